@@ -0,0 +1,46 @@
+#!/bin/bash
+
+# footprint-report.sh - Report the static footprint of an agent or controller build
+#
+# Usage: footprint-report.sh <program> <em_footprint object>
+#
+# Lists the section sizes of the program and the sizes of the large types and limits of
+# em_footprint.o, built with the same flags and compiler as the program. The sizes are
+# read with nm and size, NM and SIZE may point to the tools of a cross toolchain, so the
+# target is never run. Stack sizes are not in here, they are set at run time with
+# --stack-size.
+
+set -e
+
+PROGRAM=$1
+OBJECT=$2
+NM=${NM:-nm}
+SIZE=${SIZE:-size}
+
+if [ -z "$PROGRAM" ] || [ ! -f "$PROGRAM" ] || [ -z "$OBJECT" ] || [ ! -f "$OBJECT" ]; then
+    echo "Usage: $0 <program> <em_footprint object>"
+    exit 1
+fi
+
+echo "Sections of $PROGRAM"
+"$SIZE" -A "$PROGRAM" | awk '$1 ~ /^\.(text|rodata|data|bss|data\.rel\.ro|eh_frame)$/ { printf "  %-16s %10d\n", $1, $2; total += $2 }
+    END { printf "  %-16s %10d\n", "total", total }'
+
+SYMBOLS=$("$NM" -S -t d --defined-only "$OBJECT")
+
+echo "Types"
+echo "$SYMBOLS" | awk '$4 ~ /^em_footprint_type_/ { sub(/^em_footprint_type_/, "", $4); printf "  %-24s %10d\n", $4, $2 + 0 }' | sort -k2,2nr
+
+echo "Limits"
+echo "$SYMBOLS" | awk '$4 ~ /^em_footprint_limit_/ { sub(/^em_footprint_limit_/, "", $4); printf "  %-24s %10d\n", $4, $2 + 0 }' | sort
+
+echo "Derived"
+echo "$SYMBOLS" | awk '
+    $4 == "em_footprint_type_dm_easy_mesh_t" { dm = $2 + 0 }
+    $4 == "em_footprint_type_em_event_t" { evt = $2 + 0 }
+    $4 == "em_footprint_limit_EM_MAX_DEVICES" { devices = $2 + 0 }
+    $4 == "em_footprint_limit_EM_MAX_EVENT_DATA_LEN" { data = $2 + 0 }
+    END {
+        printf "  %-40s %10d\n", "data models of a full mesh", dm * devices
+        printf "  %-40s %10d\n", "largest event", evt + data
+    }'
@@ -0,0 +1,88 @@
+#!/bin/bash
+
+# run-bench.sh - Run the controller microbenchmarks and compare them with the previous run
+#
+# Usage: run-bench.sh <bench executable> [results dir] [benchmark filter]
+#
+# Each run is stored as <results dir>/<date>-<commit>.json, so the directory holds the
+# history of the hot paths across commits. The run is compared with the newest earlier
+# result, through compare.py of Google Benchmark when GBENCH_COMPARE points to it and
+# through a cpu time diff per benchmark otherwise. Only compare results of the same
+# build flavour and machine.
+#
+# With BENCH_BASELINE set to a result file the run is compared with that stored baseline
+# instead, and the script fails when the median cpu time of a benchmark is more than
+# BENCH_THRESHOLD percent (10 by default) above it. A baseline that does not exist yet is
+# written from the run.
+
+set -e
+
+BENCH=$1
+RESULTS_DIR=${2:-bench-results}
+FILTER=${3:-.}
+
+if [ -z "$BENCH" ] || [ ! -x "$BENCH" ]; then
+    echo "Usage: $0 <bench executable> [results dir] [benchmark filter]"
+    exit 1
+fi
+
+mkdir -p "$RESULTS_DIR"
+if COMMIT=$(git rev-parse --short HEAD 2>/dev/null); then
+    git diff --quiet HEAD || COMMIT="${COMMIT}-dirty"
+else
+    COMMIT=unknown
+fi
+PREV=$(ls -1 "$RESULTS_DIR"/*.json 2>/dev/null | sort | tail -n 1)
+OUT="$RESULTS_DIR/$(date +%Y%m%d-%H%M%S)-$COMMIT.json"
+THRESHOLD=
+if [ -n "$BENCH_BASELINE" ]; then
+    PREV=$BENCH_BASELINE
+    THRESHOLD=${BENCH_THRESHOLD:-10}
+fi
+
+"$BENCH" --benchmark_filter="$FILTER" --benchmark_repetitions=3 --benchmark_report_aggregates_only=true \
+    --benchmark_out="$OUT" --benchmark_out_format=json
+echo "Results written to $OUT"
+
+if [ -n "$BENCH_BASELINE" ] && [ ! -f "$BENCH_BASELINE" ]; then
+    cp "$OUT" "$BENCH_BASELINE"
+    echo "Baseline written to $BENCH_BASELINE"
+    exit 0
+fi
+
+if [ -z "$PREV" ]; then
+    echo "No earlier result in $RESULTS_DIR to compare with"
+    exit 0
+fi
+
+echo "Comparing with $PREV"
+if [ -z "$THRESHOLD" ] && [ -n "$GBENCH_COMPARE" ] && [ -f "$GBENCH_COMPARE" ]; then
+    python3 "$GBENCH_COMPARE" benchmarks "$PREV" "$OUT"
+    exit 0
+fi
+
+python3 - "$PREV" "$OUT" "$THRESHOLD" <<'EOF'
+import json, sys
+
+def load(path):
+    with open(path) as f:
+        runs = json.load(f)['benchmarks']
+    return {r['run_name']: r['cpu_time'] for r in runs if r.get('aggregate_name', 'median') == 'median'}
+
+old, new = load(sys.argv[1]), load(sys.argv[2])
+threshold = float(sys.argv[3]) if sys.argv[3] else None
+slower = []
+print('%-60s %14s %14s %8s' % ('Benchmark', 'old cpu', 'new cpu', 'change'))
+for name in sorted(new):
+    if name not in old:
+        print('%-60s %14s %14.0f %8s' % (name, '-', new[name], 'new'))
+        continue
+    change = ((new[name] - old[name]) * 100.0 / old[name]) if old[name] else 0.0
+    over = (threshold is not None) and (change > threshold)
+    print('%-60s %14.0f %14.0f %+7.1f%%%s' % (name, old[name], new[name], change, '  over threshold' if over else ''))
+    if over:
+        slower.append(name)
+if slower:
+    print('%d benchmark(s) more than %.0f%% slower than the baseline' % (len(slower), threshold))
+    sys.exit(1)
+EOF
@@ -0,0 +1,41 @@
+#!/bin/bash
+
+# run-conformance.sh - Run the scripted CMDU scenarios against a controller over a veth pair
+#
+# Usage: run-conformance.sh <em_conformance executable> <controller interface> [scripts dir] [controller pid]
+#
+# Creates the veth pair <controller interface>/<controller interface>-h unless it exists,
+# the controller is expected to listen on the first end, em_conformance sends from the
+# second. The scenarios run in the order of their file names, onboarding first, so that
+# the controller AL MAC is learnt before the scenarios that need it. With the pid of the
+# controller the cpu it spent is reported per scenario. Needs root for the veth pair and
+# the raw socket.
+
+set -e
+
+TOOL=$1
+IFACE=$2
+SCRIPTS_DIR=${3:-$(dirname "$0")/../tests/conformance}
+PID=$4
+
+if [ -z "$TOOL" ] || [ ! -x "$TOOL" ] || [ -z "$IFACE" ]; then
+    echo "Usage: $0 <em_conformance executable> <controller interface> [scripts dir] [controller pid]"
+    exit 1
+fi
+
+PEER="${IFACE}-h"
+if ! ip link show "$IFACE" > /dev/null 2>&1; then
+    ip link add "$IFACE" type veth peer name "$PEER"
+fi
+ip link set "$IFACE" up
+ip link set "$PEER" up
+
+ARGS="--interface=$PEER"
+if [ -n "$PID" ]; then
+    ARGS="$ARGS --pid=$PID"
+fi
+for SCRIPT in "$SCRIPTS_DIR"/onboarding.cmdu $(ls -1 "$SCRIPTS_DIR"/*.cmdu | grep -v '/onboarding.cmdu$' | sort); do
+    ARGS="$ARGS --script=$SCRIPT"
+done
+
+"$TOOL" $ARGS
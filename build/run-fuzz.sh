@@ -0,0 +1,51 @@
+#!/bin/bash
+
+# run-fuzz.sh - Run one of the fuzzing targets of tests/fuzz on its corpus
+#
+# Usage: run-fuzz.sh <em_fuzz_* executable> [seconds] [work dir] [capture.pcapng...]
+#
+# The target name is taken from the executable, em_fuzz_cmdu fuzzes with the seeds of
+# tests/fuzz/corpus/cmdu. The inputs libFuzzer finds are kept in <work dir>/<target>, so a
+# later run starts from them, and crashes, leaks, slow inputs and inputs over the time
+# budget are written to <work dir>/artifacts. The 1905 frames of the captures given, taken
+# with --capture on a controller or agent, are added to the seeds of em_fuzz_cmdu through
+# em_replay, found next to the executable or through EM_REPLAY. EM_FUZZ_BUDGET_MS sets the
+# time one input may take, 50 ms by default.
+
+set -e
+
+FUZZ=$1
+SECONDS_TO_RUN=${2:-600}
+WORK_DIR=${3:-fuzz-work}
+SEEDS_ROOT=$(dirname "$0")/../tests/fuzz/corpus
+
+if [ -z "$FUZZ" ] || [ ! -x "$FUZZ" ]; then
+    echo "Usage: $0 <em_fuzz_* executable> [seconds] [work dir] [capture.pcapng...]"
+    exit 1
+fi
+shift $(( $# < 3 ? $# : 3 ))
+
+TARGET=$(basename "$FUZZ")
+TARGET=${TARGET#em_fuzz_}
+SEEDS="$SEEDS_ROOT/$TARGET"
+if [ ! -d "$SEEDS" ]; then
+    echo "No seed corpus $SEEDS for $FUZZ"
+    exit 1
+fi
+
+mkdir -p "$WORK_DIR/$TARGET" "$WORK_DIR/artifacts"
+
+if [ $# -gt 0 ]; then
+    if [ "$TARGET" != "cmdu" ]; then
+        echo "Captures only seed em_fuzz_cmdu, ignored"
+    else
+        REPLAY=${EM_REPLAY:-$(dirname "$FUZZ")/em_replay}
+        for CAPTURE in "$@"; do
+            "$REPLAY" --file="$CAPTURE" --corpus="$WORK_DIR/$TARGET" --dir=all
+        done
+    fi
+fi
+
+# -close_fd_mask=1 drops the printf of the parsers, they would be most of the time spent
+"$FUZZ" "$WORK_DIR/$TARGET" "$SEEDS" -max_total_time="$SECONDS_TO_RUN" -timeout=2 -rss_limit_mb=1024 \
+    -max_len=8192 -close_fd_mask=1 -print_final_stats=1 -artifact_prefix="$WORK_DIR/artifacts/$TARGET-"
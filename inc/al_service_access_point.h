@@ -4,10 +4,16 @@
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 
 
 #include "al_service_data_unit.h"
 #include "al_service_exception.h"
+#include "al_service_utils.h"
+#include "al_service_shared_ring.h"
 #include "al_service_registration_request.h"
 #include "al_service_registration_response.h"
 
@@ -15,6 +21,26 @@
 using MacAddress = std::array<uint8_t, 6>;
 
 constexpr size_t SOCKET_MTU = 65536;
+constexpr size_t SAP_TX_QUEUE_DEPTH = 128;    // packets waiting for the data socket, beyond it messages are dropped
+constexpr size_t SAP_TX_BATCH = 32;           // queued packets written by one sendmsg()
+constexpr int SAP_TX_POLL_MS = 100;           // wake up of the transmitter while the socket stays full
+
+// How the data units travel to and from the IEEE1905 daemon
+enum class AlServiceTransport {
+    UnixSocket,       // packets of at most SOCKET_MTU bytes on the data socket
+    SharedMemory      // whole messages in an AlServiceSharedRing, its descriptors sent over the data socket
+};
+
+// Counters of the data request transmit queue
+struct AlServiceTransmitStats {
+    uint64_t sentPackets = 0;
+    uint64_t queuedPackets = 0;       // packets, or their end, that had to wait for the socket
+    uint64_t droppedMessages = 0;     // messages dropped because the queue was full
+    uint64_t backPressure = 0;        // sends that found the socket full
+    uint64_t batches = 0;             // sendmsg() calls writing queued packets
+    uint64_t errors = 0;              // failed sends of the transmitter, the queue is then discarded
+    size_t peakDepth = 0;
+};
 
 class AlServiceAccessPoint {
 public:
@@ -26,10 +52,13 @@ public:
 	 * Initializes the service access point with the specified socket path.
 	 *
 	 * @param[in] socketPath The path to the socket for service access.
+	 * @param[in] transport Transport of the data units, with SharedMemory the data socket only
+	 * carries the descriptors of the shared ring, for a daemon on the same host.
 	 *
 	 * @note Ensure the socket path is valid and accessible.
 	 */
-	AlServiceAccessPoint(const std::string &dataSocketPath, const std::string &controlSocketPath);
+	AlServiceAccessPoint(const std::string &dataSocketPath, const std::string &controlSocketPath,
+	    AlServiceTransport transport = AlServiceTransport::UnixSocket);
 
     // Destructor: Closes the Unix domain socket and releases any memory used by the SAP
     
@@ -56,6 +85,47 @@ public:
 	 */
 	void serviceAccessPointDataRequest(AlServiceDataUnit& message);
 
+    // Executes service request primitive on a payload owned by the caller
+    
+	/**!
+	 * @brief Sends a payload through the service access point without copying it.
+	 *
+	 * Each packet is sent with sendmsg(), the header from a local buffer and the fragment
+	 * straight from the payload, so nothing is copied into an AlServiceDataUnit first. The
+	 * call does not block, what the socket cannot take yet is copied into the transmit queue,
+	 * and a message whose packets do not fit in the queue is dropped whole and counted.
+	 *
+	 * @param[in] source Source AL MAC address.
+	 * @param[in] destination Destination AL MAC address.
+	 * With the shared memory transport the message is copied whole into the ring instead, and
+	 * dropped and counted if the ring has no room for it.
+	 *
+	 * @param[in] payload Payload to send, fragmented if larger than SOCKET_MTU - PACKET_HEADER_SIZE.
+	 * @param[in] length Size of the payload.
+	 *
+	 * @note Throws an AlServiceException if the service is not registered or the socket failed,
+	 * or if the payload is larger than the shared ring holds.
+	 */
+	void serviceAccessPointDataRequest(const MacAddress& source, const MacAddress& destination,
+	    const unsigned char *payload, size_t length);
+
+    // Counters of the transmit queue
+    
+	/**!
+	 * @brief Returns the counters of the data request transmit queue.
+	 *
+	 * Data requests never block, what the data socket cannot take at once is queued, up
+	 * to SAP_TX_QUEUE_DEPTH packets, and written by a transmitter thread in batches.
+	 *
+	 * @returns A copy of the counters.
+	 */
+	AlServiceTransmitStats getTransmitStats();
+
+	/**!
+	 * @brief Returns the number of packets waiting in the transmit queue.
+	 */
+	size_t getTransmitQueueDepth();
+
     // Executes service indication primitive (receive a message)
     
 	/**!
@@ -72,6 +142,29 @@ public:
 	 */
 	AlServiceDataUnit serviceAccessPointDataIndication();  // Fills and returns an AlServiceDataUnit object
 
+    // Executes service indication primitive without blocking, for a listener polling the data socket
+    
+	/**!
+	 * @brief Receives what the data socket holds without blocking and reassembles it in place.
+	 *
+	 * Packets may arrive in any number of reads, the progress is kept across calls. The payloads
+	 * of the fragments of a message are received one after the other into a buffer kept by the
+	 * access point, behind headroom bytes left free for the caller, e.g. to prepend a header.
+	 *
+	 * @param[in] headroom Number of bytes left free in front of the payload.
+	 * @param[out] length Size of the payload once the message is complete.
+	 * @param[out] source Source AL MAC address of the message.
+	 * @param[out] destination Destination AL MAC address of the message.
+	 *
+	 * @returns The buffer, payload at headroom and valid until the next call, once a message is
+	 * complete, nullptr while the socket has no more data.
+	 *
+	 * @note Throws an AlServiceException with PrimitiveError::InvalidMessage or FragmentOutOfOrder
+	 * once a message that was dropped has been read, the next call carries on with the next one.
+	 * Not to be mixed with the blocking indication on the same access point.
+	 */
+	unsigned char *serviceAccessPointDataIndication(size_t headroom, size_t& length, MacAddress& source, MacAddress& destination);
+
      // Executes service request primitive (send a message)
     
 	/**!
@@ -126,6 +219,16 @@ public:
 	 */
 	void setDataSocketDescriptor(int descriptor); // this was added method to set the socket descriptor
 
+    // Getter for the descriptor to wait on for data indications
+    
+	/**!
+	 * @brief Retrieves the descriptor that becomes readable when a data indication may be received.
+	 *
+	 * @returns The event descriptor of the shared ring with the shared memory transport, the data
+	 * socket descriptor otherwise.
+	 */
+	int getIndicationDescriptor() const;
+
     // Getter for the control socket descriptor
     
 	/**!
@@ -154,6 +257,61 @@ public:
 
 
     private:
+	/**!
+	 * @brief Sends a header and a payload slice on the data socket, or queues what it cannot take.
+	 *
+	 * The packet is written straight from the buffers if nothing is queued, the part the socket
+	 * does not take at once is copied into the queue. Called with alTxMutex held.
+	 *
+	 * @param[in] header Header of PACKET_HEADER_SIZE bytes.
+	 * @param[in] payload Payload slice.
+	 * @param[in] length Size of the payload slice.
+	 * @param[in] error Message of the AlServiceException thrown if the send fails.
+	 */
+	void sendPacket(const unsigned char *header, const unsigned char *payload, size_t length, const char *error);
+
+	/**!
+	 * @brief Writes the queued packets in batches until the queue is empty or the socket is full.
+	 *
+	 * Called with alTxMutex held.
+	 *
+	 * @returns 0 on success, -1 if a send failed, errno is then set.
+	 */
+	int flushTransmitQueue();
+
+	/**!
+	 * @brief Transmitter thread, flushes the queue whenever the data socket can take more.
+	 */
+	void transmitLoop();
+
+	/**!
+	 * @brief Receives up to length bytes from the data socket without blocking.
+	 *
+	 * @param[out] buffer Buffer receiving the bytes.
+	 * @param[in] length Maximum number of bytes.
+	 *
+	 * @returns Number of bytes received, 0 if nothing is available.
+	 *
+	 * @note Throws an AlServiceException if the socket is closed or the receive fails.
+	 */
+	size_t receiveAvailable(unsigned char *buffer, size_t length);
+
+	/**!
+	 * @brief Blocks until the shared ring holds a message and returns it.
+	 *
+	 * @returns The data unit, a single message.
+	 *
+	 * @note Throws an AlServiceException if waiting or the ring fails.
+	 */
+	AlServiceDataUnit receiveFromRing();
+
+	/**!
+	 * @brief Starts the packet whose header has been received by the non blocking indication.
+	 *
+	 * @param[in] headroom Number of bytes left free in front of the payload if the packet starts a message.
+	 */
+	void startReceivedPacket(size_t headroom);
+
     MacAddress alMacAddressLocal;
     int alDataSocketDescriptor;
     std::string alDataSocketpath = "/tmp/al_data_socket"; // Unix socket path initialized
@@ -161,6 +319,28 @@ public:
     std::string alControlSocketpath = "/tmp/al_control_socket"; // Unix socket path initialized
     AlServiceRegistrationResponse registrationResponse;  // Private member instance
     AlServiceRegistrationRequest registrationRequest;  // Private member instance
+    std::vector<unsigned char> alReceiveBuffer;  // SOCKET_MTU bytes reused by every data indication
+    // State of the non blocking indication
+    std::vector<unsigned char> alReassemblyBuffer;  // headroom and payload of the message being received
+    unsigned char alRxHeader[PACKET_HEADER_SIZE];
+    size_t alRxHeaderLength = 0;        // header bytes of the current packet received
+    size_t alRxPayloadLeft = 0;         // payload bytes of the current packet still to receive
+    size_t alRxHeadroom = 0;
+    size_t alRxLength = 0;              // payload bytes of the message reassembled
+    unsigned int alRxFragmentId = 0;    // id of the next fragment
+    PrimitiveError alRxDropError = PrimitiveError::UnknownError;
+    bool alRxDrop = false;              // the message is read and thrown away
+    MacAddress alRxSource;
+    MacAddress alRxDestination;
+    // Transmit queue of the data requests, filled by the callers and drained by the transmitter
+    std::mutex alTxMutex;
+    std::condition_variable alTxCondition;
+    std::deque<std::vector<unsigned char>> alTxQueue;  // serialized packets
+    size_t alTxHeadOffset = 0;          // bytes of the first packet already sent
+    AlServiceTransmitStats alTxStats;
+    std::thread alTxThread;
+    bool alTxExit = false;
+    std::unique_ptr<AlServiceSharedRing> alRing;  // set with the shared memory transport
 };
 
 #endif // AL_SERVICE_ACCESS_POINT_H
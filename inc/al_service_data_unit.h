@@ -204,6 +204,34 @@ public:
 	 * @note Ensure that the data vector is properly formatted before calling this function.
 	 */
 	void deserialize(const std::vector<unsigned char>& data);
+
+    // Header of a packet whose payload is sent from the caller's buffer
+    
+	/**!
+	 * @brief Writes the PACKET_HEADER_SIZE bytes header of a packet.
+	 *
+	 * The payload is not copied, it is sent next to the header from the caller's buffer.
+	 *
+	 * @param[out] header Buffer of PACKET_HEADER_SIZE bytes.
+	 * @param[in] source Source AL MAC address.
+	 * @param[in] destination Destination AL MAC address.
+	 * @param[in] isFragment 1 if the packet is a fragment.
+	 * @param[in] isLastFragment 1 if the packet is the last fragment.
+	 * @param[in] fragmentId Fragment ID number.
+	 * @param[in] payloadLength Size of the payload following the header.
+	 */
+	static void serializeHeader(unsigned char *header, const MacAddress& source, const MacAddress& destination,
+	    uint8_t isFragment, uint8_t isLastFragment, uint8_t fragmentId, size_t payloadLength);
+
+	/**!
+	 * @brief Reads the MAC addresses and fragment fields from the header of a received packet.
+	 *
+	 * @param[in] data Received packet.
+	 * @param[in] length Size of the packet.
+	 *
+	 * @note The payload is left untouched, if the packet is shorter than the header an AlServiceException is thrown.
+	 */
+	void deserializeHeader(const unsigned char *data, size_t length);
     
 };
 
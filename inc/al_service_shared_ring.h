@@ -0,0 +1,149 @@
+#ifndef AL_SERVICE_SHARED_RING_H
+#define AL_SERVICE_SHARED_RING_H
+
+#include <atomic>
+#include <array>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+constexpr size_t SAP_RING_SIZE = 4 * 1024 * 1024;     // bytes of each direction of the shared memory
+constexpr size_t SAP_RING_RECORD_HEADER_SIZE = 16;     // 4 (length) + 6 (MAC) + 6 (MAC)
+constexpr uint32_t SAP_RING_WRAP = 0xffffffff;         // length of the filler in front of the end of a ring
+constexpr char SAP_RING_HANDSHAKE[8] = {'A', 'L', 'S', 'A', 'P', 'S', 'H', 'M'};
+
+// Head and tail of one direction, on their own cache lines as they are written by different processes
+struct AlServiceRingControl {
+    alignas(64) std::atomic<uint64_t> head;    // bytes ever written by the producer
+    alignas(64) std::atomic<uint64_t> tail;    // bytes ever released by the consumer
+};
+
+/*
+ * Transport of whole messages between the service access point and the IEEE1905 daemon on the
+ * same host. A memfd holds one single producer single consumer ring per direction, each with an
+ * eventfd the producer signals when it writes into an empty ring. The end that creates it sends
+ * the descriptors over the data socket, the other end attaches to them with receiveDescriptors().
+ * A record is the length, the source and destination AL MAC addresses and the payload, padded to
+ * 8 bytes and never split at the end of the ring. push() and peek()/pop() are not thread safe,
+ * one thread at a time may produce and one consume.
+ */
+class AlServiceSharedRing {
+public:
+	/**!
+	 * @brief Creates the shared memory and the event descriptors of both directions.
+	 *
+	 * @param[in] ringSize Bytes of each direction, a multiple of 8.
+	 *
+	 * @note Throws an AlServiceException with PrimitiveError::SocketCreationFailed on failure.
+	 */
+	explicit AlServiceSharedRing(size_t ringSize = SAP_RING_SIZE);
+
+	/**!
+	 * @brief Attaches to the shared memory created by the other end, which then produces what this one consumes.
+	 *
+	 * @param[in] memoryDescriptor The memfd, owned by the ring from then on.
+	 * @param[in] eventDescriptors The eventfd of each direction, owned by the ring from then on.
+	 *
+	 * @note Throws an AlServiceException with PrimitiveError::SocketCreationFailed if it cannot be mapped.
+	 */
+	AlServiceSharedRing(int memoryDescriptor, const std::array<int, 2>& eventDescriptors);
+
+	/**!
+	 * @brief Destructor for AlServiceSharedRing, unmaps the memory and closes the descriptors.
+	 */
+	~AlServiceSharedRing();
+
+	AlServiceSharedRing(const AlServiceSharedRing&) = delete;
+	AlServiceSharedRing& operator=(const AlServiceSharedRing&) = delete;
+
+	/**!
+	 * @brief Sends the descriptors to the other end with SCM_RIGHTS, behind SAP_RING_HANDSHAKE.
+	 *
+	 * @param[in] socketDescriptor Connected Unix socket.
+	 *
+	 * @note Throws an AlServiceException with PrimitiveError::RequestFailed if the send fails.
+	 */
+	void sendDescriptors(int socketDescriptor) const;
+
+	/**!
+	 * @brief Receives the descriptors sent by sendDescriptors() and attaches to them.
+	 *
+	 * @param[in] socketDescriptor Connected Unix socket.
+	 *
+	 * @returns The ring of this end.
+	 *
+	 * @note Throws an AlServiceException with PrimitiveError::InvalidMessage if the message is not a handshake.
+	 */
+	static std::unique_ptr<AlServiceSharedRing> receiveDescriptors(int socketDescriptor);
+
+	/**!
+	 * @brief Copies a message into the ring of this end and signals the other end if it was idle.
+	 *
+	 * @param[in] source Source AL MAC address.
+	 * @param[in] destination Destination AL MAC address.
+	 * @param[in] payload Payload of the message.
+	 * @param[in] length Size of the payload, at most getMaxPayload().
+	 *
+	 * @returns true on success, false if the ring has no room for it yet.
+	 */
+	bool push(const std::array<uint8_t, 6>& source, const std::array<uint8_t, 6>& destination,
+	    const unsigned char *payload, size_t length);
+
+	/**!
+	 * @brief Returns the oldest message the other end wrote, left in the ring until pop().
+	 *
+	 * @param[out] length Size of the payload.
+	 * @param[out] source Source AL MAC address.
+	 * @param[out] destination Destination AL MAC address.
+	 *
+	 * @returns The payload, in the shared memory, nullptr if there is none.
+	 */
+	const unsigned char *peek(size_t& length, std::array<uint8_t, 6>& source, std::array<uint8_t, 6>& destination);
+
+	/**!
+	 * @brief Releases the message returned by peek().
+	 */
+	void pop();
+
+	/**!
+	 * @brief Clears the event descriptor of the incoming direction, to be done before peek() finds the ring empty.
+	 */
+	void clearEvent();
+
+	/**!
+	 * @brief Returns the eventfd that becomes readable when the other end writes into an empty ring.
+	 */
+	int getEventDescriptor() const;
+
+	/**!
+	 * @brief Returns the largest payload a ring holds.
+	 */
+	size_t getMaxPayload() const;
+
+private:
+	/**!
+	 * @brief Maps the memory and sets up the directions.
+	 *
+	 * @param[in] creator True at the end that created the memory, it produces into the first direction.
+	 */
+	void map(bool creator);
+
+	/**!
+	 * @brief Unmaps the memory and closes the descriptors, also when a constructor fails.
+	 */
+	void release();
+
+	size_t ringSize;
+	int memoryDescriptor = -1;
+	std::array<int, 2> eventDescriptors = {{-1, -1}};   // signaled by the producer of each direction
+	unsigned char *memory = nullptr;
+	AlServiceRingControl *txControl = nullptr;
+	unsigned char *txData = nullptr;
+	int txEvent = -1;
+	AlServiceRingControl *rxControl = nullptr;
+	unsigned char *rxData = nullptr;
+	int rxEvent = -1;
+	uint64_t rxRecordSize = 0;      // bytes of the record returned by peek()
+};
+
+#endif // AL_SERVICE_SHARED_RING_H
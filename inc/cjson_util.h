@@ -19,16 +19,137 @@
  #ifndef __CJSON_UTIL__
  #define __CJSON_UTIL__ 
 
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <limits.h>
+ #include <float.h>
+ #include <cmath>
+ #include <string>
  #include "cjson/cJSON.h"
 
  namespace cjson_utils {
 
     
+	// cJSON_PrintPreallocated() asks for a little more room than it writes, see cJSON.h
+	static const size_t print_slack = 5;
+
+	/**
+	 * @brief Get the length cJSON prints a string with, quotes and escapes included.
+	 *
+	 * @param[in] str The string, NULL prints as "".
+	 * @return size_t The length.
+	 */
+	static inline size_t get_string_print_size(const char *str) {
+        const unsigned char *p;
+        size_t len = 2;
+
+        if (str == NULL) {
+            return len;
+        }
+        for (p = reinterpret_cast<const unsigned char *>(str); *p != '\0'; p++) {
+            switch (*p) {
+                case '"': case '\\': case '\b': case '\f': case '\n': case '\r': case '\t':
+                    len += 2;
+                    break;
+                default:
+                    len += (*p < 32) ? 6:1;
+                    break;
+            }
+        }
+        return len;
+    }
+
+	/**
+	 * @brief Get the length cJSON prints a number with.
+	 *
+	 * The number is formatted into a small stack buffer the way cJSON does it, integers
+	 * as such, otherwise with the shortest of 15 or 17 digits that reads back the same.
+	 *
+	 * @param[in] item The number.
+	 * @return size_t The length, 0 if cJSON would fail to print it.
+	 */
+	static inline size_t get_number_print_size(const cJSON *item) {
+        char buff[26];
+        double d = item->valuedouble, test;
+        int len;
+
+        if (std::isnan(d) || std::isinf(d)) {
+            return strlen("null");
+        }
+        if (d == static_cast<double>(item->valueint)) {
+            len = snprintf(buff, sizeof(buff), "%d", item->valueint);
+        } else {
+            len = snprintf(buff, sizeof(buff), "%1.15g", d);
+            test = strtod(buff, NULL);
+            if (std::fabs(test - d) > ((std::fabs(test) > std::fabs(d)) ? std::fabs(test):std::fabs(d)) * DBL_EPSILON) {
+                len = snprintf(buff, sizeof(buff), "%1.17g", d);
+            }
+        }
+        return ((len < 0) || (static_cast<size_t>(len) >= sizeof(buff))) ? 0:static_cast<size_t>(len);
+    }
+
+	/**
+	 * @brief Get the length cJSON prints a value with, walking the tree without allocating.
+	 *
+	 * @param[in] item The value.
+	 * @param[in] format Whether the value is printed formatted, as by cJSON_Print().
+	 * @param[in] depth Nesting depth of the value, objects and arrays both count.
+	 * @return size_t The length, 0 if cJSON would fail to print the value.
+	 */
+	static inline size_t get_print_size(const cJSON *item, bool format, size_t depth = 0) {
+        const cJSON *child;
+        size_t len, sz;
+
+        if (item == NULL) {
+            return 0;
+        }
+        switch (item->type & 0xff) {
+            case cJSON_NULL:
+                return strlen("null");
+            case cJSON_False:
+                return strlen("false");
+            case cJSON_True:
+                return strlen("true");
+            case cJSON_Number:
+                return get_number_print_size(item);
+            case cJSON_Raw:
+                return (item->valuestring == NULL) ? 0:strlen(item->valuestring);
+            case cJSON_String:
+                return get_string_print_size(item->valuestring);
+            case cJSON_Array:
+                // [a, b]
+                len = 2;
+                for (child = item->child; child != NULL; child = child->next) {
+                    if ((sz = get_print_size(child, format, depth + 1)) == 0) {
+                        return 0;
+                    }
+                    len += sz + ((child->next == NULL) ? 0:(format ? 2:1));
+                }
+                return len;
+            case cJSON_Object:
+                // {\n, one tab more than the object per member, key:\tvalue,\n, tabs}
+                len = format ? (2 + 1 + depth):2;
+                for (child = item->child; child != NULL; child = child->next) {
+                    if ((sz = get_print_size(child, format, depth + 1)) == 0) {
+                        return 0;
+                    }
+                    len += get_string_print_size(child->string) + 1 + sz + ((child->next == NULL) ? 0:1);
+                    if (format) {
+                        len += (depth + 1) + 1 + 1;
+                    }
+                }
+                return len;
+            default:
+                return 0;
+        }
+    }
+
 	/**
 	 * @brief Get the size, in bytes, of a cJSON JSON string.
 	 *
-	 * This function calculates the size of a JSON string by converting
-	 * the cJSON object to a string and measuring its length.
+	 * The size is that of the cJSON_Print() output, computed by walking the tree, nothing
+	 * is printed or allocated.
 	 *
 	 * @param[in] json The JSON instance to get the size of. Must not be NULL.
 	 *
@@ -38,22 +159,46 @@
 	 * conversion to a string fails.
 	 */
 	static inline size_t get_cjson_blob_size(const cJSON *const json) {
-        size_t len = 0UL;
-        if (json != NULL) {
-            char *s = cJSON_Print(json);
-            if (s) {
-                len = strlen(s);
-                free(s);
-            }
+        return get_print_size(json, true);
+    }
+
+	/**
+	 * @brief Print a cJSON blob into a caller buffer.
+	 *
+	 * The blob is printed straight into the buffer, cJSON allocates nothing. If it does
+	 * not fit, the buffer receives it truncated, as snprintf() would.
+	 *
+	 * @param[in] blob The cJSON blob to print. Must not be NULL.
+	 * @param[out] buff The buffer.
+	 * @param[in] len Size of the buffer.
+	 * @param[in] unformatted A boolean flag indicating whether to leave out whitespace.
+	 * @return bool true if the whole blob fit in the buffer.
+	 */
+	static inline bool print_preallocated(cJSON *blob, char *buff, size_t len, bool unformatted = false) {
+        char *s;
+        size_t sz;
+
+        if ((blob == NULL) || (buff == NULL) || (len == 0)) {
+            return false;
         }
-        return len;
+        sz = get_print_size(blob, !unformatted);
+        if ((sz != 0) && (sz + print_slack <= len) && (len <= INT_MAX) &&
+                cJSON_PrintPreallocated(blob, buff, static_cast<int>(len), unformatted ? 0:1)) {
+            return true;
+        }
+
+        s = unformatted ? cJSON_PrintUnformatted(blob):cJSON_Print(blob);
+        snprintf(buff, len, "%s", (s == NULL) ? "":s);
+        sz = (s == NULL) ? len:strlen(s);
+        cJSON_free(s);
+        return sz < len;
     }
 
-    
 	/**
 	 * @brief Convert a cJSON blob to a string.
 	 *
-	 * This function converts a given cJSON blob into its string representation.
+	 * This function converts a given cJSON blob into its string representation. The string is
+	 * sized first and cJSON prints straight into it.
 	 *
 	 * @param[in] blob The cJSON blob to convert. Must not be NULL.
 	 * @param[in] unformatted A boolean flag indicating whether to include whitespace (newlines and tabs) in the string.
@@ -65,17 +210,147 @@
         if (blob == NULL) {
             return std::string();
         }
+        size_t sz = get_print_size(blob, !unformatted);
+        if ((sz != 0) && (sz + print_slack <= INT_MAX)) {
+            std::string str(sz + print_slack, '\0');
+            if (cJSON_PrintPreallocated(blob, &str[0], static_cast<int>(str.size()), unformatted ? 0:1)) {
+                str.resize(strlen(str.c_str()));
+                return str;
+            }
+        }
         char *s = NULL;
         if (unformatted) {
             s = cJSON_PrintUnformatted(blob);
         } else {
             s = cJSON_Print(blob);
         }
-        std::string str(s);
+        std::string str((s == NULL) ? "":s);
         free(s);
         return str;
     }
 
+	/**
+	 * @brief Skips the JSON whitespace at a position.
+	 *
+	 * @param[in] p Position in the document.
+	 * @param[in] end End of the document.
+	 * @return const char* The first character that is not whitespace, end if there is none.
+	 */
+	static inline const char *skip_space(const char *p, const char *end) {
+        while ((p < end) && ((*p == ' ') || (*p == '\t') || (*p == '\n') || (*p == '\r'))) {
+            p++;
+        }
+        return p;
+    }
+
+	/**
+	 * @brief Skips a JSON string.
+	 *
+	 * @param[in] p Opening quote of the string.
+	 * @param[in] end End of the document.
+	 * @return const char* The character after the closing quote, NULL if the string is not terminated.
+	 */
+	static inline const char *skip_string(const char *p, const char *end) {
+        for (p++; p < end; p++) {
+            if (*p == '\\') {
+                p++;
+            } else if (*p == '"') {
+                return p + 1;
+            }
+        }
+        return NULL;
+    }
+
+	/**
+	 * @brief Finds a member of the top level object of a JSON document without parsing it.
+	 *
+	 * The document is scanned up to the member, the values before it are skipped without
+	 * being parsed or allocated. Members of nested objects are not matched.
+	 *
+	 * @param[in] json The JSON document, not necessarily NUL terminated.
+	 * @param[in] len Length of the document.
+	 * @param[in] name Name of the member.
+	 * @return const char* The first character of the value of the member, NULL if the top level
+	 * object has no such member or the document is malformed before it.
+	 */
+	static inline const char *find_top_level_value(const char *json, size_t len, const char *name) {
+        const char *p, *q, *key, *end = json + len;
+        size_t name_len = strlen(name);
+        unsigned int depth = 1;
+
+        p = skip_space(json, end);
+        if ((p == end) || (*p != '{')) {
+            return NULL;
+        }
+
+        for (p++; (p < end) && (*p != '\0'); ) {
+            if (*p == '"') {
+                key = p + 1;
+                if ((p = skip_string(p, end)) == NULL) {
+                    return NULL;
+                }
+                // a string of the top level object followed by a colon is one of its keys
+                if (depth == 1) {
+                    q = skip_space(p, end);
+                    if ((q < end) && (*q == ':')) {
+                        if ((static_cast<size_t>(p - 1 - key) == name_len) && (memcmp(key, name, name_len) == 0)) {
+                            q = skip_space(q + 1, end);
+                            return (q < end) ? q:NULL;
+                        }
+                        p = q + 1;
+                    }
+                }
+                continue;
+            }
+            if ((*p == '{') || (*p == '[')) {
+                depth++;
+            } else if (((*p == '}') || (*p == ']')) && (--depth == 0)) {
+                return NULL;
+            }
+            p++;
+        }
+        return NULL;
+    }
+
+	/**
+	 * @brief Gets a string member of the top level object of a JSON document without parsing it.
+	 *
+	 * @param[in] json The JSON document, not necessarily NUL terminated.
+	 * @param[in] len Length of the document.
+	 * @param[in] name Name of the member.
+	 * @param[out] out Buffer the NUL terminated value is copied to.
+	 * @param[in] out_len Size of the buffer.
+	 * @return bool true if the member was found, is a string and fits in the buffer.
+	 *
+	 * @note Only the escapes of quotes, backslashes and slashes are decoded, a value with any
+	 * other escape is not returned.
+	 */
+	static inline bool get_top_level_string(const char *json, size_t len, const char *name, char *out, size_t out_len) {
+        const char *p, *end = json + len;
+        size_t i = 0;
+
+        if (((p = find_top_level_value(json, len, name)) == NULL) || (*p != '"')) {
+            return false;
+        }
+
+        for (p++; (p < end) && (*p != '"'); p++) {
+            if (*p == '\\') {
+                if ((++p == end) || ((*p != '"') && (*p != '\\') && (*p != '/'))) {
+                    return false;
+                }
+            }
+            if (i + 1 >= out_len) {
+                return false;
+            }
+            out[i++] = *p;
+        }
+        if ((p == end) || (out_len == 0)) {
+            return false;
+        }
+        out[i] = '\0';
+        return true;
+    }
+
  }
 
 
@@ -0,0 +1,155 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef DB_BACKEND_H
+#define DB_BACKEND_H
+
+#include <string>
+#include <vector>
+
+#define DB_BACKEND_DB_NAME      "OneWifiMesh"
+#define DB_BACKEND_SQLITE_FILE  "/nvram/OneWifiMesh.db"    // used when the path is not a file
+
+/*
+ * Rows of a query. The result set belongs to the backend, row holds the values of the
+ * current row and stays NULL until the first row is read.
+ */
+typedef struct {
+    void    *result;
+    char    **row;
+} db_rows_t;
+
+/*
+ * Storage backend of db_client_t, one instance per connection. The backend is chosen
+ * at build time: MariaDB by default, SQLite in WAL mode in process with EM_DB_SQLITE.
+ * Both speak the SQL the tables are written in, the calls below hide what differs.
+ */
+class db_backend_t {
+
+public:
+
+    /**!
+     * @brief Opens a connection.
+     *
+     * @param[in] path "username@password" of the server for MariaDB, path of the database file for SQLite.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    virtual int open(const char *path) = 0;
+
+    /**!
+     * @brief Closes the connection, rows still open must be freed first.
+     */
+    virtual void close() = 0;
+
+    /**!
+     * @brief Runs a statement.
+     *
+     * @param[in] sql Statement.
+     * @param[out] rows Rows of the statement, result is NULL if it returns none.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    virtual int query(const char *sql, db_rows_t *rows) = 0;
+
+    /**!
+     * @brief Reads the next row.
+     *
+     * @param[in,out] rows Rows of a query, freed when there are no more.
+     *
+     * @returns True if a row was read, false at the end.
+     */
+    virtual bool next_row(db_rows_t *rows) = 0;
+
+    /**!
+     * @brief Returns a value of the current row.
+     *
+     * @param[in] rows Rows of a query.
+     * @param[in] col Column, 1 based.
+     * @param[out] len Length of the value.
+     *
+     * @returns The value, NULL for a NULL value or without a current row.
+     */
+    virtual const char *get_value(db_rows_t *rows, unsigned int col, unsigned long *len) = 0;
+
+    /**!
+     * @brief Returns the number of columns of the rows.
+     */
+    virtual unsigned int get_num_cols(db_rows_t *rows) = 0;
+
+    /**!
+     * @brief Frees rows that were not read to the end.
+     */
+    virtual void free_rows(db_rows_t *rows) = 0;
+
+    /**!
+     * @brief Runs statements, in order, as one transaction.
+     *
+     * @param[in] queries Statements.
+     * @param[in] num Number of statements.
+     * @param[out] failed Set for each statement that failed.
+     */
+    virtual void write_batch(char **queries, unsigned int num, bool *failed) = 0;
+
+    /**!
+     * @brief Lists the tables of the database.
+     *
+     * @param[out] tables Names of the tables.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    virtual int get_tables(std::vector<std::string>& tables) = 0;
+
+    /**!
+     * @brief Returns a checksum of the rows of a table.
+     *
+     * @param[in] table Name of the table.
+     * @param[out] checksum Checksum, 0 if the table does not exist.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    virtual int get_checksum(const char *table, unsigned long long *checksum) = 0;
+
+    /**!
+     * @brief Drops every table, through the database when the server has one.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    virtual int recreate() = 0;
+
+    /**!
+     * @brief Selects the database again after another connection recreated it.
+     */
+    virtual void reselect() = 0;
+
+    /**!
+     * @brief Returns the error of the last call that failed.
+     */
+    virtual const char *get_error() = 0;
+
+    /**!
+     * @brief Creates a backend of the type the controller was built with.
+     *
+     * @returns The backend, not connected, NULL on allocation failure.
+     */
+    static db_backend_t *create();
+
+    virtual ~db_backend_t() { }
+};
+
+#endif
@@ -0,0 +1,63 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef DB_BACKEND_SQLITE_H
+#define DB_BACKEND_SQLITE_H
+
+#include <sqlite3.h>
+#include "db_backend.h"
+
+/*
+ * SQLite database in process, in WAL mode so the writer connection commits while the
+ * event thread reads. A connection that finds the database locked waits for it.
+ */
+class db_backend_sqlite_t : public db_backend_t {
+
+    sqlite3 *m_db;
+
+public:
+
+    int open(const char *path) override;
+    void close() override;
+    int query(const char *sql, db_rows_t *rows) override;
+    bool next_row(db_rows_t *rows) override;
+    const char *get_value(db_rows_t *rows, unsigned int col, unsigned long *len) override;
+    unsigned int get_num_cols(db_rows_t *rows) override;
+    void free_rows(db_rows_t *rows) override;
+    void write_batch(char **queries, unsigned int num, bool *failed) override;
+    int get_tables(std::vector<std::string>& tables) override;
+    int get_checksum(const char *table, unsigned long long *checksum) override;
+    int recreate() override;
+    void reselect() override;
+    const char *get_error() override;
+
+    /**!
+     * @brief Constructor for db_backend_sqlite_t, not connected.
+     */
+    db_backend_sqlite_t(): m_db(NULL) { }
+
+    /**!
+     * @brief Destructor for db_backend_sqlite_t, closes the connection.
+     */
+    ~db_backend_sqlite_t() override { close(); }
+
+    db_backend_sqlite_t(const db_backend_sqlite_t&) = delete;
+    db_backend_sqlite_t& operator=(const db_backend_sqlite_t&) = delete;
+};
+
+#endif
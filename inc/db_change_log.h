@@ -0,0 +1,170 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef DB_CHANGE_LOG_H
+#define DB_CHANGE_LOG_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <string>
+#include <deque>
+#include "db_write_queue.h"
+
+#define DB_CHANGE_LOG_MAX_RECS      8192
+#define DB_CHANGE_LOG_MAX_BYTES     (4 * 1024 * 1024)   // oldest records are dropped past either limit
+#define DB_CHANGE_LOG_HDR_LEN       21                  // length, seq, op and the lengths of the strings
+
+/*
+ * Record layout, network byte order: 32 bit length of the whole record, 64 bit sequence
+ * number, 8 bit operation, 16 bit length of the table, 16 bit length of the key, 32 bit
+ * length of the query, then the table, key and query without their nul.
+ */
+typedef struct {
+    unsigned long long  seq = 0;
+    db_write_op_t   op = db_write_op_insert;
+    std::string     table{};
+    std::string     key{};
+    std::string     query{};
+} db_change_rec_t;
+
+typedef struct {
+    unsigned long long  appended;
+    unsigned long long  dropped;        // records dropped from the ring before they were read
+    unsigned long long  resets;
+    unsigned int        num_recs;       // records in the ring
+    size_t              bytes;
+} db_change_log_stats_t;
+
+/*
+ * Change log of the row writes of the database, the commit points of the data model. Every
+ * write is appended as a binary record with the next sequence number and kept in a ring,
+ * bounded in records and bytes, so a reader that was disconnected continues from the last
+ * record it read. A reader whose next record left the ring, or that read the log of another
+ * process, tells from the log id and read() that it has to copy the whole database first.
+ * Thread safe.
+ */
+class db_change_log_t {
+
+    pthread_mutex_t m_lock;
+    pthread_cond_t  m_cond;             // signalled on append
+    std::deque<std::string> m_recs;     // encoded records, the first has sequence number m_first
+    unsigned long long  m_id;           // differs for every log, sequence numbers of two logs do not compare
+    unsigned long long  m_first;
+    unsigned long long  m_next;         // sequence number of the next record
+    db_change_log_stats_t   m_stats;
+
+public:
+
+    /**!
+     * @brief Appends a record to a buffer.
+     *
+     * @param[in] seq Sequence number.
+     * @param[in] table Table of the row.
+     * @param[in] key Key of the row.
+     * @param[in] op Operation of the query.
+     * @param[in] query SQL query.
+     * @param[out] out Buffer the record is appended to.
+     *
+     * @returns Length of the record, 0 if a string is too long to be encoded.
+     */
+    static size_t encode(unsigned long long seq, const char *table, const char *key, db_write_op_t op, const char *query,
+            std::string& out);
+
+    /**!
+     * @brief Decodes the record at the start of a buffer.
+     *
+     * @param[in] buf Buffer.
+     * @param[in] len Length of the buffer.
+     * @param[out] rec Record.
+     *
+     * @returns Length of the record, 0 if the buffer does not hold all of it yet, -1 if it is corrupt.
+     */
+    static int decode(const unsigned char *buf, size_t len, db_change_rec_t *rec);
+
+    /**!
+     * @brief Appends the write of a row.
+     *
+     * @param[in] table Table of the row.
+     * @param[in] key Key of the row.
+     * @param[in] op Operation of the query.
+     * @param[in] query SQL query.
+     *
+     * @returns Sequence number of the record, 0 if it could not be encoded.
+     */
+    unsigned long long append(const char *table, const char *key, db_write_op_t op, const char *query);
+
+    /**!
+     * @brief Reads the records from a sequence number on.
+     *
+     * @param[in] from Sequence number of the first record to read.
+     * @param[in] max_bytes Records are read until this many bytes, at least one is read.
+     * @param[out] out Buffer the records are appended to.
+     * @param[out] next Sequence number of the record after the last one read.
+     *
+     * @returns Number of records read, -1 if the record from is no longer or not yet in the log.
+     */
+    int read(unsigned long long from, size_t max_bytes, std::string& out, unsigned long long *next);
+
+    /**!
+     * @brief Waits for a record to be appended.
+     *
+     * @param[in] seq Sequence number of the record.
+     * @param[in] timeout_ms Longest wait in milliseconds.
+     *
+     * @returns True if the record is in the log, false on timeout.
+     */
+    bool wait(unsigned long long seq, unsigned int timeout_ms);
+
+    /**!
+     * @brief Drops every record, e.g. after the database was recreated.
+     *
+     * The next record skips a sequence number, so a reader up to date with the dropped
+     * records must copy the whole database as well.
+     */
+    void reset();
+
+    /**!
+     * @brief Returns the sequence number of the last record appended, 0 if none.
+     */
+    unsigned long long get_last_seq();
+
+    /**!
+     * @brief Returns the id of the log.
+     */
+    unsigned long long get_id() const { return m_id; }
+
+    /**!
+     * @brief Returns the counters.
+     */
+    void get_stats(db_change_log_stats_t *stats);
+
+    /**!
+     * @brief Constructor for db_change_log_t, the log is empty and gets a new id.
+     */
+    db_change_log_t();
+
+    /**!
+     * @brief Destructor for db_change_log_t.
+     */
+    ~db_change_log_t();
+
+    db_change_log_t(const db_change_log_t&) = delete;
+    db_change_log_t& operator=(const db_change_log_t&) = delete;
+};
+
+#endif
@@ -19,24 +19,40 @@
 #ifndef DB_CLIENT_H
 #define DB_CLIENT_H
 
-#if defined(OPENWRT_BUILD) || defined(_PLATFORM_BANANAPI_R4_)
-// MariaDB C client header for cross compiled OpenWRT
-#include <mysql/mysql.h>
-#else
-// MariaDB C client header for a standard Linux install (Debian)
-#include <mariadb/mysql.h>
-#endif
+#include <pthread.h>
+#include <atomic>
+#include <vector>
+#include "db_write_queue.h"
+#include "db_snapshot.h"
+#include "db_change_log.h"
+#include "db_backend.h"
+
+#define DB_CLIENT_PREFETCH_THREADS  4   // connections reading the tables at start up
 
  /**!
   * @brief Database client class to manage database connections and queries.
   *
   * This class provides methods for initializing, executing queries,
-  * and retrieving results from a database using the MariaDB C client library.
+  * and retrieving results from a database through the storage backend the controller
+  * was built with, MariaDB or SQLite.
   *
-  * @note This class is not thread-safe.
+  * @note This class is not thread-safe. Once start_writer() is called, row writes go
+  *       through a write behind queue drained by a worker with its own connection.
   */
  class db_client_t {
-	MYSQL *m_con;    ///< MariaDB connection instance
+	db_backend_t *m_con;    ///< Database connection instance
+	db_backend_t *m_writer_con;    ///< Connection of the write behind worker
+	db_write_queue_t m_writer;
+	std::string m_path;    ///< Path the client connected with, background jobs open their own connection
+	db_snapshot_t m_snapshot;    ///< Snapshot the tables are loaded from at start up
+	pthread_t m_bg_thread;    ///< Thread of the snapshot or reconciliation job
+	bool m_bg_running;
+	std::atomic<bool> m_bg_done;
+	std::string m_bg_file;    ///< Snapshot written by the job, empty for a reconciliation
+	std::vector<std::string> m_stale;    ///< Tables of the snapshot that differ from the database
+	std::vector<db_snapshot_t *> m_prefetch;    ///< Tables read ahead at start up, one each
+	unsigned long long m_rows_read;    ///< Rows returned by next_result()
+	db_change_log_t *m_change_log;    ///< Log the row writes are appended to, NULL if none
 
 
 	 /**!
@@ -47,7 +63,8 @@
 	  * executing any database queries to ensure a valid connection is established.
 	  *
 	  * @param[in] path A constant character pointer representing the path to the
-	  * database in the format "username@password".
+	  * database in the format "username@password", or the database file for SQLite.
+	  * @param[out] con Pointer receiving the connection.
 	  *
 	  * @returns An integer indicating the success or failure of the connection
 	  * attempt.
@@ -57,7 +74,89 @@
 	  * @note Ensure that the database server is running and accessible before
 	  * calling this function. Failure to do so may result in a connection error.
 	  */
-	 int connect(const char *path);
+	 static int connect(const char *path, db_backend_t **con);
+
+
+	 /**!
+	  * @brief Read every row of a table into a snapshot.
+	  *
+	  * @param[in] con Connection to read on.
+	  * @param[in] table Name of the table.
+	  * @param[in] checksum Checksum recorded for the table.
+	  * @param[out] snap Snapshot the table is added to.
+	  *
+	  * @returns 0 on success, -1 on failure.
+	  */
+	 static int read_table(db_backend_t *con, const char *table, unsigned long long checksum, db_snapshot_t *snap);
+
+
+	 /**!
+	  * @brief Read the rows of the tables of the database into a snapshot.
+	  *
+	  * @param[out] snap Snapshot the tables are added to.
+	  * @param[in] tables Tables to read, NULL for every table. A table the database does not have is skipped.
+	  *
+	  * @returns 0 on success, -1 on failure.
+	  */
+	 int read_snapshot(db_snapshot_t *snap, const std::vector<std::string> *tables);
+
+
+	 /**!
+	  * @brief Replace the rows of the tables of a loaded snapshot with those of the snapshot.
+	  *
+	  * The statements are built from the values of the snapshot, which may come from a peer,
+	  * so a snapshot naming a table the database does not have is refused as a whole.
+	  *
+	  * @param[in] snap Loaded snapshot.
+	  *
+	  * @returns 0 on success, -1 if a table is unknown or could not be written.
+	  */
+	 int restore_tables(const db_snapshot_t& snap);
+
+
+	 /**!
+	  * @brief Prefetch thread, reads tables on a connection of its own until none is left.
+	  *
+	  * @param[in] arg Pointer to the prefetch job.
+	  */
+	 static void *prefetch_run(void *arg);
+
+
+	 /**!
+	  * @brief Writes a batch of queries as one transaction on the writer connection.
+	  *
+	  * A statement that fails is skipped, the statements after it are still written.
+	  *
+	  * @param[in] arg Pointer to the database client.
+	  * @param[in] queries Queries, in order.
+	  * @param[in] num Number of queries.
+	  * @param[out] failed Set for each query that failed.
+	  */
+	 static void write_batch(void *arg, char **queries, unsigned int num, bool *failed);
+
+
+	 /**!
+	  * @brief Background job, writes a snapshot or compares the loaded one with the database.
+	  *
+	  * @param[in] arg Pointer to the database client.
+	  */
+	 static void *background(void *arg);
+
+
+	 /**!
+	  * @brief Start a background job.
+	  *
+	  * @param[in] file Snapshot to write, NULL to reconcile the loaded snapshot.
+	  *
+	  * @returns 0 on success, -1 if a job is running or the thread could not be created.
+	  */
+	 int start_background(const char *file);
+
+
+	 /**!
+	  * @brief Wait for the background job to finish.
+	  */
+	 void stop_background();
 
  public:
 
@@ -94,6 +193,16 @@
 	 void *execute(const char *query);
 
 
+	 /**!
+	  * @brief List the tables of the database.
+	  *
+	  * @param[out] tables Names of the tables.
+	  *
+	  * @returns 0 on success, -1 on failure.
+	  */
+	 int get_tables(std::vector<std::string>& tables);
+
+
 	 /**!
 	  * @brief Retrieve the next result from the query execution.
 	  *
@@ -111,6 +220,210 @@
 	 bool next_result(void *ctx);
 
 
+	 /**!
+	  * @brief Start the write behind worker on a second connection.
+	  *
+	  * From then on write() queues row mutations instead of executing them.
+	  *
+	  * @param[in] path Path to the database in the format "username@password".
+	  *
+	  * @returns 0 on success, -1 on failure, writes then stay synchronous.
+	  */
+	 int start_writer(const char *path);
+
+
+	 /**!
+	  * @brief Write what is queued, stop the worker and close its connection.
+	  */
+	 void stop_writer();
+
+
+	 /**!
+	  * @brief Insert, update or delete a row.
+	  *
+	  * The query is queued when the write behind worker runs, executed otherwise.
+	  *
+	  * @param[in] table Table of the row.
+	  * @param[in] key Key of the row, value of its first column.
+	  * @param[in] op Operation of the query.
+	  * @param[in] query SQL query.
+	  *
+	  * @returns 0 on success, -1 on failure.
+	  */
+	 int write(const char *table, const char *key, db_write_op_t op, const char *query);
+
+
+	 /**!
+	  * @brief Append every row write from now on to a change log.
+	  *
+	  * @param[in] log Change log, NULL to stop logging.
+	  */
+	 void set_change_log(db_change_log_t *log) { m_change_log = log; }
+
+
+	 /**!
+	  * @brief Replace the rows of the tables of a snapshot file with those of the snapshot.
+	  *
+	  * Each table is written as one transaction, tables of the database missing from the
+	  * snapshot are left as they are.
+	  *
+	  * @param[in] file Path of the snapshot.
+	  *
+	  * @returns 0 on success, -1 if the snapshot is not valid or a table could not be written.
+	  */
+	 int restore_snapshot(const char *file);
+
+
+	 /**!
+	  * @brief Replace the rows of the tables of a snapshot image with those of the snapshot.
+	  *
+	  * @param[in,out] image Image of the snapshot, see save_snapshot(std::string&), left empty.
+	  *
+	  * @returns 0 on success, -1 if the image is not valid or a table could not be written.
+	  */
+	 int restore_snapshot(std::string& image);
+
+
+	 /**!
+	  * @brief Wait until every queued write is committed.
+	  *
+	  * @note Required before queries that depend on the rows written, e.g. a table reload or reset.
+	  */
+	 void flush();
+
+
+	 /**!
+	  * @brief Return the operation of a write of a row that is not committed yet.
+	  *
+	  * @param[in] table Table of the row.
+	  * @param[in] key Key of the row.
+	  * @param[out] op Operation of the write.
+	  *
+	  * @returns True if a write of the row is pending, false otherwise.
+	  */
+	 bool get_pending(const char *table, const char *key, db_write_op_t *op) { return m_writer.get_pending(table, key, op); }
+
+
+	 /**!
+	  * @brief Return the write behind queue depth and counters.
+	  *
+	  * @param[out] stats Pointer to the counters.
+	  */
+	 void get_writer_stats(db_write_queue_stats_t *stats) { m_writer.get_stats(stats); }
+
+
+	 /**!
+	  * @brief Write the rows of every table to a snapshot file.
+	  *
+	  * Queued writes are committed first. The rows are read on a connection of their own,
+	  * so the call can run on any thread.
+	  *
+	  * @param[in] file Path of the snapshot.
+	  *
+	  * @returns 0 on success, -1 on failure.
+	  */
+	 int save_snapshot(const char *file);
+
+
+	 /**!
+	  * @brief Write the rows of some tables to a snapshot image in memory.
+	  *
+	  * Queued writes are committed first, the rows are read on a connection of their own.
+	  *
+	  * @param[out] image Buffer the image is appended to.
+	  * @param[in] tables Tables to write, NULL for every table.
+	  *
+	  * @returns 0 on success, -1 on failure.
+	  */
+	 int save_snapshot(std::string& image, const std::vector<std::string> *tables = NULL);
+
+
+	 /**!
+	  * @brief Write a snapshot on a background thread.
+	  *
+	  * @param[in] file Path of the snapshot.
+	  *
+	  * @returns 0 if the job started, -1 if another job is running.
+	  */
+	 int start_snapshot(const char *file) { return start_background(file); }
+
+
+	 /**!
+	  * @brief Load a snapshot, the tables are then read from it instead of the database.
+	  *
+	  * @param[in] file Path of the snapshot.
+	  *
+	  * @returns 0 on success, -1 if there is no valid snapshot.
+	  */
+	 int open_snapshot(const char *file) { return m_snapshot.load(file); }
+
+
+	 /**!
+	  * @brief Unload the snapshot, later reads go to the database.
+	  */
+	 void close_snapshot() { m_snapshot.unload(); }
+
+
+	 /**!
+	  * @brief Return true if the tables are read from a snapshot.
+	  */
+	 bool has_snapshot() const { return m_snapshot.is_loaded(); }
+
+
+	 /**!
+	  * @brief Read the rows of a table from the loaded snapshot or the tables read ahead.
+	  *
+	  * @param[in] table Name of the table.
+	  *
+	  * @returns Result context used like the one of execute(), NULL if neither holds the table.
+	  */
+	 void *execute_snapshot(const char *table);
+
+
+	 /**!
+	  * @brief Read tables ahead, in parallel on connections of their own.
+	  *
+	  * The rows are kept in memory and execute_snapshot() returns them until close_prefetch(),
+	  * so the tables are then loaded one after the other without waiting for the database.
+	  * Tables missing from the database or that failed to read are left to the queries.
+	  *
+	  * @param[in] tables Names of the tables.
+	  *
+	  * @returns Number of tables read.
+	  */
+	 unsigned int prefetch(const std::vector<std::string>& tables);
+
+
+	 /**!
+	  * @brief Release the tables read ahead.
+	  */
+	 void close_prefetch();
+
+
+	 /**!
+	  * @brief Return the number of rows next_result() returned so far.
+	  */
+	 unsigned long long get_rows_read() const { return m_rows_read; }
+
+
+	 /**!
+	  * @brief Compare the checksums of the loaded snapshot with the database on a background thread.
+	  *
+	  * @returns 0 if the job started, -1 if no snapshot is loaded or another job is running.
+	  */
+	 int start_reconcile();
+
+
+	 /**!
+	  * @brief Return the tables that changed since the snapshot once the reconciliation is done.
+	  *
+	  * @param[out] stale Names of the tables to reload from the database.
+	  *
+	  * @returns True if the reconciliation finished, false while it runs or if none was started.
+	  */
+	 bool get_reconciled(std::vector<std::string>& stale);
+
+
 	 /**!
 	  * @brief Retrieve a string value from the result context.
 	  *
@@ -142,6 +455,19 @@
 	 int get_number(void *ctx, unsigned int col);
 
 
+	 /**!
+	  * @brief Retrieve the bytes of a blob value from the result context.
+	  *
+	  * @param[in] ctx Result context from which the value is retrieved.
+	  * @param[out] buff Buffer the bytes are copied to.
+	  * @param[in] max Size of buff, the bytes past it are dropped.
+	  * @param[in] col Column index from which to retrieve the value (1-based).
+	  *
+	  * @returns Number of bytes copied, 0 for a NULL value or on error.
+	  */
+	 unsigned int get_blob(void *ctx, unsigned char *buff, unsigned int max, unsigned int col);
+
+
 	 /**!
 	  * @brief Recreate the database, deleting existing data and creating a fresh structure.
 	  *
@@ -170,6 +496,9 @@
 	  * @note This destructor is automatically called when the db_client_t object goes out of scope.
 	  */
 	 ~db_client_t();
+
+	 db_client_t(const db_client_t&) = delete;
+	 db_client_t& operator=(const db_client_t&) = delete;
  };
 
  #endif
@@ -19,6 +19,7 @@
 #ifndef DB_EASY_MESH_H
 #define DB_EASY_MESH_H
 
+#include <stdarg.h>
 #include "em_base.h"
 #include "db_column.h"
 #include "db_client.h"
@@ -151,6 +152,19 @@ public:
 	 * @note Ensure that the position is within the valid range for the specified format.
 	 */
 	char *get_column_format(db_fmt_t fmt, unsigned int pos);
+
+	/**!
+	 * @brief Builds the key identifying a row from the arguments of a row query.
+	 *
+	 * The key is the value of the first column, followed by those of the next key columns
+	 * separated by '@', it names the row in the write behind queue of the database client.
+	 *
+	 * @param[out] key Buffer receiving the key.
+	 * @param[in] first_col Column of the first argument, the arguments follow the column order and wrap to column 0.
+	 * @param[in] num_key_cols Number of columns of the key.
+	 * @param[in] list Arguments of the query.
+	 */
+	void get_row_key(em_2xlong_string_t key, unsigned int first_col, unsigned int num_key_cols, va_list list);
     
 	/**!
 	 * @brief Retrieves strings based on a specified token.
@@ -262,6 +276,35 @@ public:
 	 */
 	bool entry_exists_in_table(db_client_t& db_client, void *key);
 
+	/**!
+	 * @brief Selects the rows whose first column equals a key.
+	 *
+	 * The first column holds the key of the rows and is indexed, the rows are found without a scan of the table.
+	 *
+	 * @param[in] db_client Reference to the database client managing the table.
+	 * @param[in] key Value of the first column.
+	 * @param[in] max Maximum number of rows, 0 for all of them.
+	 *
+	 * @returns Result context of the rows, NULL if there are none or on failure.
+	 */
+	void *select_by_key(db_client_t& db_client, const char *key, unsigned int max);
+
+	/**!
+	 * @brief Creates the index on the key column of an existing table if it is missing.
+	 *
+	 * @param[in] db_client Reference to the database client managing the table.
+	 */
+	void create_key_index(db_client_t& db_client);
+
+	/**!
+	 * @brief Changes the binary columns that an older table has as text to blob.
+	 *
+	 * The rows keep their values, sync_db() of the table converts the ones still in hex.
+	 *
+	 * @param[in] db_client Reference to the database client managing the table.
+	 */
+	void upgrade_columns(db_client_t& db_client);
+
     
 	/**!
 	 * @brief Inserts a row into the database using the provided database client.
@@ -0,0 +1,216 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef DB_SNAPSHOT_H
+#define DB_SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define DB_SNAPSHOT_MAGIC       0x50414e5342444d45ULL  // "EMDBSNAP"
+#define DB_SNAPSHOT_VERSION     1
+#define DB_SNAPSHOT_MAX_TABLES  32
+#define DB_SNAPSHOT_MAX_COLS    32
+#define DB_SNAPSHOT_NAME_LEN    64
+#define DB_SNAPSHOT_NULL        0xffffffffU             // length of a NULL value
+
+/*
+ * File layout, host byte order: the header, the directory of num_tables tables, then the
+ * rows of each table at its offset. A row is num_cols values, each a 32 bit length and the
+ * bytes of the value followed by a nul, so values are read in place from the mapping.
+ */
+typedef struct {
+    uint64_t    magic;
+    uint32_t    version;
+    uint32_t    num_tables;
+    uint64_t    size;               // bytes of the whole file
+} db_snapshot_hdr_t;
+
+typedef struct {
+    char        name[DB_SNAPSHOT_NAME_LEN];
+    uint32_t    num_rows;
+    uint32_t    num_cols;
+    uint64_t    offset;
+    uint64_t    len;
+    uint64_t    checksum;           // table checksum reported by the database when the rows were read
+} db_snapshot_table_hdr_t;
+
+typedef struct {
+    const char      *pos;
+    const char      *end;
+    unsigned int    num_cols;
+    const char      *cols[DB_SNAPSHOT_MAX_COLS];    // NULL for a NULL value
+    unsigned long   lens[DB_SNAPSHOT_MAX_COLS];
+} db_snapshot_cursor_t;
+
+/*
+ * Binary copy of the rows of the database tables, read back at start up instead of
+ * selecting and fetching every table. Rows are added table by table and saved to a
+ * temporary file renamed over the snapshot, a loaded snapshot is mapped read only and
+ * validated before any row is read. The caller decides if the rows are still current,
+ * e.g. by comparing the table checksums with those of the database. The tables added can
+ * also be sealed in memory and read as if a file of them was loaded, or written to a
+ * buffer and loaded from it on another host.
+ */
+class db_snapshot_t {
+
+    std::vector<db_snapshot_table_hdr_t>    m_tables;
+    std::string     m_rows;             // rows of the tables added, in order
+    std::string     m_image;            // image sealed in memory, m_map points to it then
+    void            *m_map;
+    size_t          m_map_sz;
+    const db_snapshot_table_hdr_t   *m_dir;
+
+    /**!
+     * @brief Checks the header and directory of a mapped snapshot.
+     *
+     * @returns 0 if the snapshot can be read, -1 otherwise.
+     */
+    int validate();
+
+public:
+
+    /**!
+     * @brief Starts the rows of a table, the rows added next belong to it.
+     *
+     * @param[in] name Name of the table.
+     * @param[in] num_cols Number of columns of its rows.
+     * @param[in] checksum Checksum of the table.
+     *
+     * @returns 0 on success, -1 if there are too many tables or columns.
+     */
+    int add_table(const char *name, unsigned int num_cols, unsigned long long checksum);
+
+    /**!
+     * @brief Adds a row to the last table.
+     *
+     * @param[in] vals Values of the columns, NULL for a NULL value.
+     * @param[in] lens Lengths of the values.
+     *
+     * @returns 0 on success, -1 if no table was added.
+     */
+    int add_row(const char *const *vals, const unsigned long *lens);
+
+    /**!
+     * @brief Writes the tables added to a file, replacing it atomically.
+     *
+     * @param[in] file Path of the snapshot.
+     *
+     * @returns 0 on success, -1 on failure, the previous snapshot is then left in place.
+     */
+    int save(const char *file);
+
+    /**!
+     * @brief Writes the tables added to a buffer, laid out as in a file.
+     *
+     * @param[out] out Buffer the image is appended to.
+     */
+    void save_image(std::string& out);
+
+    /**!
+     * @brief Loads a snapshot from a buffer laid out as in a file, e.g. received from a peer.
+     *
+     * @param[in,out] image Image of the snapshot, taken over by the snapshot and left empty.
+     *
+     * @returns 0 on success, -1 if the image is of another version or corrupt.
+     */
+    int load_image(std::string& image);
+
+    /**!
+     * @brief Makes the tables added readable in place of a loaded snapshot, without a file.
+     *
+     * @returns 0 on success, -1 if a snapshot is already loaded.
+     */
+    int seal();
+
+    /**!
+     * @brief Maps a snapshot file.
+     *
+     * @param[in] file Path of the snapshot.
+     *
+     * @returns 0 on success, -1 if the file is missing, of another version or corrupt.
+     */
+    int load(const char *file);
+
+    /**!
+     * @brief Unmaps the loaded or sealed snapshot, the values read from it become invalid.
+     */
+    void unload();
+
+    /**!
+     * @brief Returns true if a snapshot is loaded.
+     */
+    bool is_loaded() const { return m_map != NULL; }
+
+    /**!
+     * @brief Returns the number of tables of the loaded snapshot.
+     */
+    unsigned int get_num_tables() const;
+
+    /**!
+     * @brief Returns the directory entry of a table of the loaded snapshot.
+     *
+     * @param[in] idx Index of the table.
+     */
+    const db_snapshot_table_hdr_t *get_table(unsigned int idx) const;
+
+    /**!
+     * @brief Returns the directory entry of a table of the loaded snapshot.
+     *
+     * @param[in] name Name of the table.
+     *
+     * @returns Pointer to the entry, NULL if the snapshot has no such table.
+     */
+    const db_snapshot_table_hdr_t *get_table(const char *name) const;
+
+    /**!
+     * @brief Positions a cursor before the first row of a table.
+     *
+     * @param[in] name Name of the table.
+     * @param[out] cur Cursor.
+     *
+     * @returns 0 on success, -1 if the snapshot has no such table.
+     */
+    int open_table(const char *name, db_snapshot_cursor_t *cur) const;
+
+    /**!
+     * @brief Reads the next row of a table.
+     *
+     * @param[in,out] cur Cursor, receives the values of the row.
+     *
+     * @returns True if a row was read, false at the end of the table or on a corrupt row.
+     */
+    bool next_row(db_snapshot_cursor_t *cur) const;
+
+    /**!
+     * @brief Constructor for db_snapshot_t, nothing is loaded.
+     */
+    db_snapshot_t();
+
+    /**!
+     * @brief Destructor for db_snapshot_t, unmaps the loaded snapshot.
+     */
+    ~db_snapshot_t();
+
+    db_snapshot_t(const db_snapshot_t&) = delete;
+    db_snapshot_t& operator=(const db_snapshot_t&) = delete;
+};
+
+#endif
@@ -0,0 +1,190 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef DB_WRITE_QUEUE_H
+#define DB_WRITE_QUEUE_H
+
+#include <pthread.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#define DB_WRITE_QUEUE_MAX_DEPTH    4096
+#define DB_WRITE_QUEUE_BATCH_SZ     64
+#define DB_WRITE_QUEUE_MAX_QUERY    65536   // multi row inserts stop growing past this length
+
+typedef enum {
+    db_write_op_insert,
+    db_write_op_update,
+    db_write_op_delete,
+} db_write_op_t;
+
+typedef struct db_write_s {
+    std::vector<std::string>    ids{};  // table and key of the rows, an insert can hold several
+    db_write_op_t   op = db_write_op_insert;
+    char            *query = NULL;
+    bool            in_flight = false;  // taken by the worker, no longer coalesced
+    struct db_write_s   *next = NULL;
+} db_write_t;
+
+typedef struct {
+    unsigned int        depth;          // rows queued or being written
+    unsigned int        max_depth;
+    unsigned long long  queued;
+    unsigned long long  coalesced;      // writes merged into a pending write of the same row
+    unsigned long long  merged;         // inserts appended to a pending multi row insert
+    unsigned long long  written;
+    unsigned long long  failed;
+    unsigned long long  batches;
+    unsigned long long  stalls;         // pushes that waited for the queue to drain
+} db_write_queue_stats_t;
+
+/*
+ * Writes a batch of queries, in order, as one transaction, and sets failed[i] for each
+ * query that could not be written.
+ */
+typedef void (*db_write_batch_t)(void *arg, char **queries, unsigned int num, bool *failed);
+
+/*
+ * Write behind queue of row mutations. The caller pushes the query of each insert, update
+ * or delete with the table and key of its row and returns immediately, a worker thread
+ * writes the queue in batches. An update or delete of a row whose pending update was not
+ * picked up yet replaces it, consecutive inserts into a table are merged into one multi
+ * row insert. Until a write is committed get_pending() reports it, so the caller can keep
+ * answering from its own copy of the data. Thread safe.
+ */
+class db_write_queue_t {
+
+    pthread_mutex_t m_lock;
+    pthread_cond_t  m_work_cond;        // signalled on push and on stop
+    pthread_cond_t  m_idle_cond;        // signalled when a batch completes
+    pthread_t       m_thread;
+    bool            m_running;
+    bool            m_exit;
+    db_write_batch_t    m_batch;
+    void            *m_arg;
+    unsigned int    m_batch_sz;
+    db_write_t      *m_head;
+    db_write_t      *m_tail;
+    std::unordered_map<std::string, db_write_t *> m_pending;    // latest write of each row
+    db_write_queue_stats_t  m_stats;
+
+    /**!
+     * @brief Worker thread, writes the queue until stop() is called.
+     *
+     * @param[in] arg Pointer to the queue.
+     */
+    static void *writer(void *arg);
+
+    /**!
+     * @brief Writes the next batch, the lock is released while the batch is written.
+     *
+     * @returns Number of writes of the batch.
+     */
+    unsigned int write_batch();
+
+    /**!
+     * @brief Builds the id of a row from its table and key.
+     */
+    static std::string get_id(const char *table, const char *key);
+
+    /**!
+     * @brief Appends the values of an insert to the pending insert at the tail of the queue.
+     *
+     * @param[in] id Id of the row.
+     * @param[in] query Insert query.
+     *
+     * @returns True if the row was merged, false if the query was not an insert with the same columns or does not fit.
+     */
+    bool merge_insert(const std::string& id, const char *query);
+
+public:
+
+    /**!
+     * @brief Starts the worker thread.
+     *
+     * @param[in] batch Function writing a batch of queries.
+     * @param[in] arg Argument passed to the batch function.
+     * @param[in] batch_sz Maximum number of queries of a batch.
+     *
+     * @returns 0 on success, -1 if the thread could not be created.
+     */
+    int start(db_write_batch_t batch, void *arg, unsigned int batch_sz);
+
+    /**!
+     * @brief Writes what is queued and stops the worker thread.
+     */
+    void stop();
+
+    /**!
+     * @brief Returns true if the worker thread is running.
+     */
+    bool is_running() const { return m_running; }
+
+    /**!
+     * @brief Queues the write of a row.
+     *
+     * @param[in] table Table of the row.
+     * @param[in] key Key of the row, value of its first column.
+     * @param[in] op Operation of the query.
+     * @param[in] query Query, copied.
+     *
+     * @returns 0 on success, -1 if the worker is not running or on allocation failure.
+     *
+     * @note Blocks while the queue holds DB_WRITE_QUEUE_MAX_DEPTH writes.
+     */
+    int push(const char *table, const char *key, db_write_op_t op, const char *query);
+
+    /**!
+     * @brief Waits until every write queued before the call is committed.
+     */
+    void flush();
+
+    /**!
+     * @brief Returns the operation of the latest write of a row that is not committed yet.
+     *
+     * @param[in] table Table of the row.
+     * @param[in] key Key of the row.
+     * @param[out] op Operation of the write.
+     *
+     * @returns True if a write of the row is pending, false otherwise.
+     */
+    bool get_pending(const char *table, const char *key, db_write_op_t *op);
+
+    /**!
+     * @brief Returns the queue depth and write counters.
+     *
+     * @param[out] stats Pointer to the counters.
+     */
+    void get_stats(db_write_queue_stats_t *stats);
+
+    /**!
+     * @brief Constructor for db_write_queue_t, the worker is not started.
+     */
+    db_write_queue_t();
+
+    /**!
+     * @brief Destructor for db_write_queue_t, stops the worker after writing the queue.
+     */
+    ~db_write_queue_t();
+
+    db_write_queue_t(const db_write_queue_t&) = delete;
+    db_write_queue_t& operator=(const db_write_queue_t&) = delete;
+};
+
+#endif
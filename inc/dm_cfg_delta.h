@@ -0,0 +1,75 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef DM_CFG_DELTA_H
+#define DM_CFG_DELTA_H
+
+#include "em_base.h"
+
+#define DM_CFG_DELTA_NONE       0x0
+#define DM_CFG_DELTA_CHANNEL    0x1     // current operating class, channel or transmit power, what an Operating Channel Report carries
+#define DM_CFG_DELTA_RADIO      0x2     // other configuration of a radio or its operating classes
+#define DM_CFG_DELTA_BSS        0x4     // configuration of a BSS
+#define DM_CFG_DELTA_NEW        0x8     // radio, operating class or BSS not known yet
+#define DM_CFG_DELTA_BACKHAUL   0x10    // a connected backhaul STA moved to another parent, nothing else changed
+
+/*
+ * Field level comparison of the radio and VAP configuration decoded from a OneWifi
+ * subdoc with the one of the data model, so that a callback that repeats the current
+ * configuration commits nothing and sends nothing, and one that only moves the channel
+ * only reports the channel. Only the fields a subdoc carries are compared; counters,
+ * measurements and the policies set by the controller are not, a subdoc does not hold
+ * them.
+ */
+class dm_cfg_delta_t {
+
+public:
+
+    /**!
+     * @brief Compares the configuration of a radio.
+     *
+     * @param[in] cur The radio of the data model, NULL if unknown.
+     * @param[in] dec The radio decoded from the subdoc.
+     *
+     * @returns DM_CFG_DELTA_ flags of what differs.
+     */
+    static unsigned int radio(const em_radio_info_t *cur, const em_radio_info_t *dec);
+
+    /**!
+     * @brief Compares an operating class of a radio.
+     *
+     * @param[in] cur The operating class of the data model, NULL if unknown.
+     * @param[in] dec The operating class decoded from the subdoc.
+     *
+     * @returns DM_CFG_DELTA_ flags of what differs, DM_CFG_DELTA_CHANNEL for the current operating class.
+     */
+    static unsigned int op_class(const em_op_class_info_t *cur, const em_op_class_info_t *dec);
+
+    /**!
+     * @brief Compares the configuration of a BSS.
+     *
+     * @param[in] cur The BSS of the data model, NULL if unknown.
+     * @param[in] dec The BSS decoded from the subdoc.
+     *
+     * @returns DM_CFG_DELTA_ flags of what differs, DM_CFG_DELTA_BACKHAUL alone when a backhaul
+     * STA that stays connected only changed BSSID.
+     */
+    static unsigned int bss(const em_bss_info_t *cur, const em_bss_info_t *dec);
+};
+
+#endif
@@ -20,6 +20,7 @@
 #define DM_EM_H
 #include <vector>
 #include <atomic>
+#include <bitset>
 #include "em_base.h"
 #include "wifi_webconfig.h"
 #include "dm_device.h"
@@ -38,7 +39,11 @@
 #include "dm_ap_mld.h"
 #include "dm_bsta_mld.h"
 #include "dm_assoc_sta_mld.h"
+#include "dm_mld_index.h"
+#include "dm_op_class_index.h"
 #include "dm_tid_to_link.h"
+#include "dm_key_map.h"
+#include "dm_section.h"
 #include "webconfig_external_proto.h"
 
 #define GLOBAL_NET_ID "OneWifiMesh"
@@ -47,7 +52,10 @@ class em_t;
 
 class dm_easy_mesh_t {
     static std::atomic<int> s_counter;
+    static std::atomic<unsigned int> s_generation;
     int m_instance_num;
+    unsigned int m_generation = 0;  // value of s_generation at the last change
+    unsigned int m_radio_generation = 0;    // value of s_generation at the last radio or radio capability change
     bool m_topo_changed = false;
 
 public:
@@ -72,21 +80,30 @@ public:
     dm_op_class_t m_op_class[EM_MAX_OPCLASS];
 	unsigned int	m_num_policy;
 	dm_policy_t	m_policy[EM_MAX_POLICIES];
-	hash_map_t		*m_scan_result_map = NULL;
-    hash_map_t  	*m_sta_map = NULL;
-    hash_map_t      *m_sta_assoc_map = NULL;
-    hash_map_t      *m_sta_dassoc_map = NULL;
+	dm_key_map_t	*m_scan_result_map = NULL;
+    dm_key_map_t  	*m_sta_map = NULL;
+    dm_key_map_t    *m_sta_assoc_map = NULL;
+    dm_key_map_t    *m_sta_dassoc_map = NULL;
     dm_cac_comp_t	m_cac_comp;
     unsigned short           msg_id;
     em_db_cfg_param_t	m_db_cfg_param;
+    std::bitset<EM_MAX_BSSS>    m_bss_dirty;        // rows to write when the list update bit is not set
+    std::bitset<EM_MAX_OPCLASS> m_op_class_dirty;
+    unsigned int    m_num_dirty_sta;    // STAs of m_sta_map marked through set_sta_dirty()
     em_t *m_em;
     bool    m_colocated;
     unsigned int    m_num_ap_mld;
-    dm_ap_mld_t     m_ap_mld[EM_MAX_AP_MLD];
+    dm_section_t<dm_ap_mld_t, EM_MAX_AP_MLD> m_ap_mld;
     unsigned int    m_num_bsta_mld;
-    dm_bsta_mld_t   m_bsta_mld[EM_MAX_BSTA_MLD];
+    dm_section_t<dm_bsta_mld_t, EM_MAX_BSTA_MLD> m_bsta_mld;
     unsigned int    m_num_assoc_sta_mld;
-    dm_assoc_sta_mld_t m_assoc_sta_mld[EM_MAX_ASSOC_STA_MLD];
+    dm_section_t<dm_assoc_sta_mld_t, EM_MAX_ASSOC_STA_MLD> m_assoc_sta_mld;
+    dm_mld_index_t  m_ap_mld_index;             // of m_ap_mld, rebuilt when m_num_ap_mld is not what it was built for
+    unsigned int    m_ap_mld_indexed = 0;
+    dm_mld_index_t  m_assoc_sta_mld_index;      // of m_assoc_sta_mld, same
+    unsigned int    m_assoc_sta_mld_indexed = 0;
+    dm_op_class_index_t m_op_class_index;       // of m_op_class, rebuilt when m_num_opclass is not what it was built for
+    unsigned int    m_op_class_indexed = 0;
     dm_tid_to_link_t m_tid_to_link;
 
 public:
@@ -95,6 +112,12 @@ public:
 	void set_topo_state(bool state) { m_topo_changed = state; }
 	void set_id() { m_instance_num = ++s_counter; }
 	int get_id() const { return m_instance_num; }
+	void set_changed() { m_generation = ++s_generation; }
+	unsigned int get_generation() const { return m_generation; }
+	static unsigned int next_generation() { return ++s_generation; }
+	static unsigned int get_last_generation() { return s_generation; }
+	void set_radio_changed() { set_changed(); m_radio_generation = m_generation; }
+	unsigned int get_radio_generation() const { return m_radio_generation; }
 
 	static em_e4_table_t m_e4_table[];
 	
@@ -1226,6 +1249,61 @@ public:
 	 * @note Ensure that the index is within the valid range to avoid undefined behavior.
 	 */
 	dm_op_class_t& get_op_class_by_ref(unsigned int index) { return m_op_class[index]; }
+
+	/**!
+	 * @brief Applies a full report of operating classes in one pass, e.g. all of a Channel Preference TLV.
+	 *
+	 * Each entry is matched on its radio, type and class. Entries whose class, channel or
+	 * channel list changed are updated, new ones appended, and only those are marked
+	 * through set_op_class_dirty(), so the next DB update writes the changed rows instead
+	 * of the whole list. Operating classes missing from the report are left as they are.
+	 *
+	 * @param[in] op_classes Operating classes of the report.
+	 * @param[in] num Number of operating classes.
+	 * @param[in] match_class false to match on radio and type only, for the single current operating class of a radio.
+	 *
+	 * @returns Number of operating classes updated or appended.
+	 */
+	unsigned int apply_op_classes(const em_op_class_info_t *op_classes, unsigned int num, bool match_class = true);
+
+	/**!
+	 * @brief Rebuilds the index of the operating classes, for writers of m_op_class that change the radio, type or class of entries.
+	 */
+	void reindex_op_class();
+
+	/**!
+	 * @brief Updates the index of one operating class written in place or appended as the last one.
+	 *
+	 * @param[in] idx Index of the operating class in m_op_class.
+	 */
+	void index_op_class(unsigned int idx);
+
+	/**!
+	 * @brief Returns the index entry of a radio, type and class, checked against m_op_class.
+	 *
+	 * @returns The entry, NULL if the operating class is not indexed.
+	 */
+	const dm_op_class_index_entry_t *get_op_class_entry(const unsigned char *ruid, em_op_class_type_t type, unsigned int op_class);
+
+	/**!
+	 * @brief Returns the operating class of a radio, type and class.
+	 *
+	 * @param[in] ruid Radio unique identifier, or the AL MAC for the types kept per agent.
+	 * @param[in] type Operating class type.
+	 * @param[in] op_class Operating class.
+	 * @param[out] idx Receives the index of the operating class in m_op_class, may be NULL.
+	 *
+	 * @returns The operating class, NULL if there is none.
+	 */
+	em_op_class_info_t *find_op_class(const unsigned char *ruid, em_op_class_type_t type, unsigned int op_class, unsigned int *idx = NULL);
+
+	/**!
+	 * @brief Returns whether a radio may operate on a channel of an operating class.
+	 *
+	 * A radio may not if its capabilities do not have the class or list the channel as non
+	 * operable in it. A radio whose capabilities are not known is not restricted.
+	 */
+	bool is_channel_allowed(const unsigned char *ruid, unsigned int op_class, unsigned int channel);
 	
 	/**!
 	 * @brief Prints the operational class list.
@@ -1470,7 +1548,7 @@ public:
 	 *
 	 * @returns The number of scan results.
 	 */
-	unsigned int	get_num_scan_results() { return hash_map_count(m_scan_result_map); }
+	unsigned int	get_num_scan_results() { return m_scan_result_map->count(); }
 	
 	/**!
 	 * @brief Retrieves the scan result at the specified index.
@@ -1537,8 +1615,10 @@ public:
 	 * This function assigns the provided number to the member variable m_num_ap_mld.
 	 *
 	 * @param[in] num The number of AP MLD to set.
+	 *
+	 * @note The AP MLD section grows to hold num entries, the number is capped at what it could hold.
 	 */
-	void set_num_ap_mld(unsigned int num) { m_num_ap_mld = num; }
+	void set_num_ap_mld(unsigned int num) { m_num_ap_mld = (m_ap_mld.reserve(num) == 0) ? num:m_ap_mld.get_size(); }
     
 	/**!
 	 * @brief Sets the number of AP MLDs in the EasyMesh configuration.
@@ -1622,6 +1702,79 @@ public:
 	 */
 	static unsigned int get_num_assoc_sta_mld(void *dm) { return (static_cast<dm_easy_mesh_t *>(dm))->get_num_assoc_sta_mld(); }
 
+	/**!
+	 * @brief Rebuilds the index of the AP MLDs, for writers of m_ap_mld that go around set_ap_mld().
+	 */
+	void reindex_ap_mld();
+
+	/**!
+	 * @brief Rebuilds the index of the associated STA MLDs.
+	 */
+	void reindex_assoc_sta_mld();
+
+	/**!
+	 * @brief Returns the AP MLD of an MLD MAC address.
+	 *
+	 * @param[in] mld_mac MAC address of the AP MLD.
+	 * @param[out] idx Receives the index of the AP MLD in m_ap_mld, may be NULL.
+	 *
+	 * @returns The AP MLD, NULL if there is none.
+	 */
+	em_ap_mld_info_t *find_ap_mld(const unsigned char *mld_mac, unsigned int *idx = NULL);
+
+	/**!
+	 * @brief Returns the affiliated AP of a BSSID.
+	 *
+	 * @param[in] bssid BSSID of the affiliated AP.
+	 * @param[out] mld Receives the AP MLD it is affiliated to, may be NULL.
+	 *
+	 * @returns The affiliated AP, NULL if the BSS is not affiliated to an AP MLD.
+	 */
+	em_affiliated_ap_info_t *find_affiliated_ap(const unsigned char *bssid, em_ap_mld_info_t **mld = NULL);
+
+	/**!
+	 * @brief Returns the associated STA MLD of an MLD MAC address or of the MAC address of one of its links.
+	 *
+	 * @returns The STA MLD, NULL if there is none.
+	 */
+	em_assoc_sta_mld_info_t *find_assoc_sta_mld(const unsigned char *mac);
+
+	/**!
+	 * @brief Sets an AP MLD as reported, the AP MLD of the same MLD MAC address is replaced.
+	 *
+	 * An AP MLD without MLD MAC address replaces the one its first affiliated AP belongs to.
+	 * Only an AP MLD that differs is written, and only its links are indexed again.
+	 *
+	 * @param[in] info The AP MLD.
+	 * @param[out] idx Receives the index of the AP MLD in m_ap_mld.
+	 * @param[out] delta Receives the affiliated APs added, changed and removed, matched by MAC address, may be NULL.
+	 *
+	 * @returns 1 if the AP MLD changed, 0 if not, -1 if m_ap_mld is full.
+	 */
+	int set_ap_mld(const em_ap_mld_info_t *info, unsigned int *idx, em_ap_mld_delta_t *delta = NULL);
+
+	/**!
+	 * @brief Detaches an affiliated AP that left its AP MLD.
+	 *
+	 * The BSS of the affiliated AP is no longer in the AP MLD and the associated STA MLDs drop
+	 * their link to it, a STA MLD keeps its other links and stays associated.
+	 *
+	 * @param[in] mld_mac MAC address of the AP MLD.
+	 * @param[in] ap The affiliated AP.
+	 *
+	 * @returns Number of BSSs and STA MLD links changed.
+	 */
+	unsigned int remove_affiliated_ap(const unsigned char *mld_mac, const em_affiliated_ap_info_t *ap);
+
+	/**!
+	 * @brief Removes the AP MLDs that a report no longer lists.
+	 *
+	 * @param[in] keep Indexes in m_ap_mld of the AP MLDs to keep.
+	 *
+	 * @returns Number of AP MLDs removed.
+	 */
+	unsigned int remove_ap_mld_except(const std::bitset<EM_MAX_AP_MLD>& keep);
+
 	em_ap_mld_info_t *get_ap_mld_frm_bssid(mac_address_t bss_id);
 	static em_ap_mld_info_t *get_ap_mld_frm_bssid(void *dm, mac_address_t bss_id) { return (static_cast<dm_easy_mesh_t *>(dm))->get_ap_mld_frm_bssid(bss_id); }
 
@@ -2360,6 +2513,16 @@ public:
 	 */
 	void print_config();
 
+	/**!
+	 * @brief Returns the memory held by the data model.
+	 *
+	 * Counts the fixed part, the allocated MLD sections, the STA and scan result objects in
+	 * the maps and the webconfig buffer.
+	 *
+	 * @returns Number of bytes.
+	 */
+	size_t get_footprint();
+
     
 	/**!
 	 * @brief Sets the database configuration parameter.
@@ -2371,6 +2534,7 @@ public:
 	 * @param[in] param The parameter value to be set for the specified type.
 	 *
 	 * @note Ensure that the type and param are valid and supported by the database.
+	 * The data model is marked changed, see get_generation().
 	 */
 	void set_db_cfg_param(db_cfg_type_t type, const char *param);
 	
@@ -2419,6 +2583,73 @@ public:
 	 */
 	bool db_cfg_type_is_set() { return m_db_cfg_param.db_cfg_type > 0; }
 
+	/**!
+	 * @brief Marks the metrics of a station as changed.
+	 *
+	 * Only the marked rows are written by the next table update, unless
+	 * db_cfg_type_sta_metrics_update is set, which rewrites every station.
+	 *
+	 * @param[in] sta Station of m_sta_map.
+	 */
+	void set_sta_dirty(dm_sta_t *sta);
+
+	/**!
+	 * @brief Marks a BSS as changed, only marked rows are written unless db_cfg_type_bss_list_update is set.
+	 *
+	 * @param[in] index Index of the BSS.
+	 */
+	void set_bss_dirty(unsigned int index) { if (index < EM_MAX_BSSS) m_bss_dirty.set(index); set_changed(); }
+
+	/**!
+	 * @brief Marks an operating class as changed, only marked rows are written unless db_cfg_type_op_class_list_update is set.
+	 *
+	 * @param[in] index Index of the operating class.
+	 */
+	void set_op_class_dirty(unsigned int index) { if (index < EM_MAX_OPCLASS) m_op_class_dirty.set(index); set_changed(); }
+
+	/**!
+	 * @brief Returns true if a BSS is marked as changed.
+	 *
+	 * @param[in] index Index of the BSS.
+	 */
+	bool is_bss_dirty(unsigned int index) const { return (index < EM_MAX_BSSS) && m_bss_dirty.test(index); }
+
+	/**!
+	 * @brief Returns true if an operating class is marked as changed.
+	 *
+	 * @param[in] index Index of the operating class.
+	 */
+	bool is_op_class_dirty(unsigned int index) const { return (index < EM_MAX_OPCLASS) && m_op_class_dirty.test(index); }
+
+	/**!
+	 * @brief Clears the mark of a BSS once its row is written.
+	 *
+	 * @param[in] index Index of the BSS, EM_MAX_BSSS to clear every mark.
+	 */
+	void reset_bss_dirty(unsigned int index) { if (index < EM_MAX_BSSS) m_bss_dirty.reset(index); else m_bss_dirty.reset(); }
+
+	/**!
+	 * @brief Clears the mark of an operating class once its row is written.
+	 *
+	 * @param[in] index Index of the operating class, EM_MAX_OPCLASS to clear every mark.
+	 */
+	void reset_op_class_dirty(unsigned int index) { if (index < EM_MAX_OPCLASS) m_op_class_dirty.reset(index); else m_op_class_dirty.reset(); }
+
+	/**!
+	 * @brief Returns the number of stations marked as changed.
+	 */
+	unsigned int get_num_dirty_sta() const { return m_num_dirty_sta; }
+
+	/**!
+	 * @brief Clears the marks of every station of m_sta_map.
+	 */
+	void reset_sta_dirty();
+
+	/**!
+	 * @brief Returns true if a station, BSS or operating class is marked as changed.
+	 */
+	bool has_dirty_objects() const { return (m_num_dirty_sta > 0) || m_bss_dirty.any() || m_op_class_dirty.any(); }
+
     
 	/**!
 	 * @brief Handles the dirty device management state.
@@ -2495,11 +2726,11 @@ public:
 	/**!
 	 * @brief Clones the hash maps from the given dm_easy_mesh_t object.
 	 *
-	 * This function duplicates the hash maps contained within the provided
-	 * dm_easy_mesh_t object, allowing for independent manipulation of the
-	 * cloned data.
+	 * This function copies the STA maps of this object into the provided
+	 * dm_easy_mesh_t object. Empty maps share the storage of ours until either
+	 * side changes, the STAs themselves are shared.
 	 *
-	 * @param[in] obj The dm_easy_mesh_t object whose hash maps are to be cloned.
+	 * @param[in] obj The dm_easy_mesh_t object receiving the maps.
 	 *
 	 * @note Ensure that the dm_easy_mesh_t object is properly initialized
 	 * before calling this function to avoid undefined behavior.
@@ -24,9 +24,40 @@
 #include "dm_easy_mesh.h"
 #include "webconfig_external_proto.h"
 #include "bus.h"
+#include "em_lat_hist.h"
+#include "dm_sta_delta.h"
+#include "em_beacon_report_agg.h"
+#include "dm_cfg_delta.h"
 
 class dm_easy_mesh_agent_t : public dm_easy_mesh_t {
 
+    unsigned long long m_policy_key;    // hash of the policies last set in OneWifi, 0 if none
+
+    // one webconfig context for all subdocs, initialized on first use and never torn down
+    static pthread_mutex_t s_webconfig_lock;
+    static webconfig_t s_webconfig;
+    static bool s_webconfig_ready;
+    static em_lat_hist_t s_decode_hist[webconfig_subdoc_type_max];
+    static em_lat_hist_t s_encode_hist[webconfig_subdoc_type_max];
+
+    static void init_webconfig_ext(webconfig_external_easymesh_t *ext, dm_easy_mesh_agent_t *dm,
+                                   m2ctrl_radioconfig *m2_cfg, em_policy_cfg_params_t *policy_config);
+    static bool init_webconfig();
+
+    /**!
+     * @brief Compares a radio decoded from a subdoc, and its operating classes, with those of this data model.
+     *
+     * @returns DM_CFG_DELTA_ flags of what differs.
+     */
+    unsigned int get_radio_cfg_delta(dm_easy_mesh_t& dm, dm_radio_t *radio);
+
+    /**!
+     * @brief Compares the BSSs of a radio decoded from a subdoc with those of this data model.
+     *
+     * @returns DM_CFG_DELTA_ flags of what differs.
+     */
+    unsigned int get_bss_cfg_delta(dm_easy_mesh_t& dm, const unsigned char *ruid);
+
 public:
 
     
@@ -53,14 +84,13 @@ public:
 	 *
 	 * @param[in] evt Pointer to the event data structure containing information about the event.
 	 * @param[in] pcmd Array of command pointers to be processed.
+	 * @param[in,out] delta STAs reported by the previous subdocs, only the changes to them get commands.
 	 *
-	 * @returns Integer status code indicating the result of the analysis.
-	 * @retval 0 on success.
-	 * @retval Non-zero error code on failure.
+	 * @returns Number of commands, 0 if no STA joined or left.
 	 *
 	 * @note Ensure that the event and command data are properly initialized before calling this function.
 	 */
-	int analyze_sta_list(em_bus_event_t *evt, em_cmd_t *pcmd[]);
+	int analyze_sta_list(em_bus_event_t *evt, em_cmd_t *pcmd[], dm_sta_delta_t *delta);
     
 	/**!
 	 * @brief Analyzes the auto-configuration renewal process.
@@ -281,6 +311,7 @@ public:
 	 * @brief Analyzes and sets the policy based on the provided event and bus description.
 	 *
 	 * This function processes the event and bus description to determine the appropriate policy settings.
+	 * Policies identical to those last set, the request of another radio, are not set again.
 	 *
 	 * @param[in] evt Pointer to the event structure containing the event details.
 	 * @param[in] desc Pointer to the bus description structure.
@@ -297,18 +328,26 @@ public:
 	/**!
 	 * @brief Analyzes the beacon report.
 	 *
-	 * This function processes the beacon report received in the event and command structures.
+	 * This function decodes the beacon report received in the event and merges the
+	 * Measurement Reports of each STA into the aggregator, the response of a STA is
+	 * built by create_beacon_report_cmd() once its reports are complete.
 	 *
 	 * @param[in] evt Pointer to the event structure containing the beacon report.
-	 * @param[in] pcmd Array of pointers to command structures for processing.
+	 * @param[in] agg Beacon Reports of the STAs being measured.
 	 *
-	 * @returns int Status code indicating the success or failure of the analysis.
-	 * @retval 0 on success.
-	 * @retval Non-zero error code on failure.
+	 * @returns int Number of STAs merged, 0 if the report had none.
+	 */
+	int analyze_beacon_report(em_bus_event_t *evt, em_beacon_report_agg_t *agg);
+
+	/**!
+	 * @brief Creates the command sending the Beacon Metrics Response of a STA.
 	 *
-	 * @note Ensure that the event and command structures are properly initialized before calling this function.
+	 * @param[in] report The merged reports of the STA.
+	 * @param[out] pcmd Array of pointers receiving the commands.
+	 *
+	 * @returns int Number of commands created.
 	 */
-	int analyze_beacon_report(em_bus_event_t *evt, em_cmd_t *pcmd[]);
+	int create_beacon_report_cmd(const em_beacon_report_agg_report_t *report, em_cmd_t *pcmd[]);
 
 	/**!
 	 * @brief Analyzes the AP Metrics report.
@@ -364,6 +403,38 @@ public:
 	 * @note Ensure that the document and data pointers are valid before calling this function.
 	 */
 	static webconfig_error_t webconfig_dummy_apply(webconfig_subdoc_t *doc, webconfig_subdoc_data_t *data);
+
+	/**!
+	 * @brief Decodes a OneWiFi subdoc into a data model with the shared webconfig context.
+	 *
+	 * @param[in] dm Data model the subdoc is decoded into.
+	 * @param[in] str JSON subdoc.
+	 * @param[in,out] type Type of the subdoc, set by the decode.
+	 *
+	 * @returns webconfig_error_none on success, the webconfig error otherwise.
+	 *
+	 * @note Decodes and encodes are serialized, each one is timed per subdoc type.
+	 */
+	static webconfig_error_t decode_onewifi_subdoc(dm_easy_mesh_agent_t *dm, char *str, webconfig_subdoc_type_t *type);
+
+	/**!
+	 * @brief Encodes a data model into a OneWiFi subdoc with the shared webconfig context.
+	 *
+	 * @param[in] dm Data model to encode.
+	 * @param[in] m2_cfg M2 radio configuration, or NULL.
+	 * @param[in] policy_config Policy configuration, or NULL.
+	 * @param[in] type Type of the subdoc.
+	 * @param[out] str JSON subdoc, owned by the webconfig library.
+	 *
+	 * @returns webconfig_error_none on success, the webconfig error otherwise.
+	 */
+	static webconfig_error_t encode_onewifi_subdoc(dm_easy_mesh_agent_t *dm, m2ctrl_radioconfig *m2_cfg,
+                                                   em_policy_cfg_params_t *policy_config, webconfig_subdoc_type_t type, char **str);
+
+	/**!
+	 * @brief Prints the decode and encode times of each subdoc type seen since the previous call, then clears them.
+	 */
+	static void print_subdoc_stats();
     
 	/**!
 	* @brief Constructor for the dm_easy_mesh_agent class.
@@ -31,6 +31,7 @@
 #include "dm_sta_list.h"
 #include "dm_policy_list.h"
 #include "dm_scan_result_list.h"
+#include "dm_scan_retention.h"
 #include "dm_dpp.h"
 #include "db_client.h"
 #include "dm_easy_mesh_list.h"
@@ -61,6 +62,7 @@ public:
     dm_radio_t *get_dm_radio(dm_easy_mesh_t *dm, char *instance, bool is_num);
     dm_sta_t *get_dm_bh_sta(dm_easy_mesh_t *dm, dm_radio_t *radio);
     const char* get_table_instance(const char *src, char *instance, size_t max_len, bool *is_num);
+    static bool get_instance_mac(const char *instance, mac_address_t mac);
 
     bus_error_t network_get(char *event_name, raw_data_t *p_data);
     static bus_error_t network_get_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data);
@@ -69,6 +71,7 @@ public:
     static bus_error_t device_get_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data);
     bus_error_t device_tget(char *event_name, raw_data_t *p_data);
     static bus_error_t device_tget_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data);
+    static bus_error_t device_tget_params(const char *root, bus_data_prop_t **property, unsigned int since, unsigned int *num);
 
     bus_error_t policy_get(char* event_name, raw_data_t* p_data);
     static bus_error_t policy_get_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data);
@@ -125,8 +128,76 @@ public:
     static bus_error_t sta_tget_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data);
     static bus_error_t sta_tget_params(dm_easy_mesh_t *dm, const char *root, em_bss_info_t *bi, bus_data_prop_t **property);
     static bus_error_t sta_get_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data);
+
+    bus_error_t orchdiag_get(char *event_name, raw_data_t *p_data);
+    static bus_error_t orchdiag_get_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data);
+
+    bus_error_t perf_get(char *event_name, raw_data_t *p_data);
+    static bus_error_t perf_get_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data);
+
+    bus_error_t mem_get(char *event_name, raw_data_t *p_data);
+    bus_error_t mem_set(char *event_name, raw_data_t *p_data);
+    static bus_error_t mem_get_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data);
+    static bus_error_t mem_set_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data);
+
+    bus_error_t subtree_get(char *event_name, raw_data_t *p_data);
+    bus_error_t subtree_set(char *event_name, raw_data_t *p_data);
+    static bus_error_t subtree_get_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data);
+    static bus_error_t subtree_set_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data);
+
+    bus_error_t notify_get(char *event_name, raw_data_t *p_data);
+    bus_error_t notify_set(char *event_name, raw_data_t *p_data);
+    static bus_error_t notify_get_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data);
+    static bus_error_t notify_set_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data);
+
+    /**!
+     * @brief Publishes the subscribed TR-181 parameters whose value changed.
+     *
+     * Marks the parameters under the devices changed since the last call, all of them if
+     * devices were added or removed, and once per notification interval evaluates the
+     * marked parameters and publishes the values that differ from those published last.
+     * Tables and the subtree Tree are not evaluated. Runs on the controller thread.
+     *
+     * @param[in] now_ms Current time in ms.
+     */
+    void publish_changes(unsigned long long now_ms);
+
+    /**!
+     * @brief Removes the scan results the retention policy picks and their database rows.
+     *
+     * Results never stamped are stamped now and kept for a full period. The rows of a
+     * result are deleted with one query. Runs on the controller thread, with
+     * em_mgr_t::lock_scan_results() held against the handlers filling the results.
+     *
+     * @param[in] now_ms Current time in ms, CLOCK_MONOTONIC.
+     *
+     * @returns Number of scan results removed.
+     */
+    unsigned int expire_scan_results(unsigned long long now_ms);
+
+    /**!
+     * @brief Removes the least recently used scan results of an agent and their database rows.
+     *
+     * Used when the agent is over its memory budget. Results not stamped yet are never
+     * evicted. Runs on the controller thread, with em_mgr_t::lock_scan_results() held.
+     *
+     * @param[in] dm Data model of the agent.
+     * @param[in] bytes Bytes to free.
+     *
+     * @returns Bytes freed, may be less than asked when the agent runs out of results.
+     */
+    unsigned long long evict_scan_results(dm_easy_mesh_t *dm, unsigned long long bytes);
+
+    /**!
+     * @brief Returns the retention policy of the scan results.
+     */
+    dm_scan_retention_t *get_scan_retention() { return &m_scan_retention; }
 private:
     db_client_t m_db_client;
+    dm_scan_retention_t m_scan_retention;
+    unsigned int    m_subtree_since;    // generation the subtree Tree reports changes after, 0 for all
+    unsigned int    m_notify_generation;    // generation the changes were marked up to
+    unsigned int    m_topo_list_generation;     // data model list generation of the last topology update
     bool	m_initialized;
     bool	m_network_initialized;
 
@@ -213,6 +284,30 @@ private:
 	 */
 	int set_radio_cap_list(cJSON *radio_cap_list_obj, mac_address_t *radio_mac);
 
+	/**!
+	 * @brief Writes the database row of one BSS of a data model.
+	 *
+	 * @param[in] dm Pointer to the data model.
+	 * @param[in] index Index of the BSS.
+	 *
+	 * @returns int
+	 * @retval 0 on success
+	 * @retval -1 on failure
+	 */
+	int update_bss_row(dm_easy_mesh_t *dm, unsigned int index);
+
+	/**!
+	 * @brief Writes the database row of one operating class of a data model.
+	 *
+	 * @param[in] dm Pointer to the data model.
+	 * @param[in] index Index of the operating class.
+	 *
+	 * @returns int
+	 * @retval 0 on success
+	 * @retval -1 on failure
+	 */
+	int update_op_class_row(dm_easy_mesh_t *dm, unsigned int index);
+
 public:
     
 	/**!
@@ -398,6 +493,16 @@ public:
 	 * @note Ensure that the command list is properly initialized before calling this function.
 	 */
 	int analyze_sta_steer(em_cmd_steer_params_t &params, em_cmd_t *cmd[]);
+
+	/**!
+	 * @brief Analyzes the steering of several STAs of one BSS.
+	 *
+	 * @param[in] params The source BSS and the STA/target pairs.
+	 * @param[out] cmd Array of command pointers to be populated.
+	 *
+	 * @returns int Number of commands created.
+	 */
+	int analyze_sta_steer_batch(em_cmd_steer_batch_params_t &params, em_cmd_t *cmd[]);
     
 	/**!
 	 * @brief Analyzes the disassociation of a station.
@@ -946,6 +1051,17 @@ public:
 	 * em_subdoc_info_t structure before calling this function.
 	 */
 	void get_config(em_long_string_t net_id, em_subdoc_info_t *subdoc);
+
+	/**!
+	 * @brief Builds the configuration of a sub-document as a cJSON tree, for the callers that
+	 * stream it instead of printing it into the sub-document.
+	 *
+	 * @param[in] net_id The network identifier.
+	 * @param[in] subdoc Sub-document, its name selects the configuration.
+	 *
+	 * @returns The tree, to be freed with cJSON_Delete().
+	 */
+	cJSON *get_config_tree(em_long_string_t net_id, em_subdoc_info_t *subdoc);
     
 	/**!
 	* @brief Sets the configuration for the Easy Mesh.
@@ -1054,6 +1170,33 @@ public:
 	 */
 	dm_easy_mesh_t *get_next_dm(dm_easy_mesh_t *dm) { return m_data_model_list.get_next_dm(dm); }
 
+	/**!
+	 * @brief Retrieves a data model by its instance number.
+	 *
+	 * @param[in] id Instance number.
+	 *
+	 * @returns The data model, NULL if none has the number.
+	 */
+	dm_easy_mesh_t *get_dm_by_id(int id) { return m_data_model_list.get_dm_by_id(id); }
+
+	/**!
+	 * @brief Retrieves the data model of a device.
+	 *
+	 * @param[in] dev_mac MAC address of the device.
+	 *
+	 * @returns The data model, NULL if no data model has the device.
+	 */
+	dm_easy_mesh_t *get_dm_by_dev_mac(const unsigned char *dev_mac) { return m_data_model_list.get_dm_by_dev_mac(dev_mac); }
+
+	/**!
+	 * @brief Retrieves the data model holding a BSS.
+	 *
+	 * @param[in] bssid BSSID.
+	 *
+	 * @returns The data model, NULL if no data model has the BSS.
+	 */
+	dm_easy_mesh_t *get_dm_by_bss(const unsigned char *bssid) { return m_data_model_list.get_dm_by_bss(bssid); }
+
     
 	/**!
 	 * @brief Retrieves the first network from the data model list.
@@ -1661,6 +1804,9 @@ public:
 	 *
 	 * This function is responsible for updating the current network topology
 	 * based on the latest configuration and status of the mesh network.
+	 * Only the devices whose data model changed since their node was added, see
+	 * em_network_topo_t::is_current(), are added again. All are once a data model was
+	 * created or deleted since the last update.
 	 *
 	 * @note Ensure that the network configuration is properly initialized
 	 * before calling this function.
@@ -1687,6 +1833,18 @@ public:
 	 * @note Ensure that the data is properly initialized before calling this function.
 	 */
 	void handle_dirty_dm();
+
+	/**!
+	 * @brief Returns the depth and counters of the database write behind queue.
+	 *
+	 * @param[out] stats Pointer to the counters.
+	 */
+	void get_db_writer_stats(db_write_queue_stats_t *stats) { m_db_client.get_writer_stats(stats); }
+
+	/**!
+	 * @brief Returns the database client, for the replication to a standby controller.
+	 */
+	db_client_t *get_db_client() { return &m_db_client; }
     
 	/**!
 	* @brief Initializes the tables used in the mesh control module.
@@ -1710,6 +1868,15 @@ public:
 	 * @note Ensure that the system is properly initialized before calling this function.
 	 */
 	int load_tables();
+
+	/**!
+	 * @brief Reloads tables from the database.
+	 *
+	 * Used for the tables that were loaded from the snapshot and changed in the database since it was written.
+	 *
+	 * @param[in] tables Names of the tables.
+	 */
+	void reload_tables(const std::vector<std::string>& tables);
     
 	/**!
 	 * @brief Loads the network SSID table.
@@ -1763,7 +1930,14 @@ public:
 	 * as it will permanently remove all data models.
 	 */
 	void delete_all_data_models() { m_data_model_list.delete_all_data_models(); }
-    
+
+	/**!
+	 * @brief Initializes the data model list alone, without the database or the bus.
+	 *
+	 * For the tools that build a mesh in memory, init() does it for the controller.
+	 */
+	void init_data_model_list(em_mgr_t *mgr) { m_data_model_list.init(mgr); }
+
 	/**!
 	 * @brief Debugs the probe for the data model list.
 	 *
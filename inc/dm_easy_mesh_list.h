@@ -20,16 +20,274 @@
 #ifndef DM_EM_LIST_H
 #define DM_EM_LIST_H
 
+#include <unordered_map>
 #include "em_base.h"
 #include "dm_easy_mesh.h"
+#include "em_mac_index.h"
+#include "em_intern.h"
+
+#define DM_LIST_REONBOARD_GRACE_MS  60000   // a removed agent that comes back within this gets its data model back
+#define DM_LIST_MAX_RETIRED         8       // removed data models kept for re-onboarding, the oldest is freed first
 
 class em_mgr_t;
+class dm_easy_mesh_list_t;
+
+typedef enum {
+    dm_list_walk_device,
+    dm_list_walk_radio,
+    dm_list_walk_bss,
+    dm_list_walk_sta,
+    dm_list_walk_op_class,
+    dm_list_walk_policy,
+    dm_list_walk_scan_result,
+    dm_list_walk_max
+} dm_list_walk_t;
+
+/*
+ * Cursor over one kind of element of all the data models of a dm_easy_mesh_list_t, in
+ * data model order and then in the order each data model keeps them. It remembers the
+ * data model and the index it stands on, so that a step is constant time instead of a
+ * search for the previous element from the first data model. Data models without any
+ * element of the kind are skipped. Deleting a data model invalidates its cursors.
+ */
+class dm_list_cursor_t {
+    dm_easy_mesh_list_t *m_list;
+    dm_list_walk_t m_walk;
+    dm_easy_mesh_t *m_dm;
+    unsigned int m_idx;
+    void *m_cur;
+
+    /**!
+     * @brief Returns the first element of a data model.
+     *
+     * @param[in] dm Pointer to the data model.
+     *
+     * @returns The element, NULL if the data model has none.
+     */
+    void *get_first_in_dm(dm_easy_mesh_t *dm);
+
+    /**!
+     * @brief Returns the element following the current one in the current data model.
+     *
+     * @returns The element, NULL if the current one is the last of the data model.
+     */
+    void *get_next_in_dm();
+
+public:
+
+    /**!
+     * @brief Moves the cursor to the first element.
+     *
+     * @returns The element, NULL if there is none.
+     */
+    void *first();
+
+    /**!
+     * @brief Moves the cursor to the next element.
+     *
+     * @returns The element, NULL at the end.
+     */
+    void *next();
+
+    /**!
+     * @brief Moves the cursor to an element, searching from the first one.
+     *
+     * @param[in] elem Pointer to the element.
+     *
+     * @returns True if the element was found, false otherwise, the cursor is then at the end.
+     */
+    bool seek(const void *elem);
+
+    /**!
+     * @brief Invalidates the position, the cursor is at the end until first() is called.
+     */
+    void reset() { m_dm = NULL; m_idx = 0; m_cur = NULL; }
+
+    /**!
+     * @brief Returns the current element, NULL at the end.
+     */
+    void *get() const { return m_cur; }
+
+    /**!
+     * @brief Returns the data model of the current element, NULL at the end.
+     */
+    dm_easy_mesh_t *get_dm() const { return m_dm; }
+
+    /**!
+     * @brief Constructor for dm_list_cursor_t.
+     *
+     * @param[in] list Pointer to the data model list to walk.
+     * @param[in] walk Kind of element to walk.
+     */
+    dm_list_cursor_t(dm_easy_mesh_list_t *list = NULL, dm_list_walk_t walk = dm_list_walk_device):
+        m_list(list), m_walk(walk), m_dm(NULL), m_idx(0), m_cur(NULL) {}
+};
+
+/*
+ * Range for loop over one kind of element, for example
+ * for (dm_sta_t *sta : list.walk_stas()) { ... }
+ */
+template <typename T>
+class dm_list_range_t {
+    dm_list_cursor_t m_cursor;
+
+public:
+    class iterator {
+        dm_list_cursor_t *m_cursor;
+        T *m_cur;
+
+    public:
+        T *operator*() const { return m_cur; }
+        iterator& operator++() { m_cur = static_cast<T *>(m_cursor->next()); return *this; }
+        bool operator!=(const iterator& it) const { return m_cur != it.m_cur; }
+
+        iterator(dm_list_cursor_t *cursor, T *cur): m_cursor(cursor), m_cur(cur) {}
+    };
+
+    iterator begin() { return iterator(&m_cursor, static_cast<T *>(m_cursor.first())); }
+    iterator end() { return iterator(&m_cursor, NULL); }
+
+    dm_list_range_t(dm_easy_mesh_list_t *list, dm_list_walk_t walk): m_cursor(list, walk) {}
+};
+
+// a removed data model, kept for the agent to return within DM_LIST_REONBOARD_GRACE_MS
+typedef struct {
+    dm_easy_mesh_t  *dm;
+    unsigned long long  removed_ms;
+} dm_retired_t;
 
 class dm_easy_mesh_list_t {
     em_long_string_t	m_network_list[EM_MAX_NETWORKS];
     unsigned int m_num_networks;
     hash_map_t  *m_list;
     em_mgr_t *m_mgr;
+    dm_list_cursor_t	m_walk[dm_list_walk_max];    // positions of the get_first_*()/get_next_*() walks
+    em_mac_index_t	m_radio_index;      // radio MAC -> data model, checked on use and fixed on mismatch
+    em_mac_index_t	m_bss_index;        // BSSID -> data model, same
+    em_mac_index_t	m_dev_index;        // device MAC -> data model, same
+    std::unordered_map<int, dm_easy_mesh_t *>	m_dm_ids;    // instance number -> data model, rebuilt when emptied or stale
+    std::unordered_map<uint64_t, dm_easy_mesh_t *>	m_dm_keys;   // interned network id and AL MAC -> data model, same content as m_list
+    unsigned int	m_generation = 0;   // generation of the last data model created or deleted
+    std::unordered_map<uint64_t, dm_retired_t>	m_retired;  // m_dm_keys key -> removed data model
+
+	/**!
+	 * @brief Returns the element following another one for the get_next_*() walks.
+	 *
+	 * The walk cursor is used as is when it stands on the element, which is the case when
+	 * the caller hands back what it got last, otherwise the element is searched for.
+	 *
+	 * @param[in] walk Kind of element.
+	 * @param[in] elem Pointer to the element.
+	 *
+	 * @returns The next element, NULL at the end or if elem is not in the list.
+	 */
+	void *get_walk_next(dm_list_walk_t walk, const void *elem);
+
+	/**!
+	 * @brief Invalidates the walk cursors, before data models are deleted.
+	 */
+	void reset_walks();
+
+	/**!
+	 * @brief Returns the key of a data model in m_dm_keys.
+	 *
+	 * @param[in] net_id Network id.
+	 * @param[in] al_mac AL MAC address of the device.
+	 * @param[out] key Receives the key, the em_intern_t handle of the network id above the MAC.
+	 * @param[in] add Whether a network id not interned yet is added.
+	 *
+	 * @returns True if the key was built, false if the network id is not known and add is false.
+	 */
+	bool get_dm_key(const char *net_id, const unsigned char *al_mac, uint64_t *key, bool add);
+
+	/**!
+	 * @brief Drops a data model from the walk cursors and the MAC indexes, before it is deleted.
+	 *
+	 * @param[in] dm Pointer to the data model, may be NULL.
+	 */
+	void forget_data_model(dm_easy_mesh_t *dm);
+
+	/**!
+	 * @brief Copies the network and its SSIDs from the reference data model of the network, if there is one.
+	 *
+	 * @param[in] dm Pointer to the data model.
+	 * @param[in] net_id Network id.
+	 */
+	void copy_network(dm_easy_mesh_t *dm, const char *net_id);
+
+	/**!
+	 * @brief Returns the monotonic time in milliseconds.
+	 */
+	static unsigned long long get_now_ms();
+
+	/**!
+	 * @brief Frees a data model, its maps and buffers at once rather than entry by entry.
+	 *
+	 * @param[in] dm Pointer to the data model, forgotten already, may be NULL.
+	 */
+	static void free_data_model(dm_easy_mesh_t *dm);
+
+	/**!
+	 * @brief Keeps a removed data model for its agent to return, frees the expired ones.
+	 *
+	 * @param[in] key Key of the data model in m_dm_keys.
+	 * @param[in] dm Pointer to the data model, forgotten already.
+	 * @param[in] now Current time in milliseconds.
+	 */
+	void retire_data_model(uint64_t key, dm_easy_mesh_t *dm, unsigned long long now);
+
+	/**!
+	 * @brief Takes back the removed data model of a returning agent.
+	 *
+	 * The rows the removal deleted from the database are marked to be written again.
+	 *
+	 * @param[in] key Key of the data model in m_dm_keys.
+	 * @param[in] now Current time in milliseconds.
+	 *
+	 * @returns The data model, NULL if there is none removed within DM_LIST_REONBOARD_GRACE_MS.
+	 */
+	dm_easy_mesh_t *revive_data_model(uint64_t key, unsigned long long now);
+
+	/**!
+	 * @brief Frees the removed data models, all of them or those past DM_LIST_REONBOARD_GRACE_MS.
+	 *
+	 * @param[in] all true to free all of them.
+	 * @param[in] now Current time in milliseconds.
+	 */
+	void purge_retired(bool all, unsigned long long now);
+
+	/**!
+	 * @brief Returns the data model holding a radio.
+	 *
+	 * The radio index is tried first, a stale entry is dropped and all data models are
+	 * searched, the one found is indexed.
+	 *
+	 * @param[in] ruid Radio MAC address.
+	 * @param[out] radio Receives the radio, may be NULL.
+	 *
+	 * @returns The data model, NULL if no data model has the radio.
+	 */
+	dm_easy_mesh_t *get_dm_by_radio(const unsigned char *ruid, dm_radio_t **radio = NULL);
+
+	/**!
+	 * @brief Returns the radio of a data model with a given MAC address.
+	 *
+	 * @param[in] dm Pointer to the data model.
+	 * @param[in] ruid Radio MAC address.
+	 *
+	 * @returns The radio, NULL if the data model does not have it.
+	 */
+	static dm_radio_t *find_radio(dm_easy_mesh_t *dm, const unsigned char *ruid);
+
+	/**!
+	 * @brief Returns the BSS of a data model with a given BSSID.
+	 *
+	 * @param[in] dm Pointer to the data model.
+	 * @param[in] bssid BSSID.
+	 *
+	 * @returns The BSS, NULL if the data model does not have it.
+	 */
+	static dm_bss_t *find_bss(dm_easy_mesh_t *dm, const unsigned char *bssid);
 
 public:
    
@@ -49,6 +307,35 @@ public:
 	 * calling this function.
 	 */
 	dm_easy_mesh_t *get_data_model(const char *net_id, const unsigned char *al_mac);
+
+	/**!
+	 * @brief Retrieves a data model by its instance number, the one get_id() returns.
+	 *
+	 * @param[in] id Instance number, that of the TR-181 Device table.
+	 *
+	 * @returns The data model, the first in walk order if several share the number, NULL if none has it.
+	 *
+	 * @note Constant time, the map is rebuilt once a data model was created or deleted.
+	 */
+	dm_easy_mesh_t *get_dm_by_id(int id);
+
+	/**!
+	 * @brief Returns the generation at which the last data model was created or deleted.
+	 *
+	 * @note Instance numbers given to the data models by position may have moved since then.
+	 */
+	unsigned int get_generation() const { return m_generation; }
+
+	/**!
+	 * @brief Retrieves the data model of a device.
+	 *
+	 * @param[in] dev_mac MAC address of the device, its ID.
+	 *
+	 * @returns The data model, NULL if no data model has the device.
+	 *
+	 * @note Constant time once the device has been looked up, misses search all data models.
+	 */
+	dm_easy_mesh_t *get_dm_by_dev_mac(const unsigned char *dev_mac);
     
 	/**!
 	 * @brief Creates a data model for the EasyMesh network.
@@ -66,6 +353,7 @@ public:
 	 * @retval NULL if the creation fails.
 	 *
 	 * @note Ensure that the network identifier and interface are valid before calling this function.
+	 * @note A data model of the same device deleted within DM_LIST_REONBOARD_GRACE_MS is reused.
 	 */
 	dm_easy_mesh_t *create_data_model(const char *net_id, const em_interface_t *al_intf, em_profile_type_t profile, bool colocated_dm = false);
     
@@ -78,6 +366,7 @@ public:
 	 * @param[in] al_mac The AL MAC address associated with the data model.
 	 *
 	 * @note Ensure that the network ID and AL MAC address are valid and correspond to an existing data model.
+	 * @note The data model is kept for DM_LIST_REONBOARD_GRACE_MS in case the agent comes back.
 	 */
 	void delete_data_model(const char *net_id, const unsigned char *al_mac);
     
@@ -87,6 +376,7 @@ public:
 	 * This function removes all existing data models, ensuring that the system is reset to a state without any data models.
 	 *
 	 * @note Use this function with caution as it will remove all data models permanently.
+	 * @note The data models kept for re-onboarding are freed too.
 	 */
 	void delete_all_data_models();
 
@@ -142,6 +432,20 @@ public:
 	 */
 	dm_easy_mesh_t *get_next_dm(dm_easy_mesh_t *dm) { return static_cast<dm_easy_mesh_t *>(hash_map_get_next(m_list, dm)); }
 
+	/**!
+	 * @brief Returns ranges over all the elements of a kind, for range for loops.
+	 *
+	 * Each range has its own cursor, nested walks do not disturb each other nor the
+	 * get_first_*()/get_next_*() walks.
+	 */
+	dm_list_range_t<dm_device_t> walk_devices() { return dm_list_range_t<dm_device_t>(this, dm_list_walk_device); }
+	dm_list_range_t<dm_radio_t> walk_radios() { return dm_list_range_t<dm_radio_t>(this, dm_list_walk_radio); }
+	dm_list_range_t<dm_bss_t> walk_bss() { return dm_list_range_t<dm_bss_t>(this, dm_list_walk_bss); }
+	dm_list_range_t<dm_sta_t> walk_stas() { return dm_list_range_t<dm_sta_t>(this, dm_list_walk_sta); }
+	dm_list_range_t<dm_op_class_t> walk_op_classes() { return dm_list_range_t<dm_op_class_t>(this, dm_list_walk_op_class); }
+	dm_list_range_t<dm_policy_t> walk_policies() { return dm_list_range_t<dm_policy_t>(this, dm_list_walk_policy); }
+	dm_list_range_t<dm_scan_result_t> walk_scan_results() { return dm_list_range_t<dm_scan_result_t>(this, dm_list_walk_scan_result); }
+
     
 	/**!
 	 * @brief Retrieves the first network from the list.
@@ -312,6 +616,17 @@ public:
 	 * @note Ensure that the key provided is valid and corresponds to an existing radio object.
 	 */
 	dm_radio_t *get_radio(const char *key);
+
+	/**!
+	 * @brief Retrieves a radio by MAC address, whatever data model holds it.
+	 *
+	 * @param[in] ruid Radio MAC address.
+	 *
+	 * @returns A pointer to the radio, NULL if no data model has it.
+	 *
+	 * @note Constant time once the radio has been looked up or put, misses search all data models.
+	 */
+	dm_radio_t *get_radio_by_mac(const unsigned char *ruid) { dm_radio_t *radio = NULL; get_dm_by_radio(ruid, &radio); return radio; }
     
 	/**!
 	 * @brief Removes a radio entry identified by the given key.
@@ -411,6 +726,30 @@ public:
 	 * BSS in the system.
 	 */
 	dm_bss_t *get_bss(const char *key);
+
+	/**!
+	 * @brief Retrieves a BSS by BSSID, whatever data model holds it.
+	 *
+	 * @param[in] bssid BSSID.
+	 *
+	 * @returns A pointer to the BSS, NULL if no data model has it.
+	 *
+	 * @note Constant time once the BSS has been looked up or put, misses search all data models.
+	 */
+	dm_bss_t *get_bss_by_mac(const unsigned char *bssid);
+
+	/**!
+	 * @brief Retrieves the data model holding a BSS.
+	 *
+	 * The BSS index is tried first, a stale entry is dropped and all data models are
+	 * searched, the one found is indexed.
+	 *
+	 * @param[in] bssid BSSID.
+	 * @param[out] bss Receives the BSS, may be NULL.
+	 *
+	 * @returns The data model, NULL if no data model has the BSS.
+	 */
+	dm_easy_mesh_t *get_dm_by_bss(const unsigned char *bssid, dm_bss_t **bss = NULL);
     
 	/**!
 	 * @brief Removes a BSS entry identified by the given key.
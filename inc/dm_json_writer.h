@@ -0,0 +1,249 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef DM_JSON_WRITER_H
+#define DM_JSON_WRITER_H
+
+#include <stddef.h>
+#include <cjson/cJSON.h>
+
+#define DM_JSON_WRITER_MAX_DEPTH    32
+#define DM_JSON_WRITER_FLUSH_LEN    4096    // buffered bytes handed to a sink at once
+
+/**!
+ * @brief Receives the output of a streaming writer.
+ *
+ * @param[in] arg Argument given with the sink.
+ * @param[in] data Bytes written, not NUL terminated.
+ * @param[in] len Number of bytes.
+ *
+ * @returns 0 on success, -1 on failure, the writer then stops writing.
+ */
+typedef int (*dm_json_writer_sink_t)(void *arg, const char *data, size_t len);
+
+/*
+ * Writer the dm_* encode functions target. A streaming writer appends compact JSON, numbers
+ * and strings formatted as cJSON_PrintUnformatted() does, to a buffer it keeps across reset()
+ * or hands to a sink whenever DM_JSON_WRITER_FLUSH_LEN bytes are buffered. A tree writer adds
+ * cJSON items to the container it is created on, for the callers that still need a cJSON tree.
+ * Values are members of the open object, the key is then required, or rows of the open array,
+ * the key is then ignored. Not thread safe.
+ */
+class dm_json_writer_t {
+
+    char                    *m_buff;
+    size_t                  m_len;
+    size_t                  m_cap;
+    dm_json_writer_sink_t   m_sink;
+    void                    *m_sink_arg;
+    cJSON                   *m_tree[DM_JSON_WRITER_MAX_DEPTH];     // open containers of a tree writer
+    bool                    m_is_array[DM_JSON_WRITER_MAX_DEPTH];
+    bool                    m_has_rows[DM_JSON_WRITER_MAX_DEPTH];  // a value was written into the container
+    unsigned int            m_depth;
+    bool                    m_is_tree;
+    bool                    m_error;
+
+    /**!
+     * @brief Appends bytes to the buffer, growing it or flushing it to the sink.
+     *
+     * @param[in] data Bytes to append.
+     * @param[in] len Number of bytes.
+     */
+    void put(const char *data, size_t len);
+
+    /**!
+     * @brief Appends a JSON string, quoted and escaped.
+     *
+     * @param[in] str NUL terminated string, NULL is written as an empty string.
+     */
+    void put_string(const char *str);
+
+    /**!
+     * @brief Writes the separator and the key in front of a value of a streaming writer.
+     *
+     * @param[in] key Name of the member, ignored in an array.
+     *
+     * @returns 0 on success, -1 if a key is missing or nothing is open to write into.
+     */
+    int open_value(const char *key);
+
+    /**!
+     * @brief Adds an item to the open container of a tree writer.
+     *
+     * @param[in] key Name of the member, ignored in an array.
+     * @param[in] item Item to add, owned by the tree from then on.
+     *
+     * @returns The item, NULL if it could not be added.
+     */
+    cJSON *add_item(const char *key, cJSON *item);
+
+    /**!
+     * @brief Opens an object or an array.
+     *
+     * @param[in] key Name of the member, ignored in an array or at the top.
+     * @param[in] is_array True to open an array.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    int begin(const char *key, bool is_array);
+
+    /**!
+     * @brief Closes the container opened last.
+     *
+     * @param[in] is_array True if it is an array.
+     *
+     * @returns 0 on success, -1 if it is not open.
+     */
+    int end(bool is_array);
+
+public:
+
+    /**!
+     * @brief Opens an object, the member key of the open object or a row of the open array.
+     *
+     * @param[in] key Name of the member, NULL in an array or at the top.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    int begin_object(const char *key = NULL) { return begin(key, false); }
+
+    /**!
+     * @brief Closes the object opened last.
+     *
+     * @returns 0 on success, -1 if the container opened last is not an object.
+     */
+    int end_object() { return end(false); }
+
+    /**!
+     * @brief Opens an array, the member key of the open object or a row of the open array.
+     *
+     * @param[in] key Name of the member, NULL in an array or at the top.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    int begin_array(const char *key = NULL) { return begin(key, true); }
+
+    /**!
+     * @brief Closes the array opened last.
+     *
+     * @returns 0 on success, -1 if the container opened last is not an array.
+     */
+    int end_array() { return end(true); }
+
+    /**!
+     * @brief Writes a string.
+     *
+     * @param[in] key Name of the member, NULL in an array.
+     * @param[in] val Value.
+     */
+    void add_string(const char *key, const char *val);
+
+    /**!
+     * @brief Writes a number.
+     *
+     * @param[in] key Name of the member, NULL in an array.
+     * @param[in] val Value.
+     */
+    void add_number(const char *key, double val);
+
+    /**!
+     * @brief Writes a boolean.
+     *
+     * @param[in] key Name of the member, NULL in an array.
+     * @param[in] val Value.
+     */
+    void add_bool(const char *key, bool val);
+
+    /**!
+     * @brief Writes JSON text as it is, e.g. a list streamed by another writer.
+     *
+     * @param[in] key Name of the member, NULL in an array.
+     * @param[in] json Valid JSON text.
+     */
+    void add_raw(const char *key, const char *json);
+
+    /**!
+     * @brief Writes a cJSON item and its children, a streaming writer walks it without printing it whole.
+     *
+     * @param[in] key Name of the member, NULL in an array or at the top.
+     * @param[in] item Item to write, a tree writer adds a copy of it.
+     */
+    void add_tree(const char *key, const cJSON *item);
+
+    /**!
+     * @brief Hands the buffered output to the sink.
+     *
+     * @returns 0 on success or without a sink, -1 if the sink failed.
+     */
+    int flush();
+
+    /**!
+     * @brief Returns the output of a streaming writer without a sink, NUL terminated.
+     */
+    const char *get_str() { return (m_buff != NULL) ? m_buff:""; }
+
+    /**!
+     * @brief Returns the length of the buffered output.
+     */
+    size_t get_len() { return m_len; }
+
+    /**!
+     * @brief Returns true if the output is incomplete, a write failed or was misplaced.
+     */
+    bool has_error() { return m_error; }
+
+    /**!
+     * @brief Returns true if the writer adds to a cJSON tree.
+     */
+    bool is_tree() { return m_is_tree; }
+
+    /**!
+     * @brief Discards the output of a streaming writer, the buffer is kept for the next one.
+     */
+    void reset();
+
+    /**!
+     * @brief Constructor of a streaming writer into its own buffer.
+     */
+    dm_json_writer_t();
+
+    /**!
+     * @brief Constructor of a streaming writer into a sink, e.g. a socket.
+     *
+     * @param[in] sink Function receiving the output.
+     * @param[in] arg Argument passed to the sink.
+     */
+    dm_json_writer_t(dm_json_writer_sink_t sink, void *arg);
+
+    /**!
+     * @brief Constructor of a tree writer.
+     *
+     * @param[in] container Object or array the values are added to.
+     */
+    dm_json_writer_t(cJSON *container);
+
+    /**!
+     * @brief Destructor for dm_json_writer_t, the output left in the buffer is not flushed.
+     */
+    ~dm_json_writer_t();
+
+    dm_json_writer_t(const dm_json_writer_t&) = delete;
+    dm_json_writer_t& operator=(const dm_json_writer_t&) = delete;
+};
+
+#endif
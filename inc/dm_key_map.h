@@ -0,0 +1,238 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef DM_KEY_MAP_H
+#define DM_KEY_MAP_H
+
+#include <stdint.h>
+#include <atomic>
+#include "em_base.h"
+
+#define DM_KEY_MAP_MIN_SZ   16
+
+/*
+ * Binary key of the per data model STA and scan result maps. Unused fields are
+ * zero, keys are compared as bytes. The network of a scan result is that of the
+ * data model holding the map, so it is not part of the key.
+ */
+typedef struct {
+    mac_address_t   mac[3];         // STA, BSSID and radio, or scanner and device for scan results
+    unsigned char   op_class;
+    unsigned char   channel;
+    unsigned char   type;           // em_scanner_type_t of scan results
+    unsigned char   pad[3];         // keeps the size a multiple of 4 for the hash
+} dm_map_key_t;
+
+typedef struct {
+    dm_map_key_t key;
+    void *val;                      // NULL for a free entry
+    unsigned int prev;              // insertion order list, DM_KEY_MAP_NONE terminated
+    unsigned int next;
+} dm_key_map_entry_t;
+
+#define DM_KEY_MAP_NONE     (~0u)
+
+/*
+ * Map from dm_map_key_t to pointers, iterated in insertion order like the hash_map_t
+ * it replaces for STAs and scan results. Entries sit in a dense array, two open
+ * addressing tables with linear probing index them by key and by value, so that
+ * get_next() does not walk the map. A copy made by copy_from() shares the storage
+ * of its source, the first of them to change then takes a private copy. Not thread
+ * safe, but maps sharing storage may be used from different threads.
+ */
+class dm_key_map_t {
+
+    dm_key_map_entry_t *m_entries;
+    unsigned int *m_by_key;         // entry index + 1, 0 for an empty slot
+    unsigned int *m_by_val;
+    unsigned int m_size;            // entries allocated, the index tables have twice as many slots
+    unsigned int m_count;
+    unsigned int m_free;            // free entries, linked through next
+    unsigned int m_head;
+    unsigned int m_tail;
+    std::atomic<unsigned int> *m_refs;  // maps sharing the storage, NULL if it is not shared
+
+    /**!
+     * @brief Takes a private copy of shared storage before a change.
+     *
+     * @returns 0 on success, -1 on allocation failure.
+     */
+    int unshare();
+
+    /**!
+     * @brief Returns the home slot of a key in m_by_key.
+     *
+     * @param[in] key Pointer to the key.
+     */
+    unsigned int get_key_home(const dm_map_key_t *key) const;
+
+    /**!
+     * @brief Returns the home slot of a value in m_by_val.
+     *
+     * @param[in] val Value.
+     */
+    unsigned int get_val_home(const void *val) const;
+
+    /**!
+     * @brief Returns the m_by_key slot holding a key.
+     *
+     * @param[in] key Pointer to the key.
+     *
+     * @returns The slot, DM_KEY_MAP_NONE if the key is not in the map.
+     */
+    unsigned int find_key(const dm_map_key_t *key) const;
+
+    /**!
+     * @brief Returns the m_by_val slot holding an entry.
+     *
+     * @param[in] idx Index of the entry.
+     *
+     * @returns The slot, DM_KEY_MAP_NONE if the entry is not indexed.
+     */
+    unsigned int find_val(unsigned int idx) const;
+
+    /**!
+     * @brief Indexes an entry by key and by value.
+     *
+     * @param[in] idx Index of the entry.
+     */
+    void index_entry(unsigned int idx);
+
+    /**!
+     * @brief Empties a slot of an index table, shifting back the slots of the run behind it.
+     *
+     * @param[in] table Index table.
+     * @param[in] slot Slot to empty.
+     * @param[in] by_key True for m_by_key, false for m_by_val.
+     */
+    void unindex_slot(unsigned int *table, unsigned int slot, bool by_key);
+
+    /**!
+     * @brief Doubles the entries and rebuilds the index tables.
+     *
+     * @returns 0 on success, -1 on allocation failure.
+     */
+    int grow();
+
+public:
+
+    /**!
+     * @brief Builds the key of a STA map entry.
+     *
+     * @param[out] key Pointer to the key.
+     * @param[in] sta STA MAC address.
+     * @param[in] bssid BSSID the STA is on.
+     * @param[in] ruid Radio of the BSS.
+     */
+    static void sta_key(dm_map_key_t *key, const unsigned char *sta, const unsigned char *bssid, const unsigned char *ruid);
+
+    /**!
+     * @brief Builds the key of a scan result map entry.
+     *
+     * @param[out] key Pointer to the key.
+     * @param[in] id Pointer to the scan result id, its network is ignored.
+     */
+    static void scan_result_key(dm_map_key_t *key, const em_scan_result_id_t *id);
+
+    /**!
+     * @brief Adds a value, replacing the value of a key already in the map.
+     *
+     * @param[in] key Pointer to the key.
+     * @param[in] val Value, must not be NULL.
+     *
+     * @returns The replaced value, NULL if the key is new or on failure.
+     *
+     * @note A replaced value keeps the position of its key in the iteration order.
+     */
+    void *put(const dm_map_key_t *key, void *val);
+
+    /**!
+     * @brief Returns the value of a key.
+     *
+     * @param[in] key Pointer to the key.
+     *
+     * @returns The value, NULL if the key is not in the map.
+     */
+    void *get(const dm_map_key_t *key) const;
+
+    /**!
+     * @brief Removes a key.
+     *
+     * @param[in] key Pointer to the key.
+     *
+     * @returns The removed value, NULL if the key is not in the map.
+     */
+    void *remove(const dm_map_key_t *key);
+
+    /**!
+     * @brief Returns the first value in insertion order.
+     *
+     * @returns The value, NULL if the map is empty.
+     */
+    void *get_first() const;
+
+    /**!
+     * @brief Returns the value following another one in insertion order.
+     *
+     * @param[in] val Value returned by get_first() or get_next().
+     *
+     * @returns The next value, NULL at the end or if val is not in the map.
+     *
+     * @note A value stored under several keys continues from one of them.
+     */
+    void *get_next(const void *val) const;
+
+    /**!
+     * @brief Adds every key of another map.
+     *
+     * An empty map shares the storage of the source instead, nothing is copied until
+     * either map changes. The values are not copied.
+     *
+     * @param[in] src Map to copy.
+     *
+     * @returns 0 on success, -1 on allocation failure.
+     */
+    int copy_from(dm_key_map_t& src);
+
+    /**!
+     * @brief Returns the number of keys in the map.
+     */
+    unsigned int count() const { return m_count; }
+
+    /**!
+     * @brief Removes all keys, the values are not freed.
+     *
+     * @note Storage shared with other maps is left to them.
+     */
+    void clear();
+
+    /**!
+     * @brief Constructor for dm_key_map_t.
+     */
+    dm_key_map_t();
+
+    /**!
+     * @brief Destructor for dm_key_map_t.
+     */
+    ~dm_key_map_t();
+
+    dm_key_map_t(const dm_key_map_t&) = delete;
+    dm_key_map_t& operator=(const dm_key_map_t&) = delete;
+};
+
+#endif
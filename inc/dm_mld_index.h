@@ -0,0 +1,98 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef DM_MLD_INDEX_H
+#define DM_MLD_INDEX_H
+
+#include "em_base.h"
+#include "em_hex.h"
+
+#include <unordered_map>
+
+/*
+ * Index of the MLDs of a data model section: MLD MAC -> index of the MLD in the section,
+ * affiliated AP or STA MAC -> index of the MLD and of the link in it. The data model keeps
+ * it along with the section and checks what it returns against the section, a mismatch
+ * makes it rebuild the index. Zero MACs are not indexed. Not thread safe.
+ */
+class dm_mld_index_t {
+
+    std::unordered_map<em_packed_mac_t, unsigned int> m_mlds;
+    std::unordered_map<em_packed_mac_t, unsigned int> m_links;     // MLD index << 8 | link index
+
+public:
+
+    /**!
+     * @brief Indexes an MLD, replacing the index it had.
+     *
+     * @param[in] mld_mac MAC of the MLD.
+     * @param[in] idx Index of the MLD in the section.
+     */
+    void add_mld(const unsigned char *mld_mac, unsigned int idx);
+
+    /**!
+     * @brief Indexes an affiliated link, replacing the MLD and link it had.
+     *
+     * @param[in] mac MAC of the affiliated AP or STA.
+     * @param[in] idx Index of the MLD in the section.
+     * @param[in] link Index of the link in the MLD.
+     */
+    void add_link(const unsigned char *mac, unsigned int idx, unsigned int link);
+
+    /**!
+     * @brief Removes an MLD if it is indexed at idx, it may have moved to another one since.
+     */
+    void remove_mld(const unsigned char *mld_mac, unsigned int idx);
+
+    /**!
+     * @brief Removes an affiliated link if it is indexed under the MLD at idx.
+     */
+    void remove_link(const unsigned char *mac, unsigned int idx);
+
+    /**!
+     * @brief Returns the index of an MLD.
+     *
+     * @param[in] mld_mac MAC of the MLD.
+     * @param[out] idx Receives the index of the MLD in the section.
+     *
+     * @returns True if the MLD is indexed.
+     */
+    bool find_mld(const unsigned char *mld_mac, unsigned int *idx) const;
+
+    /**!
+     * @brief Returns the MLD and link of an affiliated AP or STA.
+     *
+     * @param[in] mac MAC of the affiliated AP or STA.
+     * @param[out] idx Receives the index of the MLD in the section.
+     * @param[out] link Receives the index of the link in the MLD, may be NULL.
+     *
+     * @returns True if the link is indexed.
+     */
+    bool find_link(const unsigned char *mac, unsigned int *idx, unsigned int *link) const;
+
+    /**!
+     * @brief Removes all MLDs and links.
+     */
+    void clear();
+
+    unsigned int get_num_mlds() const { return static_cast<unsigned int> (m_mlds.size()); }
+
+    unsigned int get_num_links() const { return static_cast<unsigned int> (m_links.size()); }
+};
+
+#endif
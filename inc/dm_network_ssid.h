@@ -107,6 +107,29 @@ public:
 	 */
 	static em_haul_type_t haul_type_from_string(em_string_t	str);
 
+	/**!
+	 * @brief Returns the bands of a network SSID, a bit per em_freq_band_t.
+	 *
+	 * The Band strings are "2.4", "5" and "6", a band that is not one of them counts as all bands.
+	 */
+	static unsigned int get_band_mask(const em_network_ssid_info_t *info);
+
+	/**!
+	 * @brief Returns the bands whose BSSs a change of the network SSID list reconfigures.
+	 *
+	 * The entries of the two lists are paired by haul type, the bands of a pair that differs
+	 * in any field, before and after the change, are in the mask. An entry without a pair
+	 * adds its own bands. The entries without haul type are not looked at.
+	 *
+	 * @param[in] tgt Network SSIDs requested.
+	 * @param[in] num_tgt Number of entries of tgt.
+	 * @param[in] cur Network SSIDs in use.
+	 * @param[in] num_cur Number of entries of cur.
+	 *
+	 * @returns A bit per em_freq_band_t, 0 if no haul type changed.
+	 */
+	static unsigned int get_changed_bands(dm_network_ssid_t *tgt, unsigned int num_tgt, dm_network_ssid_t *cur, unsigned int num_cur);
+
     bool operator == (const dm_network_ssid_t& obj);
     void operator = (const dm_network_ssid_t& obj);
     
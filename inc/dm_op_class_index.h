@@ -0,0 +1,93 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef DM_OP_CLASS_INDEX_H
+#define DM_OP_CLASS_INDEX_H
+
+#include "em_base.h"
+#include "em_hex.h"
+
+#include <unordered_map>
+
+typedef struct {
+    unsigned int        idx;                // of the operating class in the section
+    unsigned int        num_channels;       // of the entry when it was indexed
+    unsigned long long  channels[4];        // bit n set if channel n is in the channel list of the entry
+} dm_op_class_index_entry_t;
+
+/*
+ * Index of the operating classes of a data model section: radio, type and class packed in
+ * one integer -> index of the operating class in the section and a bitmap of its channel
+ * list. The channel list of a capability operating class holds the channels the radio
+ * cannot operate on in that class, so the bitmaps tell whether a radio allows a channel
+ * without walking the section. The data model keeps it along with the section and checks
+ * what it returns against the section, a mismatch makes it rebuild the index. Not thread
+ * safe.
+ */
+class dm_op_class_index_t {
+
+    std::unordered_map<unsigned long long, dm_op_class_index_entry_t> m_op_classes;
+    std::unordered_map<em_packed_mac_t, unsigned int> m_capable;   // radio to its number of capability operating classes
+
+public:
+
+    /**!
+     * @brief Returns the key of a radio, type and class.
+     */
+    static unsigned long long get_key(const unsigned char *ruid, unsigned int type, unsigned int op_class)
+    {
+        return (em_hex::pack_mac(ruid) << 16) | ((type & 0xff) << 8) | (op_class & 0xff);
+    }
+
+    /**!
+     * @brief Returns whether a channel is in the channel list of an indexed entry.
+     */
+    static bool has_channel(const dm_op_class_index_entry_t *entry, unsigned int channel)
+    {
+        return (channel < 256) && ((entry->channels[channel >> 6] & (1ULL << (channel & 0x3f))) != 0);
+    }
+
+    /**!
+     * @brief Indexes an operating class, replacing the entry its radio, type and class had.
+     *
+     * @param[in] info Operating class.
+     * @param[in] idx Index of the operating class in the section.
+     */
+    void add(const em_op_class_info_t *info, unsigned int idx);
+
+    /**!
+     * @brief Returns the entry of a radio, type and class.
+     *
+     * @returns The entry, NULL if the operating class is not indexed.
+     */
+    const dm_op_class_index_entry_t *find(const unsigned char *ruid, unsigned int type, unsigned int op_class) const;
+
+    /**!
+     * @brief Returns whether a radio has capability operating classes indexed.
+     */
+    bool has_capability(const unsigned char *ruid) const { return m_capable.find(em_hex::pack_mac(ruid)) != m_capable.end(); }
+
+    /**!
+     * @brief Removes all operating classes.
+     */
+    void clear();
+
+    unsigned int get_num() const { return static_cast<unsigned int> (m_op_classes.size()); }
+};
+
+#endif
@@ -20,10 +20,24 @@
 #define DM_SCAN_RESULT_H
 
 #include "em_base.h"
+#include "dm_json_writer.h"
+
+#define DM_SCAN_RESULT_NBR_SLOTS    (EM_MAX_NEIGHBORS * 2)  // BSSID index of the neighbors, at most half full
 
 class dm_scan_result_t {
 public:
     em_scan_result_t    m_scan_result;
+    unsigned long long  m_used_ms;      // CLOCK_MONOTONIC ms of the last update, 0 if never stamped, see touch()
+
+private:
+    // open addressed BSSID index, neighbor position + 1 per slot, 0 for an empty one
+    unsigned char   m_nbr_slot[DM_SCAN_RESULT_NBR_SLOTS];
+    unsigned short  m_nbr_indexed;      // neighbors in the index
+
+	/**!
+	 * @brief Returns the first slot of a BSSID in the neighbor index.
+	 */
+	static unsigned int nbr_hash(const unsigned char *bssid);
 
 public:
     
@@ -37,7 +51,7 @@ public:
 	 *
 	 * @note This function does not take any parameters.
 	 */
-	int init() { memset(&m_scan_result, 0, sizeof(em_scan_result_t)); return 0; }
+	int init() { memset(&m_scan_result, 0, sizeof(em_scan_result_t)); reindex_neighbors(); return 0; }
     
 	/**!
 	 * @brief Retrieves the current scan result.
@@ -78,6 +92,13 @@ public:
 	 */
 	void encode(cJSON *obj);
 
+	/**!
+	 * @brief Encodes the scan result into the open object of a writer.
+	 *
+	 * @param[in] writer Writer, streaming or adding to a cJSON tree.
+	 */
+	void encode(dm_json_writer_t& writer);
+
     bool operator == (const dm_scan_result_t& obj);
     void operator = (const dm_scan_result_t& obj);
 
@@ -114,6 +135,38 @@ public:
 	 */
 	bool has_same_id(em_scan_result_id_t *);
 
+	/**!
+	 * @brief Looks a neighbor up by BSSID through the neighbor index.
+	 *
+	 * @param[in] bssid BSSID of the neighbor.
+	 *
+	 * @returns Pointer to the neighbor in m_scan_result, NULL if it is not there.
+	 *
+	 * @note The index is rebuilt first if the number of neighbors changed behind its back.
+	 */
+	em_neighbor_t *find_neighbor(const unsigned char *bssid);
+
+	/**!
+	 * @brief Updates the neighbor of the same BSSID, or appends it.
+	 *
+	 * @param[in] nbr The neighbor to store.
+	 *
+	 * @returns int
+	 * @retval 0 on success.
+	 * @retval -1 if the neighbor is new and the list is full.
+	 */
+	int put_neighbor(const em_neighbor_t *nbr);
+
+	/**!
+	 * @brief Rebuilds the neighbor index, to be called after the neighbors of m_scan_result were rewritten in place.
+	 */
+	void reindex_neighbors();
+
+	/**!
+	 * @brief Records that the scan result was just updated, the retention pass removes the least recently updated first.
+	 */
+	void touch();
+
     
 	/**!
 	 * @brief Processes the scan result and returns a dm_scan_result_t object.
@@ -150,6 +150,16 @@ public:
 	 * @note Ensure that the database client is properly initialized before calling this function.
 	 */
 	int update_db(db_client_t& db_client, dm_orch_type_t op, void *data);
+
+	/**!
+	 * @brief Deletes the rows of a scan result, its own and those of its neighbors, with one query.
+	 *
+	 * @param[in] db_client Reference to the database client.
+	 * @param[in] id Identity of the scan result.
+	 *
+	 * @returns 0 on success, -1 on failure.
+	 */
+	int delete_rows(db_client_t& db_client, const em_scan_result_id_t *id);
     
 	/**!
 	 * @brief Searches the database using the provided key.
@@ -223,6 +233,16 @@ public:
 	 */
 	int get_config(cJSON *obj, void *parent_id, bool summary = false);
 
+	/**!
+	 * @brief Writes the scan results of a radio, or of one scan, as rows of the array open in the writer.
+	 *
+	 * @param[in] writer Writer with an array open.
+	 * @param[in] parent_id Scan result key string of the radio or of the scan.
+	 *
+	 * @returns int 0 on success, -1 if the writer failed.
+	 */
+	int get_config(dm_json_writer_t& writer, void *parent_id);
+
     
 	/**!
 	 * @brief Retrieves the first scan result from the list.
@@ -0,0 +1,105 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef DM_SCAN_RETENTION_H
+#define DM_SCAN_RETENTION_H
+
+#include "em_hex.h"
+
+typedef struct {
+    unsigned int        max_age_ms;     // results not updated for this long are removed, 0 for no limit
+    unsigned int        max_per_radio;  // results of a scanner beyond this are removed, least recently updated first, 0 for no limit
+    unsigned long long  max_bytes;      // memory of all the results, 0 for no limit
+    unsigned int        min_idle_ms;    // results updated more recently are kept whatever the limits
+} dm_scan_retention_params_t;
+
+typedef struct {
+    em_packed_mac_t     scanner;        // radio or STA that scanned
+    unsigned long long  used_ms;        // last update
+    unsigned int        bytes;
+} dm_scan_retention_entry_t;
+
+typedef struct {
+    unsigned long long  passes;
+    unsigned long long  evicted_age;
+    unsigned long long  evicted_radio;
+    unsigned long long  evicted_memory;
+    unsigned int        last_entries;   // results seen by the last pass
+    unsigned long long  last_bytes;     // their memory, before the evictions
+} dm_scan_retention_stats_t;
+
+/*
+ * Retention of the scan results of the controller data models. A pass is given every
+ * result with the time it was last updated and picks the ones to remove: those older
+ * than the maximum age, then per scanner the least recently updated beyond the maximum
+ * count, then across all scanners the least recently updated until the memory is under
+ * the cap. Results updated within min_idle_ms are never picked, an em may be filling
+ * them. The caller removes the results and their rows. Not thread safe, run by the
+ * controller thread only.
+ */
+class dm_scan_retention_t {
+
+    dm_scan_retention_params_t m_params;
+    dm_scan_retention_stats_t m_stats;
+
+public:
+
+    /**!
+     * @brief Picks the results to remove.
+     *
+     * @param[in] now Current time in milliseconds.
+     * @param[in] entries The results.
+     * @param[in] num Number of results.
+     * @param[out] evict Array of num flags, set for the results to remove.
+     *
+     * @returns Number of results to remove.
+     */
+    unsigned int select(unsigned long long now, const dm_scan_retention_entry_t *entries, unsigned int num, bool *evict);
+
+    /**!
+     * @brief Returns true if a pass may remove something, false if no limit is set.
+     */
+    bool is_enabled() const { return (m_params.max_age_ms != 0) || (m_params.max_per_radio != 0) || (m_params.max_bytes != 0); }
+
+    /**!
+     * @brief Sets the parameters.
+     */
+    void set_params(const dm_scan_retention_params_t *params) { m_params = *params; }
+
+    /**!
+     * @brief Returns the parameters.
+     */
+    const dm_scan_retention_params_t& get_params() { return m_params; }
+
+    /**!
+     * @brief Returns the counters.
+     */
+    const dm_scan_retention_stats_t& get_stats() { return m_stats; }
+
+    /**!
+     * @brief Constructor for dm_scan_retention_t, with the default parameters.
+     */
+    dm_scan_retention_t();
+
+    /**!
+     * @brief Destructor for dm_scan_retention_t.
+     */
+    ~dm_scan_retention_t();
+};
+
+#endif
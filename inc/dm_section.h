@@ -0,0 +1,161 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef DM_SECTION_H
+#define DM_SECTION_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <new>
+
+#define DM_SECTION_MIN_SZ   4
+
+/*
+ * Variable length section of a data model, replaces a fixed array of N elements that is
+ * mostly empty. Storage is allocated on first use and doubles up to N elements, indexing
+ * keeps the array syntax and grows the section to reach the index. Reading an index that
+ * was never written from a const section returns a default element without allocating.
+ */
+template <typename T, unsigned int N>
+class dm_section_t {
+
+    T *m_elems;
+    unsigned int m_size;            // elements allocated
+
+public:
+
+    /**!
+     * @brief Makes room for a number of elements, new elements are default constructed.
+     *
+     * @param[in] num Number of elements needed, at most N.
+     *
+     * @returns 0 on success, -1 if num is above N or on allocation failure.
+     */
+    int reserve(unsigned int num)
+    {
+        unsigned int sz, i;
+        T *elems;
+
+        if (num <= m_size) {
+            return 0;
+        }
+        if (num > N) {
+            printf("%s:%d: Section of %d elements can not hold %d\n", __func__, __LINE__, N, num);
+            return -1;
+        }
+
+        for (sz = (m_size == 0) ? DM_SECTION_MIN_SZ:(m_size * 2); sz < num; sz *= 2);
+        sz = (sz > N) ? N:sz;
+
+        if ((elems = new (std::nothrow) T[sz]()) == NULL) {
+            printf("%s:%d: Failed to allocate %d elements\n", __func__, __LINE__, sz);
+            return -1;
+        }
+        for (i = 0; i < m_size; i++) {
+            elems[i] = m_elems[i];
+        }
+        delete [] m_elems;
+        m_elems = elems;
+        m_size = sz;
+
+        return 0;
+    }
+
+    /**!
+     * @brief Returns an element, growing the section to hold it.
+     *
+     * @param[in] idx Index of the element, below N.
+     *
+     * @returns Reference to the element, to a scratch element if it could not be allocated.
+     */
+    T& operator [] (unsigned int idx)
+    {
+        static T scratch;
+
+        if ((idx >= m_size) && (reserve(idx + 1) != 0)) {
+            return scratch;
+        }
+
+        return m_elems[idx];
+    }
+
+    /**!
+     * @brief Returns an element, a default element if it was never written.
+     *
+     * @param[in] idx Index of the element.
+     */
+    const T& operator [] (unsigned int idx) const
+    {
+        static const T empty{};
+
+        return (idx < m_size) ? m_elems[idx]:empty;
+    }
+
+    /**!
+     * @brief Returns the number of elements allocated.
+     */
+    unsigned int get_size() const { return m_size; }
+
+    /**!
+     * @brief Returns the bytes allocated for the elements.
+     */
+    size_t get_footprint() const { return m_size * sizeof(T); }
+
+    /**!
+     * @brief Frees all elements.
+     */
+    void clear()
+    {
+        delete [] m_elems;
+        m_elems = NULL;
+        m_size = 0;
+    }
+
+    dm_section_t& operator = (const dm_section_t& obj)
+    {
+        unsigned int i;
+
+        if (this == &obj) {
+            return *this;
+        }
+        if (reserve(obj.m_size) == 0) {
+            for (i = 0; i < obj.m_size; i++) {
+                m_elems[i] = obj.m_elems[i];
+            }
+        }
+
+        return *this;
+    }
+
+    /**!
+     * @brief Copy constructor for dm_section_t, the elements are copied.
+     */
+    dm_section_t(const dm_section_t& obj): m_elems(NULL), m_size(0) { *this = obj; }
+
+    /**!
+     * @brief Constructor for dm_section_t, nothing is allocated.
+     */
+    dm_section_t(): m_elems(NULL), m_size(0) { }
+
+    /**!
+     * @brief Destructor for dm_section_t.
+     */
+    ~dm_section_t() { clear(); }
+};
+
+#endif
@@ -22,9 +22,14 @@
 #include "em_base.h"
 #include "db_easy_mesh.h"
 
+#include <string>
+#include <unordered_map>
+
 class dm_ssid_2_vid_map_t : public db_easy_mesh_t {
     em_ssid_2_vid_map_info_t    m_ssid_2_vid_map_info;
     hash_map_t  *m_list;
+    std::unordered_map<std::string, unsigned short> m_vids;    // SSID to VID of the list, kept by update_list()
+    unsigned int m_generation;      // bumped when an SSID is added or its VID changes
 
 public:
     
@@ -96,6 +101,26 @@ public:
 	 */
 	dm_orch_type_t update_list(const dm_ssid_2_vid_map_t& ssid_2_vid);
 
+	/**!
+	 * @brief Returns the VID of an SSID, without walking the list.
+	 *
+	 * Traffic separation maps an SSID to the same VID on every device, the last mapping
+	 * added or updated wins.
+	 *
+	 * @param[in] ssid The SSID.
+	 *
+	 * @returns The VID, -1 if the SSID is not mapped.
+	 */
+	int get_vid(const char *ssid);
+
+	/**!
+	 * @brief Returns the generation of the map, it changes whenever an SSID is added or gets another VID.
+	 *
+	 * The Traffic Separation Policy and the VLANs derived from the map need not be
+	 * rebuilt while it stays the same.
+	 */
+	unsigned int get_generation() { return m_generation; }
+
     
 	/**!
 	 * @brief Initializes the SSID to VID mapping table.
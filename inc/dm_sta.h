@@ -19,11 +19,17 @@
 #ifndef DM_STA_H
 #define DM_STA_H
 
+#include <stdint.h>
 #include "em_base.h"
+#include "em_client_cap_cache.h"
+#include "dm_json_writer.h"
 
 class dm_sta_t {
 public:
     em_sta_info_t    m_sta_info;
+    bool    m_dirty;            // row changed since it was last written to the database
+    em_client_cap_t m_caps;     // elements of the frame body, parsed once
+    uint64_t    m_caps_hash;    // frame body m_caps and the element fields were parsed from, 0 if not parsed
 
 public:
     
@@ -34,7 +40,7 @@ public:
 	 *
 	 * @returns 0 on successful initialization.
 	 */
-	int init() { memset(&m_sta_info, 0, sizeof(em_sta_info_t)); return 0; }
+	int init() { memset(&m_sta_info, 0, sizeof(em_sta_info_t)); m_caps_hash = 0; return 0; }
     
 	/**!
 	 * @brief Retrieves the station information.
@@ -46,6 +52,31 @@ public:
 	 * @note Ensure that the returned pointer is not null before accessing its members.
 	 */
 	em_sta_info_t *get_sta_info() { return &m_sta_info; }
+
+	/**!
+	 * @brief Marks the station as changed, or clears the mark once its row is written.
+	 *
+	 * @param[in] dirty True if the database row of the station is out of date.
+	 */
+	void set_dirty(bool dirty) { m_dirty = dirty; }
+
+	/**!
+	 * @brief Returns true if the database row of the station is out of date.
+	 */
+	bool is_dirty() const { return m_dirty; }
+
+	/**!
+	 * @brief Returns the capabilities of the station, from the elements of its (Re)Association Request.
+	 *
+	 * The frame body is parsed on the first call and again only once it changed, the element
+	 * fields of m_sta_info are decoded with it.
+	 */
+	const em_client_cap_t *get_caps();
+
+	/**!
+	 * @brief Returns the hash of the frame body of a station, FNV-1a over its length too.
+	 */
+	static uint64_t get_frame_hash(const em_sta_info_t *info);
     
 	/**!
 	 * @brief Decodes a JSON object and associates it with a parent ID.
@@ -75,6 +106,14 @@ public:
 	 * @note Ensure that the cJSON object is properly initialized before calling this function.
 	 */
 	void encode(cJSON *obj, em_get_sta_list_reason_t reson = em_get_sta_list_reason_none);
+
+	/**!
+	 * @brief Encodes the station into the open object of a writer.
+	 *
+	 * @param[in] writer Writer, streaming or adding to a cJSON tree.
+	 * @param[in] reason The reason for encoding, selects the members written.
+	 */
+	void encode(dm_json_writer_t& writer, em_get_sta_list_reason_t reason = em_get_sta_list_reason_none);
 	
 	/**!
 	 * @brief Encodes a beacon report into a JSON object.
@@ -87,6 +126,13 @@ public:
 	 */
 	void encode_beacon_report(cJSON *obj);
 
+	/**!
+	 * @brief Encodes the beacon report as the Neighbors member of the open object of a writer.
+	 *
+	 * @param[in] writer Writer, streaming or adding to a cJSON tree.
+	 */
+	void encode_beacon_report(dm_json_writer_t& writer);
+
     bool operator == (const dm_sta_t& obj);
     void operator = (const dm_sta_t& obj);
 
@@ -110,7 +156,8 @@ public:
 	 * @brief Decodes the capabilities of a station.
 	 *
 	 * This function processes the capability information of a given station
-	 * and updates the relevant fields in the `dm_sta_t` structure.
+	 * and updates the relevant fields in the `dm_sta_t` structure. A frame body
+	 * that did not change since it was last decoded is not walked again.
 	 *
 	 * @param[in] sta Pointer to the `dm_sta_t` structure representing the station.
 	 *
@@ -0,0 +1,97 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef DM_STA_DELTA_H
+#define DM_STA_DELTA_H
+
+#include <stdint.h>
+#include "em_base.h"
+#include "dm_key_map.h"
+
+#define DM_STA_DELTA_RESYNC_MS      300000  // every associated STA is reported again at least this often
+
+typedef struct {
+    dm_map_key_t    key;
+    uint64_t        frame_hash;     // of the association request, a new one is a reassociation
+    unsigned int    pass;           // last apply() that listed the STA associated
+} dm_sta_delta_entry_t;
+
+typedef struct {
+    unsigned int    joined;         // new or reassociated STAs left in the assoc map
+    unsigned int    unchanged;      // STAs dropped from the assoc map
+    unsigned int    left;           // STAs of the disassoc map
+    unsigned int    vanished;       // STAs no longer listed and not in the disassoc map
+} dm_sta_delta_stats_t;
+
+/*
+ * STAs the agent last reported associated. An associated clients subdoc lists every
+ * client, apply() reduces the decoded maps to the STAs that joined or left since the
+ * previous subdoc, so that only those are copied into commands and notified. A STA
+ * that is no longer listed is forgotten without being reported, as it was before.
+ * All STAs are passed through every DM_STA_DELTA_RESYNC_MS, so that a report lost
+ * on the way to the controller is eventually repeated. Not thread safe.
+ */
+class dm_sta_delta_t {
+
+    dm_key_map_t m_stage;           // dm_sta_delta_entry_t of each STA reported associated
+    unsigned int m_pass;
+    unsigned long long m_resync_ms;
+    unsigned long long m_last_resync_ms;
+    dm_sta_delta_stats_t m_stats;   // of the last apply()
+
+    static uint64_t get_frame_hash(const em_sta_info_t *info);
+
+public:
+
+    /**!
+     * @brief Reduces the decoded maps of an associated clients subdoc to the changes.
+     *
+     * @param[in,out] assoc dm_sta_t of the associated STAs, those reported before are removed and freed.
+     * @param[in] dassoc dm_sta_t of the STAs that left, kept as they are.
+     * @param[in] now_ms Monotonic time in milliseconds.
+     *
+     * @returns Number of STAs left in both maps.
+     */
+    unsigned int apply(dm_key_map_t *assoc, dm_key_map_t *dassoc, unsigned long long now_ms);
+
+    /**!
+     * @brief Forgets all STAs, the next apply() passes every STA through.
+     */
+    void reset();
+
+    unsigned int get_count() const { return m_stage.count(); }
+
+    const dm_sta_delta_stats_t *get_stats() const { return &m_stats; }
+
+    /**!
+     * @brief Constructor for dm_sta_delta_t.
+     *
+     * @param[in] resync_ms Interval of the full reports, 0 to never repeat them.
+     */
+    explicit dm_sta_delta_t(unsigned long long resync_ms = DM_STA_DELTA_RESYNC_MS);
+
+    /**!
+     * @brief Destructor for dm_sta_delta_t.
+     */
+    ~dm_sta_delta_t();
+
+    dm_sta_delta_t(const dm_sta_delta_t&) = delete;
+    dm_sta_delta_t& operator=(const dm_sta_delta_t&) = delete;
+};
+
+#endif
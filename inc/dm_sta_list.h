@@ -45,6 +45,18 @@ public:
 	 */
 	int init();
 
+	/**!
+	 * @brief Reads the frame body of a STAList row, a blob or the hex text of the older rows.
+	 *
+	 * @param[in] db_client Reference to the database client the row is read from.
+	 * @param[in] ctx Result context of the row.
+	 * @param[in] col Column of the frame body (1-based).
+	 * @param[in,out] info STA whose frame_body_len is set, receives the frame body.
+	 *
+	 * @returns true if the row has the frame body in hex and is to be written again.
+	 */
+	static bool get_frame_body(db_client_t& db_client, void *ctx, unsigned int col, em_sta_info_t *info);
+
 
     
 	/**!
@@ -272,6 +284,17 @@ public:
 	 */
 	int get_config(cJSON *obj, void *parent_id, em_get_sta_list_reason_t reason);
 
+	/**!
+	 * @brief Writes the stations of a BSS as rows of the array open in the writer.
+	 *
+	 * @param[in] writer Writer with an array open.
+	 * @param[in] parent_id BSSID string of the BSS.
+	 * @param[in] reason The reason for retrieving the station list configuration.
+	 *
+	 * @returns int 0 on success, -1 if the writer failed.
+	 */
+	int get_config(dm_json_writer_t& writer, void *parent_id, em_get_sta_list_reason_t reason);
+
     
 	/**!
 	 * @brief Retrieves the first station.
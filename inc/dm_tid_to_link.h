@@ -49,6 +49,24 @@ public:
 	 * @note Ensure that the returned pointer is not null before dereferencing.
 	 */
 	em_tid_to_link_info_t *get_tid_to_link_info() { return &m_tid_to_link_info; }
+
+	/**!
+	 * @brief Sets the mapping of all the TIDs of a STA MLD, in both directions.
+	 *
+	 * The mappings are those of one AP MLD, the mapping of a STA MLD of another AP MLD is
+	 * refused until the mappings are pushed and cleared.
+	 *
+	 * @param[in] ap_mld MAC address of the AP MLD.
+	 * @param[in] sta_mld MAC address of the STA MLD.
+	 * @param[in] link_map Bit n set if the TIDs may use link ID n.
+	 * @param[in] default_map True if link_map holds all the links of the STA MLD.
+	 *
+	 * @returns int
+	 * @retval 1 if the mapping changed.
+	 * @retval 0 if the STA MLD already had it.
+	 * @retval -1 if the mappings are of another AP MLD or full.
+	 */
+	int set_mapping(const unsigned char *ap_mld, const unsigned char *sta_mld, unsigned char link_map, bool default_map);
     
 	/**!
 	 * @brief Decodes a JSON object to extract relevant information.
@@ -11,9 +11,13 @@ Specification sections referenced according to:
 #include "ec_ops.h"
 #include "ec_crypto.h"
 #include "em_crypto.h"
+#include "em_1905_key_table.h"
 #include "util.h"
 
+#include <deque>
 #include <map>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 #include <stdexcept>
 
@@ -28,6 +32,25 @@ using handshake_completed_handler = std::function<void(uint8_t[ETH_ALEN], bool)>
 static const uint8_t EAPOL_KDE_OUI_WFA[3] = {0x50, 0x6F, 0x9A};
 static const uint8_t EAPOL_KDE_OUI[3] = {0x00, 0x0F, 0xAC};
 
+// Largest Key Data carried in the 1905 EAPOL-Key frames, the 1905 GTK KDE with room to spare
+#define EC_1905_KEY_DATA_MAX_LEN 256
+
+// Group key handshakes kept in flight by a GTK rekey, the other peers wait for a free place
+#define EC_1905_GTK_REKEY_MAX_INFLIGHT  8
+// Time to wait for message 2 of a group key handshake before sending message 1 again
+#define EC_1905_GTK_REKEY_TIMEOUT_MS    1000
+// Resends of message 1 before giving up on a peer
+#define EC_1905_GTK_REKEY_MAX_RETRIES   3
+
+/**
+ * @brief Progress of the group key handshake with one peer during a GTK rekey
+ */
+typedef struct {
+    uint64_t start_ms;      // first message 1 sent
+    uint64_t sent_ms;       // last message 1 sent
+    unsigned int retries;
+} ec_1905_gtk_rekey_t;
+
 class ec_1905_encrypt_layer_t {
 public:
     /**
@@ -35,12 +58,14 @@ public:
      * @param local_al_mac AL MAC address string for local device
      * @param send_direct_encap_dpp_msg Callback for sending DPP frames
      * @param send_1905_eapol_encap_msg Callback for sending EAPOL frames
+     * @param defer Callback for running a step later, the layer sleeps instead when not set
      * @throws std::invalid_argument if local_al_mac format is invalid
      */
     ec_1905_encrypt_layer_t(std::string local_al_mac, 
                             send_dir_encap_dpp_func send_direct_encap_dpp_msg,
                             send_1905_eapol_encap_func send_1905_eapol_encap_msg,
-                            handshake_completed_handler handshake_complete);
+                            handshake_completed_handler handshake_complete,
+                            defer_func defer = nullptr);
     ~ec_1905_encrypt_layer_t() {
         if (m_C_signing_key) em_crypto_t::free_key(m_C_signing_key);
         if (m_net_access_key) em_crypto_t::free_key(m_net_access_key);
@@ -128,13 +153,34 @@ public:
 
     /**
      * @brief Rekeys GTK and distributes to all enrolled agents
-     * @return true if GTK regenerated and distributed successfully
+     * @return true if GTK regenerated and its distribution started
      * 
      * @note Controller-only operation. Generates new GTK and sends
-     *       to all agents (EM 5.4.7.5) via group key handshake (EM 5.3.7.3)
+     *       to all agents (EM 5.4.7.5) via group key handshake (EM 5.3.7.3).
+     *       At most EC_1905_GTK_REKEY_MAX_INFLIGHT handshakes run at once, the next
+     *       agent is started as each one completes or is given up.
      */
     bool rekey_1905_layer_gtk();
 
+    /**
+     * @brief Retries the overdue group key handshakes of a GTK rekey
+     * 
+     * @note Called periodically from the protocol thread. Message 1 is sent again to the peers
+     *       that did not answer within EC_1905_GTK_REKEY_TIMEOUT_MS, up to EC_1905_GTK_REKEY_MAX_RETRIES
+     *       times, and waiting peers are started in the places that freed up.
+     */
+    void handle_gtk_rekey_timeout();
+
+    /**
+     * @brief Number of peers whose group key handshake of the current GTK rekey has not completed
+     */
+    size_t get_gtk_rekey_outstanding() const { return m_gtk_rekey_pending.size() + m_gtk_rekey_inflight.size(); }
+
+    /**
+     * @brief Keys installed by the handshakes, by peer AL MAC, for the protection of the 1905 messages
+     */
+    em_1905_key_table_t *get_key_table() { return &m_key_table; }
+
 
 private:
     // Cryptographic key material
@@ -143,8 +189,8 @@ private:
     std::string m_connector_1905;
     const EVP_MD *m_hash_fn = nullptr;
     
-    // Session context and peer management
-    std::map<std::string, ec_1905_key_ctx> m_1905_mac_key_mac;
+    // Session context and peer management, keyed by the peer's AL MAC packed in an integer
+    std::unordered_map<uint64_t, ec_1905_key_ctx> m_1905_mac_key_mac;
     std::vector<uint8_t> m_al_mac_addr;
     uint8_t m_transaction_id = 0;
     const uint8_t empty_nonce[SHA256_DIGEST_LENGTH] = {0};
@@ -154,6 +200,16 @@ private:
     uint8_t m_gtk[SHA512_DIGEST_LENGTH];
     uint8_t m_gtk_id; // GTK ID (1-3) (2 bits, cannot include 0, as per EasyMesh Table 12)
     uint64_t m_gtk_rekey_counter = 0;
+
+    // 1905 TKs and GTK as installed through set_key, with the per frame counters
+    em_1905_key_table_t m_key_table;
+
+    // GTK rekey fan-out (controller only), peers waiting for a handshake and the ones in flight
+    std::deque<uint64_t> m_gtk_rekey_pending;
+    std::unordered_map<uint64_t, ec_1905_gtk_rekey_t> m_gtk_rekey_inflight;
+    uint64_t m_gtk_rekey_start_ms = 0;
+    unsigned int m_gtk_rekey_done = 0;
+    unsigned int m_gtk_rekey_failed = 0;
     
     // Key derivation parameters
     uint16_t mic_kck_bits = 0;
@@ -163,6 +219,10 @@ private:
     send_dir_encap_dpp_func m_send_dir_encap_dpp_msg;
     send_1905_eapol_encap_func m_send_1905_eapol_encap_msg;
     handshake_completed_handler m_handshake_complete;
+    defer_func m_defer;
+
+    // expires with the layer, deferred steps check it before touching the layer
+    std::shared_ptr<bool> m_alive = std::make_shared<bool>(true);
 
     // DPP frame creation
     /**
@@ -197,6 +257,28 @@ private:
      */
     bool begin_1905_4way_handshake(uint8_t dest_al_mac[ETH_ALEN], bool do_rekey);
 
+    /**
+     * @brief Builds and sends message 1 of the group key handshake with the current GTK
+     * @param mac AL MAC address of the peer
+     * @param ctx Key context for the peer
+     * @return true if the frame was sent
+     */
+    bool send_gtk_rekey(uint8_t mac[ETH_ALEN], ec_1905_key_ctx& ctx);
+
+    /**
+     * @brief Starts the group key handshakes of waiting peers up to EC_1905_GTK_REKEY_MAX_INFLIGHT
+     * 
+     * @note Reports the rekey as a whole once no peer is left.
+     */
+    void pump_gtk_rekey();
+
+    /**
+     * @brief Ends the group key handshake with a peer, reporting its latency
+     * @param key Key of the peer in the key context table
+     * @param ok True if the handshake completed, false if the peer was given up
+     */
+    void finish_gtk_rekey(uint64_t key, bool ok);
+
     // Cryptographic operations
     /**
      * @brief Computes PMK and PMKID from received connector payload
@@ -403,9 +485,12 @@ private:
      * @param ctx Key context containing PTK-KCK
      * @param eapol_frame EAPOL frame buffer
      * @param eapol_frame_size Frame size
-     * @return MIC vector, or empty vector on error
+     * @param mic Output buffer for the MIC, `mic_kck_bits / 8` bytes
+     * @return true if the MIC was calculated
+     * 
+     * @note The frame is not modified, its Key MIC field is taken as zero.
      */
-    std::vector<uint8_t> calculate_mic(ec_1905_key_ctx &ctx, uint8_t* eapol_frame, size_t eapol_frame_size);
+    bool calculate_mic(ec_1905_key_ctx &ctx, uint8_t* eapol_frame, size_t eapol_frame_size, uint8_t *mic);
 
     /**
      * @brief Verifies EAPOL frame MIC for authentication
@@ -419,24 +504,26 @@ private:
     /**
      * @brief Encrypts key data using NIST AES Key Wrap
      * @param ctx Key context containing PTK-KEK
-     * @param key_data_plain Plaintext key data
+     * @param key_data_plain Plaintext key data, at most EC_1905_KEY_DATA_MAX_LEN bytes once padded
      * @param key_data_len Key data length
-     * @return Pair of encrypted buffer and size, or {nullptr, 0} on error
+     * @param wrapped_key_data Output buffer for the encrypted key data
+     * @param wrapped_size Size of the output buffer, the padded length + 8 is needed
+     * @return Encrypted key data length, or 0 on error
      * 
      * @note Applies padding per IEEE 802.11 12.7.2j before encryption.
      */
-    std::pair<uint8_t*, size_t> encrypt_key_data(ec_1905_key_ctx& ctx, uint8_t* key_data_plain, size_t key_data_len);
+    size_t encrypt_key_data(ec_1905_key_ctx& ctx, uint8_t* key_data_plain, size_t key_data_len, uint8_t *wrapped_key_data, size_t wrapped_size);
 
     /**
      * @brief Decrypts key data using NIST AES Key Unwrap
      * @param ctx Key context containing PTK-KEK
      * @param wrapped_key_data Encrypted key data
      * @param key_data_len Encrypted data length
-     * @return Pair of decrypted buffer and size, or {nullptr, 0} on error
-     * 
-     * @note Caller must free returned buffer
+     * @param unwrapped_key_data Output buffer for the decrypted key data
+     * @param unwrapped_size Size of the output buffer, at least `key_data_len`
+     * @return Decrypted key data length without padding, or 0 on error
      */
-    std::pair<uint8_t*, size_t> decrypt_key_data(ec_1905_key_ctx& ctx, uint8_t* wrapped_key_data, size_t key_data_len);
+    size_t decrypt_key_data(ec_1905_key_ctx& ctx, uint8_t* wrapped_key_data, size_t key_data_len, uint8_t *unwrapped_key_data, size_t unwrapped_size);
 
     // Key installation
     /*
@@ -866,6 +866,12 @@ typedef struct {
      * @brief Is this Enrollee onboarding via ethernet?
      */
     bool is_eth;
+
+    /**
+     * @brief The "chirp" hash of the responder bootstrapping key, computed on the first chirp since every chirp is matched against it.
+     */
+    uint8_t chirp_hash[SHA256_DIGEST_LENGTH];
+    bool has_chirp_hash;
 } ec_connection_context_t;
 
 
@@ -408,6 +408,18 @@ public:
 		return m_1905_encrypt_layer->rekey_1905_layer_gtk();
 	}
 
+	/**
+     * @brief Retries the overdue group key handshakes of a GTK rekey
+     */
+	inline void handle_gtk_rekey_timeout() {
+		m_1905_encrypt_layer->handle_gtk_rekey_timeout();
+	}
+
+	/**
+     * @brief Drops the onboarding sessions that stalled, only the Controller Configurator keeps sessions
+     */
+	virtual void handle_session_timeout() {}
+
 	/**
 	 * @brief Retrieves the current security context.
 	 */
@@ -452,6 +464,8 @@ protected:
 
     send_encap_dpp_func m_send_prox_encap_dpp_msg;
 
+    send_encap_dpp_frame_func m_send_prox_encap_dpp_frame;
+
     send_dir_encap_dpp_func m_send_dir_encap_dpp_msg;
 
     send_act_frame_func m_send_action_frame;
@@ -472,6 +486,24 @@ protected:
 	// The key can be the phy MAC or the AL MAC, depending on the context.
 	// The `peer_al_mac` field in the context will always be the AL MAC (when it's been set)
     std::map<std::string, ec_connection_context_t> m_connections = {};
+
+	/**!
+	 * @brief Sends a DPP frame to an AL in a Proxied Encap DPP message without a chirp.
+	 *
+	 * The 1905 Encap DPP TLV is written straight into the outgoing message, the frame is copied once.
+	 * Without the send_encap_dpp_frame op the TLV is created on the heap and sent with send_encap_dpp.
+	 *
+	 * @param[in] dpp_frame_indicator 0 for a DPP Public Action frame, 1 for a GAS frame.
+	 * @param[in] dest_mac The Destination STA MAC address of the TLV, NULL if not present.
+	 * @param[in] frame_type The frame type of the TLV.
+	 * @param[in] frame The DPP frame, still owned by the caller.
+	 * @param[in] frame_len The length of the DPP frame.
+	 * @param[in] dest_al_mac The destination AL MAC address.
+	 *
+	 * @returns true if the message was sent, false otherwise.
+	 */
+	bool send_prox_encap_dpp_frame(bool dpp_frame_indicator, uint8_t *dest_mac, ec_frame_type_t frame_type,
+								   uint8_t *frame, size_t frame_len, uint8_t dest_al_mac[ETH_ALEN]);
     
 	/**!
 	 * @brief Retrieves the connection context for a given MAC address.
@@ -820,6 +820,8 @@ public:
 	/**
 	 * @brief Split and decode a connector into its constituent parts. 
 	 * If the signing_key is provided, it will also verify the signature.
+	 * Verified Connectors are remembered until they expire, at most for an hour,
+	 * so the same Connector and C-sign-key are only verified once.
 	 *
 	 * @param[in] conn The connector to split and decode.
 	 * @param[in] signing_key If provided, signature verification will be performed using this key.
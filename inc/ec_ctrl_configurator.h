@@ -4,6 +4,14 @@
 #include "ec_configurator.h"
 #include <unordered_map>
 
+// Chirps handled per second across all Enrollees, a whole site chirping after a factory reset is spread over time
+#define EC_CTRL_CHIRP_RATE_PER_SEC      10
+#define EC_CTRL_CHIRP_BURST             20
+// A chirp from an Enrollee whose session moved within this window is a retransmission and is dropped
+#define EC_CTRL_CHIRP_HOLDOFF_MS        3000
+// A session that stays in one phase for longer than this is dropped, the Enrollee chirps again
+#define EC_CTRL_SESSION_PHASE_TIMEOUT_MS 10000
+
 // forward decl
 struct cJSON;
 
@@ -16,6 +24,37 @@ typedef enum {
 	dpp_config_obj_backhaul_bss
 } dpp_config_obj_type_e;
 
+// What the Configurator waits for from an Enrollee being onboarded
+typedef enum {
+    ec_session_phase_auth = 0,      // Authentication Response
+    ec_session_phase_config,        // Configuration Request
+    ec_session_phase_result,        // Configuration Result
+    ec_session_phase_conn_status,   // Connection Status Result
+    ec_session_phase_max
+} ec_session_phase_t;
+
+typedef struct {
+    std::string mac;                // key of the connection context
+    ec_session_phase_t phase;
+    uint64_t start_ms;
+    uint64_t phase_start_ms;
+    uint64_t phase_ms[ec_session_phase_max];
+} ec_ctrl_session_t;
+
+typedef struct {
+    unsigned int active;
+    unsigned int peak_active;
+    unsigned long long started;
+    unsigned long long completed;
+    unsigned long long failed;
+    unsigned long long timed_out;
+    unsigned long long chirps_dropped;
+    // time spent in every phase by the sessions that went through it
+    unsigned long long phase_count[ec_session_phase_max];
+    unsigned long long phase_total_ms[ec_session_phase_max];
+    unsigned long long phase_max_ms[ec_session_phase_max];
+} ec_ctrl_session_stats_t;
+
 class ec_ctrl_configurator_t : public ec_configurator_t {
 public:
     
@@ -199,6 +238,18 @@ public:
 	 */
 	static cJSON *finalize_dpp_config_obj(cJSON *base, dpp_config_obj_type_e config_obj_type, ec_persistent_sec_ctx_t* sec_ctx, SSL_KEY* enrollee_net_access_key);
 
+	/**
+	 * @brief Drops the onboarding sessions that stayed too long in one phase.
+	 *
+	 * @note Called periodically from the protocol thread.
+	 */
+	void handle_session_timeout() override;
+
+	/**
+	 * @brief Returns the counters of the onboarding sessions.
+	 */
+	const ec_ctrl_session_stats_t& get_session_stats() const { return m_session_stats; }
+
 private:
     // Private member variables can be added here
 
@@ -328,6 +379,54 @@ private:
 	// The Group Master Key (GMK) used to securing the 1905 layer
 	std::vector<uint8_t> m_gmk;
 
+	/**
+	 * @brief Takes a chirp token, so that a burst of chirps is handled at EC_CTRL_CHIRP_RATE_PER_SEC.
+	 *
+	 * @param enrollee_mac The MAC of the chirping Enrollee.
+	 * @return true if the chirp should be handled, false if it is dropped.
+	 */
+	bool admit_chirp(const uint8_t enrollee_mac[ETH_ALEN]);
+
+	/**
+	 * @brief Starts, or restarts, the onboarding session of an Enrollee once its Authentication Request is sent.
+	 *
+	 * @param enrollee_mac The MAC of the Enrollee, as used to key its connection context.
+	 */
+	void begin_session(const uint8_t enrollee_mac[ETH_ALEN]);
+
+	/**
+	 * @brief Moves the session of an Enrollee on to the next phase.
+	 *
+	 * @param enrollee_mac The MAC of the Enrollee.
+	 * @param phase The phase the session now waits in.
+	 */
+	void advance_session(const uint8_t enrollee_mac[ETH_ALEN], ec_session_phase_t phase);
+
+	/**
+	 * @brief Ends the session of an Enrollee and records its phase latencies.
+	 *
+	 * @param enrollee_mac The MAC of the Enrollee.
+	 * @param success Whether the Enrollee was onboarded.
+	 */
+	void end_session(const uint8_t enrollee_mac[ETH_ALEN], bool success);
+
+	/**
+	 * @brief Returns the chirp hash of the responder bootstrapping key of a connection, computing it on first use.
+	 *
+	 * @param conn_ctx The connection context.
+	 * @return The SHA-256 "chirp" hash, or NULL if it could not be computed.
+	 */
+	const uint8_t *get_chirp_hash(ec_connection_context_t *conn_ctx);
+
+	// Onboarding sessions keyed by the Enrollee MAC packed into an integer
+	std::unordered_map<uint64_t, ec_ctrl_session_t> m_sessions;
+
+	ec_ctrl_session_stats_t m_session_stats = {};
+
+	// Chirp token bucket
+	double m_chirp_tokens = EC_CTRL_CHIRP_BURST;
+	uint64_t m_chirp_refill_ms = 0;
+
 };
 
 #endif // EC_CTRL_CONFIGURATOR_H
@@ -6,6 +6,7 @@
 #include "ec_util.h"
 #include "ec_ops.h"
 #include "ec_1905_encrypt_layer.h"
+#include "ec_gas_frag.h"
 #include "timer.h"
 
 #include <map>
@@ -14,8 +15,12 @@
 #include <vector>
 #include <unordered_set>
 #include <atomic>
+#include <mutex>
 #include <thread>
 
+// Listen time on a channel of the Presence Announcement sweep, EasyConnect 6.2.3
+#define EC_PRES_ANNOUNCE_DWELL_MS   2000
+
 struct cJSON;
 
 class ec_enrollee_t {
@@ -279,6 +284,13 @@ public:
 	 */
 	bool handle_bss_info_event(const std::vector<wifi_bss_info_t> &bss_info_list);
 
+	/**
+	 * @brief Time from the first Presence Announcement to the first DPP Authentication Request of this onboarding
+	 * 
+	 * @return The time in ms, or -1 if no Authentication Request was received yet
+	 */
+	int64_t get_time_to_first_auth_request_ms() const { return m_time_to_first_auth_req_ms.load(); }
+
 	/**
      * @brief Initiates secure 1905 layer establishment with peer
      * @param dest_al_mac Destination AL MAC address
@@ -364,6 +376,22 @@ private:
 	 */
 	void send_reconfiguration_announcement_frames();
 
+	/**
+	 * @brief Orders a channel list for an announcement sweep
+	 * 
+	 * Channels where a BSS advertises a CCE IE come first, the ones with the most such BSSs and the best RSSI
+	 * leading, then the channels where the configured SSID was heard, then the rest of the list.
+	 * 
+	 * @param is_reconfig_list If true, order the reconfiguration channel list, otherwise the presence announcement one.
+	 * @return The channels in the order to announce on
+	 */
+	std::vector<uint32_t> get_announcement_schedule(bool is_reconfig_list);
+
+	/**
+	 * @brief Returns true if a BSS advertising a CCE IE was heard on the channel
+	 */
+	bool is_cce_channel(uint32_t freq);
+
 
 	/**
 	 * @brief Check that a given BSS Info has a CCE IE present in it's IE buffer
@@ -559,12 +587,13 @@ private:
 	std::pair<uint8_t*, size_t> create_connection_status_result(ec_status_code_t dpp_status, const std::string& ssid);
 
 	/**
-	 * @brief Create a GAS Comeback Request frame with default fields to be sent to a Peer indicating we're ready to receive the next GAS Comeback Response frame
+	 * @brief Send a GAS Comeback Request frame to a Peer indicating we're ready to receive the next GAS Comeback Response frame
 	 * 
+	 * @param dest_mac The MAC of the Peer
 	 * @param dialog_token The dialog token of the GAS session
-	 * @return ec_gas_comeback_request_frame_t* The GAS Comeback Frame on success, otherwise nullptr
+	 * @return true if the frame was sent, otherwise false
 	 */
-	ec_gas_comeback_request_frame_t *create_comeback_request(uint8_t dialog_token);
+	bool send_comeback_request(uint8_t dest_mac[ETH_ALEN], uint8_t dialog_token);
     
 	/**
 	 * @brief Create a DPP Connection Status object (EasyConnect 6.5.4.2)
@@ -670,6 +699,24 @@ private:
 	 */
 	std::atomic<bool> m_received_scan_results{false};
 
+	/**
+	 * @brief What the scan results told about a channel of the announcement channel lists
+	 */
+	typedef struct {
+		unsigned int num_cce_bss;	// BSSs advertising a CCE IE
+		int best_rssi;				// best RSSI of those BSSs
+		bool has_ssid;				// the configured SSID was heard
+	} ec_announce_chan_t;
+
+	// Key -> frequency
+	std::unordered_map<uint32_t, ec_announce_chan_t> m_announce_chans = {};
+
+	// The channel lists are filled in by the scan results while the announcement threads read them
+	std::mutex m_announce_mtx;
+
+	std::atomic<uint64_t> m_pres_announce_start_ms{0};
+	std::atomic<int64_t> m_time_to_first_auth_req_ms{-1};
+
     /**
      * @brief Thread for sending DPP Presence Announcement frames upon onboarding start
      * 
@@ -695,21 +742,8 @@ private:
 
 	std::shared_ptr<ThreadedTimer> m_autoconf_search_timer = std::make_shared<ThreadedTimer>();
 
-	/**
-	 * @brief Metadata about a fragmented GAS response frame
-	 * 
-	 */
-	struct gas_fragment_buffer_t {
-		uint8_t dialog_token = 0;
-		std::vector<uint8_t> reassembled_payload = {};
-		uint8_t expected_fragment_id = 0;
-		bool complete = false;
-		std::chrono::steady_clock::time_point last_seen = std::chrono::steady_clock::now();
-	};
-
-	// Key -> sender's MAC + dialog_token (example: aabbcceeddff_42) as a string
-	// Value -> buffer for re-assembling GAS frame fragments
-	std::unordered_map<std::string, gas_fragment_buffer_t> m_gas_fragments;
+	// Reassembles the Configuration Responses sent in GAS Comeback Response fragments
+	ec_gas_frag_t m_gas_frag;
 
 	/**
 	 * @brief Map of BSSIDs (as strings) that we are awaiting association status for
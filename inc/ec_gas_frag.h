@@ -0,0 +1,109 @@
+#ifndef EC_GAS_FRAG_H
+#define EC_GAS_FRAG_H
+
+#include "ec_util.h"
+
+#include <vector>
+
+// GAS exchanges with fragments in flight, one per peer being configured
+#define EC_GAS_FRAG_MAX_SESSIONS    4
+// Payload capacity reserved per session, a DPP Configuration Response with a few Configuration Objects fits
+#define EC_GAS_FRAG_BUF_RESERVE     (4 * WIFI_MTU_SIZE)
+// Largest payload carried over the 7 bit Fragment ID
+#define EC_GAS_FRAG_MAX_PAYLOAD     (128 * WIFI_MTU_SIZE)
+// A session that saw no fragment for this long is given to the next exchange
+#define EC_GAS_FRAG_SESSION_TIMEOUT_MS  5000
+
+typedef enum {
+    ec_gas_frag_error = -1,
+    ec_gas_frag_more,       // more fragments to come
+    ec_gas_frag_complete,   // the payload is complete
+} ec_gas_frag_status_t;
+
+/**
+ * @brief One fragmented GAS exchange with a peer
+ */
+typedef struct {
+    uint64_t peer;                  // MAC packed in an integer, 0 when the session is free
+    uint8_t dialog_token;
+    uint8_t fragment_id;            // next Fragment ID to receive or send
+    size_t offset;                  // bytes of the payload already sent
+    uint64_t last_ms;
+    std::vector<uint8_t> payload;   // capacity is kept from one exchange to the next
+} ec_gas_frag_session_t;
+
+/**
+ * @brief Reassembles and fragments the GAS Comeback Responses carrying DPP Configuration Responses.
+ *
+ * The receiving side (Enrollee) adds every GAS Comeback Response it gets and is handed the complete
+ * payload with the last one. A payload that fits in a single fragment is handed out of the frame
+ * itself, without a copy. The sending side (Proxy Agent) queues the whole payload once and builds
+ * each GAS Comeback Response on demand in a frame buffer that is reused.
+ *
+ * Sessions and their buffers are allocated once. A peer has one session, a new dialog token restarts it.
+ */
+class ec_gas_frag_t {
+public:
+    ec_gas_frag_t();
+
+    /**
+     * @brief Adds a received GAS Comeback Response to the payload reassembled from a peer.
+     *
+     * @param peer The MAC of the sender.
+     * @param frame The GAS Comeback Response frame.
+     * @param len The length of the frame.
+     * @param[out] payload The complete payload, valid until the next call for this peer or `release`.
+     * @param[out] payload_len The length of the complete payload.
+     * @return ec_gas_frag_complete once the last fragment is added, ec_gas_frag_more while fragments are
+     *         missing, ec_gas_frag_error on a malformed or out of order fragment (the session is dropped).
+     */
+    ec_gas_frag_status_t add_fragment(const uint8_t peer[ETH_ALEN], const ec_gas_comeback_response_frame_t *frame, size_t len,
+                                      const uint8_t **payload, size_t *payload_len);
+
+    /**
+     * @brief Queues a payload to be sent to a peer in GAS Comeback Responses.
+     *
+     * @param peer The MAC of the receiver.
+     * @param dialog_token The dialog token of the GAS exchange.
+     * @param payload The payload, copied.
+     * @param len The length of the payload.
+     * @return true on success, false if the payload is too large.
+     */
+    bool queue(const uint8_t peer[ETH_ALEN], uint8_t dialog_token, const uint8_t *payload, size_t len);
+
+    /**
+     * @brief Builds the next GAS Comeback Response queued for a peer.
+     *
+     * @param peer The MAC of the receiver.
+     * @param[out] frame_len The length of the frame.
+     * @return The frame, valid until the next call, or NULL if nothing is queued for the peer.
+     *         The session is released once its last fragment is built.
+     */
+    const ec_gas_comeback_response_frame_t *next_fragment(const uint8_t peer[ETH_ALEN], size_t *frame_len);
+
+    /**
+     * @brief Returns whether fragments are queued for a peer.
+     */
+    bool has_pending(const uint8_t peer[ETH_ALEN]) const;
+
+    /**
+     * @brief Releases the session of a peer, its buffer is kept for the next exchange.
+     */
+    void release(const uint8_t peer[ETH_ALEN]);
+
+private:
+    ec_gas_frag_session_t *find(uint64_t peer);
+    const ec_gas_frag_session_t *find(uint64_t peer) const;
+
+    /**
+     * @brief Takes a session for a new exchange, the one of the peer, a free one or the least recently used one.
+     */
+    ec_gas_frag_session_t *claim(uint64_t peer, uint8_t dialog_token);
+
+    ec_gas_frag_session_t m_sessions[EC_GAS_FRAG_MAX_SESSIONS];
+
+    // GAS Comeback Response built by next_fragment
+    std::vector<uint8_t> m_tx_frame;
+};
+
+#endif // EC_GAS_FRAG_H
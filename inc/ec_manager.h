@@ -174,6 +174,28 @@ public:
 		return m_configurator->rekey_1905_layer_gtk();
 	}
 
+	/**
+     * @brief Retries the overdue group key handshakes of a GTK rekey
+     * 
+     * @note Called periodically from the protocol thread, does nothing on agents.
+     */
+	inline void handle_gtk_rekey_timeout() {
+		if (m_configurator != nullptr && m_is_controller) {
+			m_configurator->handle_gtk_rekey_timeout();
+		}
+	}
+
+	/**
+	 * @brief Drops the DPP onboarding sessions that stalled
+	 * 
+	 * @note Called periodically from the protocol thread, does nothing on agents.
+	 */
+	inline void handle_dpp_session_timeout() {
+		if (m_configurator != nullptr && m_is_controller) {
+			m_configurator->handle_session_timeout();
+		}
+	}
+
 	/**
 	 * @brief Get the security context of the node
 	 * 
@@ -78,6 +78,19 @@ using send_chirp_func = std::function<bool(em_dpp_chirp_value_t*, size_t, uint8_
  */
 using send_encap_dpp_func = std::function<bool(em_encap_dpp_t*, size_t, em_dpp_chirp_value_t*, size_t, uint8_t*)>;
 
+/**
+ * @brief Sends a proxied encapsulated DPP message, the 1905 Encap DPP TLV is written straight into the message
+ * 
+ * @param dpp_frame_indicator 0 for a DPP Public Action frame, 1 for a GAS frame
+ * @param dest_mac The Destination STA MAC address of the TLV (6 bytes), NULL if not present
+ * @param frame_type The frame type of the TLV
+ * @param frame The DPP frame to encapsulate
+ * @param frame_len The length of the DPP frame
+ * @param dst_al_mac The destination AL MAC address (6 bytes)
+ * @return bool true if successful, false otherwise
+ */
+using send_encap_dpp_frame_func = std::function<bool(bool, uint8_t*, ec_frame_type_t, uint8_t*, size_t, uint8_t*)>;
+
 
 /**
  * @brief Sends a direct encapsulated DPP message
@@ -164,6 +177,15 @@ using get_fbss_info_func = std::function<cJSON*(uint8_t*)>;
  */
 using can_onboard_additional_aps_func = std::function<bool(void)>;
 
+/**
+ * @brief Runs a function once a delay has passed, without blocking the caller.
+ *
+ * @param delay_ms The delay in milliseconds
+ * @param fn The function to run, called on the thread of the em that owns the EC manager
+ * @return bool true if the function was scheduled, false otherwise
+ */
+using defer_func = std::function<bool(unsigned int, std::function<void()>)>;
+
 /**
  * @brief Callback configuration structure for EasyConnect (EC) logic
  * 
@@ -177,6 +199,7 @@ using can_onboard_additional_aps_func = std::function<bool(void)>;
 struct ec_ops_t {
     send_chirp_func send_chirp = nullptr;
     send_encap_dpp_func send_encap_dpp = nullptr;
+    send_encap_dpp_frame_func send_encap_dpp_frame = nullptr;
     send_dir_encap_dpp_func send_dir_encap_dpp = nullptr;
     send_act_frame_func send_act_frame = nullptr;
     toggle_cce_func toggle_cce = nullptr;
@@ -190,4 +213,5 @@ struct ec_ops_t {
     send_autoconf_search_func send_autoconf_search = nullptr;
     send_autoconf_search_resp_func send_autoconf_search_resp = nullptr;
     send_bss_config_req_func send_bss_config_req = nullptr;
+    defer_func defer = nullptr;
 };
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define EC_PA_CONFIGURATOR_H
 
 #include "ec_configurator.h"
+#include "ec_gas_frag.h"
 #include "util.h"
 
 #include <map>
@@ -199,20 +200,10 @@ private:
 	bool send_prepare_for_fragmented_frames_frame(uint8_t dest_mac[ETH_ALEN]);
 
 	/**
-	 * @brief Fragments a frame whose size exceeds the MTU size
+	 * @brief Frames too large for the MTU, sent to a peer a fragment at a time once they indicate (via a GAS Comeback Request frame) that they are ready to receive more fragments
 	 * 
-	 * @param payload The total payload
-	 * @param len The full length
-	 * @param dialog_token The GAS peer session dialog token
-	 * @return std::vector<ec_gas_comeback_response_frame_t *> Vector of frame fragments encapsulated in GAS Comeback Response frames, otherwise empty
 	 */
-	std::vector<ec_gas_comeback_response_frame_t *> fragment_large_frame(const uint8_t *payload, size_t len, uint8_t dialog_token);
-
-	/**
-	 * @brief Queue'd fragments to be sent to a peer once they indicate (via a GAS Comeback Request frame) that they are ready to receive more fragments
-	 * 
-	 */
-	std::unordered_map<std::string, std::vector<ec_gas_comeback_response_frame_t*>> m_gas_frames_to_be_sent = {};
+	ec_gas_frag_t m_gas_frag;
 
 protected:
     // Protected member variables and methods go here
@@ -41,6 +41,11 @@
 // -100 buffer is for frame overhead (management header, etc).
 #define WIFI_MTU_SIZE (1500UL - 100UL)
 
+// Attributes of a frame that are indexed, the rest is found by walking the remainder
+#define EC_ATTRIB_INDEX_MAX 32
+// Bytes a writer holds without allocating, enough for the wrapped plaintext of the Authentication frames
+#define EC_ATTRIB_WRITER_INLINE_SZ 256
+
 typedef enum {
     DPP_URI_VERSION = 0,
     DPP_URI_MAC,
@@ -241,66 +246,54 @@ public:
 
     
 	/**!
-	 * @brief Allocates a GAS frame based on the specified action type.
-	 *
-	 * This function allocates memory for a GAS frame and initializes it based on the action type provided.
+	 * @brief Returns the size of the fixed part of a GAS frame.
 	 *
-	 * @param[in] action The type of GAS action to perform. Determines the frame structure to allocate.
-	 * @param[in] dialog_token The dialog token to be used in the GAS frame.
+	 * @param[in] action The type of GAS action.
 	 *
-	 * @returns A pair containing a pointer to the allocated frame and the size of the frame.
-	 * @retval std::pair<void *, size_t> A pair where the first element is a pointer to the allocated frame and the second element is the size of the frame.
+	 * @returns The size of the frame without its query or response, 0 for an unhandled action.
+	 */
+	static inline size_t get_gas_frame_size(dpp_gas_action_type_t action) {
+        switch(action) {
+            case dpp_gas_action_type_t::dpp_gas_initial_req:
+                return sizeof(ec_gas_initial_request_frame_t);
+            case dpp_gas_action_type_t::dpp_gas_initial_resp:
+                return sizeof(ec_gas_initial_response_frame_t);
+            case dpp_gas_action_type_t::dpp_gas_comeback_req:
+                return sizeof(ec_gas_comeback_request_frame_t);
+            case dpp_gas_action_type_t::dpp_gas_comeback_resp:
+                return sizeof(ec_gas_comeback_response_frame_t);
+            default:
+                printf("%s:%d: unhandled GAS frame type=%02x\n", __func__, __LINE__, action);
+                return 0;
+        }
+    }
+
+	/**!
+	 * @brief Initializes a zeroed GAS frame of `get_gas_frame_size(action)` bytes.
 	 *
-	 * @note If the allocation fails, the function returns a pair with a nullptr and size 0.
+	 * @param[out] frame The frame to initialize.
+	 * @param[in] action The type of GAS action to perform. Determines the frame structure.
+	 * @param[in] dialog_token The dialog token to be used in the GAS frame.
 	 */
-	static std::pair<void *, size_t> alloc_gas_frame(dpp_gas_action_type_t action, uint8_t dialog_token) {
-        void *frame = nullptr;
-        size_t created_frame_size = 0UL;
+	static inline void init_gas_frame(void *frame, dpp_gas_action_type_t action, uint8_t dialog_token) {
         switch(action) {
             case dpp_gas_action_type_t::dpp_gas_initial_req: {
-                frame = calloc(1, sizeof(ec_gas_initial_request_frame_t));
-                if (!frame) {
-                    printf("%s:%d: Failed to allocate GAS frame!\n", __func__, __LINE__);
-                    break;
-                }
                 auto *req_frame = static_cast<ec_gas_initial_request_frame_t *>(frame);
                 memcpy(req_frame->ape, DPP_GAS_CONFIG_REQ_APE, sizeof(req_frame->ape));
                 memcpy(req_frame->ape_id, DPP_GAS_CONFIG_REQ_PROTO_ID, sizeof(req_frame->ape_id));
-                created_frame_size = sizeof(ec_gas_initial_request_frame_t);
             }
             break;
 
             case dpp_gas_action_type_t::dpp_gas_initial_resp: {
-                frame = calloc(1, sizeof(ec_gas_initial_response_frame_t));
-                if (!frame) {
-                    printf("%s:%d: Failed to allocate GAS frame!\n", __func__, __LINE__);
-                    break;
-                }
                 auto *resp_frame = static_cast<ec_gas_initial_response_frame_t *>(frame);
                 memcpy(resp_frame->ape, DPP_GAS_CONFIG_REQ_APE, sizeof(resp_frame->ape));
                 memcpy(resp_frame->ape_id, DPP_GAS_CONFIG_REQ_PROTO_ID, sizeof(resp_frame->ape_id));
                 // NOTE: Hardcoded since we are not implementing the full GAS protocol
                 resp_frame->status_code = 0; // SUCCESS
-                created_frame_size = sizeof(ec_gas_initial_response_frame_t);
             }
             break;
 
-			case dpp_gas_action_type_t::dpp_gas_comeback_req: {
-				frame = calloc(1, sizeof(ec_gas_comeback_request_frame_t));
-				if (!frame) {
-					printf("%s:%d: Failed to allocate GAS Comeback Request frame!\n", __func__, __LINE__);
-					break;
-				}
-				created_frame_size = sizeof(ec_gas_comeback_request_frame_t);
-			}
-			break;
-	
 			case dpp_gas_action_type_t::dpp_gas_comeback_resp: {
-				frame = calloc(1, sizeof(ec_gas_comeback_response_frame_t));
-				if (!frame) {
-					printf("%s:%d: Failed to allocate GAS Comeback Response frame!\n", __func__, __LINE__);
-					break;
-				}
 				auto *cb_resp_frame = static_cast<ec_gas_comeback_response_frame_t *>(frame);
 				memcpy(cb_resp_frame->ape, DPP_GAS_CONFIG_REQ_APE, sizeof(cb_resp_frame->ape));
 				memcpy(cb_resp_frame->ape_id, DPP_GAS_CONFIG_REQ_PROTO_ID, sizeof(cb_resp_frame->ape_id));
@@ -308,21 +301,43 @@ public:
 				cb_resp_frame->gas_comeback_delay = 0;    // No delay for now
 				cb_resp_frame->fragment_id = 0;
 				cb_resp_frame->more_fragments = 0;
-				created_frame_size = sizeof(ec_gas_comeback_response_frame_t);
 			}
 			break;
 
             default:
-                printf("%s:%d: unhandled GAS frame type=%02x\n", __func__, __LINE__, action);
                 break;
         }
         // Shared fields
-        if (frame) {
-            ec_gas_frame_base_t *base = static_cast<ec_gas_frame_base_t *>(frame);
-            base->category = 0x04;
-            base->action = static_cast<uint8_t>(action);
-            base->dialog_token = dialog_token;
+        ec_gas_frame_base_t *base = static_cast<ec_gas_frame_base_t *>(frame);
+        base->category = 0x04;
+        base->action = static_cast<uint8_t>(action);
+        base->dialog_token = dialog_token;
+    }
+
+	/**!
+	 * @brief Allocates a GAS frame based on the specified action type.
+	 *
+	 * This function allocates memory for a GAS frame and initializes it based on the action type provided.
+	 *
+	 * @param[in] action The type of GAS action to perform. Determines the frame structure to allocate.
+	 * @param[in] dialog_token The dialog token to be used in the GAS frame.
+	 *
+	 * @returns A pair containing a pointer to the allocated frame and the size of the frame.
+	 * @retval std::pair<void *, size_t> A pair where the first element is a pointer to the allocated frame and the second element is the size of the frame.
+	 *
+	 * @note If the allocation fails, the function returns a pair with a nullptr and size 0.
+	 */
+	static std::pair<void *, size_t> alloc_gas_frame(dpp_gas_action_type_t action, uint8_t dialog_token) {
+        size_t created_frame_size = get_gas_frame_size(action);
+        if (created_frame_size == 0) {
+            return std::make_pair(nullptr, 0UL);
         }
+        void *frame = calloc(1, created_frame_size);
+        if (!frame) {
+            printf("%s:%d: Failed to allocate GAS frame!\n", __func__, __LINE__);
+            return std::make_pair(nullptr, 0UL);
+        }
+        init_gas_frame(frame, action, dialog_token);
         return std::make_pair(frame, created_frame_size);
     }
 
@@ -535,6 +550,32 @@ public:
 	 */
 	static std::pair<em_encap_dpp_t*, uint16_t> create_encap_dpp_tlv(bool dpp_frame_indicator, mac_addr_t dest_mac, ec_frame_type_t frame_type, uint8_t *encap_frame, size_t encap_frame_len);
 
+	/**
+	 * @brief Returns the length of an Encap DPP TLV value.
+	 *
+	 * @param[in] has_dest_mac True if the Destination STA MAC Address field is present.
+	 * @param[in] encap_frame_len The length of the encapsulated frame.
+	 *
+	 * @return size_t The length of the value, header fields and frame included.
+	 */
+	static inline size_t get_encap_dpp_tlv_len(bool has_dest_mac, size_t encap_frame_len) {
+		return sizeof(em_encap_dpp_t) + (has_dest_mac ? sizeof(mac_addr_t) : 0) + sizeof(uint8_t) + sizeof(uint16_t) + encap_frame_len;
+	}
+
+	/**
+	 * @brief Writes an Encap DPP TLV value into a buffer, e.g. straight into the TLV of an outgoing CMDU.
+	 *
+	 * @param[out] buff Buffer receiving the value, at least get_encap_dpp_tlv_len() bytes.
+	 * @param[in] dpp_frame_indicator The DPP frame indicator. Use 0 for DPP Public Action frame and 1 for GAS Frame.
+	 * @param[in] dest_mac The destination MAC address. Use NULL if not present.
+	 * @param[in] frame_type The type of the frame.
+	 * @param[in] encap_frame Pointer to the encapsulated frame.
+	 * @param[in] encap_frame_len The length of the encapsulated frame.
+	 *
+	 * @return size_t The number of bytes written, 0 if the frame is too large.
+	 */
+	static size_t write_encap_dpp_tlv(uint8_t *buff, bool dpp_frame_indicator, mac_addr_t dest_mac, ec_frame_type_t frame_type, uint8_t *encap_frame, size_t encap_frame_len);
+
 
     
 	/**
@@ -1111,4 +1152,223 @@ private:
     }
 };
 
-#endif // _EC_UTIL_H_
\ No newline at end of file
+/*
+ * Indexes the attributes of a buffer in a single pass, so that fetching several attributes of a frame
+ * does not walk it once per attribute. By default get() returns the first instance of an attribute,
+ * the same as ec_util::get_attrib(). The walk stops at the first attribute that runs past the end of
+ * the buffer. The buffer is not copied and must outlive the index.
+ */
+class ec_attrib_index_t {
+
+    typedef struct {
+        uint16_t id;
+        uint16_t len;
+        uint32_t off;
+    } ec_attrib_ref_t;
+
+    uint8_t *m_buff;
+    size_t m_len;
+    ec_attrib_ref_t m_refs[EC_ATTRIB_INDEX_MAX];
+    unsigned int m_num;
+    size_t m_indexed_len;       // bytes covered by m_refs, the rest is walked on lookup
+    bool m_malformed;
+
+    /**!
+     * @brief Builds the host-byte-ordered view of an attribute found at `off`.
+     */
+    ec_attribute_t make_attrib(size_t off) const;
+
+public:
+
+    /**!
+     * @brief Fetches an attribute.
+     *
+     * @param[in] id The attribute ID.
+     * @param[in] instance Which instance of the attribute to fetch, 0 for the first.
+     *
+     * @returns The attribute if found, std::nullopt otherwise.
+     */
+    std::optional<const ec_attribute_t> get(ec_attrib_id_t id, unsigned int instance = 0) const;
+
+    /**!
+     * @brief Returns the number of instances of an attribute in the buffer.
+     */
+    unsigned int count(ec_attrib_id_t id) const;
+
+    /**!
+     * @brief Checks whether an attribute length ran past the end of the buffer.
+     */
+    bool is_malformed() const { return m_malformed; }
+
+    /**!
+     * @brief Constructor for ec_attrib_index_t.
+     *
+     * @param[in] buff The attributes, in network (little endian) byte ordering.
+     * @param[in] len The length of the buffer.
+     */
+    ec_attrib_index_t(uint8_t *buff, size_t len);
+};
+
+/*
+ * Builds the attributes of a frame into a single buffer owned by the writer, behind `base_size` bytes
+ * reserved for the frame header. Callers size the writer for the whole frame up front so that the
+ * attributes, and the wrapped data encrypted in place, are written without reallocating or copying;
+ * the buffer still grows if the estimate falls short. Small writers, such as the plaintext of a
+ * wrapped data attribute, live in inline storage and do not allocate at all. Not thread safe.
+ */
+class ec_attrib_writer_t {
+
+    uint8_t *m_buff;
+    size_t m_cap;
+    size_t m_len;
+    size_t m_base_size;
+    bool m_base_aad;
+    bool m_error;
+    uint8_t m_inline[EC_ATTRIB_WRITER_INLINE_SZ];
+
+    /**!
+     * @brief Makes sure that `len` more bytes fit into the buffer, growing it if needed.
+     *
+     * @returns true on success, false if the buffer could not grow.
+     */
+    bool reserve(size_t len);
+
+public:
+
+    /**!
+     * @brief Returns the on-wire size of a wrapped data attribute holding `plain_len` bytes of plaintext.
+     */
+    static inline size_t get_wrapped_size(size_t plain_len) {
+        return ec_util::get_ec_attr_size(static_cast<uint16_t>(plain_len + AES_BLOCK_SIZE));
+    }
+
+    /**!
+     * @brief Appends an attribute whose data is written in place by the caller.
+     *
+     * @param[in] id The attribute ID.
+     * @param[in] len The length of the attribute data.
+     *
+     * @returns Pointer to the zeroed attribute data, valid until the next call on the writer, NULL on failure.
+     */
+    uint8_t *open_attrib(ec_attrib_id_t id, uint16_t len);
+
+    /**!
+     * @brief Appends an attribute.
+     *
+     * @param[in] id The attribute ID.
+     * @param[in] len The length of the attribute data.
+     * @param[in] data The attribute data, may be NULL if `len` is 0.
+     *
+     * @returns true on success, false on failure.
+     */
+    bool add_attrib(ec_attrib_id_t id, uint16_t len, const uint8_t *data);
+
+    /**!
+     * @brief Appends an attribute whose data is held in a scoped buffer.
+     */
+    inline bool add_attrib(ec_attrib_id_t id, uint16_t len, const scoped_buff& data) {
+        return add_attrib(id, len, data.get());
+    }
+
+    /**!
+     * @brief Appends a one octet attribute.
+     */
+    inline bool add_attrib(ec_attrib_id_t id, uint8_t val) {
+        return add_attrib(id, sizeof(uint8_t), &val);
+    }
+
+    /**!
+     * @brief Appends a two octet attribute, `val` is copied as is.
+     */
+    inline bool add_attrib(ec_attrib_id_t id, uint16_t val) {
+        return add_attrib(id, sizeof(uint16_t), reinterpret_cast<uint8_t *>(&val));
+    }
+
+    /**!
+     * @brief Appends an attribute holding a string, without its terminating NUL.
+     */
+    inline bool add_attrib(ec_attrib_id_t id, const std::string& str) {
+        return add_attrib(id, static_cast<uint16_t>(str.length()), reinterpret_cast<const uint8_t *>(str.c_str()));
+    }
+
+    /**!
+     * @brief Encrypts `plain` with AES-SIV straight into a new wrapped data attribute.
+     *
+     * With `use_aad`, the AAD is the frame header, if the writer was created with `base_aad`, followed by
+     * the attributes written so far, the same as ec_util::add_wrapped_data_attr().
+     *
+     * @param[in] use_aad Whether to use AAD in the encryption.
+     * @param[in] key The key to use for encryption.
+     * @param[in] plain The attributes to wrap.
+     * @param[in] plain_len The length of the attributes to wrap.
+     *
+     * @returns true on success, false on failure.
+     */
+    bool add_wrapped_data(bool use_aad, uint8_t *key, const uint8_t *plain, size_t plain_len);
+
+    /**!
+     * @brief Encrypts the attributes of another writer into a new wrapped data attribute.
+     */
+    inline bool add_wrapped_data(bool use_aad, uint8_t *key, ec_attrib_writer_t& plain) {
+        if (plain.has_error()) {
+            m_error = true;
+            return false;
+        }
+        return add_wrapped_data(use_aad, key, plain.attribs(), plain.attribs_len());
+    }
+
+    /**!
+     * @brief Returns the start of the buffer, where the caller writes the frame header.
+     */
+    uint8_t *base() { return m_buff; }
+
+    /**!
+     * @brief Returns the start of the attributes.
+     */
+    uint8_t *attribs() { return m_buff + m_base_size; }
+
+    /**!
+     * @brief Returns the length of the attributes written so far.
+     */
+    size_t attribs_len() const { return m_len - m_base_size; }
+
+    /**!
+     * @brief Returns the length of the frame, header included.
+     */
+    size_t size() const { return m_len; }
+
+    /**!
+     * @brief Hands the frame over to the caller.
+     *
+     * @param[out] len The length of the frame, header included.
+     *
+     * @returns The heap allocated frame, NULL if any step of the build failed.
+     *
+     * @warning The caller is responsible for freeing the returned frame. The writer is empty afterwards.
+     */
+    uint8_t *release(size_t *len);
+
+    /**!
+     * @brief Checks whether any step of the build failed.
+     */
+    bool has_error() const { return m_error; }
+
+    /**!
+     * @brief Constructor for ec_attrib_writer_t.
+     *
+     * @param[in] base_size Bytes reserved, and zeroed, in front of the attributes for the frame header.
+     * @param[in] capacity Expected size of the frame, header included.
+     * @param[in] base_aad Whether the frame header is part of the AAD of wrapped data (DPP public action frames).
+     */
+    ec_attrib_writer_t(size_t base_size = 0, size_t capacity = 0, bool base_aad = false);
+
+    /**!
+     * @brief Destructor for ec_attrib_writer_t.
+     */
+    ~ec_attrib_writer_t();
+
+    ec_attrib_writer_t(const ec_attrib_writer_t&) = delete;
+    ec_attrib_writer_t& operator=(const ec_attrib_writer_t&) = delete;
+};
+
+#endif // _EC_UTIL_H_
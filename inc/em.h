@@ -32,11 +32,25 @@
 #include "em_policy_cfg.h"
 #include "dm_easy_mesh.h"
 #include "em_sm.h"
+#include "em_mpsc_queue.h"
+#include "em_lat_hist.h"
+#include "em_frame_trace.h"
+#include "em_capture.h"
+#include "em_tlv_writer.h"
+#include "em_msg.h"
+#include "em_worker_pool.h"
+#include "em_crypto_pool.h"
+#include "em_timer_wheel.h"
+#include "em_stack.h"
 
 #include "util.h"
 
 #include <set>
 #include <string>
+#include <functional>
+#include <atomic>
+#include <array>
+#include <vector>
 
 enum peer_1905_security_status {
 	PEER_1905_SECURITY_NOT_STARTED = 0,
@@ -44,32 +58,89 @@ enum peer_1905_security_status {
 	PEER_1905_SECURITY_SECURED
 };
 
+class em_t;
+
+// continuation of an em waiting on a manager timer, see em_t::defer()
+typedef struct {
+    em_crypto_job_t job;        // queued with the crypto jobs once the timer expired
+    em_timer_t timer;
+    em_t *em;
+    std::function<void()> fn;
+} em_deferred_t;
+
+// capability TLV values of the radio cached by em_t, see get_cap_tlv()
+typedef enum {
+    em_cap_tlv_ap_cap,
+    em_cap_tlv_ht,
+    em_cap_tlv_vht,
+    em_cap_tlv_he,
+    em_cap_tlv_wifi6,
+    em_cap_tlv_wifi7,
+    em_cap_tlv_channel_scan,
+    em_cap_tlv_cac,
+    em_cap_tlv_max
+} em_cap_tlv_t;
+
 class em_mgr_t;
 class em_cmd_exec_t;
+struct em_orch_link_t;
 
 class em_t : 
     public em_configuration_t, public em_discovery_t, 
     public em_provisioning_t, public em_channel_t,
     public em_capability_t, public em_metrics_t,
     public em_steering_t, public em_policy_cfg_t  {
+
+public:
+    typedef void (em_t::*em_msg_handler_t)(unsigned char *data, unsigned int len);
+
+private:
+    // handler of every message type, indexed by em_msg_t::get_type_slot()
+    static const std::array<em_msg_handler_t, EM_MSG_TYPE_SLOTS> m_msg_handlers;
     
     dm_easy_mesh_t*  m_data_model;
 	em_mgr_t	*m_mgr;
 
     em_orch_state_t m_orch_state;
     em_cmd_t *m_cmd;
+    em_orch_link_t *m_orch_links;   // commands of the orchestrator this em is candidate of
+    em_lat_hist_t m_orch_step_lat;  // time from command activation to this em reaching fini
+    em_tlv_writer_t m_tlv_writer;   // reused by the messages built on this em's thread
+    em_msg_type_stats_t m_msg_stats[EM_MSG_TYPE_SLOTS];     // updated on this em's thread only
     em_sm_t  m_sm;
 	em_service_type_t   m_service_type;
     int m_fd;
     em_interface_t  m_ruid;
     em_freq_band_t  m_band;
     em_profile_type_t   m_profile_type;
-    em_queue_t  m_iq;
+    em_mpsc_queue_t  m_iq;
     pthread_t   m_tid;
+    std::atomic<em_worker_slot_t *> m_slot;     // home worker slot, NULL when the em runs its own thread
+    std::atomic<bool> m_parked;                 // own thread sleeps without timeout, see is_idle()
     bool    m_exit;
     bool m_is_al_em;
     bool dev_test_enable;
 
+    // cached transmit socket on the AL interface
+    pthread_mutex_t m_tx_lock;
+    int m_tx_fd;
+    int m_tx_ifindex;
+    mac_address_t m_tx_mac;
+    std::atomic<unsigned int> m_tx_gen;
+    unsigned int m_tx_cached_gen;
+
+    // key agreement jobs handed back by the crypto pool, resumed on this em's thread
+    pthread_mutex_t m_crypto_lock;
+    em_crypto_job_t *m_crypto_head;
+    em_crypto_job_t *m_crypto_tail;
+    std::atomic<unsigned int> m_crypto_inflight;
+    std::set<em_deferred_t *> m_deferred;   // not resumed yet, protected by m_crypto_lock
+
+    // capability TLV values, dropped when the radio generation of the data model moves
+    pthread_mutex_t m_cap_lock;
+    unsigned int m_cap_gen;
+    std::vector<unsigned char> m_cap_tlv[em_cap_tlv_max];
+
 	bool m_is_dpp_onboarding = false;
 
 	std::map<std::string, peer_1905_security_status> m_1905_layer_peer_security_statuses;
@@ -83,6 +154,50 @@ class em_t :
 	 * @note Ensure that all preconditions are met before calling this function.
 	 */
 	void proto_run();
+
+	/**!
+	 * @brief Processes up to budget queued frames.
+	 *
+	 * @param[in] budget Largest number of frames to process.
+	 *
+	 * @returns True if frames are left in the queue, false otherwise.
+	 */
+	bool proto_run_batch(unsigned int budget);
+
+	/**!
+	 * @brief Resumes the state machines whose key agreement jobs are back from the crypto pool.
+	 *
+	 * @returns Number of jobs resumed.
+	 */
+	unsigned int resume_crypto_jobs();
+
+	/**!
+	 * @brief Crypto pool callback, queues a finished job on its em and wakes the em up.
+	 *
+	 * @param[in] job Pointer to the job, its owner is the em_t.
+	 */
+	static void crypto_job_done(em_crypto_job_t *job);
+
+	/**!
+	 * @brief Queues a job to be resumed on this em's thread and wakes the em up.
+	 *
+	 * @param[in] job Pointer to the job.
+	 */
+	void queue_resume(em_crypto_job_t *job);
+
+	/**!
+	 * @brief Manager timer callback of a continuation, queues it on its em.
+	 *
+	 * @param[in] arg Pointer to the em_deferred_t.
+	 */
+	static void deferred_expired(void *arg);
+
+	/**!
+	 * @brief Runs a continuation on its em's thread and frees it.
+	 *
+	 * @param[in] job Pointer to the job of the em_deferred_t.
+	 */
+	static void deferred_resume(em_crypto_job_t *job);
     
 	/**!
 	 * @brief Exits the protocol.
@@ -101,10 +216,25 @@ class em_t :
 	 *
 	 * @param[in] data Pointer to the data to be processed.
 	 * @param[in] len Length of the data to be processed.
+	 * @param[in] ts Receive stamps of the frame, traced with the handler when not NULL.
 	 *
 	 * @note Ensure that the data pointer is valid and the length is correct.
 	 */
-	void proto_process(unsigned char *data, unsigned int len);
+	void proto_process(unsigned char *data, unsigned int len, const em_frame_ts_t *ts = NULL);
+
+	/**!
+	 * @brief Handles the messages that belong to the configuration module once the AP MLD
+	 * configuration is done and to the steering module otherwise.
+	 *
+	 * @param[in] data Pointer to the frame.
+	 * @param[in] len Length of the frame.
+	 */
+	void process_steering_msg(unsigned char *data, unsigned int len);
+
+	/**!
+	 * @brief Builds the handler table of proto_process().
+	 */
+	static constexpr std::array<em_msg_handler_t, EM_MSG_TYPE_SLOTS> build_msg_handlers();
     
 	/**!
 	 * @brief Handles the protocol timeout event.
@@ -116,6 +246,18 @@ class em_t :
 	 */
 	void proto_timeout();
 
+	/**!
+	 * @brief Returns true if the em has no periodic work, its state waits for a peer and
+	 * nothing is queued for the next ticks. An idle em is not ticked until it is woken.
+	 */
+	bool is_idle();
+
+	/**!
+	 * @brief Makes an idle em run its periodic work again, called after something changed it
+	 * from another thread.
+	 */
+	void wake();
+
     // em socket read and write
     
 	/**!
@@ -172,6 +314,56 @@ class em_t :
 	 * @note Ensure that the buffer is properly allocated and the length is correctly specified to avoid buffer overflow.
 	 */
 	int send_frame(unsigned char *buff, unsigned int len, bool multicast = false);
+
+	/**!
+	 * @brief Sends a burst of frames with a single sendmmsg() call.
+	 *
+	 * The frames are sent on the cached AL interface socket. In AL_SAP builds the frames
+	 * are handed to the SAP one after another.
+	 *
+	 * @param[in] buffs Array of pointers to the frames, each starting with the em_raw_hdr_t.
+	 * @param[in] lens Array of frame lengths.
+	 * @param[in] num Number of frames in the burst.
+	 * @param[in] multicast Boolean flag indicating whether to send the frames as multicast.
+	 *
+	 * @returns Number of frames sent, or -1 if none could be sent.
+	 */
+	int send_frames(unsigned char **buffs, unsigned int *lens, unsigned int num, bool multicast = false);
+
+	/**!
+	 * @brief Appends a frame to the running em_capture_t capture, annotated with this node.
+	 *
+	 * @param[in] dir Direction of the frame.
+	 * @param[in] buff Frame, starting with the em_raw_hdr_t.
+	 * @param[in] len Length of the frame.
+	 */
+	void capture_frame(em_capture_dir_t dir, unsigned char *buff, unsigned int len);
+
+	/**!
+	 * @brief Marks the cached transmit socket as stale.
+	 *
+	 * The socket and interface index are resolved again by the next send. Safe to call
+	 * from any thread, e.g. on netlink link change notifications.
+	 */
+	void invalidate_tx_socket() { m_tx_gen++; }
+
+	/**!
+	 * @brief Returns the cached transmit socket, opening and binding it if needed.
+	 *
+	 * @param[out] ifindex Interface index the socket is bound to.
+	 *
+	 * @returns Socket descriptor, or -1 on failure.
+	 *
+	 * @note Must be called with m_tx_lock held.
+	 */
+	int get_tx_socket(int *ifindex);
+
+	/**!
+	 * @brief Closes the cached transmit socket.
+	 *
+	 * @note Must be called with m_tx_lock held.
+	 */
+	void close_tx_socket();
     
 	/**!
 	 * @brief Sends a command to the specified service type.
@@ -213,6 +405,35 @@ class em_t :
 	 */
 	bool initialize_ec_manager();
 
+	/**!
+	 * @brief Copies a capability TLV value of the radio, encoding it only if it is not cached.
+	 *
+	 * The AP Capability Report and M1 answer from the cache until a radio or radio
+	 * capability update moves the radio generation of the data model. May be called
+	 * from the thread of another em.
+	 *
+	 * @param[in] type Capability TLV.
+	 * @param[out] buff Buffer for the TLV value.
+	 *
+	 * @returns Length of the value, 0 if the radio capabilities are not known.
+	 */
+	short get_cap_tlv(em_cap_tlv_t type, unsigned char *buff);
+
+	/**!
+	 * @brief Encodes a capability TLV value of the radio from the data model.
+	 */
+	short encode_cap_tlv(em_cap_tlv_t type, unsigned char *buff);
+
+	// the encoders of the cached capability TLVs, see get_cap_tlv()
+	short encode_ap_cap_tlv(unsigned char *buff);
+	short encode_ht_tlv(unsigned char *buff);
+	short encode_vht_tlv(unsigned char *buff);
+	short encode_he_tlv(unsigned char *buff);
+	short encode_wifi6_tlv(unsigned char *buff);
+	short encode_wifi7_tlv(unsigned char *buff);
+	short encode_channelscan_tlv(unsigned char *buff);
+	short encode_cac_cap_tlv(unsigned char *buff);
+
 public:
     
 	/**!
@@ -283,6 +504,11 @@ public:
 	 * @returns True if the interface is an AL EM, false otherwise.
 	 */
 	bool is_al_interface_em() { return m_is_al_em; }
+
+	/**!
+	 * @brief Returns the bytes of stack reserved for the em, 0 when it runs on the worker pool.
+	 */
+	size_t get_stack_size() { return (m_slot.load() == NULL) ? em_stack_t::get_size(em_stack_role_node):0; }
     
 	/**!
 	 * @brief Checks if the given SSID is a candidate.
@@ -450,6 +676,32 @@ public:
 	 */
 	em_mgr_t *get_mgr() { return m_mgr; }
 
+	/**!
+	 * @brief Hands a key agreement job to the crypto pool of the manager.
+	 *
+	 * @param[in] job Pointer to the job, run and resume must be set.
+	 *
+	 * @returns int
+	 * @retval 0 if the job was queued, its resume callback runs on this em's thread
+	 * @retval -1 if the pool is not running or full
+	 */
+	int submit_crypto_job(em_crypto_job_t *job);
+
+	/**!
+	 * @brief Runs a function on this em's thread once a delay has passed, without blocking the caller.
+	 *
+	 * The delay is kept by the manager timer wheel. A continuation still pending when the
+	 * em is deinitialized is dropped without being run.
+	 *
+	 * @param[in] delay_ms Delay in milliseconds.
+	 * @param[in] fn Function to run.
+	 *
+	 * @returns int
+	 * @retval 0 if the continuation was scheduled
+	 * @retval -1 if the em is exiting
+	 */
+	int defer(unsigned int delay_ms, std::function<void()> fn);
+
     
 	/**!
 	 * @brief Retrieves the EC Manager instance.
@@ -492,6 +744,31 @@ public:
 	 * @note Ensure that the state provided is valid and within the defined range of em_orch_state_t.
 	 */
 	void set_orch_state(em_orch_state_t state);
+
+	/**!
+	 * @brief Returns the head of the list of orchestrator commands this em is candidate of.
+	 *
+	 * @returns Pointer to the list head, maintained by em_orch_t.
+	 */
+	em_orch_link_t **get_orch_links() { return &m_orch_links; }
+
+	/**!
+	 * @brief Returns the histogram of the orchestration step times of this em, recorded by em_orch_t.
+	 */
+	em_lat_hist_t *get_orch_step_latency() { return &m_orch_step_lat; }
+
+	/**!
+	 * @brief Returns the TLV writer of this em, its buffer is kept between messages.
+	 */
+	em_tlv_writer_t *get_tlv_writer() { return &m_tlv_writer; }
+
+	/**!
+	 * @brief Returns the receive counters of a message type, types without a slot of their
+	 * own share EM_MSG_TYPE_SLOT_OTHER.
+	 *
+	 * @param[in] type Message type.
+	 */
+	em_msg_type_stats_t *get_msg_stats(em_msg_type_t type) { return &m_msg_stats[em_msg_t::get_type_slot(type)]; }
 	
 	/**!
 	 * @brief Clears the command by setting it to NULL.
@@ -519,7 +796,14 @@ public:
 	 *
 	 * @note Ensure that the state provided is valid and within the expected range of states.
 	 */
-	void set_state(em_state_t state) {  m_sm.set_state(state); }
+	void set_state(em_state_t state) {  m_sm.set_state(state); wake(); }
+
+	/**!
+	 * @brief Retrieves the state machine, for its time in state accounting.
+	 *
+	 * @returns Pointer to the state machine.
+	 */
+	em_sm_t *get_sm() { return &m_sm; }
 	
 	/**!
 	 * @brief Retrieves the service type.
@@ -1210,6 +1494,23 @@ public:
 	 * @note Additional notes about the function.
 	 */
 	static void *em_func(void *);
+
+	/**!
+	 * @brief Worker pool callback running the queued frames of an em.
+	 *
+	 * @param[in] ctx Pointer to the em_t.
+	 * @param[in] budget Largest number of frames to process.
+	 *
+	 * @returns True if frames are left in the queue of the em, false otherwise.
+	 */
+	static bool worker_run(void *ctx, unsigned int budget) { return static_cast<em_t *>(ctx)->proto_run_batch(budget); }
+
+	/**!
+	 * @brief Worker pool callback running the periodic state handling of an em, parks the em if it is idle.
+	 *
+	 * @param[in] ctx Pointer to the em_t.
+	 */
+	static void worker_tick(void *ctx);
     
 	/**!
 	 * @brief Retrieves the string representation of the frequency band type.
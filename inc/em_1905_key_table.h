@@ -0,0 +1,201 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_1905_KEY_TABLE_H
+#define EM_1905_KEY_TABLE_H
+
+#include "em_base.h"
+#include "em_hex.h"
+#include "aes_siv.h"
+
+#include <unordered_map>
+
+#define EM_1905_TK_LEN              32      // AES-SIV with a pair of 128 bit keys
+#define EM_1905_GTK_LEN             32      // HMAC-SHA256
+#define EM_1905_MIC_LEN             32
+#define EM_1905_COUNTER_LEN         6
+#define EM_1905_MAX_COUNTER         0xffffffffffffULL   // 48 bit counters, the key has to change before
+#define EM_1905_AAD_HDR_LEN         6       // message version, reserved, type and identifier of the CMDU header
+#define EM_1905_ENCR_HDR_LEN        (EM_1905_COUNTER_LEN + 2 * sizeof(mac_address_t) + sizeof(unsigned short))
+#define EM_1905_MIC_HDR_LEN         (1 + EM_1905_COUNTER_LEN + sizeof(mac_address_t) + sizeof(unsigned short))
+
+typedef struct {
+    siv_ctx             siv;            // keyed with the 1905 TK once, at install
+    bool                keyed;
+    unsigned long long  tx_counter;     // last Encryption Transmission Counter sent to the peer
+    unsigned long long  rx_counter;     // last one received from the peer
+    unsigned long long  rx_mic_counter; // last GTK Integrity Transmission Counter received from the peer
+} em_1905_peer_keys_t;
+
+typedef struct {
+    unsigned long long  encrypted;
+    unsigned long long  decrypted;
+    unsigned long long  protected_mics;
+    unsigned long long  checked_mics;
+    unsigned long long  replays;        // counters not above the last one received
+    unsigned long long  failures;       // decryptions or MICs that did not verify
+    unsigned long long  no_key;         // frames of peers without the key
+} em_1905_key_table_stats_t;
+
+/*
+ * Keys of the 1905 layer security of EasyMesh 5.3.7, by the AL MAC of the peer. A peer
+ * has its 1905 TK, keyed into an AES-SIV context when installed, and the transmission
+ * counters of both directions. The GTK protects the multicast messages with the MIC TLV,
+ * the table keeps the counter of the local messages and per peer the last counter it
+ * sent. The counters are checked and moved in place, the per frame functions do not
+ * build keys or strings. Used from the thread of the 1905 encryption layer that installs
+ * the keys, not thread safe.
+ */
+class em_1905_key_table_t {
+
+    mac_address_t m_al_mac;
+    std::unordered_map<em_packed_mac_t, em_1905_peer_keys_t> m_peers;
+    unsigned char m_gtk[EM_1905_GTK_LEN];
+    unsigned char m_gtk_id;             // 0 while no GTK is installed
+    unsigned long long m_gtk_tx_counter;
+    em_1905_key_table_stats_t m_stats;
+
+public:
+
+    /**!
+     * @brief Writes a 48 bit counter in network order.
+     */
+    static void put_counter(unsigned char *buff, unsigned long long counter);
+
+    /**!
+     * @brief Reads a 48 bit counter in network order.
+     */
+    static unsigned long long get_counter(const unsigned char *buff);
+
+    /**!
+     * @brief Sets the AL MAC of the local device, the source of the protected messages.
+     */
+    void set_al_mac(const unsigned char *al_mac) { memcpy(m_al_mac, al_mac, sizeof(mac_address_t)); }
+
+    /**!
+     * @brief Installs the 1905 TK of a peer, the counters of both directions restart.
+     *
+     * @param[in] peer AL MAC of the peer.
+     * @param[in] tk Key, EM_1905_TK_LEN bytes are used.
+     * @param[in] len Length of tk.
+     *
+     * @returns 0 on success, -1 if the key is too short or cannot be set.
+     */
+    int install_ptk(const unsigned char *peer, const unsigned char *tk, unsigned int len);
+
+    /**!
+     * @brief Installs the GTK a peer uses, and makes it the local one if it changed.
+     *
+     * @param[in] peer AL MAC of the peer.
+     * @param[in] gtk Key, EM_1905_GTK_LEN bytes are used.
+     * @param[in] len Length of gtk.
+     * @param[in] key_id GTK Key ID, 1 to 3.
+     * @param[in] rx_counter Last GTK Integrity Transmission Counter of the peer, the next one has to be above.
+     *
+     * @returns 0 on success, -1 if the key is too short or the key ID not valid.
+     */
+    int install_gtk(const unsigned char *peer, const unsigned char *gtk, unsigned int len, unsigned char key_id,
+                    unsigned long long rx_counter);
+
+    /**!
+     * @brief Drops the keys of a peer.
+     */
+    void remove(const unsigned char *peer);
+
+    /**!
+     * @brief Returns the keys and counters of a peer, NULL if it has none.
+     */
+    const em_1905_peer_keys_t *get_peer(const unsigned char *peer);
+
+    /**!
+     * @brief Builds the Encrypted Payload TLV value of a unicast message to a peer.
+     *
+     * The TLVs of the message are encrypted with AES-SIV, the CMDU header, the counter
+     * and both AL MACs are the associated data.
+     *
+     * @param[in] peer AL MAC of the destination.
+     * @param[in] cmdu CMDU header of the message.
+     * @param[in] plain TLVs to protect.
+     * @param[in] len Length of plain.
+     * @param[out] value Receives the TLV value, EM_1905_ENCR_HDR_LEN + AES_BLOCK_SIZE + len bytes.
+     * @param[in] size Size of value.
+     *
+     * @returns Length of the value, -1 if the peer has no key, its counter ran out or value is too small.
+     */
+    int encrypt(const unsigned char *peer, const unsigned char *cmdu, const unsigned char *plain, unsigned int len,
+                unsigned char *value, unsigned int size);
+
+    /**!
+     * @brief Opens the Encrypted Payload TLV value of a message to the local device.
+     *
+     * The counter of the source has to be above the last one received, it moves only
+     * once the payload verified.
+     *
+     * @param[in] cmdu CMDU header of the message.
+     * @param[in] value TLV value.
+     * @param[in] len Length of value.
+     * @param[out] plain Receives the TLVs.
+     * @param[in] size Size of plain.
+     *
+     * @returns Length of the TLVs, -1 if the payload is malformed, replayed, of a peer without key or does not verify.
+     */
+    int decrypt(const unsigned char *cmdu, const unsigned char *value, unsigned int len, unsigned char *plain,
+                unsigned int size);
+
+    /**!
+     * @brief Builds the MIC TLV value of a multicast message with the local GTK.
+     *
+     * @param[in] cmdu CMDU header of the message.
+     * @param[in] tlvs TLVs of the message, without the MIC and End of Message TLVs.
+     * @param[in] len Length of tlvs.
+     * @param[out] value Receives the TLV value, EM_1905_MIC_HDR_LEN + EM_1905_MIC_LEN bytes.
+     * @param[in] size Size of value.
+     *
+     * @returns Length of the value, -1 if no GTK is installed, its counter ran out or value is too small.
+     */
+    int add_mic(const unsigned char *cmdu, const unsigned char *tlvs, unsigned int len, unsigned char *value,
+                unsigned int size);
+
+    /**!
+     * @brief Checks the MIC TLV value of a multicast message, its GTK Key ID has to be the one installed.
+     *
+     * @returns 0 if the MIC verifies and the counter is above the last one of the source, -1 otherwise.
+     */
+    int check_mic(const unsigned char *cmdu, const unsigned char *tlvs, unsigned int len, const unsigned char *value,
+                  unsigned int value_len);
+
+    /**!
+     * @brief Returns the counters.
+     */
+    em_1905_key_table_stats_t get_stats() { return m_stats; }
+
+    /**!
+     * @brief Constructor for em_1905_key_table_t.
+     */
+    em_1905_key_table_t();
+
+    /**!
+     * @brief Destructor for em_1905_key_table_t.
+     */
+    ~em_1905_key_table_t();
+
+    em_1905_key_table_t(const em_1905_key_table_t&) = delete;
+    em_1905_key_table_t& operator=(const em_1905_key_table_t&) = delete;
+};
+
+#endif
@@ -23,9 +23,11 @@
 #include "em_mgr.h"
 #include "ieee80211.h"
 #include "dm_easy_mesh_agent.h"
+#include "dm_sta_delta.h"
 #include "em_crypto.h"
 #include "em_orch_agent.h"
 #include "em_simulator.h"
+#include "em_bus_dispatch.h"
 #include "bus.h"
 
 #include <string>
@@ -38,6 +40,21 @@
 class em_cmd_agent_t;
 class AlServiceAccessPoint;
 
+// bus callbacks, each posts its payloads to a dispatch channel of its own
+typedef enum {
+    em_agent_bus_cb_onewifi,
+    em_agent_bus_cb_sta,
+    em_agent_bus_cb_assoc_stats,
+    em_agent_bus_cb_channel_scan,
+    em_agent_bus_cb_beacon_report,
+    em_agent_bus_cb_assoc_status,
+    em_agent_bus_cb_bss_info,
+    em_agent_bus_cb_ap_metrics,
+    em_agent_bus_cb_mgmt_action,
+    em_agent_bus_cb_csa_beacon,
+    em_agent_bus_cb_max
+} em_agent_bus_cb_t;
+
 class em_agent_t : public em_mgr_t {
 
     em_orch_agent_t *m_orch;
@@ -45,6 +62,44 @@ class em_agent_t : public em_mgr_t {
     em_short_string_t   m_data_model_path;
     em_cmd_agent_t  *m_agent_cmd;
 	em_simulator_t	m_simulator;
+    dm_sta_delta_t  m_sta_delta;    // STAs already reported by the sta list commands
+    em_bus_dispatch_t   m_bus_dispatch;     // runs the bus callbacks off the bus thread
+    int m_bus_channels[em_agent_bus_cb_max];
+
+	/**!
+	 * @brief Adds a dispatch channel per bus callback and starts the dispatch thread.
+	 *
+	 * @note Called before the bus is subscribed to, a callback posts to its channel.
+	 */
+	void init_bus_dispatch();
+
+	/**!
+	 * @brief Queues the payload of a bus callback for its handler.
+	 *
+	 * @param[in] cb Callback the payload was received by.
+	 * @param[in] data Payload, copied.
+	 *
+	 * @returns True if queued, false if dropped.
+	 */
+	bool post_bus_payload(em_agent_bus_cb_t cb, raw_data_t *data);
+
+	/**!
+	 * @brief Key of a payload for coalescing, its SubDocName.
+	 */
+	static bool get_subdoc_key(const unsigned char *data, unsigned int len, char *key, unsigned int key_len);
+
+	/**!
+	 * @brief Dispatch handlers, run on the dispatch thread with the payload of a callback.
+	 *
+	 * @param[in] data Payload, nul terminated.
+	 * @param[in] len Length of the payload.
+	 * @param[in] arg Bus event type for handle_bus_payload(), unused otherwise.
+	 */
+	static void handle_bus_payload(unsigned char *data, unsigned int len, void *arg);
+	static void handle_onewifi_payload(unsigned char *data, unsigned int len, void *arg);
+	static void handle_assoc_stats_payload(unsigned char *data, unsigned int len, void *arg);
+	static void handle_channel_scan_payload(unsigned char *data, unsigned int len, void *arg);
+	static void handle_mgmt_action_payload(unsigned char *data, unsigned int len, void *arg);
 
 	
 	/**!
@@ -122,6 +177,11 @@ class em_agent_t : public em_mgr_t {
 	 */
 	void handle_500ms_tick();
 
+	/**!
+	 * @brief Runs the orchestrator right away after a state change.
+	 */
+	void handle_orch_kick();
+
     
 	/**!
 	 * @brief Handles a bus event.
@@ -193,6 +253,32 @@ class em_agent_t : public em_mgr_t {
 	 */
 	void handle_recv_wfa_action_frame(em_bus_event_t *evt);
 
+	/**!
+	 * @brief Handles a received WFA action frame.
+	 *
+	 * @param[in] buff Pointer to the frame, preceded by the wifi_frame_t of OneWifi.
+	 * @param[in] frame_len Length of the buffer.
+	 */
+	void handle_recv_wfa_action_frame(uint8_t *buff, size_t frame_len);
+
+	/**!
+	 * @brief Hands a DPP or GAS action frame to the AL node, or queues it as a bus event if there is none yet.
+	 *
+	 * @param[in] type Bus event used when the frame can not be handed to the AL node.
+	 * @param[in] data Pointer to the frame, preceded by the wifi_frame_t of OneWifi.
+	 * @param[in] len Length of the data.
+	 */
+	void push_action_frame(em_bus_event_type_t type, uint8_t *data, unsigned int len);
+
+	/**!
+	 * @brief Handles a DPP or GAS action frame queued on the AL node by push_action_frame().
+	 *
+	 * @param[in] em Pointer to the AL node.
+	 * @param[in] frame Pointer to the frame, preceded by the wifi_frame_t of OneWifi.
+	 * @param[in] len Length of the frame.
+	 */
+	void handle_node_action_frame(em_t *em, unsigned char *frame, unsigned int len) override;
+
 	/**
 	 * @brief Handles the reception of BSS info reports from OneWifi
 	 * 
@@ -266,6 +352,13 @@ class em_agent_t : public em_mgr_t {
 	 * @note Ensure that the event structure is properly initialized before calling this function.
 	 */
 	void handle_beacon_report(em_bus_event_t *evt);
+
+	/**!
+	 * @brief Submits the Beacon Metrics Response of a STA whose reports are complete or past their deadline.
+	 *
+	 * @note Nothing is submitted while a beacon report command is in progress.
+	 */
+	void submit_beacon_report();
     
 	/**!
 	 * @brief Handles the reception of a GAS frame.
@@ -279,6 +372,14 @@ class em_agent_t : public em_mgr_t {
 	 */
 	void handle_recv_gas_frame(em_bus_event_t *evt);
 
+	/**!
+	 * @brief Handles a received GAS frame.
+	 *
+	 * @param[in] frame Pointer to the 802.11 management frame.
+	 * @param[in] full_frame_length Length of the frame.
+	 */
+	void handle_recv_gas_frame(uint8_t *frame, size_t full_frame_length);
+
 	/**!
 	 * @brief Handles the AP Metrics report event.
 	 *
@@ -603,7 +704,19 @@ public:
 	 * @note Ensure that the event structure is properly initialized before calling this function.
 	 */
 	void handle_onewifi_private_subdoc(em_bus_event_t *evt);
-	
+
+	/**!
+	 * @brief Defers a OneWifi subdoc that arrived while a command of its type is in progress.
+	 *
+	 * The subdoc is handled once that command finished, a newer subdoc of the same
+	 * name arriving meanwhile replaces it.
+	 *
+	 * @param[in] evt Pointer to the subdoc event.
+	 *
+	 * @returns True if the subdoc is deferred, false if it must be rejected.
+	 */
+	bool defer_subdoc(em_bus_event_t *evt);
+
 	/**!
 	 * @brief Handles the private callback for OneWiFi events.
 	 *
@@ -0,0 +1,148 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_AP_CAP_REPORT_H
+#define EM_AP_CAP_REPORT_H
+
+#include "em_base.h"
+
+// ingest time of the reports is recorded per size, tri-band Wi-Fi 7 agents send the large ones
+#define EM_AP_CAP_REPORT_SMALL_LEN      512
+#define EM_AP_CAP_REPORT_LARGE_LEN      2048
+
+// TLVs of a radio, found by the RUID at the start of their value
+typedef enum {
+    em_ap_cap_radio_tlv_basic,
+    em_ap_cap_radio_tlv_ht,
+    em_ap_cap_radio_tlv_vht,
+    em_ap_cap_radio_tlv_he,
+    em_ap_cap_radio_tlv_wifi6,
+    em_ap_cap_radio_tlv_scan,
+    em_ap_cap_radio_tlv_advanced,   // the entry of the radio in the AP Radio Advanced Capabilities TLV
+    em_ap_cap_radio_tlv_max
+} em_ap_cap_radio_tlv_t;
+
+// TLVs of the agent, or that list several radios
+typedef enum {
+    em_ap_cap_agent_tlv_ap_cap,
+    em_ap_cap_agent_tlv_wifi7,
+    em_ap_cap_agent_tlv_eht_ops,
+    em_ap_cap_agent_tlv_cac,
+    em_ap_cap_agent_tlv_prof_2,
+    em_ap_cap_agent_tlv_inventory,
+    em_ap_cap_agent_tlv_max
+} em_ap_cap_agent_tlv_t;
+
+// value of a TLV in the frame, NULL if the report has none
+typedef struct {
+    const unsigned char *value;
+    unsigned int        len;
+} em_ap_cap_tlv_ref_t;
+
+typedef struct {
+    mac_address_t       ruid;
+    em_ap_cap_tlv_ref_t tlvs[em_ap_cap_radio_tlv_max];
+} em_ap_cap_radio_sect_t;
+
+/*
+ * An AP Capability Report parsed once, its TLVs grouped by the radio they describe.
+ * The report is walked a single time with the bounds checked, the handler then
+ * applies each radio in one go, its radio, capabilities and operating classes
+ * looked up once instead of once per TLV. Nothing is copied, the sections point
+ * into the frame, which has to outlive the report.
+ */
+class em_ap_cap_report_t {
+
+    em_ap_cap_radio_sect_t m_radios[EM_MAX_RADIO_PER_AGENT];
+    unsigned int m_num_radios;
+    em_ap_cap_tlv_ref_t m_agent[em_ap_cap_agent_tlv_max];
+    unsigned int m_num_tlvs;
+
+    /**!
+     * @brief Returns the section of a radio, added if the report did not have it yet.
+     *
+     * @returns The section, NULL if the report has EM_MAX_RADIO_PER_AGENT radios already.
+     */
+    em_ap_cap_radio_sect_t *get_sect(const unsigned char *ruid);
+
+public:
+
+    /**!
+     * @brief Parses the TLVs of a report.
+     *
+     * @param[in] tlvs The TLVs, after the CMDU header.
+     * @param[in] len Length of the TLVs.
+     *
+     * @returns Number of TLVs, -1 if a TLV runs past the end or is malformed.
+     */
+    int parse(const unsigned char *tlvs, unsigned int len);
+
+    /**!
+     * @brief Returns the number of radios of the report.
+     */
+    unsigned int get_num_radios() { return m_num_radios; }
+
+    /**!
+     * @brief Returns the section of a radio.
+     *
+     * @param[in] idx Index, below get_num_radios().
+     */
+    const em_ap_cap_radio_sect_t *get_radio(unsigned int idx) { return &m_radios[idx]; }
+
+    /**!
+     * @brief Returns a TLV of the agent, its value is NULL if the report has none.
+     */
+    const em_ap_cap_tlv_ref_t *get_agent_tlv(em_ap_cap_agent_tlv_t type) { return &m_agent[type]; }
+
+    /**!
+     * @brief Returns the number of TLVs parsed, the End of Message TLV left out.
+     */
+    unsigned int get_num_tlvs() { return m_num_tlvs; }
+
+    /**!
+     * @brief Decodes the operating classes of an AP Radio Basic Capabilities TLV.
+     *
+     * @param[in] basic The TLV.
+     * @param[out] op_classes Array receiving the operating classes, of type em_op_class_type_capability.
+     * @param[in] max Size of the array.
+     *
+     * @returns Number of operating classes stored, those past the end of the TLV are left out.
+     */
+    static unsigned int decode_op_classes(const em_ap_cap_tlv_ref_t *basic, em_op_class_info_t *op_classes, unsigned int max);
+
+    /**!
+     * @brief Copies the value of a TLV into a structure, the part the TLV is too short for is zeroed.
+     *
+     * @param[in] tlv The TLV.
+     * @param[out] dst The structure.
+     * @param[in] size Size of the structure.
+     */
+    static void copy(const em_ap_cap_tlv_ref_t *tlv, void *dst, size_t size);
+
+    /**!
+     * @brief Constructor for em_ap_cap_report_t.
+     */
+    em_ap_cap_report_t();
+
+    /**!
+     * @brief Destructor for em_ap_cap_report_t.
+     */
+    ~em_ap_cap_report_t();
+};
+
+#endif
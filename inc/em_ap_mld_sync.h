@@ -0,0 +1,92 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_AP_MLD_SYNC_H
+#define EM_AP_MLD_SYNC_H
+
+#include <vector>
+
+#define EM_AP_MLD_SYNC_MAX_PENDING  8       // requests waiting for their ACK, the oldest is dropped to make room
+
+typedef struct {
+    unsigned short              msg_id;
+    std::vector<unsigned char>  tlv;        // value of the AP MLD Configuration TLV sent
+} em_ap_mld_sync_pending_t;
+
+/*
+ * AP MLD Configuration of one agent, as sent by the controller and as acknowledged by
+ * the agent. A request is kept by its message id until the 1905 ACK with that id, which
+ * makes its configuration the acknowledged one whatever the state of the node is by then.
+ * A request that is not acknowledged is not taken as applied, it is sent again on the
+ * next reconfiguration. Not thread safe, used from the thread of the node.
+ */
+class em_ap_mld_sync_t {
+
+    std::vector<unsigned char> m_acked;                 // empty until the first ACK
+    std::vector<em_ap_mld_sync_pending_t> m_pending;    // in the order sent
+
+public:
+
+    /**!
+     * @brief Tells whether the agent acknowledged this configuration last.
+     *
+     * @param[in] tlv Value of the AP MLD Configuration TLV.
+     * @param[in] len Length of the value.
+     *
+     * @returns True if the configuration is unchanged and need not be sent.
+     */
+    bool is_acked(const unsigned char *tlv, unsigned int len) const;
+
+    /**!
+     * @brief Records a request sent to the agent, until its ACK.
+     *
+     * @param[in] msg_id Message id of the request.
+     * @param[in] tlv Value of the AP MLD Configuration TLV in the request.
+     * @param[in] len Length of the value.
+     */
+    void sent(unsigned short msg_id, const unsigned char *tlv, unsigned int len);
+
+    /**!
+     * @brief Matches a 1905 ACK to a request.
+     *
+     * The configuration of the request becomes the acknowledged one, the requests sent
+     * before it are superseded and dropped.
+     *
+     * @param[in] msg_id Message id of the ACK.
+     *
+     * @returns True if it acknowledges a request, false otherwise.
+     */
+    bool ack(unsigned short msg_id);
+
+    /**!
+     * @brief Tells whether a request with this message id waits for its ACK.
+     */
+    bool is_pending(unsigned short msg_id) const;
+
+    /**!
+     * @brief Returns the number of requests waiting for their ACK.
+     */
+    unsigned int pending() const { return static_cast<unsigned int> (m_pending.size()); }
+
+    /**!
+     * @brief Forgets the acknowledged configuration and the pending requests, the next one is sent.
+     */
+    void reset() { m_acked.clear(); m_pending.clear(); }
+};
+
+#endif
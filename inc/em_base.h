@@ -36,10 +36,31 @@ extern "C"
 #include <netinet/in.h>
 #include "ec_base.h"
 
+/*
+ * Footprint profiles, -DEM_FOOTPRINT_PROFILE_SMALL_MESH for the agents and controllers of a
+ * home mesh of a few nodes. A profile only sets the limits it shrinks and each of the
+ * guarded limits below may also be set on its own with -D. em_event_t and the data model
+ * go through sockets and the database, so the controller, the agent and the CLI of an
+ * install are built with the same profile. See build/footprint-report.sh for the sizes.
+ */
+#ifdef EM_FOOTPRINT_PROFILE_SMALL_MESH
+#define EM_MAX_NETWORKS	2
+#define EM_MAX_DEVICES 8
+#define EM_MAX_STA_PER_BSS	32
+#define EM_MAX_EVENT_DATA_LEN	4096*32
+#define EM_MAX_AP_MLD	8
+#define EM_MAX_BSTA_MLD	4
+#define EM_MAX_ASSOC_STA_MLD	32
+#endif
+
+#ifndef EM_MAX_NETWORKS
 #define EM_MAX_NETWORKS	5
+#endif
 #define EM_MAX_NET_SSIDS 5
 #define EM_MAX_INTERFACES	8 
+#ifndef EM_MAX_DEVICES
 #define EM_MAX_DEVICES 16
+#endif
 #define EM_MAX_PLATFORMS	5
 #define ETH_P_1905      0x893a
 #define MAX_INTF_NAME_SZ    16
@@ -52,6 +73,8 @@ extern "C"
 #define EM_PROTO_TOUT   1
 #define EM_METRICS_REQ_MULT 5
 #define EM_MGR_TOUT     500 // in milliseconds
+#define EM_MGR_MAX_EPOLL_EVENTS 16
+#define EM_MAX_TX_BATCH 16
 #define EM_1_TOUT_MULT 	2
 #define EM_2_TOUT_MULT 	4	
 #define EM_5_TOUT_MULT 	10	
@@ -80,14 +103,17 @@ extern "C"
 #define MAP_AP_ROLE_MAX 2
 #define MAX_MCS_NSS 6
 #define EM_MAX_CAC_METHODS 4
+#ifndef EM_MAX_STA_PER_BSS
 #define EM_MAX_STA_PER_BSS         128
+#endif
 #define EM_MAX_STA_PER_STEER_POLICY        16 
 #define EM_MAX_STA_PER_AGENT       (EM_MAX_RADIO_PER_AGENT * EM_MAX_STA_PER_BSS)
 #define EM_MAX_NEIGHBORS	16
-#define EM_MAX_CHANNEL_SCAN_RPRT_MSG_LEN		166
 #define EM_MAX_CLIENT_MARKER    5
 
+#ifndef EM_MAX_EVENT_DATA_LEN
 #define   EM_MAX_EVENT_DATA_LEN   4096*100
+#endif
 #define EM_MAX_CHANNELS_IN_LIST  64
 #define EM_MAX_CMD_GEN_TTL  10
 #define EM_MAX_CMD_EXT_TTL  30
@@ -97,6 +123,7 @@ extern "C"
 #define EM_MAX_CLIENT_STEER_REQ_TX_THRESH  5
 #define EM_MAX_CLIENT_ASSOC_CTRL_REQ_TX_THRESH  5
 #define MAX_STA_TO_DISASSOC		32
+#define EM_MAX_STEER_BATCH		16
 #define EM_MAX_DB_CFG_CRITERIA	32
 
 #define EM_CLI_MAX_ARGS 5
@@ -164,9 +191,15 @@ extern "C"
 #define EM_MAX_AKMS     10
 #define EM_MAX_HAUL_TYPES   8
 #define EM_MAX_OPCLASS  64
+#ifndef EM_MAX_AP_MLD
 #define EM_MAX_AP_MLD   64
+#endif
+#ifndef EM_MAX_BSTA_MLD
 #define EM_MAX_BSTA_MLD   64
+#endif
+#ifndef EM_MAX_ASSOC_STA_MLD
 #define EM_MAX_ASSOC_STA_MLD   64
+#endif
 #define EM_MAX_PRE_SET_CHANNELS   6
 
 #define EM_MAX_CMD  16
@@ -183,6 +216,8 @@ extern "C"
 #define EM_KEY_FILE	"/nvram//test_cert.key"
 
 #define EM_CFG_FILE "/nvram/EasymeshCfg.json"
+#define EM_DB_SNAPSHOT_FILE "/nvram/EasymeshDb.snap"
+#define EM_DB_SNAPSHOT_INTERVAL 300  // seconds between periodic snapshots of the database
 #define EM_VENDOR_OUI_SIZE 3
 
 #define EM_MAX_SSID_LEN                33 
@@ -2041,10 +2076,21 @@ typedef enum {
     em_cmd_type_ap_metrics_report,
     em_cmd_type_get_reset,
     em_cmd_type_bsta_cap,
+    em_cmd_type_get_orch_stats,
+    em_cmd_type_sta_steer_batch,
+    em_cmd_type_get_perf_stats,
+    em_cmd_type_get_mem_stats,
 
     em_cmd_type_max,
 } em_cmd_type_t;
 
+typedef enum {
+    em_cmd_prio_interactive,    // steering and disassociation, a STA is waiting on them
+    em_cmd_prio_config,
+    em_cmd_prio_background,     // metrics and scans
+    em_cmd_prio_max
+} em_cmd_prio_t;
+
 
 typedef struct {
     queue_t *queue;
@@ -2059,6 +2105,7 @@ typedef enum {
     em_event_type_node,
     em_event_type_bus,
     em_event_type_nb,
+    em_event_type_action,       // 802.11 action frame queued on an em, carried like a frame event
     em_event_type_max
 } em_event_type_t;
 
@@ -2387,6 +2434,13 @@ typedef struct {
     em_affiliated_ap_info_t  affiliated_ap[EM_MAX_AP_MLD];
 } em_ap_mld_info_t;
 
+typedef struct {
+    unsigned char  num_added;       // affiliated APs new to the AP MLD
+    unsigned char  num_changed;     // affiliated APs kept with another radio, link ID or validity
+    unsigned char  num_removed;
+    em_affiliated_ap_info_t  removed[EM_MAX_AP_MLD];
+} em_ap_mld_delta_t;
+
 typedef struct {
     bool  mac_addr_valid;
     em_interface_t  ruid;
@@ -2723,6 +2777,9 @@ typedef enum {
     em_bus_event_type_get_reset,
     em_bus_event_type_recv_csa_beacon_frame,
     em_bus_event_type_bsta_cap_req,
+    em_bus_event_type_get_orch_stats,
+    em_bus_event_type_get_perf_stats,
+    em_bus_event_type_get_mem_stats,
 
     em_bus_event_type_max
 } em_bus_event_type_t;
@@ -2935,6 +2992,25 @@ typedef struct {
     unsigned int	target_channel;
 } em_cmd_steer_params_t;
 
+typedef struct {
+    mac_address_t	sta_mac;
+    bssid_t	target;
+    unsigned int	target_op_class;
+    unsigned int	target_channel;
+} em_steer_batch_entry_t;
+
+typedef struct {
+    bssid_t	source;
+    unsigned int	request_mode;
+    bool	disassoc_imminent;
+    bool	btm_abridged;
+    bool	link_removal_imminent;
+    unsigned int	steer_opportunity_win;
+    unsigned int    btm_disassociation_timer;
+    unsigned int	num;
+    em_steer_batch_entry_t	entries[EM_MAX_STEER_BATCH];
+} em_cmd_steer_batch_params_t;
+
 typedef struct {
     bssid_t	source;
     mac_address_t	sta_mac;
@@ -2998,6 +3074,7 @@ typedef struct {
     union {
         em_cmd_args_t	args;
         em_cmd_steer_params_t	steer_params;
+        em_cmd_steer_batch_params_t	steer_batch_params;
         em_cmd_btm_report_params_t  btm_report_params;
         em_cmd_disassoc_params_t	disassoc_params;
 		em_cmd_scan_params_t	scan_params;
@@ -3084,6 +3161,7 @@ typedef enum {
     db_data_type_date,
     db_data_type_datetime,
     db_data_type_timestamp,
+    db_data_type_blob,      // raw bytes, written as a X'' hex literal and read back as they are
 } db_data_type_t;
 
 typedef unsigned int db_data_type_args_t;
@@ -0,0 +1,164 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_BEACON_REPORT_AGG_H
+#define EM_BEACON_REPORT_AGG_H
+
+#include <pthread.h>
+#include "em_base.h"
+
+#define EM_BEACON_REPORT_AGG_MAX_STAS       32      // STAs measured at once, a new one replaces the oldest
+#define EM_BEACON_REPORT_AGG_MAX_CHANNELS   16      // channels of a Beacon Metrics Query waited for
+#define EM_BEACON_REPORT_AGG_MAX_ELEMS      EM_MAX_BEACON_REPORTS_PER_SCAN
+#define EM_BEACON_REPORT_AGG_DEADLINE_MS    1000    // longest a STA waits for the rest of its reports
+#define EM_BEACON_REPORT_AGG_ELEM_LEN       257     // element ID, length and the longest body
+
+typedef struct {
+    unsigned char   len;            // of the whole element
+    unsigned char   channel;
+    unsigned char   rcpi;
+    bssid_t         bssid;
+    unsigned char   data[EM_BEACON_REPORT_AGG_ELEM_LEN];
+} em_beacon_report_agg_elem_t;
+
+typedef struct {
+    bool            used;
+    mac_address_t   sta;
+    bssid_t         bssid;          // of the BSS the STA is associated with
+    unsigned long long start_ms;    // of the query, else of the first report
+    unsigned int    num_expected;   // 0 if the channels are not known, the deadline alone ends the wait
+    unsigned char   expected[EM_BEACON_REPORT_AGG_MAX_CHANNELS];
+    unsigned int    num_elems;
+    em_beacon_report_agg_elem_t elems[EM_BEACON_REPORT_AGG_MAX_ELEMS];
+} em_beacon_report_agg_sta_t;
+
+/*
+ * Beacon Reports of a STA merged into the one Beacon Metrics Response sent for it
+ */
+typedef struct {
+    mac_address_t   sta;
+    bssid_t         bssid;
+    unsigned int    count;          // Measurement Report elements
+    unsigned int    len;
+    unsigned char   elems[EM_MAX_BEACON_MEASUREMENT_LEN];
+} em_beacon_report_agg_report_t;
+
+typedef struct {
+    unsigned long long  reports;        // Beacon Report events merged
+    unsigned long long  elems;          // Measurement Report elements received
+    unsigned long long  duplicates;     // elements replacing one of the same BSS and channel
+    unsigned long long  responses;      // responses built
+    unsigned long long  complete;       // of which had every queried channel
+    unsigned long long  compacted;      // of which had their optional subelements stripped to fit
+    unsigned long long  evicted;        // STAs replaced while pending
+} em_beacon_report_agg_stats_t;
+
+/*
+ * Beacon Reports of the STAs being measured by the agent. OneWifi raises a Beacon
+ * Report event as the STA reports, often one per channel, and each used to become a
+ * Beacon Metrics Response of its own. The reports are merged per STA instead, an
+ * element per BSS and channel, until the STA reported on every channel of its Beacon
+ * Metrics Query or EM_BEACON_REPORT_AGG_DEADLINE_MS passed, and then handed out as one
+ * response, strongest BSS first. Elements that do not fit the response lose their
+ * optional subelements, then the weakest are left out. Thread safe.
+ */
+class em_beacon_report_agg_t {
+
+    pthread_mutex_t m_lock;
+    em_beacon_report_agg_sta_t m_stas[EM_BEACON_REPORT_AGG_MAX_STAS];
+    em_beacon_report_agg_stats_t m_stats;
+
+    /**!
+     * @brief Returns the entry of a STA, a new one if it has none, the lock held.
+     */
+    em_beacon_report_agg_sta_t *get_sta(const unsigned char *sta, unsigned long long now);
+
+    /**!
+     * @brief Returns true if the STA reported on every queried channel, the lock held.
+     */
+    static bool is_complete(const em_beacon_report_agg_sta_t *s);
+
+    /**!
+     * @brief Builds the response of a STA and frees its entry, the lock held.
+     */
+    void build(em_beacon_report_agg_sta_t *s, em_beacon_report_agg_report_t *report);
+
+public:
+
+    /**!
+     * @brief Starts the wait for the reports of a STA on the channels of a Beacon Metrics Query.
+     *
+     * @param[in] sta MAC address of the STA.
+     * @param[in] channels Channels queried, those past EM_BEACON_REPORT_AGG_MAX_CHANNELS are not waited for.
+     * @param[in] num Number of channels, 0 if not known.
+     * @param[in] now Current time in milliseconds.
+     */
+    void expect(const unsigned char *sta, const unsigned char *channels, unsigned int num, unsigned long long now);
+
+    /**!
+     * @brief Merges the Measurement Report elements of a Beacon Report event.
+     *
+     * @param[in] sta MAC address of the STA.
+     * @param[in] bssid BSSID the STA is associated with.
+     * @param[in] elems The Measurement Report elements.
+     * @param[in] len Length of the elements.
+     * @param[in] count Number of elements announced by the event.
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns Number of elements merged.
+     */
+    unsigned int add(const unsigned char *sta, const unsigned char *bssid, const unsigned char *elems, unsigned int len,
+            unsigned int count, unsigned long long now);
+
+    /**!
+     * @brief Hands out the response of a STA that is complete or past its deadline.
+     *
+     * A STA past its deadline without any report is dropped, there is nothing to respond.
+     *
+     * @param[in] now Current time in milliseconds.
+     * @param[out] report The response.
+     *
+     * @returns True if a response was handed out, false if none is ready.
+     */
+    bool pop_ready(unsigned long long now, em_beacon_report_agg_report_t *report);
+
+    /**!
+     * @brief Returns the number of STAs waited for.
+     */
+    unsigned int get_pending();
+
+    /**!
+     * @brief Returns the counters.
+     */
+    void get_stats(em_beacon_report_agg_stats_t *stats);
+
+    /**!
+     * @brief Constructor for em_beacon_report_agg_t.
+     */
+    em_beacon_report_agg_t();
+
+    /**!
+     * @brief Destructor for em_beacon_report_agg_t.
+     */
+    ~em_beacon_report_agg_t();
+
+    em_beacon_report_agg_t(const em_beacon_report_agg_t&) = delete;
+    em_beacon_report_agg_t& operator=(const em_beacon_report_agg_t&) = delete;
+};
+
+#endif
@@ -0,0 +1,155 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_BEACON_REPORT_CACHE_H
+#define EM_BEACON_REPORT_CACHE_H
+
+#include <pthread.h>
+#include "em_base.h"
+
+#include <unordered_map>
+
+#define EM_BEACON_REPORT_MAX_PER_STA    16      // BSSs remembered per STA, the oldest is replaced
+#define EM_BEACON_REPORT_FRESH_MS       30000   // a STA reported within this time is not queried again
+#define EM_BEACON_REPORT_MAX_AGE_MS     120000  // reports older than this are aged out
+
+/*
+ * A BSS as seen by a STA in a Beacon Report
+ */
+typedef struct {
+    bssid_t             bssid;
+    unsigned char       op_class;
+    unsigned char       channel;
+    unsigned char       rcpi;
+    unsigned char       rsni;
+    unsigned long long  time_ms;        // CLOCK_MONOTONIC milliseconds
+} em_beacon_report_entry_t;
+
+typedef struct {
+    unsigned long long  last_ms;        // time of the last Beacon Metrics Response of the STA
+    unsigned int        num;
+    em_beacon_report_entry_t entries[EM_BEACON_REPORT_MAX_PER_STA];
+} em_beacon_report_sta_t;
+
+/*
+ * Beacon Reports of the STAs, an entry per (STA, BSSID, channel). Beacon Metrics
+ * Responses update the entries in place, so steering picks a target from the cache
+ * and the scheduler skips STAs whose reports are fresh instead of asking them to
+ * measure again. Entries older than EM_BEACON_REPORT_MAX_AGE_MS are aged out.
+ * Thread safe.
+ */
+class em_beacon_report_cache_t {
+
+    pthread_rwlock_t m_lock;
+    // keyed by the STA MAC packed in an integer
+    std::unordered_map<unsigned long long, em_beacon_report_sta_t> m_stas;
+
+    /**!
+     * @brief Returns the key of a STA.
+     */
+    static unsigned long long sta_key(const unsigned char *sta);
+
+public:
+
+    /**!
+     * @brief Adds or refreshes the entry of a BSS seen by a STA.
+     *
+     * @param[in] sta MAC address of the STA.
+     * @param[in] entry The entry, matched on its BSSID and channel.
+     */
+    void update(const unsigned char *sta, const em_beacon_report_entry_t *entry);
+
+    /**!
+     * @brief Adds the Measurement Report elements of a Beacon Metrics Response.
+     *
+     * @param[in] sta MAC address of the STA.
+     * @param[in] elems The Measurement Report elements.
+     * @param[in] len Length of the elements.
+     * @param[in] count Number of elements announced by the response.
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns Number of entries added or refreshed.
+     */
+    unsigned int add_reports(const unsigned char *sta, const unsigned char *elems, unsigned int len, unsigned int count, unsigned long long now);
+
+    /**!
+     * @brief Returns true if the STA sent a Beacon Metrics Response in the last EM_BEACON_REPORT_FRESH_MS.
+     *
+     * @param[in] sta MAC address of the STA.
+     * @param[in] now Current time in milliseconds.
+     */
+    bool is_fresh(const unsigned char *sta, unsigned long long now);
+
+    /**!
+     * @brief Copies the entries of a STA.
+     *
+     * @param[in] sta MAC address of the STA.
+     * @param[out] entries Array receiving the entries.
+     * @param[in] max Size of the array.
+     *
+     * @returns Number of entries stored.
+     */
+    unsigned int get_reports(const unsigned char *sta, em_beacon_report_entry_t *entries, unsigned int max);
+
+    /**!
+     * @brief Returns the entry with the highest RCPI of a STA, for the target of a steering.
+     *
+     * @param[in] sta MAC address of the STA.
+     * @param[in] exclude BSSID left out, the one the STA is associated with, may be NULL.
+     * @param[out] entry The entry.
+     *
+     * @returns True if the STA has an entry other than exclude, false otherwise.
+     */
+    bool get_best(const unsigned char *sta, const unsigned char *exclude, em_beacon_report_entry_t *entry);
+
+    /**!
+     * @brief Removes the entries older than EM_BEACON_REPORT_MAX_AGE_MS, and the STAs left without entries.
+     *
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns Number of entries removed.
+     */
+    unsigned int age_out(unsigned long long now);
+
+    /**!
+     * @brief Removes the entries of a STA.
+     *
+     * @returns True if the STA had entries, false otherwise.
+     */
+    bool remove(const unsigned char *sta);
+
+    /**!
+     * @brief Returns the number of STAs with entries.
+     */
+    unsigned int count();
+
+    /**!
+     * @brief Constructor for em_beacon_report_cache_t.
+     */
+    em_beacon_report_cache_t();
+
+    /**!
+     * @brief Destructor for em_beacon_report_cache_t.
+     */
+    ~em_beacon_report_cache_t();
+
+    em_beacon_report_cache_t(const em_beacon_report_cache_t&) = delete;
+    em_beacon_report_cache_t& operator=(const em_beacon_report_cache_t&) = delete;
+};
+
+#endif
@@ -0,0 +1,238 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_BH_STEER_H
+#define EM_BH_STEER_H
+
+#include <pthread.h>
+#include "em_base.h"
+#include "em_beacon_report_cache.h"
+
+#include <unordered_map>
+
+#define EM_BH_STEER_MAX_NODES       64      // agents of a pass
+#define EM_BH_STEER_MAX_BSS         256     // backhaul BSSs of a pass
+#define EM_BH_STEER_MAX_DECISIONS   8       // decisions returned by a pass
+
+typedef enum {
+    em_bh_steer_action_steer,           // send a Backhaul Steering Request to the agent
+    em_bh_steer_action_measure,         // no fresh measurement of the backhaul STA, query the other agents first
+} em_bh_steer_action_t;
+
+typedef struct {
+    bool            enabled;
+    unsigned char   rcpi_thresh;        // a backhaul STA whose RCPI is below looks for a better parent
+    unsigned char   min_rcpi;           // a parent has to see the backhaul STA at least this strong
+    unsigned char   rcpi_hysteresis;    // a parent as far from the controller has to be this much better
+    unsigned int    fresh_ms;           // measurements older than this are not used
+    unsigned int    timeout_ms;         // a steer without a response after this time failed
+    unsigned int    backoff_ms;         // an agent steered, successfully or not, is left alone this long
+} em_bh_steer_params_t;
+
+/*
+ * An agent as seen by the controller, a node of the backhaul tree
+ */
+typedef struct {
+    mac_address_t   al_mac;
+    mac_address_t   bsta;               // MAC of its backhaul STA, zero for a wired agent
+    bssid_t         bssid;              // BSS its backhaul STA is associated with
+    unsigned char   rcpi;               // of the backhaul STA, as measured by its parent, 0 if unknown
+} em_bh_steer_node_t;
+
+/*
+ * A backhaul BSS, a parent a backhaul STA may associate with
+ */
+typedef struct {
+    mac_address_t   al_mac;             // agent operating the BSS
+    bssid_t         bssid;
+    unsigned char   op_class;
+    unsigned char   channel;
+} em_bh_steer_bss_t;
+
+typedef struct {
+    em_bh_steer_action_t action;
+    mac_address_t   al_mac;
+    mac_address_t   bsta;
+    bssid_t         source;
+    bssid_t         target;             // steer only
+    unsigned char   op_class;           // of the target
+    unsigned char   channel;
+    unsigned char   rcpi;
+    unsigned char   target_rcpi;
+    unsigned int    hops;               // of the agent to the controller, before and after the steer
+    unsigned int    target_hops;
+} em_bh_steer_decision_t;
+
+/*
+ * Steering completion of an agent, from the request to the response
+ */
+typedef struct {
+    unsigned int        steers;
+    unsigned int        completed;
+    unsigned int        failed;             // rejected by the agent
+    unsigned int        timeouts;
+    unsigned long long  last_latency_ms;
+    unsigned long long  max_latency_ms;
+    unsigned long long  total_latency_ms;   // over the completed steers
+} em_bh_steer_agent_stats_t;
+
+typedef struct {
+    unsigned long long  passes;
+    unsigned long long  steers;
+    unsigned long long  measures;
+    unsigned long long  completed;
+    unsigned long long  failed;
+    unsigned long long  timeouts;
+    unsigned long long  max_latency_ms;
+} em_bh_steer_stats_t;
+
+typedef struct {
+    bool                pending;
+    unsigned long long  start_ms;           // of the pending steer
+    unsigned long long  backoff_until;
+    em_bh_steer_agent_stats_t stats;
+} em_bh_steer_agent_t;
+
+/*
+ * Controller driven backhaul steering. A pass walks the backhaul tree made of the
+ * agents and the backhaul BSSs they operate: an agent whose backhaul STA is weak, or
+ * that another parent closer to the controller sees well enough, is steered to the
+ * best parent measured by the other agents, one that is not in its own subtree. The
+ * time from the Backhaul Steering Request to its response is kept per agent. While a
+ * steer is pending the agent is not steered again, and it is left alone for a backoff
+ * after it. Thread safe, the responses are handled by the threads of the ems.
+ */
+class em_bh_steer_t {
+
+    pthread_mutex_t m_lock;
+    em_bh_steer_params_t m_params;
+    em_bh_steer_stats_t m_stats;
+    // keyed by the AL MAC packed in an integer
+    std::unordered_map<unsigned long long, em_bh_steer_agent_t> m_agents;
+
+    /**!
+     * @brief Returns the key of an agent.
+     */
+    static unsigned long long al_key(const unsigned char *al_mac);
+
+    /**!
+     * @brief Returns the number of wireless backhaul hops of an agent to the controller.
+     *
+     * @param[in] nodes The agents.
+     * @param[in] parent Index of the parent of each agent, num if the parent is not an agent.
+     * @param[in] num Number of agents.
+     * @param[in] node Index of the agent.
+     */
+    static unsigned int hops(const em_bh_steer_node_t *nodes, const unsigned int *parent, unsigned int num, unsigned int node);
+
+    /**!
+     * @brief Returns true if an agent is in the backhaul subtree of another, or is that agent.
+     */
+    static bool in_subtree(const unsigned int *parent, unsigned int num, unsigned int node, unsigned int root);
+
+public:
+
+    /**!
+     * @brief Runs a pass over the agents.
+     *
+     * @param[in] now Current time in milliseconds.
+     * @param[in] nodes The agents.
+     * @param[in] num_nodes Number of agents, at most EM_BH_STEER_MAX_NODES are evaluated.
+     * @param[in] bss The backhaul BSSs of the agents.
+     * @param[in] num_bss Number of BSSs.
+     * @param[in] meas Measurements of the backhaul STAs by the other agents, keyed by backhaul STA.
+     * @param[out] decisions Array receiving the decisions.
+     * @param[in] max Size of the array.
+     *
+     * @returns Number of decisions stored.
+     */
+    unsigned int evaluate(unsigned long long now, const em_bh_steer_node_t *nodes, unsigned int num_nodes,
+                          const em_bh_steer_bss_t *bss, unsigned int num_bss, em_beacon_report_cache_t *meas,
+                          em_bh_steer_decision_t *decisions, unsigned int max);
+
+    /**!
+     * @brief Starts the steer of an agent once its Backhaul Steering Request was queued.
+     *
+     * @param[in] al_mac AL MAC of the agent.
+     * @param[in] now Current time in milliseconds.
+     */
+    void started(const unsigned char *al_mac, unsigned long long now);
+
+    /**!
+     * @brief Ends the steer of an agent on its Backhaul Steering Response.
+     *
+     * @param[in] al_mac AL MAC of the agent.
+     * @param[in] success True if the agent moved to the target.
+     * @param[in] now Current time in milliseconds.
+     * @param[out] latency_ms Receives the time since the request, may be NULL.
+     *
+     * @returns True if a steer of the agent was pending, false otherwise.
+     */
+    bool completed(const unsigned char *al_mac, bool success, unsigned long long now, unsigned long long *latency_ms);
+
+    /**!
+     * @brief Ends the steers pending for longer than timeout_ms.
+     *
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns Number of steers timed out.
+     */
+    unsigned int expire(unsigned long long now);
+
+    /**!
+     * @brief Returns true if a steer of the agent is pending.
+     */
+    bool is_pending(const unsigned char *al_mac);
+
+    /**!
+     * @brief Copies the steering statistics of an agent.
+     *
+     * @returns True if the agent was ever steered, false otherwise.
+     */
+    bool get_agent_stats(const unsigned char *al_mac, em_bh_steer_agent_stats_t *stats);
+
+    /**!
+     * @brief Sets the parameters of the passes.
+     */
+    void set_params(const em_bh_steer_params_t *params);
+
+    /**!
+     * @brief Returns the parameters of the passes.
+     */
+    em_bh_steer_params_t get_params();
+
+    /**!
+     * @brief Returns the statistics of the passes and steers.
+     */
+    em_bh_steer_stats_t get_stats();
+
+    /**!
+     * @brief Constructor for em_bh_steer_t, with the default parameters.
+     */
+    em_bh_steer_t();
+
+    /**!
+     * @brief Destructor for em_bh_steer_t.
+     */
+    ~em_bh_steer_t();
+
+    em_bh_steer_t(const em_bh_steer_t&) = delete;
+    em_bh_steer_t& operator=(const em_bh_steer_t&) = delete;
+};
+
+#endif
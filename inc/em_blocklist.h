@@ -0,0 +1,164 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_BLOCKLIST_H
+#define EM_BLOCKLIST_H
+
+#include <pthread.h>
+#include "em_base.h"
+#include "em_timer_wheel.h"
+
+#include <unordered_map>
+#include <vector>
+
+#define EM_BLOCKLIST_MAX                1024    // blocked (STA, BSSID) pairs
+#define EM_BLOCKLIST_BLOOM_SLOTS        4096    // counters of the bloom filter, a power of two
+#define EM_BLOCKLIST_BLOOM_HASHES       3
+
+typedef struct {
+    unsigned long long  sta;            // MAC addresses packed in integers
+    unsigned long long  bssid;
+} em_blocklist_key_t;
+
+struct em_blocklist_key_hash_t {
+    size_t operator()(const em_blocklist_key_t& key) const { return std::hash<unsigned long long>()(key.sta ^ (key.bssid << 16)); }
+};
+
+struct em_blocklist_key_eq_t {
+    bool operator()(const em_blocklist_key_t& a, const em_blocklist_key_t& b) const { return (a.sta == b.sta) && (a.bssid == b.bssid); }
+};
+
+class em_blocklist_t;
+
+typedef struct {
+    em_blocklist_key_t  key;
+    unsigned long long  expires_ms;     // 0 for an indefinite block
+    em_timer_t          timer;          // armed for timed blocks only
+    em_blocklist_t      *owner;
+} em_blocklist_entry_t;
+
+typedef struct {
+    unsigned int        entries;
+    unsigned long long  blocks;
+    unsigned long long  unblocks;
+    unsigned long long  expired;
+    unsigned long long  lookups;
+    unsigned long long  bloom_rejects;  // lookups answered by the bloom filter alone
+    unsigned long long  hits;           // lookups of a blocked pair
+} em_blocklist_stats_t;
+
+/*
+ * STAs blocked from BSSs by Client Association Control Requests. The pairs live in a
+ * hash set fronted by a counting bloom filter, so the association path answers the
+ * common case, a STA that is not blocked, without touching the set. Timed blocks are
+ * armed on a private timer wheel that expire() turns, so expiry only visits the
+ * entries that are due. Thread safe.
+ */
+class em_blocklist_t {
+
+    pthread_mutex_t m_lock;
+    std::unordered_map<em_blocklist_key_t, em_blocklist_entry_t, em_blocklist_key_hash_t, em_blocklist_key_eq_t> m_entries;
+    unsigned char m_bloom[EM_BLOCKLIST_BLOOM_SLOTS];
+    em_timer_wheel_t m_timers;
+    // entries whose timer fired during the current expire(), removed once the wheel is done with them
+    std::vector<em_blocklist_key_t> m_expired;
+    em_blocklist_stats_t m_stats;
+
+    /**!
+     * @brief Returns the key of a (STA, BSSID) pair.
+     */
+    static em_blocklist_key_t make_key(const unsigned char *sta, const unsigned char *bssid);
+
+    /**!
+     * @brief Returns the bloom filter counters of a key.
+     */
+    static void bloom_slots(const em_blocklist_key_t& key, unsigned int slots[EM_BLOCKLIST_BLOOM_HASHES]);
+
+    /**!
+     * @brief Adds a key to the bloom filter, or removes it. Called with m_lock held.
+     */
+    void bloom_update(const em_blocklist_key_t& key, bool add);
+
+    /**!
+     * @brief Timer callback of a timed block.
+     */
+    static void expire_cb(void *arg);
+
+public:
+
+    /**!
+     * @brief Blocks a STA from a BSS, or refreshes its block.
+     *
+     * @param[in] sta MAC address of the STA.
+     * @param[in] bssid BSSID of the BSS.
+     * @param[in] ttl_ms Validity of the block in milliseconds, 0 for an indefinite block.
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns 0 on success, -1 if the list is full.
+     */
+    int block(const unsigned char *sta, const unsigned char *bssid, unsigned int ttl_ms, unsigned long long now);
+
+    /**!
+     * @brief Unblocks a STA from a BSS.
+     *
+     * @returns True if the STA was blocked, false otherwise.
+     */
+    bool unblock(const unsigned char *sta, const unsigned char *bssid);
+
+    /**!
+     * @brief Returns true if a STA is blocked from a BSS.
+     *
+     * @param[in] sta MAC address of the STA.
+     * @param[in] bssid BSSID of the BSS.
+     */
+    bool is_blocked(const unsigned char *sta, const unsigned char *bssid);
+
+    /**!
+     * @brief Removes the timed blocks that are due.
+     *
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns Number of blocks removed.
+     */
+    unsigned int expire(unsigned long long now);
+
+    /**!
+     * @brief Returns the number of blocked pairs.
+     */
+    unsigned int count();
+
+    /**!
+     * @brief Copies the counters.
+     */
+    void get_stats(em_blocklist_stats_t *stats);
+
+    /**!
+     * @brief Constructor for em_blocklist_t.
+     */
+    em_blocklist_t();
+
+    /**!
+     * @brief Destructor for em_blocklist_t.
+     */
+    ~em_blocklist_t();
+
+    em_blocklist_t(const em_blocklist_t&) = delete;
+    em_blocklist_t& operator=(const em_blocklist_t&) = delete;
+};
+
+#endif
@@ -0,0 +1,217 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_BUS_DISPATCH_H
+#define EM_BUS_DISPATCH_H
+
+#include <stdint.h>
+#include <pthread.h>
+#include <atomic>
+#include <deque>
+#include <cjson/cJSON.h>
+
+#define EM_BUS_DISPATCH_MAX_CHANNELS    16
+#define EM_BUS_DISPATCH_NAME_LEN        32
+#define EM_BUS_DISPATCH_KEY_LEN         64
+
+typedef enum {
+    em_bus_dispatch_policy_drop_oldest,     // a full queue drops its oldest payload, for reports the next one supersedes
+    em_bus_dispatch_policy_drop_newest,     // a full queue refuses the payload, for events handled in order
+    em_bus_dispatch_policy_coalesce,        // a payload replaces the queued one of the same key, a full queue then drops the oldest
+} em_bus_dispatch_policy_t;
+
+/*
+ * Payload of a bus callback, copied once from the bus and shared by reference until its
+ * last holder releases it. Nul terminated past its length for the JSON parsers.
+ */
+class em_bus_buf_t {
+
+    std::atomic<unsigned int> m_ref;
+    unsigned int m_len;
+
+    em_bus_buf_t() : m_ref(1), m_len(0) { }
+
+public:
+
+    /**!
+     * @brief Copies a payload into a new buffer, held once by the caller.
+     *
+     * @returns The buffer, NULL if out of memory.
+     */
+    static em_bus_buf_t *create(const void *data, unsigned int len);
+
+    /**!
+     * @brief Takes a reference.
+     */
+    void hold() { m_ref.fetch_add(1, std::memory_order_relaxed); }
+
+    /**!
+     * @brief Drops a reference, the last one frees the buffer.
+     */
+    void release();
+
+    unsigned char *get_data() { return reinterpret_cast<unsigned char *>(this + 1); }
+    unsigned int get_len() const { return m_len; }
+};
+
+typedef void (*em_bus_dispatch_handler_t)(unsigned char *data, unsigned int len, void *arg);
+
+// returns false if the payload has no key, it is then queued without coalescing
+typedef bool (*em_bus_dispatch_key_func_t)(const unsigned char *data, unsigned int len, char *key, unsigned int key_len);
+
+typedef struct {
+    unsigned long long  posted;
+    unsigned long long  dispatched;
+    unsigned long long  dropped;        // by a full queue, oldest or newest per the policy
+    unsigned long long  coalesced;      // replaced by a later payload of the same key
+    unsigned long long  bytes;          // queued now
+    unsigned int        depth;
+    unsigned int        max_depth;
+    unsigned long long  max_wait_us;    // longest a payload waited for its handler
+} em_bus_dispatch_stats_t;
+
+typedef struct {
+    em_bus_buf_t    *buf;
+    uint64_t        seq;
+    uint64_t        posted_us;
+    bool            has_key;
+    char            key[EM_BUS_DISPATCH_KEY_LEN];
+} em_bus_dispatch_entry_t;
+
+typedef struct {
+    char                        name[EM_BUS_DISPATCH_NAME_LEN];
+    em_bus_dispatch_policy_t    policy;
+    unsigned int                max_depth;
+    em_bus_dispatch_handler_t   handler;
+    em_bus_dispatch_key_func_t  key_func;
+    void                        *arg;
+    std::deque<em_bus_dispatch_entry_t> queue;
+    em_bus_dispatch_stats_t     stats;
+} em_bus_dispatch_channel_t;
+
+/*
+ * Hands the payloads of bus callbacks to a thread of their own, so that the callbacks
+ * return to the bus library as soon as the payload is copied. Each callback posts to a
+ * channel with a bounded queue and a policy for when the handlers fall behind. The
+ * thread runs the handlers in the order the payloads were posted across all channels,
+ * a coalesced payload takes the place of the one it replaces at the tail. Until start()
+ * succeeds a post runs the handler on the calling thread.
+ */
+class em_bus_dispatch_t {
+
+    pthread_mutex_t m_lock;
+    pthread_cond_t m_cond;
+    pthread_t m_thread;
+    bool m_running;
+    bool m_stop;
+    uint64_t m_seq;
+    unsigned int m_num_channels;
+    em_bus_dispatch_channel_t m_channels[EM_BUS_DISPATCH_MAX_CHANNELS];
+
+    static void *run(void *arg);
+
+    /**!
+     * @brief Pops the payload posted first across the channels, the lock held.
+     *
+     * @returns Channel of the payload, -1 if every queue is empty.
+     */
+    int pop(em_bus_dispatch_entry_t *entry);
+
+public:
+
+    /**!
+     * @brief Adds a channel, before start().
+     *
+     * @param[in] name Name reported in the counters.
+     * @param[in] policy What a full queue does.
+     * @param[in] max_depth Payloads queued at most, at least 1.
+     * @param[in] handler Handler run on the dispatch thread.
+     * @param[in] key_func Key of a payload for the coalesce policy, NULL to coalesce them all.
+     * @param[in] arg Argument of the handler.
+     *
+     * @returns Channel to post to, -1 if there are too many.
+     */
+    int add_channel(const char *name, em_bus_dispatch_policy_t policy, unsigned int max_depth,
+            em_bus_dispatch_handler_t handler, em_bus_dispatch_key_func_t key_func, void *arg);
+
+    /**!
+     * @brief Starts the dispatch thread.
+     *
+     * @returns 0 on success, -1 if the thread could not be created, posts then stay synchronous.
+     */
+    int start();
+
+    /**!
+     * @brief Stops the dispatch thread, the payloads still queued are dropped.
+     */
+    void stop();
+
+    /**!
+     * @brief Queues a payload for the handler of a channel.
+     *
+     * @param[in] channel Channel returned by add_channel().
+     * @param[in] buf Payload, a reference is taken while it is queued.
+     *
+     * @returns True if queued or handled, false if it was dropped.
+     */
+    bool post(int channel, em_bus_buf_t *buf);
+
+    /**!
+     * @brief Copies a payload and queues it for the handler of a channel.
+     *
+     * @returns True if queued or handled, false if it was dropped.
+     */
+    bool post(int channel, const void *data, unsigned int len);
+
+    /**!
+     * @brief Returns the counters of a channel.
+     */
+    void get_stats(int channel, em_bus_dispatch_stats_t *stats);
+
+    /**!
+     * @brief Returns the total of the dropped and coalesced payloads of all channels.
+     */
+    unsigned long long get_lost();
+
+    /**!
+     * @brief Adds the counters of every channel to a JSON object.
+     *
+     * @param[in] obj JSON object the "Channels" array is added to.
+     */
+    void encode(cJSON *obj);
+
+    /**!
+     * @brief Prints the counters of every channel.
+     */
+    void print_stats();
+
+    /**!
+     * @brief Constructor for em_bus_dispatch_t, without channels.
+     */
+    em_bus_dispatch_t();
+
+    /**!
+     * @brief Destructor for em_bus_dispatch_t, stops the thread.
+     */
+    ~em_bus_dispatch_t();
+
+    em_bus_dispatch_t(const em_bus_dispatch_t&) = delete;
+    em_bus_dispatch_t& operator=(const em_bus_dispatch_t&) = delete;
+};
+
+#endif
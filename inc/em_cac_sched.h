@@ -0,0 +1,211 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_CAC_SCHED_H
+#define EM_CAC_SCHED_H
+
+#include <pthread.h>
+#include "em_base.h"
+#include "em_hex.h"
+
+#include <unordered_map>
+
+#define EM_CAC_SCHED_CAC_MS             90000   // CAC of a DFS channel, 60 s and the time to report it
+#define EM_CAC_SCHED_WEATHER_CAC_MS     660000  // CAC overlapping the weather radar channels 120 to 128, 10 min
+#define EM_CAC_SCHED_NON_OCC_MS         1800000 // non-occupancy period after a radar detection
+#define EM_CAC_SCHED_MAX_ACTIVE         4       // radios in CAC in the whole mesh
+#define EM_CAC_SCHED_MAX_PER_GROUP      1       // radios in CAC among the agents of a backhaul branch
+#define EM_CAC_SCHED_MAX_WAIT_MS        300000  // a radio waiting longer is refused the uncleared channels
+#define EM_CAC_SCHED_STALE_MS           10000   // a waiting radio that has not asked again by then left the queue
+
+typedef enum {
+    em_cac_state_unknown,           // no CAC known, a CAC is needed before operating on the channel
+    em_cac_state_available,         // CAC completed, operation may start right away
+    em_cac_state_non_occupied,      // radar detected, not usable until its non-occupancy period ends
+    em_cac_state_active,            // CAC running
+} em_cac_state_t;
+
+typedef enum {
+    em_cac_admit_started,           // the radio may go off channel for its CAC
+    em_cac_admit_wait,              // the mesh or the branch of the agent has its CACs running, ask again
+    em_cac_admit_refused,           // waited EM_CAC_SCHED_MAX_WAIT_MS, the uncleared channels are not offered
+} em_cac_admit_t;
+
+typedef struct {
+    em_cac_state_t      state;
+    unsigned long long  time_ms;    // available: CAC completion, non occupied and active: their end
+} em_cac_sched_channel_t;
+
+typedef struct {
+    em_packed_mac_t     group;      // AL MAC of the agent heading its backhaul branch, see set_group()
+    std::unordered_map<unsigned int, em_cac_sched_channel_t> channels;     // keyed by channel_key()
+} em_cac_sched_agent_t;
+
+typedef struct {
+    em_packed_mac_t     agent;
+    unsigned long long  queued_ms;  // first admit() that had to wait, 0 if not waiting
+    unsigned long long  asked_ms;   // last admit() while waiting
+    unsigned long long  end_ms;     // end of the CAC admitted, 0 if not in CAC
+} em_cac_sched_radio_t;
+
+typedef struct {
+    unsigned int        started;
+    unsigned int        waited;     // admit() calls that had to wait
+    unsigned int        refused;
+    unsigned int        completed;  // CAC Completion Reports of admitted radios
+    unsigned int        radar;      // channels put in non-occupancy by a radar detection
+    unsigned int        timed_out;  // admitted radios without CAC Completion Report by their end
+    unsigned int        status_reports;
+} em_cac_sched_stats_t;
+
+/*
+ * Controller scheduling of the DFS Channel Availability Checks of the agents. The state of
+ * every DFS channel of an agent comes from its CAC Status Reports, and its CAC Completion
+ * Reports clear a channel or start its non-occupancy period. A radio asks admit() before it
+ * is offered DFS channels it has not cleared, which would take it off channel for the CAC.
+ * At most EM_CAC_SCHED_MAX_PER_GROUP radios of a backhaul branch and EM_CAC_SCHED_MAX_ACTIVE
+ * radios of the mesh run a CAC at once, the others wait in the order they asked, so that
+ * after a restart the neighboring agents do not all leave the air together. The channels
+ * an agent already cleared need no admission and are preferred. Thread safe.
+ */
+class em_cac_sched_t {
+
+    pthread_mutex_t m_lock;
+    std::unordered_map<em_packed_mac_t, em_cac_sched_agent_t> m_agents;     // keyed by AL MAC
+    std::unordered_map<em_packed_mac_t, em_cac_sched_radio_t> m_radios;     // keyed by radio unique identifier
+    em_cac_sched_stats_t m_stats;
+
+    /**!
+     * @brief Returns the key of an operating class and channel.
+     */
+    static unsigned int channel_key(unsigned char op_class, unsigned char channel) { return (static_cast<unsigned int> (op_class) << 8) | channel; }
+
+    /**!
+     * @brief Returns the agent entry, added with itself as its group if it is not known.
+     */
+    em_cac_sched_agent_t *get_agent(em_packed_mac_t agent);
+
+    /**!
+     * @brief Ends the CACs past their end and drops the waiting radios that stopped asking.
+     */
+    void expire(unsigned long long now);
+
+    /**!
+     * @brief Ends the CAC of a radio, true if it was admitted.
+     */
+    bool release(em_packed_mac_t ruid);
+
+    /**!
+     * @brief Returns the lowest and highest 20 MHz channels covered by a channel of an operating class.
+     */
+    static void get_span(unsigned char op_class, unsigned char channel, unsigned char *low, unsigned char *high);
+
+public:
+
+    /**!
+     * @brief Returns true if a channel of an operating class needs a CAC, any of its 20 MHz channels is a 5 GHz DFS one.
+     *
+     * The channel of the 80 and 160 MHz operating classes is their center channel.
+     */
+    static bool is_dfs(unsigned char op_class, unsigned char channel);
+
+    /**!
+     * @brief Returns how long the CAC of a channel is expected to take, in milliseconds.
+     */
+    static unsigned int get_cac_ms(unsigned char op_class, unsigned char channel);
+
+    /**!
+     * @brief Sets the group of an agent, the agents of a group run one CAC at a time.
+     *
+     * @param[in] agent AL MAC of the agent.
+     * @param[in] group AL MAC of the agent heading its backhaul branch, the next hop of its route.
+     */
+    void set_group(const unsigned char *agent, const unsigned char *group);
+
+    /**!
+     * @brief Takes a CAC Status Report TLV, it replaces the channel states of the agent.
+     *
+     * @param[in] agent AL MAC of the agent.
+     * @param[in] value Value of the TLV.
+     * @param[in] len Length of the value.
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns Number of channels taken, -1 if the TLV is malformed.
+     */
+    int handle_status_report(const unsigned char *agent, const unsigned char *value, unsigned int len, unsigned long long now);
+
+    /**!
+     * @brief Takes a CAC Completion Report TLV, it ends the CAC of each radio in it.
+     *
+     * A successful CAC makes its channel available, a radar detection starts the
+     * non-occupancy period of the channels detected.
+     *
+     * @param[in] agent AL MAC of the agent.
+     * @param[in] value Value of the TLV.
+     * @param[in] len Length of the value.
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns Number of radios taken, -1 if the TLV is malformed.
+     */
+    int handle_completion_report(const unsigned char *agent, const unsigned char *value, unsigned int len, unsigned long long now);
+
+    /**!
+     * @brief Returns the state of a channel for an agent.
+     *
+     * A channel that is not DFS is always available.
+     */
+    em_cac_state_t get_state(const unsigned char *agent, unsigned char op_class, unsigned char channel, unsigned long long now);
+
+    /**!
+     * @brief Asks for a CAC of a radio, before it is offered DFS channels its agent has not cleared.
+     *
+     * A radio admitted stays in CAC until a CAC Completion Report of the radio or cac_ms.
+     * A radio waiting must ask again at least every EM_CAC_SCHED_STALE_MS to keep its place.
+     *
+     * @param[in] agent AL MAC of the agent.
+     * @param[in] ruid Radio unique identifier.
+     * @param[in] cac_ms Longest CAC of the channels offered, see get_cac_ms().
+     * @param[in] now Current time in milliseconds.
+     */
+    em_cac_admit_t admit(const unsigned char *agent, const unsigned char *ruid, unsigned int cac_ms, unsigned long long now);
+
+    /**!
+     * @brief Returns the number of radios in CAC.
+     */
+    unsigned int get_active(unsigned long long now);
+
+    /**!
+     * @brief Returns the counters.
+     */
+    em_cac_sched_stats_t get_stats();
+
+    /**!
+     * @brief Constructor for em_cac_sched_t.
+     */
+    em_cac_sched_t();
+
+    /**!
+     * @brief Destructor for em_cac_sched_t.
+     */
+    ~em_cac_sched_t();
+
+    em_cac_sched_t(const em_cac_sched_t&) = delete;
+    em_cac_sched_t& operator=(const em_cac_sched_t&) = delete;
+};
+
+#endif
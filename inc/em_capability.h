@@ -22,6 +22,7 @@
 #include "em_base.h"
 #include "dm_easy_mesh.h"
 #include "em.h"
+#include "em_ap_cap_report.h"
 
 class em_cmd_t;
 class em_mgr_t;
@@ -694,6 +695,23 @@ class em_capability_t {
 	 * @note Ensure that the data buffer is valid and the length is correctly specified.
 	 */
 	int handle_ap_cap_report(unsigned char *data, unsigned int len);
+
+	/**!
+	 * @brief Applies the TLVs of a radio of an AP Capability Report.
+	 *
+	 * The radio and its operating classes are updated first, then its capabilities,
+	 * looked up once for all of them.
+	 *
+	 * @param[in] sect The TLVs of the radio.
+	 */
+	void apply_ap_cap_radio(const em_ap_cap_radio_sect_t *sect);
+
+	/**!
+	 * @brief Applies the TLVs of an AP Capability Report that are not those of a single radio.
+	 *
+	 * @param[in] report The parsed report.
+	 */
+	void apply_ap_cap_agent(em_ap_cap_report_t *report);
     
 	/**!
 	 * @brief Handles the client capability report.
@@ -711,6 +729,29 @@ class em_capability_t {
 	 */
 	int handle_client_cap_report(unsigned char *data, unsigned int len);
 
+	/**!
+	 * @brief Adds the STA of a client capability report to the associated STAs of the data model.
+	 *
+	 * @param[in] sta_info The STA, its BSSID and its frame body.
+	 */
+	void put_client_cap(em_sta_info_t *sta_info);
+
+	/**!
+	 * @brief Returns the band of the radio, em_freq_band_unknown if the radio is not in the data model.
+	 */
+	em_freq_band_t get_radio_band();
+
+	/**!
+	 * @brief Decides whether the STA of the current command is sent a client capability query.
+	 *
+	 * The radios that do not carry the BSS of the STA, and the STAs whose capabilities
+	 * are cached, are confirmed without a query. A STA with a query in flight is left
+	 * pending until its report comes.
+	 *
+	 * @returns True if the query is sent by this radio, false otherwise.
+	 */
+	bool client_cap_query_needed();
+
 	/**!
 	 * @brief Handles the backhaul sta capability query.
 	 *
@@ -0,0 +1,143 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_CAPTURE_H
+#define EM_CAPTURE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <atomic>
+#include <vector>
+
+#define EM_CAPTURE_NODE_LEN             128
+#define EM_CAPTURE_MAX_BLOCK            (1 << 20)   // larger blocks are taken as a corrupt file
+
+// pcapng block types and options, see draft-ietf-opsawg-pcapng
+#define EM_PCAPNG_BLOCK_SHB             0x0a0d0d0a
+#define EM_PCAPNG_BLOCK_IDB             0x00000001
+#define EM_PCAPNG_BLOCK_EPB             0x00000006
+#define EM_PCAPNG_BYTE_ORDER_MAGIC      0x1a2b3c4d
+#define EM_PCAPNG_LINKTYPE_ETHERNET     1
+#define EM_PCAPNG_OPT_END               0
+#define EM_PCAPNG_OPT_COMMENT           1
+#define EM_PCAPNG_OPT_IF_NAME           2
+#define EM_PCAPNG_OPT_EPB_FLAGS         2
+#define EM_PCAPNG_OPT_IF_TSRESOL        9
+
+typedef enum {
+    em_capture_dir_unknown,
+    em_capture_dir_rx,
+    em_capture_dir_tx,
+} em_capture_dir_t;
+
+typedef struct {
+    uint64_t            ts_us;          // wall clock of the capture
+    em_capture_dir_t    dir;
+    unsigned int        len;
+    unsigned int        orig_len;
+    const unsigned char *data;          // valid until the next read
+    char                node[EM_CAPTURE_NODE_LEN];  // em_t annotation, empty if the frame has none
+} em_capture_frame_t;
+
+/*
+ * Writes the frames received by the listener and sent by the ems to a pcapng file, one
+ * Ethernet interface and one enhanced packet block per frame. The direction goes in the
+ * flags of the block and the node that received or sent the frame in its comment. Every
+ * frame is flushed, so that a capture of a process that is killed stays readable. The
+ * capture is off unless started, which costs one relaxed load per frame.
+ */
+class em_capture_t {
+
+    static std::atomic<FILE *> s_fp;
+    static pthread_mutex_t s_lock;
+    static uint64_t s_frames;
+
+    static int write_shb_idb(FILE *fp, const char *ifname);
+
+public:
+
+    /**!
+     * @brief Starts to capture into a file, replacing its content.
+     *
+     * @param[in] path File name.
+     * @param[in] ifname Name of the capturing interface recorded in the file, or NULL.
+     *
+     * @returns 0 on success, -1 if the file cannot be written or a capture runs already.
+     */
+    static int start(const char *path, const char *ifname = NULL);
+
+    /**!
+     * @brief Stops the capture and closes the file.
+     *
+     * @returns Number of frames written.
+     */
+    static uint64_t stop();
+
+    static bool is_active() { return s_fp.load(std::memory_order_relaxed) != NULL; }
+
+    /**!
+     * @brief Appends a frame to the capture, if one runs.
+     *
+     * @param[in] dir Direction of the frame.
+     * @param[in] node Annotation of the em_t that received or sent it, or NULL.
+     * @param[in] buff Ethernet frame.
+     * @param[in] len Length of the frame.
+     */
+    static void write(em_capture_dir_t dir, const char *node, const unsigned char *buff, unsigned int len);
+};
+
+/*
+ * Reads the Ethernet frames of a pcapng file, written by em_capture_t or by another tool.
+ * Blocks other than the section header, interface description and enhanced packet blocks
+ * are skipped. Only files in the byte order of the host are read.
+ */
+class em_capture_reader_t {
+
+    FILE *m_fp;
+    std::vector<unsigned char> m_block;
+    std::vector<uint64_t> m_if_units;   // timestamp units per second of each interface
+
+    int parse_idb(unsigned int len);
+    int parse_epb(unsigned int len, em_capture_frame_t *frame);
+
+public:
+
+    /**!
+     * @brief Opens a capture.
+     *
+     * @returns 0 on success, -1 if the file cannot be read or does not start with a section header.
+     */
+    int open(const char *path);
+
+    /**!
+     * @brief Reads the next frame.
+     *
+     * @param[out] frame Frame, its data is valid until the next call.
+     *
+     * @returns 1 with a frame, 0 at the end of the file, -1 on a corrupt file.
+     */
+    int next(em_capture_frame_t *frame);
+
+    void close();
+
+    em_capture_reader_t();
+    ~em_capture_reader_t();
+};
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_CHAN_PLAN_OPTIMISER_H
+#define EM_CHAN_PLAN_OPTIMISER_H
+
+#include "em_optimiser.h"
+#include "em_chan_planner.h"
+#include "em_hex.h"
+
+#include <unordered_map>
+
+typedef struct {
+    unsigned char   from;               // operating channel when proposed
+    unsigned char   channel;
+} em_chan_plan_proposal_t;
+
+/*
+ * The mesh wide channel planner of the network optimiser as an optimisation plugin. The
+ * radio, BSS and scan events go straight into the planner, which marks the radios they
+ * touch dirty, and each cycle plans from the dirty radios within the budget. Once a plan
+ * completes, every radio whose planned channel is better than its operating one gives a
+ * channel action scored by the cost it saves. A change is proposed once, again only if
+ * the plan moves the radio elsewhere or the radio reports another operating channel.
+ */
+class em_chan_plan_optimiser_t : public em_optimiser_t {
+
+    em_chan_planner_t m_planner;
+    std::unordered_map<em_packed_mac_t, em_chan_plan_proposal_t> m_proposed;   // radio to the change last proposed for it
+
+public:
+
+    const char *get_name() { return "chan_planner"; }
+
+    void radio_changed(const em_optimiser_radio_t *radio);
+
+    void bss_added(const unsigned char *bssid, const unsigned char *ruid) { m_planner.add_bss(bssid, ruid); }
+
+    void scan_result(const em_scan_result_t *res) { m_planner.add_scan_result(res); }
+
+    unsigned int optimise(unsigned long long now, unsigned long long budget_us, em_optimiser_action_t *actions,
+                          unsigned int max);
+
+    /**!
+     * @brief Returns the planner, for its parameters and counters.
+     */
+    em_chan_planner_t *get_planner() { return &m_planner; }
+
+    /**!
+     * @brief Constructor for em_chan_plan_optimiser_t.
+     */
+    em_chan_plan_optimiser_t();
+
+    /**!
+     * @brief Destructor for em_chan_plan_optimiser_t.
+     */
+    ~em_chan_plan_optimiser_t();
+
+    em_chan_plan_optimiser_t(const em_chan_plan_optimiser_t&) = delete;
+    em_chan_plan_optimiser_t& operator=(const em_chan_plan_optimiser_t&) = delete;
+};
+
+#endif
@@ -0,0 +1,272 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_CHAN_PLANNER_H
+#define EM_CHAN_PLANNER_H
+
+#include "em_base.h"
+
+#include <vector>
+#include <unordered_map>
+
+#define EM_CHAN_PLANNER_MAX_CHANNELS    32      // operable channels of a radio
+#define EM_CHAN_PLANNER_MAX_PREF        15      // best preference of the Channel Preference TLV
+
+typedef enum {
+    em_chan_planner_band_2g,
+    em_chan_planner_band_5g,
+    em_chan_planner_band_6g,
+} em_chan_planner_band_t;
+
+typedef struct {
+    unsigned char   channel;
+    unsigned char   pref;           // 1 to EM_CHAN_PLANNER_MAX_PREF, higher is better
+    unsigned int    ext_cost;       // BSSs outside the mesh heard on the channel by the radio
+} em_chan_planner_channel_t;
+
+typedef struct {
+    unsigned int    peer;           // node index
+    unsigned int    weight;         // how loud the two radios hear each other
+} em_chan_planner_edge_t;
+
+typedef struct {
+    mac_address_t               ruid;
+    unsigned char               op_class;
+    em_chan_planner_band_t      band;
+    unsigned int                num_channels;
+    em_chan_planner_channel_t   channels[EM_CHAN_PLANNER_MAX_CHANNELS];
+    unsigned char               current;    // operating channel reported by the radio
+    unsigned char               channel;    // planned channel, 0 until planned
+    bool                        dirty;      // its channels or edges changed since the last plan
+    std::vector<em_chan_planner_edge_t> edges;
+} em_chan_planner_node_t;
+
+typedef struct {
+    mac_address_t       ruid;
+    unsigned char       op_class;
+    unsigned char       current;
+    unsigned char       channel;        // planned
+    unsigned long long  gain;           // cost of the radio on its operating channel less the one on the planned channel
+} em_chan_planner_change_t;
+
+typedef struct {
+    unsigned int    pref_weight;    // cost of each preference step below the best
+    unsigned int    switch_cost;    // cost of moving a radio off its operating channel
+    unsigned int    max_moves;      // channel changes per node and plan, bounds the local search
+} em_chan_planner_params_t;
+
+typedef struct {
+    unsigned long long  plans;
+    unsigned long long  moves;          // channel changes made by the local search
+    unsigned int        last_evaluated; // nodes evaluated by the last plan
+    unsigned long long  last_plan_us;
+    unsigned long long  max_plan_us;
+    unsigned long long  last_cost;      // total cost of the last plan
+    unsigned long long  truncated;      // plans stopped by their time budget, the next one goes on
+} em_chan_planner_stats_t;
+
+/*
+ * Mesh wide channel planning from the channel scans of all agents. Each radio is a
+ * node with its operable channels and their preferences, taken from its Channel
+ * Preference Report. A Channel Scan Result of a radio that hears a BSS of another mesh
+ * radio adds an edge weighted by the signal strength, every other BSS it hears adds to
+ * the cost of that channel for the radio. The cost of a channel for a radio is its
+ * preference penalty, the foreign BSSs on it, the edges to the radios on an overlapping
+ * channel and a penalty for moving off the operating channel.
+ *
+ * The first plan colors the radios greedily, the most interfered one first, then a
+ * local search moves any radio to its cheapest channel until none improves. A move only
+ * changes the cost of the radio and its peers and the costs are symmetric, so the total
+ * cost drops with every move. New scan data only marks the radios it touches dirty, and
+ * the next plan starts the local search from them instead of planning from scratch. A
+ * plan given a time budget stops once it is spent, the radios it did not get to stay
+ * unplanned or dirty for the next plan. Not thread safe.
+ */
+class em_chan_planner_t {
+
+    em_chan_planner_params_t m_params;
+    em_chan_planner_stats_t m_stats;
+    std::vector<em_chan_planner_node_t> m_nodes;
+    // keyed by the MAC packed in an integer
+    std::unordered_map<unsigned long long, unsigned int> m_radios;
+    std::unordered_map<unsigned long long, unsigned int> m_bss;     // BSSID to the node of its radio
+
+    /**!
+     * @brief Returns the node of a radio, NULL if it is not known.
+     */
+    em_chan_planner_node_t *find_node(const unsigned char *ruid);
+
+    /**!
+     * @brief Adds or raises the edge between two nodes, on both of them.
+     */
+    void set_edge(unsigned int a, unsigned int b, unsigned int weight);
+
+    /**!
+     * @brief Returns the cost of a channel for a node, given the channels of its peers.
+     */
+    unsigned long long channel_cost(unsigned int node, const em_chan_planner_channel_t *ch);
+
+    /**!
+     * @brief Returns the cheapest channel of a node, NULL if it has none.
+     */
+    const em_chan_planner_channel_t *best_channel(unsigned int node, unsigned long long *cost);
+
+    /**!
+     * @brief Returns the operable channel entry of a node, NULL if it is not operable.
+     */
+    static const em_chan_planner_channel_t *get_channel_entry(const em_chan_planner_node_t *node, unsigned char channel);
+
+    /**!
+     * @brief Returns the CLOCK_MONOTONIC time in microseconds, for the plan time.
+     */
+    static unsigned long long now_us();
+
+public:
+
+    /**!
+     * @brief Returns the band of a global operating class.
+     */
+    static em_chan_planner_band_t get_band(unsigned char op_class);
+
+    /**!
+     * @brief Returns how much two channels of a band overlap, in percent.
+     *
+     * 2.4 GHz channels 5 apart or more do not overlap, the others only on the same channel.
+     */
+    static unsigned int get_overlap(em_chan_planner_band_t band, unsigned char a, unsigned char b);
+
+    /**!
+     * @brief Returns the edge or foreign BSS weight of a signal strength in dBm.
+     */
+    static unsigned int get_signal_weight(signed char signal_strength);
+
+    /**!
+     * @brief Adds a radio or replaces its operable channels.
+     *
+     * @param[in] ruid Radio unique identifier.
+     * @param[in] op_class Operating class of the channels.
+     * @param[in] channels Operable channels.
+     * @param[in] prefs Preference of each channel, 0 for a non operable one.
+     * @param[in] num Number of channels.
+     * @param[in] current Operating channel of the radio.
+     *
+     * @returns 0 on success, -1 if there are too many channels.
+     */
+    int set_radio(const unsigned char *ruid, unsigned char op_class, const unsigned char *channels,
+                  const unsigned char *prefs, unsigned int num, unsigned char current);
+
+    /**!
+     * @brief Moves the operating channel of a radio, its operable channels are kept.
+     *
+     * @returns 0 on success, -1 if the radio is not known.
+     */
+    int set_current(const unsigned char *ruid, unsigned char current);
+
+    /**!
+     * @brief Maps a BSSID to its radio, for the scan results that hear it.
+     *
+     * @returns 0 on success, -1 if the radio is not known.
+     */
+    int add_bss(const unsigned char *bssid, const unsigned char *ruid);
+
+    /**!
+     * @brief Takes the neighbors of a Channel Scan Result of a radio.
+     *
+     * The foreign BSSs of the result replace the cost of its channel for the radio, the
+     * mesh BSSs raise the edges to their radios.
+     *
+     * @param[in] res Scan result of one radio, operating class and channel.
+     *
+     * @returns Number of edges raised, -1 if the scanner radio is not known.
+     */
+    int add_scan_result(const em_scan_result_t *res);
+
+    /**!
+     * @brief Plans the channels.
+     *
+     * @param[in] full true to plan all radios from scratch, false to start from the dirty ones.
+     * @param[in] budget_us Time the plan may take, 0 for no limit. A plan evaluates 16 radios at least.
+     *
+     * @returns Number of radios whose planned channel changed.
+     */
+    unsigned int plan(bool full, unsigned long long budget_us = 0);
+
+    /**!
+     * @brief Returns the planned channel of a radio, 0 if it is not planned.
+     */
+    unsigned char get_channel(const unsigned char *ruid);
+
+    /**!
+     * @brief Returns the radios whose planned channel is not their operating channel.
+     *
+     * @param[out] changes Array receiving the changes.
+     * @param[in] max Size of the array.
+     *
+     * @returns Number of changes stored.
+     */
+    unsigned int get_changes(em_chan_planner_change_t *changes, unsigned int max);
+
+    /**!
+     * @brief Returns the total cost of the planned channels, each edge counted once.
+     */
+    unsigned long long get_cost();
+
+    /**!
+     * @brief Returns the number of radios.
+     */
+    unsigned int count() { return static_cast<unsigned int>(m_nodes.size()); }
+
+    /**!
+     * @brief Runs the planner on a synthetic topology and prints the cost and time of the plans.
+     *
+     * The radios are spread on a square, all in 2.4 GHz on channel 6, and hear each other
+     * by the distance between them. The full plan is followed by incremental plans, each
+     * after a new scan of one radio.
+     *
+     * @param[in] num_nodes Number of radios.
+     * @param[in] seed Seed of the topology.
+     */
+    static void benchmark(unsigned int num_nodes, unsigned int seed);
+
+    /**!
+     * @brief Sets the parameters.
+     */
+    void set_params(const em_chan_planner_params_t *params) { m_params = *params; }
+
+    /**!
+     * @brief Returns the parameters.
+     */
+    const em_chan_planner_params_t& get_params() { return m_params; }
+
+    /**!
+     * @brief Returns the counters.
+     */
+    const em_chan_planner_stats_t& get_stats() { return m_stats; }
+
+    /**!
+     * @brief Constructor for em_chan_planner_t, with the default parameters.
+     */
+    em_chan_planner_t();
+
+    /**!
+     * @brief Destructor for em_chan_planner_t.
+     */
+    ~em_chan_planner_t();
+};
+
+#endif
@@ -20,10 +20,18 @@
 #define EM_CHANNEL_H
 
 #include "em_base.h"
+#include "em_tlv_writer.h"
+#include "em_scan_diff.h"
+
+#define EM_CHANNEL_SCAN_RPRT_MAX_FRAGS  16  // frames of one Channel Scan Report, the results left go in the next one
 
 class em_cmd_t;
+class dm_scan_result_t;
 class em_channel_t {
 
+    em_scan_diff_t m_scan_diff;     // results last reported, only the changed ones go in the next report
+    bool m_cac_admitted;            // the CAC scheduler let the radio be offered DFS channels its agent has not cleared
+
     
 	/**!
 	 * @brief Sends a frame of data.
@@ -41,6 +49,25 @@ class em_channel_t {
 	 * @note This is a pure virtual function and must be implemented by derived classes.
 	 */
 	virtual int send_frame(unsigned char *buff, unsigned int len, bool multicast = false) = 0;
+
+	/**!
+	 * @brief Sends a burst of frames, e.g. the fragments of one CMDU.
+	 *
+	 * @param[in] buffs Array of pointers to the frames.
+	 * @param[in] lens Array of frame lengths.
+	 * @param[in] num Number of frames.
+	 * @param[in] multicast Flag indicating whether the frames should be sent as multicast.
+	 *
+	 * @returns Number of frames sent, or -1 if none could be sent.
+	 */
+	virtual int send_frames(unsigned char **buffs, unsigned int *lens, unsigned int num, bool multicast = false) = 0;
+
+	/**!
+	 * @brief Returns the TLV writer used to build outgoing messages.
+	 *
+	 * @note This is a pure virtual function and must be implemented by derived classes.
+	 */
+	virtual em_tlv_writer_t *get_tlv_writer() = 0;
 	
 	/**!
 	 * @brief Pushes an event to the event manager.
@@ -157,21 +184,16 @@ public:
 	short create_channel_scan_req_tlv(unsigned char *buff);
     
 	/**!
-	 * @brief Creates a channel scan result TLV.
-	 *
-	 * This function is responsible for creating a channel scan result TLV (Type-Length-Value) structure
-	 * and storing it in the provided buffer at the specified index.
+	 * @brief Creates a Channel Scan Result TLV.
 	 *
-	 * @param[out] buff Pointer to the buffer where the TLV will be stored.
-	 * @param[in] index The index in the buffer where the TLV should be placed.
+	 * @param[out] buff Pointer to the buffer where the TLV value will be stored.
+	 * @param[in] scan_res The scan result to encode.
 	 *
-	 * @returns short
-	 * @retval 0 on success.
-	 * @retval -1 on failure.
+	 * @returns short Length of the TLV value.
 	 *
 	 * @note Ensure that the buffer has sufficient space to store the TLV.
 	 */
-	short create_channel_scan_res_tlv(unsigned char *buff, unsigned int index);
+	short create_channel_scan_res_tlv(unsigned char *buff, dm_scan_result_t *scan_res);
     
 	/**!
 	 * @brief Creates a channel preference TLV.
@@ -187,6 +209,50 @@ public:
 	 * @note Ensure that the buffer is allocated with sufficient size before calling this function.
 	 */
 	short create_channel_pref_tlv(unsigned char *buff);
+
+	/**!
+	 * @brief Returns the preference and reason code octet of a channel in the Channel Selection Request.
+	 *
+	 * DFS channels the agent cleared are preferred over the ones that need a CAC, these are
+	 * only operable if admitted by the CAC scheduler, channels in their non-occupancy period never.
+	 * Channels the radio capabilities list as non operable are never.
+	 *
+	 * @param[in] op_class Operating class of the channel.
+	 * @param[in] channel The channel.
+	 * @param[in] now Current time in milliseconds.
+	 */
+	unsigned char get_channel_pref_bits(unsigned char op_class, unsigned char channel, unsigned long long now);
+
+	/**!
+	 * @brief Asks the CAC scheduler whether the radio may be offered DFS channels its agent has not cleared.
+	 *
+	 * @returns False if the Channel Selection Request has to wait for the CACs of the neighboring agents.
+	 */
+	bool admit_cac();
+
+	/**!
+	 * @brief Asks the spectrum cache whether the 6 GHz spectrum of the agent has to be inquired first.
+	 *
+	 * Sends the Available Spectrum Inquiry if the radio has 6 GHz operating classes and the
+	 * availability of its location is missing or about to expire.
+	 *
+	 * @returns False if the Channel Selection Request has to wait for the inquiry.
+	 */
+	bool query_spectrum();
+
+	/**!
+	 * @brief Sets the location of the agent from the AFC request of an Available Spectrum Inquiry Request TLV.
+	 *
+	 * @returns 0 on success, -1 if the request has no location.
+	 */
+	int set_spectrum_location(unsigned char *buff, unsigned int len);
+
+	/**!
+	 * @brief Puts the AFC response of an Available Spectrum Inquiry Response TLV in the spectrum cache.
+	 *
+	 * @returns Number of operating classes taken, -1 if the response is not a successful one.
+	 */
+	int put_spectrum_response(unsigned char *buff, unsigned int len, unsigned long long now);
     
 	/**!
 	 * @brief Creates an operating channel report TLV.
@@ -330,19 +396,20 @@ public:
 	int send_channel_scan_request_msg();
     
 	/**!
-	 * @brief Sends a channel scan report message.
+	 * @brief Sends a Channel Scan Report with the scan results from a cursor on.
 	 *
-	 * This function is responsible for sending a report message after scanning channels.
+	 * The results are encoded back to back in one pass, the TLV writer starts a new
+	 * frame whenever one is full and all the frames go out in one burst. A report holds
+	 * at most EM_CHANNEL_SCAN_RPRT_MAX_FRAGS frames, the cursor is left on the first
+	 * result that did not fit. Results that did not change since they were last reported
+	 * are left out, see em_scan_diff_t; the report carries the first result if none did,
+	 * the message needs one.
 	 *
-	 * @param[in] last_inex Pointer to the last index scanned.
+	 * @param[in,out] next Cursor on the scan results of the data model, NULL once all are sent.
 	 *
-	 * @returns int Status code of the operation.
-	 * @retval 0 on success.
-	 * @retval -1 on failure.
-	 *
-	 * @note Ensure that the pointer is valid before calling this function.
+	 * @returns int Length of the report on success, -1 on failure.
 	 */
-	int send_channel_scan_report_msg(unsigned int *last_inex);
+	int send_channel_scan_report_msg(dm_scan_result_t **next);
     
 	/**!
 	 * @brief Sends a channel selection request message.
@@ -429,6 +496,19 @@ public:
 	 */
 	int send_available_spectrum_inquiry_msg();
 
+	/**!
+	 * @brief Handles the Available Spectrum Inquiry of an agent on the controller.
+	 *
+	 * The location and the spectrum made available go in the spectrum cache and end the
+	 * inquiry in flight for the location.
+	 *
+	 * @param[in] buff Pointer to the message.
+	 * @param[in] len Length of the message.
+	 *
+	 * @returns 0.
+	 */
+	int handle_avail_spectrum_inquiry(unsigned char *buff, unsigned int len);
+
     
 	/**!
 	 * @brief Handles the channel scan request.
@@ -743,6 +823,11 @@ public:
 	 */
 	void process_state();
 
+	/**!
+	 * @brief Returns the record of the scan results last reported, to tune or disable the incremental reports.
+	 */
+	em_scan_diff_t *get_scan_diff() { return &m_scan_diff; }
+
     unsigned int m_channel_pref_query_tx_cnt;
     unsigned int m_channel_sel_req_tx_cnt;
 	
@@ -40,6 +40,7 @@ class em_cli_t {
 	 */
 	em_cmd_t& get_command(char *in, size_t in_len, em_network_node_t *node = NULL);
     em_long_string_t	m_lib_dbg_file_name;
+    pthread_mutex_t     m_cmd_lock;     // get_command() edits the specs the threads share
 public:
 
 	em_cli_params_t	m_params;
@@ -56,9 +57,42 @@ public:
 	 *
 	 * @returns A pointer to the network node after execution.
 	 *
+	 * Threads may call it at the same time. When the controller tags its results, their
+	 * commands share the connection and each gets its result as soon as it is ready.
+	 *
 	 * @note Ensure that the input command is properly formatted and the node is initialized before calling this function.
 	 */
 	em_network_node_t *exec(char *in, size_t in_len, em_network_node_t *node);
+
+	/**!
+	 * @brief Executes a batch of commands over the connection kept to the controller.
+	 *
+	 * The commands are written ahead of their results instead of one round trip each. A
+	 * controller that tags its results answers each as soon as it is done, the others run
+	 * them in order. A command that fails validation gets the invalid input status. The
+	 * commands after the first one left without a result get none.
+	 *
+	 * @param[in] in The commands.
+	 * @param[in] nodes Edited network nodes of the commands, NULL if none has one.
+	 * @param[in] num Number of commands.
+	 * @param[out] out Result of each command, NULL if it has none.
+	 *
+	 * @returns Number of results.
+	 */
+	unsigned int exec_batch(char **in, em_network_node_t **nodes, unsigned int num, em_network_node_t **out);
+
+	/**!
+	 * @brief Executes the commands of a file as a batch, one command per line.
+	 *
+	 * Blank lines and lines starting with # are skipped.
+	 *
+	 * @param[in] file_name The file.
+	 * @param[out] out Result of each command, NULL if it has none.
+	 * @param[in] max The most commands read from the file.
+	 *
+	 * @returns Number of commands read from the file.
+	 */
+	unsigned int exec_batch_file(const char *file_name, em_network_node_t **out, unsigned int max);
     
 	/**!
 	 * @brief Initializes the EM CLI with the specified parameters.
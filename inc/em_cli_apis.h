@@ -43,6 +43,29 @@ extern "C" {
 	 */
 	em_network_node_t *exec(char *in, size_t in_len, em_network_node_t *node);
 
+	/**!
+	 * @brief Executes a batch of commands, pipelined over the connection to the controller.
+	 *
+	 * @param[in] in The commands.
+	 * @param[in] nodes Edited network nodes of the commands, NULL if none has one.
+	 * @param[in] num Number of commands.
+	 * @param[out] out Result of each command in order, NULL if it has none.
+	 *
+	 * @returns Number of results.
+	 */
+	unsigned int exec_batch(char **in, em_network_node_t **nodes, unsigned int num, em_network_node_t **out);
+
+	/**!
+	 * @brief Executes the commands of a file, one per line, as a batch.
+	 *
+	 * @param[in] file_name The file.
+	 * @param[out] out Result of each command in order, NULL if it has none.
+	 * @param[in] max The most commands read from the file.
+	 *
+	 * @returns Number of commands read from the file.
+	 */
+	unsigned int exec_batch_file(const char *file_name, em_network_node_t **out, unsigned int max);
+
 	/**!
 	 * @brief Initializes the EM CLI with the given parameters.
 	 *
@@ -391,6 +414,25 @@ extern "C" {
 	 */
 	em_network_node_t *get_network_tree_by_key(em_network_node_t *node, em_long_string_t key);
 
+	/**!
+	 * @brief Indexes a tree so the lookups by key, path and display counter in it do not walk it.
+	 *
+	 * @param[in] tree Root of the tree.
+	 *
+	 * @returns 0 on success, -1 if the tree cannot be indexed.
+	 */
+	int index_network_tree(em_network_node_t *tree);
+
+	/**!
+	 * @brief Retrieves a node by its full dotted key, array elements named by position.
+	 *
+	 * @param[in] tree Root of the tree.
+	 * @param[in] path Full dotted key of the node, e.g. "Result.NetworkSSIDList.0.SSID".
+	 *
+	 * @returns The node, NULL if there is none.
+	 */
+	em_network_node_t *get_network_tree_by_path(em_network_node_t *tree, const char *path);
+
 	/**!
 	 * @brief Initializes the library debugging with the specified file name.
 	 *
@@ -0,0 +1,209 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_CLIENT_CAP_CACHE_H
+#define EM_CLIENT_CAP_CACHE_H
+
+#include <pthread.h>
+#include "em_base.h"
+
+#include <unordered_map>
+
+#define EM_CLIENT_CAP_MAX_AGE_MS        3600000 // a STA is queried again after this time
+#define EM_CLIENT_CAP_QUERY_TIMEOUT_MS  5000    // a STA with a query in flight is not queried again before this time
+
+// bands of a STA
+#define EM_CLIENT_CAP_BAND_24           0x01
+#define EM_CLIENT_CAP_BAND_5            0x02
+#define EM_CLIENT_CAP_BAND_6            0x04
+
+// capabilities of a STA
+#define EM_CLIENT_CAP_HT                0x0001
+#define EM_CLIENT_CAP_VHT               0x0002
+#define EM_CLIENT_CAP_HE                0x0004
+#define EM_CLIENT_CAP_EHT               0x0008
+#define EM_CLIENT_CAP_BTM               0x0010
+#define EM_CLIENT_CAP_RRM               0x0020
+#define EM_CLIENT_CAP_MLO               0x0040
+
+/*
+ * Capabilities of a STA parsed from the (Re)Association Request frame body of a
+ * Client Capability Report
+ */
+typedef struct {
+    unsigned int        bands;          // EM_CLIENT_CAP_BAND_*, 0 if unknown
+    unsigned int        flags;          // EM_CLIENT_CAP_*
+    unsigned char       max_nss;        // spatial streams, 0 if unknown
+    mac_address_t       mld_mac;        // of a STA with EM_CLIENT_CAP_MLO, zero if the element has none
+    unsigned long long  time_ms;        // CLOCK_MONOTONIC milliseconds of the report
+} em_client_cap_t;
+
+typedef struct {
+    em_client_cap_t     cap;
+    unsigned long long  query_ms;       // time of the query in flight, 0 if none
+    unsigned int        body_len;
+    unsigned char       body[EM_MAX_FRAME_BODY_LEN];
+} em_client_cap_sta_t;
+
+/*
+ * Client capabilities of the STAs, kept across reassociations and BSS moves. The
+ * frame body of a Client Capability Report is parsed once, the next reports of the
+ * same STA are compared to it and parsed again only if it changed. A STA seen again
+ * is not queried again unless its entry is older than EM_CLIENT_CAP_MAX_AGE_MS or it
+ * associated on a band it did not announce, and a single query per STA is in flight
+ * whichever radio saw it. Steering reads the parsed form. Thread safe.
+ */
+class em_client_cap_cache_t {
+
+    pthread_rwlock_t m_lock;
+    // keyed by the STA MAC packed in an integer
+    std::unordered_map<unsigned long long, em_client_cap_sta_t> m_stas;
+
+    /**!
+     * @brief Returns the key of a STA.
+     */
+    static unsigned long long sta_key(const unsigned char *sta);
+
+public:
+
+    /**!
+     * @brief Stores the frame body of a Client Capability Report.
+     *
+     * @param[in] sta MAC address of the STA.
+     * @param[in] body The (Re)Association Request frame body.
+     * @param[in] len Length of the frame body.
+     * @param[in] band Band the STA associated on, added to the bands of the STA.
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns True if the capabilities of the STA are new or changed, false otherwise.
+     */
+    bool update(const unsigned char *sta, const unsigned char *body, unsigned int len, em_freq_band_t band, unsigned long long now);
+
+    /**!
+     * @brief Copies the parsed capabilities of a STA.
+     *
+     * @param[in] sta MAC address of the STA.
+     * @param[out] cap The capabilities.
+     *
+     * @returns True if the STA has an entry, false otherwise.
+     */
+    bool get(const unsigned char *sta, em_client_cap_t *cap);
+
+    /**!
+     * @brief Copies the frame body of the last Client Capability Report of a STA.
+     *
+     * @param[in] sta MAC address of the STA.
+     * @param[out] body Buffer receiving the frame body.
+     * @param[in] max Size of the buffer.
+     *
+     * @returns Length of the frame body, 0 if the STA has no entry or the buffer is too small.
+     */
+    unsigned int get_body(const unsigned char *sta, unsigned char *body, unsigned int max);
+
+    /**!
+     * @brief Returns true if a STA has to be sent a Client Capability Query.
+     *
+     * @param[in] sta MAC address of the STA.
+     * @param[in] band Band the STA associated on.
+     * @param[in] now Current time in milliseconds.
+     */
+    bool needs_query(const unsigned char *sta, em_freq_band_t band, unsigned long long now);
+
+    /**!
+     * @brief Marks a query of a STA in flight.
+     *
+     * @param[in] sta MAC address of the STA.
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns True if the caller sends the query, false if one is in flight already.
+     */
+    bool claim_query(const unsigned char *sta, unsigned long long now);
+
+    /**!
+     * @brief Returns true if a STA may be steered to a band, STAs not known yet may be steered anywhere.
+     *
+     * @param[in] sta MAC address of the STA.
+     * @param[in] op_class Operating class of the target.
+     */
+    bool supports_op_class(const unsigned char *sta, unsigned char op_class);
+
+    /**!
+     * @brief Removes the entries not updated in EM_CLIENT_CAP_MAX_AGE_MS.
+     *
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns Number of entries removed.
+     */
+    unsigned int age_out(unsigned long long now);
+
+    /**!
+     * @brief Removes the entry of a STA.
+     *
+     * @returns True if the STA had an entry, false otherwise.
+     */
+    bool remove(const unsigned char *sta);
+
+    /**!
+     * @brief Returns the number of STAs with an entry.
+     */
+    unsigned int count();
+
+    /**!
+     * @brief Parses the elements of a (Re)Association Request frame body.
+     *
+     * @param[in] body The frame body.
+     * @param[in] len Length of the frame body.
+     * @param[out] cap The capabilities, its time is left alone.
+     *
+     * @returns True if the elements were parsed to the end, false otherwise.
+     */
+    static bool parse(const unsigned char *body, unsigned int len, em_client_cap_t *cap);
+
+    /**!
+     * @brief Returns the offset of the elements in a (Re)Association Request frame body.
+     *
+     * The fixed fields of an Association or a Reassociation Request are skipped, a body
+     * of elements alone starts at 0, as does a body none of these fit.
+     */
+    static unsigned int get_elems_offset(const unsigned char *body, unsigned int len);
+
+    /**!
+     * @brief Returns the EM_CLIENT_CAP_BAND_* of an operating class, 0 if unknown.
+     */
+    static unsigned int op_class_band(unsigned char op_class);
+
+    /**!
+     * @brief Returns the EM_CLIENT_CAP_BAND_* of a band, 0 if unknown.
+     */
+    static unsigned int freq_band(em_freq_band_t band);
+
+    /**!
+     * @brief Constructor for em_client_cap_cache_t.
+     */
+    em_client_cap_cache_t();
+
+    /**!
+     * @brief Destructor for em_client_cap_cache_t.
+     */
+    ~em_client_cap_cache_t();
+
+    em_client_cap_cache_t(const em_client_cap_cache_t&) = delete;
+    em_client_cap_cache_t& operator=(const em_client_cap_cache_t&) = delete;
+};
+
+#endif
@@ -22,9 +22,81 @@
 #include "em_base.h"
 #include "em_ctrl.h"
 #include <sys/time.h>
+#include <atomic>
 #include "dm_easy_mesh.h"
+#include "em_profile.h"
+#include "em_cmd_pool.h"
+
+class em_t;
+class em_cmd_t;
+struct em_orch_cmd_list_t;
+
+/*
+ * Entry of the per em_t command index of the orchestrator, one per command candidate.
+ */
+struct em_orch_link_t {
+    em_cmd_t *cmd;
+    em_t *em;
+    em_orch_link_t *next;
+    em_orch_link_t *prev;
+    bool step_timed;    // the step time of this em_t was recorded
+};
+
+/*
+ * Data model of a command, shared by the command and the clones made for the other
+ * orchestration steps. A holder that changes it after cloning first takes its own
+ * copy through em_cmd_t::get_own_data_model().
+ */
+struct em_cmd_snapshot_t {
+    dm_easy_mesh_t dm;
+    std::atomic<unsigned int> refs;
+    bool initialized;       // dm.init() was called, dm.deinit() is due with the last reference
+
+    // the snapshots of a burst of commands reuse the blocks of the previous ones
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr);
+};
 
 class em_cmd_t {
+    em_cmd_snapshot_t *m_snapshot;
+
+	/**!
+	 * @brief Drops the reference of this command on its data model snapshot.
+	 *
+	 * The snapshot is deinitialized and freed with its last reference.
+	 */
+	void release_snapshot();
+
+protected:
+
+	/**!
+	 * @brief Constructor for a clone of a command, sharing its data model snapshot.
+	 *
+	 * @param[in] parent Command being cloned.
+	 */
+	explicit em_cmd_t(em_cmd_t *parent);
+
+public:
+
+	/**!
+	 * @brief Allocates a command from em_cmd_pool_t.
+	 *
+	 * Every command type has its own size and so its own free list, the constructor
+	 * of the type initializes the recycled block.
+	 *
+	 * @param[in] size Size of the command type.
+	 *
+	 * @returns Pointer to the block.
+	 */
+	static void *operator new(size_t size);
+
+	/**!
+	 * @brief Returns a command to em_cmd_pool_t.
+	 *
+	 * @param[in] ptr Pointer to the destroyed command.
+	 */
+	static void operator delete(void *ptr);
+
 public:
     em_cmd_type_t   m_type;
     em_service_type_t   m_svc;
@@ -32,7 +104,8 @@ public:
     em_event_t  *m_evt;
     em_string_t m_name;
     queue_t *m_em_candidates;
-    dm_easy_mesh_t  m_data_model;
+    dm_easy_mesh_t  *m_data_model;     // snapshot, shared with the clones of the command
+    em_cmd_ctx_t    m_ctx;
     struct timeval  m_start_time;
 
     unsigned int m_orch_op_idx;
@@ -41,6 +114,19 @@ public:
     unsigned int m_rd_op_class;
     unsigned int m_rd_channel;
     unsigned int m_db_cfg_type;
+    bool m_orch_in_place;   // the steps run on this command, advanced by the orchestrator instead of cloned
+    unsigned int m_cfg_bands;   // bit per em_freq_band_t of the radios the command reconfigures, 0 for all radios
+
+    // orchestrator bookkeeping, only touched by em_orch_t
+    em_orch_cmd_list_t *m_orch_list;
+    em_cmd_t *m_orch_next;
+    em_cmd_t *m_orch_prev;
+    em_cmd_t *m_type_next;
+    em_cmd_t *m_type_prev;
+    em_orch_link_t *m_em_links;
+    unsigned int m_num_em_links;
+    uint64_t m_submit_us;
+    uint64_t m_active_us;
 
 public:
     
@@ -69,6 +155,15 @@ public:
 	 */
 	char *status_to_string(em_cmd_out_status_t status, char *str);
 
+	/**!
+	 * @brief Returns the name of a command output status, as in the Status of a result.
+	 *
+	 * @param[in] status The status.
+	 *
+	 * @returns The name, an empty string for an unknown status.
+	 */
+	static const char *get_status_string(em_cmd_out_status_t status);
+
     
 	/**!
 	 * @brief Retrieves the type of the command.
@@ -163,7 +258,31 @@ public:
 	 *
 	 * @returns Pointer to the data model instance.
 	 */
-	dm_easy_mesh_t *get_data_model() { return &m_data_model; }
+	dm_easy_mesh_t *get_data_model() { return m_data_model; }
+
+	/**!
+	 * @brief Retrieves the data model for changes.
+	 *
+	 * The data model is copied first if it is shared with other commands, so that the
+	 * changes are only seen by this command.
+	 *
+	 * @returns Pointer to the data model of this command only.
+	 */
+	dm_easy_mesh_t *get_own_data_model();
+
+	/**!
+	 * @brief Retrieves the command context.
+	 *
+	 * @returns Pointer to the context of this command.
+	 */
+	em_cmd_ctx_t *get_cmd_ctx() { return &m_ctx; }
+
+	/**!
+	 * @brief Sets the command context.
+	 *
+	 * @param[in] ctx Pointer to the context to copy.
+	 */
+	void set_cmd_ctx(em_cmd_ctx_t *ctx) { memcpy(&m_ctx, ctx, sizeof(em_cmd_ctx_t)); }
 
     
 	/**!
@@ -234,6 +353,18 @@ public:
 	 * memory leaks.
 	 */
 	virtual em_cmd_t *clone_for_next();
+
+	/**!
+	 * @brief Moves the command to its next orchestration operation in place.
+	 *
+	 * Used by the orchestrator for commands whose steps run in place, the context is
+	 * reset for the new operation as clone_for_next() does for a clone.
+	 *
+	 * @returns True if the command moved, false if it was on its last operation.
+	 */
+	bool advance_orch_op();
+
+	bool is_orch_in_place() { return m_orch_in_place; }
     
 	/**!
 	 * @brief Clones the current em_cmd object.
@@ -288,7 +419,7 @@ public:
 	 *
 	 * @note Ensure that the returned pointer is valid before using it.
 	 */
-	em_interface_t *get_ctrl_al_interface() { return m_data_model.get_ctrl_al_interface(); }
+	em_interface_t *get_ctrl_al_interface() { return m_data_model->get_ctrl_al_interface(); }
     
 	/**!
 	 * @brief Retrieves the agent AL interface.
@@ -299,7 +430,7 @@ public:
 	 *
 	 * @note Ensure that the returned pointer is valid before using it.
 	 */
-	em_interface_t *get_agent_al_interface() { return m_data_model.get_agent_al_interface(); }
+	em_interface_t *get_agent_al_interface() { return m_data_model->get_agent_al_interface(); }
     
 	/**!
 	 * @brief Retrieves the radio interface for the specified index.
@@ -313,7 +444,7 @@ public:
 	 *
 	 * @note Ensure that the index is within the valid range of available radio interfaces.
 	 */
-	em_interface_t *get_radio_interface(unsigned int index) { return m_data_model.get_radio_interface(index); }
+	em_interface_t *get_radio_interface(unsigned int index) { return m_data_model->get_radio_interface(index); }
         
     
 	/**!
@@ -325,7 +456,7 @@ public:
 	 *
 	 * @note Ensure that the returned pointer is handled appropriately to avoid memory issues.
 	 */
-	unsigned char *get_al_interface_mac() { return m_data_model.get_agent_al_interface_mac(); }
+	unsigned char *get_al_interface_mac() { return m_data_model->get_agent_al_interface_mac(); }
     
 	/**!
 	 * @brief Retrieves the manufacturer name.
@@ -336,14 +467,14 @@ public:
 	 *
 	 * @note Ensure that the returned string is properly managed to avoid memory leaks.
 	 */
-	char *get_manufacturer() { return m_data_model.get_manufacturer(); }
+	char *get_manufacturer() { return m_data_model->get_manufacturer(); }
     
 	/**!
 	 * @brief Retrieves the manufacturer model.
 	 *
 	 * @returns A pointer to a character string containing the manufacturer model.
 	 */
-	char *get_manufacturer_model() { return m_data_model.get_manufacturer_model(); }
+	char *get_manufacturer_model() { return m_data_model->get_manufacturer_model(); }
     
 	/**!
 	 * @brief Retrieves the serial number.
@@ -354,7 +485,7 @@ public:
 	 *
 	 * @note Ensure that the returned pointer is not null before using it.
 	 */
-	char *get_serial_number() { return m_data_model.get_serial_number(); }
+	char *get_serial_number() { return m_data_model->get_serial_number(); }
     
 	/**!
 	 * @brief Retrieves the IEEE 1905 security capabilities.
@@ -368,7 +499,7 @@ public:
 	 * @note Ensure that the returned pointer is not null before accessing
 	 * the security capabilities.
 	 */
-	em_ieee_1905_security_cap_t *get_ieee_1905_security_cap() { return m_data_model.get_ieee_1905_security_cap(); }
+	em_ieee_1905_security_cap_t *get_ieee_1905_security_cap() { return m_data_model->get_ieee_1905_security_cap(); }
     
 	/**!
 	 * @brief Retrieves the primary device type.
@@ -379,7 +510,7 @@ public:
 	 *
 	 * @note Ensure that the returned string is not modified or freed by the caller.
 	 */
-	char *get_primary_device_type() { return m_data_model.get_primary_device_type(); }
+	char *get_primary_device_type() { return m_data_model->get_primary_device_type(); }
 
     
 	/**!
@@ -389,7 +520,7 @@ public:
 	 *
 	 * @returns The number of network SSIDs.
 	 */
-	unsigned int get_num_network_ssid() { return m_data_model.get_num_network_ssid(); }
+	unsigned int get_num_network_ssid() { return m_data_model->get_num_network_ssid(); }
 
     
 	/**!
@@ -403,7 +534,7 @@ public:
 	 *
 	 * @note Ensure the index is within the valid range of available network SSIDs.
 	 */
-	dm_network_ssid_t *get_network_ssid(unsigned int index) { return m_data_model.get_network_ssid(index); }
+	dm_network_ssid_t *get_network_ssid(unsigned int index) { return m_data_model->get_network_ssid(index); }
     
 	/**!
 	 * @brief Retrieves the DPP (Data Processing Pointer) from the data model.
@@ -414,7 +545,7 @@ public:
 	 * @returns A pointer to the dm_dpp_t structure.
 	 * @note Ensure that the returned pointer is not null before using it.
 	 */
-	dm_dpp_t *get_dpp() { return m_data_model.get_dpp(); }
+	dm_dpp_t *get_dpp() { return m_data_model->get_dpp(); }
     
 	/**!
 	 * @brief Retrieves a radio object from the data model.
@@ -429,7 +560,7 @@ public:
 	 *
 	 * @note Ensure that the index is within the valid range of available radios.
 	 */
-	dm_radio_t *get_radio(unsigned int index) { return m_data_model.get_radio(index); }
+	dm_radio_t *get_radio(unsigned int index) { return m_data_model->get_radio(index); }
     
 	/**!
 	 * @brief Retrieves the current operation class for a given index.
@@ -444,7 +575,7 @@ public:
 	 *
 	 * @note Ensure that the index is within the valid range before calling this function.
 	 */
-	dm_op_class_t *get_curr_op_class(unsigned int index) { return m_data_model.get_curr_op_class(index); }
+	dm_op_class_t *get_curr_op_class(unsigned int index) { return m_data_model->get_curr_op_class(index); }
     
 	/**!
 	 * @brief Retrieves the radio data for a given interface.
@@ -460,7 +591,7 @@ public:
 	 * @note Ensure that the interface provided is valid and initialized
 	 *       before calling this function.
 	 */
-	rdk_wifi_radio_t *get_radio_data(em_interface_t *radio) { return m_data_model.get_radio_data(radio); };
+	rdk_wifi_radio_t *get_radio_data(em_interface_t *radio) { return m_data_model->get_radio_data(radio); };
     
 	/**!
 	 * @brief Retrieves the current read operation class.
@@ -540,12 +671,11 @@ public:
 	/**!
 	 * @brief Resets the command context.
 	 *
-	 * This function resets the command context by invoking the reset_cmd_ctx method
-	 * on the m_data_model object.
+	 * The context belongs to the command, the shared data model is not changed.
 	 *
 	 * @note This function does not take any parameters and does not return any value.
 	 */
-	void reset_cmd_ctx() { m_data_model.reset_cmd_ctx(); }
+	void reset_cmd_ctx() { memset(&m_ctx, 0, sizeof(em_cmd_ctx_t)); }
 
     
 	/**!
@@ -566,6 +696,16 @@ public:
 	 */
 	void set_db_cfg_type(unsigned int type) { m_db_cfg_type = type; }
 
+	/**!
+	 * @brief Returns the bands of the radios the command reconfigures, a bit per em_freq_band_t, 0 for all radios.
+	 */
+	unsigned int get_cfg_bands() { return m_cfg_bands; }
+
+	/**!
+	 * @brief Restricts the command to the radios of some bands, before it is cloned for its next steps.
+	 */
+	void set_cfg_bands(unsigned int bands) { m_cfg_bands = bands; }
+
     
 	/**!
 	 * @brief Converts a bus event type to a command type.
@@ -618,6 +758,16 @@ public:
 	 * @note Ensure that the input type is a valid em_bus_event_type_t value to avoid undefined behavior.
 	 */
 	static const char *get_bus_event_type_str(em_bus_event_type_t type);
+
+	/**!
+	 * @brief Names the event types of em_profile_t, an em_profile_name_fn_t.
+	 *
+	 * @param[in] domain Profile domain of the type.
+	 * @param[in] type Bus or event type, CMDU types are left to the numeric default.
+	 *
+	 * @returns Name of the type, or NULL.
+	 */
+	static const char *get_profile_type_str(em_profile_domain_t domain, unsigned int type);
     
 	/**!
 	 * @brief Retrieves the command type as a string.
@@ -631,6 +781,19 @@ public:
 	 * @note Ensure that the command type provided is valid to avoid unexpected results.
 	 */
 	static const char *get_cmd_type_str(em_cmd_type_t type);    
+
+	/**!
+	 * @brief Returns the priority class the orchestrator queues a command type in.
+	 *
+	 * @param[in] type The command type.
+	 *
+	 * @returns The priority class, em_cmd_prio_config for the types not listed.
+	 */
+	static em_cmd_prio_t get_cmd_prio(em_cmd_type_t type);
+
+	static const char *get_cmd_prio_str(em_cmd_prio_t prio);
+
+	em_cmd_prio_t get_prio() { return get_cmd_prio(m_type); }
     
 	/**!
 	 * @brief Dumps the bus event details.
@@ -695,6 +858,9 @@ public:
 	 * @note Ensure that all operations using em_cmd_t are completed before destruction.
 	 */
 	virtual ~em_cmd_t();
+
+	em_cmd_t(const em_cmd_t&) = delete;
+	em_cmd_t& operator=(const em_cmd_t&) = delete;
 };
 
 #endif
@@ -69,6 +69,13 @@ public:
 	int     get_edited_node(em_network_node_t *node, const char *header, char *buff);
   
   
+	/**!
+	 * @brief Builds the event of the command sent to the controller.
+	 *
+	 * @returns 0 on success, -1 if a file or edited node of the command is missing.
+	 */
+	int build_event();
+
 	/**!
 	 * @brief Executes a command and stores the result.
 	 *
@@ -20,9 +20,96 @@
 #define EM_CMD_CTRL_H
 
 #include "em_cmd_exec.h"
+#include <vector>
+#include <map>
+#include <string>
+
+typedef struct {
+    SSL             *ssl;
+    time_t          last_used;
+    unsigned int    outstanding;    // commands of a tagged session whose result is not written
+    bool            closed;         // the client of a tagged session left before all its results
+} em_cmd_ctrl_session_t;
+
+// where the result of a command goes
+typedef struct {
+    SSL             *ssl;
+    unsigned int    id;             // id of the command on a tagged session
+} em_cmd_ctrl_reply_t;
+
+// result for a tagged session, its id and frames, written by the command loop
+typedef struct {
+    SSL             *ssl;
+    std::string     data;
+} em_cmd_ctrl_tagged_result_t;
 
 class em_cmd_ctrl_t : public em_cmd_exec_t { 
 
+    int m_wake[2];                      // send_result wakes the command loop up to poll a parked session
+    pthread_mutex_t m_parked_lock;
+    std::vector<SSL *> m_parked;        // kept sessions whose result was sent
+    std::vector<em_cmd_ctrl_tagged_result_t> m_tagged_results;  // results waiting to be written, under m_parked_lock
+
+    std::vector<em_cmd_ctrl_session_t> m_sessions;  // kept sessions polled by the command loop
+
+    pthread_mutex_t m_pending_lock;
+    std::map<em_event_t *, em_cmd_ctrl_reply_t> m_pending;  // queued events whose handler sends the result
+    em_event_t *m_current;              // event the manager handles, set by begin_event()
+
+    /**!
+     * @brief Reads a command from a session and executes it.
+     *
+     * The result is sent now or, for the commands that wait for the orchestration, later
+     * by send_result(). A kept session is parked again once its result is sent.
+     *
+     * @param[in] ssl The session.
+     */
+    void handle_command(SSL *ssl);
+
+    /**!
+     * @brief Reads the commands of a tagged session and executes them.
+     *
+     * The session is not parked, its next commands are read while the ones before them
+     * wait for the orchestration.
+     *
+     * @param[in] session The session.
+     *
+     * @returns 0 on success, -1 if the client closed the session.
+     */
+    int handle_tagged_command(em_cmd_ctrl_session_t *session);
+
+    /**!
+     * @brief Queues the command read for the manager.
+     *
+     * @param[in] reply Where the result of the command goes.
+     *
+     * @returns True if the handler of the command sends the result, false if the caller does.
+     */
+    bool dispatch(const em_cmd_ctrl_reply_t *reply);
+
+    /**!
+     * @brief Sends the result of a command to where it goes.
+     *
+     * The result of a tagged session is encoded and handed to the command loop, the only
+     * thread that reads and writes the tagged sessions.
+     */
+    int send_result(const em_cmd_ctrl_reply_t *reply, em_cmd_out_status_t status, cJSON *result);
+
+    /**!
+     * @brief Writes the results handed to the command loop for the tagged sessions.
+     */
+    void write_tagged_results(time_t now);
+
+    /**!
+     * @brief Wakes the command loop up.
+     */
+    void wake();
+
+    /**!
+     * @brief Shuts a session down and closes its connection.
+     */
+    static void close_session(SSL *ssl);
+
 public:
     
 	/**!
@@ -40,11 +127,28 @@ public:
 	 */
 	int execute(char *result);
     
+	/**!
+	 * @brief Tells which event the manager handles, the results sent until end_event() answer it.
+	 *
+	 * @param[in] evt The event, from the queue of the manager.
+	 */
+	void begin_event(em_event_t *evt) { m_current = evt; }
+
+	/**!
+	 * @brief Ends the handling of the event given to begin_event().
+	 *
+	 * A command whose handler sent no result is answered em_cmd_out_status_other, as the
+	 * commands that do not wait for the orchestration are.
+	 */
+	void end_event();
+
 	/**!
 	 * @brief Sends the result of a command execution.
 	 *
 	 * This function is responsible for sending the result status of a command
-	 * execution to the appropriate handler or output interface.
+	 * execution to the appropriate handler or output interface. The result answers the
+	 * command of the event the manager handles, it is dropped for the events the
+	 * controller raised itself.
 	 *
 	 * @param[in] status The status of the command execution to be sent.
 	 *
@@ -56,6 +160,21 @@ public:
 	 */
 	int send_result(em_cmd_out_status_t status);
 
+	/**!
+	 * @brief Sends the result of a command execution with its output.
+	 *
+	 * The output is streamed in frames to the clients that negotiated EM_CMD_STREAM_PROTO,
+	 * printed whole for the others.
+	 *
+	 * @param[in] status The status of the command execution.
+	 * @param[in] result The output, sent as the Result of a successful command, NULL for none.
+	 * The caller keeps it.
+	 *
+	 * @returns int
+	 * @retval 0 on success
+	 */
+	int send_result(em_cmd_out_status_t status, cJSON *result);
+
     
 	/**!
 	 * @brief Constructor for em_cmd_ctrl_t class.
@@ -65,6 +184,11 @@ public:
 	 * @note This constructor does not take any parameters.
 	 */
 	em_cmd_ctrl_t();
+
+	/**!
+	 * @brief Destructor for em_cmd_ctrl_t class.
+	 */
+	~em_cmd_ctrl_t();
 };
 
 #endif
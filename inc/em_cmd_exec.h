@@ -23,6 +23,76 @@
 #include "em_cmd.h"
 #include "openssl/ssl.h"
 #include "openssl/err.h"
+#include <map>
+#include <string>
+
+#define EM_CMD_KEEP_ALIVE_PROTO     "em-keep-alive"     // ALPN protocol of a connection kept open between commands
+#define EM_CMD_CHANNEL_IDLE_SEC     20                  // a kept connection idle longer is reconnected by the client
+#define EM_CMD_SESSION_IDLE_SEC     30                  // and closed by the server
+#define EM_CMD_MAX_KEPT_SESSIONS    16
+#define EM_CMD_STREAM_PROTO         "em-stream"         // ALPN protocol of a kept connection whose results are framed
+#define EM_CMD_STREAM_CHUNK_SZ      4096                // the most of a frame a client reads at once
+#define EM_CMD_PIPELINE_DEPTH       32                  // commands of a batch written ahead of their results
+#define EM_CMD_PIPELINE_SZ          (256 * 1024)        // and their bytes, less than the receive buffer of the service
+#define EM_CMD_WIRE_MAGIC           0x31574d45          // "EMW1", first bytes of an encoded bus event
+#define EM_CMD_TAGGED_PROTO         "em-tagged"         // ALPN protocol of a kept connection whose commands and results carry an id
+#define EM_CMD_TAG_SZ               4
+
+/*
+ * A framed result is a sequence of frames, each a 4 byte length in network byte order and
+ * that many bytes of JSON text, ended by a frame of length 0. The controller writes the
+ * frames as it encodes the result, the client hands them on as they are read.
+ *
+ * On a tagged connection each command is preceded by an id of EM_CMD_TAG_SZ bytes in
+ * network byte order, and each result, framed, by the id of its command. The controller
+ * answers a command as soon as it is done, so a result may overtake the results of the
+ * commands sent before it. The threads of a client share the connection.
+ */
+
+/*
+ * An encoded bus event is the header below, the first params_len bytes of the parameters
+ * of the command, whose remaining bytes are zero, and the event union with its data_len
+ * bytes of data. A command thus carries its arguments and its subdocument, not the whole
+ * em_event_t. An event that does not start with the magic is a plain em_event_t.
+ */
+typedef struct {
+    unsigned int    magic;
+    unsigned int    type;           // em_bus_event_type_t
+    unsigned int    params_len;
+    unsigned int    data_len;
+} __attribute__((__packed__)) em_cmd_wire_hdr_t;
+
+/**!
+ * @brief Receives the result of a command as it is read.
+ *
+ * @param[in] arg Argument given with the sink.
+ * @param[in] data Bytes of the result, not NUL terminated.
+ * @param[in] len Number of bytes.
+ *
+ * @returns 0 to go on, -1 to stop reading, the connection is then closed.
+ */
+typedef int (*em_cmd_result_sink_t)(void *arg, const char *data, unsigned int len);
+
+/*
+ * Connection to a service reused by the commands sent to it. The results are read in
+ * the order of the commands, one command at a time, unless the connection is tagged.
+ * The commands of a tagged connection then go out as they come, the thread waiting for
+ * a result reads the results of the others as well. The TLS session is resumed when the
+ * connection is made again.
+ */
+typedef struct {
+    SSL                 *ssl;
+    SSL_SESSION         *session;
+    struct sockaddr_in  addr;
+    bool                keep_alive;     // the service keeps the connection open after the result
+    bool                tagged;         // the service tags its results, see EM_CMD_TAGGED_PROTO
+    bool                reading;        // a thread reads the results of the tagged connection
+    unsigned int        next_id;
+    unsigned int        outstanding;    // commands sent on the tagged connection whose result is not read
+    unsigned int        generation;     // bumped when the connection is closed
+    std::map<unsigned int, std::string> results;    // results read for the threads waiting for them
+    time_t              last_used;
+} em_cmd_channel_t;
 
 class em_cmd_exec_t {
 
@@ -30,6 +100,72 @@ class em_cmd_exec_t {
     pthread_mutex_t m_lock;
 	SSL_CTX *m_ssl_ctx;	
 
+    static SSL_CTX *s_client_ctx;
+    static em_cmd_channel_t s_channel[em_service_type_none];
+    static pthread_mutex_t s_channel_lock;
+    static pthread_cond_t s_channel_cond;   // a result of a tagged connection was read or the connection closed
+
+    /**!
+     * @brief Returns the TLS context of the connections to the services, created on first use.
+     */
+    static SSL_CTX *get_client_ctx();
+
+    /**!
+     * @brief Closes the connection of a channel, the TLS session is kept for the next one.
+     *
+     * The threads waiting for a result of the connection are woken up, they fail.
+     */
+    static void close_channel(em_cmd_channel_t *ch);
+
+    /**!
+     * @brief Sends a command on a tagged channel and hands its result to a sink.
+     *
+     * Called with s_channel_lock held, which is released while waiting for the service so that
+     * the other threads can send their commands in the meantime.
+     *
+     * @returns 1 on success, 0 if the service closed the connection before the command,
+     * -1 on error.
+     */
+    static int transact_tagged(em_cmd_channel_t *ch, const unsigned char *in, unsigned int in_len,
+                               em_cmd_result_sink_t sink, void *arg);
+
+    /**!
+     * @brief Sends a command on a tagged channel without waiting for its result.
+     *
+     * @param[out] id Id of the command, to wait for its result with wait_tagged().
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    static int send_tagged(em_cmd_channel_t *ch, const unsigned char *in, unsigned int in_len, unsigned int *id);
+
+    /**!
+     * @brief Waits for the result of a command sent on a tagged channel.
+     *
+     * The result is handed to the sink as it is read, or from where another thread stored
+     * it. Called with s_channel_lock held.
+     *
+     * @returns 1 on success, -1 if the connection failed before the result.
+     */
+    static int wait_tagged(em_cmd_channel_t *ch, unsigned int id, unsigned int generation,
+                           em_cmd_result_sink_t sink, void *arg);
+
+    /**!
+     * @brief Reads the result of a command, its frames or the string up to its terminating NUL.
+     *
+     * @param[in] ssl The connection.
+     * @param[in] sink Function receiving the result.
+     * @param[in] arg Argument passed to the sink.
+     *
+     * @returns 1 on success, 0 if the connection was closed before any of the result, -1 on error.
+     */
+    static int read_result(SSL *ssl, em_cmd_result_sink_t sink, void *arg);
+
+    /**!
+     * @brief Selects the keep alive protocol when the client offers it.
+     */
+    static int select_alpn(SSL *ssl, const unsigned char **out, unsigned char *outlen,
+                           const unsigned char *in, unsigned int inlen, void *arg);
+
 public:
     em_cmd_t m_cmd;
     SSL *m_ssl;
@@ -162,9 +298,129 @@ public:
 	 *
 	 * This function returns the socket for service type.
 	 *
+	 * @param[in] ctx TLS context of the connection.
+	 * @param[in] svc Service to connect to.
+	 * @param[in] session TLS session to resume, if any.
+	 * @param[in] keep_alive Offer the service to keep the connection open after the result.
+	 *
 	 * @returns socket
 	 */
-	SSL *get_ep_for_dst_svc(SSL_CTX *ctx, em_service_type_t svc);
+	SSL *get_ep_for_dst_svc(SSL_CTX *ctx, em_service_type_t svc, SSL_SESSION *session = NULL, bool keep_alive = false);
+
+	/**!
+	 * @brief Sends a command to a service and reads its result on the channel kept to it.
+	 *
+	 * The connection and the TLS session of the previous command are reused, a command costs
+	 * one write and one read. The channel is connected again if it was idle for more than
+	 * EM_CMD_CHANNEL_IDLE_SEC, the service closed it or the destination changed. When the
+	 * service tags its results, the threads calling this function share the connection and
+	 * do not wait for the results of each other.
+	 *
+	 * @param[in] svc Service the command is sent to.
+	 * @param[in] in The command.
+	 * @param[in] in_len Length of the command.
+	 * @param[out] out Buffer for the result.
+	 * @param[in] out_len Size of the buffer.
+	 *
+	 * @returns 0 on success, -1 on failure.
+	 */
+	int transact(em_service_type_t svc, unsigned char *in, unsigned int in_len, char *out, unsigned int out_len);
+
+	/**!
+	 * @brief Sends a command to a service and hands its result to a sink as it is read.
+	 *
+	 * A result of any size is read with EM_CMD_STREAM_CHUNK_SZ bytes of memory, the sink
+	 * gets it without the terminating NUL.
+	 *
+	 * @param[in] svc Service the command is sent to.
+	 * @param[in] in The command.
+	 * @param[in] in_len Length of the command.
+	 * @param[in] sink Function receiving the result.
+	 * @param[in] arg Argument passed to the sink.
+	 *
+	 * @returns 0 on success, -1 on failure.
+	 */
+	int transact(em_service_type_t svc, unsigned char *in, unsigned int in_len, em_cmd_result_sink_t sink, void *arg);
+
+	/**!
+	 * @brief Sends a batch of commands to a service and hands their results to a sink in order.
+	 *
+	 * The first command goes through transact(). When the service frames its results the
+	 * others are pipelined on the kept channel, up to EM_CMD_PIPELINE_DEPTH commands or
+	 * EM_CMD_PIPELINE_SZ bytes are written ahead of the result being read, so a batch does
+	 * not wait a round trip per command. When it tags them as well, a command answered
+	 * right away is not held up by one waiting for the orchestration, its result is kept
+	 * until the sink gets to it. Other services get the commands one after the other on the
+	 * kept channel.
+	 *
+	 * @param[in] svc Service the commands are sent to.
+	 * @param[in] in The commands.
+	 * @param[in] in_len Lengths of the commands.
+	 * @param[in] num Number of commands.
+	 * @param[in] sink Function receiving the results.
+	 * @param[in] arg Arguments passed to the sink, one per command.
+	 *
+	 * @returns Number of commands whose result was read, from the first one on.
+	 */
+	unsigned int transact_batch(em_service_type_t svc, unsigned char **in, unsigned int *in_len, unsigned int num,
+	                            em_cmd_result_sink_t sink, void **arg);
+
+	/**!
+	 * @brief Returns true if the connection is kept open after the result, framed or not.
+	 */
+	static bool is_keep_alive(SSL *ssl);
+
+	/**!
+	 * @brief Returns true if the results are framed on a connection, tagged or not.
+	 */
+	static bool is_streaming(SSL *ssl);
+	/**!
+	 * @brief Returns true if the commands and results carry an id on a connection.
+	 */
+	static bool is_tagged(SSL *ssl);
+
+	/**!
+	 * @brief Writes a frame of a result, a dm_json_writer_t sink.
+	 *
+	 * @param[in] arg The connection, an SSL.
+	 * @param[in] data Bytes of the frame.
+	 * @param[in] len Number of bytes, 0 ends the result.
+	 *
+	 * @returns 0 on success, -1 on failure.
+	 */
+	static int write_frame(void *arg, const char *data, size_t len);
+
+	/**!
+	 * @brief Reads a whole event, encoded or plain, its header and then its data.
+	 *
+	 * @returns Length of the event, 0 if the connection was closed, -1 on error.
+	 */
+	static int read_event(SSL *ssl, em_event_t *evt);
+
+	/**!
+	 * @brief Encodes a bus event for sending, see em_cmd_wire_hdr_t.
+	 *
+	 * @param[in] evt The bus event, its data_len set.
+	 * @param[out] buff Buffer receiving the encoded event.
+	 * @param[in] len Size of the buffer, sizeof(em_cmd_wire_hdr_t) plus the length of the event is always enough.
+	 *
+	 * @returns Length of the encoded event, 0 if it is not a bus event or does not fit.
+	 */
+	static unsigned int encode_event(em_event_t *evt, unsigned char *buff, unsigned int len);
+
+	/**!
+	 * @brief Writes a buffer, across as many TLS records as needed.
+	 *
+	 * @returns 0 on success, -1 on failure.
+	 */
+	static int write_all(SSL *ssl, const unsigned char *buff, unsigned int len);
+
+	/**!
+	 * @brief Reads exactly len bytes.
+	 *
+	 * @returns len on success, 0 if the connection was closed before any of them, -1 on error.
+	 */
+	static int read_all(SSL *ssl, unsigned char *buff, unsigned int len);
     
 	/**!
 	 * @brief gets listener socket from service type
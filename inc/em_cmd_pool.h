@@ -0,0 +1,114 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_CMD_POOL_H
+#define EM_CMD_POOL_H
+
+#include <pthread.h>
+#include <stddef.h>
+
+#define EM_CMD_POOL_MAX_SIZES       48
+#define EM_CMD_POOL_CACHE           32      // per object size
+#define EM_CMD_POOL_LARGE_SZ        (64*1024)
+#define EM_CMD_POOL_LARGE_CACHE     8       // per object size, for the data model snapshots
+
+/*
+ * Header of a pooled block, padded so that the object behind it keeps the strictest alignment.
+ */
+typedef union em_cmd_pool_blk {
+    struct {
+        unsigned int idx;               // size slot the block belongs to
+        union em_cmd_pool_blk *next;
+    } h;
+    max_align_t align;
+} em_cmd_pool_blk_t;
+
+typedef struct {
+    size_t size;
+    em_cmd_pool_blk_t *free;
+    unsigned int alloc;
+    unsigned int hit;
+    unsigned int cached;
+} em_cmd_pool_slot_t;
+
+class em_cmd_pool_t {
+
+    pthread_mutex_t m_lock;
+    em_cmd_pool_slot_t m_slots[EM_CMD_POOL_MAX_SIZES];
+    unsigned int m_num_slots;
+
+public:
+
+    /**!
+     * @brief Allocates a block for an object of the given size.
+     *
+     * The commands of one type all have the same size, so each command type, and the
+     * data model snapshots, get their own free list. A recycled block is used when one
+     * is available, otherwise a new block is allocated.
+     *
+     * @param[in] size Size of the object.
+     *
+     * @returns Pointer to the uninitialized block, NULL if memory could not be allocated.
+     */
+    void *alloc(size_t size);
+
+    /**!
+     * @brief Returns a block obtained from alloc() to the pool.
+     *
+     * @param[in] ptr Pointer to the block. NULL is ignored.
+     *
+     * @note Blocks beyond the per size cache limit are released to the heap.
+     */
+    void release(void *ptr);
+
+    /**!
+     * @brief Returns the allocation statistics of an object size.
+     *
+     * @param[in] size Size of the object.
+     * @param[out] alloc Number of allocations.
+     * @param[out] hit Number of allocations served from the free list.
+     * @param[out] cached Number of free blocks held.
+     *
+     * @returns True if the size was ever allocated.
+     */
+    bool get_stats(size_t size, unsigned int *alloc, unsigned int *hit, unsigned int *cached);
+
+    /**!
+     * @brief Prints allocation statistics of the pool.
+     */
+    void dump_stats();
+
+    /**!
+     * @brief Returns the pool shared by all commands of the process.
+     *
+     * It is never destroyed, so commands released at exit still find it.
+     */
+    static em_cmd_pool_t *get_pool();
+
+    /**!
+     * @brief Constructor for em_cmd_pool_t.
+     */
+    em_cmd_pool_t();
+
+    /**!
+     * @brief Destructor for em_cmd_pool_t, releases all cached blocks.
+     */
+    ~em_cmd_pool_t();
+};
+
+#endif
@@ -0,0 +1,41 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_CMD_STA_STEER_BATCH_H
+#define EM_CMD_STA_STEER_BATCH_H
+
+#include "em_cmd.h"
+
+class em_cmd_sta_steer_batch_t : public em_cmd_t {
+
+public:
+
+	/**!
+	 * @brief Steers several STAs of one BSS with a single Client Steering Request.
+	 *
+	 * Each STA has its own target, the request carries one Target BSSID per STA.
+	 *
+	 * @param[in] params The source BSS, the BTM request fields shared by the STAs and the STA/target pairs,
+	 *                   num is clamped to EM_MAX_STEER_BATCH.
+	 *
+	 * @returns em_cmd_sta_steer_batch_t
+	 */
+	em_cmd_sta_steer_batch_t(em_cmd_steer_batch_params_t& params);
+};
+
+#endif
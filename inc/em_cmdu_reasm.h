@@ -0,0 +1,221 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_CMDU_REASM_H
+#define EM_CMDU_REASM_H
+
+#include <stdint.h>
+#include "em_base.h"
+#include "em_frame_ring.h"
+#include "em_lat_hist.h"
+
+#define EM_REASM_MAX_ENTRIES    32
+#define EM_REASM_MAX_FRAGS      64              // fragments of one message, one bit each in em_reasm_entry_t::frags
+#define EM_REASM_PEER_QUOTA     (256 * 1024)    // bytes of pending fragments per source
+#define EM_REASM_MAX_BYTES      (1024 * 1024)   // bytes of pending fragments in total
+#define EM_REASM_TIMEOUT_US     (1000 * 1000)
+
+typedef struct {
+    unsigned char frag_id;
+    unsigned int off;           // of the TLVs of the fragment in em_reasm_entry_t::tlvs
+    unsigned int len;
+} em_reasm_frag_t;
+
+typedef struct {
+    bool in_use;
+    mac_address_t src;
+    unsigned short msg_id;
+    unsigned short type;        // network byte order, as in the CMDU
+    unsigned char hdr[sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)];   // headers of fragment 0, once it arrived
+    unsigned char *tlvs;
+    unsigned int len;
+    unsigned int cap;
+    uint64_t frags;             // bit per fragment id received
+    int last_frag_id;           // -1 until the fragment with the last fragment flag arrives
+    unsigned int num_frags;
+    em_reasm_frag_t frag[EM_REASM_MAX_FRAGS];
+    uint64_t first_us;
+} em_reasm_entry_t;
+
+typedef struct {
+    unsigned int completed;
+    unsigned int timeouts;
+    unsigned int quota_evictions;   // messages dropped to make room for newer ones
+    unsigned int dropped_frags;     // duplicate, inconsistent or malformed fragments
+} em_reasm_stats_t;
+
+/*
+ * Reassembles fragmented CMDUs keyed by source MAC and message id. Fragments are
+ * copied out of their receive buffers as they arrive so that pending messages do
+ * not hold ring buffers, complete messages are handed out in a single receive
+ * buffer with the headers of fragment 0. Not thread safe, the listener thread owns it.
+ */
+class em_cmdu_reasm_t {
+
+    em_frame_ring_t *m_ring;
+    em_reasm_entry_t m_entries[EM_REASM_MAX_ENTRIES];
+    unsigned int m_num_entries;
+    unsigned int m_bytes;
+    unsigned int m_peer_quota;
+    unsigned int m_max_bytes;
+    uint64_t m_timeout_us;
+    em_reasm_stats_t m_stats;
+    em_lat_hist_t m_lat;            // first fragment to complete message
+
+    /**!
+     * @brief Finds the entry of a message, optionally taking a free one.
+     *
+     * @param[in] src Source MAC address.
+     * @param[in] msg_id Message id in network byte order.
+     * @param[in] create Whether a free entry is taken when none matches.
+     *
+     * @returns Pointer to the entry, NULL if none matches and none could be taken.
+     */
+    em_reasm_entry_t *find_entry(mac_address_t src, unsigned short msg_id, bool create);
+
+    /**!
+     * @brief Releases an entry and its buffer.
+     *
+     * @param[in] entry Pointer to the entry.
+     */
+    void free_entry(em_reasm_entry_t *entry);
+
+    /**!
+     * @brief Returns the oldest entry, optionally only among those of one source.
+     *
+     * @param[in] src Source MAC address, NULL for any source.
+     * @param[in] skip Entry that must not be returned, may be NULL.
+     */
+    em_reasm_entry_t *get_oldest(mac_address_t src, em_reasm_entry_t *skip);
+
+    /**!
+     * @brief Returns the bytes held by the entries of one source.
+     *
+     * @param[in] src Source MAC address.
+     */
+    unsigned int get_peer_bytes(mac_address_t src);
+
+    /**!
+     * @brief Makes room for len more bytes in an entry, evicting older messages over the quotas.
+     *
+     * @param[in] entry Pointer to the entry that grows.
+     * @param[in] len Number of bytes needed.
+     *
+     * @returns 0 on success, -1 if the entry can not grow.
+     */
+    int reserve(em_reasm_entry_t *entry, unsigned int len);
+
+    /**!
+     * @brief Copies a complete message into a receive buffer and releases its entry.
+     *
+     * @param[in] entry Pointer to the entry.
+     * @param[out] len Length of the message.
+     *
+     * @returns Pointer to the buffer, NULL if no buffer could be taken.
+     */
+    em_rx_buff_t *assemble(em_reasm_entry_t *entry, unsigned int *len);
+
+    /**!
+     * @brief Returns the length of the TLVs of a fragment up to the end of message TLV or
+     * the last complete TLV.
+     *
+     * @param[in] tlvs Pointer to the TLVs.
+     * @param[in] len Length of the buffer holding the TLVs.
+     * @param[in] keep_eom Whether the end of message TLV is part of the result.
+     */
+    static unsigned int get_tlvs_len(unsigned char *tlvs, unsigned int len, bool keep_eom);
+
+public:
+
+    /**!
+     * @brief Sets the ring complete messages are taken from.
+     *
+     * @param[in] ring Pointer to the ring.
+     */
+    void init(em_frame_ring_t *ring) { m_ring = ring; }
+
+    /**!
+     * @brief Takes a received frame and returns the message to process, if any.
+     *
+     * Unfragmented frames are returned as is. Fragments are copied and released, the
+     * message is returned once its last fragment is in. Pending messages older than
+     * the timeout are dropped first.
+     *
+     * @param[in] buff Receive buffer holding the frame, owned by the reassembler from now on.
+     * @param[in,out] len Length of the frame, set to the length of the returned message.
+     * @param[in] now_us Current time in microseconds, see em_lat_hist_t::get_time_us().
+     *
+     * @returns Buffer holding a complete message, NULL if there is nothing to process yet.
+     */
+    em_rx_buff_t *add(em_rx_buff_t *buff, unsigned int *len, uint64_t now_us);
+
+    /**!
+     * @brief Drops the pending messages whose first fragment is older than the timeout.
+     *
+     * @param[in] now_us Current time in microseconds.
+     *
+     * @returns Number of messages dropped.
+     */
+    unsigned int expire(uint64_t now_us);
+
+    /**!
+     * @brief Drops all pending messages.
+     */
+    void flush();
+
+    /**!
+     * @brief Overrides the limits, mainly for tests.
+     *
+     * @param[in] peer_quota Bytes of pending fragments per source.
+     * @param[in] max_bytes Bytes of pending fragments in total.
+     * @param[in] timeout_us Time a message may take to complete.
+     */
+    void set_limits(unsigned int peer_quota, unsigned int max_bytes, uint64_t timeout_us);
+
+    /**!
+     * @brief Returns the number of messages waiting for fragments.
+     */
+    unsigned int get_pending() { return m_num_entries; }
+
+    /**!
+     * @brief Returns the bytes held by pending messages.
+     */
+    unsigned int get_pending_bytes() { return m_bytes; }
+
+    /**!
+     * @brief Returns the reassembly counters.
+     */
+    em_reasm_stats_t *get_stats() { return &m_stats; }
+
+    /**!
+     * @brief Returns the histogram of the time from the first fragment to the complete message.
+     */
+    em_lat_hist_t *get_latency() { return &m_lat; }
+
+    /**!
+     * @brief Constructor for em_cmdu_reasm_t.
+     */
+    em_cmdu_reasm_t();
+
+    /**!
+     * @brief Destructor for em_cmdu_reasm_t.
+     */
+    ~em_cmdu_reasm_t();
+};
+
+#endif
@@ -0,0 +1,198 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_COLOR_PLANNER_H
+#define EM_COLOR_PLANNER_H
+
+#include <pthread.h>
+#include "em_base.h"
+#include "em_hex.h"
+
+#include <vector>
+#include <unordered_map>
+
+#define EM_COLOR_PLANNER_MAX_COLOR      63      // BSS colors are 1 to 63, 0 is none
+#define EM_COLOR_PLANNER_PEER_COST      100     // per unit of edge weight, a mesh peer on the channel with the color
+#define EM_COLOR_PLANNER_HIDDEN_COST    25      // per unit of edge weight, a peer of a peer on the channel with the color
+#define EM_COLOR_PLANNER_FOREIGN_COST   2000    // a BSS outside the mesh heard on the channel with the color
+#define EM_COLOR_PLANNER_SWITCH_COST    500     // moving a radio off its color, its STAs see a BSS Color Change
+#define EM_COLOR_PLANNER_MAX_MOVES      4       // color changes per radio and plan, bounds the local search
+
+typedef struct {
+    unsigned int    peer;           // node index
+    unsigned int    weight;         // how loud the two radios hear each other
+} em_color_planner_edge_t;
+
+typedef struct {
+    mac_address_t   ruid;
+    unsigned char   op_class;
+    unsigned char   channel;        // operating channel, the radios of another channel do not collide
+    unsigned char   current;        // color reported by the radio, 0 if none
+    unsigned char   color;          // planned color, 0 until planned
+    unsigned long long  heard;      // bit n set if the radio reported a neighbor BSS with color n in use
+    unsigned long long  scanned;    // bit n set if a scan of the channel heard a BSS outside the mesh with color n
+    bool            dirty;          // its report, scans or edges changed since the last plan
+    unsigned int    moves;          // color changes in the current plan
+    std::vector<em_color_planner_edge_t>   edges;
+    std::vector<em_packed_mac_t>   bss;        // BSSIDs of the radio
+} em_color_planner_node_t;
+
+typedef struct {
+    unsigned char   color;
+    bool            srg_valid;                  // the SRG bitmaps below are worth sending
+    unsigned char   srg_color_bitmap[8];        // colors of the mesh peers on the channel
+    unsigned char   srg_bssid_bitmap[8];        // BSSID bits 39 to 44 of the BSSs of those peers
+} em_color_plan_t;
+
+typedef struct {
+    unsigned long long  plans;
+    unsigned long long  moves;          // color changes made by the local search
+    unsigned int        last_evaluated; // radios evaluated by the last plan
+    unsigned int        reports;        // Spatial Reuse Reports that changed a radio
+} em_color_planner_stats_t;
+
+/*
+ * Controller planning of the BSS colors and spatial reuse groups of the mesh radios. Each
+ * radio is a node on its operating channel, its Spatial Reuse Report gives its color and
+ * the colors its neighbors use, and a Channel Scan Result of the radio that hears a BSS of
+ * another mesh radio adds an edge weighted by the signal strength. The cost of a color for
+ * a radio is the weight of its peers on the channel with that color, a lower weight for
+ * the peers of its peers that its STAs may hear but it does not, any BSS outside the mesh
+ * heard with the color and a penalty for leaving the color the radio has. A report or scan
+ * that changes a radio marks it dirty and the next plan starts a local search from the
+ * dirty radios, a radio that moves puts its peers back in the search. The spatial reuse
+ * group of a radio is its mesh peers on the channel, their colors and BSSIDs. Thread safe.
+ */
+class em_color_planner_t {
+
+    pthread_mutex_t m_lock;
+    em_color_planner_stats_t m_stats;
+    std::vector<em_color_planner_node_t> m_nodes;
+    std::unordered_map<em_packed_mac_t, unsigned int> m_radios;     // radio unique identifier to node
+    std::unordered_map<em_packed_mac_t, unsigned int> m_bss;        // BSSID to the node of its radio
+
+    /**!
+     * @brief Returns the node index of a radio, added if it is not known.
+     */
+    unsigned int get_node(const unsigned char *ruid);
+
+    /**!
+     * @brief Returns the color a node has in the plan, the reported one until it is planned.
+     */
+    unsigned char get_color(const em_color_planner_node_t *node) { return (node->color != 0) ? node->color:node->current; }
+
+    /**!
+     * @brief Returns the colors a node hears from outside the mesh.
+     *
+     * The colors of its report that none of its peers on the channel has are taken as foreign.
+     */
+    unsigned long long get_foreign(unsigned int node);
+
+    /**!
+     * @brief Returns the cost of a color for a node, given the colors of its peers.
+     */
+    unsigned long long color_cost(unsigned int node, unsigned char color, unsigned long long foreign);
+
+    /**!
+     * @brief Adds or raises the edge between two nodes, on both of them.
+     */
+    void set_edge(unsigned int a, unsigned int b, unsigned int weight);
+
+public:
+
+    /**!
+     * @brief Returns the edge weight of a signal strength in dBm.
+     */
+    static unsigned int get_signal_weight(signed char signal_strength);
+
+    /**!
+     * @brief Returns the bit of a BSSID in a partial BSSID bitmap, from its bits 39 to 44.
+     */
+    static unsigned int get_partial_bssid_bit(const unsigned char *bssid);
+
+    /**!
+     * @brief Takes the Spatial Reuse Report of a radio.
+     *
+     * @param[in] ruid Radio unique identifier.
+     * @param[in] op_class Operating class of the radio.
+     * @param[in] channel Operating channel of the radio.
+     * @param[in] color BSS color reported.
+     * @param[in] heard Neighbor BSS color in use bitmap of the report, 8 octets, bit 0 of octet 0 is color 0.
+     *
+     * @returns True if the radio changed and is planned again.
+     */
+    bool set_report(const unsigned char *ruid, unsigned char op_class, unsigned char channel, unsigned char color,
+                    const unsigned char *heard);
+
+    /**!
+     * @brief Maps a BSSID to its radio, for the scan results that hear it and the SRG bitmaps.
+     */
+    void add_bss(const unsigned char *bssid, const unsigned char *ruid);
+
+    /**!
+     * @brief Takes the neighbors of a Channel Scan Result of a radio.
+     *
+     * The mesh BSSs of the result raise the edges to their radios. The colors of the BSSs
+     * outside the mesh replace the foreign colors of the radio if the scan is of its
+     * operating channel.
+     *
+     * @returns Number of edges raised, -1 if the scanner radio is not known.
+     */
+    int add_scan_result(const em_scan_result_t *res);
+
+    /**!
+     * @brief Plans the colors.
+     *
+     * @param[in] full true to plan all radios, false to start from the dirty ones.
+     *
+     * @returns Number of radios whose planned color changed.
+     */
+    unsigned int plan(bool full);
+
+    /**!
+     * @brief Returns the planned color and spatial reuse group of a radio.
+     *
+     * @returns True if the radio is planned.
+     */
+    bool get_plan(const unsigned char *ruid, em_color_plan_t *plan);
+
+    /**!
+     * @brief Returns the number of collisions, pairs of peers on a channel with the same color.
+     */
+    unsigned int get_collisions();
+
+    /**!
+     * @brief Returns the counters.
+     */
+    em_color_planner_stats_t get_stats();
+
+    /**!
+     * @brief Constructor for em_color_planner_t.
+     */
+    em_color_planner_t();
+
+    /**!
+     * @brief Destructor for em_color_planner_t.
+     */
+    ~em_color_planner_t();
+
+    em_color_planner_t(const em_color_planner_t&) = delete;
+    em_color_planner_t& operator=(const em_color_planner_t&) = delete;
+};
+
+#endif
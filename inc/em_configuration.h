@@ -21,11 +21,83 @@
 
 #include "em_base.h"
 #include "em_crypto.h"
+#include "em_crypto_pool.h"
 #include "dm_easy_mesh.h"
 #include "ec_manager.h"
+#include "em_ap_mld_sync.h"
+
+#include <atomic>
+#include <vector>
 
 class em_cmd_t;
 class em_mgr_t;
+class em_configuration_t;
+
+// copy of what the WSC key derivation of one M1 needs, so that it can run on the crypto pool
+struct em_wsc_keys_job_t {
+    em_crypto_job_t job;                // first member, the pool hands back &job
+    em_configuration_t *cfg;
+    unsigned short msg_id;              // of the M1, echoed by the M2
+    unsigned char remote_pub[DH_KEY_SZ];
+    unsigned short pub_len;
+    unsigned char local_priv[DH_KEY_SZ];
+    unsigned short priv_len;
+    em_nonce_t e_nonce;
+    mac_address_t e_mac;
+    em_nonce_t r_nonce;
+    unsigned char keys[WPS_AUTHKEY_LEN + WPS_KEYWRAPKEY_LEN + WPS_EMSK_LEN];
+    // Encrypted Settings of each haul, plain on submit, sealed with the keys by the worker
+    unsigned char plain[em_haul_type_max][MAX_EM_BUFF_SZ];
+    unsigned int plain_len[em_haul_type_max];
+    unsigned char enc[em_haul_type_max][MAX_EM_BUFF_SZ + 2 * AES_BLOCK_SIZE];
+    unsigned int enc_len[em_haul_type_max];
+};
+#define EM_TOPO_RESP_MAX_BSS    (EM_MAX_RADIO_PER_AGENT * EM_MAX_BSS_PER_RADIO)
+#define EM_TOPO_NOTIF_DEBOUNCE_MS   500     // client events within this window go in one Topology Notification
+#define EM_TOPO_NOTIF_MAX_EVENTS    32      // Client Association Event TLVs per Topology Notification
+
+typedef struct {
+    mac_address_t   sta;
+    bssid_t         bssid;
+    bool            assoc;
+} em_topo_notif_event_t;
+
+// one BSS of a Topology Response, merged from the operational BSS TLVs that list it
+typedef struct {
+    mac_address_t   ruid;
+    mac_address_t   bssid;
+    ssid_t          ssid;
+    bool            operational;        // listed by the AP Operational BSS TLV
+    bool            vendor;             // listed by the vendor operational BSS TLV
+    em_haul_type_t  haul_type;
+    em_vap_mode_t   vap_mode;
+} em_topo_resp_bss_t;
+
+// a Topology Response decoded and checked before any of it reaches the data model
+typedef struct {
+    em_profile_type_t   profile;
+    unsigned int        num_bss;
+    em_topo_resp_bss_t  bss[EM_TOPO_RESP_MAX_BSS];
+    bool                bsta_present;
+    em_bh_sta_radio_cap_t   bsta;
+    const em_ap_mld_config_t *ap_mld;   // in the message, NULL if there is no AP MLD Configuration TLV
+} em_topo_resp_t;
+
+#define EM_WSC_ATTR_INDEX_SZ    (attr_id_primary_device_type - attr_id_ap_channel + 1)
+
+// where each WSC attribute of a message is, by attribute id from attr_id_ap_channel
+typedef struct {
+    unsigned short  offset;             // of the value in the message, 0 if the attribute is not in it
+    unsigned short  len;
+} em_wsc_attr_ref_t;
+
+typedef struct {
+    unsigned char       *buff;
+    unsigned int        len;
+    unsigned int        num;            // attributes in the message, including the ones not indexed
+    em_wsc_attr_ref_t   attr[EM_WSC_ATTR_INDEX_SZ];
+} em_wsc_attr_index_t;
+
 class em_configuration_t {
 
     
@@ -86,6 +158,7 @@ class em_configuration_t {
 	 *
 	 * @param[out] buff Pointer to the buffer where the generated message will be stored.
 	 * @param[in] msg_id The message ID of the original request being responded to.
+	 * @param[in] job Keys job holding the Encrypted Settings sealed on the crypto pool, NULL to encrypt them here.
 	 *
 	 * @returns int Status code indicating success or failure of the message creation.
 	 * @retval 0 on success.
@@ -93,7 +166,44 @@ class em_configuration_t {
 	 *
 	 * @note Ensure that the buffer is adequately sized to hold the generated message.
 	 */
-	int create_autoconfig_wsc_m2_msg(unsigned char *buff, unsigned short msg_id);
+	int create_autoconfig_wsc_m2_msg(unsigned char *buff, unsigned short msg_id, const em_wsc_keys_job_t *job = NULL);
+
+	/**!
+	 * @brief Builds and sends the WSC M2 answering an M1, once the keys are computed.
+	 *
+	 * @param[in] msg_id The message ID of the M1.
+	 * @param[in] job Keys job holding the Encrypted Settings sealed on the crypto pool, NULL to encrypt them here.
+	 *
+	 * @returns int
+	 * @retval 0 on success
+	 * @retval -1 on failure
+	 */
+	int send_autoconfig_wsc_m2(unsigned short msg_id, const em_wsc_keys_job_t *job = NULL);
+
+	/**!
+	 * @brief Queues the key derivation of the M1 just parsed on the crypto pool.
+	 *
+	 * @param[in] msg_id The message ID of the M1.
+	 *
+	 * @returns int
+	 * @retval 0 if queued, the M2 is sent by resume_wsc_keys_job()
+	 * @retval -1 if the keys must be computed by the caller
+	 */
+	int submit_wsc_keys_job(unsigned short msg_id);
+
+	/**!
+	 * @brief Derives the WSC keys of an M1 and seals the Encrypted Settings with them, run on a crypto worker.
+	 *
+	 * @param[in] job Pointer to the em_wsc_keys_job_t.
+	 */
+	static void run_wsc_keys_job(em_crypto_job_t *job);
+
+	/**!
+	 * @brief Sends the M2 with the keys derived by run_wsc_keys_job(), run on the thread of the em.
+	 *
+	 * @param[in] job Pointer to the em_wsc_keys_job_t.
+	 */
+	static void resume_wsc_keys_job(em_crypto_job_t *job);
     
 	/**!
 	 * @brief Creates a BSS configuration request message.
@@ -466,6 +576,85 @@ class em_configuration_t {
 	 * @note Ensure that the MAC address and BSSID are valid before calling this function.
 	 */
 	int send_topology_notification_by_client(mac_address_t sta, bssid_t bssid, bool assoc);
+
+	/**!
+	 * @brief Sends one topology notification carrying a Client Association Event TLV per event.
+	 *
+	 * @param[in] events Client association events, at most EM_TOPO_NOTIF_MAX_EVENTS.
+	 * @param[in] num Number of events.
+	 *
+	 * @returns Length of the message sent, -1 on failure.
+	 */
+	int send_topology_notification(const em_topo_notif_event_t *events, unsigned int num);
+
+	/**!
+	 * @brief Queues a client association event for the next topology notification.
+	 *
+	 * A later event of the same STA and BSSID replaces the pending one. A full queue is
+	 * sent at once.
+	 *
+	 * @param[in] sta The MAC address of the station.
+	 * @param[in] bssid The BSSID of the network.
+	 * @param[in] assoc true if the STA associated, false if it left.
+	 */
+	void queue_topology_notification(mac_address_t sta, bssid_t bssid, bool assoc);
+
+	/**!
+	 * @brief Sends the queued client association events in one topology notification.
+	 *
+	 * Unless forced, nothing is sent until EM_TOPO_NOTIF_DEBOUNCE_MS after the last
+	 * notification, so that a burst of events goes in a single message.
+	 *
+	 * @param[in] force true to send regardless of the window.
+	 *
+	 * @returns Number of events sent.
+	 */
+	unsigned int flush_topology_notifications(bool force = false);
+
+	/**!
+	 * @brief Returns true if client association events wait for flush_topology_notifications().
+	 */
+	bool has_queued_topology_notifications() { return m_num_topo_notif_events != 0; }
+
+	/**!
+	 * @brief Asks for a Topology Query to the agent of a configured em, sent from its next tick.
+	 *
+	 * Called by the controller thread for the agents em_topo_sched_t hands out, the caller
+	 * wakes the em.
+	 */
+	void request_topology_query() { m_topo_query_requested = true; }
+
+	/**!
+	 * @brief Returns true if request_topology_query() was called since the last send.
+	 */
+	bool has_requested_topology_query() { return m_topo_query_requested.load(); }
+
+	/**!
+	 * @brief Sends the Topology Query asked by request_topology_query(), on the thread of the em.
+	 *
+	 * A query asked while the em is not configured is put back to the scheduler.
+	 */
+	void send_requested_topology_query();
+
+	/**!
+	 * @brief Asks for the TID-to-link mappings of the data model to be pushed to the agent.
+	 *
+	 * Called by the controller thread once it set the mappings with dm_tid_to_link_t::set_mapping(),
+	 * the caller wakes the em. The mappings are not touched again by the controller until sent.
+	 */
+	void request_tid_to_link_map_policy() { m_t2lm_requested = true; }
+
+	/**!
+	 * @brief Returns true if request_tid_to_link_map_policy() was called since the last send.
+	 */
+	bool has_requested_tid_to_link_map_policy() { return m_t2lm_requested.load(); }
+
+	/**!
+	 * @brief Sends the mappings asked by request_tid_to_link_map_policy() in a Policy Config Request, on the thread of the em.
+	 *
+	 * The mappings of the data model are cleared once encoded.
+	 */
+	void send_requested_tid_to_link_map_policy();
     
 	/**!
 	 * @brief Sends a BSTA MLD configuration request message.
@@ -773,47 +962,79 @@ class em_configuration_t {
 	 * @param[in] len Length of the data in the buffer.
 	 *
 	 * @returns int Status code indicating success or failure.
-	 * @retval 0 on success.
-	 * @retval -1 on failure.
+	 * @returns int Number of data model objects the response changed, -1 on failure.
 	 *
-	 * @note Ensure the buffer is properly allocated and the length is correct before calling this function.
+	 * @note The whole response is decoded by parse_topology_response() first, a response that
+	 * fails leaves the data model untouched.
 	 */
 	int handle_topology_response(unsigned char *buff, unsigned int len);
-    
+
 	/**!
-	 * @brief Handles topology notifications.
+	 * @brief Decodes a Topology Response into a staging structure, without touching the data model.
 	 *
-	 * This function processes the topology notification received in the buffer.
+	 * @param[in] buff Pointer to the message, starting with the raw header.
+	 * @param[in] len Length of the message.
+	 * @param[out] resp Decoded response.
 	 *
-	 * @param[in] buff Pointer to the buffer containing the notification data.
-	 * @param[in] len Length of the data in the buffer.
+	 * @returns int
+	 * @retval 0 on success
+	 * @retval -1 if the message is truncated or misses a mandatory TLV
+	 */
+	int parse_topology_response(unsigned char *buff, unsigned int len, em_topo_resp_t *resp);
+
+	/**!
+	 * @brief Applies the difference between a decoded Topology Response and the data model.
 	 *
-	 * @returns int Status code indicating success or failure.
-	 * @retval 0 on success.
-	 * @retval -1 on failure.
+	 * Only the BSSs and the device whose values changed are marked for the DB update.
 	 *
-	 * @note Ensure the buffer is properly allocated and the length is correct before calling this function.
+	 * @param[in] resp Response decoded by parse_topology_response().
+	 * @param[in] src_al_mac AL MAC address of the agent.
+	 *
+	 * @returns int Number of objects changed, -1 if the new BSSs do not fit, nothing is applied then.
 	 */
-	int handle_topology_notification(unsigned char *buff, unsigned int len);
-	int handle_bsta_radio_cap(unsigned char *buff, unsigned int len);
+	int apply_topology_response(const em_topo_resp_t *resp, const unsigned char *src_al_mac);
 
 	/**!
-	 * @brief Handles the operational BSS for the access point.
+	 * @brief Checks that the AP MLDs of an AP MLD Configuration TLV fit in it.
 	 *
-	 * This function processes the buffer containing BSS information and performs
-	 * necessary operations based on the data provided.
+	 * @param[in] buff Value of the TLV.
+	 * @param[in] len Length of the value.
 	 *
-	 * @param[in] buff Pointer to the buffer containing BSS data.
-	 * @param[in] len Length of the buffer.
+	 * @returns True if the TLV can be applied.
+	 */
+	static bool check_ap_mld_config(const unsigned char *buff, unsigned int len);
+
+	/**!
+	 * @brief Applies the AP MLDs of an AP MLD Configuration TLV that differ from the data model.
+	 *
+	 * The AP MLDs are matched by MLD MAC address, the ones the TLV no longer lists are removed.
+	 *
+	 * @param[in] conf AP MLD Configuration TLV checked by check_ap_mld_config().
+	 *
+	 * @returns Number of AP MLDs and BSSs changed.
+	 */
+	unsigned int apply_ap_mld_config(const em_ap_mld_config_t *conf);
+
+	/**!
+	 * @brief Returns the staged BSS of a radio, added if it is not staged yet, NULL if the staging is full.
+	 */
+	static em_topo_resp_bss_t *stage_topology_bss(em_topo_resp_t *resp, const unsigned char *ruid, const unsigned char *bssid);
+    
+	/**!
+	 * @brief Handles topology notifications.
+	 *
+	 * This function processes the topology notification received in the buffer.
+	 *
+	 * @param[in] buff Pointer to the buffer containing the notification data.
+	 * @param[in] len Length of the data in the buffer.
 	 *
 	 * @returns int Status code indicating success or failure.
 	 * @retval 0 on success.
 	 * @retval -1 on failure.
 	 *
-	 * @note Ensure that the buffer is properly allocated and the length is correctly set
-	 * before calling this function.
+	 * @note Ensure the buffer is properly allocated and the length is correct before calling this function.
 	 */
-	int handle_ap_operational_bss(unsigned char *buff, unsigned int len);
+	int handle_topology_notification(unsigned char *buff, unsigned int len);
     
 	/**!
 	 * @brief Handles the BSS configuration report.
@@ -862,6 +1083,19 @@ class em_configuration_t {
 	 * @note Ensure that the buffer is properly allocated and the length is correctly specified.
 	 */
 	int handle_ack_msg(unsigned char *buff, unsigned int len);
+
+	/**!
+	 * @brief Tells whether a 1905 ACK acknowledges an AP MLD Configuration Request of this node.
+	 *
+	 * The ACK is matched on its message id, so that it reaches handle_ack_msg() whatever
+	 * the state of the node is when it arrives.
+	 *
+	 * @param[in] buff Pointer to the buffer containing the message.
+	 * @param[in] len Length of the message in the buffer.
+	 *
+	 * @returns True if the ACK is for a pending AP MLD Configuration Request.
+	 */
+	bool is_ap_mld_ack(unsigned char *buff, unsigned int len);
    
 
 	/**!
@@ -954,17 +1188,6 @@ class em_configuration_t {
 	 */
 	int handle_ap_mld_config_resp(unsigned char *buff, unsigned int len);
 	
-	/**!
-	 * @brief Handles the operational BSS for the AP vendor.
-	 *
-	 * This function processes the given value and length to manage the operational BSS.
-	 *
-	 * @param[in] value Pointer to the data representing the operational BSS.
-	 * @param[in] len Length of the data pointed by value.
-	 *
-	 * @note Ensure that the value is not null and len is valid to avoid undefined behavior.
-	 */
-	void handle_ap_vendor_operational_bss(unsigned char *value, unsigned int len);
 
     
 	/**!
@@ -985,12 +1208,13 @@ class em_configuration_t {
 	 *
 	 * @param[in] buff Pointer to the buffer where the message will be created.
 	 * @param[in] haul_type The type of haul for which the message is being created.
+	 * @param[in] job Keys job holding the Encrypted Settings sealed on the crypto pool, NULL to encrypt them here.
 	 *
 	 * @returns The length of the created message as an unsigned short.
 	 *
 	 * @note Ensure that the buffer is properly allocated and the haul type is valid before calling this function.
 	 */
-	unsigned short create_m2_msg(unsigned char *buff, em_haul_type_t haul_type);
+	unsigned short create_m2_msg(unsigned char *buff, em_haul_type_t haul_type, const em_wsc_keys_job_t *job = NULL);
     
 	/**!
 	 * @brief Creates a traffic separation policy.
@@ -1177,6 +1401,17 @@ class em_configuration_t {
 	 * @note This function does not take any parameters and returns a pointer to the manager.
 	 */
 	virtual em_mgr_t *get_mgr() = 0;
+
+	/**!
+	 * @brief Hands a key agreement job to the crypto pool, its resume callback runs on the thread of this em.
+	 *
+	 * @param[in] job Pointer to the job, run and resume must be set.
+	 *
+	 * @returns int
+	 * @retval 0 if the job was queued
+	 * @retval -1 if the pool is not running or full, the caller runs the computation itself
+	 */
+	virtual int submit_crypto_job(em_crypto_job_t *job) = 0;
     
 	/**!
 	 * @brief Retrieves the EC Manager instance.
@@ -1571,6 +1806,16 @@ private:
     unsigned char m_m2_encrypted_settings[em_haul_type_max][MAX_EM_BUFF_SZ];
     unsigned int m_m2_encrypted_settings_len[em_haul_type_max];
 
+    em_wsc_keys_job_t m_wsc_keys_job;
+    bool m_wsc_keys_pending;            // m_wsc_keys_job is on the crypto pool
+
+    em_topo_notif_event_t m_topo_notif_events[EM_TOPO_NOTIF_MAX_EVENTS];
+    unsigned int m_num_topo_notif_events;
+    unsigned long long m_topo_notif_sent_ms;    // time of the last topology notification
+    std::atomic<bool> m_topo_query_requested;   // set by the controller thread, see request_topology_query()
+    std::atomic<bool> m_t2lm_requested;         // set by the controller thread, see request_tid_to_link_map_policy()
+    em_ap_mld_sync_t m_ap_mld_sync;             // AP MLD Configuration sent to the agent and acknowledged by it
+
 public:
 
 	bool send_autoconf_search_ext_chirp(em_dpp_chirp_value_t *chirp, size_t hash_len);
@@ -1624,6 +1869,38 @@ public:
 	 */
 	static em_wsc_msg_type_t get_wsc_msg_type(unsigned char *buff, unsigned int len);
 
+	/**!
+	 * @brief Indexes the attributes of a WSC message in one pass.
+	 *
+	 * Only the first of repeated attributes is indexed, ids out of data_elem_attr_id_t are skipped.
+	 *
+	 * @param[in] buff WSC message, the value of a WSC TLV or the plain Encrypted Settings.
+	 * @param[in] len Length of the message.
+	 * @param[out] index Receives the offset and length of each attribute.
+	 *
+	 * @returns 0 on success, -1 if an attribute runs past the end of the message.
+	 */
+	static int index_wsc_attrs(unsigned char *buff, unsigned int len, em_wsc_attr_index_t *index);
+
+	/**!
+	 * @brief Returns the value of an attribute of an indexed WSC message, NULL if it is not in it.
+	 *
+	 * @param[in] index Index built by index_wsc_attrs().
+	 * @param[in] id Attribute id.
+	 * @param[out] len Receives the length of the value, may be NULL.
+	 */
+	static unsigned char *get_wsc_attr(const em_wsc_attr_index_t *index, data_elem_attr_id_t id, unsigned short *len);
+
+	/**!
+	 * @brief Returns the value of the next repeat of an attribute of an indexed WSC message, NULL if there is none.
+	 *
+	 * @param[in] index Index built by index_wsc_attrs().
+	 * @param[in] id Attribute id.
+	 * @param[in] prev Value returned for the previous repeat by get_wsc_attr() or this function.
+	 * @param[out] len Receives the length of the value, may be NULL.
+	 */
+	static unsigned char *get_next_wsc_attr(const em_wsc_attr_index_t *index, data_elem_attr_id_t id, unsigned char *prev, unsigned short *len);
+
     
 	/**!
 	* @brief Sends a topology query message.
@@ -1682,6 +1959,16 @@ public:
 	 * @note Ensure that the buffer is properly allocated before calling this function.
 	 */
 	int create_encrypted_settings(unsigned char *buff, em_haul_type_t haul_type);
+
+	/**!
+	 * @brief Writes the plain settings of a haul, the content of its Encrypted Settings before the key wrap.
+	 *
+	 * @param[out] plain Buffer of MAX_EM_BUFF_SZ bytes.
+	 * @param[in] haul_type The haul type.
+	 *
+	 * @returns Length of the settings, 0 if the radio or the haul has none.
+	 */
+	unsigned int create_settings_plain(unsigned char *plain, em_haul_type_t haul_type);
     
 	/**!
 	 * @brief Creates an authenticator using the provided buffer.
@@ -2074,6 +2361,32 @@ public:
 	 */
 	int compute_keys(unsigned char *remote_pub, unsigned short pub_len, unsigned char *local_priv, unsigned short priv_len);
 
+	/**!
+	 * @brief Derives the WSC authentication, key wrap and EMSK keys, only using what it is passed.
+	 *
+	 * @param[in] remote_pub Pointer to the remote public key.
+	 * @param[in] pub_len Length of the remote public key.
+	 * @param[in] local_priv Pointer to the local private key.
+	 * @param[in] priv_len Length of the local private key.
+	 * @param[in] e_nonce Enrollee nonce.
+	 * @param[in] e_mac Enrollee MAC address.
+	 * @param[in] r_nonce Registrar nonce.
+	 * @param[out] keys Buffer of WPS_AUTHKEY_LEN + WPS_KEYWRAPKEY_LEN + WPS_EMSK_LEN bytes.
+	 *
+	 * @returns int
+	 * @retval 1 on success
+	 * @retval -1 on failure
+	 */
+	static int derive_wsc_keys(unsigned char *remote_pub, unsigned short pub_len, unsigned char *local_priv, unsigned short priv_len,
+		unsigned char *e_nonce, unsigned char *e_mac, unsigned char *r_nonce, unsigned char *keys);
+
+	/**!
+	 * @brief Installs keys derived by derive_wsc_keys().
+	 *
+	 * @param[in] keys Buffer of WPS_AUTHKEY_LEN + WPS_KEYWRAPKEY_LEN + WPS_EMSK_LEN bytes.
+	 */
+	void set_wsc_keys(unsigned char *keys);
+
 	/**!
 	 * @brief Map authentication type hex value based on security mode string selected.
 	 *
@@ -2176,6 +2489,7 @@ public:
     em_crypto_t m_crypto;
     unsigned char m_auth_key[WPS_AUTHKEY_LEN];
     unsigned char m_key_wrap_key[WPS_KEYWRAPKEY_LEN];
+    em_wsc_seal_t m_wsc_seal;       // keyed by set_wsc_keys()
     unsigned char m_emsk[WPS_EMSK_LEN];
     unsigned int m_renew_tx_cnt;
     unsigned int m_topo_query_tx_cnt;
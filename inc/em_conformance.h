@@ -0,0 +1,211 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_CONFORMANCE_H
+#define EM_CONFORMANCE_H
+
+#include <string.h>
+#include <string>
+#include <vector>
+#include "em_base.h"
+#include "em_lat_hist.h"
+#include "em_tlv_writer.h"
+
+#define EM_CONFORMANCE_DEF_TIMEOUT_MS   1000
+// an answer of as many fragments as a message may be built of
+#define EM_CONFORMANCE_MAX_ANSWER_SZ    (EM_TLV_WRITER_MAX_FRAGS * EM_MAX_FRAME_SZ)
+
+typedef enum {
+    em_conformance_dst_multicast,   // 01:80:c2:00:00:13
+    em_conformance_dst_ctrl,        // AL MAC of the controller, given or learnt from its first answer
+} em_conformance_dst_t;
+
+// one TLV of a scripted message, the value is resolved when the message is built
+typedef struct {
+    em_tlv_type_t type;
+    std::vector<std::string> tokens;    // hex bytes, $al or $ctrl
+} em_conformance_tlv_t;
+
+typedef struct {
+    em_msg_type_t type;
+    em_conformance_dst_t dst;
+    std::vector<em_conformance_tlv_t> tlvs;
+    bool expect;
+    em_msg_type_t expect_type;
+    unsigned int timeout_ms;
+    bool match_id;                      // the answer carries the message id of the request
+} em_conformance_step_t;
+
+typedef struct {
+    unsigned int sent;
+    unsigned int answered;
+    unsigned int invalid;               // answered, but failed em_msg_t::validate()
+    unsigned int timeouts;
+    unsigned int errors;                // could not be built or sent
+    unsigned long long bytes;
+    unsigned long long elapsed_us;
+    unsigned long long cpu_ticks;       // user and system time of the controller
+} em_conformance_stats_t;
+
+typedef struct {
+    std::string name;
+    unsigned int iterations;
+    em_profile_type_t profile;
+    std::vector<em_conformance_step_t> steps;
+    em_conformance_stats_t stats;
+    em_lat_hist_t lat;
+} em_conformance_scenario_t;
+
+/*
+ * Scripted CMDU sequences for checking a controller end to end. A script holds one or
+ * more scenarios, each a list of messages sent to the controller and the answers
+ * expected back:
+ *
+ *     scenario topology
+ *     iterations 100
+ *     profile 2
+ *     send topo_query ctrl
+ *     expect topo_resp 500
+ *     send topo_notif ctrl
+ *     tlv 0x01 $al
+ *
+ * tlv lines add to the message of the send above them, the value is hex bytes with
+ * optional spaces, $al and $ctrl stand for the MAC addresses of the harness and the
+ * controller. Messages are named as in em_msg_type_t without the prefix or given as a
+ * number. The class only parses, builds and matches, the caller owns the socket.
+ */
+class em_conformance_t {
+
+    std::vector<em_conformance_scenario_t> m_scenarios;
+    mac_address_t m_al_mac;
+    mac_address_t m_ctrl_mac;
+    bool m_ctrl_known;
+
+    /**!
+     * @brief Parses one line of a script into the last scenario.
+     *
+     * @param[in] line The line, without comment.
+     * @param[out] err Receives the reason on failure.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    int parse_line(const std::string& line, std::string& err);
+
+    /**!
+     * @brief Resolves the value of a scripted TLV.
+     *
+     * @param[in] tlv The TLV.
+     * @param[out] value Receives the value.
+     * @param[in] max Size of value.
+     *
+     * @returns Length of the value, -1 if it does not fit or a variable is not known yet.
+     */
+    int resolve(const em_conformance_tlv_t& tlv, unsigned char *value, unsigned int max);
+
+public:
+
+    /**!
+     * @brief Parses a script and adds its scenarios.
+     *
+     * @param[in] text The script.
+     * @param[out] err Receives the line and the reason on failure.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    int parse(const char *text, std::string& err);
+
+    /**!
+     * @brief Reads and parses a script file.
+     *
+     * @param[in] path Path of the file.
+     * @param[out] err Receives the reason on failure.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    int load(const char *path, std::string& err);
+
+    /**!
+     * @brief Builds the message of a step.
+     *
+     * @param[in] step The step.
+     * @param[in] msg_id Message id to use.
+     * @param[out] writer Receives the frames of the message.
+     *
+     * @returns Number of frames, -1 on failure.
+     */
+    int build(const em_conformance_step_t& step, unsigned short msg_id, em_tlv_writer_t& writer);
+
+    /**!
+     * @brief Checks whether a received frame is the answer a step waits for.
+     *
+     * @param[in] step The step.
+     * @param[in] msg_id Message id of the request.
+     * @param[in] frame The frame, ethernet header included.
+     * @param[in] len Length of the frame.
+     *
+     * @returns True if it is a fragment of the expected answer.
+     */
+    bool match(const em_conformance_step_t& step, unsigned short msg_id, const unsigned char *frame, unsigned int len);
+
+    /**!
+     * @brief Returns the scenarios parsed so far.
+     */
+    std::vector<em_conformance_scenario_t>& get_scenarios() { return m_scenarios; }
+
+    /**!
+     * @brief Sets the AL MAC address the harness sends from.
+     */
+    void set_al_mac(const unsigned char *mac) { memcpy(m_al_mac, mac, sizeof(mac_address_t)); }
+
+    /**!
+     * @brief Sets the AL MAC address of the controller.
+     */
+    void set_ctrl_mac(const unsigned char *mac) { memcpy(m_ctrl_mac, mac, sizeof(mac_address_t)); m_ctrl_known = true; }
+
+    /**!
+     * @brief Checks whether the AL MAC address of the controller is known.
+     */
+    bool is_ctrl_known() { return m_ctrl_known; }
+
+    /**!
+     * @brief Looks up a message type by its name or number.
+     *
+     * @param[in] name The name, e.g. "topo_query", or a number, e.g. "0x0002".
+     * @param[out] type Receives the type.
+     *
+     * @returns 0 on success, -1 if the name is not known.
+     */
+    static int get_msg_type(const char *name, em_msg_type_t *type);
+
+    /**!
+     * @brief Returns the name of a message type, "unknown" if it has none.
+     */
+    static const char *get_msg_name(em_msg_type_t type);
+
+    /**!
+     * @brief Constructor for em_conformance_t.
+     */
+    em_conformance_t();
+
+    /**!
+     * @brief Destructor for em_conformance_t.
+     */
+    ~em_conformance_t();
+};
+
+#endif
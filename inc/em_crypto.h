@@ -74,24 +74,20 @@ private:
 
     
 	/**
-	 * @brief Helper function to compute a Diffie-Hellman shared secret using version-specific OpenSSL APIs.
+	 * @brief Helper function to compute a Diffie-Hellman shared secret in the 1536-bit MODP group.
 	 *
-	 * This function computes the shared secret based on the provided prime modulus, generator, local private key,
-	 * and remote public key. It allocates the output buffer for the shared secret within the function.
+	 * This function raises the remote public key to the local private key modulo the group prime,
+	 * converted once with its Montgomery context, using the BN_CTX kept by the calling thread.
+	 * It allocates the output buffer for the shared secret within the function.
 	 *
-	 * @param[in] p Prime modulus as BIGNUM.
-	 * @param[in] g Generator as BIGNUM.
-	 * @param[in] bn_priv Local private key as BIGNUM.
-	 * @param[in] bn_pub Remote public key as BIGNUM.
+	 * @param[in] bn_priv Local private key as BIGNUM, freed by the function.
+	 * @param[in] bn_pub Remote public key as BIGNUM, freed by the function.
 	 * @param[out] shared_secret Output buffer for computed shared secret (allocated within function).
 	 * @param[out] secret_len Length of computed shared secret.
 	 *
-	 * @return 1 on success, 0 on failure.
-	 *
-	 * @note For OpenSSL < 3.0: Uses legacy DH APIs.
-	 * @note For OpenSSL >= 3.0: Uses modern EVP APIs.
+	 * @return 1 on success, 0 on failure or if the public key is not in [2, p - 2].
 	 */
-	static uint8_t compute_secret_internal(BIGNUM *p, BIGNUM *g, BIGNUM *bn_priv,  BIGNUM *bn_pub, uint8_t **shared_secret, size_t *secret_len);
+	static uint8_t compute_secret_internal(BIGNUM *bn_priv,  BIGNUM *bn_pub, uint8_t **shared_secret, size_t *secret_len);
 public:
     static uint8_t g_dh1536_g[];
     static uint8_t g_dh1536_p[];
@@ -714,6 +710,38 @@ public:
 	 */
 	static EC_GROUP* get_key_group(const SSL_KEY* key);
 
+	/**
+	 * @brief Get the shared group of a curve
+	 *
+	 * The group is set up once per process with its generator multiples precomputed.
+	 *
+	 * @param[in] nid NID of the curve.
+	 *
+	 * @return Pointer to the group, NULL if the curve is not one DPP uses. It must not be freed or modified.
+	 */
+	static const EC_GROUP* get_curve_group(int nid);
+
+	/**
+	 * @brief Create a group of a curve
+	 *
+	 * Copies the shared group of the curve, with its precomputed table, if there is one.
+	 *
+	 * @param[in] nid NID of the curve.
+	 *
+	 * @return Pointer to the group, the caller is responsible for freeing it, NULL on failure.
+	 */
+	static EC_GROUP* new_curve_group(int nid);
+
+	/**
+	 * @brief Get the scratch BN_CTX of the calling thread
+	 *
+	 * Callers take their temporaries with BN_CTX_start()/BN_CTX_get() and release them
+	 * with BN_CTX_end() before returning.
+	 *
+	 * @return Pointer to the BN_CTX, it must not be freed. NULL if it could not be allocated.
+	 */
+	static BN_CTX* get_thread_bn_ctx();
+
     
 	/**
 	 * @brief Get the private key as a BIGNUM object
@@ -1203,6 +1231,90 @@ public:
 	~em_crypto_t() {}
 };
 
+/*
+ * Seals and opens WSC Encrypted Settings with the keys of one exchange. The AES key
+ * schedule and the HMAC key are set up once by set_keys(), every BSS entry of an M2
+ * then only sets its IV, where the per call primitives of em_crypto_t expand both keys
+ * again for each entry. Not thread safe, one per em or per crypto worker job.
+ */
+class em_wsc_seal_t {
+
+    EVP_CIPHER_CTX *m_enc;
+    EVP_CIPHER_CTX *m_dec;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    EVP_MAC *m_mac;
+    EVP_MAC_CTX *m_mac_ctx;
+#elif OPENSSL_VERSION_NUMBER >= 0x10100000L
+    HMAC_CTX *m_mac_ctx;
+#else
+    uint8_t m_auth_key[WPS_AUTHKEY_LEN];
+#endif
+    bool m_keyed;
+
+	/**!
+	 * @brief Computes the key wrap authenticator of plain settings with the auth key set.
+	 *
+	 * @returns 1 on success, 0 on failure.
+	 */
+	uint8_t authenticate(const uint8_t *plain, unsigned int plain_len, uint8_t *hash);
+
+public:
+
+	/**!
+	 * @brief Sets the keys, the contexts are created on first use and kept across keys.
+	 *
+	 * @param[in] auth_key WPS authentication key, WPS_AUTHKEY_LEN bytes.
+	 * @param[in] key_wrap_key WPS key wrap key, WPS_KEYWRAPKEY_LEN bytes.
+	 *
+	 * @returns 0 on success, -1 on failure, the seal is then left without keys.
+	 */
+	int set_keys(const uint8_t *auth_key, const uint8_t *key_wrap_key);
+
+	/**!
+	 * @brief Drops the keys, their schedules are wiped from the contexts.
+	 */
+	void clear();
+
+	/**!
+	 * @brief Returns true once set_keys() succeeded.
+	 */
+	bool is_keyed() const { return m_keyed; }
+
+	/**!
+	 * @brief Appends the key wrap authenticator to plain settings and encrypts them under a fresh IV.
+	 *
+	 * @param[in,out] plain Settings, followed by room for the authenticator attribute.
+	 * @param[in] plain_len Length of the settings.
+	 * @param[out] out IV followed by the encrypted settings, plain_len + 2 * AES_BLOCK_SIZE + 12 bytes at most.
+	 *
+	 * @returns Length written to out, 0 on failure.
+	 */
+	unsigned int seal(uint8_t *plain, unsigned int plain_len, uint8_t *out);
+
+	/**!
+	 * @brief Decrypts Encrypted Settings in place.
+	 *
+	 * @param[in,out] data IV followed by the encrypted settings, the settings are written after the IV.
+	 * @param[in] len Length of data, IV included.
+	 *
+	 * @returns Length of the settings at data + AES_BLOCK_SIZE, authenticator included, 0 on failure.
+	 */
+	unsigned int open(uint8_t *data, unsigned int len);
+
+	/**!
+	 * @brief Constructor for em_wsc_seal_t, no keys are set.
+	 */
+	em_wsc_seal_t();
+
+	/**!
+	 * @brief Destructor for em_wsc_seal_t.
+	 */
+	~em_wsc_seal_t();
+
+	em_wsc_seal_t(const em_wsc_seal_t&) = delete;
+	em_wsc_seal_t& operator=(const em_wsc_seal_t&) = delete;
+};
+
 
 // Custom deleters for OpenSSL objects to use with std::unique_ptr
 struct BIODeleter {
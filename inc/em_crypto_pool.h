@@ -0,0 +1,124 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_CRYPTO_POOL_H
+#define EM_CRYPTO_POOL_H
+
+#include <pthread.h>
+
+#define EM_CRYPTO_POOL_MAX_WORKERS  4
+#define EM_CRYPTO_POOL_QUEUE_SZ     1024    // jobs queued at the same time, further submits are refused
+
+struct em_crypto_job_t;
+
+typedef void (*em_crypto_job_cb_t)(em_crypto_job_t *job);
+
+/*
+ * One piece of key agreement work. run() is called on a crypto worker and must only use
+ * what the job holds, done() is called right after on the same worker and hands the job
+ * back to its owner, which calls resume() on its own thread.
+ */
+struct em_crypto_job_t {
+    em_crypto_job_cb_t run;
+    em_crypto_job_cb_t done;
+    em_crypto_job_cb_t resume;
+    void *owner;
+    int result;                 // set by run(), -1 if the job was never run
+    em_crypto_job_t *next;      // in the queue of the pool
+};
+
+/*
+ * Small set of threads the DH and ECDH computations of the onboarding state machines are
+ * offloaded to, so that the workers running the ems keep processing frames while many
+ * agents onboard at once. Jobs run in submit order, several at a time.
+ */
+class em_crypto_pool_t {
+
+    pthread_t m_tids[EM_CRYPTO_POOL_MAX_WORKERS];
+    unsigned int m_num;
+    pthread_mutex_t m_lock;             // protects the queue and m_exit
+    pthread_cond_t m_cond;
+    em_crypto_job_t *m_head;
+    em_crypto_job_t *m_tail;
+    unsigned int m_queued;
+    unsigned int m_high_watermark;
+    bool m_exit;
+
+    /**!
+     * @brief Main loop of a crypto worker.
+     */
+    void run();
+
+    /**!
+     * @brief Entry point of the crypto workers.
+     *
+     * @param[in] arg Pointer to the em_crypto_pool_t.
+     */
+    static void *worker_func(void *arg);
+
+public:
+
+    /**!
+     * @brief Starts the crypto workers.
+     *
+     * @param[in] num Number of workers, 0 for half of the online CPUs, at most EM_CRYPTO_POOL_MAX_WORKERS.
+     *
+     * @returns int
+     * @retval 0 on success
+     * @retval -1 on failure, no worker is left running
+     */
+    int init(unsigned int num);
+
+    /**!
+     * @brief Stops and joins the workers, jobs still queued are handed back with result -1.
+     */
+    void deinit();
+
+    /**!
+     * @brief Queues a job.
+     *
+     * @param[in] job Pointer to the job, run, done and owner must be set.
+     *
+     * @returns int
+     * @retval 0 if the job was queued, done() will be called once for it
+     * @retval -1 if the pool is not running or full, the caller keeps the job
+     */
+    int submit(em_crypto_job_t *job);
+
+    /**!
+     * @brief Returns the number of running workers, 0 if the pool is not started.
+     */
+    unsigned int get_num_workers() { return m_num; }
+
+    /**!
+     * @brief Returns the highest number of jobs queued at the same time.
+     */
+    unsigned int get_high_watermark() { return m_high_watermark; }
+
+    /**!
+     * @brief Constructor for em_crypto_pool_t.
+     */
+    em_crypto_pool_t();
+
+    /**!
+     * @brief Destructor for em_crypto_pool_t.
+     */
+    ~em_crypto_pool_t();
+};
+
+#endif
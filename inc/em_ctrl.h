@@ -25,6 +25,19 @@
 #include "em_orch_ctrl.h"
 #include "bus.h"
 #include "em_dev_test_ctrl.h"
+#include "em_topo_publisher.h"
+#include "em_steer_engine.h"
+#include "em_tid_link_planner.h"
+#include "em_chan_plan_optimiser.h"
+#include "em_route_table.h"
+#include "em_renew_sched.h"
+#include "em_mem_acct.h"
+#include "em_ha.h"
+
+#include <unordered_map>
+#include "em_intern.h"
+
+#define EM_CTRL_DM_COMMIT_PENDING_US    (10 * 1000000ULL)   // a repeated search after this issues the commit again
 
 #ifdef AL_SAP
 #define DATA_SOCKET_PATH "/tmp/al_data_socket"
@@ -42,6 +55,47 @@ class em_ctrl_t : public em_mgr_t {
     em_cmd_ctrl_t   *m_ctrl_cmd;
     em_orch_ctrl_t *m_orch;
 	em_dev_test_t dev_test;
+	em_topo_publisher_t m_topo_publisher;
+	unsigned int m_sta_link_metrics_slot;	// slot of the current 1s tick in the polling round
+	unsigned int m_sta_link_metrics_round;	// polling rounds so far
+	em_route_table_t m_route_table;
+	em_renew_sched_t m_renew_sched;
+	em_steer_engine_t m_steer_engine;
+	em_tid_link_planner_t m_tid_link_planner;
+	em_chan_plan_optimiser_t m_chan_plan_optimiser;
+	em_mem_acct_t m_mem_acct;
+	em_ha_t m_ha;
+	pthread_mutex_t m_commit_lock;
+	std::unordered_map<uint64_t, uint64_t> m_pending_commits;	// interned net id and AL MAC of the queued dm_commit, when queued
+
+	/**!
+	 * @brief Claims the dm_commit of a device, so that its repeated autoconfig searches queue it once.
+	 *
+	 * @param[in] info Network and AL MAC of the device.
+	 *
+	 * @returns True if the commit is to be queued, false if one is already pending.
+	 */
+	bool claim_dm_commit(em_commit_info_t *info);
+
+	/**!
+	 * @brief Releases the claim taken by claim_dm_commit() once the commit is handled.
+	 *
+	 * @param[in] info Network and AL MAC of the device.
+	 */
+	void release_dm_commit(em_commit_info_t *info);
+
+	/**!
+	 * @brief Returns the key of a device in m_pending_commits.
+	 */
+	static uint64_t get_commit_key(em_commit_info_t *info);
+
+	/**!
+	 * @brief Publishes a message of the network topology event.
+	 *
+	 * @param[in] msg Message built by the topology publisher.
+	 * @param[in] type Type of the message.
+	 */
+	void publish_topology_msg(const std::string& msg, em_topo_msg_type_t type);
 
 	/**!
 	 * @brief Handles a bus event.
@@ -70,6 +124,17 @@ public:
     static em_ctrl_t *get_em_ctrl_instance();
 
 	dm_easy_mesh_ctrl_t *get_dm_ctrl() { return &m_data_model; }
+
+	em_orch_ctrl_t *get_orch() { return m_orch; }
+
+	/**!
+	 * @brief Encodes the orchestrator latency histograms per command type and the step times per em.
+	 *
+	 * @param[in] parent JSON object receiving the "Commands" and "Agents" arrays.
+	 *
+	 * @note Must be called from the controller thread.
+	 */
+	void get_orch_stats(cJSON *parent);
     
 	/**!
 	 * @brief Listens for input events and processes them accordingly.
@@ -174,6 +239,11 @@ public:
 	 */
 	void handle_500ms_tick();
 
+	/**!
+	 * @brief Runs the orchestrator right away after a state change.
+	 */
+	void handle_orch_kick();
+
     
 	/**!
 	 * @brief Handles the dirty data management.
@@ -195,6 +265,19 @@ public:
 	 * @note Ensure that the event pointer is valid and properly initialized before calling this function.
 	 */
 	void handle_event(em_event_t *evt);
+
+	/**!
+	 * @brief Checks whether a queued event is made redundant by a later one.
+	 *
+	 * Commits of the same device and network are coalesced, since the commit handler
+	 * always works on the current state of the data model.
+	 *
+	 * @param[in] evt Pointer to the earlier event.
+	 * @param[in] next Pointer to a later event of the same batch.
+	 *
+	 * @returns True if handling next also covers evt, false otherwise.
+	 */
+	bool coalesce_event(em_event_t *evt, em_event_t *next);
     
 	/**!
 	 * @brief Handles the start of the DPP process.
@@ -376,6 +459,73 @@ public:
 	 * @note Ensure that the client metrics are correctly formatted before calling this function.
 	 */
 	void handle_client_metrics_req();
+
+	/**!
+	 * @brief Runs a pass of the steering engine, run on the 2s tick.
+	 *
+	 * Steering decisions are submitted as client steering commands, like the ones of a
+	 * northbound steering request, and STAs without a fresh target get a Beacon Metrics
+	 * Query from the em of their radio.
+	 */
+	void handle_steer_engine();
+
+	/**!
+	 * @brief Runs a pass of the TID-to-link planner over the STA MLDs, run on the 2s tick.
+	 *
+	 * The mappings that changed are set in the data model of the agent and pushed by a
+	 * configured em of the agent, the ones of a single AP MLD per agent and pass.
+	 */
+	void handle_tid_link_planner();
+
+	/**!
+	 * @brief Runs a pass of the backhaul steering over the agents, run on the 2s tick.
+	 *
+	 * An agent with a better parent gets a Backhaul Steering Request from a configured em of
+	 * the agent, the other agents are first asked to measure a backhaul STA without a fresh
+	 * measurement. Steers without a response are expired.
+	 */
+	void handle_bh_steer();
+
+	/**!
+	 * @brief Runs a cycle of the optimisation plugins, run on the 2s tick.
+	 *
+	 * The actions come ranked, within EM_OPTIMISER_BUDGET_US of CPU time. Steers are
+	 * submitted as client steering commands, unless the steering engine is backing off the
+	 * STA. Channel and power actions are only logged, the controller changes the channels
+	 * of a whole band through the northbound interface.
+	 */
+	void handle_optimiser();
+
+	/**!
+	 * @brief Measures the memory held for each agent and enforces the budgets, run on the 5s tick.
+	 *
+	 * An agent over its budget loses the cache rows of its STAs, then its oldest scan results.
+	 */
+	void handle_mem_acct();
+
+	/**!
+	 * @brief Creates the ems of the radios of the replicated data model, configured, after a takeover.
+	 *
+	 * The agents kept the configuration the primary gave them, so they are queried for their
+	 * topology instead of being asked to onboard again.
+	 */
+	void resume_nodes();
+
+	/**!
+	 * @brief Measures the memory held for one agent.
+	 *
+	 * @param[in] dm Data model of the agent.
+	 * @param[out] usage Receives the usage.
+	 */
+	void measure_agent_mem(dm_easy_mesh_t *dm, em_mem_acct_usage_t *usage);
+
+	/**!
+	 * @brief Asks the em of each agent due in em_topo_sched_t for a Topology Query, run on the 1s tick.
+	 *
+	 * The query goes out from a configured radio of the agent, an agent without radio em is
+	 * dropped from the schedule and one whose radios are all busy is deferred.
+	 */
+	void handle_topology_queries();
     
 	/**!
 	 * @brief Handles the retrieval of DM data.
@@ -387,6 +537,27 @@ public:
 	 * @note Ensure that the event structure is properly initialized before calling this function.
 	 */
 	void handle_get_dm_data(em_bus_event_t *evt);
+
+	/**!
+	 * @brief Handles the retrieval of the orchestrator latency statistics.
+	 *
+	 * @param[in] evt Pointer to the bus event, the statistics are returned in its subdoc.
+	 */
+	void handle_get_orch_stats(em_bus_event_t *evt);
+
+	/**!
+	 * @brief Handles the retrieval of the process wide performance counters.
+	 *
+	 * @param[in] evt Pointer to the bus event.
+	 */
+	void handle_get_perf_stats(em_bus_event_t *evt);
+
+	/**!
+	 * @brief Handles the retrieval of the memory held for each agent and of the budgets.
+	 *
+	 * @param[in] evt Pointer to the bus event.
+	 */
+	void handle_get_mem_stats(em_bus_event_t *evt);
     
 	/**!
 	 * @brief Handles the DM commit event.
@@ -479,16 +650,18 @@ public:
 	 * @brief Updates the network topology using the data model.
 	 *
 	 * This function calls the `update_network_topology` method on the `m_data_model` object
-	 * to refresh or modify the current network topology.
+	 * to refresh or modify the current network topology, then takes the backhaul routes of
+	 * the agents from it and stretches their topology query periods accordingly.
 	 *
 	 * @note Ensure that `m_data_model` is properly initialized before calling this function.
 	 */
-	void update_network_topology() { m_data_model.update_network_topology(); }
+	void update_network_topology();
 
 	/**!
 	 * @brief Publish the network topology using the data model.
 	 *
-	 * This function publishes the current network topology over the bus.
+	 * This function publishes the change of the network topology over the bus, as a patch
+	 * of the document published last or as a snapshot.
 	 *
 	 * @note Ensure that `m_data_model` is properly updated before calling this function.
 	 */
@@ -704,6 +877,50 @@ public:
 	 */
 	em_cmd_ctrl_t *get_ctrl_cmd() { return m_ctrl_cmd; }
 
+	/**!
+	 * @brief Retrieves the slot of the polling round whose agents are queried for STA link metrics.
+	 *
+	 * @returns The slot, below EM_STA_LINK_METRICS_POLL_SLOTS.
+	 */
+	unsigned int get_sta_link_metrics_slot() { return m_sta_link_metrics_slot; }
+
+	/**!
+	 * @brief Retrieves the number of STA link metrics polling rounds so far.
+	 *
+	 * An agent whose poll scale is n is only queried in every nth round, see em_route_table_t.
+	 */
+	unsigned int get_sta_link_metrics_round() { return m_sta_link_metrics_round; }
+
+	/**!
+	 * @brief Retrieves the backhaul routes of the agents.
+	 */
+	em_route_table_t *get_route_table() { return &m_route_table; }
+
+	/**!
+	 * @brief Retrieves the pacing of the mesh wide autoconfiguration renews.
+	 */
+	em_renew_sched_t *get_renew_sched() { return &m_renew_sched; }
+
+	/**!
+	 * @brief Retrieves the steering engine, for its parameters and counters.
+	 */
+	em_steer_engine_t *get_steer_engine() { return &m_steer_engine; }
+
+	/**!
+	 * @brief Retrieves the TID-to-link planner, for its parameters and counters.
+	 */
+	em_tid_link_planner_t *get_tid_link_planner() { return &m_tid_link_planner; }
+
+	/**!
+	 * @brief Retrieves the memory accounting of the agents, for its budgets and usage.
+	 */
+	em_mem_acct_t *get_mem_acct() { return &m_mem_acct; }
+
+	/**!
+	 * @brief Retrieves the active/standby replication of the controller.
+	 */
+	em_ha_t *get_ha() { return &m_ha; }
+
     
 	/**!
 	 * @brief Constructor for the em_ctrl_t class.
@@ -20,12 +20,22 @@
 #define EMDEVTEST_H
 
 #include "em_base.h"
+#include "dm_json_writer.h"
 #define DEV_TEST_COMMAND_COUNT 2
+#define DEV_TEST_ENCODE_RESERVE 64     // closing brackets and the em_list_next of a page
+class em_t;
 class em_dev_test_t {
 
+    // one entry of em_list, one test of dev_test
+    void encode_em(dm_json_writer_t& writer, em_t *em, bool testinprogress);
+    void encode_test(dm_json_writer_t& writer, int i, bool update);
+
 public:
     em_dev_test_info dev_test_info;
-    void encode(em_subdoc_info_t *subdoc, hash_map_t *m_em_map, bool update, bool autconfig_renew_status);
+    // streams the subdoc, the em_list from the non AL em at index start on and as many as
+    // fit the event, em_list_next is the index of the first one left out if any
+    void encode(em_subdoc_info_t *subdoc, hash_map_t *m_em_map, bool update, bool autconfig_renew_status,
+                unsigned int start = 0);
     void analyze_set_dev_test(em_bus_event_t *evt, hash_map_t *m_em_map);
     void decode(em_subdoc_info_t *subdoc, hash_map_t *m_em_map, const char *str);
     em_dev_test_t();
@@ -0,0 +1,126 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_EVENT_POOL_H
+#define EM_EVENT_POOL_H
+
+#include <pthread.h>
+#include "em_base.h"
+
+#define EM_EVENT_POOL_SMALL_DATA_SZ     1024
+#define EM_EVENT_POOL_MEDIUM_DATA_SZ    (4096*4)
+#define EM_EVENT_POOL_LARGE_DATA_SZ     EM_MAX_EVENT_DATA_LEN
+
+#define EM_EVENT_POOL_SMALL_CACHE       64
+#define EM_EVENT_POOL_MEDIUM_CACHE      16
+#define EM_EVENT_POOL_LARGE_CACHE       2
+
+typedef enum {
+    em_event_pool_class_small,
+    em_event_pool_class_medium,
+    em_event_pool_class_large,
+    em_event_pool_class_max
+} em_event_pool_class_t;
+
+typedef struct em_event_pool_blk {
+    em_event_pool_class_t cls;
+    struct em_event_pool_blk *next;
+} em_event_pool_blk_t;
+
+typedef struct {
+    unsigned int alloc;
+    unsigned int hit;
+    unsigned int cached;
+} em_event_pool_stats_t;
+
+class em_event_pool_t {
+
+    pthread_mutex_t m_lock;
+    em_event_pool_blk_t *m_free[em_event_pool_class_max];
+    em_event_pool_stats_t m_stats[em_event_pool_class_max];
+
+    /**!
+     * @brief Returns the payload capacity of a size class.
+     *
+     * @param[in] cls The size class.
+     *
+     * @returns Number of payload bytes an event of this class can hold.
+     */
+    static unsigned int class_data_size(em_event_pool_class_t cls);
+
+    /**!
+     * @brief Returns the maximum number of free blocks retained for a size class.
+     *
+     * @param[in] cls The size class.
+     *
+     * @returns Maximum number of cached blocks.
+     */
+    static unsigned int class_cache_size(em_event_pool_class_t cls);
+
+public:
+
+    /**!
+     * @brief Allocates an event able to hold data_len bytes of payload.
+     *
+     * The event comes from the smallest size class that fits the payload. A recycled
+     * block is used when one is available, otherwise a new block is allocated. The
+     * byte following a subdoc payload of data_len bytes, u.bevt.u.subdoc.buff[data_len],
+     * is zeroed so that the payload is always terminated.
+     *
+     * @param[in] data_len Number of payload bytes following the em_event_t header.
+     *
+     * @returns Pointer to the event, or NULL if data_len exceeds EM_MAX_EVENT_DATA_LEN
+     * or memory could not be allocated.
+     */
+    em_event_t *alloc(unsigned int data_len);
+
+    /**!
+     * @brief Returns an event obtained from alloc() to the pool.
+     *
+     * @param[in] evt Pointer to the event. NULL is ignored.
+     *
+     * @note Blocks beyond the per class cache limit are released to the heap.
+     */
+    void release(em_event_t *evt);
+
+    /**!
+     * @brief Returns the payload length carried by an event.
+     *
+     * @param[in] evt Pointer to the event.
+     *
+     * @returns Payload length in bytes, 0 for events without payload.
+     */
+    static unsigned int get_event_data_len(em_event_t *evt);
+
+    /**!
+     * @brief Prints allocation statistics of the pool.
+     */
+    void dump_stats();
+
+    /**!
+     * @brief Constructor for em_event_pool_t.
+     */
+    em_event_pool_t();
+
+    /**!
+     * @brief Destructor for em_event_pool_t, releases all cached blocks.
+     */
+    ~em_event_pool_t();
+};
+
+#endif
@@ -0,0 +1,153 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_FRAME_RING_H
+#define EM_FRAME_RING_H
+
+#include <pthread.h>
+#include <atomic>
+#include "em_base.h"
+#include "em_frame_trace.h"
+
+#define EM_RX_RING_SZ       64
+#define EM_RX_BUFF_SZ       (MAX_EM_BUFF_SZ*EM_MAX_BANDS)
+
+class em_frame_ring_t;
+
+struct em_rx_buff_t {
+    em_frame_ring_t *ring;
+    std::atomic<unsigned int> ref;
+    bool heap;
+    unsigned int size;
+    struct em_rx_buff_t *next;
+    em_event_t evt;             // frame event handed to the em_t queue, evt.u.fevt.frame points at data
+    em_frame_ts_t ts;           // receive stamps, cleared by get()
+    void *src;                  // node the frame was read from while it waits for its receive shard
+    unsigned char *data;
+};
+
+class em_frame_ring_t {
+
+    pthread_mutex_t m_lock;
+    em_rx_buff_t *m_buffs;
+    unsigned char *m_slab;
+    em_rx_buff_t *m_free;
+    unsigned int m_num;
+    unsigned int m_in_use;
+    unsigned int m_high_watermark;
+    unsigned int m_heap_allocs;
+
+    /**!
+     * @brief Returns a buffer to the free list or to the heap.
+     *
+     * @param[in] buff Pointer to the buffer whose last reference was dropped.
+     */
+    void recycle(em_rx_buff_t *buff);
+
+public:
+
+    /**!
+     * @brief Allocates the ring buffers.
+     *
+     * @param[in] num Number of buffers in the ring, each able to hold EM_RX_BUFF_SZ bytes.
+     *
+     * @returns int
+     * @retval 0 on success
+     * @retval -1 on failure
+     */
+    int init(unsigned int num = EM_RX_RING_SZ);
+
+    /**!
+     * @brief Releases the ring buffers.
+     *
+     * @note All buffers must have been returned before calling this function.
+     */
+    void deinit();
+
+    /**!
+     * @brief Takes a receive buffer able to hold len bytes with a reference count of one.
+     *
+     * Ring buffers are used when len fits in EM_RX_BUFF_SZ and one is free, otherwise a
+     * buffer is allocated from the heap and freed when its last reference is dropped.
+     *
+     * @param[in] len Number of bytes the buffer must be able to hold.
+     *
+     * @returns Pointer to the buffer, or NULL if memory could not be allocated.
+     */
+    em_rx_buff_t *get(unsigned int len = EM_RX_BUFF_SZ);
+
+    /**!
+     * @brief Prepares the frame event embedded in the buffer.
+     *
+     * @param[in] buff Pointer to the buffer.
+     * @param[in] len Length of the frame held in the buffer.
+     *
+     * @returns Pointer to the embedded frame event.
+     */
+    static em_event_t *to_event(em_rx_buff_t *buff, unsigned int len);
+
+    /**!
+     * @brief Returns the buffer owning a frame event created by to_event().
+     *
+     * @param[in] evt Pointer to the frame event.
+     *
+     * @returns Pointer to the owning buffer.
+     */
+    static em_rx_buff_t *from_event(em_event_t *evt);
+
+    /**!
+     * @brief Takes an additional reference on a buffer.
+     *
+     * @param[in] buff Pointer to the buffer.
+     */
+    static void hold(em_rx_buff_t *buff) { buff->ref++; }
+
+    /**!
+     * @brief Drops a reference on a buffer, returning it to its ring when the last one goes.
+     *
+     * @param[in] buff Pointer to the buffer. NULL is ignored.
+     */
+    static void put(em_rx_buff_t *buff);
+
+    /**!
+     * @brief Returns the number of buffers currently handed out.
+     */
+    unsigned int get_in_use() { return m_in_use; }
+
+    /**!
+     * @brief Returns the highest number of buffers handed out at the same time.
+     */
+    unsigned int get_high_watermark() { return m_high_watermark; }
+
+    /**!
+     * @brief Returns the number of heap buffers allocated because the ring was exhausted.
+     */
+    unsigned int get_heap_allocs() { return m_heap_allocs; }
+
+    /**!
+     * @brief Constructor for em_frame_ring_t.
+     */
+    em_frame_ring_t();
+
+    /**!
+     * @brief Destructor for em_frame_ring_t.
+     */
+    ~em_frame_ring_t();
+};
+
+#endif
@@ -0,0 +1,145 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_FRAME_TRACE_H
+#define EM_FRAME_TRACE_H
+
+#include <stdint.h>
+#include <atomic>
+#include <sys/socket.h>
+#include <cjson/cJSON.h>
+#include "em_lat_hist.h"
+#include "em_msg.h"
+
+#define EM_FRAME_TRACE_SLOW_US          100000  // default threshold of the slow frame log
+#define EM_FRAME_TRACE_LOG_PER_SEC      10      // slow frames logged per second at most, the rest are counted
+
+typedef enum {
+    em_frame_stage_socket,      // kernel receive to the read of the listener
+    em_frame_stage_listener,    // read to the push into the em_t queue, reassembly and routing
+    em_frame_stage_queue,       // waiting in the em_t queue
+    em_frame_stage_handler,     // the CMDU handler
+    em_frame_stage_total,       // receive, or read when the kernel gave no timestamp, to handler return
+    em_frame_stage_max
+} em_frame_stage_t;
+
+// monotonic microseconds at each hand over of a received frame, 0 when not known
+typedef struct {
+    uint64_t rx_us;
+    uint64_t read_us;
+    uint64_t queued_us;
+} em_frame_ts_t;
+
+/*
+ * Per message type latency of each stage a received CMDU goes through, from the socket
+ * to the return of its handler. Recorded once per handled frame from the em_t thread with
+ * relaxed atomics, while the listener only stamps the frame. Frames slower than the
+ * threshold are logged with their stage breakdown.
+ */
+class em_frame_trace_t {
+
+    static std::atomic<uint64_t> s_buckets[EM_MSG_TYPE_SLOTS][em_frame_stage_max][EM_LAT_HIST_BUCKETS];
+    static std::atomic<uint64_t> s_sum_us[EM_MSG_TYPE_SLOTS][em_frame_stage_max];
+    static std::atomic<uint64_t> s_max_us[EM_MSG_TYPE_SLOTS][em_frame_stage_max];
+    static std::atomic<uint64_t> s_slow_threshold_us;
+    static std::atomic<uint64_t> s_slow_frames;
+    static std::atomic<uint64_t> s_log_window_us;
+    static std::atomic<unsigned int> s_log_count;
+
+    static void record_stage(unsigned int slot, em_frame_stage_t stage, uint64_t us);
+    static void get_slot_hist(unsigned int slot, em_frame_stage_t stage, em_lat_hist_t *out);
+    static void log_slow(unsigned int type, const uint64_t *stage_us, const bool *known);
+
+public:
+
+    /**!
+     * @brief Turns on receive timestamps of a socket.
+     *
+     * Software SO_TIMESTAMPING where the kernel has it, SO_TIMESTAMPNS otherwise.
+     *
+     * @param[in] fd Socket.
+     *
+     * @returns 0 on success, -1 if the socket gives no receive timestamps.
+     */
+    static int enable_rx_timestamps(int fd);
+
+    /**!
+     * @brief Returns the receive time of a message read with recvmsg.
+     *
+     * The realtime stamp of the kernel is moved to the monotonic clock of em_lat_hist_t.
+     *
+     * @param[in] msg Message header, with the control data of the receive.
+     * @param[in] now_us Monotonic time of the read in microseconds.
+     *
+     * @returns Monotonic receive time in microseconds, 0 if the message carries no timestamp.
+     */
+    static uint64_t get_rx_time_us(struct msghdr *msg, uint64_t now_us);
+
+    /**!
+     * @brief Records the stages of a handled frame.
+     *
+     * Stages with a missing stamp are left out.
+     *
+     * @param[in] type CMDU message type.
+     * @param[in] ts Stamps of the frame.
+     * @param[in] start_us Start of the handler.
+     * @param[in] end_us Return of the handler.
+     */
+    static void record(unsigned int type, const em_frame_ts_t *ts, uint64_t start_us, uint64_t end_us);
+
+    /**!
+     * @brief Sets the total latency above which frames are logged, 0 turns the log off.
+     */
+    static void set_slow_threshold_us(uint64_t us) { s_slow_threshold_us.store(us, std::memory_order_relaxed); }
+
+    /**!
+     * @brief Returns the threshold of the slow frame log.
+     */
+    static uint64_t get_slow_threshold_us() { return s_slow_threshold_us.load(std::memory_order_relaxed); }
+
+    /**!
+     * @brief Returns the number of frames above the threshold, logged or not.
+     */
+    static uint64_t get_slow_frames() { return s_slow_frames.load(std::memory_order_relaxed); }
+
+    /**!
+     * @brief Adds the samples of one stage of one message type.
+     *
+     * @param[in] type CMDU message type.
+     * @param[in] stage Stage.
+     * @param[out] out Histogram the samples are added to.
+     */
+    static void get_hist(unsigned int type, em_frame_stage_t stage, em_lat_hist_t *out);
+
+    /**!
+     * @brief Encodes the stages of every message type that was handled.
+     *
+     * @param[in] obj Object the "SlowThreshold", "SlowFrames" and "Types" fields are added to,
+     * Types holds one object per message type named by its hex value.
+     */
+    static void encode(cJSON *obj);
+
+    /**!
+     * @brief Clears all samples and the slow frame count.
+     */
+    static void reset();
+
+    static const char *get_stage_str(em_frame_stage_t stage);
+};
+
+#endif
@@ -0,0 +1,296 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_HA_H
+#define EM_HA_H
+
+#include <pthread.h>
+#include <atomic>
+#include <string>
+#include <openssl/ssl.h>
+#include "em_base.h"
+#include "db_client.h"
+#include "db_change_log.h"
+
+#define EM_HA_HEARTBEAT_MS      1000        // the primary sends a heartbeat when it has no record to send
+#define EM_HA_TAKEOVER_MS       3000        // the standby takes over after this long without hearing the primary
+#define EM_HA_RETRY_MS          500         // between the connection attempts of the standby
+#define EM_HA_FENCE_PROBE_MS    5000        // between the probes of a controller that took over for the primary it replaced
+#define EM_HA_MAX_BATCH         65536       // bytes of change log records read for one frame
+#define EM_HA_MAX_FRAME         (64 * 1024 * 1024)
+#define EM_HA_CERT_FILE         EM_CERT_FILE    // certificate both controllers present
+#define EM_HA_KEY_FILE          EM_KEY_FILE
+#define EM_HA_CA_FILE           EM_CERT_FILE    // the only trust anchor, a peer without a certificate it issued is refused
+
+typedef enum {
+    em_ha_role_none,
+    em_ha_role_primary,
+    em_ha_role_standby,
+} em_ha_role_t;
+
+/*
+ * Frames on the replication connection, an 8 bit type and a 32 bit length in network byte
+ * order ahead of the payload. Integers are 64 bit in network byte order, the rows travel as
+ * db_snapshot_t images, never as statements.
+ */
+typedef enum {
+    em_ha_frame_hello = 1,      // standby: log id and sequence number of the last record applied, epoch
+    em_ha_frame_info,           // primary: log id, epoch, AL MAC and name of the AL interface
+    em_ha_frame_snapshot,       // primary: sequence number the snapshot is current to, then the image of every table
+    em_ha_frame_tables,         // primary: first and last sequence numbers of records, then the image of the tables they changed
+    em_ha_frame_heartbeat,      // primary: sequence number of its last record
+} em_ha_frame_type_t;
+
+typedef struct {
+    unsigned long long  connects;       // standbys connected to the primary, connections to it of the standby
+    unsigned long long  snapshots;      // full copies sent or restored
+    unsigned long long  records;        // records sent or applied
+    unsigned long long  bytes;          // bytes of the frames sent or received
+} em_ha_stats_t;
+
+/*
+ * Active/standby replication of the controller data model. Every row write of the
+ * database, the commit points of the dirty objects of dm_easy_mesh_t, is appended to a
+ * binary change log. The primary streams the changes to the standby over mutually
+ * authenticated TLS, listening on the address it is configured with; a standby that
+ * connects for the first time, or whose next record left the log, gets a snapshot of the
+ * database first and the changes from then on. The standby never runs what the primary
+ * sends: each change frame carries the rows of the tables the records changed, which the
+ * standby writes back through statements it builds itself, into tables it has, so a change
+ * costs a copy of the tables it touches. The standby runs no controller while the primary
+ * is alive. When it has not heard the primary for EM_HA_TAKEOVER_MS and a new connection to
+ * it fails as well, it moves the AL MAC of the primary to its AL interface and starts the
+ * controller on the replicated database, with the radios of the agents already configured,
+ * so the agents keep their configuration instead of onboarding again.
+ *
+ * Each takeover starts a new epoch. The controller that took over serves the next standby
+ * on the address it reached the primary from, and probes the primary it replaced every
+ * EM_HA_FENCE_PROBE_MS. A primary that hears of a higher epoch, from a probe or a standby,
+ * is fenced: it stops serving and its controller stops. Epochs are not kept across
+ * restarts, and a primary that neither peer can reach keeps running until it is reached.
+ */
+class em_ha_t {
+
+    em_ha_role_t    m_role;
+    std::string     m_host;             // of the primary, for the standby and for the probes after a takeover
+    std::string     m_bind;             // address the primary listens on
+    unsigned short  m_port;
+    std::string     m_ifname;           // AL interface of the standby, that of the primary if empty
+    db_change_log_t m_log;
+    SSL_CTX         *m_ssl_ctx;
+
+    db_client_t     *m_client;          // database of the primary
+    mac_address_t   m_al_mac;
+    std::string     m_al_ifname;
+    int             m_listen_fd;
+    int             m_conn_fd;          // standby being served
+    pthread_t       m_thread;
+    bool            m_running;
+    std::atomic<bool>   m_exit;
+
+    unsigned long long  m_epoch;        // of this controller as primary
+    unsigned long long  m_peer_id;      // log id of the primary, for the standby
+    unsigned long long  m_peer_seq;     // last record applied
+    unsigned long long  m_peer_epoch;   // highest epoch of a primary replicated
+    bool            m_copied;           // the database holds a copy of that of the primary
+    bool            m_took_over;
+    std::atomic<bool>   m_fenced;
+
+    pthread_mutex_t m_lock;
+    em_ha_stats_t   m_stats;
+
+    /**!
+     * @brief Creates the TLS context, with the certificate and key of the controller and peer verification.
+     *
+     * @returns 0 on success, -1 if the certificate, key or trust anchor can not be loaded.
+     */
+    int init_tls();
+
+    /**!
+     * @brief Connects to the primary, or the primary replaced, and completes the TLS handshake.
+     *
+     * @param[out] fd Socket of the connection.
+     *
+     * @returns The TLS connection, NULL if the primary could not be reached or authenticated.
+     */
+    SSL *connect_peer(int *fd);
+
+    /**!
+     * @brief Shuts down and frees a TLS connection and closes its socket.
+     */
+    static void close_peer(SSL *ssl, int fd);
+
+    /**!
+     * @brief Sends a frame.
+     *
+     * @returns 0 on success, -1 if the connection failed.
+     */
+    static int send_frame(SSL *ssl, em_ha_frame_type_t type, const std::string& payload);
+
+    /**!
+     * @brief Receives a frame.
+     *
+     * @param[in] ssl Connection.
+     * @param[out] type Type of the frame.
+     * @param[out] payload Payload of the frame.
+     * @param[in] timeout_ms Longest wait for each part of the frame.
+     *
+     * @returns 0 on success, -1 on timeout or if the connection failed.
+     */
+    static int recv_frame(SSL *ssl, unsigned char *type, std::string& payload, int timeout_ms);
+
+    /**!
+     * @brief Thread of the primary, serves one standby at a time and probes the primary it replaced.
+     *
+     * @param[in] arg Pointer to the em_ha_t.
+     */
+    static void *primary_run(void *arg);
+
+    /**!
+     * @brief Streams the changes to a connected standby until it disconnects or stop() is called.
+     *
+     * @param[in] ssl Connection.
+     */
+    void serve(SSL *ssl);
+
+    /**!
+     * @brief Tells the primary this controller replaced of the epoch of the takeover.
+     */
+    void probe_replaced();
+
+    /**!
+     * @brief Sends a snapshot of the database.
+     *
+     * @param[in] ssl Connection.
+     * @param[out] seq Sequence number of the last record the snapshot holds.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    int send_snapshot(SSL *ssl, unsigned long long *seq);
+
+    /**!
+     * @brief Sends the tables changed by change log records.
+     *
+     * @param[in] ssl Connection.
+     * @param[in] first Sequence number of the first record.
+     * @param[in] last Sequence number of the last record.
+     * @param[in] recs The records, as read from the change log.
+     *
+     * @returns Number of records, -1 if the records are corrupt or the connection failed.
+     */
+    int send_tables(SSL *ssl, unsigned long long first, unsigned long long last, const std::string& recs);
+
+    /**!
+     * @brief Applies a frame received from the primary to the database of the standby.
+     *
+     * @returns 0 on success, -1 if the standby has to copy the whole database again.
+     */
+    int apply(db_client_t *client, unsigned char type, std::string& payload);
+
+    /**!
+     * @brief Adds to the counters.
+     */
+    void count(unsigned long long connects, unsigned long long snapshots, unsigned long long records, unsigned long long bytes);
+
+public:
+
+    /**!
+     * @brief Sets the role from the --ha option of the controller.
+     *
+     * @param[in] spec "primary:<listen address>:<port>" or "standby:<primary address>:<port>[:<AL interface>]",
+     * an IPv6 address in brackets.
+     *
+     * @returns 0 on success, -1 if the option is not valid.
+     */
+    int configure(const char *spec);
+
+    /**!
+     * @brief Returns the role.
+     */
+    em_ha_role_t get_role() const { return m_role; }
+
+    /**!
+     * @brief Returns the change log the database of the primary appends its writes to.
+     */
+    db_change_log_t *get_change_log() { return &m_log; }
+
+    /**!
+     * @brief Starts to serve a standby.
+     *
+     * @param[in] client Database of the controller, its writes are appended to get_change_log().
+     * @param[in] al_mac AL MAC of the controller.
+     * @param[in] al_ifname AL interface of the controller.
+     *
+     * @returns 0 on success, -1 if TLS can not be set up or the address could not be listened on.
+     */
+    int start_primary(db_client_t *client, const unsigned char *al_mac, const char *al_ifname);
+
+    /**!
+     * @brief Replicates the database of the primary until it fails, then takes its AL MAC over.
+     *
+     * Blocks the caller, the controller is started once this returns. The standby takes over
+     * only once it copied the database of a primary.
+     *
+     * @param[in] data_model_path Database of the standby.
+     *
+     * @returns 0 once the standby took over, -1 if its database can not be opened or TLS can not be set up.
+     */
+    int run_standby(const char *data_model_path);
+
+    /**!
+     * @brief Returns true if this controller took over from a primary.
+     */
+    bool has_taken_over() const { return m_took_over; }
+
+    /**!
+     * @brief Returns true if another controller took over from this one, which then has to stop.
+     */
+    bool is_fenced() const { return m_fenced; }
+
+    /**!
+     * @brief Stops serving the standby.
+     */
+    void stop();
+
+    /**!
+     * @brief Returns the counters.
+     */
+    void get_stats(em_ha_stats_t *stats);
+
+    /**!
+     * @brief Sets the MAC address of an interface, bringing it down while it changes.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    static int set_mac_address(const char *ifname, const unsigned char *mac);
+
+    /**!
+     * @brief Constructor for em_ha_t, no role.
+     */
+    em_ha_t();
+
+    /**!
+     * @brief Destructor for em_ha_t, stops serving the standby.
+     */
+    ~em_ha_t();
+
+    em_ha_t(const em_ha_t&) = delete;
+    em_ha_t& operator=(const em_ha_t&) = delete;
+};
+
+#endif
@@ -0,0 +1,213 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_HEX_H
+#define EM_HEX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define EM_HEX_MAC_LEN          6
+#define EM_HEX_MAC_STR_LEN      17      // "xx:xx:xx:xx:xx:xx" without the NUL
+
+// a MAC address in the low 48 bits, compared in one instruction
+typedef uint64_t em_packed_mac_t;
+
+/*
+ * Table driven hex encoding and decoding of MAC addresses and blobs. These sit under
+ * every MAC to string conversion of the data model, keys are built and parsed for each
+ * STA, BSS and radio, so they avoid the printf/scanf machinery altogether.
+ */
+namespace em_hex {
+
+	/**!
+	 * @brief Returns the value of a hex digit.
+	 *
+	 * @param[in] c The digit, either case.
+	 *
+	 * @returns 0 to 15, -1 if c is not a hex digit.
+	 */
+	inline int digit_val(char c) {
+		static const signed char tbl[256] = {
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+			-1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+		};
+
+		return tbl[static_cast<unsigned char> (c)];
+	}
+
+	/**!
+	 * @brief Writes the two lower case hex digits of a byte.
+	 *
+	 * @param[in] b The byte.
+	 * @param[out] out Receives two characters, no NUL.
+	 */
+	inline void put_byte(unsigned char b, char *out) {
+		static const char digits[] = "0123456789abcdef";
+
+		out[0] = digits[b >> 4];
+		out[1] = digits[b & 0xf];
+	}
+
+	/**!
+	 * @brief Formats a MAC address as "xx:xx:xx:xx:xx:xx".
+	 *
+	 * @param[in] mac The MAC address.
+	 * @param[out] str Buffer of at least EM_HEX_MAC_STR_LEN + 1 characters.
+	 * @param[in] delim Separator between the bytes, '\0' for none.
+	 *
+	 * @returns Pointer to the end of the string, at its NUL, so that keys can be appended to.
+	 */
+	inline char *mac_to_str(const unsigned char *mac, char *str, char delim = ':') {
+		unsigned int i;
+
+		for (i = 0; i < EM_HEX_MAC_LEN; i++) {
+			if ((i != 0) && (delim != '\0')) {
+				*str++ = delim;
+			}
+			put_byte(mac[i], str);
+			str += 2;
+		}
+		*str = '\0';
+
+		return str;
+	}
+
+	/**!
+	 * @brief Parses a MAC address, either "xx:xx:xx:xx:xx:xx" or "xxxxxxxxxxxx".
+	 *
+	 * Either case is accepted and ':' or '-' may separate the bytes.
+	 *
+	 * @param[in] str The string.
+	 * @param[out] mac Receives the MAC address, the bytes that could not be parsed are zeroed.
+	 *
+	 * @returns 0 on success, -1 if str does not start with a MAC address.
+	 */
+	inline int str_to_mac(const char *str, unsigned char *mac) {
+		unsigned int i;
+		int hi, lo;
+
+		for (i = 0; i < EM_HEX_MAC_LEN; i++) {
+			if ((i != 0) && ((*str == ':') || (*str == '-'))) {
+				str++;
+			}
+			if (((hi = digit_val(str[0])) < 0) || ((lo = digit_val(str[1])) < 0)) {
+				memset(&mac[i], 0, EM_HEX_MAC_LEN - i);
+				return -1;
+			}
+			mac[i] = static_cast<unsigned char> ((hi << 4) | lo);
+			str += 2;
+		}
+
+		return 0;
+	}
+
+	/**!
+	 * @brief Encodes a blob as lower case hex digits.
+	 *
+	 * @param[in] in The blob.
+	 * @param[in] in_len Length of the blob.
+	 * @param[out] out Receives 2 * in_len digits and a NUL.
+	 */
+	inline void encode(const unsigned char *in, size_t in_len, char *out) {
+		size_t i;
+
+		for (i = 0; i < in_len; i++) {
+			put_byte(in[i], &out[2*i]);
+		}
+		out[2*in_len] = '\0';
+	}
+
+	/**!
+	 * @brief Decodes hex digits into a blob.
+	 *
+	 * @param[in] in The digits, either case.
+	 * @param[in] in_len Number of digits, an odd last one is ignored.
+	 * @param[out] out Receives in_len / 2 bytes.
+	 *
+	 * @returns 0 on success, -1 if a character is not a hex digit, it is decoded as 0.
+	 */
+	inline int decode(const char *in, size_t in_len, unsigned char *out) {
+		size_t i;
+		int hi, lo, ret = 0;
+
+		for (i = 0; i < in_len/2; i++) {
+			hi = digit_val(in[2*i]);
+			lo = digit_val(in[2*i + 1]);
+			if ((hi | lo) < 0) {
+				ret = -1;
+				hi = (hi < 0) ? 0:hi;
+				lo = (lo < 0) ? 0:lo;
+			}
+			out[i] = static_cast<unsigned char> ((hi << 4) | lo);
+		}
+
+		return ret;
+	}
+
+	/**!
+	 * @brief Packs a MAC address into an integer.
+	 *
+	 * The byte order follows the host, packed values are only compared and hashed,
+	 * never sent or stored.
+	 *
+	 * @param[in] mac The MAC address.
+	 */
+	inline em_packed_mac_t pack_mac(const unsigned char *mac) {
+		em_packed_mac_t val = 0;
+
+		memcpy(&val, mac, EM_HEX_MAC_LEN);
+		return val;
+	}
+
+	/**!
+	 * @brief Unpacks a MAC address packed by pack_mac().
+	 *
+	 * @param[in] val The packed MAC address.
+	 * @param[out] mac Receives the MAC address.
+	 */
+	inline void unpack_mac(em_packed_mac_t val, unsigned char *mac) {
+		memcpy(mac, &val, EM_HEX_MAC_LEN);
+	}
+
+	/**!
+	 * @brief Compares two MAC addresses.
+	 *
+	 * @returns True if they are equal.
+	 */
+	inline bool mac_equal(const unsigned char *a, const unsigned char *b) {
+		return pack_mac(a) == pack_mac(b);
+	}
+}
+
+#endif
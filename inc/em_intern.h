@@ -0,0 +1,98 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_INTERN_H
+#define EM_INTERN_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+#define EM_INTERN_NONE      0       // handle of no string
+
+typedef unsigned int em_intern_id_t;
+
+/*
+ * Table of the strings that name things shared across the data model, network ids and
+ * SSIDs, each given a small integer handle for as long as the process runs. Keys and
+ * indexes hold the handle and compare it as an integer, the string is only looked up at
+ * the JSON, DB and TR-181 boundaries. Handles start at 1 and are never reused, the
+ * string of a handle never moves. Thread safe.
+ */
+class em_intern_t {
+
+    pthread_rwlock_t m_lock;
+    unsigned int m_serial;
+    std::unordered_map<std::string, em_intern_id_t> m_ids;
+    std::deque<std::string> m_strs;     // string of handle n at n - 1
+
+public:
+
+    /**!
+     * @brief Returns the handle of a string, adding it to the table if needed.
+     *
+     * @param[in] str The string.
+     * @param[in] max Size of the buffer holding the string, the string ends at its NUL or there.
+     *
+     * @returns The handle, EM_INTERN_NONE if str is NULL.
+     */
+    em_intern_id_t intern(const char *str, size_t max);
+
+    /**!
+     * @brief Returns the handle of a string without adding it.
+     *
+     * @param[in] str The string.
+     * @param[in] max Size of the buffer holding the string.
+     *
+     * @returns The handle, EM_INTERN_NONE if the string was never interned.
+     */
+    em_intern_id_t find(const char *str, size_t max);
+
+    /**!
+     * @brief Returns the string of a handle.
+     *
+     * @param[in] id The handle.
+     *
+     * @returns The string, valid for the life of the table, "" for an unknown handle.
+     */
+    const char *get_str(em_intern_id_t id);
+
+    /**!
+     * @brief Returns the number of strings in the table.
+     */
+    unsigned int count();
+
+    /**!
+     * @brief Returns the table shared by the whole process.
+     */
+    static em_intern_t *get_table();
+
+    /**!
+     * @brief Constructor for em_intern_t.
+     */
+    em_intern_t();
+
+    /**!
+     * @brief Destructor for em_intern_t.
+     */
+    ~em_intern_t();
+};
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_LAT_HIST_H
+#define EM_LAT_HIST_H
+
+#include <stdint.h>
+#include <cjson/cJSON.h>
+
+// bucket 0 holds samples below 1us, bucket i holds [2^(i-1), 2^i) us, the last one is open ended
+#define EM_LAT_HIST_BUCKETS     26
+
+/*
+ * Fixed size latency histogram with power of two microsecond buckets. Recording a
+ * sample never allocates. Not thread safe, samples and reads must come from one thread.
+ */
+class em_lat_hist_t {
+
+    unsigned int m_buckets[EM_LAT_HIST_BUCKETS];
+    unsigned int m_count;
+    uint64_t m_sum_us;
+    uint64_t m_max_us;
+
+public:
+
+    /**!
+     * @brief Records one sample.
+     *
+     * @param[in] us Sample in microseconds.
+     */
+    void add(uint64_t us);
+
+    /**!
+     * @brief Adds the samples of another histogram given by its raw values.
+     *
+     * @param[in] buckets Sample count of each of the EM_LAT_HIST_BUCKETS buckets.
+     * @param[in] sum_us Sum of the samples in microseconds.
+     * @param[in] max_us Largest sample in microseconds.
+     */
+    void merge(const uint64_t *buckets, uint64_t sum_us, uint64_t max_us);
+
+    /**!
+     * @brief Clears all samples.
+     */
+    void reset();
+
+    /**!
+     * @brief Returns the number of recorded samples.
+     */
+    unsigned int get_count() { return m_count; }
+
+    /**!
+     * @brief Returns the largest recorded sample in microseconds.
+     */
+    uint64_t get_max_us() { return m_max_us; }
+
+    /**!
+     * @brief Returns the mean of the recorded samples in microseconds, 0 if there are none.
+     */
+    uint64_t get_mean_us() { return (m_count == 0) ? 0:(m_sum_us / m_count); }
+
+    /**!
+     * @brief Returns the number of samples in a bucket.
+     *
+     * @param[in] idx Index of the bucket, below EM_LAT_HIST_BUCKETS.
+     */
+    unsigned int get_bucket(unsigned int idx) { return m_buckets[idx]; }
+
+    /**!
+     * @brief Estimates a percentile from the bucket counts.
+     *
+     * @param[in] pct Percentile, 1 to 100.
+     *
+     * @returns Upper bound of the bucket holding the percentile in microseconds, never above the
+     * largest sample, 0 if there are no samples.
+     */
+    uint64_t get_percentile_us(unsigned int pct);
+
+    /**!
+     * @brief Adds the summary and the non empty buckets of the histogram to a JSON object.
+     *
+     * @param[in] obj JSON object to add the fields to.
+     */
+    void encode(cJSON *obj);
+
+    /**!
+     * @brief Returns the bucket a sample falls into.
+     *
+     * @param[in] us Sample in microseconds.
+     */
+    static unsigned int get_bucket_index(uint64_t us);
+
+    /**!
+     * @brief Returns the exclusive upper bound of a bucket in microseconds, UINT64_MAX for the last one.
+     *
+     * @param[in] idx Index of the bucket.
+     */
+    static uint64_t get_bucket_limit_us(unsigned int idx);
+
+    /**!
+     * @brief Returns the monotonic clock in microseconds.
+     */
+    static uint64_t get_time_us();
+
+    /**!
+     * @brief Constructor for em_lat_hist_t.
+     */
+    em_lat_hist_t();
+
+    /**!
+     * @brief Destructor for em_lat_hist_t.
+     */
+    ~em_lat_hist_t();
+};
+
+#endif
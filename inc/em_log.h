@@ -0,0 +1,176 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_LOG_H
+#define EM_LOG_H
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <atomic>
+#include "util.h"
+
+#define EM_LOG_RING_SZ      1024    // messages waiting for the writer thread, a power of two
+#define EM_LOG_MSG_SZ       512     // messages are formatted in place up to this length, longer ones are allocated
+#define EM_LOG_CHECK_MS     1000    // how often the debug enable files and the log files are looked at
+#define EM_LOG_NUM_MODULES  (EM_CONF + 1)
+
+typedef enum {
+    em_log_dest_none,
+    em_log_dest_stdout,
+    em_log_dest_debug,      // <debug dir><module>, while the debug enable file of the module exists
+    em_log_dest_file,       // <log dir><module>.txt
+} em_log_dest_t;
+
+typedef struct {
+    std::atomic<size_t> seq;
+    unsigned char       module;
+    unsigned char       dest;
+    unsigned int        len;
+    char                *big;           // the message when it does not fit in text
+    char                text[EM_LOG_MSG_SZ];
+} em_log_cell_t;
+
+typedef struct {
+    char                name[16];
+    char                dbg_enable[256];    // file enabling the debug level of the module
+    std::atomic<bool>   debug;
+    // owned by the writer thread
+    FILE                *fp[2];             // debug, file
+    dev_t               dev[2];
+    ino_t               ino[2];
+} em_log_module_t;
+
+/*
+ * Log backend of util::em_util_print(). The callers format their message straight into
+ * a slot of a ring and a writer thread appends the slots to the log files, so logging
+ * costs no system call in the caller. The level is checked before anything is formatted,
+ * the debug enable files are looked at by the writer thread every EM_LOG_CHECK_MS. The
+ * log files are kept open and reopened once they were rotated or removed. A full ring
+ * drops the message, the writer logs how many were dropped.
+ */
+class em_log_t {
+
+    em_log_cell_t *m_cells;
+    size_t m_mask;
+    std::atomic<size_t> m_enqueue_pos;
+    std::atomic<size_t> m_dequeue_pos;
+    std::atomic<bool> m_waiting;
+    std::atomic<bool> m_exit;
+    std::atomic<unsigned int> m_drops;
+    unsigned int m_drops_logged;
+    int m_efd;
+    std::atomic<bool> m_running;
+    pthread_t m_thread;
+    pthread_mutex_t m_lock;             // output without the writer thread
+    em_log_module_t m_modules[EM_LOG_NUM_MODULES];
+    char m_dbg_dir[128];
+    char m_log_dir[128];
+
+    static void *writer(void *arg);
+
+    void write_cells();
+    FILE *output(em_log_cell_t *cell);
+    void check_files();
+    void close_files();
+    void wake();
+
+    em_log_dest_t get_dest(easymesh_log_level_t level, easymesh_dbg_type_t module);
+    em_log_cell_t *reserve(size_t *pos);
+    void publish(em_log_cell_t *cell, size_t pos);
+
+public:
+
+    /**!
+     * @brief Looks at the debug enable files and starts the writer thread.
+     *
+     * @param[in] dbg_prefix Prefix of the debug enable files, e.g. LOG_PATH_PREFIX.
+     * @param[in] dbg_dir Directory of the debug log files.
+     * @param[in] log_dir Directory of the info and error log files.
+     *
+     * @returns 0 on success, -1 if the messages are written by the callers.
+     */
+    int init(const char *dbg_prefix, const char *dbg_dir, const char *log_dir);
+
+    /**!
+     * @brief Writes the queued messages, stops the writer thread and closes the log files.
+     */
+    void deinit();
+
+    /**!
+     * @brief Tells if a message of a level is logged by a module, without a system call.
+     */
+    bool enabled(easymesh_log_level_t level, easymesh_dbg_type_t module) { return get_dest(level, module) != em_log_dest_none; }
+
+    /**!
+     * @brief Queues a formatted message with the program, time, module, function, line and level in front.
+     *
+     * @param[in] level Log level of the message.
+     * @param[in] module Module logging the message.
+     * @param[in] func Function logging the message.
+     * @param[in] line Line logging the message.
+     * @param[in] format Format of the message, a new line is appended.
+     * @param[in] args Arguments of the format.
+     */
+    void vprint(easymesh_log_level_t level, easymesh_dbg_type_t module, const char *func, int line, const char *format, va_list args);
+
+    /**!
+     * @brief Queues text as it is.
+     *
+     * @param[in] level Log level of the text.
+     * @param[in] module Module logging the text.
+     * @param[in] text The text.
+     * @param[in] len Length of the text.
+     */
+    void write(easymesh_log_level_t level, easymesh_dbg_type_t module, const char *text, unsigned int len);
+
+    /**!
+     * @brief Waits until the messages queued so far are written.
+     *
+     * @param[in] timeout_ms Maximum time to wait in milliseconds.
+     *
+     * @returns True if they were written, false on timeout.
+     */
+    bool flush(int timeout_ms);
+
+    /**!
+     * @brief Returns the number of messages dropped because the ring was full.
+     */
+    unsigned int get_drops() { return m_drops; }
+
+    /**!
+     * @brief Returns the logger of the process, started on first use.
+     */
+    static em_log_t *get_log();
+
+    /**!
+     * @brief Constructor for em_log_t.
+     */
+    em_log_t();
+
+    /**!
+     * @brief Destructor for em_log_t.
+     */
+    ~em_log_t();
+
+    em_log_t(const em_log_t&) = delete;
+    em_log_t& operator=(const em_log_t&) = delete;
+};
+
+#endif
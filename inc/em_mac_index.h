@@ -0,0 +1,136 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_MAC_INDEX_H
+#define EM_MAC_INDEX_H
+
+#include "em_base.h"
+
+#define EM_MAC_INDEX_MIN_SZ     64
+
+typedef struct {
+    mac_address_t mac;
+    void *val;                  // NULL for an empty slot
+} em_mac_index_entry_t;
+
+/*
+ * Open addressing hash from a binary MAC address to pointers, with linear probing
+ * and backward shift deletion so that no tombstones build up. A MAC may map to
+ * several values, all of them sit in the probe run of its home slot. The table
+ * doubles when half full. Not thread safe.
+ */
+class em_mac_index_t {
+
+    em_mac_index_entry_t *m_table;
+    unsigned int m_mask;
+    unsigned int m_count;
+
+    /**!
+     * @brief Returns the home slot of a MAC address.
+     *
+     * @param[in] mac MAC address.
+     */
+    unsigned int get_home(const unsigned char *mac) const;
+
+    /**!
+     * @brief Doubles the table and re-inserts all entries.
+     *
+     * @returns 0 on success, -1 if the table could not be allocated.
+     */
+    int grow();
+
+    /**!
+     * @brief Empties a slot, shifting back the entries of the run behind it.
+     *
+     * @param[in] idx Index of the slot.
+     */
+    void remove_at(unsigned int idx);
+
+public:
+
+    /**!
+     * @brief Adds a mapping, adding one that exists already is a no-op.
+     *
+     * @param[in] mac MAC address.
+     * @param[in] val Value, must not be NULL.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    int add(const unsigned char *mac, void *val);
+
+    /**!
+     * @brief Removes a mapping.
+     *
+     * @param[in] mac MAC address.
+     * @param[in] val Value.
+     *
+     * @returns True if the mapping was found, false otherwise.
+     */
+    bool remove(const unsigned char *mac, void *val);
+
+    /**!
+     * @brief Removes every mapping to a value, whatever its MAC address.
+     *
+     * @param[in] val Value.
+     *
+     * @returns Number of mappings removed.
+     */
+    unsigned int remove_value(void *val);
+
+    /**!
+     * @brief Returns the first value a MAC address maps to.
+     *
+     * @param[in] mac MAC address.
+     *
+     * @returns The value, NULL if the MAC address is not indexed.
+     */
+    void *get(const unsigned char *mac) const;
+
+    /**!
+     * @brief Returns all values a MAC address maps to.
+     *
+     * @param[in] mac MAC address.
+     * @param[out] vals Array receiving the values.
+     * @param[in] max Size of the array.
+     *
+     * @returns Number of values found, may exceed max, only max are stored.
+     */
+    unsigned int get_all(const unsigned char *mac, void **vals, unsigned int max) const;
+
+    /**!
+     * @brief Returns the number of mappings.
+     */
+    unsigned int count() const { return m_count; }
+
+    /**!
+     * @brief Removes all mappings.
+     */
+    void clear();
+
+    /**!
+     * @brief Constructor for em_mac_index_t.
+     */
+    em_mac_index_t();
+
+    /**!
+     * @brief Destructor for em_mac_index_t.
+     */
+    ~em_mac_index_t();
+};
+
+#endif
@@ -0,0 +1,169 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_MEM_ACCT_H
+#define EM_MEM_ACCT_H
+
+#include <pthread.h>
+#include <cjson/cJSON.h>
+#include "em_base.h"
+#include "em_hex.h"
+
+#include <unordered_map>
+
+typedef enum {
+    em_mem_acct_dm,             // dm_easy_mesh_t and its MLD sections
+    em_mem_acct_stas,           // dm_sta_t of the STA map, the frames of em_sta_info_t are inline
+    em_mem_acct_scan,           // scan results
+    em_mem_acct_sta_caches,     // metrics history, Beacon Reports and client capabilities of its STAs
+    em_mem_acct_ems,            // em_t of the agent
+    em_mem_acct_cmds,           // queued and active em_cmd_t with an em of the agent as candidate
+    em_mem_acct_stacks,         // stacks of the ems running their own thread, reserved rather than used
+    em_mem_acct_max
+} em_mem_acct_type_t;
+
+typedef struct {
+    mac_address_t       al_mac;
+    unsigned long long  bytes[em_mem_acct_max];
+} em_mem_acct_usage_t;
+
+typedef struct {
+    unsigned long long  agent_budget;   // bytes of an agent, over it its caches are evicted, 0 for no limit
+    unsigned long long  total_budget;   // bytes of all agents, over it new agents are refused, 0 for no limit
+    unsigned int        max_agents;     // agents onboarded, beyond it new agents are refused, 0 for no limit
+} em_mem_acct_params_t;
+
+typedef struct {
+    unsigned long long  updates;
+    unsigned long long  refused;        // autoconfig searches of new agents turned away
+    unsigned long long  evictions;      // agents whose caches were evicted
+    unsigned long long  evicted_bytes;
+    unsigned long long  total_bytes;    // of the last update
+    unsigned long long  peak_bytes;
+} em_mem_acct_stats_t;
+
+/*
+ * Memory held by the controller for each onboarded agent, by AL MAC. The controller
+ * measures the data model, STAs, scan results, STA caches, ems and queued commands of
+ * every agent on its 5s tick and hands them over in one update, the table then answers
+ * the CLI and TR-181 and enforces the budgets: an agent over its budget is reported back
+ * for its caches to be evicted, and a new agent is refused while the agents together are
+ * over the total budget. The budgets count the heap only, the stacks are reserved
+ * address space and are reported apart. Thread safe, admit() is called by the listener.
+ */
+class em_mem_acct_t {
+
+    pthread_mutex_t m_lock;
+    std::unordered_map<em_packed_mac_t, em_mem_acct_usage_t> m_agents;
+    em_mem_acct_params_t m_params;
+    em_mem_acct_stats_t m_stats;
+
+public:
+
+    /**!
+     * @brief Replaces the usage of the agents by a new measurement.
+     *
+     * @param[in] usage The usage, one per agent.
+     * @param[in] num Number of agents.
+     * @param[out] over Receives the agents over the agent budget, may be NULL.
+     * @param[in] max Size of over.
+     *
+     * @returns Number of agents over the agent budget, at most max.
+     */
+    unsigned int update(const em_mem_acct_usage_t *usage, unsigned int num, em_mem_acct_usage_t *over, unsigned int max);
+
+    /**!
+     * @brief Decides whether an agent may onboard.
+     *
+     * An agent already accounted for is always admitted.
+     *
+     * @param[in] al_mac AL MAC of the agent.
+     *
+     * @returns True if admitted, false if a limit is reached.
+     */
+    bool admit(const unsigned char *al_mac);
+
+    /**!
+     * @brief Records that the caches of an agent were evicted.
+     *
+     * @param[in] bytes Bytes freed.
+     */
+    void evicted(unsigned long long bytes);
+
+    /**!
+     * @brief Returns the usage of an agent.
+     *
+     * @param[in] al_mac AL MAC of the agent.
+     * @param[out] usage Receives the usage.
+     *
+     * @returns True if the agent is accounted for.
+     */
+    bool get_usage(const unsigned char *al_mac, em_mem_acct_usage_t *usage);
+
+    /**!
+     * @brief Returns the number of agents accounted for.
+     */
+    unsigned int count();
+
+    /**!
+     * @brief Adds the parameters, counters and the usage of every agent to a JSON object.
+     *
+     * @param[in] obj JSON object to add the fields to.
+     */
+    void encode(cJSON *obj);
+
+    /**!
+     * @brief Sets the parameters, applied from the next update or onboarding.
+     */
+    void set_params(const em_mem_acct_params_t *params);
+
+    /**!
+     * @brief Returns the parameters.
+     */
+    em_mem_acct_params_t get_params();
+
+    /**!
+     * @brief Returns the counters.
+     */
+    em_mem_acct_stats_t get_stats();
+
+    /**!
+     * @brief Returns the bytes of a usage the budgets apply to, every type but the stacks.
+     */
+    static unsigned long long get_heap_bytes(const em_mem_acct_usage_t *usage);
+
+    /**!
+     * @brief Returns the name of a type, as used in the JSON encoding.
+     */
+    static const char *get_type_str(em_mem_acct_type_t type);
+
+    /**!
+     * @brief Constructor for em_mem_acct_t, without limits.
+     */
+    em_mem_acct_t();
+
+    /**!
+     * @brief Destructor for em_mem_acct_t.
+     */
+    ~em_mem_acct_t();
+
+    em_mem_acct_t(const em_mem_acct_t&) = delete;
+    em_mem_acct_t& operator=(const em_mem_acct_t&) = delete;
+};
+
+#endif
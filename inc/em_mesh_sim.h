@@ -0,0 +1,197 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_MESH_SIM_H
+#define EM_MESH_SIM_H
+
+#include <stdio.h>
+#include <sys/types.h>
+#include <net/if.h>
+#include <vector>
+#include "em_base.h"
+#include "em_crypto.h"
+#include "em_tlv_writer.h"
+#include "em_lat_hist.h"
+
+#define EM_MESH_SIM_MAX_AGENTS      65535
+#define EM_MESH_SIM_MAX_RADIOS      4
+#define EM_MESH_SIM_MAX_STAS        32      // per radio, the associated clients TLV fits a frame
+#define EM_MESH_SIM_RETRY_MS        2000    // search and M1 are sent again without an answer
+
+typedef enum {
+    em_mesh_sim_state_idle,
+    em_mesh_sim_state_search,       // autoconfig search sent
+    em_mesh_sim_state_wsc,          // M1 sent for every radio
+    em_mesh_sim_state_onboarded,    // M2 received for every radio
+} em_mesh_sim_state_t;
+
+typedef struct {
+    char ifname[IFNAMSIZ];
+    unsigned int num_agents;
+    unsigned int num_radios;        // per agent
+    unsigned int num_stas;          // per radio
+    unsigned int start_rate;        // agents started per second, 0 starts them all at once
+    unsigned int metrics_ms;        // unsolicited AP metrics period per agent, 0 disables them
+    unsigned int btm_ms;            // BTM report period per agent, 0 disables them
+    unsigned int duration_s;
+    pid_t ctrl_pid;                 // controller sampled for memory and CPU, 0 for none
+} em_mesh_sim_config_t;
+
+typedef struct {
+    em_mesh_sim_state_t state;
+    unsigned int radios_done;       // bit per radio that got its M2
+    unsigned int btm_sta;           // next station to report a BTM for
+    uint64_t start_ms;
+    uint64_t sent_ms;
+    uint64_t next_metrics_ms;
+    uint64_t next_btm_ms;
+} em_mesh_sim_agent_t;
+
+typedef struct {
+    uint64_t frames_tx;
+    uint64_t frames_rx;
+    uint64_t tx_errors;
+    uint64_t retries;
+    uint64_t onboarded;
+    uint64_t first_start_ms;
+    uint64_t last_onboard_ms;
+} em_mesh_sim_stats_t;
+
+/*
+ * Load generator for the controller. Emulates many agents, each with its radios and
+ * stations, speaking 1905 CMDUs over a raw socket on one interface, e.g. the end of a
+ * veth pair whose peer the controller listens on. Agents are onboarded through the
+ * autoconfig search and M1, then answer topology and metrics queries and send periodic
+ * AP metrics and BTM reports. All agents are run by the thread calling run().
+ */
+class em_mesh_sim_t {
+
+    em_mesh_sim_config_t m_cfg;
+    std::vector<em_mesh_sim_agent_t> m_agents;
+    em_mesh_sim_stats_t m_stats;
+    em_lat_hist_t m_onboard_lat;
+    em_tlv_writer_t m_writer;
+    em_crypto_t m_crypto;           // one key pair, shared by the M1 of every radio
+    mac_address_t m_ctrl_mac;
+    bool m_ctrl_known;
+    unsigned short m_msg_id;
+    int m_fd;
+    unsigned int m_started;         // agents started so far, in index order
+    uint64_t m_steady_ms;           // every agent onboarded
+    uint64_t m_end_ms;
+    bool m_ctrl_base_ok;
+    unsigned long m_ctrl_base_rss_kb;
+    unsigned long m_ctrl_onboarded_rss_kb;
+    unsigned long m_ctrl_end_rss_kb;
+    unsigned long long m_ctrl_steady_ticks;
+    unsigned long long m_ctrl_end_ticks;
+    unsigned char m_rx_buff[EM_MAX_FRAME_SZ];
+
+    /**!
+     * @brief Sends every frame built by the writer.
+     *
+     * @returns 0 on success, -1 if a frame could not be sent.
+     */
+    int send_built();
+
+    /**!
+     * @brief Handles one frame received on the socket.
+     *
+     * @param[in] buff Frame, ethernet header included.
+     * @param[in] len Length of the frame.
+     */
+    void handle_frame(unsigned char *buff, unsigned int len);
+
+    /**!
+     * @brief Starts the agents that are due, sends again what was not answered and sends the periodic reports.
+     *
+     * @param[in] now_ms Current time in milliseconds.
+     */
+    void handle_timers(uint64_t now_ms);
+
+    /**!
+     * @brief Returns the agent the AL MAC address belongs to, -1 if it is not simulated.
+     */
+    int get_agent_index(const unsigned char *al_mac);
+
+    /**!
+     * @brief Reads the resident memory in kB and the CPU time in clock ticks of the controller.
+     *
+     * @returns 0 on success, -1 if the controller could not be sampled.
+     */
+    int sample_ctrl(unsigned long *rss_kb, unsigned long long *cpu_ticks);
+
+public:
+
+    /**!
+     * @brief Fills the MAC addresses the simulator uses for an agent.
+     *
+     * @param[in] agent Index of the agent.
+     * @param[in] radio Index of the radio, -1 for the AL MAC address.
+     * @param[in] sta Index of the station, -1 for the radio or its BSS.
+     * @param[in] bss True for the BSSID of the radio rather than its radio unique id.
+     * @param[out] mac Address.
+     */
+    static void get_mac(unsigned int agent, int radio, int sta, bool bss, unsigned char *mac);
+
+    /**!
+     * @brief Builds the messages of an agent into the writer.
+     *
+     * @returns Number of frames of the message, -1 on failure.
+     */
+    int build_autoconf_search(unsigned int agent);
+    int build_m1(unsigned int agent, unsigned int radio);
+    int build_topo_resp(unsigned int agent, unsigned short msg_id);
+    int build_ap_metrics_rsp(unsigned int agent, unsigned short msg_id);
+    int build_btm_rprt(unsigned int agent, unsigned int radio, unsigned int sta);
+    int build_ack(unsigned int agent, unsigned short msg_id);
+
+    /**!
+     * @brief Returns the writer holding the last message built.
+     */
+    em_tlv_writer_t *get_writer() { return &m_writer; }
+
+    /**!
+     * @brief Initializes the agents, the key pair and the socket.
+     *
+     * @param[in] cfg Configuration, copied.
+     * @param[in] open_socket False to only build messages, e.g. for tests.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    int init(const em_mesh_sim_config_t *cfg, bool open_socket = true);
+
+    /**!
+     * @brief Runs the agents for the configured duration, printing a line of progress every second.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    int run();
+
+    /**!
+     * @brief Prints the onboarding throughput and latency, and the controller memory and CPU use.
+     */
+    void print_summary(FILE *out);
+
+    em_mesh_sim_stats_t *get_stats() { return &m_stats; }
+
+    em_mesh_sim_t();
+    ~em_mesh_sim_t();
+};
+
+#endif
@@ -21,10 +21,122 @@
 
 #include "em_base.h"
 #include "dm_easy_mesh.h"
+#include "em_tlv_writer.h"
+#include "em_unassoc_sta.h"
+
+#include <unordered_map>
+#include <deque>
+#include <pthread.h>
+
+// 1s ticks of a round in which the controller queries every agent for STA link metrics
+#define EM_STA_LINK_METRICS_POLL_SLOTS  10
+// STA MAC Address TLVs that fit in a single frame Associated STA Link Metrics Query
+#define EM_STA_LINK_METRICS_QUERY_MAX_BATCH ((ETH_DATA_LEN - sizeof(em_cmdu_t) - sizeof(em_tlv_t)) / \
+                                                (sizeof(em_tlv_t) + sizeof(mac_address_t)))
+// AP Metrics Responses between two that report every BSS and STA, the others only report those that changed enough
+#define EM_AP_METRICS_FULL_REPORT_INTERVAL  10
+// A BSS is reported again once the utilization of its channel moved by this much, out of 255,
+// unless the Metric Reporting Policy of its radio sets a threshold
+#define EM_AP_METRICS_UTIL_DELTA    10
+// or once it sent or received this many unicast bytes since its last report
+#define EM_AP_METRICS_BSS_BYTES_DELTA   (1024 * 1024)
+// A STA is reported again once it sent or received this many bytes since its last report
+#define EM_STA_REPORT_BYTES_DELTA   (64 * 1024)
+// or once its RCPI moved by this much, in 0.5 dB steps
+#define EM_STA_REPORT_RCPI_DELTA    4
+// Beacon Metrics Queries sent per em and per tick, the rest waits for the next tick
+#define EM_BEACON_QUERY_BATCH       4
+// STAs waiting for a Beacon Metrics Query per em, further requests are refused
+#define EM_BEACON_QUERY_MAX_PENDING 64
+// A query without a response after this time no longer holds back a new one for its STA
+#define EM_BEACON_QUERY_TIMEOUT_MS  10000
+
+typedef enum {
+    em_sta_report_type_ap_metrics,      // STA TLVs of the periodic AP Metrics Responses
+    em_sta_report_type_link_metrics,    // Associated STA Link Metrics Responses pushed on STA updates
+    em_sta_report_type_max
+} em_sta_report_type_t;
+
+/**
+ * @brief Thresholds of the AP Metrics Responses, defaults from the EM_AP_METRICS and EM_STA_REPORT constants
+ */
+typedef struct {
+    unsigned int full_interval;         // responses between two full ones, 0 or 1 for always full
+    unsigned int util_delta;            // of the channel utilization of a BSS
+    unsigned int bss_bytes_delta;       // of the unicast bytes of a BSS
+    unsigned int sta_bytes_delta;       // of the bytes of a STA
+    unsigned int sta_rcpi_delta;        // of the RCPI of a STA
+} em_ap_metrics_delta_params_t;
+
+/**
+ * @brief A BSS as last reported to the controller
+ */
+typedef struct {
+    unsigned int util;
+    unsigned int num_sta;
+    unsigned int bytes_sent;
+    unsigned int bytes_rcvd;
+    unsigned int gen;       // generation of the report in which the BSS was last seen
+} em_bss_report_snapshot_t;
+
+/**
+ * @brief A STA as last reported to the controller
+ */
+typedef struct {
+    unsigned int bytes_tx;
+    unsigned int bytes_rx;
+    unsigned char rcpi;
+    unsigned int gen;       // generation of the report in which the STA was last seen
+} em_sta_report_snapshot_t;
+
+/**
+ * @brief Size of the AP Metrics Responses sent
+ */
+typedef struct {
+    unsigned int reports;
+    unsigned long long bytes;           // over all reports
+    unsigned int last_bytes;
+    unsigned int last_frames;
+    unsigned int stas_reported;         // over all reports
+    unsigned int stas_unchanged;        // left out of the reports, over all reports
+    unsigned int bsss_reported;         // over all reports
+    unsigned int bsss_unchanged;        // AP Metrics TLVs left out of the reports, over all reports
+} em_ap_metrics_report_stats_t;
+
+/**
+ * @brief A STA waiting for a Beacon Metrics Query
+ */
+typedef struct {
+    mac_address_t sta;
+    bssid_t bssid;          // BSSID to measure, wildcard for all
+} em_beacon_query_req_t;
 
 class em_mgr_t;
 class em_metrics_t {
 
+	unsigned int m_sta_query_batch;
+
+	// STAs as last reported, per kind of report, keyed by their MAC packed in an integer
+	std::unordered_map<unsigned long long, em_sta_report_snapshot_t> m_sta_last_report[em_sta_report_type_max];
+	unsigned int m_sta_report_gen[em_sta_report_type_max];
+	em_ap_metrics_report_stats_t m_ap_metrics_stats;
+
+	// BSSs as last reported by the AP Metrics Responses, keyed by their BSSID packed in an integer
+	std::unordered_map<unsigned long long, em_bss_report_snapshot_t> m_bss_last_report;
+	unsigned int m_bss_report_gen;
+	em_ap_metrics_delta_params_t m_ap_delta;
+
+	// Beacon Metrics Queries waiting for the next tick, and the STAs queried, keyed by their
+	// MAC packed in an integer, with the time of the query
+	pthread_mutex_t m_beacon_lock;
+	std::deque<em_beacon_query_req_t> m_beacon_queue;
+	std::unordered_map<unsigned long long, unsigned long long> m_beacon_inflight;
+
+	// Unassociated STA Link Metrics Queries waiting for the next tick, and the STAs queried
+	pthread_mutex_t m_unassoc_lock;
+	std::deque<em_unassoc_sta_target_t> m_unassoc_queue;
+	std::unordered_map<unsigned long long, unsigned long long> m_unassoc_inflight;
+
     
 	/**!
 	 * @brief Retrieves the data model instance.
@@ -73,6 +185,25 @@ class em_metrics_t {
 	 * @note Ensure the buffer is properly allocated and the length is correctly specified.
 	 */
 	virtual int send_frame(unsigned char *buff, unsigned int len, bool multicast = false) = 0;
+
+	/**!
+	 * @brief Sends a burst of frames, e.g. the fragments of one CMDU.
+	 *
+	 * @param[in] buffs Array of pointers to the frames.
+	 * @param[in] lens Array of frame lengths.
+	 * @param[in] num Number of frames.
+	 * @param[in] multicast Flag indicating whether the frames should be sent as multicast.
+	 *
+	 * @returns Number of frames sent, or -1 if none could be sent.
+	 */
+	virtual int send_frames(unsigned char **buffs, unsigned int *lens, unsigned int num, bool multicast = false) = 0;
+
+	/**!
+	 * @brief Returns the TLV writer used to build outgoing messages.
+	 *
+	 * @note This is a pure virtual function and must be implemented by derived classes.
+	 */
+	virtual em_tlv_writer_t *get_tlv_writer() = 0;
     
 	/**!
 	 * @brief Retrieves the profile type.
@@ -101,10 +232,21 @@ class em_metrics_t {
 	 * @brief Sends link metrics message to all associated stations.
 	 *
 	 * This function is responsible for sending link metrics messages to all stations that are currently associated.
+	 * Each query carries up to set_sta_link_metrics_query_batch() STA MAC Address TLVs.
 	 *
 	 * @note Ensure that the station list is up-to-date before calling this function.
 	 */
 	void send_all_associated_sta_link_metrics_msg();
+
+	/**!
+	 * @brief Sends one Associated STA Link Metrics Query for several stations.
+	 *
+	 * @param[in] sta_macs The MAC addresses of the stations.
+	 * @param[in] num The number of stations, at most EM_STA_LINK_METRICS_QUERY_MAX_BATCH.
+	 *
+	 * @returns int The length sent, -1 on failure.
+	 */
+	int send_associated_sta_link_metrics_batch(mac_address_t *sta_macs, unsigned int num);
     
 	/**!
 	 * @brief Sends a link metrics message to the associated station.
@@ -143,6 +285,17 @@ class em_metrics_t {
 	 */
 	int send_associated_link_metrics_response(mac_address_t sta_mac, unsigned short msg_id);
 
+	/**!
+	 * @brief Sends one response with the link metrics of several stations, answering a batched query.
+	 *
+	 * @param[in] sta_macs The MAC addresses of the stations.
+	 * @param[in] num The number of stations.
+	 * @param[in] msg_id The message ID of the query.
+	 *
+	 * @returns int The length sent, -1 on failure.
+	 */
+	int send_associated_link_metrics_response(mac_address_t *sta_macs, unsigned int num, unsigned short msg_id);
+
 	/**!
 	 * @brief Sends link metrics message for associated stations.
 	 *
@@ -265,6 +418,29 @@ class em_metrics_t {
 	 */
 	int handle_beacon_metrics_response(unsigned char *buff, unsigned int len);
 
+	/**!
+	 * @brief Handles an Unassociated STA Link Metrics Query, on the agent.
+	 *
+	 * @param[in] buff Pointer to the buffer containing the query.
+	 * @param[in] len Length of the buffer.
+	 *
+	 * @returns 0 on success, -1 on failure.
+	 */
+	int handle_unassoc_sta_link_metrics_query(unsigned char *buff, unsigned int len);
+
+	/**!
+	 * @brief Handles an Unassociated STA Link Metrics Response, on the controller.
+	 *
+	 * Each STA measured becomes an entry of the unassociated STA cache of the manager, for
+	 * the BSS of the agent on the channel of the measurement.
+	 *
+	 * @param[in] buff Pointer to the buffer containing the response.
+	 * @param[in] len Length of the buffer.
+	 *
+	 * @returns Number of entries added, -1 on failure.
+	 */
+	int handle_unassoc_sta_link_metrics_response(unsigned char *buff, unsigned int len);
+
   	/**!
 	 * @brief Handles the associated station traffic statistics.
 	 *
@@ -422,6 +598,30 @@ class em_metrics_t {
 	 */
 	int send_beacon_metrics_response();
 
+	/**!
+	 * @brief Sends an Unassociated STA Link Metrics Query for the targets of an op class.
+	 *
+	 * @param[in] op_class The op class.
+	 * @param[in] targets The targets, those of other op classes are left out.
+	 * @param[in] num Number of targets.
+	 *
+	 * @returns Length of the query, -1 on failure.
+	 */
+	int send_unassoc_sta_link_metrics_query(unsigned char op_class, const em_unassoc_sta_target_t *targets, unsigned int num);
+
+	/**!
+	 * @brief Sends an Unassociated STA Link Metrics Response.
+	 *
+	 * @param[in] op_class The op class of the query.
+	 * @param[in] meas The measurements.
+	 * @param[in] num Number of measurements.
+	 * @param[in] msg_id Message ID of the query.
+	 *
+	 * @returns Length of the response, -1 on failure.
+	 */
+	int send_unassoc_sta_link_metrics_response(unsigned char op_class, const em_unassoc_sta_meas_t *meas, unsigned int num,
+	                                           unsigned short msg_id);
+
         /**!
 	 * @brief Sends the AP metrics response.
 	 *
@@ -493,6 +693,45 @@ class em_metrics_t {
 	 */
 	short create_radio_metrics_tlv(unsigned char *buff);
     
+	/**!
+	 * @brief Checks whether a STA is to be reported, the first time it is seen or once it crossed a threshold.
+	 *
+	 * The STA is marked as seen in the current generation and its snapshot is updated when it is reported.
+	 *
+	 * @param[in] type The kind of report.
+	 * @param[in] sta The STA.
+	 * @param[in] full True if the report has every STA.
+	 *
+	 * @returns true if the STA is to be reported.
+	 */
+	bool sta_report_due(em_sta_report_type_t type, const dm_sta_t *const sta, bool full);
+
+	/**!
+	 * @brief Forgets the STAs not seen in the current generation of a kind of report and starts the next one.
+	 *
+	 * @param[in] type The kind of report.
+	 */
+	void sta_report_prune(em_sta_report_type_t type);
+
+	/**!
+	 * @brief Checks whether the AP Metrics of a BSS are to be reported, the first time it is seen or once it crossed a threshold.
+	 *
+	 * The BSS is marked as seen in the current generation and its snapshot is updated when it is reported.
+	 *
+	 * @param[in] bss The BSS.
+	 * @param[in] util Utilization of the channel of the BSS.
+	 * @param[in] util_delta Change of the utilization that is reported.
+	 * @param[in] full True if the report has every BSS.
+	 *
+	 * @returns true if the BSS is to be reported.
+	 */
+	bool bss_report_due(const dm_bss_t& bss, unsigned int util, unsigned int util_delta, bool full);
+
+	/**!
+	 * @brief Forgets the BSSs not seen in the current generation of AP Metrics Responses and starts the next one.
+	 */
+	void bss_report_prune();
+
 	/**!
 	 * @brief Creates an associated station traffic statistics TLV.
 	 *
@@ -569,6 +808,96 @@ public:
 	 */
 	void process_agent_state();
 
+	/**!
+	 * @brief Sets the number of stations queried per Associated STA Link Metrics Query.
+	 *
+	 * The specification has one STA MAC Address TLV per query, the default. A larger batch is
+	 * only for agents that answer every TLV of the query, as this one does.
+	 *
+	 * @param[in] batch The number of stations, clamped to 1..EM_STA_LINK_METRICS_QUERY_MAX_BATCH.
+	 */
+	void set_sta_link_metrics_query_batch(unsigned int batch);
+
+	/**!
+	 * @brief Retrieves the slot of the polling round in which the controller queries this agent.
+	 *
+	 * The slot is derived from the AL MAC of the agent, so all its radios share it and the agents
+	 * are spread over the round.
+	 *
+	 * @returns The slot, below EM_STA_LINK_METRICS_POLL_SLOTS.
+	 */
+	unsigned int get_sta_link_metrics_poll_slot();
+
+	/**!
+	 * @brief Retrieves the size of the AP Metrics Responses sent so far.
+	 *
+	 * @returns The report statistics.
+	 */
+	const em_ap_metrics_report_stats_t& get_ap_metrics_report_stats() { return m_ap_metrics_stats; }
+
+	/**!
+	 * @brief Sets the thresholds below which BSSs and STAs are left out of the AP Metrics Responses.
+	 *
+	 * @param[in] params The thresholds, the next response is a full one.
+	 */
+	void set_ap_metrics_delta_params(const em_ap_metrics_delta_params_t *params);
+
+	/**!
+	 * @brief Retrieves the thresholds of the AP Metrics Responses.
+	 */
+	const em_ap_metrics_delta_params_t& get_ap_metrics_delta_params() { return m_ap_delta; }
+
+	/**!
+	 * @brief Requests a Beacon Report of a station, before steering it.
+	 *
+	 * The query is sent by send_pending_beacon_queries() on a later tick. Nothing is queued if
+	 * the station is already queued or queried, or if its cached reports are still fresh.
+	 *
+	 * @param[in] sta_mac The MAC address of the station.
+	 * @param[in] bssid The BSSID to measure, the wildcard BSSID for all.
+	 *
+	 * @returns 1 if the station was queued, 0 if no query is needed, -1 if the queue is full.
+	 */
+	int request_beacon_report(mac_address_t sta_mac, bssid_t bssid);
+
+	/**!
+	 * @brief Sends up to EM_BEACON_QUERY_BATCH queued Beacon Metrics Queries, called every controller tick.
+	 *
+	 * @returns The number of queries sent.
+	 */
+	unsigned int send_pending_beacon_queries();
+
+	/**!
+	 * @brief Returns true if Beacon Metrics Queries are queued or wait for their report.
+	 */
+	bool has_pending_beacon_queries();
+
+	/**!
+	 * @brief Requests the link metrics of a STA not associated with the agent of the em.
+	 *
+	 * The STA is queued, send_pending_unassoc_sta_queries() sends the queued STAs of an op
+	 * class in a single query. Nothing is queued if the STA is already queued or queried.
+	 *
+	 * @param[in] sta_mac The MAC address of the station.
+	 * @param[in] op_class The op class to measure on.
+	 * @param[in] channel The channel to measure on.
+	 *
+	 * @returns 1 if the station was queued, 0 if no query is needed, -1 if the queue is full.
+	 */
+	int request_unassoc_sta_metrics(mac_address_t sta_mac, unsigned char op_class, unsigned char channel);
+
+	/**!
+	 * @brief Sends the queued Unassociated STA Link Metrics Queries, one per op class, called every controller tick.
+	 *
+	 * @returns The number of queries sent.
+	 */
+	unsigned int send_pending_unassoc_sta_queries();
+
+	/**!
+	 * @brief Returns true if Unassociated STA Link Metrics Queries are queued or wait for their response.
+	 */
+	bool has_pending_unassoc_sta_queries();
+
     
 	/**!
 	 * @brief Constructor for the em_metrics_t class.
@@ -0,0 +1,177 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_METRICS_HISTORY_H
+#define EM_METRICS_HISTORY_H
+
+#include <pthread.h>
+#include "em_base.h"
+#include "em_mac_index.h"
+
+#define EM_METRICS_HISTORY_LEN          32      // samples kept per entity, a power of two
+#define EM_METRICS_HISTORY_MIN_ROWS     64
+#define EM_METRICS_HISTORY_EWMA_SHIFT   3       // weight of a new sample in the EWMA, 1/8
+#define EM_METRICS_HISTORY_EWMA_FRAC    8       // fractional bits of the EWMA
+
+/*
+ * One metrics sample. A STA sample has the RCPI, the estimated MAC data rates and the
+ * sum of its transmit and receive utilization. A BSS sample has the channel utilization
+ * in util, its other fields are 0.
+ */
+typedef struct {
+    unsigned long long  time_ms;        // CLOCK_MONOTONIC milliseconds
+    unsigned char       rcpi;
+    unsigned int        ul_rate;
+    unsigned int        dl_rate;
+    unsigned int        util;
+} em_metrics_sample_t;
+
+typedef struct {
+    unsigned int        num;            // samples in the window
+    em_metrics_sample_t min;            // per field, time_ms of the oldest sample in the window
+    em_metrics_sample_t max;            // per field, time_ms of the newest sample
+    em_metrics_sample_t ewma;           // over every sample of the entity, time_ms of the newest one
+} em_metrics_aggregate_t;
+
+typedef struct {
+    mac_address_t       mac;
+    unsigned int        head;           // slot of the next sample
+    unsigned int        num;            // samples in the ring, at most EM_METRICS_HISTORY_LEN
+    long long           ewma_rcpi;      // scaled by 2^EM_METRICS_HISTORY_EWMA_FRAC
+    long long           ewma_ul_rate;
+    long long           ewma_dl_rate;
+    long long           ewma_util;
+    em_metrics_sample_t samples[EM_METRICS_HISTORY_LEN];
+} em_metrics_history_row_t;
+
+/*
+ * Recent metrics samples of STAs or BSSs, a fixed size ring per entity keyed by its MAC.
+ * The metrics handlers append a sample when they update the data model, so steering and
+ * diagnostics see a trend rather than the last value, without writes to the database.
+ * Appending is O(1) and keeps the EWMA up to date, min and max are over a time window
+ * of the ring. Rows are dense, removing an entity moves the last row into its place.
+ * Thread safe.
+ */
+class em_metrics_history_t {
+
+    pthread_rwlock_t m_lock;
+    em_metrics_history_row_t *m_rows;
+    unsigned int m_num_rows;
+    unsigned int m_size;                // rows allocated
+    em_mac_index_t m_index;             // MAC -> row + 1
+
+    /**!
+     * @brief Doubles the rows.
+     *
+     * @returns 0 on success, -1 on allocation failure, the rows are then unchanged.
+     */
+    int grow();
+
+    /**!
+     * @brief Returns the row of an entity, NULL if it has no samples. The lock must be held.
+     */
+    em_metrics_history_row_t *find(const unsigned char *mac) const;
+
+public:
+
+    /**!
+     * @brief Returns the current CLOCK_MONOTONIC time in milliseconds, for the time of the samples.
+     */
+    static unsigned long long now_ms();
+
+    /**!
+     * @brief Appends a sample to the ring of an entity, overwriting its oldest sample when full.
+     *
+     * @param[in] mac MAC address of the STA or BSSID of the BSS.
+     * @param[in] sample The sample.
+     *
+     * @returns 0 on success, -1 if the row could not be allocated.
+     */
+    int append(const unsigned char *mac, const em_metrics_sample_t *sample);
+
+    /**!
+     * @brief Computes the aggregates of an entity.
+     *
+     * @param[in] mac MAC address of the entity.
+     * @param[in] window_ms Min and max are over the samples of the last window_ms milliseconds, 0 for the whole ring.
+     * @param[in] now Current time, see now_ms().
+     * @param[out] agg The aggregates.
+     *
+     * @returns True if the entity has samples, false otherwise.
+     */
+    bool get_aggregate(const unsigned char *mac, unsigned int window_ms, unsigned long long now, em_metrics_aggregate_t *agg);
+
+    /**!
+     * @brief Copies the most recent samples of an entity, oldest first.
+     *
+     * @param[in] mac MAC address of the entity.
+     * @param[out] samples Array receiving the samples.
+     * @param[in] max Size of the array.
+     *
+     * @returns Number of samples stored.
+     */
+    unsigned int get_samples(const unsigned char *mac, em_metrics_sample_t *samples, unsigned int max);
+
+    /**!
+     * @brief Returns the entities whose RCPI EWMA is below a threshold, for steering candidates.
+     *
+     * A single low sample does not make a STA weak, its EWMA has to go down.
+     *
+     * @param[in] rcpi_thresh RCPI threshold.
+     * @param[in] min_samples Entities with fewer samples are skipped.
+     * @param[out] macs Array receiving the MAC addresses.
+     * @param[in] max Size of the array.
+     *
+     * @returns Number of entities stored.
+     */
+    unsigned int find_weak(unsigned char rcpi_thresh, unsigned int min_samples, mac_address_t *macs, unsigned int max);
+
+    /**!
+     * @brief Removes the samples of an entity.
+     *
+     * @param[in] mac MAC address of the entity.
+     *
+     * @returns True if the entity had samples, false otherwise.
+     */
+    bool remove(const unsigned char *mac);
+
+    /**!
+     * @brief Returns the number of entities with samples.
+     */
+    unsigned int count();
+
+    /**!
+     * @brief Removes all entities and frees the rows.
+     */
+    void clear();
+
+    /**!
+     * @brief Constructor for em_metrics_history_t.
+     */
+    em_metrics_history_t();
+
+    /**!
+     * @brief Destructor for em_metrics_history_t.
+     */
+    ~em_metrics_history_t();
+
+    em_metrics_history_t(const em_metrics_history_t&) = delete;
+    em_metrics_history_t& operator=(const em_metrics_history_t&) = delete;
+};
+
+#endif
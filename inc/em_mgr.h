@@ -21,21 +21,131 @@
 
 #include "em.h"
 #include "em_orch.h"
+#include "em_event_pool.h"
+#include "em_frame_ring.h"
+#include "em_cmdu_reasm.h"
+#include "em_rx_shard.h"
+#include "em_worker_pool.h"
+#include "em_crypto_pool.h"
+#include "em_mac_index.h"
+#include "em_mpsc_queue.h"
+#include "em_timer_wheel.h"
+#include "em_sta_metrics_table.h"
+#include "em_metrics_history.h"
+#include "em_beacon_report_cache.h"
+#include "em_beacon_report_agg.h"
+#include "em_client_cap_cache.h"
+#include "em_steer_outcome.h"
+#include "em_policy_push.h"
+#include "em_blocklist.h"
+#include "em_topo_sched.h"
+#include "em_bh_steer.h"
+#include "em_cac_sched.h"
+#include "em_color_planner.h"
+#include "em_spectrum_cache.h"
+#include "em_optimiser.h"
 #include "ieee80211.h"
 
+// timer armed from another thread, waiting for the manager thread to put it on the wheel
+typedef struct {
+    em_timer_t *t;
+    uint64_t deadline_ms;
+    em_timer_cb_t cb;
+    void *arg;
+} em_mgr_async_timer_t;
+
 class em_mgr_t {
    
     pthread_t   m_tid;
-    bool m_exit;
-    em_queue_t  m_queue;
-	unsigned int m_tick_demultiplex;
+    std::atomic<bool> m_exit;
+    em_mpsc_queue_t  m_queue;
+    unsigned int m_queue_timeout;
+    pthread_t   m_queue_tid;
+    std::atomic<bool> m_queue_running;  // m_queue_tid is set, the manager loop drains the queue
+    unsigned int m_coalesced;
+    std::atomic<bool> m_orch_kick;
+    em_event_pool_t m_event_pool;
+    em_frame_ring_t m_rx_ring;
+    em_cmdu_reasm_t m_reasm;        // fragments received by the listener
+    em_rx_shard_pool_t m_rx_shards; // reassemble and route the frames of their agents when started
+    unsigned int m_num_rx_shards;
+    pthread_mutex_t m_route_lock;   // find_em_for_msg_type() may create ems and data models
+    em_worker_pool_t m_workers;     // runs the ems unless built with EM_THREAD_PER_NODE
+    em_crypto_pool_t m_crypto_pool; // DH computations of the onboarding ems
+
+    // binary MAC indexes of m_em_map, a hit is checked against the node before it is returned
+    pthread_rwlock_t m_index_lock;
+    em_mac_index_t m_ruid_index;    // radio interface MAC -> node, AL nodes excluded
+    em_mac_index_t m_al_index;      // AL MAC of the data model -> nodes of the device, AL nodes excluded
+    em_mac_index_t m_al_node_index; // AL MAC -> AL node
+    em_mac_index_t m_bss_index;     // BSSID -> radio node, filled by the lookups
+    em_t *m_al_node;
+    std::vector<em_t *> m_radio_nodes;  // candidates of the network wide commands, in the order they were added
+    std::vector<em_t *> m_al_nodes;
+
+    /**!
+     * @brief Adds a node to the MAC indexes, called once it is in m_em_map.
+     *
+     * @param[in] em Pointer to the node.
+     */
+    void index_node(em_t *em);
+
+    /**!
+     * @brief Removes every index entry of a node.
+     *
+     * @param[in] em Pointer to the node.
+     */
+    void unindex_node(em_t *em);
+
+    /**!
+     * @brief Checks whether a radio node holds a BSS in its data model.
+     *
+     * @param[in] em Pointer to the node.
+     * @param[in] bssid BSSID.
+     */
+    static bool is_bss_of_node(em_t *em, const unsigned char *bssid);
+    em_timer_wheel_t m_timers;
+    em_timer_t  m_500ms_timer;
+    em_timer_t  m_1s_timer;
+    em_timer_t  m_2s_timer;
+    em_timer_t  m_5s_timer;
+    pthread_mutex_t m_async_timer_lock;
+    std::vector<em_mgr_async_timer_t> m_async_timers;   // see add_timer_async()
 	unsigned short m_msg_id;
+    em_msg_type_stats_t m_msg_stats[EM_MSG_TYPE_SLOTS];     // frames routed by the listener, drops had no target em
+    em_sta_metrics_table_t m_sta_metrics;  // metrics of all STAs, fed by the metrics handlers of the ems
+    em_metrics_history_t m_sta_history;     // recent samples of every STA
+    em_metrics_history_t m_bss_history;     // recent samples of every BSS
+    em_beacon_report_cache_t m_beacon_reports;  // Beacon Reports of every STA
+    em_beacon_report_cache_t m_unassoc_stas;    // STAs as measured by the agents they are not associated with
+    em_beacon_report_agg_t m_beacon_agg;    // Beacon Reports of the STAs the agent is measuring, merged per STA
+    em_client_cap_cache_t m_client_caps;    // parsed client capabilities of every STA
+    em_steer_outcome_table_t m_steer_outcomes;  // outstanding steers and their outcomes per agent
+    em_policy_push_t m_policy_push;     // policy encodings shared by the agents and the requests waiting for their ACK
+    em_blocklist_t m_blocklist;     // STAs blocked from the local BSSs by the controller
+    em_topo_sched_t m_topo_sched;   // when the topology of each onboarded agent is queried
+    em_bh_steer_t m_bh_steer;       // backhaul steers in flight and their latency per agent
+    em_cac_sched_t m_cac_sched;     // DFS channel states of the agents and their CACs in flight
+    em_color_planner_t m_color_planner;     // BSS colors and spatial reuse groups planned for the radios
+    em_spectrum_cache_t m_spectrum_cache;   // 6 GHz spectrum the AFC system made available, per location
+    em_optimiser_host_t m_optimiser;    // optimisation plugins, fed with the changes of the mesh
+    pthread_mutex_t m_scan_result_lock;     // scan result maps of the data models, filled by the ems, aged by the manager
 
 public:
 	pthread_mutex_t m_mutex;
     hash_map_t      *m_em_map;
     unsigned int m_timeout;
     fd_set  m_rset;
+    int     m_epoll_fd;
+    int     m_wakeup_fd;
+    int     m_netlink_fd;
+    pthread_mutex_t m_listener_lock;
+    pthread_cond_t  m_listener_cond;
+    pthread_t   m_listener_tid;
+    bool    m_listener_running;         // the epoll listener loop runs
+    unsigned long long m_listener_gen;  // event batches the epoll listener has finished
+    struct epoll_event *m_listener_batch;   // batch the epoll listener is handling, listener thread only
+    int     m_listener_batch_num;
     
     
 	/**!
@@ -72,6 +182,25 @@ public:
 	 */
 	int start();
 
+	/**!
+	 * @brief Stops the manager loop and the epoll listener.
+	 *
+	 * Wakes the listener out of epoll_wait() and returns once it has left its loop.
+	 */
+	void stop();
+
+	/**!
+	 * @brief Handles a batch of events drained from the manager queue and frees them.
+	 *
+	 * An event that coalesce_event() reports as covered by the event right after it
+	 * is freed without being handled. Events are never merged across another event,
+	 * which would then be handled before work queued ahead of it.
+	 *
+	 * @param[in] evts Array of events in queue order.
+	 * @param[in] num Number of events in the array.
+	 */
+	void handle_event_batch(em_event_t **evts, unsigned int num);
+
     
 	/**!
 	 * @brief Checks if the data model is initialized.
@@ -106,6 +235,25 @@ public:
 	 */
 	em_event_t *pop_from_queue();
 
+	/**!
+	 * @brief Allocates an event for the manager queue from the event pool.
+	 *
+	 * Every event pushed with push_to_queue() must be obtained from this function,
+	 * the manager returns it to the pool once it has been handled.
+	 *
+	 * @param[in] data_len Number of payload bytes following the em_event_t header.
+	 *
+	 * @returns Pointer to the zeroed event header, or NULL on failure.
+	 */
+	em_event_t *alloc_event(unsigned int data_len);
+
+	/**!
+	 * @brief Returns an event obtained from alloc_event() to the event pool.
+	 *
+	 * @param[in] evt Pointer to the event.
+	 */
+	void free_event(em_event_t *evt);
+
     
 	/**!
 	 * @brief Listens to the nodes for incoming data or signals.
@@ -147,6 +295,202 @@ public:
 	 */
 	void proto_process(unsigned char *data, unsigned int len, em_t *em = NULL);
 
+	/**!
+	 * @brief Hands a received frame to the target em_t without copying it.
+	 *
+	 * The frame event embedded in the receive buffer is queued to the em_t found by
+	 * find_em_for_msg_type(). Ownership of the buffer reference passes to the target
+	 * queue, or the buffer is released if no target is found.
+	 *
+	 * @param[in] buff Receive buffer holding the frame.
+	 * @param[in] len Length of the frame.
+	 * @param[in] em Optional pointer to the AL interface node the frame was received on.
+	 */
+	void proto_process(em_rx_buff_t *buff, unsigned int len, em_t *em = NULL);
+
+	/**!
+	 * @brief Reassembles a received frame, counts it and queues it to its target em_t.
+	 *
+	 * Runs on the listener, or on the receive shard owning the source of the frame.
+	 *
+	 * @param[in] reasm Reassembler of the calling thread.
+	 * @param[in] stats Routing counters of the calling thread, EM_MSG_TYPE_SLOTS of them.
+	 * @param[in] buff Receive buffer holding the frame.
+	 * @param[in] len Length of the frame.
+	 * @param[in] em Optional pointer to the AL interface node the frame was received on.
+	 */
+	void route_frame(em_cmdu_reasm_t *reasm, em_msg_type_stats_t *stats, em_rx_buff_t *buff, unsigned int len, em_t *em);
+
+	/**!
+	 * @brief Routes a frame on its receive shard, see em_rx_shard_route_cb_t.
+	 */
+	static void rx_shard_route(void *ctx, em_rx_shard_t *shard, em_rx_buff_t *buff, unsigned int len, void *src);
+
+	/**!
+	 * @brief Sets the number of receive shards started by init().
+	 *
+	 * With 0, the default, the listener reassembles and routes every frame itself.
+	 *
+	 * @param[in] num Number of shards, at most EM_RX_SHARD_MAX.
+	 */
+	void set_rx_shards(unsigned int num) { m_num_rx_shards = num; }
+
+	/**!
+	 * @brief Returns the receive shards, the pool has no shard unless set_rx_shards() was called.
+	 */
+	em_rx_shard_pool_t *get_rx_shards() { return &m_rx_shards; }
+
+	/**!
+	 * @brief Releases a frame event queued by proto_process() once it has been handled.
+	 *
+	 * @param[in] evt Pointer to the frame event.
+	 */
+	void free_frame_event(em_event_t *evt);
+
+	/**!
+	 * @brief Hands a received 802.11 action frame to the home worker of an em_t.
+	 *
+	 * The frame is copied into a receive buffer and queued on the em_t like a 1905
+	 * frame, bypassing the manager queue, handle_node_action_frame() then runs it.
+	 * Safe to call from any thread.
+	 *
+	 * @param[in] em Pointer to the em_t.
+	 * @param[in] frame Pointer to the frame.
+	 * @param[in] len Length of the frame.
+	 *
+	 * @returns True if the frame was handed over, false if no buffer could be taken.
+	 */
+	bool push_node_action_frame(em_t *em, const unsigned char *frame, unsigned int len);
+
+	/**!
+	 * @brief Handles an action frame queued by push_node_action_frame(). Optional to implement.
+	 *
+	 * Runs on the home worker of the em_t, or its thread, never on the manager thread.
+	 *
+	 * @param[in] em Pointer to the em_t the frame was queued on.
+	 * @param[in] frame Pointer to the frame, valid until the function returns.
+	 * @param[in] len Length of the frame.
+	 */
+	virtual void handle_node_action_frame(em_t *em, unsigned char *frame, unsigned int len) { }
+
+	/**!
+	 * @brief Returns the routing counters of a message type, summed over the listener and the receive shards.
+	 *
+	 * @param[in] type Message type.
+	 * @param[out] stats Counters.
+	 */
+	void get_msg_stats(em_msg_type_t type, em_msg_type_stats_t *stats);
+
+	/**!
+	 * @brief Returns the metrics table of all STAs, for scans across the whole mesh.
+	 */
+	em_sta_metrics_table_t *get_sta_metrics() { return &m_sta_metrics; }
+
+	/**!
+	 * @brief Returns the recent link metrics samples of every STA, keyed by STA MAC.
+	 */
+	em_metrics_history_t *get_sta_history() { return &m_sta_history; }
+
+	/**!
+	 * @brief Returns the recent channel utilization samples of every BSS, keyed by BSSID.
+	 */
+	em_metrics_history_t *get_bss_history() { return &m_bss_history; }
+
+	/**!
+	 * @brief Returns the Beacon Reports of every STA, keyed by STA, BSSID and channel.
+	 */
+	em_beacon_report_cache_t *get_beacon_reports() { return &m_beacon_reports; }
+
+	/**!
+	 * @brief Returns the Unassociated STA Link Metrics of every STA, keyed by STA, BSSID and channel.
+	 *
+	 * An entry is the BSS of the agent that measured the STA on the channel, a steering target.
+	 */
+	em_beacon_report_cache_t *get_unassoc_stas() { return &m_unassoc_stas; }
+
+	/**!
+	 * @brief Returns the Beacon Reports of the STAs the agent is measuring, until their response is sent.
+	 */
+	em_beacon_report_agg_t *get_beacon_agg() { return &m_beacon_agg; }
+
+	/**!
+	 * @brief Returns the client capabilities of every STA, kept across associations.
+	 */
+	em_client_cap_cache_t *get_client_caps() { return &m_client_caps; }
+
+	/**!
+	 * @brief Returns the outstanding steers, keyed by STA and message id, and the outcomes per agent.
+	 */
+	em_steer_outcome_table_t *get_steer_outcomes() { return &m_steer_outcomes; }
+
+	/**!
+	 * @brief Returns the cached Multi-AP Policy Config Request encodings and the requests waiting for their ACK.
+	 */
+	em_policy_push_t *get_policy_push() { return &m_policy_push; }
+
+	/**!
+	 * @brief Returns the STAs blocked from the local BSSs by Client Association Control Requests.
+	 */
+	em_blocklist_t *get_blocklist() { return &m_blocklist; }
+
+	/**!
+	 * @brief Returns the schedule of the Topology Queries to the onboarded agents.
+	 */
+	em_topo_sched_t *get_topo_sched() { return &m_topo_sched; }
+
+	/**!
+	 * @brief Returns the backhaul steering of the agents, their steers in flight and latencies.
+	 */
+	em_bh_steer_t *get_bh_steer() { return &m_bh_steer; }
+
+	/**!
+	 * @brief Returns the DFS channel states of the agents and the admission of their CACs.
+	 */
+	em_cac_sched_t *get_cac_sched() { return &m_cac_sched; }
+
+	/**!
+	 * @brief Returns the BSS color and spatial reuse planner of the radios.
+	 */
+	em_color_planner_t *get_color_planner() { return &m_color_planner; }
+
+	/**!
+	 * @brief Locks the scan result maps of the data models.
+	 *
+	 * Held by a handler while it finds, creates and fills results, and by the manager while
+	 * it expires or evicts them, so that no result is deleted while it is being filled.
+	 */
+	void lock_scan_results() { pthread_mutex_lock(&m_scan_result_lock); }
+
+	/**!
+	 * @brief Unlocks the scan result maps of the data models.
+	 */
+	void unlock_scan_results() { pthread_mutex_unlock(&m_scan_result_lock); }
+
+	/**!
+	 * @brief Returns the cache of the 6 GHz spectrum available at the locations of the agents.
+	 */
+	em_spectrum_cache_t *get_spectrum_cache() { return &m_spectrum_cache; }
+
+	/**!
+	 * @brief Returns the host of the optimisation plugins.
+	 */
+	em_optimiser_host_t *get_optimiser() { return &m_optimiser; }
+
+	/**!
+	 * @brief Returns the reassembler of the fragmented messages received by the listener.
+	 */
+	em_cmdu_reasm_t *get_reassembler() { return &m_reasm; }
+
+	/**!
+	 * @brief Returns the worker pool the ems are sharded onto, it has no workers in thread per em mode.
+	 */
+	em_worker_pool_t *get_worker_pool() { return &m_workers; }
+
+	/**!
+	 * @brief Returns the pool the ems offload their key agreements to, it has no workers if it failed to start.
+	 */
+	em_crypto_pool_t *get_crypto_pool() { return &m_crypto_pool; }
+
     
 	/**!
 	 * @brief Creates a new node with the specified parameters.
@@ -227,6 +571,49 @@ public:
 	*/
 	void get_all_em_for_al_mac(mac_address_t mac, std::vector<em_t*> &em_radios);
 
+	/**!
+	 * @brief Looks up a radio node by its radio interface MAC address.
+	 *
+	 * @param[in] ruid Radio interface MAC address.
+	 *
+	 * @returns Pointer to the node, NULL if there is none. AL nodes are never returned.
+	 */
+	em_t *get_node_by_ruid(const unsigned char *ruid);
+
+	/**!
+	 * @brief Looks up an AL node by its AL MAC address.
+	 *
+	 * @param[in] al_mac AL MAC address.
+	 *
+	 * @returns Pointer to the node, NULL if there is none.
+	 */
+	em_t *get_al_node_by_mac(const unsigned char *al_mac);
+
+	/**!
+	 * @brief Looks up the radio node whose data model has the BSS under its radio.
+	 *
+	 * @param[in] bssid BSSID.
+	 *
+	 * @returns Pointer to the node, NULL if there is none.
+	 *
+	 * @note Misses scan the nodes once and remember the result.
+	 */
+	em_t *get_node_by_bssid(const unsigned char *bssid);
+
+	/**!
+	 * @brief Returns the radio nodes, AL nodes excluded.
+	 *
+	 * @param[out] nodes Vector the nodes are appended to, in the order they were added.
+	 */
+	void get_radio_nodes(std::vector<em_t *> &nodes);
+
+	/**!
+	 * @brief Returns the AL nodes.
+	 *
+	 * @param[out] nodes Vector the nodes are appended to, in the order they were added.
+	 */
+	void get_al_nodes(std::vector<em_t *> &nodes);
+
 	/**!
 	 * @brief Listener for node events.
 	 *
@@ -253,16 +640,142 @@ public:
 	int reset_listeners();
 
 	/**!
-	 * @brief Handles the timeout event.
+	 * @brief Creates the epoll instance and the wake up eventfd used by the nodes listener.
 	 *
-	 * This function is called when a timeout occurs. It performs necessary
-	 * actions to handle the timeout situation.
+	 * If epoll is not available the listener falls back to the select() based loop.
 	 *
-	 * @note Ensure that the timeout duration is set appropriately before
-	 * calling this function.
+	 * @returns int
+	 * @retval 0 on success
+	 * @retval -1 on failure, select() fallback is used
+	 */
+	int init_listener();
+
+	/**!
+	 * @brief Registers the fd of an AL interface node with the epoll listener.
+	 *
+	 * Non AL nodes are ignored. In non AL_SAP builds the fd is switched to non blocking
+	 * mode and registered edge triggered.
+	 *
+	 * @param[in] em Pointer to the node to register.
+	 *
+	 * @returns int
+	 * @retval 0 on success or if nothing needs to be registered
+	 * @retval -1 on failure
+	 */
+	int register_listener(em_t *em);
+
+	/**!
+	 * @brief Removes the fd of an AL interface node from the epoll listener.
+	 *
+	 * Returns once the listener has finished the batch of events it was handling, so
+	 * that it no longer refers to the node and the node can be deleted. Called from the
+	 * listener itself, the node is skipped in the rest of the current batch instead.
+	 *
+	 * @param[in] em Pointer to the node to unregister.
+	 *
+	 * @note Must be called before the node fd is closed.
+	 */
+	void unregister_listener(em_t *em);
+
+	/**!
+	 * @brief Wakes the epoll listener out of epoll_wait().
+	 */
+	void wake_listener();
+
+	/**!
+	 * @brief Reads one frame from the AL interface node and hands it to proto_process.
+	 *
+	 * @param[in] em Pointer to the AL interface node.
+	 *
+	 * @returns True if a frame was read and more may be pending, false otherwise.
+	 */
+	bool read_al_node(em_t *em);
+
+	/**!
+	 * @brief Drains the netlink socket and invalidates the node transmit sockets on link changes.
+	 */
+	void handle_link_change();
+
+	/**!
+	 * @brief epoll based listener loop for node events.
+	 *
+	 * Sleeps until a registered fd becomes readable, so the cost of a wake up is
+	 * proportional to the number of ready fds rather than the number of nodes.
+	 */
+	void nodes_listener_epoll();
+
+	/**!
+	 * @brief Runs the callbacks of all timers that are due.
+	 *
+	 * Called by the manager loop whenever it wakes up, either because an event was
+	 * queued or because the nearest timer deadline was reached.
 	 */
 	void handle_timeout();
 
+	/**!
+	 * @brief Arms the periodic 500ms, 1s, 2s and 5s tick timers.
+	 */
+	void start_ticks();
+
+	/**!
+	 * @brief Arms a timer on the manager timer wheel.
+	 *
+	 * The manager loop sleeps until the nearest armed deadline, so modules that need
+	 * to run later should arm a timer rather than poll from a periodic tick.
+	 *
+	 * @param[in] t Pointer to the timer, initialized with em_timer_wheel_t::init_timer().
+	 * @param[in] timeout_ms Time until the first expiry in milliseconds.
+	 * @param[in] period_ms Interval of a periodic timer in milliseconds, 0 for a one shot timer.
+	 * @param[in] cb Callback run from the manager thread when the timer expires.
+	 * @param[in] arg Argument passed to the callback.
+	 *
+	 * @note Must only be called from the manager thread, i.e. from event handlers and timer callbacks.
+	 */
+	void add_timer(em_timer_t *t, unsigned int timeout_ms, unsigned int period_ms, em_timer_cb_t cb, void *arg);
+
+	/**!
+	 * @brief Disarms a timer armed with add_timer().
+	 *
+	 * @param[in] t Pointer to the timer.
+	 *
+	 * @note Must only be called from the manager thread.
+	 */
+	void cancel_timer(em_timer_t *t);
+
+	/**!
+	 * @brief Arms a one shot timer on the manager timer wheel from any thread.
+	 *
+	 * The request is queued and the manager thread is woken up to arm the timer, the
+	 * deadline is taken at the time of the call. Used by the ems to run a continuation
+	 * later instead of sleeping on their worker.
+	 *
+	 * @param[in] t Pointer to the timer, initialized with em_timer_wheel_t::init_timer().
+	 * @param[in] timeout_ms Time until the expiry in milliseconds.
+	 * @param[in] cb Callback run from the manager thread when the timer expires.
+	 * @param[in] arg Argument passed to the callback.
+	 *
+	 * @note The timer is disarmed with cancel_timer(), from the manager thread.
+	 */
+	void add_timer_async(em_timer_t *t, unsigned int timeout_ms, em_timer_cb_t cb, void *arg);
+
+	/**!
+	 * @brief Moves the timers queued by add_timer_async() onto the timer wheel.
+	 */
+	void arm_async_timers();
+
+	/**!
+	 * @brief Asks the manager thread to run the orchestrator as soon as possible.
+	 *
+	 * May be called from any thread, e.g. when an em_t changes state on frame receipt.
+	 * Several kicks before the manager wakes up result in a single orchestrator run.
+	 */
+	void kick_orch();
+
+	/**!
+	 * @brief Runs the orchestrator after kick_orch(). Optional to implement.
+	 */
+	virtual void handle_orch_kick() { }
+
 	/**!
 	 * @brief Returns the next msg_id to be updated in the cmdu header of the 1905 request.
 	 *
@@ -510,6 +1023,20 @@ public:
 	 */
 	virtual void handle_event(em_event_t *evt) = 0;
 
+	/**!
+	 * @brief Checks whether a queued event is made redundant by a later one. Optional to implement.
+	 *
+	 * Called while draining a batch from the manager queue, for each event and the one
+	 * queued right after it. When this returns true, evt is freed without being handled
+	 * and only next is handled.
+	 *
+	 * @param[in] evt Pointer to the earlier event.
+	 * @param[in] next Pointer to the event queued right after it.
+	 *
+	 * @returns True if handling next also covers evt, false otherwise.
+	 */
+	virtual bool coalesce_event(em_event_t *evt, em_event_t *next) { return false; }
+
     
 	/**!
 	 * @brief Handles the 5-second tick event.
@@ -720,6 +1247,26 @@ public:
 	 * @returns True if the event was processed successfully, false otherwise.
 	 */
 	bool io_process(em_event_t *evt);
+
+	/**!
+	 * @brief Copies an event into the event pool, ready for push_to_queue().
+	 *
+	 * Only the payload the event carries is copied.
+	 *
+	 * @param[in] evt The event.
+	 *
+	 * @returns The copy, NULL if the pool is exhausted.
+	 */
+	em_event_t *copy_event(em_event_t *evt);
+
+	/**!
+	 * @brief Returns true if the handler of an event sends the result of its command.
+	 *
+	 * io_process() returns the same, the caller answers the other events itself.
+	 *
+	 * @param[in] evt The event.
+	 */
+	static bool is_result_deferred(em_event_t *evt);
 	
 	/**!
 	 * @brief Processes input/output events based on the event type and data provided.
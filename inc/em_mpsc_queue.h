@@ -0,0 +1,163 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_MPSC_QUEUE_H
+#define EM_MPSC_QUEUE_H
+
+#include <stddef.h>
+#include <pthread.h>
+#include <atomic>
+
+#define EM_MGR_QUEUE_SZ     1024
+#define EM_NODE_QUEUE_SZ    256
+#define EM_MGR_BATCH_SZ     64
+#define EM_MGR_QUEUE_WAIT_MS    100     // longest a producer waits for room in the manager queue
+
+typedef struct {
+    std::atomic<size_t> seq;
+    void *data;
+} em_mpsc_cell_t;
+
+/*
+ * Bounded multi producer, single consumer queue. Producers never take a lock, the
+ * consumer sleeps on an eventfd only when the queue is empty. A producer that may wait
+ * for room sleeps on a condition variable that the consumer signals once it frees cells.
+ */
+class em_mpsc_queue_t {
+
+    em_mpsc_cell_t *m_cells;
+    size_t m_mask;
+    std::atomic<size_t> m_enqueue_pos;
+    std::atomic<size_t> m_dequeue_pos;
+    std::atomic<bool> m_waiting;
+    int m_efd;
+
+    std::atomic<unsigned int> m_high_watermark;
+    std::atomic<unsigned int> m_drops;
+
+    pthread_mutex_t m_space_lock;
+    pthread_cond_t m_space_cond;
+    std::atomic<unsigned int> m_space_waiters;  // producers waiting for room
+
+    bool try_push(void *data);
+    void wake_producers();
+
+public:
+
+    /**!
+     * @brief Allocates the queue cells and the wake up eventfd.
+     *
+     * @param[in] capacity Maximum number of queued entries, rounded up to a power of two.
+     *
+     * @returns int
+     * @retval 0 on success
+     * @retval -1 on failure
+     */
+    int init(unsigned int capacity);
+
+    /**!
+     * @brief Releases the queue cells and the eventfd.
+     *
+     * @note Entries still queued are not freed, drain the queue with pop() first.
+     */
+    void deinit();
+
+    /**!
+     * @brief Appends an entry, may be called concurrently from any thread.
+     *
+     * @param[in] data Entry to append, must not be NULL.
+     *
+     * @returns True if the entry was queued, false if the queue is full.
+     */
+    bool push(void *data);
+
+    /**!
+     * @brief Appends an entry, waiting up to timeout_ms for room if the queue is full.
+     *
+     * @param[in] data Entry to append, must not be NULL.
+     * @param[in] timeout_ms Longest wait for room, 0 not to wait.
+     *
+     * @returns True if the entry was queued, false if the queue stayed full.
+     *
+     * @note The consumer thread must not wait for itself.
+     */
+    bool push_wait(void *data, int timeout_ms);
+
+    /**!
+     * @brief Removes the oldest entry, must only be called from the consumer thread.
+     *
+     * @returns The entry, or NULL if the queue is empty.
+     */
+    void *pop();
+
+    /**!
+     * @brief Removes up to max of the oldest entries in one pass, must only be called from the consumer thread.
+     *
+     * @param[out] entries Array receiving the entries in queue order.
+     * @param[in] max Size of the entries array.
+     *
+     * @returns Number of entries removed.
+     */
+    unsigned int pop_batch(void **entries, unsigned int max);
+
+    /**!
+     * @brief Sleeps until an entry is queued, wake() is called or the timeout expires.
+     *
+     * @param[in] timeout_ms Maximum time to sleep in milliseconds, -1 to sleep without limit.
+     *
+     * @returns True if the queue has entries or the consumer was woken, false on timeout.
+     */
+    bool wait(int timeout_ms);
+
+    /**!
+     * @brief Wakes the consumer, e.g. to make it notice an exit request.
+     */
+    void wake();
+
+    /**!
+     * @brief Returns the number of queued entries.
+     */
+    unsigned int count();
+
+    /**!
+     * @brief Returns the highest number of entries queued at the same time.
+     */
+    unsigned int get_high_watermark() { return m_high_watermark; }
+
+    /**!
+     * @brief Returns the number of entries rejected because the queue was full, after any wait.
+     */
+    unsigned int get_drops() { return m_drops; }
+
+    /**!
+     * @brief Returns the eventfd the consumer sleeps on.
+     */
+    int get_fd() { return m_efd; }
+
+    /**!
+     * @brief Constructor for em_mpsc_queue_t.
+     */
+    em_mpsc_queue_t();
+
+    /**!
+     * @brief Destructor for em_mpsc_queue_t.
+     */
+    ~em_mpsc_queue_t();
+};
+
+#endif
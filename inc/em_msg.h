@@ -21,6 +21,26 @@
 #include "em_base.h"
 
 #define EM_MAX_TLV_MEMBERS 64
+#define EM_MAX_TLV_TYPES    256
+#define EM_MAX_INDEXED_TLVS 256
+
+// 1905 message types 0x0000-0x000f, EasyMesh ones 0x8000-0x804f, the last slot takes everything else
+#define EM_MSG_TYPE_1905_SLOTS  0x10
+#define EM_MSG_TYPE_MAP_SLOTS   0x50
+#define EM_MSG_TYPE_SLOTS       (EM_MSG_TYPE_1905_SLOTS + EM_MSG_TYPE_MAP_SLOTS + 1)
+#define EM_MSG_TYPE_SLOT_OTHER  (EM_MSG_TYPE_SLOTS - 1)
+
+typedef struct {
+    unsigned int offset;        // from the start of the indexed TLVs
+    unsigned short next;        // 1 based slot of the next TLV of the same type, 0 for the last one
+} em_tlv_ref_t;
+
+typedef struct {
+    unsigned int rx;
+    unsigned int drops;         // received but not handled
+    uint64_t handler_us;        // total time spent in the handler
+    uint64_t handler_max_us;
+} em_msg_type_stats_t;
 
 class em_tlv_member_t {
 public:
@@ -78,6 +98,50 @@ class em_msg_t {
     em_short_string_t m_errors[EM_MAX_TLV_MEMBERS];
     unsigned char *m_buff;
     unsigned int m_len;
+
+    // TLV index, built once per buffer so that lookups do not re-walk the TLV chain
+    unsigned char *m_index_base;
+    unsigned int m_index_len;
+    unsigned int m_index_end;
+    unsigned int m_index_num;
+    bool m_index_full;
+    bool m_index_malformed;
+    unsigned short m_index_first[EM_MAX_TLV_TYPES];
+    em_tlv_ref_t m_index_refs[EM_MAX_INDEXED_TLVS];
+
+	/**!
+	 * @brief Indexes the TLVs of a buffer in a single pass.
+	 *
+	 * The walk stops at the end of message TLV, at the end of the buffer or at the first TLV whose
+	 * length overruns the buffer. TLVs beyond EM_MAX_INDEXED_TLVS are left to a linear walk on lookup.
+	 *
+	 * @param[in] tlvs Pointer to the first TLV, may be NULL.
+	 * @param[in] len Length of the TLVs.
+	 */
+	void index_tlvs(unsigned char *tlvs, unsigned int len);
+
+	/**!
+	 * @brief Returns an instance of a TLV type from the TLVs at tlvs, indexing them first if needed.
+	 *
+	 * @param[in] tlvs Pointer to the first TLV.
+	 * @param[in] len Length of the TLVs.
+	 * @param[in] type The type of the TLV.
+	 * @param[in] instance Zero based instance of the type, in frame order.
+	 *
+	 * @returns A pointer to the TLV if found, otherwise NULL.
+	 */
+	em_tlv_t *find_tlv(unsigned char *tlvs, unsigned int len, em_tlv_type_t type, unsigned int instance);
+
+	/**!
+	 * @brief Returns the TLV of any of the given types that comes first in the frame.
+	 *
+	 * @param[in] types Array of TLV types.
+	 * @param[in] num Number of entries in types.
+	 *
+	 * @returns A pointer to the TLV if found, otherwise NULL.
+	 */
+	em_tlv_t *get_first_tlv_of(const em_tlv_type_t *types, unsigned int num);
+
 public:
 
     
@@ -175,6 +239,30 @@ public:
         return add_tlv(buff, len, em_tlv_type_eom, NULL, 0);
     }
 
+	/**!
+	 * @brief Maps a message type to a dense slot, for tables indexed by message type.
+	 *
+	 * @param[in] type Message type in host byte order.
+	 *
+	 * @returns Slot below EM_MSG_TYPE_SLOTS, EM_MSG_TYPE_SLOT_OTHER for types outside the known ranges.
+	 */
+	static constexpr unsigned int get_type_slot(unsigned int type) {
+        return (type < EM_MSG_TYPE_1905_SLOTS) ? type:
+            ((type >= em_msg_type_1905_ack) && (type < (em_msg_type_1905_ack + EM_MSG_TYPE_MAP_SLOTS))) ?
+            (EM_MSG_TYPE_1905_SLOTS + type - em_msg_type_1905_ack):EM_MSG_TYPE_SLOT_OTHER;
+    }
+
+	/**!
+	 * @brief Maps a slot of get_type_slot() back to its message type.
+	 *
+	 * @param[in] slot Slot other than EM_MSG_TYPE_SLOT_OTHER, which stands for many types.
+	 *
+	 * @returns Message type in host byte order.
+	 */
+	static constexpr unsigned int get_slot_type(unsigned int slot) {
+        return (slot < EM_MSG_TYPE_1905_SLOTS) ? slot:(em_msg_type_1905_ack + slot - EM_MSG_TYPE_1905_SLOTS);
+    }
+
     
 	/**
 	* @brief Add a 1905 header to the message.
@@ -319,6 +407,30 @@ public:
 	 * @note Ensure that the TLV type provided is valid and that the TLV structure exists.
 	 */
 	em_tlv_t *get_tlv(em_tlv_type_t type);
+
+	/**!
+	 * @brief Retrieves one instance of a TLV type that may appear several times, e.g. AP Metrics.
+	 *
+	 * @param[in] type The type of the TLV to retrieve.
+	 * @param[in] instance Zero based instance of the type, in frame order.
+	 *
+	 * @returns A pointer to the TLV if found, otherwise NULL.
+	 */
+	em_tlv_t *get_tlv(em_tlv_type_t type, unsigned int instance);
+
+	/**!
+	 * @brief Returns the number of TLVs of a type in the message.
+	 *
+	 * @param[in] type The type of the TLV.
+	 */
+	unsigned int get_tlv_count(em_tlv_type_t type);
+
+	/**!
+	 * @brief Checks whether the TLV chain ended with a TLV whose length overruns the buffer.
+	 *
+	 * @returns True if the TLVs are truncated or malformed, false otherwise.
+	 */
+	bool is_malformed();
     
 	/**!
 	 * @brief Initiates the autoconfiguration search process.
@@ -1045,7 +1157,7 @@ public:
 	 *
 	 * @note This constructor does not take any parameters and does not return any value.
 	 */
-	em_msg_t() {}
+	em_msg_t() { m_buff = NULL; m_len = 0; index_tlvs(NULL, 0); }
     
 	/**!
 	 * @brief Destructor for the em_msg_t class.
@@ -19,10 +19,157 @@
 #ifndef EM_NET_NODE_H
 #define EM_NET_NODE_H
 
+#include <pthread.h>
 #include "em_base.h"
 
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define EM_NET_NODE_ARENA_MIN_BLOCK     32      // nodes of a block added to a tree that outgrew its first one
+
+/*
+ * Lookup tables of a network tree, built on request once the tree is complete. The nodes
+ * are numbered in the order a depth first search visits them, a search from any node
+ * takes the first match in its subtree.
+ */
+typedef struct {
+    std::vector<em_network_node_t *> nodes;     // depth first order
+    std::unordered_map<const em_network_node_t *, std::pair<unsigned int, unsigned int> > pos; // first node and size of each subtree
+    std::map<std::string, std::vector<unsigned int> > key;          // nodes of each key, sorted for prefix matches
+    std::unordered_map<unsigned int, std::vector<unsigned int> > ctr;  // nodes of each display counter
+    std::unordered_map<std::string, em_network_node_t *> path;      // full dotted key, array elements by position
+} em_net_node_index_t;
+
+/*
+ * Nodes of one network tree, allocated from blocks owned by the tree instead of one
+ * malloc each. The first block is sized to the tree being built, the tree is freed in
+ * bulk. Nodes added to the tree later come from the same blocks.
+ */
+class em_net_node_arena_t {
+
+    std::vector<std::pair<em_network_node_t *, unsigned int> > m_blocks;   // first node and number of nodes
+    unsigned int m_used;                // nodes taken from the last block
+    em_net_node_index_t *m_index;       // dropped when a node is added
+
+public:
+
+    /**!
+     * @brief Returns a zeroed node, NULL if the last block is full.
+     */
+    em_network_node_t *alloc();
+
+    /**!
+     * @brief Adds a block, as large as the last one and at least EM_NET_NODE_ARENA_MIN_BLOCK nodes.
+     *
+     * @returns The first node of the block.
+     */
+    em_network_node_t *add_block();
+
+    /**!
+     * @brief Returns true if a node is in one of the blocks.
+     */
+    bool owns(const em_network_node_t *node);
+
+    /**!
+     * @brief Returns the blocks, their first node and number of nodes.
+     */
+    const std::vector<std::pair<em_network_node_t *, unsigned int> >& get_blocks() { return m_blocks; }
+
+    /**!
+     * @brief Returns the index of the tree, NULL if it has none.
+     */
+    em_net_node_index_t *get_index() { return m_index; }
+
+    /**!
+     * @brief Replaces the index of the tree, NULL drops it.
+     */
+    void set_index(em_net_node_index_t *index);
+
+    /**!
+     * @brief Returns the first node, the root of the tree.
+     */
+    em_network_node_t *get_root() { return m_blocks[0].first; }
+
+    /**!
+     * @brief Constructor for em_net_node_arena_t.
+     *
+     * @param[in] num Number of nodes of the first block.
+     */
+    em_net_node_arena_t(unsigned int num);
+
+    /**!
+     * @brief Destructor for em_net_node_arena_t, frees the blocks.
+     */
+    ~em_net_node_arena_t();
+
+    em_net_node_arena_t(const em_net_node_arena_t&) = delete;
+    em_net_node_arena_t& operator=(const em_net_node_arena_t&) = delete;
+};
+
 class em_net_node_t {
 
+    // the arenas of the trees, by the address of their blocks
+    static std::map<const em_network_node_t *, em_net_node_arena_t *> s_arena_blocks;
+    static pthread_mutex_t s_arena_lock;
+
+    /**!
+     * @brief Creates the arena of a new tree, sized for a number of nodes.
+     */
+    static em_net_node_arena_t *create_arena(unsigned int num);
+
+    /**!
+     * @brief Returns the arena a node was allocated from, NULL if it was allocated alone.
+     */
+    static em_net_node_arena_t *find_arena(const em_network_node_t *node);
+
+    /**!
+     * @brief Returns a zeroed node of an arena or, without arena, of its own allocation.
+     */
+    static em_network_node_t *alloc_node(em_net_node_arena_t *arena);
+
+    /**!
+     * @brief Returns the number of nodes of a tree.
+     */
+    static unsigned int get_num_nodes(const em_network_node_t *node);
+
+    /**!
+     * @brief Deep copy of a tree into an arena.
+     */
+    static em_network_node_t *clone_network_tree_node(em_network_node_t *node, em_net_node_arena_t *arena);
+
+    /**!
+     * @brief Display copy of a tree into an arena, see clone_network_tree_for_display().
+     */
+    static em_network_node_t *clone_network_tree_for_display_node(em_network_node_t *orig_node, em_network_node_t *dis_node,
+            unsigned int index, bool collapse, unsigned int *node_ctr, em_net_node_arena_t *arena);
+
+    /**!
+     * @brief Returns the index of the tree a node is in, NULL if the tree is not indexed.
+     */
+    static em_net_node_index_t *find_index(const em_network_node_t *node);
+
+    /**!
+     * @brief Adds a subtree to an index, depth first.
+     */
+    static void index_network_tree_node(em_net_node_index_t *index, em_network_node_t *node, const std::string& path);
+
+    /**!
+     * @brief Walks a subtree for the first node whose key starts with key.
+     */
+    static em_network_node_t *search_network_tree_by_key(em_network_node_t *node, const char *key);
+
+    /**!
+     * @brief Walks a subtree for the first node of a display counter.
+     */
+    static em_network_node_t *search_node_from_node_ctr(em_network_node_t *tree, unsigned int node_display_ctr);
+
+    /**!
+     * @brief Frees the nodes of a tree that are not in an arena, arena is NULL to free them all.
+     */
+    static void free_network_tree_node(em_network_node_t *node, em_net_node_arena_t *arena);
+
 public:
     
 	/**!
@@ -102,6 +249,33 @@ public:
 	 * @note Ensure that the tree is properly initialized before calling this function.
 	 */
 	static em_network_node_t *get_node_from_node_ctr(em_network_node_t *tree, unsigned int node_display_ctr);
+
+	/**!
+	 * @brief Indexes a tree by key, full dotted key and display counter.
+	 *
+	 * The lookups of get_network_tree_by_key(), get_network_tree_by_path() and
+	 * get_node_from_node_ctr() in the tree then no longer walk it. The index is dropped when
+	 * a node is added to the tree and freed with it. Only the trees built by this class
+	 * are indexed, the others are searched as before.
+	 *
+	 * @param[in] tree Root of the tree.
+	 *
+	 * @returns 0 on success, -1 if the tree cannot be indexed.
+	 */
+	static int index_network_tree(em_network_node_t *tree);
+
+	/**!
+	 * @brief Retrieves a node by its full dotted key.
+	 *
+	 * The path joins the keys from below the root, the elements of an array are named by
+	 * their position, e.g. "Result.NetworkSSIDList.0.SSID".
+	 *
+	 * @param[in] tree Root of the tree.
+	 * @param[in] path Full dotted key of the node.
+	 *
+	 * @returns The node, NULL if there is none.
+	 */
+	static em_network_node_t *get_network_tree_by_path(em_network_node_t *tree, const char *path);
     
 	/**!
 	 * @brief Retrieves the network tree node from a JSON object.
@@ -113,6 +287,7 @@ public:
 	 * @param[in] obj The JSON object containing the network tree node data.
 	 * @param[out] root The root node structure to be populated with the parsed data.
 	 * @param[out] node_ctr Pointer to an unsigned integer to store the node count.
+	 * @param[in] arena Arena the child nodes are allocated from, NULL to allocate each alone.
 	 *
 	 * @returns int
 	 * @retval 0 on success.
@@ -121,7 +296,8 @@ public:
 	 * @note Ensure that the JSON object is properly formatted and that the root
 	 * node structure is initialized before calling this function.
 	 */
-	static int get_network_tree_node(cJSON *obj, em_network_node_t *root, unsigned int *node_ctr);
+	static int get_network_tree_node(cJSON *obj, em_network_node_t *root, unsigned int *node_ctr,
+	                                 em_net_node_arena_t *arena = NULL);
     
 	/**!
 	 * @brief Retrieves the child node at a specified index from the given network node.
@@ -235,6 +411,9 @@ public:
 	 *
 	 * @param[in] tree Pointer to the network tree to be freed.
 	 *
+	 * The nodes of a tree built in an arena are freed with it. A subtree of such a tree is
+	 * freed with the root of its tree, only the nodes it got from elsewhere are freed now.
+	 *
 	 * @note Ensure that the tree is not used after this function is called.
 	 */
 	static void free_network_tree(em_network_node_t *tree);
@@ -21,12 +21,103 @@
 
 #include "em_base.h"
 #include "dm_easy_mesh.h"
+#include "em_mac_index.h"
+#include "em_route_table.h"
+
+#include <functional>
+
+#define EM_NETWORK_TOPO_MAX_MATCHES	8	// indexed nodes checked per lookup
 
 class em_network_topo_t {
 
 	dm_easy_mesh_t	*m_data_model;
 	unsigned int m_num_topologies;	
 	em_network_topo_t	*m_topology[EM_MAX_NETWORKS];
+	em_network_topo_t	*m_parent;		// NULL for the root
+	em_network_topo_t	*m_root;
+	unsigned int	m_hops;			// backhaul hops to the controller, 0 for the root
+	unsigned int	m_generation;	// of the data model when the node was created
+
+	// kept by the root of the tree for all its nodes, checked on use and fixed on mismatch
+	em_mac_index_t	m_al_index;		// AL MAC -> node
+	em_mac_index_t	m_bss_index;	// BSSID -> node
+	em_mac_index_t	m_bsta_index;	// backhaul STA MAC -> node of the BSS it is associated to
+
+	/**!
+	 * @brief Hangs this subtree under a parent, or makes it a tree of its own if NULL.
+	 *
+	 * Sets the root and hop count of the nodes of the subtree and indexes them in the root.
+	 *
+	 * @param[in] parent The new parent.
+	 */
+	void attach(em_network_topo_t *parent);
+
+	/**!
+	 * @brief Indexes the AL MAC, BSSs and associated backhaul STAs of this node in the root.
+	 */
+	void index();
+
+	/**!
+	 * @brief Removes the nodes of this subtree from the indexes of the root.
+	 */
+	void unindex();
+
+	/**!
+	 * @brief Returns true if the node is this one or one of its descendants.
+	 */
+	bool is_in_subtree(em_network_topo_t *topo);
+
+	/**!
+	 * @brief Returns true if the STA is associated to a backhaul BSS of this node.
+	 */
+	bool is_bh_associated(const unsigned char *sta_mac);
+
+	/**!
+	 * @brief Returns the first node of this subtree indexed under a MAC address that still matches.
+	 *
+	 * Indexed nodes that no longer match are dropped from the index.
+	 *
+	 * @param[in] index Index of the root.
+	 * @param[in] mac MAC address.
+	 * @param[in] match Checks the node against the current data model.
+	 * @param[in] dm If not NULL, only the node of this data model is returned.
+	 *
+	 * @returns The node, NULL if none is indexed.
+	 */
+	em_network_topo_t *find_indexed(em_mac_index_t *index, const unsigned char *mac,
+		const std::function<bool(em_network_topo_t *)>& match, dm_easy_mesh_t *dm = NULL);
+
+	/**!
+	 * @brief Walks this subtree for the node of a data model, see find_topology().
+	 */
+	em_network_topo_t *walk_topology(dm_easy_mesh_t *dm);
+
+	/**!
+	 * @brief Walks this subtree for the node of a BSS, see find_topology_by_bss_mac().
+	 */
+	em_network_topo_t *walk_topology_by_bss_mac(mac_address_t bss_mac);
+
+	/**!
+	 * @brief Walks this subtree for the node a backhaul STA is associated to, see find_topology_by_bh_associated().
+	 */
+	em_network_topo_t *walk_topology_by_bh_associated(mac_address_t sta_mac);
+
+	/**!
+	 * @brief Returns the rate of the link to the parent.
+	 *
+	 * @param[out] wireless Set if the backhaul STA of this device is associated to the parent.
+	 *
+	 * @returns The rate in Mbps, the estimated downlink MAC rate of the backhaul STA for a
+	 * wireless link, else the backhaul PHY rate of the device, 0 if not known.
+	 */
+	unsigned int get_link_rate(bool *wireless);
+
+	/**!
+	 * @brief Appends the routes of the nodes of this subtree, see get_routes().
+	 *
+	 * @param[in] via Route of this node, NULL for the root.
+	 */
+	void walk_routes(const em_route_t *via, em_route_t *routes, unsigned int max, unsigned int *num);
 
 public:
 	
@@ -102,6 +193,19 @@ public:
 	 * @note Ensure that the EasyMesh data is properly initialized before calling this function.
 	 */
 	em_network_topo_t *find_topology(dm_easy_mesh_t *dm);
+
+	/**!
+	 * @brief Returns whether the node of a data model is up to date, called on the root like add().
+	 *
+	 * It is if it was created from this data model at its current generation and sits
+	 * under the node the backhaul of the device is associated to. A node that is not is
+	 * removed and added again, the others are left in the tree.
+	 *
+	 * @param[in] dm Data model of the device.
+	 *
+	 * @returns False if the device has no node or it is out of date.
+	 */
+	bool is_current(dm_easy_mesh_t *dm);
 	
 	/**!
 	 * @brief Retrieves the data model instance.
@@ -112,6 +216,38 @@ public:
 	 * @note Ensure that the returned pointer is not null before using it.
 	 */
 	dm_easy_mesh_t *get_data_model() { return m_data_model; }
+
+	/**!
+	 * @brief Returns the parent node, the device this one is backhauled through.
+	 *
+	 * @returns The parent, NULL for the root.
+	 */
+	em_network_topo_t *get_parent() { return m_parent; }
+
+	/**!
+	 * @brief Returns the number of backhaul hops between this device and the controller.
+	 */
+	unsigned int get_hops() { return m_hops; }
+
+	/**!
+	 * @brief Returns the path from this node to the controller.
+	 *
+	 * @param[out] path Array receiving the nodes, this one first and the root last.
+	 * @param[in] max Size of the array.
+	 *
+	 * @returns Number of nodes on the path, get_hops() + 1, only max are stored.
+	 */
+	unsigned int get_path(em_network_topo_t **path, unsigned int max);
+
+	/**!
+	 * @brief Returns the backhaul route from this node, the root for the controller, to every device below it.
+	 *
+	 * @param[out] routes Array receiving the routes, parents before their children.
+	 * @param[in] max Size of the array.
+	 *
+	 * @returns Number of devices below this node, only max are stored.
+	 */
+	unsigned int get_routes(em_route_t *routes, unsigned int max);
 	
 	
 	/**!
@@ -0,0 +1,229 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_OPTIMISER_H
+#define EM_OPTIMISER_H
+
+#include "em_base.h"
+#include "em_metrics_history.h"
+#include <pthread.h>
+
+#include <vector>
+
+#define EM_OPTIMISER_MAX_PLUGINS        8
+#define EM_OPTIMISER_MAX_ACTIONS        32      // actions returned by a cycle, over all plugins
+#define EM_OPTIMISER_MAX_CHANNELS       32      // channels of a radio event
+#define EM_OPTIMISER_MAX_PREF           15      // best preference of the Channel Preference TLV
+#define EM_OPTIMISER_BUDGET_US          5000    // CPU time of a cycle, shared by the plugins
+
+typedef enum {
+    em_optimiser_action_steer,          // move a STA from source to target
+    em_optimiser_action_channel,        // move a radio to op_class and channel
+    em_optimiser_action_power,          // set the transmit power of a radio
+} em_optimiser_action_type_t;
+
+typedef struct {
+    em_optimiser_action_type_t  type;
+    unsigned long long          score;      // expected gain, the actions of a cycle are ranked by it
+    unsigned int                plugin;     // index of the plugin that returned it, set by the host
+    mac_address_t               ruid;       // channel and power
+    mac_address_t               sta;        // steer
+    bssid_t                     source;
+    bssid_t                     target;
+    unsigned char               op_class;   // of the target or the new channel
+    unsigned char               channel;
+    signed char                 tx_power;   // power, in dBm
+} em_optimiser_action_t;
+
+/*
+ * A radio as the Channel Preference Report and Operating Channel Report of its agent
+ * give it. An event with no channels only moves the operating channel.
+ */
+typedef struct {
+    mac_address_t   ruid;
+    unsigned char   op_class;
+    unsigned char   current;            // operating channel
+    signed char     tx_power;
+    unsigned int    num_channels;
+    unsigned char   channels[EM_OPTIMISER_MAX_CHANNELS];
+    unsigned char   prefs[EM_OPTIMISER_MAX_CHANNELS];   // 1 to EM_OPTIMISER_MAX_PREF, 0 for a non operable channel
+} em_optimiser_radio_t;
+
+typedef struct {
+    unsigned long long  events;
+    unsigned long long  cycles;
+    unsigned long long  actions;
+    unsigned long long  skipped;        // cycles the plugin was not run, the budget was spent
+    unsigned long long  overruns;       // cycles it ran past the budget left to it
+    unsigned long long  last_us;        // CPU time of its last cycle
+    unsigned long long  max_us;
+} em_optimiser_stats_t;
+
+/*
+ * Plugin of the controller optimisation. The host feeds it the changes of the mesh as
+ * they are handled, a radio, a BSS of a radio, a metrics sample or a scan result, so that
+ * it keeps its own model up to date instead of rebuilding it from the data model. Each
+ * cycle asks it for ranked actions within the CPU time left to it, work it could not
+ * finish is picked up by the next cycle. The host serialises all the calls.
+ */
+class em_optimiser_t {
+
+public:
+
+    /**!
+     * @brief Returns the name of the plugin, for the logs.
+     */
+    virtual const char *get_name() = 0;
+
+    /**!
+     * @brief A radio was added or changed.
+     */
+    virtual void radio_changed(const em_optimiser_radio_t *radio) { }
+
+    /**!
+     * @brief A BSS of a radio was reported.
+     */
+    virtual void bss_added(const unsigned char *bssid, const unsigned char *ruid) { }
+
+    /**!
+     * @brief A STA link metrics sample was received.
+     */
+    virtual void sta_sample(const unsigned char *sta, const unsigned char *bssid, const em_metrics_sample_t *sample) { }
+
+    /**!
+     * @brief An AP metrics sample of a BSS was received.
+     */
+    virtual void bss_sample(const unsigned char *bssid, const em_metrics_sample_t *sample) { }
+
+    /**!
+     * @brief A channel scan result of a radio was received.
+     */
+    virtual void scan_result(const em_scan_result_t *res) { }
+
+    /**!
+     * @brief Runs a cycle.
+     *
+     * @param[in] now Current time in milliseconds.
+     * @param[in] budget_us CPU time the cycle may take.
+     * @param[out] actions Array receiving the actions.
+     * @param[in] max Size of the array.
+     *
+     * @returns Number of actions stored.
+     */
+    virtual unsigned int optimise(unsigned long long now, unsigned long long budget_us, em_optimiser_action_t *actions,
+                                  unsigned int max) = 0;
+
+    /**!
+     * @brief An action of the plugin was submitted.
+     */
+    virtual void applied(const em_optimiser_action_t *action, unsigned long long now) { }
+
+    /**!
+     * @brief Destructor for em_optimiser_t.
+     */
+    virtual ~em_optimiser_t() { }
+};
+
+/*
+ * Host of the optimisation plugins, fed by the handlers of the ems from any thread. Events
+ * go to every plugin as they come. A cycle runs the plugins in turn within one CPU time
+ * budget, starting one further each cycle so that a plugin that spends the budget does not
+ * starve the ones after it, and ranks the actions of all plugins by score. Thread safe.
+ */
+class em_optimiser_host_t {
+
+    pthread_mutex_t m_lock;
+    std::vector<em_optimiser_t *> m_plugins;
+    std::vector<em_optimiser_stats_t> m_stats;
+    unsigned int m_next;                // plugin that starts the next cycle
+
+public:
+
+    /**!
+     * @brief Returns the CPU time of the calling thread in microseconds.
+     */
+    static unsigned long long now_cpu_us();
+
+    /**!
+     * @brief Adds a plugin, the caller keeps it until it is removed.
+     *
+     * @returns Index of the plugin, -1 if there are EM_OPTIMISER_MAX_PLUGINS already or it was added before.
+     */
+    int add(em_optimiser_t *plugin);
+
+    /**!
+     * @brief Removes a plugin, the indexes of the ones after it move down.
+     */
+    void remove(em_optimiser_t *plugin);
+
+    /**!
+     * @brief Feeds an event to the plugins.
+     */
+    void radio_changed(const em_optimiser_radio_t *radio);
+    void bss_added(const unsigned char *bssid, const unsigned char *ruid);
+    void sta_sample(const unsigned char *sta, const unsigned char *bssid, const em_metrics_sample_t *sample);
+    void bss_sample(const unsigned char *bssid, const em_metrics_sample_t *sample);
+    void scan_result(const em_scan_result_t *res);
+
+    /**!
+     * @brief Runs a cycle of the plugins.
+     *
+     * @param[in] now Current time in milliseconds.
+     * @param[in] budget_us CPU time of the cycle.
+     * @param[out] actions Array receiving the actions, the best first.
+     * @param[in] max Size of the array.
+     *
+     * @returns Number of actions stored.
+     */
+    unsigned int run(unsigned long long now, unsigned long long budget_us, em_optimiser_action_t *actions, unsigned int max);
+
+    /**!
+     * @brief Tells the plugin of an action that it was submitted.
+     */
+    void applied(const em_optimiser_action_t *action, unsigned long long now);
+
+    /**!
+     * @brief Returns the number of plugins.
+     */
+    unsigned int count();
+
+    /**!
+     * @brief Returns the name of a plugin, NULL if there is none at the index.
+     */
+    const char *get_name(unsigned int plugin);
+
+    /**!
+     * @brief Returns the counters of a plugin, false if there is none at the index.
+     */
+    bool get_stats(unsigned int plugin, em_optimiser_stats_t *stats);
+
+    /**!
+     * @brief Constructor for em_optimiser_host_t.
+     */
+    em_optimiser_host_t();
+
+    /**!
+     * @brief Destructor for em_optimiser_host_t.
+     */
+    ~em_optimiser_host_t();
+
+    em_optimiser_host_t(const em_optimiser_host_t&) = delete;
+    em_optimiser_host_t& operator=(const em_optimiser_host_t&) = delete;
+};
+
+#endif
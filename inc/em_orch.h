@@ -25,13 +25,133 @@
 class em_cmd_t;
 class em_mgr_t;
 
+/*
+ * Intrusive list of commands linked through em_cmd_t::m_orch_next/m_orch_prev, oldest first.
+ */
+struct em_orch_cmd_list_t {
+    em_cmd_t *head;
+    em_cmd_t *tail;
+    unsigned int count;
+};
+
+#define EM_ORCH_MAX_DEFERRED    16
+#define EM_ORCH_MAX_PARTITIONS  64
+
+#define EM_ORCH_WEIGHT_INTERACTIVE  4
+#define EM_ORCH_WEIGHT_CONFIG       2
+#define EM_ORCH_WEIGHT_BACKGROUND   1
+
+/*
+ * Latest bus event of a type and key that arrived while a command of its type was
+ * in progress, handled again once no command of that type is left.
+ */
+typedef struct {
+    em_event_t *evt;                // NULL when the slot is free
+    em_bus_event_type_t type;
+    em_cmd_type_t cmd_type;
+    em_subdoc_name_space_t key;
+} em_orch_deferred_t;
+
+typedef enum {
+    em_orch_lat_wait,       // submitted until promoted to active
+    em_orch_lat_active,     // promoted until every candidate reached fini
+    em_orch_lat_step,       // promoted until one candidate reached fini
+    em_orch_lat_max
+} em_orch_lat_type_t;
+
 class em_orch_t {
 
+    em_cmd_t *m_type_head[em_cmd_type_max];
+    unsigned int m_type_count[em_cmd_type_max];
+    em_lat_hist_t m_lat[em_cmd_type_max][em_orch_lat_max];
+    em_orch_deferred_t m_deferred[EM_ORCH_MAX_DEFERRED];
+    unsigned int m_num_deferred;
+    unsigned int m_deferred_replaced;
+    bool m_partition;
+    unsigned int m_class_weight[em_cmd_prio_max];       // commands promoted per class in a round
+    unsigned int m_class_max_pending[em_cmd_prio_max];  // admission limit, 0 for none
+    unsigned int m_class_max_active[em_cmd_prio_max];   // 0 for none
+    unsigned int m_class_active[em_cmd_prio_max];
+    unsigned int m_class_rejected[em_cmd_prio_max];
+    em_lat_hist_t m_class_wait[em_cmd_prio_max];
+
+	/**!
+	 * @brief Returns the AL MAC of the agent an em_t belongs to, the key of its partition.
+	 *
+	 * @param[in] em Pointer to the em_t.
+	 *
+	 * @returns Pointer to the AL MAC.
+	 */
+	static unsigned char *get_agent_mac(em_t *em);
+
+	/**!
+	 * @brief Splits a command whose candidates belong to several agents into one command per agent.
+	 *
+	 * The candidates of the first agent stay with the command, those of each other agent
+	 * move to a clone sharing its data model.
+	 *
+	 * @param[in] pcmd Pointer to the command, its candidates must be built.
+	 * @param[out] parts Array the command and its clones are written to.
+	 * @param[in] max Size of the array, the candidates of the agents beyond it stay with the command.
+	 *
+	 * @returns The number of commands written to parts, at least 1.
+	 */
+	unsigned int split_by_agent(em_cmd_t *pcmd, em_cmd_t *parts[], unsigned int max);
+
+	/**!
+	 * @brief Moves the pending commands of a class whose candidates are all idle to the active queue, oldest first.
+	 *
+	 * @param[in] prio Priority class.
+	 * @param[in] budget Maximum number of commands to promote.
+	 * @param[in,out] served AL MACs of the agents that got a command promoted in this round,
+	 * at most one command per agent is promoted when not NULL.
+	 *
+	 * @returns The number of commands promoted.
+	 */
+	unsigned int promote_class(em_cmd_prio_t prio, unsigned int budget, std::vector<unsigned char *> *served);
+
+	/**!
+	 * @brief Appends a command to the tail of a command list.
+	 *
+	 * @param[in] list Pointer to the list.
+	 * @param[in] pcmd Pointer to the command, must not be on any list.
+	 */
+	void list_append(em_orch_cmd_list_t *list, em_cmd_t *pcmd);
+
+	/**!
+	 * @brief Removes a command from the list it is on, if any.
+	 *
+	 * @param[in] pcmd Pointer to the command.
+	 */
+	void list_remove(em_cmd_t *pcmd);
+
+	/**!
+	 * @brief Adds a submitted command to the per type and per em_t indexes.
+	 *
+	 * @param[in] pcmd Pointer to the command, its candidates must be built.
+	 */
+	void index_command(em_cmd_t *pcmd);
+
+	/**!
+	 * @brief Removes a command from the per type and per em_t indexes, if indexed.
+	 *
+	 * @param[in] pcmd Pointer to the command.
+	 */
+	void unindex_command(em_cmd_t *pcmd);
+
+	/**!
+	 * @brief Handles the deferred events whose command type has no command left.
+	 *
+	 * @returns The number of events handled.
+	 */
+	unsigned int replay_deferred();
+
 public:
     em_mgr_t    *m_mgr;
-    queue_t *m_pending;
-    queue_t *m_active;
+    em_orch_cmd_list_t m_pending[em_cmd_prio_max];
+    em_orch_cmd_list_t m_active;
     hash_map_t  *m_cmd_map;
+    unsigned int m_max_active;
 
 public:
     
@@ -45,15 +165,131 @@ public:
 	em_orch_state_t get_state(em_cmd_t *cmd);
     
 	/**!
-	 * @brief Handles the timeout event.
+	 * @brief Runs the orchestrator.
 	 *
-	 * This function is called when a timeout occurs.
-	 * It performs necessary operations to handle the timeout.
-	 *
-	 * @note Ensure that the timeout duration is correctly set before calling this function.
+	 * Called on the periodic tick and whenever the manager is kicked by a
+	 * state change. Every eligible pending command is promoted in one pass, and
+	 * the pass is repeated as long as finished commands free up candidates.
 	 */
 	void handle_timeout();
 
+	/**!
+	 * @brief Moves a command whose steps run in place to its next orchestrated step.
+	 *
+	 * The steps in between that are not orchestrated are pre processed on the way.
+	 *
+	 * @param[in] pcmd Pointer to the command.
+	 *
+	 * @returns True if the command is on a step to orchestrate, false if it has none left
+	 * or does not run its steps in place.
+	 */
+	bool advance_in_place(em_cmd_t *pcmd);
+
+	/**!
+	 * @brief Moves every pending command whose candidates are all idle to the active queue.
+	 *
+	 * The classes are served in rounds, each class promotes up to its weight in a round,
+	 * highest priority first, so the candidates a steer and a scan compete for go to the
+	 * steer while the background work still gets its share of the active slots.
+	 * When partitioned by agent with a limit on the active commands, the free slots go
+	 * round robin over the agents, so an agent with a long queue does not hold them all.
+	 *
+	 * @returns The number of commands promoted.
+	 */
+	unsigned int promote_pending();
+
+	/**!
+	 * @brief Orchestrates every active command and destroys the finished ones.
+	 *
+	 * A command whose steps run in place stays active when it finished a step that is
+	 * not its last, its candidates start the next step.
+	 *
+	 * @returns The number of commands that finished or moved to their next step.
+	 */
+	unsigned int process_active();
+
+	/**!
+	 * @brief Holds a bus event until no command of its type is left.
+	 *
+	 * For updates that carry a full state, such as the OneWifi subdocs, the handler
+	 * defers the event instead of rejecting it when is_cmd_type_in_progress() is true.
+	 * A held event of the same type and key is replaced, so only the latest update is
+	 * handled, right after the command in progress finished. Manager thread only.
+	 *
+	 * @param[in] evt Pointer to the bus event, copied.
+	 * @param[in] key Key of the update within its type, e.g. the subdoc name.
+	 *
+	 * @returns True if the event is held, false if no slot or memory is left.
+	 */
+	bool defer_event(em_bus_event_t *evt, const char *key);
+
+	/**!
+	 * @brief Drops all deferred events without handling them.
+	 */
+	void clear_deferred();
+
+	unsigned int get_num_deferred() { return m_num_deferred; }
+
+	unsigned int get_deferred_replaced() { return m_deferred_replaced; }
+
+	/**!
+	 * @brief Sets the maximum number of commands that may be active at the same time.
+	 *
+	 * An em_t is candidate of at most one active command, since it holds a single
+	 * orchestration state, so this bounds how many em_t are orchestrated at once.
+	 *
+	 * @param[in] max Maximum number of active commands, 0 for no limit.
+	 */
+	void set_max_active(unsigned int max) { m_max_active = max; }
+
+	/**!
+	 * @brief Sets whether the submitted commands are split per agent.
+	 *
+	 * A command only finishes when all its candidates did, so a command sent to many agents
+	 * holds the fast ones back until the slowest is done, and the next command for them
+	 * waits. Split per agent AL MAC, the commands of each agent progress on their own.
+	 *
+	 * @param[in] partition True to split the commands submitted from now on.
+	 */
+	void set_partition_by_agent(bool partition) { m_partition = partition; }
+
+	bool is_partitioned_by_agent() { return m_partition; }
+
+	/**!
+	 * @brief Sets how many commands of a priority class are promoted in a scheduling round.
+	 *
+	 * @param[in] prio Priority class.
+	 * @param[in] weight Commands per round, at least 1.
+	 */
+	void set_class_weight(em_cmd_prio_t prio, unsigned int weight) { m_class_weight[prio] = (weight == 0) ? 1:weight; }
+
+	/**!
+	 * @brief Sets the admission limits of a priority class.
+	 *
+	 * A command submitted while its class has max_pending commands waiting is completed
+	 * without being orchestrated.
+	 *
+	 * @param[in] prio Priority class.
+	 * @param[in] max_pending Maximum number of pending commands, 0 for no limit.
+	 * @param[in] max_active Maximum number of active commands, 0 for no limit.
+	 */
+	void set_class_limits(em_cmd_prio_t prio, unsigned int max_pending, unsigned int max_active);
+
+	unsigned int get_num_pending();
+
+	/**!
+	 * @brief Returns the number of pending and active commands of an agent.
+	 *
+	 * A command belongs to the agent of its first candidate, see split_by_agent().
+	 *
+	 * @param[in] al_mac AL MAC of the agent.
+	 */
+	unsigned int get_agent_cmd_count(const unsigned char *al_mac);
+
+	unsigned int get_class_rejected(em_cmd_prio_t prio) { return m_class_rejected[prio]; }
+
+	em_lat_hist_t *get_class_wait(em_cmd_prio_t prio) { return &m_class_wait[prio]; }
+
     
 	/**!
 	 * @brief Submits a list of commands for execution.
@@ -282,6 +518,67 @@ public:
 	 * @returns True if the command type is in progress, false otherwise.
 	 */
         bool is_cmd_type_renew_in_progress(em_bus_event_t *evt); 
+
+	/**!
+	 * @brief Returns the number of pending and active commands of a type.
+	 *
+	 * @param[in] type Command type.
+	 *
+	 * @returns The number of commands, 0 for an out of range type.
+	 */
+	unsigned int get_cmd_count(em_cmd_type_t type);
+
+	/**!
+	 * @brief Returns the first pending or active command of a type.
+	 *
+	 * Further commands of the same type follow through em_cmd_t::m_type_next.
+	 *
+	 * @param[in] type Command type.
+	 *
+	 * @returns Pointer to the command, or NULL if there is none.
+	 */
+	em_cmd_t *get_first_cmd_of_type(em_cmd_type_t type);
+
+	/**!
+	 * @brief Collects the pending and active commands an em_t is candidate of.
+	 *
+	 * @param[in] em Pointer to the em_t.
+	 * @param[out] pcmd Array receiving the commands.
+	 * @param[in] max Size of the array.
+	 *
+	 * @returns The number of commands stored in the array.
+	 */
+	unsigned int get_cmds_for_em(em_t *em, em_cmd_t *pcmd[], unsigned int max);
+
+	/**!
+	 * @brief Returns the latency histogram of a command type.
+	 *
+	 * @param[in] type Command type.
+	 * @param[in] lat Which latency of the command, see em_orch_lat_type_t.
+	 *
+	 * @returns Pointer to the histogram.
+	 */
+	em_lat_hist_t *get_latency(em_cmd_type_t type, em_orch_lat_type_t lat) { return &m_lat[type][lat]; }
+
+	/**!
+	 * @brief Clears the latency histograms of all command types.
+	 */
+	void reset_latency();
+
+	/**!
+	 * @brief Adds the latency histograms of every command type that has samples to a JSON array.
+	 *
+	 * @param[in] arr JSON array receiving one object per command type.
+	 */
+	void encode_latency(cJSON *arr);
+
+	/**!
+	 * @brief Adds the queue state and the wait time of each priority class to a JSON array.
+	 *
+	 * @param[in] arr JSON array receiving one object per priority class.
+	 */
+	void encode_class_latency(cJSON *arr);
+
 	/**!
 	 * @brief Orchestrates the execution of a command within the em context.
 	 *
@@ -21,6 +21,8 @@
 
 #include "em_orch.h"
 
+#define EM_ORCH_CTRL_MAX_BACKGROUND_PENDING 32
+
 class em_orch_ctrl_t : public em_orch_t {
 
 public:
@@ -41,7 +43,17 @@ public:
 	 * calling this function.
 	 */
 	unsigned int build_candidates(em_cmd_t *cmd);
-    
+
+	/**!
+	 * @brief Finds the radio node serving a STA.
+	 *
+	 * @param[in] sta_mac MAC address of the STA.
+	 * @param[in] bssid BSSID the STA is associated to.
+	 *
+	 * @returns Pointer to the em of the radio the STA is on, NULL if the STA is not known.
+	 */
+	em_t *get_sta_node(mac_address_t sta_mac, bssid_t bssid);
+
 	/**!
 	 * @brief Pre-processes the orchestration operation.
 	 *
@@ -107,6 +119,25 @@ public:
 	 */
 	void orch_transient(em_cmd_t *pcmd, em_t *em);
 
+	/**!
+	 * @brief Plans a mesh wide renew round in the renew pacing of the controller.
+	 *
+	 * @param[in] nodes Radio nodes to renew.
+	 */
+	void renew_plan(std::vector<em_t *>& nodes);
+
+	/**!
+	 * @brief Ends the renew of a radio in the renew pacing and prints the progress of the round.
+	 */
+	void renew_finish(em_t *em, bool ok);
+
+	/**!
+	 * @brief Returns whether the renew of a radio is past EM_MAX_CMD_GEN_TTL.
+	 *
+	 * A radio still waiting for its turn is not, one in progress is from its own start.
+	 */
+	bool renew_is_late(em_t *em);
+
 public:
     
 	/**!
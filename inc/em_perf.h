@@ -0,0 +1,201 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_PERF_H
+#define EM_PERF_H
+
+#include <stdint.h>
+#include <atomic>
+#include <cjson/cJSON.h>
+#include "em_lat_hist.h"
+
+#define EM_PERF_MAX_SHARDS      32      // threads past this many share shards
+
+typedef enum {
+    em_perf_ctr_mgr_events_queued,
+    em_perf_ctr_mgr_events_dropped,     // manager queue full
+    em_perf_ctr_mgr_events_handled,
+    em_perf_ctr_frames_rx,              // CMDUs handed to the em handlers
+    em_perf_ctr_node_frames_dropped,    // ingress queue of a node full
+    em_perf_ctr_frames_tx,
+    em_perf_ctr_frames_tx_errors,
+    em_perf_ctr_bytes_tx,
+    em_perf_ctr_orch_cmds_submitted,
+    em_perf_ctr_orch_cmds_done,
+    em_perf_ctr_db_queries,
+    em_perf_ctr_db_errors,
+    em_perf_ctr_tr181_gets,
+    em_perf_ctr_max
+} em_perf_ctr_t;
+
+typedef enum {
+    em_perf_gauge_mgr_queue_depth,
+    em_perf_gauge_orch_pending,
+    em_perf_gauge_orch_active,
+    em_perf_gauge_max
+} em_perf_gauge_t;
+
+typedef enum {
+    em_perf_hist_mgr_event,             // one event of the manager queue
+    em_perf_hist_proto_process,         // one CMDU handler
+    em_perf_hist_send_frame,
+    em_perf_hist_orch_run,              // one pass of the orchestrator
+    em_perf_hist_db_execute,
+    em_perf_hist_tr181_get,             // a TR-181 get, queueing to the manager included
+    em_perf_hist_ap_cap_report_small,   // AP Capability Report ingest, below EM_AP_CAP_REPORT_SMALL_LEN
+    em_perf_hist_ap_cap_report_medium,
+    em_perf_hist_ap_cap_report_large,   // EM_AP_CAP_REPORT_LARGE_LEN and above
+    em_perf_hist_max
+} em_perf_hist_t;
+
+// counters and histograms of the threads that record into it, written with relaxed atomics
+typedef struct alignas(64) {
+    std::atomic<uint64_t> ctrs[em_perf_ctr_max];
+    std::atomic<uint64_t> buckets[em_perf_hist_max][EM_LAT_HIST_BUCKETS];
+    std::atomic<uint64_t> sum_us[em_perf_hist_max];
+    std::atomic<uint64_t> max_us[em_perf_hist_max];
+} em_perf_shard_t;
+
+/*
+ * Process wide performance counters, gauges and latency histograms. Each thread records
+ * into its own shard without a lock, the shards are summed when the values are read, so
+ * recording stays cheap enough for the frame and event paths.
+ */
+class em_perf_t {
+
+    static em_perf_shard_t s_shards[EM_PERF_MAX_SHARDS];
+    static std::atomic<unsigned int> s_next_shard;
+    static std::atomic<uint64_t> s_gauges[em_perf_gauge_max];
+    static std::atomic<uint64_t> s_gauge_max[em_perf_gauge_max];
+
+    static inline em_perf_shard_t *get_shard()
+    {
+        static thread_local em_perf_shard_t *t_shard =
+            &s_shards[s_next_shard.fetch_add(1, std::memory_order_relaxed) % EM_PERF_MAX_SHARDS];
+
+        return t_shard;
+    }
+
+    static inline void update_max(std::atomic<uint64_t> *max, uint64_t val)
+    {
+        uint64_t cur = max->load(std::memory_order_relaxed);
+
+        while ((val > cur) && (max->compare_exchange_weak(cur, val, std::memory_order_relaxed) == false));
+    }
+
+public:
+
+    /**!
+     * @brief Adds to a counter.
+     *
+     * @param[in] ctr Counter.
+     * @param[in] n Amount to add.
+     */
+    static inline void inc(em_perf_ctr_t ctr, uint64_t n = 1)
+    {
+        get_shard()->ctrs[ctr].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /**!
+     * @brief Records one latency sample.
+     *
+     * @param[in] hist Histogram.
+     * @param[in] us Sample in microseconds.
+     */
+    static inline void record(em_perf_hist_t hist, uint64_t us)
+    {
+        em_perf_shard_t *shard = get_shard();
+
+        shard->buckets[hist][em_lat_hist_t::get_bucket_index(us)].fetch_add(1, std::memory_order_relaxed);
+        shard->sum_us[hist].fetch_add(us, std::memory_order_relaxed);
+        update_max(&shard->max_us[hist], us);
+    }
+
+    /**!
+     * @brief Sets the current value of a gauge, its high watermark follows.
+     *
+     * @param[in] gauge Gauge.
+     * @param[in] val Current value.
+     */
+    static inline void set_gauge(em_perf_gauge_t gauge, uint64_t val)
+    {
+        s_gauges[gauge].store(val, std::memory_order_relaxed);
+        update_max(&s_gauge_max[gauge], val);
+    }
+
+    /**!
+     * @brief Returns a counter summed over all shards.
+     */
+    static uint64_t get_counter(em_perf_ctr_t ctr);
+
+    /**!
+     * @brief Returns the current value of a gauge.
+     */
+    static uint64_t get_gauge(em_perf_gauge_t gauge) { return s_gauges[gauge].load(std::memory_order_relaxed); }
+
+    /**!
+     * @brief Returns the highest value a gauge was set to.
+     */
+    static uint64_t get_gauge_max(em_perf_gauge_t gauge) { return s_gauge_max[gauge].load(std::memory_order_relaxed); }
+
+    /**!
+     * @brief Adds the samples of a histogram from all shards.
+     *
+     * @param[in] hist Histogram.
+     * @param[out] out Histogram the samples are added to.
+     */
+    static void get_hist(em_perf_hist_t hist, em_lat_hist_t *out);
+
+    /**!
+     * @brief Encodes every counter, gauge and histogram.
+     *
+     * Counters carry their total and their rate per second since the previous encode.
+     *
+     * @param[in] obj Object the "Counters", "Gauges" and "Latency" objects are added to.
+     */
+    static void encode(cJSON *obj);
+
+    /**!
+     * @brief Clears every counter, gauge and histogram.
+     */
+    static void reset();
+
+    static const char *get_counter_str(em_perf_ctr_t ctr);
+    static const char *get_gauge_str(em_perf_gauge_t gauge);
+    static const char *get_hist_str(em_perf_hist_t hist);
+};
+
+/*
+ * Records the time spent in a scope into a histogram.
+ */
+class em_perf_scope_t {
+
+    em_perf_hist_t m_hist;
+    uint64_t m_start_us;
+
+public:
+
+    explicit em_perf_scope_t(em_perf_hist_t hist) : m_hist(hist), m_start_us(em_lat_hist_t::get_time_us()) { }
+
+    ~em_perf_scope_t() { em_perf_t::record(m_hist, em_lat_hist_t::get_time_us() - m_start_us); }
+
+    em_perf_scope_t(const em_perf_scope_t&) = delete;
+    em_perf_scope_t& operator=(const em_perf_scope_t&) = delete;
+};
+
+#endif
@@ -270,6 +270,52 @@ public:
 	 */
 	int send_policy_cfg_request_msg();
 
+	/**!
+	 * @brief Encodes the TLVs of a Multi-AP Policy Config Request, up to the End of Message TLV.
+	 *
+	 * @param[out] buff Buffer for the TLVs.
+	 * @param[out] ruid_off Offsets of the radio unique identifiers in the TLVs.
+	 * @param[out] num_ruid Number of offsets, at most EM_POLICY_PUSH_MAX_RUID.
+	 *
+	 * @returns Length of the TLVs.
+	 */
+	size_t create_policy_cfg_tlvs(unsigned char *buff, unsigned short *ruid_off, unsigned int *num_ruid);
+
+	/**!
+	 * @brief Returns the data model the policy TLVs are encoded from, the one of the current command.
+	 */
+	dm_easy_mesh_t *get_policy_data_model();
+
+	/**!
+	 * @brief Returns the first policy of a radio scoped type that applies to this radio.
+	 *
+	 * @param[in] dm Data model of the policies.
+	 * @param[in] type Policy type.
+	 *
+	 * @returns Index of the policy, -1 if none applies.
+	 */
+	int find_radio_policy(dm_easy_mesh_t *dm, em_policy_id_type_t type);
+
+	/**!
+	 * @brief Returns the key of the Multi-AP Policy Config Request encoding of this radio.
+	 *
+	 * The key covers the policies without their network and device and the radio scoped
+	 * policies that apply to this radio, so the radios of all agents with the same
+	 * policies share one encoding, see em_policy_push_t.
+	 *
+	 * @param[in] dm Data model of the policies.
+	 */
+	unsigned long long get_policy_key(dm_easy_mesh_t *dm);
+
+	/**!
+	 * @brief Sends the 1905 ACK of a Multi-AP Policy Config Request to the controller.
+	 *
+	 * @param[in] msg_id Message id of the request.
+	 *
+	 * @returns Length of the message sent, -1 on failure.
+	 */
+	int send_policy_cfg_ack(unsigned short msg_id);
+
     
 	/**!
 	 * @brief Handles the policy configuration request.
@@ -287,6 +333,16 @@ public:
 	 */
 	int handle_policy_cfg_req(unsigned char *buff, unsigned int len);
 
+	/**!
+	 * @brief Stores the mappings of a TID-to-Link Mapping Policy TLV in the data model.
+	 *
+	 * @param[in] buff Value of the TLV.
+	 * @param[in] len Length of the value.
+	 *
+	 * @returns 0 on success, -1 if the TLV is truncated.
+	 */
+	int handle_tid_to_link_map_policy(unsigned char *buff, unsigned int len);
+
     
 	/**!
 	 * @brief Processes a message with the given data and length.
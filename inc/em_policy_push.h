@@ -0,0 +1,173 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_POLICY_PUSH_H
+#define EM_POLICY_PUSH_H
+
+#include <pthread.h>
+#include "em_base.h"
+
+#include <unordered_map>
+#include <vector>
+
+#define EM_POLICY_PUSH_MAX_ENCODINGS    16      // cached policy encodings, the least recently used is dropped
+#define EM_POLICY_PUSH_MAX_RUID         4       // radio unique identifiers patched per encoding
+#define EM_POLICY_PUSH_MAX_PENDING      256     // requests waiting for their ACK, the oldest is expired to make room
+#define EM_POLICY_PUSH_TIMEOUT_MS       5000    // a request without ACK by then is lost
+
+/*
+ * The TLVs of a Multi-AP Policy Config Request, from the first one to the End of
+ * Message TLV, with the offsets of the radio unique identifiers in them
+ */
+typedef struct {
+    unsigned long long  key;
+    unsigned int        len;
+    unsigned int        num_ruid;
+    unsigned short      ruid_off[EM_POLICY_PUSH_MAX_RUID];
+    unsigned long long  last_used;
+    unsigned char       tlvs[MAX_EM_BUFF_SZ];
+} em_policy_push_encoding_t;
+
+typedef struct {
+    mac_address_t       agent;          // AL MAC of the agent the request was sent to
+    unsigned short      msg_id;
+    unsigned long long  sent_ms;        // CLOCK_MONOTONIC milliseconds
+} em_policy_push_pending_t;
+
+typedef struct {
+    unsigned int        encoded;        // requests encoded from the data model
+    unsigned int        reused;         // requests copied from a cached encoding
+    unsigned int        cleared;        // encodings dropped on a policy change
+    unsigned int        sent;
+    unsigned int        acked;
+    unsigned int        expired;        // no ACK within EM_POLICY_PUSH_TIMEOUT_MS
+    unsigned long long  max_ack_ms;     // slowest ACK
+} em_policy_push_stats_t;
+
+/*
+ * Multi-AP Policy Config Requests pushed to the agents. A policy change reaches every
+ * radio of every agent, and the requests of radios with the same policy set differ only
+ * in their addresses, message id and radio unique identifiers. The first request of a
+ * policy set is encoded from the data model and cached, the others are copied from the
+ * cache with their radio unique identifiers patched. The requests are sent without
+ * waiting for each other and their 1905 ACKs are matched on the agent and message id.
+ * Thread safe.
+ */
+class em_policy_push_t {
+
+    pthread_mutex_t m_lock;
+    std::vector<em_policy_push_encoding_t> m_encodings;
+    // agent MAC in the low 48 bits, message id in the high 16 bits
+    std::unordered_map<unsigned long long, em_policy_push_pending_t> m_pending;
+    em_policy_push_stats_t m_stats;
+    unsigned long long m_use;           // bumped on every lookup, orders the encodings by use
+
+    /**!
+     * @brief Returns the pending key of a request.
+     */
+    static unsigned long long pending_key(const unsigned char *agent, unsigned short msg_id);
+
+public:
+
+    /**!
+     * @brief Copies the cached TLVs of a policy set with the radio unique identifiers set.
+     *
+     * @param[in] key Policy set, see em_policy_cfg_t::get_policy_key().
+     * @param[in] ruid Radio unique identifier of the request.
+     * @param[out] buff Buffer for the TLVs.
+     * @param[in] size Size of the buffer.
+     *
+     * @returns Length of the TLVs, 0 if the policy set is not cached or does not fit.
+     */
+    unsigned int get_encoding(unsigned long long key, const unsigned char *ruid, unsigned char *buff, unsigned int size);
+
+    /**!
+     * @brief Caches the TLVs of a policy set.
+     *
+     * @param[in] key Policy set.
+     * @param[in] tlvs The TLVs, up to and including the End of Message TLV.
+     * @param[in] len Length of the TLVs.
+     * @param[in] ruid_off Offsets of the radio unique identifiers in the TLVs.
+     * @param[in] num_ruid Number of offsets.
+     *
+     * @returns 0 on success, -1 if the TLVs do not fit.
+     */
+    int put_encoding(unsigned long long key, const unsigned char *tlvs, unsigned int len,
+                     const unsigned short *ruid_off, unsigned int num_ruid);
+
+    /**!
+     * @brief Drops the cached TLVs of all policy sets.
+     *
+     * @returns Number of encodings dropped.
+     */
+    unsigned int clear_encodings();
+
+    /**!
+     * @brief Records a request sent to an agent, until its ACK.
+     *
+     * @param[in] agent AL MAC of the agent.
+     * @param[in] msg_id Message id of the request.
+     * @param[in] now Current time in milliseconds.
+     */
+    void sent(const unsigned char *agent, unsigned short msg_id, unsigned long long now);
+
+    /**!
+     * @brief Matches a 1905 ACK to a request.
+     *
+     * @param[in] agent AL MAC of the agent sending the ACK.
+     * @param[in] msg_id Message id of the ACK.
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns True if it acknowledges a request, false otherwise.
+     */
+    bool ack(const unsigned char *agent, unsigned short msg_id, unsigned long long now);
+
+    /**!
+     * @brief Drops the requests older than EM_POLICY_PUSH_TIMEOUT_MS.
+     *
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns Number of requests expired.
+     */
+    unsigned int expire(unsigned long long now);
+
+    /**!
+     * @brief Returns the number of requests waiting for their ACK, of one agent or all if NULL.
+     */
+    unsigned int pending(const unsigned char *agent = NULL);
+
+    /**!
+     * @brief Returns the counters.
+     */
+    em_policy_push_stats_t get_stats();
+
+    /**!
+     * @brief Constructor for em_policy_push_t.
+     */
+    em_policy_push_t();
+
+    /**!
+     * @brief Destructor for em_policy_push_t.
+     */
+    ~em_policy_push_t();
+
+    em_policy_push_t(const em_policy_push_t&) = delete;
+    em_policy_push_t& operator=(const em_policy_push_t&) = delete;
+};
+
+#endif
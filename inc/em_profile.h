@@ -0,0 +1,169 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_PROFILE_H
+#define EM_PROFILE_H
+
+#include <stdint.h>
+#include <time.h>
+#include <atomic>
+#include <cjson/cJSON.h>
+#include "em_msg.h"
+
+#define EM_PROFILE_MAX_TYPES    128     // per domain, larger types are counted in the last one
+#define EM_PROFILE_TOP_N        10
+
+/*
+ * Build with -DEM_PROFILE to profile the event handlers. Each scope then costs two reads
+ * of the thread CPU clock, and every malloc(), calloc(), realloc() and operator new of
+ * the process is counted per thread, through the allocator hooks of the sanitizers in
+ * sanitized builds and by wrapping the glibc allocator otherwise.
+ */
+#ifdef EM_PROFILE
+#define EM_PROFILE_SCOPE(domain, type) em_profile_scope_t em_profile_scope(domain, static_cast<unsigned int>(type))
+#else
+#define EM_PROFILE_SCOPE(domain, type)
+#endif
+
+typedef enum {
+    em_profile_domain_bus,      // em_bus_event_type_t handled by handle_event()
+    em_profile_domain_event,    // other em_event_type_t handled by handle_event()
+    em_profile_domain_cmdu,     // CMDU message type handled by em_t::proto_process()
+    em_profile_domain_max
+} em_profile_domain_t;
+
+typedef struct {
+    em_profile_domain_t domain;
+    unsigned int    type;           // message type for the CMDU domain
+    uint64_t        count;
+    uint64_t        cpu_ns;
+    uint64_t        max_cpu_ns;
+    uint64_t        allocs;
+    uint64_t        alloc_bytes;
+} em_profile_entry_t;
+
+// name of a type, NULL for the numeric default
+typedef const char *(*em_profile_name_fn_t)(em_profile_domain_t domain, unsigned int type);
+
+/*
+ * CPU time and heap allocations of each handled event type, summed over all threads with
+ * relaxed atomics. The numbers of a scope include those of the scopes nested in it.
+ */
+class em_profile_t {
+
+    static std::atomic<uint64_t> s_count[em_profile_domain_max][EM_PROFILE_MAX_TYPES];
+    static std::atomic<uint64_t> s_cpu_ns[em_profile_domain_max][EM_PROFILE_MAX_TYPES];
+    static std::atomic<uint64_t> s_max_cpu_ns[em_profile_domain_max][EM_PROFILE_MAX_TYPES];
+    static std::atomic<uint64_t> s_allocs[em_profile_domain_max][EM_PROFILE_MAX_TYPES];
+    static std::atomic<uint64_t> s_alloc_bytes[em_profile_domain_max][EM_PROFILE_MAX_TYPES];
+
+    static unsigned int get_slot(em_profile_domain_t domain, unsigned int type);
+
+public:
+
+    /**!
+     * @brief Returns the CPU time of the calling thread in nanoseconds.
+     */
+    static uint64_t get_thread_cpu_ns()
+    {
+        struct timespec ts;
+
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return (static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    /**!
+     * @brief Returns the allocations of the calling thread, 0 unless built with EM_PROFILE.
+     *
+     * @param[out] allocs Number of allocations.
+     * @param[out] bytes Bytes requested by them.
+     */
+    static void get_thread_allocs(uint64_t *allocs, uint64_t *bytes);
+
+    /**!
+     * @brief Records one handled event.
+     *
+     * @param[in] domain Domain of the type.
+     * @param[in] type Event or message type.
+     * @param[in] cpu_ns CPU time of the handler.
+     * @param[in] allocs Allocations of the handler.
+     * @param[in] alloc_bytes Bytes allocated by the handler.
+     */
+    static void record(em_profile_domain_t domain, unsigned int type, uint64_t cpu_ns, uint64_t allocs, uint64_t alloc_bytes);
+
+    /**!
+     * @brief Returns the types with the most CPU time.
+     *
+     * @param[out] entries Array of at least n entries, most expensive first.
+     * @param[in] n Number of entries wanted.
+     *
+     * @returns Number of entries filled, at most the number of types seen.
+     */
+    static unsigned int get_top(em_profile_entry_t *entries, unsigned int n);
+
+    /**!
+     * @brief Encodes the types with the most CPU time.
+     *
+     * @param[in] arr Array one object per type is added to.
+     * @param[in] n Number of types.
+     * @param[in] name_fn Names of the types, or NULL.
+     */
+    static void encode(cJSON *arr, unsigned int n = EM_PROFILE_TOP_N, em_profile_name_fn_t name_fn = NULL);
+
+    /**!
+     * @brief Prints the types with the most CPU time, one line each.
+     */
+    static void print(unsigned int n = EM_PROFILE_TOP_N, em_profile_name_fn_t name_fn = NULL);
+
+    static void reset();
+
+    static const char *get_domain_str(em_profile_domain_t domain);
+};
+
+/*
+ * Records the CPU time and the allocations of a scope, used through EM_PROFILE_SCOPE().
+ */
+class em_profile_scope_t {
+
+    em_profile_domain_t m_domain;
+    unsigned int m_type;
+    uint64_t m_cpu_ns;
+    uint64_t m_allocs;
+    uint64_t m_alloc_bytes;
+
+public:
+
+    em_profile_scope_t(em_profile_domain_t domain, unsigned int type) : m_domain(domain), m_type(type),
+        m_cpu_ns(em_profile_t::get_thread_cpu_ns()), m_allocs(0), m_alloc_bytes(0)
+    {
+        em_profile_t::get_thread_allocs(&m_allocs, &m_alloc_bytes);
+    }
+
+    ~em_profile_scope_t()
+    {
+        uint64_t allocs, bytes;
+
+        em_profile_t::get_thread_allocs(&allocs, &bytes);
+        em_profile_t::record(m_domain, m_type, em_profile_t::get_thread_cpu_ns() - m_cpu_ns, allocs - m_allocs, bytes - m_alloc_bytes);
+    }
+
+    em_profile_scope_t(const em_profile_scope_t&) = delete;
+    em_profile_scope_t& operator=(const em_profile_scope_t&) = delete;
+};
+
+#endif
@@ -20,6 +20,7 @@
 #define EM_PROVISIONING_H
 
 #include "em_base.h"
+#include "em_tlv_writer.h"
 #include "ec_manager.h"
 #include <memory>
 
@@ -46,6 +47,16 @@ class em_provisioning_t {
 	 */
 	int create_dpp_direct_encap_msg(uint8_t *buff, uint8_t *frame, uint16_t len);
 
+	/**!
+	 * @brief Finishes the DPP message built in the TLV writer and sends its frames.
+	 *
+	 * @param[in] type Type of the message, for the validation.
+	 * @param[in] name Name of the message, for the logs.
+	 *
+	 * @returns int Length of the message on success, -1 on failure.
+	 */
+	int send_dpp_msg(em_msg_type_t type, const char *name);
+
 	/**!
 	 * @brief Handles the 1905 rekey message.
 	 *
@@ -323,6 +334,22 @@ class em_provisioning_t {
 	 * @note This is a pure virtual function and must be implemented by derived classes.
 	 */
 	virtual int send_frame(uint8_t *buff, unsigned int len, bool multicast = false) = 0;
+
+	/**!
+	 * @brief Sends the frames of a fragmented message in order.
+	 *
+	 * @returns Number of frames sent, or -1 if none could be sent.
+	 *
+	 * @note This is a pure virtual function and must be implemented by derived classes.
+	 */
+	virtual int send_frames(unsigned char **buffs, unsigned int *lens, unsigned int num, bool multicast = false) = 0;
+
+	/**!
+	 * @brief Returns the TLV writer used to build outgoing messages.
+	 *
+	 * @note This is a pure virtual function and must be implemented by derived classes.
+	 */
+	virtual em_tlv_writer_t *get_tlv_writer() = 0;
     
 	/**!
 	 * @brief Sends a command to the specified service type.
@@ -430,6 +457,25 @@ protected:
 	 */
 	int send_prox_encap_dpp_msg(em_encap_dpp_t* encap_dpp_tlv, size_t encap_dpp_len, em_dpp_chirp_value_t *chirp, size_t chirp_len, uint8_t dst_al_mac[ETH_ALEN]);
 
+	/**!
+	 * @brief Sends a proxied encapsulated DPP message, the 1905 Encap DPP TLV is written in place.
+	 *
+	 * The TLV header fields and the frame go straight into the message buffer of the TLV
+	 * writer, no Encap DPP TLV is allocated on the way.
+	 *
+	 * @param[in] dpp_frame_indicator 0 for a DPP Public Action frame, 1 for a GAS frame.
+	 * @param[in] dest_mac Destination STA MAC address of the TLV, NULL if not present.
+	 * @param[in] frame_type Frame type of the TLV.
+	 * @param[in] frame Pointer to the DPP frame.
+	 * @param[in] frame_len Length of the DPP frame.
+	 * @param[in] dst_al_mac Pointer to the destination AL MAC address (6 bytes).
+	 *
+	 * @returns int
+	 * @retval Length of the message on success
+	 * @retval -1 on failure
+	 */
+	int send_prox_encap_dpp_frame(bool dpp_frame_indicator, uint8_t *dest_mac, ec_frame_type_t frame_type, uint8_t *frame, size_t frame_len, uint8_t dst_al_mac[ETH_ALEN]);
+
 	/**!
 	 * @brief Sends a direct encapsulated DPP message. 
 	 *
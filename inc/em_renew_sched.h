@@ -0,0 +1,165 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_RENEW_SCHED_H
+#define EM_RENEW_SCHED_H
+
+#include <pthread.h>
+#include "em_base.h"
+#include "em_hex.h"
+
+#include <vector>
+#include <unordered_map>
+
+#define EM_RENEW_SCHED_MAX_ACTIVE   4       // radios going through M1/M2 at the same time
+#define EM_RENEW_SCHED_GAP_MS       250     // between two radios starting their renew
+#define EM_RENEW_SCHED_STEP_MS      10000   // an active radio that did not finish by then frees its slot as failed, a
+                                            // round that did not move for as long gives up on the radio holding it
+
+typedef enum {
+    em_renew_sched_waiting,         // not its turn yet
+    em_renew_sched_active,          // renew sent, M1/M2 in progress
+    em_renew_sched_done,
+    em_renew_sched_failed,
+} em_renew_sched_state_t;
+
+typedef struct {
+    mac_address_t   ruid;
+    mac_address_t   al_mac;         // agent of the radio
+    unsigned int    hops;           // backhaul links between the agent and the controller
+} em_renew_sched_radio_t;
+
+typedef struct {
+    em_renew_sched_radio_t  radio;
+    em_renew_sched_state_t  state;
+    unsigned long long      start_ms;
+} em_renew_sched_entry_t;
+
+typedef struct {
+    unsigned int    total;          // radios of the current round
+    unsigned int    waiting;
+    unsigned int    active;
+    unsigned int    done;
+    unsigned int    failed;
+    unsigned long long  rounds;
+    unsigned long long  timeouts;   // radios that did not finish within EM_RENEW_SCHED_STEP_MS
+} em_renew_sched_progress_t;
+
+/*
+ * Controller pacing of a mesh wide autoconfiguration renew. The radios of a round are
+ * ordered by the hops of their agent, the deepest first, so that an agent renews before
+ * the agent its backhaul goes through and the backhaul parents keep their links until the
+ * agents behind them are done. At most max_active radios are between the renew and the
+ * M2 at a time and two radios start at least gap_ms apart, so the M1s and their key
+ * derivation reach the controller spread out. The radios that are not part of the round
+ * are not held back. Thread safe.
+ */
+class em_renew_sched_t {
+
+    pthread_mutex_t m_lock;
+    std::vector<em_renew_sched_entry_t> m_entries;      // round order
+    std::unordered_map<em_packed_mac_t, unsigned int> m_index;     // radio unique identifier to entry
+    unsigned int m_next;            // first entry still waiting
+    unsigned int m_active;
+    unsigned long long m_last_start_ms;
+    unsigned long long m_moved_ms;  // last plan, start or finish
+    unsigned int m_max_active;
+    unsigned int m_gap_ms;
+    em_renew_sched_progress_t m_progress;
+
+    /**!
+     * @brief Frees the slots of the active radios that did not finish in time and skips a stuck radio.
+     */
+    void expire(unsigned long long now);
+
+    /**!
+     * @brief Moves m_next to the first radio still waiting.
+     */
+    void advance();
+
+    /**!
+     * @brief Ends an active radio, with the lock held.
+     */
+    void end(em_renew_sched_entry_t *entry, bool ok);
+
+public:
+
+    /**!
+     * @brief Sets the pacing.
+     *
+     * @param[in] max_active Radios in progress at a time, 0 for no limit.
+     * @param[in] gap_ms Time between two starts, 0 for none.
+     */
+    void set_limits(unsigned int max_active, unsigned int gap_ms);
+
+    /**!
+     * @brief Starts a round, the radios still waiting from the previous one join it.
+     *
+     * @param[in] radios Radios to renew.
+     * @param[in] num Number of radios.
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns Number of radios in the round.
+     */
+    unsigned int plan(const em_renew_sched_radio_t *radios, unsigned int num, unsigned long long now);
+
+    /**!
+     * @brief Returns whether a radio may send its renew now, it is active from then on.
+     *
+     * A radio of the round may start when no radio still waiting is deeper in the mesh,
+     * a slot is free and gap_ms passed since the last start. A radio that is not in the
+     * round or already started always may.
+     */
+    bool may_start(const unsigned char *ruid, unsigned long long now);
+
+    /**!
+     * @brief Ends the renew of a radio.
+     *
+     * @param[in] ruid Radio unique identifier.
+     * @param[in] ok False if the renew was canceled.
+     * @param[in] now Current time in milliseconds.
+     */
+    void finish(const unsigned char *ruid, bool ok, unsigned long long now);
+
+    /**!
+     * @brief Returns the state and start time of a radio in the round.
+     *
+     * @returns False if the radio is not in the round.
+     */
+    bool get_entry(const unsigned char *ruid, em_renew_sched_entry_t *entry);
+
+    /**!
+     * @brief Returns how far the round is.
+     */
+    em_renew_sched_progress_t get_progress();
+
+    /**!
+     * @brief Constructor for em_renew_sched_t.
+     */
+    em_renew_sched_t();
+
+    /**!
+     * @brief Destructor for em_renew_sched_t.
+     */
+    ~em_renew_sched_t();
+
+    em_renew_sched_t(const em_renew_sched_t&) = delete;
+    em_renew_sched_t& operator=(const em_renew_sched_t&) = delete;
+};
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_ROUTE_TABLE_H
+#define EM_ROUTE_TABLE_H
+
+#include <pthread.h>
+#include "em_base.h"
+#include "em_hex.h"
+
+#include <unordered_map>
+
+#define EM_ROUTE_TABLE_MAX_ROUTES   256     // agents taken from one walk of the topology
+#define EM_ROUTE_SLOW_LINK_MBPS     100     // a path whose bottleneck is below polls half as often
+#define EM_ROUTE_MAX_POLL_SCALE     8
+
+typedef struct {
+    mac_address_t   al_mac;
+    mac_address_t   next_hop;           // AL MAC of the agent directly under the controller on the path
+    unsigned int    hops;               // backhaul links from the controller
+    unsigned int    wireless_hops;      // of those, the ones over a backhaul BSS
+    unsigned int    bottleneck_mbps;    // lowest known link rate of the path, 0 if none is known
+} em_route_t;
+
+typedef struct {
+    unsigned int    updates;            // update() calls
+    unsigned int    changed;            // routes added, removed or moved by them
+    unsigned long long  lookups;
+    unsigned long long  misses;
+} em_route_table_stats_t;
+
+/*
+ * Backhaul path of every agent as seen from the controller, taken from the em_network_topo_t
+ * tree each time the topology changes so that the senders do not walk the tree. The path
+ * tells how often an agent is worth polling, the background polling of agents deep behind
+ * wireless hops or slow links is spread out so that the control traffic to them has the
+ * airtime. Thread safe.
+ */
+class em_route_table_t {
+
+    pthread_mutex_t m_lock;
+    std::unordered_map<em_packed_mac_t, em_route_t> m_routes;
+    em_route_table_stats_t m_stats;
+
+public:
+
+    /**!
+     * @brief Replaces the routes by the ones of the current topology.
+     *
+     * @param[in] routes The routes, one per agent.
+     * @param[in] num Number of routes.
+     *
+     * @returns Number of routes added, removed or moved.
+     */
+    unsigned int update(const em_route_t *routes, unsigned int num);
+
+    /**!
+     * @brief Returns the route of an agent.
+     *
+     * @param[in] al_mac AL MAC of the agent.
+     * @param[out] route Receives the route.
+     *
+     * @returns True if the agent is in the topology.
+     */
+    bool get_route(const unsigned char *al_mac, em_route_t *route);
+
+    /**!
+     * @brief Returns by how much the polling period of an agent is stretched.
+     *
+     * @param[in] al_mac AL MAC of the agent.
+     *
+     * @returns 1 for an agent one wireless hop away or unknown, up to EM_ROUTE_MAX_POLL_SCALE.
+     */
+    unsigned int get_poll_scale(const unsigned char *al_mac);
+
+    /**!
+     * @brief Returns by how much the polling period over a route is stretched.
+     *
+     * Doubled for every wireless hop after the first, up to two, and once more if the
+     * bottleneck is below EM_ROUTE_SLOW_LINK_MBPS.
+     */
+    static unsigned int get_poll_scale(const em_route_t *route);
+
+    /**!
+     * @brief Returns the number of routes.
+     */
+    unsigned int count();
+
+    /**!
+     * @brief Returns the counters.
+     */
+    em_route_table_stats_t get_stats();
+
+    /**!
+     * @brief Constructor for em_route_table_t.
+     */
+    em_route_table_t();
+
+    /**!
+     * @brief Destructor for em_route_table_t.
+     */
+    ~em_route_table_t();
+
+    em_route_table_t(const em_route_table_t&) = delete;
+    em_route_table_t& operator=(const em_route_table_t&) = delete;
+};
+
+#endif
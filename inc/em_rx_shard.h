@@ -0,0 +1,141 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_RX_SHARD_H
+#define EM_RX_SHARD_H
+
+#include <pthread.h>
+#include <atomic>
+#include "em_mpsc_queue.h"
+#include "em_frame_ring.h"
+#include "em_cmdu_reasm.h"
+#include "em_msg.h"
+
+#define EM_RX_SHARD_MAX         16
+#define EM_RX_SHARD_QUEUE_SZ    256     // frames waiting for one shard
+
+class em_rx_shard_pool_t;
+
+struct em_rx_shard_t {
+    em_rx_shard_pool_t *pool;
+    unsigned int idx;
+    pthread_t tid;
+    em_mpsc_queue_t queue;              // frames read by the listener, in the order they were read
+    em_cmdu_reasm_t reasm;              // fragments of the agents owned by the shard
+    em_msg_type_stats_t msg_stats[EM_MSG_TYPE_SLOTS];   // messages routed by the shard, drops had no target em
+    std::atomic<unsigned int> drops;    // frames dropped because the queue was full
+};
+
+// routes a received frame, run on the thread of the shard owning its source
+typedef void (*em_rx_shard_route_cb_t)(void *ctx, em_rx_shard_t *shard, em_rx_buff_t *buff, unsigned int len, void *src);
+
+/*
+ * Receive shards of the manager. The listener only reads the frames and hands each to
+ * the shard owning its source AL MAC, the shard reassembles, counts and routes them to
+ * their em on its own thread. All frames of an agent, and so all fragments of one of
+ * its messages, go through the same shard in the order they were read.
+ */
+class em_rx_shard_pool_t {
+
+    em_rx_shard_t *m_shards;
+    unsigned int m_num;
+    em_rx_shard_route_cb_t m_route;
+    void *m_ctx;
+    std::atomic<bool> m_exit;
+
+    /**!
+     * @brief Main loop of a shard thread.
+     *
+     * @param[in] shard Pointer to the shard.
+     */
+    void run(em_rx_shard_t *shard);
+
+    /**!
+     * @brief Entry point of the shard threads.
+     *
+     * @param[in] arg Pointer to the em_rx_shard_t.
+     */
+    static void *shard_func(void *arg);
+
+public:
+
+    /**!
+     * @brief Starts the shards.
+     *
+     * @param[in] num Number of shards, at most EM_RX_SHARD_MAX.
+     * @param[in] ring Ring the reassembled messages are taken from.
+     * @param[in] route Callback routing the frames.
+     * @param[in] ctx Context passed to the callback.
+     *
+     * @returns int
+     * @retval 0 on success
+     * @retval -1 on failure, no shard is left running
+     */
+    int init(unsigned int num, em_frame_ring_t *ring, em_rx_shard_route_cb_t route, void *ctx);
+
+    /**!
+     * @brief Stops and joins the shards, releasing the frames still queued.
+     */
+    void deinit();
+
+    /**!
+     * @brief Returns the shard owning a source.
+     *
+     * @param[in] mac AL MAC of the source.
+     * @param[in] num Number of shards.
+     */
+    static unsigned int get_shard(const unsigned char *mac, unsigned int num);
+
+    /**!
+     * @brief Hands a frame to the shard owning its source, called from the listener only.
+     *
+     * @param[in] buff Receive buffer holding the frame, owned by the shard from now on.
+     * @param[in] len Length of the frame, at least the size of the Ethernet header.
+     * @param[in] src Node the frame was read from, passed to the callback.
+     *
+     * @returns True if the frame was queued, false if it was dropped.
+     */
+    bool dispatch(em_rx_buff_t *buff, unsigned int len, void *src);
+
+    /**!
+     * @brief Returns the number of running shards, 0 if the pool is not started.
+     */
+    unsigned int get_num_shards() { return m_num; }
+
+    /**!
+     * @brief Returns a shard.
+     *
+     * @param[in] idx Index of the shard, below get_num_shards().
+     */
+    em_rx_shard_t *get_shard(unsigned int idx) { return &m_shards[idx]; }
+
+    /**!
+     * @brief Constructor for em_rx_shard_pool_t.
+     */
+    em_rx_shard_pool_t();
+
+    /**!
+     * @brief Destructor for em_rx_shard_pool_t, stops the shards.
+     */
+    ~em_rx_shard_pool_t();
+
+    em_rx_shard_pool_t(const em_rx_shard_pool_t&) = delete;
+    em_rx_shard_pool_t& operator=(const em_rx_shard_pool_t&) = delete;
+};
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_SCAN_DIFF_H
+#define EM_SCAN_DIFF_H
+
+#include "em_base.h"
+#include "em_hex.h"
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+typedef struct {
+    bool                enabled;            // false reports every result
+    unsigned char       rcpi_threshold;     // change of the signal of a neighbor that is reported, in dB
+    unsigned char       util_threshold;     // change of the utilization of the channel that is reported
+    unsigned int        refresh_ms;         // an unchanged result is reported again after this long
+} em_scan_diff_params_t;
+
+typedef struct {
+    unsigned long long  results;            // results compared
+    unsigned long long  suppressed;         // results left out of a report, unchanged
+    unsigned long long  appeared;           // neighbors not in the result last reported
+    unsigned long long  disappeared;        // neighbors of the result last reported gone
+    unsigned long long  changed;            // neighbors whose signal moved beyond the threshold
+} em_scan_diff_stats_t;
+
+/*
+ * Agent side record of the scan results last reported to the controller, one per
+ * scanner, operating class and channel. A Channel Scan Report only carries the results
+ * where a neighbor appeared or disappeared, the signal of one moved by rcpi_threshold or
+ * more, the utilization of the channel by util_threshold or more, or the scan status
+ * changed. The controller replaces a result as a whole when it receives it and keeps
+ * the ones it does not receive, so left out results stay valid there; each is still
+ * reported every refresh_ms so that the controller does not age it out. Not thread
+ * safe, owned by the em of a radio.
+ */
+class em_scan_diff_t {
+
+    typedef std::vector<std::pair<em_packed_mac_t, signed char> > em_scan_diff_nbrs_t;
+
+    typedef struct {
+        unsigned char       scan_status;
+        unsigned char       util;
+        unsigned long long  reported_ms;
+        em_scan_diff_nbrs_t nbrs;           // sorted by BSSID
+    } em_scan_diff_entry_t;
+
+    em_scan_diff_params_t m_params;
+    em_scan_diff_stats_t m_stats;
+    std::unordered_map<unsigned long long, em_scan_diff_entry_t> m_entries;
+
+    static unsigned long long get_key(const em_scan_result_id_t *id);
+    static void get_nbrs(const em_scan_result_t *res, em_scan_diff_nbrs_t& nbrs);
+
+public:
+
+    /**!
+     * @brief Tells if a scan result differs enough from the one last reported to be reported.
+     *
+     * @param[in] res The scan result.
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns True if the result is to be reported, false if it can be left out.
+     */
+    bool is_changed(const em_scan_result_t *res, unsigned long long now);
+
+    /**!
+     * @brief Records a scan result as reported.
+     *
+     * @param[in] res The scan result.
+     * @param[in] now Current time in milliseconds.
+     */
+    void reported(const em_scan_result_t *res, unsigned long long now);
+
+    /**!
+     * @brief Forgets every result reported, the next report carries them all.
+     */
+    void forget() { m_entries.clear(); }
+
+    /**!
+     * @brief Returns the number of results recorded.
+     */
+    unsigned int get_count() const { return static_cast<unsigned int> (m_entries.size()); }
+
+    /**!
+     * @brief Sets the parameters.
+     */
+    void set_params(const em_scan_diff_params_t *params) { m_params = *params; }
+
+    /**!
+     * @brief Returns the parameters.
+     */
+    const em_scan_diff_params_t& get_params() { return m_params; }
+
+    /**!
+     * @brief Returns the counters.
+     */
+    const em_scan_diff_stats_t& get_stats() { return m_stats; }
+
+    /**!
+     * @brief Constructor for em_scan_diff_t, with the default parameters.
+     */
+    em_scan_diff_t();
+
+    /**!
+     * @brief Destructor for em_scan_diff_t.
+     */
+    ~em_scan_diff_t();
+};
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_SCHED_H
+#define EM_SCHED_H
+
+#include <pthread.h>
+#include "em_stack.h"
+
+#define EM_SCHED_ROLE_MGR       em_stack_role_max       // the manager thread, the one running em_mgr_t::start()
+#define EM_SCHED_NUM_ROLES      (em_stack_role_max + 1)
+#define EM_SCHED_MAX_CPUS       64
+#define EM_SCHED_NAME_LEN       16                      // kernel limit of a thread name, nul included
+
+typedef struct {
+    unsigned long long  cpus;       // bit per CPU the threads run on, 0 to leave them floating
+    int     policy;                 // SCHED_OTHER, SCHED_FIFO or SCHED_RR
+    int     priority;               // real time priority, 1 to 99, for SCHED_FIFO and SCHED_RR
+    bool    set_nice;
+    int     nice;
+} em_sched_cfg_t;
+
+/*
+ * Scheduling of the threads by role. Every thread names itself after its role when it
+ * starts and takes the CPUs, real time policy and nice value configured for the role, so
+ * the frame I/O and the orchestration can be pinned away from the busy cores of the SoC
+ * and run ahead of the rest. Nothing is changed for a role that is not configured. A
+ * setting the process is not allowed, e.g. a real time policy without CAP_SYS_NICE, is
+ * reported and the thread runs on with the default.
+ */
+class em_sched_t {
+
+    static em_sched_cfg_t s_cfg[EM_SCHED_NUM_ROLES];
+    static pthread_mutex_t s_lock;
+
+    /**!
+     * @brief Parses the options of one role, e.g. "cpus=2-3:fifo=20".
+     *
+     * @returns 0 on success, -1 on a bad option.
+     */
+    static int parse(const char *spec, const char *end, em_sched_cfg_t *cfg);
+
+public:
+
+    /**!
+     * @brief Sets the scheduling from a list of role:option[:option...], e.g.
+     * "listener:cpus=2-3:fifo=20,mgr:cpus=1:nice=-5".
+     *
+     * The options are cpus=<CPUs> as numbers and ranges joined by '+', fifo=<priority>,
+     * rr=<priority> and nice=<value>. The roles are those of em_stack_t and mgr.
+     *
+     * @param[in] spec The list, comma separated.
+     *
+     * @returns 0 on success, -1 on an unknown role or a bad option, nothing is set then.
+     */
+    static int configure(const char *spec);
+
+    /**!
+     * @brief Clears the scheduling of every role, mainly for tests.
+     */
+    static void reset();
+
+    /**!
+     * @brief Returns the scheduling of a role.
+     *
+     * @param[in] role Role, below EM_SCHED_NUM_ROLES.
+     * @param[out] cfg Scheduling.
+     */
+    static void get_cfg(unsigned int role, em_sched_cfg_t *cfg);
+
+    /**!
+     * @brief Names the calling thread and applies the scheduling of its role.
+     *
+     * @param[in] role Role of the thread, below EM_SCHED_NUM_ROLES.
+     * @param[in] name Name of the thread, shortened to fit EM_SCHED_NAME_LEN, NULL to keep
+     * the name, e.g. for the main thread whose name is the one of the process.
+     *
+     * @returns 0 on success, -1 if a setting could not be applied.
+     */
+    static int apply(unsigned int role, const char *name);
+
+    /**!
+     * @brief Shortens a thread name, keeping the prefix up to the first '-' and the end.
+     *
+     * @param[in] name Name of the thread.
+     * @param[out] out Shortened name, EM_SCHED_NAME_LEN bytes.
+     */
+    static void get_short_name(const char *name, char *out);
+
+    /**!
+     * @brief Returns the name of a role, as used in configure().
+     */
+    static const char *get_role_str(unsigned int role);
+};
+
+#endif
@@ -19,11 +19,43 @@
 #ifndef EM_SM_H
 #define EM_SM_H
 
+#include <pthread.h>
+#include <stdint.h>
+#include <atomic>
 #include "em_base.h"
+#include "em_lat_hist.h"
 
+#define EM_SM_POLL_MS           (EM_PROTO_TOUT * 1000)  // deadline of the states whose code retries a request or waits on other nodes
+#define EM_SM_SLACK_MS          (EM_SM_POLL_MS / 2)     // the tick is not exact, a deadline this close is taken as reached
+#define EM_SM_NUM_AGENT_STATES  (em_state_agent_ap_metrics_pending + 1)
+#define EM_SM_NUM_STATES        (EM_SM_NUM_AGENT_STATES + em_state_max - em_state_ctrl_unconfigured)
+
+typedef struct {
+	em_state_t		state;
+	unsigned int	deadline_ms;	// the state code runs again this long after it last ran, 0 if only on events
+} em_sm_state_info_t;
+
+/*
+ * State of a node. The states are described by a table fixed at compile time, the
+ * state code of a node runs when its state changes, when an event reaches it or when
+ * the deadline of its state passes, states waiting for a peer have no deadline and
+ * cost nothing on the ticks in between. The time spent in each state is recorded.
+ */
 class em_sm_t {
 	
-	em_state_t	m_state;
+	std::atomic<em_state_t>	m_state;
+	pthread_mutex_t	m_lock;				// states are also set from the orchestrator and from other nodes
+	std::atomic<bool>	m_kicked;		// the state code has to run on the next tick
+	uint64_t	m_enter_us;				// when the state was entered
+	uint64_t	m_next_us;				// deadline of the state code, 0 if none
+	unsigned int	m_transitions;
+	unsigned int	m_runs;				// times the state code ran
+	em_lat_hist_t	m_time_in_state[EM_SM_NUM_STATES];
+
+	/**!
+	 * @brief Returns the index of a state in the state table, -1 if it is not a state.
+	 */
+	static int get_state_index(em_state_t state);
 
 public:
 	
@@ -60,7 +92,59 @@ public:
 	 *
 	 * @returns The current state of type em_state_t.
 	 */
-	em_state_t get_state() { return m_state; }
+	em_state_t get_state() { return m_state.load(); }
+
+	/**!
+	 * @brief Makes the state code run on the next tick, called when an event reached the node.
+	 */
+	void kick() { m_kicked = true; }
+
+	/**!
+	 * @brief Returns true if the state code has nothing to run until an event, no event is
+	 * pending and the state has no deadline.
+	 */
+	bool is_waiting();
+
+	/**!
+	 * @brief Decides if the state code runs on this tick and arms the next deadline if it does.
+	 *
+	 * @param[in] now_us Current time in microseconds, see em_lat_hist_t::get_time_us().
+	 *
+	 * @returns True if the state changed, an event arrived or the deadline of the state passed.
+	 */
+	bool begin_run(uint64_t now_us);
+
+	/**!
+	 * @brief Copies the histogram of the time spent in a state.
+	 *
+	 * @param[in] state The state.
+	 * @param[out] hist Receives the histogram, one sample per time the state was left.
+	 *
+	 * @returns True on success, false if state is not a state.
+	 */
+	bool get_time_in_state(em_state_t state, em_lat_hist_t *hist);
+
+	/**!
+	 * @brief Returns the number of state changes.
+	 */
+	unsigned int get_num_transitions();
+
+	/**!
+	 * @brief Returns the number of times the state code ran.
+	 */
+	unsigned int get_num_runs();
+
+	/**!
+	 * @brief Returns the entry of a state in the state table, NULL if it is not a state.
+	 */
+	static const em_sm_state_info_t *get_state_info(em_state_t state);
+
+	/**!
+	 * @brief Returns the state at an index of the state table.
+	 *
+	 * @param[in] idx Index, below EM_SM_NUM_STATES.
+	 */
+	static em_state_t get_state_at(unsigned int idx);
 
 	
 	/**!
@@ -93,6 +177,9 @@ public:
 	 * @note Ensure that all resources are properly released before the object is destroyed.
 	 */
 	~em_sm_t();
+
+	em_sm_t(const em_sm_t&) = delete;
+	em_sm_t& operator=(const em_sm_t&) = delete;
 };
 
 #endif
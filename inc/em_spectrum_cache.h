@@ -0,0 +1,186 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_SPECTRUM_CACHE_H
+#define EM_SPECTRUM_CACHE_H
+
+#include <pthread.h>
+#include <time.h>
+#include "em_base.h"
+#include "em_hex.h"
+
+#include <vector>
+#include <unordered_map>
+
+#define EM_SPECTRUM_CACHE_GRID          10000   // location cells of 1/10000 degree, about 11 m, share their spectrum
+#define EM_SPECTRUM_CACHE_MAX_TTL_MS    86400000    // an availability is not trusted longer than a day, whatever it says
+#define EM_SPECTRUM_CACHE_REFRESH_MS    3600000 // inquire again this long before the availability expires
+#define EM_SPECTRUM_CACHE_INFLIGHT_MS   10000   // an inquiry without response by then failed
+#define EM_SPECTRUM_CACHE_RETRY_MS      300000  // after a failed inquiry the location is not inquired again for this long
+
+typedef enum {
+    em_spectrum_state_unknown,      // no availability for the location and operating class, or it expired
+    em_spectrum_state_available,    // the AFC system allows standard power on the channel
+    em_spectrum_state_unavailable,  // the operating class is known and the channel is not in it
+} em_spectrum_state_t;
+
+typedef enum {
+    em_spectrum_query_cached,       // the availability of the location is fresh, no inquiry needed
+    em_spectrum_query_send,         // the caller sends the inquiry, the location is marked in flight
+    em_spectrum_query_wait,         // an inquiry of the location is in flight, possibly for another radio
+    em_spectrum_query_failed,       // the last inquiry failed, go on without until EM_SPECTRUM_CACHE_RETRY_MS
+} em_spectrum_query_t;
+
+typedef struct {
+    unsigned char   channel;        // channel center frequency index
+    signed char     max_eirp;       // dBm
+} em_spectrum_channel_t;
+
+typedef struct {
+    unsigned long long  expire_ms;
+    std::vector<em_spectrum_channel_t>  channels;
+} em_spectrum_entry_t;
+
+typedef struct {
+    em_packed_mac_t     owner;          // agent that sent the last inquiry or availability
+    unsigned long long  inflight_ms;    // inquiry sent, 0 if none in flight
+    unsigned long long  failed_ms;      // last inquiry failed, 0 if it did not
+    std::unordered_map<unsigned char, em_spectrum_entry_t> op_classes;
+} em_spectrum_location_t;
+
+typedef struct {
+    unsigned long long  hits;           // get_state() answered from a fresh availability
+    unsigned long long  misses;
+    unsigned int        inquiries;      // em_spectrum_query_send answers
+    unsigned int        shared;         // query() answered from the inquiry or availability of another agent
+    unsigned int        expired;        // availabilities dropped at their expiry
+    unsigned int        failed;
+} em_spectrum_cache_stats_t;
+
+/*
+ * Controller cache of the 6 GHz standard power spectrum that the AFC system makes available,
+ * from the Available Spectrum Inquiry Responses of the agents. The availability of an
+ * operating class is kept per location, the agents that reported the same location cell
+ * share it and share its inquiries, an agent whose location is not known has a location of
+ * its own. The channel preference of the radios comes from the cache and query() tells a
+ * Channel Selection Request whether an inquiry has to go out first, only when the
+ * availability is missing or about to expire rather than on every preference cycle.
+ * Thread safe.
+ */
+class em_spectrum_cache_t {
+
+    pthread_mutex_t m_lock;
+    std::unordered_map<em_packed_mac_t, unsigned long long> m_agents;      // AL MAC to location key
+    std::unordered_map<unsigned long long, em_spectrum_location_t> m_locations;
+    em_spectrum_cache_stats_t m_stats;
+
+    /**!
+     * @brief Returns the location key of an agent, its own one if its location is not known.
+     */
+    unsigned long long get_key(const unsigned char *agent);
+
+    /**!
+     * @brief Drops the availabilities of a location past their expiry.
+     */
+    void expire(em_spectrum_location_t *loc, unsigned long long now);
+
+public:
+
+    /**!
+     * @brief Returns true if an operating class is a 6 GHz one, subject to the AFC system for standard power.
+     */
+    static bool is_afc(unsigned char op_class) { return (op_class >= 131) && (op_class <= 137); }
+
+    /**!
+     * @brief Converts the availabilityExpireTime of an AFC response to the time in milliseconds.
+     *
+     * @param[in] str UTC time, "YYYY-MM-DDThh:mm:ssZ".
+     * @param[in] wall Current UTC time in seconds.
+     * @param[in] now Current time in milliseconds.
+     * @param[out] expire_ms Receives the expiry, at most EM_SPECTRUM_CACHE_MAX_TTL_MS away.
+     *
+     * @returns 0 on success, -1 if the time cannot be parsed or already passed.
+     */
+    static int parse_expire_time(const char *str, time_t wall, unsigned long long now, unsigned long long *expire_ms);
+
+    /**!
+     * @brief Sets the location of an agent, from the center of its AFC inquiry.
+     *
+     * @returns 0 on success, -1 if the coordinates are out of range.
+     */
+    int set_location(const unsigned char *agent, double latitude, double longitude);
+
+    /**!
+     * @brief Takes the availability of an operating class for the location of an agent, it replaces the previous one.
+     *
+     * @param[in] agent AL MAC of the agent.
+     * @param[in] op_class Global operating class.
+     * @param[in] channels Channels available, by center frequency index.
+     * @param[in] num Number of channels.
+     * @param[in] expire_ms Expiry, see parse_expire_time().
+     * @param[in] now Current time in milliseconds.
+     */
+    void put(const unsigned char *agent, unsigned char op_class, const em_spectrum_channel_t *channels, unsigned int num,
+             unsigned long long expire_ms, unsigned long long now);
+
+    /**!
+     * @brief Ends the inquiry in flight for the location of an agent.
+     *
+     * @param[in] agent AL MAC of the agent.
+     * @param[in] ok False if no availability came, the location is not inquired again for EM_SPECTRUM_CACHE_RETRY_MS.
+     * @param[in] now Current time in milliseconds.
+     */
+    void end_inquiry(const unsigned char *agent, bool ok, unsigned long long now);
+
+    /**!
+     * @brief Returns whether a channel of an operating class may be used at standard power by an agent.
+     *
+     * @param[out] max_eirp Receives the maximum EIRP of an available channel, may be NULL.
+     */
+    em_spectrum_state_t get_state(const unsigned char *agent, unsigned char op_class, unsigned char channel,
+                                  unsigned long long now, signed char *max_eirp);
+
+    /**!
+     * @brief Returns whether an inquiry is needed for the location of an agent before its channel selection.
+     *
+     * An availability that expires within EM_SPECTRUM_CACHE_REFRESH_MS needs one, the first
+     * caller is answered em_spectrum_query_send and the others em_spectrum_query_wait until
+     * end_inquiry() or EM_SPECTRUM_CACHE_INFLIGHT_MS.
+     */
+    em_spectrum_query_t query(const unsigned char *agent, unsigned long long now);
+
+    /**!
+     * @brief Returns the counters.
+     */
+    em_spectrum_cache_stats_t get_stats();
+
+    /**!
+     * @brief Constructor for em_spectrum_cache_t.
+     */
+    em_spectrum_cache_t();
+
+    /**!
+     * @brief Destructor for em_spectrum_cache_t.
+     */
+    ~em_spectrum_cache_t();
+
+    em_spectrum_cache_t(const em_spectrum_cache_t&) = delete;
+    em_spectrum_cache_t& operator=(const em_spectrum_cache_t&) = delete;
+};
+
+#endif
@@ -0,0 +1,152 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_STA_METRICS_TABLE_H
+#define EM_STA_METRICS_TABLE_H
+
+#include <pthread.h>
+#include "em_base.h"
+#include "em_mac_index.h"
+
+#define EM_STA_METRICS_MIN_ROWS     64
+
+/*
+ * Columns of the STA metrics table, row i of every column is the same STA. Rows are
+ * dense, removing a STA moves the last row into its place, so a scan is a plain loop
+ * from 0 to num_rows over the columns it needs.
+ */
+typedef struct {
+    unsigned int    num_rows;
+    mac_address_t   *sta;
+    mac_address_t   *bssid;
+    unsigned int    *updated;           // CLOCK_MONOTONIC seconds of the last update
+    signed int      *signal_strength;
+    unsigned char   *rcpi;
+    unsigned int    *est_ul_rate;
+    unsigned int    *est_dl_rate;
+    unsigned int    *last_ul_rate;
+    unsigned int    *last_dl_rate;
+    unsigned int    *util_tx;
+    unsigned int    *util_rx;
+    unsigned int    *pkts_tx;
+    unsigned int    *pkts_rx;
+    unsigned int    *bytes_tx;
+    unsigned int    *bytes_rx;
+    unsigned int    *errors_tx;
+    unsigned int    *errors_rx;
+    unsigned int    *retrans_count;
+} em_sta_metrics_cols_t;
+
+/*
+ * Controller wide copy of the per STA metrics, laid out as a structure of arrays so
+ * that analytics over all clients (steering candidates, weakest clients) scan contiguous
+ * columns instead of chasing em_sta_info_t objects through the data models. The metrics
+ * handlers update it after they update the data model, one row per STA MAC.
+ * Thread safe, scans through get_cols() must hold the read lock.
+ */
+class em_sta_metrics_table_t {
+
+    pthread_rwlock_t m_lock;
+    em_sta_metrics_cols_t m_cols;
+    unsigned int m_size;                // rows allocated in every column
+    em_mac_index_t m_index;             // STA MAC -> row + 1
+
+    /**!
+     * @brief Doubles the rows of every column.
+     *
+     * @returns 0 on success, -1 on allocation failure, the table is then unchanged.
+     */
+    int grow();
+
+    /**!
+     * @brief Returns the current CLOCK_MONOTONIC time in seconds.
+     */
+    static unsigned int now();
+
+public:
+
+    /**!
+     * @brief Adds or refreshes the row of a STA from its data model information.
+     *
+     * @param[in] info Pointer to the STA information, id is the row key.
+     *
+     * @returns 0 on success, -1 if the row could not be allocated.
+     */
+    int update(const em_sta_info_t *info);
+
+    /**!
+     * @brief Removes the row of a STA.
+     *
+     * @param[in] sta STA MAC address.
+     *
+     * @returns True if the STA had a row, false otherwise.
+     */
+    bool remove(const unsigned char *sta);
+
+    /**!
+     * @brief Returns the STAs whose RCPI is below a threshold.
+     *
+     * @param[in] rcpi_thresh RCPI threshold.
+     * @param[in] max_age Rows not updated for more than this many seconds are skipped, 0 for no limit.
+     * @param[out] stas Array receiving the STA MAC addresses.
+     * @param[in] max Size of the array.
+     *
+     * @returns Number of STAs stored.
+     */
+    unsigned int find_weak(unsigned char rcpi_thresh, unsigned int max_age, mac_address_t *stas, unsigned int max);
+
+    /**!
+     * @brief Returns the number of STAs in the table.
+     */
+    unsigned int count();
+
+    /**!
+     * @brief Takes the read lock, required around get_cols() and the scan of the columns.
+     */
+    void read_lock() { pthread_rwlock_rdlock(&m_lock); }
+
+    /**!
+     * @brief Releases the read lock.
+     */
+    void read_unlock() { pthread_rwlock_unlock(&m_lock); }
+
+    /**!
+     * @brief Returns the columns, valid until the read lock is released.
+     */
+    const em_sta_metrics_cols_t *get_cols() const { return &m_cols; }
+
+    /**!
+     * @brief Removes all rows and frees the columns.
+     */
+    void clear();
+
+    /**!
+     * @brief Constructor for em_sta_metrics_table_t.
+     */
+    em_sta_metrics_table_t();
+
+    /**!
+     * @brief Destructor for em_sta_metrics_table_t.
+     */
+    ~em_sta_metrics_table_t();
+
+    em_sta_metrics_table_t(const em_sta_metrics_table_t&) = delete;
+    em_sta_metrics_table_t& operator=(const em_sta_metrics_table_t&) = delete;
+};
+
+#endif
@@ -0,0 +1,154 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_STACK_H
+#define EM_STACK_H
+
+#include <stddef.h>
+#include <pthread.h>
+#include <cjson/cJSON.h>
+
+#define EM_STACK_MAX_THREADS    128
+#define EM_STACK_MIN_SZ         0x10000     // 64KB, below it a size is refused
+#define EM_STACK_NAME_LEN       32
+#define EM_STACK_RESET_MARGIN   0x1000      // left as is under the frame of enter()
+
+typedef enum {
+    em_stack_role_node,         // an em_t running its own thread
+    em_stack_role_worker,       // worker pool threads running the ems
+    em_stack_role_crypto,       // crypto pool threads
+    em_stack_role_listener,     // input and nodes listeners of the manager
+    em_stack_role_max
+} em_stack_role_t;
+
+typedef struct {
+    em_stack_role_t role;
+    char            name[EM_STACK_NAME_LEN];
+    size_t          size;           // usable bytes, the guard page excluded
+    size_t          high_water;     // deepest use since the thread started
+} em_stack_thread_info_t;
+
+typedef struct {
+    bool            in_use;
+    em_stack_role_t role;
+    char            name[EM_STACK_NAME_LEN];
+    unsigned char   *low;           // lowest usable address, page aligned
+    unsigned char   *high;          // top of the stack
+} em_stack_slot_t;
+
+/*
+ * Stack sizes of the threads by role and their high water marks. A stack page is only
+ * backed once the thread touches it and stays so, the lowest resident page is the high
+ * water mark of the thread. A thread drops the pages under its frame when it starts, the
+ * ones a former thread left on a stack the C library reuses, so the mark is its own.
+ * Painting a canary would back every page of the stack, the memory the marks are there
+ * to save. Reading the marks costs a mincore() of each stack and nothing on the paths of
+ * the threads. The sizes are set from the command line before the threads start, so that
+ * small targets reserve what their threads actually use.
+ */
+class em_stack_t {
+
+    static size_t s_size[em_stack_role_max];
+    static size_t s_max_high_water[em_stack_role_max];     // of the threads that exited
+    static em_stack_slot_t s_slots[EM_STACK_MAX_THREADS];
+    static pthread_mutex_t s_lock;
+
+    static size_t scan(const em_stack_slot_t *slot);
+
+public:
+
+    /**!
+     * @brief Sets the stack size of a role, for the threads started after.
+     *
+     * @param[in] role Role of the threads.
+     * @param[in] size Size in bytes, rounded up to a page.
+     *
+     * @returns 0 on success, -1 if the size is below EM_STACK_MIN_SZ.
+     */
+    static int set_size(em_stack_role_t role, size_t size);
+
+    /**!
+     * @brief Sets the stack sizes from a list of role=KB, e.g. "node=256,worker=512".
+     *
+     * @param[in] spec The list, comma separated.
+     *
+     * @returns 0 on success, -1 on an unknown role or a bad size, nothing is set then.
+     */
+    static int configure(const char *spec);
+
+    /**!
+     * @brief Returns the stack size of a role.
+     */
+    static size_t get_size(em_stack_role_t role);
+
+    /**!
+     * @brief Sets the stack size of a role in the attributes of a thread to be created.
+     *
+     * @param[in] attr Initialized attributes.
+     * @param[in] role Role of the thread.
+     *
+     * @returns 0 on success, the error of pthread_attr_setstacksize() otherwise.
+     */
+    static int set_attr(pthread_attr_t *attr, em_stack_role_t role);
+
+    /**!
+     * @brief Resets the unused stack of the calling thread and registers it, first call of a thread.
+     *
+     * @param[in] role Role of the thread.
+     * @param[in] name Name reported for the thread.
+     *
+     * @returns Slot of the thread for leave(), -1 if it is not tracked.
+     */
+    static int enter(em_stack_role_t role, const char *name);
+
+    /**!
+     * @brief Unregisters the calling thread, its high water mark is kept for its role.
+     *
+     * @param[in] slot Slot returned by enter().
+     */
+    static void leave(int slot);
+
+    /**!
+     * @brief Returns the running threads with their high water marks.
+     *
+     * @param[out] info Receives the threads.
+     * @param[in] max Size of info.
+     *
+     * @returns Number of threads filled.
+     */
+    static unsigned int get_threads(em_stack_thread_info_t *info, unsigned int max);
+
+    /**!
+     * @brief Returns the deepest use of the threads of a role, the exited ones included.
+     */
+    static size_t get_max_high_water(em_stack_role_t role);
+
+    /**!
+     * @brief Adds the size and deepest use of each role and the threads to a JSON object.
+     *
+     * @param[in] obj JSON object to add the fields to.
+     */
+    static void encode(cJSON *obj);
+
+    /**!
+     * @brief Returns the name of a role, as used in configure() and the JSON encoding.
+     */
+    static const char *get_role_str(em_stack_role_t role);
+};
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_STARTUP_PROF_H
+#define EM_STARTUP_PROF_H
+
+#include <stdint.h>
+#include <pthread.h>
+#include <cjson/cJSON.h>
+
+#define EM_STARTUP_PROF_MAX_ENTRIES     64
+#define EM_STARTUP_PROF_NAME_LEN        32
+
+typedef enum {
+    em_startup_prof_phase,      // a step of the initialization
+    em_startup_prof_table,      // a database table loaded into the data model
+} em_startup_prof_kind_t;
+
+typedef struct {
+    em_startup_prof_kind_t  kind;
+    char                    name[EM_STARTUP_PROF_NAME_LEN];
+    unsigned int            depth;          // phases it runs in
+    uint64_t                start_us;       // since the first entry
+    uint64_t                us;
+    unsigned long long      rows;           // rows read, tables only
+    long long               heap_bytes;     // heap grown meanwhile, negative if it shrank
+    long long               rss_bytes;      // resident memory grown meanwhile
+    bool                    ended;
+} em_startup_prof_entry_t;
+
+/*
+ * Where the time of a cold start goes. The initialization marks its phases and the tables
+ * it loads, nested as they run, with the time, rows and memory each took. The profile is
+ * printed once when the initialization is done and kept for the CLI, entries begun after
+ * that are not recorded. The heap is read from the allocator where the C library reports
+ * it, the resident memory from /proc on every target.
+ */
+class em_startup_prof_t {
+
+    static em_startup_prof_entry_t s_entries[EM_STARTUP_PROF_MAX_ENTRIES];
+    static unsigned int s_num;
+    static unsigned int s_depth;
+    static uint64_t s_start_us;
+    static uint64_t s_total_us;
+    static bool s_done;
+    static pthread_mutex_t s_lock;
+
+public:
+
+    /**!
+     * @brief Begins an entry, the ones begun before it ends are nested in it.
+     *
+     * @param[in] kind Phase or table.
+     * @param[in] name Name of the entry.
+     *
+     * @returns Slot of the entry for end(), -1 once the profile is done or full.
+     */
+    static int begin(em_startup_prof_kind_t kind, const char *name);
+
+    /**!
+     * @brief Ends an entry.
+     *
+     * @param[in] slot Slot returned by begin(), -1 is ignored.
+     * @param[in] rows Rows read, for a table.
+     */
+    static void end(int slot, unsigned long long rows = 0);
+
+    /**!
+     * @brief Marks the end of the initialization and prints the profile, once.
+     */
+    static void done();
+
+    /**!
+     * @brief Returns true once done() was called.
+     */
+    static bool is_done();
+
+    /**!
+     * @brief Prints the profile, an entry per line indented by its nesting.
+     */
+    static void print();
+
+    /**!
+     * @brief Adds the total time and the entries to a JSON object.
+     *
+     * @param[in] obj JSON object to add the fields to.
+     */
+    static void encode(cJSON *obj);
+
+    /**!
+     * @brief Clears the profile, the next entry starts a new one.
+     */
+    static void reset();
+
+    /**!
+     * @brief Returns the heap in use, 0 where the C library does not report it.
+     */
+    static long long get_heap_bytes();
+
+    /**!
+     * @brief Returns the resident memory of the process, 0 if it cannot be read.
+     */
+    static long long get_rss_bytes();
+};
+
+/*
+ * Records a phase for the duration of a scope.
+ */
+class em_startup_prof_scope_t {
+
+    int m_slot;
+
+public:
+
+    explicit em_startup_prof_scope_t(const char *name) : m_slot(em_startup_prof_t::begin(em_startup_prof_phase, name)) { }
+
+    ~em_startup_prof_scope_t() { em_startup_prof_t::end(m_slot); }
+
+    em_startup_prof_scope_t(const em_startup_prof_scope_t&) = delete;
+    em_startup_prof_scope_t& operator=(const em_startup_prof_scope_t&) = delete;
+};
+
+#endif
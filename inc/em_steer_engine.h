@@ -0,0 +1,165 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_STEER_ENGINE_H
+#define EM_STEER_ENGINE_H
+
+#include "em_base.h"
+#include "em_sta_metrics_table.h"
+#include "em_metrics_history.h"
+#include "em_beacon_report_cache.h"
+#include "em_client_cap_cache.h"
+
+#include <unordered_map>
+
+#define EM_STEER_ENGINE_MAX_DECISIONS   16      // decisions returned by a pass
+
+typedef enum {
+    em_steer_action_steer,              // send a BTM request to the target
+    em_steer_action_beacon_report,      // no fresh target, query a Beacon Report first
+} em_steer_action_t;
+
+typedef struct {
+    bool            enabled;
+    unsigned char   rcpi_thresh;        // a STA whose RCPI EWMA is below is steered
+    unsigned char   rcpi_hysteresis;    // the target has to be this much better than the STA RCPI
+    unsigned int    util_thresh;        // STAs of a BSS whose utilization EWMA is above are offloaded, 0 to disable
+    unsigned int    util_hysteresis;    // the target BSS has to be this much less utilized
+    unsigned int    min_samples;        // STAs with fewer link metrics samples are skipped
+    unsigned int    backoff_ms;         // a steered STA is left alone this long, doubled per attempt
+    unsigned int    backoff_max_ms;
+    unsigned int    max_steers;         // steering decisions per pass
+    unsigned int    btm_disassoc_timer; // BTM Disassociation Timer of the requests, in TBTTs
+} em_steer_engine_params_t;
+
+typedef struct {
+    em_steer_action_t   action;
+    mac_address_t       sta;
+    bssid_t             source;
+    bssid_t             target;         // steer only
+    unsigned char       op_class;       // of the target
+    unsigned char       channel;
+    unsigned char       rcpi;           // RCPI EWMA of the STA
+    unsigned char       target_rcpi;    // RCPI of the target in the Beacon Report
+    unsigned long long  latency_ms;     // steer only, since the STA first needed steering
+} em_steer_decision_t;
+
+typedef struct {
+    unsigned long long  passes;
+    unsigned long long  steers;
+    unsigned long long  beacon_requests;
+    unsigned int        last_stas;          // STAs evaluated by the last pass
+    unsigned int        last_triggered;     // STAs that needed steering in the last pass
+    unsigned long long  last_pass_us;       // run time of the last pass
+    unsigned long long  max_pass_us;
+    unsigned long long  last_latency_ms;    // from the first pass a STA needed steering to its decision
+    unsigned long long  max_latency_ms;
+    unsigned long long  total_latency_ms;   // over all steers
+} em_steer_engine_stats_t;
+
+typedef struct {
+    unsigned long long  trigger_ms;     // first pass in which the STA needed steering, 0 if it does not
+    unsigned long long  backoff_until;
+    unsigned int        attempts;       // steers in a row, reset once the STA is left alone long enough
+    unsigned long long  pass;           // last pass that saw the STA
+} em_steer_sta_state_t;
+
+/*
+ * Controller steering decisions from the cached metrics. Each pass is one scan of the
+ * STA metrics table: a STA whose RCPI EWMA is below the threshold, or whose BSS is
+ * above the utilization threshold, needs steering. Its target is the strongest other
+ * BSS of its Beacon Reports, and it is only steered if the target is better by the
+ * hysteresis. Without a fresh Beacon Report the pass asks for one instead. A steered
+ * STA is left alone for a backoff that doubles on every attempt, so a STA bouncing
+ * between two BSSs is not steered in a loop. Not thread safe, run by the controller
+ * thread only.
+ */
+class em_steer_engine_t {
+
+    em_steer_engine_params_t m_params;
+    em_steer_engine_stats_t m_stats;
+    // keyed by the STA MAC packed in an integer
+    std::unordered_map<unsigned long long, em_steer_sta_state_t> m_stas;
+
+    /**!
+     * @brief Returns the current CLOCK_MONOTONIC time in microseconds, for the pass time.
+     */
+    static unsigned long long now_us();
+
+public:
+
+    /**!
+     * @brief Runs a pass over the STAs.
+     *
+     * @param[in] now Current time in milliseconds.
+     * @param[in] table Metrics of all STAs, for the STAs and their BSS.
+     * @param[in] sta_history Link metrics samples of the STAs, for the RCPI EWMA.
+     * @param[in] bss_history Samples of the BSSs, for the utilization EWMA.
+     * @param[in] reports Beacon Reports of the STAs, for the targets.
+     * @param[out] decisions Array receiving the decisions.
+     * @param[in] max Size of the array.
+     * @param[in] caps Client capabilities of the STAs, targets on a band the STA does not support are left out, may be NULL.
+     * @param[in] unassoc Unassociated STA Link Metrics of the STAs, targets as good as those of the Beacon Reports, may be NULL.
+     *
+     * @returns Number of decisions stored, at most max_steers of them steers.
+     */
+    unsigned int evaluate(unsigned long long now, em_sta_metrics_table_t *table, em_metrics_history_t *sta_history,
+                          em_metrics_history_t *bss_history, em_beacon_report_cache_t *reports,
+                          em_steer_decision_t *decisions, unsigned int max, em_client_cap_cache_t *caps = NULL,
+                          em_beacon_report_cache_t *unassoc = NULL);
+
+    /**!
+     * @brief Starts the backoff of a STA once its BTM request was submitted.
+     *
+     * @param[in] sta MAC address of the STA.
+     * @param[in] now Current time in milliseconds.
+     */
+    void steered(const unsigned char *sta, unsigned long long now);
+
+    /**!
+     * @brief Returns true if the STA is in its backoff.
+     */
+    bool in_backoff(const unsigned char *sta, unsigned long long now);
+
+    /**!
+     * @brief Sets the parameters.
+     */
+    void set_params(const em_steer_engine_params_t *params) { m_params = *params; }
+
+    /**!
+     * @brief Returns the parameters.
+     */
+    const em_steer_engine_params_t& get_params() { return m_params; }
+
+    /**!
+     * @brief Returns the counters.
+     */
+    const em_steer_engine_stats_t& get_stats() { return m_stats; }
+
+    /**!
+     * @brief Constructor for em_steer_engine_t, with the default parameters.
+     */
+    em_steer_engine_t();
+
+    /**!
+     * @brief Destructor for em_steer_engine_t.
+     */
+    ~em_steer_engine_t();
+};
+
+#endif
@@ -0,0 +1,204 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_STEER_OUTCOME_H
+#define EM_STEER_OUTCOME_H
+
+#include <pthread.h>
+#include <cjson/cJSON.h>
+#include "em_base.h"
+#include "em_lat_hist.h"
+
+#include <unordered_map>
+#include <vector>
+
+#define EM_STEER_OUTCOME_MAX            256     // outstanding steers, the oldest is expired to make room
+#define EM_STEER_OUTCOME_TIMEOUT_MS     10000   // a steer without reassociation by then has failed
+
+/*
+ * A steered STA, from the Client Steering Request to its reassociation
+ */
+typedef struct {
+    mac_address_t       agent;          // AL MAC of the agent the request was sent to
+    mac_address_t       sta;
+    bssid_t             source;
+    bssid_t             target;         // the one the BTM Report names once it is received
+    unsigned short      msg_id;         // of the Client Steering Request
+    unsigned char       status;         // BTM status code, once report_ms is set
+    unsigned long long  req_ms;         // CLOCK_MONOTONIC milliseconds, 0 if not seen yet
+    unsigned long long  ack_ms;
+    unsigned long long  report_ms;
+    unsigned long long  reassoc_ms;
+} em_steer_outcome_entry_t;
+
+typedef struct {
+    unsigned int        requests;
+    unsigned int        acked;
+    unsigned int        reported;
+    unsigned int        succeeded;      // reassociated with the target
+    unsigned int        failed;         // BTM rejected or reassociated elsewhere
+    unsigned int        expired;        // no reassociation within EM_STEER_OUTCOME_TIMEOUT_MS
+    unsigned int        success_pct;    // of the closed steers
+    unsigned long long  p50_ms;         // request to reassociation of the succeeded steers
+    unsigned long long  p99_ms;
+} em_steer_outcome_stats_t;
+
+typedef struct {
+    unsigned int        requests;
+    unsigned int        acked;
+    unsigned int        reported;
+    unsigned int        succeeded;
+    unsigned int        failed;
+    unsigned int        expired;
+    em_lat_hist_t       steer_time;
+} em_steer_outcome_agent_t;
+
+/*
+ * Outstanding steers keyed by (STA MAC, message id of the Client Steering Request).
+ * The 1905 ACK is matched on the agent and message id, the BTM Report and the
+ * reassociation on the newest steer of the STA. A steer is closed once the STA
+ * reassociates, its BTM request is rejected or it expires, and its outcome is added
+ * to the counters and the steering time histogram of its agent. Thread safe.
+ */
+class em_steer_outcome_table_t {
+
+    pthread_mutex_t m_lock;
+    // STA MAC in the low 48 bits, message id in the high 16 bits
+    std::unordered_map<unsigned long long, em_steer_outcome_entry_t> m_entries;
+    // STA MAC to the message id of its newest steer
+    std::unordered_map<unsigned long long, unsigned short> m_latest;
+    // keyed by the agent AL MAC packed in an integer
+    std::unordered_map<unsigned long long, em_steer_outcome_agent_t> m_agents;
+
+    /**!
+     * @brief Returns a MAC address packed in an integer.
+     */
+    static unsigned long long mac_key(const unsigned char *mac);
+
+    /**!
+     * @brief Returns the newest steer of a STA, m_entries.end() if it has none. Called with m_lock held.
+     */
+    std::unordered_map<unsigned long long, em_steer_outcome_entry_t>::iterator find_latest(const unsigned char *sta);
+
+    /**!
+     * @brief Adds the outcome of a steer to its agent and removes it. Called with m_lock held.
+     *
+     * @param[in] it The steer.
+     * @param[in] success True if the STA reassociated with the target.
+     * @param[in] expired True if the steer timed out.
+     *
+     * @returns Iterator past the removed steer.
+     */
+    std::unordered_map<unsigned long long, em_steer_outcome_entry_t>::iterator close(
+        std::unordered_map<unsigned long long, em_steer_outcome_entry_t>::iterator it, bool success, bool expired);
+
+public:
+
+    /**!
+     * @brief Adds a steer once its Client Steering Request is sent.
+     *
+     * @param[in] agent AL MAC of the agent.
+     * @param[in] sta MAC address of the STA.
+     * @param[in] source BSSID the STA is steered from.
+     * @param[in] target BSSID the STA is steered to.
+     * @param[in] msg_id Message id of the request.
+     * @param[in] now Current time in milliseconds.
+     */
+    void add_request(const unsigned char *agent, const unsigned char *sta, const unsigned char *source,
+                     const unsigned char *target, unsigned short msg_id, unsigned long long now);
+
+    /**!
+     * @brief Records the 1905 ACK of a Client Steering Request.
+     *
+     * @param[in] agent AL MAC of the agent sending the ACK.
+     * @param[in] msg_id Message id of the ACK, the one of the request.
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns Number of steers acknowledged, one per STA of the request.
+     */
+    unsigned int ack(const unsigned char *agent, unsigned short msg_id, unsigned long long now);
+
+    /**!
+     * @brief Records the BTM Report of a STA, closing its steer as failed if the STA rejected it.
+     *
+     * @param[in] sta MAC address of the STA.
+     * @param[in] status BTM status code, 0 if accepted.
+     * @param[in] target BSSID the STA chose, ignored if all zero.
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns True if the STA has a steer outstanding, false otherwise.
+     */
+    bool report(const unsigned char *sta, unsigned char status, const unsigned char *target, unsigned long long now);
+
+    /**!
+     * @brief Records the association of a STA, closing its steer.
+     *
+     * @param[in] sta MAC address of the STA.
+     * @param[in] bssid BSSID the STA associated with.
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns True if the STA had a steer outstanding, false otherwise.
+     */
+    bool reassociated(const unsigned char *sta, const unsigned char *bssid, unsigned long long now);
+
+    /**!
+     * @brief Closes the steers older than EM_STEER_OUTCOME_TIMEOUT_MS as expired.
+     *
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns Number of steers expired.
+     */
+    unsigned int expire(unsigned long long now);
+
+    /**!
+     * @brief Returns the outcomes of the steers sent to an agent.
+     *
+     * @param[in] agent AL MAC of the agent.
+     * @param[out] stats The outcomes.
+     *
+     * @returns True if a steer was sent to the agent, false otherwise.
+     */
+    bool get_agent_stats(const unsigned char *agent, em_steer_outcome_stats_t *stats);
+
+    /**!
+     * @brief Adds an object with the outcomes of each agent to a JSON array.
+     *
+     * @param[in] arr JSON array to add the objects to.
+     */
+    void encode(cJSON *arr);
+
+    /**!
+     * @brief Returns the number of outstanding steers.
+     */
+    unsigned int count();
+
+    /**!
+     * @brief Constructor for em_steer_outcome_table_t.
+     */
+    em_steer_outcome_table_t();
+
+    /**!
+     * @brief Destructor for em_steer_outcome_table_t.
+     */
+    ~em_steer_outcome_table_t();
+
+    em_steer_outcome_table_t(const em_steer_outcome_table_t&) = delete;
+    em_steer_outcome_table_t& operator=(const em_steer_outcome_table_t&) = delete;
+};
+
+#endif
@@ -19,6 +19,8 @@
 #ifndef EM_STEERING_H
 #define EM_STEERING_H
 
+#include <atomic>
+#include <string>
 #include "em_base.h"
 
 class em_steering_t {
@@ -26,6 +28,10 @@ class em_steering_t {
     unsigned int m_client_steering_req_tx_cnt;
     unsigned int m_client_assoc_ctrl_req_tx_cnt;
 
+    pthread_mutex_t m_bh_steer_lock;
+    em_bh_steering_req_t m_bh_steer_req;        // set by the controller thread, see request_bh_steer()
+    std::atomic<bool> m_bh_steer_requested;
+
     
 	/**!
 	 * @brief Sends a client steering request message.
@@ -135,6 +141,21 @@ class em_steering_t {
 	 * @note Ensure that the buffer is properly allocated and the length is correctly specified.
 	 */
 	int handle_client_steering_report(unsigned char *buff, unsigned int len);
+
+	/**!
+	 * @brief Handles a Client Association Control Request on the agent.
+	 *
+	 * Blocks or unblocks the listed STAs from the BSS in the blocklist of the manager,
+	 * then acknowledges the request.
+	 *
+	 * @param[in] buff Pointer to the buffer containing the message.
+	 * @param[in] len Length of the message in the buffer.
+	 *
+	 * @returns int
+	 * @retval 0 on success
+	 * @retval -1 on failure
+	 */
+	int handle_client_assoc_ctrl_req(unsigned char *buff, unsigned int len);
     
 	/**!
 	 * @brief Handles the acknowledgment message.
@@ -197,6 +218,74 @@ class em_steering_t {
 	 */
 	short create_btm_request_tlv(unsigned char *buff);
 
+	/**!
+	 * @brief Creates a Steering Request TLV for all the STAs of a steer batch command.
+	 *
+	 * The TLV has the STA list of the batch and one Target BSSID per STA, in the same order.
+	 *
+	 * @param[out] buff Pointer to the buffer where the TLV value will be stored.
+	 * @param[in] params The batch.
+	 *
+	 * @returns The size of the TLV value.
+	 */
+	short create_btm_request_batch_tlv(unsigned char *buff, const em_cmd_steer_batch_params_t *params);
+
+	/**!
+	 * @brief Passes each STA of a Steering Request TLV to the bus as a single STA request.
+	 *
+	 * @param[in] steer_req The Steering Request TLV value.
+	 * @param[in] len Length of the TLV value.
+	 *
+	 * @returns Number of STAs passed on, -1 if the TLV is malformed.
+	 */
+	int split_client_steering_req(const unsigned char *steer_req, unsigned int len);
+
+	/**!
+	 * @brief Sends a Backhaul Steering Request to the agent.
+	 *
+	 * @param[in] req The bSTA to steer and its target BSS.
+	 *
+	 * @returns Length of the message sent, -1 on failure.
+	 */
+	int send_bh_steering_req_msg(const em_bh_steering_req_t *req);
+
+	/**!
+	 * @brief Sends a Backhaul Steering Response to the controller.
+	 *
+	 * @param[in] req The request answered.
+	 * @param[in] result 0 if the bSTA moved to the target BSS, 1 otherwise.
+	 *
+	 * @returns Length of the message sent, -1 on failure.
+	 */
+	int send_bh_steering_rsp_msg(const em_bh_steering_req_t *req, unsigned char result);
+
+	/**!
+	 * @brief Handles a Backhaul Steering Request on the agent.
+	 *
+	 * The bSTA is moved to the target BSS through OneWifi and put back on its current BSS
+	 * if that fails. Only the bSTA is reconfigured, the ems of the agent stay configured
+	 * and the devices behind it keep their ems on the controller.
+	 *
+	 * @param[in] buff The message.
+	 * @param[in] len Length of the message.
+	 *
+	 * @returns 0 on success, -1 on failure.
+	 */
+	int handle_bh_steering_req(unsigned char *buff, unsigned int len);
+
+	/**!
+	 * @brief Handles a Backhaul Steering Response on the controller.
+	 *
+	 * Completes the steer in em_bh_steer_t and asks for a Topology Query of the agent so
+	 * that its new parent is learned.
+	 *
+	 * @param[in] buff The message.
+	 * @param[in] len Length of the message.
+	 *
+	 * @returns 0 on success, -1 on failure.
+	 */
+	int handle_bh_steering_rsp(unsigned char *buff, unsigned int len);
+
 public:
 	
 	/**!
@@ -277,6 +366,17 @@ public:
 	 */
 	virtual em_cmd_t *get_current_cmd() = 0;
 
+	/**!
+	 * @brief Connects the backhaul STA of the agent to a BSS through OneWifi.
+	 *
+	 * @param[in] ssid SSID of the BSS.
+	 * @param[in] passphrase Passphrase of the BSS.
+	 * @param[in] bssid BSSID of the BSS.
+	 *
+	 * @returns True if OneWifi took the configuration.
+	 */
+	virtual bool bsta_connect_bss(const std::string& ssid, const std::string passphrase, bssid_t bssid) = 0;
+
 public:
 
     
@@ -324,6 +424,29 @@ public:
 	 */
 	void set_client_assoc_ctrl_req_tx_count(unsigned int cnt) { m_client_assoc_ctrl_req_tx_cnt = cnt; }
 
+	/**!
+	 * @brief Asks for a Backhaul Steering Request to the agent, sent from the next tick of the em.
+	 *
+	 * Called by the controller thread for the decisions of em_bh_steer_t, the caller wakes
+	 * the em. A request not sent yet is replaced.
+	 *
+	 * @param[in] bsta MAC of the backhaul STA.
+	 * @param[in] target BSSID of the new parent.
+	 * @param[in] op_class Operating class of the new parent.
+	 * @param[in] channel Channel of the new parent.
+	 */
+	void request_bh_steer(const mac_address_t bsta, const bssid_t target, unsigned char op_class, unsigned char channel);
+
+	/**!
+	 * @brief Returns true if request_bh_steer() was called since the last send.
+	 */
+	bool has_requested_bh_steer() { return m_bh_steer_requested.load(); }
+
+	/**!
+	 * @brief Sends the request asked by request_bh_steer(), on the thread of the em.
+	 */
+	void send_requested_bh_steer();
+
     
 	/**!
 	 * @brief Processes a message with the given data and length.
@@ -0,0 +1,158 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_TID_LINK_PLANNER_H
+#define EM_TID_LINK_PLANNER_H
+
+#include "em_base.h"
+#include "em_hex.h"
+#include "em_metrics_history.h"
+
+#include <unordered_map>
+
+#define EM_TID_LINK_PLANNER_MAX_LINKS       8       // link IDs of a one octet link mapping
+#define EM_TID_LINK_PLANNER_MAX_DECISIONS   16      // decisions returned by a pass
+
+typedef struct {
+    mac_address_t   sta;                // affiliated STA, its link metrics samples
+    bssid_t         bssid;              // affiliated AP, its utilization samples
+    unsigned char   link_id;            // of the affiliated AP, below EM_TID_LINK_PLANNER_MAX_LINKS
+} em_tid_link_t;
+
+typedef struct {
+    mac_address_t   ap_mld;
+    mac_address_t   sta_mld;
+    unsigned int    num_links;
+    em_tid_link_t   links[EM_TID_LINK_PLANNER_MAX_LINKS];
+} em_tid_link_mld_t;
+
+typedef struct {
+    mac_address_t   ap_mld;
+    mac_address_t   sta_mld;
+    unsigned char   link_map;           // bit n set if all TIDs may use link ID n
+    bool            default_map;        // all the links of the STA MLD, the default mapping
+} em_tid_link_decision_t;
+
+typedef struct {
+    bool            enabled;
+    unsigned char   rcpi_floor;         // a link whose RCPI EWMA is below carries no TID
+    unsigned char   rcpi_hysteresis;    // a link leaves below floor - hysteresis and joins above floor + hysteresis
+    unsigned int    util_ceiling;       // a link whose BSS utilization EWMA is above carries no TID, 0 to disable
+    unsigned int    util_hysteresis;
+    unsigned int    min_samples;        // links with fewer samples keep their mapping
+    unsigned int    hold_ms;            // a mapping is kept at least this long once pushed
+} em_tid_link_planner_params_t;
+
+typedef struct {
+    unsigned long long  passes;
+    unsigned long long  evaluated;      // STA MLDs with new samples
+    unsigned long long  skipped;        // STA MLDs without new samples, not evaluated
+    unsigned long long  held;           // changes deferred by hold_ms
+    unsigned long long  decisions;
+    unsigned long long  pushed;
+    unsigned int        last_mlds;      // STA MLDs given to the last pass
+} em_tid_link_planner_stats_t;
+
+typedef struct {
+    unsigned char       all_map;        // links of the STA MLD when it was last seen
+    unsigned char       link_map;       // mapping last pushed, the default one until then
+    unsigned long long  seen_ms;        // newest sample evaluated
+    unsigned long long  pushed_ms;
+    unsigned long long  pass;           // last pass that saw the STA MLD
+} em_tid_link_mld_state_t;
+
+/*
+ * Controller TID-to-link mapping of the associated STA MLDs, from the link metrics and
+ * BSS utilization history. A link carries the TIDs while its RCPI EWMA is above the floor
+ * and its BSS below the utilization ceiling, each with a hysteresis around the threshold
+ * so that a link on the edge does not flap. All the TIDs go to the same links, the best
+ * link is kept if none qualifies. A STA MLD is only evaluated when one of its links has a
+ * sample newer than its last evaluation, and a mapping is only returned when it differs
+ * from the one pushed, at most once per hold_ms. Not thread safe, run by the controller
+ * thread only.
+ */
+class em_tid_link_planner_t {
+
+    em_tid_link_planner_params_t m_params;
+    em_tid_link_planner_stats_t m_stats;
+    std::unordered_map<em_packed_mac_t, em_tid_link_mld_state_t> m_mlds;     // keyed by STA MLD MAC
+
+public:
+
+    /**!
+     * @brief Runs a pass over the STA MLDs.
+     *
+     * @param[in] now Current time in milliseconds.
+     * @param[in] mlds The associated STA MLDs and their links.
+     * @param[in] num Number of STA MLDs.
+     * @param[in] sta_history Link metrics samples of the affiliated STAs, for the RCPI EWMA.
+     * @param[in] bss_history Samples of the affiliated APs, for the utilization EWMA.
+     * @param[out] decisions Array receiving the mappings that differ from the pushed ones.
+     * @param[in] max Size of the array.
+     *
+     * @returns Number of decisions stored.
+     */
+    unsigned int evaluate(unsigned long long now, const em_tid_link_mld_t *mlds, unsigned int num,
+                          em_metrics_history_t *sta_history, em_metrics_history_t *bss_history,
+                          em_tid_link_decision_t *decisions, unsigned int max);
+
+    /**!
+     * @brief Records a mapping once it was queued to the agent, the STA MLD is held from now.
+     *
+     * @param[in] decision The decision returned by evaluate().
+     * @param[in] now Current time in milliseconds.
+     */
+    void pushed(const em_tid_link_decision_t *decision, unsigned long long now);
+
+    /**!
+     * @brief Returns the mapping last pushed for a STA MLD.
+     *
+     * @param[in] sta_mld MAC address of the STA MLD.
+     * @param[out] link_map Receives the link map.
+     *
+     * @returns True if the STA MLD is known, false otherwise.
+     */
+    bool get_link_map(const unsigned char *sta_mld, unsigned char *link_map);
+
+    /**!
+     * @brief Sets the parameters.
+     */
+    void set_params(const em_tid_link_planner_params_t *params) { m_params = *params; }
+
+    /**!
+     * @brief Returns the parameters.
+     */
+    const em_tid_link_planner_params_t& get_params() { return m_params; }
+
+    /**!
+     * @brief Returns the counters.
+     */
+    const em_tid_link_planner_stats_t& get_stats() { return m_stats; }
+
+    /**!
+     * @brief Constructor for em_tid_link_planner_t, with the default parameters.
+     */
+    em_tid_link_planner_t();
+
+    /**!
+     * @brief Destructor for em_tid_link_planner_t.
+     */
+    ~em_tid_link_planner_t();
+};
+
+#endif
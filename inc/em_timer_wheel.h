@@ -0,0 +1,161 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_TIMER_WHEEL_H
+#define EM_TIMER_WHEEL_H
+
+#include <stdint.h>
+
+#define EM_TIMER_TICK_MS        10
+#define EM_TIMER_WHEEL_BITS     6
+#define EM_TIMER_WHEEL_SLOTS    (1 << EM_TIMER_WHEEL_BITS)
+#define EM_TIMER_WHEEL_LEVELS   3
+
+typedef void (*em_timer_cb_t)(void *arg);
+
+/*
+ * Timer owned by the module that arms it, the wheel only links it into its slots.
+ */
+struct em_timer_t {
+    struct em_timer_t *next;
+    struct em_timer_t *prev;
+    uint64_t expires;           // absolute deadline in ticks
+    unsigned int period_ms;     // 0 for one shot timers
+    em_timer_cb_t cb;
+    void *arg;
+};
+
+/*
+ * Hierarchical timer wheel. Level 0 resolves EM_TIMER_TICK_MS, each further level is
+ * EM_TIMER_WHEEL_SLOTS times coarser and cascades its timers down as the wheel turns.
+ * Not thread safe, all calls must be made from the thread that runs the wheel.
+ */
+class em_timer_wheel_t {
+
+    em_timer_t m_slots[EM_TIMER_WHEEL_LEVELS][EM_TIMER_WHEEL_SLOTS];
+    uint64_t m_now;
+    unsigned int m_count;
+
+    /**!
+     * @brief Links a timer into the slot matching its deadline.
+     *
+     * @param[in] t Pointer to the timer, its expires field must be set.
+     */
+    void link(em_timer_t *t);
+
+    /**!
+     * @brief Moves all timers of a higher level slot down to the levels below.
+     *
+     * @param[in] level Level of the slot.
+     * @param[in] idx Index of the slot.
+     */
+    void cascade(unsigned int level, unsigned int idx);
+
+    /**!
+     * @brief Unlinks a timer from its list.
+     *
+     * @param[in] t Pointer to the timer.
+     */
+    static void unlink(em_timer_t *t);
+
+    /**!
+     * @brief Converts milliseconds to wheel ticks, rounding up.
+     */
+    static uint64_t ms_to_ticks(uint64_t ms) { return (ms + EM_TIMER_TICK_MS - 1) / EM_TIMER_TICK_MS; }
+
+public:
+
+    /**!
+     * @brief Arms a timer, re-arming it if it was already pending.
+     *
+     * @param[in] t Pointer to the timer, must stay valid until it fires or is cancelled.
+     * @param[in] now_ms Current time in milliseconds, see get_time_ms().
+     * @param[in] timeout_ms Time until the first expiry in milliseconds.
+     * @param[in] period_ms Interval of a periodic timer in milliseconds, 0 for a one shot timer.
+     * @param[in] cb Callback run from run() when the timer expires.
+     * @param[in] arg Argument passed to the callback.
+     */
+    void add(em_timer_t *t, uint64_t now_ms, unsigned int timeout_ms, unsigned int period_ms, em_timer_cb_t cb, void *arg);
+
+    /**!
+     * @brief Disarms a timer. Cancelling a timer that is not pending is a no-op.
+     *
+     * @param[in] t Pointer to the timer.
+     */
+    void cancel(em_timer_t *t);
+
+    /**!
+     * @brief Checks whether a timer is armed.
+     *
+     * @param[in] t Pointer to the timer.
+     *
+     * @returns True if the timer is pending, false otherwise.
+     */
+    static bool is_pending(em_timer_t *t) { return t->next != NULL; }
+
+    /**!
+     * @brief Turns the wheel up to now_ms and runs the callbacks of every expired timer.
+     *
+     * Callbacks may add or cancel any timer, including the one being run. Periodic
+     * timers that were not re-armed or cancelled by their callback are re-armed one
+     * period after their previous deadline.
+     *
+     * @param[in] now_ms Current time in milliseconds.
+     *
+     * @returns Number of callbacks run.
+     */
+    unsigned int run(uint64_t now_ms);
+
+    /**!
+     * @brief Returns the time until the nearest deadline.
+     *
+     * @param[in] now_ms Current time in milliseconds.
+     *
+     * @returns Milliseconds until the nearest deadline, 0 if a timer is already due, -1 if no timer is armed.
+     */
+    int next_timeout_ms(uint64_t now_ms);
+
+    /**!
+     * @brief Returns the number of armed timers.
+     */
+    unsigned int count() { return m_count; }
+
+    /**!
+     * @brief Returns the monotonic clock in milliseconds.
+     */
+    static uint64_t get_time_ms();
+
+    /**!
+     * @brief Initializes a timer so that it can be cancelled before it is ever armed.
+     *
+     * @param[in] t Pointer to the timer.
+     */
+    static void init_timer(em_timer_t *t);
+
+    /**!
+     * @brief Constructor for em_timer_wheel_t.
+     */
+    em_timer_wheel_t();
+
+    /**!
+     * @brief Destructor for em_timer_wheel_t.
+     */
+    ~em_timer_wheel_t();
+};
+
+#endif
@@ -0,0 +1,173 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_TLV_WRITER_H
+#define EM_TLV_WRITER_H
+
+#include <net/ethernet.h>
+#include "em_base.h"
+
+// largest 1905 frame on the wire, ethernet header included
+#define EM_MAX_FRAME_SZ             (sizeof(em_raw_hdr_t) + ETH_DATA_LEN)
+#define EM_TLV_WRITER_MAX_FRAGS     64
+// room reserved for a TLV whose length is only known once it has been written
+#define EM_TLV_WRITER_MAX_VALUE_LEN MAX_EM_BUFF_SZ
+
+/*
+ * Builds a CMDU into a buffer owned by the writer. The buffer grows on demand and is
+ * kept across messages, so a writer that is reused does not allocate once it is warm.
+ * TLVs that do not fit into the current frame start a new fragment, the fragments are
+ * laid out back to back in the buffer with their own 1905 header. Not thread safe.
+ */
+class em_tlv_writer_t {
+
+    unsigned char *m_buff;
+    unsigned int m_cap;
+    unsigned int m_len;
+    unsigned int m_frame_sz;
+    unsigned int m_frag_off[EM_TLV_WRITER_MAX_FRAGS];
+    unsigned int m_num_frags;
+    unsigned int m_tlv_off;         // offset of the open TLV
+    unsigned int m_tlv_max;         // value length reserved for the open TLV
+    bool m_tlv_open;
+    bool m_error;
+
+    /**!
+     * @brief Makes sure that len more bytes fit into the buffer, growing it if needed.
+     *
+     * @param[in] len Number of bytes needed past the current length.
+     *
+     * @returns 0 on success, -1 if the buffer could not grow.
+     */
+    int reserve(unsigned int len);
+
+    /**!
+     * @brief Returns the number of bytes used by the current fragment.
+     */
+    unsigned int get_frame_len() { return m_len - m_frag_off[m_num_frags - 1]; }
+
+    /**!
+     * @brief Starts a new fragment in front of the TLV at tlv_off, moving the TLV behind its header.
+     *
+     * @param[in] tlv_off Offset of the TLV that did not fit the current fragment.
+     *
+     * @returns 0 on success, -1 if there are too many fragments.
+     */
+    int new_fragment(unsigned int tlv_off);
+
+public:
+
+    /**!
+     * @brief Starts a new CMDU, dropping whatever was built before.
+     *
+     * @param[in] dst Destination MAC address.
+     * @param[in] src Source MAC address.
+     * @param[in] type Type of the message.
+     * @param[in] msg_id Message ID.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    int begin(mac_addr_t dst, mac_addr_t src, em_msg_type_t type, unsigned short msg_id);
+
+    /**!
+     * @brief Opens a TLV whose value is written in place and whose length is set by close_tlv().
+     *
+     * @param[in] type Type of the TLV.
+     * @param[in] max_len Largest value length the caller may write.
+     *
+     * @returns Pointer to the value, valid until the next call on the writer, NULL on failure.
+     */
+    unsigned char *open_tlv(em_tlv_type_t type, unsigned int max_len = EM_TLV_WRITER_MAX_VALUE_LEN);
+
+    /**!
+     * @brief Closes the open TLV, back-patching its length and moving it to a new fragment if needed.
+     *
+     * @param[in] len Length of the value that was written, at most the max_len given to open_tlv().
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    int close_tlv(unsigned int len);
+
+    /**!
+     * @brief Appends a TLV with a ready made value.
+     *
+     * @param[in] type Type of the TLV.
+     * @param[in] value Value of the TLV, may be NULL if len is 0.
+     * @param[in] len Length of the value.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    int add_tlv(em_tlv_type_t type, const unsigned char *value, unsigned int len);
+
+    /**!
+     * @brief Appends the end of message TLV and sets the fragment ids and the last fragment flag.
+     *
+     * @returns Number of frames of the message, -1 if any step of the build failed.
+     */
+    int finish();
+
+    /**!
+     * @brief Returns the number of frames built so far.
+     */
+    unsigned int get_frame_count() { return m_num_frags; }
+
+    /**!
+     * @brief Returns one frame of the message.
+     *
+     * @param[in] idx Index of the frame, below get_frame_count().
+     * @param[out] len Length of the frame.
+     *
+     * @returns Pointer to the frame, valid until the next call that modifies the writer.
+     */
+    unsigned char *get_frame(unsigned int idx, unsigned int *len);
+
+    /**!
+     * @brief Fills arrays of frame pointers and lengths, e.g. for em_t::send_frames().
+     *
+     * @param[out] buffs Array receiving the frame pointers.
+     * @param[out] lens Array receiving the frame lengths.
+     * @param[in] max Size of the arrays.
+     *
+     * @returns Number of entries filled.
+     */
+    unsigned int get_frames(unsigned char **buffs, unsigned int *lens, unsigned int max);
+
+    /**!
+     * @brief Checks whether any step of the build failed since begin().
+     */
+    bool has_error() { return m_error; }
+
+    /**!
+     * @brief Overrides the largest frame size, mainly for tests.
+     *
+     * @param[in] sz Frame size in bytes, ethernet header included.
+     */
+    void set_frame_size(unsigned int sz) { m_frame_sz = sz; }
+
+    /**!
+     * @brief Constructor for em_tlv_writer_t.
+     */
+    em_tlv_writer_t();
+
+    /**!
+     * @brief Destructor for em_tlv_writer_t.
+     */
+    ~em_tlv_writer_t();
+};
+
+#endif
@@ -0,0 +1,163 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_TOPO_PUBLISHER_H
+#define EM_TOPO_PUBLISHER_H
+
+#include <string>
+#include <cjson/cJSON.h>
+
+#define EM_TOPO_SNAPSHOT_PATCHES        32          // patches published between two snapshots
+#define EM_TOPO_SNAPSHOT_INTERVAL_MS    60000       // snapshot interval while nothing changes
+
+#define EM_TOPO_MSG_TYPE            "Type"
+#define EM_TOPO_MSG_SEQ             "Seq"
+#define EM_TOPO_MSG_BASE_SEQ        "BaseSeq"
+#define EM_TOPO_MSG_TOPOLOGY        "Topology"
+#define EM_TOPO_MSG_PATCH           "Patch"
+#define EM_TOPO_MSG_TYPE_SNAPSHOT   "Snapshot"
+
+typedef enum {
+    em_topo_msg_type_none,
+    em_topo_msg_type_snapshot,
+    em_topo_msg_type_patch,
+} em_topo_msg_type_t;
+
+typedef struct {
+    unsigned long long  snapshots;
+    unsigned long long  patches;
+    unsigned long long  unchanged;          // updates equal to the document last published
+    unsigned long long  snapshot_bytes;
+    unsigned long long  patch_bytes;
+} em_topo_publisher_stats_t;
+
+/*
+ * Builds the messages of the network topology event. Every message is compact JSON with a
+ * sequence number. A snapshot carries the whole document:
+ *
+ *     {"Type":"Snapshot","Seq":7,"Topology":{...}}
+ *
+ * a patch carries the RFC 6902 operations that turn the document of BaseSeq into this one:
+ *
+ *     {"Type":"Patch","Seq":8,"BaseSeq":7,"Patch":[{"op":"replace","path":"/...","value":...}]}
+ *
+ * A subscriber that misses a sequence number waits for the next snapshot. Snapshots are sent
+ * first, every EM_TOPO_SNAPSHOT_PATCHES patches, when a patch would not be smaller than the
+ * last snapshot and every EM_TOPO_SNAPSHOT_INTERVAL_MS for late subscribers. Not thread safe,
+ * used by the controller thread only.
+ */
+class em_topo_publisher_t {
+
+    cJSON               *m_base;            // document last published
+    unsigned int        m_seq;
+    unsigned int        m_num_patches;      // patches since the last snapshot
+    unsigned long long  m_snapshot_ms;      // time of the last snapshot
+    size_t              m_snapshot_len;     // size of the last snapshot
+    em_topo_publisher_stats_t   m_stats;
+
+    /**!
+     * @brief Appends the operations that turn one value into another.
+     *
+     * @param[in] from Value of the base document.
+     * @param[in] to Value of the new document.
+     * @param[in] path JSON pointer of the value.
+     * @param[out] patch Array of operations.
+     */
+    static void diff(const cJSON *from, const cJSON *to, const std::string& path, cJSON *patch);
+
+    /**!
+     * @brief Appends an operation to a patch.
+     *
+     * @param[out] patch Array of operations.
+     * @param[in] op Operation, add, remove or replace.
+     * @param[in] path JSON pointer of the value.
+     * @param[in] value Value of the operation, NULL for remove.
+     */
+    static void add_op(cJSON *patch, const char *op, const std::string& path, const cJSON *value);
+
+    /**!
+     * @brief Serializes the base document as a snapshot.
+     *
+     * @param[in] now_ms Current time in ms.
+     * @param[out] msg Message.
+     */
+    void get_snapshot(unsigned long long now_ms, std::string& msg);
+
+public:
+
+    /**!
+     * @brief Builds the message publishing a new topology document.
+     *
+     * @param[in] doc New document, owned by the publisher from then on.
+     * @param[in] now_ms Current time in ms.
+     * @param[out] msg Message to publish, cleared if there is nothing to publish.
+     *
+     * @returns Type of the message, em_topo_msg_type_none if the document is unchanged.
+     */
+    em_topo_msg_type_t update(cJSON *doc, unsigned long long now_ms, std::string& msg);
+
+    /**!
+     * @brief Builds the periodic snapshot of the document last published.
+     *
+     * @param[in] now_ms Current time in ms.
+     * @param[out] msg Message to publish, cleared if there is nothing to publish.
+     *
+     * @returns em_topo_msg_type_snapshot if the interval elapsed, em_topo_msg_type_none otherwise.
+     */
+    em_topo_msg_type_t get_periodic(unsigned long long now_ms, std::string& msg);
+
+    /**!
+     * @brief Returns the pointer of a member of an object, ~ and / escaped as in RFC 6901.
+     *
+     * @param[in] path JSON pointer of the object.
+     * @param[in] key Name of the member.
+     */
+    static std::string get_pointer(const std::string& path, const char *key);
+
+    /**!
+     * @brief Returns the sequence number of the message last built, 0 before the first one.
+     */
+    unsigned int get_seq() { return m_seq; }
+
+    /**!
+     * @brief Returns the message counters.
+     *
+     * @param[out] stats Pointer to the counters.
+     */
+    void get_stats(em_topo_publisher_stats_t *stats) { *stats = m_stats; }
+
+    /**!
+     * @brief Drops the document last published, the next update is a snapshot.
+     */
+    void reset();
+
+    /**!
+     * @brief Constructor for em_topo_publisher_t, nothing is published yet.
+     */
+    em_topo_publisher_t();
+
+    /**!
+     * @brief Destructor for em_topo_publisher_t.
+     */
+    ~em_topo_publisher_t();
+
+    em_topo_publisher_t(const em_topo_publisher_t&) = delete;
+    em_topo_publisher_t& operator=(const em_topo_publisher_t&) = delete;
+};
+
+#endif
@@ -0,0 +1,182 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_TOPO_SCHED_H
+#define EM_TOPO_SCHED_H
+
+#include <pthread.h>
+#include "em_base.h"
+
+#include <unordered_map>
+
+#define EM_TOPO_SCHED_MIN_PERIOD_MS     60000   // period of an agent whose topology just changed
+#define EM_TOPO_SCHED_MAX_PERIOD_MS     960000  // period of an agent stable for a while
+#define EM_TOPO_SCHED_JITTER_PCT        20      // a period is drawn within this many percent of its value
+#define EM_TOPO_SCHED_TIMEOUT_MS        5000    // a query without response by then is lost
+#define EM_TOPO_SCHED_RETRY_MS          2000    // wait before a query that could not be sent is due again
+#define EM_TOPO_SCHED_MAX_PER_TICK      8       // queries handed out by one get_due()
+
+typedef struct {
+    unsigned long long  due_ms;         // CLOCK_MONOTONIC milliseconds
+    unsigned long long  sent_ms;        // of the outstanding query
+    unsigned int        period_ms;      // doubled by every unchanged response
+    unsigned int        min_period_ms;  // the period is brought back to this, see set_min_period()
+    bool                outstanding;    // handed out by get_due(), not answered yet
+    bool                notified;       // a Topology Notification came while a query was outstanding
+} em_topo_sched_agent_t;
+
+typedef struct {
+    unsigned int        queried;        // queries handed out, deferred ones included
+    unsigned int        changed;        // responses that changed the topology
+    unsigned int        unchanged;
+    unsigned int        notified;       // Topology Notifications that made a query due
+    unsigned int        lost;           // no response within EM_TOPO_SCHED_TIMEOUT_MS
+    unsigned int        deferred;       // handed out but not sent
+} em_topo_sched_stats_t;
+
+/*
+ * When the controller queries the topology of each onboarded agent. The period of an agent
+ * starts at its minimum, EM_TOPO_SCHED_MIN_PERIOD_MS unless set_min_period(), and doubles with every response that changes nothing,
+ * up to EM_TOPO_SCHED_MAX_PERIOD_MS, a response that changes something or a Topology
+ * Notification brings it back down, the notification also makes the query due right away.
+ * Every period is drawn with jitter keyed by the agent, so agents onboarded together drift
+ * apart instead of being queried, and answering, in the same tick. Thread safe.
+ */
+class em_topo_sched_t {
+
+    pthread_mutex_t m_lock;
+    // AL MAC of the agent in the low 48 bits
+    std::unordered_map<unsigned long long, em_topo_sched_agent_t> m_agents;
+    em_topo_sched_stats_t m_stats;
+    unsigned long long m_seed;
+
+    /**!
+     * @brief Returns the key of an agent.
+     */
+    static unsigned long long agent_key(const unsigned char *agent);
+
+    /**!
+     * @brief Returns a period with its jitter, drawn from the agent and the time.
+     */
+    unsigned long long jitter(unsigned long long key, unsigned int period_ms, unsigned long long now);
+
+public:
+
+    /**!
+     * @brief Starts the queries of an agent, the first one is due within a jittered minimum period.
+     *
+     * @param[in] agent AL MAC of the agent.
+     * @param[in] now Current time in milliseconds.
+     *
+     * Adding an agent already known leaves it as it is.
+     */
+    void add(const unsigned char *agent, unsigned long long now);
+
+    /**!
+     * @brief Stops the queries of an agent.
+     *
+     * @param[in] agent AL MAC of the agent.
+     */
+    void remove(const unsigned char *agent);
+
+    /**!
+     * @brief Sets the shortest period of an agent, longer for the agents behind a long backhaul path.
+     *
+     * @param[in] agent AL MAC of the agent.
+     * @param[in] period_ms The period, clamped to EM_TOPO_SCHED_MIN_PERIOD_MS..EM_TOPO_SCHED_MAX_PERIOD_MS.
+     *
+     * @returns True if the agent is known.
+     */
+    bool set_min_period(const unsigned char *agent, unsigned int period_ms);
+
+    /**!
+     * @brief Records a Topology Notification of an agent, its query is due now.
+     *
+     * @param[in] agent AL MAC of the agent.
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns True if the agent is known.
+     */
+    bool notified(const unsigned char *agent, unsigned long long now);
+
+    /**!
+     * @brief Records the Topology Response of an agent and sets the time of its next query.
+     *
+     * @param[in] agent AL MAC of the agent.
+     * @param[in] changed True if the response changed the topology.
+     * @param[in] now Current time in milliseconds.
+     *
+     * @returns True if it answers a query handed out by get_due().
+     */
+    bool answered(const unsigned char *agent, bool changed, unsigned long long now);
+
+    /**!
+     * @brief Puts back a query handed out by get_due() that could not be sent.
+     *
+     * @param[in] agent AL MAC of the agent.
+     * @param[in] now Current time in milliseconds.
+     */
+    void defer(const unsigned char *agent, unsigned long long now);
+
+    /**!
+     * @brief Hands out the agents whose query is due, the most overdue first.
+     *
+     * The queries are outstanding until answered(), defer() or EM_TOPO_SCHED_TIMEOUT_MS.
+     *
+     * @param[in] now Current time in milliseconds.
+     * @param[out] agents Receives the AL MACs.
+     * @param[in] max Size of agents.
+     *
+     * @returns Number of agents written.
+     */
+    unsigned int get_due(unsigned long long now, mac_address_t *agents, unsigned int max);
+
+    /**!
+     * @brief Returns the next query time and period of an agent.
+     *
+     * @returns True if the agent is known.
+     */
+    bool get_agent(const unsigned char *agent, em_topo_sched_agent_t *info);
+
+    /**!
+     * @brief Returns the number of agents.
+     */
+    unsigned int count();
+
+    /**!
+     * @brief Returns the counters.
+     */
+    em_topo_sched_stats_t get_stats();
+
+    /**!
+     * @brief Constructor for em_topo_sched_t.
+     *
+     * @param[in] seed Seed of the jitter, 0 to use the clock.
+     */
+    em_topo_sched_t(unsigned long long seed = 0);
+
+    /**!
+     * @brief Destructor for em_topo_sched_t.
+     */
+    ~em_topo_sched_t();
+
+    em_topo_sched_t(const em_topo_sched_t&) = delete;
+    em_topo_sched_t& operator=(const em_topo_sched_t&) = delete;
+};
+
+#endif
@@ -0,0 +1,180 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_TRACE_H
+#define EM_TRACE_H
+
+#include <stdio.h>
+#include <time.h>
+#include <atomic>
+#include "util.h"
+
+#ifndef EM_TRACE_COMPILED
+#define EM_TRACE_COMPILED       1       // 0 compiles every em_trace() out
+#endif
+
+#define EM_TRACE_RING_SZ        1024    // records per thread, a power of two
+#define EM_TRACE_MAX_THREADS    64
+#define EM_TRACE_MAX_ARGS       4
+#define EM_TRACE_MAGIC          0x454d5452  // "EMTR"
+#define EM_TRACE_VERSION        1
+
+typedef enum {
+    em_trace_event_none,
+    em_trace_event_orch_submit,         // commands submitted, commands pending
+    em_trace_event_orch_exec,           // command type, em state
+    em_trace_event_orch_skip,           // command type, em state
+    em_trace_event_orch_fini,           // command type, em state
+    em_trace_event_orch_transient,      // command type, em state, seconds in transient
+    em_trace_event_ctrl_state,          // command type, em state
+    em_trace_event_max
+} em_trace_event_t;
+
+typedef struct {
+    unsigned long long  ts_ns;          // CLOCK_MONOTONIC
+    unsigned short      module;         // easymesh_dbg_type_t
+    unsigned short      event;          // em_trace_event_t
+    unsigned int        args[EM_TRACE_MAX_ARGS];
+} em_trace_rec_t;
+
+typedef struct {
+    std::atomic<unsigned long long> head;   // records written, only the owning thread writes
+    std::atomic<int>    tid;                // thread recording, or that recorded last
+    std::atomic<bool>   in_use;             // false once the thread exited
+    em_trace_rec_t      recs[EM_TRACE_RING_SZ];
+} em_trace_ring_t;
+
+// layout of a dump, the file header then a ring header and EM_TRACE_RING_SZ records per ring
+typedef struct {
+    unsigned int        magic;
+    unsigned int        version;
+    unsigned int        num_rings;
+    unsigned int        ring_sz;
+} em_trace_file_hdr_t;
+
+typedef struct {
+    int                 tid;
+    unsigned int        reserved;
+    unsigned long long  head;
+} em_trace_ring_hdr_t;
+
+/*
+ * Binary trace kept on in production. em_trace() stores a timestamp, the module, an
+ * event id and a few integers in a ring of the calling thread, without a lock, a system
+ * call or any formatting. The rings are written out with dump(), also from a fatal
+ * signal, and turned into text afterwards with decode().
+ */
+class em_trace_t {
+
+    static em_trace_ring_t *s_rings[EM_TRACE_MAX_THREADS];
+    static std::atomic<unsigned int> s_num_rings;
+    static std::atomic<bool> s_enabled;
+    static char s_crash_path[256];
+
+    static em_trace_ring_t *get_ring();
+    static void crash_handler(int sig);
+
+public:
+
+    /**!
+     * @brief Records an event in the ring of the calling thread.
+     *
+     * @param[in] module Module of the event.
+     * @param[in] event Event id.
+     * @param[in] a0 First argument of the event.
+     * @param[in] a1 Second argument of the event.
+     * @param[in] a2 Third argument of the event.
+     * @param[in] a3 Fourth argument of the event.
+     */
+    static inline void record(easymesh_dbg_type_t module, em_trace_event_t event, unsigned int a0 = 0,
+                              unsigned int a1 = 0, unsigned int a2 = 0, unsigned int a3 = 0)
+    {
+        static thread_local em_trace_ring_t *t_ring = NULL;
+        em_trace_rec_t *rec;
+        struct timespec ts;
+        unsigned long long head;
+
+        if (s_enabled.load(std::memory_order_relaxed) == false) {
+            return;
+        }
+        if ((t_ring == NULL) && ((t_ring = get_ring()) == NULL)) {
+            return;
+        }
+
+        head = t_ring->head.load(std::memory_order_relaxed);
+        rec = &t_ring->recs[head & (EM_TRACE_RING_SZ - 1)];
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        rec->ts_ns = static_cast<unsigned long long>(ts.tv_sec) * 1000000000ULL + static_cast<unsigned long long>(ts.tv_nsec);
+        rec->module = static_cast<unsigned short>(module);
+        rec->event = static_cast<unsigned short>(event);
+        rec->args[0] = a0;
+        rec->args[1] = a1;
+        rec->args[2] = a2;
+        rec->args[3] = a3;
+        t_ring->head.store(head + 1, std::memory_order_release);
+    }
+
+    /**!
+     * @brief Turns the recording on or off, it is on by default.
+     */
+    static void enable(bool enable) { s_enabled = enable; }
+
+    /**!
+     * @brief Writes the rings of all threads to a file descriptor, async signal safe.
+     *
+     * @returns 0 on success, -1 on a write error.
+     */
+    static int dump(int fd);
+
+    /**!
+     * @brief Writes the rings of all threads to a file.
+     *
+     * @returns 0 on success, -1 on failure.
+     */
+    static int dump(const char *path);
+
+    /**!
+     * @brief Prints a dump as text, the records of all threads merged by time.
+     *
+     * @param[in] path The dump.
+     * @param[in] out Where to print.
+     *
+     * @returns Number of records printed, -1 if the file is not a dump.
+     */
+    static int decode(const char *path, FILE *out);
+
+    /**!
+     * @brief Dumps the rings to a file on SIGSEGV, SIGBUS, SIGFPE, SIGILL and SIGABRT, then lets the signal kill the process.
+     */
+    static void install_crash_handler(const char *path);
+
+    /**!
+     * @brief Returns the name of an event.
+     */
+    static const char *get_event_str(unsigned int event);
+};
+
+#if EM_TRACE_COMPILED
+#define em_trace(module, event, ...) \
+    (std::integral_constant<bool, em_log_compiled(EM_LOG_LVL_ERROR, module)>::value ? \
+        em_trace_t::record(module, event, ##__VA_ARGS__) : (void)0)
+#else
+#define em_trace(module, event, ...) ((void)0)
+#endif
+
+#endif
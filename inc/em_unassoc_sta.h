@@ -0,0 +1,111 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_UNASSOC_STA_H
+#define EM_UNASSOC_STA_H
+
+#include "em_base.h"
+
+#define EM_UNASSOC_STA_QUERY_MAX_PENDING    64      // STAs waiting for a query per em, further requests are refused
+#define EM_UNASSOC_STA_QUERY_TIMEOUT_MS     10000   // a STA queried without a response can be queried again after this
+
+/*
+ * A STA an agent is asked to measure, on a channel of an op class
+ */
+typedef struct {
+    mac_address_t   sta;
+    unsigned char   op_class;
+    unsigned char   channel;
+} em_unassoc_sta_target_t;
+
+/*
+ * A STA as measured by an agent
+ */
+typedef struct {
+    mac_address_t   sta;
+    unsigned char   channel;
+    unsigned int    time_delta_ms;      // age of the measurement when the response was sent
+    unsigned char   rcpi;
+} em_unassoc_sta_meas_t;
+
+/*
+ * Codec of the Unassociated STA Link Metrics Query TLV (see section 17.2.25) and
+ * Response TLV (see section 17.2.26). A query names a single op class and lists the
+ * STAs per channel, so the controller asks an agent for all its targets of an op class
+ * in one query instead of one per STA. Values are the TLV bodies, without the header.
+ */
+class em_unassoc_sta_tlv_t {
+
+public:
+
+    /**!
+     * @brief Encodes a query TLV.
+     *
+     * @param[in] op_class The op class, the targets of other op classes are left out.
+     * @param[in] targets The targets, in any order, they are grouped by channel.
+     * @param[in] num Number of targets.
+     * @param[out] buff Buffer receiving the TLV value.
+     * @param[in] max Size of the buffer.
+     *
+     * @returns Length of the value, 0 if no target is on op_class or the value does not fit.
+     */
+    static unsigned int encode_query(unsigned char op_class, const em_unassoc_sta_target_t *targets, unsigned int num,
+                                     unsigned char *buff, unsigned int max);
+
+    /**!
+     * @brief Decodes a query TLV.
+     *
+     * @param[in] buff The TLV value.
+     * @param[in] len Length of the value.
+     * @param[out] targets Array receiving the targets, with the op class of the query.
+     * @param[in] max Size of the array, the targets beyond it are dropped.
+     *
+     * @returns Number of targets stored, -1 if the value is truncated.
+     */
+    static int decode_query(const unsigned char *buff, unsigned int len, em_unassoc_sta_target_t *targets, unsigned int max);
+
+    /**!
+     * @brief Encodes a response TLV.
+     *
+     * @param[in] op_class The op class of the query.
+     * @param[in] meas The measurements.
+     * @param[in] num Number of measurements.
+     * @param[out] buff Buffer receiving the TLV value.
+     * @param[in] max Size of the buffer.
+     *
+     * @returns Length of the value, 0 if it does not fit.
+     */
+    static unsigned int encode_response(unsigned char op_class, const em_unassoc_sta_meas_t *meas, unsigned int num,
+                                        unsigned char *buff, unsigned int max);
+
+    /**!
+     * @brief Decodes a response TLV.
+     *
+     * @param[in] buff The TLV value.
+     * @param[in] len Length of the value.
+     * @param[out] op_class Receives the op class of the response.
+     * @param[out] meas Array receiving the measurements.
+     * @param[in] max Size of the array, the measurements beyond it are dropped.
+     *
+     * @returns Number of measurements stored, -1 if the value is truncated.
+     */
+    static int decode_response(const unsigned char *buff, unsigned int len, unsigned char *op_class,
+                               em_unassoc_sta_meas_t *meas, unsigned int max);
+};
+
+#endif
@@ -0,0 +1,205 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef EM_WORKER_POOL_H
+#define EM_WORKER_POOL_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <atomic>
+#include "em_mpsc_queue.h"
+
+#define EM_WORKER_MAX_WORKERS   16
+#define EM_WORKER_MAX_NODES     1024    // slots of the pool, also the size of each ready queue
+#define EM_WORKER_BATCH_SZ      16      // events of one node run before the next ready node gets its turn
+#define EM_WORKER_NONE          (~0u)
+
+// runs up to budget queued events of a node, returns true if more are left
+typedef bool (*em_worker_run_cb_t)(void *ctx, unsigned int budget);
+// periodic work of a node, run from its home worker
+typedef void (*em_worker_tick_cb_t)(void *ctx);
+
+class em_worker_pool_t;
+
+struct em_worker_slot_t {
+    void *ctx;                          // NULL while the slot is free
+    std::atomic<unsigned int> worker;   // home worker, EM_WORKER_NONE while the slot is free
+    std::atomic<bool> scheduled;        // queued on the ready queue of the home worker
+    std::atomic<bool> parked;           // idle, skipped by the ticks until unparked or scheduled
+    struct em_worker_slot_t *next;      // in the list of the home worker, or the free list
+};
+
+struct em_worker_t {
+    em_worker_pool_t *pool;
+    unsigned int idx;
+    pthread_t tid;
+    pthread_mutex_t lock;               // held while a node of this worker runs, recursive
+    em_mpsc_queue_t ready;              // slots with queued events
+    em_worker_slot_t *homed;
+    unsigned int num_homed;
+};
+
+/*
+ * Fixed set of worker threads the nodes are sharded onto. A node is homed on one
+ * worker for its whole life, so its events keep their order and its handlers never
+ * run concurrently. Slots are never freed while the pool runs, stale ready entries
+ * of a detached slot are recognized by their home worker and skipped.
+ */
+class em_worker_pool_t {
+
+    em_worker_t *m_workers;
+    unsigned int m_num;
+    pthread_mutex_t m_lock;             // protects the free slot list and the homing decision
+    em_worker_slot_t *m_slots;
+    em_worker_slot_t *m_free;
+    em_worker_run_cb_t m_run;
+    em_worker_tick_cb_t m_tick;
+    unsigned int m_tick_ms;
+    std::atomic<bool> m_exit;
+
+    /**!
+     * @brief Runs one ready slot on its home worker.
+     *
+     * @param[in] w Pointer to the worker.
+     * @param[in] slot Pointer to the slot popped from the ready queue.
+     */
+    void run_slot(em_worker_t *w, em_worker_slot_t *slot);
+
+    /**!
+     * @brief Runs the periodic work of every node homed on a worker.
+     *
+     * @param[in] w Pointer to the worker.
+     */
+    void tick(em_worker_t *w);
+
+    /**!
+     * @brief Main loop of a worker thread.
+     *
+     * @param[in] w Pointer to the worker.
+     */
+    void run(em_worker_t *w);
+
+    /**!
+     * @brief Entry point of the worker threads.
+     *
+     * @param[in] arg Pointer to the em_worker_t.
+     */
+    static void *worker_func(void *arg);
+
+    /**!
+     * @brief Returns the monotonic clock in milliseconds.
+     */
+    static uint64_t get_time_ms();
+
+public:
+
+    /**!
+     * @brief Starts the workers, each pinned to one CPU.
+     *
+     * @param[in] num Number of workers, 0 for one per online CPU, at most EM_WORKER_MAX_WORKERS.
+     * @param[in] run Callback running the queued events of a node.
+     * @param[in] tick Callback running the periodic work of a node, may be NULL.
+     * @param[in] tick_ms Period of the tick callback in milliseconds.
+     *
+     * @returns int
+     * @retval 0 on success
+     * @retval -1 on failure, no worker is left running
+     */
+    int init(unsigned int num, em_worker_run_cb_t run, em_worker_tick_cb_t tick, unsigned int tick_ms);
+
+    /**!
+     * @brief Stops and joins the workers.
+     *
+     * @note All nodes must have been detached before calling this function.
+     */
+    void deinit();
+
+    /**!
+     * @brief Homes a node on the worker with the fewest nodes.
+     *
+     * @param[in] ctx Node passed to the callbacks, must not be NULL.
+     *
+     * @returns Pointer to the slot of the node, NULL if the pool is not running or full.
+     */
+    em_worker_slot_t *attach(void *ctx);
+
+    /**!
+     * @brief Removes a node from its worker, waiting for a callback of the node that is running.
+     *
+     * @param[in] slot Pointer to the slot returned by attach().
+     *
+     * @note The callbacks are not run for the node once this function returns.
+     */
+    void detach(em_worker_slot_t *slot);
+
+    /**!
+     * @brief Makes the home worker of a node run it, called after the node queued an event.
+     *
+     * @param[in] slot Pointer to the slot of the node.
+     */
+    void schedule(em_worker_slot_t *slot);
+
+    /**!
+     * @brief Stops running the periodic work of an idle node.
+     *
+     * @param[in] slot Pointer to the slot of the node.
+     *
+     * @note The node is ticked again once unpark() or schedule() is called for it. A node
+     * parks itself from its tick and then checks again that it is idle, unparking if not,
+     * so that a wake up racing with the decision is never lost.
+     */
+    void park(em_worker_slot_t *slot) { slot->parked = true; }
+
+    /**!
+     * @brief Makes the next ticks run the periodic work of a node again.
+     *
+     * @param[in] slot Pointer to the slot of the node.
+     */
+    void unpark(em_worker_slot_t *slot) { slot->parked = false; }
+
+    /**!
+     * @brief Returns the number of parked nodes homed on a worker.
+     *
+     * @param[in] idx Index of the worker, below get_num_workers().
+     */
+    unsigned int get_num_parked(unsigned int idx);
+
+    /**!
+     * @brief Returns the number of running workers, 0 if the pool is not started.
+     */
+    unsigned int get_num_workers() { return m_num; }
+
+    /**!
+     * @brief Returns the number of nodes homed on a worker.
+     *
+     * @param[in] idx Index of the worker, below get_num_workers().
+     */
+    unsigned int get_num_homed(unsigned int idx) { return m_workers[idx].num_homed; }
+
+    /**!
+     * @brief Constructor for em_worker_pool_t.
+     */
+    em_worker_pool_t();
+
+    /**!
+     * @brief Destructor for em_worker_pool_t.
+     */
+    ~em_worker_pool_t();
+};
+
+#endif
@@ -8,6 +8,79 @@
 #include <chrono>
 #include <atomic>
 #include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <map>
+#include <set>
+#include <cstdint>
+
+/**
+ * @brief Process wide timer thread behind every ThreadedTimer.
+ *
+ * Timers are kept ordered by deadline and their callbacks run one at a time on a single
+ * thread, started with the first timer. Callbacks should return quickly, a long one
+ * delays every other timer.
+ */
+class TimerService {
+public:
+    using handle_t = uint64_t;
+
+    /**
+     * @brief Returns the timer service, starting its thread on first use
+     */
+    static TimerService& instance();
+
+    /**
+     * @brief Schedules `callback` after `delay`, then every `interval` while it returns true
+     *
+     * @param delay The delay for the first call
+     * @param interval The periodicity of the following calls, 0 for a one shot timer
+     * @param callback The callback, called on the timer thread
+     * @return handle_t Handle to cancel the timer with, never 0
+     */
+    handle_t schedule(std::chrono::milliseconds delay, std::chrono::milliseconds interval, std::function<bool()> callback);
+
+    /**
+     * @brief Cancels a timer
+     *
+     * Waits for the callback of the timer if it is running, unless called from the timer
+     * thread, e.g. by the callback itself.
+     *
+     * @param handle The handle returned by schedule()
+     * @return bool true if the timer was still scheduled, false if it had already ended
+     */
+    bool cancel(handle_t handle);
+
+    /**
+     * @brief Returns the number of timers scheduled
+     */
+    size_t pending();
+
+private:
+    using clock_t = std::chrono::steady_clock;
+
+    struct entry_t {
+        clock_t::time_point deadline;
+        std::chrono::milliseconds interval;
+        std::function<bool()> callback;
+    };
+
+    std::mutex m_lock;
+    std::condition_variable m_cond;         // a timer was added in front of the queue
+    std::condition_variable m_done_cond;    // a callback returned
+    std::map<handle_t, entry_t> m_timers;
+    std::set<std::pair<clock_t::time_point, handle_t>> m_queue;
+    handle_t m_next_handle = 1;
+    handle_t m_running = 0;                 // timer whose callback runs
+    std::thread::id m_thread_id;
+
+    TimerService();
+
+    /**
+     * @brief Main loop of the timer thread
+     */
+    void run();
+};
 
 class ThreadedTimer {
 public:
@@ -16,7 +89,7 @@ public:
 
     /**
      * @brief Call `callback` after `delay` milliseconds
-     * 
+     *
      * @param delay The delay for the callback
      * @param callback The callback
      */
@@ -24,7 +97,7 @@ public:
 
     /**
      * @brief Starts a timer which calls `callback` with periodicity `interval`
-     * 
+     *
      * @param interval The periodicity at which to call the callback
      * @param callback The callback. If the callback returns false, the timer will stop.
      */
@@ -32,13 +105,13 @@ public:
 
     /**
      * @brief Cancel this timer.
-     * 
+     *
+     * Once it returns the callback is not running, unless it is called from the callback.
      */
     void stop();
 
 private:
-    std::unique_ptr<std::thread> timer_thread;
-    std::atomic<bool> running;
+    std::atomic<TimerService::handle_t> m_handle;
 };
 
 #endif // THREADED_TIMER_H
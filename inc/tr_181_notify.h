@@ -0,0 +1,159 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef TR_181_NOTIFY_H
+#define TR_181_NOTIFY_H
+
+#include <pthread.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#define TR_181_NOTIFY_DEF_INTERVAL_MS   1000
+#define TR_181_NOTIFY_MIN_INTERVAL_MS   500     // batches are taken on the 500 ms manager tick
+
+typedef struct {
+    unsigned int    refs;               // subscriptions of the path
+    bool            changed;            // marked since the last batch
+    bool            published;          // value holds the last value published
+    std::string     value;
+} tr_181_notify_sub_t;
+
+typedef struct {
+    unsigned int        num_subs;
+    unsigned long long  marked;         // paths marked changed
+    unsigned long long  coalesced;      // marks of a path already marked
+    unsigned long long  batches;
+    unsigned long long  published;      // values that differed from the last one published
+    unsigned long long  unchanged;      // values evaluated and found unchanged
+} tr_181_notify_stats_t;
+
+/*
+ * Value change subscriptions of TR-181 parameters. The bus adds and removes subscriptions
+ * from its own thread, the controller marks the paths under the objects that changed and,
+ * at most once per interval, takes the batch of marked paths, evaluates them and publishes
+ * those whose value differs from the one published last. Thread safe.
+ */
+class tr_181_notify_t {
+
+    pthread_mutex_t m_lock;
+    std::unordered_map<std::string, tr_181_notify_sub_t>    m_subs;
+    std::vector<std::string>    m_changed;          // marked paths, in the order they were marked
+    unsigned int        m_interval_ms;
+    unsigned long long  m_last_ms;                  // time of the last batch
+    tr_181_notify_stats_t   m_stats;
+
+public:
+
+    /**!
+     * @brief Adds a subscription of a parameter.
+     *
+     * @param[in] path Full name of the parameter.
+     *
+     * @returns 0 on success, -1 on an empty path.
+     */
+    int subscribe(const char *path);
+
+    /**!
+     * @brief Removes a subscription of a parameter, the path is dropped with its last one.
+     *
+     * @param[in] path Full name of the parameter.
+     *
+     * @returns 0 on success, -1 if the path is not subscribed.
+     */
+    int unsubscribe(const char *path);
+
+    /**!
+     * @brief Returns true if any parameter is subscribed.
+     */
+    bool has_subs();
+
+    /**!
+     * @brief Marks the subscribed parameters under an object as changed.
+     *
+     * @param[in] prefix Name of the object, with its trailing dot, or of a parameter.
+     *
+     * @returns Number of paths marked, those already marked are not counted again.
+     */
+    unsigned int mark_changed(const char *prefix);
+
+    /**!
+     * @brief Takes the batch of paths marked since the last one.
+     *
+     * @param[in] now_ms Current time in ms.
+     * @param[out] paths Marked paths, cleared first.
+     *
+     * @returns Number of paths, 0 while the interval since the last batch has not elapsed.
+     */
+    unsigned int get_batch(unsigned long long now_ms, std::vector<std::string>& paths);
+
+    /**!
+     * @brief Records the current value of a path of a batch.
+     *
+     * @param[in] path Full name of the parameter.
+     * @param[in] value Value, as a string.
+     *
+     * @returns True if the value is to be published, false if it was published already or the path is no longer subscribed.
+     */
+    bool update_value(const char *path, const std::string& value);
+
+    /**!
+     * @brief Sets the minimum interval between two batches.
+     *
+     * @param[in] interval_ms Interval in ms, at least TR_181_NOTIFY_MIN_INTERVAL_MS.
+     *
+     * @returns 0 on success, -1 if the interval is too short.
+     */
+    int set_interval(unsigned int interval_ms);
+
+    /**!
+     * @brief Returns the minimum interval between two batches in ms.
+     */
+    unsigned int get_interval();
+
+    /**!
+     * @brief Returns the subscription and publish counters.
+     *
+     * @param[out] stats Pointer to the counters.
+     */
+    void get_stats(tr_181_notify_stats_t *stats);
+
+    /**!
+     * @brief Returns the object template of a path, instance numbers replaced by {i}.
+     *
+     * @param[in] path Full name of a parameter, e.g. Device.WiFi.DataElements.Network.Device.2.ID.
+     *
+     * @returns The template, e.g. Device.WiFi.DataElements.Network.Device.{i}.ID.
+     */
+    static std::string get_template(const char *path);
+
+    /**!
+     * @brief Constructor for tr_181_notify_t, nothing is subscribed.
+     */
+    tr_181_notify_t();
+
+    /**!
+     * @brief Destructor for tr_181_notify_t.
+     */
+    ~tr_181_notify_t();
+
+    tr_181_notify_t(const tr_181_notify_t&) = delete;
+    tr_181_notify_t& operator=(const tr_181_notify_t&) = delete;
+};
+
+#endif
@@ -0,0 +1,46 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef TR_181_SCHEMA_H
+#define TR_181_SCHEMA_H
+
+#define TR_181_SCHEMA_DEFAULT_CB    -1      // element served by the default callbacks
+
+typedef enum {
+    tr_181_schema_type_property,
+    tr_181_schema_type_table,
+} tr_181_schema_type_t;
+
+/*
+ * Element of the Data Elements schema, in the order the schema lists them. The table is
+ * generated at build time by tr_181_schema_gen from Data_Elements_JSON_Schema_v3.0.json,
+ * so registering the namespaces at start up is a pass over static data.
+ */
+typedef struct {
+    const char              *path;
+    tr_181_schema_type_t    type;
+    bool                    writable;
+    double                  min;        // range of the value, 0 when the schema gives none
+    double                  max;
+    int                     cb_id;      // position in TR_181_CALLBACKS or TR_181_SCHEMA_DEFAULT_CB
+} tr_181_schema_elem_t;
+
+extern const tr_181_schema_elem_t g_tr_181_schema[];
+extern const unsigned int g_tr_181_schema_num;
+
+#endif
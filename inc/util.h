@@ -25,10 +25,12 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "wifi_hal.h"
+#include "em_hex.h"
 #include <pthread.h>
 #include <string>
 #include <memory>
 #include <vector>
+#include <type_traits>
 
 #ifndef LOG_PATH_PREFIX
 #define LOG_PATH_PREFIX "/nvram/"
@@ -83,11 +85,11 @@ namespace util {
 	void em_util_print(easymesh_log_level_t level, easymesh_dbg_type_t module, const char *func, int line, const char *format, ...);
 
 	/**!
-	 * @brief Introduces a delay for a specified amount of time.
+	 * @brief Sleeps for a specified amount of time.
 	 *
-	 * @param[in] duration The amount of time to delay, in milliseconds.
+	 * @param[in] seconds The amount of time to sleep, in seconds.
 	 *
-	 * @note This function will block the execution for the specified duration.
+	 * @note This function blocks the calling thread, an em_t should use em_t::defer() instead.
 	 */
 	void delay(int );
 
@@ -165,6 +167,9 @@ namespace util {
 	 */
 	inline std::string mac_to_string(const uint8_t mac[6], const std::string& delim = ":") {
 		char mac_str[18]; // Max size: 6 bytes * 2 hex chars + 5 delimiters + null terminator
+		if (delim.size() <= 1) {
+			return std::string(mac_str, static_cast<size_t> (em_hex::mac_to_str(mac, mac_str, delim.empty() ? '\0':delim[0]) - mac_str));
+		}
 		snprintf(mac_str, sizeof(mac_str), "%02x%s%02x%s%02x%s%02x%s%02x%s%02x", 
 				mac[0], delim.c_str(), mac[1], delim.c_str(), mac[2], delim.c_str(),
 				mac[3], delim.c_str(), mac[4], delim.c_str(), mac[5]);
@@ -360,11 +365,32 @@ namespace util {
 
 #define __FILENAME__ (strrchr(__FILE__, '/') ? strrchr(__FILE__, '/') + 1 : __FILE__)
 
-#define em_printf(format, ...)  util::em_util_print(EM_LOG_LVL_INFO, EM_AGENT, __func__, __LINE__, format, ##__VA_ARGS__)// general log
-#define em_printfout(format, ...)  util::em_util_print(EM_LOG_LVL_INFO, EM_STDOUT, __FILENAME__, __LINE__, format, ##__VA_ARGS__)// general log
-#define em_util_dbg_print(module, format, ...)  util::em_util_print(EM_LOG_LVL_DEBUG, module, __func__, __LINE__, format, ##__VA_ARGS__)
-#define em_util_info_print(module, format, ...)  util::em_util_print(EM_LOG_LVL_INFO, module, __func__, __LINE__, format, ##__VA_ARGS__)
-#define em_util_error_print(module, format, ...)  util::em_util_print(EM_LOG_LVL_ERROR, module, __func__, __LINE__, format, ##__VA_ARGS__)
+/*
+ * Logs below EM_LOG_COMPILE_LEVEL or of a module not in EM_LOG_COMPILE_MODULES are not
+ * compiled in, their arguments are not even evaluated, e.g. build with
+ * -DEM_LOG_COMPILE_LEVEL=EM_LOG_LVL_INFO to drop every debug log from the binaries.
+ */
+#ifndef EM_LOG_COMPILE_LEVEL
+#define EM_LOG_COMPILE_LEVEL    EM_LOG_LVL_DEBUG
+#endif
+#ifndef EM_LOG_COMPILE_MODULES
+#define EM_LOG_COMPILE_MODULES  0xffffffffu         // one bit per easymesh_dbg_type_t
+#endif
+
+constexpr bool em_log_compiled(easymesh_log_level_t level, easymesh_dbg_type_t module)
+{
+    return (level >= EM_LOG_COMPILE_LEVEL) && (((EM_LOG_COMPILE_MODULES >> module) & 1u) != 0);
+}
+
+#define EM_LOG_PRINT(level, module, func, format, ...) \
+    (std::integral_constant<bool, em_log_compiled(level, module)>::value ? \
+        util::em_util_print(level, module, func, __LINE__, format, ##__VA_ARGS__) : (void)0)
+
+#define em_printf(format, ...)  EM_LOG_PRINT(EM_LOG_LVL_INFO, EM_AGENT, __func__, format, ##__VA_ARGS__)// general log
+#define em_printfout(format, ...)  EM_LOG_PRINT(EM_LOG_LVL_INFO, EM_STDOUT, __FILENAME__, format, ##__VA_ARGS__)// general log
+#define em_util_dbg_print(module, format, ...)  EM_LOG_PRINT(EM_LOG_LVL_DEBUG, module, __func__, format, ##__VA_ARGS__)
+#define em_util_info_print(module, format, ...)  EM_LOG_PRINT(EM_LOG_LVL_INFO, module, __func__, format, ##__VA_ARGS__)
+#define em_util_error_print(module, format, ...)  EM_LOG_PRINT(EM_LOG_LVL_ERROR, module, __func__, format, ##__VA_ARGS__)
 
 
 // Used to avoid many many if-not-null checks
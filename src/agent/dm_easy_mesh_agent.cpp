@@ -40,6 +40,7 @@
 #include "em_cmd_dev_init.h"
 #include "dm_easy_mesh_agent.h"
 #include <cjson/cJSON.h>
+#include "cjson_util.h"
 #include "ieee80211.h"
 #include "em_cmd_sta_list.h"
 #include "em_cmd_onewifi_cb.h"
@@ -51,6 +52,7 @@
 #include "em_cmd_beacon_report.h"
 #include "em_cmd_sta_link_metrics.h"
 #include "em_cmd_ap_metrics_report.h"
+#include "em_timer_wheel.h"
 
 #ifdef AL_SAP
 #include "al_service_access_point.h"
@@ -59,6 +61,12 @@ extern AlServiceAccessPoint* g_sap;
 extern MacAddress g_al_mac_sap;
 #endif
 
+pthread_mutex_t dm_easy_mesh_agent_t::s_webconfig_lock = PTHREAD_MUTEX_INITIALIZER;
+webconfig_t dm_easy_mesh_agent_t::s_webconfig;
+bool dm_easy_mesh_agent_t::s_webconfig_ready = false;
+em_lat_hist_t dm_easy_mesh_agent_t::s_decode_hist[webconfig_subdoc_type_max];
+em_lat_hist_t dm_easy_mesh_agent_t::s_encode_hist[webconfig_subdoc_type_max];
+
 int dm_easy_mesh_agent_t::analyze_dev_init(em_bus_event_t *evt, em_cmd_t *pcmd[])
 {
     int num = 0;
@@ -96,16 +104,28 @@ int dm_easy_mesh_agent_t::analyze_dev_init(em_bus_event_t *evt, em_cmd_t *pcmd[]
 	return num;
 }
 
-int dm_easy_mesh_agent_t::analyze_sta_list(em_bus_event_t *evt, em_cmd_t *pcmd[])
+static bool has_sta_on_radio(dm_key_map_t *map, const unsigned char *radio)
+{
+    dm_sta_t *sta;
+
+    for (sta = static_cast<dm_sta_t *> (map->get_first()); sta != NULL; sta = static_cast<dm_sta_t *> (map->get_next(sta))) {
+        if (memcmp(sta->get_sta_info()->radiomac, radio, sizeof(mac_address_t)) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int dm_easy_mesh_agent_t::analyze_sta_list(em_bus_event_t *evt, em_cmd_t *pcmd[], dm_sta_delta_t *delta)
 {
     unsigned int num = 0, i = 0, num_radios = 0;
     dm_easy_mesh_agent_t  dm;
     dm_sta_t *sta = NULL;
     em_cmd_t *tmp = NULL;
-    em_long_string_t key;
+    dm_map_key_t key;
     mac_addr_str_t radio_str;
     em_cmd_params_t *evt_param = NULL;
-    mac_addr_str_t  sta_mac_str, bss_mac_str, radio_mac_str;
 
     num_radios = get_num_radios();
     dm.init();
@@ -118,55 +138,61 @@ int dm_easy_mesh_agent_t::analyze_sta_list(em_bus_event_t *evt, em_cmd_t *pcmd[]
     }
 
     dm.m_num_bss = m_num_bss;
-    for (unsigned int i = 0; i < EM_MAX_BSSS; i++) {
+    for (unsigned int i = 0; i < m_num_bss; i++) {
         dm.m_bss[i] = m_bss[i];
     }
 
     dm.translate_and_decode_onewifi_subdoc(reinterpret_cast<char *>(evt->u.raw_buff),
         webconfig_subdoc_type_associated_clients, "Assoc clients");
 
+    // the subdoc lists every client, keep only those that joined or left since the previous one
+    if (delta->apply(dm.m_sta_assoc_map, dm.m_sta_dassoc_map, em_timer_wheel_t::get_time_ms()) == 0) {
+        return 0;
+    }
+    printf("%s:%d: STAs joined:%u left:%u unchanged:%u vanished:%u\n", __func__, __LINE__,
+        delta->get_stats()->joined, delta->get_stats()->left, delta->get_stats()->unchanged, delta->get_stats()->vanished);
+
     for ( i = 0; i < num_radios; i++) {
+        if ((has_sta_on_radio(dm.m_sta_assoc_map, get_radio_by_ref(i).get_radio_interface_mac()) == false) &&
+                (has_sta_on_radio(dm.m_sta_dassoc_map, get_radio_by_ref(i).get_radio_interface_mac()) == false)) {
+            continue;
+        }
+
         evt_param->u.args.num_args = 1;
         dm_easy_mesh_t::macbytes_to_string(get_radio_by_ref(i).get_radio_interface_mac(), radio_str);
         strncpy(evt_param->u.args.args[0], radio_str, strlen(radio_str) + 1);
 
         pcmd[num] = new em_cmd_sta_list_t(evt->params, dm);
 
-        sta = static_cast<dm_sta_t *> (hash_map_get_first(dm.m_sta_assoc_map));
+        sta = static_cast<dm_sta_t *> (dm.m_sta_assoc_map->get_first());
         while(sta != NULL) {
             if (memcmp(sta->get_sta_info()->radiomac, get_radio_by_ref(i).get_radio_interface_mac(), sizeof(mac_address_t)) != 0) {
-                sta = static_cast<dm_sta_t *> (hash_map_get_next(dm.m_sta_assoc_map, sta));
+                sta = static_cast<dm_sta_t *> (dm.m_sta_assoc_map->get_next(sta));
                 continue;
             }
 
-            dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.id, sta_mac_str);
-            dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.bssid, bss_mac_str);
-            dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.radiomac, radio_mac_str);
-            snprintf(key, sizeof(em_long_string_t), "%s@%s@%s", sta_mac_str, bss_mac_str, radio_mac_str);
-            hash_map_put(pcmd[num]->m_data_model.m_sta_assoc_map, strdup(key), new dm_sta_t(*sta));
-            sta = static_cast<dm_sta_t *> (hash_map_get_next(dm.m_sta_assoc_map, sta));
+            dm_key_map_t::sta_key(&key, sta->m_sta_info.id, sta->m_sta_info.bssid, sta->m_sta_info.radiomac);
+            pcmd[num]->m_data_model->m_sta_assoc_map->put(&key, new dm_sta_t(*sta));
+            sta = static_cast<dm_sta_t *> (dm.m_sta_assoc_map->get_next(sta));
         }
 
-        sta = static_cast<dm_sta_t *> (hash_map_get_first(dm.m_sta_dassoc_map));
+        sta = static_cast<dm_sta_t *> (dm.m_sta_dassoc_map->get_first());
         while(sta != NULL) {
             if (memcmp(sta->get_sta_info()->radiomac, get_radio_by_ref(i).get_radio_interface_mac(), sizeof(mac_address_t)) != 0) {
-                sta = static_cast<dm_sta_t *> (hash_map_get_next(dm.m_sta_dassoc_map, sta));
+                sta = static_cast<dm_sta_t *> (dm.m_sta_dassoc_map->get_next(sta));
                 continue;
              }
 
-            dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.id, sta_mac_str);
-            dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.bssid, bss_mac_str);
-            dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.radiomac, radio_mac_str);
-            snprintf(key, sizeof(em_long_string_t), "%s@%s@%s", sta_mac_str, bss_mac_str, radio_mac_str);
-            hash_map_put(pcmd[num]->m_data_model.m_sta_dassoc_map, strdup(key), new dm_sta_t(*sta));
-            sta = static_cast<dm_sta_t *> (hash_map_get_next(dm.m_sta_dassoc_map, sta));
+            dm_key_map_t::sta_key(&key, sta->m_sta_info.id, sta->m_sta_info.bssid, sta->m_sta_info.radiomac);
+            pcmd[num]->m_data_model->m_sta_dassoc_map->put(&key, new dm_sta_t(*sta));
+            sta = static_cast<dm_sta_t *> (dm.m_sta_dassoc_map->get_next(sta));
         }
 
         tmp = pcmd[num];
         num++;
 
         while ((pcmd[num] = tmp->clone_for_next()) != NULL) {
-            dm.clone_hash_maps(*pcmd[num]->get_data_model());
+            dm.clone_hash_maps(*pcmd[num]->get_own_data_model());
             tmp = pcmd[num];
             num++;
         }
@@ -202,30 +228,14 @@ int dm_easy_mesh_agent_t::analyze_autoconfig_renew(em_bus_event_t *evt, em_cmd_t
 
 void dm_easy_mesh_agent_t::translate_onewifi_dml_data (char *str)
 {           
-    webconfig_t config;
-    webconfig_external_easymesh_t ext;
     webconfig_subdoc_type_t type;
                 
-    webconfig_proto_easymesh_init(&ext, this, NULL, NULL, get_num_radios, set_num_radios,
-            get_num_op_class, set_num_op_class, get_num_bss, set_num_bss,
-            get_device_info, get_network_info, get_radio_info, get_ieee_1905_security_info, get_bss_info, get_op_class_info, 
-            get_first_sta_info, get_next_sta_info, get_sta_info, put_sta_info, get_bss_info_with_mac, update_scan_results,
-            update_ap_mld_info, update_bsta_mld_info, update_assoc_sta_mld_info, get_ap_mld_frm_bssid);
-    
-    config.initializer = webconfig_initializer_onewifi;
-    config.apply_data =  webconfig_dummy_apply;
-                
-    if (webconfig_init(&config) != webconfig_error_none) {
-        printf( "[%s]:%d Init WiFi Web Config  fail\n",__func__,__LINE__);
-        return ;
-                
-    }           
-                
-    if ((webconfig_easymesh_decode(&config, str, &ext, &type)) == webconfig_error_none) {
+    if (decode_onewifi_subdoc(this, str, &type) == webconfig_error_none) {
         printf("%s:%d Dev-Init decode success\n",__func__, __LINE__);
     } else {       
         printf("%s:%d Dev-Init decode fail\n",__func__, __LINE__);
     }       
+    set_radio_changed();
         
 }
 
@@ -253,10 +263,66 @@ int dm_easy_mesh_agent_t::analyze_m2ctrl_configuration(em_bus_event_t *evt, wifi
     return refresh_onewifi_subdoc(desc, bus_hdl, "Private", get_subdoc_vap_type_for_freq(radioconfig->freq[0]), &m2ctrl, NULL);
 }    
 
+unsigned int dm_easy_mesh_agent_t::get_radio_cfg_delta(dm_easy_mesh_t& dm, dm_radio_t *radio)
+{
+    const unsigned char *ruid = radio->get_radio_info()->intf.mac;
+    em_op_class_info_t *dec, *cur;
+    dm_radio_t *tmp;
+    unsigned int i, j, delta;
+
+    tmp = get_radio(ruid);
+    delta = dm_cfg_delta_t::radio((tmp != NULL) ? tmp->get_radio_info():NULL, radio->get_radio_info());
+
+    for (i = 0; i < dm.get_num_op_class(); i++) {
+        dec = dm.get_op_class_info(i);
+        if (memcmp(dec->id.ruid, ruid, sizeof(mac_address_t)) != 0) {
+            continue;
+        }
+
+        // a radio has one current operating class whatever its number, as commit_config() matches them
+        for (j = 0, cur = NULL; j < get_num_op_class(); j++) {
+            cur = get_op_class_info(j);
+            if ((cur->id.type == dec->id.type) && (memcmp(cur->id.ruid, ruid, sizeof(mac_address_t)) == 0) &&
+                    ((cur->op_class == dec->op_class) || (dec->id.type == em_op_class_type_current))) {
+                break;
+            }
+            cur = NULL;
+        }
+        delta |= dm_cfg_delta_t::op_class(cur, dec);
+    }
+
+    return delta;
+}
+
+unsigned int dm_easy_mesh_agent_t::get_bss_cfg_delta(dm_easy_mesh_t& dm, const unsigned char *ruid)
+{
+    em_bss_info_t *dec, *cur;
+    unsigned int i, j, delta = DM_CFG_DELTA_NONE;
+
+    for (i = 0; i < dm.get_num_bss(); i++) {
+        dec = dm.get_bss(i)->get_bss_info();
+        if (memcmp(dec->ruid.mac, ruid, sizeof(mac_address_t)) != 0) {
+            continue;
+        }
+
+        for (j = 0, cur = NULL; j < get_num_bss(); j++) {
+            cur = get_bss(j)->get_bss_info();
+            // the BSSID of a backhaul STA is the one of its parent, its VAP is the same one across roams
+            if ((dec->vap_mode == em_vap_mode_sta) ? ((cur->vap_mode == em_vap_mode_sta) && (cur->vap_index == dec->vap_index) &&
+                    (memcmp(cur->ruid.mac, dec->ruid.mac, sizeof(mac_address_t)) == 0)) :
+                    (memcmp(cur->bssid.mac, dec->bssid.mac, sizeof(mac_address_t)) == 0)) {
+                break;
+            }
+            cur = NULL;
+        }
+        delta |= dm_cfg_delta_t::bss(cur, dec);
+    }
+
+    return delta;
+}
+
 int dm_easy_mesh_agent_t::analyze_onewifi_vap_cb(em_bus_event_t *evt, em_cmd_t *pcmd[])
 {
-    webconfig_t config;
-    webconfig_external_easymesh_t ext;
     webconfig_subdoc_type_t type;
     int num = 0;
     unsigned int j = 0, index = 0;
@@ -267,21 +333,10 @@ int dm_easy_mesh_agent_t::analyze_onewifi_vap_cb(em_bus_event_t *evt, em_cmd_t *
 	dm_radio_t *radio;
 	em_freq_band_t freq_band;
 	const char *json_data = reinterpret_cast<char *> (evt->u.raw_buff);
+	em_subdoc_name_space_t subdoc_name;
+	unsigned int delta;
 
-    webconfig_proto_easymesh_init(&ext, &dm, NULL, NULL, get_num_radios, set_num_radios,
-            get_num_op_class, set_num_op_class, get_num_bss, set_num_bss,
-            get_device_info, get_network_info, get_radio_info, get_ieee_1905_security_info, get_bss_info, 
-            get_op_class_info, get_first_sta_info, get_next_sta_info, get_sta_info, put_sta_info, get_bss_info_with_mac,
-            update_scan_results, update_ap_mld_info, update_bsta_mld_info, update_assoc_sta_mld_info, get_ap_mld_frm_bssid);
-    config.initializer = webconfig_initializer_onewifi;
-    config.apply_data =  webconfig_dummy_apply;
-    if (webconfig_init(&config) != webconfig_error_none) {
-        em_printfout( "Init WiFi Web Config  fail");
-        return 0;
-    }
-
-    if ((webconfig_easymesh_decode(&config, reinterpret_cast<char *> (evt->u.raw_buff),
-            &ext, &type)) == webconfig_error_none) {
+    if (decode_onewifi_subdoc(&dm, reinterpret_cast<char *> (evt->u.raw_buff), &type) == webconfig_error_none) {
         em_printfout("Private subdoc decode success");
     } else {
         em_printfout("Private subdoc decode fail");
@@ -289,27 +344,34 @@ int dm_easy_mesh_agent_t::analyze_onewifi_vap_cb(em_bus_event_t *evt, em_cmd_t *
 
 	if (dm.get_num_bss() != 0) {
 		dm_easy_mesh_t::macbytes_to_string(dm.get_bss(index)->get_bss_info()->ruid.mac, mac_str);
+		// OneWifi sends the whole VAP subdoc again for any event, most repeat what is committed
+		if ((delta = get_bss_cfg_delta(dm, dm.get_bss(index)->get_bss_info()->ruid.mac)) == DM_CFG_DELTA_NONE) {
+			em_printfout("BSSs of %s unchanged, nothing to commit", mac_str);
+			return 0;
+		}
 		snprintf(reinterpret_cast<char *> (cm_config.params), sizeof(cm_config.params), "%s", mac_str);
 		cm_config.type = em_commit_target_bss;
 		commit_config(dm, cm_config);
+
+		// a backhaul steer only moved the bSTA, the ems stay configured rather than onboard again
+		if (delta == DM_CFG_DELTA_BACKHAUL) {
+			em_printfout("Backhaul STA of %s moved to another parent, committed", mac_str);
+			return 0;
+		}
 	} else {
-		cJSON *json = cJSON_Parse(json_data);
-		if (json == NULL) {
+		if (cjson_utils::get_top_level_string(json_data, evt->data_len, "SubDocName", subdoc_name, sizeof(subdoc_name)) == false) {
 			em_printfout("Error parsing JSON");
 			return 0;
 		}
-		cJSON *subdoc_name = cJSON_GetObjectItemCaseSensitive(json, "SubDocName");
-		if (cJSON_IsString(subdoc_name) && (subdoc_name->valuestring != NULL)) {
-			if (strcmp(subdoc_name->valuestring, "Vap_5G") == 0) {
-				freq_band = em_freq_band_5 ;
-				em_printfout("Found SubDocName:Vap 5G recv");
-			} else if (strcmp(subdoc_name->valuestring, "Vap_2.4G") == 0) {
-				em_printfout("Found SubDocName:Vap 2.4G recv");
-				freq_band = em_freq_band_24;
-			} else if (strcmp(subdoc_name->valuestring, "Vap_6G") == 0) {
-				em_printfout("Found SubDocName:Vap 6G recv");
-				freq_band = em_freq_band_60;
-			}
+		if (strcmp(subdoc_name, "Vap_5G") == 0) {
+			freq_band = em_freq_band_5 ;
+			em_printfout("Found SubDocName:Vap 5G recv");
+		} else if (strcmp(subdoc_name, "Vap_2.4G") == 0) {
+			em_printfout("Found SubDocName:Vap 2.4G recv");
+			freq_band = em_freq_band_24;
+		} else if (strcmp(subdoc_name, "Vap_6G") == 0) {
+			em_printfout("Found SubDocName:Vap 6G recv");
+			freq_band = em_freq_band_60;
 		}
 		for (j = 0; j < get_num_radios(); j++) {
 			radio = get_radio(j);
@@ -333,8 +395,6 @@ int dm_easy_mesh_agent_t::analyze_onewifi_vap_cb(em_bus_event_t *evt, em_cmd_t *
 
 int dm_easy_mesh_agent_t::analyze_onewifi_radio_cb(em_bus_event_t *evt, em_cmd_t *pcmd[])
 {
-    webconfig_t config;
-    webconfig_external_easymesh_t ext;
     webconfig_subdoc_type_t type;
     int num = 0;
     mac_addr_str_t  mac_str;
@@ -342,31 +402,28 @@ int dm_easy_mesh_agent_t::analyze_onewifi_radio_cb(em_bus_event_t *evt, em_cmd_t
     dm_easy_mesh_agent_t  dm;
     em_cmd_t *tmp;
     em_commit_target_t cm_config;
+    unsigned int delta;
 
-    webconfig_proto_easymesh_init(&ext, &dm, NULL, NULL, get_num_radios, set_num_radios,
-            get_num_op_class, set_num_op_class, get_num_bss, set_num_bss,
-            get_device_info, get_network_info, get_radio_info, get_ieee_1905_security_info, get_bss_info, get_op_class_info, 
-            get_first_sta_info, get_next_sta_info, get_sta_info, put_sta_info, get_bss_info_with_mac, update_scan_results,
-            update_ap_mld_info, update_bsta_mld_info, update_assoc_sta_mld_info, get_ap_mld_frm_bssid);
-
-    config.initializer = webconfig_initializer_onewifi;
-    config.apply_data =  webconfig_dummy_apply;
-    if (webconfig_init(&config) != webconfig_error_none) {
-        printf( "[%s]:%d Init WiFi Web Config  fail\n",__func__,__LINE__);
-        return 0;
-    }
-
-    if ((webconfig_easymesh_decode(&config, reinterpret_cast<char *> (evt->u.raw_buff),
-            &ext, &type)) == webconfig_error_none) {
+    if (decode_onewifi_subdoc(&dm, reinterpret_cast<char *> (evt->u.raw_buff), &type) == webconfig_error_none) {
         printf("%s:%d Radio subdoc decode success\n",__func__, __LINE__);
     } else {
         printf("%s:%d Radio subdoc decode fail\n",__func__, __LINE__);
     }
 
 	dm_easy_mesh_t::macbytes_to_string(dm.get_radio(index)->get_radio_info()->intf.mac, mac_str);
+	if ((delta = get_radio_cfg_delta(dm, dm.get_radio(index))) == DM_CFG_DELTA_NONE) {
+		printf("%s:%d Radio %s unchanged, nothing to commit\n", __func__, __LINE__, mac_str);
+		return 0;
+	}
 	cm_config.type = em_commit_target_radio;
 	snprintf(reinterpret_cast<char *> (cm_config.params), sizeof(cm_config.params), "%s", mac_str);
 	commit_config(dm, cm_config);
+
+	// the Operating Channel Report only carries the current channel and power, nothing else to tell
+	if ((delta & DM_CFG_DELTA_CHANNEL) == 0) {
+		printf("%s:%d Radio %s configuration committed, channel unchanged\n", __func__, __LINE__, mac_str);
+		return 0;
+	}
 	pcmd[num] = new em_cmd_op_channel_report_t(evt->params, dm);
 	tmp = pcmd[num];
 	num++;
@@ -629,7 +686,7 @@ int dm_easy_mesh_agent_t::analyze_sta_link_metrics(em_bus_event_t *evt, em_cmd_t
     dm.translate_and_decode_onewifi_subdoc(reinterpret_cast<char *> (evt->u.raw_buff), webconfig_subdoc_type_em_sta_link_metrics,
         "Link Metrics");
     pcmd[num]->m_svc = em_service_type_agent;
-    dm.clone_hash_maps(pcmd[num]->m_data_model);
+    dm.clone_hash_maps(*pcmd[num]->get_own_data_model());
 
     tmp = pcmd[num];
     num++;
@@ -746,42 +803,24 @@ int dm_easy_mesh_agent_t::analyze_scan_result(em_bus_event_t *evt, em_cmd_t *pcm
     unsigned int num = 0;
     dm_easy_mesh_agent_t  dm = *this;
     em_cmd_t *tmp;
-    cJSON *json, *scanner_mac_obj;
+    mac_addr_str_t scanner_mac;
 
-    webconfig_t config;
-    webconfig_external_easymesh_t ext;
     webconfig_subdoc_type_t type = webconfig_subdoc_type_em_channel_stats;
 
-    webconfig_proto_easymesh_init(&ext, &dm, NULL, NULL, get_num_radios, set_num_radios,
-            get_num_op_class, set_num_op_class, get_num_bss, set_num_bss,
-            get_device_info, get_network_info, get_radio_info, get_ieee_1905_security_info, get_bss_info, get_op_class_info,
-            get_first_sta_info, get_next_sta_info, get_sta_info, put_sta_info, get_bss_info_with_mac, update_scan_results,
-            update_ap_mld_info, update_bsta_mld_info, update_assoc_sta_mld_info, get_ap_mld_frm_bssid);
-
-    config.initializer = webconfig_initializer_onewifi;
-    config.apply_data =  webconfig_dummy_apply;
-
-    if (webconfig_init(&config) != webconfig_error_none) {
-        printf( "[%s]:%d Init WiFi Web Config  fail\n",__func__,__LINE__);
-        return 0;
-    }
-
-    json = cJSON_Parse((const char *)evt->u.raw_buff);
-    scanner_mac_obj = cJSON_GetObjectItemCaseSensitive(json, "ScannerMac");
-    if ((scanner_mac_obj == NULL) || (cJSON_IsString(scanner_mac_obj) == false) || (scanner_mac_obj->valuestring == NULL) ) {
+    if (cjson_utils::get_top_level_string((const char *)evt->u.raw_buff, evt->data_len, "ScannerMac", scanner_mac, sizeof(scanner_mac)) == false) {
         printf("%s:%d Unable to find scanner mac\n", __func__, __LINE__);
         return 0;
     }
 
-    if ((webconfig_easymesh_decode(&config, (char *)evt->u.raw_buff, &ext, &type)) == webconfig_error_none) {
-        printf("%s:%d scanner mac: %s - analyze_scan_result subdoc decode success\n",__func__, __LINE__, scanner_mac_obj->valuestring);
+    if (decode_onewifi_subdoc(&dm, (char *)evt->u.raw_buff, &type) == webconfig_error_none) {
+        printf("%s:%d scanner mac: %s - analyze_scan_result subdoc decode success\n",__func__, __LINE__, scanner_mac);
     } else {
-        printf("%s:%d scanner mac: %s - analyze_scan_result subdoc decode fail\n",__func__, __LINE__, scanner_mac_obj->valuestring);
+        printf("%s:%d scanner mac: %s - analyze_scan_result subdoc decode fail\n",__func__, __LINE__, scanner_mac);
     }
 
     em_cmd_params_t *evt_param = NULL;
     evt_param = &evt->params;
-    dm_easy_mesh_t::string_to_macbytes(scanner_mac_obj->valuestring, evt_param->u.scan_params.ruid);
+    dm_easy_mesh_t::string_to_macbytes(scanner_mac, evt_param->u.scan_params.ruid);
 
     pcmd[num] = new em_cmd_scan_result_t(evt->params, dm);
     tmp = pcmd[num];
@@ -798,24 +837,37 @@ int dm_easy_mesh_agent_t::analyze_scan_result(em_bus_event_t *evt, em_cmd_t *pcm
 int dm_easy_mesh_agent_t::analyze_set_policy(em_bus_event_t *evt, wifi_bus_desc_t *desc, bus_handle_t *bus_hdl)
 {
     em_policy_cfg_params_t *policy_cfg = (em_policy_cfg_params_t *)evt->u.raw_buff;
+    const unsigned char *p = (const unsigned char *)policy_cfg;
+    unsigned long long key = 14695981039346656037ULL;
+    size_t i;
+    int ret;
+
+    // FNV-1a, the controller sends the same policies in the request of every radio
+    for (i = 0; i < sizeof(em_policy_cfg_params_t); i++) {
+        key = (key ^ p[i]) * 1099511628211ULL;
+    }
+    if ((m_policy_key != 0) && (key == m_policy_key)) {
+        printf("%s:%d Policy unchanged, the VLANs of the BSSs stay as they are\n", __func__, __LINE__);
+        return 1;
+    }
 
-    return refresh_onewifi_subdoc(desc, bus_hdl, "Policy", webconfig_subdoc_type_em_config, NULL, policy_cfg);
+    if ((ret = refresh_onewifi_subdoc(desc, bus_hdl, "Policy", webconfig_subdoc_type_em_config, NULL, policy_cfg)) == 1) {
+        m_policy_key = key;
+    }
+
+    return ret;
 }
 
-int dm_easy_mesh_agent_t::analyze_beacon_report(em_bus_event_t *evt, em_cmd_t *pcmd[])
+int dm_easy_mesh_agent_t::analyze_beacon_report(em_bus_event_t *evt, em_beacon_report_agg_t *agg)
 {
     dm_sta_t *sta = NULL;
-    em_cmd_t *tmp = NULL;
-    em_cmd_params_t *evt_param = NULL;
     dm_easy_mesh_agent_t  dm;
-    unsigned int num = 0, num_radios = 0;
-    mac_addr_str_t macstr;
+    unsigned long long now = em_timer_wheel_t::get_time_ms();
+    unsigned int len;
+    int num = 0;
 
     dm.init();
 
-    evt_param = &evt->params;
-
-    num_radios = m_num_radios;
     for (unsigned int i = 0; i < m_num_radios; i++) {
         memcpy(&dm.m_radio[i], &m_radio[i], sizeof(dm_radio_t));
     }
@@ -827,18 +879,65 @@ int dm_easy_mesh_agent_t::analyze_beacon_report(em_bus_event_t *evt, em_cmd_t *p
 
     dm.translate_and_decode_onewifi_subdoc((char *)evt->u.raw_buff, webconfig_subdoc_type_beacon_report, "Beacon Report");
 
-    sta = (dm_sta_t *)hash_map_get_first((hash_map_t *)dm.m_sta_map);
-    if (sta != NULL) {
-        evt_param->u.args.num_args = 2;
+    // a report usually covers a channel, the response waits for the rest of the STA's reports
+    sta = (dm_sta_t *)dm.m_sta_map->get_first();
+    while (sta != NULL) {
+        len = sta->m_sta_info.beacon_report_len;
+        if (len > EM_MAX_BEACON_MEASUREMENT_LEN) {
+            len = EM_MAX_BEACON_MEASUREMENT_LEN;
+        }
+        agg->add(sta->m_sta_info.id, sta->m_sta_info.bssid, sta->m_sta_info.beacon_report_elem, len,
+                sta->m_sta_info.num_beacon_meas_report, now);
+        num++;
+        sta = (dm_sta_t *)dm.m_sta_map->get_next(sta);
+    }
+
+    return num;
+}
 
-        dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.id, macstr);
-        strncpy(evt_param->u.args.args[0], macstr, strlen(macstr) + 1);
+int dm_easy_mesh_agent_t::create_beacon_report_cmd(const em_beacon_report_agg_report_t *report, em_cmd_t *pcmd[])
+{
+    em_cmd_t *tmp = NULL;
+    em_cmd_params_t params;
+    dm_easy_mesh_agent_t  dm;
+    em_sta_info_t *info;
+    dm_map_key_t key;
+    unsigned int num = 0;
+    mac_addr_str_t macstr;
+
+    dm.init();
 
-        dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.bssid, macstr);
-        strncpy(evt_param->u.args.args[1], macstr, strlen(macstr) + 1);
+    for (unsigned int i = 0; i < m_num_radios; i++) {
+        memcpy(&dm.m_radio[i], &m_radio[i], sizeof(dm_radio_t));
+    }
+
+    dm.m_num_bss = m_num_bss;
+    for (unsigned int i = 0; i < EM_MAX_BSSS; i++) {
+        memcpy(&dm.m_bss[i], &m_bss[i], sizeof(dm_bss_t));
     }
 
-    pcmd[num] = new em_cmd_beacon_report_t(evt->params, dm);
+    // the response is built from the one STA of the command's data model
+    info = new em_sta_info_t;
+    memset(info, 0, sizeof(em_sta_info_t));
+    memcpy(info->id, report->sta, sizeof(mac_address_t));
+    memcpy(info->bssid, report->bssid, sizeof(bssid_t));
+    info->num_beacon_meas_report = report->count;
+    info->beacon_report_len = report->len;
+    memcpy(info->beacon_report_elem, report->elems, report->len);
+    dm_key_map_t::sta_key(&key, info->id, info->bssid, info->radiomac);
+    dm.m_sta_map->put(&key, new dm_sta_t(info));
+    delete info;
+
+    memset(&params, 0, sizeof(em_cmd_params_t));
+    params.u.args.num_args = 2;
+
+    dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *>(report->sta), macstr);
+    strncpy(params.u.args.args[0], macstr, strlen(macstr) + 1);
+
+    dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *>(report->bssid), macstr);
+    strncpy(params.u.args.args[1], macstr, strlen(macstr) + 1);
+
+    pcmd[num] = new em_cmd_beacon_report_t(params, dm);
 
     tmp = pcmd[num];
     num++;
@@ -848,7 +947,7 @@ int dm_easy_mesh_agent_t::analyze_beacon_report(em_bus_event_t *evt, em_cmd_t *p
         num++;
     }
 
-    return num;
+    return static_cast<int>(num);
 }
 
 int dm_easy_mesh_agent_t::analyze_ap_metrics_report(em_bus_event_t *evt, em_cmd_t *pcmd[])
@@ -857,26 +956,29 @@ int dm_easy_mesh_agent_t::analyze_ap_metrics_report(em_bus_event_t *evt, em_cmd_
     em_cmd_params_t *evt_param = NULL;
     unsigned int num = 0;
     mac_addr_str_t macstr;
-    cJSON *json, *emap_metrics_report, *param_obj;
+    const char *json = (const char *)evt->u.raw_buff, *emap_metrics_report, *param;
+    char *param_end;
     int radio_index = 0;
     
     printf("%s:%d: Enter\n", __func__, __LINE__);
     translate_and_decode_onewifi_subdoc((char *)evt->u.raw_buff, webconfig_subdoc_type_em_ap_metrics_report, "AP Metrics Report");
 
-    json = cJSON_Parse((const char *)evt->u.raw_buff);
-    emap_metrics_report = cJSON_GetObjectItem(json, "EMAPMetricsReport");
+    // the decode above is the only parse of the report, the radio index is scanned for
+    emap_metrics_report = cjson_utils::find_top_level_value(json, evt->data_len, "EMAPMetricsReport");
     if (emap_metrics_report == NULL) {
         printf("%s:%d: Invalid or missing EMAPMetricsReport\n", __func__, __LINE__);
         return 0;
     }
 
-    param_obj = cJSON_GetObjectItemCaseSensitive(emap_metrics_report, "Radio Index");
-    if ((param_obj == NULL) || (cJSON_IsNumber(param_obj) == false) ) {
+    param = cjson_utils::find_top_level_value(emap_metrics_report, evt->data_len - static_cast<unsigned int>(emap_metrics_report - json), "Radio Index");
+    if (param != NULL) {
+        radio_index = static_cast<int>(strtol(param, &param_end, 10));
+    }
+    if ((param == NULL) || (param_end == param)) {
         printf("%s:%d Unable to find scanner mac\n", __func__, __LINE__);
         return 0;
     }
 
-    radio_index = param_obj->valueint;
     evt_param = &evt->params;
     dm_easy_mesh_t::macbytes_to_string(get_radio_by_ref(radio_index).get_radio_interface_mac(), macstr);
     memcpy(evt_param->u.ap_metrics_params.ruid, get_radio_by_ref(radio_index).get_radio_interface_mac(), sizeof(mac_addr_t));
@@ -922,52 +1024,19 @@ void dm_easy_mesh_agent_t::translate_and_decode_onewifi_subdoc(char *str, webcon
 {
     printf("%s:%d: Enter\n", __func__, __LINE__);
 
-    webconfig_t config;
-    webconfig_external_easymesh_t extdata = {0};
-
-    webconfig_proto_easymesh_init(&extdata, this, NULL, NULL, get_num_radios, set_num_radios,
-        get_num_op_class, set_num_op_class, get_num_bss, set_num_bss,
-        get_device_info, get_network_info, get_radio_info, get_ieee_1905_security_info, get_bss_info, get_op_class_info,
-        get_first_sta_info, get_next_sta_info, get_sta_info, put_sta_info, get_bss_info_with_mac, update_scan_results,
-        update_ap_mld_info, update_bsta_mld_info, update_assoc_sta_mld_info, get_ap_mld_frm_bssid);
-
-    config.initializer = webconfig_initializer_onewifi;
-    config.apply_data =  webconfig_dummy_apply;
-
-    if (webconfig_init(&config) != webconfig_error_none) {
-        printf( "[%s]:%d Init WiFi Web Config  fail\n",__func__,__LINE__);
-        return;
-    }
-
-    if ((webconfig_easymesh_decode(&config, str, &extdata, &type)) == webconfig_error_none) {
+    if (decode_onewifi_subdoc(this, str, &type) == webconfig_error_none) {
         printf("%s:%d %s decode success\n",__func__, __LINE__, logname);
     } else {
         printf("%s:%d %s decode fail\n",__func__, __LINE__, logname);
     }
+    set_radio_changed();
 }
 
 int dm_easy_mesh_agent_t::refresh_onewifi_subdoc(wifi_bus_desc_t *desc, bus_handle_t *bus_hdl, const char* logname, webconfig_subdoc_type_t type, m2ctrl_radioconfig *m2_cfg, em_policy_cfg_params_t *policy_config)
 {
-    webconfig_external_easymesh_t ext_data;
-
-    webconfig_proto_easymesh_init(&ext_data, this, m2_cfg, policy_config, get_num_radios, set_num_radios,
-        get_num_op_class, set_num_op_class, get_num_bss, set_num_bss,
-        get_device_info, get_network_info, get_radio_info, get_ieee_1905_security_info, get_bss_info, get_op_class_info,
-        get_first_sta_info, get_next_sta_info, get_sta_info, put_sta_info, get_bss_info_with_mac, update_scan_results,
-        update_ap_mld_info, update_bsta_mld_info, update_assoc_sta_mld_info, get_ap_mld_frm_bssid);
-
-    webconfig_t config;
-    config.initializer = webconfig_initializer_onewifi;
-    config.apply_data =  webconfig_dummy_apply;
-
-    if (webconfig_init(&config) != webconfig_error_none) {
-        printf( "[%s]:%d Init WiFi Web Config  fail\n",__func__,__LINE__);
-        return 0;
-    }
-
     char *webconfig_easymesh_raw_data_ptr;
 
-    if ((webconfig_easymesh_encode(&config, &ext_data, type, &webconfig_easymesh_raw_data_ptr )) == webconfig_error_none) {
+    if (encode_onewifi_subdoc(this, m2_cfg, policy_config, type, &webconfig_easymesh_raw_data_ptr) == webconfig_error_none) {
         printf("%s:%d %s subdoc encode success %s\n", __func__, __LINE__, logname, webconfig_easymesh_raw_data_ptr);
     } else {
         printf("%s:%d %s subdoc encode failure\n", __func__, __LINE__, logname);
@@ -1000,9 +1069,109 @@ webconfig_error_t dm_easy_mesh_agent_t::webconfig_dummy_apply(webconfig_subdoc_t
     return webconfig_error_none;
 }   
 
-dm_easy_mesh_agent_t::dm_easy_mesh_agent_t()
+void dm_easy_mesh_agent_t::init_webconfig_ext(webconfig_external_easymesh_t *ext, dm_easy_mesh_agent_t *dm,
+        m2ctrl_radioconfig *m2_cfg, em_policy_cfg_params_t *policy_config)
 {
+    webconfig_proto_easymesh_init(ext, dm, m2_cfg, policy_config, get_num_radios, set_num_radios,
+        get_num_op_class, set_num_op_class, get_num_bss, set_num_bss,
+        get_device_info, get_network_info, get_radio_info, get_ieee_1905_security_info, get_bss_info, get_op_class_info,
+        get_first_sta_info, get_next_sta_info, get_sta_info, put_sta_info, get_bss_info_with_mac, update_scan_results,
+        update_ap_mld_info, update_bsta_mld_info, update_assoc_sta_mld_info, get_ap_mld_frm_bssid);
+}
+
+bool dm_easy_mesh_agent_t::init_webconfig()
+{
+    // building the subdoc tables costs more than most decodes, do it once and retry only on failure
+    if (s_webconfig_ready == true) {
+        return true;
+    }
+
+    memset(&s_webconfig, 0, sizeof(webconfig_t));
+    s_webconfig.initializer = webconfig_initializer_onewifi;
+    s_webconfig.apply_data = webconfig_dummy_apply;
+    if (webconfig_init(&s_webconfig) != webconfig_error_none) {
+        printf("%s:%d Init WiFi Web Config fail\n", __func__, __LINE__);
+        return false;
+    }
+    s_webconfig_ready = true;
+
+    return true;
+}
+
+webconfig_error_t dm_easy_mesh_agent_t::decode_onewifi_subdoc(dm_easy_mesh_agent_t *dm, char *str, webconfig_subdoc_type_t *type)
+{
+    webconfig_external_easymesh_t ext;
+    webconfig_error_t err;
+    uint64_t start_us;
+
+    memset(&ext, 0, sizeof(webconfig_external_easymesh_t));
+    init_webconfig_ext(&ext, dm, NULL, NULL);
+
+    pthread_mutex_lock(&s_webconfig_lock);
+    if (init_webconfig() == false) {
+        pthread_mutex_unlock(&s_webconfig_lock);
+        return webconfig_error_init;
+    }
+    start_us = em_lat_hist_t::get_time_us();
+    err = webconfig_easymesh_decode(&s_webconfig, str, &ext, type);
+    if ((err == webconfig_error_none) && (*type < webconfig_subdoc_type_max)) {
+        s_decode_hist[*type].add(em_lat_hist_t::get_time_us() - start_us);
+    }
+    pthread_mutex_unlock(&s_webconfig_lock);
 
+    return err;
+}
+
+webconfig_error_t dm_easy_mesh_agent_t::encode_onewifi_subdoc(dm_easy_mesh_agent_t *dm, m2ctrl_radioconfig *m2_cfg,
+        em_policy_cfg_params_t *policy_config, webconfig_subdoc_type_t type, char **str)
+{
+    webconfig_external_easymesh_t ext;
+    webconfig_error_t err;
+    uint64_t start_us;
+
+    memset(&ext, 0, sizeof(webconfig_external_easymesh_t));
+    init_webconfig_ext(&ext, dm, m2_cfg, policy_config);
+
+    pthread_mutex_lock(&s_webconfig_lock);
+    if (init_webconfig() == false) {
+        pthread_mutex_unlock(&s_webconfig_lock);
+        return webconfig_error_init;
+    }
+    start_us = em_lat_hist_t::get_time_us();
+    err = webconfig_easymesh_encode(&s_webconfig, &ext, type, str);
+    if ((err == webconfig_error_none) && (type < webconfig_subdoc_type_max)) {
+        s_encode_hist[type].add(em_lat_hist_t::get_time_us() - start_us);
+    }
+    pthread_mutex_unlock(&s_webconfig_lock);
+
+    return err;
+}
+
+void dm_easy_mesh_agent_t::print_subdoc_stats()
+{
+    em_lat_hist_t *hist;
+    unsigned int i, j;
+
+    pthread_mutex_lock(&s_webconfig_lock);
+    for (i = 0; i < webconfig_subdoc_type_max; i++) {
+        for (j = 0; j < 2; j++) {
+            hist = (j == 0) ? &s_decode_hist[i]:&s_encode_hist[i];
+            if (hist->get_count() == 0) {
+                continue;
+            }
+            printf("%s:%d: subdoc type:%u %s count:%u mean:%lluus p99:%lluus max:%lluus\n", __func__, __LINE__, i,
+                (j == 0) ? "decode":"encode", hist->get_count(), static_cast<unsigned long long>(hist->get_mean_us()),
+                static_cast<unsigned long long>(hist->get_percentile_us(99)),
+                static_cast<unsigned long long>(hist->get_max_us()));
+            hist->reset();
+        }
+    }
+    pthread_mutex_unlock(&s_webconfig_lock);
+}
+
+dm_easy_mesh_agent_t::dm_easy_mesh_agent_t()
+{
+    m_policy_key = 0;
 }
 
 dm_easy_mesh_agent_t::~dm_easy_mesh_agent_t()
@@ -39,7 +39,12 @@
 #include "em_orch_agent.h"
 #include "ec_util.h"
 #include "util.h"
+#include "em_trace.h"
+#include "em_capture.h"
+#include "em_sched.h"
+#include "em_profile.h"
 #include <cjson/cJSON.h>
+#include "cjson_util.h"
 
 #include <string>
 #include <vector>
@@ -60,8 +65,8 @@ void em_agent_t::handle_sta_list(em_bus_event_t *evt)
     em_cmd_t *pcmd[EM_MAX_CMD] = {NULL};
     unsigned int num;
 
-    if ((num = m_data_model.analyze_sta_list(evt, pcmd)) == 0) {
-        printf("analyze_sta_list failed\n");
+    if ((num = m_data_model.analyze_sta_list(evt, pcmd, &m_sta_delta)) == 0) {
+        printf("analyze_sta_list no associated client changes\n");
     } else if (m_orch->submit_commands(pcmd, num) > 0) {
         printf("analyze_sta_list submit complete\n");
     }
@@ -257,6 +262,19 @@ void em_agent_t::handle_m2ctrl_configuration(em_bus_event_t *evt)
     }
 }
 
+bool em_agent_t::defer_subdoc(em_bus_event_t *evt)
+{
+    em_subdoc_name_space_t name;
+
+    // each band has a subdoc of its own, only an update of the same one supersedes it
+    if (cjson_utils::get_top_level_string(reinterpret_cast<char *>(evt->u.raw_buff), evt->data_len,
+            "SubDocName", name, sizeof(name)) == false) {
+        name[0] = 0;
+    }
+
+    return m_orch->defer_event(evt, name);
+}
+
 void em_agent_t::handle_onewifi_private_cb(em_bus_event_t *evt)
 {
     em_cmd_t *pcmd[EM_MAX_CMD] = {NULL};
@@ -268,7 +286,9 @@ void em_agent_t::handle_onewifi_private_cb(em_bus_event_t *evt)
     }
 
     if (m_orch->is_cmd_type_in_progress(evt) == true) {
-        m_agent_cmd->send_result(em_cmd_out_status_prev_cmd_in_progress);
+        if (defer_subdoc(evt) == false) {
+            m_agent_cmd->send_result(em_cmd_out_status_prev_cmd_in_progress);
+        }
     } else if ((num = m_data_model.analyze_onewifi_vap_cb(evt, pcmd)) == 0) {
         printf("analyze_onewifi_vap_cb completed\n");
     } else if (m_orch->submit_commands(pcmd, num) > 0) {
@@ -287,7 +307,9 @@ void em_agent_t::handle_onewifi_mesh_sta_cb(em_bus_event_t *evt)
     }
 
     if (m_orch->is_cmd_type_in_progress(evt) == true) {
-        m_agent_cmd->send_result(em_cmd_out_status_prev_cmd_in_progress);
+        if (defer_subdoc(evt) == false) {
+            m_agent_cmd->send_result(em_cmd_out_status_prev_cmd_in_progress);
+        }
     } else if ((num = m_data_model.analyze_onewifi_vap_cb(evt, pcmd)) == 0) {
         printf("analyze_onewifi_vap_cb completed\n");
     } else if (m_orch->submit_commands(pcmd, num) > 0) {
@@ -306,7 +328,9 @@ void em_agent_t::handle_onewifi_radio_cb(em_bus_event_t *evt)
     }
 
     if (m_orch->is_cmd_type_in_progress(evt) == true) {
-        m_agent_cmd->send_result(em_cmd_out_status_prev_cmd_in_progress);
+        if (defer_subdoc(evt) == false) {
+            m_agent_cmd->send_result(em_cmd_out_status_prev_cmd_in_progress);
+        }
     } else if ((num = m_data_model.analyze_onewifi_radio_cb(evt, pcmd)) == 0) {
         printf("analyze_onewifi_radio_cb completed\n");
     } else if (m_orch->submit_commands(pcmd, num) > 0) {
@@ -457,9 +481,13 @@ void em_agent_t::handle_recv_gas_frame(em_bus_event_t *evt)
         printf("%s:%d: NULL bus event!\n", __func__, __LINE__);
         return;
     }
-    const size_t full_frame_length = evt->data_len;
+    handle_recv_gas_frame(evt->u.raw_buff, evt->data_len);
+}
+
+void em_agent_t::handle_recv_gas_frame(uint8_t *frame, size_t full_frame_length)
+{
     const size_t mgmt_hdr_len = offsetof(struct ieee80211_mgmt, u);
-    ieee80211_mgmt *mgmt_frame = (ieee80211_mgmt *)evt->u.raw_buff;
+    ieee80211_mgmt *mgmt_frame = (ieee80211_mgmt *)frame;
 
     std::string dest_mac_str = util::mac_to_string(mgmt_frame->da);
     // Validate that it is a broadcast frame or we have a node that should have received it
@@ -486,7 +514,7 @@ void em_agent_t::handle_recv_gas_frame(em_bus_event_t *evt)
 
     em_t* al_node = get_al_node();
 
-    auto gas_frame_base = (ec_gas_frame_base_t *)(evt->u.raw_buff + mgmt_hdr_len);
+    auto gas_frame_base = (ec_gas_frame_base_t *)(frame + mgmt_hdr_len);
 
     bool is_wfa_ec_gas = false;
 
@@ -556,13 +584,16 @@ void em_agent_t::handle_recv_gas_frame(em_bus_event_t *evt)
 
 void em_agent_t::handle_recv_wfa_action_frame(em_bus_event_t *evt)
 {
-    uint8_t* mgmt_frame_buff = reinterpret_cast<uint8_t*>(evt->u.raw_buff);
-    size_t frame_len = evt->data_len;
+    handle_recv_wfa_action_frame(evt->u.raw_buff, evt->data_len);
+}
+
+void em_agent_t::handle_recv_wfa_action_frame(uint8_t *buff, size_t frame_len)
+{
+    uint8_t* mgmt_frame_buff = buff;
     unsigned int recv_freq = 0;
 
     // The frequency (and other wifi data) is prepended to the action frame data
-    auto* frame_info = reinterpret_cast<wifi_frame_t*>(evt->u.raw_buff);
-    em_printfout("Received WFA action frame at frequency %d MHz", frame_info->recv_freq);
+    auto* frame_info = reinterpret_cast<wifi_frame_t*>(buff);
 
     mgmt_frame_buff += sizeof(wifi_frame_t);
     frame_len       -= sizeof(wifi_frame_t);
@@ -587,7 +618,6 @@ void em_agent_t::handle_recv_wfa_action_frame(em_bus_event_t *evt)
     printf("%s:%d: Received WFA action frame: Full Length: %d, VS Action Data Length: %d\n", __func__, __LINE__, frame_len, vs_data_len);
 
     std::string dest_mac_str = util::mac_to_string(mgmt_frame->da);
-    em_printfout("Dest Mac Str: %s", dest_mac_str.c_str());
 
     // Validate either this is a broadcast frame or we have a node that should have received it
     // even though (for DPP_OUI) we are processing it all in the AL node
@@ -752,16 +782,31 @@ void em_agent_t::handle_set_policy(em_bus_event_t *evt)
 }
 
 void em_agent_t::handle_beacon_report(em_bus_event_t *evt)
+{
+    // merged even while a response is in progress, it is sent with the STA's next one
+    if (m_data_model.analyze_beacon_report(evt, get_beacon_agg()) == 0) {
+        printf("analyze_beacon_report failed\n");
+    }
+    submit_beacon_report();
+}
+
+void em_agent_t::submit_beacon_report()
 {
     em_cmd_t *pcmd[EM_MAX_CMD] = {NULL};
+    em_beacon_report_agg_report_t report;
     unsigned int num = 0;
 
-    if (m_orch->is_cmd_type_in_progress(evt) == true) {
-        printf("analyze_beacon_report in progress\n");
-    } else if ((num = m_data_model.analyze_beacon_report(evt, pcmd)) == 0) {
-        printf("analyze_beacon_report failed\n");
+    // one response at a time as before, the others wait in the aggregator for the next tick
+    if (m_orch->get_cmd_count(em_cmd_type_beacon_report) != 0) {
+        return;
+    }
+    if (get_beacon_agg()->pop_ready(em_timer_wheel_t::get_time_ms(), &report) == false) {
+        return;
+    }
+    if ((num = static_cast<unsigned int>(m_data_model.create_beacon_report_cmd(&report, pcmd))) == 0) {
+        printf("create_beacon_report_cmd failed\n");
     } else if (m_orch->submit_commands(pcmd, num) > 0) {
-        printf("submitted beacon report cmd for orch\n");
+        printf("submitted beacon report cmd for orch, %u reports\n", report.count);
     }
 }
 
@@ -886,13 +931,15 @@ void em_agent_t::handle_bus_event(em_bus_event_t *evt)
 void em_agent_t::handle_event(em_event_t *evt)
 {
     switch(evt->type) {
-        case em_event_type_frame:
+        case em_event_type_frame: {
+            EM_PROFILE_SCOPE(em_profile_domain_event, evt->type);
             handle_frame_event(&evt->u.fevt);
-            break;
+        } break;
 
-        case em_event_type_bus:
+        case em_event_type_bus: {
+            EM_PROFILE_SCOPE(em_profile_domain_bus, evt->u.bevt.type);
             handle_bus_event(&evt->u.bevt);
-            break;
+        } break;
 
         default:
             break;
@@ -902,6 +949,22 @@ void em_agent_t::handle_event(em_event_t *evt)
 
 void em_agent_t::handle_5s_tick()
 {
+    static unsigned int ticks = 0;
+    static unsigned long long bus_lost = 0;
+    unsigned long long lost = m_bus_dispatch.get_lost();
+
+    // the agent has no perf stats command, the timings go to the log every minute
+    if ((++ticks % 12) == 0) {
+        dm_easy_mesh_agent_t::print_subdoc_stats();
+        m_bus_dispatch.print_stats();
+#ifdef EM_PROFILE
+        em_profile_t::print(EM_PROFILE_TOP_N, em_cmd_t::get_profile_type_str);
+#endif
+    } else if (lost != bus_lost) {
+        // callbacks dropped or coalesced since the last tick, the handlers fall behind the bus
+        m_bus_dispatch.print_stats();
+    }
+    bus_lost = lost;
 #ifdef SCAN_RESULT_TEST
 	unsigned char *buff = NULL;
 	em_cmd_params_t	params;
@@ -919,10 +982,16 @@ void em_agent_t::handle_2s_tick()
 
 void em_agent_t::handle_1s_tick()
 {
-
+    get_blocklist()->expire(em_timer_wheel_t::get_time_ms());
 }
 
 void em_agent_t::handle_500ms_tick()
+{
+    submit_beacon_report();
+    m_orch->handle_timeout();
+}
+
+void em_agent_t::handle_orch_kick()
 {
     m_orch->handle_timeout();
 }
@@ -1153,13 +1222,69 @@ void em_agent_t::input_listener()
     io(NULL);
 }
 
+// bus event types of the payloads handle_bus_payload() passes on as they are
+static em_bus_event_type_t s_bus_payload_types[em_agent_bus_cb_max] = {
+    em_bus_event_type_none,
+    em_bus_event_type_sta_list,
+    em_bus_event_type_none,
+    em_bus_event_type_none,
+    em_bus_event_type_beacon_report,
+    em_bus_event_type_assoc_status,
+    em_bus_event_type_bss_info,
+    em_bus_event_type_ap_metrics_report,
+    em_bus_event_type_none,
+    em_bus_event_type_recv_csa_beacon_frame,
+};
+
+void em_agent_t::init_bus_dispatch()
+{
+    // configuration subdocs and periodic reports are superseded by the next one, events are not
+    m_bus_channels[em_agent_bus_cb_onewifi] = m_bus_dispatch.add_channel("onewifi", em_bus_dispatch_policy_coalesce,
+            16, handle_onewifi_payload, get_subdoc_key, NULL);
+    m_bus_channels[em_agent_bus_cb_sta] = m_bus_dispatch.add_channel("sta_list", em_bus_dispatch_policy_coalesce,
+            4, handle_bus_payload, NULL, &s_bus_payload_types[em_agent_bus_cb_sta]);
+    m_bus_channels[em_agent_bus_cb_assoc_stats] = m_bus_dispatch.add_channel("assoc_stats", em_bus_dispatch_policy_coalesce,
+            8, handle_assoc_stats_payload, get_subdoc_key, NULL);
+    m_bus_channels[em_agent_bus_cb_channel_scan] = m_bus_dispatch.add_channel("channel_scan", em_bus_dispatch_policy_drop_oldest,
+            16, handle_channel_scan_payload, NULL, NULL);
+    m_bus_channels[em_agent_bus_cb_beacon_report] = m_bus_dispatch.add_channel("beacon_report", em_bus_dispatch_policy_drop_oldest,
+            16, handle_bus_payload, NULL, &s_bus_payload_types[em_agent_bus_cb_beacon_report]);
+    m_bus_channels[em_agent_bus_cb_assoc_status] = m_bus_dispatch.add_channel("assoc_status", em_bus_dispatch_policy_drop_newest,
+            64, handle_bus_payload, NULL, &s_bus_payload_types[em_agent_bus_cb_assoc_status]);
+    m_bus_channels[em_agent_bus_cb_bss_info] = m_bus_dispatch.add_channel("bss_info", em_bus_dispatch_policy_drop_newest,
+            16, handle_bus_payload, NULL, &s_bus_payload_types[em_agent_bus_cb_bss_info]);
+    m_bus_channels[em_agent_bus_cb_ap_metrics] = m_bus_dispatch.add_channel("ap_metrics", em_bus_dispatch_policy_drop_oldest,
+            16, handle_bus_payload, NULL, &s_bus_payload_types[em_agent_bus_cb_ap_metrics]);
+    m_bus_channels[em_agent_bus_cb_mgmt_action] = m_bus_dispatch.add_channel("mgmt_action", em_bus_dispatch_policy_drop_newest,
+            64, handle_mgmt_action_payload, NULL, NULL);
+    m_bus_channels[em_agent_bus_cb_csa_beacon] = m_bus_dispatch.add_channel("csa_beacon", em_bus_dispatch_policy_drop_newest,
+            16, handle_bus_payload, NULL, &s_bus_payload_types[em_agent_bus_cb_csa_beacon]);
+
+    m_bus_dispatch.start();
+}
+
+bool em_agent_t::post_bus_payload(em_agent_bus_cb_t cb, raw_data_t *data)
+{
+    return m_bus_dispatch.post(m_bus_channels[cb], data->raw_data.bytes, data->raw_data_len);
+}
+
+bool em_agent_t::get_subdoc_key(const unsigned char *data, unsigned int len, char *key, unsigned int key_len)
+{
+    return cjson_utils::get_top_level_string(reinterpret_cast<const char *>(data), len, "SubDocName", key, key_len);
+}
+
+void em_agent_t::handle_bus_payload(unsigned char *data, unsigned int len, void *arg)
+{
+    g_agent.io_process(*static_cast<em_bus_event_type_t *>(arg), data, len);
+}
+
 int em_agent_t::bss_info_cb(char *event_name, raw_data_t *data, void *userData)
 {
     if (data == nullptr) {
         em_printfout("NULL data from OneWifi callback!");
         return -1;
     }
-    g_agent.io_process(em_bus_event_type_bss_info, reinterpret_cast<unsigned char *>(data->raw_data.bytes), data->raw_data_len);
+    g_agent.post_bus_payload(em_agent_bus_cb_bss_info, data);
     return 1;
 }
 
@@ -1169,29 +1294,38 @@ int em_agent_t::association_status_cb(char *event_name, raw_data_t *data, void *
         em_printfout("NULL data from OneWiFi callback!");
         return -1;
     }
-    g_agent.io_process(em_bus_event_type_assoc_status, reinterpret_cast<unsigned char *>(data->raw_data.bytes), data->raw_data_len);
+    g_agent.post_bus_payload(em_agent_bus_cb_assoc_status, data);
     return 1;
 }
 
 int em_agent_t::channel_scan_cb(char *event_name, raw_data_t *data, void *userData)
 {
     (void)userData;
+
+    g_agent.post_bus_payload(em_agent_bus_cb_channel_scan, data);
+
+    return 1;
+}
+
+void em_agent_t::handle_channel_scan_payload(unsigned char *data, unsigned int len, void *arg)
+{
     cJSON *json, *channel_stats_arr;
+    bool empty = false;
 
-    json = cJSON_Parse((const char *)data->raw_data.bytes);
+    json = cJSON_Parse(reinterpret_cast<const char *>(data));
     if (json != NULL) {
         channel_stats_arr = cJSON_GetObjectItem(json, "ChannelScanResponse");
         if ((channel_stats_arr == NULL) && (cJSON_IsObject(channel_stats_arr) == false)) {
-            return -1;
-        }
-        if (cJSON_IsArray(channel_stats_arr) && cJSON_GetArraySize(channel_stats_arr) == 0) {
-            return -1;
+            empty = true;
+        } else if (cJSON_IsArray(channel_stats_arr) && cJSON_GetArraySize(channel_stats_arr) == 0) {
+            empty = true;
         }
+        cJSON_Delete(json);
     }
 
-    g_agent.io_process(em_bus_event_type_scan_result, (unsigned char *)data->raw_data.bytes, data->raw_data_len);
-
-    return 1;
+    if (empty == false) {
+        g_agent.io_process(em_bus_event_type_scan_result, data, len);
+    }
 }
 
 int em_agent_t::ap_metrics_report_cb(char *event_name, raw_data_t *data, void *userData)
@@ -1199,7 +1333,7 @@ int em_agent_t::ap_metrics_report_cb(char *event_name, raw_data_t *data, void *u
     //printf("%s:%d Received Frame data for event [%s] and data :\n%s\n", __func__, __LINE__, event_name, data->raw_data.bytes);
     (void)userData;
 
-    g_agent.io_process(em_bus_event_type_ap_metrics_report, (unsigned char *)data->raw_data.bytes, data->raw_data_len);
+    g_agent.post_bus_payload(em_agent_bus_cb_ap_metrics, data);
 
     return 0;
 }
@@ -1209,21 +1343,60 @@ int em_agent_t::beacon_report_cb(char *event_name, raw_data_t *data, void *userD
     //printf("%s:%d Received Frame data for event [%s] and data :\n%s\n", __func__, __LINE__, event_name, data->raw_data.bytes);
     (void)userData;
 
-    g_agent.io_process(em_bus_event_type_beacon_report, (unsigned char *)data->raw_data.bytes, data->raw_data_len);
+    g_agent.post_bus_payload(em_agent_bus_cb_beacon_report, data);
 
     return 0;
 }
 
+void em_agent_t::push_action_frame(em_bus_event_type_t type, uint8_t *data, unsigned int len)
+{
+    em_t *al_node;
+
+    // DPP and GAS frames only concern the EC manager, which runs on the home worker of the AL node
+    if (((al_node = get_al_node()) != NULL) && (push_node_action_frame(al_node, data, len) == true)) {
+        return;
+    }
+
+    if (type == em_bus_event_type_recv_gas_frame) {
+        io_process(type, data + sizeof(wifi_frame_t), len - static_cast<unsigned int>(sizeof(wifi_frame_t)));
+    } else {
+        io_process(type, data, len);
+    }
+}
+
+void em_agent_t::handle_node_action_frame(em_t *em, unsigned char *frame, unsigned int len)
+{
+    struct ieee80211_mgmt *mgmt_frame = reinterpret_cast<struct ieee80211_mgmt *>(frame + sizeof(wifi_frame_t));
+
+    // queued as received from OneWifi, the wifi_frame_t first
+    if (mgmt_frame->u.action.u.vs_public_action.action == WLAN_PA_VENDOR_SPECIFIC) {
+        handle_recv_wfa_action_frame(frame, len);
+    } else {
+        handle_recv_gas_frame(frame + sizeof(wifi_frame_t), len - sizeof(wifi_frame_t));
+    }
+}
+
 int em_agent_t::mgmt_action_frame_cb(char *event_name, raw_data_t *data, void *userData)
 {
+    (void)event_name;
     (void)userData;
-    em_printfout("Received Frame data for event [%s] and data of len: %d",event_name, data->raw_data_len);
 
     EM_ASSERT_MSG_TRUE(data != NULL && data->raw_data.bytes != NULL && data->raw_data_len > 0, -1,
                    "Invalid data in mgmt_action_frame_cb");
 
-    uint8_t* mgmt_frame_data = (uint8_t*)data->raw_data.bytes;
-    unsigned int mgmt_hdr_len = data->raw_data_len;
+    g_agent.post_bus_payload(em_agent_bus_cb_mgmt_action, data);
+
+    return 0;
+}
+
+void em_agent_t::handle_mgmt_action_payload(unsigned char *data, unsigned int len, void *arg)
+{
+    if (len < sizeof(wifi_frame_t)) {
+        return;
+    }
+
+    uint8_t* mgmt_frame_data = data;
+    unsigned int mgmt_hdr_len = len;
 
     // The frequency (and other wifi data) is prepended to the action frame data
     mgmt_frame_data += sizeof(wifi_frame_t);
@@ -1239,112 +1412,111 @@ int em_agent_t::mgmt_action_frame_cb(char *event_name, raw_data_t *data, void *u
     if (mgmt_frame->u.action.u.bss_tm_resp.action == WLAN_WNM_BTM_RESPONSE) {
         g_agent.io_process(em_bus_event_type_btm_response, mgmt_frame_data, mgmt_hdr_len);
 
-        return 1;
+        return;
     }
 
     if (mgmt_frame->u.action.u.vs_public_action.action == WLAN_PA_VENDOR_SPECIFIC) {
         // printf("Received Vendor Specific Public Action Frame\n");
         uint8_t wfa_oui[3] = {0x50, 0x6F, 0x9A};
         if (!memcmp(mgmt_frame->u.action.u.vs_public_action.oui, wfa_oui, sizeof(wfa_oui))){
-            // Push WFA action frame back to main thread
             // Push all data to pass frequency as well
-            g_agent.io_process(em_bus_event_type_recv_wfa_action_frame, reinterpret_cast<uint8_t*>(data->raw_data.bytes), data->raw_data_len);
+            g_agent.push_action_frame(em_bus_event_type_recv_wfa_action_frame, data, len);
         }
     }
 
     if (mgmt_frame->u.action.u.public_action.action >= WLAN_PA_GAS_INITIAL_REQ &&
         mgmt_frame->u.action.u.public_action.action <= WLAN_PA_GAS_COMEBACK_RESP) {
-        printf("%s:%d: GAS frame rx'd\n", __func__, __LINE__);
-        g_agent.io_process(em_bus_event_type_recv_gas_frame, mgmt_frame_data, mgmt_hdr_len);
+        g_agent.push_action_frame(em_bus_event_type_recv_gas_frame, data, len);
     }
-
-    return 0;
 }
 
 int em_agent_t::assoc_stats_cb(char *event_name, raw_data_t *data, void *userData)
 {
     (void)userData;
     //printf("%s:%d recv data:\r\n%s\r\n", __func__, __LINE__, (char *)data->raw_data.bytes);
-    cJSON *json, *assoc_stats_arr;
+    g_agent.post_bus_payload(em_agent_bus_cb_assoc_stats, data);
 
-    json = cJSON_Parse((const char *)data->raw_data.bytes);
-    if (json != NULL) {
-        cJSON *subdoc_name = cJSON_GetObjectItemCaseSensitive(json, "SubDocName");
-        if ((strcmp(subdoc_name->valuestring, "Easymesh STA link metrics") == 0)) {
+    return 1;
+}
+
+void em_agent_t::handle_assoc_stats_payload(unsigned char *data, unsigned int len, void *arg)
+{
+    const char *json = reinterpret_cast<const char *>(data), *end = json + len, *assoc_stats;
+    em_subdoc_name_space_t subdoc_name;
+
+    // the subdoc is parsed once, by the webconfig decode of the handler
+    if (cjson_utils::get_top_level_string(json, len, "SubDocName", subdoc_name, sizeof(subdoc_name)) == true) {
+        if ((strcmp(subdoc_name, "Easymesh STA link metrics") == 0)) {
             printf("%s:%d Found SubDocName: Easymesh STA link metrics\n", __func__, __LINE__);
-        } else if ((strcmp(subdoc_name->valuestring, "AssociatedDeviceStats") == 0)) {
+        } else if ((strcmp(subdoc_name, "AssociatedDeviceStats") == 0)) {
             printf("%s:%d Found SubDocName: AssociatedDeviceStats\n", __func__, __LINE__);
-            assoc_stats_arr = cJSON_GetObjectItem(json, "AssociatedDeviceStats");
-            if ((assoc_stats_arr == NULL) && (cJSON_IsObject(assoc_stats_arr) == false)) {
-                return -1;
+            assoc_stats = cjson_utils::find_top_level_value(json, len, "AssociatedDeviceStats");
+            if (assoc_stats == NULL) {
+                return;
             }
-            if (cJSON_IsArray(assoc_stats_arr) && cJSON_GetArraySize(assoc_stats_arr) == 0) {
+            if ((*assoc_stats == '[') && (cjson_utils::skip_space(assoc_stats + 1, end) < end) &&
+                    (*cjson_utils::skip_space(assoc_stats + 1, end) == ']')) {
                 printf("%s:%d AssociatedDeviceStats is NULL\n", __func__, __LINE__);
-                return -1;
+                return;
             }
         }
     }
 
-    g_agent.io_process(em_bus_event_type_sta_link_metrics, (unsigned char *)data->raw_data.bytes, data->raw_data_len);
-    cJSON_Delete(json);
-
-    return 1;
+    g_agent.io_process(em_bus_event_type_sta_link_metrics, data, len);
 }
 
 void em_agent_t::sta_cb(char *event_name, raw_data_t *data, void *userData)
 {
     (void)userData;
     //printf("%s:%d Recv data from onewifi:\r\n%s\r\n", __func__, __LINE__, (char *)data->raw_data.bytes);
-    g_agent.io_process(em_bus_event_type_sta_list, (unsigned char *)data->raw_data.bytes, data->raw_data_len);
+    g_agent.post_bus_payload(em_agent_bus_cb_sta, data);
 
 }
 
 void em_agent_t::onewifi_cb(char *event_name, raw_data_t *data, void *userData)
 {
         (void)userData;
-	const char *json_data = (char *)data->raw_data.bytes;
-	cJSON *json = cJSON_Parse(json_data);
 
 	//printf("%s:%dRecv data from onewifi:\r\n%s\r\n", __func__, __LINE__, (char *)data->raw_data.bytes);
+    g_agent.post_bus_payload(em_agent_bus_cb_onewifi, data);
+}
 
-	if (json == NULL) {
-		printf("%s:%d Error parsing JSON\n", __func__, __LINE__);
-        return;
-	}
-    cJSON *subdoc_name = cJSON_GetObjectItemCaseSensitive(json, "SubDocName");
-    if (!cJSON_IsString(subdoc_name) || (subdoc_name->valuestring == NULL)) {
-        cJSON_Delete(json);
+void em_agent_t::handle_onewifi_payload(unsigned char *data, unsigned int len, void *arg)
+{
+	const char *json_data = reinterpret_cast<const char *>(data);
+    em_subdoc_name_space_t subdoc_name;
+
+    // only the name is needed for the dispatch, the handler decodes the subdoc
+    if (cjson_utils::get_top_level_string(json_data, len, "SubDocName", subdoc_name, sizeof(subdoc_name)) == false) {
+		printf("%s:%d SubDocName not found\n", __func__, __LINE__);
         return;
     }
 
-    if ((strcmp(subdoc_name->valuestring, "private") == 0) || (strcmp(subdoc_name->valuestring, "Vap_6G") == 0) ||
-        (strcmp(subdoc_name->valuestring, "Vap_5G") == 0) || (strcmp(subdoc_name->valuestring, "Vap_2.4G") == 0)) {
+    if ((strcmp(subdoc_name, "private") == 0) || (strcmp(subdoc_name, "Vap_6G") == 0) ||
+        (strcmp(subdoc_name, "Vap_5G") == 0) || (strcmp(subdoc_name, "Vap_2.4G") == 0)) {
         printf("%s:%d Found SubDocName: private\n", __func__, __LINE__);
-        g_agent.io_process(em_bus_event_type_onewifi_private_cb, (unsigned char *)data->raw_data.bytes, data->raw_data_len);
+        g_agent.io_process(em_bus_event_type_onewifi_private_cb, data, len);
 
-    } else if ((strcmp(subdoc_name->valuestring, "radio") == 0) || (strcmp(subdoc_name->valuestring, "radio_6G") == 0) ||
-        (strcmp(subdoc_name->valuestring, "radio_5G") == 0) || (strcmp(subdoc_name->valuestring, "radio_2.4G") == 0)) {
+    } else if ((strcmp(subdoc_name, "radio") == 0) || (strcmp(subdoc_name, "radio_6G") == 0) ||
+        (strcmp(subdoc_name, "radio_5G") == 0) || (strcmp(subdoc_name, "radio_2.4G") == 0)) {
         printf("%s:%d Found SubDocName: radio\n", __func__, __LINE__);
-        g_agent.io_process(em_bus_event_type_onewifi_radio_cb, (unsigned char *)data->raw_data.bytes, data->raw_data_len);
+        g_agent.io_process(em_bus_event_type_onewifi_radio_cb, data, len);
 
-    } else if ((strcmp(subdoc_name->valuestring, "mesh_sta") == 0) || 
-               (strcmp(subdoc_name->valuestring, "mesh backhaul sta") == 0)) {
+    } else if ((strcmp(subdoc_name, "mesh_sta") == 0) || 
+               (strcmp(subdoc_name, "mesh backhaul sta") == 0)) {
         printf("%s:%d Found SubDocName: mesh_sta\n", __func__, __LINE__);
-        g_agent.io_process(em_bus_event_type_onewifi_mesh_sta_cb, (unsigned char *)data->raw_data.bytes, data->raw_data_len);
+        g_agent.io_process(em_bus_event_type_onewifi_mesh_sta_cb, data, len);
 
     } else {
-        em_printfout("SubDocName (%s) not matching private, mesh_sta, or radio", subdoc_name->valuestring);
+        em_printfout("SubDocName (%s) not matching private, mesh_sta, or radio", subdoc_name);
     }
-
-    cJSON_Delete(json);
-
 }
 
 int em_agent_t::mgmt_csa_beacon_frame_cb(char *event_name, raw_data_t *data, void *userData)
 {
     printf("%s:%d Received Frame data for event [%s] and data of len:\n%d\n", __func__, __LINE__, event_name, data->raw_data_len);
 
-    g_agent.io_process(em_bus_event_type_recv_csa_beacon_frame, (unsigned char *)data->raw_data.bytes, data->raw_data_len);
+    g_agent.post_bus_payload(em_agent_bus_cb_csa_beacon, data);
     return 1;
 }
 
@@ -1363,6 +1535,9 @@ int em_agent_t::data_model_init(const char *data_model_path)
 
     m_agent_cmd = new em_cmd_agent_t();
 
+    // before the listener subscribes to the bus
+    init_bus_dispatch();
+
     return 0;
 }
 
@@ -1378,7 +1553,6 @@ em_t *em_agent_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em
     em_cmdu_t *cmdu;
     em_interface_t intf;
     em_freq_band_t band = em_freq_band_unknown;
-    dm_easy_mesh_t *dm;
     em_t *em = NULL;
     mac_address_t ruid;
     em_profile_type_t profile;
@@ -1387,7 +1561,6 @@ em_t *em_agent_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em
     mac_address_t client_mac;
     bool found = false;
     em_string_t al_mac_str;
-    em_bss_info_t *em_bss = NULL;
 
     assert(len > ((sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))));
     if (len < ((sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)))) {
@@ -1402,11 +1575,13 @@ em_t *em_agent_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em
    
     cmdu = (em_cmdu_t *)(data + sizeof(em_raw_hdr_t));
 
+    // index the TLVs once, every lookup below is served from it
+    em_msg_t msg(data + (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)), len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)));
+
     switch (htons(cmdu->type)) {
 	case em_msg_type_autoconf_resp:
 		found = false;
-		if (em_msg_t(data + (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)),
-				len - (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))).get_freq_band(&band) == false) {
+		if (msg.get_freq_band(&band) == false) {
 			printf("%s:%d: Could not find frequency band\n", __func__, __LINE__);
 			return NULL;
 		}
@@ -1438,20 +1613,17 @@ em_t *em_agent_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em
 		break;
 	case em_msg_type_autoconf_renew:
 		found = false;
-		if (em_msg_t(data + (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)),
-				len - (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))).get_freq_band(&band) == false) {
+		if (msg.get_freq_band(&band) == false) {
 			printf("%s:%d: Could not find frequency band\n", __func__, __LINE__);
 			return NULL;
 		}
 
-		if (em_msg_t(data + (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)),
-			len - (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))).get_al_mac_address(ruid) == false) {
+		if (msg.get_al_mac_address(ruid) == false) {
 			printf("%s:%d: Could not find radio_id for em_msg_type_autoconf_renew\n", __func__, __LINE__);
 			return NULL;
 		}
-		dm_easy_mesh_t::macbytes_to_string(ruid, al_mac_str);
-		strcat(al_mac_str, "_al");
-		if ((em = (em_t *)hash_map_get(m_em_map, al_mac_str)) != NULL) {
+		if ((em = get_al_node_by_mac(ruid)) != NULL) {
+			dm_easy_mesh_t::macbytes_to_string(ruid, al_mac_str);
 			printf("%s:%d: Found existing AL MAC:%s\n", __func__, __LINE__, al_mac_str);
 		} else {
 			return NULL;
@@ -1477,13 +1649,12 @@ em_t *em_agent_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em
 		}
 		break;
 		case em_msg_type_autoconf_wsc:
-			if (em_msg_t(data + (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)),
-                	len - (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))).get_radio_id(&ruid) == false) {
+			if (msg.get_radio_id(&ruid) == false) {
 				return NULL;
 			}
 
-			dm_easy_mesh_t::macbytes_to_string(ruid, mac_str1);
-        	if ((em = (em_t *)hash_map_get(m_em_map, mac_str1)) != NULL) {
+        	if ((em = get_node_by_ruid(ruid)) != NULL) {
+				dm_easy_mesh_t::macbytes_to_string(ruid, mac_str1);
             	printf("%s:%d: Found existing radio:%s\n", __func__, __LINE__, mac_str1);
         	} else {
 				return NULL;
@@ -1493,14 +1664,11 @@ em_t *em_agent_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em
         case em_msg_type_ap_cap_query:
         case em_msg_type_topo_query:
         case em_msg_type_channel_pref_query:
-            em_string_t al_mac_str;
-            dm_easy_mesh_t::macbytes_to_string(hdr->dst, al_mac_str);
-            strcat(al_mac_str, "_al");
-            if ((em = (em_t *)hash_map_get(m_em_map, al_mac_str)) != NULL) {
-                em_printfout("Received query message, found al_mac agent:%s", al_mac_str);
+            if ((em = get_al_node_by_mac(hdr->dst)) != NULL) {
+                em_printfout("Received query message, found al_mac agent:" MACSTRFMT, MAC2STR(hdr->dst));
             } else {
-                em_printfout("Discarding query message, al_mac agent:%s not found",
-                    al_mac_str);
+                em_printfout("Discarding query message, al_mac agent:" MACSTRFMT " not found",
+                    MAC2STR(hdr->dst));
                 return NULL;
             }
             break;
@@ -1509,14 +1677,13 @@ em_t *em_agent_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em
             break;
 		
         case  em_msg_type_channel_sel_req:
-            if (em_msg_t(data + (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)),
-                	len - (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))).get_radio_id(&ruid) == false) {
+            if (msg.get_radio_id(&ruid) == false) {
                 printf("%s:%d: Could not find radio_id for em_msg_type_channel_pref_query\n", __func__, __LINE__);
                 return NULL;
             }
 
             dm_easy_mesh_t::macbytes_to_string(ruid, mac_str1);
-            if ((em = (em_t *)hash_map_get(m_em_map, mac_str1)) != NULL) {
+            if ((em = get_node_by_ruid(ruid)) != NULL) {
                 if (em->is_al_interface_em() == false) {
                     printf("%s:%d: Received em_msg_type_channel_sel_req, found existing radio:%s\n", __func__, __LINE__, mac_str1);
                 } else {
@@ -1534,25 +1701,16 @@ em_t *em_agent_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em
             break;
 
         case  em_msg_type_client_cap_query:
-            if (em_msg_t(data + (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)),
-                len - (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))).get_bss_id(&bss_mac) == false) {
+            if (msg.get_bss_id(&bss_mac) == false) {
                 printf("%s:%d: Could not find BSS mac for em_msg_type_client_cap_query\n", __func__, __LINE__);
                 return NULL;
             }
 
             dm_easy_mesh_t::macbytes_to_string(bss_mac, mac_str1);
 
-            em = static_cast<em_t *> (hash_map_get_first(m_em_map));
-            while (em != NULL) {
-                dm = em->get_data_model();
-                em_bss = dm->get_bss_info_with_mac(bss_mac);
-                if (memcmp(em_bss->ruid.mac, em->get_radio_interface_mac(), sizeof(bssid_t)) == 0) {
-                    printf("%s:%d: Received client cap query: found radio for bss:%s\n", __func__, __LINE__, mac_str1);
-                    break;
-                }
-                em = static_cast<em_t *> (hash_map_get_next(m_em_map, em));
-            }
-            if(em == NULL){
+            if ((em = get_node_by_bssid(bss_mac)) != NULL) {
+                printf("%s:%d: Received client cap query: found radio for bss:%s\n", __func__, __LINE__, mac_str1);
+            } else {
                 dm_easy_mesh_t::macbytes_to_string(bss_mac, mac_str2);
                 printf("%s:%d: Received client cap query: Could not find radio:%s of bss:%s\n", __func__, __LINE__, mac_str1, mac_str2);
             }
@@ -1596,14 +1754,22 @@ em_t *em_agent_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em
             printf("%s:%d: Sending Client BTM REPORT\n", __func__, __LINE__);
             break;
 
+        case em_msg_type_client_assoc_ctrl_req:
+            em = (em_t *)hash_map_get_first(m_em_map);
+            while (em != NULL) {
+                if ((em->is_al_interface_em() == false)) {
+                    break;
+                }
+                em = (em_t *)hash_map_get_next(m_em_map, em);
+            }
+            break;
+
 		case em_msg_type_channel_scan_req:
-			if (em_msg_t(data + (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)),
-                	len - (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))).get_radio_id(&ruid) == false) {
+			if (msg.get_radio_id(&ruid) == false) {
 				return NULL;
 			}
 
-			dm_easy_mesh_t::macbytes_to_string(ruid, mac_str1);
-        	if ((em = (em_t *)hash_map_get(m_em_map, mac_str1)) == NULL) {
+        	if ((em = get_node_by_ruid(ruid)) == NULL) {
 				return NULL;
 			}
 			
@@ -1642,6 +1808,8 @@ em_t *em_agent_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em
         case em_msg_type_ap_mld_config_resp:
         case em_msg_type_beacon_metrics_query:
         case em_msg_type_ap_metrics_rsp:
+        case em_msg_type_unassoc_sta_link_metrics_rsp:
+        case em_msg_type_bh_steering_rsp:
             break;
 
         case em_msg_type_proxied_encap_dpp:
@@ -1652,6 +1820,8 @@ em_t *em_agent_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em
         case em_msg_type_1905_encap_eapol:
         case em_msg_type_bss_config_rsp:
         case em_msg_type_agent_list:
+        case em_msg_type_unassoc_sta_link_metrics_query:
+        case em_msg_type_bh_steering_req:
             em = al_em;
             break;
         case em_msg_type_topo_disc:
@@ -1826,7 +1996,11 @@ bool em_agent_t::try_start_dpp_onboarding()  {
 
 em_agent_t::em_agent_t()
 {
+    unsigned int i;
 
+    for (i = 0; i < em_agent_bus_cb_max; i++) {
+        m_bus_channels[i] = -1;
+    }
 }
 
 em_agent_t::~em_agent_t()
@@ -1868,7 +2042,7 @@ int main(int argc, const char *argv[])
     }
 
     if ((args.size() == 1) && (args[0] == "--help" || args[0] == "-h")) {
-        printf("Usage: %s [data-model-path] [--interface=al_mac_iface] [--start-dpp-onboard] [--regen-dpp-uri]\n", argv[0]);
+        printf("Usage: %s [data-model-path] [--interface=al_mac_iface] [--start-dpp-onboard] [--regen-dpp-uri] [--capture=file.pcapng] [--stack-size=role=KB,...] [--sched=role:option[:option...],...]\n", argv[0]);
         return 0;
     }
 
@@ -1902,6 +2076,26 @@ int main(int argc, const char *argv[])
             g_agent.ethernet_onboarding = true;
             continue;
         }
+        if (arg.find("--capture=") == 0) {
+            if (em_capture_t::start(arg.substr(strlen("--capture=")).c_str()) != 0) {
+                return -1;
+            }
+            continue;
+        }
+        if (arg.find("--stack-size=") == 0) {
+            if (em_stack_t::configure(arg.substr(strlen("--stack-size=")).c_str()) != 0) {
+                printf("Invalid stack sizes: %s\n", arg.c_str());
+                return -1;
+            }
+            continue;
+        }
+        if (arg.find("--sched=") == 0) {
+            if (em_sched_t::configure(arg.substr(strlen("--sched=")).c_str()) != 0) {
+                printf("Invalid thread scheduling: %s\n", arg.c_str());
+                return -1;
+            }
+            continue;
+        }
         if (data_model_path.empty()) {
             data_model_path = arg;
             continue;
@@ -1914,12 +2108,15 @@ int main(int argc, const char *argv[])
         printf("Using data model path: %s\n", data_model_path.c_str());
     }
 
+    em_trace_t::install_crash_handler("/tmp/emAgent.trace");
+
     if (g_agent.init(data_model_path.empty() ? NULL : data_model_path.c_str()) == 0) {
 #ifdef AL_SAP
     g_sap = g_agent.al_sap_register();
 #endif
         g_agent.start();
     }
+    em_capture_t::stop();
 
     return 0;
 }
@@ -0,0 +1,725 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <linux/if_packet.h>
+#include <openssl/rand.h>
+#include "em_mesh_sim.h"
+#include "em_msg.h"
+
+#define EM_MESH_SIM_SSID    "em_mesh_sim"
+
+static uint64_t get_time_ms()
+{
+    return em_lat_hist_t::get_time_us() / 1000;
+}
+
+static unsigned int add_attr(unsigned char *buff, unsigned short id, const void *val, unsigned short len)
+{
+    data_elem_attr_t *attr = reinterpret_cast<data_elem_attr_t *> (buff);
+
+    attr->id = htons(id);
+    attr->len = htons(len);
+    memcpy(attr->val, val, len);
+
+    return static_cast<unsigned int> (sizeof(data_elem_attr_t)) + len;
+}
+
+void em_mesh_sim_t::get_mac(unsigned int agent, int radio, int sta, bool bss, unsigned char *mac)
+{
+    // locally administered, stations apart from the agents
+    mac[0] = (sta < 0) ? 0x02:0x06;
+    mac[1] = 0x5e;
+    mac[2] = static_cast<unsigned char> (agent >> 8);
+    mac[3] = static_cast<unsigned char> (agent);
+    mac[4] = (radio < 0) ? 0:static_cast<unsigned char> (radio + 1);
+    mac[5] = (sta >= 0) ? static_cast<unsigned char> (sta + 1):((bss == true) ? 1:0);
+}
+
+int em_mesh_sim_t::get_agent_index(const unsigned char *al_mac)
+{
+    unsigned int idx;
+
+    if ((al_mac[0] != 0x02) || (al_mac[1] != 0x5e) || (al_mac[4] != 0) || (al_mac[5] != 0)) {
+        return -1;
+    }
+
+    idx = (static_cast<unsigned int> (al_mac[2]) << 8) | al_mac[3];
+
+    return (idx < m_agents.size()) ? static_cast<int> (idx):-1;
+}
+
+int em_mesh_sim_t::build_autoconf_search(unsigned int agent)
+{
+    mac_address_t multi_addr = {0x01, 0x80, 0xc2, 0x00, 0x00, 0x13};
+    mac_address_t al_mac;
+    unsigned char role = 0, band = em_freq_band_24, profile = em_profile_type_2;
+    unsigned char service[2] = {1, em_service_type_agent};
+    unsigned char searched[2] = {1, em_service_type_ctrl};
+
+    get_mac(agent, -1, -1, false, al_mac);
+    m_writer.begin(multi_addr, al_mac, em_msg_type_autoconf_search, m_msg_id++);
+    m_writer.add_tlv(em_tlv_type_al_mac_address, al_mac, sizeof(mac_address_t));
+    m_writer.add_tlv(em_tlv_type_searched_role, &role, sizeof(role));
+    m_writer.add_tlv(em_tlv_type_autoconf_freq_band, &band, sizeof(band));
+    m_writer.add_tlv(em_tlv_type_supported_service, service, sizeof(service));
+    m_writer.add_tlv(em_tlv_type_searched_service, searched, sizeof(searched));
+    m_writer.add_tlv(em_tlv_type_profile, &profile, sizeof(profile));
+
+    return m_writer.finish();
+}
+
+int em_mesh_sim_t::build_m1(unsigned int agent, unsigned int radio)
+{
+    mac_address_t al_mac, ruid;
+    em_ap_radio_basic_cap_t *basic;
+    em_op_class_t *op_class;
+    em_profile_2_ap_cap_t prof_2;
+    em_ap_radio_advanced_cap_t adv;
+    em_crypto_info_t *info = m_crypto.get_crypto_info();
+    unsigned char *tmp, uuid[sizeof(uuid_t)] = {0}, nonce[sizeof(em_nonce_t)];
+    unsigned char dev_type[8] = {0x00, 0x06, 0x00, 0x50, 0xf2, 0x04, 0x00, 0x01};
+    unsigned char msg_type = em_wsc_msg_type_m1, version = 0x11, conn = 0x01, state = 0x01;
+    unsigned char rf_band = ((radio % 2) == 0) ? 0x01:0x02;
+    unsigned short auth = htons(0x0020), encr = htons(0x0008), methods = htons(0x0080), zero = 0;
+    unsigned int os_version = htonl(0x80000000), len = 0;
+    char serial[32];
+
+    get_mac(agent, -1, -1, false, al_mac);
+    get_mac(agent, static_cast<int> (radio), -1, false, ruid);
+    m_writer.begin(m_ctrl_mac, al_mac, em_msg_type_autoconf_wsc, m_msg_id++);
+
+    // one BSS on one operating class, 2.4 GHz on the even radios and 5 GHz on the odd ones
+    if ((tmp = m_writer.open_tlv(em_tlv_type_ap_radio_basic_cap, sizeof(em_ap_radio_basic_cap_t) + sizeof(em_op_class_t))) != NULL) {
+        basic = reinterpret_cast<em_ap_radio_basic_cap_t *> (tmp);
+        memcpy(basic->ruid, ruid, sizeof(mac_address_t));
+        basic->num_bss = 1;
+        basic->op_class_num = 1;
+        op_class = basic->op_classes;
+        op_class->op_class = ((radio % 2) == 0) ? 81:115;
+        op_class->max_tx_eirp = 20;
+        op_class->num = 0;
+        m_writer.close_tlv(sizeof(em_ap_radio_basic_cap_t) + sizeof(em_op_class_t));
+    }
+
+    memcpy(&uuid[sizeof(uuid) - sizeof(mac_address_t)], ruid, sizeof(mac_address_t));
+    RAND_bytes(nonce, sizeof(nonce));
+    snprintf(serial, sizeof(serial), "sim-%u-%u", agent, radio);
+    if ((tmp = m_writer.open_tlv(em_tlv_type_wsc)) != NULL) {
+        len += add_attr(tmp + len, attr_id_version, &version, sizeof(version));
+        len += add_attr(tmp + len, attr_id_msg_type, &msg_type, sizeof(msg_type));
+        len += add_attr(tmp + len, attr_id_uuid_e, uuid, sizeof(uuid));
+        len += add_attr(tmp + len, attr_id_mac_address, ruid, sizeof(mac_address_t));
+        len += add_attr(tmp + len, attr_id_enrollee_nonce, nonce, sizeof(nonce));
+        len += add_attr(tmp + len, attr_id_public_key, info->e_pub, static_cast<unsigned short> (info->e_pub_len));
+        len += add_attr(tmp + len, attr_id_auth_type_flags, &auth, sizeof(auth));
+        len += add_attr(tmp + len, attr_id_encryption_type_flags, &encr, sizeof(encr));
+        len += add_attr(tmp + len, attr_id_conn_type_flags, &conn, sizeof(conn));
+        len += add_attr(tmp + len, attr_id_cfg_methods, &methods, sizeof(methods));
+        len += add_attr(tmp + len, attr_id_wifi_wsc_state, &state, sizeof(state));
+        len += add_attr(tmp + len, attr_id_manufacturer, "RDK", 3);
+        len += add_attr(tmp + len, attr_id_model_name, "em_mesh_sim", 11);
+        len += add_attr(tmp + len, attr_id_model_number, "1", 1);
+        len += add_attr(tmp + len, attr_id_serial_num, serial, static_cast<unsigned short> (strlen(serial)));
+        len += add_attr(tmp + len, attr_id_primary_device_type, dev_type, sizeof(dev_type));
+        len += add_attr(tmp + len, attr_id_device_name, serial, static_cast<unsigned short> (strlen(serial)));
+        len += add_attr(tmp + len, attr_id_rf_bands, &rf_band, sizeof(rf_band));
+        len += add_attr(tmp + len, attr_id_assoc_state, &zero, sizeof(zero));
+        len += add_attr(tmp + len, attr_id_device_password_id, &zero, sizeof(zero));
+        len += add_attr(tmp + len, attr_id_cfg_error, &zero, sizeof(zero));
+        len += add_attr(tmp + len, attr_id_os_version, &os_version, sizeof(os_version));
+        m_writer.close_tlv(len);
+    }
+
+    memset(&prof_2, 0, sizeof(prof_2));
+    prof_2.byte_counter_units = 1;
+    m_writer.add_tlv(em_tlv_type_profile_2_ap_cap, reinterpret_cast<unsigned char *> (&prof_2), sizeof(prof_2));
+
+    memset(&adv, 0, sizeof(adv));
+    memcpy(adv.ruid, ruid, sizeof(mac_address_t));
+    m_writer.add_tlv(em_tlv_type_ap_radio_advanced_cap, reinterpret_cast<unsigned char *> (&adv), sizeof(adv));
+
+    return m_writer.finish();
+}
+
+int em_mesh_sim_t::build_topo_resp(unsigned int agent, unsigned short msg_id)
+{
+    mac_address_t al_mac, mac;
+    em_device_info_type_t *dev;
+    em_local_interface_t *intf;
+    em_ap_op_bss_t *op_bss;
+    em_ap_op_bss_radio_t *op_radio;
+    em_ap_operational_bss_t *bss;
+    unsigned char *tmp, service[2] = {1, em_service_type_agent}, profile = em_profile_type_2;
+    unsigned short val;
+    unsigned int i, j, len;
+
+    get_mac(agent, -1, -1, false, al_mac);
+    m_writer.begin(m_ctrl_mac, al_mac, em_msg_type_topo_resp, msg_id);
+
+    // a wireless interface per radio, its MAC address being the BSSID
+    len = static_cast<unsigned int> (sizeof(em_device_info_type_t) + m_cfg.num_radios * sizeof(em_local_interface_t));
+    if ((tmp = m_writer.open_tlv(em_tlv_type_device_info, len)) != NULL) {
+        dev = reinterpret_cast<em_device_info_type_t *> (tmp);
+        memcpy(dev->al_mac_addr, al_mac, sizeof(mac_address_t));
+        dev->local_interface_num = static_cast<unsigned char> (m_cfg.num_radios);
+        for (i = 0; i < m_cfg.num_radios; i++) {
+            intf = &dev->local_interface[i];
+            memset(intf, 0, sizeof(em_local_interface_t));
+            get_mac(agent, static_cast<int> (i), -1, true, intf->mac_addr);
+            intf->media_data.media_type = htons(((i % 2) == 0) ? em_media_type_ieee80211n_24:em_media_type_ieee80211ac_5);
+            intf->media_data.media_spec_size = static_cast<unsigned char> (sizeof(em_media_spec_data_t) - 3);
+            memcpy(intf->media_data.network_memb, intf->mac_addr, sizeof(mac_address_t));
+        }
+        m_writer.close_tlv(len);
+    }
+
+    len = static_cast<unsigned int> (sizeof(em_ap_op_bss_t) + m_cfg.num_radios *
+        (sizeof(em_ap_op_bss_radio_t) + sizeof(em_ap_operational_bss_t) + strlen(EM_MESH_SIM_SSID)));
+    if ((tmp = m_writer.open_tlv(em_tlv_type_operational_bss, len)) != NULL) {
+        op_bss = reinterpret_cast<em_ap_op_bss_t *> (tmp);
+        op_bss->radios_num = static_cast<unsigned char> (m_cfg.num_radios);
+        tmp = reinterpret_cast<unsigned char *> (op_bss->radios);
+        for (i = 0; i < m_cfg.num_radios; i++) {
+            op_radio = reinterpret_cast<em_ap_op_bss_radio_t *> (tmp);
+            get_mac(agent, static_cast<int> (i), -1, false, op_radio->ruid);
+            op_radio->bss_num = 1;
+            bss = op_radio->bss;
+            get_mac(agent, static_cast<int> (i), -1, true, bss->bssid);
+            bss->ssid_len = static_cast<unsigned char> (strlen(EM_MESH_SIM_SSID));
+            memcpy(bss->ssid, EM_MESH_SIM_SSID, bss->ssid_len);
+            tmp += sizeof(em_ap_op_bss_radio_t) + sizeof(em_ap_operational_bss_t) + bss->ssid_len;
+        }
+        m_writer.close_tlv(len);
+    }
+
+    m_writer.add_tlv(em_tlv_type_supported_service, service, sizeof(service));
+
+    // bss count, then per BSS its BSSID, station count and stations with their association time
+    len = 1 + m_cfg.num_radios * (sizeof(mac_address_t) + 2 + m_cfg.num_stas * (sizeof(mac_address_t) + 2));
+    if ((m_cfg.num_stas != 0) && ((tmp = m_writer.open_tlv(em_tlv_type_associated_clients, len)) != NULL)) {
+        *tmp++ = static_cast<unsigned char> (m_cfg.num_radios);
+        for (i = 0; i < m_cfg.num_radios; i++) {
+            get_mac(agent, static_cast<int> (i), -1, true, mac);
+            memcpy(tmp, mac, sizeof(mac_address_t));
+            tmp += sizeof(mac_address_t);
+            val = htons(static_cast<unsigned short> (m_cfg.num_stas));
+            memcpy(tmp, &val, sizeof(val));
+            tmp += sizeof(val);
+            for (j = 0; j < m_cfg.num_stas; j++) {
+                get_mac(agent, static_cast<int> (i), static_cast<int> (j), false, tmp);
+                tmp += sizeof(mac_address_t);
+                val = htons(10);
+                memcpy(tmp, &val, sizeof(val));
+                tmp += sizeof(val);
+            }
+        }
+        m_writer.close_tlv(len);
+    }
+
+    m_writer.add_tlv(em_tlv_type_profile, &profile, sizeof(profile));
+
+    return m_writer.finish();
+}
+
+int em_mesh_sim_t::build_ap_metrics_rsp(unsigned int agent, unsigned short msg_id)
+{
+    mac_address_t al_mac;
+    em_ap_metric_t metric;
+    em_ap_ext_metric_t ext;
+    em_radio_metric_t radio;
+    em_assoc_sta_traffic_sts_t sts;
+    unsigned char link[sizeof(em_assoc_sta_link_metrics_t) + sizeof(em_assoc_link_metrics_t)];
+    em_assoc_sta_link_metrics_t *sta_link = reinterpret_cast<em_assoc_sta_link_metrics_t *> (link);
+    unsigned int i, j;
+
+    get_mac(agent, -1, -1, false, al_mac);
+    m_writer.begin(m_ctrl_mac, al_mac, em_msg_type_ap_metrics_rsp, msg_id);
+
+    for (i = 0; i < m_cfg.num_radios; i++) {
+        memset(&metric, 0, sizeof(metric));
+        get_mac(agent, static_cast<int> (i), -1, true, metric.bssid);
+        metric.channel_util = static_cast<unsigned char> (20 + (agent + i) % 60);
+        metric.num_sta = htons(static_cast<unsigned short> (m_cfg.num_stas));
+        metric.est_service_params_BE_bit = 1;
+        m_writer.add_tlv(em_tlv_type_ap_metrics, reinterpret_cast<unsigned char *> (&metric), sizeof(metric));
+
+        memset(&ext, 0, sizeof(ext));
+        memcpy(ext.bssid, metric.bssid, sizeof(mac_address_t));
+        m_writer.add_tlv(em_tlv_type_ap_ext_metric, reinterpret_cast<unsigned char *> (&ext), sizeof(ext));
+
+        memset(&radio, 0, sizeof(radio));
+        get_mac(agent, static_cast<int> (i), -1, false, radio.ruid);
+        radio.noise = 40;
+        radio.transmit = 30;
+        m_writer.add_tlv(em_tlv_type_radio_metric, reinterpret_cast<unsigned char *> (&radio), sizeof(radio));
+
+        for (j = 0; j < m_cfg.num_stas; j++) {
+            memset(&sts, 0, sizeof(sts));
+            get_mac(agent, static_cast<int> (i), static_cast<int> (j), false, sts.sta_mac_addr);
+            sts.bytes_sent = htonl(1000 * (j + 1));
+            sts.bytes_recv = htonl(500 * (j + 1));
+            sts.packets_sent = htonl(10 * (j + 1));
+            sts.packets_recv = htonl(5 * (j + 1));
+            m_writer.add_tlv(em_tlv_type_assoc_sta_traffic_sts, reinterpret_cast<unsigned char *> (&sts), sizeof(sts));
+
+            memset(link, 0, sizeof(link));
+            memcpy(sta_link->sta_mac, sts.sta_mac_addr, sizeof(mac_address_t));
+            sta_link->num_bssids = 1;
+            memcpy(sta_link->assoc_link_metrics[0].bssid, metric.bssid, sizeof(mac_address_t));
+            sta_link->assoc_link_metrics[0].est_mac_data_rate_dl = htonl(400);
+            sta_link->assoc_link_metrics[0].est_mac_data_rate_ul = htonl(200);
+            sta_link->assoc_link_metrics[0].rcpi = static_cast<unsigned char> (120 + (j % 60));
+            m_writer.add_tlv(em_tlv_type_assoc_sta_link_metric, link, sizeof(link));
+        }
+    }
+
+    return m_writer.finish();
+}
+
+int em_mesh_sim_t::build_btm_rprt(unsigned int agent, unsigned int radio, unsigned int sta)
+{
+    mac_address_t al_mac;
+    em_steering_btm_rprt_t rprt;
+
+    get_mac(agent, -1, -1, false, al_mac);
+    m_writer.begin(m_ctrl_mac, al_mac, em_msg_type_client_steering_btm_rprt, m_msg_id++);
+
+    memset(&rprt, 0, sizeof(rprt));
+    get_mac(agent, static_cast<int> (radio), -1, true, rprt.bssid);
+    get_mac(agent, static_cast<int> (radio), static_cast<int> (sta), false, rprt.sta_mac_addr);
+    get_mac(agent, static_cast<int> ((radio + 1) % m_cfg.num_radios), -1, true, rprt.target_bssid);
+    m_writer.add_tlv(em_tlv_type_steering_btm_rprt, reinterpret_cast<unsigned char *> (&rprt), sizeof(rprt));
+
+    return m_writer.finish();
+}
+
+int em_mesh_sim_t::build_ack(unsigned int agent, unsigned short msg_id)
+{
+    mac_address_t al_mac;
+
+    get_mac(agent, -1, -1, false, al_mac);
+    m_writer.begin(m_ctrl_mac, al_mac, em_msg_type_1905_ack, msg_id);
+
+    return m_writer.finish();
+}
+
+int em_mesh_sim_t::send_built()
+{
+    unsigned char *frame;
+    unsigned int i, len;
+    int ret = 0;
+
+    if (m_writer.has_error() == true) {
+        m_stats.tx_errors++;
+        return -1;
+    }
+
+    for (i = 0; i < m_writer.get_frame_count(); i++) {
+        frame = m_writer.get_frame(i, &len);
+        if (send(m_fd, frame, len, 0) < 0) {
+            m_stats.tx_errors++;
+            ret = -1;
+            continue;
+        }
+        m_stats.frames_tx++;
+    }
+
+    return ret;
+}
+
+void em_mesh_sim_t::handle_frame(unsigned char *buff, unsigned int len)
+{
+    em_raw_hdr_t *hdr = reinterpret_cast<em_raw_hdr_t *> (buff);
+    em_cmdu_t *cmdu;
+    em_mesh_sim_agent_t *agent;
+    em_steering_req_t *req;
+    em_tlv_t *tlv;
+    mac_address_t ruid;
+    unsigned short msg_id;
+    unsigned int radio, sta, all;
+    uint64_t now_ms;
+    int idx;
+
+    if ((len < (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))) || (ntohs(hdr->type) != ETH_P_1905)) {
+        return;
+    }
+
+    // multicasts, e.g. the search of the controller, and frames sent by the simulator are of no interest
+    if ((idx = get_agent_index(hdr->dst)) < 0) {
+        return;
+    }
+
+    m_stats.frames_rx++;
+    agent = &m_agents[static_cast<unsigned int> (idx)];
+    cmdu = reinterpret_cast<em_cmdu_t *> (buff + sizeof(em_raw_hdr_t));
+    msg_id = ntohs(cmdu->id);
+    em_msg_t msg(buff + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t), len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)));
+
+    switch (ntohs(cmdu->type)) {
+        case em_msg_type_autoconf_resp:
+            if (agent->state != em_mesh_sim_state_search) {
+                break;
+            }
+            if (m_ctrl_known == false) {
+                memcpy(m_ctrl_mac, hdr->src, sizeof(mac_address_t));
+                m_ctrl_known = true;
+            }
+            agent->state = em_mesh_sim_state_wsc;
+            agent->sent_ms = get_time_ms();
+            for (radio = 0; radio < m_cfg.num_radios; radio++) {
+                build_m1(static_cast<unsigned int> (idx), radio);
+                send_built();
+            }
+            break;
+
+        case em_msg_type_autoconf_wsc:
+            if ((agent->state != em_mesh_sim_state_wsc) || ((tlv = msg.get_tlv(em_tlv_type_radio_id)) == NULL) ||
+                    (ntohs(tlv->len) < sizeof(mac_address_t))) {
+                break;
+            }
+            radio = tlv->value[4] - 1U;
+            if (radio >= m_cfg.num_radios) {
+                break;
+            }
+            get_mac(static_cast<unsigned int> (idx), static_cast<int> (radio), -1, false, ruid);
+            if (memcmp(ruid, tlv->value, sizeof(mac_address_t)) != 0) {
+                break;
+            }
+            agent->radios_done |= (1U << radio);
+            all = (1U << m_cfg.num_radios) - 1;
+            if (agent->radios_done == all) {
+                now_ms = get_time_ms();
+                agent->state = em_mesh_sim_state_onboarded;
+                agent->next_metrics_ms = now_ms + m_cfg.metrics_ms;
+                agent->next_btm_ms = now_ms + m_cfg.btm_ms;
+                m_onboard_lat.add((now_ms - agent->start_ms) * 1000);
+                m_stats.onboarded++;
+                m_stats.last_onboard_ms = now_ms;
+            }
+            break;
+
+        case em_msg_type_topo_query:
+            build_topo_resp(static_cast<unsigned int> (idx), msg_id);
+            send_built();
+            break;
+
+        case em_msg_type_ap_metrics_query:
+            build_ap_metrics_rsp(static_cast<unsigned int> (idx), msg_id);
+            send_built();
+            break;
+
+        case em_msg_type_map_policy_config_req:
+        case em_msg_type_client_assoc_ctrl_req:
+            build_ack(static_cast<unsigned int> (idx), msg_id);
+            send_built();
+            break;
+
+        case em_msg_type_client_steering_req:
+            build_ack(static_cast<unsigned int> (idx), msg_id);
+            send_built();
+            // report the steered station if it is one of ours, any station of the BSS otherwise
+            tlv = msg.get_tlv(em_tlv_type_steering_request);
+            if ((tlv == NULL) || (ntohs(tlv->len) < sizeof(em_steering_req_t))) {
+                break;
+            }
+            req = reinterpret_cast<em_steering_req_t *> (tlv->value);
+            radio = req->bssid[4] - 1U;
+            sta = req->sta_mac_addr[5] - 1U;
+            if ((radio < m_cfg.num_radios) && (m_cfg.num_stas != 0)) {
+                build_btm_rprt(static_cast<unsigned int> (idx), radio, sta % m_cfg.num_stas);
+                send_built();
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void em_mesh_sim_t::handle_timers(uint64_t now_ms)
+{
+    em_mesh_sim_agent_t *agent;
+    unsigned int i, radio, due;
+
+    if (m_stats.first_start_ms == 0) {
+        m_stats.first_start_ms = now_ms;
+    }
+
+    // agents start at the configured rate
+    due = static_cast<unsigned int> (m_agents.size());
+    if (m_cfg.start_rate != 0) {
+        due = static_cast<unsigned int> ((now_ms - m_stats.first_start_ms) * m_cfg.start_rate / 1000 + 1);
+        due = (due > m_agents.size()) ? static_cast<unsigned int> (m_agents.size()):due;
+    }
+    for (; m_started < due; m_started++) {
+        agent = &m_agents[m_started];
+        agent->state = em_mesh_sim_state_search;
+        agent->start_ms = now_ms;
+        agent->sent_ms = now_ms;
+        build_autoconf_search(m_started);
+        send_built();
+    }
+
+    for (i = 0; i < m_started; i++) {
+        agent = &m_agents[i];
+        switch (agent->state) {
+            case em_mesh_sim_state_search:
+                if ((now_ms - agent->sent_ms) >= EM_MESH_SIM_RETRY_MS) {
+                    agent->sent_ms = now_ms;
+                    m_stats.retries++;
+                    build_autoconf_search(i);
+                    send_built();
+                }
+                break;
+
+            case em_mesh_sim_state_wsc:
+                if ((now_ms - agent->sent_ms) >= EM_MESH_SIM_RETRY_MS) {
+                    agent->sent_ms = now_ms;
+                    m_stats.retries++;
+                    for (radio = 0; radio < m_cfg.num_radios; radio++) {
+                        if ((agent->radios_done & (1U << radio)) == 0) {
+                            build_m1(i, radio);
+                            send_built();
+                        }
+                    }
+                }
+                break;
+
+            case em_mesh_sim_state_onboarded:
+                if ((m_cfg.metrics_ms != 0) && (now_ms >= agent->next_metrics_ms)) {
+                    agent->next_metrics_ms += m_cfg.metrics_ms;
+                    build_ap_metrics_rsp(i, m_msg_id++);
+                    send_built();
+                }
+                if ((m_cfg.btm_ms != 0) && (m_cfg.num_stas != 0) && (now_ms >= agent->next_btm_ms)) {
+                    agent->next_btm_ms += m_cfg.btm_ms;
+                    build_btm_rprt(i, agent->btm_sta % m_cfg.num_radios, (agent->btm_sta / m_cfg.num_radios) % m_cfg.num_stas);
+                    send_built();
+                    agent->btm_sta++;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+int em_mesh_sim_t::sample_ctrl(unsigned long *rss_kb, unsigned long long *cpu_ticks)
+{
+    char path[64], line[1024], *tmp;
+    unsigned long size, resident;
+    unsigned long long utime, stime;
+    FILE *fp;
+    int ret;
+
+    if (m_cfg.ctrl_pid == 0) {
+        return -1;
+    }
+
+    snprintf(path, sizeof(path), "/proc/%d/statm", m_cfg.ctrl_pid);
+    if ((fp = fopen(path, "r")) == NULL) {
+        return -1;
+    }
+    ret = fscanf(fp, "%lu %lu", &size, &resident);
+    fclose(fp);
+    if (ret != 2) {
+        return -1;
+    }
+    *rss_kb = resident * static_cast<unsigned long> (sysconf(_SC_PAGESIZE)) / 1024;
+
+    // utime and stime are the 14th and 15th fields, the name in parentheses may hold spaces
+    snprintf(path, sizeof(path), "/proc/%d/stat", m_cfg.ctrl_pid);
+    if ((fp = fopen(path, "r")) == NULL) {
+        return -1;
+    }
+    tmp = fgets(line, sizeof(line), fp);
+    fclose(fp);
+    if ((tmp == NULL) || ((tmp = strrchr(line, ')')) == NULL)) {
+        return -1;
+    }
+    if (sscanf(tmp + 1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu", &utime, &stime) != 2) {
+        return -1;
+    }
+    *cpu_ticks = utime + stime;
+
+    return 0;
+}
+
+int em_mesh_sim_t::init(const em_mesh_sim_config_t *cfg, bool open_socket)
+{
+    struct sockaddr_ll addr;
+    struct packet_mreq mreq;
+    int ifindex, sz = 4 * 1024 * 1024;
+
+    if ((cfg->num_agents == 0) || (cfg->num_agents > EM_MESH_SIM_MAX_AGENTS) || (cfg->num_radios == 0) ||
+            (cfg->num_radios > EM_MESH_SIM_MAX_RADIOS) || (cfg->num_stas > EM_MESH_SIM_MAX_STAS)) {
+        printf("%s:%d: At most %d agents of %d radios with %d stations each\n", __func__, __LINE__,
+            EM_MESH_SIM_MAX_AGENTS, EM_MESH_SIM_MAX_RADIOS, EM_MESH_SIM_MAX_STAS);
+        return -1;
+    }
+
+    memcpy(&m_cfg, cfg, sizeof(em_mesh_sim_config_t));
+    m_agents.assign(m_cfg.num_agents, em_mesh_sim_agent_t());
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_onboard_lat.reset();
+    m_started = 0;
+
+    if (m_crypto.init() != 0) {
+        printf("%s:%d: Could not create the key pair\n", __func__, __LINE__);
+        return -1;
+    }
+
+    if (open_socket == false) {
+        return 0;
+    }
+
+    if ((ifindex = static_cast<int> (if_nametoindex(m_cfg.ifname))) == 0) {
+        printf("%s:%d: Unknown interface: %s\n", __func__, __LINE__, m_cfg.ifname);
+        return -1;
+    }
+
+    if ((m_fd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_1905))) < 0) {
+        printf("%s:%d: Could not open socket, err: %d\n", __func__, __LINE__, errno);
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sll_family = AF_PACKET;
+    addr.sll_protocol = htons(ETH_P_1905);
+    addr.sll_ifindex = ifindex;
+    if (bind(m_fd, reinterpret_cast<struct sockaddr *> (&addr), sizeof(addr)) < 0) {
+        printf("%s:%d: Could not bind to %s, err: %d\n", __func__, __LINE__, m_cfg.ifname, errno);
+        close(m_fd);
+        m_fd = -1;
+        return -1;
+    }
+
+    // the agents' addresses are not the interface's own
+    memset(&mreq, 0, sizeof(mreq));
+    mreq.mr_ifindex = ifindex;
+    mreq.mr_type = PACKET_MR_PROMISC;
+    setsockopt(m_fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq));
+    setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &sz, sizeof(sz));
+    setsockopt(m_fd, SOL_SOCKET, SO_SNDBUF, &sz, sizeof(sz));
+
+    return 0;
+}
+
+int em_mesh_sim_t::run()
+{
+    struct pollfd pfd;
+    uint64_t start_ms, now_ms, end_ms, next_report_ms;
+    ssize_t len;
+
+    if (m_fd < 0) {
+        return -1;
+    }
+
+    start_ms = now_ms = get_time_ms();
+    end_ms = now_ms + m_cfg.duration_s * 1000ULL;
+    next_report_ms = now_ms + 1000;
+    m_ctrl_base_ok = (sample_ctrl(&m_ctrl_base_rss_kb, &m_ctrl_steady_ticks) == 0);
+
+    pfd.fd = m_fd;
+    pfd.events = POLLIN;
+    while (now_ms < end_ms) {
+        handle_timers(now_ms);
+
+        if (poll(&pfd, 1, 10) > 0) {
+            while ((len = recv(m_fd, m_rx_buff, sizeof(m_rx_buff), MSG_DONTWAIT)) > 0) {
+                handle_frame(m_rx_buff, static_cast<unsigned int> (len));
+            }
+        }
+
+        now_ms = get_time_ms();
+        // steady state starts once every agent is onboarded
+        if ((m_steady_ms == 0) && (m_stats.onboarded == m_agents.size())) {
+            m_steady_ms = now_ms;
+            sample_ctrl(&m_ctrl_onboarded_rss_kb, &m_ctrl_steady_ticks);
+        }
+        if (now_ms >= next_report_ms) {
+            next_report_ms += 1000;
+            printf("%4llus: started: %u onboarded: %llu tx: %llu rx: %llu retries: %llu tx errors: %llu\n",
+                static_cast<unsigned long long> ((now_ms - start_ms) / 1000), m_started,
+                static_cast<unsigned long long> (m_stats.onboarded), static_cast<unsigned long long> (m_stats.frames_tx),
+                static_cast<unsigned long long> (m_stats.frames_rx), static_cast<unsigned long long> (m_stats.retries),
+                static_cast<unsigned long long> (m_stats.tx_errors));
+        }
+    }
+
+    m_end_ms = now_ms;
+    if (sample_ctrl(&m_ctrl_end_rss_kb, &m_ctrl_end_ticks) != 0) {
+        m_ctrl_base_ok = false;
+    }
+
+    return 0;
+}
+
+void em_mesh_sim_t::print_summary(FILE *out)
+{
+    double secs, ticks;
+
+    fprintf(out, "Agents: %u, radios per agent: %u, stations per radio: %u\n", m_cfg.num_agents, m_cfg.num_radios, m_cfg.num_stas);
+    secs = (m_stats.onboarded == 0) ? 0:static_cast<double> (m_stats.last_onboard_ms - m_stats.first_start_ms) / 1000.0;
+    fprintf(out, "Onboarded: %llu in %.1fs, %.1f agents/s, retries: %llu\n", static_cast<unsigned long long> (m_stats.onboarded),
+        secs, (secs > 0) ? static_cast<double> (m_stats.onboarded) / secs:0.0, static_cast<unsigned long long> (m_stats.retries));
+    fprintf(out, "Onboarding latency ms: p50: %llu p90: %llu p99: %llu max: %llu\n",
+        static_cast<unsigned long long> (m_onboard_lat.get_percentile_us(50) / 1000),
+        static_cast<unsigned long long> (m_onboard_lat.get_percentile_us(90) / 1000),
+        static_cast<unsigned long long> (m_onboard_lat.get_percentile_us(99) / 1000),
+        static_cast<unsigned long long> (m_onboard_lat.get_max_us() / 1000));
+
+    if (m_ctrl_base_ok == false) {
+        return;
+    }
+    fprintf(out, "Controller RSS kB: before: %lu end: %lu\n", m_ctrl_base_rss_kb, m_ctrl_end_rss_kb);
+    if ((m_steady_ms != 0) && (m_stats.onboarded != 0)) {
+        fprintf(out, "Controller memory per agent: %.1f kB\n",
+            (static_cast<double> (m_ctrl_onboarded_rss_kb) - static_cast<double> (m_ctrl_base_rss_kb)) / static_cast<double> (m_stats.onboarded));
+        secs = static_cast<double> (m_end_ms - m_steady_ms) / 1000.0;
+        ticks = static_cast<double> (m_ctrl_end_ticks - m_ctrl_steady_ticks);
+        if (secs > 0) {
+            fprintf(out, "Controller steady state CPU: %.1f%% over %.1fs\n",
+                100.0 * ticks / static_cast<double> (sysconf(_SC_CLK_TCK)) / secs, secs);
+        }
+    }
+}
+
+em_mesh_sim_t::em_mesh_sim_t() : m_cfg(), m_agents(), m_stats(), m_onboard_lat(), m_writer(), m_crypto(), m_ctrl_mac(),
+    m_ctrl_known(false), m_msg_id(1), m_fd(-1), m_started(0), m_steady_ms(0), m_end_ms(0), m_ctrl_base_ok(false),
+    m_ctrl_base_rss_kb(0), m_ctrl_onboarded_rss_kb(0), m_ctrl_end_rss_kb(0), m_ctrl_steady_ticks(0), m_ctrl_end_ticks(0)
+{
+    // broadcast until the controller answers a search
+    memset(m_ctrl_mac, 0xff, sizeof(mac_address_t));
+}
+
+em_mesh_sim_t::~em_mesh_sim_t()
+{
+    if (m_fd >= 0) {
+        close(m_fd);
+    }
+}
@@ -0,0 +1,96 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include "em_mesh_sim.h"
+
+static em_mesh_sim_t g_mesh_sim;
+
+static bool get_uint_arg(const std::string& arg, const char *name, unsigned int *val)
+{
+    size_t len = strlen(name);
+    char *end;
+
+    if (arg.compare(0, len, name) != 0) {
+        return false;
+    }
+    *val = static_cast<unsigned int> (strtoul(arg.c_str() + len, &end, 10));
+
+    return (end != (arg.c_str() + len)) && (*end == '\0');
+}
+
+int main(int argc, const char *argv[])
+{
+    em_mesh_sim_config_t cfg;
+    std::vector<std::string> args;
+    unsigned int pid = 0;
+
+    for (int i = 1; i < argc; i++) {
+        args.push_back(argv[i]);
+    }
+
+    if ((args.size() == 0) || ((args.size() == 1) && (args[0] == "--help" || args[0] == "-h"))) {
+        printf("Usage: %s --interface=iface [--agents=n] [--radios=n] [--stations=n] [--rate=agents_per_sec] "
+            "[--metrics-ms=ms] [--btm-ms=ms] [--duration=sec] [--ctrl-pid=pid]\n", argv[0]);
+        return 0;
+    }
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.num_agents = 100;
+    cfg.num_radios = 2;
+    cfg.num_stas = 4;
+    cfg.start_rate = 50;
+    cfg.metrics_ms = 10000;
+    cfg.btm_ms = 30000;
+    cfg.duration_s = 60;
+
+    for (auto arg : args) {
+        if (arg.find("--interface=") == 0) {
+            snprintf(cfg.ifname, sizeof(cfg.ifname), "%s", arg.substr(strlen("--interface=")).c_str());
+        } else if ((get_uint_arg(arg, "--agents=", &cfg.num_agents) == true) ||
+                (get_uint_arg(arg, "--radios=", &cfg.num_radios) == true) ||
+                (get_uint_arg(arg, "--stations=", &cfg.num_stas) == true) ||
+                (get_uint_arg(arg, "--rate=", &cfg.start_rate) == true) ||
+                (get_uint_arg(arg, "--metrics-ms=", &cfg.metrics_ms) == true) ||
+                (get_uint_arg(arg, "--btm-ms=", &cfg.btm_ms) == true) ||
+                (get_uint_arg(arg, "--duration=", &cfg.duration_s) == true)) {
+            continue;
+        } else if (get_uint_arg(arg, "--ctrl-pid=", &pid) == true) {
+            cfg.ctrl_pid = static_cast<pid_t> (pid);
+        } else {
+            printf("Invalid argument: %s\n", arg.c_str());
+            return -1;
+        }
+    }
+
+    if (cfg.ifname[0] == '\0') {
+        printf("Missing --interface\n");
+        return -1;
+    }
+
+    if ((g_mesh_sim.init(&cfg) != 0) || (g_mesh_sim.run() != 0)) {
+        return -1;
+    }
+    g_mesh_sim.print_summary(stdout);
+
+    return 0;
+}
@@ -1,8 +1,11 @@
+#include <poll.h>
+#include <algorithm>
 #include "al_service_access_point.h"
 #include "al_service_utils.h"
 
 // Constructor: Connects to the Unix domain socket using the provided path --> moved from hardcoded to check in the unit test for socket creation
-AlServiceAccessPoint::AlServiceAccessPoint(const std::string &dataSocketPath, const std::string &controlSocketPath) : alDataSocketpath(dataSocketPath),
+AlServiceAccessPoint::AlServiceAccessPoint(const std::string &dataSocketPath, const std::string &controlSocketPath,
+                                           AlServiceTransport transport) : alDataSocketpath(dataSocketPath),
                                                                                                                       alControlSocketpath(controlSocketPath)
 {
     alControlSocketDescriptor = socket(AF_UNIX, SOCK_STREAM, 0);
@@ -34,10 +37,35 @@ AlServiceAccessPoint::AlServiceAccessPoint(const std::string &dataSocketPath, co
 #ifdef DEBUG_MODE
     std::cout << "Connected to Unix data socket: " << dataSocketPath << std::endl;
 #endif
+
+    // The daemon attaches to the ring with the descriptors sent ahead of anything else on the data socket
+    if (transport == AlServiceTransport::SharedMemory) {
+        try {
+            alRing.reset(new AlServiceSharedRing());
+            alRing->sendDescriptors(alDataSocketDescriptor);
+        } catch (...) {
+            alRing.reset();
+            close(alDataSocketDescriptor);
+            close(alControlSocketDescriptor);
+            throw;
+        }
+#ifdef DEBUG_MODE
+        std::cout << "Shared ring of " << alRing->getMaxPayload() << " bytes sent on the data socket" << std::endl;
+#endif
+    }
 }
 
 // Destructor: Closes the Unix domain socket
 AlServiceAccessPoint::~AlServiceAccessPoint() {
+    // Stop the transmitter before the socket goes, what is still queued is lost
+    {
+        std::lock_guard<std::mutex> lock(alTxMutex);
+        alTxExit = true;
+    }
+    alTxCondition.notify_one();
+    if (alTxThread.joinable()) {
+        alTxThread.join();
+    }
     if (alDataSocketDescriptor != -1)
     {
         close(alDataSocketDescriptor);
@@ -67,6 +95,11 @@ void AlServiceAccessPoint::setDataSocketDescriptor(int descriptor)
     alDataSocketDescriptor = descriptor;
 }
 
+int AlServiceAccessPoint::getIndicationDescriptor() const
+{
+    return alRing ? alRing->getEventDescriptor() : alDataSocketDescriptor;
+}
+
 int AlServiceAccessPoint::getControlSocketDescriptor() const
 {
     return alControlSocketDescriptor;
@@ -111,71 +144,235 @@ AlServiceRegistrationResponse AlServiceAccessPoint::serviceAccessPointRegistrati
     return registrationResponse;
 }
 
+// Writes the queued packets, several per sendmsg(), stops without blocking once the socket is full
+int AlServiceAccessPoint::flushTransmitQueue() {
+    while (!alTxQueue.empty()) {
+        struct iovec iov[SAP_TX_BATCH];
+        struct msghdr msg = {};
+        size_t count = 0;
+
+        for (auto it = alTxQueue.begin(); it != alTxQueue.end() && count < SAP_TX_BATCH; ++it, ++count) {
+            size_t offset = (count == 0) ? alTxHeadOffset : 0;
+            iov[count].iov_base = it->data() + offset;
+            iov[count].iov_len = it->size() - offset;
+        }
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+
+        ssize_t bytesSent = sendmsg(alDataSocketDescriptor, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (bytesSent == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                alTxStats.backPressure++;
+                return 0;
+            }
+            return -1;
+        }
+        alTxStats.batches++;
+
+        // Pop the packets written, a stream socket may stop in the middle of one
+        size_t left = static_cast<size_t>(bytesSent);
+        while (left > 0) {
+            size_t remaining = alTxQueue.front().size() - alTxHeadOffset;
+            if (left < remaining) {
+                alTxHeadOffset += left;
+                break;
+            }
+            left -= remaining;
+            alTxQueue.pop_front();
+            alTxHeadOffset = 0;
+            alTxStats.sentPackets++;
+        }
+    }
+
+    return 0;
+}
+
+// Sends a header and a payload slice as one packet, what the socket does not take is queued
+void AlServiceAccessPoint::sendPacket(const unsigned char *header, const unsigned char *payload, size_t length, const char *error) {
+    size_t total = PACKET_HEADER_SIZE + length;
+    size_t sent = 0;
+
+    // Packets leave in order, behind the queued ones
+    while (alTxQueue.empty() && sent < total) {
+        struct iovec iov[2];
+        struct msghdr msg = {};
+
+        if (sent < PACKET_HEADER_SIZE) {
+            iov[0].iov_base = const_cast<unsigned char *>(header) + sent;
+            iov[0].iov_len = PACKET_HEADER_SIZE - sent;
+            iov[1].iov_base = const_cast<unsigned char *>(payload);
+            iov[1].iov_len = length;
+            msg.msg_iovlen = (length == 0) ? 1 : 2;
+        } else {
+            iov[0].iov_base = const_cast<unsigned char *>(payload) + (sent - PACKET_HEADER_SIZE);
+            iov[0].iov_len = total - sent;
+            msg.msg_iovlen = 1;
+        }
+        msg.msg_iov = iov;
+
+        ssize_t bytesSent = sendmsg(alDataSocketDescriptor, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (bytesSent == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                alTxStats.backPressure++;
+                break;
+            }
+            throw AlServiceException(error, PrimitiveError::RequestFailed);
+        }
+        sent += static_cast<size_t>(bytesSent);
+    }
+
+    if (sent == total) {
+        alTxStats.sentPackets++;
+        return;
+    }
+
+    // Copy what is left, the transmitter writes it once the socket drains
+    std::vector<unsigned char> packet;
+    packet.reserve(total - sent);
+    if (sent < PACKET_HEADER_SIZE) {
+        packet.insert(packet.end(), header + sent, header + PACKET_HEADER_SIZE);
+        packet.insert(packet.end(), payload, payload + length);
+    } else {
+        packet.insert(packet.end(), payload + (sent - PACKET_HEADER_SIZE), payload + length);
+    }
+    alTxQueue.push_back(std::move(packet));
+    alTxStats.queuedPackets++;
+    alTxStats.peakDepth = std::max(alTxStats.peakDepth, alTxQueue.size());
+}
+
+// Transmitter thread, waits for queued packets then for the socket to take them
+void AlServiceAccessPoint::transmitLoop() {
+    std::unique_lock<std::mutex> lock(alTxMutex);
+
+    while (!alTxExit) {
+        if (alTxQueue.empty()) {
+            alTxCondition.wait(lock);
+            continue;
+        }
+
+        lock.unlock();
+        struct pollfd pfd = {alDataSocketDescriptor, POLLOUT, 0};
+        poll(&pfd, 1, SAP_TX_POLL_MS);
+        lock.lock();
+
+        if (flushTransmitQueue() != 0) {
+            // Nobody to report to, drop what is queued rather than retry on a broken socket
+            std::cout << "Failed to send queued packets through Unix socket, err: " << errno << std::endl;
+            alTxStats.errors++;
+            alTxQueue.clear();
+            alTxHeadOffset = 0;
+        }
+    }
+}
+
+AlServiceTransmitStats AlServiceAccessPoint::getTransmitStats() {
+    std::lock_guard<std::mutex> lock(alTxMutex);
+    return alTxStats;
+}
+
+size_t AlServiceAccessPoint::getTransmitQueueDepth() {
+    std::lock_guard<std::mutex> lock(alTxMutex);
+    return alTxQueue.size();
+}
+
 // Message to send a SDU message to the IEEE1905 application
 void AlServiceAccessPoint::serviceAccessPointDataRequest(AlServiceDataUnit& message) {
+    const std::vector<unsigned char>& payload = message.getPayload();
+
+    serviceAccessPointDataRequest(message.getSourceAlMacAddress(), message.getDestinationAlMacAddress(),
+        payload.data(), payload.size());
+}
+
+// Sends a payload the caller owns, the fragments are sent from it without copying
+void AlServiceAccessPoint::serviceAccessPointDataRequest(const MacAddress& source, const MacAddress& destination,
+    const unsigned char *payload, size_t length) {
     /*
      * We assume MTU = SOCKET_MTU, so max packet size is less or equal MTU size.
      * Each packet contains a header and a payload. The header size is
      * 4 (size) + 6 (MAC) + 6 (MAC) + 3 x 1 (3 x 1 byte flags) = 19 bytes.
      * Because of that, the fragment (payload) size can't exceed
-     * MTU - PACKET_HEADER_SIZE = 1481 bytes
+     * MTU - PACKET_HEADER_SIZE bytes
     */
     const size_t fragmentSize = (SOCKET_MTU - PACKET_HEADER_SIZE);
-
-    const std::vector<unsigned char>& payload = message.getPayload();
-
-    size_t totalSize = payload.size();
+    unsigned char header[PACKET_HEADER_SIZE];
 
     //first condition to check if the service has been correctly registered enable
-    if (registrationRequest.getSAPActivationStatus() == SAPActivation::SAP_ENABLE || registrationResponse.getResult() == RegistrationResult::SUCCESS) {
+    if ((registrationRequest.getSAPActivationStatus() == SAPActivation::SAP_ENABLE || registrationResponse.getResult() == RegistrationResult::SUCCESS) && alRing) {
+        // The ring carries the message whole, it waits for the daemon in there rather than in the queue
+        std::lock_guard<std::mutex> lock(alTxMutex);
 
-        // If whole packet size is less than or equal to fragmentSize, send directly without fragmentation
-        if (totalSize <= fragmentSize) {
-            message.setIsFragment(0);
-            message.setIsLastFragment(1);
-
-            // Serialize and send the data
-            std::vector<unsigned char> serializedData = message.serialize();
-            ssize_t bytesSent = send(alDataSocketDescriptor, serializedData.data(), serializedData.size(), 0);
-            if (bytesSent == -1) {
-                throw AlServiceException("Failed to send message through Unix socket", PrimitiveError::RequestFailed);
-            }
+        if (length > alRing->getMaxPayload()) {
+            throw AlServiceException("Message too large for the shared ring", PrimitiveError::RequestFailed);
+        }
+        if (!alRing->push(source, destination, payload, length)) {
+            alTxStats.backPressure++;
+            alTxStats.droppedMessages++;
             #ifdef DEBUG_MODE
-            std::cout << "Sent single message with size " << std::dec << bytesSent << " bytes (no fragmentation)." << std::endl;
+            std::cout << "Shared ring full, dropped message of " << length << " bytes." << std::endl;
             #endif
-            return; // Exit the function after sending
+            return;
         }
-        // For payloads larger than fragmentSize bytes, handle fragmentation
-        size_t numFragments = (totalSize + fragmentSize - 1) / fragmentSize;
-        for (size_t i = 0; i < numFragments; ++i) {
-            size_t start = i * fragmentSize;
-            size_t end = std::min(start + fragmentSize, totalSize);
-            std::vector<unsigned char> fragmentData(payload.begin() + start, payload.begin() + end);
+        alTxStats.sentPackets++;
+    } else if (registrationRequest.getSAPActivationStatus() == SAPActivation::SAP_ENABLE || registrationResponse.getResult() == RegistrationResult::SUCCESS) {
+        size_t numFragments = (length <= fragmentSize) ? 1 : (length + fragmentSize - 1) / fragmentSize;
+        std::lock_guard<std::mutex> lock(alTxMutex);
 
-            message.setPayload(fragmentData);
-            message.setFragmentId(static_cast<uint8_t>(i));
-            message.setIsFragment(1); // Mark as a fragment
-
-            // Mark as last fragment if this is the last iteration
-            message.setIsLastFragment((i == numFragments - 1) ? 1 : 0);
-
-            // Debugging Output for Fragmentation
+        if (flushTransmitQueue() != 0) {
+            throw AlServiceException("Failed to send message through Unix socket", PrimitiveError::RequestFailed);
+        }
+        // A message is dropped whole, the peer could not reassemble one missing a fragment
+        if (alTxQueue.size() + numFragments > SAP_TX_QUEUE_DEPTH) {
+            alTxStats.droppedMessages++;
             #ifdef DEBUG_MODE
-            std::cout << "Sending fragment " << i << " of " << numFragments
-                    << " - Size: " << fragmentData.size() << " bytes, "
-                    << "isFragment: " << static_cast<int>(message.getIsFragment()) << ", "
-                    << "FragmentId: " << static_cast<int>(message.getFragmentId()) << ", "
-                    << "isLastFragment: " << static_cast<int>(message.getIsLastFragment()) << std::endl;
+            std::cout << "Transmit queue full, dropped message of " << length << " bytes." << std::endl;
             #endif
-            // Serialize and send the current fragment
-            std::vector<unsigned char> serializedData = message.serialize();
-            ssize_t bytesSent = send(alDataSocketDescriptor, serializedData.data(), serializedData.size(), 0);
-            if (bytesSent == -1) {
-                throw AlServiceException("Failed to send message fragment through Unix socket", PrimitiveError::RequestFailed);
-            }
+            return;
+        }
+
+        // If whole packet size is less than or equal to fragmentSize, send directly without fragmentation
+        if (length <= fragmentSize) {
+            AlServiceDataUnit::serializeHeader(header, source, destination, 0, 1, 0, length);
+            sendPacket(header, payload, length, "Failed to send message through Unix socket");
             #ifdef DEBUG_MODE
-            std::cout << "Fragment " << i << " sent successfully with size " << bytesSent << " bytes." << std::endl;
+            std::cout << "Sent single message with size " << std::dec << length + PACKET_HEADER_SIZE << " bytes (no fragmentation)." << std::endl;
             #endif
+        } else {
+            // For payloads larger than fragmentSize bytes, handle fragmentation
+            for (size_t i = 0; i < numFragments; ++i) {
+                size_t start = i * fragmentSize;
+                size_t size = std::min(fragmentSize, length - start);
+                uint8_t isLastFragment = (i == numFragments - 1) ? 1 : 0;
+
+                AlServiceDataUnit::serializeHeader(header, source, destination, 1, isLastFragment, static_cast<uint8_t>(i), size);
+
+                // Debugging Output for Fragmentation
+                #ifdef DEBUG_MODE
+                std::cout << "Sending fragment " << i << " of " << numFragments
+                        << " - Size: " << size << " bytes, "
+                        << "isFragment: 1, "
+                        << "FragmentId: " << i << ", "
+                        << "isLastFragment: " << static_cast<int>(isLastFragment) << std::endl;
+                #endif
+                // Send the header and the current slice of the payload
+                sendPacket(header, payload + start, size, "Failed to send message fragment through Unix socket");
+                #ifdef DEBUG_MODE
+                std::cout << "Fragment " << i << " sent successfully with size " << size + PACKET_HEADER_SIZE << " bytes." << std::endl;
+                #endif
+            }
+        }
+
+        // The transmitter only runs once the socket pushed back
+        if (!alTxQueue.empty()) {
+            if (!alTxThread.joinable()) {
+                alTxThread = std::thread(&AlServiceAccessPoint::transmitLoop, this);
+            }
+            alTxCondition.notify_one();
         }
     }else if (registrationResponse.getResult() != RegistrationResult::SUCCESS) {
     #ifdef DEBUG_MODE
@@ -198,28 +395,36 @@ void AlServiceAccessPoint::serviceAccessPointDataRequest(AlServiceDataUnit& mess
 }
 // Executes service indication primitive (receive a message through the socket)
 AlServiceDataUnit AlServiceAccessPoint::serviceAccessPointDataIndication() {
-    std::vector<unsigned char> payload;
     int fragmentId = 0;
     bool receivingFragments = true;
     AlServiceDataUnit message;
+    AlServiceDataUnit fragment;
 
-    while (receivingFragments) {
-        std::vector<unsigned char> buffer(SOCKET_MTU, 0x00);
+    if (alRing) {
+        return receiveFromRing();
+    }
+
+    // The payloads are copied once, from the receive buffer kept across calls into the message
+    if (alReceiveBuffer.size() != SOCKET_MTU) {
+        alReceiveBuffer.resize(SOCKET_MTU);
+    }
+    std::vector<unsigned char>& payload = message.getPayload();
+    payload.clear();
 
+    while (receivingFragments) {
         // Receive data from the socket
-        ssize_t bytesRead = recv(alDataSocketDescriptor, buffer.data(), buffer.size(), 0);
+        ssize_t bytesRead = recv(alDataSocketDescriptor, alReceiveBuffer.data(), alReceiveBuffer.size(), 0);
         if (bytesRead <= 0) {
             if (errno == EBADF || errno == ECONNRESET) {
                 throw AlServiceException("Socket closed or connection reset", PrimitiveError::SocketClosed);
             }
             throw AlServiceException("Failed to receive message through Unix socket", PrimitiveError::IndicationFailed);
         }
-        buffer.resize(bytesRead);
+        const unsigned char *data = alReceiveBuffer.data();
 
-        // Deserialize the received fragment
-        AlServiceDataUnit fragment;
+        // Deserialize the header of the received fragment
         try {
-            fragment.deserialize(buffer);
+            fragment.deserializeHeader(data, static_cast<size_t>(bytesRead));
         } catch (const std::exception& e) {
             throw AlServiceException("Failed to deserialize AlServiceDataUnit fragment", PrimitiveError::InvalidMessage);
         }
@@ -235,7 +440,9 @@ AlServiceDataUnit AlServiceAccessPoint::serviceAccessPointDataIndication() {
             #ifdef DEBUG_MODE
             std::cout << "Received a non-fragmented message of size: " << bytesRead << " bytes." << std::endl;
             #endif
-            return fragment; // Return immediately, as no reassembly is needed
+            message.deserializeHeader(data, static_cast<size_t>(bytesRead));
+            payload.assign(data + PACKET_HEADER_SIZE, data + bytesRead);
+            return message; // Return immediately, as no reassembly is needed
         }
         #ifdef DEBUG_MODE
         // Fragmented message handling
@@ -247,7 +454,7 @@ AlServiceDataUnit AlServiceAccessPoint::serviceAccessPointDataIndication() {
         }
 
         // Append fragment payload to full payload
-        payload.insert(payload.end(), fragment.getPayload().begin(), fragment.getPayload().end());
+        payload.insert(payload.end(), data + PACKET_HEADER_SIZE, data + bytesRead);
 
         // Store source and destination MAC addresses from the first fragment
         if (fragmentId == 0) {
@@ -260,12 +467,167 @@ AlServiceDataUnit AlServiceAccessPoint::serviceAccessPointDataIndication() {
         fragmentId++;
     }
 
-    // Set the assembled payload on the AlServiceDataUnit object
-    message.setPayload(payload);
     #ifdef DEBUG_MODE
     std::cout << "Reassembled message received with total payload size: " << payload.size() << " bytes." << std::endl;
     #endif
     return message;
 }
 
+// Waits for the next message of the shared ring
+AlServiceDataUnit AlServiceAccessPoint::receiveFromRing() {
+    AlServiceDataUnit message;
+    MacAddress source, destination;
+    const unsigned char *payload;
+    size_t length;
+
+    while (true) {
+        alRing->clearEvent();
+        if ((payload = alRing->peek(length, source, destination)) != nullptr) {
+            break;
+        }
+        struct pollfd pfd = {alRing->getEventDescriptor(), POLLIN, 0};
+        if (poll(&pfd, 1, -1) == -1 && errno != EINTR) {
+            throw AlServiceException("Failed to wait on the shared ring", PrimitiveError::IndicationFailed);
+        }
+    }
+    message.setIsFragment(0);
+    message.setIsLastFragment(1);
+    message.setFragmentId(0);
+    message.setSourceAlMacAddress(source);
+    message.setDestinationAlMacAddress(destination);
+    message.getPayload().assign(payload, payload + length);
+    alRing->pop();
+    #ifdef DEBUG_MODE
+    std::cout << "Received message of " << length << " bytes from the shared ring." << std::endl;
+    #endif
+    return message;
+}
+
+// Receives what is available, 0 once the socket is drained
+size_t AlServiceAccessPoint::receiveAvailable(unsigned char *buffer, size_t length) {
+    ssize_t bytesRead = recv(alDataSocketDescriptor, buffer, length, MSG_DONTWAIT);
+    if (bytesRead > 0) {
+        return static_cast<size_t>(bytesRead);
+    }
+    if (bytesRead == 0) {
+        throw AlServiceException("Socket closed or connection reset", PrimitiveError::SocketClosed);
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return 0;
+    }
+    if (errno == EBADF || errno == ECONNRESET) {
+        throw AlServiceException("Socket closed or connection reset", PrimitiveError::SocketClosed);
+    }
+    throw AlServiceException("Failed to receive message through Unix socket", PrimitiveError::IndicationFailed);
+}
+
+// Checks the header of the packet received and makes room for its payload
+void AlServiceAccessPoint::startReceivedPacket(size_t headroom) {
+    uint32_t packetSize = (static_cast<uint32_t>(alRxHeader[0]) << 24) | (static_cast<uint32_t>(alRxHeader[1]) << 16) |
+        (static_cast<uint32_t>(alRxHeader[2]) << 8) | static_cast<uint32_t>(alRxHeader[3]);
+    uint8_t isFragment = alRxHeader[16];
+    uint8_t fragmentId = alRxHeader[18];
+
+    // the length counts everything after itself
+    if (packetSize < PACKET_HEADER_SIZE - sizeof(uint32_t)) {
+        alRxPayloadLeft = 0;
+        alRxDrop = true;
+        alRxDropError = PrimitiveError::InvalidMessage;
+        return;
+    }
+    alRxPayloadLeft = packetSize - (PACKET_HEADER_SIZE - sizeof(uint32_t));
+
+    // A single message or a first fragment starts a new message, one left incomplete is abandoned
+    if (isFragment == 0 || fragmentId == 0) {
+        alRxLength = 0;
+        alRxFragmentId = 0;
+        alRxDrop = false;
+        alRxHeadroom = headroom;
+        std::copy(alRxHeader + 4, alRxHeader + 10, alRxSource.begin());
+        std::copy(alRxHeader + 10, alRxHeader + 16, alRxDestination.begin());
+    }
+
+    if (alRxDrop == false && fragmentId != alRxFragmentId) {
+        alRxDrop = true;
+        alRxDropError = PrimitiveError::FragmentOutOfOrder;
+    }
+    alRxFragmentId = static_cast<unsigned int>(fragmentId) + 1;
+
+    if (alRxDrop == false && alRxHeadroom + alRxLength + alRxPayloadLeft > alReassemblyBuffer.size()) {
+        alReassemblyBuffer.resize(alRxHeadroom + alRxLength + alRxPayloadLeft);
+    }
+}
+
+// Executes service indication primitive without blocking, see the header for the contract
+unsigned char *AlServiceAccessPoint::serviceAccessPointDataIndication(size_t headroom, size_t& length,
+    MacAddress& source, MacAddress& destination) {
+    size_t received;
+
+    if (alRing) {
+        const unsigned char *payload;
 
+        // Cleared first, a message written after the ring was found empty signals again
+        alRing->clearEvent();
+        if ((payload = alRing->peek(length, source, destination)) == nullptr) {
+            return nullptr;
+        }
+        if (alReassemblyBuffer.size() < headroom + length) {
+            alReassemblyBuffer.resize(headroom + length);
+        }
+        std::copy(payload, payload + length, alReassemblyBuffer.data() + headroom);
+        alRing->pop();
+        return alReassemblyBuffer.data();
+    }
+
+    if (alReassemblyBuffer.size() < headroom + SOCKET_MTU) {
+        alReassemblyBuffer.resize(headroom + SOCKET_MTU);
+    }
+
+    while (true) {
+        if (alRxHeaderLength < PACKET_HEADER_SIZE) {
+            if ((received = receiveAvailable(alRxHeader + alRxHeaderLength, PACKET_HEADER_SIZE - alRxHeaderLength)) == 0) {
+                return nullptr;
+            }
+            alRxHeaderLength += received;
+            if (alRxHeaderLength < PACKET_HEADER_SIZE) {
+                continue;
+            }
+            startReceivedPacket(headroom);
+        }
+
+        // The payload lands behind the fragments already received, a dropped one anywhere in the buffer
+        while (alRxPayloadLeft > 0) {
+            if (alRxDrop == true) {
+                received = receiveAvailable(alReassemblyBuffer.data(), std::min(alRxPayloadLeft, alReassemblyBuffer.size()));
+            } else {
+                received = receiveAvailable(alReassemblyBuffer.data() + alRxHeadroom + alRxLength, alRxPayloadLeft);
+                alRxLength += received;
+            }
+            if (received == 0) {
+                return nullptr;
+            }
+            alRxPayloadLeft -= received;
+        }
+
+        // The packet is complete, wait for the next fragment unless it was the last one
+        alRxHeaderLength = 0;
+        if (alRxHeader[17] == 0) {
+            continue;
+        }
+
+        length = alRxLength;
+        alRxLength = 0;
+        alRxFragmentId = 0;
+        if (alRxDrop == true) {
+            alRxDrop = false;
+            throw AlServiceException((alRxDropError == PrimitiveError::FragmentOutOfOrder) ? "Fragment out of order" :
+                "Failed to deserialize AlServiceDataUnit fragment", alRxDropError);
+        }
+        source = alRxSource;
+        destination = alRxDestination;
+        #ifdef DEBUG_MODE
+        std::cout << "Received message with total payload size: " << length << " bytes." << std::endl;
+        #endif
+        return alReassemblyBuffer.data();
+    }
+}
@@ -36,30 +36,37 @@ void AlServiceDataUnit::appendToPayload(const unsigned char* data, size_t length
     payload.insert(payload.end(), data, data + length);
 }
 
+// Header serialization, shared with the senders that do not copy the payload
+void AlServiceDataUnit::serializeHeader(unsigned char *header, const MacAddress& source, const MacAddress& destination,
+    uint8_t isFragment, uint8_t isLastFragment, uint8_t fragmentId, size_t payloadLength) {
+    // the length counts everything after itself
+    uint32_t packet_size = static_cast<uint32_t>(PACKET_HEADER_SIZE - sizeof(uint32_t) + payloadLength);
+
+    header[0] = static_cast<unsigned char>(packet_size >> 24);
+    header[1] = static_cast<unsigned char>(packet_size >> 16);
+    header[2] = static_cast<unsigned char>(packet_size >> 8);
+    header[3] = static_cast<unsigned char>(packet_size >> 0);
+    // Add MAC addresses
+    std::copy(source.begin(), source.end(), header + 4);
+    std::copy(destination.begin(), destination.end(), header + 10);
+    // Add fragment information, a single byte each
+    header[16] = isFragment;
+    header[17] = isLastFragment;
+    header[18] = fragmentId;
+}
+
 // Serialization method
 std::vector<unsigned char> AlServiceDataUnit::serialize() const {
     std::vector<unsigned char> serializedData;
 
-    // Calculate SDU size
-    uint32_t fragments_size = sizeof(isFragment) + sizeof(isLastFragment) + sizeof(fragmentId);// is fragment + is last fragment + fragment id
-    uint32_t packet_size = sourceAlMacAddress.size() + destinationAlMacAddress.size() + fragments_size + payload.size();
-
-    // put 32bit size as 8bit
-    serializedData = convert_u32_into_bytes(packet_size);
-
-    // Add MAC addresses
-    serializedData.insert(serializedData.end(), sourceAlMacAddress.begin(), sourceAlMacAddress.end());
-    serializedData.insert(serializedData.end(), destinationAlMacAddress.begin(), destinationAlMacAddress.end());
-
-    // Add fragment information
-    serializedData.push_back(static_cast<uint8_t>(isFragment));      // Ensure isFragment is stored as a single byte
-    serializedData.push_back(static_cast<uint8_t>(isLastFragment));  // Ensure isLastFragment is stored as a single byte
-    serializedData.push_back(static_cast<uint8_t>(fragmentId));
+    serializedData.reserve(PACKET_HEADER_SIZE + payload.size());
+    serializedData.resize(PACKET_HEADER_SIZE);
+    serializeHeader(serializedData.data(), sourceAlMacAddress, destinationAlMacAddress, isFragment, isLastFragment,
+        fragmentId, payload.size());
 
     // Add Payload
     serializedData.insert(serializedData.end(), payload.begin(), payload.end());
     #ifdef DEBUG_MODE
-    // Debugging output to confirm correct interpretation of flags
     std::cout << "Serialized Fragment Information - isFragment: " << static_cast<int>(isFragment)
               << ", isLastFragment: " << static_cast<int>(isLastFragment)
               << ", fragmentId: " << static_cast<int>(fragmentId) << std::endl;
@@ -68,31 +75,32 @@ std::vector<unsigned char> AlServiceDataUnit::serialize() const {
     return serializedData;
 }
 
-// Deserialization method
-void AlServiceDataUnit::deserialize(const std::vector<unsigned char>& data) {
+void AlServiceDataUnit::deserializeHeader(const unsigned char *data, size_t length) {
     // Each packet contains a header and a payload. The header size is
     // 4 (length) + 6 (MAC) + 6 (MAC) + 3 x 1 (3 x 1 byte flags) = 19 bytes.
     // Because of that, the packet should be atleast 19 bytes, discard if not.
-    if (data.size() < PACKET_HEADER_SIZE) {
+    if (length < PACKET_HEADER_SIZE) {
         throw AlServiceException("Insufficient data to deserialize AlServiceDataUnit", PrimitiveError::DeserializationError);
     }
 
-    auto data_raw = remove_length_delimited_part(data);
-
     // Extract MAC addresses
-    std::copy(data_raw.begin(), data_raw.begin() + 6, sourceAlMacAddress.begin());
-    std::copy(data_raw.begin() + 6, data_raw.begin() + 12, destinationAlMacAddress.begin());
+    std::copy(data + 4, data + 10, sourceAlMacAddress.begin());
+    std::copy(data + 10, data + 16, destinationAlMacAddress.begin());
 
-    // Extract fragment information, ensuring correct byte interpretation
-    isFragment = static_cast<uint8_t>(data_raw[12]);
-    isLastFragment = static_cast<uint8_t>(data_raw[13]);
-    fragmentId = static_cast<uint8_t>(data_raw[14]);
+    // Extract fragment information
+    isFragment = static_cast<uint8_t>(data[16]);
+    isLastFragment = static_cast<uint8_t>(data[17]);
+    fragmentId = static_cast<uint8_t>(data[18]);
+}
+
+// Deserialization method
+void AlServiceDataUnit::deserialize(const std::vector<unsigned char>& data) {
+    deserializeHeader(data.data(), data.size());
     #ifdef DEBUG_MODE
-    // Debugging output to confirm correct interpretation of flags
     std::cout << "Deserialized Fragment Information - isFragment: " << static_cast<int>(isFragment)
               << ", isLastFragment: " << static_cast<int>(isLastFragment)
               << ", fragmentId: " << static_cast<int>(fragmentId) << std::endl;
     #endif
     // Extract Payload
-    payload.assign(data_raw.begin() + 15, data_raw.end());
+    payload.assign(data.begin() + PACKET_HEADER_SIZE, data.end());
 }
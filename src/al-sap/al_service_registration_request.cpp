@@ -48,8 +48,8 @@ std::vector<unsigned char> AlServiceRegistrationRequest::serializeRegistrationRe
 
 // Deserialization method: Populates the request from a byte vector
 void AlServiceRegistrationRequest::deserializeRegistrationRequest(const std::vector<unsigned char>& data) {
-    auto data_raw = remove_length_delimited_part(data);
-    if (data.size() >= SIZE_BYTES) {
+    if (data.size() >= FRAMED_SIZE_BYTES) {
+        auto data_raw = remove_length_delimited_part(data);
         serviceOperation = static_cast<SAPActivation>(data_raw[0]);
         serviceType = static_cast<ServiceType>(data_raw[1]);
 
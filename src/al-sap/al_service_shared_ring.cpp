@@ -0,0 +1,270 @@
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <algorithm>
+#include <limits>
+#include <iostream>
+#include "al_service_shared_ring.h"
+#include "al_service_exception.h"
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "the ring indexes are shared between processes");
+
+// Records are 8 bytes aligned so that a filler length always fits in front of the end
+static uint64_t recordSize(size_t length) {
+    return (SAP_RING_RECORD_HEADER_SIZE + length + 7) & ~static_cast<uint64_t>(7);
+}
+
+// Creates the memfd and the eventfds, the first direction is the one this end produces into
+AlServiceSharedRing::AlServiceSharedRing(size_t ringSize) : ringSize(ringSize) {
+    // both directions have to fit in the memfd, whose size is an off_t
+    constexpr size_t maxRingSize = static_cast<size_t>(std::numeric_limits<off_t>::max()) / 2 - sizeof(AlServiceRingControl);
+    if (ringSize == 0 || (ringSize % 8) != 0 || ringSize > maxRingSize) {
+        throw AlServiceException("Invalid shared ring size", PrimitiveError::SocketCreationFailed);
+    }
+    memoryDescriptor = memfd_create("al_sap_ring", MFD_CLOEXEC);
+    if (memoryDescriptor == -1 ||
+        ftruncate(memoryDescriptor, static_cast<off_t>(2 * (sizeof(AlServiceRingControl) + ringSize))) == -1) {
+        if (memoryDescriptor != -1) {
+            close(memoryDescriptor);
+        }
+        throw AlServiceException("Failed to create the shared ring memory", PrimitiveError::SocketCreationFailed);
+    }
+    for (int& event : eventDescriptors) {
+        if ((event = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) == -1) {
+            release();
+            throw AlServiceException("Failed to create the shared ring event", PrimitiveError::SocketCreationFailed);
+        }
+    }
+    try {
+        map(true);
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+// Attaches to the memory of the other end, its size tells the size of the rings
+AlServiceSharedRing::AlServiceSharedRing(int memoryDescriptor, const std::array<int, 2>& eventDescriptors) :
+    ringSize(0), memoryDescriptor(memoryDescriptor), eventDescriptors(eventDescriptors) {
+    struct stat st;
+
+    if (fstat(memoryDescriptor, &st) == -1 || static_cast<size_t>(st.st_size) <= 2 * sizeof(AlServiceRingControl) ||
+        (static_cast<size_t>(st.st_size) % 16) != 0) {
+        release();
+        throw AlServiceException("Invalid shared ring memory", PrimitiveError::SocketCreationFailed);
+    }
+    ringSize = static_cast<size_t>(st.st_size) / 2 - sizeof(AlServiceRingControl);
+    try {
+        map(false);
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+AlServiceSharedRing::~AlServiceSharedRing() {
+    release();
+}
+
+void AlServiceSharedRing::release() {
+    if (memory != nullptr) {
+        munmap(memory, 2 * (sizeof(AlServiceRingControl) + ringSize));
+        memory = nullptr;
+    }
+    if (memoryDescriptor != -1) {
+        close(memoryDescriptor);
+        memoryDescriptor = -1;
+    }
+    for (int& event : eventDescriptors) {
+        if (event != -1) {
+            close(event);
+            event = -1;
+        }
+    }
+}
+
+void AlServiceSharedRing::map(bool creator) {
+    size_t direction = sizeof(AlServiceRingControl) + ringSize;
+    void *addr = mmap(nullptr, 2 * direction, PROT_READ | PROT_WRITE, MAP_SHARED, memoryDescriptor, 0);
+
+    if (addr == MAP_FAILED) {
+        throw AlServiceException("Failed to map the shared ring memory", PrimitiveError::SocketCreationFailed);
+    }
+    memory = static_cast<unsigned char *>(addr);
+
+    AlServiceRingControl *first = reinterpret_cast<AlServiceRingControl *>(memory);
+    AlServiceRingControl *second = reinterpret_cast<AlServiceRingControl *>(memory + direction);
+    if (creator) {
+        // The memfd starts zeroed, the indexes only need constructing
+        new (first) AlServiceRingControl();
+        new (second) AlServiceRingControl();
+        first->head = first->tail = 0;
+        second->head = second->tail = 0;
+    }
+
+    txControl = creator ? first : second;
+    txData = reinterpret_cast<unsigned char *>(txControl) + sizeof(AlServiceRingControl);
+    txEvent = eventDescriptors[creator ? 0 : 1];
+    rxControl = creator ? second : first;
+    rxData = reinterpret_cast<unsigned char *>(rxControl) + sizeof(AlServiceRingControl);
+    rxEvent = eventDescriptors[creator ? 1 : 0];
+}
+
+void AlServiceSharedRing::sendDescriptors(int socketDescriptor) const {
+    int fds[3] = {memoryDescriptor, eventDescriptors[0], eventDescriptors[1]};
+    char control[CMSG_SPACE(sizeof(fds))] = {};
+    struct iovec iov = {const_cast<char *>(SAP_RING_HANDSHAKE), sizeof(SAP_RING_HANDSHAKE)};
+    struct msghdr msg = {};
+
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    if (sendmsg(socketDescriptor, &msg, MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(SAP_RING_HANDSHAKE))) {
+        throw AlServiceException("Failed to send the shared ring descriptors", PrimitiveError::RequestFailed);
+    }
+}
+
+std::unique_ptr<AlServiceSharedRing> AlServiceSharedRing::receiveDescriptors(int socketDescriptor) {
+    int fds[3] = {-1, -1, -1};
+    char handshake[sizeof(SAP_RING_HANDSHAKE)];
+    char control[CMSG_SPACE(sizeof(fds))] = {};
+    struct iovec iov = {handshake, sizeof(handshake)};
+    struct msghdr msg = {};
+
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    ssize_t bytesRead = recvmsg(socketDescriptor, &msg, MSG_WAITALL | MSG_CMSG_CLOEXEC);
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    if (cmsg != nullptr && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
+        cmsg->cmsg_len == CMSG_LEN(sizeof(fds))) {
+        memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+    }
+    if (bytesRead != static_cast<ssize_t>(sizeof(handshake)) || memcmp(handshake, SAP_RING_HANDSHAKE, sizeof(handshake)) != 0 ||
+        fds[0] == -1) {
+        for (int fd : fds) {
+            if (fd != -1) {
+                close(fd);
+            }
+        }
+        throw AlServiceException("Invalid shared ring handshake", PrimitiveError::InvalidMessage);
+    }
+
+    return std::unique_ptr<AlServiceSharedRing>(new AlServiceSharedRing(fds[0], {{fds[1], fds[2]}}));
+}
+
+bool AlServiceSharedRing::push(const std::array<uint8_t, 6>& source, const std::array<uint8_t, 6>& destination,
+    const unsigned char *payload, size_t length) {
+    uint64_t head = txControl->head.load(std::memory_order_relaxed);
+    uint64_t start = head;
+    uint64_t tail = txControl->tail.load(std::memory_order_acquire);
+    uint64_t size = recordSize(length);
+    uint64_t offset = head % ringSize;
+
+    if (length > getMaxPayload()) {
+        return false;
+    }
+
+    // A record does not wrap, the end of the ring is skipped with a filler once there is room for it
+    if (offset + size > ringSize) {
+        if (head - tail + (ringSize - offset) > ringSize) {
+            return false;
+        }
+        uint32_t wrap = SAP_RING_WRAP;
+        memcpy(txData + offset, &wrap, sizeof(wrap));
+        head += ringSize - offset;
+        offset = 0;
+        txControl->head.store(head, std::memory_order_seq_cst);
+    }
+    if (head - tail + size > ringSize) {
+        return false;
+    }
+
+    uint32_t value = static_cast<uint32_t>(length);
+    unsigned char *record = txData + offset;
+    memcpy(record, &value, sizeof(value));
+    memcpy(record + 4, source.data(), source.size());
+    memcpy(record + 10, destination.data(), destination.size());
+    if (length > 0) {
+        memcpy(record + SAP_RING_RECORD_HEADER_SIZE, payload, length);
+    }
+    txControl->head.store(head + size, std::memory_order_seq_cst);
+
+    // The consumer clears the event before it finds the ring empty, so only a record written into
+    // an empty ring needs one, the consumer reads the head again after every release otherwise
+    if (txControl->tail.load(std::memory_order_seq_cst) >= start) {
+        uint64_t one = 1;
+        if (write(txEvent, &one, sizeof(one)) == -1 && errno != EAGAIN) {
+            std::cout << "Failed to signal the shared ring, err: " << errno << std::endl;
+        }
+    }
+
+    return true;
+}
+
+const unsigned char *AlServiceSharedRing::peek(size_t& length, std::array<uint8_t, 6>& source, std::array<uint8_t, 6>& destination) {
+    uint64_t tail = rxControl->tail.load(std::memory_order_relaxed);
+
+    while (true) {
+        uint64_t head = rxControl->head.load(std::memory_order_seq_cst);
+        uint64_t offset = tail % ringSize;
+        uint32_t value;
+
+        if (tail == head) {
+            return nullptr;
+        }
+        memcpy(&value, rxData + offset, sizeof(value));
+        if (value == SAP_RING_WRAP) {
+            tail += ringSize - offset;
+            rxControl->tail.store(tail, std::memory_order_seq_cst);
+            continue;
+        }
+
+        // The other end is a separate process, a corrupted record must not take this one down
+        if (value > getMaxPayload() || recordSize(value) > ringSize - offset || recordSize(value) > head - tail) {
+            throw AlServiceException("Invalid shared ring record", PrimitiveError::InvalidMessage);
+        }
+        const unsigned char *record = rxData + offset;
+        length = value;
+        std::copy(record + 4, record + 10, source.begin());
+        std::copy(record + 10, record + 16, destination.begin());
+        rxRecordSize = recordSize(value);
+        return record + SAP_RING_RECORD_HEADER_SIZE;
+    }
+}
+
+void AlServiceSharedRing::pop() {
+    if (rxRecordSize != 0) {
+        rxControl->tail.fetch_add(rxRecordSize, std::memory_order_seq_cst);
+        rxRecordSize = 0;
+    }
+}
+
+void AlServiceSharedRing::clearEvent() {
+    uint64_t count;
+
+    if (read(rxEvent, &count, sizeof(count)) == -1 && errno != EAGAIN) {
+        std::cout << "Failed to clear the shared ring event, err: " << errno << std::endl;
+    }
+}
+
+int AlServiceSharedRing::getEventDescriptor() const {
+    return rxEvent;
+}
+
+size_t AlServiceSharedRing::getMaxPayload() const {
+    return std::min(ringSize - SAP_RING_RECORD_HEADER_SIZE, static_cast<size_t>(SAP_RING_WRAP - 1));
+}
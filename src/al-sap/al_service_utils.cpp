@@ -82,5 +82,7 @@ uint32_t convert_bytes_into_u32(const std::vector<unsigned char>& bytes)
 
 std::vector<unsigned char> remove_length_delimited_part(const std::vector<unsigned char>& buffer)
 {
+    if (buffer.size() < sizeof(uint32_t))
+        return std::vector<unsigned char>();
     return std::vector<unsigned char>(buffer.cbegin() + sizeof(uint32_t), buffer.cend());
 }
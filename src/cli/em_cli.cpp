@@ -38,6 +38,9 @@
 #include "em_cli.h"
 #include <readline/readline.h>
 #include <readline/history.h>
+
+#include <string>
+#include <vector>
 em_cli_t g_cli;
 
 em_network_node_t *em_cli_t::get_reset_tree(char *platform)
@@ -224,7 +227,10 @@ em_network_node_t *em_cli_t::exec(char *in, size_t sz, em_network_node_t *node)
     em_cmd_cli_t *cli_cmd;
 
     snprintf(cmd, sizeof(cmd),  "%s", in);
+    // the spec is copied into the command, which then runs alongside those of the other threads
+    pthread_mutex_lock(&m_cmd_lock);
     cli_cmd = new em_cmd_cli_t(get_command(cmd, sz, node), m_params.user_data.addr);
+    pthread_mutex_unlock(&m_cmd_lock);
 
     if (cli_cmd->init() != 0) {
         printf("%s:%d: Failed to init command\n", __func__, __LINE__);
@@ -250,6 +256,107 @@ em_network_node_t *em_cli_t::exec(char *in, size_t sz, em_network_node_t *node)
 	return new_node;
 }
 
+static int append_batch_result(void *arg, const char *data, unsigned int len)
+{
+    static_cast<std::string *> (arg)->append(data, len);
+
+    return 0;
+}
+
+unsigned int em_cli_t::exec_batch(char **in, em_network_node_t **nodes, unsigned int num, em_network_node_t **out)
+{
+    em_long_string_t cmd, status;
+    em_cmd_cli_t *cli_cmd;
+    std::vector<std::string> events, results(num);
+    std::vector<unsigned int> index, lens;
+    std::vector<unsigned char *> cmds;
+    std::vector<void *> args;
+    unsigned int i, done, num_out = 0;
+
+    // the events are built up front, a command that cannot be sent gets its status in place
+    for (i = 0; i < num; i++) {
+        out[i] = NULL;
+        snprintf(cmd, sizeof(cmd), "%s", in[i]);
+        pthread_mutex_lock(&m_cmd_lock);
+        cli_cmd = new em_cmd_cli_t(get_command(cmd, strlen(cmd), (nodes != NULL) ? nodes[i]:NULL), m_params.user_data.addr);
+        pthread_mutex_unlock(&m_cmd_lock);
+        if ((cli_cmd->validate() == true) && (cli_cmd->build_event() == 0)) {
+            // the event goes encoded, only as long as its arguments and subdocument
+            events.emplace_back(sizeof(em_cmd_wire_hdr_t) + cli_cmd->get_event_length(), 0);
+            events.back().resize(em_cmd_exec_t::encode_event(cli_cmd->get_event(),
+                reinterpret_cast<unsigned char *> (&events.back()[0]), static_cast<unsigned int> (events.back().size())));
+            if (events.back().empty() == false) {
+                index.push_back(i);
+            } else {
+                events.pop_back();
+            }
+        }
+        if ((index.empty() == true) || (index.back() != i)) {
+            cli_cmd->m_cmd.status_to_string(em_cmd_out_status_invalid_input, status);
+            results[i] = status;
+        }
+        delete cli_cmd;
+    }
+
+    for (auto& it : events) {
+        cmds.push_back(reinterpret_cast<unsigned char *> (&it[0]));
+        lens.push_back(static_cast<unsigned int> (it.size()));
+    }
+    for (auto it : index) {
+        args.push_back(&results[it]);
+    }
+
+    // the commands after the first unanswered one have no result
+    done = 0;
+    if (events.size() > 0) {
+        em_cmd_cli_t conn(em_cmd_cli_t::m_client_cmd_spec[em_cmd_type_none], m_params.user_data.addr);
+        done = conn.transact_batch(em_service_type_ctrl, &cmds[0], &lens[0], static_cast<unsigned int> (events.size()),
+            append_batch_result, &args[0]);
+    }
+
+    for (i = 0; i < num; i++) {
+        if ((done < index.size()) && (i >= index[done])) {
+            break;
+        }
+        if ((results[i].empty() == false) && ((out[i] = em_net_node_t::get_network_tree(&results[i][0])) != NULL)) {
+            num_out++;
+        }
+    }
+
+    return num_out;
+}
+
+unsigned int em_cli_t::exec_batch_file(const char *file_name, em_network_node_t **out, unsigned int max)
+{
+    FILE *fp;
+    em_long_string_t line;
+    std::vector<std::string> lines;
+    std::vector<char *> in;
+    size_t len;
+
+    if ((fp = fopen(file_name, "r")) == NULL) {
+        printf("%s:%d: failed to open file:%s error:%d\n", __func__, __LINE__, file_name, errno);
+        return 0;
+    }
+
+    // a command per line, blank lines and lines starting with # are skipped
+    while ((lines.size() < max) && (fgets(line, sizeof(line), fp) != NULL)) {
+        len = strcspn(line, "\r\n");
+        line[len] = 0;
+        if ((len == 0) || (line[0] == '#')) {
+            continue;
+        }
+        lines.push_back(line);
+    }
+    fclose(fp);
+
+    for (auto& it : lines) {
+        in.push_back(&it[0]);
+    }
+
+    return (in.size() > 0) ? exec_batch(&in[0], NULL, static_cast<unsigned int> (in.size()), out):0;
+}
+
 void em_cli_t::init_lib_dbg(char *file_name)
 {
     FILE *fp;
@@ -295,10 +402,12 @@ int em_cli_t::set_remote_addr(unsigned int ip, unsigned int port, bool valid)
 
 em_cli_t::em_cli_t()
 {
+    pthread_mutex_init(&m_cmd_lock, NULL);
 }
 
 em_cli_t::~em_cli_t()
 {
+    pthread_mutex_destroy(&m_cmd_lock);
 }
 
 em_cli_t *get_cli()
@@ -311,6 +420,16 @@ extern "C" em_network_node_t *exec(char *in, size_t in_len, em_network_node_t *n
     return g_cli.exec(in, in_len, node);
 }
 
+extern "C" unsigned int exec_batch(char **in, em_network_node_t **nodes, unsigned int num, em_network_node_t **out)
+{
+    return g_cli.exec_batch(in, nodes, num, out);
+}
+
+extern "C" unsigned int exec_batch_file(const char *file_name, em_network_node_t **out, unsigned int max)
+{
+    return g_cli.exec_batch_file(file_name, out, max);
+}
+
 extern "C" int set_remote_addr(unsigned int ip, unsigned int port, bool valid)
 {
     return g_cli.set_remote_addr(ip, port, valid);
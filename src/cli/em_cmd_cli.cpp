@@ -69,6 +69,9 @@ em_cmd_params_t spec_params[] = {
     {.u = {.args = {2, {"", "", "", "", ""}, "MLDConfig"}}},
     {.u = {.args = {2, {"", "", "", "", ""}, "MLDReconfig"}}},
 	{.u = {.args = {2, {"", "", "", "", ""}, "DevTest.json"}}},
+	{.u = {.args = {2, {"", "", "", "", ""}, "OrchStats"}}},
+	{.u = {.args = {2, {"", "", "", "", ""}, "PerfStats"}}},
+	{.u = {.args = {2, {"", "", "", "", ""}, "MemStats"}}},
 	{.u = {.args = {0, {"", "", "", "", ""}, "max"}}},
 };
 
@@ -103,7 +106,10 @@ em_cmd_t em_cmd_cli_t::m_client_cmd_spec[] = {
     em_cmd_t(em_cmd_type_get_mld_config, spec_params[26]),
     em_cmd_t(em_cmd_type_mld_reconfig, spec_params[27]),
     em_cmd_t(em_cmd_type_set_dev_test, spec_params[28]),
-    em_cmd_t(em_cmd_type_max, spec_params[29]),
+    em_cmd_t(em_cmd_type_get_orch_stats, spec_params[29]),
+    em_cmd_t(em_cmd_type_get_perf_stats, spec_params[30]),
+    em_cmd_t(em_cmd_type_get_mem_stats, spec_params[31]),
+    em_cmd_t(em_cmd_type_max, spec_params[32]),
 };
 
 int em_cmd_cli_t::get_edited_node(em_network_node_t *node, const char *header, char *buff)
@@ -163,26 +169,23 @@ int em_cmd_cli_t::get_edited_node(em_network_node_t *node, const char *header, c
 	return strlen(formatted) + 1;
 }
 
-int em_cmd_cli_t::execute(char *result)
+int em_cmd_cli_t::build_event()
 {
-    int ret, dsock;
     em_bus_event_t *bevt;
     em_subdoc_info_t    *info;
     em_event_t *evt;
     em_cmd_params_t *param;
     dm_easy_mesh_t dm;
-    unsigned char *tmp;
     em_long_string_t	in;
     em_status_string_t out;
 	em_network_node_t *node;
-	SSL_CTX *ctx;
-	SSL *ssl;
 
     evt = get_event();
     param = get_param();
 
     evt->type = em_event_type_bus;
     bevt = &evt->u.bevt;
+    bevt->data_len = 0;
     memcpy(&bevt->params, param, sizeof(em_cmd_params_t));
 
     switch (get_type()) {
@@ -456,6 +459,23 @@ int em_cmd_cli_t::execute(char *result)
             snprintf(info->name, sizeof(info->name), "%s", param->u.args.fixed_args);
             break;
 
+        case em_cmd_type_get_orch_stats:
+            bevt->type = em_bus_event_type_get_orch_stats;
+            info = &bevt->u.subdoc;
+            snprintf(info->name, sizeof(info->name), "%s", param->u.args.fixed_args);
+            break;
+
+        case em_cmd_type_get_perf_stats:
+            bevt->type = em_bus_event_type_get_perf_stats;
+            info = &bevt->u.subdoc;
+            snprintf(info->name, sizeof(info->name), "%s", param->u.args.fixed_args);
+            break;
+        case em_cmd_type_get_mem_stats:
+            bevt->type = em_bus_event_type_get_mem_stats;
+            info = &bevt->u.subdoc;
+            snprintf(info->name, sizeof(info->name), "%s", param->u.args.fixed_args);
+            break;
+
         default:
             break;
     }
@@ -464,41 +484,33 @@ int em_cmd_cli_t::execute(char *result)
 
     get_cmd()->init(dm);
 
-	ctx = SSL_CTX_new(TLS_client_method());
-    SSL_CTX_use_certificate_file(ctx, EM_CERT_FILE, SSL_FILETYPE_PEM);
- 
-	if ((ssl = get_ep_for_dst_svc(ctx, em_service_type_ctrl)) == NULL) {
-		//printf("%s:%d: Can not get socket for service\n", __func__, __LINE__);
-		snprintf(result, sizeof(em_long_string_t), "%s:%d: connect error on socket, err:%d\n", __func__, __LINE__, errno);
-		SSL_CTX_free(ctx);
-		return -1;
-	} 
-
-    tmp = (unsigned char *)get_event();
+    return 0;
+}
 
-	dsock = SSL_get_fd(ssl);
+int em_cmd_cli_t::execute(char *result)
+{
+    unsigned char *buff;
+    unsigned int len;
+    int ret = 0;
 
-    if ((ret = SSL_write(ssl, tmp, get_event_length())) <= 0) {
-		close(dsock);		
-		SSL_free(ssl);
-		SSL_CTX_free(ctx);
+    if (build_event() != 0) {
         return -1;
-	}
-    
-    /* Receive result. */
-    if ((ret = SSL_read(ssl, (unsigned char *)result, EM_MAX_EVENT_DATA_LEN)) <= 0) {
-        printf("%s:%d: result read error on socket, err:%d\n", __func__, __LINE__, errno);
-		close(dsock);		
-		SSL_free(ssl);
-		SSL_CTX_free(ctx);
+    }
+
+    len = static_cast<unsigned int> (sizeof(em_cmd_wire_hdr_t)) + get_event_length();
+    if ((buff = static_cast<unsigned char *> (malloc(len))) == NULL) {
         return -1;
     }
 
-    close(dsock);
-	SSL_free(ssl);
-	SSL_CTX_free(ctx);
+	// the connection to the controller stays open for the next command
+	if (((len = encode_event(get_event(), buff, len)) == 0) ||
+			(transact(em_service_type_ctrl, buff, len, result, EM_MAX_EVENT_DATA_LEN) != 0)) {
+		printf("%s:%d: %s", __func__, __LINE__, result);
+		ret = -1;
+	}
+    free(buff);
 
-    return 0;
+    return ret;
 }
 
 em_cmd_cli_t::em_cmd_cli_t(em_cmd_t& obj, struct sockaddr_in& addr)
@@ -33,6 +33,7 @@
 #include <unistd.h>
 #include <pthread.h>
 #include <cjson/cJSON.h>
+#include <new>
 #include "em_cmd.h"
 
 bool em_cmd_t::validate()
@@ -110,58 +111,53 @@ void em_cmd_t::copy_frame_event(em_frame_event_t *evt)
 	memcpy(fevt->frame, evt->frame, evt->frame_len);			
 }	
 
-char *em_cmd_t::status_to_string(em_cmd_out_status_t status, char *str)
+const char *em_cmd_t::get_status_string(em_cmd_out_status_t status)
 {
-    cJSON *obj, *res = NULL;
-    em_long_string_t status_str;
-    em_subdoc_info_t *info;
-    em_event_t *evt;
-    char *tmp;
-
-    evt = get_event();
-    info = &evt->u.bevt.u.subdoc;
-
-    obj = cJSON_CreateObject();
-
     switch (status) {
         case em_cmd_out_status_success:
-            snprintf(status_str, sizeof(status_str), "%s", "Success");
-            break;
+            return "Success";
 
         case em_cmd_out_status_not_ready:
-            snprintf(status_str, sizeof(status_str), "%s", "Error_Not_Ready");
-            break;
+            return "Error_Not_Ready";
 
         case em_cmd_out_status_invalid_input:
-            snprintf(status_str, sizeof(status_str), "%s", "Error_Invalid_Input");
-            break;
+            return "Error_Invalid_Input";
 
         case em_cmd_out_status_timeout:
-            snprintf(status_str, sizeof(status_str), "%s", "Error_Timeout");
-            break;
+            return "Error_Timeout";
 
         case em_cmd_out_status_invalid_mac:
-            snprintf(status_str, sizeof(status_str), "%s", "Error_Invalid_Mac");
-            break;
+            return "Error_Invalid_Mac";
 
         case em_cmd_out_status_interface_down:
-            snprintf(status_str, sizeof(status_str), "%s", "Error_Interface_Down");
-            break;
+            return "Error_Interface_Down";
 
         case em_cmd_out_status_other:
-            snprintf(status_str, sizeof(status_str), "%s", "Error_Other");
-            break;
+            return "Error_Other";
 
         case em_cmd_out_status_prev_cmd_in_progress:
-            snprintf(status_str, sizeof(status_str), "%s", "Error_Prev_Cmd_In_Progress");
-            break;
+            return "Error_Prev_Cmd_In_Progress";
 
         case em_cmd_out_status_no_change:
-            snprintf(status_str, sizeof(status_str), "%s", "Error_No_Config_Change_Detected");
-            break;
+            return "Error_No_Config_Change_Detected";
     }
 
-    cJSON_AddStringToObject(obj, "Status", status_str);
+    return "";
+}
+
+char *em_cmd_t::status_to_string(em_cmd_out_status_t status, char *str)
+{
+    cJSON *obj, *res = NULL;
+    em_subdoc_info_t *info;
+    em_event_t *evt;
+    char *tmp;
+
+    evt = get_event();
+    info = &evt->u.bevt.u.subdoc;
+
+    obj = cJSON_CreateObject();
+
+    cJSON_AddStringToObject(obj, "Status", get_status_string(status));
     if (status == em_cmd_out_status_success) {
         res = cJSON_Parse(info->buff);
         if (res != NULL) {
@@ -180,26 +176,100 @@ char *em_cmd_t::status_to_string(em_cmd_out_status_t status, char *str)
 void em_cmd_t::deinit()
 {
     queue_destroy(m_em_candidates);
-    m_data_model.deinit();
+    release_snapshot();
 	//free(m_evt);
 }
 
+void em_cmd_t::release_snapshot()
+{
+    if (m_snapshot == NULL) {
+        return;
+    }
+
+    if (m_snapshot->refs.fetch_sub(1) == 1) {
+        if (m_snapshot->initialized == true) {
+            m_snapshot->dm.deinit();
+        }
+        delete m_snapshot;
+    }
+    m_snapshot = NULL;
+    m_data_model = NULL;
+}
+
 void em_cmd_t::init(dm_easy_mesh_t& dm)
 {
     m_em_candidates = queue_create();
-    m_data_model.init();
-    m_data_model = dm;
+    get_own_data_model();
+    if (m_snapshot->initialized == false) {
+        m_data_model->init();
+        m_snapshot->initialized = true;
+    }
+    *m_data_model = dm;
+}
+
+void *em_cmd_snapshot_t::operator new(size_t size)
+{
+    void *ptr;
+
+    if ((ptr = em_cmd_pool_t::get_pool()->alloc(size)) == NULL) {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+void em_cmd_snapshot_t::operator delete(void *ptr)
+{
+    em_cmd_pool_t::get_pool()->release(ptr);
+}
+
+void *em_cmd_t::operator new(size_t size)
+{
+    void *ptr;
+
+    if ((ptr = em_cmd_pool_t::get_pool()->alloc(size)) == NULL) {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+void em_cmd_t::operator delete(void *ptr)
+{
+    em_cmd_pool_t::get_pool()->release(ptr);
+}
+
+dm_easy_mesh_t *em_cmd_t::get_own_data_model()
+{
+    em_cmd_snapshot_t *snapshot;
+
+    if ((m_snapshot != NULL) && (m_snapshot->refs.load() == 1)) {
+        return m_data_model;
+    }
+
+    snapshot = new em_cmd_snapshot_t();
+    snapshot->refs = 1;
+    snapshot->initialized = false;
+    if ((m_snapshot != NULL) && (m_snapshot->initialized == true)) {
+        snapshot->dm.init();
+        snapshot->dm = m_snapshot->dm;
+        snapshot->initialized = true;
+    }
+    release_snapshot();
+    m_snapshot = snapshot;
+    m_data_model = &m_snapshot->dm;
+
+    return m_data_model;
 }
 
 em_cmd_t *em_cmd_t::clone()
 {   
     em_cmd_t *out = NULL;
     unsigned int i;
-    em_cmd_ctx_t *pctx, ctx;
 
-    out = new em_cmd_t(m_type, m_param, m_data_model);
+    // the clone shares the data model, only the context is its own
+    out = new em_cmd_t(this);
 
-    out->m_data_model = m_data_model;
     out->set_orch_op_index(m_orch_op_idx);
     out->m_num_orch_desc = m_num_orch_desc;
     for (i = 0; i < m_num_orch_desc; i++) {
@@ -207,10 +277,8 @@ em_cmd_t *em_cmd_t::clone()
         out->m_orch_desc[i].submit = m_orch_desc[i].submit;
     }
 
-    pctx = m_data_model.get_cmd_ctx();	
-    memcpy(&ctx, pctx, sizeof(em_cmd_ctx_t));	
-    ctx.arr_index += 1;
-    out->m_data_model.set_cmd_ctx(&ctx);
+    out->set_cmd_ctx(&m_ctx);
+    out->m_ctx.arr_index += 1;
     return out;
 }
 
@@ -220,13 +288,13 @@ em_cmd_t *em_cmd_t::clone_for_next()
     unsigned int i;
     em_cmd_ctx_t ctx;
 
-    if (m_orch_op_idx == (m_num_orch_desc - 1)) {
+    // the orchestrator runs the next steps on this command
+    if ((m_orch_in_place == true) || (m_orch_op_idx == (m_num_orch_desc - 1))) {
         return NULL;
     }
 
-    out = new em_cmd_t(m_type, m_param, m_data_model);
+    out = new em_cmd_t(this);
 
-    out->m_data_model = m_data_model;
     out->set_orch_op_index(m_orch_op_idx + 1);
     out->m_num_orch_desc = m_num_orch_desc;
     for (i = 0; i < m_num_orch_desc; i++) {
@@ -236,20 +304,32 @@ em_cmd_t *em_cmd_t::clone_for_next()
 
     memset(&ctx, 0, sizeof(em_cmd_ctx_t));
     ctx.type = out->get_orch_op();
-    out->m_data_model.set_cmd_ctx(&ctx);
+    out->set_cmd_ctx(&ctx);
 
     return out;
 }
 
-void em_cmd_t::override_op(unsigned int index, em_orch_desc_t *desc)
+bool em_cmd_t::advance_orch_op()
 {
-    em_cmd_ctx_t *ctx;
+    em_cmd_ctx_t ctx;
 
+    if ((m_orch_op_idx + 1) >= m_num_orch_desc) {
+        return false;
+    }
+
+    m_orch_op_idx++;
+    memset(&ctx, 0, sizeof(em_cmd_ctx_t));
+    ctx.type = get_orch_op();
+    set_cmd_ctx(&ctx);
+
+    return true;
+}
+
+void em_cmd_t::override_op(unsigned int index, em_orch_desc_t *desc)
+{
     m_orch_desc[index].op = desc->op;
     m_orch_desc[index].submit = desc->submit;
-    ctx = m_data_model.get_cmd_ctx();
-    ctx->type = desc->op;
-    m_data_model.set_cmd_ctx(ctx);
+    m_ctx.type = desc->op;
 }
 
 void em_cmd_t::init()
@@ -457,6 +537,26 @@ void em_cmd_t::init()
             m_svc = em_service_type_ctrl;
             break;
 
+        case em_cmd_type_get_orch_stats:
+            snprintf(m_name, sizeof(m_name), "%s", "get_orch_stats");
+            m_svc = em_service_type_ctrl;
+            break;
+
+        case em_cmd_type_get_perf_stats:
+            snprintf(m_name, sizeof(m_name), "%s", "get_perf_stats");
+            m_svc = em_service_type_ctrl;
+            break;
+
+        case em_cmd_type_get_mem_stats:
+            snprintf(m_name, sizeof(m_name), "%s", "get_mem_stats");
+            m_svc = em_service_type_ctrl;
+            break;
+
+        case em_cmd_type_sta_steer_batch:
+            snprintf(m_name, sizeof(m_name), "%s", "sta_steer_batch");
+            m_svc = em_service_type_ctrl;
+            break;
+
         default:
             break;
 
@@ -500,6 +600,9 @@ const char *em_cmd_t::get_bus_event_type_str(em_bus_event_type_t type)
         BUS_EVENT_TYPE_2S(em_bus_event_type_get_mld_config)
         BUS_EVENT_TYPE_2S(em_bus_event_type_mld_reconfig)
         BUS_EVENT_TYPE_2S(em_bus_event_type_get_reset)
+        BUS_EVENT_TYPE_2S(em_bus_event_type_get_orch_stats)
+        BUS_EVENT_TYPE_2S(em_bus_event_type_get_perf_stats)
+        BUS_EVENT_TYPE_2S(em_bus_event_type_get_mem_stats)
        
         default:
            break;
@@ -507,6 +610,24 @@ const char *em_cmd_t::get_bus_event_type_str(em_bus_event_type_t type)
     return "em_bus_event_type_unknown";
 }   
 
+const char *em_cmd_t::get_profile_type_str(em_profile_domain_t domain, unsigned int type)
+{
+    if (domain == em_profile_domain_bus) {
+        return get_bus_event_type_str(static_cast<em_bus_event_type_t>(type));
+    } else if (domain != em_profile_domain_event) {
+        return NULL;
+    }
+
+    switch (type) {
+        case em_event_type_frame:   return "em_event_type_frame";
+        case em_event_type_device:  return "em_event_type_device";
+        case em_event_type_node:    return "em_event_type_node";
+        case em_event_type_nb:      return "em_event_type_nb";
+        case em_event_type_action:  return "em_event_type_action";
+        default:                    return NULL;
+    }
+}
+
 const char *em_cmd_t::get_orch_op_str(dm_orch_type_t type)
 {
 #define ORCH_TYPE_2S(x) case x: return #x;
@@ -631,6 +752,10 @@ const char *em_cmd_t::get_cmd_type_str(em_cmd_type_t type)
         CMD_TYPE_2S(em_cmd_type_beacon_report)
         CMD_TYPE_2S(em_cmd_type_ap_metrics_report)
         CMD_TYPE_2S(em_cmd_type_get_reset)
+        CMD_TYPE_2S(em_cmd_type_get_orch_stats)
+        CMD_TYPE_2S(em_cmd_type_get_perf_stats)
+        CMD_TYPE_2S(em_cmd_type_get_mem_stats)
+        CMD_TYPE_2S(em_cmd_type_sta_steer_batch)
 
         default:
            break;
@@ -639,6 +764,46 @@ const char *em_cmd_t::get_cmd_type_str(em_cmd_type_t type)
     return "em_cmd_type_unknown";
 }
 
+em_cmd_prio_t em_cmd_t::get_cmd_prio(em_cmd_type_t type)
+{
+    switch (type) {
+        case em_cmd_type_steer_sta:
+        case em_cmd_type_disassoc_sta:
+        case em_cmd_type_btm_sta:
+        case em_cmd_type_sta_steer:
+        case em_cmd_type_sta_steer_batch:
+        case em_cmd_type_btm_report:
+        case em_cmd_type_sta_disassoc:
+            return em_cmd_prio_interactive;
+
+        case em_cmd_type_scan_channel:
+        case em_cmd_type_scan_result:
+        case em_cmd_type_dev_test:
+        case em_cmd_type_sta_link_metrics:
+        case em_cmd_type_avail_spectrum_inquiry:
+        case em_cmd_type_beacon_report:
+        case em_cmd_type_ap_metrics_report:
+            return em_cmd_prio_background;
+
+        default:
+            break;
+    }
+
+    return em_cmd_prio_config;
+}
+
+const char *em_cmd_t::get_cmd_prio_str(em_cmd_prio_t prio)
+{
+    switch (prio) {
+        case em_cmd_prio_interactive:   return "interactive";
+        case em_cmd_prio_config:        return "config";
+        case em_cmd_prio_background:    return "background";
+        default:                        break;
+    }
+
+    return "unknown";
+}
+
 em_cmd_type_t em_cmd_t::bus_2_cmd_type(em_bus_event_type_t etype)
 {
     em_cmd_type_t type = em_cmd_type_none;
@@ -752,6 +917,15 @@ em_cmd_type_t em_cmd_t::bus_2_cmd_type(em_bus_event_type_t etype)
             type = em_cmd_type_em_config;
             break;
 
+        case em_bus_event_type_onewifi_private_cb:
+        case em_bus_event_type_onewifi_mesh_sta_cb:
+            type = em_cmd_type_onewifi_cb;
+            break;
+
+        case em_bus_event_type_onewifi_radio_cb:
+            type = em_cmd_type_op_channel_report;
+            break;
+
         case em_bus_event_type_get_mld_config:
             type = em_cmd_type_get_mld_config;
             break;
@@ -772,6 +946,18 @@ em_cmd_type_t em_cmd_t::bus_2_cmd_type(em_bus_event_type_t etype)
             type = em_cmd_type_get_reset;
             break;
 
+        case em_bus_event_type_get_orch_stats:
+            type = em_cmd_type_get_orch_stats;
+            break;
+
+        case em_bus_event_type_get_perf_stats:
+            type = em_cmd_type_get_perf_stats;
+            break;
+
+        case em_bus_event_type_get_mem_stats:
+            type = em_cmd_type_get_mem_stats;
+            break;
+
         default:
             break;
     }
@@ -824,6 +1010,18 @@ em_bus_event_type_t em_cmd_t::cmd_2_bus_event_type(em_cmd_type_t ctype)
             type = em_bus_event_type_get_reset;
             break;
 
+        case em_cmd_type_get_orch_stats:
+            type = em_bus_event_type_get_orch_stats;
+            break;
+
+        case em_cmd_type_get_perf_stats:
+            type = em_bus_event_type_get_perf_stats;
+            break;
+
+        case em_cmd_type_get_mem_stats:
+            type = em_bus_event_type_get_mem_stats;
+            break;
+
         default:
             break;
     }
@@ -867,7 +1065,7 @@ int em_cmd_t::dump_bus_event(em_bus_event_t *evt)
 	return 0;
 }   
 
-em_cmd_t::em_cmd_t(em_cmd_type_t type, em_cmd_params_t param, dm_easy_mesh_t& dm) : m_evt(NULL)
+em_cmd_t::em_cmd_t(em_cmd_type_t type, em_cmd_params_t param, dm_easy_mesh_t& dm) : m_snapshot(NULL), m_evt(NULL), m_data_model(NULL), m_ctx(), m_orch_in_place(false), m_cfg_bands(0), m_orch_list(NULL), m_orch_next(NULL), m_orch_prev(NULL), m_type_next(NULL), m_type_prev(NULL), m_em_links(NULL), m_num_em_links(0), m_submit_us(0), m_active_us(0)
 {
     m_type = type;
     m_db_cfg_type = db_cfg_type_none;
@@ -876,21 +1074,36 @@ em_cmd_t::em_cmd_t(em_cmd_type_t type, em_cmd_params_t param, dm_easy_mesh_t& dm
     init();
 }
 
-em_cmd_t::em_cmd_t(em_cmd_type_t type, em_cmd_params_t param) : m_evt(NULL)
+em_cmd_t::em_cmd_t(em_cmd_type_t type, em_cmd_params_t param) : m_snapshot(NULL), m_evt(NULL), m_data_model(NULL), m_ctx(), m_orch_in_place(false), m_cfg_bands(0), m_orch_list(NULL), m_orch_next(NULL), m_orch_prev(NULL), m_type_next(NULL), m_type_prev(NULL), m_em_links(NULL), m_num_em_links(0), m_submit_us(0), m_active_us(0)
 {
     m_type = type;
     m_db_cfg_type = db_cfg_type_none;
     memcpy(&m_param, &param, sizeof(em_cmd_params_t));
+    get_own_data_model();
+    init();
+}
+
+em_cmd_t::em_cmd_t(em_cmd_t *parent) : m_snapshot(parent->m_snapshot), m_evt(NULL), m_data_model(parent->m_data_model), m_ctx(), m_orch_in_place(false), m_cfg_bands(0), m_orch_list(NULL), m_orch_next(NULL), m_orch_prev(NULL), m_type_next(NULL), m_type_prev(NULL), m_em_links(NULL), m_num_em_links(0), m_submit_us(0), m_active_us(0)
+{
+    m_snapshot->refs++;
+    m_type = parent->m_type;
+    m_orch_in_place = parent->m_orch_in_place;
+    m_db_cfg_type = db_cfg_type_none;
+    m_cfg_bands = parent->m_cfg_bands;
+    memcpy(&m_param, &parent->m_param, sizeof(em_cmd_params_t));
+    m_em_candidates = queue_create();
     init();
 }
 
-em_cmd_t::em_cmd_t() : m_evt(NULL)
+em_cmd_t::em_cmd_t() : m_snapshot(NULL), m_evt(NULL), m_data_model(NULL), m_ctx(), m_orch_in_place(false), m_cfg_bands(0), m_orch_list(NULL), m_orch_next(NULL), m_orch_prev(NULL), m_type_next(NULL), m_type_prev(NULL), m_em_links(NULL), m_num_em_links(0), m_submit_us(0), m_active_us(0)
 {
 	m_evt = static_cast<em_event_t *> (malloc(sizeof(em_event_t) + EM_MAX_EVENT_DATA_LEN));
+    get_own_data_model();
 }
 
 em_cmd_t::~em_cmd_t()
 {
+    release_snapshot();
 	free(m_evt);	
 }
 
@@ -54,6 +54,6 @@ em_cmd_ap_metrics_report_t::em_cmd_ap_metrics_report_t(em_cmd_params_t param, dm
 
     memset(&ctx, 0, sizeof(em_cmd_ctx_t));
     ctx.type = m_orch_desc[0].op;
-    m_data_model.set_cmd_ctx(&ctx);
+    set_cmd_ctx(&ctx);
 }
 
@@ -38,6 +38,6 @@ em_cmd_bsta_cap_t::em_cmd_bsta_cap_t(em_cmd_params_t param, dm_easy_mesh_t& dm)
 
    memset(&ctx, 0, sizeof(em_cmd_ctx_t));
    ctx.type = m_orch_desc[0].op;
-   m_data_model.set_cmd_ctx(&ctx);
+   set_cmd_ctx(&ctx);
 }
 
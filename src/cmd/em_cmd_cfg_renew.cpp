@@ -46,5 +46,5 @@ em_cmd_cfg_renew_t::em_cmd_cfg_renew_t(em_service_type_t service, em_cmd_params_
 
     memset(&ctx, 0, sizeof(em_cmd_ctx_t));
     ctx.type = m_orch_desc[0].op;    
-    m_data_model.set_cmd_ctx(&ctx);
+    set_cmd_ctx(&ctx);
 }
@@ -43,10 +43,10 @@ em_cmd_channel_pref_query_t::em_cmd_channel_pref_query_t(em_service_type_t servi
     snprintf(m_name, sizeof(m_name), "%s", "channel_pref_query");
     m_svc = em_service_type_ctrl;
     init(dm);
-    m_data_model.set_msg_id(dm.msg_id);
+    m_data_model->set_msg_id(dm.msg_id);
 
     memset(&ctx, 0, sizeof(em_cmd_ctx_t));
     ctx.type = m_orch_desc[0].op;
-    m_data_model.set_cmd_ctx(&ctx);
+    set_cmd_ctx(&ctx);
 }
 
@@ -46,6 +46,7 @@ em_cmd_em_config_t::em_cmd_em_config_t(em_cmd_params_t param, dm_easy_mesh_t& dm
 
     m_orch_op_idx = 0;
     m_num_orch_desc = 10;
+    m_orch_in_place = true;
     m_orch_desc[0].op = dm_orch_type_bss_delete;
     m_orch_desc[0].submit = false;
     m_orch_desc[1].op = dm_orch_type_topo_sync;
@@ -73,6 +74,6 @@ em_cmd_em_config_t::em_cmd_em_config_t(em_cmd_params_t param, dm_easy_mesh_t& dm
 
     memset(&ctx, 0, sizeof(em_cmd_ctx_t));
     ctx.type = m_orch_desc[0].op;
-    m_data_model.set_cmd_ctx(&ctx);
+    set_cmd_ctx(&ctx);
 }
 
@@ -25,6 +25,7 @@
 #include <unistd.h>
 #include <arpa/inet.h>
 #include <net/if.h>
+#include <netinet/tcp.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/uio.h>
@@ -32,9 +33,37 @@
 #include <sys/un.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <poll.h>
+#include <time.h>
+#include <vector>
 #include <cjson/cJSON.h>
 #include "em_cli.h"
 
+// ALPN wire format, the length of each protocol name and then the name, the preferred one first
+static const unsigned char em_cmd_keep_alive_protos[] = "\x09" EM_CMD_TAGGED_PROTO "\x09" EM_CMD_STREAM_PROTO
+    "\x0d" EM_CMD_KEEP_ALIVE_PROTO;
+
+// result read into the buffer of the caller
+typedef struct {
+    char            *out;
+    unsigned int    size;
+    unsigned int    len;
+} em_cmd_result_buff_t;
+
+SSL_CTX *em_cmd_exec_t::s_client_ctx = NULL;
+em_cmd_channel_t em_cmd_exec_t::s_channel[em_service_type_none];
+pthread_mutex_t em_cmd_exec_t::s_channel_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t em_cmd_exec_t::s_channel_cond = PTHREAD_COND_INITIALIZER;
+
+static time_t get_monotonic_sec()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec;
+}
+
 void em_cmd_exec_t::wait(struct timespec *time_to_wait)
 {
     printf("Waiting\n");
@@ -77,16 +106,38 @@ int em_cmd_exec_t::load_params_file(const char *filename, char *buff)
 
 int em_cmd_exec_t::execute(em_cmd_type_t type, em_service_type_t to_svc, unsigned char *in, unsigned int len)
 {
-    em_event_t ev;
+    em_event_t *evt;
     em_bus_event_t *bevt;
     em_subdoc_info_t    *info;
-    ev.type = em_event_type_bus;
-    bevt = &ev.u.bevt;
+    unsigned char *buff;
+    unsigned int sz;
+    int ret = -1;
+
+    if (len > EM_MAX_EVENT_DATA_LEN) {
+        return -1;
+    }
+
+    // the subdocument follows the event, the event is sent encoded
+    if ((evt = static_cast<em_event_t *> (calloc(1, sizeof(em_event_t) + len))) == NULL) {
+        return -1;
+    }
+    evt->type = em_event_type_bus;
+    bevt = &evt->u.bevt;
     bevt->type = em_cmd_t::cmd_2_bus_event_type(type);
+    bevt->data_len = len;
     info = &bevt->u.subdoc;
     memcpy(info->buff, in, len);
-    
-    return send_cmd(to_svc, reinterpret_cast<unsigned char *> (&ev), sizeof(em_event_t));;
+
+    sz = static_cast<unsigned int> (sizeof(em_cmd_wire_hdr_t) + sizeof(em_event_t)) + len;
+    if ((buff = static_cast<unsigned char *> (malloc(sz))) != NULL) {
+        if ((sz = encode_event(evt, buff, sz)) != 0) {
+            ret = send_cmd(to_svc, buff, sz);
+        }
+        free(buff);
+    }
+    free(evt);
+
+    return ret;
 }
 
 unsigned short em_cmd_exec_t::get_port_from_dst_service(em_service_type_t to_svc)
@@ -207,7 +258,7 @@ int em_cmd_exec_t::get_listener_socket(em_service_type_t svc)
 	return lsock;
 }
 
-SSL *em_cmd_exec_t::get_ep_for_dst_svc(SSL_CTX *ctx, em_service_type_t svc)
+SSL *em_cmd_exec_t::get_ep_for_dst_svc(SSL_CTX *ctx, em_service_type_t svc, SSL_SESSION *session, bool keep_alive)
 {
 	SSL *ssl;
 #ifdef LOCAL_CLI
@@ -222,6 +273,7 @@ SSL *em_cmd_exec_t::get_ep_for_dst_svc(SSL_CTX *ctx, em_service_type_t svc)
     int sock, ret;
     int do_reuse_sock = 1;
 	unsigned int sz = sizeof(em_event_t) + EM_MAX_EVENT_DATA_LEN;
+    int nodelay = 1;
 
     if ((sock = socket(domain, SOCK_STREAM, 0)) < 0) {
         printf("%s:%d: Could not create socket\n", __func__, __LINE__);
@@ -248,6 +300,9 @@ SSL *em_cmd_exec_t::get_ep_for_dst_svc(SSL_CTX *ctx, em_service_type_t svc)
 #else
     if (get_ep_addr() != NULL) {
 	    memcpy(&addr, get_ep_addr(), sizeof(struct sockaddr_in));
+    } else {
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = inet_addr("127.0.0.1");
     }
     addr.sin_port = htons(port);
 #endif
@@ -260,6 +315,8 @@ SSL *em_cmd_exec_t::get_ep_for_dst_svc(SSL_CTX *ctx, em_service_type_t svc)
 
 	setsockopt(sock, SOL_SOCKET, SO_SNDBUF, &sz, sizeof(sz)); // Send buffer EM_MAX_EVENT_DATA_LEN
     setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &sz, sizeof(sz)); // Receive buffer EM_MAX_EVENT_DATA_LEN
+    // the frame lengths are small writes, they must not wait for the ACK of the previous one
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
 	
 	ssl = SSL_new(ctx);
 	if (ssl == NULL) {
@@ -268,6 +325,12 @@ SSL *em_cmd_exec_t::get_ep_for_dst_svc(SSL_CTX *ctx, em_service_type_t svc)
 		return NULL;
 	}
     SSL_set_fd(ssl, sock);
+    if (session != NULL) {
+        SSL_set_session(ssl, session);
+    }
+    if (keep_alive == true) {
+        SSL_set_alpn_protos(ssl, em_cmd_keep_alive_protos, sizeof(em_cmd_keep_alive_protos) - 1);
+    }
 
 	if (SSL_connect(ssl) != 1) {
         printf("%s:%d: Could not connect to ssl\n", __func__, __LINE__);
@@ -279,87 +342,627 @@ SSL *em_cmd_exec_t::get_ep_for_dst_svc(SSL_CTX *ctx, em_service_type_t svc)
 	return ssl;
 }
 
-int em_cmd_exec_t::send_cmd(em_service_type_t to_svc, unsigned char *in, unsigned int in_len, char *out, unsigned int out_len)
+SSL_CTX *em_cmd_exec_t::get_client_ctx()
 {
-    SSL *ssl;
-#ifdef LOCAL_CLI
-    struct sockaddr_un addr;
-    em_long_string_t sock_path;
-	int domain = AF_UNIX;
-#else
-	struct sockaddr_in addr;
-	unsigned short port;
-	int domain = AF_INET;
-#endif
-    int dsock;
-    ssize_t ret;
-    unsigned int sz = sizeof(em_event_t);
-    int do_reuse_sock = 1;
+    if (s_client_ctx != NULL) {
+        return s_client_ctx;
+    }
 
-#ifdef LOCAL_CLI
-    if (get_path_from_dst_service(to_svc, sock_path) == NULL) {
-#else
-    if ((port = get_port_from_dst_service(to_svc)) == 0) {
-#endif
-        printf("%s:%d: Could not find path from destination service: %d\n",__func__,__LINE__, to_svc);
+    if ((s_client_ctx = SSL_CTX_new(TLS_client_method())) == NULL) {
+        printf("%s:%d: Failed to create SSL context\n", __func__, __LINE__);
+        return NULL;
+    }
+    SSL_CTX_use_certificate_file(s_client_ctx, EM_CERT_FILE, SSL_FILETYPE_PEM);
+
+    // a write on a connection the service has just closed fails instead of killing the process
+    signal(SIGPIPE, SIG_IGN);
+
+    return s_client_ctx;
+}
+
+void em_cmd_exec_t::close_channel(em_cmd_channel_t *ch)
+{
+    int sock;
+
+    if (ch->ssl == NULL) {
+        return;
+    }
+
+    // shut down so that the session stays resumable
+    sock = SSL_get_fd(ch->ssl);
+    SSL_shutdown(ch->ssl);
+    SSL_free(ch->ssl);
+    close(sock);
+    ch->ssl = NULL;
+
+    // the results still owed by the connection never come
+    ch->tagged = false;
+    ch->reading = false;
+    ch->outstanding = 0;
+    ch->generation++;
+    ch->results.clear();
+    pthread_cond_broadcast(&s_channel_cond);
+}
+
+bool em_cmd_exec_t::is_keep_alive(SSL *ssl)
+{
+    const unsigned char *proto = NULL;
+    unsigned int len = 0;
+
+    SSL_get0_alpn_selected(ssl, &proto, &len);
+
+    return (len != 0);
+}
+
+bool em_cmd_exec_t::is_streaming(SSL *ssl)
+{
+    const unsigned char *proto = NULL;
+    unsigned int len = 0;
+
+    SSL_get0_alpn_selected(ssl, &proto, &len);
+
+    return ((len == strlen(EM_CMD_STREAM_PROTO)) && (memcmp(proto, EM_CMD_STREAM_PROTO, len) == 0)) ||
+        is_tagged(ssl);
+}
+
+bool em_cmd_exec_t::is_tagged(SSL *ssl)
+{
+    const unsigned char *proto = NULL;
+    unsigned int len = 0;
+
+    SSL_get0_alpn_selected(ssl, &proto, &len);
+
+    return (len == strlen(EM_CMD_TAGGED_PROTO)) && (memcmp(proto, EM_CMD_TAGGED_PROTO, len) == 0);
+}
+
+int em_cmd_exec_t::write_frame(void *arg, const char *data, size_t len)
+{
+    SSL *ssl = static_cast<SSL *> (arg);
+    unsigned char hdr[4];
+
+    hdr[0] = static_cast<unsigned char> (len >> 24);
+    hdr[1] = static_cast<unsigned char> (len >> 16);
+    hdr[2] = static_cast<unsigned char> (len >> 8);
+    hdr[3] = static_cast<unsigned char> (len);
+
+    if (write_all(ssl, hdr, sizeof(hdr)) != 0) {
         return -1;
     }
-    
-	if ((dsock = socket(domain, SOCK_STREAM, 0)) < 0) {
-        snprintf(out, out_len, "%s:%d: error opening socket, err:%d\n", __func__, __LINE__, errno);
+
+    return (len == 0) ? 0:write_all(ssl, reinterpret_cast<const unsigned char *> (data), static_cast<unsigned int> (len));
+}
+
+int em_cmd_exec_t::select_alpn(SSL *ssl, const unsigned char **out, unsigned char *outlen,
+                               const unsigned char *in, unsigned int inlen, void *arg)
+{
+    unsigned char *proto;
+
+    if (SSL_select_next_proto(&proto, outlen, em_cmd_keep_alive_protos, sizeof(em_cmd_keep_alive_protos) - 1,
+            in, inlen) != OPENSSL_NPN_NEGOTIATED) {
+        // older clients close the connection after the result, as before
+        return SSL_TLSEXT_ERR_NOACK;
+    }
+    *out = proto;
+
+    return SSL_TLSEXT_ERR_OK;
+}
+
+int em_cmd_exec_t::write_all(SSL *ssl, const unsigned char *buff, unsigned int len)
+{
+    unsigned int off = 0;
+    int ret;
+
+    while (off < len) {
+        if ((ret = SSL_write(ssl, buff + off, static_cast<int> (len - off))) <= 0) {
+            return -1;
+        }
+        off += static_cast<unsigned int> (ret);
+    }
+
+    return 0;
+}
+
+int em_cmd_exec_t::read_all(SSL *ssl, unsigned char *buff, unsigned int len)
+{
+    unsigned int off = 0;
+    int ret;
+
+    while (off < len) {
+        if ((ret = SSL_read(ssl, buff + off, static_cast<int> (len - off))) <= 0) {
+            return (off == 0) ? 0:-1;
+        }
+        off += static_cast<unsigned int> (ret);
+    }
+
+    return static_cast<int> (len);
+}
+
+unsigned int em_cmd_exec_t::encode_event(em_event_t *evt, unsigned char *buff, unsigned int len)
+{
+    em_bus_event_t *bevt = &evt->u.bevt;
+    em_cmd_wire_hdr_t *hdr = reinterpret_cast<em_cmd_wire_hdr_t *> (buff);
+    const unsigned char *params = reinterpret_cast<const unsigned char *> (&bevt->params.u);
+    unsigned int params_len = sizeof(bevt->params.u), body_len;
+
+    if ((evt->type != em_event_type_bus) || (bevt->data_len > EM_MAX_EVENT_DATA_LEN)) {
+        return 0;
+    }
+
+    // the arguments fill the parameters from the start, the zero tail is not sent
+    while ((params_len > 0) && (params[params_len - 1] == 0)) {
+        params_len--;
+    }
+    body_len = static_cast<unsigned int> (sizeof(bevt->u)) + bevt->data_len;
+
+    if (sizeof(em_cmd_wire_hdr_t) + params_len + body_len > len) {
+        return 0;
+    }
+
+    hdr->magic = EM_CMD_WIRE_MAGIC;
+    hdr->type = bevt->type;
+    hdr->params_len = params_len;
+    hdr->data_len = bevt->data_len;
+    memcpy(buff + sizeof(em_cmd_wire_hdr_t), params, params_len);
+    memcpy(buff + sizeof(em_cmd_wire_hdr_t) + params_len, &bevt->u, body_len);
+
+    return static_cast<unsigned int> (sizeof(em_cmd_wire_hdr_t)) + params_len + body_len;
+}
+
+int em_cmd_exec_t::read_event(SSL *ssl, em_event_t *evt)
+{
+    em_cmd_wire_hdr_t hdr;
+    em_bus_event_t *bevt = &evt->u.bevt;
+    unsigned int len;
+    int ret;
+
+    if ((ret = read_all(ssl, reinterpret_cast<unsigned char *> (&hdr), sizeof(hdr.magic))) <= 0) {
+        return ret;
+    }
+
+    if (hdr.magic == EM_CMD_WIRE_MAGIC) {
+        if (read_all(ssl, reinterpret_cast<unsigned char *> (&hdr) + sizeof(hdr.magic),
+                sizeof(hdr) - sizeof(hdr.magic)) <= 0) {
+            return -1;
+        }
+        if ((hdr.params_len > sizeof(bevt->params.u)) || (hdr.data_len > EM_MAX_EVENT_DATA_LEN)) {
+            printf("%s:%d: event params length: %u data length: %u too long\n", __func__, __LINE__,
+                hdr.params_len, hdr.data_len);
+            return -1;
+        }
+
+        evt->type = em_event_type_bus;
+        bevt->type = static_cast<em_bus_event_type_t> (hdr.type);
+        memset(&bevt->params, 0, sizeof(bevt->params));
+        bevt->data_len = hdr.data_len;
+        len = static_cast<unsigned int> (sizeof(bevt->u)) + hdr.data_len;
+        if (((hdr.params_len > 0) && (read_all(ssl, reinterpret_cast<unsigned char *> (&bevt->params.u),
+                hdr.params_len) <= 0)) || (read_all(ssl, reinterpret_cast<unsigned char *> (&bevt->u), len) <= 0)) {
+            return -1;
+        }
+
+        return static_cast<int> (sizeof(em_event_t) + hdr.data_len);
+    }
+
+    memcpy(evt, &hdr, sizeof(hdr.magic));
+    if (read_all(ssl, reinterpret_cast<unsigned char *> (evt) + sizeof(hdr.magic), sizeof(em_event_t) - sizeof(hdr.magic)) <= 0) {
         return -1;
     }
-    setsockopt(dsock, SOL_SOCKET, SO_SNDBUF, &sz, sizeof(sz)); // Send buffer 1K
-    setsockopt(dsock, SOL_SOCKET, SO_RCVBUF, &sz, sizeof(sz)); // Receive buffer 1K
-    setsockopt(dsock, SOL_SOCKET, SO_REUSEADDR, &do_reuse_sock, sizeof(do_reuse_sock)); // Reuse address 
 
-    memset(&addr, 0, sizeof(addr));
-#ifdef LOCAL_CLI 
-    addr.sun_family = AF_UNIX;
+    switch (evt->type) {
+        case em_event_type_frame:
+            len = evt->u.fevt.frame_len;
+            break;
 
-    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", sock_path);
-#else
-	addr.sin_family = AF_INET; 
-	addr.sin_addr.s_addr = inet_addr("127.0.0.1");
-    addr.sin_port = htons(port);
-#endif
+        case em_event_type_bus:
+            len = evt->u.bevt.data_len;
+            break;
 
-    //snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", sock_path);
+        default:
+            len = 0;
+            break;
+    }
+
+    if (len > EM_MAX_EVENT_DATA_LEN) {
+        printf("%s:%d: event data length: %u too long\n", __func__, __LINE__, len);
+        return -1;
+    }
 
-    if ((ret = connect(dsock, reinterpret_cast<const struct sockaddr *> (&addr), sizeof(struct sockaddr_un))) != 0) {
-        snprintf(out, out_len, "%s:%d: connect error on socket, err:%d\n", __func__, __LINE__, errno);
+    if ((len > 0) && (read_all(ssl, reinterpret_cast<unsigned char *> (evt) + sizeof(em_event_t), len) != static_cast<int> (len))) {
         return -1;
     }
 
-    ssl = SSL_new(m_ssl_ctx);
-    SSL_set_fd(ssl, dsock);
+    return static_cast<int> (sizeof(em_event_t) + len);
+}
 
-    if ((ret = SSL_write(ssl, in, static_cast<int> (in_len))) <= 0) {
-    	SSL_free(ssl);
-        close(dsock);
+int em_cmd_exec_t::read_result(SSL *ssl, em_cmd_result_sink_t sink, void *arg)
+{
+    unsigned char hdr[4];
+    char buff[EM_CMD_STREAM_CHUNK_SZ];
+    unsigned int len, sz;
+    bool started = false;
+    char *end;
+    int ret;
+
+    if (is_streaming(ssl) == true) {
+        while (1) {
+            if ((ret = read_all(ssl, hdr, sizeof(hdr))) <= 0) {
+                return (started == false) ? ret:-1;
+            }
+            started = true;
+            len = (static_cast<unsigned int> (hdr[0]) << 24) | (static_cast<unsigned int> (hdr[1]) << 16) |
+                (static_cast<unsigned int> (hdr[2]) << 8) | hdr[3];
+            if (len == 0) {
+                return 1;
+            }
+            while (len > 0) {
+                sz = (len < sizeof(buff)) ? len:static_cast<unsigned int> (sizeof(buff));
+                if ((read_all(ssl, reinterpret_cast<unsigned char *> (buff), sz) <= 0) || (sink(arg, buff, sz) != 0)) {
+                    return -1;
+                }
+                len -= sz;
+            }
+        }
+    }
+
+    while (1) {
+        if ((ret = SSL_read(ssl, buff, sizeof(buff))) <= 0) {
+            return (started == false) ? 0:-1;
+        }
+        started = true;
+        if ((end = static_cast<char *> (memchr(buff, 0, static_cast<size_t> (ret)))) != NULL) {
+            return (sink(arg, buff, static_cast<unsigned int> (end - buff)) == 0) ? 1:-1;
+        }
+        if (sink(arg, buff, static_cast<unsigned int> (ret)) != 0) {
+            return -1;
+        }
+    }
+}
+
+static int append_result(void *arg, const char *data, unsigned int len)
+{
+    em_cmd_result_buff_t *res = static_cast<em_cmd_result_buff_t *> (arg);
+
+    // one byte is kept for the terminating NUL
+    if (res->len + len >= res->size) {
+        printf("%s:%d: result larger than %u bytes\n", __func__, __LINE__, res->size);
         return -1;
     }
+    memcpy(res->out + res->len, data, len);
+    res->len += len;
+    res->out[res->len] = 0;
 
-    if (out == NULL) {
-    	SSL_free(ssl);
-        close(dsock);
-        return 0;
+    return 0;
+}
+
+int em_cmd_exec_t::transact(em_service_type_t svc, unsigned char *in, unsigned int in_len, char *out, unsigned int out_len)
+{
+    em_cmd_result_buff_t res;
+
+    if ((out == NULL) || (out_len == 0)) {
+        return -1;
     }
-    
-	/* Receive result. */
-    if ((ret = SSL_read(ssl, reinterpret_cast<unsigned char *> (out), static_cast<int> (out_len))) <= 0) {
-        snprintf(out, out_len, "%s:%d: result read error on socket, err:%d\n", __func__, __LINE__, errno);
-    	SSL_free(ssl);
-        close(dsock);
+
+    res.out = out;
+    res.size = out_len;
+    res.len = 0;
+    out[0] = 0;
+
+    if (transact(svc, in, in_len, append_result, &res) != 0) {
+        if (res.len == 0) {
+            snprintf(out, out_len, "%s:%d: result read error on socket, err:%d\n", __func__, __LINE__, errno);
+        }
+        return -1;
+    }
+
+    return 0;
+}
+
+static int append_string(void *arg, const char *data, unsigned int len)
+{
+    static_cast<std::string *> (arg)->append(data, len);
+
+    return 0;
+}
+
+static int discard_result(void *arg, const char *data, unsigned int len)
+{
+    return 0;
+}
+
+int em_cmd_exec_t::send_tagged(em_cmd_channel_t *ch, const unsigned char *in, unsigned int in_len, unsigned int *id)
+{
+    std::vector<unsigned char> buff(EM_CMD_TAG_SZ + in_len);
+
+    // the id and the command in one write, they go out in the same TLS record
+    *id = ch->next_id++;
+    buff[0] = static_cast<unsigned char> (*id >> 24);
+    buff[1] = static_cast<unsigned char> (*id >> 16);
+    buff[2] = static_cast<unsigned char> (*id >> 8);
+    buff[3] = static_cast<unsigned char> (*id);
+    memcpy(&buff[EM_CMD_TAG_SZ], in, in_len);
+
+    if (write_all(ch->ssl, &buff[0], static_cast<unsigned int> (buff.size())) != 0) {
+        if (ch->reading == true) {
+            // the reader polls the socket without the lock, it fails and closes the channel
+            shutdown(SSL_get_fd(ch->ssl), SHUT_RDWR);
+        } else {
+            close_channel(ch);
+        }
         return -1;
     }
-    	
-	SSL_free(ssl);
-    close(dsock);
+    ch->outstanding++;
 
     return 0;
 }
 
+int em_cmd_exec_t::wait_tagged(em_cmd_channel_t *ch, unsigned int id, unsigned int generation,
+                               em_cmd_result_sink_t sink, void *arg)
+{
+    std::map<unsigned int, std::string>::iterator it;
+    unsigned char tag[EM_CMD_TAG_SZ];
+    unsigned int read_id = 0;
+    struct pollfd pfd;
+    int ret;
+
+    while (1) {
+        if ((it = ch->results.find(id)) != ch->results.end()) {
+            ret = (sink(arg, it->second.data(), static_cast<unsigned int> (it->second.size())) == 0) ? 1:-1;
+            ch->results.erase(it);
+            return ret;
+        }
+        if (ch->generation != generation) {
+            return -1;
+        }
+        if (ch->reading == true) {
+            pthread_cond_wait(&s_channel_cond, &s_channel_lock);
+            continue;
+        }
+
+        // this thread reads the next result, whichever command it answers
+        ch->reading = true;
+        if (SSL_pending(ch->ssl) == 0) {
+            // the other threads send their commands while the service works on them
+            pfd.fd = SSL_get_fd(ch->ssl);
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            pthread_mutex_unlock(&s_channel_lock);
+            while ((poll(&pfd, 1, -1) < 0) && (errno == EINTR));
+            pthread_mutex_lock(&s_channel_lock);
+        }
+
+        if ((ret = read_all(ch->ssl, tag, sizeof(tag))) > 0) {
+            read_id = (static_cast<unsigned int> (tag[0]) << 24) | (static_cast<unsigned int> (tag[1]) << 16) |
+                (static_cast<unsigned int> (tag[2]) << 8) | tag[3];
+            ret = (read_id == id) ? read_result(ch->ssl, sink, arg):read_result(ch->ssl, append_string, &ch->results[read_id]);
+        }
+        if (ret <= 0) {
+            printf("%s:%d: result read error on socket, err:%d\n", __func__, __LINE__, errno);
+            close_channel(ch);
+            return -1;
+        }
+
+        ch->outstanding--;
+        ch->reading = false;
+        pthread_cond_broadcast(&s_channel_cond);
+        if (read_id == id) {
+            return 1;
+        }
+    }
+}
+
+int em_cmd_exec_t::transact_tagged(em_cmd_channel_t *ch, const unsigned char *in, unsigned int in_len,
+                                   em_cmd_result_sink_t sink, void *arg)
+{
+    unsigned int id, generation = ch->generation;
+    bool idle = (ch->outstanding == 0);
+
+    if (send_tagged(ch, in, in_len, &id) != 0) {
+        // nothing was lost if the service closed an idle connection, the command can go on a new one
+        return (idle == true) ? 0:-1;
+    }
+
+    return wait_tagged(ch, id, generation, sink, arg);
+}
+
+int em_cmd_exec_t::transact(em_service_type_t svc, unsigned char *in, unsigned int in_len, em_cmd_result_sink_t sink, void *arg)
+{
+    em_cmd_channel_t *ch;
+    struct sockaddr_in addr;
+    struct pollfd pfd;
+    SSL_CTX *ctx;
+    SSL_SESSION *session;
+    bool reused;
+    time_t now;
+    int len = -1;
+
+    if ((svc >= em_service_type_none) || (sink == NULL)) {
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    if (get_ep_addr() != NULL) {
+        memcpy(&addr, get_ep_addr(), sizeof(struct sockaddr_in));
+    }
+
+    pthread_mutex_lock(&s_channel_lock);
+    ch = &s_channel[svc];
+
+    // a shared connection to another destination is given up once its results are in
+    while ((ch->ssl != NULL) && (ch->outstanding != 0) && (memcmp(&ch->addr, &addr, sizeof(addr)) != 0)) {
+        pthread_cond_wait(&s_channel_cond, &s_channel_lock);
+    }
+    now = get_monotonic_sec();
+
+    if ((ch->ssl != NULL) && (ch->outstanding == 0)) {
+        // the service sends nothing between results, a readable connection is a closed one
+        pfd.fd = SSL_get_fd(ch->ssl);
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if ((now - ch->last_used > EM_CMD_CHANNEL_IDLE_SEC) || (memcmp(&ch->addr, &addr, sizeof(addr)) != 0) ||
+                (poll(&pfd, 1, 0) != 0)) {
+            close_channel(ch);
+        }
+    }
+
+    while (1) {
+        reused = (ch->ssl != NULL);
+        if (reused == false) {
+            if (((ctx = get_client_ctx()) == NULL) || ((ch->ssl = get_ep_for_dst_svc(ctx, svc, ch->session, true)) == NULL)) {
+                printf("%s:%d: connect error on socket, err:%d\n", __func__, __LINE__, errno);
+                break;
+            }
+            memcpy(&ch->addr, &addr, sizeof(addr));
+            ch->keep_alive = is_keep_alive(ch->ssl);
+            ch->tagged = is_tagged(ch->ssl);
+        }
+
+        if (ch->tagged == true) {
+            // the channel is closed by then if it failed
+            len = transact_tagged(ch, in, in_len, sink, arg);
+        } else if ((len = (write_all(ch->ssl, in, in_len) == 0) ? read_result(ch->ssl, sink, arg):0) <= 0) {
+            close_channel(ch);
+        }
+        if (len > 0) {
+            break;
+        }
+
+        // the service closed the kept connection before reading the command, send it on a new one
+        if ((reused == false) || (len < 0)) {
+            printf("%s:%d: result read error on socket, err:%d\n", __func__, __LINE__, errno);
+            len = -1;
+            break;
+        }
+    }
+
+    if ((len > 0) && (ch->ssl != NULL)) {
+        // the session tickets of TLS 1.3 come after the handshake, they are in by the end of the result
+        if ((reused == false) && ((session = SSL_get1_session(ch->ssl)) != NULL)) {
+            if (SSL_SESSION_is_resumable(session) == 1) {
+                if (ch->session != NULL) {
+                    SSL_SESSION_free(ch->session);
+                }
+                ch->session = session;
+            } else {
+                SSL_SESSION_free(session);
+            }
+        }
+        ch->last_used = get_monotonic_sec();
+        if (ch->keep_alive == false) {
+            close_channel(ch);
+        }
+    }
+    pthread_mutex_unlock(&s_channel_lock);
+
+    return (len > 0) ? 0:-1;
+}
+
+unsigned int em_cmd_exec_t::transact_batch(em_service_type_t svc, unsigned char **in, unsigned int *in_len, unsigned int num,
+                                           em_cmd_result_sink_t sink, void **arg)
+{
+    em_cmd_channel_t *ch;
+    std::vector<unsigned int> ids;
+    unsigned int sent, done, i, queued = 0, generation;
+    bool pipelined;
+
+    // the first command connects the channel and tells how the service sends its results
+    if ((num == 0) || (transact(svc, in[0], in_len[0], sink, arg[0]) != 0)) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&s_channel_lock);
+    ch = &s_channel[svc];
+    pipelined = (ch->ssl != NULL) && (is_streaming(ch->ssl) == true);
+    if (pipelined == false) {
+        pthread_mutex_unlock(&s_channel_lock);
+        for (done = 1; done < num; done++) {
+            if (transact(svc, in[done], in_len[done], sink, arg[done]) != 0) {
+                break;
+            }
+        }
+        return done;
+    }
+
+    // the results of a tagged channel come as the service finishes the commands, the sink
+    // still gets them in order, from where wait_tagged() keeps the ones that came early
+    ids.resize(num);
+    generation = ch->generation;
+    sent = done = 1;
+    while ((done < num) && (ch->generation == generation)) {
+        // a command larger than the window still goes once the ones before it are answered
+        while ((sent < num) && (sent - done < EM_CMD_PIPELINE_DEPTH) &&
+                ((sent == done) || (queued + in_len[sent] <= EM_CMD_PIPELINE_SZ))) {
+            if (ch->tagged == true) {
+                if (send_tagged(ch, in[sent], in_len[sent], &ids[sent]) != 0) {
+                    break;
+                }
+            } else if (write_all(ch->ssl, in[sent], in_len[sent]) != 0) {
+                break;
+            }
+            queued += in_len[sent];
+            sent++;
+        }
+
+        if ((sent == done) || (((ch->tagged == true) ? wait_tagged(ch, ids[done], generation, sink, arg[done]):
+                read_result(ch->ssl, sink, arg[done])) <= 0)) {
+            printf("%s:%d: result read error on socket, err:%d\n", __func__, __LINE__, errno);
+            break;
+        }
+        queued -= in_len[done];
+        done++;
+    }
+
+    if (done == num) {
+        ch->last_used = get_monotonic_sec();
+    } else if ((ch->tagged == true) && (ch->generation == generation)) {
+        // the connection is shared, the results of the commands written after a failure are dropped
+        for (i = done + 1; i < sent; i++) {
+            wait_tagged(ch, ids[i], generation, discard_result, NULL);
+        }
+    } else if (ch->generation == generation) {
+        // the results of the commands written after a failure are not read, the channel is not reused
+        close_channel(ch);
+    }
+    pthread_mutex_unlock(&s_channel_lock);
+
+    return done;
+}
+
+int em_cmd_exec_t::send_cmd(em_service_type_t to_svc, unsigned char *in, unsigned int in_len, char *out, unsigned int out_len)
+{
+    SSL_CTX *ctx;
+    SSL *ssl = NULL;
+    int sock, ret;
+
+    if (out != NULL) {
+        return transact(to_svc, in, in_len, out, out_len);
+    }
+
+    if (to_svc >= em_service_type_none) {
+        printf("%s:%d: Could not find path from destination service: %d\n",__func__,__LINE__, to_svc);
+        return -1;
+    }
+
+    // nobody reads the result, the command goes on a connection of its own that the service closes
+    pthread_mutex_lock(&s_channel_lock);
+    if ((ctx = get_client_ctx()) != NULL) {
+        ssl = get_ep_for_dst_svc(ctx, to_svc, s_channel[to_svc].session, false);
+    }
+    pthread_mutex_unlock(&s_channel_lock);
+
+    if (ssl == NULL) {
+        return -1;
+    }
+
+    ret = write_all(ssl, in, in_len);
+
+    sock = SSL_get_fd(ssl);
+    SSL_shutdown(ssl);
+    SSL_free(ssl);
+    close(sock);
+
+    return ret;
+}
+
 void em_cmd_exec_t::deinit()
 {
 	SSL_CTX_free(m_ssl_ctx); 
@@ -382,6 +985,9 @@ int em_cmd_exec_t::init()
     }
     SSL_CTX_set_min_proto_version(m_ssl_ctx, TLS1_2_VERSION);
     SSL_CTX_set_cipher_list(m_ssl_ctx, "ALL:eNULL");
+    SSL_CTX_set_session_id_context(m_ssl_ctx, reinterpret_cast<const unsigned char *> (EM_CMD_KEEP_ALIVE_PROTO),
+        strlen(EM_CMD_KEEP_ALIVE_PROTO));
+    SSL_CTX_set_alpn_select_cb(m_ssl_ctx, select_alpn, NULL);
 
     if (SSL_CTX_load_verify_locations(m_ssl_ctx, EM_CERT_FILE, EM_KEY_FILE) != 1) {
         printf("%s:%d: Failed to verify certificate locations\n", __func__, __LINE__);
@@ -52,7 +52,7 @@ em_cmd_get_channel_t::em_cmd_get_channel_t(em_cmd_params_t param, dm_easy_mesh_t
     init(dm);
 
     memset(&ctx, 0, sizeof(em_cmd_ctx_t));
-    m_data_model.set_cmd_ctx(&ctx);
+    set_cmd_ctx(&ctx);
 }
 
 
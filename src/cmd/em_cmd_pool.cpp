@@ -0,0 +1,152 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "em_cmd_pool.h"
+
+void *em_cmd_pool_t::alloc(size_t size)
+{
+    em_cmd_pool_blk_t *blk = NULL;
+    unsigned int i, idx = EM_CMD_POOL_MAX_SIZES;
+
+    pthread_mutex_lock(&m_lock);
+    for (i = 0; i < m_num_slots; i++) {
+        if (m_slots[i].size == size) {
+            break;
+        }
+    }
+    if ((i == m_num_slots) && (m_num_slots < EM_CMD_POOL_MAX_SIZES)) {
+        m_slots[i].size = size;
+        m_num_slots++;
+    }
+
+    if (i < m_num_slots) {
+        idx = i;
+        m_slots[i].alloc++;
+        if ((blk = m_slots[i].free) != NULL) {
+            m_slots[i].free = blk->h.next;
+            m_slots[i].cached--;
+            m_slots[i].hit++;
+        }
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    if (blk == NULL) {
+        if ((blk = static_cast<em_cmd_pool_blk_t *>(malloc(sizeof(em_cmd_pool_blk_t) + size))) == NULL) {
+            printf("%s:%d: failed to allocate block of size:%zu\n", __func__, __LINE__, size);
+            return NULL;
+        }
+        // sizes beyond the slots are not cached
+        blk->h.idx = idx;
+    }
+
+    blk->h.next = NULL;
+    return blk + 1;
+}
+
+void em_cmd_pool_t::release(void *ptr)
+{
+    em_cmd_pool_blk_t *blk;
+    em_cmd_pool_slot_t *slot;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    blk = static_cast<em_cmd_pool_blk_t *>(ptr) - 1;
+
+    pthread_mutex_lock(&m_lock);
+    if (blk->h.idx < m_num_slots) {
+        slot = &m_slots[blk->h.idx];
+        if (slot->cached < ((slot->size >= EM_CMD_POOL_LARGE_SZ) ? EM_CMD_POOL_LARGE_CACHE:EM_CMD_POOL_CACHE)) {
+            blk->h.next = slot->free;
+            slot->free = blk;
+            slot->cached++;
+            blk = NULL;
+        }
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    if (blk != NULL) {
+        free(blk);
+    }
+}
+
+bool em_cmd_pool_t::get_stats(size_t size, unsigned int *alloc, unsigned int *hit, unsigned int *cached)
+{
+    unsigned int i;
+    bool found = false;
+
+    pthread_mutex_lock(&m_lock);
+    for (i = 0; i < m_num_slots; i++) {
+        if (m_slots[i].size == size) {
+            *alloc = m_slots[i].alloc;
+            *hit = m_slots[i].hit;
+            *cached = m_slots[i].cached;
+            found = true;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return found;
+}
+
+void em_cmd_pool_t::dump_stats()
+{
+    unsigned int i;
+
+    pthread_mutex_lock(&m_lock);
+    for (i = 0; i < m_num_slots; i++) {
+        printf("%s:%d: size:%zu alloc:%u hit:%u cached:%u\n", __func__, __LINE__,
+                m_slots[i].size, m_slots[i].alloc, m_slots[i].hit, m_slots[i].cached);
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+em_cmd_pool_t *em_cmd_pool_t::get_pool()
+{
+    static em_cmd_pool_t *pool = new em_cmd_pool_t();
+
+    return pool;
+}
+
+em_cmd_pool_t::em_cmd_pool_t()
+{
+    pthread_mutex_init(&m_lock, NULL);
+    memset(m_slots, 0, sizeof(m_slots));
+    m_num_slots = 0;
+}
+
+em_cmd_pool_t::~em_cmd_pool_t()
+{
+    em_cmd_pool_blk_t *blk;
+    unsigned int i;
+
+    for (i = 0; i < m_num_slots; i++) {
+        while ((blk = m_slots[i].free) != NULL) {
+            m_slots[i].free = blk->h.next;
+            free(blk);
+        }
+    }
+
+    pthread_mutex_destroy(&m_lock);
+}
@@ -56,5 +56,5 @@ em_cmd_remove_device_t::em_cmd_remove_device_t(em_cmd_params_t param, dm_easy_me
 
     memset(&ctx, 0, sizeof(em_cmd_ctx_t));
     ctx.type = m_orch_desc[0].op;    
-    m_data_model.set_cmd_ctx(&ctx);
+    set_cmd_ctx(&ctx);
 }
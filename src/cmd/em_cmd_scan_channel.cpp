@@ -56,5 +56,5 @@ em_cmd_scan_channel_t::em_cmd_scan_channel_t(em_cmd_params_t param, dm_easy_mesh
     memset(&ctx, 0, sizeof(em_cmd_ctx_t));
     ctx.type = m_orch_desc[0].op;
 
-    m_data_model.set_cmd_ctx(&ctx);
+    set_cmd_ctx(&ctx);
 }
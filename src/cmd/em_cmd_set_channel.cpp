@@ -46,6 +46,7 @@ em_cmd_set_channel_t::em_cmd_set_channel_t(em_cmd_params_t param, dm_easy_mesh_t
 
     m_orch_op_idx = 0;
     m_num_orch_desc = 2;
+    m_orch_in_place = true;
     m_orch_desc[0].op = dm_orch_type_channel_sel;
     m_orch_desc[0].submit = true;
     m_orch_desc[1].op = dm_orch_type_channel_cnf;
@@ -58,5 +59,5 @@ em_cmd_set_channel_t::em_cmd_set_channel_t(em_cmd_params_t param, dm_easy_mesh_t
     memset(&ctx, 0, sizeof(em_cmd_ctx_t));
     ctx.type = m_orch_desc[0].op;
 
-    m_data_model.set_cmd_ctx(&ctx);
+    set_cmd_ctx(&ctx);
 }
@@ -53,6 +53,6 @@ em_cmd_sta_link_metrics_t::em_cmd_sta_link_metrics_t(dm_easy_mesh_t& dm)
 
     memset(&ctx, 0, sizeof(em_cmd_ctx_t));
     ctx.type = m_orch_desc[0].op;
-    m_data_model.set_cmd_ctx(&ctx);
+    set_cmd_ctx(&ctx);
 }
 
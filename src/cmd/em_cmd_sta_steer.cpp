@@ -56,6 +56,6 @@ em_cmd_sta_steer_t::em_cmd_sta_steer_t(em_cmd_steer_params_t params)
 
     memset(&ctx, 0, sizeof(em_cmd_ctx_t));
     ctx.type = m_orch_desc[0].op;
-    m_data_model.set_cmd_ctx(&ctx);
+    set_cmd_ctx(&ctx);
 }
 
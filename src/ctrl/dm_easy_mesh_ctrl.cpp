@@ -24,6 +24,7 @@
 #include <signal.h>
 #include <unistd.h>
 #include <math.h>
+#include <time.h>
 #include <arpa/inet.h>
 #include <net/if.h>
 #include <linux/filter.h>
@@ -38,9 +39,17 @@
 #include <unistd.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <climits>
+#include <memory>
+#include <vector>
+#include <algorithm>
 #include "dm_easy_mesh_ctrl.h"
 #include "dm_easy_mesh.h"
 #include <cjson/cJSON.h>
+#include "em_perf.h"
+#include "em_frame_trace.h"
+#include "em_stack.h"
+#include "em_startup_prof.h"
 #include "em_cmd_exec.h"
 #include "em_cmd_reset.h"
 #include "em_cmd_dev_test.h"
@@ -56,6 +65,7 @@
 #include "em_cmd_sta_assoc.h"
 #include "em_cmd_sta_link_metrics.h"
 #include "em_cmd_sta_steer.h"
+#include "em_cmd_sta_steer_batch.h"
 #include "em_cmd_sta_disassoc.h"
 #include "em_cmd_get_mld_config.h"
 #include "em_cmd_mld_reconfig.h"
@@ -319,6 +329,27 @@ int dm_easy_mesh_ctrl_t::analyze_sta_steer(em_cmd_steer_params_t &params, em_cmd
     return num;
 }
 
+int dm_easy_mesh_ctrl_t::analyze_sta_steer_batch(em_cmd_steer_batch_params_t &params, em_cmd_t *pcmd[])
+{
+    int num = 0;
+    em_cmd_t *tmp;
+
+    if (params.num == 0) {
+        return 0;
+    }
+
+    pcmd[num] = new em_cmd_sta_steer_batch_t(params);
+    tmp = pcmd[num];
+    num++;
+
+    while ((pcmd[num] = tmp->clone_for_next()) != NULL) {
+        tmp = pcmd[num];
+        num++;
+    }
+
+    return num;
+}
+
 int dm_easy_mesh_ctrl_t::analyze_command_steer(em_bus_event_t *evt, em_cmd_t *cmd[])
 {
     cJSON *obj, *wfa_obj, *net_obj, *dev_list_obj, *dev_obj;
@@ -842,6 +873,7 @@ int dm_easy_mesh_ctrl_t::analyze_set_ssid(em_bus_event_t *evt, em_cmd_t *pcmd[])
     em_cmd_t *tmp;
 	int i, j, num = 0;
 	int bit_mask = 0;
+	unsigned int bands;
 
     subdoc = &evt->u.subdoc;
 	if ((ret = dm.decode_config(subdoc, "SetSSID")) < 0) {
@@ -871,9 +903,12 @@ int dm_easy_mesh_ctrl_t::analyze_set_ssid(em_bus_event_t *evt, em_cmd_t *pcmd[])
 		return EM_PARSE_ERR_NO_CHANGE;
 	}
 
-	printf("%s:%d: Start taking action on SetSSID\n", __func__, __LINE__);	
+	// only the radios of the bands whose network SSIDs changed get the autoconfig renew
+	bands = dm_network_ssid_t::get_changed_bands(dm.m_network_ssid, EM_MAX_NET_SSIDS, pdm->m_network_ssid, EM_MAX_NET_SSIDS);
+	printf("%s:%d: Start taking action on SetSSID, bands: 0x%x\n", __func__, __LINE__, bands);
 	dm.set_db_cfg_param(db_cfg_type_network_ssid_list_update, "");
     pcmd[num] = new em_cmd_set_ssid_t(evt->params, dm);
+    pcmd[num]->set_cfg_bands(bands);
     tmp = pcmd[num];
     num++;
 
@@ -941,10 +976,9 @@ int dm_easy_mesh_ctrl_t::analyze_remove_device(em_bus_event_t *evt, em_cmd_t *pc
 
     cJSON_free(obj);
 
-	device = m_data_model_list.get_first_device();
-	while (device != NULL) {
+	for (dm_device_t *dev : m_data_model_list.walk_devices()) {
 		for (i = 0; i < num_devs_to_keep; i++) {
-			if (memcmp(device->m_device_info.intf.mac, dev_mac_to_keep[i], sizeof(mac_address_t)) == 0) {
+			if (memcmp(dev->m_device_info.intf.mac, dev_mac_to_keep[i], sizeof(mac_address_t)) == 0) {
 				keep = true;
 				break;
 			}
@@ -953,10 +987,9 @@ int dm_easy_mesh_ctrl_t::analyze_remove_device(em_bus_event_t *evt, em_cmd_t *pc
 		if (keep == true) {
 			keep = false;
 		} else {
-			devices_to_delete[num_devs_to_delete] = device;
+			devices_to_delete[num_devs_to_delete] = dev;
 			num_devs_to_delete++;
 		}
-		device = m_data_model_list.get_next_device(device);
 	}
 
 	for (i = 0; i < num_devs_to_delete; i++) {
@@ -1116,7 +1149,9 @@ int dm_easy_mesh_ctrl_t::set_device_list(cJSON *dev_list_obj)
 
 int dm_easy_mesh_ctrl_t::reset_config()
 {
-    
+    // the tables are dropped, queued writes must not land after that
+    m_db_client.flush();
+
     dm_network_list_t::delete_list();
     dm_device_list_t::delete_list();
     dm_radio_list_t::delete_list();
@@ -1211,7 +1246,8 @@ int dm_easy_mesh_ctrl_t::get_reference_config(cJSON *parent, char *net_id)
 int dm_easy_mesh_ctrl_t::get_scan_result(cJSON *parent, char *key)
 {
     cJSON *net_obj, *dev_list_obj, *dev_obj, *radio_list_obj, *radio_obj;
-	cJSON *bss_obj, *bss_list_obj, *sta_list_obj;
+	cJSON *bss_obj, *bss_list_obj;
+	dm_json_writer_t writer;
 	int i, j, k;
 	em_long_string_t	scan_parent;
 	char *dev_id, *radio_id, *bss_id;
@@ -1238,7 +1274,12 @@ int dm_easy_mesh_ctrl_t::get_scan_result(cJSON *parent, char *key)
 
 			snprintf(scan_parent, sizeof(em_long_string_t), "%s@%s@%s@0@0@1@%s", key, dev_id, radio_id, null_mac_str);
 			//printf("%s:%d: Scan Parent ID: %s\n", __func__, __LINE__, scan_parent);
-			dm_scan_result_list_t::get_config(radio_obj, scan_parent);
+			// the leaf lists are streamed, nothing reads them back out of the tree
+			writer.reset();
+			writer.begin_array();
+			dm_scan_result_list_t::get_config(writer, scan_parent);
+			writer.end_array();
+			cJSON_AddRawToObject(radio_obj, "ScanResults", writer.get_str());
 
 			bss_list_obj = cJSON_AddArrayToObject(radio_obj, "BSSList");
 			dm_bss_list_t::get_config(bss_list_obj, radio_id, true);
@@ -1247,8 +1288,11 @@ int dm_easy_mesh_ctrl_t::get_scan_result(cJSON *parent, char *key)
 				bss_obj = cJSON_GetArrayItem(bss_list_obj, k);
 				bss_id = cJSON_GetStringValue(cJSON_GetObjectItem(bss_obj, "BSSID"));
 
-				sta_list_obj = cJSON_AddArrayToObject(bss_obj, "STAList");	
-				dm_sta_list_t::get_config(sta_list_obj, bss_id, em_get_sta_list_reason_neighbors);
+				writer.reset();
+				writer.begin_array();
+				dm_sta_list_t::get_config(writer, bss_id, em_get_sta_list_reason_neighbors);
+				writer.end_array();
+				cJSON_AddRawToObject(bss_obj, "STAList", writer.get_str());
 			}
 		} 
 	}
@@ -1282,7 +1326,8 @@ int dm_easy_mesh_ctrl_t::get_policy_config(cJSON *parent, char *net_id)
 int dm_easy_mesh_ctrl_t::get_sta_config(cJSON *parent, char *key, em_get_sta_list_reason_t reason)
 {
     cJSON *net_obj, *dev_list_obj, *dev_obj, *radio_list_obj, *radio_obj, *bss_list_obj;
-    cJSON *bss_obj, *sta_list_obj;
+    cJSON *bss_obj;
+    dm_json_writer_t writer;
     int i, j, k;
     char *tmp;
 
@@ -1306,8 +1351,12 @@ int dm_easy_mesh_ctrl_t::get_sta_config(cJSON *parent, char *key, em_get_sta_lis
             for (k = 0; k < cJSON_GetArraySize(bss_list_obj); k++) {
                 bss_obj = cJSON_GetArrayItem(bss_list_obj, k);
                 tmp = cJSON_GetStringValue(cJSON_GetObjectItem(bss_obj, "bssid"));
-                sta_list_obj = cJSON_AddArrayToObject(bss_obj, "STAList");
-                dm_sta_list_t::get_config(sta_list_obj, tmp, reason);
+                // one buffer for all the lists, nothing reads them back out of the tree
+                writer.reset();
+                writer.begin_array();
+                dm_sta_list_t::get_config(writer, tmp, reason);
+                writer.end_array();
+                cJSON_AddRawToObject(bss_obj, "STAList", writer.get_str());
             }
         }
     }
@@ -1502,10 +1551,9 @@ int dm_easy_mesh_ctrl_t::get_mld_config(cJSON *parent, char *key)
 	return 0;
 }
 
-void dm_easy_mesh_ctrl_t::get_config(em_long_string_t net_id, em_subdoc_info_t *subdoc)
+cJSON *dm_easy_mesh_ctrl_t::get_config_tree(em_long_string_t net_id, em_subdoc_info_t *subdoc)
 {
     cJSON *parent;
-    char *tmp;
 
     parent = cJSON_CreateObject();
 
@@ -1552,10 +1600,21 @@ void dm_easy_mesh_ctrl_t::get_config(em_long_string_t net_id, em_subdoc_info_t *
         get_wifi_reset_config(parent, net_id);
     }
 
+    return parent;
+}
+
+void dm_easy_mesh_ctrl_t::get_config(em_long_string_t net_id, em_subdoc_info_t *subdoc)
+{
+    cJSON *parent;
+    char *tmp;
+
+    parent = get_config_tree(net_id, subdoc);
+
     tmp = cJSON_Print(parent);
     printf("%s:%d: Subdoc: %s\n", __func__, __LINE__, tmp);
     strncpy(subdoc->buff, tmp, strlen(tmp) + 1);
-    cJSON_free(parent);
+    cJSON_free(tmp);
+    cJSON_Delete(parent);
 }
 
 int dm_easy_mesh_ctrl_t::copy_config(dm_easy_mesh_t *dm, em_long_string_t net_id)
@@ -1587,14 +1646,74 @@ dm_easy_mesh_t *dm_easy_mesh_ctrl_t::create_data_model(const char *net_id, const
 void dm_easy_mesh_ctrl_t::handle_dirty_dm()
 {
     dm_easy_mesh_t *dm;
+    db_write_queue_stats_t stats;
+    static unsigned long long stalls = 0;
+    static time_t snapshot_time = 0;
+    std::vector<std::string> stale;
+    time_t now;
 
     dm = m_data_model_list.get_first_dm();
     while (dm != NULL) {
-		if (dm->db_cfg_type_is_set()) {
+		if ((dm->db_cfg_type_is_set() == true) || (dm->has_dirty_objects() == true)) {
 	    	set_config(dm);		
 		}
 		dm = m_data_model_list.get_next_dm(dm);
     }
+
+    // the database does not keep up with the updates when the queue fills up
+    m_db_client.get_writer_stats(&stats);
+    if (stats.stalls != stalls) {
+        printf("%s:%d: DB writer depth:%d max:%d queued:%llu coalesced:%llu written:%llu failed:%llu stalls:%llu\n",
+                __func__, __LINE__, stats.depth, stats.max_depth, stats.queued, stats.coalesced, stats.written,
+                stats.failed, stats.stalls);
+        stalls = stats.stalls;
+    }
+
+    if (m_db_client.has_snapshot() == true) {
+        if (m_db_client.get_reconciled(stale) == true) {
+            m_db_client.close_snapshot();
+            reload_tables(stale);
+        }
+        return;
+    }
+
+    now = time(NULL);
+    if (snapshot_time == 0) {
+        snapshot_time = now;
+    } else if ((now - snapshot_time) >= EM_DB_SNAPSHOT_INTERVAL) {
+        m_db_client.start_snapshot(EM_DB_SNAPSHOT_FILE);
+        snapshot_time = now;
+    }
+}
+
+void dm_easy_mesh_ctrl_t::reload_tables(const std::vector<std::string>& tables)
+{
+    for (const std::string& table : tables) {
+        printf("%s:%d: %s changed since the snapshot, reloading\n", __func__, __LINE__, table.c_str());
+
+        if (table == dm_network_list_t::m_table_name) {
+            dm_network_list_t::load_table(m_db_client);
+        } else if (table == dm_device_list_t::m_table_name) {
+            dm_device_list_t::load_table(m_db_client);
+        } else if (table == dm_radio_list_t::m_table_name) {
+            dm_radio_list_t::load_table(m_db_client);
+        } else if (table == dm_network_ssid_list_t::m_table_name) {
+            dm_network_ssid_list_t::load_table(m_db_client);
+        } else if (table == dm_op_class_list_t::m_table_name) {
+            dm_op_class_list_t::load_table(m_db_client);
+        } else if (table == dm_bss_list_t::m_table_name) {
+            dm_bss_list_t::load_table(m_db_client);
+        } else if (table == dm_sta_list_t::m_table_name) {
+            // rows deleted since the snapshot must not survive the reload
+            dm_sta_list_t::delete_list();
+            dm_sta_list_t::load_table(m_db_client);
+        } else if (table == dm_policy_list_t::m_table_name) {
+            dm_policy_list_t::load_table(m_db_client);
+        } else if (table == dm_scan_result_list_t::m_table_name) {
+            dm_scan_result_list_t::delete_list();
+            dm_scan_result_list_t::load_table(m_db_client);
+        }
+    }
 }
 
 dm_easy_mesh_t  *dm_easy_mesh_ctrl_t::get_data_model(const char *net_id, const unsigned char *al_mac) 
@@ -1628,30 +1747,49 @@ int dm_easy_mesh_ctrl_t::load_net_ssid_table()
 
 int dm_easy_mesh_ctrl_t::load_tables()
 {
-    db_cfg_type_t type = db_cfg_type_none;
-    
-    if (dm_network_list_t::load_table(m_db_client) != 0) {
-        type = db_cfg_type_network_list_update;
-    } else if (dm_device_list_t::load_table(m_db_client) != 0) {
-        type = db_cfg_type_device_list_update;
-    } else if (dm_radio_list_t::load_table(m_db_client) != 0) {
-        type = db_cfg_type_radio_list_update;
-    } else if (dm_network_ssid_list_t::load_table(m_db_client) != 0) {
-        type = db_cfg_type_network_ssid_list_update;
-    } else if (dm_op_class_list_t::load_table(m_db_client) != 0) {
-        type = db_cfg_type_op_class_list_update;
-    } else if (dm_bss_list_t::load_table(m_db_client) != 0) {
-        type = db_cfg_type_bss_list_update;
-    } else if (dm_sta_list_t::load_table(m_db_client) != 0) {
-        type = db_cfg_type_sta_list_update;
-    } else if (dm_policy_list_t::load_table(m_db_client) != 0) {
-        type = db_cfg_type_policy_list_update;
-    } else if (dm_scan_result_list_t::load_table(m_db_client) != 0) {
-        type = db_cfg_type_scan_result_list_update;
-    }
-
-    if (type != db_cfg_type_none) {
-        return type;
+    // in the order they depend on each other, a row refers to the rows of the tables before it
+    db_easy_mesh_t *tables[] = {
+        static_cast<dm_network_list_t *>(this), static_cast<dm_device_list_t *>(this),
+        static_cast<dm_radio_list_t *>(this), static_cast<dm_network_ssid_list_t *>(this),
+        static_cast<dm_op_class_list_t *>(this), static_cast<dm_bss_list_t *>(this),
+        static_cast<dm_sta_list_t *>(this), static_cast<dm_policy_list_t *>(this),
+        static_cast<dm_scan_result_list_t *>(this)
+    };
+    db_cfg_type_t types[] = {
+        db_cfg_type_network_list_update, db_cfg_type_device_list_update,
+        db_cfg_type_radio_list_update, db_cfg_type_network_ssid_list_update,
+        db_cfg_type_op_class_list_update, db_cfg_type_bss_list_update,
+        db_cfg_type_sta_list_update, db_cfg_type_policy_list_update,
+        db_cfg_type_scan_result_list_update
+    };
+    std::vector<std::string> names;
+    unsigned long long rows;
+    unsigned int i, num = sizeof(tables) / sizeof(tables[0]);
+    int slot, rc = 0;
+
+    // the selects run in parallel, the rows are then added to the data model in order
+    if (m_db_client.has_snapshot() == false) {
+        for (i = 0; i < num; i++) {
+            names.push_back(tables[i]->m_table_name);
+        }
+        slot = em_startup_prof_t::begin(em_startup_prof_phase, "db_prefetch");
+        m_db_client.prefetch(names);
+        em_startup_prof_t::end(slot);
+    }
+
+    for (i = 0; i < num; i++) {
+        rows = m_db_client.get_rows_read();
+        slot = em_startup_prof_t::begin(em_startup_prof_table, tables[i]->m_table_name);
+        rc = tables[i]->load_table(m_db_client);
+        em_startup_prof_t::end(slot, m_db_client.get_rows_read() - rows);
+        if (rc != 0) {
+            break;
+        }
+    }
+    m_db_client.close_prefetch();
+
+    if (i < num) {
+        return types[i];
     }
 
     if (dm_network_list_t::is_table_empty(m_db_client) == true) {
@@ -1664,6 +1802,37 @@ int dm_easy_mesh_ctrl_t::load_tables()
     return 0;
 }
 
+int dm_easy_mesh_ctrl_t::update_bss_row(dm_easy_mesh_t *dm, unsigned int index)
+{
+    dm_bss_t bss;
+    mac_addr_str_t	bssid_str, radio_mac_str, dev_mac_str;
+    em_2xlong_string_t parent;
+
+    bss = dm->get_bss_by_ref(index);
+    dm_easy_mesh_t::macbytes_to_string(dm->m_device.m_device_info.intf.mac, dev_mac_str);
+    dm_easy_mesh_t::macbytes_to_string(bss.m_bss_info.ruid.mac, radio_mac_str);
+    dm_easy_mesh_t::macbytes_to_string(bss.m_bss_info.bssid.mac, bssid_str);
+    snprintf(parent, sizeof(em_2xlong_string_t), "%s@%s@%s@%s@%d", dm->m_network.m_net_info.id, 
+            dev_mac_str, radio_mac_str, bssid_str, bss.m_bss_info.id.haul_type);
+    em_printfout("BSS[%d] Parent ID: %s\n", index, parent);
+
+    return dm_bss_list_t::set_config(m_db_client, bss, parent);
+}
+
+int dm_easy_mesh_ctrl_t::update_op_class_row(dm_easy_mesh_t *dm, unsigned int index)
+{
+    em_op_class_info_t *info = &dm->m_op_class[index].m_op_class_info;
+    mac_addr_str_t	radio_mac_str;
+    em_2xlong_string_t parent;
+
+    dm_easy_mesh_t::macbytes_to_string(info->id.ruid, radio_mac_str);
+    printf("%s:%d: Op Class[%d] ruid: %s\tType: %d\tClass: %d\tClass: %d\n", __func__, __LINE__, index,
+            radio_mac_str, info->id.type, info->id.op_class, info->op_class);
+    snprintf(parent, sizeof(em_2xlong_string_t), "%s@%d@%d", radio_mac_str, info->id.type, info->id.op_class);
+
+    return dm_op_class_list_t::set_config(m_db_client, dm->m_op_class[index], parent);
+}
+
 int dm_easy_mesh_ctrl_t::update_tables(dm_easy_mesh_t *dm)
 {
     //dm_orch_type_t type = dm_orch_type_none;
@@ -1676,9 +1845,10 @@ int dm_easy_mesh_ctrl_t::update_tables(dm_easy_mesh_t *dm)
     dm_bss_t bss;
     dm_sta_t *sta, *tmp;
     dm_network_ssid_t net_ssid;
-    mac_addr_str_t	sta_mac_str, bssid_str, radio_mac_str, dev_mac_str, scanner_mac_str;
+    mac_addr_str_t	radio_mac_str, dev_mac_str, scanner_mac_str;
     unsigned int i, j;
     em_2xlong_string_t parent, key;
+    dm_map_key_t map_key;
     em_string_t haul_str;
     bool at_least_one_failed = false;
 	char *criteria;
@@ -1758,15 +1928,8 @@ int dm_easy_mesh_ctrl_t::update_tables(dm_easy_mesh_t *dm)
 
     if (dm->db_cfg_type_is_set(db_cfg_type_bss_list_update)) {
         for (i = 0; i < dm->get_num_bss(); i++) {
-            bss = dm->get_bss_by_ref(i);
-    		dm_easy_mesh_t::macbytes_to_string(dm->m_device.m_device_info.intf.mac, dev_mac_str);
-    		dm_easy_mesh_t::macbytes_to_string(bss.m_bss_info.ruid.mac, radio_mac_str);
-			dm_easy_mesh_t::macbytes_to_string(bss.m_bss_info.bssid.mac, bssid_str);
-			snprintf(parent, sizeof(em_2xlong_string_t), "%s@%s@%s@%s@%d", dm->m_network.m_net_info.id, 
-					dev_mac_str, radio_mac_str, bssid_str, bss.m_bss_info.id.haul_type);
-            em_printfout("BSS[%d] Parent ID: %s\n", i, parent);
 			criteria = dm->db_cfg_type_get_criteria(db_cfg_type_bss_list_update);
-            if (dm_bss_list_t::set_config(m_db_client, bss, parent) != 0) {
+            if (update_bss_row(dm, i) != 0) {
                 at_least_one_failed = true;
             }
         }
@@ -1774,8 +1937,16 @@ int dm_easy_mesh_ctrl_t::update_tables(dm_easy_mesh_t *dm)
             at_least_one_failed = false;
         } else {
             dm->reset_db_cfg_type(db_cfg_type_bss_list_update);
+            dm->reset_bss_dirty(EM_MAX_BSSS);
         }
-    } 
+    } else {
+        // only the BSSs marked through set_bss_dirty()
+        for (i = 0; i < dm->get_num_bss(); i++) {
+            if ((dm->is_bss_dirty(i) == true) && (update_bss_row(dm, i) == 0)) {
+                dm->reset_bss_dirty(i);
+            }
+        }
+    }
 
     if (dm->db_cfg_type_is_set(db_cfg_type_bss_list_delete)) {
         for (i = 0; i < dm->get_num_bss(); i++) {
@@ -1796,15 +1967,8 @@ int dm_easy_mesh_ctrl_t::update_tables(dm_easy_mesh_t *dm)
 
 	if (dm->db_cfg_type_is_set(db_cfg_type_op_class_list_update)) {
         for (i = 0; i < dm->get_num_op_class(); i++) {
-            op_class = dm->get_op_class_by_ref(i);
-            dm_easy_mesh_t::macbytes_to_string(dm->m_op_class[i].m_op_class_info.id.ruid, radio_mac_str);
-            printf("%s:%d: Op Class[%d] ruid: %s\tType: %d\tClass: %d\tClass: %d\n", __func__, __LINE__, i,
-            	radio_mac_str, dm->m_op_class[i].m_op_class_info.id.type, dm->m_op_class[i].m_op_class_info.id.op_class,
-				dm->m_op_class[i].m_op_class_info.op_class);
-            snprintf(parent, sizeof(em_2xlong_string_t), "%s@%d@%d", radio_mac_str, dm->m_op_class[i].m_op_class_info.id.type, 
-					dm->m_op_class[i].m_op_class_info.id.op_class);
 			criteria = dm->db_cfg_type_get_criteria(db_cfg_type_op_class_list_update);
-            if (dm_op_class_list_t::set_config(m_db_client, dm->m_op_class[i], parent) != 0) {
+            if (update_op_class_row(dm, i) != 0) {
                 at_least_one_failed = true;
             }
         }
@@ -1812,9 +1976,17 @@ int dm_easy_mesh_ctrl_t::update_tables(dm_easy_mesh_t *dm)
             at_least_one_failed = false;
         } else {
             dm->reset_db_cfg_type(db_cfg_type_op_class_list_update);
+            dm->reset_op_class_dirty(EM_MAX_OPCLASS);
         }
 		printf("\n");
-    } 
+    } else {
+        // only the operating classes marked through set_op_class_dirty()
+        for (i = 0; i < dm->get_num_op_class(); i++) {
+            if ((dm->is_op_class_dirty(i) == true) && (update_op_class_row(dm, i) == 0)) {
+                dm->reset_op_class_dirty(i);
+            }
+        }
+    }
 
     if (dm->db_cfg_type_is_set(db_cfg_type_op_class_list_delete)) {
         for (i = 0; i < dm->get_num_op_class(); i++) {
@@ -1839,16 +2011,16 @@ int dm_easy_mesh_ctrl_t::update_tables(dm_easy_mesh_t *dm)
     } 
 
     if (dm->db_cfg_type_is_set(db_cfg_type_sta_list_update)) {
-        sta = static_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_assoc_map));
+        sta = static_cast<dm_sta_t *> (dm->m_sta_assoc_map->get_first());
         while (sta != NULL) {
 			criteria = dm->db_cfg_type_get_criteria(db_cfg_type_sta_list_update);
             if (dm_sta_list_t::set_config(m_db_client, *sta, NULL) == 0) {
                 dm->reset_db_cfg_type(db_cfg_type_sta_list_update);
             }
-            sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_assoc_map, sta));
+            sta = static_cast<dm_sta_t *> (dm->m_sta_assoc_map->get_next(sta));
         }
 
-        sta = static_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_assoc_map));
+        sta = static_cast<dm_sta_t *> (dm->m_sta_assoc_map->get_first());
         while (sta != NULL) {
             tmp = sta;
 			criteria = dm->db_cfg_type_get_criteria(db_cfg_type_sta_list_update);
@@ -1856,12 +2028,9 @@ int dm_easy_mesh_ctrl_t::update_tables(dm_easy_mesh_t *dm)
                 dm->reset_db_cfg_type(db_cfg_type_sta_list_update);
             }
 
-            dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.id, sta_mac_str);
-            dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.bssid, bssid_str);
-            dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.radiomac, radio_mac_str);
-            snprintf(key, sizeof(em_2xlong_string_t), "%s@%s@%s", sta_mac_str, bssid_str, radio_mac_str);
-            sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_assoc_map, sta));
-            hash_map_remove(dm->m_sta_assoc_map, key);
+            dm_key_map_t::sta_key(&map_key, sta->m_sta_info.id, sta->m_sta_info.bssid, sta->m_sta_info.radiomac);
+            sta = static_cast<dm_sta_t *> (dm->m_sta_assoc_map->get_next(sta));
+            dm->m_sta_assoc_map->remove(&map_key);
             delete tmp;
         }
             
@@ -1869,29 +2038,26 @@ int dm_easy_mesh_ctrl_t::update_tables(dm_easy_mesh_t *dm)
     }
 
     if (dm->db_cfg_type_is_set(db_cfg_type_sta_list_delete)) {
-        sta = static_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_dassoc_map));
+        sta = static_cast<dm_sta_t *> (dm->m_sta_dassoc_map->get_first());
         while (sta != NULL) {
 			criteria = dm->db_cfg_type_get_criteria(db_cfg_type_sta_list_delete);
             if (dm_sta_list_t::update_db(m_db_client, dm_orch_type_db_delete, sta->get_sta_info()) != 0) {
                 dm->reset_db_cfg_type(db_cfg_type_sta_list_delete);
             }
-            sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_dassoc_map, sta));
+            sta = static_cast<dm_sta_t *> (dm->m_sta_dassoc_map->get_next(sta));
         }
 
-        sta = static_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_dassoc_map));
+        sta = static_cast<dm_sta_t *> (dm->m_sta_dassoc_map->get_first());
         while (sta != NULL) {
             tmp = sta;
 			criteria = dm->db_cfg_type_get_criteria(db_cfg_type_sta_list_delete);
             if (dm_sta_list_t::update_db(m_db_client, dm_orch_type_db_delete, sta->get_sta_info()) != 0) {
                 dm->reset_db_cfg_type(db_cfg_type_sta_list_delete);
             }
-            dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.id, sta_mac_str);
-            dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.bssid, bssid_str);
-            dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.radiomac, radio_mac_str);
-            snprintf(key, sizeof(em_2xlong_string_t), "%s@%s@%s", sta_mac_str, bssid_str, radio_mac_str);
-            sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_dassoc_map, sta));
+            dm_key_map_t::sta_key(&map_key, sta->m_sta_info.id, sta->m_sta_info.bssid, sta->m_sta_info.radiomac);
+            sta = static_cast<dm_sta_t *> (dm->m_sta_dassoc_map->get_next(sta));
 
-            hash_map_remove(dm->m_sta_dassoc_map, key);
+            dm->m_sta_dassoc_map->remove(&map_key);
             delete tmp;
         }
 		dm->reset_db_cfg_type(db_cfg_type_sta_list_delete);
@@ -1899,15 +2065,34 @@ int dm_easy_mesh_ctrl_t::update_tables(dm_easy_mesh_t *dm)
     }
 
     if (dm->db_cfg_type_is_set(db_cfg_type_sta_metrics_update)) {
-        sta = static_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_map));
+        sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_first());
         while (sta != NULL) {
 			criteria = dm->db_cfg_type_get_criteria(db_cfg_type_sta_metrics_update);
             if (dm_sta_list_t::set_config(m_db_client, *sta, NULL) == 0) {
                 dm->reset_db_cfg_type(db_cfg_type_sta_metrics_update);
             }
-            sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_map, sta));
+            sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
         }
 		dm->reset_db_cfg_type(db_cfg_type_sta_metrics_update);
+        dm->reset_sta_dirty();
+    } else if (dm->get_num_dirty_sta() > 0) {
+        // only the STAs marked through set_sta_dirty(), a failed row stays marked
+        sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_first());
+        while (sta != NULL) {
+            if (sta->is_dirty() == true) {
+                if (dm_sta_list_t::set_config(m_db_client, *sta, NULL) == 0) {
+                    sta->set_dirty(false);
+                } else {
+                    at_least_one_failed = true;
+                }
+            }
+            sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
+        }
+        if (at_least_one_failed == true) {
+            at_least_one_failed = false;
+        } else {
+            dm->reset_sta_dirty();
+        }
     }
 
     if (dm->db_cfg_type_is_set(db_cfg_type_network_ssid_list_update)) {
@@ -1948,8 +2133,8 @@ int dm_easy_mesh_ctrl_t::update_tables(dm_easy_mesh_t *dm)
     }
 
 	if (dm->db_cfg_type_is_set(db_cfg_type_scan_result_list_update)) {
-        for (i = 0; i < dm->get_num_scan_results(); i++) {
-            scan_result = dm->get_scan_result(i);
+        for (scan_result = static_cast<dm_scan_result_t *> (dm->m_scan_result_map->get_first()); scan_result != NULL;
+                scan_result = static_cast<dm_scan_result_t *> (dm->m_scan_result_map->get_next(scan_result))) {
 			dm_easy_mesh_t::macbytes_to_string(scan_result->m_scan_result.id.dev_mac, dev_mac_str);
 			dm_easy_mesh_t::macbytes_to_string(scan_result->m_scan_result.id.scanner_mac, scanner_mac_str);
             snprintf(parent, sizeof(em_2xlong_string_t), "%s@%s@%s@%d@%d@%d",
@@ -1997,94 +2182,83 @@ int dm_easy_mesh_ctrl_t::update_tables(dm_easy_mesh_t *dm)
     return 0;
 }
 
+bool dm_easy_mesh_ctrl_t::get_instance_mac(const char *instance, mac_address_t mac)
+{
+    int len = 0;
+
+    // instances name a MAC as printed by macbytes_to_string()
+    return (sscanf(instance, "%02hhx:%02hhx:%02hhx:%02hhx:%02hhx:%02hhx%n",
+            &mac[0], &mac[1], &mac[2], &mac[3], &mac[4], &mac[5], &len) == 6) && (instance[len] == '\0');
+}
+
 dm_easy_mesh_t* dm_easy_mesh_ctrl_t::get_dm_easy_mesh(char *instance, bool is_num)
 {
     dm_easy_mesh_ctrl_t *dm_ctrl = em_ctrl_t::get_em_ctrl_instance()->get_dm_ctrl();
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
+    mac_address_t dev_mac;
 
     if (is_num) {
-        if (dm == NULL || (dm->get_id() != atoi(instance))) {
-            dm = dm_ctrl->get_next_dm(dm);
-        }
-        return NULL;
+        return dm_ctrl->get_dm_by_id(atoi(instance));
     }
 
-    do {
-        char mac_str[18];
-        dm_device_t *dev = dm->get_device();
-        if (dev == NULL) {
-            dm = dm_ctrl->get_next_dm(dm);
-            continue;
-        }
-        em_device_info_t *di = dev->get_device_info();
-        dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *> (di->id.dev_mac), mac_str);
-        if (strcmp(instance, mac_str) == 0) {
-            return dm;
-        }
-        dm = dm_ctrl->get_next_dm(dm);
-    } while (dm != NULL);
+    if (get_instance_mac(instance, dev_mac) == false) {
+        return NULL;
+    }
 
-    return NULL;
+    return dm_ctrl->get_dm_by_dev_mac(dev_mac);
 }
 
 dm_device_t *dm_easy_mesh_ctrl_t::get_dm_dev(mac_address_t dev_mac, mac_address_t bmac)
 {
     dm_easy_mesh_ctrl_t *dm_ctrl = em_ctrl_t::get_em_ctrl_instance()->get_dm_ctrl();
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
+    dm_easy_mesh_t *dm = dm_ctrl->get_dm_by_bss(bmac);
+    dm_device_t *dev;
 
-    do {
-        dm_device_t *dev = dm->get_device();
-        if (dev == NULL) {
-            dm = dm_ctrl->get_next_dm(dm);
-            continue;
-        }
-        em_device_info_t *sdi = dev->get_device_info();
-        if (memcmp(dev_mac, sdi->id.dev_mac, sizeof(sdi->id.dev_mac)) == 0) {
-            dm = dm_ctrl->get_next_dm(dm);
+    // the device holding the backhaul BSS, a device is not its own backhaul
+    if ((dm != NULL) && ((dev = dm->get_device()) != NULL) &&
+            (memcmp(dev_mac, dev->get_device_info()->id.dev_mac, sizeof(mac_address_t)) != 0)) {
+        return dev;
+    }
+
+    // the BSSID is indexed to another data model or to none, search them all
+    for (dm = dm_ctrl->get_first_dm(); dm != NULL; dm = dm_ctrl->get_next_dm(dm)) {
+        if (((dev = dm->get_device()) == NULL) ||
+                (memcmp(dev_mac, dev->get_device_info()->id.dev_mac, sizeof(mac_address_t)) == 0)) {
             continue;
         }
-
         for (unsigned int i = 0; i < dm->get_num_bss(); i++) {
             dm_bss_t *bss = dm->get_bss(i);
-            if (bss == NULL) {
-                continue;
-            }
-            em_bss_info_t *bi = bss->get_bss_info();
-            if (memcmp(bmac, bi->bssid.mac, sizeof(bi->bssid.mac)) == 0) {
+            if ((bss != NULL) && (memcmp(bmac, bss->get_bss_info()->bssid.mac, sizeof(mac_address_t)) == 0)) {
                 return dev;
             }
         }
-        dm = dm_ctrl->get_next_dm(dm);
-    } while (dm != NULL);
+    }
 
     return NULL;
 }
 
 dm_radio_t* dm_easy_mesh_ctrl_t::get_dm_radio(dm_easy_mesh_t *dm, char *instance, bool is_num)
 {
-    dm_radio_t *radio = NULL;
+    mac_address_t ruid;
+    unsigned int i;
 
     if (is_num) {
         unsigned int idx = static_cast<unsigned int>(atoi(instance) - 1);
-        radio = dm->get_radio(idx);
-        return radio;
+        return (idx < dm->get_num_radios()) ? dm->get_radio(idx):NULL;
     }
 
-    for (unsigned int i = 0; i < dm->get_num_radios(); i++) {
-        char mac_str[18];
-        radio = dm->get_radio(i);
-        if (radio == NULL) {
-            continue;
-        }
-        em_radio_info_t *ri = radio->get_radio_info();
-        dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *> (ri->id.ruid), mac_str);
-        /* Probably wrong, we need base64 */
-        if (strcmp(instance, mac_str) == 0) {
+    /* Probably wrong, we need base64 */
+    if (get_instance_mac(instance, ruid) == false) {
+        return NULL;
+    }
+
+    for (i = 0; i < dm->get_num_radios(); i++) {
+        dm_radio_t *radio = dm->get_radio(i);
+        if ((radio != NULL) && (memcmp(radio->get_radio_info()->id.ruid, ruid, sizeof(mac_address_t)) == 0)) {
             return radio;
         }
     }
 
-    return radio;
+    return NULL;
 }
 
 dm_sta_t *dm_easy_mesh_ctrl_t::get_dm_bh_sta(dm_easy_mesh_t *dm, dm_radio_t *radio)
@@ -2113,18 +2287,18 @@ dm_sta_t *dm_easy_mesh_ctrl_t::get_dm_bh_sta(dm_easy_mesh_t *dm, dm_radio_t *rad
             continue;
         }
 
-        dm_sta_t *sta = static_cast<dm_sta_t *> (hash_map_get_first(sdm->m_sta_map));
+        dm_sta_t *sta = static_cast<dm_sta_t *> (sdm->m_sta_map->get_first());
         while (sta != NULL) {
             em_sta_info_t *si = sta->get_sta_info();
             if (si->associated == 0) {
-                sta = static_cast<dm_sta_t *> (hash_map_get_next(sdm->m_sta_map, sta));
+                sta = static_cast<dm_sta_t *> (sdm->m_sta_map->get_next(sta));
                 continue;
             }
             //si->radiomac; radio->m_radio_info.
             if (memcmp(di->backhaul_mac.mac, si->bssid, sizeof(si->bssid)) == 0) {
                 return sta;
             }
-            sta = static_cast<dm_sta_t *> (hash_map_get_next(sdm->m_sta_map, sta));
+            sta = static_cast<dm_sta_t *> (sdm->m_sta_map->get_next(sta));
         }
 
         sdm = dm_ctrl->get_next_dm(sdm);
@@ -2290,6 +2464,31 @@ bus_error_t dm_easy_mesh_ctrl_t::sta_tget(char *event_name, raw_data_t *p_data)
     return bus_get_cb_fwd(event_name, p_data, sta_tget_inner);
 }
 
+bus_error_t dm_easy_mesh_ctrl_t::orchdiag_get(char *event_name, raw_data_t *p_data)
+{
+    return bus_get_cb_fwd(event_name, p_data, orchdiag_get_inner);
+}
+
+bus_error_t dm_easy_mesh_ctrl_t::subtree_get(char *event_name, raw_data_t *p_data)
+{
+    return bus_get_cb_fwd(event_name, p_data, subtree_get_inner);
+}
+
+bus_error_t dm_easy_mesh_ctrl_t::subtree_set(char *event_name, raw_data_t *p_data)
+{
+    return bus_get_cb_fwd(event_name, p_data, subtree_set_inner);
+}
+
+bus_error_t dm_easy_mesh_ctrl_t::notify_get(char *event_name, raw_data_t *p_data)
+{
+    return bus_get_cb_fwd(event_name, p_data, notify_get_inner);
+}
+
+bus_error_t dm_easy_mesh_ctrl_t::notify_set(char *event_name, raw_data_t *p_data)
+{
+    return bus_get_cb_fwd(event_name, p_data, notify_set_inner);
+}
+
 const char* dm_easy_mesh_ctrl_t::get_table_instance(const char *src, char *instance, size_t max_len, bool *is_num)
 {
 	char *dst = instance;
@@ -2396,10 +2595,7 @@ bus_error_t dm_easy_mesh_ctrl_t::device_get_inner(char *event_name, raw_data_t *
     name = dm_ctrl->get_table_instance(name, instance, MAX_INSTANCE_LEN, &is_num);
     device_instance = is_num ? atoi(instance) : 0;
 
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
-    if (dm == NULL || (dm->get_id() != device_instance)) {
-        dm = dm_ctrl->get_next_dm(dm);
-    }
+    dm_easy_mesh_t *dm = dm_ctrl->get_dm_by_id(device_instance);
 
     if(dm == NULL) {
         em_printfout("dm is NULL");
@@ -2557,23 +2753,39 @@ bus_error_t dm_easy_mesh_ctrl_t::device_get_inner(char *event_name, raw_data_t *
 bus_error_t dm_easy_mesh_ctrl_t::device_tget_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
 {
     (void) user_data;
-    const char *root = event_name;
-    char path[512] = { 0 };
     bus_data_prop_t *property = NULL;
-    bus_error_t rc = bus_error_success;
+    bus_error_t rc;
+    unsigned int num;
 
     if (!event_name || !p_data) {
         return bus_error_invalid_input;
     }
 
     dm_easy_mesh_ctrl_t *dm_ctrl = em_ctrl_t::get_em_ctrl_instance()->get_dm_ctrl();
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
-    if (dm == NULL) {
+    if (dm_ctrl->get_first_dm() == NULL) {
         em_printfout("data model is NULL\n");
         return bus_error_invalid_input;
     }
 
+    if ((rc = device_tget_params(event_name, &property, 0, &num)) != bus_error_success) {
+        return rc;
+    }
+
+    if (property) {
+        dm_ctrl->raw_data_set(p_data, property);
+    }
+
+    return rc;
+}
+
+bus_error_t dm_easy_mesh_ctrl_t::device_tget_params(const char *root, bus_data_prop_t **property, unsigned int since, unsigned int *num)
+{
+    char path[512] = { 0 };
+    dm_easy_mesh_ctrl_t *dm_ctrl = em_ctrl_t::get_em_ctrl_instance()->get_dm_ctrl();
+    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
     unsigned int idx = 0;
+
+    *num = 0;
     while (dm != NULL) {
         dm_device_t *dev = dm->get_device();
         if (dev == NULL) {
@@ -2585,59 +2797,60 @@ bus_error_t dm_easy_mesh_ctrl_t::device_tget_inner(char *event_name, raw_data_t
             dm = dm_ctrl->get_next_dm(dm);
             continue;
         }
-        ++idx;
+        *num = ++idx;
+        // the instance is counted either way, the devices after it keep their number
+        if (dm->get_generation() <= since) {
+            dm = dm_ctrl->get_next_dm(dm);
+            continue;
+        }
         em_ieee_1905_security_cap_t *sec_cap = dm->get_ieee_1905_security_cap();
         if (sec_cap == NULL) {
             em_printfout("NULL sec_cap");
             return bus_error_invalid_input;
         }
 
-        dm_ctrl->property_append_tail(&property, root, idx, "ID", di->id.dev_mac);
-        dm_ctrl->property_append_tail(&property, root, idx, "Manufacturer", di->manufacturer);
-        dm_ctrl->property_append_tail(&property, root, idx, "SerialNumber", di->serial_number);
-        dm_ctrl->property_append_tail(&property, root, idx, "ManufacturerModel", di->manufacturer_model);
-        dm_ctrl->property_append_tail(&property, root, idx, "SoftwareVersion", di->software_ver);
-        dm_ctrl->property_append_tail(&property, root, idx, "ExecutionEnv", di->exec_env);
-        dm_ctrl->property_append_tail(&property, root, idx, "CountryCode", di->country_code);
+        dm_ctrl->property_append_tail(property, root, idx, "ID", di->id.dev_mac);
+        dm_ctrl->property_append_tail(property, root, idx, "Manufacturer", di->manufacturer);
+        dm_ctrl->property_append_tail(property, root, idx, "SerialNumber", di->serial_number);
+        dm_ctrl->property_append_tail(property, root, idx, "ManufacturerModel", di->manufacturer_model);
+        dm_ctrl->property_append_tail(property, root, idx, "SoftwareVersion", di->software_ver);
+        dm_ctrl->property_append_tail(property, root, idx, "ExecutionEnv", di->exec_env);
+        dm_ctrl->property_append_tail(property, root, idx, "CountryCode", di->country_code);
         if (memcmp(di->backhaul_mac.mac, ZERO_MAC_ADDR, sizeof(ZERO_MAC_ADDR)) == 0) {
-            dm_ctrl->property_append_tail(&property, root, idx, "BackhaulMACAddress", "");
+            dm_ctrl->property_append_tail(property, root, idx, "BackhaulMACAddress", "");
         } else {
-            dm_ctrl->property_append_tail(&property, root, idx, "BackhaulMACAddress", di->backhaul_mac.mac);
+            dm_ctrl->property_append_tail(property, root, idx, "BackhaulMACAddress", di->backhaul_mac.mac);
         }
         if (memcmp(di->backhaul_mac.mac, ZERO_MAC_ADDR, sizeof(ZERO_MAC_ADDR)) == 0) {
-            dm_ctrl->property_append_tail(&property, root, idx, "BackhaulALID", "");
+            dm_ctrl->property_append_tail(property, root, idx, "BackhaulALID", "");
         } else {
             dm_device_t *bhdev = dm_ctrl->get_dm_dev(di->id.dev_mac, di->backhaul_mac.mac);
             if (bhdev == NULL) {
-                dm_ctrl->property_append_tail(&property, root, idx, "BackhaulALID", "");
+                dm_ctrl->property_append_tail(property, root, idx, "BackhaulALID", "");
             } else {
                 em_device_info_t *bhdi = bhdev->get_device_info();
-                dm_ctrl->property_append_tail(&property, root, idx, "BackhaulALID", bhdi->id.dev_mac);
+                dm_ctrl->property_append_tail(property, root, idx, "BackhaulALID", bhdi->id.dev_mac);
             }
         }
         if (memcmp(di->backhaul_mac.mac, ZERO_MAC_ADDR, sizeof(ZERO_MAC_ADDR)) == 0) {
-            dm_ctrl->property_append_tail(&property, root, idx, "BackhaulMediaType", di->backhaul_media_type);
+            dm_ctrl->property_append_tail(property, root, idx, "BackhaulMediaType", di->backhaul_media_type);
         } else {
-            dm_ctrl->property_append_tail(&property, root, idx, "BackhaulMediaType", WIFI_80211_VARIANT_AC);
+            dm_ctrl->property_append_tail(property, root, idx, "BackhaulMediaType", WIFI_80211_VARIANT_AC);
         }
-        dm_ctrl->property_append_tail(&property, root, idx, "RadioNumberOfEntries", dm->get_num_radios());
-        dm_ctrl->property_append_tail(&property, root, idx, "CACStatusNumberOfEntries", 0U);
-        dm_ctrl->property_append_tail(&property, root, idx, "BackhaulDownNumberOfEntries", di->num_backhaul_down_mac);
-        dm_ctrl->property_append_tail(&property, root, idx, "OnboardingProtocol", sec_cap->onboarding_proto);
-        dm_ctrl->property_append_tail(&property, root, idx, "IntegrityAlgorithm", sec_cap->integrity_algo);
-        dm_ctrl->property_append_tail(&property, root, idx, "EncryptionAlgorithm", sec_cap->encryption_algo);
+        dm_ctrl->property_append_tail(property, root, idx, "RadioNumberOfEntries", dm->get_num_radios());
+        dm_ctrl->property_append_tail(property, root, idx, "CACStatusNumberOfEntries", 0U);
+        dm_ctrl->property_append_tail(property, root, idx, "BackhaulDownNumberOfEntries", di->num_backhaul_down_mac);
+        dm_ctrl->property_append_tail(property, root, idx, "OnboardingProtocol", sec_cap->onboarding_proto);
+        dm_ctrl->property_append_tail(property, root, idx, "IntegrityAlgorithm", sec_cap->integrity_algo);
+        dm_ctrl->property_append_tail(property, root, idx, "EncryptionAlgorithm", sec_cap->encryption_algo);
 
         snprintf(path, sizeof(path) - 1, "%s%d.Radio.", root, idx);
-        dm_ctrl->radio_tget_params(dm, path, &property);
+        dm_ctrl->radio_tget_params(dm, path, property);
 
         dm = dm_ctrl->get_next_dm(dm);
     }
 
-    if (property) {
-        dm_ctrl->raw_data_set(p_data, property);
-    }
-
-    return rc;
+    return bus_error_success;
 }
 
 bus_error_t dm_easy_mesh_ctrl_t::policy_get_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
@@ -2666,10 +2879,7 @@ bus_error_t dm_easy_mesh_ctrl_t::policy_get_inner(char *event_name, raw_data_t *
     name = dm_ctrl->get_table_instance(name, instance, MAX_INSTANCE_LEN, &is_num);
     device_instance = is_num ? atoi(instance) : 0;
 
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
-    if (dm == NULL || (dm->get_id() != device_instance)) {
-        dm = dm_ctrl->get_next_dm(dm);
-    }
+    dm_easy_mesh_t *dm = dm_ctrl->get_dm_by_id(device_instance);
 
     dm_device_t *dev = dm->get_device();
     if (dev == NULL) {
@@ -2784,15 +2994,29 @@ bus_error_t dm_easy_mesh_ctrl_t::ssid_get_inner(char *event_name, raw_data_t *p_
 bus_error_t dm_easy_mesh_ctrl_t::ssid_tget_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
 {
     const char *root = event_name;
-    char val_str[1024] = { 0 };
     bus_data_prop_t *property = NULL;
 
     dm_easy_mesh_ctrl_t *dm_ctrl = em_ctrl_t::get_em_ctrl_instance()->get_dm_ctrl();
     dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
     if (dm == NULL) {
-        dm = dm_ctrl->get_next_dm(dm);
+        em_printfout("data model is NULL");
+        return bus_error_invalid_input;
     }
 
+    dm_ctrl->ssid_tget_params(dm, root, &property);
+
+    if (property) {
+        dm_ctrl->raw_data_set(p_data, property);
+    }
+
+    return bus_error_success;
+}
+
+bus_error_t dm_easy_mesh_ctrl_t::ssid_tget_params(dm_easy_mesh_t *dm, const char *root, bus_data_prop_t **property)
+{
+    char val_str[1024] = { 0 };
+    dm_easy_mesh_ctrl_t *dm_ctrl = em_ctrl_t::get_em_ctrl_instance()->get_dm_ctrl();
+
     for (unsigned int idx = 1; idx <= dm->get_num_network_ssid(); idx++) {
         dm_network_ssid_t *ssid = dm->get_network_ssid(idx - 1);
         if (ssid == NULL) {
@@ -2801,26 +3025,22 @@ bus_error_t dm_easy_mesh_ctrl_t::ssid_tget_inner(char *event_name, raw_data_t *p
         }
         em_network_ssid_info_t *si = ssid->get_network_ssid_info();
 
-        dm_ctrl->property_append_tail(&property, root, idx, "SSID", si->ssid);
+        dm_ctrl->property_append_tail(property, root, idx, "SSID", si->ssid);
         memset(val_str, 0, sizeof(val_str));
         dm_ctrl->fill_comma_sep(si->band, ARRAY_SIZE(si->band), val_str);
-        dm_ctrl->property_append_tail(&property, root, idx, "Band", val_str);
-        dm_ctrl->property_append_tail(&property, root, idx, "Enable", si->enable);
+        dm_ctrl->property_append_tail(property, root, idx, "Band", val_str);
+        dm_ctrl->property_append_tail(property, root, idx, "Enable", si->enable);
         memset(val_str, 0, sizeof(val_str));
         dm_ctrl->fill_comma_sep(si->akm, ARRAY_SIZE(si->akm), val_str);
-        dm_ctrl->property_append_tail(&property, root, idx, "AKMsAllowed", val_str);
-        dm_ctrl->property_append_tail(&property, root, idx, "SuiteSelector", si->suite_select);
-        dm_ctrl->property_append_tail(&property, root, idx, "AdvertisementEnabled", si->advertisement);
-        dm_ctrl->property_append_tail(&property, root, idx, "MFPConfig", si->mfp);
-        dm_ctrl->property_append_tail(&property, root, idx, "MobilityDomain", si->mobility_domain);
+        dm_ctrl->property_append_tail(property, root, idx, "AKMsAllowed", val_str);
+        dm_ctrl->property_append_tail(property, root, idx, "SuiteSelector", si->suite_select);
+        dm_ctrl->property_append_tail(property, root, idx, "AdvertisementEnabled", si->advertisement);
+        dm_ctrl->property_append_tail(property, root, idx, "MFPConfig", si->mfp);
+        dm_ctrl->property_append_tail(property, root, idx, "MobilityDomain", si->mobility_domain);
         memset(val_str, 0, sizeof(val_str));
         dm_ctrl->fill_haul_type(si->haul_type, si->num_hauls, val_str);
-        dm_ctrl->property_append_tail(&property, root, idx, "HaulType", val_str);
-        dm_ctrl->property_append_tail(&property, root, idx, "AuthType", si->auth_type);
-    }
-
-    if (property) {
-        dm_ctrl->raw_data_set(p_data, property);
+        dm_ctrl->property_append_tail(property, root, idx, "HaulType", val_str);
+        dm_ctrl->property_append_tail(property, root, idx, "AuthType", si->auth_type);
     }
 
     return bus_error_success;
@@ -2900,10 +3120,7 @@ bus_error_t dm_easy_mesh_ctrl_t::radio_get_inner(char *event_name, raw_data_t *p
     name = dm_ctrl->get_table_instance(name, instance, MAX_INSTANCE_LEN, &is_num);
     device_instance = is_num ? atoi(instance) : 0;
 
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
-    if (dm == NULL || (dm->get_id() != device_instance)) {
-        dm = dm_ctrl->get_next_dm(dm);
-    }
+    dm_easy_mesh_t *dm = dm_ctrl->get_dm_by_id(device_instance);
 
     if(dm == NULL) {
         em_printfout("dm is NULL");
@@ -2973,10 +3190,7 @@ bus_error_t dm_easy_mesh_ctrl_t::radio_tget_inner(char *event_name, raw_data_t *
     name = dm_ctrl->get_table_instance(name, instance, MAX_INSTANCE_LEN, &is_num);
     device_instance = is_num ? atoi(instance) : 0;
 
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
-    if (dm == NULL || (dm->get_id() != device_instance)) {
-        dm = dm_ctrl->get_next_dm(dm);
-    }
+    dm_easy_mesh_t *dm = dm_ctrl->get_dm_by_id(device_instance);
 
     if(dm == NULL) {
         em_printfout("dm is NULL");
@@ -3089,10 +3303,7 @@ bus_error_t dm_easy_mesh_ctrl_t::rbhsta_get_inner(char *event_name, raw_data_t *
     name = dm_ctrl->get_table_instance(name, instance, MAX_INSTANCE_LEN, &is_num);
     device_instance = is_num ? atoi(instance) : 0;
 
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
-    if (dm == NULL || (dm->get_id() != device_instance)) {
-        dm = dm_ctrl->get_next_dm(dm);
-    }
+    dm_easy_mesh_t *dm = dm_ctrl->get_dm_by_id(device_instance);
 
     if(dm == NULL) {
         em_printfout("dm is NULL");
@@ -3150,10 +3361,7 @@ bus_error_t dm_easy_mesh_ctrl_t::rcaps_get_inner(char *event_name, raw_data_t *p
     name = dm_ctrl->get_table_instance(name, instance, MAX_INSTANCE_LEN, &is_num);
     device_instance = is_num ? atoi(instance) : 0;
 
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
-    if (dm == NULL || (dm->get_id() != device_instance)) {
-        dm = dm_ctrl->get_next_dm(dm);
-    }
+    dm_easy_mesh_t *dm = dm_ctrl->get_dm_by_id(device_instance);
 
     if(dm == NULL) {
         em_printfout("dm is NULL");
@@ -3217,10 +3425,7 @@ bus_error_t dm_easy_mesh_ctrl_t::wf6ap_get_inner(char *event_name, raw_data_t *p
     name = dm_ctrl->get_table_instance(name, instance, MAX_INSTANCE_LEN, &is_num);
     device_instance = is_num ? atoi(instance) : 0;
 
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
-    if (dm == NULL || (dm->get_id() != device_instance)) {
-        dm = dm_ctrl->get_next_dm(dm);
-    }
+    dm_easy_mesh_t *dm = dm_ctrl->get_dm_by_id(device_instance);
 
     if(dm == NULL) {
         em_printfout("dm is NULL");
@@ -3328,10 +3533,7 @@ bus_error_t dm_easy_mesh_ctrl_t::wf6ap_tget_inner(char *event_name, raw_data_t *
     name = dm_ctrl->get_table_instance(name, instance, MAX_INSTANCE_LEN, &is_num);
     device_instance = is_num ? atoi(instance) : 0;
 
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
-    if (dm == NULL || (dm->get_id() != device_instance)) {
-        dm = dm_ctrl->get_next_dm(dm);
-    }
+    dm_easy_mesh_t *dm = dm_ctrl->get_dm_by_id(device_instance);
 
     if(dm == NULL) {
         em_printfout("dm is NULL");
@@ -3428,10 +3630,7 @@ bus_error_t dm_easy_mesh_ctrl_t::wf7ap_get_inner(char *event_name, raw_data_t *p
     name = dm_ctrl->get_table_instance(name, instance, MAX_INSTANCE_LEN, &is_num);
     device_instance = is_num ? atoi(instance) : 0;
 
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
-    if (dm == NULL || (dm->get_id() != device_instance)) {
-        dm = dm_ctrl->get_next_dm(dm);
-    }
+    dm_easy_mesh_t *dm = dm_ctrl->get_dm_by_id(device_instance);
 
     if(dm == NULL) {
         em_printfout("dm is NULL");
@@ -3508,10 +3707,7 @@ bus_error_t dm_easy_mesh_ctrl_t::wf7ap_tget_inner(char *event_name, raw_data_t *
     name = dm_ctrl->get_table_instance(name, instance, MAX_INSTANCE_LEN, &is_num);
     device_instance = is_num ? atoi(instance) : 0;
 
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
-    if (dm == NULL || (dm->get_id() != device_instance)) {
-        dm = dm_ctrl->get_next_dm(dm);
-    }
+    dm_easy_mesh_t *dm = dm_ctrl->get_dm_by_id(device_instance);
 
     if(dm == NULL) {
         em_printfout("dm is NULL");
@@ -3621,10 +3817,7 @@ bus_error_t dm_easy_mesh_ctrl_t::curops_get_inner(char *event_name, raw_data_t *
     name = dm_ctrl->get_table_instance(name, instance, MAX_INSTANCE_LEN, &is_num);
     device_instance = is_num ? atoi(instance) : 0;
 
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
-    if (dm == NULL || (dm->get_id() != device_instance)) {
-        dm = dm_ctrl->get_next_dm(dm);
-    }
+    dm_easy_mesh_t *dm = dm_ctrl->get_dm_by_id(device_instance);
 
     if(dm == NULL) {
         em_printfout("dm is NULL");
@@ -3682,10 +3875,7 @@ bus_error_t dm_easy_mesh_ctrl_t::curops_tget_inner(char *event_name, raw_data_t
     name = dm_ctrl->get_table_instance(name, instance, MAX_INSTANCE_LEN, &is_num);
     device_instance = is_num ? atoi(instance) : 0;
 
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
-    if (dm == NULL || (dm->get_id() != device_instance)) {
-        dm = dm_ctrl->get_next_dm(dm);
-    }
+    dm_easy_mesh_t *dm = dm_ctrl->get_dm_by_id(device_instance);
 
     if(dm == NULL) {
         em_printfout("dm is NULL");
@@ -3742,7 +3932,7 @@ dm_sta_t* dm_easy_mesh_ctrl_t::get_dm_sta(dm_easy_mesh_t *dm, em_bss_info_t *bi,
     int scnt = 0;
     mac_addr_str_t bss_str, sta_str;
 
-    dm_sta_t *sta = static_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_map));
+    dm_sta_t *sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_first());
     while (sta != NULL) {
         em_sta_info_t *si = sta->get_sta_info();
         dm_easy_mesh_t::macbytes_to_string(bi->bssid.mac, bss_str);
@@ -3750,14 +3940,14 @@ dm_sta_t* dm_easy_mesh_ctrl_t::get_dm_sta(dm_easy_mesh_t *dm, em_bss_info_t *bi,
         em_printfout("Comparing bss:%s sta:%s", bss_str, sta_str);
         if (si->associated == 0 ||
             memcmp(bi->bssid.mac, si->bssid, sizeof(si->bssid)) != 0) {
-            sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_map, sta));
+            sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
             continue;
         }
         ++scnt;
         if (scnt == instance) {
             return sta;
         }
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_map, sta));
+        sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
     }
 
     return NULL;
@@ -3791,10 +3981,7 @@ bus_error_t dm_easy_mesh_ctrl_t::bss_get_inner(char *event_name, raw_data_t *p_d
     name = dm_ctrl->get_table_instance(name, instance, MAX_INSTANCE_LEN, &is_num);
     device_instance = is_num ? atoi(instance) : 0;
 
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
-    if (dm == NULL || (dm->get_id() != device_instance)) {
-        dm = dm_ctrl->get_next_dm(dm);
-    }
+    dm_easy_mesh_t *dm = dm_ctrl->get_dm_by_id(device_instance);
 
     if(dm == NULL) {
         em_printfout("dm is NULL");
@@ -3920,10 +4107,7 @@ bus_error_t dm_easy_mesh_ctrl_t::bss_tget_inner(char *event_name, raw_data_t *p_
     name = dm_ctrl->get_table_instance(name, instance, MAX_INSTANCE_LEN, &is_num);
     device_instance = is_num ? atoi(instance) : 0;
 
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
-    if (dm == NULL || (dm->get_id() != device_instance)) {
-        dm = dm_ctrl->get_next_dm(dm);
-    }
+    dm_easy_mesh_t *dm = dm_ctrl->get_dm_by_id(device_instance);
 
     if(dm == NULL) {
         em_printfout("dm is NULL");
@@ -4013,10 +4197,7 @@ bus_error_t dm_easy_mesh_ctrl_t::sta_get_inner(char *event_name, raw_data_t *p_d
     name = dm_ctrl->get_table_instance(name, instance, MAX_INSTANCE_LEN, &is_num);
     device_instance = is_num ? atoi(instance) : 0;
 
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
-    if (dm == NULL || (dm->get_id() != device_instance)) {
-        dm = dm_ctrl->get_next_dm(dm);
-    }
+    dm_easy_mesh_t *dm = dm_ctrl->get_dm_by_id(device_instance);
 
     if(dm == NULL) {
         em_printfout("dm is NULL");
@@ -4115,6 +4296,479 @@ bus_error_t dm_easy_mesh_ctrl_t::sta_get_inner(char *event_name, raw_data_t *p_d
     return rc;
 }
 
+bus_error_t dm_easy_mesh_ctrl_t::orchdiag_get_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
+{
+    (void) user_data;
+    const char *param;
+    bus_error_t rc = bus_error_success;
+    em_ctrl_t *ctrl = em_ctrl_t::get_em_ctrl_instance();
+    dm_easy_mesh_ctrl_t *dm_ctrl = ctrl->get_dm_ctrl();
+    cJSON *parent;
+    char *tmp;
+
+    if (!event_name || !p_data) {
+        return bus_error_invalid_input;
+    }
+
+    param = strrchr(event_name, '.');
+    if (param == NULL) {
+        return bus_error_invalid_input;
+    }
+    ++param;
+
+    if (strcmp(param, "PendingCommands") == 0) {
+        rc = dm_ctrl->raw_data_set(p_data, static_cast<uint32_t>(ctrl->get_orch()->get_num_pending()));
+    } else if (strcmp(param, "ActiveCommands") == 0) {
+        rc = dm_ctrl->raw_data_set(p_data, static_cast<uint32_t>(ctrl->get_orch()->m_active.count));
+    } else if (strcmp(param, "Latency") == 0) {
+        parent = cJSON_CreateObject();
+        ctrl->get_orch_stats(parent);
+        tmp = cJSON_PrintUnformatted(parent);
+        rc = dm_ctrl->raw_data_set(p_data, tmp);
+        cJSON_free(tmp);
+        cJSON_Delete(parent);
+    } else {
+        rc = bus_error_invalid_input;
+    }
+
+    return rc;
+}
+
+/* The counters are safe to read from any thread, answered without the event queue
+   so that they can still be read while the manager is stalled */
+bus_error_t dm_easy_mesh_ctrl_t::perf_get(char *event_name, raw_data_t *p_data)
+{
+    const char *param;
+    bus_error_t rc = bus_error_success;
+    cJSON *parent, *obj;
+    char *tmp;
+
+    if (!event_name || !p_data) {
+        return bus_error_invalid_input;
+    }
+
+    param = strrchr(event_name, '.');
+    if (param == NULL) {
+        return bus_error_invalid_input;
+    }
+    ++param;
+
+    parent = cJSON_CreateObject();
+    if (strcmp(param, "FrameLatency") == 0) {
+        obj = parent;
+        em_frame_trace_t::encode(obj);
+    } else if (strcmp(param, "Stacks") == 0) {
+        obj = parent;
+        em_stack_t::encode(obj);
+    } else if ((strcmp(param, "Counters") == 0) || (strcmp(param, "Gauges") == 0) || (strcmp(param, "Latency") == 0)) {
+        em_perf_t::encode(parent);
+        obj = cJSON_GetObjectItem(parent, param);
+    } else {
+        cJSON_Delete(parent);
+        return bus_error_invalid_input;
+    }
+    tmp = cJSON_PrintUnformatted(obj);
+    rc = raw_data_set(p_data, tmp);
+    cJSON_free(tmp);
+    cJSON_Delete(parent);
+
+    return rc;
+}
+
+bus_error_t dm_easy_mesh_ctrl_t::perf_get_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
+{
+    (void) user_data;
+
+    return em_ctrl_t::get_em_ctrl_instance()->get_dm_ctrl()->perf_get(event_name, p_data);
+}
+
+/* The accounting is thread safe, answered without the event queue like the counters */
+bus_error_t dm_easy_mesh_ctrl_t::mem_get(char *event_name, raw_data_t *p_data)
+{
+    return mem_get_inner(event_name, p_data, NULL);
+}
+
+bus_error_t dm_easy_mesh_ctrl_t::mem_set(char *event_name, raw_data_t *p_data)
+{
+    return mem_set_inner(event_name, p_data, NULL);
+}
+
+bus_error_t dm_easy_mesh_ctrl_t::mem_get_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
+{
+    (void) user_data;
+    dm_easy_mesh_ctrl_t *dm_ctrl = em_ctrl_t::get_em_ctrl_instance()->get_dm_ctrl();
+    em_mem_acct_t *acct = em_ctrl_t::get_em_ctrl_instance()->get_mem_acct();
+    em_mem_acct_params_t params = acct->get_params();
+    bus_error_t rc;
+    cJSON *obj;
+    char *tmp;
+
+    if (!event_name || !p_data) {
+        return bus_error_invalid_input;
+    }
+
+    if (strcmp(event_name, DE_MEM_AGENT_BUDGET) == 0) {
+        return dm_ctrl->raw_data_set(p_data, static_cast<uint32_t> (params.agent_budget));
+    } else if (strcmp(event_name, DE_MEM_TOTAL_BUDGET) == 0) {
+        return dm_ctrl->raw_data_set(p_data, static_cast<uint32_t> (params.total_budget));
+    } else if (strcmp(event_name, DE_MEM_MAX_AGENTS) == 0) {
+        return dm_ctrl->raw_data_set(p_data, static_cast<uint32_t> (params.max_agents));
+    } else if (strcmp(event_name, DE_MEM_AGENTS) != 0) {
+        return bus_error_invalid_input;
+    }
+
+    obj = cJSON_CreateObject();
+    acct->encode(obj);
+    tmp = cJSON_PrintUnformatted(obj);
+    rc = dm_ctrl->raw_data_set(p_data, tmp);
+    cJSON_free(tmp);
+    cJSON_Delete(obj);
+
+    return rc;
+}
+
+bus_error_t dm_easy_mesh_ctrl_t::mem_set_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
+{
+    (void) user_data;
+    em_mem_acct_t *acct = em_ctrl_t::get_em_ctrl_instance()->get_mem_acct();
+    em_mem_acct_params_t params = acct->get_params();
+
+    if (!event_name || !p_data) {
+        return bus_error_invalid_input;
+    }
+
+    if (p_data->data_type != bus_data_type_uint32) {
+        return bus_error_invalid_input;
+    }
+
+    // in bytes, 0 for no limit
+    if (strcmp(event_name, DE_MEM_AGENT_BUDGET) == 0) {
+        params.agent_budget = p_data->raw_data.u32;
+    } else if (strcmp(event_name, DE_MEM_TOTAL_BUDGET) == 0) {
+        params.total_budget = p_data->raw_data.u32;
+    } else if (strcmp(event_name, DE_MEM_MAX_AGENTS) == 0) {
+        params.max_agents = p_data->raw_data.u32;
+    } else {
+        return bus_error_invalid_input;
+    }
+    acct->set_params(&params);
+
+    return bus_error_success;
+}
+
+/* The whole Network subtree in one walk of the data models, or only the devices
+   changed after SinceGeneration. The Generation sent with the tree is the one to
+   set as SinceGeneration for the next get. */
+bus_error_t dm_easy_mesh_ctrl_t::subtree_get_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
+{
+    (void) user_data;
+    const char *param;
+    bus_data_prop_t *property = NULL;
+    bus_error_t rc = bus_error_success;
+    dm_easy_mesh_ctrl_t *dm_ctrl = em_ctrl_t::get_em_ctrl_instance()->get_dm_ctrl();
+    dm_easy_mesh_t *dm;
+    em_string_t str_val;
+    unsigned int since, num;
+
+    if (!event_name || !p_data) {
+        return bus_error_invalid_input;
+    }
+
+    param = strrchr(event_name, '.');
+    if (param == NULL) {
+        return bus_error_invalid_input;
+    }
+    ++param;
+
+    if (strcmp(param, "Generation") == 0) {
+        return dm_ctrl->raw_data_set(p_data, dm_easy_mesh_t::get_last_generation());
+    } else if (strcmp(param, "SinceGeneration") == 0) {
+        return dm_ctrl->raw_data_set(p_data, dm_ctrl->m_subtree_since);
+    } else if (strcmp(param, "Tree") != 0) {
+        return bus_error_invalid_input;
+    }
+
+    // devices after one created or deleted were renumbered, they are all sent again
+    since = (dm_ctrl->m_data_model_list.get_generation() > dm_ctrl->m_subtree_since) ? 0:dm_ctrl->m_subtree_since;
+    dm_ctrl->property_append_tail(&property, DE_SUBTREE_GENERATION, dm_easy_mesh_t::get_last_generation());
+
+    if ((dm = dm_ctrl->get_first_dm()) != NULL) {
+        dm_ctrl->property_append_tail(&property, DE_NETWORK_ID, GLOBAL_NET_ID);
+        dm_easy_mesh_t::macbytes_to_string(dm->get_controller_interface_mac(), str_val);
+        dm_ctrl->property_append_tail(&property, DE_NETWORK_CTRLID, str_val);
+        dm_easy_mesh_t::macbytes_to_string(dm->get_ctrl_al_interface_mac(), str_val);
+        dm_ctrl->property_append_tail(&property, DE_NETWORK_COLAGTID, str_val);
+        if (dm->get_generation() > since) {
+            dm_ctrl->ssid_tget_params(dm, DATAELEMS_NETWORK "SSID.", &property);
+        }
+    }
+
+    rc = device_tget_params(DATAELEMS_NETWORK "Device.", &property, since, &num);
+    dm_ctrl->property_append_tail(&property, DE_NETWORK_DEVNOE, num);
+
+    dm_ctrl->raw_data_set(p_data, property);
+
+    return rc;
+}
+
+bus_error_t dm_easy_mesh_ctrl_t::subtree_set_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
+{
+    (void) user_data;
+    dm_easy_mesh_ctrl_t *dm_ctrl = em_ctrl_t::get_em_ctrl_instance()->get_dm_ctrl();
+
+    if (!event_name || !p_data) {
+        return bus_error_invalid_input;
+    }
+
+    if ((strcmp(event_name, DE_SUBTREE_SINCE) != 0) || (p_data->data_type != bus_data_type_uint32)) {
+        return bus_error_invalid_input;
+    }
+    dm_ctrl->m_subtree_since = p_data->raw_data.u32;
+
+    return bus_error_success;
+}
+
+bus_error_t dm_easy_mesh_ctrl_t::notify_get_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
+{
+    (void) user_data;
+    dm_easy_mesh_ctrl_t *dm_ctrl = em_ctrl_t::get_em_ctrl_instance()->get_dm_ctrl();
+    tr_181_notify_stats_t stats;
+
+    if (!event_name || !p_data) {
+        return bus_error_invalid_input;
+    }
+
+    if (strcmp(event_name, DE_NOTIFY_INTERVAL) == 0) {
+        return dm_ctrl->raw_data_set(p_data, dm_ctrl->get_notify()->get_interval());
+    } else if (strcmp(event_name, DE_NOTIFY_SUBS) == 0) {
+        dm_ctrl->get_notify()->get_stats(&stats);
+        return dm_ctrl->raw_data_set(p_data, stats.num_subs);
+    }
+
+    return bus_error_invalid_input;
+}
+
+bus_error_t dm_easy_mesh_ctrl_t::notify_set_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
+{
+    (void) user_data;
+    dm_easy_mesh_ctrl_t *dm_ctrl = em_ctrl_t::get_em_ctrl_instance()->get_dm_ctrl();
+
+    if (!event_name || !p_data) {
+        return bus_error_invalid_input;
+    }
+
+    if ((strcmp(event_name, DE_NOTIFY_INTERVAL) != 0) || (p_data->data_type != bus_data_type_uint32)) {
+        return bus_error_invalid_input;
+    }
+    if (dm_ctrl->get_notify()->set_interval(p_data->raw_data.u32) != 0) {
+        return bus_error_invalid_input;
+    }
+
+    return bus_error_success;
+}
+
+// value of a scalar parameter as a string, false for any other type
+static bool raw_data_to_string(raw_data_t *p_data, std::string& str)
+{
+    switch (p_data->data_type) {
+        case bus_data_type_boolean:
+            str = (p_data->raw_data.b == true) ? "true":"false";
+            break;
+        case bus_data_type_int32:
+            str = std::to_string(p_data->raw_data.i32);
+            break;
+        case bus_data_type_uint8:
+            str = std::to_string(p_data->raw_data.u8);
+            break;
+        case bus_data_type_uint16:
+            str = std::to_string(p_data->raw_data.u16);
+            break;
+        case bus_data_type_uint32:
+            str = std::to_string(p_data->raw_data.u32);
+            break;
+        case bus_data_type_string:
+            if (p_data->raw_data.bytes == NULL) {
+                return false;
+            }
+            str.assign(static_cast<const char *>(p_data->raw_data.bytes), strnlen(static_cast<const char *>(p_data->raw_data.bytes), p_data->raw_data_len));
+            break;
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+unsigned int dm_easy_mesh_ctrl_t::expire_scan_results(unsigned long long now_ms)
+{
+    std::vector<dm_scan_retention_entry_t> entries;
+    std::vector<std::pair<dm_easy_mesh_t *, dm_scan_result_t *> > results;
+    std::unique_ptr<bool[]> evict;
+    dm_easy_mesh_t *dm;
+    dm_scan_result_t *res;
+    dm_scan_retention_entry_t entry;
+    dm_map_key_t key;
+    unsigned int i, num;
+
+    if (m_scan_retention.is_enabled() == false) {
+        return 0;
+    }
+
+    for (dm = get_first_dm(); dm != NULL; dm = get_next_dm(dm)) {
+        res = static_cast<dm_scan_result_t *> (dm->m_scan_result_map->get_first());
+        while (res != NULL) {
+            // loaded from the database or filled before stamping, its age starts now
+            if (res->m_used_ms == 0) {
+                res->m_used_ms = now_ms;
+            }
+            entry.scanner = em_hex::pack_mac(res->m_scan_result.id.scanner_mac);
+            entry.used_ms = res->m_used_ms;
+            entry.bytes = sizeof(dm_scan_result_t);
+            entries.push_back(entry);
+            results.push_back(std::make_pair(dm, res));
+            res = static_cast<dm_scan_result_t *> (dm->m_scan_result_map->get_next(res));
+        }
+    }
+
+    if (entries.empty() == true) {
+        return 0;
+    }
+
+    evict.reset(new bool[entries.size()]);
+    if ((num = m_scan_retention.select(now_ms, entries.data(), static_cast<unsigned int> (entries.size()), evict.get())) == 0) {
+        return 0;
+    }
+
+    // the walk cursors may sit on a result deleted below
+    m_data_model_list.reset_walks();
+
+    for (i = 0; i < results.size(); i++) {
+        if (evict[i] == false) {
+            continue;
+        }
+        dm = results[i].first;
+        res = results[i].second;
+        delete_rows(m_db_client, &res->m_scan_result.id);
+        dm_key_map_t::scan_result_key(&key, &res->m_scan_result.id);
+        if (dm->m_scan_result_map->remove(&key) == res) {
+            delete res;
+        }
+    }
+
+    return num;
+}
+
+unsigned long long dm_easy_mesh_ctrl_t::evict_scan_results(dm_easy_mesh_t *dm, unsigned long long bytes)
+{
+    std::vector<dm_scan_result_t *> results;
+    dm_scan_result_t *res;
+    dm_map_key_t key;
+    unsigned long long freed = 0;
+    unsigned int i;
+
+    // a result not stamped yet is being filled or waits for its first retention pass, keep it
+    res = static_cast<dm_scan_result_t *> (dm->m_scan_result_map->get_first());
+    while (res != NULL) {
+        if (res->m_used_ms != 0) {
+            results.push_back(res);
+        }
+        res = static_cast<dm_scan_result_t *> (dm->m_scan_result_map->get_next(res));
+    }
+
+    if (results.empty() == true) {
+        return 0;
+    }
+
+    // least recently used first
+    std::sort(results.begin(), results.end(), [](const dm_scan_result_t *a, const dm_scan_result_t *b) {
+        return a->m_used_ms < b->m_used_ms;
+    });
+
+    m_data_model_list.reset_walks();
+
+    for (i = 0; (i < results.size()) && (freed < bytes); i++) {
+        res = results[i];
+        delete_rows(m_db_client, &res->m_scan_result.id);
+        dm_key_map_t::scan_result_key(&key, &res->m_scan_result.id);
+        if (dm->m_scan_result_map->remove(&key) == res) {
+            delete res;
+        }
+        freed += sizeof(dm_scan_result_t);
+    }
+
+    return freed;
+}
+
+#define CALLBACK_INNER(n, g, s)     ELEMENT(n, CALLBACK_GETTER(g##_inner)),
+
+void dm_easy_mesh_ctrl_t::publish_changes(unsigned long long now_ms)
+{
+    static const bus_data_cb_func_t getters[] = { TR_181_CALLBACKS(CALLBACK_INNER) };
+    tr_181_notify_t *notify = get_notify();
+    unsigned int since = m_notify_generation;
+    std::vector<std::string> paths;
+    bus_name_string_t prefix;
+    std::string tmpl, value;
+    dm_easy_mesh_t *dm;
+    raw_data_t raw;
+    unsigned int i, j;
+
+    if (notify->has_subs() == false) {
+        m_notify_generation = dm_easy_mesh_t::get_last_generation();
+        return;
+    }
+
+    // the setters bump the generation of their data model, only what changed is marked
+    if (dm_easy_mesh_t::get_last_generation() > since) {
+        dm = get_first_dm();
+        if ((m_data_model_list.get_generation() > since) || ((dm != NULL) && (dm->get_generation() > since))) {
+            // devices were renumbered or the network itself changed
+            notify->mark_changed(DATAELEMS_NETWORK);
+        } else {
+            for (; dm != NULL; dm = get_next_dm(dm)) {
+                if (dm->get_generation() > since) {
+                    snprintf(prefix, sizeof(bus_name_string_t), "%sDevice.%d.", DATAELEMS_NETWORK, dm->get_id());
+                    notify->mark_changed(prefix);
+                }
+            }
+        }
+        m_notify_generation = dm_easy_mesh_t::get_last_generation();
+    }
+
+    if (notify->get_batch(now_ms, paths) == 0) {
+        return;
+    }
+
+    for (i = 0; i < paths.size(); i++) {
+        tmpl = tr_181_notify_t::get_template(paths[i].c_str());
+        // tables and the Tree are property chains, their changes are not values of their own
+        if (((tmpl.size() >= 3) && (tmpl.compare(tmpl.size() - 3, 3, "{i}") == 0)) || (tmpl == DE_SUBTREE_TREE)) {
+            continue;
+        }
+        for (j = 0; j < ARRAY_SIZE(getters); j++) {
+            if (strcmp(getters[j].cb_table_name, tmpl.c_str()) == 0) {
+                break;
+            }
+        }
+        if (j == ARRAY_SIZE(getters)) {
+            continue;
+        }
+
+        memset(&raw, 0, sizeof(raw_data_t));
+        if (getters[j].cb_func.get_handler(const_cast<char *>(paths[i].c_str()), &raw, NULL) != bus_error_success) {
+            continue;
+        }
+        if ((raw_data_to_string(&raw, value) == true) && (notify->update_value(paths[i].c_str(), value) == true)) {
+            if (get_bus_descriptor()->bus_event_publish_fn(get_bus_hdl(), paths[i].c_str(), &raw) != bus_error_success) {
+                printf("%s:%d: Failed to publish %s\n", __func__, __LINE__, paths[i].c_str());
+            }
+        }
+        if (raw.data_type == bus_data_type_string) {
+            free(raw.raw_data.bytes);
+        }
+    }
+}
+
 bus_error_t dm_easy_mesh_ctrl_t::sta_tget_inner(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
 {
     (void) user_data;
@@ -4137,10 +4791,7 @@ bus_error_t dm_easy_mesh_ctrl_t::sta_tget_inner(char *event_name, raw_data_t *p_
     name = dm_ctrl->get_table_instance(name, instance, MAX_INSTANCE_LEN, &is_num);
     device_instance = is_num ? atoi(instance) : 0;
 
-    dm_easy_mesh_t *dm = dm_ctrl->get_first_dm();
-    if (dm == NULL || (dm->get_id() != device_instance)) {
-        dm = dm_ctrl->get_next_dm(dm);
-    }
+    dm_easy_mesh_t *dm = dm_ctrl->get_dm_by_id(device_instance);
 
     if(dm == NULL) {
         em_printfout("dm is NULL");
@@ -4186,12 +4837,12 @@ bus_error_t dm_easy_mesh_ctrl_t::sta_tget_params(dm_easy_mesh_t *dm, const char
 
     unsigned int idx = 0;
     dm_easy_mesh_ctrl_t *dm_ctrl = em_ctrl_t::get_em_ctrl_instance()->get_dm_ctrl();
-    dm_sta_t *sta = static_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_map));
+    dm_sta_t *sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_first());
     while (sta != NULL) {
         em_sta_info_t *si = sta->get_sta_info();
         if (si->associated == 0 ||
             memcmp(bi->bssid.mac, si->bssid, sizeof(si->bssid)) != 0) {
-            sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_map, sta));
+            sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
             continue;
         }
         ++idx;
@@ -4221,7 +4872,7 @@ bus_error_t dm_easy_mesh_ctrl_t::sta_tget_params(dm_easy_mesh_t *dm, const char
         dm_ctrl->property_append_tail(property, root, idx, "PairwiseAKM", 0U);
         dm_ctrl->property_append_tail(property, root, idx, "PairwiseCipher", 0U);
         dm_ctrl->property_append_tail(property, root, idx, "RSNCapabilities", 0U);
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_map, sta));
+        sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
     }
 
     return rc;
@@ -4237,9 +4888,11 @@ bus_error_t dm_easy_mesh_ctrl_t::bus_get_cb_fwd(char *event_name, raw_data_t *p_
     em_event_t *req;
     bus_resp_get_t *resp = NULL;
     uintptr_t buf;
+    em_perf_scope_t scope(em_perf_hist_tr181_get);
 
+    em_perf_t::inc(em_perf_ctr_tr181_gets);
     do {
-        req = static_cast<em_event_t *>(malloc(sizeof(em_event_t)));
+        req = em_ctrl_t::get_em_ctrl_instance()->alloc_event(0);
         if (!req) {
             err = bus_error_out_of_resources;
             break;
@@ -4270,13 +4923,24 @@ bus_error_t dm_easy_mesh_ctrl_t::bus_get_cb_fwd(char *event_name, raw_data_t *p_
 void dm_easy_mesh_ctrl_t::update_network_topology()
 {
     dm_easy_mesh_t *dm;
+    unsigned int num = 0, updated = 0;
+    bool full;
 
     assert(g_network_topology != NULL);
+    // the nodes of a data model deleted or created since may point to the wrong one, all are added again
+    full = (m_data_model_list.get_generation() != m_topo_list_generation);
+    m_topo_list_generation = m_data_model_list.get_generation();
     em_printfout("-----Updating network topology <start>-------");
     dm = get_first_dm();
     while (dm != NULL) {
         if (dm->get_colocated() == false) {
             std::string dev_mac_str = util::mac_to_string(dm->m_device.m_device_info.intf.mac);
+            num++;
+            if ((full == false) && (g_network_topology->is_current(dm) == true)) {
+                dm = get_next_dm(dm);
+                continue;
+            }
+            updated++;
             if (g_network_topology->find_topology(dm) == NULL) {
                 em_printfout("New dev_mac:%s num_bss:%d added in topology.",
                     dev_mac_str.c_str(), dm->get_num_bss());
@@ -4294,7 +4958,7 @@ void dm_easy_mesh_ctrl_t::update_network_topology()
         }
         dm = get_next_dm(dm);
     }
-    em_printfout("-----Updating network topology <end>-------");
+    em_printfout("-----Updating network topology <end>, %u of %u devices%s-------", updated, num, (full == true) ? ", full":"");
     g_network_topology->print_topology();
 }
 
@@ -4322,15 +4986,23 @@ void dm_easy_mesh_ctrl_t::init_network_topology()
 
 int dm_easy_mesh_ctrl_t::init(const char *data_model_path, em_mgr_t *mgr)
 {
-    int rc;
+    int rc, slot;
 
     m_data_model_list.init(mgr);
     init_tables();
 
-    if (m_db_client.init(data_model_path) != 0) {
+    slot = em_startup_prof_t::begin(em_startup_prof_phase, "db_connect");
+    rc = m_db_client.init(data_model_path);
+    em_startup_prof_t::end(slot);
+    if (rc != 0) {
         printf("%s:%d db init failed\n", __func__, __LINE__);
         return -1;
     }
+    slot = em_startup_prof_t::begin(em_startup_prof_phase, "db_snapshot");
+    if (m_db_client.open_snapshot(EM_DB_SNAPSHOT_FILE) == 0) {
+        printf("%s:%d: Loading tables from %s\n", __func__, __LINE__, EM_DB_SNAPSHOT_FILE);
+    }
+    em_startup_prof_t::end(slot);
     int pipefd[2];
 	int rcp;
 
@@ -4343,13 +5015,19 @@ int dm_easy_mesh_ctrl_t::init(const char *data_model_path, em_mgr_t *mgr)
 	m_nb_pipe_wr = pipefd[1];
 
 
+    slot = em_startup_prof_t::begin(em_startup_prof_phase, "tr181_schema");
     tr_181_t::init(this);
+    em_startup_prof_t::end(slot);
+
+    slot = em_startup_prof_t::begin(em_startup_prof_phase, "load_tables");
     rc = load_tables();
+    em_startup_prof_t::end(slot);
 
     //Database is empty and need to fill it, then load tables with data again
     if (rc == -1) {
        //Assuming this will not fail, and there is known setup script to fill data
        printf("%s:%d: data base empty ... fill it from /usr/ccsp/EasyMesh/setup_mysql_db_post.sh\n", __func__, __LINE__);
+       m_db_client.close_snapshot();
        std::system("/usr/ccsp/EasyMesh/setup_mysql_db_post.sh");
 
        //Load tables and update rc to check it for non-empty database
@@ -4361,6 +5039,16 @@ int dm_easy_mesh_ctrl_t::init(const char *data_model_path, em_mgr_t *mgr)
         return -1;
     }
 
+    // from now on row writes leave the event thread, the data model stays authoritative
+    if (m_db_client.start_writer(data_model_path) != 0) {
+        printf("%s:%d: DB writer not started, writes are synchronous\n", __func__, __LINE__);
+    }
+
+    // the database is compared with the snapshot while the controller already answers agents
+    if ((m_db_client.has_snapshot() == true) && (m_db_client.start_reconcile() != 0)) {
+        m_db_client.close_snapshot();
+    }
+
     return 0;
 }
 
@@ -4370,10 +5058,17 @@ dm_easy_mesh_ctrl_t::dm_easy_mesh_ctrl_t()
     m_nb_pipe_rd = 0;
     m_nb_pipe_rd = 0;
     m_nb_evt_id = 0;
+    m_subtree_since = 0;
+    m_notify_generation = 0;
+    m_topo_list_generation = 0;
 }
 
 dm_easy_mesh_ctrl_t::~dm_easy_mesh_ctrl_t()
 {
+    // the next start loads the tables from the snapshot instead of the database
+    if ((m_initialized == true) && (m_db_client.has_snapshot() == false)) {
+        m_db_client.save_snapshot(EM_DB_SNAPSHOT_FILE);
+    }
     if (m_nb_pipe_rd != 0) {
         close(m_nb_pipe_rd);
     }
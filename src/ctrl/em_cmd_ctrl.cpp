@@ -27,6 +27,7 @@
 #include <net/if.h>
 #include <linux/filter.h>
 #include <netinet/ether.h>
+#include <netinet/tcp.h>
 #include <netpacket/packet.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
@@ -37,16 +38,189 @@
 #include <sys/un.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <time.h>
 #include <cjson/cJSON.h>
 #include "em_cmd_ctrl.h"
+#include "dm_json_writer.h"
+
+static time_t get_monotonic_sec()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec;
+}
+
+// dm_json_writer_t sink framing a result into a buffer, as write_frame() does on a session
+static int append_frame(void *arg, const char *data, size_t len)
+{
+    std::string *buff = static_cast<std::string *> (arg);
+
+    buff->push_back(static_cast<char> (len >> 24));
+    buff->push_back(static_cast<char> (len >> 16));
+    buff->push_back(static_cast<char> (len >> 8));
+    buff->push_back(static_cast<char> (len));
+    if (len > 0) {
+        buff->append(data, len);
+    }
+
+    return 0;
+}
+
+void em_cmd_ctrl_t::close_session(SSL *ssl)
+{
+    int sd;
+
+    sd = SSL_get_fd(ssl);
+    SSL_shutdown(ssl);
+    SSL_free(ssl);
+    close(sd);
+}
+
+void em_cmd_ctrl_t::wake()
+{
+    if ((write(m_wake[1], "", 1) < 0) && (errno != EAGAIN)) {
+        printf("%s:%d: wake error, err:%d\n", __func__, __LINE__, errno);
+    }
+}
+
+bool em_cmd_ctrl_t::dispatch(const em_cmd_ctrl_reply_t *reply)
+{
+    em_ctrl_t *em_ctrl = em_ctrl_t::get_em_ctrl_instance();
+    em_event_t *evt = get_event(), *queued;
+
+    if (evt->type != em_event_type_bus) {
+        return false;
+    }
+
+    // until the data model and the topology are up only a reset goes through
+    if (((em_ctrl->is_data_model_initialized() == false) || (em_ctrl->is_network_topology_initialized() == false)) &&
+            (evt->u.bevt.type != em_bus_event_type_reset) && (evt->u.bevt.type != em_bus_event_type_get_reset)) {
+        return false;
+    }
+
+    if (em_mgr_t::is_result_deferred(evt) == false) {
+        return em_ctrl->io_process(evt);
+    }
+
+    if ((queued = em_ctrl->copy_event(evt)) == NULL) {
+        return false;
+    }
+
+    // known before the event is queued, the manager may answer it right away
+    pthread_mutex_lock(&m_pending_lock);
+    m_pending[queued] = *reply;
+    pthread_mutex_unlock(&m_pending_lock);
+
+    em_ctrl->push_to_queue(queued);
+
+    return true;
+}
+
+void em_cmd_ctrl_t::handle_command(SSL *ssl)
+{
+    em_cmd_ctrl_reply_t reply;
+    ssize_t ret;
+
+    reply.ssl = ssl;
+    reply.id = 0;
+
+    if (is_keep_alive(ssl) == true) {
+        // exactly one event, the next command of the client stays on the connection
+        if (read_event(ssl, get_event()) <= 0) {
+            close_session(ssl);
+            m_cmd.reset();
+            return;
+        }
+    } else if ((ret = read_event(ssl, get_event())) <= 0) {
+        printf("%s:%d: listen error on socket, err:%d\n", __func__, __LINE__, errno);
+    }
+
+    //printf("%s:%d: Read bytes: %d Size: %d Name: %s Buff: %s\n", __func__, __LINE__, ret, 
+        //get_event()->u.bevt.data_len, get_event()->u.bevt.u.subdoc.name, get_event()->u.bevt.u.subdoc.buff);
+
+    if (dispatch(&reply) == false) {
+        send_result(&reply, em_cmd_out_status_other, NULL);
+    }
+
+    m_cmd.reset();
+}
+
+int em_cmd_ctrl_t::handle_tagged_command(em_cmd_ctrl_session_t *session)
+{
+    unsigned char tag[EM_CMD_TAG_SZ];
+    em_cmd_ctrl_reply_t reply;
+
+    reply.ssl = session->ssl;
+
+    // the commands TLS has already read do not make the socket readable
+    do {
+        if ((read_all(session->ssl, tag, sizeof(tag)) <= 0) || (read_event(session->ssl, get_event()) <= 0)) {
+            m_cmd.reset();
+            return -1;
+        }
+        reply.id = (static_cast<unsigned int> (tag[0]) << 24) | (static_cast<unsigned int> (tag[1]) << 16) |
+            (static_cast<unsigned int> (tag[2]) << 8) | tag[3];
+
+        // the next command is read while this one waits for the orchestration
+        session->outstanding++;
+        if (dispatch(&reply) == false) {
+            send_result(&reply, em_cmd_out_status_other, NULL);
+        }
+        m_cmd.reset();
+    } while (SSL_pending(session->ssl) > 0);
+
+    return 0;
+}
+
+void em_cmd_ctrl_t::write_tagged_results(time_t now)
+{
+    std::vector<em_cmd_ctrl_tagged_result_t> results;
+    std::vector<em_cmd_ctrl_session_t>::iterator it;
+
+    pthread_mutex_lock(&m_parked_lock);
+    results.swap(m_tagged_results);
+    pthread_mutex_unlock(&m_parked_lock);
+
+    for (auto& res : results) {
+        for (it = m_sessions.begin(); (it != m_sessions.end()) && (it->ssl != res.ssl); it++);
+        if (it == m_sessions.end()) {
+            continue;
+        }
+
+        if ((it->closed == false) && (write_all(it->ssl, reinterpret_cast<const unsigned char *> (res.data.data()),
+                static_cast<unsigned int> (res.data.size())) != 0)) {
+            printf("%s:%d: write error on socket, err:%d\n", __func__, __LINE__, errno);
+            it->closed = true;
+        }
+        it->outstanding--;
+        it->last_used = now;
+
+        // a session left by its client is closed once nothing refers to it any more
+        if ((it->closed == true) && (it->outstanding == 0)) {
+            close_session(it->ssl);
+            m_sessions.erase(it);
+        }
+    }
+}
 
 int em_cmd_ctrl_t::execute(char *result)
 {
     int lsock, dsock;
     ssize_t ret;
     unsigned int sz = sizeof(em_event_t) + EM_MAX_EVENT_DATA_LEN;
-    unsigned char *tmp;
-    bool wait = false;
+    int nodelay = 1;
+    struct pollfd fds[EM_CMD_MAX_KEPT_SESSIONS + 2];
+    std::vector<em_cmd_ctrl_session_t> kept;
+    std::vector<SSL *> ready;
+    em_cmd_ctrl_session_t session;
+    unsigned int i, nfds;
+    char drain[64];
+    time_t now;
+    SSL *ssl;
     em_ctrl_t *em_ctrl = em_ctrl_t::get_em_ctrl_instance();
 
     m_cmd.reset();
@@ -67,8 +241,95 @@ int em_cmd_ctrl_t::execute(char *result)
         return -1;        
     }
 
+    if (pipe2(m_wake, O_NONBLOCK | O_CLOEXEC) != 0) {
+        printf("%s:%d: pipe error, err:%d\n", __func__, __LINE__, errno);
+        return -1;
+    }
+
+    // a client gone before its result is a failed write, not the end of the controller
+    signal(SIGPIPE, SIG_IGN);
+
+    session.outstanding = 0;
+    session.closed = false;
+
     while (1) {
 
+        // a tagged session left by its client waits for its results, it is not polled
+        fds[0].fd = lsock;
+        fds[1].fd = m_wake[0];
+        nfds = 2;
+        for (auto& it : m_sessions) {
+            fds[nfds++].fd = (it.closed == false) ? SSL_get_fd(it.ssl):-1;
+        }
+        for (i = 0; i < nfds; i++) {
+            fds[i].events = POLLIN;
+            fds[i].revents = 0;
+        }
+
+        if (poll(fds, nfds, 1000) < 0) {
+            if (errno != EINTR) {
+                printf("%s:%d: poll error, err:%d\n", __func__, __LINE__, errno);
+            }
+            continue;
+        }
+        now = get_monotonic_sec();
+
+        // the next command of a kept session or its close, the idle ones expire
+        ready.clear();
+        kept.clear();
+        for (i = 0; i < m_sessions.size(); i++) {
+            session = m_sessions[i];
+            if ((fds[i + 2].revents != 0) && (is_tagged(session.ssl) == true)) {
+                session.last_used = now;
+                session.closed = (handle_tagged_command(&session) != 0);
+            } else if (fds[i + 2].revents != 0) {
+                ready.push_back(session.ssl);
+                continue;
+            } else if ((session.outstanding == 0) && (now - session.last_used > EM_CMD_SESSION_IDLE_SEC)) {
+                session.closed = true;
+            }
+
+            if ((session.closed == true) && (session.outstanding == 0)) {
+                close_session(session.ssl);
+            } else {
+                kept.push_back(session);
+            }
+        }
+        m_sessions.swap(kept);
+
+        // the sessions whose result was sent wait for their next command
+        if (fds[1].revents != 0) {
+            while (read(m_wake[0], drain, sizeof(drain)) > 0);
+
+            write_tagged_results(now);
+
+            pthread_mutex_lock(&m_parked_lock);
+            for (auto it : m_parked) {
+                // a pipelined command already read from the socket does not make it readable
+                if (SSL_pending(it) > 0) {
+                    ready.push_back(it);
+                } else if (m_sessions.size() < EM_CMD_MAX_KEPT_SESSIONS) {
+                    session.ssl = it;
+                    session.last_used = now;
+                    session.outstanding = 0;
+                    session.closed = false;
+                    m_sessions.push_back(session);
+                } else {
+                    close_session(it);
+                }
+            }
+            m_parked.clear();
+            pthread_mutex_unlock(&m_parked_lock);
+        }
+
+        for (auto it : ready) {
+            handle_command(it);
+        }
+
+        if (fds[0].revents == 0) {
+            continue;
+        }
+
         //printf("%s:%d: Waiting for client connection\n", __func__, __LINE__);
         if ((dsock = accept(lsock, NULL, NULL)) == -1) {
             printf("%s:%d: listen error on socket, err:%d\n", __func__, __LINE__, errno);
@@ -77,85 +338,158 @@ int em_cmd_ctrl_t::execute(char *result)
 
         setsockopt(dsock, SOL_SOCKET, SO_SNDBUF, &sz, sizeof(sz)); // Send buffer EM_MAX_EVENT_DATA_LEN
         setsockopt(dsock, SOL_SOCKET, SO_RCVBUF, &sz, sizeof(sz)); // Receive buffer EM_MAX_EVENT_DATA_LEN
+        setsockopt(dsock, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay)); // frames go out without waiting for ACKs
 
         //printf("%s:%d: Connection accepted from client\n", __func__, __LINE__);
 
-        tmp = reinterpret_cast<unsigned char *> (get_event());
-        m_ssl = SSL_new(get_ssl_ctx());
-        SSL_set_fd(m_ssl, dsock);
+        ssl = SSL_new(get_ssl_ctx());
+        SSL_set_fd(ssl, dsock);
 
-        if (SSL_accept(m_ssl) <= 0) {
-            SSL_free(m_ssl);
+        if (SSL_accept(ssl) <= 0) {
+            SSL_free(ssl);
             close(dsock);
             continue;
         }
 
-		if ((ret = SSL_read(m_ssl, tmp, sizeof(em_event_t) + EM_MAX_EVENT_DATA_LEN)) <= 0) {
-			printf("%s:%d: listen error on socket, err:%d\n", __func__, __LINE__, errno);
-		}
-
-        //printf("%s:%d: Read bytes: %d Size: %d Name: %s Buff: %s\n", __func__, __LINE__, ret, 
-        	//get_event()->u.bevt.data_len, get_event()->u.bevt.u.subdoc.name, get_event()->u.bevt.u.subdoc.buff);
-        
-        switch (get_event()->type) {
+        if (is_tagged(ssl) == false) {
+            handle_command(ssl);
+        } else if (m_sessions.size() < EM_CMD_MAX_KEPT_SESSIONS) {
+            // its commands are read as the socket becomes readable
+            session.ssl = ssl;
+            session.last_used = now;
+            session.outstanding = 0;
+            session.closed = false;
+            m_sessions.push_back(session);
+        } else {
+            close_session(ssl);
+        }
+    }
 
-            case em_event_type_bus:
-                if (em_ctrl_t::get_em_ctrl_instance()->is_data_model_initialized() == true && em_ctrl->is_network_topology_initialized() == true) {
-                    wait = em_ctrl->io_process(get_event());
-                } else {
-                    if ((get_event()->u.bevt.type == em_bus_event_type_reset) || (get_event()->u.bevt.type == em_bus_event_type_get_reset) ){
-                        wait = em_ctrl->io_process(get_event());
-                    } else {
-                        wait = false;
-                    }
-                }
-                break;
+	close_listener_socket(lsock, get_svc());
 
-            default:
-                wait = false;
-                break;
-        }	
+    return 0;
+}
 
-		//printf("%s:%d: Sending result: Wait: %d\n", __func__, __LINE__, wait);
-        if (wait == false) {
-            send_result(em_cmd_out_status_other);
+int em_cmd_ctrl_t::send_result(const em_cmd_ctrl_reply_t *reply, em_cmd_out_status_t status, cJSON *result)
+{
+    em_cmd_ctrl_tagged_result_t tagged;
+    ssize_t ret;
+    cJSON *obj;
+    char *str;
+
+    if (is_tagged(reply->ssl) == true) {
+        // the id and then the frames, as a streaming session gets them
+        tagged.ssl = reply->ssl;
+        tagged.data.push_back(static_cast<char> (reply->id >> 24));
+        tagged.data.push_back(static_cast<char> (reply->id >> 16));
+        tagged.data.push_back(static_cast<char> (reply->id >> 8));
+        tagged.data.push_back(static_cast<char> (reply->id));
+
+        dm_json_writer_t writer(append_frame, &tagged.data);
+
+        writer.begin_object();
+        writer.add_string("Status", em_cmd_t::get_status_string(status));
+        if ((status == em_cmd_out_status_success) && (result != NULL)) {
+            writer.add_tree("Result", result);
         }
+        writer.end_object();
+        writer.flush();
+        append_frame(&tagged.data, NULL, 0);
 
-        m_cmd.reset();
-		
+        pthread_mutex_lock(&m_parked_lock);
+        m_tagged_results.push_back(std::move(tagged));
+        pthread_mutex_unlock(&m_parked_lock);
+        wake();
 
+        return 0;
     }
 
-	close_listener_socket(lsock, get_svc());
+    if (is_streaming(reply->ssl) == true) {
+        // framed as it is encoded, the result is never printed whole
+        dm_json_writer_t writer(write_frame, reply->ssl);
+
+        writer.begin_object();
+        writer.add_string("Status", em_cmd_t::get_status_string(status));
+        if ((status == em_cmd_out_status_success) && (result != NULL)) {
+            writer.add_tree("Result", result);
+        }
+        writer.end_object();
+        ret = ((writer.flush() == 0) && (write_frame(reply->ssl, NULL, 0) == 0)) ? 1:-1;
+    } else {
+        obj = cJSON_CreateObject();
+        cJSON_AddStringToObject(obj, "Status", em_cmd_t::get_status_string(status));
+        if ((status == em_cmd_out_status_success) && (result != NULL)) {
+            cJSON_AddItemReferenceToObject(obj, "Result", result);
+        }
+        str = cJSON_Print(obj);
+        ret = SSL_write(reply->ssl, str, static_cast<int> (strlen(str) + 1));
+        cJSON_free(str);
+        cJSON_Delete(obj);
+    }
+
+    if (ret <= 0) {
+        printf("%s:%d: write error on socket, err:%d\n", __func__, __LINE__, errno);
+    }
+
+	//printf("%s:%d: Send success bytes sent:%d\n", __func__, __LINE__, ret);
+    if ((ret > 0) && (m_wake[1] >= 0) && (is_keep_alive(reply->ssl) == true)) {
+        // the client sends its next command on the same session
+        pthread_mutex_lock(&m_parked_lock);
+        m_parked.push_back(reply->ssl);
+        pthread_mutex_unlock(&m_parked_lock);
+        wake();
+    } else {
+        close_session(reply->ssl);
+    }
 
     return 0;
 }
 
-int em_cmd_ctrl_t::send_result(em_cmd_out_status_t status)
+int em_cmd_ctrl_t::send_result(em_cmd_out_status_t status, cJSON *result)
 {
-    ssize_t ret;
-    char *str; 
-    unsigned char *tmp;
-	int sd;
+    std::map<em_event_t *, em_cmd_ctrl_reply_t>::iterator it;
+    em_cmd_ctrl_reply_t reply;
 
-	str = static_cast<char *> (malloc(EM_MAX_EVENT_DATA_LEN));
-	memset(str, 0, EM_MAX_EVENT_DATA_LEN);
+    pthread_mutex_lock(&m_pending_lock);
+    if ((m_current == NULL) || ((it = m_pending.find(m_current)) == m_pending.end())) {
+        // an event of the controller itself, no client waits for it
+        pthread_mutex_unlock(&m_pending_lock);
+        return -1;
+    }
+    reply = it->second;
+    m_pending.erase(it);
+    pthread_mutex_unlock(&m_pending_lock);
 
-    tmp = reinterpret_cast<unsigned char *> (m_cmd.status_to_string(status, str));
+    return send_result(&reply, status, result);
+}
 
-    if ((ret = SSL_write(m_ssl, tmp, static_cast<int> (strlen(str) + 1))) <= 0) {
-        printf("%s:%d: write error on socket, err:%d\n", __func__, __LINE__, errno);
+int em_cmd_ctrl_t::send_result(em_cmd_out_status_t status)
+{
+    cJSON *result = NULL;
+    int ret;
+
+    // the handler leaves the output of the command in its event
+    if ((status == em_cmd_out_status_success) && (m_current != NULL) && (m_current->type == em_event_type_bus)) {
+        result = cJSON_Parse(m_current->u.bevt.u.subdoc.buff);
     }
+    ret = send_result(status, result);
+    cJSON_Delete(result);
 
-	//printf("%s:%d: Send success bytes sent:%d\n", __func__, __LINE__, ret);
-	sd = SSL_get_fd(m_ssl);
-	SSL_shutdown(m_ssl);
-	SSL_free(m_ssl);
-	close(sd);
+    return ret;
+}
+
+void em_cmd_ctrl_t::end_event()
+{
+    bool answered;
 
-	free(str);
+    pthread_mutex_lock(&m_pending_lock);
+    answered = (m_pending.find(m_current) == m_pending.end());
+    pthread_mutex_unlock(&m_pending_lock);
 
-    return 0;
+    if (answered == false) {
+        send_result(em_cmd_out_status_other, NULL);
+    }
+    m_current = NULL;
 }
 
 
@@ -164,5 +498,26 @@ em_cmd_ctrl_t::em_cmd_ctrl_t()
     dm_easy_mesh_t dm;
 
     m_cmd.init(dm);
+
+    m_wake[0] = m_wake[1] = -1;
+    m_current = NULL;
+    pthread_mutex_init(&m_parked_lock, NULL);
+    pthread_mutex_init(&m_pending_lock, NULL);
+}
+
+em_cmd_ctrl_t::~em_cmd_ctrl_t()
+{
+    for (auto it : m_parked) {
+        close_session(it);
+    }
+    for (auto& it : m_sessions) {
+        close_session(it.ssl);
+    }
+    if (m_wake[0] >= 0) {
+        close(m_wake[0]);
+        close(m_wake[1]);
+    }
+    pthread_mutex_destroy(&m_parked_lock);
+    pthread_mutex_destroy(&m_pending_lock);
 }
 
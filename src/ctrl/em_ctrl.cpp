@@ -38,6 +38,9 @@
 #include <unistd.h>
 #include <pthread.h>
 #include <cjson/cJSON.h>
+#include <algorithm>
+#include <vector>
+#include <unordered_set>
 #include "em.h"
 #include "em_msg.h"
 #include "em_ctrl.h"
@@ -45,6 +48,13 @@
 #include "dm_easy_mesh.h"
 #include "em_orch_ctrl.h"
 #include "util.h"
+#include "em_trace.h"
+#include "em_perf.h"
+#include "em_frame_trace.h"
+#include "em_startup_prof.h"
+#include "em_capture.h"
+#include "em_sched.h"
+#include "em_profile.h"
 #include "wifi_util.h"
 
 #ifdef AL_SAP
@@ -59,6 +69,46 @@ AlServiceAccessPoint* g_sap;
 MacAddress g_al_mac_sap;
 #endif
 
+uint64_t em_ctrl_t::get_commit_key(em_commit_info_t *info)
+{
+    uint64_t key = em_intern_t::get_table()->intern(info->net_id, sizeof(info->net_id));
+    unsigned int i;
+
+    for (i = 0; i < sizeof(mac_address_t); i++) {
+        key = (key << 8) | info->mac[i];
+    }
+
+    return key;
+}
+
+bool em_ctrl_t::claim_dm_commit(em_commit_info_t *info)
+{
+    uint64_t key = get_commit_key(info);
+    uint64_t now = em_lat_hist_t::get_time_us();
+    bool claimed = true;
+
+    pthread_mutex_lock(&m_commit_lock);
+    auto it = m_pending_commits.find(key);
+    if (it == m_pending_commits.end()) {
+        m_pending_commits.emplace(key, now);
+    } else if (now - it->second < EM_CTRL_DM_COMMIT_PENDING_US) {
+        claimed = false;
+    } else {
+        // the commit was dropped without being handled, the search issues it again
+        it->second = now;
+    }
+    pthread_mutex_unlock(&m_commit_lock);
+
+    return claimed;
+}
+
+void em_ctrl_t::release_dm_commit(em_commit_info_t *info)
+{
+    pthread_mutex_lock(&m_commit_lock);
+    m_pending_commits.erase(get_commit_key(info));
+    pthread_mutex_unlock(&m_commit_lock);
+}
+
 void em_ctrl_t::handle_dm_commit(em_bus_event_t *evt)
 {
     em_commit_info_t *info;
@@ -100,6 +150,9 @@ void em_ctrl_t::handle_dm_commit(em_bus_event_t *evt)
         new_dm.set_db_cfg_param(db_cfg_type_device_list_update, "");
         m_data_model.set_config(&new_dm);
     }
+
+    // the data model exists from here, the next search of the device finds it
+    release_dm_commit(info);
 }
 
 void em_ctrl_t::handle_client_steer(em_bus_event_t *evt)
@@ -210,11 +263,15 @@ void em_ctrl_t::handle_set_policy(em_bus_event_t *evt)
         m_ctrl_cmd->send_result(em_cmd_out_status_prev_cmd_in_progress);
     } else if ((num = m_data_model.analyze_set_policy(evt, pcmd)) == 0) {
         m_ctrl_cmd->send_result(em_cmd_out_status_no_change);
-    } else if (m_orch->submit_commands(pcmd, static_cast<unsigned int> (num)) > 0) {
-        m_ctrl_cmd->send_result(em_cmd_out_status_success);
     } else {
-        m_ctrl_cmd->send_result(em_cmd_out_status_not_ready);
-    } 
+        // the encodings of the old policies are not sent again
+        get_policy_push()->clear_encodings();
+        if (m_orch->submit_commands(pcmd, static_cast<unsigned int> (num)) > 0) {
+            m_ctrl_cmd->send_result(em_cmd_out_status_success);
+        } else {
+            m_ctrl_cmd->send_result(em_cmd_out_status_not_ready);
+        }
+    }
 
 }
 
@@ -307,6 +364,7 @@ void em_ctrl_t::handle_get_dev_test(em_bus_event_t *evt)
     em_cmd_params_t params = evt->params;
     char *temp = NULL;
     bool teststatus = false;
+    unsigned int start = 0;
 
     if (params.u.args.num_args < 1) {
         m_ctrl_cmd->send_result(em_cmd_out_status_invalid_input);
@@ -316,15 +374,19 @@ void em_ctrl_t::handle_get_dev_test(em_bus_event_t *evt)
     if (m_orch->is_cmd_type_in_progress(evt) == true) {
     }
 
+    // DevTest@from=<em_list_next> pages through a long em_list
+    if ((temp = strstr(evt->u.subdoc.name, "@from=")) != NULL) {
+        start = static_cast<unsigned int> (strtoul(temp + strlen("@from="), NULL, 10));
+    }
+
     if ((temp = strstr(evt->u.subdoc.name, "update")) != NULL) {
 	dev_test.encode(&evt->u.subdoc, m_em_map, true, false);
     } else {
 	   
            teststatus = m_orch->get_dev_test_status();
-	   dev_test.encode(&evt->u.subdoc, m_em_map, false, teststatus);
+	   dev_test.encode(&evt->u.subdoc, m_em_map, false, teststatus, start);
     }
     evt->data_len = static_cast<unsigned int> (strlen(evt->u.subdoc.buff)) + 1;
-    m_ctrl_cmd->copy_bus_event(evt);
     m_ctrl_cmd->send_result(em_cmd_out_status_success);
 }
 
@@ -343,6 +405,7 @@ void em_ctrl_t::handle_set_dev_test(em_bus_event_t *evt)
 void em_ctrl_t::handle_get_dm_data(em_bus_event_t *evt)
 {           
     em_cmd_params_t params = evt->params;
+    cJSON *result;
         
     //em_cmd_t::dump_bus_event(evt);
     if (params.u.args.num_args < 1) {
@@ -350,12 +413,94 @@ void em_ctrl_t::handle_get_dm_data(em_bus_event_t *evt)
         return;
     }
 
-    m_data_model.get_config(params.u.args.args[1], &evt->u.subdoc);
-	evt->data_len = static_cast<unsigned int> (strlen(evt->u.subdoc.buff)) + 1;
-    m_ctrl_cmd->copy_bus_event(evt);
-    m_ctrl_cmd->send_result(em_cmd_out_status_success);
+    // streamed from the tree, a large list is never printed into the event
+    result = m_data_model.get_config_tree(params.u.args.args[1], &evt->u.subdoc);
+    m_ctrl_cmd->send_result(em_cmd_out_status_success, result);
+    cJSON_Delete(result);
 }        
 
+void em_ctrl_t::get_orch_stats(cJSON *parent)
+{
+    cJSON *arr, *obj, *states, *state_obj;
+    em_t *em;
+    em_sm_t *sm;
+    em_state_t state;
+    em_lat_hist_t hist;
+    mac_addr_str_t mac_str;
+    unsigned int i;
+
+    m_orch->encode_latency(cJSON_AddArrayToObject(parent, "Commands"));
+    m_orch->encode_class_latency(cJSON_AddArrayToObject(parent, "Classes"));
+
+    arr = cJSON_AddArrayToObject(parent, "Agents");
+    em = static_cast<em_t *> (hash_map_get_first(m_em_map));
+    while (em != NULL) {
+        sm = em->get_sm();
+        if ((em->get_orch_step_latency()->get_count() != 0) || (sm->get_num_transitions() != 0)) {
+            obj = cJSON_CreateObject();
+            dm_easy_mesh_t::macbytes_to_string(em->get_radio_interface_mac(), mac_str);
+            cJSON_AddStringToObject(obj, "Radio", mac_str);
+            em->get_orch_step_latency()->encode(cJSON_AddObjectToObject(obj, "Step"));
+            cJSON_AddNumberToObject(obj, "Transitions", sm->get_num_transitions());
+            cJSON_AddNumberToObject(obj, "StateRuns", sm->get_num_runs());
+            states = cJSON_AddArrayToObject(obj, "TimeInState");
+            for (i = 0; i < EM_SM_NUM_STATES; i++) {
+                state = em_sm_t::get_state_at(i);
+                if ((sm->get_time_in_state(state, &hist) == false) || (hist.get_count() == 0)) {
+                    continue;
+                }
+                state_obj = cJSON_CreateObject();
+                cJSON_AddStringToObject(state_obj, "State", em_t::state_2_str(state));
+                hist.encode(state_obj);
+                cJSON_AddItemToArray(states, state_obj);
+            }
+            cJSON_AddItemToArray(arr, obj);
+        }
+        em = static_cast<em_t *> (hash_map_get_next(m_em_map, em));
+    }
+
+    get_steer_outcomes()->encode(cJSON_AddArrayToObject(parent, "Steering"));
+}
+
+void em_ctrl_t::handle_get_orch_stats(em_bus_event_t *evt)
+{
+    cJSON *parent;
+
+    parent = cJSON_CreateObject();
+    get_orch_stats(cJSON_AddObjectToObject(parent, "OrchStats"));
+
+    m_ctrl_cmd->send_result(em_cmd_out_status_success, parent);
+    cJSON_Delete(parent);
+}
+
+void em_ctrl_t::handle_get_mem_stats(em_bus_event_t *evt)
+{
+    cJSON *parent;
+
+    parent = cJSON_CreateObject();
+    m_mem_acct.encode(cJSON_AddObjectToObject(parent, "MemStats"));
+
+    m_ctrl_cmd->send_result(em_cmd_out_status_success, parent);
+    cJSON_Delete(parent);
+}
+
+void em_ctrl_t::handle_get_perf_stats(em_bus_event_t *evt)
+{
+    cJSON *parent;
+
+    parent = cJSON_CreateObject();
+    em_perf_t::encode(cJSON_AddObjectToObject(parent, "PerfStats"));
+    em_frame_trace_t::encode(cJSON_AddObjectToObject(parent, "FrameLatency"));
+    em_stack_t::encode(cJSON_AddObjectToObject(parent, "Stacks"));
+    em_startup_prof_t::encode(cJSON_AddObjectToObject(parent, "Startup"));
+#ifdef EM_PROFILE
+    em_profile_t::encode(cJSON_AddArrayToObject(parent, "Profile"), EM_PROFILE_TOP_N, em_cmd_t::get_profile_type_str);
+#endif
+
+    m_ctrl_cmd->send_result(em_cmd_out_status_success, parent);
+    cJSON_Delete(parent);
+}
+
 void em_ctrl_t::handle_reset(em_bus_event_t *evt)
 {
     em_cmd_t *pcmd[EM_MAX_CMD] = {NULL};
@@ -409,6 +554,561 @@ void em_ctrl_t::handle_client_metrics_req()
     }
 }
 
+void em_ctrl_t::handle_topology_queries()
+{
+    mac_address_t agents[EM_TOPO_SCHED_MAX_PER_TICK];
+    unsigned long long now = em_timer_wheel_t::get_time_ms();
+    unsigned int i, num;
+    em_t *em, *found;
+    bool known;
+
+    if ((num = get_topo_sched()->get_due(now, agents, EM_TOPO_SCHED_MAX_PER_TICK)) == 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&m_mutex);
+    for (i = 0; i < num; i++) {
+        found = NULL;
+        known = false;
+        em = static_cast<em_t *> (hash_map_get_first(m_em_map));
+        while (em != NULL) {
+            if ((em->is_al_interface_em() == false) &&
+                    (memcmp(em->get_data_model()->get_agent_al_interface_mac(), agents[i], sizeof(mac_address_t)) == 0)) {
+                known = true;
+                if (em->get_state() == em_state_ctrl_configured) {
+                    found = em;
+                    break;
+                }
+            }
+            em = static_cast<em_t *> (hash_map_get_next(m_em_map, em));
+        }
+        if (found != NULL) {
+            // sent from the ticks of the em, the response comes back on any radio of the agent
+            found->request_topology_query();
+            found->wake();
+        } else if (known == true) {
+            get_topo_sched()->defer(agents[i], now);
+        } else {
+            get_topo_sched()->remove(agents[i]);
+        }
+    }
+    pthread_mutex_unlock(&m_mutex);
+}
+
+void em_ctrl_t::update_network_topology()
+{
+    em_route_t routes[EM_ROUTE_TABLE_MAX_ROUTES];
+    unsigned int i, num, changed;
+
+    m_data_model.update_network_topology();
+    if (g_network_topology == NULL) {
+        return;
+    }
+
+    if ((num = g_network_topology->get_routes(routes, EM_ROUTE_TABLE_MAX_ROUTES)) > EM_ROUTE_TABLE_MAX_ROUTES) {
+        printf("%s:%d: %u agents in the topology, only %d routed\n", __func__, __LINE__, num, EM_ROUTE_TABLE_MAX_ROUTES);
+        num = EM_ROUTE_TABLE_MAX_ROUTES;
+    }
+    changed = m_route_table.update(routes, num);
+
+    // the agents behind wireless hops or slow links are queried less often, the ones just onboarded included,
+    // and the agents of a backhaul branch take turns for their CACs
+    for (i = 0; i < num; i++) {
+        get_topo_sched()->set_min_period(routes[i].al_mac,
+            EM_TOPO_SCHED_MIN_PERIOD_MS * em_route_table_t::get_poll_scale(&routes[i]));
+        get_cac_sched()->set_group(routes[i].al_mac, routes[i].next_hop);
+    }
+    if (changed != 0) {
+        printf("%s:%d: %u routes changed, %u agents routed\n", __func__, __LINE__, changed, num);
+    }
+}
+
+void em_ctrl_t::handle_steer_engine()
+{
+    em_steer_decision_t decisions[EM_STEER_ENGINE_MAX_DECISIONS];
+    bool done[EM_STEER_ENGINE_MAX_DECISIONS] = {false};
+    unsigned int idx[EM_MAX_STEER_BATCH];
+    em_cmd_t *pcmd[EM_MAX_CMD] = {NULL};
+    em_cmd_steer_params_t params;
+    em_cmd_steer_batch_params_t batch;
+    em_steer_batch_entry_t *entry;
+    bssid_t wildcard = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+    unsigned long long now = em_timer_wheel_t::get_time_ms();
+    mac_addr_str_t sta_str, target_str;
+    em_op_class_info_t *op_class;
+    dm_easy_mesh_t *dm, *serving;
+    unsigned int i, j, num;
+    int num_cmds;
+    em_t *em;
+
+    num = m_steer_engine.evaluate(now, get_sta_metrics(), get_sta_history(), get_bss_history(), get_beacon_reports(),
+                                  decisions, EM_STEER_ENGINE_MAX_DECISIONS, get_client_caps(), get_unassoc_stas());
+
+    for (i = 0; i < num; i++) {
+        if (decisions[i].action == em_steer_action_beacon_report) {
+            pthread_mutex_lock(&m_mutex);
+            serving = NULL;
+            em = static_cast<em_t *> (hash_map_get_first(m_em_map));
+            while (em != NULL) {
+                if ((em->is_al_interface_em() == false) && (em->find_sta(decisions[i].sta, decisions[i].source) != NULL)) {
+                    if (em->request_beacon_report(decisions[i].sta, wildcard) > 0) {
+                        // sent from the ticks of the em
+                        em->wake();
+                    }
+                    serving = em->get_data_model();
+                    break;
+                }
+                em = static_cast<em_t *> (hash_map_get_next(m_em_map, em));
+            }
+            // and the other agents measure the STA on the channels of their radios, the STAs of an
+            // op class go in a single query per agent
+            em = static_cast<em_t *> (hash_map_get_first(m_em_map));
+            while ((em != NULL) && (serving != NULL)) {
+                if ((em->is_al_interface_em() == true) && ((dm = em->get_data_model()) != serving)) {
+                    for (j = 0; j < dm->get_num_op_class(); j++) {
+                        op_class = &dm->get_op_class(j)->m_op_class_info;
+                        if ((op_class->id.type == em_op_class_type_current) &&
+                                (em->request_unassoc_sta_metrics(decisions[i].sta, static_cast<unsigned char> (op_class->op_class),
+                                                                 static_cast<unsigned char> (op_class->channel)) > 0)) {
+                            em->wake();
+                        }
+                    }
+                }
+                em = static_cast<em_t *> (hash_map_get_next(m_em_map, em));
+            }
+            pthread_mutex_unlock(&m_mutex);
+            continue;
+        }
+        if (done[i] == true) {
+            continue;
+        }
+
+        // the STAs steered off the same BSS go in a single Client Steering Request
+        memset(&batch, 0, sizeof(batch));
+        memcpy(batch.source, decisions[i].source, sizeof(bssid_t));
+        batch.request_mode = 1;
+        batch.disassoc_imminent = true;
+        batch.btm_disassociation_timer = m_steer_engine.get_params().btm_disassoc_timer;
+        for (j = i; (j < num) && (batch.num < EM_MAX_STEER_BATCH); j++) {
+            if ((done[j] == true) || (decisions[j].action != em_steer_action_steer) ||
+                    (memcmp(decisions[j].source, batch.source, sizeof(bssid_t)) != 0)) {
+                continue;
+            }
+            entry = &batch.entries[batch.num];
+            memcpy(entry->sta_mac, decisions[j].sta, sizeof(mac_address_t));
+            memcpy(entry->target, decisions[j].target, sizeof(bssid_t));
+            entry->target_op_class = decisions[j].op_class;
+            entry->target_channel = decisions[j].channel;
+            idx[batch.num++] = j;
+            done[j] = true;
+        }
+
+        if (batch.num == 1) {
+            memset(&params, 0, sizeof(params));
+            memcpy(params.sta_mac, batch.entries[0].sta_mac, sizeof(mac_address_t));
+            memcpy(params.source, batch.source, sizeof(bssid_t));
+            memcpy(params.target, batch.entries[0].target, sizeof(bssid_t));
+            params.request_mode = batch.request_mode;
+            params.disassoc_imminent = batch.disassoc_imminent;
+            params.btm_disassociation_timer = batch.btm_disassociation_timer;
+            params.target_op_class = batch.entries[0].target_op_class;
+            params.target_channel = batch.entries[0].target_channel;
+            num_cmds = m_data_model.analyze_sta_steer(params, pcmd);
+        } else {
+            num_cmds = m_data_model.analyze_sta_steer_batch(batch, pcmd);
+        }
+
+        // backoff only once the command is queued, else the next pass decides again
+        if ((num_cmds <= 0) || (m_orch->submit_commands(pcmd, static_cast<unsigned int> (num_cmds)) == 0)) {
+            continue;
+        }
+        for (j = 0; j < batch.num; j++) {
+            m_steer_engine.steered(decisions[idx[j]].sta, now);
+            dm_easy_mesh_t::macbytes_to_string(decisions[idx[j]].sta, sta_str);
+            dm_easy_mesh_t::macbytes_to_string(decisions[idx[j]].target, target_str);
+            printf("%s:%d: Steering %s to %s, rcpi %d -> %d, decided in %llu ms\n", __func__, __LINE__,
+                sta_str, target_str, decisions[idx[j]].rcpi, decisions[idx[j]].target_rcpi, decisions[idx[j]].latency_ms);
+        }
+    }
+}
+
+void em_ctrl_t::handle_optimiser()
+{
+    em_optimiser_action_t actions[EM_OPTIMISER_MAX_ACTIONS];
+    em_cmd_t *pcmd[EM_MAX_CMD] = {NULL};
+    em_cmd_steer_params_t params;
+    unsigned long long now = em_timer_wheel_t::get_time_ms();
+    mac_addr_str_t mac_str, target_str;
+    unsigned int i, num;
+    int num_cmds;
+
+    num = get_optimiser()->run(now, EM_OPTIMISER_BUDGET_US, actions, EM_OPTIMISER_MAX_ACTIONS);
+
+    for (i = 0; i < num; i++) {
+        switch (actions[i].type) {
+            case em_optimiser_action_steer:
+                // the STAs steered by the engine or a plugin share one backoff
+                if (m_steer_engine.in_backoff(actions[i].sta, now) == true) {
+                    break;
+                }
+                memset(&params, 0, sizeof(params));
+                memcpy(params.sta_mac, actions[i].sta, sizeof(mac_address_t));
+                memcpy(params.source, actions[i].source, sizeof(bssid_t));
+                memcpy(params.target, actions[i].target, sizeof(bssid_t));
+                params.request_mode = 1;
+                params.disassoc_imminent = true;
+                params.btm_disassociation_timer = m_steer_engine.get_params().btm_disassoc_timer;
+                params.target_op_class = actions[i].op_class;
+                params.target_channel = actions[i].channel;
+                if (((num_cmds = m_data_model.analyze_sta_steer(params, pcmd)) <= 0) ||
+                        (m_orch->submit_commands(pcmd, static_cast<unsigned int> (num_cmds)) == 0)) {
+                    break;
+                }
+                m_steer_engine.steered(actions[i].sta, now);
+                get_optimiser()->applied(&actions[i], now);
+                dm_easy_mesh_t::macbytes_to_string(actions[i].sta, mac_str);
+                dm_easy_mesh_t::macbytes_to_string(actions[i].target, target_str);
+                printf("%s:%d: %s steers %s to %s, score %llu\n", __func__, __LINE__,
+                    get_optimiser()->get_name(actions[i].plugin), mac_str, target_str, actions[i].score);
+                break;
+
+            case em_optimiser_action_channel:
+                dm_easy_mesh_t::macbytes_to_string(actions[i].ruid, mac_str);
+                printf("%s:%d: %s proposes channel %u of op class %u for radio %s, score %llu\n", __func__, __LINE__,
+                    get_optimiser()->get_name(actions[i].plugin), actions[i].channel, actions[i].op_class, mac_str, actions[i].score);
+                break;
+
+            case em_optimiser_action_power:
+                dm_easy_mesh_t::macbytes_to_string(actions[i].ruid, mac_str);
+                printf("%s:%d: %s proposes %d dBm for radio %s, score %llu\n", __func__, __LINE__,
+                    get_optimiser()->get_name(actions[i].plugin), actions[i].tx_power, mac_str, actions[i].score);
+                break;
+        }
+    }
+}
+
+void em_ctrl_t::handle_tid_link_planner()
+{
+    typedef struct {
+        dm_easy_mesh_t  *dm;
+        em_t            *em;        // a configured radio em of the agent
+        bool            push;
+    } agent_t;
+    std::vector<agent_t> agents;
+    std::vector<em_tid_link_mld_t> mlds;
+    std::vector<unsigned int> owner;    // agent of each STA MLD
+    em_tid_link_decision_t decisions[EM_TID_LINK_PLANNER_MAX_DECISIONS];
+    em_tid_link_mld_t mld;
+    em_assoc_sta_mld_info_t *sta_mld;
+    em_affiliated_ap_info_t *ap;
+    unsigned long long now = em_timer_wheel_t::get_time_ms();
+    mac_addr_str_t mld_str;
+    unsigned int i, j, num;
+    dm_easy_mesh_t *dm;
+    em_t *em;
+
+    pthread_mutex_lock(&m_mutex);
+
+    // the radios of an agent share its data model, its STA MLDs are gathered once
+    em = static_cast<em_t *> (hash_map_get_first(m_em_map));
+    while (em != NULL) {
+        dm = em->get_data_model();
+        if ((em->is_al_interface_em() == true) || (em->get_state() != em_state_ctrl_configured) ||
+                (std::find_if(agents.begin(), agents.end(), [dm](const agent_t& a) { return a.dm == dm; }) != agents.end())) {
+            em = static_cast<em_t *> (hash_map_get_next(m_em_map, em));
+            continue;
+        }
+        agents.push_back({dm, em, false});
+        for (i = 0; i < dm->get_num_assoc_sta_mld(); i++) {
+            sta_mld = &dm->m_assoc_sta_mld[i].m_assoc_sta_mld_info;
+            memset(&mld, 0, sizeof(mld));
+            memcpy(mld.ap_mld, sta_mld->ap_mld_mac_addr, sizeof(mac_address_t));
+            memcpy(mld.sta_mld, sta_mld->mac_addr, sizeof(mac_address_t));
+            for (j = 0; (j < sta_mld->num_affiliated_sta) && (j < EM_MAX_AP_MLD) &&
+                    (mld.num_links < EM_TID_LINK_PLANNER_MAX_LINKS); j++) {
+                if (((ap = dm->find_affiliated_ap(sta_mld->affiliated_sta[j].bssid)) == NULL) ||
+                        (ap->link_id_valid == false) || (ap->link_id >= EM_TID_LINK_PLANNER_MAX_LINKS)) {
+                    continue;
+                }
+                memcpy(mld.links[mld.num_links].sta, sta_mld->affiliated_sta[j].mac_addr, sizeof(mac_address_t));
+                memcpy(mld.links[mld.num_links].bssid, sta_mld->affiliated_sta[j].bssid, sizeof(bssid_t));
+                mld.links[mld.num_links].link_id = ap->link_id;
+                mld.num_links++;
+            }
+            // a single link has nothing to map
+            if (mld.num_links > 1) {
+                mlds.push_back(mld);
+                owner.push_back(static_cast<unsigned int> (agents.size() - 1));
+            }
+        }
+        em = static_cast<em_t *> (hash_map_get_next(m_em_map, em));
+    }
+
+    num = m_tid_link_planner.evaluate(now, mlds.data(), static_cast<unsigned int> (mlds.size()),
+                                      get_sta_history(), get_bss_history(), decisions, EM_TID_LINK_PLANNER_MAX_DECISIONS);
+
+    for (i = 0; i < num; i++) {
+        for (j = 0; j < mlds.size(); j++) {
+            if (memcmp(mlds[j].sta_mld, decisions[i].sta_mld, sizeof(mac_address_t)) == 0) {
+                break;
+            }
+        }
+        if (j == mlds.size()) {
+            continue;
+        }
+        agent_t& agent = agents[owner[j]];
+
+        // the em still owns the mappings of its last push, the decision comes back on the next pass
+        if ((agent.em->has_requested_tid_to_link_map_policy() == true) ||
+                (agent.dm->m_tid_to_link.set_mapping(decisions[i].ap_mld, decisions[i].sta_mld,
+                    decisions[i].link_map, decisions[i].default_map) < 0)) {
+            continue;
+        }
+        agent.push = true;
+        m_tid_link_planner.pushed(&decisions[i], now);
+        dm_easy_mesh_t::macbytes_to_string(decisions[i].sta_mld, mld_str);
+        printf("%s:%d: TID-to-link map of %s: 0x%02x%s\n", __func__, __LINE__, mld_str, decisions[i].link_map,
+            (decisions[i].default_map == true) ? " (default)":"");
+    }
+
+    for (auto& agent : agents) {
+        if (agent.push == true) {
+            // sent from the ticks of the em
+            agent.em->request_tid_to_link_map_policy();
+            agent.em->wake();
+        }
+    }
+
+    pthread_mutex_unlock(&m_mutex);
+}
+
+void em_ctrl_t::measure_agent_mem(dm_easy_mesh_t *dm, em_mem_acct_usage_t *usage)
+{
+    std::unordered_set<em_packed_mac_t> stas;
+    em_metrics_sample_t sample;
+    em_beacon_report_entry_t report;
+    em_client_cap_t cap;
+    dm_sta_t *sta;
+    unsigned long long footprint;
+    unsigned char *mac;
+    em_t *em;
+
+    memset(usage, 0, sizeof(em_mem_acct_usage_t));
+    memcpy(usage->al_mac, dm->get_agent_al_interface_mac(), sizeof(mac_address_t));
+
+    usage->bytes[em_mem_acct_stas] = dm->m_sta_map->count() * sizeof(dm_sta_t);
+    usage->bytes[em_mem_acct_scan] = dm->m_scan_result_map->count() * sizeof(dm_scan_result_t);
+    footprint = dm->get_footprint();
+    usage->bytes[em_mem_acct_dm] = footprint - usage->bytes[em_mem_acct_stas] - usage->bytes[em_mem_acct_scan];
+
+    // a STA seen on several BSSs has one row in each cache
+    sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_first());
+    while (sta != NULL) {
+        mac = sta->m_sta_info.id;
+        if (stas.insert(em_hex::pack_mac(mac)).second == true) {
+            if (get_sta_history()->get_samples(mac, &sample, 1) > 0) {
+                usage->bytes[em_mem_acct_sta_caches] += sizeof(em_metrics_history_row_t);
+            }
+            if (get_beacon_reports()->get_reports(mac, &report, 1) > 0) {
+                usage->bytes[em_mem_acct_sta_caches] += sizeof(em_beacon_report_sta_t);
+            }
+            if (get_client_caps()->get(mac, &cap) == true) {
+                usage->bytes[em_mem_acct_sta_caches] += sizeof(em_client_cap_sta_t);
+            }
+        }
+        sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
+    }
+
+    em = static_cast<em_t *> (hash_map_get_first(m_em_map));
+    while (em != NULL) {
+        if ((em->is_al_interface_em() == false) &&
+                (memcmp(em_orch_t::get_agent_mac(em), usage->al_mac, sizeof(mac_address_t)) == 0)) {
+            usage->bytes[em_mem_acct_ems] += sizeof(em_t);
+            usage->bytes[em_mem_acct_stacks] += em->get_stack_size();
+        }
+        em = static_cast<em_t *> (hash_map_get_next(m_em_map, em));
+    }
+
+    usage->bytes[em_mem_acct_cmds] = m_orch->get_agent_cmd_count(usage->al_mac) * sizeof(em_cmd_t);
+}
+
+void em_ctrl_t::handle_mem_acct()
+{
+    std::vector<em_mem_acct_usage_t> usage, over;
+    em_mem_acct_usage_t *agent;
+    em_mem_acct_params_t params = m_mem_acct.get_params();
+    unsigned long long excess, freed;
+    dm_easy_mesh_t *dm;
+    dm_sta_t *sta;
+    unsigned int i, num_over;
+    mac_addr_str_t mac_str;
+
+    for (dm = m_data_model.get_first_dm(); dm != NULL; dm = m_data_model.get_next_dm(dm)) {
+        usage.resize(usage.size() + 1);
+        measure_agent_mem(dm, &usage.back());
+    }
+
+    over.resize(usage.size());
+    num_over = m_mem_acct.update(usage.data(), static_cast<unsigned int> (usage.size()), over.data(), static_cast<unsigned int> (over.size()));
+
+    for (i = 0; i < num_over; i++) {
+        agent = &over[i];
+        if ((dm = get_data_model(GLOBAL_NET_ID, agent->al_mac)) == NULL) {
+            continue;
+        }
+        excess = em_mem_acct_t::get_heap_bytes(agent) - params.agent_budget;
+
+        // the caches of its STAs are refilled by the next reports, the scan results by the next scan
+        freed = 0;
+        sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_first());
+        while ((sta != NULL) && (freed < excess)) {
+            if (get_sta_history()->remove(sta->m_sta_info.id) == true) {
+                freed += sizeof(em_metrics_history_row_t);
+            }
+            if (get_beacon_reports()->remove(sta->m_sta_info.id) == true) {
+                freed += sizeof(em_beacon_report_sta_t);
+            }
+            if (get_client_caps()->remove(sta->m_sta_info.id) == true) {
+                freed += sizeof(em_client_cap_sta_t);
+            }
+            sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
+        }
+        if (freed < excess) {
+            lock_scan_results();
+            freed += m_data_model.evict_scan_results(dm, excess - freed);
+            unlock_scan_results();
+        }
+
+        dm_easy_mesh_t::macbytes_to_string(agent->al_mac, mac_str);
+        em_printfout("Agent %s over its memory budget by %llu bytes, evicted %llu bytes\n", mac_str, excess, freed);
+        m_mem_acct.evicted(freed);
+    }
+}
+
+void em_ctrl_t::handle_bh_steer()
+{
+    typedef struct {
+        dm_easy_mesh_t  *dm;
+        em_t            *al_em;
+        em_t            *em;        // a configured radio em of the agent
+    } agent_t;
+    std::vector<agent_t> agents;
+    std::vector<em_bh_steer_node_t> nodes;
+    std::vector<em_bh_steer_bss_t> bss;
+    em_bh_steer_decision_t decisions[EM_BH_STEER_MAX_DECISIONS];
+    em_bh_steer_node_t node;
+    em_bh_steer_bss_t entry;
+    em_metrics_aggregate_t agg;
+    em_device_info_t *dev;
+    em_bss_info_t *bss_info;
+    em_op_class_info_t *op_class;
+    unsigned long long now = em_timer_wheel_t::get_time_ms();
+    unsigned int fresh_ms = get_bh_steer()->get_params().fresh_ms;
+    mac_addr_str_t al_str, target_str;
+    unsigned int i, j, k, num;
+    dm_easy_mesh_t *dm;
+    em_t *em;
+
+    get_bh_steer()->expire(now);
+    if (get_bh_steer()->get_params().enabled == false) {
+        return;
+    }
+
+    pthread_mutex_lock(&m_mutex);
+
+    // the tree is made of the agents and their backhaul BSSs, an agent is gathered once
+    em = static_cast<em_t *> (hash_map_get_first(m_em_map));
+    while (em != NULL) {
+        dm = em->get_data_model();
+        auto it = std::find_if(agents.begin(), agents.end(), [dm](const agent_t& a) { return a.dm == dm; });
+        if (it == agents.end()) {
+            agents.push_back({dm, NULL, NULL});
+            it = agents.end() - 1;
+        }
+        if (em->is_al_interface_em() == true) {
+            it->al_em = em;
+        } else if ((it->em == NULL) && (em->get_state() == em_state_ctrl_configured)) {
+            it->em = em;
+        }
+        em = static_cast<em_t *> (hash_map_get_next(m_em_map, em));
+    }
+
+    for (auto& agent : agents) {
+        dm = agent.dm;
+        dev = dm->get_device_info();
+        memset(&node, 0, sizeof(node));
+        memcpy(node.al_mac, dm->get_agent_al_interface_mac(), sizeof(mac_address_t));
+        memcpy(node.bsta, dev->backhaul_sta, sizeof(mac_address_t));
+        memcpy(node.bssid, dev->backhaul_mac.mac, sizeof(bssid_t));
+        if (get_sta_history()->get_aggregate(node.bsta, fresh_ms, now, &agg) == true) {
+            node.rcpi = agg.ewma.rcpi;
+        }
+        nodes.push_back(node);
+
+        for (i = 0; i < dm->get_num_bss(); i++) {
+            bss_info = dm->get_bss_info(i);
+            if ((bss_info->vap_mode != em_vap_mode_ap) || (bss_info->backhaul_use == false) || (bss_info->enabled == false)) {
+                continue;
+            }
+            for (j = 0; j < dm->get_num_op_class(); j++) {
+                op_class = &dm->get_op_class(j)->m_op_class_info;
+                if ((op_class->id.type == em_op_class_type_current) &&
+                        (memcmp(op_class->id.ruid, bss_info->ruid.mac, sizeof(mac_address_t)) == 0)) {
+                    break;
+                }
+            }
+            if (j == dm->get_num_op_class()) {
+                continue;
+            }
+            memcpy(entry.al_mac, node.al_mac, sizeof(mac_address_t));
+            memcpy(entry.bssid, bss_info->bssid.mac, sizeof(bssid_t));
+            entry.op_class = static_cast<unsigned char> (op_class->op_class);
+            entry.channel = static_cast<unsigned char> (op_class->channel);
+            bss.push_back(entry);
+        }
+    }
+
+    num = get_bh_steer()->evaluate(now, nodes.data(), static_cast<unsigned int> (nodes.size()), bss.data(),
+                                   static_cast<unsigned int> (bss.size()), get_unassoc_stas(), decisions, EM_BH_STEER_MAX_DECISIONS);
+
+    for (i = 0; i < num; i++) {
+        if (decisions[i].action == em_bh_steer_action_measure) {
+            // every other agent measures the backhaul STA on the channels of its backhaul BSSs
+            for (auto& agent : agents) {
+                if ((agent.al_em == NULL) ||
+                        (memcmp(agent.dm->get_agent_al_interface_mac(), decisions[i].al_mac, sizeof(mac_address_t)) == 0)) {
+                    continue;
+                }
+                for (k = 0; k < bss.size(); k++) {
+                    if ((memcmp(bss[k].al_mac, agent.dm->get_agent_al_interface_mac(), sizeof(mac_address_t)) == 0) &&
+                            (agent.al_em->request_unassoc_sta_metrics(decisions[i].bsta, bss[k].op_class, bss[k].channel) > 0)) {
+                        agent.al_em->wake();
+                    }
+                }
+            }
+            continue;
+        }
+
+        for (auto& agent : agents) {
+            if ((agent.em == NULL) ||
+                    (memcmp(agent.dm->get_agent_al_interface_mac(), decisions[i].al_mac, sizeof(mac_address_t)) != 0)) {
+                continue;
+            }
+            // sent from the ticks of the em, the latency runs from here to the response
+            agent.em->request_bh_steer(decisions[i].bsta, decisions[i].target, decisions[i].op_class, decisions[i].channel);
+            agent.em->wake();
+            get_bh_steer()->started(decisions[i].al_mac, now);
+            dm_easy_mesh_t::macbytes_to_string(decisions[i].al_mac, al_str);
+            dm_easy_mesh_t::macbytes_to_string(decisions[i].target, target_str);
+            printf("%s:%d: Backhaul steering %s to %s, rcpi %d -> %d, hops %u -> %u\n", __func__, __LINE__, al_str,
+                target_str, decisions[i].rcpi, decisions[i].target_rcpi, decisions[i].hops, decisions[i].target_hops);
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&m_mutex);
+}
+
 void em_ctrl_t::handle_bsta_cap_req(em_bus_event_t *evt)
 {
     em_cmd_t *pcmd[EM_MAX_CMD] = {NULL};
@@ -427,22 +1127,61 @@ void em_ctrl_t::handle_dirty_dm()
 void em_ctrl_t::handle_5s_tick()
 {
 	//handle_client_metrics_req();
+    get_beacon_reports()->age_out(em_timer_wheel_t::get_time_ms());
+    get_unassoc_stas()->age_out(em_timer_wheel_t::get_time_ms());
+    get_client_caps()->age_out(em_timer_wheel_t::get_time_ms());
+    get_steer_outcomes()->expire(em_timer_wheel_t::get_time_ms());
+    get_policy_push()->expire(em_timer_wheel_t::get_time_ms());
+    lock_scan_results();
+    m_data_model.expire_scan_results(em_timer_wheel_t::get_time_ms());
+    unlock_scan_results();
+    handle_mem_acct();
 }
 
 void em_ctrl_t::handle_2s_tick()
 {
-
+    handle_steer_engine();
+    handle_tid_link_planner();
+    handle_bh_steer();
+    handle_optimiser();
 }
 
 void em_ctrl_t::handle_1s_tick()
 {
+    em_topo_msg_type_t type;
+    std::string msg;
+
+    // each tick queries the agents of one slot, spreading a polling round over EM_STA_LINK_METRICS_POLL_SLOTS ticks
+    m_sta_link_metrics_slot = (m_sta_link_metrics_slot + 1) % EM_STA_LINK_METRICS_POLL_SLOTS;
+    if (m_sta_link_metrics_slot == 0) {
+        m_sta_link_metrics_round++;
+    }
+    handle_client_metrics_req();
+    handle_topology_queries();
 
+    // a standby took over, two controllers must not configure the same agents
+    if (m_ha.is_fenced() == true) {
+        printf("%s:%d: Replaced by the standby, stopping\n", __func__, __LINE__);
+        stop();
+        return;
+    }
+
+    // snapshot for subscribers that joined since the last one
+    if ((type = m_topo_publisher.get_periodic(em_timer_wheel_t::get_time_ms(), msg)) != em_topo_msg_type_none) {
+        publish_topology_msg(msg, type);
+    }
 }
 
 void em_ctrl_t::handle_500ms_tick()
 {
     handle_dirty_dm();
     m_orch->handle_timeout();
+    m_data_model.publish_changes(em_timer_wheel_t::get_time_ms());
+}
+
+void em_ctrl_t::handle_orch_kick()
+{
+    m_orch->handle_timeout();
 }
 
 void em_ctrl_t::input_listener()
@@ -515,6 +1254,18 @@ void em_ctrl_t::handle_bus_event(em_bus_event_t *evt)
             handle_get_dm_data(evt);
             break;
 
+        case em_bus_event_type_get_orch_stats:
+            handle_get_orch_stats(evt);
+            break;
+
+        case em_bus_event_type_get_perf_stats:
+            handle_get_perf_stats(evt);
+            break;
+
+        case em_bus_event_type_get_mem_stats:
+            handle_get_mem_stats(evt);
+            break;
+
         case em_bus_event_type_set_radio:
             handle_set_radio(evt);  
             break;
@@ -584,16 +1335,37 @@ void em_ctrl_t::handle_bus_event(em_bus_event_t *evt)
     }
 }
 
+bool em_ctrl_t::coalesce_event(em_event_t *evt, em_event_t *next)
+{
+    em_commit_info_t *info, *next_info;
+
+    if ((evt->type != em_event_type_bus) || (next->type != em_event_type_bus) ||
+            (evt->u.bevt.type != em_bus_event_type_dm_commit) || (next->u.bevt.type != em_bus_event_type_dm_commit)) {
+        return false;
+    }
+
+    info = &evt->u.bevt.u.commit;
+    next_info = &next->u.bevt.u.commit;
+
+    return ((memcmp(info->mac, next_info->mac, sizeof(mac_address_t)) == 0) &&
+            (strncmp(info->net_id, next_info->net_id, sizeof(info->net_id)) == 0));
+}
+
 void em_ctrl_t::handle_event(em_event_t *evt)
 {
     switch(evt->type) {
-        case em_event_type_bus:
+        case em_event_type_bus: {
+            EM_PROFILE_SCOPE(em_profile_domain_bus, evt->u.bevt.type);
+            // the results sent by the handler go to the client of this event, if any
+            m_ctrl_cmd->begin_event(evt);
             handle_bus_event(&evt->u.bevt);
-            break;
+            m_ctrl_cmd->end_event();
+        } break;
 
-        case em_event_type_nb:
+        case em_event_type_nb: {
+            EM_PROFILE_SCOPE(em_profile_domain_event, evt->type);
             handle_nb_event(&evt->u.nevt);
-            break;
+        } break;
 
         default:
             break;
@@ -601,35 +1373,45 @@ void em_ctrl_t::handle_event(em_event_t *evt)
 
 }
 
+void em_ctrl_t::publish_topology_msg(const std::string& msg, em_topo_msg_type_t type)
+{
+    wifi_bus_desc_t *desc;
+    raw_data_t raw;
+
+    if ((desc = get_bus_descriptor()) == NULL) {
+        printf("%s:%d descriptor is null\n", __func__, __LINE__);
+        return;
+    }
+
+    memset(&raw, 0, sizeof(raw_data_t));
+    raw.data_type    = bus_data_type_string;
+    raw.raw_data.bytes = reinterpret_cast<unsigned char *> (const_cast<char *> (msg.c_str()));
+    raw.raw_data_len = static_cast<unsigned int> (msg.size());
+
+    if (desc->bus_event_publish_fn(m_data_model.get_bus_hdl(), DEVICE_WIFI_DATAELEMENTS_NETWORK_TOPOLOGY, &raw) == 0) {
+        em_printfout("Topology %s %u published, %u bytes", (type == em_topo_msg_type_patch) ? "patch":"snapshot",
+            m_topo_publisher.get_seq(), static_cast<unsigned int> (msg.size()));
+    } else {
+        printf("%s:%d Topology publish fail\n",__func__, __LINE__);
+    }
+}
+
 void em_ctrl_t::publish_network_topology()
 {
     assert(g_network_topology != NULL);
 
-	wifi_bus_desc_t *desc = NULL;
     cJSON *parent = NULL;
-    char *str = NULL;
-    raw_data_t raw;
     dm_easy_mesh_ctrl_t *dm_ctrl = NULL;
-
-    if((desc = get_bus_descriptor()) == NULL) {
-        printf("%s:%d descriptor is null\n", __func__, __LINE__);
-    }
+    em_topo_msg_type_t type;
+    std::string msg;
 
     parent = cJSON_CreateObject();
     dm_ctrl = reinterpret_cast<dm_easy_mesh_ctrl_t *>(get_data_model(GLOBAL_NET_ID));
     dm_ctrl->get_network_config(parent, const_cast<char*>(GLOBAL_NET_ID));
 
-    str = cJSON_Print(parent);
-    em_printfout("    ===============Publish Network Topology Json:\n%s\n===============\n",str);
-
-	raw.data_type    = bus_data_type_string;
-    raw.raw_data.bytes = reinterpret_cast<unsigned char *> (str);
-    raw.raw_data_len = static_cast<unsigned int> (strlen(str));
-
-    if (desc->bus_event_publish_fn(m_data_model.get_bus_hdl(), DEVICE_WIFI_DATAELEMENTS_NETWORK_TOPOLOGY, &raw)== 0) {
-        printf("%s:%d Topology published successfull\n",__func__, __LINE__);
-    } else {
-        printf("%s:%d Topology publish fail\n",__func__, __LINE__);
+    // the publisher keeps the document to diff the next one against
+    if ((type = m_topo_publisher.update(parent, em_timer_wheel_t::get_time_ms(), msg)) != em_topo_msg_type_none) {
+        publish_topology_msg(msg, type);
     }
 }
 
@@ -646,6 +1428,11 @@ int em_ctrl_t::data_model_init(const char *data_model_path)
         return 0;
     }
     
+    // every row written from the start is replicated to the standby
+    if (m_ha.get_role() == em_ha_role_primary) {
+        m_data_model.get_db_client()->set_change_log(m_ha.get_change_log());
+    }
+
     if (m_data_model.init(data_model_path, this) != 0) {
         printf("%s:%d: data model init failed\n", __func__, __LINE__);
         return 0;
@@ -658,12 +1445,18 @@ int em_ctrl_t::data_model_init(const char *data_model_path)
 	}
     dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *> (intf->mac), mac_str);
 
+    if ((m_ha.get_role() == em_ha_role_primary) &&
+            (m_ha.start_primary(m_data_model.get_db_client(), intf->mac, intf->name) != 0)) {
+        printf("%s:%d: Replication to the standby not started\n", __func__, __LINE__);
+    }
+
     if ((dm = get_data_model(GLOBAL_NET_ID, intf->mac)) == NULL) {
         printf("%s:%s:%d: Could not find data model for mac:%s\n", __FILE__, __func__, __LINE__, mac_str);
     } else {
         //printf("%s:%s:%d: Data model found, creating node for mac:%s\n", __FILE__, __func__, __LINE__, mac_str);
             //dm->print_config();
 
+        em_startup_prof_scope_t scope("al_node");
         if ((em = create_node(intf, em_freq_band_unknown, dm, true, em_profile_type_3, em_service_type_ctrl)) == NULL) {
             printf("%s:%d: Could not create and start abstraction layer interface\n", __func__, __LINE__);
         }
@@ -688,12 +1481,8 @@ em_t *em_ctrl_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em_
     em_t *em = NULL;
     mac_address_t ruid;
     bssid_t	bssid;
-    dm_bss_t *bss;
     em_profile_type_t profile;
-    em_2xlong_string_t key;
-    unsigned int i;
-    bool found;
-    mac_addr_str_t mac_str1, mac_str2, dev_mac_str, radio_mac_str;
+    mac_addr_str_t mac_str1, mac_str2;
     em_commit_info_t dm_commit;
 
     assert(len > ((sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))));
@@ -709,27 +1498,39 @@ em_t *em_ctrl_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em_
     
     cmdu = reinterpret_cast<em_cmdu_t *> (data + sizeof(em_raw_hdr_t));
 
+    // index the TLVs once, every lookup below is served from it
+    em_msg_t msg(data + (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)), len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)));
+
     switch (htons(cmdu->type)) {
         case em_msg_type_autoconf_search:
-            if (em_msg_t(data + (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)), len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))).get_freq_band(&band) == false) {
+            if (msg.get_freq_band(&band) == false) {
                 return NULL;
             }
 
-            if (em_msg_t(data + (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)), len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))).get_al_mac_address(intf.mac) == false) {
+            if (msg.get_al_mac_address(intf.mac) == false) {
                 return NULL;
             }
 
             dm_easy_mesh_t::macbytes_to_string(intf.mac, mac_str1);
             em_printfout("[%s] Received autoconfig search from agent al mac: %s\n", __func__, mac_str1);
             if ((dm = get_data_model(GLOBAL_NET_ID, const_cast<const unsigned char *> (intf.mac))) == NULL) {
-                if (em_msg_t(data + (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)), len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))).get_profile(&profile) == false) {
+                // left unanswered, the agent searches again and is admitted once memory is freed
+                if (m_mem_acct.admit(intf.mac) == false) {
+                    em_printfout("[%s] Refusing agent al mac: %s, memory budget reached\n", __func__, mac_str1);
+                    return NULL;
+                }
+                if (msg.get_profile(&profile) == false) {
                     profile = em_profile_type_1;
                 }
                 //dm = create_data_model(GLOBAL_NET_ID, const_cast<const em_interface_t *> (&intf), profile);
+                memset(&dm_commit, 0, sizeof(em_commit_info_t));
                 memcpy(dm_commit.mac, intf.mac, sizeof(mac_addr_t));
                 strncpy(dm_commit.net_id, GLOBAL_NET_ID, sizeof(dm_commit.net_id));
-                io_process(em_bus_event_type_dm_commit, reinterpret_cast<unsigned char *> (&dm_commit), sizeof(em_commit_info_t));
-                em_printfout("[%s] Creating data model for mac: %s net: %s\n", __func__, mac_str1, GLOBAL_NET_ID);
+                // the agent repeats its search until answered, the data model is created once
+                if (claim_dm_commit(&dm_commit) == true) {
+                    io_process(em_bus_event_type_dm_commit, reinterpret_cast<unsigned char *> (&dm_commit), sizeof(em_commit_info_t));
+                    em_printfout("[%s] Creating data model for mac: %s net: %s\n", __func__, mac_str1, GLOBAL_NET_ID);
+                }
             } else {
                 dm_easy_mesh_t::macbytes_to_string(dm->get_agent_al_interface_mac(), mac_str1);
                 em_printfout("[%s] Found existing data model for mac: %s net: %s\n", __func__, mac_str1, GLOBAL_NET_ID);
@@ -738,14 +1539,12 @@ em_t *em_ctrl_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em_
             break;
 
         case em_msg_type_autoconf_wsc:
-            if (em_msg_t(data + (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)),
-                	len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))).get_radio_id(&ruid) == false) {
+            if (msg.get_radio_id(&ruid) == false) {
                 return NULL;
             }
 
-            dm_easy_mesh_t::macbytes_to_string(ruid, mac_str1);
-        
-            if ((em = static_cast<em_t *> (hash_map_get(m_em_map, mac_str1))) != NULL) {
+            if ((em = get_node_by_ruid(ruid)) != NULL) {
+                dm_easy_mesh_t::macbytes_to_string(ruid, mac_str1);
                 printf("%s:%d: Found existing radio:%s\n", __func__, __LINE__, mac_str1);
                 if(em->get_state() != em_state_ctrl_wsc_m2_sent)
                     em->set_state(em_state_ctrl_wsc_m1_pending);
@@ -776,14 +1575,13 @@ em_t *em_ctrl_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em_
         case em_msg_type_channel_pref_rprt:
         case em_msg_type_channel_sel_rsp:
         case em_msg_type_op_channel_rprt:
-            if (em_msg_t(data + (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)),
-                    len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))).get_radio_id(&ruid) == false) {
+            if (msg.get_radio_id(&ruid) == false) {
                 printf("%s:%d: Could not find radio id in msg:0x%04x\n", __func__, __LINE__, htons(cmdu->type));
                 return NULL;
             }
 
-            dm_easy_mesh_t::macbytes_to_string(ruid, mac_str1);
-            if ((em = static_cast<em_t *> (hash_map_get(m_em_map, mac_str1))) == NULL) {
+            if ((em = get_node_by_ruid(ruid)) == NULL) {
+                dm_easy_mesh_t::macbytes_to_string(ruid, mac_str1);
                 printf("%s:%d: Could not find radio:%s\n", __func__, __LINE__, mac_str1);
                 return NULL;
             }
@@ -792,45 +1590,15 @@ em_t *em_ctrl_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em_
         case em_msg_type_topo_notif:
         case em_msg_type_client_cap_rprt:
         case em_msg_type_ap_metrics_rsp:
-           if (em_msg_t(data + (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)),
-                    len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))).get_bss_id(&bssid) == false) {
+           if (msg.get_bss_id(&bssid) == false) {
                 printf("%s:%d: Could not find bss id in msg:0x%04x\n", __func__, __LINE__, htons(cmdu->type));
                 return NULL;
             }
 
-            if ((dm = get_data_model(GLOBAL_NET_ID, const_cast<const unsigned char *> (hdr->src))) == NULL) {
-                printf("%s:%d: Can not find data model\n", __func__, __LINE__);
-            }
-
-            for (i = 0; i < dm->get_num_radios(); i++) {
-                found = true;
-                dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *> (dm->get_radio_info(i)->id.dev_mac), dev_mac_str);
-                dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *> (dm->get_radio_info(i)->id.ruid), radio_mac_str);
+            if ((em = get_node_by_bssid(bssid)) == NULL) {
                 dm_easy_mesh_t::macbytes_to_string(bssid, mac_str1);
-                snprintf(key, sizeof (em_2xlong_string_t), "%s@%s@%s@%s@", dm->get_radio_info(i)->id.net_id, dev_mac_str, radio_mac_str, mac_str1);
-
-                if ((bss = dm->get_bss(dm->get_radio_info(i)->id.ruid, bssid)) == NULL) {
-                    found = false;
-                    continue;
-                }
-                break;
-            }
-
-            if (found == false) {
-                printf("%s:%d: Could not find bss:%s from data model, for radio: %s\n", __func__, __LINE__, mac_str1, radio_mac_str);
-                return NULL;
-            }
-              
-            dm_easy_mesh_t::macbytes_to_string(bss->m_bss_info.ruid.mac, mac_str1);
-            if ((em = static_cast<em_t *> (hash_map_get(m_em_map, mac_str1))) == NULL) {
-                printf("%s:%d: Could not find radio:%s\n", __func__, __LINE__, mac_str1);
+                printf("%s:%d: Could not find radio of bss:%s\n", __func__, __LINE__, mac_str1);
                 return NULL;
-            } else {
-                dm_easy_mesh_t::macbytes_to_string(bssid, mac_str1);
-                mac_addr_str_t mac;
-                dm_easy_mesh_t::macbytes_to_string(em->get_radio_interface_mac(), mac);
-                //printf("%s:%d: Em radio id: %s\n", __func__, __LINE__, mac);
-                //printf("%s:%d: Found em for msg type: %d, key for bss[%s]: %s\n", __func__, __LINE__, htons(cmdu->type), mac_str1, key);
             }
 
             break;
@@ -843,24 +1611,21 @@ em_t *em_ctrl_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em_
         case em_msg_type_client_cap_query:
         case em_msg_type_assoc_sta_link_metrics_query:
         case em_msg_type_beacon_metrics_query:
+        case em_msg_type_unassoc_sta_link_metrics_query:
         case em_msg_type_client_steering_req:
         case em_msg_type_client_assoc_ctrl_req:
         case em_msg_type_map_policy_config_req:
         case em_msg_type_channel_scan_req:
         case em_msg_type_ap_mld_config_req:
+        case em_msg_type_bh_steering_req:
 			break;
 
 		case em_msg_type_channel_scan_rprt:
-            if (em_msg_t(data + (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)),
-                	len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))).get_radio_id(&ruid) == false) {
+            if (msg.get_radio_id(&ruid) == false) {
                 return NULL;
             }
 
-            dm_easy_mesh_t::macbytes_to_string(ruid, mac_str1);
-
-            if ((em = static_cast<em_t *> (hash_map_get(m_em_map, mac_str1))) != NULL) {        
-                //printf("%s:%d: Found existing radio:%s\n", __func__, __LINE__, mac_str1);
-			}
+            em = get_node_by_ruid(ruid);
             break;
 
         case em_msg_type_assoc_sta_link_metrics_rsp:
@@ -913,6 +1678,8 @@ em_t *em_ctrl_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em_
         case em_msg_type_1905_encap_eapol:
         case em_msg_type_bss_config_req:
         case em_msg_type_bss_config_res:
+        case em_msg_type_unassoc_sta_link_metrics_rsp:
+        case em_msg_type_bh_steering_rsp:
 	        em = al_em;
 	        break;
         case em_msg_type_topo_disc:
@@ -923,13 +1690,12 @@ em_t *em_ctrl_t::find_em_for_msg_type(unsigned char *data, unsigned int len, em_
         break;
 
         case em_msg_type_bh_sta_cap_rprt:
-            if (em_msg_t(data + (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)),
-                len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))).get_radio_id(&ruid) == false) {
+            if (msg.get_radio_id(&ruid) == false) {
                 return NULL;
             }
 
-            dm_easy_mesh_t::macbytes_to_string(ruid, mac_str1);
-            if ((em = static_cast<em_t *> (hash_map_get(m_em_map, mac_str1))) != NULL) {
+            if ((em = get_node_by_ruid(ruid)) != NULL) {
+                dm_easy_mesh_t::macbytes_to_string(ruid, mac_str1);
                 em_printfout("Received bsta report, found em:%s", mac_str1);
             }
             break;
@@ -989,16 +1755,21 @@ void em_ctrl_t::start_complete()
 	// build initial network topology
 	init_network_topology();
 
-    dm = m_data_model.get_first_dm();
-    while (dm != NULL) {
-		dm->set_db_cfg_param(db_cfg_type_scan_result_list_delete, "");
-		dm->set_db_cfg_param(db_cfg_type_sta_list_delete, "");
-		dm->set_db_cfg_param(db_cfg_type_op_class_list_delete, "");
-		dm->set_db_cfg_param(db_cfg_type_bss_list_delete, "");
-        dm = m_data_model.get_next_dm(dm);
-    }
-	memcpy(&ac_config_raw.radio, &null_mac, sizeof(mac_address_t));
-	io_process(em_bus_event_type_cfg_renew, reinterpret_cast<unsigned char *> (&ac_config_raw), sizeof(em_bus_event_type_cfg_renew_params_t));
+	// after a takeover the replicated data model is current, the agents are not renewed
+	if (m_ha.has_taken_over() == true) {
+		resume_nodes();
+	} else {
+		dm = m_data_model.get_first_dm();
+		while (dm != NULL) {
+			dm->set_db_cfg_param(db_cfg_type_scan_result_list_delete, "");
+			dm->set_db_cfg_param(db_cfg_type_sta_list_delete, "");
+			dm->set_db_cfg_param(db_cfg_type_op_class_list_delete, "");
+			dm->set_db_cfg_param(db_cfg_type_bss_list_delete, "");
+			dm = m_data_model.get_next_dm(dm);
+		}
+		memcpy(&ac_config_raw.radio, &null_mac, sizeof(mac_address_t));
+		io_process(em_bus_event_type_cfg_renew, reinterpret_cast<unsigned char *> (&ac_config_raw), sizeof(em_bus_event_type_cfg_renew_params_t));
+	}
 	//Initialze cli devtest
 	for (i = 0; i < em_dev_test_type_max; i++) {
 		dev_test.dev_test_info.num_iteration[i] = 50;
@@ -1012,6 +1783,35 @@ void em_ctrl_t::start_complete()
 	}
 }
 
+void em_ctrl_t::resume_nodes()
+{
+    dm_easy_mesh_t *dm;
+    dm_radio_t *radio;
+    em_interface_t intf;
+    em_t *em;
+    mac_address_t null_mac = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    unsigned int i, num = 0;
+
+    dm = m_data_model.get_first_dm();
+    while (dm != NULL) {
+        for (i = 0; i < dm->get_num_radios(); i++) {
+            if (((radio = dm->get_radio(i)) == NULL) ||
+                    (memcmp(radio->m_radio_info.intf.mac, null_mac, sizeof(mac_address_t)) == 0)) {
+                continue;
+            }
+            memset(&intf, 0, sizeof(em_interface_t));
+            memcpy(intf.mac, radio->m_radio_info.intf.mac, sizeof(mac_address_t));
+            if ((em = create_node(&intf, radio->m_radio_info.band, dm, false, dm->get_device()->m_device_info.profile,
+                    em_service_type_ctrl)) != NULL) {
+                em->set_state(em_state_ctrl_configured);
+                num++;
+            }
+        }
+        dm = m_data_model.get_next_dm(dm);
+    }
+    printf("%s:%d: Took over %d radios from the primary\n", __func__, __LINE__, num);
+}
+
 em_ctrl_t *em_ctrl_t::get_em_ctrl_instance()
 {
     if (s_em_ctrl == nullptr) {
@@ -1022,10 +1822,16 @@ em_ctrl_t *em_ctrl_t::get_em_ctrl_instance()
 
 em_ctrl_t::em_ctrl_t()
 {
+    m_sta_link_metrics_slot = 0;
+    m_sta_link_metrics_round = 0;
+    pthread_mutex_init(&m_commit_lock, NULL);
+    get_optimiser()->add(&m_chan_plan_optimiser);
 }
 
 em_ctrl_t::~em_ctrl_t()
 {
+    get_optimiser()->remove(&m_chan_plan_optimiser);
+    pthread_mutex_destroy(&m_commit_lock);
 }
 
 #ifdef AL_SAP
@@ -1059,13 +1865,53 @@ AlServiceAccessPoint* em_ctrl_t::al_sap_register(const std::string& data_socket_
 int main(int argc, const char *argv[])
 {
     em_ctrl_t  *em_ctrl = em_ctrl_t::get_em_ctrl_instance();
+    const char *data_model_path = NULL;
+
+    // [data-model-path] [--capture=file.pcapng] [--stack-size=role=KB,...]
+    // [--ha=primary:listen-address:port | --ha=standby:primary-address:port[:al-interface]] [--rx-shards=num]
+    // [--sched=role:option[:option...],...]
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--capture=", strlen("--capture=")) == 0) {
+            if (em_capture_t::start(argv[i] + strlen("--capture=")) != 0) {
+                return -1;
+            }
+        } else if (strncmp(argv[i], "--stack-size=", strlen("--stack-size=")) == 0) {
+            if (em_stack_t::configure(argv[i] + strlen("--stack-size=")) != 0) {
+                printf("Invalid stack sizes: %s\n", argv[i]);
+                return -1;
+            }
+        } else if (strncmp(argv[i], "--sched=", strlen("--sched=")) == 0) {
+            if (em_sched_t::configure(argv[i] + strlen("--sched=")) != 0) {
+                printf("Invalid thread scheduling: %s\n", argv[i]);
+                return -1;
+            }
+        } else if (strncmp(argv[i], "--ha=", strlen("--ha=")) == 0) {
+            if (em_ctrl->get_ha()->configure(argv[i] + strlen("--ha=")) != 0) {
+                printf("Invalid high availability role: %s\n", argv[i]);
+                return -1;
+            }
+        } else if (strncmp(argv[i], "--rx-shards=", strlen("--rx-shards=")) == 0) {
+            // the agents are partitioned by AL MAC over this many receive threads
+            em_ctrl->set_rx_shards(static_cast<unsigned int>(atoi(argv[i] + strlen("--rx-shards="))));
+        } else if (data_model_path == NULL) {
+            data_model_path = argv[i];
+        }
+    }
+
+    em_trace_t::install_crash_handler("/tmp/emCtrl.trace");
 #ifdef AL_SAP
     g_sap = em_ctrl->al_sap_register("/tmp/al_em_ctrl_data_socket", "/tmp/al_em_ctrl_control_socket");
 #endif
 
-    if (em_ctrl->init(argv[1]) == 0) {
+    // the standby replicates the primary and starts the controller once it took over
+    if ((em_ctrl->get_ha()->get_role() == em_ha_role_standby) && (em_ctrl->get_ha()->run_standby(data_model_path) != 0)) {
+        return -1;
+    }
+
+    if (em_ctrl->init(data_model_path) == 0) {
         em_ctrl->start();
     }
+    em_capture_t::stop();
 
     return 0;
 }
@@ -27,111 +27,146 @@
 #include "em_cmd_ctrl.h"
 #include "util.h"
 
-void em_dev_test_t::encode(em_subdoc_info_t *subdoc, hash_map_t *m_em_map, bool update, bool testinprogress)
+void em_dev_test_t::encode_em(dm_json_writer_t& writer, em_t *em, bool testinprogress)
 {
-	cJSON *parent, *em_jlist, *em_data, *dev_test, *dev_test_param;
-	char *tmp;
-	em_t *em = NULL;
-	int i = 0;
+	mac_addr_str_t mac_str;
 	em_small_string_t enable;
-	em_short_string_t haul_type_str;
 
-	parent = cJSON_CreateObject();
-	if (!update){
+	writer.begin_array("em");
+	dm_easy_mesh_t::macbytes_to_string(em->get_radio_interface_mac(), mac_str);
+	writer.add_string("mac_str", mac_str);
+	writer.add_string("state", em_t::state_2_str(em->get_state()));
+	snprintf(enable, sizeof(enable),"%s:%d","Test_Enabled", em->get_devteststatus());
+	writer.add_string("Debug/Test_Enabled", enable);
 
-		em_jlist = cJSON_AddObjectToObject(parent, "em_list");
-		em = static_cast<em_t *> (hash_map_get_first(m_em_map));
-		while(em != NULL) {
-			mac_addr_str_t mac_str;
-			if (em->is_al_interface_em() == false) {
-				em_data = cJSON_AddArrayToObject(em_jlist, "em");
-				dm_easy_mesh_t::macbytes_to_string(em->get_radio_interface_mac(), mac_str);
-				cJSON_AddStringToObject(em_data, "mac_str", mac_str);
-				cJSON_AddStringToObject(em_data, "state", em_t::state_2_str(em->get_state()));
-				snprintf(enable, sizeof(enable),"%s:%d","Test_Enabled", em->get_devteststatus());
-				cJSON_AddStringToObject(em_data, "Debug/Test_Enabled", enable);
-			
-				if ((em->get_state() == em_state_ctrl_misconfigured) && (em->get_devteststatus() == false)) {
-					cJSON_AddStringToObject(em_data, "Debug/Test_Enabled", "Down");
-				} else if ((em->get_state() >= em_state_ctrl_configured) && (em->get_state() != em_state_ctrl_misconfigured) && (testinprogress == false)) {
-					cJSON_AddStringToObject(em_data, "Debug/Test_Enabled", "Online");
-				} else if ((em->get_state() == em_state_ctrl_misconfigured) && (em->get_devteststatus() == true) && (testinprogress == false)
-						  && (em->get_renew_tx_count() == 0)) {
-					cJSON_AddStringToObject(em_data, "Debug/Test_Enabled", "Config-failed");
-				} else {
-					cJSON_AddStringToObject(em_data, "Debug/Test_Enabled", "Offline");
-				}
+	if ((em->get_state() == em_state_ctrl_misconfigured) && (em->get_devteststatus() == false)) {
+		writer.add_string("Debug/Test_Enabled", "Down");
+	} else if ((em->get_state() >= em_state_ctrl_configured) && (em->get_state() != em_state_ctrl_misconfigured) && (testinprogress == false)) {
+		writer.add_string("Debug/Test_Enabled", "Online");
+	} else if ((em->get_state() == em_state_ctrl_misconfigured) && (em->get_devteststatus() == true) && (testinprogress == false)
+			  && (em->get_renew_tx_count() == 0)) {
+		writer.add_string("Debug/Test_Enabled", "Config-failed");
+	} else {
+		writer.add_string("Debug/Test_Enabled", "Offline");
+	}
+	writer.end_array();
+}
+
+void em_dev_test_t::encode_test(dm_json_writer_t& writer, int i, bool update)
+{
+	em_short_string_t haul_type_str = "";
+
+	writer.begin_object();
+	if (dev_test_info.test_type[i] == em_dev_test_type_ssid) {
+		writer.add_string("Test_type", "ssid_change");
+		if(!update) {
 
+			switch (dev_test_info.haul_type) {
+				case em_haul_type_fronthaul:
+					strncpy(haul_type_str, "[Fronthaul]", strlen("[Fronthaul]") + 1);
+					break;
+				case em_haul_type_backhaul:
+					strncpy(haul_type_str, "[Backhaul]", strlen("[Backhaul]") + 1);
+					break;
+				case em_haul_type_iot:
+					strncpy(haul_type_str, "[IoT]", strlen("[IoT]") + 1);
+					break;
+				case em_haul_type_configurator:
+					strncpy(haul_type_str, "[Configurator]", strlen("[Configurator]") + 1);
+					break;
+				case em_haul_type_hotspot:
+					strncpy(haul_type_str, "[Hotspot]", strlen("[Hotspot]") + 1);
+					break;
+				default:
+				   break;
 			}
-			em = static_cast<em_t *> (hash_map_get_next(m_em_map, em));
+			writer.add_string("HaulType", haul_type_str);
+
+		} else {
+			writer.add_number("Haul_type:[Fronthault:0,Backhaul:1,IOT:2,Configurator:3,Hotspot:4]", dev_test_info.haul_type);
+		}
+	} else if(dev_test_info.test_type[i] == em_dev_test_type_channel) {
+		writer.add_string("Test_type", "channel_change");
+
+		if (dev_test_info.freq_band == em_freq_band_24) {
+			writer.add_string("Freq_band", "2.4");
+		} else {
+			writer.add_string("Freq_band", "5");
+		}
+
+	}
+	writer.add_number("No_of_iteration", dev_test_info.num_iteration[i]);
+	writer.add_number("Test_enabled", dev_test_info.enabled[i]);
+
+	if(!update) {
+		writer.add_number("Num_of_iteration_completed", dev_test_info.num_of_iteration_completed[i]);
+		writer.add_number("Current_iteration_inprogress", dev_test_info.test_inprogress[i]);
+		if (dev_test_info.test_status[i] == em_dev_test_status_inprogess) {
+			writer.add_string("Test_status", "In-Progress");
+		} else if (dev_test_info.test_status[i] == em_dev_test_status_complete){
+			writer.add_string("Test_status", "Complete");
+		} else if (dev_test_info.test_status[i] == em_dev_test_status_failed){
+			writer.add_string("Test_status", "Failed");
+		} else	{
+			writer.add_string("Test_status", "Idle");
 		}
 	}
+	writer.add_number("Configure_active_em", 0);
+	writer.end_object();
+}
+
+void em_dev_test_t::encode(em_subdoc_info_t *subdoc, hash_map_t *m_em_map, bool update, bool testinprogress, unsigned int start)
+{
+	dm_json_writer_t writer, tests, row;
+	em_t *em = NULL;
+	unsigned int idx = 0;
+	size_t max_len;
+	int i = 0;
 
-	dev_test = cJSON_AddArrayToObject(parent, "dev_test");
+	// the tests are few and small, they go in whole and the em list gets what is left
+	tests.begin_array();
 	for (i = 0; i < em_dev_test_type_max; i++) {
-		dev_test_param = cJSON_CreateObject();
-		cJSON_AddItemToArray(dev_test, dev_test_param);
-		if (dev_test_info.test_type[i] == em_dev_test_type_ssid) {
-			cJSON_AddStringToObject(dev_test_param, "Test_type", "ssid_change");
-			if(!update) {
+		encode_test(tests, i, update);
+	}
+	tests.end_array();
+	max_len = EM_MAX_EVENT_DATA_LEN - sizeof(em_subdoc_name_space_t) - DEV_TEST_ENCODE_RESERVE;
 
-				switch (dev_test_info.haul_type) {
-					case em_haul_type_fronthaul:
-						strncpy(haul_type_str, "[Fronthaul]", strlen("[Fronthaul]") + 1);
-						break;
-					case em_haul_type_backhaul:
-						strncpy(haul_type_str, "[Backhaul]", strlen("[Backhaul]") + 1);
-						break;
-					case em_haul_type_iot:
-						strncpy(haul_type_str, "[IoT]", strlen("[IoT]") + 1);
-						break;
-					case em_haul_type_configurator:
-						strncpy(haul_type_str, "[Configurator]", strlen("[Configurator]") + 1);
-						break;
-					case em_haul_type_hotspot:
-						strncpy(haul_type_str, "[Hotspot]", strlen("[Hotspot]") + 1);
+	writer.begin_object();
+	if (!update){
+
+		writer.begin_object("em_list");
+		em = static_cast<em_t *> (hash_map_get_first(m_em_map));
+		while(em != NULL) {
+			if (em->is_al_interface_em() == false) {
+				if (idx >= start) {
+					// an entry at a time, the one that does not fit starts the next page
+					row.reset();
+					encode_em(row, em, testinprogress);
+					if (writer.get_len() + row.get_len() + tests.get_len() > max_len) {
 						break;
-					default:
-					   break;
+					}
+					writer.add_raw("em", row.get_str());
 				}
-				cJSON_AddStringToObject(dev_test_param, "HaulType", haul_type_str);
-
-			} else {
-				cJSON_AddNumberToObject(dev_test_param, "Haul_type:[Fronthault:0,Backhaul:1,IOT:2,Configurator:3,Hotspot:4]", dev_test_info.haul_type);
-			}
-		} else if(dev_test_info.test_type[i] == em_dev_test_type_channel) {
-			cJSON_AddStringToObject(dev_test_param, "Test_type", "channel_change");
-
-			if (dev_test_info.freq_band == em_freq_band_24) {
-				cJSON_AddStringToObject(dev_test_param, "Freq_band", "2.4");
-			} else {
-				cJSON_AddStringToObject(dev_test_param, "Freq_band", "5");
+				idx++;
 			}
-
+			em = static_cast<em_t *> (hash_map_get_next(m_em_map, em));
 		}
-		cJSON_AddNumberToObject(dev_test_param, "No_of_iteration", dev_test_info.num_iteration[i]);
-		cJSON_AddNumberToObject(dev_test_param, "Test_enabled", dev_test_info.enabled[i]);
-
-		if(!update) {
-			cJSON_AddNumberToObject(dev_test_param, "Num_of_iteration_completed", dev_test_info.num_of_iteration_completed[i]);
-			cJSON_AddNumberToObject(dev_test_param, "Current_iteration_inprogress", dev_test_info.test_inprogress[i]);
-			if (dev_test_info.test_status[i] == em_dev_test_status_inprogess) {
-				cJSON_AddStringToObject(dev_test_param, "Test_status", "In-Progress");
-			} else if (dev_test_info.test_status[i] == em_dev_test_status_complete){
-				cJSON_AddStringToObject(dev_test_param, "Test_status", "Complete");
-			} else if (dev_test_info.test_status[i] == em_dev_test_status_failed){
-				cJSON_AddStringToObject(dev_test_param, "Test_status", "Failed");
-			} else	{
-				cJSON_AddStringToObject(dev_test_param, "Test_status", "Idle");
-			}
+		writer.end_object();
+		if (em != NULL) {
+			writer.add_number("em_list_next", idx);
 		}
-		cJSON_AddNumberToObject(dev_test_param, "Configure_active_em", 0);
 	}
 
-	tmp = cJSON_Print(parent);
-	//printf("%s:%d: Subdoc: %s\n", __func__, __LINE__, tmp);
-	strncpy(subdoc->buff, tmp, strlen(tmp) + 1);
-	cJSON_free(parent);
+	writer.add_raw("dev_test", tests.get_str());
+	writer.end_object();
+
+	if ((writer.has_error() == true) || (tests.has_error() == true)) {
+		printf("%s:%d: Failed to encode the dev test subdoc\n", __func__, __LINE__);
+		snprintf(subdoc->buff, EM_MAX_EVENT_DATA_LEN - sizeof(em_subdoc_name_space_t), "{}");
+		return;
+	}
+	//printf("%s:%d: Subdoc: %s\n", __func__, __LINE__, writer.get_str());
+	snprintf(subdoc->buff, EM_MAX_EVENT_DATA_LEN - sizeof(em_subdoc_name_space_t), "%s", writer.get_str());
 }
 
 void em_dev_test_t:: decode(em_subdoc_info_t *subdoc, hash_map_t *m_em_map, const char *str)
@@ -0,0 +1,779 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <netdb.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/time.h>
+#include <algorithm>
+#include <openssl/err.h>
+#include "em_ha.h"
+#include "em_timer_wheel.h"
+
+static void put_u64(std::string& out, unsigned long long val)
+{
+    int i;
+
+    for (i = 7; i >= 0; i--) {
+        out += static_cast<char>((val >> (i * 8)) & 0xff);
+    }
+}
+
+static unsigned long long get_u64(const std::string& buf, size_t off)
+{
+    unsigned long long val = 0;
+    size_t i;
+
+    for (i = 0; i < 8; i++) {
+        val = (val << 8) | static_cast<unsigned char>(buf[off + i]);
+    }
+
+    return val;
+}
+
+int em_ha_t::init_tls()
+{
+    if (m_ssl_ctx != NULL) {
+        return 0;
+    }
+    if ((m_ssl_ctx = SSL_CTX_new(TLS_method())) == NULL) {
+        return -1;
+    }
+    SSL_CTX_set_min_proto_version(m_ssl_ctx, TLS1_2_VERSION);
+    signal(SIGPIPE, SIG_IGN);
+
+    // both ends present the controller certificate and accept only a peer the same anchor issued
+    if ((SSL_CTX_use_certificate_file(m_ssl_ctx, EM_HA_CERT_FILE, SSL_FILETYPE_PEM) <= 0) ||
+            (SSL_CTX_use_PrivateKey_file(m_ssl_ctx, EM_HA_KEY_FILE, SSL_FILETYPE_PEM) <= 0) ||
+            (SSL_CTX_check_private_key(m_ssl_ctx) != 1) ||
+            (SSL_CTX_load_verify_locations(m_ssl_ctx, EM_HA_CA_FILE, NULL) != 1)) {
+        printf("%s:%d: Certificate, key or trust anchor of the replication link not loaded\n", __func__, __LINE__);
+        ERR_print_errors_fp(stderr);
+        SSL_CTX_free(m_ssl_ctx);
+        m_ssl_ctx = NULL;
+        return -1;
+    }
+    SSL_CTX_set_verify(m_ssl_ctx, SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT, NULL);
+
+    return 0;
+}
+
+static void set_timeouts(int fd)
+{
+    struct timeval tv;
+    int one = 1;
+
+    // bounds the handshake and a write to a peer that stopped reading
+    tv.tv_sec = EM_HA_TAKEOVER_MS / 1000;
+    tv.tv_usec = (EM_HA_TAKEOVER_MS % 1000) * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+SSL *em_ha_t::connect_peer(int *fd)
+{
+    struct addrinfo hints, *res, *ai;
+    struct pollfd pfd;
+    std::string port = std::to_string(m_port);
+    socklen_t len;
+    SSL *ssl;
+    int err;
+
+    *fd = -1;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(m_host.c_str(), port.c_str(), &hints, &res) != 0) {
+        return NULL;
+    }
+    for (ai = res; (ai != NULL) && (*fd < 0); ai = ai->ai_next) {
+        if ((*fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC | SOCK_NONBLOCK, ai->ai_protocol)) < 0) {
+            continue;
+        }
+        // a primary that is gone must not hold the takeover for the timeout of the kernel
+        err = 0;
+        if (connect(*fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+            err = errno;
+            if (err == EINPROGRESS) {
+                pfd.fd = *fd;
+                pfd.events = POLLOUT;
+                pfd.revents = 0;
+                len = sizeof(err);
+                if ((poll(&pfd, 1, EM_HA_TAKEOVER_MS) != 1) || (getsockopt(*fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0)) {
+                    err = ETIMEDOUT;
+                }
+            }
+        }
+        if (err != 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+    freeaddrinfo(res);
+    if (*fd < 0) {
+        return NULL;
+    }
+    fcntl(*fd, F_SETFL, fcntl(*fd, F_GETFL) & ~O_NONBLOCK);
+    set_timeouts(*fd);
+
+    if (((ssl = SSL_new(m_ssl_ctx)) == NULL) || (SSL_set_fd(ssl, *fd) != 1) || (SSL_connect(ssl) != 1)) {
+        printf("%s:%d: TLS handshake with %s:%d failed\n", __func__, __LINE__, m_host.c_str(), m_port);
+        close_peer(ssl, *fd);
+        *fd = -1;
+        return NULL;
+    }
+
+    return ssl;
+}
+
+void em_ha_t::close_peer(SSL *ssl, int fd)
+{
+    if (ssl != NULL) {
+        SSL_shutdown(ssl);
+        SSL_free(ssl);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+int em_ha_t::send_frame(SSL *ssl, em_ha_frame_type_t type, const std::string& payload)
+{
+    std::string frame;
+    size_t len = payload.size(), sent = 0;
+    int rc;
+
+    frame.reserve(5 + len);
+    frame += static_cast<char>(type);
+    frame += static_cast<char>(len >> 24);
+    frame += static_cast<char>(len >> 16);
+    frame += static_cast<char>(len >> 8);
+    frame += static_cast<char>(len);
+    frame += payload;
+
+    while (sent < frame.size()) {
+        if ((rc = SSL_write(ssl, frame.data() + sent, static_cast<int>(frame.size() - sent))) <= 0) {
+            return -1;
+        }
+        sent += static_cast<size_t>(rc);
+    }
+
+    return 0;
+}
+
+int em_ha_t::recv_frame(SSL *ssl, unsigned char *type, std::string& payload, int timeout_ms)
+{
+    unsigned char hdr[5];
+    struct pollfd pfd;
+    size_t len = 0, got = 0;
+    int rc;
+    char *dst;
+
+    // the header, then the payload once its length is known
+    while (got < sizeof(hdr) + len) {
+        // a record TLS already decrypted is not seen by poll
+        if (SSL_pending(ssl) == 0) {
+            pfd.fd = SSL_get_fd(ssl);
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            if ((rc = poll(&pfd, 1, timeout_ms)) <= 0) {
+                if ((rc < 0) && (errno == EINTR)) {
+                    continue;
+                }
+                return -1;
+            }
+        }
+        if (got < sizeof(hdr)) {
+            dst = reinterpret_cast<char *>(hdr) + got;
+            rc = SSL_read(ssl, dst, static_cast<int>(sizeof(hdr) - got));
+        } else {
+            dst = &payload[got - sizeof(hdr)];
+            rc = SSL_read(ssl, dst, static_cast<int>(sizeof(hdr) + len - got));
+        }
+        if (rc <= 0) {
+            return -1;
+        }
+        got += static_cast<size_t>(rc);
+
+        if (got == sizeof(hdr)) {
+            len = (static_cast<size_t>(hdr[1]) << 24) | (static_cast<size_t>(hdr[2]) << 16) |
+                    (static_cast<size_t>(hdr[3]) << 8) | hdr[4];
+            if (len > EM_HA_MAX_FRAME) {
+                printf("%s:%d: Frame of %zu bytes too long\n", __func__, __LINE__, len);
+                return -1;
+            }
+            payload.resize(len);
+        }
+    }
+    *type = hdr[0];
+
+    return 0;
+}
+
+void em_ha_t::count(unsigned long long connects, unsigned long long snapshots, unsigned long long records,
+        unsigned long long bytes)
+{
+    pthread_mutex_lock(&m_lock);
+    m_stats.connects += connects;
+    m_stats.snapshots += snapshots;
+    m_stats.records += records;
+    m_stats.bytes += bytes;
+    pthread_mutex_unlock(&m_lock);
+}
+
+int em_ha_t::send_snapshot(SSL *ssl, unsigned long long *seq)
+{
+    std::string payload, image;
+    int rc;
+
+    // records appended while the snapshot is read may be in it as well, the standby writes their tables again
+    *seq = m_log.get_last_seq();
+    if (m_client->save_snapshot(image) != 0) {
+        printf("%s:%d: Snapshot of the database failed\n", __func__, __LINE__);
+        return -1;
+    }
+    put_u64(payload, *seq);
+    payload += image;
+
+    if ((rc = send_frame(ssl, em_ha_frame_snapshot, payload)) == 0) {
+        count(0, 1, 0, payload.size());
+        printf("%s:%d: Snapshot of %zu bytes sent, current to record %llu\n", __func__, __LINE__, payload.size(), *seq);
+    }
+
+    return rc;
+}
+
+int em_ha_t::send_tables(SSL *ssl, unsigned long long first, unsigned long long last, const std::string& recs)
+{
+    const unsigned char *buf = reinterpret_cast<const unsigned char *>(recs.data());
+    std::vector<std::string> tables;
+    std::string payload, image;
+    db_change_rec_t rec;
+    size_t off = 0;
+    int len, num = 0;
+
+    // the statements stay on the primary, only the names of the tables they changed are taken
+    while (off < recs.size()) {
+        if ((len = db_change_log_t::decode(buf + off, recs.size() - off, &rec)) <= 0) {
+            printf("%s:%d: Corrupt record after %llu\n", __func__, __LINE__, first + static_cast<unsigned long long>(num));
+            return -1;
+        }
+        if (std::find(tables.begin(), tables.end(), rec.table) == tables.end()) {
+            tables.push_back(rec.table);
+        }
+        off += static_cast<size_t>(len);
+        num++;
+    }
+
+    if (m_client->save_snapshot(image, &tables) != 0) {
+        printf("%s:%d: Snapshot of %zu tables failed\n", __func__, __LINE__, tables.size());
+        return -1;
+    }
+    put_u64(payload, first);
+    put_u64(payload, last);
+    payload += image;
+    if (send_frame(ssl, em_ha_frame_tables, payload) != 0) {
+        return -1;
+    }
+    count(0, 0, static_cast<unsigned long long>(num), payload.size());
+
+    return num;
+}
+
+void em_ha_t::serve(SSL *ssl)
+{
+    std::string payload;
+    unsigned long long from, next;
+    unsigned char type;
+    int num;
+
+    if ((recv_frame(ssl, &type, payload, EM_HA_TAKEOVER_MS) != 0) || (type != em_ha_frame_hello) || (payload.size() < 24)) {
+        printf("%s:%d: No hello from the standby\n", __func__, __LINE__);
+        return;
+    }
+    // a controller that took over from this one tells of its epoch
+    if (get_u64(payload, 16) > m_epoch) {
+        printf("%s:%d: Controller of epoch %llu took over from epoch %llu, fenced\n", __func__, __LINE__,
+                get_u64(payload, 16), m_epoch);
+        m_fenced = true;
+        m_exit = true;
+        return;
+    }
+    // a standby that replicated another log starts over
+    from = (get_u64(payload, 0) == m_log.get_id()) ? get_u64(payload, 8) + 1:0;
+
+    payload.clear();
+    put_u64(payload, m_log.get_id());
+    put_u64(payload, m_epoch);
+    payload.append(reinterpret_cast<const char *>(m_al_mac), sizeof(mac_address_t));
+    payload += m_al_ifname;
+    if (send_frame(ssl, em_ha_frame_info, payload) != 0) {
+        return;
+    }
+
+    while (m_exit == false) {
+        payload.clear();
+        num = (from == 0) ? -1:m_log.read(from, EM_HA_MAX_BATCH, payload, &next);
+        if (num < 0) {
+            if (send_snapshot(ssl, &from) != 0) {
+                return;
+            }
+            from++;
+            continue;
+        }
+
+        if (num > 0) {
+            if (send_tables(ssl, from, next - 1, payload) < 0) {
+                return;
+            }
+            from = next;
+        } else if (m_log.wait(from, EM_HA_HEARTBEAT_MS) == false) {
+            put_u64(payload, from - 1);
+            if (send_frame(ssl, em_ha_frame_heartbeat, payload) != 0) {
+                return;
+            }
+        }
+    }
+}
+
+void em_ha_t::probe_replaced()
+{
+    std::string payload;
+    SSL *ssl;
+    int fd;
+
+    if ((ssl = connect_peer(&fd)) == NULL) {
+        return;
+    }
+    put_u64(payload, 0);
+    put_u64(payload, 0);
+    put_u64(payload, m_epoch);
+    if (send_frame(ssl, em_ha_frame_hello, payload) == 0) {
+        printf("%s:%d: Primary replaced at %s:%d told of epoch %llu\n", __func__, __LINE__, m_host.c_str(), m_port, m_epoch);
+    }
+    close_peer(ssl, fd);
+}
+
+void *em_ha_t::primary_run(void *arg)
+{
+    em_ha_t *ha = static_cast<em_ha_t *>(arg);
+    struct sockaddr_storage addr;
+    struct pollfd pfd;
+    socklen_t addr_len;
+    SSL *ssl;
+    int fd, rc;
+
+    while (ha->m_exit == false) {
+        pfd.fd = ha->m_listen_fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if ((rc = poll(&pfd, 1, EM_HA_FENCE_PROBE_MS)) == 0) {
+            // the primary this controller replaced may be alive, it has to stop
+            if (ha->m_took_over == true) {
+                ha->probe_replaced();
+            }
+            continue;
+        }
+
+        addr_len = sizeof(addr);
+        if ((rc < 0) || ((fd = accept4(ha->m_listen_fd, reinterpret_cast<struct sockaddr *>(&addr), &addr_len, SOCK_CLOEXEC)) < 0)) {
+            if ((errno != EINTR) && (ha->m_exit == false)) {
+                usleep(EM_HA_RETRY_MS * 1000);
+            }
+            continue;
+        }
+        set_timeouts(fd);
+
+        pthread_mutex_lock(&ha->m_lock);
+        ha->m_conn_fd = fd;
+        pthread_mutex_unlock(&ha->m_lock);
+
+        if (((ssl = SSL_new(ha->m_ssl_ctx)) != NULL) && (SSL_set_fd(ssl, fd) == 1) && (SSL_accept(ssl) == 1)) {
+            ha->count(1, 0, 0, 0);
+            printf("%s:%d: Standby connected\n", __func__, __LINE__);
+            ha->serve(ssl);
+            printf("%s:%d: Standby disconnected\n", __func__, __LINE__);
+        } else {
+            printf("%s:%d: TLS handshake with a standby failed\n", __func__, __LINE__);
+        }
+
+        pthread_mutex_lock(&ha->m_lock);
+        ha->m_conn_fd = -1;
+        pthread_mutex_unlock(&ha->m_lock);
+        close_peer(ssl, fd);
+    }
+
+    return NULL;
+}
+
+int em_ha_t::start_primary(db_client_t *client, const unsigned char *al_mac, const char *al_ifname)
+{
+    struct addrinfo hints, *res;
+    std::string port;
+    int one = 1;
+
+    if ((m_role != em_ha_role_primary) || (m_running == true) || (init_tls() != 0)) {
+        return -1;
+    }
+    m_client = client;
+    memcpy(m_al_mac, al_mac, sizeof(mac_address_t));
+    m_al_ifname = al_ifname;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE | AI_NUMERICHOST;
+    port = std::to_string(m_port);
+    if (getaddrinfo(m_bind.c_str(), port.c_str(), &hints, &res) != 0) {
+        printf("%s:%d: Listen address %s not valid\n", __func__, __LINE__, m_bind.c_str());
+        return -1;
+    }
+    if ((m_listen_fd = socket(res->ai_family, res->ai_socktype | SOCK_CLOEXEC, res->ai_protocol)) < 0) {
+        printf("%s:%d: Socket failed, err:%d\n", __func__, __LINE__, errno);
+        freeaddrinfo(res);
+        return -1;
+    }
+    setsockopt(m_listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    if ((bind(m_listen_fd, res->ai_addr, res->ai_addrlen) != 0) || (listen(m_listen_fd, 1) != 0)) {
+        printf("%s:%d: Can not listen on %s:%d, err:%d\n", __func__, __LINE__, m_bind.c_str(), m_port, errno);
+        freeaddrinfo(res);
+        close(m_listen_fd);
+        m_listen_fd = -1;
+        return -1;
+    }
+    freeaddrinfo(res);
+
+    m_exit = false;
+    if (pthread_create(&m_thread, NULL, primary_run, this) != 0) {
+        close(m_listen_fd);
+        m_listen_fd = -1;
+        return -1;
+    }
+    m_running = true;
+    printf("%s:%d: Primary of epoch %llu, replicating to the standby on %s:%d\n", __func__, __LINE__, m_epoch,
+            m_bind.c_str(), m_port);
+
+    return 0;
+}
+
+void em_ha_t::stop()
+{
+    if (m_running == false) {
+        return;
+    }
+
+    m_exit = true;
+    shutdown(m_listen_fd, SHUT_RDWR);
+    pthread_mutex_lock(&m_lock);
+    if (m_conn_fd >= 0) {
+        shutdown(m_conn_fd, SHUT_RDWR);
+    }
+    pthread_mutex_unlock(&m_lock);
+    pthread_join(m_thread, NULL);
+    close(m_listen_fd);
+    m_listen_fd = -1;
+    m_running = false;
+}
+
+int em_ha_t::apply(db_client_t *client, unsigned char type, std::string& payload)
+{
+    unsigned long long first, last;
+    std::string image;
+
+    switch (type) {
+        case em_ha_frame_info:
+            if (payload.size() < 16 + sizeof(mac_address_t)) {
+                return -1;
+            }
+            // a primary of an older epoch was replaced, it is not followed
+            if (get_u64(payload, 8) < m_peer_epoch) {
+                printf("%s:%d: Primary of epoch %llu replaced in epoch %llu, refused\n", __func__, __LINE__,
+                        get_u64(payload, 8), m_peer_epoch);
+                return -1;
+            }
+            m_peer_epoch = get_u64(payload, 8);
+            if (get_u64(payload, 0) != m_peer_id) {
+                m_peer_id = get_u64(payload, 0);
+                m_peer_seq = 0;
+            }
+            memcpy(m_al_mac, &payload[16], sizeof(mac_address_t));
+            m_al_ifname = payload.substr(16 + sizeof(mac_address_t));
+            break;
+
+        case em_ha_frame_snapshot:
+            if (payload.size() < 8) {
+                return -1;
+            }
+            image = payload.substr(8);
+            if (client->restore_snapshot(image) != 0) {
+                printf("%s:%d: Restoring the snapshot of the primary failed\n", __func__, __LINE__);
+                m_copied = false;
+                return -1;
+            }
+            m_peer_seq = get_u64(payload, 0);
+            m_copied = true;
+            count(0, 1, 0, 0);
+            printf("%s:%d: Database copied from the primary, current to record %llu\n", __func__, __LINE__, m_peer_seq);
+            break;
+
+        case em_ha_frame_tables:
+            if (payload.size() < 16) {
+                return -1;
+            }
+            first = get_u64(payload, 0);
+            last = get_u64(payload, 8);
+            // the tables of a snapshot are written again, a gap can only be filled by another copy
+            if ((first > m_peer_seq + 1) || (last < first)) {
+                printf("%s:%d: Record %llu missing\n", __func__, __LINE__, m_peer_seq + 1);
+                m_copied = false;
+                return -1;
+            }
+            image = payload.substr(16);
+            if (client->restore_snapshot(image) != 0) {
+                printf("%s:%d: Tables of records %llu to %llu refused\n", __func__, __LINE__, first, last);
+                m_copied = false;
+                return -1;
+            }
+            if (last > m_peer_seq) {
+                m_peer_seq = last;
+            }
+            count(0, 0, last - first + 1, 0);
+            break;
+
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+int em_ha_t::run_standby(const char *data_model_path)
+{
+    db_client_t client;
+    struct sockaddr_storage local;
+    socklen_t local_len;
+    unsigned long long last_rx = 0, now;
+    std::string payload;
+    char addr[INET6_ADDRSTRLEN];
+    unsigned char type;
+    const char *ifname;
+    bool reached;
+    SSL *ssl;
+    int fd;
+
+    if ((m_role != em_ha_role_standby) || (init_tls() != 0) || (client.init(data_model_path) != 0)) {
+        return -1;
+    }
+    printf("%s:%d: Standby of %s:%d\n", __func__, __LINE__, m_host.c_str(), m_port);
+
+    while (true) {
+        reached = false;
+        if ((ssl = connect_peer(&fd)) != NULL) {
+            reached = true;
+            count(1, 0, 0, 0);
+
+            // the controller that takes over serves from the address the primary was reached from
+            local_len = sizeof(local);
+            if ((getsockname(fd, reinterpret_cast<struct sockaddr *>(&local), &local_len) == 0) &&
+                    (getnameinfo(reinterpret_cast<struct sockaddr *>(&local), local_len, addr, sizeof(addr), NULL, 0, NI_NUMERICHOST) == 0)) {
+                m_bind = addr;
+            }
+
+            payload.clear();
+            put_u64(payload, m_peer_id);
+            put_u64(payload, m_peer_seq);
+            put_u64(payload, m_epoch);
+            if (send_frame(ssl, em_ha_frame_hello, payload) == 0) {
+                while (recv_frame(ssl, &type, payload, EM_HA_TAKEOVER_MS) == 0) {
+                    last_rx = em_timer_wheel_t::get_time_ms();
+                    count(0, 0, 0, payload.size());
+                    if (apply(&client, type, payload) != 0) {
+                        // copied again from the next connection
+                        m_peer_id = 0;
+                        break;
+                    }
+                }
+            }
+            close_peer(ssl, fd);
+        }
+
+        // a standby that never copied the database has nothing to take over with, a primary that
+        // went silent but still accepts a connection is not taken over
+        now = em_timer_wheel_t::get_time_ms();
+        if ((m_copied == true) && (reached == false) && ((now - last_rx) >= EM_HA_TAKEOVER_MS)) {
+            break;
+        }
+        usleep(EM_HA_RETRY_MS * 1000);
+    }
+
+    ifname = (m_ifname.empty() == true) ? m_al_ifname.c_str():m_ifname.c_str();
+    m_epoch = m_peer_epoch + 1;
+    printf("%s:%d: Primary lost at record %llu, taking over on %s in epoch %llu\n", __func__, __LINE__, m_peer_seq,
+            ifname, m_epoch);
+    if (set_mac_address(ifname, m_al_mac) != 0) {
+        printf("%s:%d: AL MAC not moved to %s, agents have to discover the controller again\n", __func__, __LINE__, ifname);
+    }
+
+    // the next standby replicates this controller
+    m_role = em_ha_role_primary;
+    m_took_over = true;
+
+    return 0;
+}
+
+int em_ha_t::set_mac_address(const char *ifname, const unsigned char *mac)
+{
+    struct ifreq ifr;
+    short flags;
+    int sock, rc = 0;
+
+    if ((sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP)) < 0) {
+        return -1;
+    }
+
+    memset(&ifr, 0, sizeof(ifr));
+    snprintf(ifr.ifr_name, sizeof(ifr.ifr_name), "%s", ifname);
+    if (ioctl(sock, SIOCGIFFLAGS, &ifr) != 0) {
+        close(sock);
+        return -1;
+    }
+    flags = ifr.ifr_flags;
+
+    // most drivers refuse a new address while the interface is up
+    ifr.ifr_flags = static_cast<short>(flags & ~IFF_UP);
+    ioctl(sock, SIOCSIFFLAGS, &ifr);
+
+    ifr.ifr_hwaddr.sa_family = ARPHRD_ETHER;
+    memcpy(ifr.ifr_hwaddr.sa_data, mac, sizeof(mac_address_t));
+    if (ioctl(sock, SIOCSIFHWADDR, &ifr) != 0) {
+        printf("%s:%d: Setting the address of %s failed, err:%d\n", __func__, __LINE__, ifname, errno);
+        rc = -1;
+    }
+
+    ifr.ifr_flags = flags;
+    ioctl(sock, SIOCSIFFLAGS, &ifr);
+    close(sock);
+
+    return rc;
+}
+
+static int split_host(const std::string& in, std::string& host, std::string& rest)
+{
+    size_t pos;
+
+    // the port follows the host, an IPv6 address has colons of its own
+    if ((in.empty() == false) && (in[0] == '[')) {
+        if ((pos = in.find(']')) == std::string::npos) {
+            return -1;
+        }
+        host = in.substr(1, pos - 1);
+        pos++;
+    } else {
+        pos = in.find(':');
+        host = in.substr(0, pos);
+    }
+    if ((pos == std::string::npos) || (pos >= in.size()) || (in[pos] != ':') || (host.empty() == true)) {
+        return -1;
+    }
+    rest = in.substr(pos + 1);
+
+    return 0;
+}
+
+int em_ha_t::configure(const char *spec)
+{
+    std::string str(spec), role, rest;
+    size_t pos;
+    long port;
+    char *end;
+
+    if ((pos = str.find(':')) == std::string::npos) {
+        return -1;
+    }
+    role = str.substr(0, pos);
+    rest = str.substr(pos + 1);
+
+    if (role == "primary") {
+        // the standby is served on one address, not on every interface
+        if (split_host(rest, m_bind, rest) != 0) {
+            return -1;
+        }
+        m_role = em_ha_role_primary;
+    } else if (role == "standby") {
+        if (split_host(rest, m_host, rest) != 0) {
+            return -1;
+        }
+        if ((pos = rest.find(':')) != std::string::npos) {
+            m_ifname = rest.substr(pos + 1);
+            rest = rest.substr(0, pos);
+        }
+        m_role = em_ha_role_standby;
+    } else {
+        return -1;
+    }
+
+    port = strtol(rest.c_str(), &end, 10);
+    if ((rest.empty() == true) || (*end != '\0') || (port <= 0) || (port > 65535)) {
+        m_role = em_ha_role_none;
+        return -1;
+    }
+    m_port = static_cast<unsigned short>(port);
+
+    return 0;
+}
+
+void em_ha_t::get_stats(em_ha_stats_t *stats)
+{
+    pthread_mutex_lock(&m_lock);
+    *stats = m_stats;
+    pthread_mutex_unlock(&m_lock);
+}
+
+em_ha_t::em_ha_t(): m_role(em_ha_role_none), m_host(), m_bind(), m_port(0), m_ifname(), m_log(), m_ssl_ctx(NULL),
+    m_client(NULL), m_al_ifname(), m_listen_fd(-1), m_conn_fd(-1), m_thread(), m_running(false), m_exit(false),
+    m_epoch(0), m_peer_id(0), m_peer_seq(0), m_peer_epoch(0), m_copied(false), m_took_over(false), m_fenced(false),
+    m_lock(), m_stats()
+{
+    memset(m_al_mac, 0, sizeof(mac_address_t));
+    memset(&m_stats, 0, sizeof(m_stats));
+    pthread_mutex_init(&m_lock, NULL);
+}
+
+em_ha_t::~em_ha_t()
+{
+    stop();
+    if (m_ssl_ctx != NULL) {
+        SSL_CTX_free(m_ssl_ctx);
+    }
+    pthread_mutex_destroy(&m_lock);
+}
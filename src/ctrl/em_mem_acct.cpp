@@ -0,0 +1,214 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "em_mem_acct.h"
+
+static const char *s_type_str[em_mem_acct_max] = {
+    "DataModel",
+    "STAs",
+    "ScanResults",
+    "STACaches",
+    "Nodes",
+    "Commands",
+    "Stacks",
+};
+
+const char *em_mem_acct_t::get_type_str(em_mem_acct_type_t type)
+{
+    return (type < em_mem_acct_max) ? s_type_str[type]:"";
+}
+
+unsigned long long em_mem_acct_t::get_heap_bytes(const em_mem_acct_usage_t *usage)
+{
+    unsigned long long bytes = 0;
+    unsigned int i;
+
+    for (i = 0; i < em_mem_acct_max; i++) {
+        if (i != em_mem_acct_stacks) {
+            bytes += usage->bytes[i];
+        }
+    }
+
+    return bytes;
+}
+
+unsigned int em_mem_acct_t::update(const em_mem_acct_usage_t *usage, unsigned int num, em_mem_acct_usage_t *over, unsigned int max)
+{
+    std::unordered_map<em_packed_mac_t, em_mem_acct_usage_t> next;
+    unsigned long long total = 0, bytes;
+    unsigned int i, num_over = 0;
+
+    next.reserve(num);
+    for (i = 0; i < num; i++) {
+        next[em_hex::pack_mac(usage[i].al_mac)] = usage[i];
+        total += get_heap_bytes(&usage[i]);
+    }
+
+    pthread_mutex_lock(&m_lock);
+    if (m_params.agent_budget != 0) {
+        for (i = 0; i < num; i++) {
+            bytes = get_heap_bytes(&usage[i]);
+            if ((bytes > m_params.agent_budget) && (over != NULL) && (num_over < max)) {
+                over[num_over++] = usage[i];
+            }
+        }
+    }
+    m_agents.swap(next);
+    m_stats.updates++;
+    m_stats.total_bytes = total;
+    if (total > m_stats.peak_bytes) {
+        m_stats.peak_bytes = total;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return num_over;
+}
+
+bool em_mem_acct_t::admit(const unsigned char *al_mac)
+{
+    em_packed_mac_t key = em_hex::pack_mac(al_mac);
+    em_mem_acct_usage_t usage;
+    bool admitted = true;
+
+    pthread_mutex_lock(&m_lock);
+    if (m_agents.find(key) == m_agents.end()) {
+        if (((m_params.max_agents != 0) && (m_agents.size() >= m_params.max_agents)) ||
+                ((m_params.total_budget != 0) && (m_stats.total_bytes >= m_params.total_budget))) {
+            m_stats.refused++;
+            admitted = false;
+        } else {
+            // counted against max_agents until the next update measures it
+            memset(&usage, 0, sizeof(usage));
+            memcpy(usage.al_mac, al_mac, sizeof(mac_address_t));
+            m_agents[key] = usage;
+        }
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return admitted;
+}
+
+void em_mem_acct_t::evicted(unsigned long long bytes)
+{
+    pthread_mutex_lock(&m_lock);
+    m_stats.evictions++;
+    m_stats.evicted_bytes += bytes;
+    // freed at once for admit(), the next update has the exact figures
+    m_stats.total_bytes -= (m_stats.total_bytes >= bytes) ? bytes:m_stats.total_bytes;
+    pthread_mutex_unlock(&m_lock);
+}
+
+bool em_mem_acct_t::get_usage(const unsigned char *al_mac, em_mem_acct_usage_t *usage)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&m_lock);
+    auto it = m_agents.find(em_hex::pack_mac(al_mac));
+    if (it != m_agents.end()) {
+        *usage = it->second;
+        found = true;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return found;
+}
+
+unsigned int em_mem_acct_t::count()
+{
+    unsigned int num;
+
+    pthread_mutex_lock(&m_lock);
+    num = static_cast<unsigned int> (m_agents.size());
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+void em_mem_acct_t::encode(cJSON *obj)
+{
+    char mac_str[EM_HEX_MAC_STR_LEN + 1];
+    cJSON *arr, *agent;
+    unsigned int i;
+
+    pthread_mutex_lock(&m_lock);
+    cJSON_AddNumberToObject(obj, "AgentBudget", static_cast<double>(m_params.agent_budget));
+    cJSON_AddNumberToObject(obj, "TotalBudget", static_cast<double>(m_params.total_budget));
+    cJSON_AddNumberToObject(obj, "MaxAgents", m_params.max_agents);
+    cJSON_AddNumberToObject(obj, "TotalBytes", static_cast<double>(m_stats.total_bytes));
+    cJSON_AddNumberToObject(obj, "PeakBytes", static_cast<double>(m_stats.peak_bytes));
+    cJSON_AddNumberToObject(obj, "Refused", static_cast<double>(m_stats.refused));
+    cJSON_AddNumberToObject(obj, "Evictions", static_cast<double>(m_stats.evictions));
+    cJSON_AddNumberToObject(obj, "EvictedBytes", static_cast<double>(m_stats.evicted_bytes));
+
+    arr = cJSON_AddArrayToObject(obj, "Agents");
+    for (auto& it : m_agents) {
+        agent = cJSON_CreateObject();
+        em_hex::mac_to_str(it.second.al_mac, mac_str);
+        cJSON_AddStringToObject(agent, "ALID", mac_str);
+        for (i = 0; i < em_mem_acct_max; i++) {
+            cJSON_AddNumberToObject(agent, s_type_str[i], static_cast<double>(it.second.bytes[i]));
+        }
+        cJSON_AddNumberToObject(agent, "HeapBytes", static_cast<double>(get_heap_bytes(&it.second)));
+        cJSON_AddItemToArray(arr, agent);
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+void em_mem_acct_t::set_params(const em_mem_acct_params_t *params)
+{
+    pthread_mutex_lock(&m_lock);
+    m_params = *params;
+    pthread_mutex_unlock(&m_lock);
+}
+
+em_mem_acct_params_t em_mem_acct_t::get_params()
+{
+    em_mem_acct_params_t params;
+
+    pthread_mutex_lock(&m_lock);
+    params = m_params;
+    pthread_mutex_unlock(&m_lock);
+
+    return params;
+}
+
+em_mem_acct_stats_t em_mem_acct_t::get_stats()
+{
+    em_mem_acct_stats_t stats;
+
+    pthread_mutex_lock(&m_lock);
+    stats = m_stats;
+    pthread_mutex_unlock(&m_lock);
+
+    return stats;
+}
+
+em_mem_acct_t::em_mem_acct_t() : m_lock(), m_agents(), m_params(), m_stats()
+{
+    pthread_mutex_init(&m_lock, NULL);
+    memset(&m_params, 0, sizeof(m_params));
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+em_mem_acct_t::~em_mem_acct_t()
+{
+    pthread_mutex_destroy(&m_lock);
+}
@@ -91,31 +91,38 @@ void em_network_topo_t::encode(cJSON *parent)
 	}	
 }
 
-em_network_topo_t *em_network_topo_t::find_topology_by_bh_associated(mac_address_t sta_mac)
+bool em_network_topo_t::is_bh_associated(const unsigned char *sta_mac)
 {
 	unsigned int i;
 	dm_sta_t *sta;
-	em_network_topo_t *topo;
-	std::string sta_mac_str, dev_mac_str;
 
-	sta_mac_str = util::mac_to_string(sta_mac);
-	dev_mac_str = util::mac_to_string(m_data_model->m_device.m_device_info.intf.mac);
 	for (i = 0; i < m_data_model->m_num_bss; i++) {
 		if (m_data_model->m_bss[i].m_bss_info.id.haul_type == em_haul_type_backhaul) {
-			sta = static_cast<dm_sta_t *> (hash_map_get_first(m_data_model->m_sta_map));
+			sta = static_cast<dm_sta_t *> (m_data_model->m_sta_map->get_first());
 			while (sta != NULL) {
 				if ((memcmp(sta->m_sta_info.id, sta_mac, sizeof(mac_address_t)) == 0) && 
 					(memcmp(sta->m_sta_info.bssid, m_data_model->m_bss[i].m_bss_info.id.bssid, sizeof(mac_address_t)) == 0)) {
-					em_printfout("Found topology of sta mac: %s dev_mac:%s", sta_mac_str.c_str(), dev_mac_str.c_str());
-					return this;
+					return true;
 				}
-				sta = static_cast<dm_sta_t *> (hash_map_get_next(m_data_model->m_sta_map, sta));
+				sta = static_cast<dm_sta_t *> (m_data_model->m_sta_map->get_next(sta));
 			}	
 		}
 	}
 
+	return false;
+}
+
+em_network_topo_t *em_network_topo_t::walk_topology_by_bh_associated(mac_address_t sta_mac)
+{
+	unsigned int i;
+	em_network_topo_t *topo;
+
+	if (is_bh_associated(sta_mac) == true) {
+		return this;
+	}
+
 	for (i = 0; i < m_num_topologies; i++) {
-		if ((topo = m_topology[i]->find_topology_by_bh_associated(sta_mac)) != NULL) {
+		if ((topo = m_topology[i]->walk_topology_by_bh_associated(sta_mac)) != NULL) {
 			return topo;	
 		}
 	}
@@ -123,6 +130,25 @@ em_network_topo_t *em_network_topo_t::find_topology_by_bh_associated(mac_address
 	return NULL;
 }
 
+em_network_topo_t *em_network_topo_t::find_topology_by_bh_associated(mac_address_t sta_mac)
+{
+	em_network_topo_t *topo;
+	std::string sta_mac_str;
+
+	topo = find_indexed(&m_root->m_bsta_index, sta_mac, [sta_mac](em_network_topo_t *t) { return t->is_bh_associated(sta_mac); });
+	if ((topo == NULL) && ((topo = walk_topology_by_bh_associated(sta_mac)) != NULL)) {
+		m_root->m_bsta_index.add(sta_mac, topo);
+	}
+
+	if (topo != NULL) {
+		sta_mac_str = util::mac_to_string(sta_mac);
+		em_printfout("Found topology of sta mac: %s dev_mac:%s", sta_mac_str.c_str(),
+			util::mac_to_string(topo->m_data_model->m_device.m_device_info.intf.mac).c_str());
+	}
+
+	return topo;
+}
+
 em_network_topo_t *em_network_topo_t::find_topology_by_bh_associated(dm_easy_mesh_t *dm)
 {
 	if (dm == NULL)	{
@@ -160,33 +186,47 @@ em_network_topo_t *em_network_topo_t::find_topology_by_bh_associated(dm_easy_mes
 	return g_network_topology->find_topology_by_bss_mac(bss_mac);
 }
 
-em_network_topo_t *em_network_topo_t::find_topology_by_bss_mac(mac_address_t bss_mac)
+em_network_topo_t *em_network_topo_t::walk_topology_by_bss_mac(mac_address_t bss_mac)
 {
 	unsigned int i;
 	em_network_topo_t *topo;
 
-	std::string bss_mac_str = util::mac_to_string(bss_mac);
-	em_bss_info_t* bss_info = m_data_model->get_bss_info_with_mac(bss_mac);
-	if (bss_info) {
-		// If we found the bss info, then return the current topology.
-		em_printfout("Found topology of bss mac: %s num_child_topo:%d", bss_mac_str.c_str(),
-			this->m_num_topologies);
+	if (m_data_model->get_bss_info_with_mac(bss_mac) != NULL) {
 		return this;
 	}
 
-	// If not found in the current topology check recursively other child topologies.
-	em_printfout("Could not find bss mac: %s, continuing with child topologies", bss_mac_str.c_str());
 	for (i = 0; i < m_num_topologies; i++) {
-		if ((topo = m_topology[i]->find_topology_by_bss_mac(bss_mac)) != NULL) {
-			em_printfout("Returning Found topology of bss mac: %s num_child_topo:%d",
-				   bss_mac_str.c_str(), topo->m_num_topologies);
+		if ((topo = m_topology[i]->walk_topology_by_bss_mac(bss_mac)) != NULL) {
 			return topo;
 		}
 	}
-	em_printfout("Could not find bss mac: %s in all topologies, return NULL", bss_mac_str.c_str());
+
 	return NULL;
 }
 
+em_network_topo_t *em_network_topo_t::find_topology_by_bss_mac(mac_address_t bss_mac)
+{
+	em_network_topo_t *topo;
+
+	std::string bss_mac_str = util::mac_to_string(bss_mac);
+	topo = find_indexed(&m_root->m_bss_index, bss_mac, [bss_mac](em_network_topo_t *t) {
+		return (t->m_data_model->get_bss_info_with_mac(bss_mac) != NULL);
+	});
+	if (topo == NULL) {
+		// a BSS added to the data model after its node was indexed
+		em_printfout("Could not find bss mac: %s in index, walking topologies", bss_mac_str.c_str());
+		if ((topo = walk_topology_by_bss_mac(bss_mac)) == NULL) {
+			em_printfout("Could not find bss mac: %s in all topologies, return NULL", bss_mac_str.c_str());
+			return NULL;
+		}
+		m_root->m_bss_index.add(bss_mac, topo);
+	}
+
+	em_printfout("Found topology of bss mac: %s num_child_topo:%d hops:%d", bss_mac_str.c_str(),
+		topo->m_num_topologies, topo->m_hops);
+	return topo;
+}
+
 void em_network_topo_t::print_topology()
 {
 	std::string dev_mac_str = util::mac_to_string(m_data_model->m_device.m_device_info.intf.mac);
@@ -198,30 +238,238 @@ void em_network_topo_t::print_topology()
 	em_printfout("---- Child Topologies[%s] <end> -----", dev_mac_str.c_str());
 }
 
-em_network_topo_t *em_network_topo_t::find_topology(dm_easy_mesh_t *dm)
+em_network_topo_t *em_network_topo_t::walk_topology(dm_easy_mesh_t *dm)
 {
 	unsigned int i;
 	em_network_topo_t *topo;
+
+	if (m_data_model == dm) {
+		return this;
+	}
+
+	for (i = 0; i < m_num_topologies; i++) {
+		if ((topo = m_topology[i]->walk_topology(dm)) != NULL) {
+			return topo;
+		}	
+	}
+
+	return NULL;
+}
+
+em_network_topo_t *em_network_topo_t::find_topology(dm_easy_mesh_t *dm)
+{
+	em_network_topo_t *topo;
 	mac_addr_str_t tgt_dev_mac_str, src_dev_mac_str;
 
 	dm_easy_mesh_t::macbytes_to_string(dm->m_device.m_device_info.intf.mac, tgt_dev_mac_str);
 	dm_easy_mesh_t::macbytes_to_string(m_data_model->m_device.m_device_info.intf.mac, src_dev_mac_str);
-	printf("%s:%d: Trying to find topology: %s in branch: %s\n", __func__, __LINE__, tgt_dev_mac_str, src_dev_mac_str);
 
-	if (m_data_model == dm) {
+	topo = find_indexed(&m_root->m_al_index, dm->m_device.m_device_info.intf.mac, [dm](em_network_topo_t *t) {
+		return (memcmp(t->m_data_model->m_device.m_device_info.intf.mac, dm->m_device.m_device_info.intf.mac,
+			sizeof(mac_address_t)) == 0);
+	}, dm);
+	if ((topo == NULL) && ((topo = walk_topology(dm)) != NULL)) {
+		// the AL MAC of the data model was rewritten after its node was indexed
+		m_root->m_al_index.add(dm->m_device.m_device_info.intf.mac, topo);
+	}
+
+	if (topo != NULL) {
 		printf("%s:%d: Found topology: %s in branch: %s\n", __func__, __LINE__, tgt_dev_mac_str, src_dev_mac_str);
-		return this;
 	}
 
+	return topo;
+}
+
+bool em_network_topo_t::is_current(dm_easy_mesh_t *dm)
+{
+	em_network_topo_t *topo, *parent;
+
+	if (((topo = find_topology(dm)) == NULL) || (topo->m_data_model != dm) || (topo->m_generation != dm->get_generation())) {
+		return false;
+	}
+
+	// a change in another device may have moved the backhaul of this one
+	if ((parent = find_topology_by_bh_associated(dm)) == NULL) {
+		parent = this;
+	}
+
+	return topo->m_parent == parent;
+}
+
+unsigned int em_network_topo_t::get_path(em_network_topo_t **path, unsigned int max)
+{
+	em_network_topo_t *topo;
+	unsigned int num = 0;
+
+	for (topo = this; topo != NULL; topo = topo->m_parent) {
+		if (num < max) {
+			path[num] = topo;
+		}
+		num++;
+	}
+
+	return num;
+}
+
+unsigned int em_network_topo_t::get_link_rate(bool *wireless)
+{
+	unsigned char *bsta;
+	dm_sta_t *sta;
+
+	*wireless = false;
+	if (m_data_model == NULL) {
+		return 0;
+	}
+
+	bsta = m_data_model->m_device.m_device_info.backhaul_sta;
+	if ((m_parent != NULL) && (m_parent->m_data_model != NULL) && (m_parent->m_data_model->m_sta_map != NULL)) {
+		sta = static_cast<dm_sta_t *> (m_parent->m_data_model->m_sta_map->get_first());
+		while (sta != NULL) {
+			if (memcmp(sta->m_sta_info.id, bsta, sizeof(mac_address_t)) == 0) {
+				*wireless = true;
+				return (sta->m_sta_info.est_dl_rate != 0) ? sta->m_sta_info.est_dl_rate:sta->m_sta_info.last_dl_rate;
+			}
+			sta = static_cast<dm_sta_t *> (m_parent->m_data_model->m_sta_map->get_next(sta));
+		}
+	}
+
+	return m_data_model->m_device.m_device_info.backhaul_phyrate;
+}
+
+void em_network_topo_t::walk_routes(const em_route_t *via, em_route_t *routes, unsigned int max, unsigned int *num)
+{
+	em_network_topo_t *child;
+	unsigned int i, rate;
+	em_route_t route;
+	bool wireless;
+
 	for (i = 0; i < m_num_topologies; i++) {
-		if ((topo = m_topology[i]->find_topology(dm)) != NULL) {
+		child = m_topology[i];
+		if (child->m_data_model == NULL) {
+			continue;
+		}
+		rate = child->get_link_rate(&wireless);
+		memset(&route, 0, sizeof(route));
+		memcpy(route.al_mac, child->m_data_model->m_device.m_device_info.intf.mac, sizeof(mac_address_t));
+		if (via == NULL) {
+			memcpy(route.next_hop, route.al_mac, sizeof(mac_address_t));
+		} else {
+			memcpy(route.next_hop, via->next_hop, sizeof(mac_address_t));
+			route.hops = via->hops;
+			route.wireless_hops = via->wireless_hops;
+			route.bottleneck_mbps = via->bottleneck_mbps;
+		}
+		route.hops++;
+		route.wireless_hops += (wireless == true) ? 1:0;
+		// links of unknown rate do not count
+		if ((rate != 0) && ((route.bottleneck_mbps == 0) || (rate < route.bottleneck_mbps))) {
+			route.bottleneck_mbps = rate;
+		}
+		if (*num < max) {
+			routes[*num] = route;
+		}
+		(*num)++;
+		child->walk_routes(&route, routes, max, num);
+	}
+}
+
+unsigned int em_network_topo_t::get_routes(em_route_t *routes, unsigned int max)
+{
+	unsigned int num = 0;
+
+	walk_routes(NULL, routes, max, &num);
+
+	return num;
+}
+
+bool em_network_topo_t::is_in_subtree(em_network_topo_t *topo)
+{
+	// the hops bound the walk up
+	while ((topo != NULL) && (topo->m_hops >= m_hops)) {
+		if (topo == this) {
+			return true;
+		}
+		topo = topo->m_parent;
+	}
+
+	return false;
+}
+
+em_network_topo_t *em_network_topo_t::find_indexed(em_mac_index_t *index, const unsigned char *mac,
+	const std::function<bool(em_network_topo_t *)>& match, dm_easy_mesh_t *dm)
+{
+	void *vals[EM_NETWORK_TOPO_MAX_MATCHES];
+	em_network_topo_t *topo;
+	unsigned int i, num;
+
+	num = index->get_all(mac, vals, EM_NETWORK_TOPO_MAX_MATCHES);
+	for (i = 0; (i < num) && (i < EM_NETWORK_TOPO_MAX_MATCHES); i++) {
+		topo = static_cast<em_network_topo_t *> (vals[i]);
+		if ((topo->m_data_model == NULL) || (match(topo) == false)) {
+			// the data model changed since the node was indexed
+			index->remove(mac, topo);
+		} else if (((dm == NULL) || (topo->m_data_model == dm)) && (is_in_subtree(topo) == true)) {
 			return topo;
-		}	
+		}
 	}
 
 	return NULL;
 }
 
+void em_network_topo_t::index()
+{
+	unsigned int i;
+	dm_sta_t *sta;
+
+	if (m_data_model == NULL) {
+		return;
+	}
+
+	m_root->m_al_index.add(m_data_model->m_device.m_device_info.intf.mac, this);
+	for (i = 0; i < m_data_model->m_num_bss; i++) {
+		m_root->m_bss_index.add(m_data_model->m_bss[i].m_bss_info.bssid.mac, this);
+		if ((m_data_model->m_bss[i].m_bss_info.id.haul_type != em_haul_type_backhaul) || (m_data_model->m_sta_map == NULL)) {
+			continue;
+		}
+		sta = static_cast<dm_sta_t *> (m_data_model->m_sta_map->get_first());
+		while (sta != NULL) {
+			if (memcmp(sta->m_sta_info.bssid, m_data_model->m_bss[i].m_bss_info.id.bssid, sizeof(mac_address_t)) == 0) {
+				m_root->m_bsta_index.add(sta->m_sta_info.id, this);
+			}
+			sta = static_cast<dm_sta_t *> (m_data_model->m_sta_map->get_next(sta));
+		}
+	}
+}
+
+void em_network_topo_t::unindex()
+{
+	unsigned int i;
+
+	m_root->m_al_index.remove_value(this);
+	m_root->m_bss_index.remove_value(this);
+	m_root->m_bsta_index.remove_value(this);
+	for (i = 0; i < m_num_topologies; i++) {
+		m_topology[i]->unindex();
+	}
+}
+
+void em_network_topo_t::attach(em_network_topo_t *parent)
+{
+	unsigned int i;
+
+	m_parent = parent;
+	m_root = (parent == NULL) ? this:parent->m_root;
+	m_hops = (parent == NULL) ? 0:(parent->m_hops + 1);
+	m_al_index.clear();
+	m_bss_index.clear();
+	m_bsta_index.clear();
+
+	index();
+	for (i = 0; i < m_num_topologies; i++) {
+		m_topology[i]->attach(this);
+	}
+}
+
 void em_network_topo_t::add_network_topo(dm_easy_mesh_t *dm, em_network_topo_t **child_topos, unsigned int num_child_topos)
 {
 	std::string dev_mac_str = util::mac_to_string(dm->m_device.m_device_info.intf.mac);
@@ -250,6 +498,7 @@ void em_network_topo_t::add_network_topo(dm_easy_mesh_t *dm, em_network_topo_t *
 	} else {
 		em_printfout("No child topologies to add to the new topo: %s", dev_mac_str.c_str());
 	}
+	m_topology[m_num_topologies]->attach(this);
 	m_num_topologies++;
 }
 
@@ -270,45 +519,44 @@ void em_network_topo_t::add(dm_easy_mesh_t *dm, em_network_topo_t **child_topos,
 
 bool em_network_topo_t::remove(dm_easy_mesh_t *dm, em_network_topo_t **child_topos, unsigned int *num_child_topos)
 {
-	unsigned int i, index = 0;
-	bool found = false;
+	unsigned int i, index;
+	em_network_topo_t *topo, *parent;
 
 	std::string dev_mac_str = util::mac_to_string(dm->m_device.m_device_info.intf.mac);
 	std::string parent_dev_mac_str = util::mac_to_string(m_data_model->m_device.m_device_info.intf.mac);
-	for (i = 0; i < m_num_topologies; i++) {
-		if (m_topology[i]->get_data_model() == dm) {
-			found = true;
-			index = i;
-			break;
-		}
+	if (((topo = find_topology(dm)) == NULL) || (topo == this)) {
+		em_printfout("Could not find topology for dev_mac:%s in any child topologies of parent dm:%s",
+			dev_mac_str.c_str(), parent_dev_mac_str.c_str());
+		return false;
 	}
-	if (found == true) {
-		if (child_topos != NULL && num_child_topos != NULL) {
-			memcpy(child_topos, m_topology[i]->m_topology, sizeof(m_topology[i]->m_topology));
-			*num_child_topos = m_topology[i]->m_num_topologies;
-		}
-		delete m_topology[i];
-		for (i = index; i < m_num_topologies - 1; i++) {
-			m_topology[i] = m_topology[i + 1];
+
+	parent = topo->m_parent;
+	for (index = 0; index < parent->m_num_topologies; index++) {
+		if (parent->m_topology[index] == topo) {
+			break;
 		}
-		em_printfout("Found and Removed topology of dev_mac:%s in parent dm:%s num_child_topos:%d",
-			dev_mac_str.c_str(), parent_dev_mac_str.c_str(), m_num_topologies);
-		m_num_topologies--;
-		return found;
 	}
+	assert(index < parent->m_num_topologies);
 
-	//If the control comes here then dm is not found in topologies, check within each topologies further
-	em_printfout("Could not find topology for dev_mac:%s in parent dm:%s, checking each child topologies",
-		dev_mac_str.c_str(), parent_dev_mac_str.c_str());
-	//search recursively in the child topologies
-	for (i = 0; i < m_num_topologies; i++) {
-		if ((found = m_topology[i]->remove(dm, child_topos, num_child_topos)) == true) {
-			return found;
-		}
+	if (child_topos != NULL && num_child_topos != NULL) {
+		memcpy(child_topos, topo->m_topology, sizeof(topo->m_topology));
+		*num_child_topos = topo->m_num_topologies;
 	}
-	em_printfout("Could not find topology for dev_mac:%s in any child topologies of parent dm:%s",
-		dev_mac_str.c_str(), parent_dev_mac_str.c_str());
-	return false;
+	// the children are left as trees of their own, to be added back by the caller
+	topo->unindex();
+	for (i = 0; i < topo->m_num_topologies; i++) {
+		topo->m_topology[i]->attach(NULL);
+	}
+	delete topo;
+	for (i = index; i < parent->m_num_topologies - 1; i++) {
+		parent->m_topology[i] = parent->m_topology[i + 1];
+	}
+	em_printfout("Found and Removed topology of dev_mac:%s in parent dm:%s num_child_topos:%d",
+		dev_mac_str.c_str(), util::mac_to_string(parent->m_data_model->m_device.m_device_info.intf.mac).c_str(),
+		parent->m_num_topologies);
+	parent->m_num_topologies--;
+
+	return true;
 }
 
 em_network_topo_t::em_network_topo_t(dm_easy_mesh_t *dm)
@@ -316,6 +564,11 @@ em_network_topo_t::em_network_topo_t(dm_easy_mesh_t *dm)
 	m_num_topologies  = 0;
 	m_data_model = dm;
 	memset(m_topology, 0, sizeof(m_topology));
+	// the data model may not be filled yet, the node is indexed when added to a tree or found
+	m_parent = NULL;
+	m_root = this;
+	m_hops = 0;
+	m_generation = (dm != NULL) ? dm->get_generation():0;
 }
 
 em_network_topo_t::em_network_topo_t()
@@ -323,6 +576,10 @@ em_network_topo_t::em_network_topo_t()
 	m_data_model = NULL;
 	m_num_topologies  = 0;
 	memset(m_topology, 0, sizeof(m_topology));
+	m_parent = NULL;
+	m_root = this;
+	m_hops = 0;
+	m_generation = 0;
 }
 
 em_network_topo_t::~em_network_topo_t()
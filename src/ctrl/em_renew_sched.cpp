@@ -0,0 +1,247 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+#include "em_renew_sched.h"
+
+void em_renew_sched_t::advance()
+{
+    while ((m_next < m_entries.size()) && (m_entries[m_next].state != em_renew_sched_waiting)) {
+        m_next++;
+    }
+}
+
+void em_renew_sched_t::end(em_renew_sched_entry_t *entry, bool ok)
+{
+    entry->state = (ok == true) ? em_renew_sched_done:em_renew_sched_failed;
+    m_active--;
+}
+
+void em_renew_sched_t::expire(unsigned long long now)
+{
+    for (auto& entry : m_entries) {
+        if ((entry.state == em_renew_sched_active) && (now >= entry.start_ms + EM_RENEW_SCHED_STEP_MS)) {
+            end(&entry, false);
+            m_progress.timeouts++;
+            m_moved_ms = now;
+        }
+    }
+
+    // the radio holding the round back is the deepest one still waiting, its em never got ready
+    if ((m_next < m_entries.size()) && ((m_max_active == 0) || (m_active < m_max_active)) &&
+            (now >= m_moved_ms + EM_RENEW_SCHED_STEP_MS)) {
+        m_entries[m_next].state = em_renew_sched_failed;
+        m_progress.timeouts++;
+        m_moved_ms = now;
+        advance();
+    }
+}
+
+void em_renew_sched_t::set_limits(unsigned int max_active, unsigned int gap_ms)
+{
+    pthread_mutex_lock(&m_lock);
+    m_max_active = max_active;
+    m_gap_ms = gap_ms;
+    pthread_mutex_unlock(&m_lock);
+}
+
+unsigned int em_renew_sched_t::plan(const em_renew_sched_radio_t *radios, unsigned int num, unsigned long long now)
+{
+    std::vector<em_renew_sched_entry_t> next;
+    std::unordered_map<em_packed_mac_t, unsigned int> index;
+    em_renew_sched_entry_t entry;
+    unsigned int i;
+
+    pthread_mutex_lock(&m_lock);
+
+    // the radios still in progress keep their slot, the ones still waiting join the new round
+    for (auto& old : m_entries) {
+        if ((old.state == em_renew_sched_active) || (old.state == em_renew_sched_waiting)) {
+            index[em_hex::pack_mac(old.radio.ruid)] = static_cast<unsigned int> (next.size());
+            next.push_back(old);
+        }
+    }
+    for (i = 0; i < num; i++) {
+        if (index.find(em_hex::pack_mac(radios[i].ruid)) != index.end()) {
+            continue;
+        }
+        memset(&entry, 0, sizeof(em_renew_sched_entry_t));
+        entry.radio = radios[i];
+        entry.state = em_renew_sched_waiting;
+        index[em_hex::pack_mac(radios[i].ruid)] = static_cast<unsigned int> (next.size());
+        next.push_back(entry);
+    }
+
+    // active first, then the deepest agents, the radios of an agent next to each other
+    std::stable_sort(next.begin(), next.end(), [](const em_renew_sched_entry_t& a, const em_renew_sched_entry_t& b) {
+        if (a.state != b.state) {
+            return a.state == em_renew_sched_active;
+        }
+        if (a.radio.hops != b.radio.hops) {
+            return a.radio.hops > b.radio.hops;
+        }
+        return memcmp(a.radio.al_mac, b.radio.al_mac, sizeof(mac_address_t)) < 0;
+    });
+
+    m_entries.swap(next);
+    m_index.clear();
+    m_active = 0;
+    m_next = 0;
+    for (i = 0; i < m_entries.size(); i++) {
+        m_index[em_hex::pack_mac(m_entries[i].radio.ruid)] = i;
+        if (m_entries[i].state == em_renew_sched_active) {
+            m_active++;
+        }
+    }
+    advance();
+    m_moved_ms = now;
+    m_progress.rounds++;
+    num = static_cast<unsigned int> (m_entries.size());
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+bool em_renew_sched_t::may_start(const unsigned char *ruid, unsigned long long now)
+{
+    em_renew_sched_entry_t *entry;
+    bool start = true;
+
+    pthread_mutex_lock(&m_lock);
+    auto it = m_index.find(em_hex::pack_mac(ruid));
+    if ((it == m_index.end()) || (m_entries[it->second].state != em_renew_sched_waiting)) {
+        pthread_mutex_unlock(&m_lock);
+        return true;
+    }
+
+    expire(now);
+    entry = &m_entries[it->second];
+    if (entry->state != em_renew_sched_waiting) {
+        // given up on while its em was not ready, it is not held back any longer
+        pthread_mutex_unlock(&m_lock);
+        return true;
+    }
+
+    if (entry->radio.hops < m_entries[m_next].radio.hops) {
+        start = false;
+    } else if ((m_max_active != 0) && (m_active >= m_max_active)) {
+        start = false;
+    } else if ((m_gap_ms != 0) && (m_last_start_ms != 0) && (now < m_last_start_ms + m_gap_ms)) {
+        start = false;
+    }
+
+    if (start == true) {
+        entry->state = em_renew_sched_active;
+        entry->start_ms = now;
+        m_active++;
+        m_last_start_ms = now;
+        m_moved_ms = now;
+        advance();
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return start;
+}
+
+void em_renew_sched_t::finish(const unsigned char *ruid, bool ok, unsigned long long now)
+{
+    em_renew_sched_entry_t *entry;
+
+    pthread_mutex_lock(&m_lock);
+    auto it = m_index.find(em_hex::pack_mac(ruid));
+    if (it != m_index.end()) {
+        entry = &m_entries[it->second];
+        if (entry->state == em_renew_sched_active) {
+            end(entry, ok);
+            m_moved_ms = now;
+        } else if (entry->state == em_renew_sched_waiting) {
+            // canceled before its turn
+            entry->state = (ok == true) ? em_renew_sched_done:em_renew_sched_failed;
+            m_moved_ms = now;
+            advance();
+        }
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+bool em_renew_sched_t::get_entry(const unsigned char *ruid, em_renew_sched_entry_t *entry)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&m_lock);
+    auto it = m_index.find(em_hex::pack_mac(ruid));
+    if (it != m_index.end()) {
+        *entry = m_entries[it->second];
+        found = true;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return found;
+}
+
+em_renew_sched_progress_t em_renew_sched_t::get_progress()
+{
+    em_renew_sched_progress_t progress;
+
+    pthread_mutex_lock(&m_lock);
+    progress = m_progress;
+    progress.total = static_cast<unsigned int> (m_entries.size());
+    progress.waiting = progress.active = progress.done = progress.failed = 0;
+    for (auto& entry : m_entries) {
+        switch (entry.state) {
+            case em_renew_sched_waiting:
+                progress.waiting++;
+                break;
+
+            case em_renew_sched_active:
+                progress.active++;
+                break;
+
+            case em_renew_sched_done:
+                progress.done++;
+                break;
+
+            case em_renew_sched_failed:
+                progress.failed++;
+                break;
+        }
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return progress;
+}
+
+em_renew_sched_t::em_renew_sched_t()
+{
+    pthread_mutex_init(&m_lock, NULL);
+    m_next = 0;
+    m_active = 0;
+    m_last_start_ms = 0;
+    m_moved_ms = 0;
+    m_max_active = EM_RENEW_SCHED_MAX_ACTIVE;
+    m_gap_ms = EM_RENEW_SCHED_GAP_MS;
+    memset(&m_progress, 0, sizeof(em_renew_sched_progress_t));
+}
+
+em_renew_sched_t::~em_renew_sched_t()
+{
+    pthread_mutex_destroy(&m_lock);
+}
@@ -0,0 +1,130 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+#include "em_route_table.h"
+
+unsigned int em_route_table_t::update(const em_route_t *routes, unsigned int num)
+{
+    std::unordered_map<em_packed_mac_t, em_route_t> next;
+    unsigned int i, changed = 0;
+
+    next.reserve(num);
+    for (i = 0; i < num; i++) {
+        next[em_hex::pack_mac(routes[i].al_mac)] = routes[i];
+    }
+
+    pthread_mutex_lock(&m_lock);
+    for (auto& it : next) {
+        auto old = m_routes.find(it.first);
+        if ((old == m_routes.end()) || (old->second.hops != it.second.hops) ||
+                (em_hex::mac_equal(old->second.next_hop, it.second.next_hop) == false)) {
+            changed++;
+        }
+    }
+    for (auto& it : m_routes) {
+        if (next.find(it.first) == next.end()) {
+            changed++;
+        }
+    }
+    m_routes.swap(next);
+    m_stats.updates++;
+    m_stats.changed += changed;
+    pthread_mutex_unlock(&m_lock);
+
+    return changed;
+}
+
+bool em_route_table_t::get_route(const unsigned char *al_mac, em_route_t *route)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&m_lock);
+    m_stats.lookups++;
+    auto it = m_routes.find(em_hex::pack_mac(al_mac));
+    if (it != m_routes.end()) {
+        *route = it->second;
+        found = true;
+    } else {
+        m_stats.misses++;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return found;
+}
+
+unsigned int em_route_table_t::get_poll_scale(const unsigned char *al_mac)
+{
+    em_route_t route;
+
+    if (get_route(al_mac, &route) == false) {
+        return 1;
+    }
+
+    return get_poll_scale(&route);
+}
+
+unsigned int em_route_table_t::get_poll_scale(const em_route_t *route)
+{
+    unsigned int scale = 1;
+
+    if (route->wireless_hops > 1) {
+        scale <<= std::min(route->wireless_hops - 1, 2u);
+    }
+    if ((route->bottleneck_mbps != 0) && (route->bottleneck_mbps < EM_ROUTE_SLOW_LINK_MBPS)) {
+        scale <<= 1;
+    }
+
+    return std::min(scale, static_cast<unsigned int> (EM_ROUTE_MAX_POLL_SCALE));
+}
+
+unsigned int em_route_table_t::count()
+{
+    unsigned int num;
+
+    pthread_mutex_lock(&m_lock);
+    num = static_cast<unsigned int> (m_routes.size());
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+em_route_table_stats_t em_route_table_t::get_stats()
+{
+    em_route_table_stats_t stats;
+
+    pthread_mutex_lock(&m_lock);
+    stats = m_stats;
+    pthread_mutex_unlock(&m_lock);
+
+    return stats;
+}
+
+em_route_table_t::em_route_table_t()
+{
+    pthread_mutex_init(&m_lock, NULL);
+    memset(&m_stats, 0, sizeof(em_route_table_stats_t));
+}
+
+em_route_table_t::~em_route_table_t()
+{
+    pthread_mutex_destroy(&m_lock);
+}
@@ -0,0 +1,243 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "em_steer_engine.h"
+
+static inline unsigned long long sta_key(const unsigned char *sta)
+{
+    unsigned long long key = 0;
+
+    memcpy(&key, sta, sizeof(mac_address_t));
+
+    return key;
+}
+
+unsigned long long em_steer_engine_t::now_us()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return static_cast<unsigned long long>(ts.tv_sec) * 1000000 + static_cast<unsigned long long>(ts.tv_nsec / 1000);
+}
+
+unsigned int em_steer_engine_t::evaluate(unsigned long long now, em_sta_metrics_table_t *table, em_metrics_history_t *sta_history,
+                                         em_metrics_history_t *bss_history, em_beacon_report_cache_t *reports,
+                                         em_steer_decision_t *decisions, unsigned int max, em_client_cap_cache_t *caps,
+                                         em_beacon_report_cache_t *unassoc)
+{
+    const em_sta_metrics_cols_t *cols;
+    em_beacon_report_entry_t entries[2 * EM_BEACON_REPORT_MAX_PER_STA];
+    const em_beacon_report_entry_t *target;
+    em_metrics_aggregate_t sta_agg, bss_agg;
+    em_steer_decision_t *d;
+    unsigned int i, j, num_entries, src_util, util, num = 0, steers = 0, triggered = 0;
+    unsigned long long start = now_us(), elapsed, pass;
+    bool weak, busy, fresh;
+
+    if (m_params.enabled == false) {
+        return 0;
+    }
+
+    pass = ++m_stats.passes;
+
+    table->read_lock();
+    cols = table->get_cols();
+
+    for (i = 0; (i < cols->num_rows) && (num < max); i++) {
+        auto it = m_stas.find(sta_key(cols->sta[i]));
+        if (it != m_stas.end()) {
+            it->second.pass = pass;
+            if (it->second.backoff_until > now) {
+                continue;
+            }
+        }
+
+        // a trend, a single bad sample does not steer a STA
+        if ((sta_history->get_aggregate(cols->sta[i], 0, now, &sta_agg) == false) || (sta_agg.num < m_params.min_samples)) {
+            continue;
+        }
+        weak = (sta_agg.ewma.rcpi < m_params.rcpi_thresh);
+        src_util = 0;
+        busy = false;
+        if (m_params.util_thresh != 0) {
+            if (bss_history->get_aggregate(cols->bssid[i], 0, now, &bss_agg) == true) {
+                src_util = bss_agg.ewma.util;
+            }
+            busy = (src_util > m_params.util_thresh);
+        }
+
+        if ((weak == false) && (busy == false)) {
+            if (it != m_stas.end()) {
+                it->second.trigger_ms = 0;
+            }
+            continue;
+        }
+
+        triggered++;
+        if (it == m_stas.end()) {
+            it = m_stas.emplace(sta_key(cols->sta[i]), em_steer_sta_state_t()).first;
+            it->second.pass = pass;
+        }
+        if (it->second.trigger_ms == 0) {
+            it->second.trigger_ms = now;
+        }
+
+        // strongest fresh BSS of the Beacon Reports and of the agents that measured the STA, better by the hysteresis
+        target = NULL;
+        fresh = false;
+        num_entries = reports->get_reports(cols->sta[i], entries, EM_BEACON_REPORT_MAX_PER_STA);
+        if (unassoc != NULL) {
+            num_entries += unassoc->get_reports(cols->sta[i], &entries[num_entries], EM_BEACON_REPORT_MAX_PER_STA);
+        }
+        for (j = 0; j < num_entries; j++) {
+            if ((memcmp(entries[j].bssid, cols->bssid[i], sizeof(bssid_t)) == 0) ||
+                    (entries[j].time_ms + EM_BEACON_REPORT_FRESH_MS <= now)) {
+                continue;
+            }
+            fresh = true;
+            if (weak == true) {
+                if (entries[j].rcpi < static_cast<unsigned int>(sta_agg.ewma.rcpi) + m_params.rcpi_hysteresis) {
+                    continue;
+                }
+            } else if (entries[j].rcpi < static_cast<unsigned int>(m_params.rcpi_thresh) + m_params.rcpi_hysteresis) {
+                continue;
+            }
+            // a band the STA never announced, it would not find the target
+            if ((caps != NULL) && (caps->supports_op_class(cols->sta[i], entries[j].op_class) == false)) {
+                continue;
+            }
+            if (m_params.util_thresh != 0) {
+                util = (bss_history->get_aggregate(entries[j].bssid, 0, now, &bss_agg) == true) ? bss_agg.ewma.util:0;
+                if ((util > m_params.util_thresh) || ((busy == true) && (util + m_params.util_hysteresis >= src_util))) {
+                    continue;
+                }
+            }
+            if ((target == NULL) || (entries[j].rcpi > target->rcpi)) {
+                target = &entries[j];
+            }
+        }
+
+        d = &decisions[num];
+        memcpy(d->sta, cols->sta[i], sizeof(mac_address_t));
+        memcpy(d->source, cols->bssid[i], sizeof(bssid_t));
+        d->rcpi = sta_agg.ewma.rcpi;
+
+        if (fresh == false) {
+            d->action = em_steer_action_beacon_report;
+            memset(d->target, 0, sizeof(bssid_t));
+            d->op_class = 0;
+            d->channel = 0;
+            d->target_rcpi = 0;
+            d->latency_ms = 0;
+            m_stats.beacon_requests++;
+            num++;
+            continue;
+        }
+
+        // no better BSS, wait for the reports to go stale before asking again
+        if ((target == NULL) || (steers >= m_params.max_steers)) {
+            continue;
+        }
+
+        d->action = em_steer_action_steer;
+        memcpy(d->target, target->bssid, sizeof(bssid_t));
+        d->op_class = target->op_class;
+        d->channel = target->channel;
+        d->target_rcpi = target->rcpi;
+        d->latency_ms = now - it->second.trigger_ms;
+        m_stats.steers++;
+        m_stats.last_latency_ms = d->latency_ms;
+        m_stats.total_latency_ms += d->latency_ms;
+        if (d->latency_ms > m_stats.max_latency_ms) {
+            m_stats.max_latency_ms = d->latency_ms;
+        }
+        steers++;
+        num++;
+    }
+
+    m_stats.last_stas = cols->num_rows;
+    table->read_unlock();
+
+    // forget the STAs gone from the table or left alone for a backoff past their last one
+    for (auto it = m_stas.begin(); it != m_stas.end();) {
+        if (((it->second.pass != pass) || (it->second.trigger_ms == 0)) &&
+                (it->second.backoff_until + m_params.backoff_ms <= now)) {
+            it = m_stas.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    m_stats.last_triggered = triggered;
+    elapsed = now_us() - start;
+    m_stats.last_pass_us = elapsed;
+    if (elapsed > m_stats.max_pass_us) {
+        m_stats.max_pass_us = elapsed;
+    }
+
+    return num;
+}
+
+void em_steer_engine_t::steered(const unsigned char *sta, unsigned long long now)
+{
+    em_steer_sta_state_t *state = &m_stas[sta_key(sta)];
+    unsigned long long backoff;
+    unsigned int shift;
+
+    state->attempts++;
+    shift = (state->attempts > 16) ? 16:(state->attempts - 1);
+    backoff = static_cast<unsigned long long>(m_params.backoff_ms) << shift;
+    if (backoff > m_params.backoff_max_ms) {
+        backoff = m_params.backoff_max_ms;
+    }
+    state->backoff_until = now + backoff;
+    state->trigger_ms = 0;
+}
+
+bool em_steer_engine_t::in_backoff(const unsigned char *sta, unsigned long long now)
+{
+    auto it = m_stas.find(sta_key(sta));
+
+    return (it != m_stas.end()) && (it->second.backoff_until > now);
+}
+
+em_steer_engine_t::em_steer_engine_t()
+{
+    memset(&m_params, 0, sizeof(m_params));
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    m_params.enabled = true;
+    m_params.rcpi_thresh = 70;          // -75 dBm
+    m_params.rcpi_hysteresis = 12;      // 6 dB
+    m_params.util_thresh = 200;         // of 255
+    m_params.util_hysteresis = 40;
+    m_params.min_samples = 4;
+    m_params.backoff_ms = 30000;
+    m_params.backoff_max_ms = 480000;
+    m_params.max_steers = 4;
+    m_params.btm_disassoc_timer = 100;
+}
+
+em_steer_engine_t::~em_steer_engine_t()
+{
+
+}
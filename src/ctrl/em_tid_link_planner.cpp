@@ -0,0 +1,200 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "em_tid_link_planner.h"
+
+unsigned int em_tid_link_planner_t::evaluate(unsigned long long now, const em_tid_link_mld_t *mlds, unsigned int num,
+                                             em_metrics_history_t *sta_history, em_metrics_history_t *bss_history,
+                                             em_tid_link_decision_t *decisions, unsigned int max)
+{
+    em_metrics_aggregate_t sta_agg[EM_TID_LINK_PLANNER_MAX_LINKS], bss_agg[EM_TID_LINK_PLANNER_MAX_LINKS];
+    bool sta_ok[EM_TID_LINK_PLANNER_MAX_LINKS], bss_ok[EM_TID_LINK_PLANNER_MAX_LINKS], on, keep;
+    const em_tid_link_mld_t *mld;
+    em_tid_link_mld_state_t *st;
+    em_tid_link_decision_t *d;
+    unsigned char all, map, bit, best_map;
+    unsigned int i, j, links, rcpi, util, best_rcpi, out = 0;
+    unsigned long long pass, newest;
+
+    if (m_params.enabled == false) {
+        return 0;
+    }
+
+    pass = ++m_stats.passes;
+    m_stats.last_mlds = num;
+
+    for (i = 0; i < num; i++) {
+        mld = &mlds[i];
+        links = (mld->num_links < EM_TID_LINK_PLANNER_MAX_LINKS) ? mld->num_links:EM_TID_LINK_PLANNER_MAX_LINKS;
+        all = 0;
+        newest = 0;
+        for (j = 0; j < links; j++) {
+            sta_ok[j] = false;
+            bss_ok[j] = false;
+            if (mld->links[j].link_id >= EM_TID_LINK_PLANNER_MAX_LINKS) {
+                continue;
+            }
+            all |= static_cast<unsigned char> (1 << mld->links[j].link_id);
+            if ((sta_ok[j] = sta_history->get_aggregate(mld->links[j].sta, 0, now, &sta_agg[j])) == true) {
+                newest = (sta_agg[j].ewma.time_ms > newest) ? sta_agg[j].ewma.time_ms:newest;
+            }
+            if ((m_params.util_ceiling != 0) &&
+                    ((bss_ok[j] = bss_history->get_aggregate(mld->links[j].bssid, 0, now, &bss_agg[j])) == true)) {
+                newest = (bss_agg[j].ewma.time_ms > newest) ? bss_agg[j].ewma.time_ms:newest;
+            }
+        }
+        if (all == 0) {
+            continue;
+        }
+
+        auto it = m_mlds.find(em_hex::pack_mac(mld->sta_mld));
+        if (it == m_mlds.end()) {
+            it = m_mlds.emplace(em_hex::pack_mac(mld->sta_mld), em_tid_link_mld_state_t()).first;
+            it->second.link_map = all;
+            it->second.all_map = all;
+        }
+        st = &it->second;
+        st->pass = pass;
+
+        // set up again, the agent maps all the TIDs to all the links of the new association
+        if (st->all_map != all) {
+            st->all_map = all;
+            st->link_map = all;
+            st->seen_ms = 0;
+        }
+
+        // nothing new on any of the links, the mapping would come out the same
+        if (newest <= st->seen_ms) {
+            m_stats.skipped++;
+            continue;
+        }
+        st->seen_ms = newest;
+        m_stats.evaluated++;
+
+        map = 0;
+        best_map = 0;
+        best_rcpi = 0;
+        for (j = 0; j < links; j++) {
+            if (mld->links[j].link_id >= EM_TID_LINK_PLANNER_MAX_LINKS) {
+                continue;
+            }
+            bit = static_cast<unsigned char> (1 << mld->links[j].link_id);
+            if ((sta_ok[j] == false) || (sta_agg[j].num < m_params.min_samples)) {
+                map |= (st->link_map & bit);
+                continue;
+            }
+            rcpi = sta_agg[j].ewma.rcpi;
+            util = (bss_ok[j] == true) ? bss_agg[j].ewma.util:0;
+            if ((best_map == 0) || (rcpi > best_rcpi)) {
+                best_map = bit;
+                best_rcpi = rcpi;
+            }
+
+            on = ((st->link_map & bit) != 0);
+            if (on == true) {
+                keep = (rcpi + m_params.rcpi_hysteresis >= m_params.rcpi_floor) &&
+                    ((m_params.util_ceiling == 0) || (util <= m_params.util_ceiling + m_params.util_hysteresis));
+            } else {
+                keep = (rcpi >= static_cast<unsigned int> (m_params.rcpi_floor) + m_params.rcpi_hysteresis) &&
+                    ((m_params.util_ceiling == 0) || (util + m_params.util_hysteresis <= m_params.util_ceiling));
+            }
+            if (keep == true) {
+                map |= bit;
+            }
+        }
+        if (map == 0) {
+            map = (best_map != 0) ? best_map:st->link_map;
+        }
+        if (map == st->link_map) {
+            continue;
+        }
+
+        // evaluated again on the next passes until the mapping is pushed
+        st->seen_ms = 0;
+        if ((st->pushed_ms != 0) && (now < st->pushed_ms + m_params.hold_ms)) {
+            m_stats.held++;
+            continue;
+        }
+        if (out >= max) {
+            continue;
+        }
+
+        d = &decisions[out++];
+        memcpy(d->ap_mld, mld->ap_mld, sizeof(mac_address_t));
+        memcpy(d->sta_mld, mld->sta_mld, sizeof(mac_address_t));
+        d->link_map = map;
+        d->default_map = (map == all);
+        m_stats.decisions++;
+    }
+
+    // forget the STA MLDs gone since
+    for (auto it = m_mlds.begin(); it != m_mlds.end();) {
+        if (it->second.pass != pass) {
+            it = m_mlds.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    return out;
+}
+
+void em_tid_link_planner_t::pushed(const em_tid_link_decision_t *decision, unsigned long long now)
+{
+    auto it = m_mlds.find(em_hex::pack_mac(decision->sta_mld));
+
+    if (it == m_mlds.end()) {
+        return;
+    }
+    it->second.link_map = decision->link_map;
+    it->second.pushed_ms = now;
+    m_stats.pushed++;
+}
+
+bool em_tid_link_planner_t::get_link_map(const unsigned char *sta_mld, unsigned char *link_map)
+{
+    auto it = m_mlds.find(em_hex::pack_mac(sta_mld));
+
+    if (it == m_mlds.end()) {
+        return false;
+    }
+    *link_map = it->second.link_map;
+
+    return true;
+}
+
+em_tid_link_planner_t::em_tid_link_planner_t()
+{
+    memset(&m_params, 0, sizeof(m_params));
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    m_params.enabled = true;
+    m_params.rcpi_floor = 60;           // -80 dBm
+    m_params.rcpi_hysteresis = 8;       // 4 dB
+    m_params.util_ceiling = 230;        // of 255
+    m_params.util_hysteresis = 20;
+    m_params.min_samples = 3;
+    m_params.hold_ms = 10000;
+}
+
+em_tid_link_planner_t::~em_tid_link_planner_t()
+{
+
+}
@@ -0,0 +1,199 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "em_topo_publisher.h"
+
+std::string em_topo_publisher_t::get_pointer(const std::string& path, const char *key)
+{
+    std::string out = path;
+
+    out += '/';
+    for (; *key != '\0'; key++) {
+        if (*key == '~') {
+            out += "~0";
+        } else if (*key == '/') {
+            out += "~1";
+        } else {
+            out += *key;
+        }
+    }
+
+    return out;
+}
+
+void em_topo_publisher_t::add_op(cJSON *patch, const char *op, const std::string& path, const cJSON *value)
+{
+    cJSON *obj = cJSON_CreateObject();
+
+    cJSON_AddStringToObject(obj, "op", op);
+    cJSON_AddStringToObject(obj, "path", path.c_str());
+    if (value != NULL) {
+        // the new document outlives the patch, reference its values instead of copying them
+        cJSON_AddItemReferenceToObject(obj, "value", const_cast<cJSON *>(value));
+    }
+    cJSON_AddItemToArray(patch, obj);
+}
+
+void em_topo_publisher_t::diff(const cJSON *from, const cJSON *to, const std::string& path, cJSON *patch)
+{
+    const cJSON *f, *t;
+    int i, num_from, num_to;
+
+    if ((from->type & 0xFF) != (to->type & 0xFF)) {
+        add_op(patch, "replace", path, to);
+        return;
+    }
+
+    if (cJSON_IsObject(from)) {
+        for (f = from->child; f != NULL; f = f->next) {
+            if ((t = cJSON_GetObjectItemCaseSensitive(to, f->string)) == NULL) {
+                add_op(patch, "remove", get_pointer(path, f->string), NULL);
+            } else {
+                diff(f, t, get_pointer(path, f->string), patch);
+            }
+        }
+        for (t = to->child; t != NULL; t = t->next) {
+            if (cJSON_GetObjectItemCaseSensitive(from, t->string) == NULL) {
+                add_op(patch, "add", get_pointer(path, t->string), t);
+            }
+        }
+    } else if (cJSON_IsArray(from)) {
+        // rows are compared by position, rows past the common length are added or removed
+        num_from = cJSON_GetArraySize(from);
+        num_to = cJSON_GetArraySize(to);
+        for (i = 0, f = from->child, t = to->child; (f != NULL) && (t != NULL); i++, f = f->next, t = t->next) {
+            diff(f, t, path + "/" + std::to_string(i), patch);
+        }
+        for (; t != NULL; i++, t = t->next) {
+            add_op(patch, "add", path + "/" + std::to_string(i), t);
+        }
+        // from the end, so that the indexes of the remaining rows do not move
+        for (i = num_from - 1; i >= num_to; i--) {
+            add_op(patch, "remove", path + "/" + std::to_string(i), NULL);
+        }
+    } else if (cJSON_Compare(from, to, true) == false) {
+        add_op(patch, "replace", path, to);
+    }
+}
+
+void em_topo_publisher_t::get_snapshot(unsigned long long now_ms, std::string& msg)
+{
+    cJSON *obj = cJSON_CreateObject();
+    char *str;
+
+    m_seq++;
+    cJSON_AddStringToObject(obj, EM_TOPO_MSG_TYPE, EM_TOPO_MSG_TYPE_SNAPSHOT);
+    cJSON_AddNumberToObject(obj, EM_TOPO_MSG_SEQ, m_seq);
+    cJSON_AddItemReferenceToObject(obj, EM_TOPO_MSG_TOPOLOGY, m_base);
+
+    str = cJSON_PrintUnformatted(obj);
+    msg = (str != NULL) ? str:"";
+    cJSON_free(str);
+    cJSON_Delete(obj);
+
+    m_num_patches = 0;
+    m_snapshot_ms = now_ms;
+    m_snapshot_len = msg.size();
+    m_stats.snapshots++;
+    m_stats.snapshot_bytes += msg.size();
+}
+
+em_topo_msg_type_t em_topo_publisher_t::update(cJSON *doc, unsigned long long now_ms, std::string& msg)
+{
+    cJSON *obj, *patch;
+    char *str;
+
+    msg.clear();
+    if (doc == NULL) {
+        return em_topo_msg_type_none;
+    }
+
+    if ((m_base != NULL) && (cJSON_Compare(m_base, doc, true) == true)) {
+        cJSON_Delete(doc);
+        m_stats.unchanged++;
+        return em_topo_msg_type_none;
+    }
+
+    if ((m_base != NULL) && (m_num_patches < EM_TOPO_SNAPSHOT_PATCHES)) {
+        patch = cJSON_CreateArray();
+        diff(m_base, doc, "", patch);
+
+        obj = cJSON_CreateObject();
+        cJSON_AddStringToObject(obj, EM_TOPO_MSG_TYPE, EM_TOPO_MSG_PATCH);
+        cJSON_AddNumberToObject(obj, EM_TOPO_MSG_SEQ, m_seq + 1);
+        cJSON_AddNumberToObject(obj, EM_TOPO_MSG_BASE_SEQ, m_seq);
+        cJSON_AddItemToObject(obj, EM_TOPO_MSG_PATCH, patch);
+
+        // the patch references values of doc, serialize it before the base is replaced
+        str = cJSON_PrintUnformatted(obj);
+        msg = (str != NULL) ? str:"";
+        cJSON_free(str);
+        cJSON_Delete(obj);
+
+        cJSON_Delete(m_base);
+        m_base = doc;
+
+        // a change of most of the document is cheaper to send whole
+        if ((msg.empty() == false) && (msg.size() < m_snapshot_len)) {
+            m_seq++;
+            m_num_patches++;
+            m_stats.patches++;
+            m_stats.patch_bytes += msg.size();
+            return em_topo_msg_type_patch;
+        }
+    } else {
+        cJSON_Delete(m_base);
+        m_base = doc;
+    }
+
+    get_snapshot(now_ms, msg);
+
+    return em_topo_msg_type_snapshot;
+}
+
+em_topo_msg_type_t em_topo_publisher_t::get_periodic(unsigned long long now_ms, std::string& msg)
+{
+    msg.clear();
+    if ((m_base == NULL) || ((now_ms - m_snapshot_ms) < EM_TOPO_SNAPSHOT_INTERVAL_MS)) {
+        return em_topo_msg_type_none;
+    }
+
+    get_snapshot(now_ms, msg);
+
+    return em_topo_msg_type_snapshot;
+}
+
+void em_topo_publisher_t::reset()
+{
+    cJSON_Delete(m_base);
+    m_base = NULL;
+    m_num_patches = 0;
+    m_snapshot_len = 0;
+}
+
+em_topo_publisher_t::em_topo_publisher_t(): m_base(NULL), m_seq(0), m_num_patches(0), m_snapshot_ms(0), m_snapshot_len(0)
+{
+    memset(&m_stats, 0, sizeof(em_topo_publisher_stats_t));
+}
+
+em_topo_publisher_t::~em_topo_publisher_t()
+{
+    cJSON_Delete(m_base);
+}
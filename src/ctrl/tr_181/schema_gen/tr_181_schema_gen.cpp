@@ -0,0 +1,363 @@
+/************************************************************************************
+  If not stated otherwise in this file or this component's LICENSE file the
+  following copyright and licenses apply:
+
+  Copyright 2025 RDK Management
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ **************************************************************************/
+
+/*
+ * Build time generator of the TR-181 schema table. Walks the Data Elements JSON schema,
+ * resolving $ref and oneOf/anyOf, and writes every element with its type, range, write
+ * permission and callback id as a static table the controller registers at start up.
+ *
+ *     tr_181_schema_gen <schema.json> <table.cpp>
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <cjson/cJSON.h>
+#include "tr_181_paths.h"
+#include "tr_181_schema.h"
+
+#define SCHEMA_ROOT_PATH    "Device.WiFi.DataElements.Network"
+
+typedef struct {
+    std::string             path;
+    tr_181_schema_type_t    type;
+    bool                    writable;
+    double                  min;
+    double                  max;
+} schema_elem_t;
+
+typedef struct {
+    const char *yang;
+    const char *tr181;
+} yang_to_tr181_map_t;
+
+static const yang_to_tr181_map_t g_yang_map[] = {
+    { "DeviceList", "Device" },
+    { "RadioList", "Radio" },
+    { "BSSList", "BSS" },
+    { "STAList", "STA" },
+    { "NetworkSSIDList", "SSID" },
+};
+
+#define CALLBACK_NAME(n, g, s)  n,
+static const char *g_cb_names[] = { TR_181_CALLBACKS(CALLBACK_NAME) };
+
+static void traverse_schema(cJSON *root, cJSON *node, const std::string& base, std::vector<schema_elem_t>& elems);
+
+// whole token replacement of the YANG list names by their TR-181 object names
+static std::string yang_to_tr181_path(const std::string& in)
+{
+    std::string out = in;
+    size_t i, pos, len;
+
+    for (i = 0; i < sizeof(g_yang_map)/sizeof(g_yang_map[0]); i++) {
+        len = strlen(g_yang_map[i].yang);
+        pos = 0;
+        while ((pos = out.find(g_yang_map[i].yang, pos)) != std::string::npos) {
+            if (((pos == 0) || (out[pos - 1] == '.')) && ((pos + len == out.size()) || (out[pos + len] == '.'))) {
+                out.replace(pos, len, g_yang_map[i].tr181);
+                pos += strlen(g_yang_map[i].tr181);
+            } else {
+                pos += len;
+            }
+        }
+    }
+
+    return out;
+}
+
+static int get_cb_id(const std::string& path)
+{
+    unsigned int i;
+
+    for (i = 0; i < sizeof(g_cb_names)/sizeof(g_cb_names[0]); i++) {
+        if (path == g_cb_names[i]) {
+            return static_cast<int>(i);
+        }
+    }
+
+    return TR_181_SCHEMA_DEFAULT_CB;
+}
+
+// resolves a reference like "#/definitions/Default8021Q_g"
+static cJSON *resolve_ref(cJSON *root, const char *ref_str)
+{
+    std::string ref, key;
+    cJSON *node = root;
+    size_t pos;
+
+    if ((ref_str == NULL) || (strncmp(ref_str, "#/", strlen("#/")) != 0)) {
+        return NULL;
+    }
+
+    ref = ref_str + strlen("#/");
+    while ((pos = ref.find('/')) != std::string::npos) {
+        key = ref.substr(0, pos);
+        ref.erase(0, pos + 1);
+        if ((node = cJSON_GetObjectItem(node, key.c_str())) == NULL) {
+            return NULL;
+        }
+    }
+    if (ref.empty() == false) {
+        node = cJSON_GetObjectItem(node, ref.c_str());
+    }
+
+    return node;
+}
+
+static bool is_null_only(cJSON *variant)
+{
+    cJSON *type = cJSON_GetObjectItem(variant, "type"), *t;
+
+    if (type == NULL) {
+        return false;
+    }
+    if (cJSON_IsString(type)) {
+        return strcmp(type->valuestring, "null") == 0;
+    }
+    if (cJSON_IsArray(type)) {
+        for (t = type->child; t != NULL; t = t->next) {
+            if (strcmp(t->valuestring, "null") != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    return false;
+}
+
+// follows $ref and the first non null variant of oneOf/anyOf, the node itself otherwise
+static cJSON *follow_ref_if_any(cJSON *root, cJSON *node)
+{
+    cJSON *ref, *comb, *it, *resolved;
+
+    if (node == NULL) {
+        return NULL;
+    }
+
+    ref = cJSON_GetObjectItem(node, "$ref");
+    if ((ref != NULL) && cJSON_IsString(ref) && ((resolved = resolve_ref(root, ref->valuestring)) != NULL)) {
+        return follow_ref_if_any(root, resolved);
+    }
+
+    if ((comb = cJSON_GetObjectItem(node, "oneOf")) == NULL) {
+        comb = cJSON_GetObjectItem(node, "anyOf");
+    }
+    if ((comb != NULL) && cJSON_IsArray(comb)) {
+        for (it = comb->child; it != NULL; it = it->next) {
+            if (is_null_only(it) == false) {
+                return follow_ref_if_any(root, it);
+            }
+        }
+    }
+
+    return node;
+}
+
+static bool schema_has_type(cJSON *schema, const char *want)
+{
+    cJSON *type = cJSON_GetObjectItem(schema, "type"), *it;
+
+    if (type == NULL) {
+        return false;
+    }
+    if (cJSON_IsString(type)) {
+        return strcmp(type->valuestring, want) == 0;
+    }
+    if (cJSON_IsArray(type)) {
+        for (it = type->child; it != NULL; it = it->next) {
+            if (strcmp(it->valuestring, want) == 0) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+static void add_elem(cJSON *schema, const std::string& path, tr_181_schema_type_t type, std::vector<schema_elem_t>& elems)
+{
+    cJSON *minimum = cJSON_GetObjectItem(schema, "minimum");
+    cJSON *maximum = cJSON_GetObjectItem(schema, "maximum");
+    cJSON *writable = cJSON_GetObjectItem(schema, "writable");
+    schema_elem_t elem;
+
+    elem.path = yang_to_tr181_path(path);
+    elem.type = type;
+    elem.writable = (writable != NULL) && (writable->type == cJSON_True);
+    elem.min = ((minimum != NULL) && cJSON_IsNumber(minimum)) ? minimum->valuedouble:0;
+    elem.max = ((maximum != NULL) && cJSON_IsNumber(maximum)) ? maximum->valuedouble:0;
+    elems.push_back(elem);
+}
+
+// an object with properties is expanded, an array is a table, anything else is a property
+static void handle_property_node(cJSON *root, const std::string& path, cJSON *schema, std::vector<schema_elem_t>& elems)
+{
+    cJSON *effective, *props, *items;
+    std::string table;
+
+    if ((effective = follow_ref_if_any(root, schema)) == NULL) {
+        return;
+    }
+
+    props = cJSON_GetObjectItem(effective, "properties");
+    if ((props != NULL) && cJSON_IsObject(props)) {
+        traverse_schema(root, effective, path, elems);
+        return;
+    }
+
+    if (schema_has_type(effective, "array") == false) {
+        add_elem(effective, path, tr_181_schema_type_property, elems);
+        return;
+    }
+
+    table = path + ".{i}";
+    add_elem(effective, table, tr_181_schema_type_table, elems);
+    if ((items = follow_ref_if_any(root, cJSON_GetObjectItem(effective, "items"))) == NULL) {
+        return;
+    }
+
+    props = cJSON_GetObjectItem(items, "properties");
+    if ((props != NULL) && cJSON_IsObject(props)) {
+        traverse_schema(root, items, table, elems);
+    } else {
+        // array of primitives, the row itself is the value
+        add_elem(items, table, tr_181_schema_type_property, elems);
+    }
+}
+
+static void traverse_schema(cJSON *root, cJSON *node, const std::string& base, std::vector<schema_elem_t>& elems)
+{
+    cJSON *effective, *props, *child;
+
+    if ((effective = follow_ref_if_any(root, node)) == NULL) {
+        return;
+    }
+
+    props = cJSON_GetObjectItem(effective, "properties");
+    if ((props == NULL) || (cJSON_IsObject(props) == false)) {
+        return;
+    }
+
+    for (child = props->child; child != NULL; child = child->next) {
+        if (child->string != NULL) {
+            handle_property_node(root, base + "." + child->string, child, elems);
+        }
+    }
+}
+
+static cJSON *read_schema(const char *file)
+{
+    std::vector<char> buf;
+    cJSON *root;
+    FILE *fp;
+    long sz;
+
+    if ((fp = fopen(file, "rb")) == NULL) {
+        printf("%s:%d: Failed to open %s\n", __func__, __LINE__, file);
+        return NULL;
+    }
+    if ((fseek(fp, 0, SEEK_END) != 0) || ((sz = ftell(fp)) < 0) || (fseek(fp, 0, SEEK_SET) != 0)) {
+        fclose(fp);
+        return NULL;
+    }
+    buf.resize(static_cast<size_t>(sz) + 1);
+    buf[fread(buf.data(), 1, static_cast<size_t>(sz), fp)] = '\0';
+    fclose(fp);
+
+    if ((root = cJSON_Parse(buf.data())) == NULL) {
+        printf("%s:%d: Failed to parse %s\n", __func__, __LINE__, file);
+    }
+
+    return root;
+}
+
+static int write_table(const char *file, const char *schema_file, const std::vector<schema_elem_t>& elems)
+{
+    std::string tmp(file);
+    unsigned int i;
+    FILE *fp;
+    bool ok;
+
+    tmp += ".tmp";
+    if ((fp = fopen(tmp.c_str(), "w")) == NULL) {
+        printf("%s:%d: Failed to open %s\n", __func__, __LINE__, tmp.c_str());
+        return -1;
+    }
+
+    fprintf(fp, "/* Generated by tr_181_schema_gen from %s, do not edit. */\n\n", schema_file);
+    fprintf(fp, "#include \"tr_181_schema.h\"\n\n");
+    fprintf(fp, "constexpr tr_181_schema_elem_t g_tr_181_schema[] = {\n");
+    for (i = 0; i < elems.size(); i++) {
+        fprintf(fp, "    { \"%s\", %s, %s, %.17g, %.17g, %d },\n", elems[i].path.c_str(),
+            (elems[i].type == tr_181_schema_type_table) ? "tr_181_schema_type_table":"tr_181_schema_type_property",
+            elems[i].writable ? "true":"false", elems[i].min, elems[i].max, get_cb_id(elems[i].path));
+    }
+    fprintf(fp, "};\n\n");
+    fprintf(fp, "constexpr unsigned int g_tr_181_schema_num = sizeof(g_tr_181_schema)/sizeof(g_tr_181_schema[0]);\n");
+
+    ok = (ferror(fp) == 0);
+    ok = (fclose(fp) == 0) && ok;
+    if ((ok == false) || (rename(tmp.c_str(), file) != 0)) {
+        printf("%s:%d: Failed to write %s\n", __func__, __LINE__, file);
+        remove(tmp.c_str());
+        return -1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<schema_elem_t> elems;
+    cJSON *root, *props, *child;
+
+    if (argc != 3) {
+        printf("usage: %s <schema.json> <table.cpp>\n", argv[0]);
+        return 1;
+    }
+    if ((root = read_schema(argv[1])) == NULL) {
+        return 1;
+    }
+
+    // the elements served are those of the top level Network object
+    if ((props = cJSON_GetObjectItem(root, "properties")) != NULL) {
+        for (child = props->child; child != NULL; child = child->next) {
+            if ((child->string != NULL) && (strstr(child->string, "Network") != NULL)) {
+                traverse_schema(root, child, SCHEMA_ROOT_PATH, elems);
+                break;
+            }
+        }
+    }
+    cJSON_Delete(root);
+
+    if (elems.empty() == true) {
+        printf("%s:%d: No element found in %s\n", __func__, __LINE__, argv[1]);
+        return 1;
+    }
+
+    if (write_table(argv[2], argv[1], elems) != 0) {
+        return 1;
+    }
+    printf("%s: %u elements of %s written to %s\n", argv[0], static_cast<unsigned int>(elems.size()), argv[1], argv[2]);
+
+    return 0;
+}
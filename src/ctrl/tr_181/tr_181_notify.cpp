@@ -0,0 +1,213 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include "tr_181_notify.h"
+
+int tr_181_notify_t::subscribe(const char *path)
+{
+    tr_181_notify_sub_t *sub;
+
+    if ((path == NULL) || (*path == '\0')) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&m_lock);
+    sub = &m_subs[path];
+    sub->refs++;
+    m_stats.num_subs = static_cast<unsigned int>(m_subs.size());
+    pthread_mutex_unlock(&m_lock);
+
+    return 0;
+}
+
+int tr_181_notify_t::unsubscribe(const char *path)
+{
+    std::unordered_map<std::string, tr_181_notify_sub_t>::iterator it;
+    int ret = -1;
+
+    if (path == NULL) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&m_lock);
+    if ((it = m_subs.find(path)) != m_subs.end()) {
+        if (--it->second.refs == 0) {
+            m_subs.erase(it);
+        }
+        m_stats.num_subs = static_cast<unsigned int>(m_subs.size());
+        ret = 0;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return ret;
+}
+
+bool tr_181_notify_t::has_subs()
+{
+    bool ret;
+
+    pthread_mutex_lock(&m_lock);
+    ret = (m_subs.empty() == false);
+    pthread_mutex_unlock(&m_lock);
+
+    return ret;
+}
+
+unsigned int tr_181_notify_t::mark_changed(const char *prefix)
+{
+    std::unordered_map<std::string, tr_181_notify_sub_t>::iterator it;
+    size_t len = strlen(prefix);
+    unsigned int num = 0;
+
+    pthread_mutex_lock(&m_lock);
+    for (it = m_subs.begin(); it != m_subs.end(); it++) {
+        if (it->first.compare(0, len, prefix) != 0) {
+            continue;
+        }
+        if (it->second.changed == true) {
+            m_stats.coalesced++;
+            continue;
+        }
+        it->second.changed = true;
+        m_changed.push_back(it->first);
+        m_stats.marked++;
+        num++;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+unsigned int tr_181_notify_t::get_batch(unsigned long long now_ms, std::vector<std::string>& paths)
+{
+    std::unordered_map<std::string, tr_181_notify_sub_t>::iterator it;
+    unsigned int i;
+
+    paths.clear();
+
+    pthread_mutex_lock(&m_lock);
+    if ((m_changed.empty() == true) || ((now_ms - m_last_ms) < m_interval_ms)) {
+        pthread_mutex_unlock(&m_lock);
+        return 0;
+    }
+
+    for (i = 0; i < m_changed.size(); i++) {
+        // dropped, or dropped and subscribed again, since it was marked
+        if (((it = m_subs.find(m_changed[i])) == m_subs.end()) || (it->second.changed == false)) {
+            continue;
+        }
+        it->second.changed = false;
+        paths.push_back(m_changed[i]);
+    }
+    m_changed.clear();
+    m_last_ms = now_ms;
+    m_stats.batches++;
+    pthread_mutex_unlock(&m_lock);
+
+    return static_cast<unsigned int>(paths.size());
+}
+
+bool tr_181_notify_t::update_value(const char *path, const std::string& value)
+{
+    std::unordered_map<std::string, tr_181_notify_sub_t>::iterator it;
+    bool ret = false;
+
+    pthread_mutex_lock(&m_lock);
+    if ((it = m_subs.find(path)) != m_subs.end()) {
+        if ((it->second.published == false) || (it->second.value != value)) {
+            it->second.value = value;
+            it->second.published = true;
+            m_stats.published++;
+            ret = true;
+        } else {
+            m_stats.unchanged++;
+        }
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return ret;
+}
+
+int tr_181_notify_t::set_interval(unsigned int interval_ms)
+{
+    if (interval_ms < TR_181_NOTIFY_MIN_INTERVAL_MS) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&m_lock);
+    m_interval_ms = interval_ms;
+    pthread_mutex_unlock(&m_lock);
+
+    return 0;
+}
+
+unsigned int tr_181_notify_t::get_interval()
+{
+    unsigned int ret;
+
+    pthread_mutex_lock(&m_lock);
+    ret = m_interval_ms;
+    pthread_mutex_unlock(&m_lock);
+
+    return ret;
+}
+
+void tr_181_notify_t::get_stats(tr_181_notify_stats_t *stats)
+{
+    pthread_mutex_lock(&m_lock);
+    *stats = m_stats;
+    pthread_mutex_unlock(&m_lock);
+}
+
+std::string tr_181_notify_t::get_template(const char *path)
+{
+    std::string out;
+    const char *seg, *end;
+
+    for (seg = path; *seg != '\0'; seg = (*end == '.') ? end + 1:end) {
+        if ((end = strchr(seg, '.')) == NULL) {
+            end = seg + strlen(seg);
+        }
+        if (seg != path) {
+            out += '.';
+        }
+        // a segment of digits only is an instance number
+        if ((end > seg) && (strspn(seg, "0123456789") == static_cast<size_t>(end - seg))) {
+            out += "{i}";
+        } else {
+            out.append(seg, static_cast<size_t>(end - seg));
+        }
+    }
+    if ((seg > path) && (seg[-1] == '.')) {
+        out += '.';
+    }
+
+    return out;
+}
+
+tr_181_notify_t::tr_181_notify_t(): m_subs(), m_changed(), m_interval_ms(TR_181_NOTIFY_DEF_INTERVAL_MS), m_last_ms(0)
+{
+    pthread_mutex_init(&m_lock, NULL);
+    memset(&m_stats, 0, sizeof(tr_181_notify_stats_t));
+}
+
+tr_181_notify_t::~tr_181_notify_t()
+{
+    pthread_mutex_destroy(&m_lock);
+}
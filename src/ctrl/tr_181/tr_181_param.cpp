@@ -282,18 +282,18 @@ dm_sta_t *get_dm_bh_sta(dm_easy_mesh_t *dm, dm_radio_t *radio)
             continue;
         }
 
-        dm_sta_t *sta = static_cast<dm_sta_t *> (hash_map_get_first(sdm->m_sta_map));
+        dm_sta_t *sta = static_cast<dm_sta_t *> (sdm->m_sta_map->get_first());
         while (sta != NULL) {
             em_sta_info_t *si = sta->get_sta_info();
             if (si->associated == 0) {
-                sta = static_cast<dm_sta_t *> (hash_map_get_next(sdm->m_sta_map, sta));
+                sta = static_cast<dm_sta_t *> (sdm->m_sta_map->get_next(sta));
                 continue;
             }
             //si->radiomac; radio->m_radio_info.
             if (memcmp(di->backhaul_mac.mac, si->bssid, sizeof(si->bssid)) == 0) {
                 return sta;
             }
-            sta = static_cast<dm_sta_t *> (hash_map_get_next(sdm->m_sta_map, sta));
+            sta = static_cast<dm_sta_t *> (sdm->m_sta_map->get_next(sta));
         }
 
         sdm = g_ctrl.get_next_dm(sdm);
@@ -388,12 +388,12 @@ dm_sta_t *get_dm_sta(dm_easy_mesh_t *dm, dm_bss_t *bss, char *instance, bool is_
         dm_easy_mesh_t::string_to_macbytes(instance, mac);
     }
 
-    dm_sta_t *sta = static_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_map));
+    dm_sta_t *sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_first());
     while (sta != NULL) {
         em_sta_info_t *si = sta->get_sta_info();
         if (si->associated == 0 ||
             memcmp(bi->bssid.mac, si->bssid, sizeof(si->bssid)) != 0) {
-            sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_map, sta));
+            sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
             continue;
         }
         ++scnt;
@@ -406,7 +406,7 @@ dm_sta_t *get_dm_sta(dm_easy_mesh_t *dm, dm_bss_t *bss, char *instance, bool is_
                 return sta;
             }
         }
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_map, sta));
+        sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
     }
 
     return NULL;
@@ -1717,6 +1717,22 @@ bus_error_t sta_get_inner(char *event_name, raw_data_t *p_data, bus_user_data_t
         rc = raw_data_set(p_data, 0U);
     } else if (strcmp(param, "RSNCapabilities") == 0) {
         rc = raw_data_set(p_data, 0U);
+    } else if (strcmp(param, "X_RDK_RCPIAverage") == 0) {
+        em_metrics_aggregate_t agg;
+        if (g_ctrl.get_sta_history()->get_aggregate(si->id, 0, em_metrics_history_t::now_ms(), &agg) == false) {
+            agg.ewma.rcpi = si->rcpi;
+        }
+        rc = raw_data_set(p_data, static_cast<uint32_t>(agg.ewma.rcpi));
+    } else if (strcmp(param, "X_RDK_RCPIHistory") == 0) {
+        // comma separated RCPI samples, oldest first
+        em_metrics_sample_t samples[EM_METRICS_HISTORY_LEN];
+        char hist[EM_METRICS_HISTORY_LEN * 4 + 1] = { 0 };
+        unsigned int i, num, off = 0;
+        num = g_ctrl.get_sta_history()->get_samples(si->id, samples, EM_METRICS_HISTORY_LEN);
+        for (i = 0; i < num; i++) {
+            off += static_cast<unsigned int>(snprintf(hist + off, sizeof(hist) - off, (i == 0) ? "%u":",%u", samples[i].rcpi));
+        }
+        rc = raw_data_set(p_data, hist);
     } else {
         printf("Invalid param: %s\n", param);
         rc = bus_error_invalid_input;
@@ -1730,12 +1746,12 @@ bus_error_t sta_tget_params(dm_easy_mesh_t *dm, const char *root, em_bss_info_t
     bus_error_t rc = bus_error_success;
 
     unsigned int idx = 0;
-    dm_sta_t *sta = static_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_map));
+    dm_sta_t *sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_first());
     while (sta != NULL) {
         em_sta_info_t *si = sta->get_sta_info();
         if (si->associated == 0 ||
             memcmp(bi->bssid.mac, si->bssid, sizeof(si->bssid)) != 0) {
-            sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_map, sta));
+            sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
             continue;
         }
         ++idx;
@@ -1765,7 +1781,7 @@ bus_error_t sta_tget_params(dm_easy_mesh_t *dm, const char *root, em_bss_info_t
         property_append_tail(property, root, idx, "PairwiseAKM", 0U);
         property_append_tail(property, root, idx, "PairwiseCipher", 0U);
         property_append_tail(property, root, idx, "RSNCapabilities", 0U);
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_map, sta));
+        sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
     }
 
     return rc;
@@ -1828,7 +1844,7 @@ bus_error_t bus_get_cb_fwd(char *event_name, raw_data_t *p_data, bus_user_data_t
     uintptr_t buf;
 
     do {
-        req = (em_event_t *) malloc(sizeof(em_event_t));
+        req = g_ctrl.alloc_event(0);
         if (!req) {
             err = bus_error_out_of_resources;
             break;
@@ -2078,6 +2094,8 @@ bus_error_t sta_tget(char *event_name, raw_data_t *p_data, bus_user_data_t *user
 #define DE_STA_PAIRWSAKM        DE_BSS_STA              "PairwiseAKM"
 #define DE_STA_PAIRWSCIPHER     DE_BSS_STA              "PairwiseCipher"
 #define DE_STA_RSNCAPS          DE_BSS_STA              "RSNCapabilities"
+#define DE_STA_X_RCPIAVG        DE_BSS_STA              "X_RDK_RCPIAverage"
+#define DE_STA_X_RCPIHIST       DE_BSS_STA              "X_RDK_RCPIHistory"
 /* Device.WiFi.DataElements.Network.Device.Radio.BSS.STA.WiFi6Capabilities */
 #define DE_STA_WIFI6CAPS        DE_BSS_STA              "WiFi6Capabilities."
 #define DE_STAWF6CAPS_HE160     DE_STA_WIFI6CAPS        "HE160"
@@ -2180,7 +2198,9 @@ int em_ctrl_t::tr181_reg_data_elements(bus_handle_t *bus_handle)
         ELEMENT_PROPERTY(DE_STA_HOSTNAME,      sta_get, bus_data_type_string),
         ELEMENT_PROPERTY(DE_STA_PAIRWSAKM,     sta_get, bus_data_type_string),
         ELEMENT_PROPERTY(DE_STA_PAIRWSCIPHER,  sta_get, bus_data_type_string),
-        ELEMENT_PROPERTY(DE_STA_RSNCAPS,       sta_get, bus_data_type_uint32)
+        ELEMENT_PROPERTY(DE_STA_RSNCAPS,       sta_get, bus_data_type_uint32),
+        ELEMENT_PROPERTY(DE_STA_X_RCPIAVG,     sta_get, bus_data_type_uint32),
+        ELEMENT_PROPERTY(DE_STA_X_RCPIHIST,    sta_get, bus_data_type_string)
     };
 
     bus_desc = get_bus_descriptor();
@@ -27,6 +27,7 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include "tr_181.h"
+#include "tr_181_schema.h"
 // #include "wfa_data_model_parser.h"
 // #include "wfa_data_model.h"
 #include "util.h"
@@ -59,203 +60,38 @@ void tr_181_t::init(void* ptr)
     register_wfa_dml();
 }
 
-int tr_181_t::wfa_set_bus_callbackfunc_pointers(const char *full_namespace, bus_callback_table_t *cb_table)
+#define CALLBACK_NAME(n, g, s)      n,
+#define CALLBACK_ELEMENT(n, g, s)   ELEMENT(n, CALLBACK_GETTER_SETTER_SUB(g, s, default_event_sub_handler)),
+
+int tr_181_t::wfa_set_bus_callbackfunc_pointers(int cb_id, bus_callback_table_t *cb_table)
 {
-    bus_data_cb_func_t bus_data_cb[] = {
-        ELEMENT(DE_NETWORK_ID,            CALLBACK_GETTER(network_get)),
-        ELEMENT(DE_NETWORK_CTRLID,        CALLBACK_GETTER(network_get)),
-        ELEMENT(DE_NETWORK_COLAGTID,      CALLBACK_GETTER(network_get)),
-        ELEMENT(DE_NETWORK_DEVNOE,        CALLBACK_GETTER(network_get)),
-        ELEMENT(DE_SSID_TABLE,            CALLBACK_GETTER(ssid_tget)),
-        ELEMENT(DE_SSID_SSID,             CALLBACK_GETTER(ssid_get)),
-        ELEMENT(DE_SSID_BAND,             CALLBACK_GETTER(ssid_get)),
-        ELEMENT(DE_SSID_ENABLE,           CALLBACK_GETTER(ssid_get)),
-        ELEMENT(DE_SSID_AKMALLOWE,        CALLBACK_GETTER(ssid_get)),
-        ELEMENT(DE_SSID_SUITESEL,         CALLBACK_GETTER(ssid_get)),
-        ELEMENT(DE_SSID_ADVENABLED,       CALLBACK_GETTER(ssid_get)),
-        ELEMENT(DE_SSID_MFPCONFIG,        CALLBACK_GETTER(ssid_get)),
-        ELEMENT(DE_SSID_MOBDOMAIN,        CALLBACK_GETTER(ssid_get)),
-        ELEMENT(DE_SSID_HAULTYPE,         CALLBACK_GETTER(ssid_get)),
-        ELEMENT(DE_DEVICE_TABLE,          CALLBACK_GETTER(device_tget)),
-        ELEMENT(DE_RADIO_TABLE,           CALLBACK_GETTER(radio_tget)),
-        ELEMENT(DE_BSS_TABLE,             CALLBACK_GETTER(bss_tget)),
-        ELEMENT(DE_STA_TABLE,             CALLBACK_GETTER(sta_tget)),
-        ELEMENT(DE_DEVICE_ID,                     CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_MAPCAP,                 CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_NUMRADIO,               CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_COLLINT,                CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_RUASSOC,                CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_MAXRRATE,               CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_MAPPROF,                CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_APMERINT,               CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_MANUFACT,               CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_SERIALNO,               CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_MFCMODEL,               CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_SWVERSION,              CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_EXECENV,                CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_LSDSTALIST,             CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_BTMSDSTALIST,           CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_MAXVIDS,                CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_BPRIO,                  CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_EPRIO,                  CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_TSEPPOLI,               CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_STVMAP,                 CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_DSCPM,                  CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_MAXPRIRULE,             CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_COUNTRCODE,             CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_PRIOSUPP,               CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_REPINDSCAN,             CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_TRASEPALW,              CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_SERPRIOALW,             CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_STASDISALW,             CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_DFSENABLE,              CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_MAXUSASSOCREPRATE,      CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_STASSTATE,              CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_COORCACALW,             CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_CONOPMODE,              CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_BHMACADDR,              CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_BHDMACADDR,             CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_BHPHYRATE,              CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_TRSEPCAP,               CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_EASYCCAP,               CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_TESTCAP,                CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_BSTAMLDMACLINK,         CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_MACNUMMLDS,             CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_BHALID,                 CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_TIDLMAP,                CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_ASSOCSTAREPINT,         CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_BHMEDIATYPE,            CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_RADIONOE,               CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_CACSTATNOE,             CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_DEVICE_BHDOWNNOE,              CALLBACK_GETTER(device_get)),
-        ELEMENT(DE_RADIO_ID,               CALLBACK_GETTER(radio_get)),
-        ELEMENT(DE_RADIO_ENABLED,          CALLBACK_GETTER(radio_get)),
-        ELEMENT(DE_RADIO_NOISE,            CALLBACK_GETTER(radio_get)),
-        ELEMENT(DE_RADIO_UTILIZATION,      CALLBACK_GETTER(radio_get)),
-        ELEMENT(DE_RADIO_TRANSMIT,         CALLBACK_GETTER(radio_get)),
-        ELEMENT(DE_RADIO_RECEIVESELF,      CALLBACK_GETTER(radio_get)),
-        ELEMENT(DE_RADIO_RECEIVEOTHER,     CALLBACK_GETTER(radio_get)),
-        ELEMENT(DE_RADIO_CHIPVENDOR,       CALLBACK_GETTER(radio_get)),
-        ELEMENT(DE_RADIO_CURROPNOE,        CALLBACK_GETTER(radio_get)),
-        ELEMENT(DE_RADIO_BSSNOE,           CALLBACK_GETTER(radio_get)),
-        ELEMENT(DE_RCAPS_HTCAPS,           CALLBACK_GETTER(rcaps_get)),
-        ELEMENT(DE_RCAPS_VHTCAPS,          CALLBACK_GETTER(rcaps_get)),
-        ELEMENT(DE_RCAPS_CAPOPNOE,         CALLBACK_GETTER(rcaps_get)),
-        ELEMENT(DE_CAPS_WF6AP,             CALLBACK_GETTER(wf6ap_tget)),
-        ELEMENT(DE_WF6AP_HE160,            CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_HE8080,           CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_MCSNSS,           CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_SU_BFER,          CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_SU_BFEE,          CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_MU_BFER,          CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_BFEE_80L,         CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_BFEE_80A,         CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_UL_MUMIMO,        CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_UL_OFDMA,         CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_DL_OFDMA,         CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_MAX_DL_MUMIMO,    CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_MAX_UL_MUMIMO,    CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_MAX_DL_OF,        CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_MAX_UL_OF,        CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_RTS,              CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_MU_RTS,           CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_MULTI_BSS,        CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_MU_EDCA,          CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_TWT_REQ,          CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_TWT_RSP,          CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_SPAT_REUSE,       CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_WF6AP_ANT_CH_USE,       CALLBACK_GETTER(wf6ap_get)),
-        ELEMENT(DE_CAPS_WF7AP,             CALLBACK_GETTER(wf7ap_tget)),
-        ELEMENT(DE_WF7AP_EMLMR,            CALLBACK_GETTER(wf7ap_get)),
-        ELEMENT(DE_WF7AP_EMLSR,            CALLBACK_GETTER(wf7ap_get)),
-        ELEMENT(DE_WF7AP_STR,              CALLBACK_GETTER(wf7ap_get)),
-        ELEMENT(DE_WF7AP_NSTR,             CALLBACK_GETTER(wf7ap_get)),
-        ELEMENT(DE_WF7AP_TID_MAP,          CALLBACK_GETTER(wf7ap_get)),
-        ELEMENT(DE_CUROP_TABLE,            CALLBACK_GETTER(curops_tget)),
-        ELEMENT(DE_CUROP_CLASS,            CALLBACK_GETTER(curops_get)),
-        ELEMENT(DE_CUROP_CHANNEL,          CALLBACK_GETTER(curops_get)),
-        ELEMENT(DE_CUROP_TXPOWER,          CALLBACK_GETTER(curops_get)),
-        ELEMENT(DE_BSS_BSSID,              CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_SSID,               CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_ENABLED,            CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_LASTCHG,            CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_TS,                 CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_UCAST_TX,           CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_UCAST_RX,           CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_MCAST_TX,           CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_MCAST_RX,           CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_BCAST_TX,           CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_BCAST_RX,           CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_EST_BE,             CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_EST_BK,             CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_EST_VI,             CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_EST_VO,             CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_BYTCNTUNITS,        CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_PROF1_DIS,          CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_PROF2_DIS,          CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_ASSOC_STAT,         CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_BHAULUSE,           CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_FHAULUSE,           CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_R1_DIS,             CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_R2_DIS,             CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_MULTI_BSSID,        CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_TX_BSSID,           CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_FHAULAKMS,          CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_BHAULAKMS,          CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_QM_DESC,            CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_NUM_STA,            CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_LINK_IMM,           CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_FH_SUITE,           CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_BSS_BH_SUITE,           CALLBACK_GETTER(bss_get)),
-        ELEMENT(DE_STA_MACADDR,            CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_HTCAPS,             CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_VHTCAPS,            CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_CLIENTCAPS,         CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_LSTDTADLR,          CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_LSTDTAULR,          CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_UTILRECV,           CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_UTILTRMT,           CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_ESTMACDTARDL,       CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_ESTMACDTARUL,       CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_SIGNALSTR,          CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_LASTCONNTIME,       CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_BYTESSNT,           CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_BYTESRCV,           CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_PCKTSSNT,           CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_PCKTSRCV,           CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_ERRSSNT,            CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_ERRSRCV,            CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_RETRANSCNT,         CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_IPV4ADDR,           CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_IPV6ADDR,           CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_HOSTNAME,           CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_PAIRWSAKM,          CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_PAIRWSCIPHER,       CALLBACK_GETTER(sta_get)),
-        ELEMENT(DE_STA_RSNCAPS,            CALLBACK_GETTER(sta_get))
+    static const bus_data_cb_func_t bus_data_cb[] = { TR_181_CALLBACKS(CALLBACK_ELEMENT) };
+    static const bus_callback_table_t bus_default_cb = {
+        default_get_param_value, default_set_param_value, default_table_add_row_handler,
+        default_table_remove_row_handler, default_event_sub_handler, NULL
     };
 
+    if ((cb_id < 0) || (static_cast<unsigned int>(cb_id) >= ARRAY_SIZE(bus_data_cb))) {
+        memcpy(cb_table, &bus_default_cb, sizeof(bus_callback_table_t));
+    } else {
+        memcpy(cb_table, &bus_data_cb[cb_id].cb_func, sizeof(bus_callback_table_t));
+    }
 
-    bus_data_cb_func_t bus_default_data_cb = { const_cast<char*>(" "),
-        { default_get_param_value, default_set_param_value, default_table_add_row_handler,
-          default_table_remove_row_handler, default_event_sub_handler, NULL }
-    };
+    return RETURN_OK;
+}
 
-    uint32_t index = 0;
-    bool     table_found = false;
+int tr_181_t::wfa_set_bus_callbackfunc_pointers(const char *full_namespace, bus_callback_table_t *cb_table)
+{
+    static const char *const cb_names[] = { TR_181_CALLBACKS(CALLBACK_NAME) };
+    unsigned int i;
 
-    for (index = 0; index < static_cast<uint32_t>(ARRAY_SIZE(bus_data_cb)); index++) {
-        if (strcmp(full_namespace, bus_data_cb[index].cb_table_name) == 0) {
-            memcpy(cb_table, &bus_data_cb[index].cb_func, sizeof(bus_callback_table_t));
-            table_found = true;
-            break;
+    for (i = 0; i < ARRAY_SIZE(cb_names); i++) {
+        if (strcmp(full_namespace, cb_names[i]) == 0) {
+            return wfa_set_bus_callbackfunc_pointers(static_cast<int>(i), cb_table);
         }
     }
 
-    if (table_found == false) {
-        memcpy(cb_table, &bus_default_data_cb.cb_func, sizeof(bus_callback_table_t));
-    }
-
-    return RETURN_OK;
+    return wfa_set_bus_callbackfunc_pointers(TR_181_SCHEMA_DEFAULT_CB, cb_table);
 }
 
 int tr_181_t::wfa_bus_register_namespace(char *full_namespace, bus_element_type_t element_type,
@@ -445,9 +281,27 @@ bus_error_t tr_181_t::default_table_remove_row_handler(const char* rowName) {
 
 bus_error_t tr_181_t::default_event_sub_handler(char* eventName, bus_event_sub_action_t action, 
                                                int32_t interval, bool* autoPublish) {
-    (void)autoPublish;
+    em_ctrl_t *em_ctrl = em_ctrl_t::get_em_ctrl_instance();
+    tr_181_notify_t *notify;
+    int ret;
 
-    return bus_error_success;
+    if ((eventName == NULL) || (em_ctrl == NULL)) {
+        return bus_error_invalid_input;
+    }
+
+    // the controller publishes the values that changed, the bus must not poll the getter
+    if (autoPublish != NULL) {
+        *autoPublish = false;
+    }
+
+    notify = em_ctrl->get_dm_ctrl()->get_notify();
+    if (action == bus_event_action_subscribe) {
+        ret = notify->subscribe(eventName);
+    } else {
+        ret = notify->unsubscribe(eventName);
+    }
+
+    return (ret == 0) ? bus_error_success:bus_error_invalid_input;
 }
 
 
@@ -712,331 +566,163 @@ bus_error_t tr_181_t::sta_tget(char *event_name, raw_data_t *p_data, bus_user_da
     return bus_error_general;
 }
 
-bus_error_t tr_181_t::wifi_elem_num_of_table_row(char* event_name, uint32_t* table_row_size)
+bus_error_t tr_181_t::orchdiag_get(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
 {
-    // Return 0 rows for all tables for now
-    if (table_row_size != NULL) {
-        *table_row_size = 0;
+    em_ctrl_t *em_ctrl = em_ctrl_t::get_em_ctrl_instance();
+
+    if (em_ctrl != NULL)
+    {
+        return em_ctrl->get_dm_ctrl()->orchdiag_get(event_name, p_data);
     }
 
-    return bus_error_success;
+    return bus_error_general;
 }
 
-//Helper to convert YANG path to TR-181 path
-std::string tr_181_t::yang_to_tr181_path(const std::string& in)
+bus_error_t tr_181_t::perf_get(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
 {
-    std::string out = in;
-    em_printfout("Converting YANG path: %s", in.c_str());
-
-    for (int i = 0; g_yang_map[i].yang; ++i) {
-        const std::string from = g_yang_map[i].yang;
-        const std::string to = g_yang_map[i].tr181;
-
-        size_t pos = 0;
-        while ((pos = out.find(from, pos)) != std::string::npos) {
-            /* ensure whole-token replacement */
-            bool left_ok = (pos == 0 || out[pos - 1] == '.');
-            bool right_ok = (pos + from.size() == out.size() ||
-                              out[pos + from.size()] == '.');
-
-            if (left_ok && right_ok) {
-                out.replace(pos, from.size(), to);
-                pos += to.size();
-            } else {
-                pos += from.size();
-            }
-        }
+    em_ctrl_t *em_ctrl = em_ctrl_t::get_em_ctrl_instance();
+
+    if (em_ctrl != NULL)
+    {
+        return em_ctrl->get_dm_ctrl()->perf_get(event_name, p_data);
     }
 
-    return out;
+    return bus_error_general;
 }
 
-// Resolve $ref if present on the node; otherwise return the node itself.
-cJSON* tr_181_t::follow_ref_if_any(cJSON* root, cJSON* node)
+bus_error_t tr_181_t::mem_get(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
 {
-    if (!node) return nullptr;
-
-    /* resolve $ref */
-    cJSON* ref = cJSON_GetObjectItem(node, "$ref");
-    if (ref && cJSON_IsString(ref)) {
-        cJSON* resolved = resolve_ref(root, ref->valuestring);
-        if (resolved)
-            return follow_ref_if_any(root, resolved);
-    }
+    em_ctrl_t *em_ctrl = em_ctrl_t::get_em_ctrl_instance();
 
-    /* unwrap oneOf / anyOf, skip null */
-    cJSON* comb = cJSON_GetObjectItem(node, "oneOf");
-    if (!comb)
-        comb = cJSON_GetObjectItem(node, "anyOf");
-
-    if (comb && cJSON_IsArray(comb)) {
-        cJSON* it = comb->child;
-        while (it) {
-            cJSON* type = cJSON_GetObjectItem(it, "type");
-
-            /* skip null-only variants */
-            if (type) {
-                if (cJSON_IsString(type) &&
-                    strcmp(type->valuestring, "null") == 0) {
-                    it = it->next;
-                    continue;
-                }
-                if (cJSON_IsArray(type)) {
-                    bool onlyNull = true;
-                    cJSON* t = type->child;
-                    while (t) {
-                        if (strcmp(t->valuestring, "null") != 0) {
-                            onlyNull = false;
-                            break;
-                        }
-                        t = t->next;
-                    }
-                    if (onlyNull) {
-                        it = it->next;
-                        continue;
-                    }
-                }
-            }
-            return follow_ref_if_any(root, it);
-        }
+    if (em_ctrl != NULL)
+    {
+        return em_ctrl->get_dm_ctrl()->mem_get(event_name, p_data);
     }
-    return node;
+
+    return bus_error_general;
 }
 
-// ------------------------------------------------------------
-// Resolve $ref like "#/definitions/Default8021Q_g"
-// ------------------------------------------------------------
-cJSON* tr_181_t::resolve_ref(cJSON* root, const char* refStr)
+bus_error_t tr_181_t::mem_set(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
 {
-    if (!root || !refStr || refStr[0] != '#') return nullptr;
-
-    std::string ref(refStr);
-    // strip "#/"
-    if (ref.rfind("#/", 0) == 0) ref = ref.substr(2);
+    em_ctrl_t *em_ctrl = em_ctrl_t::get_em_ctrl_instance();
 
-    cJSON* node = root;
-    size_t pos = 0;
-    while ((pos = ref.find('/')) != std::string::npos)
+    if (em_ctrl != NULL)
     {
-        std::string key = ref.substr(0, pos);
-        ref.erase(0, pos + 1);
-        node = cJSON_GetObjectItem(node, key.c_str());
-        if (!node) return nullptr;
+        return em_ctrl->get_dm_ctrl()->mem_set(event_name, p_data);
     }
-    if (!ref.empty())
-        node = cJSON_GetObjectItem(node, ref.c_str());
 
-    return node;
+    return bus_error_general;
 }
 
-// ------------------------------------------------------------
-// Extract min/max range, type, read/write from leaf node
-// ------------------------------------------------------------
-void tr_181_t::parse_property_constraints(cJSON* schemaNode, data_model_properties_t& props)
+bus_error_t tr_181_t::subtree_get(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
 {
-    // min / max from JSON schema
-    cJSON* minimum = cJSON_GetObjectItem(schemaNode, "minimum");
-    cJSON* maximum = cJSON_GetObjectItem(schemaNode, "maximum");
-
-    if (minimum && cJSON_IsNumber(minimum))
-        props.min_data_range = minimum->valuedouble;
+    em_ctrl_t *em_ctrl = em_ctrl_t::get_em_ctrl_instance();
 
-    if (maximum && cJSON_IsNumber(maximum))
-        props.max_data_range = maximum->valuedouble;
-}
+    if (em_ctrl != NULL)
+    {
+        return em_ctrl->get_dm_ctrl()->subtree_get(event_name, p_data);
+    }
 
-void tr_181_t::parse_readwrite(cJSON* schemaNode, data_model_properties_t& props)
-{
-    cJSON* writable = cJSON_GetObjectItem(schemaNode, "writable");
-    if (writable && writable->type == cJSON_True)
-        props.data_permission = 1;
-    else
-        props.data_permission = 0;
+    return bus_error_general;
 }
 
-bool tr_181_t::schema_has_type(cJSON* schema, const char* want)
+bus_error_t tr_181_t::subtree_set(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
 {
-    if (!schema) return false;
-
-    cJSON* type = cJSON_GetObjectItem(schema, "type");
-    if(!type) return false;
-
-    if(cJSON_IsString(type))
-        return strcmp(type->valuestring, want) == 0;
+    em_ctrl_t *em_ctrl = em_ctrl_t::get_em_ctrl_instance();
 
-    if(cJSON_IsArray(type)) {
-        cJSON* it = type->child;
-        while(it) {
-            if(strcmp(it->valuestring, want) == 0)
-                return true;
-            it = it->next;
-        }
+    if (em_ctrl != NULL)
+    {
+        return em_ctrl->get_dm_ctrl()->subtree_set(event_name, p_data);
     }
-    return false;
+
+    return bus_error_general;
 }
 
-// ------------------------------------------------------------
-// Handle ANY property under an object: decide if TABLE or PROPERTY
-// ------------------------------------------------------------
-void tr_181_t::handle_property_node(cJSON* root, const std::string& fullPath, cJSON* propertySchema)
+bus_error_t tr_181_t::notify_get(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
 {
-    if (!propertySchema) return;
-
-    bus_callback_table_t cbTable = {};
-    data_model_properties_t data_model_value;
-    memset(&data_model_value, 0, sizeof(data_model_value));
-
-    // 1) follow top-level $ref / combiners if present
-    cJSON* effective = follow_ref_if_any(root, propertySchema);
-    if (!effective) return;
+    em_ctrl_t *em_ctrl = em_ctrl_t::get_em_ctrl_instance();
 
-    // 2) If effective has properties -> expand (this handles $ref -> object with properties)
-    cJSON* propsObj = cJSON_GetObjectItem(effective, "properties");
-    if (propsObj && cJSON_IsObject(propsObj)) {
-        traverse_schema(root, effective, fullPath);
-        return;
+    if (em_ctrl != NULL)
+    {
+        return em_ctrl->get_dm_ctrl()->notify_get(event_name, p_data);
     }
 
-    // 3) If type is array -> register TABLE and examine items
-    if (schema_has_type(effective, "array")) {
-        std::string tableName = fullPath + ".{i}";
+    return bus_error_general;
+}
 
-        // reset and fill constraints for the array property itself
-        memset(&data_model_value, 0, sizeof(data_model_value));
-        parse_property_constraints(effective, data_model_value);
-        parse_readwrite(effective, data_model_value);
-        std::string tr181Path = yang_to_tr181_path(tableName);
-        wfa_set_bus_callbackfunc_pointers(tr181Path.c_str(), &cbTable);
-        wfa_bus_register_namespace(const_cast<char*>(tr181Path.c_str()), bus_element_type_table, cbTable, data_model_value, 1);
-
-        // now inspect items
-        cJSON* items = cJSON_GetObjectItem(effective, "items");
-        if (!items) return;
-
-        cJSON* itemsEff = follow_ref_if_any(root, items);
-        if (!itemsEff) return;
-
-        cJSON* itemProps = cJSON_GetObjectItem(itemsEff, "properties");
-        if (itemProps && cJSON_IsObject(itemProps)) {
-            // expand row children under tableName
-            traverse_schema(root, itemsEff, tableName);
-        } else {
-            // primitive array -> register the row as property
-            memset(&data_model_value, 0, sizeof(data_model_value));
-            parse_property_constraints(itemsEff, data_model_value);
-            parse_readwrite(itemsEff, data_model_value);
-            std::string tr181Path = yang_to_tr181_path(tableName);
-            wfa_set_bus_callbackfunc_pointers(tr181Path.c_str(), &cbTable);
-            wfa_bus_register_namespace(const_cast<char*>(tr181Path.c_str()), bus_element_type_property, cbTable, data_model_value, 1);
-        }
-        return;
-    }
+bus_error_t tr_181_t::notify_set(char *event_name, raw_data_t *p_data, bus_user_data_t *user_data)
+{
+    em_ctrl_t *em_ctrl = em_ctrl_t::get_em_ctrl_instance();
 
-    // 4) If type is object (but had no direct properties above),
-    // try to resolve any nested $ref and check again
-    if (schema_has_type(effective, "object")) {
-        // we've already tried follow_ref_if_any at top-level; if still no properties, treat as leaf object
-        memset(&data_model_value, 0, sizeof(data_model_value));
-        parse_property_constraints(effective, data_model_value);
-        parse_readwrite(effective, data_model_value);
-        std::string tr181Path = yang_to_tr181_path(fullPath);
-        wfa_set_bus_callbackfunc_pointers(tr181Path.c_str(), &cbTable);
-        wfa_bus_register_namespace(const_cast<char*>(tr181Path.c_str()), bus_element_type_property, cbTable, data_model_value, 1);
-        return;
+    if (em_ctrl != NULL)
+    {
+        return em_ctrl->get_dm_ctrl()->notify_set(event_name, p_data);
     }
 
-    // 5) Fallback: primitive (string/number/boolean/enum) - register as property
-    memset(&data_model_value, 0, sizeof(data_model_value));
-    parse_property_constraints(effective, data_model_value);
-    parse_readwrite(effective, data_model_value);
-    std::string tr181Path = yang_to_tr181_path(fullPath);
-    wfa_set_bus_callbackfunc_pointers(tr181Path.c_str(), &cbTable);
-    wfa_bus_register_namespace(const_cast<char*>(tr181Path.c_str()), bus_element_type_property, cbTable, data_model_value, 1);
+    return bus_error_general;
 }
 
-// ------------------------------------------------------------
-// Traverse object schema and process all "properties"
-// ------------------------------------------------------------
-void tr_181_t::traverse_schema(cJSON* root, cJSON* schemaNode, const std::string& basePath)
+bus_error_t tr_181_t::wifi_elem_num_of_table_row(char* event_name, uint32_t* table_row_size)
 {
-    if (!schemaNode) return;
-
-    // ensure we operate on resolved node (if schemaNode is a wrapper with $ref)
-    cJSON* effective = follow_ref_if_any(root, schemaNode);
-    if (!effective) return;
-
-    cJSON* props = cJSON_GetObjectItem(effective, "properties");
-    if (!props || !cJSON_IsObject(props)) return;
-
-    cJSON* child = props->child;
-    while (child) {
-        if (child->string) {
-            std::string newPath;
-            if (!basePath.empty() && basePath.back() != '.')
-                newPath = basePath + "." + child->string;
-            else
-                newPath = basePath + child->string;
-
-            // pass the child's schema node (not child->child) because child is a property pair
-            handle_property_node(root, newPath, child);
-        }
-        child = child->next;
+    // Return 0 rows for all tables for now
+    if (table_row_size != NULL) {
+        *table_row_size = 0;
     }
+
+    return bus_error_success;
 }
 
-// ------------------------------------------------------------
-// Entry function
-// ------------------------------------------------------------
-bool tr_181_t::parse_and_register_schema(const char *filename)
+int tr_181_t::register_wfa_dml()
 {
-    // Load file
-    FILE* f = fopen(filename, "rb");
-    if (!f) return false;
-
-    fseek(f, 0, SEEK_END);
-    long size = ftell(f);
-    fseek(f, 0, SEEK_SET);
+    const char *orchdiag[] = { DE_ORCHDIAG_PENDING, DE_ORCHDIAG_ACTIVE, DE_ORCHDIAG_LATENCY };
+    const char *subtree[] = { DE_SUBTREE_GENERATION, DE_SUBTREE_SINCE, DE_SUBTREE_TREE };
+    const char *notify[] = { DE_NOTIFY_INTERVAL, DE_NOTIFY_SUBS };
+    const char *perf[] = { DE_PERF_COUNTERS, DE_PERF_GAUGES, DE_PERF_LATENCY, DE_PERF_FRAME_LATENCY, DE_PERF_STACKS };
+    const char *mem[] = { DE_MEM_AGENT_BUDGET, DE_MEM_TOTAL_BUDGET, DE_MEM_MAX_AGENTS, DE_MEM_AGENTS };
+    const tr_181_schema_elem_t *elem;
+    bus_callback_table_t cb_table = {};
+    data_model_properties_t data_model_value;
+    bus_element_type_t type;
+    unsigned int i;
 
-    if (size < 0) {
-        fclose(f);
-        return false;
-    }
-    const size_t uSize = static_cast<size_t>(size);
-    std::vector<char> buf(uSize + 1);
-    const size_t read = std::fread(buf.data(), 1, uSize, f);
-    fclose(f);
-    buf[(read < uSize) ? read : uSize] = '\0';
-
-    cJSON* root = cJSON_Parse(buf.data());
-    if (!root) return false;
-
-    // Find top-level Network element
-    cJSON* props = cJSON_GetObjectItem(root, "properties");
-    if (!props) {
-        cJSON_Delete(root);
-        return false;
+    // elements of the schema, compiled into g_tr_181_schema at build time
+    for (i = 0; i < g_tr_181_schema_num; i++) {
+        elem = &g_tr_181_schema[i];
+        memset(&data_model_value, 0, sizeof(data_model_value));
+        data_model_value.min_data_range = elem->min;
+        data_model_value.max_data_range = elem->max;
+        data_model_value.data_permission = elem->writable ? 1:0;
+        type = (elem->type == tr_181_schema_type_table) ? bus_element_type_table:bus_element_type_property;
+        wfa_set_bus_callbackfunc_pointers(elem->cb_id, &cb_table);
+        wfa_bus_register_namespace(const_cast<char*>(elem->path), type, cb_table, data_model_value, 1);
     }
 
-    cJSON* child = props->child;
-    while (child)
-    {
-        if (child->string &&
-            std::string(child->string).find("Network") != std::string::npos)
-        {
-            traverse_schema(root, child, "Device.WiFi.DataElements.Network");
-            break;
-        }
-        child = child->next;
+    // vendor extensions are not in the schema, register them explicitly
+    memset(&data_model_value, 0, sizeof(data_model_value));
+    for (i = 0; i < ARRAY_SIZE(orchdiag); i++) {
+        wfa_set_bus_callbackfunc_pointers(orchdiag[i], &cb_table);
+        wfa_bus_register_namespace(const_cast<char*>(orchdiag[i]), bus_element_type_property, cb_table, data_model_value, 1);
+    }
+    for (i = 0; i < ARRAY_SIZE(subtree); i++) {
+        data_model_value.data_permission = (strcmp(subtree[i], DE_SUBTREE_SINCE) == 0) ? 1:0;
+        wfa_set_bus_callbackfunc_pointers(subtree[i], &cb_table);
+        wfa_bus_register_namespace(const_cast<char*>(subtree[i]), bus_element_type_property, cb_table, data_model_value, 1);
+    }
+    for (i = 0; i < ARRAY_SIZE(notify); i++) {
+        data_model_value.data_permission = (strcmp(notify[i], DE_NOTIFY_INTERVAL) == 0) ? 1:0;
+        wfa_set_bus_callbackfunc_pointers(notify[i], &cb_table);
+        wfa_bus_register_namespace(const_cast<char*>(notify[i]), bus_element_type_property, cb_table, data_model_value, 1);
+    }
+    data_model_value.data_permission = 0;
+    for (i = 0; i < ARRAY_SIZE(perf); i++) {
+        wfa_set_bus_callbackfunc_pointers(perf[i], &cb_table);
+        wfa_bus_register_namespace(const_cast<char*>(perf[i]), bus_element_type_property, cb_table, data_model_value, 1);
+    }
+    for (i = 0; i < ARRAY_SIZE(mem); i++) {
+        data_model_value.data_permission = (strcmp(mem[i], DE_MEM_AGENTS) == 0) ? 0:1;
+        wfa_set_bus_callbackfunc_pointers(mem[i], &cb_table);
+        wfa_bus_register_namespace(const_cast<char*>(mem[i]), bus_element_type_property, cb_table, data_model_value, 1);
     }
 
-    cJSON_Delete(root);
-    return true;
-}
-
-int tr_181_t::register_wfa_dml()
-{
-    const char *filename = "Data_Elements_JSON_Schema_v3.0.json";
-    parse_and_register_schema(filename);
-
     return RETURN_OK;
 }
@@ -0,0 +1,288 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+ #ifndef EM_DB_SQLITE
+
+ #include <stdio.h>
+ #include <string.h>
+ #include <stdlib.h>
+ #include <new>
+ #include "db_backend_mysql.h"
+ #include "db_write_queue.h"
+
+ db_backend_t *db_backend_t::create()
+ {
+     return new (std::nothrow) db_backend_mysql_t;
+ }
+
+ int db_backend_mysql_t::open(const char *path)
+ {
+     if (path == NULL || strlen(path) <= 0) {
+         return -1;
+     }
+
+     // Parse the path format: "username@password"
+     char *tmp = strchr(const_cast<char *>(path), '@');
+     if (tmp == NULL) {
+         printf("%s:%d: invalid path: %s\n", __func__, __LINE__, path);
+         return -1;
+     }
+
+     // Split username and password
+     char username[256];
+     char password[256];
+
+     size_t user_len = static_cast<size_t>(tmp - path);
+     if (user_len >= sizeof(username)) {
+         printf("%s:%d: username too long\n", __func__, __LINE__);
+         return -1;
+     }
+
+     strncpy(username, path, user_len);
+     username[user_len] = '\0';
+
+     tmp++; // Move past '@'
+     strncpy(password, tmp, sizeof(password) - 1);
+     password[sizeof(password) - 1] = '\0';
+
+     printf("%s:%d: user:%s pass:%s\n", __func__, __LINE__, username, password);
+
+     // Initialize MySQL connection
+     m_con = mysql_init(NULL);
+     if (m_con == NULL) {
+         printf("%s:%d: mysql_init() failed\n", __func__, __LINE__);
+         return -1;
+     }
+
+     // Connect to the database, batches of writes are sent as multi statements
+     if (mysql_real_connect(m_con,
+                           "localhost",
+                           username,
+                           password,
+                           NULL,        // Don't select database yet
+                           3306,       // Default port
+                           NULL,       // Unix socket
+                           CLIENT_MULTI_STATEMENTS) == NULL) {
+         printf("%s:%d: mysql_real_connect() failed: %s\n", __func__, __LINE__,
+                mysql_error(m_con));
+         mysql_close(m_con);
+         m_con = NULL;
+         return -1;
+     }
+
+     // Select the database
+     if (mysql_select_db(m_con, DB_BACKEND_DB_NAME) != 0) {
+         printf("%s:%d: Error selecting database: %s\n", __func__, __LINE__,
+                mysql_error(m_con));
+         // Don't fail here - the database might not exist yet
+     }
+
+     return 0;
+ }
+
+ void db_backend_mysql_t::close()
+ {
+     if (m_con) {
+         mysql_close(m_con);
+         m_con = NULL;
+     }
+ }
+
+ int db_backend_mysql_t::query(const char *sql, db_rows_t *rows)
+ {
+     MYSQL_RES *result;
+
+     rows->result = NULL;
+     rows->row = NULL;
+
+     if (mysql_query(m_con, sql)) {
+         return -1;
+     }
+
+     // no result is not an error for a query that doesn't return rows (INSERT, UPDATE, etc.)
+     if (((result = mysql_store_result(m_con)) == NULL) && (mysql_field_count(m_con) != 0)) {
+         return -1;
+     }
+     rows->result = result;
+
+     return 0;
+ }
+
+ bool db_backend_mysql_t::next_row(db_rows_t *rows)
+ {
+     rows->row = mysql_fetch_row(static_cast<MYSQL_RES *>(rows->result));
+
+     if (rows->row == NULL) {
+         free_rows(rows);
+         return false;
+     }
+
+     return true;
+ }
+
+ const char *db_backend_mysql_t::get_value(db_rows_t *rows, unsigned int col, unsigned long *len)
+ {
+     unsigned long *lengths;
+
+     if ((rows->row == NULL) || (col == 0) || (rows->row[col - 1] == NULL)) {
+         return NULL;
+     }
+
+     // Note: Column indices in MariaDB C API are 0-based
+     if ((lengths = mysql_fetch_lengths(static_cast<MYSQL_RES *>(rows->result))) == NULL) {
+         return NULL;
+     }
+     *len = lengths[col - 1];
+
+     return rows->row[col - 1];
+ }
+
+ unsigned int db_backend_mysql_t::get_num_cols(db_rows_t *rows)
+ {
+     return (rows->result == NULL) ? 0:mysql_num_fields(static_cast<MYSQL_RES *>(rows->result));
+ }
+
+ void db_backend_mysql_t::free_rows(db_rows_t *rows)
+ {
+     if (rows->result != NULL) {
+         mysql_free_result(static_cast<MYSQL_RES *>(rows->result));
+     }
+     rows->result = NULL;
+     rows->row = NULL;
+ }
+
+ void db_backend_mysql_t::write_batch(char **queries, unsigned int num, bool *failed)
+ {
+     MYSQL_RES *res;
+     std::string multi;
+     unsigned int i, start, end;
+     int status;
+
+     if (mysql_query(m_con, "start transaction")) {
+         printf("%s:%d: Error starting transaction: %s\n", __func__, __LINE__, mysql_error(m_con));
+     }
+
+     for (start = 0; start < num; start = i) {
+         multi.clear();
+         for (end = start; (end < num) &&
+                 ((end == start) || ((multi.length() + strlen(queries[end])) < DB_WRITE_QUEUE_MAX_QUERY)); end++) {
+             if (end > start) {
+                 multi += ';';
+             }
+             multi += queries[end];
+         }
+
+         // the server stops at the first statement that fails, the ones after it are sent again
+         status = mysql_query(m_con, multi.c_str()) ? 1:0;
+         for (i = start; i < end; ) {
+             if (status > 0) {
+                 printf("%s:%d: Query failed: %s\n", __func__, __LINE__, queries[i]);
+                 printf("%s:%d: Error: %s\n", __func__, __LINE__, mysql_error(m_con));
+                 failed[i++] = true;
+                 break;
+             }
+             if ((res = mysql_store_result(m_con)) != NULL) {
+                 mysql_free_result(res);
+             }
+             i++;
+             if ((status = mysql_next_result(m_con)) < 0) {
+                 break;
+             }
+         }
+     }
+
+     if (mysql_query(m_con, "commit")) {
+         printf("%s:%d: Error committing %d writes: %s\n", __func__, __LINE__, num, mysql_error(m_con));
+         for (i = 0; i < num; i++) {
+             failed[i] = true;
+         }
+     }
+ }
+
+ int db_backend_mysql_t::get_tables(std::vector<std::string>& tables)
+ {
+     MYSQL_RES *res;
+     MYSQL_ROW row;
+
+     if (mysql_query(m_con, "show tables") || ((res = mysql_store_result(m_con)) == NULL)) {
+         printf("%s:%d: Error listing tables: %s\n", __func__, __LINE__, mysql_error(m_con));
+         return -1;
+     }
+     while ((row = mysql_fetch_row(res)) != NULL) {
+         tables.push_back(row[0]);
+     }
+     mysql_free_result(res);
+
+     return 0;
+ }
+
+ int db_backend_mysql_t::get_checksum(const char *table, unsigned long long *checksum)
+ {
+     char query[128];
+     MYSQL_RES *res;
+     MYSQL_ROW row;
+
+     snprintf(query, sizeof(query), "checksum table %s", table);
+     if (mysql_query(m_con, query) || ((res = mysql_store_result(m_con)) == NULL)) {
+         printf("%s:%d: Error reading checksum of %s: %s\n", __func__, __LINE__, table, mysql_error(m_con));
+         return -1;
+     }
+
+     // the checksum is NULL for a table that does not exist
+     row = mysql_fetch_row(res);
+     *checksum = ((row != NULL) && (row[1] != NULL)) ? strtoull(row[1], NULL, 10):0;
+     mysql_free_result(res);
+
+     return 0;
+ }
+
+ int db_backend_mysql_t::recreate()
+ {
+     // Drop existing database
+     if (mysql_query(m_con, "DROP DATABASE IF EXISTS " DB_BACKEND_DB_NAME)) {
+         printf("%s:%d: Error dropping database: %s\n", __func__, __LINE__, mysql_error(m_con));
+         return -1;
+     }
+
+     // Create new database
+     if (mysql_query(m_con, "CREATE DATABASE " DB_BACKEND_DB_NAME)) {
+         printf("%s:%d: Error creating database: %s\n", __func__, __LINE__, mysql_error(m_con));
+         return -1;
+     }
+
+     if (mysql_select_db(m_con, DB_BACKEND_DB_NAME)) {
+         printf("%s:%d: Error selecting database: %s\n", __func__, __LINE__, mysql_error(m_con));
+     }
+
+     return 0;
+ }
+
+ void db_backend_mysql_t::reselect()
+ {
+     // the database was dropped under this connection
+     if (mysql_select_db(m_con, DB_BACKEND_DB_NAME)) {
+         printf("%s:%d: Error selecting database: %s\n", __func__, __LINE__, mysql_error(m_con));
+     }
+ }
+
+ const char *db_backend_mysql_t::get_error()
+ {
+     return (m_con == NULL) ? "not connected":mysql_error(m_con);
+ }
+
+ #endif
@@ -0,0 +1,274 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+ #ifdef EM_DB_SQLITE
+
+ #include <stdio.h>
+ #include <string.h>
+ #include <new>
+ #include "db_backend_sqlite.h"
+
+ #define DB_BACKEND_SQLITE_BUSY_MS   5000
+ #define DB_BACKEND_FNV_OFFSET       14695981039346656037ULL
+ #define DB_BACKEND_FNV_PRIME        1099511628211ULL
+
+ // a current row in db_rows_t, the values are read from the statement
+ static char *s_row[1];
+
+ db_backend_t *db_backend_t::create()
+ {
+     return new (std::nothrow) db_backend_sqlite_t;
+ }
+
+ int db_backend_sqlite_t::open(const char *path)
+ {
+     const char *file;
+     char *err = NULL;
+
+     // the "username@password" of a server means the default file
+     file = ((path != NULL) && (strchr(path, '/') != NULL)) ? path:DB_BACKEND_SQLITE_FILE;
+
+     if (sqlite3_open_v2(file, &m_db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL) != SQLITE_OK) {
+         printf("%s:%d: Failed to open %s: %s\n", __func__, __LINE__, file,
+                (m_db == NULL) ? "out of memory":sqlite3_errmsg(m_db));
+         close();
+         return -1;
+     }
+
+     // readers are not blocked by the writer connection, a commit is synced at checkpoints only
+     sqlite3_busy_timeout(m_db, DB_BACKEND_SQLITE_BUSY_MS);
+     if (sqlite3_exec(m_db, "pragma journal_mode=wal; pragma synchronous=normal", NULL, NULL, &err) != SQLITE_OK) {
+         printf("%s:%d: Failed to enable WAL on %s: %s\n", __func__, __LINE__, file, err);
+         sqlite3_free(err);
+     }
+
+     return 0;
+ }
+
+ void db_backend_sqlite_t::close()
+ {
+     if (m_db != NULL) {
+         sqlite3_close_v2(m_db);
+         m_db = NULL;
+     }
+ }
+
+ int db_backend_sqlite_t::query(const char *sql, db_rows_t *rows)
+ {
+     sqlite3_stmt *stmt;
+     const char *tail = sql;
+     int rc;
+
+     rows->result = NULL;
+     rows->row = NULL;
+
+     // statements without rows are run in turn, the first one with columns returns its rows
+     while (*tail != '\0') {
+         if (sqlite3_prepare_v2(m_db, tail, -1, &stmt, &tail) != SQLITE_OK) {
+             return -1;
+         }
+         if (stmt == NULL) {
+             // only white space or a comment was left
+             break;
+         }
+         if (sqlite3_column_count(stmt) > 0) {
+             rows->result = stmt;
+             return 0;
+         }
+         while ((rc = sqlite3_step(stmt)) == SQLITE_ROW);
+         sqlite3_finalize(stmt);
+         if (rc != SQLITE_DONE) {
+             return -1;
+         }
+     }
+
+     return 0;
+ }
+
+ bool db_backend_sqlite_t::next_row(db_rows_t *rows)
+ {
+     sqlite3_stmt *stmt = static_cast<sqlite3_stmt *>(rows->result);
+     int rc;
+
+     if ((rc = sqlite3_step(stmt)) != SQLITE_ROW) {
+         if (rc != SQLITE_DONE) {
+             printf("%s:%d: Error reading rows: %s\n", __func__, __LINE__, sqlite3_errmsg(m_db));
+         }
+         free_rows(rows);
+         return false;
+     }
+     rows->row = s_row;
+
+     return true;
+ }
+
+ const char *db_backend_sqlite_t::get_value(db_rows_t *rows, unsigned int col, unsigned long *len)
+ {
+     sqlite3_stmt *stmt = static_cast<sqlite3_stmt *>(rows->result);
+     const unsigned char *val;
+
+     if ((rows->row == NULL) || (col == 0) || (static_cast<int>(col) > sqlite3_column_count(stmt))) {
+         return NULL;
+     }
+
+     // Note: Column indices in SQLite are 0-based
+     if ((val = sqlite3_column_text(stmt, static_cast<int>(col - 1))) == NULL) {
+         return NULL;
+     }
+     *len = static_cast<unsigned long>(sqlite3_column_bytes(stmt, static_cast<int>(col - 1)));
+
+     return reinterpret_cast<const char *>(val);
+ }
+
+ unsigned int db_backend_sqlite_t::get_num_cols(db_rows_t *rows)
+ {
+     return (rows->result == NULL) ? 0:static_cast<unsigned int>(sqlite3_column_count(static_cast<sqlite3_stmt *>(rows->result)));
+ }
+
+ void db_backend_sqlite_t::free_rows(db_rows_t *rows)
+ {
+     if (rows->result != NULL) {
+         sqlite3_finalize(static_cast<sqlite3_stmt *>(rows->result));
+     }
+     rows->result = NULL;
+     rows->row = NULL;
+ }
+
+ void db_backend_sqlite_t::write_batch(char **queries, unsigned int num, bool *failed)
+ {
+     char *err = NULL;
+     unsigned int i;
+
+     if (sqlite3_exec(m_db, "begin", NULL, NULL, &err) != SQLITE_OK) {
+         printf("%s:%d: Error starting transaction: %s\n", __func__, __LINE__, err);
+         sqlite3_free(err);
+     }
+
+     // a statement that fails is undone on its own, the transaction goes on
+     for (i = 0; i < num; i++) {
+         if (sqlite3_exec(m_db, queries[i], NULL, NULL, &err) != SQLITE_OK) {
+             printf("%s:%d: Query failed: %s\n", __func__, __LINE__, queries[i]);
+             printf("%s:%d: Error: %s\n", __func__, __LINE__, err);
+             sqlite3_free(err);
+             failed[i] = true;
+         }
+     }
+
+     if (sqlite3_exec(m_db, "commit", NULL, NULL, &err) != SQLITE_OK) {
+         printf("%s:%d: Error committing %d writes: %s\n", __func__, __LINE__, num, err);
+         sqlite3_free(err);
+         sqlite3_exec(m_db, "rollback", NULL, NULL, NULL);
+         for (i = 0; i < num; i++) {
+             failed[i] = true;
+         }
+     }
+ }
+
+ int db_backend_sqlite_t::get_tables(std::vector<std::string>& tables)
+ {
+     sqlite3_stmt *stmt;
+
+     if (sqlite3_prepare_v2(m_db, "select name from sqlite_master where type = 'table' and name not like 'sqlite_%'",
+             -1, &stmt, NULL) != SQLITE_OK) {
+         printf("%s:%d: Error listing tables: %s\n", __func__, __LINE__, sqlite3_errmsg(m_db));
+         return -1;
+     }
+     while (sqlite3_step(stmt) == SQLITE_ROW) {
+         tables.push_back(reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0)));
+     }
+     sqlite3_finalize(stmt);
+
+     return 0;
+ }
+
+ int db_backend_sqlite_t::get_checksum(const char *table, unsigned long long *checksum)
+ {
+     sqlite3_stmt *stmt;
+     const unsigned char *val;
+     unsigned long long hash = DB_BACKEND_FNV_OFFSET;
+     char query[128];
+     int i, j, num, len, rc;
+
+     *checksum = 0;
+
+     // SQLite has no table checksum, FNV-1a of the values of the rows, in storage order
+     snprintf(query, sizeof(query), "select * from %s", table);
+     if (sqlite3_prepare_v2(m_db, query, -1, &stmt, NULL) != SQLITE_OK) {
+         // the table does not exist
+         return (sqlite3_errcode(m_db) == SQLITE_ERROR) ? 0:-1;
+     }
+
+     num = sqlite3_column_count(stmt);
+     while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+         for (i = 0; i < num; i++) {
+             val = sqlite3_column_text(stmt, i);
+             len = sqlite3_column_bytes(stmt, i);
+             for (j = 0; j < len; j++) {
+                 hash = (hash ^ val[j]) * DB_BACKEND_FNV_PRIME;
+             }
+             // a NULL and an empty value differ, so do values split at another column
+             hash = (hash ^ ((val == NULL) ? 0xffU:0xfeU)) * DB_BACKEND_FNV_PRIME;
+         }
+     }
+     sqlite3_finalize(stmt);
+
+     if (rc != SQLITE_DONE) {
+         printf("%s:%d: Error reading checksum of %s: %s\n", __func__, __LINE__, table, sqlite3_errmsg(m_db));
+         return -1;
+     }
+     *checksum = hash;
+
+     return 0;
+ }
+
+ int db_backend_sqlite_t::recreate()
+ {
+     std::vector<std::string> tables;
+     std::string sql("begin;");
+     char *err = NULL;
+
+     // the database is the file, its tables are dropped instead
+     if (get_tables(tables) != 0) {
+         return -1;
+     }
+     for (const std::string& table : tables) {
+         sql += "drop table if exists " + table + ";";
+     }
+     sql += "commit";
+
+     if (sqlite3_exec(m_db, sql.c_str(), NULL, NULL, &err) != SQLITE_OK) {
+         printf("%s:%d: Error dropping tables: %s\n", __func__, __LINE__, err);
+         sqlite3_free(err);
+         sqlite3_exec(m_db, "rollback", NULL, NULL, NULL);
+         return -1;
+     }
+
+     return 0;
+ }
+
+ void db_backend_sqlite_t::reselect()
+ {
+     // the file stays in place, the schema change is seen on the next statement
+ }
+
+ const char *db_backend_sqlite_t::get_error()
+ {
+     return (m_db == NULL) ? "not connected":sqlite3_errmsg(m_db);
+ }
+
+ #endif
@@ -0,0 +1,225 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "db_change_log.h"
+
+static void put_be(std::string& out, unsigned long long val, unsigned int len)
+{
+    while (len-- > 0) {
+        out += static_cast<char>((val >> (len * 8)) & 0xff);
+    }
+}
+
+static unsigned long long get_be(const unsigned char *buf, unsigned int len)
+{
+    unsigned long long val = 0;
+    unsigned int i;
+
+    for (i = 0; i < len; i++) {
+        val = (val << 8) | buf[i];
+    }
+
+    return val;
+}
+
+size_t db_change_log_t::encode(unsigned long long seq, const char *table, const char *key, db_write_op_t op,
+        const char *query, std::string& out)
+{
+    size_t table_len = strlen(table), key_len = strlen(key), query_len = strlen(query), len;
+
+    if ((table_len > 0xffff) || (key_len > 0xffff) || (query_len > 0x7fffffff - DB_CHANGE_LOG_HDR_LEN - table_len - key_len)) {
+        return 0;
+    }
+    len = DB_CHANGE_LOG_HDR_LEN + table_len + key_len + query_len;
+
+    put_be(out, len, 4);
+    put_be(out, seq, 8);
+    put_be(out, static_cast<unsigned long long>(op), 1);
+    put_be(out, table_len, 2);
+    put_be(out, key_len, 2);
+    put_be(out, query_len, 4);
+    out.append(table, table_len);
+    out.append(key, key_len);
+    out.append(query, query_len);
+
+    return len;
+}
+
+int db_change_log_t::decode(const unsigned char *buf, size_t len, db_change_rec_t *rec)
+{
+    size_t rec_len, table_len, key_len, query_len;
+    const char *str;
+
+    if (len < 4) {
+        return 0;
+    }
+    rec_len = get_be(buf, 4);
+    if ((rec_len < DB_CHANGE_LOG_HDR_LEN) || (rec_len > 0x7fffffff)) {
+        return -1;
+    }
+    if (len < rec_len) {
+        return 0;
+    }
+
+    table_len = get_be(buf + 13, 2);
+    key_len = get_be(buf + 15, 2);
+    query_len = get_be(buf + 17, 4);
+    if ((DB_CHANGE_LOG_HDR_LEN + table_len + key_len + query_len != rec_len) || (buf[12] > db_write_op_delete)) {
+        return -1;
+    }
+
+    rec->seq = get_be(buf + 4, 8);
+    rec->op = static_cast<db_write_op_t>(buf[12]);
+    str = reinterpret_cast<const char *>(buf + DB_CHANGE_LOG_HDR_LEN);
+    rec->table.assign(str, table_len);
+    rec->key.assign(str + table_len, key_len);
+    rec->query.assign(str + table_len + key_len, query_len);
+
+    return static_cast<int>(rec_len);
+}
+
+unsigned long long db_change_log_t::append(const char *table, const char *key, db_write_op_t op, const char *query)
+{
+    std::string rec;
+    unsigned long long seq;
+
+    pthread_mutex_lock(&m_lock);
+    seq = m_next;
+    if (encode(seq, table, key, op, query, rec) == 0) {
+        pthread_mutex_unlock(&m_lock);
+        printf("%s:%d: Write of %s too long to be logged\n", __func__, __LINE__, table);
+        return 0;
+    }
+
+    m_stats.bytes += rec.size();
+    m_recs.push_back(std::move(rec));
+    m_next++;
+    m_stats.appended++;
+
+    // the newest record is kept whatever its size
+    while ((m_recs.size() > 1) && ((m_recs.size() > DB_CHANGE_LOG_MAX_RECS) || (m_stats.bytes > DB_CHANGE_LOG_MAX_BYTES))) {
+        m_stats.bytes -= m_recs.front().size();
+        m_recs.pop_front();
+        m_first++;
+        m_stats.dropped++;
+    }
+    pthread_cond_broadcast(&m_cond);
+    pthread_mutex_unlock(&m_lock);
+
+    return seq;
+}
+
+int db_change_log_t::read(unsigned long long from, size_t max_bytes, std::string& out, unsigned long long *next)
+{
+    unsigned long long seq;
+    int num = 0;
+
+    pthread_mutex_lock(&m_lock);
+    if ((from < m_first) || (from > m_next)) {
+        pthread_mutex_unlock(&m_lock);
+        return -1;
+    }
+
+    for (seq = from; seq < m_next; seq++) {
+        const std::string& rec = m_recs[static_cast<size_t>(seq - m_first)];
+        if ((num > 0) && (out.size() + rec.size() > max_bytes)) {
+            break;
+        }
+        out += rec;
+        num++;
+    }
+    *next = seq;
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+bool db_change_log_t::wait(unsigned long long seq, unsigned int timeout_ms)
+{
+    struct timespec ts;
+    bool found;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += timeout_ms / 1000;
+    ts.tv_nsec += static_cast<long>(timeout_ms % 1000) * 1000000;
+    if (ts.tv_nsec >= 1000000000) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+
+    pthread_mutex_lock(&m_lock);
+    while ((seq >= m_next) && (pthread_cond_timedwait(&m_cond, &m_lock, &ts) == 0));
+    found = (seq < m_next);
+    pthread_mutex_unlock(&m_lock);
+
+    return found;
+}
+
+void db_change_log_t::reset()
+{
+    pthread_mutex_lock(&m_lock);
+    m_recs.clear();
+    m_stats.bytes = 0;
+    m_stats.resets++;
+    m_next++;
+    m_first = m_next;
+    pthread_cond_broadcast(&m_cond);
+    pthread_mutex_unlock(&m_lock);
+}
+
+unsigned long long db_change_log_t::get_last_seq()
+{
+    unsigned long long seq;
+
+    pthread_mutex_lock(&m_lock);
+    seq = m_next - 1;
+    pthread_mutex_unlock(&m_lock);
+
+    return seq;
+}
+
+void db_change_log_t::get_stats(db_change_log_stats_t *stats)
+{
+    pthread_mutex_lock(&m_lock);
+    *stats = m_stats;
+    stats->num_recs = static_cast<unsigned int>(m_recs.size());
+    pthread_mutex_unlock(&m_lock);
+}
+
+db_change_log_t::db_change_log_t(): m_lock(), m_cond(), m_recs(), m_id(0), m_first(1), m_next(1), m_stats()
+{
+    struct timespec ts;
+
+    pthread_mutex_init(&m_lock, NULL);
+    pthread_cond_init(&m_cond, NULL);
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    m_id = (static_cast<unsigned long long>(ts.tv_sec) << 32) ^ static_cast<unsigned long long>(ts.tv_nsec) ^
+            (static_cast<unsigned long long>(getpid()) << 20);
+}
+
+db_change_log_t::~db_change_log_t()
+{
+    pthread_cond_destroy(&m_cond);
+    pthread_mutex_destroy(&m_lock);
+}
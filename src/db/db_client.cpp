@@ -19,13 +19,24 @@
  #include <string.h>
  #include <stdlib.h>
  #include <assert.h>
+ #include <algorithm>
  #include "db_client.h"
  #include "em_base.h"
+ #include "em_hex.h"
+ #include "em_perf.h"
 
  // Structure to hold the result set and associated data
  struct result_context_t {
-     MYSQL_RES *result;
-     MYSQL_ROW row;
+     db_rows_t rows;    // result and current row of the backend
+     db_snapshot_cursor_t *snap;    // rows read from the snapshot instead of result
+ };
+
+ // tables shared out to the prefetch threads, each takes the next one left
+ struct prefetch_job_t {
+     const char *path;
+     const std::vector<std::string> *tables;
+     std::vector<db_snapshot_t *> snaps;    // by table, NULL if it was not read
+     std::atomic<unsigned int> next;
  };
 
  int db_client_t::recreate_db()
@@ -35,16 +46,20 @@
          return -1;
      }
 
-     // Drop existing database
-     if (mysql_query(m_con, "DROP DATABASE IF EXISTS OneWifiMesh")) {
-         printf("%s:%d: Error dropping database: %s\n", __func__, __LINE__, mysql_error(m_con));
+     flush();
+
+     if (m_con->recreate() != 0) {
          return -1;
      }
 
-     // Create new database
-     if (mysql_query(m_con, "CREATE DATABASE OneWifiMesh")) {
-         printf("%s:%d: Error creating database: %s\n", __func__, __LINE__, mysql_error(m_con));
-         return -1;
+     // the rows logged so far belong to the database dropped
+     if (m_change_log) {
+         m_change_log->reset();
+     }
+
+     // the writer lost its database with the drop
+     if (m_writer_con) {
+         m_writer_con->reselect();
      }
 
      return 0;
@@ -52,36 +67,126 @@
 
  void *db_client_t::execute(const char *query)
  {
+     em_perf_scope_t scope(em_perf_hist_db_execute);
+
+     em_perf_t::inc(em_perf_ctr_db_queries);
      if (!m_con) {
          printf("%s:%d: Query: %s m_con is NULL, exiting\n", __func__, __LINE__, query);
+         em_perf_t::inc(em_perf_ctr_db_errors);
          return NULL;
      }
 
-     if (mysql_query(m_con, query)) {
+     db_rows_t rows;
+
+     if (m_con->query(query, &rows) != 0) {
          printf("%s:%d: Query failed: %s\n", __func__, __LINE__, query);
-         printf("%s:%d: Error: %s\n", __func__, __LINE__, mysql_error(m_con));
+         printf("%s:%d: Error: %s\n", __func__, __LINE__, m_con->get_error());
+         em_perf_t::inc(em_perf_ctr_db_errors);
          return NULL;
      }
 
-     MYSQL_RES *result = mysql_store_result(m_con);
-     if (!result) {
-         // This might not be an error - could be a query that doesn't return results (INSERT, UPDATE, etc.)
-         if (mysql_field_count(m_con) == 0) {
-             return NULL;  // Query was successful but didn't return data
-         } else {
-             printf("%s:%d: Error storing result: %s\n", __func__, __LINE__, mysql_error(m_con));
-             return NULL;
-         }
+     // Query was successful but didn't return data (INSERT, UPDATE, etc.)
+     if (rows.result == NULL) {
+         return NULL;
      }
 
      // Create a context structure to hold the result and current row
      result_context_t *ctx = new result_context_t;
-     ctx->result = result;
-     ctx->row = NULL;
+     ctx->rows = rows;
+     ctx->snap = NULL;
+
+     return ctx;
+ }
+
+ void *db_client_t::execute_snapshot(const char *table)
+ {
+     db_snapshot_cursor_t *cur = new db_snapshot_cursor_t;
+     result_context_t *ctx;
+     unsigned int i;
+
+     // the cursor holds the rows it walks, next_result() reads it whatever snapshot opened it
+     if (m_snapshot.open_table(table, cur) != 0) {
+         for (i = 0; i < m_prefetch.size(); i++) {
+             if (m_prefetch[i]->open_table(table, cur) == 0) {
+                 break;
+             }
+         }
+         if (i == m_prefetch.size()) {
+             delete cur;
+             return NULL;
+         }
+     }
+
+     ctx = new result_context_t;
+     ctx->rows.result = NULL;
+     ctx->rows.row = NULL;
+     ctx->snap = cur;
 
      return ctx;
  }
 
+ void db_client_t::write_batch(void *arg, char **queries, unsigned int num, bool *failed)
+ {
+     db_client_t *client = static_cast<db_client_t *>(arg);
+
+     client->m_writer_con->write_batch(queries, num, failed);
+ }
+
+ int db_client_t::start_writer(const char *path)
+ {
+     if (m_writer.is_running() == true) {
+         return 0;
+     }
+
+     if (connect(path, &m_writer_con) != 0) {
+         printf("%s:%d: Writer connect failed, writes stay synchronous\n", __func__, __LINE__);
+         return -1;
+     }
+
+     if (m_writer.start(write_batch, this, DB_WRITE_QUEUE_BATCH_SZ) != 0) {
+         delete m_writer_con;
+         m_writer_con = NULL;
+         return -1;
+     }
+
+     return 0;
+ }
+
+ void db_client_t::stop_writer()
+ {
+     m_writer.stop();
+
+     if (m_writer_con) {
+         delete m_writer_con;
+         m_writer_con = NULL;
+     }
+ }
+
+ int db_client_t::write(const char *table, const char *key, db_write_op_t op, const char *query)
+ {
+     void *ctx;
+
+     if (m_change_log) {
+         m_change_log->append(table, key, op, query);
+     }
+
+     if ((m_writer.is_running() == true) && (m_writer.push(table, key, op, query) == 0)) {
+         return 0;
+     }
+
+     ctx = execute(query);
+     while (next_result(ctx) == true);
+
+     return 0;
+ }
+
+ void db_client_t::flush()
+ {
+     if (m_writer.is_running() == true) {
+         m_writer.flush();
+     }
+ }
+
  bool db_client_t::next_result(void *ctx)
  {
      if (ctx == NULL) {
@@ -89,14 +194,23 @@
      }
 
      result_context_t *res_ctx = static_cast<result_context_t *>(ctx);
-     res_ctx->row = mysql_fetch_row(res_ctx->result);
 
-     if (res_ctx->row == NULL) {
-         // No more rows - clean up
-         mysql_free_result(res_ctx->result);
+     if (res_ctx->snap != NULL) {
+         if (m_snapshot.next_row(res_ctx->snap) == false) {
+             delete res_ctx->snap;
+             delete res_ctx;
+             return false;
+         }
+         m_rows_read++;
+         return true;
+     }
+
+     if (m_con->next_row(&res_ctx->rows) == false) {
+         // No more rows, the backend freed them
          delete res_ctx;
          return false;
      }
+     m_rows_read++;
 
      return true;
  }
@@ -109,118 +223,466 @@
 
      result_context_t *res_ctx = static_cast<result_context_t *>(ctx);
 
-     if (res_ctx->row == NULL || res_ctx->row[col - 1] == NULL) {
-         return NULL;
+     if (res_ctx->snap != NULL) {
+         if ((col == 0) || (col > res_ctx->snap->num_cols) || (res_ctx->snap->cols[col - 1] == NULL)) {
+             return NULL;
+         }
+         snprintf(str, res_ctx->snap->lens[col - 1] + 1, "%s", res_ctx->snap->cols[col - 1]);
+         return str;
      }
 
-     // Note: Column indices in MariaDB C API are 0-based
-     unsigned long *lengths = mysql_fetch_lengths(res_ctx->result);
-     if (!lengths) {
+     unsigned long len;
+     const char *val = m_con->get_value(&res_ctx->rows, col, &len);
+     if (val == NULL) {
          return NULL;
      }
 
-     snprintf(str, lengths[col - 1] + 1, "%s", res_ctx->row[col - 1]);
+     snprintf(str, len + 1, "%s", val);
      return str;
  }
 
+ unsigned int db_client_t::get_blob(void *ctx, unsigned char *buff, unsigned int max, unsigned int col)
+ {
+     const char *val;
+     unsigned long len;
+
+     if (ctx == NULL) {
+         return 0;
+     }
+
+     result_context_t *res_ctx = static_cast<result_context_t *>(ctx);
+
+     if (res_ctx->snap != NULL) {
+         if ((col == 0) || (col > res_ctx->snap->num_cols) || (res_ctx->snap->cols[col - 1] == NULL)) {
+             return 0;
+         }
+         val = res_ctx->snap->cols[col - 1];
+         len = res_ctx->snap->lens[col - 1];
+     } else if ((val = m_con->get_value(&res_ctx->rows, col, &len)) == NULL) {
+         return 0;
+     }
+
+     len = std::min(len, static_cast<unsigned long>(max));
+     memcpy(buff, val, len);
+
+     return static_cast<unsigned int>(len);
+ }
+
  int db_client_t::get_number(void *ctx, unsigned int col)
  {
      assert(ctx != NULL);
 
      result_context_t *res_ctx = static_cast<result_context_t *>(ctx);
 
-     if (res_ctx->row == NULL || res_ctx->row[col - 1] == NULL) {
-         return 0;
+     if (res_ctx->snap != NULL) {
+         if ((col == 0) || (col > res_ctx->snap->num_cols) || (res_ctx->snap->cols[col - 1] == NULL)) {
+             return 0;
+         }
+         return atoi(res_ctx->snap->cols[col - 1]);
      }
 
-     // Note: Column indices in MariaDB C API are 0-based
-     return atoi(res_ctx->row[col - 1]);
+     unsigned long len;
+     const char *val = m_con->get_value(&res_ctx->rows, col, &len);
+
+     return (val == NULL) ? 0:atoi(val);
  }
 
- int db_client_t::connect(const char *path)
+ int db_client_t::connect(const char *path, db_backend_t **con)
  {
-     if (path == NULL || strlen(path) <= 0) {
+     if ((*con = db_backend_t::create()) == NULL) {
          return -1;
      }
 
-     // Parse the path format: "username@password"
-     char *tmp = strchr(const_cast<char *>(path), '@');
-     if (tmp == NULL) {
-         printf("%s:%d: invalid path: %s\n", __func__, __LINE__, path);
+     if ((*con)->open(path) != 0) {
+         delete *con;
+         *con = NULL;
          return -1;
      }
 
-     // Split username and password
-     char username[256];
-     char password[256];
+     return 0;
+ }
 
-     size_t user_len = static_cast<size_t>(tmp - path);
-     if (user_len >= sizeof(username)) {
-         printf("%s:%d: username too long\n", __func__, __LINE__);
+ int db_client_t::get_tables(std::vector<std::string>& tables)
+ {
+     if (!m_con) {
          return -1;
      }
 
-     strncpy(username, path, user_len);
-     username[user_len] = '\0';
+     return m_con->get_tables(tables);
+ }
 
-     tmp++; // Move past '@'
-     strncpy(password, tmp, sizeof(password) - 1);
-     password[sizeof(password) - 1] = '\0';
+ int db_client_t::read_table(db_backend_t *con, const char *table, unsigned long long checksum, db_snapshot_t *snap)
+ {
+     const char *vals[DB_SNAPSHOT_MAX_COLS];
+     unsigned long lens[DB_SNAPSHOT_MAX_COLS];
+     char query[128];
+     db_rows_t rows;
+     unsigned int i, num;
+
+     snprintf(query, sizeof(query), "select * from %s", table);
+     if ((con->query(query, &rows) != 0) || (rows.result == NULL)) {
+         printf("%s:%d: Error reading %s: %s\n", __func__, __LINE__, table, con->get_error());
+         return -1;
+     }
+     num = con->get_num_cols(&rows);
+     if (snap->add_table(table, num, checksum) != 0) {
+         con->free_rows(&rows);
+         return -1;
+     }
+     while (con->next_row(&rows) == true) {
+         for (i = 0; i < num; i++) {
+             lens[i] = 0;
+             vals[i] = con->get_value(&rows, i + 1, &lens[i]);
+         }
+         snap->add_row(vals, lens);
+     }
 
-     printf("%s:%d: user:%s pass:%s\n", __func__, __LINE__, username, password);
+     return 0;
+ }
 
-     // Initialize MySQL connection
-     m_con = mysql_init(NULL);
-     if (m_con == NULL) {
-         printf("%s:%d: mysql_init() failed\n", __func__, __LINE__);
+ int db_client_t::read_snapshot(db_snapshot_t *snap, const std::vector<std::string> *tables)
+ {
+     std::vector<std::string> all;
+     unsigned long long checksum;
+     db_backend_t *con;
+     bool ok = true;
+
+     if (m_path.empty() == true) {
          return -1;
      }
 
-     // Connect to the database
-     if (mysql_real_connect(m_con,
-                           "localhost",
-                           username,
-                           password,
-                           NULL,        // Don't select database yet
-                           3306,       // Default port
-                           NULL,       // Unix socket
-                           0) == NULL) {
-         printf("%s:%d: mysql_real_connect() failed: %s\n", __func__, __LINE__,
-                mysql_error(m_con));
-         mysql_close(m_con);
-         m_con = NULL;
+     // the snapshot must hold what the queue was about to write
+     flush();
+
+     if (connect(m_path.c_str(), &con) != 0) {
+         printf("%s:%d: Connect failed\n", __func__, __LINE__);
          return -1;
      }
 
-     // Select the database
-     if (mysql_select_db(m_con, "OneWifiMesh") != 0) {
-         printf("%s:%d: Error selecting database: %s\n", __func__, __LINE__,
-                mysql_error(m_con));
-         // Don't fail here - the database might not exist yet
+     if (con->get_tables(all) != 0) {
+         delete con;
+         return -1;
      }
 
+     for (const std::string& table : all) {
+         if ((tables != NULL) && (std::find(tables->begin(), tables->end(), table) == tables->end())) {
+             continue;
+         }
+         if ((con->get_checksum(table.c_str(), &checksum) != 0) || (read_table(con, table.c_str(), checksum, snap) != 0)) {
+             ok = false;
+             break;
+         }
+     }
+     delete con;
+
+     return (ok == true) ? 0:-1;
+ }
+
+ int db_client_t::save_snapshot(const char *file)
+ {
+     db_snapshot_t snap;
+
+     if (read_snapshot(&snap, NULL) != 0) {
+         return -1;
+     }
+
+     return snap.save(file);
+ }
+
+ int db_client_t::save_snapshot(std::string& image, const std::vector<std::string> *tables)
+ {
+     db_snapshot_t snap;
+
+     if (read_snapshot(&snap, tables) != 0) {
+         return -1;
+     }
+     snap.save_image(image);
+
+     return 0;
+ }
+
+ int db_client_t::restore_snapshot(const char *file)
+ {
+     db_snapshot_t snap;
+
+     if ((m_con == NULL) || (snap.load(file) != 0)) {
+         return -1;
+     }
+
+     return restore_tables(snap);
+ }
+
+ int db_client_t::restore_snapshot(std::string& image)
+ {
+     db_snapshot_t snap;
+
+     if ((m_con == NULL) || (snap.load_image(image) != 0)) {
+         return -1;
+     }
+
+     return restore_tables(snap);
+ }
+
+ int db_client_t::restore_tables(const db_snapshot_t& snap)
+ {
+     db_snapshot_cursor_t cur;
+     const db_snapshot_table_hdr_t *table;
+     std::vector<std::string> tables, sql;
+     std::vector<char *> queries;
+     bool *failed;
+     unsigned int i, j, k;
+     const char *c;
+     bool ok = true;
+
+     if ((m_con == NULL) || (m_con->get_tables(tables) != 0)) {
+         return -1;
+     }
+     // the table names go into the statements as they are, only those of this database are taken
+     for (i = 0; (table = snap.get_table(i)) != NULL; i++) {
+         if (std::find(tables.begin(), tables.end(), table->name) == tables.end()) {
+             printf("%s:%d: Snapshot of unknown table %s refused\n", __func__, __LINE__, table->name);
+             return -1;
+         }
+     }
+     flush();
+
+     for (i = 0; (table = snap.get_table(i)) != NULL; i++) {
+         sql.clear();
+         sql.push_back(std::string("delete from ") + table->name);
+         snap.open_table(table->name, &cur);
+         while (snap.next_row(&cur) == true) {
+             std::string q = std::string("insert into ") + table->name + " values(";
+             for (j = 0; j < cur.num_cols; j++) {
+                 if (j > 0) {
+                     q += ", ";
+                 }
+                 if (cur.cols[j] == NULL) {
+                     q += "NULL";
+                     continue;
+                 }
+                 // a value with control bytes, a blob, is written back as a hex literal
+                 for (k = 0, c = cur.cols[j]; (k < cur.lens[j]) && (static_cast<unsigned char>(*c) >= 0x20) && (*c != 0x7f); k++, c++);
+                 if (k < cur.lens[j]) {
+                     std::string hex(2*cur.lens[j], '0');
+                     em_hex::encode(reinterpret_cast<const unsigned char *>(cur.cols[j]), cur.lens[j], &hex[0]);
+                     q += "X'" + hex + "'";
+                     continue;
+                 }
+                 // values are written back as literals, quotes doubled
+                 q += '\'';
+                 for (k = 0, c = cur.cols[j]; k < cur.lens[j]; k++, c++) {
+                     if (*c == '\'') {
+                         q += '\'';
+#ifndef EM_DB_SQLITE
+                     } else if (*c == '\\') {
+                         q += '\\';
+#endif
+                     }
+                     q += *c;
+                 }
+                 q += '\'';
+             }
+             q += ")";
+             sql.push_back(q);
+         }
+
+         queries.clear();
+         for (std::string& q : sql) {
+             queries.push_back(&q[0]);
+         }
+         failed = new bool[queries.size()]();
+         m_con->write_batch(queries.data(), static_cast<unsigned int>(queries.size()), failed);
+         for (j = 0; j < queries.size(); j++) {
+             if (failed[j] == true) {
+                 printf("%s:%d: Restoring %s failed: %s\n", __func__, __LINE__, table->name, m_con->get_error());
+                 ok = false;
+                 break;
+             }
+         }
+         delete [] failed;
+     }
+
+     return (ok == true) ? 0:-1;
+ }
+
+ void *db_client_t::prefetch_run(void *arg)
+ {
+     prefetch_job_t *job = static_cast<prefetch_job_t *>(arg);
+     db_snapshot_t *snap;
+     db_backend_t *con;
+     unsigned int i;
+
+     // the tables this thread would have taken are read by the others
+     if (connect(job->path, &con) != 0) {
+         return NULL;
+     }
+
+     while ((i = job->next.fetch_add(1)) < job->tables->size()) {
+         snap = new db_snapshot_t;
+         if ((read_table(con, (*job->tables)[i].c_str(), 0, snap) != 0) || (snap->seal() != 0)) {
+             delete snap;
+             continue;
+         }
+         job->snaps[i] = snap;
+     }
+     delete con;
+
+     return NULL;
+ }
+
+ unsigned int db_client_t::prefetch(const std::vector<std::string>& tables)
+ {
+     pthread_t tids[DB_CLIENT_PREFETCH_THREADS];
+     std::vector<std::string> present, names;
+     prefetch_job_t job;
+     unsigned int i, num_threads = 0;
+
+     close_prefetch();
+     if ((m_path.empty() == true) || (get_tables(present) != 0)) {
+         return 0;
+     }
+
+     for (const std::string& table : tables) {
+         if (std::find(present.begin(), present.end(), table) != present.end()) {
+             names.push_back(table);
+         }
+     }
+
+     job.path = m_path.c_str();
+     job.tables = &names;
+     job.snaps.assign(names.size(), NULL);
+     job.next = 0;
+     for (i = 0; (i < names.size()) && (i < DB_CLIENT_PREFETCH_THREADS); i++) {
+         if (pthread_create(&tids[i], NULL, prefetch_run, &job) != 0) {
+             printf("%s:%d: Failed to start prefetch thread %u\n", __func__, __LINE__, i);
+             break;
+         }
+         num_threads++;
+     }
+     for (i = 0; i < num_threads; i++) {
+         pthread_join(tids[i], NULL);
+     }
+
+     for (i = 0; i < job.snaps.size(); i++) {
+         if (job.snaps[i] != NULL) {
+             m_prefetch.push_back(job.snaps[i]);
+         }
+     }
+
+     return static_cast<unsigned int>(m_prefetch.size());
+ }
+
+ void db_client_t::close_prefetch()
+ {
+     for (db_snapshot_t *snap : m_prefetch) {
+         delete snap;
+     }
+     m_prefetch.clear();
+ }
+
+ void *db_client_t::background(void *arg)
+ {
+     db_client_t *client = static_cast<db_client_t *>(arg);
+     const db_snapshot_table_hdr_t *table;
+     unsigned long long checksum;
+     unsigned int i;
+     db_backend_t *con;
+
+     if (client->m_bg_file.empty() == false) {
+         client->save_snapshot(client->m_bg_file.c_str());
+         client->m_bg_done = true;
+         return NULL;
+     }
+
+     // without a connection every table of the snapshot is reloaded from the database
+     client->m_stale.clear();
+     if (connect(client->m_path.c_str(), &con) != 0) {
+         con = NULL;
+     }
+     for (i = 0; (table = client->m_snapshot.get_table(i)) != NULL; i++) {
+         if ((con == NULL) || (con->get_checksum(table->name, &checksum) != 0) || (checksum != table->checksum)) {
+             client->m_stale.push_back(table->name);
+         }
+     }
+     delete con;
+     client->m_bg_done = true;
+
+     return NULL;
+ }
+
+ int db_client_t::start_background(const char *file)
+ {
+     // a finished snapshot job is reaped here, a reconciliation waits for get_reconciled()
+     if ((m_bg_running == true) && ((m_bg_done == false) || (m_bg_file.empty() == true))) {
+         return -1;
+     }
+     stop_background();
+
+     m_bg_file = (file == NULL) ? "":file;
+     m_bg_done = false;
+     if (pthread_create(&m_bg_thread, NULL, background, this) != 0) {
+         printf("%s:%d: Failed to start the background job\n", __func__, __LINE__);
+         return -1;
+     }
+     m_bg_running = true;
+
      return 0;
  }
 
+ void db_client_t::stop_background()
+ {
+     if (m_bg_running == true) {
+         pthread_join(m_bg_thread, NULL);
+         m_bg_running = false;
+     }
+ }
+
+ int db_client_t::start_reconcile()
+ {
+     if (m_snapshot.is_loaded() == false) {
+         return -1;
+     }
+
+     return start_background(NULL);
+ }
+
+ bool db_client_t::get_reconciled(std::vector<std::string>& stale)
+ {
+     if ((m_bg_running == false) || (m_bg_done == false) || (m_bg_file.empty() == false)) {
+         return false;
+     }
+
+     stop_background();
+     stale = m_stale;
+
+     return true;
+ }
+
  int db_client_t::init(const char *path)
  {
-     if (connect(path) != 0) {
+     if (connect(path, &m_con) != 0) {
          printf("%s:%d: Connect failed\n", __func__, __LINE__);
          return -1;
      }
+     m_path = path;
 
      return 0;
  }
 
- db_client_t::db_client_t()
+ db_client_t::db_client_t(): m_con(NULL), m_writer_con(NULL), m_writer(), m_path(), m_snapshot(), m_bg_thread(),
+     m_bg_running(false), m_bg_done(false), m_bg_file(), m_stale(), m_prefetch(), m_rows_read(0),
+     m_change_log(NULL)
  {
-     m_con = NULL;
  }
 
  db_client_t::~db_client_t()
  {
+     stop_background();
+     stop_writer();
+     close_prefetch();
+
      if (m_con) {
-         mysql_close(m_con);
+         delete m_con;
          m_con = NULL;
      }
  }
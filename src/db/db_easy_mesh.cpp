@@ -18,6 +18,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 #include <stdlib.h>
 #include <stdarg.h>
 #include <errno.h>
@@ -38,6 +39,10 @@ char *db_easy_mesh_t::get_column_format(db_fmt_t fmt, unsigned int pos)
             snprintf(fmt, sizeof(db_fmt_t), "%s", "'%s', ");
             break;
 
+        case db_data_type_blob:
+            snprintf(fmt, sizeof(db_fmt_t), "%s", "X'%s', ");
+            break;
+
         case db_data_type_integer:
         case db_data_type_int:
         case db_data_type_smallint:
@@ -53,13 +58,46 @@ char *db_easy_mesh_t::get_column_format(db_fmt_t fmt, unsigned int pos)
     return fmt;
 }
 
+void db_easy_mesh_t::get_row_key(em_2xlong_string_t key, unsigned int first_col, unsigned int num_key_cols, va_list list)
+{
+    unsigned int col;
+    db_fmt_t col_fmt;
+    size_t len;
+
+    memset(key, 0, sizeof(em_2xlong_string_t));
+
+    // the arguments follow the column format of the query, those before column 0 are skipped
+    for (col = first_col; (col != 0) && (col < m_num_cols); col = (col + 1) % m_num_cols) {
+        get_column_format(col_fmt, col);
+        if (strstr(col_fmt, "%s") != NULL) {
+            (void) va_arg(list, char *);
+        } else if (strstr(col_fmt, "%d") != NULL) {
+            (void) va_arg(list, int);
+        }
+    }
+
+    for (col = 0; (col < num_key_cols) && (col < m_num_cols); col++) {
+        len = strlen(key);
+        if (col > 0) {
+            snprintf(key + len, sizeof(em_2xlong_string_t) - len, "@");
+            len = strlen(key);
+        }
+        get_column_format(col_fmt, col);
+        if (strstr(col_fmt, "%s") != NULL) {
+            snprintf(key + len, sizeof(em_2xlong_string_t) - len, "%s", va_arg(list, char *));
+        } else if (strstr(col_fmt, "%d") != NULL) {
+            snprintf(key + len, sizeof(em_2xlong_string_t) - len, "%d", va_arg(list, int));
+        }
+    }
+}
+
 bool db_easy_mesh_t::is_table_empty(db_client_t& db_client)
 {
     db_query_t query;
     void *ctx;
     bool ret = false;
 
-    snprintf(query, sizeof(db_query_t), "select * from %s", m_table_name);
+    snprintf(query, sizeof(db_query_t), "select 1 from %s limit 1", m_table_name);
     ctx = db_client.execute(query);
 
     if (db_client.next_result(ctx) == false) {
@@ -112,7 +150,7 @@ int db_easy_mesh_t::insert_row(db_client_t& db_client, ...)
     va_list list;
     db_query_t format, query;
     db_fmt_t	col_fmt;
-    void *ctx;
+    em_2xlong_string_t key;
 
     snprintf(format, sizeof(db_query_t), "insert into %s (", m_table_name);
     for (i = 0; i < m_num_cols; i++) {
@@ -135,12 +173,13 @@ int db_easy_mesh_t::insert_row(db_client_t& db_client, ...)
     (void) vsnprintf(query, sizeof(db_query_t), format, list);
     va_end(list);
 
-    //printf("%s:%d: Query: %s\n", __func__, __LINE__, query);
+    va_start(list, db_client);
+    get_row_key(key, 0, 1, list);
+    va_end(list);
 
-    ctx = db_client.execute(query);
-    while (db_client.next_result(ctx) == true);
+    //printf("%s:%d: Query: %s\n", __func__, __LINE__, query);
 
-    return 0;
+    return db_client.write(m_table_name, key, db_write_op_insert, query);
 }
 
 int db_easy_mesh_t::update_row(db_client_t& db_client, ...)
@@ -149,7 +188,7 @@ int db_easy_mesh_t::update_row(db_client_t& db_client, ...)
     db_query_t	tmp, format, query;
     va_list list;
     db_fmt_t	col_fmt;
-    void *ctx;
+    em_2xlong_string_t key;
 
     snprintf(format, sizeof(db_query_t), "update %s set ", m_table_name);
 
@@ -171,12 +210,13 @@ int db_easy_mesh_t::update_row(db_client_t& db_client, ...)
     (void) vsnprintf(query, sizeof(db_query_t), format, list);
     va_end(list);
 
-    //printf("%s:%d: Query: %s\n", __func__, __LINE__, query);
+    va_start(list, db_client);
+    get_row_key(key, 1, 1, list);
+    va_end(list);
 
-    ctx = db_client.execute(query);
-    while (db_client.next_result(ctx) == true);
+    //printf("%s:%d: Query: %s\n", __func__, __LINE__, query);
 
-    return 0;
+    return db_client.write(m_table_name, key, db_write_op_update, query);
 }
 
 int db_easy_mesh_t::compare_row(db_client_t& db_client, ...)
@@ -215,7 +255,7 @@ int db_easy_mesh_t::delete_row(db_client_t& db_client, ...)
     db_query_t	tmp, format, query;
     va_list list;
     db_fmt_t	col_fmt;
-    void *ctx;
+    em_2xlong_string_t key;
 
     snprintf(format, sizeof(db_query_t), "delete from %s", m_table_name);
     snprintf(tmp, sizeof(db_query_t), " where %s =  ", m_columns[0].m_name);
@@ -228,12 +268,13 @@ int db_easy_mesh_t::delete_row(db_client_t& db_client, ...)
     (void) vsnprintf(query, sizeof(db_query_t), format, list);
     va_end(list);
 
-    //printf("%s:%d: Query: %s\n", __func__, __LINE__, query);
+    va_start(list, db_client);
+    get_row_key(key, 0, 1, list);
+    va_end(list);
 
-    ctx = db_client.execute(query);
-    while (db_client.next_result(ctx) == true);
+    //printf("%s:%d: Query: %s\n", __func__, __LINE__, query);
 
-    return 0;
+    return db_client.write(m_table_name, key, db_write_op_delete, query);
 }
 
 
@@ -242,6 +283,9 @@ int db_easy_mesh_t::sync_table(db_client_t& db_client)
     db_query_t    query;
     void *ctx;
 
+    // the rows are read back, what is still queued must be written first
+    db_client.flush();
+
     memset(query, 0, sizeof(db_query_t));
     snprintf(query, sizeof(db_query_t), "select * from %s", m_table_name);
 
@@ -251,23 +295,54 @@ int db_easy_mesh_t::sync_table(db_client_t& db_client)
 
 }
 
-bool db_easy_mesh_t::entry_exists_in_table(db_client_t& db_client, void *key)
+void *db_easy_mesh_t::select_by_key(db_client_t& db_client, const char *key, unsigned int max)
 {
     db_query_t    query;
-    void *ctx;
-    
+
     memset(query, 0, sizeof(db_query_t));
-    snprintf(query, sizeof(db_query_t), "select * from %s", m_table_name);
+    snprintf(query, sizeof(db_query_t), "select * from %s where %s = '%s'", m_table_name, m_columns[0].m_name, key);
+    if (max != 0) {
+        snprintf(query + strlen(query), sizeof(query) - strlen(query), " limit %d", max);
+    }
 
-    ctx = db_client.execute(query);
+    return db_client.execute(query);
+}
+
+void db_easy_mesh_t::create_key_index(db_client_t& db_client)
+{
+    db_query_t    query;
+
+    memset(query, 0, sizeof(db_query_t));
+    snprintf(query, sizeof(db_query_t), "create index if not exists %sKey on %s (%s)", m_table_name, m_table_name,
+            m_columns[0].m_name);
+    db_client.execute(query);
+}
+
+bool db_easy_mesh_t::entry_exists_in_table(db_client_t& db_client, void *key)
+{
+    void *ctx;
+    db_write_op_t op;
+    bool found;
 
-    return search_db(db_client, ctx, key);
+    // a row that is not written yet exists unless its last write deletes it
+    if (db_client.get_pending(m_table_name, static_cast<char *>(key), &op) == true) {
+        return (op != db_write_op_delete);
+    }
+
+    // the row matched the key, the context is released by the last next_result()
+    ctx = select_by_key(db_client, static_cast<char *>(key), 1);
+    found = db_client.next_result(ctx);
+    while ((found == true) && (db_client.next_result(ctx) == true));
+
+    return found;
 }
 
 void db_easy_mesh_t::delete_table(db_client_t& db_client)
 {
     db_query_t    query;
 
+    db_client.flush();
+
     memset(query, 0, sizeof(db_query_t));
     snprintf(query, sizeof(db_query_t), "drop table %s", m_table_name);
     db_client.execute(query);
@@ -279,6 +354,8 @@ int db_easy_mesh_t::create_table(db_client_t& db_client)
     unsigned int i;
     char type_str[64];
 
+    db_client.flush();
+
     memset(query, 0, sizeof(db_query_t));
     snprintf(query, sizeof(db_query_t), "create table %s (", m_table_name);
 
@@ -331,37 +408,78 @@ int db_easy_mesh_t::create_table(db_client_t& db_client)
                 snprintf(type_str, sizeof(type_str), "mediumint");
                 break;
 
+            case db_data_type_blob:
+                snprintf(type_str, sizeof(type_str), "blob");
+                break;
+
             default:
                 assert(0);
                 break;	
         }
         snprintf(query + strlen(query), sizeof(query) - strlen(query), "%s", type_str);
-        snprintf(query + strlen(query), sizeof(query) - strlen(query), "%s", ", ");
+        snprintf(query + strlen(query), sizeof(query) - strlen(query), "%s", (i + 1 < m_num_cols) ? ", ":")");
     }
 
-    query[strlen(query) - 2] = ')';
-    query[strlen(query) - 1] = 0;
     db_client.execute(query);
     //printf("%s:%d: Query: %s\n", __func__, __LINE__, query);
 
+    // rows are looked up by the key in their first column, SQLite has no index in create table
+    create_key_index(db_client);
+
     return 0;
 }
 
+void db_easy_mesh_t::upgrade_columns(db_client_t& db_client)
+{
+#ifndef EM_DB_SQLITE
+    db_query_t query;
+    em_short_string_t type;
+    unsigned int i;
+    void *ctx;
+    bool upgrade;
+
+    // the binary columns of older tables are text, the bytes would not be stored as they are
+    for (i = 0; i < m_num_cols; i++) {
+        if (m_columns[i].m_type != db_data_type_blob) {
+            continue;
+        }
+        snprintf(query, sizeof(db_query_t), "select data_type from information_schema.columns where "
+                "table_schema = database() and table_name = '%s' and column_name = '%s'", m_table_name, m_columns[i].m_name);
+        ctx = db_client.execute(query);
+        upgrade = false;
+        while (db_client.next_result(ctx) == true) {
+            memset(type, 0, sizeof(em_short_string_t));
+            db_client.get_string(ctx, type, 1);
+            upgrade = (strncasecmp(type, "blob", strlen("blob")) != 0);
+        }
+        if (upgrade == true) {
+            printf("%s:%d: Table: %s column: %s changed to blob\n", __func__, __LINE__, m_table_name, m_columns[i].m_name);
+            snprintf(query, sizeof(db_query_t), "alter table %s modify %s blob", m_table_name, m_columns[i].m_name);
+            db_client.execute(query);
+        }
+    }
+#else
+    // SQLite keeps a blob as it is whatever the column type
+    (void) db_client;
+#endif
+}
+
 int db_easy_mesh_t::load_table(db_client_t& db_client)
 {
-    db_query_t    query;
-    db_result_t   result;
+    std::vector<std::string> tables;
     void *ctx;
     bool present = false;
 
-    memset(query, 0, sizeof(db_query_t));
-    snprintf(query, sizeof(db_query_t), "show tables");
-
-    ctx = db_client.execute(query);
+    // the rows of the snapshot are reconciled with the database once the controller runs
+    if ((ctx = db_client.execute_snapshot(m_table_name)) != NULL) {
+        create_key_index(db_client);
+        upgrade_columns(db_client);
+        return sync_db(db_client, ctx);
+    }
 
-    while (db_client.next_result(ctx)) {
-        db_client.get_string(ctx, result, 1);
-        if (strncmp(result, m_table_name, strlen(m_table_name)) == 0) {
+    db_client.get_tables(tables);
+    for (const std::string& table : tables) {
+        if (strncmp(table.c_str(), m_table_name, strlen(m_table_name)) == 0) {
             present = true;
         }
     }
@@ -369,6 +487,8 @@ int db_easy_mesh_t::load_table(db_client_t& db_client)
     //printf("%s:%d: Table: %s %s\n", __func__, __LINE__, m_table_name, (present == true) ? "present":"not present");
 
     if (present == true) {
+        create_key_index(db_client);
+        upgrade_columns(db_client);
         sync_table(db_client);
     } else {
         create_table(db_client);
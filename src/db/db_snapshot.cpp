@@ -0,0 +1,366 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "db_snapshot.h"
+
+int db_snapshot_t::add_table(const char *name, unsigned int num_cols, unsigned long long checksum)
+{
+    db_snapshot_table_hdr_t table;
+
+    if ((m_tables.size() >= DB_SNAPSHOT_MAX_TABLES) || (num_cols > DB_SNAPSHOT_MAX_COLS)) {
+        printf("%s:%d: Table %s of %d columns does not fit\n", __func__, __LINE__, name, num_cols);
+        return -1;
+    }
+
+    memset(&table, 0, sizeof(db_snapshot_table_hdr_t));
+    snprintf(table.name, sizeof(table.name), "%s", name);
+    table.num_cols = num_cols;
+    table.offset = m_rows.length();
+    table.checksum = checksum;
+    m_tables.push_back(table);
+
+    return 0;
+}
+
+int db_snapshot_t::add_row(const char *const *vals, const unsigned long *lens)
+{
+    db_snapshot_table_hdr_t *table;
+    uint32_t len;
+    unsigned int i;
+    size_t start;
+
+    if (m_tables.empty() == true) {
+        return -1;
+    }
+
+    table = &m_tables.back();
+    start = m_rows.length();
+    for (i = 0; i < table->num_cols; i++) {
+        len = (vals[i] == NULL) ? DB_SNAPSHOT_NULL:static_cast<uint32_t>(lens[i]);
+        m_rows.append(reinterpret_cast<const char *>(&len), sizeof(len));
+        if (vals[i] != NULL) {
+            m_rows.append(vals[i], lens[i]);
+            m_rows.push_back('\0');
+        }
+    }
+    table->num_rows++;
+    table->len += m_rows.length() - start;
+
+    return 0;
+}
+
+int db_snapshot_t::save(const char *file)
+{
+    db_snapshot_hdr_t hdr;
+    std::string tmp(file);
+    size_t dir_sz = m_tables.size() * sizeof(db_snapshot_table_hdr_t);
+    unsigned int i;
+    FILE *fp;
+    bool ok;
+
+    memset(&hdr, 0, sizeof(db_snapshot_hdr_t));
+    hdr.magic = DB_SNAPSHOT_MAGIC;
+    hdr.version = DB_SNAPSHOT_VERSION;
+    hdr.num_tables = static_cast<uint32_t>(m_tables.size());
+    hdr.size = sizeof(db_snapshot_hdr_t) + dir_sz + m_rows.length();
+
+    // offsets were relative to the rows, the rows follow the directory
+    for (i = 0; i < m_tables.size(); i++) {
+        m_tables[i].offset += sizeof(db_snapshot_hdr_t) + dir_sz;
+    }
+
+    tmp += ".tmp";
+    if ((fp = fopen(tmp.c_str(), "wb")) == NULL) {
+        printf("%s:%d: Failed to open %s\n", __func__, __LINE__, tmp.c_str());
+        ok = false;
+    } else {
+        ok = (fwrite(&hdr, sizeof(db_snapshot_hdr_t), 1, fp) == 1) &&
+            ((dir_sz == 0) || (fwrite(m_tables.data(), dir_sz, 1, fp) == 1)) &&
+            ((m_rows.length() == 0) || (fwrite(m_rows.data(), m_rows.length(), 1, fp) == 1)) &&
+            (fflush(fp) == 0) && (fsync(fileno(fp)) == 0);
+        ok = (fclose(fp) == 0) && ok;
+    }
+
+    for (i = 0; i < m_tables.size(); i++) {
+        m_tables[i].offset -= sizeof(db_snapshot_hdr_t) + dir_sz;
+    }
+
+    if ((ok == false) || (rename(tmp.c_str(), file) != 0)) {
+        printf("%s:%d: Failed to write snapshot %s\n", __func__, __LINE__, file);
+        unlink(tmp.c_str());
+        return -1;
+    }
+
+    return 0;
+}
+
+void db_snapshot_t::save_image(std::string& out)
+{
+    db_snapshot_hdr_t hdr;
+    size_t dir_sz = m_tables.size() * sizeof(db_snapshot_table_hdr_t);
+    unsigned int i;
+
+    memset(&hdr, 0, sizeof(db_snapshot_hdr_t));
+    hdr.magic = DB_SNAPSHOT_MAGIC;
+    hdr.version = DB_SNAPSHOT_VERSION;
+    hdr.num_tables = static_cast<uint32_t>(m_tables.size());
+    hdr.size = sizeof(db_snapshot_hdr_t) + dir_sz + m_rows.length();
+
+    out.reserve(out.length() + hdr.size);
+    out.append(reinterpret_cast<const char *>(&hdr), sizeof(db_snapshot_hdr_t));
+    for (i = 0; i < m_tables.size(); i++) {
+        m_tables[i].offset += sizeof(db_snapshot_hdr_t) + dir_sz;
+        out.append(reinterpret_cast<const char *>(&m_tables[i]), sizeof(db_snapshot_table_hdr_t));
+        m_tables[i].offset -= sizeof(db_snapshot_hdr_t) + dir_sz;
+    }
+    out.append(m_rows);
+}
+
+int db_snapshot_t::load_image(std::string& image)
+{
+    unload();
+
+    if (image.empty() == true) {
+        return -1;
+    }
+    m_image.swap(image);
+    m_map = &m_image[0];
+    m_map_sz = m_image.length();
+
+    if (validate() != 0) {
+        unload();
+        return -1;
+    }
+
+    return 0;
+}
+
+int db_snapshot_t::seal()
+{
+    db_snapshot_hdr_t hdr;
+    size_t dir_sz = m_tables.size() * sizeof(db_snapshot_table_hdr_t);
+    unsigned int i;
+
+    if (m_map != NULL) {
+        return -1;
+    }
+
+    memset(&hdr, 0, sizeof(db_snapshot_hdr_t));
+    hdr.magic = DB_SNAPSHOT_MAGIC;
+    hdr.version = DB_SNAPSHOT_VERSION;
+    hdr.num_tables = static_cast<uint32_t>(m_tables.size());
+    hdr.size = sizeof(db_snapshot_hdr_t) + dir_sz + m_rows.length();
+
+    for (i = 0; i < m_tables.size(); i++) {
+        m_tables[i].offset += sizeof(db_snapshot_hdr_t) + dir_sz;
+    }
+
+    // laid out as in a file, the rows are moved once and read in place
+    m_image.reserve(hdr.size);
+    m_image.append(reinterpret_cast<const char *>(&hdr), sizeof(db_snapshot_hdr_t));
+    if (dir_sz != 0) {
+        m_image.append(reinterpret_cast<const char *>(m_tables.data()), dir_sz);
+    }
+    m_image.append(m_rows);
+    std::string().swap(m_rows);
+    std::vector<db_snapshot_table_hdr_t>().swap(m_tables);
+
+    m_map = &m_image[0];
+    m_map_sz = m_image.length();
+    m_dir = reinterpret_cast<const db_snapshot_table_hdr_t *>(m_image.data() + sizeof(db_snapshot_hdr_t));
+
+    return 0;
+}
+
+int db_snapshot_t::validate()
+{
+    const db_snapshot_hdr_t *hdr = static_cast<const db_snapshot_hdr_t *>(m_map);
+    db_snapshot_cursor_t cur;
+    size_t dir_end;
+    unsigned int i, num;
+
+    if ((m_map_sz < sizeof(db_snapshot_hdr_t)) || (hdr->magic != DB_SNAPSHOT_MAGIC)) {
+        printf("%s:%d: Not a snapshot\n", __func__, __LINE__);
+        return -1;
+    }
+    if (hdr->version != DB_SNAPSHOT_VERSION) {
+        printf("%s:%d: Snapshot version %d, expected %d\n", __func__, __LINE__, hdr->version, DB_SNAPSHOT_VERSION);
+        return -1;
+    }
+    dir_end = sizeof(db_snapshot_hdr_t) + hdr->num_tables * sizeof(db_snapshot_table_hdr_t);
+    if ((hdr->size != m_map_sz) || (hdr->num_tables > DB_SNAPSHOT_MAX_TABLES) || (dir_end > m_map_sz)) {
+        printf("%s:%d: Snapshot truncated\n", __func__, __LINE__);
+        return -1;
+    }
+
+    m_dir = reinterpret_cast<const db_snapshot_table_hdr_t *>(static_cast<const char *>(m_map) + sizeof(db_snapshot_hdr_t));
+    for (i = 0; i < hdr->num_tables; i++) {
+        if ((m_dir[i].num_cols > DB_SNAPSHOT_MAX_COLS) || (m_dir[i].offset < dir_end) ||
+                (m_dir[i].offset > m_map_sz) || (m_dir[i].len > (m_map_sz - m_dir[i].offset)) ||
+                (memchr(m_dir[i].name, '\0', sizeof(m_dir[i].name)) == NULL)) {
+            printf("%s:%d: Snapshot table %d corrupt\n", __func__, __LINE__, i);
+            return -1;
+        }
+    }
+
+    // a table is read in full or not at all, every row is checked before one is used
+    for (i = 0; i < hdr->num_tables; i++) {
+        open_table(m_dir[i].name, &cur);
+        for (num = 0; next_row(&cur) == true; num++);
+        if ((num != m_dir[i].num_rows) || (cur.pos != cur.end)) {
+            printf("%s:%d: Snapshot table %s corrupt\n", __func__, __LINE__, m_dir[i].name);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int db_snapshot_t::load(const char *file)
+{
+    struct stat st;
+    void *map;
+    int fd;
+
+    unload();
+
+    if ((fd = open(file, O_RDONLY)) < 0) {
+        return -1;
+    }
+    if ((fstat(fd, &st) != 0) || (st.st_size <= 0)) {
+        close(fd);
+        return -1;
+    }
+
+    map = mmap(NULL, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        printf("%s:%d: Failed to map %s\n", __func__, __LINE__, file);
+        return -1;
+    }
+    m_map = map;
+    m_map_sz = static_cast<size_t>(st.st_size);
+
+    if (validate() != 0) {
+        unload();
+        return -1;
+    }
+
+    return 0;
+}
+
+void db_snapshot_t::unload()
+{
+    if (m_image.empty() == false) {
+        std::string().swap(m_image);
+    } else if (m_map != NULL) {
+        munmap(m_map, m_map_sz);
+    }
+    m_map = NULL;
+    m_map_sz = 0;
+    m_dir = NULL;
+}
+
+unsigned int db_snapshot_t::get_num_tables() const
+{
+    return (m_map == NULL) ? 0:static_cast<const db_snapshot_hdr_t *>(m_map)->num_tables;
+}
+
+const db_snapshot_table_hdr_t *db_snapshot_t::get_table(unsigned int idx) const
+{
+    return (idx < get_num_tables()) ? &m_dir[idx]:NULL;
+}
+
+const db_snapshot_table_hdr_t *db_snapshot_t::get_table(const char *name) const
+{
+    unsigned int i;
+
+    for (i = 0; i < get_num_tables(); i++) {
+        if (strcmp(m_dir[i].name, name) == 0) {
+            return &m_dir[i];
+        }
+    }
+
+    return NULL;
+}
+
+int db_snapshot_t::open_table(const char *name, db_snapshot_cursor_t *cur) const
+{
+    const db_snapshot_table_hdr_t *table;
+
+    if ((table = get_table(name)) == NULL) {
+        return -1;
+    }
+
+    memset(cur, 0, sizeof(db_snapshot_cursor_t));
+    cur->pos = static_cast<const char *>(m_map) + table->offset;
+    cur->end = cur->pos + table->len;
+    cur->num_cols = table->num_cols;
+
+    return 0;
+}
+
+bool db_snapshot_t::next_row(db_snapshot_cursor_t *cur) const
+{
+    uint32_t len;
+    unsigned int i;
+
+    if ((cur->pos >= cur->end) || (cur->num_cols == 0)) {
+        return false;
+    }
+
+    for (i = 0; i < cur->num_cols; i++) {
+        if (static_cast<size_t>(cur->end - cur->pos) < sizeof(len)) {
+            printf("%s:%d: Snapshot row truncated\n", __func__, __LINE__);
+            return false;
+        }
+        memcpy(&len, cur->pos, sizeof(len));
+        cur->pos += sizeof(len);
+
+        if (len == DB_SNAPSHOT_NULL) {
+            cur->cols[i] = NULL;
+            cur->lens[i] = 0;
+            continue;
+        }
+        if ((static_cast<size_t>(cur->end - cur->pos) <= len) || (cur->pos[len] != '\0')) {
+            printf("%s:%d: Snapshot row truncated\n", __func__, __LINE__);
+            return false;
+        }
+        cur->cols[i] = cur->pos;
+        cur->lens[i] = len;
+        cur->pos += len + 1;
+    }
+
+    return true;
+}
+
+db_snapshot_t::db_snapshot_t(): m_tables(), m_rows(), m_image(), m_map(NULL), m_map_sz(0), m_dir(NULL)
+{
+}
+
+db_snapshot_t::~db_snapshot_t()
+{
+    unload();
+}
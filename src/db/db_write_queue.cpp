@@ -0,0 +1,293 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <new>
+#include "db_write_queue.h"
+
+std::string db_write_queue_t::get_id(const char *table, const char *key)
+{
+    std::string id(table);
+
+    // table names have no spaces, the id can not be ambiguous
+    id += ' ';
+    id += key;
+
+    return id;
+}
+
+bool db_write_queue_t::merge_insert(const std::string& id, const char *query)
+{
+    const char *values;
+    size_t prefix_len, len;
+    char *tmp;
+
+    if ((m_tail == NULL) || (m_tail->in_flight == true) || (m_tail->op != db_write_op_insert)) {
+        return false;
+    }
+    if ((values = strstr(query, " values(")) == NULL) {
+        return false;
+    }
+
+    // same table and columns, the values of the row become one more tuple of the insert
+    values += strlen(" values(");
+    prefix_len = static_cast<size_t>(values - query);
+    if (strncmp(m_tail->query, query, prefix_len) != 0) {
+        return false;
+    }
+    len = strlen(m_tail->query);
+    if ((len + strlen(values) + 3) > DB_WRITE_QUEUE_MAX_QUERY) {
+        return false;
+    }
+    if ((tmp = static_cast<char *>(realloc(m_tail->query, len + strlen(values) + 4))) == NULL) {
+        return false;
+    }
+    snprintf(tmp + len, strlen(values) + 4, ", (%s", values);
+    m_tail->query = tmp;
+    m_tail->ids.push_back(id);
+
+    return true;
+}
+
+unsigned int db_write_queue_t::write_batch()
+{
+    char *queries[DB_WRITE_QUEUE_BATCH_SZ];
+    bool failed[DB_WRITE_QUEUE_BATCH_SZ] = {};
+    db_write_t *w, *next;
+    unsigned int num = 0, rows = 0, i;
+    std::unordered_map<std::string, db_write_t *>::iterator it;
+
+    for (w = m_head; (w != NULL) && (num < m_batch_sz); w = w->next) {
+        w->in_flight = true;
+        queries[num++] = w->query;
+    }
+    if (num == 0) {
+        return 0;
+    }
+
+    pthread_mutex_unlock(&m_lock);
+    m_batch(m_arg, queries, num, failed);
+    pthread_mutex_lock(&m_lock);
+
+    for (i = 0, w = m_head; i < num; i++, w = next) {
+        next = w->next;
+        for (const std::string& id : w->ids) {
+            if (((it = m_pending.find(id)) != m_pending.end()) && (it->second == w)) {
+                m_pending.erase(it);
+            }
+        }
+        rows += static_cast<unsigned int>(w->ids.size());
+        if (failed[i] == true) {
+            m_stats.failed += w->ids.size();
+        } else {
+            m_stats.written += w->ids.size();
+        }
+        free(w->query);
+        delete w;
+    }
+    m_head = w;
+    if (m_head == NULL) {
+        m_tail = NULL;
+    }
+
+    m_stats.depth -= rows;
+    m_stats.batches++;
+    pthread_cond_broadcast(&m_idle_cond);
+
+    return num;
+}
+
+void *db_write_queue_t::writer(void *arg)
+{
+    db_write_queue_t *q = static_cast<db_write_queue_t *>(arg);
+
+    pthread_mutex_lock(&q->m_lock);
+    while (true) {
+        if (q->write_batch() > 0) {
+            continue;
+        }
+        if (q->m_exit == true) {
+            break;
+        }
+        pthread_cond_wait(&q->m_work_cond, &q->m_lock);
+    }
+    pthread_mutex_unlock(&q->m_lock);
+
+    return NULL;
+}
+
+int db_write_queue_t::start(db_write_batch_t batch, void *arg, unsigned int batch_sz)
+{
+    if (m_running == true) {
+        return 0;
+    }
+
+    m_batch = batch;
+    m_arg = arg;
+    m_batch_sz = ((batch_sz == 0) || (batch_sz > DB_WRITE_QUEUE_BATCH_SZ)) ? DB_WRITE_QUEUE_BATCH_SZ:batch_sz;
+    m_exit = false;
+
+    if (pthread_create(&m_thread, NULL, writer, this) != 0) {
+        printf("%s:%d: Failed to start the writer thread\n", __func__, __LINE__);
+        return -1;
+    }
+    m_running = true;
+
+    return 0;
+}
+
+void db_write_queue_t::stop()
+{
+    if (m_running == false) {
+        return;
+    }
+
+    // the worker writes what is left before it exits
+    pthread_mutex_lock(&m_lock);
+    m_exit = true;
+    pthread_cond_signal(&m_work_cond);
+    pthread_mutex_unlock(&m_lock);
+
+    pthread_join(m_thread, NULL);
+    m_running = false;
+}
+
+int db_write_queue_t::push(const char *table, const char *key, db_write_op_t op, const char *query)
+{
+    std::string id;
+    std::unordered_map<std::string, db_write_t *>::iterator it;
+    db_write_t *w;
+    char *tmp;
+
+    if (m_running == false) {
+        return -1;
+    }
+    if ((tmp = strdup(query)) == NULL) {
+        printf("%s:%d: Failed to allocate query\n", __func__, __LINE__);
+        return -1;
+    }
+    id = get_id(table, key);
+
+    pthread_mutex_lock(&m_lock);
+
+    m_stats.queued++;
+
+    // a full row update or a delete makes a pending update of the same row useless
+    it = m_pending.find(id);
+    if ((it != m_pending.end()) && (it->second->in_flight == false) &&
+            (it->second->op == db_write_op_update) && (op != db_write_op_insert)) {
+        free(it->second->query);
+        it->second->query = tmp;
+        it->second->op = op;
+        m_stats.coalesced++;
+        pthread_mutex_unlock(&m_lock);
+        return 0;
+    }
+
+    if (m_stats.depth >= DB_WRITE_QUEUE_MAX_DEPTH) {
+        m_stats.stalls++;
+        while (m_stats.depth >= DB_WRITE_QUEUE_MAX_DEPTH) {
+            pthread_cond_wait(&m_idle_cond, &m_lock);
+        }
+    }
+
+    if ((op == db_write_op_insert) && (merge_insert(id, tmp) == true)) {
+        free(tmp);
+        m_pending[id] = m_tail;
+        m_stats.merged++;
+    } else if ((w = new (std::nothrow) db_write_t) == NULL) {
+        printf("%s:%d: Failed to allocate write\n", __func__, __LINE__);
+        pthread_mutex_unlock(&m_lock);
+        free(tmp);
+        return -1;
+    } else {
+        w->ids.push_back(id);
+        w->op = op;
+        w->query = tmp;
+        w->in_flight = false;
+        w->next = NULL;
+
+        if (m_tail != NULL) {
+            m_tail->next = w;
+        } else {
+            m_head = w;
+        }
+        m_tail = w;
+        m_pending[id] = w;
+    }
+
+    m_stats.depth++;
+    if (m_stats.depth > m_stats.max_depth) {
+        m_stats.max_depth = m_stats.depth;
+    }
+    pthread_cond_signal(&m_work_cond);
+
+    pthread_mutex_unlock(&m_lock);
+
+    return 0;
+}
+
+void db_write_queue_t::flush()
+{
+    pthread_mutex_lock(&m_lock);
+    while (m_head != NULL) {
+        pthread_cond_wait(&m_idle_cond, &m_lock);
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+bool db_write_queue_t::get_pending(const char *table, const char *key, db_write_op_t *op)
+{
+    std::unordered_map<std::string, db_write_t *>::iterator it;
+    bool found = false;
+
+    pthread_mutex_lock(&m_lock);
+    if ((it = m_pending.find(get_id(table, key))) != m_pending.end()) {
+        *op = it->second->op;
+        found = true;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return found;
+}
+
+void db_write_queue_t::get_stats(db_write_queue_stats_t *stats)
+{
+    pthread_mutex_lock(&m_lock);
+    memcpy(stats, &m_stats, sizeof(db_write_queue_stats_t));
+    pthread_mutex_unlock(&m_lock);
+}
+
+db_write_queue_t::db_write_queue_t(): m_lock(), m_work_cond(), m_idle_cond(), m_thread(), m_running(false),
+    m_exit(false), m_batch(NULL), m_arg(NULL), m_batch_sz(DB_WRITE_QUEUE_BATCH_SZ), m_head(NULL), m_tail(NULL),
+    m_pending(), m_stats()
+{
+    pthread_mutex_init(&m_lock, NULL);
+    pthread_cond_init(&m_work_cond, NULL);
+    pthread_cond_init(&m_idle_cond, NULL);
+}
+
+db_write_queue_t::~db_write_queue_t()
+{
+    stop();
+    pthread_mutex_destroy(&m_lock);
+    pthread_cond_destroy(&m_work_cond);
+    pthread_cond_destroy(&m_idle_cond);
+}
@@ -0,0 +1,119 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <algorithm>
+#include "dm_cfg_delta.h"
+
+unsigned int dm_cfg_delta_t::radio(const em_radio_info_t *cur, const em_radio_info_t *dec)
+{
+    unsigned int delta = DM_CFG_DELTA_NONE;
+
+    if (cur == NULL) {
+        return DM_CFG_DELTA_NEW | DM_CFG_DELTA_CHANNEL | DM_CFG_DELTA_RADIO;
+    }
+
+    if (cur->transmit_power_limit != dec->transmit_power_limit) {
+        delta |= DM_CFG_DELTA_CHANNEL;
+    }
+
+    if ((memcmp(&cur->intf, &dec->intf, sizeof(em_interface_t)) != 0) || (cur->enabled != dec->enabled) ||
+            (cur->band != dec->band) || (cur->number_of_bss != dec->number_of_bss) ||
+            (memcmp(&cur->media_data, &dec->media_data, sizeof(em_media_spec_data_t)) != 0) ||
+            (strncmp(cur->chip_vendor, dec->chip_vendor, sizeof(em_long_string_t)) != 0) ||
+            (cur->partial_bss_color != dec->partial_bss_color) || (cur->bss_color != dec->bss_color) ||
+            (cur->hesiga_spatial_reuse_value15_allowed != dec->hesiga_spatial_reuse_value15_allowed) ||
+            (cur->srg_information_valid != dec->srg_information_valid) ||
+            (cur->non_srg_offset_valid != dec->non_srg_offset_valid) || (cur->psr_disallowed != dec->psr_disallowed) ||
+            (cur->non_srg_obsspd_max_offset != dec->non_srg_obsspd_max_offset) ||
+            (cur->srg_obsspd_min_offset != dec->srg_obsspd_min_offset) ||
+            (cur->srg_obsspd_max_offset != dec->srg_obsspd_max_offset) ||
+            (memcmp(cur->srg_bss_color_bitmap, dec->srg_bss_color_bitmap, sizeof(cur->srg_bss_color_bitmap)) != 0) ||
+            (memcmp(cur->srg_partial_bssid_bitmap, dec->srg_partial_bssid_bitmap, sizeof(cur->srg_partial_bssid_bitmap)) != 0) ||
+            (memcmp(cur->neigh_bss_color_in_use_bitmap, dec->neigh_bss_color_in_use_bitmap, sizeof(cur->neigh_bss_color_in_use_bitmap)) != 0)) {
+        delta |= DM_CFG_DELTA_RADIO;
+    }
+
+    return delta;
+}
+
+unsigned int dm_cfg_delta_t::op_class(const em_op_class_info_t *cur, const em_op_class_info_t *dec)
+{
+    unsigned int kind = (dec->id.type == em_op_class_type_current) ? DM_CFG_DELTA_CHANNEL:DM_CFG_DELTA_RADIO;
+
+    if (cur == NULL) {
+        return DM_CFG_DELTA_NEW | kind;
+    }
+
+    if ((cur->op_class != dec->op_class) || (cur->channel != dec->channel) || (cur->tx_power != dec->tx_power) ||
+            (cur->max_tx_power != dec->max_tx_power) || (cur->num_channels != dec->num_channels) ||
+            (memcmp(cur->channels, dec->channels, sizeof(cur->channels[0]) * std::min(cur->num_channels,
+                static_cast<unsigned int> (EM_MAX_CHANNELS_IN_LIST))) != 0)) {
+        return kind;
+    }
+
+    return DM_CFG_DELTA_NONE;
+}
+
+unsigned int dm_cfg_delta_t::bss(const em_bss_info_t *cur, const em_bss_info_t *dec)
+{
+    unsigned int i;
+
+    if (cur == NULL) {
+        return DM_CFG_DELTA_NEW | DM_CFG_DELTA_BSS;
+    }
+
+    if ((cur->vap_index != dec->vap_index) || (cur->vap_mode != dec->vap_mode) ||
+            (memcmp(&cur->ruid, &dec->ruid, sizeof(em_interface_t)) != 0) ||
+            (cur->id.haul_type != dec->id.haul_type) ||
+            (strncmp(cur->ssid, dec->ssid, sizeof(ssid_t)) != 0) || (cur->enabled != dec->enabled) ||
+            (cur->num_fronthaul_akms != dec->num_fronthaul_akms) || (cur->num_backhaul_akms != dec->num_backhaul_akms) ||
+            (cur->profile_1b_sta_allowed != dec->profile_1b_sta_allowed) ||
+            (cur->profile_2b_sta_allowed != dec->profile_2b_sta_allowed) ||
+            (cur->assoc_allowed_status != dec->assoc_allowed_status) ||
+            (cur->backhaul_use != dec->backhaul_use) || (cur->fronthaul_use != dec->fronthaul_use) ||
+            (cur->r1_disallowed != dec->r1_disallowed) || (cur->r2_disallowed != dec->r2_disallowed) ||
+            (cur->multi_bssid != dec->multi_bssid) || (cur->transmitted_bssid != dec->transmitted_bssid) ||
+            (memcmp(&cur->eht_ops, &dec->eht_ops, sizeof(em_eht_operations_bss_t)) != 0) ||
+            (strncmp(cur->mesh_sta_passphrase, dec->mesh_sta_passphrase, sizeof(em_short_string_t)) != 0) ||
+            (cur->vlan_id != dec->vlan_id) || (memcmp(cur->mld_mac, dec->mld_mac, sizeof(mac_address_t)) != 0) ||
+            (memcmp(cur->sta_mac, dec->sta_mac, sizeof(mac_address_t)) != 0) ||
+            (cur->vendor_elements_len != dec->vendor_elements_len) ||
+            (memcmp(cur->vendor_elements, dec->vendor_elements, std::min(cur->vendor_elements_len, sizeof(cur->vendor_elements))) != 0) ||
+            (cur->connect_status != dec->connect_status)) {
+        return DM_CFG_DELTA_BSS;
+    }
+
+    for (i = 0; (i < cur->num_fronthaul_akms) && (i < EM_MAX_AKMS); i++) {
+        if (strncmp(cur->fronthaul_akm[i], dec->fronthaul_akm[i], sizeof(em_short_string_t)) != 0) {
+            return DM_CFG_DELTA_BSS;
+        }
+    }
+    for (i = 0; (i < cur->num_backhaul_akms) && (i < EM_MAX_AKMS); i++) {
+        if (strncmp(cur->backhaul_akm[i], dec->backhaul_akm[i], sizeof(em_short_string_t)) != 0) {
+            return DM_CFG_DELTA_BSS;
+        }
+    }
+
+    // the BSSID of a backhaul STA is its parent, a roam of a connected bSTA is not a reconfiguration
+    if (memcmp(&cur->bssid, &dec->bssid, sizeof(em_interface_t)) != 0) {
+        return ((cur->vap_mode == em_vap_mode_sta) && (cur->connect_status == true)) ? DM_CFG_DELTA_BACKHAUL:DM_CFG_DELTA_BSS;
+    }
+
+    return DM_CFG_DELTA_NONE;
+}
@@ -305,13 +305,14 @@ bool dm_device_list_t::compare_db(db_client_t& db_client, const dm_device_t& sta
     em_device_info_t info;
     mac_addr_str_t mac;
     em_long_string_t   str;
-    db_query_t    query;
+    mac_addr_str_t dev_mac;
+    em_2xlong_string_t key;
     void *ctx;
 
-    memset(query, 0, sizeof(db_query_t));
-    snprintf(query, sizeof(db_query_t), "select * from %s", m_table_name);
-
-    ctx = db_client.execute(query);
+    // only the row of this device can match it
+    dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *> (sta.m_device_info.id.dev_mac), dev_mac);
+    snprintf(key, sizeof(em_2xlong_string_t), "%s@%s@%d", sta.m_device_info.id.net_id, dev_mac, sta.m_device_info.id.media);
+    ctx = select_by_key(db_client, key, 0);
 
     while (db_client.next_result(ctx)) {
         memset(&info, 0, sizeof(em_device_info_t));
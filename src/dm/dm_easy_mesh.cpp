@@ -40,7 +40,10 @@
 #include <sys/types.h>
 #include <ifaddrs.h>
 #include <fstream>
+#include <array>
 #include "dm_easy_mesh.h"
+#include "em_hex.h"
+#include "cjson_util.h"
 #include "em_cmd_dev_init.h"
 #include <cjson/cJSON.h>
 #include "em_cmd_sta_list.h"
@@ -48,12 +51,12 @@
 #include "em_cmd_client_cap.h"
 
 std::atomic<int> dm_easy_mesh_t::s_counter{0};
+std::atomic<unsigned int> dm_easy_mesh_t::s_generation{0};
 
 dm_easy_mesh_t& dm_easy_mesh_t::operator = (dm_easy_mesh_t const& obj)
 {
     dm_sta_t *sta;
-    em_long_string_t key;
-    mac_addr_str_t radio_mac_str, bss_mac_str, sta_mac_str;
+    dm_map_key_t key;
 
     m_device = obj.m_device;
     m_network = obj.m_network;
@@ -90,23 +93,39 @@ dm_easy_mesh_t& dm_easy_mesh_t::operator = (dm_easy_mesh_t const& obj)
         m_policy[i] = obj.m_policy[i];
     }
 
+    // the MLD sections only grow to what the source uses
     m_num_ap_mld = obj.m_num_ap_mld;
-    for (unsigned int i = 0; i < EM_MAX_AP_MLD; i++) {
+    for (unsigned int i = 0; i < obj.m_num_ap_mld; i++) {
         m_ap_mld[i] = obj.m_ap_mld[i];
     }
 
-    sta = static_cast<dm_sta_t *> (hash_map_get_first(obj.m_sta_map));
+    m_num_bsta_mld = obj.m_num_bsta_mld;
+    for (unsigned int i = 0; i < obj.m_num_bsta_mld; i++) {
+        m_bsta_mld[i] = obj.m_bsta_mld[i];
+    }
+
+    m_num_assoc_sta_mld = obj.m_num_assoc_sta_mld;
+    for (unsigned int i = 0; i < obj.m_num_assoc_sta_mld; i++) {
+        m_assoc_sta_mld[i] = obj.m_assoc_sta_mld[i];
+    }
+    // indexed again on first use
+    m_ap_mld_index.clear();
+    m_ap_mld_indexed = 0;
+    m_assoc_sta_mld_index.clear();
+    m_assoc_sta_mld_indexed = 0;
+    m_op_class_index.clear();
+    m_op_class_indexed = 0;
+
+    sta = static_cast<dm_sta_t *> (obj.m_sta_map->get_first());
     while (sta != NULL) {
-        dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.id, sta_mac_str);
-        dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.bssid, bss_mac_str);
-        dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.radiomac, radio_mac_str);
-        snprintf(key, sizeof(em_long_string_t), "%s@%s@%s", sta_mac_str, bss_mac_str, radio_mac_str);
-        hash_map_put(m_sta_map, strdup(key), new dm_sta_t(*sta));
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(obj.m_sta_map, sta));
+        dm_key_map_t::sta_key(&key, sta->m_sta_info.id, sta->m_sta_info.bssid, sta->m_sta_info.radiomac);
+        m_sta_map->put(&key, new dm_sta_t(*sta));
+        sta = static_cast<dm_sta_t *> (obj.m_sta_map->get_next(sta));
     }
 
     m_em = obj.m_em;
     m_instance_num = obj.m_instance_num;
+    set_radio_changed();
 
     return *this;
 }
@@ -138,6 +157,7 @@ int dm_easy_mesh_t::commit_config(dm_easy_mesh_t& dm, em_commit_target_t target)
                 m_num_radios = m_num_radios + 1;
                 printf("%s:%d New Radio %s configuration created no of radios=%d\n", __func__, __LINE__,target.params,m_num_radios);
             }
+            set_radio_changed();
 			//Commit op class
 			for (i = 0; i<dm.m_num_opclass; i++) {
 				if (memcmp(radio->get_radio_info()->intf.mac, dm.m_op_class[i].m_op_class_info.id.ruid, sizeof(mac_address_t)) == 0) {
@@ -168,6 +188,8 @@ int dm_easy_mesh_t::commit_config(dm_easy_mesh_t& dm, em_commit_target_t target)
 					}
 				}
         	}
+			// entries were overwritten with other classes
+			reindex_op_class();
 		}	
     } else if (target.type == em_commit_target_bss) {
         printf("%s:%d Commit radio=%s\n", __func__, __LINE__,target.params);
@@ -248,11 +270,12 @@ int dm_easy_mesh_t::commit_config(em_cmd_t  *cmd)
         case em_cmd_type_dev_init: {
                 switch (cmd->get_orch_op()) {
                     case dm_orch_type_al_insert:
-                        m_device = cmd->m_data_model.m_device;
+                        m_device = cmd->m_data_model->m_device;
                         break;
                     case dm_orch_type_em_insert:
-                        m_radio[m_num_radios] = cmd->m_data_model.m_radio[0];
+                        m_radio[m_num_radios] = cmd->m_data_model->m_radio[0];
                         m_num_radios++;
+                        set_radio_changed();
 
                         break;
                     default:
@@ -338,7 +361,6 @@ int dm_easy_mesh_t::encode_config(em_subdoc_info_t *subdoc, const char *str)
 int dm_easy_mesh_t::encode_config_reset(em_subdoc_info_t *subdoc, const char *key)
 {
     cJSON *parent_obj, *net_obj, *interfaces_obj, *interface_obj, *interface_arr_obj, *ssid_obj, *ssid_arr_objs;
-	char *formatted_json;
 	mac_addr_str_t	mac_str;
 	em_long_string_t	interface_str;
 	const char *preference[] = {"First Preference", "Second Preference", "Third Preference", "Fourth Preference", "Fifth Preference", "Sixth Preference", "Seventh Preference", "Eighth Preference"};
@@ -406,11 +428,9 @@ int dm_easy_mesh_t::encode_config_reset(em_subdoc_info_t *subdoc, const char *ke
         }
 	}
 	
-	formatted_json = cJSON_Print(parent_obj);
+	cjson_utils::print_preallocated(parent_obj, subdoc->buff, EM_IO_BUFF_SZ);
 
-    //printf("%s:%d: %s\n", __func__, __LINE__, formatted_json);
-    snprintf(subdoc->buff, EM_IO_BUFF_SZ, "%s", formatted_json);
-    cJSON_free(formatted_json);
+    //printf("%s:%d: %s\n", __func__, __LINE__, subdoc->buff);
     cJSON_Delete(parent_obj);
 
     return 0;
@@ -448,7 +468,6 @@ int dm_easy_mesh_t::encode_config_test(em_subdoc_info_t *subdoc, const char *key
 {
     cJSON *parent_obj, *net_obj, *dev_arr_objs,  *dev_obj, *radio_arr_objs, *radio_obj;
 	cJSON *cap_obj, *op_arr_objs, *bss_obj, *bss_arr_objs;
-	char *formatted_json;
 	unsigned int i, j;
 
     if ((parent_obj = cJSON_CreateObject()) == NULL) {
@@ -663,9 +682,7 @@ int dm_easy_mesh_t::encode_config_test(em_subdoc_info_t *subdoc, const char *key
         return -1;
     }
 
-	formatted_json = cJSON_Print(parent_obj);
-    snprintf(subdoc->buff, EM_IO_BUFF_SZ, "%s", formatted_json);
-    cJSON_free(formatted_json);
+	cjson_utils::print_preallocated(parent_obj, subdoc->buff, EM_IO_BUFF_SZ);
 
     cJSON_Delete(parent_obj);
     return 0;
@@ -1277,6 +1294,7 @@ void dm_easy_mesh_t::update_cac_status_id(mac_address_t al_mac)
 			memcpy(m_op_class[i].m_op_class_info.id.ruid, al_mac, sizeof(mac_address_t));
 		}
 	}
+	reindex_op_class();
 
     for (i = 0; i < m_num_opclass; i++) {
         dm_easy_mesh_t::macbytes_to_string(m_op_class[i].m_op_class_info.id.ruid, mac_str);
@@ -1562,62 +1580,22 @@ int dm_easy_mesh_t::decode_client_cap_config(em_subdoc_info_t *subdoc, const cha
 
 char *dm_easy_mesh_t::hex(unsigned int in_len, unsigned char *in, unsigned int out_len, char *out)
 {
-    unsigned int i;
-    unsigned char tmp;
-
     if (out_len < 2*in_len + 1) {
         return NULL;
     }
 
-    memset(out, 0, out_len);
-
-    for (i = 0; i < in_len; i++) {
-        tmp = in[i] >> 4;
-        if (tmp < 0xa) {
-            out[2*i] = static_cast<char> (tmp + 0x30);
-        } else {
-            out[2*i] = static_cast<char> (tmp - 0xa + 0x61);
-        }
-
-        tmp = in[i] & 0xf;
-        if (tmp < 0xa) {
-            out[2*i + 1] = static_cast<char> (tmp + 0x30);
-        } else {
-            out[2*i + 1] = static_cast<char> (tmp - 0xa + 0x61);
-        }
-    }
+    em_hex::encode(in, in_len, out);
 
     return out;
 }
 
 unsigned char *dm_easy_mesh_t::unhex(unsigned int in_len, char *in, unsigned int out_len, unsigned char *out)
 {
-    unsigned int i;
-    unsigned char tmp1, tmp2;
-
     if (out_len < in_len/2) {
         return NULL;
     }
 
-    for (i = 0; i < in_len/2; i++) {
-        if (in[2*i] <= '9') {
-            tmp1 = static_cast<unsigned char> (in[2*i]) - 0x30;
-        } else {
-            tmp1 = static_cast<unsigned char> (in[2*i]) - 0x61 + 0xa;
-        }
-
-        tmp1 = static_cast<unsigned char> (tmp1 << 4);
-
-        if (in[2*i + 1] <= '9') {
-            tmp2 = static_cast<unsigned char> (in[2*i + 1]) - 0x30;
-        } else {
-            tmp2 = static_cast<unsigned char> (in[2*i + 1]) - 0x61 + 0xa;
-        }
-
-        tmp2 &= 0xf;
-
-        out[i] = tmp1 | tmp2;
-    }
+    em_hex::decode(in, in_len, out);
 
     return out;
 }
@@ -1625,29 +1603,14 @@ unsigned char *dm_easy_mesh_t::unhex(unsigned int in_len, char *in, unsigned int
 char *dm_easy_mesh_t::macbytes_to_string(mac_address_t mac, char* string)
 {
     if( mac != NULL) {
-        sprintf(const_cast<char *> (string), "%02x:%02x:%02x:%02x:%02x:%02x",
-            mac[0] & 0xff,
-            mac[1] & 0xff,
-            mac[2] & 0xff,
-            mac[3] & 0xff,
-            mac[4] & 0xff,
-            mac[5] & 0xff);
+        em_hex::mac_to_str(mac, string);
     }
     return const_cast<char *> (string);
 }
 
 void dm_easy_mesh_t::string_to_macbytes(char *key, mac_address_t bmac)
 {
-    unsigned char mac[6];
-    if(strlen(key) > MIN_MAC_LEN)
-        sscanf(key, "%02hhx:%02hhx:%02hhx:%02hhx:%02hhx:%02hhx",
-                &mac[0], &mac[1], &mac[2], &mac[3], &mac[4], &mac[5]);
-    else
-        sscanf(key, "%02hhx%02hhx%02hhx%02hhx%02hhx%02hhx",
-                &mac[0], &mac[1], &mac[2], &mac[3], &mac[4], &mac[5]);
-    bmac[0] = mac[0]; bmac[1] = mac[1]; bmac[2] = mac[2];
-    bmac[3] = mac[3]; bmac[4] = mac[4]; bmac[5] = mac[5];
-
+    em_hex::str_to_mac(key, bmac);
 }
 
 void dm_easy_mesh_t::securitymode_to_str(unsigned short mode, char *sec_mode_str, size_t len)
@@ -1931,6 +1894,69 @@ dm_op_class_t *dm_easy_mesh_t::get_curr_op_class(unsigned int index)
         return &m_op_class[index];
 }
 
+unsigned int dm_easy_mesh_t::apply_op_classes(const em_op_class_info_t *op_classes, unsigned int num, bool match_class)
+{
+	em_op_class_info_t *info;
+	unsigned int i, j, first, last, changed = 0, num_existing = m_num_opclass;
+	bool found, appended = false;
+
+	for (i = 0; i < num; i++) {
+		found = false;
+		// the report never matches the classes it appends itself
+		first = 0;
+		last = num_existing;
+		if (match_class == true) {
+			// only the indexed class can match
+			if (find_op_class(op_classes[i].id.ruid, op_classes[i].id.type, op_classes[i].id.op_class, &first) == NULL) {
+				first = num_existing;
+			}
+			last = (first < num_existing) ? (first + 1):num_existing;
+		}
+		for (j = first; j < last; j++) {
+			info = &m_op_class[j].m_op_class_info;
+			if ((memcmp(info->id.ruid, op_classes[i].id.ruid, sizeof(mac_address_t)) != 0) ||
+					(info->id.type != op_classes[i].id.type) ||
+					((match_class == true) && (info->id.op_class != op_classes[i].id.op_class))) {
+				continue;
+			}
+			found = true;
+			if ((info->op_class == op_classes[i].op_class) && (info->channel == op_classes[i].channel) &&
+					(info->num_channels == op_classes[i].num_channels) &&
+					(memcmp(info->channels, op_classes[i].channels, info->num_channels * sizeof(unsigned int)) == 0) &&
+					((info->id.type != em_op_class_type_capability) || (info->max_tx_power == op_classes[i].max_tx_power))) {
+				continue;
+			}
+			info->op_class = op_classes[i].op_class;
+			info->channel = op_classes[i].channel;
+			if (info->id.type == em_op_class_type_capability) {
+				info->max_tx_power = op_classes[i].max_tx_power;
+			}
+			info->num_channels = op_classes[i].num_channels;
+			memcpy(info->channels, op_classes[i].channels, sizeof(info->channels));
+			index_op_class(j);
+			set_op_class_dirty(j);
+			changed++;
+		}
+
+		if ((found == true) || (m_num_opclass >= EM_MAX_OPCLASS)) {
+			continue;
+		}
+		memcpy(&m_op_class[m_num_opclass].m_op_class_info, &op_classes[i], sizeof(em_op_class_info_t));
+		set_op_class_dirty(m_num_opclass);
+		m_num_opclass++;
+		index_op_class(m_num_opclass - 1);
+		appended = true;
+		changed++;
+	}
+
+	// a new operating class shows in the radio rows as well
+	if (appended == true) {
+		set_db_cfg_param(db_cfg_type_radio_list_update, "");
+	}
+
+	return changed;
+}
+
 dm_device_t *dm_easy_mesh_t::find_matching_device(dm_device_t *dev)
 {
     if (memcmp(m_device.m_device_info.intf.mac, dev->m_device_info.intf.mac, sizeof(mac_address_t)) == 0) {
@@ -1982,9 +2008,30 @@ void dm_easy_mesh_t::print_config()
         printf("%s:%d:Radio Band: %d \n", __func__, __LINE__, m_radio[i].get_radio_info()->band);
         printf("%s:%d:TransmitPowerLimit: %d \n", __func__, __LINE__, transmit_power_limit);
     }
+
+    printf("%s:%d:Footprint: %zu bytes, MLD sections: %zu bytes\n", __func__, __LINE__, get_footprint(),
+            m_ap_mld.get_footprint() + m_bsta_mld.get_footprint() + m_assoc_sta_mld.get_footprint());
 }
 
 
+size_t dm_easy_mesh_t::get_footprint()
+{
+    size_t sz = sizeof(dm_easy_mesh_t);
+
+    sz += m_ap_mld.get_footprint() + m_bsta_mld.get_footprint() + m_assoc_sta_mld.get_footprint();
+    if (m_sta_map != NULL) {
+        sz += m_sta_map->count() * sizeof(dm_sta_t);
+    }
+    if (m_scan_result_map != NULL) {
+        sz += m_scan_result_map->count() * sizeof(dm_scan_result_t);
+    }
+    if (m_wifi_data != NULL) {
+        sz += sizeof(webconfig_subdoc_data_t);
+    }
+
+    return sz;
+}
+
 bool dm_easy_mesh_t::operator==(dm_easy_mesh_t const& obj)
 {
     int ret = 0;
@@ -2053,14 +2100,22 @@ em_e4_table_t dm_easy_mesh_t::m_e4_table[] = {
 // Function to get frequency band by operating class
 em_freq_band_t  dm_easy_mesh_t::get_freq_band_by_op_class(int op_class)
 {
-	size_t i = 0;
-	for (i = 0; i < sizeof(m_e4_table) / sizeof(m_e4_table[0]); ++i) {
-		if (m_e4_table[i].op_class == op_class) {
-			return m_e4_table[i].band;
+	// direct lookup by operating class, built from m_e4_table on first use
+	static const std::array<unsigned char, 256> e4_index = []() {
+		std::array<unsigned char, 256> index{};
+		for (size_t i = sizeof(m_e4_table) / sizeof(m_e4_table[0]); i > 0; --i) {
+			if ((m_e4_table[i - 1].op_class >= 0) && (m_e4_table[i - 1].op_class < 256)) {
+				index[static_cast<size_t>(m_e4_table[i - 1].op_class)] = static_cast<unsigned char>(i);
+			}
 		}
+		return index;
+	}();
+
+	if ((op_class < 0) || (op_class >= 256) || (e4_index[static_cast<size_t>(op_class)] == 0)) {
+		return em_freq_band_unknown; // Return invalid if op_class not found
 	}
-    
-	return em_freq_band_unknown; // Return invalid if op_class not found
+
+	return m_e4_table[e4_index[static_cast<size_t>(op_class)] - 1].band;
 }
 
 std::vector<int>  dm_easy_mesh_t::get_channel_list_by_op_class(int op_class)
@@ -2294,7 +2349,7 @@ em_op_class_info_t* dm_easy_mesh_t::get_opclass_info_for_bss(mac_address_t bssid
 
 em_sta_info_t *dm_easy_mesh_t::get_first_sta_info(em_target_sta_map_t target)
 {
-    hash_map_t *map;
+    dm_key_map_t *map;
     dm_sta_t *sta = NULL;
 
     if (target == em_target_sta_map_assoc) {
@@ -2305,7 +2360,7 @@ em_sta_info_t *dm_easy_mesh_t::get_first_sta_info(em_target_sta_map_t target)
         map = m_sta_map;
     }
 
-    sta = static_cast<dm_sta_t *> (hash_map_get_first(map));
+    sta = static_cast<dm_sta_t *> (map->get_first());
     if (sta == NULL) {
         return NULL;
     }
@@ -2315,7 +2370,7 @@ em_sta_info_t *dm_easy_mesh_t::get_first_sta_info(em_target_sta_map_t target)
 
 em_sta_info_t *dm_easy_mesh_t::get_next_sta_info(em_sta_info_t *info, em_target_sta_map_t target)
 {
-    hash_map_t *map;
+    dm_key_map_t *map;
     dm_sta_t *sta = NULL;
     bool match_found = false;
 
@@ -2327,13 +2382,13 @@ em_sta_info_t *dm_easy_mesh_t::get_next_sta_info(em_sta_info_t *info, em_target_
         map = m_sta_map;
     }
 
-    sta = static_cast<dm_sta_t *> (hash_map_get_first(map));
+    sta = static_cast<dm_sta_t *> (map->get_first());
     while ((sta != NULL) && (match_found == false)) {
         if (&sta->m_sta_info == info) {
             match_found = true;
         }
 
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(map, sta));
+        sta = static_cast<dm_sta_t *> (map->get_next(sta));
     }
 
     if (match_found == false) {
@@ -2351,12 +2406,12 @@ bool dm_easy_mesh_t::has_at_least_one_associated_sta()
 {
     dm_sta_t *sta;
 
-    sta = static_cast<dm_sta_t *> (hash_map_get_first(m_sta_map));
+    sta = static_cast<dm_sta_t *> (m_sta_map->get_first());
     while (sta != NULL) {
         if (sta->m_sta_info.associated == true) {
             return true;
         }
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(m_sta_map, sta));
+        sta = static_cast<dm_sta_t *> (m_sta_map->get_next(sta));
     }
 
     return false;
@@ -2366,13 +2421,13 @@ dm_sta_t *dm_easy_mesh_t::find_sta(mac_address_t sta_mac, bssid_t bssid)
 {
     dm_sta_t *sta;
 
-    sta = static_cast<dm_sta_t *> (hash_map_get_first(m_sta_map));
+    sta = static_cast<dm_sta_t *> (m_sta_map->get_first());
     while (sta != NULL) {
         if ((memcmp(sta->m_sta_info.id, sta_mac, sizeof(mac_address_t)) == 0) &&
                         (memcmp(sta->m_sta_info.bssid, bssid, sizeof(mac_address_t)) == 0)) {
             return sta;
         }
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(m_sta_map, sta));
+        sta = static_cast<dm_sta_t *> (m_sta_map->get_next(sta));
     }
 
     return NULL;
@@ -2382,12 +2437,12 @@ dm_sta_t *dm_easy_mesh_t::get_first_sta(mac_address_t sta_mac)
 {
     dm_sta_t *sta;
 
-    sta = static_cast<dm_sta_t *> (hash_map_get_first(m_sta_map));
+    sta = static_cast<dm_sta_t *> (m_sta_map->get_first());
     while (sta != NULL) {
         if (memcmp(sta->m_sta_info.id, sta_mac, sizeof(mac_address_t)) == 0) {
             return sta;
         }
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(m_sta_map, sta));
+        sta = static_cast<dm_sta_t *> (m_sta_map->get_next(sta));
     }
 
     return NULL;
@@ -2398,7 +2453,7 @@ dm_sta_t *dm_easy_mesh_t::get_next_sta(mac_address_t sta_mac, dm_sta_t *psta)
     dm_sta_t *sta;
     bool return_next = false;
 
-    sta = static_cast<dm_sta_t *> (hash_map_get_first(m_sta_map));
+    sta = static_cast<dm_sta_t *> (m_sta_map->get_first());
     while (sta != NULL) {
         if ((return_next == true) && (memcmp(sta->m_sta_info.id, sta_mac, sizeof(mac_address_t)) == 0)) {
             return sta;
@@ -2406,7 +2461,7 @@ dm_sta_t *dm_easy_mesh_t::get_next_sta(mac_address_t sta_mac, dm_sta_t *psta)
         if (sta == psta) {
             return_next = true;
         }
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(m_sta_map, sta));
+        sta = static_cast<dm_sta_t *> (m_sta_map->get_next(sta));
     }
 
     return NULL;
@@ -2414,11 +2469,11 @@ dm_sta_t *dm_easy_mesh_t::get_next_sta(mac_address_t sta_mac, dm_sta_t *psta)
 
 em_sta_info_t *dm_easy_mesh_t::get_sta_info(mac_address_t sta_mac, bssid_t bssid, mac_address_t ruid, em_target_sta_map_t target)
 {
-    hash_map_t *map;
+    dm_key_map_t *map;
     dm_sta_t *sta = NULL;
     const char	*map_str;
-    mac_addr_str_t radio_str, bss_str, sta_str;
-    em_long_string_t key = {0};
+    mac_addr_str_t sta_str;
+    dm_map_key_t key;
 
     if (target == em_target_sta_map_assoc) {
         map = m_sta_assoc_map;
@@ -2432,12 +2487,9 @@ em_sta_info_t *dm_easy_mesh_t::get_sta_info(mac_address_t sta_mac, bssid_t bssid
     }
 
     dm_easy_mesh_t::macbytes_to_string(sta_mac, sta_str);
-    dm_easy_mesh_t::macbytes_to_string(bssid, bss_str);
-    dm_easy_mesh_t::macbytes_to_string(ruid, radio_str);
 
-    snprintf(key, sizeof(em_long_string_t), "%s@%s@%s", sta_str, bss_str, radio_str);
-    printf("%s:%d: key=%s\n", __func__, __LINE__,key);
-    sta = static_cast<dm_sta_t *> (hash_map_get(map, key));
+    dm_key_map_t::sta_key(&key, sta_mac, bssid, ruid);
+    sta = static_cast<dm_sta_t *> (map->get(&key));
     if (sta == NULL) {
         printf("%s:%d: sta: %s not found in %s\n", __func__, __LINE__, sta_str, map_str);
         return NULL;
@@ -2449,10 +2501,10 @@ em_sta_info_t *dm_easy_mesh_t::get_sta_info(mac_address_t sta_mac, bssid_t bssid
 
 void dm_easy_mesh_t::put_sta_info(em_sta_info_t *sta_info, em_target_sta_map_t target)
 {
-    hash_map_t *map;
+    dm_key_map_t *map;
     const char	*map_str;
-    mac_addr_str_t radio_str, bss_str, sta_str;
-    em_2xlong_string_t key;
+    mac_addr_str_t sta_str;
+    dm_map_key_t key;
 
     if (target == em_target_sta_map_assoc) {
         map = m_sta_assoc_map;
@@ -2471,13 +2523,10 @@ void dm_easy_mesh_t::put_sta_info(em_sta_info_t *sta_info, em_target_sta_map_t t
         return;
     }
 
-    dm_easy_mesh_t::macbytes_to_string(sta_info->bssid, bss_str);
-    dm_easy_mesh_t::macbytes_to_string(sta_info->radiomac, radio_str);
-
-    snprintf(key, sizeof(em_2xlong_string_t), "%s@%s@%s", sta_str, bss_str, radio_str);
-    printf("%s:%d: Put sta key=%s\n", __func__, __LINE__,key);
+    printf("%s:%d: Put sta:%s in %s\n", __func__, __LINE__, sta_str, map_str);
 
-    hash_map_put(map, strdup(key), new dm_sta_t(sta_info));
+    dm_key_map_t::sta_key(&key, sta_info->id, sta_info->bssid, sta_info->radiomac);
+    map->put(&key, new dm_sta_t(sta_info));
 }
 
 int dm_easy_mesh_t::get_num_bss_for_associated_sta(mac_address_t sta_mac)
@@ -2485,12 +2534,12 @@ int dm_easy_mesh_t::get_num_bss_for_associated_sta(mac_address_t sta_mac)
     dm_sta_t *sta;
     int num_bssids = 0;
 
-    sta = static_cast<dm_sta_t *> (hash_map_get_first(m_sta_map));
+    sta = static_cast<dm_sta_t *> (m_sta_map->get_first());
     while (sta != NULL) {
         if (memcmp(sta->m_sta_info.id, sta_mac, sizeof(mac_address_t)) == 0) {
             num_bssids++;
         }
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(m_sta_map, sta));
+        sta = static_cast<dm_sta_t *> (m_sta_map->get_next(sta));
     }
 
     return num_bssids;
@@ -2498,115 +2547,41 @@ int dm_easy_mesh_t::get_num_bss_for_associated_sta(mac_address_t sta_mac)
 
 void dm_easy_mesh_t::clone_hash_maps(dm_easy_mesh_t& obj)
 {
-    mac_addr_str_t  sta_mac_str, bss_mac_str, radio_mac_str;
-    dm_sta_t *sta;
-    em_long_string_t key;
-
-    sta = static_cast<dm_sta_t *> (hash_map_get_first(m_sta_map));
-    while (sta != NULL) {
-        macbytes_to_string(sta->m_sta_info.id, sta_mac_str);
-        macbytes_to_string(sta->m_sta_info.bssid, bss_mac_str);
-        macbytes_to_string(sta->m_sta_info.radiomac, radio_mac_str);
-        snprintf(key, sizeof(em_long_string_t), "%s@%s@%s", sta_mac_str, bss_mac_str, radio_mac_str);
-        hash_map_put(obj.m_sta_map, strdup(key),sta);
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(m_sta_map, sta));
-    }
-
-    sta = static_cast<dm_sta_t *> (hash_map_get_first(m_sta_assoc_map));
-    while (sta != NULL) {
-        macbytes_to_string(sta->m_sta_info.id, sta_mac_str);
-        macbytes_to_string(sta->m_sta_info.bssid, bss_mac_str);
-        macbytes_to_string(sta->m_sta_info.radiomac, radio_mac_str);
-        snprintf(key, sizeof(em_long_string_t), "%s@%s@%s", sta_mac_str, bss_mac_str, radio_mac_str);
-        hash_map_put(obj.m_sta_assoc_map, strdup(key),sta);
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(m_sta_assoc_map, sta));
-    }
-
-    sta = static_cast<dm_sta_t *> (hash_map_get_first(m_sta_dassoc_map));
-    while (sta != NULL) {
-        macbytes_to_string(sta->m_sta_info.id, sta_mac_str);
-        macbytes_to_string(sta->m_sta_info.bssid, bss_mac_str);
-        macbytes_to_string(sta->m_sta_info.radiomac, radio_mac_str);
-        snprintf(key, sizeof(em_long_string_t), "%s@%s@%s", sta_mac_str, bss_mac_str, radio_mac_str);
-        hash_map_put(obj.m_sta_dassoc_map, strdup(key),sta);
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(m_sta_dassoc_map, sta));
-    }
+    // the maps of a fresh command data model share the storage of ours until either changes
+    obj.m_sta_map->copy_from(*m_sta_map);
+    obj.m_sta_assoc_map->copy_from(*m_sta_assoc_map);
+    obj.m_sta_dassoc_map->copy_from(*m_sta_dassoc_map);
 }
 
 void dm_easy_mesh_t::deinit()
 {
-    dm_sta_t *sta = NULL;
-    dm_sta_t *tmp_sta = NULL;
-	dm_scan_result_t	*res = NULL;
-	dm_scan_result_t	*tmp_res = NULL;
-    em_2xlong_string_t key;
-    mac_addr_str_t dev_mac_str, radio_mac_str, bss_mac_str, sta_mac_str, scanner_mac_str;
-
-    //destroy elements of m_scan_result_map
-	res = static_cast<dm_scan_result_t *> (hash_map_get_first(m_scan_result_map));
-	while (res != NULL) {
-		tmp_res = res;
-        res = static_cast<dm_scan_result_t *> (hash_map_get_next(m_scan_result_map, res));
-	
-		dm_easy_mesh_t::macbytes_to_string(tmp_res->m_scan_result.id.dev_mac, dev_mac_str);
-		dm_easy_mesh_t::macbytes_to_string(tmp_res->m_scan_result.id.scanner_mac, scanner_mac_str);
-
-		snprintf(key, sizeof(em_2xlong_string_t), "%s@%s@%s@%d@%d@%d", res->m_scan_result.id.net_id, dev_mac_str, scanner_mac_str, 
-					tmp_res->m_scan_result.id.op_class, tmp_res->m_scan_result.id.channel, tmp_res->m_scan_result.id.scanner_type);
-		hash_map_remove(m_scan_result_map, key);
-	}
-
-	hash_map_destroy(m_scan_result_map);	
-
-    //destroy elements of m_sta_map
-    sta = static_cast<dm_sta_t *> (hash_map_get_first(m_sta_map));
-    while (sta != NULL) {
-        tmp_sta = sta;
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(m_sta_map, sta));
-
-        dm_easy_mesh_t::macbytes_to_string(tmp_sta->m_sta_info.id, sta_mac_str);
-        dm_easy_mesh_t::macbytes_to_string(tmp_sta->m_sta_info.bssid, bss_mac_str);
-        dm_easy_mesh_t::macbytes_to_string(tmp_sta->m_sta_info.radiomac, radio_mac_str);
-        snprintf(key, sizeof(em_long_string_t), "%s@%s@%s", sta_mac_str, bss_mac_str, radio_mac_str);
-
-        hash_map_remove(m_sta_map, key);
-    }
-    hash_map_destroy(m_sta_map);
-    sta = NULL;
-
-    sta = static_cast<dm_sta_t *> (hash_map_get_first(m_sta_assoc_map));
-    while (sta != NULL)
-    {
-        tmp_sta = sta;
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(m_sta_assoc_map, sta));
-        dm_easy_mesh_t::macbytes_to_string(tmp_sta->m_sta_info.id, sta_mac_str);
-        dm_easy_mesh_t::macbytes_to_string(tmp_sta->m_sta_info.bssid, bss_mac_str);
-        dm_easy_mesh_t::macbytes_to_string(tmp_sta->m_sta_info.radiomac, radio_mac_str);
-        snprintf(key, sizeof(em_long_string_t), "%s@%s@%s", sta_mac_str, bss_mac_str, radio_mac_str);
-
-        hash_map_remove(m_sta_assoc_map, key);
-    }
-	hash_map_destroy(m_sta_assoc_map);
-    sta = NULL;
-
-    sta = static_cast<dm_sta_t *> (hash_map_get_first(m_sta_dassoc_map));
-    while (sta != NULL)
-    {
-        tmp_sta = sta;
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(m_sta_dassoc_map, sta));
-
-        dm_easy_mesh_t::macbytes_to_string(tmp_sta->m_sta_info.id, sta_mac_str);
-        dm_easy_mesh_t::macbytes_to_string(tmp_sta->m_sta_info.bssid, bss_mac_str);
-        dm_easy_mesh_t::macbytes_to_string(tmp_sta->m_sta_info.radiomac, radio_mac_str);
-        snprintf(key, sizeof(em_long_string_t), "%s@%s@%s", sta_mac_str, bss_mac_str, radio_mac_str);
+    // the values may be shared with a clone_hash_maps() copy, they are not freed here
+    delete m_scan_result_map;
+    m_scan_result_map = NULL;
+    delete m_sta_map;
+    m_sta_map = NULL;
+    delete m_sta_assoc_map;
+    m_sta_assoc_map = NULL;
+    delete m_sta_dassoc_map;
+    m_sta_dassoc_map = NULL;
 
-        hash_map_remove(m_sta_dassoc_map, key);
-    }
-	hash_map_destroy(m_sta_dassoc_map);
 	if (m_wifi_data != NULL) {
         free(m_wifi_data);
         m_wifi_data = nullptr;
     }
+
+    m_num_ap_mld = 0;
+    m_ap_mld.clear();
+    m_num_bsta_mld = 0;
+    m_bsta_mld.clear();
+    m_num_assoc_sta_mld = 0;
+    m_assoc_sta_mld.clear();
+    m_ap_mld_index.clear();
+    m_ap_mld_indexed = 0;
+    m_assoc_sta_mld_index.clear();
+    m_assoc_sta_mld_indexed = 0;
+    m_op_class_index.clear();
+    m_op_class_indexed = 0;
 }
 
 void dm_easy_mesh_t::set_policy(dm_policy_t policy)
@@ -2638,7 +2613,6 @@ void dm_easy_mesh_t::set_policy(dm_policy_t policy)
 void dm_easy_mesh_t::set_channels_list(dm_op_class_t op_class[], unsigned int num)
 {
 	unsigned int i, j;
-	bool match_found = false;
 	dm_op_class_t *oclass, *poclass;
 	mac_address_t null_mac = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
@@ -2651,25 +2625,17 @@ void dm_easy_mesh_t::set_channels_list(dm_op_class_t op_class[], unsigned int nu
 			memcpy(oclass->m_op_class_info.id.ruid, m_device.m_device_info.intf.mac, sizeof(mac_address_t));
 		}
 
-		for (j = 0; j < m_num_opclass; j++) {
-			poclass = &m_op_class[j];
-
-			if ((memcmp(oclass->m_op_class_info.id.ruid, poclass->m_op_class_info.id.ruid, sizeof(mac_address_t)) == 0) &&
-					(oclass->m_op_class_info.id.type == poclass->m_op_class_info.id.type) &&
-					(oclass->m_op_class_info.id.op_class == poclass->m_op_class_info.id.op_class)) {
-				match_found = true;
-				break;
+		if (find_op_class(oclass->m_op_class_info.id.ruid, oclass->m_op_class_info.id.type,
+				oclass->m_op_class_info.id.op_class, &j) == NULL) {
+			if (m_num_opclass >= EM_MAX_OPCLASS) {
+				continue;
 			}
+			j = m_num_opclass++;
 		}
+		poclass = &m_op_class[j];
 
-		if (match_found == true) {
-			match_found = false;
-		} else {
-			poclass = &m_op_class[m_num_opclass];
-			m_num_opclass++;
-		}
-			
 		memcpy(&poclass->m_op_class_info, &oclass->m_op_class_info, sizeof(em_op_class_info_t));
+		index_op_class(j);
 	}
 }
 
@@ -2728,20 +2694,14 @@ dm_bss_t *dm_easy_mesh_t::find_matching_bss(em_bss_id_t *id)
 dm_scan_result_t *dm_easy_mesh_t::create_new_scan_result(em_scan_result_id_t *id)
 {
 	dm_scan_result_t *res, scan_result;
-	em_2xlong_string_t key;
-	mac_addr_str_t  dev_mac_str, scanner_mac_str;
+	dm_map_key_t key;
 
 	memcpy(&scan_result.m_scan_result.id, id, sizeof(em_scan_result_id_t));
 
 	res = new dm_scan_result_t(scan_result);
 
-    dm_easy_mesh_t::macbytes_to_string(id->dev_mac, dev_mac_str);
-    dm_easy_mesh_t::macbytes_to_string(id->scanner_mac, scanner_mac_str);
-
-	snprintf(key, sizeof(em_2xlong_string_t), "%s@%s@%s@%d@%d@%d", res->m_scan_result.id.net_id, dev_mac_str, scanner_mac_str,
-                    res->m_scan_result.id.op_class, res->m_scan_result.id.channel, res->m_scan_result.id.scanner_type);
-
-	hash_map_put(m_scan_result_map, strdup(key), res);
+	dm_key_map_t::scan_result_key(&key, &res->m_scan_result.id);
+	m_scan_result_map->put(&key, res);
 
 	return res;
 }
@@ -2751,13 +2711,13 @@ dm_scan_result_t *dm_easy_mesh_t::get_scan_result(unsigned int index)
 	dm_scan_result_t *res;
 	unsigned int i = 0;
 
-	res = static_cast<dm_scan_result_t *> (hash_map_get_first(m_scan_result_map));
+	res = static_cast<dm_scan_result_t *> (m_scan_result_map->get_first());
 	while (res != NULL) {
 		if (i == index) {
 			return res;
 		}
 		i++;
-		res = static_cast<dm_scan_result_t *> (hash_map_get_next(m_scan_result_map, res));
+		res = static_cast<dm_scan_result_t *> (m_scan_result_map->get_next(res));
 	}
 
 	return NULL;
@@ -2766,22 +2726,15 @@ dm_scan_result_t *dm_easy_mesh_t::get_scan_result(unsigned int index)
 dm_scan_result_t *dm_easy_mesh_t::find_matching_scan_result(em_scan_result_id_t *id)
 {
     dm_scan_result_t *res;
+    dm_map_key_t key;
 
-	res = static_cast<dm_scan_result_t *> (hash_map_get_first(m_scan_result_map));
-	while (res != NULL) {
-        if ((strncmp(res->m_scan_result.id.net_id, id->net_id, strlen(id->net_id)) == 0) &&
-                (memcmp(res->m_scan_result.id.dev_mac, id->dev_mac, sizeof(mac_address_t)) == 0) &&
-                (memcmp(res->m_scan_result.id.scanner_mac, id->scanner_mac, sizeof(mac_address_t)) == 0) &&
-                (res->m_scan_result.id.op_class == id->op_class) &&
-                (res->m_scan_result.id.channel == id->channel) &&
-                (res->m_scan_result.id.scanner_type == id->scanner_type)) {
-            return res;
-        }
-
-		res = static_cast<dm_scan_result_t *> (hash_map_get_next(m_scan_result_map, res));
-	}    
+    // the results are keyed by scanner, device, operating class, channel and scanner type
+    dm_key_map_t::scan_result_key(&key, id);
+    if ((res = static_cast<dm_scan_result_t *> (m_scan_result_map->get(&key))) == NULL) {
+        return NULL;
+    }
 
-    return NULL;
+    return (strncmp(res->m_scan_result.id.net_id, id->net_id, strlen(id->net_id)) == 0) ? res:NULL;
 }
 
 void dm_easy_mesh_t::update_scan_results(em_scan_result_t *scan_result)
@@ -2803,51 +2756,366 @@ void dm_easy_mesh_t::update_scan_results(em_scan_result_t *scan_result)
         res = create_new_scan_result(id);
         *res->get_scan_result() = *scan_result;
     }
+    res->reindex_neighbors();
 }
 
-em_ap_mld_info_t *dm_easy_mesh_t::get_ap_mld_frm_bssid(mac_address_t bss_id)
+void dm_easy_mesh_t::reindex_ap_mld()
 {
+    em_ap_mld_info_t *info;
     unsigned int i, j;
-    em_ap_mld_info_t *ap_mld_info = NULL;
 
+    m_ap_mld_index.clear();
     for (i = 0; i < m_num_ap_mld; i++) {
-        ap_mld_info = &m_ap_mld[i].m_ap_mld_info;
-        for (j = 0; j < ap_mld_info->num_affiliated_ap; ++j) {
-            if (memcmp(ap_mld_info->affiliated_ap[j].mac_addr, bss_id, sizeof(mac_address_t)) == 0) {
-                return ap_mld_info;
+        info = &m_ap_mld[i].m_ap_mld_info;
+        m_ap_mld_index.add_mld(info->mac_addr, i);
+        for (j = 0; (j < info->num_affiliated_ap) && (j < EM_MAX_AP_MLD); j++) {
+            m_ap_mld_index.add_link(info->affiliated_ap[j].mac_addr, i, j);
+        }
+    }
+    m_ap_mld_indexed = m_num_ap_mld;
+}
+
+void dm_easy_mesh_t::reindex_assoc_sta_mld()
+{
+    em_assoc_sta_mld_info_t *info;
+    unsigned int i, j;
+
+    m_assoc_sta_mld_index.clear();
+    for (i = 0; i < m_num_assoc_sta_mld; i++) {
+        info = &m_assoc_sta_mld[i].m_assoc_sta_mld_info;
+        m_assoc_sta_mld_index.add_mld(info->mac_addr, i);
+        for (j = 0; (j < info->num_affiliated_sta) && (j < EM_MAX_AP_MLD); j++) {
+            m_assoc_sta_mld_index.add_link(info->affiliated_sta[j].mac_addr, i, j);
+        }
+    }
+    m_assoc_sta_mld_indexed = m_num_assoc_sta_mld;
+}
+
+em_ap_mld_info_t *dm_easy_mesh_t::find_ap_mld(const unsigned char *mld_mac, unsigned int *idx)
+{
+    unsigned int i, pass;
+
+    if (m_ap_mld_indexed != m_num_ap_mld) {
+        reindex_ap_mld();
+    }
+    for (pass = 0; pass < 2; pass++) {
+        if (m_ap_mld_index.find_mld(mld_mac, &i) == false) {
+            return NULL;
+        }
+        if ((i < m_num_ap_mld) && (em_hex::mac_equal(m_ap_mld[i].m_ap_mld_info.mac_addr, mld_mac) == true)) {
+            if (idx != NULL) {
+                *idx = i;
             }
+            return &m_ap_mld[i].m_ap_mld_info;
         }
+        // m_ap_mld was written around the index
+        reindex_ap_mld();
     }
 
     return NULL;
 }
 
-void dm_easy_mesh_t::update_ap_mld_info(em_ap_mld_info_t *ap_mld_info)
+em_affiliated_ap_info_t *dm_easy_mesh_t::find_affiliated_ap(const unsigned char *bssid, em_ap_mld_info_t **mld)
 {
+    em_ap_mld_info_t *info;
+    unsigned int i, link, pass;
+
+    if (m_ap_mld_indexed != m_num_ap_mld) {
+        reindex_ap_mld();
+    }
+    for (pass = 0; pass < 2; pass++) {
+        if (m_ap_mld_index.find_link(bssid, &i, &link) == false) {
+            return NULL;
+        }
+        if (i < m_num_ap_mld) {
+            info = &m_ap_mld[i].m_ap_mld_info;
+            if ((link < info->num_affiliated_ap) && (em_hex::mac_equal(info->affiliated_ap[link].mac_addr, bssid) == true)) {
+                if (mld != NULL) {
+                    *mld = info;
+                }
+                return &info->affiliated_ap[link];
+            }
+        }
+        reindex_ap_mld();
+    }
 
-    em_ap_mld_info_t *target_mld = NULL;
+    return NULL;
+}
 
-    // Find existing MLD by MAC
-    em_printfout("m_num_ap_mld %d", m_num_ap_mld);
-    for (unsigned int i = 0; i < m_num_ap_mld; i++) {
-        if (memcmp(m_ap_mld[i].m_ap_mld_info.mac_addr, ap_mld_info->mac_addr, sizeof(mac_address_t)) == 0) {
-            target_mld = &m_ap_mld[i].m_ap_mld_info;
-            em_printfout("Found existing MLD at index %d", i);
-            break;
+em_assoc_sta_mld_info_t *dm_easy_mesh_t::find_assoc_sta_mld(const unsigned char *mac)
+{
+    em_assoc_sta_mld_info_t *info;
+    unsigned int i, link, pass;
+
+    if (m_assoc_sta_mld_indexed != m_num_assoc_sta_mld) {
+        reindex_assoc_sta_mld();
+    }
+    for (pass = 0; pass < 2; pass++) {
+        if (m_assoc_sta_mld_index.find_mld(mac, &i) == true) {
+            if ((i < m_num_assoc_sta_mld) && (em_hex::mac_equal(m_assoc_sta_mld[i].m_assoc_sta_mld_info.mac_addr, mac) == true)) {
+                return &m_assoc_sta_mld[i].m_assoc_sta_mld_info;
+            }
+        } else if (m_assoc_sta_mld_index.find_link(mac, &i, &link) == true) {
+            if (i < m_num_assoc_sta_mld) {
+                info = &m_assoc_sta_mld[i].m_assoc_sta_mld_info;
+                if ((link < info->num_affiliated_sta) && (em_hex::mac_equal(info->affiliated_sta[link].mac_addr, mac) == true)) {
+                    return info;
+                }
+            }
+        } else {
+            return NULL;
+        }
+        reindex_assoc_sta_mld();
+    }
+
+    return NULL;
+}
+
+void dm_easy_mesh_t::reindex_op_class()
+{
+    unsigned int i;
+
+    m_op_class_index.clear();
+    for (i = 0; i < m_num_opclass; i++) {
+        m_op_class_index.add(&m_op_class[i].m_op_class_info, i);
+    }
+    m_op_class_indexed = m_num_opclass;
+}
+
+void dm_easy_mesh_t::index_op_class(unsigned int idx)
+{
+    // an index that is behind is rebuilt on its next use anyway
+    if ((idx >= m_num_opclass) || (m_op_class_indexed + ((idx == m_op_class_indexed) ? 1:0) != m_num_opclass)) {
+        return;
+    }
+    m_op_class_index.add(&m_op_class[idx].m_op_class_info, idx);
+    m_op_class_indexed = m_num_opclass;
+}
+
+const dm_op_class_index_entry_t *dm_easy_mesh_t::get_op_class_entry(const unsigned char *ruid, em_op_class_type_t type, unsigned int op_class)
+{
+    const dm_op_class_index_entry_t *entry;
+    em_op_class_info_t *info;
+    unsigned int pass;
+
+    if (m_op_class_indexed != m_num_opclass) {
+        reindex_op_class();
+    }
+    for (pass = 0; pass < 2; pass++) {
+        if ((entry = m_op_class_index.find(ruid, type, op_class)) == NULL) {
+            return NULL;
+        }
+        if (entry->idx < m_num_opclass) {
+            info = &m_op_class[entry->idx].m_op_class_info;
+            if ((em_hex::mac_equal(info->id.ruid, ruid) == true) && (info->id.type == type) &&
+                    (info->id.op_class == op_class) && (info->num_channels == entry->num_channels)) {
+                return entry;
+            }
         }
+        // m_op_class was written around the index
+        reindex_op_class();
     }
 
-    // If not found, create new entry
-    if (!target_mld) {
+    return NULL;
+}
+
+em_op_class_info_t *dm_easy_mesh_t::find_op_class(const unsigned char *ruid, em_op_class_type_t type, unsigned int op_class, unsigned int *idx)
+{
+    const dm_op_class_index_entry_t *entry;
+    em_op_class_info_t *info;
+    unsigned int i;
+
+    if ((entry = get_op_class_entry(ruid, type, op_class)) != NULL) {
+        if (idx != NULL) {
+            *idx = entry->idx;
+        }
+        return &m_op_class[entry->idx].m_op_class_info;
+    }
+
+    // a miss is mostly a class about to be appended, make sure no writer renamed an entry to it in place
+    for (i = 0; i < m_num_opclass; i++) {
+        info = &m_op_class[i].m_op_class_info;
+        if ((em_hex::mac_equal(info->id.ruid, ruid) == true) && (info->id.type == type) && (info->id.op_class == op_class)) {
+            reindex_op_class();
+            if (idx != NULL) {
+                *idx = i;
+            }
+            return info;
+        }
+    }
+
+    return NULL;
+}
+
+bool dm_easy_mesh_t::is_channel_allowed(const unsigned char *ruid, unsigned int op_class, unsigned int channel)
+{
+    const dm_op_class_index_entry_t *entry;
+
+    if ((entry = get_op_class_entry(ruid, em_op_class_type_capability, op_class)) == NULL) {
+        return m_op_class_index.has_capability(ruid) == false;
+    }
+
+    // the channel list of a capability operating class is the non operable channels
+    return dm_op_class_index_t::has_channel(entry, channel) == false;
+}
+
+int dm_easy_mesh_t::set_ap_mld(const em_ap_mld_info_t *info, unsigned int *idx, em_ap_mld_delta_t *delta)
+{
+    em_ap_mld_info_t *cur;
+    unsigned int i = 0, j, k, num_cur, num_info;
+
+    if (delta != NULL) {
+        memset(delta, 0, sizeof(em_ap_mld_delta_t));
+    }
+
+    if ((cur = find_ap_mld(info->mac_addr, &i)) == NULL) {
+        if ((info->num_affiliated_ap > 0) && (em_hex::pack_mac(info->mac_addr) == 0) &&
+                (find_affiliated_ap(info->affiliated_ap[0].mac_addr, &cur) != NULL)) {
+            // just checked by find_affiliated_ap()
+            m_ap_mld_index.find_link(info->affiliated_ap[0].mac_addr, &i, NULL);
+        } else if (m_num_ap_mld >= EM_MAX_AP_MLD) {
+            em_printfout("Max MLD entries reached");
+            return -1;
+        } else {
+            i = m_num_ap_mld;
+            set_num_ap_mld(m_num_ap_mld + 1);
+            if (m_num_ap_mld != i + 1) {
+                return -1;
+            }
+            cur = &m_ap_mld[i].m_ap_mld_info;
+            memset(cur, 0, sizeof(em_ap_mld_info_t));
+            m_ap_mld_indexed = m_num_ap_mld;
+        }
+    }
+    *idx = i;
+
+    if (memcmp(cur, info, sizeof(em_ap_mld_info_t)) == 0) {
+        return 0;
+    }
+
+    if (delta != NULL) {
+        num_cur = (cur->num_affiliated_ap < EM_MAX_AP_MLD) ? cur->num_affiliated_ap:EM_MAX_AP_MLD;
+        num_info = (info->num_affiliated_ap < EM_MAX_AP_MLD) ? info->num_affiliated_ap:EM_MAX_AP_MLD;
+        for (j = 0; j < num_info; j++) {
+            for (k = 0; (k < num_cur) && (em_hex::mac_equal(cur->affiliated_ap[k].mac_addr, info->affiliated_ap[j].mac_addr) == false); k++);
+            if (k == num_cur) {
+                delta->num_added++;
+            } else if (memcmp(&cur->affiliated_ap[k], &info->affiliated_ap[j], sizeof(em_affiliated_ap_info_t)) != 0) {
+                delta->num_changed++;
+            }
+        }
+        for (k = 0; k < num_cur; k++) {
+            for (j = 0; (j < num_info) && (em_hex::mac_equal(cur->affiliated_ap[k].mac_addr, info->affiliated_ap[j].mac_addr) == false); j++);
+            if (j == num_info) {
+                delta->removed[delta->num_removed++] = cur->affiliated_ap[k];
+            }
+        }
+    }
+
+    // only the links of this MLD are indexed again
+    m_ap_mld_index.remove_mld(cur->mac_addr, i);
+    for (j = 0; (j < cur->num_affiliated_ap) && (j < EM_MAX_AP_MLD); j++) {
+        m_ap_mld_index.remove_link(cur->affiliated_ap[j].mac_addr, i);
+    }
+    memcpy(cur, info, sizeof(em_ap_mld_info_t));
+    m_ap_mld_index.add_mld(cur->mac_addr, i);
+    for (j = 0; (j < cur->num_affiliated_ap) && (j < EM_MAX_AP_MLD); j++) {
+        m_ap_mld_index.add_link(cur->affiliated_ap[j].mac_addr, i, j);
+    }
+
+    return 1;
+}
+
+unsigned int dm_easy_mesh_t::remove_affiliated_ap(const unsigned char *mld_mac, const em_affiliated_ap_info_t *ap)
+{
+    em_assoc_sta_mld_info_t *sta_mld;
+    dm_bss_t *bss;
+    unsigned int i, j, num, changed = 0;
+    bool pruned = false;
+
+    bss = get_bss(const_cast<unsigned char *> (ap->ruid.mac), const_cast<unsigned char *> (ap->mac_addr));
+    if ((bss != NULL) && (em_hex::mac_equal(bss->m_bss_info.mld_mac, mld_mac) == true)) {
+        memset(bss->m_bss_info.mld_mac, 0, sizeof(mac_address_t));
+        set_bss_dirty(static_cast<unsigned int> (bss - m_bss));
+        changed++;
+    }
+
+    // the STA MLD is not torn down, only its link to the affiliated AP is gone
+    for (i = 0; i < m_num_assoc_sta_mld; i++) {
+        sta_mld = &m_assoc_sta_mld[i].m_assoc_sta_mld_info;
+        num = (sta_mld->num_affiliated_sta < EM_MAX_AP_MLD) ? sta_mld->num_affiliated_sta:EM_MAX_AP_MLD;
+        for (j = 0; j < num;) {
+            if (em_hex::mac_equal(sta_mld->affiliated_sta[j].bssid, ap->mac_addr) == false) {
+                j++;
+                continue;
+            }
+            memmove(&sta_mld->affiliated_sta[j], &sta_mld->affiliated_sta[j + 1], (num - j - 1) * sizeof(em_affiliated_sta_info_t));
+            num--;
+            changed++;
+            pruned = true;
+        }
+        sta_mld->num_affiliated_sta = static_cast<unsigned char> (num);
+    }
+    if (pruned == true) {
+        reindex_assoc_sta_mld();
+    }
+
+    return changed;
+}
+
+unsigned int dm_easy_mesh_t::remove_ap_mld_except(const std::bitset<EM_MAX_AP_MLD>& keep)
+{
+    unsigned int i, num = 0;
+
+    for (i = 0; i < m_num_ap_mld; i++) {
+        if (keep.test(i) == false) {
+            continue;
+        }
+        if (i != num) {
+            m_ap_mld[num] = m_ap_mld[i];
+        }
+        num++;
+    }
+    if (num == m_num_ap_mld) {
+        return 0;
+    }
+
+    i = m_num_ap_mld - num;
+    m_num_ap_mld = num;
+    reindex_ap_mld();
+
+    return i;
+}
+
+em_ap_mld_info_t *dm_easy_mesh_t::get_ap_mld_frm_bssid(mac_address_t bss_id)
+{
+    em_ap_mld_info_t *mld = NULL;
+
+    return (find_affiliated_ap(bss_id, &mld) != NULL) ? mld:NULL;
+}
+
+void dm_easy_mesh_t::update_ap_mld_info(em_ap_mld_info_t *ap_mld_info)
+{
+    em_ap_mld_info_t *target_mld, *owner;
+    em_affiliated_ap_info_t *input_ap, *target_aff_ap;
+    unsigned int i = 0, j, link;
+
+    // Find existing MLD by MAC, else create new entry
+    if ((target_mld = find_ap_mld(ap_mld_info->mac_addr, &i)) == NULL) {
         if (m_num_ap_mld >= EM_MAX_AP_MLD) {
             em_printfout("Max MLD entries reached");
             return;
         }
-
-        target_mld = &m_ap_mld[m_num_ap_mld].m_ap_mld_info;
+        i = m_num_ap_mld;
+        set_num_ap_mld(m_num_ap_mld + 1);
+        if (m_num_ap_mld != i + 1) {
+            return;
+        }
+        target_mld = &m_ap_mld[i].m_ap_mld_info;
         memset(target_mld, 0, sizeof(em_ap_mld_info_t));
-        em_printfout("Created new MLD at index %d", m_num_ap_mld);
-        m_num_ap_mld++;
+        m_ap_mld_index.add_mld(ap_mld_info->mac_addr, i);
+        m_ap_mld_indexed = m_num_ap_mld;
+        em_printfout("Created new MLD at index %d", i);
     }
 
     // Update MLD fields
@@ -2859,31 +3127,23 @@ void dm_easy_mesh_t::update_ap_mld_info(em_ap_mld_info_t *ap_mld_info)
     target_mld->emlsr = ap_mld_info->emlsr;
     target_mld->emlmr = ap_mld_info->emlmr;
 
-    // Loop through all affiliated APs
-    for (int j = 0; j < ap_mld_info->num_affiliated_ap; j++) {
-        em_affiliated_ap_info_t *input_ap = &ap_mld_info->affiliated_ap[j];
-        em_affiliated_ap_info_t *target_aff_ap = NULL;
-        bool aff_ap_found = false;
-
-        for (int k = 0; k < target_mld->num_affiliated_ap; k++) {
-            if (memcmp(target_mld->affiliated_ap[k].mac_addr, input_ap->mac_addr, sizeof(mac_address_t)) == 0) {
-                target_aff_ap = &target_mld->affiliated_ap[k];
-                aff_ap_found = true;
-                em_printfout("Found existing affiliated AP at index %d", k);
-                break;
-            }
+    // Loop through all affiliated APs, the ones of this MLD are found through the index
+    for (j = 0; (j < ap_mld_info->num_affiliated_ap) && (j < EM_MAX_AP_MLD); j++) {
+        input_ap = &ap_mld_info->affiliated_ap[j];
+        owner = NULL;
+        if (((target_aff_ap = find_affiliated_ap(input_ap->mac_addr, &owner)) != NULL) && (owner != target_mld)) {
+            target_aff_ap = NULL;
         }
 
-        if (!aff_ap_found) {
+        if (target_aff_ap == NULL) {
             if (target_mld->num_affiliated_ap >= EM_MAX_AP_MLD) {
                 em_printfout("Max affiliated APs reached for MLD");
                 continue;
             }
-
-            target_aff_ap = &target_mld->affiliated_ap[target_mld->num_affiliated_ap];
+            link = target_mld->num_affiliated_ap++;
+            target_aff_ap = &target_mld->affiliated_ap[link];
             memset(target_aff_ap, 0, sizeof(em_affiliated_ap_info_t));
-            em_printfout("Added new affiliated AP at index %d",target_mld->num_affiliated_ap);
-            target_mld->num_affiliated_ap++;
+            m_ap_mld_index.add_link(input_ap->mac_addr, i, link);
         }
 
         // Update affiliated AP fields
@@ -2905,8 +3165,44 @@ void dm_easy_mesh_t::update_bsta_mld_info(em_bsta_mld_info_t *bsta_mld_info)
 
 void dm_easy_mesh_t::update_assoc_sta_mld_info(em_assoc_sta_mld_info_t *assoc_sta_mld_info)
 {
-    // TODO: Implement ASSOC MLD info update logic
-    em_printfout("Enter");
+    em_assoc_sta_mld_info_t *target;
+    unsigned int i = 0, j, k;
+
+    // kept by MLD MAC address
+    if (em_hex::pack_mac(assoc_sta_mld_info->mac_addr) == 0) {
+        return;
+    }
+    if (((target = find_assoc_sta_mld(assoc_sta_mld_info->mac_addr)) == NULL) ||
+            (em_hex::mac_equal(target->mac_addr, assoc_sta_mld_info->mac_addr) == false)) {
+        if ((m_num_assoc_sta_mld >= EM_MAX_ASSOC_STA_MLD) || (m_assoc_sta_mld.reserve(m_num_assoc_sta_mld + 1) != 0)) {
+            em_printfout("Max associated STA MLD entries reached");
+            return;
+        }
+        target = &m_assoc_sta_mld[m_num_assoc_sta_mld].m_assoc_sta_mld_info;
+        memset(target, 0, sizeof(em_assoc_sta_mld_info_t));
+        memcpy(target->mac_addr, assoc_sta_mld_info->mac_addr, sizeof(mac_address_t));
+        m_assoc_sta_mld_index.add_mld(target->mac_addr, m_num_assoc_sta_mld);
+        m_num_assoc_sta_mld++;
+        m_assoc_sta_mld_indexed = m_num_assoc_sta_mld;
+    }
+    m_assoc_sta_mld_index.find_mld(target->mac_addr, &i);
+
+    memcpy(target->ap_mld_mac_addr, assoc_sta_mld_info->ap_mld_mac_addr, sizeof(mac_address_t));
+    target->str = assoc_sta_mld_info->str;
+    target->nstr = assoc_sta_mld_info->nstr;
+    target->emlsr = assoc_sta_mld_info->emlsr;
+    target->emlmr = assoc_sta_mld_info->emlmr;
+
+    // the links of the STA are replaced, a link that left is no longer found
+    for (j = 0; (j < target->num_affiliated_sta) && (j < EM_MAX_AP_MLD); j++) {
+        m_assoc_sta_mld_index.remove_link(target->affiliated_sta[j].mac_addr, i);
+    }
+    k = (assoc_sta_mld_info->num_affiliated_sta < EM_MAX_AP_MLD) ? assoc_sta_mld_info->num_affiliated_sta:EM_MAX_AP_MLD;
+    memcpy(target->affiliated_sta, assoc_sta_mld_info->affiliated_sta, k * sizeof(em_affiliated_sta_info_t));
+    target->num_affiliated_sta = static_cast<unsigned char> (k);
+    for (j = 0; j < k; j++) {
+        m_assoc_sta_mld_index.add_link(target->affiliated_sta[j].mac_addr, i, j);
+    }
 }
 
 void dm_easy_mesh_t::reset_db_cfg_type(db_cfg_type_t type) 
@@ -2942,6 +3238,28 @@ void dm_easy_mesh_t::set_db_cfg_param(db_cfg_type_t cfg_type, const char *criter
 
 	m_db_cfg_param.db_cfg_type |= static_cast<unsigned int> (cfg_type);
 	strncpy(m_db_cfg_param.db_cfg_criteria[index], criteria, strlen(criteria));
+	set_changed();
+}
+
+void dm_easy_mesh_t::set_sta_dirty(dm_sta_t *sta)
+{
+    if (sta->is_dirty() == false) {
+        sta->set_dirty(true);
+        m_num_dirty_sta++;
+    }
+    set_changed();
+}
+
+void dm_easy_mesh_t::reset_sta_dirty()
+{
+    dm_sta_t *sta;
+
+    sta = static_cast<dm_sta_t *> (m_sta_map->get_first());
+    while (sta != NULL) {
+        sta->set_dirty(false);
+        sta = static_cast<dm_sta_t *> (m_sta_map->get_next(sta));
+    }
+    m_num_dirty_sta = 0;
 }
 
 char *dm_easy_mesh_t::db_cfg_type_get_criteria(db_cfg_type_t cfg_type)
@@ -2972,10 +3290,10 @@ int dm_easy_mesh_t::init()
 	    m_network_ssid[i].init();
     }
 
-    m_scan_result_map = hash_map_create();
-    m_sta_map = hash_map_create();
-    m_sta_assoc_map = hash_map_create();
-    m_sta_dassoc_map = hash_map_create();
+    m_scan_result_map = new dm_key_map_t();
+    m_sta_map = new dm_key_map_t();
+    m_sta_assoc_map = new dm_key_map_t();
+    m_sta_dassoc_map = new dm_key_map_t();
     m_wifi_data = static_cast<webconfig_subdoc_data_t*> (malloc(sizeof(webconfig_subdoc_data_t)));
 	memset(&m_db_cfg_param, 0, sizeof(em_db_cfg_param_t));
     return 0;
@@ -2990,7 +3308,14 @@ void dm_easy_mesh_t::reset()
 	m_num_policy = 0;
 	m_num_bss = 0;
     m_num_ap_mld = 0;
+    m_num_bsta_mld = 0;
+    m_num_assoc_sta_mld = 0;
 	m_db_cfg_param.db_cfg_type = db_cfg_type_none;
+    m_bss_dirty.reset();
+    m_op_class_dirty.reset();
+    m_op_class_index.clear();
+    m_op_class_indexed = 0;
+    m_num_dirty_sta = 0;
     m_colocated = false;
 
 	memset(&m_network.m_net_info, 0, sizeof(em_network_info_t));
@@ -3018,8 +3343,13 @@ dm_easy_mesh_t::dm_easy_mesh_t()
 	m_num_policy = 0;
 	m_num_bss = 0;
     m_num_ap_mld = 0;
+    m_num_bsta_mld = 0;
+    m_num_assoc_sta_mld = 0;
     m_num_net_ssids = 0;
 	m_db_cfg_param.db_cfg_type = db_cfg_type_none;
+    m_bss_dirty.reset();
+    m_op_class_dirty.reset();
+    m_num_dirty_sta = 0;
     m_colocated = false;
 }
 
@@ -35,6 +35,7 @@
 #include <sys/socket.h>
 #include <sys/uio.h>
 #include <sys/time.h> 
+#include <time.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <ifaddrs.h> 
@@ -45,6 +46,290 @@
 #include "em_cmd_ap_cap.h"
 #include "tr_181.h"
 
+void *dm_list_cursor_t::get_first_in_dm(dm_easy_mesh_t *dm)
+{
+    switch (m_walk) {
+        case dm_list_walk_device:
+            return dm->get_device();
+
+        case dm_list_walk_radio:
+            return (dm->get_num_radios() > 0) ? dm->get_radio(0u):NULL;
+
+        case dm_list_walk_bss:
+            return (dm->get_num_bss() > 0) ? dm->get_bss(0u):NULL;
+
+        case dm_list_walk_sta:
+            return (dm->m_sta_map != NULL) ? dm->m_sta_map->get_first():NULL;
+
+        case dm_list_walk_op_class:
+            return (dm->get_num_op_class() > 0) ? dm->get_op_class(0u):NULL;
+
+        case dm_list_walk_policy:
+            return (dm->get_num_policy() > 0) ? dm->get_policy(0u):NULL;
+
+        case dm_list_walk_scan_result:
+            return (dm->m_scan_result_map != NULL) ? dm->m_scan_result_map->get_first():NULL;
+
+        default:
+            break;
+    }
+
+    return NULL;
+}
+
+void *dm_list_cursor_t::get_next_in_dm()
+{
+    unsigned int idx = m_idx + 1;
+
+    switch (m_walk) {
+        case dm_list_walk_radio:
+            return (idx < m_dm->get_num_radios()) ? m_dm->get_radio(idx):NULL;
+
+        case dm_list_walk_bss:
+            return (idx < m_dm->get_num_bss()) ? m_dm->get_bss(idx):NULL;
+
+        case dm_list_walk_sta:
+            return (m_dm->m_sta_map != NULL) ? m_dm->m_sta_map->get_next(m_cur):NULL;
+
+        case dm_list_walk_op_class:
+            return (idx < m_dm->get_num_op_class()) ? m_dm->get_op_class(idx):NULL;
+
+        case dm_list_walk_policy:
+            return (idx < m_dm->get_num_policy()) ? m_dm->get_policy(idx):NULL;
+
+        case dm_list_walk_scan_result:
+            return (m_dm->m_scan_result_map != NULL) ? m_dm->m_scan_result_map->get_next(m_cur):NULL;
+
+        default:
+            break;
+    }
+
+    return NULL;
+}
+
+void *dm_list_cursor_t::first()
+{
+    reset();
+    if (m_list == NULL) {
+        return NULL;
+    }
+
+    for (m_dm = m_list->get_first_dm(); m_dm != NULL; m_dm = m_list->get_next_dm(m_dm)) {
+        if ((m_cur = get_first_in_dm(m_dm)) != NULL) {
+            return m_cur;
+        }
+    }
+
+    return NULL;
+}
+
+void *dm_list_cursor_t::next()
+{
+    if (m_cur == NULL) {
+        return NULL;
+    }
+
+    if ((m_cur = get_next_in_dm()) != NULL) {
+        m_idx++;
+        return m_cur;
+    }
+
+    m_idx = 0;
+    for (m_dm = m_list->get_next_dm(m_dm); m_dm != NULL; m_dm = m_list->get_next_dm(m_dm)) {
+        if ((m_cur = get_first_in_dm(m_dm)) != NULL) {
+            return m_cur;
+        }
+    }
+
+    return NULL;
+}
+
+bool dm_list_cursor_t::seek(const void *elem)
+{
+    void *cur;
+
+    for (cur = first(); cur != NULL; cur = next()) {
+        if (cur == elem) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void *dm_easy_mesh_list_t::get_walk_next(dm_list_walk_t walk, const void *elem)
+{
+    dm_list_cursor_t *cursor = &m_walk[walk];
+
+    if (elem == NULL) {
+        return NULL;
+    }
+
+    if ((cursor->get() != elem) && (cursor->seek(elem) == false)) {
+        return NULL;
+    }
+
+    return cursor->next();
+}
+
+void dm_easy_mesh_list_t::reset_walks()
+{
+    unsigned int i;
+
+    for (i = 0; i < dm_list_walk_max; i++) {
+        m_walk[i].reset();
+    }
+}
+
+void dm_easy_mesh_list_t::forget_data_model(dm_easy_mesh_t *dm)
+{
+    reset_walks();
+    if (dm != NULL) {
+        m_radio_index.remove_value(dm);
+        m_bss_index.remove_value(dm);
+        m_dev_index.remove_value(dm);
+        for (auto it = m_dm_keys.begin(); it != m_dm_keys.end(); ) {
+            it = (it->second == dm) ? m_dm_keys.erase(it):std::next(it);
+        }
+    }
+    m_dm_ids.clear();
+    m_generation = dm_easy_mesh_t::next_generation();
+}
+
+dm_radio_t *dm_easy_mesh_list_t::find_radio(dm_easy_mesh_t *dm, const unsigned char *ruid)
+{
+    unsigned int i;
+
+    for (i = 0; i < dm->get_num_radios(); i++) {
+        if (memcmp(dm->m_radio[i].m_radio_info.intf.mac, ruid, sizeof(mac_address_t)) == 0) {
+            return &dm->m_radio[i];
+        }
+    }
+
+    return NULL;
+}
+
+dm_bss_t *dm_easy_mesh_list_t::find_bss(dm_easy_mesh_t *dm, const unsigned char *bssid)
+{
+    unsigned int i;
+
+    for (i = 0; i < dm->get_num_bss(); i++) {
+        if (memcmp(dm->m_bss[i].m_bss_info.bssid.mac, bssid, sizeof(bssid_t)) == 0) {
+            return &dm->m_bss[i];
+        }
+    }
+
+    return NULL;
+}
+
+dm_easy_mesh_t *dm_easy_mesh_list_t::get_dm_by_radio(const unsigned char *ruid, dm_radio_t **radio)
+{
+    dm_easy_mesh_t *dm;
+    dm_radio_t *pradio;
+
+    if ((dm = static_cast<dm_easy_mesh_t *> (m_radio_index.get(ruid))) != NULL) {
+        if ((pradio = find_radio(dm, ruid)) != NULL) {
+            if (radio != NULL) {
+                *radio = pradio;
+            }
+            return dm;
+        }
+        // the radio went away or was moved to another data model
+        m_radio_index.remove(ruid, dm);
+    }
+
+    for (dm = get_first_dm(); dm != NULL; dm = get_next_dm(dm)) {
+        if ((pradio = find_radio(dm, ruid)) != NULL) {
+            m_radio_index.add(ruid, dm);
+            if (radio != NULL) {
+                *radio = pradio;
+            }
+            return dm;
+        }
+    }
+
+    return NULL;
+}
+
+dm_easy_mesh_t *dm_easy_mesh_list_t::get_dm_by_bss(const unsigned char *bssid, dm_bss_t **bss)
+{
+    dm_easy_mesh_t *dm;
+    dm_bss_t *pbss;
+
+    if ((dm = static_cast<dm_easy_mesh_t *> (m_bss_index.get(bssid))) != NULL) {
+        if ((pbss = find_bss(dm, bssid)) != NULL) {
+            if (bss != NULL) {
+                *bss = pbss;
+            }
+            return dm;
+        }
+        m_bss_index.remove(bssid, dm);
+    }
+
+    for (dm = get_first_dm(); dm != NULL; dm = get_next_dm(dm)) {
+        if ((pbss = find_bss(dm, bssid)) != NULL) {
+            m_bss_index.add(bssid, dm);
+            if (bss != NULL) {
+                *bss = pbss;
+            }
+            return dm;
+        }
+    }
+
+    return NULL;
+}
+
+dm_bss_t *dm_easy_mesh_list_t::get_bss_by_mac(const unsigned char *bssid)
+{
+    dm_bss_t *bss = NULL;
+
+    get_dm_by_bss(bssid, &bss);
+
+    return bss;
+}
+
+dm_easy_mesh_t *dm_easy_mesh_list_t::get_dm_by_id(int id)
+{
+    std::unordered_map<int, dm_easy_mesh_t *>::iterator it;
+    dm_easy_mesh_t *dm;
+
+    // a data model copied over another one takes its instance number along
+    if (((it = m_dm_ids.find(id)) == m_dm_ids.end()) || (it->second->get_id() != id)) {
+        m_dm_ids.clear();
+        for (dm = get_first_dm(); dm != NULL; dm = get_next_dm(dm)) {
+            m_dm_ids.emplace(dm->get_id(), dm);
+        }
+        it = m_dm_ids.find(id);
+    }
+
+    return (it == m_dm_ids.end()) ? NULL:it->second;
+}
+
+dm_easy_mesh_t *dm_easy_mesh_list_t::get_dm_by_dev_mac(const unsigned char *dev_mac)
+{
+    dm_easy_mesh_t *dm;
+    dm_device_t *dev;
+
+    if ((dm = static_cast<dm_easy_mesh_t *> (m_dev_index.get(dev_mac))) != NULL) {
+        if (((dev = dm->get_device()) != NULL) &&
+                (memcmp(dev->m_device_info.id.dev_mac, dev_mac, sizeof(mac_address_t)) == 0)) {
+            return dm;
+        }
+        // the device info was rewritten with another ID
+        m_dev_index.remove(dev_mac, dm);
+    }
+
+    for (dm = get_first_dm(); dm != NULL; dm = get_next_dm(dm)) {
+        if (((dev = dm->get_device()) != NULL) &&
+                (memcmp(dev->m_device_info.id.dev_mac, dev_mac, sizeof(mac_address_t)) == 0)) {
+            m_dev_index.add(dev_mac, dm);
+            return dm;
+        }
+    }
+
+    return NULL;
+}
+
 dm_network_t *dm_easy_mesh_list_t::get_first_network()
 {
     dm_network_t *net = NULL;
@@ -157,34 +442,12 @@ void dm_easy_mesh_list_t::put_network(const char *key, const dm_network_t *net)
 
 dm_device_t *dm_easy_mesh_list_t::get_first_device()
 {
-    dm_easy_mesh_t *dm;
-
-    dm = static_cast<dm_easy_mesh_t *> (hash_map_get_first(m_list));
-    if (dm == NULL) {
-		return NULL;
-    }
-
-    return dm->get_device();
+    return static_cast<dm_device_t *> (m_walk[dm_list_walk_device].first());
 }
 
 dm_device_t *dm_easy_mesh_list_t::get_next_device(dm_device_t *dev)
-{   
-	dm_easy_mesh_t *dm;
-	bool return_next = false;
-
-
-	dm = static_cast<dm_easy_mesh_t *> (hash_map_get_first(m_list));
-	while (dm != NULL) {
-		if (return_next == true) {
-			break;
-		}
-		if (dm->get_device() == dev) {
-			return_next = true;
-		}	
-		dm = static_cast<dm_easy_mesh_t *> (hash_map_get_next(m_list, dm));
-	}
-
-    return ((return_next == true) && (dm != NULL)) ? dm->get_device():NULL;
+{
+    return static_cast<dm_device_t *> (get_walk_next(dm_list_walk_device, dev));
 }
 
 dm_device_t *dm_easy_mesh_list_t::get_device(const char *key)
@@ -208,7 +471,8 @@ void dm_easy_mesh_list_t::remove_device(const char *key)
     dm_easy_mesh_t *dm;
     dm = static_cast<dm_easy_mesh_t *> (hash_map_remove(m_list, key));
 	if (dm != NULL) {
-		delete dm;
+		forget_data_model(dm);
+		free_data_model(dm);
 	}
 }
 
@@ -259,90 +523,21 @@ void dm_easy_mesh_list_t::update_device(const char *key, const dm_device_t *dev)
 
 dm_radio_t *dm_easy_mesh_list_t::get_first_radio()
 {
-    dm_radio_t *radio = NULL;
-    dm_easy_mesh_t *dm;
-
-    dm = static_cast<dm_easy_mesh_t *> (hash_map_get_first(m_list));
-    while (dm != NULL) {
-        //printf("%s:%d: Number of radios:%d\n", __func__, __LINE__, dm->get_num_radios());
-        if (dm->get_num_radios() > 0) {
-            radio = dm->get_radio(static_cast<unsigned int> (0));
-            break;
-        }
-        dm = static_cast<dm_easy_mesh_t *> (hash_map_get_next(m_list, dm));
-    }
-
-    return radio;
+    return static_cast<dm_radio_t *> (m_walk[dm_list_walk_radio].first());
 }
 
 dm_radio_t *dm_easy_mesh_list_t::get_next_radio(dm_radio_t *radio)
-{  
-    dm_radio_t *pradio = NULL;
-    dm_easy_mesh_t *dm;
-	bool return_next = false;
-	unsigned int i;
-
-	
-	dm = static_cast<dm_easy_mesh_t *> (hash_map_get_first(m_list));
-	while (dm != NULL) {
-        if (return_next == true) {
-            if (dm->get_num_radios()) {
-                pradio = dm->get_radio(i = 0);
-            } else {
-				return_next = false;
-			}
-
-			break;
-		}
-		for (i = 0; i < dm->get_num_radios(); i++) {
-			pradio = dm->get_radio(i);
-			if (radio == pradio) {
-				return_next = true;	
-			}
-
-			if (return_next && ((i + 1) < dm->get_num_radios())) {
-				return dm->get_radio(i + 1);
-		
-			}
-		}
-
-		dm = static_cast<dm_easy_mesh_t *> (hash_map_get_next(m_list, dm));
-        
-        if ((dm == NULL) && (return_next == true)) {
-            return_next = false;
-        }
-	}
-
-    return (return_next == true) ? pradio:NULL;
+{
+    return static_cast<dm_radio_t *> (get_walk_next(dm_list_walk_radio, radio));
 }
 
 dm_radio_t *dm_easy_mesh_list_t::get_radio(const char *key)
 {  
-    dm_radio_t *radio = NULL;
-    dm_easy_mesh_t *dm;
-	unsigned int i;
-	bool found = false;
 	mac_address_t mac;
 
 	dm_easy_mesh_t::string_to_macbytes(const_cast<char *> (key), mac);
-	
-	dm = static_cast<dm_easy_mesh_t *> (hash_map_get_first(m_list));
-	while (dm != NULL) {
-		for (i = 0;  i < dm->get_num_radios(); i++) {
-			radio = dm->get_radio(i);
-			if (memcmp(radio->m_radio_info.intf.mac, mac, sizeof(mac_address_t)) == 0) {
-				found = true;
-				break;
-			}
-		}
-
-		if (found == true) {
-			break;
-		}
-		dm = static_cast<dm_easy_mesh_t *> (hash_map_get_next(m_list, dm));
-	}
 
-    return (found == true) ? radio:NULL;
+	return get_radio_by_mac(mac);
 }
 
 void dm_easy_mesh_list_t::remove_radio(const char *key)
@@ -369,6 +564,7 @@ void dm_easy_mesh_list_t::put_radio(const char *key, const dm_radio_t *radio)
         //em_printfout("Current Number of Radios: %d", dm->get_num_radios());
         dm->set_num_radios(dm->get_num_radios() + 1);
         pradio = dm->get_radio(dm->get_num_radios() - 1);
+        m_radio_index.add(radio->m_radio_info.intf.mac, dm);
     }
     *pradio = *radio;
     em_printfout("Radio dev_id is:%s", util::mac_to_string(pradio->m_radio_info.id.dev_mac).c_str());
@@ -418,59 +614,12 @@ dm_radio_t *dm_easy_mesh_list_t::get_next_radio(const char *net_id, mac_address_
 
 dm_bss_t *dm_easy_mesh_list_t::get_first_bss()
 {
-    dm_bss_t *bss = NULL;
-    dm_easy_mesh_t *dm;
-    bool found = false;
-
-    dm = static_cast<dm_easy_mesh_t *> (hash_map_get_first(m_list));
-    while (dm != NULL) {
-        if (dm->get_num_bss() > 0) {
-            bss = dm->get_bss(static_cast<unsigned int> (0));
-			found = true;
-			break;
-        }
-        dm = static_cast<dm_easy_mesh_t *> (hash_map_get_next(m_list, dm));
-    }
-    return (found == true) ? bss:NULL;
-    
+    return static_cast<dm_bss_t *> (m_walk[dm_list_walk_bss].first());
 }
 
 dm_bss_t *dm_easy_mesh_list_t::get_next_bss(dm_bss_t *bss)
-{ 
-    dm_bss_t *pbss = NULL;
-    dm_easy_mesh_t *dm;
-    bool return_next = false;
-    unsigned int i;
-
-    dm = static_cast<dm_easy_mesh_t *> (hash_map_get_first(m_list));
-    while (dm != NULL) {
-        if (return_next == true) {
-            if (dm->get_num_bss()) {
-                pbss = dm->get_bss(i = 0);
-            } else {
-                return_next = false;
-            }
-        
-            break;
-        } 
-        for (i = 0; i < dm->get_num_bss(); i++) {
-            pbss = dm->get_bss(i);
-            if (bss == pbss) {
-                return_next = true;
-            }   
-            
-            if (return_next && ((i + 1) < dm->get_num_bss())) {
-                return dm->get_bss(i + 1);
-            }
-        }
-
-        dm = static_cast<dm_easy_mesh_t *> (hash_map_get_next(m_list, dm));
-        if ((dm == NULL) && (return_next == true)) {
-            return_next = false;
-        }
-    }
-
-    return (return_next == true) ? pbss:NULL;  
+{
+    return static_cast<dm_bss_t *> (get_walk_next(dm_list_walk_bss, bss));
 }
 
 dm_bss_t *dm_easy_mesh_list_t::get_bss(const char *key)
@@ -508,6 +657,7 @@ void dm_easy_mesh_list_t::remove_bss(const char *key)
 
 	for (i = 0; i < dm->m_num_bss; i++) {
 		if (memcmp(dm->m_bss[i].m_bss_info.bssid.mac, id.bssid, sizeof(bssid_t)) == 0) {
+			m_bss_index.remove(id.bssid, dm);
 			return dm->remove_bss_by_index(i);
 		}
 	}
@@ -536,87 +686,35 @@ void dm_easy_mesh_list_t::put_bss(const char *key, const dm_bss_t *bss)
 	}	
 
 	*pbss = *bss;
+	m_bss_index.add(pbss->m_bss_info.bssid.mac, dm);
 }
 
-dm_sta_t *dm_easy_mesh_list_t::get_first_sta()
-{
-    dm_sta_t *sta = NULL;
-    dm_easy_mesh_t *dm;
-
-    dm = static_cast<dm_easy_mesh_t *> (hash_map_get_first(m_list));
-    while (dm != NULL) {
-        sta = static_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_map));
-        if (sta != NULL) {
-            return sta;
-        }
-        dm = static_cast<dm_easy_mesh_t *> (hash_map_get_next(m_list, dm));
-    }
-
-    return sta;
+dm_sta_t *dm_easy_mesh_list_t::get_first_sta()
+{
+    return static_cast<dm_sta_t *> (m_walk[dm_list_walk_sta].first());
 }
 
 dm_sta_t *dm_easy_mesh_list_t::get_next_sta(dm_sta_t *psta)
 {
-    dm_sta_t *sta = NULL;
-    dm_easy_mesh_t *dm;
-    bool return_next = false;
-
-    dm = static_cast<dm_easy_mesh_t *> (hash_map_get_first(m_list));
-    while (dm != NULL) {
-        sta = static_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_map));
-        while (sta != NULL) {
-            if (return_next == true) {
-                return sta;
-            }
-            if (sta == psta) {
-                return_next = true;
-            }
-            sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_map, sta));
-        }
-        dm = static_cast<dm_easy_mesh_t *> (hash_map_get_next(m_list, dm));
-    }
+    return static_cast<dm_sta_t *> (get_walk_next(dm_list_walk_sta, psta));
+}
 
-    return NULL;
-}   
-    
 dm_sta_t *dm_easy_mesh_list_t::get_sta(const char *key)
 {   
     dm_sta_t *sta;
     dm_easy_mesh_t *dm;
     mac_address_t sta_mac, ruid;
-    mac_addr_str_t	sta_mac_str, radio_mac_str, bssid_str;
     bssid_t	bssid;
-    bool found = false;
-    unsigned int i;
+    dm_map_key_t map_key;
 
     dm_sta_t::parse_sta_bss_radio_from_key(key, sta_mac, bssid, ruid);
 
-    dm = static_cast<dm_easy_mesh_t *> (hash_map_get_first(m_list));
-    while (dm != NULL) {
-        for (i = 0; i < dm->m_num_radios; i++) {
-            if (memcmp(dm->m_radio[i].m_radio_info.intf.mac, ruid, sizeof(mac_address_t)) == 0) {
-                found = true;
-                break;
-            }
-        }
-
-        if (found == true) {
-            break;
-        }
-        dm = static_cast<dm_easy_mesh_t *> (hash_map_get_next(m_list, dm));
-    }
-
-    if (found == false) {
+    if ((dm = get_dm_by_radio(ruid)) == NULL) {
         return NULL;
     }
 
-    dm_easy_mesh_t::macbytes_to_string(sta_mac, sta_mac_str);
-    dm_easy_mesh_t::macbytes_to_string(bssid, bssid_str);
-    dm_easy_mesh_t::macbytes_to_string(ruid, radio_mac_str);
-
-    if ((sta = static_cast<dm_sta_t *> (hash_map_get(dm->m_sta_map, key))) != NULL) {
-        //printf("%s:%d: STA:%s found on BSS:%s of radio:%s\n", __func__, __LINE__,
-        //sta_mac_str, bssid_str, radio_mac_str);
+    dm_key_map_t::sta_key(&map_key, sta_mac, bssid, ruid);
+    if ((sta = static_cast<dm_sta_t *> (dm->m_sta_map->get(&map_key))) != NULL) {
         return sta;
     }
 
@@ -633,45 +731,30 @@ void dm_easy_mesh_list_t::put_sta(const char *key, const dm_sta_t *sta)
     dm_sta_t *psta;
     dm_easy_mesh_t *dm;
     mac_address_t sta_mac, ruid;
-    mac_addr_str_t	sta_mac_str, radio_mac_str, bssid_str;
+    mac_addr_str_t	radio_mac_str;
     bssid_t	bssid;
-    bool found = false;
-    unsigned int i;
+    dm_map_key_t map_key;
 
     dm_sta_t::parse_sta_bss_radio_from_key(key, sta_mac, bssid, ruid);
-    dm_easy_mesh_t::macbytes_to_string(sta_mac, sta_mac_str);
-    dm_easy_mesh_t::macbytes_to_string(bssid, bssid_str);
-    dm_easy_mesh_t::macbytes_to_string(ruid, radio_mac_str);
-
-    dm = static_cast<dm_easy_mesh_t *> (hash_map_get_first(m_list));
-    while (dm != NULL) {
-        for (i = 0; i < dm->m_num_radios; i++) {
-            if (memcmp(dm->m_radio[i].m_radio_info.intf.mac, ruid, sizeof(mac_address_t)) == 0) {
-                found = true;
-                break;
-            }
-        }
-
-        if (found == true) {
-            break;
-        }
-        dm = static_cast<dm_easy_mesh_t *> (hash_map_get_next(m_list, dm));
-    }
 
-    if (found == false) {
+    if ((dm = get_dm_by_radio(ruid)) == NULL) {
+        dm_easy_mesh_t::macbytes_to_string(ruid, radio_mac_str);
         printf("%s:%d: Could not find dm with radio:%s\n", __func__, __LINE__, radio_mac_str);
         return;
     }
 
-    if ((psta = static_cast<dm_sta_t *> (hash_map_get(dm->m_sta_map, key))) != NULL) {
+    dm_key_map_t::sta_key(&map_key, sta_mac, bssid, ruid);
+    if ((psta = static_cast<dm_sta_t *> (dm->m_sta_map->get(&map_key))) != NULL) {
         //printf("%s:%d: STA:%s already present on BSS:%s of radio:%s dm:%p dm_mac:%s\n", __func__, __LINE__,
         //    sta_mac_str, bssid_str, radio_mac_str, dm, util::mac_to_string(dm->m_device.m_device_info.intf.mac).c_str());
         memcpy(&psta->m_sta_info, &sta->m_sta_info, sizeof(em_sta_info_t));
+        psta->m_caps = sta->m_caps;
+        psta->m_caps_hash = sta->m_caps_hash;
         return;
     }
 
     psta = new dm_sta_t(*sta);
-    hash_map_put(dm->m_sta_map, strdup(key), psta);
+    dm->m_sta_map->put(&map_key, psta);
 
     //printf("%s:%d: STA:%s added to BSS:%s of radio:%s dm:%p dm_mac:%s\n", __func__, __LINE__,
     //        sta_mac_str, bssid_str, radio_mac_str, dm, util::mac_to_string(dm->m_device.m_device_info.intf.mac).c_str());
@@ -763,14 +846,19 @@ void dm_easy_mesh_list_t::debug_probe()
 {
     dm_easy_mesh_t *dm;
     mac_addr_str_t  mac_str;
+    size_t sz, total = 0;
 
     dm = static_cast<dm_easy_mesh_t *> (hash_map_get_first(m_list));
     while (dm != NULL) {
         dm_easy_mesh_t::macbytes_to_string(dm->get_agent_al_interface_mac(), mac_str);
+        sz = dm->get_footprint();
+        total += sz;
         //printf("%s:%d: Dst AL MAC: %s\n", __func__, __LINE__, mac_str);
         //printf("%s:%d: Number of radios:%d Number of BSS: %d\n", __func__, __LINE__, dm->get_num_radios(), dm->get_num_bss());
+        printf("%s:%d: Agent: %s footprint: %zu bytes\n", __func__, __LINE__, mac_str, sz);
         dm = static_cast<dm_easy_mesh_t *> (hash_map_get_next(m_list, dm));
     }
+    printf("%s:%d: Data models footprint: %zu bytes\n", __func__, __LINE__, total);
 }
 
 void dm_easy_mesh_list_t::remove_network_ssid(const char *key)
@@ -852,60 +940,12 @@ void dm_easy_mesh_list_t::put_network_ssid(const char *key, const dm_network_ssi
 
 dm_op_class_t *dm_easy_mesh_list_t::get_first_op_class()
 {
-    dm_op_class_t *op_class = NULL;
-    dm_easy_mesh_t *dm;
-	bool found = false;
-    
-    dm = static_cast<dm_easy_mesh_t *> (hash_map_get_first(m_list));
-    while (dm != NULL) {
-        if (dm->get_num_op_class() > 0) {
-            op_class = dm->get_op_class(static_cast<unsigned int> (0));
-			found = true;
-			break;
-        }
-        dm = static_cast<dm_easy_mesh_t *> (hash_map_get_next(m_list, dm));
-    }
-
-    return (found == true) ? op_class:NULL;
+    return static_cast<dm_op_class_t *> (m_walk[dm_list_walk_op_class].first());
 }
 
 dm_op_class_t *dm_easy_mesh_list_t::get_next_op_class(dm_op_class_t *op_class)
 {
-    dm_op_class_t *pop_class = NULL;
-    dm_easy_mesh_t *dm;
-    bool return_next = false;
-    unsigned int i;
-        
-    dm = static_cast<dm_easy_mesh_t *> (hash_map_get_first(m_list));
-    while (dm != NULL) {
-        if (return_next == true) {
-            if (dm->get_num_op_class()) {
-                pop_class = dm->get_op_class(i = 0);
-            } else {
-                return_next = false;
-            }
-
-            break;
-        }
-        for (i = 0; i < dm->get_num_op_class(); i++) {
-            pop_class = dm->get_op_class(i);
-            if (pop_class == op_class) {
-                return_next = true;
-            }
-    
-            if (return_next && ((i + 1) < dm->get_num_op_class())) {
-                return dm->get_op_class(i + 1);
-            }
-        }
-
-        dm = static_cast<dm_easy_mesh_t *> (hash_map_get_next(m_list, dm));
-        if ((dm == NULL) && (return_next == true)) {
-            return_next = false;
-        }
-    }
-
-    return (return_next == true) ? pop_class:NULL;
-
+    return static_cast<dm_op_class_t *> (get_walk_next(dm_list_walk_op_class, op_class));
 }
 
 dm_op_class_t *dm_easy_mesh_list_t::get_op_class(const char *key)
@@ -915,7 +955,6 @@ dm_op_class_t *dm_easy_mesh_list_t::get_op_class(const char *key)
 	dm_radio_t *radio;
 	bool found_dm = false;
 	unsigned int i;
-    dm_op_class_t *pop_class;
 	mac_addr_str_t	mac_str;
 	
     dm_op_class_t::parse_op_class_id_from_key(key, &id);
@@ -951,21 +990,11 @@ dm_op_class_t *dm_easy_mesh_list_t::get_op_class(const char *key)
 	//printf("%s:%d: Number of op classes: %d\n", __func__, __LINE__, dm->get_num_op_class());
 
     // now check if the op class is already there
-	for (i = 0; i < dm->get_num_op_class(); i++) {
-		pop_class = &dm->m_op_class[i];
-		dm_easy_mesh_t::macbytes_to_string(pop_class->m_op_class_info.id.ruid, mac_str);
-		//printf("%s:%d: MAC: %s\tType: %d\tClass: %d\n", __func__, __LINE__, 
-				//mac_str, pop_class->m_op_class_info.id.type, pop_class->m_op_class_info.id.op_class);
-		if ((memcmp(pop_class->m_op_class_info.id.ruid, id.ruid, sizeof(mac_address_t)) == 0) && 
-					(pop_class->m_op_class_info.id.type == id.type) &&
-					(pop_class->m_op_class_info.id.op_class == id.op_class)) {
-			//printf("%s:%d: Found match\n\n\n", __func__, __LINE__);
-			return pop_class;
-		}	
+	if (dm->find_op_class(id.ruid, id.type, id.op_class, &i) == NULL) {
+		return NULL;
 	}
 
-	//printf("%s:%d: Match not found\n\n\n", __func__, __LINE__);
-	return NULL;
+	return &dm->m_op_class[i];
 }
 
 dm_op_class_t *dm_easy_mesh_list_t::get_first_pre_set_op_class_by_type(em_op_class_type_t type)
@@ -1073,72 +1102,31 @@ void dm_easy_mesh_list_t::put_op_class(const char *key, const dm_op_class_t *op_
     }
 
     // now check if the op class is already there
-    for (i = 0; i < dm->get_num_op_class(); i++) {
-        pop_class = &dm->m_op_class[i];
-        if ((memcmp(pop_class->m_op_class_info.id.ruid, op_class->m_op_class_info.id.ruid, sizeof(mac_address_t)) == 0) &&
-					(pop_class->m_op_class_info.id.type == op_class->m_op_class_info.id.type) &&
-					(pop_class->m_op_class_info.id.op_class == op_class->m_op_class_info.id.op_class)) {
-        	memcpy(&pop_class->m_op_class_info, &op_class->m_op_class_info, sizeof(em_op_class_info_t));
-        	return;
-        }
+    if (dm->find_op_class(op_class->m_op_class_info.id.ruid, op_class->m_op_class_info.id.type,
+            op_class->m_op_class_info.id.op_class, &i) != NULL) {
+        memcpy(&dm->m_op_class[i].m_op_class_info, &op_class->m_op_class_info, sizeof(em_op_class_info_t));
+        dm->index_op_class(i);
+        return;
     }
 
-    pop_class = &dm->m_op_class[dm->get_num_op_class()];
+    if ((i = dm->get_num_op_class()) >= EM_MAX_OPCLASS) {
+        em_printfout("no room for op class of mac address:%s id.type:%d", mac_str, id.type);
+        return;
+    }
+    pop_class = &dm->m_op_class[i];
     memcpy(&pop_class->m_op_class_info, &op_class->m_op_class_info, sizeof(em_op_class_info_t));
-	dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *> (pop_class->m_op_class_info.id.ruid), mac_str);
-	//printf("%s:%d: ruid: %s, type: %d, op_class: %d\n", __func__, __LINE__, 
-		//mac_str, pop_class->m_op_class_info.id.type, pop_class->m_op_class_info.id.op_class);
-    dm->set_num_op_class(dm->get_num_op_class() + 1);
-	//printf("%s:%d: Number of op classes: %d\n", __func__, __LINE__, dm->get_num_op_class());
+    dm->set_num_op_class(i + 1);
+    dm->index_op_class(i);
 }
 
 dm_policy_t *dm_easy_mesh_list_t::get_first_policy()
 {
-	dm_easy_mesh_t *dm;
-
-	dm = static_cast<dm_easy_mesh_t *> (hash_map_get_first(m_list));
-    while (dm != NULL) {
-		if (dm->m_num_policy > 0) {
-			return &dm->m_policy[0];
-		}	
-
-        dm = static_cast<dm_easy_mesh_t *> (hash_map_get_next(m_list, dm));
-    }
-
-	return NULL;
+    return static_cast<dm_policy_t *> (m_walk[dm_list_walk_policy].first());
 }
 
 dm_policy_t *dm_easy_mesh_list_t::get_next_policy(dm_policy_t *policy)
 {
-	dm_easy_mesh_t *dm;
-	bool return_next = false;
-	unsigned int i;
-
-	dm = static_cast<dm_easy_mesh_t *> (hash_map_get_first(m_list));
-    while (dm != NULL) {
-		if (dm->m_num_policy == 0) {
-			dm = static_cast<dm_easy_mesh_t *> (hash_map_get_next(m_list, dm));
-			continue;		
-		}
-
-		if (return_next == true) {
-			return &dm->m_policy[0];
-		}
-
-		for (i = 0; i < dm->m_num_policy; i++) {
-			if (policy == &dm->m_policy[i]) {
-				return_next = true;
-				break;
-			}
-		}
-
-		if ((return_next == true) && ((i + 1) < dm->m_num_policy)) {
-			return &dm->m_policy[i + 1];
-		}
-	
-        dm = static_cast<dm_easy_mesh_t *> (hash_map_get_next(m_list, dm));
-    }
-	return NULL;
+    return static_cast<dm_policy_t *> (get_walk_next(dm_list_walk_policy, policy));
 }
 
 dm_policy_t *dm_easy_mesh_list_t::get_policy(const char *key)
@@ -1198,68 +1186,32 @@ void dm_easy_mesh_list_t::put_policy(const char *key, const dm_policy_t *policy)
 
 dm_scan_result_t *dm_easy_mesh_list_t::get_first_scan_result()
 {
-	dm_easy_mesh_t *dm;
-	dm_scan_result_t *res;
-
-    dm = static_cast<dm_easy_mesh_t *> (hash_map_get_first(m_list));
-    while (dm != NULL) {
-		res = static_cast<dm_scan_result_t *> (hash_map_get_first(dm->m_scan_result_map));
-		if (res != NULL) {
-			return res;
-		}
-		
-		dm = static_cast<dm_easy_mesh_t *> (hash_map_get_next(m_list, dm));
-	}
-
-	return NULL;
+    return static_cast<dm_scan_result_t *> (m_walk[dm_list_walk_scan_result].first());
 }
 
 dm_scan_result_t *dm_easy_mesh_list_t::get_next_scan_result(dm_scan_result_t *scan_result)
 {
-    dm_easy_mesh_t *dm;
-	dm_scan_result_t *res;
-    bool return_next = false;
-
-    dm = static_cast<dm_easy_mesh_t *> (hash_map_get_first(m_list));
-    while (dm != NULL) {
-		res = static_cast<dm_scan_result_t *> (hash_map_get_first(dm->m_scan_result_map));
-		while (res != NULL) {
-			if (return_next == true) {
-				return res;
-			}
-			if (res == scan_result) {
-				return_next = true;
-			}
-			res = static_cast<dm_scan_result_t *> (hash_map_get_next(dm->m_scan_result_map, res));
-		}
-
-        dm = static_cast<dm_easy_mesh_t *> (hash_map_get_next(m_list, dm));
-    }
-    return NULL;
-
+    return static_cast<dm_scan_result_t *> (get_walk_next(dm_list_walk_scan_result, scan_result));
 }
 
 dm_scan_result_t *dm_easy_mesh_list_t::get_scan_result(const char *key)
 {
 	em_scan_result_id_t	id;
 	dm_easy_mesh_t	*dm;
-	mac_addr_str_t	dev_mac_str, scanner_mac_str;
+	mac_addr_str_t	dev_mac_str;
 	dm_scan_result_t *res;
-	em_2xlong_string_t list_key;
+	dm_map_key_t list_key;
 	
 	dm_scan_result_t::parse_scan_result_id_from_key(key, &id);
-	dm_easy_mesh_t::macbytes_to_string(id.dev_mac, dev_mac_str);
-	dm_easy_mesh_t::macbytes_to_string(id.scanner_mac, scanner_mac_str);	
 	
 	if ((dm = get_data_model(id.net_id, id.dev_mac)) == NULL) {
+		dm_easy_mesh_t::macbytes_to_string(id.dev_mac, dev_mac_str);
 		printf("%s:%d: Could not find data model for Network: %s and dev: %s\n", __func__, __LINE__, id.net_id, dev_mac_str);
 		return NULL;
 	} 
 
-	snprintf(list_key, sizeof(em_2xlong_string_t), "%s@%s@%s@%d@%d@%d", id.net_id, dev_mac_str, scanner_mac_str,
-		id.op_class, id.channel, id.scanner_type);	
-
-	res = static_cast<dm_scan_result_t *> (hash_map_get(dm->m_scan_result_map, list_key));
+	dm_key_map_t::scan_result_key(&list_key, &id);
+	res = static_cast<dm_scan_result_t *> (dm->m_scan_result_map->get(&list_key));
 
 	return res;
 }
@@ -1267,32 +1219,27 @@ dm_scan_result_t *dm_easy_mesh_list_t::get_scan_result(const char *key)
 void dm_easy_mesh_list_t::remove_scan_result(const char *key)
 {
     em_scan_result_id_t id;
-    mac_addr_str_t	dev_mac_str, scanner_mac_str, bssid_str;
+    mac_addr_str_t	dev_mac_str;
     bssid_t bssid;
     dm_easy_mesh_t *dm;
     dm_scan_result_t *res;
     dm_sta_t *sta;
     int i;
     int index_to_remove = -1;
-    em_2xlong_string_t list_key;
+    dm_map_key_t list_key;
     bool found_sta = false;
     wifi_BeaconReport_t *rprt;
 
     dm_scan_result_t::parse_scan_result_id_from_key(key, &id, bssid);
 
-    dm_easy_mesh_t::macbytes_to_string(id.dev_mac, dev_mac_str);
-    dm_easy_mesh_t::macbytes_to_string(id.scanner_mac, scanner_mac_str);
-    dm_easy_mesh_t::macbytes_to_string(bssid, bssid_str);
-
     if ((dm = get_data_model(id.net_id, id.dev_mac)) == NULL) {
+        dm_easy_mesh_t::macbytes_to_string(id.dev_mac, dev_mac_str);
         printf("%s:%d: Could not find data model for Network: %s and dev: %s\n", __func__, __LINE__, id.net_id, dev_mac_str);
         return;
     }
 
-    snprintf(list_key, sizeof(em_2xlong_string_t), "%s@%s@%s@%d@%d@%d", id.net_id, dev_mac_str, scanner_mac_str,
-        id.op_class, id.channel, id.scanner_type);
-
-    if ((res = static_cast<dm_scan_result_t *> (hash_map_remove(dm->m_scan_result_map, list_key))) != NULL) {
+    dm_key_map_t::scan_result_key(&list_key, &id);
+    if ((res = static_cast<dm_scan_result_t *> (dm->m_scan_result_map->remove(&list_key))) != NULL) {
         delete res;
     }
 
@@ -1301,13 +1248,13 @@ void dm_easy_mesh_list_t::remove_scan_result(const char *key)
         return;
     }
 
-    sta = static_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_map));
+    sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_first());
         while (sta != NULL) {
             if (memcmp(sta->m_sta_info.id, id.scanner_mac, sizeof(mac_address_t)) == 0) {
                 found_sta = true;
                 break;
             }
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_map, sta));
+        sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
     }
 
     if (found_sta == false) {
@@ -1339,61 +1286,40 @@ void dm_easy_mesh_list_t::put_scan_result(const char *key, const dm_scan_result_
 {
 	em_scan_result_id_t	id;
 	dm_easy_mesh_t	*dm;
-	mac_addr_str_t	dev_mac_str, scanner_mac_str;
+	mac_addr_str_t	dev_mac_str;
 	dm_scan_result_t *res;
 	dm_sta_t *sta;
 	bssid_t bssid;
-	bool found_neighbor = false, found_sta = false;
-	unsigned int i;
-	em_neighbor_t *nbr;
-	em_2xlong_string_t list_key;
+	bool found_sta = false;
+	dm_map_key_t list_key;
 	wifi_BeaconReport_t *rprt;
 	
 	dm_scan_result_t::parse_scan_result_id_from_key(key, &id, bssid);
 
-	dm_easy_mesh_t::macbytes_to_string(id.dev_mac, dev_mac_str);
-	dm_easy_mesh_t::macbytes_to_string(id.scanner_mac, scanner_mac_str);
-
 	if ((dm = get_data_model(id.net_id, id.dev_mac)) == NULL) {
+		dm_easy_mesh_t::macbytes_to_string(id.dev_mac, dev_mac_str);
 		printf("%s:%d: Could not find data model for Network: %s and dev: %s\n", __func__, __LINE__, id.net_id, dev_mac_str);
 		return;
 	}
 		
-	snprintf(list_key, sizeof(em_2xlong_string_t), "%s@%s@%s@%d@%d@%d", id.net_id, dev_mac_str, scanner_mac_str, 
-    							id.op_class, id.channel, id.scanner_type);
-
-	if ((res = static_cast<dm_scan_result_t *> (hash_map_get(dm->m_scan_result_map, list_key))) == NULL) {
+	dm_key_map_t::scan_result_key(&list_key, &id);
+	if ((res = static_cast<dm_scan_result_t *> (dm->m_scan_result_map->get(&list_key))) == NULL) {
 		//printf("%s:%d: New Scan Result\tnetwork: %s\tdevice: %s\tradio: %s\topclass: %d\tchannel: %d\tScanner Type: %d\n", 
 				//__func__, __LINE__, id.net_id, dev_mac_str, scanner_mac_str, id.op_class, id.channel, id.scanner_type);	
-		res = new dm_scan_result_t();
-		
-		hash_map_put(dm->m_scan_result_map, strdup(list_key), res);
-
-		memcpy(&res->m_scan_result, &scan_result->m_scan_result, sizeof(em_scan_result_t));
+		res = new dm_scan_result_t(scan_result->m_scan_result);
 		
-		// increase the neighbors by 1
-		res->m_scan_result.num_neighbors++;		
-	} else {
-		//printf("%s:%d: Existing Scan Result\tnetwork: %s\tdevice: %s\tradio: %s\topclass: %d\tchannel: %d\tScanner Type: %d\n", 
-				//__func__, __LINE__, id.net_id, dev_mac_str, scanner_mac_str, id.op_class, id.channel, id.scanner_type);	
-		for (i = 0; i < res->m_scan_result.num_neighbors; i++) {
-			nbr = &res->m_scan_result.neighbor[i];
+		dm->m_scan_result_map->put(&list_key, res);
 
-			if (memcmp(nbr->bssid, bssid, sizeof(mac_address_t)) == 0) {
-				found_neighbor = true;
-				memcpy(nbr, &scan_result->m_scan_result.neighbor[index], sizeof(em_neighbor_t));
-				break;
-			}
-		}
+		// the neighbors come one key at a time
+		res->m_scan_result.num_neighbors = 0;
+		res->reindex_neighbors();
+	}
+	res->touch();
 
-		if (found_neighbor == false) {
-			if (res->m_scan_result.num_neighbors >= EM_MAX_NEIGHBORS) {
-				return;
-			}
-			nbr = &res->m_scan_result.neighbor[res->m_scan_result.num_neighbors];
-			memcpy(nbr, &scan_result->m_scan_result.neighbor[index], sizeof(em_neighbor_t));
-			res->m_scan_result.num_neighbors++;
-		}
+	// O(1) through the BSSID index of the result, whether the neighbor is new or an update
+	if ((index < scan_result->m_scan_result.num_neighbors) &&
+			(res->put_neighbor(&scan_result->m_scan_result.neighbor[index]) != 0)) {
+		return;
 	}
 
 	// now if the result is from sta beacon report, find the sta and populate the structure
@@ -1401,14 +1327,14 @@ void dm_easy_mesh_list_t::put_scan_result(const char *key, const dm_scan_result_
 		return;
 	} 
 
-	sta = static_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_map));
+	sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_first());
 	while (sta != NULL) {
 
 		if (memcmp(sta->m_sta_info.id, id.scanner_mac, sizeof(mac_address_t)) == 0) {
 			found_sta = true;
 			break;
 		}
-		sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_map, sta));
+		sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
 	}		
 
 	if (found_sta == false) {
@@ -1445,14 +1371,17 @@ void dm_easy_mesh_list_t::delete_all_data_models()
 		snprintf(key, sizeof(em_2xlong_string_t), "%s@%s", dev->m_device_info.id.net_id, mac_str);
 
 		hash_map_remove(m_list, key);
-		delete tmp;
+		forget_data_model(tmp);
+		free_data_model(tmp);
     }   
 
+    purge_retired(true, 0);
 }
 
 void dm_easy_mesh_list_t::delete_data_model(const char *net_id, const unsigned char *al_mac)
 {
     dm_easy_mesh_t *dm = NULL;
+    uint64_t dm_key;
     mac_addr_str_t mac_str;
     em_long_string_t	key;
 	
@@ -1461,20 +1390,26 @@ void dm_easy_mesh_list_t::delete_data_model(const char *net_id, const unsigned c
     //printf("%s:%d: Putting data model at key: %s\n", __func__, __LINE__, key);
 
     dm = static_cast<dm_easy_mesh_t *> (hash_map_remove(m_list, key));
+    if (dm == NULL) {
+        return;
+    }
+    forget_data_model(dm);
 
     //printf("%s:%d: deleteing data model at key: %s, dm:%p, colocated:%d\n", __func__, __LINE__, key, dm, dm->get_colocated());
-    dm->deinit();
-    delete dm;
+    if ((dm->get_colocated() == false) && (get_dm_key(net_id, al_mac, &dm_key, false) == true)) {
+        retire_data_model(dm_key, dm, get_now_ms());
+    } else {
+        free_data_model(dm);
+    }
 }
 
 dm_easy_mesh_t *dm_easy_mesh_list_t::create_data_model(const char *net_id, const em_interface_t *al_intf, em_profile_type_t profile, bool colocated)
 {
-    dm_easy_mesh_t *dm = NULL, *ref_dm;
+    dm_easy_mesh_t *dm = NULL;
     mac_addr_str_t mac_str;
     em_short_string_t	key;
-    dm_network_t *net, *pnet;
+    uint64_t dm_key;
     dm_device_t *dev;
-    dm_network_ssid_t *net_ssid, *pnet_ssid;
 	const em_policy_t	em_policy[] = {
 						{{"OneWifiMesh", {0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
 							em_policy_id_type_ap_metrics_rep}, 0, {}, em_steering_policy_type_unknown, 
@@ -1535,6 +1470,19 @@ dm_easy_mesh_t *dm_easy_mesh_list_t::create_data_model(const char *net_id, const
     dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *> (al_intf->mac), mac_str);
     snprintf(key, sizeof(em_short_string_t), "%s@%s", net_id, mac_str);
 
+    // an agent that flapped gets back the data model it had, without building a new one
+    if ((colocated == false) && (get_dm_key(net_id, al_intf->mac, &dm_key, false) == true) &&
+            ((dm = revive_data_model(dm_key, get_now_ms())) != NULL)) {
+        em_printfout("Reusing data model for net_id: %s mac: %s", net_id, mac_str);
+        dm->get_device()->m_device_info.profile = profile;
+        copy_network(dm, net_id);
+        hash_map_put(m_list, strdup(key), dm);
+        m_dm_keys[dm_key] = dm;
+        m_dm_ids.clear();
+        m_generation = dm_easy_mesh_t::next_generation();
+        return dm;
+    }
+
     dm = new dm_easy_mesh_t();
     dm->init();
     em_printfout("Created data model for net_id: %s mac: %s, coloc:%d", net_id, mac_str, colocated);
@@ -1567,38 +1515,174 @@ dm_easy_mesh_t *dm_easy_mesh_list_t::create_data_model(const char *net_id, const
 
 	em_printfout("Number of policies: %d", dm->get_num_policy());
 
+    copy_network(dm, net_id);
+    em_printfout("Putting data model at key: %s", key);
+    hash_map_put(m_list, strdup(key), dm);
+    if (get_dm_key(net_id, al_intf->mac, &dm_key, true) == true) {
+        m_dm_keys[dm_key] = dm;
+    }
+    m_dm_ids.clear();
+    m_generation = dm_easy_mesh_t::next_generation();
+
+    return dm;
+}
+
+void dm_easy_mesh_list_t::copy_network(dm_easy_mesh_t *dm, const char *net_id)
+{
+    dm_easy_mesh_t *ref_dm;
+    dm_network_t *net, *pnet;
+    dm_network_ssid_t *net_ssid, *pnet_ssid;
+    unsigned int i;
+
     // is this the first data model
-    if ((net = get_network(net_id)) != NULL) {
-        pnet = dm->get_network();
-        *pnet = *net;
+    if ((net = get_network(net_id)) == NULL) {
+        return;
+    }
 
-        ref_dm = get_data_model(net->m_net_info.id, net->m_net_info.colocated_agent_id.mac);
-        assert(ref_dm != NULL);
-        dm->set_num_network_ssid(ref_dm->get_num_network_ssid());
-        //printf("%s:%d: Number of network ssid in reference data model: %d\n", __func__, __LINE__, ref_dm->get_num_network_ssid());
-        for (i = 0; i < ref_dm->get_num_network_ssid(); i++) {
-            pnet_ssid = dm->get_network_ssid(i);
-            net_ssid = ref_dm->get_network_ssid(i);
-            *pnet_ssid = *net_ssid;
+    pnet = dm->get_network();
+    *pnet = *net;
+
+    ref_dm = get_data_model(net->m_net_info.id, net->m_net_info.colocated_agent_id.mac);
+    assert(ref_dm != NULL);
+    dm->set_num_network_ssid(ref_dm->get_num_network_ssid());
+    //printf("%s:%d: Number of network ssid in reference data model: %d\n", __func__, __LINE__, ref_dm->get_num_network_ssid());
+    for (i = 0; i < ref_dm->get_num_network_ssid(); i++) {
+        pnet_ssid = dm->get_network_ssid(i);
+        net_ssid = ref_dm->get_network_ssid(i);
+        *pnet_ssid = *net_ssid;
+    }
+}
+
+unsigned long long dm_easy_mesh_list_t::get_now_ms()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<unsigned long long> (ts.tv_sec) * 1000ULL + static_cast<unsigned long long> (ts.tv_nsec) / 1000000ULL;
+}
+
+void dm_easy_mesh_list_t::free_data_model(dm_easy_mesh_t *dm)
+{
+    if (dm == NULL) {
+        return;
+    }
+
+    // the key maps free their storage in one go, the data model arrays go with it
+    dm->deinit();
+    delete dm;
+}
+
+void dm_easy_mesh_list_t::retire_data_model(uint64_t key, dm_easy_mesh_t *dm, unsigned long long now)
+{
+    std::unordered_map<uint64_t, dm_retired_t>::iterator it, oldest;
+
+    purge_retired(false, now);
+
+    if ((it = m_retired.find(key)) != m_retired.end()) {
+        free_data_model(it->second.dm);
+        m_retired.erase(it);
+    }
+
+    if (m_retired.size() >= DM_LIST_MAX_RETIRED) {
+        oldest = m_retired.begin();
+        for (it = m_retired.begin(); it != m_retired.end(); it++) {
+            if (it->second.removed_ms < oldest->second.removed_ms) {
+                oldest = it;
+            }
         }
+        free_data_model(oldest->second.dm);
+        m_retired.erase(oldest);
     }
-    em_printfout("Putting data model at key: %s", key);
-    hash_map_put(m_list, strdup(key), dm);
+
+    m_retired[key] = {dm, now};
+}
+
+dm_easy_mesh_t *dm_easy_mesh_list_t::revive_data_model(uint64_t key, unsigned long long now)
+{
+    std::unordered_map<uint64_t, dm_retired_t>::iterator it;
+    dm_easy_mesh_t *dm;
+
+    purge_retired(false, now);
+
+    if ((it = m_retired.find(key)) == m_retired.end()) {
+        return NULL;
+    }
+
+    dm = it->second.dm;
+    m_retired.erase(it);
+
+    // the removal deleted the rows of the device, they are written again from the model
+    dm->reset_db_cfg_type(db_cfg_type_device_list_delete);
+    dm->reset_db_cfg_type(db_cfg_type_radio_list_delete);
+    dm->reset_db_cfg_type(db_cfg_type_bss_list_delete);
+    dm->reset_db_cfg_type(db_cfg_type_op_class_list_delete);
+    dm->set_db_cfg_param(db_cfg_type_device_list_update, "");
+    dm->set_db_cfg_param(db_cfg_type_radio_list_update, "");
+    dm->set_db_cfg_param(db_cfg_type_bss_list_update, "");
+    dm->set_db_cfg_param(db_cfg_type_op_class_list_update, "");
 
     return dm;
 }
 
+void dm_easy_mesh_list_t::purge_retired(bool all, unsigned long long now)
+{
+    std::unordered_map<uint64_t, dm_retired_t>::iterator it;
+
+    for (it = m_retired.begin(); it != m_retired.end(); ) {
+        if ((all == true) || ((now - it->second.removed_ms) >= DM_LIST_REONBOARD_GRACE_MS)) {
+            free_data_model(it->second.dm);
+            it = m_retired.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+bool dm_easy_mesh_list_t::get_dm_key(const char *net_id, const unsigned char *al_mac, uint64_t *key, bool add)
+{
+    em_intern_t *table = em_intern_t::get_table();
+    em_intern_id_t net;
+    unsigned int i;
+
+    net = (add == true) ? table->intern(net_id, sizeof(em_long_string_t)):table->find(net_id, sizeof(em_long_string_t));
+    if (net == EM_INTERN_NONE) {
+        return false;
+    }
+
+    *key = net;
+    for (i = 0; i < sizeof(mac_address_t); i++) {
+        *key = (*key << 8) | al_mac[i];
+    }
+
+    return true;
+}
+
 dm_easy_mesh_t *dm_easy_mesh_list_t::get_data_model(const char *net_id, const unsigned char *al_mac)
 {
-    dm_easy_mesh_t *dm = NULL;
-    mac_addr_str_t mac_str;
-    em_2xlong_string_t	key;
+    // the lookups made while handling one frame are mostly for the same device
+    static thread_local struct {
+        const dm_easy_mesh_list_t *list;
+        unsigned int generation;
+        uint64_t key;
+        dm_easy_mesh_t *dm;
+    } s_last = {NULL, 0, 0, NULL};
+    uint64_t key;
+
+    if ((net_id == NULL) || (al_mac == NULL) || (get_dm_key(net_id, al_mac, &key, false) == false)) {
+        return NULL;
+    }
 
-    dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *> (al_mac), mac_str);
-    snprintf(key, sizeof(key), "%s@%s", net_id, mac_str);
-    dm = static_cast<dm_easy_mesh_t *> (hash_map_get(m_list, key));
+    if ((s_last.list == this) && (s_last.generation == m_generation) && (s_last.key == key)) {
+        return s_last.dm;
+    }
 
-    return dm;
+    auto it = m_dm_keys.find(key);
+    s_last.list = this;
+    s_last.generation = m_generation;
+    s_last.key = key;
+    s_last.dm = (it == m_dm_keys.end()) ? NULL:it->second;
+
+    return s_last.dm;
 }
 
 void dm_easy_mesh_list_t::init(em_mgr_t *mgr)
@@ -1610,10 +1694,14 @@ void dm_easy_mesh_list_t::init(em_mgr_t *mgr)
 
 dm_easy_mesh_list_t::dm_easy_mesh_list_t()
 {
+    unsigned int i;
 
+    for (i = 0; i < dm_list_walk_max; i++) {
+        m_walk[i] = dm_list_cursor_t(this, static_cast<dm_list_walk_t> (i));
+    }
 }
 
 dm_easy_mesh_list_t::~dm_easy_mesh_list_t()
 {
-
+    purge_retired(true, 0);
 }
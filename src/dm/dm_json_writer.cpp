@@ -0,0 +1,329 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <limits.h>
+#include "dm_json_writer.h"
+
+void dm_json_writer_t::put(const char *data, size_t len)
+{
+    size_t cap;
+    char *tmp;
+
+    if (m_error == true) {
+        return;
+    }
+
+    if ((m_sink != NULL) && (m_len + len > DM_JSON_WRITER_FLUSH_LEN)) {
+        if (flush() != 0) {
+            return;
+        }
+        // larger than the whole buffer, no point in copying it
+        if (len > DM_JSON_WRITER_FLUSH_LEN) {
+            if (m_sink(m_sink_arg, data, len) != 0) {
+                m_error = true;
+            }
+            return;
+        }
+    }
+
+    // one more byte for the terminating NUL
+    if (m_len + len + 1 > m_cap) {
+        cap = (m_cap == 0) ? 256:m_cap;
+        while (m_len + len + 1 > cap) {
+            cap *= 2;
+        }
+        if ((tmp = static_cast<char *>(realloc(m_buff, cap))) == NULL) {
+            printf("%s:%d: Failed to grow the buffer to %zu bytes\n", __func__, __LINE__, cap);
+            m_error = true;
+            return;
+        }
+        m_buff = tmp;
+        m_cap = cap;
+    }
+
+    memcpy(m_buff + m_len, data, len);
+    m_len += len;
+    m_buff[m_len] = '\0';
+}
+
+void dm_json_writer_t::put_string(const char *str)
+{
+    const char *run;
+    char esc[8];
+
+    put("\"", 1);
+    for (run = str; (str != NULL) && (*str != '\0'); str++) {
+        if ((static_cast<unsigned char>(*str) >= 0x20) && (*str != '"') && (*str != '\\')) {
+            continue;
+        }
+        put(run, static_cast<size_t>(str - run));
+        run = str + 1;
+        switch (*str) {
+            case '"':   put("\\\"", 2); break;
+            case '\\':  put("\\\\", 2); break;
+            case '\b':  put("\\b", 2); break;
+            case '\f':  put("\\f", 2); break;
+            case '\n':  put("\\n", 2); break;
+            case '\r':  put("\\r", 2); break;
+            case '\t':  put("\\t", 2); break;
+            default:
+                snprintf(esc, sizeof(esc), "\\u%04x", static_cast<unsigned char>(*str));
+                put(esc, 6);
+                break;
+        }
+    }
+    if (str != NULL) {
+        put(run, static_cast<size_t>(str - run));
+    }
+    put("\"", 1);
+}
+
+int dm_json_writer_t::open_value(const char *key)
+{
+    if (m_depth == 0) {
+        m_error = true;
+        return -1;
+    }
+
+    if (m_is_array[m_depth - 1] == false) {
+        if (key == NULL) {
+            m_error = true;
+            return -1;
+        }
+        if (m_has_rows[m_depth - 1] == true) {
+            put(",", 1);
+        }
+        put_string(key);
+        put(":", 1);
+    } else if (m_has_rows[m_depth - 1] == true) {
+        put(",", 1);
+    }
+    m_has_rows[m_depth - 1] = true;
+
+    return (m_error == true) ? -1:0;
+}
+
+cJSON *dm_json_writer_t::add_item(const char *key, cJSON *item)
+{
+    cJSON *parent = m_tree[m_depth - 1];
+
+    if ((item == NULL) || (parent == NULL) || ((m_is_array[m_depth - 1] == false) && (key == NULL))) {
+        cJSON_Delete(item);
+        m_error = true;
+        return NULL;
+    }
+
+    if (m_is_array[m_depth - 1] == true) {
+        cJSON_AddItemToArray(parent, item);
+    } else {
+        cJSON_AddItemToObject(parent, key, item);
+    }
+
+    return item;
+}
+
+int dm_json_writer_t::begin(const char *key, bool is_array)
+{
+    cJSON *item;
+
+    if (m_depth == DM_JSON_WRITER_MAX_DEPTH) {
+        m_error = true;
+        return -1;
+    }
+
+    if (m_is_tree == true) {
+        if ((item = add_item(key, is_array ? cJSON_CreateArray():cJSON_CreateObject())) == NULL) {
+            return -1;
+        }
+        m_tree[m_depth] = item;
+    } else {
+        if ((m_depth > 0) && (open_value(key) != 0)) {
+            return -1;
+        }
+        put(is_array ? "[":"{", 1);
+    }
+
+    m_is_array[m_depth] = is_array;
+    m_has_rows[m_depth] = false;
+    m_depth++;
+
+    return (m_error == true) ? -1:0;
+}
+
+int dm_json_writer_t::end(bool is_array)
+{
+    // the container of a tree writer is not the writer's to close
+    if ((m_depth <= (m_is_tree ? 1u:0u)) || (m_is_array[m_depth - 1] != is_array)) {
+        m_error = true;
+        return -1;
+    }
+
+    m_depth--;
+    if (m_is_tree == false) {
+        put(is_array ? "]":"}", 1);
+    }
+
+    return (m_error == true) ? -1:0;
+}
+
+void dm_json_writer_t::add_string(const char *key, const char *val)
+{
+    if (m_is_tree == true) {
+        add_item(key, cJSON_CreateString(val));
+    } else if (open_value(key) == 0) {
+        put_string(val);
+    }
+}
+
+void dm_json_writer_t::add_number(const char *key, double val)
+{
+    char num[32];
+    double test = 0;
+    int n;
+
+    if (m_is_tree == true) {
+        add_item(key, cJSON_CreateNumber(val));
+        return;
+    }
+
+    if (open_value(key) != 0) {
+        return;
+    }
+
+    // same text as cJSON: integers that fit an int as such, otherwise the shortest of 15 or 17 digits
+    if (isnan(val) || isinf(val)) {
+        n = snprintf(num, sizeof(num), "null");
+    } else if ((val >= INT_MIN) && (val <= INT_MAX) && (val == static_cast<double>(static_cast<int>(val)))) {
+        n = snprintf(num, sizeof(num), "%d", static_cast<int>(val));
+    } else {
+        n = snprintf(num, sizeof(num), "%1.15g", val);
+        if ((sscanf(num, "%lg", &test) != 1) || (fabs(test - val) > fmax(fabs(test), fabs(val)) * DBL_EPSILON)) {
+            n = snprintf(num, sizeof(num), "%1.17g", val);
+        }
+    }
+    put(num, static_cast<size_t>(n));
+}
+
+void dm_json_writer_t::add_bool(const char *key, bool val)
+{
+    if (m_is_tree == true) {
+        add_item(key, cJSON_CreateBool(val));
+    } else if (open_value(key) == 0) {
+        put(val ? "true":"false", val ? 4:5);
+    }
+}
+
+void dm_json_writer_t::add_raw(const char *key, const char *json)
+{
+    if (m_is_tree == true) {
+        add_item(key, cJSON_CreateRaw(json));
+    } else if (open_value(key) == 0) {
+        put(json, strlen(json));
+    }
+}
+
+void dm_json_writer_t::add_tree(const char *key, const cJSON *item)
+{
+    const cJSON *child;
+    bool is_array;
+
+    if (item == NULL) {
+        m_error = true;
+        return;
+    }
+
+    if (m_is_tree == true) {
+        add_item(key, cJSON_Duplicate(item, true));
+        return;
+    }
+
+    if (cJSON_IsObject(item) || cJSON_IsArray(item)) {
+        is_array = cJSON_IsArray(item);
+        if (begin(key, is_array) != 0) {
+            return;
+        }
+        cJSON_ArrayForEach(child, item) {
+            add_tree(child->string, child);
+        }
+        end(is_array);
+    } else if (cJSON_IsString(item)) {
+        add_string(key, item->valuestring);
+    } else if (cJSON_IsNumber(item)) {
+        add_number(key, item->valuedouble);
+    } else if (cJSON_IsBool(item)) {
+        add_bool(key, cJSON_IsTrue(item));
+    } else if (cJSON_IsRaw(item)) {
+        add_raw(key, item->valuestring);
+    } else if (open_value(key) == 0) {
+        put("null", 4);
+    }
+}
+
+int dm_json_writer_t::flush()
+{
+    if ((m_sink == NULL) || (m_len == 0)) {
+        return (m_error == true) ? -1:0;
+    }
+
+    if ((m_error == false) && (m_sink(m_sink_arg, m_buff, m_len) != 0)) {
+        m_error = true;
+    }
+    m_len = 0;
+    m_buff[0] = '\0';
+
+    return (m_error == true) ? -1:0;
+}
+
+void dm_json_writer_t::reset()
+{
+    m_len = 0;
+    if (m_buff != NULL) {
+        m_buff[0] = '\0';
+    }
+    m_depth = (m_is_tree == true) ? 1:0;
+    m_has_rows[0] = false;
+    m_error = false;
+}
+
+dm_json_writer_t::dm_json_writer_t(): m_buff(NULL), m_len(0), m_cap(0), m_sink(NULL), m_sink_arg(NULL),
+    m_depth(0), m_is_tree(false), m_error(false)
+{
+}
+
+dm_json_writer_t::dm_json_writer_t(dm_json_writer_sink_t sink, void *arg): m_buff(NULL), m_len(0), m_cap(0),
+    m_sink(sink), m_sink_arg(arg), m_depth(0), m_is_tree(false), m_error(false)
+{
+}
+
+dm_json_writer_t::dm_json_writer_t(cJSON *container): m_buff(NULL), m_len(0), m_cap(0), m_sink(NULL),
+    m_sink_arg(NULL), m_depth(1), m_is_tree(true), m_error(false)
+{
+    m_tree[0] = container;
+    m_is_array[0] = cJSON_IsArray(container);
+    m_has_rows[0] = false;
+}
+
+dm_json_writer_t::~dm_json_writer_t()
+{
+    free(m_buff);
+}
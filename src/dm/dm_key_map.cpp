@@ -0,0 +1,393 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "dm_key_map.h"
+
+void dm_key_map_t::sta_key(dm_map_key_t *key, const unsigned char *sta, const unsigned char *bssid, const unsigned char *ruid)
+{
+    memset(key, 0, sizeof(dm_map_key_t));
+    memcpy(key->mac[0], sta, sizeof(mac_address_t));
+    memcpy(key->mac[1], bssid, sizeof(mac_address_t));
+    memcpy(key->mac[2], ruid, sizeof(mac_address_t));
+}
+
+void dm_key_map_t::scan_result_key(dm_map_key_t *key, const em_scan_result_id_t *id)
+{
+    memset(key, 0, sizeof(dm_map_key_t));
+    memcpy(key->mac[0], id->scanner_mac, sizeof(mac_address_t));
+    memcpy(key->mac[1], id->dev_mac, sizeof(mac_address_t));
+    key->op_class = id->op_class;
+    key->channel = id->channel;
+    key->type = static_cast<unsigned char>(id->scanner_type);
+}
+
+unsigned int dm_key_map_t::get_key_home(const dm_map_key_t *key) const
+{
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(key);
+    uint64_t h = 0xcbf29ce484222325ULL, w;
+    unsigned int i;
+
+    // the key is a multiple of 4 bytes, mix it 4 bytes at a time
+    for (i = 0; i < sizeof(dm_map_key_t); i += 4) {
+        w = (static_cast<uint64_t>(p[i]) << 24) | (static_cast<uint64_t>(p[i + 1]) << 16) |
+            (static_cast<uint64_t>(p[i + 2]) << 8) | p[i + 3];
+        h = (h ^ w) * 0x9e3779b97f4a7c15ULL;
+    }
+
+    return static_cast<unsigned int>(h >> 32) & ((m_size * 2) - 1);
+}
+
+unsigned int dm_key_map_t::get_val_home(const void *val) const
+{
+    uint64_t h = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(val)) * 0x9e3779b97f4a7c15ULL;
+
+    return static_cast<unsigned int>(h >> 32) & ((m_size * 2) - 1);
+}
+
+unsigned int dm_key_map_t::find_key(const dm_map_key_t *key) const
+{
+    unsigned int mask = (m_size * 2) - 1, slot;
+
+    if (m_size == 0) {
+        return DM_KEY_MAP_NONE;
+    }
+
+    for (slot = get_key_home(key); m_by_key[slot] != 0; slot = (slot + 1) & mask) {
+        if (memcmp(&m_entries[m_by_key[slot] - 1].key, key, sizeof(dm_map_key_t)) == 0) {
+            return slot;
+        }
+    }
+
+    return DM_KEY_MAP_NONE;
+}
+
+unsigned int dm_key_map_t::find_val(unsigned int idx) const
+{
+    unsigned int mask = (m_size * 2) - 1, slot;
+
+    for (slot = get_val_home(m_entries[idx].val); m_by_val[slot] != 0; slot = (slot + 1) & mask) {
+        if (m_by_val[slot] == idx + 1) {
+            return slot;
+        }
+    }
+
+    return DM_KEY_MAP_NONE;
+}
+
+void dm_key_map_t::index_entry(unsigned int idx)
+{
+    unsigned int mask = (m_size * 2) - 1, slot;
+
+    for (slot = get_key_home(&m_entries[idx].key); m_by_key[slot] != 0; slot = (slot + 1) & mask);
+    m_by_key[slot] = idx + 1;
+
+    for (slot = get_val_home(m_entries[idx].val); m_by_val[slot] != 0; slot = (slot + 1) & mask);
+    m_by_val[slot] = idx + 1;
+}
+
+void dm_key_map_t::unindex_slot(unsigned int *table, unsigned int slot, bool by_key)
+{
+    unsigned int mask = (m_size * 2) - 1, next, home;
+    dm_key_map_entry_t *e;
+
+    table[slot] = 0;
+
+    // move back every slot of the run that may no longer be reachable from its home slot
+    for (next = (slot + 1) & mask; table[next] != 0; next = (next + 1) & mask) {
+        e = &m_entries[table[next] - 1];
+        home = (by_key == true) ? get_key_home(&e->key):get_val_home(e->val);
+        if (((next - home) & mask) >= ((next - slot) & mask)) {
+            table[slot] = table[next];
+            table[next] = 0;
+            slot = next;
+        }
+    }
+}
+
+int dm_key_map_t::unshare()
+{
+    dm_key_map_entry_t *entries;
+    unsigned int *by_key, *by_val;
+
+    if (m_refs == NULL) {
+        return 0;
+    }
+
+    if (m_refs->load() > 1) {
+        entries = static_cast<dm_key_map_entry_t *>(malloc(m_size * sizeof(dm_key_map_entry_t)));
+        by_key = static_cast<unsigned int *>(malloc(m_size * 2 * sizeof(unsigned int)));
+        by_val = static_cast<unsigned int *>(malloc(m_size * 2 * sizeof(unsigned int)));
+        if ((entries == NULL) || (by_key == NULL) || (by_val == NULL)) {
+            printf("%s:%d: Failed to copy %d shared entries\n", __func__, __LINE__, m_size);
+            free(entries);
+            free(by_key);
+            free(by_val);
+            return -1;
+        }
+        memcpy(entries, m_entries, m_size * sizeof(dm_key_map_entry_t));
+        memcpy(by_key, m_by_key, m_size * 2 * sizeof(unsigned int));
+        memcpy(by_val, m_by_val, m_size * 2 * sizeof(unsigned int));
+
+        // let go of the shared storage only once copied, the last map to let go frees it
+        if (m_refs->fetch_sub(1) != 1) {
+            m_entries = entries;
+            m_by_key = by_key;
+            m_by_val = by_val;
+            m_refs = NULL;
+            return 0;
+        }
+
+        // the others let go while copying, the storage is ours alone after all
+        free(entries);
+        free(by_key);
+        free(by_val);
+    }
+
+    delete m_refs;
+    m_refs = NULL;
+
+    return 0;
+}
+
+int dm_key_map_t::grow()
+{
+    unsigned int sz = (m_size == 0) ? DM_KEY_MAP_MIN_SZ:(m_size * 2), i;
+    dm_key_map_entry_t *entries;
+    unsigned int *by_key, *by_val;
+
+    entries = static_cast<dm_key_map_entry_t *>(realloc(m_entries, sz * sizeof(dm_key_map_entry_t)));
+    if (entries == NULL) {
+        printf("%s:%d: Failed to allocate %d entries\n", __func__, __LINE__, sz);
+        return -1;
+    }
+    m_entries = entries;
+
+    by_key = static_cast<unsigned int *>(calloc(sz * 2, sizeof(unsigned int)));
+    by_val = static_cast<unsigned int *>(calloc(sz * 2, sizeof(unsigned int)));
+    if ((by_key == NULL) || (by_val == NULL)) {
+        printf("%s:%d: Failed to allocate index of size:%d\n", __func__, __LINE__, sz * 2);
+        free(by_key);
+        free(by_val);
+        return -1;
+    }
+    free(m_by_key);
+    free(m_by_val);
+    m_by_key = by_key;
+    m_by_val = by_val;
+
+    // the entries keep their index, only the tables are rebuilt
+    for (i = sz; i > m_size; i--) {
+        m_entries[i - 1].val = NULL;
+        m_entries[i - 1].next = m_free;
+        m_free = i - 1;
+    }
+    m_size = sz;
+    for (i = m_head; i != DM_KEY_MAP_NONE; i = m_entries[i].next) {
+        index_entry(i);
+    }
+
+    return 0;
+}
+
+void *dm_key_map_t::put(const dm_map_key_t *key, void *val)
+{
+    unsigned int slot, idx, vslot;
+    void *old;
+
+    if (val == NULL) {
+        return NULL;
+    }
+
+    if ((slot = find_key(key)) != DM_KEY_MAP_NONE) {
+        idx = m_by_key[slot] - 1;
+        if ((old = m_entries[idx].val) == val) {
+            return NULL;
+        }
+        if (unshare() != 0) {
+            return NULL;
+        }
+        vslot = find_val(idx);
+        unindex_slot(m_by_val, vslot, false);
+        m_entries[idx].val = val;
+        for (vslot = get_val_home(val); m_by_val[vslot] != 0; vslot = (vslot + 1) & ((m_size * 2) - 1));
+        m_by_val[vslot] = idx + 1;
+        return old;
+    }
+
+    if ((unshare() != 0) || ((m_free == DM_KEY_MAP_NONE) && (grow() != 0))) {
+        return NULL;
+    }
+
+    idx = m_free;
+    m_free = m_entries[idx].next;
+
+    memcpy(&m_entries[idx].key, key, sizeof(dm_map_key_t));
+    m_entries[idx].val = val;
+    m_entries[idx].next = DM_KEY_MAP_NONE;
+    m_entries[idx].prev = m_tail;
+    if (m_tail != DM_KEY_MAP_NONE) {
+        m_entries[m_tail].next = idx;
+    } else {
+        m_head = idx;
+    }
+    m_tail = idx;
+    m_count++;
+
+    index_entry(idx);
+
+    return NULL;
+}
+
+void *dm_key_map_t::get(const dm_map_key_t *key) const
+{
+    unsigned int slot;
+
+    if ((slot = find_key(key)) == DM_KEY_MAP_NONE) {
+        return NULL;
+    }
+
+    return m_entries[m_by_key[slot] - 1].val;
+}
+
+void *dm_key_map_t::remove(const dm_map_key_t *key)
+{
+    unsigned int slot, idx;
+    dm_key_map_entry_t *e;
+    void *val;
+
+    if (((slot = find_key(key)) == DM_KEY_MAP_NONE) || (unshare() != 0)) {
+        return NULL;
+    }
+
+    idx = m_by_key[slot] - 1;
+    e = &m_entries[idx];
+    unindex_slot(m_by_key, slot, true);
+    unindex_slot(m_by_val, find_val(idx), false);
+
+    if (e->prev != DM_KEY_MAP_NONE) {
+        m_entries[e->prev].next = e->next;
+    } else {
+        m_head = e->next;
+    }
+    if (e->next != DM_KEY_MAP_NONE) {
+        m_entries[e->next].prev = e->prev;
+    } else {
+        m_tail = e->prev;
+    }
+
+    val = e->val;
+    e->val = NULL;
+    e->next = m_free;
+    m_free = idx;
+    m_count--;
+
+    return val;
+}
+
+void *dm_key_map_t::get_first() const
+{
+    return (m_head == DM_KEY_MAP_NONE) ? NULL:m_entries[m_head].val;
+}
+
+void *dm_key_map_t::get_next(const void *val) const
+{
+    unsigned int mask = (m_size * 2) - 1, slot, next;
+
+    if ((m_size == 0) || (val == NULL)) {
+        return NULL;
+    }
+
+    for (slot = get_val_home(val); m_by_val[slot] != 0; slot = (slot + 1) & mask) {
+        if (m_entries[m_by_val[slot] - 1].val == val) {
+            next = m_entries[m_by_val[slot] - 1].next;
+            return (next == DM_KEY_MAP_NONE) ? NULL:m_entries[next].val;
+        }
+    }
+
+    return NULL;
+}
+
+int dm_key_map_t::copy_from(dm_key_map_t& src)
+{
+    unsigned int i;
+
+    if ((&src == this) || (src.m_count == 0)) {
+        return 0;
+    }
+
+    if (m_count != 0) {
+        for (i = src.m_head; i != DM_KEY_MAP_NONE; i = src.m_entries[i].next) {
+            put(&src.m_entries[i].key, src.m_entries[i].val);
+            if (get(&src.m_entries[i].key) != src.m_entries[i].val) {
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    clear();
+    if (src.m_refs == NULL) {
+        src.m_refs = new std::atomic<unsigned int>(1);
+    }
+    src.m_refs->fetch_add(1);
+
+    m_refs = src.m_refs;
+    m_entries = src.m_entries;
+    m_by_key = src.m_by_key;
+    m_by_val = src.m_by_val;
+    m_size = src.m_size;
+    m_count = src.m_count;
+    m_free = src.m_free;
+    m_head = src.m_head;
+    m_tail = src.m_tail;
+
+    return 0;
+}
+
+void dm_key_map_t::clear()
+{
+    if ((m_refs == NULL) || (m_refs->fetch_sub(1) == 1)) {
+        free(m_entries);
+        free(m_by_key);
+        free(m_by_val);
+        delete m_refs;
+    }
+    m_refs = NULL;
+    m_entries = NULL;
+    m_by_key = NULL;
+    m_by_val = NULL;
+    m_size = 0;
+    m_count = 0;
+    m_free = DM_KEY_MAP_NONE;
+    m_head = DM_KEY_MAP_NONE;
+    m_tail = DM_KEY_MAP_NONE;
+}
+
+dm_key_map_t::dm_key_map_t(): m_entries(NULL), m_by_key(NULL), m_by_val(NULL), m_size(0), m_count(0),
+    m_free(DM_KEY_MAP_NONE), m_head(DM_KEY_MAP_NONE), m_tail(DM_KEY_MAP_NONE), m_refs(NULL)
+{
+
+}
+
+dm_key_map_t::~dm_key_map_t()
+{
+    clear();
+}
@@ -0,0 +1,90 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include "dm_mld_index.h"
+
+static bool is_zero_mac(const unsigned char *mac)
+{
+    return em_hex::pack_mac(mac) == 0;
+}
+
+void dm_mld_index_t::add_mld(const unsigned char *mld_mac, unsigned int idx)
+{
+    if (is_zero_mac(mld_mac) == false) {
+        m_mlds[em_hex::pack_mac(mld_mac)] = idx;
+    }
+}
+
+void dm_mld_index_t::add_link(const unsigned char *mac, unsigned int idx, unsigned int link)
+{
+    if (is_zero_mac(mac) == false) {
+        m_links[em_hex::pack_mac(mac)] = (idx << 8) | (link & 0xff);
+    }
+}
+
+void dm_mld_index_t::remove_mld(const unsigned char *mld_mac, unsigned int idx)
+{
+    auto it = m_mlds.find(em_hex::pack_mac(mld_mac));
+
+    if ((it != m_mlds.end()) && (it->second == idx)) {
+        m_mlds.erase(it);
+    }
+}
+
+void dm_mld_index_t::remove_link(const unsigned char *mac, unsigned int idx)
+{
+    auto it = m_links.find(em_hex::pack_mac(mac));
+
+    if ((it != m_links.end()) && ((it->second >> 8) == idx)) {
+        m_links.erase(it);
+    }
+}
+
+bool dm_mld_index_t::find_mld(const unsigned char *mld_mac, unsigned int *idx) const
+{
+    auto it = m_mlds.find(em_hex::pack_mac(mld_mac));
+
+    if (it == m_mlds.end()) {
+        return false;
+    }
+    *idx = it->second;
+
+    return true;
+}
+
+bool dm_mld_index_t::find_link(const unsigned char *mac, unsigned int *idx, unsigned int *link) const
+{
+    auto it = m_links.find(em_hex::pack_mac(mac));
+
+    if (it == m_links.end()) {
+        return false;
+    }
+    *idx = it->second >> 8;
+    if (link != NULL) {
+        *link = it->second & 0xff;
+    }
+
+    return true;
+}
+
+void dm_mld_index_t::clear()
+{
+    m_mlds.clear();
+    m_links.clear();
+}
@@ -171,7 +171,7 @@ bool dm_network_ssid_t::operator == (const dm_network_ssid_t& obj)
     ret += (memcmp(&this->m_network_ssid_info.mobility_domain, &obj.m_network_ssid_info.mobility_domain, sizeof(mac_address_t)) != 0);
     ret += (this->m_network_ssid_info.num_hauls != obj.m_network_ssid_info.num_hauls);
     for (i = 0; i < this->m_network_ssid_info.num_hauls; i++) {
-    ret += (this->m_network_ssid_info.haul_type[i] == obj.m_network_ssid_info.haul_type[i]);
+    ret += (this->m_network_ssid_info.haul_type[i] != obj.m_network_ssid_info.haul_type[i]);
 }
     ret += (memcmp(&this->m_network_ssid_info.auth_type, &obj.m_network_ssid_info.auth_type, sizeof(em_string_t)) != 0);
     //em_util_info_print(EM_MGR, "%s:%d: MUH ret=%d\n", __func__, __LINE__,ret);
@@ -262,6 +262,64 @@ em_haul_type_t dm_network_ssid_t::haul_type_from_string(em_string_t str)
     return type; 
 }
 
+unsigned int dm_network_ssid_t::get_band_mask(const em_network_ssid_info_t *info)
+{
+    unsigned int i, mask = 0;
+
+    for (i = 0; (i < info->num_bands) && (i < EM_MAX_BANDS); i++) {
+        if (strncmp(info->band[i], "2.4", strlen("2.4")) == 0) {
+            mask |= (1U << em_freq_band_24);
+        } else if (strncmp(info->band[i], "5", strlen("5")) == 0) {
+            mask |= (1U << em_freq_band_5);
+        } else if (strncmp(info->band[i], "6", strlen("6")) == 0) {
+            mask |= (1U << em_freq_band_60);
+        } else {
+            return (1U << em_freq_band_unknown) - 1;
+        }
+    }
+
+    return mask;
+}
+
+unsigned int dm_network_ssid_t::get_changed_bands(dm_network_ssid_t *tgt, unsigned int num_tgt, dm_network_ssid_t *cur, unsigned int num_cur)
+{
+    dm_network_ssid_t *tgt_ssid, *cur_ssid;
+    unsigned int i, j, haul, mask = 0;
+
+    for (haul = 0; haul < em_haul_type_max; haul++) {
+        tgt_ssid = NULL;
+        cur_ssid = NULL;
+        for (i = 0; (i < num_tgt) && (tgt_ssid == NULL); i++) {
+            for (j = 0; (j < tgt[i].m_network_ssid_info.num_hauls) && (j < EM_MAX_HAUL_TYPES); j++) {
+                if (tgt[i].m_network_ssid_info.haul_type[j] == static_cast<em_haul_type_t> (haul)) {
+                    tgt_ssid = &tgt[i];
+                    break;
+                }
+            }
+        }
+        for (i = 0; (i < num_cur) && (cur_ssid == NULL); i++) {
+            for (j = 0; (j < cur[i].m_network_ssid_info.num_hauls) && (j < EM_MAX_HAUL_TYPES); j++) {
+                if (cur[i].m_network_ssid_info.haul_type[j] == static_cast<em_haul_type_t> (haul)) {
+                    cur_ssid = &cur[i];
+                    break;
+                }
+            }
+        }
+
+        if ((tgt_ssid != NULL) && (cur_ssid != NULL) && (*tgt_ssid == *cur_ssid)) {
+            continue;
+        }
+        if (tgt_ssid != NULL) {
+            mask |= get_band_mask(&tgt_ssid->m_network_ssid_info);
+        }
+        if (cur_ssid != NULL) {
+            mask |= get_band_mask(&cur_ssid->m_network_ssid_info);
+        }
+    }
+
+    return mask;
+}
+
 dm_network_ssid_t::dm_network_ssid_t(em_network_ssid_info_t *net_ssid)
 {
     memcpy(&m_network_ssid_info, net_ssid, sizeof(em_network_ssid_info_t));
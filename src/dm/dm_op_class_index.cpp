@@ -0,0 +1,58 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include "dm_op_class_index.h"
+
+void dm_op_class_index_t::add(const em_op_class_info_t *info, unsigned int idx)
+{
+    unsigned long long key = get_key(info->id.ruid, info->id.type, info->id.op_class);
+    dm_op_class_index_entry_t *entry;
+    unsigned int i, channel;
+
+    auto it = m_op_classes.find(key);
+    if (it == m_op_classes.end()) {
+        it = m_op_classes.emplace(key, dm_op_class_index_entry_t()).first;
+        if (info->id.type == em_op_class_type_capability) {
+            m_capable[em_hex::pack_mac(info->id.ruid)]++;
+        }
+    }
+
+    entry = &it->second;
+    memset(entry, 0, sizeof(dm_op_class_index_entry_t));
+    entry->idx = idx;
+    entry->num_channels = info->num_channels;
+    for (i = 0; (i < info->num_channels) && (i < EM_MAX_CHANNELS_IN_LIST); i++) {
+        if ((channel = info->channels[i]) < 256) {
+            entry->channels[channel >> 6] |= 1ULL << (channel & 0x3f);
+        }
+    }
+}
+
+const dm_op_class_index_entry_t *dm_op_class_index_t::find(const unsigned char *ruid, unsigned int type, unsigned int op_class) const
+{
+    auto it = m_op_classes.find(get_key(ruid, type, op_class));
+
+    return (it == m_op_classes.end()) ? NULL:&it->second;
+}
+
+void dm_op_class_index_t::clear()
+{
+    m_op_classes.clear();
+    m_capable.clear();
+}
@@ -29,6 +29,7 @@
 #include <sys/socket.h>
 #include <sys/uio.h>
 #include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 #include "dm_scan_result.h"
 #include "dm_easy_mesh.h"
@@ -112,37 +113,44 @@ int dm_scan_result_t::decode(const cJSON *obj, void *parent_id)
 
 void dm_scan_result_t::encode(cJSON *obj)
 {
-	cJSON *arr_obj, *tmp;
+	dm_json_writer_t writer(obj);
+
+	encode(writer);
+}
+
+void dm_scan_result_t::encode(dm_json_writer_t& writer)
+{
 	unsigned int i;
 	mac_addr_str_t	bssid_str;
 	mac_address_t null_mac = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
-	cJSON_AddNumberToObject(obj, "ScanStatus", m_scan_result.scan_status);
-	cJSON_AddStringToObject(obj, "TimeStamp", m_scan_result.timestamp);
-	cJSON_AddNumberToObject(obj, "Utilization", m_scan_result.util);
-	cJSON_AddNumberToObject(obj, "Noise", m_scan_result.noise);
+	writer.add_number("ScanStatus", m_scan_result.scan_status);
+	writer.add_string("TimeStamp", m_scan_result.timestamp);
+	writer.add_number("Utilization", m_scan_result.util);
+	writer.add_number("Noise", m_scan_result.noise);
 	
-	arr_obj = cJSON_AddArrayToObject(obj, "Neighbors");
+	writer.begin_array("Neighbors");
 	for (i = 0; i < m_scan_result.num_neighbors; i++) {
 		if (memcmp(null_mac, m_scan_result.neighbor[i].bssid, sizeof(mac_address_t)) == 0) {
 			continue;
 		}
-		tmp = cJSON_CreateObject();
+		writer.begin_object();
 
 		dm_easy_mesh_t::macbytes_to_string(m_scan_result.neighbor[i].bssid, bssid_str);
-		cJSON_AddStringToObject(tmp, "BSSID", bssid_str);	
-		cJSON_AddStringToObject(tmp, "SSID", m_scan_result.neighbor[i].ssid);	
-		cJSON_AddNumberToObject(tmp, "SignalStrength", m_scan_result.neighbor[i].signal_strength);
-		cJSON_AddNumberToObject(tmp, "Bandwidth", m_scan_result.neighbor[i].bandwidth);
-		cJSON_AddNumberToObject(tmp, "BSSColor", m_scan_result.neighbor[i].bss_color);
-		cJSON_AddNumberToObject(tmp, "ChannelUtil", m_scan_result.neighbor[i].channel_util);
-		cJSON_AddNumberToObject(tmp, "STACount", m_scan_result.neighbor[i].sta_count);
+		writer.add_string("BSSID", bssid_str);	
+		writer.add_string("SSID", m_scan_result.neighbor[i].ssid);	
+		writer.add_number("SignalStrength", m_scan_result.neighbor[i].signal_strength);
+		writer.add_number("Bandwidth", m_scan_result.neighbor[i].bandwidth);
+		writer.add_number("BSSColor", m_scan_result.neighbor[i].bss_color);
+		writer.add_number("ChannelUtil", m_scan_result.neighbor[i].channel_util);
+		writer.add_number("STACount", m_scan_result.neighbor[i].sta_count);
 		
-		cJSON_AddItemToArray(arr_obj, tmp);
+		writer.end_object();
 	}
+	writer.end_array();
 		
-	cJSON_AddNumberToObject(obj, "ScanDuration", m_scan_result.aggr_scan_duration);
-	cJSON_AddNumberToObject(obj, "ScanType", m_scan_result.scan_type);
+	writer.add_number("ScanDuration", m_scan_result.aggr_scan_duration);
+	writer.add_number("ScanType", m_scan_result.scan_type);
 }
 
 bool dm_scan_result_t::operator == (const dm_scan_result_t& obj)
@@ -156,6 +164,91 @@ void dm_scan_result_t::operator = (const dm_scan_result_t& obj)
 {
 	if (this == &obj) { return; }
 	memcpy(&m_scan_result, &obj.m_scan_result, sizeof(em_scan_result_t));
+	m_used_ms = obj.m_used_ms;
+	reindex_neighbors();
+}
+
+void dm_scan_result_t::touch()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	m_used_ms = static_cast<unsigned long long> (ts.tv_sec) * 1000ULL + static_cast<unsigned long long> (ts.tv_nsec) / 1000000ULL;
+}
+
+unsigned int dm_scan_result_t::nbr_hash(const unsigned char *bssid)
+{
+	// the low bytes of a BSSID are the ones that differ between neighbors
+	return (static_cast<unsigned int>(bssid[3]) * 31u + static_cast<unsigned int>(bssid[4]) * 7u + bssid[5]) % DM_SCAN_RESULT_NBR_SLOTS;
+}
+
+void dm_scan_result_t::reindex_neighbors()
+{
+	unsigned int i, slot;
+
+	memset(m_nbr_slot, 0, sizeof(m_nbr_slot));
+	m_nbr_indexed = 0;
+
+	if (m_scan_result.num_neighbors > EM_MAX_NEIGHBORS) {
+		m_scan_result.num_neighbors = EM_MAX_NEIGHBORS;
+	}
+
+	for (i = 0; i < m_scan_result.num_neighbors; i++) {
+		slot = nbr_hash(m_scan_result.neighbor[i].bssid);
+		while (m_nbr_slot[slot] != 0) {
+			slot = (slot + 1) % DM_SCAN_RESULT_NBR_SLOTS;
+		}
+		m_nbr_slot[slot] = static_cast<unsigned char>(i + 1);
+	}
+	m_nbr_indexed = m_scan_result.num_neighbors;
+}
+
+em_neighbor_t *dm_scan_result_t::find_neighbor(const unsigned char *bssid)
+{
+	em_neighbor_t *nbr;
+	unsigned int i, slot;
+
+	if (m_nbr_indexed != m_scan_result.num_neighbors) {
+		reindex_neighbors();
+	}
+
+	slot = nbr_hash(bssid);
+	for (i = 0; (i < DM_SCAN_RESULT_NBR_SLOTS) && (m_nbr_slot[slot] != 0); i++) {
+		nbr = &m_scan_result.neighbor[m_nbr_slot[slot] - 1];
+		if (memcmp(nbr->bssid, bssid, sizeof(bssid_t)) == 0) {
+			return nbr;
+		}
+		slot = (slot + 1) % DM_SCAN_RESULT_NBR_SLOTS;
+	}
+
+	return NULL;
+}
+
+int dm_scan_result_t::put_neighbor(const em_neighbor_t *nbr)
+{
+	em_neighbor_t *found;
+	unsigned int slot;
+
+	if ((found = find_neighbor(nbr->bssid)) != NULL) {
+		memcpy(found, nbr, sizeof(em_neighbor_t));
+		return 0;
+	}
+
+	if (m_scan_result.num_neighbors >= EM_MAX_NEIGHBORS) {
+		return -1;
+	}
+
+	memcpy(&m_scan_result.neighbor[m_scan_result.num_neighbors], nbr, sizeof(em_neighbor_t));
+	m_scan_result.num_neighbors++;
+
+	slot = nbr_hash(nbr->bssid);
+	while (m_nbr_slot[slot] != 0) {
+		slot = (slot + 1) % DM_SCAN_RESULT_NBR_SLOTS;
+	}
+	m_nbr_slot[slot] = static_cast<unsigned char>(m_scan_result.num_neighbors);
+	m_nbr_indexed = m_scan_result.num_neighbors;
+
+	return 0;
 }
 
 int dm_scan_result_t::parse_scan_result_id_from_key(const char *key, em_scan_result_id_t *id, unsigned char *bssid)
@@ -236,24 +329,28 @@ bool dm_scan_result_t::has_same_id(em_scan_result_id_t *id)
 	return true;
 }
 
-dm_scan_result_t::dm_scan_result_t(em_scan_result_t *scan_result)
+dm_scan_result_t::dm_scan_result_t(em_scan_result_t *scan_result) : m_used_ms(0)
 {
     memcpy(&m_scan_result, scan_result, sizeof(em_scan_result_t));
+	reindex_neighbors();
 }
 
-dm_scan_result_t::dm_scan_result_t(const dm_scan_result_t& scan_result)
+dm_scan_result_t::dm_scan_result_t(const dm_scan_result_t& scan_result) : m_used_ms(scan_result.m_used_ms)
 {
     memcpy(&m_scan_result, &scan_result.m_scan_result, sizeof(em_scan_result_t));
+	reindex_neighbors();
 }
 
-dm_scan_result_t::dm_scan_result_t(const em_scan_result_t& scan_result)
+dm_scan_result_t::dm_scan_result_t(const em_scan_result_t& scan_result) : m_used_ms(0)
 {
     memcpy(&m_scan_result, &scan_result, sizeof(em_scan_result_t));
+	reindex_neighbors();
 }
 
-dm_scan_result_t::dm_scan_result_t()
+dm_scan_result_t::dm_scan_result_t() : m_used_ms(0)
 {
 	memset(&m_scan_result, 0, sizeof(em_scan_result_t));
+	reindex_neighbors();
 }
 
 dm_scan_result_t::~dm_scan_result_t()
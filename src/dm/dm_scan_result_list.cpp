@@ -41,7 +41,13 @@
 
 int dm_scan_result_list_t::get_config(cJSON *parent_obj, void *parent, bool summary)
 {
-	cJSON *scan_res_arr_obj, *scan_res_obj;
+	dm_json_writer_t writer(cJSON_AddArrayToObject(parent_obj, "ScanResults"));
+
+	return get_config(writer, parent);
+}
+
+int dm_scan_result_list_t::get_config(dm_json_writer_t& writer, void *parent)
+{
 	em_scan_result_id_t id;
 	dm_scan_result_t *res;
 	bool all_scan_rsults_of_radio = false;
@@ -51,8 +57,6 @@ int dm_scan_result_list_t::get_config(cJSON *parent_obj, void *parent, bool summ
 		all_scan_rsults_of_radio = true;
 	}
 
-	scan_res_arr_obj = cJSON_AddArrayToObject(parent_obj, "ScanResults");
-
 	res = static_cast<dm_scan_result_t *>(get_first_scan_result());
 	while (res != NULL) {
 		if (all_scan_rsults_of_radio == true) {
@@ -65,15 +69,15 @@ int dm_scan_result_list_t::get_config(cJSON *parent_obj, void *parent, bool summ
 			}
 		}	
 
-		scan_res_obj = cJSON_CreateObject();
-		res->encode(scan_res_obj);
-		cJSON_AddItemToArray(scan_res_arr_obj, scan_res_obj);
+		writer.begin_object();
+		res->encode(writer);
+		writer.end_object();
 		
 
 		res = static_cast<dm_scan_result_t *>(get_next_scan_result(res));
 	}
 	
-    return 0;
+    return (writer.has_error() == true) ? -1:0;
 }
 
 int dm_scan_result_list_t::set_config(db_client_t& db_client, const cJSON *obj_arr, void *parent_id)
@@ -186,7 +190,7 @@ void dm_scan_result_list_t::update_list(const dm_scan_result_t& scan_result, uns
 
         case dm_orch_type_db_update:
             pscan_result = get_scan_result(key);
-            memcpy(&pscan_result->m_scan_result, &scan_result.m_scan_result, sizeof(em_scan_result_t));
+            *pscan_result = scan_result;
             break;
 
         case dm_orch_type_db_delete:
@@ -275,6 +279,25 @@ int dm_scan_result_list_t::update_db(db_client_t& db_client, dm_orch_type_t op,
     return ret;
 }
 
+int dm_scan_result_list_t::delete_rows(db_client_t& db_client, const em_scan_result_id_t *id)
+{
+    mac_addr_str_t dev_mac_str, scanner_mac_str;
+	em_2xlong_string_t prefix;
+	db_query_t query;
+
+	dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *>(id->dev_mac), dev_mac_str);
+	dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *>(id->scanner_mac), scanner_mac_str);
+
+	// every row key of the result starts with its identity, the BSSID of the row follows
+    snprintf(prefix, sizeof(prefix), "%s@%s@%s@%d@%d@%d@", id->net_id, dev_mac_str, scanner_mac_str,
+					id->op_class, id->channel, id->scanner_type);
+	snprintf(query, sizeof(db_query_t), "delete from %s where substr(%s, 1, %zu) = '%s'",
+					m_table_name, m_columns[0].m_name, strlen(prefix), prefix);
+
+	// queued under the prefix, behind the pending writes of the rows
+	return db_client.write(m_table_name, prefix, db_write_op_delete, query);
+}
+
 bool dm_scan_result_list_t::search_db(db_client_t& db_client, void *ctx, void *key)
 {
     em_long_string_t  str;
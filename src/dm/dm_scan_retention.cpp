@@ -0,0 +1,113 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include "dm_scan_retention.h"
+
+unsigned int dm_scan_retention_t::select(unsigned long long now, const dm_scan_retention_entry_t *entries, unsigned int num, bool *evict)
+{
+    std::vector<unsigned int> lru(num);
+    std::unordered_map<em_packed_mac_t, unsigned int> per_radio;
+    unsigned long long bytes = 0;
+    unsigned int i, out = 0;
+
+    m_stats.passes++;
+    m_stats.last_entries = num;
+
+    for (i = 0; i < num; i++) {
+        lru[i] = i;
+        evict[i] = false;
+        bytes += entries[i].bytes;
+    }
+    m_stats.last_bytes = bytes;
+
+    // least recently updated first, each limit takes the oldest results
+    std::sort(lru.begin(), lru.end(), [entries](unsigned int a, unsigned int b) {
+        return entries[a].used_ms < entries[b].used_ms;
+    });
+
+    for (i = 0; i < num; i++) {
+        const dm_scan_retention_entry_t& e = entries[lru[i]];
+
+        if (now < e.used_ms + m_params.min_idle_ms) {
+            continue;
+        }
+        if ((m_params.max_age_ms != 0) && (now >= e.used_ms + m_params.max_age_ms)) {
+            evict[lru[i]] = true;
+            bytes -= e.bytes;
+            m_stats.evicted_age++;
+            out++;
+        }
+    }
+
+    if (m_params.max_per_radio != 0) {
+        for (i = 0; i < num; i++) {
+            if (evict[i] == false) {
+                per_radio[entries[i].scanner]++;
+            }
+        }
+        for (i = 0; i < num; i++) {
+            const dm_scan_retention_entry_t& e = entries[lru[i]];
+            unsigned int& count = per_radio[e.scanner];
+
+            if ((evict[lru[i]] == true) || (count <= m_params.max_per_radio) || (now < e.used_ms + m_params.min_idle_ms)) {
+                continue;
+            }
+            evict[lru[i]] = true;
+            bytes -= e.bytes;
+            count--;
+            m_stats.evicted_radio++;
+            out++;
+        }
+    }
+
+    if (m_params.max_bytes != 0) {
+        for (i = 0; (i < num) && (bytes > m_params.max_bytes); i++) {
+            const dm_scan_retention_entry_t& e = entries[lru[i]];
+
+            if ((evict[lru[i]] == true) || (now < e.used_ms + m_params.min_idle_ms)) {
+                continue;
+            }
+            evict[lru[i]] = true;
+            bytes -= e.bytes;
+            m_stats.evicted_memory++;
+            out++;
+        }
+    }
+
+    return out;
+}
+
+dm_scan_retention_t::dm_scan_retention_t()
+{
+    memset(&m_params, 0, sizeof(m_params));
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    m_params.max_age_ms = 3600000;          // an hour, periodic scans refresh theirs well before
+    m_params.max_per_radio = 128;
+    m_params.max_bytes = 64ULL << 20;
+    m_params.min_idle_ms = 10000;
+}
+
+dm_scan_retention_t::~dm_scan_retention_t()
+{
+
+}
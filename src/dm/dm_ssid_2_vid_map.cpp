@@ -94,32 +94,35 @@ int dm_ssid_2_vid_map_t::set_config(db_client_t& db_client, const cJSON *obj_arr
 dm_orch_type_t dm_ssid_2_vid_map_t::update_list(const dm_ssid_2_vid_map_t& ssid_2_vid_map)
 {
     dm_ssid_2_vid_map_t *pssid_2_vid_map;
-    bool found = false;
-
-    pssid_2_vid_map = static_cast<dm_ssid_2_vid_map_t *>(hash_map_get_first(m_list));
-    while (pssid_2_vid_map != NULL) {
-	if (strncmp(ssid_2_vid_map.m_ssid_2_vid_map_info.id, pssid_2_vid_map->m_ssid_2_vid_map_info.id, strlen(ssid_2_vid_map.m_ssid_2_vid_map_info.id)) == 0) {
-	    found = true;
-	    break;
-	}	
-	pssid_2_vid_map = static_cast<dm_ssid_2_vid_map_t *>(hash_map_get_next(m_list, pssid_2_vid_map));
+    const em_ssid_2_vid_map_info_t *info = &ssid_2_vid_map.m_ssid_2_vid_map_info;
+    dm_orch_type_t op = dm_orch_type_db_update;
+
+    pssid_2_vid_map = static_cast<dm_ssid_2_vid_map_t *>(hash_map_get(m_list, info->id));
+    if (pssid_2_vid_map == NULL) {
+        hash_map_put(m_list, strdup(info->id), new dm_ssid_2_vid_map_t(ssid_2_vid_map));
+        op = dm_orch_type_db_insert;
+    } else if (*pssid_2_vid_map == ssid_2_vid_map) {
+        printf("%s:%d: Network SSID: %s already in list\n", __func__, __LINE__, pssid_2_vid_map->m_ssid_2_vid_map_info.id);
+        return dm_orch_type_none;
+    } else {
+        printf("%s:%d: Network SSID: %s in list but needs update\n", __func__, __LINE__, pssid_2_vid_map->m_ssid_2_vid_map_info.id);
+        memcpy(&pssid_2_vid_map->m_ssid_2_vid_map_info, info, sizeof(em_ssid_2_vid_map_info_t));
     }
 
-    if (found == true) {
-        if (*pssid_2_vid_map == ssid_2_vid_map) {
-            printf("%s:%d: Network SSID: %s already in list\n", __func__, __LINE__, pssid_2_vid_map->m_ssid_2_vid_map_info.id);
-	    return dm_orch_type_none;
-	}
-		
-        	
-	printf("%s:%d: Network SSID: %s in list but needs update\n", __func__, __LINE__, pssid_2_vid_map->m_ssid_2_vid_map_info.id);
-	return dm_orch_type_db_update;
-    }	
+    auto it = m_vids.find(info->ssid);
+    if ((it == m_vids.end()) || (it->second != info->vid)) {
+        m_vids[info->ssid] = info->vid;
+        m_generation++;
+    }
+
+    return op;
+}
 
-    hash_map_put(m_list, strdup(ssid_2_vid_map.m_ssid_2_vid_map_info.id), new dm_ssid_2_vid_map_t(ssid_2_vid_map));	
+int dm_ssid_2_vid_map_t::get_vid(const char *ssid)
+{
+    auto it = m_vids.find(ssid);
 
-		
-    return dm_orch_type_db_insert;
+    return (it != m_vids.end()) ? it->second:-1;
 }
 
 bool dm_ssid_2_vid_map_t::operator == (const db_easy_mesh_t& obj)
@@ -210,6 +213,8 @@ void dm_ssid_2_vid_map_t::init_columns()
 int dm_ssid_2_vid_map_t::init()
 {
 	m_list = hash_map_create();
+    m_vids.clear();
+    m_generation = 0;
     init_table();
     init_columns();
     return 0;
@@ -217,17 +222,22 @@ int dm_ssid_2_vid_map_t::init()
 
 dm_ssid_2_vid_map_t::dm_ssid_2_vid_map_t(em_ssid_2_vid_map_info_t *ssid_2_vid_map)
 {
+    m_list = NULL;
+    m_generation = 0;
     memcpy(&m_ssid_2_vid_map_info, ssid_2_vid_map, sizeof(em_ssid_2_vid_map_info_t));
 }
 
 dm_ssid_2_vid_map_t::dm_ssid_2_vid_map_t(const dm_ssid_2_vid_map_t& ssid_2_vid_map)
 {
+    m_list = NULL;
+    m_generation = 0;
     memcpy(&m_ssid_2_vid_map_info, &ssid_2_vid_map.m_ssid_2_vid_map_info, sizeof(em_ssid_2_vid_map_info_t));
 }
 
 dm_ssid_2_vid_map_t::dm_ssid_2_vid_map_t()
 {
-
+    m_list = NULL;
+    m_generation = 0;
 }
 
 dm_ssid_2_vid_map_t::~dm_ssid_2_vid_map_t()
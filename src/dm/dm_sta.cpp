@@ -147,126 +147,137 @@ int dm_sta_t::decode(const cJSON *obj, void *parent_id)
 }
 
 void dm_sta_t::encode(cJSON *obj, em_get_sta_list_reason_t reason)
+{
+    dm_json_writer_t writer(obj);
+
+    encode(writer, reason);
+}
+
+void dm_sta_t::encode(dm_json_writer_t& writer, em_get_sta_list_reason_t reason)
 {
     mac_addr_str_t  mac_str;
-    cJSON *reason_obj, *request_obj;
 
     dm_sta_t::decode_sta_capability(this);
     dm_sta_t::decode_beacon_report(this);
     dm_easy_mesh_t::macbytes_to_string(m_sta_info.id, mac_str);
     if (strlen(m_sta_info.sta_client_type) != 0) {
-        cJSON_AddStringToObject(obj, "ClientType", m_sta_info.sta_client_type);
+        writer.add_string("ClientType", m_sta_info.sta_client_type);
     }
-    cJSON_AddStringToObject(obj, "MACAddress", mac_str);
-    cJSON_AddBoolToObject(obj, "Associated", m_sta_info.associated);
+    writer.add_string("MACAddress", mac_str);
+    writer.add_bool("Associated", m_sta_info.associated);
 
     if (reason == em_get_sta_list_reason_none) {
-		encode_beacon_report(obj);
+		encode_beacon_report(writer);
 	
-        cJSON_AddNumberToObject(obj, "LastDataUplinkRate", m_sta_info.last_ul_rate);
-        cJSON_AddStringToObject(obj, "TimeStamp", m_sta_info.timestamp);
-        cJSON_AddNumberToObject(obj, "EstMACDataRateUplink", m_sta_info.est_ul_rate);
-        cJSON_AddNumberToObject(obj, "LastConnectTime", m_sta_info.last_conn_time);
-        cJSON_AddNumberToObject(obj, "RetransCount", m_sta_info.retrans_count);
-        cJSON_AddNumberToObject(obj, "EstMACDataRateDownlink", m_sta_info.est_dl_rate);
-        cJSON_AddStringToObject(obj, "HTCapabilities", m_sta_info.ht_cap);
-        cJSON_AddNumberToObject(obj, "SignalStrength", m_sta_info.signal_strength);
-        cJSON_AddNumberToObject(obj, "RCPI", m_sta_info.rcpi);
-        cJSON_AddNumberToObject(obj, "UtilizationTransmit", m_sta_info.util_tx);
-        cJSON_AddStringToObject(obj, "VHTCapabilities", m_sta_info.vht_cap);
-        cJSON_AddStringToObject(obj, "HECapabilities", m_sta_info.he_cap);
-        cJSON_AddStringToObject(obj, "ClientCapabilities", m_sta_info.cap);
-        cJSON_AddNumberToObject(obj, "LastDataDownlinkRate", m_sta_info.last_dl_rate);
-        cJSON_AddNumberToObject(obj, "PacketsReceived", m_sta_info.pkts_rx);
-        cJSON_AddNumberToObject(obj, "UtilizationReceive", m_sta_info.util_rx);
-        cJSON_AddNumberToObject(obj, "BytesSent", m_sta_info.bytes_tx);
-        cJSON_AddNumberToObject(obj, "PacketsSent", m_sta_info.pkts_tx);
-        cJSON_AddNumberToObject(obj, "BytesReceived", m_sta_info.bytes_rx);
-        cJSON_AddNumberToObject(obj, "ErrorsSent", m_sta_info.errors_tx);
-        cJSON_AddNumberToObject(obj, "ErrorsReceived", m_sta_info.errors_rx);
-        cJSON_AddStringToObject(obj, "CellularDataPreference", m_sta_info.cellular_data_pref);
-        cJSON_AddStringToObject(obj, "ListenInterval", m_sta_info.listen_interval);
-        cJSON_AddStringToObject(obj, "SSID", m_sta_info.ssid);
+        writer.add_number("LastDataUplinkRate", m_sta_info.last_ul_rate);
+        writer.add_string("TimeStamp", m_sta_info.timestamp);
+        writer.add_number("EstMACDataRateUplink", m_sta_info.est_ul_rate);
+        writer.add_number("LastConnectTime", m_sta_info.last_conn_time);
+        writer.add_number("RetransCount", m_sta_info.retrans_count);
+        writer.add_number("EstMACDataRateDownlink", m_sta_info.est_dl_rate);
+        writer.add_string("HTCapabilities", m_sta_info.ht_cap);
+        writer.add_number("SignalStrength", m_sta_info.signal_strength);
+        writer.add_number("RCPI", m_sta_info.rcpi);
+        writer.add_number("UtilizationTransmit", m_sta_info.util_tx);
+        writer.add_string("VHTCapabilities", m_sta_info.vht_cap);
+        writer.add_string("HECapabilities", m_sta_info.he_cap);
+        writer.add_string("ClientCapabilities", m_sta_info.cap);
+        writer.add_number("LastDataDownlinkRate", m_sta_info.last_dl_rate);
+        writer.add_number("PacketsReceived", m_sta_info.pkts_rx);
+        writer.add_number("UtilizationReceive", m_sta_info.util_rx);
+        writer.add_number("BytesSent", m_sta_info.bytes_tx);
+        writer.add_number("PacketsSent", m_sta_info.pkts_tx);
+        writer.add_number("BytesReceived", m_sta_info.bytes_rx);
+        writer.add_number("ErrorsSent", m_sta_info.errors_tx);
+        writer.add_number("ErrorsReceived", m_sta_info.errors_rx);
+        writer.add_string("CellularDataPreference", m_sta_info.cellular_data_pref);
+        writer.add_string("ListenInterval", m_sta_info.listen_interval);
+        writer.add_string("SSID", m_sta_info.ssid);
         if (m_sta_info.multi_link[0] != '\0')
-            cJSON_AddStringToObject(obj, "MLDAddr", m_sta_info.multi_link);
-        cJSON_AddStringToObject(obj, "SupportedRates", m_sta_info.supp_rates);
-        cJSON_AddStringToObject(obj, "PowerCapability", m_sta_info.power_cap);
-        cJSON_AddStringToObject(obj, "SupportedChannels", m_sta_info.supp_channels);
-        cJSON_AddStringToObject(obj, "RSNInformation", m_sta_info.rsn_info);
-        cJSON_AddStringToObject(obj, "ExtendedSupportedRates", m_sta_info.ext_supp_rates);
-        cJSON_AddStringToObject(obj, "SupportedOperatingClasses", m_sta_info.supp_op_classes);
-        cJSON_AddStringToObject(obj, "ExtendedCapabilities", m_sta_info.ext_cap);
-        cJSON_AddStringToObject(obj, "RMEnabledCapabilities", m_sta_info.rm_cap);
-        cJSON *vendor_info = cJSON_CreateArray();
+            writer.add_string("MLDAddr", m_sta_info.multi_link);
+        writer.add_string("SupportedRates", m_sta_info.supp_rates);
+        writer.add_string("PowerCapability", m_sta_info.power_cap);
+        writer.add_string("SupportedChannels", m_sta_info.supp_channels);
+        writer.add_string("RSNInformation", m_sta_info.rsn_info);
+        writer.add_string("ExtendedSupportedRates", m_sta_info.ext_supp_rates);
+        writer.add_string("SupportedOperatingClasses", m_sta_info.supp_op_classes);
+        writer.add_string("ExtendedCapabilities", m_sta_info.ext_cap);
+        writer.add_string("RMEnabledCapabilities", m_sta_info.rm_cap);
+        writer.begin_array("VendorSpecific");
         for (unsigned int i = 0; i < m_sta_info.num_vendor_infos; i++) {
-            cJSON *vendor = cJSON_CreateObject();
-            cJSON_AddStringToObject(vendor, "VendorInfo", m_sta_info.vendor_info[i]);
-            cJSON_AddItemToArray(vendor_info, vendor);
+            writer.begin_object();
+            writer.add_string("VendorInfo", m_sta_info.vendor_info[i]);
+            writer.end_object();
         }
-        cJSON_AddItemToObject(obj, "VendorSpecific", vendor_info);
+        writer.end_array();
     } else if (reason == em_get_sta_list_reason_steer) {
-        reason_obj = cJSON_CreateObject();
-        cJSON_AddItemToObject(obj, "ClientSteer", reason_obj);
-        cJSON_AddStringToObject(reason_obj, "TargetBSSID", "00:00:00:00:00:00");
-        request_obj = cJSON_CreateObject();
-        cJSON_AddItemToObject(reason_obj, "RequestMode", request_obj);
-        cJSON_AddNumberToObject(request_obj, "Steering_Opportunity", 0);
-        cJSON_AddNumberToObject(request_obj, "Steering_Mandate", 1);
-        cJSON_AddFalseToObject(reason_obj, "BTMDisassociationImminent");
-        cJSON_AddFalseToObject(reason_obj, "BTMAbridged");
-        cJSON_AddFalseToObject(reason_obj, "LinkRemovalImminent");
-        cJSON_AddNumberToObject(reason_obj, "SteeringOpportunityWindow", 1);
-        cJSON_AddNumberToObject(reason_obj, "BTMDisassociationTimer", 5);
-        cJSON_AddNumberToObject(reason_obj, "TargetBSSOperatingClass", 81);
-        cJSON_AddNumberToObject(reason_obj, "TargetBSSChannel", 6);
+        writer.begin_object("ClientSteer");
+        writer.add_string("TargetBSSID", "00:00:00:00:00:00");
+        writer.begin_object("RequestMode");
+        writer.add_number("Steering_Opportunity", 0);
+        writer.add_number("Steering_Mandate", 1);
+        writer.end_object();
+        writer.add_bool("BTMDisassociationImminent", false);
+        writer.add_bool("BTMAbridged", false);
+        writer.add_bool("LinkRemovalImminent", false);
+        writer.add_number("SteeringOpportunityWindow", 1);
+        writer.add_number("BTMDisassociationTimer", 5);
+        writer.add_number("TargetBSSOperatingClass", 81);
+        writer.add_number("TargetBSSChannel", 6);
+        writer.end_object();
     } else if (reason == em_get_sta_list_reason_disassoc) {
-        reason_obj = cJSON_CreateObject();
-        cJSON_AddItemToObject(obj, "Disassociate", reason_obj);
-        cJSON_AddNumberToObject(reason_obj, "DisassociationTimer", 0);
-        cJSON_AddNumberToObject(reason_obj, "ReasonCode", 0);
-        cJSON_AddFalseToObject(reason_obj, "Silent");
+        writer.begin_object("Disassociate");
+        writer.add_number("DisassociationTimer", 0);
+        writer.add_number("ReasonCode", 0);
+        writer.add_bool("Silent", false);
+        writer.end_object();
     } else if (reason == em_get_sta_list_reason_btm) {
-        reason_obj = cJSON_CreateObject();
-        cJSON_AddItemToObject(obj, "BTMRequest", reason_obj);
-        cJSON_AddTrueToObject(reason_obj, "DisassociationImminent");
-        cJSON_AddNumberToObject(reason_obj, "DisassociationTimer", 0);
-        cJSON_AddNumberToObject(reason_obj, "BSSTerminationDuration", 0);
-        cJSON_AddNumberToObject(reason_obj, "ValidityInterval", 0);
-        cJSON_AddNumberToObject(reason_obj, "SteeringTimer", 0);
-        cJSON_AddStringToObject(reason_obj, "TargetBSS", "00:00:00:00:00:00");
+        writer.begin_object("BTMRequest");
+        writer.add_bool("DisassociationImminent", true);
+        writer.add_number("DisassociationTimer", 0);
+        writer.add_number("BSSTerminationDuration", 0);
+        writer.add_number("ValidityInterval", 0);
+        writer.add_number("SteeringTimer", 0);
+        writer.add_string("TargetBSS", "00:00:00:00:00:00");
+        writer.end_object();
     } else if (reason == em_get_sta_list_reason_neighbors) {
-        encode_beacon_report(obj);
+        encode_beacon_report(writer);
     } else if (reason == em_get_sta_list_reason_topology) {
-        cJSON_AddStringToObject(obj, "SSID", m_sta_info.ssid);
+        writer.add_string("SSID", m_sta_info.ssid);
         if (m_sta_info.multi_link[0] != '\0')
-            cJSON_AddStringToObject(obj, "MLDAddr", m_sta_info.multi_link);
-        cJSON_AddNumberToObject(obj, "SignalStrength", m_sta_info.signal_strength);
-        cJSON_AddNumberToObject(obj, "LastConnectTime", m_sta_info.last_conn_time);
-        cJSON_AddStringToObject(obj, "HTCapabilities", m_sta_info.ht_cap);
-        cJSON_AddStringToObject(obj, "VHTCapabilities", m_sta_info.vht_cap);
-        cJSON_AddStringToObject(obj, "HECapabilities", m_sta_info.he_cap);
-        cJSON_AddStringToObject(obj, "ClientCapabilities", m_sta_info.cap);
+            writer.add_string("MLDAddr", m_sta_info.multi_link);
+        writer.add_number("SignalStrength", m_sta_info.signal_strength);
+        writer.add_number("LastConnectTime", m_sta_info.last_conn_time);
+        writer.add_string("HTCapabilities", m_sta_info.ht_cap);
+        writer.add_string("VHTCapabilities", m_sta_info.vht_cap);
+        writer.add_string("HECapabilities", m_sta_info.he_cap);
+        writer.add_string("ClientCapabilities", m_sta_info.cap);
     }
 }
 
 void dm_sta_t::encode_beacon_report(cJSON *obj)
+{
+    dm_json_writer_t writer(obj);
+
+    encode_beacon_report(writer);
+}
+
+void dm_sta_t::encode_beacon_report(dm_json_writer_t& writer)
 {
 	mac_addr_str_t mac_str;
-    cJSON *neighbors_arr_obj, *neighbor_obj;
 	unsigned int i;
 
-	neighbors_arr_obj = cJSON_AddArrayToObject(obj, "Neighbors");
+	writer.begin_array("Neighbors");
 	for (i = 0; i < m_sta_info.num_beacon_meas_report; i++) {
-		neighbor_obj = cJSON_CreateObject();
+		writer.begin_object();
 		dm_easy_mesh_t::macbytes_to_string(m_sta_info.beacon_reports[i].bssid, mac_str);
-		cJSON_AddStringToObject(neighbor_obj, "BSSID", mac_str);
-		cJSON_AddNumberToObject(neighbor_obj, "OpClass", m_sta_info.beacon_reports[i].opClass);
-		cJSON_AddNumberToObject(neighbor_obj, "Channel", m_sta_info.beacon_reports[i].channel);
-		cJSON_AddNumberToObject(neighbor_obj, "RCPI", m_sta_info.beacon_reports[i].rcpi);
-
-		cJSON_AddItemToArray(neighbors_arr_obj, neighbor_obj);
+		writer.add_string("BSSID", mac_str);
+		writer.add_number("OpClass", m_sta_info.beacon_reports[i].opClass);
+		writer.add_number("Channel", m_sta_info.beacon_reports[i].channel);
+		writer.add_number("RCPI", m_sta_info.beacon_reports[i].rcpi);
+		writer.end_object();
 	}
-		
+	writer.end_array();
 }
 
 bool dm_sta_t::operator == (const dm_sta_t& obj)
@@ -341,6 +352,7 @@ void dm_sta_t::operator = (const dm_sta_t& obj)
     memcpy(&this->m_sta_info.ext_cap, &obj.m_sta_info.ext_cap, sizeof(em_long_string_t));
     memcpy(&this->m_sta_info.rm_cap, &obj.m_sta_info.rm_cap, sizeof(em_long_string_t));
     memcpy(&this->m_sta_info.multi_link, &obj.m_sta_info.multi_link, sizeof(em_long_string_t));
+    this->m_caps_hash = 0;
     for (unsigned int i = 0; i < this->m_sta_info.num_vendor_infos; i++) {
         memcpy(&this->m_sta_info.vendor_info, &obj.m_sta_info.vendor_info, sizeof(em_long_string_t));
     }
@@ -370,128 +382,129 @@ void dm_sta_t::parse_sta_bss_radio_from_key(const char *key, mac_address_t sta,
 
 }
 
+uint64_t dm_sta_t::get_frame_hash(const em_sta_info_t *info)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    unsigned int i, len;
+
+    // FNV-1a
+    len = (info->frame_body_len < EM_MAX_FRAME_BODY_LEN) ? info->frame_body_len:EM_MAX_FRAME_BODY_LEN;
+    for (i = 0; i < len; i++) {
+        h = (h ^ info->frame_body[i]) * 0x100000001b3ULL;
+    }
+
+    return h ^ len;
+}
+
+const em_client_cap_t *dm_sta_t::get_caps()
+{
+    decode_sta_capability(this);
+
+    return &m_caps;
+}
+
 void dm_sta_t::decode_sta_capability(dm_sta_t *sta)
 {
-    unsigned int offset = 0;
+    unsigned int offset, len;
     unsigned char length;
     tag_type_t tag_id;
-    unsigned char *ext_ptr;
-    int ext_len;
-    unsigned char common_info_len;
+    const unsigned char *value;
+    uint64_t hash;
+
+    // the body is the one of the association, the encodes in between do not walk it again
+    hash = get_frame_hash(&sta->m_sta_info);
+    if (sta->m_caps_hash == hash) {
+        return;
+    }
+    sta->m_caps_hash = hash;
+
+    len = (sta->m_sta_info.frame_body_len < EM_MAX_FRAME_BODY_LEN) ? sta->m_sta_info.frame_body_len:EM_MAX_FRAME_BODY_LEN;
+    em_client_cap_cache_t::parse(sta->m_sta_info.frame_body, len, &sta->m_caps);
 
     sta->m_sta_info.num_vendor_infos = 0;
+    if ((sta->m_caps.flags & EM_CLIENT_CAP_MLO) != 0) {
+        strncpy(sta->m_sta_info.multi_link, util::mac_to_string(sta->m_caps.mld_mac).c_str(), sizeof(em_long_string_t) - 1);
+    }
 
-    while (offset < sta->m_sta_info.frame_body_len) {
-        if (offset + 2 > sta->m_sta_info.frame_body_len) {
+    offset = em_client_cap_cache_t::get_elems_offset(sta->m_sta_info.frame_body, len);
+    while (offset < len) {
+        if (offset + 2 > len) {
             printf("%s:%d: Insufficient data for tag header\n", __func__, __LINE__);
             return;
         }
 
         tag_id = static_cast<tag_type_t>(sta->m_sta_info.frame_body[offset]);
         length = sta->m_sta_info.frame_body[offset + 1];
+        value = &sta->m_sta_info.frame_body[offset + 2];
 
-        if (offset + 2 + length > sta->m_sta_info.frame_body_len) {
+        if (offset + 2 + length > len) {
             printf("%s:%d: Tag length exceeds remaining packet length\n", __func__, __LINE__);
             return;
         }
 
-        ieee80211_tagvalue_t *tag = static_cast<ieee80211_tagvalue_t *> (malloc(sizeof(ieee80211_tagvalue_t) + length));
-        if (!tag) {
-            printf("%s:%d: Memory allocation failed\n", __func__, __LINE__);
-            return;
-        }
-
-        tag->tag_id = tag_id;
-        tag->length = length;
-        memcpy(tag->value, &sta->m_sta_info.frame_body[offset + 2], length);
-
-        switch (tag->tag_id) {
+        switch (tag_id) {
             case tag_ssid:
                 memset(sta->m_sta_info.ssid, 0, sizeof(em_long_string_t));
-                memcpy(sta->m_sta_info.ssid, tag->value, tag->length);
+                memcpy(sta->m_sta_info.ssid, value, length);
                 break;
 
             case tag_supported_rates:
-                dm_easy_mesh_t::hex(tag->length, tag->value, sizeof(em_long_string_t), sta->m_sta_info.supp_rates);
+                dm_easy_mesh_t::hex(length, value, sizeof(em_long_string_t), sta->m_sta_info.supp_rates);
                 break;
 
             case tag_extended_supported_rates:
-                dm_easy_mesh_t::hex(tag->length, tag->value, sizeof(em_long_string_t), sta->m_sta_info.ext_supp_rates);
+                dm_easy_mesh_t::hex(length, value, sizeof(em_long_string_t), sta->m_sta_info.ext_supp_rates);
                 break;
 
             case tag_power_capability:
-                dm_easy_mesh_t::hex(tag->length, tag->value, sizeof(em_long_string_t), sta->m_sta_info.power_cap);
+                dm_easy_mesh_t::hex(length, value, sizeof(em_long_string_t), sta->m_sta_info.power_cap);
                 break;
 
             case tag_supported_channels:
-                dm_easy_mesh_t::hex(tag->length, tag->value, sizeof(em_long_string_t), sta->m_sta_info.supp_channels);
+                dm_easy_mesh_t::hex(length, value, sizeof(em_long_string_t), sta->m_sta_info.supp_channels);
                 break;
 
             case tag_rsn_information:
-                dm_easy_mesh_t::hex(tag->length, tag->value, sizeof(em_long_string_t), sta->m_sta_info.rsn_info);
+                dm_easy_mesh_t::hex(length, value, sizeof(em_long_string_t), sta->m_sta_info.rsn_info);
                 break;
 
             case tag_supported_operating_classes:
-                dm_easy_mesh_t::hex(tag->length, tag->value, sizeof(em_long_string_t), sta->m_sta_info.supp_op_classes);
+                dm_easy_mesh_t::hex(length, value, sizeof(em_long_string_t), sta->m_sta_info.supp_op_classes);
                 break;
 
             case tag_rm_enabled_capability:
-                dm_easy_mesh_t::hex(tag->length, tag->value, sizeof(em_long_string_t), sta->m_sta_info.rm_cap);
+                dm_easy_mesh_t::hex(length, value, sizeof(em_long_string_t), sta->m_sta_info.rm_cap);
                 break;
 
             case tag_ht_capabilities:
-                dm_easy_mesh_t::hex(tag->length, tag->value, sizeof(em_long_string_t), sta->m_sta_info.ht_cap);
+                dm_easy_mesh_t::hex(length, value, sizeof(em_long_string_t), sta->m_sta_info.ht_cap);
                 break;
 
             case tag_extended_capabilities:
-                dm_easy_mesh_t::hex(tag->length, tag->value, sizeof(em_long_string_t), sta->m_sta_info.ext_cap);
-                if (tag->length >= 3) {
-                    if (tag->value[2] & (1 << 3)) {
-                        sta->m_sta_info.multi_band_cap = true;
-                    } else {
-                        sta->m_sta_info.multi_band_cap = false;
-                    }
-                } else {
-                    sta->m_sta_info.multi_band_cap = false;
-                }
+                dm_easy_mesh_t::hex(length, value, sizeof(em_long_string_t), sta->m_sta_info.ext_cap);
+                sta->m_sta_info.multi_band_cap = ((length >= 3) && ((value[2] & (1 << 3)) != 0));
                 break;
 
             case tag_vht_capability:
-                dm_easy_mesh_t::hex(tag->length, tag->value, sizeof(em_long_string_t), sta->m_sta_info.vht_cap);
+                dm_easy_mesh_t::hex(length, value, sizeof(em_long_string_t), sta->m_sta_info.vht_cap);
                 break;
 
             case tag_vendor_specific:
                 if (sta->m_sta_info.num_vendor_infos < MAX_VENDOR_INFO) {
-                    dm_easy_mesh_t::hex(tag->length, tag->value, sizeof(sta->m_sta_info.vendor_info[sta->m_sta_info.num_vendor_infos]), sta->m_sta_info.vendor_info[sta->m_sta_info.num_vendor_infos]);
+                    dm_easy_mesh_t::hex(length, value, sizeof(sta->m_sta_info.vendor_info[sta->m_sta_info.num_vendor_infos]), sta->m_sta_info.vendor_info[sta->m_sta_info.num_vendor_infos]);
                     sta->m_sta_info.num_vendor_infos++;
                 }
                 break;
 
-            case tag_extended_tags: {
-                if (tag->value[0] == tag_ext_multi_link) {
-                    ext_ptr = tag->value + 1;
-                    ext_len = tag->length - 1;
-
-                    // Minimum required length: 2 (multilink_control) + 1 (common_info_len) + 6 (MLD MAC)
-                    if (ext_len >= 9) {
-                        ext_ptr += 2; // Skip multilink_control
-                        common_info_len = ext_ptr[0];
-                        ext_ptr++;
-
-                        if (common_info_len >= EM_MAC_ADDR_LEN) {
-                            strncpy(sta->m_sta_info.multi_link, util::mac_to_string(ext_ptr).c_str(), sizeof(em_long_string_t));
-                        }
-                    }
-                }
+            case tag_extended_tags:
+                // the Multi-Link element is in m_caps
                 break;
-            }
 
             default:
-                printf("%s:%d: Unknown Tag ID: %d\n", __func__, __LINE__, tag->tag_id);
+                printf("%s:%d: Unknown Tag ID: %d\n", __func__, __LINE__, tag_id);
                 break;
         }
-    offset += 2 + tag->length;
-    free(tag);
+        offset += 2 + length;
     }
 
 }
@@ -520,17 +533,17 @@ void dm_sta_t::decode_beacon_report(dm_sta_t *sta)
    }
 }
 
-dm_sta_t::dm_sta_t(em_sta_info_t *sta)
+dm_sta_t::dm_sta_t(em_sta_info_t *sta): m_dirty(false), m_caps_hash(0)
 {
     memcpy(&m_sta_info, sta, sizeof(em_sta_info_t));
 }
 
-dm_sta_t::dm_sta_t(const dm_sta_t& sta)
+dm_sta_t::dm_sta_t(const dm_sta_t& sta): m_dirty(false), m_caps(sta.m_caps), m_caps_hash(sta.m_caps_hash)
 {
     memcpy(&m_sta_info, &sta.m_sta_info, sizeof(em_sta_info_t));
 }
 
-dm_sta_t::dm_sta_t()
+dm_sta_t::dm_sta_t(): m_dirty(false), m_caps_hash(0)
 {
     memset(&m_sta_info, 0, sizeof(em_sta_info_t));
 }
@@ -0,0 +1,120 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "dm_sta_delta.h"
+#include "dm_sta.h"
+
+uint64_t dm_sta_delta_t::get_frame_hash(const em_sta_info_t *info)
+{
+    return dm_sta_t::get_frame_hash(info);
+}
+
+unsigned int dm_sta_delta_t::apply(dm_key_map_t *assoc, dm_key_map_t *dassoc, unsigned long long now_ms)
+{
+    dm_sta_delta_entry_t *entry, *next_entry;
+    dm_sta_t *sta, *next;
+    dm_map_key_t key;
+    uint64_t frame_hash;
+    bool resync = false;
+
+    memset(&m_stats, 0, sizeof(dm_sta_delta_stats_t));
+    m_pass++;
+    if ((m_resync_ms != 0) && ((now_ms - m_last_resync_ms) >= m_resync_ms)) {
+        resync = true;
+        m_last_resync_ms = now_ms;
+    }
+
+    sta = static_cast<dm_sta_t *>(assoc->get_first());
+    while (sta != NULL) {
+        next = static_cast<dm_sta_t *>(assoc->get_next(sta));
+        dm_key_map_t::sta_key(&key, sta->m_sta_info.id, sta->m_sta_info.bssid, sta->m_sta_info.radiomac);
+        frame_hash = get_frame_hash(&sta->m_sta_info);
+
+        if ((entry = static_cast<dm_sta_delta_entry_t *>(m_stage.get(&key))) == NULL) {
+            entry = new dm_sta_delta_entry_t;
+            memcpy(&entry->key, &key, sizeof(dm_map_key_t));
+            m_stage.put(&key, entry);
+        } else if ((entry->frame_hash == frame_hash) && (resync == false)) {
+            entry->pass = m_pass;
+            assoc->remove(&key);
+            delete sta;
+            m_stats.unchanged++;
+            sta = next;
+            continue;
+        }
+
+        entry->frame_hash = frame_hash;
+        entry->pass = m_pass;
+        m_stats.joined++;
+        sta = next;
+    }
+
+    sta = static_cast<dm_sta_t *>(dassoc->get_first());
+    while (sta != NULL) {
+        dm_key_map_t::sta_key(&key, sta->m_sta_info.id, sta->m_sta_info.bssid, sta->m_sta_info.radiomac);
+        if ((entry = static_cast<dm_sta_delta_entry_t *>(m_stage.remove(&key))) != NULL) {
+            delete entry;
+        }
+        m_stats.left++;
+        sta = static_cast<dm_sta_t *>(dassoc->get_next(sta));
+    }
+
+    // the subdoc lists every associated STA, those missing from it are gone
+    entry = static_cast<dm_sta_delta_entry_t *>(m_stage.get_first());
+    while (entry != NULL) {
+        next_entry = static_cast<dm_sta_delta_entry_t *>(m_stage.get_next(entry));
+        if (entry->pass != m_pass) {
+            m_stage.remove(&entry->key);
+            delete entry;
+            m_stats.vanished++;
+        }
+        entry = next_entry;
+    }
+
+    return assoc->count() + dassoc->count();
+}
+
+void dm_sta_delta_t::reset()
+{
+    dm_sta_delta_entry_t *entry, *next;
+
+    entry = static_cast<dm_sta_delta_entry_t *>(m_stage.get_first());
+    while (entry != NULL) {
+        next = static_cast<dm_sta_delta_entry_t *>(m_stage.get_next(entry));
+        delete entry;
+        entry = next;
+    }
+    m_stage.clear();
+    m_last_resync_ms = 0;
+}
+
+dm_sta_delta_t::dm_sta_delta_t(unsigned long long resync_ms)
+{
+    m_pass = 0;
+    m_resync_ms = resync_ms;
+    m_last_resync_ms = 0;
+    memset(&m_stats, 0, sizeof(dm_sta_delta_stats_t));
+}
+
+dm_sta_delta_t::~dm_sta_delta_t()
+{
+    reset();
+}
@@ -35,10 +35,12 @@
 #include <sys/uio.h>
 #include <sys/time.h>
 #include <unistd.h>
+#include <algorithm>
 #include "em_cmd.h"
 #include "dm_sta_list.h"
 #include "dm_easy_mesh.h"
 #include "dm_easy_mesh_ctrl.h"
+#include "em_hex.h"
 
 int dm_sta_list_t::get_config(cJSON *obj_arr, void *parent, bool summary)
 {
@@ -46,9 +48,15 @@ int dm_sta_list_t::get_config(cJSON *obj_arr, void *parent, bool summary)
 }
 
 int dm_sta_list_t::get_config(cJSON *obj_arr, void *parent, em_get_sta_list_reason_t reason)
+{
+    dm_json_writer_t writer(obj_arr);
+
+    return get_config(writer, parent, reason);
+}
+
+int dm_sta_list_t::get_config(dm_json_writer_t& writer, void *parent, em_get_sta_list_reason_t reason)
 {
     dm_sta_t *sta;
-    cJSON *obj;
     bssid_t	bssid;
 
     dm_easy_mesh_t::string_to_macbytes(static_cast<char *>(parent), bssid);
@@ -58,14 +66,14 @@ int dm_sta_list_t::get_config(cJSON *obj_arr, void *parent, em_get_sta_list_reas
             sta = get_next_sta(sta);
             continue;
         }
-        obj = cJSON_CreateObject(); 
-        sta->encode(obj, reason);
+        writer.begin_object();
+        sta->encode(writer, reason);
+        writer.end_object();
 
-        cJSON_AddItemToArray(obj_arr, obj);
         sta = get_next_sta(sta);
     }
-    //em_printfout("Station list for bssid %s:\n%s", parent, cJSON_Print(obj_arr));
-    return 0;
+
+    return (writer.has_error() == true) ? -1:0;
 }
 
 int dm_sta_list_t::analyze_config(const cJSON *obj_arr, void *parent_id, em_cmd_t *pcmd[], em_cmd_params_t *param)
@@ -108,13 +116,17 @@ int dm_sta_list_t::set_config(db_client_t& db_client, dm_sta_t& sta, void *paren
 dm_orch_type_t dm_sta_list_t::get_dm_orch_type(db_client_t& db_client, const dm_sta_t& sta)
 {
     dm_sta_t *psta;
-    mac_addr_str_t  sta_mac_str, bssid_mac_str, radio_mac_str;
+    mac_addr_str_t  sta_mac_str;
     em_long_string_t key;
+    char *end;
 
-    dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *>(sta.m_sta_info.id), sta_mac_str);
-    dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *>(sta.m_sta_info.bssid), bssid_mac_str);
-    dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *>(sta.m_sta_info.radiomac), radio_mac_str);
-    snprintf(key, sizeof (em_long_string_t), "%s@%s@%s", sta_mac_str, bssid_mac_str, radio_mac_str);
+    // built for every STA of every report, hence no snprintf
+    end = em_hex::mac_to_str(sta.m_sta_info.id, key);
+    memcpy(sta_mac_str, key, static_cast<size_t> (end - key) + 1);
+    *end++ = '@';
+    end = em_hex::mac_to_str(sta.m_sta_info.bssid, end);
+    *end++ = '@';
+    em_hex::mac_to_str(sta.m_sta_info.radiomac, end);
 
     psta = get_sta(key);
     if (psta != NULL) {
@@ -143,13 +155,14 @@ dm_orch_type_t dm_sta_list_t::get_dm_orch_type(db_client_t& db_client, const dm_
 void dm_sta_list_t::update_list(const dm_sta_t& sta, dm_orch_type_t op)
 {
     dm_sta_t *psta;
-    mac_addr_str_t	sta_mac_str, bssid_mac_str, radio_mac_str;
     em_long_string_t key;
+    char *end;
 
-    dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *>(sta.m_sta_info.id), sta_mac_str);
-    dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *>(sta.m_sta_info.bssid), bssid_mac_str);
-    dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *>(sta.m_sta_info.radiomac), radio_mac_str);
-    snprintf(key, sizeof (em_long_string_t), "%s@%s@%s", sta_mac_str, bssid_mac_str, radio_mac_str);
+    end = em_hex::mac_to_str(sta.m_sta_info.id, key);
+    *end++ = '@';
+    end = em_hex::mac_to_str(sta.m_sta_info.bssid, end);
+    *end++ = '@';
+    em_hex::mac_to_str(sta.m_sta_info.radiomac, end);
 
     switch (op) {
         case dm_orch_type_db_insert:
@@ -159,6 +172,8 @@ void dm_sta_list_t::update_list(const dm_sta_t& sta, dm_orch_type_t op)
         case dm_orch_type_db_update:
 			psta = get_sta(key);
             memcpy(&psta->m_sta_info, &sta.m_sta_info, sizeof(em_sta_info_t));
+            psta->m_caps = sta.m_caps;
+            psta->m_caps_hash = sta.m_caps_hash;
             break;
 
         case dm_orch_type_db_delete:
@@ -174,17 +189,17 @@ void dm_sta_list_t::update_list(const dm_sta_t& sta, dm_orch_type_t op)
 void dm_sta_list_t::delete_list()
 {       
     dm_sta_t *psta, *tmp;
-    mac_addr_str_t	sta_mac_str, bssid_mac_str;
     em_long_string_t key;
+    char *end;
     
     psta = get_first_sta();
     while (psta != NULL) {
         tmp = psta;
         psta = get_next_sta(psta);       
     
-   	dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *>(tmp->m_sta_info.id), sta_mac_str);
-    	dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *>(tmp->m_sta_info.bssid), bssid_mac_str);
-    	snprintf(key, sizeof (em_long_string_t), "%s@%s", sta_mac_str, bssid_mac_str);
+        end = em_hex::mac_to_str(tmp->m_sta_info.id, key);
+        *end++ = '@';
+        em_hex::mac_to_str(tmp->m_sta_info.bssid, end);
         remove_sta(key);    
     }
 }   
@@ -200,7 +215,7 @@ int dm_sta_list_t::update_row(db_client_t& db_client, ...)
     db_query_t  tmp, format, query;
     va_list list;
     db_fmt_t    col_fmt;
-    void *ctx;
+    em_2xlong_string_t key;
 
     snprintf(format, sizeof(db_query_t), "update %s set ", m_table_name);
 
@@ -233,12 +248,14 @@ int dm_sta_list_t::update_row(db_client_t& db_client, ...)
     (void) vsnprintf(query, sizeof(db_query_t), format, list);
     va_end(list);
 
-    //printf("%s:%d: Query: %s\n", __func__, __LINE__, query);
+    // a STA has a row per BSSID, both name the row in the write queue
+    va_start(list, db_client);
+    get_row_key(key, 1, (strncmp(m_table_name, "STAList", sizeof(m_table_name)) == 0) ? 2:1, list);
+    va_end(list);
 
-    ctx = db_client.execute(query);
-    while (db_client.next_result(ctx) == true);
+    //printf("%s:%d: Query: %s\n", __func__, __LINE__, query);
 
-    return 0;
+    return db_client.write(m_table_name, key, db_write_op_update, query);
 }
 
 int dm_sta_list_t::update_db(db_client_t& db_client, dm_orch_type_t op, void *data)
@@ -246,13 +263,13 @@ int dm_sta_list_t::update_db(db_client_t& db_client, dm_orch_type_t op, void *da
     mac_addr_str_t sta_mac_str, bssid_mac_str, radio_mac_str;
     em_sta_info_t *info = static_cast<em_sta_info_t *>(data);
     int ret = 0;
-    char frame_body[EM_MAX_FRAME_BODY_LEN*2];
+    char frame_body[EM_MAX_FRAME_BODY_LEN*2 + 1];
 
     //printf("dm_sta_list_t:%s:%d: Operation: %s\n", __func__, __LINE__, em_cmd_t::get_orch_op_str(op));
 
 	switch (op) {
 		case dm_orch_type_db_insert:
-			dm_easy_mesh_t::hex(info->frame_body_len, info->frame_body, EM_MAX_FRAME_BODY_LEN*2, frame_body);
+			dm_easy_mesh_t::hex(std::min(info->frame_body_len, static_cast<unsigned int>(EM_MAX_FRAME_BODY_LEN)), info->frame_body, sizeof(frame_body), frame_body);
 			ret = insert_row(db_client, dm_easy_mesh_t::macbytes_to_string(info->id, sta_mac_str),
 						dm_easy_mesh_t::macbytes_to_string(info->bssid, bssid_mac_str),
 						dm_easy_mesh_t::macbytes_to_string(info->radiomac, radio_mac_str),
@@ -265,7 +282,7 @@ int dm_sta_list_t::update_db(db_client_t& db_client, dm_orch_type_t op, void *da
 			break;
 
 		case dm_orch_type_db_update:
-			dm_easy_mesh_t::hex(info->frame_body_len, info->frame_body, EM_MAX_FRAME_BODY_LEN*2, frame_body);
+			dm_easy_mesh_t::hex(std::min(info->frame_body_len, static_cast<unsigned int>(EM_MAX_FRAME_BODY_LEN)), info->frame_body, sizeof(frame_body), frame_body);
 			ret = update_row(db_client, dm_easy_mesh_t::macbytes_to_string(info->bssid, bssid_mac_str), 
 						dm_easy_mesh_t::macbytes_to_string(info->radiomac, radio_mac_str),
 						info->associated, info->last_ul_rate, info->last_dl_rate,
@@ -307,15 +324,11 @@ bool dm_sta_list_t::compare_db(db_client_t& db_client, const dm_sta_t& sta)
 {
     em_sta_info_t info;
     mac_addr_str_t mac;
-    char frame_body[EM_MAX_FRAME_BODY_LEN*2];
-
-    db_query_t    query;
     void *ctx;
 
-    memset(query, 0, sizeof(db_query_t));
-    snprintf(query, sizeof(db_query_t), "select * from %s", m_table_name);
-
-    ctx = db_client.execute(query);
+    // only the rows of this STA can match it
+    dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *>(sta.m_sta_info.id), mac);
+    ctx = select_by_key(db_client, mac, 0);
 
     while (db_client.next_result(ctx)) {
         memset(&info, 0, sizeof(em_sta_info_t));
@@ -347,9 +360,7 @@ bool dm_sta_list_t::compare_db(db_client_t& db_client, const dm_sta_t& sta)
         info.errors_tx = static_cast<unsigned char> (db_client.get_number(ctx, 19));
         info.errors_rx = static_cast<unsigned char> (db_client.get_number(ctx, 20));
         info.frame_body_len = static_cast<unsigned char> (db_client.get_number(ctx, 21));
-
-        db_client.get_string(ctx, frame_body, 22);
-        dm_easy_mesh_t::unhex(static_cast<unsigned int>(strlen(frame_body)), frame_body, EM_MAX_FRAME_BODY_LEN, info.frame_body);
+        get_frame_body(db_client, ctx, 22, &info);
 
         if (memcmp(static_cast<const void*>(&sta.m_sta_info), static_cast<const void*>(&info), sizeof(em_sta_info_t)) == 0) {
             return true;
@@ -364,7 +375,8 @@ int dm_sta_list_t::sync_db(db_client_t& db_client, void *ctx)
     em_sta_info_t info;
     mac_addr_str_t	mac;
     int rc = 0;
-    char frame_body[EM_MAX_FRAME_BODY_LEN*2];
+    unsigned int num_hex = 0;
+    bool hex;
 
     while (db_client.next_result(ctx)) {
         memset(&info, 0, sizeof(em_sta_info_t));
@@ -397,14 +409,41 @@ int dm_sta_list_t::sync_db(db_client_t& db_client, void *ctx)
         info.errors_rx = static_cast<unsigned int> (db_client.get_number(ctx, 20));
         info.frame_body_len = static_cast<unsigned int> (db_client.get_number(ctx, 21));
 
-        db_client.get_string(ctx, frame_body, 22);
-        dm_easy_mesh_t::unhex(static_cast<unsigned int>(strlen(frame_body)), frame_body, EM_MAX_FRAME_BODY_LEN, info.frame_body);
+        hex = get_frame_body(db_client, ctx, 22, &info);
 
         update_list(dm_sta_t(&info), dm_orch_type_db_insert);
+
+        // a row written before the frame body was a blob is written again, once
+        if (hex == true) {
+            update_db(db_client, dm_orch_type_db_update, &info);
+            num_hex++;
+        }
+    }
+
+    if (num_hex != 0) {
+        printf("%s:%d: %d frame bodies converted from hex\n", __func__, __LINE__, num_hex);
     }
     return rc;
 }
 
+bool dm_sta_list_t::get_frame_body(db_client_t& db_client, void *ctx, unsigned int col, em_sta_info_t *info)
+{
+    char hex[EM_MAX_FRAME_BODY_LEN*2];
+    unsigned int len, max;
+
+    max = std::min(info->frame_body_len, static_cast<unsigned int>(EM_MAX_FRAME_BODY_LEN));
+    len = db_client.get_blob(ctx, reinterpret_cast<unsigned char *>(hex), sizeof(hex), col);
+
+    // the blob has the length of the frame body, the hex text of the older rows twice that
+    if ((max == 0) || (len != 2*max)) {
+        memcpy(info->frame_body, hex, std::min(len, max));
+        return false;
+    }
+
+    dm_easy_mesh_t::unhex(len, hex, EM_MAX_FRAME_BODY_LEN, info->frame_body);
+    return true;
+}
+
 void dm_sta_list_t::init_table()
 {
     snprintf(m_table_name, sizeof(m_table_name), "%s", "STAList");
@@ -435,7 +474,7 @@ void dm_sta_list_t::init_columns()
     m_columns[m_num_cols++] = db_column_t("ErrorsSent", db_data_type_int, 0);
     m_columns[m_num_cols++] = db_column_t("ErrorsReceived", db_data_type_int, 0);
     m_columns[m_num_cols++] = db_column_t("FrameBodyLength", db_data_type_int, 0);
-    m_columns[m_num_cols++] = db_column_t("FrameBody", db_data_type_text, 1024);
+    m_columns[m_num_cols++] = db_column_t("FrameBody", db_data_type_blob, EM_MAX_FRAME_BODY_LEN);
 }
 
 int dm_sta_list_t::init()
@@ -46,6 +46,47 @@ void dm_tid_to_link_t::encode(cJSON *obj)
     //TODO: needs to be implemnented
 }
 
+int dm_tid_to_link_t::set_mapping(const unsigned char *ap_mld, const unsigned char *sta_mld, unsigned char link_map, bool default_map)
+{
+    em_tid_to_link_info_t *info = &m_tid_to_link_info;
+    em_tid_to_link_map_info_t *map = NULL;
+    unsigned int i;
+
+    if (info->num_mapping == 0) {
+        info->is_bsta_config = false;
+        memcpy(info->mld_mac_addr, ap_mld, sizeof(mac_address_t));
+    } else if (memcmp(info->mld_mac_addr, ap_mld, sizeof(mac_address_t)) != 0) {
+        return -1;
+    }
+
+    for (i = 0; i < info->num_mapping; i++) {
+        if (memcmp(info->tid_to_link_mapping[i].sta_mld_mac_addr, sta_mld, sizeof(mac_address_t)) == 0) {
+            map = &info->tid_to_link_mapping[i];
+            break;
+        }
+    }
+    if (map == NULL) {
+        if (info->num_mapping >= EM_MAX_AP_MLD) {
+            return -1;
+        }
+        map = &info->tid_to_link_mapping[info->num_mapping++];
+        memset(map, 0, sizeof(em_tid_to_link_map_info_t));
+        memcpy(map->sta_mld_mac_addr, sta_mld, sizeof(mac_address_t));
+    } else if ((map->tid_to_link_map == link_map) && (map->default_link_map == default_map)) {
+        return 0;
+    }
+
+    // one octet map for every TID, downlink, the direction the AP MLD schedules
+    map->add_remove = true;
+    map->direction = false;
+    map->default_link_map = default_map;
+    map->link_map_size = true;
+    map->link_map_presence_ind = (default_map == true) ? 0x00:0xff;
+    map->tid_to_link_map = link_map;
+
+    return 1;
+}
+
 void dm_tid_to_link_t::operator = (const dm_tid_to_link_t& obj)
 {
     if (this == &obj) { return; }
@@ -0,0 +1,167 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <arpa/inet.h>
+#include "em_ap_cap_report.h"
+
+em_ap_cap_radio_sect_t *em_ap_cap_report_t::get_sect(const unsigned char *ruid)
+{
+    unsigned int i;
+
+    for (i = 0; i < m_num_radios; i++) {
+        if (memcmp(m_radios[i].ruid, ruid, sizeof(mac_address_t)) == 0) {
+            return &m_radios[i];
+        }
+    }
+    if (m_num_radios == EM_MAX_RADIO_PER_AGENT) {
+        return NULL;
+    }
+
+    memset(&m_radios[m_num_radios], 0, sizeof(em_ap_cap_radio_sect_t));
+    memcpy(m_radios[m_num_radios].ruid, ruid, sizeof(mac_address_t));
+
+    return &m_radios[m_num_radios++];
+}
+
+int em_ap_cap_report_t::parse(const unsigned char *tlvs, unsigned int len)
+{
+    const em_tlv_t *tlv;
+    em_ap_cap_radio_sect_t *sect;
+    unsigned int tlv_len, i;
+    int radio_tlv, agent_tlv;
+
+    while (len >= sizeof(em_tlv_t)) {
+        tlv = reinterpret_cast<const em_tlv_t *> (tlvs);
+        tlv_len = ntohs(tlv->len);
+        if (tlv->type == em_tlv_type_eom) {
+            break;
+        }
+        if (len < sizeof(em_tlv_t) + tlv_len) {
+            printf("%s:%d: TLV type:0x%02x len:%d past the end of the report\n", __func__, __LINE__, tlv->type, tlv_len);
+            return -1;
+        }
+
+        radio_tlv = -1;
+        agent_tlv = -1;
+        switch (tlv->type) {
+            case em_tlv_type_ap_radio_basic_cap:    radio_tlv = em_ap_cap_radio_tlv_basic; break;
+            case em_tlv_type_ht_cap:                radio_tlv = em_ap_cap_radio_tlv_ht; break;
+            case em_tlv_type_vht_cap:               radio_tlv = em_ap_cap_radio_tlv_vht; break;
+            case em_tlv_type_he_cap:                radio_tlv = em_ap_cap_radio_tlv_he; break;
+            case em_tlv_type_ap_wifi6_cap:          radio_tlv = em_ap_cap_radio_tlv_wifi6; break;
+            case em_tlv_type_channel_scan_cap:      radio_tlv = em_ap_cap_radio_tlv_scan; break;
+            case em_tlv_type_ap_cap:                agent_tlv = em_ap_cap_agent_tlv_ap_cap; break;
+            case em_tlv_type_wifi7_agent_cap:       agent_tlv = em_ap_cap_agent_tlv_wifi7; break;
+            case em_tlv_eht_operations:             agent_tlv = em_ap_cap_agent_tlv_eht_ops; break;
+            case em_tlv_type_cac_cap:               agent_tlv = em_ap_cap_agent_tlv_cac; break;
+            case em_tlv_type_profile_2_ap_cap:      agent_tlv = em_ap_cap_agent_tlv_prof_2; break;
+            case em_tlv_type_device_inventory:      agent_tlv = em_ap_cap_agent_tlv_inventory; break;
+
+            case em_tlv_type_ap_radio_advanced_cap:
+                // an entry per radio
+                if ((tlv_len % sizeof(em_ap_radio_advanced_cap_t)) != 0) {
+                    printf("%s:%d: Invalid TLV length:%d for advanced cap\n", __func__, __LINE__, tlv_len);
+                    return -1;
+                }
+                for (i = 0; i < tlv_len; i += sizeof(em_ap_radio_advanced_cap_t)) {
+                    if ((sect = get_sect(&tlv->value[i])) != NULL) {
+                        sect->tlvs[em_ap_cap_radio_tlv_advanced].value = &tlv->value[i];
+                        sect->tlvs[em_ap_cap_radio_tlv_advanced].len = sizeof(em_ap_radio_advanced_cap_t);
+                    }
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        // a later TLV of the same radio and type replaces the earlier one
+        if ((radio_tlv >= 0) && (tlv_len >= sizeof(mac_address_t))) {
+            if ((sect = get_sect(tlv->value)) == NULL) {
+                printf("%s:%d: more than %d radios in the report\n", __func__, __LINE__, EM_MAX_RADIO_PER_AGENT);
+            } else {
+                sect->tlvs[radio_tlv].value = tlv->value;
+                sect->tlvs[radio_tlv].len = tlv_len;
+            }
+        } else if (agent_tlv >= 0) {
+            m_agent[agent_tlv].value = tlv->value;
+            m_agent[agent_tlv].len = tlv_len;
+        }
+
+        m_num_tlvs++;
+        tlvs += sizeof(em_tlv_t) + tlv_len;
+        len -= static_cast<unsigned int> (sizeof(em_tlv_t)) + tlv_len;
+    }
+
+    return static_cast<int> (m_num_tlvs);
+}
+
+unsigned int em_ap_cap_report_t::decode_op_classes(const em_ap_cap_tlv_ref_t *basic, em_op_class_info_t *op_classes, unsigned int max)
+{
+    const em_ap_radio_basic_cap_t *cap = reinterpret_cast<const em_ap_radio_basic_cap_t *> (basic->value);
+    const em_op_class_t *op_class;
+    em_op_class_info_t *info;
+    unsigned int i, j, off, num = 0;
+
+    if ((basic->value == NULL) || (basic->len < sizeof(em_ap_radio_basic_cap_t))) {
+        return 0;
+    }
+
+    off = sizeof(em_ap_radio_basic_cap_t);
+    for (i = 0; (i < cap->op_class_num) && (num < max); i++) {
+        op_class = reinterpret_cast<const em_op_class_t *> (basic->value + off);
+        if ((off + sizeof(em_op_class_t) > basic->len) || (off + sizeof(em_op_class_t) + op_class->num > basic->len)) {
+            printf("%s:%d: operating class %d past the end of the TLV\n", __func__, __LINE__, i);
+            break;
+        }
+
+        info = &op_classes[num++];
+        memset(info, 0, sizeof(em_op_class_info_t));
+        memcpy(info->id.ruid, cap->ruid, sizeof(mac_address_t));
+        info->id.type = em_op_class_type_capability;
+        info->op_class = static_cast<unsigned int> (op_class->op_class);
+        info->id.op_class = info->op_class;
+        info->max_tx_power = static_cast<int> (op_class->max_tx_eirp);
+        info->num_channels = (op_class->num > EM_MAX_CHANNELS_IN_LIST) ? EM_MAX_CHANNELS_IN_LIST:op_class->num;
+        for (j = 0; j < info->num_channels; j++) {
+            info->channels[j] = static_cast<unsigned int> (op_class->channels.channel[j]);
+        }
+        off += static_cast<unsigned int> (sizeof(em_op_class_t)) + op_class->num;
+    }
+
+    return num;
+}
+
+void em_ap_cap_report_t::copy(const em_ap_cap_tlv_ref_t *tlv, void *dst, size_t size)
+{
+    size_t len = (tlv->len < size) ? tlv->len:size;
+
+    memcpy(dst, tlv->value, len);
+    memset(static_cast<unsigned char *> (dst) + len, 0, size - len);
+}
+
+em_ap_cap_report_t::em_ap_cap_report_t() : m_radios(), m_num_radios(0), m_agent(), m_num_tlvs(0)
+{
+}
+
+em_ap_cap_report_t::~em_ap_cap_report_t()
+{
+}
@@ -44,6 +44,8 @@
 #include "dm_easy_mesh.h"
 #include "em_cmd_exec.h"
 #include "em_cmd_client_cap.h"
+#include "em_mgr.h"
+#include "em_perf.h"
 
 int em_capability_t::send_ap_cap_report_msg(unsigned char *dst, unsigned short msg_id)
 {
@@ -337,12 +339,12 @@ short em_capability_t::create_client_cap_tlv(unsigned char *buff, mac_address_t
 
     dm = get_data_model();
 
-    dm_sta = reinterpret_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_map));
+    dm_sta = reinterpret_cast<dm_sta_t *> (dm->m_sta_map->get_first());
     while(dm_sta != NULL) {
         if (memcmp(dm_sta->get_sta_info()->id, sta, sizeof(mac_address_t)) == 0) {
             break;
         }
-        dm_sta = reinterpret_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_map, sta));
+        dm_sta = reinterpret_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
     }
 
     //TODO; if dm_sta is null break; fill result 0?
@@ -735,15 +737,11 @@ int em_capability_t::handle_client_cap_report(unsigned char *buff, unsigned int
     unsigned int tmp_len;
     em_tlv_t *tlv;
     em_sta_info_t sta_info;
-    mac_addr_str_t sta_mac_str, bssid_str, radio_mac_str;
-    em_long_string_t	key;
-    dm_easy_mesh_t  *dm;
+    mac_addr_str_t sta_mac_str;
     bool found_client_info = false;
     bool found_cap_report = false;
     char *errors[EM_MAX_TLV_MEMBERS] = {0};
 
-    dm = get_data_model();
-
     if (em_msg_t(em_msg_type_client_cap_rprt, em_profile_type_3, buff, len).validate(errors) == 0) {
         printf("%s:%d:Client Capability query message validation failed\n",__func__,__LINE__);
         return -1;
@@ -780,7 +778,10 @@ int em_capability_t::handle_client_cap_report(unsigned char *buff, unsigned int
             }
             sta_info.associated = true;
             sta_info.frame_body_len = htons(tlv->len) - 1;
-            memcpy(sta_info.frame_body, &tlv->value[1], htons(tlv->len) - 1);
+            if (sta_info.frame_body_len > EM_MAX_FRAME_BODY_LEN) {
+                sta_info.frame_body_len = EM_MAX_FRAME_BODY_LEN;
+            }
+            memcpy(sta_info.frame_body, &tlv->value[1], sta_info.frame_body_len);
 
             found_cap_report = true;
             break;
@@ -795,19 +796,76 @@ int em_capability_t::handle_client_cap_report(unsigned char *buff, unsigned int
         return -1;
     }
 
+    if (get_mgr()->get_client_caps()->update(sta_info.id, sta_info.frame_body, sta_info.frame_body_len,
+            get_radio_band(), em_timer_wheel_t::get_time_ms()) == true) {
+        dm_easy_mesh_t::macbytes_to_string(sta_info.id, sta_mac_str);
+        em_printfout("Client capabilities of %s changed", sta_mac_str);
+    }
+
     set_state(em_state_ctrl_sta_cap_confirmed);
+    put_client_cap(&sta_info);
 
-    dm_easy_mesh_t::macbytes_to_string(sta_info.id, sta_mac_str);
-    dm_easy_mesh_t::macbytes_to_string(sta_info.bssid, bssid_str);
-    dm_easy_mesh_t::macbytes_to_string(get_radio_interface_mac(), radio_mac_str);
-    snprintf(key, sizeof(em_long_string_t), "%s@%s@%s", sta_mac_str, bssid_str, radio_mac_str);
+    return 0;
+}
 
-    if (hash_map_get(dm->m_sta_assoc_map, key) == NULL) {
-        hash_map_put(dm->m_sta_assoc_map, strdup(key), new dm_sta_t(&sta_info));
+void em_capability_t::put_client_cap(em_sta_info_t *sta_info)
+{
+    mac_addr_str_t sta_mac_str;
+    dm_map_key_t key;
+    dm_easy_mesh_t *dm = get_data_model();
+
+    dm_key_map_t::sta_key(&key, sta_info->id, sta_info->bssid, get_radio_interface_mac());
+    if (dm->m_sta_assoc_map->get(&key) == NULL) {
+        dm->m_sta_assoc_map->put(&key, new dm_sta_t(sta_info));
         dm->set_db_cfg_param(db_cfg_type_sta_list_update, "");
-        em_printfout("New client updated to db: %s", key);
+        dm_easy_mesh_t::macbytes_to_string(sta_info->id, sta_mac_str);
+        em_printfout("New client updated to db: %s", sta_mac_str);
     }
-    return 0;
+}
+
+em_freq_band_t em_capability_t::get_radio_band()
+{
+    dm_radio_t *radio;
+
+    if ((radio = get_data_model()->get_radio(get_radio_interface_mac())) == NULL) {
+        return em_freq_band_unknown;
+    }
+
+    return radio->get_radio_info()->band;
+}
+
+bool em_capability_t::client_cap_query_needed()
+{
+    em_client_cap_cache_t *caps = get_mgr()->get_client_caps();
+    em_cmd_params_t *evt_param = &get_current_cmd()->m_param;
+    unsigned long long now = em_timer_wheel_t::get_time_ms();
+    dm_easy_mesh_t *dm = get_data_model();
+    em_bss_info_t *bss_info;
+    em_sta_info_t sta_info;
+
+    memset(&sta_info, 0, sizeof(em_sta_info_t));
+    dm_easy_mesh_t::string_to_macbytes(evt_param->u.args.args[1], sta_info.bssid);
+    dm_easy_mesh_t::string_to_macbytes(evt_param->u.args.args[2], sta_info.id);
+    memcpy(sta_info.radiomac, get_radio_interface_mac(), sizeof(mac_address_t));
+
+    // the association is handed to every radio of the agent, the radio of the BSS asks and gets the report
+    if (((bss_info = dm->get_bss_info_with_mac(sta_info.bssid)) != NULL) &&
+            (memcmp(bss_info->ruid.mac, get_radio_interface_mac(), sizeof(mac_address_t)) != 0)) {
+        set_state(em_state_ctrl_sta_cap_confirmed);
+        return false;
+    }
+
+    // reassociation or BSS move of a STA already reported, its last report stands for this BSS too
+    if (caps->needs_query(sta_info.id, get_radio_band(), now) == false) {
+        sta_info.frame_body_len = caps->get_body(sta_info.id, sta_info.frame_body, EM_MAX_FRAME_BODY_LEN);
+        sta_info.associated = true;
+        set_state(em_state_ctrl_sta_cap_confirmed);
+        put_client_cap(&sta_info);
+        return false;
+    }
+
+    // asked already, the report confirms this em when it comes
+    return caps->claim_query(sta_info.id, now);
 }
 
 void em_capability_t::handle_client_cap_query(unsigned char *buff, unsigned int len)
@@ -944,20 +1002,21 @@ int em_capability_t::handle_ap_radio_basic_cap(unsigned char *buff, unsigned int
 {
 	dm_radio_t * radio;
 	mac_address_t	ruid;
-	unsigned int i, j;
+	unsigned int i, num, changed;
 	em_radio_info_t *radio_info;
 	bool radio_exists = false;
-	bool op_class_exists = false;
-	mac_addr_str_t mac_str;
 	em_ap_radio_basic_cap_t *radio_basic_cap = reinterpret_cast<em_ap_radio_basic_cap_t *> (buff);
-	em_op_class_t *basic_cap_op_class;
-	em_op_class_info_t	op_class_info;
-	dm_op_class_t *op_class_obj;
+	em_ap_cap_tlv_ref_t basic = {buff, len};
+	em_op_class_info_t	op_class_info[EM_MAX_OP_CLASS];
 
 	dm_easy_mesh_t *dm = get_data_model();
 
+	if (len < sizeof(em_ap_radio_basic_cap_t)) {
+		em_printfout("AP Radio Basic Capabilities too short, len:%d", len);
+		return -1;
+	}
+
 	memcpy(ruid, radio_basic_cap->ruid, sizeof(mac_address_t));
-	dm_easy_mesh_t::macbytes_to_string(ruid, mac_str);
 	for (i = 0; i < dm->get_num_radios(); i++) {
 		radio = dm->get_radio(i);
 		if (memcmp(radio->m_radio_info.intf.mac, ruid, sizeof(mac_address_t)) == 0) {
@@ -966,6 +1025,10 @@ int em_capability_t::handle_ap_radio_basic_cap(unsigned char *buff, unsigned int
 		}
 	}
 	if (radio_exists == false) {
+		if (dm->get_num_radios() >= EM_MAX_RADIO_PER_AGENT) {
+			em_printfout("No room for radio: %s", util::mac_to_string(ruid).c_str());
+			return -1;
+		}
 		em_printfout("Radio does not exist, getting radio at index: %d", dm->get_num_radios());
 		radio = dm->get_radio(dm->get_num_radios());
 		memset(&radio->m_radio_info, 0, sizeof(em_radio_info_t));	
@@ -978,42 +1041,10 @@ int em_capability_t::handle_ap_radio_basic_cap(unsigned char *buff, unsigned int
 	radio_info->number_of_bss = radio_basic_cap->num_bss;
 	dm->set_db_cfg_param(db_cfg_type_radio_list_update, "");
 
-	basic_cap_op_class = radio_basic_cap->op_classes;
-	if (basic_cap_op_class != NULL) {
-		for (i = 0; i < radio_basic_cap->op_class_num; i++) {
-			memset(&op_class_info, 0, sizeof(em_op_class_info_t));
-			memcpy(op_class_info.id.ruid, ruid, sizeof(mac_address_t));
-			op_class_info.id.type = em_op_class_type_capability;
-			op_class_info.op_class = static_cast<unsigned int> (basic_cap_op_class->op_class);
-			op_class_info.id.op_class = op_class_info.op_class;
-			op_class_info.max_tx_power = static_cast<int> (basic_cap_op_class->max_tx_eirp);
-			op_class_info.num_channels = static_cast<unsigned int> (basic_cap_op_class->num);
-			for (j = 0; j < op_class_info.num_channels; j++) {
-				op_class_info.channels[j] = static_cast<unsigned int> (basic_cap_op_class->channels.channel[j]);
-			}
-			basic_cap_op_class = reinterpret_cast<em_op_class_t *>(reinterpret_cast<unsigned char *> (basic_cap_op_class) + sizeof(em_op_class_t) + op_class_info.num_channels);
- 			op_class_obj = &dm->m_op_class[0];
-			op_class_obj = &dm->m_op_class[0];
-			// now check if the op_class already exists
-			for (j = 0; j < dm->get_num_op_class(); j++) {
-				op_class_obj = &dm->m_op_class[j];
-				if (*op_class_obj == dm_op_class_t(&op_class_info)) {
-					op_class_exists = true;
-					break;
-				}
-			}
-
-			if (op_class_exists == true) {
-				op_class_exists = false;
-			} else {
-				op_class_obj = &dm->m_op_class[dm->get_num_op_class()];
-				dm->set_num_op_class(dm->get_num_op_class() + 1);
-			}
-			memcpy(&op_class_obj->m_op_class_info, &op_class_info, sizeof(em_op_class_info_t));
-			dm->set_db_cfg_param(db_cfg_type_op_class_list_update, "");
-		}
-	} else {
-		em_printfout("basic_cap_op_class is NULL");
+	// all the classes of the radio at once, only the changed ones are marked dirty
+	num = em_ap_cap_report_t::decode_op_classes(&basic, op_class_info, EM_MAX_OP_CLASS);
+	if ((changed = dm->apply_op_classes(op_class_info, num)) > 0) {
+		em_printfout("%u of %u capability operating classes changed for radio: %s", changed, num, util::mac_to_string(ruid).c_str());
 	}
 
 	return 0;
@@ -1101,206 +1132,151 @@ int em_capability_t::handle_eht_operations_tlv(unsigned char *buff)
     return 0;
 }
 
-int em_capability_t::handle_ap_cap_report(unsigned char *buff, unsigned int len)
+void em_capability_t::apply_ap_cap_radio(const em_ap_cap_radio_sect_t *sect)
 {
-    em_cmdu_t *cmdu = reinterpret_cast<em_cmdu_t *> (buff + sizeof(em_raw_hdr_t));
-
-    em_tlv_t *tlv;
-    unsigned int tmp_len;
-    dm_easy_mesh_t *dm;
-
-    dm = get_data_model();
-    
-    tlv =  reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *>(cmdu) + sizeof(em_cmdu_t));
-    tmp_len = len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
-
-    em_printfout("AP Capability report message rcvd");
+    dm_easy_mesh_t *dm = get_data_model();
+    const em_ap_cap_tlv_ref_t *tlvs = sect->tlvs;
+    dm_radio_cap_t *radio_cap;
+    em_radio_cap_info_t *cap_info;
+    unsigned int i;
+
+    // the radio first, the capabilities below are looked up by it
+    if (tlvs[em_ap_cap_radio_tlv_basic].value != NULL) {
+        handle_ap_radio_basic_cap(const_cast<unsigned char *> (tlvs[em_ap_cap_radio_tlv_basic].value), tlvs[em_ap_cap_radio_tlv_basic].len);
+    }
 
-    while ((tlv->type != em_tlv_type_eom) && (tmp_len > 0)) {
-        if (tlv->type == em_tlv_type_ap_cap) {
-            dm_radio_t *radio = dm->get_radio(get_radio_interface_mac());
-            em_radio_info_t *radio_info = radio->get_radio_info();
-            em_ap_capability_t *ap_cap = reinterpret_cast<em_ap_capability_t *>(tlv->value);
+    for (i = em_ap_cap_radio_tlv_ht; i < em_ap_cap_radio_tlv_max; i++) {
+        if (tlvs[i].value != NULL) {
+            break;
+        }
+    }
+    if (i == em_ap_cap_radio_tlv_max) {
+        return;
+    }
 
-            if ((ap_cap == NULL) || (radio_info == NULL)){
-                em_printfout("No data Found");
-            }
+    if ((radio_cap = dm->get_radio_cap(const_cast<unsigned char *> (sect->ruid))) == NULL) {
+        em_printfout("Unknown RUID: %s", util::mac_to_string(sect->ruid).c_str());
+        return;
+    }
+    cap_info = radio_cap->get_radio_cap_info();
 
-            radio_info->unassociated_sta_link_mterics_nonopclass_inclusion_policy = ap_cap->unassociated_client_link_metrics_non_op_channels;
-            radio_info->unassociated_sta_link_mterics_opclass_inclusion_policy = ap_cap->unassociated_client_link_metrics_op_channels;
-            radio_info->support_rcpi_steering = ap_cap->rcpi_steering;
-        } else if (tlv->type == em_tlv_type_ap_radio_basic_cap){
-            handle_ap_radio_basic_cap(tlv->value, htons(tlv->len));
-        } else if (tlv->type == em_tlv_type_ht_cap){
-            em_ap_ht_cap_t *ht_cap = reinterpret_cast<em_ap_ht_cap_t *>(tlv->value);
-            dm_radio_cap_t *radio_cap = dm->get_radio_cap(ht_cap->ruid);
-
-            if ((ht_cap != NULL) && (radio_cap != NULL)){
-                em_radio_cap_info_t *cap_info = radio_cap->get_radio_cap_info();
-                if ((cap_info == NULL)){
-                    em_printfout("No data Found");
-                }
-                memcpy(&cap_info->ht_cap, ht_cap, sizeof(em_ap_ht_cap_t));
-            }
-        }
-        else if (tlv->type == em_tlv_type_vht_cap){
-            em_ap_vht_cap_t *vht_cap = reinterpret_cast<em_ap_vht_cap_t *>(tlv->value);
-            dm_radio_cap_t *radio_cap = dm->get_radio_cap(vht_cap->ruid);
-            if ((vht_cap != NULL) && (radio_cap != NULL)){
-                em_radio_cap_info_t *cap_info = radio_cap->get_radio_cap_info();
-                if ((cap_info == NULL)){
-                    em_printfout("No data Found");
-                    return 0;
-                }
-                memcpy(&cap_info->vht_cap, vht_cap, sizeof(em_ap_vht_cap_t));
-            }
-        }
-        else if (tlv->type == em_tlv_type_he_cap){
-            em_ap_he_cap_t *he_cap = reinterpret_cast<em_ap_he_cap_t *>(tlv->value);
-            dm_radio_cap_t *radio_cap = dm->get_radio_cap(he_cap->ruid);
+    if (tlvs[em_ap_cap_radio_tlv_ht].value != NULL) {
+        em_ap_cap_report_t::copy(&tlvs[em_ap_cap_radio_tlv_ht], &cap_info->ht_cap, sizeof(em_ap_ht_cap_t));
+    }
+    if (tlvs[em_ap_cap_radio_tlv_vht].value != NULL) {
+        em_ap_cap_report_t::copy(&tlvs[em_ap_cap_radio_tlv_vht], &cap_info->vht_cap, sizeof(em_ap_vht_cap_t));
+    }
+    if (tlvs[em_ap_cap_radio_tlv_he].value != NULL) {
+        em_ap_cap_report_t::copy(&tlvs[em_ap_cap_radio_tlv_he], &cap_info->he_cap, sizeof(em_ap_he_cap_t));
+    }
+    if (tlvs[em_ap_cap_radio_tlv_wifi6].value != NULL) {
+        em_ap_cap_report_t::copy(&tlvs[em_ap_cap_radio_tlv_wifi6], &cap_info->wifi6_cap, sizeof(em_radio_wifi6_cap_data_t));
+    }
+    if (tlvs[em_ap_cap_radio_tlv_scan].value != NULL) {
+        em_ap_cap_report_t::copy(&tlvs[em_ap_cap_radio_tlv_scan], &cap_info->ch_scan, sizeof(em_channel_scan_cap_radio_t));
+    }
+    if (tlvs[em_ap_cap_radio_tlv_advanced].value != NULL) {
+        em_ap_cap_report_t::copy(&tlvs[em_ap_cap_radio_tlv_advanced], &cap_info->radio_ad_cap, sizeof(em_ap_radio_advanced_cap_t));
+    }
+}
 
-            if ((he_cap != NULL) && (radio_cap != NULL)){
-                em_radio_cap_info_t *cap_info = radio_cap->get_radio_cap_info();
+void em_capability_t::apply_ap_cap_agent(em_ap_cap_report_t *report)
+{
+    dm_easy_mesh_t *dm = get_data_model();
+    const em_ap_cap_tlv_ref_t *tlv;
+    dm_radio_t *radio;
+    dm_radio_cap_t *radio_cap;
+    em_radio_info_t *radio_info;
+    em_ap_capability_t ap_cap;
+    em_wifi7_agent_cap_t wifi7_cap;
+    em_cac_cap_t cac;
+    em_device_inventory_t invent;
+    unsigned int i;
+
+    tlv = report->get_agent_tlv(em_ap_cap_agent_tlv_ap_cap);
+    if ((tlv->value != NULL) && ((radio = dm->get_radio(get_radio_interface_mac())) != NULL)) {
+        em_ap_cap_report_t::copy(tlv, &ap_cap, sizeof(em_ap_capability_t));
+        radio_info = radio->get_radio_info();
+        radio_info->unassociated_sta_link_mterics_nonopclass_inclusion_policy = ap_cap.unassociated_client_link_metrics_non_op_channels;
+        radio_info->unassociated_sta_link_mterics_opclass_inclusion_policy = ap_cap.unassociated_client_link_metrics_op_channels;
+        radio_info->support_rcpi_steering = ap_cap.rcpi_steering;
+    }
 
-                if ((cap_info == NULL)){
-                    em_printfout("No data Found");
-                    return 0;
-                }
-                memcpy(&cap_info->he_cap, he_cap, sizeof(em_ap_he_cap_t));
+    tlv = report->get_agent_tlv(em_ap_cap_agent_tlv_wifi7);
+    if (tlv->value != NULL) {
+        em_ap_cap_report_t::copy(tlv, &wifi7_cap, sizeof(em_wifi7_agent_cap_t));
+        for (i = 0; (i < wifi7_cap.radios_num) && (i < EM_MAX_RADIO_PER_AGENT); i++) {
+            if ((radio_cap = dm->get_radio_cap(wifi7_cap.radios[i].ruid)) != NULL) {
+                memcpy(&radio_cap->get_radio_cap_info()->wifi7_cap, &wifi7_cap, sizeof(em_wifi7_agent_cap_t));
             }
         }
-        else if (tlv->type == em_tlv_type_ap_wifi6_cap){
-            em_radio_wifi6_cap_data_t *wifi6_cap = reinterpret_cast<em_radio_wifi6_cap_data_t *>(tlv->value);
-            dm_radio_cap_t *radio_cap = dm->get_radio_cap(wifi6_cap->ruid);
+    }
 
-            if ((wifi6_cap != NULL) && radio_cap != NULL){
-                em_radio_cap_info_t *cap_info = radio_cap->get_radio_cap_info();
+    tlv = report->get_agent_tlv(em_ap_cap_agent_tlv_eht_ops);
+    if (tlv->value != NULL) {
+        handle_eht_operations_tlv(const_cast<unsigned char *> (tlv->value));
+    }
 
-                if ((cap_info == NULL)){
-                    em_printfout("No data Found");
-                    return 0;
-                }
-                memcpy(&cap_info->wifi6_cap, wifi6_cap, sizeof(em_radio_wifi6_cap_data_t));
-            }
-        }
-        else if (tlv->type == em_tlv_type_wifi7_agent_cap){
-            em_wifi7_agent_cap_t *wifi7_cap = reinterpret_cast<em_wifi7_agent_cap_t *>(tlv->value);
-            for (int idx = 0; idx < wifi7_cap->radios_num; idx++)
-            {
-                dm_radio_cap_t *radio_cap = dm->get_radio_cap(wifi7_cap->radios[idx].ruid);
-                if ((wifi7_cap != NULL) && (radio_cap != NULL)){
-                    em_radio_cap_info_t *cap_info = radio_cap->get_radio_cap_info();
-                    if ((cap_info == NULL)){
-                        em_printfout("No data Found");
-                        return 0;
-                    }
-                    memcpy(&cap_info->wifi7_cap, wifi7_cap, sizeof(em_wifi7_agent_cap_t));
-                }
+    tlv = report->get_agent_tlv(em_ap_cap_agent_tlv_cac);
+    if (tlv->value != NULL) {
+        em_ap_cap_report_t::copy(tlv, &cac, sizeof(em_cac_cap_t));
+        for (i = 0; (i < cac.radios_num) && (i < EM_MAX_RADIO_PER_AGENT); i++) {
+            if ((radio_cap = dm->get_radio_cap(cac.radios[i].ruid)) != NULL) {
+                memcpy(&radio_cap->get_radio_cap_info()->cac_cap, &cac.radios[0], sizeof(em_cac_cap_t));
             }
         }
-        else if (tlv->type == em_tlv_eht_operations){
-            handle_eht_operations_tlv(tlv->value);
-        }
-        else if (tlv->type == em_tlv_type_channel_scan_cap){
-            em_channel_scan_cap_radio_t *scan = reinterpret_cast<em_channel_scan_cap_radio_t *>(tlv->value);
-            dm_radio_cap_t *radio_cap = dm->get_radio_cap(scan->ruid);
-            if (radio_cap != NULL){
-                em_radio_cap_info_t *cap_info = radio_cap->get_radio_cap_info();
-                if ((scan == NULL) && (cap_info == NULL)){
-                    em_printfout("No data Found");
-                    return 0;
-                }
-                memcpy(&cap_info->ch_scan, scan, sizeof(em_channel_scan_cap_radio_t));
-            }
-        }
-        else if (tlv->type == em_tlv_type_1905_layer_security_cap){
-        }
-        else if (tlv->type == em_tlv_type_cac_cap){
-            em_cac_cap_t *cac = reinterpret_cast<em_cac_cap_t *>(tlv->value);
-            for (int idx = 0; idx < cac->radios_num; idx++)
-            {
-                dm_radio_cap_t *radio_cap = dm->get_radio_cap(cac->radios[idx].ruid);
-                if ((cac != NULL) && (radio_cap != NULL)){
-                    em_radio_cap_info_t *cap_info = radio_cap->get_radio_cap_info();
-                    if ((cap_info == NULL)){
-                        em_printfout("No data Found");
-                        return 0;
-                    }
-                    memcpy(&cap_info->cac_cap, &cac->radios[0], sizeof(em_cac_cap_t));
-                }
-            }
-        } else if (tlv->type == em_tlv_type_profile_2_ap_cap){
-            em_profile_2_ap_cap_t *prof = reinterpret_cast<em_profile_2_ap_cap_t *>(tlv->value);
-            dm_radio_cap_t *radio_cap = dm->get_radio_cap(get_radio_interface_mac());
-            if (radio_cap != NULL){
-            em_radio_cap_info_t *cap_info = radio_cap->get_radio_cap_info();
-
+    }
 
-            if ((prof == NULL) || (cap_info == NULL)){
-                em_printfout("No data Found");
-                return 0;
-            }
+    tlv = report->get_agent_tlv(em_ap_cap_agent_tlv_prof_2);
+    if ((tlv->value != NULL) && ((radio_cap = dm->get_radio_cap(get_radio_interface_mac())) != NULL)) {
+        em_ap_cap_report_t::copy(tlv, &radio_cap->get_radio_cap_info()->prof_2_ap_cap, sizeof(em_profile_2_ap_cap_t));
+    }
 
-            memcpy(&cap_info->prof_2_ap_cap, &prof, sizeof(em_profile_2_ap_cap_t));
+    tlv = report->get_agent_tlv(em_ap_cap_agent_tlv_inventory);
+    if (tlv->value != NULL) {
+        em_ap_cap_report_t::copy(tlv, &invent, sizeof(em_device_inventory_t));
+        for (i = 0; (i < dm->get_num_radios()) && (i < EM_MAX_RADIO_PER_AGENT); i++) {
+            if ((radio = dm->get_radio(invent.radios[i].ruid)) != NULL) {
+                memcpy(&radio->get_radio_info()->inventory_info, &invent, sizeof(em_device_inventory_t));
             }
         }
-        else if (tlv->type == em_tlv_type_metric_cltn_interval){
-        } else if (tlv->type == em_tlv_type_device_inventory){
-            em_device_inventory_t *invent = reinterpret_cast<em_device_inventory_t *>(tlv->value);
-            if (invent != NULL){
-                for (unsigned int index = 0; index < dm->get_num_radios(); index++)
-                {
-                    dm_radio_t *radio = dm->get_radio(invent->radios[index].ruid);
-                    if (radio == NULL) {
-                        continue;
-                    }
-                    em_radio_info_t *radio_info = radio->get_radio_info();
+    }
+}
 
-                    if ((radio_info != NULL)){
-                        memcpy(&radio_info->inventory_info, invent, sizeof(em_device_inventory_t));
-                    }
-                }
-            }
-        } else if (tlv->type == em_tlv_type_ap_radio_advanced_cap){
-            uint16_t value_len = ntohs(tlv->len);
+int em_capability_t::handle_ap_cap_report(unsigned char *buff, unsigned int len)
+{
+    em_ap_cap_report_t report;
+    uint64_t start = em_lat_hist_t::get_time_us();
+    unsigned int i, hdr_len = static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
+    dm_easy_mesh_t *dm;
 
-            if (value_len % sizeof(em_ap_radio_advanced_cap_t) != 0) {
-                em_printfout("Invalid TLV length for advanced cap");
-                return -1;
-            }
+    dm = get_data_model();
 
-            uint16_t count = value_len / sizeof(em_ap_radio_advanced_cap_t);
-            uint8_t *adv = tlv->value;
-            for (uint16_t i = 0; i < count; ++i) {
-                em_ap_radio_advanced_cap_t *ad =
-                    reinterpret_cast<em_ap_radio_advanced_cap_t *>(adv);
-                    
-                dm_radio_cap_t *radio_cap = dm->get_radio_cap(ad->ruid);
-
-                if (radio_cap) {
-                    em_radio_cap_info_t *cap_info = radio_cap->get_radio_cap_info();
-                    if (cap_info) {
-                        memcpy(&cap_info->radio_ad_cap, ad, sizeof(em_ap_radio_advanced_cap_t));
-                    }
-                 } else {
-                    em_printfout("Unknown RUID: %s",
-                        util::mac_to_string(ad->ruid).c_str());
-                }
+    em_printfout("AP Capability report message rcvd");
 
-                adv += sizeof(em_ap_radio_advanced_cap_t);
-            }
-        }
+    if ((len < hdr_len) || (report.parse(buff + hdr_len, len - hdr_len) < 0)) {
+        em_printfout("AP Capability report malformed, len:%d", len);
+        return -1;
+    }
 
-        tmp_len -= static_cast<unsigned int> (sizeof(em_tlv_t) + htons(tlv->len));
-        tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
+    // a radio at a time, then what the agent reports across its radios
+    for (i = 0; i < report.get_num_radios(); i++) {
+        apply_ap_cap_radio(report.get_radio(i));
     }
+    apply_ap_cap_agent(&report);
+    dm->set_radio_changed();
 
     /*if (em_msg_t(em_msg_type_ap_cap_rprt, em_profile_type_3, buff, len).validate(errors) == 0) {
         printf("%s:%d:AP Capability report message validation failed\n",__func__,__LINE__);
         return -1;
     }*/
 
-    em_printfout("AP Capability report message rcvd for radio: %s", util::mac_to_string(get_radio_interface_mac()).c_str());
+    em_perf_t::record((len < EM_AP_CAP_REPORT_SMALL_LEN) ? em_perf_hist_ap_cap_report_small:
+            ((len < EM_AP_CAP_REPORT_LARGE_LEN) ? em_perf_hist_ap_cap_report_medium:em_perf_hist_ap_cap_report_large),
+            em_lat_hist_t::get_time_us() - start);
+
+    em_printfout("AP Capability report message rcvd for radio: %s, %u TLVs of %u radios",
+            util::mac_to_string(get_radio_interface_mac()).c_str(), report.get_num_tlvs(), report.get_num_radios());
 
     return 0;
 }
@@ -1408,7 +1384,9 @@ void em_capability_t::process_ctrl_state()
             break;
 
         case em_state_ctrl_sta_cap_pending:
-            send_client_cap_query();
+            if (client_cap_query_needed() == true) {
+                send_client_cap_query();
+            }
             break;
 
         default:
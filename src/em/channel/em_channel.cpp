@@ -36,6 +36,7 @@
 #include <sys/time.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <algorithm>
 #include <openssl/rand.h>
 #include "em.h"
 #include "em_msg.h"
@@ -138,16 +139,18 @@ short em_channel_t::create_channel_scan_req_tlv(unsigned char *buff)
 short em_channel_t::create_channel_pref_tlv(unsigned char *buff)
 {
     short len = 0;
-    unsigned int i, j;
+    unsigned int i, j, k;
     em_channel_pref_t       *pref;
     em_channel_pref_op_class_t      *pref_op_class;
     dm_easy_mesh_t *dm;
     dm_op_class_t   *op_class;
     unsigned char *tmp;
-    unsigned char pref_bits = 0xee;
+    unsigned char pref_bits;
+    unsigned char bits[EM_MAX_CHANNELS_IN_LIST];
     unsigned int num_of_channel = 0;
     em_channels_list_t *channel_list;
     em_device_info_t *device ;
+    unsigned long long now = em_timer_wheel_t::get_time_ms();
 
     dm = get_data_model();
     pref = reinterpret_cast<em_channel_pref_t *> (buff);
@@ -166,27 +169,154 @@ short em_channel_t::create_channel_pref_tlv(unsigned char *buff)
             continue;
         }
         
-        pref_op_class->op_class = static_cast<unsigned char> (op_class->m_op_class_info.op_class);
-        num_of_channel = op_class->m_op_class_info.num_channels;
-        channel_list = &pref_op_class->channels;
-        len += static_cast<short unsigned int> (sizeof(em_channel_pref_op_class_t));
-        pref_op_class->num = static_cast<unsigned char> (num_of_channel);
+        num_of_channel = std::min(op_class->m_op_class_info.num_channels, static_cast<unsigned int> (EM_MAX_CHANNELS_IN_LIST));
+        // an empty channel list stands for all the channels of the operating class
+        bits[0] = 0xee;
         for (j = 0; j < num_of_channel; j++) {
-            memcpy(channel_list->channel, reinterpret_cast<unsigned char *> (&op_class->m_op_class_info.channels[j]), sizeof(unsigned char));
-            channel_list = reinterpret_cast<em_channels_list_t *> (reinterpret_cast<unsigned char *> (channel_list) + sizeof(unsigned char));
-            len += static_cast<short unsigned int> (sizeof(unsigned char));
+            bits[j] = get_channel_pref_bits(static_cast<unsigned char> (op_class->m_op_class_info.op_class),
+                static_cast<unsigned char> (op_class->m_op_class_info.channels[j]), now);
         }
 
-        tmp += sizeof(em_channel_pref_op_class_t) + pref_op_class->num;
-        memcpy(tmp, &pref_bits, sizeof(unsigned char));
-        len += static_cast<short unsigned int> (sizeof(unsigned char));
-        tmp += sizeof(unsigned char);
-        pref_op_class = reinterpret_cast<em_channel_pref_op_class_t *> (tmp);
-        pref->op_classes_num++;
+        // one entry per preference of the operating class, in the order the channels come
+        for (j = 0; j < std::max(num_of_channel, 1u); j++) {
+            pref_bits = bits[j];
+            for (k = 0; (k < j) && (bits[k] != pref_bits); k++);
+            if (k < j) {
+                continue;
+            }
+
+            pref_op_class->op_class = static_cast<unsigned char> (op_class->m_op_class_info.op_class);
+            channel_list = &pref_op_class->channels;
+            len += static_cast<short unsigned int> (sizeof(em_channel_pref_op_class_t));
+            pref_op_class->num = 0;
+            for (k = j; k < num_of_channel; k++) {
+                if (bits[k] != pref_bits) {
+                    continue;
+                }
+                channel_list->channel[pref_op_class->num++] = static_cast<unsigned char> (op_class->m_op_class_info.channels[k]);
+                len += static_cast<short unsigned int> (sizeof(unsigned char));
+            }
+
+            tmp += sizeof(em_channel_pref_op_class_t) + pref_op_class->num;
+            memcpy(tmp, &pref_bits, sizeof(unsigned char));
+            len += static_cast<short unsigned int> (sizeof(unsigned char));
+            tmp += sizeof(unsigned char);
+            pref_op_class = reinterpret_cast<em_channel_pref_op_class_t *> (tmp);
+            pref->op_classes_num++;
+        }
     }
     return len;
 }
 
+unsigned char em_channel_t::get_channel_pref_bits(unsigned char op_class, unsigned char channel, unsigned long long now)
+{
+    // preference in the high nibble, reason code in the low one
+    if (get_data_model()->is_channel_allowed(get_radio_interface_mac(), op_class, channel) == false) {
+        return 0x00;    // the radio reported the channel as non operable
+    }
+
+    if ((em_spectrum_cache_t::is_afc(op_class) == true) &&
+            (get_mgr()->get_spectrum_cache()->get_state(get_data_model()->get_agent_al_interface_mac(), op_class, channel,
+                now, NULL) == em_spectrum_state_unavailable)) {
+        return 0x10;    // not available at standard power, still usable at low power indoor
+    }
+
+    if (em_cac_sched_t::is_dfs(op_class, channel) == false) {
+        return 0xee;
+    }
+
+    switch (get_mgr()->get_cac_sched()->get_state(get_data_model()->get_agent_al_interface_mac(), op_class, channel, now)) {
+        case em_cac_state_available:
+            return 0xe9;    // CAC run and channel cleared
+
+        case em_cac_state_non_occupied:
+            return 0x07;    // radar detected
+
+        default:
+            return (m_cac_admitted == true) ? 0xda:0x0a;    // DFS channel state unknown
+    }
+}
+
+bool em_channel_t::query_spectrum()
+{
+    dm_easy_mesh_t *dm = get_data_model();
+    em_device_info_t *device = dm->get_device_info();
+    unsigned int i;
+    dm_op_class_t *op_class;
+
+    for (i = 0; i < dm->m_num_opclass; i++) {
+        op_class = &dm->m_op_class[i];
+        if ((memcmp(op_class->m_op_class_info.id.ruid, device->intf.mac, sizeof(mac_address_t)) == 0) &&
+                (op_class->m_op_class_info.id.type == em_op_class_type_anticipated) &&
+                (em_spectrum_cache_t::is_afc(static_cast<unsigned char> (op_class->m_op_class_info.op_class)) == true)) {
+            break;
+        }
+    }
+    if (i == dm->m_num_opclass) {
+        return true;
+    }
+
+    switch (get_mgr()->get_spectrum_cache()->query(dm->get_agent_al_interface_mac(), em_timer_wheel_t::get_time_ms())) {
+        case em_spectrum_query_send:
+            send_available_spectrum_inquiry_msg();
+            return false;
+
+        case em_spectrum_query_wait:
+            return false;
+
+        default:
+            return true;
+    }
+}
+
+bool em_channel_t::admit_cac()
+{
+    dm_easy_mesh_t *dm = get_data_model();
+    em_device_info_t *device = dm->get_device_info();
+    em_cac_sched_t *sched = get_mgr()->get_cac_sched();
+    unsigned long long now = em_timer_wheel_t::get_time_ms();
+    unsigned int i, j, cac_ms = 0;
+    unsigned char op, ch;
+    dm_op_class_t *op_class;
+    em_cac_state_t state;
+
+    m_cac_admitted = false;
+
+    // the longest CAC among the DFS channels offered that the agent has not cleared
+    for (i = 0; i < dm->m_num_opclass; i++) {
+        op_class = &dm->m_op_class[i];
+        if (((memcmp(op_class->m_op_class_info.id.ruid, device->intf.mac, sizeof(mac_address_t)) == 0) &&
+                (op_class->m_op_class_info.id.type == em_op_class_type_anticipated)) == false) {
+            continue;
+        }
+        op = static_cast<unsigned char> (op_class->m_op_class_info.op_class);
+        for (j = 0; (j < op_class->m_op_class_info.num_channels) && (j < EM_MAX_CHANNELS_IN_LIST); j++) {
+            ch = static_cast<unsigned char> (op_class->m_op_class_info.channels[j]);
+            state = sched->get_state(dm->get_agent_al_interface_mac(), op, ch, now);
+            if ((state == em_cac_state_unknown) || (state == em_cac_state_active)) {
+                cac_ms = std::max(cac_ms, em_cac_sched_t::get_cac_ms(op, ch));
+            }
+        }
+    }
+    if (cac_ms == 0) {
+        return true;
+    }
+
+    switch (sched->admit(dm->get_agent_al_interface_mac(), get_radio_interface_mac(), cac_ms, now)) {
+        case em_cac_admit_started:
+            m_cac_admitted = true;
+            return true;
+
+        case em_cac_admit_refused:
+            em_printfout("radio %s waited too long for a CAC, uncleared DFS channels not offered",
+                util::mac_to_string(get_radio_interface_mac()).c_str());
+            return true;
+
+        default:
+            return false;
+    }
+}
+
 short em_channel_t::create_transmit_power_limit_tlv(unsigned char *buff)
 {
     short len = 0;
@@ -274,20 +404,15 @@ int em_channel_t::send_channel_scan_request_msg()
 
 }
 
-short em_channel_t::create_channel_scan_res_tlv(unsigned char *buff, unsigned int index)
+short em_channel_t::create_channel_scan_res_tlv(unsigned char *buff, dm_scan_result_t *scan_res)
 {
 	unsigned char *tmp = buff, ssid_len, bw_len, i;
     short len = 0;
 	char date_time[EM_DATE_TIME_BUFF_SZ];
-    dm_easy_mesh_t *dm;
-	dm_scan_result_t *scan_res;
 	em_neighbor_t *nbr;
 	unsigned short param;
 	em_channel_scan_result_t *res = reinterpret_cast<em_channel_scan_result_t *> (buff);
 
-    dm = get_data_model();
-	scan_res = dm->get_scan_result(index);
-
 	memcpy(res->ruid, scan_res->m_scan_result.id.scanner_mac, sizeof(mac_address_t));
 	memcpy(&res->op_class, &scan_res->m_scan_result.id.op_class, sizeof(unsigned char));
 	memcpy(&res->channel, &scan_res->m_scan_result.id.channel, sizeof(unsigned char));
@@ -417,7 +542,7 @@ short em_channel_t::create_channel_scan_res_tlv(unsigned char *buff, unsigned in
 	}			
 
 	memcpy(tmp, &scan_res->m_scan_result.aggr_scan_duration, sizeof(unsigned int));
-	len += static_cast<short unsigned int> (sizeof(unsigned char));
+	len += static_cast<short unsigned int> (sizeof(unsigned int));
 	tmp += sizeof(unsigned int);
 	
 	memcpy(tmp, &scan_res->m_scan_result.scan_type, sizeof(unsigned char));
@@ -428,105 +553,83 @@ short em_channel_t::create_channel_scan_res_tlv(unsigned char *buff, unsigned in
 }
 
 
-int em_channel_t::send_channel_scan_report_msg(unsigned int *last_index)
+int em_channel_t::send_channel_scan_report_msg(dm_scan_result_t **next)
 {
-    unsigned char buff[MAX_EM_BUFF_SZ];
-    unsigned short  msg_type = em_msg_type_channel_scan_rprt;
-    unsigned int len = 0;
-    em_cmdu_t *cmdu;
-    em_tlv_t *tlv;
-    short sz = 0;
-    unsigned char *tmp = buff;
-    unsigned short type = htons(ETH_P_1905);
+    em_tlv_writer_t *writer = get_tlv_writer();
+    unsigned char *frames[EM_TLV_WRITER_MAX_FRAGS];
+    unsigned int lens[EM_TLV_WRITER_MAX_FRAGS];
 	char date_time[EM_DATE_TIME_BUFF_SZ];
-    dm_easy_mesh_t *dm;
-	unsigned int i, start_idx = *last_index;
-	unsigned char time_len;
-
-    dm = get_data_model();
-
-    memcpy(tmp, dm->get_ctl_mac(), sizeof(mac_address_t));
-    tmp += sizeof(mac_address_t);
-    len += sizeof(mac_address_t);
-
-    memcpy(tmp, dm->get_agent_al_interface_mac(), sizeof(mac_address_t));
-    tmp += sizeof(mac_address_t);
-    len += sizeof(mac_address_t);
-
-    memcpy(tmp, reinterpret_cast<unsigned char *> (&type), sizeof(unsigned short));
-    tmp += sizeof(unsigned short);
-    len += sizeof(unsigned short);
-
-    cmdu = reinterpret_cast<em_cmdu_t *> (tmp);
-
-    memset(tmp, 0, sizeof(em_cmdu_t));
-    cmdu->type = htons(msg_type);
-    cmdu->id = htons(get_mgr()->get_next_msg_id());
-    cmdu->last_frag_ind = 1;
-    cmdu->relay_ind = 0;
+    dm_easy_mesh_t *dm = get_data_model();
+	dm_scan_result_t *scan_res = *next;
+	unsigned char *tmp;
+	unsigned int i, time_len, num_results = 0;
+	int num, len = 0;
+	unsigned long long now = em_timer_wheel_t::get_time_ms();
 
-    tmp += sizeof(em_cmdu_t);
-    len += sizeof(em_cmdu_t);
+    writer->begin(dm->get_ctl_mac(), dm->get_agent_al_interface_mac(), em_msg_type_channel_scan_rprt, get_mgr()->get_next_msg_id());
 
     // One Timestamp TLV (see section 17.2.41).
-    tlv = reinterpret_cast<em_tlv_t *> (tmp);
-    tlv->type = em_tlv_type_timestamp;
 	util::get_date_time_rfc3399(date_time, sizeof(date_time));
-	sz = static_cast<short int> (strlen(date_time) + 1);
-	time_len = static_cast<unsigned char> (strlen(date_time));
-	memcpy(tlv->value, &time_len, sizeof(unsigned char));
-	memcpy(tlv->value + 1, date_time, static_cast<size_t> (sz));
-    tlv->len = htons(static_cast<short unsigned int> (sz));
-
-    tmp += (sizeof(em_tlv_t) + static_cast<short unsigned int> (sz));
-    len += static_cast<unsigned int> (sizeof(em_tlv_t) + static_cast<short unsigned int> (sz));
-
-    // One or more Channel Scan Result TLVs (see section 17.2.40).
-	for (i = start_idx; i < dm->get_num_scan_results(); i++) {
-    	tlv = reinterpret_cast<em_tlv_t *> (tmp);
-    	tlv->type = em_tlv_type_channel_scan_rslt;
-    	sz = create_channel_scan_res_tlv(tlv->value, i);
-    	tlv->len = htons(static_cast<short unsigned int> (sz));
-
-    	tmp += (sizeof(em_tlv_t) + static_cast<short unsigned int> (sz));
-    	len += static_cast<unsigned int> (sizeof(em_tlv_t) + static_cast<short unsigned int> (sz));
+	time_len = static_cast<unsigned int> (strlen(date_time));
+	if ((tmp = writer->open_tlv(em_tlv_type_timestamp)) != NULL) {
+		tmp[0] = static_cast<unsigned char> (time_len);
+		memcpy(tmp + 1, date_time, time_len);
+		writer->close_tlv(time_len + 1);
+	}
 
-		if (len > EM_MAX_CHANNEL_SCAN_RPRT_MSG_LEN) {
-			break;	
+    // One or more Channel Scan Result TLVs (see section 17.2.40), each frame filled before the next one starts
+	// unchanged results are left out, the controller keeps what it was last sent
+	while ((scan_res != NULL) && (writer->get_frame_count() < EM_CHANNEL_SCAN_RPRT_MAX_FRAGS)) {
+		if ((m_scan_diff.is_changed(&scan_res->m_scan_result, now) == true) &&
+				((tmp = writer->open_tlv(em_tlv_type_channel_scan_rslt)) != NULL)) {
+			writer->close_tlv(static_cast<unsigned int> (create_channel_scan_res_tlv(tmp, scan_res)));
+			m_scan_diff.reported(&scan_res->m_scan_result, now);
+			num_results++;
 		}
+		scan_res = static_cast<dm_scan_result_t *> (dm->m_scan_result_map->get_next(scan_res));
 	}
-	
-	*last_index = i + 1;
+
+	// the message needs one Channel Scan Result TLV
+	if ((num_results == 0) && (*next != NULL) && ((tmp = writer->open_tlv(em_tlv_type_channel_scan_rslt)) != NULL)) {
+		writer->close_tlv(static_cast<unsigned int> (create_channel_scan_res_tlv(tmp, *next)));
+		m_scan_diff.reported(&(*next)->m_scan_result, now);
+		num_results++;
+	}
+	*next = scan_res;
 
     // Zero or more MLD Structure TLV (see section 17.2.99)
 
     // End of message
-    tlv = reinterpret_cast<em_tlv_t *> (tmp);
-    tlv->type = em_tlv_type_eom;
-    tlv->len = 0;
-
-    tmp += (sizeof (em_tlv_t));
-    len += (sizeof (em_tlv_t));
-    //if (em_msg_t(em_msg_type_channel_scan_req, em_profile_type_3, buff, len).validate(errors) == 0) {
-        //printf("Channel Selection Request msg failed validation in tnx end\n");
-        //return -1;
-    //}
+    if (writer->finish() < 0) {
+        printf("%s:%d: Channel Scan Report build failed\n", __func__, __LINE__);
+        m_scan_diff.forget();
+        return -1;
+    }
 
-    if (send_frame(buff, len)  < 0) {
-        printf("%s:%d: Channel Selection Request msg failed, error:%d\n", __func__, __LINE__, errno);
+    num = static_cast<int> (writer->get_frames(frames, lens, EM_TLV_WRITER_MAX_FRAGS));
+    if (send_frames(frames, lens, static_cast<unsigned int> (num)) != num) {
+        printf("%s:%d: Channel Scan Report send failed, error:%d\n", __func__, __LINE__, errno);
+        // what was recorded as reported was not, the next report carries everything
+        m_scan_diff.forget();
         return -1;
     }
 
-    set_state(em_state_ctrl_configured);
+    for (i = 0; i < static_cast<unsigned int> (num); i++) {
+        len += static_cast<int> (lens[i]);
+    }
+    printf("%s:%d: Channel Scan Report with %u results in %d frames sent, %llu unchanged left out so far\n", __func__, __LINE__,
+            num_results, num, m_scan_diff.get_stats().suppressed);
 
-    return static_cast<int> (len);
+    set_state(em_state_ctrl_configured);
 
+    return len;
 }
 
 short em_channel_t::create_spatial_reuse_req_tlv(unsigned char *buff)
 {
     short len = 0;
     em_spatial_reuse_req_t *spatial_reuse_req;
+    em_color_plan_t plan;
 
     spatial_reuse_req = reinterpret_cast<em_spatial_reuse_req_t *> (buff);
     memcpy(spatial_reuse_req->ruid, get_radio_interface_mac(), sizeof(mac_address_t));
@@ -544,6 +647,17 @@ short em_channel_t::create_spatial_reuse_req_tlv(unsigned char *buff)
     memcpy(spatial_reuse_req->srg_bss_color_bitmap, radio_info->srg_bss_color_bitmap, sizeof(spatial_reuse_req->srg_bss_color_bitmap));
     memcpy(spatial_reuse_req->srg_partial_bssid_bitmap, radio_info->srg_partial_bssid_bitmap, sizeof(spatial_reuse_req->srg_partial_bssid_bitmap));
 
+    // the color planned for the radio and its spatial reuse group, once it has reported
+    if ((get_service_type() == em_service_type_ctrl) &&
+            (get_mgr()->get_color_planner()->get_plan(get_radio_interface_mac(), &plan) == true)) {
+        spatial_reuse_req->bss_color = plan.color;
+        if (plan.srg_valid == true) {
+            spatial_reuse_req->srg_info_valid = 1;
+            memcpy(spatial_reuse_req->srg_bss_color_bitmap, plan.srg_color_bitmap, sizeof(spatial_reuse_req->srg_bss_color_bitmap));
+            memcpy(spatial_reuse_req->srg_partial_bssid_bitmap, plan.srg_bssid_bitmap, sizeof(spatial_reuse_req->srg_partial_bssid_bitmap));
+        }
+    }
+
     len += static_cast<short unsigned int> (sizeof(em_spatial_reuse_req_t));
 
     return len;
@@ -660,13 +774,16 @@ int em_channel_t::send_channel_sel_response_msg(em_chan_sel_resp_code_type_t cod
 
     dm = get_data_model();
 
-    memcpy(tmp, dm->get_ctl_mac(), sizeof(mac_address_t));
-    tmp += sizeof(mac_address_t);
-    len += sizeof(mac_address_t);
-
-    memcpy(tmp, dm->get_agent_al_interface_mac(), sizeof(mac_address_t));
-	tmp += sizeof(mac_address_t);
-    len += sizeof(mac_address_t);
+    // the controller sends it to ask the agent for its inquiry
+    if (get_service_type() == em_service_type_ctrl) {
+        memcpy(tmp, dm->get_agent_al_interface_mac(), sizeof(mac_address_t));
+        memcpy(tmp + sizeof(mac_address_t), dm->get_ctrl_al_interface_mac(), sizeof(mac_address_t));
+    } else {
+        memcpy(tmp, dm->get_ctl_mac(), sizeof(mac_address_t));
+        memcpy(tmp + sizeof(mac_address_t), dm->get_agent_al_interface_mac(), sizeof(mac_address_t));
+    }
+    tmp += 2 * sizeof(mac_address_t);
+    len += 2 * sizeof(mac_address_t);
 
     memcpy(tmp, reinterpret_cast<unsigned char *> (&type), sizeof(unsigned short));
     tmp += sizeof(unsigned short);
@@ -1334,40 +1451,140 @@ int em_channel_t::send_available_spectrum_inquiry_msg()
 
 }
 
+int em_channel_t::set_spectrum_location(unsigned char *buff, unsigned int len)
+{
+    cJSON *req, *center, *lat, *lon;
+
+    // the center of the location of the first inquiry, see the AFC system to device interface
+    scoped_cjson root(cJSON_ParseWithLength(reinterpret_cast<const char *> (buff), len));
+    req = cJSON_GetArrayItem(cJSON_GetObjectItem(root.get(), "availableSpectrumInquiryRequests"), 0);
+    center = cJSON_GetObjectItem(cJSON_GetObjectItem(cJSON_GetObjectItem(req, "location"), "ellipse"), "center");
+    lat = cJSON_GetObjectItem(center, "latitude");
+    lon = cJSON_GetObjectItem(center, "longitude");
+    if ((cJSON_IsNumber(lat) == false) || (cJSON_IsNumber(lon) == false)) {
+        return -1;
+    }
+
+    return get_mgr()->get_spectrum_cache()->set_location(get_data_model()->get_agent_al_interface_mac(),
+        lat->valuedouble, lon->valuedouble);
+}
+
+int em_channel_t::put_spectrum_response(unsigned char *buff, unsigned int len, unsigned long long now)
+{
+    em_spectrum_cache_t *cache = get_mgr()->get_spectrum_cache();
+    em_spectrum_channel_t channels[EM_MAX_CHANNELS_IN_LIST];
+    cJSON *rsp, *code, *expire, *info, *op_class, *cfi, *eirp, *ch;
+    unsigned long long expire_ms;
+    unsigned int num;
+    int taken = 0;
+
+    scoped_cjson root(cJSON_ParseWithLength(reinterpret_cast<const char *> (buff), len));
+    rsp = cJSON_GetArrayItem(cJSON_GetObjectItem(root.get(), "availableSpectrumInquiryResponses"), 0);
+    code = cJSON_GetObjectItem(cJSON_GetObjectItem(rsp, "response"), "responseCode");
+    expire = cJSON_GetObjectItem(rsp, "availabilityExpireTime");
+    if ((cJSON_IsNumber(code) == false) || (code->valueint != 0) || (cJSON_IsString(expire) == false) ||
+            (em_spectrum_cache_t::parse_expire_time(expire->valuestring, time(NULL), now, &expire_ms) != 0)) {
+        return -1;
+    }
+
+    info = cJSON_GetObjectItem(rsp, "availableChannelInfo");
+    cJSON_ArrayForEach(op_class, info) {
+        cfi = cJSON_GetObjectItem(op_class, "channelCfi");
+        eirp = cJSON_GetObjectItem(op_class, "maxEirp");
+        if ((cJSON_IsNumber(cJSON_GetObjectItem(op_class, "globalOperatingClass")) == false) || (cJSON_IsArray(cfi) == false)) {
+            continue;
+        }
+
+        // maxEirp goes along channelCfi, one value per channel
+        eirp = (cJSON_IsArray(eirp) == true) ? eirp->child:NULL;
+        num = 0;
+        cJSON_ArrayForEach(ch, cfi) {
+            if ((num < EM_MAX_CHANNELS_IN_LIST) && (cJSON_IsNumber(ch) == true)) {
+                channels[num].channel = static_cast<unsigned char> (ch->valueint);
+                channels[num].max_eirp = ((eirp != NULL) && (cJSON_IsNumber(eirp) == true)) ?
+                    static_cast<signed char> (std::min(std::max(eirp->valuedouble, -128.0), 127.0)):0;
+                num++;
+            }
+            eirp = (eirp != NULL) ? eirp->next:NULL;
+        }
+        cache->put(get_data_model()->get_agent_al_interface_mac(),
+            static_cast<unsigned char> (cJSON_GetObjectItem(op_class, "globalOperatingClass")->valueint), channels, num, expire_ms, now);
+        taken++;
+    }
+
+    return taken;
+}
+
+int em_channel_t::handle_avail_spectrum_inquiry(unsigned char *buff, unsigned int len)
+{
+    em_tlv_t    *tlv;
+    int tlv_len, taken = -1;
+    unsigned long long now = em_timer_wheel_t::get_time_ms();
+
+    tlv = reinterpret_cast<em_tlv_t *> (buff + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
+    tlv_len = static_cast<int> (len - (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)));
+
+    // the request has the location, it comes before the response
+    while ((tlv_len >= static_cast<int> (sizeof(em_tlv_t))) && (tlv->type != em_tlv_type_eom) &&
+            (static_cast<int> (sizeof(em_tlv_t) + htons(tlv->len)) <= tlv_len)) {
+        if (tlv->type == em_tlv_type_avail_spectrum_inquiry_reg) {
+            set_spectrum_location(tlv->value, htons(tlv->len));
+        } else if (tlv->type == em_tlv_type_avail_spectrum_inquiry_rsp) {
+            taken = put_spectrum_response(tlv->value, htons(tlv->len), now);
+        }
+
+        tlv_len -= static_cast<int> (sizeof(em_tlv_t) + htons(tlv->len));
+        tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
+    }
+
+    get_mgr()->get_spectrum_cache()->end_inquiry(get_data_model()->get_agent_al_interface_mac(), (taken > 0), now);
+
+    return 0;
+}
+
 int em_channel_t::handle_op_channel_report(unsigned char *buff, unsigned int len)
 {
     dm_easy_mesh_t *dm;
-    unsigned int i = 0, found = 0;
-    em_op_class_info_t  *op_class_info;
+    em_op_class_info_t  op_class_info;
     em_op_channel_rprt_t *rpt = reinterpret_cast<em_op_channel_rprt_t *> (buff);
+    em_optimiser_radio_t radio;
+    unsigned int i, tx_power_off;
     dm = get_data_model();
 
-    for (i = 0; i < dm->m_num_opclass; i++) {
-        op_class_info = &dm->m_op_class[i].m_op_class_info;
-        if (((memcmp(op_class_info->id.ruid, get_radio_interface_mac(), sizeof(mac_address_t)) == 0) &&
-                    (op_class_info->id.type == em_op_class_type_current)) == true) {
-            op_class_info->op_class = static_cast<unsigned int> (rpt->op_classes[0].op_class);
-            op_class_info->channel = static_cast<unsigned int> (rpt->op_classes[0].channel);
-            found++;
-        }
+    // the current operating class of the radio, whatever class it was reported in before
+    memset(&op_class_info, 0, sizeof(em_op_class_info_t));
+    op_class_info.id.type = em_op_class_type_current;
+    memcpy(op_class_info.id.ruid, get_radio_interface_mac(), sizeof(mac_address_t));
+    op_class_info.op_class = static_cast<unsigned int> (rpt->op_classes[0].op_class);
+    op_class_info.id.op_class = op_class_info.op_class;
+    op_class_info.channel = static_cast<unsigned int> (rpt->op_classes[0].channel);
+    dm->apply_op_classes(&op_class_info, 1, false);
+
+    // the optimisation plugins follow the operating channel, and learn the BSSs the scans of other radios hear
+    memset(&radio, 0, sizeof(em_optimiser_radio_t));
+    memcpy(radio.ruid, get_radio_interface_mac(), sizeof(mac_address_t));
+    radio.op_class = rpt->op_classes[0].op_class;
+    radio.current = rpt->op_classes[0].channel;
+    tx_power_off = static_cast<unsigned int> (sizeof(em_op_channel_rprt_t) + rpt->op_classes_num * sizeof(em_op_class_ch_rprt_t));
+    if (tx_power_off < len) {
+        radio.tx_power = static_cast<signed char> (buff[tx_power_off]);
     }
-    if (found == 0) {
-        op_class_info = &dm->m_op_class[dm->get_num_op_class()].m_op_class_info;
-        op_class_info->id.type = em_op_class_type_current;
-        memcpy(op_class_info->id.ruid, get_radio_interface_mac(), sizeof(mac_address_t));
-        op_class_info->op_class = static_cast<unsigned int> (rpt->op_classes[0].op_class);
-        op_class_info->id.op_class = op_class_info->op_class;
-        op_class_info->channel = static_cast<unsigned int> (rpt->op_classes[0].channel);
-        dm->set_num_op_class(dm->get_num_op_class() + 1);
-        dm->set_db_cfg_param(db_cfg_type_op_class_list_update, "");
-        dm->set_db_cfg_param(db_cfg_type_radio_list_update, "");
+    get_mgr()->get_optimiser()->radio_changed(&radio);
+    for (i = 0; i < dm->get_num_bss(); i++) {
+        if (memcmp(dm->m_bss[i].m_bss_info.ruid.mac, get_radio_interface_mac(), sizeof(mac_address_t)) == 0) {
+            get_mgr()->get_optimiser()->bss_added(dm->m_bss[i].m_bss_info.bssid.mac, get_radio_interface_mac());
+        }
     }
+
     return 0;
 }
 
 int em_channel_t::handle_spatial_reuse_report(unsigned char *buff, unsigned int len)
 {
     dm_easy_mesh_t *dm;
+    em_op_class_info_t *op_class = NULL;
+    em_color_planner_t *planner;
+    unsigned int i;
     em_spatial_reuse_rprt_t *rpt = reinterpret_cast<em_spatial_reuse_rprt_t *> (buff);
     dm = get_data_model();
 
@@ -1386,6 +1603,29 @@ int em_channel_t::handle_spatial_reuse_report(unsigned char *buff, unsigned int
     memcpy(radio_info->srg_partial_bssid_bitmap, rpt->srg_partial_bssid_bitmap, sizeof(radio_info->srg_partial_bssid_bitmap));
     memcpy(radio_info->neigh_bss_color_in_use_bitmap, rpt->neigh_bss_color_in_use_bitmap, sizeof(radio_info->neigh_bss_color_in_use_bitmap));
 
+    // the Operating Channel Report before it in the message has set the current channel
+    for (i = 0; i < dm->get_num_op_class(); i++) {
+        op_class = dm->get_op_class_info(i);
+        if ((op_class->id.type == em_op_class_type_current) &&
+                (memcmp(op_class->id.ruid, get_radio_interface_mac(), sizeof(mac_address_t)) == 0)) {
+            break;
+        }
+    }
+    if (i == dm->get_num_op_class()) {
+        return 0;
+    }
+
+    planner = get_mgr()->get_color_planner();
+    for (i = 0; i < dm->get_num_bss(); i++) {
+        if (memcmp(dm->m_bss[i].m_bss_info.ruid.mac, get_radio_interface_mac(), sizeof(mac_address_t)) == 0) {
+            planner->add_bss(dm->m_bss[i].m_bss_info.bssid.mac, get_radio_interface_mac());
+        }
+    }
+    if (planner->set_report(get_radio_interface_mac(), static_cast<unsigned char> (op_class->op_class),
+            static_cast<unsigned char> (op_class->channel), rpt->bss_color, rpt->neigh_bss_color_in_use_bitmap) == true) {
+        planner->plan(false);
+    }
+
     return 0;
 }
 
@@ -1394,55 +1634,67 @@ int em_channel_t::handle_channel_pref_tlv_ctrl(unsigned char *buff, unsigned int
 {
     em_channel_pref_t   *pref = reinterpret_cast<em_channel_pref_t *> (buff);
     em_channel_pref_op_class_t *channel_pref;
-    unsigned int i = 0, j = 0;
-	bool match_found = false;
+    unsigned int i = 0, j = 0, num, changed;
     em_op_class_info_t      op_class_info[EM_MAX_OP_CLASS];
-    em_op_class_info_t *pop_class_info;
+    em_op_class_info_t *current;
+    em_optimiser_radio_t radio;
+    unsigned char pref_bits;
     dm_easy_mesh_t *dm;
 
     dm = get_data_model();
     em_device_info_t    *device = dm->get_device_info();
 
+	// the channels of the current operating class of the radio go to the optimisation plugins
+	memset(&radio, 0, sizeof(em_optimiser_radio_t));
+	memcpy(radio.ruid, pref->ruid, sizeof(mac_address_t));
+	for (i = 0; i < dm->get_num_op_class(); i++) {
+		current = dm->get_op_class_info(i);
+		if ((current->id.type == em_op_class_type_current) && (memcmp(current->id.ruid, pref->ruid, sizeof(mac_address_t)) == 0)) {
+			radio.op_class = static_cast<unsigned char> (current->op_class);
+			radio.current = static_cast<unsigned char> (current->channel);
+			break;
+		}
+	}
+
+	num = (pref->op_classes_num > EM_MAX_OP_CLASS) ? EM_MAX_OP_CLASS:pref->op_classes_num;
 	channel_pref = pref->op_classes;
-	memcpy(op_class_info[i].id.ruid, pref->ruid, sizeof(mac_address_t));
-	for (i = 0; i < pref->op_classes_num; i++) {
+	for (i = 0; i < num; i++) {
 		memset(&op_class_info[i], 0, sizeof(em_op_class_info_t));
 		memcpy(op_class_info[i].id.ruid, device->intf.mac, sizeof(mac_address_t));
 		op_class_info[i].id.type = em_op_class_type_preference;
 		op_class_info[i].op_class = static_cast<unsigned int> (channel_pref->op_class);
 		op_class_info[i].id.op_class = op_class_info[i].op_class;
-		op_class_info[i].num_channels = static_cast<unsigned int> (channel_pref->num);
+		op_class_info[i].num_channels = (channel_pref->num > EM_MAX_CHANNELS_IN_LIST) ? EM_MAX_CHANNELS_IN_LIST:channel_pref->num;
 		for (j = 0; j < op_class_info[i].num_channels; j++) {
 			op_class_info[i].channels[j] = static_cast<unsigned int > (channel_pref->channels.channel[j]);
 		}
+		// preference in the high nibble of the octet after the channels
+		pref_bits = channel_pref->channels.channel[channel_pref->num];
+		if ((radio.op_class != 0) && (channel_pref->op_class == radio.op_class)) {
+			for (j = 0; (j < channel_pref->num) && (radio.num_channels < EM_OPTIMISER_MAX_CHANNELS); j++) {
+				radio.channels[radio.num_channels] = channel_pref->channels.channel[j];
+				radio.prefs[radio.num_channels++] = static_cast<unsigned char> (pref_bits >> 4);
+			}
+		}
 		channel_pref = reinterpret_cast<em_channel_pref_op_class_t *> (reinterpret_cast<unsigned char *> (channel_pref) + sizeof(em_channel_pref_op_class_t) +
-				op_class_info[i].num_channels + sizeof(unsigned char));
+				channel_pref->num + sizeof(unsigned char));
 		//printf("%s:%d op class: %d\tAnticipated Channels: %d\n", __func__, __LINE__, 
 				//op_class_info[i].op_class, op_class_info[i].num_anticipated_channels);
 	}
-	
-	for (i = 0; i < pref->op_classes_num; i++) {
-		for (j = 0; j < dm->get_num_op_class(); j++) {
-			pop_class_info = &dm->m_op_class[j].m_op_class_info;
-
-			if ((memcmp(pop_class_info->id.ruid, op_class_info[i].id.ruid, sizeof(mac_address_t)) == 0) &&
-						(pop_class_info->id.type == op_class_info[i].id.type) &&
-						(pop_class_info->id.op_class == op_class_info[i].id.op_class)) {
-				match_found = true;
-				break;
-			}
-		}
 
-		if (match_found == true) {
-			match_found = false;
-			continue;
+	// the whole TLV at once, only the changed operating classes are written to the DB
+	if ((changed = dm->apply_op_classes(op_class_info, num)) > 0) {
+		printf("%s:%d: %u of %u preference operating classes changed\n", __func__, __LINE__, changed, num);
+	}
+
+	// a channel left out of the report has the highest preference
+	if (radio.op_class != 0) {
+		for (j = 0; (j < radio.num_channels) && (radio.channels[j] != radio.current); j++);
+		if ((j == radio.num_channels) && (radio.num_channels < EM_OPTIMISER_MAX_CHANNELS)) {
+			radio.channels[radio.num_channels] = radio.current;
+			radio.prefs[radio.num_channels++] = EM_OPTIMISER_MAX_PREF;
 		}
-		
-		pop_class_info = &dm->m_op_class[dm->get_num_op_class()].m_op_class_info;
-		memcpy(pop_class_info, &op_class_info[i], sizeof(em_op_class_info_t));
-		dm->set_num_op_class(dm->get_num_op_class() + 1);
-		dm->set_db_cfg_param(db_cfg_type_op_class_list_update, "");
-		dm->set_db_cfg_param(db_cfg_type_radio_list_update, "");
+		get_mgr()->get_optimiser()->radio_changed(&radio);
 	}
 
     return 0;
@@ -1537,10 +1789,18 @@ int em_channel_t::handle_channel_pref_rprt(unsigned char *buff, unsigned int len
     tlv = reinterpret_cast<em_tlv_t *> (buff + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
     tlv_len = static_cast<int> (len - (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)));
 
-    while ((tlv->type != em_tlv_type_eom) && (len > 0)) {
+    while ((tlv->type != em_tlv_type_eom) && (tlv_len > 0)) {
         if (tlv->type == em_tlv_type_channel_pref) {
             handle_channel_pref_tlv_ctrl(tlv->value, htons(tlv->len));
         }
+        if (tlv->type == em_tlv_type_cac_sts_rprt) {
+            get_mgr()->get_cac_sched()->handle_status_report(get_data_model()->get_agent_al_interface_mac(),
+                tlv->value, htons(tlv->len), em_timer_wheel_t::get_time_ms());
+        }
+        if (tlv->type == em_tlv_type_cac_cmpltn_rprt) {
+            get_mgr()->get_cac_sched()->handle_completion_report(get_data_model()->get_agent_al_interface_mac(),
+                tlv->value, htons(tlv->len), em_timer_wheel_t::get_time_ms());
+        }
         if (tlv->type == em_tlv_eht_operations) {
             handle_eht_operations_tlv_ctrl(tlv->value, htons(tlv->len));
             break;
@@ -1578,6 +1838,11 @@ int em_channel_t::handle_channel_pref_tlv(unsigned char *buff, op_class_channel_
 
 		op_class->num = 1;
 		for (i = 0; i < pref->op_classes_num; i++) {
+			// the first channel of the class is the one configured
+			if ((op_class_info[i].num_channels > 0) && (get_data_model()->is_channel_allowed(pref->ruid,
+					op_class_info[i].op_class, op_class_info[i].channels[0]) == false)) {
+				continue;
+			}
 			if (get_band() == (dm_easy_mesh_t::get_freq_band_by_op_class(static_cast<int> (op_class_info[i].op_class)))) {
 				memcpy(&op_class->op_class_info[0], &op_class_info[i], sizeof(em_op_class_info_t));
 				//printf("%s:%d Received channel selection request op_class=%d \n",__func__, __LINE__,op_class_info[i].op_class);
@@ -1845,6 +2110,7 @@ void em_channel_t::fill_scan_result(dm_scan_result_t *scan_res, em_channel_scan_
     memcpy(&scan_res->m_scan_result.scan_type, tmp, sizeof(unsigned char));
     tmp += sizeof(unsigned char);
 
+	scan_res->reindex_neighbors();
 }
 
 int em_channel_t::handle_channel_scan_rprt(unsigned char *buff, unsigned int len)
@@ -1872,11 +2138,17 @@ int em_channel_t::handle_channel_scan_rprt(unsigned char *buff, unsigned int len
             id.channel = res->channel;
 			id.scanner_type = em_scanner_type_radio;
 
+			// the manager ages the results out from its own thread
+			get_mgr()->lock_scan_results();
 			if ((scan_res = dm->find_matching_scan_result(&id)) == NULL) {
 				scan_res = dm->create_new_scan_result(&id);
 			}
 
 			fill_scan_result(scan_res, res);
+			scan_res->touch();
+			get_mgr()->get_color_planner()->add_scan_result(&scan_res->m_scan_result);
+			get_mgr()->get_optimiser()->scan_result(&scan_res->m_scan_result);
+			get_mgr()->unlock_scan_results();
 		}
 
         if (tlv->type == em_tlv_type_timestamp) {
@@ -1941,6 +2213,8 @@ void em_channel_t::process_msg(unsigned char *data, unsigned int len)
         case em_msg_type_avail_spectrum_inquiry:
             if (get_service_type() == em_service_type_agent) {
                 send_available_spectrum_inquiry_msg();
+            } else if (get_service_type() == em_service_type_ctrl) {
+                handle_avail_spectrum_inquiry(data, len);
             }
             break;
 
@@ -1963,7 +2237,7 @@ void em_channel_t::process_msg(unsigned char *data, unsigned int len)
 
 void em_channel_t::process_state()
 {
-	unsigned int last_index = 0;
+	dm_scan_result_t *scan_res;
 	dm_easy_mesh_t *dm;
 
     switch (get_state()) {
@@ -2006,8 +2280,11 @@ void em_channel_t::process_state()
 		case em_state_agent_channel_scan_result_pending:
             if (get_service_type() == em_service_type_agent) {
 				dm = get_data_model();
-				while (last_index < dm->get_num_scan_results()) {
-                	send_channel_scan_report_msg(&last_index);
+				scan_res = static_cast<dm_scan_result_t *> (dm->m_scan_result_map->get_first());
+				while (scan_res != NULL) {
+                	if (send_channel_scan_report_msg(&scan_res) < 0) {
+						break;
+					}
 				}
                 set_state(em_state_agent_configured);
             }
@@ -2049,7 +2326,9 @@ void em_channel_t::process_ctrl_state()
 
         case em_state_ctrl_channel_select_pending:
         case em_state_ctrl_avail_spectrum_inquiry_pending:
-			if(get_service_type() == em_service_type_ctrl) {
+			// held while the 6 GHz spectrum is inquired or the neighboring agents run their CACs,
+			// tried again on the next deadline of the state
+			if ((get_service_type() == em_service_type_ctrl) && (query_spectrum() == true) && (admit_cac() == true)) {
 				send_channel_sel_request_msg();
 			}
             break; 
@@ -2067,6 +2346,7 @@ em_channel_t::em_channel_t()
 {
     m_channel_pref_query_tx_cnt = 0;
     m_channel_sel_req_tx_cnt = 0;
+    m_cac_admitted = false;
 }
 
 em_channel_t::~em_channel_t()
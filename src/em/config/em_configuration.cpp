@@ -20,6 +20,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <limits.h>
 #include <assert.h>
 #include <signal.h>
 #include <unistd.h>
@@ -34,6 +35,7 @@
 #include <sys/socket.h>
 #include <sys/uio.h>
 #include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 #include <pthread.h>
 #include <openssl/rand.h>
@@ -72,19 +74,17 @@ unsigned short em_configuration_t::create_client_assoc_event_tlv(unsigned char *
     unsigned char *tmp;
     unsigned char joined = (assoc == true)?0x80:0x00;
     bool found_assoc_sta_mld = false;
-    unsigned int i;
+    em_assoc_sta_mld_info_t *assoc_sta_mld_info;
 
     tmp = buff;
 
     dm_easy_mesh_t *dm = get_data_model();
 
-    for (i = 0; i < dm->get_num_assoc_sta_mld(); i++) {
-        em_assoc_sta_mld_info_t& assoc_sta_mld_info = dm->m_assoc_sta_mld[i].m_assoc_sta_mld_info;
-        if (memcmp(assoc_sta_mld_info.mac_addr, sta, sizeof(mac_address_t) == 0)) {
-            found_assoc_sta_mld = true;
-            memcpy(tmp, assoc_sta_mld_info.mac_addr, sizeof(mac_address_t));
-            memcpy(tmp + sizeof(mac_address_t), assoc_sta_mld_info.ap_mld_mac_addr, sizeof(mac_address_t));
-        }
+    // the STA is reported as its MLD when it is one
+    if ((assoc_sta_mld_info = dm->find_assoc_sta_mld(sta)) != NULL) {
+        found_assoc_sta_mld = true;
+        memcpy(tmp, assoc_sta_mld_info->mac_addr, sizeof(mac_address_t));
+        memcpy(tmp + sizeof(mac_address_t), assoc_sta_mld_info->ap_mld_mac_addr, sizeof(mac_address_t));
     }
 
     if (!found_assoc_sta_mld) {
@@ -99,10 +99,67 @@ unsigned short em_configuration_t::create_client_assoc_event_tlv(unsigned char *
 }
 
 int em_configuration_t::send_topology_notification_by_client(mac_address_t sta, bssid_t bssid, bool assoc)
+{
+    em_topo_notif_event_t event;
+
+    memcpy(event.sta, sta, sizeof(mac_address_t));
+    memcpy(event.bssid, bssid, sizeof(bssid_t));
+    event.assoc = assoc;
+
+    return send_topology_notification(&event, 1);
+}
+
+void em_configuration_t::queue_topology_notification(mac_address_t sta, bssid_t bssid, bool assoc)
+{
+    em_topo_notif_event_t *event;
+    unsigned int i;
+
+    for (i = 0; i < m_num_topo_notif_events; i++) {
+        event = &m_topo_notif_events[i];
+        if ((memcmp(event->sta, sta, sizeof(mac_address_t)) == 0) && (memcmp(event->bssid, bssid, sizeof(bssid_t)) == 0)) {
+            event->assoc = assoc;
+            return;
+        }
+    }
+
+    if (m_num_topo_notif_events == EM_TOPO_NOTIF_MAX_EVENTS) {
+        flush_topology_notifications(true);
+    }
+
+    event = &m_topo_notif_events[m_num_topo_notif_events++];
+    memcpy(event->sta, sta, sizeof(mac_address_t));
+    memcpy(event->bssid, bssid, sizeof(bssid_t));
+    event->assoc = assoc;
+}
+
+unsigned int em_configuration_t::flush_topology_notifications(bool force)
+{
+    unsigned long long now = em_timer_wheel_t::get_time_ms();
+    unsigned int num = m_num_topo_notif_events;
+
+    if (num == 0) {
+        return 0;
+    }
+
+    if ((force == false) && (now - m_topo_notif_sent_ms < EM_TOPO_NOTIF_DEBOUNCE_MS)) {
+        return 0;
+    }
+
+    // the events are dropped on failure, the next STA list resends the state
+    if (send_topology_notification(m_topo_notif_events, num) > 0) {
+        printf("%s:%d: %u client events in one topology notification\n", __func__, __LINE__, num);
+    }
+    m_num_topo_notif_events = 0;
+    m_topo_notif_sent_ms = now;
+
+    return num;
+}
+
+int em_configuration_t::send_topology_notification(const em_topo_notif_event_t *events, unsigned int num)
 {
     unsigned short  msg_type = em_msg_type_topo_notif;
     char *errors[EM_MAX_TLV_MEMBERS] = {0};
-    unsigned int len = 0;
+    unsigned int len = 0, i;
     unsigned short sz;
     em_cmdu_t *cmdu;
     em_tlv_t *tlv;
@@ -110,9 +167,12 @@ int em_configuration_t::send_topology_notification_by_client(mac_address_t sta,
     unsigned char *tmp = buff;
     unsigned short type = htons(ETH_P_1905);
     mac_address_t   multi_addr = {0x01, 0x80, 0xc2, 0x00, 0x00, 0x13};
-    unsigned char joined = (assoc == true)?0x80:0x00;
     dm_easy_mesh_t *dm;
 
+    if ((num == 0) || (num > EM_TOPO_NOTIF_MAX_EVENTS)) {
+        return -1;
+    }
+
     dm = get_data_model();
 
     memcpy(tmp, reinterpret_cast<unsigned char *> (multi_addr), sizeof(mac_address_t));
@@ -147,14 +207,17 @@ int em_configuration_t::send_topology_notification_by_client(mac_address_t sta,
     tmp += (sizeof (em_tlv_t) + sizeof(mac_address_t));
     len += static_cast<unsigned int> (sizeof (em_tlv_t) + sizeof(mac_address_t));
 
-    // Client Association Event  17.2.20
-    tlv = reinterpret_cast<em_tlv_t *> (tmp);
-    tlv->type = em_tlv_type_client_assoc_event;
-    sz = create_client_assoc_event_tlv(tlv->value, sta, bssid, joined);
-    tlv->len =  htons(sz);
+    // Client Association Event  17.2.20, one per event
+    for (i = 0; i < num; i++) {
+        tlv = reinterpret_cast<em_tlv_t *> (tmp);
+        tlv->type = em_tlv_type_client_assoc_event;
+        sz = create_client_assoc_event_tlv(tlv->value, const_cast<unsigned char *> (events[i].sta),
+            const_cast<unsigned char *> (events[i].bssid), events[i].assoc);
+        tlv->len =  htons(sz);
 
-    tmp += (sizeof(em_tlv_t) + sz);
-    len += static_cast<unsigned int> (sizeof(em_tlv_t) + sz);
+        tmp += (sizeof(em_tlv_t) + sz);
+        len += static_cast<unsigned int> (sizeof(em_tlv_t) + sz);
+    }
 
     // End of message
     tlv = reinterpret_cast<em_tlv_t *> (tmp);
@@ -186,20 +249,28 @@ void em_configuration_t::handle_state_topology_notify()
 {
     dm_easy_mesh_t *dm;
     dm_sta_t *sta;
+    mac_addr_str_t sta_str;
 
     dm = get_current_cmd()->get_data_model();
 
-    sta = static_cast<dm_sta_t *>(hash_map_get_first(dm->m_sta_assoc_map));
+    sta = static_cast<dm_sta_t *>(dm->m_sta_assoc_map->get_first());
     while (sta != NULL) {
-        send_topology_notification_by_client(sta->m_sta_info.id, sta->m_sta_info.bssid, true);
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_assoc_map, sta));
+        // the bloom filter answers for the STAs that were never blocked
+        if (get_mgr()->get_blocklist()->is_blocked(sta->m_sta_info.id, sta->m_sta_info.bssid) == true) {
+            dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.id, sta_str);
+            printf("%s:%d: STA %s associated while blocked from its BSS\n", __func__, __LINE__, sta_str);
+        }
+        queue_topology_notification(sta->m_sta_info.id, sta->m_sta_info.bssid, true);
+        sta = static_cast<dm_sta_t *> (dm->m_sta_assoc_map->get_next(sta));
     }
 
-    sta = static_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_dassoc_map));
+    sta = static_cast<dm_sta_t *> (dm->m_sta_dassoc_map->get_first());
     while (sta != NULL) {
-        send_topology_notification_by_client(sta->m_sta_info.id, sta->m_sta_info.bssid, false);
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_dassoc_map, sta));
+        queue_topology_notification(sta->m_sta_info.id, sta->m_sta_info.bssid, false);
+        sta = static_cast<dm_sta_t *> (dm->m_sta_dassoc_map->get_next(sta));
     }
+    // sent now after a quiet window, else by proto_timeout once the window has passed
+    flush_topology_notifications();
     set_state(em_state_agent_configured);
 }
 
@@ -368,6 +439,83 @@ int em_configuration_t::send_topology_query_msg()
 	return static_cast<int> (len);
 }
 
+void em_configuration_t::send_requested_topology_query()
+{
+    dm_easy_mesh_t *dm = get_data_model();
+
+    if (m_topo_query_requested.exchange(false) == false) {
+        return;
+    }
+
+    // the onboarding of the radio sends its own queries, a scheduled one waits for it
+    if ((get_state() < em_state_ctrl_configured) || (get_state() == em_state_ctrl_misconfigured) ||
+            (send_topology_query_msg() < 0)) {
+        get_mgr()->get_topo_sched()->defer(dm->get_agent_al_interface_mac(), em_timer_wheel_t::get_time_ms());
+    }
+}
+
+void em_configuration_t::send_requested_tid_to_link_map_policy()
+{
+    unsigned char buff[MAX_EM_BUFF_SZ];
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    unsigned int len = 0;
+    em_cmdu_t *cmdu;
+    em_tlv_t *tlv;
+    unsigned short tlv_len;
+    unsigned char *tmp = buff;
+    unsigned short type = htons(ETH_P_1905);
+    dm_easy_mesh_t *dm = get_data_model();
+
+    if (m_t2lm_requested.load() == false) {
+        return;
+    }
+
+    memcpy(tmp, dm->get_agent_al_interface_mac(), sizeof(mac_address_t));
+    tmp += sizeof(mac_address_t);
+    len += static_cast<unsigned int> (sizeof(mac_address_t));
+
+    memcpy(tmp, dm->get_ctrl_al_interface_mac(), sizeof(mac_address_t));
+    tmp += sizeof(mac_address_t);
+    len += static_cast<unsigned int> (sizeof(mac_address_t));
+
+    memcpy(tmp, reinterpret_cast<unsigned char *> (&type), sizeof(unsigned short));
+    tmp += sizeof(unsigned short);
+    len += static_cast<unsigned int> (sizeof(unsigned short));
+
+    cmdu = reinterpret_cast<em_cmdu_t *> (tmp);
+    memset(tmp, 0, sizeof(em_cmdu_t));
+    cmdu->type = htons(em_msg_type_map_policy_config_req);
+    cmdu->id = htons(get_mgr()->get_next_msg_id());
+    cmdu->last_frag_ind = 1;
+    cmdu->relay_ind = 0;
+
+    tmp += sizeof(em_cmdu_t);
+    len += static_cast<unsigned int> (sizeof(em_cmdu_t));
+
+    // TID-to-Link Mapping Policy TLV 17.2.97, the only policy that changed
+    tlv_len = static_cast<unsigned short> (create_tid_to_link_map_policy_tlv(tmp));
+    tmp += (sizeof(em_tlv_t) + tlv_len);
+    len += static_cast<unsigned int> (sizeof(em_tlv_t) + tlv_len);
+
+    tlv = reinterpret_cast<em_tlv_t *> (tmp);
+    tlv->type = em_tlv_type_eom;
+    tlv->len = 0;
+    len += static_cast<unsigned int> (sizeof(em_tlv_t));
+
+    // the controller thread sets the next mappings once the flag is down
+    dm->m_tid_to_link.m_tid_to_link_info.num_mapping = 0;
+    m_t2lm_requested = false;
+
+    if (em_msg_t(em_msg_type_map_policy_config_req, em_profile_type_3, buff, len).validate(errors) == 0) {
+        printf("%s:%d: TID-to-link Policy Config Request validation failed\n", __func__, __LINE__);
+        return;
+    }
+    if (send_frame(buff, len) < 0) {
+        printf("%s:%d: TID-to-link Policy Config Request send failed, error:%d\n", __func__, __LINE__, errno);
+        return;
+    }
+}
+
 int em_configuration_t::create_operational_bss_tlv(unsigned char *buff)
 {
     em_tlv_t *tlv;
@@ -811,51 +959,6 @@ void em_configuration_t::print_ap_vendor_operational_bss_tlv(unsigned char *valu
 	}
 }
 
-void em_configuration_t::handle_ap_vendor_operational_bss(unsigned char *value, unsigned int len)
-{
-	mac_addr_str_t	rd_mac_str, bss_mac_str;
-	em_ap_vendor_op_bss_radio_t		   *radio;
-	em_ap_vendor_operational_bss_t *bss;
-	em_ap_vendor_op_bss_t *ap;
-	unsigned int i, j, all_bss_len = 0;
-	dm_bss_t *dm_bss;
-	dm_easy_mesh_t  *dm;
-	dm = get_data_model();
-	ap = reinterpret_cast<em_ap_vendor_op_bss_t *> (value);
-	radio = ap->radios;
-	em_printfout("Number of radios: %d", ap->radios_num);
-	for (i = 0; i < ap->radios_num; i++) {
-		dm_easy_mesh_t::macbytes_to_string(radio->ruid, rd_mac_str);
-		em_printfout("Radio: %s", rd_mac_str);
-		bss = radio->bss;
-		em_printfout("Number of bss: %d", radio->bss_num);
-		for (j = 0; j < radio->bss_num; j++) {
-			dm_easy_mesh_t::macbytes_to_string(bss->bssid, bss_mac_str);
-			em_printfout("BSSID=%s haul type=%d vap_mode:%d", bss_mac_str, bss->haultype, bss->vap_mode);
-			dm_bss = dm->get_bss(radio->ruid, bss->bssid);
-			if (dm_bss == NULL) {
-				dm_bss = &dm->m_bss[dm->m_num_bss];
-				dm->set_num_bss(dm->get_num_bss() + 1);
-			}
-			// fill up id first
-			strncpy(dm_bss->m_bss_info.id.net_id, dm->m_device.m_device_info.id.net_id, sizeof(em_long_string_t));
-			memcpy(dm_bss->m_bss_info.id.dev_mac, dm->m_device.m_device_info.intf.mac, sizeof(mac_address_t));
-			memcpy(dm_bss->m_bss_info.id.ruid, radio->ruid, sizeof(mac_address_t));
-			memcpy(dm_bss->m_bss_info.id.bssid, bss->bssid, sizeof(mac_address_t));
-			memcpy(dm_bss->m_bss_info.ruid.mac, radio->ruid, sizeof(mac_address_t));
-			memcpy(dm_bss->m_bss_info.bssid.mac, bss->bssid, sizeof(mac_address_t));
-			dm_bss->m_bss_info.id.haul_type = static_cast<em_haul_type_t> (bss->haultype);
-			dm_bss->m_bss_info.vap_mode = static_cast<em_vap_mode_t> (bss->vap_mode);
-
-			bss = reinterpret_cast<em_ap_vendor_operational_bss_t *>(reinterpret_cast<unsigned char *> (bss) + sizeof(em_ap_vendor_operational_bss_t));
-			all_bss_len += sizeof(em_ap_vendor_operational_bss_t);
-		}
-
-		radio = reinterpret_cast<em_ap_vendor_op_bss_radio_t *>(reinterpret_cast<unsigned char *> (radio) + sizeof(em_ap_vendor_op_bss_radio_t) + all_bss_len);
-		all_bss_len = 0;
-	}
-}
-
 int em_configuration_t::create_tid_to_link_map_policy_tlv(unsigned char *buff)
 {
     em_tlv_t *tlv;
@@ -863,8 +966,8 @@ int em_configuration_t::create_tid_to_link_map_policy_tlv(unsigned char *buff)
     em_tid_to_link_map_policy_t *tid_to_link_map_policy;
     em_tid_to_link_mapping_t *tid_to_link_mapping;
     dm_easy_mesh_t  *dm;
-    unsigned int i;
-    unsigned short tid_to_link_map_len = 0;
+    unsigned int i, tid, num_maps;
+    unsigned short tid_to_link_map_len = 0, mapping_len;
     unsigned short tlv_len = 0;
 
     dm = get_data_model();
@@ -893,10 +996,23 @@ int em_configuration_t::create_tid_to_link_map_policy_tlv(unsigned char *buff)
         tid_to_link_mapping->link_map_size = tid_to_link_map_info.link_map_size;
         tid_to_link_mapping->link_map_presence_ind = tid_to_link_map_info.link_map_presence_ind;
         memcpy(tid_to_link_mapping->expected_duration, tid_to_link_map_info.expected_dur, 3 * sizeof(unsigned char));
-        //TODO: tid_to_link_map
 
-        tid_to_link_mapping = reinterpret_cast<em_tid_to_link_mapping_t *> (reinterpret_cast<unsigned char *> (tid_to_link_mapping) + sizeof(em_tid_to_link_mapping_t));
-        tid_to_link_map_len += sizeof(em_tid_to_link_mapping_t);
+        // the data model has one map, sent for each TID of the presence indicator
+        num_maps = 0;
+        for (tid = 0; tid < 8; tid++) {
+            if ((tid_to_link_map_info.link_map_presence_ind & (1 << tid)) == 0) {
+                continue;
+            }
+            tid_to_link_mapping->tid_to_link_map[num_maps++] = tid_to_link_map_info.tid_to_link_map;
+            if (tid_to_link_map_info.link_map_size == false) {
+                // two octet map, link IDs 8 and above unused
+                tid_to_link_mapping->tid_to_link_map[num_maps++] = 0;
+            }
+        }
+        mapping_len = static_cast<unsigned short> (offsetof(em_tid_to_link_mapping_t, tid_to_link_map) + num_maps);
+
+        tid_to_link_mapping = reinterpret_cast<em_tid_to_link_mapping_t *> (reinterpret_cast<unsigned char *> (tid_to_link_mapping) + mapping_len);
+        tid_to_link_map_len = static_cast<unsigned short> (tid_to_link_map_len + mapping_len);
     }
 
     tlv_len += tid_to_link_map_len;
@@ -1095,7 +1211,18 @@ int em_configuration_t::send_ap_mld_config_req_msg()
     len += static_cast<unsigned int> (sizeof(em_cmdu_t));
 
     // One AP MLD Configuration TLV
-    tlv_len = static_cast<short unsigned int> (create_ap_mld_config_tlv(tmp));
+    tlv = reinterpret_cast<em_tlv_t *> (tmp);
+    tlv->type = em_tlv_type_ap_mld_config;
+    tlv_len = static_cast<short unsigned int> (create_ap_mld_config_tlv(tlv->value));
+    tlv->len = htons(tlv_len);
+
+    // the agent has this configuration already, the links it did not change are not disturbed
+    if (m_ap_mld_sync.is_acked(tlv->value, tlv_len) == true) {
+        em_printfout("AP MLD configuration of %s unchanged, not sent", util::mac_to_string(dm->get_agent_al_interface_mac()).c_str());
+        set_state(em_state_ctrl_ap_mld_configured);
+        return 0;
+    }
+    m_ap_mld_sync.sent(ntohs(cmdu->id), tlv->value, tlv_len);
 
     tmp += (sizeof(em_tlv_t) + tlv_len);
     len += static_cast<unsigned int> (sizeof(em_tlv_t) + tlv_len);
@@ -1238,7 +1365,10 @@ int em_configuration_t::send_ap_mld_config_resp_msg(unsigned char *dst, unsigned
     len += static_cast<unsigned int> (sizeof(em_cmdu_t));
 
     // One AP MLD Configuration TLV
-    tlv_len = static_cast<short unsigned int> (create_ap_mld_config_tlv(tmp));
+    tlv = reinterpret_cast<em_tlv_t *> (tmp);
+    tlv->type = em_tlv_type_ap_mld_config;
+    tlv_len = static_cast<short unsigned int> (create_ap_mld_config_tlv(tlv->value));
+    tlv->len = htons(tlv_len);
 
     tmp += (sizeof(em_tlv_t) + tlv_len);
     len += static_cast<unsigned int> (sizeof(em_tlv_t) + tlv_len);
@@ -1358,124 +1488,12 @@ int em_configuration_t::handle_bsta_mld_config_req(unsigned char *buff, unsigned
 	return 0;
 }
 
-int em_configuration_t::handle_bsta_radio_cap(unsigned char *buff, unsigned int len)
-{
-    dm_easy_mesh_t *dm = get_data_model();
-    em_bh_sta_radio_cap_t *bsta_radio_cap = reinterpret_cast<em_bh_sta_radio_cap_t*>(buff);
-    bool is_colocated = dm->get_colocated();
-
-    em_printfout("Backhaul STA Radio Capabilities received, sta mac: %s for radio: %s, mac present: %d",
-        util::mac_to_string(bsta_radio_cap->bsta_addr).c_str(),
-        util::mac_to_string(bsta_radio_cap->ruid).c_str(), bsta_radio_cap->bsta_mac_present);
-
-    //find device based on this radio
-    em_device_info_t *dev = dm->get_device_info();
-    if (dev == NULL) {
-        em_printfout("Could not find device in data model");
-        return -1;
-    }
-
-    //memcpy(dm->m_device.m_device_info.backhaul_sta, bsta_radio_cap->bsta_addr, sizeof(mac_address_t));
-    //also update the bss with the sta mac
-    for (unsigned int i = 0; i < dm->get_num_bss(); i++) {
-        if ( (memcmp(dm->m_bss[i].m_bss_info.ruid.mac, bsta_radio_cap->ruid, sizeof(mac_address_t)) == 0) &&
-                (dm->m_bss[i].m_bss_info.vap_mode == em_vap_mode_sta) ) {
-            memcpy(dm->m_bss[i].m_bss_info.sta_mac, bsta_radio_cap->bsta_addr, sizeof(mac_address_t));
-            em_printfout("Topo Response: BSS updated with backhaul sta mac: %s for radio: %s",
-                util::mac_to_string(bsta_radio_cap->bsta_addr).c_str(),
-                util::mac_to_string(bsta_radio_cap->ruid).c_str());
-            break;
-        }
-    }
-
-    em_printfout("is_colocated val: %d for device id: %s, ctrl al_interface mac: %s \
-        , ctrl interface mac: %s", is_colocated, util::mac_to_string(dev->id.dev_mac).c_str(),
-        util::mac_to_string(dm->get_ctrl_al_interface_mac()).c_str(),
-        util::mac_to_string(dm->get_controller_interface_mac()).c_str());
-
-    mac_addr_str_t rad_mac_str;
-    dm_easy_mesh_t::macbytes_to_string(bsta_radio_cap->ruid, rad_mac_str);
-
-    get_mgr()->io_process(em_bus_event_type_bsta_cap_req, reinterpret_cast<unsigned char *> (&rad_mac_str), sizeof(mac_addr_str_t));
-    em_printfout("IO process for bcap query submitted with rad mac: %s", rad_mac_str);
-
-    em_printfout("Update BSTA Cap for Device id: %s",
-        util::mac_to_string(dev->id.dev_mac).c_str());
-
-    memcpy(dm->m_device.m_device_info.backhaul_sta, bsta_radio_cap->bsta_addr, sizeof(mac_address_t));
-    dm->set_db_cfg_param(db_cfg_type_device_list_update, "");
-
-    return 0;
-}
-
-int em_configuration_t::handle_ap_operational_bss(unsigned char *buff, unsigned int len)
-{
-	dm_easy_mesh_t	*dm;
-	em_ap_op_bss_t	*ap;
-	em_ap_op_bss_radio_t	*radio;
-	em_ap_operational_bss_t	*bss;
-	dm_bss_t *dm_bss;
-	bool updated_at_least_one_bss = false;;
-	unsigned int i, j;
-	unsigned int all_bss_len = 0;
-	char time_date[EM_DATE_TIME_BUFF_SZ];
-
-	dm = get_data_model();
-            
-    // first verify that dm has all the radios
-    ap = reinterpret_cast<em_ap_op_bss_t *> (buff);
-    radio = const_cast<em_ap_op_bss_radio_t *> (ap->radios);
-
-	util::get_date_time_rfc3399(time_date, sizeof(time_date));
-
-    for (i = 0; i < ap->radios_num; i++) {
-        bss = radio->bss;
-        all_bss_len = 0;
-        for (j = 0; j < radio->bss_num; j++) {
-            dm_bss = dm->get_bss(radio->ruid, bss->bssid);
-		
-			if (dm_bss == NULL) {
-				dm_bss = &dm->m_bss[dm->m_num_bss];
-
-				// fill up id first
-				strncpy(dm_bss->m_bss_info.id.net_id, dm->m_device.m_device_info.id.net_id, sizeof(em_long_string_t));
-				memcpy(dm_bss->m_bss_info.id.dev_mac, dm->m_device.m_device_info.intf.mac, sizeof(mac_address_t));
-				memcpy(dm_bss->m_bss_info.id.ruid, radio->ruid, sizeof(mac_address_t));
-				memcpy(dm_bss->m_bss_info.id.bssid, bss->bssid, sizeof(mac_address_t));
-	
-                memcpy(dm_bss->m_bss_info.bssid.mac, bss->bssid, sizeof(mac_address_t));
-                memcpy(dm_bss->m_bss_info.ruid.mac, radio->ruid, sizeof(mac_address_t));
-                dm->set_num_bss(dm->get_num_bss() + 1);
-			}
-            strncpy(dm_bss->m_bss_info.ssid, bss->ssid, bss->ssid_len);
-			dm_bss->m_bss_info.enabled = true;
-			strncpy(dm_bss->m_bss_info.timestamp, time_date, sizeof(em_long_string_t));
-
-			updated_at_least_one_bss = true;
-			
-			all_bss_len += static_cast<unsigned int> (sizeof(em_ap_operational_bss_t) + bss->ssid_len);
-			bss = reinterpret_cast<em_ap_operational_bss_t *> (reinterpret_cast<unsigned char *> (bss) + sizeof(em_ap_operational_bss_t) + bss->ssid_len);
-        }
-
-        radio = reinterpret_cast<em_ap_op_bss_radio_t *> (reinterpret_cast<unsigned char *> (radio) + sizeof(em_ap_op_bss_radio_t) + all_bss_len);
-
-    }
-
-	if (updated_at_least_one_bss == true) {
-		dm->set_db_cfg_param(db_cfg_type_bss_list_update, "");
-	}
-
-	return 0;
-
-}
-
 int em_configuration_t::handle_topology_notification(unsigned char *buff, unsigned int len)
 {
     em_tlv_t *tlv;
     unsigned int tmp_len;
     mac_address_t dev_mac;
-    mac_addr_str_t sta_mac_str, bssid_str, radio_mac_str;
-    em_long_string_t    key;
+    dm_map_key_t    key;
     dm_easy_mesh_t  *dm;
     bool found_dev_mac = false;
     em_client_assoc_event_t *assoc_evt_tlv;
@@ -1514,10 +1532,7 @@ int em_configuration_t::handle_topology_notification(unsigned char *buff, unsign
     while ((tlv->type != em_tlv_type_eom) && (tmp_len > 0)) {
         if (tlv->type == em_tlv_type_client_assoc_event) {
             assoc_evt_tlv = reinterpret_cast<em_client_assoc_event_t *> (tlv->value);
-            dm_easy_mesh_t::macbytes_to_string(assoc_evt_tlv->cli_mac_address, sta_mac_str);
-            dm_easy_mesh_t::macbytes_to_string(assoc_evt_tlv->bssid, bssid_str);
-            dm_easy_mesh_t::macbytes_to_string(get_radio_interface_mac(), radio_mac_str);
-            snprintf(key, sizeof(em_long_string_t), "%s@%s@%s", sta_mac_str, bssid_str, radio_mac_str);
+            dm_key_map_t::sta_key(&key, assoc_evt_tlv->cli_mac_address, assoc_evt_tlv->bssid, get_radio_interface_mac());
 
             //em_printfout("Client Device:%s %s to BSSID: %s\n", sta_mac_str,
             //        (assoc_evt_tlv->assoc_event == 1)?"associated":"disassociated", bssid_str);
@@ -1529,15 +1544,18 @@ int em_configuration_t::handle_topology_notification(unsigned char *buff, unsign
                 memcpy(sta_info.radiomac, get_radio_interface_mac(), sizeof(mac_address_t));
                 sta_info.associated = assoc_evt_tlv->assoc_event;
 
-                hash_map_put(dm->m_sta_assoc_map, strdup(key), new dm_sta_t(&sta_info));
+                dm->m_sta_assoc_map->put(&key, new dm_sta_t(&sta_info));
 
                 dm->set_db_cfg_param(db_cfg_type_sta_list_update, "");
                 //em_printfout("Client updated to db: %s", key);
+            } else {
+                // closes the steer of the STA, if it was steered
+                get_mgr()->get_steer_outcomes()->reassociated(assoc_evt_tlv->cli_mac_address, assoc_evt_tlv->bssid,
+                    em_timer_wheel_t::get_time_ms());
             }
             memcpy(raw.dev, dev_mac, sizeof(mac_address_t));
             memcpy(reinterpret_cast<unsigned char *> (&raw.assoc), reinterpret_cast<unsigned char *> (assoc_evt_tlv), sizeof(em_client_assoc_event_t));
             get_mgr()->io_process(em_bus_event_type_sta_assoc, reinterpret_cast<unsigned char *> (&raw), sizeof(em_bus_event_type_client_assoc_params_t));
-            break;
         }
             
 		tmp_len -= static_cast<unsigned int> (sizeof(em_tlv_t) + htons(tlv->len));
@@ -1548,79 +1566,158 @@ int em_configuration_t::handle_topology_notification(unsigned char *buff, unsign
 	return 0;
 }
 
-int em_configuration_t::handle_topology_response(unsigned char *buff, unsigned int len)
+em_topo_resp_bss_t *em_configuration_t::stage_topology_bss(em_topo_resp_t *resp, const unsigned char *ruid, const unsigned char *bssid)
+{
+    em_topo_resp_bss_t *bss;
+    unsigned int i;
+
+    for (i = 0; i < resp->num_bss; i++) {
+        bss = &resp->bss[i];
+        if ((memcmp(bss->ruid, ruid, sizeof(mac_address_t)) == 0) && (memcmp(bss->bssid, bssid, sizeof(mac_address_t)) == 0)) {
+            return bss;
+        }
+    }
+
+    if (resp->num_bss >= EM_TOPO_RESP_MAX_BSS) {
+        return NULL;
+    }
+    bss = &resp->bss[resp->num_bss++];
+    memset(bss, 0, sizeof(em_topo_resp_bss_t));
+    memcpy(bss->ruid, ruid, sizeof(mac_address_t));
+    memcpy(bss->bssid, bssid, sizeof(mac_address_t));
+
+    return bss;
+}
+
+int em_configuration_t::parse_topology_response(unsigned char *buff, unsigned int len, em_topo_resp_t *resp)
 {
     em_tlv_t *tlv;
-    unsigned int tmp_len;
-    int ret = 0;
+    unsigned int tmp_len, tlv_len, off, i, j, ssid_len;
     char *errors[EM_MAX_TLV_MEMBERS] = {0};
-    bool found_op_bss = false;
-    bool found_profile = false;
-    bool found_bss_config_rprt = false;
-    em_profile_type_t profile = em_profile_type_reserved;
-	dm_easy_mesh_t *dm;
-    em_raw_hdr_t *hdr = reinterpret_cast<em_raw_hdr_t *>(buff);
-    uint8_t *src_al_mac = hdr->src;
-    em_interface_name_t name;
-    
-	dm = get_data_model();
-
-    tlv =  reinterpret_cast<em_tlv_t *> (buff + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
+    bool found_profile = false, found_op_bss = false, found_bss_config_rprt = false;
+    em_ap_op_bss_radio_t *radio;
+    em_ap_operational_bss_t *op_bss;
+    em_ap_vendor_op_bss_radio_t *vendor_radio;
+    em_ap_vendor_operational_bss_t *vendor_bss;
+    em_topo_resp_bss_t *bss;
+
+    resp->profile = em_profile_type_reserved;
+    resp->num_bss = 0;
+    resp->bsta_present = false;
+    resp->ap_mld = NULL;
+
+    if (len < sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)) {
+        return -1;
+    }
+    tlv = reinterpret_cast<em_tlv_t *> (buff + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
     tmp_len = len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
-        
-    while ((tlv->type != em_tlv_type_eom) && (tmp_len > 0)) {
-        if (tlv->type != em_tlv_type_profile) {
-            tmp_len -= static_cast<unsigned int> (sizeof(em_tlv_t) + htons(tlv->len));
-            tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
 
-            continue;
-
-        } else {
-            found_profile = true;
-			memcpy(&profile, tlv->value, ntohs(tlv->len));
-            break; 
+    while ((tmp_len >= sizeof(em_tlv_t)) && (tlv->type != em_tlv_type_eom)) {
+        tlv_len = ntohs(tlv->len);
+        if (sizeof(em_tlv_t) + tlv_len > tmp_len) {
+            printf("%s:%d: TLV type %d runs past the message, dropping\n", __func__, __LINE__, tlv->type);
+            return -1;
         }
-    }
 
-	if (found_profile == false) {
-		printf("%s:%d: Could not find profile in topo reponse message, dropping\n", __func__, __LINE__);
-		return -1;
-	}
+        switch (tlv->type) {
+            case em_tlv_type_profile:
+                if ((tlv_len > 0) && (found_profile == false)) {
+                    resp->profile = static_cast<em_profile_type_t> (tlv->value[0]);
+                    found_profile = true;
+                }
+                break;
 
-	m_peer_profile = profile;
-    
-	if (em_msg_t(em_msg_type_topo_resp, m_peer_profile, buff, len).validate(errors) == 0) {
-        printf("%s:%d: topology response msg validation failed\n", __func__, __LINE__);
-            
-        //return -1;
-    }       
-        
-    tlv =  reinterpret_cast<em_tlv_t *> (buff + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
-    tmp_len = len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
+            case em_tlv_type_operational_bss:
+            case em_tlv_type_vendor_operational_bss:
+                if (tlv_len < 1) {
+                    break;
+                }
+                off = 1;
+                for (i = 0; i < tlv->value[0]; i++) {
+                    if (off + sizeof(em_ap_op_bss_radio_t) > tlv_len) {
+                        printf("%s:%d: Truncated operational BSS TLV, dropping\n", __func__, __LINE__);
+                        return -1;
+                    }
+                    // both radio headers are the RUID and the number of BSSs
+                    radio = reinterpret_cast<em_ap_op_bss_radio_t *> (tlv->value + off);
+                    vendor_radio = reinterpret_cast<em_ap_vendor_op_bss_radio_t *> (tlv->value + off);
+                    off += static_cast<unsigned int> (sizeof(em_ap_op_bss_radio_t));
+                    for (j = 0; j < radio->bss_num; j++) {
+                        if (tlv->type == em_tlv_type_operational_bss) {
+                            op_bss = reinterpret_cast<em_ap_operational_bss_t *> (tlv->value + off);
+                            if ((off + sizeof(em_ap_operational_bss_t) > tlv_len) ||
+                                    (off + sizeof(em_ap_operational_bss_t) + op_bss->ssid_len > tlv_len)) {
+                                printf("%s:%d: Truncated operational BSS TLV, dropping\n", __func__, __LINE__);
+                                return -1;
+                            }
+                            if ((bss = stage_topology_bss(resp, radio->ruid, op_bss->bssid)) == NULL) {
+                                return -1;
+                            }
+                            ssid_len = (op_bss->ssid_len < sizeof(ssid_t)) ? op_bss->ssid_len:static_cast<unsigned int> (sizeof(ssid_t) - 1);
+                            memset(bss->ssid, 0, sizeof(ssid_t));
+                            memcpy(bss->ssid, op_bss->ssid, ssid_len);
+                            bss->operational = true;
+                            off += static_cast<unsigned int> (sizeof(em_ap_operational_bss_t) + op_bss->ssid_len);
+                        } else {
+                            vendor_bss = reinterpret_cast<em_ap_vendor_operational_bss_t *> (tlv->value + off);
+                            if (off + sizeof(em_ap_vendor_operational_bss_t) > tlv_len) {
+                                printf("%s:%d: Truncated vendor operational BSS TLV, dropping\n", __func__, __LINE__);
+                                return -1;
+                            }
+                            if ((bss = stage_topology_bss(resp, vendor_radio->ruid, vendor_bss->bssid)) == NULL) {
+                                return -1;
+                            }
+                            bss->haul_type = static_cast<em_haul_type_t> (vendor_bss->haultype);
+                            bss->vap_mode = static_cast<em_vap_mode_t> (vendor_bss->vap_mode);
+                            bss->vendor = true;
+                            off += static_cast<unsigned int> (sizeof(em_ap_vendor_operational_bss_t));
+                        }
+                    }
+                }
+                if (tlv->type == em_tlv_type_operational_bss) {
+                    found_op_bss = true;
+                }
+                break;
 
-	while ((tlv->type != em_tlv_type_eom) && (tmp_len > 0)) {
-		if (tlv->type != em_tlv_type_vendor_operational_bss) {
-			tmp_len -= static_cast<unsigned int> (sizeof(em_tlv_t) + htons(tlv->len));
-			tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
-			continue;
-		} else {
-			handle_ap_vendor_operational_bss(tlv->value, tlv->len);
-			break;
-		}
-	}
-	tlv =  reinterpret_cast<em_tlv_t *> (buff + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
-	tmp_len = len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)); 
-    while ((tlv->type != em_tlv_type_eom) && (tmp_len > 0)) {
-        if (tlv->type != em_tlv_type_operational_bss) {
-            tmp_len -= static_cast<unsigned int> (sizeof(em_tlv_t) + htons(tlv->len));
-            tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
+            case em_tlv_type_bss_conf_rep:
+                found_bss_config_rprt = true;
+                break;
 
-            continue;
+            case em_tlv_type_bh_sta_radio_cap:
+                if ((resp->bsta_present == false) && (tlv_len >= sizeof(em_bh_sta_radio_cap_t))) {
+                    memcpy(&resp->bsta, tlv->value, sizeof(em_bh_sta_radio_cap_t));
+                    resp->bsta_present = true;
+                }
+                break;
 
-        } else {
-            found_op_bss = true;
-            break;
+            case em_tlv_type_ap_mld_config:
+                if ((resp->ap_mld != NULL) || (tlv_len < sizeof(em_ap_mld_config_t))) {
+                    break;
+                }
+                if (check_ap_mld_config(tlv->value, tlv_len) == false) {
+                    printf("%s:%d: Truncated AP MLD Configuration TLV, dropping\n", __func__, __LINE__);
+                    return -1;
+                }
+                if (tlv->value[0] <= EM_MAX_AP_MLD) {
+                    resp->ap_mld = reinterpret_cast<const em_ap_mld_config_t *> (tlv->value);
+                }
+                break;
+
+            default:
+                break;
         }
+
+        tmp_len -= static_cast<unsigned int> (sizeof(em_tlv_t) + tlv_len);
+        tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + tlv_len);
+    }
+
+    if (found_profile == false) {
+        printf("%s:%d: Could not find profile in topo reponse message, dropping\n", __func__, __LINE__);
+        return -1;
+    }
+
+    if (em_msg_t(em_msg_type_topo_resp, resp->profile, buff, len).validate(errors) == 0) {
+        printf("%s:%d: topology response msg validation failed\n", __func__, __LINE__);
     }
 
     if (found_op_bss == false) {
@@ -1628,152 +1725,306 @@ int em_configuration_t::handle_topology_response(unsigned char *buff, unsigned i
         return -1;
     }
 
-	if (handle_ap_operational_bss(tlv->value, tlv->len) != 0) {
-		printf("%s:%d: Operational BSS handling failed\n", __func__, __LINE__);
-		return -1;
-	}
+    if (found_bss_config_rprt == false) {
+        printf("%s:%d: Could not find bss configuration report, failing mesaage\n", __func__, __LINE__);
+        return -1;
+    }
 
-    while ((tlv->type != em_tlv_type_eom) && (tmp_len > 0)) {
-        if (tlv->type != em_tlv_type_bss_conf_rep) {
-            tmp_len -= static_cast<unsigned int> (sizeof(em_tlv_t) + htons(tlv->len));
-            tlv = reinterpret_cast <em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
+    return 0;
+}
 
-            continue;
+bool em_configuration_t::check_ap_mld_config(const unsigned char *buff, unsigned int len)
+{
+    const em_ap_mld_t *ap_mld;
+    unsigned int i, off;
 
-        } else {
-            found_bss_config_rprt = true;
-            break;
+    if (len < sizeof(em_ap_mld_config_t)) {
+        return false;
+    }
+    off = static_cast<unsigned int> (sizeof(em_ap_mld_config_t));
+    for (i = 0; i < buff[0]; i++) {
+        ap_mld = reinterpret_cast<const em_ap_mld_t *> (buff + off);
+        if ((off + sizeof(em_ap_mld_t) > len) || (ap_mld->num_affiliated_ap > EM_MAX_AP_MLD) ||
+                (off + sizeof(em_ap_mld_t) + ap_mld->num_affiliated_ap * sizeof(em_affiliated_ap_mld_t) > len)) {
+            return false;
         }
+        off += static_cast<unsigned int> (sizeof(em_ap_mld_t) + ap_mld->num_affiliated_ap * sizeof(em_affiliated_ap_mld_t));
     }
 
-    if (found_bss_config_rprt == false) {
-        printf("%s:%d: Could not find bss configuration report, failing mesaage\n", __func__, __LINE__);
-        return -1;
+    return true;
+}
+
+unsigned int em_configuration_t::apply_ap_mld_config(const em_ap_mld_config_t *conf)
+{
+    dm_easy_mesh_t *dm = get_data_model();
+    const em_ap_mld_t *ap_mld;
+    const em_affiliated_ap_mld_t *affiliated_ap_mld;
+    std::bitset<EM_MAX_AP_MLD> listed;
+    em_ap_mld_info_t info, *cur;
+    em_ap_mld_delta_t delta;
+    em_affiliated_ap_info_t *affiliated_ap_info;
+    dm_bss_t *dm_bss;
+    unsigned int i, j, idx, changed = 0, links = 0;
+    int rc;
+
+    if (conf->num_ap_mld == 0) {
+        return 0;
     }
 
-	if (handle_bss_configuration_report(tlv->value, tlv->len) != 0) {
-		printf("%s:%d: BSS Configuration Report handling failed\n", __func__, __LINE__);
-		return -1;
-	}
+    ap_mld = conf->ap_mld;
+    for (i = 0; (i < conf->num_ap_mld) && (i < EM_MAX_AP_MLD); i++) {
+        memset(&info, 0, sizeof(em_ap_mld_info_t));
+        info.mac_addr_valid = ap_mld->ap_mld_mac_addr_valid;
+        strncpy(info.ssid, ap_mld->ssid, (ap_mld->ssid_len < sizeof(ssid_t)) ? ap_mld->ssid_len:sizeof(ssid_t) - 1);
+        memcpy(info.mac_addr, ap_mld->ap_mld_mac_addr, sizeof(mac_address_t));
+        info.str = ap_mld->str;
+        info.nstr = ap_mld->nstr;
+        info.emlsr = ap_mld->emlsr;
+        info.emlmr = ap_mld->emlmr;
+        info.num_affiliated_ap = ap_mld->num_affiliated_ap;
 
-    while ((tlv->type != em_tlv_type_eom) && (tmp_len > 0)) {
-        if (tlv->type != em_tlv_type_bh_sta_radio_cap) {
-            tmp_len -= static_cast<unsigned int> (sizeof(em_tlv_t) + htons(tlv->len));
-            tlv = reinterpret_cast <em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
+        affiliated_ap_mld = ap_mld->affiliated_ap_mld;
+        for (j = 0; j < ap_mld->num_affiliated_ap; j++) {
+            affiliated_ap_info = &info.affiliated_ap[j];
+            affiliated_ap_info->mac_addr_valid = affiliated_ap_mld->affiliated_mac_addr_valid;
+            affiliated_ap_info->link_id_valid = affiliated_ap_mld->link_id_valid;
+            memcpy(affiliated_ap_info->ruid.mac, affiliated_ap_mld->ruid, sizeof(mac_address_t));
+            memcpy(affiliated_ap_info->mac_addr, affiliated_ap_mld->affiliated_mac_addr, sizeof(mac_address_t));
+            affiliated_ap_info->link_id = affiliated_ap_mld->link_id;
+            affiliated_ap_mld++;
+        }
+        ap_mld = reinterpret_cast<const em_ap_mld_t *> (affiliated_ap_mld);
+
+        // matched by MLD MAC address, an unchanged MLD costs a lookup and a compare
+        if ((rc = dm->set_ap_mld(&info, &idx, &delta)) < 0) {
             continue;
-        } else {
-            handle_bsta_radio_cap(tlv->value, tlv->len);
-            break;
         }
-    }
+        listed.set(idx);
+        changed += static_cast<unsigned int> (rc);
 
+        // the links kept are left alone, with the STA MLDs associated through them
+        for (j = 0; j < delta.num_removed; j++) {
+            links += dm->remove_affiliated_ap(info.mac_addr, &delta.removed[j]);
+        }
+        if (rc > 0) {
+            em_printfout("AP MLD %s: %d links added, %d changed, %d removed", util::mac_to_string(info.mac_addr).c_str(),
+                delta.num_added, delta.num_changed, delta.num_removed);
+        }
 
-    bool found_ap_mld = false;
-    while ((tlv->type != em_tlv_type_eom) && (tmp_len > 0)) {
-        if (tlv->type != em_tlv_type_ap_mld_config) {
-            tmp_len -= static_cast<unsigned int> (sizeof(em_tlv_t) + htons(tlv->len));
-            tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
+        for (j = 0; j < info.num_affiliated_ap; j++) {
+            dm_bss = dm->get_bss(info.affiliated_ap[j].ruid.mac, info.affiliated_ap[j].mac_addr);
+            if ((dm_bss != NULL) && (memcmp(dm_bss->m_bss_info.mld_mac, info.mac_addr, sizeof(mac_address_t)) != 0)) {
+                memcpy(dm_bss->m_bss_info.mld_mac, info.mac_addr, sizeof(mac_address_t));
+                dm->set_bss_dirty(static_cast<unsigned int> (dm_bss - dm->m_bss));
+                changed++;
+            }
+        }
+    }
 
+    // the report lists all the AP MLDs of the agent
+    for (i = 0; i < dm->get_num_ap_mld(); i++) {
+        if (listed.test(i) == true) {
             continue;
+        }
+        cur = &dm->m_ap_mld[i].m_ap_mld_info;
+        for (j = 0; (j < cur->num_affiliated_ap) && (j < EM_MAX_AP_MLD); j++) {
+            links += dm->remove_affiliated_ap(cur->mac_addr, &cur->affiliated_ap[j]);
+        }
+    }
+    changed += dm->remove_ap_mld_except(listed);
 
-        } else {
-            found_ap_mld = true;
-            break;
-       }
+    return changed + links;
+}
+
+int em_configuration_t::apply_topology_response(const em_topo_resp_t *resp, const unsigned char *src_al_mac)
+{
+    dm_easy_mesh_t *dm = get_data_model();
+    const em_topo_resp_bss_t *bss;
+    dm_bss_t *dm_bss;
+    em_bss_info_t *info;
+    em_interface_name_t name;
+    mac_address_t backhaul_alid;
+    char time_date[EM_DATE_TIME_BUFF_SZ];
+    unsigned int i, num_new = 0, changed = 0;
+    bool bss_changed, dev_changed = false;
+
+    // all or nothing, the new BSSs must fit
+    for (i = 0; i < resp->num_bss; i++) {
+        if (dm->get_bss(const_cast<unsigned char *> (resp->bss[i].ruid), const_cast<unsigned char *> (resp->bss[i].bssid)) == NULL) {
+            num_new++;
+        }
+    }
+    if (dm->get_num_bss() + num_new > EM_MAX_BSSS) {
+        printf("%s:%d: %u new BSSs do not fit in the data model, dropping\n", __func__, __LINE__, num_new);
+        return -1;
     }
 
-    if (found_ap_mld == true) {
-        em_printfout("Found AP MLD details in topology response message");
-        handle_ap_mld_config_tlv(tlv->value, htons(tlv->len));
+    m_peer_profile = resp->profile;
+    util::get_date_time_rfc3399(time_date, sizeof(time_date));
+
+    for (i = 0; i < resp->num_bss; i++) {
+        bss = &resp->bss[i];
+        bss_changed = false;
+        dm_bss = dm->get_bss(const_cast<unsigned char *> (bss->ruid), const_cast<unsigned char *> (bss->bssid));
+        if (dm_bss == NULL) {
+            dm_bss = &dm->m_bss[dm->m_num_bss];
+            info = &dm_bss->m_bss_info;
+            memset(info, 0, sizeof(em_bss_info_t));
+
+            // fill up id first
+            strncpy(info->id.net_id, dm->m_device.m_device_info.id.net_id, sizeof(em_long_string_t));
+            memcpy(info->id.dev_mac, dm->m_device.m_device_info.intf.mac, sizeof(mac_address_t));
+            memcpy(info->id.ruid, bss->ruid, sizeof(mac_address_t));
+            memcpy(info->id.bssid, bss->bssid, sizeof(mac_address_t));
+            memcpy(info->bssid.mac, bss->bssid, sizeof(mac_address_t));
+            memcpy(info->ruid.mac, bss->ruid, sizeof(mac_address_t));
+            dm->set_num_bss(dm->get_num_bss() + 1);
+            bss_changed = true;
+        }
+        info = &dm_bss->m_bss_info;
+
+        if ((bss->vendor == true) && ((info->id.haul_type != bss->haul_type) || (info->vap_mode != bss->vap_mode))) {
+            info->id.haul_type = bss->haul_type;
+            info->vap_mode = bss->vap_mode;
+            bss_changed = true;
+        }
+        if (bss->operational == true) {
+            if ((strncmp(info->ssid, bss->ssid, sizeof(ssid_t)) != 0) || (info->enabled == false)) {
+                memcpy(info->ssid, bss->ssid, sizeof(ssid_t));
+                info->enabled = true;
+                bss_changed = true;
+            }
+            // last seen, not worth a row write on its own
+            strncpy(info->timestamp, time_date, sizeof(em_long_string_t));
+        }
+
+        if (bss_changed == true) {
+            dm->set_bss_dirty(static_cast<unsigned int> (dm_bss - dm->m_bss));
+            changed++;
+        }
     }
-    em_printfout("No of AP MLDs: %d", dm->m_num_ap_mld);
 
-    em_printfout("Src al mac: " MACSTRFMT, MAC2STR(src_al_mac));
+    if (resp->bsta_present == true) {
+        mac_addr_str_t rad_mac_str;
+
+        em_printfout("Backhaul STA Radio Capabilities received, sta mac: %s for radio: %s, mac present: %d",
+            util::mac_to_string(resp->bsta.bsta_addr).c_str(), util::mac_to_string(resp->bsta.ruid).c_str(),
+            resp->bsta.bsta_mac_present);
 
+        // the backhaul STA of the radio
+        for (i = 0; i < dm->get_num_bss(); i++) {
+            info = &dm->m_bss[i].m_bss_info;
+            if ((memcmp(info->ruid.mac, resp->bsta.ruid, sizeof(mac_address_t)) != 0) || (info->vap_mode != em_vap_mode_sta)) {
+                continue;
+            }
+            if (memcmp(info->sta_mac, resp->bsta.bsta_addr, sizeof(mac_address_t)) != 0) {
+                memcpy(info->sta_mac, resp->bsta.bsta_addr, sizeof(mac_address_t));
+                dm->set_bss_dirty(i);
+                changed++;
+            }
+            break;
+        }
+
+        dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *> (resp->bsta.ruid), rad_mac_str);
+        get_mgr()->io_process(em_bus_event_type_bsta_cap_req, reinterpret_cast<unsigned char *> (&rad_mac_str), sizeof(mac_addr_str_t));
+
+        if (memcmp(dm->m_device.m_device_info.backhaul_sta, resp->bsta.bsta_addr, sizeof(mac_address_t)) != 0) {
+            memcpy(dm->m_device.m_device_info.backhaul_sta, resp->bsta.bsta_addr, sizeof(mac_address_t));
+            dev_changed = true;
+        }
+    }
+
+    if (resp->ap_mld != NULL) {
+        changed += apply_ap_mld_config(resp->ap_mld);
+    }
+
+    // an agent on this device has no backhaul AL, the others are behind the controller
     if (dm_easy_mesh_t::name_from_mac_address(reinterpret_cast<const mac_address_t*>(src_al_mac), name) == 0) {
-        em_printfout("MAC address exists on this device.");
-        memset(dm->m_device.m_device_info.backhaul_alid.mac, 0, sizeof(mac_address_t));
+        memset(backhaul_alid, 0, sizeof(mac_address_t));
     } else {
-        em_printfout("MAC address not found on any interface.");
-        memcpy(dm->m_device.m_device_info.backhaul_alid.mac, dm->get_ctrl_al_interface_mac(), sizeof(mac_address_t));
+        memcpy(backhaul_alid, dm->get_ctrl_al_interface_mac(), sizeof(mac_address_t));
+    }
+    if (memcmp(dm->m_device.m_device_info.backhaul_alid.mac, backhaul_alid, sizeof(mac_address_t)) != 0) {
+        memcpy(dm->m_device.m_device_info.backhaul_alid.mac, backhaul_alid, sizeof(mac_address_t));
+        dev_changed = true;
     }
 
-    em_printfout("updated dm dev_info's colocated: %d backhaul_mac: %s and backhaul_alid: %s", dm->get_colocated(),
-        util::mac_to_string(dm->m_device.m_device_info.backhaul_mac.mac).c_str(),
-        util::mac_to_string(dm->m_device.m_device_info.backhaul_alid.mac).c_str());
-
-	return ret;
-}
+    if (dev_changed == true) {
+        dm->set_db_cfg_param(db_cfg_type_device_list_update, "");
+        changed++;
+    }
 
-int em_configuration_t::handle_ack_msg(unsigned char *buff, unsigned int len)
-{
-    set_state(em_state_ctrl_ap_mld_req_ack_rcvd);
-    return 0;
+    return static_cast<int> (changed);
 }
 
-int em_configuration_t::handle_ap_mld_config_tlv(unsigned char *buff, unsigned int len)
+int em_configuration_t::handle_topology_response(unsigned char *buff, unsigned int len)
 {
-    em_ap_mld_config_t *ap_mld_conf = reinterpret_cast<em_ap_mld_config_t *> (buff);
-    em_ap_mld_t *ap_mld;
-    em_affiliated_ap_mld_t *affiliated_ap_mld;
-    dm_easy_mesh_t  *dm;
-    unsigned int i, j;
-    unsigned short ap_mld_len = 0;
-    unsigned short affiliated_ap_len = 0;
-    dm_bss_t *dm_bss;
+    em_raw_hdr_t *hdr = reinterpret_cast<em_raw_hdr_t *>(buff);
+    em_topo_resp_t resp;
+    struct timespec start, end;
+    int changed;
 
-    dm = get_data_model();
+    clock_gettime(CLOCK_MONOTONIC, &start);
 
-    if(ap_mld_conf->num_ap_mld == 0) {
-        em_printfout("Zero AP MLD data");
-        return 0;
+    // decoded in full first, a response that fails halfway leaves the data model as it was
+    if (parse_topology_response(buff, len, &resp) != 0) {
+        return -1;
     }
-    dm->set_num_ap_mld(ap_mld_conf->num_ap_mld);
+    changed = apply_topology_response(&resp, hdr->src);
 
-    em_printfout("No of AP MLDs: %d", ap_mld_conf->num_ap_mld);
-    ap_mld = ap_mld_conf->ap_mld;
-
-    for (i = 0; i < ap_mld_conf->num_ap_mld; i++) {
-        em_ap_mld_info_t* ap_mld_info = &dm->m_ap_mld[i].m_ap_mld_info;
-        if (ap_mld_info == NULL) {
-           em_printfout("NULL pointer detected in ap_mld_info");
-           return 0;
-        }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    em_printfout("Topology response of %s: %u BSSs, %d objects changed, ingest %lld us",
+        util::mac_to_string(hdr->src).c_str(), resp.num_bss, changed,
+        static_cast<long long> ((end.tv_sec - start.tv_sec) * 1000000LL + (end.tv_nsec - start.tv_nsec) / 1000));
 
-        ap_mld_info->mac_addr_valid = ap_mld->ap_mld_mac_addr_valid;
-        strncpy(ap_mld_info->ssid, ap_mld->ssid, ap_mld->ssid_len);
+    return changed;
+}
 
-        memcpy(ap_mld_info->mac_addr, ap_mld->ap_mld_mac_addr, sizeof(mac_address_t));
-        ap_mld_info->str = ap_mld->str;
-        ap_mld_info->nstr = ap_mld->nstr;
-        ap_mld_info->emlsr = ap_mld->emlsr;
-        ap_mld_info->emlmr = ap_mld->emlmr;
+int em_configuration_t::handle_ack_msg(unsigned char *buff, unsigned int len)
+{
+    em_cmdu_t *cmdu;
 
-        ap_mld_info->num_affiliated_ap = ap_mld->num_affiliated_ap;
-        affiliated_ap_mld = ap_mld->affiliated_ap_mld;
+    if (len < (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))) {
+        return -1;
+    }
+    cmdu = reinterpret_cast<em_cmdu_t *> (buff + sizeof(em_raw_hdr_t));
 
-        for (j = 0; j < ap_mld->num_affiliated_ap; j++) {
-            em_affiliated_ap_info_t* affiliated_ap_info = &dm->m_ap_mld[i].m_ap_mld_info.affiliated_ap[j];
-            affiliated_ap_info->mac_addr_valid = affiliated_ap_mld->affiliated_mac_addr_valid;
-            affiliated_ap_info->link_id_valid = affiliated_ap_mld->link_id_valid;
-            memcpy(affiliated_ap_info->ruid.mac, affiliated_ap_mld->ruid, sizeof(mac_address_t));
-            memcpy(affiliated_ap_info->mac_addr, affiliated_ap_mld->affiliated_mac_addr, sizeof(mac_address_t));
-            memcpy(&affiliated_ap_info->link_id, &affiliated_ap_mld->link_id, sizeof(unsigned char));
+    // the orchestration may have moved the node on already, the ACK still applies
+    if (m_ap_mld_sync.ack(ntohs(cmdu->id)) == false) {
+        return 0;
+    }
+    if (get_state() == em_state_ctrl_ap_mld_configured) {
+        set_state(em_state_ctrl_ap_mld_req_ack_rcvd);
+    }
+    return 0;
+}
 
-            affiliated_ap_mld = reinterpret_cast<em_affiliated_ap_mld_t *> (reinterpret_cast<unsigned char *> (affiliated_ap_mld) + sizeof(em_affiliated_ap_mld_t));
-            affiliated_ap_len += sizeof(em_affiliated_ap_mld_t);
+bool em_configuration_t::is_ap_mld_ack(unsigned char *buff, unsigned int len)
+{
+    em_cmdu_t *cmdu;
 
-            dm_bss = dm->get_bss(affiliated_ap_info->ruid.mac, affiliated_ap_info->mac_addr);
-            if (dm_bss != NULL) {
-                memcpy(dm_bss->m_bss_info.mld_mac, ap_mld_info->mac_addr , sizeof(mac_address_t));
-            }
+    if (len < (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))) {
+        return false;
+    }
+    cmdu = reinterpret_cast<em_cmdu_t *> (buff + sizeof(em_raw_hdr_t));
 
-        }
+    return m_ap_mld_sync.is_pending(ntohs(cmdu->id));
+}
 
-        ap_mld = reinterpret_cast<em_ap_mld_t *> (reinterpret_cast<unsigned char *> (ap_mld) + sizeof(em_ap_mld_t) + affiliated_ap_len);
-        ap_mld_len += static_cast<short unsigned int> (sizeof(em_ap_mld_t) + affiliated_ap_len);
+int em_configuration_t::handle_ap_mld_config_tlv(unsigned char *buff, unsigned int len)
+{
+    if (check_ap_mld_config(buff, len) == false) {
+        em_printfout("Truncated AP MLD Configuration TLV");
+        return -1;
+    }
+    if (buff[0] == 0) {
+        em_printfout("Zero AP MLD data");
+        return 0;
     }
 
+    em_printfout("No of AP MLDs: %d, changed: %d", buff[0],
+        apply_ap_mld_config(reinterpret_cast<const em_ap_mld_config_t *> (buff)));
+
     return 0;
 }
 
@@ -1871,7 +2122,7 @@ int em_configuration_t::handle_ap_mld_config_req(unsigned char *buff, unsigned i
 
     while ((tlv->type != em_tlv_type_eom) && (len > 0)) {
         if (tlv->type == em_tlv_type_ap_mld_config) {
-            handle_ap_mld_config_tlv(tlv->value, sizeof(em_ap_mld_config_t));
+            handle_ap_mld_config_tlv(tlv->value, htons(tlv->len));
         }
         if (tlv->type == em_tlv_eht_operations) {
             handle_eht_operations_tlv(tlv->value);
@@ -1945,7 +2196,7 @@ unsigned short em_configuration_t::create_traffic_separation_policy(unsigned cha
     return len;
 }
 
-unsigned short em_configuration_t::create_m2_msg(unsigned char *buff, em_haul_type_t haul_type)
+unsigned short em_configuration_t::create_m2_msg(unsigned char *buff, em_haul_type_t haul_type, const em_wsc_keys_job_t *job)
 {
     data_elem_attr_t *attr;
     unsigned short size, len = 0;
@@ -2161,7 +2412,13 @@ unsigned short em_configuration_t::create_m2_msg(unsigned char *buff, em_haul_ty
     // encrypted settings
     attr = reinterpret_cast<data_elem_attr_t *> (tmp);
     attr->id = htons(attr_id_encrypted_settings);
-    size = static_cast<short unsigned int> (create_encrypted_settings(attr->val, haul_type));
+    if (job != NULL) {
+        // sealed on the crypto pool along with the keys
+        size = static_cast<short unsigned int> (job->enc_len[haul_type]);
+        memcpy(attr->val, job->enc[haul_type], size);
+    } else {
+        size = static_cast<short unsigned int> (create_encrypted_settings(attr->val, haul_type));
+    }
     attr->len = htons(size);
     
     len += static_cast<unsigned short int> (sizeof(data_elem_attr_t) + size);
@@ -3136,7 +3393,8 @@ int em_configuration_t::create_bss_conf_resp_tlv(uint8_t *buff, em_bss_info_t *b
     return static_cast<int>(json_string.length());
 }
 
-int em_configuration_t::compute_keys(unsigned char *remote_pub, unsigned short pub_len, unsigned char *local_priv, unsigned short priv_len)
+int em_configuration_t::derive_wsc_keys(unsigned char *remote_pub, unsigned short pub_len, unsigned char *local_priv, unsigned short priv_len,
+    unsigned char *e_nonce, unsigned char *e_mac, unsigned char *r_nonce, unsigned char *keys)
 {
     unsigned char *secret;
     unsigned short secret_len;
@@ -3144,11 +3402,10 @@ int em_configuration_t::compute_keys(unsigned char *remote_pub, unsigned short p
     size_t length[3];
     unsigned char  dhkey[SHA256_MAC_LEN];
     unsigned char  kdk  [SHA256_MAC_LEN];
-    unsigned char keys[WPS_AUTHKEY_LEN + WPS_KEYWRAPKEY_LEN + WPS_EMSK_LEN];
     char str[] = "Wi-Fi Easy and Secure Key Derivation";
 
     // first compute keys
-    if (compute_secret(&secret, &secret_len, remote_pub, pub_len, local_priv, priv_len) != 1) {
+    if (em_crypto_t::platform_compute_shared_secret(&secret, &secret_len, remote_pub, pub_len, local_priv, static_cast<uint8_t>(priv_len)) != 1) {
         printf("%s:%d: Shared secret computation failed\n", __func__, __LINE__);
         return -1;
     }
@@ -3159,15 +3416,16 @@ int em_configuration_t::compute_keys(unsigned char *remote_pub, unsigned short p
     addr[0] = secret;
     length[0] = static_cast<size_t> (secret_len);
 
-    if (compute_digest(1, addr, length, dhkey) != 1) {
+    if (em_crypto_t::platform_SHA256(1, addr, length, dhkey) != 1) {
         free(secret);
         printf("%s:%d: Hash key computation failed\n", __func__, __LINE__);
         return -1;
     }
+    free(secret);
 
-    addr[0] = get_e_nonce();
-    addr[1] = get_e_mac();
-    addr[2] = get_r_nonce();
+    addr[0] = e_nonce;
+    addr[1] = e_mac;
+    addr[2] = r_nonce;
     length[0] = sizeof(em_nonce_t);
     length[1] = sizeof(mac_address_t);
     length[2] = sizeof(em_nonce_t);
@@ -3181,31 +3439,129 @@ int em_configuration_t::compute_keys(unsigned char *remote_pub, unsigned short p
     //printf("%s:%d: r-nonce:\n", __func__, __LINE__);
     //util::print_hex_dump(length[2], addr[2]);
     
-    if (compute_kdk(dhkey, SHA256_MAC_LEN, 3, addr, length, kdk) != 1) {
-        free(secret);
+    if (em_crypto_t::platform_hmac_SHA256(dhkey, SHA256_MAC_LEN, 3, addr, length, kdk) != 1) {
         printf("%s:%d: kdk computation failed\n", __func__, __LINE__);
         return -1;
     }
 
     //printf("%s:%d: kdk:\n", __func__, __LINE__);
     //util::print_hex_dump(SHA256_MAC_LEN, kdk);
-    if (derive_key(kdk, NULL, 0, str, keys, sizeof(keys)) != 1) {
-        free(secret);
+    if (em_crypto_t::wps_key_derivation_function(kdk, NULL, 0, str, keys, WPS_AUTHKEY_LEN + WPS_KEYWRAPKEY_LEN + WPS_EMSK_LEN) != 1) {
         printf("%s:%d: key derivation failed\n", __func__, __LINE__);
         return -1;
     }
 
+    return 1;
+}
+
+void em_configuration_t::set_wsc_keys(unsigned char *keys)
+{
     memcpy(m_auth_key, keys, WPS_AUTHKEY_LEN);
     memcpy(m_key_wrap_key, keys + WPS_AUTHKEY_LEN, WPS_KEYWRAPKEY_LEN);
     memcpy(m_emsk, keys + WPS_AUTHKEY_LEN + WPS_KEYWRAPKEY_LEN, WPS_EMSK_LEN);
+    // every Encrypted Settings of the exchange is sealed or opened with these schedules
+    if (m_wsc_seal.set_keys(m_auth_key, m_key_wrap_key) != 0) {
+        printf("%s:%d: Encrypted Settings keys setup failed\n", __func__, __LINE__);
+    }
 
     //printf("%s:%d: Encrypt/Decrypt Key:\n", __func__, __LINE__);
     //util::print_hex_dump(WPS_EMSK_LEN, m_emsk);
+}
+
+int em_configuration_t::compute_keys(unsigned char *remote_pub, unsigned short pub_len, unsigned char *local_priv, unsigned short priv_len)
+{
+    unsigned char keys[WPS_AUTHKEY_LEN + WPS_KEYWRAPKEY_LEN + WPS_EMSK_LEN];
+
+    if (derive_wsc_keys(remote_pub, pub_len, local_priv, priv_len, get_e_nonce(), get_e_mac(), get_r_nonce(), keys) != 1) {
+        return -1;
+    }
+    set_wsc_keys(keys);
 
     return 1;
 }
 
-int em_configuration_t::create_autoconfig_wsc_m2_msg(unsigned char *buff, unsigned short msg_id)
+int em_configuration_t::submit_wsc_keys_job(unsigned short msg_id)
+{
+    em_wsc_keys_job_t *job = &m_wsc_keys_job;
+    dm_radio_t *radio;
+    unsigned int i, num_hauls;
+
+    if ((get_e_public_len() > sizeof(job->remote_pub)) || (get_r_private_len() > sizeof(job->local_priv))) {
+        return -1;
+    }
+
+    job->job.run = em_configuration_t::run_wsc_keys_job;
+    job->job.resume = em_configuration_t::resume_wsc_keys_job;
+    job->cfg = this;
+    job->msg_id = msg_id;
+    memcpy(job->remote_pub, get_e_public(), get_e_public_len());
+    job->pub_len = static_cast<unsigned short> (get_e_public_len());
+    memcpy(job->local_priv, get_r_private(), get_r_private_len());
+    job->priv_len = static_cast<unsigned short> (get_r_private_len());
+    memcpy(job->e_nonce, get_e_nonce(), sizeof(em_nonce_t));
+    memcpy(job->e_mac, get_e_mac(), sizeof(mac_address_t));
+    memcpy(job->r_nonce, get_r_nonce(), sizeof(em_nonce_t));
+
+    // the settings of every haul are read from the data model here and sealed by the worker
+    memset(job->plain_len, 0, sizeof(job->plain_len));
+    memset(job->enc_len, 0, sizeof(job->enc_len));
+    radio = get_radio_from_dm();
+    num_hauls = (radio == NULL) ? 0:radio->m_radio_info.number_of_bss;
+    for (i = 0; (i < num_hauls) && (i < em_haul_type_max); i++) {
+        job->plain_len[i] = create_settings_plain(job->plain[i], static_cast<em_haul_type_t> (i));
+    }
+
+    m_wsc_keys_pending = true;
+    if (submit_crypto_job(&job->job) != 0) {
+        m_wsc_keys_pending = false;
+        memset(job->local_priv, 0, sizeof(job->local_priv));
+        memset(job->plain, 0, sizeof(job->plain));
+        return -1;
+    }
+
+    return 0;
+}
+
+void em_configuration_t::run_wsc_keys_job(em_crypto_job_t *job)
+{
+    em_wsc_keys_job_t *j = reinterpret_cast<em_wsc_keys_job_t *> (job);
+    em_wsc_seal_t seal;
+    unsigned int i;
+
+    job->result = derive_wsc_keys(j->remote_pub, j->pub_len, j->local_priv, j->priv_len, j->e_nonce, j->e_mac, j->r_nonce, j->keys);
+    if ((job->result == 1) && (seal.set_keys(j->keys, j->keys + WPS_AUTHKEY_LEN) != 0)) {
+        job->result = 0;
+    }
+    for (i = 0; (job->result == 1) && (i < em_haul_type_max); i++) {
+        if (j->plain_len[i] == 0) {
+            continue;
+        }
+        j->enc_len[i] = seal.seal(j->plain[i], j->plain_len[i], j->enc[i]);
+    }
+    memset(j->plain, 0, sizeof(j->plain));
+}
+
+void em_configuration_t::resume_wsc_keys_job(em_crypto_job_t *job)
+{
+    em_wsc_keys_job_t *j = reinterpret_cast<em_wsc_keys_job_t *> (job);
+    em_configuration_t *cfg = j->cfg;
+
+    cfg->m_wsc_keys_pending = false;
+    memset(j->local_priv, 0, sizeof(j->local_priv));
+
+    if (job->result != 1) {
+        printf("%s:%d: Keys computation failed\n", __func__, __LINE__);
+    } else if (cfg->get_state() != em_state_ctrl_wsc_m1_pending) {
+        // the em was reset while the keys were computed, the agent sends a new M1
+        printf("%s:%d: Dropping keys of M1, state moved to %d\n", __func__, __LINE__, cfg->get_state());
+    } else {
+        cfg->set_wsc_keys(j->keys);
+        cfg->send_autoconfig_wsc_m2(j->msg_id, j);
+    }
+    memset(j->keys, 0, sizeof(j->keys));
+}
+
+int em_configuration_t::create_autoconfig_wsc_m2_msg(unsigned char *buff, unsigned short msg_id, const em_wsc_keys_job_t *job)
 {
     unsigned short  msg_type = em_msg_type_autoconf_wsc;
     int len = 0;
@@ -3217,14 +3573,9 @@ int em_configuration_t::create_autoconfig_wsc_m2_msg(unsigned char *buff, unsign
     unsigned short type = htons(ETH_P_1905);
     dm_radio_t *radio;
 
+    // the keys are computed by the caller, see handle_autoconfig_wsc_m1()
     radio = get_radio_from_dm();
 
-    // first compute keys
-    if (compute_keys(get_e_public(), static_cast<short unsigned int> (get_e_public_len()), get_r_private(), static_cast<short unsigned int> (get_r_private_len())) != 1) {
-        printf("%s:%d: Keys computation failed\n", __func__, __LINE__);
-        return -1;
-    }
-
     memcpy(tmp, const_cast<unsigned char *> (get_peer_mac()), sizeof(mac_address_t));
     tmp += sizeof(mac_address_t);
     len += static_cast<int> (sizeof(mac_address_t));
@@ -3268,7 +3619,7 @@ int em_configuration_t::create_autoconfig_wsc_m2_msg(unsigned char *buff, unsign
     for (i = 0; i < num_hauls; i++) {
         tlv = reinterpret_cast<em_tlv_t *> (tmp);
         tlv->type = em_tlv_type_wsc;
-        sz = create_m2_msg(tlv->value, static_cast<em_haul_type_t> (i));
+        sz = create_m2_msg(tlv->value, static_cast<em_haul_type_t> (i), job);
         if (sz == 0) {
             em_printfout("Not adding haul_type: %d as size returned is 0", i);
             continue;
@@ -3597,60 +3948,87 @@ int em_configuration_t::create_autoconfig_search_msg(unsigned char *buff, em_dpp
 
 int em_configuration_t::handle_wsc_m2(unsigned char *buff, unsigned int len, unsigned int index)
 {
-    data_elem_attr_t    *attr;
-    int ret = 0;
-    unsigned int tmp_len;
-    unsigned short id;
+    em_wsc_attr_index_t attrs;
+    unsigned char *val, *r_nonce, *r_pub, *encrypted, *authenticator;
+    unsigned short val_len, r_nonce_len, r_pub_len, encrypted_len, authenticator_len;
 
     em_printfout("Parsing m2 message, index: %d, len: %d", index, len);
 
-    m_m2_length = len - 12;
-    memcpy(m_m2_msg, buff, m_m2_length);
-    
-    attr = reinterpret_cast<data_elem_attr_t *> (buff); tmp_len = len;
+    if ((index >= em_haul_type_max) || (len < 12) || ((len - 12) > sizeof(m_m2_msg)) ||
+            (index_wsc_attrs(buff, len, &attrs) != 0)) {
+        em_printfout("Malformed m2 message, index: %d, len: %d", index, len);
+        return -1;
+    }
 
-    while (tmp_len > 0) {
+    if (((val = get_wsc_attr(&attrs, attr_id_msg_type, &val_len)) == NULL) || (val_len < 1) ||
+            (val[0] != em_wsc_msg_type_m2)) {
+        return -1;
+    }
 
-        id = htons(attr->id);
+    r_nonce = get_wsc_attr(&attrs, attr_id_registrar_nonce, &r_nonce_len);
+    r_pub = get_wsc_attr(&attrs, attr_id_public_key, &r_pub_len);
+    encrypted = get_wsc_attr(&attrs, attr_id_encrypted_settings, &encrypted_len);
+    authenticator = get_wsc_attr(&attrs, attr_id_authenticator, &authenticator_len);
 
-        if (id == attr_id_version) {
-        } else if (id == attr_id_msg_type) {
-            if (attr->val[0] != em_wsc_msg_type_m2) {
-                return -1;
-            }
-        } else if (id == attr_id_registrar_nonce) {
-            set_r_nonce(attr->val, htons(attr->len));
-        } else if (id == attr_id_public_key) {
-            set_r_public(attr->val, htons(attr->len));
-        } else if (id == attr_id_encrypted_settings) {
-            memcpy(&m_m2_encrypted_settings[index][0], attr->val, htons(attr->len));
-            m_m2_encrypted_settings_len[index] = htons(attr->len);
-            //em_printfout("Copied encrypted setting[%d] len:%d", index, htons(attr->len));
-        } else if (id == attr_id_authenticator) {
-            memcpy(m_m2_authenticator[index], attr->val, htons(attr->len));
-        }
+    if ((r_nonce_len > sizeof(em_nonce_t)) || (r_pub_len > DH_KEY_SZ) ||
+            (encrypted_len > sizeof(m_m2_encrypted_settings[index])) || (authenticator_len > SHA256_MAC_LEN)) {
+        em_printfout("Malformed m2 attribute, index: %d", index);
+        return -1;
+    }
+
+    m_m2_length = len - 12;
+    memcpy(m_m2_msg, buff, m_m2_length);
 
-        tmp_len -= static_cast<unsigned int> (sizeof(data_elem_attr_t) + htons(attr->len));
-        attr = reinterpret_cast<data_elem_attr_t *>(reinterpret_cast<unsigned char *> (attr) + sizeof(data_elem_attr_t) + htons(attr->len));
+    if (r_nonce != NULL) {
+        set_r_nonce(r_nonce, r_nonce_len);
+    }
+    if (r_pub != NULL) {
+        set_r_public(r_pub, r_pub_len);
+    }
+    if (encrypted != NULL) {
+        memcpy(&m_m2_encrypted_settings[index][0], encrypted, encrypted_len);
+        m_m2_encrypted_settings_len[index] = encrypted_len;
+    }
+    if (authenticator != NULL) {
+        memcpy(m_m2_authenticator[index], authenticator, authenticator_len);
     }
 
-    return ret;
+    return 0;
 
 }
 
 int em_configuration_t::handle_wsc_m1(unsigned char *buff, unsigned int len)
 {
-    data_elem_attr_t    *attr;
-    int ret = 0;
-    unsigned int tmp_len;
-    unsigned short id;
-    mac_addr_str_t mac_str;
+    em_wsc_attr_index_t attrs;
+    unsigned char *val;
+    unsigned short val_len;
     em_device_info_t    dev_info;
     dm_easy_mesh_t *dm;
     em_freq_band_t  band;
     dm_radio_t *radio;
     unsigned int found = 0, i  = 0;
 
+    // an M1 that does not parse or lacks what the keys are derived from is dropped before any of it is used
+    if ((len > sizeof(m_m1_msg)) || (index_wsc_attrs(buff, len, &attrs) != 0)) {
+        em_printfout("Malformed m1 message, len: %d", len);
+        return -1;
+    }
+
+    if (((val = get_wsc_attr(&attrs, attr_id_msg_type, &val_len)) == NULL) || (val_len < 1) ||
+            (val[0] != em_wsc_msg_type_m1)) {
+        return -1;
+    }
+
+    if ((((val = get_wsc_attr(&attrs, attr_id_uuid_e, &val_len)) != NULL) && (val_len > sizeof(uuid_t))) ||
+            (((val = get_wsc_attr(&attrs, attr_id_mac_address, &val_len)) == NULL) || (val_len != sizeof(mac_address_t))) ||
+            (((val = get_wsc_attr(&attrs, attr_id_enrollee_nonce, &val_len)) == NULL) || (val_len != sizeof(em_nonce_t))) ||
+            (((val = get_wsc_attr(&attrs, attr_id_public_key, &val_len)) == NULL) || (val_len > DH_KEY_SZ)) ||
+            (((val = get_wsc_attr(&attrs, attr_id_auth_type_flags, &val_len)) != NULL) && (val_len < sizeof(uint16_t))) ||
+            (((val = get_wsc_attr(&attrs, attr_id_rf_bands, &val_len)) != NULL) && (val_len < 1))) {
+        em_printfout("Malformed m1 attribute, len: %d", len);
+        return -1;
+    }
+
 	dm = get_data_model();
 	memset(&dev_info, 0, sizeof(em_device_info_t));
 
@@ -3669,103 +4047,82 @@ int em_configuration_t::handle_wsc_m1(unsigned char *buff, unsigned int len)
 	}
     m_m1_length = len;
     memcpy(m_m1_msg, buff, m_m1_length);
-    
-    attr = reinterpret_cast<data_elem_attr_t *> (buff); tmp_len = len;
 
-    while (tmp_len > 0) {
+    if ((val = get_wsc_attr(&attrs, attr_id_uuid_e, &val_len)) != NULL) {
+        set_e_uuid(val, val_len);
+    }
 
-        id = htons(attr->id);
-        if (id == attr_id_version) {
-        } else if (id == attr_id_msg_type) {
-            if (attr->val[0] != em_wsc_msg_type_m1) {
-                return -1;
-            }
-        } else if (id == attr_id_uuid_e) {
-            set_e_uuid(attr->val, htons(attr->len));
-            //printf("%s:%d: enrollee uuid length:%d\n", __func__, __LINE__, htons(attr->len));
-        } else if (id == attr_id_mac_address) {
-            set_e_mac(attr->val);
-            dm_easy_mesh_t::macbytes_to_string(attr->val, mac_str);
-            //printf("%s:%d: enrollee mac address:%s\n", __func__, __LINE__, mac_str);
-        } else if (id == attr_id_enrollee_nonce) {
-            set_e_nonce(attr->val, htons(attr->len));
-            //printf("%s:%d: enrollee nonce length:%d\n", __func__, __LINE__, htons(attr->len));
-        } else if (id == attr_id_public_key) {
-            set_e_public(attr->val, htons(attr->len));
-            //printf("%s:%d: enrollee public key length:%d\n", __func__, __LINE__, htons(attr->len));
-        } else if (id == attr_id_auth_type_flags) {
-            uint16_t auth_flags = 0;
-            memcpy(&auth_flags, attr->val, sizeof(uint16_t));
-            auth_flags = ntohs(auth_flags);
-            std::vector<std::string> akms = convert_wps_authtype_to_akm_strings(auth_flags);
-            em_printfout("Recieved AKMs: (0x%04x)", auth_flags);
-            for (auto &akm : akms) {
-                printf(" %s", akm.c_str());
-            }
-            printf("\n");
-            if (akms.size() > 0) {
-                for (unsigned int i = 0; i < radio->get_radio_info()->number_of_bss; i++) {
-                    em_bss_info_t* bss_info = dm->get_bss_info(i);
-                    if (bss_info != NULL) {
-                        bss_info->num_fronthaul_akms = static_cast<uint8_t>(akms.size());
-                        bss_info->num_backhaul_akms = static_cast<uint8_t>(akms.size());
-                        em_printfout("BSS %u, Set %zu FH AKMs, Set %zu BH AKMs", i, akms.size(), akms.size());
-                        for (size_t i = 0; i < akms.size(); i++){
-                            snprintf(bss_info->fronthaul_akm[i], sizeof(em_short_string_t), "%s", akms[i].c_str());
-                            snprintf(bss_info->backhaul_akm[i], sizeof(em_short_string_t), "%s", akms[i].c_str());
-                        }
+    set_e_mac(get_wsc_attr(&attrs, attr_id_mac_address, NULL));
+
+    val = get_wsc_attr(&attrs, attr_id_enrollee_nonce, &val_len);
+    set_e_nonce(val, val_len);
+
+    val = get_wsc_attr(&attrs, attr_id_public_key, &val_len);
+    set_e_public(val, val_len);
+
+    if ((val = get_wsc_attr(&attrs, attr_id_auth_type_flags, NULL)) != NULL) {
+        uint16_t auth_flags = 0;
+        memcpy(&auth_flags, val, sizeof(uint16_t));
+        auth_flags = ntohs(auth_flags);
+        std::vector<std::string> akms = convert_wps_authtype_to_akm_strings(auth_flags);
+        em_printfout("Recieved AKMs: (0x%04x)", auth_flags);
+        for (auto &akm : akms) {
+            printf(" %s", akm.c_str());
+        }
+        printf("\n");
+        if (akms.size() > 0) {
+            for (unsigned int i = 0; i < radio->get_radio_info()->number_of_bss; i++) {
+                em_bss_info_t* bss_info = dm->get_bss_info(i);
+                if (bss_info != NULL) {
+                    bss_info->num_fronthaul_akms = static_cast<uint8_t>(akms.size());
+                    bss_info->num_backhaul_akms = static_cast<uint8_t>(akms.size());
+                    em_printfout("BSS %u, Set %zu FH AKMs, Set %zu BH AKMs", i, akms.size(), akms.size());
+                    for (size_t i = 0; i < akms.size(); i++){
+                        snprintf(bss_info->fronthaul_akm[i], sizeof(em_short_string_t), "%s", akms[i].c_str());
+                        snprintf(bss_info->backhaul_akm[i], sizeof(em_short_string_t), "%s", akms[i].c_str());
                     }
                 }
-			    dm->set_db_cfg_param(db_cfg_type_bss_list_update, "");
-            }
-        } else if (id == attr_id_encryption_type_flags) {
-        } else if (id == attr_id_conn_type_flags) {
-        } else if (id == attr_id_cfg_methods) {
-        } else if (id == attr_id_wifi_wsc_state) {
-        } else if (id == attr_id_manufacturer) {
-            memcpy(dev_info.manufacturer, attr->val, htons(attr->len));
-            set_manufacturer(dev_info.manufacturer);
-            //printf("%s:%d: Manufacturer:%s\n", __func__, __LINE__, dev_info.manufacturer);
-            dm->set_db_cfg_param(db_cfg_type_device_list_update, "");
-        } else if (id == attr_id_model_name) {
-            memcpy(dev_info.manufacturer_model, attr->val, htons(attr->len));
-            set_manufacturer_model(dev_info.manufacturer_model);
-            dm->set_db_cfg_param(db_cfg_type_device_list_update, "");
-            //printf("%s:%d: Manufacturer Model:%s\n", __func__, __LINE__, dev_info.manufacturer_model);
-        } else if (id == attr_id_model_number) {
-        } else if (id == attr_id_serial_num) {
-            memcpy(dev_info.serial_number, attr->val, htons(attr->len));
-            set_serial_number(dev_info.serial_number);
-            //printf("%s:%d: Manufacturer:%s\n", __func__, __LINE__, dev_info.serial_number);
-            if( dm->get_colocated() == false )
-            {
-                memcpy(dm->m_device.m_device_info.backhaul_alid.mac, dm->get_ctrl_al_interface_mac(), sizeof(mac_address_t));
             }
+            dm->set_db_cfg_param(db_cfg_type_bss_list_update, "");
+        }
+    }
+
+    if ((val = get_wsc_attr(&attrs, attr_id_manufacturer, &val_len)) != NULL) {
+        snprintf(dev_info.manufacturer, sizeof(dev_info.manufacturer), "%.*s", val_len, val);
+        set_manufacturer(dev_info.manufacturer);
+        dm->set_db_cfg_param(db_cfg_type_device_list_update, "");
+    }
+
+    if ((val = get_wsc_attr(&attrs, attr_id_model_name, &val_len)) != NULL) {
+        snprintf(dev_info.manufacturer_model, sizeof(dev_info.manufacturer_model), "%.*s", val_len, val);
+        set_manufacturer_model(dev_info.manufacturer_model);
+        dm->set_db_cfg_param(db_cfg_type_device_list_update, "");
+    }
 
-            em_printfout("Updated dm dev_info's backhaul_mac: %s and backhaul_alid: %s",
-                util::mac_to_string(dm->m_device.m_device_info.backhaul_mac.mac).c_str(),
-                util::mac_to_string(dm->m_device.m_device_info.backhaul_alid.mac).c_str());
-
-            dm->set_db_cfg_param(db_cfg_type_device_list_update, "");
-        } else if (id == attr_id_primary_device_type) {
-        } else if (id == attr_id_device_name) {
-        } else if (id == attr_id_rf_bands) {
-			band = static_cast<em_freq_band_t> (attr->val[0] >> 1);
-			printf("%s:%d Freq band = %d \n", __func__, __LINE__,band);
-			set_band(band);
-			radio->get_radio_info()->band = band;
-			dm->set_db_cfg_param(db_cfg_type_radio_list_update, "");
-        } else if (id == attr_id_assoc_state) {
-        } else if (id == attr_id_device_password_id) {
-        } else if (id == attr_id_cfg_error) {
-        } else if (id == attr_id_os_version) {
+    if ((val = get_wsc_attr(&attrs, attr_id_serial_num, &val_len)) != NULL) {
+        snprintf(dev_info.serial_number, sizeof(dev_info.serial_number), "%.*s", val_len, val);
+        set_serial_number(dev_info.serial_number);
+        if( dm->get_colocated() == false )
+        {
+            memcpy(dm->m_device.m_device_info.backhaul_alid.mac, dm->get_ctrl_al_interface_mac(), sizeof(mac_address_t));
         }
 
-        tmp_len -= static_cast<unsigned int> (sizeof(data_elem_attr_t) + htons(attr->len));
-        attr = reinterpret_cast<data_elem_attr_t *> (reinterpret_cast<unsigned char *> (attr) + sizeof(data_elem_attr_t) + htons(attr->len));
+        em_printfout("Updated dm dev_info's backhaul_mac: %s and backhaul_alid: %s",
+            util::mac_to_string(dm->m_device.m_device_info.backhaul_mac.mac).c_str(),
+            util::mac_to_string(dm->m_device.m_device_info.backhaul_alid.mac).c_str());
+
+        dm->set_db_cfg_param(db_cfg_type_device_list_update, "");
     }
 
-    return ret;
+    if ((val = get_wsc_attr(&attrs, attr_id_rf_bands, NULL)) != NULL) {
+        band = static_cast<em_freq_band_t> (val[0] >> 1);
+        printf("%s:%d Freq band = %d \n", __func__, __LINE__,band);
+        set_band(band);
+        radio->get_radio_info()->band = band;
+        dm->set_db_cfg_param(db_cfg_type_radio_list_update, "");
+    }
+
+    return 0;
 
 }
 
@@ -3797,7 +4154,10 @@ int em_configuration_t::handle_autoconfig_wsc_m2(unsigned char *buff, unsigned i
             em_printfout("Handle wsc TLV, count: %d", wsc_tlv_count);
             //Storing m2 address and length in static variable;
             set_e_mac(get_radio_interface_mac());
-            handle_wsc_m2(tlv->value, htons(tlv->len), wsc_tlv_count);
+            if (handle_wsc_m2(tlv->value, htons(tlv->len), wsc_tlv_count) != 0) {
+                em_printfout("wsc m2 rejected, count: %d", wsc_tlv_count);
+                return -1;
+            }
 
             // first compute keys
             if (compute_keys(get_r_public(), static_cast<short unsigned int> (get_r_public_len()), get_e_private(), static_cast<short unsigned int> (get_e_private_len())) != 1) {
@@ -3853,9 +4213,10 @@ int em_configuration_t::handle_autoconfig_wsc_m2(unsigned char *buff, unsigned i
 
 int em_configuration_t::handle_encrypted_settings(unsigned int wsc_tlv_count)
 {
-    data_elem_attr_t    *attr;
-    int tmp_len, ret = 0;
-    unsigned short id;
+    em_wsc_attr_index_t attrs;
+    unsigned char *val;
+    unsigned short val_len;
+    int ret = 0;
     char pass[64] = {0};
     unsigned char *plain;
     unsigned short plain_len;
@@ -3871,14 +4232,17 @@ int em_configuration_t::handle_encrypted_settings(unsigned int wsc_tlv_count)
         plain_len = static_cast<short unsigned int> (m_m2_encrypted_settings_len[wsc_index]) - AES_BLOCK_SIZE;
         em_printfout("##handle_encrypted_settings wsc_index:%d plain_len: %d", wsc_index, plain_len);
 
-        // first decrypt the encrypted m2 data
-        if ((plain_len = em_crypto_t::platform_aes_128_cbc_decrypt(m_key_wrap_key, &m_m2_encrypted_settings[wsc_index][0], plain, plain_len)) == 0) {
+        // first decrypt the encrypted m2 data, the key schedule is shared by all of them
+        if ((plain_len = static_cast<unsigned short> (m_wsc_seal.open(m_m2_encrypted_settings[wsc_index],
+                m_m2_encrypted_settings_len[wsc_index]))) == 0) {
             em_printfout("Platform decrypt failed for wsc_tlv:%d", wsc_index);
             return 0;
         }
 
-        attr = reinterpret_cast<data_elem_attr_t *> (plain);
-        tmp_len = plain_len;
+        if (index_wsc_attrs(plain, plain_len, &attrs) != 0) {
+            em_printfout("Malformed encrypted settings for wsc_tlv:%d", wsc_index);
+            return -1;
+        }
 
         // Set the haultype to the wsc index by default
         if (wsc_index >= em_haul_type_max) {
@@ -3886,43 +4250,50 @@ int em_configuration_t::handle_encrypted_settings(unsigned int wsc_tlv_count)
             return 0;
         }
         radioconfig.haultype[wsc_index] = static_cast<em_haul_type_t> (wsc_index);
-        while (tmp_len > 0) {
-            id = htons(attr->id);
-            if (id == attr_id_vendor_ext) {
-                // Handle only em_vendor_oui
-                unsigned short attr_len = htons(attr->len);
-                if ((attr_len > EM_VENDOR_OUI_SIZE) && (memcmp(attr->val, em_vendor_oui, EM_VENDOR_OUI_SIZE) == 0)) {
-                    unsigned char vendor_attr_id = attr->val[EM_VENDOR_OUI_SIZE];
-                    if (vendor_attr_id == vendor_ext_attr_id_haul_type) {
-                        radioconfig.haultype[wsc_index] = static_cast<em_haul_type_t> (attr->val[EM_VENDOR_OUI_SIZE + 1]);
-                        em_printfout("##vendor_ext haul_type attrib[%d]: %d", wsc_index, radioconfig.haultype[wsc_index]);
-                    }
-                }
-            } else if (id == attr_id_ssid) {
-                //If controller does not support no of haultype parameter
-                memcpy(radioconfig.ssid[wsc_index], attr->val, sizeof(radioconfig.ssid[wsc_index]));
-                radioconfig.enable[wsc_index] = true;
-                em_printfout("##ssid attrib[%d]: %s", wsc_index, radioconfig.ssid[wsc_index]);
-                memcpy(radioconfig.radio_mac[wsc_index], get_radio_interface_mac(), sizeof(mac_address_t));
-            } else if (id == attr_id_auth_type) {
-                memcpy(reinterpret_cast<char *> (&auth_type), reinterpret_cast<unsigned char *> (attr->val), htons(attr->len));
-                radioconfig.authtype[wsc_index] = static_cast<unsigned int>(auth_type);
-                em_printfout("##authtype[%d]: %x", wsc_index, radioconfig.authtype[wsc_index]);
-            } else if (id == attr_id_encryption_type) {
-                em_printfout("##encr type attrib for wsc_index:%d", wsc_index);
-            } else if (id == attr_id_network_key) {
-                memcpy(pass, attr->val, htons(attr->len));
-                memcpy(radioconfig.password[wsc_index], attr->val, htons(attr->len));
-                em_printfout("##network key[%d]: %s", wsc_index, pass);
-            } else if (id == attr_id_mac_address) {
-                memcpy(radioconfig.radio_mac[wsc_index], attr->val, sizeof(mac_address_t));
-                em_printfout("##mac address[%d]: %s", wsc_index, util::mac_to_string(radioconfig.radio_mac[wsc_index]).c_str());
-            } else if (id == attr_id_key_wrap_authenticator) {
-                radioconfig.key_wrap_authenticator[wsc_index] = attr->val[0];
-                em_printfout("##key wrap auth[%d]: %u", wsc_index, radioconfig.key_wrap_authenticator[wsc_index]);
+
+        // Handle only em_vendor_oui, other vendors may add extensions of their own
+        for (val = get_wsc_attr(&attrs, attr_id_vendor_ext, &val_len); val != NULL;
+                val = get_next_wsc_attr(&attrs, attr_id_vendor_ext, val, &val_len)) {
+            if ((val_len > (EM_VENDOR_OUI_SIZE + 1)) && (memcmp(val, em_vendor_oui, EM_VENDOR_OUI_SIZE) == 0) &&
+                    (val[EM_VENDOR_OUI_SIZE] == vendor_ext_attr_id_haul_type)) {
+                radioconfig.haultype[wsc_index] = static_cast<em_haul_type_t> (val[EM_VENDOR_OUI_SIZE + 1]);
+                em_printfout("##vendor_ext haul_type attrib[%d]: %d", wsc_index, radioconfig.haultype[wsc_index]);
+                break;
             }
-            tmp_len -= static_cast<int> (sizeof(data_elem_attr_t) + htons(attr->len));
-            attr = reinterpret_cast<data_elem_attr_t *> (reinterpret_cast<unsigned char *>(attr) + sizeof(data_elem_attr_t) + htons(attr->len));
+        }
+
+        if ((val = get_wsc_attr(&attrs, attr_id_ssid, &val_len)) != NULL) {
+            //If controller does not support no of haultype parameter
+            snprintf(radioconfig.ssid[wsc_index], sizeof(radioconfig.ssid[wsc_index]), "%.*s", val_len, val);
+            radioconfig.enable[wsc_index] = true;
+            em_printfout("##ssid attrib[%d]: %s", wsc_index, radioconfig.ssid[wsc_index]);
+            memcpy(radioconfig.radio_mac[wsc_index], get_radio_interface_mac(), sizeof(mac_address_t));
+        }
+
+        if (((val = get_wsc_attr(&attrs, attr_id_auth_type, &val_len)) != NULL) && (val_len >= sizeof(auth_type))) {
+            memcpy(reinterpret_cast<char *> (&auth_type), val, sizeof(auth_type));
+            radioconfig.authtype[wsc_index] = static_cast<unsigned int>(auth_type);
+            em_printfout("##authtype[%d]: %x", wsc_index, radioconfig.authtype[wsc_index]);
+        }
+
+        if (get_wsc_attr(&attrs, attr_id_encryption_type, NULL) != NULL) {
+            em_printfout("##encr type attrib for wsc_index:%d", wsc_index);
+        }
+
+        if ((val = get_wsc_attr(&attrs, attr_id_network_key, &val_len)) != NULL) {
+            snprintf(pass, sizeof(pass), "%.*s", val_len, val);
+            snprintf(radioconfig.password[wsc_index], sizeof(radioconfig.password[wsc_index]), "%.*s", val_len, val);
+            em_printfout("##network key[%d]: %s", wsc_index, pass);
+        }
+
+        if (((val = get_wsc_attr(&attrs, attr_id_mac_address, &val_len)) != NULL) && (val_len >= sizeof(mac_address_t))) {
+            memcpy(radioconfig.radio_mac[wsc_index], val, sizeof(mac_address_t));
+            em_printfout("##mac address[%d]: %s", wsc_index, util::mac_to_string(radioconfig.radio_mac[wsc_index]).c_str());
+        }
+
+        if (((val = get_wsc_attr(&attrs, attr_id_key_wrap_authenticator, &val_len)) != NULL) && (val_len > 0)) {
+            radioconfig.key_wrap_authenticator[wsc_index] = val[0];
+            em_printfout("##key wrap auth[%d]: %u", wsc_index, radioconfig.key_wrap_authenticator[wsc_index]);
         }
         radioconfig.noofbssconfig++;
     }
@@ -4655,24 +5026,33 @@ int em_configuration_t::handle_agent_list_msg(uint8_t *buff, unsigned int len, u
 }
 
 int em_configuration_t::create_encrypted_settings(unsigned char *buff, em_haul_type_t haul_type)
+{
+    unsigned char plain[MAX_EM_BUFF_SZ];
+    unsigned int plain_len, len;
+
+    if ((plain_len = create_settings_plain(plain, haul_type)) == 0) {
+        return 0;
+    }
+    len = m_wsc_seal.seal(plain, plain_len, buff);
+    memset(plain, 0, sizeof(plain));
+
+    return static_cast<int> (len);
+}
+
+unsigned int em_configuration_t::create_settings_plain(unsigned char *plain, em_haul_type_t haul_type)
 {
     data_elem_attr_t *attr;
     short len = 0;
     unsigned char *tmp;
-    unsigned int size = 0, cipher_len, plain_len;
-    unsigned char iv[AES_BLOCK_SIZE];
-    unsigned char plain[MAX_EM_BUFF_SZ];
+    unsigned int size = 0;
     unsigned short auth_type = 0x0200; // WPA3-Personal
-    unsigned char hash[SHA256_MAC_LEN];
-    unsigned char *keywrap_data_addr[1];
-    size_t keywrap_data_length[1];
     em_network_ssid_info_t *net_ssid_info;
     memset(plain, 0, MAX_EM_BUFF_SZ);
     tmp = plain;
     len = 0;
 
     dm_easy_mesh_t *dm = get_data_model();
-    unsigned int no_of_haultype = 0, radio_exists, i;
+    unsigned int radio_exists = false, i;
     dm_radio_t * radio = NULL;
 
     for (i = 0; i < dm->get_num_radios(); i++) {
@@ -4684,7 +5064,7 @@ int em_configuration_t::create_encrypted_settings(unsigned char *buff, em_haul_t
     }
     if (radio_exists == false) {
         em_printfout("Radio does not exist, return len as 0.");
-        return len;
+        return 0;
     }
     em_printfout("radio:%s haul_type=%d radio no of bss=%d",
         util::mac_to_string(get_radio_interface_mac()).c_str(), haul_type, radio->m_radio_info.number_of_bss);
@@ -4757,40 +5137,7 @@ int em_configuration_t::create_encrypted_settings(unsigned char *buff, em_haul_t
     len += static_cast<short> (sizeof(data_elem_attr_t) + size);
     tmp += (sizeof(data_elem_attr_t) + size);
 
-    // key wrap
-    keywrap_data_addr[0] = plain;
-    keywrap_data_length[0] = static_cast<size_t> (len);
-    if (em_crypto_t::platform_hmac_SHA256(m_auth_key, WPS_AUTHKEY_LEN, 1, keywrap_data_addr, keywrap_data_length, hash) != 1) {
-	    printf("%s:%d: Authenticator create failed\n", __func__, __LINE__);
-	    return 0;
-    }
-    attr = reinterpret_cast<data_elem_attr_t *> (tmp);
-    attr->id = htons(attr_id_key_wrap_authenticator);
-    size = EM_KEY_WRAP_TLV_LEN;
-    attr->len = htons(static_cast<short unsigned int> (size));
-    memcpy(reinterpret_cast<char *> (attr->val), const_cast<unsigned char *> (hash), EM_KEY_WRAP_TLV_LEN);
-
-    len += static_cast<short> (sizeof(data_elem_attr_t) + size);
-    tmp += (sizeof(data_elem_attr_t) + size);
-
-    if (em_crypto_t::generate_iv(iv, AES_BLOCK_SIZE) != 1) {
-	    printf("%s:%d: iv generate failed\n", __func__, __LINE__);
-	    return 0;
-    }
-
-    memcpy(buff, iv, AES_BLOCK_SIZE);
-
-    plain_len = static_cast<unsigned int> (len);
-
-    // encrypt the m2 data
-    if (em_crypto_t::platform_aes_128_cbc_encrypt(m_key_wrap_key, iv, plain, plain_len, buff + AES_BLOCK_SIZE, &cipher_len) != 1) {
-	    printf("%s:%d: platform encrypt failed\n", __func__, __LINE__);
-	    return 0;
-    }
-
-    em_printfout("Encrypted for radio:%s haul_type:%d length:%u plain_len:%u",
-        util::mac_to_string(get_radio_interface_mac()).c_str(), haul_type, cipher_len + AES_BLOCK_SIZE, plain_len);
-    return static_cast<int> (cipher_len) + AES_BLOCK_SIZE;
+    return static_cast<unsigned int> (len);
 }
 
 uint32_t em_configuration_t::get_Auth_type_hex(const char *security_mode) {
@@ -4832,34 +5179,123 @@ em_wsc_msg_type_t em_configuration_t::get_wsc_msg_type(unsigned char *buff, unsi
 {
     em_tlv_t    *tlv;
     data_elem_attr_t    *attr;
-    unsigned int tmp_len_tlvs, tmp_len_attribs;
+    unsigned int tmp_len_tlvs, tmp_len_attribs, tlv_len, attr_len;
 
     tlv = reinterpret_cast<em_tlv_t *> (buff); tmp_len_tlvs = len;
 
-    while ((tlv->type != em_tlv_type_eom) && (tmp_len_tlvs > 0)) {
+    while (tmp_len_tlvs >= sizeof(em_tlv_t)) {
+        tlv_len = htons(tlv->len);
+        if ((tlv->type == em_tlv_type_eom) || ((sizeof(em_tlv_t) + tlv_len) > tmp_len_tlvs)) {
+            break;
+        }
+
         if (tlv->type == em_tlv_type_wsc) {
-            tmp_len_attribs = tlv->len;
+            tmp_len_attribs = tlv_len;
             attr = reinterpret_cast<data_elem_attr_t *> (tlv->value);
 
-            while (tmp_len_attribs > 0) {
+            while (tmp_len_attribs >= sizeof(data_elem_attr_t)) {
+                attr_len = htons(attr->len);
+                if ((sizeof(data_elem_attr_t) + attr_len) > tmp_len_attribs) {
+                    break;
+                }
 
-                if (htons(attr->id) == attr_id_msg_type) {
+                if ((htons(attr->id) == attr_id_msg_type) && (attr_len > 0)) {
                     return static_cast<em_wsc_msg_type_t> (attr->val[0]);
                 }
 
-                tmp_len_attribs -=  static_cast<unsigned int> (sizeof(data_elem_attr_t) + htons(attr->len));
-                attr = reinterpret_cast<data_elem_attr_t *> (reinterpret_cast<unsigned char *> (attr) + sizeof(data_elem_attr_t) + htons(attr->len));
+                tmp_len_attribs -=  static_cast<unsigned int> (sizeof(data_elem_attr_t) + attr_len);
+                attr = reinterpret_cast<data_elem_attr_t *> (reinterpret_cast<unsigned char *> (attr) + sizeof(data_elem_attr_t) + attr_len);
             }
         }
 
-        tmp_len_tlvs -= static_cast<unsigned int> (sizeof(em_tlv_t) + htons(tlv->len));
-        tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
+        tmp_len_tlvs -= static_cast<unsigned int> (sizeof(em_tlv_t) + tlv_len);
+        tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + tlv_len);
 
     }
 
     return em_wsc_msg_type_none;
 }
 
+int em_configuration_t::index_wsc_attrs(unsigned char *buff, unsigned int len, em_wsc_attr_index_t *index)
+{
+    data_elem_attr_t *attr;
+    unsigned int offset = 0, attr_len, id;
+
+    memset(index, 0, sizeof(em_wsc_attr_index_t));
+    index->buff = buff;
+    index->len = len;
+
+    if (len > USHRT_MAX) {
+        return -1;
+    }
+
+    while (offset < len) {
+        if ((len - offset) < sizeof(data_elem_attr_t)) {
+            return -1;
+        }
+        attr = reinterpret_cast<data_elem_attr_t *> (buff + offset);
+        attr_len = ntohs(attr->len);
+        if ((len - offset - sizeof(data_elem_attr_t)) < attr_len) {
+            return -1;
+        }
+
+        id = ntohs(attr->id);
+        if ((id >= attr_id_ap_channel) && ((id - attr_id_ap_channel) < EM_WSC_ATTR_INDEX_SZ) &&
+                (index->attr[id - attr_id_ap_channel].offset == 0)) {
+            index->attr[id - attr_id_ap_channel].offset = static_cast<unsigned short> (offset + sizeof(data_elem_attr_t));
+            index->attr[id - attr_id_ap_channel].len = static_cast<unsigned short> (attr_len);
+        }
+
+        index->num++;
+        offset += static_cast<unsigned int> (sizeof(data_elem_attr_t)) + attr_len;
+    }
+
+    return 0;
+}
+
+unsigned char *em_configuration_t::get_wsc_attr(const em_wsc_attr_index_t *index, data_elem_attr_id_t id, unsigned short *len)
+{
+    const em_wsc_attr_ref_t *ref;
+
+    if ((id < attr_id_ap_channel) || ((id - attr_id_ap_channel) >= EM_WSC_ATTR_INDEX_SZ)) {
+        return NULL;
+    }
+
+    ref = &index->attr[id - attr_id_ap_channel];
+    if (len != NULL) {
+        *len = ref->len;
+    }
+
+    return (ref->offset == 0) ? NULL:index->buff + ref->offset;
+}
+
+unsigned char *em_configuration_t::get_next_wsc_attr(const em_wsc_attr_index_t *index, data_elem_attr_id_t id, unsigned char *prev, unsigned short *len)
+{
+    data_elem_attr_t *attr;
+    unsigned int offset;
+
+    // the message was checked by index_wsc_attrs(), the repeats are rare enough to be looked for in place
+    attr = reinterpret_cast<data_elem_attr_t *> (prev - sizeof(data_elem_attr_t));
+    offset = static_cast<unsigned int> (prev - index->buff) + ntohs(attr->len);
+
+    while (offset < index->len) {
+        attr = reinterpret_cast<data_elem_attr_t *> (index->buff + offset);
+        if (ntohs(attr->id) == id) {
+            if (len != NULL) {
+                *len = ntohs(attr->len);
+            }
+            return attr->val;
+        }
+        offset += static_cast<unsigned int> (sizeof(data_elem_attr_t)) + ntohs(attr->len);
+    }
+
+    if (len != NULL) {
+        *len = 0;
+    }
+
+    return NULL;
+}
+
 int em_configuration_t::handle_ap_radio_advanced_cap(unsigned char *buff, unsigned int len)
 {
     //dm_easy_mesh_t *dm;
@@ -4938,7 +5374,8 @@ int em_configuration_t::handle_ap_radio_basic_cap(unsigned char *buff, unsigned
 				dm->set_num_op_class(dm->get_num_op_class() + 1);
 			}
 			memcpy(&op_class_obj->m_op_class_info, &op_class_info, sizeof(em_op_class_info_t));
-			dm->set_db_cfg_param(db_cfg_type_op_class_list_update, "");
+			dm->index_op_class(static_cast<unsigned int> (op_class_obj - dm->m_op_class));
+			dm->set_op_class_dirty(static_cast<unsigned int> (op_class_obj - dm->m_op_class));
 		}
 	} else {
 		printf("%s:%d basic_cap_op_class is NULL \n", __func__, __LINE__);
@@ -4949,18 +5386,21 @@ int em_configuration_t::handle_ap_radio_basic_cap(unsigned char *buff, unsigned
 
 int em_configuration_t::handle_autoconfig_wsc_m1(unsigned char *buff, unsigned int len)
 {
-    unsigned char msg[MAX_EM_BUFF_SZ*em_haul_type_max];
-    unsigned int sz;
     char *errors[EM_MAX_TLV_MEMBERS] = {0};
     mac_addr_str_t  mac_str;
     em_tlv_t    *tlv;
     unsigned int tlv_len;
-    em_bus_event_type_m2_tx_params_t   raw;
 
 
     dm_easy_mesh_t::macbytes_to_string(get_peer_mac(), mac_str);
     printf("%s:%d: Device AL MAC: %s\n", __func__, __LINE__, mac_str);
 
+    if (m_wsc_keys_pending == true) {
+        // retransmission of the M1 whose M2 is about to be sent
+        printf("%s:%d: Keys of the previous M1 are being computed, ignoring M1\n", __func__, __LINE__);
+        return 0;
+    }
+
     if (em_msg_t(em_msg_type_autoconf_wsc, em_profile_type_3, buff, len).validate(errors) == 0) {
         printf("%s:%d: received autoconfig wsc m1 msg failed validation\n", __func__, __LINE__);
 
@@ -4975,7 +5415,10 @@ int em_configuration_t::handle_autoconfig_wsc_m1(unsigned char *buff, unsigned i
         if (tlv->type == em_tlv_type_ap_radio_basic_cap) {
             handle_ap_radio_basic_cap(tlv->value, htons(tlv->len));
         } else if (tlv->type == em_tlv_type_wsc) {
-            handle_wsc_m1(tlv->value, htons(tlv->len));
+            if (handle_wsc_m1(tlv->value, htons(tlv->len)) != 0) {
+                printf("%s:%d: wsc m1 rejected\n", __func__, __LINE__);
+                return -1;
+            }
         } else if (tlv->type == em_tlv_type_profile_2_ap_cap) {
         } else if (tlv->type == em_tlv_type_ap_radio_advanced_cap) {
             handle_ap_radio_advanced_cap(tlv->value, htons(tlv->len));
@@ -4985,7 +5428,27 @@ int em_configuration_t::handle_autoconfig_wsc_m1(unsigned char *buff, unsigned i
         tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
     }
 
-    sz = static_cast<unsigned int> (create_autoconfig_wsc_m2_msg(msg, ntohs(cmdu->id)));
+    // the DH computation runs on the crypto pool so that an onboarding storm does not stall the ems
+    if (submit_wsc_keys_job(ntohs(cmdu->id)) == 0) {
+        return 0;
+    }
+
+    if (compute_keys(get_e_public(), static_cast<short unsigned int> (get_e_public_len()), get_r_private(), static_cast<short unsigned int> (get_r_private_len())) != 1) {
+        printf("%s:%d: Keys computation failed\n", __func__, __LINE__);
+        return -1;
+    }
+
+    return send_autoconfig_wsc_m2(ntohs(cmdu->id));
+}
+
+int em_configuration_t::send_autoconfig_wsc_m2(unsigned short msg_id, const em_wsc_keys_job_t *job)
+{
+    unsigned char msg[MAX_EM_BUFF_SZ*em_haul_type_max];
+    unsigned int sz;
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    em_bus_event_type_m2_tx_params_t   raw;
+
+    sz = static_cast<unsigned int> (create_autoconfig_wsc_m2_msg(msg, msg_id, job));
 
     if (em_msg_t(em_msg_type_autoconf_wsc, em_profile_type_3, msg, sz).validate(errors) == 0) {
         printf("Autoconfig wsc m2 msg failed validation in tnx end\n");
@@ -5157,6 +5620,8 @@ void em_configuration_t::process_msg(unsigned char *data, unsigned int len)
 {
     unsigned char *tlvs;
     unsigned int tlvs_len;
+    int changed;
+    em_topo_sched_agent_t sched;
 
     em_cmdu_t *cmdu = reinterpret_cast<em_cmdu_t *>(data + sizeof(em_raw_hdr_t));
             
@@ -5230,7 +5695,7 @@ void em_configuration_t::process_msg(unsigned char *data, unsigned int len)
 
         case em_msg_type_topo_resp:
             if ((get_service_type() == em_service_type_ctrl) && (get_state() == em_state_ctrl_topo_sync_pending)){
-                if (handle_topology_response(data, len) == 0) {
+                if ((changed = handle_topology_response(data, len)) >= 0) {
                     set_state(em_state_ctrl_topo_synchronized);
                     std::vector<em_t *> em_radios;
                     dm_easy_mesh_t *dm = get_data_model();
@@ -5243,19 +5708,33 @@ void em_configuration_t::process_msg(unsigned char *data, unsigned int len)
                         printf("%s:%d em_msg_type_topo_resp handle success, state: %s\n", __func__, __LINE__, em_t::state_2_str(em->get_state()));
                     }
                     em_radios.clear();
-                    // update network topology here
-                    get_mgr()->update_network_topology();
-                    dm->set_topo_state(true);
-                    dm->set_db_cfg_param(db_cfg_type_device_list_update, "");
+                    // the agent is onboarded, its topology is queried from now on, at the period its route sets
+                    get_mgr()->get_topo_sched()->add(hdr->src, em_timer_wheel_t::get_time_ms());
+                    // an unchanged response has nothing to publish, the changed rows are already marked
+                    if (changed > 0) {
+                        get_mgr()->update_network_topology();
+                        dm->set_topo_state(true);
+                    }
                 } else {
                     printf("%s:%d em_msg_type_topo_resp handle failed \n", __func__, __LINE__);
                 }
+            } else if ((get_service_type() == em_service_type_ctrl) && (get_state() >= em_state_ctrl_configured) &&
+                    (get_mgr()->get_topo_sched()->get_agent(hdr->src, &sched) == true) && (sched.outstanding == true)) {
+                // answer to a query of em_topo_sched_t, sent by any radio of the agent, the states are left as they are
+                changed = handle_topology_response(data, len);
+                if (changed > 0) {
+                    get_mgr()->update_network_topology();
+                    get_data_model()->set_topo_state(true);
+                }
+                get_mgr()->get_topo_sched()->answered(hdr->src, changed > 0, em_timer_wheel_t::get_time_ms());
             }
             break;
 
         case em_msg_type_topo_notif:
             if ((get_service_type() == em_service_type_ctrl) && (get_state() >= em_state_ctrl_topo_synchronized)) {
                 handle_topology_notification(data, len);
+                // the notification only tells about one change, the query picks up the rest
+                get_mgr()->get_topo_sched()->notified(hdr->src, em_timer_wheel_t::get_time_ms());
             }
             break;
         
@@ -5519,6 +5998,12 @@ em_configuration_t::em_configuration_t()
 {
     m_renew_tx_cnt = 0;
     m_topo_query_tx_cnt = 0;
+    memset(&m_wsc_keys_job, 0, sizeof(em_wsc_keys_job_t));
+    m_wsc_keys_pending = false;
+    m_num_topo_notif_events = 0;
+    m_topo_notif_sent_ms = 0;
+    m_topo_query_requested = false;
+    m_t2lm_requested = false;
 }
 
 em_configuration_t::~em_configuration_t()
@@ -0,0 +1,307 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <openssl/crypto.h>
+#include "em_1905_key_table.h"
+#include "em_crypto.h"
+
+void em_1905_key_table_t::put_counter(unsigned char *buff, unsigned long long counter)
+{
+    int i;
+
+    for (i = EM_1905_COUNTER_LEN - 1; i >= 0; i--) {
+        buff[i] = static_cast<unsigned char> (counter);
+        counter >>= 8;
+    }
+}
+
+unsigned long long em_1905_key_table_t::get_counter(const unsigned char *buff)
+{
+    unsigned long long counter = 0;
+    unsigned int i;
+
+    for (i = 0; i < EM_1905_COUNTER_LEN; i++) {
+        counter = (counter << 8) | buff[i];
+    }
+
+    return counter;
+}
+
+int em_1905_key_table_t::install_ptk(const unsigned char *peer, const unsigned char *tk, unsigned int len)
+{
+    em_1905_peer_keys_t *keys;
+
+    if (len < EM_1905_TK_LEN) {
+        return -1;
+    }
+
+    keys = &m_peers[em_hex::pack_mac(peer)];
+    if (keys->keyed == true) {
+        siv_free(&keys->siv);
+        keys->keyed = false;
+    }
+    if (siv_init(&keys->siv, tk, SIV_256) != 1) {
+        siv_free(&keys->siv);
+        return -1;
+    }
+    keys->keyed = true;
+    keys->tx_counter = 0;
+    keys->rx_counter = 0;
+
+    return 0;
+}
+
+int em_1905_key_table_t::install_gtk(const unsigned char *peer, const unsigned char *gtk, unsigned int len,
+                                     unsigned char key_id, unsigned long long rx_counter)
+{
+    em_1905_peer_keys_t *keys;
+
+    if ((len < EM_1905_GTK_LEN) || (key_id < 1) || (key_id > 3)) {
+        return -1;
+    }
+
+    // the local counter restarts with a new group key only
+    if ((key_id != m_gtk_id) || (memcmp(m_gtk, gtk, EM_1905_GTK_LEN) != 0)) {
+        memcpy(m_gtk, gtk, EM_1905_GTK_LEN);
+        m_gtk_id = key_id;
+        m_gtk_tx_counter = 0;
+    }
+
+    keys = &m_peers[em_hex::pack_mac(peer)];
+    keys->rx_mic_counter = rx_counter;
+
+    return 0;
+}
+
+void em_1905_key_table_t::remove(const unsigned char *peer)
+{
+    std::unordered_map<em_packed_mac_t, em_1905_peer_keys_t>::iterator it;
+
+    if ((it = m_peers.find(em_hex::pack_mac(peer))) == m_peers.end()) {
+        return;
+    }
+    if (it->second.keyed == true) {
+        siv_free(&it->second.siv);
+    }
+    m_peers.erase(it);
+}
+
+const em_1905_peer_keys_t *em_1905_key_table_t::get_peer(const unsigned char *peer)
+{
+    std::unordered_map<em_packed_mac_t, em_1905_peer_keys_t>::iterator it;
+
+    if ((it = m_peers.find(em_hex::pack_mac(peer))) == m_peers.end()) {
+        return NULL;
+    }
+
+    return &it->second;
+}
+
+int em_1905_key_table_t::encrypt(const unsigned char *peer, const unsigned char *cmdu, const unsigned char *plain,
+                                 unsigned int len, unsigned char *value, unsigned int size)
+{
+    std::unordered_map<em_packed_mac_t, em_1905_peer_keys_t>::iterator it;
+    em_1905_peer_keys_t *keys;
+    unsigned char *tmp = value;
+    unsigned short siv_len;
+
+    if ((it = m_peers.find(em_hex::pack_mac(peer))) == m_peers.end() || (it->second.keyed == false)) {
+        m_stats.no_key++;
+        return -1;
+    }
+    keys = &it->second;
+
+    if ((len > 0xffff - AES_BLOCK_SIZE) || (size < EM_1905_ENCR_HDR_LEN + AES_BLOCK_SIZE + len) ||
+            (keys->tx_counter >= EM_1905_MAX_COUNTER)) {
+        return -1;
+    }
+
+    keys->tx_counter++;
+    put_counter(tmp, keys->tx_counter);
+    tmp += EM_1905_COUNTER_LEN;
+    memcpy(tmp, m_al_mac, sizeof(mac_address_t));
+    tmp += sizeof(mac_address_t);
+    memcpy(tmp, peer, sizeof(mac_address_t));
+    tmp += sizeof(mac_address_t);
+    siv_len = htons(static_cast<unsigned short> (AES_BLOCK_SIZE + len));
+    memcpy(tmp, &siv_len, sizeof(unsigned short));
+    tmp += sizeof(unsigned short);
+
+    // the synthetic IV leads the output, the ciphertext follows
+    siv_encrypt(&keys->siv, plain, tmp + AES_BLOCK_SIZE, static_cast<int> (len), tmp, 4,
+        cmdu, EM_1905_AAD_HDR_LEN, value, EM_1905_COUNTER_LEN, value + EM_1905_COUNTER_LEN, sizeof(mac_address_t),
+        value + EM_1905_COUNTER_LEN + sizeof(mac_address_t), sizeof(mac_address_t));
+    m_stats.encrypted++;
+
+    return static_cast<int> (EM_1905_ENCR_HDR_LEN + AES_BLOCK_SIZE + len);
+}
+
+int em_1905_key_table_t::decrypt(const unsigned char *cmdu, const unsigned char *value, unsigned int len,
+                                 unsigned char *plain, unsigned int size)
+{
+    std::unordered_map<em_packed_mac_t, em_1905_peer_keys_t>::iterator it;
+    em_1905_peer_keys_t *keys;
+    const unsigned char *src = value + EM_1905_COUNTER_LEN, *dst = src + sizeof(mac_address_t);
+    unsigned char iv[AES_BLOCK_SIZE];
+    unsigned long long counter;
+    unsigned short siv_len;
+    unsigned int plain_len;
+
+    if (len < EM_1905_ENCR_HDR_LEN + AES_BLOCK_SIZE) {
+        return -1;
+    }
+    memcpy(&siv_len, dst + sizeof(mac_address_t), sizeof(unsigned short));
+    siv_len = ntohs(siv_len);
+    if ((siv_len < AES_BLOCK_SIZE) || (EM_1905_ENCR_HDR_LEN + siv_len > len) ||
+            (memcmp(dst, m_al_mac, sizeof(mac_address_t)) != 0)) {
+        return -1;
+    }
+    plain_len = siv_len - AES_BLOCK_SIZE;
+    if (plain_len > size) {
+        return -1;
+    }
+
+    if ((it = m_peers.find(em_hex::pack_mac(src))) == m_peers.end() || (it->second.keyed == false)) {
+        m_stats.no_key++;
+        return -1;
+    }
+    keys = &it->second;
+
+    if ((counter = get_counter(value)) <= keys->rx_counter) {
+        m_stats.replays++;
+        return -1;
+    }
+
+    memcpy(iv, value + EM_1905_ENCR_HDR_LEN, AES_BLOCK_SIZE);
+    if (siv_decrypt(&keys->siv, value + EM_1905_ENCR_HDR_LEN + AES_BLOCK_SIZE, plain, static_cast<int> (plain_len), iv, 4,
+            cmdu, EM_1905_AAD_HDR_LEN, value, EM_1905_COUNTER_LEN, src, sizeof(mac_address_t),
+            dst, sizeof(mac_address_t)) != 1) {
+        m_stats.failures++;
+        return -1;
+    }
+    keys->rx_counter = counter;
+    m_stats.decrypted++;
+
+    return static_cast<int> (plain_len);
+}
+
+int em_1905_key_table_t::add_mic(const unsigned char *cmdu, const unsigned char *tlvs, unsigned int len,
+                                 unsigned char *value, unsigned int size)
+{
+    unsigned char *tmp = value;
+    unsigned char *addr[3];
+    size_t addr_len[3];
+    unsigned short mic_len;
+
+    if ((m_gtk_id == 0) || (size < EM_1905_MIC_HDR_LEN + EM_1905_MIC_LEN) || (m_gtk_tx_counter >= EM_1905_MAX_COUNTER)) {
+        return -1;
+    }
+
+    m_gtk_tx_counter++;
+    // GTK Key ID in the two upper bits, MIC version 1 is 0
+    *tmp++ = static_cast<unsigned char> (m_gtk_id << 6);
+    put_counter(tmp, m_gtk_tx_counter);
+    tmp += EM_1905_COUNTER_LEN;
+    memcpy(tmp, m_al_mac, sizeof(mac_address_t));
+    tmp += sizeof(mac_address_t);
+    mic_len = htons(EM_1905_MIC_LEN);
+    memcpy(tmp, &mic_len, sizeof(unsigned short));
+    tmp += sizeof(unsigned short);
+
+    addr[0] = const_cast<unsigned char *> (cmdu);
+    addr_len[0] = EM_1905_AAD_HDR_LEN;
+    addr[1] = value;
+    addr_len[1] = 1 + EM_1905_COUNTER_LEN + sizeof(mac_address_t);
+    addr[2] = const_cast<unsigned char *> (tlvs);
+    addr_len[2] = len;
+    if (em_crypto_t::platform_hmac_SHA256(m_gtk, EM_1905_GTK_LEN, 3, addr, addr_len, tmp) != 1) {
+        return -1;
+    }
+    m_stats.protected_mics++;
+
+    return static_cast<int> (EM_1905_MIC_HDR_LEN + EM_1905_MIC_LEN);
+}
+
+int em_1905_key_table_t::check_mic(const unsigned char *cmdu, const unsigned char *tlvs, unsigned int len,
+                                   const unsigned char *value, unsigned int value_len)
+{
+    std::unordered_map<em_packed_mac_t, em_1905_peer_keys_t>::iterator it;
+    const unsigned char *src = value + 1 + EM_1905_COUNTER_LEN;
+    unsigned char mic[EM_1905_MIC_LEN];
+    unsigned char *addr[3];
+    size_t addr_len[3];
+    unsigned long long counter;
+    unsigned short mic_len;
+
+    if (value_len < EM_1905_MIC_HDR_LEN + EM_1905_MIC_LEN) {
+        return -1;
+    }
+    memcpy(&mic_len, src + sizeof(mac_address_t), sizeof(unsigned short));
+    if ((ntohs(mic_len) != EM_1905_MIC_LEN) || (EM_1905_MIC_HDR_LEN + EM_1905_MIC_LEN > value_len)) {
+        return -1;
+    }
+
+    if ((m_gtk_id == 0) || ((value[0] >> 6) != m_gtk_id) ||
+            ((it = m_peers.find(em_hex::pack_mac(src))) == m_peers.end())) {
+        m_stats.no_key++;
+        return -1;
+    }
+
+    if ((counter = get_counter(value + 1)) <= it->second.rx_mic_counter) {
+        m_stats.replays++;
+        return -1;
+    }
+
+    addr[0] = const_cast<unsigned char *> (cmdu);
+    addr_len[0] = EM_1905_AAD_HDR_LEN;
+    addr[1] = const_cast<unsigned char *> (value);
+    addr_len[1] = 1 + EM_1905_COUNTER_LEN + sizeof(mac_address_t);
+    addr[2] = const_cast<unsigned char *> (tlvs);
+    addr_len[2] = len;
+    if ((em_crypto_t::platform_hmac_SHA256(m_gtk, EM_1905_GTK_LEN, 3, addr, addr_len, mic) != 1) ||
+            (CRYPTO_memcmp(mic, value + EM_1905_MIC_HDR_LEN, EM_1905_MIC_LEN) != 0)) {
+        m_stats.failures++;
+        return -1;
+    }
+    it->second.rx_mic_counter = counter;
+    m_stats.checked_mics++;
+
+    return 0;
+}
+
+em_1905_key_table_t::em_1905_key_table_t()
+{
+    memset(m_al_mac, 0, sizeof(mac_address_t));
+    memset(m_gtk, 0, sizeof(m_gtk));
+    m_gtk_id = 0;
+    m_gtk_tx_counter = 0;
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+em_1905_key_table_t::~em_1905_key_table_t()
+{
+    for (auto& peer : m_peers) {
+        if (peer.second.keyed == true) {
+            siv_free(&peer.second.siv);
+        }
+    }
+    OPENSSL_cleanse(m_gtk, sizeof(m_gtk));
+}
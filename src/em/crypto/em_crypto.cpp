@@ -226,6 +226,137 @@ bail:
     return -1;
 }
 
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+#define EM_CRYPTO_CACHED_ALGOS  8
+
+/*
+ * Contexts of the platform_* primitives, kept by each thread and started over by the next
+ * init instead of being allocated and freed on every call, WSC M1/M2, the 1905 MIC and the
+ * key derivations call them several times per message. With OpenSSL 3 the algorithms behind
+ * the EVP_sha256() like handles the callers pass are also fetched once rather than at every init.
+ */
+struct em_crypto_cache_t {
+    EVP_MD_CTX      *md_ctx;
+    EVP_CIPHER_CTX  *cipher_ctx;
+    BN_CTX          *bn_ctx;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    EVP_MAC         *hmac;
+    EVP_MAC_CTX     *hmac_ctx;
+    const EVP_MD    *hmac_md;       // digest hmac_ctx is set up for
+    const EVP_MD    *md[EM_CRYPTO_CACHED_ALGOS][2];         // handle passed, handle fetched
+    const EVP_CIPHER *cipher[EM_CRYPTO_CACHED_ALGOS][2];
+#else
+    HMAC_CTX        *hmac_ctx;
+#endif
+
+    ~em_crypto_cache_t()
+    {
+        unsigned int i;
+
+        EVP_MD_CTX_free(md_ctx);
+        EVP_CIPHER_CTX_free(cipher_ctx);
+        BN_CTX_free(bn_ctx);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+        EVP_MAC_CTX_free(hmac_ctx);
+        EVP_MAC_free(hmac);
+        for (i = 0; i < EM_CRYPTO_CACHED_ALGOS; i++) {
+            EVP_MD_free(const_cast<EVP_MD *> (md[i][1]));
+            EVP_CIPHER_free(const_cast<EVP_CIPHER *> (cipher[i][1]));
+        }
+#else
+        (void)i;
+        HMAC_CTX_free(hmac_ctx);
+#endif
+    }
+};
+
+// zero initialized, every member is created on first use by the thread
+static thread_local em_crypto_cache_t s_crypto_cache;
+
+static const EVP_MD *cached_md(const EVP_MD *md)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    unsigned int i;
+    EVP_MD *fetched;
+
+    // a handle from EVP_MD_fetch() is used as is
+    if ((md == NULL) || (EVP_MD_get0_provider(md) != NULL)) {
+        return md;
+    }
+    for (i = 0; (i < EM_CRYPTO_CACHED_ALGOS) && (s_crypto_cache.md[i][0] != NULL); i++) {
+        if (s_crypto_cache.md[i][0] == md) {
+            return s_crypto_cache.md[i][1];
+        }
+    }
+    if ((i == EM_CRYPTO_CACHED_ALGOS) || ((fetched = EVP_MD_fetch(NULL, EVP_MD_get0_name(md), NULL)) == NULL)) {
+        return md;
+    }
+    s_crypto_cache.md[i][0] = md;
+    s_crypto_cache.md[i][1] = fetched;
+
+    return fetched;
+#else
+    return md;
+#endif
+}
+
+static const EVP_CIPHER *cached_cipher(const EVP_CIPHER *cipher)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    unsigned int i;
+    EVP_CIPHER *fetched;
+
+    if ((cipher == NULL) || (EVP_CIPHER_get0_provider(cipher) != NULL)) {
+        return cipher;
+    }
+    for (i = 0; (i < EM_CRYPTO_CACHED_ALGOS) && (s_crypto_cache.cipher[i][0] != NULL); i++) {
+        if (s_crypto_cache.cipher[i][0] == cipher) {
+            return s_crypto_cache.cipher[i][1];
+        }
+    }
+    if ((i == EM_CRYPTO_CACHED_ALGOS) || ((fetched = EVP_CIPHER_fetch(NULL, EVP_CIPHER_get0_name(cipher), NULL)) == NULL)) {
+        return cipher;
+    }
+    s_crypto_cache.cipher[i][0] = cipher;
+    s_crypto_cache.cipher[i][1] = fetched;
+
+    return fetched;
+#else
+    return cipher;
+#endif
+}
+#endif
+
+// Returns the cipher context to use, the cached one of the thread or a new one on old OpenSSL
+static EVP_CIPHER_CTX *get_cipher_ctx(const EVP_CIPHER **cipher_type)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    if ((s_crypto_cache.cipher_ctx == NULL) && ((s_crypto_cache.cipher_ctx = EVP_CIPHER_CTX_new()) == NULL)) {
+        return NULL;
+    }
+    *cipher_type = cached_cipher(*cipher_type);
+
+    return s_crypto_cache.cipher_ctx;
+#else
+    (void)cipher_type;
+
+    return EVP_CIPHER_CTX_new();
+#endif
+}
+
+// Done with the cipher context, a failed operation must not leave its state to the next one
+static void put_cipher_ctx(EVP_CIPHER_CTX *ctx, bool failed)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    if (failed == true) {
+        EVP_CIPHER_CTX_reset(ctx);
+    }
+#else
+    (void)failed;
+    EVP_CIPHER_CTX_free(ctx);
+#endif
+}
+
 uint8_t em_crypto_t::platform_hash(const EVP_MD * hashing_algo, uint8_t num_elem, uint8_t **addr, size_t *len, uint8_t *digest)
 {  
     EVP_MD_CTX   *ctx;
@@ -233,10 +364,11 @@ uint8_t em_crypto_t::platform_hash(const EVP_MD * hashing_algo, uint8_t num_elem
     uint8_t       res = 1;
 
 #if OPENSSL_VERSION_NUMBER >= 0x10100000L
-    ctx = EVP_MD_CTX_new();
-    if (!ctx) {
+    if ((s_crypto_cache.md_ctx == NULL) && ((s_crypto_cache.md_ctx = EVP_MD_CTX_new()) == NULL)) {
         return 0;
     }
+    ctx = s_crypto_cache.md_ctx;
+    hashing_algo = cached_md(hashing_algo);
 #else
     EVP_MD_CTX  ctx_aux;
     ctx = &ctx_aux;
@@ -259,14 +391,15 @@ uint8_t em_crypto_t::platform_hash(const EVP_MD * hashing_algo, uint8_t num_elem
         }
     }
 
+    // the _ex variant leaves the context to the next call
     if (1 == res) {
-        if (!EVP_DigestFinal(ctx, digest, &mac_len)) {
+        if (!EVP_DigestFinal_ex(ctx, digest, &mac_len)) {
             res = 0;
         }
     }
 
-#if OPENSSL_VERSION_NUMBER >= 0x10100000L
-    EVP_MD_CTX_free(ctx);
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+    EVP_MD_CTX_cleanup(ctx);
 #endif
 
     return res;
@@ -278,89 +411,92 @@ uint8_t em_crypto_t::platform_hmac_hash(const EVP_MD * hashing_algo, uint8_t *ke
         return 0;
     }
 
-#if OPENSSL_VERSION_NUMBER >= 0x30000000L
-    EVP_MD_CTX   *ctx;
-    EVP_PKEY     *pkey;
-#else
-    HMAC_CTX     *ctx;
-#endif
     size_t        i;
     unsigned int mdlen = static_cast<unsigned int> (EVP_MD_size(hashing_algo));
 
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
-    ctx = EVP_MD_CTX_new();
-#elif OPENSSL_VERSION_NUMBER >= 0x10100000L
-    ctx = HMAC_CTX_new();
-#else
-    HMAC_CTX  ctx_aux;
-    ctx = &ctx_aux;
+    EVP_MAC_CTX  *ctx;
+    OSSL_PARAM    params[2], *set = NULL;
+    size_t        out_len = 0;
 
-    HMAC_CTX_init(ctx);
-#endif
-    if (!ctx) {
-        return 0;
+    if (s_crypto_cache.hmac_ctx == NULL) {
+        if ((s_crypto_cache.hmac == NULL) && ((s_crypto_cache.hmac = EVP_MAC_fetch(NULL, "HMAC", NULL)) == NULL)) {
+            return 0;
+        }
+        if ((s_crypto_cache.hmac_ctx = EVP_MAC_CTX_new(s_crypto_cache.hmac)) == NULL) {
+            return 0;
+        }
     }
+    ctx = s_crypto_cache.hmac_ctx;
 
-#if OPENSSL_VERSION_NUMBER >= 0x30000000L
-    pkey = EVP_PKEY_new_raw_private_key(EVP_PKEY_HMAC, NULL, key, keylen);
-    if (pkey == NULL) {
-        goto bail;
+    // the digest is only set when it changes, EVP_MAC_init() keeps it otherwise
+    if (s_crypto_cache.hmac_md != hashing_algo) {
+        params[0] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char *> (EVP_MD_get0_name(hashing_algo)), 0);
+        params[1] = OSSL_PARAM_construct_end();
+        set = params;
+        s_crypto_cache.hmac_md = NULL;
     }
-    if (EVP_DigestSignInit(ctx, NULL, hashing_algo, NULL, pkey) != 1) {
-        goto bail;
+    if (EVP_MAC_init(ctx, key, keylen, set) != 1) {
+        return 0;
     }
+    s_crypto_cache.hmac_md = hashing_algo;
 
     for (i = 0; i < num_elem; i++) {
-        if (EVP_DigestSignUpdate(ctx, addr[i], len[i]) != 1) {
-            goto bail;
+        if (EVP_MAC_update(ctx, addr[i], len[i]) != 1) {
+            return 0;
         }
     }
 
-    if (EVP_DigestSignFinal(ctx, hmac, reinterpret_cast<size_t*>(&mdlen)) != 1) {
-        goto bail;
+    if ((EVP_MAC_final(ctx, hmac, &out_len, mdlen) != 1) || (out_len != mdlen)) {
+        return 0;
     }
-#else
+#elif OPENSSL_VERSION_NUMBER >= 0x10100000L
+    HMAC_CTX     *ctx;
+
+    if ((s_crypto_cache.hmac_ctx == NULL) && ((s_crypto_cache.hmac_ctx = HMAC_CTX_new()) == NULL)) {
+        return 0;
+    }
+    ctx = s_crypto_cache.hmac_ctx;
+
+    // a digest given again starts the context over
     if (HMAC_Init_ex(ctx, key, static_cast<int> (keylen), hashing_algo, NULL) != 1) {
-        goto bail;
+        return 0;
     }
 
     for (i = 0; i < num_elem; i++) {
-        HMAC_Update(ctx, addr[i], len[i]);
+        if (HMAC_Update(ctx, addr[i], len[i]) != 1) {
+            return 0;
+        }
     }
 
     if (HMAC_Final(ctx, hmac, &mdlen) != 1) {
-        goto bail;
+        return 0;
     }
-#endif
-
-    /* Release resources */
-#if OPENSSL_VERSION_NUMBER >= 0x30000000L
-    if (pkey)
-        EVP_PKEY_free(pkey);
-    if (ctx)
-        EVP_MD_CTX_free(ctx);
-#elif OPENSSL_VERSION_NUMBER >= 0x10100000L
-    HMAC_CTX_free(ctx);
 #else
-    HMAC_CTX_cleanup(ctx);
-#endif
+    HMAC_CTX  ctx_aux;
+    HMAC_CTX *ctx = &ctx_aux;
+    uint8_t   res = 1;
 
-    return 1;
+    HMAC_CTX_init(ctx);
+    if (HMAC_Init_ex(ctx, key, static_cast<int> (keylen), hashing_algo, NULL) != 1) {
+        res = 0;
+    }
 
-bail:
-#if OPENSSL_VERSION_NUMBER >= 0x30000000L
-    if (pkey)
-        EVP_PKEY_free(pkey);
-    if (ctx)
-        EVP_MD_CTX_free(ctx);
-#elif OPENSSL_VERSION_NUMBER >= 0x10100000L
-    HMAC_CTX_free(ctx);
-#else
+    for (i = 0; (res == 1) && (i < num_elem); i++) {
+        HMAC_Update(ctx, addr[i], len[i]);
+    }
+
+    if ((res == 1) && (HMAC_Final(ctx, hmac, &mdlen) != 1)) {
+        res = 0;
+    }
     HMAC_CTX_cleanup(ctx);
+
+    if (res == 0) {
+        return 0;
+    }
 #endif
 
-    //em_util_info_print(EM_CONF," %s:%d\n",__func__,__LINE__);
-    return 0;
+    return 1;
 }
 void em_crypto_t:: append_u32_net(const uint32_t *memory_pointer, uint8_t **packet_ppointer)
 {
@@ -436,21 +572,12 @@ uint8_t em_crypto_t:: wps_key_derivation_function(uint8_t *key, uint8_t *label_p
 }
 uint8_t em_crypto_t::platform_cipher_encrypt(const EVP_CIPHER *cipher_type, uint8_t *key, uint8_t *iv, uint8_t *plain, uint32_t plain_len, uint8_t *cipher_text, uint32_t *cipher_len, bool disable_padding)
 {
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-    EVP_CIPHER_CTX _ctx;
-#endif
     EVP_CIPHER_CTX *ctx;
     int len = static_cast<int> (plain_len + AES_BLOCK_SIZE - 1), final_len = 0;
 
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-    EVP_CIPHER_CTX_init(&_ctx);
-    ctx = &_ctx;
-#else
-    ctx=EVP_CIPHER_CTX_new();
-    if (!ctx) {
+    if ((ctx = get_cipher_ctx(&cipher_type)) == NULL) {
         return 0;
     }
-#endif
     
     // For wrap ciphers, set the appropriate flags BEFORE init
     if (EVP_CIPHER_mode(cipher_type) == EVP_CIPH_WRAP_MODE) {
@@ -462,17 +589,12 @@ uint8_t em_crypto_t::platform_cipher_encrypt(const EVP_CIPHER *cipher_type, uint
         char err_buf[256];
         ERR_error_string_n(err, err_buf, sizeof(err_buf));
         printf("%s:%d EVP_EncryptInit_ex failed: %s\n", __func__, __LINE__, err_buf);
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-        EVP_CIPHER_CTX_cleanup(ctx);
-#else
-        EVP_CIPHER_CTX_free(ctx);
-#endif
+        put_cipher_ctx(ctx, true);
         return 0;
     }
 
-    if (disable_padding) {
-        EVP_CIPHER_CTX_set_padding(ctx, 0);
-    }
+    // set either way, the reused context keeps the padding of the last call
+    EVP_CIPHER_CTX_set_padding(ctx, disable_padding ? 0 : 1);
 
     
     if (EVP_EncryptUpdate(ctx, cipher_text, &len, plain, static_cast<int> (plain_len)) != 1) {
@@ -480,11 +602,7 @@ uint8_t em_crypto_t::platform_cipher_encrypt(const EVP_CIPHER *cipher_type, uint
         char err_buf[256];
         ERR_error_string_n(err, err_buf, sizeof(err_buf));
         printf("%s:%d EVP_EncryptUpdate failed: %s\n", __func__, __LINE__, err_buf);
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-        EVP_CIPHER_CTX_cleanup(ctx);
-#else
-        EVP_CIPHER_CTX_free(ctx);
-#endif
+        put_cipher_ctx(ctx, true);
         return 0;
     }
 
@@ -493,42 +611,25 @@ uint8_t em_crypto_t::platform_cipher_encrypt(const EVP_CIPHER *cipher_type, uint
         char err_buf[256];
         ERR_error_string_n(err, err_buf, sizeof(err_buf));
         printf("%s:%d EVP_EncryptFinal_ex failed: %s\n", __func__, __LINE__, err_buf);
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-        EVP_CIPHER_CTX_cleanup(ctx);
-#else
-        EVP_CIPHER_CTX_free(ctx);
-#endif
+        put_cipher_ctx(ctx, true);
         return 0;
     }
 
     *cipher_len = static_cast<uint32_t> (len + final_len);
 
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-    EVP_CIPHER_CTX_cleanup(ctx);
-#else
-    EVP_CIPHER_CTX_free(ctx);
-#endif
+    put_cipher_ctx(ctx, false);
 
     return 1;
 }
 uint32_t em_crypto_t::platform_cipher_decrypt(const EVP_CIPHER *cipher_type, uint8_t *key, uint8_t *iv, uint8_t *data, uint32_t data_len, bool disable_padding)
 {
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-    EVP_CIPHER_CTX _ctx;
-#endif
     EVP_CIPHER_CTX *ctx;
     int             plen, len;
     uint8_t         buf[AES_BLOCK_SIZE];
 
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-    EVP_CIPHER_CTX_init(&_ctx);
-    ctx = &_ctx;
-#else
-    ctx=EVP_CIPHER_CTX_new();
-    if (!ctx) {
+    if ((ctx = get_cipher_ctx(&cipher_type)) == NULL) {
         return 0;
     }
-#endif
     
     // For wrap ciphers, set the appropriate flags BEFORE init
     if (EVP_CIPHER_mode(cipher_type) == EVP_CIPH_WRAP_MODE) {
@@ -540,17 +641,11 @@ uint32_t em_crypto_t::platform_cipher_decrypt(const EVP_CIPHER *cipher_type, uin
         char err_buf[256];
         ERR_error_string_n(err, err_buf, sizeof(err_buf));
         printf("%s:%d EVP_DecryptInit_ex failed: %s\n", __func__, __LINE__, err_buf);
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-        EVP_CIPHER_CTX_cleanup(ctx);
-#else
-        EVP_CIPHER_CTX_free(ctx);
-#endif
+        put_cipher_ctx(ctx, true);
         return 0;
     }
 
-    if (disable_padding) {
-        EVP_CIPHER_CTX_set_padding(ctx, 0);
-    }
+    EVP_CIPHER_CTX_set_padding(ctx, disable_padding ? 0 : 1);
     
     plen = static_cast<int> (data_len);
     if (EVP_DecryptUpdate(ctx, data, &plen, data, static_cast<int> (data_len)) != 1) {
@@ -558,11 +653,7 @@ uint32_t em_crypto_t::platform_cipher_decrypt(const EVP_CIPHER *cipher_type, uin
         char err_buf[256];
         ERR_error_string_n(err, err_buf, sizeof(err_buf));
         printf("%s:%d EVP_DecryptUpdate failed: %s\n", __func__, __LINE__, err_buf);
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-        EVP_CIPHER_CTX_cleanup(ctx);
-#else
-        EVP_CIPHER_CTX_free(ctx);
-#endif
+        put_cipher_ctx(ctx, true);
         return 0;
     }
 
@@ -572,30 +663,20 @@ uint32_t em_crypto_t::platform_cipher_decrypt(const EVP_CIPHER *cipher_type, uin
         char err_buf[256];
         ERR_error_string_n(err, err_buf, sizeof(err_buf));
         printf("%s:%d EVP_DecryptFinal_ex failed: %s\n", __func__, __LINE__, err_buf);
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-        EVP_CIPHER_CTX_cleanup(ctx);
-#else
-        EVP_CIPHER_CTX_free(ctx);
-#endif
+        put_cipher_ctx(ctx, true);
         return 0;
     }
+    // the block held back for the padding check comes out of the final call
+    memcpy(data + plen, buf, static_cast<size_t> (len));
     plen += len;
 
     // For non-wrap ciphers, len should be 0 after final
     if (disable_padding && EVP_CIPHER_mode(cipher_type) != EVP_CIPH_WRAP_MODE && len != 0) {
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-        EVP_CIPHER_CTX_cleanup(ctx);
-#else
-        EVP_CIPHER_CTX_free(ctx);
-#endif
+        put_cipher_ctx(ctx, true);
         return 0;
     }
 
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-    EVP_CIPHER_CTX_cleanup(ctx);
-#else
-    EVP_CIPHER_CTX_free(ctx);
-#endif
+    put_cipher_ctx(ctx, false);
 
     return static_cast<uint32_t>(plen);
 }
@@ -663,6 +744,206 @@ uint8_t em_crypto_t::aes_key_unwrap(uint8_t *kek, size_t kek_len,
     return 1;
 }
 
+em_wsc_seal_t::em_wsc_seal_t() : m_enc(NULL), m_dec(NULL),
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    m_mac(NULL), m_mac_ctx(NULL),
+#elif OPENSSL_VERSION_NUMBER >= 0x10100000L
+    m_mac_ctx(NULL),
+#else
+    m_auth_key(),
+#endif
+    m_keyed(false)
+{
+}
+
+em_wsc_seal_t::~em_wsc_seal_t()
+{
+    clear();
+    EVP_CIPHER_CTX_free(m_enc);
+    EVP_CIPHER_CTX_free(m_dec);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    EVP_MAC_free(m_mac);
+#elif OPENSSL_VERSION_NUMBER >= 0x10100000L
+    HMAC_CTX_free(m_mac_ctx);
+#endif
+}
+
+int em_wsc_seal_t::set_keys(const uint8_t *auth_key, const uint8_t *key_wrap_key)
+{
+    const EVP_CIPHER *cipher = EVP_aes_128_cbc();
+
+    // the contexts of the previous keys are keyed again, not made anew
+    m_keyed = false;
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    cipher = cached_cipher(cipher);
+#endif
+    if (((m_enc == NULL) && ((m_enc = EVP_CIPHER_CTX_new()) == NULL)) ||
+            ((m_dec == NULL) && ((m_dec = EVP_CIPHER_CTX_new()) == NULL))) {
+        return -1;
+    }
+
+    // the key schedules are made here, seal() and open() only set the IV
+    if ((EVP_EncryptInit_ex(m_enc, cipher, NULL, key_wrap_key, NULL) != 1) ||
+            (EVP_DecryptInit_ex(m_dec, cipher, NULL, key_wrap_key, NULL) != 1)) {
+        printf("%s:%d: cipher init failed\n", __func__, __LINE__);
+        clear();
+        return -1;
+    }
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    OSSL_PARAM params[2];
+
+    if ((m_mac == NULL) && ((m_mac = EVP_MAC_fetch(NULL, "HMAC", NULL)) == NULL)) {
+        clear();
+        return -1;
+    }
+    if ((m_mac_ctx == NULL) && ((m_mac_ctx = EVP_MAC_CTX_new(m_mac)) == NULL)) {
+        clear();
+        return -1;
+    }
+    params[0] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char *> ("SHA256"), 0);
+    params[1] = OSSL_PARAM_construct_end();
+    if (EVP_MAC_init(m_mac_ctx, auth_key, WPS_AUTHKEY_LEN, params) != 1) {
+        printf("%s:%d: hmac init failed\n", __func__, __LINE__);
+        clear();
+        return -1;
+    }
+#elif OPENSSL_VERSION_NUMBER >= 0x10100000L
+    if ((m_mac_ctx == NULL) && ((m_mac_ctx = HMAC_CTX_new()) == NULL)) {
+        clear();
+        return -1;
+    }
+    if (HMAC_Init_ex(m_mac_ctx, auth_key, WPS_AUTHKEY_LEN, EVP_sha256(), NULL) != 1) {
+        printf("%s:%d: hmac init failed\n", __func__, __LINE__);
+        clear();
+        return -1;
+    }
+#else
+    memcpy(m_auth_key, auth_key, WPS_AUTHKEY_LEN);
+#endif
+    m_keyed = true;
+
+    return 0;
+}
+
+void em_wsc_seal_t::clear()
+{
+    m_keyed = false;
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    // reset cleanses the key schedule, the context itself is kept
+    if (m_enc != NULL) {
+        EVP_CIPHER_CTX_reset(m_enc);
+    }
+    if (m_dec != NULL) {
+        EVP_CIPHER_CTX_reset(m_dec);
+    }
+#else
+    if (m_enc != NULL) {
+        EVP_CIPHER_CTX_cleanup(m_enc);
+    }
+    if (m_dec != NULL) {
+        EVP_CIPHER_CTX_cleanup(m_dec);
+    }
+#endif
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    EVP_MAC_CTX_free(m_mac_ctx);
+    m_mac_ctx = NULL;
+#elif OPENSSL_VERSION_NUMBER >= 0x10100000L
+    if (m_mac_ctx != NULL) {
+        HMAC_CTX_reset(m_mac_ctx);
+    }
+#else
+    OPENSSL_cleanse(m_auth_key, sizeof(m_auth_key));
+#endif
+}
+
+uint8_t em_wsc_seal_t::authenticate(const uint8_t *plain, unsigned int plain_len, uint8_t *hash)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    size_t out_len = 0;
+
+    // no key given, the context starts over with the one of set_keys()
+    if ((EVP_MAC_init(m_mac_ctx, NULL, 0, NULL) != 1) || (EVP_MAC_update(m_mac_ctx, plain, plain_len) != 1) ||
+            (EVP_MAC_final(m_mac_ctx, hash, &out_len, SHA256_MAC_LEN) != 1) || (out_len != SHA256_MAC_LEN)) {
+        return 0;
+    }
+#elif OPENSSL_VERSION_NUMBER >= 0x10100000L
+    unsigned int out_len = SHA256_MAC_LEN;
+
+    if ((HMAC_Init_ex(m_mac_ctx, NULL, 0, NULL, NULL) != 1) || (HMAC_Update(m_mac_ctx, plain, plain_len) != 1) ||
+            (HMAC_Final(m_mac_ctx, hash, &out_len) != 1)) {
+        return 0;
+    }
+#else
+    uint8_t *addr[1] = { const_cast<uint8_t *> (plain) };
+    size_t len[1] = { plain_len };
+
+    if (em_crypto_t::platform_hmac_SHA256(m_auth_key, WPS_AUTHKEY_LEN, 1, addr, len, hash) != 1) {
+        return 0;
+    }
+#endif
+
+    return 1;
+}
+
+unsigned int em_wsc_seal_t::seal(uint8_t *plain, unsigned int plain_len, uint8_t *out)
+{
+    data_elem_attr_t *attr;
+    uint8_t hash[SHA256_MAC_LEN];
+    int len = 0, final_len = 0;
+
+    if (m_keyed == false) {
+        return 0;
+    }
+
+    // key wrap authenticator, the first bytes of the HMAC of the settings
+    if (authenticate(plain, plain_len, hash) != 1) {
+        printf("%s:%d: Authenticator create failed\n", __func__, __LINE__);
+        return 0;
+    }
+    attr = reinterpret_cast<data_elem_attr_t *> (plain + plain_len);
+    attr->id = htons(attr_id_key_wrap_authenticator);
+    attr->len = htons(EM_KEY_WRAP_TLV_LEN);
+    memcpy(attr->val, hash, EM_KEY_WRAP_TLV_LEN);
+    plain_len += static_cast<unsigned int> (sizeof(data_elem_attr_t) + EM_KEY_WRAP_TLV_LEN);
+
+    if (em_crypto_t::generate_iv(out, AES_BLOCK_SIZE) != 1) {
+        printf("%s:%d: iv generate failed\n", __func__, __LINE__);
+        return 0;
+    }
+
+    if ((EVP_EncryptInit_ex(m_enc, NULL, NULL, NULL, out) != 1) ||
+            (EVP_EncryptUpdate(m_enc, out + AES_BLOCK_SIZE, &len, plain, static_cast<int> (plain_len)) != 1) ||
+            (EVP_EncryptFinal_ex(m_enc, out + AES_BLOCK_SIZE + len, &final_len) != 1)) {
+        printf("%s:%d: platform encrypt failed\n", __func__, __LINE__);
+        return 0;
+    }
+
+    return static_cast<unsigned int> (AES_BLOCK_SIZE + len + final_len);
+}
+
+unsigned int em_wsc_seal_t::open(uint8_t *data, unsigned int len)
+{
+    uint8_t buf[AES_BLOCK_SIZE], *cipher = data + AES_BLOCK_SIZE;
+    int plen = 0, final_len = sizeof(buf);
+
+    if ((m_keyed == false) || (len <= AES_BLOCK_SIZE)) {
+        return 0;
+    }
+    len -= AES_BLOCK_SIZE;
+
+    if ((EVP_DecryptInit_ex(m_dec, NULL, NULL, NULL, data) != 1) ||
+            (EVP_DecryptUpdate(m_dec, cipher, &plen, cipher, static_cast<int> (len)) != 1) ||
+            (EVP_DecryptFinal_ex(m_dec, buf, &final_len) != 1)) {
+        printf("%s:%d: platform decrypt failed\n", __func__, __LINE__);
+        return 0;
+    }
+    // the block held back for the padding check comes out of the final call
+    memcpy(cipher + plen, buf, static_cast<size_t> (final_len));
+
+    return static_cast<unsigned int> (plen + final_len);
+}
+
 
 
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
@@ -754,19 +1035,17 @@ uint8_t em_crypto_t::platform_compute_shared_secret(uint8_t **shared_secret, uin
         return 0;
     }
 
-    BIGNUM *p = BN_bin2bn(g_dh1536_p, sizeof(g_dh1536_p), NULL);
-    BIGNUM *g = BN_bin2bn(g_dh1536_g, sizeof(g_dh1536_g), NULL);
     BIGNUM *bn_priv = BN_bin2bn(local_priv, local_priv_len, NULL);
     BIGNUM *bn_pub = BN_bin2bn(remote_pub, remote_pub_len, NULL);
 
-    if (!p || !g || !bn_priv || !bn_pub) {
-        cleanup_bignums(p, g, bn_priv, bn_pub);
+    if (!bn_priv || !bn_pub) {
+        cleanup_bignums(NULL, NULL, bn_priv, bn_pub);
         printf("%s:%d Failed to initialize BIGNUMs\n", __func__, __LINE__);
         return 0;
     }
 
     size_t secret_len = 0;
-    uint8_t did_succeed = compute_secret_internal(p, g, bn_priv, bn_pub, 
+    uint8_t did_succeed = compute_secret_internal(bn_priv, bn_pub, 
                                            shared_secret, &secret_len);
     
     if (did_succeed) {
@@ -1015,130 +1294,167 @@ void em_crypto_t::cleanup_bignums(BIGNUM *p, BIGNUM *g, BIGNUM *priv, BIGNUM *pu
     BN_clear_free(pub);
 }
 
-#if OPENSSL_VERSION_NUMBER >= 0x30000000L
-uint8_t em_crypto_t::compute_secret_internal(BIGNUM *p, BIGNUM *g, BIGNUM *bn_priv, 
-                                BIGNUM *bn_pub, uint8_t **shared_secret,
+// The WSC group never changes, its prime is converted and its Montgomery context set up once
+struct em_crypto_dh_group_t {
+    BIGNUM      *p;
+    BIGNUM      *p_minus_1;
+    BN_MONT_CTX *mont_p;
+};
+
+static em_crypto_dh_group_t s_dh_group;
+static pthread_once_t dh_group_once = PTHREAD_ONCE_INIT;
+
+static void init_dh_group()
+{
+    BN_CTX *bn_ctx = BN_CTX_new();
+
+    s_dh_group.p = BN_bin2bn(em_crypto_t::g_dh1536_p, sizeof(em_crypto_t::g_dh1536_p), NULL);
+    s_dh_group.p_minus_1 = BN_dup(s_dh_group.p);
+    s_dh_group.mont_p = BN_MONT_CTX_new();
+    if ((bn_ctx == NULL) || (s_dh_group.p == NULL) || (s_dh_group.p_minus_1 == NULL) || (s_dh_group.mont_p == NULL) ||
+            (BN_sub_word(s_dh_group.p_minus_1, 1) != 1) || (BN_MONT_CTX_set(s_dh_group.mont_p, s_dh_group.p, bn_ctx) != 1)) {
+        printf("%s:%d Failed to set up the DH group\n", __func__, __LINE__);
+        BN_free(s_dh_group.p);
+        BN_free(s_dh_group.p_minus_1);
+        BN_MONT_CTX_free(s_dh_group.mont_p);
+        memset(&s_dh_group, 0, sizeof(s_dh_group));
+    }
+    BN_CTX_free(bn_ctx);
+}
+
+uint8_t em_crypto_t::compute_secret_internal(BIGNUM *bn_priv, BIGNUM *bn_pub, uint8_t **shared_secret,
                                 size_t *secret_len) {
-    if (!p || !g || !bn_priv || !bn_pub) {
+    BN_CTX *bn_ctx;
+    BIGNUM *secret = NULL;
+    int len;
+    uint8_t ret = 0;
+
+    pthread_once(&dh_group_once, init_dh_group);
+    if ((s_dh_group.mont_p == NULL) || !bn_priv || !bn_pub) {
         printf("%s:%d Failed to initialize BIGNUMs\n", __func__, __LINE__);
+        cleanup_bignums(NULL, NULL, bn_priv, bn_pub);
         return 0;
     }
 
-    EVP_PKEY* dh_priv = create_dh_pkey(p, g, bn_priv, NULL);
-    EVP_PKEY* dh_pub = create_dh_pkey(p, g, NULL, bn_pub);
-    if (!dh_priv || !dh_pub) {
-        printf("%s:%d Failed to create DH keys\n", __func__, __LINE__);
+    // 0, 1 and p - 1 would force the secret, DH_check_pub_key() refuses them as well
+    if ((BN_cmp(bn_pub, BN_value_one()) <= 0) || (BN_cmp(bn_pub, s_dh_group.p_minus_1) >= 0)) {
+        printf("%s:%d Invalid remote public key\n", __func__, __LINE__);
+        cleanup_bignums(NULL, NULL, bn_priv, bn_pub);
         return 0;
     }
 
-    EVP_PKEY_CTX *ctx;
-    int ret = 0;
-
-    // Thread-local library context (if needed for thread isolation)
-    static thread_local OSSL_LIB_CTX *libctx = nullptr;
-    if (!libctx) {
-        libctx = OSSL_LIB_CTX_new(); // Create a new thread-local context
-        if (!libctx) {
-            printf("%s:%d Failed to create thread-local context\n", __func__, __LINE__);
-            return 0;
-        }
-        // Load providers into the thread-local context
-        if (!OSSL_PROVIDER_load(libctx, "default")) {
-            printf("%s:%d Failed to load default provider\n", __func__, __LINE__);
-            OSSL_LIB_CTX_free(libctx);
-            libctx = nullptr;
-            return 0;
-        }
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    if ((bn_ctx = get_thread_bn_ctx()) == NULL) {
+        cleanup_bignums(NULL, NULL, bn_priv, bn_pub);
+        return 0;
     }
-
-    if (NULL == (ctx = EVP_PKEY_CTX_new_from_pkey(libctx, dh_priv, NULL))){
-        printf("%s:%d EVP_PKEY_CTX_new failed\n", __func__, __LINE__);
-        goto cleanup;
+#else
+    if ((bn_ctx = BN_CTX_new()) == NULL) {
+        cleanup_bignums(NULL, NULL, bn_priv, bn_pub);
+        return 0;
     }
+#endif
+    BN_CTX_start(bn_ctx);
 
-    if (EVP_PKEY_derive_init(ctx) <= 0){
-        printf("%s:%d EVP_PKEY_derive_init failed\n", __func__, __LINE__);
+    // Same value as DH_compute_key(), without padding to the size of the prime
+    BN_set_flags(bn_priv, BN_FLG_CONSTTIME);
+    if (((secret = BN_CTX_get(bn_ctx)) == NULL) ||
+            (BN_mod_exp_mont_consttime(secret, bn_pub, bn_priv, s_dh_group.p, bn_ctx, s_dh_group.mont_p) != 1)) {
+        printf("%s:%d Failed to compute the shared secret\n", __func__, __LINE__);
         goto cleanup;
     }
 
-    if (EVP_PKEY_derive_set_peer(ctx, dh_pub) <= 0){
-        printf("%s:%d EVP_PKEY_derive_set_peer failed\n", __func__, __LINE__);
+    len = BN_num_bytes(secret);
+    if ((*shared_secret = static_cast<uint8_t *> (OPENSSL_malloc(static_cast<size_t> (len > 0 ? len : 1)))) == NULL) {
+        printf("%s:%d shared secret malloc failed\n", __func__, __LINE__);
         goto cleanup;
     }
+    *secret_len = static_cast<size_t> (BN_bn2bin(secret, *shared_secret));
+    ret = (*secret_len > 0) ? 1 : 0;
 
-    /* Determine buffer length */
-    if (EVP_PKEY_derive(ctx, NULL, secret_len) <= 0) {
-        printf("%s:%d EVP_PKEY_derive failed\n", __func__, __LINE__);
-        goto cleanup;
+cleanup:
+    if (secret != NULL) {
+        BN_clear(secret);
     }
+    BN_CTX_end(bn_ctx);
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+    BN_CTX_free(bn_ctx);
+#endif
+    cleanup_bignums(NULL, NULL, bn_priv, bn_pub);
 
-    *shared_secret = (uint8_t*)OPENSSL_malloc(*secret_len);
-
-    if (!*shared_secret) {
-        printf("%s:%d shared secret malloc failed\n", __func__, __LINE__);
-        goto cleanup;
-    }
-    
-    if (EVP_PKEY_derive(ctx, *shared_secret, secret_len) <= 0) {
-        printf("%s:%d EVP_PKEY_derive failed\n", __func__, __LINE__);
-        goto cleanup;
-    }
+    return ret;
+}
 
-    ret = 1;
+// The curves DPP uses, set up once with their generator multiples precomputed. The groups
+// of get_key_group() are copies of these, which share the precomputed table.
+#define EM_CRYPTO_EC_CURVES     5
 
-cleanup:
-    // Cleanup
+struct em_crypto_ec_curve_t {
+    int         nid;
+    EC_GROUP    *group;
+};
 
-    EVP_PKEY_CTX_free(ctx);
-    EVP_PKEY_free(dh_priv);
-    EVP_PKEY_free(dh_pub);
+static em_crypto_ec_curve_t s_ec_curves[EM_CRYPTO_EC_CURVES] = {
+    { NID_X9_62_prime256v1, NULL },
+    { NID_secp384r1, NULL },
+    { NID_secp521r1, NULL },
+    { NID_X9_62_prime192v1, NULL },
+    { NID_secp224r1, NULL },
+};
+static pthread_once_t ec_curves_once = PTHREAD_ONCE_INIT;
 
-    cleanup_bignums(p, g, bn_priv, bn_pub);
-    return static_cast<uint8_t> (ret);
-}
-#else
-uint8_t em_crypto_t::compute_secret_internal(BIGNUM *p, BIGNUM *g, BIGNUM *bn_priv,
-                                BIGNUM *bn_pub, uint8_t **shared_secret,
-                                size_t *secret_len) {
-    DH *dh = DH_new();
-    if (!dh) {
-        BN_clear_free(bn_pub);
-        return 0;
-    }
+static void init_ec_curves()
+{
+    BN_CTX *bn_ctx = BN_CTX_new();
+    unsigned int i;
 
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-    dh->p = p;
-    dh->g = g;
-    dh->priv_key = bn_priv;
-#else
-    if (DH_set0_pqg(dh, p, NULL, g) != 1 ||
-        DH_set0_key(dh, NULL, bn_priv) != 1) {
-        DH_free(dh);
-        BN_clear_free(bn_pub);
-        return 0;
-    }
+    for (i = 0; i < EM_CRYPTO_EC_CURVES; i++) {
+        if ((s_ec_curves[i].group = EC_GROUP_new_by_curve_name(s_ec_curves[i].nid)) == NULL) {
+            printf("%s:%d Failed to set up curve %d\n", __func__, __LINE__, s_ec_curves[i].nid);
+            continue;
+        }
+#if (OPENSSL_VERSION_NUMBER < 0x30000000L) || !defined(OPENSSL_NO_DEPRECATED_3_0)
+        // optional, the group is used without the table if this fails
+        if ((bn_ctx != NULL) && (EC_GROUP_precompute_mult(s_ec_curves[i].group, bn_ctx) != 1)) {
+            printf("%s:%d Failed to precompute the multiples of curve %d\n", __func__, __LINE__, s_ec_curves[i].nid);
+        }
 #endif
-    int size = DH_size(dh);
-    if (size <= 0) {
-        DH_free(dh);
-        BN_clear_free(bn_pub);
-        return 0;
     }
-    *shared_secret = static_cast<uint8_t*> (calloc(static_cast<size_t> (size), sizeof(uint8_t)));
-    if (!*shared_secret) {
-        // Memory allocation failed
-        DH_free(dh);
-        BN_clear_free(bn_pub);
-        return 0;
+    BN_CTX_free(bn_ctx);
+}
+
+const EC_GROUP *em_crypto_t::get_curve_group(int nid)
+{
+    unsigned int i;
+
+    pthread_once(&ec_curves_once, init_ec_curves);
+    for (i = 0; i < EM_CRYPTO_EC_CURVES; i++) {
+        if (s_ec_curves[i].nid == nid) {
+            return s_ec_curves[i].group;
+        }
     }
-    *secret_len = static_cast<size_t> (DH_compute_key(*shared_secret, bn_pub, dh));
-    
-    DH_free(dh);
-    BN_clear_free(bn_pub);
 
-    return (*secret_len > 0) ? 1 : 0;
+    return NULL;
 }
+
+EC_GROUP *em_crypto_t::new_curve_group(int nid)
+{
+    const EC_GROUP *group = get_curve_group(nid);
+
+    return (group != NULL) ? EC_GROUP_dup(group) : EC_GROUP_new_by_curve_name(nid);
+}
+
+BN_CTX *em_crypto_t::get_thread_bn_ctx()
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    if (s_crypto_cache.bn_ctx == NULL) {
+        s_crypto_cache.bn_ctx = BN_CTX_new();
+    }
+    return s_crypto_cache.bn_ctx;
+#else
+    return NULL;
 #endif
+}
 
 SSL_KEY* em_crypto_t::ec_key_from_base64_der(const std::string& base64_der_pubkey) 
 {
@@ -1224,7 +1540,7 @@ EC_GROUP *em_crypto_t::get_key_group(const SSL_KEY *key)
     if (EVP_PKEY_get_group_name(key, group_name, sizeof(group_name), &group_name_len) <= 0) return NULL;
     
     // Create a group from the name
-    group = EC_GROUP_new_by_curve_name(OBJ_txt2nid(group_name));
+    group = new_curve_group(OBJ_txt2nid(group_name));
     if (!group) return NULL;
 
     return group;
@@ -1429,7 +1745,7 @@ EC_GROUP *em_crypto_t::get_key_group(const SSL_KEY *key)
     // Provides consistent behavior across different OpenSSL versions
     // since OpenSSL 3.0+ creates a new EC_GROUP object.
     int nid = EC_GROUP_get_curve_name(group);
-    return EC_GROUP_new_by_curve_name(nid);
+    return new_curve_group(nid);
 }
 BIGNUM *em_crypto_t::get_priv_key_bn(const SSL_KEY *key)
 {
@@ -50,6 +50,12 @@
 #include "em_cmd.h"
 #include "em_cmd_exec.h"
 #include "util.h"
+#include "em_trace.h"
+#include "em_perf.h"
+#include "em_stack.h"
+#include "em_sched.h"
+#include "em_profile.h"
+#include "em_frame_ring.h"
 #include "ec_ops.h"
 #include "ec_util.h"
 
@@ -86,6 +92,7 @@ void em_t::orch_execute(em_cmd_t *pcmd)
 
     m_cmd = pcmd;
     m_orch_state = em_orch_state_progress;
+    m_sm.kick();
 
     dm_easy_mesh_t::macbytes_to_string(get_radio_interface_mac(), mac_str);
 	//printf("%s:%d: Radio: %s State: 0x%04x\n", __func__, __LINE__, mac_str, get_state());
@@ -115,7 +122,7 @@ void em_t::orch_execute(em_cmd_t *pcmd)
 			break;
 
         case em_cmd_type_start_dpp: {
-            ec_data_t *dpp_info = pcmd->m_data_model.get_dpp()->get_dpp_info();
+            ec_data_t *dpp_info = pcmd->m_data_model->get_dpp()->get_dpp_info();
             printf("ORCH: Start DPP\n");
             printf("ORCH: DPP: \n");
             printf("\tDPP: Version: %d\n", dpp_info->version);
@@ -212,6 +219,7 @@ void em_t::orch_execute(em_cmd_t *pcmd)
             break;
 
         case em_cmd_type_sta_steer:
+        case em_cmd_type_sta_steer_batch:
             m_sm.set_state(em_state_ctrl_sta_steer_pending);
             break;
 
@@ -255,6 +263,9 @@ void em_t::orch_execute(em_cmd_t *pcmd)
             break;
 
     }
+
+    // the command runs from the next tick of this em
+    wake();
 }
 
 void em_t::set_orch_state(em_orch_state_t state)
@@ -267,6 +278,9 @@ void em_t::set_orch_state(em_orch_state_t state)
     }
 
     m_orch_state = state;
+    m_sm.kick();
+    wake();
+    m_mgr->kick_orch();
 }
 
 void em_t::handle_timeout()
@@ -274,93 +288,129 @@ void em_t::handle_timeout()
     //printf("%s:%d: em timeout\n", __func__, __LINE__);
 }
 
-void em_t::proto_process(unsigned char *data, unsigned int len)
+constexpr std::array<em_t::em_msg_handler_t, EM_MSG_TYPE_SLOTS> em_t::build_msg_handlers()
 {
-    em_cmdu_t *cmdu;
-    mac_addr_str_t mac_str;
-
-    cmdu = reinterpret_cast<em_cmdu_t *>(data + sizeof(em_raw_hdr_t));
+    std::array<em_msg_handler_t, EM_MSG_TYPE_SLOTS> handlers = {};
+    const struct {
+        em_msg_type_t type;
+        em_msg_handler_t handler;
+    } map[] = {
+        {em_msg_type_autoconf_search, &em_configuration_t::process_msg},
+        {em_msg_type_autoconf_resp, &em_configuration_t::process_msg},
+        {em_msg_type_autoconf_wsc, &em_configuration_t::process_msg},
+        {em_msg_type_autoconf_renew, &em_configuration_t::process_msg},
+        {em_msg_type_topo_resp, &em_configuration_t::process_msg},
+        {em_msg_type_topo_query, &em_configuration_t::process_msg},
+        {em_msg_type_topo_notif, &em_configuration_t::process_msg},
+        {em_msg_type_ap_mld_config_req, &em_configuration_t::process_msg},
+        {em_msg_type_ap_mld_config_resp, &em_configuration_t::process_msg},
+        {em_msg_type_bss_config_req, &em_configuration_t::process_msg},
+        {em_msg_type_bss_config_rsp, &em_configuration_t::process_msg},
+        {em_msg_type_bss_config_res, &em_configuration_t::process_msg},
+        {em_msg_type_agent_list, &em_configuration_t::process_msg},
+
+        {em_msg_type_ap_cap_query, &em_capability_t::process_msg},
+        {em_msg_type_ap_cap_rprt, &em_capability_t::process_msg},
+        {em_msg_type_client_cap_query, &em_capability_t::process_msg},
+        {em_msg_type_client_cap_rprt, &em_capability_t::process_msg},
+        {em_msg_type_bh_sta_cap_query, &em_capability_t::process_msg},
+        {em_msg_type_bh_sta_cap_rprt, &em_capability_t::process_msg},
+
+        {em_msg_type_channel_pref_query, &em_channel_t::process_msg},
+        {em_msg_type_channel_pref_rprt, &em_channel_t::process_msg},
+        {em_msg_type_channel_sel_req, &em_channel_t::process_msg},
+        {em_msg_type_channel_sel_rsp, &em_channel_t::process_msg},
+        {em_msg_type_op_channel_rprt, &em_channel_t::process_msg},
+        {em_msg_type_avail_spectrum_inquiry, &em_channel_t::process_msg},
+        {em_msg_type_channel_scan_req, &em_channel_t::process_msg},
+        {em_msg_type_channel_scan_rprt, &em_channel_t::process_msg},
+
+        {em_msg_type_assoc_sta_link_metrics_query, &em_metrics_t::process_msg},
+        {em_msg_type_assoc_sta_link_metrics_rsp, &em_metrics_t::process_msg},
+        {em_msg_type_beacon_metrics_query, &em_metrics_t::process_msg},
+        {em_msg_type_beacon_metrics_rsp, &em_metrics_t::process_msg},
+        {em_msg_type_ap_metrics_rsp, &em_metrics_t::process_msg},
+        {em_msg_type_unassoc_sta_link_metrics_query, &em_metrics_t::process_msg},
+        {em_msg_type_unassoc_sta_link_metrics_rsp, &em_metrics_t::process_msg},
+
+        {em_msg_type_dpp_cce_ind, &em_provisioning_t::process_msg},
+        {em_msg_type_proxied_encap_dpp, &em_provisioning_t::process_msg},
+        {em_msg_type_direct_encap_dpp, &em_provisioning_t::process_msg},
+        {em_msg_type_reconfig_trigger, &em_provisioning_t::process_msg},
+        {em_msg_type_chirp_notif, &em_provisioning_t::process_msg},
+        {em_msg_type_dpp_bootstrap_uri_notif, &em_provisioning_t::process_msg},
+        {em_msg_type_1905_rekey_req, &em_provisioning_t::process_msg},
+        {em_msg_type_1905_encap_eapol, &em_provisioning_t::process_msg},
+
+        {em_msg_type_client_steering_req, &em_t::process_steering_msg},
+        {em_msg_type_client_steering_btm_rprt, &em_t::process_steering_msg},
+        {em_msg_type_client_assoc_ctrl_req, &em_t::process_steering_msg},
+        {em_msg_type_bh_steering_req, &em_t::process_steering_msg},
+        {em_msg_type_bh_steering_rsp, &em_t::process_steering_msg},
+        {em_msg_type_1905_ack, &em_t::process_steering_msg},
+
+        {em_msg_type_map_policy_config_req, &em_policy_cfg_t::process_msg},
+    };
 
+    for (const auto& entry : map) {
+        handlers[em_msg_t::get_type_slot(entry.type)] = entry.handler;
+    }
 
-    dm_easy_mesh_t::macbytes_to_string(get_radio_interface_mac(), mac_str);
-    switch (htons(cmdu->type)) {
-        case em_msg_type_autoconf_search:
-        case em_msg_type_autoconf_resp:
-        case em_msg_type_autoconf_wsc:
-        case em_msg_type_autoconf_renew:
-        case em_msg_type_topo_resp:
-        case em_msg_type_topo_query:
-        case em_msg_type_topo_notif:
-        case em_msg_type_ap_mld_config_req:
-        case em_msg_type_ap_mld_config_resp:
-        case em_msg_type_bss_config_req:
-        case em_msg_type_bss_config_rsp:
-        case em_msg_type_bss_config_res:
-        case em_msg_type_agent_list:
-            em_configuration_t::process_msg(data, len);
-            break;
+    return handlers;
+}
 
-        case em_msg_type_ap_cap_query:
-        case em_msg_type_ap_cap_rprt:
-        case em_msg_type_client_cap_query:
-        case em_msg_type_client_cap_rprt:
-            em_capability_t::process_msg(data, len);
-            break;
+const std::array<em_t::em_msg_handler_t, EM_MSG_TYPE_SLOTS> em_t::m_msg_handlers = em_t::build_msg_handlers();
 
-        case em_msg_type_channel_pref_query:
-        case em_msg_type_channel_pref_rprt:
-        case em_msg_type_channel_sel_req:
-        case em_msg_type_channel_sel_rsp:
-        case em_msg_type_op_channel_rprt:
-        case em_msg_type_avail_spectrum_inquiry:
-		case em_msg_type_channel_scan_req:
-		case em_msg_type_channel_scan_rprt:
-            em_channel_t::process_msg(data, len);
-            break;
+void em_t::process_steering_msg(unsigned char *data, unsigned int len)
+{
+    em_cmdu_t *cmdu = reinterpret_cast<em_cmdu_t *> (data + sizeof(em_raw_hdr_t));
 
-        case em_msg_type_assoc_sta_link_metrics_query:
-        case em_msg_type_assoc_sta_link_metrics_rsp:
-        case em_msg_type_beacon_metrics_query:
-        case em_msg_type_beacon_metrics_rsp:
-        case em_msg_type_ap_metrics_rsp:
-            em_metrics_t::process_msg(data, len);
-            break;
+    // an ACK goes to the request with its message id, not to whatever the node does now
+    if ((htons(cmdu->type) == em_msg_type_1905_ack) && (em_configuration_t::is_ap_mld_ack(data, len) == true)) {
+        em_configuration_t::process_msg(data, len);
+    } else {
+        em_steering_t::process_msg(data, len);
+    }
+}
 
-        case em_msg_type_dpp_cce_ind:
-        case em_msg_type_proxied_encap_dpp:
-        case em_msg_type_direct_encap_dpp:
-        case em_msg_type_reconfig_trigger:
-        case em_msg_type_chirp_notif:
-        case em_msg_type_dpp_bootstrap_uri_notif:
-        case em_msg_type_1905_rekey_req:
-        case em_msg_type_1905_encap_eapol:
-            em_provisioning_t::process_msg(data, len);
-            break;
-        case em_msg_type_client_steering_req:
-        case em_msg_type_client_steering_btm_rprt:
-        case em_msg_type_1905_ack:
-            if (m_sm.get_state() == em_state_ctrl_ap_mld_configured) {
-                em_configuration_t::process_msg(data, len);
-            } else {
-                em_steering_t::process_msg(data, len);
-            }
-            break;
+void em_t::proto_process(unsigned char *data, unsigned int len, const em_frame_ts_t *ts)
+{
+    em_cmdu_t *cmdu;
+    em_msg_type_stats_t *stats;
+    em_msg_handler_t handler;
+    uint64_t start, elapsed;
+    unsigned int slot;
+
+    if (len < (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))) {
+        m_msg_stats[EM_MSG_TYPE_SLOT_OTHER].rx++;
+        m_msg_stats[EM_MSG_TYPE_SLOT_OTHER].drops++;
+        return;
+    }
 
-        case em_msg_type_map_policy_config_req:
-            em_policy_cfg_t::process_msg(data, len);
-            break;
+    cmdu = reinterpret_cast<em_cmdu_t *>(data + sizeof(em_raw_hdr_t));
+    slot = em_msg_t::get_type_slot(htons(cmdu->type));
+    stats = &m_msg_stats[slot];
+    stats->rx++;
 
-        case em_msg_type_bh_sta_cap_query:
-        case em_msg_type_bh_sta_cap_rprt:
-            em_printfout("  proto_process, type rcvd: %d", htons(cmdu->type));
-            em_capability_t::process_msg(data, len);
-            break;
+    if ((handler = m_msg_handlers[slot]) == NULL) {
+        stats->drops++;
+        return;
+    }
 
-        default:
-            break;
+    start = em_lat_hist_t::get_time_us();
+    {
+        EM_PROFILE_SCOPE(em_profile_domain_cmdu, htons(cmdu->type));
+        (this->*handler)(data, len);
     }
+    elapsed = em_lat_hist_t::get_time_us() - start;
 
-    free(data);
+    em_perf_t::inc(em_perf_ctr_frames_rx);
+    em_perf_t::record(em_perf_hist_proto_process, elapsed);
+    if (ts != NULL) {
+        em_frame_trace_t::record(htons(cmdu->type), ts, start, start + elapsed);
+    }
+    stats->handler_us += elapsed;
+    stats->handler_max_us = (elapsed > stats->handler_max_us) ? elapsed:stats->handler_max_us;
 }
 
 void em_t::handle_agent_state()
@@ -451,8 +501,7 @@ void em_t::handle_ctrl_state()
 
     assert(m_cmd != NULL);
 
-    //printf("%s:%d: Cmd: %s State: %s\n", __func__, __LINE__,
-        //em_cmd_t::get_cmd_type_str(m_cmd->m_type), em_t::state_2_str(get_state()));
+    em_trace(EM_MGR, em_trace_event_ctrl_state, m_cmd->m_type, get_state());
     cmd_type = m_cmd->m_type;
     switch (cmd_type) {
         case em_cmd_type_set_ssid:
@@ -487,6 +536,7 @@ void em_t::handle_ctrl_state()
 			break;
 
         case em_cmd_type_sta_steer:
+        case em_cmd_type_sta_steer_batch:
             em_steering_t::process_ctrl_state();
             break;
 
@@ -513,89 +563,298 @@ void em_t::handle_ctrl_state()
 
 void em_t::proto_timeout()
 {
+    // the state code runs on a state change, an event or the deadline of the state, not on every tick
+    bool due = m_sm.begin_run(em_lat_hist_t::get_time_us());
+
     if (m_service_type == em_service_type_agent) {
-        handle_agent_state();
+        if (due == true) {
+            handle_agent_state();
+        }
+        flush_topology_notifications();
     } else if (m_service_type == em_service_type_ctrl) {
-        handle_ctrl_state();
+        if (due == true) {
+            handle_ctrl_state();
+        }
+        send_pending_beacon_queries();
+        send_pending_unassoc_sta_queries();
+        send_requested_topology_query();
+        send_requested_tid_to_link_map_policy();
+        send_requested_bh_steer();
+        if (m_ec_manager != nullptr) {
+            m_ec_manager->handle_gtk_rekey_timeout();
+            m_ec_manager->handle_dpp_session_timeout();
+        }
+    }
+}
+
+bool em_t::is_idle()
+{
+    if ((m_sm.is_waiting() == false) || (m_ec_manager != nullptr)) {
+        return false;
+    }
+
+    if (m_service_type == em_service_type_agent) {
+        return has_queued_topology_notifications() == false;
+    }
+
+    return (has_pending_beacon_queries() == false) && (has_pending_unassoc_sta_queries() == false) &&
+        (has_requested_topology_query() == false) && (has_requested_tid_to_link_map_policy() == false) &&
+        (has_requested_bh_steer() == false);
+}
+
+void em_t::wake()
+{
+    em_worker_slot_t *slot;
+
+    if ((slot = m_slot.load()) != NULL) {
+        m_mgr->get_worker_pool()->unpark(slot);
+    } else if (m_parked.exchange(false) == true) {
+        m_iq.wake();
+    }
+}
+
+void em_t::worker_tick(void *ctx)
+{
+    em_t *em = static_cast<em_t *>(ctx);
+    em_worker_slot_t *slot;
+
+    em->proto_timeout();
+
+    // parked before looking, so that a wake up racing with the check unparks it again
+    if ((slot = em->m_slot.load()) != NULL) {
+        em->m_mgr->get_worker_pool()->park(slot);
+        if (em->is_idle() == false) {
+            em->m_mgr->get_worker_pool()->unpark(slot);
+        }
     }
 }
 
 void em_t::proto_exit()
 {
+    em_worker_slot_t *slot;
+
     m_exit = true;
-    pthread_cond_signal(&m_iq.cond);
+    if ((slot = m_slot.exchange(NULL)) != NULL) {
+        // waits for the home worker if it is running this em
+        m_mgr->get_worker_pool()->detach(slot);
+        return;
+    }
+    m_iq.wake();
     sched_yield();
 }
 
-void em_t::proto_run()
+int em_t::submit_crypto_job(em_crypto_job_t *job)
+{
+    em_crypto_pool_t *pool = m_mgr->get_crypto_pool();
+
+    if ((pool->get_num_workers() == 0) || (m_exit == true)) {
+        return -1;
+    }
+
+    job->owner = this;
+    job->done = em_t::crypto_job_done;
+    m_crypto_inflight++;
+    if (pool->submit(job) != 0) {
+        m_crypto_inflight--;
+        return -1;
+    }
+
+    return 0;
+}
+
+void em_t::queue_resume(em_crypto_job_t *job)
+{
+    em_worker_slot_t *slot;
+
+    pthread_mutex_lock(&m_crypto_lock);
+    job->next = NULL;
+    if (m_crypto_tail == NULL) {
+        m_crypto_head = job;
+    } else {
+        m_crypto_tail->next = job;
+    }
+    m_crypto_tail = job;
+    pthread_mutex_unlock(&m_crypto_lock);
+
+    if ((slot = m_slot.load()) != NULL) {
+        m_mgr->get_worker_pool()->schedule(slot);
+    } else {
+        m_iq.wake();
+    }
+}
+
+void em_t::crypto_job_done(em_crypto_job_t *job)
+{
+    em_t *em = static_cast<em_t *>(job->owner);
+
+    em->queue_resume(job);
+
+    // deinit() waits for this, the em may be gone from here on
+    em->m_crypto_inflight--;
+}
+
+int em_t::defer(unsigned int delay_ms, std::function<void()> fn)
+{
+    em_deferred_t *d;
+
+    if (m_exit == true) {
+        return -1;
+    }
+
+    d = new em_deferred_t();
+    d->job.resume = em_t::deferred_resume;
+    d->job.owner = d;
+    d->job.result = 0;
+    d->job.next = NULL;
+    em_timer_wheel_t::init_timer(&d->timer);
+    d->em = this;
+    d->fn = std::move(fn);
+
+    pthread_mutex_lock(&m_crypto_lock);
+    m_deferred.insert(d);
+    pthread_mutex_unlock(&m_crypto_lock);
+
+    m_mgr->add_timer_async(&d->timer, delay_ms, em_t::deferred_expired, d);
+
+    return 0;
+}
+
+void em_t::deferred_expired(void *arg)
+{
+    em_deferred_t *d = static_cast<em_deferred_t *>(arg);
+
+    // runs on the manager thread, deinit() cancels the timer there before the em goes
+    d->em->queue_resume(&d->job);
+}
+
+void em_t::deferred_resume(em_crypto_job_t *job)
+{
+    em_deferred_t *d = static_cast<em_deferred_t *>(job->owner);
+    em_t *em = d->em;
+
+    pthread_mutex_lock(&em->m_crypto_lock);
+    em->m_deferred.erase(d);
+    pthread_mutex_unlock(&em->m_crypto_lock);
+
+    d->fn();
+    delete d;
+}
+
+unsigned int em_t::resume_crypto_jobs()
+{
+    em_crypto_job_t *job, *next;
+    unsigned int num = 0;
+
+    pthread_mutex_lock(&m_crypto_lock);
+    job = m_crypto_head;
+    m_crypto_head = NULL;
+    m_crypto_tail = NULL;
+    pthread_mutex_unlock(&m_crypto_lock);
+
+    for (; job != NULL; job = next) {
+        next = job->next;
+        job->next = NULL;
+        job->resume(job);
+        num++;
+    }
+
+    return num;
+}
+
+bool em_t::proto_run_batch(unsigned int budget)
 {
-    int rc;
     em_event_t *evt;
-    struct timespec time_to_wait;
-    struct timeval tm;
+    unsigned int num;
 
-    pthread_mutex_lock(&m_iq.lock);
-    while (m_exit == false) {
-        rc = 0;
+    num = resume_crypto_jobs();
+    while ((num < budget) && ((evt = pop_from_queue()) != NULL)) {
+        if (evt->type == em_event_type_action) {
+            m_mgr->handle_node_action_frame(this, evt->u.fevt.frame, evt->u.fevt.frame_len);
+        } else {
+            assert(evt->type == em_event_type_frame);
+            proto_process(evt->u.fevt.frame, evt->u.fevt.frame_len, &em_frame_ring_t::from_event(evt)->ts);
+        }
+        m_mgr->free_frame_event(evt);
+        num++;
+    }
 
-        gettimeofday(&tm, NULL);
-        time_to_wait.tv_sec = tm.tv_sec;
-        time_to_wait.tv_nsec = tm.tv_usec * 1000;
-        time_to_wait.tv_sec += m_iq.timeout;
+    // frames move the state machine, let the orchestrator look at it now
+    if (num != 0) {
+        m_sm.kick();
+        if (m_orch_state == em_orch_state_progress) {
+            m_mgr->kick_orch();
+        }
+    }
+
+    return m_iq.count() != 0;
+}
 
-        if (queue_count(m_iq.queue) == 0) {
-            rc = pthread_cond_timedwait(&m_iq.cond, &m_iq.lock, &time_to_wait);
+void em_t::proto_run()
+{
+    while (m_exit == false) {
+        // an idle em sleeps until a frame, a command or another node wakes it
+        m_parked = true;
+        if (is_idle() == false) {
+            m_parked = false;
         }
-        if ((rc == 0) || (queue_count(m_iq.queue) != 0)) {
-            // dequeue data
-            while (queue_count(m_iq.queue)) {
-                evt = static_cast<em_event_t *>(queue_pop(m_iq.queue));
-                if (evt == NULL) {
-                    continue;
-                }
-                pthread_mutex_unlock(&m_iq.lock);
-                assert(evt->type == em_event_type_frame);
-                proto_process(evt->u.fevt.frame, evt->u.fevt.frame_len);
-                free(evt);
-                pthread_mutex_lock(&m_iq.lock);
-            }
-        } else if (rc == ETIMEDOUT) {
-            pthread_mutex_unlock(&m_iq.lock);
-            proto_timeout();
-            pthread_mutex_lock(&m_iq.lock);
+        if (m_iq.wait((m_parked.load() == true) ? -1:(EM_PROTO_TOUT * 1000)) == true) {
+            while (proto_run_batch(EM_NODE_QUEUE_SZ) == true);
         } else {
-            printf("%s:%d em exited with rc - %d\n",__func__,__LINE__,rc);
-            pthread_mutex_unlock(&m_iq.lock);
-            return;
+            proto_timeout();
         }
     }
-    pthread_mutex_unlock(&m_iq.lock);
 
 }
 
 void *em_t::em_func(void *arg)
 {
-    size_t stack_size2;
-    pthread_attr_t attr;
-
-    pthread_attr_init(&attr);
-    pthread_attr_getstacksize(&attr, &stack_size2);
-    printf("%s:%d Thread stack size = %ld bytes \n", __func__, __LINE__, stack_size2);
-    pthread_attr_destroy(&attr);
     em_t *m = static_cast<em_t *>(arg);
+    char name[EM_STACK_NAME_LEN];
+    int slot;
 
+    snprintf(name, sizeof(name), "node-%s", util::mac_to_string(m->get_radio_interface_mac()).c_str());
+    slot = em_stack_t::enter(em_stack_role_node, name);
+    em_sched_t::apply(em_stack_role_node, name);
     m->proto_run();
+    em_stack_t::leave(slot);
     return NULL;
 }
 
 void em_t::deinit()
 {
+    em_worker_slot_t *slot;
+    em_event_t *evt;
+
     m_exit = true;
-    pthread_cond_destroy(&m_iq.cond);
-    pthread_mutex_destroy(&m_iq.lock);
+    if ((slot = m_slot.exchange(NULL)) != NULL) {
+        m_mgr->get_worker_pool()->detach(slot);
+    }
+
+    // the crypto workers still hold jobs of this em, finished ones are dropped with it
+    while (m_crypto_inflight.load() != 0) {
+        usleep(1000);
+    }
+
+    // continuations not run yet, deinit() runs on the manager thread so their timers can not fire meanwhile
+    for (auto d : m_deferred) {
+        m_mgr->cancel_timer(&d->timer);
+        delete d;
+    }
+    m_deferred.clear();
+    m_crypto_head = NULL;
+    m_crypto_tail = NULL;
     close(m_fd);
 
-    queue_destroy(m_iq.queue);
+    pthread_mutex_lock(&m_tx_lock);
+    close_tx_socket();
+    pthread_mutex_unlock(&m_tx_lock);
+
+    // return frames that were never processed to the receive ring
+    while ((evt = pop_from_queue()) != NULL) {
+        m_mgr->free_frame_event(evt);
+    }
+
+    m_iq.deinit();
 }
 
 int em_t::set_bp_filter()
@@ -634,7 +893,7 @@ int em_t::set_bp_filter()
 int em_t::start_al_interface()
 {
 #ifdef AL_SAP
-    m_fd = g_sap->getDataSocketDescriptor();
+    m_fd = g_sap->getIndicationDescriptor();
 #else
     int sock_fd;
     struct sockaddr_ll addr_ll;
@@ -662,6 +921,9 @@ int em_t::start_al_interface()
     m_fd = sock_fd;
 
     set_bp_filter();
+    if (em_frame_trace_t::enable_rx_timestamps(m_fd) != 0) {
+        printf("%s:%d: No receive timestamps, frames are traced from the read\n", __func__, __LINE__);
+    }
 #endif // AL_SAP
     return 0;
 }
@@ -673,6 +935,7 @@ int em_t::send_cmd(em_cmd_exec_t *exec, em_cmd_type_t type, em_service_type_t sv
 
 int em_t::send_frame(unsigned char *buff, unsigned int len, bool multicast)
 {
+    em_perf_scope_t scope(em_perf_hist_send_frame);
     int ret = 0;
     em_raw_hdr_t *hdr = reinterpret_cast<em_raw_hdr_t *>(buff);
 
@@ -681,46 +944,210 @@ int em_t::send_frame(unsigned char *buff, unsigned int len, bool multicast)
     em_printfout("ORIGINAL_ETH_FRAME:\t");
     util::print_hex_dump(len, buff);
 #endif
-    AlServiceDataUnit sdu;
     //override destination and source mac addresses
     MacAddress src_mac, dest_mac;
     std::copy(hdr->dst, hdr->dst + ETH_ALEN, dest_mac.begin());
     std::copy(hdr->src, hdr->src + ETH_ALEN, src_mac.begin());
 
-    sdu.setDestinationAlMacAddress(dest_mac);
-    sdu.setSourceAlMacAddress(src_mac);
-
 #ifdef DEBUG_MODE
     em_printfout("Destination MAC Address: " MACSTRFMT, MAC2STR(buff));
     em_printfout("Source MAC Address: " MACSTRFMT, MAC2STR(buff+ETH_ALEN));
 #endif
-    // Copy over the payload, excluding the header
-    sdu.setPayload({buff + sizeof(em_raw_hdr_t), buff + len});
-    g_sap->serviceAccessPointDataRequest(sdu);
+    // Send the payload, excluding the header, straight from the frame
+    g_sap->serviceAccessPointDataRequest(src_mac, dest_mac, buff + sizeof(em_raw_hdr_t), len - sizeof(em_raw_hdr_t));
 #else
-    em_short_string_t   ifname;
     struct sockaddr_ll sadr_ll;
-    int sock;
     mac_address_t   multi_addr = {0x01, 0x80, 0xc2, 0x00, 0x00, 0x13};
+    int sock, ifindex, retry;
+
+    pthread_mutex_lock(&m_tx_lock);
+    for (retry = 0; retry < 2; retry++) {
+        if ((sock = get_tx_socket(&ifindex)) < 0) {
+            ret = -1;
+            break;
+        }
 
+        memset(&sadr_ll, 0, sizeof(struct sockaddr_ll));
+        sadr_ll.sll_family = AF_PACKET;
+        sadr_ll.sll_ifindex = ifindex;
+        sadr_ll.sll_halen = ETH_ALEN; // length of destination mac address
+        sadr_ll.sll_protocol = htons(ETH_P_ALL);
+        memcpy(sadr_ll.sll_addr, (multicast == true) ? multi_addr:hdr->dst, sizeof(mac_address_t));
 
-    dm_easy_mesh_t::name_from_mac_address(reinterpret_cast<mac_address_t *>(get_al_interface_mac()), ifname);
+        ret = static_cast<int>(sendto(sock, buff, len, 0, reinterpret_cast<const struct sockaddr*>(&sadr_ll), sizeof(struct sockaddr_ll)));
+        if ((ret >= 0) || ((errno != ENXIO) && (errno != ENODEV) && (errno != ENETDOWN) && (errno != EBADF))) {
+            break;
+        }
+
+        // interface went away or was recreated, resolve it again
+        close_tx_socket();
+    }
+    pthread_mutex_unlock(&m_tx_lock);
+#endif
+
+    if (ret < 0) {
+        em_perf_t::inc(em_perf_ctr_frames_tx_errors);
+    } else {
+        em_perf_t::inc(em_perf_ctr_frames_tx);
+        em_perf_t::inc(em_perf_ctr_bytes_tx, len);
+        if (em_capture_t::is_active() == true) {
+            capture_frame(em_capture_dir_tx, buff, len);
+        }
+    }
 
-    sock = socket(AF_PACKET, SOCK_RAW, IPPROTO_RAW);
-    if (sock < 0) {
+    return ret;
+}
+
+int em_t::send_frames(unsigned char **buffs, unsigned int *lens, unsigned int num, bool multicast)
+{
+    unsigned int i;
+    int sent = 0;
+
+#ifdef AL_SAP
+    for (i = 0; i < num; i++) {
+        if (send_frame(buffs[i], lens[i], multicast) < 0) {
+            break;
+        }
+        sent++;
+    }
+#else
+    struct mmsghdr msgs[EM_MAX_TX_BATCH];
+    struct iovec iovs[EM_MAX_TX_BATCH];
+    struct sockaddr_ll addrs[EM_MAX_TX_BATCH];
+    mac_address_t   multi_addr = {0x01, 0x80, 0xc2, 0x00, 0x00, 0x13};
+    em_raw_hdr_t *hdr;
+    unsigned int n;
+    int sock, ifindex, ret;
+
+    pthread_mutex_lock(&m_tx_lock);
+    if ((sock = get_tx_socket(&ifindex)) < 0) {
+        pthread_mutex_unlock(&m_tx_lock);
+        em_perf_t::inc(em_perf_ctr_frames_tx_errors);
         return -1;
     }
 
-    sadr_ll.sll_ifindex = static_cast<int>(if_nametoindex(ifname));
-    sadr_ll.sll_halen = ETH_ALEN; // length of destination mac address
-    sadr_ll.sll_protocol = htons(ETH_P_ALL);
-    memcpy(sadr_ll.sll_addr, (multicast == true) ? multi_addr:hdr->dst, sizeof(mac_address_t));
+    while (static_cast<unsigned int>(sent) < num) {
+        n = num - static_cast<unsigned int>(sent);
+        n = (n > EM_MAX_TX_BATCH) ? EM_MAX_TX_BATCH:n;
+
+        memset(msgs, 0, sizeof(struct mmsghdr) * n);
+        memset(addrs, 0, sizeof(struct sockaddr_ll) * n);
+        for (i = 0; i < n; i++) {
+            hdr = reinterpret_cast<em_raw_hdr_t *>(buffs[static_cast<unsigned int>(sent) + i]);
+
+            addrs[i].sll_family = AF_PACKET;
+            addrs[i].sll_ifindex = ifindex;
+            addrs[i].sll_halen = ETH_ALEN;
+            addrs[i].sll_protocol = htons(ETH_P_ALL);
+            memcpy(addrs[i].sll_addr, (multicast == true) ? multi_addr:hdr->dst, sizeof(mac_address_t));
 
-    ret = static_cast<int>(sendto(sock, buff, len, 0, reinterpret_cast<const struct sockaddr*>(&sadr_ll), sizeof(struct sockaddr_ll)));
-    close(sock);
+            iovs[i].iov_base = buffs[static_cast<unsigned int>(sent) + i];
+            iovs[i].iov_len = lens[static_cast<unsigned int>(sent) + i];
+
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_ll);
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        if ((ret = sendmmsg(sock, msgs, n, 0)) <= 0) {
+            printf("%s:%d: sendmmsg failed after %d frames, err:%d\n", __func__, __LINE__, sent, errno);
+            if ((errno == ENXIO) || (errno == ENODEV) || (errno == ENETDOWN) || (errno == EBADF)) {
+                close_tx_socket();
+            }
+            break;
+        }
+        sent += ret;
+    }
+    pthread_mutex_unlock(&m_tx_lock);
+
+    // send_frame() counts the frames of the AL SAP path
+    em_perf_t::inc(em_perf_ctr_frames_tx, static_cast<uint64_t>(sent));
+    for (i = 0; i < static_cast<unsigned int>(sent); i++) {
+        em_perf_t::inc(em_perf_ctr_bytes_tx, lens[i]);
+        if (em_capture_t::is_active() == true) {
+            capture_frame(em_capture_dir_tx, buffs[i], lens[i]);
+        }
+    }
+    if (static_cast<unsigned int>(sent) < num) {
+        em_perf_t::inc(em_perf_ctr_frames_tx_errors);
+    }
 #endif
-   
-    return ret;
+
+    return (sent == 0) ? -1:sent;
+}
+
+void em_t::capture_frame(em_capture_dir_t dir, unsigned char *buff, unsigned int len)
+{
+    mac_addr_str_t mac_str;
+    char node[EM_CAPTURE_NODE_LEN];
+
+    dm_easy_mesh_t::macbytes_to_string(get_radio_interface_mac(), mac_str);
+    snprintf(node, sizeof(node), "node=%s if=%s svc=%s", mac_str, get_radio_interface_name(),
+        (m_service_type == em_service_type_ctrl) ? "ctrl":((m_service_type == em_service_type_agent) ? "agent":"other"));
+    em_capture_t::write(dir, node, buff, len);
+}
+
+int em_t::get_tx_socket(int *ifindex)
+{
+    em_short_string_t   ifname;
+    struct sockaddr_ll addr_ll;
+    unsigned char *al_mac = get_al_interface_mac();
+    unsigned int gen = m_tx_gen;
+    struct sock_filter drop_all[] = { BPF_STMT(BPF_RET | BPF_K, 0) };
+    struct sock_fprog drop_prog = { static_cast<unsigned short>(sizeof(drop_all) / sizeof(drop_all[0])), drop_all };
+
+    if ((m_tx_fd >= 0) && (m_tx_cached_gen == gen) && (memcmp(m_tx_mac, al_mac, sizeof(mac_address_t)) == 0)) {
+        *ifindex = m_tx_ifindex;
+        return m_tx_fd;
+    }
+
+    close_tx_socket();
+
+    if (dm_easy_mesh_t::name_from_mac_address(reinterpret_cast<mac_address_t *>(al_mac), ifname) != 0) {
+        printf("%s:%d: Can not find interface for al mac:" MACSTRFMT "\n", __func__, __LINE__, MAC2STR(al_mac));
+        return -1;
+    }
+
+    if ((m_tx_ifindex = static_cast<int>(if_nametoindex(ifname))) == 0) {
+        printf("%s:%d: Can not find index for interface:%s, err:%d\n", __func__, __LINE__, ifname, errno);
+        return -1;
+    }
+
+    if ((m_tx_fd = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, IPPROTO_RAW)) < 0) {
+        printf("%s:%d: Error opening socket, err:%d\n", __func__, __LINE__, errno);
+        return -1;
+    }
+
+    // the socket keeps the protocol it was opened with, a bind with protocol 0 does not
+    // change what it receives, so drop every frame in the kernel before it is queued
+    if (setsockopt(m_tx_fd, SOL_SOCKET, SO_ATTACH_FILTER, &drop_prog, sizeof(drop_prog)) < 0) {
+        printf("%s:%d: Failed to attach drop filter to interface:%s, err:%d\n", __func__, __LINE__, ifname, errno);
+    }
+
+    memset(&addr_ll, 0, sizeof(struct sockaddr_ll));
+    addr_ll.sll_family = AF_PACKET;
+    addr_ll.sll_ifindex = m_tx_ifindex;
+    if (bind(m_tx_fd, reinterpret_cast<struct sockaddr *>(&addr_ll), sizeof(struct sockaddr_ll)) < 0) {
+        printf("%s:%d: Error binding to interface:%s, err:%d\n", __func__, __LINE__, ifname, errno);
+        close_tx_socket();
+        return -1;
+    }
+
+    memcpy(m_tx_mac, al_mac, sizeof(mac_address_t));
+    m_tx_cached_gen = gen;
+    *ifindex = m_tx_ifindex;
+
+    return m_tx_fd;
+}
+
+void em_t::close_tx_socket()
+{
+    if (m_tx_fd >= 0) {
+        close(m_tx_fd);
+    }
+    m_tx_fd = -1;
+    m_tx_ifindex = 0;
 }
 
 bool em_t::is_matching_freq_band(em_freq_band_t *band)
@@ -868,15 +1295,25 @@ bool em_t::trigger_sta_scan()
 
 void em_t::push_to_queue(em_event_t *evt)
 {
-    pthread_mutex_lock(&m_iq.lock);
-    queue_push(m_iq.queue, evt);
-    pthread_cond_signal(&m_iq.cond);
-    pthread_mutex_unlock(&m_iq.lock);
+    em_worker_slot_t *slot;
+
+    // the listener feeds every node, it does not wait for the worker of one of them
+    if (m_iq.push(evt) == false) {
+        em_perf_t::inc(em_perf_ctr_node_frames_dropped);
+        printf("%s:%d: Ingress queue full, dropping frame of len:%d, %u dropped\n", __func__, __LINE__,
+            evt->u.fevt.frame_len, m_iq.get_drops());
+        m_mgr->free_frame_event(evt);
+        return;
+    }
+
+    if ((slot = m_slot.load()) != NULL) {
+        m_mgr->get_worker_pool()->schedule(slot);
+    }
 }
 
 em_event_t *em_t::pop_from_queue()
 {
-    return reinterpret_cast<em_event_t *>(queue_pop(m_iq.queue));
+    return static_cast<em_event_t *>(m_iq.pop());
 }
 
 dm_sta_t *em_t::find_sta(mac_address_t sta_mac, bssid_t bssid)
@@ -978,7 +1415,63 @@ short em_t::create_ap_radio_basic_cap(unsigned char *buff) {
     return static_cast<short>(len);
 }
 
+short em_t::get_cap_tlv(em_cap_tlv_t type, unsigned char *buff)
+{
+    std::vector<unsigned char>& cached = m_cap_tlv[type];
+    unsigned int gen = m_data_model->get_radio_generation();
+    short len;
+
+    pthread_mutex_lock(&m_cap_lock);
+    if (m_cap_gen != gen) {
+        for (auto& tlv : m_cap_tlv) {
+            tlv.clear();
+        }
+        m_cap_gen = gen;
+    }
+
+    if (cached.empty() == false) {
+        memcpy(buff, cached.data(), cached.size());
+        len = static_cast<short>(cached.size());
+    } else if ((len = encode_cap_tlv(type, buff)) > 0) {
+        cached.assign(buff, buff + len);
+    }
+    pthread_mutex_unlock(&m_cap_lock);
+
+    return len;
+}
+
+short em_t::encode_cap_tlv(em_cap_tlv_t type, unsigned char *buff)
+{
+    switch (type) {
+        case em_cap_tlv_ap_cap:
+            return encode_ap_cap_tlv(buff);
+        case em_cap_tlv_ht:
+            return encode_ht_tlv(buff);
+        case em_cap_tlv_vht:
+            return encode_vht_tlv(buff);
+        case em_cap_tlv_he:
+            return encode_he_tlv(buff);
+        case em_cap_tlv_wifi6:
+            return encode_wifi6_tlv(buff);
+        case em_cap_tlv_wifi7:
+            return encode_wifi7_tlv(buff);
+        case em_cap_tlv_channel_scan:
+            return encode_channelscan_tlv(buff);
+        case em_cap_tlv_cac:
+            return encode_cac_cap_tlv(buff);
+        default:
+            break;
+    }
+
+    return 0;
+}
+
 short em_t::create_ap_cap_tlv(unsigned char *buff)
+{
+    return get_cap_tlv(em_cap_tlv_ap_cap, buff);
+}
+
+short em_t::encode_ap_cap_tlv(unsigned char *buff)
 {
     short len = 0;
     dm_radio_t* radio = get_data_model()->get_radio(get_radio_interface_mac());
@@ -1019,6 +1512,11 @@ short em_t::create_ap_radio_advanced_cap_tlv(unsigned char *buff)
 }
 
 short em_t::create_ht_tlv(unsigned char *buff)
+{
+    return get_cap_tlv(em_cap_tlv_ht, buff);
+}
+
+short em_t::encode_ht_tlv(unsigned char *buff)
 {
     short len = 0;
     dm_easy_mesh_t  *dm;
@@ -1044,6 +1542,11 @@ short em_t::create_ht_tlv(unsigned char *buff)
 }
 
 short em_t::create_vht_tlv(unsigned char *buff)
+{
+    return get_cap_tlv(em_cap_tlv_vht, buff);
+}
+
+short em_t::encode_vht_tlv(unsigned char *buff)
 {
     short len = 0;
     dm_easy_mesh_t  *dm;
@@ -1068,6 +1571,11 @@ short em_t::create_vht_tlv(unsigned char *buff)
 }
 
 short em_t::create_he_tlv(unsigned char *buff)
+{
+    return get_cap_tlv(em_cap_tlv_he, buff);
+}
+
+short em_t::encode_he_tlv(unsigned char *buff)
 {
     short len = 0;
     dm_easy_mesh_t  *dm;
@@ -1093,6 +1601,11 @@ short em_t::create_he_tlv(unsigned char *buff)
 
 
 short em_t::create_wifi6_tlv(unsigned char *buff)
+{
+    return get_cap_tlv(em_cap_tlv_wifi6, buff);
+}
+
+short em_t::encode_wifi6_tlv(unsigned char *buff)
 {
     short len = 0;
     dm_easy_mesh_t  *dm;
@@ -1117,6 +1630,11 @@ short em_t::create_wifi6_tlv(unsigned char *buff)
 }
 
 short em_t::create_wifi7_tlv(unsigned char *buff)
+{
+    return get_cap_tlv(em_cap_tlv_wifi7, buff);
+}
+
+short em_t::encode_wifi7_tlv(unsigned char *buff)
 {
     short len = 0;
     dm_easy_mesh_t  *dm;
@@ -1141,6 +1659,11 @@ short em_t::create_wifi7_tlv(unsigned char *buff)
 }
 
 short em_t::create_channelscan_tlv(unsigned char *buff)
+{
+    return get_cap_tlv(em_cap_tlv_channel_scan, buff);
+}
+
+short em_t::encode_channelscan_tlv(unsigned char *buff)
 {
     short len = 0;
     dm_easy_mesh_t  *dm;
@@ -1257,6 +1780,11 @@ short em_t::create_metric_col_int_tlv(unsigned char *buff)
 }
 
 short em_t::create_cac_cap_tlv(unsigned char *buff)
+{
+    return get_cap_tlv(em_cap_tlv_cac, buff);
+}
+
+short em_t::encode_cac_cap_tlv(unsigned char *buff)
 {
     short len = 0;
     dm_easy_mesh_t  *dm;
@@ -1757,7 +2285,9 @@ int em_t::push_event(em_event_t *evt)
 {
 	em_event_t *e;
 
-    e = static_cast<em_event_t *>(malloc(sizeof(em_event_t)));
+    if ((e = m_mgr->alloc_event(0)) == NULL) {
+        return -1;
+    }
     memcpy(e, evt, sizeof(em_event_t));
 
     m_mgr->push_to_queue(e);
@@ -1779,35 +2309,33 @@ int em_t::init()
     m_exit = false;
 
     // initialize the ingress queue
-    m_iq.queue = queue_create();
-    pthread_mutex_init(&m_iq.lock, NULL);
-    pthread_cond_init(&m_iq.cond, NULL);
-    m_iq.timeout = EM_PROTO_TOUT;
+    if (m_iq.init(EM_NODE_QUEUE_SZ) != 0) {
+        return -1;
+    }
 
     // initialize the crypto
     m_crypto.init();
 
-    size_t stack_size = 0x800000; /* 8MB */
+    if (m_mgr->get_worker_pool()->get_num_workers() != 0) {
+        // the frames of this em are run by its home worker
+        m_slot = m_mgr->get_worker_pool()->attach(this);
+        if (m_slot.load() != NULL) {
+            return 0;
+        }
+        printf("%s:%d: Failed to attach to the worker pool, starting an em thread\n", __func__, __LINE__);
+    }
+
     pthread_attr_t attr;
     pthread_attr_t *attrp = NULL;
-    int ret = 0;
     attrp = &attr;
     pthread_attr_init(&attr);
-    // Setting explicitly stacksize as in few platforms(e.g. openwrt) if not called, the
-    // new thread will inherit the default stack size which is significantly less
-    // leading to stack overflow.
-    ret = pthread_attr_setstacksize(&attr, stack_size);
-    if (ret != 0) {
-        printf("%s:%d pthread_attr_setstacksize failed for size:%ld ret:%d\n",
-                __func__, __LINE__, stack_size, ret);
-    }
+    em_stack_t::set_attr(&attr, em_stack_role_node);
     pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
 
     if (pthread_create(&m_tid, attrp, em_t::em_func, this) != 0) {
         printf("%s:%d: Failed to start em thread\n", __func__, __LINE__);
         close(m_fd);
-        pthread_mutex_destroy(&m_iq.lock);
-        pthread_cond_destroy(&m_iq.cond);
+        m_iq.deinit();
         if(attrp != NULL) {
             pthread_attr_destroy(attrp);
         }
@@ -1912,6 +2440,10 @@ bool em_t::initialize_ec_manager(){
                                                 std::placeholders::_1, std::placeholders::_2, 
                                                 std::placeholders::_3, std::placeholders::_4,
                                                 std::placeholders::_5);
+    ops.send_encap_dpp_frame       = std::bind(&em_t::send_prox_encap_dpp_frame, this, 
+                                                std::placeholders::_1, std::placeholders::_2, 
+                                                std::placeholders::_3, std::placeholders::_4,
+                                                std::placeholders::_5, std::placeholders::_6);
     ops.send_dir_encap_dpp         = std::bind(&em_t::send_direct_encap_dpp_msg, this, 
                                                 std::placeholders::_1, std::placeholders::_2, 
                                                 std::placeholders::_3);
@@ -1932,6 +2464,9 @@ bool em_t::initialize_ec_manager(){
                                                std::placeholders::_1, std::placeholders::_2);
     ops.send_bss_config_req       = std::bind(&em_t::send_bss_config_req_msg, this, 
                                                 std::placeholders::_1);
+    ops.defer                      = [this](unsigned int delay_ms, std::function<void()> fn) {
+                                                return defer(delay_ms, std::move(fn)) == 0;
+                                            };
 
     // Enrollee callbacks
     if (service_type == em_service_type_agent) {
@@ -2051,8 +2586,11 @@ void em_t::cfg_1905_handshake_complete_handler(uint8_t peer_al_mac[ETH_ALEN], bo
     set_peer_1905_security_status(peer_al_mac, peer_1905_security_status::PEER_1905_SECURITY_SECURED);
 }
 
-em_t::em_t(em_interface_t *ruid, em_freq_band_t band, dm_easy_mesh_t *dm, em_mgr_t *mgr, em_profile_type_t profile, em_service_type_t type, bool is_al_em): m_data_model(), m_mgr(mgr), m_orch_state(), m_cmd(), m_sm(), m_service_type(), m_fd(0), m_ruid(*ruid), m_band(band), m_profile_type(profile), m_iq(), m_tid(), m_exit(), m_is_al_em(is_al_em)
+em_t::em_t(em_interface_t *ruid, em_freq_band_t band, dm_easy_mesh_t *dm, em_mgr_t *mgr, em_profile_type_t profile, em_service_type_t type, bool is_al_em): m_data_model(), m_mgr(mgr), m_orch_state(), m_cmd(), m_orch_links(NULL), m_msg_stats(), m_sm(), m_service_type(), m_fd(0), m_ruid(*ruid), m_band(band), m_profile_type(profile), m_iq(), m_tid(), m_slot(NULL), m_parked(false), m_exit(), m_is_al_em(is_al_em), m_tx_lock(), m_tx_fd(-1), m_tx_ifindex(0), m_tx_mac(), m_tx_gen(0), m_tx_cached_gen(0), m_crypto_lock(), m_crypto_head(NULL), m_crypto_tail(NULL), m_crypto_inflight(0), m_deferred(), m_cap_lock(), m_cap_gen(0)
 {
+    pthread_mutex_init(&m_tx_lock, NULL);
+    pthread_mutex_init(&m_crypto_lock, NULL);
+    pthread_mutex_init(&m_cap_lock, NULL);
     memcpy(&m_ruid, ruid, sizeof(em_interface_t));
     m_band = band;
     m_service_type = type;
@@ -2076,5 +2614,7 @@ em_t::em_t(em_interface_t *ruid, em_freq_band_t band, dm_easy_mesh_t *dm, em_mgr
 
 em_t::~em_t()
 {
-
+    pthread_mutex_destroy(&m_cap_lock);
+    pthread_mutex_destroy(&m_crypto_lock);
+    pthread_mutex_destroy(&m_tx_lock);
 }
@@ -0,0 +1,79 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include "em_ap_mld_sync.h"
+
+bool em_ap_mld_sync_t::is_acked(const unsigned char *tlv, unsigned int len) const
+{
+    if ((m_acked.empty() == true) || (m_acked.size() != len)) {
+        return false;
+    }
+
+    return memcmp(m_acked.data(), tlv, len) == 0;
+}
+
+void em_ap_mld_sync_t::sent(unsigned short msg_id, const unsigned char *tlv, unsigned int len)
+{
+    em_ap_mld_sync_pending_t p;
+
+    // a message id that wrapped around replaces the request it was given to before
+    for (auto it = m_pending.begin(); it != m_pending.end(); it++) {
+        if (it->msg_id == msg_id) {
+            m_pending.erase(it);
+            break;
+        }
+    }
+    if (m_pending.size() >= EM_AP_MLD_SYNC_MAX_PENDING) {
+        m_pending.erase(m_pending.begin());
+    }
+
+    p.msg_id = msg_id;
+    p.tlv.assign(tlv, tlv + len);
+    m_pending.push_back(std::move(p));
+}
+
+bool em_ap_mld_sync_t::ack(unsigned short msg_id)
+{
+    unsigned int i;
+
+    for (i = 0; i < m_pending.size(); i++) {
+        if (m_pending[i].msg_id == msg_id) {
+            break;
+        }
+    }
+    if (i == m_pending.size()) {
+        return false;
+    }
+
+    m_acked.swap(m_pending[i].tlv);
+    m_pending.erase(m_pending.begin(), m_pending.begin() + i + 1);
+
+    return true;
+}
+
+bool em_ap_mld_sync_t::is_pending(unsigned short msg_id) const
+{
+    for (const auto& p : m_pending) {
+        if (p.msg_id == msg_id) {
+            return true;
+        }
+    }
+
+    return false;
+}
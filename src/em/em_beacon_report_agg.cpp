@@ -0,0 +1,277 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "em_beacon_report_agg.h"
+
+// Measurement Report element, offsets in its body after the element ID and length
+#define EM_MEAS_RPRT_CHANNEL    4
+#define EM_MEAS_RPRT_RCPI       16
+#define EM_MEAS_RPRT_BSSID      18
+#define EM_MEAS_RPRT_MIN_LEN    (EM_MEAS_RPRT_BSSID + sizeof(bssid_t))
+#define EM_MEAS_RPRT_FIXED_LEN  29      // up to the Parent TSF, the optional subelements follow
+
+em_beacon_report_agg_sta_t *em_beacon_report_agg_t::get_sta(const unsigned char *sta, unsigned long long now)
+{
+    em_beacon_report_agg_sta_t *s, *slot = NULL;
+    unsigned int i;
+
+    for (i = 0; i < EM_BEACON_REPORT_AGG_MAX_STAS; i++) {
+        s = &m_stas[i];
+        if (s->used == false) {
+            if (slot == NULL) {
+                slot = s;
+            }
+        } else if (memcmp(s->sta, sta, sizeof(mac_address_t)) == 0) {
+            return s;
+        }
+    }
+
+    // all slots waiting, the STA waiting the longest gives way
+    if (slot == NULL) {
+        slot = &m_stas[0];
+        for (i = 1; i < EM_BEACON_REPORT_AGG_MAX_STAS; i++) {
+            if (m_stas[i].start_ms < slot->start_ms) {
+                slot = &m_stas[i];
+            }
+        }
+        m_stats.evicted++;
+    }
+
+    slot->used = true;
+    memcpy(slot->sta, sta, sizeof(mac_address_t));
+    memset(slot->bssid, 0, sizeof(bssid_t));
+    slot->start_ms = now;
+    slot->num_expected = 0;
+    slot->num_elems = 0;
+
+    return slot;
+}
+
+bool em_beacon_report_agg_t::is_complete(const em_beacon_report_agg_sta_t *s)
+{
+    unsigned int i, j;
+
+    if (s->num_expected == 0) {
+        return false;
+    }
+    for (i = 0; i < s->num_expected; i++) {
+        for (j = 0; j < s->num_elems; j++) {
+            if (s->elems[j].channel == s->expected[i]) {
+                break;
+            }
+        }
+        if (j == s->num_elems) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void em_beacon_report_agg_t::build(em_beacon_report_agg_sta_t *s, em_beacon_report_agg_report_t *report)
+{
+    unsigned int order[EM_BEACON_REPORT_AGG_MAX_ELEMS];
+    const em_beacon_report_agg_elem_t *e;
+    unsigned int i, j, tmp, total = 0, len;
+    bool compact;
+
+    // strongest first, so that the weakest are the ones left out of a full response
+    for (i = 0; i < s->num_elems; i++) {
+        order[i] = i;
+        total += s->elems[i].len;
+        for (j = i; (j > 0) && (s->elems[order[j]].rcpi > s->elems[order[j - 1]].rcpi); j--) {
+            tmp = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = tmp;
+        }
+    }
+    compact = (total > sizeof(report->elems));
+
+    memcpy(report->sta, s->sta, sizeof(mac_address_t));
+    memcpy(report->bssid, s->bssid, sizeof(bssid_t));
+    report->count = 0;
+    report->len = 0;
+    for (i = 0; i < s->num_elems; i++) {
+        e = &s->elems[order[i]];
+        len = e->len;
+        if ((compact == true) && (len > EM_MEAS_RPRT_FIXED_LEN + 2)) {
+            len = EM_MEAS_RPRT_FIXED_LEN + 2;
+        }
+        if (report->len + len > sizeof(report->elems)) {
+            break;
+        }
+        memcpy(&report->elems[report->len], e->data, len);
+        report->elems[report->len + 1] = static_cast<unsigned char>(len - 2);
+        report->len += len;
+        report->count++;
+    }
+
+    m_stats.responses++;
+    if (is_complete(s) == true) {
+        m_stats.complete++;
+    }
+    if (compact == true) {
+        m_stats.compacted++;
+    }
+    s->used = false;
+}
+
+void em_beacon_report_agg_t::expect(const unsigned char *sta, const unsigned char *channels, unsigned int num, unsigned long long now)
+{
+    em_beacon_report_agg_sta_t *s;
+    unsigned int i, j;
+
+    pthread_mutex_lock(&m_lock);
+    s = get_sta(sta, now);
+
+    // a new query starts a new measurement, reports of the previous one are not merged into it
+    s->start_ms = now;
+    s->num_elems = 0;
+    s->num_expected = 0;
+    for (i = 0; (i < num) && (s->num_expected < EM_BEACON_REPORT_AGG_MAX_CHANNELS); i++) {
+        for (j = 0; (j < s->num_expected) && (s->expected[j] != channels[i]); j++);
+        if (j == s->num_expected) {
+            s->expected[s->num_expected++] = channels[i];
+        }
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+unsigned int em_beacon_report_agg_t::add(const unsigned char *sta, const unsigned char *bssid, const unsigned char *elems,
+        unsigned int len, unsigned int count, unsigned long long now)
+{
+    em_beacon_report_agg_sta_t *s;
+    em_beacon_report_agg_elem_t *e;
+    const unsigned char *body;
+    unsigned int i, j, elem_len, num = 0;
+
+    pthread_mutex_lock(&m_lock);
+    s = get_sta(sta, now);
+    memcpy(s->bssid, bssid, sizeof(bssid_t));
+    m_stats.reports++;
+
+    for (i = 0; (i < count) && (len >= 2); i++) {
+        elem_len = elems[1];
+        if (len < elem_len + 2) {
+            printf("%s:%d: Measurement Report %d truncated\n", __func__, __LINE__, i);
+            break;
+        }
+        body = elems + 2;
+        if (elem_len >= EM_MEAS_RPRT_MIN_LEN) {
+            m_stats.elems++;
+
+            // the same BSS on the same channel, else a free slot, else the weakest if this one is stronger
+            e = NULL;
+            for (j = 0; j < s->num_elems; j++) {
+                if ((s->elems[j].channel == body[EM_MEAS_RPRT_CHANNEL]) &&
+                        (memcmp(s->elems[j].bssid, &body[EM_MEAS_RPRT_BSSID], sizeof(bssid_t)) == 0)) {
+                    e = &s->elems[j];
+                    m_stats.duplicates++;
+                    break;
+                }
+            }
+            if ((e == NULL) && (s->num_elems < EM_BEACON_REPORT_AGG_MAX_ELEMS)) {
+                e = &s->elems[s->num_elems++];
+            } else if (e == NULL) {
+                e = &s->elems[0];
+                for (j = 1; j < s->num_elems; j++) {
+                    if (s->elems[j].rcpi < e->rcpi) {
+                        e = &s->elems[j];
+                    }
+                }
+                if (e->rcpi >= body[EM_MEAS_RPRT_RCPI]) {
+                    e = NULL;
+                }
+            }
+            if (e != NULL) {
+                e->len = static_cast<unsigned char>(elem_len + 2);
+                e->channel = body[EM_MEAS_RPRT_CHANNEL];
+                e->rcpi = body[EM_MEAS_RPRT_RCPI];
+                memcpy(e->bssid, &body[EM_MEAS_RPRT_BSSID], sizeof(bssid_t));
+                memcpy(e->data, elems, elem_len + 2);
+                num++;
+            }
+        }
+        elems += elem_len + 2;
+        len -= elem_len + 2;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+bool em_beacon_report_agg_t::pop_ready(unsigned long long now, em_beacon_report_agg_report_t *report)
+{
+    em_beacon_report_agg_sta_t *s, *ready = NULL;
+    unsigned int i;
+
+    pthread_mutex_lock(&m_lock);
+    for (i = 0; i < EM_BEACON_REPORT_AGG_MAX_STAS; i++) {
+        s = &m_stas[i];
+        if ((s->used == false) || ((is_complete(s) == false) && (now < s->start_ms + EM_BEACON_REPORT_AGG_DEADLINE_MS))) {
+            continue;
+        }
+        if (s->num_elems == 0) {
+            s->used = false;
+        } else if ((ready == NULL) || (s->start_ms < ready->start_ms)) {
+            ready = s;
+        }
+    }
+    if (ready != NULL) {
+        build(ready, report);
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return (ready != NULL);
+}
+
+unsigned int em_beacon_report_agg_t::get_pending()
+{
+    unsigned int i, num = 0;
+
+    pthread_mutex_lock(&m_lock);
+    for (i = 0; i < EM_BEACON_REPORT_AGG_MAX_STAS; i++) {
+        if (m_stas[i].used == true) {
+            num++;
+        }
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+void em_beacon_report_agg_t::get_stats(em_beacon_report_agg_stats_t *stats)
+{
+    pthread_mutex_lock(&m_lock);
+    *stats = m_stats;
+    pthread_mutex_unlock(&m_lock);
+}
+
+em_beacon_report_agg_t::em_beacon_report_agg_t()
+{
+    pthread_mutex_init(&m_lock, NULL);
+    memset(m_stas, 0, sizeof(m_stas));
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+em_beacon_report_agg_t::~em_beacon_report_agg_t()
+{
+    pthread_mutex_destroy(&m_lock);
+}
@@ -0,0 +1,246 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "em_beacon_report_cache.h"
+
+// Measurement Report element, offsets in its body after the element ID and length
+#define EM_MEAS_RPRT_OP_CLASS   3
+#define EM_MEAS_RPRT_CHANNEL    4
+#define EM_MEAS_RPRT_RCPI       16
+#define EM_MEAS_RPRT_RSNI       17
+#define EM_MEAS_RPRT_BSSID      18
+#define EM_MEAS_RPRT_MIN_LEN    (EM_MEAS_RPRT_BSSID + sizeof(bssid_t))
+
+unsigned long long em_beacon_report_cache_t::sta_key(const unsigned char *sta)
+{
+    unsigned long long key = 0;
+
+    memcpy(&key, sta, sizeof(mac_address_t));
+
+    return key;
+}
+
+void em_beacon_report_cache_t::update(const unsigned char *sta, const em_beacon_report_entry_t *entry)
+{
+    em_beacon_report_sta_t *s;
+    unsigned int i, slot;
+
+    pthread_rwlock_wrlock(&m_lock);
+
+    auto it = m_stas.find(sta_key(sta));
+    if (it == m_stas.end()) {
+        it = m_stas.emplace(sta_key(sta), em_beacon_report_sta_t()).first;
+        it->second.num = 0;
+    }
+    s = &it->second;
+
+    // same BSS on the same channel, else a free slot, else the oldest entry
+    slot = s->num;
+    for (i = 0; i < s->num; i++) {
+        if ((memcmp(s->entries[i].bssid, entry->bssid, sizeof(bssid_t)) == 0) && (s->entries[i].channel == entry->channel)) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot == EM_BEACON_REPORT_MAX_PER_STA) {
+        slot = 0;
+        for (i = 1; i < s->num; i++) {
+            if (s->entries[i].time_ms < s->entries[slot].time_ms) {
+                slot = i;
+            }
+        }
+    } else if (slot == s->num) {
+        s->num++;
+    }
+    s->entries[slot] = *entry;
+    s->last_ms = entry->time_ms;
+
+    pthread_rwlock_unlock(&m_lock);
+}
+
+unsigned int em_beacon_report_cache_t::add_reports(const unsigned char *sta, const unsigned char *elems, unsigned int len, unsigned int count, unsigned long long now)
+{
+    em_beacon_report_entry_t entry;
+    const unsigned char *body;
+    unsigned int i, elem_len, num = 0;
+
+    for (i = 0; (i < count) && (len >= 2); i++) {
+        elem_len = elems[1];
+        if (len < elem_len + 2) {
+            printf("%s:%d: Measurement Report %d truncated\n", __func__, __LINE__, i);
+            break;
+        }
+        body = elems + 2;
+        if (elem_len >= EM_MEAS_RPRT_MIN_LEN) {
+            memset(&entry, 0, sizeof(entry));
+            memcpy(entry.bssid, &body[EM_MEAS_RPRT_BSSID], sizeof(bssid_t));
+            entry.op_class = body[EM_MEAS_RPRT_OP_CLASS];
+            entry.channel = body[EM_MEAS_RPRT_CHANNEL];
+            entry.rcpi = body[EM_MEAS_RPRT_RCPI];
+            entry.rsni = body[EM_MEAS_RPRT_RSNI];
+            entry.time_ms = now;
+            update(sta, &entry);
+            num++;
+        }
+        elems += elem_len + 2;
+        len -= elem_len + 2;
+    }
+
+    // a response without a usable report still makes the STA fresh, it was just measured
+    if (num == 0) {
+        pthread_rwlock_wrlock(&m_lock);
+        auto it = m_stas.find(sta_key(sta));
+        if (it == m_stas.end()) {
+            it = m_stas.emplace(sta_key(sta), em_beacon_report_sta_t()).first;
+            it->second.num = 0;
+        }
+        it->second.last_ms = now;
+        pthread_rwlock_unlock(&m_lock);
+    }
+
+    return num;
+}
+
+bool em_beacon_report_cache_t::is_fresh(const unsigned char *sta, unsigned long long now)
+{
+    bool fresh;
+
+    pthread_rwlock_rdlock(&m_lock);
+    auto it = m_stas.find(sta_key(sta));
+    fresh = (it != m_stas.end()) && (now < it->second.last_ms + EM_BEACON_REPORT_FRESH_MS);
+    pthread_rwlock_unlock(&m_lock);
+
+    return fresh;
+}
+
+unsigned int em_beacon_report_cache_t::get_reports(const unsigned char *sta, em_beacon_report_entry_t *entries, unsigned int max)
+{
+    unsigned int num;
+
+    pthread_rwlock_rdlock(&m_lock);
+
+    auto it = m_stas.find(sta_key(sta));
+    if (it == m_stas.end()) {
+        pthread_rwlock_unlock(&m_lock);
+        return 0;
+    }
+    num = (it->second.num < max) ? it->second.num:max;
+    memcpy(entries, it->second.entries, num * sizeof(em_beacon_report_entry_t));
+
+    pthread_rwlock_unlock(&m_lock);
+
+    return num;
+}
+
+bool em_beacon_report_cache_t::get_best(const unsigned char *sta, const unsigned char *exclude, em_beacon_report_entry_t *entry)
+{
+    const em_beacon_report_entry_t *best = NULL, *e;
+    unsigned int i;
+
+    pthread_rwlock_rdlock(&m_lock);
+
+    auto it = m_stas.find(sta_key(sta));
+    if (it != m_stas.end()) {
+        for (i = 0; i < it->second.num; i++) {
+            e = &it->second.entries[i];
+            if ((exclude != NULL) && (memcmp(e->bssid, exclude, sizeof(bssid_t)) == 0)) {
+                continue;
+            }
+            if ((best == NULL) || (e->rcpi > best->rcpi)) {
+                best = e;
+            }
+        }
+    }
+    if (best != NULL) {
+        *entry = *best;
+    }
+
+    pthread_rwlock_unlock(&m_lock);
+
+    return best != NULL;
+}
+
+unsigned int em_beacon_report_cache_t::age_out(unsigned long long now)
+{
+    em_beacon_report_sta_t *s;
+    unsigned int i, removed = 0;
+
+    if (now < EM_BEACON_REPORT_MAX_AGE_MS) {
+        return 0;
+    }
+
+    pthread_rwlock_wrlock(&m_lock);
+
+    for (auto it = m_stas.begin(); it != m_stas.end();) {
+        s = &it->second;
+        i = 0;
+        while (i < s->num) {
+            if (s->entries[i].time_ms + EM_BEACON_REPORT_MAX_AGE_MS <= now) {
+                s->entries[i] = s->entries[s->num - 1];
+                s->num--;
+                removed++;
+            } else {
+                i++;
+            }
+        }
+        if ((s->num == 0) && (s->last_ms + EM_BEACON_REPORT_MAX_AGE_MS <= now)) {
+            it = m_stas.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    pthread_rwlock_unlock(&m_lock);
+
+    return removed;
+}
+
+bool em_beacon_report_cache_t::remove(const unsigned char *sta)
+{
+    bool found;
+
+    pthread_rwlock_wrlock(&m_lock);
+    found = (m_stas.erase(sta_key(sta)) != 0);
+    pthread_rwlock_unlock(&m_lock);
+
+    return found;
+}
+
+unsigned int em_beacon_report_cache_t::count()
+{
+    unsigned int num;
+
+    pthread_rwlock_rdlock(&m_lock);
+    num = static_cast<unsigned int>(m_stas.size());
+    pthread_rwlock_unlock(&m_lock);
+
+    return num;
+}
+
+em_beacon_report_cache_t::em_beacon_report_cache_t()
+{
+    pthread_rwlock_init(&m_lock, NULL);
+}
+
+em_beacon_report_cache_t::~em_beacon_report_cache_t()
+{
+    pthread_rwlock_destroy(&m_lock);
+}
@@ -0,0 +1,336 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "em_bh_steer.h"
+
+static const mac_address_t s_zero_mac = {0};
+
+unsigned long long em_bh_steer_t::al_key(const unsigned char *al_mac)
+{
+    unsigned long long key = 0;
+
+    memcpy(&key, al_mac, sizeof(mac_address_t));
+
+    return key;
+}
+
+unsigned int em_bh_steer_t::hops(const em_bh_steer_node_t *nodes, const unsigned int *parent, unsigned int num, unsigned int node)
+{
+    unsigned int num_hops = 0;
+
+    // a wired agent ends the walk, a loop of stale entries is cut at num hops
+    while ((node < num) && (memcmp(nodes[node].bsta, s_zero_mac, sizeof(mac_address_t)) != 0) && (num_hops <= num)) {
+        num_hops++;
+        node = parent[node];
+    }
+
+    return num_hops;
+}
+
+bool em_bh_steer_t::in_subtree(const unsigned int *parent, unsigned int num, unsigned int node, unsigned int root)
+{
+    unsigned int i;
+
+    for (i = 0; (node < num) && (i <= num); i++) {
+        if (node == root) {
+            return true;
+        }
+        node = parent[node];
+    }
+
+    return false;
+}
+
+unsigned int em_bh_steer_t::evaluate(unsigned long long now, const em_bh_steer_node_t *nodes, unsigned int num_nodes,
+                                     const em_bh_steer_bss_t *bss, unsigned int num_bss, em_beacon_report_cache_t *meas,
+                                     em_bh_steer_decision_t *decisions, unsigned int max)
+{
+    unsigned int parent[EM_BH_STEER_MAX_NODES], owner[EM_BH_STEER_MAX_BSS];
+    em_beacon_report_entry_t entries[EM_BEACON_REPORT_MAX_PER_STA];
+    const em_beacon_report_entry_t *target;
+    unsigned int i, j, k, num_entries, depth, target_depth = 0, cand_depth, target_bss = 0, num = 0;
+    em_bh_steer_decision_t *d;
+    bool weak, fresh;
+
+    if (num_nodes > EM_BH_STEER_MAX_NODES) {
+        num_nodes = EM_BH_STEER_MAX_NODES;
+    }
+    if (num_bss > EM_BH_STEER_MAX_BSS) {
+        num_bss = EM_BH_STEER_MAX_BSS;
+    }
+
+    pthread_mutex_lock(&m_lock);
+
+    if (m_params.enabled == false) {
+        pthread_mutex_unlock(&m_lock);
+        return 0;
+    }
+    m_stats.passes++;
+
+    // the tree: the agent of each backhaul BSS, and the parent of each agent
+    for (j = 0; j < num_bss; j++) {
+        for (owner[j] = 0; owner[j] < num_nodes; owner[j]++) {
+            if (memcmp(nodes[owner[j]].al_mac, bss[j].al_mac, sizeof(mac_address_t)) == 0) {
+                break;
+            }
+        }
+    }
+    for (i = 0; i < num_nodes; i++) {
+        parent[i] = num_nodes;
+        for (j = 0; j < num_bss; j++) {
+            if (memcmp(nodes[i].bssid, bss[j].bssid, sizeof(bssid_t)) == 0) {
+                parent[i] = owner[j];
+                break;
+            }
+        }
+    }
+
+    for (i = 0; (i < num_nodes) && (num < max); i++) {
+        if (memcmp(nodes[i].bsta, s_zero_mac, sizeof(mac_address_t)) == 0) {
+            continue;
+        }
+        auto it = m_agents.find(al_key(nodes[i].al_mac));
+        if ((it != m_agents.end()) && ((it->second.pending == true) || (it->second.backoff_until > now))) {
+            continue;
+        }
+
+        depth = hops(nodes, parent, num_nodes, i);
+        weak = (nodes[i].rcpi != 0) && (nodes[i].rcpi < m_params.rcpi_thresh);
+
+        // the strongest fresh parent closer to the controller, else as close and better by the hysteresis
+        target = NULL;
+        fresh = false;
+        num_entries = meas->get_reports(nodes[i].bsta, entries, EM_BEACON_REPORT_MAX_PER_STA);
+        for (k = 0; k < num_entries; k++) {
+            if (entries[k].time_ms + m_params.fresh_ms <= now) {
+                continue;
+            }
+            fresh = true;
+            if ((entries[k].rcpi < m_params.min_rcpi) || (memcmp(entries[k].bssid, nodes[i].bssid, sizeof(bssid_t)) == 0)) {
+                continue;
+            }
+            for (j = 0; j < num_bss; j++) {
+                if (memcmp(entries[k].bssid, bss[j].bssid, sizeof(bssid_t)) == 0) {
+                    break;
+                }
+            }
+            // not a backhaul BSS, or one of the agent's own subtree, the agent would cut itself off
+            if ((j == num_bss) || in_subtree(parent, num_nodes, owner[j], i)) {
+                continue;
+            }
+            cand_depth = hops(nodes, parent, num_nodes, owner[j]) + 1;
+            if ((cand_depth > depth) || ((cand_depth == depth) &&
+                    ((weak == false) || (entries[k].rcpi < static_cast<unsigned int> (nodes[i].rcpi) + m_params.rcpi_hysteresis)))) {
+                continue;
+            }
+            if ((target == NULL) || (cand_depth < target_depth) || ((cand_depth == target_depth) && (entries[k].rcpi > target->rcpi))) {
+                target = &entries[k];
+                target_depth = cand_depth;
+                target_bss = j;
+            }
+        }
+
+        d = &decisions[num];
+        memset(d, 0, sizeof(em_bh_steer_decision_t));
+        memcpy(d->al_mac, nodes[i].al_mac, sizeof(mac_address_t));
+        memcpy(d->bsta, nodes[i].bsta, sizeof(mac_address_t));
+        memcpy(d->source, nodes[i].bssid, sizeof(bssid_t));
+        d->rcpi = nodes[i].rcpi;
+        d->hops = depth;
+
+        // only a weak agent or one that could get closer is worth measuring
+        if (fresh == false) {
+            if ((weak == true) || (depth > 1)) {
+                d->action = em_bh_steer_action_measure;
+                m_stats.measures++;
+                num++;
+            }
+            continue;
+        }
+        if (target == NULL) {
+            continue;
+        }
+
+        d->action = em_bh_steer_action_steer;
+        memcpy(d->target, target->bssid, sizeof(bssid_t));
+        d->op_class = bss[target_bss].op_class;
+        d->channel = bss[target_bss].channel;
+        d->target_rcpi = target->rcpi;
+        d->target_hops = target_depth;
+        num++;
+    }
+
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+void em_bh_steer_t::started(const unsigned char *al_mac, unsigned long long now)
+{
+    em_bh_steer_agent_t *agent;
+
+    pthread_mutex_lock(&m_lock);
+    agent = &m_agents[al_key(al_mac)];
+    agent->pending = true;
+    agent->start_ms = now;
+    agent->backoff_until = now + m_params.timeout_ms + m_params.backoff_ms;
+    agent->stats.steers++;
+    m_stats.steers++;
+    pthread_mutex_unlock(&m_lock);
+}
+
+bool em_bh_steer_t::completed(const unsigned char *al_mac, bool success, unsigned long long now, unsigned long long *latency_ms)
+{
+    em_bh_steer_agent_t *agent;
+    unsigned long long latency;
+
+    pthread_mutex_lock(&m_lock);
+
+    auto it = m_agents.find(al_key(al_mac));
+    if ((it == m_agents.end()) || (it->second.pending == false)) {
+        pthread_mutex_unlock(&m_lock);
+        return false;
+    }
+    agent = &it->second;
+    agent->pending = false;
+    agent->backoff_until = now + m_params.backoff_ms;
+    latency = (now > agent->start_ms) ? (now - agent->start_ms):0;
+
+    if (success == true) {
+        agent->stats.completed++;
+        agent->stats.last_latency_ms = latency;
+        agent->stats.total_latency_ms += latency;
+        if (latency > agent->stats.max_latency_ms) {
+            agent->stats.max_latency_ms = latency;
+        }
+        m_stats.completed++;
+        if (latency > m_stats.max_latency_ms) {
+            m_stats.max_latency_ms = latency;
+        }
+    } else {
+        agent->stats.failed++;
+        m_stats.failed++;
+    }
+
+    pthread_mutex_unlock(&m_lock);
+
+    if (latency_ms != NULL) {
+        *latency_ms = latency;
+    }
+
+    return true;
+}
+
+unsigned int em_bh_steer_t::expire(unsigned long long now)
+{
+    unsigned int num = 0;
+
+    pthread_mutex_lock(&m_lock);
+
+    for (auto it = m_agents.begin(); it != m_agents.end(); ++it) {
+        if ((it->second.pending == true) && (it->second.start_ms + m_params.timeout_ms <= now)) {
+            it->second.pending = false;
+            it->second.backoff_until = now + m_params.backoff_ms;
+            it->second.stats.timeouts++;
+            m_stats.timeouts++;
+            num++;
+        }
+    }
+
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+bool em_bh_steer_t::is_pending(const unsigned char *al_mac)
+{
+    bool pending;
+
+    pthread_mutex_lock(&m_lock);
+    auto it = m_agents.find(al_key(al_mac));
+    pending = (it != m_agents.end()) && (it->second.pending == true);
+    pthread_mutex_unlock(&m_lock);
+
+    return pending;
+}
+
+bool em_bh_steer_t::get_agent_stats(const unsigned char *al_mac, em_bh_steer_agent_stats_t *stats)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&m_lock);
+    auto it = m_agents.find(al_key(al_mac));
+    if (it != m_agents.end()) {
+        *stats = it->second.stats;
+        found = true;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return found;
+}
+
+void em_bh_steer_t::set_params(const em_bh_steer_params_t *params)
+{
+    pthread_mutex_lock(&m_lock);
+    m_params = *params;
+    pthread_mutex_unlock(&m_lock);
+}
+
+em_bh_steer_params_t em_bh_steer_t::get_params()
+{
+    em_bh_steer_params_t params;
+
+    pthread_mutex_lock(&m_lock);
+    params = m_params;
+    pthread_mutex_unlock(&m_lock);
+
+    return params;
+}
+
+em_bh_steer_stats_t em_bh_steer_t::get_stats()
+{
+    em_bh_steer_stats_t stats;
+
+    pthread_mutex_lock(&m_lock);
+    stats = m_stats;
+    pthread_mutex_unlock(&m_lock);
+
+    return stats;
+}
+
+em_bh_steer_t::em_bh_steer_t() : m_lock(), m_params(), m_stats(), m_agents()
+{
+    pthread_mutex_init(&m_lock, NULL);
+    memset(&m_params, 0, sizeof(m_params));
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    m_params.enabled = true;
+    m_params.rcpi_thresh = 80;          // -70 dBm
+    m_params.min_rcpi = 90;             // -65 dBm
+    m_params.rcpi_hysteresis = 12;      // 6 dB
+    m_params.fresh_ms = 30000;
+    m_params.timeout_ms = 15000;
+    m_params.backoff_ms = 300000;
+}
+
+em_bh_steer_t::~em_bh_steer_t()
+{
+    pthread_mutex_destroy(&m_lock);
+}
@@ -0,0 +1,215 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "em_blocklist.h"
+
+em_blocklist_key_t em_blocklist_t::make_key(const unsigned char *sta, const unsigned char *bssid)
+{
+    em_blocklist_key_t key = {0, 0};
+
+    memcpy(&key.sta, sta, sizeof(mac_address_t));
+    memcpy(&key.bssid, bssid, sizeof(bssid_t));
+
+    return key;
+}
+
+void em_blocklist_t::bloom_slots(const em_blocklist_key_t& key, unsigned int slots[EM_BLOCKLIST_BLOOM_HASHES])
+{
+    unsigned long long h = key.sta * 0x9e3779b97f4a7c15ULL ^ key.bssid;
+    unsigned long long h2;
+    unsigned int i;
+
+    // splitmix64 finalizer, then double hashing for the other slots
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    h2 = (h >> 32) | 1;
+
+    for (i = 0; i < EM_BLOCKLIST_BLOOM_HASHES; i++) {
+        slots[i] = static_cast<unsigned int>((h + i * h2) & (EM_BLOCKLIST_BLOOM_SLOTS - 1));
+    }
+}
+
+void em_blocklist_t::bloom_update(const em_blocklist_key_t& key, bool add)
+{
+    unsigned int slots[EM_BLOCKLIST_BLOOM_HASHES], i;
+
+    bloom_slots(key, slots);
+    for (i = 0; i < EM_BLOCKLIST_BLOOM_HASHES; i++) {
+        // a saturated counter stays set, which only costs a false positive
+        if (m_bloom[slots[i]] == 0xff) {
+            continue;
+        }
+        if (add == true) {
+            m_bloom[slots[i]]++;
+        } else if (m_bloom[slots[i]] != 0) {
+            m_bloom[slots[i]]--;
+        }
+    }
+}
+
+void em_blocklist_t::expire_cb(void *arg)
+{
+    em_blocklist_entry_t *entry = static_cast<em_blocklist_entry_t *>(arg);
+
+    // the wheel still uses the timer after the callback, the entry is removed by expire()
+    entry->owner->m_expired.push_back(entry->key);
+}
+
+int em_blocklist_t::block(const unsigned char *sta, const unsigned char *bssid, unsigned int ttl_ms, unsigned long long now)
+{
+    em_blocklist_key_t key = make_key(sta, bssid);
+    em_blocklist_entry_t *entry;
+
+    pthread_mutex_lock(&m_lock);
+
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        if (m_entries.size() >= EM_BLOCKLIST_MAX) {
+            pthread_mutex_unlock(&m_lock);
+            return -1;
+        }
+        it = m_entries.emplace(key, em_blocklist_entry_t()).first;
+        entry = &it->second;
+        entry->key = key;
+        entry->owner = this;
+        em_timer_wheel_t::init_timer(&entry->timer);
+        bloom_update(key, true);
+    }
+    entry = &it->second;
+
+    if (ttl_ms == 0) {
+        m_timers.cancel(&entry->timer);
+        entry->expires_ms = 0;
+    } else {
+        m_timers.add(&entry->timer, now, ttl_ms, 0, expire_cb, entry);
+        entry->expires_ms = now + ttl_ms;
+    }
+    m_stats.blocks++;
+
+    pthread_mutex_unlock(&m_lock);
+
+    return 0;
+}
+
+bool em_blocklist_t::unblock(const unsigned char *sta, const unsigned char *bssid)
+{
+    em_blocklist_key_t key = make_key(sta, bssid);
+
+    pthread_mutex_lock(&m_lock);
+
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        pthread_mutex_unlock(&m_lock);
+        return false;
+    }
+    m_timers.cancel(&it->second.timer);
+    bloom_update(key, false);
+    m_entries.erase(it);
+    m_stats.unblocks++;
+
+    pthread_mutex_unlock(&m_lock);
+
+    return true;
+}
+
+bool em_blocklist_t::is_blocked(const unsigned char *sta, const unsigned char *bssid)
+{
+    em_blocklist_key_t key = make_key(sta, bssid);
+    unsigned int slots[EM_BLOCKLIST_BLOOM_HASHES], i;
+    bool blocked;
+
+    bloom_slots(key, slots);
+
+    pthread_mutex_lock(&m_lock);
+
+    m_stats.lookups++;
+    for (i = 0; i < EM_BLOCKLIST_BLOOM_HASHES; i++) {
+        if (m_bloom[slots[i]] == 0) {
+            m_stats.bloom_rejects++;
+            pthread_mutex_unlock(&m_lock);
+            return false;
+        }
+    }
+    blocked = (m_entries.find(key) != m_entries.end());
+    if (blocked == true) {
+        m_stats.hits++;
+    }
+
+    pthread_mutex_unlock(&m_lock);
+
+    return blocked;
+}
+
+unsigned int em_blocklist_t::expire(unsigned long long now)
+{
+    unsigned int num = 0;
+
+    pthread_mutex_lock(&m_lock);
+
+    m_timers.run(now);
+    for (auto& key : m_expired) {
+        auto it = m_entries.find(key);
+        if (it == m_entries.end()) {
+            continue;
+        }
+        bloom_update(key, false);
+        m_entries.erase(it);
+        num++;
+    }
+    m_expired.clear();
+    m_stats.expired += num;
+
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+unsigned int em_blocklist_t::count()
+{
+    unsigned int num;
+
+    pthread_mutex_lock(&m_lock);
+    num = static_cast<unsigned int>(m_entries.size());
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+void em_blocklist_t::get_stats(em_blocklist_stats_t *stats)
+{
+    pthread_mutex_lock(&m_lock);
+    *stats = m_stats;
+    stats->entries = static_cast<unsigned int>(m_entries.size());
+    pthread_mutex_unlock(&m_lock);
+}
+
+em_blocklist_t::em_blocklist_t()
+{
+    pthread_mutex_init(&m_lock, NULL);
+    memset(m_bloom, 0, sizeof(m_bloom));
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+em_blocklist_t::~em_blocklist_t()
+{
+    pthread_mutex_destroy(&m_lock);
+}
@@ -0,0 +1,377 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <new>
+#include "em_bus_dispatch.h"
+#include "em_lat_hist.h"
+#include "em_stack.h"
+#include "em_sched.h"
+
+static const char *s_policy_str[] = {
+    "DropOldest",
+    "DropNewest",
+    "Coalesce",
+};
+
+em_bus_buf_t *em_bus_buf_t::create(const void *data, unsigned int len)
+{
+    em_bus_buf_t *buf;
+    void *mem;
+
+    if ((mem = malloc(sizeof(em_bus_buf_t) + len + 1)) == NULL) {
+        return NULL;
+    }
+    buf = new (mem) em_bus_buf_t();
+    buf->m_len = len;
+    if (len != 0) {
+        memcpy(buf->get_data(), data, len);
+    }
+    buf->get_data()[len] = '\0';
+
+    return buf;
+}
+
+void em_bus_buf_t::release()
+{
+    if (m_ref.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        this->~em_bus_buf_t();
+        free(this);
+    }
+}
+
+int em_bus_dispatch_t::add_channel(const char *name, em_bus_dispatch_policy_t policy, unsigned int max_depth,
+        em_bus_dispatch_handler_t handler, em_bus_dispatch_key_func_t key_func, void *arg)
+{
+    em_bus_dispatch_channel_t *ch;
+    int channel;
+
+    pthread_mutex_lock(&m_lock);
+    if ((m_num_channels >= EM_BUS_DISPATCH_MAX_CHANNELS) || (m_running == true) || (handler == NULL)) {
+        pthread_mutex_unlock(&m_lock);
+        return -1;
+    }
+    channel = static_cast<int>(m_num_channels++);
+    ch = &m_channels[channel];
+    snprintf(ch->name, sizeof(ch->name), "%s", name);
+    ch->policy = policy;
+    ch->max_depth = (max_depth == 0) ? 1:max_depth;
+    ch->handler = handler;
+    ch->key_func = key_func;
+    ch->arg = arg;
+    ch->queue.clear();
+    memset(&ch->stats, 0, sizeof(em_bus_dispatch_stats_t));
+    pthread_mutex_unlock(&m_lock);
+
+    return channel;
+}
+
+int em_bus_dispatch_t::pop(em_bus_dispatch_entry_t *entry)
+{
+    em_bus_dispatch_channel_t *ch;
+    unsigned int i;
+    int first = -1;
+
+    for (i = 0; i < m_num_channels; i++) {
+        if ((m_channels[i].queue.empty() == false) &&
+                ((first < 0) || (m_channels[i].queue.front().seq < m_channels[first].queue.front().seq))) {
+            first = static_cast<int>(i);
+        }
+    }
+    if (first < 0) {
+        return -1;
+    }
+
+    ch = &m_channels[first];
+    *entry = ch->queue.front();
+    ch->queue.pop_front();
+    ch->stats.bytes -= entry->buf->get_len();
+    ch->stats.depth = static_cast<unsigned int>(ch->queue.size());
+
+    return first;
+}
+
+void *em_bus_dispatch_t::run(void *arg)
+{
+    em_bus_dispatch_t *disp = static_cast<em_bus_dispatch_t *>(arg);
+    em_bus_dispatch_channel_t *ch;
+    em_bus_dispatch_entry_t entry;
+    uint64_t wait_us;
+    int channel, slot;
+
+    slot = em_stack_t::enter(em_stack_role_listener, "bus-dispatch");
+    em_sched_t::apply(em_stack_role_listener, "bus-dispatch");
+
+    pthread_mutex_lock(&disp->m_lock);
+    while (true) {
+        while ((disp->m_stop == false) && ((channel = disp->pop(&entry)) < 0)) {
+            pthread_cond_wait(&disp->m_cond, &disp->m_lock);
+        }
+        if (disp->m_stop == true) {
+            break;
+        }
+        ch = &disp->m_channels[channel];
+        pthread_mutex_unlock(&disp->m_lock);
+
+        wait_us = em_lat_hist_t::get_time_us() - entry.posted_us;
+        ch->handler(entry.buf->get_data(), entry.buf->get_len(), ch->arg);
+        entry.buf->release();
+
+        pthread_mutex_lock(&disp->m_lock);
+        ch->stats.dispatched++;
+        if (wait_us > ch->stats.max_wait_us) {
+            ch->stats.max_wait_us = wait_us;
+        }
+    }
+    pthread_mutex_unlock(&disp->m_lock);
+
+    em_stack_t::leave(slot);
+
+    return NULL;
+}
+
+int em_bus_dispatch_t::start()
+{
+    pthread_attr_t attr;
+    int ret;
+
+    pthread_mutex_lock(&m_lock);
+    if (m_running == true) {
+        pthread_mutex_unlock(&m_lock);
+        return 0;
+    }
+    m_stop = false;
+
+    pthread_attr_init(&attr);
+    em_stack_t::set_attr(&attr, em_stack_role_listener);
+    ret = pthread_create(&m_thread, &attr, run, this);
+    pthread_attr_destroy(&attr);
+    if (ret != 0) {
+        pthread_mutex_unlock(&m_lock);
+        printf("%s:%d: Failed to start the bus dispatch thread, callbacks are handled on the bus thread\n",
+                __func__, __LINE__);
+        return -1;
+    }
+    m_running = true;
+    pthread_mutex_unlock(&m_lock);
+
+    return 0;
+}
+
+void em_bus_dispatch_t::stop()
+{
+    em_bus_dispatch_channel_t *ch;
+    unsigned int i;
+
+    pthread_mutex_lock(&m_lock);
+    if (m_running == false) {
+        pthread_mutex_unlock(&m_lock);
+        return;
+    }
+    m_stop = true;
+    pthread_cond_signal(&m_cond);
+    pthread_mutex_unlock(&m_lock);
+
+    pthread_join(m_thread, NULL);
+
+    pthread_mutex_lock(&m_lock);
+    m_running = false;
+    for (i = 0; i < m_num_channels; i++) {
+        ch = &m_channels[i];
+        while (ch->queue.empty() == false) {
+            ch->queue.front().buf->release();
+            ch->queue.pop_front();
+            ch->stats.dropped++;
+        }
+        ch->stats.bytes = 0;
+        ch->stats.depth = 0;
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+bool em_bus_dispatch_t::post(int channel, em_bus_buf_t *buf)
+{
+    em_bus_dispatch_channel_t *ch;
+    em_bus_dispatch_entry_t entry;
+    std::deque<em_bus_dispatch_entry_t>::iterator it;
+    em_bus_buf_t *replaced = NULL, *dropped = NULL;
+
+    if ((channel < 0) || (static_cast<unsigned int>(channel) >= m_num_channels) || (buf == NULL)) {
+        return false;
+    }
+    ch = &m_channels[channel];
+
+    // the key is looked up before the lock, the dispatch thread is not held up by it
+    entry.buf = buf;
+    entry.has_key = false;
+    entry.key[0] = '\0';
+    if (ch->policy == em_bus_dispatch_policy_coalesce) {
+        entry.has_key = (ch->key_func == NULL) ? true:ch->key_func(buf->get_data(), buf->get_len(), entry.key, sizeof(entry.key));
+    }
+
+    pthread_mutex_lock(&m_lock);
+    ch->stats.posted++;
+    if (m_running == false) {
+        ch->stats.dispatched++;
+        pthread_mutex_unlock(&m_lock);
+        ch->handler(buf->get_data(), buf->get_len(), ch->arg);
+        return true;
+    }
+
+    if (entry.has_key == true) {
+        for (it = ch->queue.begin(); it != ch->queue.end(); it++) {
+            if ((it->has_key == true) && (strcmp(it->key, entry.key) == 0)) {
+                replaced = it->buf;
+                ch->stats.bytes -= replaced->get_len();
+                ch->stats.coalesced++;
+                ch->queue.erase(it);
+                break;
+            }
+        }
+    }
+
+    if (ch->queue.size() >= ch->max_depth) {
+        if (ch->policy == em_bus_dispatch_policy_drop_newest) {
+            ch->stats.dropped++;
+            pthread_mutex_unlock(&m_lock);
+            return false;
+        }
+        dropped = ch->queue.front().buf;
+        ch->stats.bytes -= dropped->get_len();
+        ch->stats.dropped++;
+        ch->queue.pop_front();
+    }
+
+    buf->hold();
+    entry.seq = m_seq++;
+    entry.posted_us = em_lat_hist_t::get_time_us();
+    ch->queue.push_back(entry);
+    ch->stats.bytes += buf->get_len();
+    ch->stats.depth = static_cast<unsigned int>(ch->queue.size());
+    if (ch->stats.depth > ch->stats.max_depth) {
+        ch->stats.max_depth = ch->stats.depth;
+    }
+    pthread_cond_signal(&m_cond);
+    pthread_mutex_unlock(&m_lock);
+
+    // freed out of the lock, a payload can be a few hundred KB
+    if (replaced != NULL) {
+        replaced->release();
+    }
+    if (dropped != NULL) {
+        dropped->release();
+    }
+
+    return true;
+}
+
+bool em_bus_dispatch_t::post(int channel, const void *data, unsigned int len)
+{
+    em_bus_buf_t *buf;
+    bool ret;
+
+    if ((buf = em_bus_buf_t::create(data, len)) == NULL) {
+        printf("%s:%d: Failed to allocate %u bytes\n", __func__, __LINE__, len);
+        return false;
+    }
+    ret = post(channel, buf);
+    buf->release();
+
+    return ret;
+}
+
+void em_bus_dispatch_t::get_stats(int channel, em_bus_dispatch_stats_t *stats)
+{
+    pthread_mutex_lock(&m_lock);
+    if ((channel >= 0) && (static_cast<unsigned int>(channel) < m_num_channels)) {
+        *stats = m_channels[channel].stats;
+    } else {
+        memset(stats, 0, sizeof(em_bus_dispatch_stats_t));
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+unsigned long long em_bus_dispatch_t::get_lost()
+{
+    unsigned long long lost = 0;
+    unsigned int i;
+
+    pthread_mutex_lock(&m_lock);
+    for (i = 0; i < m_num_channels; i++) {
+        lost += m_channels[i].stats.dropped + m_channels[i].stats.coalesced;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return lost;
+}
+
+void em_bus_dispatch_t::encode(cJSON *obj)
+{
+    em_bus_dispatch_channel_t *ch;
+    cJSON *arr, *item;
+    unsigned int i;
+
+    arr = cJSON_AddArrayToObject(obj, "Channels");
+    pthread_mutex_lock(&m_lock);
+    for (i = 0; i < m_num_channels; i++) {
+        ch = &m_channels[i];
+        item = cJSON_CreateObject();
+        cJSON_AddStringToObject(item, "Name", ch->name);
+        cJSON_AddStringToObject(item, "Policy", s_policy_str[ch->policy]);
+        cJSON_AddNumberToObject(item, "Posted", static_cast<double>(ch->stats.posted));
+        cJSON_AddNumberToObject(item, "Dispatched", static_cast<double>(ch->stats.dispatched));
+        cJSON_AddNumberToObject(item, "Dropped", static_cast<double>(ch->stats.dropped));
+        cJSON_AddNumberToObject(item, "Coalesced", static_cast<double>(ch->stats.coalesced));
+        cJSON_AddNumberToObject(item, "Depth", ch->stats.depth);
+        cJSON_AddNumberToObject(item, "MaxDepth", ch->stats.max_depth);
+        cJSON_AddNumberToObject(item, "Bytes", static_cast<double>(ch->stats.bytes));
+        cJSON_AddNumberToObject(item, "MaxWaitUs", static_cast<double>(ch->stats.max_wait_us));
+        cJSON_AddItemToArray(arr, item);
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+void em_bus_dispatch_t::print_stats()
+{
+    em_bus_dispatch_channel_t *ch;
+    unsigned int i;
+
+    pthread_mutex_lock(&m_lock);
+    for (i = 0; i < m_num_channels; i++) {
+        ch = &m_channels[i];
+        printf("%s:%d: Bus %s posted:%llu dispatched:%llu dropped:%llu coalesced:%llu depth:%u max:%u/%u max_wait:%lluus\n",
+                __func__, __LINE__, ch->name, ch->stats.posted, ch->stats.dispatched, ch->stats.dropped,
+                ch->stats.coalesced, ch->stats.depth, ch->stats.max_depth, ch->max_depth, ch->stats.max_wait_us);
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+em_bus_dispatch_t::em_bus_dispatch_t() : m_thread(), m_running(false), m_stop(false), m_seq(0), m_num_channels(0)
+{
+    pthread_mutex_init(&m_lock, NULL);
+    pthread_cond_init(&m_cond, NULL);
+}
+
+em_bus_dispatch_t::~em_bus_dispatch_t()
+{
+    stop();
+    pthread_cond_destroy(&m_cond);
+    pthread_mutex_destroy(&m_lock);
+}
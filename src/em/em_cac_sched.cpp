@@ -0,0 +1,372 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <arpa/inet.h>
+#include "em_cac_sched.h"
+
+#define EM_CAC_SCHED_DFS_LOW        52      // first and last 20 MHz DFS channels of 5 GHz
+#define EM_CAC_SCHED_DFS_HIGH       144
+#define EM_CAC_SCHED_WEATHER_LOW    120
+#define EM_CAC_SCHED_WEATHER_HIGH   128
+
+void em_cac_sched_t::get_span(unsigned char op_class, unsigned char channel, unsigned char *low, unsigned char *high)
+{
+    int offset_low = 0, offset_high = 0;
+
+    switch (op_class) {
+        // 40 MHz, secondary channel above or below the primary
+        case 116: case 119: case 122: case 126:
+            offset_high = 4;
+            break;
+
+        case 117: case 120: case 123: case 127:
+            offset_low = 4;
+            break;
+
+        // 80 and 160 MHz, channel is the center
+        case 128: case 130:
+            offset_low = offset_high = 6;
+            break;
+
+        case 129:
+            offset_low = offset_high = 14;
+            break;
+
+        default:
+            break;
+    }
+
+    *low = static_cast<unsigned char> ((channel > offset_low) ? channel - offset_low:0);
+    *high = static_cast<unsigned char> (channel + offset_high);
+}
+
+bool em_cac_sched_t::is_dfs(unsigned char op_class, unsigned char channel)
+{
+    unsigned char low, high;
+
+    // the 5 GHz operating classes, 2.4 and 6 GHz have no DFS channel
+    if ((op_class < 115) || (op_class > 130)) {
+        return false;
+    }
+    get_span(op_class, channel, &low, &high);
+
+    return (high >= EM_CAC_SCHED_DFS_LOW) && (low <= EM_CAC_SCHED_DFS_HIGH);
+}
+
+unsigned int em_cac_sched_t::get_cac_ms(unsigned char op_class, unsigned char channel)
+{
+    unsigned char low, high;
+
+    if (is_dfs(op_class, channel) == false) {
+        return 0;
+    }
+    get_span(op_class, channel, &low, &high);
+
+    return ((high >= EM_CAC_SCHED_WEATHER_LOW) && (low <= EM_CAC_SCHED_WEATHER_HIGH)) ?
+        EM_CAC_SCHED_WEATHER_CAC_MS:EM_CAC_SCHED_CAC_MS;
+}
+
+em_cac_sched_agent_t *em_cac_sched_t::get_agent(em_packed_mac_t agent)
+{
+    auto it = m_agents.find(agent);
+
+    if (it == m_agents.end()) {
+        it = m_agents.emplace(agent, em_cac_sched_agent_t()).first;
+        it->second.group = agent;
+    }
+
+    return &it->second;
+}
+
+void em_cac_sched_t::expire(unsigned long long now)
+{
+    em_cac_sched_radio_t *r;
+
+    for (auto it = m_radios.begin(); it != m_radios.end();) {
+        r = &it->second;
+        if ((r->end_ms != 0) && (r->end_ms <= now)) {
+            // no CAC Completion Report, the slot is given back all the same
+            r->end_ms = 0;
+            m_stats.timed_out++;
+        }
+        if ((r->queued_ms != 0) && (r->asked_ms + EM_CAC_SCHED_STALE_MS <= now)) {
+            r->queued_ms = 0;
+        }
+        if ((r->end_ms == 0) && (r->queued_ms == 0)) {
+            it = m_radios.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+bool em_cac_sched_t::release(em_packed_mac_t ruid)
+{
+    auto it = m_radios.find(ruid);
+
+    if ((it == m_radios.end()) || (it->second.end_ms == 0)) {
+        return false;
+    }
+    it->second.end_ms = 0;
+    if (it->second.queued_ms == 0) {
+        m_radios.erase(it);
+    }
+
+    return true;
+}
+
+void em_cac_sched_t::set_group(const unsigned char *agent, const unsigned char *group)
+{
+    pthread_mutex_lock(&m_lock);
+    get_agent(em_hex::pack_mac(agent))->group = em_hex::pack_mac(group);
+    pthread_mutex_unlock(&m_lock);
+}
+
+int em_cac_sched_t::handle_status_report(const unsigned char *agent, const unsigned char *value, unsigned int len, unsigned long long now)
+{
+    const em_cac_avail_t *avail;
+    const em_cac_non_occ_t *non_occ;
+    const em_cac_active_t *active;
+    unsigned int avail_num, non_occ_num, active_num, off, i;
+    unsigned long long age_ms, countdown;
+    em_cac_sched_agent_t *a;
+    int num = 0;
+
+    // three lists, each a count and its entries
+    if (len < sizeof(unsigned char)) {
+        return -1;
+    }
+    avail_num = value[0];
+    off = sizeof(unsigned char) + avail_num * sizeof(em_cac_avail_t);
+    if (len < off + sizeof(unsigned char)) {
+        return -1;
+    }
+    non_occ_num = value[off];
+    off += sizeof(unsigned char) + non_occ_num * sizeof(em_cac_non_occ_t);
+    if (len < off + sizeof(unsigned char)) {
+        return -1;
+    }
+    active_num = value[off];
+    if (len < off + sizeof(unsigned char) + active_num * sizeof(em_cac_active_t)) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&m_lock);
+    a = get_agent(em_hex::pack_mac(agent));
+    a->channels.clear();
+
+    avail = reinterpret_cast<const em_cac_avail_t *> (value + sizeof(unsigned char));
+    for (i = 0; i < avail_num; i++, num++) {
+        age_ms = static_cast<unsigned long long> (ntohs(avail[i].mins_since_cac_comp)) * 60000;
+        a->channels[channel_key(avail[i].op_class, avail[i].channel)] = {em_cac_state_available, (now > age_ms) ? now - age_ms:0};
+    }
+
+    off = sizeof(unsigned char) + avail_num * sizeof(em_cac_avail_t);
+    non_occ = reinterpret_cast<const em_cac_non_occ_t *> (value + off + sizeof(unsigned char));
+    for (i = 0; i < non_occ_num; i++, num++) {
+        a->channels[channel_key(non_occ[i].op_class, non_occ[i].channel)] = {em_cac_state_non_occupied,
+            now + static_cast<unsigned long long> (ntohs(non_occ[i].sec_remain_non_occ_dur)) * 1000};
+    }
+
+    off += sizeof(unsigned char) + non_occ_num * sizeof(em_cac_non_occ_t);
+    active = reinterpret_cast<const em_cac_active_t *> (value + off + sizeof(unsigned char));
+    for (i = 0; i < active_num; i++, num++) {
+        countdown = (static_cast<unsigned long long> (active[i].countdown_cac_comp[0]) << 16) |
+            (static_cast<unsigned long long> (active[i].countdown_cac_comp[1]) << 8) | active[i].countdown_cac_comp[2];
+        a->channels[channel_key(active[i].op_class, active[i].channel)] = {em_cac_state_active, now + countdown * 1000};
+    }
+    m_stats.status_reports++;
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+int em_cac_sched_t::handle_completion_report(const unsigned char *agent, const unsigned char *value, unsigned int len, unsigned long long now)
+{
+    const em_cac_comp_rprt_radio_t *radio;
+    unsigned int radios_num, off, end, i, j;
+    em_cac_sched_agent_t *a;
+
+    if (len < sizeof(unsigned char)) {
+        return -1;
+    }
+    radios_num = value[0];
+
+    // the radios are checked whole before any is taken
+    off = sizeof(unsigned char);
+    for (i = 0; i < radios_num; i++) {
+        if (len < off + sizeof(em_cac_comp_rprt_radio_t)) {
+            return -1;
+        }
+        radio = reinterpret_cast<const em_cac_comp_rprt_radio_t *> (value + off);
+        off += sizeof(em_cac_comp_rprt_radio_t) + radio->detected_pairs_num * sizeof(em_cac_comp_rprt_pair_t);
+        if (len < off) {
+            return -1;
+        }
+    }
+    end = off;
+
+    pthread_mutex_lock(&m_lock);
+    a = get_agent(em_hex::pack_mac(agent));
+    for (off = sizeof(unsigned char); off < end;
+            off += sizeof(em_cac_comp_rprt_radio_t) + radio->detected_pairs_num * sizeof(em_cac_comp_rprt_pair_t)) {
+        radio = reinterpret_cast<const em_cac_comp_rprt_radio_t *> (value + off);
+        // status 0 is a successful CAC, 1 a radar detection, the others a CAC that did not run
+        if (radio->status == 0) {
+            a->channels[channel_key(radio->op_class, radio->channel)] = {em_cac_state_available, now};
+        } else if (radio->status == 1) {
+            for (j = 0; j < radio->detected_pairs_num; j++) {
+                a->channels[channel_key(radio->detected_pairs[j].op_class, radio->detected_pairs[j].channel)] =
+                    {em_cac_state_non_occupied, now + EM_CAC_SCHED_NON_OCC_MS};
+                m_stats.radar++;
+            }
+        } else {
+            a->channels.erase(channel_key(radio->op_class, radio->channel));
+        }
+        if (release(em_hex::pack_mac(radio->ruid)) == true) {
+            m_stats.completed++;
+        }
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return static_cast<int> (radios_num);
+}
+
+em_cac_state_t em_cac_sched_t::get_state(const unsigned char *agent, unsigned char op_class, unsigned char channel, unsigned long long now)
+{
+    em_cac_state_t state = em_cac_state_unknown;
+
+    if (is_dfs(op_class, channel) == false) {
+        return em_cac_state_available;
+    }
+
+    pthread_mutex_lock(&m_lock);
+    auto it = m_agents.find(em_hex::pack_mac(agent));
+    if (it != m_agents.end()) {
+        auto ch = it->second.channels.find(channel_key(op_class, channel));
+        if (ch != it->second.channels.end()) {
+            state = ch->second.state;
+            // the non-occupancy period or the CAC is over, the channel needs a new CAC
+            if (((state == em_cac_state_non_occupied) || (state == em_cac_state_active)) && (ch->second.time_ms <= now)) {
+                state = em_cac_state_unknown;
+            }
+        }
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return state;
+}
+
+em_cac_admit_t em_cac_sched_t::admit(const unsigned char *agent, const unsigned char *ruid, unsigned int cac_ms, unsigned long long now)
+{
+    em_packed_mac_t key = em_hex::pack_mac(ruid), group;
+    unsigned int active = 0, in_group = 0;
+    em_cac_sched_radio_t *r;
+    em_cac_admit_t ret;
+    bool older = false;
+
+    pthread_mutex_lock(&m_lock);
+    expire(now);
+
+    group = get_agent(em_hex::pack_mac(agent))->group;
+    r = &m_radios[key];
+    r->agent = em_hex::pack_mac(agent);
+    if (r->end_ms != 0) {
+        pthread_mutex_unlock(&m_lock);
+        return em_cac_admit_started;
+    }
+    if (r->queued_ms == 0) {
+        r->queued_ms = now;
+    }
+    r->asked_ms = now;
+
+    for (auto& it : m_radios) {
+        if (get_agent(it.second.agent)->group != group) {
+            if (it.second.end_ms != 0) {
+                active++;
+            }
+            continue;
+        }
+        if (it.second.end_ms != 0) {
+            active++;
+            in_group++;
+        } else if ((it.first != key) && (it.second.queued_ms != 0) &&
+                ((it.second.queued_ms < r->queued_ms) || ((it.second.queued_ms == r->queued_ms) && (it.first < key)))) {
+            // the branch serves its radios in the order they asked
+            older = true;
+        }
+    }
+
+    if ((active < EM_CAC_SCHED_MAX_ACTIVE) && (in_group < EM_CAC_SCHED_MAX_PER_GROUP) && (older == false)) {
+        r->queued_ms = 0;
+        r->end_ms = now + cac_ms;
+        m_stats.started++;
+        ret = em_cac_admit_started;
+    } else if (now - r->queued_ms >= EM_CAC_SCHED_MAX_WAIT_MS) {
+        m_radios.erase(key);
+        m_stats.refused++;
+        ret = em_cac_admit_refused;
+    } else {
+        m_stats.waited++;
+        ret = em_cac_admit_wait;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return ret;
+}
+
+unsigned int em_cac_sched_t::get_active(unsigned long long now)
+{
+    unsigned int num = 0;
+
+    pthread_mutex_lock(&m_lock);
+    expire(now);
+    for (auto& it : m_radios) {
+        if (it.second.end_ms != 0) {
+            num++;
+        }
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+em_cac_sched_stats_t em_cac_sched_t::get_stats()
+{
+    em_cac_sched_stats_t stats;
+
+    pthread_mutex_lock(&m_lock);
+    stats = m_stats;
+    pthread_mutex_unlock(&m_lock);
+
+    return stats;
+}
+
+em_cac_sched_t::em_cac_sched_t()
+{
+    pthread_mutex_init(&m_lock, NULL);
+    memset(&m_stats, 0, sizeof(em_cac_sched_stats_t));
+}
+
+em_cac_sched_t::~em_cac_sched_t()
+{
+    pthread_mutex_destroy(&m_lock);
+}
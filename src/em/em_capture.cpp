@@ -0,0 +1,338 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "em_capture.h"
+
+#define EM_PCAPNG_PAD(len)  (((len) + 3U) & ~3U)
+
+std::atomic<FILE *> em_capture_t::s_fp(NULL);
+pthread_mutex_t em_capture_t::s_lock = PTHREAD_MUTEX_INITIALIZER;
+uint64_t em_capture_t::s_frames = 0;
+
+static const unsigned char s_pad[4] = {0};
+
+static void write_option(FILE *fp, uint16_t code, const void *val, uint16_t len)
+{
+    fwrite(&code, sizeof(code), 1, fp);
+    fwrite(&len, sizeof(len), 1, fp);
+    if (len != 0) {
+        fwrite(val, len, 1, fp);
+        fwrite(s_pad, EM_PCAPNG_PAD(len) - len, 1, fp);
+    }
+}
+
+int em_capture_t::write_shb_idb(FILE *fp, const char *ifname)
+{
+    // version 1.0, section length not known
+    uint32_t shb[7] = {EM_PCAPNG_BLOCK_SHB, sizeof(shb), EM_PCAPNG_BYTE_ORDER_MAGIC, 1, 0xffffffff, 0xffffffff, sizeof(shb)};
+    uint32_t type = EM_PCAPNG_BLOCK_IDB, len;
+    uint16_t linktype = EM_PCAPNG_LINKTYPE_ETHERNET, reserved = 0, name_len;
+    uint32_t snaplen = 0;
+    uint8_t tsresol = 6;
+
+    fwrite(shb, sizeof(shb), 1, fp);
+
+    name_len = static_cast<uint16_t>((ifname != NULL) ? strnlen(ifname, 64):0);
+    len = 20 + 8 + ((name_len != 0) ? (4 + EM_PCAPNG_PAD(name_len)):0) + 4;
+    fwrite(&type, sizeof(type), 1, fp);
+    fwrite(&len, sizeof(len), 1, fp);
+    fwrite(&linktype, sizeof(linktype), 1, fp);
+    fwrite(&reserved, sizeof(reserved), 1, fp);
+    fwrite(&snaplen, sizeof(snaplen), 1, fp);
+    if (name_len != 0) {
+        write_option(fp, EM_PCAPNG_OPT_IF_NAME, ifname, name_len);
+    }
+    write_option(fp, EM_PCAPNG_OPT_IF_TSRESOL, &tsresol, sizeof(tsresol));
+    write_option(fp, EM_PCAPNG_OPT_END, NULL, 0);
+    fwrite(&len, sizeof(len), 1, fp);
+
+    return (fflush(fp) == 0) ? 0:-1;
+}
+
+int em_capture_t::start(const char *path, const char *ifname)
+{
+    FILE *fp;
+
+    pthread_mutex_lock(&s_lock);
+    if (s_fp.load(std::memory_order_relaxed) != NULL) {
+        pthread_mutex_unlock(&s_lock);
+        printf("%s:%d: Capture already running\n", __func__, __LINE__);
+        return -1;
+    }
+
+    if ((fp = fopen(path, "wb")) == NULL) {
+        pthread_mutex_unlock(&s_lock);
+        printf("%s:%d: Failed to open capture file:%s\n", __func__, __LINE__, path);
+        return -1;
+    }
+    if (write_shb_idb(fp, ifname) != 0) {
+        fclose(fp);
+        pthread_mutex_unlock(&s_lock);
+        printf("%s:%d: Failed to write capture file:%s\n", __func__, __LINE__, path);
+        return -1;
+    }
+
+    s_frames = 0;
+    s_fp.store(fp, std::memory_order_release);
+    pthread_mutex_unlock(&s_lock);
+    printf("%s:%d: Capturing frames to %s\n", __func__, __LINE__, path);
+
+    return 0;
+}
+
+uint64_t em_capture_t::stop()
+{
+    FILE *fp;
+    uint64_t frames;
+
+    pthread_mutex_lock(&s_lock);
+    fp = s_fp.exchange(NULL, std::memory_order_relaxed);
+    frames = s_frames;
+    if (fp != NULL) {
+        fclose(fp);
+    }
+    pthread_mutex_unlock(&s_lock);
+
+    return frames;
+}
+
+void em_capture_t::write(em_capture_dir_t dir, const char *node, const unsigned char *buff, unsigned int len)
+{
+    uint32_t hdr[7], flags, block_len;
+    uint16_t node_len;
+    struct timespec ts;
+    uint64_t ts_us;
+    FILE *fp;
+
+    if (s_fp.load(std::memory_order_relaxed) == NULL) {
+        return;
+    }
+
+    node_len = static_cast<uint16_t>((node != NULL) ? strnlen(node, EM_CAPTURE_NODE_LEN - 1):0);
+    flags = (dir == em_capture_dir_rx) ? 1:((dir == em_capture_dir_tx) ? 2:0);
+    block_len = static_cast<uint32_t>(sizeof(hdr)) + EM_PCAPNG_PAD(len) + 8 +
+        ((node_len != 0) ? (4 + EM_PCAPNG_PAD(node_len)):0) + 4 + 4;
+
+    pthread_mutex_lock(&s_lock);
+    // stopped while waiting for the lock
+    if ((fp = s_fp.load(std::memory_order_relaxed)) == NULL) {
+        pthread_mutex_unlock(&s_lock);
+        return;
+    }
+
+    // stamped under the lock, so that the frames of all threads are in time order
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts_us = (static_cast<uint64_t>(ts.tv_sec) * 1000000) + (static_cast<uint64_t>(ts.tv_nsec) / 1000);
+    hdr[0] = EM_PCAPNG_BLOCK_EPB;
+    hdr[1] = block_len;
+    hdr[2] = 0;     // interface
+    hdr[3] = static_cast<uint32_t>(ts_us >> 32);
+    hdr[4] = static_cast<uint32_t>(ts_us);
+    hdr[5] = len;
+    hdr[6] = len;
+    fwrite(hdr, sizeof(hdr), 1, fp);
+    fwrite(buff, len, 1, fp);
+    fwrite(s_pad, EM_PCAPNG_PAD(len) - len, 1, fp);
+    write_option(fp, EM_PCAPNG_OPT_EPB_FLAGS, &flags, sizeof(flags));
+    if (node_len != 0) {
+        write_option(fp, EM_PCAPNG_OPT_COMMENT, node, node_len);
+    }
+    write_option(fp, EM_PCAPNG_OPT_END, NULL, 0);
+    fwrite(&block_len, sizeof(block_len), 1, fp);
+    fflush(fp);
+    s_frames++;
+    pthread_mutex_unlock(&s_lock);
+}
+
+int em_capture_reader_t::open(const char *path)
+{
+    uint32_t type;
+
+    close();
+    if ((m_fp = fopen(path, "rb")) == NULL) {
+        printf("%s:%d: Failed to open capture file:%s\n", __func__, __LINE__, path);
+        return -1;
+    }
+
+    if ((fread(&type, sizeof(type), 1, m_fp) != 1) || (type != EM_PCAPNG_BLOCK_SHB)) {
+        printf("%s:%d: Not a pcapng file:%s\n", __func__, __LINE__, path);
+        close();
+        return -1;
+    }
+    rewind(m_fp);
+
+    return 0;
+}
+
+int em_capture_reader_t::parse_idb(unsigned int len)
+{
+    const unsigned char *opt, *end = &m_block[0] + len;
+    uint64_t units = 1000000;
+    uint16_t code, opt_len;
+    unsigned int i;
+
+    if (len < 8) {
+        return -1;
+    }
+    opt = &m_block[8];
+
+    // options follow the link type, reserved and snap length
+    while ((opt + 4) <= end) {
+        memcpy(&code, opt, sizeof(code));
+        memcpy(&opt_len, opt + 2, sizeof(opt_len));
+        if ((code == EM_PCAPNG_OPT_END) || ((opt + 4 + opt_len) > end)) {
+            break;
+        }
+        if ((code == EM_PCAPNG_OPT_IF_TSRESOL) && (opt_len >= 1)) {
+            // a power of ten, or a power of two with the top bit set
+            units = 1;
+            for (i = 0; (i < (opt[4] & 0x7fU)) && (units < 1000000000000000000ULL); i++) {
+                units *= (opt[4] & 0x80U) ? 2:10;
+            }
+        }
+        opt += 4 + EM_PCAPNG_PAD(opt_len);
+    }
+    m_if_units.push_back((units == 0) ? 1000000:units);
+
+    return 0;
+}
+
+int em_capture_reader_t::parse_epb(unsigned int len, em_capture_frame_t *frame)
+{
+    const unsigned char *opt, *end = &m_block[0] + len;
+    uint32_t fields[5], flags;
+    uint16_t code, opt_len;
+    uint64_t ts, units;
+
+    if (len < sizeof(fields)) {
+        return -1;
+    }
+    // interface, timestamp high and low, captured and original length
+    memcpy(fields, &m_block[0], sizeof(fields));
+    if ((fields[0] >= m_if_units.size()) || (fields[3] > (len - sizeof(fields)))) {
+        return -1;
+    }
+
+    ts = (static_cast<uint64_t>(fields[1]) << 32) | fields[2];
+    units = m_if_units[fields[0]];
+    frame->ts_us = static_cast<uint64_t>((static_cast<unsigned __int128>(ts) * 1000000) / units);
+    frame->dir = em_capture_dir_unknown;
+    frame->len = fields[3];
+    frame->orig_len = fields[4];
+    frame->data = &m_block[sizeof(fields)];
+    frame->node[0] = '\0';
+
+    opt = frame->data + EM_PCAPNG_PAD(frame->len);
+    while ((opt + 4) <= end) {
+        memcpy(&code, opt, sizeof(code));
+        memcpy(&opt_len, opt + 2, sizeof(opt_len));
+        if ((code == EM_PCAPNG_OPT_END) || ((opt + 4 + opt_len) > end)) {
+            break;
+        }
+        if ((code == EM_PCAPNG_OPT_EPB_FLAGS) && (opt_len == sizeof(flags))) {
+            memcpy(&flags, opt + 4, sizeof(flags));
+            frame->dir = ((flags & 3U) == 1) ? em_capture_dir_rx:(((flags & 3U) == 2) ? em_capture_dir_tx:em_capture_dir_unknown);
+        } else if (code == EM_PCAPNG_OPT_COMMENT) {
+            snprintf(frame->node, sizeof(frame->node), "%.*s", static_cast<int>(opt_len), reinterpret_cast<const char *>(opt + 4));
+        }
+        opt += 4 + EM_PCAPNG_PAD(opt_len);
+    }
+
+    return 1;
+}
+
+int em_capture_reader_t::next(em_capture_frame_t *frame)
+{
+    uint32_t hdr[2], trailer, magic;
+    unsigned int len;
+    int ret;
+
+    if (m_fp == NULL) {
+        return -1;
+    }
+
+    while (fread(hdr, sizeof(hdr), 1, m_fp) == 1) {
+        if ((hdr[1] < 12) || ((hdr[1] % 4) != 0) || (hdr[1] > EM_CAPTURE_MAX_BLOCK)) {
+            printf("%s:%d: Invalid block length:%u\n", __func__, __LINE__, hdr[1]);
+            return -1;
+        }
+
+        // the body of the block, without the type and the two lengths
+        len = hdr[1] - 12;
+        m_block.resize(len + 4);
+        if ((fread(&m_block[0], 1, len, m_fp) != len) || (fread(&trailer, sizeof(trailer), 1, m_fp) != 1) ||
+                (trailer != hdr[1])) {
+            printf("%s:%d: Truncated block\n", __func__, __LINE__);
+            return -1;
+        }
+
+        switch (hdr[0]) {
+            case EM_PCAPNG_BLOCK_SHB:
+                if (len < sizeof(magic)) {
+                    return -1;
+                }
+                memcpy(&magic, &m_block[0], sizeof(magic));
+                if (magic != EM_PCAPNG_BYTE_ORDER_MAGIC) {
+                    printf("%s:%d: Section in foreign byte order\n", __func__, __LINE__);
+                    return -1;
+                }
+                m_if_units.clear();
+                break;
+
+            case EM_PCAPNG_BLOCK_IDB:
+                if (parse_idb(len) != 0) {
+                    printf("%s:%d: Invalid interface block\n", __func__, __LINE__);
+                    return -1;
+                }
+                break;
+
+            case EM_PCAPNG_BLOCK_EPB:
+                if ((ret = parse_epb(len, frame)) < 0) {
+                    printf("%s:%d: Invalid packet block\n", __func__, __LINE__);
+                }
+                return ret;
+
+            default:
+                break;
+        }
+    }
+
+    return 0;
+}
+
+void em_capture_reader_t::close()
+{
+    if (m_fp != NULL) {
+        fclose(m_fp);
+        m_fp = NULL;
+    }
+    m_if_units.clear();
+}
+
+em_capture_reader_t::em_capture_reader_t()
+{
+    m_fp = NULL;
+}
+
+em_capture_reader_t::~em_capture_reader_t()
+{
+    close();
+}
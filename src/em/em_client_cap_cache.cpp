@@ -0,0 +1,376 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "em_client_cap_cache.h"
+
+// elements of a (Re)Association Request
+#define EM_ELEM_SSID                0
+#define EM_ELEM_HT_CAP              45
+#define EM_ELEM_SUPP_OP_CLASSES     59
+#define EM_ELEM_RRM_CAP             70
+#define EM_ELEM_EXT_CAP             127
+#define EM_ELEM_VHT_CAP             191
+#define EM_ELEM_EXT                 255
+#define EM_ELEM_EXT_HE_CAP          35
+#define EM_ELEM_EXT_HE_6G_CAP       59
+#define EM_ELEM_EXT_MULTI_LINK      107
+#define EM_ELEM_EXT_EHT_CAP         108
+
+#define EM_OP_CLASS_DELIM           130     // ends the operating classes of a Supported Operating Classes element
+#define EM_EXT_CAP_BTM_BYTE         2       // BSS Transition, bit 19 of the Extended Capabilities
+#define EM_EXT_CAP_BTM_BIT          0x08
+#define EM_MULTI_LINK_MLD_MAC       4       // after the extension ID, Multi-Link Control and Common Info Length
+
+unsigned long long em_client_cap_cache_t::sta_key(const unsigned char *sta)
+{
+    unsigned long long key = 0;
+
+    memcpy(&key, sta, sizeof(mac_address_t));
+
+    return key;
+}
+
+// true if the elements end exactly at the end of the buffer
+static bool elems_fit(const unsigned char *elems, unsigned int len)
+{
+    while (len >= 2) {
+        if (len < static_cast<unsigned int>(elems[1]) + 2) {
+            return false;
+        }
+        len -= static_cast<unsigned int>(elems[1]) + 2;
+        elems += elems[1] + 2;
+    }
+
+    return len == 0;
+}
+
+unsigned int em_client_cap_cache_t::op_class_band(unsigned char op_class)
+{
+    if ((op_class >= 81) && (op_class <= 84)) {
+        return EM_CLIENT_CAP_BAND_24;
+    } else if ((op_class >= 115) && (op_class <= 130)) {
+        return EM_CLIENT_CAP_BAND_5;
+    } else if ((op_class >= 131) && (op_class <= 137)) {
+        return EM_CLIENT_CAP_BAND_6;
+    }
+
+    return 0;
+}
+
+unsigned int em_client_cap_cache_t::freq_band(em_freq_band_t band)
+{
+    switch (band) {
+        case em_freq_band_24:
+            return EM_CLIENT_CAP_BAND_24;
+        case em_freq_band_5:
+            return EM_CLIENT_CAP_BAND_5;
+        case em_freq_band_60:
+            return EM_CLIENT_CAP_BAND_6;
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+unsigned int em_client_cap_cache_t::get_elems_offset(const unsigned char *body, unsigned int len)
+{
+    // an Association Request has its fixed fields first, a Reassociation Request the current AP too,
+    // some agents send the elements alone, the SSID element comes first in all of them
+    static const unsigned int offsets[] = {4, 10, 0};
+    unsigned int i;
+
+    for (i = 0; i < sizeof(offsets)/sizeof(offsets[0]); i++) {
+        if ((offsets[i] < len) && (body[offsets[i]] == EM_ELEM_SSID) && (elems_fit(body + offsets[i], len - offsets[i]) == true)) {
+            return offsets[i];
+        }
+    }
+    printf("%s:%d: frame body of length:%d not parsed to the end\n", __func__, __LINE__, len);
+
+    return 0;
+}
+
+bool em_client_cap_cache_t::parse(const unsigned char *body, unsigned int len, em_client_cap_t *cap)
+{
+    const unsigned char *elem;
+    unsigned int i, off, elem_len, nss, map;
+
+    cap->bands = 0;
+    cap->flags = 0;
+    cap->max_nss = 0;
+    memset(cap->mld_mac, 0, sizeof(mac_address_t));
+
+    off = get_elems_offset(body, len);
+
+    while (off + 2 <= len) {
+        elem = body + off + 2;
+        elem_len = body[off + 1];
+        if (off + 2 + elem_len > len) {
+            return false;
+        }
+
+        switch (body[off]) {
+            case EM_ELEM_HT_CAP:
+                cap->flags |= EM_CLIENT_CAP_HT;
+                // Rx MCS bitmask after the HT Capability Information and A-MPDU Parameters, a byte per stream
+                for (i = 0, nss = 0; (i < 4) && (3 + i < elem_len); i++) {
+                    nss += (elem[3 + i] != 0) ? 1:0;
+                }
+                cap->max_nss = (nss > cap->max_nss) ? static_cast<unsigned char>(nss):cap->max_nss;
+                break;
+
+            case EM_ELEM_VHT_CAP:
+                cap->flags |= EM_CLIENT_CAP_VHT;
+                // Rx VHT-MCS Map after the VHT Capabilities Information, 2 bits per stream, 3 if not supported
+                if (elem_len >= 6) {
+                    map = static_cast<unsigned int>(elem[4]) | (static_cast<unsigned int>(elem[5]) << 8);
+                    for (i = 8; i > 0; i--) {
+                        if (((map >> (2*(i - 1))) & 0x3) != 0x3) {
+                            break;
+                        }
+                    }
+                    cap->max_nss = (i > cap->max_nss) ? static_cast<unsigned char>(i):cap->max_nss;
+                }
+                break;
+
+            case EM_ELEM_SUPP_OP_CLASSES:
+                for (i = 0; (i < elem_len) && (elem[i] != EM_OP_CLASS_DELIM); i++) {
+                    cap->bands |= op_class_band(elem[i]);
+                }
+                break;
+
+            case EM_ELEM_RRM_CAP:
+                cap->flags |= EM_CLIENT_CAP_RRM;
+                break;
+
+            case EM_ELEM_EXT_CAP:
+                if ((elem_len > EM_EXT_CAP_BTM_BYTE) && ((elem[EM_EXT_CAP_BTM_BYTE] & EM_EXT_CAP_BTM_BIT) != 0)) {
+                    cap->flags |= EM_CLIENT_CAP_BTM;
+                }
+                break;
+
+            case EM_ELEM_EXT:
+                if (elem_len == 0) {
+                    break;
+                }
+                if (elem[0] == EM_ELEM_EXT_HE_CAP) {
+                    cap->flags |= EM_CLIENT_CAP_HE;
+                } else if (elem[0] == EM_ELEM_EXT_EHT_CAP) {
+                    cap->flags |= EM_CLIENT_CAP_EHT;
+                } else if (elem[0] == EM_ELEM_EXT_HE_6G_CAP) {
+                    cap->bands |= EM_CLIENT_CAP_BAND_6;
+                } else if (elem[0] == EM_ELEM_EXT_MULTI_LINK) {
+                    cap->flags |= EM_CLIENT_CAP_MLO;
+                    // the Common Info of a Basic Multi-Link element starts with its length and the MLD MAC
+                    if ((elem_len >= EM_MULTI_LINK_MLD_MAC + sizeof(mac_address_t)) && (elem[EM_MULTI_LINK_MLD_MAC - 1] >= sizeof(mac_address_t))) {
+                        memcpy(cap->mld_mac, &elem[EM_MULTI_LINK_MLD_MAC], sizeof(mac_address_t));
+                    }
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        off += 2 + elem_len;
+    }
+
+    return off == len;
+}
+
+bool em_client_cap_cache_t::update(const unsigned char *sta, const unsigned char *body, unsigned int len, em_freq_band_t band, unsigned long long now)
+{
+    em_client_cap_sta_t *s;
+    unsigned int bands;
+    bool changed;
+
+    if (len > EM_MAX_FRAME_BODY_LEN) {
+        len = EM_MAX_FRAME_BODY_LEN;
+    }
+
+    pthread_rwlock_wrlock(&m_lock);
+
+    auto it = m_stas.find(sta_key(sta));
+    if (it == m_stas.end()) {
+        it = m_stas.emplace(sta_key(sta), em_client_cap_sta_t()).first;
+    }
+    s = &it->second;
+    bands = s->cap.bands;
+
+    // the same STA reports the same body on every association, parsed once
+    changed = (s->cap.time_ms == 0) || (s->body_len != len) || (memcmp(s->body, body, len) != 0);
+    if (changed == true) {
+        memcpy(s->body, body, len);
+        s->body_len = len;
+        parse(s->body, len, &s->cap);
+        bands = s->cap.bands;
+    }
+    s->cap.bands |= freq_band(band);
+    s->cap.time_ms = now;
+    s->query_ms = 0;
+    changed = changed || (s->cap.bands != bands);
+
+    pthread_rwlock_unlock(&m_lock);
+
+    return changed;
+}
+
+bool em_client_cap_cache_t::get(const unsigned char *sta, em_client_cap_t *cap)
+{
+    bool found;
+
+    pthread_rwlock_rdlock(&m_lock);
+    auto it = m_stas.find(sta_key(sta));
+    found = (it != m_stas.end()) && (it->second.cap.time_ms != 0);
+    if (found == true) {
+        *cap = it->second.cap;
+    }
+    pthread_rwlock_unlock(&m_lock);
+
+    return found;
+}
+
+unsigned int em_client_cap_cache_t::get_body(const unsigned char *sta, unsigned char *body, unsigned int max)
+{
+    unsigned int len = 0;
+
+    pthread_rwlock_rdlock(&m_lock);
+    auto it = m_stas.find(sta_key(sta));
+    if ((it != m_stas.end()) && (it->second.cap.time_ms != 0) && (it->second.body_len <= max)) {
+        len = it->second.body_len;
+        memcpy(body, it->second.body, len);
+    }
+    pthread_rwlock_unlock(&m_lock);
+
+    return len;
+}
+
+bool em_client_cap_cache_t::needs_query(const unsigned char *sta, em_freq_band_t band, unsigned long long now)
+{
+    const em_client_cap_t *cap;
+    unsigned int b = freq_band(band);
+    bool needed = true;
+
+    pthread_rwlock_rdlock(&m_lock);
+    auto it = m_stas.find(sta_key(sta));
+    if ((it != m_stas.end()) && (it->second.cap.time_ms != 0)) {
+        cap = &it->second.cap;
+        // a STA on a band it did not announce is not the STA that was reported
+        needed = (now >= cap->time_ms + EM_CLIENT_CAP_MAX_AGE_MS) ||
+                ((b != 0) && (cap->bands != 0) && ((cap->bands & b) == 0));
+    }
+    pthread_rwlock_unlock(&m_lock);
+
+    return needed;
+}
+
+bool em_client_cap_cache_t::claim_query(const unsigned char *sta, unsigned long long now)
+{
+    em_client_cap_sta_t *s;
+    bool claimed = false;
+
+    pthread_rwlock_wrlock(&m_lock);
+    auto it = m_stas.find(sta_key(sta));
+    if (it == m_stas.end()) {
+        it = m_stas.emplace(sta_key(sta), em_client_cap_sta_t()).first;
+    }
+    s = &it->second;
+    if ((s->query_ms == 0) || (now >= s->query_ms + EM_CLIENT_CAP_QUERY_TIMEOUT_MS)) {
+        s->query_ms = now;
+        claimed = true;
+    }
+    pthread_rwlock_unlock(&m_lock);
+
+    return claimed;
+}
+
+bool em_client_cap_cache_t::supports_op_class(const unsigned char *sta, unsigned char op_class)
+{
+    unsigned int b = op_class_band(op_class);
+    bool supported = true;
+
+    pthread_rwlock_rdlock(&m_lock);
+    auto it = m_stas.find(sta_key(sta));
+    if ((b != 0) && (it != m_stas.end()) && (it->second.cap.time_ms != 0) && (it->second.cap.bands != 0)) {
+        supported = ((it->second.cap.bands & b) != 0);
+    }
+    pthread_rwlock_unlock(&m_lock);
+
+    return supported;
+}
+
+unsigned int em_client_cap_cache_t::age_out(unsigned long long now)
+{
+    unsigned long long last;
+    unsigned int removed = 0;
+
+    if (now < EM_CLIENT_CAP_MAX_AGE_MS) {
+        return 0;
+    }
+
+    pthread_rwlock_wrlock(&m_lock);
+
+    for (auto it = m_stas.begin(); it != m_stas.end();) {
+        last = (it->second.cap.time_ms > it->second.query_ms) ? it->second.cap.time_ms:it->second.query_ms;
+        if (last + EM_CLIENT_CAP_MAX_AGE_MS <= now) {
+            it = m_stas.erase(it);
+            removed++;
+        } else {
+            ++it;
+        }
+    }
+
+    pthread_rwlock_unlock(&m_lock);
+
+    return removed;
+}
+
+bool em_client_cap_cache_t::remove(const unsigned char *sta)
+{
+    bool found;
+
+    pthread_rwlock_wrlock(&m_lock);
+    found = (m_stas.erase(sta_key(sta)) != 0);
+    pthread_rwlock_unlock(&m_lock);
+
+    return found;
+}
+
+unsigned int em_client_cap_cache_t::count()
+{
+    unsigned int num;
+
+    pthread_rwlock_rdlock(&m_lock);
+    num = static_cast<unsigned int>(m_stas.size());
+    pthread_rwlock_unlock(&m_lock);
+
+    return num;
+}
+
+em_client_cap_cache_t::em_client_cap_cache_t()
+{
+    pthread_rwlock_init(&m_lock, NULL);
+}
+
+em_client_cap_cache_t::~em_client_cap_cache_t()
+{
+    pthread_rwlock_destroy(&m_lock);
+}
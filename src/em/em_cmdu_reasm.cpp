@@ -0,0 +1,360 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <arpa/inet.h>
+#include "em_cmdu_reasm.h"
+
+#define EM_REASM_HDR_LEN    (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))
+
+em_reasm_entry_t *em_cmdu_reasm_t::find_entry(mac_address_t src, unsigned short msg_id, bool create)
+{
+    em_reasm_entry_t *entry, *avail = NULL;
+    unsigned int i;
+
+    for (i = 0; i < EM_REASM_MAX_ENTRIES; i++) {
+        entry = &m_entries[i];
+        if (entry->in_use == false) {
+            avail = (avail == NULL) ? entry:avail;
+            continue;
+        }
+        if ((entry->msg_id == msg_id) && (memcmp(entry->src, src, sizeof(mac_address_t)) == 0)) {
+            return entry;
+        }
+    }
+
+    if (create == false) {
+        return NULL;
+    }
+
+    if (avail == NULL) {
+        // every entry is taken, the oldest message is the least likely to complete
+        if ((avail = get_oldest(NULL, NULL)) == NULL) {
+            return NULL;
+        }
+        free_entry(avail);
+        m_stats.quota_evictions++;
+    }
+
+    avail->in_use = true;
+    memcpy(avail->src, src, sizeof(mac_address_t));
+    avail->msg_id = msg_id;
+    avail->tlvs = NULL;
+    avail->len = 0;
+    avail->cap = 0;
+    avail->frags = 0;
+    avail->last_frag_id = -1;
+    avail->num_frags = 0;
+    m_num_entries++;
+
+    return avail;
+}
+
+void em_cmdu_reasm_t::free_entry(em_reasm_entry_t *entry)
+{
+    free(entry->tlvs);
+    entry->tlvs = NULL;
+    m_bytes -= entry->cap;
+    entry->cap = 0;
+    entry->len = 0;
+    entry->in_use = false;
+    m_num_entries--;
+}
+
+em_reasm_entry_t *em_cmdu_reasm_t::get_oldest(mac_address_t src, em_reasm_entry_t *skip)
+{
+    em_reasm_entry_t *entry, *oldest = NULL;
+    unsigned int i;
+
+    for (i = 0; i < EM_REASM_MAX_ENTRIES; i++) {
+        entry = &m_entries[i];
+        if ((entry->in_use == false) || (entry == skip)) {
+            continue;
+        }
+        if ((src != NULL) && (memcmp(entry->src, src, sizeof(mac_address_t)) != 0)) {
+            continue;
+        }
+        if ((oldest == NULL) || (entry->first_us < oldest->first_us)) {
+            oldest = entry;
+        }
+    }
+
+    return oldest;
+}
+
+unsigned int em_cmdu_reasm_t::get_peer_bytes(mac_address_t src)
+{
+    unsigned int i, bytes = 0;
+
+    for (i = 0; i < EM_REASM_MAX_ENTRIES; i++) {
+        if ((m_entries[i].in_use == true) && (memcmp(m_entries[i].src, src, sizeof(mac_address_t)) == 0)) {
+            bytes += m_entries[i].cap;
+        }
+    }
+
+    return bytes;
+}
+
+int em_cmdu_reasm_t::reserve(em_reasm_entry_t *entry, unsigned int len)
+{
+    em_reasm_entry_t *victim;
+    unsigned char *tmp;
+    unsigned int need = entry->len + len, cap, grow;
+
+    if (need <= entry->cap) {
+        return 0;
+    }
+
+    if ((need > m_peer_quota) || (need > m_max_bytes)) {
+        return -1;
+    }
+
+    cap = (entry->cap * 2 > need) ? entry->cap * 2:need;
+    if ((cap > m_peer_quota) || (cap > m_max_bytes)) {
+        cap = need;
+    }
+    grow = cap - entry->cap;
+
+    while ((get_peer_bytes(entry->src) + grow) > m_peer_quota) {
+        if ((victim = get_oldest(entry->src, entry)) == NULL) {
+            return -1;
+        }
+        free_entry(victim);
+        m_stats.quota_evictions++;
+    }
+
+    while ((m_bytes + grow) > m_max_bytes) {
+        if ((victim = get_oldest(NULL, entry)) == NULL) {
+            return -1;
+        }
+        free_entry(victim);
+        m_stats.quota_evictions++;
+    }
+
+    if ((tmp = static_cast<unsigned char *>(realloc(entry->tlvs, cap))) == NULL) {
+        printf("%s:%d: Failed to grow reassembly buffer to %d bytes\n", __func__, __LINE__, cap);
+        return -1;
+    }
+
+    entry->tlvs = tmp;
+    entry->cap = cap;
+    m_bytes += grow;
+
+    return 0;
+}
+
+em_rx_buff_t *em_cmdu_reasm_t::assemble(em_reasm_entry_t *entry, unsigned int *len)
+{
+    em_rx_buff_t *buff;
+    em_cmdu_t *cmdu;
+    unsigned int i, j, off = EM_REASM_HDR_LEN;
+    bool in_order = true;
+
+    if ((buff = m_ring->get(EM_REASM_HDR_LEN + entry->len)) == NULL) {
+        printf("%s:%d: Failed to get a buffer for a message of %d bytes\n", __func__, __LINE__, entry->len);
+        free_entry(entry);
+        return NULL;
+    }
+
+    // headers of fragment 0, marked as those of an unfragmented CMDU
+    memcpy(buff->data, entry->hdr, EM_REASM_HDR_LEN);
+    cmdu = reinterpret_cast<em_cmdu_t *>(buff->data + sizeof(em_raw_hdr_t));
+    cmdu->frag_id = 0;
+    cmdu->last_frag_ind = 1;
+
+    for (i = 0; i < entry->num_frags; i++) {
+        if (entry->frag[i].frag_id != i) {
+            in_order = false;
+            break;
+        }
+    }
+
+    if ((in_order == true) && (entry->len != 0)) {
+        // fragments came in order, their TLVs are already laid out as the message
+        memcpy(buff->data + off, entry->tlvs, entry->len);
+        off += entry->len;
+    } else if (in_order == false) {
+        for (i = 0; i < entry->num_frags; i++) {
+            for (j = 0; entry->frag[j].frag_id != i; j++);
+            memcpy(buff->data + off, entry->tlvs + entry->frag[j].off, entry->frag[j].len);
+            off += entry->frag[j].len;
+        }
+    }
+
+    *len = off;
+    free_entry(entry);
+
+    return buff;
+}
+
+unsigned int em_cmdu_reasm_t::get_tlvs_len(unsigned char *tlvs, unsigned int len, bool keep_eom)
+{
+    em_tlv_t *tlv;
+    unsigned int off = 0, tlv_len;
+
+    while ((off + sizeof(em_tlv_t)) <= len) {
+        tlv = reinterpret_cast<em_tlv_t *>(tlvs + off);
+        if (tlv->type == em_tlv_type_eom) {
+            // padding of short frames reads as end of message TLVs as well
+            return (keep_eom == true) ? static_cast<unsigned int>(off + sizeof(em_tlv_t)):off;
+        }
+        tlv_len = static_cast<unsigned int>(sizeof(em_tlv_t) + htons(tlv->len));
+        if ((off + tlv_len) > len) {
+            break;
+        }
+        off += tlv_len;
+    }
+
+    return off;
+}
+
+em_rx_buff_t *em_cmdu_reasm_t::add(em_rx_buff_t *buff, unsigned int *len, uint64_t now_us)
+{
+    em_raw_hdr_t *hdr;
+    em_cmdu_t *cmdu;
+    em_reasm_entry_t *entry;
+    em_reasm_frag_t *frag;
+    unsigned int tlvs_len;
+    uint64_t bit;
+
+    if (m_num_entries != 0) {
+        expire(now_us);
+    }
+
+    // frames too short for a CMDU are left to the caller to reject
+    if (*len < EM_REASM_HDR_LEN) {
+        return buff;
+    }
+
+    hdr = reinterpret_cast<em_raw_hdr_t *>(buff->data);
+    cmdu = reinterpret_cast<em_cmdu_t *>(buff->data + sizeof(em_raw_hdr_t));
+    if ((cmdu->frag_id == 0) && (cmdu->last_frag_ind == 1)) {
+        return buff;
+    }
+
+    entry = (cmdu->frag_id < EM_REASM_MAX_FRAGS) ? find_entry(hdr->src, cmdu->id, true):NULL;
+    if (entry == NULL) {
+        m_stats.dropped_frags++;
+        em_frame_ring_t::put(buff);
+        return NULL;
+    }
+
+    bit = static_cast<uint64_t>(1) << cmdu->frag_id;
+    if (entry->num_frags == 0) {
+        entry->type = cmdu->type;
+        entry->first_us = now_us;
+    } else if ((entry->type != cmdu->type) || ((entry->frags & bit) != 0) ||
+            ((entry->last_frag_id >= 0) && ((cmdu->last_frag_ind == 1) || (cmdu->frag_id > entry->last_frag_id)))) {
+        m_stats.dropped_frags++;
+        em_frame_ring_t::put(buff);
+        return NULL;
+    }
+
+    if ((cmdu->last_frag_ind == 1) && ((entry->frags >> cmdu->frag_id) > 1)) {
+        // a fragment past the last one was already taken, the message can not be trusted
+        m_stats.dropped_frags++;
+        free_entry(entry);
+        em_frame_ring_t::put(buff);
+        return NULL;
+    }
+
+    tlvs_len = get_tlvs_len(buff->data + EM_REASM_HDR_LEN, *len - EM_REASM_HDR_LEN, cmdu->last_frag_ind == 1);
+    if (reserve(entry, tlvs_len) != 0) {
+        m_stats.dropped_frags++;
+        free_entry(entry);
+        em_frame_ring_t::put(buff);
+        return NULL;
+    }
+
+    frag = &entry->frag[entry->num_frags];
+    frag->frag_id = cmdu->frag_id;
+    frag->off = entry->len;
+    frag->len = tlvs_len;
+    if (tlvs_len != 0) {
+        memcpy(entry->tlvs + entry->len, buff->data + EM_REASM_HDR_LEN, tlvs_len);
+        entry->len += tlvs_len;
+    }
+    // the message takes the headers of fragment 0, whatever fragment came first
+    if (cmdu->frag_id == 0) {
+        memcpy(entry->hdr, buff->data, EM_REASM_HDR_LEN);
+    }
+    entry->frags |= bit;
+    entry->num_frags++;
+    if (cmdu->last_frag_ind == 1) {
+        entry->last_frag_id = cmdu->frag_id;
+    }
+    em_frame_ring_t::put(buff);
+
+    if ((entry->last_frag_id < 0) || (entry->num_frags != static_cast<unsigned int>(entry->last_frag_id + 1))) {
+        return NULL;
+    }
+
+    m_stats.completed++;
+    m_lat.add(now_us - entry->first_us);
+
+    return assemble(entry, len);
+}
+
+unsigned int em_cmdu_reasm_t::expire(uint64_t now_us)
+{
+    em_reasm_entry_t *entry;
+    unsigned int i, num = 0;
+
+    for (i = 0; i < EM_REASM_MAX_ENTRIES; i++) {
+        entry = &m_entries[i];
+        if ((entry->in_use == true) && ((now_us - entry->first_us) > m_timeout_us)) {
+            free_entry(entry);
+            m_stats.timeouts++;
+            num++;
+        }
+    }
+
+    return num;
+}
+
+void em_cmdu_reasm_t::flush()
+{
+    unsigned int i;
+
+    for (i = 0; i < EM_REASM_MAX_ENTRIES; i++) {
+        if (m_entries[i].in_use == true) {
+            free_entry(&m_entries[i]);
+        }
+    }
+}
+
+void em_cmdu_reasm_t::set_limits(unsigned int peer_quota, unsigned int max_bytes, uint64_t timeout_us)
+{
+    m_peer_quota = peer_quota;
+    m_max_bytes = max_bytes;
+    m_timeout_us = timeout_us;
+}
+
+em_cmdu_reasm_t::em_cmdu_reasm_t(): m_ring(NULL), m_num_entries(0), m_bytes(0), m_peer_quota(EM_REASM_PEER_QUOTA),
+    m_max_bytes(EM_REASM_MAX_BYTES), m_timeout_us(EM_REASM_TIMEOUT_US)
+{
+    memset(m_entries, 0, sizeof(m_entries));
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+em_cmdu_reasm_t::~em_cmdu_reasm_t()
+{
+    flush();
+}
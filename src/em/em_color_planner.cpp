@@ -0,0 +1,381 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <deque>
+#include "em_color_planner.h"
+
+unsigned int em_color_planner_t::get_signal_weight(signed char signal_strength)
+{
+    int weight = static_cast<int> (signal_strength) + 100;
+
+    // -99 dBm and below barely interferes, -20 dBm and above is next door
+    return static_cast<unsigned int> (std::min(std::max(weight, 1), 80));
+}
+
+unsigned int em_color_planner_t::get_partial_bssid_bit(const unsigned char *bssid)
+{
+    // bit 39 is the most significant bit of octet 4, bits 40 to 44 the low bits of octet 5
+    return static_cast<unsigned int> (((bssid[4] >> 7) & 0x01) | ((bssid[5] & 0x1f) << 1));
+}
+
+unsigned int em_color_planner_t::get_node(const unsigned char *ruid)
+{
+    em_packed_mac_t key = em_hex::pack_mac(ruid);
+    auto it = m_radios.find(key);
+
+    if (it != m_radios.end()) {
+        return it->second;
+    }
+
+    m_nodes.emplace_back();
+    em_color_planner_node_t& node = m_nodes.back();
+    memcpy(node.ruid, ruid, sizeof(mac_address_t));
+    node.op_class = 0;
+    node.channel = 0;
+    node.current = 0;
+    node.color = 0;
+    node.heard = 0;
+    node.scanned = 0;
+    node.dirty = true;
+    node.moves = 0;
+    m_radios[key] = static_cast<unsigned int> (m_nodes.size() - 1);
+
+    return static_cast<unsigned int> (m_nodes.size() - 1);
+}
+
+void em_color_planner_t::set_edge(unsigned int a, unsigned int b, unsigned int weight)
+{
+    em_color_planner_node_t *node = &m_nodes[a], *peer = &m_nodes[b];
+
+    for (auto& e : node->edges) {
+        if (e.peer != b) {
+            continue;
+        }
+        if (e.weight >= weight) {
+            return;
+        }
+        e.weight = weight;
+        for (auto& p : peer->edges) {
+            if (p.peer == a) {
+                p.weight = weight;
+                break;
+            }
+        }
+        node->dirty = true;
+        peer->dirty = true;
+        return;
+    }
+
+    node->edges.push_back({b, weight});
+    peer->edges.push_back({a, weight});
+    node->dirty = true;
+    peer->dirty = true;
+}
+
+unsigned long long em_color_planner_t::get_foreign(unsigned int node)
+{
+    em_color_planner_node_t *n = &m_nodes[node], *peer;
+    unsigned long long mesh = 0;
+
+    for (auto& e : n->edges) {
+        peer = &m_nodes[e.peer];
+        if ((peer->channel == n->channel) && (peer->current != 0)) {
+            mesh |= 1ULL << peer->current;
+        }
+    }
+
+    return n->scanned | (n->heard & ~mesh & ~1ULL);
+}
+
+unsigned long long em_color_planner_t::color_cost(unsigned int node, unsigned char color, unsigned long long foreign)
+{
+    em_color_planner_node_t *n = &m_nodes[node], *peer, *hidden;
+    unsigned long long cost = 0;
+
+    if ((n->current != 0) && (color != n->current)) {
+        cost += EM_COLOR_PLANNER_SWITCH_COST;
+    }
+    if ((foreign & (1ULL << color)) != 0) {
+        cost += EM_COLOR_PLANNER_FOREIGN_COST;
+    }
+
+    for (auto& e : n->edges) {
+        peer = &m_nodes[e.peer];
+        if (peer->channel != n->channel) {
+            continue;
+        }
+        if (get_color(peer) == color) {
+            cost += static_cast<unsigned long long> (e.weight) * EM_COLOR_PLANNER_PEER_COST;
+        }
+        // the STAs of the peer hear both, the weaker link bounds the collision
+        for (auto& e2 : peer->edges) {
+            hidden = &m_nodes[e2.peer];
+            if ((e2.peer == node) || (hidden->channel != n->channel) || (get_color(hidden) != color)) {
+                continue;
+            }
+            cost += static_cast<unsigned long long> (std::min(e.weight, e2.weight)) * EM_COLOR_PLANNER_HIDDEN_COST;
+        }
+    }
+
+    return cost;
+}
+
+bool em_color_planner_t::set_report(const unsigned char *ruid, unsigned char op_class, unsigned char channel, unsigned char color,
+                                    const unsigned char *heard)
+{
+    em_color_planner_node_t *node;
+    unsigned long long bits = 0;
+    bool changed;
+    unsigned int i;
+
+    for (i = 0; i < 8; i++) {
+        bits |= static_cast<unsigned long long> (heard[i]) << (8 * i);
+    }
+    color &= EM_COLOR_PLANNER_MAX_COLOR;
+
+    pthread_mutex_lock(&m_lock);
+    node = &m_nodes[get_node(ruid)];
+    changed = (node->op_class != op_class) || (node->channel != channel) || (node->current != color) || (node->heard != bits);
+    if (changed == true) {
+        node->op_class = op_class;
+        node->channel = channel;
+        node->current = color;
+        node->heard = bits;
+        node->dirty = true;
+        m_stats.reports++;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return changed;
+}
+
+void em_color_planner_t::add_bss(const unsigned char *bssid, const unsigned char *ruid)
+{
+    em_packed_mac_t key = em_hex::pack_mac(bssid);
+    unsigned int idx;
+
+    pthread_mutex_lock(&m_lock);
+    idx = get_node(ruid);
+    auto it = m_bss.find(key);
+    if ((it == m_bss.end()) || (it->second != idx)) {
+        if (it != m_bss.end()) {
+            std::vector<em_packed_mac_t>& old = m_nodes[it->second].bss;
+            old.erase(std::remove(old.begin(), old.end(), key), old.end());
+        }
+        m_bss[key] = idx;
+        m_nodes[idx].bss.push_back(key);
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+int em_color_planner_t::add_scan_result(const em_scan_result_t *res)
+{
+    unsigned long long scanned = 0;
+    unsigned int i, num, idx, color;
+    int raised = 0;
+
+    pthread_mutex_lock(&m_lock);
+    auto radio = m_radios.find(em_hex::pack_mac(res->id.scanner_mac));
+    if (radio == m_radios.end()) {
+        pthread_mutex_unlock(&m_lock);
+        return -1;
+    }
+    idx = radio->second;
+
+    num = (res->num_neighbors > EM_MAX_NEIGHBORS) ? EM_MAX_NEIGHBORS:res->num_neighbors;
+    for (i = 0; i < num; i++) {
+        auto it = m_bss.find(em_hex::pack_mac(res->neighbor[i].bssid));
+        if (it == m_bss.end()) {
+            if ((color = (res->neighbor[i].bss_color & EM_COLOR_PLANNER_MAX_COLOR)) != 0) {
+                scanned |= 1ULL << color;
+            }
+            continue;
+        }
+        if (it->second != idx) {
+            set_edge(idx, it->second, get_signal_weight(res->neighbor[i].signal_strength));
+            raised++;
+        }
+    }
+
+    if ((res->id.channel == m_nodes[idx].channel) && (m_nodes[idx].scanned != scanned)) {
+        m_nodes[idx].scanned = scanned;
+        m_nodes[idx].dirty = true;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return raised;
+}
+
+unsigned int em_color_planner_t::plan(bool full)
+{
+    std::vector<unsigned char> before;
+    std::vector<bool> queued;
+    std::deque<unsigned int> work;
+    em_color_planner_node_t *n;
+    unsigned long long foreign, cost, best_cost;
+    unsigned int i, idx, changed = 0, evaluated = 0, start, k;
+    unsigned char color, best;
+
+    pthread_mutex_lock(&m_lock);
+    before.resize(m_nodes.size());
+    queued.assign(m_nodes.size(), false);
+    for (i = 0; i < m_nodes.size(); i++) {
+        before[i] = m_nodes[i].color;
+        m_nodes[i].moves = 0;
+        if ((full == true) || (m_nodes[i].dirty == true) || (m_nodes[i].color == 0)) {
+            work.push_back(i);
+            queued[i] = true;
+        }
+    }
+
+    while (work.empty() == false) {
+        idx = work.front();
+        work.pop_front();
+        queued[idx] = false;
+        n = &m_nodes[idx];
+        n->dirty = false;
+        evaluated++;
+
+        // the color the radio has first, so that it keeps it on a tie, then from an offset of
+        // its own so that radios planned together do not all try color 1
+        foreign = get_foreign(idx);
+        best = (get_color(n) != 0) ? get_color(n):1;
+        best_cost = color_cost(idx, best, foreign);
+        start = static_cast<unsigned int> (em_hex::pack_mac(n->ruid) % EM_COLOR_PLANNER_MAX_COLOR);
+        for (k = 0; k < EM_COLOR_PLANNER_MAX_COLOR; k++) {
+            color = static_cast<unsigned char> ((start + k) % EM_COLOR_PLANNER_MAX_COLOR + 1);
+            if ((color != best) && ((cost = color_cost(idx, color, foreign)) < best_cost)) {
+                best = color;
+                best_cost = cost;
+            }
+        }
+
+        if (n->color == 0) {
+            n->color = best;
+            if (best == n->current) {
+                continue;
+            }
+        } else if ((best != n->color) && (n->moves < EM_COLOR_PLANNER_MAX_MOVES)) {
+            n->color = best;
+            n->moves++;
+            m_stats.moves++;
+        } else {
+            continue;
+        }
+
+        // the peers on the channel see a new color, and so do the peers of the peers
+        for (auto& e : n->edges) {
+            if ((m_nodes[e.peer].channel != n->channel) || (queued[e.peer] == true)) {
+                continue;
+            }
+            work.push_back(e.peer);
+            queued[e.peer] = true;
+        }
+    }
+
+    for (i = 0; i < m_nodes.size(); i++) {
+        if (m_nodes[i].color != before[i]) {
+            changed++;
+        }
+    }
+    m_stats.plans++;
+    m_stats.last_evaluated = evaluated;
+    pthread_mutex_unlock(&m_lock);
+
+    return changed;
+}
+
+bool em_color_planner_t::get_plan(const unsigned char *ruid, em_color_plan_t *plan)
+{
+    em_color_planner_node_t *n, *peer;
+    unsigned int bit;
+    bool found = false;
+
+    memset(plan, 0, sizeof(em_color_plan_t));
+
+    pthread_mutex_lock(&m_lock);
+    auto it = m_radios.find(em_hex::pack_mac(ruid));
+    if ((it != m_radios.end()) && (m_nodes[it->second].color != 0)) {
+        n = &m_nodes[it->second];
+        plan->color = n->color;
+        for (auto& e : n->edges) {
+            peer = &m_nodes[e.peer];
+            if ((peer->channel != n->channel) || (get_color(peer) == 0)) {
+                continue;
+            }
+            bit = get_color(peer);
+            plan->srg_color_bitmap[bit / 8] |= static_cast<unsigned char> (1 << (bit % 8));
+            for (auto bssid : peer->bss) {
+                unsigned char mac[EM_HEX_MAC_LEN];
+
+                em_hex::unpack_mac(bssid, mac);
+                bit = get_partial_bssid_bit(mac);
+                plan->srg_bssid_bitmap[bit / 8] |= static_cast<unsigned char> (1 << (bit % 8));
+            }
+            plan->srg_valid = true;
+        }
+        found = true;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return found;
+}
+
+unsigned int em_color_planner_t::get_collisions()
+{
+    unsigned int i, num = 0;
+
+    pthread_mutex_lock(&m_lock);
+    for (i = 0; i < m_nodes.size(); i++) {
+        for (auto& e : m_nodes[i].edges) {
+            if ((e.peer > i) && (m_nodes[e.peer].channel == m_nodes[i].channel) &&
+                    (get_color(&m_nodes[i]) != 0) && (get_color(&m_nodes[i]) == get_color(&m_nodes[e.peer]))) {
+                num++;
+            }
+        }
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+em_color_planner_stats_t em_color_planner_t::get_stats()
+{
+    em_color_planner_stats_t stats;
+
+    pthread_mutex_lock(&m_lock);
+    stats = m_stats;
+    pthread_mutex_unlock(&m_lock);
+
+    return stats;
+}
+
+em_color_planner_t::em_color_planner_t()
+{
+    pthread_mutex_init(&m_lock, NULL);
+    memset(&m_stats, 0, sizeof(em_color_planner_stats_t));
+}
+
+em_color_planner_t::~em_color_planner_t()
+{
+    pthread_mutex_destroy(&m_lock);
+}
@@ -0,0 +1,156 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "em_crypto_pool.h"
+#include "em_stack.h"
+#include "em_sched.h"
+
+void em_crypto_pool_t::run()
+{
+    em_crypto_job_t *job;
+
+    while (true) {
+        pthread_mutex_lock(&m_lock);
+        while ((m_head == NULL) && (m_exit == false)) {
+            pthread_cond_wait(&m_cond, &m_lock);
+        }
+        if (m_exit == true) {
+            pthread_mutex_unlock(&m_lock);
+            break;
+        }
+        job = m_head;
+        m_head = job->next;
+        m_tail = (m_head == NULL) ? NULL:m_tail;
+        m_queued--;
+        pthread_mutex_unlock(&m_lock);
+
+        job->next = NULL;
+        job->run(job);
+        // the owner may free the job as soon as it is handed back
+        job->done(job);
+    }
+}
+
+void *em_crypto_pool_t::worker_func(void *arg)
+{
+    int slot = em_stack_t::enter(em_stack_role_crypto, "crypto");
+
+    em_sched_t::apply(em_stack_role_crypto, "crypto");
+
+    static_cast<em_crypto_pool_t *>(arg)->run();
+    em_stack_t::leave(slot);
+    return NULL;
+}
+
+int em_crypto_pool_t::init(unsigned int num)
+{
+    pthread_attr_t attr;
+    long ncpu;
+    unsigned int i;
+
+    if ((ncpu = sysconf(_SC_NPROCESSORS_ONLN)) < 2) {
+        ncpu = 2;
+    }
+    // the rest of the CPUs is left to the workers running the ems
+    num = (num == 0) ? static_cast<unsigned int>(ncpu / 2):num;
+    num = (num > EM_CRYPTO_POOL_MAX_WORKERS) ? EM_CRYPTO_POOL_MAX_WORKERS:num;
+
+    m_exit = false;
+    for (i = 0; i < num; i++) {
+        pthread_attr_init(&attr);
+        em_stack_t::set_attr(&attr, em_stack_role_crypto);
+        if (pthread_create(&m_tids[i], &attr, em_crypto_pool_t::worker_func, this) != 0) {
+            printf("%s:%d: Failed to start crypto worker %d\n", __func__, __LINE__, i);
+            pthread_attr_destroy(&attr);
+            deinit();
+            return -1;
+        }
+        pthread_attr_destroy(&attr);
+        m_num++;
+    }
+
+    printf("%s:%d: Started %d crypto workers\n", __func__, __LINE__, m_num);
+
+    return 0;
+}
+
+void em_crypto_pool_t::deinit()
+{
+    em_crypto_job_t *job;
+    unsigned int i;
+
+    pthread_mutex_lock(&m_lock);
+    m_exit = true;
+    pthread_cond_broadcast(&m_cond);
+    pthread_mutex_unlock(&m_lock);
+
+    for (i = 0; i < m_num; i++) {
+        pthread_join(m_tids[i], NULL);
+    }
+    m_num = 0;
+
+    // the owners wait for every job they submitted, hand back the ones that never ran
+    while ((job = m_head) != NULL) {
+        m_head = job->next;
+        job->next = NULL;
+        job->result = -1;
+        job->done(job);
+    }
+    m_tail = NULL;
+    m_queued = 0;
+}
+
+int em_crypto_pool_t::submit(em_crypto_job_t *job)
+{
+    pthread_mutex_lock(&m_lock);
+    if ((m_num == 0) || (m_exit == true) || (m_queued >= EM_CRYPTO_POOL_QUEUE_SZ)) {
+        pthread_mutex_unlock(&m_lock);
+        return -1;
+    }
+
+    job->result = -1;
+    job->next = NULL;
+    if (m_tail == NULL) {
+        m_head = job;
+    } else {
+        m_tail->next = job;
+    }
+    m_tail = job;
+    m_queued++;
+    m_high_watermark = (m_queued > m_high_watermark) ? m_queued:m_high_watermark;
+    pthread_cond_signal(&m_cond);
+    pthread_mutex_unlock(&m_lock);
+
+    return 0;
+}
+
+em_crypto_pool_t::em_crypto_pool_t(): m_tids(), m_num(0), m_head(NULL), m_tail(NULL), m_queued(0), m_high_watermark(0), m_exit(false)
+{
+    pthread_mutex_init(&m_lock, NULL);
+    pthread_cond_init(&m_cond, NULL);
+}
+
+em_crypto_pool_t::~em_crypto_pool_t()
+{
+    deinit();
+    pthread_cond_destroy(&m_cond);
+    pthread_mutex_destroy(&m_lock);
+}
@@ -0,0 +1,174 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "em_event_pool.h"
+
+// a subdoc payload starts inside em_event_t, so the byte after it is still within a block of data_len bytes
+#define EM_EVENT_POOL_SUBDOC_OFFSET     offsetof(em_event_t, u.bevt.u.subdoc.buff)
+static_assert(EM_EVENT_POOL_SUBDOC_OFFSET < sizeof(em_event_t), "subdoc terminator beyond the block");
+
+unsigned int em_event_pool_t::class_data_size(em_event_pool_class_t cls)
+{
+    switch (cls) {
+        case em_event_pool_class_small:
+            return EM_EVENT_POOL_SMALL_DATA_SZ;
+
+        case em_event_pool_class_medium:
+            return EM_EVENT_POOL_MEDIUM_DATA_SZ;
+
+        default:
+            break;
+    }
+
+    return EM_EVENT_POOL_LARGE_DATA_SZ;
+}
+
+unsigned int em_event_pool_t::class_cache_size(em_event_pool_class_t cls)
+{
+    switch (cls) {
+        case em_event_pool_class_small:
+            return EM_EVENT_POOL_SMALL_CACHE;
+
+        case em_event_pool_class_medium:
+            return EM_EVENT_POOL_MEDIUM_CACHE;
+
+        default:
+            break;
+    }
+
+    return EM_EVENT_POOL_LARGE_CACHE;
+}
+
+unsigned int em_event_pool_t::get_event_data_len(em_event_t *evt)
+{
+    if (evt->type != em_event_type_bus) {
+        return 0;
+    }
+
+    return (evt->u.bevt.data_len > EM_MAX_EVENT_DATA_LEN) ? EM_MAX_EVENT_DATA_LEN:evt->u.bevt.data_len;
+}
+
+em_event_t *em_event_pool_t::alloc(unsigned int data_len)
+{
+    em_event_pool_blk_t *blk = NULL;
+    em_event_pool_class_t cls;
+    em_event_t *evt;
+
+    if (data_len > EM_MAX_EVENT_DATA_LEN) {
+        printf("%s:%d: event data length:%d exceeds max:%d\n", __func__, __LINE__, data_len, EM_MAX_EVENT_DATA_LEN);
+        return NULL;
+    }
+
+    if (data_len <= EM_EVENT_POOL_SMALL_DATA_SZ) {
+        cls = em_event_pool_class_small;
+    } else if (data_len <= EM_EVENT_POOL_MEDIUM_DATA_SZ) {
+        cls = em_event_pool_class_medium;
+    } else {
+        cls = em_event_pool_class_large;
+    }
+
+    pthread_mutex_lock(&m_lock);
+    m_stats[cls].alloc++;
+    if ((blk = m_free[cls]) != NULL) {
+        m_free[cls] = blk->next;
+        m_stats[cls].cached--;
+        m_stats[cls].hit++;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    if (blk == NULL) {
+        blk = static_cast<em_event_pool_blk_t *>(malloc(sizeof(em_event_pool_blk_t) + sizeof(em_event_t) + class_data_size(cls)));
+        if (blk == NULL) {
+            printf("%s:%d: failed to allocate event of class:%d\n", __func__, __LINE__, cls);
+            return NULL;
+        }
+        blk->cls = cls;
+    }
+
+    blk->next = NULL;
+    evt = reinterpret_cast<em_event_t *>(blk + 1);
+    memset(evt, 0, sizeof(em_event_t));
+    reinterpret_cast<unsigned char *>(evt)[EM_EVENT_POOL_SUBDOC_OFFSET + data_len] = 0;
+
+    return evt;
+}
+
+void em_event_pool_t::release(em_event_t *evt)
+{
+    em_event_pool_blk_t *blk;
+    em_event_pool_class_t cls;
+
+    if (evt == NULL) {
+        return;
+    }
+
+    blk = reinterpret_cast<em_event_pool_blk_t *>(evt) - 1;
+    cls = blk->cls;
+
+    pthread_mutex_lock(&m_lock);
+    if (m_stats[cls].cached < class_cache_size(cls)) {
+        blk->next = m_free[cls];
+        m_free[cls] = blk;
+        m_stats[cls].cached++;
+        blk = NULL;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    if (blk != NULL) {
+        free(blk);
+    }
+}
+
+void em_event_pool_t::dump_stats()
+{
+    unsigned int i;
+
+    pthread_mutex_lock(&m_lock);
+    for (i = 0; i < em_event_pool_class_max; i++) {
+        printf("%s:%d: class:%d data size:%d alloc:%d hit:%d cached:%d\n", __func__, __LINE__, i,
+                class_data_size(static_cast<em_event_pool_class_t>(i)), m_stats[i].alloc, m_stats[i].hit, m_stats[i].cached);
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+em_event_pool_t::em_event_pool_t()
+{
+    pthread_mutex_init(&m_lock, NULL);
+    memset(m_free, 0, sizeof(m_free));
+    memset(m_stats, 0, sizeof(m_stats));
+}
+
+em_event_pool_t::~em_event_pool_t()
+{
+    em_event_pool_blk_t *blk;
+    unsigned int i;
+
+    for (i = 0; i < em_event_pool_class_max; i++) {
+        while ((blk = m_free[i]) != NULL) {
+            m_free[i] = blk->next;
+            free(blk);
+        }
+    }
+
+    pthread_mutex_destroy(&m_lock);
+}
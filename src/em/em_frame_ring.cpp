@@ -0,0 +1,155 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <new>
+#include "em_frame_ring.h"
+
+int em_frame_ring_t::init(unsigned int num)
+{
+    unsigned int i;
+
+    m_buffs = new (std::nothrow) em_rx_buff_t[num];
+    m_slab = static_cast<unsigned char *>(malloc(num * EM_RX_BUFF_SZ));
+    if ((m_buffs == NULL) || (m_slab == NULL)) {
+        printf("%s:%d: Failed to allocate %d receive buffers\n", __func__, __LINE__, num);
+        deinit();
+        return -1;
+    }
+
+    m_num = num;
+    m_free = NULL;
+    for (i = 0; i < num; i++) {
+        m_buffs[i].ring = this;
+        m_buffs[i].ref = 0;
+        m_buffs[i].heap = false;
+        m_buffs[i].size = EM_RX_BUFF_SZ;
+        m_buffs[i].data = m_slab + (i * EM_RX_BUFF_SZ);
+        m_buffs[i].next = m_free;
+        m_free = &m_buffs[i];
+    }
+
+    return 0;
+}
+
+void em_frame_ring_t::deinit()
+{
+    if (m_in_use != 0) {
+        printf("%s:%d: %d receive buffers still in use\n", __func__, __LINE__, m_in_use);
+    }
+
+    delete[] m_buffs;
+    free(m_slab);
+    m_buffs = NULL;
+    m_slab = NULL;
+    m_free = NULL;
+    m_num = 0;
+}
+
+em_rx_buff_t *em_frame_ring_t::get(unsigned int len)
+{
+    em_rx_buff_t *buff = NULL;
+
+    pthread_mutex_lock(&m_lock);
+    if ((len <= EM_RX_BUFF_SZ) && ((buff = m_free) != NULL)) {
+        m_free = buff->next;
+    } else {
+        m_heap_allocs++;
+    }
+    m_in_use++;
+    m_high_watermark = (m_in_use > m_high_watermark) ? m_in_use:m_high_watermark;
+    pthread_mutex_unlock(&m_lock);
+
+    if (buff == NULL) {
+        // ring exhausted or oversized frame
+        buff = new (std::nothrow) em_rx_buff_t;
+        if ((buff == NULL) || ((buff->data = static_cast<unsigned char *>(malloc(len))) == NULL)) {
+            printf("%s:%d: Failed to allocate receive buffer of size:%d\n", __func__, __LINE__, len);
+            delete buff;
+            pthread_mutex_lock(&m_lock);
+            m_in_use--;
+            pthread_mutex_unlock(&m_lock);
+            return NULL;
+        }
+        buff->ring = this;
+        buff->heap = true;
+        buff->size = len;
+    }
+
+    buff->next = NULL;
+    buff->ref = 1;
+    memset(&buff->ts, 0, sizeof(buff->ts));
+
+    return buff;
+}
+
+em_event_t *em_frame_ring_t::to_event(em_rx_buff_t *buff, unsigned int len)
+{
+    buff->evt.type = em_event_type_frame;
+    buff->evt.u.fevt.frame = buff->data;
+    buff->evt.u.fevt.frame_len = len;
+
+    return &buff->evt;
+}
+
+em_rx_buff_t *em_frame_ring_t::from_event(em_event_t *evt)
+{
+    return reinterpret_cast<em_rx_buff_t *>(reinterpret_cast<unsigned char *>(evt) - offsetof(em_rx_buff_t, evt));
+}
+
+void em_frame_ring_t::put(em_rx_buff_t *buff)
+{
+    if (buff == NULL) {
+        return;
+    }
+
+    if (--buff->ref == 0) {
+        buff->ring->recycle(buff);
+    }
+}
+
+void em_frame_ring_t::recycle(em_rx_buff_t *buff)
+{
+    pthread_mutex_lock(&m_lock);
+    m_in_use--;
+    if (buff->heap == false) {
+        buff->next = m_free;
+        m_free = buff;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    if (buff->heap == true) {
+        free(buff->data);
+        delete buff;
+    }
+}
+
+em_frame_ring_t::em_frame_ring_t(): m_lock(), m_buffs(NULL), m_slab(NULL), m_free(NULL), m_num(0), m_in_use(0), m_high_watermark(0), m_heap_allocs(0)
+{
+    pthread_mutex_init(&m_lock, NULL);
+}
+
+em_frame_ring_t::~em_frame_ring_t()
+{
+    deinit();
+    pthread_mutex_destroy(&m_lock);
+}
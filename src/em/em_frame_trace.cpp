@@ -0,0 +1,234 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <linux/net_tstamp.h>
+#include "em_frame_trace.h"
+
+std::atomic<uint64_t> em_frame_trace_t::s_buckets[EM_MSG_TYPE_SLOTS][em_frame_stage_max][EM_LAT_HIST_BUCKETS];
+std::atomic<uint64_t> em_frame_trace_t::s_sum_us[EM_MSG_TYPE_SLOTS][em_frame_stage_max];
+std::atomic<uint64_t> em_frame_trace_t::s_max_us[EM_MSG_TYPE_SLOTS][em_frame_stage_max];
+std::atomic<uint64_t> em_frame_trace_t::s_slow_threshold_us(EM_FRAME_TRACE_SLOW_US);
+std::atomic<uint64_t> em_frame_trace_t::s_slow_frames(0);
+std::atomic<uint64_t> em_frame_trace_t::s_log_window_us(0);
+std::atomic<unsigned int> em_frame_trace_t::s_log_count(0);
+
+static const char *s_stage_str[em_frame_stage_max] = {
+    "Socket",
+    "Listener",
+    "Queue",
+    "Handler",
+    "Total",
+};
+
+int em_frame_trace_t::enable_rx_timestamps(int fd)
+{
+    int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    int on = 1;
+
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0) {
+        return 0;
+    }
+
+    return (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) == 0) ? 0:-1;
+}
+
+uint64_t em_frame_trace_t::get_rx_time_us(struct msghdr *msg, uint64_t now_us)
+{
+    struct cmsghdr *cmsg;
+    struct timespec ts = {0, 0}, real;
+    uint64_t rx_real_us, now_real_us;
+
+    for (cmsg = CMSG_FIRSTHDR(msg); cmsg != NULL; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET) {
+            continue;
+        }
+        // the software stamp is the first of the three of SO_TIMESTAMPING
+        if ((cmsg->cmsg_type == SO_TIMESTAMPING) || (cmsg->cmsg_type == SO_TIMESTAMPNS)) {
+            memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            break;
+        }
+    }
+
+    if ((ts.tv_sec == 0) && (ts.tv_nsec == 0)) {
+        return 0;
+    }
+
+    clock_gettime(CLOCK_REALTIME, &real);
+    rx_real_us = (static_cast<uint64_t>(ts.tv_sec) * 1000000) + (static_cast<uint64_t>(ts.tv_nsec) / 1000);
+    now_real_us = (static_cast<uint64_t>(real.tv_sec) * 1000000) + (static_cast<uint64_t>(real.tv_nsec) / 1000);
+
+    // a wall clock step between the receive and now makes the stamp useless
+    if ((rx_real_us > now_real_us) || ((now_real_us - rx_real_us) > now_us)) {
+        return 0;
+    }
+
+    return now_us - (now_real_us - rx_real_us);
+}
+
+void em_frame_trace_t::record_stage(unsigned int slot, em_frame_stage_t stage, uint64_t us)
+{
+    std::atomic<uint64_t> *max = &s_max_us[slot][stage];
+    uint64_t cur = max->load(std::memory_order_relaxed);
+
+    s_buckets[slot][stage][em_lat_hist_t::get_bucket_index(us)].fetch_add(1, std::memory_order_relaxed);
+    s_sum_us[slot][stage].fetch_add(us, std::memory_order_relaxed);
+    while ((us > cur) && (max->compare_exchange_weak(cur, us, std::memory_order_relaxed) == false));
+}
+
+void em_frame_trace_t::log_slow(unsigned int type, const uint64_t *stage_us, const bool *known)
+{
+    uint64_t now_us = em_lat_hist_t::get_time_us(), window = s_log_window_us.load(std::memory_order_relaxed);
+    char breakdown[160];
+    unsigned int i;
+    int len = 0;
+
+    if ((now_us - window) >= 1000000) {
+        if (s_log_window_us.compare_exchange_strong(window, now_us, std::memory_order_relaxed) == true) {
+            s_log_count.store(0, std::memory_order_relaxed);
+        }
+    }
+    if (s_log_count.fetch_add(1, std::memory_order_relaxed) >= EM_FRAME_TRACE_LOG_PER_SEC) {
+        return;
+    }
+
+    breakdown[0] = '\0';
+    for (i = 0; (i < em_frame_stage_max) && (len < static_cast<int>(sizeof(breakdown))); i++) {
+        if (known[i] == true) {
+            len += snprintf(&breakdown[len], sizeof(breakdown) - static_cast<size_t>(len), " %s:%lluus",
+                s_stage_str[i], static_cast<unsigned long long>(stage_us[i]));
+        } else {
+            len += snprintf(&breakdown[len], sizeof(breakdown) - static_cast<size_t>(len), " %s:-", s_stage_str[i]);
+        }
+    }
+    printf("%s:%d: Slow frame type:0x%04x%s\n", __func__, __LINE__, type, breakdown);
+}
+
+void em_frame_trace_t::record(unsigned int type, const em_frame_ts_t *ts, uint64_t start_us, uint64_t end_us)
+{
+    uint64_t stage_us[em_frame_stage_max] = {0};
+    bool known[em_frame_stage_max] = {false};
+    uint64_t first_us, threshold;
+    unsigned int slot = em_msg_t::get_type_slot(type), i;
+
+    // stamps of other threads may be a microsecond apart, never report a negative stage
+    if ((ts->rx_us != 0) && (ts->read_us != 0)) {
+        stage_us[em_frame_stage_socket] = (ts->read_us > ts->rx_us) ? (ts->read_us - ts->rx_us):0;
+        known[em_frame_stage_socket] = true;
+    }
+    if ((ts->read_us != 0) && (ts->queued_us != 0)) {
+        stage_us[em_frame_stage_listener] = (ts->queued_us > ts->read_us) ? (ts->queued_us - ts->read_us):0;
+        known[em_frame_stage_listener] = true;
+    }
+    if (ts->queued_us != 0) {
+        stage_us[em_frame_stage_queue] = (start_us > ts->queued_us) ? (start_us - ts->queued_us):0;
+        known[em_frame_stage_queue] = true;
+    }
+    stage_us[em_frame_stage_handler] = (end_us > start_us) ? (end_us - start_us):0;
+    known[em_frame_stage_handler] = true;
+
+    first_us = (ts->rx_us != 0) ? ts->rx_us:((ts->read_us != 0) ? ts->read_us:ts->queued_us);
+    if (first_us != 0) {
+        stage_us[em_frame_stage_total] = (end_us > first_us) ? (end_us - first_us):0;
+        known[em_frame_stage_total] = true;
+    }
+
+    for (i = 0; i < em_frame_stage_max; i++) {
+        if (known[i] == true) {
+            record_stage(slot, static_cast<em_frame_stage_t>(i), stage_us[i]);
+        }
+    }
+
+    threshold = s_slow_threshold_us.load(std::memory_order_relaxed);
+    i = (known[em_frame_stage_total] == true) ? em_frame_stage_total:em_frame_stage_handler;
+    if ((threshold != 0) && (stage_us[i] > threshold)) {
+        s_slow_frames.fetch_add(1, std::memory_order_relaxed);
+        log_slow(type, stage_us, known);
+    }
+}
+
+void em_frame_trace_t::get_hist(unsigned int type, em_frame_stage_t stage, em_lat_hist_t *out)
+{
+    get_slot_hist(em_msg_t::get_type_slot(type), stage, out);
+}
+
+void em_frame_trace_t::get_slot_hist(unsigned int slot, em_frame_stage_t stage, em_lat_hist_t *out)
+{
+    uint64_t buckets[EM_LAT_HIST_BUCKETS];
+    unsigned int i;
+
+    for (i = 0; i < EM_LAT_HIST_BUCKETS; i++) {
+        buckets[i] = s_buckets[slot][stage][i].load(std::memory_order_relaxed);
+    }
+    out->merge(buckets, s_sum_us[slot][stage].load(std::memory_order_relaxed),
+        s_max_us[slot][stage].load(std::memory_order_relaxed));
+}
+
+void em_frame_trace_t::encode(cJSON *obj)
+{
+    cJSON *types, *type_obj;
+    char name[8];
+    unsigned int slot, stage;
+
+    cJSON_AddNumberToObject(obj, "SlowThreshold", static_cast<double>(get_slow_threshold_us()));
+    cJSON_AddNumberToObject(obj, "SlowFrames", static_cast<double>(get_slow_frames()));
+    types = cJSON_AddObjectToObject(obj, "Types");
+    for (slot = 0; slot < EM_MSG_TYPE_SLOTS; slot++) {
+        // every handled frame has a handler sample
+        em_lat_hist_t handler;
+        get_slot_hist(slot, em_frame_stage_handler, &handler);
+        if (handler.get_count() == 0) {
+            continue;
+        }
+
+        if (slot == EM_MSG_TYPE_SLOT_OTHER) {
+            snprintf(name, sizeof(name), "Other");
+        } else {
+            snprintf(name, sizeof(name), "0x%04x", em_msg_t::get_slot_type(slot));
+        }
+        type_obj = cJSON_AddObjectToObject(types, name);
+        for (stage = 0; stage < em_frame_stage_max; stage++) {
+            em_lat_hist_t hist;
+            get_slot_hist(slot, static_cast<em_frame_stage_t>(stage), &hist);
+            hist.encode(cJSON_AddObjectToObject(type_obj, s_stage_str[stage]));
+        }
+    }
+}
+
+void em_frame_trace_t::reset()
+{
+    unsigned int i, j, k;
+
+    for (i = 0; i < EM_MSG_TYPE_SLOTS; i++) {
+        for (j = 0; j < em_frame_stage_max; j++) {
+            for (k = 0; k < EM_LAT_HIST_BUCKETS; k++) {
+                s_buckets[i][j][k].store(0, std::memory_order_relaxed);
+            }
+            s_sum_us[i][j].store(0, std::memory_order_relaxed);
+            s_max_us[i][j].store(0, std::memory_order_relaxed);
+        }
+    }
+    s_slow_frames.store(0, std::memory_order_relaxed);
+}
+
+const char *em_frame_trace_t::get_stage_str(em_frame_stage_t stage)
+{
+    return (stage < em_frame_stage_max) ? s_stage_str[stage]:"unknown";
+}
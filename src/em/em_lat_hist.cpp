@@ -0,0 +1,142 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include "em_lat_hist.h"
+
+void em_lat_hist_t::add(uint64_t us)
+{
+    m_buckets[get_bucket_index(us)]++;
+    m_count++;
+    m_sum_us += us;
+    m_max_us = (us > m_max_us) ? us:m_max_us;
+}
+
+void em_lat_hist_t::merge(const uint64_t *buckets, uint64_t sum_us, uint64_t max_us)
+{
+    unsigned int i;
+
+    for (i = 0; i < EM_LAT_HIST_BUCKETS; i++) {
+        m_buckets[i] += static_cast<unsigned int>(buckets[i]);
+        m_count += static_cast<unsigned int>(buckets[i]);
+    }
+    m_sum_us += sum_us;
+    m_max_us = (max_us > m_max_us) ? max_us:m_max_us;
+}
+
+void em_lat_hist_t::reset()
+{
+    memset(m_buckets, 0, sizeof(m_buckets));
+    m_count = 0;
+    m_sum_us = 0;
+    m_max_us = 0;
+}
+
+uint64_t em_lat_hist_t::get_percentile_us(unsigned int pct)
+{
+    uint64_t rank, seen = 0, limit;
+    unsigned int i;
+
+    if (m_count == 0) {
+        return 0;
+    }
+
+    pct = (pct > 100) ? 100:pct;
+    rank = (static_cast<uint64_t>(m_count) * pct + 99) / 100;
+    rank = (rank == 0) ? 1:rank;
+
+    for (i = 0; i < EM_LAT_HIST_BUCKETS; i++) {
+        seen += m_buckets[i];
+        if (seen >= rank) {
+            break;
+        }
+    }
+
+    limit = get_bucket_limit_us(i);
+
+    return (limit < m_max_us) ? limit:m_max_us;
+}
+
+void em_lat_hist_t::encode(cJSON *obj)
+{
+    cJSON *arr, *bucket;
+    unsigned int i;
+
+    cJSON_AddNumberToObject(obj, "Count", m_count);
+    cJSON_AddNumberToObject(obj, "MeanUs", static_cast<double>(get_mean_us()));
+    cJSON_AddNumberToObject(obj, "P50Us", static_cast<double>(get_percentile_us(50)));
+    cJSON_AddNumberToObject(obj, "P90Us", static_cast<double>(get_percentile_us(90)));
+    cJSON_AddNumberToObject(obj, "P99Us", static_cast<double>(get_percentile_us(99)));
+    cJSON_AddNumberToObject(obj, "MaxUs", static_cast<double>(m_max_us));
+
+    arr = cJSON_AddArrayToObject(obj, "Buckets");
+    for (i = 0; i < EM_LAT_HIST_BUCKETS; i++) {
+        if (m_buckets[i] == 0) {
+            continue;
+        }
+        bucket = cJSON_CreateObject();
+        // the open ended bucket is reported with a limit of 0
+        cJSON_AddNumberToObject(bucket, "LimitUs", (i == (EM_LAT_HIST_BUCKETS - 1)) ? 0:static_cast<double>(get_bucket_limit_us(i)));
+        cJSON_AddNumberToObject(bucket, "Count", m_buckets[i]);
+        cJSON_AddItemToArray(arr, bucket);
+    }
+}
+
+unsigned int em_lat_hist_t::get_bucket_index(uint64_t us)
+{
+    unsigned int idx;
+
+    if (us == 0) {
+        return 0;
+    }
+
+    idx = static_cast<unsigned int>(64 - __builtin_clzll(us));
+
+    return (idx < EM_LAT_HIST_BUCKETS) ? idx:(EM_LAT_HIST_BUCKETS - 1);
+}
+
+uint64_t em_lat_hist_t::get_bucket_limit_us(unsigned int idx)
+{
+    if (idx >= (EM_LAT_HIST_BUCKETS - 1)) {
+        return UINT64_MAX;
+    }
+
+    return static_cast<uint64_t>(1) << idx;
+}
+
+uint64_t em_lat_hist_t::get_time_us()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (static_cast<uint64_t>(ts.tv_sec) * 1000000) + static_cast<uint64_t>(ts.tv_nsec / 1000);
+}
+
+em_lat_hist_t::em_lat_hist_t(): m_count(0), m_sum_us(0), m_max_us(0)
+{
+    memset(m_buckets, 0, sizeof(m_buckets));
+}
+
+em_lat_hist_t::~em_lat_hist_t()
+{
+
+}
@@ -0,0 +1,201 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "em_mac_index.h"
+#include "em_hex.h"
+
+unsigned int em_mac_index_t::get_home(const unsigned char *mac) const
+{
+    uint64_t key = em_hex::pack_mac(mac);
+
+    // the OUI bytes carry little entropy, mix everything into the high bits
+    key *= 0x9e3779b97f4a7c15ULL;
+
+    return static_cast<unsigned int>(key >> 32) & m_mask;
+}
+
+int em_mac_index_t::grow()
+{
+    em_mac_index_entry_t *old = m_table, *table;
+    unsigned int old_sz = (old == NULL) ? 0:(m_mask + 1), sz, i;
+
+    sz = (old_sz == 0) ? EM_MAC_INDEX_MIN_SZ:(old_sz * 2);
+    if ((table = static_cast<em_mac_index_entry_t *>(calloc(sz, sizeof(em_mac_index_entry_t)))) == NULL) {
+        printf("%s:%d: Failed to allocate index of size:%d\n", __func__, __LINE__, sz);
+        return -1;
+    }
+
+    m_table = table;
+    m_mask = sz - 1;
+    m_count = 0;
+    for (i = 0; i < old_sz; i++) {
+        if (old[i].val != NULL) {
+            add(old[i].mac, old[i].val);
+        }
+    }
+    free(old);
+
+    return 0;
+}
+
+void em_mac_index_t::remove_at(unsigned int idx)
+{
+    unsigned int next, home;
+
+    m_table[idx].val = NULL;
+    m_count--;
+
+    // move back every entry of the run that may no longer be reachable from its home slot
+    for (next = (idx + 1) & m_mask; m_table[next].val != NULL; next = (next + 1) & m_mask) {
+        home = get_home(m_table[next].mac);
+        if (((next - home) & m_mask) >= ((next - idx) & m_mask)) {
+            m_table[idx] = m_table[next];
+            m_table[next].val = NULL;
+            idx = next;
+        }
+    }
+}
+
+int em_mac_index_t::add(const unsigned char *mac, void *val)
+{
+    unsigned int idx;
+
+    if (val == NULL) {
+        return -1;
+    }
+
+    if (((m_count + 1) * 2 > (m_mask + 1)) || (m_table == NULL)) {
+        if (grow() != 0) {
+            return -1;
+        }
+    }
+
+    for (idx = get_home(mac); m_table[idx].val != NULL; idx = (idx + 1) & m_mask) {
+        if ((m_table[idx].val == val) && (em_hex::mac_equal(m_table[idx].mac, mac))) {
+            return 0;
+        }
+    }
+
+    memcpy(m_table[idx].mac, mac, sizeof(mac_address_t));
+    m_table[idx].val = val;
+    m_count++;
+
+    return 0;
+}
+
+bool em_mac_index_t::remove(const unsigned char *mac, void *val)
+{
+    unsigned int idx;
+
+    if (m_table == NULL) {
+        return false;
+    }
+
+    for (idx = get_home(mac); m_table[idx].val != NULL; idx = (idx + 1) & m_mask) {
+        if ((m_table[idx].val == val) && (em_hex::mac_equal(m_table[idx].mac, mac))) {
+            remove_at(idx);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+unsigned int em_mac_index_t::remove_value(void *val)
+{
+    unsigned int idx, num = 0, prev;
+
+    if ((m_table == NULL) || (val == NULL)) {
+        return 0;
+    }
+
+    // a run wrapping around the end can shift a match behind the scan, rescan until nothing goes
+    do {
+        prev = num;
+        for (idx = 0; idx <= m_mask; ) {
+            if (m_table[idx].val == val) {
+                // the shift may have moved another match into this slot, look at it again
+                remove_at(idx);
+                num++;
+                continue;
+            }
+            idx++;
+        }
+    } while (num != prev);
+
+    return num;
+}
+
+void *em_mac_index_t::get(const unsigned char *mac) const
+{
+    unsigned int idx;
+
+    if (m_table == NULL) {
+        return NULL;
+    }
+
+    for (idx = get_home(mac); m_table[idx].val != NULL; idx = (idx + 1) & m_mask) {
+        if (em_hex::mac_equal(m_table[idx].mac, mac)) {
+            return m_table[idx].val;
+        }
+    }
+
+    return NULL;
+}
+
+unsigned int em_mac_index_t::get_all(const unsigned char *mac, void **vals, unsigned int max) const
+{
+    unsigned int idx, num = 0;
+
+    if (m_table == NULL) {
+        return 0;
+    }
+
+    for (idx = get_home(mac); m_table[idx].val != NULL; idx = (idx + 1) & m_mask) {
+        if (em_hex::mac_equal(m_table[idx].mac, mac)) {
+            if (num < max) {
+                vals[num] = m_table[idx].val;
+            }
+            num++;
+        }
+    }
+
+    return num;
+}
+
+void em_mac_index_t::clear()
+{
+    free(m_table);
+    m_table = NULL;
+    m_mask = 0;
+    m_count = 0;
+}
+
+em_mac_index_t::em_mac_index_t(): m_table(NULL), m_mask(0), m_count(0)
+{
+
+}
+
+em_mac_index_t::~em_mac_index_t()
+{
+    clear();
+}
@@ -0,0 +1,257 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "em_metrics_history.h"
+
+unsigned long long em_metrics_history_t::now_ms()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return static_cast<unsigned long long>(ts.tv_sec) * 1000 + static_cast<unsigned long long>(ts.tv_nsec / 1000000);
+}
+
+int em_metrics_history_t::grow()
+{
+    unsigned int sz = (m_size == 0) ? EM_METRICS_HISTORY_MIN_ROWS:(m_size * 2);
+    em_metrics_history_row_t *rows;
+
+    if ((rows = static_cast<em_metrics_history_row_t *>(realloc(m_rows, sz * sizeof(em_metrics_history_row_t)))) == NULL) {
+        printf("%s:%d: Failed to allocate %d rows\n", __func__, __LINE__, sz);
+        return -1;
+    }
+    m_rows = rows;
+    m_size = sz;
+
+    return 0;
+}
+
+em_metrics_history_row_t *em_metrics_history_t::find(const unsigned char *mac) const
+{
+    void *val;
+
+    if ((val = m_index.get(mac)) == NULL) {
+        return NULL;
+    }
+
+    return &m_rows[reinterpret_cast<uintptr_t>(val) - 1];
+}
+
+int em_metrics_history_t::append(const unsigned char *mac, const em_metrics_sample_t *sample)
+{
+    em_metrics_history_row_t *row;
+
+    pthread_rwlock_wrlock(&m_lock);
+
+    if ((row = find(mac)) == NULL) {
+        if ((m_num_rows == m_size) && (grow() != 0)) {
+            pthread_rwlock_unlock(&m_lock);
+            return -1;
+        }
+        if (m_index.add(mac, reinterpret_cast<void *>(static_cast<uintptr_t>(m_num_rows) + 1)) != 0) {
+            pthread_rwlock_unlock(&m_lock);
+            return -1;
+        }
+        row = &m_rows[m_num_rows];
+        m_num_rows++;
+        memcpy(row->mac, mac, sizeof(mac_address_t));
+        row->head = 0;
+        row->num = 0;
+        // the first sample starts the averages
+        row->ewma_rcpi = static_cast<long long>(sample->rcpi) << EM_METRICS_HISTORY_EWMA_FRAC;
+        row->ewma_ul_rate = static_cast<long long>(sample->ul_rate) << EM_METRICS_HISTORY_EWMA_FRAC;
+        row->ewma_dl_rate = static_cast<long long>(sample->dl_rate) << EM_METRICS_HISTORY_EWMA_FRAC;
+        row->ewma_util = static_cast<long long>(sample->util) << EM_METRICS_HISTORY_EWMA_FRAC;
+    } else {
+        row->ewma_rcpi += ((static_cast<long long>(sample->rcpi) << EM_METRICS_HISTORY_EWMA_FRAC) - row->ewma_rcpi) >> EM_METRICS_HISTORY_EWMA_SHIFT;
+        row->ewma_ul_rate += ((static_cast<long long>(sample->ul_rate) << EM_METRICS_HISTORY_EWMA_FRAC) - row->ewma_ul_rate) >> EM_METRICS_HISTORY_EWMA_SHIFT;
+        row->ewma_dl_rate += ((static_cast<long long>(sample->dl_rate) << EM_METRICS_HISTORY_EWMA_FRAC) - row->ewma_dl_rate) >> EM_METRICS_HISTORY_EWMA_SHIFT;
+        row->ewma_util += ((static_cast<long long>(sample->util) << EM_METRICS_HISTORY_EWMA_FRAC) - row->ewma_util) >> EM_METRICS_HISTORY_EWMA_SHIFT;
+    }
+
+    row->samples[row->head] = *sample;
+    row->head = (row->head + 1) & (EM_METRICS_HISTORY_LEN - 1);
+    if (row->num < EM_METRICS_HISTORY_LEN) {
+        row->num++;
+    }
+
+    pthread_rwlock_unlock(&m_lock);
+
+    return 0;
+}
+
+bool em_metrics_history_t::get_aggregate(const unsigned char *mac, unsigned int window_ms, unsigned long long now, em_metrics_aggregate_t *agg)
+{
+    em_metrics_history_row_t *row;
+    const em_metrics_sample_t *s;
+    unsigned long long oldest;
+    unsigned int i, idx;
+
+    pthread_rwlock_rdlock(&m_lock);
+
+    if ((row = find(mac)) == NULL) {
+        pthread_rwlock_unlock(&m_lock);
+        return false;
+    }
+
+    memset(agg, 0, sizeof(em_metrics_aggregate_t));
+    agg->ewma.rcpi = static_cast<unsigned char>(row->ewma_rcpi >> EM_METRICS_HISTORY_EWMA_FRAC);
+    agg->ewma.ul_rate = static_cast<unsigned int>(row->ewma_ul_rate >> EM_METRICS_HISTORY_EWMA_FRAC);
+    agg->ewma.dl_rate = static_cast<unsigned int>(row->ewma_dl_rate >> EM_METRICS_HISTORY_EWMA_FRAC);
+    agg->ewma.util = static_cast<unsigned int>(row->ewma_util >> EM_METRICS_HISTORY_EWMA_FRAC);
+
+    // newest first, the scan stops at the first sample out of the window
+    oldest = ((window_ms == 0) || (now < window_ms)) ? 0:(now - window_ms);
+    for (i = 0; i < row->num; i++) {
+        idx = (row->head - 1 - i) & (EM_METRICS_HISTORY_LEN - 1);
+        s = &row->samples[idx];
+        if (s->time_ms < oldest) {
+            break;
+        }
+        if (agg->num == 0) {
+            agg->min = *s;
+            agg->max = *s;
+            agg->ewma.time_ms = s->time_ms;
+        } else {
+            agg->min.time_ms = s->time_ms;
+            agg->min.rcpi = (s->rcpi < agg->min.rcpi) ? s->rcpi:agg->min.rcpi;
+            agg->min.ul_rate = (s->ul_rate < agg->min.ul_rate) ? s->ul_rate:agg->min.ul_rate;
+            agg->min.dl_rate = (s->dl_rate < agg->min.dl_rate) ? s->dl_rate:agg->min.dl_rate;
+            agg->min.util = (s->util < agg->min.util) ? s->util:agg->min.util;
+            agg->max.rcpi = (s->rcpi > agg->max.rcpi) ? s->rcpi:agg->max.rcpi;
+            agg->max.ul_rate = (s->ul_rate > agg->max.ul_rate) ? s->ul_rate:agg->max.ul_rate;
+            agg->max.dl_rate = (s->dl_rate > agg->max.dl_rate) ? s->dl_rate:agg->max.dl_rate;
+            agg->max.util = (s->util > agg->max.util) ? s->util:agg->max.util;
+        }
+        agg->num++;
+    }
+
+    pthread_rwlock_unlock(&m_lock);
+
+    return true;
+}
+
+unsigned int em_metrics_history_t::get_samples(const unsigned char *mac, em_metrics_sample_t *samples, unsigned int max)
+{
+    em_metrics_history_row_t *row;
+    unsigned int i, num;
+
+    pthread_rwlock_rdlock(&m_lock);
+
+    if ((row = find(mac)) == NULL) {
+        pthread_rwlock_unlock(&m_lock);
+        return 0;
+    }
+
+    num = (row->num < max) ? row->num:max;
+    for (i = 0; i < num; i++) {
+        samples[i] = row->samples[(row->head - num + i) & (EM_METRICS_HISTORY_LEN - 1)];
+    }
+
+    pthread_rwlock_unlock(&m_lock);
+
+    return num;
+}
+
+unsigned int em_metrics_history_t::find_weak(unsigned char rcpi_thresh, unsigned int min_samples, mac_address_t *macs, unsigned int max)
+{
+    long long thresh = static_cast<long long>(rcpi_thresh) << EM_METRICS_HISTORY_EWMA_FRAC;
+    unsigned int i, num = 0;
+
+    pthread_rwlock_rdlock(&m_lock);
+
+    for (i = 0; (i < m_num_rows) && (num < max); i++) {
+        if ((m_rows[i].num >= min_samples) && (m_rows[i].ewma_rcpi < thresh)) {
+            memcpy(macs[num], m_rows[i].mac, sizeof(mac_address_t));
+            num++;
+        }
+    }
+
+    pthread_rwlock_unlock(&m_lock);
+
+    return num;
+}
+
+bool em_metrics_history_t::remove(const unsigned char *mac)
+{
+    unsigned int row, last;
+    void *val;
+
+    pthread_rwlock_wrlock(&m_lock);
+
+    if ((val = m_index.get(mac)) == NULL) {
+        pthread_rwlock_unlock(&m_lock);
+        return false;
+    }
+    row = static_cast<unsigned int>(reinterpret_cast<uintptr_t>(val) - 1);
+    m_index.remove(mac, val);
+
+    // keep the rows dense, the last row takes the place of the removed one
+    last = m_num_rows - 1;
+    if (row != last) {
+        m_index.remove(m_rows[last].mac, reinterpret_cast<void *>(static_cast<uintptr_t>(last) + 1));
+        m_index.add(m_rows[last].mac, val);
+        m_rows[row] = m_rows[last];
+    }
+    m_num_rows--;
+
+    pthread_rwlock_unlock(&m_lock);
+
+    return true;
+}
+
+unsigned int em_metrics_history_t::count()
+{
+    unsigned int num;
+
+    pthread_rwlock_rdlock(&m_lock);
+    num = m_num_rows;
+    pthread_rwlock_unlock(&m_lock);
+
+    return num;
+}
+
+void em_metrics_history_t::clear()
+{
+    pthread_rwlock_wrlock(&m_lock);
+
+    free(m_rows);
+    m_rows = NULL;
+    m_num_rows = 0;
+    m_size = 0;
+    m_index.clear();
+
+    pthread_rwlock_unlock(&m_lock);
+}
+
+em_metrics_history_t::em_metrics_history_t(): m_rows(NULL), m_num_rows(0), m_size(0)
+{
+    pthread_rwlock_init(&m_lock, NULL);
+}
+
+em_metrics_history_t::~em_metrics_history_t()
+{
+    clear();
+    pthread_rwlock_destroy(&m_lock);
+}
@@ -37,6 +37,10 @@
 #include <unistd.h>
 #include <pthread.h>
 #include <assert.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <algorithm>
 #include <openssl/bio.h> /* BasicInput/Output streams */
 #include <openssl/err.h> /* errors */
 #include <openssl/ssl.h> /* core library */
@@ -44,6 +48,10 @@
 #include "em_mgr.h"
 #include "em_msg.h"
 #include "em_cmd.h"
+#include "em_perf.h"
+#include "em_stack.h"
+#include "em_sched.h"
+#include "em_startup_prof.h"
 #include "util.h"
 
 #ifdef AL_SAP
@@ -57,7 +65,10 @@ void em_mgr_t::io_process(em_bus_event_type_t type, char *data, unsigned int len
     em_event_t *evt;
     em_bus_event_t *bevt;
 
-    evt = static_cast<em_event_t *>(malloc(sizeof(em_event_t) + EM_MAX_EVENT_DATA_LEN));
+    if ((evt = m_event_pool.alloc(len)) == NULL) {
+        printf("%s:%d: Failed to allocate event type:%d len:%d\n", __func__, __LINE__, type, len);
+        return;
+    }
     evt->type = em_event_type_bus;
     bevt = &evt->u.bevt;
     bevt->type = type;
@@ -79,7 +90,10 @@ void em_mgr_t::io_process(em_bus_event_type_t type, unsigned char *data, unsigne
     em_event_t *evt;
     em_bus_event_t *bevt;
 
-    evt = static_cast<em_event_t *>(malloc(sizeof(em_event_t) + EM_MAX_EVENT_DATA_LEN));
+    if ((evt = m_event_pool.alloc(len)) == NULL) {
+        printf("%s:%d: Failed to allocate event type:%d len:%d\n", __func__, __LINE__, type, len);
+        return;
+    }
     evt->type = em_event_type_bus;
     bevt = &evt->u.bevt;
     bevt->type = type;
@@ -96,54 +110,143 @@ void em_mgr_t::io_process(em_bus_event_type_t type, unsigned char *data, unsigne
     push_to_queue(evt);
 }
 
-bool em_mgr_t::io_process(em_event_t *evt)
+em_event_t *em_mgr_t::copy_event(em_event_t *evt)
 {
     em_event_t *e;
-    em_bus_event_t *bevt;
-    bool should_wait;
+    unsigned int data_len;
 
-    bevt = &evt->u.bevt;
-    //em_cmd_t::dump_bus_event(bevt);
+    // copy only the payload that is actually carried by the event
+    data_len = em_event_pool_t::get_event_data_len(evt);
+    if ((e = m_event_pool.alloc(data_len)) == NULL) {
+        printf("%s:%d: Failed to allocate event len:%d\n", __func__, __LINE__, data_len);
+        return NULL;
+    }
+    memcpy(reinterpret_cast<unsigned char *>(e), reinterpret_cast<unsigned char *>(evt), sizeof(em_event_t) + data_len);
+    if (e->type == em_event_type_bus) {
+        e->u.bevt.data_len = data_len;
+    }
 
-    e = static_cast<em_event_t *>(malloc(sizeof(em_event_t) + EM_MAX_EVENT_DATA_LEN));
-    memcpy(reinterpret_cast<unsigned char *>(e), reinterpret_cast<unsigned char *>(evt), sizeof(em_event_t) + EM_MAX_EVENT_DATA_LEN);
+    return e;
+}
+
+bool em_mgr_t::is_result_deferred(em_event_t *evt)
+{
+    // the handlers of the bus events answer the command, a commit has nobody to answer
+    return (evt->type == em_event_type_bus) && (evt->u.bevt.type != em_bus_event_type_dm_commit);
+}
+
+bool em_mgr_t::io_process(em_event_t *evt)
+{
+    em_event_t *e;
+
+    //em_cmd_t::dump_bus_event(&evt->u.bevt);
+    if ((e = copy_event(evt)) == NULL) {
+        return false;
+    }
 
     push_to_queue(e);
 
     // check if the server should wait
-    should_wait = false;
+    return is_result_deferred(evt);
+}
 
-    switch (evt->type) {
-        case em_event_type_bus:
-            bevt = &evt->u.bevt;
-            if (bevt->type != em_bus_event_type_dm_commit) {
-                should_wait = true;
-            }
-            break;
+void em_mgr_t::proto_process(unsigned char *data, unsigned int len, em_t *al_em)
+{
+    em_rx_buff_t *buff;
 
-        default:
-            break;
+    if ((buff = m_rx_ring.get(len)) == NULL) {
+        return;
     }
 
-    return should_wait;
+    memcpy(buff->data, data, len);
+    buff->ts.read_us = em_lat_hist_t::get_time_us();
+    proto_process(buff, len, al_em);
 }
 
-void em_mgr_t::proto_process(unsigned char *data, unsigned int len, em_t *al_em)
+void em_mgr_t::proto_process(em_rx_buff_t *buff, unsigned int len, em_t *al_em)
+{
+    // fragments are captured as received, so that a replay goes through reassembly again
+    if ((em_capture_t::is_active() == true) && (al_em != NULL)) {
+        al_em->capture_frame(em_capture_dir_rx, buff->data, len);
+    }
+
+    // the shard owning the source reassembles and routes, in the order the frames were read
+    if ((m_rx_shards.get_num_shards() != 0) && (len >= sizeof(em_raw_hdr_t))) {
+        m_rx_shards.dispatch(buff, len, al_em);
+        return;
+    }
+
+    route_frame(&m_reasm, m_msg_stats, buff, len, al_em);
+}
+
+void em_mgr_t::route_frame(em_cmdu_reasm_t *reasm, em_msg_type_stats_t *stats, em_rx_buff_t *buff, unsigned int len, em_t *al_em)
 {
-    em_event_t	*evt;
     em_t *em = NULL;
+    em_msg_type_stats_t *type_stats = &stats[EM_MSG_TYPE_SLOT_OTHER];
+    em_frame_ts_t ts = buff->ts;
+
+    // fragments are held back until the message is complete
+    if ((buff = reasm->add(buff, &len, em_lat_hist_t::get_time_us())) == NULL) {
+        return;
+    }
+    // a reassembled message is traced from its last fragment
+    buff->ts = ts;
 
-	em = find_em_for_msg_type(data, len, al_em);
+    if (len >= (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))) {
+        type_stats = &stats[em_msg_t::get_type_slot(htons(reinterpret_cast<em_cmdu_t *>(buff->data + sizeof(em_raw_hdr_t))->type))];
+    }
+    type_stats->rx++;
+
+    pthread_mutex_lock(&m_route_lock);
+	em = find_em_for_msg_type(buff->data, len, al_em);
+    pthread_mutex_unlock(&m_route_lock);
 	if (em == NULL) {
+        type_stats->drops++;
+        em_frame_ring_t::put(buff);
 		return;
 	}
 
-    evt = static_cast<em_event_t *>(malloc(sizeof(em_event_t)));
-    evt->type = em_event_type_frame;
-    evt->u.fevt.frame = static_cast<unsigned char *>(malloc(len));
-    memcpy(evt->u.fevt.frame, data, len);
-    evt->u.fevt.frame_len = len;
+    // the buffer is owned by the target queue until em_t releases the event
+    buff->ts.queued_us = em_lat_hist_t::get_time_us();
+    em->push_to_queue(em_frame_ring_t::to_event(buff, len));
+}
+
+void em_mgr_t::rx_shard_route(void *ctx, em_rx_shard_t *shard, em_rx_buff_t *buff, unsigned int len, void *src)
+{
+    static_cast<em_mgr_t *>(ctx)->route_frame(&shard->reasm, shard->msg_stats, buff, len, static_cast<em_t *>(src));
+}
+
+void em_mgr_t::get_msg_stats(em_msg_type_t type, em_msg_type_stats_t *stats)
+{
+    unsigned int slot = em_msg_t::get_type_slot(type), i;
+
+    *stats = m_msg_stats[slot];
+    for (i = 0; i < m_rx_shards.get_num_shards(); i++) {
+        stats->rx += m_rx_shards.get_shard(i)->msg_stats[slot].rx;
+        stats->drops += m_rx_shards.get_shard(i)->msg_stats[slot].drops;
+    }
+}
+
+void em_mgr_t::free_frame_event(em_event_t *evt)
+{
+    em_frame_ring_t::put(em_frame_ring_t::from_event(evt));
+}
+
+bool em_mgr_t::push_node_action_frame(em_t *em, const unsigned char *frame, unsigned int len)
+{
+    em_rx_buff_t *buff;
+    em_event_t *evt;
+
+    if ((buff = m_rx_ring.get(len)) == NULL) {
+        return false;
+    }
+    memcpy(buff->data, frame, len);
+
+    evt = em_frame_ring_t::to_event(buff, len);
+    evt->type = em_event_type_action;
     em->push_to_queue(evt);
+
+    return true;
 }
 
 void em_mgr_t::delete_nodes()
@@ -173,8 +276,10 @@ void em_mgr_t::delete_node(em_interface_t *ruid)
         return;
     }
 
+    unregister_listener(em);
     em->stop();
     em->deinit();
+    unindex_node(em);
 	pthread_mutex_lock(&m_mutex);
 	hash_map_remove(m_em_map, mac_str);
 	pthread_mutex_unlock(&m_mutex);
@@ -221,6 +326,11 @@ em_t *em_mgr_t::create_node(em_interface_t *ruid, em_freq_band_t band, dm_easy_m
 	pthread_mutex_lock(&m_mutex);
     hash_map_put(m_em_map, strdup(mac_str), em);
 	pthread_mutex_unlock(&m_mutex);
+    index_node(em);
+
+    if (register_listener(em) != 0) {
+        printf("%s:%d: Failed to register listener for key:%s\n", __func__, __LINE__, mac_str);
+    }
     printf("%s:%d: created entry for key:%s\n", __func__, __LINE__, mac_str);
 
     return em;
@@ -248,6 +358,13 @@ em_t *em_mgr_t::get_al_node()
     em_t *em;
     bool found = false;
 
+    pthread_rwlock_rdlock(&m_index_lock);
+    em = m_al_node;
+    pthread_rwlock_unlock(&m_index_lock);
+    if (em != NULL) {
+        return em;
+    }
+
     em = static_cast<em_t *>(hash_map_get_first(m_em_map));
     while (em != NULL) {
         if (em->is_al_interface_em() == true) {
@@ -267,13 +384,10 @@ em_t *em_mgr_t::get_phy_al_node()
     if (al_node == NULL) return NULL;
     uint8_t* al_mac = al_node->get_radio_interface_mac();
 
-    // al_mac_str is the real MAC (no "_al" suffix)
-    // al_mac_str will be the key for the real `em_t` in the `m_em_map`
-    char al_mac_str[EM_MAC_STR_LEN+1] = {0};
-    dm_easy_mesh_t::macbytes_to_string(al_mac, al_mac_str);
-    em_t *phy_al_em = reinterpret_cast<em_t *>(hash_map_get(m_em_map, al_mac_str));
+    // the real `em_t` is indexed by the real MAC, the one without the "_al" suffix
+    em_t *phy_al_em = get_node_by_ruid(al_mac);
     if (phy_al_em == NULL) {
-        printf("%s:%d: Can not find phy al node with key:%s\n", __func__, __LINE__, al_mac_str);
+        printf("%s:%d: Can not find phy al node with mac:" MACSTRFMT "\n", __func__, __LINE__, MAC2STR(al_mac));
         return NULL;
     }
     return phy_al_em;
@@ -281,54 +395,178 @@ em_t *em_mgr_t::get_phy_al_node()
 
 void em_mgr_t::get_all_em_for_al_mac(mac_address_t mac, std::vector<em_t*> &em_radios)
 {
-    em_t* em = static_cast<em_t *>(hash_map_get_first(m_em_map));
-    std::string mac_str = util::mac_to_string(mac);
-    //em_printfout("*****al_mac:%s******", util::mac_to_string(mac).c_str());
+    std::vector<void *> vals(EM_MAX_RADIO_PER_AGENT + 1);
+    unsigned int num, i;
+    em_t *em;
+
+    pthread_rwlock_rdlock(&m_index_lock);
+    if ((num = m_al_index.get_all(mac, vals.data(), static_cast<unsigned int>(vals.size()))) > vals.size()) {
+        vals.resize(num);
+        num = m_al_index.get_all(mac, vals.data(), num);
+    }
+    pthread_rwlock_unlock(&m_index_lock);
+
+    for (i = 0; i < num; i++) {
+        em = static_cast<em_t *>(vals[i]);
+        // the data model may have learnt its AL MAC after the node was indexed
+        if (memcmp(em->get_data_model()->get_device()->get_dev_interface_mac(), mac, MAC_ADDR_LEN) == 0) {
+            em_radios.push_back(em);
+        }
+    }
+
+    if (em_radios.empty() == false) {
+        return;
+    }
+
+    em = static_cast<em_t *>(hash_map_get_first(m_em_map));
     while (em != NULL) {
         dm_easy_mesh_t* dm = em->get_data_model();
         unsigned char* al_mac = dm->get_device()->get_dev_interface_mac();
         if (!(em->is_al_interface_em()) && (memcmp(al_mac, mac, MAC_ADDR_LEN) == 0)) {
             em_radios.push_back(em);
-            //em_printfout("Added em with radio_mac:%s",
-            //    util::mac_to_string(em->get_radio_interface_mac()).c_str());
         }
         em = static_cast<em_t*>(hash_map_get_next(m_em_map, em));
     }
-    //em_printfout("******end*******");
+
+    if (em_radios.empty() == false) {
+        pthread_rwlock_wrlock(&m_index_lock);
+        for (i = 0; i < em_radios.size(); i++) {
+            m_al_index.add(mac, em_radios[i]);
+        }
+        pthread_rwlock_unlock(&m_index_lock);
+    }
 }
 
+em_t *em_mgr_t::get_node_by_ruid(const unsigned char *ruid)
+{
+    em_t *em;
 
-void *em_mgr_t::mgr_input_listen(void *arg)
+    pthread_rwlock_rdlock(&m_index_lock);
+    em = static_cast<em_t *>(m_ruid_index.get(ruid));
+    pthread_rwlock_unlock(&m_index_lock);
+
+    return em;
+}
+
+em_t *em_mgr_t::get_al_node_by_mac(const unsigned char *al_mac)
 {
-    size_t stack_size2;
-    pthread_attr_t attr;
+    em_t *em;
 
-    pthread_attr_init(&attr);
-    pthread_attr_getstacksize(&attr, &stack_size2);
-    pthread_attr_destroy(&attr);
-    printf("%s:%d Thread stack size = %ld bytes \n", __func__, __LINE__, stack_size2);
+    pthread_rwlock_rdlock(&m_index_lock);
+    em = static_cast<em_t *>(m_al_node_index.get(al_mac));
+    pthread_rwlock_unlock(&m_index_lock);
+
+    return em;
+}
+
+bool em_mgr_t::is_bss_of_node(em_t *em, const unsigned char *bssid)
+{
+    dm_easy_mesh_t *dm = em->get_data_model();
+
+    return (dm != NULL) && (dm->get_bss(em->get_radio_interface_mac(), const_cast<unsigned char *> (bssid)) != NULL);
+}
+
+em_t *em_mgr_t::get_node_by_bssid(const unsigned char *bssid)
+{
+    em_t *em;
+
+    pthread_rwlock_rdlock(&m_index_lock);
+    em = static_cast<em_t *>(m_bss_index.get(bssid));
+    pthread_rwlock_unlock(&m_index_lock);
+
+    if ((em != NULL) && (is_bss_of_node(em, bssid) == true)) {
+        return em;
+    }
+
+    // the BSS moved or was never looked up, find its radio and remember it
+    em = static_cast<em_t *>(hash_map_get_first(m_em_map));
+    while (em != NULL) {
+        if ((em->is_al_interface_em() == false) && (is_bss_of_node(em, bssid) == true)) {
+            break;
+        }
+        em = static_cast<em_t *>(hash_map_get_next(m_em_map, em));
+    }
+
+    pthread_rwlock_wrlock(&m_index_lock);
+    while (m_bss_index.get(bssid) != NULL) {
+        m_bss_index.remove(bssid, m_bss_index.get(bssid));
+    }
+    if (em != NULL) {
+        m_bss_index.add(bssid, em);
+    }
+    pthread_rwlock_unlock(&m_index_lock);
+
+    return em;
+}
+
+void em_mgr_t::get_radio_nodes(std::vector<em_t *> &nodes)
+{
+    pthread_rwlock_rdlock(&m_index_lock);
+    nodes.insert(nodes.end(), m_radio_nodes.begin(), m_radio_nodes.end());
+    pthread_rwlock_unlock(&m_index_lock);
+}
+
+void em_mgr_t::get_al_nodes(std::vector<em_t *> &nodes)
+{
+    pthread_rwlock_rdlock(&m_index_lock);
+    nodes.insert(nodes.end(), m_al_nodes.begin(), m_al_nodes.end());
+    pthread_rwlock_unlock(&m_index_lock);
+}
+
+void em_mgr_t::index_node(em_t *em)
+{
+    dm_easy_mesh_t *dm = em->get_data_model();
+
+    pthread_rwlock_wrlock(&m_index_lock);
+    if (em->is_al_interface_em() == true) {
+        m_al_node_index.add(em->get_radio_interface_mac(), em);
+        m_al_node = (m_al_node == NULL) ? em:m_al_node;
+        m_al_nodes.push_back(em);
+    } else {
+        m_ruid_index.add(em->get_radio_interface_mac(), em);
+        m_radio_nodes.push_back(em);
+        if (dm != NULL) {
+            m_al_index.add(dm->get_device()->get_dev_interface_mac(), em);
+        }
+    }
+    pthread_rwlock_unlock(&m_index_lock);
+}
+
+void em_mgr_t::unindex_node(em_t *em)
+{
+    pthread_rwlock_wrlock(&m_index_lock);
+    m_ruid_index.remove_value(em);
+    m_al_index.remove_value(em);
+    m_al_node_index.remove_value(em);
+    m_bss_index.remove_value(em);
+    m_radio_nodes.erase(std::remove(m_radio_nodes.begin(), m_radio_nodes.end(), em), m_radio_nodes.end());
+    m_al_nodes.erase(std::remove(m_al_nodes.begin(), m_al_nodes.end(), em), m_al_nodes.end());
+    if (m_al_node == em) {
+        // get_al_node() falls back to the node map until the next AL node is indexed
+        m_al_node = NULL;
+    }
+    pthread_rwlock_unlock(&m_index_lock);
+}
+
+void *em_mgr_t::mgr_input_listen(void *arg)
+{
     em_mgr_t *mgr = static_cast<em_mgr_t *>(arg);
+    int slot = em_stack_t::enter(em_stack_role_listener, "input");
+
+    em_sched_t::apply(em_stack_role_listener, "input");
 
     mgr->input_listener();
+    em_stack_t::leave(slot);
     return NULL;
 }
 
 int em_mgr_t::input_listen()
 {
-    size_t stack_size = 0x800000; /* 8MB */
     pthread_attr_t attr;
     pthread_attr_t *attrp = NULL;
-    int ret = 0;
     attrp = &attr;
     pthread_attr_init(&attr);
-    // Setting explicitly stacksize as in few platforms(e.g. openwrt) if not called, the
-    // new thread will inherit the default stack size which is significantly less
-    // leading to stack overflow.
-    ret = pthread_attr_setstacksize(&attr, stack_size);
-    if (ret != 0) {
-        printf("%s:%d pthread_attr_setstacksize failed for size:%ld ret:%d\n",
-                __func__, __LINE__, stack_size, ret);
-    }
+    em_stack_t::set_attr(&attr, em_stack_role_listener);
     pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
 
     if (pthread_create(&m_tid, attrp, em_mgr_t::mgr_input_listen, this) != 0) {
@@ -367,18 +605,274 @@ int em_mgr_t::reset_listeners()
 
 }
 
+int em_mgr_t::register_listener(em_t *em)
+{
+    struct epoll_event ev;
+
+    if ((m_epoll_fd < 0) || (em->is_al_interface_em() == false) || (em->get_fd() < 0)) {
+        return 0;
+    }
+
+    memset(&ev, 0, sizeof(struct epoll_event));
+    ev.data.ptr = em;
+#ifdef AL_SAP
+    // The SAP indication reads without blocking until the socket is drained, the descriptor
+    // stays blocking for the sends on it, so keep it level triggered
+    ev.events = EPOLLIN;
+#else
+    // Edge triggered, the listener drains the socket until EAGAIN
+    int flags = fcntl(em->get_fd(), F_GETFL, 0);
+    if ((flags < 0) || (fcntl(em->get_fd(), F_SETFL, flags | O_NONBLOCK) < 0)) {
+        printf("%s:%d: Failed to set non blocking mode on fd:%d, err:%d\n", __func__, __LINE__, em->get_fd(), errno);
+        return -1;
+    }
+    ev.events = EPOLLIN | EPOLLET;
+#endif
+
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, em->get_fd(), &ev) < 0) {
+        printf("%s:%d: Failed to register fd:%d, err:%d\n", __func__, __LINE__, em->get_fd(), errno);
+        return -1;
+    }
+
+    return 0;
+}
+
+void em_mgr_t::wake_listener()
+{
+    uint64_t val = 1;
+
+    if (m_wakeup_fd < 0) {
+        return;
+    }
+
+    if (write(m_wakeup_fd, &val, sizeof(val)) < 0) {
+        printf("%s:%d: Failed to wake up listener, err:%d\n", __func__, __LINE__, errno);
+    }
+}
+
+void em_mgr_t::unregister_listener(em_t *em)
+{
+    unsigned long long gen;
+    int i;
+
+    if ((m_epoll_fd < 0) || (em->is_al_interface_em() == false) || (em->get_fd() < 0)) {
+        return;
+    }
+
+    epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, em->get_fd(), NULL);
+
+    pthread_mutex_lock(&m_listener_lock);
+    if (m_listener_running == false) {
+        pthread_mutex_unlock(&m_listener_lock);
+        return;
+    }
+
+    if (pthread_equal(pthread_self(), m_listener_tid)) {
+        // the rest of the current batch may still hold the node, skip it there
+        for (i = 0; i < m_listener_batch_num; i++) {
+            if (m_listener_batch[i].data.ptr == em) {
+                m_listener_batch[i].data.ptr = &m_listener_gen;
+            }
+        }
+        pthread_mutex_unlock(&m_listener_lock);
+        return;
+    }
+
+    // the batch the listener is in may have been returned before the removal, wait for
+    // it to end, the next epoll_wait() no longer reports the fd
+    gen = m_listener_gen;
+    wake_listener();
+    while ((m_listener_running == true) && (m_listener_gen == gen)) {
+        pthread_cond_wait(&m_listener_cond, &m_listener_lock);
+    }
+    pthread_mutex_unlock(&m_listener_lock);
+}
+
+bool em_mgr_t::read_al_node(em_t *em)
+{
+#ifdef AL_SAP
+    MacAddress first_mac, second_mac;
+    unsigned char *frame;
+    size_t len;
+
+    try {
+        // Reassembled in place behind room for the Ethernet header, nullptr once the socket is drained
+        frame = g_sap->serviceAccessPointDataIndication(sizeof(em_raw_hdr_t), len, first_mac, second_mac);
+        if (frame == nullptr) {
+            return false;
+        }
+    } catch (const AlServiceException& e) {
+        if ((e.getPrimitiveError() == PrimitiveError::InvalidMessage) ||
+                (e.getPrimitiveError() == PrimitiveError::FragmentOutOfOrder)) {
+            em_printfout("%s. Dropping packet", e.what());
+            return true;
+        }
+        em_printfout("%s", e.what());
+        throw e; // rethrow the exception if it's not an indication failure
+    }
+
+    // Original implementation expects whole ethernet frame
+    // not just CMDU, the header goes in front of the payload
+    memcpy(frame, first_mac.data(), ETH_ALEN);
+    memcpy(frame + ETH_ALEN, second_mac.data(), ETH_ALEN);
+    frame[2 * ETH_ALEN] = 0x89;
+    frame[2 * ETH_ALEN + 1] = 0x3A;
+#ifdef DEBUG_MODE
+    em_printfout("First MAC Address: " MACSTRFMT, MAC2STR(first_mac));
+    em_printfout("Second MAC Address: " MACSTRFMT, MAC2STR(second_mac));
+    em_printfout("RECONSTRUCTED_ETH_FRAME: \t");
+    util::print_hex_dump(static_cast<unsigned int>(sizeof(em_raw_hdr_t) + len), frame);
+#endif
+    proto_process(frame, static_cast<unsigned int>(sizeof(em_raw_hdr_t) + len), em);
+
+    return true;
+#else
+    em_rx_buff_t *buff;
+    struct msghdr msg;
+    struct iovec iov;
+    unsigned char ctrl[CMSG_SPACE(3 * sizeof(struct timespec))];
+    ssize_t len;
+
+    if ((buff = m_rx_ring.get()) == NULL) {
+        return false;
+    }
+
+    // receive data from this interface directly into the ring buffer, with the kernel receive stamp
+    iov.iov_base = buff->data;
+    iov.iov_len = buff->size;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl;
+    msg.msg_controllen = sizeof(ctrl);
+    len = recvmsg(em->get_fd(), &msg, 0);
+    if (len <= 0) {
+        em_frame_ring_t::put(buff);
+        return false;
+    }
+    buff->ts.read_us = em_lat_hist_t::get_time_us();
+    buff->ts.rx_us = em_frame_trace_t::get_rx_time_us(&msg, buff->ts.read_us);
+
+    proto_process(buff, static_cast<unsigned int>(len), em);
+    return true;
+#endif
+}
+
+void em_mgr_t::handle_link_change()
+{
+    unsigned char buff[EM_IO_BUFF_SZ];
+    struct nlmsghdr *nlh;
+    bool changed = false;
+    int len;
+    em_t *em;
+
+    while ((len = static_cast<int>(recv(m_netlink_fd, buff, sizeof(buff), 0))) > 0) {
+        for (nlh = reinterpret_cast<struct nlmsghdr *>(buff); NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+            if ((nlh->nlmsg_type == RTM_NEWLINK) || (nlh->nlmsg_type == RTM_DELLINK)) {
+                changed = true;
+            }
+        }
+    }
+
+    if (changed == false) {
+        return;
+    }
+
+    // cached transmit sockets may refer to a stale ifindex now
+    pthread_mutex_lock(&m_mutex);
+    em = static_cast<em_t *>(hash_map_get_first(m_em_map));
+    while (em != NULL) {
+        em->invalidate_tx_socket();
+        em = static_cast<em_t *>(hash_map_get_next(m_em_map, em));
+    }
+    pthread_mutex_unlock(&m_mutex);
+}
+
+void em_mgr_t::nodes_listener_epoll()
+{
+    struct epoll_event events[EM_MGR_MAX_EPOLL_EVENTS];
+    uint64_t val;
+    em_t *em;
+    int rc, i;
+
+    pthread_mutex_lock(&m_listener_lock);
+    m_listener_tid = pthread_self();
+    m_listener_running = true;
+    pthread_mutex_unlock(&m_listener_lock);
+
+    while (m_exit == false) {
+        // No periodic wake up unless fragments wait for the rest of their message
+        rc = epoll_wait(m_epoll_fd, events, EM_MGR_MAX_EPOLL_EVENTS,
+            (m_reasm.get_pending() == 0) ? -1:static_cast<int>(EM_REASM_TIMEOUT_US / 1000));
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            printf("%s:%d: epoll_wait failed, err:%d\n", __func__, __LINE__, errno);
+            break;
+        }
+
+        if (m_reasm.get_pending() != 0) {
+            m_reasm.expire(em_lat_hist_t::get_time_us());
+        }
+
+        m_listener_batch = events;
+        m_listener_batch_num = rc;
+        for (i = 0; i < rc; i++) {
+            if (events[i].data.ptr == NULL) {
+                // wake up event, drain the counter
+                while (read(m_wakeup_fd, &val, sizeof(val)) > 0);
+                continue;
+            }
+
+            if (events[i].data.ptr == &m_netlink_fd) {
+                handle_link_change();
+                continue;
+            }
+
+            // unregistered during this batch
+            if (events[i].data.ptr == &m_listener_gen) {
+                continue;
+            }
+
+            em = static_cast<em_t *>(events[i].data.ptr);
+            while (read_al_node(em) == true);
+        }
+
+        // the nodes unregistered until now are not referenced any more
+        pthread_mutex_lock(&m_listener_lock);
+        m_listener_batch_num = 0;
+        m_listener_gen++;
+        pthread_cond_broadcast(&m_listener_cond);
+        pthread_mutex_unlock(&m_listener_lock);
+    }
+
+    pthread_mutex_lock(&m_listener_lock);
+    m_listener_running = false;
+    pthread_cond_broadcast(&m_listener_cond);
+    pthread_mutex_unlock(&m_listener_lock);
+}
+
 void em_mgr_t::nodes_listener()
 {
     em_t *em = NULL;
     struct timeval tm;
     int rc, highest_fd = 0;
 
+    if (m_epoll_fd >= 0) {
+        nodes_listener_epoll();
+        return;
+    }
+
     tm.tv_sec = 0;
     tm.tv_usec = m_timeout * 1000;
     highest_fd = reset_listeners();
 
     while ((rc = select(highest_fd + 1, &m_rset, NULL, NULL, &tm)) >= 0) {
         if (rc == 0) {
+            if (m_reasm.get_pending() != 0) {
+                m_reasm.expire(em_lat_hist_t::get_time_us());
+            }
             tm.tv_sec = 0;
             tm.tv_usec = m_timeout * 1000;
             highest_fd = reset_listeners();
@@ -389,52 +883,13 @@ void em_mgr_t::nodes_listener()
         em = static_cast<em_t *>(hash_map_get_first(m_em_map));
         while (em != NULL) {
             if (em->is_al_interface_em() == true) {
-#ifdef AL_SAP
-                try{
-                    AlServiceDataUnit sdu = g_sap->serviceAccessPointDataIndication();
-                    std::vector<unsigned char> payload = sdu.getPayload();
-                    // Original implementation expects whole ethernet frame
-                    // not just CMDU, so we have to reconstruct it
-                    std::vector<unsigned char> reconstructed_eth_frame;
-                    auto first_mac = sdu.getSourceAlMacAddress();
-                    reconstructed_eth_frame.insert(reconstructed_eth_frame.end(),first_mac.begin(),first_mac.end());
-                    auto second_mac = sdu.getDestinationAlMacAddress();
-                    reconstructed_eth_frame.insert(reconstructed_eth_frame.end(),second_mac.begin(),second_mac.end());
-
-                    reconstructed_eth_frame.push_back(0x89);
-                    reconstructed_eth_frame.push_back(0x3A);
-
-                    reconstructed_eth_frame.insert(reconstructed_eth_frame.end(),payload.begin(),payload.end());
-#ifdef DEBUG_MODE
-                    em_printfout("First MAC Address: " MACSTRFMT, MAC2STR(first_mac));
-                    em_printfout("Second MAC Address: " MACSTRFMT, MAC2STR(second_mac));
-                    em_printfout("RECONSTRUCTED_ETH_FRAME: \t");
-                    util::print_hex_dump(reconstructed_eth_frame);
-#endif
-                    proto_process(reconstructed_eth_frame.data(), static_cast<unsigned int>(reconstructed_eth_frame.size()), em);
-                } catch (const AlServiceException& e) {
-                    if (e.getPrimitiveError() == PrimitiveError::InvalidMessage) {
-                        em_printfout("%s. Dropping packet", e.what());
-                    } else {
-                        em_printfout("%s", e.what());
-                        throw e; // rethrow the exception if it's not an indication failure
-                    }
-                }
-#else
-                unsigned char buff[MAX_EM_BUFF_SZ*EM_MAX_BANDS];
                 pthread_mutex_lock(&m_mutex);
                 int ret = FD_ISSET(em->get_fd(), &m_rset);
                 pthread_mutex_unlock(&m_mutex);
                 if (ret)
                 {
-                    // receive data from this interface
-                    memset(buff, 0, MAX_EM_BUFF_SZ*EM_MAX_BANDS);
-                    ssize_t len = read(em->get_fd(), buff, MAX_EM_BUFF_SZ*EM_MAX_BANDS);
-                    if (len) {
-                        proto_process(buff, static_cast<unsigned int>(len), em);
-                    }
+                    read_al_node(em);
                 }
-#endif
             }
             em = static_cast<em_t *>(hash_map_get_next(m_em_map, em));
         }
@@ -448,33 +903,23 @@ void em_mgr_t::nodes_listener()
 
 void *em_mgr_t::mgr_nodes_listen(void *arg)
 {
-    size_t stack_size2;
-    pthread_attr_t attr;
-    pthread_attr_init(&attr);
-    pthread_attr_getstacksize(&attr, &stack_size2);
-    printf("%s:%d Thread stack size = %ld bytes \n", __func__, __LINE__, stack_size2);
-    pthread_attr_destroy(&attr);
     em_mgr_t *mgr = static_cast<em_mgr_t *>(arg);
+    int slot = em_stack_t::enter(em_stack_role_listener, "nodes");
+
+    em_sched_t::apply(em_stack_role_listener, "nodes");
+
     mgr->nodes_listener();
+    em_stack_t::leave(slot);
     return NULL;
 }
 
 int em_mgr_t::nodes_listen()
 {
-    size_t stack_size = 0x800000; /* 8MB */
     pthread_attr_t attr;
     pthread_attr_t *attrp = NULL;
-    int ret = 0;
     attrp = &attr;
     pthread_attr_init(&attr);
-    // Setting explicitly stacksize as in few platforms(e.g. openwrt) if not called, the
-    // new thread will inherit the default stack size which is significantly less
-    // leading to stack overflow.
-    ret = pthread_attr_setstacksize(&attr, stack_size);
-    if (ret != 0) {
-        printf("%s:%d pthread_attr_setstacksize failed for size:%ld ret:%d\n",
-                __func__, __LINE__, stack_size, ret);
-    }
+    em_stack_t::set_attr(&attr, em_stack_role_listener);
     pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
     if (pthread_create(&m_tid, attrp, em_mgr_t::mgr_nodes_listen, this) != 0) {
         printf("%s:%d: Failed to start em mgr thread\n", __func__, __LINE__);
@@ -489,25 +934,97 @@ int em_mgr_t::nodes_listen()
     return 0;
 }
 
+static void em_mgr_500ms_tick(void *arg)
+{
+    static_cast<em_mgr_t *>(arg)->handle_500ms_tick();
+}
+
+static void em_mgr_1s_tick(void *arg)
+{
+    static_cast<em_mgr_t *>(arg)->handle_1s_tick();
+}
+
+static void em_mgr_2s_tick(void *arg)
+{
+    static_cast<em_mgr_t *>(arg)->handle_2s_tick();
+}
+
+static void em_mgr_5s_tick(void *arg)
+{
+    static_cast<em_mgr_t *>(arg)->handle_5s_tick();
+}
+
 void em_mgr_t::handle_timeout()
 {
-	m_tick_demultiplex++;
+    m_timers.run(em_timer_wheel_t::get_time_ms());
+}
 
-	handle_500ms_tick();
+void em_mgr_t::start_ticks()
+{
+    add_timer(&m_500ms_timer, EM_MGR_TOUT, EM_MGR_TOUT, em_mgr_500ms_tick, this);
+    add_timer(&m_1s_timer, EM_MGR_TOUT * EM_1_TOUT_MULT, EM_MGR_TOUT * EM_1_TOUT_MULT, em_mgr_1s_tick, this);
+    add_timer(&m_2s_timer, EM_MGR_TOUT * EM_2_TOUT_MULT, EM_MGR_TOUT * EM_2_TOUT_MULT, em_mgr_2s_tick, this);
+    add_timer(&m_5s_timer, EM_MGR_TOUT * EM_5_TOUT_MULT, EM_MGR_TOUT * EM_5_TOUT_MULT, em_mgr_5s_tick, this);
+}
 
-	if ((m_tick_demultiplex % EM_1_TOUT_MULT) == 0) {
-		handle_1s_tick();
-	}
+void em_mgr_t::add_timer(em_timer_t *t, unsigned int timeout_ms, unsigned int period_ms, em_timer_cb_t cb, void *arg)
+{
+    m_timers.add(t, em_timer_wheel_t::get_time_ms(), timeout_ms, period_ms, cb, arg);
+}
 
-	if ((m_tick_demultiplex % EM_2_TOUT_MULT) == 0) {
-		handle_2s_tick();
-	}
+void em_mgr_t::cancel_timer(em_timer_t *t)
+{
+    std::vector<em_mgr_async_timer_t>::iterator it;
 
-	if ((m_tick_demultiplex % EM_5_TOUT_MULT) == 0) {
-		handle_5s_tick();
-		m_tick_demultiplex = 0;
-	}
+    pthread_mutex_lock(&m_async_timer_lock);
+    for (it = m_async_timers.begin(); it != m_async_timers.end(); it++) {
+        if (it->t == t) {
+            m_async_timers.erase(it);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&m_async_timer_lock);
 
+    m_timers.cancel(t);
+}
+
+void em_mgr_t::add_timer_async(em_timer_t *t, unsigned int timeout_ms, em_timer_cb_t cb, void *arg)
+{
+    em_mgr_async_timer_t req;
+
+    req.t = t;
+    req.deadline_ms = em_timer_wheel_t::get_time_ms() + timeout_ms;
+    req.cb = cb;
+    req.arg = arg;
+
+    pthread_mutex_lock(&m_async_timer_lock);
+    m_async_timers.push_back(req);
+    pthread_mutex_unlock(&m_async_timer_lock);
+
+    // the manager may be sleeping until a later deadline
+    m_queue.wake();
+}
+
+void em_mgr_t::arm_async_timers()
+{
+    std::vector<em_mgr_async_timer_t> reqs;
+    uint64_t now;
+
+    pthread_mutex_lock(&m_async_timer_lock);
+    reqs.swap(m_async_timers);
+    pthread_mutex_unlock(&m_async_timer_lock);
+
+    now = em_timer_wheel_t::get_time_ms();
+    for (auto& req : reqs) {
+        m_timers.add(req.t, now, (req.deadline_ms > now) ? static_cast<unsigned int>(req.deadline_ms - now):0, 0, req.cb, req.arg);
+    }
+}
+
+void em_mgr_t::kick_orch()
+{
+    if (m_orch_kick.exchange(true) == false) {
+        m_queue.wake();
+    }
 }
 
 unsigned short em_mgr_t::get_next_msg_id()
@@ -519,107 +1036,275 @@ unsigned short em_mgr_t::get_next_msg_id()
     return m_msg_id;
 }
 
+void em_mgr_t::handle_event_batch(em_event_t **evts, unsigned int num)
+{
+    em_event_t *evt;
+    unsigned int i;
+
+    for (i = 0; i < num; i++) {
+        evt = evts[i];
+        // only the event right after it may take its place, moving its work past any other
+        // event would let that one see the state before it
+        if ((i + 1 < num) && (coalesce_event(evt, evts[i + 1]) == true)) {
+            m_coalesced++;
+        } else if (((evt->type == em_event_type_bus) && ((evt->u.bevt.type == em_bus_event_type_reset) ||
+                (evt->u.bevt.type == em_bus_event_type_get_reset))) ||
+                (is_data_model_initialized() == true) || (evt->type == em_event_type_nb)) {
+            em_perf_scope_t scope(em_perf_hist_mgr_event);
+            handle_event(evt);
+        }
+        em_perf_t::inc(em_perf_ctr_mgr_events_handled);
+        free_event(evt);
+    }
+}
+
 int em_mgr_t::start()
 {
-    int rc;
-    em_event_t *evt;;
-    struct timespec time_to_wait;
-    struct timeval tm;
+    em_event_t *evts[EM_MGR_BATCH_SZ];
+    unsigned int num;
+    int timeout;
 	bool started = false;
     input_listen();
     nodes_listen();
-    pthread_mutex_lock(&m_queue.lock);
+    m_queue_tid = pthread_self();
+    m_queue_running = true;
+    em_sched_t::apply(EM_SCHED_ROLE_MGR, NULL);
     while (m_exit == false) {
-        rc = 0;
-
-        gettimeofday(&tm, NULL);
-        time_to_wait.tv_sec = tm.tv_sec;
-       	time_to_wait.tv_nsec = tm.tv_usec * 1000;
-		util::add_milliseconds(&time_to_wait, m_queue.timeout);
-
-        if (queue_count(m_queue.queue) == 0) {
-            rc = pthread_cond_timedwait(&m_queue.cond, &m_queue.lock, &time_to_wait);
+        if ((started == false) && (is_data_model_initialized() == true)) {
+            start_complete();
+            start_ticks();
+            started = true;
         }
-        if ((rc == 0) || (queue_count(m_queue.queue) != 0)) {
-            // dequeue data
-            while (queue_count(m_queue.queue)) {
-                evt = static_cast<em_event_t *>(queue_pop(m_queue.queue));
-                if (evt == NULL) {
-                    continue;
-                }
-                pthread_mutex_unlock(&m_queue.lock);
-                if (((evt->type == em_event_type_bus) && ((evt->u.bevt.type == em_bus_event_type_reset) ||
-                      (evt->u.bevt.type == em_bus_event_type_get_reset))) ||
-						(is_data_model_initialized() == true)) {
-
-                    handle_event(evt);
-                } else if (evt->type == em_event_type_nb) {
-                    handle_event(evt);
-                }
-                free(evt);
-                pthread_mutex_lock(&m_queue.lock);
+
+        // sleep until the nearest timer deadline, poll for the data model until then
+        timeout = (started == true) ? m_timers.next_timeout_ms(em_timer_wheel_t::get_time_ms()):static_cast<int>(m_queue_timeout);
+        if (m_queue.wait(timeout) == true) {
+            em_perf_t::set_gauge(em_perf_gauge_mgr_queue_depth, m_queue.count());
+            // dequeue data in batches
+            while ((num = m_queue.pop_batch(reinterpret_cast<void **>(evts), EM_MGR_BATCH_SZ)) != 0) {
+                handle_event_batch(evts, num);
             }
-        } else if (rc == ETIMEDOUT) {
-            pthread_mutex_unlock(&m_queue.lock);
-            //printf("%s:%d: Timeout secs: %d\n", __func__, __LINE__, time_to_wait.tv_sec);
-            if (is_data_model_initialized() == true) {
-				if (started == false) {
-					start_complete();
-					started = true;
-				}
-                handle_timeout();
+        }
+
+        if (started == true) {
+            if (m_orch_kick.exchange(false) == true) {
+                handle_orch_kick();
             }
-            pthread_mutex_lock(&m_queue.lock);
-        } else {
-            printf("%s:%d em exited with rc - %d\n",__func__,__LINE__, rc);
-            pthread_mutex_unlock(&m_queue.lock);
-            return -1;
+            arm_async_timers();
+            handle_timeout();
         }
     }
-    pthread_mutex_unlock(&m_queue.lock);
     return 0;
 }
 
+void em_mgr_t::stop()
+{
+    m_exit = true;
+    wake_listener();
+
+    pthread_mutex_lock(&m_listener_lock);
+    while (m_listener_running == true) {
+        pthread_cond_wait(&m_listener_cond, &m_listener_lock);
+    }
+    pthread_mutex_unlock(&m_listener_lock);
+}
+
 void em_mgr_t::push_to_queue(em_event_t *evt)
 {
-    pthread_mutex_lock(&m_queue.lock);
-    queue_push(m_queue.queue, evt);
-    pthread_cond_signal(&m_queue.cond);
-    pthread_mutex_unlock(&m_queue.lock);
+    // the manager thread can not wait for itself to drain the queue, nor can anyone
+    // before the manager loop runs
+    bool wait = (m_queue_running == true) && (pthread_equal(pthread_self(), m_queue_tid) == 0);
+
+    if (m_queue.push_wait(evt, (wait == true) ? EM_MGR_QUEUE_WAIT_MS:0) == false) {
+        em_perf_t::inc(em_perf_ctr_mgr_events_dropped);
+        printf("%s:%d: Queue full, dropping event type:%d, %u dropped\n", __func__, __LINE__, evt->type, m_queue.get_drops());
+        free_event(evt);
+        return;
+    }
+    em_perf_t::inc(em_perf_ctr_mgr_events_queued);
+}
+
+em_event_t *em_mgr_t::alloc_event(unsigned int data_len)
+{
+    return m_event_pool.alloc(data_len);
+}
+
+void em_mgr_t::free_event(em_event_t *evt)
+{
+    m_event_pool.release(evt);
 }
 
 em_event_t *em_mgr_t::pop_from_queue()
 {
-    return static_cast<em_event_t *>(queue_pop(m_queue.queue));
+    return static_cast<em_event_t *>(m_queue.pop());
 }
 
 int em_mgr_t::init(const char *data_model_path)
 {
+    int slot, rc;
+
+    slot = em_startup_prof_t::begin(em_startup_prof_phase, "ssl");
     SSL_load_error_strings();
     SSL_library_init();
+    em_startup_prof_t::end(slot);
 
+    slot = em_startup_prof_t::begin(em_startup_prof_phase, "queues");
     m_em_map = hash_map_create();
 
     // initialize the egress queue
-    m_queue.queue = queue_create();
-    pthread_mutex_init(&m_queue.lock, NULL);
-    pthread_cond_init(&m_queue.cond, NULL);
+    if (m_queue.init(EM_MGR_QUEUE_SZ) != 0) {
+        em_startup_prof_t::end(slot);
+        return -1;
+    }
 
-    m_queue.timeout = EM_MGR_TOUT;
+    m_queue_timeout = EM_MGR_TOUT;
     m_msg_id = 0;
 
+    m_rx_ring.init(EM_RX_RING_SZ);
+    m_reasm.init(&m_rx_ring);
+    if ((m_num_rx_shards != 0) && (m_rx_shards.init(m_num_rx_shards, &m_rx_ring, em_mgr_t::rx_shard_route, this) != 0)) {
+        printf("%s:%d: Failed to start the receive shards, the listener routes the frames\n", __func__, __LINE__);
+    }
+    em_startup_prof_t::end(slot);
+
+#ifndef EM_THREAD_PER_NODE
+    // one worker per CPU runs all ems, build with EM_THREAD_PER_NODE to give every em its own thread
+    slot = em_startup_prof_t::begin(em_startup_prof_phase, "worker_pool");
+    if (m_workers.init(0, em_t::worker_run, em_t::worker_tick, EM_PROTO_TOUT * 1000) != 0) {
+        printf("%s:%d: Failed to start the worker pool, using a thread per em\n", __func__, __LINE__);
+    }
+    em_startup_prof_t::end(slot);
+#endif
+
+    // the ems compute their keys on their own thread if this fails
+    slot = em_startup_prof_t::begin(em_startup_prof_phase, "crypto_pool");
+    if (m_crypto_pool.init(0) != 0) {
+        printf("%s:%d: Failed to start the crypto pool\n", __func__, __LINE__);
+    }
+    em_startup_prof_t::end(slot);
+
+    slot = em_startup_prof_t::begin(em_startup_prof_phase, "listener");
+    init_listener();
+    em_startup_prof_t::end(slot);
+
+    slot = em_startup_prof_t::begin(em_startup_prof_phase, "orch");
     orch_init();
-    return data_model_init(data_model_path);
+    em_startup_prof_t::end(slot);
+
+    slot = em_startup_prof_t::begin(em_startup_prof_phase, "data_model");
+    rc = data_model_init(data_model_path);
+    em_startup_prof_t::end(slot);
+
+    em_startup_prof_t::done();
+
+    return rc;
+}
+
+int em_mgr_t::init_listener()
+{
+    struct epoll_event ev;
+    struct sockaddr_nl nl_addr;
+
+    if ((m_epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+        printf("%s:%d: epoll not available, falling back to select, err:%d\n", __func__, __LINE__, errno);
+        return -1;
+    }
+
+    if ((m_wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+        printf("%s:%d: eventfd failed, falling back to select, err:%d\n", __func__, __LINE__, errno);
+        close(m_epoll_fd);
+        m_epoll_fd = -1;
+        return -1;
+    }
+
+    memset(&ev, 0, sizeof(struct epoll_event));
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_wakeup_fd, &ev) < 0) {
+        printf("%s:%d: Failed to register wake up fd, err:%d\n", __func__, __LINE__, errno);
+        close(m_wakeup_fd);
+        close(m_epoll_fd);
+        m_wakeup_fd = -1;
+        m_epoll_fd = -1;
+        return -1;
+    }
+
+    // link notifications invalidate the cached transmit sockets of the nodes
+    memset(&nl_addr, 0, sizeof(struct sockaddr_nl));
+    nl_addr.nl_family = AF_NETLINK;
+    nl_addr.nl_groups = RTMGRP_LINK;
+    if ((m_netlink_fd = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE)) < 0) {
+        printf("%s:%d: Failed to open netlink socket, err:%d\n", __func__, __LINE__, errno);
+        return 0;
+    }
+
+    memset(&ev, 0, sizeof(struct epoll_event));
+    ev.events = EPOLLIN;
+    ev.data.ptr = &m_netlink_fd;
+    if ((bind(m_netlink_fd, reinterpret_cast<struct sockaddr *>(&nl_addr), sizeof(struct sockaddr_nl)) < 0) ||
+            (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_netlink_fd, &ev) < 0)) {
+        printf("%s:%d: Failed to register netlink socket, err:%d\n", __func__, __LINE__, errno);
+        close(m_netlink_fd);
+        m_netlink_fd = -1;
+    }
+
+    return 0;
 }
 
 em_mgr_t::em_mgr_t()
 {
     m_exit = false;
     m_timeout = EM_MGR_TOUT;
-	m_tick_demultiplex = 0;
+    m_queue_timeout = EM_MGR_TOUT;
+    m_queue_tid = 0;
+    m_queue_running = false;
+    m_coalesced = 0;
+    m_orch_kick = false;
+    memset(m_msg_stats, 0, sizeof(m_msg_stats));
+    m_num_rx_shards = 0;
+    pthread_mutex_init(&m_route_lock, NULL);
+    pthread_rwlock_init(&m_index_lock, NULL);
+    m_al_node = NULL;
+    em_timer_wheel_t::init_timer(&m_500ms_timer);
+    em_timer_wheel_t::init_timer(&m_1s_timer);
+    em_timer_wheel_t::init_timer(&m_2s_timer);
+    em_timer_wheel_t::init_timer(&m_5s_timer);
+    pthread_mutex_init(&m_async_timer_lock, NULL);
+    pthread_mutex_init(&m_scan_result_lock, NULL);
+    m_epoll_fd = -1;
+    m_wakeup_fd = -1;
+    m_netlink_fd = -1;
+    pthread_mutex_init(&m_listener_lock, NULL);
+    pthread_cond_init(&m_listener_cond, NULL);
+    m_listener_tid = 0;
+    m_listener_running = false;
+    m_listener_gen = 0;
+    m_listener_batch = NULL;
+    m_listener_batch_num = 0;
 }
 
 em_mgr_t::~em_mgr_t()
 {
+    // the listener must be out of epoll_wait() before its fds are closed
+    stop();
+
+    if (m_netlink_fd >= 0) {
+        close(m_netlink_fd);
+    }
+
+    if (m_wakeup_fd >= 0) {
+        close(m_wakeup_fd);
+    }
+
+    if (m_epoll_fd >= 0) {
+        close(m_epoll_fd);
+    }
 
+    m_rx_shards.deinit();
+    pthread_mutex_destroy(&m_route_lock);
+    pthread_rwlock_destroy(&m_index_lock);
+    pthread_mutex_destroy(&m_async_timer_lock);
+    pthread_mutex_destroy(&m_scan_result_lock);
+    pthread_cond_destroy(&m_listener_cond);
+    pthread_mutex_destroy(&m_listener_lock);
 }
@@ -0,0 +1,279 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/eventfd.h>
+#include <new>
+#include "em_mpsc_queue.h"
+
+int em_mpsc_queue_t::init(unsigned int capacity)
+{
+    size_t sz = 2, i;
+
+    while (sz < capacity) {
+        sz <<= 1;
+    }
+
+    if ((m_cells = new (std::nothrow) em_mpsc_cell_t[sz]) == NULL) {
+        printf("%s:%d: Failed to allocate queue of size:%zu\n", __func__, __LINE__, sz);
+        return -1;
+    }
+
+    if ((m_efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+        printf("%s:%d: eventfd failed, err:%d\n", __func__, __LINE__, errno);
+        delete[] m_cells;
+        m_cells = NULL;
+        return -1;
+    }
+
+    for (i = 0; i < sz; i++) {
+        m_cells[i].seq.store(i, std::memory_order_relaxed);
+        m_cells[i].data = NULL;
+    }
+
+    m_mask = sz - 1;
+    m_enqueue_pos.store(0, std::memory_order_relaxed);
+    m_dequeue_pos.store(0, std::memory_order_relaxed);
+
+    return 0;
+}
+
+void em_mpsc_queue_t::deinit()
+{
+    if (m_efd >= 0) {
+        close(m_efd);
+        m_efd = -1;
+    }
+
+    delete[] m_cells;
+    m_cells = NULL;
+}
+
+bool em_mpsc_queue_t::push(void *data)
+{
+    if (try_push(data) == false) {
+        m_drops++;
+        return false;
+    }
+
+    return true;
+}
+
+bool em_mpsc_queue_t::push_wait(void *data, int timeout_ms)
+{
+    struct timespec deadline;
+    bool queued;
+
+    if (((queued = try_push(data)) == true) || (timeout_ms <= 0)) {
+        if (queued == false) {
+            m_drops++;
+        }
+        return queued;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += static_cast<long>(timeout_ms % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+
+    // registered before the retry, so that a pop after it signals the wait below
+    pthread_mutex_lock(&m_space_lock);
+    m_space_waiters++;
+    while ((queued = try_push(data)) == false) {
+        if (pthread_cond_timedwait(&m_space_cond, &m_space_lock, &deadline) == ETIMEDOUT) {
+            queued = try_push(data);
+            break;
+        }
+    }
+    m_space_waiters--;
+    pthread_mutex_unlock(&m_space_lock);
+
+    if (queued == false) {
+        m_drops++;
+    }
+
+    return queued;
+}
+
+void em_mpsc_queue_t::wake_producers()
+{
+    // orders the freed cells before the check, against the waiter's register then retry
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_space_waiters.load() != 0) {
+        pthread_mutex_lock(&m_space_lock);
+        pthread_cond_broadcast(&m_space_cond);
+        pthread_mutex_unlock(&m_space_lock);
+    }
+}
+
+bool em_mpsc_queue_t::try_push(void *data)
+{
+    em_mpsc_cell_t *cell;
+    size_t pos, seq, depth;
+    intptr_t dif;
+    uint64_t val = 1;
+
+    pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    while (true) {
+        cell = &m_cells[pos & m_mask];
+        seq = cell->seq.load(std::memory_order_acquire);
+        dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (dif == 0) {
+            if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed) == true) {
+                break;
+            }
+        } else if (dif < 0) {
+            return false;
+        } else {
+            pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->data = data;
+    cell->seq.store(pos + 1, std::memory_order_release);
+
+    depth = count();
+    if (depth > m_high_watermark) {
+        m_high_watermark = static_cast<unsigned int>(depth);
+    }
+
+    // only pay for the syscall when the consumer is asleep
+    if (m_waiting.load(std::memory_order_seq_cst) == true) {
+        if (write(m_efd, &val, sizeof(val)) < 0) {
+            printf("%s:%d: Failed to wake up consumer, err:%d\n", __func__, __LINE__, errno);
+        }
+    }
+
+    return true;
+}
+
+void *em_mpsc_queue_t::pop()
+{
+    em_mpsc_cell_t *cell;
+    void *data;
+    size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+
+    cell = &m_cells[pos & m_mask];
+    if (cell->seq.load(std::memory_order_acquire) != (pos + 1)) {
+        return NULL;
+    }
+
+    data = cell->data;
+    cell->seq.store(pos + m_mask + 1, std::memory_order_release);
+    m_dequeue_pos.store(pos + 1, std::memory_order_release);
+    wake_producers();
+
+    return data;
+}
+
+unsigned int em_mpsc_queue_t::pop_batch(void **entries, unsigned int max)
+{
+    em_mpsc_cell_t *cell;
+    size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+    unsigned int num = 0;
+
+    while (num < max) {
+        cell = &m_cells[pos & m_mask];
+        if (cell->seq.load(std::memory_order_acquire) != (pos + 1)) {
+            break;
+        }
+        entries[num++] = cell->data;
+        cell->seq.store(pos + m_mask + 1, std::memory_order_release);
+        pos++;
+    }
+
+    // publish the new head once for the whole batch
+    if (num != 0) {
+        m_dequeue_pos.store(pos, std::memory_order_release);
+        wake_producers();
+    }
+
+    return num;
+}
+
+bool em_mpsc_queue_t::wait(int timeout_ms)
+{
+    struct pollfd pfd;
+    uint64_t val;
+    int rc;
+
+    m_waiting.store(true, std::memory_order_seq_cst);
+    if (count() != 0) {
+        m_waiting.store(false, std::memory_order_relaxed);
+        return true;
+    }
+
+    pfd.fd = m_efd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    while (((rc = poll(&pfd, 1, timeout_ms)) < 0) && (errno == EINTR));
+
+    m_waiting.store(false, std::memory_order_relaxed);
+    if (rc > 0) {
+        while (read(m_efd, &val, sizeof(val)) > 0);
+        return true;
+    }
+
+    return (count() != 0);
+}
+
+void em_mpsc_queue_t::wake()
+{
+    uint64_t val = 1;
+
+    if (write(m_efd, &val, sizeof(val)) < 0) {
+        printf("%s:%d: Failed to wake up consumer, err:%d\n", __func__, __LINE__, errno);
+    }
+}
+
+unsigned int em_mpsc_queue_t::count()
+{
+    size_t enq = m_enqueue_pos.load(std::memory_order_acquire);
+    size_t deq = m_dequeue_pos.load(std::memory_order_acquire);
+
+    return (enq > deq) ? static_cast<unsigned int>(enq - deq):0;
+}
+
+em_mpsc_queue_t::em_mpsc_queue_t(): m_cells(NULL), m_mask(0), m_enqueue_pos(0), m_dequeue_pos(0), m_waiting(false), m_efd(-1), m_high_watermark(0), m_drops(0),
+    m_space_waiters(0)
+{
+    pthread_condattr_t attr;
+
+    pthread_mutex_init(&m_space_lock, NULL);
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&m_space_cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+em_mpsc_queue_t::~em_mpsc_queue_t()
+{
+    deinit();
+    pthread_cond_destroy(&m_space_cond);
+    pthread_mutex_destroy(&m_space_lock);
+}
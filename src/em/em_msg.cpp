@@ -31,110 +31,191 @@
 #include "em_configuration.h"
 #include "util.h"
 
+void em_msg_t::index_tlvs(unsigned char *tlvs, unsigned int len)
+{
+    em_tlv_t *tlv;
+    unsigned short last[EM_MAX_TLV_TYPES];
+    unsigned int off = 0, tlv_len;
+
+    memset(m_index_first, 0, sizeof(m_index_first));
+    memset(last, 0, sizeof(last));
+    m_index_base = tlvs;
+    m_index_len = len;
+    m_index_num = 0;
+    m_index_full = false;
+    m_index_malformed = false;
+
+    if (tlvs == NULL) {
+        m_index_len = 0;
+        m_index_end = 0;
+        return;
+    }
+
+    while ((len - off) >= sizeof(em_tlv_t)) {
+        tlv = reinterpret_cast<em_tlv_t *> (tlvs + off);
+        if (tlv->type == em_tlv_type_eom) {
+            break;
+        }
+
+        tlv_len = static_cast<unsigned int> (sizeof(em_tlv_t) + ntohs(tlv->len));
+        if (tlv_len > (len - off)) {
+            m_index_malformed = true;
+            break;
+        }
+
+        if (m_index_num == EM_MAX_INDEXED_TLVS) {
+            m_index_full = true;
+            break;
+        }
+
+        m_index_refs[m_index_num].offset = off;
+        m_index_refs[m_index_num].next = 0;
+        m_index_num++;
+
+        if (last[tlv->type] == 0) {
+            m_index_first[tlv->type] = static_cast<unsigned short> (m_index_num);
+        } else {
+            m_index_refs[last[tlv->type] - 1].next = static_cast<unsigned short> (m_index_num);
+        }
+        last[tlv->type] = static_cast<unsigned short> (m_index_num);
+
+        off += tlv_len;
+    }
+
+    m_index_end = off;
+}
+
+em_tlv_t *em_msg_t::find_tlv(unsigned char *tlvs, unsigned int len, em_tlv_type_t type, unsigned int instance)
+{
+    em_tlv_t *tlv;
+    unsigned int slot, off, tlv_len;
+
+    if ((tlvs != m_index_base) || (len != m_index_len)) {
+        index_tlvs(tlvs, len);
+    }
+
+    for (slot = m_index_first[type & 0xff]; slot != 0; slot = m_index_refs[slot - 1].next) {
+        if (instance == 0) {
+            return reinterpret_cast<em_tlv_t *> (m_index_base + m_index_refs[slot - 1].offset);
+        }
+        instance--;
+    }
+
+    if (m_index_full == false) {
+        return NULL;
+    }
+
+    // more TLVs than index slots, walk the part that was not indexed
+    off = m_index_end;
+    while ((m_index_len - off) >= sizeof(em_tlv_t)) {
+        tlv = reinterpret_cast<em_tlv_t *> (m_index_base + off);
+        tlv_len = static_cast<unsigned int> (sizeof(em_tlv_t) + ntohs(tlv->len));
+        if ((tlv->type == em_tlv_type_eom) || (tlv_len > (m_index_len - off))) {
+            break;
+        }
+        if (tlv->type == type) {
+            if (instance == 0) {
+                return tlv;
+            }
+            instance--;
+        }
+        off += tlv_len;
+    }
+
+    return NULL;
+}
+
+em_tlv_t *em_msg_t::get_first_tlv_of(const em_tlv_type_t *types, unsigned int num)
+{
+    em_tlv_t *tlv, *first = NULL;
+    unsigned int i;
+
+    for (i = 0; i < num; i++) {
+        tlv = get_tlv(types[i]);
+        if ((tlv != NULL) && ((first == NULL) || (tlv < first))) {
+            first = tlv;
+        }
+    }
+
+    return first;
+}
+
 bool em_msg_t::get_tlv(em_tlv_t *itlv)
 {
     em_tlv_t    *tlv;
-    unsigned int len;
 
-    tlv = reinterpret_cast<em_tlv_t *> (m_buff); len = m_len;
-    while ((tlv->type != em_tlv_type_eom) && (len > 0)) {
-        if (tlv->type == itlv->type) {
-            memcpy(itlv->value, tlv->value, htons(tlv->len));
-            return true;
-        }
-        len -= static_cast<unsigned int> (sizeof(em_tlv_t) + htons(tlv->len));
-        tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
+    if ((tlv = get_tlv(static_cast<em_tlv_type_t> (itlv->type))) == NULL) {
+        return false;
     }
 
-    return false;
+    memcpy(itlv->value, tlv->value, htons(tlv->len));
+
+    return true;
 }
 
 bool em_msg_t::get_client_mac_info(mac_address_t *mac)
 {
     em_tlv_t    *tlv;
-    unsigned int len;
     em_client_info_t *cltinfo;
 
-    tlv = reinterpret_cast<em_tlv_t *> (m_buff); len = m_len;
-    while ((tlv->type != em_tlv_type_eom) && (len > 0)) {
-        if (tlv->type == em_tlv_type_client_info) {
-            cltinfo = reinterpret_cast<em_client_info_t *> (tlv->value);
-            memcpy(mac, &cltinfo->client_mac_addr, sizeof(mac_address_t));
-            return true;
-        }
+    if ((mac == NULL) || ((tlv = get_tlv(em_tlv_type_client_info)) == NULL)) {
+        return false;
     }
-    return false;
+
+    cltinfo = reinterpret_cast<em_client_info_t *> (tlv->value);
+    memcpy(mac, &cltinfo->client_mac_addr, sizeof(mac_address_t));
+
+    return true;
 }
 
 bool em_msg_t::get_al_mac_address(unsigned char *mac)
 {
     em_tlv_t    *tlv;
-    unsigned int len;
 
-    tlv = reinterpret_cast<em_tlv_t *> (m_buff); len = m_len;
-    while ((tlv->type != em_tlv_type_eom) && (len > 0)) {
-        if (tlv->type == em_tlv_type_al_mac_address) {
-            memcpy(mac, tlv->value, htons(tlv->len));
-            return true;
-        }
-        len -= static_cast<unsigned int> (sizeof(em_tlv_t) + htons(tlv->len));
-        tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
+    if ((mac == NULL) || ((tlv = get_tlv(em_tlv_type_al_mac_address)) == NULL)) {
+        return false;
     }
 
-    return false;
+    memcpy(mac, tlv->value, htons(tlv->len));
+
+    return true;
 }
 
 bool em_msg_t::get_profile(em_profile_type_t *profile)
 {
     em_tlv_t    *tlv;
-    unsigned int len;
-
-    tlv = reinterpret_cast<em_tlv_t *> (m_buff); len = m_len;
-    while ((tlv->type != em_tlv_type_eom) && (len > 0)) {
-        if (tlv->type == em_tlv_type_profile) {
-            memcpy(profile, tlv->value, htons(tlv->len));
-            return true;
-        }
 
-        len -= static_cast<unsigned int> (sizeof(em_tlv_t) + htons(tlv->len));
-        tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
+    if ((profile == NULL) || ((tlv = get_tlv(em_tlv_type_profile)) == NULL)) {
+        return false;
     }
 
-    return false;
+    memcpy(profile, tlv->value, htons(tlv->len));
+
+    return true;
 }
 
 bool em_msg_t::get_bss_id(mac_address_t *mac)
 {
     em_tlv_t    *tlv;
-    unsigned int len;
+    const em_tlv_type_t types[] = {em_tlv_type_client_info, em_tlv_type_client_assoc_event, em_tlv_type_ap_metrics};
 
-    tlv = reinterpret_cast<em_tlv_t *> (m_buff); len = m_len;
-    while ((tlv->type != em_tlv_type_eom) && (len > 0)) {
-        if (tlv->type == em_tlv_type_client_info) {
-            memcpy(mac, tlv->value, sizeof(mac_address_t));
-            return true;
-        } else if (tlv->type == em_tlv_type_client_assoc_event) {
-            memcpy(mac, tlv->value + sizeof(mac_address_t), sizeof(mac_address_t));
-            return true;
-        } else if (tlv->type == em_tlv_type_client_info) {
-            memcpy(mac, tlv->value + sizeof(mac_address_t), sizeof(mac_address_t));
-            return true;
-        } else if (tlv->type == em_tlv_type_ap_metrics) {
-            memcpy(mac, tlv->value, sizeof(mac_address_t));
-            return true;
-        }
+    if ((mac == NULL) || ((tlv = get_first_tlv_of(types, sizeof(types)/sizeof(types[0]))) == NULL)) {
+        return false;
+    }
 
-        len -= static_cast<unsigned int> (sizeof(em_tlv_t) + htons(tlv->len));
-        tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
+    if (tlv->type == em_tlv_type_client_assoc_event) {
+        memcpy(mac, tlv->value + sizeof(mac_address_t), sizeof(mac_address_t));
+    } else {
+        memcpy(mac, tlv->value, sizeof(mac_address_t));
     }
 
-    return false;
+    return true;
 }
 
 bool em_msg_t::get_radio_id(mac_address_t *mac)
 {
-    em_tlv_t    *tlv;
-    unsigned int len;
+    em_tlv_t    *tlv, *bss_tlv = NULL;
+    unsigned int i;
 	unsigned int num_radios = 0;
     em_ap_radio_basic_cap_t *rd_basic_cap;
     em_ap_radio_advanced_cap_t  *rd_adv_cap;
@@ -142,130 +223,146 @@ bool em_msg_t::get_radio_id(mac_address_t *mac)
     em_ap_vht_cap_t *rd_vht_cap;
     em_ap_he_cap_t *rd_he_cap;
     em_ap_op_bss_t  *ap;
-    
-	em_ap_op_bss_radio_t    *radio;
+    const em_tlv_type_t types[] = {em_tlv_type_radio_id, em_tlv_type_ap_radio_basic_cap, em_tlv_type_ap_radio_advanced_cap,
+        em_tlv_type_ht_cap, em_tlv_type_vht_cap, em_tlv_type_he_cap, em_tlv_type_channel_pref, em_tlv_type_channel_sel_resp,
+        em_tlv_type_op_channel_report, em_tlv_type_channel_scan_req, em_tlv_type_channel_scan_rslt, em_tlv_type_radio_metric,
+        em_tlv_type_bh_sta_radio_cap};
 
-    tlv = reinterpret_cast<em_tlv_t *> (m_buff); len = m_len;
-    while ((tlv->type != em_tlv_type_eom) && (len > 0)) {
-        if (tlv->type == em_tlv_type_radio_id) {
-            memcpy(mac, tlv->value, sizeof(mac_address_t));
-            return true;    
-        } else if (tlv->type == em_tlv_type_ap_radio_basic_cap) {
+    if (mac == NULL) {
+        return false;
+    }
+
+    // an operational bss TLV only names a radio if it lists at least one
+    for (i = 0; (bss_tlv = get_tlv(em_tlv_type_operational_bss, i)) != NULL; i++) {
+        ap = reinterpret_cast<em_ap_op_bss_t *> (bss_tlv->value);
+        if (ap->radios_num >= 1) {
+            break;
+        }
+    }
+
+    tlv = get_first_tlv_of(types, sizeof(types)/sizeof(types[0]));
+    if ((bss_tlv != NULL) && ((tlv == NULL) || (bss_tlv < tlv))) {
+        ap = reinterpret_cast<em_ap_op_bss_t *> (bss_tlv->value);
+        memcpy(mac, &ap->radios[0].ruid, sizeof(mac_address_t));
+        return true;
+    }
+
+    if (tlv == NULL) {
+        return false;
+    }
+
+    switch (tlv->type) {
+        case em_tlv_type_ap_radio_basic_cap:
             rd_basic_cap = reinterpret_cast<em_ap_radio_basic_cap_t *> (tlv->value);
             memcpy(mac, &rd_basic_cap->ruid, sizeof(mac_address_t));
-            return true;    
-        } else if (tlv->type == em_tlv_type_ap_radio_advanced_cap) {
+            break;
+
+        case em_tlv_type_ap_radio_advanced_cap:
             rd_adv_cap = reinterpret_cast<em_ap_radio_advanced_cap_t *> (tlv->value);
             memcpy(mac, &rd_adv_cap->ruid, sizeof(mac_address_t));
-            return true;    
+            break;
 
-        } else if (tlv->type == em_tlv_type_ht_cap) {
+        case em_tlv_type_ht_cap:
             rd_ht_cap = reinterpret_cast<em_ap_ht_cap_t *> (tlv->value);
             memcpy(mac, &rd_ht_cap->ruid, sizeof(mac_address_t));
-            return true;
-        } else if (tlv->type == em_tlv_type_vht_cap) {
+            break;
+
+        case em_tlv_type_vht_cap:
             rd_vht_cap = reinterpret_cast<em_ap_vht_cap_t *>(tlv->value);
             memcpy(mac, &rd_vht_cap->ruid, sizeof(mac_address_t));
-            return true;
-        } else if (tlv->type == em_tlv_type_he_cap) {
+            break;
+
+        case em_tlv_type_he_cap:
             rd_he_cap = reinterpret_cast<em_ap_he_cap_t *> (tlv->value);
             memcpy(mac, &rd_he_cap->ruid, sizeof(mac_address_t));
-            return true;
-        } else if (tlv->type == em_tlv_type_operational_bss) {
-			ap = reinterpret_cast<em_ap_op_bss_t *> (tlv->value);
-			if (ap->radios_num >= 1) {
-				radio = ap->radios;
-				memcpy(mac, &radio->ruid, sizeof(mac_address_t));
-				return true;	
-			} 
-        } else if (tlv->type == em_tlv_type_channel_pref) {
-			memcpy(mac, tlv->value, sizeof(mac_address_t));
-			return true;	
-		} else if (tlv->type == em_tlv_type_channel_sel_resp) {
-			memcpy(mac, tlv->value, sizeof(mac_address_t));
-			return true;
-		} else if (tlv->type == em_tlv_type_op_channel_report) {
-			memcpy(mac, tlv->value, sizeof(mac_address_t));
-			return true;
-		} else if (tlv->type == em_tlv_type_channel_scan_req) {
+            break;
+
+        case em_tlv_type_channel_scan_req:
 			memcpy(&num_radios, tlv->value + sizeof(unsigned char), sizeof(unsigned char));
-			if (num_radios != 0) {
-				memcpy(mac, tlv->value + 2*sizeof(unsigned char), sizeof(mac_address_t));
-				return true;
-			} else {
+			if (num_radios == 0) {
 				return false;
 			}
-		} else if (tlv->type == em_tlv_type_channel_scan_rslt) {
-			memcpy(mac, tlv->value, sizeof(mac_address_t));
-            return true;
-		} else if (tlv->type == em_tlv_type_radio_metric) {
-            memcpy(mac, tlv->value, sizeof(mac_address_t));
-            return true;
-        } else if (tlv->type == em_tlv_type_bh_sta_radio_cap) {
-            memcpy(mac, tlv->value, sizeof(mac_address_t));
-            return true;
-        }
+			memcpy(mac, tlv->value + 2*sizeof(unsigned char), sizeof(mac_address_t));
+            break;
 
-        len -= static_cast<unsigned int> (sizeof(em_tlv_t) + htons(tlv->len));
-        tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
+        default:
+            // radio id, channel preference, selection response, operating channel report,
+            // scan result, radio metrics and backhaul sta radio capabilities lead with the ruid
+            memcpy(mac, tlv->value, sizeof(mac_address_t));
+            break;
     }
 
-    return false;
+    return true;
 }
 
 bool em_msg_t::get_freq_band(em_freq_band_t *band)
 {
     em_tlv_t    *tlv;
-    unsigned int len;
+    const em_tlv_type_t types[] = {em_tlv_type_supported_freq_band, em_tlv_type_autoconf_freq_band};
 
-    tlv = reinterpret_cast<em_tlv_t *> (m_buff); len = m_len;
-    while ((tlv->type != em_tlv_type_eom) && (len > 0)) {
-        if ((tlv->type == em_tlv_type_supported_freq_band) || (tlv->type == em_tlv_type_autoconf_freq_band)) {
-            memcpy(reinterpret_cast<unsigned char *> (band), tlv->value, sizeof(unsigned char));
-            return true;
-        }
-        len -= static_cast<unsigned int> (sizeof(em_tlv_t) + htons(tlv->len));
-        tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
+    if ((band == NULL) || ((tlv = get_first_tlv_of(types, sizeof(types)/sizeof(types[0]))) == NULL)) {
+        return false;
     }
 
-    return false;
+    memcpy(reinterpret_cast<unsigned char *> (band), tlv->value, sizeof(unsigned char));
 
+    return true;
 }
 
 bool em_msg_t::get_profile_type(em_profile_type_t *profile)
 {
     em_tlv_t    *tlv;
-    unsigned int len;
+
+    if (profile == NULL) {
+        return false;
+    }
 
     *profile = em_profile_type_reserved;
-    tlv = reinterpret_cast<em_tlv_t *> (m_buff); len = m_len;
-    while ((tlv->type != em_tlv_type_eom) && (len > 0)) {
-        if (tlv->type == em_tlv_type_profile) {
-            memcpy(reinterpret_cast<unsigned char *> (profile), tlv->value, htons(tlv->len));
-            return true;
-        }
-        len -= static_cast<unsigned int> (sizeof(em_tlv_t) + htons(tlv->len));
-        tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
+    if ((tlv = get_tlv(em_tlv_type_profile)) == NULL) {
+        return false;
     }
 
-    return false;
+    memcpy(reinterpret_cast<unsigned char *> (profile), tlv->value, htons(tlv->len));
+
+    return true;
 }
 
 em_tlv_t *em_msg_t::get_tlv(em_tlv_type_t type)
 {
-    em_tlv_t    *tlv;
-    unsigned int len;
+    return find_tlv(m_buff, m_len, type, 0);
+}
 
-    tlv = reinterpret_cast<em_tlv_t *> (m_buff); len = m_len;
-    while ((tlv->type != em_tlv_type_eom) && (len > 0)) {
-        if (tlv->type == type) {
-            return tlv; 
-        }
-        len -= static_cast<unsigned int> (sizeof(em_tlv_t) + ntohs(tlv->len));
-        tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + ntohs(tlv->len));
+em_tlv_t *em_msg_t::get_tlv(em_tlv_type_t type, unsigned int instance)
+{
+    return find_tlv(m_buff, m_len, type, instance);
+}
+
+unsigned int em_msg_t::get_tlv_count(em_tlv_type_t type)
+{
+    unsigned int slot, num = 0;
+
+    if (find_tlv(m_buff, m_len, type, 0) == NULL) {
+        return 0;
     }
 
-    return NULL;
+    for (slot = m_index_first[type & 0xff]; slot != 0; slot = m_index_refs[slot - 1].next) {
+        num++;
+    }
+
+    while ((m_index_full == true) && (find_tlv(m_buff, m_len, type, num) != NULL)) {
+        num++;
+    }
+
+    return num;
+}
+
+bool em_msg_t::is_malformed()
+{
+    if ((m_buff != m_index_base) || (m_len != m_index_len)) {
+        index_tlvs(m_buff, m_len);
+    }
+
+    return m_index_malformed;
 }
 
 em_tlv_t *em_msg_t::get_tlv(em_tlv_t* tlvs_buff, unsigned int buff_len, em_tlv_type_t type)
@@ -275,14 +372,18 @@ em_tlv_t *em_msg_t::get_tlv(em_tlv_t* tlvs_buff, unsigned int buff_len, em_tlv_t
     EM_ASSERT_MSG_TRUE(buff_len > 0, NULL, "Buffer length is zero");
 
     em_tlv_t    *tlv = tlvs_buff;
-    unsigned int len = buff_len;
+    unsigned int len = buff_len, tlv_len;
 
-    while ((tlv->type != em_tlv_type_eom) && (len > 0)) {
+    while (len >= sizeof(em_tlv_t)) {
+        tlv_len = static_cast<unsigned int> (sizeof(em_tlv_t) + ntohs(tlv->len));
+        if ((tlv->type == em_tlv_type_eom) || (tlv_len > len)) {
+            break;
+        }
         if (tlv->type == type) {
             return tlv; 
         }
-        len -= static_cast<unsigned int> (sizeof(em_tlv_t) + ntohs(tlv->len));
-        tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + ntohs(tlv->len));
+        len -= tlv_len;
+        tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + tlv_len);
     }
 
     return NULL;
@@ -291,7 +392,7 @@ em_tlv_t *em_msg_t::get_tlv(em_tlv_t* tlvs_buff, unsigned int buff_len, em_tlv_t
 em_tlv_t *em_msg_t::get_first_tlv(em_tlv_t* tlvs_buff, unsigned int buff_len)
 {
 
-    if (tlvs_buff == NULL || buff_len == 0) {
+    if (tlvs_buff == NULL || buff_len < sizeof(em_tlv_t)) {
         return NULL;
     }
 
@@ -396,34 +497,25 @@ unsigned char* em_msg_t::add_1905_header(unsigned char *buff, unsigned int *len,
 unsigned int em_msg_t::validate(char *errors[])
 {
     em_tlv_t *tlv;
-    unsigned int i, len;
+    unsigned char *tlvs = NULL;
+    unsigned int i, len = 0;
     bool validation = true;
 
-    for (i = 0; i < m_num_tlv; i++) {
-        tlv =  reinterpret_cast<em_tlv_t *> (m_buff + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
+    if ((m_buff != NULL) && (m_len > (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)))) {
+        tlvs = m_buff + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t);
         len = m_len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
+    }
 
-        while ((tlv->type != em_tlv_type_eom) && (len > 0)) {
-            if (tlv->type == m_tlv_member[i].m_type) {
-                m_tlv_member[i].m_present = true;
-                break;
-            }
-            len -= static_cast<unsigned int> (sizeof(em_tlv_t) + htons(tlv->len));
-            tlv = reinterpret_cast<em_tlv_t *> ((reinterpret_cast<unsigned char *>(tlv) + sizeof(em_tlv_t) + htons(tlv->len)));
-        }
+    for (i = 0; i < m_num_tlv; i++) {
+        tlv = find_tlv(tlvs, len, m_tlv_member[i].m_type, 0);
+        m_tlv_member[i].m_present = (tlv != NULL);
 
-        if ((m_tlv_member[i].m_requirement == mandatory) &&((m_tlv_member[i].m_present == false)||((sizeof(em_tlv_t) + htons(tlv->len)) < static_cast<size_t> (m_tlv_member[i].m_tlv_length)))) {
+        if ((m_tlv_member[i].m_requirement == mandatory) && ((tlv == NULL) ||
+                ((sizeof(em_tlv_t) + htons(tlv->len)) < static_cast<size_t> (m_tlv_member[i].m_tlv_length)))) {
             strncpy(m_errors[m_num_errors], m_tlv_member[i].m_spec, sizeof(m_errors[m_num_errors]));
             m_num_errors++;
             errors[m_num_errors - 1] = m_errors[m_num_errors - 1];
             validation = false;
-            if (m_tlv_member[i].m_present == false) { 
-                //printf("%s:%d; TLV not present\n", __func__, __LINE__);
-            }   
-
-            if (((sizeof(em_tlv_t) + htons(tlv->len)) < static_cast<size_t> (m_tlv_member[i].m_tlv_length))) {
-                //printf("%s:%d; TLV type: 0x%04x Length: %d, length validation error\n", __func__, __LINE__, tlv->type, htons(tlv->len));
-            }
         }
 
         if ((m_tlv_member[i].m_requirement == bad) && (m_tlv_member[i].m_present == true)) {
@@ -583,6 +675,7 @@ void em_msg_t::policy_config_req()
     m_tlv_member[m_num_tlv++] = em_tlv_member_t(em_tlv_type_unsucc_assoc_policy, (m_profile > em_profile_type_1) ? optional:bad, "17.2.58 of Wi-Fi Easy Mesh 5.0", 7);
     m_tlv_member[m_num_tlv++] = em_tlv_member_t(em_tlv_type_backhaul_bss_conf, (m_profile > em_profile_type_1) ? optional:bad, "17.2.66 of Wi-Fi Easy Mesh 5.0", 9); 
     m_tlv_member[m_num_tlv++] = em_tlv_member_t(em_tlv_type_qos_mgmt_policy, optional, "17.2.92 of Wi-Fi Easy Mesh 5.0", 37);
+    m_tlv_member[m_num_tlv++] = em_tlv_member_t(em_tlv_type_tid_to_link_map_policy, optional, "17.2.97 of Wi-Fi Easy Mesh 6.0", 64);
 }
 
 void em_msg_t::channel_pref_query()
@@ -703,7 +796,7 @@ void em_msg_t::unassoc_sta_link_metrics_query()
 }
 void em_msg_t::unassoc_sta_link_metrics_rsp()
 {
-    m_tlv_member[m_num_tlv++] = em_tlv_member_t(em_tlv_type_unassoc_sta_link_metric_rsp, mandatory, "17.2.26 of Wi-Fi Easy Mesh 5.0", 11);
+    m_tlv_member[m_num_tlv++] = em_tlv_member_t(em_tlv_type_unassoc_sta_link_metric_rsp, mandatory, "17.2.26 of Wi-Fi Easy Mesh 5.0", 5);
 }
 
 void em_msg_t::beacon_metrics_query()
@@ -903,6 +996,13 @@ em_msg_t::em_msg_t(em_msg_type_t type, em_profile_type_t profile, unsigned char
     m_len = len;
     m_num_errors = 0;   
 
+    // validate() looks the TLVs up behind the 1905 header
+    if ((tlvs != NULL) && (len > (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)))) {
+        index_tlvs(tlvs + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t), len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)));
+    } else {
+        index_tlvs(NULL, 0);
+    }
+
     switch (type) {
         case em_msg_type_autoconf_search:
             autoconfig_search();
@@ -912,6 +1012,9 @@ em_msg_t::em_msg_t(em_msg_type_t type, em_profile_type_t profile, unsigned char
             break;
 
         case em_msg_type_autoconf_wsc:
+            if ((tlvs == NULL) || (len <= (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)))) {
+                break;
+            }
             tlvs = tlvs + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t);
             len = static_cast<unsigned int>(len - (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)));
             if(em_configuration_t::get_wsc_msg_type(tlvs,len) == em_wsc_msg_type_m1) {
@@ -1204,12 +1307,15 @@ void em_msg_t::set_m1(unsigned char *tlvs, unsigned int len)
 {
     m_buff  = tlvs;
     m_len = len;
+    // the M1 may still be under construction, index it on the first lookup
+    index_tlvs(NULL, 0);
 }
 
 em_msg_t::em_msg_t(unsigned char *tlvs, unsigned int len)
 {
     m_buff  = tlvs;
     m_len = len;
+    index_tlvs(m_buff, m_len);
 }
 em_msg_t::~em_msg_t()
 {
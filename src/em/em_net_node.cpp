@@ -33,9 +33,231 @@
 #include <unistd.h>
 #include <pthread.h>
 #include <cjson/cJSON.h>
+#include <algorithm>
+#include <climits>
 #include "em_net_node.h"
 #include "em_cmd_exec.h"
 
+std::map<const em_network_node_t *, em_net_node_arena_t *> em_net_node_t::s_arena_blocks;
+pthread_mutex_t em_net_node_t::s_arena_lock = PTHREAD_MUTEX_INITIALIZER;
+
+em_network_node_t *em_net_node_arena_t::alloc()
+{
+    if (m_used == m_blocks.back().second) {
+        return NULL;
+    }
+
+    return &m_blocks.back().first[m_used++];
+}
+
+em_network_node_t *em_net_node_arena_t::add_block()
+{
+    unsigned int num = std::max(m_blocks.back().second, static_cast<unsigned int> (EM_NET_NODE_ARENA_MIN_BLOCK));
+
+    m_blocks.push_back(std::make_pair(static_cast<em_network_node_t *> (calloc(num, sizeof(em_network_node_t))), num));
+    m_used = 0;
+
+    return m_blocks.back().first;
+}
+
+bool em_net_node_arena_t::owns(const em_network_node_t *node)
+{
+    for (auto& it : m_blocks) {
+        if ((node >= it.first) && (node < it.first + it.second)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void em_net_node_arena_t::set_index(em_net_node_index_t *index)
+{
+    delete m_index;
+    m_index = index;
+}
+
+em_net_node_arena_t::em_net_node_arena_t(unsigned int num)
+{
+    m_index = NULL;
+    num = std::max(num, 1u);
+    m_blocks.push_back(std::make_pair(static_cast<em_network_node_t *> (calloc(num, sizeof(em_network_node_t))), num));
+    m_used = 0;
+}
+
+em_net_node_arena_t::~em_net_node_arena_t()
+{
+    delete m_index;
+    for (auto& it : m_blocks) {
+        free(it.first);
+    }
+}
+
+em_net_node_arena_t *em_net_node_t::create_arena(unsigned int num)
+{
+    em_net_node_arena_t *arena = new em_net_node_arena_t(num);
+
+    pthread_mutex_lock(&s_arena_lock);
+    s_arena_blocks[arena->get_root()] = arena;
+    pthread_mutex_unlock(&s_arena_lock);
+
+    return arena;
+}
+
+em_net_node_arena_t *em_net_node_t::find_arena(const em_network_node_t *node)
+{
+    em_net_node_arena_t *arena = NULL;
+
+    pthread_mutex_lock(&s_arena_lock);
+    auto it = s_arena_blocks.upper_bound(node);
+    if ((it != s_arena_blocks.begin()) && ((--it)->second->owns(node) == true)) {
+        arena = it->second;
+    }
+    pthread_mutex_unlock(&s_arena_lock);
+
+    return arena;
+}
+
+em_network_node_t *em_net_node_t::alloc_node(em_net_node_arena_t *arena)
+{
+    em_network_node_t *node;
+
+    if (arena == NULL) {
+        return static_cast<em_network_node_t *> (calloc(1, sizeof(em_network_node_t)));
+    }
+
+    // the tree changes, its index is built again on request
+    if (arena->get_index() != NULL) {
+        arena->set_index(NULL);
+    }
+
+    if ((node = arena->alloc()) == NULL) {
+        pthread_mutex_lock(&s_arena_lock);
+        s_arena_blocks[arena->add_block()] = arena;
+        pthread_mutex_unlock(&s_arena_lock);
+        node = arena->alloc();
+    }
+
+    return node;
+}
+
+unsigned int em_net_node_t::get_num_nodes(const em_network_node_t *node)
+{
+    unsigned int i, num = 1;
+
+    for (i = 0; i < node->num_children; i++) {
+        num += get_num_nodes(node->child[i]);
+    }
+
+    return num;
+}
+
+em_net_node_index_t *em_net_node_t::find_index(const em_network_node_t *node)
+{
+    em_net_node_arena_t *arena = find_arena(node);
+
+    return (arena != NULL) ? arena->get_index():NULL;
+}
+
+// the first of sorted depth first positions in the subtree at pos, UINT_MAX if none
+static unsigned int get_first_in_subtree(const std::vector<unsigned int>& positions, std::pair<unsigned int, unsigned int> pos)
+{
+    auto it = std::lower_bound(positions.begin(), positions.end(), pos.first);
+
+    return ((it != positions.end()) && (*it < pos.first + pos.second)) ? *it:UINT_MAX;
+}
+
+void em_net_node_t::index_network_tree_node(em_net_node_index_t *index, em_network_node_t *node, const std::string& path)
+{
+    unsigned int i, first = static_cast<unsigned int> (index->nodes.size());
+    std::string child_path;
+
+    index->nodes.push_back(node);
+    if (node->key[0] != 0) {
+        index->key[node->key].push_back(first);
+    }
+    index->ctr[node->display_info.node_ctr].push_back(first);
+    index->path.emplace(path, node);
+
+    for (i = 0; i < node->num_children; i++) {
+        child_path = path.empty() ? "":(path + ".");
+        child_path += (node->child[i]->key[0] != 0) ? std::string(node->child[i]->key):std::to_string(i);
+        index_network_tree_node(index, node->child[i], child_path);
+    }
+
+    index->pos[node] = std::make_pair(first, static_cast<unsigned int> (index->nodes.size()) - first);
+}
+
+int em_net_node_t::index_network_tree(em_network_node_t *tree)
+{
+    em_net_node_arena_t *arena;
+    em_net_node_index_t *index;
+
+    if ((tree == NULL) || ((arena = find_arena(tree)) == NULL) || (arena->get_root() != tree)) {
+        return -1;
+    }
+
+    index = new em_net_node_index_t;
+    index_network_tree_node(index, tree, "");
+    arena->set_index(index);
+
+    return 0;
+}
+
+em_network_node_t *em_net_node_t::get_network_tree_by_path(em_network_node_t *tree, const char *path)
+{
+    em_net_node_index_t *index;
+    em_network_node_t *node = tree;
+    const char *name, *end;
+    size_t len;
+    unsigned int i;
+
+    if ((tree == NULL) || (path == NULL)) {
+        return NULL;
+    }
+
+    if (((index = find_index(tree)) != NULL) && (index->nodes[0] == tree)) {
+        auto it = index->path.find(path);
+        return (it != index->path.end()) ? it->second:NULL;
+    }
+
+    name = path;
+    while ((*name != 0) && (node != NULL)) {
+        end = name + strcspn(name, ".");
+        len = static_cast<size_t> (end - name);
+        for (i = 0; i < node->num_children; i++) {
+            if (node->child[i]->key[0] != 0) {
+                if ((strlen(node->child[i]->key) == len) && (strncmp(node->child[i]->key, name, len) == 0)) {
+                    break;
+                }
+            } else if ((len > 0) && (strspn(name, "0123456789") == len) && (strtoul(name, NULL, 10) == i)) {
+                break;
+            }
+        }
+        node = (i < node->num_children) ? node->child[i]:NULL;
+
+        // an empty name, the last one included, is no node
+        name = (*end == '.') ? end + 1:end;
+        if ((*end == '.') && (*name == 0)) {
+            node = NULL;
+        }
+    }
+
+    return node;
+}
+
+static unsigned int get_num_json_nodes(const cJSON *obj)
+{
+    const cJSON *tmp;
+    unsigned int num = 1;
+
+    for (tmp = obj->child; tmp != NULL; tmp = tmp->next) {
+        num += get_num_json_nodes(tmp);
+    }
+
+    return num;
+}
+
 em_network_node_data_type_t em_net_node_t::get_node_type(em_network_node_t *node)
 {
     return node->type;
@@ -84,6 +306,7 @@ void em_net_node_t::set_node_array_value(em_network_node_t *node, char *fmt)
 	em_long_string_t value;
 	char *tmp, *remain;
 	em_network_node_data_type_t arrType = em_network_node_data_type_invalid;
+	em_net_node_arena_t *arena;
 
 	if (node->type == em_network_node_data_type_array_str) {
 		arrType = em_network_node_data_type_string;
@@ -110,6 +333,9 @@ void em_net_node_t::set_node_array_value(em_network_node_t *node, char *fmt)
 		
 	snprintf(value, sizeof(em_long_string_t), "%s", tmp);
 
+	// the elements go in the arena of the tree being edited, if it has one
+	arena = find_arena(node);
+
 	tmp = value;
 	remain = value;
 
@@ -117,8 +343,7 @@ void em_net_node_t::set_node_array_value(em_network_node_t *node, char *fmt)
 	while ((tmp = strstr(remain, ", ")) != NULL) {
 		*tmp = 0;
 	
-		node->child[node->num_children] = static_cast<em_network_node_t *>(malloc(sizeof(em_network_node_t)));
-		memset(node->child[node->num_children], 0, sizeof(em_network_node_t));
+		node->child[node->num_children] = alloc_node(arena);
 		node->child[node->num_children]->type = arrType;
 		if (arrType == em_network_node_data_type_string) {
 			strncpy(node->child[node->num_children]->value_str, remain, sizeof(em_long_string_t));
@@ -135,8 +360,7 @@ void em_net_node_t::set_node_array_value(em_network_node_t *node, char *fmt)
 		*tmp = 0;
 	}
 
-	node->child[node->num_children] = static_cast<em_network_node_t *> (malloc(sizeof(em_network_node_t)));
-	memset(node->child[node->num_children], 0, sizeof(em_network_node_t));
+	node->child[node->num_children] = alloc_node(arena);
 	node->child[node->num_children]->type = arrType;
 	if (arrType == em_network_node_data_type_string) {
 		strncpy(node->child[node->num_children]->value_str, remain, sizeof(em_long_string_t));
@@ -439,10 +663,10 @@ void *em_net_node_t::network_tree_to_json(em_network_node_t *root)
     return obj;	
 }
 
-int em_net_node_t::get_network_tree_node(cJSON *obj, em_network_node_t *root, unsigned int *node_display_ctr)
+int em_net_node_t::get_network_tree_node(cJSON *obj, em_network_node_t *root, unsigned int *node_display_ctr,
+                                         em_net_node_arena_t *arena)
 {
     cJSON *child_obj, *tmp_obj;
-    size_t sz = 0;
 
     if (obj->string != NULL) {
         strncpy(root->key, obj->string, strlen(obj->string) + 1);
@@ -480,10 +704,7 @@ int em_net_node_t::get_network_tree_node(cJSON *obj, em_network_node_t *root, un
 
     while (tmp_obj != NULL) {
 
-        //TBD with details as this needs to be revisited
-        sz = sizeof(em_network_node_t) * 2;
-        root->child[root->num_children] = static_cast<em_network_node_t *> (malloc(sz));
-        memset(root->child[root->num_children], 0, sz);
+        root->child[root->num_children] = alloc_node(arena);
 
         if (cJSON_IsArray(obj) == true) {
             if ((cJSON_IsObject(tmp_obj) == true) || (cJSON_IsArray(tmp_obj) == true)) {
@@ -495,7 +716,7 @@ int em_net_node_t::get_network_tree_node(cJSON *obj, em_network_node_t *root, un
         root->child[root->num_children]->display_info.node_ctr = *node_display_ctr;
         root->child[root->num_children]->display_info.orig_node_ctr = *node_display_ctr;
         root->child[root->num_children]->display_info.node_pos = root->display_info.node_pos + 1;
-        get_network_tree_node(tmp_obj, root->child[root->num_children], node_display_ctr);
+        get_network_tree_node(tmp_obj, root->child[root->num_children], node_display_ctr, arena);
 
         root->num_children++;
 
@@ -509,6 +730,7 @@ em_network_node_t *em_net_node_t::get_network_tree(char *buff)
 {
     cJSON *root_obj = NULL;
     em_network_node_t *root;
+    em_net_node_arena_t *arena;
     unsigned int node_display_ctr = 0;
 
 	if ((buff == NULL) || (*buff == 0)) {
@@ -521,10 +743,11 @@ em_network_node_t *em_net_node_t::get_network_tree(char *buff)
 
 	//printf("%s:%d: %s\n", __func__, __LINE__, cJSON_Print(root_obj));
 
-    root = static_cast<em_network_node_t *> (malloc(sizeof(em_network_node_t)));
-    memset(root, 0, sizeof(em_network_node_t));
+    // one block for the whole tree, the root first
+    arena = create_arena(get_num_json_nodes(root_obj));
+    root = alloc_node(arena);
 
-    get_network_tree_node(root_obj, root, &node_display_ctr);
+    get_network_tree_node(root_obj, root, &node_display_ctr, arena);
 
     cJSON_Delete(root_obj);
 
@@ -533,18 +756,38 @@ em_network_node_t *em_net_node_t::get_network_tree(char *buff)
 }
 
 em_network_node_t *em_net_node_t::get_node_from_node_ctr(em_network_node_t *tree, unsigned int node_display_ctr)
+{
+    em_net_node_index_t *index;
+    unsigned int first;
+
+    if (tree == NULL) return NULL;
+
+    if ((index = find_index(tree)) != NULL) {
+        auto pos = index->pos.find(tree);
+        if (pos != index->pos.end()) {
+            auto it = index->ctr.find(node_display_ctr);
+            if (it == index->ctr.end()) {
+                return NULL;
+            }
+            first = get_first_in_subtree(it->second, pos->second);
+            return (first != UINT_MAX) ? index->nodes[first]:NULL;
+        }
+    }
+
+    return search_node_from_node_ctr(tree, node_display_ctr);
+}
+
+em_network_node_t *em_net_node_t::search_node_from_node_ctr(em_network_node_t *tree, unsigned int node_display_ctr)
 {
     em_network_node_t *node = NULL;
     bool found_match = false;
     unsigned int i;
 
-    if (tree == NULL) return NULL;
-
     if (tree->display_info.node_ctr == node_display_ctr) {
         return tree;
     } else {
         for (i = 0; i < tree->num_children; i++) {
-            if ((node = get_node_from_node_ctr(tree->child[i], node_display_ctr)) != NULL) {
+            if ((node = search_node_from_node_ctr(tree->child[i], node_display_ctr)) != NULL) {
                 found_match = true;
                 break;
             }
@@ -560,15 +803,19 @@ em_network_node_t *em_net_node_t::get_node_from_node_ctr(em_network_node_t *tree
 
 em_network_node_t *em_net_node_t::clone_network_tree(em_network_node_t *node)
 {
-    em_network_node_t *cloned = NULL;
-	unsigned int i;
-
     if (node == NULL) {
         return NULL;
     }
 
-    cloned = static_cast<em_network_node_t *> (malloc(sizeof(em_network_node_t)));
-    memset(cloned, 0, sizeof(em_network_node_t));
+    return clone_network_tree_node(node, create_arena(get_num_nodes(node)));
+}
+
+em_network_node_t *em_net_node_t::clone_network_tree_node(em_network_node_t *node, em_net_node_arena_t *arena)
+{
+    em_network_node_t *cloned = NULL;
+	unsigned int i;
+
+    cloned = alloc_node(arena);
 
     strncpy(cloned->key, node->key, strlen(node->key) + 1);
     memcpy(&cloned->display_info, &node->display_info, sizeof(em_node_display_info_t));
@@ -579,7 +826,7 @@ em_network_node_t *em_net_node_t::clone_network_tree(em_network_node_t *node)
     cloned->value_int = node->value_int;
 
 	for (i = 0; i < node->num_children; i++) {
-     	cloned->child[i] = clone_network_tree(node->child[i]);
+     	cloned->child[i] = clone_network_tree_node(node->child[i], arena);
     	cloned->num_children++;
     }
 
@@ -588,11 +835,6 @@ em_network_node_t *em_net_node_t::clone_network_tree(em_network_node_t *node)
 
 em_network_node_t *em_net_node_t::clone_network_tree_for_display(em_network_node_t *orig_node, em_network_node_t *dis_node, unsigned int index, bool collapse, unsigned int *node_display_ctr)
 {
-    em_network_node_t *cloned = NULL, *tree_to_add = NULL;
-    unsigned int i;
-    bool should_consider = false;
-    bool trim_result = false;
-    em_network_node_t *node;
     unsigned int start_node_ctr = 0;
 
     if (node_display_ctr == NULL) {
@@ -603,6 +845,20 @@ em_network_node_t *em_net_node_t::clone_network_tree_for_display(em_network_node
         return NULL;
     }
 
+    // the tree shown is about as large as the one it is redrawn from
+    return clone_network_tree_for_display_node(orig_node, dis_node, index, collapse, node_display_ctr,
+        create_arena(get_num_nodes((dis_node != NULL) ? dis_node:orig_node)));
+}
+
+em_network_node_t *em_net_node_t::clone_network_tree_for_display_node(em_network_node_t *orig_node, em_network_node_t *dis_node,
+        unsigned int index, bool collapse, unsigned int *node_display_ctr, em_net_node_arena_t *arena)
+{
+    em_network_node_t *cloned = NULL, *tree_to_add = NULL;
+    unsigned int i;
+    bool should_consider = false;
+    bool trim_result = false;
+    em_network_node_t *node;
+
     if (dis_node == NULL) {
         node = orig_node;
     } else {
@@ -618,8 +874,7 @@ em_network_node_t *em_net_node_t::clone_network_tree_for_display(em_network_node
 		}
 	}
 
-    cloned = static_cast<em_network_node_t *> (malloc(sizeof(em_network_node_t)));
-    memset(cloned, 0, sizeof(em_network_node_t));
+    cloned = alloc_node(arena);
 
 	if (trim_result == false) {
     	strncpy(cloned->key, node->key, strlen(node->key) + 1);
@@ -651,7 +906,8 @@ em_network_node_t *em_net_node_t::clone_network_tree_for_display(em_network_node
                 } else {
                     (*node_display_ctr)++;
                 }
-                cloned->child[i] = clone_network_tree_for_display(orig_node, tree_to_add->child[i], index, collapse, node_display_ctr);
+                cloned->child[i] = clone_network_tree_for_display_node(orig_node, tree_to_add->child[i], index, collapse,
+                    node_display_ctr, arena);
             }
             cloned->display_info.collapsed = false;
             cloned->num_children = tree_to_add->num_children;
@@ -672,7 +928,8 @@ em_network_node_t *em_net_node_t::clone_network_tree_for_display(em_network_node
             } else {
                 (*node_display_ctr)++;
             }
-            cloned->child[i] = clone_network_tree_for_display(orig_node, node->child[i], index, collapse, node_display_ctr);
+            cloned->child[i] = clone_network_tree_for_display_node(orig_node, node->child[i], index, collapse,
+                node_display_ctr, arena);
             cloned->num_children++;
         }
 
@@ -692,20 +949,43 @@ em_network_node_t *em_net_node_t::get_network_tree_by_file(const char *file_name
     return get_network_tree(buff);
 }
 
-void em_net_node_t::free_network_tree_node(em_network_node_t *node)
+void em_net_node_t::free_network_tree_node(em_network_node_t *node, em_net_node_arena_t *arena)
 {
     unsigned int i;
 
     for (i = 0; i < node->num_children; i++) {
-        free_network_tree_node(node->child[i]);
+        free_network_tree_node(node->child[i], arena);
+    }
+
+    // a node of an arena goes with the root of its tree
+    if (((arena != NULL) && (arena->owns(node) == true)) || (find_arena(node) != NULL)) {
+        return;
     }
 
     free(node);
 }
 
+void em_net_node_t::free_network_tree_node(em_network_node_t *node)
+{
+    free_network_tree(node);
+}
+
 void em_net_node_t::free_network_tree(em_network_node_t *node)
 {
-    free_network_tree_node(node);
+    em_net_node_arena_t *arena = find_arena(node);
+
+    free_network_tree_node(node, arena);
+
+    if ((arena == NULL) || (arena->get_root() != node)) {
+        return;
+    }
+
+    pthread_mutex_lock(&s_arena_lock);
+    for (auto& it : arena->get_blocks()) {
+        s_arena_blocks.erase(it.first);
+    }
+    pthread_mutex_unlock(&s_arena_lock);
+    delete arena;
 }
 
 em_network_node_t *em_net_node_t::get_child_node_at_index(em_network_node_t *node, unsigned int idx)
@@ -720,6 +1000,28 @@ unsigned int em_net_node_t::get_node_display_position(em_network_node_t *node)
 }
 
 em_network_node_t *em_net_node_t::get_network_tree_by_key(em_network_node_t *node, em_long_string_t key)
+{
+	em_net_node_index_t *index;
+	unsigned int first, best = UINT_MAX;
+	size_t len = strlen(key);
+
+	if ((len > 0) && ((index = find_index(node)) != NULL)) {
+		auto pos = index->pos.find(node);
+		if (pos != index->pos.end()) {
+			// the keys starting with key are next to each other in the index
+			for (auto it = index->key.lower_bound(key); (it != index->key.end()) &&
+					(strncmp(it->first.c_str(), key, len) == 0); ++it) {
+				first = get_first_in_subtree(it->second, pos->second);
+				best = std::min(best, first);
+			}
+			return (best != UINT_MAX) ? index->nodes[best]:NULL;
+		}
+	}
+
+	return search_network_tree_by_key(node, key);
+}
+
+em_network_node_t *em_net_node_t::search_network_tree_by_key(em_network_node_t *node, const char *key)
 {
 	unsigned int i;
 	em_network_node_t *tmp;
@@ -729,7 +1031,7 @@ em_network_node_t *em_net_node_t::get_network_tree_by_key(em_network_node_t *nod
 	}	
 
 	for (i = 0; i < node->num_children; i++) {
-		if ((tmp = get_network_tree_by_key(node->child[i], key)) != NULL) {
+		if ((tmp = search_network_tree_by_key(node->child[i], key)) != NULL) {
 			return tmp;
 		}	
 	}
@@ -840,3 +1142,13 @@ extern "C" em_network_node_t *get_network_tree_by_key(em_network_node_t *node, e
 {
 	return em_net_node_t::get_network_tree_by_key(node, key);
 }
+
+extern "C" int index_network_tree(em_network_node_t *tree)
+{
+    return em_net_node_t::index_network_tree(tree);
+}
+
+extern "C" em_network_node_t *get_network_tree_by_path(em_network_node_t *tree, const char *path)
+{
+    return em_net_node_t::get_network_tree_by_path(tree, path);
+}
@@ -45,6 +45,7 @@
 #include <ifaddrs.h>
 #include "em_onewifi.h"
 #include "util.h"
+#include "em_hex.h"
 
 em_onewifi_t::em_onewifi_t()
 {
@@ -58,28 +59,13 @@ em_onewifi_t::~em_onewifi_t()
 
 char *em_onewifi_t::macbytes_to_string(mac_address_t mac, char* string)
 {
-	sprintf(const_cast<char *> (string), "%02x:%02x:%02x:%02x:%02x:%02x",
-            mac[0] & 0xff,
-            mac[1] & 0xff,
-            mac[2] & 0xff,
-            mac[3] & 0xff,
-            mac[4] & 0xff,
-            mac[5] & 0xff);
+    em_hex::mac_to_str(mac, string);
     return const_cast<char *> (string);
 }
 
 void em_onewifi_t::string_to_macbytes(char *key, mac_address_t bmac) 
 {
-    unsigned int mac[6];
-    if (strlen(key) > MIN_MAC_LEN)
-        sscanf(key, "%02x:%02x:%02x:%02x:%02x:%02x",
-                &mac[0], &mac[1], &mac[2], &mac[3], &mac[4], &mac[5]);
-    else
-        sscanf(key, "%02x%02x%02x%02x%02x%02x",
-                &mac[0], &mac[1], &mac[2], &mac[3], &mac[4], &mac[5]);
-    bmac[0] = static_cast<unsigned char> (mac[0]); bmac[1] = static_cast<unsigned char> (mac[1]); bmac[2] = static_cast<unsigned char> (mac[2]);
-    bmac[3] = static_cast<unsigned char> (mac[3]); bmac[4] = static_cast<unsigned char> (mac[4]); bmac[5] = static_cast<unsigned char> (mac[5]);
-
+    em_hex::str_to_mac(key, bmac);
 }
 
 int em_onewifi_t::mac_address_from_name(const char *ifname, mac_address_t mac)
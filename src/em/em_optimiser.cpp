@@ -0,0 +1,231 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <algorithm>
+#include "em_optimiser.h"
+
+unsigned long long em_optimiser_host_t::now_cpu_us()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+
+    return static_cast<unsigned long long> (ts.tv_sec) * 1000000 + static_cast<unsigned long long> (ts.tv_nsec / 1000);
+}
+
+int em_optimiser_host_t::add(em_optimiser_t *plugin)
+{
+    em_optimiser_stats_t stats;
+    int idx = -1;
+
+    memset(&stats, 0, sizeof(em_optimiser_stats_t));
+
+    pthread_mutex_lock(&m_lock);
+    if ((m_plugins.size() < EM_OPTIMISER_MAX_PLUGINS) &&
+            (std::find(m_plugins.begin(), m_plugins.end(), plugin) == m_plugins.end())) {
+        idx = static_cast<int> (m_plugins.size());
+        m_plugins.push_back(plugin);
+        m_stats.push_back(stats);
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return idx;
+}
+
+void em_optimiser_host_t::remove(em_optimiser_t *plugin)
+{
+    std::vector<em_optimiser_t *>::iterator it;
+
+    pthread_mutex_lock(&m_lock);
+    if ((it = std::find(m_plugins.begin(), m_plugins.end(), plugin)) != m_plugins.end()) {
+        m_stats.erase(m_stats.begin() + (it - m_plugins.begin()));
+        m_plugins.erase(it);
+        m_next = 0;
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+void em_optimiser_host_t::radio_changed(const em_optimiser_radio_t *radio)
+{
+    unsigned int i;
+
+    pthread_mutex_lock(&m_lock);
+    for (i = 0; i < m_plugins.size(); i++) {
+        m_plugins[i]->radio_changed(radio);
+        m_stats[i].events++;
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+void em_optimiser_host_t::bss_added(const unsigned char *bssid, const unsigned char *ruid)
+{
+    unsigned int i;
+
+    pthread_mutex_lock(&m_lock);
+    for (i = 0; i < m_plugins.size(); i++) {
+        m_plugins[i]->bss_added(bssid, ruid);
+        m_stats[i].events++;
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+void em_optimiser_host_t::sta_sample(const unsigned char *sta, const unsigned char *bssid, const em_metrics_sample_t *sample)
+{
+    unsigned int i;
+
+    pthread_mutex_lock(&m_lock);
+    for (i = 0; i < m_plugins.size(); i++) {
+        m_plugins[i]->sta_sample(sta, bssid, sample);
+        m_stats[i].events++;
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+void em_optimiser_host_t::bss_sample(const unsigned char *bssid, const em_metrics_sample_t *sample)
+{
+    unsigned int i;
+
+    pthread_mutex_lock(&m_lock);
+    for (i = 0; i < m_plugins.size(); i++) {
+        m_plugins[i]->bss_sample(bssid, sample);
+        m_stats[i].events++;
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+void em_optimiser_host_t::scan_result(const em_scan_result_t *res)
+{
+    unsigned int i;
+
+    pthread_mutex_lock(&m_lock);
+    for (i = 0; i < m_plugins.size(); i++) {
+        m_plugins[i]->scan_result(res);
+        m_stats[i].events++;
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+unsigned int em_optimiser_host_t::run(unsigned long long now, unsigned long long budget_us, em_optimiser_action_t *actions,
+                                      unsigned int max)
+{
+    em_optimiser_stats_t *stats;
+    unsigned long long start, plugin_start, used, left;
+    unsigned int i, j, idx, num = 0, got, count;
+
+    pthread_mutex_lock(&m_lock);
+    count = static_cast<unsigned int> (m_plugins.size());
+    start = now_cpu_us();
+    for (i = 0; i < count; i++) {
+        idx = (m_next + i) % count;
+        stats = &m_stats[idx];
+        used = now_cpu_us() - start;
+        if ((used >= budget_us) || (num >= max)) {
+            stats->skipped++;
+            continue;
+        }
+        left = budget_us - used;
+
+        plugin_start = now_cpu_us();
+        got = std::min(m_plugins[idx]->optimise(now, left, &actions[num], max - num), max - num);
+        stats->last_us = now_cpu_us() - plugin_start;
+        for (j = num; j < num + got; j++) {
+            actions[j].plugin = idx;
+        }
+        num += got;
+
+        stats->cycles++;
+        stats->actions += got;
+        if (stats->last_us > stats->max_us) {
+            stats->max_us = stats->last_us;
+        }
+        if (stats->last_us > left) {
+            stats->overruns++;
+        }
+    }
+    if (count > 0) {
+        m_next = (m_next + 1) % count;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    std::stable_sort(actions, actions + num,
+        [](const em_optimiser_action_t& a, const em_optimiser_action_t& b) { return a.score > b.score; });
+
+    return num;
+}
+
+void em_optimiser_host_t::applied(const em_optimiser_action_t *action, unsigned long long now)
+{
+    pthread_mutex_lock(&m_lock);
+    if (action->plugin < m_plugins.size()) {
+        m_plugins[action->plugin]->applied(action, now);
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+unsigned int em_optimiser_host_t::count()
+{
+    unsigned int num;
+
+    pthread_mutex_lock(&m_lock);
+    num = static_cast<unsigned int> (m_plugins.size());
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+const char *em_optimiser_host_t::get_name(unsigned int plugin)
+{
+    const char *name = NULL;
+
+    pthread_mutex_lock(&m_lock);
+    if (plugin < m_plugins.size()) {
+        name = m_plugins[plugin]->get_name();
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return name;
+}
+
+bool em_optimiser_host_t::get_stats(unsigned int plugin, em_optimiser_stats_t *stats)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&m_lock);
+    if (plugin < m_stats.size()) {
+        *stats = m_stats[plugin];
+        found = true;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return found;
+}
+
+em_optimiser_host_t::em_optimiser_host_t()
+{
+    pthread_mutex_init(&m_lock, NULL);
+    m_next = 0;
+}
+
+em_optimiser_host_t::~em_optimiser_host_t()
+{
+    pthread_mutex_destroy(&m_lock);
+}
@@ -0,0 +1,167 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "em_perf.h"
+
+em_perf_shard_t em_perf_t::s_shards[EM_PERF_MAX_SHARDS];
+std::atomic<unsigned int> em_perf_t::s_next_shard(0);
+std::atomic<uint64_t> em_perf_t::s_gauges[em_perf_gauge_max];
+std::atomic<uint64_t> em_perf_t::s_gauge_max[em_perf_gauge_max];
+
+static const char *s_ctr_str[em_perf_ctr_max] = {
+    "MgrEventsQueued",
+    "MgrEventsDropped",
+    "MgrEventsHandled",
+    "FramesRx",
+    "NodeFramesDropped",
+    "FramesTx",
+    "FramesTxErrors",
+    "BytesTx",
+    "OrchCommandsSubmitted",
+    "OrchCommandsDone",
+    "DbQueries",
+    "DbErrors",
+    "Tr181Gets",
+};
+
+static const char *s_gauge_str[em_perf_gauge_max] = {
+    "MgrQueueDepth",
+    "OrchPending",
+    "OrchActive",
+};
+
+static const char *s_hist_str[em_perf_hist_max] = {
+    "MgrEvent",
+    "ProtoProcess",
+    "SendFrame",
+    "OrchRun",
+    "DbExecute",
+    "Tr181Get",
+    "ApCapReportSmall",
+    "ApCapReportMedium",
+    "ApCapReportLarge",
+};
+
+// counter values at the previous encode, for the rates
+static pthread_mutex_t s_rate_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t s_rate_last[em_perf_ctr_max];
+static uint64_t s_rate_last_us;
+
+uint64_t em_perf_t::get_counter(em_perf_ctr_t ctr)
+{
+    uint64_t total = 0;
+    unsigned int i;
+
+    for (i = 0; i < EM_PERF_MAX_SHARDS; i++) {
+        total += s_shards[i].ctrs[ctr].load(std::memory_order_relaxed);
+    }
+
+    return total;
+}
+
+void em_perf_t::get_hist(em_perf_hist_t hist, em_lat_hist_t *out)
+{
+    uint64_t buckets[EM_LAT_HIST_BUCKETS];
+    unsigned int i, j;
+
+    for (i = 0; i < EM_PERF_MAX_SHARDS; i++) {
+        for (j = 0; j < EM_LAT_HIST_BUCKETS; j++) {
+            buckets[j] = s_shards[i].buckets[hist][j].load(std::memory_order_relaxed);
+        }
+        out->merge(buckets, s_shards[i].sum_us[hist].load(std::memory_order_relaxed),
+            s_shards[i].max_us[hist].load(std::memory_order_relaxed));
+    }
+}
+
+void em_perf_t::encode(cJSON *obj)
+{
+    cJSON *ctrs, *gauges, *lat, *item;
+    uint64_t now_us, val, elapsed_us;
+    unsigned int i;
+
+    now_us = em_lat_hist_t::get_time_us();
+
+    pthread_mutex_lock(&s_rate_lock);
+    elapsed_us = (s_rate_last_us == 0) ? 0:(now_us - s_rate_last_us);
+    ctrs = cJSON_AddObjectToObject(obj, "Counters");
+    for (i = 0; i < em_perf_ctr_max; i++) {
+        val = get_counter(static_cast<em_perf_ctr_t>(i));
+        item = cJSON_AddObjectToObject(ctrs, s_ctr_str[i]);
+        cJSON_AddNumberToObject(item, "Total", static_cast<double>(val));
+        // a reset in between makes the counter go back, report no rate then
+        cJSON_AddNumberToObject(item, "PerSec", ((elapsed_us == 0) || (val < s_rate_last[i])) ? 0:
+            static_cast<double>(val - s_rate_last[i]) * 1000000.0 / static_cast<double>(elapsed_us));
+        s_rate_last[i] = val;
+    }
+    s_rate_last_us = now_us;
+    pthread_mutex_unlock(&s_rate_lock);
+
+    gauges = cJSON_AddObjectToObject(obj, "Gauges");
+    for (i = 0; i < em_perf_gauge_max; i++) {
+        item = cJSON_AddObjectToObject(gauges, s_gauge_str[i]);
+        cJSON_AddNumberToObject(item, "Value", static_cast<double>(get_gauge(static_cast<em_perf_gauge_t>(i))));
+        cJSON_AddNumberToObject(item, "Max", static_cast<double>(get_gauge_max(static_cast<em_perf_gauge_t>(i))));
+    }
+
+    lat = cJSON_AddObjectToObject(obj, "Latency");
+    for (i = 0; i < em_perf_hist_max; i++) {
+        em_lat_hist_t hist;
+        get_hist(static_cast<em_perf_hist_t>(i), &hist);
+        hist.encode(cJSON_AddObjectToObject(lat, s_hist_str[i]));
+    }
+}
+
+void em_perf_t::reset()
+{
+    unsigned int i, j, k;
+
+    for (i = 0; i < EM_PERF_MAX_SHARDS; i++) {
+        for (j = 0; j < em_perf_ctr_max; j++) {
+            s_shards[i].ctrs[j].store(0, std::memory_order_relaxed);
+        }
+        for (j = 0; j < em_perf_hist_max; j++) {
+            for (k = 0; k < EM_LAT_HIST_BUCKETS; k++) {
+                s_shards[i].buckets[j][k].store(0, std::memory_order_relaxed);
+            }
+            s_shards[i].sum_us[j].store(0, std::memory_order_relaxed);
+            s_shards[i].max_us[j].store(0, std::memory_order_relaxed);
+        }
+    }
+    for (i = 0; i < em_perf_gauge_max; i++) {
+        s_gauges[i].store(0, std::memory_order_relaxed);
+        s_gauge_max[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+const char *em_perf_t::get_counter_str(em_perf_ctr_t ctr)
+{
+    return (ctr < em_perf_ctr_max) ? s_ctr_str[ctr]:"unknown";
+}
+
+const char *em_perf_t::get_gauge_str(em_perf_gauge_t gauge)
+{
+    return (gauge < em_perf_gauge_max) ? s_gauge_str[gauge]:"unknown";
+}
+
+const char *em_perf_t::get_hist_str(em_perf_hist_t hist)
+{
+    return (hist < em_perf_hist_max) ? s_hist_str[hist]:"unknown";
+}
@@ -0,0 +1,220 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "em_policy_push.h"
+
+unsigned long long em_policy_push_t::pending_key(const unsigned char *agent, unsigned short msg_id)
+{
+    unsigned long long key = 0;
+
+    memcpy(&key, agent, sizeof(mac_address_t));
+
+    return key | (static_cast<unsigned long long>(msg_id) << 48);
+}
+
+unsigned int em_policy_push_t::get_encoding(unsigned long long key, const unsigned char *ruid, unsigned char *buff, unsigned int size)
+{
+    unsigned int i, len = 0;
+
+    pthread_mutex_lock(&m_lock);
+    for (auto& e : m_encodings) {
+        if ((e.key != key) || (e.len > size)) {
+            continue;
+        }
+        memcpy(buff, e.tlvs, e.len);
+        for (i = 0; i < e.num_ruid; i++) {
+            memcpy(buff + e.ruid_off[i], ruid, sizeof(mac_address_t));
+        }
+        e.last_used = ++m_use;
+        len = e.len;
+        m_stats.reused++;
+        break;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return len;
+}
+
+int em_policy_push_t::put_encoding(unsigned long long key, const unsigned char *tlvs, unsigned int len,
+                                   const unsigned short *ruid_off, unsigned int num_ruid)
+{
+    em_policy_push_encoding_t *e = NULL;
+    unsigned int i;
+
+    if ((len > sizeof(e->tlvs)) || (num_ruid > EM_POLICY_PUSH_MAX_RUID)) {
+        return -1;
+    }
+    for (i = 0; i < num_ruid; i++) {
+        if (ruid_off[i] + sizeof(mac_address_t) > len) {
+            return -1;
+        }
+    }
+
+    pthread_mutex_lock(&m_lock);
+    m_stats.encoded++;
+    for (auto& it : m_encodings) {
+        if (it.key == key) {
+            e = &it;
+            break;
+        }
+    }
+    if (e == NULL) {
+        if (m_encodings.size() < EM_POLICY_PUSH_MAX_ENCODINGS) {
+            m_encodings.emplace_back();
+            e = &m_encodings.back();
+        } else {
+            e = &m_encodings[0];
+            for (auto& it : m_encodings) {
+                if (it.last_used < e->last_used) {
+                    e = &it;
+                }
+            }
+        }
+    }
+
+    e->key = key;
+    e->len = len;
+    memcpy(e->tlvs, tlvs, len);
+    e->num_ruid = num_ruid;
+    memcpy(e->ruid_off, ruid_off, num_ruid * sizeof(unsigned short));
+    e->last_used = ++m_use;
+    pthread_mutex_unlock(&m_lock);
+
+    return 0;
+}
+
+unsigned int em_policy_push_t::clear_encodings()
+{
+    unsigned int num;
+
+    pthread_mutex_lock(&m_lock);
+    num = static_cast<unsigned int>(m_encodings.size());
+    m_encodings.clear();
+    m_stats.cleared += num;
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+void em_policy_push_t::sent(const unsigned char *agent, unsigned short msg_id, unsigned long long now)
+{
+    unsigned long long key = pending_key(agent, msg_id);
+    em_policy_push_pending_t *p;
+
+    pthread_mutex_lock(&m_lock);
+    if ((m_pending.size() >= EM_POLICY_PUSH_MAX_PENDING) && (m_pending.find(key) == m_pending.end())) {
+        auto oldest = m_pending.begin();
+        for (auto it = m_pending.begin(); it != m_pending.end(); ++it) {
+            if (it->second.sent_ms < oldest->second.sent_ms) {
+                oldest = it;
+            }
+        }
+        m_pending.erase(oldest);
+        m_stats.expired++;
+    }
+
+    p = &m_pending[key];
+    memcpy(p->agent, agent, sizeof(mac_address_t));
+    p->msg_id = msg_id;
+    p->sent_ms = now;
+    m_stats.sent++;
+    pthread_mutex_unlock(&m_lock);
+}
+
+bool em_policy_push_t::ack(const unsigned char *agent, unsigned short msg_id, unsigned long long now)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&m_lock);
+    auto it = m_pending.find(pending_key(agent, msg_id));
+    if (it != m_pending.end()) {
+        if (now - it->second.sent_ms > m_stats.max_ack_ms) {
+            m_stats.max_ack_ms = now - it->second.sent_ms;
+        }
+        m_pending.erase(it);
+        m_stats.acked++;
+        found = true;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return found;
+}
+
+unsigned int em_policy_push_t::expire(unsigned long long now)
+{
+    unsigned int num = 0;
+
+    pthread_mutex_lock(&m_lock);
+    for (auto it = m_pending.begin(); it != m_pending.end(); ) {
+        if (now - it->second.sent_ms >= EM_POLICY_PUSH_TIMEOUT_MS) {
+            it = m_pending.erase(it);
+            num++;
+        } else {
+            ++it;
+        }
+    }
+    m_stats.expired += num;
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+unsigned int em_policy_push_t::pending(const unsigned char *agent)
+{
+    unsigned int num = 0;
+
+    pthread_mutex_lock(&m_lock);
+    if (agent == NULL) {
+        num = static_cast<unsigned int>(m_pending.size());
+    } else {
+        for (auto& it : m_pending) {
+            if (memcmp(it.second.agent, agent, sizeof(mac_address_t)) == 0) {
+                num++;
+            }
+        }
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+em_policy_push_stats_t em_policy_push_t::get_stats()
+{
+    em_policy_push_stats_t stats;
+
+    pthread_mutex_lock(&m_lock);
+    stats = m_stats;
+    pthread_mutex_unlock(&m_lock);
+
+    return stats;
+}
+
+em_policy_push_t::em_policy_push_t()
+{
+    pthread_mutex_init(&m_lock, NULL);
+    memset(&m_stats, 0, sizeof(em_policy_push_stats_t));
+    m_use = 0;
+}
+
+em_policy_push_t::~em_policy_push_t()
+{
+    pthread_mutex_destroy(&m_lock);
+}
@@ -0,0 +1,239 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "em_profile.h"
+
+#define EM_PROFILE_TYPE_OTHER   0xffffffff  // CMDU types without a slot of their own
+
+static_assert(EM_MSG_TYPE_SLOTS <= EM_PROFILE_MAX_TYPES, "CMDU slots do not fit the profile");
+
+std::atomic<uint64_t> em_profile_t::s_count[em_profile_domain_max][EM_PROFILE_MAX_TYPES];
+std::atomic<uint64_t> em_profile_t::s_cpu_ns[em_profile_domain_max][EM_PROFILE_MAX_TYPES];
+std::atomic<uint64_t> em_profile_t::s_max_cpu_ns[em_profile_domain_max][EM_PROFILE_MAX_TYPES];
+std::atomic<uint64_t> em_profile_t::s_allocs[em_profile_domain_max][EM_PROFILE_MAX_TYPES];
+std::atomic<uint64_t> em_profile_t::s_alloc_bytes[em_profile_domain_max][EM_PROFILE_MAX_TYPES];
+
+static const char *s_domain_str[em_profile_domain_max] = {
+    "Bus",
+    "Event",
+    "CMDU",
+};
+
+#ifdef EM_PROFILE
+static __thread uint64_t t_allocs;
+static __thread uint64_t t_alloc_bytes;
+
+#if defined(__SANITIZE_ADDRESS__)
+extern "C" int __sanitizer_install_malloc_and_free_hooks(void (*malloc_hook)(const volatile void *, size_t),
+    void (*free_hook)(const volatile void *));
+
+static void profile_malloc_hook(const volatile void *ptr, size_t size)
+{
+    t_allocs++;
+    t_alloc_bytes += size;
+}
+
+static void profile_free_hook(const volatile void *ptr)
+{
+}
+
+static int s_hooks_installed = __sanitizer_install_malloc_and_free_hooks(profile_malloc_hook, profile_free_hook);
+#else
+// the definitions below take the place of those of glibc for the whole process
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t num, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+    t_allocs++;
+    t_alloc_bytes += size;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t num, size_t size)
+{
+    t_allocs++;
+    t_alloc_bytes += num * size;
+    return __libc_calloc(num, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    t_allocs++;
+    t_alloc_bytes += size;
+    return __libc_realloc(ptr, size);
+}
+}
+#endif
+#endif
+
+void em_profile_t::get_thread_allocs(uint64_t *allocs, uint64_t *bytes)
+{
+#ifdef EM_PROFILE
+    *allocs = t_allocs;
+    *bytes = t_alloc_bytes;
+#else
+    *allocs = 0;
+    *bytes = 0;
+#endif
+}
+
+unsigned int em_profile_t::get_slot(em_profile_domain_t domain, unsigned int type)
+{
+    if (domain == em_profile_domain_cmdu) {
+        return em_msg_t::get_type_slot(type);
+    }
+
+    return (type < EM_PROFILE_MAX_TYPES) ? type:(EM_PROFILE_MAX_TYPES - 1);
+}
+
+void em_profile_t::record(em_profile_domain_t domain, unsigned int type, uint64_t cpu_ns, uint64_t allocs, uint64_t alloc_bytes)
+{
+    unsigned int slot;
+    uint64_t cur;
+
+    if (domain >= em_profile_domain_max) {
+        return;
+    }
+    slot = get_slot(domain, type);
+
+    s_count[domain][slot].fetch_add(1, std::memory_order_relaxed);
+    s_cpu_ns[domain][slot].fetch_add(cpu_ns, std::memory_order_relaxed);
+    s_allocs[domain][slot].fetch_add(allocs, std::memory_order_relaxed);
+    s_alloc_bytes[domain][slot].fetch_add(alloc_bytes, std::memory_order_relaxed);
+    cur = s_max_cpu_ns[domain][slot].load(std::memory_order_relaxed);
+    while ((cpu_ns > cur) && (s_max_cpu_ns[domain][slot].compare_exchange_weak(cur, cpu_ns, std::memory_order_relaxed) == false));
+}
+
+unsigned int em_profile_t::get_top(em_profile_entry_t *entries, unsigned int n)
+{
+    std::vector<em_profile_entry_t> all;
+    em_profile_entry_t entry;
+    unsigned int domain, slot;
+
+    for (domain = 0; domain < em_profile_domain_max; domain++) {
+        for (slot = 0; slot < EM_PROFILE_MAX_TYPES; slot++) {
+            if ((entry.count = s_count[domain][slot].load(std::memory_order_relaxed)) == 0) {
+                continue;
+            }
+            entry.domain = static_cast<em_profile_domain_t>(domain);
+            entry.type = slot;
+            if (domain == em_profile_domain_cmdu) {
+                entry.type = (slot == EM_MSG_TYPE_SLOT_OTHER) ? EM_PROFILE_TYPE_OTHER:em_msg_t::get_slot_type(slot);
+            }
+            entry.cpu_ns = s_cpu_ns[domain][slot].load(std::memory_order_relaxed);
+            entry.max_cpu_ns = s_max_cpu_ns[domain][slot].load(std::memory_order_relaxed);
+            entry.allocs = s_allocs[domain][slot].load(std::memory_order_relaxed);
+            entry.alloc_bytes = s_alloc_bytes[domain][slot].load(std::memory_order_relaxed);
+            all.push_back(entry);
+        }
+    }
+
+    n = std::min(n, static_cast<unsigned int>(all.size()));
+    std::partial_sort(all.begin(), all.begin() + n, all.end(), [](const em_profile_entry_t& a, const em_profile_entry_t& b) {
+        return a.cpu_ns > b.cpu_ns;
+    });
+    std::copy(all.begin(), all.begin() + n, entries);
+
+    return n;
+}
+
+static const char *get_type_name(const em_profile_entry_t *entry, em_profile_name_fn_t name_fn, char *buff, size_t len)
+{
+    const char *name;
+
+    if ((name_fn != NULL) && ((name = name_fn(entry->domain, entry->type)) != NULL)) {
+        return name;
+    }
+
+    if (entry->domain != em_profile_domain_cmdu) {
+        snprintf(buff, len, "%u", entry->type);
+    } else if (entry->type == EM_PROFILE_TYPE_OTHER) {
+        snprintf(buff, len, "Other");
+    } else {
+        snprintf(buff, len, "0x%04x", entry->type);
+    }
+
+    return buff;
+}
+
+void em_profile_t::encode(cJSON *arr, unsigned int n, em_profile_name_fn_t name_fn)
+{
+    std::vector<em_profile_entry_t> entries(n);
+    cJSON *obj;
+    char name[16];
+    unsigned int i;
+
+    n = get_top(entries.data(), n);
+    for (i = 0; i < n; i++) {
+        obj = cJSON_CreateObject();
+        cJSON_AddStringToObject(obj, "Domain", get_domain_str(entries[i].domain));
+        cJSON_AddStringToObject(obj, "Type", get_type_name(&entries[i], name_fn, name, sizeof(name)));
+        cJSON_AddNumberToObject(obj, "Count", static_cast<double>(entries[i].count));
+        cJSON_AddNumberToObject(obj, "CpuUs", static_cast<double>(entries[i].cpu_ns / 1000));
+        cJSON_AddNumberToObject(obj, "MeanCpuUs", static_cast<double>(entries[i].cpu_ns / entries[i].count / 1000));
+        cJSON_AddNumberToObject(obj, "MaxCpuUs", static_cast<double>(entries[i].max_cpu_ns / 1000));
+        cJSON_AddNumberToObject(obj, "Allocs", static_cast<double>(entries[i].allocs));
+        cJSON_AddNumberToObject(obj, "AllocBytes", static_cast<double>(entries[i].alloc_bytes));
+        cJSON_AddItemToArray(arr, obj);
+    }
+}
+
+void em_profile_t::print(unsigned int n, em_profile_name_fn_t name_fn)
+{
+    std::vector<em_profile_entry_t> entries(n);
+    char name[16];
+    unsigned int i;
+
+    n = get_top(entries.data(), n);
+    for (i = 0; i < n; i++) {
+        printf("%s:%d: %s %s count:%llu cpu:%lluus mean:%lluus max:%lluus allocs:%llu bytes:%llu\n", __func__, __LINE__,
+            get_domain_str(entries[i].domain), get_type_name(&entries[i], name_fn, name, sizeof(name)),
+            static_cast<unsigned long long>(entries[i].count), static_cast<unsigned long long>(entries[i].cpu_ns / 1000),
+            static_cast<unsigned long long>(entries[i].cpu_ns / entries[i].count / 1000),
+            static_cast<unsigned long long>(entries[i].max_cpu_ns / 1000), static_cast<unsigned long long>(entries[i].allocs),
+            static_cast<unsigned long long>(entries[i].alloc_bytes));
+    }
+}
+
+void em_profile_t::reset()
+{
+    unsigned int i, j;
+
+    for (i = 0; i < em_profile_domain_max; i++) {
+        for (j = 0; j < EM_PROFILE_MAX_TYPES; j++) {
+            s_count[i][j].store(0, std::memory_order_relaxed);
+            s_cpu_ns[i][j].store(0, std::memory_order_relaxed);
+            s_max_cpu_ns[i][j].store(0, std::memory_order_relaxed);
+            s_allocs[i][j].store(0, std::memory_order_relaxed);
+            s_alloc_bytes[i][j].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+const char *em_profile_t::get_domain_str(em_profile_domain_t domain)
+{
+    return (domain < em_profile_domain_max) ? s_domain_str[domain]:"unknown";
+}
@@ -0,0 +1,175 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <new>
+#include "em_rx_shard.h"
+#include "em_frame_trace.h"
+#include "em_stack.h"
+#include "em_sched.h"
+
+void em_rx_shard_pool_t::run(em_rx_shard_t *shard)
+{
+    em_event_t *evts[EM_MGR_BATCH_SZ];
+    em_rx_buff_t *buff;
+    unsigned int i, num;
+
+    while (m_exit == false) {
+        // no periodic wake up unless fragments wait for the rest of their message
+        if (shard->queue.wait((shard->reasm.get_pending() == 0) ? -1:static_cast<int>(EM_REASM_TIMEOUT_US / 1000)) == true) {
+            while ((num = shard->queue.pop_batch(reinterpret_cast<void **>(evts), EM_MGR_BATCH_SZ)) != 0) {
+                for (i = 0; i < num; i++) {
+                    buff = em_frame_ring_t::from_event(evts[i]);
+                    m_route(m_ctx, shard, buff, evts[i]->u.fevt.frame_len, buff->src);
+                }
+            }
+        }
+
+        if (shard->reasm.get_pending() != 0) {
+            shard->reasm.expire(em_lat_hist_t::get_time_us());
+        }
+    }
+}
+
+void *em_rx_shard_pool_t::shard_func(void *arg)
+{
+    em_rx_shard_t *shard = static_cast<em_rx_shard_t *>(arg);
+    char name[EM_STACK_NAME_LEN];
+    int slot;
+
+    snprintf(name, sizeof(name), "rx-%u", shard->idx);
+    slot = em_stack_t::enter(em_stack_role_listener, name);
+    em_sched_t::apply(em_stack_role_listener, name);
+    shard->pool->run(shard);
+    em_stack_t::leave(slot);
+    return NULL;
+}
+
+int em_rx_shard_pool_t::init(unsigned int num, em_frame_ring_t *ring, em_rx_shard_route_cb_t route, void *ctx)
+{
+    pthread_attr_t attr;
+    unsigned int i, started = 0;
+    int ret = 0;
+
+    num = (num > EM_RX_SHARD_MAX) ? EM_RX_SHARD_MAX:num;
+    if ((num == 0) || ((m_shards = new (std::nothrow) em_rx_shard_t[num]) == NULL)) {
+        return -1;
+    }
+
+    m_route = route;
+    m_ctx = ctx;
+    m_exit = false;
+
+    for (i = 0; i < num; i++) {
+        m_shards[i].pool = this;
+        m_shards[i].idx = i;
+        m_shards[i].reasm.init(ring);
+        memset(m_shards[i].msg_stats, 0, sizeof(m_shards[i].msg_stats));
+        m_shards[i].drops = 0;
+        if (m_shards[i].queue.init(EM_RX_SHARD_QUEUE_SZ) != 0) {
+            ret = -1;
+            break;
+        }
+
+        pthread_attr_init(&attr);
+        em_stack_t::set_attr(&attr, em_stack_role_listener);
+        if (pthread_create(&m_shards[i].tid, &attr, em_rx_shard_pool_t::shard_func, &m_shards[i]) != 0) {
+            printf("%s:%d: Failed to start receive shard %d\n", __func__, __LINE__, i);
+            pthread_attr_destroy(&attr);
+            m_shards[i].queue.deinit();
+            ret = -1;
+            break;
+        }
+        pthread_attr_destroy(&attr);
+        started++;
+    }
+
+    m_num = started;
+    if (ret != 0) {
+        deinit();
+        return -1;
+    }
+
+    printf("%s:%d: Started %d receive shards\n", __func__, __LINE__, m_num);
+
+    return 0;
+}
+
+void em_rx_shard_pool_t::deinit()
+{
+    em_event_t *evt;
+    unsigned int i;
+
+    if (m_shards == NULL) {
+        return;
+    }
+
+    m_exit = true;
+    for (i = 0; i < m_num; i++) {
+        m_shards[i].queue.wake();
+    }
+    for (i = 0; i < m_num; i++) {
+        pthread_join(m_shards[i].tid, NULL);
+        while ((evt = static_cast<em_event_t *>(m_shards[i].queue.pop())) != NULL) {
+            em_frame_ring_t::put(em_frame_ring_t::from_event(evt));
+        }
+        m_shards[i].queue.deinit();
+        m_shards[i].reasm.flush();
+    }
+
+    delete[] m_shards;
+    m_shards = NULL;
+    m_num = 0;
+}
+
+unsigned int em_rx_shard_pool_t::get_shard(const unsigned char *mac, unsigned int num)
+{
+    unsigned int hash = 2166136261u, i;
+
+    // FNV-1a, the low bytes of the AL MACs of one vendor differ the most
+    for (i = 0; i < sizeof(mac_address_t); i++) {
+        hash = (hash ^ mac[i]) * 16777619u;
+    }
+
+    return hash % num;
+}
+
+bool em_rx_shard_pool_t::dispatch(em_rx_buff_t *buff, unsigned int len, void *src)
+{
+    em_rx_shard_t *shard;
+
+    shard = &m_shards[get_shard(reinterpret_cast<em_raw_hdr_t *>(buff->data)->src, m_num)];
+    buff->src = src;
+    if (shard->queue.push(em_frame_ring_t::to_event(buff, len)) == false) {
+        shard->drops++;
+        em_frame_ring_t::put(buff);
+        return false;
+    }
+
+    return true;
+}
+
+em_rx_shard_pool_t::em_rx_shard_pool_t(): m_shards(NULL), m_num(0), m_route(NULL), m_ctx(NULL), m_exit(false)
+{
+}
+
+em_rx_shard_pool_t::~em_rx_shard_pool_t()
+{
+    deinit();
+}
@@ -0,0 +1,114 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include "em_scan_diff.h"
+
+unsigned long long em_scan_diff_t::get_key(const em_scan_result_id_t *id)
+{
+    // the scanner MAC takes the low 48 bits
+    return em_hex::pack_mac(id->scanner_mac) | (static_cast<unsigned long long> (id->op_class) << 48) |
+                (static_cast<unsigned long long> (id->channel) << 56);
+}
+
+void em_scan_diff_t::get_nbrs(const em_scan_result_t *res, em_scan_diff_nbrs_t& nbrs)
+{
+    unsigned int i, num = std::min(static_cast<unsigned int> (res->num_neighbors), static_cast<unsigned int> (EM_MAX_NEIGHBORS));
+
+    nbrs.clear();
+    nbrs.reserve(num);
+    for (i = 0; i < num; i++) {
+        nbrs.push_back(std::make_pair(em_hex::pack_mac(res->neighbor[i].bssid), res->neighbor[i].signal_strength));
+    }
+    std::sort(nbrs.begin(), nbrs.end());
+}
+
+bool em_scan_diff_t::is_changed(const em_scan_result_t *res, unsigned long long now)
+{
+    std::unordered_map<unsigned long long, em_scan_diff_entry_t>::iterator it;
+    em_scan_diff_nbrs_t nbrs;
+    unsigned int i = 0, j = 0, appeared = 0, disappeared = 0, changed = 0;
+    bool ret = false;
+
+    m_stats.results++;
+
+    if ((m_params.enabled == false) || ((it = m_entries.find(get_key(&res->id))) == m_entries.end())) {
+        return true;
+    }
+
+    const em_scan_diff_entry_t& last = it->second;
+
+    get_nbrs(res, nbrs);
+
+    // both sorted by BSSID, one merge finds what appeared, disappeared and moved
+    while ((i < nbrs.size()) || (j < last.nbrs.size())) {
+        if ((j == last.nbrs.size()) || ((i < nbrs.size()) && (nbrs[i].first < last.nbrs[j].first))) {
+            appeared++;
+            i++;
+        } else if ((i == nbrs.size()) || (last.nbrs[j].first < nbrs[i].first)) {
+            disappeared++;
+            j++;
+        } else {
+            if (abs(nbrs[i].second - last.nbrs[j].second) >= m_params.rcpi_threshold) {
+                changed++;
+            }
+            i++;
+            j++;
+        }
+    }
+    m_stats.appeared += appeared;
+    m_stats.disappeared += disappeared;
+    m_stats.changed += changed;
+
+    if ((appeared != 0) || (disappeared != 0) || (changed != 0) || (res->scan_status != last.scan_status) ||
+            (abs(res->util - last.util) >= m_params.util_threshold) || (now >= last.reported_ms + m_params.refresh_ms)) {
+        ret = true;
+    } else {
+        m_stats.suppressed++;
+    }
+
+    return ret;
+}
+
+void em_scan_diff_t::reported(const em_scan_result_t *res, unsigned long long now)
+{
+    em_scan_diff_entry_t& entry = m_entries[get_key(&res->id)];
+
+    entry.scan_status = res->scan_status;
+    entry.util = res->util;
+    entry.reported_ms = now;
+    get_nbrs(res, entry.nbrs);
+}
+
+em_scan_diff_t::em_scan_diff_t() : m_entries()
+{
+    memset(&m_params, 0, sizeof(m_params));
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    m_params.enabled = true;
+    m_params.rcpi_threshold = 6;
+    m_params.util_threshold = 20;
+    m_params.refresh_ms = 600000;   // well within the age the controller keeps a result
+}
+
+em_scan_diff_t::~em_scan_diff_t()
+{
+
+}
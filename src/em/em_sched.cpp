@@ -0,0 +1,241 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include "em_sched.h"
+
+em_sched_cfg_t em_sched_t::s_cfg[EM_SCHED_NUM_ROLES];     // zeroed, SCHED_OTHER on the CPUs of the process
+pthread_mutex_t em_sched_t::s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+const char *em_sched_t::get_role_str(unsigned int role)
+{
+    if (role == EM_SCHED_ROLE_MGR) {
+        return "mgr";
+    }
+
+    return em_stack_t::get_role_str(static_cast<em_stack_role_t>(role));
+}
+
+// parses a number between min and max ending at end
+static int parse_num(const char *p, const char *end, long min, long max, long *val)
+{
+    char *num_end;
+
+    if (p == end) {
+        return -1;
+    }
+    errno = 0;
+    *val = strtol(p, &num_end, 10);
+    if ((num_end != end) || (errno != 0) || (*val < min) || (*val > max)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int em_sched_t::parse(const char *spec, const char *end, em_sched_cfg_t *cfg)
+{
+    const char *p = spec, *opt_end, *eq, *cpu, *cpu_end, *dash;
+    long first, last, val;
+
+    while (p < end) {
+        opt_end = static_cast<const char *>(memchr(p, ':', static_cast<size_t>(end - p)));
+        opt_end = (opt_end == NULL) ? end:opt_end;
+        if ((eq = static_cast<const char *>(memchr(p, '=', static_cast<size_t>(opt_end - p)))) == NULL) {
+            return -1;
+        }
+
+        if ((eq - p == 4) && (strncmp(p, "cpus", 4) == 0)) {
+            cfg->cpus = 0;
+            for (cpu = eq + 1; ; cpu = cpu_end + 1) {
+                cpu_end = static_cast<const char *>(memchr(cpu, '+', static_cast<size_t>(opt_end - cpu)));
+                cpu_end = (cpu_end == NULL) ? opt_end:cpu_end;
+                dash = static_cast<const char *>(memchr(cpu, '-', static_cast<size_t>(cpu_end - cpu)));
+                if (dash == NULL) {
+                    if (parse_num(cpu, cpu_end, 0, EM_SCHED_MAX_CPUS - 1, &first) != 0) {
+                        return -1;
+                    }
+                    last = first;
+                } else if ((parse_num(cpu, dash, 0, EM_SCHED_MAX_CPUS - 1, &first) != 0) ||
+                        (parse_num(dash + 1, cpu_end, first, EM_SCHED_MAX_CPUS - 1, &last) != 0)) {
+                    return -1;
+                }
+                for (; first <= last; first++) {
+                    cfg->cpus |= 1ULL << first;
+                }
+                if (cpu_end == opt_end) {
+                    break;
+                }
+            }
+            if (cfg->cpus == 0) {
+                return -1;
+            }
+        } else if (((eq - p == 4) && (strncmp(p, "fifo", 4) == 0)) || ((eq - p == 2) && (strncmp(p, "rr", 2) == 0))) {
+            if (parse_num(eq + 1, opt_end, 1, 99, &val) != 0) {
+                return -1;
+            }
+            cfg->policy = (*p == 'f') ? SCHED_FIFO:SCHED_RR;
+            cfg->priority = static_cast<int>(val);
+        } else if ((eq - p == 4) && (strncmp(p, "nice", 4) == 0)) {
+            if (parse_num(eq + 1, opt_end, -20, 19, &val) != 0) {
+                return -1;
+            }
+            cfg->set_nice = true;
+            cfg->nice = static_cast<int>(val);
+        } else {
+            return -1;
+        }
+        p = (opt_end < end) ? opt_end + 1:end;
+    }
+
+    return 0;
+}
+
+int em_sched_t::configure(const char *spec)
+{
+    em_sched_cfg_t cfg[EM_SCHED_NUM_ROLES];
+    bool set[EM_SCHED_NUM_ROLES] = {};
+    const char *p = spec, *colon, *end;
+    unsigned int i;
+
+    pthread_mutex_lock(&s_lock);
+    memcpy(cfg, s_cfg, sizeof(cfg));
+    pthread_mutex_unlock(&s_lock);
+
+    while (*p != '\0') {
+        end = strchr(p, ',');
+        end = (end == NULL) ? p + strlen(p):end;
+        if (((colon = static_cast<const char *>(memchr(p, ':', static_cast<size_t>(end - p)))) == NULL) || (colon == p)) {
+            return -1;
+        }
+        for (i = 0; i < EM_SCHED_NUM_ROLES; i++) {
+            if ((strlen(get_role_str(i)) == static_cast<size_t>(colon - p)) && (strncmp(p, get_role_str(i), static_cast<size_t>(colon - p)) == 0)) {
+                break;
+            }
+        }
+        if ((i == EM_SCHED_NUM_ROLES) || (parse(colon + 1, end, &cfg[i]) != 0)) {
+            return -1;
+        }
+        set[i] = true;
+        p = (*end == ',') ? end + 1:end;
+    }
+
+    pthread_mutex_lock(&s_lock);
+    for (i = 0; i < EM_SCHED_NUM_ROLES; i++) {
+        if (set[i] == true) {
+            s_cfg[i] = cfg[i];
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+
+    return 0;
+}
+
+void em_sched_t::reset()
+{
+    pthread_mutex_lock(&s_lock);
+    memset(s_cfg, 0, sizeof(s_cfg));
+    pthread_mutex_unlock(&s_lock);
+}
+
+void em_sched_t::get_cfg(unsigned int role, em_sched_cfg_t *cfg)
+{
+    pthread_mutex_lock(&s_lock);
+    *cfg = s_cfg[role];
+    pthread_mutex_unlock(&s_lock);
+}
+
+void em_sched_t::get_short_name(const char *name, char *out)
+{
+    size_t len = strlen(name), prefix;
+    const char *dash;
+
+    if (len < EM_SCHED_NAME_LEN) {
+        snprintf(out, EM_SCHED_NAME_LEN, "%s", name);
+        return;
+    }
+
+    // the end tells the threads of a role apart, e.g. the last bytes of a MAC
+    dash = strchr(name, '-');
+    prefix = ((dash != NULL) && (static_cast<size_t>(dash - name) < EM_SCHED_NAME_LEN / 2)) ? static_cast<size_t>(dash - name) + 1:0;
+    memcpy(out, name, prefix);
+    memcpy(out + prefix, name + len - (EM_SCHED_NAME_LEN - 1 - prefix), EM_SCHED_NAME_LEN - 1 - prefix);
+    out[EM_SCHED_NAME_LEN - 1] = '\0';
+}
+
+int em_sched_t::apply(unsigned int role, const char *name)
+{
+    char short_name[EM_SCHED_NAME_LEN];
+    struct sched_param param;
+    em_sched_cfg_t cfg;
+    cpu_set_t cpus;
+    unsigned int i;
+    int ret = 0, err;
+
+    if (name != NULL) {
+        get_short_name(name, short_name);
+        pthread_setname_np(pthread_self(), short_name);
+    } else {
+        snprintf(short_name, sizeof(short_name), "%s", get_role_str(role));
+    }
+    if (role >= EM_SCHED_NUM_ROLES) {
+        return -1;
+    }
+    get_cfg(role, &cfg);
+
+    if (cfg.cpus != 0) {
+        CPU_ZERO(&cpus);
+        for (i = 0; i < EM_SCHED_MAX_CPUS; i++) {
+            if ((cfg.cpus & (1ULL << i)) != 0) {
+                CPU_SET(i, &cpus);
+            }
+        }
+        if ((err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus)) != 0) {
+            printf("%s:%d: Failed to set the CPUs of %s, err:%d\n", __func__, __LINE__, short_name, err);
+            ret = -1;
+        }
+    }
+
+    if (cfg.policy != SCHED_OTHER) {
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = cfg.priority;
+        if ((err = pthread_setschedparam(pthread_self(), cfg.policy, &param)) != 0) {
+            printf("%s:%d: Failed to set the real time priority of %s, err:%d\n", __func__, __LINE__, short_name, err);
+            ret = -1;
+        }
+    }
+
+    // the nice value of a Linux thread is set on its task id
+    if ((cfg.set_nice == true) &&
+            (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), cfg.nice) != 0)) {
+        printf("%s:%d: Failed to set the nice value of %s, err:%d\n", __func__, __LINE__, short_name, errno);
+        ret = -1;
+    }
+
+    return ret;
+}
@@ -24,33 +24,226 @@
 #include <assert.h>
 #include "em_sm.h"
 
+#define W	0					// waits for a peer, its code runs on events only
+#define P	EM_SM_POLL_MS		// its code sends, retries or looks at the other radios of the agent
 
-bool em_sm_t::validate_sm(em_state_t state)
+// every state, in the order of em_state_t
+static constexpr em_sm_state_info_t em_sm_states[] = {
+	{em_state_agent_unconfigured, P},
+	{em_state_agent_1905_unconfigured, P},
+	{em_state_agent_1905_securing, W},
+	{em_state_agent_autoconfig_rsp_pending, P},
+	{em_state_agent_wsc_m2_pending, P},
+	{em_state_agent_owconfig_pending, W},
+	{em_state_agent_onewifi_bssconfig_ind, W},
+	{em_state_agent_autoconfig_renew_pending, P},
+	{em_state_agent_topo_synchronized, W},
+	{em_state_agent_ap_cap_report, W},
+	{em_state_agent_channel_pref_query, P},
+	{em_state_agent_channel_selection_pending, W},
+	{em_state_agent_channel_select_configuration_pending, W},
+	{em_state_agent_channel_report_pending, P},
+	{em_state_agent_channel_scan_result_pending, P},
+	{em_state_agent_configured, W},
+	{em_state_agent_topology_notify, P},
+	{em_state_agent_client_cap_report, W},
+	{em_state_agent_sta_link_metrics_pending, P},
+	{em_state_agent_steer_btm_res_pending, P},
+	{em_state_agent_beacon_report_pending, P},
+	{em_state_agent_ap_metrics_pending, P},
+
+	{em_state_ctrl_unconfigured, W},
+	{em_state_ctrl_wsc_m1_pending, W},
+	{em_state_ctrl_wsc_m2_sent, W},
+	{em_state_ctrl_ap_cap_query_pending, P},
+	{em_state_ctrl_ap_cap_report_received, W},
+	{em_state_ctrl_topo_sync_pending, P},
+	{em_state_ctrl_topo_synchronized, W},
+	{em_state_ctrl_channel_query_pending, P},
+	{em_state_ctrl_channel_pref_report_pending, W},
+	{em_state_ctrl_channel_queried, W},
+	{em_state_ctrl_channel_select_pending, P},
+	{em_state_ctrl_channel_selected, W},
+	{em_state_ctrl_channel_cnf_pending, W},
+	{em_state_ctrl_channel_report_pending, W},
+	{em_state_ctrl_channel_scan_pending, P},
+	{em_state_ctrl_configured, W},
+	{em_state_ctrl_misconfigured, P},
+	{em_state_ctrl_sta_cap_pending, P},
+	{em_state_ctrl_sta_cap_confirmed, W},
+	{em_state_ctrl_sta_link_metrics_pending, P},
+	{em_state_ctrl_sta_steer_pending, P},
+	{em_state_ctrl_steer_btm_req_ack_rcvd, W},
+	{em_state_ctrl_sta_disassoc_pending, P},
+	{em_state_ctrl_set_policy_pending, P},
+	{em_state_ctrl_ap_mld_config_pending, P},
+	{em_state_ctrl_ap_mld_configured, W},
+	{em_state_ctrl_bsta_mld_config_pending, W},
+	{em_state_ctrl_ap_mld_req_ack_rcvd, W},
+	{em_state_ctrl_avail_spectrum_inquiry_pending, P},
+	{em_state_ctrl_bsta_cap_pending, P},
+	{em_state_ctrl_topo_publish_pending, P},
+};
+
+#undef W
+#undef P
+
+static constexpr bool em_sm_states_valid()
 {
+	if (sizeof(em_sm_states)/sizeof(em_sm_states[0]) != EM_SM_NUM_STATES) {
+		return false;
+	}
+	for (unsigned int i = 0; i < EM_SM_NUM_STATES; i++) {
+		if (static_cast<unsigned int> (em_sm_states[i].state) != ((i < EM_SM_NUM_AGENT_STATES) ? i:
+				(i - EM_SM_NUM_AGENT_STATES + em_state_ctrl_unconfigured))) {
+			return false;
+		}
+	}
+
 	return true;
 }
 
+static_assert(em_sm_states_valid(), "em_sm_states must list every em_state_t in order");
+
+int em_sm_t::get_state_index(em_state_t state)
+{
+	unsigned int val = static_cast<unsigned int> (state);
+
+	if (val < EM_SM_NUM_AGENT_STATES) {
+		return static_cast<int> (val);
+	} else if ((val >= em_state_ctrl_unconfigured) && (val < em_state_max)) {
+		return static_cast<int> (val - em_state_ctrl_unconfigured + EM_SM_NUM_AGENT_STATES);
+	}
+
+	return -1;
+}
+
+const em_sm_state_info_t *em_sm_t::get_state_info(em_state_t state)
+{
+	int idx = get_state_index(state);
+
+	return (idx < 0) ? NULL:&em_sm_states[idx];
+}
+
+em_state_t em_sm_t::get_state_at(unsigned int idx)
+{
+	return em_sm_states[idx].state;
+}
+
+bool em_sm_t::validate_sm(em_state_t state)
+{
+	return get_state_index(state) >= 0;
+}
+
 int em_sm_t::set_state(em_state_t state)
 {
-	if (validate_sm(state) == true) {
+	uint64_t now;
+	int idx;
+
+	if (validate_sm(state) == false) {
+		return -1;
+	}
+
+	pthread_mutex_lock(&m_lock);
+	if (state != m_state.load()) {
+		now = em_lat_hist_t::get_time_us();
+		if ((idx = get_state_index(m_state.load())) >= 0) {
+			m_time_in_state[idx].add(now - m_enter_us);
+		}
+		m_enter_us = now;
+		m_transitions++;
 		m_state = state;
-		return 0;
 	}
+	pthread_mutex_unlock(&m_lock);
 
-	return -1;
+	// set again by another node also counts as an event
+	m_kicked = true;
+
+	return 0;
+}
+
+bool em_sm_t::begin_run(uint64_t now_us)
+{
+	const em_sm_state_info_t *info;
+	bool due;
+
+	pthread_mutex_lock(&m_lock);
+	due = (m_kicked.exchange(false) == true) || ((m_next_us != 0) && (now_us + EM_SM_SLACK_MS * 1000 >= m_next_us));
+	if (due == true) {
+		info = get_state_info(m_state.load());
+		m_next_us = ((info == NULL) || (info->deadline_ms == 0)) ? 0:(now_us + info->deadline_ms * 1000ULL);
+		m_runs++;
+	}
+	pthread_mutex_unlock(&m_lock);
+
+	return due;
+}
+
+bool em_sm_t::is_waiting()
+{
+	bool waiting;
+
+	pthread_mutex_lock(&m_lock);
+	waiting = (m_kicked.load() == false) && (m_next_us == 0);
+	pthread_mutex_unlock(&m_lock);
+
+	return waiting;
+}
+
+bool em_sm_t::get_time_in_state(em_state_t state, em_lat_hist_t *hist)
+{
+	int idx;
+
+	if ((idx = get_state_index(state)) < 0) {
+		return false;
+	}
+
+	pthread_mutex_lock(&m_lock);
+	*hist = m_time_in_state[idx];
+	pthread_mutex_unlock(&m_lock);
+
+	return true;
+}
+
+unsigned int em_sm_t::get_num_transitions()
+{
+	unsigned int num;
+
+	pthread_mutex_lock(&m_lock);
+	num = m_transitions;
+	pthread_mutex_unlock(&m_lock);
+
+	return num;
+}
+
+unsigned int em_sm_t::get_num_runs()
+{
+	unsigned int num;
+
+	pthread_mutex_lock(&m_lock);
+	num = m_runs;
+	pthread_mutex_unlock(&m_lock);
+
+	return num;
 }
 
 void em_sm_t::init_sm(em_service_type_t service)
 {
+	pthread_mutex_lock(&m_lock);
 	m_state = (service == em_service_type_agent) ? em_state_agent_unconfigured:em_state_ctrl_unconfigured;	
+	m_enter_us = em_lat_hist_t::get_time_us();
+	pthread_mutex_unlock(&m_lock);
+	m_kicked = true;
 }
 
-em_sm_t::em_sm_t()
+em_sm_t::em_sm_t() : m_state(em_state_agent_unconfigured), m_lock(), m_kicked(true), m_enter_us(0),
+	m_next_us(0), m_transitions(0), m_runs(0), m_time_in_state()
 {
-
+	pthread_mutex_init(&m_lock, NULL);
+	m_enter_us = em_lat_hist_t::get_time_us();
 }
 
 em_sm_t::~em_sm_t()
 {
-
+	pthread_mutex_destroy(&m_lock);
 }
@@ -0,0 +1,224 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "em_spectrum_cache.h"
+
+int em_spectrum_cache_t::parse_expire_time(const char *str, time_t wall, unsigned long long now, unsigned long long *expire_ms)
+{
+    struct tm tm;
+    char zone = '\0';
+    time_t expire;
+
+    memset(&tm, 0, sizeof(struct tm));
+    if ((sscanf(str, "%4d-%2d-%2dT%2d:%2d:%2d%c", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+            &tm.tm_hour, &tm.tm_min, &tm.tm_sec, &zone) != 7) || (zone != 'Z')) {
+        return -1;
+    }
+    if ((tm.tm_mon < 1) || (tm.tm_mon > 12) || (tm.tm_mday < 1) || (tm.tm_mday > 31) ||
+            (tm.tm_hour > 23) || (tm.tm_min > 59) || (tm.tm_sec > 60)) {
+        return -1;
+    }
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+
+    if (((expire = timegm(&tm)) == static_cast<time_t> (-1)) || (expire <= wall)) {
+        return -1;
+    }
+
+    if (static_cast<unsigned long long> (expire - wall) * 1000 > EM_SPECTRUM_CACHE_MAX_TTL_MS) {
+        *expire_ms = now + EM_SPECTRUM_CACHE_MAX_TTL_MS;
+    } else {
+        *expire_ms = now + static_cast<unsigned long long> (expire - wall) * 1000;
+    }
+
+    return 0;
+}
+
+unsigned long long em_spectrum_cache_t::get_key(const unsigned char *agent)
+{
+    em_packed_mac_t mac = em_hex::pack_mac(agent);
+    auto it = m_agents.find(mac);
+
+    // a packed MAC has its top 16 bits clear, a location key its top bit set
+    return (it != m_agents.end()) ? it->second:mac;
+}
+
+void em_spectrum_cache_t::expire(em_spectrum_location_t *loc, unsigned long long now)
+{
+    for (auto it = loc->op_classes.begin(); it != loc->op_classes.end(); ) {
+        if (it->second.expire_ms <= now) {
+            it = loc->op_classes.erase(it);
+            m_stats.expired++;
+        } else {
+            it++;
+        }
+    }
+}
+
+int em_spectrum_cache_t::set_location(const unsigned char *agent, double latitude, double longitude)
+{
+    long long lat, lon;
+
+    if (!(fabs(latitude) <= 90.0) || !(fabs(longitude) <= 180.0)) {
+        return -1;
+    }
+    lat = llround(latitude * EM_SPECTRUM_CACHE_GRID) + 90LL * EM_SPECTRUM_CACHE_GRID;
+    lon = llround(longitude * EM_SPECTRUM_CACHE_GRID) + 180LL * EM_SPECTRUM_CACHE_GRID;
+
+    pthread_mutex_lock(&m_lock);
+    m_agents[em_hex::pack_mac(agent)] = (1ULL << 63) | (static_cast<unsigned long long> (lat) << 32) |
+        static_cast<unsigned long long> (lon);
+    pthread_mutex_unlock(&m_lock);
+
+    return 0;
+}
+
+void em_spectrum_cache_t::put(const unsigned char *agent, unsigned char op_class, const em_spectrum_channel_t *channels,
+                              unsigned int num, unsigned long long expire_ms, unsigned long long now)
+{
+    em_spectrum_location_t *loc;
+
+    pthread_mutex_lock(&m_lock);
+    loc = &m_locations[get_key(agent)];
+    expire(loc, now);
+    if (expire_ms > now) {
+        em_spectrum_entry_t& entry = loc->op_classes[op_class];
+        entry.expire_ms = expire_ms;
+        entry.channels.assign(channels, channels + num);
+    }
+    loc->owner = em_hex::pack_mac(agent);
+    pthread_mutex_unlock(&m_lock);
+}
+
+void em_spectrum_cache_t::end_inquiry(const unsigned char *agent, bool ok, unsigned long long now)
+{
+    em_spectrum_location_t *loc;
+
+    pthread_mutex_lock(&m_lock);
+    loc = &m_locations[get_key(agent)];
+    loc->inflight_ms = 0;
+    loc->failed_ms = (ok == true) ? 0:now;
+    if (ok == false) {
+        m_stats.failed++;
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+em_spectrum_state_t em_spectrum_cache_t::get_state(const unsigned char *agent, unsigned char op_class, unsigned char channel,
+                                                   unsigned long long now, signed char *max_eirp)
+{
+    em_spectrum_state_t state = em_spectrum_state_unknown;
+
+    pthread_mutex_lock(&m_lock);
+    auto loc = m_locations.find(get_key(agent));
+    if (loc != m_locations.end()) {
+        auto entry = loc->second.op_classes.find(op_class);
+        if ((entry != loc->second.op_classes.end()) && (entry->second.expire_ms > now)) {
+            state = em_spectrum_state_unavailable;
+            for (auto& ch : entry->second.channels) {
+                if (ch.channel == channel) {
+                    state = em_spectrum_state_available;
+                    if (max_eirp != NULL) {
+                        *max_eirp = ch.max_eirp;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+    if (state == em_spectrum_state_unknown) {
+        m_stats.misses++;
+    } else {
+        m_stats.hits++;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return state;
+}
+
+em_spectrum_query_t em_spectrum_cache_t::query(const unsigned char *agent, unsigned long long now)
+{
+    em_packed_mac_t mac = em_hex::pack_mac(agent);
+    em_spectrum_location_t *loc;
+    em_spectrum_query_t ret;
+    bool fresh;
+
+    pthread_mutex_lock(&m_lock);
+    loc = &m_locations[get_key(agent)];
+    expire(loc, now);
+    if ((loc->inflight_ms != 0) && (now - loc->inflight_ms >= EM_SPECTRUM_CACHE_INFLIGHT_MS)) {
+        loc->inflight_ms = 0;
+        loc->failed_ms = now;
+        m_stats.failed++;
+    }
+
+    // fresh if every operating class it has lasts past the refresh margin
+    fresh = (loc->op_classes.empty() == false);
+    for (auto& entry : loc->op_classes) {
+        if (entry.second.expire_ms <= now + EM_SPECTRUM_CACHE_REFRESH_MS) {
+            fresh = false;
+        }
+    }
+
+    if (fresh == true) {
+        ret = em_spectrum_query_cached;
+    } else if (loc->inflight_ms != 0) {
+        ret = em_spectrum_query_wait;
+    } else if ((loc->failed_ms != 0) && (now - loc->failed_ms < EM_SPECTRUM_CACHE_RETRY_MS)) {
+        ret = em_spectrum_query_failed;
+    } else {
+        loc->inflight_ms = (now != 0) ? now:1;
+        loc->failed_ms = 0;
+        loc->owner = mac;
+        m_stats.inquiries++;
+        ret = em_spectrum_query_send;
+    }
+
+    if (((ret == em_spectrum_query_cached) || (ret == em_spectrum_query_wait)) && (loc->owner != mac)) {
+        m_stats.shared++;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return ret;
+}
+
+em_spectrum_cache_stats_t em_spectrum_cache_t::get_stats()
+{
+    em_spectrum_cache_stats_t stats;
+
+    pthread_mutex_lock(&m_lock);
+    stats = m_stats;
+    pthread_mutex_unlock(&m_lock);
+
+    return stats;
+}
+
+em_spectrum_cache_t::em_spectrum_cache_t()
+{
+    pthread_mutex_init(&m_lock, NULL);
+    memset(&m_stats, 0, sizeof(em_spectrum_cache_stats_t));
+}
+
+em_spectrum_cache_t::~em_spectrum_cache_t()
+{
+    pthread_mutex_destroy(&m_lock);
+}
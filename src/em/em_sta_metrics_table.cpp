@@ -0,0 +1,240 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "em_sta_metrics_table.h"
+
+unsigned int em_sta_metrics_table_t::now()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return static_cast<unsigned int>(ts.tv_sec);
+}
+
+int em_sta_metrics_table_t::grow()
+{
+    unsigned int sz = (m_size == 0) ? EM_STA_METRICS_MIN_ROWS:(m_size * 2), i;
+    void *col;
+    struct {
+        void **col;
+        size_t elem_sz;
+    } cols[] = {
+        {reinterpret_cast<void **>(&m_cols.sta), sizeof(mac_address_t)},
+        {reinterpret_cast<void **>(&m_cols.bssid), sizeof(mac_address_t)},
+        {reinterpret_cast<void **>(&m_cols.updated), sizeof(unsigned int)},
+        {reinterpret_cast<void **>(&m_cols.signal_strength), sizeof(signed int)},
+        {reinterpret_cast<void **>(&m_cols.rcpi), sizeof(unsigned char)},
+        {reinterpret_cast<void **>(&m_cols.est_ul_rate), sizeof(unsigned int)},
+        {reinterpret_cast<void **>(&m_cols.est_dl_rate), sizeof(unsigned int)},
+        {reinterpret_cast<void **>(&m_cols.last_ul_rate), sizeof(unsigned int)},
+        {reinterpret_cast<void **>(&m_cols.last_dl_rate), sizeof(unsigned int)},
+        {reinterpret_cast<void **>(&m_cols.util_tx), sizeof(unsigned int)},
+        {reinterpret_cast<void **>(&m_cols.util_rx), sizeof(unsigned int)},
+        {reinterpret_cast<void **>(&m_cols.pkts_tx), sizeof(unsigned int)},
+        {reinterpret_cast<void **>(&m_cols.pkts_rx), sizeof(unsigned int)},
+        {reinterpret_cast<void **>(&m_cols.bytes_tx), sizeof(unsigned int)},
+        {reinterpret_cast<void **>(&m_cols.bytes_rx), sizeof(unsigned int)},
+        {reinterpret_cast<void **>(&m_cols.errors_tx), sizeof(unsigned int)},
+        {reinterpret_cast<void **>(&m_cols.errors_rx), sizeof(unsigned int)},
+        {reinterpret_cast<void **>(&m_cols.retrans_count), sizeof(unsigned int)},
+    };
+
+    // a column that grew before a failure only has spare rows, m_size stays as it was
+    for (i = 0; i < sizeof(cols)/sizeof(cols[0]); i++) {
+        if ((col = realloc(*cols[i].col, sz * cols[i].elem_sz)) == NULL) {
+            printf("%s:%d: Failed to allocate %d rows\n", __func__, __LINE__, sz);
+            return -1;
+        }
+        *cols[i].col = col;
+    }
+    m_size = sz;
+
+    return 0;
+}
+
+int em_sta_metrics_table_t::update(const em_sta_info_t *info)
+{
+    unsigned int row;
+    void *val;
+
+    pthread_rwlock_wrlock(&m_lock);
+
+    if ((val = m_index.get(info->id)) != NULL) {
+        row = static_cast<unsigned int>(reinterpret_cast<uintptr_t>(val) - 1);
+    } else {
+        if ((m_cols.num_rows == m_size) && (grow() != 0)) {
+            pthread_rwlock_unlock(&m_lock);
+            return -1;
+        }
+        row = m_cols.num_rows;
+        if (m_index.add(info->id, reinterpret_cast<void *>(static_cast<uintptr_t>(row) + 1)) != 0) {
+            pthread_rwlock_unlock(&m_lock);
+            return -1;
+        }
+        m_cols.num_rows++;
+        memcpy(m_cols.sta[row], info->id, sizeof(mac_address_t));
+    }
+
+    memcpy(m_cols.bssid[row], info->bssid, sizeof(mac_address_t));
+    m_cols.updated[row] = now();
+    m_cols.signal_strength[row] = info->signal_strength;
+    m_cols.rcpi[row] = info->rcpi;
+    m_cols.est_ul_rate[row] = info->est_ul_rate;
+    m_cols.est_dl_rate[row] = info->est_dl_rate;
+    m_cols.last_ul_rate[row] = info->last_ul_rate;
+    m_cols.last_dl_rate[row] = info->last_dl_rate;
+    m_cols.util_tx[row] = info->util_tx;
+    m_cols.util_rx[row] = info->util_rx;
+    m_cols.pkts_tx[row] = info->pkts_tx;
+    m_cols.pkts_rx[row] = info->pkts_rx;
+    m_cols.bytes_tx[row] = info->bytes_tx;
+    m_cols.bytes_rx[row] = info->bytes_rx;
+    m_cols.errors_tx[row] = info->errors_tx;
+    m_cols.errors_rx[row] = info->errors_rx;
+    m_cols.retrans_count[row] = info->retrans_count;
+
+    pthread_rwlock_unlock(&m_lock);
+
+    return 0;
+}
+
+bool em_sta_metrics_table_t::remove(const unsigned char *sta)
+{
+    unsigned int row, last;
+    void *val;
+
+    pthread_rwlock_wrlock(&m_lock);
+
+    if ((val = m_index.get(sta)) == NULL) {
+        pthread_rwlock_unlock(&m_lock);
+        return false;
+    }
+    row = static_cast<unsigned int>(reinterpret_cast<uintptr_t>(val) - 1);
+    m_index.remove(sta, val);
+
+    // keep the rows dense, the last row takes the place of the removed one
+    last = m_cols.num_rows - 1;
+    if (row != last) {
+        m_index.remove(m_cols.sta[last], reinterpret_cast<void *>(static_cast<uintptr_t>(last) + 1));
+        m_index.add(m_cols.sta[last], val);
+        memcpy(m_cols.sta[row], m_cols.sta[last], sizeof(mac_address_t));
+        memcpy(m_cols.bssid[row], m_cols.bssid[last], sizeof(mac_address_t));
+        m_cols.updated[row] = m_cols.updated[last];
+        m_cols.signal_strength[row] = m_cols.signal_strength[last];
+        m_cols.rcpi[row] = m_cols.rcpi[last];
+        m_cols.est_ul_rate[row] = m_cols.est_ul_rate[last];
+        m_cols.est_dl_rate[row] = m_cols.est_dl_rate[last];
+        m_cols.last_ul_rate[row] = m_cols.last_ul_rate[last];
+        m_cols.last_dl_rate[row] = m_cols.last_dl_rate[last];
+        m_cols.util_tx[row] = m_cols.util_tx[last];
+        m_cols.util_rx[row] = m_cols.util_rx[last];
+        m_cols.pkts_tx[row] = m_cols.pkts_tx[last];
+        m_cols.pkts_rx[row] = m_cols.pkts_rx[last];
+        m_cols.bytes_tx[row] = m_cols.bytes_tx[last];
+        m_cols.bytes_rx[row] = m_cols.bytes_rx[last];
+        m_cols.errors_tx[row] = m_cols.errors_tx[last];
+        m_cols.errors_rx[row] = m_cols.errors_rx[last];
+        m_cols.retrans_count[row] = m_cols.retrans_count[last];
+    }
+    m_cols.num_rows--;
+
+    pthread_rwlock_unlock(&m_lock);
+
+    return true;
+}
+
+unsigned int em_sta_metrics_table_t::find_weak(unsigned char rcpi_thresh, unsigned int max_age, mac_address_t *stas, unsigned int max)
+{
+    unsigned int i, num = 0, oldest, t = now();
+    const unsigned char *rcpi;
+    const unsigned int *updated;
+
+    pthread_rwlock_rdlock(&m_lock);
+
+    rcpi = m_cols.rcpi;
+    updated = m_cols.updated;
+    oldest = ((max_age == 0) || (t < max_age)) ? 0:(t - max_age);
+    for (i = 0; (i < m_cols.num_rows) && (num < max); i++) {
+        if ((rcpi[i] < rcpi_thresh) && (updated[i] >= oldest)) {
+            memcpy(stas[num], m_cols.sta[i], sizeof(mac_address_t));
+            num++;
+        }
+    }
+
+    pthread_rwlock_unlock(&m_lock);
+
+    return num;
+}
+
+unsigned int em_sta_metrics_table_t::count()
+{
+    unsigned int num;
+
+    pthread_rwlock_rdlock(&m_lock);
+    num = m_cols.num_rows;
+    pthread_rwlock_unlock(&m_lock);
+
+    return num;
+}
+
+void em_sta_metrics_table_t::clear()
+{
+    pthread_rwlock_wrlock(&m_lock);
+
+    free(m_cols.sta);
+    free(m_cols.bssid);
+    free(m_cols.updated);
+    free(m_cols.signal_strength);
+    free(m_cols.rcpi);
+    free(m_cols.est_ul_rate);
+    free(m_cols.est_dl_rate);
+    free(m_cols.last_ul_rate);
+    free(m_cols.last_dl_rate);
+    free(m_cols.util_tx);
+    free(m_cols.util_rx);
+    free(m_cols.pkts_tx);
+    free(m_cols.pkts_rx);
+    free(m_cols.bytes_tx);
+    free(m_cols.bytes_rx);
+    free(m_cols.errors_tx);
+    free(m_cols.errors_rx);
+    free(m_cols.retrans_count);
+    memset(&m_cols, 0, sizeof(em_sta_metrics_cols_t));
+    m_size = 0;
+    m_index.clear();
+
+    pthread_rwlock_unlock(&m_lock);
+}
+
+em_sta_metrics_table_t::em_sta_metrics_table_t(): m_size(0)
+{
+    pthread_rwlock_init(&m_lock, NULL);
+    memset(&m_cols, 0, sizeof(em_sta_metrics_cols_t));
+}
+
+em_sta_metrics_table_t::~em_sta_metrics_table_t()
+{
+    clear();
+    pthread_rwlock_destroy(&m_lock);
+}
@@ -0,0 +1,290 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <vector>
+#include "em_stack.h"
+
+size_t em_stack_t::s_size[em_stack_role_max] = {
+    0x800000,   // 8MB, the defaults the threads were created with
+    0x800000,
+    0x100000,   // 1MB, the jobs only run the OpenSSL primitives
+    0x800000,
+};
+size_t em_stack_t::s_max_high_water[em_stack_role_max];
+em_stack_slot_t em_stack_t::s_slots[EM_STACK_MAX_THREADS];
+pthread_mutex_t em_stack_t::s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *s_role_str[em_stack_role_max] = {
+    "node",
+    "worker",
+    "crypto",
+    "listener",
+};
+
+static size_t get_page_size()
+{
+    long page = sysconf(_SC_PAGESIZE);
+
+    return (page > 0) ? static_cast<size_t>(page):4096;
+}
+
+const char *em_stack_t::get_role_str(em_stack_role_t role)
+{
+    return (role < em_stack_role_max) ? s_role_str[role]:"";
+}
+
+int em_stack_t::set_size(em_stack_role_t role, size_t size)
+{
+    size_t page = get_page_size();
+
+    if ((role >= em_stack_role_max) || (size < EM_STACK_MIN_SZ)) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&s_lock);
+    s_size[role] = (size + page - 1) / page * page;
+    pthread_mutex_unlock(&s_lock);
+
+    return 0;
+}
+
+int em_stack_t::configure(const char *spec)
+{
+    size_t sizes[em_stack_role_max];
+    bool set[em_stack_role_max] = {};
+    const char *p = spec, *eq, *end;
+    unsigned long long kb;
+    char *num_end;
+    unsigned int i;
+
+    while (*p != '\0') {
+        end = strchr(p, ',');
+        end = (end == NULL) ? p + strlen(p):end;
+        if (((eq = static_cast<const char *>(memchr(p, '=', static_cast<size_t>(end - p)))) == NULL) || (eq == p)) {
+            return -1;
+        }
+        for (i = 0; i < em_stack_role_max; i++) {
+            if ((strlen(s_role_str[i]) == static_cast<size_t>(eq - p)) && (strncmp(p, s_role_str[i], static_cast<size_t>(eq - p)) == 0)) {
+                break;
+            }
+        }
+        if (i == em_stack_role_max) {
+            return -1;
+        }
+        kb = strtoull(eq + 1, &num_end, 10);
+        if ((num_end != end) || (eq + 1 == end) || (kb > (SIZE_MAX / 1024)) || ((kb * 1024) < EM_STACK_MIN_SZ)) {
+            return -1;
+        }
+        sizes[i] = static_cast<size_t>(kb * 1024);
+        set[i] = true;
+        p = (*end == ',') ? end + 1:end;
+    }
+
+    for (i = 0; i < em_stack_role_max; i++) {
+        if (set[i] == true) {
+            set_size(static_cast<em_stack_role_t>(i), sizes[i]);
+        }
+    }
+
+    return 0;
+}
+
+size_t em_stack_t::get_size(em_stack_role_t role)
+{
+    size_t size;
+
+    pthread_mutex_lock(&s_lock);
+    size = s_size[role];
+    pthread_mutex_unlock(&s_lock);
+
+    return size;
+}
+
+int em_stack_t::set_attr(pthread_attr_t *attr, em_stack_role_t role)
+{
+    size_t size = get_size(role);
+    int ret;
+
+    // Setting explicitly stacksize as in few platforms(e.g. openwrt) if not called, the
+    // new thread will inherit the default stack size which is significantly less
+    // leading to stack overflow.
+    if ((ret = pthread_attr_setstacksize(attr, size)) != 0) {
+        printf("%s:%d pthread_attr_setstacksize failed for %s size:%zu ret:%d\n", __func__, __LINE__,
+                s_role_str[role], size, ret);
+    }
+
+    return ret;
+}
+
+int em_stack_t::enter(em_stack_role_t role, const char *name)
+{
+    pthread_attr_t attr;
+    void *addr;
+    size_t size, guard = 0, page = get_page_size();
+    unsigned char *low, *high;
+    uintptr_t frame, reset_end;
+    int i;
+
+    if (pthread_getattr_np(pthread_self(), &attr) != 0) {
+        return -1;
+    }
+    pthread_attr_getstack(&attr, &addr, &size);
+    pthread_attr_getguardsize(&attr, &guard);
+    pthread_attr_destroy(&attr);
+
+    // the guard is skipped in case the C library reports it as part of the stack
+    low = static_cast<unsigned char *>(addr) + guard;
+    high = static_cast<unsigned char *>(addr) + size;
+    frame = reinterpret_cast<uintptr_t>(__builtin_frame_address(0));
+    if ((frame <= reinterpret_cast<uintptr_t>(low) + EM_STACK_RESET_MARGIN) || (frame > reinterpret_cast<uintptr_t>(high))) {
+        return -1;
+    }
+
+    // pages a former thread of a reused stack touched, this thread has not used them yet
+    reset_end = (frame - EM_STACK_RESET_MARGIN) / page * page;
+    if (reset_end > reinterpret_cast<uintptr_t>(low)) {
+        madvise(low, reset_end - reinterpret_cast<uintptr_t>(low), MADV_DONTNEED);
+    }
+
+    pthread_mutex_lock(&s_lock);
+    for (i = 0; i < EM_STACK_MAX_THREADS; i++) {
+        if (s_slots[i].in_use == false) {
+            s_slots[i].in_use = true;
+            s_slots[i].role = role;
+            snprintf(s_slots[i].name, sizeof(s_slots[i].name), "%s", name);
+            s_slots[i].low = low;
+            s_slots[i].high = high;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+
+    return (i < EM_STACK_MAX_THREADS) ? i:-1;
+}
+
+void em_stack_t::leave(int slot)
+{
+    size_t high_water;
+
+    if ((slot < 0) || (slot >= EM_STACK_MAX_THREADS)) {
+        return;
+    }
+
+    pthread_mutex_lock(&s_lock);
+    high_water = scan(&s_slots[slot]);
+    if (high_water > s_max_high_water[s_slots[slot].role]) {
+        s_max_high_water[s_slots[slot].role] = high_water;
+    }
+    s_slots[slot].in_use = false;
+    pthread_mutex_unlock(&s_lock);
+}
+
+size_t em_stack_t::scan(const em_stack_slot_t *slot)
+{
+    size_t page = get_page_size(), len = static_cast<size_t>(slot->high - slot->low), i, num;
+    std::vector<unsigned char> resident;
+
+    num = (len + page - 1) / page;
+    resident.resize(num);
+    if (mincore(slot->low, len, resident.data()) != 0) {
+        return 0;
+    }
+
+    for (i = 0; i < num; i++) {
+        if ((resident[i] & 1) != 0) {
+            return len - (i * page);
+        }
+    }
+
+    return 0;
+}
+
+unsigned int em_stack_t::get_threads(em_stack_thread_info_t *info, unsigned int max)
+{
+    unsigned int i, num = 0;
+
+    pthread_mutex_lock(&s_lock);
+    for (i = 0; (i < EM_STACK_MAX_THREADS) && (num < max); i++) {
+        if (s_slots[i].in_use == false) {
+            continue;
+        }
+        info[num].role = s_slots[i].role;
+        snprintf(info[num].name, sizeof(info[num].name), "%s", s_slots[i].name);
+        info[num].size = static_cast<size_t>(s_slots[i].high - s_slots[i].low);
+        info[num].high_water = scan(&s_slots[i]);
+        num++;
+    }
+    pthread_mutex_unlock(&s_lock);
+
+    return num;
+}
+
+size_t em_stack_t::get_max_high_water(em_stack_role_t role)
+{
+    em_stack_thread_info_t info[EM_STACK_MAX_THREADS];
+    size_t max;
+    unsigned int i, num;
+
+    num = get_threads(info, EM_STACK_MAX_THREADS);
+
+    pthread_mutex_lock(&s_lock);
+    max = s_max_high_water[role];
+    pthread_mutex_unlock(&s_lock);
+
+    for (i = 0; i < num; i++) {
+        if ((info[i].role == role) && (info[i].high_water > max)) {
+            max = info[i].high_water;
+        }
+    }
+
+    return max;
+}
+
+void em_stack_t::encode(cJSON *obj)
+{
+    em_stack_thread_info_t info[EM_STACK_MAX_THREADS];
+    cJSON *arr, *item;
+    unsigned int i, num;
+
+    arr = cJSON_AddArrayToObject(obj, "Roles");
+    for (i = 0; i < em_stack_role_max; i++) {
+        item = cJSON_CreateObject();
+        cJSON_AddStringToObject(item, "Role", s_role_str[i]);
+        cJSON_AddNumberToObject(item, "Size", static_cast<double>(get_size(static_cast<em_stack_role_t>(i))));
+        cJSON_AddNumberToObject(item, "MaxHighWater", static_cast<double>(get_max_high_water(static_cast<em_stack_role_t>(i))));
+        cJSON_AddItemToArray(arr, item);
+    }
+
+    num = get_threads(info, EM_STACK_MAX_THREADS);
+    arr = cJSON_AddArrayToObject(obj, "Threads");
+    for (i = 0; i < num; i++) {
+        item = cJSON_CreateObject();
+        cJSON_AddStringToObject(item, "Name", info[i].name);
+        cJSON_AddStringToObject(item, "Role", s_role_str[info[i].role]);
+        cJSON_AddNumberToObject(item, "Size", static_cast<double>(info[i].size));
+        cJSON_AddNumberToObject(item, "HighWater", static_cast<double>(info[i].high_water));
+        cJSON_AddItemToArray(arr, item);
+    }
+}
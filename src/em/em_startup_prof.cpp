@@ -0,0 +1,210 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <malloc.h>
+#include "em_startup_prof.h"
+#include "em_lat_hist.h"
+
+em_startup_prof_entry_t em_startup_prof_t::s_entries[EM_STARTUP_PROF_MAX_ENTRIES];
+unsigned int em_startup_prof_t::s_num = 0;
+unsigned int em_startup_prof_t::s_depth = 0;
+uint64_t em_startup_prof_t::s_start_us = 0;
+uint64_t em_startup_prof_t::s_total_us = 0;
+bool em_startup_prof_t::s_done = false;
+pthread_mutex_t em_startup_prof_t::s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+long long em_startup_prof_t::get_heap_bytes()
+{
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 33)))
+    struct mallinfo2 info = mallinfo2();
+
+    return static_cast<long long>(info.uordblks + info.hblkhd);
+#elif defined(__GLIBC__)
+    struct mallinfo info = mallinfo();
+
+    // the fields of the older call are int and wrap past 2GB, far above what is loaded here
+    return static_cast<long long>(static_cast<unsigned int>(info.uordblks) + static_cast<unsigned int>(info.hblkhd));
+#else
+    return 0;
+#endif
+}
+
+long long em_startup_prof_t::get_rss_bytes()
+{
+    unsigned long long size, resident;
+    long page = sysconf(_SC_PAGESIZE);
+    FILE *fp;
+    int num;
+
+    if ((fp = fopen("/proc/self/statm", "r")) == NULL) {
+        return 0;
+    }
+    num = fscanf(fp, "%llu %llu", &size, &resident);
+    fclose(fp);
+
+    return ((num == 2) && (page > 0)) ? static_cast<long long>(resident * static_cast<unsigned long long>(page)):0;
+}
+
+int em_startup_prof_t::begin(em_startup_prof_kind_t kind, const char *name)
+{
+    em_startup_prof_entry_t *entry;
+    uint64_t now = em_lat_hist_t::get_time_us();
+    int slot = -1;
+
+    pthread_mutex_lock(&s_lock);
+    if ((s_done == false) && (s_num < EM_STARTUP_PROF_MAX_ENTRIES)) {
+        if (s_num == 0) {
+            s_start_us = now;
+        }
+        slot = static_cast<int>(s_num++);
+        entry = &s_entries[slot];
+        memset(entry, 0, sizeof(em_startup_prof_entry_t));
+        entry->kind = kind;
+        snprintf(entry->name, sizeof(entry->name), "%s", name);
+        entry->depth = s_depth++;
+        entry->start_us = now - s_start_us;
+        // the values at the start until the entry ends
+        entry->heap_bytes = get_heap_bytes();
+        entry->rss_bytes = get_rss_bytes();
+    }
+    pthread_mutex_unlock(&s_lock);
+
+    return slot;
+}
+
+void em_startup_prof_t::end(int slot, unsigned long long rows)
+{
+    em_startup_prof_entry_t *entry;
+    uint64_t now = em_lat_hist_t::get_time_us();
+
+    if ((slot < 0) || (slot >= EM_STARTUP_PROF_MAX_ENTRIES)) {
+        return;
+    }
+
+    pthread_mutex_lock(&s_lock);
+    entry = &s_entries[slot];
+    if ((static_cast<unsigned int>(slot) < s_num) && (entry->ended == false)) {
+        entry->us = now - s_start_us - entry->start_us;
+        entry->rows = rows;
+        entry->heap_bytes = get_heap_bytes() - entry->heap_bytes;
+        entry->rss_bytes = get_rss_bytes() - entry->rss_bytes;
+        entry->ended = true;
+        if (s_depth > 0) {
+            s_depth--;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+void em_startup_prof_t::done()
+{
+    uint64_t now = em_lat_hist_t::get_time_us();
+
+    pthread_mutex_lock(&s_lock);
+    if (s_done == true) {
+        pthread_mutex_unlock(&s_lock);
+        return;
+    }
+    s_done = true;
+    s_total_us = (s_num == 0) ? 0:(now - s_start_us);
+    pthread_mutex_unlock(&s_lock);
+
+    print();
+}
+
+bool em_startup_prof_t::is_done()
+{
+    bool done;
+
+    pthread_mutex_lock(&s_lock);
+    done = s_done;
+    pthread_mutex_unlock(&s_lock);
+
+    return done;
+}
+
+void em_startup_prof_t::print()
+{
+    em_startup_prof_entry_t *entry;
+    unsigned int i;
+
+    pthread_mutex_lock(&s_lock);
+    printf("%s:%d: Startup took %llu.%03llu ms, heap:%lld rss:%lld\n", __func__, __LINE__,
+            static_cast<unsigned long long>(s_total_us / 1000), static_cast<unsigned long long>(s_total_us % 1000),
+            get_heap_bytes(), get_rss_bytes());
+    for (i = 0; i < s_num; i++) {
+        entry = &s_entries[i];
+        if (entry->ended == false) {
+            continue;
+        }
+        printf("%s:%d: %*s%-*s %8llu.%03llu ms heap:%+lld rss:%+lld", __func__, __LINE__,
+                static_cast<int>(entry->depth * 2), "", static_cast<int>(EM_STARTUP_PROF_NAME_LEN - entry->depth * 2),
+                entry->name, static_cast<unsigned long long>(entry->us / 1000),
+                static_cast<unsigned long long>(entry->us % 1000), entry->heap_bytes, entry->rss_bytes);
+        if (entry->kind == em_startup_prof_table) {
+            printf(" rows:%llu", entry->rows);
+        }
+        printf("\n");
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+void em_startup_prof_t::encode(cJSON *obj)
+{
+    em_startup_prof_entry_t *entry;
+    cJSON *arr, *item;
+    unsigned int i;
+
+    pthread_mutex_lock(&s_lock);
+    cJSON_AddNumberToObject(obj, "Done", (s_done == true) ? 1:0);
+    cJSON_AddNumberToObject(obj, "TotalUs", static_cast<double>(s_total_us));
+    arr = cJSON_AddArrayToObject(obj, "Entries");
+    for (i = 0; i < s_num; i++) {
+        entry = &s_entries[i];
+        if (entry->ended == false) {
+            continue;
+        }
+        item = cJSON_CreateObject();
+        cJSON_AddStringToObject(item, "Name", entry->name);
+        cJSON_AddStringToObject(item, "Kind", (entry->kind == em_startup_prof_table) ? "Table":"Phase");
+        cJSON_AddNumberToObject(item, "Depth", entry->depth);
+        cJSON_AddNumberToObject(item, "StartUs", static_cast<double>(entry->start_us));
+        cJSON_AddNumberToObject(item, "Us", static_cast<double>(entry->us));
+        if (entry->kind == em_startup_prof_table) {
+            cJSON_AddNumberToObject(item, "Rows", static_cast<double>(entry->rows));
+        }
+        cJSON_AddNumberToObject(item, "HeapBytes", static_cast<double>(entry->heap_bytes));
+        cJSON_AddNumberToObject(item, "RssBytes", static_cast<double>(entry->rss_bytes));
+        cJSON_AddItemToArray(arr, item);
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+void em_startup_prof_t::reset()
+{
+    pthread_mutex_lock(&s_lock);
+    s_num = 0;
+    s_depth = 0;
+    s_start_us = 0;
+    s_total_us = 0;
+    s_done = false;
+    pthread_mutex_unlock(&s_lock);
+}
@@ -0,0 +1,279 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "em_steer_outcome.h"
+
+unsigned long long em_steer_outcome_table_t::mac_key(const unsigned char *mac)
+{
+    unsigned long long key = 0;
+
+    memcpy(&key, mac, sizeof(mac_address_t));
+
+    return key;
+}
+
+std::unordered_map<unsigned long long, em_steer_outcome_entry_t>::iterator em_steer_outcome_table_t::find_latest(const unsigned char *sta)
+{
+    auto it = m_latest.find(mac_key(sta));
+
+    if (it == m_latest.end()) {
+        return m_entries.end();
+    }
+
+    return m_entries.find(it->first | (static_cast<unsigned long long>(it->second) << 48));
+}
+
+std::unordered_map<unsigned long long, em_steer_outcome_entry_t>::iterator em_steer_outcome_table_t::close(
+    std::unordered_map<unsigned long long, em_steer_outcome_entry_t>::iterator it, bool success, bool expired)
+{
+    em_steer_outcome_entry_t *e = &it->second;
+    em_steer_outcome_agent_t *agent = &m_agents[mac_key(e->agent)];
+
+    if (success == true) {
+        agent->succeeded++;
+        agent->steer_time.add((e->reassoc_ms - e->req_ms) * 1000);
+    } else if (expired == true) {
+        agent->expired++;
+    } else {
+        agent->failed++;
+    }
+
+    auto latest = m_latest.find(mac_key(e->sta));
+    if ((latest != m_latest.end()) && (latest->second == e->msg_id)) {
+        m_latest.erase(latest);
+    }
+
+    return m_entries.erase(it);
+}
+
+void em_steer_outcome_table_t::add_request(const unsigned char *agent, const unsigned char *sta, const unsigned char *source,
+                                           const unsigned char *target, unsigned short msg_id, unsigned long long now)
+{
+    unsigned long long key = mac_key(sta) | (static_cast<unsigned long long>(msg_id) << 48);
+    em_steer_outcome_entry_t *e;
+
+    pthread_mutex_lock(&m_lock);
+
+    // a new request supersedes the one still outstanding for the STA
+    auto it = find_latest(sta);
+    if ((it != m_entries.end()) && (it->first != key)) {
+        close(it, false, false);
+    }
+
+    if ((m_entries.size() >= EM_STEER_OUTCOME_MAX) && (m_entries.find(key) == m_entries.end())) {
+        auto oldest = m_entries.begin();
+        for (it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->second.req_ms < oldest->second.req_ms) {
+                oldest = it;
+            }
+        }
+        close(oldest, false, true);
+    }
+
+    e = &m_entries[key];
+    memset(e, 0, sizeof(em_steer_outcome_entry_t));
+    memcpy(e->agent, agent, sizeof(mac_address_t));
+    memcpy(e->sta, sta, sizeof(mac_address_t));
+    memcpy(e->source, source, sizeof(bssid_t));
+    memcpy(e->target, target, sizeof(bssid_t));
+    e->msg_id = msg_id;
+    e->req_ms = now;
+    m_latest[mac_key(sta)] = msg_id;
+    m_agents[mac_key(agent)].requests++;
+
+    pthread_mutex_unlock(&m_lock);
+}
+
+unsigned int em_steer_outcome_table_t::ack(const unsigned char *agent, unsigned short msg_id, unsigned long long now)
+{
+    unsigned int num = 0;
+
+    pthread_mutex_lock(&m_lock);
+
+    // one request may carry several STAs, all acknowledged by the same ACK
+    for (auto& it : m_entries) {
+        if ((it.second.msg_id == msg_id) && (it.second.ack_ms == 0) &&
+                (memcmp(it.second.agent, agent, sizeof(mac_address_t)) == 0)) {
+            it.second.ack_ms = now;
+            num++;
+        }
+    }
+    if (num != 0) {
+        m_agents[mac_key(agent)].acked += num;
+    }
+
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+bool em_steer_outcome_table_t::report(const unsigned char *sta, unsigned char status, const unsigned char *target, unsigned long long now)
+{
+    static const bssid_t zero = {0};
+    em_steer_outcome_entry_t *e;
+
+    pthread_mutex_lock(&m_lock);
+
+    auto it = find_latest(sta);
+    if (it == m_entries.end()) {
+        pthread_mutex_unlock(&m_lock);
+        return false;
+    }
+    e = &it->second;
+    if (e->report_ms == 0) {
+        e->report_ms = now;
+        m_agents[mac_key(e->agent)].reported++;
+    }
+    e->status = status;
+    if (memcmp(target, zero, sizeof(bssid_t)) != 0) {
+        memcpy(e->target, target, sizeof(bssid_t));
+    }
+    if (status != 0) {
+        close(it, false, false);
+    }
+
+    pthread_mutex_unlock(&m_lock);
+
+    return true;
+}
+
+bool em_steer_outcome_table_t::reassociated(const unsigned char *sta, const unsigned char *bssid, unsigned long long now)
+{
+    pthread_mutex_lock(&m_lock);
+
+    auto it = find_latest(sta);
+    if (it == m_entries.end()) {
+        pthread_mutex_unlock(&m_lock);
+        return false;
+    }
+    it->second.reassoc_ms = now;
+    close(it, memcmp(it->second.target, bssid, sizeof(bssid_t)) == 0, false);
+
+    pthread_mutex_unlock(&m_lock);
+
+    return true;
+}
+
+unsigned int em_steer_outcome_table_t::expire(unsigned long long now)
+{
+    unsigned int num = 0;
+
+    pthread_mutex_lock(&m_lock);
+
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->second.req_ms + EM_STEER_OUTCOME_TIMEOUT_MS <= now) {
+            it = close(it, false, true);
+            num++;
+        } else {
+            ++it;
+        }
+    }
+
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+bool em_steer_outcome_table_t::get_agent_stats(const unsigned char *agent, em_steer_outcome_stats_t *stats)
+{
+    em_steer_outcome_agent_t *a;
+    unsigned int closed;
+
+    pthread_mutex_lock(&m_lock);
+
+    auto it = m_agents.find(mac_key(agent));
+    if (it == m_agents.end()) {
+        pthread_mutex_unlock(&m_lock);
+        return false;
+    }
+    a = &it->second;
+    stats->requests = a->requests;
+    stats->acked = a->acked;
+    stats->reported = a->reported;
+    stats->succeeded = a->succeeded;
+    stats->failed = a->failed;
+    stats->expired = a->expired;
+    closed = a->succeeded + a->failed + a->expired;
+    stats->success_pct = (closed == 0) ? 0:(a->succeeded * 100 / closed);
+    stats->p50_ms = a->steer_time.get_percentile_us(50) / 1000;
+    stats->p99_ms = a->steer_time.get_percentile_us(99) / 1000;
+
+    pthread_mutex_unlock(&m_lock);
+
+    return true;
+}
+
+void em_steer_outcome_table_t::encode(cJSON *arr)
+{
+    em_steer_outcome_stats_t stats;
+    unsigned char agent[sizeof(mac_address_t)];
+    char mac_str[18];
+    cJSON *obj;
+    std::vector<unsigned long long> keys;
+
+    pthread_mutex_lock(&m_lock);
+    for (auto& it : m_agents) {
+        keys.push_back(it.first);
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    for (auto key : keys) {
+        memcpy(agent, &key, sizeof(mac_address_t));
+        if (get_agent_stats(agent, &stats) == false) {
+            continue;
+        }
+        snprintf(mac_str, sizeof(mac_str), "%02x:%02x:%02x:%02x:%02x:%02x",
+            agent[0], agent[1], agent[2], agent[3], agent[4], agent[5]);
+        obj = cJSON_CreateObject();
+        cJSON_AddStringToObject(obj, "Agent", mac_str);
+        cJSON_AddNumberToObject(obj, "Requests", stats.requests);
+        cJSON_AddNumberToObject(obj, "Acked", stats.acked);
+        cJSON_AddNumberToObject(obj, "Reported", stats.reported);
+        cJSON_AddNumberToObject(obj, "Succeeded", stats.succeeded);
+        cJSON_AddNumberToObject(obj, "Failed", stats.failed);
+        cJSON_AddNumberToObject(obj, "Expired", stats.expired);
+        cJSON_AddNumberToObject(obj, "SuccessPct", stats.success_pct);
+        cJSON_AddNumberToObject(obj, "P50Ms", static_cast<double>(stats.p50_ms));
+        cJSON_AddNumberToObject(obj, "P99Ms", static_cast<double>(stats.p99_ms));
+        cJSON_AddItemToArray(arr, obj);
+    }
+}
+
+unsigned int em_steer_outcome_table_t::count()
+{
+    unsigned int num;
+
+    pthread_mutex_lock(&m_lock);
+    num = static_cast<unsigned int>(m_entries.size());
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+em_steer_outcome_table_t::em_steer_outcome_table_t()
+{
+    pthread_mutex_init(&m_lock, NULL);
+}
+
+em_steer_outcome_table_t::~em_steer_outcome_table_t()
+{
+    pthread_mutex_destroy(&m_lock);
+}
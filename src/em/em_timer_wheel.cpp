@@ -0,0 +1,238 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include "em_timer_wheel.h"
+
+#define EM_TIMER_WHEEL_MASK     (EM_TIMER_WHEEL_SLOTS - 1)
+#define EM_TIMER_WHEEL_RANGE(level)   (static_cast<uint64_t>(1) << (EM_TIMER_WHEEL_BITS * ((level) + 1)))
+
+void em_timer_wheel_t::unlink(em_timer_t *t)
+{
+    t->prev->next = t->next;
+    t->next->prev = t->prev;
+    t->next = NULL;
+    t->prev = NULL;
+}
+
+void em_timer_wheel_t::link(em_timer_t *t)
+{
+    em_timer_t *head;
+    uint64_t expires = t->expires, delta;
+    unsigned int level;
+
+    if (expires <= m_now) {
+        // only happens while cascading, the current slot is run right after
+        head = &m_slots[0][m_now & EM_TIMER_WHEEL_MASK];
+    } else {
+        delta = expires - m_now;
+        for (level = 0; level < (EM_TIMER_WHEEL_LEVELS - 1); level++) {
+            if (delta < EM_TIMER_WHEEL_RANGE(level)) {
+                break;
+            }
+        }
+        if (delta >= EM_TIMER_WHEEL_RANGE(level)) {
+            // beyond the last level, park it in the farthest slot and let cascade re-link it
+            expires = m_now + EM_TIMER_WHEEL_RANGE(level) - 1;
+        }
+        head = &m_slots[level][(expires >> (EM_TIMER_WHEEL_BITS * level)) & EM_TIMER_WHEEL_MASK];
+    }
+
+    t->next = head;
+    t->prev = head->prev;
+    head->prev->next = t;
+    head->prev = t;
+}
+
+void em_timer_wheel_t::cascade(unsigned int level, unsigned int idx)
+{
+    em_timer_t *head = &m_slots[level][idx], *t;
+
+    while ((t = head->next) != head) {
+        unlink(t);
+        link(t);
+    }
+}
+
+void em_timer_wheel_t::add(em_timer_t *t, uint64_t now_ms, unsigned int timeout_ms, unsigned int period_ms, em_timer_cb_t cb, void *arg)
+{
+    cancel(t);
+
+    if (m_count == 0) {
+        // nothing is linked, the wheel can jump to the current time for free
+        m_now = now_ms / EM_TIMER_TICK_MS;
+    }
+
+    t->cb = cb;
+    t->arg = arg;
+    t->period_ms = period_ms;
+    t->expires = ms_to_ticks(now_ms + timeout_ms);
+    if (t->expires <= m_now) {
+        t->expires = m_now + 1;
+    }
+
+    link(t);
+    m_count++;
+}
+
+void em_timer_wheel_t::cancel(em_timer_t *t)
+{
+    if (is_pending(t) == false) {
+        return;
+    }
+
+    unlink(t);
+    m_count--;
+}
+
+unsigned int em_timer_wheel_t::run(uint64_t now_ms)
+{
+    uint64_t now = now_ms / EM_TIMER_TICK_MS;
+    em_timer_t expired, *head, *t;
+    unsigned int idx, next_idx, num = 0;
+
+    while ((m_now < now) && (m_count != 0)) {
+        m_now++;
+        idx = m_now & EM_TIMER_WHEEL_MASK;
+        if (idx == 0) {
+            // level 0 wrapped, pull the timers of the next period down
+            next_idx = (m_now >> EM_TIMER_WHEEL_BITS) & EM_TIMER_WHEEL_MASK;
+            cascade(1, next_idx);
+            if (next_idx == 0) {
+                cascade(2, (m_now >> (EM_TIMER_WHEEL_BITS * 2)) & EM_TIMER_WHEEL_MASK);
+            }
+        }
+
+        head = &m_slots[0][idx];
+        if (head->next == head) {
+            continue;
+        }
+
+        // move the slot aside so that callbacks can freely add and cancel timers
+        expired.next = head->next;
+        expired.prev = head->prev;
+        expired.next->prev = &expired;
+        expired.prev->next = &expired;
+        head->next = head;
+        head->prev = head;
+
+        while ((t = expired.next) != &expired) {
+            unlink(t);
+            m_count--;
+            t->cb(t->arg);
+            num++;
+
+            if ((t->period_ms != 0) && (is_pending(t) == false)) {
+                t->expires += ms_to_ticks(t->period_ms);
+                if (t->expires <= m_now) {
+                    t->expires = m_now + 1;
+                }
+                link(t);
+                m_count++;
+            }
+        }
+    }
+
+    if (m_now < now) {
+        m_now = now;
+    }
+
+    return num;
+}
+
+int em_timer_wheel_t::next_timeout_ms(uint64_t now_ms)
+{
+    em_timer_t *head, *t;
+    uint64_t expires = UINT64_MAX, deadline_ms;
+    unsigned int level, i;
+
+    if (m_count == 0) {
+        return -1;
+    }
+
+    // level 0 slots hold a single deadline each, the first busy one is the nearest
+    for (i = 1; i <= EM_TIMER_WHEEL_SLOTS; i++) {
+        head = &m_slots[0][(m_now + i) & EM_TIMER_WHEEL_MASK];
+        if (head->next != head) {
+            expires = head->next->expires;
+            break;
+        }
+    }
+
+    // timers of the higher levels that are not cascaded yet can still be due earlier
+    for (level = 1; level < EM_TIMER_WHEEL_LEVELS; level++) {
+        for (i = 0; i < EM_TIMER_WHEEL_SLOTS; i++) {
+            head = &m_slots[level][i];
+            for (t = head->next; t != head; t = t->next) {
+                expires = (t->expires < expires) ? t->expires:expires;
+            }
+        }
+    }
+
+    deadline_ms = expires * EM_TIMER_TICK_MS;
+    if (deadline_ms <= now_ms) {
+        return 0;
+    }
+
+    return static_cast<int>(deadline_ms - now_ms);
+}
+
+uint64_t em_timer_wheel_t::get_time_ms()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (static_cast<uint64_t>(ts.tv_sec) * 1000) + static_cast<uint64_t>(ts.tv_nsec / 1000000);
+}
+
+void em_timer_wheel_t::init_timer(em_timer_t *t)
+{
+    memset(t, 0, sizeof(em_timer_t));
+}
+
+em_timer_wheel_t::em_timer_wheel_t(): m_now(0), m_count(0)
+{
+    unsigned int level, i;
+
+    for (level = 0; level < EM_TIMER_WHEEL_LEVELS; level++) {
+        for (i = 0; i < EM_TIMER_WHEEL_SLOTS; i++) {
+            m_slots[level][i].next = &m_slots[level][i];
+            m_slots[level][i].prev = &m_slots[level][i];
+        }
+    }
+}
+
+em_timer_wheel_t::~em_timer_wheel_t()
+{
+    em_timer_t *head;
+    unsigned int level, i;
+
+    // leave the owners' timers in a state where cancel() is still safe
+    for (level = 0; level < EM_TIMER_WHEEL_LEVELS; level++) {
+        for (i = 0; i < EM_TIMER_WHEEL_SLOTS; i++) {
+            head = &m_slots[level][i];
+            while (head->next != head) {
+                unlink(head->next);
+            }
+        }
+    }
+}
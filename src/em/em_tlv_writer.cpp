@@ -0,0 +1,217 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <arpa/inet.h>
+#include "em_tlv_writer.h"
+#include "em_msg.h"
+
+#define EM_CMDU_HDR_SZ  (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))
+
+int em_tlv_writer_t::reserve(unsigned int len)
+{
+    unsigned char *buff;
+    unsigned int cap;
+
+    if ((m_len + len) <= m_cap) {
+        return 0;
+    }
+
+    cap = (m_cap == 0) ? static_cast<unsigned int> (2 * EM_MAX_FRAME_SZ):m_cap;
+    while (cap < (m_len + len)) {
+        cap *= 2;
+    }
+
+    if ((buff = static_cast<unsigned char *> (realloc(m_buff, cap))) == NULL) {
+        printf("%s:%d: Could not grow buffer to %d bytes\n", __func__, __LINE__, cap);
+        m_error = true;
+        return -1;
+    }
+
+    m_buff = buff;
+    m_cap = cap;
+
+    return 0;
+}
+
+int em_tlv_writer_t::new_fragment(unsigned int tlv_off)
+{
+    unsigned int tlv_len = m_len - tlv_off;
+
+    if (m_num_frags == EM_TLV_WRITER_MAX_FRAGS) {
+        printf("%s:%d: Message needs more than %d fragments\n", __func__, __LINE__, EM_TLV_WRITER_MAX_FRAGS);
+        m_error = true;
+        return -1;
+    }
+
+    // the room for the header was reserved when the TLV was opened
+    memmove(m_buff + tlv_off + EM_CMDU_HDR_SZ, m_buff + tlv_off, tlv_len);
+    memcpy(m_buff + tlv_off, m_buff, EM_CMDU_HDR_SZ);
+    m_frag_off[m_num_frags] = tlv_off;
+    m_num_frags++;
+    m_len += static_cast<unsigned int> (EM_CMDU_HDR_SZ);
+
+    return 0;
+}
+
+int em_tlv_writer_t::begin(mac_addr_t dst, mac_addr_t src, em_msg_type_t type, unsigned short msg_id)
+{
+    m_len = 0;
+    m_num_frags = 1;
+    m_frag_off[0] = 0;
+    m_tlv_open = false;
+    m_error = false;
+
+    if (reserve(static_cast<unsigned int> (EM_CMDU_HDR_SZ)) != 0) {
+        return -1;
+    }
+
+    em_msg_t::add_1905_header(m_buff, &m_len, dst, src, type, msg_id);
+
+    return 0;
+}
+
+unsigned char *em_tlv_writer_t::open_tlv(em_tlv_type_t type, unsigned int max_len)
+{
+    em_tlv_t *tlv;
+
+    if ((m_num_frags == 0) || (m_tlv_open == true) || (max_len > 0xffff)) {
+        printf("%s:%d: Can not open TLV type: 0x%02x\n", __func__, __LINE__, type);
+        m_error = true;
+        return NULL;
+    }
+
+    if (reserve(static_cast<unsigned int> (EM_CMDU_HDR_SZ + sizeof(em_tlv_t)) + max_len) != 0) {
+        return NULL;
+    }
+
+    tlv = reinterpret_cast<em_tlv_t *> (m_buff + m_len);
+    tlv->type = static_cast<unsigned char> (type);
+    tlv->len = 0;
+
+    m_tlv_off = m_len;
+    m_tlv_max = max_len;
+    m_tlv_open = true;
+
+    return tlv->value;
+}
+
+int em_tlv_writer_t::close_tlv(unsigned int len)
+{
+    em_tlv_t *tlv;
+    unsigned int tlv_len, room;
+
+    if ((m_tlv_open == false) || (len > m_tlv_max)) {
+        printf("%s:%d: Invalid TLV length: %d, reserved: %d\n", __func__, __LINE__, len, m_tlv_max);
+        m_error = true;
+        m_tlv_open = false;
+        return -1;
+    }
+
+    m_tlv_open = false;
+    tlv = reinterpret_cast<em_tlv_t *> (m_buff + m_tlv_off);
+    tlv->len = htons(static_cast<unsigned short> (len));
+    tlv_len = static_cast<unsigned int> (sizeof(em_tlv_t)) + len;
+    m_len = m_tlv_off + tlv_len;
+
+    // every fragment keeps room for the end of message TLV
+    room = m_frame_sz - ((tlv->type == em_tlv_type_eom) ? 0:static_cast<unsigned int> (sizeof(em_tlv_t)));
+    if ((get_frame_len() > room) && ((m_tlv_off - m_frag_off[m_num_frags - 1]) > EM_CMDU_HDR_SZ)) {
+        if (new_fragment(m_tlv_off) != 0) {
+            return -1;
+        }
+    }
+
+    if (get_frame_len() > m_frame_sz) {
+        printf("%s:%d: TLV type: 0x%02x length: %d does not fit a single frame\n", __func__, __LINE__, tlv->type, len);
+    }
+
+    return 0;
+}
+
+int em_tlv_writer_t::add_tlv(em_tlv_type_t type, const unsigned char *value, unsigned int len)
+{
+    unsigned char *tmp;
+
+    if ((tmp = open_tlv(type, len)) == NULL) {
+        return -1;
+    }
+
+    if (len != 0) {
+        memcpy(tmp, value, len);
+    }
+
+    return close_tlv(len);
+}
+
+int em_tlv_writer_t::finish()
+{
+    em_cmdu_t *cmdu;
+    unsigned int i;
+
+    if ((m_tlv_open == true) || (add_tlv(em_tlv_type_eom, NULL, 0) != 0)) {
+        m_error = true;
+        return -1;
+    }
+
+    for (i = 0; i < m_num_frags; i++) {
+        cmdu = reinterpret_cast<em_cmdu_t *> (m_buff + m_frag_off[i] + sizeof(em_raw_hdr_t));
+        cmdu->frag_id = static_cast<unsigned char> (i);
+        cmdu->last_frag_ind = (i == (m_num_frags - 1)) ? 1:0;
+    }
+
+    return (m_error == true) ? -1:static_cast<int> (m_num_frags);
+}
+
+unsigned char *em_tlv_writer_t::get_frame(unsigned int idx, unsigned int *len)
+{
+    if (idx >= m_num_frags) {
+        *len = 0;
+        return NULL;
+    }
+
+    *len = ((idx + 1) < m_num_frags) ? (m_frag_off[idx + 1] - m_frag_off[idx]):(m_len - m_frag_off[idx]);
+
+    return m_buff + m_frag_off[idx];
+}
+
+unsigned int em_tlv_writer_t::get_frames(unsigned char **buffs, unsigned int *lens, unsigned int max)
+{
+    unsigned int i;
+
+    for (i = 0; (i < m_num_frags) && (i < max); i++) {
+        buffs[i] = get_frame(i, &lens[i]);
+    }
+
+    return i;
+}
+
+em_tlv_writer_t::em_tlv_writer_t(): m_buff(NULL), m_cap(0), m_len(0), m_frame_sz(EM_MAX_FRAME_SZ), m_num_frags(0),
+    m_tlv_off(0), m_tlv_max(0), m_tlv_open(false), m_error(false)
+{
+
+}
+
+em_tlv_writer_t::~em_tlv_writer_t()
+{
+    if (m_buff != NULL) {
+        free(m_buff);
+    }
+}
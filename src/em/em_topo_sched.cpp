@@ -0,0 +1,247 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "em_topo_sched.h"
+
+unsigned long long em_topo_sched_t::agent_key(const unsigned char *agent)
+{
+    unsigned long long key = 0;
+
+    memcpy(&key, agent, sizeof(mac_address_t));
+
+    return key;
+}
+
+unsigned long long em_topo_sched_t::jitter(unsigned long long key, unsigned int period_ms, unsigned long long now)
+{
+    unsigned long long x = m_seed ^ key ^ (now * 0x9e3779b97f4a7c15ULL);
+    unsigned long long pct;
+
+    // splitmix64 finalizer, agents drawn in the same tick get unrelated periods
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    pct = 100 - EM_TOPO_SCHED_JITTER_PCT + x % (2 * EM_TOPO_SCHED_JITTER_PCT + 1);
+
+    return period_ms * pct / 100;
+}
+
+void em_topo_sched_t::add(const unsigned char *agent, unsigned long long now)
+{
+    unsigned long long key = agent_key(agent);
+    em_topo_sched_agent_t a;
+
+    pthread_mutex_lock(&m_lock);
+    if (m_agents.find(key) == m_agents.end()) {
+        memset(&a, 0, sizeof(a));
+        a.period_ms = EM_TOPO_SCHED_MIN_PERIOD_MS;
+        a.min_period_ms = EM_TOPO_SCHED_MIN_PERIOD_MS;
+        a.due_ms = now + jitter(key, a.period_ms, now);
+        m_agents.emplace(key, a);
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+void em_topo_sched_t::remove(const unsigned char *agent)
+{
+    pthread_mutex_lock(&m_lock);
+    m_agents.erase(agent_key(agent));
+    pthread_mutex_unlock(&m_lock);
+}
+
+bool em_topo_sched_t::set_min_period(const unsigned char *agent, unsigned int period_ms)
+{
+    bool found = false;
+
+    period_ms = std::max(period_ms, static_cast<unsigned int> (EM_TOPO_SCHED_MIN_PERIOD_MS));
+    period_ms = std::min(period_ms, static_cast<unsigned int> (EM_TOPO_SCHED_MAX_PERIOD_MS));
+
+    pthread_mutex_lock(&m_lock);
+    auto it = m_agents.find(agent_key(agent));
+    if (it != m_agents.end()) {
+        // the current period is left to run, the next ones start from the new minimum
+        it->second.min_period_ms = period_ms;
+        it->second.period_ms = std::max(it->second.period_ms, period_ms);
+        found = true;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return found;
+}
+
+bool em_topo_sched_t::notified(const unsigned char *agent, unsigned long long now)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&m_lock);
+    auto it = m_agents.find(agent_key(agent));
+    if (it != m_agents.end()) {
+        it->second.period_ms = it->second.min_period_ms;
+        if (it->second.outstanding == true) {
+            // the response may predate the change, query again once it is in
+            it->second.notified = true;
+        } else {
+            it->second.due_ms = now;
+        }
+        m_stats.notified++;
+        found = true;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return found;
+}
+
+bool em_topo_sched_t::answered(const unsigned char *agent, bool changed, unsigned long long now)
+{
+    unsigned long long key = agent_key(agent);
+    em_topo_sched_agent_t *a;
+    bool found = false;
+
+    pthread_mutex_lock(&m_lock);
+    auto it = m_agents.find(key);
+    if ((it != m_agents.end()) && (it->second.outstanding == true)) {
+        a = &it->second;
+        a->outstanding = false;
+        if (changed == true) {
+            a->period_ms = a->min_period_ms;
+            m_stats.changed++;
+        } else {
+            a->period_ms = std::min(2 * a->period_ms, static_cast<unsigned int> (EM_TOPO_SCHED_MAX_PERIOD_MS));
+            m_stats.unchanged++;
+        }
+        if (a->notified == true) {
+            a->notified = false;
+            a->due_ms = now;
+        } else {
+            a->due_ms = now + jitter(key, a->period_ms, now);
+        }
+        found = true;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return found;
+}
+
+void em_topo_sched_t::defer(const unsigned char *agent, unsigned long long now)
+{
+    pthread_mutex_lock(&m_lock);
+    auto it = m_agents.find(agent_key(agent));
+    if ((it != m_agents.end()) && (it->second.outstanding == true)) {
+        it->second.outstanding = false;
+        it->second.due_ms = now + EM_TOPO_SCHED_RETRY_MS;
+        m_stats.deferred++;
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+unsigned int em_topo_sched_t::get_due(unsigned long long now, mac_address_t *agents, unsigned int max)
+{
+    std::vector<std::pair<unsigned long long, unsigned long long> > due;
+    em_topo_sched_agent_t *a;
+    unsigned int i, num;
+
+    pthread_mutex_lock(&m_lock);
+    for (auto& it : m_agents) {
+        a = &it.second;
+        if ((a->outstanding == true) && (now - a->sent_ms >= EM_TOPO_SCHED_TIMEOUT_MS)) {
+            // lost, the period is kept and the query tried again within a short one
+            a->outstanding = false;
+            a->notified = false;
+            a->due_ms = now + jitter(it.first, a->min_period_ms, now);
+            m_stats.lost++;
+        }
+        if ((a->outstanding == false) && (a->due_ms <= now)) {
+            due.emplace_back(a->due_ms, it.first);
+        }
+    }
+
+    num = static_cast<unsigned int> (std::min(due.size(), static_cast<size_t> (max)));
+    std::partial_sort(due.begin(), due.begin() + num, due.end());
+    for (i = 0; i < num; i++) {
+        a = &m_agents[due[i].second];
+        a->outstanding = true;
+        a->sent_ms = now;
+        memcpy(agents[i], &due[i].second, sizeof(mac_address_t));
+    }
+    m_stats.queried += num;
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+bool em_topo_sched_t::get_agent(const unsigned char *agent, em_topo_sched_agent_t *info)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&m_lock);
+    auto it = m_agents.find(agent_key(agent));
+    if (it != m_agents.end()) {
+        *info = it->second;
+        found = true;
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return found;
+}
+
+unsigned int em_topo_sched_t::count()
+{
+    unsigned int num;
+
+    pthread_mutex_lock(&m_lock);
+    num = static_cast<unsigned int> (m_agents.size());
+    pthread_mutex_unlock(&m_lock);
+
+    return num;
+}
+
+em_topo_sched_stats_t em_topo_sched_t::get_stats()
+{
+    em_topo_sched_stats_t stats;
+
+    pthread_mutex_lock(&m_lock);
+    stats = m_stats;
+    pthread_mutex_unlock(&m_lock);
+
+    return stats;
+}
+
+em_topo_sched_t::em_topo_sched_t(unsigned long long seed)
+{
+    struct timespec ts;
+
+    pthread_mutex_init(&m_lock, NULL);
+    memset(&m_stats, 0, sizeof(em_topo_sched_stats_t));
+    if (seed == 0) {
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        seed = static_cast<unsigned long long> (ts.tv_sec) * 1000000000ULL + static_cast<unsigned long long> (ts.tv_nsec);
+    }
+    m_seed = seed;
+}
+
+em_topo_sched_t::~em_topo_sched_t()
+{
+    pthread_mutex_destroy(&m_lock);
+}
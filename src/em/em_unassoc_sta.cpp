@@ -0,0 +1,152 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include "em_unassoc_sta.h"
+
+#define EM_UNASSOC_STA_RSP_ENTRY_LEN    (sizeof(mac_address_t) + 1 + 4 + 1)    // MAC, channel, time delta, RCPI
+
+unsigned int em_unassoc_sta_tlv_t::encode_query(unsigned char op_class, const em_unassoc_sta_target_t *targets, unsigned int num,
+                                                unsigned char *buff, unsigned int max)
+{
+    bool done[EM_UNASSOC_STA_QUERY_MAX_PENDING] = {false};
+    unsigned char *num_channels, *num_stas;
+    unsigned int i, j, len = 2;
+
+    if ((num > EM_UNASSOC_STA_QUERY_MAX_PENDING) || (max < len)) {
+        return 0;
+    }
+
+    buff[0] = op_class;
+    num_channels = &buff[1];
+    *num_channels = 0;
+
+    for (i = 0; i < num; i++) {
+        if ((done[i] == true) || (targets[i].op_class != op_class)) {
+            continue;
+        }
+        if (len + 2 > max) {
+            return 0;
+        }
+        buff[len++] = targets[i].channel;
+        num_stas = &buff[len++];
+        *num_stas = 0;
+        (*num_channels)++;
+
+        // every target on the channel, the STAs of a channel are contiguous
+        for (j = i; j < num; j++) {
+            if ((done[j] == true) || (targets[j].op_class != op_class) || (targets[j].channel != targets[i].channel)) {
+                continue;
+            }
+            if (len + sizeof(mac_address_t) > max) {
+                return 0;
+            }
+            memcpy(&buff[len], targets[j].sta, sizeof(mac_address_t));
+            len += static_cast<unsigned int> (sizeof(mac_address_t));
+            (*num_stas)++;
+            done[j] = true;
+        }
+    }
+
+    return (*num_channels == 0) ? 0:len;
+}
+
+int em_unassoc_sta_tlv_t::decode_query(const unsigned char *buff, unsigned int len, em_unassoc_sta_target_t *targets, unsigned int max)
+{
+    unsigned int i, j, num_channels, num_stas, off = 2, num = 0;
+    unsigned char channel;
+
+    if (len < 2) {
+        return -1;
+    }
+    num_channels = buff[1];
+
+    for (i = 0; i < num_channels; i++) {
+        if (off + 2 > len) {
+            return -1;
+        }
+        channel = buff[off];
+        num_stas = buff[off + 1];
+        off += 2;
+        if (off + num_stas * sizeof(mac_address_t) > len) {
+            return -1;
+        }
+        for (j = 0; j < num_stas; j++) {
+            if (num < max) {
+                memcpy(targets[num].sta, &buff[off], sizeof(mac_address_t));
+                targets[num].op_class = buff[0];
+                targets[num].channel = channel;
+                num++;
+            }
+            off += static_cast<unsigned int> (sizeof(mac_address_t));
+        }
+    }
+
+    return static_cast<int> (num);
+}
+
+unsigned int em_unassoc_sta_tlv_t::encode_response(unsigned char op_class, const em_unassoc_sta_meas_t *meas, unsigned int num,
+                                                   unsigned char *buff, unsigned int max)
+{
+    unsigned int i, delta, len = 2;
+
+    // a single octet counts the STAs
+    if ((num > 0xff) || (max < len + num * EM_UNASSOC_STA_RSP_ENTRY_LEN)) {
+        return 0;
+    }
+
+    buff[0] = op_class;
+    buff[1] = static_cast<unsigned char> (num);
+    for (i = 0; i < num; i++) {
+        memcpy(&buff[len], meas[i].sta, sizeof(mac_address_t));
+        len += static_cast<unsigned int> (sizeof(mac_address_t));
+        buff[len++] = meas[i].channel;
+        delta = htonl(meas[i].time_delta_ms);
+        memcpy(&buff[len], &delta, sizeof(delta));
+        len += static_cast<unsigned int> (sizeof(delta));
+        buff[len++] = meas[i].rcpi;
+    }
+
+    return len;
+}
+
+int em_unassoc_sta_tlv_t::decode_response(const unsigned char *buff, unsigned int len, unsigned char *op_class,
+                                          em_unassoc_sta_meas_t *meas, unsigned int max)
+{
+    unsigned int i, delta, off = 2, num = 0;
+
+    if ((len < 2) || (len < 2 + buff[1] * EM_UNASSOC_STA_RSP_ENTRY_LEN)) {
+        return -1;
+    }
+
+    *op_class = buff[0];
+    for (i = 0; (i < buff[1]) && (num < max); i++) {
+        memcpy(meas[num].sta, &buff[off], sizeof(mac_address_t));
+        off += static_cast<unsigned int> (sizeof(mac_address_t));
+        meas[num].channel = buff[off++];
+        memcpy(&delta, &buff[off], sizeof(delta));
+        meas[num].time_delta_ms = ntohl(delta);
+        off += static_cast<unsigned int> (sizeof(delta));
+        meas[num].rcpi = buff[off++];
+        num++;
+    }
+
+    return static_cast<int> (num);
+}
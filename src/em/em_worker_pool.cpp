@@ -0,0 +1,342 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sched.h>
+#include <time.h>
+#include <new>
+#include "em_worker_pool.h"
+#include "em_stack.h"
+#include "em_sched.h"
+
+void em_worker_pool_t::run_slot(em_worker_t *w, em_worker_slot_t *slot)
+{
+    bool more = false;
+
+    pthread_mutex_lock(&w->lock);
+    // the slot may have been detached, and even homed elsewhere, since it was queued
+    if ((slot->worker.load() == w->idx) && (slot->ctx != NULL)) {
+        // cleared first so that an event queued while the node runs schedules it again
+        slot->scheduled = false;
+        more = m_run(slot->ctx, EM_WORKER_BATCH_SZ);
+    }
+    pthread_mutex_unlock(&w->lock);
+
+    if (more == true) {
+        // let the other ready nodes of this worker run before the rest of the batch
+        schedule(slot);
+    }
+}
+
+void em_worker_pool_t::tick(em_worker_t *w)
+{
+    em_worker_slot_t *slot, *next;
+
+    pthread_mutex_lock(&w->lock);
+    for (slot = w->homed; slot != NULL; slot = next) {
+        next = slot->next;
+        if (slot->parked.load() == true) {
+            continue;
+        }
+        m_tick(slot->ctx);
+        // a tick that detached the next node leaves it on the free list, the rest waits for the next tick
+        if ((next != NULL) && (next->worker.load() != w->idx)) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&w->lock);
+}
+
+void em_worker_pool_t::run(em_worker_t *w)
+{
+    em_worker_slot_t *slot;
+    uint64_t now, next_tick = get_time_ms() + m_tick_ms;
+
+    while (m_exit == false) {
+        now = get_time_ms();
+        if (w->ready.wait((next_tick > now) ? static_cast<int>(next_tick - now):0) == true) {
+            while ((slot = static_cast<em_worker_slot_t *>(w->ready.pop())) != NULL) {
+                run_slot(w, slot);
+            }
+        }
+
+        if ((m_tick != NULL) && (get_time_ms() >= next_tick)) {
+            tick(w);
+            next_tick += m_tick_ms;
+            now = get_time_ms();
+            // a worker that fell behind skips the ticks it missed
+            next_tick = (next_tick <= now) ? (now + m_tick_ms):next_tick;
+        }
+    }
+}
+
+void *em_worker_pool_t::worker_func(void *arg)
+{
+    em_worker_t *w = static_cast<em_worker_t *>(arg);
+    char name[EM_STACK_NAME_LEN];
+    int slot;
+
+    snprintf(name, sizeof(name), "worker-%u", w->idx);
+    slot = em_stack_t::enter(em_stack_role_worker, name);
+    // the CPUs configured for the workers replace the pinning of init()
+    em_sched_t::apply(em_stack_role_worker, name);
+    w->pool->run(w);
+    em_stack_t::leave(slot);
+    return NULL;
+}
+
+uint64_t em_worker_pool_t::get_time_ms()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (static_cast<uint64_t>(ts.tv_sec) * 1000) + static_cast<uint64_t>(ts.tv_nsec / 1000000);
+}
+
+int em_worker_pool_t::init(unsigned int num, em_worker_run_cb_t run, em_worker_tick_cb_t tick, unsigned int tick_ms)
+{
+    pthread_mutexattr_t mattr;
+    pthread_attr_t attr;
+    cpu_set_t cpus;
+    long ncpu;
+    unsigned int i, started = 0;
+    int ret = 0;
+
+    if ((ncpu = sysconf(_SC_NPROCESSORS_ONLN)) < 1) {
+        ncpu = 1;
+    }
+    num = (num == 0) ? static_cast<unsigned int>(ncpu):num;
+    num = (num > EM_WORKER_MAX_WORKERS) ? EM_WORKER_MAX_WORKERS:num;
+
+    m_workers = new (std::nothrow) em_worker_t[num];
+    m_slots = new (std::nothrow) em_worker_slot_t[EM_WORKER_MAX_NODES];
+    if ((m_workers == NULL) || (m_slots == NULL)) {
+        printf("%s:%d: Failed to allocate %d workers\n", __func__, __LINE__, num);
+        delete[] m_workers;
+        delete[] m_slots;
+        m_workers = NULL;
+        m_slots = NULL;
+        return -1;
+    }
+
+    m_free = NULL;
+    for (i = 0; i < EM_WORKER_MAX_NODES; i++) {
+        m_slots[i].ctx = NULL;
+        m_slots[i].worker = EM_WORKER_NONE;
+        m_slots[i].scheduled = false;
+        m_slots[i].parked = false;
+        m_slots[i].next = m_free;
+        m_free = &m_slots[i];
+    }
+
+    m_run = run;
+    m_tick = tick;
+    m_tick_ms = tick_ms;
+    m_exit = false;
+
+    pthread_mutexattr_init(&mattr);
+    // a callback may detach another node of its own worker
+    pthread_mutexattr_settype(&mattr, PTHREAD_MUTEX_RECURSIVE);
+
+    for (i = 0; i < num; i++) {
+        m_workers[i].pool = this;
+        m_workers[i].idx = i;
+        m_workers[i].homed = NULL;
+        m_workers[i].num_homed = 0;
+        pthread_mutex_init(&m_workers[i].lock, &mattr);
+        if (m_workers[i].ready.init(EM_WORKER_MAX_NODES) != 0) {
+            ret = -1;
+            break;
+        }
+
+        pthread_attr_init(&attr);
+        em_stack_t::set_attr(&attr, em_stack_role_worker);
+        CPU_ZERO(&cpus);
+        CPU_SET(static_cast<size_t>(i) % static_cast<size_t>(ncpu), &cpus);
+        if (pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpus) != 0) {
+            printf("%s:%d: Failed to pin worker %d, running it unpinned\n", __func__, __LINE__, i);
+        }
+
+        if (pthread_create(&m_workers[i].tid, &attr, em_worker_pool_t::worker_func, &m_workers[i]) != 0) {
+            // the affinity may be refused in containers, try once more without it
+            pthread_attr_destroy(&attr);
+            pthread_attr_init(&attr);
+            em_stack_t::set_attr(&attr, em_stack_role_worker);
+            if (pthread_create(&m_workers[i].tid, &attr, em_worker_pool_t::worker_func, &m_workers[i]) != 0) {
+                printf("%s:%d: Failed to start worker %d\n", __func__, __LINE__, i);
+                pthread_attr_destroy(&attr);
+                m_workers[i].ready.deinit();
+                ret = -1;
+                break;
+            }
+        }
+        pthread_attr_destroy(&attr);
+        started++;
+    }
+    pthread_mutexattr_destroy(&mattr);
+
+    m_num = started;
+    if (ret != 0) {
+        deinit();
+        return -1;
+    }
+
+    printf("%s:%d: Started %d workers\n", __func__, __LINE__, m_num);
+
+    return 0;
+}
+
+void em_worker_pool_t::deinit()
+{
+    unsigned int i;
+
+    if (m_workers == NULL) {
+        return;
+    }
+
+    m_exit = true;
+    for (i = 0; i < m_num; i++) {
+        m_workers[i].ready.wake();
+    }
+    for (i = 0; i < m_num; i++) {
+        pthread_join(m_workers[i].tid, NULL);
+        m_workers[i].ready.deinit();
+        pthread_mutex_destroy(&m_workers[i].lock);
+    }
+
+    delete[] m_workers;
+    delete[] m_slots;
+    m_workers = NULL;
+    m_slots = NULL;
+    m_free = NULL;
+    m_num = 0;
+}
+
+em_worker_slot_t *em_worker_pool_t::attach(void *ctx)
+{
+    em_worker_slot_t *slot;
+    em_worker_t *w;
+    unsigned int i, idx = 0;
+
+    if (m_num == 0) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&m_lock);
+    if ((slot = m_free) == NULL) {
+        pthread_mutex_unlock(&m_lock);
+        printf("%s:%d: No free worker slot\n", __func__, __LINE__);
+        return NULL;
+    }
+    m_free = slot->next;
+    for (i = 1; i < m_num; i++) {
+        idx = (m_workers[i].num_homed < m_workers[idx].num_homed) ? i:idx;
+    }
+    w = &m_workers[idx];
+    w->num_homed++;
+    pthread_mutex_unlock(&m_lock);
+
+    // the worker lock is never taken with the pool lock held, callbacks may attach nodes
+    pthread_mutex_lock(&w->lock);
+    slot->ctx = ctx;
+    slot->scheduled = false;
+    slot->parked = false;
+    slot->next = w->homed;
+    w->homed = slot;
+    slot->worker = idx;
+    pthread_mutex_unlock(&w->lock);
+
+    return slot;
+}
+
+void em_worker_pool_t::detach(em_worker_slot_t *slot)
+{
+    em_worker_slot_t **pp;
+    em_worker_t *w;
+    unsigned int idx = slot->worker;
+
+    if (idx == EM_WORKER_NONE) {
+        return;
+    }
+
+    w = &m_workers[idx];
+    pthread_mutex_lock(&w->lock);
+    for (pp = &w->homed; *pp != NULL; pp = &(*pp)->next) {
+        if (*pp == slot) {
+            *pp = slot->next;
+            break;
+        }
+    }
+    slot->worker = EM_WORKER_NONE;
+    slot->ctx = NULL;
+    pthread_mutex_unlock(&w->lock);
+
+    pthread_mutex_lock(&m_lock);
+    w->num_homed--;
+    slot->next = m_free;
+    m_free = slot;
+    pthread_mutex_unlock(&m_lock);
+}
+
+void em_worker_pool_t::schedule(em_worker_slot_t *slot)
+{
+    unsigned int idx = slot->worker;
+
+    // an event may leave work for the next ticks
+    slot->parked = false;
+    if ((idx == EM_WORKER_NONE) || (slot->scheduled.exchange(true) == true)) {
+        return;
+    }
+
+    if (m_workers[idx].ready.push(slot) == false) {
+        printf("%s:%d: Ready queue of worker %d full\n", __func__, __LINE__, idx);
+        slot->scheduled = false;
+    }
+}
+
+unsigned int em_worker_pool_t::get_num_parked(unsigned int idx)
+{
+    em_worker_slot_t *slot;
+    unsigned int num = 0;
+
+    pthread_mutex_lock(&m_workers[idx].lock);
+    for (slot = m_workers[idx].homed; slot != NULL; slot = slot->next) {
+        num += (slot->parked.load() == true) ? 1u:0u;
+    }
+    pthread_mutex_unlock(&m_workers[idx].lock);
+
+    return num;
+}
+
+em_worker_pool_t::em_worker_pool_t(): m_workers(NULL), m_num(0), m_slots(NULL), m_free(NULL), m_run(NULL), m_tick(NULL), m_tick_ms(0), m_exit(false)
+{
+    pthread_mutex_init(&m_lock, NULL);
+}
+
+em_worker_pool_t::~em_worker_pool_t()
+{
+    deinit();
+    pthread_mutex_destroy(&m_lock);
+}
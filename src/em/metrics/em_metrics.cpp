@@ -43,8 +43,18 @@
 #include "em_cmd.h"
 #include "util.h"
 #include "em.h"
+#include "em_mgr.h"
 #include "em_cmd_exec.h"
 
+static inline unsigned long long sta_key(const unsigned char *sta_mac)
+{
+    unsigned long long key = 0;
+
+    memcpy(&key, sta_mac, sizeof(mac_address_t));
+
+    return key;
+}
+
 int em_metrics_t::handle_assoc_sta_link_metrics_tlv(unsigned char *buff)
 {
     em_assoc_sta_link_metrics_t	*sta_metrics;
@@ -52,6 +62,7 @@ int em_metrics_t::handle_assoc_sta_link_metrics_tlv(unsigned char *buff)
     dm_sta_t *sta;
     unsigned int i;
     dm_easy_mesh_t  *dm;
+    em_metrics_sample_t sample;
 
     dm = get_data_model();
 
@@ -67,6 +78,16 @@ int em_metrics_t::handle_assoc_sta_link_metrics_tlv(unsigned char *buff)
         sta->m_sta_info.est_dl_rate = metrics->est_mac_data_rate_dl;
         sta->m_sta_info.est_ul_rate = metrics->est_mac_data_rate_ul;
         sta->m_sta_info.rcpi = metrics->rcpi;
+        get_mgr()->get_sta_metrics()->update(&sta->m_sta_info);
+        dm->set_sta_dirty(sta);
+
+        sample.time_ms = em_metrics_history_t::now_ms();
+        sample.rcpi = metrics->rcpi;
+        sample.ul_rate = metrics->est_mac_data_rate_ul;
+        sample.dl_rate = metrics->est_mac_data_rate_dl;
+        sample.util = sta->m_sta_info.util_tx + sta->m_sta_info.util_rx;
+        get_mgr()->get_sta_history()->append(sta_metrics->sta_mac, &sample);
+        get_mgr()->get_optimiser()->sta_sample(sta_metrics->sta_mac, metrics->bssid, &sample);
     }
 
     return 0;
@@ -95,6 +116,8 @@ int em_metrics_t::handle_assoc_sta_ext_link_metrics_tlv(unsigned char *buff)
         sta->m_sta_info.last_ul_rate = metrics->last_data_ul_rate;
         sta->m_sta_info.util_rx = metrics->util_receive;
         sta->m_sta_info.util_tx = metrics->util_transmit;
+        get_mgr()->get_sta_metrics()->update(&sta->m_sta_info);
+        dm->set_sta_dirty(sta);
     }
 
     return 0;
@@ -127,6 +150,7 @@ int em_metrics_t::handle_assoc_sta_vendor_link_metrics_tlv(unsigned char *buff,
     sta = dm->find_sta(sta_metrics->sta_mac, sta_metrics->bssid);
     if (sta != NULL && len >= sizeof(em_assoc_sta_vendor_link_metrics_t)) {
         strncpy(sta->m_sta_info.sta_client_type, sta_metrics->sta_client_type, sizeof(sta->m_sta_info.sta_client_type));
+        dm->set_sta_dirty(sta);
     }
 
     return 0;
@@ -134,7 +158,8 @@ int em_metrics_t::handle_assoc_sta_vendor_link_metrics_tlv(unsigned char *buff,
 
 int em_metrics_t::handle_associated_sta_link_metrics_query(unsigned char *buff, unsigned int len)
 {
-    mac_address_t sta;
+    mac_address_t sta[EM_STA_LINK_METRICS_QUERY_MAX_BATCH];
+    unsigned int num = 0, tmp_len, tlv_len;
     em_tlv_t *tlv;
     char *errors[EM_MAX_TLV_MEMBERS] = {0};
 
@@ -144,11 +169,29 @@ int em_metrics_t::handle_associated_sta_link_metrics_query(unsigned char *buff,
     }
 
     tlv = reinterpret_cast<em_tlv_t *> (buff + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
+    tmp_len = len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
+
+    // a batched query carries one STA MAC Address TLV per station
+    while ((tmp_len >= sizeof(em_tlv_t)) && (tlv->type != em_tlv_type_eom) && (num < EM_STA_LINK_METRICS_QUERY_MAX_BATCH)) {
+        tlv_len = htons(tlv->len);
+        if (tmp_len < sizeof(em_tlv_t) + tlv_len) {
+            break;
+        }
+        if ((tlv->type == em_tlv_type_sta_mac_addr) && (tlv_len >= sizeof(mac_address_t))) {
+            memcpy(sta[num], tlv->value, sizeof(mac_address_t));
+            num++;
+        }
+        tmp_len -= static_cast<unsigned int> (sizeof(em_tlv_t) + tlv_len);
+        tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + tlv_len);
+    }
 
-    memcpy(sta, tlv->value, sizeof(mac_address_t));
     em_cmdu_t *cmdu = reinterpret_cast<em_cmdu_t *> (buff + sizeof(em_raw_hdr_t));
 
-    send_associated_link_metrics_response(sta, ntohs(cmdu->id));
+    if (num == 1) {
+        send_associated_link_metrics_response(sta[0], ntohs(cmdu->id));
+    } else if (num > 1) {
+        send_associated_link_metrics_response(sta, num, ntohs(cmdu->id));
+    }
     set_state(em_state_agent_configured);
 
     return 0;
@@ -223,7 +266,6 @@ int em_metrics_t::handle_associated_sta_link_metrics_resp(unsigned char *buff, u
         tmp_len -= (sizeof(em_tlv_t) + static_cast<size_t> (htons(tlv->len)));
         tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
     }
-    dm->set_db_cfg_param(db_cfg_type_sta_metrics_update, "");
     set_state(em_state_ctrl_configured);
 
     return 0;
@@ -233,6 +275,9 @@ int em_metrics_t::handle_beacon_metrics_query(unsigned char *buff, unsigned int
 {
     mac_address_t sta;
     em_tlv_t *tlv;
+    em_beacon_ap_channel_rprt_t *rprt;
+    unsigned char channels[EM_BEACON_REPORT_AGG_MAX_CHANNELS];
+    unsigned int i, j, num = 0;
     char *errors[EM_MAX_TLV_MEMBERS] = {0};
 
     if (em_msg_t(em_msg_type_beacon_metrics_query, em_profile_type_2, buff, len).validate(errors) == 0) {
@@ -258,6 +303,27 @@ int em_metrics_t::handle_beacon_metrics_query(unsigned char *buff, unsigned int
 
     memcpy(sta, tlv->value, sizeof(mac_address_t));
 
+    // the reports of the STA are merged into one response, sent once every queried channel is reported
+    if (beacon_metrics->channel_num != 255) {
+        channels[num++] = beacon_metrics->channel_num;
+    } else {
+        for (i = 0; (i < beacon_metrics->num_ap_channel_rprt) &&
+                (i < sizeof(beacon_metrics->ap_channel_rprt) / sizeof(em_beacon_ap_channel_rprt_t)); i++) {
+            rprt = &beacon_metrics->ap_channel_rprt[i];
+            for (j = 0; (j + 1 < rprt->ap_channel_rprt_len) && (j < sizeof(rprt->ap_channel_list)) &&
+                    (num < EM_BEACON_REPORT_AGG_MAX_CHANNELS); j++) {
+                channels[num++] = rprt->ap_channel_list[j];
+            }
+        }
+    }
+    // channel 0 is every channel of the operating class, only the deadline ends that wait
+    for (i = 0; i < num; i++) {
+        if (channels[i] == 0) {
+            num = 0;
+        }
+    }
+    get_mgr()->get_beacon_agg()->expect(sta, channels, num, em_timer_wheel_t::get_time_ms());
+
     return 0;
 }
 
@@ -290,6 +356,11 @@ int em_metrics_t::handle_beacon_metrics_response(unsigned char *buff, unsigned i
         tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
     }
 
+    if (response == NULL) {
+        printf("%s:%d: Beacon Metrics Response TLV not found\n", __func__, __LINE__);
+        return -1;
+    }
+
     sta = dm->get_first_sta(response->sta_mac_addr);
     while (sta != NULL) {
         if (memcmp(sta->m_sta_info.id, response->sta_mac_addr, sizeof(mac_address_t)) == 0) {
@@ -304,6 +375,12 @@ int em_metrics_t::handle_beacon_metrics_response(unsigned char *buff, unsigned i
         return -1;
     }
 
+    pthread_mutex_lock(&m_beacon_lock);
+    m_beacon_inflight.erase(sta_key(response->sta_mac_addr));
+    pthread_mutex_unlock(&m_beacon_lock);
+    get_mgr()->get_beacon_reports()->add_reports(response->sta_mac_addr, response->meas_reports, report_len,
+        response->meas_rprt_count, em_timer_wheel_t::get_time_ms());
+
     sta->m_sta_info.num_beacon_meas_report = response->meas_rprt_count;
     sta->m_sta_info.beacon_report_len = report_len;
     memcpy(sta->m_sta_info.beacon_report_elem, response->meas_reports, static_cast<size_t> (report_len));
@@ -324,8 +401,15 @@ int em_metrics_t::handle_ap_metrics_tlv(unsigned char *buff, bssid_t get_bssid)
     em_ap_metric_t *ap_metrics = reinterpret_cast<em_ap_metric_t *> (buff);
     em_bss_info_t *bss = get_data_model()->get_bss_info_with_mac(ap_metrics->bssid);
     mac_addr_str_t bss_str;
+    em_metrics_sample_t sample;
 
     memcpy(get_bssid, ap_metrics->bssid, sizeof(mac_addr_t));
+
+    memset(&sample, 0, sizeof(sample));
+    sample.time_ms = em_metrics_history_t::now_ms();
+    sample.util = ap_metrics->channel_util;
+    get_mgr()->get_bss_history()->append(ap_metrics->bssid, &sample);
+    get_mgr()->get_optimiser()->bss_sample(ap_metrics->bssid, &sample);
     if (bss != NULL) {
         bss->numberofsta = htons(ap_metrics->num_sta);
         dm_easy_mesh_t::macbytes_to_string(ap_metrics->bssid, bss_str);
@@ -362,6 +446,7 @@ int em_metrics_t::handle_assoc_sta_traffic_stats(unsigned char *buff, bssid_t bs
     sta->m_sta_info.errors_tx       = sta_metrics->tx_pkt_errors;
     sta->m_sta_info.errors_rx       = sta_metrics->rx_pkt_errors;
     sta->m_sta_info.retrans_count   = sta_metrics->retx_cnt;
+    get_mgr()->get_sta_metrics()->update(&sta->m_sta_info);
 
     return 0;
 }
@@ -470,7 +555,6 @@ int em_metrics_t::handle_ap_metrics_response(unsigned char *buff, unsigned int l
         tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
     }
 
-    dm->set_db_cfg_param(db_cfg_type_sta_metrics_update, "");
     set_state(em_state_ctrl_configured);
 
     return 0;
@@ -544,18 +628,65 @@ int em_metrics_t::send_associated_sta_link_metrics_msg(mac_address_t sta_mac)
     return static_cast<int> (len);
 }
 
+int em_metrics_t::send_associated_sta_link_metrics_batch(mac_address_t *sta_macs, unsigned int num)
+{
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    em_tlv_writer_t *writer = get_tlv_writer();
+    unsigned char *frame;
+    unsigned int i, len = 0;
+    dm_easy_mesh_t *dm = get_data_model();
+
+    writer->begin(dm->get_agent_al_interface_mac(), dm->get_ctrl_al_interface_mac(),
+        em_msg_type_assoc_sta_link_metrics_query, get_mgr()->get_next_msg_id());
+
+    // STA MAC Address Type TLVs (see section 17.2.23), one per station
+    for (i = 0; i < num; i++) {
+        writer->add_tlv(em_tlv_type_sta_mac_addr, sta_macs[i], sizeof(mac_address_t));
+    }
+
+    // the batch is sized to fit a single frame, a query is never fragmented
+    if ((writer->finish() != 1) || ((frame = writer->get_frame(0, &len)) == NULL)) {
+        printf("%s:%d: Associated STA Link Metrics Query build failed for %u stations\n", __func__, __LINE__, num);
+        return -1;
+    }
+
+    if (em_msg_t(em_msg_type_assoc_sta_link_metrics_query, em_profile_type_3, frame, len).validate(errors) == 0) {
+        printf("Associated STA Link Metrics Query msg validation failed\n");
+        return -1;
+    }
+
+    if (send_frame(frame, len)  < 0) {
+        printf("%s:%d: Associated STA Link Metrics Query send failed, error:%d\n", __func__, __LINE__, errno);
+        return -1;
+    }
+
+    printf("%s:%d: Associated STA Link Metrics Query for %u stations send success\n", __func__, __LINE__, num);
+    return static_cast<int> (len);
+}
+
 void em_metrics_t::send_all_associated_sta_link_metrics_msg()
 {
     dm_easy_mesh_t *dm;
     dm_sta_t *sta;
+    mac_address_t sta_macs[EM_STA_LINK_METRICS_QUERY_MAX_BATCH];
+    unsigned int num = 0;
 
     dm = get_data_model();
-    sta = static_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_map));
+    sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_first());
     while (sta != NULL) {
         if (sta->m_sta_info.associated == true) {
-            send_associated_sta_link_metrics_msg(sta->m_sta_info.id);
+            memcpy(sta_macs[num], sta->m_sta_info.id, sizeof(mac_address_t));
+            num++;
+            if (num == m_sta_query_batch) {
+                send_associated_sta_link_metrics_batch(sta_macs, num);
+                num = 0;
+            }
         }
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_map, sta));
+        sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
+    }
+
+    if (num > 0) {
+        send_associated_sta_link_metrics_batch(sta_macs, num);
     }
 }
 
@@ -565,11 +696,19 @@ void em_metrics_t::send_associated_sta_link_metrics_resp_msg()
     dm_sta_t *sta;
 
     dm = get_current_cmd()->get_data_model();
-    sta = static_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_assoc_map));
+    sta = static_cast<dm_sta_t *> (dm->m_sta_assoc_map->get_first());
     while (sta != NULL) {
-        send_associated_link_metrics_response(sta->m_sta_info.id, dm->get_msg_id());
-        sta = static_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_assoc_map, sta));
+        // only the STAs that moved past a threshold since they were last pushed
+        if ((sta_report_due(em_sta_report_type_link_metrics, sta, false) == true) &&
+                (send_associated_link_metrics_response(sta->m_sta_info.id, dm->get_msg_id()) < 0)) {
+            // pushed again with the next update
+            unsigned long long key = 0;
+            memcpy(&key, sta->m_sta_info.id, sizeof(mac_address_t));
+            m_sta_last_report[em_sta_report_type_link_metrics].erase(key);
+        }
+        sta = static_cast<dm_sta_t *> (dm->m_sta_assoc_map->get_next(sta));
     }
+    sta_report_prune(em_sta_report_type_link_metrics);
     set_state(em_state_agent_configured);
 }
 
@@ -589,13 +728,13 @@ int em_metrics_t::send_associated_link_metrics_response(mac_address_t sta_mac, u
     bool sta_found = false;
     dm_sta_t *sta;
 
-    sta = reinterpret_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_map));
+    sta = reinterpret_cast<dm_sta_t *> (dm->m_sta_map->get_first());
     while(sta != NULL) {
         if (memcmp(sta->m_sta_info.id, sta_mac, sizeof(mac_address_t)) == 0) {
             sta_found = true;
             break;
         }
-        sta = reinterpret_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_map, sta));
+        sta = reinterpret_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
     }
 
     if (sta == NULL) {
@@ -685,6 +824,78 @@ int em_metrics_t::send_associated_link_metrics_response(mac_address_t sta_mac, u
     return static_cast<int> (len);
 }
 
+int em_metrics_t::send_associated_link_metrics_response(mac_address_t *sta_macs, unsigned int num, unsigned short msg_id)
+{
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    em_tlv_writer_t *writer = get_tlv_writer();
+    unsigned char *frames[EM_TLV_WRITER_MAX_FRAGS];
+    unsigned int lens[EM_TLV_WRITER_MAX_FRAGS];
+    unsigned char *tmp;
+    unsigned int i;
+    int count, len = 0;
+    dm_easy_mesh_t *dm = get_data_model();
+    dm_sta_t *sta;
+
+    // the metrics of many stations span several frames, the writer fragments them
+    writer->begin(dm->get_ctl_mac(), dm->get_agent_al_interface_mac(), em_msg_type_assoc_sta_link_metrics_rsp, msg_id);
+
+    for (i = 0; i < num; i++) {
+        sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_first());
+        while ((sta != NULL) && (memcmp(sta->m_sta_info.id, sta_macs[i], sizeof(mac_address_t)) != 0)) {
+            sta = static_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
+        }
+
+        if (sta == NULL) {
+            //Error code  TLV 17.2.36, STA not associated with any BSS of this agent
+            if ((tmp = writer->open_tlv(em_tlv_type_error_code)) != NULL) {
+                tmp[0] = 0x01;
+                memcpy(&tmp[1], sta_macs[i], sizeof(mac_address_t));
+                writer->close_tlv(sizeof(unsigned char) + sizeof(mac_address_t));
+            }
+            continue;
+        }
+
+        //Assoc sta link metrics 17.2.24
+        if ((tmp = writer->open_tlv(em_tlv_type_assoc_sta_link_metric)) != NULL) {
+            writer->close_tlv(static_cast<unsigned int> (create_assoc_sta_link_metrics_tlv(tmp, sta_macs[i], sta)));
+        }
+
+        //assoc ext link metrics 17.2.62
+        if ((tmp = writer->open_tlv(em_tlv_type_assoc_sta_ext_link_metric)) != NULL) {
+            writer->close_tlv(static_cast<unsigned int> (create_assoc_ext_sta_link_metrics_tlv(tmp, sta_macs[i], sta)));
+        }
+
+        //assoc vendor link metrics
+        if ((tmp = writer->open_tlv(em_tlv_type_vendor_sta_metrics)) != NULL) {
+            writer->close_tlv(static_cast<unsigned int> (create_assoc_vendor_sta_link_metrics_tlv(tmp, sta_macs[i], sta)));
+        }
+    }
+
+    // End of message
+    if ((count = writer->finish()) < 0) {
+        printf("%s:%d: Associated STA Link Metrics build failed\n", __func__, __LINE__);
+        return -1;
+    }
+
+    count = static_cast<int> (writer->get_frames(frames, lens, EM_TLV_WRITER_MAX_FRAGS));
+    if ((count == 1) && (em_msg_t(em_msg_type_assoc_sta_link_metrics_rsp, em_profile_type_3, frames[0], lens[0]).validate(errors) == 0)) {
+        printf("%s:%d: Associated STA Link Metrics validation failed\n", __func__, __LINE__);
+        return -1;
+    }
+
+    if (send_frames(frames, lens, static_cast<unsigned int> (count)) != count) {
+        printf("%s:%d: Associated STA Link Metrics send failed, error:%d\n", __func__, __LINE__, errno);
+        return -1;
+    }
+
+    for (i = 0; i < static_cast<unsigned int> (count); i++) {
+        len += static_cast<int> (lens[i]);
+    }
+    printf("%s:%d: Associated STA Link Metrics for %u stations sent successfully, fragments: %d\n", __func__, __LINE__, num, count);
+
+    return len;
+}
+
 short em_metrics_t::send_beacon_metrics_query(mac_address_t sta_mac, bssid_t bssid)
 {
     unsigned char buff[MAX_EM_BUFF_SZ];
@@ -754,6 +965,372 @@ short em_metrics_t::send_beacon_metrics_query(mac_address_t sta_mac, bssid_t bss
     return static_cast<short> (len);
 }
 
+int em_metrics_t::request_beacon_report(mac_address_t sta_mac, bssid_t bssid)
+{
+    unsigned long long key = sta_key(sta_mac);
+    em_beacon_query_req_t req;
+
+    if (get_mgr()->get_beacon_reports()->is_fresh(sta_mac, em_timer_wheel_t::get_time_ms()) == true) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&m_beacon_lock);
+
+    if (m_beacon_inflight.find(key) != m_beacon_inflight.end()) {
+        pthread_mutex_unlock(&m_beacon_lock);
+        return 0;
+    }
+    for (const auto& pending : m_beacon_queue) {
+        if (memcmp(pending.sta, sta_mac, sizeof(mac_address_t)) == 0) {
+            pthread_mutex_unlock(&m_beacon_lock);
+            return 0;
+        }
+    }
+    if (m_beacon_queue.size() >= EM_BEACON_QUERY_MAX_PENDING) {
+        pthread_mutex_unlock(&m_beacon_lock);
+        printf("%s:%d: Beacon Metrics Query queue full\n", __func__, __LINE__);
+        return -1;
+    }
+
+    memcpy(req.sta, sta_mac, sizeof(mac_address_t));
+    memcpy(req.bssid, bssid, sizeof(bssid_t));
+    m_beacon_queue.push_back(req);
+
+    pthread_mutex_unlock(&m_beacon_lock);
+
+    return 1;
+}
+
+bool em_metrics_t::has_pending_beacon_queries()
+{
+    bool pending;
+
+    pthread_mutex_lock(&m_beacon_lock);
+    pending = (m_beacon_queue.empty() == false) || (m_beacon_inflight.empty() == false);
+    pthread_mutex_unlock(&m_beacon_lock);
+
+    return pending;
+}
+
+unsigned int em_metrics_t::send_pending_beacon_queries()
+{
+    em_beacon_report_cache_t *cache = get_mgr()->get_beacon_reports();
+    unsigned long long now = em_timer_wheel_t::get_time_ms();
+    em_beacon_query_req_t batch[EM_BEACON_QUERY_BATCH];
+    unsigned int i, num = 0, sent = 0;
+
+    pthread_mutex_lock(&m_beacon_lock);
+
+    for (auto it = m_beacon_inflight.begin(); it != m_beacon_inflight.end();) {
+        if (it->second + EM_BEACON_QUERY_TIMEOUT_MS <= now) {
+            it = m_beacon_inflight.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    while ((num < EM_BEACON_QUERY_BATCH) && (m_beacon_queue.empty() == false)) {
+        batch[num] = m_beacon_queue.front();
+        m_beacon_queue.pop_front();
+        // reported since it was queued, by a query of another em or on its own
+        if (cache->is_fresh(batch[num].sta, now) == true) {
+            continue;
+        }
+        m_beacon_inflight[sta_key(batch[num].sta)] = now;
+        num++;
+    }
+
+    pthread_mutex_unlock(&m_beacon_lock);
+
+    // sent without the lock, a STA whose query failed can be requested again
+    for (i = 0; i < num; i++) {
+        if (send_beacon_metrics_query(batch[i].sta, batch[i].bssid) < 0) {
+            pthread_mutex_lock(&m_beacon_lock);
+            m_beacon_inflight.erase(sta_key(batch[i].sta));
+            pthread_mutex_unlock(&m_beacon_lock);
+            continue;
+        }
+        sent++;
+    }
+
+    return sent;
+}
+
+static inline unsigned long long unassoc_key(const unsigned char *sta_mac, unsigned char op_class)
+{
+    return sta_key(sta_mac) | (static_cast<unsigned long long> (op_class) << 48);
+}
+
+int em_metrics_t::request_unassoc_sta_metrics(mac_address_t sta_mac, unsigned char op_class, unsigned char channel)
+{
+    em_unassoc_sta_target_t req;
+
+    pthread_mutex_lock(&m_unassoc_lock);
+
+    if (m_unassoc_inflight.find(unassoc_key(sta_mac, op_class)) != m_unassoc_inflight.end()) {
+        pthread_mutex_unlock(&m_unassoc_lock);
+        return 0;
+    }
+    for (const auto& pending : m_unassoc_queue) {
+        if ((memcmp(pending.sta, sta_mac, sizeof(mac_address_t)) == 0) && (pending.op_class == op_class) &&
+                (pending.channel == channel)) {
+            pthread_mutex_unlock(&m_unassoc_lock);
+            return 0;
+        }
+    }
+    if (m_unassoc_queue.size() >= EM_UNASSOC_STA_QUERY_MAX_PENDING) {
+        pthread_mutex_unlock(&m_unassoc_lock);
+        printf("%s:%d: Unassociated STA Link Metrics Query queue full\n", __func__, __LINE__);
+        return -1;
+    }
+
+    memcpy(req.sta, sta_mac, sizeof(mac_address_t));
+    req.op_class = op_class;
+    req.channel = channel;
+    m_unassoc_queue.push_back(req);
+
+    pthread_mutex_unlock(&m_unassoc_lock);
+
+    return 1;
+}
+
+bool em_metrics_t::has_pending_unassoc_sta_queries()
+{
+    bool pending;
+
+    pthread_mutex_lock(&m_unassoc_lock);
+    pending = (m_unassoc_queue.empty() == false) || (m_unassoc_inflight.empty() == false);
+    pthread_mutex_unlock(&m_unassoc_lock);
+
+    return pending;
+}
+
+unsigned int em_metrics_t::send_pending_unassoc_sta_queries()
+{
+    unsigned long long now = em_timer_wheel_t::get_time_ms();
+    em_unassoc_sta_target_t targets[EM_UNASSOC_STA_QUERY_MAX_PENDING];
+    bool done[EM_UNASSOC_STA_QUERY_MAX_PENDING] = {false};
+    unsigned int i, j, num = 0, sent = 0;
+
+    pthread_mutex_lock(&m_unassoc_lock);
+
+    for (auto it = m_unassoc_inflight.begin(); it != m_unassoc_inflight.end();) {
+        if (it->second + EM_UNASSOC_STA_QUERY_TIMEOUT_MS <= now) {
+            it = m_unassoc_inflight.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // the whole queue, a query carries every STA of its op class on all its channels
+    while ((num < EM_UNASSOC_STA_QUERY_MAX_PENDING) && (m_unassoc_queue.empty() == false)) {
+        targets[num] = m_unassoc_queue.front();
+        m_unassoc_queue.pop_front();
+        m_unassoc_inflight[unassoc_key(targets[num].sta, targets[num].op_class)] = now;
+        num++;
+    }
+
+    pthread_mutex_unlock(&m_unassoc_lock);
+
+    for (i = 0; i < num; i++) {
+        if (done[i] == true) {
+            continue;
+        }
+        for (j = i; j < num; j++) {
+            done[j] = done[j] || (targets[j].op_class == targets[i].op_class);
+        }
+        if (send_unassoc_sta_link_metrics_query(targets[i].op_class, targets, num) >= 0) {
+            sent++;
+            continue;
+        }
+        // the STAs of a failed query can be requested again
+        pthread_mutex_lock(&m_unassoc_lock);
+        for (j = i; j < num; j++) {
+            if (targets[j].op_class == targets[i].op_class) {
+                m_unassoc_inflight.erase(unassoc_key(targets[j].sta, targets[j].op_class));
+            }
+        }
+        pthread_mutex_unlock(&m_unassoc_lock);
+    }
+
+    return sent;
+}
+
+int em_metrics_t::send_unassoc_sta_link_metrics_query(unsigned char op_class, const em_unassoc_sta_target_t *targets, unsigned int num)
+{
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    em_tlv_writer_t *writer = get_tlv_writer();
+    unsigned char value[2 + EM_UNASSOC_STA_QUERY_MAX_PENDING * (2 + sizeof(mac_address_t))];
+    unsigned char *frame;
+    unsigned int value_len, len = 0;
+    dm_easy_mesh_t *dm = get_data_model();
+
+    if ((value_len = em_unassoc_sta_tlv_t::encode_query(op_class, targets, num, value, sizeof(value))) == 0) {
+        printf("%s:%d: Unassociated STA Link Metrics Query TLV build failed for op class %d\n", __func__, __LINE__, op_class);
+        return -1;
+    }
+
+    writer->begin(dm->get_agent_al_interface_mac(), dm->get_ctrl_al_interface_mac(),
+        em_msg_type_unassoc_sta_link_metrics_query, get_mgr()->get_next_msg_id());
+
+    // Unassociated STA Link Metrics Query TLV (see section 17.2.25)
+    writer->add_tlv(em_tlv_type_unassoc_sta_link_metric_query, value, value_len);
+
+    if ((writer->finish() != 1) || ((frame = writer->get_frame(0, &len)) == NULL)) {
+        printf("%s:%d: Unassociated STA Link Metrics Query build failed\n", __func__, __LINE__);
+        return -1;
+    }
+
+    if (em_msg_t(em_msg_type_unassoc_sta_link_metrics_query, em_profile_type_2, frame, len).validate(errors) == 0) {
+        printf("Unassociated STA Link Metrics Query msg validation failed\n");
+        return -1;
+    }
+
+    if (send_frame(frame, len)  < 0) {
+        printf("%s:%d: Unassociated STA Link Metrics Query send failed, error:%d\n", __func__, __LINE__, errno);
+        return -1;
+    }
+
+    printf("%s:%d: Unassociated STA Link Metrics Query for op class %d send success\n", __func__, __LINE__, op_class);
+    return static_cast<int> (len);
+}
+
+int em_metrics_t::handle_unassoc_sta_link_metrics_query(unsigned char *buff, unsigned int len)
+{
+    em_unassoc_sta_target_t targets[EM_UNASSOC_STA_QUERY_MAX_PENDING];
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    em_cmdu_t *cmdu = reinterpret_cast<em_cmdu_t *> (buff + sizeof(em_raw_hdr_t));
+    em_tlv_t *tlv;
+    int num;
+
+    if (em_msg_t(em_msg_type_unassoc_sta_link_metrics_query, em_profile_type_2, buff, len).validate(errors) == 0) {
+        printf("%s:%d: Unassociated STA Link Metrics Query validation failed\n", __func__, __LINE__);
+        return -1;
+    }
+
+    em_msg_t msg(buff + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t), len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)));
+    if (((tlv = msg.get_tlv(em_tlv_type_unassoc_sta_link_metric_query)) == NULL) ||
+            ((num = em_unassoc_sta_tlv_t::decode_query(tlv->value, htons(tlv->len), targets, EM_UNASSOC_STA_QUERY_MAX_PENDING)) <= 0)) {
+        printf("%s:%d: Unassociated STA Link Metrics Query TLV malformed\n", __func__, __LINE__);
+        return -1;
+    }
+
+    // the radios report no off channel measurement of STAs, the response names none
+    send_unassoc_sta_link_metrics_response(targets[0].op_class, NULL, 0, ntohs(cmdu->id));
+
+    return 0;
+}
+
+int em_metrics_t::send_unassoc_sta_link_metrics_response(unsigned char op_class, const em_unassoc_sta_meas_t *meas, unsigned int num,
+                                                         unsigned short msg_id)
+{
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    em_tlv_writer_t *writer = get_tlv_writer();
+    unsigned char value[2 + EM_UNASSOC_STA_QUERY_MAX_PENDING * (sizeof(mac_address_t) + 6)];
+    unsigned char *frame;
+    unsigned int value_len, len = 0;
+    dm_easy_mesh_t *dm = get_data_model();
+
+    if (num > EM_UNASSOC_STA_QUERY_MAX_PENDING) {
+        num = EM_UNASSOC_STA_QUERY_MAX_PENDING;
+    }
+    if ((value_len = em_unassoc_sta_tlv_t::encode_response(op_class, meas, num, value, sizeof(value))) == 0) {
+        printf("%s:%d: Unassociated STA Link Metrics Response TLV build failed\n", __func__, __LINE__);
+        return -1;
+    }
+
+    writer->begin(dm->get_ctl_mac(), dm->get_agent_al_interface_mac(), em_msg_type_unassoc_sta_link_metrics_rsp, msg_id);
+
+    // Unassociated STA Link Metrics Response TLV (see section 17.2.26)
+    writer->add_tlv(em_tlv_type_unassoc_sta_link_metric_rsp, value, value_len);
+
+    if ((writer->finish() != 1) || ((frame = writer->get_frame(0, &len)) == NULL)) {
+        printf("%s:%d: Unassociated STA Link Metrics Response build failed\n", __func__, __LINE__);
+        return -1;
+    }
+
+    if (em_msg_t(em_msg_type_unassoc_sta_link_metrics_rsp, em_profile_type_2, frame, len).validate(errors) == 0) {
+        printf("Unassociated STA Link Metrics Response msg validation failed\n");
+        return -1;
+    }
+
+    if (send_frame(frame, len)  < 0) {
+        printf("%s:%d: Unassociated STA Link Metrics Response send failed, error:%d\n", __func__, __LINE__, errno);
+        return -1;
+    }
+
+    printf("%s:%d: Unassociated STA Link Metrics Response for %u stations send success\n", __func__, __LINE__, num);
+    return static_cast<int> (len);
+}
+
+int em_metrics_t::handle_unassoc_sta_link_metrics_response(unsigned char *buff, unsigned int len)
+{
+    em_unassoc_sta_meas_t meas[EM_UNASSOC_STA_QUERY_MAX_PENDING];
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    em_beacon_report_cache_t *cache = get_mgr()->get_unassoc_stas();
+    unsigned long long now = em_timer_wheel_t::get_time_ms();
+    dm_easy_mesh_t *dm = get_data_model();
+    em_beacon_report_entry_t entry;
+    em_op_class_info_t *info;
+    dm_bss_t *bss;
+    unsigned char op_class;
+    unsigned int i, j, k;
+    em_tlv_t *tlv;
+    int num, added = 0;
+
+    if (em_msg_t(em_msg_type_unassoc_sta_link_metrics_rsp, em_profile_type_2, buff, len).validate(errors) == 0) {
+        printf("%s:%d: Unassociated STA Link Metrics Response validation failed\n", __func__, __LINE__);
+        return -1;
+    }
+
+    em_msg_t msg(buff + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t), len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)));
+    if (((tlv = msg.get_tlv(em_tlv_type_unassoc_sta_link_metric_rsp)) == NULL) ||
+            ((num = em_unassoc_sta_tlv_t::decode_response(tlv->value, htons(tlv->len), &op_class, meas, EM_UNASSOC_STA_QUERY_MAX_PENDING)) < 0)) {
+        printf("%s:%d: Unassociated STA Link Metrics Response TLV malformed\n", __func__, __LINE__);
+        return -1;
+    }
+
+    for (i = 0; i < static_cast<unsigned int> (num); i++) {
+        // the target is a fronthaul BSS of the radio operating on the channel measured
+        for (j = 0; j < dm->get_num_op_class(); j++) {
+            info = &dm->get_op_class(j)->m_op_class_info;
+            if ((info->id.type != em_op_class_type_current) || (info->op_class != op_class) || (info->channel != meas[i].channel)) {
+                continue;
+            }
+            for (k = 0; k < dm->get_num_bss(); k++) {
+                bss = dm->get_bss(k);
+                if ((bss->m_bss_info.enabled == false) || (bss->m_bss_info.vap_mode != em_vap_mode_ap) ||
+                        (memcmp(bss->m_bss_info.ruid.mac, info->id.ruid, sizeof(mac_address_t)) != 0)) {
+                    continue;
+                }
+                memset(&entry, 0, sizeof(entry));
+                memcpy(entry.bssid, bss->m_bss_info.bssid.mac, sizeof(bssid_t));
+                entry.op_class = op_class;
+                entry.channel = meas[i].channel;
+                entry.rcpi = meas[i].rcpi;
+                entry.time_ms = (meas[i].time_delta_ms < now) ? (now - meas[i].time_delta_ms):0;
+                cache->update(meas[i].sta, &entry);
+                added++;
+            }
+        }
+    }
+
+    // the response answers the whole query, the STAs the agent did not measure are not waited for
+    pthread_mutex_lock(&m_unassoc_lock);
+    for (auto it = m_unassoc_inflight.begin(); it != m_unassoc_inflight.end();) {
+        if ((it->first >> 48) == op_class) {
+            it = m_unassoc_inflight.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    pthread_mutex_unlock(&m_unassoc_lock);
+
+    printf("%s:%d: Unassociated STA Link Metrics Response rcvd, %d stations, %d entries\n", __func__, __LINE__, num, added);
+
+    return added;
+}
+
 int em_metrics_t::send_beacon_metrics_response()
 {
     unsigned char buff[MAX_EM_BUFF_SZ];
@@ -770,7 +1347,7 @@ int em_metrics_t::send_beacon_metrics_response()
     bool sta_found = false;
     dm_sta_t *sta;
 
-    sta = reinterpret_cast<dm_sta_t *> (hash_map_get_first(get_current_cmd()->get_data_model()->m_sta_map));
+    sta = reinterpret_cast<dm_sta_t *> (get_current_cmd()->get_data_model()->m_sta_map->get_first());
 
     memcpy(tmp, dm->get_ctl_mac(), sizeof(mac_address_t));
     tmp += sizeof(mac_address_t);
@@ -838,156 +1415,152 @@ int em_metrics_t::send_beacon_metrics_response()
 
 int em_metrics_t::send_ap_metrics_response()
 {
-    unsigned char buff[MAX_EM_BUFF_SZ] = {0};
     char *errors[EM_MAX_TLV_MEMBERS] = {0};
-    unsigned short  msg_type = em_msg_type_ap_metrics_rsp;
-    size_t len = 0;
-    em_cmdu_t *cmdu;
-    em_tlv_t *tlv;
-    unsigned char *tmp = buff;
-    short sz = 0;
-    unsigned short type = htons(ETH_P_1905);
+    em_tlv_writer_t *writer = get_tlv_writer();
+    unsigned char *frames[EM_TLV_WRITER_MAX_FRAGS];
+    unsigned int lens[EM_TLV_WRITER_MAX_FRAGS];
+    unsigned char *tmp;
+    int num, len = 0;
+    unsigned int i;
     dm_easy_mesh_t *dm = get_data_model();
-    mac_addr_str_t mac_str;
+    dm_radio_t *radio;
     dm_sta_t *sta;
     int bss_index = 0;
+    unsigned int reported = 0, unchanged = 0, bss_reported = 0, bss_unchanged = 0;
+    unsigned int util = 0, util_delta = m_ap_delta.util_delta;
+    // a full report every few lets the controller age out BSSs and STAs it stopped hearing
+    // about and refreshes the counters that moved less than the thresholds
+    bool full = (m_ap_delta.full_interval <= 1) || ((m_ap_metrics_stats.reports % m_ap_delta.full_interval) == 0);
+
+    // the reporting threshold of the Metric Reporting Policy of the radio prevails
+    if ((radio = dm->get_radio(get_current_cmd()->get_param()->u.ap_metrics_params.ruid)) != NULL) {
+        util = radio->get_radio_info()->utilization;
+        if (radio->get_radio_info()->channel_utilization_reporting_threshold != 0) {
+            util_delta = radio->get_radio_info()->channel_utilization_reporting_threshold;
+        }
+    }
 
-    memcpy(tmp, dm->get_ctl_mac(), sizeof(mac_address_t));
-    tmp += sizeof(mac_address_t);
-    len += sizeof(mac_address_t);
-
-    memcpy(tmp, dm->get_agent_al_interface_mac(), sizeof(mac_address_t));
-    tmp += sizeof(mac_address_t);
-    len += sizeof(mac_address_t);
-
-    memcpy(tmp, reinterpret_cast<unsigned char *> (&type), sizeof(unsigned short));
-    tmp += sizeof(unsigned short);
-    len += sizeof(unsigned short);
-
-    cmdu = reinterpret_cast<em_cmdu_t *> (tmp);
-
-    memset(tmp, 0, sizeof(em_cmdu_t));
-    cmdu->type = htons(msg_type);
-    cmdu->id = htons(get_mgr()->get_next_msg_id());
-    cmdu->last_frag_ind = 1;
-
-    tmp += sizeof(em_cmdu_t);
-    len += sizeof(em_cmdu_t);
+    // reports with many stations span several frames, the writer fragments them
+    writer->begin(dm->get_ctl_mac(), dm->get_agent_al_interface_mac(), em_msg_type_ap_metrics_rsp, get_mgr()->get_next_msg_id());
 
     //AP Metrics Response 17.1.17
-    //AP Metrics TLV (17.2.22)
+    //Radio Metrics TLV (17.2.60), of the one radio of the response, it was repeated for each BSS
+    if ((tmp = writer->open_tlv(em_tlv_type_radio_metric)) != NULL) {
+        writer->close_tlv(static_cast<unsigned int> (create_radio_metrics_tlv(tmp)));
+    }
+
     for (bss_index = 0; bss_index < static_cast<int>(dm->m_num_bss); bss_index++) {
         if (memcmp(dm->m_bss[bss_index].m_bss_info.ruid.mac,
             get_current_cmd()->get_param()->u.ap_metrics_params.ruid, sizeof(mac_addr_t)) != 0) {
             continue;
         }
 
-        tlv = reinterpret_cast<em_tlv_t *> (tmp);
-        tlv->type = em_tlv_type_ap_metrics;
-        sz = create_ap_metrics_tlv(tlv->value, dm->m_bss[bss_index]);
-        tlv->len =  htons(static_cast<unsigned short> (sz));
+        if (bss_report_due(dm->m_bss[bss_index], util, util_delta, full) == false) {
+            bss_unchanged++;
+        } else {
+            bss_reported++;
 
-        tmp += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
-        len += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
-
-        //AP Extended Metrics TLV (17.2.61)
-        tlv = reinterpret_cast<em_tlv_t *> (tmp);
-        tlv->type = em_tlv_type_ap_ext_metric;
-        sz = create_ap_ext_metrics_tlv(tlv->value, dm->m_bss[bss_index]);
-        tlv->len =  htons(static_cast<unsigned short> (sz));
-
-        tmp += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
-        len += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
-
-        //Radio Metrics TLV (17.2.60)
-        tlv = reinterpret_cast<em_tlv_t *> (tmp);
-        tlv->type = em_tlv_type_radio_metric;
-        sz = create_radio_metrics_tlv(tlv->value);
-        tlv->len =  htons(static_cast<unsigned short> (sz));
+            //AP Metrics TLV (17.2.22)
+            if ((tmp = writer->open_tlv(em_tlv_type_ap_metrics)) != NULL) {
+                writer->close_tlv(static_cast<unsigned int> (create_ap_metrics_tlv(tmp, dm->m_bss[bss_index])));
+            }
 
-        tmp += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
-        len += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
+            //AP Extended Metrics TLV (17.2.61)
+            if ((tmp = writer->open_tlv(em_tlv_type_ap_ext_metric)) != NULL) {
+                writer->close_tlv(static_cast<unsigned int> (create_ap_ext_metrics_tlv(tmp, dm->m_bss[bss_index])));
+            }
+        }
 
         //now search if this sta is associated to this
-        sta = reinterpret_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_map));
+        sta = reinterpret_cast<dm_sta_t *> (dm->m_sta_map->get_first());
         while(sta != NULL) {
             if (memcmp(sta->get_sta_info()->bssid, dm->m_bss[bss_index].m_bss_info.bssid.mac, sizeof(mac_address_t)) != 0) {
-                sta = static_cast<dm_sta_t *>(hash_map_get_next(dm->m_sta_map, sta));
+                sta = static_cast<dm_sta_t *>(dm->m_sta_map->get_next(sta));
                 continue;
             }
-            //Associated STA Traffic Stats TLV (17.2.35)
-            tlv = reinterpret_cast<em_tlv_t *> (tmp);
-            tlv->type = em_tlv_type_assoc_sta_traffic_sts;
-            sz = create_assoc_sta_traffic_stats_tlv(tlv->value, sta);
-            tlv->len =  htons(static_cast<unsigned short> (sz));
+            if (sta_report_due(em_sta_report_type_ap_metrics, sta, full) == false) {
+                unchanged++;
+                sta = static_cast<dm_sta_t *>(dm->m_sta_map->get_next(sta));
+                continue;
+            }
+            reported++;
 
-            tmp += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
-            len += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
+            //Associated STA Traffic Stats TLV (17.2.35)
+            if ((tmp = writer->open_tlv(em_tlv_type_assoc_sta_traffic_sts)) != NULL) {
+                writer->close_tlv(static_cast<unsigned int> (create_assoc_sta_traffic_stats_tlv(tmp, sta)));
+            }
 
             //Associated STA Link Metrics TLV (17.2.24).
-            tlv = reinterpret_cast<em_tlv_t *> (tmp);
-            tlv->type = em_tlv_type_assoc_sta_link_metric;
-            sz = create_assoc_sta_link_metrics_tlv(tlv->value, sta->m_sta_info.id, sta);
-            tlv->len =  htons(static_cast<unsigned short> (sz));
-
-            tmp += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
-            len += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
+            if ((tmp = writer->open_tlv(em_tlv_type_assoc_sta_link_metric)) != NULL) {
+                writer->close_tlv(static_cast<unsigned int> (create_assoc_sta_link_metrics_tlv(tmp, sta->m_sta_info.id, sta)));
+            }
 
             //Associated STA Extended Link Metrics TLV (17.2.62)
-            tlv = reinterpret_cast<em_tlv_t *> (tmp);
-            tlv->type = em_tlv_type_assoc_sta_ext_link_metric;
-            sz = create_assoc_ext_sta_link_metrics_tlv(tlv->value, sta->m_sta_info.id, sta);
-            tlv->len =  htons(static_cast<unsigned short> (sz));
-
-            tmp += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
-            len += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
+            if ((tmp = writer->open_tlv(em_tlv_type_assoc_sta_ext_link_metric)) != NULL) {
+                writer->close_tlv(static_cast<unsigned int> (create_assoc_ext_sta_link_metrics_tlv(tmp, sta->m_sta_info.id, sta)));
+            }
 
             //Associated Wi-Fi 6 STA Status Report TLV (17.2.73)
             //Profile-3 msg, hence failing even though optional
-            tlv = reinterpret_cast<em_tlv_t *> (tmp);
-            tlv->type = em_tlv_type_assoc_wifi6_sta_rprt;
-            sz = create_assoc_wifi6_sta_sta_report_tlv(tlv->value, sta);
-            tlv->len =  htons(static_cast<unsigned short> (sz));
-
-            tmp += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
-            len += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
+            if ((tmp = writer->open_tlv(em_tlv_type_assoc_wifi6_sta_rprt)) != NULL) {
+                writer->close_tlv(static_cast<unsigned int> (create_assoc_wifi6_sta_sta_report_tlv(tmp, sta)));
+            }
 
             //assoc vendor link metrics
-            tlv = reinterpret_cast<em_tlv_t *> (tmp);
-            tlv->type = em_tlv_type_vendor_sta_metrics;
-            sz = create_assoc_vendor_sta_link_metrics_tlv(tlv->value, sta->m_sta_info.id, sta);
-            tlv->len = htons(static_cast<short unsigned int> (sz));
-
-            tmp += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
-            len += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
+            if ((tmp = writer->open_tlv(em_tlv_type_vendor_sta_metrics)) != NULL) {
+                writer->close_tlv(static_cast<unsigned int> (create_assoc_vendor_sta_link_metrics_tlv(tmp, sta->m_sta_info.id, sta)));
+            }
 
-            sta = reinterpret_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_map, sta));
+            sta = reinterpret_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
         }
     }
 
     // End of message
-    tlv = reinterpret_cast<em_tlv_t *> (tmp);
-    tlv->type = em_tlv_type_eom;
-    tlv->len = 0;
-
-    tmp += (sizeof(em_tlv_t));
-    len += (sizeof(em_tlv_t));
+    if ((num = writer->finish()) < 0) {
+        printf("%s:%d: AP Metrics Response build failed\n", __func__, __LINE__);
+        // the BSSs and STAs were not reported, the next report has them all
+        m_sta_last_report[em_sta_report_type_ap_metrics].clear();
+        m_bss_last_report.clear();
+        return -1;
+    }
 
-    if (em_msg_t(em_msg_type_ap_metrics_rsp, em_profile_type_2, buff, static_cast<unsigned int> (len)).validate(errors) == 0) {
-        printf("%s:%d: AP Metrics Response validation failed for %s\n", __func__, __LINE__, mac_str);
+    num = static_cast<int> (writer->get_frames(frames, lens, EM_TLV_WRITER_MAX_FRAGS));
+    if ((num == 1) && (em_msg_t(em_msg_type_ap_metrics_rsp, em_profile_type_2, frames[0], lens[0]).validate(errors) == 0)) {
+        printf("%s:%d: AP Metrics Response validation failed\n", __func__, __LINE__);
         //return -1;
     }
 
-    if (send_frame(buff, static_cast<unsigned int> (len))  < 0) {
+    if (send_frames(frames, lens, static_cast<unsigned int> (num)) != num) {
         printf("%s:%d: AP Metrics Response send failed, error:%d\n", __func__, __LINE__, errno);
+        m_sta_last_report[em_sta_report_type_ap_metrics].clear();
+        m_bss_last_report.clear();
         return -1;
     }
 
-    printf("%s:%d: AP Metrics Response send success\n", __func__, __LINE__);
+    for (i = 0; i < static_cast<unsigned int> (num); i++) {
+        len += static_cast<int> (lens[i]);
+    }
+
+    // BSSs and STAs that left since the previous report are forgotten
+    sta_report_prune(em_sta_report_type_ap_metrics);
+    bss_report_prune();
+
+    m_ap_metrics_stats.reports++;
+    m_ap_metrics_stats.bytes += static_cast<unsigned long long> (len);
+    m_ap_metrics_stats.last_bytes = static_cast<unsigned int> (len);
+    m_ap_metrics_stats.last_frames = static_cast<unsigned int> (num);
+    m_ap_metrics_stats.stas_reported += reported;
+    m_ap_metrics_stats.stas_unchanged += unchanged;
+    m_ap_metrics_stats.bsss_reported += bss_reported;
+    m_ap_metrics_stats.bsss_unchanged += bss_unchanged;
+
+    printf("%s:%d: AP Metrics Response send success, fragments: %d, bytes: %d, avg bytes per report: %llu, bsss: %u, unchanged: %u, stations: %u, unchanged: %u\n",
+        __func__, __LINE__, num, len, m_ap_metrics_stats.bytes / m_ap_metrics_stats.reports, bss_reported, bss_unchanged,
+        reported, unchanged);
 
     set_state(em_state_agent_configured);
 
-    return static_cast<int> (len);
+    return len;
 }
 
 short em_metrics_t::create_assoc_sta_link_metrics_tlv(unsigned char *buff, mac_address_t sta_mac, const dm_sta_t *const sta)
@@ -1141,12 +1714,12 @@ short em_metrics_t::create_beacon_metrics_query_tlv(unsigned char *buff, mac_add
     
 	dm = get_data_model();
 
-    sta = reinterpret_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_map));
+    sta = reinterpret_cast<dm_sta_t *> (dm->m_sta_map->get_first());
     while(sta != NULL) {
         if (memcmp(sta->m_sta_info.id, sta_mac, sizeof(mac_address_t)) == 0) {
             break;
         }
-        sta = reinterpret_cast<dm_sta_t *> (hash_map_get_next(dm->m_sta_map, sta));
+        sta = reinterpret_cast<dm_sta_t *> (dm->m_sta_map->get_next(sta));
     }
 
     for (j = 0; j < dm->get_num_bss(); j++) {
@@ -1230,7 +1803,7 @@ short em_metrics_t::create_beacon_metrics_response_tlv(unsigned char *buff)
 
     dm = get_current_cmd()->get_data_model();
     dm_sta_t *sta;
-    sta = reinterpret_cast<dm_sta_t *> (hash_map_get_first(dm->m_sta_map));
+    sta = reinterpret_cast<dm_sta_t *> (dm->m_sta_map->get_first());
     if (sta != NULL) {
         memcpy(response->sta_mac_addr, sta->m_sta_info.id, sizeof(mac_addr_t));
         len += sizeof(response->sta_mac_addr);
@@ -1313,6 +1886,104 @@ short em_metrics_t::create_radio_metrics_tlv(unsigned char *buff)
     return static_cast<short> (len);
 }
 
+bool em_metrics_t::sta_report_due(em_sta_report_type_t type, const dm_sta_t *const sta, bool full)
+{
+    std::unordered_map<unsigned long long, em_sta_report_snapshot_t>& table = m_sta_last_report[type];
+    unsigned long long key = 0;
+    em_sta_report_snapshot_t *last;
+    int rcpi_delta;
+
+    memcpy(&key, sta->m_sta_info.id, sizeof(mac_address_t));
+    auto it = table.find(key);
+    if (it == table.end()) {
+        table[key] = {sta->m_sta_info.bytes_tx, sta->m_sta_info.bytes_rx, sta->m_sta_info.rcpi, m_sta_report_gen[type]};
+        return true;
+    }
+
+    last = &it->second;
+    last->gen = m_sta_report_gen[type];
+
+    // unsigned differences, a counter that wrapped still gives its delta
+    rcpi_delta = static_cast<int> (sta->m_sta_info.rcpi) - static_cast<int> (last->rcpi);
+    if ((full == false) && ((sta->m_sta_info.bytes_tx - last->bytes_tx) < m_ap_delta.sta_bytes_delta) &&
+            ((sta->m_sta_info.bytes_rx - last->bytes_rx) < m_ap_delta.sta_bytes_delta) &&
+            (static_cast<unsigned int> (abs(rcpi_delta)) < m_ap_delta.sta_rcpi_delta)) {
+        return false;
+    }
+
+    last->bytes_tx = sta->m_sta_info.bytes_tx;
+    last->bytes_rx = sta->m_sta_info.bytes_rx;
+    last->rcpi = sta->m_sta_info.rcpi;
+
+    return true;
+}
+
+void em_metrics_t::sta_report_prune(em_sta_report_type_t type)
+{
+    std::unordered_map<unsigned long long, em_sta_report_snapshot_t>& table = m_sta_last_report[type];
+
+    for (auto it = table.begin(); it != table.end(); ) {
+        if (it->second.gen != m_sta_report_gen[type]) {
+            it = table.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_sta_report_gen[type]++;
+}
+
+bool em_metrics_t::bss_report_due(const dm_bss_t& bss, unsigned int util, unsigned int util_delta, bool full)
+{
+    const em_bss_info_t *info = &bss.m_bss_info;
+    unsigned long long key = 0;
+    em_bss_report_snapshot_t *last;
+
+    memcpy(&key, info->bssid.mac, sizeof(mac_address_t));
+    auto it = m_bss_last_report.find(key);
+    if (it == m_bss_last_report.end()) {
+        m_bss_last_report[key] = {util, info->numberofsta, info->unicast_bytes_sent, info->unicast_bytes_rcvd, m_bss_report_gen};
+        return true;
+    }
+
+    last = &it->second;
+    last->gen = m_bss_report_gen;
+
+    // any STA joining or leaving is reported, the counters only once they moved enough
+    if ((full == false) && (info->numberofsta == last->num_sta) &&
+            (static_cast<unsigned int> (abs(static_cast<int> (util) - static_cast<int> (last->util))) < util_delta) &&
+            ((info->unicast_bytes_sent - last->bytes_sent) < m_ap_delta.bss_bytes_delta) &&
+            ((info->unicast_bytes_rcvd - last->bytes_rcvd) < m_ap_delta.bss_bytes_delta)) {
+        return false;
+    }
+
+    last->util = util;
+    last->num_sta = info->numberofsta;
+    last->bytes_sent = info->unicast_bytes_sent;
+    last->bytes_rcvd = info->unicast_bytes_rcvd;
+
+    return true;
+}
+
+void em_metrics_t::bss_report_prune()
+{
+    for (auto it = m_bss_last_report.begin(); it != m_bss_last_report.end(); ) {
+        if (it->second.gen != m_bss_report_gen) {
+            it = m_bss_last_report.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_bss_report_gen++;
+}
+
+void em_metrics_t::set_ap_metrics_delta_params(const em_ap_metrics_delta_params_t *params)
+{
+    m_ap_delta = *params;
+    // the snapshots were taken against the previous thresholds
+    m_sta_last_report[em_sta_report_type_ap_metrics].clear();
+    m_bss_last_report.clear();
+}
+
 short em_metrics_t::create_assoc_sta_traffic_stats_tlv(unsigned char *buff, const dm_sta_t *const sta)
 {
     size_t len = 0;
@@ -1403,6 +2074,14 @@ void em_metrics_t::process_msg(unsigned char *data, unsigned int len)
             handle_ap_metrics_response(data, len);
             break;
 
+        case em_msg_type_unassoc_sta_link_metrics_query:
+            handle_unassoc_sta_link_metrics_query(data, len);
+            break;
+
+        case em_msg_type_unassoc_sta_link_metrics_rsp:
+            handle_unassoc_sta_link_metrics_response(data, len);
+            break;
+
         default:
             break;
     }
@@ -1440,12 +2119,47 @@ void em_metrics_t::process_agent_state()
     }
 }
 
-em_metrics_t::em_metrics_t()
+void em_metrics_t::set_sta_link_metrics_query_batch(unsigned int batch)
+{
+    if (batch == 0) {
+        batch = 1;
+    } else if (batch > EM_STA_LINK_METRICS_QUERY_MAX_BATCH) {
+        batch = EM_STA_LINK_METRICS_QUERY_MAX_BATCH;
+    }
+    m_sta_query_batch = batch;
+}
+
+unsigned int em_metrics_t::get_sta_link_metrics_poll_slot()
 {
+    unsigned char *al_mac = get_data_model()->get_agent_al_interface_mac();
+    unsigned int hash = 2166136261u;
+    unsigned int i;
+
+    // FNV-1a, consecutive AL MACs land in different slots
+    for (i = 0; i < sizeof(mac_address_t); i++) {
+        hash = (hash ^ al_mac[i]) * 16777619u;
+    }
 
+    return hash % EM_STA_LINK_METRICS_POLL_SLOTS;
 }
 
-em_metrics_t::~em_metrics_t()
+em_metrics_t::em_metrics_t()
 {
+    m_sta_query_batch = 1;
+    memset(&m_ap_metrics_stats, 0, sizeof(m_ap_metrics_stats));
+    memset(m_sta_report_gen, 0, sizeof(m_sta_report_gen));
+    m_bss_report_gen = 0;
+    m_ap_delta.full_interval = EM_AP_METRICS_FULL_REPORT_INTERVAL;
+    m_ap_delta.util_delta = EM_AP_METRICS_UTIL_DELTA;
+    m_ap_delta.bss_bytes_delta = EM_AP_METRICS_BSS_BYTES_DELTA;
+    m_ap_delta.sta_bytes_delta = EM_STA_REPORT_BYTES_DELTA;
+    m_ap_delta.sta_rcpi_delta = EM_STA_REPORT_RCPI_DELTA;
+    pthread_mutex_init(&m_beacon_lock, NULL);
+    pthread_mutex_init(&m_unassoc_lock, NULL);
+}
 
+em_metrics_t::~em_metrics_t()
+{
+    pthread_mutex_destroy(&m_beacon_lock);
+    pthread_mutex_destroy(&m_unassoc_lock);
 }
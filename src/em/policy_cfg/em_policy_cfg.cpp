@@ -19,6 +19,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <errno.h>
 #include <assert.h>
 #include <signal.h>
@@ -41,6 +42,64 @@
 #include "em_msg.h"
 #include "em_cmd_exec.h"
 
+dm_easy_mesh_t *em_policy_cfg_t::get_policy_data_model()
+{
+	if ((get_current_cmd() != NULL) && (get_current_cmd()->get_type() == em_cmd_type_set_policy)) {
+		return get_current_cmd()->get_data_model();
+	}
+
+	return get_data_model();
+}
+
+int em_policy_cfg_t::find_radio_policy(dm_easy_mesh_t *dm, em_policy_id_type_t type)
+{
+	dm_policy_t *policy;
+	unsigned int i;
+	mac_address_t broadcast_mac = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+
+	for (i = 0; i < dm->get_num_policy(); i++) {
+		policy = &dm->m_policy[i];
+		if (policy->m_policy.id.type != type) {
+			continue;
+		}
+		if ((memcmp(policy->m_policy.id.radio_mac, broadcast_mac, sizeof(mac_address_t)) == 0) ||
+				(memcmp(policy->m_policy.id.radio_mac, get_radio_interface_mac(), sizeof(mac_address_t)) == 0)) {
+			return static_cast<int> (i);
+		}
+	}
+
+	return -1;
+}
+
+unsigned long long em_policy_cfg_t::get_policy_key(dm_easy_mesh_t *dm)
+{
+	unsigned long long key = 14695981039346656037ULL;
+	em_policy_t *policy;
+	unsigned int i;
+	int radio[2];
+
+	// FNV-1a
+	auto hash = [&key](const void *data, size_t len) {
+		const unsigned char *p = static_cast<const unsigned char *> (data);
+		for (size_t j = 0; j < len; j++) {
+			key = (key ^ p[j]) * 1099511628211ULL;
+		}
+	};
+
+	for (i = 0; i < dm->get_num_policy(); i++) {
+		policy = &dm->m_policy[i].m_policy;
+		hash(policy->id.radio_mac, sizeof(mac_address_t));
+		hash(&policy->id.type, sizeof(policy->id.type));
+		hash(&policy->num_sta, sizeof(em_policy_t) - offsetof(em_policy_t, num_sta));
+	}
+
+	radio[0] = find_radio_policy(dm, em_policy_id_type_steering_param);
+	radio[1] = find_radio_policy(dm, em_policy_id_type_radio_metrics_rep);
+	hash(radio, sizeof(radio));
+
+	return key;
+}
+
 short em_policy_cfg_t::create_metrics_rep_policy_tlv(unsigned char *buff)
 {
 	short len = 0;
@@ -51,13 +110,9 @@ short em_policy_cfg_t::create_metrics_rep_policy_tlv(unsigned char *buff)
 	unsigned int i = 0;
 	em_metric_rprt_policy_t	*metric;
 	em_metric_rprt_policy_radio_t *radio_metric;
-	mac_address_t broadcast_mac = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+	int radio;
 
-	if (get_current_cmd()->get_type() == em_cmd_type_em_config) {
-        dm = get_data_model();
-	} else if (get_current_cmd()->get_type() == em_cmd_type_set_policy) {
-        dm = get_current_cmd()->get_data_model();
-	}
+	dm = get_policy_data_model();
 
 	metric = reinterpret_cast<em_metric_rprt_policy_t *> (tmp);
 	for (i = 0; i < dm->get_num_policy(); i++) {
@@ -72,24 +127,12 @@ short em_policy_cfg_t::create_metrics_rep_policy_tlv(unsigned char *buff)
 		return 0;
 	}	
 
-	found_match = false;
 	metric->interval = static_cast<unsigned char> (policy->m_policy.interval);
 
-	for (i = 0; i < dm->get_num_policy(); i++) {
-		policy = &dm->m_policy[i];
-		if (policy->m_policy.id.type == em_policy_id_type_radio_metrics_rep) {
-			if ((memcmp(policy->m_policy.id.radio_mac, broadcast_mac, sizeof(mac_address_t)) == 0) ||
-					(memcmp(policy->m_policy.id.radio_mac, get_radio_interface_mac(), sizeof(mac_address_t)) == 0)) {
-				found_match = true;
-            	break;	
-			}
-		}
-	}
-
-	
-	if (found_match == false) {
+	if ((radio = find_radio_policy(dm, em_policy_id_type_radio_metrics_rep)) < 0) {
 		return 0;
 	}
+	policy = &dm->m_policy[radio];
 
 	metric->radios_num = 1;
 	radio_metric = &metric->radios[0];
@@ -127,8 +170,10 @@ short em_policy_cfg_t::create_steering_policy_tlv(unsigned char *buff)
 	em_steering_policy_radio_t	*radio_policy;
 	mac_address_t null_mac = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 	mac_address_t broadcast_mac = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+	int radio;
 
-	dm = get_data_model();
+	// the command's data model, as for the other policy TLVs
+	dm = get_policy_data_model();
 	
 	for (i = 0; i < dm->get_num_policy(); i++) {
 		policy = &dm->m_policy[i];
@@ -186,19 +231,10 @@ short em_policy_cfg_t::create_steering_policy_tlv(unsigned char *buff)
 	tmp += sizeof(unsigned char) + sta_policy->num_sta*sizeof(mac_address_t);
 	len += sizeof(unsigned char) + sta_policy->num_sta*sizeof(mac_address_t);
 
-	for (i = 0; i < dm->get_num_policy(); i++) {
-		policy = &dm->m_policy[i];
-		if (policy->m_policy.id.type == em_policy_id_type_steering_param) {
-			if ((memcmp(policy->m_policy.id.radio_mac, broadcast_mac, sizeof(mac_address_t)) == 0) ||
-					(memcmp(policy->m_policy.id.radio_mac, get_radio_interface_mac(), sizeof(mac_address_t)) == 0)) {
-				found_match = true;
-            	break;	
-			}
-		}
-	}
+	radio = find_radio_policy(dm, em_policy_id_type_steering_param);
 
 	//radio
-	if (found_match == false) {
+	if (radio < 0) {
 		*tmp = 0;
 		tmp += sizeof(unsigned char);
 		len += sizeof(unsigned char);
@@ -207,6 +243,7 @@ short em_policy_cfg_t::create_steering_policy_tlv(unsigned char *buff)
 		tmp += sizeof(unsigned char);
 		len += sizeof(unsigned char);
 
+		policy = &dm->m_policy[radio];
 		radio_policy = reinterpret_cast<em_steering_policy_radio_t *> (tmp);
 		memcpy(radio_policy->ruid, get_radio_interface_mac(), sizeof(mac_address_t));
 		radio_policy->steering_policy = static_cast<unsigned char> (policy->m_policy.policy);
@@ -236,11 +273,7 @@ short em_policy_cfg_t::create_traffic_sep_policy_tlv(unsigned char *buff)
     unsigned char *tmp = buff;
     unsigned int i = 0;
 
-    if (get_current_cmd()->get_type() == em_cmd_type_em_config) {
-        dm = get_data_model();
-    } else if (get_current_cmd()->get_type() == em_cmd_type_set_policy) {
-        dm = get_current_cmd()->get_data_model();
-    }
+    dm = get_policy_data_model();
 
     for (i = 0; i < dm->get_num_policy(); i++) {
         policy = &dm->m_policy[i];
@@ -319,7 +352,7 @@ short em_policy_cfg_t::create_vendor_policy_cfg_tlv(unsigned char *buff)
     unsigned char *tmp = buff;
     unsigned int i = 0;
 
-    dm = get_current_cmd()->get_data_model();
+    dm = get_policy_data_model();
 
     for (i = 0; i < dm->get_num_policy(); i++) {
         policy = &dm->m_policy[i];
@@ -340,49 +373,23 @@ short em_policy_cfg_t::create_vendor_policy_cfg_tlv(unsigned char *buff)
     return static_cast<short> (len);
 }
 
-int em_policy_cfg_t::send_policy_cfg_request_msg()
+size_t em_policy_cfg_t::create_policy_cfg_tlvs(unsigned char *buff, unsigned short *ruid_off, unsigned int *num_ruid)
 {
-    unsigned char buff[MAX_EM_BUFF_SZ];
-    char *errors[EM_MAX_TLV_MEMBERS] = {0};
-    unsigned short  msg_type = em_msg_type_map_policy_config_req;
     size_t len = 0;
-    em_cmdu_t *cmdu;
     em_tlv_t *tlv;
     short sz = 0;
     unsigned char *tmp = buff;
-    unsigned short type = htons(ETH_P_1905);
-    dm_easy_mesh_t *dm;
-
-    dm = get_data_model();
-
-    memcpy(tmp, dm->get_agent_al_interface_mac(), sizeof(mac_address_t));
-    tmp += sizeof(mac_address_t);
-    len += sizeof(mac_address_t);
-
-    memcpy(tmp, dm->get_ctrl_al_interface_mac(), sizeof(mac_address_t));
-    tmp += sizeof(mac_address_t);
-    len += sizeof(mac_address_t);
-
-    memcpy(tmp, reinterpret_cast<unsigned char *> (&type), sizeof(unsigned short));
-    tmp += sizeof(unsigned short);
-    len += sizeof(unsigned short);
-
-    cmdu = reinterpret_cast<em_cmdu_t *> (tmp);
 
-    memset(tmp, 0, sizeof(em_cmdu_t));
-    cmdu->type = htons(msg_type);
-    cmdu->id = htons(get_mgr()->get_next_msg_id());
-    cmdu->last_frag_ind = 1;
-    cmdu->relay_ind = 0;
-
-    tmp += sizeof(em_cmdu_t);
-    len += sizeof(em_cmdu_t);
+    *num_ruid = 0;
 
     // Zero or one Steering Policy TLV (see section 17.2.11).
     tlv = reinterpret_cast<em_tlv_t *> (tmp);
     tlv->type = em_tlv_type_steering_policy;
 	sz = create_steering_policy_tlv(tlv->value);
 	tlv->len = htons(static_cast<short unsigned int> (sz));
+	if (find_radio_policy(get_policy_data_model(), em_policy_id_type_steering_param) >= 0) {
+		ruid_off[(*num_ruid)++] = static_cast<unsigned short> (tlv->value + sz - sizeof(em_steering_policy_radio_t) - buff);
+	}
 
 	tmp += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
     len += (sizeof(em_tlv_t) + static_cast<size_t> (sz));    
@@ -392,6 +399,9 @@ int em_policy_cfg_t::send_policy_cfg_request_msg()
     tlv->type = em_tlv_type_metric_reporting_policy;
     sz = create_metrics_rep_policy_tlv(tlv->value);
     tlv->len = htons(static_cast<short unsigned int> (sz));
+    if (sz > 0) {
+        ruid_off[(*num_ruid)++] = static_cast<unsigned short> (reinterpret_cast<em_metric_rprt_policy_t *> (tlv->value)->radios[0].ruid - buff);
+    }
 
     tmp += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
     len += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
@@ -466,15 +476,72 @@ int em_policy_cfg_t::send_policy_cfg_request_msg()
 
     tmp += (sizeof (em_tlv_t));
     len += (sizeof (em_tlv_t));
-    if (em_msg_t(em_msg_type_map_policy_config_req, em_profile_type_3, buff, static_cast<unsigned int> (len)).validate(errors) == 0) {
-        printf("%s:%d: Policy Cfg Request msg validation failed\n", __func__, __LINE__);
-        return -1;
+
+    return len;
+}
+
+int em_policy_cfg_t::send_policy_cfg_request_msg()
+{
+    unsigned char buff[MAX_EM_BUFF_SZ];
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    unsigned short  msg_type = em_msg_type_map_policy_config_req;
+    size_t len = 0, tlvs_len = 0;
+    em_cmdu_t *cmdu;
+    unsigned char *tmp = buff;
+    unsigned short type = htons(ETH_P_1905);
+    unsigned short msg_id;
+    unsigned short ruid_off[EM_POLICY_PUSH_MAX_RUID];
+    unsigned int num_ruid;
+    unsigned long long key;
+    em_policy_push_t *push = get_mgr()->get_policy_push();
+    dm_easy_mesh_t *dm;
+
+    dm = get_data_model();
+
+    memcpy(tmp, dm->get_agent_al_interface_mac(), sizeof(mac_address_t));
+    tmp += sizeof(mac_address_t);
+    len += sizeof(mac_address_t);
+
+    memcpy(tmp, dm->get_ctrl_al_interface_mac(), sizeof(mac_address_t));
+    tmp += sizeof(mac_address_t);
+    len += sizeof(mac_address_t);
+
+    memcpy(tmp, reinterpret_cast<unsigned char *> (&type), sizeof(unsigned short));
+    tmp += sizeof(unsigned short);
+    len += sizeof(unsigned short);
+
+    cmdu = reinterpret_cast<em_cmdu_t *> (tmp);
+
+    msg_id = get_mgr()->get_next_msg_id();
+    memset(tmp, 0, sizeof(em_cmdu_t));
+    cmdu->type = htons(msg_type);
+    cmdu->id = htons(msg_id);
+    cmdu->last_frag_ind = 1;
+    cmdu->relay_ind = 0;
+
+    tmp += sizeof(em_cmdu_t);
+    len += sizeof(em_cmdu_t);
+
+    // the TLVs are encoded once per policy set, the other radios and the agents onboarding
+    // or reconnecting later copy them until the policies change
+    key = get_policy_key(get_policy_data_model());
+    tlvs_len = push->get_encoding(key, get_radio_interface_mac(), tmp, static_cast<unsigned int> (sizeof(buff) - len));
+
+    if (tlvs_len == 0) {
+        tlvs_len = create_policy_cfg_tlvs(tmp, ruid_off, &num_ruid);
+        if (em_msg_t(em_msg_type_map_policy_config_req, em_profile_type_3, buff, static_cast<unsigned int> (len + tlvs_len)).validate(errors) == 0) {
+            printf("%s:%d: Policy Cfg Request msg validation failed\n", __func__, __LINE__);
+            return -1;
+        }
+        push->put_encoding(key, tmp, static_cast<unsigned int> (tlvs_len), ruid_off, num_ruid);
     }
+    len += tlvs_len;
 
     if (send_frame(buff, static_cast<unsigned int> (len))  < 0) {
         printf("%s:%d: Policy Cfg Request msg send failed, error:%d\n", __func__, __LINE__, errno);
         return -1;
     }
+    push->sent(dm->get_agent_al_interface_mac(), msg_id, em_timer_wheel_t::get_time_ms());
 
 	printf("%s:%d: Policy Cfg Request Msg Send Success\n", __func__, __LINE__);
 
@@ -482,6 +549,61 @@ int em_policy_cfg_t::send_policy_cfg_request_msg()
 
 }
 
+int em_policy_cfg_t::send_policy_cfg_ack(unsigned short msg_id)
+{
+    unsigned char buff[MAX_EM_BUFF_SZ];
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    unsigned short  msg_type = em_msg_type_1905_ack;
+    size_t len = 0;
+    em_cmdu_t *cmdu;
+    em_tlv_t *tlv;
+    unsigned char *tmp = buff;
+    unsigned short type = htons(ETH_P_1905);
+    dm_easy_mesh_t *dm = get_data_model();
+
+    memcpy(tmp, dm->get_ctrl_al_interface_mac(), sizeof(mac_address_t));
+    tmp += sizeof(mac_address_t);
+    len += sizeof(mac_address_t);
+
+    memcpy(tmp, dm->get_agent_al_interface_mac(), sizeof(mac_address_t));
+    tmp += sizeof(mac_address_t);
+    len += sizeof(mac_address_t);
+
+    memcpy(tmp, reinterpret_cast<unsigned char *> (&type), sizeof(unsigned short));
+    tmp += sizeof(unsigned short);
+    len += sizeof(unsigned short);
+
+    cmdu = reinterpret_cast<em_cmdu_t *> (tmp);
+
+    memset(tmp, 0, sizeof(em_cmdu_t));
+    cmdu->type = htons(msg_type);
+    cmdu->id = htons(msg_id);
+    cmdu->last_frag_ind = 1;
+
+    tmp += sizeof(em_cmdu_t);
+    len += sizeof(em_cmdu_t);
+
+    // End of message
+    tlv = reinterpret_cast<em_tlv_t *> (tmp);
+    tlv->type = em_tlv_type_eom;
+    tlv->len = 0;
+
+    tmp += (sizeof(em_tlv_t));
+    len += (sizeof(em_tlv_t));
+
+    if (em_msg_t(em_msg_type_1905_ack, em_profile_type_3, buff, static_cast<unsigned int> (len)).validate(errors) == 0) {
+        printf("%s:%d: 1905 ACK validation failed\n", __func__, __LINE__);
+        return -1;
+    }
+
+    if (send_frame(buff, static_cast<unsigned int> (len))  < 0) {
+        printf("%s:%d: 1905 ACK send failed, error:%d\n", __func__, __LINE__, errno);
+        return -1;
+    }
+
+    return static_cast<int> (len);
+}
+
 int em_policy_cfg_t::handle_policy_cfg_req(unsigned char *buff, unsigned int len)
 {
     em_policy_cfg_params_t policy;
@@ -490,8 +612,12 @@ int em_policy_cfg_t::handle_policy_cfg_req(unsigned char *buff, unsigned int len
     size_t data_len = 0;
     unsigned int i = 0;
     mac_addr_str_t mac_str;
+    em_cmdu_t *cmdu = reinterpret_cast<em_cmdu_t *> (buff + sizeof(em_raw_hdr_t));
+
+    memset(&policy, 0, sizeof(em_policy_cfg_params_t));
 
-    memset(&policy, 0, sizeof(em_policy_cfg_t));
+    // the controller matches the ACKs of the agents to its requests, see em_policy_push_t
+    send_policy_cfg_ack(ntohs(cmdu->id));
 
     tlv = reinterpret_cast<em_tlv_t *> (buff + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
     tlv_len = len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
@@ -568,6 +694,8 @@ int em_policy_cfg_t::handle_policy_cfg_req(unsigned char *buff, unsigned int len
         } else if (tlv->type == em_tlv_type_unsucc_assoc_policy) {
         } else if (tlv->type == em_tlv_type_backhaul_bss_conf) {
         } else if (tlv->type == em_tlv_type_qos_mgmt_policy){
+        } else if (tlv->type == em_tlv_type_tid_to_link_map_policy) {
+            handle_tid_to_link_map_policy(tlv->value, htons(tlv->len));
         } else if (tlv->type == em_tlv_vendor_plolicy_cfg) {
             em_vendor_policy_t *vendor = reinterpret_cast<em_vendor_policy_t *> (tlv->value);
             snprintf(policy.vendor_policy.managed_client_marker, sizeof(em_string_t), "%s", vendor->managed_client_marker);
@@ -585,6 +713,43 @@ int em_policy_cfg_t::handle_policy_cfg_req(unsigned char *buff, unsigned int len
     return 0;
 }
 
+int em_policy_cfg_t::handle_tid_to_link_map_policy(unsigned char *buff, unsigned int len)
+{
+    em_tid_to_link_map_policy_t *policy = reinterpret_cast<em_tid_to_link_map_policy_t *> (buff);
+    em_tid_to_link_mapping_t *mapping;
+    dm_tid_to_link_t *t2lm = &get_data_model()->m_tid_to_link;
+    unsigned int i, tid, num_maps, off;
+
+    if (len < sizeof(em_tid_to_link_map_policy_t)) {
+        return -1;
+    }
+
+    // a policy replaces the mappings of the AP MLD
+    t2lm->m_tid_to_link_info.num_mapping = 0;
+    off = static_cast<unsigned int> (sizeof(em_tid_to_link_map_policy_t));
+    for (i = 0; i < policy->num_mapping; i++) {
+        mapping = reinterpret_cast<em_tid_to_link_mapping_t *> (buff + off);
+        if (off + offsetof(em_tid_to_link_mapping_t, tid_to_link_map) > len) {
+            return -1;
+        }
+        num_maps = 0;
+        for (tid = 0; tid < 8; tid++) {
+            if ((mapping->link_map_presence_ind & (1 << tid)) != 0) {
+                num_maps += (mapping->link_map_size == 1) ? 1:2;
+            }
+        }
+        if (off + offsetof(em_tid_to_link_mapping_t, tid_to_link_map) + num_maps > len) {
+            return -1;
+        }
+        // the data model keeps one map, the one of the first TID present
+        t2lm->set_mapping(policy->mld_mac_addr, mapping->sta_mld_mac_addr,
+            (num_maps != 0) ? mapping->tid_to_link_map[0]:0, mapping->default_link_mapping == 1);
+        off += static_cast<unsigned int> (offsetof(em_tid_to_link_mapping_t, tid_to_link_map) + num_maps);
+    }
+
+    return 0;
+}
+
 void em_policy_cfg_t::process_msg(unsigned char *data, unsigned int len)
 {
     em_cmdu_t *cmdu = reinterpret_cast<em_cmdu_t *> (data + sizeof(em_raw_hdr_t));
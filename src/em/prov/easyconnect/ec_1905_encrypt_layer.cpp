@@ -4,19 +4,50 @@
 #include "ec_crypto.h"
 #include "ec_util.h"
 
+#include <array>
+#include <chrono>
+#include <cstring>
+
+/**
+ * @brief Key of a peer in the key context table, the AL MAC packed in an integer
+ */
+static inline uint64_t peer_key(const uint8_t mac[ETH_ALEN])
+{
+    uint64_t key = 0;
+    memcpy(&key, mac, ETH_ALEN);
+    return key;
+}
+
+/**
+ * @brief AL MAC of a peer from its key in the key context table
+ */
+static inline void peer_mac(uint64_t key, uint8_t mac[ETH_ALEN])
+{
+    memcpy(mac, &key, ETH_ALEN);
+}
+
+static inline uint64_t now_ms()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
 ec_1905_encrypt_layer_t::ec_1905_encrypt_layer_t(std::string local_al_mac, 
                                                  send_dir_encap_dpp_func send_direct_encap_dpp_msg, 
                                                  send_1905_eapol_encap_func send_1905_eapol_encap_msg,
-                                                 handshake_completed_handler handshake_complete) : 
+                                                 handshake_completed_handler handshake_complete,
+                                                 defer_func defer) : 
                                                  m_send_dir_encap_dpp_msg(send_direct_encap_dpp_msg), 
                                                  m_send_1905_eapol_encap_msg(send_1905_eapol_encap_msg),
-                                                 m_handshake_complete(handshake_complete) {
+                                                 m_handshake_complete(handshake_complete),
+                                                 m_defer(defer) {
         
     m_al_mac_addr = util::macstr_to_vector(local_al_mac);
     if (m_al_mac_addr.empty()) {
         em_printfout("Invalid AL MAC address format: %s", local_al_mac.c_str());
         throw std::invalid_argument("Invalid AL MAC address format");
     }
+    m_key_table.set_al_mac(m_al_mac_addr.data());
 }
 
 bool ec_1905_encrypt_layer_t::handle_peer_disc_req_frame(ec_frame_t *frame, uint16_t len, uint8_t src_mac[ETH_ALEN])
@@ -162,11 +193,11 @@ bool ec_1905_encrypt_layer_t::handle_peer_disc_req_frame(ec_frame_t *frame, uint
         em_printfout("Successfully derived GTK for Agent '%s'", src_mac_str.c_str()); 
     }
     
-    if (m_1905_mac_key_mac.find(src_mac_str) != m_1905_mac_key_mac.end()) {
+    if (m_1905_mac_key_mac.find(peer_key(src_mac)) != m_1905_mac_key_mac.end()) {
         em_printfout("Key context for '%s' already exists, overwriting", src_mac_str.c_str());
     }
 
-    m_1905_mac_key_mac[src_mac_str] = ctx;
+    m_1905_mac_key_mac[peer_key(src_mac)] = ctx;
 
     /* EasyMesh 5.3.7.1
 
@@ -180,7 +211,26 @@ bool ec_1905_encrypt_layer_t::handle_peer_disc_req_frame(ec_frame_t *frame, uint
         return false;
     }
 
-    // Wait .5 seconds to make sure that the first EAPOL frame arrives after the discovery response
+    // Wait .5 seconds to make sure that the first EAPOL frame arrives after the discovery response,
+    // the em keeps processing frames meanwhile
+    if (m_defer) {
+        std::weak_ptr<bool> alive = m_alive;
+        std::array<uint8_t, ETH_ALEN> peer;
+        memcpy(peer.data(), src_mac, ETH_ALEN);
+        auto start_handshake = [this, alive, peer, src_mac_str]() {
+            if (alive.expired()) {
+                return;
+            }
+            std::array<uint8_t, ETH_ALEN> mac = peer;
+            if (!begin_1905_4way_handshake(mac.data(), false)) {
+                em_printfout("Failed to begin 1905 4-way handshake with Agent '%s'", src_mac_str.c_str());
+            }
+        };
+        if (m_defer(500, start_handshake)) {
+            return true;
+        }
+    }
+
     std::this_thread::sleep_for(std::chrono::milliseconds(500));
 
     if (!begin_1905_4way_handshake(src_mac, false)) {
@@ -292,11 +342,11 @@ bool ec_1905_encrypt_layer_t::handle_peer_disc_resp_frame(ec_frame_t *frame, uin
     memcpy(ctx.pmk, pmk.data(), pmk.size());
     memcpy(ctx.pmkid, pmkid.data(), pmkid.size());
     
-    if (m_1905_mac_key_mac.find(src_mac_str) != m_1905_mac_key_mac.end()) {
+    if (m_1905_mac_key_mac.find(peer_key(src_mac)) != m_1905_mac_key_mac.end()) {
         em_printfout("Key context for '%s' already exists, overwriting", src_mac_str.c_str());
     }
 
-    m_1905_mac_key_mac[src_mac_str] = ctx;
+    m_1905_mac_key_mac[peer_key(src_mac)] = ctx;
 
     return true;
 }
@@ -308,21 +358,19 @@ bool ec_1905_encrypt_layer_t::handle_eapol_frame(uint8_t *frame, uint16_t len, u
     }
     EM_ASSERT_NOT_NULL(src_mac, false, "Source MAC address is null in EAPOL frame");
 
-    std::string src_mac_str = util::mac_to_string(src_mac);
-
-    em_printfout("Handling EAPOL frame from '%s'", src_mac_str.c_str());
+    em_printfout("Handling EAPOL frame from '" MACSTRFMT "'", MAC2STR(src_mac));
 
-    bool key_ctx_exists = m_1905_mac_key_mac.find(src_mac_str) != m_1905_mac_key_mac.end();
-    if (!key_ctx_exists) {
+    auto key_ctx_it = m_1905_mac_key_mac.find(peer_key(src_mac));
+    if (key_ctx_it == m_1905_mac_key_mac.end()) {
         // We don't have an existing key context, this means that a key context was not created during the DPP Network Introduction
         // so we cannot continue with the 4-way handshake
-        em_printfout("No existing key context for '%s', PMK has not been established via DPP Network Introduction! Exiting...", src_mac_str.c_str());
+        em_printfout("No existing key context for '" MACSTRFMT "', PMK has not been established via DPP Network Introduction! Exiting...", MAC2STR(src_mac));
         return false;
     }
 
-    ec_1905_key_ctx& ctx = m_1905_mac_key_mac[src_mac_str];
+    ec_1905_key_ctx& ctx = key_ctx_it->second;
     if (memcmp(ctx.pmk, empty_nonce, SHA256_DIGEST_LENGTH) == 0) {
-        em_printfout("PMK for '%s' is empty, cannot handle EAPOL frame! DPP Network Introduction was not completed!", src_mac_str.c_str());
+        em_printfout("PMK for '" MACSTRFMT "' is empty, cannot handle EAPOL frame! DPP Network Introduction was not completed!", MAC2STR(src_mac));
         return false;
     }
 
@@ -335,16 +383,16 @@ bool ec_1905_encrypt_layer_t::handle_eapol_frame(uint8_t *frame, uint16_t len, u
         bool ret = false;
         if (ctx.sent_eapol_idx == 0) {
             // Empty context, recieved first frame of group key handshake
-            em_printfout("Received frame 1/2 of group key handshake from '%s'", src_mac_str.c_str());
+            em_printfout("Received frame 1/2 of group key handshake from '" MACSTRFMT "'", MAC2STR(src_mac));
             ret = handle_group_eapol_frame_1(ctx, frame, len, src_mac);
         } else if (ctx.sent_eapol_idx == 1) {
             // Existing context, already sent first frame of group key handshake
             // Assuming we just recieved the second frame of the group key handshake
-            em_printfout("Received frame 2/2 of group key handshake from '%s'", src_mac_str.c_str());
+            em_printfout("Received frame 2/2 of group key handshake from '" MACSTRFMT "'", MAC2STR(src_mac));
             ret = handle_group_eapol_frame_2(ctx, frame, len, src_mac);
         } else {
-            em_printfout("Received EAPOL frame with unexpected sent EAPOL index %d for group key handshake with '%s', ignoring", 
-                ctx.sent_eapol_idx, src_mac_str.c_str());
+            em_printfout("Received EAPOL frame with unexpected sent EAPOL index %d for group key handshake with '" MACSTRFMT "', ignoring", 
+                ctx.sent_eapol_idx, MAC2STR(src_mac));
         }
 
         return ret;
@@ -354,26 +402,26 @@ bool ec_1905_encrypt_layer_t::handle_eapol_frame(uint8_t *frame, uint16_t len, u
     bool ret = false;
     if (ctx.sent_eapol_idx == 0) {
         // Empty context, recieved first frame of the 4-way handshake
-        em_printfout("Received frame 1/4 of 4-way handshake from '%s'", src_mac_str.c_str());
+        em_printfout("Received frame 1/4 of 4-way handshake from '" MACSTRFMT "'", MAC2STR(src_mac));
         ret = handle_pw_eapol_frame_1(ctx, frame, len, src_mac);
     }  else if (ctx.sent_eapol_idx == 1) {
         // Existing context, already sent first frame of the 4-way handshake
         // Assuming we just recieved the second frame of the 4-way handshake
-        em_printfout("Received frame 2/4 of 4-way handshake from '%s'", src_mac_str.c_str());
+        em_printfout("Received frame 2/4 of 4-way handshake from '" MACSTRFMT "'", MAC2STR(src_mac));
         ret = handle_pw_eapol_frame_2(ctx, frame, len, src_mac);
     } else if (ctx.sent_eapol_idx == 2) {
         // Existing context, already sent second frame of the 4-way handshake
         // Assuming we just recieved the third frame of the 4-way handshake
-        em_printfout("Received frame 3/4 of 4-way handshake from '%s'", src_mac_str.c_str());
+        em_printfout("Received frame 3/4 of 4-way handshake from '" MACSTRFMT "'", MAC2STR(src_mac));
         ret = handle_pw_eapol_frame_3(ctx, frame, len, src_mac);
     } else if (ctx.sent_eapol_idx == 3) {
         // Existing context, already sent third frame of the 4-way handshake
         // Assuming we just recieved the fourth frame of the 4-way handshake
-        em_printfout("Received frame 4/4 of 4-way handshake from '%s'", src_mac_str.c_str());
+        em_printfout("Received frame 4/4 of 4-way handshake from '" MACSTRFMT "'", MAC2STR(src_mac));
         ret = handle_pw_eapol_frame_4(ctx, frame, len, src_mac);
     } else {
-        em_printfout("Received EAPOL frame with unexpected sent EAPOL index %d for 4-way handshake with '%s', ignoring", 
-                    ctx.sent_eapol_idx, src_mac_str.c_str());
+        em_printfout("Received EAPOL frame with unexpected sent EAPOL index %d for 4-way handshake with '" MACSTRFMT "', ignoring", 
+                    ctx.sent_eapol_idx, MAC2STR(src_mac));
     }
 
     return ret;
@@ -405,10 +453,10 @@ bool ec_1905_encrypt_layer_t::rekey_1905_layer_ptk(uint8_t dest_al_mac[ETH_ALEN]
     EM_ASSERT_NOT_NULL(dest_al_mac, false, "Destination AL MAC address is null.");
 
     std::string dest_mac_str = util::mac_to_string(dest_al_mac);
-    EM_ASSERT_MSG_FALSE(m_1905_mac_key_mac.find(dest_mac_str) != m_1905_mac_key_mac.end(), false, 
+    EM_ASSERT_MSG_FALSE(m_1905_mac_key_mac.find(peer_key(dest_al_mac)) != m_1905_mac_key_mac.end(), false, 
         "Cannot rekey 1905 layer PTK with '%s', key context does not exist", dest_mac_str.c_str());
 
-    ec_1905_key_ctx& ctx = m_1905_mac_key_mac[dest_mac_str];
+    ec_1905_key_ctx& ctx = m_1905_mac_key_mac[peer_key(dest_al_mac)];
 
     if (memcmp(ctx.pmk, empty_nonce, sizeof(ctx.pmk)) == 0) {
         em_printfout("Cannot rekey 1905 layer PTK with '%s', PMK is not set", dest_mac_str.c_str());
@@ -433,15 +481,17 @@ bool ec_1905_encrypt_layer_t::rekey_1905_layer_ptk()
     every Multi-AP device it is communicating with.
     */
 
-    for (auto& [mac_str, ctx] : m_1905_mac_key_mac) {
+    for (auto& [key, ctx] : m_1905_mac_key_mac) {
+        uint8_t mac[ETH_ALEN];
+        peer_mac(key, mac);
 
         if (memcmp(ctx.pmk, empty_nonce, sizeof(ctx.pmk)) == 0) {
-            em_printfout("Cannot rekey 1905 layer PTK with '%s', PMK is not set", mac_str.c_str());
+            em_printfout("Cannot rekey 1905 layer PTK with '" MACSTRFMT "', PMK is not set", MAC2STR(mac));
             return false;
         }
 
-        if (!begin_1905_4way_handshake(util::macstr_to_vector(mac_str).data(), true)) {
-            em_printfout("Failed to begin 1905 4-way handshake (REKEY) with Agent '%s'", mac_str.c_str());
+        if (!begin_1905_4way_handshake(mac, true)) {
+            em_printfout("Failed to begin 1905 4-way handshake (REKEY) with Agent '" MACSTRFMT "'", MAC2STR(mac));
             return false;
         }
     }
@@ -466,27 +516,130 @@ bool ec_1905_encrypt_layer_t::rekey_1905_layer_gtk()
     }
     m_gtk_rekey_counter++;
 
-    // Send GTK to all agents
-    for (auto& [mac_str, ctx] : m_1905_mac_key_mac) {
+    if (!m_gtk_rekey_pending.empty() || !m_gtk_rekey_inflight.empty()) {
+        // The handshakes still running carry the previous GTK, every peer starts over with the new one
+        em_printfout("Previous GTK rekey still has %zu peers outstanding, restarting it", get_gtk_rekey_outstanding());
+        m_gtk_rekey_pending.clear();
+        m_gtk_rekey_inflight.clear();
+    }
+
+    // Send GTK to all agents, EC_1905_GTK_REKEY_MAX_INFLIGHT at a time
+    for (const auto& entry : m_1905_mac_key_mac) {
+        m_gtk_rekey_pending.push_back(entry.first);
+    }
+    m_gtk_rekey_start_ms = now_ms();
+    m_gtk_rekey_done = 0;
+    m_gtk_rekey_failed = 0;
+    em_printfout("Rekeying GTK with %zu agents", m_gtk_rekey_pending.size());
 
-        // Build and send the first frame of the group key handshake
-        auto [eapol_frame, frame_len] = build_group_eapol_frame_1(ctx);
-        if (eapol_frame == nullptr || frame_len == 0) {
-            em_printfout("Failed to build EAPOL frame for group key handshake with Agent '%s'", mac_str.c_str());
-            return false;
+    pump_gtk_rekey();
+
+    return true;
+}
+
+void ec_1905_encrypt_layer_t::handle_gtk_rekey_timeout()
+{
+    if (m_gtk_rekey_inflight.empty()) {
+        return;
+    }
+
+    uint64_t now = now_ms();
+    for (auto it = m_gtk_rekey_inflight.begin(); it != m_gtk_rekey_inflight.end();) {
+        uint64_t key = it->first;
+        ec_1905_gtk_rekey_t& rekey = it->second;
+        ++it;
+
+        if (now - rekey.sent_ms < EC_1905_GTK_REKEY_TIMEOUT_MS) {
+            continue;
         }
-        std::vector<uint8_t> mac_vec = util::macstr_to_vector(mac_str);
-        if (!m_send_1905_eapol_encap_msg(eapol_frame, frame_len, mac_vec.data())) {
-            em_printfout("Failed to send EAPOL frame for group key handshake with Agent '%s'", mac_str.c_str());
-            free(eapol_frame);
-            return false;
+
+        uint8_t mac[ETH_ALEN];
+        peer_mac(key, mac);
+        auto ctx_it = m_1905_mac_key_mac.find(key);
+        if (rekey.retries >= EC_1905_GTK_REKEY_MAX_RETRIES || ctx_it == m_1905_mac_key_mac.end()) {
+            em_printfout("No answer to group key handshake with Agent '" MACSTRFMT "' after %u retries, giving up", MAC2STR(mac), rekey.retries);
+            finish_gtk_rekey(key, false);
+            continue;
         }
 
-        // Increment sent EAPOL index
-        ctx.sent_eapol_idx = 1; // We just sent the first frame of the group key handshake
-        em_printfout("Sent first EAPOL frame for group key handshake with Agent '%s'", mac_str.c_str());
+        rekey.retries++;
+        rekey.sent_ms = now;
+        em_printfout("Group key handshake with Agent '" MACSTRFMT "' timed out, retry %u", MAC2STR(mac), rekey.retries);
+        if (!send_gtk_rekey(mac, ctx_it->second)) {
+            finish_gtk_rekey(key, false);
+        }
     }
-    return false;
+
+    pump_gtk_rekey();
+}
+
+bool ec_1905_encrypt_layer_t::send_gtk_rekey(uint8_t mac[ETH_ALEN], ec_1905_key_ctx& ctx)
+{
+    // Build and send the first frame of the group key handshake
+    auto [eapol_frame, frame_len] = build_group_eapol_frame_1(ctx);
+    if (eapol_frame == nullptr || frame_len == 0) {
+        em_printfout("Failed to build EAPOL frame for group key handshake with Agent '" MACSTRFMT "'", MAC2STR(mac));
+        return false;
+    }
+    if (!m_send_1905_eapol_encap_msg(eapol_frame, frame_len, mac)) {
+        em_printfout("Failed to send EAPOL frame for group key handshake with Agent '" MACSTRFMT "'", MAC2STR(mac));
+        free(eapol_frame);
+        return false;
+    }
+    free(eapol_frame);
+
+    // Increment sent EAPOL index
+    ctx.sent_eapol_idx = 1; // We just sent the first frame of the group key handshake
+    em_printfout("Sent first EAPOL frame for group key handshake with Agent '" MACSTRFMT "'", MAC2STR(mac));
+    return true;
+}
+
+void ec_1905_encrypt_layer_t::pump_gtk_rekey()
+{
+    while (m_gtk_rekey_inflight.size() < EC_1905_GTK_REKEY_MAX_INFLIGHT && !m_gtk_rekey_pending.empty()) {
+        uint64_t key = m_gtk_rekey_pending.front();
+        m_gtk_rekey_pending.pop_front();
+
+        // The peer may have been dropped since the rekey started
+        auto ctx_it = m_1905_mac_key_mac.find(key);
+        if (ctx_it == m_1905_mac_key_mac.end()) {
+            continue;
+        }
+
+        uint8_t mac[ETH_ALEN];
+        peer_mac(key, mac);
+        uint64_t now = now_ms();
+        if (!send_gtk_rekey(mac, ctx_it->second)) {
+            m_gtk_rekey_failed++;
+            continue;
+        }
+        m_gtk_rekey_inflight[key] = {now, now, 0};
+    }
+
+    if (m_gtk_rekey_start_ms != 0 && m_gtk_rekey_pending.empty() && m_gtk_rekey_inflight.empty()) {
+        em_printfout("GTK rekey finished in %llu ms, %u agents rekeyed, %u failed",
+            static_cast<unsigned long long>(now_ms() - m_gtk_rekey_start_ms), m_gtk_rekey_done, m_gtk_rekey_failed);
+        m_gtk_rekey_start_ms = 0;
+    }
+}
+
+void ec_1905_encrypt_layer_t::finish_gtk_rekey(uint64_t key, bool ok)
+{
+    auto it = m_gtk_rekey_inflight.find(key);
+    if (it == m_gtk_rekey_inflight.end()) {
+        return;
+    }
+
+    if (ok) {
+        uint8_t mac[ETH_ALEN];
+        peer_mac(key, mac);
+        em_printfout("GTK rekey with Agent '" MACSTRFMT "' completed in %llu ms, %u retries", MAC2STR(mac),
+            static_cast<unsigned long long>(now_ms() - it->second.start_ms), it->second.retries);
+        m_gtk_rekey_done++;
+    } else {
+        m_gtk_rekey_failed++;
+    }
+    m_gtk_rekey_inflight.erase(it);
 }
 
 bool ec_1905_encrypt_layer_t::set_sec_params(SSL_KEY *c_sign_key, SSL_KEY* net_access_key, std::string connector_1905, const EVP_MD *hash_fn, std::vector<uint8_t> gmk)
@@ -560,10 +713,10 @@ bool ec_1905_encrypt_layer_t::begin_1905_4way_handshake(uint8_t dest_al_mac[ETH_
     EM_ASSERT_NOT_NULL(dest_al_mac, false, "Destination AL MAC address is null.");
 
     std::string dest_mac_str = util::mac_to_string(dest_al_mac);
-    EM_ASSERT_MSG_FALSE(m_1905_mac_key_mac.find(dest_mac_str) == m_1905_mac_key_mac.end(), false, 
+    EM_ASSERT_MSG_FALSE(m_1905_mac_key_mac.find(peer_key(dest_al_mac)) == m_1905_mac_key_mac.end(), false, 
         "Cannot start 1905 4-way handshake with '%s', key context does not exist", dest_mac_str.c_str());
 
-    ec_1905_key_ctx& ctx = m_1905_mac_key_mac[dest_mac_str];
+    ec_1905_key_ctx& ctx = m_1905_mac_key_mac[peer_key(dest_al_mac)];
     uint8_t empty[SHA256_DIGEST_LENGTH] = {0};
     EM_ASSERT_MSG_TRUE(memcmp(ctx.pmk, empty, sizeof(ctx.pmk)) != 0, false, 
         "Cannot start 1905 4-way handshake with '%s', PMK is not set", dest_mac_str.c_str());
@@ -812,16 +965,23 @@ std::pair<uint8_t *, size_t> ec_1905_encrypt_layer_t::alloc_eapol_frame(bool is_
     return {eapol_frame, eapol_frame_size};
 }
 
-std::pair<uint8_t *, size_t> ec_1905_encrypt_layer_t::encrypt_key_data(ec_1905_key_ctx &ctx, uint8_t* key_data_plain, size_t key_data_len)
+size_t ec_1905_encrypt_layer_t::encrypt_key_data(ec_1905_key_ctx &ctx, uint8_t* key_data_plain, size_t key_data_len, uint8_t *wrapped_key_data, size_t wrapped_size)
 {
+    EM_ASSERT_NOT_NULL(key_data_plain, 0, "Key Data is null");
+    EM_ASSERT_NOT_NULL(wrapped_key_data, 0, "Wrapped Key Data buffer is null");
 
     // Copy the Key Data to a new buffer to pad if necessary
     size_t new_key_data_len = key_data_len;
     size_t remaining_pad_bytes = 8 - (key_data_len % 8);
 
-    uint8_t* key_data_plain_copy = reinterpret_cast<uint8_t*>(calloc(new_key_data_len + remaining_pad_bytes, 1));
-    EM_ASSERT_NOT_NULL(key_data_plain_copy, {}, "Failed to allocate memory for Key Data padding");
+    uint8_t key_data_plain_copy[EC_1905_KEY_DATA_MAX_LEN];
+    EM_ASSERT_MSG_TRUE(new_key_data_len + remaining_pad_bytes <= sizeof(key_data_plain_copy), 0, 
+        "Key Data length %zu is too large to wrap", key_data_len);
+    // +8 for integrity check
+    EM_ASSERT_MSG_TRUE(new_key_data_len + remaining_pad_bytes + 8 <= wrapped_size, 0, 
+        "Wrapped Key Data buffer is too small for %zu bytes of Key Data", key_data_len);
 
+    memset(key_data_plain_copy, 0, new_key_data_len + remaining_pad_bytes);
     memcpy(key_data_plain_copy, key_data_plain, key_data_len); // Copy the original Key Data
 
 
@@ -841,45 +1001,41 @@ std::pair<uint8_t *, size_t> ec_1905_encrypt_layer_t::encrypt_key_data(ec_1905_k
     memset(empty_kek, 0, sizeof(empty_kek));
     if (memcmp(ctx.ptk_kek, empty_kek, sizeof(empty_kek)) == 0) {
         em_printfout("PTK KEK is null, cannot encrypt Key Data");
-        free(key_data_plain_copy);
-        return {};
+        return 0;
     }
 
-    uint8_t* wrapped_key_data = reinterpret_cast<uint8_t*>(calloc(new_key_data_len+8, 1)); // +8 for integrity check
     uint32_t wrapped_key_data_len = 0;
 
-    em_printfout("DEBUG: Calling aes_key_wrap with plain_len=%zu", new_key_data_len);
     if (!em_crypto_t::aes_key_wrap(ctx.ptk_kek, kek_bits / 8, key_data_plain_copy, static_cast<uint32_t>(new_key_data_len), wrapped_key_data, &wrapped_key_data_len)){
         em_printfout("Failed to encrypt Key Data using AES Key Wrap");
-        free(wrapped_key_data);
-        free(key_data_plain_copy);
-        return {};
+        OPENSSL_cleanse(key_data_plain_copy, sizeof(key_data_plain_copy));
+        return 0;
     }
-    em_printfout("DEBUG: aes_key_wrap returned wrapped_len=%u", wrapped_key_data_len);
-    free(key_data_plain_copy);
-    return {wrapped_key_data, wrapped_key_data_len};
+    OPENSSL_cleanse(key_data_plain_copy, sizeof(key_data_plain_copy));
+    return wrapped_key_data_len;
 }
 
-std::pair<uint8_t *, size_t> ec_1905_encrypt_layer_t::decrypt_key_data(ec_1905_key_ctx &ctx, uint8_t *wrapped_key_data, size_t key_data_len)
+size_t ec_1905_encrypt_layer_t::decrypt_key_data(ec_1905_key_ctx &ctx, uint8_t *wrapped_key_data, size_t key_data_len, uint8_t *unwrapped_key_data, size_t unwrapped_size)
 {
 
-    EM_ASSERT_NOT_NULL(wrapped_key_data, {}, "Wrapped Key Data is null");
-    EM_ASSERT_MSG_TRUE(key_data_len > 0, {}, "Wrapped Key Data length must be greater than 0");
+    EM_ASSERT_NOT_NULL(wrapped_key_data, 0, "Wrapped Key Data is null");
+    EM_ASSERT_NOT_NULL(unwrapped_key_data, 0, "Unwrapped Key Data buffer is null");
+    EM_ASSERT_MSG_TRUE(key_data_len > 0, 0, "Wrapped Key Data length must be greater than 0");
+    // aes_key_unwrap() works in place in the output buffer
+    EM_ASSERT_MSG_TRUE(key_data_len <= unwrapped_size, 0, "Unwrapped Key Data buffer is too small for %zu bytes", key_data_len);
 
     uint8_t empty_kek[sizeof(ctx.ptk_kek)];
     memset(empty_kek, 0, sizeof(empty_kek));
     if (memcmp(ctx.ptk_kek, empty_kek, sizeof(empty_kek)) == 0) {
         em_printfout("PTK KEK is null, cannot decrypt Key Data");
-        return {};
+        return 0;
     }
 
-    uint8_t* unwrapped_key_data = reinterpret_cast<uint8_t*>(calloc(key_data_len, 1));
     uint32_t unwrapped_len = 0;
 
     if (!em_crypto_t::aes_key_unwrap(ctx.ptk_kek, kek_bits / 8, wrapped_key_data, static_cast<uint32_t>(key_data_len), unwrapped_key_data, &unwrapped_len)){
         em_printfout("Failed to decrypt Key Data using AES Key Wrap");
-        free(unwrapped_key_data);
-        return {};
+        return 0;
     }
 
     // Remove (IEEE 802.11 12.7.2j) padding from back to front
@@ -898,79 +1054,70 @@ std::pair<uint8_t *, size_t> ec_1905_encrypt_layer_t::decrypt_key_data(ec_1905_k
         break;
     }
 
-    // Resize the unwrapped key data to the new (unpadded) length
-    unwrapped_key_data = reinterpret_cast<uint8_t*>(realloc(unwrapped_key_data, unwrapped_len));
-    EM_ASSERT_NOT_NULL(unwrapped_key_data, {}, "Failed to reallocate memory for unwrapped Key Data");
-
-    return {unwrapped_key_data, unwrapped_len};
+    return unwrapped_len;
 }
 
 bool ec_1905_encrypt_layer_t::verify_mic(ec_1905_key_ctx &ctx, uint8_t *eapol_frame, size_t eapol_frame_size)
 {
-    std::vector<uint8_t> mic = calculate_mic(ctx, eapol_frame, eapol_frame_size);
-    if (mic.empty()) {
+    uint8_t mic[SHA512_DIGEST_LENGTH];
+    size_t mic_len_bytes = mic_kck_bits / 8;
+
+    if (!calculate_mic(ctx, eapol_frame, eapol_frame_size, mic)) {
         em_printfout("Failed to calculate MIC for EAPOL frame");
         return false;
     }
     eapol_packet_t* eapol_packet = reinterpret_cast<eapol_packet_t*>(eapol_frame + sizeof(ieee802_1x_hdr_t));
-    if (memcmp(eapol_packet->mic_len_key, mic.data(), mic.size()) != 0) {
+    if (CRYPTO_memcmp(eapol_packet->mic_len_key, mic, mic_len_bytes) != 0) {
         em_printfout("MIC verification failed for EAPOL frame");
         em_printfout("Calculated MIC: ");
-        util::print_hex_dump(mic);
+        util::print_hex_dump(static_cast<unsigned int>(mic_len_bytes), mic);
         em_printfout("EAPOL frame MIC: ");
-        util::print_hex_dump(static_cast<unsigned int>(mic.size()), eapol_packet->mic_len_key);
+        util::print_hex_dump(static_cast<unsigned int>(mic_len_bytes), eapol_packet->mic_len_key);
         return false;
     }
 
     return true;
 }
 
-std::vector<uint8_t> ec_1905_encrypt_layer_t::calculate_mic(ec_1905_key_ctx &ctx, uint8_t* eapol_frame, size_t eapol_frame_size) {
-    EM_ASSERT_NOT_NULL(eapol_frame, {}, "EAPOL header is null");
-    EM_ASSERT_MSG_TRUE(eapol_frame_size >= sizeof(ieee802_1x_hdr_t) + sizeof(eapol_packet_t), {}, 
-        "EAPOL frame size is too small to contain EAPOL header and packet");
-    EM_ASSERT_NOT_NULL(m_hash_fn, {}, "Hash function is not set, cannot calculate MIC");
-    EM_ASSERT_MSG_TRUE(mic_kck_bits > 0, {}, "MIC KCK bits must be greater than 0 to calculate MIC");
-
+bool ec_1905_encrypt_layer_t::calculate_mic(ec_1905_key_ctx &ctx, uint8_t* eapol_frame, size_t eapol_frame_size, uint8_t *mic) {
+    EM_ASSERT_NOT_NULL(eapol_frame, false, "EAPOL header is null");
+    EM_ASSERT_NOT_NULL(mic, false, "MIC buffer is null");
+    EM_ASSERT_NOT_NULL(m_hash_fn, false, "Hash function is not set, cannot calculate MIC");
+    EM_ASSERT_MSG_TRUE(mic_kck_bits > 0, false, "MIC KCK bits must be greater than 0 to calculate MIC");
 
-    uint8_t* eapol_frame_copy = reinterpret_cast<uint8_t*>(malloc(eapol_frame_size));
-    EM_ASSERT_NOT_NULL(eapol_frame_copy, {}, "Failed to allocate memory for EAPOL frame copy");
-    memcpy(eapol_frame_copy, eapol_frame, eapol_frame_size);
+    // While they are the same value, they are used for different purposes 
+    // so we keep them separate
+    size_t mic_len_bytes = mic_kck_bits / 8; // MIC length in bytes
+    size_t mic_offset = sizeof(ieee802_1x_hdr_t) + offsetof(eapol_packet_t, mic_len_key);
+    EM_ASSERT_MSG_TRUE(eapol_frame_size >= sizeof(ieee802_1x_hdr_t) + sizeof(eapol_packet_t) + mic_len_bytes, false, 
+        "EAPOL frame size is too small to contain EAPOL header, packet and MIC");
 
-    eapol_packet_t* eapol_packet = reinterpret_cast<eapol_packet_t*>(eapol_frame_copy + sizeof(ieee802_1x_hdr_t));
+    eapol_packet_t* eapol_packet = reinterpret_cast<eapol_packet_t*>(eapol_frame + sizeof(ieee802_1x_hdr_t));
     if (eapol_packet->key_info.bits.key_mic == 0) {
         em_printfout("EAPOL frame does not have MIC set, not calculating MIC");
-        free(eapol_frame_copy);
-        return {};
+        return false;
     }
 
-    // While they are the same value, they are used for different purposes 
-    // so we keep them separate
-    size_t mic_len_bytes = mic_kck_bits / 8; // MIC length in bytes
-
-    // Set Key MIC field to 0 before calculating MIC
+    // The MIC is computed with the Key MIC field set to 0. Rather than copying the frame to clear it,
+    // the frame is hashed around the field with zeros in its place.
     // MIC is at the end of the EAPOL packet, before Key Len and Key Data
-    memset(eapol_packet->mic_len_key, 0, mic_len_bytes); 
-
-    // Calculate the MIC for the EAPOL frame
+    static const uint8_t zero_mic[SHA512_DIGEST_LENGTH] = {0};
 
     // Initialize temp MIC buffer to the max algorithm digest length since it will be truncated
     uint8_t temp_mic[SHA512_DIGEST_LENGTH];
     memset(temp_mic, 0, sizeof(temp_mic));
 
-    uint8_t *addr[1] = { reinterpret_cast<uint8_t*>(eapol_frame_copy) };
-    size_t len[1] = { eapol_frame_size };
+    uint8_t *addr[3] = { eapol_frame, const_cast<uint8_t*>(zero_mic), eapol_frame + mic_offset + mic_len_bytes };
+    size_t len[3] = { mic_offset, mic_len_bytes, eapol_frame_size - mic_offset - mic_len_bytes };
 
-    if (!em_crypto_t::platform_hmac_hash(m_hash_fn, ctx.ptk_kck, (mic_kck_bits / 8), 1, addr, len, temp_mic)) {
-        free(eapol_frame_copy);
+    if (!em_crypto_t::platform_hmac_hash(m_hash_fn, ctx.ptk_kck, (mic_kck_bits / 8), 3, addr, len, temp_mic)) {
         em_printfout("Failed to calculate MIC for EAPOL frame");
-        return {};
+        return false;
     }
 
-    std::vector<uint8_t> mic(temp_mic, temp_mic + mic_len_bytes); // Truncate to MIC length
-    free(eapol_frame_copy);
+    memcpy(mic, temp_mic, mic_len_bytes); // Truncate to MIC length
 
-    return mic;
+    return true;
 }
 
 std::pair<uint8_t*, size_t> ec_1905_encrypt_layer_t::build_pw_eapol_frame_1(ec_1905_key_ctx &ctx)
@@ -1068,14 +1215,14 @@ std::pair<uint8_t*, size_t> ec_1905_encrypt_layer_t::build_pw_eapol_frame_2(ec_1
     ieee802_1x_hdr_t* eapol_hdr = reinterpret_cast<ieee802_1x_hdr_t*>(eapol_frame);
     eapol_hdr->length = htons(static_cast<uint16_t>(eapol_frame_size - sizeof(ieee802_1x_hdr_t))); 
 
-    std::vector<uint8_t> mic = calculate_mic(ctx, eapol_frame, eapol_frame_size);
-    if (mic.empty()) {
+    uint8_t mic[SHA512_DIGEST_LENGTH];
+    if (!calculate_mic(ctx, eapol_frame, eapol_frame_size, mic)) {
         em_printfout("Failed to calculate MIC for EAPOL frame 2 in 4-way handshake with '%s'", util::mac_to_string(m_al_mac_addr.data()).c_str());
         free(eapol_frame);
         return {};
     }
     // Copy the MIC to the end of the EAPOL packet
-    memcpy(eapol_packet->mic_len_key, mic.data(), mic.size());
+    memcpy(eapol_packet->mic_len_key, mic, mic_kck_bits / 8);
 
     return {eapol_frame, eapol_frame_size};
 }
@@ -1133,7 +1280,7 @@ std::pair<uint8_t*, size_t> ec_1905_encrypt_layer_t::build_pw_eapol_frame_3(ec_1
         return {};
     }
 
-    uint8_t key_data_plain[256] = {0}; // Unencrypted key data buffer
+    uint8_t key_data_plain[EC_1905_KEY_DATA_MAX_LEN] = {0}; // Unencrypted key data buffer
     size_t key_data_len = 0;
 
     eapol_kde_t* kde = reinterpret_cast<eapol_kde_t*>(key_data_plain);
@@ -1152,8 +1299,10 @@ std::pair<uint8_t*, size_t> ec_1905_encrypt_layer_t::build_pw_eapol_frame_3(ec_1
 
 
     em_printfout("DEBUG: Encrypting key_data_len=%zu bytes for frame 3", key_data_len);
-    auto [wrapped_key_data, wrapped_key_data_len] = encrypt_key_data(ctx, key_data_plain, key_data_len);
-    if (wrapped_key_data == NULL || wrapped_key_data_len == 0) {
+    uint8_t wrapped_key_data[EC_1905_KEY_DATA_MAX_LEN + 8];
+    size_t wrapped_key_data_len = encrypt_key_data(ctx, key_data_plain, key_data_len, wrapped_key_data, sizeof(wrapped_key_data));
+    OPENSSL_cleanse(key_data_plain, sizeof(key_data_plain));
+    if (wrapped_key_data_len == 0) {
         em_printfout("Failed to encrypt Key Data for EAPOL frame 3 in 4-way handshake with '%s'", util::mac_to_string(m_al_mac_addr.data()).c_str());
         free(eapol_frame);
         return {};
@@ -1170,9 +1319,8 @@ std::pair<uint8_t*, size_t> ec_1905_encrypt_layer_t::build_pw_eapol_frame_3(ec_1
     eapol_hdr->length = htons(static_cast<uint16_t>(final_eapol_frame_size - sizeof(ieee802_1x_hdr_t))); 
 
     // Calculate the MIC for the EAPOL frame
-    std::vector<uint8_t> mic = calculate_mic(ctx, final_eapol_frame, final_eapol_frame_size);
-    EM_ASSERT_NOT_NULL_FREE(mic.data(), {}, final_eapol_frame, "Failed to calculate MIC for EAPOL frame 3 in 4-way handshake with '%s'", util::mac_to_string(m_al_mac_addr.data()).c_str());
-    if (mic.empty()) {
+    uint8_t mic[SHA512_DIGEST_LENGTH];
+    if (!calculate_mic(ctx, final_eapol_frame, final_eapol_frame_size, mic)) {
         em_printfout("Failed to calculate MIC for EAPOL frame 3 in 4-way handshake with '%s'", util::mac_to_string(m_al_mac_addr.data()).c_str());
         free(final_eapol_frame);
         return {};
@@ -1181,7 +1329,7 @@ std::pair<uint8_t*, size_t> ec_1905_encrypt_layer_t::build_pw_eapol_frame_3(ec_1
     eapol_packet = reinterpret_cast<eapol_packet_t*>(final_eapol_frame + sizeof(ieee802_1x_hdr_t));
 
     // Copy the MIC to the end of the EAPOL packet (before Key Len and Key Data)
-    memcpy(eapol_packet->mic_len_key, mic.data(), mic.size()); 
+    memcpy(eapol_packet->mic_len_key, mic, mic_kck_bits / 8); 
 
     return {final_eapol_frame, final_eapol_frame_size};
 }
@@ -1224,14 +1372,14 @@ std::pair<uint8_t*, size_t> ec_1905_encrypt_layer_t::build_pw_eapol_frame_4(ec_1
     ieee802_1x_hdr_t* eapol_hdr = reinterpret_cast<ieee802_1x_hdr_t*>(eapol_frame);
     eapol_hdr->length = htons(static_cast<uint16_t>(eapol_frame_size - sizeof(ieee802_1x_hdr_t))); 
 
-    std::vector<uint8_t> mic = calculate_mic(ctx, eapol_frame, eapol_frame_size);
-    if (mic.empty()) {
+    uint8_t mic[SHA512_DIGEST_LENGTH];
+    if (!calculate_mic(ctx, eapol_frame, eapol_frame_size, mic)) {
         em_printfout("Failed to calculate MIC for EAPOL frame 2 in 4-way handshake with '%s'", util::mac_to_string(m_al_mac_addr.data()).c_str());
         free(eapol_frame);
         return {};
     }
     // Copy the MIC to the end of the EAPOL packet
-    memcpy(eapol_packet->mic_len_key, mic.data(), mic.size());
+    memcpy(eapol_packet->mic_len_key, mic, mic_kck_bits / 8);
 
     return {eapol_frame, eapol_frame_size};
 }
@@ -1286,7 +1434,7 @@ std::pair<uint8_t *, size_t> ec_1905_encrypt_layer_t::build_group_eapol_frame_1(
         return {};
     }
 
-    uint8_t key_data_plain[256] = {0}; // Unencrypted key data buffer
+    uint8_t key_data_plain[EC_1905_KEY_DATA_MAX_LEN] = {0}; // Unencrypted key data buffer
     size_t key_data_len = 0;
 
     eapol_kde_t* kde = reinterpret_cast<eapol_kde_t*>(key_data_plain);
@@ -1303,7 +1451,14 @@ std::pair<uint8_t *, size_t> ec_1905_encrypt_layer_t::build_group_eapol_frame_1(
 
     key_data_len = sizeof(eapol_kde_t) + sizeof(gtk_1905_kde_t);
 
-    auto [wrapped_key_data, wrapped_key_data_len] = encrypt_key_data(ctx, key_data_plain, key_data_len);
+    uint8_t wrapped_key_data[EC_1905_KEY_DATA_MAX_LEN + 8];
+    size_t wrapped_key_data_len = encrypt_key_data(ctx, key_data_plain, key_data_len, wrapped_key_data, sizeof(wrapped_key_data));
+    OPENSSL_cleanse(key_data_plain, sizeof(key_data_plain));
+    if (wrapped_key_data_len == 0) {
+        em_printfout("Failed to encrypt Key Data for EAPOL frame 1 in group key handshake");
+        free(eapol_frame);
+        return {};
+    }
 
     // Add encrypted Key Data to the EAPOL frame
     auto [final_eapol_frame, final_eapol_frame_size] = append_key_data_buff(eapol_frame, eapol_frame_size, wrapped_key_data, wrapped_key_data_len, true);
@@ -1315,8 +1470,8 @@ std::pair<uint8_t *, size_t> ec_1905_encrypt_layer_t::build_group_eapol_frame_1(
     eapol_hdr->length = htons(static_cast<uint16_t>(final_eapol_frame_size - sizeof(ieee802_1x_hdr_t))); 
 
     // Calculate the MIC for the EAPOL frame
-    std::vector<uint8_t> mic = calculate_mic(ctx, final_eapol_frame, final_eapol_frame_size);
-    if (mic.empty()) {
+    uint8_t mic[SHA512_DIGEST_LENGTH];
+    if (!calculate_mic(ctx, final_eapol_frame, final_eapol_frame_size, mic)) {
         em_printfout("Failed to calculate MIC for EAPOL frame 3 in 4-way handshake with '%s'", util::mac_to_string(m_al_mac_addr.data()).c_str());
         free(final_eapol_frame);
         return {};
@@ -1325,7 +1480,7 @@ std::pair<uint8_t *, size_t> ec_1905_encrypt_layer_t::build_group_eapol_frame_1(
     eapol_packet = reinterpret_cast<eapol_packet_t*>(final_eapol_frame + sizeof(ieee802_1x_hdr_t));
 
     // Copy the MIC to the end of the EAPOL packet (before Key Len and Key Data)
-    memcpy(eapol_packet->mic_len_key, mic.data(), mic.size()); 
+    memcpy(eapol_packet->mic_len_key, mic, mic_kck_bits / 8); 
 
     return {final_eapol_frame, final_eapol_frame_size};
 }
@@ -1368,14 +1523,14 @@ std::pair<uint8_t *, size_t> ec_1905_encrypt_layer_t::build_group_eapol_frame_2(
     ieee802_1x_hdr_t* eapol_hdr = reinterpret_cast<ieee802_1x_hdr_t*>(eapol_frame);
     eapol_hdr->length = htons(static_cast<uint16_t>(eapol_frame_size - sizeof(ieee802_1x_hdr_t))); 
 
-    std::vector<uint8_t> mic = calculate_mic(ctx, eapol_frame, eapol_frame_size);
-    if (mic.empty()) {
+    uint8_t mic[SHA512_DIGEST_LENGTH];
+    if (!calculate_mic(ctx, eapol_frame, eapol_frame_size, mic)) {
         em_printfout("Failed to calculate MIC for EAPOL frame 2 in 4-way handshake with '%s'", util::mac_to_string(m_al_mac_addr.data()).c_str());
         free(eapol_frame);
         return {};
     }
     // Copy the MIC to the end of the EAPOL packet
-    memcpy(eapol_packet->mic_len_key, mic.data(), mic.size());
+    memcpy(eapol_packet->mic_len_key, mic, mic_kck_bits / 8);
 
     return {eapol_frame, eapol_frame_size};
 }
@@ -1603,14 +1758,15 @@ bool ec_1905_encrypt_layer_t::handle_pw_eapol_frame_3(ec_1905_key_ctx &ctx, uint
     uint8_t* wrapped_data = eapol_packet->mic_len_key + mic_len_bytes + sizeof(uint16_t); 
     
     // Validate wrapped_len is reasonable (GTK + KDE overhead should be < 256 bytes)
-    if (wrapped_len > 256) {
+    if (wrapped_len > EC_1905_KEY_DATA_MAX_LEN) {
         em_printfout("ERROR: Invalid wrapped_len=%u (0x%04X) in frame 3, rejecting packet from '" MACSTRFMT "'", 
                      wrapped_len, wrapped_len, MAC2STR(src_mac));
         return false;
     }
     
-    auto [unwrapped_key_data, unwrapped_key_data_len] = decrypt_key_data(ctx, wrapped_data, wrapped_len);
-    if (unwrapped_key_data == nullptr || unwrapped_key_data_len == 0) {
+    uint8_t unwrapped_key_data[EC_1905_KEY_DATA_MAX_LEN];
+    size_t unwrapped_key_data_len = decrypt_key_data(ctx, wrapped_data, wrapped_len, unwrapped_key_data, sizeof(unwrapped_key_data));
+    if (unwrapped_key_data_len == 0) {
         em_printfout("Failed to decrypt Key Data for EAPOL frame 3 in 4-way handshake with '" MACSTRFMT "'", MAC2STR(src_mac));
         return false;
     }
@@ -1772,14 +1928,15 @@ bool ec_1905_encrypt_layer_t::handle_group_eapol_frame_1(ec_1905_key_ctx &ctx, u
     uint8_t* wrapped_data = eapol_packet->mic_len_key + mic_len_bytes + sizeof(uint16_t); 
     
     // Validate wrapped_len is reasonable (GTK + KDE overhead should be < 256 bytes)
-    if (wrapped_len > 256) {
+    if (wrapped_len > EC_1905_KEY_DATA_MAX_LEN) {
         em_printfout("ERROR: Invalid wrapped_len=%u (0x%04X) in group frame 1, rejecting packet from '" MACSTRFMT "'", 
                      wrapped_len, wrapped_len, MAC2STR(src_mac));
         return false;
     }
 
-    auto [unwrapped_key_data, unwrapped_len] = decrypt_key_data(ctx, wrapped_data, wrapped_len);
-    if (unwrapped_key_data == nullptr || unwrapped_len == 0) {
+    uint8_t unwrapped_key_data[EC_1905_KEY_DATA_MAX_LEN];
+    size_t unwrapped_len = decrypt_key_data(ctx, wrapped_data, wrapped_len, unwrapped_key_data, sizeof(unwrapped_key_data));
+    if (unwrapped_len == 0) {
         em_printfout("Failed to decrypt key data in EAPOL frame 1 in group key handshake with '" MACSTRFMT "'", MAC2STR(src_mac));
         return false;
     }
@@ -1867,6 +2024,12 @@ bool ec_1905_encrypt_layer_t::handle_group_eapol_frame_2(ec_1905_key_ctx &ctx, u
 
     em_printfout("Group key handshake with '" MACSTRFMT "' completed successfully", MAC2STR(src_mac)); 
 
+    // Let a waiting peer of the GTK rekey take the freed place
+    if (m_gtk_rekey_inflight.find(peer_key(src_mac)) != m_gtk_rekey_inflight.end()) {
+        finish_gtk_rekey(peer_key(src_mac), true);
+        pump_gtk_rekey();
+    }
+
     // Notify that the group key handshake is complete
     m_handshake_complete(src_mac, true);
 
@@ -1985,5 +2148,16 @@ bool ec_1905_encrypt_layer_t::set_key(uint8_t *key, size_t key_len, uint16_t key
         em_printfout("Setting GTK with ID %u for MAC '" MACSTRFMT "'", key_id, MAC2STR(mac));
     }
     util::print_hex_dump(static_cast<unsigned int>(key_len), key);
+
+    if (is_pairwise) {
+        // the 1905 TK follows the KCK and KEK in the PTK
+        size_t tk_offset = static_cast<size_t>(mic_kck_bits + kek_bits) / 8;
+        if (key_len <= tk_offset ||
+            m_key_table.install_ptk(mac, key + tk_offset, static_cast<unsigned int>(key_len - tk_offset)) != 0) {
+            em_printfout("No 1905 TK in the PTK for MAC '" MACSTRFMT "', not installed", MAC2STR(mac));
+        }
+    } else if (m_key_table.install_gtk(mac, key, static_cast<unsigned int>(key_len), static_cast<uint8_t>(key_id), recv_seq_counter) != 0) {
+        em_printfout("GTK with ID %u for MAC '" MACSTRFMT "' not installed", key_id, MAC2STR(mac));
+    }
     return true;
 }
\ No newline at end of file
@@ -8,6 +8,7 @@ ec_configurator_t::ec_configurator_t(const std::string &al_mac_addr, ec_ops_t& o
 {
     m_send_chirp_notification    = ops.send_chirp;
     m_send_prox_encap_dpp_msg    = ops.send_encap_dpp;
+    m_send_prox_encap_dpp_frame  = ops.send_encap_dpp_frame;
     m_send_dir_encap_dpp_msg     = ops.send_dir_encap_dpp;
     m_send_action_frame          = ops.send_act_frame;
     m_get_backhaul_sta_info      = ops.get_backhaul_sta_info;
@@ -22,7 +23,8 @@ ec_configurator_t::ec_configurator_t(const std::string &al_mac_addr, ec_ops_t& o
         al_mac_addr, 
         ops.send_dir_encap_dpp, 
         ops.send_1905_eapol_encap,
-        handshake_complete);
+        handshake_complete,
+        ops.defer);
 
     if (!sec_ctx.C_signing_key || !sec_ctx.pp_key || !sec_ctx.net_access_key || !sec_ctx.connector) {
         em_printfout("Key(s) missing, cannot secure 1905 layer!");
@@ -31,6 +33,20 @@ ec_configurator_t::ec_configurator_t(const std::string &al_mac_addr, ec_ops_t& o
     m_sec_ctx = sec_ctx;
 }
 
+bool ec_configurator_t::send_prox_encap_dpp_frame(bool dpp_frame_indicator, uint8_t *dest_mac, ec_frame_type_t frame_type,
+                                                  uint8_t *frame, size_t frame_len, uint8_t dest_al_mac[ETH_ALEN])
+{
+    if (m_send_prox_encap_dpp_frame) {
+        return m_send_prox_encap_dpp_frame(dpp_frame_indicator, dest_mac, frame_type, frame, frame_len, dest_al_mac);
+    }
+
+    auto [encap_dpp_tlv, encap_dpp_tlv_len] = ec_util::create_encap_dpp_tlv(dpp_frame_indicator, dest_mac, frame_type, frame, frame_len);
+    ASSERT_NOT_NULL(encap_dpp_tlv, false, "%s:%d: Failed to create Encap DPP TLV\n", __func__, __LINE__);
+    bool sent = m_send_prox_encap_dpp_msg(encap_dpp_tlv, encap_dpp_tlv_len, nullptr, 0, dest_al_mac);
+    free(encap_dpp_tlv);
+    return sent;
+}
+
 void ec_configurator_t::handle_1905_handshake_completed(uint8_t peer_mac[ETH_ALEN], bool is_group) {
     em_printfout("1905 handshake completed with peer: " MACSTRFMT ", group key: %s", 
                  MAC2STR(peer_mac), is_group ? "true" : "false");
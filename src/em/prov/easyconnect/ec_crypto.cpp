@@ -5,6 +5,7 @@
 
 #include "cjson/cJSON.h"
 #include <numeric>
+#include <mutex>
 
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
 #include <openssl/kdf.h>
@@ -608,43 +609,36 @@ scoped_buff ec_crypto::encode_ec_point(ec_connection_context_t &c_ctx, const EC_
 
 scoped_buff ec_crypto::encode_ec_point(const EC_GROUP* group, const EC_POINT *point, const BIGNUM* prime, BN_CTX* bn_ctx)
 {
-    scoped_bn x(BN_new());
-    scoped_bn y(BN_new());
-
-    if (EC_POINT_get_affine_coordinates(group, point, x.get(), y.get(), bn_ctx) == 0) {
-        em_printfout("unable to get x, y of the curve");
+    if (bn_ctx == NULL && (bn_ctx = em_crypto_t::get_thread_bn_ctx()) == NULL) {
+        em_printfout("unable to get a BN_CTX");
         return nullptr;
     }
 
-    BIGNUM *prime_bn = const_cast<BIGNUM *>(prime);
-    bool is_prime_fetched = false;
-    if (prime_bn == NULL) {
-        prime_bn = BN_new();
-        if (EC_GROUP_get_curve(group, prime_bn, NULL, NULL, bn_ctx) == 0) {
-            em_printfout("unable to get prime of the curve");
-            BN_free(prime_bn);
-            return nullptr;
-        }
-        is_prime_fetched = true;
-    }
-
-    int prime_len = BN_num_bytes(prime_bn);
-    if (is_prime_fetched) {
-        BN_free(prime_bn);
-    }
+    // The DPP curves are prime curves, their coordinates are as long as the prime
+    int prime_len = (prime != NULL) ? BN_num_bytes(prime) : static_cast<int>((EC_GROUP_get_degree(group) + 7) / 8);
 
     uint8_t *key_buff = reinterpret_cast<uint8_t *>(calloc(static_cast<size_t>(2 * prime_len), 1));
     if (key_buff == NULL) {
         em_printfout("unable to allocate memory");
         return nullptr;
     }
-    
-    BN_bn2bin(const_cast<const BIGNUM *>(x.get()), &key_buff[prime_len - BN_num_bytes(x.get())]);
-    BN_bn2bin(const_cast<const BIGNUM *>(y.get()),
-              &key_buff[2 * prime_len - BN_num_bytes(y.get())]);
-
     scoped_buff key_buff_ptr(key_buff);
 
+    BN_CTX_start(bn_ctx);
+    BIGNUM *x = BN_CTX_get(bn_ctx);
+    BIGNUM *y = BN_CTX_get(bn_ctx);
+    bool did_succeed = (y != NULL) && (EC_POINT_get_affine_coordinates(group, point, x, y, bn_ctx) != 0);
+    if (!did_succeed) {
+        em_printfout("unable to get x, y of the curve");
+    } else {
+        BN_bn2binpad(x, key_buff, prime_len);
+        BN_bn2binpad(y, key_buff + prime_len, prime_len);
+    }
+    BN_CTX_end(bn_ctx);
+
+    if (!did_succeed) {
+        return nullptr;
+    }
     return key_buff_ptr;
 }
 
@@ -660,19 +654,19 @@ EC_POINT *ec_crypto::decode_ec_point(const EC_GROUP* group, const uint8_t *key_b
         return NULL;
     }
 
-    scoped_bn prime(BN_new());
-    EM_ASSERT_NOT_NULL(prime.get(), NULL, "Failed to create BIGNUM for prime");
-    if (EC_GROUP_get_curve(group, prime.get(), NULL, NULL, NULL) == 0) {
-        em_printfout("unable to get prime of the curve");
+    if (bn_ctx == NULL && (bn_ctx = em_crypto_t::get_thread_bn_ctx()) == NULL) {
+        em_printfout("unable to get a BN_CTX");
         return NULL;
     }
 
-    int prime_len = BN_num_bytes(prime.get());
-    BIGNUM *x = BN_bin2bn(key_buff, prime_len, NULL);
-    BIGNUM *y = BN_bin2bn(key_buff + prime_len, prime_len, NULL);
+    int prime_len = static_cast<int>((EC_GROUP_get_degree(group) + 7) / 8);
     EC_POINT *point = EC_POINT_new(group);
-    
-    if (x == NULL || y == NULL) {
+
+    BN_CTX_start(bn_ctx);
+    BIGNUM *x = BN_CTX_get(bn_ctx);
+    BIGNUM *y = BN_CTX_get(bn_ctx);
+
+    if (y == NULL || BN_bin2bn(key_buff, prime_len, x) == NULL || BN_bin2bn(key_buff + prime_len, prime_len, y) == NULL) {
         em_printfout("unable to convert buffer to BIGNUMs");
         goto err;
     }
@@ -693,14 +687,12 @@ EC_POINT *ec_crypto::decode_ec_point(const EC_GROUP* group, const uint8_t *key_b
         goto err;
     }
 
-    BN_free(x);
-    BN_free(y);
+    BN_CTX_end(bn_ctx);
     
     return point;
 
 err:
-    if (x) BN_free(x);
-    if (y) BN_free(y);
+    BN_CTX_end(bn_ctx);
     if (point) EC_POINT_free(point);
     return NULL;
 }
@@ -727,6 +719,91 @@ std::pair<const BIGNUM *, const EC_POINT *> ec_crypto::generate_proto_keypair(ec
     return std::pair<const BIGNUM*, const EC_POINT*>(proto_priv, proto_pub);
 }
 
+#define EC_CONNECTOR_CACHE_SZ   64      // connectors remembered as verified
+#define EC_CONNECTOR_CACHE_TTL  3600    // seconds a verification is remembered, capped by the connector expiry
+
+// Connectors whose signature verified, so that peer discovery and rekeys with the same
+// Connector skip the ECDSA verification. An entry is keyed by the hash of the C-sign-key
+// and of the whole Connector, so any change of either misses.
+struct ec_connector_cache_entry_t {
+    uint8_t id[SHA256_DIGEST_LENGTH];
+    time_t expiry;                      // 0 while the entry is free
+    uint64_t last_used;
+};
+
+static std::mutex s_connector_cache_lock;
+static ec_connector_cache_entry_t s_connector_cache[EC_CONNECTOR_CACHE_SZ];
+static uint64_t s_connector_cache_clock;
+
+static bool connector_cache_id(const std::string& connector, SSL_KEY *signing_key, uint8_t *id)
+{
+    uint8_t *kid = ec_crypto::compute_key_hash(signing_key);
+    if (kid == NULL) {
+        return false;
+    }
+
+    uint8_t *addr[2] = {kid, reinterpret_cast<uint8_t *>(const_cast<char *>(connector.data()))};
+    size_t len[2] = {SHA256_DIGEST_LENGTH, connector.length()};
+    uint8_t result = em_crypto_t::platform_SHA256(2, addr, len, id);
+    free(kid);
+
+    return result == 1;
+}
+
+static bool connector_cache_lookup(const uint8_t *id)
+{
+    std::lock_guard<std::mutex> lock(s_connector_cache_lock);
+    time_t now = time(NULL);
+
+    for (auto& entry : s_connector_cache) {
+        if ((entry.expiry == 0) || (memcmp(entry.id, id, SHA256_DIGEST_LENGTH) != 0)) {
+            continue;
+        }
+        if (entry.expiry <= now) {
+            entry.expiry = 0;
+            return false;
+        }
+        entry.last_used = ++s_connector_cache_clock;
+        return true;
+    }
+
+    return false;
+}
+
+static void connector_cache_insert(const uint8_t *id, const cJSON *jws_payload)
+{
+    time_t now = time(NULL);
+    time_t expiry = now + EC_CONNECTOR_CACHE_TTL;
+
+    cJSON *conn_expiry = cJSON_GetObjectItem(jws_payload, "expiry");
+    if (conn_expiry != NULL) {
+        struct tm tm = {};
+        if (!cJSON_IsString(conn_expiry) || strptime(conn_expiry->valuestring, "%Y-%m-%dT%H:%M:%S%z", &tm) == NULL) {
+            return;
+        }
+        time_t conn_expiry_time = mktime(&tm);
+        if (conn_expiry_time <= now) {
+            return;
+        }
+        expiry = std::min(expiry, conn_expiry_time);
+    }
+
+    std::lock_guard<std::mutex> lock(s_connector_cache_lock);
+    ec_connector_cache_entry_t *victim = &s_connector_cache[0];
+    for (auto& entry : s_connector_cache) {
+        if ((entry.expiry == 0) || (entry.expiry <= now)) {
+            victim = &entry;
+            break;
+        }
+        if (entry.last_used < victim->last_used) {
+            victim = &entry;
+        }
+    }
+    memcpy(victim->id, id, SHA256_DIGEST_LENGTH);
+    victim->expiry = expiry;
+    victim->last_used = ++s_connector_cache_clock;
+}
+
 std::optional<std::tuple<cJSON*, cJSON*, std::vector<uint8_t>>> ec_crypto::split_decode_connector(const char* conn, std::optional<SSL_KEY*> signing_key) {
     if (conn == NULL) {
         em_printfout("Connector is NULL");
@@ -750,13 +827,19 @@ std::optional<std::tuple<cJSON*, cJSON*, std::vector<uint8_t>>> ec_crypto::split
     // Remove signature from parts
     parts.pop_back();
 
+    uint8_t cache_id[SHA256_DIGEST_LENGTH];
+    bool cache_miss = false;
     if (signing_key.has_value()){
-        std::string signed_msg = parts[0] + "." + parts[1];
-        std::vector<uint8_t> signed_bytes(signed_msg.begin(), signed_msg.end());
-
-        if (!em_crypto_t::verify_signature(signed_bytes, *sig, *signing_key, EVP_sha256())) {
-            em_printfout("Signature verification of connector failed");
-            return std::nullopt;
+        bool has_id = connector_cache_id(connector, *signing_key, cache_id);
+        if (!has_id || !connector_cache_lookup(cache_id)) {
+            std::string signed_msg = parts[0] + "." + parts[1];
+            std::vector<uint8_t> signed_bytes(signed_msg.begin(), signed_msg.end());
+
+            if (!em_crypto_t::verify_signature(signed_bytes, *sig, *signing_key, EVP_sha256())) {
+                em_printfout("Signature verification of connector failed");
+                return std::nullopt;
+            }
+            cache_miss = has_id;
         }
     }
 
@@ -794,6 +877,9 @@ std::optional<std::tuple<cJSON*, cJSON*, std::vector<uint8_t>>> ec_crypto::split
         }
         return std::nullopt;
     }
+    if (cache_miss) {
+        connector_cache_insert(cache_id, decoded_parts[1]);
+    }
     return std::make_tuple(decoded_parts[0], decoded_parts[1], *sig);
 }
 
@@ -1007,7 +1093,7 @@ std::pair<EC_GROUP*, EC_POINT*> ec_crypto::decode_jwk(cJSON *json_web_key, BN_CT
     int nid = EC_curve_nist2nid(crv->valuestring);
     EM_ASSERT_MSG_TRUE(nid != NID_undef, {}, "Invalid curve name in JWK: %s", crv->valuestring);
 
-    scoped_ec_group curv_group(EC_GROUP_new_by_curve_name(nid));
+    scoped_ec_group curv_group(em_crypto_t::new_curve_group(nid));
     EM_ASSERT_NOT_NULL(curv_group.get(), {}, "Failed to create EC_GROUP from curve name: %s", crv->valuestring);
 
     std::optional<std::vector<uint8_t>> x_bytes = em_crypto_t::base64url_decode(x->valuestring);
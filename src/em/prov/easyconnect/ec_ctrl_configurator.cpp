@@ -7,6 +7,34 @@
 #include "cjson_util.h"
 #include "em_crypto.h"
 #include <netinet/in.h>
+#include <chrono>
+
+/**
+ * @brief Key of an Enrollee in the session table, its MAC packed in an integer
+ */
+static inline uint64_t session_key(const uint8_t mac[ETH_ALEN])
+{
+    uint64_t key = 0;
+    memcpy(&key, mac, ETH_ALEN);
+    return key;
+}
+
+static inline uint64_t now_ms()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static const char *session_phase_to_string(ec_session_phase_t phase)
+{
+    switch (phase) {
+        case ec_session_phase_auth: return "auth";
+        case ec_session_phase_config: return "config";
+        case ec_session_phase_result: return "result";
+        case ec_session_phase_conn_status: return "conn_status";
+        default: return "unknown";
+    }
+}
 
 ec_ctrl_configurator_t::ec_ctrl_configurator_t(const std::string& al_mac_addr, ec_ops_t& ops, ec_persistent_sec_ctx_t sec_ctx, handshake_completed_handler handshake_complete) :
                                                ec_configurator_t(al_mac_addr, ops, sec_ctx, false, handshake_complete)
@@ -120,6 +148,11 @@ bool ec_ctrl_configurator_t::process_chirp_notification(em_dpp_chirp_value_t *ch
         return false;
     }
 
+    if (!admit_chirp(mac)) {
+        free(hash);
+        return true;
+    }
+
     std::string mac_str = util::mac_to_string(mac);
     ec_connection_context_t* c_ctx = get_conn_ctx(mac_str);
     if (c_ctx == NULL) {
@@ -134,6 +167,7 @@ bool ec_ctrl_configurator_t::process_chirp_notification(em_dpp_chirp_value_t *ch
 
         // We now know that this bootstrapping data/connection context is for this MAC address
         ec_connection_context_t new_c_ctx;
+        memset(&new_c_ctx, 0, sizeof(ec_connection_context_t));
         memcpy(&new_c_ctx.boot_data, &c_ctx->boot_data, sizeof(ec_data_t));
         m_connections[mac_str] = new_c_ctx;
     }
@@ -141,24 +175,21 @@ bool ec_ctrl_configurator_t::process_chirp_notification(em_dpp_chirp_value_t *ch
     EM_ASSERT_NOT_NULL_FREE(c_ctx, false, hash, "No connection context found for Enrollee with matching MAC or hash. Has the DPP URI been given?\n");
 
     // Validate hash
-    // Compute the hash of the responder boot key 
-    uint8_t *resp_boot_key_chirp_hash = ec_crypto::compute_key_hash(c_ctx->boot_data.responder_boot_key, "chirp");
+    // The hash of the responder boot key is computed once per connection context
+    const uint8_t *resp_boot_key_chirp_hash = get_chirp_hash(c_ctx);
     ASSERT_NOT_NULL_FREE(resp_boot_key_chirp_hash, false, hash, "%s:%d: unable to compute \"chirp\" responder bootstrapping key hash\n", __func__, __LINE__);
 
-    if (memcmp(hash, resp_boot_key_chirp_hash, hash_len) != 0) {
+    if (hash_len > SHA256_DIGEST_LENGTH || memcmp(hash, resp_boot_key_chirp_hash, hash_len) != 0) {
         // Hashes don't match, don't initiate DPP authentication
         em_printfout("Chirp notification hash and DPP URI hash did not match! Stopping DPP!");
         em_printfout("Expected hash: ");
         util::print_hex_dump(hash_len, resp_boot_key_chirp_hash);
         printf("\n%s:%d: Received hash: \n", __func__, __LINE__);
         util::print_hex_dump(hash_len, hash);
-        free(resp_boot_key_chirp_hash);
         free(hash);
         return false;
     }
 
-    free(resp_boot_key_chirp_hash);
-
 
     auto [auth_frame, auth_frame_len] = create_auth_request(mac_str);
     if (auth_frame == NULL || auth_frame_len == 0) {
@@ -180,7 +211,9 @@ bool ec_ctrl_configurator_t::process_chirp_notification(em_dpp_chirp_value_t *ch
     free(hash);
 
     // Send the encapsulated DPP message (with Encap TLV and Chirp TLV)
-    this->m_send_prox_encap_dpp_msg(encap_dpp_tlv, encap_dpp_size, chirp, chirp_tlv_size, src_al_mac);
+    if (this->m_send_prox_encap_dpp_msg(encap_dpp_tlv, encap_dpp_size, chirp, chirp_tlv_size, src_al_mac)) {
+        begin_session(mac);
+    }
 
     free(encap_dpp_tlv);
     free(chirp);
@@ -336,6 +369,11 @@ bool ec_ctrl_configurator_t::handle_autoconf_chirp(em_dpp_chirp_value_t* chirp,
         em_printfout("Failed to parse DPP Chirp TLV from Autoconf Search (extended) message");
         return false;
     }
+
+    if (!admit_chirp(src_mac)) {
+        free(enrollee_hash);
+        return true;
+    }
     
     // Autoconfig Chirps are only done for Ethernet onboarding
 
@@ -393,6 +431,8 @@ bool ec_ctrl_configurator_t::handle_autoconf_chirp(em_dpp_chirp_value_t* chirp,
     bool sent = m_send_dir_encap_dpp_msg(frame, frame_len, src_mac);
     if (!sent) {
         em_printfout("Failed to send DPP Authentication Request frame to Enrollee '%s'", src_mac_str.c_str());
+    } else {
+        begin_session(src_mac);
     }
     em_printfout("Sent DPP Authentication Request frame to Enrollee '%s'", src_mac_str.c_str());
     free(frame);
@@ -448,8 +488,15 @@ bool ec_ctrl_configurator_t::handle_proxied_config_result_frame(uint8_t *encap_f
     ec_status_code_t dpp_status = static_cast<ec_status_code_t>(status_attr->data[0]);
     if (dpp_status == DPP_STATUS_OK) {
         conn_ctx->is_easyconnect_dpp_complete = true;
+        // Only a wireless Enrollee was asked for its Connection Status
+        if (conn_ctx->is_eth) {
+            end_session(src_mac, true);
+        } else {
+            advance_session(src_mac, ec_session_phase_conn_status);
+        }
     } else if (dpp_status == DPP_STATUS_CONFIG_REJECTED) {
         conn_ctx->is_easyconnect_dpp_complete = false;
+        end_session(src_mac, false);
     } else {
         em_printfout("Invalid DPP Status %d (%s)", static_cast<int>(dpp_status), ec_util::status_code_to_string(dpp_status).c_str());
         free(unwrapped_attrs);
@@ -509,6 +556,7 @@ bool ec_ctrl_configurator_t::handle_proxied_conn_status_result_frame(uint8_t *en
 
     cJSON_Delete(conn_status_obj);
     free(unwrapped_attrs);
+    end_session(src_mac, true);
     return true;
 }
 
@@ -601,15 +649,15 @@ bool ec_ctrl_configurator_t::handle_proxied_dpp_configuration_request(uint8_t *e
         auto [config_response_frame, config_response_frame_len] = create_config_response_frame(src_mac, src_al_mac, session_dialog_token, DPP_STATUS_CONFIGURATION_FAILURE);
         std::string status_code_str =  ec_util::status_code_to_string(DPP_STATUS_CONFIGURATION_FAILURE);
 
-        auto [encap_response_frame, encap_response_frame_len] = ec_util::create_encap_dpp_tlv(true, src_mac, ec_frame_type_easymesh, reinterpret_cast<uint8_t*>(config_response_frame), config_response_frame_len);
-        ASSERT_NOT_NULL(encap_response_frame, {}, "%s:%d: Failed to alloc DPP Configuration frame!\n", __func__, __LINE__);
+        ASSERT_NOT_NULL(config_response_frame, {}, "%s:%d: Failed to alloc DPP Configuration frame!\n", __func__, __LINE__);
 
         em_printfout("Sending DPP Configuration Response frame for Enrollee '" MACSTRFMT "' over 1905 with DPP status code %s", MAC2STR(src_mac), status_code_str.c_str());
-        bool sent = m_send_prox_encap_dpp_msg(encap_response_frame, encap_response_frame_len, nullptr, config_response_frame_len, src_al_mac);
+        bool sent = send_prox_encap_dpp_frame(true, src_mac, ec_frame_type_easymesh, reinterpret_cast<uint8_t*>(config_response_frame), config_response_frame_len, src_al_mac);
         if (!sent) {
             em_printfout("Failed to send DPP Configuration Response for Enrollee '" MACSTRFMT "'", MAC2STR(src_mac));
         }
         free(config_response_frame);
+        end_session(src_mac, false);
         return sent;
     }
 
@@ -687,12 +735,9 @@ bool ec_ctrl_configurator_t::handle_proxied_dpp_configuration_request(uint8_t *e
         return false;
     }
 
-    auto [encap_response_frame, encap_response_frame_len] = ec_util::create_encap_dpp_tlv(true, src_mac, ec_frame_type_easymesh, config_response_frame, config_response_frame_len);
-    ASSERT_NOT_NULL_FREE(encap_response_frame, {}, config_response_frame, "%s:%d: Failed to alloc DPP Configuration frame!\n", __func__, __LINE__);
-
     bool did_succeed = false;
     if (!conn_ctx->is_eth) {
-        did_succeed = m_send_prox_encap_dpp_msg(encap_response_frame, encap_response_frame_len, nullptr, 0, src_al_mac);
+        did_succeed = send_prox_encap_dpp_frame(true, src_mac, ec_frame_type_easymesh, config_response_frame, config_response_frame_len, src_al_mac);
         if (!did_succeed) {
             em_printfout("Failed to send Proxied Encap DPP message containing DPP Configuration frame to '" MACSTRFMT "'", MAC2STR(src_mac));
         }
@@ -704,7 +749,10 @@ bool ec_ctrl_configurator_t::handle_proxied_dpp_configuration_request(uint8_t *e
     }
 
     free(config_response_frame);
-    free(encap_response_frame);
+
+    if (did_succeed) {
+        advance_session(src_mac, ec_session_phase_result);
+    }
         
     return did_succeed;
 }
@@ -842,15 +890,12 @@ bool ec_ctrl_configurator_t::handle_auth_response(ec_frame_t *frame, size_t len,
         auto [resp_frame, resp_len] = create_auth_confirm(enrollee_mac, DPP_STATUS_NOT_COMPATIBLE, NULL);
         ASSERT_NOT_NULL(resp_frame, false, "%s:%d: Failed to create response frame\n", __func__, __LINE__);
 
-        auto [encap_dpp_tlv, encap_dpp_size] = ec_util::create_encap_dpp_tlv(0, src_mac, ec_frame_type_auth_cnf, resp_frame, resp_len);
-        free(resp_frame);
-        ASSERT_NOT_NULL(encap_dpp_tlv, false, "%s:%d: Failed to create Encap DPP TLV\n", __func__, __LINE__);
-
         // Send the encapsulated DPP message (with Encap TLV)
-        if (!this->m_send_prox_encap_dpp_msg(encap_dpp_tlv, encap_dpp_size, NULL, 0, src_al_mac)){
+        if (!send_prox_encap_dpp_frame(0, src_mac, ec_frame_type_auth_cnf, resp_frame, resp_len, src_al_mac)){
             em_printfout("Failed to send Encap DPP TLV");
         }
-        free(encap_dpp_tlv);
+        free(resp_frame);
+        end_session(src_mac, false);
 
         return false;
     }
@@ -972,16 +1017,13 @@ bool ec_ctrl_configurator_t::handle_auth_response(ec_frame_t *frame, size_t len,
         auto [resp_frame, resp_len] = create_auth_confirm(enrollee_mac, DPP_STATUS_AUTH_FAILURE, NULL);
         ASSERT_NOT_NULL(resp_frame, false, "%s:%d: Failed to create response frame\n", __func__, __LINE__);
 
-        auto [encap_dpp_tlv, encap_dpp_size] = ec_util::create_encap_dpp_tlv(0, src_mac, ec_frame_type_auth_cnf, resp_frame, resp_len);
-        free(resp_frame);
-        ASSERT_NOT_NULL(encap_dpp_tlv, false, "%s:%d: Failed to create Encap DPP TLV\n", __func__, __LINE__);
-
         // Send the encapsulated DPP message (with Encap TLV)
-        if (!this->m_send_prox_encap_dpp_msg(encap_dpp_tlv, encap_dpp_size, NULL, 0, src_al_mac)){
+        if (!send_prox_encap_dpp_frame(0, src_mac, ec_frame_type_auth_cnf, resp_frame, resp_len, src_al_mac)){
             em_printfout("Failed to send encapsulated DPP message");
         }
 
-        free(encap_dpp_tlv);
+        free(resp_frame);
+        end_session(src_mac, false);
         return false;
     }
 
@@ -1010,26 +1052,23 @@ bool ec_ctrl_configurator_t::handle_auth_response(ec_frame_t *frame, size_t len,
     free(i_auth);
     ASSERT_NOT_NULL(resp_frame, false, "%s:%d: Failed to create response frame\n", __func__, __LINE__);
 
-    auto [encap_dpp_tlv, encap_dpp_size] = ec_util::create_encap_dpp_tlv(0, src_mac, ec_frame_type_auth_cnf, resp_frame, resp_len);
-    free(resp_frame);
-    ASSERT_NOT_NULL(encap_dpp_tlv, false, "%s:%d: Failed to create Encap DPP TLV\n", __func__, __LINE__);
-
     if (!conn_ctx->is_eth) {
         // Send the encapsulated DPP message (with Encap TLV)
-        if (!this->m_send_prox_encap_dpp_msg(encap_dpp_tlv, encap_dpp_size, NULL, 0, src_al_mac)){
+        if (!send_prox_encap_dpp_frame(0, src_mac, ec_frame_type_auth_cnf, resp_frame, resp_len, src_al_mac)){
             em_printfout("Failed to send encapsulated DPP message");
-            free(encap_dpp_tlv);
+            free(resp_frame);
             return false;
         }
     } else {
         if (!m_send_dir_encap_dpp_msg(reinterpret_cast<uint8_t*>(resp_frame), resp_len, src_mac)) {
             em_printfout("Failed to send DPP Authentication Confirm frame via Direct Encap msg to Enrollee '" MACSTRFMT "'", MAC2STR(src_mac));
-            free(encap_dpp_tlv);
+            free(resp_frame);
             return false;
         }
     }
 
-    free(encap_dpp_tlv);
+    free(resp_frame);
+    advance_session(src_mac, ec_session_phase_config);
     return true;
 }
 
@@ -1102,11 +1141,7 @@ bool ec_ctrl_configurator_t::handle_recfg_announcement(ec_frame_t *encap_frame,
     auto [recfg_auth_req_frame, recfg_auth_req_frame_len] = create_recfg_auth_request(enrollee_mac, fc_nid);
     ASSERT_NOT_NULL(recfg_auth_req_frame, false, "%s:%d: Failed to create Reconfiguration Authentication Request frame\n", __func__, __LINE__);
 
-    auto [encap_dpp_tlv, encap_dpp_tlv_len] = ec_util::create_encap_dpp_tlv(0, sa, ec_frame_type_recfg_auth_req, recfg_auth_req_frame, recfg_auth_req_frame_len);
-    ASSERT_NOT_NULL_FREE(encap_dpp_tlv, false, recfg_auth_req_frame, "%s:%d: Failed to create Encap DPP TLV\n", __func__, __LINE__);
-
-    bool sent = m_send_prox_encap_dpp_msg(encap_dpp_tlv, encap_dpp_tlv_len, nullptr, 0, src_al_mac);
-    free(encap_dpp_tlv);
+    bool sent = send_prox_encap_dpp_frame(0, sa, ec_frame_type_recfg_auth_req, recfg_auth_req_frame, recfg_auth_req_frame_len, src_al_mac);
     free(recfg_auth_req_frame);
     if (sent) {
         m_currently_undergoing_recfg[enrollee_mac] = true;
@@ -1298,15 +1333,21 @@ std::pair<uint8_t *, size_t> ec_ctrl_configurator_t::create_auth_request(std::st
     auto e_ctx = get_eph_ctx(enrollee_mac);
     ASSERT_NOT_NULL(e_ctx, {}, "%s:%d: Ephemeral context not found for enrollee MAC %s\n", __func__, __LINE__, enrollee_mac.c_str());
 
-    ec_frame_t *frame =  ec_util::alloc_frame(ec_frame_type_auth_req);
-    ASSERT_NOT_NULL(frame, {}, "%s:%d failed to allocate memory for frame\n", __func__, __LINE__);
+    const uint16_t proto_key_len = static_cast<uint16_t>(2*BN_num_bytes(conn_ctx->prime));
+    const size_t wrapped_len = ec_util::get_ec_attr_size(static_cast<uint16_t>(conn_ctx->nonce_len)) + ec_util::get_ec_attr_size(sizeof(uint8_t));
+    const size_t frame_size = EC_FRAME_BASE_SIZE + 2 * ec_util::get_ec_attr_size(SHA256_DIGEST_LENGTH) +
+        ec_util::get_ec_attr_size(proto_key_len) + ec_util::get_ec_attr_size(sizeof(uint16_t)) + ec_attrib_writer_t::get_wrapped_size(wrapped_len);
+    // The frame is built in place, sized for the largest set of attributes
+    ec_attrib_writer_t writer(EC_FRAME_BASE_SIZE, frame_size, true);
+    ec_frame_t *frame = reinterpret_cast<ec_frame_t *>(writer.base());
+    ec_util::init_frame(frame);
+    frame->frame_type = ec_frame_type_auth_req;
 
     // Start EasyConnect 6.3.2
 
     // Generate initiator nonce
     if (RAND_bytes(e_ctx->i_nonce, conn_ctx->nonce_len) != 1) {
         em_printfout("Failed to generate i-nonce!");
-        free(frame);
         return {};
     }
 
@@ -1317,14 +1358,13 @@ std::pair<uint8_t *, size_t> ec_ctrl_configurator_t::create_auth_request(std::st
     auto [priv_init_proto_key, pub_init_proto_key] = ec_crypto::generate_proto_keypair(*conn_ctx);
     if (priv_init_proto_key == NULL || pub_init_proto_key == NULL) {
         em_printfout("failed to generate initiator protocol key pair");
-        free(frame);
         return {};
     }
     e_ctx->priv_init_proto_key = const_cast<BIGNUM*>(priv_init_proto_key);
     e_ctx->public_init_proto_key = const_cast<EC_POINT*>(pub_init_proto_key);
 
     // Compute the M.x
-    ASSERT_NOT_NULL_FREE(conn_ctx->boot_data.resp_pub_boot_key, {}, frame, "%s:%d failed to get responder bootstrapping public key\n", __func__, __LINE__);
+    ASSERT_NOT_NULL(conn_ctx->boot_data.resp_pub_boot_key, {}, "%s:%d failed to get responder bootstrapping public key\n", __func__, __LINE__);
 
     e_ctx->m = ec_crypto::compute_ec_ss_x(*conn_ctx, e_ctx->priv_init_proto_key, conn_ctx->boot_data.resp_pub_boot_key);
     const BIGNUM *bn_inputs[1] = { e_ctx->m };
@@ -1332,43 +1372,39 @@ std::pair<uint8_t *, size_t> ec_ctrl_configurator_t::create_auth_request(std::st
     e_ctx->k1 = static_cast<uint8_t *>(calloc(conn_ctx->digest_len, 1));
     if (ec_crypto::compute_hkdf_key(*conn_ctx, e_ctx->k1, conn_ctx->digest_len, "first intermediate key", bn_inputs, 1, NULL, 0) == 0) {
         em_printfout("Failed to compute k1");
-        free(frame);
         return {};
     }
 
     printf("Key K_1:\n");
     util::print_hex_dump(static_cast<unsigned int> (conn_ctx->digest_len), e_ctx->k1);
     
-    uint8_t* attribs = NULL;
-    size_t attribs_len = 0;
-
     // Responder Bootstrapping Key Hash: SHA-256(B_R)
     uint8_t* responder_keyhash = ec_crypto::compute_key_hash(conn_ctx->boot_data.responder_boot_key);
-    ASSERT_NOT_NULL_FREE2(responder_keyhash, {}, frame, attribs, "%s:%d failed to compute responder bootstrapping key hash\n", __func__, __LINE__);
+    ASSERT_NOT_NULL(responder_keyhash, {}, "%s:%d failed to compute responder bootstrapping key hash\n", __func__, __LINE__);
 
-    attribs = ec_util::add_attrib(attribs, &attribs_len, ec_attrib_id_resp_bootstrap_key_hash, SHA256_DIGEST_LENGTH, responder_keyhash);
+    writer.add_attrib(ec_attrib_id_resp_bootstrap_key_hash, SHA256_DIGEST_LENGTH, responder_keyhash);
     free(responder_keyhash);
 
     // Initiator Bootstrapping Key Hash: SHA-256(B_I)
     if (conn_ctx->boot_data.initiator_boot_key != NULL){
         // If != NULL, mutual authentication can be performed.
         uint8_t* initiator_keyhash = ec_crypto::compute_key_hash(conn_ctx->boot_data.initiator_boot_key);
-        ASSERT_NOT_NULL_FREE2(initiator_keyhash, {}, frame, attribs, "%s:%d failed to compute initiator bootstrapping key hash\n", __func__, __LINE__); 
+        ASSERT_NOT_NULL(initiator_keyhash, {}, "%s:%d failed to compute initiator bootstrapping key hash\n", __func__, __LINE__); 
     
-        attribs = ec_util::add_attrib(attribs, &attribs_len, ec_attrib_id_init_bootstrap_key_hash, SHA256_DIGEST_LENGTH, initiator_keyhash);
+        writer.add_attrib(ec_attrib_id_init_bootstrap_key_hash, SHA256_DIGEST_LENGTH, initiator_keyhash);
         free(initiator_keyhash);
     }
 
 
     // Public Initiator Protocol Key: P_I
     auto protocol_key_buff = ec_crypto::encode_ec_point(*conn_ctx, e_ctx->public_init_proto_key);
-    ASSERT_NOT_NULL_FREE2(protocol_key_buff, {}, frame, attribs, "%s:%d failed to encode public initiator protocol key\n", __func__, __LINE__);
+    ASSERT_NOT_NULL(protocol_key_buff, {}, "%s:%d failed to encode public initiator protocol key\n", __func__, __LINE__);
 
-    attribs = ec_util::add_attrib(attribs, &attribs_len, ec_attrib_id_init_proto_key, static_cast<uint16_t>(2*BN_num_bytes(conn_ctx->prime)), protocol_key_buff);
+    writer.add_attrib(ec_attrib_id_init_proto_key, proto_key_len, protocol_key_buff);
 
     // Protocol Version
     // if (m_cfgrtr_ver > 1) {
-    //     attribs = ec_util::add_attrib(attribs, &attribs_len, ec_attrib_id_proto_version, m_cfgrtr_ver);
+    //     writer.add_attrib(ec_attrib_id_proto_version, m_cfgrtr_ver);
     // }
 
     // Channel Attribute (optional)
@@ -1376,31 +1412,22 @@ std::pair<uint8_t *, size_t> ec_ctrl_configurator_t::create_auth_request(std::st
     if (conn_ctx->boot_data.ec_freqs[0] != 0){
         unsigned int base_freq = conn_ctx->boot_data.ec_freqs[0]; 
         uint16_t chann_attr = SWAP_LITTLE_ENDIAN(ec_util::freq_to_channel_attr(base_freq));
-        attribs = ec_util::add_attrib(attribs, &attribs_len, ec_attrib_id_channel, sizeof(uint16_t), reinterpret_cast<uint8_t*>(&chann_attr));
+        writer.add_attrib(ec_attrib_id_channel, chann_attr);
     }
 
 
     // Wrapped Data (with Initiator Nonce and Initiator Capabilities)
     // EasyMesh 8.2.2 Table 36
-    attribs = ec_util::add_wrapped_data_attr(frame, attribs, &attribs_len, true, e_ctx->k1, [&](){
-        uint8_t* wrap_attribs = NULL;
-        size_t wrapped_len = 0;
-        wrap_attribs = ec_util::add_attrib(wrap_attribs, &wrapped_len, ec_attrib_id_init_nonce, static_cast<uint16_t>(conn_ctx->nonce_len), e_ctx->i_nonce);
-        wrap_attribs = ec_util::add_attrib(wrap_attribs, &wrapped_len, ec_attrib_id_init_caps, m_dpp_caps.byte);
-        return std::make_pair(wrap_attribs, wrapped_len);
-    });
+    ec_attrib_writer_t wrap_attribs(0, wrapped_len);
+    wrap_attribs.add_attrib(ec_attrib_id_init_nonce, static_cast<uint16_t>(conn_ctx->nonce_len), e_ctx->i_nonce);
+    wrap_attribs.add_attrib(ec_attrib_id_init_caps, m_dpp_caps.byte);
+    writer.add_wrapped_data(true, e_ctx->k1, wrap_attribs);
 
-    // Add attributes to the frame
-    if (!(frame = ec_util::copy_attrs_to_frame(frame, attribs, attribs_len))) {
-        em_printfout("unable to copy attributes to frame");
-        free(frame);
-        free(attribs);
-        return {};
-    }
-
-    free(attribs);
+    size_t frame_len = 0;
+    uint8_t *buff = writer.release(&frame_len);
+    ASSERT_NOT_NULL(buff, {}, "%s:%d: Failed to build Authentication Request frame\n", __func__, __LINE__);
 
-    return std::make_pair(reinterpret_cast<uint8_t*>(frame), EC_FRAME_BASE_SIZE + attribs_len);
+    return std::make_pair(buff, frame_len);
 }
 
 std::pair<uint8_t *, size_t> ec_ctrl_configurator_t::create_auth_confirm(std::string enrollee_mac, ec_status_code_t dpp_status, uint8_t* i_auth_tag)
@@ -1692,33 +1719,23 @@ std::pair<uint8_t *, size_t> ec_ctrl_configurator_t::create_config_response_fram
     ASSERT_NOT_NULL(e_ctx, {}, "%s:%d: No ephemeral context found for Enrollee '" MACSTRFMT "'\n", __func__, __LINE__, MAC2STR(enrollee_mac.c_str()));
 
     if (dpp_status != DPP_STATUS_OK) {
-        auto [frame, frame_len] = ec_util::alloc_gas_frame(dpp_gas_action_type_t::dpp_gas_initial_resp, dialog_token);
-        if (frame == nullptr || frame_len == 0) {
-            em_printfout("Failed to create DPP Configuration Response frame!");
-            return {};
-        }
-        ec_gas_initial_response_frame_t *response_frame = reinterpret_cast<ec_gas_initial_response_frame_t *>(frame);
-
-        uint8_t *attribs = nullptr;
-        size_t attribs_len = 0;
+        const size_t base_size = ec_util::get_gas_frame_size(dpp_gas_action_type_t::dpp_gas_initial_resp);
+        const size_t wrapped_len = ec_util::get_ec_attr_size(conn_ctx->nonce_len);
+        ec_attrib_writer_t writer(base_size, base_size + ec_util::get_ec_attr_size(sizeof(uint8_t)) + ec_attrib_writer_t::get_wrapped_size(wrapped_len));
+        ec_util::init_gas_frame(writer.base(), dpp_gas_action_type_t::dpp_gas_initial_resp, dialog_token);
 
         // Configurator → Enrollee: DPP Status, { E-nonce }ke
-        attribs = ec_util::add_attrib(attribs, &attribs_len, ec_attrib_id_dpp_status, static_cast<uint8_t>(dpp_status));
-        attribs = ec_util::add_cfg_wrapped_data_attr(attribs, &attribs_len, true, e_ctx->ke, [&](){
-            size_t wrapped_len = 0;
-            uint8_t *wrapped_attribs = ec_util::add_attrib(nullptr, &wrapped_len, ec_attrib_id_enrollee_nonce, conn_ctx->nonce_len, e_ctx->e_nonce);
-            return std::make_pair(wrapped_attribs, wrapped_len);
-        });
-        if ((response_frame = ec_util::copy_attrs_to_frame(response_frame, attribs, attribs_len)) == nullptr) {
-            em_printfout("Failed to copy attribs to DPP Configuration Response frame!");
-            free(response_frame);
-            return {};
-        }
-        free(attribs);
+        writer.add_attrib(ec_attrib_id_dpp_status, static_cast<uint8_t>(dpp_status));
+        ec_attrib_writer_t wrap_attribs(0, wrapped_len);
+        wrap_attribs.add_attrib(ec_attrib_id_enrollee_nonce, conn_ctx->nonce_len, e_ctx->e_nonce);
+        writer.add_wrapped_data(true, e_ctx->ke, wrap_attribs);
+        reinterpret_cast<ec_gas_initial_response_frame_t *>(writer.base())->resp_len = static_cast<uint16_t>(writer.attribs_len());
 
-        response_frame->resp_len = static_cast<uint16_t>(attribs_len);
+        size_t frame_len = 0;
+        uint8_t *frame = writer.release(&frame_len);
+        ASSERT_NOT_NULL(frame, {}, "%s:%d: Failed to build DPP Configuration Response frame!\n", __func__, __LINE__);
 
-        return std::make_pair(reinterpret_cast<uint8_t *>(response_frame), sizeof(ec_gas_initial_response_frame_t) + attribs_len);
+        return std::make_pair(frame, frame_len);
     }
 
     // DPP_STATUS_OK case.
@@ -1776,39 +1793,35 @@ std::pair<uint8_t *, size_t> ec_ctrl_configurator_t::create_config_response_fram
 
 
     // Create DPP Configuration frame.
-    auto [frame, frame_len] = ec_util::alloc_gas_frame(dpp_gas_action_type_t::dpp_gas_initial_resp, dialog_token);
-    ASSERT_NOT_NULL(frame, {}, "%s:%d: Could not allocate DPP Configuration Response frame!\n", __func__, __LINE__);
-    ec_gas_initial_response_frame_t *response_frame = reinterpret_cast<ec_gas_initial_response_frame_t *>(frame);
-
-    uint8_t *attribs = nullptr;
-    size_t attribs_len = 0;
     // Configurator → Enrollee: DPP Status, { E-nonce, configurationPayload [, sendConnStatus]}ke
-    attribs = ec_util::add_attrib(attribs, &attribs_len, ec_attrib_id_dpp_status, static_cast<uint8_t>(DPP_STATUS_OK));
-    attribs = ec_util::add_cfg_wrapped_data_attr(attribs, &attribs_len, true, e_ctx->ke, [&]() {
-        size_t wrapped_len = 0;
-        uint8_t *wrapped_attribs = ec_util::add_attrib(nullptr, &wrapped_len, ec_attrib_id_enrollee_nonce, conn_ctx->nonce_len, e_ctx->e_nonce);
-        wrapped_attribs = ec_util::add_attrib(wrapped_attribs, &wrapped_len, ec_attrib_id_dpp_config_obj, ieee1905_config_obj_str);
-        if (!is_sta) {
-            wrapped_attribs = ec_util::add_attrib(wrapped_attribs, &wrapped_len, ec_attrib_id_dpp_config_obj, bsta_config_obj_str);
-        } else {
-            wrapped_attribs = ec_util::add_attrib(wrapped_attribs, &wrapped_len, ec_attrib_id_dpp_config_obj, fbss_config_obj_str);
-        }
-        if (!conn_ctx->is_eth) {
-            // EasyMesh 5.3.5:
-            // If the Multi-AP Controller onboards the Enrollee Multi-AP Agent over a Multi-AP
-            // Logical Ethernet Interface, the Multi-AP Controller shall not include a ‘sendConnStatus’ attribute in a DPP Configuration
-            // Response frame. 
-            wrapped_attribs = ec_util::add_attrib(wrapped_attribs, &wrapped_len, ec_attrib_id_send_conn_status, 0, NULL);
-        }
-        return std::make_pair(wrapped_attribs, wrapped_len);
-    });
+    const std::string& sta_config_obj_str = is_sta ? fbss_config_obj_str : bsta_config_obj_str;
+    const size_t wrapped_len = ec_util::get_ec_attr_size(conn_ctx->nonce_len) +
+        ec_util::get_ec_attr_size(static_cast<uint16_t>(ieee1905_config_obj_str.length())) +
+        ec_util::get_ec_attr_size(static_cast<uint16_t>(sta_config_obj_str.length())) + ec_util::get_ec_attr_size(0);
+    const size_t base_size = ec_util::get_gas_frame_size(dpp_gas_action_type_t::dpp_gas_initial_resp);
+    ec_attrib_writer_t writer(base_size, base_size + ec_util::get_ec_attr_size(sizeof(uint8_t)) + ec_attrib_writer_t::get_wrapped_size(wrapped_len));
+    ec_util::init_gas_frame(writer.base(), dpp_gas_action_type_t::dpp_gas_initial_resp, dialog_token);
+
+    writer.add_attrib(ec_attrib_id_dpp_status, static_cast<uint8_t>(DPP_STATUS_OK));
+    ec_attrib_writer_t wrap_attribs(0, wrapped_len);
+    wrap_attribs.add_attrib(ec_attrib_id_enrollee_nonce, conn_ctx->nonce_len, e_ctx->e_nonce);
+    wrap_attribs.add_attrib(ec_attrib_id_dpp_config_obj, ieee1905_config_obj_str);
+    wrap_attribs.add_attrib(ec_attrib_id_dpp_config_obj, sta_config_obj_str);
+    if (!conn_ctx->is_eth) {
+        // EasyMesh 5.3.5:
+        // If the Multi-AP Controller onboards the Enrollee Multi-AP Agent over a Multi-AP
+        // Logical Ethernet Interface, the Multi-AP Controller shall not include a ‘sendConnStatus’ attribute in a DPP Configuration
+        // Response frame. 
+        wrap_attribs.add_attrib(ec_attrib_id_send_conn_status, 0, NULL);
+    }
+    writer.add_wrapped_data(true, e_ctx->ke, wrap_attribs);
+    reinterpret_cast<ec_gas_initial_response_frame_t *>(writer.base())->resp_len = static_cast<uint16_t>(writer.attribs_len());
 
-    response_frame = ec_util::copy_attrs_to_frame(response_frame, attribs, attribs_len);
-    free(attribs);
-    ASSERT_NOT_NULL(response_frame, {}, "%s:%d: Failed to copy attributes to DPP Configuration frame!\n", __func__, __LINE__);
-    response_frame->resp_len = static_cast<uint16_t>(attribs_len);
+    size_t frame_len = 0;
+    uint8_t *frame = writer.release(&frame_len);
+    ASSERT_NOT_NULL(frame, {}, "%s:%d: Failed to build DPP Configuration frame!\n", __func__, __LINE__);
 
-    return std::make_pair(reinterpret_cast<uint8_t *>(response_frame), sizeof(ec_gas_initial_response_frame_t) + attribs_len);
+    return std::make_pair(frame, frame_len);
 }
 
 std::optional<std::pair<std::string, ec_connection_context_t *>> ec_ctrl_configurator_t::find_conn_ctx(uint8_t* enrollee_hash, uint8_t hash_len){
@@ -1825,28 +1838,162 @@ std::optional<std::pair<std::string, ec_connection_context_t *>> ec_ctrl_configu
         }
 
         // Compare hash.
-        uint8_t *hash = ec_crypto::compute_key_hash(conn_ctx.boot_data.responder_boot_key, "chirp");
+        const uint8_t *hash = get_chirp_hash(&conn_ctx);
         if (!hash) {
             em_printfout("Failed to compute hash of responder bootstrap public key for Enrollee '%s'", mac.c_str());
             continue;
         }
-        em_printfout("Computed hash of responder bootstrap public key for Enrollee '%s': ", mac.c_str());
-        util::print_hex_dump(hash_len, hash);
-        em_printfout("Received hash from Autoconf Search (extended) chirp: ");
-        util::print_hex_dump(hash_len, enrollee_hash);
-        if (memcmp(hash, enrollee_hash, hash_len) == 0) {
+        if (hash_len <= SHA256_DIGEST_LENGTH && memcmp(hash, enrollee_hash, hash_len) == 0) {
             // We found the Enrollee
             em_printfout("Found Enrollee '%s' with matching hash", mac.c_str());
             e_conn_ctx  = &conn_ctx;
             enroleee_phy_mac = mac;
-            free(hash);
             break;
         }
-        free(hash);
     }
 
     EM_ASSERT_NOT_NULL(e_conn_ctx, {}, "No connection context found for Enrollee with given hash");
     EM_ASSERT_MSG_TRUE(!enroleee_phy_mac.empty(), {}, "No Enrollee MAC found for Enrollee with given hash");
 
     return {{enroleee_phy_mac, e_conn_ctx}};
-}
\ No newline at end of file
+}
+
+bool ec_ctrl_configurator_t::admit_chirp(const uint8_t enrollee_mac[ETH_ALEN])
+{
+    uint64_t now = now_ms();
+
+    // The Enrollee keeps chirping until it gets an Authentication Request, a chirp sent before ours reached it is not a new session
+    auto it = m_sessions.find(session_key(enrollee_mac));
+    if (it != m_sessions.end() && now - it->second.phase_start_ms < EC_CTRL_CHIRP_HOLDOFF_MS) {
+        m_session_stats.chirps_dropped++;
+        return false;
+    }
+
+    if (m_chirp_refill_ms != 0) {
+        m_chirp_tokens += static_cast<double>(now - m_chirp_refill_ms) * EC_CTRL_CHIRP_RATE_PER_SEC / 1000.0;
+        if (m_chirp_tokens > EC_CTRL_CHIRP_BURST) {
+            m_chirp_tokens = EC_CTRL_CHIRP_BURST;
+        }
+    }
+    m_chirp_refill_ms = now;
+
+    if (m_chirp_tokens < 1.0) {
+        // The Enrollee chirps again, it is handled once the burst has drained
+        m_session_stats.chirps_dropped++;
+        em_printfout("Dropping chirp from '" MACSTRFMT "', %u sessions active", MAC2STR(enrollee_mac), m_session_stats.active);
+        return false;
+    }
+    m_chirp_tokens -= 1.0;
+
+    return true;
+}
+
+void ec_ctrl_configurator_t::begin_session(const uint8_t enrollee_mac[ETH_ALEN])
+{
+    uint64_t now = now_ms();
+    auto [it, inserted] = m_sessions.try_emplace(session_key(enrollee_mac));
+    ec_ctrl_session_t& session = it->second;
+
+    if (inserted) {
+        m_session_stats.active++;
+        m_session_stats.started++;
+        if (m_session_stats.active > m_session_stats.peak_active) {
+            m_session_stats.peak_active = m_session_stats.active;
+        }
+    }
+
+    // A new Authentication Request restarts the session of an Enrollee that chirped again
+    session.mac = util::mac_to_string(enrollee_mac);
+    session.phase = ec_session_phase_auth;
+    session.start_ms = now;
+    session.phase_start_ms = now;
+    memset(session.phase_ms, 0, sizeof(session.phase_ms));
+}
+
+void ec_ctrl_configurator_t::advance_session(const uint8_t enrollee_mac[ETH_ALEN], ec_session_phase_t phase)
+{
+    auto it = m_sessions.find(session_key(enrollee_mac));
+    if (it == m_sessions.end()) {
+        return;
+    }
+
+    uint64_t now = now_ms();
+    ec_ctrl_session_t& session = it->second;
+    session.phase_ms[session.phase] += now - session.phase_start_ms;
+    session.phase = phase;
+    session.phase_start_ms = now;
+}
+
+void ec_ctrl_configurator_t::end_session(const uint8_t enrollee_mac[ETH_ALEN], bool success)
+{
+    auto it = m_sessions.find(session_key(enrollee_mac));
+    if (it == m_sessions.end()) {
+        return;
+    }
+
+    uint64_t now = now_ms();
+    ec_ctrl_session_t& session = it->second;
+    session.phase_ms[session.phase] += now - session.phase_start_ms;
+
+    for (int i = 0; i <= session.phase; i++) {
+        m_session_stats.phase_count[i]++;
+        m_session_stats.phase_total_ms[i] += session.phase_ms[i];
+        if (session.phase_ms[i] > m_session_stats.phase_max_ms[i]) {
+            m_session_stats.phase_max_ms[i] = session.phase_ms[i];
+        }
+    }
+
+    em_printfout("DPP session of '%s' %s after %llums (auth %llums, config %llums, result %llums, conn_status %llums), %u still active",
+        session.mac.c_str(), success ? "completed" : (std::string("failed in phase ") + session_phase_to_string(session.phase)).c_str(),
+        static_cast<unsigned long long>(now - session.start_ms),
+        static_cast<unsigned long long>(session.phase_ms[ec_session_phase_auth]),
+        static_cast<unsigned long long>(session.phase_ms[ec_session_phase_config]),
+        static_cast<unsigned long long>(session.phase_ms[ec_session_phase_result]),
+        static_cast<unsigned long long>(session.phase_ms[ec_session_phase_conn_status]),
+        m_session_stats.active - 1);
+
+    if (success) {
+        m_session_stats.completed++;
+    } else {
+        m_session_stats.failed++;
+    }
+    m_session_stats.active--;
+    m_sessions.erase(it);
+}
+
+void ec_ctrl_configurator_t::handle_session_timeout()
+{
+    uint64_t now = now_ms();
+
+    for (auto it = m_sessions.begin(); it != m_sessions.end();) {
+        ec_ctrl_session_t& session = it->second;
+        if (now - session.phase_start_ms < EC_CTRL_SESSION_PHASE_TIMEOUT_MS) {
+            ++it;
+            continue;
+        }
+
+        // The connection context is kept, the Enrollee chirps again and gets a new Authentication Request
+        em_printfout("DPP session of '%s' timed out after %llums in phase '%s'", session.mac.c_str(),
+            static_cast<unsigned long long>(now - session.phase_start_ms), session_phase_to_string(session.phase));
+        m_session_stats.timed_out++;
+        m_session_stats.active--;
+        it = m_sessions.erase(it);
+    }
+}
+
+const uint8_t *ec_ctrl_configurator_t::get_chirp_hash(ec_connection_context_t *conn_ctx)
+{
+    if (conn_ctx->has_chirp_hash) {
+        return conn_ctx->chirp_hash;
+    }
+
+    uint8_t *hash = ec_crypto::compute_key_hash(conn_ctx->boot_data.responder_boot_key, "chirp");
+    if (hash == NULL) {
+        return NULL;
+    }
+    memcpy(conn_ctx->chirp_hash, hash, SHA256_DIGEST_LENGTH);
+    conn_ctx->has_chirp_hash = true;
+    free(hash);
+
+    return conn_ctx->chirp_hash;
+}
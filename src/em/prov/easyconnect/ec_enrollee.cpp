@@ -6,6 +6,14 @@
 #include "cjson/cJSON.h"
 #include "cjson_util.h"
 #include <unistd.h>
+#include <algorithm>
+#include <chrono>
+
+static inline uint64_t now_ms()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
 
 ec_enrollee_t::ec_enrollee_t(const std::string& al_mac_addr, ec_ops_t& ops, std::optional<ec_persistent_sec_ctx_t> existing_sec_ctx)
     : m_al_mac_addr(al_mac_addr) {
@@ -23,7 +31,8 @@ ec_enrollee_t::ec_enrollee_t(const std::string& al_mac_addr, ec_ops_t& ops, std:
         ops.send_dir_encap_dpp, 
         ops.send_1905_eapol_encap,
         std::bind(&ec_enrollee_t::handle_1905_handshake_completed, 
-                  this, std::placeholders::_1, std::placeholders::_2));
+                  this, std::placeholders::_1, std::placeholders::_2),
+        ops.defer);
 
     // Import existing security context
     if (existing_sec_ctx.has_value()) {
@@ -130,9 +139,11 @@ void ec_enrollee_t::generate_bss_channel_list(bool is_reconfig_list){
 
     auto& freq_list = is_reconfig_list ? m_recnf_announcement_freqs : m_pres_announcement_freqs; 
 
+    std::unique_lock<std::mutex> lock(m_announce_mtx);
 
-    // Clear existing channel list
+    // Clear existing channel list, the scan below tells again where the CCE IEs are heard
     freq_list.erase(freq_list.begin(), freq_list.end());
+    m_announce_chans.clear();
     
     // This step is not present in EC-Reconfig for some reason (likely because of the SSID check)
     if (!is_reconfig_list) {
@@ -167,6 +178,7 @@ void ec_enrollee_t::generate_bss_channel_list(bool is_reconfig_list){
     freq_list.insert(5220); // 5 GHz: Channel 44 (5.220 GHz)
     freq_list.insert(60480); // 60 GHz: Channel 2 (60.48 GHz)
     freq_list.insert(920); // 920 MHz: Channel 37 
+    lock.unlock();
 
     /* EC-Reconfig #2
 
@@ -206,7 +218,10 @@ void ec_enrollee_t::generate_bss_channel_list(bool is_reconfig_list){
 void ec_enrollee_t::send_presence_announcement_frames()
 {
     uint32_t attempts = 0;
-    uint32_t dwell = 2000;
+    uint32_t dwell = EC_PRES_ANNOUNCE_DWELL_MS;
+
+    m_time_to_first_auth_req_ms.store(-1);
+    m_pres_announce_start_ms.store(now_ms());
 
     auto [frame, frame_len] = create_presence_announcement();
     if (frame == nullptr || frame_len == 0) {
@@ -223,7 +238,7 @@ void ec_enrollee_t::send_presence_announcement_frames()
             // to resuming the presence announcement procedure, however, it shall generate a new channel list using the steps
             // specified in Section 6.2.2.
             attempts = 0;
-            dwell = 2000;
+            dwell = EC_PRES_ANNOUNCE_DWELL_MS;
 
             if (!ec_util::interruptible_sleep(std::chrono::seconds(5), [this]() -> bool {
                 return m_received_auth_frame.load();
@@ -234,9 +249,10 @@ void ec_enrollee_t::send_presence_announcement_frames()
             // Generate new channel list
             generate_bss_channel_list(false);
         }
-        // m_pres_announcement_freqs may be modified by a different thread
-        // iterate a local copy for thread safety
-        std::vector<uint32_t> freqs(m_pres_announcement_freqs.begin(), m_pres_announcement_freqs.end());
+        // m_pres_announcement_freqs may be modified by a different thread, the schedule is a local copy
+        // with the channels where a Configurator is most likely to hear us first
+        std::vector<uint32_t> freqs = get_announcement_schedule(false);
+        bool cce_heard = !freqs.empty() && is_cce_channel(freqs.front());
 
         for (const auto& freq : freqs) {
             // EasyConnect 6.2.3
@@ -245,14 +261,17 @@ void ec_enrollee_t::send_presence_announcement_frames()
             // Authentication Request frame is not received, it shall repeat the presence announcement for the next channel in
             // the channel list.
 
+            // The increased wait of the repeated sweeps is only spent where a CCE IE was heard, if any was
+            uint32_t chan_dwell = (!cce_heard || is_cce_channel(freq)) ? dwell : EC_PRES_ANNOUNCE_DWELL_MS;
+
             // Send frame
-            if (!m_send_action_frame(const_cast<uint8_t *>(BROADCAST_MAC_ADDR), frame, frame_len, freq, dwell)) {
+            if (!m_send_action_frame(const_cast<uint8_t *>(BROADCAST_MAC_ADDR), frame, frame_len, freq, chan_dwell)) {
                 em_printfout("Failed to send DPP Presence Announcement frame (broadcast) on freq %d", freq);
             }
 
 
-            // Wait `dwell` before moving to next channel.
-            if (!ec_util::interruptible_sleep(std::chrono::milliseconds(dwell), [this]() -> bool {
+            // Wait `chan_dwell` before moving to next channel.
+            if (!ec_util::interruptible_sleep(std::chrono::milliseconds(chan_dwell), [this]() -> bool {
                 return m_received_auth_frame.load();
             })) {
                 break;
@@ -304,8 +323,8 @@ void ec_enrollee_t::send_reconfiguration_announcement_frames()
             generate_bss_channel_list(true);
         }
 
-        // thread-safe copy
-        std::vector<uint32_t> freqs(m_recnf_announcement_freqs.begin(), m_recnf_announcement_freqs.end());
+        // thread-safe copy, with the channels where a Configurator is most likely to hear us first
+        std::vector<uint32_t> freqs = get_announcement_schedule(true);
         for (const auto& freq : freqs) {
             // EasyConnect 6.5.2
             // the Enrollee selects a channel from the channel list,
@@ -331,6 +350,42 @@ void ec_enrollee_t::send_reconfiguration_announcement_frames()
     free(frame);
 }
 
+std::vector<uint32_t> ec_enrollee_t::get_announcement_schedule(bool is_reconfig_list)
+{
+    std::lock_guard<std::mutex> lock(m_announce_mtx);
+    const auto& freq_list = is_reconfig_list ? m_recnf_announcement_freqs : m_pres_announcement_freqs;
+    std::vector<uint32_t> freqs(freq_list.begin(), freq_list.end());
+
+    auto chan_of = [this](uint32_t freq) -> ec_announce_chan_t {
+        auto it = m_announce_chans.find(freq);
+        return (it != m_announce_chans.end()) ? it->second : ec_announce_chan_t{};
+    };
+
+    std::sort(freqs.begin(), freqs.end(), [&chan_of](uint32_t a, uint32_t b) {
+        ec_announce_chan_t ca = chan_of(a), cb = chan_of(b);
+        if (ca.num_cce_bss != cb.num_cce_bss) {
+            return ca.num_cce_bss > cb.num_cce_bss;
+        }
+        if (ca.num_cce_bss > 0 && ca.best_rssi != cb.best_rssi) {
+            return ca.best_rssi > cb.best_rssi;
+        }
+        if (ca.has_ssid != cb.has_ssid) {
+            return ca.has_ssid;
+        }
+        // The set has no order, keep the sweep the same from one cycle to the next
+        return a < b;
+    });
+
+    return freqs;
+}
+
+bool ec_enrollee_t::is_cce_channel(uint32_t freq)
+{
+    std::lock_guard<std::mutex> lock(m_announce_mtx);
+    auto it = m_announce_chans.find(freq);
+    return it != m_announce_chans.end() && it->second.num_cce_bss > 0;
+}
+
 bool ec_enrollee_t::handle_recfg_auth_request(ec_frame_t *frame, size_t len, uint8_t src_mac[ETH_ALEN])
 {
     if (!frame) {
@@ -587,10 +642,18 @@ bool ec_enrollee_t::handle_auth_request(ec_frame_t *frame, size_t len, uint8_t s
     m_received_auth_frame.store(true);
     m_selected_freq = static_cast<uint32_t>(recv_freq);
 
+    uint64_t start_ms = m_pres_announce_start_ms.exchange(0);
+    if (start_ms != 0) {
+        m_time_to_first_auth_req_ms.store(static_cast<int64_t>(now_ms() - start_ms));
+        em_printfout("First DPP Authentication Request %lldms after the first Presence Announcement, on freq %u (%s)",
+            static_cast<long long>(m_time_to_first_auth_req_ms.load()), recv_freq, is_cce_channel(m_selected_freq) ? "CCE heard" : "no CCE heard");
+    }
+
     if (m_send_pres_announcement_thread.joinable()) m_send_pres_announcement_thread.join();
     size_t attrs_len = len - EC_FRAME_BASE_SIZE;
+    ec_attrib_index_t attribs(frame->attributes, attrs_len);
 
-    auto B_r_hash_attr = ec_util::get_attrib(frame->attributes, static_cast<uint16_t> (attrs_len), ec_attrib_id_resp_bootstrap_key_hash);
+    auto B_r_hash_attr = attribs.get(ec_attrib_id_resp_bootstrap_key_hash);
     ASSERT_OPT_HAS_VALUE(B_r_hash_attr, false, "%s:%d No responder bootstrapping key hash attribute found\n", __func__, __LINE__);
 
     uint8_t* responder_keyhash = ec_crypto::compute_key_hash(m_boot_data().responder_boot_key);
@@ -605,7 +668,7 @@ bool ec_enrollee_t::handle_auth_request(ec_frame_t *frame, size_t len, uint8_t s
     
     if (m_boot_data().initiator_boot_key != NULL){
         // Initiator bootstrapping key is present on enrollee, mutual authentication is possible
-        auto B_i_hash_attr = ec_util::get_attrib(frame->attributes, static_cast<uint16_t> (attrs_len), ec_attrib_id_init_bootstrap_key_hash);
+        auto B_i_hash_attr = attribs.get(ec_attrib_id_init_bootstrap_key_hash);
         ASSERT_OPT_HAS_VALUE(B_i_hash_attr, false, "%s:%d No initiator bootstrapping key hash attribute found\n", __func__, __LINE__);
         uint8_t* initiator_keyhash = ec_crypto::compute_key_hash(m_boot_data().initiator_boot_key);
         if (initiator_keyhash != NULL) {
@@ -623,7 +686,7 @@ bool ec_enrollee_t::handle_auth_request(ec_frame_t *frame, size_t len, uint8_t s
         }     
     }
 
-   auto channel_attr = ec_util::get_attrib(frame->attributes, static_cast<uint16_t> (attrs_len), ec_attrib_id_channel);
+   auto channel_attr = attribs.get(ec_attrib_id_channel);
     if (channel_attr && channel_attr->length == sizeof(uint16_t)) {
         /*
         the Responder determines whether it can use the requested channel for the
@@ -641,7 +704,7 @@ Authentication Request frame without replying to it.
         // Maybe just attempt to send it on the channel
     }
 
-    auto pub_init_proto_key_attr = ec_util::get_attrib(frame->attributes, static_cast<uint16_t> (attrs_len), ec_attrib_id_init_proto_key);
+    auto pub_init_proto_key_attr = attribs.get(ec_attrib_id_init_proto_key);
 
     ASSERT_OPT_HAS_VALUE(pub_init_proto_key_attr, false, "%s:%d No public initiator protocol key attribute found\n", __func__, __LINE__);
     ASSERT_EQUALS(pub_init_proto_key_attr->length, BN_num_bytes(m_c_ctx.prime) * 2, false, "%s:%d Invalid public initiator protocol key length\n", __func__, __LINE__);
@@ -669,7 +732,7 @@ Authentication Request frame without replying to it.
     printf("Key K_1:\n");
     util::print_hex_dump(static_cast<unsigned int> (m_c_ctx.digest_len), m_eph_ctx().k1);
 
-    auto wrapped_data_attr = ec_util::get_attrib(frame->attributes, static_cast<uint16_t> (attrs_len), ec_attrib_id_wrapped_data);
+    auto wrapped_data_attr = attribs.get(ec_attrib_id_wrapped_data);
     ASSERT_OPT_HAS_VALUE(wrapped_data_attr, false, "%s:%d No wrapped data attribute found\n", __func__, __LINE__);
 
     // Attempt to unwrap the wrapped data with generated k1 (from sent keys)
@@ -680,15 +743,16 @@ Authentication Request frame without replying to it.
         return false;
     }
 
-    auto init_caps_attr = ec_util::get_attrib(wrapped_data, static_cast<uint16_t> (wrapped_len), ec_attrib_id_init_caps);
+    ec_attrib_index_t wrapped_attribs(wrapped_data, wrapped_len);
+    auto init_caps_attr = wrapped_attribs.get(ec_attrib_id_init_caps);
     ASSERT_OPT_HAS_VALUE_FREE(init_caps_attr, false, wrapped_data, "%s:%d No initiator capabilities attribute found\n", __func__, __LINE__);
 
     const ec_dpp_capabilities_t init_caps = {
         .byte = init_caps_attr->data[0]
     };
 
-    auto i_nonce_attr = ec_util::get_attrib(wrapped_data, static_cast<uint16_t>(wrapped_len), ec_attrib_id_init_nonce);
-    ASSERT_OPT_HAS_VALUE_FREE(init_caps_attr, false, wrapped_data, "%s:%d: No initiator nonce attribute found\n", __func__, __LINE__);
+    auto i_nonce_attr = wrapped_attribs.get(ec_attrib_id_init_nonce);
+    ASSERT_OPT_HAS_VALUE_FREE(i_nonce_attr, false, wrapped_data, "%s:%d: No initiator nonce attribute found\n", __func__, __LINE__);
     memcpy(m_eph_ctx().i_nonce, i_nonce_attr->data, i_nonce_attr->length);
     em_printfout("i-nonce (Configurator is initiator)");
     util::print_hex_dump(i_nonce_attr->length, m_eph_ctx().i_nonce);
@@ -697,7 +761,7 @@ Authentication Request frame without replying to it.
     free(wrapped_data);
 
     uint8_t init_proto_version = 0; // Undefined
-    auto proto_version_attr = ec_util::get_attrib(frame->attributes, attrs_len, ec_attrib_id_proto_version);
+    auto proto_version_attr = attribs.get(ec_attrib_id_proto_version);
     if (proto_version_attr && proto_version_attr->length == 1) {
         init_proto_version = proto_version_attr->data[0];
     }
@@ -920,7 +984,8 @@ bool ec_enrollee_t::handle_config_response(uint8_t *query_resp, size_t len, uint
     EM_ASSERT_NOT_NULL(query_resp, false, "Query response is NULL");
     EM_ASSERT_MSG_TRUE(len > 0, false, "Query response length is zero");
 
-    auto status_attrib = ec_util::get_attrib(query_resp, len, ec_attrib_id_dpp_status);
+    ec_attrib_index_t attribs(query_resp, len);
+    auto status_attrib = attribs.get(ec_attrib_id_dpp_status);
     ASSERT_OPT_HAS_VALUE(status_attrib, false, "%s:%d: No DPP status attribute found\n", __func__, __LINE__);
 
     ec_status_code_t config_response_status_code = static_cast<ec_status_code_t>(status_attrib->data[0]);
@@ -946,7 +1011,7 @@ bool ec_enrollee_t::handle_config_response(uint8_t *query_resp, size_t len, uint
         return false;
     }
 
-    auto wrapped_attrs = ec_util::get_attrib(query_resp, len, ec_attrib_id_wrapped_data);
+    auto wrapped_attrs = attribs.get(ec_attrib_id_wrapped_data);
     ASSERT_OPT_HAS_VALUE(wrapped_attrs, false, "%s:%d: Failed to get wrapped data attribute!\n", __func__, __LINE__);
 
     auto [unwrapped_attrs, unwrapped_attrs_len] = ec_util::unwrap_wrapped_attrib(*wrapped_attrs, query_resp, true, m_eph_ctx().ke);
@@ -954,17 +1019,18 @@ bool ec_enrollee_t::handle_config_response(uint8_t *query_resp, size_t len, uint
         em_printfout("Failed to unwrap wrapped attributes.");
         return false;
     }
-    auto e_nonce_attr = ec_util::get_attrib(unwrapped_attrs, unwrapped_attrs_len, ec_attrib_id_enrollee_nonce);
+    ec_attrib_index_t unwrapped_attribs(unwrapped_attrs, unwrapped_attrs_len);
+    auto e_nonce_attr = unwrapped_attribs.get(ec_attrib_id_enrollee_nonce);
     ASSERT_OPT_HAS_VALUE_FREE(e_nonce_attr, false, unwrapped_attrs, "%s:%d: No e-nonce in attributes!\n", __func__, __LINE__);
 
-    auto dpp_config_obj_1905 = ec_util::get_attrib(unwrapped_attrs, unwrapped_attrs_len, ec_attrib_id_dpp_config_obj);
+    auto dpp_config_obj_1905 = unwrapped_attribs.get(ec_attrib_id_dpp_config_obj);
     ASSERT_OPT_HAS_VALUE_FREE(dpp_config_obj_1905, false, unwrapped_attrs, "%s:%d: No IEEE1905 Configuration object attribute found\n", __func__, __LINE__);
 
-    auto dpp_config_obj_bsta = ec_util::get_attrib(reinterpret_cast<uint8_t*>(dpp_config_obj_1905->original) + ec_util::get_ec_attr_size(dpp_config_obj_1905->length), unwrapped_attrs_len, ec_attrib_id_dpp_config_obj);
+    auto dpp_config_obj_bsta = unwrapped_attribs.get(ec_attrib_id_dpp_config_obj, 1);
     ASSERT_OPT_HAS_VALUE_FREE(dpp_config_obj_bsta, false, unwrapped_attrs, "%s:%d: No bSTA Configuration object attribute found\n", __func__, __LINE__);
 
     // This is optional, so can be nullptr.
-    auto send_connection_status_attr = ec_util::get_attrib(unwrapped_attrs, unwrapped_attrs_len, ec_attrib_id_send_conn_status);
+    auto send_connection_status_attr = unwrapped_attribs.get(ec_attrib_id_send_conn_status);
 
     // Only necessary if Configurator includes "sendConnStatus" in Configuration response.
     bool needs_connection_status = (send_connection_status_attr.has_value());
@@ -1174,25 +1240,32 @@ std::pair<uint8_t *, size_t> ec_enrollee_t::create_auth_response(ec_status_code_
         Responder → Initiator: DPP Status, SHA-256(BR), [ SHA-256(BI), ] PR, [Protocol Version], { R-nonce, I-nonce, R-capabilities, { R-auth }ke }k2
     */
 
-    ec_frame_t *frame =  ec_util::alloc_frame(ec_frame_type_auth_rsp);
-    ASSERT_NOT_NULL(frame, {}, "%s:%d failed to allocate memory for frame\n", __func__, __LINE__);
-
-    uint8_t* attribs = NULL;
-    size_t attribs_len = 0;
-
-    attribs = ec_util::add_attrib(attribs, &attribs_len, ec_attrib_id_dpp_status, static_cast<uint8_t>(dpp_status));
+    // The frame is built in place, sized for the STATUS_OK layout which is the largest
+    const uint16_t proto_key_len = (m_c_ctx.prime != NULL) ? static_cast<uint16_t>(BN_num_bytes(m_c_ctx.prime) * 2) : 0;
+    const size_t ke_wrapped_len = ec_util::get_ec_attr_size(static_cast<uint16_t>(m_c_ctx.digest_len));
+    const size_t wrapped_len = 2 * ec_util::get_ec_attr_size(static_cast<uint16_t>(m_c_ctx.nonce_len)) +
+        ec_util::get_ec_attr_size(sizeof(uint8_t)) + ec_attrib_writer_t::get_wrapped_size(ke_wrapped_len);
+    const size_t frame_size = EC_FRAME_BASE_SIZE + 2 * ec_util::get_ec_attr_size(sizeof(uint8_t)) +
+        2 * ec_util::get_ec_attr_size(SHA256_DIGEST_LENGTH) + ec_util::get_ec_attr_size(proto_key_len) +
+        ec_attrib_writer_t::get_wrapped_size(wrapped_len);
+    ec_attrib_writer_t writer(EC_FRAME_BASE_SIZE, frame_size, true);
+    ec_frame_t *frame = reinterpret_cast<ec_frame_t *>(writer.base());
+    ec_util::init_frame(frame);
+    frame->frame_type = ec_frame_type_auth_rsp;
+
+    writer.add_attrib(ec_attrib_id_dpp_status, static_cast<uint8_t>(dpp_status));
 
     // Add Responder Bootstrapping Key Hash (SHA-256(B_R))
     uint8_t* responder_keyhash = ec_crypto::compute_key_hash(m_boot_data().responder_boot_key);
-    ASSERT_NOT_NULL_FREE2(responder_keyhash, {}, frame, attribs, "%s:%d failed to compute responder bootstrapping key hash\n", __func__, __LINE__);
+    ASSERT_NOT_NULL(responder_keyhash, {}, "%s:%d failed to compute responder bootstrapping key hash\n", __func__, __LINE__);
 
-    attribs = ec_util::add_attrib(attribs, &attribs_len, ec_attrib_id_resp_bootstrap_key_hash, SHA256_DIGEST_LENGTH, responder_keyhash);
+    writer.add_attrib(ec_attrib_id_resp_bootstrap_key_hash, SHA256_DIGEST_LENGTH, responder_keyhash);
     free(responder_keyhash);
     // Conditional (Only included for mutual authentication) (SHA-256(B_I))
     if (m_eph_ctx().is_mutual_auth) {
         uint8_t* initiator_keyhash = ec_crypto::compute_key_hash(m_boot_data().initiator_boot_key);
         if (initiator_keyhash != NULL) {
-            attribs = ec_util::add_attrib(attribs, &attribs_len, ec_attrib_id_init_bootstrap_key_hash, SHA256_DIGEST_LENGTH, initiator_keyhash);
+            writer.add_attrib(ec_attrib_id_init_bootstrap_key_hash, SHA256_DIGEST_LENGTH, initiator_keyhash);
             free(initiator_keyhash);
         }
 
@@ -1203,23 +1276,17 @@ std::pair<uint8_t *, size_t> ec_enrollee_t::create_auth_response(ec_status_code_
     if (dpp_status != DPP_STATUS_OK) {
         if (init_proto_version >= 2) {
             // Add Protocol Version (TOOD: Add variable for responder protocol version)
-            attribs = ec_util::add_attrib(attribs, &attribs_len, ec_attrib_id_proto_version, static_cast<uint8_t>(1));
+            writer.add_attrib(ec_attrib_id_proto_version, static_cast<uint8_t>(1));
         }
-        attribs = ec_util::add_wrapped_data_attr(frame, attribs, &attribs_len, true, m_eph_ctx().k1, [&](){
-            size_t wrapped_len = 0;
-            uint8_t* wrap_attribs = ec_util::add_attrib(NULL, &wrapped_len, ec_attrib_id_init_nonce, m_c_ctx.nonce_len, m_eph_ctx().i_nonce);
-            wrap_attribs = ec_util::add_attrib(wrap_attribs, &wrapped_len, ec_attrib_id_resp_caps, m_dpp_caps.byte);
-            return std::make_pair(wrap_attribs, wrapped_len);
-        });
-        
-        if (!(frame = ec_util::copy_attrs_to_frame(frame, attribs, attribs_len))) {
-            em_printfout("unable to copy attributes to frame");
-            free(frame);
-            free(attribs);
-            return {};
-        }
-        free(attribs);
-        return std::make_pair(reinterpret_cast<uint8_t*>(frame), EC_FRAME_BASE_SIZE + attribs_len);
+        ec_attrib_writer_t wrap_attribs(0, wrapped_len);
+        wrap_attribs.add_attrib(ec_attrib_id_init_nonce, m_c_ctx.nonce_len, m_eph_ctx().i_nonce);
+        wrap_attribs.add_attrib(ec_attrib_id_resp_caps, m_dpp_caps.byte);
+        writer.add_wrapped_data(true, m_eph_ctx().k1, wrap_attribs);
+
+        size_t frame_len = 0;
+        uint8_t *buff = writer.release(&frame_len);
+        ASSERT_NOT_NULL(buff, {}, "%s:%d: Failed to build Authentication Response frame\n", __func__, __LINE__);
+        return std::make_pair(buff, frame_len);
     }
     
     // STATUS_OK
@@ -1227,8 +1294,6 @@ std::pair<uint8_t *, size_t> ec_enrollee_t::create_auth_response(ec_status_code_
     // Generate R-nonce
     if (!RAND_bytes(m_eph_ctx().r_nonce, m_c_ctx.nonce_len)) {
         em_printfout("failed to generate R-nonce");
-        free(attribs);
-        free(frame);
         return {};
     }
 
@@ -1236,8 +1301,6 @@ std::pair<uint8_t *, size_t> ec_enrollee_t::create_auth_response(ec_status_code_
     auto [priv_resp_proto_key, pub_resp_proto_key] = ec_crypto::generate_proto_keypair(m_c_ctx);
     if (priv_resp_proto_key == NULL || pub_resp_proto_key == NULL) {
         em_printfout("failed to generate responder protocol keypair");
-        free(attribs);
-        free(frame);
         return {};
     }
     
@@ -1245,22 +1308,20 @@ std::pair<uint8_t *, size_t> ec_enrollee_t::create_auth_response(ec_status_code_
     m_eph_ctx().public_resp_proto_key = const_cast<EC_POINT*>(pub_resp_proto_key);
     m_eph_ctx().priv_resp_proto_key = const_cast<BIGNUM*>(priv_resp_proto_key);
 
-    ASSERT_NOT_NULL_FREE2(m_eph_ctx().public_init_proto_key, {}, frame, attribs, "%s:%d initiator protocol keypair was never generated!\n", __func__, __LINE__);
+    ASSERT_NOT_NULL(m_eph_ctx().public_init_proto_key, {}, "%s:%d initiator protocol keypair was never generated!\n", __func__, __LINE__);
     m_eph_ctx().n = ec_crypto::compute_ec_ss_x(m_c_ctx, m_eph_ctx().priv_resp_proto_key, m_eph_ctx().public_init_proto_key);
     const BIGNUM *bn_inputs[1] = { m_eph_ctx().n };
     // Compute the "second intermediate key" (k2)
     m_eph_ctx().k2 = static_cast<uint8_t *>(calloc(m_c_ctx.digest_len, 1));
     if (ec_crypto::compute_hkdf_key(m_c_ctx, m_eph_ctx().k2, m_c_ctx.digest_len, "second intermediate key", bn_inputs, 1, NULL, 0) == 0) {
         em_printfout("Failed to compute k2"); 
-        free(attribs);
-        free(frame);
         return {};
     }
 
     printf("Key K_2:\n");
     util::print_hex_dump(m_c_ctx.digest_len, m_eph_ctx().k2);
 
-    ASSERT_NOT_NULL_FREE2(m_boot_data().resp_priv_boot_key, {}, frame, attribs, "%s:%d failed to get responder bootstrapping private key\n", __func__, __LINE__);
+    ASSERT_NOT_NULL(m_boot_data().resp_priv_boot_key, {}, "%s:%d failed to get responder bootstrapping private key\n", __func__, __LINE__);
 
     // Compute L.x
     if (m_eph_ctx().is_mutual_auth){
@@ -1271,8 +1332,6 @@ std::pair<uint8_t *, size_t> ec_enrollee_t::create_auth_response(ec_status_code_
 
     if (m_eph_ctx().is_mutual_auth && m_eph_ctx().l == NULL) {
         em_printfout("failed to compute L.x");
-        free(attribs);
-        free(frame);
         return {};
     }
     
@@ -1281,8 +1340,6 @@ std::pair<uint8_t *, size_t> ec_enrollee_t::create_auth_response(ec_status_code_
     m_eph_ctx().ke = static_cast<uint8_t *>(calloc(m_c_ctx.digest_len, 1));
     if (ec_crypto::compute_ke(m_c_ctx, &m_eph_ctx(), m_eph_ctx().ke) == 0){
         em_printfout("Failed to compute ke");
-        free(attribs);
-        free(frame);
         return {};
     }
 
@@ -1324,47 +1381,39 @@ std::pair<uint8_t *, size_t> ec_enrollee_t::create_auth_response(ec_status_code_
     if (P_R_x) BN_free(P_R_x);
     if (B_R_x) BN_free(B_R_x);
     if (B_I_x) BN_free(B_I_x);
-    ASSERT_NOT_NULL_FREE2(r_auth, {}, frame, attribs, "%s:%d: Failed to compute R-auth\n", __func__, __LINE__);
+    ASSERT_NOT_NULL(r_auth, {}, "%s:%d: Failed to compute R-auth\n", __func__, __LINE__);
 
     // Add P_R
     auto encoded_P_R = ec_crypto::encode_ec_point(m_c_ctx, m_eph_ctx().public_resp_proto_key);
-    ASSERT_NOT_NULL_FREE2(encoded_P_R, {}, frame, attribs, "%s:%d failed to encode responder protocol key\n", __func__, __LINE__);
+    ASSERT_NOT_NULL_FREE(encoded_P_R, {}, r_auth, "%s:%d failed to encode responder protocol key\n", __func__, __LINE__);
 
-    attribs = ec_util::add_attrib(attribs, &attribs_len, ec_attrib_id_resp_proto_key, static_cast<uint16_t>(BN_num_bytes(m_c_ctx.prime) * 2), encoded_P_R);
+    writer.add_attrib(ec_attrib_id_resp_proto_key, proto_key_len, encoded_P_R);
 
     // Add Protocol Version
     if (init_proto_version >= 2) {
         // Add Protocol Version (TOOD: Add variable for responder protocol version)
-        attribs = ec_util::add_attrib(attribs, &attribs_len, ec_attrib_id_proto_version, static_cast<uint8_t>(1));
+        writer.add_attrib(ec_attrib_id_proto_version, static_cast<uint8_t>(1));
     }
 
     // Add `{ R-nonce, I-nonce, R-capabilities, { R-auth }k_e }k_2`
-    attribs = ec_util::add_wrapped_data_attr(frame, attribs, &attribs_len, true, m_eph_ctx().k2, [&](){
-        size_t wrapped_len = 0;
-        uint8_t* wrap_attribs = ec_util::add_attrib(NULL, &wrapped_len, ec_attrib_id_resp_nonce, m_c_ctx.nonce_len, m_eph_ctx().r_nonce);
-        wrap_attribs = ec_util::add_attrib(wrap_attribs, &wrapped_len, ec_attrib_id_init_nonce, m_c_ctx.nonce_len, m_eph_ctx().i_nonce);
-        wrap_attribs = ec_util::add_attrib(wrap_attribs, &wrapped_len, ec_attrib_id_resp_caps, m_dpp_caps.byte);
-
-        // R-auth is wrapped in an additional wrapped data attribute (k_e) inside the main wrapped data attribute (k_2)
-        wrap_attribs = ec_util::add_wrapped_data_attr(frame, wrap_attribs, &wrapped_len, false, m_eph_ctx().ke, [&](){
-            size_t int_wrapped_len = 0;
-            uint8_t* int_wrapped_attrs = ec_util::add_attrib(NULL, &int_wrapped_len, ec_attrib_id_resp_auth_tag, m_c_ctx.digest_len, r_auth);
-            return std::make_pair(int_wrapped_attrs, int_wrapped_len);
-        });
-        return std::make_pair(wrap_attribs, wrapped_len);
-    });
+    ec_attrib_writer_t wrap_attribs(0, wrapped_len);
+    wrap_attribs.add_attrib(ec_attrib_id_resp_nonce, m_c_ctx.nonce_len, m_eph_ctx().r_nonce);
+    wrap_attribs.add_attrib(ec_attrib_id_init_nonce, m_c_ctx.nonce_len, m_eph_ctx().i_nonce);
+    wrap_attribs.add_attrib(ec_attrib_id_resp_caps, m_dpp_caps.byte);
+
+    // R-auth is wrapped in an additional wrapped data attribute (k_e) inside the main wrapped data attribute (k_2)
+    ec_attrib_writer_t int_wrapped_attrs(0, ke_wrapped_len);
+    int_wrapped_attrs.add_attrib(ec_attrib_id_resp_auth_tag, m_c_ctx.digest_len, r_auth);
+    wrap_attribs.add_wrapped_data(false, m_eph_ctx().ke, int_wrapped_attrs);
+    writer.add_wrapped_data(true, m_eph_ctx().k2, wrap_attribs);
 
     free(r_auth);
 
-    if (!(frame = ec_util::copy_attrs_to_frame(frame, attribs, attribs_len))) {
-        em_printfout("unable to copy attributes to frame");
-        free(frame);
-        free(attribs);
-        return {};
-    }
-    free(attribs);
+    size_t frame_len = 0;
+    uint8_t *buff = writer.release(&frame_len);
+    ASSERT_NOT_NULL(buff, {}, "%s:%d: Failed to build Authentication Response frame\n", __func__, __LINE__);
 
-    return std::make_pair(reinterpret_cast<uint8_t*>(frame), EC_FRAME_BASE_SIZE + attribs_len);
+    return std::make_pair(buff, frame_len);
 
 }
 
@@ -1768,54 +1817,33 @@ bool ec_enrollee_t::handle_gas_comeback_response(ec_gas_comeback_response_frame_
         em_printfout("NULL GAS comeback response frame");
         return false;
     }
-    const std::string source_mac_key = util::mac_to_string(src_mac) + "_" + std::to_string(static_cast<int>(frame->base.dialog_token));
-    if (frame->fragment_id != m_gas_fragments[source_mac_key].expected_fragment_id) {
-        em_printfout("Fragment ID mismatch for dialog=%d from %s", frame->base.dialog_token, source_mac_key.c_str());
+
+    const uint8_t *payload = nullptr;
+    size_t payload_len = 0;
+    ec_gas_frag_status_t status = m_gas_frag.add_fragment(src_mac, frame, len, &payload, &payload_len);
+    if (status == ec_gas_frag_error) {
         return false;
     }
 
-    bool more_frags_coming = (frame->more_fragments > 0);
-
-    m_gas_fragments[source_mac_key].reassembled_payload.insert(
-        m_gas_fragments[source_mac_key].reassembled_payload.end(),
-        frame->comeback_resp,
-        frame->comeback_resp + frame->comeback_resp_len
-    );
-
-    m_gas_fragments[source_mac_key].expected_fragment_id++;
-    m_gas_fragments[source_mac_key].last_seen = std::chrono::steady_clock::now();
-
-    if (!more_frags_coming) {
+    if (status == ec_gas_frag_complete) {
         // No more data coming, we've got a complete frame
-        em_printfout("Full fragmented frame reassembled:\n");
-        util::print_hex_dump(m_gas_fragments[source_mac_key].reassembled_payload);
-        bool did_succeed = handle_config_response(
-            m_gas_fragments[source_mac_key].reassembled_payload.data(),
-            m_gas_fragments[source_mac_key].reassembled_payload.size(),
-            src_mac
-        );
+        em_printfout("Full fragmented frame of %zu bytes reassembled", payload_len);
+        bool did_succeed = handle_config_response(const_cast<uint8_t *>(payload), payload_len, src_mac);
         if (!did_succeed) {
             em_printfout("Failed to handle Configuration Response");
             return false;
         }
-        m_gas_fragments.erase(source_mac_key);
+        // Regardless of if we're still awaiting fragments or if we marshalled a full frame, we've succeeded.
+        return true;
     }
 
-    if (more_frags_coming) {
-        // If there's more frags coming, send a Comeback Request to enable sending of next Comeback Response
-        ec_gas_comeback_request_frame_t *cb_frame = create_comeback_request(frame->base.dialog_token);
-        ASSERT_NOT_NULL(cb_frame, false, "%s:%d: Failed to allocate a GAS Comeback Request frame\n", __func__, __LINE__);
-        bool sent = send_phy_frame(src_mac, reinterpret_cast<uint8_t *>(cb_frame), sizeof(ec_gas_comeback_request_frame_t), m_selected_freq);
-
-        if (!sent) {
-            em_printfout("Failed to send GAS Comeback Request to '" MACSTRFMT "', we made it to frag #%d", MAC2STR(src_mac), frame->fragment_id);
-        }
-        free(cb_frame);
-        return sent;
+    // If there's more frags coming, send a Comeback Request to enable sending of next Comeback Response
+    bool sent = send_comeback_request(src_mac, frame->base.dialog_token);
+    if (!sent) {
+        em_printfout("Failed to send GAS Comeback Request to '" MACSTRFMT "', we made it to frag #%d", MAC2STR(src_mac), frame->fragment_id);
+        m_gas_frag.release(src_mac);
     }
-
-    // Regardless of if we're still awaiting fragments or if we marshalled a full frame, we've succeeded.
-    return true;
+    return sent;
 }
 
 bool ec_enrollee_t::handle_gas_initial_response(ec_gas_initial_response_frame_t *resp_frame, size_t len, uint8_t src_mac[ETH_ALEN])
@@ -1829,11 +1857,7 @@ bool ec_enrollee_t::handle_gas_initial_response(ec_gas_initial_response_frame_t
     if (is_fragmentation_signal_frame) {
         em_printfout("Received a fragmentation preperation GAS Initial Response frame from '" MACSTRFMT "'", MAC2STR(src_mac));
 
-        ec_gas_comeback_request_frame_t *cb_frame = create_comeback_request(resp_frame->base.dialog_token);
-        ASSERT_NOT_NULL(cb_frame, false, "%s:%d: Failed to allocate GAS Initial Request frame\n", __func__, __LINE__);
-        bool sent = send_phy_frame(src_mac, reinterpret_cast<uint8_t *>(cb_frame), sizeof(ec_gas_comeback_request_frame_t), m_selected_freq);
-
-        free(cb_frame);
+        bool sent = send_comeback_request(src_mac, resp_frame->base.dialog_token);
         if (!sent) {
             em_printfout("Failed to send GAS Comeback Request to '" MACSTRFMT "'", MAC2STR(src_mac));
             return false;
@@ -1848,11 +1872,13 @@ bool ec_enrollee_t::handle_gas_initial_response(ec_gas_initial_response_frame_t
     return handle_config_response(resp_frame->resp, static_cast<size_t>(resp_frame->resp_len), src_mac);
 }
 
-ec_gas_comeback_request_frame_t *ec_enrollee_t::create_comeback_request(uint8_t dialog_token)
+bool ec_enrollee_t::send_comeback_request(uint8_t dest_mac[ETH_ALEN], uint8_t dialog_token)
 {
-    auto [frame, len] = ec_util::alloc_gas_frame(dpp_gas_comeback_req, dialog_token);
-    if (frame == nullptr || len == 0) return nullptr;
-    return reinterpret_cast<ec_gas_comeback_request_frame_t*>(frame);
+    // Only the GAS header, built on the stack for every fragment
+    ec_gas_comeback_request_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+    ec_util::init_gas_frame(&frame, dpp_gas_comeback_req, dialog_token);
+    return send_phy_frame(dest_mac, reinterpret_cast<uint8_t *>(&frame), sizeof(frame), m_selected_freq);
 }
 
 bool ec_enrollee_t::send_autoconf_search_chirp(){
@@ -2055,6 +2081,7 @@ bool ec_enrollee_t::handle_bss_info_event(const std::vector<wifi_bss_info_t> &bs
 {
 
     bool did_handle_bss_info = false;
+    std::lock_guard<std::mutex> lock(m_announce_mtx);
     for (auto& bss_info : bss_info_list) {
         /* EC EC 6.5.2 #2 
         For each channel on which the Enrollee detects the SSID for which it is currently configured, add to the channel list;
@@ -2063,6 +2090,7 @@ bool ec_enrollee_t::handle_bss_info_event(const std::vector<wifi_bss_info_t> &bs
             std::string(bss_info.ssid) == m_configured_ssid) {
             em_printfout("SSID %s heard on frequency %d, adding to Reconfiguration Announcement frequency list", bss_info.ssid, bss_info.freq);
             m_recnf_announcement_freqs.insert(bss_info.freq);
+            m_announce_chans[bss_info.freq].has_ssid = true;
             did_handle_bss_info = true;
         }
 
@@ -2074,6 +2102,11 @@ bool ec_enrollee_t::handle_bss_info_event(const std::vector<wifi_bss_info_t> &bs
             em_printfout("CCE heard on frequency %d, adding to Presence Announcement frequency list", bss_info.freq);
             m_pres_announcement_freqs.insert(bss_info.freq);
             m_recnf_announcement_freqs.insert(bss_info.freq);
+            ec_announce_chan_t& chan = m_announce_chans[bss_info.freq];
+            if (chan.num_cce_bss == 0 || bss_info.rssi > chan.best_rssi) {
+                chan.best_rssi = bss_info.rssi;
+            }
+            chan.num_cce_bss++;
             did_handle_bss_info = true;
         }
 
@@ -0,0 +1,201 @@
+#include "ec_gas_frag.h"
+
+#include "util.h"
+
+#include <chrono>
+
+/**
+ * @brief Key of a peer in the session table, its MAC packed in an integer
+ */
+static inline uint64_t peer_key(const uint8_t mac[ETH_ALEN])
+{
+    uint64_t key = 0;
+    memcpy(&key, mac, ETH_ALEN);
+    return key;
+}
+
+static inline uint64_t now_ms()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+ec_gas_frag_t::ec_gas_frag_t()
+{
+    for (auto& session : m_sessions) {
+        session.peer = 0;
+        session.dialog_token = 0;
+        session.fragment_id = 0;
+        session.offset = 0;
+        session.last_ms = 0;
+        session.payload.reserve(EC_GAS_FRAG_BUF_RESERVE);
+    }
+    m_tx_frame.reserve(sizeof(ec_gas_comeback_response_frame_t) + WIFI_MTU_SIZE);
+}
+
+ec_gas_frag_session_t *ec_gas_frag_t::find(uint64_t peer)
+{
+    for (auto& session : m_sessions) {
+        if (session.peer == peer) {
+            return &session;
+        }
+    }
+    return NULL;
+}
+
+const ec_gas_frag_session_t *ec_gas_frag_t::find(uint64_t peer) const
+{
+    for (const auto& session : m_sessions) {
+        if (session.peer == peer) {
+            return &session;
+        }
+    }
+    return NULL;
+}
+
+ec_gas_frag_session_t *ec_gas_frag_t::claim(uint64_t peer, uint8_t dialog_token)
+{
+    ec_gas_frag_session_t *session = find(peer);
+    uint64_t now = now_ms();
+
+    if (session == NULL) {
+        session = &m_sessions[0];
+        for (auto& s : m_sessions) {
+            if (s.peer == 0) {
+                session = &s;
+                break;
+            }
+            if (s.last_ms < session->last_ms) {
+                session = &s;
+            }
+        }
+        if (session->peer != 0 && now - session->last_ms < EC_GAS_FRAG_SESSION_TIMEOUT_MS) {
+            uint8_t mac[ETH_ALEN];
+            memcpy(mac, &session->peer, ETH_ALEN);
+            em_printfout("All %d GAS sessions busy, dropping the one with '" MACSTRFMT "'", EC_GAS_FRAG_MAX_SESSIONS, MAC2STR(mac));
+        }
+    }
+
+    session->peer = peer;
+    session->dialog_token = dialog_token;
+    session->fragment_id = 0;
+    session->offset = 0;
+    session->last_ms = now;
+    // clear() keeps the capacity, the buffer is not allocated again
+    session->payload.clear();
+
+    return session;
+}
+
+ec_gas_frag_status_t ec_gas_frag_t::add_fragment(const uint8_t peer[ETH_ALEN], const ec_gas_comeback_response_frame_t *frame, size_t len,
+                                                 const uint8_t **payload, size_t *payload_len)
+{
+    if (frame == NULL || len < sizeof(ec_gas_comeback_response_frame_t) ||
+        len - sizeof(ec_gas_comeback_response_frame_t) < frame->comeback_resp_len) {
+        em_printfout("Malformed GAS Comeback Response from '" MACSTRFMT "'", MAC2STR(peer));
+        return ec_gas_frag_error;
+    }
+
+    uint64_t key = peer_key(peer);
+    ec_gas_frag_session_t *session = find(key);
+
+    if (frame->fragment_id == 0) {
+        // Fast path, the whole payload is in this frame
+        if (frame->more_fragments == 0) {
+            if (session != NULL) {
+                session->peer = 0;
+            }
+            *payload = frame->comeback_resp;
+            *payload_len = frame->comeback_resp_len;
+            return ec_gas_frag_complete;
+        }
+        session = claim(key, frame->base.dialog_token);
+    }
+
+    if (session == NULL || session->dialog_token != frame->base.dialog_token || session->fragment_id != frame->fragment_id) {
+        em_printfout("Unexpected GAS Comeback Response fragment #%d for dialog=%d from '" MACSTRFMT "'",
+            frame->fragment_id, frame->base.dialog_token, MAC2STR(peer));
+        if (session != NULL) {
+            session->peer = 0;
+        }
+        return ec_gas_frag_error;
+    }
+
+    if (session->payload.size() + frame->comeback_resp_len > EC_GAS_FRAG_MAX_PAYLOAD) {
+        em_printfout("GAS Comeback Response payload from '" MACSTRFMT "' too large", MAC2STR(peer));
+        session->peer = 0;
+        return ec_gas_frag_error;
+    }
+
+    session->payload.insert(session->payload.end(), frame->comeback_resp, frame->comeback_resp + frame->comeback_resp_len);
+    session->fragment_id = (session->fragment_id + 1) & 0x7F;
+    session->last_ms = now_ms();
+
+    if (frame->more_fragments != 0) {
+        return ec_gas_frag_more;
+    }
+
+    // The session is free for the next exchange, its buffer is left as is until it is claimed
+    session->peer = 0;
+    *payload = session->payload.data();
+    *payload_len = session->payload.size();
+    return ec_gas_frag_complete;
+}
+
+bool ec_gas_frag_t::queue(const uint8_t peer[ETH_ALEN], uint8_t dialog_token, const uint8_t *payload, size_t len)
+{
+    if (payload == NULL || len == 0 || len > EC_GAS_FRAG_MAX_PAYLOAD) {
+        em_printfout("Cannot fragment a payload of %zu bytes for '" MACSTRFMT "'", len, MAC2STR(peer));
+        return false;
+    }
+
+    ec_gas_frag_session_t *session = claim(peer_key(peer), dialog_token);
+    session->payload.assign(payload, payload + len);
+
+    return true;
+}
+
+const ec_gas_comeback_response_frame_t *ec_gas_frag_t::next_fragment(const uint8_t peer[ETH_ALEN], size_t *frame_len)
+{
+    ec_gas_frag_session_t *session = find(peer_key(peer));
+    if (session == NULL || session->offset >= session->payload.size()) {
+        return NULL;
+    }
+
+    size_t chunk_size = std::min(WIFI_MTU_SIZE, session->payload.size() - session->offset);
+    size_t base_len = sizeof(ec_gas_comeback_response_frame_t);
+
+    // Within the capacity reserved by the constructor
+    m_tx_frame.assign(base_len + chunk_size, 0);
+    ec_util::init_gas_frame(m_tx_frame.data(), dpp_gas_comeback_resp, session->dialog_token);
+
+    auto *frame = reinterpret_cast<ec_gas_comeback_response_frame_t *>(m_tx_frame.data());
+    frame->fragment_id = session->fragment_id & 0x7F;
+    frame->more_fragments = ((session->offset + chunk_size) < session->payload.size()) ? 1 : 0;
+    frame->comeback_resp_len = static_cast<uint16_t>(chunk_size);
+    memcpy(frame->comeback_resp, session->payload.data() + session->offset, chunk_size);
+
+    session->offset += chunk_size;
+    session->fragment_id = (session->fragment_id + 1) & 0x7F;
+    session->last_ms = now_ms();
+    if (frame->more_fragments == 0) {
+        session->peer = 0;
+    }
+
+    *frame_len = m_tx_frame.size();
+    return frame;
+}
+
+bool ec_gas_frag_t::has_pending(const uint8_t peer[ETH_ALEN]) const
+{
+    const ec_gas_frag_session_t *session = find(peer_key(peer));
+    return session != NULL && session->offset < session->payload.size();
+}
+
+void ec_gas_frag_t::release(const uint8_t peer[ETH_ALEN])
+{
+    ec_gas_frag_session_t *session = find(peer_key(peer));
+    if (session != NULL) {
+        session->peer = 0;
+    }
+}
@@ -89,10 +89,7 @@ bool ec_pa_configurator_t::handle_recfg_announcement(ec_frame_t *frame, size_t l
         sent = m_send_action_frame(sa, encap_frame_vec.data(), encap_frame_vec.size(), 0, 0);
     } else {
         em_printfout("No matching C-sign key hash found in DPP Reconfiguration Announcement frame, sending Reconfiguration Announcement frame to controller");
-        auto [encap_frame, encap_frame_len] = ec_util::create_encap_dpp_tlv(false, sa, ec_frame_type_recfg_announcement, reinterpret_cast<uint8_t*>(frame), len);
-        ASSERT_NOT_NULL(encap_frame, false, "%s:%d: Failed to create Encap DPP TLV for Reconfiguration Announcement frame\n", __func__, __LINE__);
-        sent = m_send_prox_encap_dpp_msg(encap_frame, encap_frame_len, nullptr, 0, m_ctrl_al_mac_addr.data());
-        free(encap_frame);
+        sent = send_prox_encap_dpp_frame(false, sa, ec_frame_type_recfg_announcement, reinterpret_cast<uint8_t*>(frame), len, m_ctrl_al_mac_addr.data());
     }
     return sent;
 }
@@ -102,13 +99,8 @@ bool ec_pa_configurator_t::handle_auth_response(ec_frame_t *frame, size_t len, u
     (void)src_al_mac; // Unused parameter in proxy agent
     em_printfout("Received a DPP Authentication Response frame from '" MACSTRFMT "'\n", MAC2STR(src_mac));
     // Encapsulate 802.11 frame into 1905 Encap DPP TLV and send to controller
-    auto [encap_dpp_tlv, encap_dpp_size] = ec_util::create_encap_dpp_tlv(false, src_mac, ec_frame_type_auth_rsp, reinterpret_cast<uint8_t*>(frame), len);
-    ASSERT_NOT_NULL(encap_dpp_tlv, false, "%s:%d Failed to create Encap DPP TLV\n", __func__, __LINE__);
-
     // Only create and forward an Encap TLV
-    bool did_succeed = m_send_prox_encap_dpp_msg(encap_dpp_tlv, encap_dpp_size, NULL, 0, m_ctrl_al_mac_addr.data());
-    free(encap_dpp_tlv);
-    return did_succeed;
+    return send_prox_encap_dpp_frame(false, src_mac, ec_frame_type_auth_rsp, reinterpret_cast<uint8_t*>(frame), len, m_ctrl_al_mac_addr.data());
 }
 
 bool ec_pa_configurator_t::handle_cfg_request(uint8_t *buff, unsigned int len, uint8_t sa[ETH_ALEN])
@@ -123,13 +115,10 @@ bool ec_pa_configurator_t::handle_cfg_request(uint8_t *buff, unsigned int len, u
     // Configuration Request frame and shall set the Enrollee MAC Address Present field to one, include the Enrollee's MAC
     // address in the Destination STA MAC Address field, set the DPP Frame Indicator field to one and the Frame Type field to
     // 255, and send the message to the Multi-AP Controller.
-    auto [encap_dpp_tlv, encap_dpp_tlv_len] = ec_util::create_encap_dpp_tlv(true, sa, static_cast<ec_frame_type_t>(ec_frame_type_easymesh), buff, len);
-    ASSERT_NOT_NULL(encap_dpp_tlv, false, "%s:%d: Could not create Encap DPP TLV!\n", __func__, __LINE__);
-    bool sent = m_send_prox_encap_dpp_msg(encap_dpp_tlv, encap_dpp_tlv_len, nullptr, 0, m_ctrl_al_mac_addr.data());
+    bool sent = send_prox_encap_dpp_frame(true, sa, static_cast<ec_frame_type_t>(ec_frame_type_easymesh), buff, len, m_ctrl_al_mac_addr.data());
     if (!sent) {
         em_printfout("Failed to send Proxied Encap DPP message!");
     }
-    free(encap_dpp_tlv);
     return sent;
 }
 
@@ -142,14 +131,11 @@ bool ec_pa_configurator_t::handle_cfg_result(ec_frame_t *frame, size_t len, uint
     // Address field to the MAC address of the Enrollee, set the DPP Frame Indicator field to 0 and the Frame Type field to 11,
     // and send the Proxied Encap DPP message to the Multi-AP Controller.
 
-    auto [encap_dpp_tlv, encap_dpp_tlv_len] = ec_util::create_encap_dpp_tlv(false, sa, ec_frame_type_cfg_result, reinterpret_cast<uint8_t*>(frame), len);
-    ASSERT_NOT_NULL(encap_dpp_tlv, false, "%s:%d: Failed to create Encap DPP TLV\n", __func__, __LINE__);
-    bool sent = m_send_prox_encap_dpp_msg(encap_dpp_tlv, encap_dpp_tlv_len, nullptr, 0, m_ctrl_al_mac_addr.data());
+    bool sent = send_prox_encap_dpp_frame(false, sa, ec_frame_type_cfg_result, reinterpret_cast<uint8_t*>(frame), len, m_ctrl_al_mac_addr.data());
     if (!sent) {
         em_printfout("Failed to send Encap DPP TLV");
     }
     em_printfout("Sent Encap DPP TLV");
-    free(encap_dpp_tlv);
     return sent;
 }
 
@@ -162,14 +148,11 @@ bool ec_pa_configurator_t::handle_connection_status_result(ec_frame_t *frame, si
     // Address field to the MAC address of the Enrollee, set the DPP Frame Indicator field to 0 and the Frame Type field to 12,
     // and send the Proxied Encap DPP message to the Multi-AP Controller
 
-    auto [encap_dpp_tlv, encap_dpp_tlv_len] = ec_util::create_encap_dpp_tlv(false, sa, ec_frame_type_conn_status_result, reinterpret_cast<uint8_t*>(frame), len);
-    ASSERT_NOT_NULL(encap_dpp_tlv, false, "%s:%d: Failed to create Encap DPP TLV\n", __func__, __LINE__);
-    bool sent = m_send_prox_encap_dpp_msg(encap_dpp_tlv, encap_dpp_tlv_len, nullptr, 0, m_ctrl_al_mac_addr.data());
+    bool sent = send_prox_encap_dpp_frame(false, sa, ec_frame_type_conn_status_result, reinterpret_cast<uint8_t*>(frame), len, m_ctrl_al_mac_addr.data());
     if (!sent) {
         em_printfout("Failed to send Encap DPP TLV");
     }
     em_printfout("Sent Encap DPP TLV");
-    free(encap_dpp_tlv);
     return sent;
 }
 
@@ -214,7 +197,12 @@ bool ec_pa_configurator_t::process_proxy_encap_dpp_msg(em_encap_dpp_t *encap_tlv
         uint8_t* payload = encap_frame + sizeof(ec_gas_initial_response_frame_t);
         size_t payload_len = encap_frame_len - sizeof(ec_gas_initial_response_frame_t);
 
-        m_gas_frames_to_be_sent[dest_mac_str] = fragment_large_frame(payload, payload_len, dialog_token);
+        // The fragments are built one at a time as the peer asks for them
+        bool queued = m_gas_frag.queue(dest_mac, dialog_token, payload, payload_len);
+        free(encap_frame);
+        if (!queued) {
+            return false;
+        }
         return send_prepare_for_fragmented_frames_frame(dest_mac);
     }
 
@@ -390,8 +378,7 @@ bool ec_pa_configurator_t::process_direct_encap_dpp_msg(uint8_t* dpp_frame, uint
 bool ec_pa_configurator_t::handle_gas_comeback_request([[maybe_unused]] uint8_t *buff, [[maybe_unused]] unsigned int len, uint8_t sa[ETH_ALEN])
 {
     em_printfout("Received a GAS Comeback Request frame from '" MACSTRFMT "'", MAC2STR(sa));
-    auto frame_it = m_gas_frames_to_be_sent.find(util::mac_to_string(sa));
-    if (frame_it == m_gas_frames_to_be_sent.end()) {
+    if (!m_gas_frag.has_pending(sa)) {
         // Nothing to do
         em_printfout("Received potentially spurious GAS Comeback Request frame from '" MACSTRFMT "', not doing anything with it", MAC2STR(sa));
         return true;
@@ -401,32 +388,27 @@ bool ec_pa_configurator_t::handle_gas_comeback_request([[maybe_unused]] uint8_t
     auto dialog_it = m_gas_session_dialog_tokens.find(util::mac_to_string(sa));
     if (dialog_it == m_gas_session_dialog_tokens.end()) {
         em_printfout("Received GAS Comeback Request from '" MACSTRFMT "', we have a frame waiting for them, but no dialog token known!", MAC2STR(sa));
+        m_gas_frag.release(sa);
         return false;
     }
 
-    // Get the fragments to send
-    std::vector<ec_gas_comeback_response_frame_t*>& fragments = frame_it->second;
-
-    if (fragments.empty()) {
-        em_printfout("Received GAS Comeback Request, but we have no more fragments to send to '" MACSTRFMT "'", MAC2STR(sa));
+    // Fragments are built by increasing frag ID, in a frame buffer that is reused
+    size_t fragment_len = 0;
+    const ec_gas_comeback_response_frame_t *fragment = m_gas_frag.next_fragment(sa, &fragment_len);
+    if (fragment == nullptr) {
+        em_printfout("Failed to build the next fragment for '" MACSTRFMT "'", MAC2STR(sa));
         return false;
     }
 
-    // This code assumes that m_gas_frames_to_be_sent stores fragments with linearly increasing frag ID
-    // Grab 0th, send it, delete it
-    ec_gas_comeback_response_frame_t *fragment = fragments.front();
-    fragments.erase(fragments.begin());
-
-    bool sent = m_send_action_frame(sa, reinterpret_cast<uint8_t*>(fragment), sizeof(ec_gas_comeback_response_frame_t) + fragment->comeback_resp_len, 0, 0);
+    bool sent = m_send_action_frame(sa, reinterpret_cast<uint8_t*>(const_cast<ec_gas_comeback_response_frame_t*>(fragment)), fragment_len, 0, 0);
     
     if (!sent) {
         em_printfout("Failed to send fragment #%d to '" MACSTRFMT "'", fragment->fragment_id, MAC2STR(sa));
-        free(fragment);
+        m_gas_frag.release(sa);
         return false;
     }
 
     em_printfout("Sent fragment #%d (more frags = %d) to '" MACSTRFMT "'", fragment->fragment_id, fragment->more_fragments, MAC2STR(sa));
-    free(fragment);
     return sent;
 }
 
@@ -441,60 +423,12 @@ bool ec_pa_configurator_t::send_prepare_for_fragmented_frames_frame(uint8_t dest
 
     // Inform GAS peer that we're going to be sending them a fragmented frame via the 
     // GAS Comeback mechanism by first sending a GAS Initial Response with resp_len = 0  and / or delay > 0
-    auto [gas_initial_resp_frame, gas_initial_resp_frame_len] = ec_util::alloc_gas_frame(dpp_gas_initial_resp, dialog_token);
-    if (gas_initial_resp_frame == nullptr) {
-        em_printfout("Could not allocate GAS Initial Response frame");
-        return false;
-    }
-    ec_gas_initial_response_frame_t *frame = reinterpret_cast<ec_gas_initial_response_frame_t*>(gas_initial_resp_frame);
-    frame->resp_len = 0;
-    frame->gas_comeback_delay = 1;
+    // Only the GAS header, no need to allocate it
+    ec_gas_initial_response_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+    ec_util::init_gas_frame(&frame, dpp_gas_initial_resp, dialog_token);
+    frame.resp_len = 0;
+    frame.gas_comeback_delay = 1;
     em_printfout("Sending GAS Comeback Response preparation GAS Initial Response frame to '" MACSTRFMT "'", MAC2STR(dest_mac));
-    return m_send_action_frame(dest_mac, reinterpret_cast<uint8_t*>(frame), gas_initial_resp_frame_len, 0, 0);
+    return m_send_action_frame(dest_mac, reinterpret_cast<uint8_t*>(&frame), sizeof(frame), 0, 0);
 }
-
-std::vector<ec_gas_comeback_response_frame_t *> ec_pa_configurator_t::fragment_large_frame(const uint8_t *payload, size_t len, uint8_t dialog_token)
-{
-    // Fragments will be stored by increasing frag ID
-    std::vector<ec_gas_comeback_response_frame_t *> fragments;
-    size_t offset = 0;
-    uint8_t frag_id = 0;
-
-    while (offset < len) {
-        size_t chunk_size = std::min(WIFI_MTU_SIZE, len - offset);
-
-        auto [base_frame, base_len] = ec_util::alloc_gas_frame(dpp_gas_comeback_resp, dialog_token);
-        if (!base_frame) {
-            em_printfout("Failed to allocate GAS Comeback Response frame for frag #%d", frag_id);
-            for (auto *f : fragments) {
-                free(f);
-            }
-            return {};
-        }
-
-        ec_gas_comeback_response_frame_t *frame = static_cast<ec_gas_comeback_response_frame_t *>(base_frame);
-        frame->comeback_resp_len = static_cast<uint16_t>(chunk_size);
-
-        frame->fragment_id = frag_id & 0x7F;
-        frame->more_fragments = ((offset + chunk_size) < len) ? 1 : 0;
-
-        em_printfout("Copying data into fragment #%d:\n", frag_id);
-        util::print_hex_dump(static_cast<unsigned int>(chunk_size), const_cast<uint8_t*>(payload + offset));
-        // Copy the actual chunk of the payload into the frame
-        frame = ec_util::copy_payload_to_gas_resp(frame, const_cast<uint8_t *>(payload + offset), chunk_size);
-        if (!frame) {
-            em_printfout("Failed to copy payload into Comeback Response frame for frag #%d", frag_id);
-            for (auto *f : fragments) {
-                free(f);
-            }
-            return {};
-        }
-        fragments.push_back(frame);
-
-
-        offset += chunk_size;
-        frag_id++;
-    }
-
-    return fragments;
-}
\ No newline at end of file
@@ -13,6 +13,72 @@
 #include "dm_easy_mesh.h"
 #include "cjson_util.h"
 
+// Number of expanded AES-SIV keys kept per thread, a DPP exchange uses k1, k2, ke and the
+// connection's configuration key at most
+#define EC_SIV_CACHE_SZ 4
+
+typedef struct {
+    uint8_t key[SIV_256/8];
+    siv_ctx ctx;
+    uint64_t last_used;
+    bool valid;
+} ec_siv_cache_entry_t;
+
+struct ec_siv_cache_t {
+    ec_siv_cache_entry_t entries[EC_SIV_CACHE_SZ];
+    uint64_t clock;
+
+    ec_siv_cache_t() : clock(0) { memset(entries, 0, sizeof(entries)); }
+    ~ec_siv_cache_t()
+    {
+        for (auto& e : entries) {
+            if (e.valid) {
+                siv_free(&e.ctx);
+                memset(e.key, 0, sizeof(e.key));
+            }
+        }
+    }
+};
+
+/**
+ * @brief Get an AES-SIV context keyed with `key`, reusing the expanded key schedules of a recent call.
+ *
+ * siv_encrypt() and siv_decrypt() restart the context when they return, so a cached context is
+ * ready for the next message. The least recently used entry is freed to make room.
+ *
+ * @param key The SIV_256 key (32 bytes)
+ * @return siv_ctx* The context, owned by the calling thread's cache, or NULL if the key could not be set up
+ */
+static siv_ctx *get_siv_ctx(const uint8_t *key)
+{
+    static thread_local ec_siv_cache_t cache;
+    ec_siv_cache_entry_t *victim = &cache.entries[0];
+
+    for (auto& e : cache.entries) {
+        if (e.valid && memcmp(e.key, key, sizeof(e.key)) == 0) {
+            e.last_used = ++cache.clock;
+            return &e.ctx;
+        }
+        if (!e.valid || (victim->valid && e.last_used < victim->last_used)) {
+            victim = &e;
+        }
+    }
+
+    if (victim->valid) {
+        siv_free(&victim->ctx);
+        victim->valid = false;
+    }
+    if (siv_init(&victim->ctx, key, SIV_256) != 1) {
+        siv_free(&victim->ctx);
+        return NULL;
+    }
+    memcpy(victim->key, key, sizeof(victim->key));
+    victim->last_used = ++cache.clock;
+    victim->valid = true;
+
+    return &victim->ctx;
+}
+
 void ec_util::init_frame(ec_frame_t *frame)
 {
     memset(frame, 0, sizeof(ec_frame_t));
@@ -34,10 +100,14 @@ std::optional<const ec_attribute_t> ec_util::get_attrib(uint8_t *buff, size_t le
     size_t total_len = 0;
     ec_net_attribute_t *attrib = reinterpret_cast<ec_net_attribute_t *>(buff);
 
-    while (total_len < len) {
+    while (total_len + offsetof(ec_net_attribute_t, data) <= len) {
         const uint16_t curr_id = SWAP_LITTLE_ENDIAN(attrib->attr_id);
         const uint16_t curr_data_len = SWAP_LITTLE_ENDIAN(attrib->length);
         const size_t attr_len = get_ec_attr_size(curr_data_len);
+        if (total_len + attr_len > len) {
+            em_printfout("Attribute 0x%04x runs past the end of the buffer", curr_id);
+            break;
+        }
         if (curr_id == id) {
             // Create a copy of the found attrib, but with host byte ordering
             ec_attribute_t host_attr = {
@@ -86,6 +156,256 @@ uint8_t* ec_util::add_attrib(uint8_t *buff, size_t* buff_len, ec_attrib_id_t id,
     return base_ptr;
 }
 
+ec_attrib_index_t::ec_attrib_index_t(uint8_t *buff, size_t len) : m_buff(buff), m_len(len), m_num(0), m_indexed_len(0), m_malformed(false)
+{
+    ec_net_attribute_t *attrib;
+    size_t attr_len;
+
+    if (buff == NULL) {
+        m_len = 0;
+        return;
+    }
+
+    while ((m_indexed_len < m_len) && (m_num < EC_ATTRIB_INDEX_MAX)) {
+        if (m_len - m_indexed_len < offsetof(ec_net_attribute_t, data)) {
+            m_malformed = true;
+            break;
+        }
+        attrib = reinterpret_cast<ec_net_attribute_t *>(m_buff + m_indexed_len);
+        attr_len = ec_util::get_ec_attr_size(SWAP_LITTLE_ENDIAN(attrib->length));
+        if (attr_len > m_len - m_indexed_len) {
+            m_malformed = true;
+            break;
+        }
+        m_refs[m_num].id = SWAP_LITTLE_ENDIAN(attrib->attr_id);
+        m_refs[m_num].len = SWAP_LITTLE_ENDIAN(attrib->length);
+        m_refs[m_num].off = static_cast<uint32_t>(m_indexed_len);
+        m_num++;
+        m_indexed_len += attr_len;
+    }
+
+    if (m_malformed) {
+        // nothing past a bad length can be trusted
+        m_len = m_indexed_len;
+    }
+}
+
+ec_attribute_t ec_attrib_index_t::make_attrib(size_t off) const
+{
+    ec_net_attribute_t *attrib = reinterpret_cast<ec_net_attribute_t *>(m_buff + off);
+    ec_attribute_t host_attr = {
+        .attr_id = SWAP_LITTLE_ENDIAN(attrib->attr_id),
+        .length = SWAP_LITTLE_ENDIAN(attrib->length),
+        .original = attrib,
+        .data = attrib->data
+    };
+
+    return host_attr;
+}
+
+std::optional<const ec_attribute_t> ec_attrib_index_t::get(ec_attrib_id_t id, unsigned int instance) const
+{
+    ec_net_attribute_t *attrib;
+    unsigned int i;
+    size_t off, attr_len;
+
+    for (i = 0; i < m_num; i++) {
+        if ((m_refs[i].id == id) && (instance-- == 0)) {
+            return make_attrib(m_refs[i].off);
+        }
+    }
+
+    // past the indexed attributes of a very long frame
+    for (off = m_indexed_len; m_len - off >= offsetof(ec_net_attribute_t, data); off += attr_len) {
+        attrib = reinterpret_cast<ec_net_attribute_t *>(m_buff + off);
+        attr_len = ec_util::get_ec_attr_size(SWAP_LITTLE_ENDIAN(attrib->length));
+        if (attr_len > m_len - off) {
+            break;
+        }
+        if ((SWAP_LITTLE_ENDIAN(attrib->attr_id) == id) && (instance-- == 0)) {
+            return make_attrib(off);
+        }
+    }
+
+    return std::nullopt;
+}
+
+unsigned int ec_attrib_index_t::count(ec_attrib_id_t id) const
+{
+    ec_net_attribute_t *attrib;
+    unsigned int i, num = 0;
+    size_t off, attr_len;
+
+    for (i = 0; i < m_num; i++) {
+        num += (m_refs[i].id == id) ? 1:0;
+    }
+
+    for (off = m_indexed_len; m_len - off >= offsetof(ec_net_attribute_t, data); off += attr_len) {
+        attrib = reinterpret_cast<ec_net_attribute_t *>(m_buff + off);
+        attr_len = ec_util::get_ec_attr_size(SWAP_LITTLE_ENDIAN(attrib->length));
+        if (attr_len > m_len - off) {
+            break;
+        }
+        num += (SWAP_LITTLE_ENDIAN(attrib->attr_id) == id) ? 1:0;
+    }
+
+    return num;
+}
+
+ec_attrib_writer_t::ec_attrib_writer_t(size_t base_size, size_t capacity, bool base_aad) :
+    m_buff(m_inline), m_cap(sizeof(m_inline)), m_len(0), m_base_size(base_size), m_base_aad(base_aad), m_error(false)
+{
+    if (reserve((capacity > base_size) ? capacity:base_size)) {
+        memset(m_buff, 0, base_size);
+        m_len = base_size;
+    }
+}
+
+ec_attrib_writer_t::~ec_attrib_writer_t()
+{
+    if (m_buff != m_inline) {
+        free(m_buff);
+    }
+}
+
+bool ec_attrib_writer_t::reserve(size_t len)
+{
+    uint8_t *buff;
+    size_t cap;
+
+    if (m_len + len <= m_cap) {
+        return true;
+    }
+    if (m_error) {
+        return false;
+    }
+
+    // grow geometrically so that a low estimate costs a few reallocations at most
+    for (cap = (m_cap * 2); cap < (m_len + len); cap *= 2);
+    if (m_buff == m_inline) {
+        if ((buff = static_cast<uint8_t *>(malloc(cap))) != NULL) {
+            memcpy(buff, m_inline, m_len);
+        }
+    } else {
+        buff = static_cast<uint8_t *>(realloc(m_buff, cap));
+    }
+    if (buff == NULL) {
+        em_printfout("Failed to grow attribute buffer to %zu bytes", cap);
+        m_error = true;
+        return false;
+    }
+    m_buff = buff;
+    m_cap = cap;
+
+    return true;
+}
+
+uint8_t *ec_attrib_writer_t::open_attrib(ec_attrib_id_t id, uint16_t len)
+{
+    ec_net_attribute_t *attr;
+
+    if (!reserve(ec_util::get_ec_attr_size(len))) {
+        return NULL;
+    }
+
+    attr = reinterpret_cast<ec_net_attribute_t *>(m_buff + m_len);
+    // EC attribute id and length are little endian according to the spec (8.1)
+    attr->attr_id = SWAP_LITTLE_ENDIAN(id);
+    attr->length = SWAP_LITTLE_ENDIAN(len);
+    memset(attr->data, 0, len);
+    m_len += ec_util::get_ec_attr_size(len);
+
+    return attr->data;
+}
+
+bool ec_attrib_writer_t::add_attrib(ec_attrib_id_t id, uint16_t len, const uint8_t *data)
+{
+    uint8_t *attr_data;
+
+    if ((attr_data = open_attrib(id, len)) == NULL) {
+        return false;
+    }
+    if ((data != NULL) && (len != 0)) {
+        memcpy(attr_data, data, len);
+    }
+
+    return true;
+}
+
+bool ec_attrib_writer_t::add_wrapped_data(bool use_aad, uint8_t *key, const uint8_t *plain, size_t plain_len)
+{
+    ec_net_attribute_t *attr;
+    siv_ctx *ctx;
+    size_t aad_len = attribs_len();
+    int siv_result;
+
+    if ((plain_len + AES_BLOCK_SIZE) > UINT16_MAX) {
+        em_printfout("Wrapped data of %zu bytes does not fit an attribute", plain_len);
+        m_error = true;
+        return false;
+    }
+
+    // NOTE: HARDCODING AS SIV_256 FOR NOW, see ec_util::add_wrapped_data_attr
+    if ((ctx = get_siv_ctx(key)) == NULL) {
+        em_printfout("Failed to initialize AES-SIV context");
+        m_error = true;
+        return false;
+    }
+
+    if (!reserve(get_wrapped_size(plain_len))) {
+        return false;
+    }
+
+    // The synthetic IV/tag is stored in the first AES_BLOCK_SIZE bytes of the attribute data
+    attr = reinterpret_cast<ec_net_attribute_t *>(m_buff + m_len);
+    attr->attr_id = SWAP_LITTLE_ENDIAN(ec_attrib_id_wrapped_data);
+    attr->length = SWAP_LITTLE_ENDIAN(static_cast<uint16_t>(plain_len + AES_BLOCK_SIZE));
+    if (!use_aad) {
+        siv_result = siv_encrypt(ctx, plain, &attr->data[AES_BLOCK_SIZE], plain_len, attr->data, 0);
+    } else if (m_base_aad && (m_base_size != 0)) {
+        siv_result = siv_encrypt(ctx, plain, &attr->data[AES_BLOCK_SIZE], plain_len, attr->data, 2,
+            m_buff, m_base_size,
+            attribs(), aad_len);
+    } else {
+        siv_result = siv_encrypt(ctx, plain, &attr->data[AES_BLOCK_SIZE], plain_len, attr->data, 1,
+            attribs(), aad_len);
+    }
+    if (siv_result < 0) {
+        em_printfout("Failed to encrypt and authenticate wrapped data");
+        m_error = true;
+        return false;
+    }
+    m_len += get_wrapped_size(plain_len);
+
+    return true;
+}
+
+uint8_t *ec_attrib_writer_t::release(size_t *len)
+{
+    uint8_t *buff = m_buff;
+
+    *len = 0;
+    if (m_error) {
+        return NULL;
+    }
+
+    if (m_buff == m_inline) {
+        if ((buff = static_cast<uint8_t *>(malloc(m_len))) == NULL) {
+            em_printfout("Failed to allocate %zu bytes", m_len);
+            return NULL;
+        }
+        memcpy(buff, m_inline, m_len);
+    }
+    *len = m_len;
+
+    m_buff = m_inline;
+    m_cap = sizeof(m_inline);
+    m_len = 0;
+    m_base_size = 0;
+
+    return buff;
+}
+
 uint16_t ec_util::freq_to_channel_attr(unsigned int freq)
 {
     auto op_chan = util::em_freq_to_chan(freq);
@@ -126,12 +446,11 @@ uint8_t *ec_util::add_wrapped_data_attr(uint8_t *frame, size_t frame_len, uint8_
 
     ASSERT_NOT_NULL(non_wrapped_len, NULL, "Non-wrapped length cannot be NULL\n");
 
-    siv_ctx ctx;
-
     // NOTE: HARDCODING AS SIV_256 FOR NOW
     //  The spec technically only specifies P-256 so technically this is all that's allowed but for future proofing it's better to add more 
     //  I just want to avoid adding the digest_len as a parameter...
-    siv_init(&ctx, key, SIV_256);
+    siv_ctx *ctx = get_siv_ctx(key);
+    ASSERT_NOT_NULL(ctx, NULL, "Failed to initialize AES-SIV context\n");
 
     /*
     Initialize AES-SIV context
@@ -174,17 +493,16 @@ uint8_t *ec_util::add_wrapped_data_attr(uint8_t *frame, size_t frame_len, uint8_
         ASSERT_NOT_NULL_FREE2(frame_attribs, NULL, wrapped_attrib, wrap_attribs, "Frame attributes cannot be NULL for AAD encryption\n");
         if (frame == NULL || frame_len == 0) {
             em_printfout("frame is null or frame_len == 0 for AAD encryption, skipping it");
-            siv_result = siv_encrypt(&ctx, wrap_attribs, &wrapped_attrib->data[AES_BLOCK_SIZE], wrapped_len, wrapped_attrib->data, 1,
+            siv_result = siv_encrypt(ctx, wrap_attribs, &wrapped_attrib->data[AES_BLOCK_SIZE], wrapped_len, wrapped_attrib->data, 1,
                 frame_attribs, *non_wrapped_len);
         } else {
-            siv_result = siv_encrypt(&ctx, wrap_attribs, &wrapped_attrib->data[AES_BLOCK_SIZE], wrapped_len, wrapped_attrib->data, 2,
+            siv_result = siv_encrypt(ctx, wrap_attribs, &wrapped_attrib->data[AES_BLOCK_SIZE], wrapped_len, wrapped_attrib->data, 2,
                 frame, frame_len,
                 frame_attribs, *non_wrapped_len);
         }
     } else {
-        siv_result = siv_encrypt(&ctx, wrap_attribs, &wrapped_attrib->data[AES_BLOCK_SIZE], wrapped_len, wrapped_attrib->data, 0);
+        siv_result = siv_encrypt(ctx, wrap_attribs, &wrapped_attrib->data[AES_BLOCK_SIZE], wrapped_len, wrapped_attrib->data, 0);
     }
-    siv_free(&ctx);
     if (siv_result < 0) {
         em_printfout("Failed to encrypt and authenticate wrapped data");
         free(wrap_attribs);
@@ -213,12 +531,14 @@ std::pair<uint8_t*, uint16_t> ec_util::unwrap_wrapped_attrib(const ec_attribute_
 
 std::pair<uint8_t*, uint16_t> ec_util::unwrap_wrapped_attrib(const ec_attribute_t& wrapped_attrib, uint8_t *frame, size_t frame_len, uint8_t *frame_attribs, bool uses_aad, uint8_t *key)
 {
-    siv_ctx ctx;
-
     // NOTE: HARDCODING AS SIV_256 FOR NOW
     //  The spec technically only specifies P-256 so technically this is all that's allowed but for future proofing it's better to add more 
     //  I just want to avoid adding the digest_len as a parameter...
-    siv_init(&ctx, key, SIV_256);
+    siv_ctx *ctx = get_siv_ctx(key);
+    if (ctx == NULL) {
+        em_printfout("Failed to initialize AES-SIV context");
+        return {nullptr, 0};
+    }
 
     /*
     Initialize AES-SIV context
@@ -248,11 +568,11 @@ std::pair<uint8_t*, uint16_t> ec_util::unwrap_wrapped_attrib(const ec_attribute_
         size_t pre_wrapped_attribs_size = static_cast<size_t>(reinterpret_cast<uint8_t*>(wrapped_attrib.original) - frame_attribs);
         if (frame == NULL || frame_len == 0) {
             em_printfout("frame is null or frame_len == 0 for AAD decryption, skipping it");
-            result = siv_decrypt(&ctx, wrapped_ciphertext, unwrap_attribs, wrapped_len,
+            result = siv_decrypt(ctx, wrapped_ciphertext, unwrap_attribs, wrapped_len,
                 wrapped_attrib.data, 1,
                 frame_attribs, pre_wrapped_attribs_size);
         } else {
-            result = siv_decrypt(&ctx, wrapped_ciphertext, unwrap_attribs, wrapped_len,
+            result = siv_decrypt(ctx, wrapped_ciphertext, unwrap_attribs, wrapped_len,
                 wrapped_attrib.data, 2,
                 frame, frame_len,
                 frame_attribs, pre_wrapped_attribs_size);
@@ -260,10 +580,9 @@ std::pair<uint8_t*, uint16_t> ec_util::unwrap_wrapped_attrib(const ec_attribute_
         
 
     } else {
-        result = siv_decrypt(&ctx, wrapped_ciphertext, unwrap_attribs, wrapped_len,
+        result = siv_decrypt(ctx, wrapped_ciphertext, unwrap_attribs, wrapped_len,
                              wrapped_attrib.data, 0);
     }
-    siv_free(&ctx);
     if (result < 0) {
         em_printfout("Failed to decrypt and authenticate wrapped data");
         free(unwrap_attribs);
@@ -275,7 +594,7 @@ std::pair<uint8_t*, uint16_t> ec_util::unwrap_wrapped_attrib(const ec_attribute_
 
 bool ec_util::parse_dpp_chirp_tlv(em_dpp_chirp_value_t* chirp_tlv, uint16_t chirp_tlv_len, mac_addr_t *mac, uint8_t **hash, uint16_t *hash_len)
 {
-    if (chirp_tlv == NULL || chirp_tlv_len == 0) {
+    if (chirp_tlv == NULL || chirp_tlv_len < sizeof(em_dpp_chirp_value_t)) {
         fprintf(stderr, "Invalid input\n");
         return false;
     }
@@ -297,6 +616,11 @@ bool ec_util::parse_dpp_chirp_tlv(em_dpp_chirp_value_t* chirp_tlv, uint16_t chir
         return true;
     }
 
+    if (data_len < sizeof(uint16_t)) {
+        fprintf(stderr, "%s:%d: Invalid chirp tlv, %d bytes left for the hash length\n", __func__, __LINE__, data_len);
+        return false;
+    }
+
     *hash_len = util::deref_net_uint16_to_host(data_ptr);
     data_ptr += sizeof(uint16_t);
     data_len -= static_cast<uint16_t>(sizeof(uint16_t));
@@ -367,7 +691,7 @@ std::pair<em_dpp_chirp_value_t*, uint16_t> ec_util::create_dpp_chirp_tlv(bool ma
 
 bool ec_util::parse_encap_dpp_tlv(em_encap_dpp_t *encap_tlv, uint16_t encap_tlv_len, mac_addr_t *dest_mac, uint8_t *frame_type, uint8_t **encap_frame, uint16_t *encap_frame_len)
 {
-    if (encap_tlv == NULL || encap_tlv_len == 0) {
+    if (encap_tlv == NULL || encap_tlv_len < sizeof(em_encap_dpp_t)) {
         fprintf(stderr, "Invalid input\n");
         return false;
     }
@@ -398,6 +722,7 @@ bool ec_util::parse_encap_dpp_tlv(em_encap_dpp_t *encap_tlv, uint16_t encap_tlv_
     // Get frame length - Fix for alignment issue
     *encap_frame_len = util::deref_net_uint16_to_host(data_ptr);
     data_ptr += sizeof(uint16_t);
+    data_len = static_cast<uint16_t>(data_len - (sizeof(uint8_t) + sizeof(uint16_t)));
 
     if (data_len < *encap_frame_len) {
         fprintf(stderr, "Invalid encap tlv\n");
@@ -414,10 +739,7 @@ bool ec_util::parse_encap_dpp_tlv(em_encap_dpp_t *encap_tlv, uint16_t encap_tlv_
 
 std::pair<em_encap_dpp_t*, uint16_t> ec_util::create_encap_dpp_tlv(bool dpp_frame_indicator, mac_addr_t dest_mac, ec_frame_type_t frame_type, uint8_t *encap_frame, size_t encap_frame_len)
 {
-    size_t data_size = sizeof(em_encap_dpp_t) + sizeof(uint8_t) + sizeof(uint16_t) + encap_frame_len;
-    if (dest_mac != NULL) {
-        data_size += sizeof(mac_addr_t);
-    }
+    size_t data_size = get_encap_dpp_tlv_len(dest_mac != NULL, encap_frame_len);
     em_encap_dpp_t *encap_tlv = NULL;
     if (encap_frame_len > UINT16_MAX) {
         fprintf(stderr, "Encap frame too large\n");
@@ -428,6 +750,20 @@ std::pair<em_encap_dpp_t*, uint16_t> ec_util::create_encap_dpp_tlv(bool dpp_fram
         fprintf(stderr, "Failed to allocate memory\n");
         return {};
     }
+    write_encap_dpp_tlv(reinterpret_cast<uint8_t *>(encap_tlv), dpp_frame_indicator, dest_mac, frame_type, encap_frame, encap_frame_len);
+
+    return std::pair<em_encap_dpp_t*, uint16_t>(encap_tlv, static_cast<uint16_t>(data_size));
+}
+
+size_t ec_util::write_encap_dpp_tlv(uint8_t *buff, bool dpp_frame_indicator, mac_addr_t dest_mac, ec_frame_type_t frame_type, uint8_t *encap_frame, size_t encap_frame_len)
+{
+    em_encap_dpp_t *encap_tlv = reinterpret_cast<em_encap_dpp_t *>(buff);
+    if (encap_frame_len > UINT16_MAX) {
+        fprintf(stderr, "Encap frame too large\n");
+        return 0;
+    }
+
+    memset(encap_tlv, 0, sizeof(em_encap_dpp_t));
     (encap_tlv)->dpp_frame_indicator = dpp_frame_indicator;
     (encap_tlv)->enrollee_mac_addr_present = (dest_mac != NULL) ? 1 : 0;
 
@@ -445,7 +781,7 @@ std::pair<em_encap_dpp_t*, uint16_t> ec_util::create_encap_dpp_tlv(bool dpp_fram
 
     memcpy(data_ptr, encap_frame, encap_frame_len);
 
-    return std::pair<em_encap_dpp_t*, uint16_t>(encap_tlv, static_cast<uint16_t>(data_size));
+    return get_encap_dpp_tlv_len(dest_mac != NULL, encap_frame_len);
 }
 
 ec_frame_t *ec_util::copy_attrs_to_frame(ec_frame_t *frame, uint8_t *attrs, size_t attrs_len)
@@ -72,8 +72,47 @@ int em_provisioning_t::create_cce_ind_msg(uint8_t *buff, bool enable)
     return static_cast<int> (len);
 }
 
+int em_provisioning_t::send_dpp_msg(em_msg_type_t type, const char *name)
+{
+    em_tlv_writer_t *writer = get_tlv_writer();
+    unsigned char *frames[EM_TLV_WRITER_MAX_FRAGS];
+    unsigned int lens[EM_TLV_WRITER_MAX_FRAGS];
+    unsigned int i, len = 0;
+    int num;
+
+    if ((num = writer->finish()) < 0) {
+        em_printfout("%s msg build failed", name);
+        return -1;
+    }
+    num = static_cast<int> (writer->get_frames(frames, lens, EM_TLV_WRITER_MAX_FRAGS));
+
+    // the validation needs the whole message, a fragment alone does not pass it
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+
+    if ((num == 1) && (em_msg_t(type, em_profile_type_3, frames[0], lens[0]).validate(errors) == 0)) {
+        em_printfout("%s msg failed validation in tnx end", name);
+    }
+
+    for (i = 0; i < static_cast<unsigned int> (num); i++) {
+        len += lens[i];
+    }
+
+    em_raw_hdr_t *hdr = reinterpret_cast<em_raw_hdr_t *>(frames[0]);
+    em_printfout("Sending %s msg from '" MACSTRFMT "' to '" MACSTRFMT "' of length %d in %d frames", name, MAC2STR(hdr->src), MAC2STR(hdr->dst), len, num);
+
+    if (send_frames(frames, lens, static_cast<unsigned int> (num)) != num) {
+        em_printfout("%s msg failed", name);
+        perror("send_frames");
+        return -1;
+    }
+
+    return static_cast<int> (len);
+}
+
 int em_provisioning_t::send_prox_encap_dpp_msg(em_encap_dpp_t* encap_dpp_tlv, size_t encap_dpp_len, em_dpp_chirp_value_t *chirp, size_t chirp_len, uint8_t dest_al_mac[ETH_ALEN])
 {
+    em_tlv_writer_t *writer = get_tlv_writer();
+
     if (encap_dpp_len == 0 || encap_dpp_tlv == NULL) {
         em_printfout("Encap DPP TLV is empty");
         return -1;
@@ -89,49 +128,61 @@ int em_provisioning_t::send_prox_encap_dpp_msg(em_encap_dpp_t* encap_dpp_tlv, si
         return -1;
     }
 
-    // Make sure there is enough room for the TLV, the 1905 layer will deal with fragmentation.
-    uint8_t buff[MAX_EM_BUFF_SZ+encap_dpp_len];
-    unsigned int len = 0;
-    uint8_t *tmp = buff;
-
-    tmp = em_msg_t::add_1905_header(tmp, &len, dest_al_mac, get_al_interface_mac(), em_msg_type_proxied_encap_dpp,
-                        get_mgr()->get_next_msg_id());
+    // The writer fragments the message if the TLVs do not fit a frame
+    writer->begin(dest_al_mac, get_al_interface_mac(), em_msg_type_proxied_encap_dpp, get_mgr()->get_next_msg_id());
 
     // One 1905 Encap DPP TLV 17.2.79
-    tmp = em_msg_t::add_tlv(tmp, &len, em_tlv_type_1905_encap_dpp, reinterpret_cast<uint8_t *> (encap_dpp_tlv), static_cast<unsigned int> (encap_dpp_len));
+    writer->add_tlv(em_tlv_type_1905_encap_dpp, reinterpret_cast<uint8_t *> (encap_dpp_tlv), static_cast<unsigned int> (encap_dpp_len));
 
     // Zero or One DPP Chirp value tlv 17.2.83
     if (chirp != NULL && chirp_len > 0) {
-        tmp = em_msg_t::add_tlv(tmp, &len, em_tlv_type_dpp_chirp_value, reinterpret_cast<uint8_t *> (chirp), static_cast<unsigned int> (chirp_len));
+        writer->add_tlv(em_tlv_type_dpp_chirp_value, reinterpret_cast<uint8_t *> (chirp), static_cast<unsigned int> (chirp_len));
     }
 
+    return send_dpp_msg(em_msg_type_proxied_encap_dpp, "Proxied Encap DPP");
+}
 
-    tmp = em_msg_t::add_eom_tlv(tmp, &len);
+int em_provisioning_t::send_prox_encap_dpp_frame(bool dpp_frame_indicator, uint8_t *dest_mac, ec_frame_type_t frame_type, uint8_t *frame, size_t frame_len, uint8_t dest_al_mac[ETH_ALEN])
+{
+    em_tlv_writer_t *writer = get_tlv_writer();
+    size_t encap_dpp_len;
+    uint8_t *tmp;
 
-    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    if (frame_len == 0 || frame == NULL) {
+        em_printfout("Encap DPP Frame is empty");
+        return -1;
+    }
 
-    if (em_msg_t(em_msg_type_proxied_encap_dpp, em_profile_type_3, buff, len).validate(errors) == 0) {
-        em_printfout("Proxied Encap DPP msg failed validation in tnx end");
-        //return -1;
+    if (dest_al_mac == NULL) {
+        em_printfout("Destination AL MAC address is NULL");
+        return -1;
     }
 
-    {
-        em_raw_hdr_t *hdr = reinterpret_cast<em_raw_hdr_t *>(buff);
-        em_printfout("Sending Proxied Encap DPP msg from '" MACSTRFMT "' to '" MACSTRFMT "'", MAC2STR(hdr->src), MAC2STR(hdr->dst));
+    if (memcmp(dest_al_mac, ZERO_MAC_ADDR, ETH_ALEN) == 0) {
+        em_printfout("Destination AL MAC address is zero");
+        return -1;
     }
 
-    em_printfout("Sending Proxied Encap DPP msg of length %d", len);
-    if (send_frame(buff, len)  < 0) {
-        em_printfout("Proxied Encap DPP msg failed");
-        perror("send_frame");
+    encap_dpp_len = ec_util::get_encap_dpp_tlv_len(dest_mac != NULL, frame_len);
+    if ((frame_len > UINT16_MAX) || (encap_dpp_len > UINT16_MAX)) {
+        em_printfout("Encap DPP Frame of length %zu is too large", frame_len);
         return -1;
     }
 
-    return static_cast<int> (len);
+    writer->begin(dest_al_mac, get_al_interface_mac(), em_msg_type_proxied_encap_dpp, get_mgr()->get_next_msg_id());
+
+    // One 1905 Encap DPP TLV 17.2.79, its fields and the frame written straight into the message
+    if ((tmp = writer->open_tlv(em_tlv_type_1905_encap_dpp, static_cast<unsigned int> (encap_dpp_len))) != NULL) {
+        writer->close_tlv(static_cast<unsigned int> (ec_util::write_encap_dpp_tlv(tmp, dpp_frame_indicator, dest_mac, frame_type, frame, frame_len)));
+    }
+
+    return send_dpp_msg(em_msg_type_proxied_encap_dpp, "Proxied Encap DPP");
 }
 
 int em_provisioning_t::send_direct_encap_dpp_msg(uint8_t* dpp_frame, size_t dpp_frame_len, uint8_t dest_al_mac[ETH_ALEN])
 {
+    em_tlv_writer_t *writer = get_tlv_writer();
+
     if (dpp_frame_len == 0 || dpp_frame == NULL) {
         em_printfout("Direct DPP Frame is empty");
         return -1;
@@ -146,36 +197,17 @@ int em_provisioning_t::send_direct_encap_dpp_msg(uint8_t* dpp_frame, size_t dpp_
         return -1;
     }
 
-    // Make sure there is enough room for the TLV, the 1905 layer will deal with fragmentation.
-    uint8_t buff[MAX_EM_BUFF_SZ+dpp_frame_len];
-    unsigned int len = 0;
-    uint8_t *tmp = buff;
-
-    tmp = em_msg_t::add_1905_header(tmp, &len, dest_al_mac, get_al_interface_mac(), em_msg_type_direct_encap_dpp,
-                        get_mgr()->get_next_msg_id());
-
-    // One 1905 Encap DPP TLV 17.2.86
-    tmp = em_msg_t::add_tlv(tmp, &len, em_tlv_type_dpp_msg, dpp_frame, static_cast<unsigned int> (dpp_frame_len));
-
-    tmp = em_msg_t::add_eom_tlv(tmp, &len);
-
-    char *errors[EM_MAX_TLV_MEMBERS] = {0};
-
-    if (em_msg_t(em_msg_type_direct_encap_dpp, em_profile_type_3, buff, len).validate(errors) == 0) {
-        em_printfout("Direct Encap DPP msg failed validation in tnx end");
-        //return -1;
+    if (dpp_frame_len > UINT16_MAX) {
+        em_printfout("Direct DPP Frame of length %zu is too large", dpp_frame_len);
+        return -1;
     }
 
-    em_raw_hdr_t *hdr = reinterpret_cast<em_raw_hdr_t *>(buff);
-    em_printfout("Sending Direct Encap DPP msg from '" MACSTRFMT "' to '" MACSTRFMT "' of length %d", MAC2STR(hdr->src), MAC2STR(hdr->dst), len);
+    writer->begin(dest_al_mac, get_al_interface_mac(), em_msg_type_direct_encap_dpp, get_mgr()->get_next_msg_id());
 
-    if (send_frame(buff, len)  < 0) {
-        em_printfout("Direct Encap DPP msg failed");
-        perror("send_frame");
-        return -1;
-    }
+    // One 1905 Encap DPP TLV 17.2.86
+    writer->add_tlv(em_tlv_type_dpp_msg, dpp_frame, static_cast<unsigned int> (dpp_frame_len));
 
-    return static_cast<int> (len);
+    return send_dpp_msg(em_msg_type_direct_encap_dpp, "Direct Encap DPP");
 }
 
 int em_provisioning_t::send_1905_eapol_encap_msg(uint8_t* eapol_frame, size_t eapol_frame_len, uint8_t dest_al_mac[ETH_ALEN])
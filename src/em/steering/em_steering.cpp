@@ -19,6 +19,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <errno.h>
 #include <assert.h>
 #include <signal.h>
@@ -64,7 +65,7 @@ int em_steering_t::send_client_assoc_ctrl_req_msg()
                     assoc_ctrl[num].assoc_control = 0x03;
                 } else {
                     assoc_ctrl[num].assoc_control = 0x02;
-                    assoc_ctrl[num].validity_period = static_cast<short unsigned int> (disassoc_param->disassoc_time);
+                    assoc_ctrl[num].validity_period = htons(static_cast<short unsigned int> (disassoc_param->disassoc_time));
                 }
                 assoc_ctrl[num].count = 1;
                 memcpy(assoc_ctrl[num].sta_mac, disassoc_param->sta_mac, sizeof(mac_address_t));
@@ -158,6 +159,10 @@ int em_steering_t::send_client_steering_req_msg()
     em_tlv_t *tlv;
     unsigned char *tmp = buff;
     unsigned short type = htons(ETH_P_1905);
+    unsigned short msg_id;
+    unsigned long long now;
+    unsigned int i;
+    em_cmd_t *pcmd;
     dm_easy_mesh_t *dm;
 
     dm = get_data_model();
@@ -178,7 +183,8 @@ int em_steering_t::send_client_steering_req_msg()
 
     memset(tmp, 0, sizeof(em_cmdu_t));
     cmdu->type = htons(msg_type);
-    cmdu->id = htons(get_mgr()->get_next_msg_id());
+    msg_id = get_mgr()->get_next_msg_id();
+    cmdu->id = htons(msg_id);
     cmdu->last_frag_ind = 1;
     cmdu->relay_ind = 0;
 
@@ -188,7 +194,11 @@ int em_steering_t::send_client_steering_req_msg()
     // 17.2.29 Steering Request TLV/ Profile-2 Steering Request TLV 17.2.57
     tlv = reinterpret_cast<em_tlv_t *> (tmp);
     tlv->type = em_tlv_type_steering_request;
-    sz = create_btm_request_tlv(tlv->value);
+    if (get_current_cmd()->get_type() == em_cmd_type_sta_steer_batch) {
+        sz = create_btm_request_batch_tlv(tlv->value, &get_current_cmd()->m_param.u.steer_batch_params);
+    } else {
+        sz = create_btm_request_tlv(tlv->value);
+    }
     tlv->len = htons(static_cast<short unsigned int> (sz));
 
 	tmp += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
@@ -215,6 +225,21 @@ int em_steering_t::send_client_steering_req_msg()
     m_client_steering_req_tx_cnt++;
     printf("%s:%d: Client Steering Request (%d) Send Successful\n", __func__, __LINE__, m_client_steering_req_tx_cnt);
 
+    // the ACK, BTM Report and reassociation of each STA are matched against the request
+    pcmd = get_current_cmd();
+    now = em_timer_wheel_t::get_time_ms();
+    if (pcmd->get_type() == em_cmd_type_sta_steer_batch) {
+        em_cmd_steer_batch_params_t *batch = &pcmd->m_param.u.steer_batch_params;
+        for (i = 0; i < batch->num; i++) {
+            get_mgr()->get_steer_outcomes()->add_request(dm->get_agent_al_interface_mac(), batch->entries[i].sta_mac,
+                batch->source, batch->entries[i].target, msg_id, now);
+        }
+    } else {
+        em_cmd_steer_params_t *params = &pcmd->m_param.u.steer_params;
+        get_mgr()->get_steer_outcomes()->add_request(dm->get_agent_al_interface_mac(), params->sta_mac,
+            params->source, params->target, msg_id, now);
+    }
+
     return static_cast<int> (len);
 }
 
@@ -352,6 +377,186 @@ int em_steering_t::send_1905_ack_message(mac_addr_t sta_mac, unsigned short msg_
     return static_cast<int> (len);
 }
 
+int em_steering_t::send_bh_steering_req_msg(const em_bh_steering_req_t *req)
+{
+    unsigned char buff[MAX_EM_BUFF_SZ];
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    unsigned short  msg_type = em_msg_type_bh_steering_req;
+    size_t len = 0;
+    em_cmdu_t *cmdu;
+    em_tlv_t *tlv;
+    unsigned char *tmp = buff;
+    unsigned short type = htons(ETH_P_1905);
+    dm_easy_mesh_t *dm = get_data_model();
+
+    memcpy(tmp, dm->get_agent_al_interface_mac(), sizeof(mac_address_t));
+    tmp += sizeof(mac_address_t);
+    len += sizeof(mac_address_t);
+
+    memcpy(tmp, dm->get_ctrl_al_interface_mac(), sizeof(mac_address_t));
+    tmp += sizeof(mac_address_t);
+    len += sizeof(mac_address_t);
+
+    memcpy(tmp, reinterpret_cast<unsigned char *> (&type), sizeof(unsigned short));
+    tmp += sizeof(unsigned short);
+    len += sizeof(unsigned short);
+
+    cmdu = reinterpret_cast<em_cmdu_t *> (tmp);
+
+    memset(tmp, 0, sizeof(em_cmdu_t));
+    cmdu->type = htons(msg_type);
+    cmdu->id = htons(get_mgr()->get_next_msg_id());
+    cmdu->last_frag_ind = 1;
+
+    tmp += sizeof(em_cmdu_t);
+    len += sizeof(em_cmdu_t);
+
+    // 17.2.32 Backhaul Steering Request TLV format
+    tlv = reinterpret_cast<em_tlv_t *> (tmp);
+    tlv->type = em_tlv_type_bh_steering_req;
+    memcpy(tlv->value, req, sizeof(em_bh_steering_req_t));
+    tlv->len = htons(sizeof(em_bh_steering_req_t));
+
+    tmp += (sizeof(em_tlv_t) + sizeof(em_bh_steering_req_t));
+    len += (sizeof(em_tlv_t) + sizeof(em_bh_steering_req_t));
+
+    // End of message
+    tlv = reinterpret_cast<em_tlv_t *> (tmp);
+    tlv->type = em_tlv_type_eom;
+    tlv->len = 0;
+
+    tmp += (sizeof(em_tlv_t));
+    len += (sizeof(em_tlv_t));
+
+    if (em_msg_t(em_msg_type_bh_steering_req, em_profile_type_2, buff, static_cast<unsigned int> (len)).validate(errors) == 0) {
+        printf("%s:%d: Backhaul Steering Request validation failed\n", __func__, __LINE__);
+        return -1;
+    }
+
+    if (send_frame(buff, static_cast<unsigned int> (len))  < 0) {
+        printf("%s:%d: Backhaul Steering Request send failed, error:%d\n", __func__, __LINE__, errno);
+        return -1;
+    }
+
+    printf("%s:%d: Backhaul Steering Request send success\n", __func__, __LINE__);
+
+    return static_cast<int> (len);
+}
+
+int em_steering_t::send_bh_steering_rsp_msg(const em_bh_steering_req_t *req, unsigned char result)
+{
+    unsigned char buff[MAX_EM_BUFF_SZ];
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    unsigned short  msg_type = em_msg_type_bh_steering_rsp;
+    size_t len = 0;
+    em_cmdu_t *cmdu;
+    em_tlv_t *tlv;
+    em_bh_steering_resp_t *resp;
+    unsigned char *tmp = buff;
+    short sz = 0;
+    unsigned short type = htons(ETH_P_1905);
+    mac_address_t bsta;
+    dm_easy_mesh_t *dm = get_data_model();
+
+    memcpy(tmp, dm->get_ctrl_al_interface_mac(), sizeof(mac_address_t));
+    tmp += sizeof(mac_address_t);
+    len += sizeof(mac_address_t);
+
+    memcpy(tmp, dm->get_agent_al_interface_mac(), sizeof(mac_address_t));
+    tmp += sizeof(mac_address_t);
+    len += sizeof(mac_address_t);
+
+    memcpy(tmp, reinterpret_cast<unsigned char *> (&type), sizeof(unsigned short));
+    tmp += sizeof(unsigned short);
+    len += sizeof(unsigned short);
+
+    cmdu = reinterpret_cast<em_cmdu_t *> (tmp);
+
+    memset(tmp, 0, sizeof(em_cmdu_t));
+    cmdu->type = htons(msg_type);
+    cmdu->id = htons(get_mgr()->get_next_msg_id());
+    cmdu->last_frag_ind = 1;
+
+    tmp += sizeof(em_cmdu_t);
+    len += sizeof(em_cmdu_t);
+
+    // 17.2.33 Backhaul Steering Response TLV format
+    tlv = reinterpret_cast<em_tlv_t *> (tmp);
+    tlv->type = em_tlv_type_bh_steering_rsp;
+    resp = reinterpret_cast<em_bh_steering_resp_t *> (tlv->value);
+    memcpy(resp->bh_sta_mac_addr, req->bh_sta_mac_addr, sizeof(mac_address_t));
+    memcpy(resp->target_bssid, req->target_bssid, sizeof(resp->target_bssid));
+    resp->result_code = result;
+    tlv->len = htons(sizeof(em_bh_steering_resp_t));
+
+    tmp += (sizeof(em_tlv_t) + sizeof(em_bh_steering_resp_t));
+    len += (sizeof(em_tlv_t) + sizeof(em_bh_steering_resp_t));
+
+    // 17.2.36 Error Code TLV format, reason 0x07 backhaul steering request rejected
+    if (result != 0) {
+        memcpy(bsta, req->bh_sta_mac_addr, sizeof(mac_address_t));
+        tlv = reinterpret_cast<em_tlv_t *> (tmp);
+        tlv->type = em_tlv_type_error_code;
+        sz = create_error_code_tlv(tlv->value, 0x07, bsta);
+        tlv->len = htons(static_cast<short unsigned int> (sz));
+
+        tmp += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
+        len += (sizeof(em_tlv_t) + static_cast<size_t> (sz));
+    }
+
+    // End of message
+    tlv = reinterpret_cast<em_tlv_t *> (tmp);
+    tlv->type = em_tlv_type_eom;
+    tlv->len = 0;
+
+    tmp += (sizeof(em_tlv_t));
+    len += (sizeof(em_tlv_t));
+
+    if (em_msg_t(em_msg_type_bh_steering_rsp, em_profile_type_2, buff, static_cast<unsigned int> (len)).validate(errors) == 0) {
+        printf("%s:%d: Backhaul Steering Response validation failed\n", __func__, __LINE__);
+        return -1;
+    }
+
+    if (send_frame(buff, static_cast<unsigned int> (len))  < 0) {
+        printf("%s:%d: Backhaul Steering Response send failed, error:%d\n", __func__, __LINE__, errno);
+        return -1;
+    }
+
+    printf("%s:%d: Backhaul Steering Response send success\n", __func__, __LINE__);
+
+    return static_cast<int> (len);
+}
+
+void em_steering_t::request_bh_steer(const mac_address_t bsta, const bssid_t target, unsigned char op_class, unsigned char channel)
+{
+    pthread_mutex_lock(&m_bh_steer_lock);
+    memcpy(m_bh_steer_req.bh_sta_mac_addr, bsta, sizeof(mac_address_t));
+    memcpy(m_bh_steer_req.target_bssid, target, sizeof(m_bh_steer_req.target_bssid));
+    m_bh_steer_req.op_class = op_class;
+    m_bh_steer_req.channel_numb = channel;
+    m_bh_steer_requested = true;
+    pthread_mutex_unlock(&m_bh_steer_lock);
+}
+
+void em_steering_t::send_requested_bh_steer()
+{
+    em_bh_steering_req_t req;
+    dm_easy_mesh_t *dm = get_data_model();
+
+    if (m_bh_steer_requested.load() == false) {
+        return;
+    }
+
+    pthread_mutex_lock(&m_bh_steer_lock);
+    req = m_bh_steer_req;
+    m_bh_steer_requested = false;
+    pthread_mutex_unlock(&m_bh_steer_lock);
+
+    if (send_bh_steering_req_msg(&req) < 0) {
+        get_mgr()->get_bh_steer()->completed(dm->get_agent_al_interface_mac(), false, em_timer_wheel_t::get_time_ms(), NULL);
+    }
+}
+
 short em_steering_t::create_btm_request_tlv(unsigned char *buff)
 {
     size_t len = 0;
@@ -383,6 +588,40 @@ short em_steering_t::create_btm_request_tlv(unsigned char *buff)
     return static_cast<short> (len);
 }
 
+short em_steering_t::create_btm_request_batch_tlv(unsigned char *buff, const em_cmd_steer_batch_params_t *params)
+{
+    em_steering_req_t *req = reinterpret_cast<em_steering_req_t *> (buff);
+    unsigned char *tmp;
+    unsigned int i;
+
+    // the fields up to the STA List Count are the ones of a single STA request
+    memcpy(req->bssid, params->source, sizeof(bssid_t));
+    req->reserved = 0;
+    req->req_mode = static_cast<unsigned char>(params->request_mode) & 0x01;
+    req->btm_dissoc_imminent = params->disassoc_imminent;
+    req->btm_abridged = params->btm_abridged;
+    req->btm_link_removal_imminent = params->link_removal_imminent;
+    req->steering_opportunity_window = (params->request_mode == 1) ? 0:htons(static_cast<uint16_t> (params->steer_opportunity_win));
+    req->btm_dissoc_timer = htons(static_cast<uint16_t> (params->btm_disassociation_timer));
+    req->sta_list_count = static_cast<unsigned char> (params->num);
+
+    tmp = req->sta_mac_addr;
+    for (i = 0; i < params->num; i++) {
+        memcpy(tmp, params->entries[i].sta_mac, sizeof(mac_address_t));
+        tmp += sizeof(mac_address_t);
+    }
+
+    *tmp++ = static_cast<unsigned char> (params->num);
+    for (i = 0; i < params->num; i++) {
+        memcpy(tmp, params->entries[i].target, sizeof(bssid_t));
+        tmp += sizeof(bssid_t);
+        *tmp++ = static_cast<unsigned char> (params->entries[i].target_op_class);
+        *tmp++ = static_cast<unsigned char> (params->entries[i].target_channel);
+    }
+
+    return static_cast<short> (tmp - buff);
+}
+
 short em_steering_t::create_btm_report_tlv(unsigned char *buff)
 {
     short len = 0;
@@ -444,14 +683,60 @@ int em_steering_t::handle_client_steering_req(unsigned char *buff, unsigned int
 
     dm_easy_mesh_t::macbytes_to_string(steer_req->sta_mac_addr, mac_str);
     printf("%s:%d Recived steer req for sta=%s\n", __func__, __LINE__, mac_str);
-    
-	get_mgr()->io_process(em_bus_event_type_bss_tm_req, reinterpret_cast<unsigned char *> (steer_req), sizeof(em_steering_req_t));
+
+    if (steer_req->sta_list_count > 1) {
+        split_client_steering_req(tlv->value, htons(tlv->len));
+    } else {
+        get_mgr()->io_process(em_bus_event_type_bss_tm_req, reinterpret_cast<unsigned char *> (steer_req), sizeof(em_steering_req_t));
+    }
 
     send_1905_ack_message(steer_req->sta_mac_addr, ntohs(cmdu->id));
 
     return 0;
 }
 
+int em_steering_t::split_client_steering_req(const unsigned char *steer_req, unsigned int len)
+{
+    const em_steering_req_t *hdr = reinterpret_cast<const em_steering_req_t *> (steer_req);
+    const unsigned char *stas, *targets, *target;
+    unsigned int i, num_stas, num_targets;
+    size_t stas_off = offsetof(em_steering_req_t, sta_mac_addr);
+    const size_t target_sz = sizeof(bssid_t) + 2;
+    em_steering_req_t req;
+
+    if (len <= stas_off) {
+        return -1;
+    }
+    num_stas = hdr->sta_list_count;
+    if (len < stas_off + num_stas * sizeof(mac_address_t) + 1) {
+        printf("%s:%d: Steering Request TLV too short for %d STAs\n", __func__, __LINE__, num_stas);
+        return -1;
+    }
+    stas = steer_req + stas_off;
+    num_targets = stas[num_stas * sizeof(mac_address_t)];
+    targets = stas + num_stas * sizeof(mac_address_t) + 1;
+    // one target for all the STAs or one per STA
+    if (((num_targets != 1) && (num_targets != num_stas)) ||
+            (len < static_cast<size_t> (targets - steer_req) + num_targets * target_sz)) {
+        printf("%s:%d: Steering Request TLV with %d STAs and %d targets is invalid\n", __func__, __LINE__, num_stas, num_targets);
+        return -1;
+    }
+
+    memcpy(&req, hdr, stas_off);
+    req.sta_list_count = 1;
+    req.target_bssid_list_count = 1;
+    for (i = 0; i < num_stas; i++) {
+        target = targets + ((num_targets == 1) ? 0:i) * target_sz;
+        memcpy(req.sta_mac_addr, stas + i * sizeof(mac_address_t), sizeof(mac_address_t));
+        memcpy(req.target_bssids, target, sizeof(bssid_t));
+        req.target_bss_op_class = target[sizeof(bssid_t)];
+        req.target_bss_channel_num = target[sizeof(bssid_t) + 1];
+        get_mgr()->io_process(em_bus_event_type_bss_tm_req, reinterpret_cast<unsigned char *> (&req), sizeof(em_steering_req_t));
+    }
+
+    return static_cast<int> (num_stas);
+}
+
 int em_steering_t::handle_client_steering_report(unsigned char *buff, unsigned int len)
 {
     em_tlv_t *tlv;
@@ -470,6 +755,8 @@ int em_steering_t::handle_client_steering_report(unsigned char *buff, unsigned i
     mac_addr_str_t mac_str;
     dm_easy_mesh_t::macbytes_to_string(btm_rprt->sta_mac_addr, mac_str);
     printf("%s:%d Client BTM Report for sta %s, status %d\n", __func__, __LINE__, mac_str, btm_rprt->btm_status_code);
+    get_mgr()->get_steer_outcomes()->report(btm_rprt->sta_mac_addr, btm_rprt->btm_status_code, btm_rprt->target_bssid,
+        em_timer_wheel_t::get_time_ms());
 
     set_state(em_state_ctrl_configured);
 
@@ -479,8 +766,163 @@ int em_steering_t::handle_client_steering_report(unsigned char *buff, unsigned i
     return 0;
 }
 
+int em_steering_t::handle_bh_steering_req(unsigned char *buff, unsigned int len)
+{
+    em_tlv_t *tlv;
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    em_bh_steering_req_t req;
+    em_bss_info_t *bsta_info;
+    bssid_t target, current;
+    mac_addr_str_t bsta_str, target_str;
+    unsigned char result = 1;
+
+    if (em_msg_t(em_msg_type_bh_steering_req, em_profile_type_2, buff, len).validate(errors) == 0) {
+        printf("%s:%d:Backhaul Steering Request message validation failed\n",__func__,__LINE__);
+        return -1;
+    }
+
+    tlv = reinterpret_cast<em_tlv_t *> (buff + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
+    if ((tlv->type != em_tlv_type_bh_steering_req) || (htons(tlv->len) < sizeof(em_bh_steering_req_t))) {
+        return -1;
+    }
+    memcpy(&req, tlv->value, sizeof(em_bh_steering_req_t));
+    memcpy(target, req.target_bssid, sizeof(bssid_t));
+
+    dm_easy_mesh_t::macbytes_to_string(req.bh_sta_mac_addr, bsta_str);
+    dm_easy_mesh_t::macbytes_to_string(target, target_str);
+    printf("%s:%d Received backhaul steer of bsta=%s to %s\n", __func__, __LINE__, bsta_str, target_str);
+
+    // make before break as far as OneWifi lets us: only the bSTA is reconfigured, the ems
+    // stay configured, and a failed move puts the bSTA back on the BSS it was on
+    if (((bsta_info = get_data_model()->get_bsta_bss_info()) != NULL) &&
+            ((memcmp(bsta_info->sta_mac, req.bh_sta_mac_addr, sizeof(mac_address_t)) == 0) ||
+            (memcmp(bsta_info->id.bssid, req.bh_sta_mac_addr, sizeof(mac_address_t)) == 0))) {
+        std::string ssid(bsta_info->ssid);
+        std::string passphrase(bsta_info->mesh_sta_passphrase);
+
+        memcpy(current, bsta_info->bssid.mac, sizeof(bssid_t));
+        if (bsta_connect_bss(ssid, passphrase, target) == true) {
+            result = 0;
+        } else {
+            printf("%s:%d Backhaul steer to %s failed, back to the current BSS\n", __func__, __LINE__, target_str);
+            bsta_connect_bss(ssid, passphrase, current);
+        }
+    } else {
+        printf("%s:%d bsta=%s is not the backhaul STA of this agent\n", __func__, __LINE__, bsta_str);
+    }
+
+    send_bh_steering_rsp_msg(&req, result);
+
+    return 0;
+}
+
+int em_steering_t::handle_bh_steering_rsp(unsigned char *buff, unsigned int len)
+{
+    em_tlv_t *tlv;
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    em_bh_steering_resp_t *resp = NULL;
+    unsigned int tlvs_len;
+    unsigned long long latency_ms = 0, now = em_timer_wheel_t::get_time_ms();
+    dm_easy_mesh_t *dm = get_data_model();
+    bool success;
+
+    if (em_msg_t(em_msg_type_bh_steering_rsp, em_profile_type_2, buff, len).validate(errors) == 0) {
+        printf("%s:%d:Backhaul Steering Response message validation failed\n",__func__,__LINE__);
+        return -1;
+    }
+
+    tlv = reinterpret_cast<em_tlv_t *> (buff + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
+    tlvs_len = len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
+
+    while ((tlv->type != em_tlv_type_eom) && (tlvs_len >= sizeof(em_tlv_t) + htons(tlv->len))) {
+        if ((tlv->type == em_tlv_type_bh_steering_rsp) && (htons(tlv->len) >= sizeof(em_bh_steering_resp_t))) {
+            resp = reinterpret_cast<em_bh_steering_resp_t *> (tlv->value);
+        }
+        tlvs_len -= static_cast<unsigned int> (sizeof(em_tlv_t) + htons(tlv->len));
+        tlv = reinterpret_cast<em_tlv_t *> (reinterpret_cast<unsigned char *> (tlv) + sizeof(em_tlv_t) + htons(tlv->len));
+    }
+
+    success = (resp != NULL) && (resp->result_code == 0);
+    if (get_mgr()->get_bh_steer()->completed(dm->get_agent_al_interface_mac(), success, now, &latency_ms) == false) {
+        return 0;
+    }
+
+    printf("%s:%d Backhaul steer %s in %llu ms\n", __func__, __LINE__, (success == true) ? "completed":"failed", latency_ms);
+
+    // the agent has a new parent, its Topology Response tells the controller which
+    get_mgr()->get_topo_sched()->notified(dm->get_agent_al_interface_mac(), now);
+
+    return 0;
+}
+
+int em_steering_t::handle_client_assoc_ctrl_req(unsigned char *buff, unsigned int len)
+{
+    em_tlv_t *tlv;
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    em_cmdu_t *cmdu = reinterpret_cast<em_cmdu_t *> (buff + sizeof(em_raw_hdr_t));
+    const unsigned char *value, *sta;
+    unsigned char ctrl, count, i;
+    unsigned short validity;
+    unsigned int tlv_len;
+    unsigned long long now = em_timer_wheel_t::get_time_ms();
+    em_blocklist_t *blocklist = get_mgr()->get_blocklist();
+    mac_address_t ack_sta = {0};
+    mac_addr_str_t bssid_str;
+
+    if (em_msg_t(em_msg_type_client_assoc_ctrl_req, em_profile_type_3, buff, len).validate(errors) == 0) {
+        printf("%s:%d: Client Assoc Control Request message validation failed\n", __func__, __LINE__);
+        return -1;
+    }
+
+    // 17.2.31 Client Association Control Request TLV: BSSID, control, validity period, STA list
+    tlv = reinterpret_cast<em_tlv_t *> (buff + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
+    tlv_len = ntohs(tlv->len);
+    if (tlv_len < offsetof(em_client_assoc_ctrl_req_t, sta_mac)) {
+        printf("%s:%d: Client Assoc Control Request TLV too short: %d\n", __func__, __LINE__, tlv_len);
+        return -1;
+    }
+    value = tlv->value;
+    ctrl = value[offsetof(em_client_assoc_ctrl_req_t, assoc_control)];
+    memcpy(&validity, &value[offsetof(em_client_assoc_ctrl_req_t, validity_period)], sizeof(unsigned short));
+    validity = ntohs(validity);
+    count = value[offsetof(em_client_assoc_ctrl_req_t, count)];
+    if (tlv_len < offsetof(em_client_assoc_ctrl_req_t, sta_mac) + count * sizeof(mac_address_t)) {
+        printf("%s:%d: Client Assoc Control Request TLV truncated, %d STAs\n", __func__, __LINE__, count);
+        return -1;
+    }
+
+    sta = &value[offsetof(em_client_assoc_ctrl_req_t, sta_mac)];
+    for (i = 0; i < count; i++, sta += sizeof(mac_address_t)) {
+        // 0x00 block and 0x02 timed block for the validity period, 0x01 unblock, 0x03 indefinite block
+        if (ctrl == 0x01) {
+            blocklist->unblock(sta, value);
+        } else if (blocklist->block(sta, value, (ctrl == 0x03) ? 0:(static_cast<unsigned int> (validity) * 1000), now) != 0) {
+            printf("%s:%d: Blocklist full, STA %d not blocked\n", __func__, __LINE__, i);
+        }
+    }
+
+    dm_easy_mesh_t::macbytes_to_string(const_cast<unsigned char *> (value), bssid_str);
+    printf("%s:%d: Client Assoc Control %d for %d STAs on %s, %d blocked\n", __func__, __LINE__,
+        ctrl, count, bssid_str, blocklist->count());
+
+    if (count != 0) {
+        memcpy(ack_sta, &value[offsetof(em_client_assoc_ctrl_req_t, sta_mac)], sizeof(mac_address_t));
+    }
+    send_1905_ack_message(ack_sta, ntohs(cmdu->id));
+
+    return 0;
+}
+
 int em_steering_t::handle_ack_msg(unsigned char *buff, unsigned int len)
 {
+    em_raw_hdr_t *hdr = reinterpret_cast<em_raw_hdr_t *> (buff);
+    em_cmdu_t *cmdu = reinterpret_cast<em_cmdu_t *> (buff + sizeof(em_raw_hdr_t));
+
+    // the ACK of a Multi-AP Policy Config Request leaves the steering state alone
+    if (get_mgr()->get_policy_push()->ack(hdr->src, ntohs(cmdu->id), em_timer_wheel_t::get_time_ms()) == true) {
+        return 0;
+    }
+    get_mgr()->get_steer_outcomes()->ack(hdr->src, ntohs(cmdu->id), em_timer_wheel_t::get_time_ms());
     set_state(em_state_ctrl_steer_btm_req_ack_rcvd);
     return 0;
 }
@@ -526,6 +968,18 @@ void em_steering_t::process_msg(unsigned char *data, unsigned int len)
             handle_client_steering_report(data, len);
             break;
 
+        case em_msg_type_client_assoc_ctrl_req:
+            handle_client_assoc_ctrl_req(data, len);
+            break;
+
+        case em_msg_type_bh_steering_req:
+            handle_bh_steering_req(data, len);
+            break;
+
+        case em_msg_type_bh_steering_rsp:
+            handle_bh_steering_rsp(data, len);
+            break;
+
         case em_msg_type_1905_ack:
             handle_ack_msg(data, len);
 
@@ -538,9 +992,12 @@ em_steering_t::em_steering_t()
 {
     m_client_steering_req_tx_cnt = 0;
     m_client_assoc_ctrl_req_tx_cnt = 0;
+    memset(&m_bh_steer_req, 0, sizeof(m_bh_steer_req));
+    m_bh_steer_requested = false;
+    pthread_mutex_init(&m_bh_steer_lock, NULL);
 }
 
 em_steering_t::~em_steering_t()
 {
-
+    pthread_mutex_destroy(&m_bh_steer_lock);
 }
@@ -0,0 +1,83 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "em_chan_plan_optimiser.h"
+
+void em_chan_plan_optimiser_t::radio_changed(const em_optimiser_radio_t *radio)
+{
+    std::unordered_map<em_packed_mac_t, em_chan_plan_proposal_t>::iterator it;
+
+    if (radio->num_channels == 0) {
+        m_planner.set_current(radio->ruid, radio->current);
+    } else {
+        m_planner.set_radio(radio->ruid, radio->op_class, radio->channels, radio->prefs, radio->num_channels, radio->current);
+    }
+
+    // the radio moved, where it was proposed or elsewhere, either way the proposal is done
+    if (((it = m_proposed.find(em_hex::pack_mac(radio->ruid))) != m_proposed.end()) && (radio->current != it->second.from)) {
+        m_proposed.erase(it);
+    }
+}
+
+unsigned int em_chan_plan_optimiser_t::optimise(unsigned long long now, unsigned long long budget_us,
+                                                em_optimiser_action_t *actions, unsigned int max)
+{
+    em_chan_planner_change_t changes[EM_OPTIMISER_MAX_ACTIONS];
+    unsigned long long truncated = m_planner.get_stats().truncated;
+    unsigned int i, num, count = 0;
+    em_packed_mac_t key;
+
+    m_planner.plan(false, budget_us);
+
+    // a plan cut short is half way, it goes on in the next cycle
+    if (m_planner.get_stats().truncated != truncated) {
+        return 0;
+    }
+
+    num = m_planner.get_changes(changes, (max < EM_OPTIMISER_MAX_ACTIONS) ? max:EM_OPTIMISER_MAX_ACTIONS);
+    for (i = 0; i < num; i++) {
+        key = em_hex::pack_mac(changes[i].ruid);
+        auto it = m_proposed.find(key);
+        if ((it != m_proposed.end()) && (it->second.channel == changes[i].channel)) {
+            continue;
+        }
+        m_proposed[key] = {changes[i].current, changes[i].channel};
+
+        memset(&actions[count], 0, sizeof(em_optimiser_action_t));
+        actions[count].type = em_optimiser_action_channel;
+        actions[count].score = changes[i].gain;
+        memcpy(actions[count].ruid, changes[i].ruid, sizeof(mac_address_t));
+        actions[count].op_class = changes[i].op_class;
+        actions[count].channel = changes[i].channel;
+        count++;
+    }
+
+    return count;
+}
+
+em_chan_plan_optimiser_t::em_chan_plan_optimiser_t()
+{
+
+}
+
+em_chan_plan_optimiser_t::~em_chan_plan_optimiser_t()
+{
+
+}
@@ -0,0 +1,443 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include "em_chan_planner.h"
+
+static inline unsigned long long mac_key(const unsigned char *mac)
+{
+    unsigned long long key = 0;
+
+    memcpy(&key, mac, sizeof(mac_address_t));
+
+    return key;
+}
+
+unsigned long long em_chan_planner_t::now_us()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return static_cast<unsigned long long>(ts.tv_sec) * 1000000 + static_cast<unsigned long long>(ts.tv_nsec / 1000);
+}
+
+em_chan_planner_band_t em_chan_planner_t::get_band(unsigned char op_class)
+{
+    if ((op_class >= 81) && (op_class <= 84)) {
+        return em_chan_planner_band_2g;
+    } else if ((op_class >= 131) && (op_class <= 137)) {
+        return em_chan_planner_band_6g;
+    }
+
+    return em_chan_planner_band_5g;
+}
+
+unsigned int em_chan_planner_t::get_overlap(em_chan_planner_band_t band, unsigned char a, unsigned char b)
+{
+    unsigned int dist = (a > b) ? static_cast<unsigned int>(a - b):static_cast<unsigned int>(b - a);
+
+    if (band == em_chan_planner_band_2g) {
+        return (dist >= 5) ? 0:(5 - dist) * 20;
+    }
+
+    return (dist == 0) ? 100:0;
+}
+
+unsigned int em_chan_planner_t::get_signal_weight(signed char signal_strength)
+{
+    int weight = static_cast<int>(signal_strength) + 100;
+
+    if (weight < 0) {
+        return 0;
+    }
+
+    return (weight > 100) ? 100:static_cast<unsigned int>(weight);
+}
+
+em_chan_planner_node_t *em_chan_planner_t::find_node(const unsigned char *ruid)
+{
+    auto it = m_radios.find(mac_key(ruid));
+
+    return (it == m_radios.end()) ? NULL:&m_nodes[it->second];
+}
+
+const em_chan_planner_channel_t *em_chan_planner_t::get_channel_entry(const em_chan_planner_node_t *node, unsigned char channel)
+{
+    unsigned int i;
+
+    for (i = 0; i < node->num_channels; i++) {
+        if (node->channels[i].channel == channel) {
+            return &node->channels[i];
+        }
+    }
+
+    return NULL;
+}
+
+int em_chan_planner_t::set_radio(const unsigned char *ruid, unsigned char op_class, const unsigned char *channels,
+                                 const unsigned char *prefs, unsigned int num, unsigned char current)
+{
+    em_chan_planner_node_t *node;
+    unsigned int i;
+
+    if (num > EM_CHAN_PLANNER_MAX_CHANNELS) {
+        return -1;
+    }
+
+    if ((node = find_node(ruid)) == NULL) {
+        m_radios[mac_key(ruid)] = static_cast<unsigned int>(m_nodes.size());
+        m_nodes.emplace_back();
+        node = &m_nodes.back();
+        memcpy(node->ruid, ruid, sizeof(mac_address_t));
+        node->channel = 0;
+    }
+
+    node->op_class = op_class;
+    node->band = get_band(op_class);
+    node->current = current;
+    node->num_channels = 0;
+    for (i = 0; i < num; i++) {
+        if (prefs[i] == 0) {
+            continue;
+        }
+        node->channels[node->num_channels].channel = channels[i];
+        node->channels[node->num_channels].pref = (prefs[i] > EM_CHAN_PLANNER_MAX_PREF) ? EM_CHAN_PLANNER_MAX_PREF:prefs[i];
+        node->channels[node->num_channels].ext_cost = 0;
+        node->num_channels++;
+    }
+    node->dirty = true;
+
+    return 0;
+}
+
+int em_chan_planner_t::set_current(const unsigned char *ruid, unsigned char current)
+{
+    em_chan_planner_node_t *node;
+
+    if ((node = find_node(ruid)) == NULL) {
+        return -1;
+    }
+    if (node->current != current) {
+        node->current = current;
+        node->dirty = true;
+    }
+
+    return 0;
+}
+
+int em_chan_planner_t::add_bss(const unsigned char *bssid, const unsigned char *ruid)
+{
+    auto it = m_radios.find(mac_key(ruid));
+
+    if (it == m_radios.end()) {
+        return -1;
+    }
+    m_bss[mac_key(bssid)] = it->second;
+
+    return 0;
+}
+
+void em_chan_planner_t::set_edge(unsigned int a, unsigned int b, unsigned int weight)
+{
+    em_chan_planner_node_t *node = &m_nodes[a], *peer = &m_nodes[b];
+    unsigned int i;
+
+    for (i = 0; i < node->edges.size(); i++) {
+        if (node->edges[i].peer != b) {
+            continue;
+        }
+        if (node->edges[i].weight >= weight) {
+            return;
+        }
+        node->edges[i].weight = weight;
+        for (auto& e : peer->edges) {
+            if (e.peer == a) {
+                e.weight = weight;
+                break;
+            }
+        }
+        node->dirty = true;
+        peer->dirty = true;
+        return;
+    }
+
+    node->edges.push_back({b, weight});
+    peer->edges.push_back({a, weight});
+    node->dirty = true;
+    peer->dirty = true;
+}
+
+int em_chan_planner_t::add_scan_result(const em_scan_result_t *res)
+{
+    em_chan_planner_node_t *node;
+    em_chan_planner_channel_t *ch;
+    unsigned int i, num, idx, ext_cost = 0;
+    int raised = 0;
+
+    if ((node = find_node(res->id.scanner_mac)) == NULL) {
+        return -1;
+    }
+    if (get_band(res->id.op_class) != node->band) {
+        return 0;
+    }
+    idx = m_radios[mac_key(res->id.scanner_mac)];
+
+    num = (res->num_neighbors > EM_MAX_NEIGHBORS) ? EM_MAX_NEIGHBORS:res->num_neighbors;
+    for (i = 0; i < num; i++) {
+        auto it = m_bss.find(mac_key(res->neighbor[i].bssid));
+        if (it == m_bss.end()) {
+            ext_cost += get_signal_weight(res->neighbor[i].signal_strength);
+            continue;
+        }
+        // its own BSSs, or a mesh radio of another band heard through a leak
+        if ((it->second == idx) || (m_nodes[it->second].band != m_nodes[idx].band)) {
+            continue;
+        }
+        set_edge(idx, it->second, get_signal_weight(res->neighbor[i].signal_strength));
+        raised++;
+    }
+
+    // set_edge() may have grown the nodes' edges, not the nodes
+    node = &m_nodes[idx];
+    ch = const_cast<em_chan_planner_channel_t *>(get_channel_entry(node, res->id.channel));
+    if ((ch != NULL) && (ch->ext_cost != ext_cost)) {
+        ch->ext_cost = ext_cost;
+        node->dirty = true;
+    }
+
+    return raised;
+}
+
+unsigned long long em_chan_planner_t::channel_cost(unsigned int node, const em_chan_planner_channel_t *ch)
+{
+    em_chan_planner_node_t *n = &m_nodes[node], *peer;
+    unsigned long long cost;
+
+    cost = static_cast<unsigned long long>(EM_CHAN_PLANNER_MAX_PREF - ch->pref) * m_params.pref_weight + ch->ext_cost;
+    if ((n->current != 0) && (ch->channel != n->current)) {
+        cost += m_params.switch_cost;
+    }
+
+    for (const auto& e : n->edges) {
+        peer = &m_nodes[e.peer];
+        if ((peer->channel == 0) || (peer->band != n->band)) {
+            continue;
+        }
+        cost += e.weight * get_overlap(n->band, ch->channel, peer->channel) / 100;
+    }
+
+    return cost;
+}
+
+const em_chan_planner_channel_t *em_chan_planner_t::best_channel(unsigned int node, unsigned long long *cost)
+{
+    em_chan_planner_node_t *n = &m_nodes[node];
+    const em_chan_planner_channel_t *best = NULL;
+    unsigned long long c;
+    unsigned int i;
+
+    for (i = 0; i < n->num_channels; i++) {
+        c = channel_cost(node, &n->channels[i]);
+        if ((best == NULL) || (c < *cost)) {
+            best = &n->channels[i];
+            *cost = c;
+        }
+    }
+
+    return best;
+}
+
+unsigned int em_chan_planner_t::plan(bool full, unsigned long long budget_us)
+{
+    std::vector<unsigned char> prev(m_nodes.size());
+    std::vector<unsigned int> order, work, moves(m_nodes.size(), 0);
+    std::vector<bool> queued(m_nodes.size(), false);
+    std::vector<unsigned long long> load(m_nodes.size(), 0);
+    const em_chan_planner_channel_t *best, *cur;
+    unsigned long long start = now_us(), elapsed, best_cost = 0, cur_cost;
+    unsigned int i, u, head, changed = 0, evaluated = 0;
+    bool truncated = false;
+
+    for (i = 0; i < m_nodes.size(); i++) {
+        prev[i] = m_nodes[i].channel;
+        if (full == true) {
+            m_nodes[i].channel = 0;
+        }
+        if ((m_nodes[i].channel != 0) && (get_channel_entry(&m_nodes[i], m_nodes[i].channel) == NULL)) {
+            m_nodes[i].channel = 0;
+        }
+        if (m_nodes[i].channel == 0) {
+            for (const auto& e : m_nodes[i].edges) {
+                load[i] += e.weight;
+            }
+            order.push_back(i);
+        }
+        if ((full == true) || (m_nodes[i].dirty == true) || (m_nodes[i].channel == 0)) {
+            work.push_back(i);
+            queued[i] = true;
+        }
+    }
+
+    // greedy coloring of the unplanned radios, the most interfered first
+    std::stable_sort(order.begin(), order.end(), [&load](unsigned int a, unsigned int b) { return load[a] > load[b]; });
+    for (auto n : order) {
+        if ((budget_us != 0) && (evaluated > 0) && ((evaluated % 16) == 0) && ((now_us() - start) >= budget_us)) {
+            truncated = true;
+            break;
+        }
+        if ((best = best_channel(n, &best_cost)) != NULL) {
+            m_nodes[n].channel = best->channel;
+        }
+        evaluated++;
+    }
+
+    // local search, a radio whose channel changed requeues its peers
+    for (head = 0; (truncated == false) && (head < work.size()); head++) {
+        if ((budget_us != 0) && (evaluated > 0) && ((evaluated % 16) == 0) && ((now_us() - start) >= budget_us)) {
+            truncated = true;
+            break;
+        }
+        u = work[head];
+        queued[u] = false;
+        evaluated++;
+        if ((m_nodes[u].channel == 0) || (moves[u] >= m_params.max_moves)) {
+            continue;
+        }
+        cur = get_channel_entry(&m_nodes[u], m_nodes[u].channel);
+        cur_cost = channel_cost(u, cur);
+        if (((best = best_channel(u, &best_cost)) == NULL) || (best_cost >= cur_cost)) {
+            continue;
+        }
+        m_nodes[u].channel = best->channel;
+        moves[u]++;
+        m_stats.moves++;
+        for (const auto& e : m_nodes[u].edges) {
+            if ((queued[e.peer] == false) && (m_nodes[e.peer].band == m_nodes[u].band)) {
+                work.push_back(e.peer);
+                queued[e.peer] = true;
+            }
+        }
+    }
+
+    // the radios still queued are where the next plan goes on
+    for (i = 0; i < m_nodes.size(); i++) {
+        m_nodes[i].dirty = queued[i];
+        if (m_nodes[i].channel != prev[i]) {
+            changed++;
+        }
+    }
+
+    m_stats.plans++;
+    if (truncated == true) {
+        m_stats.truncated++;
+    }
+    m_stats.last_evaluated = evaluated;
+    m_stats.last_cost = get_cost();
+    elapsed = now_us() - start;
+    m_stats.last_plan_us = elapsed;
+    if (elapsed > m_stats.max_plan_us) {
+        m_stats.max_plan_us = elapsed;
+    }
+
+    return changed;
+}
+
+unsigned char em_chan_planner_t::get_channel(const unsigned char *ruid)
+{
+    em_chan_planner_node_t *node = find_node(ruid);
+
+    return (node == NULL) ? 0:node->channel;
+}
+
+unsigned int em_chan_planner_t::get_changes(em_chan_planner_change_t *changes, unsigned int max)
+{
+    const em_chan_planner_channel_t *cur, *planned;
+    unsigned long long cur_cost, planned_cost;
+    em_chan_planner_node_t *n;
+    unsigned int i, num = 0;
+
+    for (i = 0; (i < m_nodes.size()) && (num < max); i++) {
+        n = &m_nodes[i];
+        if ((n->channel == 0) || (n->current == 0) || (n->channel == n->current) ||
+                ((planned = get_channel_entry(n, n->channel)) == NULL)) {
+            continue;
+        }
+        planned_cost = channel_cost(i, planned);
+        if ((cur = get_channel_entry(n, n->current)) != NULL) {
+            if ((cur_cost = channel_cost(i, cur)) <= planned_cost) {
+                continue;
+            }
+        } else {
+            // off a channel that is no longer operable, as costly as the worst preference
+            cur_cost = planned_cost + static_cast<unsigned long long>(EM_CHAN_PLANNER_MAX_PREF) * m_params.pref_weight;
+        }
+        memcpy(changes[num].ruid, n->ruid, sizeof(mac_address_t));
+        changes[num].op_class = n->op_class;
+        changes[num].current = n->current;
+        changes[num].channel = n->channel;
+        changes[num].gain = cur_cost - planned_cost;
+        num++;
+    }
+
+    return num;
+}
+
+unsigned long long em_chan_planner_t::get_cost()
+{
+    const em_chan_planner_channel_t *ch;
+    em_chan_planner_node_t *n;
+    unsigned long long cost = 0;
+    unsigned int i;
+
+    for (i = 0; i < m_nodes.size(); i++) {
+        n = &m_nodes[i];
+        if ((n->channel == 0) || ((ch = get_channel_entry(n, n->channel)) == NULL)) {
+            continue;
+        }
+        cost += static_cast<unsigned long long>(EM_CHAN_PLANNER_MAX_PREF - ch->pref) * m_params.pref_weight + ch->ext_cost;
+        if ((n->current != 0) && (n->channel != n->current)) {
+            cost += m_params.switch_cost;
+        }
+        for (const auto& e : n->edges) {
+            if ((e.peer > i) && (m_nodes[e.peer].channel != 0) && (m_nodes[e.peer].band == n->band)) {
+                cost += e.weight * get_overlap(n->band, n->channel, m_nodes[e.peer].channel) / 100;
+            }
+        }
+    }
+
+    return cost;
+}
+
+em_chan_planner_t::em_chan_planner_t()
+{
+    memset(&m_params, 0, sizeof(m_params));
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    m_params.pref_weight = 4;
+    m_params.switch_cost = 20;
+    m_params.max_moves = 16;
+}
+
+em_chan_planner_t::~em_chan_planner_t()
+{
+
+}
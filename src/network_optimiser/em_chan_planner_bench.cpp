@@ -0,0 +1,179 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include "em_chan_planner.h"
+
+#define EM_CHAN_PLANNER_BENCH_AREA      60.0    // side of the square, in meters
+#define EM_CHAN_PLANNER_BENCH_FOREIGN   8       // foreign BSSs, each heard by the radios close to it
+
+typedef struct {
+    double  x;
+    double  y;
+} em_chan_planner_bench_pos_t;
+
+static unsigned int bench_rand(unsigned int *state)
+{
+    *state = *state * 1103515245u + 12345u;
+
+    return (*state >> 16) & 0x7fff;
+}
+
+static void bench_mac(unsigned int n, unsigned char kind, unsigned char *mac)
+{
+    memset(mac, 0, sizeof(mac_address_t));
+    mac[0] = 0x02;
+    mac[1] = kind;
+    mac[4] = static_cast<unsigned char>(n >> 8);
+    mac[5] = static_cast<unsigned char>(n);
+}
+
+// log distance path loss at 2.4 GHz, 20 dBm transmit power
+static signed char bench_signal(const em_chan_planner_bench_pos_t *a, const em_chan_planner_bench_pos_t *b, int jitter)
+{
+    double dist = sqrt((a->x - b->x) * (a->x - b->x) + (a->y - b->y) * (a->y - b->y)) + 1.0;
+    double rssi = 20.0 - 40.0 - 35.0 * log10(dist) + jitter;
+
+    return static_cast<signed char>((rssi < -127.0) ? -127.0:rssi);
+}
+
+// the strongest radios and foreign BSSs a radio hears on a channel, as in a Channel Scan Result
+static void bench_scan(unsigned int node, unsigned char channel, const std::vector<em_chan_planner_bench_pos_t>& pos,
+                       const std::vector<em_chan_planner_bench_pos_t>& foreign, const std::vector<unsigned char>& foreign_channel,
+                       int jitter, em_scan_result_t *res)
+{
+    std::vector<em_neighbor_t> heard;
+    em_neighbor_t nbr;
+    unsigned int i;
+
+    memset(res, 0, sizeof(em_scan_result_t));
+    bench_mac(node, 0, res->id.scanner_mac);
+    res->id.op_class = 81;
+    res->id.channel = channel;
+
+    memset(&nbr, 0, sizeof(nbr));
+    for (i = 0; (channel == 6) && (i < pos.size()); i++) {
+        if (i == node) {
+            continue;
+        }
+        nbr.signal_strength = bench_signal(&pos[node], &pos[i], jitter);
+        if (nbr.signal_strength > -95) {
+            bench_mac(i, 1, nbr.bssid);
+            heard.push_back(nbr);
+        }
+    }
+    for (i = 0; i < foreign.size(); i++) {
+        if (foreign_channel[i] != channel) {
+            continue;
+        }
+        nbr.signal_strength = bench_signal(&pos[node], &foreign[i], 0);
+        if (nbr.signal_strength > -95) {
+            bench_mac(i, 2, nbr.bssid);
+            heard.push_back(nbr);
+        }
+    }
+
+    std::sort(heard.begin(), heard.end(), [](const em_neighbor_t& a, const em_neighbor_t& b) { return a.signal_strength > b.signal_strength; });
+    for (i = 0; (i < heard.size()) && (i < EM_MAX_NEIGHBORS); i++) {
+        res->neighbor[i] = heard[i];
+    }
+    res->num_neighbors = static_cast<unsigned short>(i);
+}
+
+static void bench_setup(em_chan_planner_t *planner, unsigned int num_nodes, const std::vector<em_chan_planner_bench_pos_t>& pos,
+                        const std::vector<em_chan_planner_bench_pos_t>& foreign, const std::vector<unsigned char>& foreign_channel)
+{
+    unsigned char channels[11], prefs[11], ruid[6], bssid[6];
+    unsigned char scan_channels[] = {1, 6, 11};
+    em_scan_result_t res;
+    unsigned int i, j;
+
+    for (i = 0; i < 11; i++) {
+        channels[i] = static_cast<unsigned char>(i + 1);
+        prefs[i] = ((channels[i] == 1) || (channels[i] == 6) || (channels[i] == 11)) ? EM_CHAN_PLANNER_MAX_PREF:10;
+    }
+    for (i = 0; i < num_nodes; i++) {
+        bench_mac(i, 0, ruid);
+        bench_mac(i, 1, bssid);
+        planner->set_radio(ruid, 81, channels, prefs, 11, 6);
+        planner->add_bss(bssid, ruid);
+    }
+    for (i = 0; i < num_nodes; i++) {
+        for (j = 0; j < sizeof(scan_channels); j++) {
+            bench_scan(i, scan_channels[j], pos, foreign, foreign_channel, 0, &res);
+            planner->add_scan_result(&res);
+        }
+    }
+}
+
+void em_chan_planner_t::benchmark(unsigned int num_nodes, unsigned int seed)
+{
+    std::vector<em_chan_planner_bench_pos_t> pos(num_nodes), foreign(EM_CHAN_PLANNER_BENCH_FOREIGN);
+    std::vector<unsigned char> foreign_channel(EM_CHAN_PLANNER_BENCH_FOREIGN);
+    em_chan_planner_t planner, baseline;
+    em_chan_planner_params_t params;
+    em_scan_result_t res;
+    unsigned long long total_us = 0, max_us = 0;
+    unsigned int i, changed, total_changed = 0, state = seed;
+
+    for (i = 0; i < num_nodes; i++) {
+        pos[i].x = EM_CHAN_PLANNER_BENCH_AREA * bench_rand(&state) / 0x7fff;
+        pos[i].y = EM_CHAN_PLANNER_BENCH_AREA * bench_rand(&state) / 0x7fff;
+    }
+    for (i = 0; i < EM_CHAN_PLANNER_BENCH_FOREIGN; i++) {
+        foreign[i].x = EM_CHAN_PLANNER_BENCH_AREA * bench_rand(&state) / 0x7fff;
+        foreign[i].y = EM_CHAN_PLANNER_BENCH_AREA * bench_rand(&state) / 0x7fff;
+        foreign_channel[i] = (bench_rand(&state) % 2 == 0) ? 1:11;
+    }
+
+    // switching is never worth it, every radio stays on channel 6
+    params = baseline.get_params();
+    params.switch_cost = 1000000;
+    baseline.set_params(&params);
+    bench_setup(&baseline, num_nodes, pos, foreign, foreign_channel);
+    baseline.plan(true);
+
+    bench_setup(&planner, num_nodes, pos, foreign, foreign_channel);
+    changed = planner.plan(true);
+    printf("%s:%d: %u radios, cost on channel 6: %llu, full plan: %llu in %llu us, %u radios planned, %llu moves\n",
+        __func__, __LINE__, num_nodes, baseline.get_stats().last_cost, planner.get_stats().last_cost,
+        planner.get_stats().last_plan_us, changed, planner.get_stats().moves);
+
+    // a new scan of one radio at a time, the signals a few dB off
+    for (i = 0; i < num_nodes; i++) {
+        bench_scan(i, 6, pos, foreign, foreign_channel, static_cast<int>(bench_rand(&state) % 7) - 3, &res);
+        planner.add_scan_result(&res);
+        total_changed += planner.plan(false);
+        total_us += planner.get_stats().last_plan_us;
+        if (planner.get_stats().last_plan_us > max_us) {
+            max_us = planner.get_stats().last_plan_us;
+        }
+    }
+    printf("%s:%d: %u incremental plans: avg %llu us, max %llu us, %u channel changes, cost: %llu\n",
+        __func__, __LINE__, num_nodes, total_us / ((num_nodes == 0) ? 1:num_nodes), max_us, total_changed,
+        planner.get_stats().last_cost);
+
+    // the same scans planned from scratch, for the cost the incremental plans drifted to
+    em_chan_planner_t replan = planner;
+    replan.plan(true);
+    printf("%s:%d: full plan of the same scans: %llu in %llu us\n", __func__, __LINE__, replan.get_stats().last_cost,
+        replan.get_stats().last_plan_us);
+}
@@ -24,12 +24,14 @@
 #include "bus.h"
 #include "bus_common.h"
 #include "tr_181.h"
+#include "em_chan_planner.h"
 
 typedef enum{
     CONTROLLERID,
     COLOCATEDAGENTID,
     SETSSID,
-    TOPO_PUBLISH
+    TOPO_PUBLISH,
+    CHANNEL_PLAN_BENCH
 }test_tr;
 
 void print_options()
@@ -40,6 +42,7 @@ void print_options()
     printf("\nDEVICE_WIFI_DATAELEMENTS_NETWORK_COLOCATEDAGENTID:%d",COLOCATEDAGENTID);
     printf("\nDEVICE_WIFI_DATAELEMENTS_NETWORK_SETSSID_CMD:%d",SETSSID);
     printf("\nDEVICE_WIFI_DATAELEMENTS_NETWORK_TOPO_PUBLISH:%d",TOPO_PUBLISH);
+    printf("\nCHANNEL_PLAN_BENCH (50 radios):%d",CHANNEL_PLAN_BENCH);
     printf("\n ---------------------------------------------------");
     printf("\n");
 }
@@ -191,6 +194,8 @@ int main()
             if (desc->bus_event_subs_fn(&m_bus_hdl, DEVICE_WIFI_DATAELEMENTS_NETWORK_TOPOLOGY, reinterpret_cast<void *>(&topo_cb), nullptr, 0) != 0) {
                 printf("Failed to subscribe to 'Device.WiFi.DataElements.Network.Topology'\n");
             }
+        } else if (input == CHANNEL_PLAN_BENCH) {
+            em_chan_planner_t::benchmark(50, 1);
         } else {
             printf("\n%s:%d Invalid Input\n", __func__, __LINE__);
         }
@@ -33,10 +33,14 @@
 #include <sys/uio.h>
 #include <unistd.h>
 #include <assert.h>
+#include <limits.h>
 #include "em_base.h"
 #include "em_cmd.h"
 #include "em_orch.h"
+#include "em_mgr.h"
 #include "util.h"
+#include "em_trace.h"
+#include "em_perf.h"
 #define MAX_CMD_DEV_TEST 2
 
 unsigned int em_orch_t::submit_commands(em_cmd_t *pcmd[], unsigned int num)
@@ -46,7 +50,12 @@ unsigned int em_orch_t::submit_commands(em_cmd_t *pcmd[], unsigned int num)
     bool submit = true;
 
     for (i = 0; i < num; i++) {
-        if ((submit = pre_process_orch_op(pcmd[i])) == false) {
+        submit = pre_process_orch_op(pcmd[i]);
+        if (submit == false) {
+            submit = advance_in_place(pcmd[i]);
+        }
+
+        if (submit == false) {
             // complete the command
             destroy_command(pcmd[i]);	
             submit = true;
@@ -56,7 +65,12 @@ unsigned int em_orch_t::submit_commands(em_cmd_t *pcmd[], unsigned int num)
         }
     }	
 
-    //printf("%s:%d: Submitted commands count:%d\n", __func__, __LINE__, submitted);
+    if ((submitted != 0) && (m_mgr != NULL)) {
+        m_mgr->kick_orch();
+    }
+
+    em_trace(EM_MGR, em_trace_event_orch_submit, submitted, get_num_pending());
+    em_perf_t::inc(em_perf_ctr_orch_cmds_submitted, submitted);
 
     return submitted;
 }
@@ -119,19 +133,225 @@ void em_orch_t::push_stats(em_cmd_t *pcmd)
 
 bool em_orch_t::submit_command(em_cmd_t *pcmd)
 {
-    bool submitted = false;
+    em_cmd_t *parts[EM_ORCH_MAX_PARTITIONS];
+    em_cmd_prio_t prio = pcmd->get_prio();
+    unsigned int i, num = 1;
+
+    if ((m_class_max_pending[prio] != 0) && (m_pending[prio].count >= m_class_max_pending[prio])) {
+        // the class is saturated, the command is dropped before it delays the others
+        m_class_rejected[prio]++;
+        destroy_command(pcmd);
+        return false;
+    }
 
     // build em candidates in cmd;
     if (build_candidates(pcmd) == 0) {
         // if there are no candidates, complete the command
         destroy_command(pcmd);
+        return false;
+    }
+
+    parts[0] = pcmd;
+    if (m_partition == true) {
+        num = split_by_agent(pcmd, parts, EM_ORCH_MAX_PARTITIONS);
+    }
+
+    for (i = 0; i < num; i++) {
+        parts[i]->m_submit_us = em_lat_hist_t::get_time_us();
+        list_append(&m_pending[prio], parts[i]);
+        index_command(parts[i]);
+        push_stats(parts[i]);
+    }
+
+    return true;
+}
+
+unsigned char *em_orch_t::get_agent_mac(em_t *em)
+{
+    dm_easy_mesh_t *dm = em->get_data_model();
+
+    return (dm != NULL) ? dm->get_device()->get_dev_interface_mac():em->get_radio_interface_mac();
+}
+
+unsigned int em_orch_t::split_by_agent(em_cmd_t *pcmd, em_cmd_t *parts[], unsigned int max)
+{
+    em_cmd_t *part;
+    em_t *em;
+    unsigned int i = 0, j, num = 1;
+
+    parts[0] = pcmd;
+    while (i < queue_count(pcmd->m_em_candidates)) {
+        em = static_cast<em_t *>(queue_peek(pcmd->m_em_candidates, i));
+        for (j = 0; j < num; j++) {
+            if (memcmp(get_agent_mac(em), get_agent_mac(static_cast<em_t *>(queue_peek(parts[j]->m_em_candidates, 0))), sizeof(mac_address_t)) == 0) {
+                break;
+            }
+        }
+
+        if ((j == 0) || ((j == num) && (num == max))) {
+            i++;
+            continue;
+        }
+
+        if (j == num) {
+            // same step and context as the command, the clone only differs by its candidates
+            part = pcmd->clone();
+            part->set_cmd_ctx(&pcmd->m_ctx);
+            parts[num++] = part;
+        }
+        queue_remove(pcmd->m_em_candidates, i);
+        queue_push(parts[j]->m_em_candidates, em);
+    }
+
+    return num;
+}
+
+void em_orch_t::list_append(em_orch_cmd_list_t *list, em_cmd_t *pcmd)
+{
+    if (list == &m_active) {
+        m_class_active[pcmd->get_prio()]++;
+    }
+
+    pcmd->m_orch_list = list;
+    pcmd->m_orch_next = NULL;
+    pcmd->m_orch_prev = list->tail;
+    if (list->tail != NULL) {
+        list->tail->m_orch_next = pcmd;
     } else {
-        queue_push(m_pending, pcmd);
-        push_stats(pcmd);
-        submitted = true;
+        list->head = pcmd;
     }
+    list->tail = pcmd;
+    list->count++;
+}
 
-    return submitted;
+void em_orch_t::list_remove(em_cmd_t *pcmd)
+{
+    em_orch_cmd_list_t *list = pcmd->m_orch_list;
+
+    if (list == NULL) {
+        return;
+    }
+
+    if (list == &m_active) {
+        m_class_active[pcmd->get_prio()]--;
+    }
+
+    if (pcmd->m_orch_prev != NULL) {
+        pcmd->m_orch_prev->m_orch_next = pcmd->m_orch_next;
+    } else {
+        list->head = pcmd->m_orch_next;
+    }
+    if (pcmd->m_orch_next != NULL) {
+        pcmd->m_orch_next->m_orch_prev = pcmd->m_orch_prev;
+    } else {
+        list->tail = pcmd->m_orch_prev;
+    }
+    list->count--;
+
+    pcmd->m_orch_list = NULL;
+    pcmd->m_orch_next = NULL;
+    pcmd->m_orch_prev = NULL;
+}
+
+void em_orch_t::index_command(em_cmd_t *pcmd)
+{
+    em_orch_link_t *link, **head;
+    unsigned int i, count;
+    int type = static_cast<int>(pcmd->m_type);
+
+    if ((type >= 0) && (type < em_cmd_type_max)) {
+        pcmd->m_type_prev = NULL;
+        pcmd->m_type_next = m_type_head[type];
+        if (m_type_head[type] != NULL) {
+            m_type_head[type]->m_type_prev = pcmd;
+        }
+        m_type_head[type] = pcmd;
+        m_type_count[type]++;
+    }
+
+    if ((count = queue_count(pcmd->m_em_candidates)) == 0) {
+        return;
+    }
+
+    pcmd->m_em_links = new em_orch_link_t[count];
+    pcmd->m_num_em_links = count;
+    for (i = 0; i < count; i++) {
+        link = &pcmd->m_em_links[i];
+        link->cmd = pcmd;
+        link->em = static_cast<em_t *>(queue_peek(pcmd->m_em_candidates, i));
+        link->step_timed = false;
+        head = link->em->get_orch_links();
+        link->prev = NULL;
+        link->next = *head;
+        if (*head != NULL) {
+            (*head)->prev = link;
+        }
+        *head = link;
+    }
+}
+
+void em_orch_t::unindex_command(em_cmd_t *pcmd)
+{
+    em_orch_link_t *link;
+    unsigned int i;
+    int type = static_cast<int>(pcmd->m_type);
+
+    if ((type >= 0) && (type < em_cmd_type_max) &&
+            ((pcmd->m_type_prev != NULL) || (m_type_head[type] == pcmd))) {
+        if (pcmd->m_type_prev != NULL) {
+            pcmd->m_type_prev->m_type_next = pcmd->m_type_next;
+        } else {
+            m_type_head[type] = pcmd->m_type_next;
+        }
+        if (pcmd->m_type_next != NULL) {
+            pcmd->m_type_next->m_type_prev = pcmd->m_type_prev;
+        }
+        pcmd->m_type_next = NULL;
+        pcmd->m_type_prev = NULL;
+        m_type_count[type]--;
+    }
+
+    for (i = 0; i < pcmd->m_num_em_links; i++) {
+        link = &pcmd->m_em_links[i];
+        if (link->prev != NULL) {
+            link->prev->next = link->next;
+        } else {
+            *link->em->get_orch_links() = link->next;
+        }
+        if (link->next != NULL) {
+            link->next->prev = link->prev;
+        }
+    }
+
+    delete[] pcmd->m_em_links;
+    pcmd->m_em_links = NULL;
+    pcmd->m_num_em_links = 0;
+}
+
+unsigned int em_orch_t::get_cmd_count(em_cmd_type_t type)
+{
+    int idx = static_cast<int>(type);
+
+    return ((idx >= 0) && (idx < em_cmd_type_max)) ? m_type_count[idx]:0;
+}
+
+em_cmd_t *em_orch_t::get_first_cmd_of_type(em_cmd_type_t type)
+{
+    int idx = static_cast<int>(type);
+
+    return ((idx >= 0) && (idx < em_cmd_type_max)) ? m_type_head[idx]:NULL;
+}
+
+unsigned int em_orch_t::get_cmds_for_em(em_t *em, em_cmd_t *pcmd[], unsigned int max)
+{
+    em_orch_link_t *link;
+    unsigned int num = 0;
+
+    for (link = *em->get_orch_links(); (link != NULL) && (num < max); link = link->next) {
+        pcmd[num++] = link->cmd;
+    }
+
+    return num;
 }
 
 void em_orch_t::destroy_command(em_cmd_t *pcmd)
@@ -139,6 +359,9 @@ void em_orch_t::destroy_command(em_cmd_t *pcmd)
     unsigned int count;
 	em_t *em;
 
+    list_remove(pcmd);
+    unindex_command(pcmd);
+
     // remove candidates from queue
     while ((count = queue_count(pcmd->m_em_candidates)) != 0) {
         em = static_cast<em_t *>(queue_remove(pcmd->m_em_candidates, count - 1));
@@ -148,34 +371,31 @@ void em_orch_t::destroy_command(em_cmd_t *pcmd)
     pcmd->deinit();
 
     delete pcmd;
+    em_perf_t::inc(em_perf_ctr_orch_cmds_done);
 }
 
 void em_orch_t::cancel_command(em_cmd_type_t type) 
 {
-    int i, j;
-    em_cmd_t *pcmd;
+    int j;
+    unsigned int i;
+    em_cmd_t *pcmd, *next;
     em_t *em;
     mac_addr_str_t	mac_str;
 
-    // first go through the pending queue and remove the commnands
-    for (i = static_cast<int>(queue_count(m_pending)) - 1; i >= 0; i--) {
-        pcmd = static_cast<em_cmd_t *>(queue_peek(m_pending, static_cast<unsigned int>(i))); 
-        if (pcmd->m_type == type) {
+    // pending commands are removed, active ones are moved to cancel
+    for (pcmd = get_first_cmd_of_type(type); pcmd != NULL; pcmd = next) {
+        next = pcmd->m_type_next;
+        if ((pcmd->m_orch_list != NULL) && (pcmd->m_orch_list != &m_active)) {
             for (j = static_cast<int>(queue_count(pcmd->m_em_candidates)) - 1; j >= 0; j--) {
                 queue_remove(pcmd->m_em_candidates, static_cast<unsigned int>(j));
             }
 
-            queue_remove(m_pending, static_cast<unsigned int>(i));
+            list_remove(pcmd);
             pop_stats(pcmd);
             destroy_command(pcmd);
-        }   
-    } 
-    // go though active queue and finish the commands
-    for (i = static_cast<int>(queue_count(m_active)) - 1; i >= 0; i--) {
-        pcmd = static_cast<em_cmd_t *>(queue_peek(m_active, static_cast<unsigned int>(i)));
-        if (pcmd->m_type == type) {
-            for (j = static_cast<int>(queue_count(pcmd->m_em_candidates)) - 1; j >= 0; j--) {
-                em = static_cast<em_t *>(queue_peek(pcmd->m_em_candidates, static_cast<unsigned int>(j)));
+        } else if (pcmd->m_orch_list == &m_active) {
+            for (i = 0; i < pcmd->m_num_em_links; i++) {
+                em = pcmd->m_em_links[i].em;
                 dm_easy_mesh_t::macbytes_to_string(em->get_radio_interface_mac(), mac_str);
                 printf("%s:%d: Setting em:%s State set to cancel\n", __func__, __LINE__, mac_str);
                 pre_process_cancel(pcmd, em);
@@ -189,23 +409,16 @@ bool em_orch_t::orchestrate(em_cmd_t *pcmd, em_t *em)
 {
     bool done = false;
     em_orch_state_t orch_state;
-    mac_addr_str_t	mac_str;
 
     orch_state = em->get_orch_state();
 
-    dm_easy_mesh_t::macbytes_to_string(em->get_radio_interface_mac(), mac_str);
-
     if (orch_state == em_orch_state_pending) {
         if (is_em_ready_for_orch_exec(pcmd, em) == true) {
             // ask em to execute the command
-            //printf("%s:%d: Start orchestartion:%s(%s), em state:%s\n", __func__, __LINE__, 
-					//em_cmd_t::get_orch_op_str(pcmd->get_orch_op()), em_cmd_t::get_cmd_type_str(pcmd->m_type), 
-					//em_t::state_2_str(em->get_state()));
+            em_trace(EM_MGR, em_trace_event_orch_exec, pcmd->m_type, em->get_state());
             em->orch_execute(pcmd);
         } else {
-            //printf("%s:%d: skipping orchestration:%s(%s) because of incorrect state, state:%s\n", __func__, __LINE__, 
-					//em_cmd_t::get_orch_op_str(pcmd->get_orch_op()), em_cmd_t::get_cmd_type_str(pcmd->m_type), 
-					//em_t::state_2_str(em->get_state()));
+            em_trace(EM_MGR, em_trace_event_orch_skip, pcmd->m_type, em->get_state());
             update_stats(pcmd);
             orch_transient(pcmd, em);
         }
@@ -219,7 +432,7 @@ bool em_orch_t::orchestrate(em_cmd_t *pcmd, em_t *em)
         }
 
     } else if (orch_state == em_orch_state_fini) {
-        //printf("%s:%d: em:%s Detected in fini state\n", __func__, __LINE__, mac_str);
+        em_trace(EM_MGR, em_trace_event_orch_fini, pcmd->m_type, em->get_state());
         done = true;
     }
 
@@ -228,71 +441,41 @@ bool em_orch_t::orchestrate(em_cmd_t *pcmd, em_t *em)
 
 bool em_orch_t::eligible_for_active(em_cmd_t *pcmd)
 {
-    signed int i;
-    bool eligible = true;
-    em_t *em;
+    unsigned int i;
 
-    for (i = static_cast<int>(queue_count(pcmd->m_em_candidates)) - 1; i >= 0; i--) {
-        em = static_cast<em_t *>(queue_peek(pcmd->m_em_candidates, static_cast<unsigned int>(i)));
-	if (em != NULL) {
-		if (em->get_orch_state() != em_orch_state_idle) {
-			eligible = false;
-			break;
-		}
+    for (i = 0; i < pcmd->m_num_em_links; i++) {
+        if (pcmd->m_em_links[i].em->get_orch_state() != em_orch_state_idle) {
+            return false;
         }
     }
 
-    return eligible;
+    return true;
 }
 
 bool em_orch_t::is_cmd_type_renew_in_progress(em_bus_event_t *evt)
 {
-	em_cmd_stats_t *stats;
-	em_short_string_t key;
 	em_cmd_type_t		type;
 	em_bus_event_type_cfg_renew_params_t *raw;
 	mac_address_t mac;
-	mac_addr_str_t mac_str, radio_mac;
+	mac_addr_str_t mac_str;
 	em_cmd_t *pcmd;
 	em_t *em;
-	signed int i, j;
+	unsigned int i;
 
 	type = em_cmd_t::bus_2_cmd_type(evt->type);
 
-	snprintf(key, sizeof(em_short_string_t), "%d", type);
-
 	raw = reinterpret_cast<em_bus_event_type_cfg_renew_params_t *>(evt->u.raw_buff);
 	memcpy(mac, raw->radio, sizeof(mac_address_t));
-	dm_easy_mesh_t::macbytes_to_string(mac, radio_mac);
-	if ((stats = static_cast<em_cmd_stats_t *>(hash_map_get(m_cmd_map, key))) != NULL) {
+	if (get_cmd_count(type) != 0) {
 	   printf("%s:%d: Command of type: %d actively executing\n", __func__, __LINE__, type);
-		// Go through the pending queue and check if radio mac match
-		for (i = static_cast<int>(queue_count(m_pending)) - 1; i >= 0; i--) {
-			pcmd = static_cast<em_cmd_t *>(queue_peek(m_pending, static_cast<unsigned int>(i)));
-			if (pcmd->m_type == type) {
-				for (j = static_cast<int>(queue_count(pcmd->m_em_candidates)) - 1; j >= 0; j--) {
-					em = static_cast<em_t *>(queue_peek(pcmd->m_em_candidates, static_cast<unsigned int>(j)));
-					dm_easy_mesh_t::macbytes_to_string(em->get_radio_interface_mac(), mac_str);
-					if (memcmp(mac, em->get_radio_interface_mac(), sizeof(mac_address_t)) == 0) {
-						dm_easy_mesh_t::macbytes_to_string(em->get_radio_interface_mac(), mac_str);
-						printf("%s:%d: Command of type: %d actively executing for %s\n", __func__, __LINE__, type, mac_str);
-						return true;
-					}
-				}
-			}
-		}
-		// go though active queue and check if radio mac match
-		for (i = static_cast<int>(queue_count(m_active)) - 1; i >= 0; i--) {
-			pcmd = static_cast<em_cmd_t *>(queue_peek(m_active, static_cast<unsigned int>(i)));
-			if (pcmd->m_type == type) {
-				for (j = static_cast<int>(queue_count(pcmd->m_em_candidates)) - 1; j >= 0; j--) {
-					em = static_cast<em_t *>(queue_peek(pcmd->m_em_candidates, static_cast<unsigned int>(j)));
+		// go through the pending and active commands of this type and check if radio mac match
+		for (pcmd = get_first_cmd_of_type(type); pcmd != NULL; pcmd = pcmd->m_type_next) {
+			for (i = 0; i < pcmd->m_num_em_links; i++) {
+				em = pcmd->m_em_links[i].em;
+				if (memcmp(mac, em->get_radio_interface_mac(), sizeof(mac_address_t)) == 0) {
 					dm_easy_mesh_t::macbytes_to_string(em->get_radio_interface_mac(), mac_str);
-					if (memcmp(mac, em->get_radio_interface_mac(), sizeof(mac_addr_t)) == 0) {
-						dm_easy_mesh_t::macbytes_to_string(em->get_radio_interface_mac(), mac_str);
-						printf("%s:%d: Command of type: %d actively executing for %s\n", __func__, __LINE__, type, mac_str);
-						return true;
-					}
+					printf("%s:%d: Command of type: %d actively executing for %s\n", __func__, __LINE__, type, mac_str);
+					return true;
 				}
 			}
 		}
@@ -303,19 +486,13 @@ bool em_orch_t::is_cmd_type_renew_in_progress(em_bus_event_t *evt)
 
 bool em_orch_t::get_dev_test_status()
 {
-    em_cmd_stats_t *stats;
-    em_short_string_t key;
     em_cmd_type_t type[MAX_CMD_DEV_TEST] = {em_cmd_type_cfg_renew, em_cmd_type_set_radio};
     int i = 0;
 
     for (i = 0; i < MAX_CMD_DEV_TEST; i++) {
-        snprintf(key, sizeof(em_short_string_t), "%d", type[i]);
-
-        if ((stats = static_cast<em_cmd_stats_t *>(hash_map_get(m_cmd_map, key))) != NULL) {
-            //printf("%s:%d: Command of type: %d actively executing\n", __func__, __LINE__, type);
+        if (get_cmd_count(type[i]) != 0) {
             return true;
         }
-
     }
 
     return false;
@@ -324,101 +501,368 @@ bool em_orch_t::get_dev_test_status()
 
 bool em_orch_t::is_cmd_type_in_progress(em_bus_event_t *evt)
 {
-    em_cmd_stats_t *stats;
-    em_short_string_t key;
     em_cmd_type_t	type;
 
     type = em_cmd_t::bus_2_cmd_type(evt->type);
 
-    snprintf(key, sizeof(em_short_string_t), "%d", type);
-
     if ((type == em_cmd_type_cfg_renew ) ||
         (type == em_cmd_type_ap_metrics_report)) {
         return is_cmd_type_renew_in_progress(evt);
     }
-    if ((stats = static_cast<em_cmd_stats_t *>(hash_map_get(m_cmd_map, key))) != NULL) {
-        //printf("%s:%d: Command of type: %d actively executing\n", __func__, __LINE__, type);
-        return true;
-    }
 
-    return false;
+    return (get_cmd_count(type) != 0);
 }
 
-void em_orch_t::handle_timeout()
+unsigned int em_orch_t::promote_pending()
 {
-    em_cmd_t *pcmd;
-    em_t *em;
-    signed int i, j; 
-    unsigned int cnt;
-    bool eligible_to_move = false;
-    bool ret = true;
-
-    // go through pending queue and check if the commands can be moved to active
-    for (i = static_cast<int>(queue_count(m_pending)) - 1; i >= 0; i--) {
-        pcmd = static_cast<em_cmd_t *>(queue_peek(m_pending, static_cast<unsigned int>(i)));
-        if (eligible_for_active(pcmd) == true) {
-            queue_remove(m_pending, static_cast<unsigned int>(i));
-            //printf("%s:%d: Cmd: %s Orch Type: %s eligible for active\n", __func__, __LINE__, 
-                    //pcmd->get_cmd_name(), em_cmd_t::get_orch_op_str(pcmd->get_orch_op()));
-            eligible_to_move = true;
-            break;			
+    std::vector<unsigned char *> served;
+    unsigned int prio, round, promoted = 0;
+    bool fair = (m_partition == true) && (m_max_active != 0);
+
+    // without a limit on the active commands every eligible one is promoted, the order only
+    // decides which class gets the candidates they compete for
+    do {
+        served.clear();
+        round = 0;
+        for (prio = 0; prio < em_cmd_prio_max; prio++) {
+            round += promote_class(static_cast<em_cmd_prio_t>(prio), (m_max_active == 0) ? UINT_MAX:m_class_weight[prio],
+                        (fair == true) ? &served:NULL);
+        }
+        promoted += round;
+    } while ((round != 0) && ((m_max_active == 0) || (m_active.count < m_max_active)));
+
+    return promoted;
+}
+
+unsigned int em_orch_t::promote_class(em_cmd_prio_t prio, unsigned int budget, std::vector<unsigned char *> *served)
+{
+    em_cmd_t *pcmd, *next;
+    unsigned char *agent = NULL;
+    unsigned int i, promoted = 0;
+
+    // oldest first, a promoted command makes its candidates busy for the ones behind it
+    for (pcmd = m_pending[prio].head; (pcmd != NULL) && (promoted < budget); pcmd = next) {
+        next = pcmd->m_orch_next;
+        if (((m_max_active != 0) && (m_active.count >= m_max_active)) ||
+                ((m_class_max_active[prio] != 0) && (m_class_active[prio] >= m_class_max_active[prio]))) {
+            break;
+        }
+
+        if (served != NULL) {
+            agent = get_agent_mac(pcmd->m_em_links[0].em);
+            for (i = 0; i < served->size(); i++) {
+                if (memcmp((*served)[i], agent, sizeof(mac_address_t)) == 0) {
+                    break;
+                }
+            }
+            if (i < served->size()) {
+                continue;
+            }
         }
-    }	
 
-    if (eligible_to_move == true) {
-        for (i = static_cast<int>(queue_count(pcmd->m_em_candidates)) - 1; i >= 0; i--) {
-            em = static_cast<em_t *>(queue_peek(pcmd->m_em_candidates, static_cast<unsigned int>(i)));
-            em->set_orch_state(em_orch_state_pending);
+        if (eligible_for_active(pcmd) == false) {
+            continue;
+        }
+
+        list_remove(pcmd);
+        for (i = 0; i < pcmd->m_num_em_links; i++) {
+            pcmd->m_em_links[i].em->set_orch_state(em_orch_state_pending);
         }
 
 		// as soon as command is pushed to active start timing
 		pcmd->set_start_time();
-        queue_push(m_active, pcmd);
-    } else {
-        if ((cnt = queue_count(m_pending))) {
-            pcmd = static_cast<em_cmd_t *>(queue_peek(m_pending, cnt - 1));
-            //printf("%s:%d:%d Command in pending but not eligible for active\n", __func__, __LINE__, cnt);
+        pcmd->m_active_us = em_lat_hist_t::get_time_us();
+        m_lat[pcmd->get_type()][em_orch_lat_wait].add(pcmd->m_active_us - pcmd->m_submit_us);
+        m_class_wait[prio].add(pcmd->m_active_us - pcmd->m_submit_us);
+        list_append(&m_active, pcmd);
+        promoted++;
+        if (served != NULL) {
+            served->push_back(agent);
         }
     }
 
+    return promoted;
+}
+
+unsigned int em_orch_t::process_active()
+{
+    em_cmd_t *pcmd, *next;
+    em_orch_link_t *link;
+    signed int i;
+    unsigned int finished = 0;
+    uint64_t now_us = em_lat_hist_t::get_time_us(), step_us;
+    bool done;
 
     // go through active queue and check command states
-    for (i = static_cast<int>(queue_count(m_active)) - 1; i >= 0; i--) {
-        pcmd = static_cast<em_cmd_t *>(queue_peek(m_active, static_cast<unsigned int>(i)));
-		//printf("%s:%d: Cmd: %s, em candidates: %d\n", __func__, __LINE__, 
-					//em_cmd_t::get_cmd_type_str(pcmd->m_type), queue_count(pcmd->m_em_candidates));
-        for (j = static_cast<int>(queue_count(pcmd->m_em_candidates)) - 1; j >= 0; j--) {
-            em = static_cast<em_t *>(queue_peek(pcmd->m_em_candidates, static_cast<unsigned int>(j)));
-            ret &= orchestrate(pcmd, em);
+    for (pcmd = m_active.head; pcmd != NULL; pcmd = next) {
+        next = pcmd->m_orch_next;
+        done = true;
+        for (i = static_cast<int>(pcmd->m_num_em_links) - 1; i >= 0; i--) {
+            link = &pcmd->m_em_links[i];
+            if (orchestrate(pcmd, link->em) == false) {
+                done = false;
+            } else if (link->step_timed == false) {
+                // first pass that sees this em in fini, slow agents show up here
+                step_us = now_us - pcmd->m_active_us;
+                m_lat[pcmd->get_type()][em_orch_lat_step].add(step_us);
+                link->em->get_orch_step_latency()->add(step_us);
+                link->step_timed = true;
+            }
         }
 
-        if (ret == true) {
+        if (done == true) {
             // means the command is in fini sate 
-            //printf("%s:%d: Removing and destroying Command type: %s Orchestration: %s because command is in fini state\n", 
-                   // __func__, __LINE__, pcmd->get_cmd_name(), em_cmd_t::get_orch_op_str(pcmd->get_orch_op()));
-            queue_remove(m_active, static_cast<unsigned int>(i));
+            m_lat[pcmd->get_type()][em_orch_lat_active].add(now_us - pcmd->m_active_us);
+            if (advance_in_place(pcmd) == true) {
+                // the next step keeps the candidates, the command stays active
+                for (i = static_cast<int>(pcmd->m_num_em_links) - 1; i >= 0; i--) {
+                    pcmd->m_em_links[i].em->set_orch_state(em_orch_state_pending);
+                    pcmd->m_em_links[i].step_timed = false;
+                }
+                pcmd->set_start_time();
+                pcmd->m_active_us = now_us;
+                finished++;
+                continue;
+            }
+            list_remove(pcmd);
             pop_stats(pcmd);
-            for (j = static_cast<int>(queue_count(pcmd->m_em_candidates)) - 1; j >= 0; j--) {
-                em = static_cast<em_t *>(queue_peek(pcmd->m_em_candidates, static_cast<unsigned int>(j)));
-                em->set_orch_state(em_orch_state_idle);
+            for (i = static_cast<int>(pcmd->m_num_em_links) - 1; i >= 0; i--) {
+                pcmd->m_em_links[i].em->set_orch_state(em_orch_state_idle);
             }
             destroy_command(pcmd);
-            //em->set_state(em_state_agent_config_complete);
+            finished++;
+        }
+    }
+
+    return finished;
+}
+
+bool em_orch_t::advance_in_place(em_cmd_t *pcmd)
+{
+    if (pcmd->is_orch_in_place() == false) {
+        return false;
+    }
+
+    // the steps that are not orchestrated only need their pre processing
+    while (pcmd->advance_orch_op() == true) {
+        if (pre_process_orch_op(pcmd) == true) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool em_orch_t::defer_event(em_bus_event_t *evt, const char *key)
+{
+    em_orch_deferred_t *slot = NULL;
+    em_event_t *e;
+    unsigned int i, data_len;
+
+    for (i = 0; i < EM_ORCH_MAX_DEFERRED; i++) {
+        if (m_deferred[i].evt == NULL) {
+            if (slot == NULL) {
+                slot = &m_deferred[i];
+            }
+        } else if ((m_deferred[i].type == evt->type) && (strncmp(m_deferred[i].key, key, sizeof(em_subdoc_name_space_t)) == 0)) {
+            slot = &m_deferred[i];
             break;
         }
+    }
+
+    if (slot == NULL) {
+        printf("%s:%d: No slot left to defer event type:%d\n", __func__, __LINE__, evt->type);
+        return false;
+    }
+
+    data_len = (evt->data_len > EM_MAX_EVENT_DATA_LEN) ? EM_MAX_EVENT_DATA_LEN:evt->data_len;
+    if ((e = m_mgr->alloc_event(data_len)) == NULL) {
+        return false;
+    }
+    e->type = em_event_type_bus;
+    memcpy(&e->u.bevt, evt, sizeof(em_bus_event_t) + data_len);
+    e->u.bevt.data_len = data_len;
+
+    if (slot->evt != NULL) {
+        // the update held so far was never handled, the newer one supersedes it
+        m_mgr->free_event(slot->evt);
+        m_deferred_replaced++;
+    } else {
+        slot->type = evt->type;
+        slot->cmd_type = em_cmd_t::bus_2_cmd_type(evt->type);
+        snprintf(slot->key, sizeof(em_subdoc_name_space_t), "%s", key);
+        m_num_deferred++;
+    }
+    slot->evt = e;
+
+    return true;
+}
+
+unsigned int em_orch_t::replay_deferred()
+{
+    em_event_t *evt;
+    unsigned int i, num = 0;
+
+    for (i = 0; (i < EM_ORCH_MAX_DEFERRED) && (m_num_deferred != 0); i++) {
+        // a handled event may submit commands of its type, the next ones of that type wait for them
+        if ((m_deferred[i].evt == NULL) || (get_cmd_count(m_deferred[i].cmd_type) != 0)) {
+            continue;
+        }
+
+        evt = m_deferred[i].evt;
+        m_deferred[i].evt = NULL;
+        m_num_deferred--;
+        m_mgr->handle_event(evt);
+        m_mgr->free_event(evt);
+        num++;
+    }
+
+    return num;
+}
+
+void em_orch_t::clear_deferred()
+{
+    unsigned int i;
+
+    for (i = 0; i < EM_ORCH_MAX_DEFERRED; i++) {
+        if (m_deferred[i].evt != NULL) {
+            m_mgr->free_event(m_deferred[i].evt);
+            m_deferred[i].evt = NULL;
+        }
+    }
+    m_num_deferred = 0;
+}
+
+void em_orch_t::set_class_limits(em_cmd_prio_t prio, unsigned int max_pending, unsigned int max_active)
+{
+    m_class_max_pending[prio] = max_pending;
+    m_class_max_active[prio] = max_active;
+}
+
+unsigned int em_orch_t::get_num_pending()
+{
+    unsigned int prio, num = 0;
+
+    for (prio = 0; prio < em_cmd_prio_max; prio++) {
+        num += m_pending[prio].count;
+    }
+
+    return num;
+}
+
+unsigned int em_orch_t::get_agent_cmd_count(const unsigned char *al_mac)
+{
+    em_orch_cmd_list_t *lists[em_cmd_prio_max + 1];
+    em_cmd_t *pcmd;
+    unsigned int i, num = 0;
+
+    for (i = 0; i < em_cmd_prio_max; i++) {
+        lists[i] = &m_pending[i];
+    }
+    lists[em_cmd_prio_max] = &m_active;
+
+    for (i = 0; i <= em_cmd_prio_max; i++) {
+        for (pcmd = lists[i]->head; pcmd != NULL; pcmd = pcmd->m_orch_next) {
+            if ((queue_count(pcmd->m_em_candidates) > 0) &&
+                    (memcmp(get_agent_mac(static_cast<em_t *>(queue_peek(pcmd->m_em_candidates, 0))), al_mac, sizeof(mac_address_t)) == 0)) {
+                num++;
+            }
+        }
+    }
+
+    return num;
+}
+
+void em_orch_t::reset_latency()
+{
+    unsigned int type, lat, prio;
+
+    for (prio = 0; prio < em_cmd_prio_max; prio++) {
+        m_class_wait[prio].reset();
+    }
+
+
+    for (type = 0; type < em_cmd_type_max; type++) {
+        for (lat = 0; lat < em_orch_lat_max; lat++) {
+            m_lat[type][lat].reset();
+        }
+    }
+}
+
+void em_orch_t::encode_latency(cJSON *arr)
+{
+    cJSON *obj;
+    unsigned int type;
+
+    for (type = 0; type < em_cmd_type_max; type++) {
+        if ((m_lat[type][em_orch_lat_wait].get_count() == 0) && (m_lat[type][em_orch_lat_step].get_count() == 0)) {
+            continue;
+        }
+
+        obj = cJSON_CreateObject();
+        cJSON_AddStringToObject(obj, "Command", em_cmd_t::get_cmd_type_str(static_cast<em_cmd_type_t>(type)));
+        m_lat[type][em_orch_lat_wait].encode(cJSON_AddObjectToObject(obj, "Wait"));
+        m_lat[type][em_orch_lat_active].encode(cJSON_AddObjectToObject(obj, "Active"));
+        m_lat[type][em_orch_lat_step].encode(cJSON_AddObjectToObject(obj, "Step"));
+        cJSON_AddItemToArray(arr, obj);
+    }
+}
 
+void em_orch_t::encode_class_latency(cJSON *arr)
+{
+    cJSON *obj;
+    unsigned int prio;
+
+    for (prio = 0; prio < em_cmd_prio_max; prio++) {
+        obj = cJSON_CreateObject();
+        cJSON_AddStringToObject(obj, "Class", em_cmd_t::get_cmd_prio_str(static_cast<em_cmd_prio_t>(prio)));
+        cJSON_AddNumberToObject(obj, "Pending", m_pending[prio].count);
+        cJSON_AddNumberToObject(obj, "Active", m_class_active[prio]);
+        cJSON_AddNumberToObject(obj, "Rejected", m_class_rejected[prio]);
+        m_class_wait[prio].encode(cJSON_AddObjectToObject(obj, "Wait"));
+        cJSON_AddItemToArray(arr, obj);
     }
+}
 
+void em_orch_t::handle_timeout()
+{
+    em_perf_scope_t scope(em_perf_hist_orch_run);
+
+    // finished commands leave idle candidates behind, give the pending ones a go right away
+    do {
+        do {
+            promote_pending();
+        } while (process_active() != 0);
+        // updates deferred behind a finished command are handled now, ahead of any queued event
+    } while ((m_num_deferred != 0) && (replay_deferred() != 0));
+
+    em_perf_t::set_gauge(em_perf_gauge_orch_pending, get_num_pending());
+    em_perf_t::set_gauge(em_perf_gauge_orch_active, m_active.count);
 }
 
 em_orch_t::em_orch_t()
 {
-    m_pending = queue_create();
-    m_active = queue_create();
+    memset(m_pending, 0, sizeof(m_pending));
+    memset(&m_active, 0, sizeof(m_active));
+    memset(m_type_head, 0, sizeof(m_type_head));
+    memset(m_type_count, 0, sizeof(m_type_count));
     m_cmd_map = hash_map_create();
+    memset(m_deferred, 0, sizeof(m_deferred));
+    m_num_deferred = 0;
+    m_deferred_replaced = 0;
+    m_mgr = NULL;
+    m_max_active = 0;
+    m_partition = false;
+    m_class_weight[em_cmd_prio_interactive] = EM_ORCH_WEIGHT_INTERACTIVE;
+    m_class_weight[em_cmd_prio_config] = EM_ORCH_WEIGHT_CONFIG;
+    m_class_weight[em_cmd_prio_background] = EM_ORCH_WEIGHT_BACKGROUND;
+    memset(m_class_max_pending, 0, sizeof(m_class_max_pending));
+    memset(m_class_max_active, 0, sizeof(m_class_max_active));
+    memset(m_class_active, 0, sizeof(m_class_active));
+    memset(m_class_rejected, 0, sizeof(m_class_rejected));
 }
 
 em_orch_t::~em_orch_t()
 {
-
+    clear_deferred();
 }
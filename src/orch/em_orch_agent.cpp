@@ -212,11 +212,11 @@ bool em_orch_agent_t::pre_process_orch_op(em_cmd_t *pcmd)
     dm_easy_mesh_t *dm;
     em_commit_target_t config;
     dm_sta_t *sta;
-    em_long_string_t key;
-    mac_addr_str_t sta_mac_str, bss_mac_str, radio_mac_str;
+    dm_map_key_t key;
+    mac_addr_str_t sta_mac_str;
     em_freq_band_t band;
 
-    ctx = pcmd->m_data_model.get_cmd_ctx();
+    ctx = pcmd->get_cmd_ctx();
 
     switch (pcmd->get_orch_op()) {
         case dm_orch_type_al_insert:
@@ -229,7 +229,7 @@ bool em_orch_agent_t::pre_process_orch_op(em_cmd_t *pcmd)
             }
             config.type = em_commit_target_al;
             //commit basic configuration before orchestrate
-            dm->commit_config(pcmd->m_data_model, config);
+            dm->commit_config(*pcmd->m_data_model, config);
             em = m_mgr->create_node(intf, em_freq_band_unknown, dm, 1, em_profile_type_3, em_service_type_agent);
             if (em != NULL) {
                 printf("%s:%d: AL node created\n", __func__, __LINE__);
@@ -245,9 +245,9 @@ bool em_orch_agent_t::pre_process_orch_op(em_cmd_t *pcmd)
                 dm_easy_mesh_t::macbytes_to_string(intf->mac, mac_str);
                 config.type = em_commit_target_radio;
                 snprintf(reinterpret_cast<char*>(&config.params[0]), sizeof(config.params), "%s", mac_str);
-                dm->commit_config(pcmd->m_data_model, config);
+                dm->commit_config(*pcmd->m_data_model, config);
                 config.type = em_commit_target_bss;
-                dm->commit_config(pcmd->m_data_model, config);
+                dm->commit_config(*pcmd->m_data_model, config);
                 band =  pcmd->get_radio(i)->get_radio_info()->band;
                 printf("%s:%d: calling create_node band=%d\n", __func__, __LINE__, band);
                 if ((em = m_mgr->create_node(intf, band, dm, 0, em_profile_type_3, em_service_type_agent)) == NULL) {
@@ -264,38 +264,34 @@ bool em_orch_agent_t::pre_process_orch_op(em_cmd_t *pcmd)
                 dm = m_mgr->create_data_model(GLOBAL_NET_ID, intf);
             }
 
-            sta = static_cast<dm_sta_t *> (hash_map_get_first(pcmd->get_data_model()->m_sta_assoc_map));
+            sta = static_cast<dm_sta_t *> (pcmd->get_data_model()->m_sta_assoc_map->get_first());
             while(sta != NULL) {
                 dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.id, sta_mac_str);
-                dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.bssid, bss_mac_str);
-                dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.radiomac, radio_mac_str);
-                snprintf(key, sizeof(em_long_string_t), "%s@%s@%s", sta_mac_str, bss_mac_str, radio_mac_str);
+                dm_key_map_t::sta_key(&key, sta->m_sta_info.id, sta->m_sta_info.bssid, sta->m_sta_info.radiomac);
 
                 em_sta_info_t *em_sta = dm->get_sta_info(sta->get_sta_info()->id, sta->get_sta_info()->bssid, sta->get_sta_info()->radiomac, em_target_sta_map_consolidated);
                 if (em_sta != NULL) {
-                    printf("Consolidated Map, sta exists; updating with key: %s\n", key);
+                    printf("Consolidated Map, sta exists; updating sta: %s\n", sta_mac_str);
                     memcpy(em_sta, sta->get_sta_info(), sizeof(em_sta_info_t));
                 } else {
-                    printf("Consolidated map new addition with key: %s\n", key);
-                    hash_map_put(dm->m_sta_map, strdup(key), new dm_sta_t(*sta));
+                    printf("Consolidated map new addition of sta: %s\n", sta_mac_str);
+                    dm->m_sta_map->put(&key, new dm_sta_t(*sta));
                 }
 
-                sta = static_cast<dm_sta_t *> (hash_map_get_next(pcmd->get_data_model()->m_sta_assoc_map, sta));
+                sta = static_cast<dm_sta_t *> (pcmd->get_data_model()->m_sta_assoc_map->get_next(sta));
             }
 
-            sta = static_cast<dm_sta_t *> (hash_map_get_first(pcmd->get_data_model()->m_sta_dassoc_map));
+            sta = static_cast<dm_sta_t *> (pcmd->get_data_model()->m_sta_dassoc_map->get_first());
             while(sta != NULL) {
                 dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.id, sta_mac_str);
-                dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.bssid, bss_mac_str);
-                dm_easy_mesh_t::macbytes_to_string(sta->m_sta_info.radiomac, radio_mac_str);
-                snprintf(key, sizeof(em_long_string_t), "%s@%s@%s", sta_mac_str, bss_mac_str, radio_mac_str);
+                dm_key_map_t::sta_key(&key, sta->m_sta_info.id, sta->m_sta_info.bssid, sta->m_sta_info.radiomac);
 
                 em_sta_info_t *em_sta = dm->get_sta_info(sta->get_sta_info()->id, sta->get_sta_info()->bssid, sta->get_sta_info()->radiomac, em_target_sta_map_consolidated);
-                sta = static_cast<dm_sta_t *>(hash_map_get_next(pcmd->get_data_model()->m_sta_dassoc_map, sta));
+                sta = static_cast<dm_sta_t *>(pcmd->get_data_model()->m_sta_dassoc_map->get_next(sta));
                 if (em_sta != NULL) {
-                    printf("Consolidated Map removed with key: %s\n", key);
+                    printf("Consolidated Map removed sta: %s\n", sta_mac_str);
                     dm_sta_t *tmp = sta;
-                    tmp = static_cast<dm_sta_t *>(hash_map_remove(dm->m_sta_map, key));
+                    tmp = static_cast<dm_sta_t *>(dm->m_sta_map->remove(&key));
                     delete tmp;
                 }
             }
@@ -317,13 +313,13 @@ bool em_orch_agent_t::pre_process_orch_op(em_cmd_t *pcmd)
                 dm = m_mgr->create_data_model(GLOBAL_NET_ID, intf);
             }
 
-            sta = static_cast<dm_sta_t *> (hash_map_get_first(pcmd->get_data_model()->m_sta_assoc_map));
+            sta = static_cast<dm_sta_t *> (pcmd->get_data_model()->m_sta_assoc_map->get_first());
             while(sta != NULL) {
                 em_sta_info_t *em_sta = dm->get_sta_info(sta->get_sta_info()->id, sta->get_sta_info()->bssid, sta->get_sta_info()->radiomac, em_target_sta_map_consolidated);
                 if (em_sta != NULL) {
                     memcpy(em_sta, &sta->m_sta_info, sizeof(em_sta_info_t));
                 }
-                sta = static_cast<dm_sta_t *> (hash_map_get_next(pcmd->get_data_model()->m_sta_assoc_map, sta));
+                sta = static_cast<dm_sta_t *> (pcmd->get_data_model()->m_sta_assoc_map->get_next(sta));
             }
             break;
 
@@ -345,13 +341,13 @@ unsigned int em_orch_agent_t::build_candidates(em_cmd_t *pcmd)
     mac_address_t	radio_mac, mac1, mac2;
     dm_sta_t *sta;
 
-    ctx = pcmd->m_data_model.get_cmd_ctx();
+    ctx = pcmd->get_cmd_ctx();
 	pthread_mutex_lock(&m_mgr->m_mutex);
     em = static_cast<em_t *> (hash_map_get_first(m_mgr->m_em_map));
     while (em != NULL) {
         switch (pcmd->m_type) {
             case em_cmd_type_dev_init:
-                radio = pcmd->m_data_model.get_radio(ctx->arr_index);
+                radio = pcmd->m_data_model->get_radio(ctx->arr_index);
                 dm_easy_mesh_t::macbytes_to_string(radio->get_radio_interface_mac(), src_mac_str);
                 dm_easy_mesh_t::macbytes_to_string(em->get_radio_interface_mac(), dst_mac_str);
 				if (!(em->is_al_interface_em())) {
@@ -376,7 +372,7 @@ unsigned int em_orch_agent_t::build_candidates(em_cmd_t *pcmd)
                 }
 
                 printf("%s:%d pcmd radio mac=%s\n", __func__, __LINE__, pcmd->m_param.u.args.args[0]);
-                if ((hash_map_count(pcmd->get_data_model()->m_sta_assoc_map) != 0) || (hash_map_count(pcmd->get_data_model()->m_sta_dassoc_map) != 0)) {
+                if ((pcmd->get_data_model()->m_sta_assoc_map->count() != 0) || (pcmd->get_data_model()->m_sta_dassoc_map->count() != 0)) {
                     queue_push(pcmd->m_em_candidates, em);
                     count++;
                 }
@@ -398,7 +394,7 @@ unsigned int em_orch_agent_t::build_candidates(em_cmd_t *pcmd)
 		        break;
 	        case em_cmd_type_client_cap_query:
                 if (!(em->is_al_interface_em())) {
-                    radio = pcmd->m_data_model.get_radio(static_cast<unsigned int> (0));
+                    radio = pcmd->m_data_model->get_radio(static_cast<unsigned int> (0));
 		            if (radio == NULL) {
                         printf("%s:%d client cap radio cannot be found.\n", __func__, __LINE__);
                         break;
@@ -435,7 +431,7 @@ unsigned int em_orch_agent_t::build_candidates(em_cmd_t *pcmd)
 				break;
             case em_cmd_type_op_channel_report:
                 if (!(em->is_al_interface_em())) {
-                    radio = pcmd->m_data_model.get_radio(static_cast<unsigned int> (0));
+                    radio = pcmd->m_data_model->get_radio(static_cast<unsigned int> (0));
                     if (radio == NULL) {
                         printf("%s:%d channel sel radio cannot be found.\n", __func__, __LINE__);
                         break;
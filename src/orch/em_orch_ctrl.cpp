@@ -38,6 +38,54 @@
 #include "em_cmd_exec.h"
 #include "em_orch_ctrl.h"
 #include "em_cmd_ctrl.h"
+#include "em_trace.h"
+
+bool em_orch_ctrl_t::renew_is_late(em_t *em)
+{
+    em_renew_sched_t *sched = static_cast<em_ctrl_t *>(m_mgr)->get_renew_sched();
+    em_renew_sched_entry_t entry;
+
+    if (sched->get_entry(em->get_radio_interface_mac(), &entry) == false) {
+        return true;
+    }
+    if (entry.state == em_renew_sched_waiting) {
+        return false;
+    } else if (entry.state == em_renew_sched_active) {
+        return (em_lat_hist_t::get_time_us() / 1000) > (entry.start_ms + EM_MAX_CMD_GEN_TTL * 1000ULL);
+    }
+
+    return true;
+}
+
+void em_orch_ctrl_t::renew_plan(std::vector<em_t *>& nodes)
+{
+    em_ctrl_t *ctrl = static_cast<em_ctrl_t *>(m_mgr);
+    std::vector<em_renew_sched_radio_t> radios(nodes.size());
+    em_route_t route;
+    unsigned int i;
+
+    // the agents deepest in the backhaul go first, an agent not in the topology is taken as near
+    for (i = 0; i < nodes.size(); i++) {
+        memcpy(radios[i].ruid, nodes[i]->get_radio_interface_mac(), sizeof(mac_address_t));
+        memcpy(radios[i].al_mac, nodes[i]->get_data_model()->get_agent_al_interface_mac(), sizeof(mac_address_t));
+        radios[i].hops = (ctrl->get_route_table()->get_route(radios[i].al_mac, &route) == true) ? route.hops:0;
+    }
+    printf("%s:%d: Renew round of %u radios\n", __func__, __LINE__,
+        ctrl->get_renew_sched()->plan(radios.data(), static_cast<unsigned int> (radios.size()), em_lat_hist_t::get_time_us() / 1000));
+}
+
+void em_orch_ctrl_t::renew_finish(em_t *em, bool ok)
+{
+    em_renew_sched_t *sched = static_cast<em_ctrl_t *>(m_mgr)->get_renew_sched();
+    em_renew_sched_progress_t progress;
+
+    sched->finish(em->get_radio_interface_mac(), ok, em_lat_hist_t::get_time_us() / 1000);
+    progress = sched->get_progress();
+    if (progress.total != 0) {
+        printf("%s:%d: Renew round %llu: %u of %u radios done, %u failed, %u in progress, %u waiting\n", __func__, __LINE__,
+            progress.rounds, progress.done, progress.total, progress.failed, progress.active, progress.waiting);
+    }
+}
 
 void em_orch_ctrl_t::orch_transient(em_cmd_t *pcmd, em_t *em)
 {
@@ -49,9 +97,7 @@ void em_orch_ctrl_t::orch_transient(em_cmd_t *pcmd, em_t *em)
     stats = static_cast<em_cmd_stats_t *>(hash_map_get(m_cmd_map, key));
     assert(stats != NULL);
 	
-	//printf("%s:%d: Orchestration:%s(%s) state:%s, time in transient:%d\n", __func__, __LINE__, 
-		//em_cmd_t::get_orch_op_str(pcmd->get_orch_op()), em_cmd_t::get_cmd_type_str(pcmd->m_type), 
-		//em_t::state_2_str(em->get_state()), stats->time);
+	em_trace(EM_MGR, em_trace_event_orch_transient, pcmd->m_type, em->get_state(), stats->time);
 	
 	switch (pcmd->m_type) {
 		case em_cmd_type_em_config:
@@ -61,6 +107,18 @@ void em_orch_ctrl_t::orch_transient(em_cmd_t *pcmd, em_t *em)
     		}
 			break;
 
+		case em_cmd_type_set_ssid:
+		case em_cmd_type_cfg_renew:
+			// a radio held back by the renew pacing is not late, one in progress is late from its own start
+			if (renew_is_late(em) == false) {
+				break;
+			}
+    		if (stats->time > EM_MAX_CMD_GEN_TTL) {
+        		printf("%s:%d: Canceling cmd: %s because time limit exceeded\n", __func__, __LINE__, pcmd->get_cmd_name());
+        		cancel_command(pcmd->get_type());
+    		}
+			break;
+
 		default:
     		if (stats->time > EM_MAX_CMD_GEN_TTL) {
         		printf("%s:%d: Canceling cmd: %s because time limit exceeded\n", __func__, __LINE__, pcmd->get_cmd_name());
@@ -81,8 +139,14 @@ bool em_orch_ctrl_t::is_em_ready_for_orch_fini(em_cmd_t *pcmd, em_t *em)
             if (em->get_renew_tx_count() >= EM_MAX_RENEW_TX_THRESH) {
                 em->set_renew_tx_count(0);
                 printf("%s:%d: Maximum renew tx threshold crossed, transitioning to fini\n", __func__, __LINE__);
+                if (pcmd->m_type != em_cmd_type_set_radio) {
+                    renew_finish(em, false);
+                }
                 return true;
             } else if (em->get_state() == em_state_ctrl_wsc_m2_sent) {
+                if (pcmd->m_type != em_cmd_type_set_radio) {
+                    renew_finish(em, true);
+                }
                 return true;
 			}
             break;
@@ -142,6 +206,7 @@ bool em_orch_ctrl_t::is_em_ready_for_orch_fini(em_cmd_t *pcmd, em_t *em)
             }
             break;
         case em_cmd_type_sta_steer:
+        case em_cmd_type_sta_steer_batch:
             if (em->get_client_steering_req_tx_count() >= EM_MAX_CLIENT_STEER_REQ_TX_THRESH
                 || (em->get_state() == em_state_ctrl_steer_btm_req_ack_rcvd)) {
                 em->set_client_steering_req_tx_count(0);
@@ -196,8 +261,13 @@ bool em_orch_ctrl_t::is_em_ready_for_orch_fini(em_cmd_t *pcmd, em_t *em)
 
 bool em_orch_ctrl_t::is_em_ready_for_orch_exec(em_cmd_t *pcmd, em_t *em)
 {
+    bool ready = false;
+
     switch (pcmd->m_type) {
         case em_cmd_type_set_ssid:
+            return static_cast<em_ctrl_t *>(m_mgr)->get_renew_sched()->may_start(em->get_radio_interface_mac(),
+                em_lat_hist_t::get_time_us() / 1000);
+
         case em_cmd_type_set_radio:
         case em_cmd_type_mld_reconfig:
         case em_cmd_type_start_dpp:
@@ -206,23 +276,28 @@ bool em_orch_ctrl_t::is_em_ready_for_orch_exec(em_cmd_t *pcmd, em_t *em)
         case em_cmd_type_em_config:
         case em_cmd_type_cfg_renew:
             if (em->get_state() == em_state_ctrl_unconfigured) {
-				return true;
+				ready = true;
             } else if (em->get_state() == em_state_ctrl_wsc_m2_sent) {
-                return true;
+                ready = true;
             } else if (em->get_state() == em_state_ctrl_ap_cap_report_received){
-                return true;
+                ready = true;
             } else if (em->get_state() == em_state_ctrl_topo_synchronized) {
-                return true;
+                ready = true;
             } else if (em->get_state() == em_state_ctrl_channel_queried) {
-                return true;
+                ready = true;
             } else if (em->get_state() == em_state_ctrl_channel_selected) {
-                return true;
+                ready = true;
             } else if (em->get_state() == em_state_ctrl_configured) {
-                return true;
+                ready = true;
             } else if (em->get_state() == em_state_ctrl_misconfigured) {
-                return true;
+                ready = true;
             }
-            break;
+            // the radios of a mesh wide renew round wait for their turn
+            if ((ready == true) && (pcmd->m_type == em_cmd_type_cfg_renew)) {
+                return static_cast<em_ctrl_t *>(m_mgr)->get_renew_sched()->may_start(em->get_radio_interface_mac(),
+                    em_lat_hist_t::get_time_us() / 1000);
+            }
+            return ready;
 
         case em_cmd_type_sta_assoc:
             if (em->get_state() >= em_state_ctrl_topo_synchronized) {
@@ -240,6 +315,7 @@ bool em_orch_ctrl_t::is_em_ready_for_orch_exec(em_cmd_t *pcmd, em_t *em)
 	    }
 	break;
         case em_cmd_type_sta_steer:
+        case em_cmd_type_sta_steer_batch:
         case em_cmd_type_sta_disassoc:
         case em_cmd_type_sta_link_metrics:
         case em_cmd_type_scan_channel:
@@ -260,6 +336,8 @@ void em_orch_ctrl_t::pre_process_cancel(em_cmd_t *pcmd, em_t *em)
 	em_event_t  ev;
     em_bus_event_t *bev;
     em_bus_event_type_cfg_renew_params_t    *raw;
+    unsigned char buff[sizeof(em_cmd_wire_hdr_t) + sizeof(em_event_t)];
+    unsigned int len;
 	em_ctrl_t *ctrl = static_cast<em_ctrl_t *>(m_mgr);
 	em_cmd_ctrl_t *cmd_ctrl = ctrl->get_ctrl_cmd();
 
@@ -270,17 +348,25 @@ void em_orch_ctrl_t::pre_process_cancel(em_cmd_t *pcmd, em_t *em)
             em->set_channel_pref_query_tx_count(0);
             em->set_cap_query_tx_count(0);
 			// send cfg renew so that controller can orchestrate renew
+			memset(&ev, 0, sizeof(em_event_t));
 			ev.type = em_event_type_bus;
     		bev = &ev.u.bevt;
     		bev->type = em_bus_event_type_cfg_renew;
             raw = reinterpret_cast<em_bus_event_type_cfg_renew_params_t *>(bev->u.raw_buff);
     		memcpy(raw->radio, em->get_radio_interface_mac(), sizeof(mac_address_t));
-            cmd_ctrl->send_cmd(em_service_type_ctrl, reinterpret_cast<unsigned char *>(&ev), sizeof(em_event_t));
+            if ((len = em_cmd_exec_t::encode_event(&ev, buff, sizeof(buff))) != 0) {
+                cmd_ctrl->send_cmd(em_service_type_ctrl, buff, len);
+            }
 			break;
 		
+		case em_cmd_type_set_ssid:
+			renew_finish(em, false);
+			break;
+
 		case em_cmd_type_cfg_renew:
            	em->set_state(em_state_ctrl_misconfigured);
             em->set_renew_tx_count(0);
+			renew_finish(em, false);
 			break;
 
         default:
@@ -293,7 +379,7 @@ bool em_orch_ctrl_t::pre_process_orch_op(em_cmd_t *pcmd)
     em_t *em;
     em_ctrl_t *ctrl = static_cast<em_ctrl_t *>(m_mgr);
     dm_easy_mesh_ctrl_t *dm_ctrl = reinterpret_cast<dm_easy_mesh_ctrl_t *>(ctrl->get_data_model(GLOBAL_NET_ID));
-    dm_easy_mesh_t *dm = &pcmd->m_data_model;
+    dm_easy_mesh_t *dm = pcmd->m_data_model;
     dm_easy_mesh_t *mgr_dm;
     mac_addr_str_t	mac_str;
     em_commit_target_t config;
@@ -333,7 +419,7 @@ bool em_orch_ctrl_t::pre_process_orch_op(em_cmd_t *pcmd)
             if (em != NULL) {
                 config.type = em_commit_target_em;
                 // since this does not have to go through orchestration of M1 M2, commit the data model
-                em->get_data_model()->commit_config(pcmd->m_data_model, config);
+                em->get_data_model()->commit_config(*pcmd->m_data_model, config);
             }
             break;
 
@@ -405,15 +491,28 @@ bool em_orch_ctrl_t::pre_process_orch_op(em_cmd_t *pcmd)
     return pcmd->get_orch_submit();
 }
 
+em_t *em_orch_ctrl_t::get_sta_node(mac_address_t sta_mac, bssid_t bssid)
+{
+    em_t *em;
+    dm_sta_t *sta;
+
+    // the data model of the device holding the BSS knows the radio the STA is on
+    if (((em = m_mgr->get_node_by_bssid(bssid)) == NULL) || ((sta = em->get_data_model()->find_sta(sta_mac, bssid)) == NULL)) {
+        return NULL;
+    }
+
+    return m_mgr->get_node_by_ruid(sta->m_sta_info.radiomac);
+}
+
 unsigned int em_orch_ctrl_t::build_candidates(em_cmd_t *pcmd)
 {
     em_t *em;
     dm_easy_mesh_t *dm;
     mac_address_t	bss_mac, rad_mac;
-    unsigned int count = 0, i;
+    unsigned int count = 0, i, j;
     mac_addr_str_t mac_str;
     em_disassoc_params_t *disassoc_param;
-    dm_sta_t *sta;
+    std::vector<em_t *> nodes, round;
 	mac_address_t null_mac = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
     if (pcmd->m_type == em_cmd_type_em_config) {
@@ -425,155 +524,168 @@ unsigned int em_orch_ctrl_t::build_candidates(em_cmd_t *pcmd)
         return count;
     }
 
+    // the targets are looked up in the MAC indexes, only the remaining types look at every node
 	pthread_mutex_lock(&m_mgr->m_mutex);
-    em = static_cast<em_t *>(hash_map_get_first(m_mgr->m_em_map));
-    while (em != NULL) {
-        switch (pcmd->m_type) {
-            case em_cmd_type_set_ssid:
-		if (em->is_al_interface_em() == false) {
-			dm_easy_mesh_t::macbytes_to_string(em->get_radio_interface_mac(), mac_str);
-			printf("%s:%d Set SSID : %s push to queue \n", __func__, __LINE__,mac_str);
-			queue_push(pcmd->m_em_candidates, em);
-			count++;
+    switch (pcmd->m_type) {
+        case em_cmd_type_set_ssid:
+            // the radios of the bands the change does not touch keep their BSSs up
+            m_mgr->get_radio_nodes(nodes);
+            for (i = 0; i < nodes.size(); i++) {
+                if ((pcmd->get_cfg_bands() != 0) && (nodes[i]->get_band() < em_freq_band_unknown) &&
+                        ((pcmd->get_cfg_bands() & (1U << nodes[i]->get_band())) == 0)) {
+                    continue;
                 }
-                break;
+                dm_easy_mesh_t::macbytes_to_string(nodes[i]->get_radio_interface_mac(), mac_str);
+                printf("%s:%d Set SSID : %s push to queue \n", __func__, __LINE__,mac_str);
+                queue_push(pcmd->m_em_candidates, nodes[i]);
+                round.push_back(nodes[i]);
+                count++;
+            }
+            renew_plan(round);
+            break;
 
-            case em_cmd_type_dev_test:
-                if (em->is_dev_test_candidate()) {
+        case em_cmd_type_dev_test:
+        case em_cmd_type_reset:
+            em = static_cast<em_t *>(hash_map_get_first(m_mgr->m_em_map));
+            while (em != NULL) {
+                if (((pcmd->m_type == em_cmd_type_dev_test) && (em->is_dev_test_candidate() == true)) ||
+                        ((pcmd->m_type == em_cmd_type_reset) && (em->is_tx_cfg_renew_candidate() == true))) {
                     queue_push(pcmd->m_em_candidates, em);
                     count++;
                 }
-                break;
+                em = static_cast<em_t *>(hash_map_get_next(m_mgr->m_em_map, em));
+            }
+            break;
 
-            case em_cmd_type_reset:
-                if (em->is_tx_cfg_renew_candidate()) {
-                    queue_push(pcmd->m_em_candidates, em);
+        case em_cmd_type_cfg_renew:
+            dm = pcmd->get_data_model();
+            dm_easy_mesh_t::string_to_macbytes(pcmd->m_param.u.args.args[0], dm->m_radio[0].m_radio_info.intf.mac);
+            // check if the radio is null mac
+            if (memcmp(null_mac, dm->m_radio[0].m_radio_info.intf.mac, sizeof(mac_address_t)) == 0) {
+                m_mgr->get_radio_nodes(nodes);
+                for (i = 0; i < nodes.size(); i++) {
+                    printf("%s:%d push to queue since null mac \n", __func__, __LINE__);
+                    queue_push(pcmd->m_em_candidates, nodes[i]);
                     count++;
                 }
-                break;
-
-            case em_cmd_type_cfg_renew:
-		dm = pcmd->get_data_model();
-		dm_easy_mesh_t::string_to_macbytes(pcmd->m_param.u.args.args[0], dm->m_radio[0].m_radio_info.intf.mac);
-		// check if the radio is null mac
-		if ((memcmp(null_mac, dm->m_radio[0].m_radio_info.intf.mac, sizeof(mac_address_t)) == 0) &&  (em->is_al_interface_em() == false)) {
-			printf("%s:%d push to queue since null mac \n", __func__, __LINE__);	
-			queue_push(pcmd->m_em_candidates, em);
-                	count++;
-		} else if ((memcmp(em->get_radio_interface_mac(), dm->m_radio[0].m_radio_info.intf.mac, sizeof(mac_address_t)) == 0) && (em->is_al_interface_em() == false)) {
-			dm_easy_mesh_t::macbytes_to_string(em->get_radio_interface_mac(), mac_str);
-			printf("%s:%d Auto config renew %s push to queue since mac matches\n", __func__, __LINE__,mac_str);
-			queue_push(pcmd->m_em_candidates, em);
-			count++;
-                }
-                break;
-
-            case em_cmd_type_sta_assoc:
-                dm = em->get_data_model();
-                dm_easy_mesh_t::string_to_macbytes(pcmd->m_param.u.args.args[1], bss_mac);
-                //printf("%s:%d:BSS for this STA %s is %s\n", __func__, __LINE__, pcmd->m_param.u.args.args[2], pcmd->m_param.u.args.args[1]);
-                for (i = 0; i < dm->m_num_bss; i++) {
-                    if ((memcmp(dm->m_bss[i].m_bss_info.bssid.mac, bss_mac, sizeof(mac_address_t)) == 0) &&
-                        (em->is_al_interface_em() == false)) {
-                        queue_push(pcmd->m_em_candidates, em);
-                        count++;
-                        //printf("%s:%d:Found em this STA, candidate count: %d\n", __func__, __LINE__, count);
-                        break;
-                    }
-                }
-                break;
+                renew_plan(nodes);
+            } else if ((em = m_mgr->get_node_by_ruid(dm->m_radio[0].m_radio_info.intf.mac)) != NULL) {
+                dm_easy_mesh_t::macbytes_to_string(em->get_radio_interface_mac(), mac_str);
+                printf("%s:%d Auto config renew %s push to queue since mac matches\n", __func__, __LINE__,mac_str);
+                queue_push(pcmd->m_em_candidates, em);
+                count++;
+            }
+            break;
 
-            case em_cmd_type_sta_link_metrics:
-                if ((em->is_al_interface_em() == false) && (em->get_state() == em_state_ctrl_configured)  && 
-                        (em->has_at_least_one_associated_sta() == true)) {
-                    queue_push(pcmd->m_em_candidates, em);
-                    count++;
-                }
-                break;
-            
-            case em_cmd_type_set_channel:
-				if (em->is_al_interface_em() == false) {
-					for(i = 0; i < pcmd->m_param.u.args.num_args; i++) {
-						if(atoi(pcmd->m_param.u.args.args[i]) == em->get_band()) {
-							dm_easy_mesh_t::macbytes_to_string(em->get_radio_interface_mac(), mac_str);
-							printf("%s:%d Set Channel : %s push to queue \n", __func__, __LINE__,mac_str);
-							queue_push(pcmd->m_em_candidates, em);
-							count++;
-							break;
-						}
-					}
-                }
-                break;
-            case em_cmd_type_scan_channel:
-                if (em->is_al_interface_em() == false) {
-                    queue_push(pcmd->m_em_candidates, em);
-                    count++;
-                }
-                break;
+        case em_cmd_type_sta_assoc:
+            // every radio of the device holding the BSS
+            dm_easy_mesh_t::string_to_macbytes(pcmd->m_param.u.args.args[1], bss_mac);
+            if ((em = m_mgr->get_node_by_bssid(bss_mac)) != NULL) {
+                m_mgr->get_all_em_for_al_mac(em->get_data_model()->get_device()->get_dev_interface_mac(), nodes);
+            }
+            for (i = 0; i < nodes.size(); i++) {
+                queue_push(pcmd->m_em_candidates, nodes[i]);
+                count++;
+            }
+            break;
 
-            case em_cmd_type_sta_steer:
-                if (em->find_sta(pcmd->m_param.u.steer_params.sta_mac, pcmd->m_param.u.steer_params.source) != NULL) {
+        case em_cmd_type_sta_link_metrics:
+            // agents are spread over the slots of the polling round, a tick only queries the ones of its slot,
+            // the ones behind a long or slow backhaul path only in every few rounds
+            m_mgr->get_radio_nodes(nodes);
+            for (i = 0; i < nodes.size(); i++) {
+                em = nodes[i];
+                if ((em->get_state() == em_state_ctrl_configured) && (em->has_at_least_one_associated_sta() == true) &&
+                        (em->get_sta_link_metrics_poll_slot() == static_cast<em_ctrl_t *>(m_mgr)->get_sta_link_metrics_slot()) &&
+                        ((static_cast<em_ctrl_t *>(m_mgr)->get_sta_link_metrics_round() %
+                          static_cast<em_ctrl_t *>(m_mgr)->get_route_table()->get_poll_scale(em->get_data_model()->get_agent_al_interface_mac())) == 0)) {
                     queue_push(pcmd->m_em_candidates, em);
                     count++;
                 }
-                break;
+            }
+            break;
 
-            case em_cmd_type_sta_disassoc:
-                dm = pcmd->get_data_model();
-                for (i = 0; i < pcmd->m_param.u.disassoc_params.num; i++) {
-                    disassoc_param = &pcmd->m_param.u.disassoc_params.params[i];
-                    if ((sta = em->find_sta(disassoc_param->sta_mac, disassoc_param->bssid)) != NULL) {
+        case em_cmd_type_set_channel:
+            m_mgr->get_radio_nodes(nodes);
+            for (i = 0; i < nodes.size(); i++) {
+                em = nodes[i];
+                for (j = 0; j < pcmd->m_param.u.args.num_args; j++) {
+                    if (atoi(pcmd->m_param.u.args.args[j]) == em->get_band()) {
+                        dm_easy_mesh_t::macbytes_to_string(em->get_radio_interface_mac(), mac_str);
+                        printf("%s:%d Set Channel : %s push to queue \n", __func__, __LINE__,mac_str);
                         queue_push(pcmd->m_em_candidates, em);
                         count++;
+                        break;
                     }
                 }
-                break;
+            }
+            break;
 
-			case em_cmd_type_set_policy:
-			case em_cmd_type_set_radio:
-				dm = pcmd->get_data_model();
-				for (i = 0; i < dm->get_num_radios(); i++) {
-					if (memcmp(em->get_radio_interface_mac(), dm->m_radio[i].m_radio_info.intf.mac, sizeof(mac_address_t)) == 0) {
-						dm_easy_mesh_t::macbytes_to_string(em->get_radio_interface_mac(), mac_str);
-						//printf("%s:%d: em: %s pushed for command: em_cmd_type_set_policy\n", __func__, __LINE__, mac_str);
-                        queue_push(pcmd->m_em_candidates, em);
-                        count++;
-						break;
-					}
-				}
-				break;
+        case em_cmd_type_scan_channel:
+            m_mgr->get_radio_nodes(nodes);
+            for (i = 0; i < nodes.size(); i++) {
+                queue_push(pcmd->m_em_candidates, nodes[i]);
+                count++;
+            }
+            break;
 
-            case em_cmd_type_mld_reconfig:
-                if (em->is_al_interface_em()) {
-                    queue_push(pcmd->m_em_candidates, em);
-                    count++;
-                }
-                break;
-            case em_cmd_type_start_dpp:
-                if (em->is_al_interface_em()) {
-                    // TODO: Add additional checks for provisioning state or more if needed 
+        case em_cmd_type_sta_steer:
+            if ((em = get_sta_node(pcmd->m_param.u.steer_params.sta_mac, pcmd->m_param.u.steer_params.source)) != NULL) {
+                queue_push(pcmd->m_em_candidates, em);
+                count++;
+            }
+            break;
+
+        case em_cmd_type_sta_steer_batch:
+            // every STA of the batch is on the source BSS, the em of its radio sends the request
+            if ((em = get_sta_node(pcmd->m_param.u.steer_batch_params.entries[0].sta_mac, pcmd->m_param.u.steer_batch_params.source)) != NULL) {
+                queue_push(pcmd->m_em_candidates, em);
+                count++;
+            }
+            break;
+
+        case em_cmd_type_sta_disassoc:
+            for (i = 0; i < pcmd->m_param.u.disassoc_params.num; i++) {
+                disassoc_param = &pcmd->m_param.u.disassoc_params.params[i];
+                if ((em = get_sta_node(disassoc_param->sta_mac, disassoc_param->bssid)) != NULL) {
                     queue_push(pcmd->m_em_candidates, em);
                     count++;
                 }
-                break;
+            }
+            break;
 
-            case em_cmd_type_bsta_cap:
-                dm_easy_mesh_t::string_to_macbytes(pcmd->m_param.u.args.args[0], rad_mac);
-                //search this radio em of for this agent al device to filter the em
-                dm = em->get_data_model();
-                if ((memcmp(em->get_radio_interface_mac(), rad_mac, sizeof(mac_address_t)) == 0))
-                {
+        case em_cmd_type_set_policy:
+        case em_cmd_type_set_radio:
+            dm = pcmd->get_data_model();
+            for (i = 0; i < dm->get_num_radios(); i++) {
+                if ((em = m_mgr->get_node_by_ruid(dm->m_radio[i].m_radio_info.intf.mac)) != NULL) {
                     queue_push(pcmd->m_em_candidates, em);
                     count++;
-                    em_printfout("BSTA CAP count: %d; push to queue for em radio: %s\n", count, util::mac_to_string(em->get_radio_interface_mac()).c_str());
-                    break;
                 }
-                break;
+            }
+            break;
 
-            default:
-                break;
-        }			
-        em = static_cast<em_t *>(hash_map_get_next(m_mgr->m_em_map, em));
+        case em_cmd_type_mld_reconfig:
+        case em_cmd_type_start_dpp:
+            // TODO: Add additional checks for provisioning state or more if needed
+            m_mgr->get_al_nodes(nodes);
+            for (i = 0; i < nodes.size(); i++) {
+                queue_push(pcmd->m_em_candidates, nodes[i]);
+                count++;
+            }
+            break;
+
+        case em_cmd_type_bsta_cap:
+            dm_easy_mesh_t::string_to_macbytes(pcmd->m_param.u.args.args[0], rad_mac);
+            if ((em = m_mgr->get_node_by_ruid(rad_mac)) != NULL) {
+                queue_push(pcmd->m_em_candidates, em);
+                count++;
+                em_printfout("BSTA CAP count: %d; push to queue for em radio: %s\n", count, util::mac_to_string(em->get_radio_interface_mac()).c_str());
+            }
+            break;
+
+        default:
+            break;
     }
 	pthread_mutex_unlock(&m_mgr->m_mutex);
 
@@ -583,4 +695,8 @@ unsigned int em_orch_ctrl_t::build_candidates(em_cmd_t *pcmd)
 em_orch_ctrl_t::em_orch_ctrl_t(em_mgr_t *mgr)
 {
     m_mgr = mgr;
+    // the commands sent to the agents have no dependency across agents
+    set_partition_by_agent(true);
+    // periodic metrics and scans are dropped rather than queued behind a backlog
+    set_class_limits(em_cmd_prio_background, EM_ORCH_CTRL_MAX_BACKGROUND_PENDING, 0);
 }
@@ -42,6 +42,7 @@
  *     - OpenSSL 3.0+ Compatability
  *         - Add `aes_encrypt_block`, `aes_init`, and `siv_free` abstractions
  *         - Updated `siv_aes_ctr` and existing methods for OpenSSL 3.0 for EVP_CIPHER_CTX
+ *         - CTR keyed once in `siv_init`, `siv_aes_ctr` only sets the IV of `ctr_sched`
  * Copyright 2025 Comcast Cable Communications Management, LLC
  */
 
@@ -96,21 +97,16 @@ static void aes_encrypt_block(const unsigned char *in, unsigned char *out, SIV_K
     }
     
     int outlen = 0;
-    // Use the context directly to encrypt just one block
+    // Use the context directly to encrypt just one block, without padding ECB has nothing to finalize
     if (1 != EVP_EncryptUpdate(*ctx, out, &outlen, in, AES_BLOCK_SIZE)) {
         return;
     }
-    
-    int final_len = 0;
-    if (1 != EVP_EncryptFinal_ex(*ctx, out + outlen, &final_len)) {
-        return;
-    }
 #else
     AES_encrypt(in, out, ctx);
 #endif
 }
 
-static int aes_init(const unsigned char *key, const int bits, SIV_KEY_CTX *ctx)
+static int aes_init(const unsigned char *key, const int bits, SIV_KEY_CTX *ctx, const int ctr)
 {
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
     if (*ctx != NULL) {
@@ -123,16 +119,16 @@ static int aes_init(const unsigned char *key, const int bits, SIV_KEY_CTX *ctx)
     }
 
     const EVP_CIPHER* cipher = NULL;
-    // Use ECB mode which is equivalent to what AES_encrypt does
+    // Use ECB mode which is equivalent to what AES_encrypt does, or CTR for the ctr key
     switch (bits) {
         case 128:
-            cipher = EVP_aes_128_ecb();
+            cipher = ctr ? EVP_aes_128_ctr() : EVP_aes_128_ecb();
             break;
         case 192:
-            cipher = EVP_aes_192_ecb();
+            cipher = ctr ? EVP_aes_192_ctr() : EVP_aes_192_ecb();
             break;
         case 256:
-            cipher = EVP_aes_256_ecb();
+            cipher = ctr ? EVP_aes_256_ctr() : EVP_aes_256_ecb();
             break;
         default:
             EVP_CIPHER_CTX_free(*ctx);
@@ -151,6 +147,7 @@ static int aes_init(const unsigned char *key, const int bits, SIV_KEY_CTX *ctx)
 
     return 0; // Success
 #else
+    (void)ctr;
     return AES_set_encrypt_key(key, bits, ctx);
 #endif
 }
@@ -448,31 +445,16 @@ siv_init (siv_ctx *ctx, const unsigned char *key, int keylen)
     memset((char *)ctx, 0, sizeof(siv_ctx));
     switch (keylen) {
         case SIV_512:   /* a pair of 256 bit keys */
-            aes_init(key, 256, &ctx->s2v_sched);
-            aes_init(key+AES_256_BYTES, 256, &ctx->ctr_sched);
-#if OPENSSL_VERSION_NUMBER >= 0x30000000L
-            // Store the raw keys for OpenSSL 3.0
-            ctx->ctr_key_bits = 256;
-            memcpy(ctx->ctr_key, key+AES_256_BYTES, AES_256_BYTES);
-#endif
+            aes_init(key, 256, &ctx->s2v_sched, 0);
+            aes_init(key+AES_256_BYTES, 256, &ctx->ctr_sched, 1);
             break;
         case SIV_384:   /* a pair of 192 bit keys */
-            aes_init(key, 192, &ctx->s2v_sched);
-            aes_init(key+AES_192_BYTES, 192, &ctx->ctr_sched);
-#if OPENSSL_VERSION_NUMBER >= 0x30000000L
-            // Store the raw keys for OpenSSL 3.0
-            ctx->ctr_key_bits = 192;
-            memcpy(ctx->ctr_key, key+AES_192_BYTES, AES_192_BYTES);
-#endif
+            aes_init(key, 192, &ctx->s2v_sched, 0);
+            aes_init(key+AES_192_BYTES, 192, &ctx->ctr_sched, 1);
             break;
         case SIV_256:   /* a pair of 128 bit keys */
-            aes_init(key, 128, &ctx->s2v_sched);
-            aes_init(key+AES_128_BYTES, 128, &ctx->ctr_sched);
-#if OPENSSL_VERSION_NUMBER >= 0x30000000L
-            // Store the raw keys for OpenSSL 3.0
-            ctx->ctr_key_bits = 128;
-            memcpy(ctx->ctr_key, key+AES_128_BYTES, AES_128_BYTES);
-#endif
+            aes_init(key, 128, &ctx->s2v_sched, 0);
+            aes_init(key+AES_128_BYTES, 128, &ctx->ctr_sched, 1);
             break;
         default:
             return -1;
@@ -547,59 +529,26 @@ siv_aes_ctr (siv_ctx *ctx, const unsigned char *p, const int lenp,
         unsigned char *c, const unsigned char *iv)
 {
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
-    // For OpenSSL 3.0, we need a dedicated CTR mode context
-    EVP_CIPHER_CTX *ctr_ctx = EVP_CIPHER_CTX_new();
-    if (!ctr_ctx) {
+    if (ctx->ctr_sched == NULL) {
         return;
     }
-    
-    // Select the appropriate CTR cipher based on key size
-    const EVP_CIPHER *cipher = NULL;
-    switch (ctx->ctr_key_bits) {
-        case 128:
-            cipher = EVP_aes_128_ctr();
-            break;
-        case 192:
-            cipher = EVP_aes_192_ctr();
-            break;
-        case 256:
-            cipher = EVP_aes_256_ctr();
-            break;
-        default:
-            EVP_CIPHER_CTX_free(ctr_ctx);
-            return;
-    }
-    
+
     // Make a copy of the IV with the same constraints as in original code
     unsigned char ctr_iv[AES_BLOCK_SIZE];
     memcpy(ctr_iv, iv, AES_BLOCK_SIZE);
     ctr_iv[12] &= 0x7f;
     ctr_iv[8] &= 0x7f;
     
-    // Initialize with CTR mode
-    if (1 != EVP_EncryptInit_ex(ctr_ctx, cipher, NULL, ctx->ctr_key, ctr_iv)) {
-        EVP_CIPHER_CTX_free(ctr_ctx);
+    // ctr_sched is keyed by siv_init(), only the counter starts over
+    if (1 != EVP_EncryptInit_ex(ctx->ctr_sched, NULL, NULL, NULL, ctr_iv)) {
         return;
     }
     
-    // No padding needed
-    EVP_CIPHER_CTX_set_padding(ctr_ctx, 0);
-    
-    // Process data in one go
+    // Process data in one go, CTR has nothing to finalize
     int outlen = 0;
-    if (1 != EVP_EncryptUpdate(ctr_ctx, c, &outlen, p, lenp)) {
-        EVP_CIPHER_CTX_free(ctr_ctx);
-        return;
-    }
-    
-    // Finalize (should be a no-op with no padding)
-    int final_len = 0;
-    if (1 != EVP_EncryptFinal_ex(ctr_ctx, c + outlen, &final_len)) {
-        EVP_CIPHER_CTX_free(ctr_ctx);
+    if (1 != EVP_EncryptUpdate(ctx->ctr_sched, c, &outlen, p, lenp)) {
         return;
     }
-    
-    EVP_CIPHER_CTX_free(ctr_ctx);
 #else
     int i, j;
     unsigned char ctr[AES_BLOCK_SIZE], ecr[AES_BLOCK_SIZE];
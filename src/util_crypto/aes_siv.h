@@ -41,6 +41,7 @@
  *     - Enhanced Documentation
  *     - OpenSSL 3.0+ Compatability
  *         - Added `SIV_KEY_CTX` macro and temporary `ctr_key` storage in `siv_ctx`
+ *         - `ctr_sched` is a CTR context keyed once, replacing the raw `ctr_key` copy
  * Copyright 2025 Comcast Cable Communications Management, LLC
  */
 
@@ -80,11 +81,6 @@ typedef struct _siv_ctx {
     unsigned char K2[AES_BLOCK_SIZE];
     unsigned char T[AES_BLOCK_SIZE];
     unsigned char benchmark[AES_BLOCK_SIZE];
-#if OPENSSL_VERSION_NUMBER >= 0x30000000L
-    // Store raw keys for OpenSSL 3.0 ctr
-    unsigned char ctr_key[AES_BLOCK_SIZE*2]; // Up to 256 bits
-    int ctr_key_bits;                        // Key size in bits
-#endif
     SIV_KEY_CTX ctr_sched;
     SIV_KEY_CTX s2v_sched;
 } siv_ctx;
@@ -0,0 +1,347 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <sstream>
+#include "em_conformance.h"
+#include "em_hex.h"
+
+typedef struct {
+    em_msg_type_t type;
+    const char *name;
+} em_conformance_msg_name_t;
+
+// the names of the validation_test menu, which are those of em_msg_type_t
+static const em_conformance_msg_name_t s_msg_names[] = {
+    {em_msg_type_topo_disc, "topo_disc"},
+    {em_msg_type_topo_notif, "topo_notif"},
+    {em_msg_type_topo_query, "topo_query"},
+    {em_msg_type_topo_resp, "topo_resp"},
+    {em_msg_type_topo_vendor, "topo_vendor"},
+    {em_msg_type_link_metric_query, "link_metric_query"},
+    {em_msg_type_link_metric_resp, "link_metric_resp"},
+    {em_msg_type_autoconf_search, "autoconf_search"},
+    {em_msg_type_autoconf_resp, "autoconf_resp"},
+    {em_msg_type_autoconf_wsc, "autoconf_wsc"},
+    {em_msg_type_autoconf_renew, "autoconf_renew"},
+    {em_msg_type_1905_ack, "1905_ack"},
+    {em_msg_type_ap_cap_query, "ap_cap_query"},
+    {em_msg_type_ap_cap_rprt, "ap_cap_rprt"},
+    {em_msg_type_map_policy_config_req, "map_policy_config_req"},
+    {em_msg_type_channel_pref_query, "channel_pref_query"},
+    {em_msg_type_channel_pref_rprt, "channel_pref_rprt"},
+    {em_msg_type_channel_sel_req, "channel_sel_req"},
+    {em_msg_type_channel_sel_rsp, "channel_sel_rsp"},
+    {em_msg_type_op_channel_rprt, "op_channel_rprt"},
+    {em_msg_type_client_cap_query, "client_cap_query"},
+    {em_msg_type_client_cap_rprt, "client_cap_rprt"},
+    {em_msg_type_ap_metrics_query, "ap_metrics_query"},
+    {em_msg_type_ap_metrics_rsp, "ap_metrics_rsp"},
+    {em_msg_type_assoc_sta_link_metrics_query, "assoc_sta_link_metrics_query"},
+    {em_msg_type_assoc_sta_link_metrics_rsp, "assoc_sta_link_metrics_rsp"},
+    {em_msg_type_unassoc_sta_link_metrics_query, "unassoc_sta_link_metrics_query"},
+    {em_msg_type_unassoc_sta_link_metrics_rsp, "unassoc_sta_link_metrics_rsp"},
+    {em_msg_type_beacon_metrics_query, "beacon_metrics_query"},
+    {em_msg_type_beacon_metrics_rsp, "beacon_metrics_rsp"},
+    {em_msg_type_combined_infra_metrics, "combined_infra_metrics"},
+    {em_msg_type_client_steering_req, "client_steering_req"},
+    {em_msg_type_client_steering_btm_rprt, "client_steering_btm_rprt"},
+    {em_msg_type_client_assoc_ctrl_req, "client_assoc_ctrl_req"},
+    {em_msg_type_steering_complete, "steering_complete"},
+    {em_msg_type_higher_layer_data, "higher_layer_data"},
+    {em_msg_type_bh_steering_req, "bh_steering_req"},
+    {em_msg_type_bh_steering_rsp, "bh_steering_rsp"},
+    {em_msg_type_channel_scan_req, "channel_scan_req"},
+    {em_msg_type_channel_scan_rprt, "channel_scan_rprt"},
+    {em_msg_type_err_rsp, "err_rsp"},
+    {em_msg_type_assoc_status_notif, "assoc_status_notif"},
+    {em_msg_type_bh_sta_cap_query, "bh_sta_cap_query"},
+    {em_msg_type_bh_sta_cap_rprt, "bh_sta_cap_rprt"},
+};
+
+int em_conformance_t::get_msg_type(const char *name, em_msg_type_t *type)
+{
+    unsigned int i;
+    unsigned long val;
+    char *end;
+
+    for (i = 0; i < sizeof(s_msg_names)/sizeof(s_msg_names[0]); i++) {
+        if (strcmp(s_msg_names[i].name, name) == 0) {
+            *type = s_msg_names[i].type;
+            return 0;
+        }
+    }
+
+    val = strtoul(name, &end, 0);
+    if ((name[0] == '\0') || (*end != '\0') || (val > 0xffff)) {
+        return -1;
+    }
+    *type = static_cast<em_msg_type_t> (val);
+
+    return 0;
+}
+
+const char *em_conformance_t::get_msg_name(em_msg_type_t type)
+{
+    unsigned int i;
+
+    for (i = 0; i < sizeof(s_msg_names)/sizeof(s_msg_names[0]); i++) {
+        if (s_msg_names[i].type == type) {
+            return s_msg_names[i].name;
+        }
+    }
+
+    return "unknown";
+}
+
+int em_conformance_t::parse_line(const std::string& line, std::string& err)
+{
+    std::istringstream in(line);
+    std::string key, arg, opt;
+    em_conformance_scenario_t *scenario;
+    em_conformance_step_t *step;
+    em_conformance_tlv_t tlv;
+    unsigned long val;
+    char *end;
+
+    if (!(in >> key)) {
+        return 0;
+    }
+
+    if (key == "scenario") {
+        if (!(in >> arg)) {
+            err = "scenario without a name";
+            return -1;
+        }
+        m_scenarios.emplace_back();
+        scenario = &m_scenarios.back();
+        scenario->name = arg;
+        scenario->iterations = 1;
+        scenario->profile = em_profile_type_3;
+        memset(&scenario->stats, 0, sizeof(scenario->stats));
+        return 0;
+    }
+
+    if (m_scenarios.empty() == true) {
+        err = key + " before the first scenario";
+        return -1;
+    }
+    scenario = &m_scenarios.back();
+    step = (scenario->steps.empty() == true) ? NULL:&scenario->steps.back();
+
+    if (key == "iterations") {
+        if (!(in >> val) || (val == 0)) {
+            err = "iterations needs a positive count";
+            return -1;
+        }
+        scenario->iterations = static_cast<unsigned int> (val);
+    } else if (key == "profile") {
+        if (!(in >> val) || (val < em_profile_type_1) || (val > em_profile_type_3)) {
+            err = "profile needs 1, 2 or 3";
+            return -1;
+        }
+        scenario->profile = static_cast<em_profile_type_t> (val);
+    } else if (key == "send") {
+        scenario->steps.emplace_back();
+        step = &scenario->steps.back();
+        step->dst = em_conformance_dst_ctrl;
+        step->expect = false;
+        step->expect_type = em_msg_type_1905_ack;
+        step->timeout_ms = EM_CONFORMANCE_DEF_TIMEOUT_MS;
+        step->match_id = true;
+        if (!(in >> arg) || (get_msg_type(arg.c_str(), &step->type) != 0)) {
+            err = "send needs a known message, not " + arg;
+            return -1;
+        }
+        if (in >> opt) {
+            if (opt == "multicast") {
+                step->dst = em_conformance_dst_multicast;
+            } else if (opt != "ctrl") {
+                err = "send goes to ctrl or multicast, not " + opt;
+                return -1;
+            }
+        }
+    } else if (key == "tlv") {
+        if (step == NULL) {
+            err = "tlv before the first send";
+            return -1;
+        }
+        if (!(in >> arg) || ((val = strtoul(arg.c_str(), &end, 0)) > 0xff) || (*end != '\0')) {
+            err = "tlv needs a type below 256, not " + arg;
+            return -1;
+        }
+        tlv.type = static_cast<em_tlv_type_t> (val);
+        while (in >> arg) {
+            if ((arg != "$al") && (arg != "$ctrl") && (((arg.size() % 2) != 0) ||
+                    (arg.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos))) {
+                err = "tlv value must be hex bytes, $al or $ctrl, not " + arg;
+                return -1;
+            }
+            tlv.tokens.push_back(arg);
+        }
+        step->tlvs.push_back(tlv);
+    } else if (key == "expect") {
+        if (step == NULL) {
+            err = "expect before the first send";
+            return -1;
+        }
+        if (!(in >> arg) || (get_msg_type(arg.c_str(), &step->expect_type) != 0)) {
+            err = "expect needs a known message, not " + arg;
+            return -1;
+        }
+        step->expect = true;
+        if ((in >> val) && (val != 0)) {
+            step->timeout_ms = static_cast<unsigned int> (val);
+        }
+        in.clear();
+        if (in >> opt) {
+            if (opt == "anyid") {
+                step->match_id = false;
+            } else {
+                err = "expect takes anyid, not " + opt;
+                return -1;
+            }
+        }
+    } else {
+        err = "unknown keyword " + key;
+        return -1;
+    }
+
+    return 0;
+}
+
+int em_conformance_t::parse(const char *text, std::string& err)
+{
+    std::istringstream in(text);
+    std::string line;
+    unsigned int num = 0;
+    size_t pos;
+
+    while (std::getline(in, line)) {
+        num++;
+        if ((pos = line.find('#')) != std::string::npos) {
+            line.erase(pos);
+        }
+        if (parse_line(line, err) != 0) {
+            err = "line " + std::to_string(num) + ": " + err;
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int em_conformance_t::load(const char *path, std::string& err)
+{
+    std::ifstream file(path);
+    std::stringstream text;
+
+    if (!file) {
+        err = std::string("could not open ") + path;
+        return -1;
+    }
+    text << file.rdbuf();
+
+    return parse(text.str().c_str(), err);
+}
+
+int em_conformance_t::resolve(const em_conformance_tlv_t& tlv, unsigned char *value, unsigned int max)
+{
+    unsigned int len = 0, sz;
+
+    for (const auto& tok : tlv.tokens) {
+        if ((tok == "$al") || (tok == "$ctrl")) {
+            if ((tok == "$ctrl") && (m_ctrl_known == false)) {
+                printf("%s:%d: $ctrl used before the controller is known\n", __func__, __LINE__);
+                return -1;
+            }
+            if ((len + sizeof(mac_address_t)) > max) {
+                return -1;
+            }
+            memcpy(&value[len], (tok == "$al") ? m_al_mac:m_ctrl_mac, sizeof(mac_address_t));
+            len += static_cast<unsigned int> (sizeof(mac_address_t));
+        } else {
+            sz = static_cast<unsigned int> (tok.size() / 2);
+            if ((len + sz) > max) {
+                return -1;
+            }
+            em_hex::decode(tok.c_str(), tok.size(), &value[len]);
+            len += sz;
+        }
+    }
+
+    return static_cast<int> (len);
+}
+
+int em_conformance_t::build(const em_conformance_step_t& step, unsigned short msg_id, em_tlv_writer_t& writer)
+{
+    mac_address_t multi_addr = {0x01, 0x80, 0xc2, 0x00, 0x00, 0x13};
+    unsigned char *value;
+    int len;
+
+    if ((step.dst == em_conformance_dst_ctrl) && (m_ctrl_known == false)) {
+        printf("%s:%d: %s sent to the controller before it is known\n", __func__, __LINE__, get_msg_name(step.type));
+        return -1;
+    }
+
+    writer.begin((step.dst == em_conformance_dst_ctrl) ? m_ctrl_mac:multi_addr, m_al_mac, step.type, msg_id);
+    for (const auto& tlv : step.tlvs) {
+        if ((value = writer.open_tlv(tlv.type)) == NULL) {
+            return -1;
+        }
+        if ((len = resolve(tlv, value, EM_TLV_WRITER_MAX_VALUE_LEN)) < 0) {
+            writer.close_tlv(0);
+            return -1;
+        }
+        writer.close_tlv(static_cast<unsigned int> (len));
+    }
+
+    return writer.finish();
+}
+
+bool em_conformance_t::match(const em_conformance_step_t& step, unsigned short msg_id, const unsigned char *frame, unsigned int len)
+{
+    const em_raw_hdr_t *hdr = reinterpret_cast<const em_raw_hdr_t *> (frame);
+    const em_cmdu_t *cmdu = reinterpret_cast<const em_cmdu_t *> (frame + sizeof(em_raw_hdr_t));
+
+    if ((step.expect == false) || (len < (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t))) ||
+            (ntohs(hdr->type) != ETH_P_1905) || (em_hex::mac_equal(hdr->src, m_al_mac) == true)) {
+        return false;
+    }
+
+    if ((m_ctrl_known == true) && (em_hex::mac_equal(hdr->src, m_ctrl_mac) == false)) {
+        return false;
+    }
+
+    if (ntohs(cmdu->type) != step.expect_type) {
+        return false;
+    }
+
+    return (step.match_id == false) || (ntohs(cmdu->id) == msg_id);
+}
+
+em_conformance_t::em_conformance_t() : m_scenarios(), m_al_mac(), m_ctrl_mac(), m_ctrl_known(false)
+{
+}
+
+em_conformance_t::~em_conformance_t()
+{
+}
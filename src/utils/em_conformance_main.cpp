@@ -0,0 +1,340 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <string>
+#include <vector>
+#include "em_conformance.h"
+#include "em_msg.h"
+#include "em_hex.h"
+
+typedef struct {
+    std::vector<std::string> scripts;
+    char            ifname[IFNAMSIZ];
+    char            scenario[64];   // only the scenario of this name
+    int             pid;            // controller whose cpu use is reported
+    bool            ctrl_given;
+    unsigned char   ctrl[ETH_ALEN];
+} em_conformance_config_t;
+
+static int open_socket(const char *ifname, struct sockaddr_ll *addr, unsigned char *mac)
+{
+    struct ifreq ifr;
+    int sock;
+
+    if ((sock = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_1905))) < 0) {
+        printf("%s:%d: Failed to open raw socket, err:%d\n", __func__, __LINE__, errno);
+        return -1;
+    }
+
+    memset(addr, 0, sizeof(struct sockaddr_ll));
+    addr->sll_family = AF_PACKET;
+    addr->sll_protocol = htons(ETH_P_1905);
+    if ((addr->sll_ifindex = static_cast<int>(if_nametoindex(ifname))) == 0) {
+        printf("%s:%d: Unknown interface:%s\n", __func__, __LINE__, ifname);
+        close(sock);
+        return -1;
+    }
+    addr->sll_halen = ETH_ALEN;
+
+    if (bind(sock, reinterpret_cast<struct sockaddr *>(addr), sizeof(struct sockaddr_ll)) < 0) {
+        printf("%s:%d: Failed to bind to %s, err:%d\n", __func__, __LINE__, ifname, errno);
+        close(sock);
+        return -1;
+    }
+
+    memset(&ifr, 0, sizeof(ifr));
+    snprintf(ifr.ifr_name, sizeof(ifr.ifr_name), "%s", ifname);
+    if (ioctl(sock, SIOCGIFHWADDR, &ifr) < 0) {
+        printf("%s:%d: Failed to get the MAC address of %s, err:%d\n", __func__, __LINE__, ifname, errno);
+        close(sock);
+        return -1;
+    }
+    memcpy(mac, ifr.ifr_hwaddr.sa_data, ETH_ALEN);
+
+    return sock;
+}
+
+// user and system time of a process in clock ticks, 0 if it cannot be read
+static unsigned long long get_cpu_ticks(int pid)
+{
+    char path[64], buff[1024], *p;
+    unsigned long long utime = 0, stime = 0;
+    FILE *fp;
+    size_t len;
+
+    if (pid <= 0) {
+        return 0;
+    }
+
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    if ((fp = fopen(path, "r")) == NULL) {
+        return 0;
+    }
+    len = fread(buff, 1, sizeof(buff) - 1, fp);
+    fclose(fp);
+    buff[len] = '\0';
+
+    // the command name may hold spaces, fields 14 and 15 are counted from its closing bracket
+    if (((p = strrchr(buff, ')')) == NULL) ||
+            (sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu", &utime, &stime) != 2)) {
+        return 0;
+    }
+
+    return utime + stime;
+}
+
+/*
+ * Waits for the answer to a step and reassembles its fragments into buff. The frames
+ * of other exchanges, e.g. the controller's own topology queries, are dropped.
+ *
+ * Returns the length of the answer, 0 on timeout, -1 on failure.
+ */
+static int wait_answer(em_conformance_t *conf, const em_conformance_step_t& step, unsigned short msg_id,
+    int sock, unsigned char *buff, unsigned int max, uint64_t deadline_us)
+{
+    unsigned char frame[EM_MAX_FRAME_SZ];
+    const unsigned int hdr_len = static_cast<unsigned int>(sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
+    struct pollfd pfd;
+    em_cmdu_t *cmdu;
+    unsigned int len = 0;
+    uint64_t now_us;
+    ssize_t ret;
+
+    pfd.fd = sock;
+    pfd.events = POLLIN;
+
+    while ((now_us = em_lat_hist_t::get_time_us()) < deadline_us) {
+        pfd.revents = 0;
+        if (poll(&pfd, 1, static_cast<int>((deadline_us - now_us + 999) / 1000)) <= 0) {
+            continue;
+        }
+        if ((ret = recv(sock, frame, sizeof(frame), 0)) <= 0) {
+            if ((ret < 0) && (errno != EINTR)) {
+                return -1;
+            }
+            continue;
+        }
+        if (conf->match(step, msg_id, frame, static_cast<unsigned int>(ret)) == false) {
+            continue;
+        }
+
+        // the first fragment keeps its header, the others only add their TLVs
+        if (len == 0) {
+            if (static_cast<unsigned int>(ret) > max) {
+                return -1;
+            }
+            memcpy(buff, frame, static_cast<size_t>(ret));
+            len = static_cast<unsigned int>(ret);
+        } else {
+            if ((len + static_cast<unsigned int>(ret) - hdr_len) > max) {
+                return -1;
+            }
+            memcpy(buff + len, frame + hdr_len, static_cast<size_t>(ret) - hdr_len);
+            len += static_cast<unsigned int>(ret) - hdr_len;
+        }
+
+        cmdu = reinterpret_cast<em_cmdu_t *>(frame + sizeof(em_raw_hdr_t));
+        if (cmdu->last_frag_ind == 1) {
+            if (conf->is_ctrl_known() == false) {
+                conf->set_ctrl_mac(reinterpret_cast<em_raw_hdr_t *>(frame)->src);
+            }
+            return static_cast<int>(len);
+        }
+    }
+
+    return 0;
+}
+
+static void run_step(em_conformance_t *conf, em_conformance_scenario_t& scenario, const em_conformance_step_t& step,
+    unsigned short msg_id, int sock, struct sockaddr_ll *addr, em_tlv_writer_t& writer, unsigned char *answer)
+{
+    unsigned char *frame;
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    unsigned int i, len;
+    uint64_t start_us;
+    int num, ret;
+
+    if ((num = conf->build(step, msg_id, writer)) < 0) {
+        scenario.stats.errors++;
+        return;
+    }
+
+    start_us = em_lat_hist_t::get_time_us();
+    for (i = 0; i < static_cast<unsigned int>(num); i++) {
+        frame = writer.get_frame(i, &len);
+        memcpy(addr->sll_addr, frame, ETH_ALEN);
+        if (sendto(sock, frame, len, 0, reinterpret_cast<struct sockaddr *>(addr), sizeof(struct sockaddr_ll)) < 0) {
+            scenario.stats.errors++;
+            return;
+        }
+        scenario.stats.bytes += len;
+    }
+    scenario.stats.sent++;
+
+    if (step.expect == false) {
+        return;
+    }
+
+    ret = wait_answer(conf, step, msg_id, sock, answer, static_cast<unsigned int>(EM_CONFORMANCE_MAX_ANSWER_SZ),
+        start_us + (static_cast<uint64_t>(step.timeout_ms) * 1000));
+    if (ret < 0) {
+        scenario.stats.errors++;
+        return;
+    } else if (ret == 0) {
+        printf("%s: no %s to %s %u within %u ms\n", scenario.name.c_str(), em_conformance_t::get_msg_name(step.expect_type),
+            em_conformance_t::get_msg_name(step.type), msg_id, step.timeout_ms);
+        scenario.stats.timeouts++;
+        return;
+    }
+
+    scenario.lat.add(em_lat_hist_t::get_time_us() - start_us);
+    scenario.stats.answered++;
+
+    if (em_msg_t(step.expect_type, scenario.profile, answer, static_cast<unsigned int>(ret)).validate(errors) == 0) {
+        printf("%s: invalid %s:", scenario.name.c_str(), em_conformance_t::get_msg_name(step.expect_type));
+        for (i = 0; (i < EM_MAX_TLV_MEMBERS) && (errors[i] != NULL); i++) {
+            printf(" %s", errors[i]);
+        }
+        printf("\n");
+        scenario.stats.invalid++;
+    }
+}
+
+static void report(em_conformance_scenario_t& scenario)
+{
+    em_conformance_stats_t *stats = &scenario.stats;
+    double secs = static_cast<double>(stats->elapsed_us) / 1000000;
+    long hz = sysconf(_SC_CLK_TCK);
+
+    printf("%-16s %6u sent %6u answered %4u invalid %4u timeouts %4u errors %9.0f msgs/s "
+        "p50 %6llu us p99 %6llu us max %6llu us",
+        scenario.name.c_str(), stats->sent, stats->answered, stats->invalid, stats->timeouts, stats->errors,
+        (secs > 0) ? (static_cast<double>(stats->sent) / secs):0.0,
+        static_cast<unsigned long long>(scenario.lat.get_percentile_us(50)),
+        static_cast<unsigned long long>(scenario.lat.get_percentile_us(99)),
+        static_cast<unsigned long long>(scenario.lat.get_max_us()));
+    if ((hz > 0) && (secs > 0)) {
+        printf(" ctrl cpu %5.1f%%", static_cast<double>(stats->cpu_ticks) * 100 / static_cast<double>(hz) / secs);
+    }
+    printf("\n");
+}
+
+int main(int argc, const char *argv[])
+{
+    em_conformance_config_t cfg;
+    em_conformance_t conf;
+    em_tlv_writer_t writer;
+    struct sockaddr_ll addr;
+    unsigned char al_mac[ETH_ALEN];
+    unsigned char *answer;
+    unsigned short msg_id = 0;
+    unsigned long long cpu_start;
+    uint64_t start_us;
+    std::string arg, err;
+    unsigned int it;
+    int sock, failed = 0, i;
+
+    if (argc < 3) {
+        printf("Usage: %s --script=file.cmdu [--script=...] --interface=iface [--ctrl=mac] [--pid=ctrl pid] "
+            "[--scenario=name]\n", argv[0]);
+        printf("Runs the scripted CMDU sequences against a controller reachable on the interface, checks its "
+            "answers with em_msg_t::validate() and reports throughput, latency and, with --pid, its cpu use.\n");
+        return -1;
+    }
+
+    cfg.ifname[0] = '\0';
+    cfg.scenario[0] = '\0';
+    cfg.pid = 0;
+    cfg.ctrl_given = false;
+
+    for (i = 1; i < argc; i++) {
+        arg = argv[i];
+        if (arg.find("--script=") == 0) {
+            cfg.scripts.push_back(arg.substr(strlen("--script=")));
+        } else if (arg.find("--interface=") == 0) {
+            snprintf(cfg.ifname, sizeof(cfg.ifname), "%s", arg.substr(strlen("--interface=")).c_str());
+        } else if (arg.find("--scenario=") == 0) {
+            snprintf(cfg.scenario, sizeof(cfg.scenario), "%s", arg.substr(strlen("--scenario=")).c_str());
+        } else if (arg.find("--pid=") == 0) {
+            cfg.pid = atoi(arg.substr(strlen("--pid=")).c_str());
+        } else if ((arg.find("--ctrl=") == 0) && (em_hex::str_to_mac(arg.c_str() + strlen("--ctrl="), cfg.ctrl) == 0)) {
+            cfg.ctrl_given = true;
+        } else {
+            printf("Invalid argument: %s\n", arg.c_str());
+            return -1;
+        }
+    }
+
+    if ((cfg.scripts.empty() == true) || (cfg.ifname[0] == '\0')) {
+        printf("Missing --script or --interface\n");
+        return -1;
+    }
+
+    for (const auto& script : cfg.scripts) {
+        if (conf.load(script.c_str(), err) != 0) {
+            printf("%s: %s\n", script.c_str(), err.c_str());
+            return -1;
+        }
+    }
+
+    if ((sock = open_socket(cfg.ifname, &addr, al_mac)) < 0) {
+        return -1;
+    }
+    conf.set_al_mac(al_mac);
+    if (cfg.ctrl_given == true) {
+        conf.set_ctrl_mac(cfg.ctrl);
+    }
+
+    answer = static_cast<unsigned char *>(malloc(EM_CONFORMANCE_MAX_ANSWER_SZ));
+    for (auto& scenario : conf.get_scenarios()) {
+        if ((cfg.scenario[0] != '\0') && (scenario.name != cfg.scenario)) {
+            continue;
+        }
+
+        cpu_start = get_cpu_ticks(cfg.pid);
+        start_us = em_lat_hist_t::get_time_us();
+        for (it = 0; it < scenario.iterations; it++) {
+            for (const auto& step : scenario.steps) {
+                run_step(&conf, scenario, step, ++msg_id, sock, &addr, writer, answer);
+            }
+        }
+        scenario.stats.elapsed_us = em_lat_hist_t::get_time_us() - start_us;
+        scenario.stats.cpu_ticks = (cfg.pid > 0) ? (get_cpu_ticks(cfg.pid) - cpu_start):0;
+
+        report(scenario);
+        if ((scenario.stats.invalid + scenario.stats.timeouts + scenario.stats.errors) != 0) {
+            failed++;
+        }
+    }
+    free(answer);
+    close(sock);
+
+    return (failed != 0) ? -1:0;
+}
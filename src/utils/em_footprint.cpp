@@ -0,0 +1,71 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Footprint of the large types and of the limits they are sized by, for
+ * build/footprint-report.sh. Each symbol below is an array as large as what it
+ * describes, so that nm -S reads the sizes off the object built for the target,
+ * cross builds included, without running anything on it. The object is not linked
+ * into the programs.
+ */
+
+#include "em_base.h"
+#include "dm_easy_mesh.h"
+#include "dm_policy.h"
+#include "dm_sta.h"
+#include "dm_scan_result.h"
+#include "em.h"
+#include "em_cmd.h"
+
+#define EM_FOOTPRINT_TYPE(type)     char em_footprint_type_##type[sizeof(type)];
+#define EM_FOOTPRINT_LIMIT(limit)   char em_footprint_limit_##limit[limit];
+
+extern "C" {
+
+EM_FOOTPRINT_TYPE(dm_easy_mesh_t)
+EM_FOOTPRINT_TYPE(dm_network_t)
+EM_FOOTPRINT_TYPE(dm_device_t)
+EM_FOOTPRINT_TYPE(dm_network_ssid_t)
+EM_FOOTPRINT_TYPE(dm_radio_t)
+EM_FOOTPRINT_TYPE(dm_radio_cap_t)
+EM_FOOTPRINT_TYPE(dm_bss_t)
+EM_FOOTPRINT_TYPE(dm_op_class_t)
+EM_FOOTPRINT_TYPE(dm_policy_t)
+EM_FOOTPRINT_TYPE(dm_sta_t)
+EM_FOOTPRINT_TYPE(dm_scan_result_t)
+EM_FOOTPRINT_TYPE(dm_ap_mld_t)
+EM_FOOTPRINT_TYPE(dm_bsta_mld_t)
+EM_FOOTPRINT_TYPE(dm_assoc_sta_mld_t)
+EM_FOOTPRINT_TYPE(em_t)
+EM_FOOTPRINT_TYPE(em_cmd_t)
+EM_FOOTPRINT_TYPE(em_event_t)
+EM_FOOTPRINT_TYPE(em_bus_event_t)
+EM_FOOTPRINT_TYPE(em_qos_mgmt_policy_t)
+
+EM_FOOTPRINT_LIMIT(EM_MAX_NETWORKS)
+EM_FOOTPRINT_LIMIT(EM_MAX_DEVICES)
+EM_FOOTPRINT_LIMIT(EM_MAX_BSSS)
+EM_FOOTPRINT_LIMIT(EM_MAX_OPCLASS)
+EM_FOOTPRINT_LIMIT(EM_MAX_POLICIES)
+EM_FOOTPRINT_LIMIT(EM_MAX_STA_PER_BSS)
+EM_FOOTPRINT_LIMIT(EM_MAX_EVENT_DATA_LEN)
+EM_FOOTPRINT_LIMIT(EM_MAX_AP_MLD)
+EM_FOOTPRINT_LIMIT(EM_MAX_BSTA_MLD)
+EM_FOOTPRINT_LIMIT(EM_MAX_ASSOC_STA_MLD)
+
+}
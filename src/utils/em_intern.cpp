@@ -0,0 +1,131 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <atomic>
+#include "em_intern.h"
+
+// the last string a thread looked up, the same network id is looked up for every frame
+typedef struct {
+    unsigned int table;     // serial of the table, a table made again at the same address is another one
+    em_intern_id_t id;
+    const char *str;        // interned, never moves
+    size_t len;
+} em_intern_last_t;
+
+static thread_local em_intern_last_t s_last = {0, EM_INTERN_NONE, NULL, 0};
+static std::atomic<unsigned int> s_serial(0);
+
+em_intern_id_t em_intern_t::intern(const char *str, size_t max)
+{
+    em_intern_id_t id;
+
+    if (str == NULL) {
+        return EM_INTERN_NONE;
+    }
+
+    // nearly always known already, the read lock is enough
+    if ((id = find(str, max)) != EM_INTERN_NONE) {
+        return id;
+    }
+
+    std::string key(str, strnlen(str, max));
+
+    pthread_rwlock_wrlock(&m_lock);
+    auto it = m_ids.find(key);
+    if (it != m_ids.end()) {
+        id = it->second;
+    } else {
+        m_strs.push_back(key);
+        id = static_cast<em_intern_id_t> (m_strs.size());
+        m_ids.emplace(key, id);
+    }
+    pthread_rwlock_unlock(&m_lock);
+
+    return id;
+}
+
+em_intern_id_t em_intern_t::find(const char *str, size_t max)
+{
+    em_intern_id_t id = EM_INTERN_NONE;
+
+    if (str == NULL) {
+        return EM_INTERN_NONE;
+    }
+
+    if ((s_last.table == m_serial) && (s_last.len <= max) && (strncmp(s_last.str, str, max) == 0)) {
+        return s_last.id;
+    }
+
+    std::string key(str, strnlen(str, max));
+
+    pthread_rwlock_rdlock(&m_lock);
+    auto it = m_ids.find(key);
+    if (it != m_ids.end()) {
+        id = it->second;
+        s_last.table = m_serial;
+        s_last.id = id;
+        s_last.str = m_strs[id - 1].c_str();
+        s_last.len = m_strs[id - 1].size();
+    }
+    pthread_rwlock_unlock(&m_lock);
+
+    return id;
+}
+
+const char *em_intern_t::get_str(em_intern_id_t id)
+{
+    const char *str = "";
+
+    pthread_rwlock_rdlock(&m_lock);
+    if ((id != EM_INTERN_NONE) && (id <= m_strs.size())) {
+        str = m_strs[id - 1].c_str();
+    }
+    pthread_rwlock_unlock(&m_lock);
+
+    return str;
+}
+
+unsigned int em_intern_t::count()
+{
+    unsigned int num;
+
+    pthread_rwlock_rdlock(&m_lock);
+    num = static_cast<unsigned int> (m_strs.size());
+    pthread_rwlock_unlock(&m_lock);
+
+    return num;
+}
+
+em_intern_t *em_intern_t::get_table()
+{
+    // never destroyed, the handles in static data models stay valid at exit
+    static em_intern_t *table = new em_intern_t();
+
+    return table;
+}
+
+em_intern_t::em_intern_t() : m_lock(), m_serial(++s_serial), m_ids(), m_strs()
+{
+    pthread_rwlock_init(&m_lock, NULL);
+}
+
+em_intern_t::~em_intern_t()
+{
+    pthread_rwlock_destroy(&m_lock);
+}
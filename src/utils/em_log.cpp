@@ -0,0 +1,543 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/time.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+#include <new>
+#include "em_log.h"
+
+extern "C" {
+    extern char *__progname;
+}
+
+static const struct {
+    const char *name;
+    const char *dbg_enable;
+} s_module_files[EM_LOG_NUM_MODULES] = {
+    {"", ""},                           // EM_STDOUT
+    {"emAgent", "emAgentDbg"},
+    {"emCtrl", "emCtrlDbg"},
+    {"emMgr", "emMgrDbg"},
+    {"emDb", "emDbDbg"},
+    {"emProv", "emProvDbg"},
+    {"emConf", "emConfDbg"},
+};
+
+static unsigned long long get_now_ms()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return static_cast<unsigned long long>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+// localtime() looks at the time zone file on every call, the date only changes once per second
+static void get_formatted_time(char *buff, unsigned int len)
+{
+    static thread_local time_t s_sec = -1;
+    static thread_local char s_date[64];
+    struct timeval tv_now;
+    struct tm tm_info;
+
+    gettimeofday(&tv_now, NULL);
+    if (tv_now.tv_sec != s_sec) {
+        localtime_r(&tv_now.tv_sec, &tm_info);
+        strftime(s_date, sizeof(s_date), "%m/%d/%Y - %T", &tm_info);
+        s_sec = tv_now.tv_sec;
+    }
+
+    snprintf(buff, len, "%s.%06lld", s_date, static_cast<long long>(tv_now.tv_usec));
+}
+
+static void get_file_path(const char *dir, const em_log_module_t *mod, unsigned int idx, char *path, unsigned int len)
+{
+    snprintf(path, len, "%s%s%s", dir, mod->name, (idx == 0) ? "":".txt");
+}
+
+em_log_dest_t em_log_t::get_dest(easymesh_log_level_t level, easymesh_dbg_type_t module)
+{
+    if (module == EM_STDOUT) {
+        return em_log_dest_stdout;
+    }
+    if ((static_cast<unsigned int>(module) >= EM_LOG_NUM_MODULES) || (m_cells == NULL)) {
+        return em_log_dest_none;
+    }
+    if (m_modules[module].debug.load(std::memory_order_relaxed) == true) {
+        return em_log_dest_debug;
+    }
+
+    return ((level == EM_LOG_LVL_INFO) || (level == EM_LOG_LVL_ERROR)) ? em_log_dest_file:em_log_dest_none;
+}
+
+em_log_cell_t *em_log_t::reserve(size_t *pos)
+{
+    em_log_cell_t *cell;
+    size_t seq;
+    intptr_t dif;
+
+    *pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    while (true) {
+        cell = &m_cells[*pos & m_mask];
+        seq = cell->seq.load(std::memory_order_acquire);
+        dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(*pos);
+        if (dif == 0) {
+            if (m_enqueue_pos.compare_exchange_weak(*pos, *pos + 1, std::memory_order_relaxed) == true) {
+                return cell;
+            }
+        } else if (dif < 0) {
+            m_drops++;
+            return NULL;
+        } else {
+            *pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void em_log_t::publish(em_log_cell_t *cell, size_t pos)
+{
+    cell->seq.store(pos + 1, std::memory_order_seq_cst);
+
+    // only pay for the syscall when the writer is asleep
+    if (m_waiting.load(std::memory_order_seq_cst) == true) {
+        wake();
+    }
+}
+
+void em_log_t::vprint(easymesh_log_level_t level, easymesh_dbg_type_t module, const char *func, int line, const char *format, va_list args)
+{
+    em_log_dest_t dest = get_dest(level, module);
+    em_log_cell_t local, *cell;
+    char time_buff[96];
+    const char *severity;
+    unsigned int hdr;
+    size_t pos = 0;
+    va_list copy;
+    FILE *fp;
+    int n;
+
+    if (dest == em_log_dest_none) {
+        return;
+    }
+
+    switch (level) {
+        case EM_LOG_LVL_INFO:
+            severity = "INFO";
+            break;
+        case EM_LOG_LVL_ERROR:
+            severity = "ERROR";
+            break;
+        case EM_LOG_LVL_DEBUG:
+            severity = "DEBUG";
+            break;
+        default:
+            severity = "UNKNOWN";
+            break;
+    }
+
+    if (m_running == false) {
+        cell = &local;
+    } else if ((cell = reserve(&pos)) == NULL) {
+        return;
+    }
+
+    get_formatted_time(time_buff, sizeof(time_buff));
+    n = snprintf(cell->text, sizeof(cell->text), "[%s] %s %s:%s:%d: %s: ", __progname ? __progname : "", time_buff,
+        m_modules[module].name, func, line, severity);
+    hdr = ((n < 0) || (n >= static_cast<int>(sizeof(cell->text)))) ? sizeof(cell->text) - 1:static_cast<unsigned int>(n);
+
+    va_copy(copy, args);
+    n = vsnprintf(cell->text + hdr, sizeof(cell->text) - hdr, format, copy);
+    va_end(copy);
+    n = (n < 0) ? 0:n;
+
+    cell->module = static_cast<unsigned char>(module);
+    cell->dest = static_cast<unsigned char>(dest);
+    cell->big = NULL;
+    if (hdr + n + 1 < sizeof(cell->text)) {
+        cell->len = hdr + n + 1;
+        cell->text[cell->len - 1] = '\n';
+    } else if ((cell->big = static_cast<char *>(malloc(hdr + n + 2))) != NULL) {
+        memcpy(cell->big, cell->text, hdr);
+        vsnprintf(cell->big + hdr, n + 1, format, args);
+        cell->len = hdr + n + 1;
+        cell->big[cell->len - 1] = '\n';
+    } else {
+        cell->len = sizeof(cell->text) - 1;
+        cell->text[cell->len - 1] = '\n';
+    }
+
+    if (cell == &local) {
+        pthread_mutex_lock(&m_lock);
+        if ((fp = output(cell)) != NULL) {
+            fflush(fp);
+        }
+        pthread_mutex_unlock(&m_lock);
+        return;
+    }
+
+    publish(cell, pos);
+}
+
+void em_log_t::write(easymesh_log_level_t level, easymesh_dbg_type_t module, const char *text, unsigned int len)
+{
+    em_log_dest_t dest = get_dest(level, module);
+    em_log_cell_t local, *cell;
+    size_t pos = 0;
+    FILE *fp;
+
+    if (dest == em_log_dest_none) {
+        return;
+    }
+
+    if (m_running == false) {
+        cell = &local;
+    } else if ((cell = reserve(&pos)) == NULL) {
+        return;
+    }
+
+    cell->module = static_cast<unsigned char>(module);
+    cell->dest = static_cast<unsigned char>(dest);
+    cell->big = NULL;
+    if (len <= sizeof(cell->text)) {
+        memcpy(cell->text, text, len);
+        cell->len = len;
+    } else if ((cell->big = static_cast<char *>(malloc(len))) != NULL) {
+        memcpy(cell->big, text, len);
+        cell->len = len;
+    } else {
+        memcpy(cell->text, text, sizeof(cell->text));
+        cell->len = sizeof(cell->text);
+    }
+
+    if (cell == &local) {
+        pthread_mutex_lock(&m_lock);
+        if ((fp = output(cell)) != NULL) {
+            fflush(fp);
+        }
+        pthread_mutex_unlock(&m_lock);
+        return;
+    }
+
+    publish(cell, pos);
+}
+
+FILE *em_log_t::output(em_log_cell_t *cell)
+{
+    em_log_module_t *mod = &m_modules[cell->module];
+    unsigned int idx = cell->dest - em_log_dest_debug;
+    char path[256];
+    struct stat st;
+    FILE *fp;
+
+    if (cell->dest == em_log_dest_stdout) {
+        fp = stdout;
+    } else {
+        if (mod->fp[idx] == NULL) {
+            get_file_path((idx == 0) ? m_dbg_dir:m_log_dir, mod, idx, path, sizeof(path));
+            if ((mod->fp[idx] = fopen(path, "a")) != NULL) {
+                fstat(fileno(mod->fp[idx]), &st);
+                mod->dev[idx] = st.st_dev;
+                mod->ino[idx] = st.st_ino;
+            }
+        }
+        fp = mod->fp[idx];
+    }
+
+    if (fp != NULL) {
+        fwrite((cell->big != NULL) ? cell->big:cell->text, 1, cell->len, fp);
+    }
+
+    free(cell->big);
+    cell->big = NULL;
+
+    return fp;
+}
+
+void em_log_t::write_cells()
+{
+    size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+    em_log_cell_t *cell;
+    unsigned int i, j, drops, num = 0;
+
+    while (true) {
+        cell = &m_cells[pos & m_mask];
+        if (cell->seq.load(std::memory_order_acquire) != (pos + 1)) {
+            break;
+        }
+        output(cell);
+        cell->seq.store(pos + m_mask + 1, std::memory_order_release);
+        pos++;
+        num++;
+    }
+
+    drops = m_drops.load(std::memory_order_relaxed);
+    if (drops != m_drops_logged) {
+        fprintf(stdout, "[%s] em_log: %u log messages dropped, the ring was full\n", __progname ? __progname : "",
+            drops - m_drops_logged);
+        m_drops_logged = drops;
+        num++;
+    }
+
+    if (num == 0) {
+        return;
+    }
+
+    // one write per file for the whole batch
+    fflush(stdout);
+    for (i = 0; i < EM_LOG_NUM_MODULES; i++) {
+        for (j = 0; j < 2; j++) {
+            if (m_modules[i].fp[j] != NULL) {
+                fflush(m_modules[i].fp[j]);
+            }
+        }
+    }
+    m_dequeue_pos.store(pos, std::memory_order_release);
+}
+
+void em_log_t::check_files()
+{
+    em_log_module_t *mod;
+    char path[256];
+    struct stat st;
+    unsigned int i, j;
+    bool debug;
+
+    for (i = 0; i < EM_LOG_NUM_MODULES; i++) {
+        mod = &m_modules[i];
+        if (mod->dbg_enable[0] == 0) {
+            continue;
+        }
+        debug = (access(mod->dbg_enable, R_OK) == 0);
+        mod->debug.store(debug, std::memory_order_relaxed);
+
+        for (j = 0; j < 2; j++) {
+            if (mod->fp[j] == NULL) {
+                continue;
+            }
+            // rotated or removed files are reopened by the next message
+            get_file_path((j == 0) ? m_dbg_dir:m_log_dir, mod, j, path, sizeof(path));
+            if (((j == 0) && (debug == false)) || (stat(path, &st) != 0) ||
+                    (st.st_dev != mod->dev[j]) || (st.st_ino != mod->ino[j])) {
+                fclose(mod->fp[j]);
+                mod->fp[j] = NULL;
+            }
+        }
+    }
+}
+
+void em_log_t::close_files()
+{
+    unsigned int i, j;
+
+    for (i = 0; i < EM_LOG_NUM_MODULES; i++) {
+        for (j = 0; j < 2; j++) {
+            if (m_modules[i].fp[j] != NULL) {
+                fclose(m_modules[i].fp[j]);
+                m_modules[i].fp[j] = NULL;
+            }
+        }
+    }
+}
+
+void em_log_t::wake()
+{
+    uint64_t val = 1;
+
+    if (::write(m_efd, &val, sizeof(val)) < 0) {
+        return;
+    }
+}
+
+void *em_log_t::writer(void *arg)
+{
+    em_log_t *log = static_cast<em_log_t *>(arg);
+    unsigned long long now, last_check = get_now_ms();
+    struct pollfd pfd;
+    uint64_t val;
+    size_t pos;
+    int timeout;
+
+    pfd.fd = log->m_efd;
+    pfd.events = POLLIN;
+
+    while (log->m_exit.load() == false) {
+        log->m_waiting.store(true, std::memory_order_seq_cst);
+        pos = log->m_dequeue_pos.load(std::memory_order_relaxed);
+        if (log->m_cells[pos & log->m_mask].seq.load(std::memory_order_seq_cst) != (pos + 1)) {
+            now = get_now_ms();
+            timeout = (now - last_check >= EM_LOG_CHECK_MS) ? 0:static_cast<int>(EM_LOG_CHECK_MS - (now - last_check));
+            pfd.revents = 0;
+            if (poll(&pfd, 1, timeout) > 0) {
+                while (read(log->m_efd, &val, sizeof(val)) > 0);
+            }
+        }
+        log->m_waiting.store(false, std::memory_order_relaxed);
+
+        log->write_cells();
+
+        now = get_now_ms();
+        if (now - last_check >= EM_LOG_CHECK_MS) {
+            log->check_files();
+            last_check = now;
+        }
+    }
+
+    log->write_cells();
+
+    return NULL;
+}
+
+bool em_log_t::flush(int timeout_ms)
+{
+    size_t target = m_enqueue_pos.load(std::memory_order_acquire);
+    unsigned long long start = get_now_ms();
+
+    if (m_running == false) {
+        return true;
+    }
+
+    wake();
+    while (m_dequeue_pos.load(std::memory_order_acquire) < target) {
+        if (get_now_ms() - start >= static_cast<unsigned long long>(timeout_ms)) {
+            return false;
+        }
+        usleep(1000);
+    }
+
+    return true;
+}
+
+int em_log_t::init(const char *dbg_prefix, const char *dbg_dir, const char *log_dir)
+{
+    em_log_module_t *mod;
+    size_t i;
+
+    if ((m_cells = new (std::nothrow) em_log_cell_t[EM_LOG_RING_SZ]) == NULL) {
+        return -1;
+    }
+    for (i = 0; i < EM_LOG_RING_SZ; i++) {
+        m_cells[i].seq.store(i, std::memory_order_relaxed);
+        m_cells[i].big = NULL;
+    }
+    m_mask = EM_LOG_RING_SZ - 1;
+
+    snprintf(m_dbg_dir, sizeof(m_dbg_dir), "%s", dbg_dir);
+    snprintf(m_log_dir, sizeof(m_log_dir), "%s", log_dir);
+    for (i = 0; i < EM_LOG_NUM_MODULES; i++) {
+        mod = &m_modules[i];
+        snprintf(mod->name, sizeof(mod->name), "%s", s_module_files[i].name);
+        mod->dbg_enable[0] = 0;
+        if (s_module_files[i].dbg_enable[0] != 0) {
+            snprintf(mod->dbg_enable, sizeof(mod->dbg_enable), "%s%s", dbg_prefix, s_module_files[i].dbg_enable);
+            mod->debug.store(access(mod->dbg_enable, R_OK) == 0);
+        }
+    }
+
+    if ((m_efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+        return -1;
+    }
+    m_exit = false;
+    if (pthread_create(&m_thread, NULL, em_log_t::writer, this) != 0) {
+        close(m_efd);
+        m_efd = -1;
+        return -1;
+    }
+    m_running = true;
+
+    return 0;
+}
+
+void em_log_t::deinit()
+{
+    if (m_running == true) {
+        m_exit = true;
+        wake();
+        pthread_join(m_thread, NULL);
+        m_running = false;
+    }
+
+    if (m_efd >= 0) {
+        close(m_efd);
+        m_efd = -1;
+    }
+
+    pthread_mutex_lock(&m_lock);
+    close_files();
+    pthread_mutex_unlock(&m_lock);
+}
+
+static em_log_t *s_log = NULL;
+static pthread_once_t s_log_once = PTHREAD_ONCE_INIT;
+
+static void flush_log_at_exit()
+{
+    s_log->flush(EM_LOG_CHECK_MS);
+}
+
+static void start_log()
+{
+    // never deleted, other threads may still log while the process exits
+    s_log = new em_log_t();
+    s_log->init(LOG_PATH_PREFIX, "/tmp/", "/rdklogs/logs/");
+    atexit(flush_log_at_exit);
+}
+
+em_log_t *em_log_t::get_log()
+{
+    pthread_once(&s_log_once, start_log);
+
+    return s_log;
+}
+
+em_log_t::em_log_t(): m_cells(NULL), m_mask(0), m_enqueue_pos(0), m_dequeue_pos(0), m_waiting(false), m_exit(false),
+    m_drops(0), m_drops_logged(0), m_efd(-1), m_running(false), m_thread()
+{
+    unsigned int i;
+
+    pthread_mutex_init(&m_lock, NULL);
+    for (i = 0; i < EM_LOG_NUM_MODULES; i++) {
+        m_modules[i].name[0] = 0;
+        m_modules[i].dbg_enable[0] = 0;
+        m_modules[i].debug = false;
+        memset(m_modules[i].fp, 0, sizeof(m_modules[i].fp));
+    }
+    m_dbg_dir[0] = 0;
+    m_log_dir[0] = 0;
+}
+
+em_log_t::~em_log_t()
+{
+    size_t i;
+
+    deinit();
+    for (i = 0; (m_cells != NULL) && (i <= m_mask); i++) {
+        free(m_cells[i].big);
+    }
+    delete[] m_cells;
+    pthread_mutex_destroy(&m_lock);
+}
@@ -0,0 +1,276 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <string>
+#include "em_capture.h"
+
+#define EM_REPLAY_ETH_P_1905    0x893a
+
+typedef struct {
+    char            file[256];
+    char            ifname[IFNAMSIZ];
+    double          speed;          // 1 replays at the captured rate, 0 back to back
+    unsigned int    loops;
+    em_capture_dir_t dir;           // unknown replays both directions
+    char            node[EM_CAPTURE_NODE_LEN];  // only frames whose annotation contains it
+    bool            rewrite_dst;
+    unsigned char   dst[ETH_ALEN];
+    char            corpus[256];    // directory the 1905 frames are written to instead of sent
+} em_replay_config_t;
+
+static uint64_t get_time_us()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (static_cast<uint64_t>(ts.tv_sec) * 1000000) + (static_cast<uint64_t>(ts.tv_nsec) / 1000);
+}
+
+static void sleep_until_us(uint64_t us)
+{
+    struct timespec ts;
+
+    ts.tv_sec = static_cast<time_t>(us / 1000000);
+    ts.tv_nsec = static_cast<long>((us % 1000000) * 1000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+}
+
+static int open_socket(const char *ifname, struct sockaddr_ll *addr)
+{
+    int sock;
+
+    if ((sock = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL))) < 0) {
+        printf("%s:%d: Failed to open raw socket, err:%d\n", __func__, __LINE__, errno);
+        return -1;
+    }
+
+    memset(addr, 0, sizeof(struct sockaddr_ll));
+    addr->sll_family = AF_PACKET;
+    addr->sll_protocol = htons(ETH_P_ALL);
+    if ((addr->sll_ifindex = static_cast<int>(if_nametoindex(ifname))) == 0) {
+        printf("%s:%d: Unknown interface:%s\n", __func__, __LINE__, ifname);
+        close(sock);
+        return -1;
+    }
+    addr->sll_halen = ETH_ALEN;
+
+    return sock;
+}
+
+/*
+ * Sends the frames of the capture on the interface, spaced as they were captured divided
+ * by the speed. The schedule is absolute, a late frame is sent at once and the frames
+ * after it keep their captured offsets.
+ */
+static int replay(em_replay_config_t *cfg, int sock, struct sockaddr_ll *addr)
+{
+    em_capture_reader_t reader;
+    em_capture_frame_t frame;
+    unsigned char buff[65536];
+    uint64_t first_ts = 0, start_us, due_us, now_us, late_us, max_late_us = 0, bytes = 0;
+    unsigned int loop, sent = 0, errors = 0;
+    int ret;
+
+    start_us = get_time_us();
+    for (loop = 0; loop < cfg->loops; loop++) {
+        if (reader.open(cfg->file) != 0) {
+            return -1;
+        }
+        // each loop starts where the previous one ended
+        first_ts = 0;
+        due_us = 0;
+
+        while ((ret = reader.next(&frame)) == 1) {
+            if (((cfg->dir != em_capture_dir_unknown) && (frame.dir != cfg->dir)) ||
+                    ((cfg->node[0] != '\0') && (strstr(frame.node, cfg->node) == NULL)) ||
+                    (frame.len < ETH_HLEN) || (frame.len > sizeof(buff))) {
+                continue;
+            }
+
+            if (first_ts == 0) {
+                first_ts = frame.ts_us;
+                due_us = get_time_us();
+            }
+            if ((cfg->speed > 0) && (frame.ts_us > first_ts)) {
+                now_us = due_us + static_cast<uint64_t>(static_cast<double>(frame.ts_us - first_ts) / cfg->speed);
+                sleep_until_us(now_us);
+                late_us = get_time_us() - now_us;
+                max_late_us = (late_us > max_late_us) ? late_us:max_late_us;
+            }
+
+            memcpy(buff, frame.data, frame.len);
+            if (cfg->rewrite_dst == true) {
+                memcpy(buff, cfg->dst, ETH_ALEN);
+            }
+            memcpy(addr->sll_addr, buff, ETH_ALEN);
+            if (sendto(sock, buff, frame.len, 0, reinterpret_cast<struct sockaddr *>(addr), sizeof(struct sockaddr_ll)) < 0) {
+                errors++;
+                continue;
+            }
+            sent++;
+            bytes += frame.len;
+        }
+        reader.close();
+        if (ret < 0) {
+            break;
+        }
+    }
+
+    now_us = get_time_us() - start_us;
+    printf("Sent %u frames, %llu bytes in %llu.%03llu s, %.0f frames/s, %u send errors, max %llu us late\n",
+        sent, static_cast<unsigned long long>(bytes), static_cast<unsigned long long>(now_us / 1000000),
+        static_cast<unsigned long long>((now_us % 1000000) / 1000),
+        (now_us != 0) ? (static_cast<double>(sent) * 1000000 / static_cast<double>(now_us)):0.0,
+        errors, static_cast<unsigned long long>(max_late_us));
+
+    return (ret < 0) ? -1:0;
+}
+
+/*
+ * Writes every 1905 frame of the capture to a file of its own in the corpus directory,
+ * the seeds of the fuzzing targets of tests/fuzz. The files are named after the capture
+ * and the frame number, so that a capture written twice does not add duplicates.
+ */
+static int write_corpus(em_replay_config_t *cfg)
+{
+    em_capture_reader_t reader;
+    em_capture_frame_t frame;
+    char path[sizeof(cfg->corpus) + sizeof(cfg->file) + 16];
+    const char *name;
+    unsigned int num = 0, written = 0;
+    FILE *fp;
+    int ret;
+
+    if (reader.open(cfg->file) != 0) {
+        return -1;
+    }
+    name = strrchr(cfg->file, '/');
+    name = (name == NULL) ? cfg->file:name + 1;
+
+    while ((ret = reader.next(&frame)) == 1) {
+        num++;
+        if (((cfg->dir != em_capture_dir_unknown) && (frame.dir != cfg->dir)) ||
+                ((cfg->node[0] != '\0') && (strstr(frame.node, cfg->node) == NULL)) ||
+                (frame.len < ETH_HLEN) || (((frame.data[12] << 8) | frame.data[13]) != EM_REPLAY_ETH_P_1905)) {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), "%s/%s-%u", cfg->corpus, name, num);
+        if ((fp = fopen(path, "wb")) == NULL) {
+            printf("%s:%d: Failed to create %s, err:%d\n", __func__, __LINE__, path, errno);
+            ret = -1;
+            break;
+        }
+        if (fwrite(frame.data, 1, frame.len, fp) != frame.len) {
+            ret = -1;
+        }
+        fclose(fp);
+        if (ret < 0) {
+            break;
+        }
+        written++;
+    }
+    reader.close();
+
+    printf("Wrote %u of %u frames to %s\n", written, num, cfg->corpus);
+
+    return (ret < 0) ? -1:0;
+}
+
+int main(int argc, const char *argv[])
+{
+    em_replay_config_t cfg;
+    struct sockaddr_ll addr;
+    std::string arg;
+    unsigned int mac[ETH_ALEN];
+    int sock, ret, i, j;
+
+    if (argc < 3) {
+        printf("Usage: %s --file=capture.pcapng --interface=iface [--speed=x] [--loops=n] [--dir=rx|tx|all] "
+            "[--node=annotation] [--dst=mac] [--corpus=dir]\n", argv[0]);
+        printf("Replays the frames a controller or agent captured with --capture, by default the received ones "
+            "at the captured rate. --speed=10 replays ten times faster, --speed=0 back to back. --corpus writes the "
+            "1905 frames to a fuzzing corpus instead, no interface needed.\n");
+        return -1;
+    }
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.speed = 1;
+    cfg.loops = 1;
+    cfg.dir = em_capture_dir_rx;
+
+    for (i = 1; i < argc; i++) {
+        arg = argv[i];
+        if (arg.find("--file=") == 0) {
+            snprintf(cfg.file, sizeof(cfg.file), "%s", arg.substr(strlen("--file=")).c_str());
+        } else if (arg.find("--interface=") == 0) {
+            snprintf(cfg.ifname, sizeof(cfg.ifname), "%s", arg.substr(strlen("--interface=")).c_str());
+        } else if (arg.find("--speed=") == 0) {
+            cfg.speed = atof(arg.substr(strlen("--speed=")).c_str());
+        } else if (arg.find("--loops=") == 0) {
+            cfg.loops = static_cast<unsigned int>(strtoul(arg.substr(strlen("--loops=")).c_str(), NULL, 10));
+        } else if (arg == "--dir=rx") {
+            cfg.dir = em_capture_dir_rx;
+        } else if (arg == "--dir=tx") {
+            cfg.dir = em_capture_dir_tx;
+        } else if (arg == "--dir=all") {
+            cfg.dir = em_capture_dir_unknown;
+        } else if (arg.find("--node=") == 0) {
+            snprintf(cfg.node, sizeof(cfg.node), "%s", arg.substr(strlen("--node=")).c_str());
+        } else if ((arg.find("--dst=") == 0) && (sscanf(arg.c_str() + strlen("--dst="), "%x:%x:%x:%x:%x:%x",
+                &mac[0], &mac[1], &mac[2], &mac[3], &mac[4], &mac[5]) == ETH_ALEN)) {
+            for (j = 0; j < ETH_ALEN; j++) {
+                cfg.dst[j] = static_cast<unsigned char>(mac[j]);
+            }
+            cfg.rewrite_dst = true;
+        } else if (arg.find("--corpus=") == 0) {
+            snprintf(cfg.corpus, sizeof(cfg.corpus), "%s", arg.substr(strlen("--corpus=")).c_str());
+        } else {
+            printf("Invalid argument: %s\n", arg.c_str());
+            return -1;
+        }
+    }
+
+    if ((cfg.file[0] != '\0') && (cfg.corpus[0] != '\0')) {
+        return (write_corpus(&cfg) < 0) ? -1:0;
+    }
+
+    if ((cfg.file[0] == '\0') || (cfg.ifname[0] == '\0') || (cfg.speed < 0) || (cfg.loops == 0)) {
+        printf("Missing --file or --interface, or invalid --speed or --loops\n");
+        return -1;
+    }
+
+    if ((sock = open_socket(cfg.ifname, &addr)) < 0) {
+        return -1;
+    }
+    ret = replay(&cfg, sock, &addr);
+    close(sock);
+
+    return (ret < 0) ? -1:0;
+}
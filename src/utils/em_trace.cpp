@@ -0,0 +1,255 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <algorithm>
+#include <new>
+#include <vector>
+#include "em_trace.h"
+
+em_trace_ring_t *em_trace_t::s_rings[EM_TRACE_MAX_THREADS];
+std::atomic<unsigned int> em_trace_t::s_num_rings(0);
+std::atomic<bool> em_trace_t::s_enabled(true);
+char em_trace_t::s_crash_path[256];
+
+static pthread_mutex_t s_ring_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *s_module_str[] = {"stdout", "agent", "ctrl", "mgr", "db", "prov", "conf"};
+
+static const char *s_event_str[em_trace_event_max] = {
+    "none",
+    "orch_submit",
+    "orch_exec",
+    "orch_skip",
+    "orch_fini",
+    "orch_transient",
+    "ctrl_state",
+};
+
+// marks the ring of a thread as free when the thread exits, the records stay for the next dump
+struct em_trace_ring_owner_t {
+    em_trace_ring_t *ring = NULL;
+
+    ~em_trace_ring_owner_t() {
+        if (ring != NULL) {
+            ring->in_use.store(false, std::memory_order_release);
+        }
+    }
+};
+
+em_trace_ring_t *em_trace_t::get_ring()
+{
+    static thread_local em_trace_ring_owner_t t_owner;
+    static thread_local bool t_no_ring = false;
+    em_trace_ring_t *ring = NULL;
+    unsigned int i, num;
+
+    if (t_no_ring == true) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&s_ring_lock);
+    num = s_num_rings.load(std::memory_order_relaxed);
+    if (num < EM_TRACE_MAX_THREADS) {
+        if ((ring = new (std::nothrow) em_trace_ring_t) != NULL) {
+            ring->head.store(0, std::memory_order_relaxed);
+            s_rings[num] = ring;
+            s_num_rings.store(num + 1, std::memory_order_release);
+        }
+    } else {
+        // all taken, reuse the ring of a thread that exited
+        for (i = 0; i < num; i++) {
+            if (s_rings[i]->in_use.load(std::memory_order_acquire) == false) {
+                ring = s_rings[i];
+                break;
+            }
+        }
+    }
+    if (ring != NULL) {
+        ring->tid.store(static_cast<int>(syscall(SYS_gettid)), std::memory_order_release);
+        ring->in_use.store(true, std::memory_order_release);
+    }
+    pthread_mutex_unlock(&s_ring_lock);
+
+    t_owner.ring = ring;
+    t_no_ring = (ring == NULL);
+
+    return ring;
+}
+
+static int write_all(int fd, const void *buff, size_t len)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(buff);
+    ssize_t ret;
+
+    while (len > 0) {
+        if ((ret = write(fd, p, len)) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        p += ret;
+        len -= static_cast<size_t>(ret);
+    }
+
+    return 0;
+}
+
+int em_trace_t::dump(int fd)
+{
+    em_trace_file_hdr_t hdr;
+    em_trace_ring_hdr_t ring_hdr;
+    unsigned int i;
+
+    hdr.magic = EM_TRACE_MAGIC;
+    hdr.version = EM_TRACE_VERSION;
+    hdr.num_rings = s_num_rings.load(std::memory_order_acquire);
+    hdr.ring_sz = EM_TRACE_RING_SZ;
+    if (write_all(fd, &hdr, sizeof(hdr)) != 0) {
+        return -1;
+    }
+
+    // the rings are not locked, a record written meanwhile may be torn
+    for (i = 0; i < hdr.num_rings; i++) {
+        ring_hdr.tid = s_rings[i]->tid.load(std::memory_order_acquire);
+        ring_hdr.reserved = 0;
+        ring_hdr.head = s_rings[i]->head.load(std::memory_order_acquire);
+        if ((write_all(fd, &ring_hdr, sizeof(ring_hdr)) != 0) ||
+                (write_all(fd, s_rings[i]->recs, sizeof(s_rings[i]->recs)) != 0)) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int em_trace_t::dump(const char *path)
+{
+    int fd, ret;
+
+    if ((fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)) < 0) {
+        printf("%s:%d: Failed to open %s, err:%d\n", __func__, __LINE__, path, errno);
+        return -1;
+    }
+    ret = dump(fd);
+    close(fd);
+
+    return ret;
+}
+
+int em_trace_t::decode(const char *path, FILE *out)
+{
+    typedef struct {
+        int tid;
+        em_trace_rec_t rec;
+    } em_trace_entry_t;
+
+    std::vector<em_trace_entry_t> entries;
+    std::vector<em_trace_rec_t> recs;
+    em_trace_file_hdr_t hdr;
+    em_trace_ring_hdr_t ring_hdr;
+    em_trace_entry_t entry;
+    unsigned long long i, start;
+    unsigned int r, j;
+    FILE *fp;
+
+    if ((fp = fopen(path, "rb")) == NULL) {
+        printf("%s:%d: Failed to open %s, err:%d\n", __func__, __LINE__, path, errno);
+        return -1;
+    }
+    if ((fread(&hdr, sizeof(hdr), 1, fp) != 1) || (hdr.magic != EM_TRACE_MAGIC) ||
+            (hdr.version != EM_TRACE_VERSION) || (hdr.ring_sz == 0) || ((hdr.ring_sz & (hdr.ring_sz - 1)) != 0)) {
+        printf("%s:%d: %s is not a trace dump\n", __func__, __LINE__, path);
+        fclose(fp);
+        return -1;
+    }
+
+    recs.resize(hdr.ring_sz);
+    for (r = 0; r < hdr.num_rings; r++) {
+        if ((fread(&ring_hdr, sizeof(ring_hdr), 1, fp) != 1) ||
+                (fread(recs.data(), sizeof(em_trace_rec_t), hdr.ring_sz, fp) != hdr.ring_sz)) {
+            break;
+        }
+        start = (ring_hdr.head > hdr.ring_sz) ? ring_hdr.head - hdr.ring_sz:0;
+        for (i = start; i < ring_hdr.head; i++) {
+            entry.tid = ring_hdr.tid;
+            entry.rec = recs[i & (hdr.ring_sz - 1)];
+            entries.push_back(entry);
+        }
+    }
+    fclose(fp);
+
+    std::stable_sort(entries.begin(), entries.end(),
+        [](const em_trace_entry_t& a, const em_trace_entry_t& b) { return a.rec.ts_ns < b.rec.ts_ns; });
+
+    for (auto& e : entries) {
+        fprintf(out, "%llu.%09llu %d %s %s", e.rec.ts_ns / 1000000000ULL, e.rec.ts_ns % 1000000000ULL, e.tid,
+            (e.rec.module < sizeof(s_module_str) / sizeof(s_module_str[0])) ? s_module_str[e.rec.module]:"unknown",
+            get_event_str(e.rec.event));
+        for (j = 0; j < EM_TRACE_MAX_ARGS; j++) {
+            fprintf(out, " %u", e.rec.args[j]);
+        }
+        fprintf(out, "\n");
+    }
+
+    return static_cast<int>(entries.size());
+}
+
+void em_trace_t::crash_handler(int sig)
+{
+    int fd;
+
+    if ((fd = open(s_crash_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)) >= 0) {
+        dump(fd);
+        close(fd);
+    }
+
+    // the handler was reset, the signal now takes its default action
+    raise(sig);
+}
+
+void em_trace_t::install_crash_handler(const char *path)
+{
+    int sigs[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+    struct sigaction sa;
+    unsigned int i;
+
+    snprintf(s_crash_path, sizeof(s_crash_path), "%s", path);
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = em_trace_t::crash_handler;
+    sa.sa_flags = SA_RESETHAND;
+    sigemptyset(&sa.sa_mask);
+    for (i = 0; i < sizeof(sigs) / sizeof(sigs[0]); i++) {
+        sigaction(sigs[i], &sa, NULL);
+    }
+}
+
+const char *em_trace_t::get_event_str(unsigned int event)
+{
+    return (event < em_trace_event_max) ? s_event_str[event]:"unknown";
+}
@@ -0,0 +1,31 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include "em_trace.h"
+
+int main(int argc, const char *argv[])
+{
+    if (argc != 2) {
+        printf("Usage: %s <trace dump>\n", argv[0]);
+        return -1;
+    }
+
+    // one line per record: seconds.nanoseconds thread module event args
+    return (em_trace_t::decode(argv[1], stdout) < 0) ? -1:0;
+}
@@ -1,6 +1,114 @@
 #include "timer.h"
 
-ThreadedTimer::ThreadedTimer() : running(false) {}
+TimerService& TimerService::instance() {
+    // never destroyed, timers may still be stopped from static destructors
+    static TimerService *service = new TimerService();
+    return *service;
+}
+
+TimerService::TimerService() {
+    std::thread thread(&TimerService::run, this);
+    m_thread_id = thread.get_id();
+    thread.detach();
+}
+
+TimerService::handle_t TimerService::schedule(std::chrono::milliseconds delay, std::chrono::milliseconds interval, std::function<bool()> callback) {
+    clock_t::time_point deadline = clock_t::now() + delay;
+    std::lock_guard<std::mutex> lock(m_lock);
+    handle_t handle = m_next_handle++;
+
+    m_timers[handle] = entry_t{deadline, interval, std::move(callback)};
+    m_queue.insert(std::make_pair(deadline, handle));
+    if (m_queue.begin()->second == handle) {
+        m_cond.notify_one();
+    }
+
+    return handle;
+}
+
+bool TimerService::cancel(handle_t handle) {
+    std::function<bool()> callback;
+    std::unique_lock<std::mutex> lock(m_lock);
+    auto it = m_timers.find(handle);
+
+    if (it == m_timers.end()) {
+        return false;
+    }
+
+    m_queue.erase(std::make_pair(it->second.deadline, handle));
+    callback = std::move(it->second.callback);
+    m_timers.erase(it);
+    if (std::this_thread::get_id() != m_thread_id) {
+        m_done_cond.wait(lock, [this, handle]() { return m_running != handle; });
+    }
+    lock.unlock();
+
+    // the callback may own the timer that is being stopped, destroy it without the lock
+    callback = nullptr;
+
+    return true;
+}
+
+size_t TimerService::pending() {
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_timers.size();
+}
+
+void TimerService::run() {
+    std::unique_lock<std::mutex> lock(m_lock);
+    std::function<bool()> callback;
+    clock_t::time_point now, deadline;
+    handle_t handle;
+    bool again;
+
+    while (true) {
+        if (m_queue.empty()) {
+            m_cond.wait(lock);
+            continue;
+        }
+        now = clock_t::now();
+        if (m_queue.begin()->first > now) {
+            // a copy, the entry may be cancelled during the wait
+            deadline = m_queue.begin()->first;
+            m_cond.wait_until(lock, deadline);
+            continue;
+        }
+
+        handle = m_queue.begin()->second;
+        m_queue.erase(m_queue.begin());
+        auto it = m_timers.find(handle);
+        callback = it->second.callback;
+        m_running = handle;
+        lock.unlock();
+
+        again = callback();
+
+        lock.lock();
+        m_running = 0;
+        it = m_timers.find(handle);
+        if (it != m_timers.end()) {
+            if (again && (it->second.interval.count() > 0)) {
+                // keep the period, unless the callback overran it
+                now = clock_t::now();
+                it->second.deadline += it->second.interval;
+                if (it->second.deadline <= now) {
+                    it->second.deadline = now + it->second.interval;
+                }
+                m_queue.insert(std::make_pair(it->second.deadline, handle));
+            } else {
+                callback = std::move(it->second.callback);
+                m_timers.erase(it);
+            }
+        }
+        m_done_cond.notify_all();
+
+        lock.unlock();
+        callback = nullptr;
+        lock.lock();
+    }
+}
+
+ThreadedTimer::ThreadedTimer() : m_handle(0) {}
 
 ThreadedTimer::~ThreadedTimer() {
     stop();
@@ -8,34 +116,21 @@ ThreadedTimer::~ThreadedTimer() {
 
 void ThreadedTimer::execute_after(std::chrono::milliseconds delay, std::function<void()> callback) {
     stop();
-    running = true;
-    timer_thread = std::make_unique<std::thread>([this, delay, callback]() {
-        std::this_thread::sleep_for(delay);
-        if (running.load()) {
-            callback();
-        }
+    m_handle = TimerService::instance().schedule(delay, std::chrono::milliseconds(0), [callback]() {
+        callback();
+        return false;
     });
 }
 
 void ThreadedTimer::start_periodic(std::chrono::milliseconds interval, std::function<bool()> callback) {
     stop();
-    running = true;
-    timer_thread = std::make_unique<std::thread>([this, interval, callback]() {
-        while (running.load()) {
-            std::this_thread::sleep_for(interval);
-            if (running.load()) {
-                if (!callback()) {
-                    stop();  // Stop if callback returns false
-                    break;
-                }
-            }
-        }
-    });
+    m_handle = TimerService::instance().schedule(interval, interval, std::move(callback));
 }
 
 void ThreadedTimer::stop() {
-    running = false;
-    if (timer_thread && timer_thread->joinable()) {
-        timer_thread->join();
+    TimerService::handle_t handle = m_handle.exchange(0);
+
+    if (handle != 0) {
+        TimerService::instance().cancel(handle);
     }
 }
@@ -21,8 +21,10 @@
 #include <string.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 
 
@@ -39,12 +41,9 @@
 
 
 #include "util.h"
+#include "em_log.h"
 #include <netinet/in.h>
 
-extern "C" {
-    extern char *__progname;
-}
-
 void util::print_stacktrace() {
 #ifdef __GLIBC__
     // Get the stack trace (Unix/Linux implementation)
@@ -94,84 +93,16 @@ void util::add_milliseconds(struct timespec *ts, long milliseconds)
 }
 
 void util::delay(int seconds) {
-    time_t start_time, current_time;
-
-    // Get current time
-    time(&start_time);
-
-    do {
-        // Update current time
-        time(&current_time);
-    } while ((current_time - start_time) < seconds); // Loop until desired delay is achieved
-}
-
-char *get_formatted_time_em(char *time)
-{
-    struct tm *tm_info;
-    struct timeval tv_now;
-    char tmp[128];
-
-    gettimeofday(&tv_now, NULL);
-    tm_info = const_cast<struct tm *>(localtime(&tv_now.tv_sec));
-
-    strftime(tmp, 128, "%m/%d/%Y - %T", tm_info);
-
-    snprintf(time, 160, "%s.%06lld", tmp, static_cast<long long>(tv_now.tv_usec));
-    return time;
-}
-
-std::pair<FILE*, std::string> get_module_log_fd_name(easymesh_dbg_type_t module, easymesh_log_level_t level) {
-    std::string filename_dbg_enable = std::string(LOG_PATH_PREFIX);
-    std::string module_filename;
-
-    switch (module) {
-        case EM_AGENT:
-            filename_dbg_enable += "emAgentDbg";
-            module_filename = "emAgent";
-            break;
-        case EM_CTRL:
-            filename_dbg_enable += "emCtrlDbg";
-            module_filename = "emCtrl";
-            break;
-        case EM_MGR:
-            filename_dbg_enable += "emMgrDbg";
-            module_filename = "emMgr";
-            break;
-        case EM_DB:
-            filename_dbg_enable += "emDbDbg";
-            module_filename = "emDb";
-            break;
-        case EM_PROV:
-            filename_dbg_enable += "emProvDbg";
-            module_filename = "emProv";
-            break;
-        case EM_CONF:
-            filename_dbg_enable += "emConfDbg";
-            module_filename = "emConf";
-            break;
-        case EM_STDOUT:
-            return std::make_pair(stdout, "");
-    }
-
-    bool debug_enabled = ((access(filename_dbg_enable.c_str(), R_OK)) == 0);
-    
-    if (debug_enabled) {
-        std::string filename = "/tmp/" + module_filename;
-        return std::make_pair(fopen(filename.c_str(), "a+"), module_filename);
-    }
+    struct timespec deadline;
 
-    switch (level) {
-        case EM_LOG_LVL_INFO:
-        case EM_LOG_LVL_ERROR: {
-            std::string filename = "/rdklogs/logs/" + module_filename + ".txt";
-            return std::make_pair(fopen(filename.c_str(), "a+"), module_filename);
-        }
-        case EM_LOG_LVL_DEBUG:
-        default:
-            break;
+    if (seconds <= 0) {
+        return;
     }
 
-    return std::make_pair(nullptr, std::string());
+    // absolute deadline, so that signals interrupting the sleep do not stretch it
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += seconds;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR);
 }
 
 void util::print_hex_dump(const std::vector<uint8_t>& data, easymesh_dbg_type_t module)
@@ -181,29 +112,36 @@ void util::print_hex_dump(const std::vector<uint8_t>& data, easymesh_dbg_type_t
 
 void util::print_hex_dump(unsigned int length, uint8_t *buffer, easymesh_dbg_type_t module)
 {
+    em_log_t *log = em_log_t::get_log();
     unsigned int i;
     uint8_t buff[512] = {};
     const uint8_t * pc = const_cast<const uint8_t *>(buffer);
+    std::string out;
+    char tmp[64];
 
-    auto [fp, module_filename] = get_module_log_fd_name(module, EM_LOG_LVL_DEBUG);
-    if (fp == NULL) {
+    if (log->enabled(EM_LOG_LVL_DEBUG, module) == false) {
         return;
     }
 
     if ((pc == NULL) || (length <= 0)) {
-        fprintf(fp,"buffer NULL or BAD LENGTH = %d :\n", length);
-        if (fp != stdout) fclose (fp);
+        snprintf(tmp, sizeof(tmp), "buffer NULL or BAD LENGTH = %d :\n", length);
+        log->write(EM_LOG_LVL_DEBUG, module, tmp, static_cast<unsigned int>(strlen(tmp)));
         return;
     }
 
+    out.reserve(((length + 15) / 16) * 75);
     for (i = 0; i < length; i++) {
         if ((i % 16) == 0) {
-            if (i != 0)
-                fprintf(fp,"  %s\n", buff);
-            fprintf(fp,"  %04x ", i);
+            if (i != 0) {
+                snprintf(tmp, sizeof(tmp), "  %s\n", buff);
+                out += tmp;
+            }
+            snprintf(tmp, sizeof(tmp), "  %04x ", i);
+            out += tmp;
         }
 
-        fprintf(fp," %02x", pc[i]);
+        snprintf(tmp, sizeof(tmp), " %02x", pc[i]);
+        out += tmp;
 
         if (!isprint(pc[i]))
             buff[i % 16] = '.';
@@ -213,181 +151,254 @@ void util::print_hex_dump(unsigned int length, uint8_t *buffer, easymesh_dbg_typ
     }
 
     while ((i % 16) != 0) {
-        fprintf(fp,"   ");
+        out += "   ";
         i++;
     }
 
-    fprintf(fp,"  %s\n", buff);
-    if (fp != stdout) fclose (fp);
+    snprintf(tmp, sizeof(tmp), "  %s\n", buff);
+    out += tmp;
+    log->write(EM_LOG_LVL_DEBUG, module, out.data(), static_cast<unsigned int>(out.size()));
 }
 
-
-
 void util::em_util_print(easymesh_log_level_t level, easymesh_dbg_type_t module, const char *func, int line, const char *format, ...)
 {
-    char buff[256] = {0};
-    char time_buff[128] = {0};
+    em_log_t *log = em_log_t::get_log();
     va_list list;
-#if defined(__ENABLE_PID__) && (__ENABLE_PID__)
-    pid_t pid;
-#endif
-    
-    const char *severity;
-
-    auto [fp, module_filename] = get_module_log_fd_name(module, level);
-    if (fp == NULL) return; 
-
-
-
-    switch (level) {
-        case EM_LOG_LVL_INFO:
-            severity = "INFO";
-            break;
-        case EM_LOG_LVL_ERROR:
-            severity = "ERROR";
-            break;
-        case EM_LOG_LVL_DEBUG:
-            severity = "DEBUG";
-            break;
-        default:
-            severity = "UNKNOWN";
-            break;
-    }
 
-    get_formatted_time_em(time_buff);
-    snprintf(buff, sizeof(buff), "[%s] %s %s:%s:%d: %s: ", __progname ? __progname : "", time_buff, module_filename.c_str(), func, line, severity);
-    fprintf(fp, "%s", buff);
+    // nothing is formatted for a level the module does not log
+    if (log->enabled(level, module) == false) {
+        return;
+    }
 
     va_start(list, format);
-    vfprintf(fp, format, list);
+    log->vprint(level, module, func, line, format, list);
     va_end(list);
-
-    fprintf(fp, "\n");
-
-    fflush(fp);
-    if (fp != stdout) fclose (fp);
 }
 
 
+enum freq_region {
+    freq_region_global,
+    freq_region_us,
+    freq_region_eu,
+    freq_region_jp,
+    freq_region_cn,
+    freq_region_max,
+    freq_region_unknown = freq_region_max,  // a region without ranges of its own, only the global ones apply
+};
+
 struct freq_range {
     uint8_t op_class;
     uint8_t min_chan;
     uint8_t max_chan;
     uint16_t base_freq;
     uint16_t spacing;
-    std::string region;  // "" for global
+    uint8_t region;
 };
 
-const std::vector<freq_range> frequency_ranges = {
+constexpr freq_range frequency_ranges[] = {
     // Global frequency ranges
     // 2.4 GHz band
-    {81, 1, 13, 2407, 5, ""},      // channels 1-13
-    {82, 14, 14, 2414, 5, ""},     // channel 14
-    {83, 1, 13, 2407, 5, ""},      // channels 1-9; 40 MHz
-    {84, 5, 13, 2407, 5, ""},      // channels 5-13; 40 MHz
+    {81, 1, 13, 2407, 5, freq_region_global},      // channels 1-13
+    {82, 14, 14, 2414, 5, freq_region_global},     // channel 14
+    {83, 1, 13, 2407, 5, freq_region_global},      // channels 1-9; 40 MHz
+    {84, 5, 13, 2407, 5, freq_region_global},      // channels 5-13; 40 MHz
 
     // 5 GHz band
-    {115, 36, 48, 5000, 5, ""},    // channels 36-48; indoor only
-    {116, 36, 44, 5000, 5, ""},    // channels 36,44; 40 MHz
-    {117, 40, 48, 5000, 5, ""},    // channels 40,48; 40 MHz
-    {118, 52, 64, 5000, 5, ""},    // channels 52-64; dfs
-    {119, 52, 60, 5000, 5, ""},    // channels 52,60; 40 MHz
-    {120, 56, 64, 5000, 5, ""},    // channels 56,64; 40 MHz
-    {121, 100, 140, 5000, 5, ""},  // channels 100-140
-    {122, 100, 142, 5000, 5, ""},  // channels 100-142; 40 MHz
-    {123, 104, 136, 5000, 5, ""},  // channels 104-136; 40 MHz
-    {124, 149, 161, 5000, 5, ""},  // channels 149-161
-    {125, 149, 177, 5000, 5, ""},  // channels 149-177
-    {126, 149, 173, 5000, 5, ""},  // channels 149-173; 40 MHz
-    {127, 153, 177, 5000, 5, ""},  // channels 153-177; 40 MHz
-    {128, 36, 177, 5000, 5, ""},   // 80 MHz centered on 42,58,106,122,138,155,171
-    {129, 36, 177, 5000, 5, ""},   // 160 MHz centered on 50,114,163
-    {130, 36, 177, 5000, 5, ""},   // As class 128
+    {115, 36, 48, 5000, 5, freq_region_global},    // channels 36-48; indoor only
+    {116, 36, 44, 5000, 5, freq_region_global},    // channels 36,44; 40 MHz
+    {117, 40, 48, 5000, 5, freq_region_global},    // channels 40,48; 40 MHz
+    {118, 52, 64, 5000, 5, freq_region_global},    // channels 52-64; dfs
+    {119, 52, 60, 5000, 5, freq_region_global},    // channels 52,60; 40 MHz
+    {120, 56, 64, 5000, 5, freq_region_global},    // channels 56,64; 40 MHz
+    {121, 100, 140, 5000, 5, freq_region_global},  // channels 100-140
+    {122, 100, 142, 5000, 5, freq_region_global},  // channels 100-142; 40 MHz
+    {123, 104, 136, 5000, 5, freq_region_global},  // channels 104-136; 40 MHz
+    {124, 149, 161, 5000, 5, freq_region_global},  // channels 149-161
+    {125, 149, 177, 5000, 5, freq_region_global},  // channels 149-177
+    {126, 149, 173, 5000, 5, freq_region_global},  // channels 149-173; 40 MHz
+    {127, 153, 177, 5000, 5, freq_region_global},  // channels 153-177; 40 MHz
+    {128, 36, 177, 5000, 5, freq_region_global},   // 80 MHz centered on 42,58,106,122,138,155,171
+    {129, 36, 177, 5000, 5, freq_region_global},   // 160 MHz centered on 50,114,163
+    {130, 36, 177, 5000, 5, freq_region_global},   // As class 128
 
     // 6 GHz band (UHB channels)
-    {131, 1, 233, 5950, 5, ""},    // 20 MHz
-    {132, 3, 233, 5950, 5, ""},    // 40 MHz
-    {133, 7, 233, 5950, 5, ""},    // 80 MHz
-    {134, 15, 233, 5950, 5, ""},   // 160 MHz
-    {135, 7, 233, 5950, 5, ""},    // 80+80 MHz
-    {136, 2, 2, 5935, 1, ""},      // Special case channel 2
+    {131, 1, 233, 5950, 5, freq_region_global},    // 20 MHz
+    {132, 3, 233, 5950, 5, freq_region_global},    // 40 MHz
+    {133, 7, 233, 5950, 5, freq_region_global},    // 80 MHz
+    {134, 15, 233, 5950, 5, freq_region_global},   // 160 MHz
+    {135, 7, 233, 5950, 5, freq_region_global},    // 80+80 MHz
+    {136, 2, 2, 5935, 1, freq_region_global},      // Special case channel 2
 
     // 60 GHz band
-    {180, 1, 8, 56160, 2160, ""},    // channels 1-8
-    {181, 9, 15, 56160, 2160, ""},   // EDMG CB2
-    {182, 17, 22, 56160, 2160, ""},  // EDMG CB3
-    {183, 25, 29, 56160, 2160, ""},  // EDMG CB4
+    {180, 1, 8, 56160, 2160, freq_region_global},    // channels 1-8
+    {181, 9, 15, 56160, 2160, freq_region_global},   // EDMG CB2
+    {182, 17, 22, 56160, 2160, freq_region_global},  // EDMG CB3
+    {183, 25, 29, 56160, 2160, freq_region_global},  // EDMG CB4
 
     // US region specific
-    {12, 1, 11, 2407, 5, "US"},      // 2.4 GHz channels 1-11
-    {32, 1, 7, 2407, 5, "US"},       // 2.4 GHz 40MHz channels 1-7
-    {33, 5, 11, 2407, 5, "US"},      // 2.4 GHz 40MHz channels 5-11
-    {1, 36, 48, 5000, 5, "US"},      // 5 GHz channels 36-48
-    {2, 52, 64, 5000, 5, "US"},      // 5 GHz channels 52-64
-    {4, 100, 144, 5000, 5, "US"},    // 5 GHz channels 100-144
-    {5, 149, 165, 5000, 5, "US"},    // 5 GHz channels 149-165
-    {34, 1, 8, 56160, 2160, "US"},   // 60 GHz channels 1-8
-    {37, 9, 15, 56160, 2160, "US"},  // 60 GHz EDMG CB2
-    {38, 17, 22, 56160, 2160, "US"}, // 60 GHz EDMG CB3
-    {39, 25, 29, 56160, 2160, "US"}, // 60 GHz EDMG CB4
+    {12, 1, 11, 2407, 5, freq_region_us},      // 2.4 GHz channels 1-11
+    {32, 1, 7, 2407, 5, freq_region_us},       // 2.4 GHz 40MHz channels 1-7
+    {33, 5, 11, 2407, 5, freq_region_us},      // 2.4 GHz 40MHz channels 5-11
+    {1, 36, 48, 5000, 5, freq_region_us},      // 5 GHz channels 36-48
+    {2, 52, 64, 5000, 5, freq_region_us},      // 5 GHz channels 52-64
+    {4, 100, 144, 5000, 5, freq_region_us},    // 5 GHz channels 100-144
+    {5, 149, 165, 5000, 5, freq_region_us},    // 5 GHz channels 149-165
+    {34, 1, 8, 56160, 2160, freq_region_us},   // 60 GHz channels 1-8
+    {37, 9, 15, 56160, 2160, freq_region_us},  // 60 GHz EDMG CB2
+    {38, 17, 22, 56160, 2160, freq_region_us}, // 60 GHz EDMG CB3
+    {39, 25, 29, 56160, 2160, freq_region_us}, // 60 GHz EDMG CB4
 
     // EU region specific
-    {4, 1, 13, 2407, 5, "EU"},       // 2.4 GHz channels 1-13
-    {11, 1, 9, 2407, 5, "EU"},       // 2.4 GHz 40MHz channels 1-9
-    {12, 5, 13, 2407, 5, "EU"},      // 2.4 GHz 40MHz channels 5-13
-    {1, 36, 48, 5000, 5, "EU"},      // 5 GHz channels 36-48
-    {2, 52, 64, 5000, 5, "EU"},      // 5 GHz channels 52-64
-    {3, 100, 140, 5000, 5, "EU"},    // 5 GHz channels 100-140
-    {17, 149, 169, 5000, 5, "EU"},   // 5 GHz channels 149-169
-    {18, 1, 6, 56160, 2160, "EU"},   // 60 GHz channels 1-6
-    {21, 9, 11, 56160, 2160, "EU"},  // 60 GHz EDMG CB2
-    {22, 17, 18, 56160, 2160, "EU"}, // 60 GHz EDMG CB3
-    {23, 25, 25, 56160, 2160, "EU"}, // 60 GHz EDMG CB4
+    {4, 1, 13, 2407, 5, freq_region_eu},       // 2.4 GHz channels 1-13
+    {11, 1, 9, 2407, 5, freq_region_eu},       // 2.4 GHz 40MHz channels 1-9
+    {12, 5, 13, 2407, 5, freq_region_eu},      // 2.4 GHz 40MHz channels 5-13
+    {1, 36, 48, 5000, 5, freq_region_eu},      // 5 GHz channels 36-48
+    {2, 52, 64, 5000, 5, freq_region_eu},      // 5 GHz channels 52-64
+    {3, 100, 140, 5000, 5, freq_region_eu},    // 5 GHz channels 100-140
+    {17, 149, 169, 5000, 5, freq_region_eu},   // 5 GHz channels 149-169
+    {18, 1, 6, 56160, 2160, freq_region_eu},   // 60 GHz channels 1-6
+    {21, 9, 11, 56160, 2160, freq_region_eu},  // 60 GHz EDMG CB2
+    {22, 17, 18, 56160, 2160, freq_region_eu}, // 60 GHz EDMG CB3
+    {23, 25, 25, 56160, 2160, freq_region_eu}, // 60 GHz EDMG CB4
 
     // JP region specific
-    {30, 1, 13, 2407, 5, "JP"},      // 2.4 GHz channels 1-13
-    {31, 14, 14, 2414, 5, "JP"},     // 2.4 GHz channel 14
-    {1, 34, 64, 5000, 5, "JP"},      // 5 GHz channels 34-64
-    {32, 52, 64, 5000, 5, "JP"},     // 5 GHz channels 52-64
-    {34, 100, 140, 5000, 5, "JP"},   // 5 GHz channels 100-140
-    {59, 1, 6, 56160, 2160, "JP"},   // 60 GHz channels 1-6
-    {62, 9, 11, 56160, 2160, "JP"},  // 60 GHz EDMG CB2
-    {63, 17, 18, 56160, 2160, "JP"}, // 60 GHz EDMG CB3
-    {64, 25, 25, 56160, 2160, "JP"}, // 60 GHz EDMG CB4
+    {30, 1, 13, 2407, 5, freq_region_jp},      // 2.4 GHz channels 1-13
+    {31, 14, 14, 2414, 5, freq_region_jp},     // 2.4 GHz channel 14
+    {1, 34, 64, 5000, 5, freq_region_jp},      // 5 GHz channels 34-64
+    {32, 52, 64, 5000, 5, freq_region_jp},     // 5 GHz channels 52-64
+    {34, 100, 140, 5000, 5, freq_region_jp},   // 5 GHz channels 100-140
+    {59, 1, 6, 56160, 2160, freq_region_jp},   // 60 GHz channels 1-6
+    {62, 9, 11, 56160, 2160, freq_region_jp},  // 60 GHz EDMG CB2
+    {63, 17, 18, 56160, 2160, freq_region_jp}, // 60 GHz EDMG CB3
+    {64, 25, 25, 56160, 2160, freq_region_jp}, // 60 GHz EDMG CB4
 
     // CN region specific
-    {7, 1, 13, 2407, 5, "CN"},       // 2.4 GHz channels 1-13
-    {8, 1, 9, 2407, 5, "CN"},        // 2.4 GHz 40MHz channels 1-9
-    {9, 5, 13, 2407, 5, "CN"},       // 2.4 GHz 40MHz channels 5-13
-    {1, 36, 48, 5000, 5, "CN"},      // 5 GHz channels 36-48
-    {2, 52, 64, 5000, 5, "CN"},      // 5 GHz channels 52-64
-    {3, 149, 165, 5000, 5, "CN"},    // 5 GHz channels 149-165
-    {6, 149, 157, 5000, 5, "CN"}     // 5 GHz 40MHz channels 149,157
+    {7, 1, 13, 2407, 5, freq_region_cn},       // 2.4 GHz channels 1-13
+    {8, 1, 9, 2407, 5, freq_region_cn},        // 2.4 GHz 40MHz channels 1-9
+    {9, 5, 13, 2407, 5, freq_region_cn},       // 2.4 GHz 40MHz channels 5-13
+    {1, 36, 48, 5000, 5, freq_region_cn},      // 5 GHz channels 36-48
+    {2, 52, 64, 5000, 5, freq_region_cn},      // 5 GHz channels 52-64
+    {3, 149, 165, 5000, 5, freq_region_cn},    // 5 GHz channels 149-165
+    {6, 149, 157, 5000, 5, freq_region_cn}     // 5 GHz 40MHz channels 149,157
 };
 
-int util::em_chan_to_freq(uint8_t op_class, uint8_t channel, const std::string& region) {
+constexpr size_t num_frequency_ranges = sizeof(frequency_ranges) / sizeof(frequency_ranges[0]);
 
-    for (const auto& range : frequency_ranges) {
+// 2.4, 5 and 6 GHz, the frequencies looked up per neighbor of scan and beacon reports
+constexpr unsigned int freq_table_min = 2400;
+constexpr unsigned int freq_table_max = 7200;
+constexpr unsigned int freq_table_size = freq_table_max - freq_table_min + 1;
 
-        uint8_t chan = channel;
-        if (chan == 0) {
-            chan = range.min_chan; // If channel is 0, use the minimum channel in the range
-        }
+/*
+ * Direct lookup tables generated at compile time from frequency_ranges. Regional and
+ * global operating classes never share a number within a region, so an operating class
+ * has at most one range per region. A frequency maps to the first range of its region,
+ * or without one to the first global range when no region is given and to the last
+ * global range otherwise, as the range scan did.
+ */
+struct freq_tables {
+    uint8_t range[freq_region_max + 1][256];        // range index + 1 per operating class, 0 for none
+    uint16_t regional[freq_region_max][freq_table_size];  // op_class << 8 | channel, 0 for none
+    uint16_t first_global[freq_table_size];
+    uint16_t last_global[freq_table_size];
+};
 
-        bool is_valid_channel = (chan >= range.min_chan && chan <= range.max_chan);
-        bool is_valid_op_class = (range.op_class == op_class);
+constexpr freq_tables make_freq_tables()
+{
+    freq_tables t{};
+
+    for (size_t i = 0; i < num_frequency_ranges; i++) {
+        const freq_range& r = frequency_ranges[i];
+
+        for (unsigned int region = 0; region <= freq_region_max; region++) {
+            if (((r.region == freq_region_global) || (r.region == region)) && (t.range[region][r.op_class] == 0)) {
+                t.range[region][r.op_class] = static_cast<uint8_t>(i + 1);
+            }
+        }
 
-        if ((range.region.empty() || range.region == region) && 
-            is_valid_channel && is_valid_op_class) {
-            return range.base_freq + (chan * range.spacing);
+        for (unsigned int chan = r.min_chan; chan <= r.max_chan; chan++) {
+            unsigned int freq = r.base_freq + chan * r.spacing;
+            if ((freq < freq_table_min) || (freq > freq_table_max)) {
+                continue;
+            }
+            uint16_t val = static_cast<uint16_t>((r.op_class << 8) | chan);
+            if (r.region != freq_region_global) {
+                if (t.regional[r.region][freq - freq_table_min] == 0) {
+                    t.regional[r.region][freq - freq_table_min] = val;
+                }
+                continue;
+            }
+            if (t.first_global[freq - freq_table_min] == 0) {
+                t.first_global[freq - freq_table_min] = val;
+            }
+            t.last_global[freq - freq_table_min] = val;
         }
     }
-    return -1;
+
+    return t;
+}
+
+constexpr freq_tables frequency_tables = make_freq_tables();
+
+static inline unsigned int get_freq_region(const std::string& region)
+{
+    if (region.empty()) {
+        return freq_region_global;
+    } else if (region == "US") {
+        return freq_region_us;
+    } else if (region == "EU") {
+        return freq_region_eu;
+    } else if (region == "JP") {
+        return freq_region_jp;
+    } else if (region == "CN") {
+        return freq_region_cn;
+    }
+
+    return freq_region_unknown;
+}
+
+int util::em_chan_to_freq(uint8_t op_class, uint8_t channel, const std::string& region) {
+
+    uint8_t idx = frequency_tables.range[get_freq_region(region)][op_class];
+    if (idx == 0) {
+        return -1;
+    }
+
+    const freq_range& range = frequency_ranges[idx - 1];
+    uint8_t chan = channel;
+    if (chan == 0) {
+        chan = range.min_chan; // If channel is 0, use the minimum channel in the range
+    }
+
+    if (chan < range.min_chan || chan > range.max_chan) {
+        return -1;
+    }
+    return range.base_freq + (chan * range.spacing);
 }
 
 std::pair<uint8_t, uint8_t> util::em_freq_to_chan(unsigned int frequency, const std::string& region) {
     std::pair<uint8_t, uint8_t> global_result;
-    
+    unsigned int region_idx = get_freq_region(region);
+
+    if (frequency >= freq_table_min && frequency <= freq_table_max) {
+        uint16_t val = 0;
+        if (region_idx == freq_region_global) {
+            val = frequency_tables.first_global[frequency - freq_table_min];
+        } else {
+            if (region_idx != freq_region_unknown) {
+                val = frequency_tables.regional[region_idx][frequency - freq_table_min];
+            }
+            if (val == 0) {
+                val = frequency_tables.last_global[frequency - freq_table_min];
+            }
+        }
+        if (val != 0) {
+            return std::make_pair(static_cast<uint8_t>(val >> 8), static_cast<uint8_t>(val & 0xff));
+        }
+        return global_result;
+    }
+
+    // 60 GHz, not worth a table
     for (const auto& range : frequency_ranges) {
         unsigned int min_freq = static_cast<unsigned int>(range.base_freq + (range.min_chan * range.spacing));
         unsigned int max_freq = static_cast<unsigned int>(range.base_freq + (range.max_chan * range.spacing));
@@ -404,10 +415,10 @@ std::pair<uint8_t, uint8_t> util::em_freq_to_chan(unsigned int frequency, const
         
         // Frequency is within range, return op class and channel
         auto result = std::make_pair(range.op_class, channel);
-        if (range.region == region) return result;
+        if (range.region == region_idx) return result;
         
         // Save global result if no region-specific match
-        if (range.region.empty()) {
+        if (range.region == freq_region_global) {
             global_result = result;
         }
     }
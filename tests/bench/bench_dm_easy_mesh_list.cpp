@@ -0,0 +1,189 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <string>
+#include "em_ctrl.h"
+#include "dm_easy_mesh_list.h"
+
+#define BENCH_NUM_AGENTS    16
+#define BENCH_NUM_RADIOS    2
+
+static void get_mac(unsigned int agent, unsigned int radio, unsigned int sta, mac_address_t mac)
+{
+    mac[0] = (sta == 0) ? 0x02 : 0x06;
+    mac[1] = static_cast<unsigned char> (agent);
+    mac[2] = static_cast<unsigned char> (radio);
+    mac[3] = static_cast<unsigned char> (sta >> 16);
+    mac[4] = static_cast<unsigned char> (sta >> 8);
+    mac[5] = static_cast<unsigned char> (sta);
+}
+
+/*
+ * Data model list of BENCH_NUM_AGENTS agents with BENCH_NUM_RADIOS radios each, and the
+ * station keys spread over all the radios, the way the controller sees a large mesh.
+ */
+class dm_list_fixture_t : public benchmark::Fixture {
+public:
+    em_ctrl_t *m_mgr = nullptr;
+    dm_easy_mesh_list_t *m_list = nullptr;
+    std::vector<std::string> m_sta_keys;
+
+    void SetUp(const benchmark::State& state) override
+    {
+        em_interface_t al{};
+        dm_easy_mesh_t *dm;
+        mac_address_t mac, bssid;
+        mac_addr_str_t sta_str, bssid_str, ruid_str;
+        em_long_string_t key;
+        unsigned int i, j, num_stas = static_cast<unsigned int> (state.range(0));
+
+        m_mgr = new em_ctrl_t();
+        m_list = new dm_easy_mesh_list_t();
+        m_list->init(m_mgr);
+        for (i = 0; i < BENCH_NUM_AGENTS; i++) {
+            get_mac(i, 0xff, 0, al.mac);
+            snprintf(al.name, sizeof(al.name), "agent%u", i);
+            dm = m_list->create_data_model("OneWifiMesh", &al, em_profile_type_3, false);
+            dm->set_num_radios(BENCH_NUM_RADIOS);
+            for (j = 0; j < BENCH_NUM_RADIOS; j++) {
+                get_mac(i, j, 0, dm->m_radio[j].m_radio_info.intf.mac);
+            }
+        }
+
+        m_sta_keys.clear();
+        for (i = 0; i < num_stas; i++) {
+            get_mac(i % BENCH_NUM_AGENTS, (i / BENCH_NUM_AGENTS) % BENCH_NUM_RADIOS, 0, mac);
+            memcpy(bssid, mac, sizeof(mac_address_t));
+            bssid[5] = 1;
+            dm_easy_mesh_t::macbytes_to_string(mac, ruid_str);
+            dm_easy_mesh_t::macbytes_to_string(bssid, bssid_str);
+            get_mac(i % BENCH_NUM_AGENTS, 0, i + 1, mac);
+            dm_easy_mesh_t::macbytes_to_string(mac, sta_str);
+            snprintf(key, sizeof(key), "%s@%s@%s", sta_str, bssid_str, ruid_str);
+            m_sta_keys.push_back(key);
+        }
+    }
+
+    void TearDown(const benchmark::State&) override
+    {
+        m_list->delete_all_data_models();
+        delete m_list;
+        delete m_mgr;
+    }
+
+    void put_all_stas()
+    {
+        dm_sta_t sta;
+        mac_address_t bssid, ruid;
+
+        for (auto& key : m_sta_keys) {
+            sta.init();
+            dm_sta_t::parse_sta_bss_radio_from_key(key.c_str(), sta.m_sta_info.id, bssid, ruid);
+            memcpy(sta.m_sta_info.bssid, bssid, sizeof(mac_address_t));
+            memcpy(sta.m_sta_info.radiomac, ruid, sizeof(mac_address_t));
+            m_list->put_sta(key.c_str(), &sta);
+        }
+    }
+};
+
+// first pass inserts, every later pass updates the stations in place
+BENCHMARK_DEFINE_F(dm_list_fixture_t, BM_dm_list_put_sta)(benchmark::State& state)
+{
+    for (auto _ : state) {
+        put_all_stas();
+    }
+    state.SetItemsProcessed(static_cast<int64_t> (state.iterations()) * state.range(0));
+}
+BENCHMARK_REGISTER_F(dm_list_fixture_t, BM_dm_list_put_sta)->Arg(1000)->Arg(10000);
+
+BENCHMARK_DEFINE_F(dm_list_fixture_t, BM_dm_list_get_sta)(benchmark::State& state)
+{
+    put_all_stas();
+    for (auto _ : state) {
+        for (auto& key : m_sta_keys) {
+            benchmark::DoNotOptimize(m_list->get_sta(key.c_str()));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t> (state.iterations()) * state.range(0));
+}
+BENCHMARK_REGISTER_F(dm_list_fixture_t, BM_dm_list_get_sta)->Arg(1000)->Arg(10000);
+
+BENCHMARK_DEFINE_F(dm_list_fixture_t, BM_dm_list_iterate_sta)(benchmark::State& state)
+{
+    dm_sta_t *sta;
+    unsigned int count = 0;
+
+    put_all_stas();
+    for (auto _ : state) {
+        count = 0;
+        for (sta = m_list->get_first_sta(); sta != NULL; sta = m_list->get_next_sta(sta)) {
+            count++;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.counters["stas"] = count;
+    state.SetItemsProcessed(static_cast<int64_t> (state.iterations()) * count);
+}
+BENCHMARK_REGISTER_F(dm_list_fixture_t, BM_dm_list_iterate_sta)->Arg(1000)->Arg(10000);
+
+// channel scan report of one radio, one key per neighbor as the scan report handler stores it
+BENCHMARK_DEFINE_F(dm_list_fixture_t, BM_dm_list_put_scan_result)(benchmark::State& state)
+{
+    dm_scan_result_t res;
+    em_neighbor_t *nbr;
+    mac_address_t dev, scanner;
+    mac_addr_str_t dev_str, scanner_str, bssid_str;
+    em_long_string_t key;
+    unsigned int i, j, num_channels = static_cast<unsigned int> (state.range(1));
+    std::vector<std::string> keys;
+
+    get_mac(0, 0xff, 0, dev);
+    get_mac(0, 0, 0, scanner);
+    dm_easy_mesh_t::macbytes_to_string(dev, dev_str);
+    dm_easy_mesh_t::macbytes_to_string(scanner, scanner_str);
+
+    res.init();
+    res.m_scan_result.num_neighbors = EM_MAX_NEIGHBORS;
+    for (j = 0; j < EM_MAX_NEIGHBORS; j++) {
+        nbr = &res.m_scan_result.neighbor[j];
+        get_mac(0x80, 0, j + 1, nbr->bssid);
+        snprintf(nbr->ssid, sizeof(nbr->ssid), "neighbor%u", j);
+        nbr->signal_strength = static_cast<signed char> (-40 - static_cast<int> (j));
+    }
+    for (i = 0; i < num_channels; i++) {
+        for (j = 0; j < EM_MAX_NEIGHBORS; j++) {
+            dm_easy_mesh_t::macbytes_to_string(res.m_scan_result.neighbor[j].bssid, bssid_str);
+            snprintf(key, sizeof(key), "OneWifiMesh@%s@%s@%u@%u@%d@%s", dev_str, scanner_str, 128,
+                36 + (4 * i), em_scanner_type_radio, bssid_str);
+            keys.push_back(key);
+        }
+    }
+
+    for (auto _ : state) {
+        for (i = 0; i < keys.size(); i++) {
+            m_list->put_scan_result(keys[i].c_str(), &res, i % EM_MAX_NEIGHBORS);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t> (state.iterations()) * static_cast<int64_t> (keys.size()));
+}
+BENCHMARK_REGISTER_F(dm_list_fixture_t, BM_dm_list_put_scan_result)->Args({0, 8})->Args({0, 32});
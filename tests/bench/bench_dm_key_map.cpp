@@ -0,0 +1,188 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+#include <string>
+#include "collection.h"
+#include "dm_easy_mesh.h"
+#include "dm_key_map.h"
+
+/*
+ * dm_key_map_t against the hash_map_t it replaced for the STA maps, keyed the way each
+ * of them is: binary STA, BSSID and radio tuples, and the "sta@bssid@ruid" strings
+ * strdup'ed into the map.
+ */
+class dm_key_map_fixture_t : public benchmark::Fixture {
+public:
+    dm_key_map_t *m_map = nullptr;
+    hash_map_t *m_hash_map = nullptr;
+    std::vector<dm_map_key_t> m_keys;
+    std::vector<std::string> m_str_keys;
+    std::vector<unsigned int> m_vals;
+
+    void SetUp(const benchmark::State& state) override
+    {
+        mac_address_t sta, bssid, ruid;
+        mac_addr_str_t sta_str, bssid_str, ruid_str;
+        em_long_string_t str;
+        dm_map_key_t key;
+        unsigned int i, num = static_cast<unsigned int> (state.range(0));
+
+        m_map = new dm_key_map_t();
+        m_hash_map = hash_map_create();
+        m_keys.clear();
+        m_str_keys.clear();
+        m_vals.assign(num, 0);
+        for (i = 0; i < num; i++) {
+            memset(ruid, 0, sizeof(mac_address_t));
+            ruid[0] = 0x02;
+            ruid[4] = static_cast<unsigned char> (i % 32);
+            memcpy(bssid, ruid, sizeof(mac_address_t));
+            bssid[5] = static_cast<unsigned char> (1 + (i % 4));
+            sta[0] = 0x06;
+            sta[1] = 0;
+            sta[2] = 0;
+            sta[3] = static_cast<unsigned char> (i >> 16);
+            sta[4] = static_cast<unsigned char> (i >> 8);
+            sta[5] = static_cast<unsigned char> (i);
+
+            dm_key_map_t::sta_key(&key, sta, bssid, ruid);
+            m_keys.push_back(key);
+            dm_easy_mesh_t::macbytes_to_string(sta, sta_str);
+            dm_easy_mesh_t::macbytes_to_string(bssid, bssid_str);
+            dm_easy_mesh_t::macbytes_to_string(ruid, ruid_str);
+            snprintf(str, sizeof(str), "%s@%s@%s", sta_str, bssid_str, ruid_str);
+            m_str_keys.push_back(str);
+
+            m_map->put(&key, &m_vals[i]);
+            hash_map_put(m_hash_map, strdup(str), &m_vals[i]);
+        }
+    }
+
+    void TearDown(const benchmark::State&) override
+    {
+        // the values are not the map's to free, take them out before destroying it
+        for (auto& key : m_str_keys) {
+            hash_map_remove(m_hash_map, key.c_str());
+        }
+        hash_map_destroy(m_hash_map);
+        delete m_map;
+    }
+};
+
+BENCHMARK_DEFINE_F(dm_key_map_fixture_t, BM_dm_key_map_get)(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (auto& key : m_keys) {
+            benchmark::DoNotOptimize(m_map->get(&key));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t> (state.iterations()) * state.range(0));
+}
+BENCHMARK_REGISTER_F(dm_key_map_fixture_t, BM_dm_key_map_get)->Arg(1000)->Arg(10000);
+
+BENCHMARK_DEFINE_F(dm_key_map_fixture_t, BM_hash_map_get)(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (auto& key : m_str_keys) {
+            benchmark::DoNotOptimize(hash_map_get(m_hash_map, key.c_str()));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t> (state.iterations()) * state.range(0));
+}
+BENCHMARK_REGISTER_F(dm_key_map_fixture_t, BM_hash_map_get)->Arg(1000)->Arg(10000);
+
+// a lookup of a STA that is not there, as for every new association
+BENCHMARK_DEFINE_F(dm_key_map_fixture_t, BM_dm_key_map_get_miss)(benchmark::State& state)
+{
+    dm_map_key_t miss;
+
+    for (auto _ : state) {
+        for (auto& key : m_keys) {
+            miss = key;
+            miss.mac[0][0] = 0x0a;
+            benchmark::DoNotOptimize(m_map->get(&miss));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t> (state.iterations()) * state.range(0));
+}
+BENCHMARK_REGISTER_F(dm_key_map_fixture_t, BM_dm_key_map_get_miss)->Arg(1000)->Arg(10000);
+
+BENCHMARK_DEFINE_F(dm_key_map_fixture_t, BM_dm_key_map_iterate)(benchmark::State& state)
+{
+    void *val;
+    unsigned int count = 0;
+
+    for (auto _ : state) {
+        count = 0;
+        for (val = m_map->get_first(); val != NULL; val = m_map->get_next(val)) {
+            count++;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(static_cast<int64_t> (state.iterations()) * count);
+}
+BENCHMARK_REGISTER_F(dm_key_map_fixture_t, BM_dm_key_map_iterate)->Arg(1000)->Arg(10000);
+
+BENCHMARK_DEFINE_F(dm_key_map_fixture_t, BM_hash_map_iterate)(benchmark::State& state)
+{
+    void *val;
+    unsigned int count = 0;
+
+    for (auto _ : state) {
+        count = 0;
+        for (val = hash_map_get_first(m_hash_map); val != NULL; val = hash_map_get_next(m_hash_map, val)) {
+            count++;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(static_cast<int64_t> (state.iterations()) * count);
+}
+BENCHMARK_REGISTER_F(dm_key_map_fixture_t, BM_hash_map_iterate)->Arg(1000)->Arg(10000);
+
+// a STA joining and leaving, its key put then removed
+BENCHMARK_DEFINE_F(dm_key_map_fixture_t, BM_dm_key_map_put_remove)(benchmark::State& state)
+{
+    unsigned int i = 0, num = static_cast<unsigned int> (m_keys.size());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m_map->remove(&m_keys[i]));
+        m_map->put(&m_keys[i], &m_vals[i]);
+        i = (i + 1) % num;
+    }
+    state.SetItemsProcessed(static_cast<int64_t> (state.iterations()));
+}
+BENCHMARK_REGISTER_F(dm_key_map_fixture_t, BM_dm_key_map_put_remove)->Arg(1000)->Arg(10000);
+
+BENCHMARK_DEFINE_F(dm_key_map_fixture_t, BM_hash_map_put_remove)(benchmark::State& state)
+{
+    unsigned int i = 0, num = static_cast<unsigned int> (m_str_keys.size());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(hash_map_remove(m_hash_map, m_str_keys[i].c_str()));
+        hash_map_put(m_hash_map, strdup(m_str_keys[i].c_str()), &m_vals[i]);
+        i = (i + 1) % num;
+    }
+    state.SetItemsProcessed(static_cast<int64_t> (state.iterations()));
+}
+BENCHMARK_REGISTER_F(dm_key_map_fixture_t, BM_hash_map_put_remove)->Arg(1000)->Arg(10000);
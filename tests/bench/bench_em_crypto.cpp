@@ -0,0 +1,219 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "em_crypto.h"
+#include "aes_siv.h"
+#include "em_1905_key_table.h"
+
+static void BM_em_crypto_sha256(benchmark::State& state)
+{
+    std::vector<uint8_t> data(static_cast<size_t> (state.range(0)), 0xa5);
+    uint8_t digest[SHA256_MAC_LEN];
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(em_crypto_t::platform_SHA256(data.data(), data.size(), digest));
+    }
+    state.SetBytesProcessed(static_cast<int64_t> (state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_em_crypto_sha256)->Arg(64)->Arg(1024)->Arg(16384);
+
+// the authenticator of M2 is an HMAC over M1 and M2
+static void BM_em_crypto_hmac_sha256(benchmark::State& state)
+{
+    std::vector<uint8_t> m1(static_cast<size_t> (state.range(0)), 0x11), m2(static_cast<size_t> (state.range(0)), 0x22);
+    uint8_t key[SHA256_MAC_LEN] = {0x5a};
+    uint8_t *addr[2] = {m1.data(), m2.data()};
+    size_t len[2] = {m1.size(), m2.size()};
+    uint8_t hmac[SHA256_MAC_LEN];
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(em_crypto_t::platform_hmac_SHA256(key, sizeof(key), 2, addr, len, hmac));
+    }
+    state.SetBytesProcessed(static_cast<int64_t> (state.iterations()) * state.range(0) * 2);
+}
+BENCHMARK(BM_em_crypto_hmac_sha256)->Arg(512)->Arg(2048);
+
+// one side of the Diffie-Hellman exchange of M1/M2, once per onboarded radio
+static void BM_em_crypto_dh_shared_secret(benchmark::State& state)
+{
+    em_crypto_t local, remote;
+    em_crypto_info_t *local_info, *remote_info;
+    uint8_t *secret;
+    uint16_t secret_len;
+
+    if ((local.init() != 0) || (remote.init() != 0)) {
+        state.SkipWithError("em_crypto_t init failed");
+        return;
+    }
+    local_info = local.get_crypto_info();
+    remote_info = remote.get_crypto_info();
+    for (auto _ : state) {
+        secret = NULL;
+        if (em_crypto_t::platform_compute_shared_secret(&secret, &secret_len, remote_info->e_pub,
+                static_cast<uint16_t> (remote_info->e_pub_len), local_info->e_priv,
+                static_cast<uint8_t> (local_info->e_priv_len)) != 1) {
+            state.SkipWithError("shared secret failed");
+            break;
+        }
+        free(secret);
+    }
+}
+BENCHMARK(BM_em_crypto_dh_shared_secret);
+
+static void BM_em_crypto_aes_key_wrap(benchmark::State& state)
+{
+    uint8_t kek[32] = {0x01}, plain[64] = {0x02}, wrapped[sizeof(plain) + 8], unwrapped[sizeof(plain) + 8];
+    uint32_t wrapped_len, unwrapped_len;
+
+    for (auto _ : state) {
+        wrapped_len = sizeof(wrapped);
+        unwrapped_len = sizeof(unwrapped);
+        em_crypto_t::aes_key_wrap(kek, sizeof(kek), plain, sizeof(plain), wrapped, &wrapped_len);
+        benchmark::DoNotOptimize(em_crypto_t::aes_key_unwrap(kek, sizeof(kek), wrapped, wrapped_len, unwrapped, &unwrapped_len));
+    }
+}
+BENCHMARK(BM_em_crypto_aes_key_wrap);
+
+// wrapped DPP attributes, encrypted and then decrypted with two associated data items
+static void BM_aes_siv_wrap_unwrap(benchmark::State& state)
+{
+    siv_ctx ctx;
+    uint8_t key[64] = {0x33}, tag[AES_BLOCK_SIZE], ad1[16] = {0x44}, ad2[32] = {0x55};
+    std::vector<uint8_t> plain(static_cast<size_t> (state.range(0)), 0x66), cipher(plain.size()), out(plain.size());
+
+    if (siv_init(&ctx, key, SIV_256) != 1) {
+        state.SkipWithError("siv_init failed");
+        return;
+    }
+    for (auto _ : state) {
+        siv_encrypt(&ctx, plain.data(), cipher.data(), static_cast<int> (plain.size()), tag, 2,
+            ad1, sizeof(ad1), ad2, sizeof(ad2));
+        if (siv_decrypt(&ctx, cipher.data(), out.data(), static_cast<int> (cipher.size()), tag, 2,
+                ad1, sizeof(ad1), ad2, sizeof(ad2)) != 1) {
+            state.SkipWithError("siv_decrypt failed");
+            break;
+        }
+    }
+    siv_free(&ctx);
+    state.SetBytesProcessed(static_cast<int64_t> (state.iterations()) * state.range(0) * 2);
+}
+BENCHMARK(BM_aes_siv_wrap_unwrap)->Arg(64)->Arg(512)->Arg(4096);
+
+// Encrypted Settings of an M2 with one entry per BSS, each keyed again by the per call primitives
+static void BM_em_crypto_m2_settings_per_call(benchmark::State& state)
+{
+    uint8_t auth_key[WPS_AUTHKEY_LEN] = {0x5a}, key_wrap_key[WPS_KEYWRAPKEY_LEN] = {0xa5};
+    uint8_t plain[128] = {0x77}, out[sizeof(plain) + 2 * AES_BLOCK_SIZE], hash[SHA256_MAC_LEN];
+    uint8_t *addr[1] = {plain};
+    size_t len[1] = {96};
+    uint32_t cipher_len;
+    int64_t i;
+
+    for (auto _ : state) {
+        for (i = 0; i < state.range(0); i++) {
+            em_crypto_t::platform_hmac_SHA256(auth_key, sizeof(auth_key), 1, addr, len, hash);
+            memcpy(plain + len[0], hash, EM_KEY_WRAP_TLV_LEN);
+            em_crypto_t::generate_iv(out, AES_BLOCK_SIZE);
+            benchmark::DoNotOptimize(em_crypto_t::platform_aes_128_cbc_encrypt(key_wrap_key, out, plain,
+                static_cast<uint32_t> (len[0] + 12), out + AES_BLOCK_SIZE, &cipher_len));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t> (state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_em_crypto_m2_settings_per_call)->Arg(1)->Arg(4)->Arg(16)->Arg(32);
+
+// the same with em_wsc_seal_t, keyed once per M2 as set_wsc_keys() does
+static void BM_em_crypto_m2_settings_seal(benchmark::State& state)
+{
+    uint8_t auth_key[WPS_AUTHKEY_LEN] = {0x5a}, key_wrap_key[WPS_KEYWRAPKEY_LEN] = {0xa5};
+    uint8_t plain[128] = {0x77}, out[sizeof(plain) + 2 * AES_BLOCK_SIZE];
+    em_wsc_seal_t seal;
+    int64_t i;
+
+    for (auto _ : state) {
+        if (seal.set_keys(auth_key, key_wrap_key) != 0) {
+            state.SkipWithError("set_keys failed");
+            break;
+        }
+        for (i = 0; i < state.range(0); i++) {
+            benchmark::DoNotOptimize(seal.seal(plain, 96, out));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t> (state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_em_crypto_m2_settings_seal)->Arg(1)->Arg(4)->Arg(16)->Arg(32);
+
+// encrypted unicast 1905 messages, sealed for a peer of the key table and opened by the peer
+static void BM_em_1905_encrypt_decrypt(benchmark::State& state)
+{
+    const unsigned char ctrl_mac[] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01}, agent_mac[] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02};
+    const unsigned char cmdu[] = {0x00, 0x00, 0x80, 0x02, 0x12, 0x34, 0x00, 0x80};
+    unsigned char tk[EM_1905_TK_LEN] = {0x3c};
+    std::vector<unsigned char> tlvs(static_cast<size_t> (state.range(0)), 0x11), plain(tlvs.size());
+    std::vector<unsigned char> value(EM_1905_ENCR_HDR_LEN + AES_BLOCK_SIZE + tlvs.size());
+    em_1905_key_table_t ctrl, agent;
+    int len;
+
+    ctrl.set_al_mac(ctrl_mac);
+    agent.set_al_mac(agent_mac);
+    ctrl.install_ptk(agent_mac, tk, sizeof(tk));
+    agent.install_ptk(ctrl_mac, tk, sizeof(tk));
+    for (auto _ : state) {
+        len = ctrl.encrypt(agent_mac, cmdu, tlvs.data(), static_cast<unsigned int> (tlvs.size()), value.data(),
+            static_cast<unsigned int> (value.size()));
+        if ((len < 0) || (agent.decrypt(cmdu, value.data(), static_cast<unsigned int> (len), plain.data(),
+                static_cast<unsigned int> (plain.size())) < 0)) {
+            state.SkipWithError("1905 encryption failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t> (state.iterations()) * state.range(0));
+    state.SetItemsProcessed(static_cast<int64_t> (state.iterations()));
+}
+BENCHMARK(BM_em_1905_encrypt_decrypt)->Arg(64)->Arg(512)->Arg(1500);
+
+// MIC of multicast 1905 messages with the GTK, added and checked
+static void BM_em_1905_mic(benchmark::State& state)
+{
+    const unsigned char ctrl_mac[] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01}, agent_mac[] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02};
+    const unsigned char cmdu[] = {0x00, 0x00, 0x00, 0x01, 0x12, 0x34, 0x00, 0x80};
+    unsigned char gtk[EM_1905_GTK_LEN] = {0x5a}, value[EM_1905_MIC_HDR_LEN + EM_1905_MIC_LEN];
+    std::vector<unsigned char> tlvs(static_cast<size_t> (state.range(0)), 0x22);
+    em_1905_key_table_t ctrl, agent;
+    int len;
+
+    ctrl.set_al_mac(ctrl_mac);
+    agent.set_al_mac(agent_mac);
+    ctrl.install_gtk(agent_mac, gtk, sizeof(gtk), 1, 0);
+    agent.install_gtk(ctrl_mac, gtk, sizeof(gtk), 1, 0);
+    for (auto _ : state) {
+        len = ctrl.add_mic(cmdu, tlvs.data(), static_cast<unsigned int> (tlvs.size()), value, sizeof(value));
+        if ((len < 0) || (agent.check_mic(cmdu, tlvs.data(), static_cast<unsigned int> (tlvs.size()), value,
+                static_cast<unsigned int> (len)) != 0)) {
+            state.SkipWithError("1905 MIC failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t> (state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_em_1905_mic)->Arg(64)->Arg(512);
@@ -0,0 +1,138 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include "em_msg.h"
+#include "em_tlv_writer.h"
+
+// AP metrics response of one radio with num_stas stations, reassembled into one frame
+static unsigned int build_ap_metrics_rsp(em_tlv_writer_t *writer, unsigned int num_stas)
+{
+    mac_address_t dst = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01}, src = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02};
+    em_ap_metric_t metric;
+    em_ap_ext_metric_t ext;
+    em_assoc_sta_traffic_sts_t sts;
+    unsigned char link[sizeof(em_assoc_sta_link_metrics_t) + sizeof(em_assoc_link_metrics_t)];
+    em_assoc_sta_link_metrics_t *sta_link = reinterpret_cast<em_assoc_sta_link_metrics_t *> (link);
+    unsigned int i, len;
+
+    writer->set_frame_size(1024 * 1024);
+    writer->begin(dst, src, em_msg_type_ap_metrics_rsp, 1);
+
+    memset(&metric, 0, sizeof(metric));
+    memcpy(metric.bssid, src, sizeof(mac_address_t));
+    metric.num_sta = htons(static_cast<unsigned short> (num_stas));
+    metric.est_service_params_BE_bit = 1;
+    writer->add_tlv(em_tlv_type_ap_metrics, reinterpret_cast<unsigned char *> (&metric), sizeof(metric));
+    memset(&ext, 0, sizeof(ext));
+    memcpy(ext.bssid, src, sizeof(mac_address_t));
+    writer->add_tlv(em_tlv_type_ap_ext_metric, reinterpret_cast<unsigned char *> (&ext), sizeof(ext));
+
+    for (i = 0; i < num_stas; i++) {
+        memset(&sts, 0, sizeof(sts));
+        sts.sta_mac_addr[0] = 0x06;
+        sts.sta_mac_addr[4] = static_cast<unsigned char> (i >> 8);
+        sts.sta_mac_addr[5] = static_cast<unsigned char> (i);
+        writer->add_tlv(em_tlv_type_assoc_sta_traffic_sts, reinterpret_cast<unsigned char *> (&sts), sizeof(sts));
+
+        memset(link, 0, sizeof(link));
+        memcpy(sta_link->sta_mac, sts.sta_mac_addr, sizeof(mac_address_t));
+        sta_link->num_bssids = 1;
+        memcpy(sta_link->assoc_link_metrics[0].bssid, src, sizeof(mac_address_t));
+        writer->add_tlv(em_tlv_type_assoc_sta_link_metric, link, sizeof(link));
+    }
+    writer->finish();
+    writer->get_frame(0, &len);
+
+    return len;
+}
+
+static void BM_em_tlv_writer_build(benchmark::State& state)
+{
+    em_tlv_writer_t writer;
+    unsigned int len = 0;
+
+    for (auto _ : state) {
+        len = build_ap_metrics_rsp(&writer, static_cast<unsigned int> (state.range(0)));
+        benchmark::DoNotOptimize(len);
+    }
+    state.SetBytesProcessed(static_cast<int64_t> (state.iterations()) * len);
+}
+BENCHMARK(BM_em_tlv_writer_build)->Arg(8)->Arg(64)->Arg(512);
+
+static void BM_em_msg_validate(benchmark::State& state)
+{
+    em_tlv_writer_t writer;
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    unsigned char *frame;
+    unsigned int len;
+
+    len = build_ap_metrics_rsp(&writer, static_cast<unsigned int> (state.range(0)));
+    frame = writer.get_frame(0, &len);
+    for (auto _ : state) {
+        em_msg_t msg(em_msg_type_ap_metrics_rsp, em_profile_type_2, frame, len);
+        benchmark::DoNotOptimize(msg.validate(errors));
+    }
+    state.SetBytesProcessed(static_cast<int64_t> (state.iterations()) * len);
+}
+BENCHMARK(BM_em_msg_validate)->Arg(8)->Arg(64)->Arg(512);
+
+// every TLV in order, the way most handlers parse a CMDU
+static void BM_em_msg_tlv_walk(benchmark::State& state)
+{
+    em_tlv_writer_t writer;
+    em_tlv_t *tlvs, *tlv;
+    unsigned char *frame;
+    unsigned int len, tlvs_len, count = 0;
+
+    len = build_ap_metrics_rsp(&writer, static_cast<unsigned int> (state.range(0)));
+    frame = writer.get_frame(0, &len);
+    tlvs = reinterpret_cast<em_tlv_t *> (frame + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
+    tlvs_len = len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
+    for (auto _ : state) {
+        count = 0;
+        for (tlv = em_msg_t::get_first_tlv(tlvs, tlvs_len); tlv != NULL; tlv = em_msg_t::get_next_tlv(tlv, tlvs, tlvs_len)) {
+            count++;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.counters["tlvs"] = count;
+}
+BENCHMARK(BM_em_msg_tlv_walk)->Arg(8)->Arg(64)->Arg(512);
+
+// every instance of one TLV type through the index of em_msg_t, built once per message
+static void BM_em_msg_tlv_lookup(benchmark::State& state)
+{
+    em_tlv_writer_t writer;
+    unsigned char *frame;
+    unsigned int i, len, num;
+
+    len = build_ap_metrics_rsp(&writer, static_cast<unsigned int> (state.range(0)));
+    frame = writer.get_frame(0, &len);
+    for (auto _ : state) {
+        em_msg_t msg(frame + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t), len - static_cast<unsigned int> (sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)));
+        num = msg.get_tlv_count(em_tlv_type_assoc_sta_link_metric);
+        for (i = 0; i < num; i++) {
+            benchmark::DoNotOptimize(msg.get_tlv(em_tlv_type_assoc_sta_link_metric, i));
+        }
+    }
+}
+BENCHMARK(BM_em_msg_tlv_lookup)->Arg(8)->Arg(64)->Arg(512);
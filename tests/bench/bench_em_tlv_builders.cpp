@@ -0,0 +1,98 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <string.h>
+#include "em.h"
+#include "em_ctrl.h"
+#include "dm_easy_mesh.h"
+
+/*
+ * em_t of one radio of a data model with two radios and a BSS each, as the TLV builders
+ * of the capability report and M1 see it.
+ */
+class em_builder_fixture_t : public benchmark::Fixture {
+public:
+    em_ctrl_t *m_mgr = nullptr;
+    dm_easy_mesh_t *m_dm = nullptr;
+    em_t *m_em = nullptr;
+    unsigned char m_buff[MAX_EM_BUFF_SZ];
+
+    void SetUp(const benchmark::State&) override
+    {
+        em_interface_t ruid{};
+        unsigned int i;
+
+        m_mgr = new em_ctrl_t();
+        m_dm = new dm_easy_mesh_t();
+        m_dm->set_num_radios(2);
+        m_dm->m_num_bss = 2;
+        for (i = 0; i < 2; i++) {
+            unsigned char mac[] = {0x02, 0x00, 0x00, 0x00, static_cast<unsigned char> (i + 1), 0x00};
+            memcpy(m_dm->m_radio[i].m_radio_info.intf.mac, mac, sizeof(mac_address_t));
+            memcpy(m_dm->m_radio[i].m_radio_info.id.ruid, mac, sizeof(mac_address_t));
+            memcpy(m_dm->m_radio_cap[i].m_radio_cap_info.ruid.mac, mac, sizeof(mac_address_t));
+            memcpy(m_dm->m_bss[i].m_bss_info.ruid.mac, mac, sizeof(mac_address_t));
+            mac[5] = 1;
+            memcpy(m_dm->m_bss[i].m_bss_info.bssid.mac, mac, sizeof(mac_address_t));
+        }
+        memcpy(ruid.mac, m_dm->m_radio[0].m_radio_info.intf.mac, sizeof(mac_address_t));
+        strncpy(ruid.name, "wlan0", sizeof(ruid.name));
+        m_em = new em_t(&ruid, em_freq_band_24, m_dm, m_mgr, em_profile_type_3, em_service_type_agent, false);
+    }
+
+    void TearDown(const benchmark::State&) override
+    {
+        delete m_em;
+        delete m_dm;
+        delete m_mgr;
+    }
+};
+
+// served from the per em cache while the radios do not change
+BENCHMARK_F(em_builder_fixture_t, BM_em_create_ap_cap_tlv_cached)(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m_em->create_ap_cap_tlv(m_buff));
+    }
+}
+
+// encoded again on every call, as after each radio update
+BENCHMARK_F(em_builder_fixture_t, BM_em_create_ap_cap_tlv_changed)(benchmark::State& state)
+{
+    for (auto _ : state) {
+        m_dm->set_radio_changed();
+        benchmark::DoNotOptimize(m_em->create_ap_cap_tlv(m_buff));
+    }
+}
+
+BENCHMARK_F(em_builder_fixture_t, BM_em_create_ht_tlv_changed)(benchmark::State& state)
+{
+    for (auto _ : state) {
+        m_dm->set_radio_changed();
+        benchmark::DoNotOptimize(m_em->create_ht_tlv(m_buff));
+    }
+}
+
+BENCHMARK_F(em_builder_fixture_t, BM_em_create_ap_radio_advanced_cap_tlv)(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m_em->create_ap_radio_advanced_cap_tlv(m_buff));
+    }
+}
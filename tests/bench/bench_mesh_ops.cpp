@@ -0,0 +1,324 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <vector>
+#include "em.h"
+#include "em_ctrl.h"
+#include "em_tlv_writer.h"
+#include "em_policy_push.h"
+#include "dm_easy_mesh_ctrl.h"
+#include "tr_181_paths.h"
+
+#define MESH_NUM_AGENTS     32
+#define MESH_NUM_RADIOS     2
+#define MESH_NUM_BSS        2       // per radio
+
+static void get_mac(unsigned int agent, unsigned int radio, unsigned int sta, mac_address_t mac)
+{
+    mac[0] = (sta == 0) ? 0x02 : 0x06;
+    mac[1] = static_cast<unsigned char> (agent);
+    mac[2] = static_cast<unsigned char> (radio);
+    mac[3] = static_cast<unsigned char> (sta >> 16);
+    mac[4] = static_cast<unsigned char> (sta >> 8);
+    mac[5] = static_cast<unsigned char> (sta);
+}
+
+static void free_property(bus_data_prop_t *prop)
+{
+    bus_data_prop_t *next;
+
+    while (prop != NULL) {
+        next = prop->next_data;
+        if (prop->value.data_type == bus_data_type_string) {
+            free(prop->value.raw_data.bytes);
+        }
+        free(prop);
+        prop = next;
+    }
+}
+
+/*
+ * Mesh of MESH_NUM_AGENTS agents in the data model of the controller instance, the one the
+ * TR-181 handlers read, with MESH_NUM_RADIOS radios of MESH_NUM_BSS BSSs each and the
+ * stations spread over the first BSS of every radio. The operations timed here are the
+ * ones whose cost grows with the mesh, the thresholds of build/run-bench.sh guard them.
+ */
+class mesh_fixture_t : public benchmark::Fixture {
+public:
+    dm_easy_mesh_ctrl_t *m_ctrl = nullptr;
+    em_t *m_em = nullptr;
+    std::vector<unsigned char> m_topo_resp;     // Topology Response of the first agent
+    em_topo_resp_t m_resp;
+    unsigned char m_buff[MAX_EM_BUFF_SZ];
+
+    void SetUp(const benchmark::State& state) override
+    {
+        static bool list_ready = false;
+        em_interface_t al{}, ruid{};
+        dm_easy_mesh_t *dm;
+        dm_bss_t *bss;
+        dm_sta_t sta;
+        mac_address_t mac;
+        mac_addr_str_t sta_str, bssid_str, ruid_str;
+        em_long_string_t key;
+        unsigned int i, j, k, num_stas = static_cast<unsigned int> (state.range(0));
+
+        m_ctrl = em_ctrl_t::get_em_ctrl_instance()->get_dm_ctrl();
+        if (list_ready == false) {
+            m_ctrl->init_data_model_list(em_ctrl_t::get_em_ctrl_instance());
+            list_ready = true;
+        }
+
+        for (i = 0; i < MESH_NUM_AGENTS; i++) {
+            get_mac(i, 0xff, 0, al.mac);
+            snprintf(al.name, sizeof(al.name), "agent%u", i);
+            dm = m_ctrl->create_data_model("OneWifiMesh", &al, em_profile_type_3);
+            memcpy(dm->get_device()->m_device_info.id.dev_mac, al.mac, sizeof(mac_address_t));
+            dm->set_num_radios(MESH_NUM_RADIOS);
+            dm->m_num_bss = MESH_NUM_RADIOS * MESH_NUM_BSS;
+            for (j = 0; j < MESH_NUM_RADIOS; j++) {
+                get_mac(i, j, 0, mac);
+                memcpy(dm->m_radio[j].m_radio_info.intf.mac, mac, sizeof(mac_address_t));
+                memcpy(dm->m_radio[j].m_radio_info.id.ruid, mac, sizeof(mac_address_t));
+                for (k = 0; k < MESH_NUM_BSS; k++) {
+                    bss = &dm->m_bss[j * MESH_NUM_BSS + k];
+                    bss->init();
+                    memcpy(bss->m_bss_info.ruid.mac, mac, sizeof(mac_address_t));
+                    memcpy(bss->m_bss_info.bssid.mac, mac, sizeof(mac_address_t));
+                    bss->m_bss_info.bssid.mac[5] = static_cast<unsigned char> (k + 1);
+                    snprintf(bss->m_bss_info.ssid, sizeof(ssid_t), "mesh_ssid%u", k);
+                    bss->m_bss_info.enabled = true;
+                }
+            }
+        }
+
+        for (i = 0; i < num_stas; i++) {
+            get_mac(i % MESH_NUM_AGENTS, (i / MESH_NUM_AGENTS) % MESH_NUM_RADIOS, 0, mac);
+            dm_easy_mesh_t::macbytes_to_string(mac, ruid_str);
+            sta.init();
+            memcpy(sta.m_sta_info.radiomac, mac, sizeof(mac_address_t));
+            mac[5] = 1;
+            dm_easy_mesh_t::macbytes_to_string(mac, bssid_str);
+            memcpy(sta.m_sta_info.bssid, mac, sizeof(mac_address_t));
+            get_mac(i % MESH_NUM_AGENTS, 0, i + 1, sta.m_sta_info.id);
+            dm_easy_mesh_t::macbytes_to_string(sta.m_sta_info.id, sta_str);
+            snprintf(key, sizeof(key), "%s@%s@%s", sta_str, bssid_str, ruid_str);
+            m_ctrl->put_sta(key, &sta);
+        }
+
+        build_topology_response(num_stas);
+
+        dm = m_ctrl->get_first_dm();
+        memcpy(ruid.mac, dm->m_radio[0].m_radio_info.intf.mac, sizeof(mac_address_t));
+        strncpy(ruid.name, "wlan0", sizeof(ruid.name));
+        m_em = new em_t(&ruid, em_freq_band_24, dm, em_ctrl_t::get_em_ctrl_instance(), em_profile_type_3,
+            em_service_type_ctrl, false);
+    }
+
+    void TearDown(const benchmark::State&) override
+    {
+        delete m_em;
+        m_ctrl->delete_all_data_models();
+    }
+
+    // what agent 0 answers a Topology Query with, its radios, BSSs and associated stations
+    void build_topology_response(unsigned int num_stas)
+    {
+        em_tlv_writer_t writer;
+        mac_address_t dst = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01}, al, mac;
+        em_device_info_type_t *dev;
+        em_local_interface_t *intf;
+        em_ap_op_bss_t *op;
+        em_ap_op_bss_radio_t *radio;
+        em_ap_operational_bss_t *op_bss;
+        em_bss_config_rprt_t *rprt;
+        em_radio_rprt_t *rprt_radio;
+        em_bss_rprt_t *rprt_bss;
+        unsigned char *val, profile = static_cast<unsigned char> (em_profile_type_3);
+        unsigned short num;
+        unsigned int i, j, k, off, num_off, len;
+
+        get_mac(0, 0xff, 0, al);
+        writer.set_frame_size(1024 * 1024);
+        writer.begin(dst, al, em_msg_type_topo_resp, 1);
+
+        dev = reinterpret_cast<em_device_info_type_t *> (writer.open_tlv(em_tlv_type_device_info));
+        memcpy(dev->al_mac_addr, al, sizeof(mac_address_t));
+        dev->local_interface_num = MESH_NUM_RADIOS;
+        for (j = 0; j < MESH_NUM_RADIOS; j++) {
+            intf = &dev->local_interface[j];
+            memset(intf, 0, sizeof(em_local_interface_t));
+            get_mac(0, j, 0, intf->mac_addr);
+            intf->media_data.media_spec_size = 10;
+        }
+        writer.close_tlv(static_cast<unsigned int> (sizeof(em_device_info_type_t) + MESH_NUM_RADIOS * sizeof(em_local_interface_t)));
+
+        op = reinterpret_cast<em_ap_op_bss_t *> (writer.open_tlv(em_tlv_type_operational_bss));
+        op->radios_num = MESH_NUM_RADIOS;
+        off = sizeof(em_ap_op_bss_t);
+        for (j = 0; j < MESH_NUM_RADIOS; j++) {
+            radio = reinterpret_cast<em_ap_op_bss_radio_t *> (reinterpret_cast<unsigned char *> (op) + off);
+            get_mac(0, j, 0, radio->ruid);
+            radio->bss_num = MESH_NUM_BSS;
+            off += static_cast<unsigned int> (sizeof(em_ap_op_bss_radio_t));
+            for (k = 0; k < MESH_NUM_BSS; k++) {
+                op_bss = reinterpret_cast<em_ap_operational_bss_t *> (reinterpret_cast<unsigned char *> (op) + off);
+                get_mac(0, j, 0, op_bss->bssid);
+                op_bss->bssid[5] = static_cast<unsigned char> (k + 1);
+                op_bss->ssid_len = static_cast<unsigned char> (snprintf(op_bss->ssid, sizeof(ssid_t), "mesh_ssid%u", k));
+                off += static_cast<unsigned int> (sizeof(em_ap_operational_bss_t) + op_bss->ssid_len);
+            }
+        }
+        writer.close_tlv(off);
+
+        // stations on the first BSS of each radio, as the fixture associates them
+        val = writer.open_tlv(em_tlv_type_associated_clients);
+        val[0] = MESH_NUM_RADIOS;
+        off = 1;
+        for (j = 0; j < MESH_NUM_RADIOS; j++) {
+            get_mac(0, j, 0, val + off);
+            val[off + 5] = 1;
+            num_off = off + static_cast<unsigned int> (sizeof(mac_address_t));
+            off = num_off + static_cast<unsigned int> (sizeof(unsigned short));
+            num = 0;
+            for (i = 0; i < num_stas; i++) {
+                if (((i % MESH_NUM_AGENTS) != 0) || (((i / MESH_NUM_AGENTS) % MESH_NUM_RADIOS) != j)) {
+                    continue;
+                }
+                get_mac(0, 0, i + 1, mac);
+                memcpy(val + off, mac, sizeof(mac_address_t));
+                memset(val + off + sizeof(mac_address_t), 0, sizeof(unsigned short));
+                off += static_cast<unsigned int> (sizeof(em_assoc_clients_sta_t));
+                num++;
+            }
+            num = htons(num);
+            memcpy(val + num_off, &num, sizeof(unsigned short));
+        }
+        writer.close_tlv(off);
+
+        writer.add_tlv(em_tlv_type_profile, &profile, sizeof(profile));
+
+        rprt = reinterpret_cast<em_bss_config_rprt_t *> (writer.open_tlv(em_tlv_type_bss_conf_rep));
+        rprt->num_radios = MESH_NUM_RADIOS;
+        off = sizeof(em_bss_config_rprt_t);
+        for (j = 0; j < MESH_NUM_RADIOS; j++) {
+            rprt_radio = reinterpret_cast<em_radio_rprt_t *> (reinterpret_cast<unsigned char *> (rprt) + off);
+            get_mac(0, j, 0, rprt_radio->ruid);
+            rprt_radio->num_bss = MESH_NUM_BSS;
+            off += static_cast<unsigned int> (sizeof(em_radio_rprt_t));
+            for (k = 0; k < MESH_NUM_BSS; k++) {
+                rprt_bss = reinterpret_cast<em_bss_rprt_t *> (reinterpret_cast<unsigned char *> (rprt) + off);
+                memset(rprt_bss, 0, sizeof(em_bss_rprt_t));
+                get_mac(0, j, 0, rprt_bss->bssid);
+                rprt_bss->bssid[5] = static_cast<unsigned char> (k + 1);
+                rprt_bss->ssid_len = static_cast<unsigned char> (snprintf(rprt_bss->ssid, sizeof(ssid_t), "mesh_ssid%u", k));
+                off += static_cast<unsigned int> (sizeof(em_bss_rprt_t) + rprt_bss->ssid_len);
+            }
+        }
+        writer.close_tlv(off);
+
+        writer.finish();
+        val = writer.get_frame(0, &len);
+        m_topo_resp.assign(val, val + len);
+    }
+};
+
+BENCHMARK_DEFINE_F(mesh_fixture_t, BM_mesh_parse_topology_response)(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m_em->parse_topology_response(m_topo_resp.data(),
+            static_cast<unsigned int> (m_topo_resp.size()), &m_resp));
+    }
+    state.SetBytesProcessed(static_cast<int64_t> (state.iterations()) * static_cast<int64_t> (m_topo_resp.size()));
+}
+BENCHMARK_REGISTER_F(mesh_fixture_t, BM_mesh_parse_topology_response)->Arg(1000);
+
+// a command takes a copy of the data model of every agent it goes to
+BENCHMARK_DEFINE_F(mesh_fixture_t, BM_mesh_clone)(benchmark::State& state)
+{
+    dm_easy_mesh_t *dm, *clone;
+
+    for (auto _ : state) {
+        for (dm = m_ctrl->get_first_dm(); dm != NULL; dm = m_ctrl->get_next_dm(dm)) {
+            clone = new dm_easy_mesh_t();
+            *clone = *dm;
+            benchmark::DoNotOptimize(clone);
+            delete clone;
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t> (state.iterations()) * MESH_NUM_AGENTS);
+}
+BENCHMARK_REGISTER_F(mesh_fixture_t, BM_mesh_clone)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_DEFINE_F(mesh_fixture_t, BM_mesh_iterate_sta)(benchmark::State& state)
+{
+    dm_sta_t *sta;
+    unsigned int count = 0;
+
+    for (auto _ : state) {
+        count = 0;
+        for (sta = m_ctrl->get_first_sta(); sta != NULL; sta = m_ctrl->get_next_sta(sta)) {
+            count++;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.counters["stas"] = count;
+    state.SetItemsProcessed(static_cast<int64_t> (state.iterations()) * count);
+}
+BENCHMARK_REGISTER_F(mesh_fixture_t, BM_mesh_iterate_sta)->Arg(1000);
+
+// a full Subtree.Tree get, every device is sent as nothing was read before
+BENCHMARK_DEFINE_F(mesh_fixture_t, BM_mesh_tr181_subtree_get)(benchmark::State& state)
+{
+    char name[] = DE_SUBTREE_TREE;
+    raw_data_t data;
+    bus_data_prop_t *prop;
+    unsigned int count = 0;
+
+    for (auto _ : state) {
+        memset(&data, 0, sizeof(data));
+        benchmark::DoNotOptimize(dm_easy_mesh_ctrl_t::subtree_get_inner(name, &data, NULL));
+        state.PauseTiming();
+        prop = static_cast<bus_data_prop_t *> (data.raw_data.bytes);
+        for (count = 0; prop != NULL; prop = prop->next_data) {
+            count++;
+        }
+        free_property(static_cast<bus_data_prop_t *> (data.raw_data.bytes));
+        state.ResumeTiming();
+    }
+    state.counters["params"] = count;
+    state.SetItemsProcessed(static_cast<int64_t> (state.iterations()) * count);
+}
+BENCHMARK_REGISTER_F(mesh_fixture_t, BM_mesh_tr181_subtree_get)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_DEFINE_F(mesh_fixture_t, BM_mesh_create_policy_cfg_tlvs)(benchmark::State& state)
+{
+    unsigned short ruid_off[EM_POLICY_PUSH_MAX_RUID];
+    unsigned int num_ruid;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m_em->create_policy_cfg_tlvs(m_buff, ruid_off, &num_ruid));
+    }
+}
+BENCHMARK_REGISTER_F(mesh_fixture_t, BM_mesh_create_policy_cfg_tlvs)->Arg(1000);
@@ -0,0 +1,104 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "em_network_topo.h"
+#include "dm_easy_mesh.h"
+
+#define BENCH_NUM_RADIOS    2
+#define BENCH_NUM_BSS       2
+
+static dm_easy_mesh_t *create_dm(unsigned int level, unsigned int index)
+{
+    dm_easy_mesh_t *dm = new dm_easy_mesh_t{};
+    unsigned char mac[] = {0x02, static_cast<unsigned char> (level), static_cast<unsigned char> (index), 0x00, 0x00, 0x00};
+    unsigned int i, j;
+    em_bss_info_t *bss;
+
+    memcpy(dm->m_device.m_device_info.intf.mac, mac, sizeof(mac_address_t));
+    dm->set_num_radios(BENCH_NUM_RADIOS);
+    dm->m_num_bss = 0;
+    for (i = 0; i < BENCH_NUM_RADIOS; i++) {
+        mac[3] = static_cast<unsigned char> (i + 1);
+        mac[5] = 0;
+        memcpy(dm->m_radio[i].m_radio_info.intf.mac, mac, sizeof(mac_address_t));
+        memcpy(dm->m_radio[i].m_radio_info.id.ruid, mac, sizeof(mac_address_t));
+        for (j = 0; j < BENCH_NUM_BSS; j++) {
+            bss = &dm->m_bss[dm->m_num_bss++].m_bss_info;
+            mac[5] = static_cast<unsigned char> (j + 1);
+            memcpy(bss->id.ruid, dm->m_radio[i].m_radio_info.id.ruid, sizeof(mac_address_t));
+            memcpy(bss->id.bssid, mac, sizeof(mac_address_t));
+            memcpy(bss->bssid.mac, mac, sizeof(mac_address_t));
+            snprintf(bss->ssid, sizeof(bss->ssid), "OneWifiMesh");
+            bss->id.haul_type = em_haul_type_fronthaul;
+            // the stations of an AP BSS come from the controller data model, which needs the database
+            bss->vap_mode = em_vap_mode_sta;
+        }
+    }
+
+    return dm;
+}
+
+/*
+ * get_network_config() is the encode of the controller topology, a root device with
+ * state.range(0) children that have state.range(0) children each.
+ */
+static void BM_em_network_topo_encode(benchmark::State& state)
+{
+    unsigned int i, j, fanout = static_cast<unsigned int> (state.range(0));
+    std::vector<dm_easy_mesh_t *> dms;
+    std::vector<em_network_topo_t *> grand;
+    em_network_topo_t *root;
+    cJSON *parent;
+    char *str;
+    size_t len = 0;
+
+    dms.push_back(create_dm(0, 0));
+    root = new em_network_topo_t(dms[0]);
+    for (i = 0; i < fanout; i++) {
+        grand.clear();
+        dms.push_back(create_dm(1, i));
+        for (j = 0; j < fanout; j++) {
+            dms.push_back(create_dm(2, (i * fanout) + j));
+            grand.push_back(new em_network_topo_t(dms.back()));
+        }
+        root->add(dms[dms.size() - fanout - 1], grand.data(), fanout);
+    }
+
+    for (auto _ : state) {
+        parent = cJSON_CreateObject();
+        root->encode(parent);
+        str = cJSON_PrintUnformatted(parent);
+        len = strlen(str);
+        cJSON_free(str);
+        cJSON_Delete(parent);
+    }
+    state.counters["devices"] = static_cast<double> (dms.size());
+    state.SetBytesProcessed(static_cast<int64_t> (state.iterations() * len));
+
+    delete root;
+    for (auto dm : dms) {
+        delete dm;
+    }
+}
+BENCHMARK(BM_em_network_topo_encode)->Arg(1)->Arg(4);
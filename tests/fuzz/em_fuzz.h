@@ -0,0 +1,80 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EM_FUZZ_H
+#define EM_FUZZ_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#define EM_FUZZ_BUDGET_MS       50      // per input, overridden by EM_FUZZ_BUDGET_MS in the environment
+
+/*
+ * Time budget of one input. libFuzzer's -timeout only counts whole seconds and is meant
+ * for hangs, a parser that walks its TLVs quadratically stays well under it on the
+ * largest frames. An input that runs past the budget aborts, so libFuzzer stores it as a
+ * crash to be minimized like any other.
+ */
+class em_fuzz_budget_t {
+
+    uint64_t m_start_us;
+    size_t m_size;
+
+    static uint64_t get_time_us() {
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (static_cast<uint64_t>(ts.tv_sec) * 1000000) + static_cast<uint64_t>(ts.tv_nsec / 1000);
+    }
+
+    static uint64_t get_budget_us() {
+        static uint64_t budget_us = 0;
+        const char *env;
+
+        if (budget_us == 0) {
+            env = getenv("EM_FUZZ_BUDGET_MS");
+            budget_us = static_cast<uint64_t>((env != NULL) ? strtoul(env, NULL, 10):EM_FUZZ_BUDGET_MS) * 1000;
+            budget_us = (budget_us == 0) ? (EM_FUZZ_BUDGET_MS * 1000):budget_us;
+        }
+
+        return budget_us;
+    }
+
+public:
+
+    explicit em_fuzz_budget_t(size_t size): m_start_us(get_time_us()), m_size(size) {}
+
+    ~em_fuzz_budget_t() {
+        uint64_t elapsed_us = get_time_us() - m_start_us;
+
+        if (elapsed_us > get_budget_us()) {
+            fprintf(stderr, "Input of %zu bytes took %llu us, over the budget of %llu us\n", m_size,
+                    static_cast<unsigned long long>(elapsed_us), static_cast<unsigned long long>(get_budget_us()));
+            abort();
+        }
+    }
+
+    em_fuzz_budget_t(const em_fuzz_budget_t&) = delete;
+    em_fuzz_budget_t& operator=(const em_fuzz_budget_t&) = delete;
+};
+
+#endif
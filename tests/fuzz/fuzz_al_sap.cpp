@@ -0,0 +1,56 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include <stdexcept>
+#include "al_service_data_unit.h"
+#include "al_service_registration_request.h"
+#include "al_service_registration_response.h"
+#include "em_fuzz.h"
+
+/*
+ * Input: one message as read from the AL SAP socket. It is decoded as a data unit and as
+ * both registration messages. A decoder may refuse the input by throwing, anything else
+ * it does with it is a finding.
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    em_fuzz_budget_t budget(size);
+    std::vector<unsigned char> msg(data, data + size);
+    AlServiceDataUnit sdu;
+    AlServiceRegistrationRequest req;
+    AlServiceRegistrationResponse rsp;
+
+    try {
+        sdu.deserialize(msg);
+    } catch (const std::runtime_error&) {
+    }
+
+    try {
+        req.deserializeRegistrationRequest(msg);
+    } catch (const std::runtime_error&) {
+    }
+
+    try {
+        rsp.deserializeRegistrationResponse(msg);
+    } catch (const std::runtime_error&) {
+    }
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include "em_msg.h"
+#include "em_frame_ring.h"
+#include "em_fuzz.h"
+
+/*
+ * Input: one 1905 frame as received, Ethernet header, CMDU header and TLVs. The frame is
+ * checked against the TLV rules of its message type for every profile, then every TLV
+ * type is looked up through the index and through the plain walks the handlers use.
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    em_fuzz_budget_t budget(size);
+    unsigned int hdr_len = sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t), len, i, num;
+    char *errors[EM_MAX_TLV_MEMBERS];
+    em_msg_type_t type;
+    unsigned char *frame, *tlvs;
+    em_tlv_t *tlv;
+    int profile;
+
+    if ((size == 0) || (size > EM_RX_BUFF_SZ)) {
+        return 0;
+    }
+
+    // a copy of its exact size, so that ASan sees any read past the end of the frame
+    len = static_cast<unsigned int>(size);
+    if ((frame = static_cast<unsigned char *>(malloc(len))) == NULL) {
+        return 0;
+    }
+    memcpy(frame, data, len);
+
+    type = (len >= hdr_len) ? static_cast<em_msg_type_t>(ntohs(reinterpret_cast<em_cmdu_t *>(frame + sizeof(em_raw_hdr_t))->type)):em_msg_type_topo_disc;
+    for (profile = em_profile_type_1; profile <= em_profile_type_3; profile++) {
+        em_msg_t msg(type, static_cast<em_profile_type_t>(profile), frame, len);
+
+        memset(errors, 0, sizeof(errors));
+        msg.validate(errors);
+    }
+
+    if (len > hdr_len) {
+        tlvs = frame + hdr_len;
+        em_msg_t msg(tlvs, len - hdr_len);
+
+        msg.is_malformed();
+        for (i = 0; i < EM_MAX_TLV_TYPES; i++) {
+            num = msg.get_tlv_count(static_cast<em_tlv_type_t>(i));
+            if (num != 0) {
+                msg.get_tlv(static_cast<em_tlv_type_t>(i), num - 1);
+            }
+            em_msg_t::get_tlv(reinterpret_cast<em_tlv_t *>(tlvs), len - hdr_len, static_cast<em_tlv_type_t>(i));
+        }
+
+        for (tlv = em_msg_t::get_first_tlv(reinterpret_cast<em_tlv_t *>(tlvs), len - hdr_len); tlv != NULL;
+                tlv = em_msg_t::get_next_tlv(tlv, reinterpret_cast<em_tlv_t *>(tlvs), len - hdr_len));
+    }
+
+    free(frame);
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ec_util.h"
+#include "em_fuzz.h"
+
+typedef enum {
+    fuzz_dpp_frame,         // DPP public action frame, header and attributes
+    fuzz_dpp_chirp,         // value of a DPP Chirp TLV
+    fuzz_dpp_encap,         // value of a 1905 Encap DPP TLV
+    fuzz_dpp_max
+} fuzz_dpp_input_t;
+
+/*
+ * Input: one byte telling what the rest is, see fuzz_dpp_input_t, then the bytes as they
+ * come off the air or out of the TLV. Every attribute ID is fetched from a frame, first
+ * and second instance, through the index and through get_attrib().
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    em_fuzz_budget_t budget(size);
+    uint8_t *buff, *hash = NULL, *encap_frame = NULL, frame_type;
+    uint16_t len, hash_len = 0, encap_frame_len = 0;
+    mac_addr_t mac;
+    unsigned int id;
+
+    if ((size < 2) || (size - 1 > UINT16_MAX)) {
+        return 0;
+    }
+
+    // a copy of its exact size, so that ASan sees any read past the end of the input
+    len = static_cast<uint16_t>(size - 1);
+    if ((buff = static_cast<uint8_t *>(malloc(len))) == NULL) {
+        return 0;
+    }
+    memcpy(buff, data + 1, len);
+
+    switch (data[0] % fuzz_dpp_max) {
+        case fuzz_dpp_frame:
+            if ((len >= sizeof(ec_frame_t)) && (ec_util::validate_frame(reinterpret_cast<ec_frame_t *>(buff)) == true)) {
+                ec_attrib_index_t index(buff + sizeof(ec_frame_t), len - sizeof(ec_frame_t));
+
+                for (id = ec_attrib_id_dpp_status; id <= ec_attrib_id_config_nonce; id++) {
+                    index.get(static_cast<ec_attrib_id_t>(id));
+                    index.get(static_cast<ec_attrib_id_t>(id), 1);
+                    ec_util::get_attrib(buff + sizeof(ec_frame_t), len - sizeof(ec_frame_t), static_cast<ec_attrib_id_t>(id));
+                }
+            }
+            break;
+
+        case fuzz_dpp_chirp:
+            ec_util::parse_dpp_chirp_tlv(reinterpret_cast<em_dpp_chirp_value_t *>(buff), len, &mac, &hash, &hash_len);
+            break;
+
+        case fuzz_dpp_encap:
+            ec_util::parse_encap_dpp_tlv(reinterpret_cast<em_encap_dpp_t *>(buff), len, &mac, &frame_type, &encap_frame, &encap_frame_len);
+            break;
+
+        default:
+            break;
+    }
+
+    free(hash);
+    free(encap_frame);
+    free(buff);
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "em_cmdu_reasm.h"
+#include "em_fuzz.h"
+
+#define EM_FUZZ_REASM_STEP_US   1000
+
+/*
+ * Input: a sequence of fragments, each a 2 byte big endian length and the frame. The
+ * fragments go through one reassembler 1 ms apart, so that the fuzzer reaches the
+ * timeouts and quotas as well. Every buffer must be back in the ring at the end.
+ *
+ * The only buffer of the ring stays taken, so that the fragments and the messages are
+ * allocated from the heap at their exact size and ASan sees reads past their end.
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    static em_frame_ring_t ring;
+    static em_rx_buff_t *held = NULL;
+    em_fuzz_budget_t budget(size);
+    em_cmdu_reasm_t reasm;
+    em_rx_buff_t *buff;
+    unsigned int frame_len, len;
+    uint64_t now_us = 0;
+    size_t off = 0;
+
+    if ((held == NULL) && ((ring.init(1) != 0) || ((held = ring.get()) == NULL))) {
+        abort();
+    }
+    reasm.init(&ring);
+
+    while (off + sizeof(uint16_t) <= size) {
+        frame_len = (static_cast<unsigned int>(data[off]) << 8) | data[off + 1];
+        off += sizeof(uint16_t);
+        frame_len = (frame_len > size - off) ? static_cast<unsigned int>(size - off):frame_len;
+        if ((frame_len == 0) || ((buff = ring.get(frame_len)) == NULL)) {
+            break;
+        }
+
+        memcpy(buff->data, data + off, frame_len);
+        off += frame_len;
+        len = frame_len;
+        now_us += EM_FUZZ_REASM_STEP_US;
+        if ((buff = reasm.add(buff, &len, now_us)) != NULL) {
+            em_frame_ring_t::put(buff);
+        }
+    }
+
+    reasm.flush();
+    if (ring.get_in_use() != 1) {
+        abort();
+    }
+
+    return 0;
+}
@@ -607,3 +607,104 @@ TEST_F(ECUtilAttributeTest, AttributeReallocation) {
     }
     
 }
+
+// Test that the single pass index finds the same attributes as get_attrib
+TEST_F(ECUtilAttributeTest, AttributeIndex) {
+    size_t buffer_len = 0;
+    create_new_attrib_buf(buffer_len);
+    ASSERT_NE(buffer, nullptr);
+    buffer = ec_util::add_attrib(buffer, &buffer_len, ec_attrib_id_channel, std::string("second"));
+    ASSERT_NE(buffer, nullptr);
+
+    ec_attrib_index_t index(buffer, buffer_len);
+    EXPECT_FALSE(index.is_malformed());
+    for (const auto id : all_ec_attribute_ids) {
+        auto expected = ec_util::get_attrib(buffer, buffer_len, id);
+        auto attr = index.get(id);
+        ASSERT_EQ(attr.has_value(), expected.has_value());
+        if (attr.has_value()) {
+            EXPECT_EQ(attr->original, expected->original);
+            EXPECT_EQ(attr->length, expected->length);
+        }
+    }
+
+    EXPECT_EQ(index.count(ec_attrib_id_channel), 2u);
+    auto second = index.get(ec_attrib_id_channel, 1);
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(std::string(reinterpret_cast<char *>(second->data), second->length), "second");
+    EXPECT_FALSE(index.get(ec_attrib_id_channel, 2).has_value());
+
+    // A length running past the end stops the walk
+    reinterpret_cast<ec_net_attribute_t *>(test_attrib_2)->length = SWAP_LITTLE_ENDIAN(static_cast<uint16_t>(0xffff));
+    ec_attrib_index_t bad_index(buffer, buffer_len);
+    EXPECT_TRUE(bad_index.is_malformed());
+    EXPECT_TRUE(bad_index.get(ec_attrib_id_dpp_status).has_value());
+    EXPECT_FALSE(bad_index.get(ec_attrib_id_init_bootstrap_key_hash).has_value());
+    EXPECT_FALSE(bad_index.get(ec_attrib_id_channel).has_value());
+    EXPECT_EQ(bad_index.count(ec_attrib_id_channel), 0u);
+}
+
+// Test that the attribute writer builds the same frame as add_attrib and add_wrapped_data_attr
+TEST_F(ECUtilAttributeTest, AttributeWriterMatchesAddAttrib) {
+    uint8_t key[32], nonce[16], tag[32];
+    size_t attribs_len = 0;
+    uint8_t *attribs = NULL;
+
+    for (size_t i = 0; i < sizeof(key); i++) {
+        key[i] = static_cast<uint8_t>(i);
+        tag[i] = static_cast<uint8_t>(0xa0 + i);
+    }
+    memset(nonce, 0x5a, sizeof(nonce));
+
+    // DPP Status, SHA-256(BR), { I-nonce, { R-auth }ke }k1, the legacy way
+    attribs = ec_util::add_attrib(attribs, &attribs_len, ec_attrib_id_dpp_status, static_cast<uint8_t>(DPP_STATUS_OK));
+    attribs = ec_util::add_attrib(attribs, &attribs_len, ec_attrib_id_resp_bootstrap_key_hash, sizeof(tag), tag);
+    attribs = ec_util::add_wrapped_data_attr(frame, attribs, &attribs_len, true, key, [&](){
+        size_t wrapped_len = 0;
+        uint8_t *wrap_attribs = ec_util::add_attrib(NULL, &wrapped_len, ec_attrib_id_init_nonce, sizeof(nonce), nonce);
+        wrap_attribs = ec_util::add_wrapped_data_attr(frame, wrap_attribs, &wrapped_len, false, key, [&](){
+            size_t int_wrapped_len = 0;
+            uint8_t *int_wrapped_attrs = ec_util::add_attrib(NULL, &int_wrapped_len, ec_attrib_id_resp_auth_tag, sizeof(tag), tag);
+            return std::make_pair(int_wrapped_attrs, int_wrapped_len);
+        });
+        return std::make_pair(wrap_attribs, wrapped_len);
+    });
+    ASSERT_NE(attribs, nullptr);
+    frame = ec_util::copy_attrs_to_frame(frame, attribs, attribs_len);
+    free(attribs);
+    ASSERT_NE(frame, nullptr);
+
+    // The same frame built in place, with a capacity estimate that is too small to force a reallocation
+    ec_attrib_writer_t writer(EC_FRAME_BASE_SIZE, EC_FRAME_BASE_SIZE + 8, true);
+    ec_util::init_frame(reinterpret_cast<ec_frame_t *>(writer.base()));
+    reinterpret_cast<ec_frame_t *>(writer.base())->frame_type = ec_frame_type_auth_req;
+    EXPECT_TRUE(writer.add_attrib(ec_attrib_id_dpp_status, static_cast<uint8_t>(DPP_STATUS_OK)));
+    EXPECT_TRUE(writer.add_attrib(ec_attrib_id_resp_bootstrap_key_hash, sizeof(tag), tag));
+    ec_attrib_writer_t inner(0, ec_util::get_ec_attr_size(sizeof(tag)));
+    EXPECT_TRUE(inner.add_attrib(ec_attrib_id_resp_auth_tag, sizeof(tag), tag));
+    ec_attrib_writer_t wrap_attribs;
+    EXPECT_TRUE(wrap_attribs.add_attrib(ec_attrib_id_init_nonce, sizeof(nonce), nonce));
+    EXPECT_TRUE(wrap_attribs.add_wrapped_data(false, key, inner));
+    EXPECT_TRUE(writer.add_wrapped_data(true, key, wrap_attribs));
+    EXPECT_EQ(writer.attribs_len(), attribs_len);
+
+    size_t frame_len = 0;
+    uint8_t *built = writer.release(&frame_len);
+    ASSERT_NE(built, nullptr);
+    ASSERT_EQ(frame_len, EC_FRAME_BASE_SIZE + attribs_len);
+    EXPECT_EQ(memcmp(built, frame, frame_len), 0);
+
+    // And it unwraps like any other frame
+    ec_frame_t *built_frame = reinterpret_cast<ec_frame_t *>(built);
+    ec_attrib_index_t index(built_frame->attributes, attribs_len);
+    auto wrapped = index.get(ec_attrib_id_wrapped_data);
+    ASSERT_TRUE(wrapped.has_value());
+    auto [unwrapped, unwrapped_len] = ec_util::unwrap_wrapped_attrib(*wrapped, built_frame, true, key);
+    ASSERT_NE(unwrapped, nullptr);
+    ec_attrib_index_t unwrapped_index(unwrapped, unwrapped_len);
+    auto i_nonce = unwrapped_index.get(ec_attrib_id_init_nonce);
+    ASSERT_TRUE(i_nonce.has_value());
+    EXPECT_EQ(memcmp(i_nonce->data, nonce, sizeof(nonce)), 0);
+    free(unwrapped);
+    free(built);
+}
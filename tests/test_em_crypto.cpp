@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <chrono>
 #include <iomanip>
 #include <memory>
 #include <string>
@@ -828,4 +829,191 @@ TEST_F(EmCryptoTests, PlatformHmacHashRFC4231TestCase2) {
     
     EXPECT_EQ(result, 1) << "HMAC calculation should succeed";
     EXPECT_EQ(memcmp(hmac_result, expected, 32), 0) << "HMAC result should match RFC 4231 test case 2";
-}
\ No newline at end of file
+}
+TEST_F(EmCryptoTests, PlatformPrimitivesReuseContexts) {
+    // The contexts are kept by the thread, interleaving algorithms and directions must not leak state
+    uint8_t key[20];
+    memset(key, 0x0b, 20);
+    const char* data = "Hi There";
+    uint8_t* addr[1] = { (uint8_t*)data };
+    size_t len[1] = { strlen(data) };
+    uint8_t hmac_result[48], digest[32];
+
+    // RFC 4231 Test Case 1, SHA-256 and SHA-384
+    uint8_t expected_256[8] = { 0xb0, 0x34, 0x4c, 0x61, 0xd8, 0xdb, 0x38, 0x53 };
+    uint8_t expected_384[8] = { 0xaf, 0xd0, 0x39, 0x44, 0xd8, 0x48, 0x95, 0x62 };
+    // SHA-256 of "abc"
+    uint8_t expected_abc[8] = { 0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea };
+    uint8_t* abc[2] = { (uint8_t*)"a", (uint8_t*)"bc" };
+    size_t abc_len[2] = { 1, 2 };
+
+    uint8_t iv[AES_BLOCK_SIZE] = {0};
+    uint8_t plain[40], cipher_text[64];
+    uint32_t cipher_len = 0;
+    for (uint8_t i = 0; i < sizeof(plain); i++) {
+        plain[i] = i;
+    }
+
+    for (int round = 0; round < 3; round++) {
+        EXPECT_EQ(em_crypto_t::platform_hmac_hash(EVP_sha256(), key, 20, 1, addr, len, hmac_result), 1);
+        EXPECT_EQ(memcmp(hmac_result, expected_256, 8), 0) << "round " << round;
+        EXPECT_EQ(em_crypto_t::platform_hmac_hash(EVP_sha384(), key, 20, 1, addr, len, hmac_result), 1);
+        EXPECT_EQ(memcmp(hmac_result, expected_384, 8), 0) << "round " << round;
+        EXPECT_EQ(em_crypto_t::platform_hash(EVP_sha256(), 2, abc, abc_len, digest), 1);
+        EXPECT_EQ(memcmp(digest, expected_abc, 8), 0) << "round " << round;
+
+        // Padded CBC, then a decrypt that fails, then padded CBC again on the same context
+        ASSERT_EQ(em_crypto_t::platform_aes_128_cbc_encrypt(key, iv, plain, sizeof(plain), cipher_text, &cipher_len), 1);
+        EXPECT_EQ(cipher_len, 48u);
+        EXPECT_EQ(em_crypto_t::platform_aes_128_cbc_decrypt(key, iv, cipher_text, cipher_len), sizeof(plain));
+        EXPECT_EQ(memcmp(cipher_text, plain, sizeof(plain)), 0) << "round " << round;
+        EXPECT_EQ(em_crypto_t::platform_cipher_decrypt(EVP_aes_128_cbc(), key, iv, cipher_text, 20, true), 0u);
+    }
+}
+
+TEST_F(EmCryptoTests, KeyExchangeThroughput) {
+    // Both ends of WSC key exchanges in the 1536-bit group, the rate is printed for comparisons
+    const int exchanges = 100;
+    BN_CTX *bn_ctx = BN_CTX_new();
+    BIGNUM *p = BN_bin2bn(em_crypto_t::g_dh1536_p, sizeof(em_crypto_t::g_dh1536_p), NULL);
+    BIGNUM *g = BN_bin2bn(em_crypto_t::g_dh1536_g, sizeof(em_crypto_t::g_dh1536_g), NULL);
+    BIGNUM *priv[2] = { BN_new(), BN_new() }, *pub[2] = { BN_new(), BN_new() };
+    uint8_t priv_bin[2][192], pub_bin[2][192];
+    uint16_t priv_len[2], pub_len[2];
+
+    ASSERT_NE(bn_ctx, nullptr);
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(BN_priv_rand(priv[i], 1536, BN_RAND_TOP_ANY, BN_RAND_BOTTOM_ANY), 1);
+        ASSERT_EQ(BN_mod_exp(pub[i], g, priv[i], p, bn_ctx), 1);
+        priv_len[i] = static_cast<uint16_t>(BN_bn2bin(priv[i], priv_bin[i]));
+        pub_len[i] = static_cast<uint16_t>(BN_bn2bin(pub[i], pub_bin[i]));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < exchanges; i++) {
+        uint8_t *secret[2] = { NULL, NULL };
+        uint16_t secret_len[2] = { 0, 0 };
+
+        ASSERT_EQ(em_crypto_t::platform_compute_shared_secret(&secret[0], &secret_len[0], pub_bin[1], pub_len[1],
+            priv_bin[0], static_cast<uint8_t>(priv_len[0])), 1);
+        ASSERT_EQ(em_crypto_t::platform_compute_shared_secret(&secret[1], &secret_len[1], pub_bin[0], pub_len[0],
+            priv_bin[1], static_cast<uint8_t>(priv_len[1])), 1);
+        EXPECT_EQ(secret_len[0], secret_len[1]);
+        EXPECT_EQ(memcmp(secret[0], secret[1], secret_len[0]), 0);
+        OPENSSL_free(secret[0]);
+        OPENSSL_free(secret[1]);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "DH-1536 shared secrets: " << (2 * exchanges) / elapsed << " per second" << std::endl;
+
+    // A public key of 1 would force the secret
+    uint8_t one = 1, *secret = NULL;
+    uint16_t secret_len = 0;
+    EXPECT_EQ(em_crypto_t::platform_compute_shared_secret(&secret, &secret_len, &one, 1,
+        priv_bin[0], static_cast<uint8_t>(priv_len[0])), 0);
+
+    for (int i = 0; i < 2; i++) {
+        BN_clear_free(priv[i]);
+        BN_free(pub[i]);
+    }
+    BN_free(p);
+    BN_free(g);
+    BN_CTX_free(bn_ctx);
+}
+
+TEST_F(EmCryptoTests, SharedCurveGroups) {
+    const int nids[] = { NID_X9_62_prime256v1, NID_secp384r1, NID_secp521r1 };
+    BN_CTX *bn_ctx = em_crypto_t::get_thread_bn_ctx();
+
+    ASSERT_NE(bn_ctx, nullptr);
+    EXPECT_EQ(em_crypto_t::get_thread_bn_ctx(), bn_ctx);
+    for (int nid : nids) {
+        const EC_GROUP *shared = em_crypto_t::get_curve_group(nid);
+        ASSERT_NE(shared, nullptr) << "nid " << nid;
+        EXPECT_EQ(em_crypto_t::get_curve_group(nid), shared);
+        EXPECT_EQ(EC_GROUP_get_curve_name(shared), nid);
+
+        // The copy handed out matches a group built from scratch
+        EC_GROUP *copy = em_crypto_t::new_curve_group(nid);
+        EC_GROUP *fresh = EC_GROUP_new_by_curve_name(nid);
+        ASSERT_NE(copy, nullptr);
+        EXPECT_EQ(EC_GROUP_cmp(copy, fresh, bn_ctx), 0);
+
+        // The group of a key is the shared one as well
+        SSL_KEY *key = em_crypto_t::generate_ec_key(nid);
+        ASSERT_NE(key, nullptr);
+        EC_GROUP *key_group = em_crypto_t::get_key_group(key);
+        ASSERT_NE(key_group, nullptr);
+        EXPECT_EQ(EC_GROUP_cmp(key_group, shared, bn_ctx), 0);
+
+        EC_GROUP_free(key_group);
+        em_crypto_t::free_key(key);
+        EC_GROUP_free(fresh);
+        EC_GROUP_free(copy);
+    }
+
+    // Curves DPP does not use are still created, without a shared group
+    EXPECT_EQ(em_crypto_t::get_curve_group(NID_secp256k1), nullptr);
+    EC_GROUP *other = em_crypto_t::new_curve_group(NID_secp256k1);
+    EXPECT_NE(other, nullptr);
+    EC_GROUP_free(other);
+}
+
+TEST_F(EmCryptoTests, WscSealMatchesPerCallPrimitives) {
+    // Encrypted Settings of one M2 sealed with one key schedule, read back with the per call primitives
+    uint8_t auth_key[WPS_AUTHKEY_LEN], key_wrap_key[WPS_KEYWRAPKEY_LEN], hash[SHA256_MAC_LEN];
+    uint8_t plain[128], sealed[sizeof(plain) + 2 * AES_BLOCK_SIZE], copy[sizeof(sealed)];
+    const unsigned int plain_len = 100, kwa_len = sizeof(data_elem_attr_t) + EM_KEY_WRAP_TLV_LEN;
+    em_wsc_seal_t seal;
+
+    memset(auth_key, 0x5a, sizeof(auth_key));
+    memset(key_wrap_key, 0xa5, sizeof(key_wrap_key));
+    EXPECT_FALSE(seal.is_keyed());
+    EXPECT_EQ(seal.seal(plain, plain_len, sealed), 0u);
+    ASSERT_EQ(seal.set_keys(auth_key, key_wrap_key), 0);
+    ASSERT_TRUE(seal.is_keyed());
+
+    for (uint8_t bss = 0; bss < 16; bss++) {
+        for (unsigned int i = 0; i < plain_len; i++) {
+            plain[i] = static_cast<uint8_t>(bss + i);
+        }
+        unsigned int len = seal.seal(plain, plain_len, sealed);
+        ASSERT_EQ(len, AES_BLOCK_SIZE + ((plain_len + kwa_len) / AES_BLOCK_SIZE + 1) * AES_BLOCK_SIZE) << "bss " << int(bss);
+
+        // the authenticator is the start of the HMAC of the settings
+        uint8_t *addr[1] = { plain };
+        size_t addr_len[1] = { plain_len };
+        ASSERT_EQ(em_crypto_t::platform_hmac_SHA256(auth_key, sizeof(auth_key), 1, addr, addr_len, hash), 1);
+        EXPECT_EQ(memcmp(plain + plain_len + sizeof(data_elem_attr_t), hash, EM_KEY_WRAP_TLV_LEN), 0) << "bss " << int(bss);
+
+        memcpy(copy, sealed, len);
+        EXPECT_EQ(em_crypto_t::platform_aes_128_cbc_decrypt(key_wrap_key, copy, copy + AES_BLOCK_SIZE, len - AES_BLOCK_SIZE),
+            plain_len + kwa_len);
+        EXPECT_EQ(memcmp(copy + AES_BLOCK_SIZE, plain, plain_len + kwa_len), 0) << "bss " << int(bss);
+
+        EXPECT_EQ(seal.open(sealed, len), plain_len + kwa_len);
+        EXPECT_EQ(memcmp(sealed + AES_BLOCK_SIZE, plain, plain_len + kwa_len), 0) << "bss " << int(bss);
+    }
+
+    // settings sealed by the per call primitives open as well
+    uint8_t iv[AES_BLOCK_SIZE] = {0x01};
+    uint32_t cipher_len = 0;
+    memcpy(sealed, iv, sizeof(iv));
+    ASSERT_EQ(em_crypto_t::platform_aes_128_cbc_encrypt(key_wrap_key, iv, plain, 48, sealed + AES_BLOCK_SIZE, &cipher_len), 1);
+    EXPECT_EQ(seal.open(sealed, cipher_len + AES_BLOCK_SIZE), 48u);
+    EXPECT_EQ(memcmp(sealed + AES_BLOCK_SIZE, plain, 48), 0);
+
+    // a broken padding fails and leaves the next entry unaffected, as do new keys
+    EXPECT_EQ(seal.open(sealed, 20), 0u);
+    EXPECT_EQ(seal.open(sealed, AES_BLOCK_SIZE), 0u);
+    key_wrap_key[0] ^= 0xff;
+    ASSERT_EQ(seal.set_keys(auth_key, key_wrap_key), 0);
+    unsigned int len = seal.seal(plain, 32, sealed);
+    ASSERT_NE(len, 0u);
+    memcpy(copy, sealed, len);
+    EXPECT_EQ(em_crypto_t::platform_aes_128_cbc_decrypt(key_wrap_key, copy, copy + AES_BLOCK_SIZE, len - AES_BLOCK_SIZE), 32 + kwa_len);
+
+    seal.clear();
+    EXPECT_FALSE(seal.is_keyed());
+    EXPECT_EQ(seal.open(sealed, len), 0u);
+}
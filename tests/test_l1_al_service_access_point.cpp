@@ -0,0 +1,464 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <poll.h>
+#include <algorithm>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "al_service_access_point.h"
+#include "al_service_utils.h"
+
+// IEEE1905 side of a service access point, listening on the data and control sockets
+class AlServiceAccessPointTest : public ::testing::Test {
+protected:
+    std::string dataPath, controlPath;
+    int dataListen = -1, controlListen = -1, dataPeer = -1, controlPeer = -1;
+    AlServiceAccessPoint *sap = nullptr;
+
+    static int listenOn(const std::string& path) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        struct sockaddr_un addr = createUnixSocketAddress(path);
+
+        unlink(path.c_str());
+        if ((bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0) || (listen(fd, 1) != 0)) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    void SetUp() override {
+        dataPath = "/tmp/test_al_sap_data_" + std::to_string(getpid());
+        controlPath = "/tmp/test_al_sap_control_" + std::to_string(getpid());
+        ASSERT_NE((dataListen = listenOn(dataPath)), -1);
+        ASSERT_NE((controlListen = listenOn(controlPath)), -1);
+        sap = new AlServiceAccessPoint(dataPath, controlPath);
+        ASSERT_NE((controlPeer = accept(controlListen, nullptr, nullptr)), -1);
+        ASSERT_NE((dataPeer = accept(dataListen, nullptr, nullptr)), -1);
+    }
+
+    void TearDown() override {
+        delete sap;
+        for (int fd : {dataPeer, controlPeer, dataListen, controlListen}) {
+            if (fd != -1) {
+                close(fd);
+            }
+        }
+        unlink(dataPath.c_str());
+        unlink(controlPath.c_str());
+    }
+
+    // Reads one length delimited packet sent by the access point
+    std::vector<unsigned char> readPacket() {
+        std::vector<unsigned char> packet(sizeof(uint32_t));
+        size_t got = 0;
+
+        while (got < packet.size()) {
+            ssize_t n = recv(dataPeer, packet.data() + got, packet.size() - got, 0);
+            if (n <= 0) {
+                return {};
+            }
+            got += static_cast<size_t>(n);
+            if (got == sizeof(uint32_t)) {
+                packet.resize(sizeof(uint32_t) + convert_bytes_into_u32(packet));
+            }
+        }
+        return packet;
+    }
+};
+
+/**
+ *@brief Test that a large payload is sent as ordered fragments from the caller's buffer
+ *
+ *This test verifies that serviceAccessPointDataRequest splits a payload larger than a packet into fragments with correct headers and that the fragments carry the whole payload.
+ *
+ ***Test Group ID:* *Basic: 01@n
+ ***Test Case ID:* *001@n
+ ***Priority:* *High@n
+ *@n
+ ***Pre-Conditions:* *None@n
+ ***Dependencies:* *None@n
+ ***User Interaction:* *None@n
+ *@n
+ ***Test Procedure:**@n
+ *| Variation / Step | Description | Test Data | Expected Result | Notes |
+ *| :----: | --------- | ---------- |-------------- | ----- |
+ *| 01 | Send a payload of two and a half packets | 2.5 x (SOCKET_MTU - PACKET_HEADER_SIZE) bytes | Three fragments, ids 0 to 2, last one flagged | Should Pass |
+ *| 02 | Reassemble the fragments | None | Equal to the payload, MAC addresses preserved | Should Pass |
+ */
+TEST_F(AlServiceAccessPointTest, FragmentedRequestFromBuffer) {
+    std::cout << "Entering FragmentedRequestFromBuffer test" << std::endl;
+    const size_t fragmentSize = SOCKET_MTU - PACKET_HEADER_SIZE;
+    MacAddress src = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01}, dst = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02};
+    std::vector<unsigned char> payload(fragmentSize * 5 / 2), reassembled;
+    AlServiceDataUnit sdu;
+
+    for (size_t i = 0; i < payload.size(); i++) {
+        payload[i] = static_cast<unsigned char>(i * 7);
+    }
+    sap->serviceAccessPointDataRequest(src, dst, payload.data(), payload.size());
+
+    for (int i = 0; i < 3; i++) {
+        std::vector<unsigned char> packet = readPacket();
+        ASSERT_FALSE(packet.empty());
+        sdu.deserialize(packet);
+        EXPECT_EQ(sdu.getIsFragment(), 1);
+        EXPECT_EQ(sdu.getFragmentId(), i);
+        EXPECT_EQ(sdu.getIsLastFragment(), (i == 2) ? 1 : 0);
+        EXPECT_EQ(sdu.getSourceAlMacAddress(), src);
+        EXPECT_EQ(sdu.getDestinationAlMacAddress(), dst);
+        EXPECT_LE(sdu.getPayload().size(), fragmentSize);
+        reassembled.insert(reassembled.end(), sdu.getPayload().begin(), sdu.getPayload().end());
+    }
+    EXPECT_EQ(reassembled, payload);
+    std::cout << "Exiting FragmentedRequestFromBuffer test" << std::endl;
+}
+
+/**
+ *@brief Test that a data unit request and indications round trip through the reused receive buffer
+ *
+ *This test verifies that a small AlServiceDataUnit is sent as one packet and that consecutive indications return each received message.
+ *
+ ***Test Group ID:* *Basic: 01@n
+ ***Test Case ID:* *002@n
+ ***Priority:* *High@n
+ *@n
+ ***Pre-Conditions:* *None@n
+ ***Dependencies:* *None@n
+ ***User Interaction:* *None@n
+ *@n
+ ***Test Procedure:**@n
+ *| Variation / Step | Description | Test Data | Expected Result | Notes |
+ *| :----: | --------- | ---------- |-------------- | ----- |
+ *| 01 | Send a data unit of 100 bytes | payload = 100 bytes | One unfragmented packet equal to serialize() | Should Pass |
+ *| 02 | Echo two packets of different sizes one after the other | 100 and 10 bytes | Both indications return their own payload and addresses | Should Pass |
+ */
+TEST_F(AlServiceAccessPointTest, RequestAndIndicationRoundTrip) {
+    std::cout << "Entering RequestAndIndicationRoundTrip test" << std::endl;
+    AlServiceDataUnit sdu, received;
+    std::vector<unsigned char> packet;
+
+    sdu.setSourceAlMacAddress({0x02, 0x00, 0x00, 0x00, 0x00, 0x01});
+    sdu.setDestinationAlMacAddress({0x02, 0x00, 0x00, 0x00, 0x00, 0x02});
+    sdu.setPayload(std::vector<unsigned char>(100, 0xab));
+    sap->serviceAccessPointDataRequest(sdu);
+
+    packet = readPacket();
+    sdu.setIsFragment(0);
+    sdu.setIsLastFragment(1);
+    EXPECT_EQ(packet, sdu.serialize());
+
+    ASSERT_EQ(send(dataPeer, packet.data(), packet.size(), 0), static_cast<ssize_t>(packet.size()));
+    received = sap->serviceAccessPointDataIndication();
+    EXPECT_EQ(received.getPayload(), sdu.getPayload());
+    EXPECT_EQ(received.getSourceAlMacAddress(), sdu.getSourceAlMacAddress());
+
+    sdu.setDestinationAlMacAddress({0x02, 0x00, 0x00, 0x00, 0x00, 0x03});
+    sdu.setPayload(std::vector<unsigned char>(10, 0xcd));
+    packet = sdu.serialize();
+    ASSERT_EQ(send(dataPeer, packet.data(), packet.size(), 0), static_cast<ssize_t>(packet.size()));
+    received = sap->serviceAccessPointDataIndication();
+    EXPECT_EQ(received.getPayload(), sdu.getPayload());
+    EXPECT_EQ(received.getDestinationAlMacAddress(), sdu.getDestinationAlMacAddress());
+    std::cout << "Exiting RequestAndIndicationRoundTrip test" << std::endl;
+}
+
+/**
+ *@brief Test that the non blocking indication reassembles fragments received in pieces
+ *
+ *This test verifies that the non blocking serviceAccessPointDataIndication returns nothing while a message is incomplete, keeps its progress across calls and reassembles the fragments behind the requested headroom.
+ *
+ ***Test Group ID:* *Basic: 01@n
+ ***Test Case ID:* *003@n
+ ***Priority:* *High@n
+ *@n
+ ***Pre-Conditions:* *None@n
+ ***Dependencies:* *None@n
+ ***User Interaction:* *None@n
+ *@n
+ ***Test Procedure:**@n
+ *| Variation / Step | Description | Test Data | Expected Result | Notes |
+ *| :----: | --------- | ---------- |-------------- | ----- |
+ *| 01 | Call the indication on an empty socket | None | nullptr | Should Pass |
+ *| 02 | Write two fragments in chunks of 7 bytes, calling the indication after each | 3 + 2 payload bytes | nullptr until the last byte | Should Pass |
+ *| 03 | Check the message | headroom = 14 | Payload of 5 bytes at offset 14, source and destination of the first fragment | Should Pass |
+ */
+TEST_F(AlServiceAccessPointTest, NonBlockingIndicationInPieces) {
+    std::cout << "Entering NonBlockingIndicationInPieces test" << std::endl;
+    MacAddress src = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01}, dst = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02}, gotSrc, gotDst;
+    unsigned char first[PACKET_HEADER_SIZE + 3], second[PACKET_HEADER_SIZE + 2];
+    std::vector<unsigned char> stream;
+    unsigned char *frame = nullptr;
+    size_t length = 0;
+
+    EXPECT_EQ(sap->serviceAccessPointDataIndication(14, length, gotSrc, gotDst), nullptr);
+
+    AlServiceDataUnit::serializeHeader(first, src, dst, 1, 0, 0, 3);
+    first[PACKET_HEADER_SIZE] = 1; first[PACKET_HEADER_SIZE + 1] = 2; first[PACKET_HEADER_SIZE + 2] = 3;
+    AlServiceDataUnit::serializeHeader(second, src, dst, 1, 1, 1, 2);
+    second[PACKET_HEADER_SIZE] = 4; second[PACKET_HEADER_SIZE + 1] = 5;
+    stream.insert(stream.end(), first, first + sizeof(first));
+    stream.insert(stream.end(), second, second + sizeof(second));
+
+    for (size_t off = 0; off < stream.size(); off += 7) {
+        size_t n = std::min<size_t>(7, stream.size() - off);
+        ASSERT_EQ(send(dataPeer, stream.data() + off, n, 0), static_cast<ssize_t>(n));
+        frame = sap->serviceAccessPointDataIndication(14, length, gotSrc, gotDst);
+        if (off + n < stream.size()) {
+            EXPECT_EQ(frame, nullptr);
+        }
+    }
+    ASSERT_NE(frame, nullptr);
+    ASSERT_EQ(length, 5u);
+    for (size_t i = 0; i < length; i++) {
+        EXPECT_EQ(frame[14 + i], i + 1);
+    }
+    EXPECT_EQ(gotSrc, src);
+    EXPECT_EQ(gotDst, dst);
+    EXPECT_EQ(sap->serviceAccessPointDataIndication(14, length, gotSrc, gotDst), nullptr);
+    std::cout << "Exiting NonBlockingIndicationInPieces test" << std::endl;
+}
+
+/**
+ *@brief Test that a message with an out of order fragment is dropped without losing the next one
+ *
+ *This test verifies that the non blocking indication reads a message with a missing fragment to its end, reports it once with FragmentOutOfOrder and returns the following message.
+ *
+ ***Test Group ID:* *Basic: 01@n
+ ***Test Case ID:* *004@n
+ ***Priority:* *High@n
+ *@n
+ ***Pre-Conditions:* *None@n
+ ***Dependencies:* *None@n
+ ***User Interaction:* *None@n
+ *@n
+ ***Test Procedure:**@n
+ *| Variation / Step | Description | Test Data | Expected Result | Notes |
+ *| :----: | --------- | ---------- |-------------- | ----- |
+ *| 01 | Write fragments 0 and 2 of a message then a single message | 4 payload bytes each | AlServiceException with FragmentOutOfOrder | Should Pass |
+ *| 02 | Call the indication again | None | The single message | Should Pass |
+ */
+TEST_F(AlServiceAccessPointTest, NonBlockingIndicationDropsOutOfOrder) {
+    std::cout << "Entering NonBlockingIndicationDropsOutOfOrder test" << std::endl;
+    MacAddress src = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01}, dst = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02}, gotSrc, gotDst;
+    unsigned char packet[PACKET_HEADER_SIZE + 4] = {};
+    PrimitiveError error = PrimitiveError::UnknownError;
+    unsigned char *frame;
+    size_t length = 0;
+
+    AlServiceDataUnit::serializeHeader(packet, src, dst, 1, 0, 0, 4);
+    ASSERT_EQ(send(dataPeer, packet, sizeof(packet), 0), static_cast<ssize_t>(sizeof(packet)));
+    AlServiceDataUnit::serializeHeader(packet, src, dst, 1, 1, 2, 4);
+    ASSERT_EQ(send(dataPeer, packet, sizeof(packet), 0), static_cast<ssize_t>(sizeof(packet)));
+    AlServiceDataUnit::serializeHeader(packet, dst, src, 0, 1, 0, 4);
+    packet[PACKET_HEADER_SIZE] = 0x5a;
+    ASSERT_EQ(send(dataPeer, packet, sizeof(packet), 0), static_cast<ssize_t>(sizeof(packet)));
+
+    try {
+        sap->serviceAccessPointDataIndication(0, length, gotSrc, gotDst);
+    } catch (const AlServiceException& e) {
+        error = e.getPrimitiveError();
+    }
+    EXPECT_EQ(error, PrimitiveError::FragmentOutOfOrder);
+
+    ASSERT_NE((frame = sap->serviceAccessPointDataIndication(0, length, gotSrc, gotDst)), nullptr);
+    EXPECT_EQ(length, 4u);
+    EXPECT_EQ(frame[0], 0x5a);
+    EXPECT_EQ(gotSrc, dst);
+    std::cout << "Exiting NonBlockingIndicationDropsOutOfOrder test" << std::endl;
+}
+
+/**
+ *@brief Test that data requests queue instead of blocking while the peer does not read
+ *
+ *This test verifies that serviceAccessPointDataRequest returns while the data socket is full, that the queued packets are written by the transmitter in order once the peer reads and that the counters account for it.
+ *
+ ***Test Group ID:* *Basic: 01@n
+ ***Test Case ID:* *005@n
+ ***Priority:* *High@n
+ *@n
+ ***Pre-Conditions:* *None@n
+ ***Dependencies:* *None@n
+ ***User Interaction:* *None@n
+ *@n
+ ***Test Procedure:**@n
+ *| Variation / Step | Description | Test Data | Expected Result | Notes |
+ *| :----: | --------- | ---------- |-------------- | ----- |
+ *| 01 | Send 64 messages without reading them | 16000 bytes each | Returns, packets queued and back pressure counted | Should Pass |
+ *| 02 | Read all the packets | None | 64 messages in sending order, queue empty, 64 packets sent | Should Pass |
+ */
+TEST_F(AlServiceAccessPointTest, RequestQueuesUnderBackPressure) {
+    std::cout << "Entering RequestQueuesUnderBackPressure test" << std::endl;
+    MacAddress src = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01}, dst = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02};
+    std::vector<unsigned char> payload(16000);
+    AlServiceTransmitStats stats;
+    AlServiceDataUnit sdu;
+
+    for (int i = 0; i < 64; i++) {
+        payload[0] = static_cast<unsigned char>(i);
+        sap->serviceAccessPointDataRequest(src, dst, payload.data(), payload.size());
+    }
+    stats = sap->getTransmitStats();
+    EXPECT_GT(stats.queuedPackets, 0u);
+    EXPECT_GT(stats.backPressure, 0u);
+    EXPECT_EQ(stats.droppedMessages, 0u);
+    EXPECT_LE(stats.peakDepth, SAP_TX_QUEUE_DEPTH);
+
+    for (int i = 0; i < 64; i++) {
+        std::vector<unsigned char> packet = readPacket();
+        ASSERT_FALSE(packet.empty());
+        sdu.deserialize(packet);
+        ASSERT_EQ(sdu.getPayload().size(), payload.size());
+        EXPECT_EQ(sdu.getPayload()[0], i);
+    }
+    EXPECT_EQ(sap->getTransmitQueueDepth(), 0u);
+    stats = sap->getTransmitStats();
+    EXPECT_EQ(stats.sentPackets, 64u);
+    EXPECT_GT(stats.batches, 0u);
+    std::cout << "Exiting RequestQueuesUnderBackPressure test" << std::endl;
+}
+
+/**
+ *@brief Test that messages beyond the queue depth are dropped whole and counted
+ *
+ *This test verifies that once SAP_TX_QUEUE_DEPTH packets wait for the socket, further fragmented messages are dropped without any of their fragments being sent.
+ *
+ ***Test Group ID:* *Basic: 01@n
+ ***Test Case ID:* *006@n
+ ***Priority:* *High@n
+ *@n
+ ***Pre-Conditions:* *None@n
+ ***Dependencies:* *None@n
+ ***User Interaction:* *None@n
+ *@n
+ ***Test Procedure:**@n
+ *| Variation / Step | Description | Test Data | Expected Result | Notes |
+ *| :----: | --------- | ---------- |-------------- | ----- |
+ *| 01 | Send 100 messages of two fragments without reading them | 1.5 x (SOCKET_MTU - PACKET_HEADER_SIZE) bytes each | Some messages dropped, queue within its depth | Should Pass |
+ *| 02 | Read the packets sent | None | Every message complete, the sent ones in order | Should Pass |
+ */
+TEST_F(AlServiceAccessPointTest, RequestDropsWholeMessagesWhenFull) {
+    std::cout << "Entering RequestDropsWholeMessagesWhenFull test" << std::endl;
+    const size_t fragmentSize = SOCKET_MTU - PACKET_HEADER_SIZE;
+    MacAddress src = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01}, dst = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02};
+    std::vector<unsigned char> payload(fragmentSize * 3 / 2);
+    AlServiceTransmitStats stats;
+    AlServiceDataUnit sdu;
+    int last = -1;
+
+    for (int i = 0; i < 100; i++) {
+        payload[0] = static_cast<unsigned char>(i);
+        sap->serviceAccessPointDataRequest(src, dst, payload.data(), payload.size());
+    }
+    stats = sap->getTransmitStats();
+    EXPECT_GT(stats.droppedMessages, 0u);
+    EXPECT_LE(sap->getTransmitQueueDepth(), SAP_TX_QUEUE_DEPTH);
+
+    for (uint64_t i = 0; i < 100 - stats.droppedMessages; i++) {
+        std::vector<unsigned char> first = readPacket(), second = readPacket();
+        ASSERT_FALSE(first.empty() || second.empty());
+        sdu.deserialize(first);
+        EXPECT_EQ(sdu.getFragmentId(), 0);
+        EXPECT_GT(static_cast<int>(sdu.getPayload()[0]), last);
+        last = sdu.getPayload()[0];
+        sdu.deserialize(second);
+        EXPECT_EQ(sdu.getFragmentId(), 1);
+        EXPECT_EQ(sdu.getIsLastFragment(), 1);
+    }
+    EXPECT_EQ(sap->getTransmitQueueDepth(), 0u);
+    std::cout << "Exiting RequestDropsWholeMessagesWhenFull test" << std::endl;
+}
+
+/**
+ *@brief Test that the shared memory transport carries whole messages both ways
+ *
+ *This test verifies that an access point constructed with AlServiceTransport::SharedMemory hands its ring over the data socket, writes a message larger than a packet without fragmenting it and receives the messages the daemon writes with both indications.
+ *
+ ***Test Group ID:* *Basic: 01@n
+ ***Test Case ID:* *007@n
+ ***Priority:* *High@n
+ *@n
+ ***Pre-Conditions:* *None@n
+ ***Dependencies:* *None@n
+ ***User Interaction:* *None@n
+ *@n
+ ***Test Procedure:**@n
+ *| Variation / Step | Description | Test Data | Expected Result | Notes |
+ *| :----: | --------- | ---------- |-------------- | ----- |
+ *| 01 | Construct with the shared memory transport, attach the daemon side | Descriptors on the data socket | Handshake accepted | Should Pass |
+ *| 02 | Send a payload of three packets | 3 x SOCKET_MTU bytes | One record equal to the payload | Should Pass |
+ *| 03 | Daemon writes two messages | 100 and 200000 bytes | Indication descriptor readable, non blocking indication returns them behind the headroom then nullptr | Should Pass |
+ *| 04 | Daemon writes one more message | 10 bytes | Blocking indication returns it | Should Pass |
+ *| 05 | Send a payload larger than the ring | SAP_RING_SIZE bytes | AlServiceException | Should Pass |
+ */
+TEST_F(AlServiceAccessPointTest, SharedMemoryTransport) {
+    std::cout << "Entering SharedMemoryTransport test" << std::endl;
+    MacAddress src = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01}, dst = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02}, from, to;
+    std::vector<unsigned char> payload(3 * SOCKET_MTU), small(100, 0x11), large(200000, 0x22), tiny(10, 0x33);
+    int shmControlPeer, shmDataPeer;
+    size_t length;
+
+    for (size_t i = 0; i < payload.size(); i++) {
+        payload[i] = static_cast<unsigned char>(i * 13);
+    }
+    AlServiceAccessPoint shm(dataPath, controlPath, AlServiceTransport::SharedMemory);
+    ASSERT_NE((shmControlPeer = accept(controlListen, nullptr, nullptr)), -1);
+    ASSERT_NE((shmDataPeer = accept(dataListen, nullptr, nullptr)), -1);
+    std::unique_ptr<AlServiceSharedRing> daemon = AlServiceSharedRing::receiveDescriptors(shmDataPeer);
+    EXPECT_NE(shm.getIndicationDescriptor(), shm.getDataSocketDescriptor());
+
+    shm.serviceAccessPointDataRequest(src, dst, payload.data(), payload.size());
+    const unsigned char *record = daemon->peek(length, from, to);
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(std::vector<unsigned char>(record, record + length), payload);
+    EXPECT_EQ(from, src);
+    EXPECT_EQ(to, dst);
+    daemon->pop();
+    EXPECT_EQ(daemon->peek(length, from, to), nullptr);
+
+    ASSERT_TRUE(daemon->push(dst, src, small.data(), small.size()));
+    ASSERT_TRUE(daemon->push(dst, src, large.data(), large.size()));
+    struct pollfd pfd = {shm.getIndicationDescriptor(), POLLIN, 0};
+    EXPECT_EQ(poll(&pfd, 1, 1000), 1);
+    for (const std::vector<unsigned char> *expected : {&small, &large}) {
+        unsigned char *buffer = shm.serviceAccessPointDataIndication(14, length, from, to);
+        ASSERT_NE(buffer, nullptr);
+        EXPECT_EQ(std::vector<unsigned char>(buffer + 14, buffer + 14 + length), *expected);
+        EXPECT_EQ(from, dst);
+        EXPECT_EQ(to, src);
+    }
+    EXPECT_EQ(shm.serviceAccessPointDataIndication(14, length, from, to), nullptr);
+    EXPECT_EQ(poll(&pfd, 1, 0), 0);
+
+    ASSERT_TRUE(daemon->push(dst, src, tiny.data(), tiny.size()));
+    AlServiceDataUnit sdu = shm.serviceAccessPointDataIndication();
+    EXPECT_EQ(sdu.getPayload(), tiny);
+    EXPECT_EQ(sdu.getSourceAlMacAddress(), dst);
+
+    std::vector<unsigned char> oversized(SAP_RING_SIZE);
+    EXPECT_THROW(shm.serviceAccessPointDataRequest(src, dst, oversized.data(), oversized.size()), AlServiceException);
+    EXPECT_EQ(shm.getTransmitStats().sentPackets, 1u);
+    close(shmDataPeer);
+    close(shmControlPeer);
+    std::cout << "Exiting SharedMemoryTransport test" << std::endl;
+}
@@ -442,10 +442,10 @@ TEST(AlServiceRegistrationRequest, SerializeInvalidRegistrationRequest) {
  * **Test Procedure:**
  * | Variation / Step | Description                                                                              | Test Data                                               | Expected Result                                                                  | Notes      |
  * | :--------------: | ---------------------------------------------------------------------------------------- | ------------------------------------------------------- | -------------------------------------------------------------------------------- | ---------- |
- * | 01               | Invokes the deserializeRegistrationRequest API with a valid byte stream input              | validData = 0x00, 0x02, 0x01, 0x02 | API processes the valid registration request without errors and returns normally | Should Pass |
+ * | 01               | Invokes the deserializeRegistrationRequest API with a valid byte stream input              | validData = 0x00, 0x00, 0x00, 0x02, 0x01, 0x02 | API processes the valid registration request without errors and returns normally | Should Pass |
  */
  TEST(AlServiceRegistrationRequest, DeserializeValidRegistrationRequest) {
-    std::vector<unsigned char> validData = {0x00, 0x02, 0x01, 0x02};
+    std::vector<unsigned char> validData = {0x00, 0x00, 0x00, 0x02, 0x01, 0x02};
     std::cout << "Entering DeserializeValidRegistrationRequest" << std::endl;
     AlServiceRegistrationRequest instance;
     EXPECT_NO_THROW({
@@ -0,0 +1,153 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <poll.h>
+#include <vector>
+#include <sys/socket.h>
+#include "al_service_shared_ring.h"
+#include "al_service_exception.h"
+
+// Both ends of a shared ring, the second attached with the descriptors the first sends
+class AlServiceSharedRingTest : public ::testing::Test {
+protected:
+    int sockets[2] = {-1, -1};
+    std::array<uint8_t, 6> src = {{0x02, 0x00, 0x00, 0x00, 0x00, 0x01}};
+    std::array<uint8_t, 6> dst = {{0x02, 0x00, 0x00, 0x00, 0x00, 0x02}};
+
+    void SetUp() override {
+        ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0);
+    }
+
+    void TearDown() override {
+        close(sockets[0]);
+        close(sockets[1]);
+    }
+
+    static bool readable(int fd) {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        return poll(&pfd, 1, 0) == 1;
+    }
+};
+
+/**
+ *@brief Test that records round trip, wrap at the end of the ring and stop at a full ring
+ *
+ *This test verifies that messages pushed at one end are peeked in order at the other, that the producer signals only a ring that was empty and that a record never straddles the end of the ring.
+ *
+ ***Test Group ID:* *Basic: 01@n
+ ***Test Case ID:* *001@n
+ ***Priority:* *High@n
+ *@n
+ ***Pre-Conditions:* *None@n
+ ***Dependencies:* *None@n
+ ***User Interaction:* *None@n
+ *@n
+ ***Test Procedure:**@n
+ *| Variation / Step | Description | Test Data | Expected Result | Notes |
+ *| :----: | --------- | ---------- |-------------- | ----- |
+ *| 01 | Create a 256 bytes ring and attach the other end | Descriptors over a socket pair | Event not readable, max payload 240 | Should Pass |
+ *| 02 | Push until the ring is full | 50 bytes records | Three records fit, the fourth is refused, event readable | Should Pass |
+ *| 03 | Consume and push again across the end of the ring | 50 and 100 bytes records | Records in order with their MAC addresses | Should Pass |
+ */
+TEST_F(AlServiceSharedRingTest, PushPeekWrapAndFull) {
+    std::cout << "Entering PushPeekWrapAndFull test" << std::endl;
+    AlServiceSharedRing owner(256);
+    std::array<uint8_t, 6> from, to;
+    std::vector<unsigned char> payload(100);
+    size_t length;
+
+    owner.sendDescriptors(sockets[0]);
+    std::unique_ptr<AlServiceSharedRing> peer = AlServiceSharedRing::receiveDescriptors(sockets[1]);
+    EXPECT_EQ(peer->getMaxPayload(), 240u);
+    EXPECT_FALSE(readable(peer->getEventDescriptor()));
+    EXPECT_EQ(peer->peek(length, from, to), nullptr);
+
+    for (unsigned char i = 0; i < 3; i++) {
+        payload[0] = i;
+        EXPECT_TRUE(owner.push(src, dst, payload.data(), 50));
+    }
+    EXPECT_FALSE(owner.push(src, dst, payload.data(), 50));
+    EXPECT_FALSE(owner.push(src, dst, payload.data(), 241));
+    EXPECT_TRUE(readable(peer->getEventDescriptor()));
+    peer->clearEvent();
+    EXPECT_FALSE(readable(peer->getEventDescriptor()));
+
+    // 72 bytes records, the fourth one does not fit in front of the end and starts the ring again
+    for (unsigned char i = 0; i < 2; i++) {
+        const unsigned char *record = peer->peek(length, from, to);
+        ASSERT_NE(record, nullptr);
+        EXPECT_EQ(length, 50u);
+        EXPECT_EQ(record[0], i);
+        EXPECT_EQ(from, src);
+        EXPECT_EQ(to, dst);
+        peer->pop();
+    }
+    payload[0] = 3;
+    EXPECT_TRUE(owner.push(src, dst, payload.data(), 100));
+    EXPECT_FALSE(readable(peer->getEventDescriptor()));
+
+    const unsigned char *record = peer->peek(length, from, to);
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(record[0], 2);
+    peer->pop();
+    ASSERT_NE((record = peer->peek(length, from, to)), nullptr);
+    EXPECT_EQ(length, 100u);
+    EXPECT_EQ(record[0], 3);
+    peer->pop();
+    EXPECT_EQ(peer->peek(length, from, to), nullptr);
+
+    // The other direction, the peer produces and the owner consumes
+    EXPECT_TRUE(peer->push(dst, src, payload.data(), 0));
+    EXPECT_TRUE(readable(owner.getEventDescriptor()));
+    ASSERT_NE(owner.peek(length, from, to), nullptr);
+    EXPECT_EQ(length, 0u);
+    EXPECT_EQ(from, dst);
+    std::cout << "Exiting PushPeekWrapAndFull test" << std::endl;
+}
+
+/**
+ *@brief Test that a message other than the handshake is refused
+ *
+ *This test verifies that receiveDescriptors throws when the data socket carries anything but SAP_RING_HANDSHAKE with the descriptors.
+ *
+ ***Test Group ID:* *Basic: 01@n
+ ***Test Case ID:* *002@n
+ ***Priority:* *High@n
+ *@n
+ ***Pre-Conditions:* *None@n
+ ***Dependencies:* *None@n
+ ***User Interaction:* *None@n
+ *@n
+ ***Test Procedure:**@n
+ *| Variation / Step | Description | Test Data | Expected Result | Notes |
+ *| :----: | --------- | ---------- |-------------- | ----- |
+ *| 01 | Send 8 bytes without descriptors | "ALSAPSHM" | AlServiceException | Should Pass |
+ *| 02 | Create a ring of a size that is not a multiple of 8 | 100 bytes | AlServiceException | Should Pass |
+ *| 03 | Create a ring too large for the size of a memfd | SIZE_MAX & ~7 | AlServiceException | Should Pass |
+ */
+TEST_F(AlServiceSharedRingTest, HandshakeRejected) {
+    std::cout << "Entering HandshakeRejected test" << std::endl;
+    ASSERT_EQ(send(sockets[0], SAP_RING_HANDSHAKE, sizeof(SAP_RING_HANDSHAKE), 0), static_cast<ssize_t>(sizeof(SAP_RING_HANDSHAKE)));
+    EXPECT_THROW(AlServiceSharedRing::receiveDescriptors(sockets[1]), AlServiceException);
+    EXPECT_THROW(AlServiceSharedRing ring(100), AlServiceException);
+    EXPECT_THROW(AlServiceSharedRing ring(SIZE_MAX & ~static_cast<size_t>(7)), AlServiceException);
+    std::cout << "Exiting HandshakeRejected test" << std::endl;
+}
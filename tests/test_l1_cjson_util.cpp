@@ -317,3 +317,169 @@ TEST(CjsonUtils, RepeatedCallsReturnSameOutput) {
     cJSON_Delete(obj);
     std::cout << "Exiting " << testName << " test" << std::endl;
 }
+/**
+ * @brief Verify that get_top_level_string finds a member of the top level object only.
+ *
+ * This test scans documents for SubDocName the way the OneWifi callbacks do, with the name placed after nested objects, arrays and strings that contain the same key.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 009@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**
+ * | Variation / Step | Description                                                                 | Test Data                                      | Expected Result                                  | Notes       |
+ * | :--------------: | --------------------------------------------------------------------------- | ---------------------------------------------- | ------------------------------------------------ | ----------- |
+ * | 01               | Scan a document whose nested object and array hold SubDocName before the top level one | SubDocName = "Vap_5G" at the top level  | "Vap_5G" is returned                             | Should Pass |
+ * | 02               | Scan a document with escaped quotes in a value before the member and in the member | SubDocName = "a\"b"                     | a"b is returned                                  | Should Pass |
+ * | 03               | Scan a document with SubDocName only in a nested object                     | None                                           | The member is not found                          | Should Pass |
+ * | 04               | Scan truncated documents, a non string member and a too small buffer        | None                                           | false is returned                                | Should Pass |
+ */
+TEST(CjsonUtils, GetTopLevelString) {
+    const char* testName = "GetTopLevelString";
+    std::cout << "Entering " << testName << " test" << std::endl;
+    const char *doc1 = "{ \"Version\": \"1.0\", \"Nested\": {\"SubDocName\": \"inner\", \"a\": [1, {\"b\": \"}\"}]},"
+        " \"List\": [\"SubDocName\", \"x\"], \"SubDocName\" : \"Vap_5G\", \"Tail\": {}}";
+    const char *doc2 = "{\"Note\": \"say \\\"SubDocName\\\": \\\"no\\\"\", \"SubDocName\": \"a\\\"b\"}";
+    const char *doc3 = "{\"Nested\": {\"SubDocName\": \"inner\"}}";
+    const char *doc4 = "{\"SubDocName\": 5, \"Name\": \"abcdef\"}";
+    char name[64];
+    char small[4];
+
+    EXPECT_TRUE(cjson_utils::get_top_level_string(doc1, strlen(doc1), "SubDocName", name, sizeof(name)));
+    EXPECT_STREQ(name, "Vap_5G");
+    EXPECT_TRUE(cjson_utils::get_top_level_string(doc2, strlen(doc2), "SubDocName", name, sizeof(name)));
+    EXPECT_STREQ(name, "a\"b");
+    EXPECT_FALSE(cjson_utils::get_top_level_string(doc3, strlen(doc3), "SubDocName", name, sizeof(name)));
+    EXPECT_FALSE(cjson_utils::get_top_level_string(doc1, strlen(doc1) - 20, "SubDocName", name, sizeof(name)));
+    EXPECT_FALSE(cjson_utils::get_top_level_string(doc1, 60, "SubDocName", name, sizeof(name)));
+    EXPECT_FALSE(cjson_utils::get_top_level_string(doc4, strlen(doc4), "SubDocName", name, sizeof(name)));
+    EXPECT_FALSE(cjson_utils::get_top_level_string(doc4, strlen(doc4), "Name", small, sizeof(small)));
+    EXPECT_TRUE(cjson_utils::get_top_level_string(doc4, strlen(doc4), "Name", name, sizeof(name)));
+    EXPECT_STREQ(name, "abcdef");
+    std::cout << "Exiting " << testName << " test" << std::endl;
+}
+/**
+ * @brief Verify that find_top_level_value points at values of any type and works on nested objects.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 010@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**
+ * | Variation / Step | Description                                                                 | Test Data                                      | Expected Result                                  | Notes       |
+ * | :--------------: | --------------------------------------------------------------------------- | ---------------------------------------------- | ------------------------------------------------ | ----------- |
+ * | 01               | Find an empty array member                                                  | "AssociatedDeviceStats": [ ]                   | The value starts with '['                        | Should Pass |
+ * | 02               | Find a nested object, then a number member inside it                        | "EMAPMetricsReport": {"Radio Index": 2}        | The inner value starts with '2'                  | Should Pass |
+ * | 03               | Scan a document that is not an object                                       | An array                                       | NULL is returned                                 | Should Pass |
+ */
+TEST(CjsonUtils, FindTopLevelValue) {
+    const char* testName = "FindTopLevelValue";
+    std::cout << "Entering " << testName << " test" << std::endl;
+    const char *doc = "{\"SubDocName\": \"AP Metrics\", \"AssociatedDeviceStats\": [ ],"
+        " \"EMAPMetricsReport\": {\"Radio\": {\"Radio Index\": 9}, \"Radio Index\": 2}}";
+    const char *arr = "[{\"SubDocName\": \"x\"}]";
+    const char *val, *inner;
+
+    val = cjson_utils::find_top_level_value(doc, strlen(doc), "AssociatedDeviceStats");
+    ASSERT_NE(val, nullptr);
+    EXPECT_EQ(*val, '[');
+    EXPECT_EQ(*cjson_utils::skip_space(val + 1, doc + strlen(doc)), ']');
+    val = cjson_utils::find_top_level_value(doc, strlen(doc), "EMAPMetricsReport");
+    ASSERT_NE(val, nullptr);
+    inner = cjson_utils::find_top_level_value(val, strlen(val), "Radio Index");
+    ASSERT_NE(inner, nullptr);
+    EXPECT_EQ(*inner, '2');
+    EXPECT_EQ(cjson_utils::find_top_level_value(doc, strlen(doc), "Radio Index"), nullptr);
+    EXPECT_EQ(cjson_utils::find_top_level_value(arr, strlen(arr), "SubDocName"), nullptr);
+    std::cout << "Exiting " << testName << " test" << std::endl;
+}
+/**
+ * @brief Verify that the measured print size matches cJSON's output for every value type.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 011@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**
+ * | Variation / Step | Description                                                                 | Test Data                                      | Expected Result                                  | Notes       |
+ * | :--------------: | --------------------------------------------------------------------------- | ---------------------------------------------- | ------------------------------------------------ | ----------- |
+ * | 01               | Build a tree with nested objects and arrays, numbers, escapes and literals  | Objects in arrays, 0.1, 1e300, -7, "a\"b\n\x01"| get_print_size equals the length cJSON prints    | Should Pass |
+ * | 02               | Measure an empty object and an empty array                                  | {}, []                                         | Same length as cJSON prints                      | Should Pass |
+ */
+TEST(CjsonUtils, PrintSizeMatchesPrint) {
+    const char* testName = "PrintSizeMatchesPrint";
+    std::cout << "Entering " << testName << " test" << std::endl;
+    cJSON *root = cJSON_CreateObject();
+    ASSERT_NE(root, nullptr);
+    cJSON *arr = cJSON_AddArrayToObject(root, "List");
+    cJSON *item = cJSON_CreateObject();
+    cJSON_AddStringToObject(item, "Name", "a\"b\n\x01");
+    cJSON_AddNumberToObject(item, "Frac", 0.1);
+    cJSON_AddNumberToObject(item, "Big", 1e300);
+    cJSON_AddNumberToObject(item, "Neg", -7);
+    cJSON_AddItemToArray(arr, item);
+    cJSON_AddItemToArray(arr, cJSON_CreateArray());
+    cJSON_AddItemToArray(arr, cJSON_CreateObject());
+    cJSON_AddNullToObject(root, "Null");
+    cJSON_AddFalseToObject(root, "False");
+
+    char *formatted = cJSON_Print(root);
+    char *unformatted = cJSON_PrintUnformatted(root);
+    ASSERT_NE(formatted, nullptr);
+    ASSERT_NE(unformatted, nullptr);
+    EXPECT_EQ(cjson_utils::get_print_size(root, true), strlen(formatted));
+    EXPECT_EQ(cjson_utils::get_print_size(root, false), strlen(unformatted));
+    EXPECT_EQ(cjson_utils::get_cjson_blob_size(root), strlen(formatted));
+    EXPECT_EQ(cjson_utils::stringify(root), std::string(formatted));
+    EXPECT_EQ(cjson_utils::stringify(root, true), std::string(unformatted));
+    cJSON_free(formatted);
+    cJSON_free(unformatted);
+    cJSON_Delete(root);
+    std::cout << "Exiting " << testName << " test" << std::endl;
+}
+/**
+ * @brief Verify that print_preallocated prints into a caller buffer and truncates what does not fit.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 012@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**
+ * | Variation / Step | Description                                                                 | Test Data                                      | Expected Result                                  | Notes       |
+ * | :--------------: | --------------------------------------------------------------------------- | ---------------------------------------------- | ------------------------------------------------ | ----------- |
+ * | 01               | Print an object into a buffer large enough                                  | {"SubDocName": "Reset"}, 256 bytes             | true, same text as cJSON_Print                   | Should Pass |
+ * | 02               | Print it into a buffer too small                                            | 8 bytes                                        | false, the first 7 characters                    | Should Pass |
+ */
+TEST(CjsonUtils, PrintPreallocated) {
+    const char* testName = "PrintPreallocated";
+    std::cout << "Entering " << testName << " test" << std::endl;
+    char buff[256], small[8];
+    cJSON *obj = cJSON_CreateObject();
+    ASSERT_NE(obj, nullptr);
+    cJSON_AddStringToObject(obj, "SubDocName", "Reset");
+    char *s = cJSON_Print(obj);
+    ASSERT_NE(s, nullptr);
+    EXPECT_TRUE(cjson_utils::print_preallocated(obj, buff, sizeof(buff)));
+    EXPECT_STREQ(buff, s);
+    EXPECT_FALSE(cjson_utils::print_preallocated(obj, small, sizeof(small)));
+    EXPECT_EQ(std::string(small), std::string(s, sizeof(small) - 1));
+    cJSON_free(s);
+    cJSON_Delete(obj);
+    std::cout << "Exiting " << testName << " test" << std::endl;
+}
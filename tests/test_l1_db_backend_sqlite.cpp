@@ -0,0 +1,359 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "db_client.h"
+
+#ifdef EM_DB_SQLITE
+
+static void test_db_file(char *file, size_t len)
+{
+    snprintf(file, len, "/tmp/test_db_backend_%d.db", getpid());
+    unlink(file);
+}
+
+static void test_db_remove(const char *file)
+{
+    std::string path(file);
+
+    unlink(path.c_str());
+    unlink((path + "-wal").c_str());
+    unlink((path + "-shm").c_str());
+}
+
+/**
+* @brief Test that rows written to SQLite are read back through the backend
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Open a database file, create a table and an index in one call | None | 0 is returned, no rows | Should Pass |
+* | 02| Write a batch of three inserts, the second one invalid | None | Only the second is marked failed | Should Pass |
+* | 03| Select the rows | None | Two rows, values, lengths and NULL are preserved | Should Pass |
+* | 04| Read the tables and checksums, change a row | None | The table is listed, the checksum changes, a missing table has checksum 0 | Should Pass |
+* | 05| Recreate the database | None | No table is left | Should Pass |
+*/
+TEST(db_backend_sqlite_t_Test, QueryAndWrite) {
+    std::cout << "Entering QueryAndWrite test" << std::endl;
+    char file[64];
+    db_backend_t *db;
+    db_rows_t rows;
+    std::vector<std::string> tables;
+    unsigned long long sum0, sum1;
+    unsigned long len;
+    const char *val;
+    char q0[] = "insert into t (k, v) values('a', 1)";
+    char q1[] = "insert into nope (k) values('b')";
+    char q2[] = "insert into t (k) values('c')";
+    char *queries[] = {q0, q1, q2};
+    bool failed[3] = {false, false, false};
+
+    test_db_file(file, sizeof(file));
+    ASSERT_NE(db = db_backend_t::create(), nullptr);
+    ASSERT_EQ(db->open(file), 0);
+    ASSERT_EQ(db->query("create table t (k varchar(16), v int); create index tKey on t (k)", &rows), 0);
+    EXPECT_EQ(rows.result, nullptr);
+
+    db->write_batch(queries, 3, failed);
+    EXPECT_FALSE(failed[0]);
+    EXPECT_TRUE(failed[1]);
+    EXPECT_FALSE(failed[2]);
+
+    ASSERT_EQ(db->query("select * from t order by k", &rows), 0);
+    ASSERT_NE(rows.result, nullptr);
+    EXPECT_EQ(db->get_num_cols(&rows), 2u);
+    EXPECT_EQ(db->get_value(&rows, 1, &len), nullptr);
+    ASSERT_TRUE(db->next_row(&rows));
+    ASSERT_NE(val = db->get_value(&rows, 1, &len), nullptr);
+    EXPECT_STREQ(val, "a");
+    EXPECT_EQ(len, 1u);
+    ASSERT_NE(val = db->get_value(&rows, 2, &len), nullptr);
+    EXPECT_STREQ(val, "1");
+    EXPECT_EQ(db->get_value(&rows, 3, &len), nullptr);
+    ASSERT_TRUE(db->next_row(&rows));
+    EXPECT_EQ(db->get_value(&rows, 2, &len), nullptr);
+    EXPECT_FALSE(db->next_row(&rows));
+    EXPECT_EQ(rows.result, nullptr);
+    EXPECT_NE(db->query("select * from nope", &rows), 0);
+
+    ASSERT_EQ(db->get_tables(tables), 0);
+    ASSERT_EQ(tables.size(), 1u);
+    EXPECT_EQ(tables[0], "t");
+    ASSERT_EQ(db->get_checksum("t", &sum0), 0);
+    ASSERT_EQ(db->query("update t set v = 2 where k = 'a'", &rows), 0);
+    ASSERT_EQ(db->get_checksum("t", &sum1), 0);
+    EXPECT_NE(sum0, sum1);
+    ASSERT_EQ(db->get_checksum("nope", &sum0), 0);
+    EXPECT_EQ(sum0, 0u);
+
+    ASSERT_EQ(db->recreate(), 0);
+    tables.clear();
+    ASSERT_EQ(db->get_tables(tables), 0);
+    EXPECT_TRUE(tables.empty());
+
+    delete db;
+    test_db_remove(file);
+    std::cout << "Exiting QueryAndWrite test" << std::endl;
+}
+
+/**
+* @brief Test the database client with its write behind worker and snapshot on SQLite
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Init the client on a file, create a table and start the writer | None | 0 is returned | Should Pass |
+* | 02| Write two rows and flush | None | Both rows are read back on the main connection | Should Pass |
+* | 03| Save a snapshot and load it | None | The table is read from the snapshot | Should Pass |
+*/
+TEST(db_backend_sqlite_t_Test, ClientOnSqlite) {
+    std::cout << "Entering ClientOnSqlite test" << std::endl;
+    char file[64], snap[80], str[32];
+    db_client_t client;
+    std::vector<std::string> tables;
+    unsigned int num = 0;
+    void *ctx;
+
+    test_db_file(file, sizeof(file));
+    snprintf(snap, sizeof(snap), "%s.snap", file);
+    ASSERT_EQ(client.init(file), 0);
+    EXPECT_EQ(client.execute("create table t (k varchar(16), v int)"), nullptr);
+    ASSERT_EQ(client.start_writer(file), 0);
+
+    EXPECT_EQ(client.write("t", "a", db_write_op_insert, "insert into t (k, v) values('a', 1)"), 0);
+    EXPECT_EQ(client.write("t", "b", db_write_op_insert, "insert into t (k, v) values('b', 2)"), 0);
+    client.flush();
+
+    ASSERT_NE(ctx = client.execute("select * from t order by k"), nullptr);
+    while (client.next_result(ctx) == true) {
+        ASSERT_NE(client.get_string(ctx, str, 1), nullptr);
+        EXPECT_STREQ(str, (num == 0) ? "a":"b");
+        EXPECT_EQ(client.get_number(ctx, 2), static_cast<int>(num + 1));
+        num++;
+    }
+    EXPECT_EQ(num, 2u);
+    ASSERT_EQ(client.get_tables(tables), 0);
+    EXPECT_EQ(tables.size(), 1u);
+
+    ASSERT_EQ(client.save_snapshot(snap), 0);
+    ASSERT_EQ(client.open_snapshot(snap), 0);
+    ASSERT_NE(ctx = client.execute_snapshot("t"), nullptr);
+    for (num = 0; client.next_result(ctx) == true; num++);
+    EXPECT_EQ(num, 2u);
+    client.close_snapshot();
+
+    client.stop_writer();
+    unlink(snap);
+    test_db_remove(file);
+    std::cout << "Exiting ClientOnSqlite test" << std::endl;
+}
+
+/**
+* @brief Test that a second database follows the first through snapshot images, never running its statements
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Write two rows, one with a quote and a NULL, on a client logging its writes | None | Two records logged | Should Pass |
+* | 02| Restore an image of the first database into the second | Stale row in the second | The rows of the first replace it | Should Pass |
+* | 03| Update and delete on the first, restore an image of the tables the logged records changed | Table u untouched | Both databases hold the same row, u is not in the image | Should Pass |
+* | 04| Restore an image naming a table the second does not have | Table x | -1 is returned, nothing is written | Should Pass |
+*/
+TEST(db_backend_sqlite_t_Test, Replicate) {
+    std::cout << "Entering Replicate test" << std::endl;
+    char file[64], standby_file[80], str[32];
+    db_client_t primary, standby, other;
+    db_change_log_t log;
+    db_change_rec_t rec;
+    db_snapshot_t snap;
+    std::vector<std::string> tables;
+    std::string recs, image;
+    unsigned long long seq, next;
+    size_t off = 0;
+    int len;
+    void *ctx;
+
+    test_db_file(file, sizeof(file));
+    snprintf(standby_file, sizeof(standby_file), "%s.standby", file);
+    test_db_remove(standby_file);
+    ASSERT_EQ(primary.init(file), 0);
+    ASSERT_EQ(standby.init(standby_file), 0);
+    EXPECT_EQ(primary.execute("create table t (k varchar(16), v varchar(16))"), nullptr);
+    EXPECT_EQ(primary.execute("create table u (k varchar(16))"), nullptr);
+    EXPECT_EQ(standby.execute("create table t (k varchar(16), v varchar(16))"), nullptr);
+    EXPECT_EQ(standby.execute("create table u (k varchar(16))"), nullptr);
+    EXPECT_EQ(standby.execute("insert into t values('stale', 'x')"), nullptr);
+
+    primary.set_change_log(&log);
+    EXPECT_EQ(primary.write("t", "a", db_write_op_insert, "insert into t values('a', 'it''s')"), 0);
+    EXPECT_EQ(primary.write("t", "b", db_write_op_insert, "insert into t values('b', NULL)"), 0);
+    EXPECT_EQ(log.get_last_seq(), 2u);
+
+    seq = log.get_last_seq();
+    ASSERT_EQ(primary.save_snapshot(image), 0);
+    ASSERT_EQ(standby.restore_snapshot(image), 0);
+    ASSERT_NE(ctx = standby.execute("select k, v from t order by k"), nullptr);
+    ASSERT_TRUE(standby.next_result(ctx));
+    EXPECT_STREQ(standby.get_string(ctx, str, 1), "a");
+    EXPECT_STREQ(standby.get_string(ctx, str, 2), "it's");
+    ASSERT_TRUE(standby.next_result(ctx));
+    EXPECT_STREQ(standby.get_string(ctx, str, 1), "b");
+    EXPECT_FALSE(standby.next_result(ctx));
+
+    EXPECT_EQ(primary.write("t", "a", db_write_op_update, "update t set v = 'new' where k = 'a'"), 0);
+    EXPECT_EQ(primary.write("t", "b", db_write_op_delete, "delete from t where k = 'b'"), 0);
+    ASSERT_EQ(log.read(seq + 1, 65536, recs, &next), 2);
+    EXPECT_EQ(next, 5u);
+    while ((len = db_change_log_t::decode(reinterpret_cast<const unsigned char *>(recs.data()) + off, recs.size() - off, &rec)) > 0) {
+        if (std::find(tables.begin(), tables.end(), rec.table) == tables.end()) {
+            tables.push_back(rec.table);
+        }
+        off += static_cast<size_t>(len);
+    }
+    EXPECT_EQ(off, recs.size());
+    ASSERT_EQ(tables.size(), 1u);
+
+    image.clear();
+    ASSERT_EQ(primary.save_snapshot(image, &tables), 0);
+    recs = image;
+    ASSERT_EQ(snap.load_image(recs), 0);
+    EXPECT_EQ(snap.get_num_tables(), 1u);
+    EXPECT_EQ(snap.get_table("u"), nullptr);
+    ASSERT_EQ(standby.restore_snapshot(image), 0);
+
+    ASSERT_NE(ctx = standby.execute("select k, v from t"), nullptr);
+    ASSERT_TRUE(standby.next_result(ctx));
+    EXPECT_STREQ(standby.get_string(ctx, str, 1), "a");
+    EXPECT_STREQ(standby.get_string(ctx, str, 2), "new");
+    EXPECT_FALSE(standby.next_result(ctx));
+
+    // a peer can not make the standby write a table it does not have
+    test_db_remove(file);
+    ASSERT_EQ(other.init(file), 0);
+    EXPECT_EQ(other.execute("create table x (k varchar(16))"), nullptr);
+    EXPECT_EQ(other.execute("create table t (k varchar(16), v varchar(16))"), nullptr);
+    image.clear();
+    ASSERT_EQ(other.save_snapshot(image), 0);
+    EXPECT_EQ(standby.restore_snapshot(image), -1);
+    ASSERT_NE(ctx = standby.execute("select k from t"), nullptr);
+    ASSERT_TRUE(standby.next_result(ctx));
+    EXPECT_STREQ(standby.get_string(ctx, str, 1), "a");
+    EXPECT_FALSE(standby.next_result(ctx));
+
+    test_db_remove(standby_file);
+    test_db_remove(file);
+    std::cout << "Exiting Replicate test" << std::endl;
+}
+
+/**
+* @brief Test that the bytes of a blob column come back as they were written
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Write a blob with a NUL, a quote and a byte over 0x7f as a hex literal | X'00ff410027' | The 5 bytes are read back, a smaller buffer gets the first ones | Should Pass |
+* | 02| Read the row from a snapshot | None | The 5 bytes are read back | Should Pass |
+* | 03| Restore the snapshot into a second database | None | The 5 bytes are read back from it | Should Pass |
+*/
+TEST(db_backend_sqlite_t_Test, BlobRoundTrip) {
+    std::cout << "Entering BlobRoundTrip test" << std::endl;
+    const unsigned char blob[] = {0x00, 0xff, 0x41, 0x00, 0x27};
+    char file[64], standby_file[80], snap[80];
+    unsigned char buff[16];
+    db_client_t primary, standby;
+    void *ctx;
+
+    test_db_file(file, sizeof(file));
+    snprintf(standby_file, sizeof(standby_file), "%s.standby", file);
+    snprintf(snap, sizeof(snap), "%s.snap", file);
+    test_db_remove(standby_file);
+    ASSERT_EQ(primary.init(file), 0);
+    ASSERT_EQ(standby.init(standby_file), 0);
+    EXPECT_EQ(primary.execute("create table t (k varchar(16), v blob)"), nullptr);
+    EXPECT_EQ(standby.execute("create table t (k varchar(16), v blob)"), nullptr);
+    EXPECT_EQ(primary.execute("insert into t values('a', X'00ff410027')"), nullptr);
+
+    ASSERT_NE(ctx = primary.execute("select k, v from t"), nullptr);
+    ASSERT_TRUE(primary.next_result(ctx));
+    EXPECT_EQ(primary.get_blob(ctx, buff, sizeof(buff), 2), sizeof(blob));
+    EXPECT_EQ(memcmp(buff, blob, sizeof(blob)), 0);
+    EXPECT_EQ(primary.get_blob(ctx, buff, 2, 2), 2u);
+    EXPECT_FALSE(primary.next_result(ctx));
+
+    ASSERT_EQ(primary.save_snapshot(snap), 0);
+    ASSERT_EQ(primary.open_snapshot(snap), 0);
+    ASSERT_NE(ctx = primary.execute_snapshot("t"), nullptr);
+    ASSERT_TRUE(primary.next_result(ctx));
+    memset(buff, 0, sizeof(buff));
+    EXPECT_EQ(primary.get_blob(ctx, buff, sizeof(buff), 2), sizeof(blob));
+    EXPECT_EQ(memcmp(buff, blob, sizeof(blob)), 0);
+    EXPECT_FALSE(primary.next_result(ctx));
+    primary.close_snapshot();
+
+    ASSERT_EQ(standby.restore_snapshot(snap), 0);
+    ASSERT_NE(ctx = standby.execute("select k, v from t"), nullptr);
+    ASSERT_TRUE(standby.next_result(ctx));
+    memset(buff, 0, sizeof(buff));
+    EXPECT_EQ(standby.get_blob(ctx, buff, sizeof(buff), 2), sizeof(blob));
+    EXPECT_EQ(memcmp(buff, blob, sizeof(blob)), 0);
+    EXPECT_FALSE(standby.next_result(ctx));
+
+    unlink(snap);
+    test_db_remove(standby_file);
+    test_db_remove(file);
+    std::cout << "Exiting BlobRoundTrip test" << std::endl;
+}
+
+#endif
@@ -0,0 +1,169 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <string>
+#include "db_change_log.h"
+
+// decodes every record of a buffer, in order
+static std::vector<db_change_rec_t> test_decode_all(const std::string& buf)
+{
+    std::vector<db_change_rec_t> recs;
+    db_change_rec_t rec;
+    size_t off = 0;
+    int len;
+
+    while ((len = db_change_log_t::decode(reinterpret_cast<const unsigned char *>(buf.data()) + off, buf.size() - off, &rec)) > 0) {
+        recs.push_back(rec);
+        off += static_cast<size_t>(len);
+    }
+    EXPECT_EQ(off, buf.size());
+
+    return recs;
+}
+
+/**
+* @brief Test the encoding of the records
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Encode a record and decode it | Update of a row | Same fields, header in network byte order | Should Pass |
+* | 02| Decode every prefix of the record | None | More bytes needed | Should Pass |
+* | 03| Decode records with a bad length or operation | None | Corrupt | Should Pass |
+*/
+TEST(db_change_log_t_Test, Encode) {
+    std::cout << "Entering Encode test" << std::endl;
+    std::string buf;
+    db_change_rec_t rec;
+    const unsigned char *p;
+    size_t len, i;
+
+    len = db_change_log_t::encode(0x0102030405060708ULL, "RadioList", "aa:bb", db_write_op_update,
+            "update RadioList set Enabled = 1", buf);
+    ASSERT_EQ(len, buf.size());
+    ASSERT_EQ(len, DB_CHANGE_LOG_HDR_LEN + strlen("RadioList") + strlen("aa:bb") + strlen("update RadioList set Enabled = 1"));
+    p = reinterpret_cast<const unsigned char *>(buf.data());
+    EXPECT_EQ(p[3], len);
+    EXPECT_EQ(p[4], 0x01);
+    EXPECT_EQ(p[11], 0x08);
+
+    ASSERT_EQ(db_change_log_t::decode(p, buf.size(), &rec), static_cast<int>(len));
+    EXPECT_EQ(rec.seq, 0x0102030405060708ULL);
+    EXPECT_EQ(rec.op, db_write_op_update);
+    EXPECT_EQ(rec.table, "RadioList");
+    EXPECT_EQ(rec.key, "aa:bb");
+    EXPECT_EQ(rec.query, "update RadioList set Enabled = 1");
+
+    for (i = 0; i < len; i++) {
+        EXPECT_EQ(db_change_log_t::decode(p, i, &rec), 0);
+    }
+
+    buf[12] = 7;
+    EXPECT_EQ(db_change_log_t::decode(p, buf.size(), &rec), -1);
+    buf[12] = db_write_op_delete;
+    buf[3] = static_cast<char>(len - 1);
+    EXPECT_EQ(db_change_log_t::decode(p, buf.size(), &rec), -1);
+    buf[3] = 4;
+    EXPECT_EQ(db_change_log_t::decode(p, buf.size(), &rec), -1);
+    std::cout << "Exiting Encode test" << std::endl;
+}
+
+/**
+* @brief Test that readers continue from their last record and learn when they fell behind
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Append three records, read them in two parts | Byte limit of one record | Records in order, then the rest | Should Pass |
+* | 02| Read past the last record | None | Nothing read, waiting times out | Should Pass |
+* | 03| Overflow the ring | DB_CHANGE_LOG_MAX_RECS more | The oldest are no longer readable | Should Pass |
+* | 04| Reset the log | None | The last record read is no longer current | Should Pass |
+*/
+TEST(db_change_log_t_Test, Ring) {
+    std::cout << "Entering Ring test" << std::endl;
+    db_change_log_t log, other;
+    db_change_log_stats_t stats;
+    std::vector<db_change_rec_t> recs;
+    std::string buf;
+    unsigned long long next, last;
+    unsigned int i;
+
+    EXPECT_NE(log.get_id(), other.get_id());
+    EXPECT_EQ(log.get_last_seq(), 0u);
+    EXPECT_EQ(log.append("t", "a", db_write_op_insert, "insert a"), 1u);
+    EXPECT_EQ(log.append("t", "b", db_write_op_insert, "insert b"), 2u);
+    EXPECT_EQ(log.append("t", "a", db_write_op_delete, "delete a"), 3u);
+
+    ASSERT_EQ(log.read(1, 1, buf, &next), 1);
+    EXPECT_EQ(next, 2u);
+    ASSERT_EQ(log.read(next, 65536, buf, &next), 2);
+    EXPECT_EQ(next, 4u);
+    recs = test_decode_all(buf);
+    ASSERT_EQ(recs.size(), 3u);
+    EXPECT_EQ(recs[0].query, "insert a");
+    EXPECT_EQ(recs[2].seq, 3u);
+    EXPECT_EQ(recs[2].op, db_write_op_delete);
+
+    buf.clear();
+    EXPECT_EQ(log.read(4, 65536, buf, &next), 0);
+    EXPECT_EQ(log.read(5, 65536, buf, &next), -1);
+    EXPECT_TRUE(log.wait(3, 10));
+    EXPECT_FALSE(log.wait(4, 10));
+
+    for (i = 0; i < DB_CHANGE_LOG_MAX_RECS; i++) {
+        log.append("t", "c", db_write_op_update, "update c");
+    }
+    last = log.get_last_seq();
+    EXPECT_EQ(last, 3u + DB_CHANGE_LOG_MAX_RECS);
+    EXPECT_EQ(log.read(3, 65536, buf, &next), -1);
+    buf.clear();
+    EXPECT_EQ(log.read(4, 0, buf, &next), 1);
+    log.get_stats(&stats);
+    EXPECT_EQ(stats.appended, 3u + DB_CHANGE_LOG_MAX_RECS);
+    EXPECT_EQ(stats.dropped, 3u);
+    EXPECT_EQ(stats.num_recs, static_cast<unsigned int>(DB_CHANGE_LOG_MAX_RECS));
+
+    log.reset();
+    EXPECT_EQ(log.read(last + 1, 65536, buf, &next), -1);
+    EXPECT_EQ(log.append("t", "d", db_write_op_insert, "insert d"), last + 2);
+    buf.clear();
+    EXPECT_EQ(log.read(last + 2, 65536, buf, &next), 1);
+    log.get_stats(&stats);
+    EXPECT_EQ(stats.resets, 1u);
+    EXPECT_EQ(stats.num_recs, 1u);
+    std::cout << "Exiting Ring test" << std::endl;
+}
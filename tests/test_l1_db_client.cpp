@@ -21,6 +21,7 @@
 #include <gmock/gmock.h>
 #include <stdio.h>
 #include "db_client.h"
+#include "db_backend_mysql.h"
 
 class db_client_t_Test : public ::testing::Test {
 protected:
@@ -0,0 +1,256 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "db_snapshot.h"
+
+static void test_snapshot_file(char *file, size_t len)
+{
+    snprintf(file, len, "/tmp/test_db_snapshot_%d.snap", getpid());
+}
+
+/**
+* @brief Test that the rows saved to a snapshot are read back
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Add a table of two rows, one with a NULL value, and an empty table, save | None | 0 is returned | Should Pass |
+* | 02| Load the snapshot | None | Both tables are listed with their checksums | Should Pass |
+* | 03| Read the rows of the first table | None | The values, lengths and NULL are preserved | Should Pass |
+* | 04| Open a table that was not saved | None | -1 is returned | Should Pass |
+*/
+TEST(db_snapshot_t_Test, SaveAndLoad) {
+    std::cout << "Entering SaveAndLoad test" << std::endl;
+    char file[64];
+    db_snapshot_t out, in;
+    db_snapshot_cursor_t cur;
+    const db_snapshot_table_hdr_t *table;
+    const char *row0[] = {"aa:bb:cc:dd:ee:ff", "12", ""};
+    const char *row1[] = {"11:22:33:44:55:66", NULL, "x"};
+    unsigned long lens0[] = {17, 2, 0}, lens1[] = {17, 0, 1};
+
+    test_snapshot_file(file, sizeof(file));
+    EXPECT_EQ(out.add_row(row0, lens0), -1);
+    ASSERT_EQ(out.add_table("STAList", 3, 1234), 0);
+    ASSERT_EQ(out.add_row(row0, lens0), 0);
+    ASSERT_EQ(out.add_row(row1, lens1), 0);
+    ASSERT_EQ(out.add_table("ScanResultList", 14, 0), 0);
+    ASSERT_EQ(out.save(file), 0);
+
+    ASSERT_EQ(in.load(file), 0);
+    EXPECT_TRUE(in.is_loaded());
+    EXPECT_EQ(in.get_num_tables(), 2u);
+    ASSERT_NE(table = in.get_table("STAList"), nullptr);
+    EXPECT_EQ(table->num_rows, 2u);
+    EXPECT_EQ(table->checksum, 1234u);
+    ASSERT_NE(table = in.get_table(1), nullptr);
+    EXPECT_STREQ(table->name, "ScanResultList");
+    EXPECT_EQ(table->num_rows, 0u);
+
+    ASSERT_EQ(in.open_table("STAList", &cur), 0);
+    ASSERT_TRUE(in.next_row(&cur));
+    EXPECT_STREQ(cur.cols[0], "aa:bb:cc:dd:ee:ff");
+    EXPECT_STREQ(cur.cols[1], "12");
+    EXPECT_STREQ(cur.cols[2], "");
+    EXPECT_EQ(cur.lens[0], 17u);
+    ASSERT_TRUE(in.next_row(&cur));
+    EXPECT_EQ(cur.cols[1], nullptr);
+    EXPECT_STREQ(cur.cols[2], "x");
+    EXPECT_FALSE(in.next_row(&cur));
+
+    ASSERT_EQ(in.open_table("ScanResultList", &cur), 0);
+    EXPECT_FALSE(in.next_row(&cur));
+    EXPECT_EQ(in.open_table("DeviceList", &cur), -1);
+
+    in.unload();
+    EXPECT_FALSE(in.is_loaded());
+    EXPECT_EQ(in.get_table("STAList"), nullptr);
+    unlink(file);
+    std::cout << "Exiting SaveAndLoad test" << std::endl;
+}
+
+/**
+* @brief Test that a snapshot of another version or a truncated snapshot is rejected
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Load a missing file | None | -1 is returned | Should Pass |
+* | 02| Save a snapshot, change its version and load it | None | -1 is returned, nothing is loaded | Should Pass |
+* | 03| Save a snapshot, cut its last bytes and load it | None | -1 is returned, nothing is loaded | Should Pass |
+*/
+TEST(db_snapshot_t_Test, RejectInvalid) {
+    std::cout << "Entering RejectInvalid test" << std::endl;
+    char file[64];
+    db_snapshot_t out, in;
+    db_snapshot_hdr_t hdr;
+    const char *row[] = {"aa:bb:cc:dd:ee:ff", "12"};
+    unsigned long lens[] = {17, 2};
+    long sz;
+    FILE *fp;
+
+    test_snapshot_file(file, sizeof(file));
+    unlink(file);
+    EXPECT_EQ(in.load(file), -1);
+
+    ASSERT_EQ(out.add_table("STAList", 2, 0), 0);
+    ASSERT_EQ(out.add_row(row, lens), 0);
+    ASSERT_EQ(out.save(file), 0);
+
+    ASSERT_NE(fp = fopen(file, "r+b"), nullptr);
+    ASSERT_EQ(fread(&hdr, sizeof(hdr), 1, fp), 1u);
+    hdr.version = DB_SNAPSHOT_VERSION + 1;
+    rewind(fp);
+    ASSERT_EQ(fwrite(&hdr, sizeof(hdr), 1, fp), 1u);
+    fclose(fp);
+    EXPECT_EQ(in.load(file), -1);
+    EXPECT_FALSE(in.is_loaded());
+
+    ASSERT_EQ(out.save(file), 0);
+    ASSERT_NE(fp = fopen(file, "rb"), nullptr);
+    fseek(fp, 0, SEEK_END);
+    sz = ftell(fp);
+    fclose(fp);
+    ASSERT_EQ(truncate(file, sz - 4), 0);
+    EXPECT_EQ(in.load(file), -1);
+    EXPECT_FALSE(in.is_loaded());
+
+    unlink(file);
+    std::cout << "Exiting RejectInvalid test" << std::endl;
+}
+
+/**
+* @brief Test that the tables added are read in memory once sealed
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Add a table of two rows and seal | None | 0 is returned, the snapshot is loaded | Should Pass |
+* | 02| Read the rows | None | The values and the NULL are preserved | Should Pass |
+* | 03| Seal again, then unload | None | -1 is returned, then nothing is loaded | Should Pass |
+*/
+TEST(db_snapshot_t_Test, Seal) {
+    std::cout << "Entering Seal test" << std::endl;
+    db_snapshot_t snap;
+    db_snapshot_cursor_t cur;
+    const char *row1[] = {"aa:bb:cc:dd:ee:ff", "12"};
+    const char *row2[] = {"11:22:33:44:55:66", NULL};
+    unsigned long lens1[] = {17, 2}, lens2[] = {17, 0};
+
+    ASSERT_EQ(snap.add_table("STAList", 2, 0), 0);
+    ASSERT_EQ(snap.add_row(row1, lens1), 0);
+    ASSERT_EQ(snap.add_row(row2, lens2), 0);
+    ASSERT_EQ(snap.seal(), 0);
+    EXPECT_TRUE(snap.is_loaded());
+    ASSERT_EQ(snap.get_num_tables(), 1u);
+    EXPECT_EQ(snap.get_table("STAList")->num_rows, 2u);
+
+    ASSERT_EQ(snap.open_table("STAList", &cur), 0);
+    ASSERT_TRUE(snap.next_row(&cur));
+    EXPECT_STREQ(cur.cols[0], "aa:bb:cc:dd:ee:ff");
+    EXPECT_STREQ(cur.cols[1], "12");
+    ASSERT_TRUE(snap.next_row(&cur));
+    EXPECT_EQ(cur.cols[1], nullptr);
+    EXPECT_FALSE(snap.next_row(&cur));
+
+    EXPECT_EQ(snap.seal(), -1);
+    snap.unload();
+    EXPECT_FALSE(snap.is_loaded());
+    std::cout << "Exiting Seal test" << std::endl;
+}
+
+/**
+* @brief Test that a snapshot written to a buffer is loaded from it
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Add two tables, write them to a buffer | None | The buffer is not empty | Should Pass |
+* | 02| Load the buffer | None | Both tables and their rows are read back, the buffer is taken over | Should Pass |
+* | 03| Load a truncated buffer and an empty one | None | -1 is returned, nothing is loaded | Should Pass |
+*/
+TEST(db_snapshot_t_Test, Image) {
+    std::cout << "Entering Image test" << std::endl;
+    db_snapshot_t out, in;
+    db_snapshot_cursor_t cur;
+    std::string image, cut;
+    const char *row[] = {"aa:bb:cc:dd:ee:ff", NULL};
+    unsigned long lens[] = {17, 0};
+
+    ASSERT_EQ(out.add_table("STAList", 2, 7), 0);
+    ASSERT_EQ(out.add_row(row, lens), 0);
+    ASSERT_EQ(out.add_table("DeviceList", 2, 0), 0);
+    out.save_image(image);
+    ASSERT_FALSE(image.empty());
+    cut = image.substr(0, image.size() - 1);
+
+    ASSERT_EQ(in.load_image(image), 0);
+    EXPECT_TRUE(image.empty());
+    EXPECT_EQ(in.get_num_tables(), 2u);
+    EXPECT_EQ(in.get_table("STAList")->checksum, 7u);
+    ASSERT_EQ(in.open_table("STAList", &cur), 0);
+    ASSERT_TRUE(in.next_row(&cur));
+    EXPECT_STREQ(cur.cols[0], "aa:bb:cc:dd:ee:ff");
+    EXPECT_EQ(cur.cols[1], nullptr);
+    EXPECT_FALSE(in.next_row(&cur));
+    ASSERT_EQ(in.open_table("DeviceList", &cur), 0);
+    EXPECT_FALSE(in.next_row(&cur));
+
+    EXPECT_EQ(in.load_image(cut), -1);
+    EXPECT_FALSE(in.is_loaded());
+    EXPECT_EQ(in.load_image(image), -1);
+    EXPECT_FALSE(in.is_loaded());
+    std::cout << "Exiting Image test" << std::endl;
+}
@@ -0,0 +1,247 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <pthread.h>
+#include <string>
+#include <vector>
+#include "db_write_queue.h"
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    bool blocked;               // the batch function waits until cleared
+    unsigned int entered;       // batches that reached the batch function
+    std::vector<std::string> written;
+    std::vector<unsigned int> batches;
+} test_sink_t;
+
+static void test_write_batch(void *arg, char **queries, unsigned int num, bool *failed)
+{
+    test_sink_t *sink = static_cast<test_sink_t *>(arg);
+    unsigned int i;
+
+    pthread_mutex_lock(&sink->lock);
+    sink->entered++;
+    pthread_cond_broadcast(&sink->cond);
+    while (sink->blocked == true) {
+        pthread_cond_wait(&sink->cond, &sink->lock);
+    }
+    for (i = 0; i < num; i++) {
+        sink->written.push_back(queries[i]);
+        failed[i] = (strncmp(queries[i], "bad", strlen("bad")) == 0);
+    }
+    sink->batches.push_back(num);
+    pthread_mutex_unlock(&sink->lock);
+}
+
+static void test_sink_wait_entered(test_sink_t *sink, unsigned int num)
+{
+    pthread_mutex_lock(&sink->lock);
+    while (sink->entered < num) {
+        pthread_cond_wait(&sink->cond, &sink->lock);
+    }
+    pthread_mutex_unlock(&sink->lock);
+}
+
+static void test_sink_release(test_sink_t *sink)
+{
+    pthread_mutex_lock(&sink->lock);
+    sink->blocked = false;
+    pthread_cond_broadcast(&sink->cond);
+    pthread_mutex_unlock(&sink->lock);
+}
+
+/**
+* @brief Test that writes are committed in order and that flush waits for them
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Push before the worker is started | None | -1 is returned | Should Pass |
+* | 02| Push an insert, an update and a delete of three rows | None | The writes are pending | Should Pass |
+* | 03| Flush | None | The writes are committed in order, nothing is pending, depth is 0 | Should Pass |
+*/
+TEST(db_write_queue_t_Test, FlushWritesInOrder) {
+    std::cout << "Entering FlushWritesInOrder test" << std::endl;
+    test_sink_t sink = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, true, 0, {}, {}};
+    db_write_queue_t queue;
+    db_write_queue_stats_t stats;
+    db_write_op_t op;
+
+    EXPECT_EQ(queue.push("t", "a", db_write_op_insert, "insert a"), -1);
+    ASSERT_EQ(queue.start(test_write_batch, &sink, 8), 0);
+
+    EXPECT_EQ(queue.push("t", "a", db_write_op_insert, "insert a"), 0);
+    EXPECT_EQ(queue.push("t", "b", db_write_op_update, "update b"), 0);
+    EXPECT_EQ(queue.push("u", "a", db_write_op_delete, "delete a"), 0);
+    EXPECT_TRUE(queue.get_pending("t", "a", &op));
+    EXPECT_EQ(op, db_write_op_insert);
+    EXPECT_TRUE(queue.get_pending("u", "a", &op));
+    EXPECT_EQ(op, db_write_op_delete);
+    EXPECT_FALSE(queue.get_pending("t", "c", &op));
+
+    test_sink_release(&sink);
+    queue.flush();
+
+    ASSERT_EQ(sink.written.size(), 3u);
+    EXPECT_EQ(sink.written[0], "insert a");
+    EXPECT_EQ(sink.written[1], "update b");
+    EXPECT_EQ(sink.written[2], "delete a");
+    EXPECT_FALSE(queue.get_pending("t", "a", &op));
+    queue.get_stats(&stats);
+    EXPECT_EQ(stats.depth, 0u);
+    EXPECT_EQ(stats.queued, 3u);
+    EXPECT_EQ(stats.written, 3u);
+    EXPECT_EQ(stats.failed, 0u);
+    queue.stop();
+    std::cout << "Exiting FlushWritesInOrder test" << std::endl;
+}
+
+/**
+* @brief Test that updates of a row waiting in the queue are coalesced
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Block the worker on its first batch | None | The writes after it stay queued | Should Pass |
+* | 02| Push an insert then three updates of a row, then an update and a delete of another | None | The updates of the first row collapse to one, the second row ends as a delete | Should Pass |
+* | 03| Stop the queue | None | The remaining writes are committed before the worker exits | Should Pass |
+*/
+TEST(db_write_queue_t_Test, CoalesceUpdates) {
+    std::cout << "Entering CoalesceUpdates test" << std::endl;
+    test_sink_t sink = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, true, 0, {}, {}};
+    db_write_queue_t queue;
+    db_write_queue_stats_t stats;
+    db_write_op_t op;
+
+    ASSERT_EQ(queue.start(test_write_batch, &sink, 2), 0);
+    // the worker blocks on its first batch, whatever it took, the rest is coalesced
+    EXPECT_EQ(queue.push("t", "x", db_write_op_update, "update x 0"), 0);
+    EXPECT_EQ(queue.push("t", "a", db_write_op_insert, "insert a"), 0);
+    EXPECT_EQ(queue.push("t", "a", db_write_op_update, "update a 1"), 0);
+    EXPECT_EQ(queue.push("t", "a", db_write_op_update, "update a 2"), 0);
+    EXPECT_EQ(queue.push("t", "a", db_write_op_update, "update a 3"), 0);
+    EXPECT_EQ(queue.push("t", "b", db_write_op_update, "update b 1"), 0);
+    EXPECT_EQ(queue.push("t", "b", db_write_op_delete, "delete b"), 0);
+    EXPECT_TRUE(queue.get_pending("t", "b", &op));
+    EXPECT_EQ(op, db_write_op_delete);
+
+    test_sink_release(&sink);
+    queue.stop();
+
+    queue.get_stats(&stats);
+    EXPECT_EQ(stats.queued, 7u);
+    EXPECT_EQ(stats.coalesced, 3u);
+    EXPECT_EQ(stats.written, 4u);
+    EXPECT_EQ(stats.depth, 0u);
+    ASSERT_EQ(sink.written.size(), 4u);
+    EXPECT_EQ(sink.written[1], "insert a");
+    EXPECT_EQ(sink.written[2], "update a 3");
+    EXPECT_EQ(sink.written[3], "delete b");
+    for (unsigned int num : sink.batches) {
+        EXPECT_LE(num, 2u);
+    }
+    std::cout << "Exiting CoalesceUpdates test" << std::endl;
+}
+
+/**
+* @brief Test that consecutive inserts into a table are merged into a multi row insert
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Block the worker on its first batch | None | The writes after it stay queued | Should Pass |
+* | 02| Push three inserts into a table, one into another table, then one more into the first | None | The first three become one insert, each row is pending | Should Pass |
+* | 03| Stop the queue | None | Three inserts are written, the counters count rows | Should Pass |
+* | 04| Push a failing insert of two rows | None | Both rows are counted as failed | Should Pass |
+*/
+TEST(db_write_queue_t_Test, MergeInserts) {
+    std::cout << "Entering MergeInserts test" << std::endl;
+    test_sink_t sink = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, true, 0, {}, {}};
+    db_write_queue_t queue;
+    db_write_queue_stats_t stats;
+    db_write_op_t op;
+
+    ASSERT_EQ(queue.start(test_write_batch, &sink, 8), 0);
+    EXPECT_EQ(queue.push("t", "x", db_write_op_update, "update x"), 0);
+    test_sink_wait_entered(&sink, 1);
+    EXPECT_EQ(queue.push("t", "a", db_write_op_insert, "insert into t (k, v) values(a, 1)"), 0);
+    EXPECT_EQ(queue.push("t", "b", db_write_op_insert, "insert into t (k, v) values(b, 2)"), 0);
+    EXPECT_EQ(queue.push("t", "c", db_write_op_insert, "insert into t (k, v) values(c, 3)"), 0);
+    EXPECT_EQ(queue.push("u", "a", db_write_op_insert, "insert into u (k, v) values(a, 4)"), 0);
+    EXPECT_EQ(queue.push("t", "d", db_write_op_insert, "insert into t (k, v) values(d, 5)"), 0);
+    EXPECT_TRUE(queue.get_pending("t", "b", &op));
+    EXPECT_EQ(op, db_write_op_insert);
+    EXPECT_TRUE(queue.get_pending("t", "c", &op));
+
+    test_sink_release(&sink);
+    queue.flush();
+
+    ASSERT_EQ(sink.written.size(), 4u);
+    EXPECT_EQ(sink.written[1], "insert into t (k, v) values(a, 1), (b, 2), (c, 3)");
+    EXPECT_EQ(sink.written[2], "insert into u (k, v) values(a, 4)");
+    EXPECT_EQ(sink.written[3], "insert into t (k, v) values(d, 5)");
+    EXPECT_FALSE(queue.get_pending("t", "c", &op));
+    queue.get_stats(&stats);
+    EXPECT_EQ(stats.queued, 6u);
+    EXPECT_EQ(stats.merged, 2u);
+    EXPECT_EQ(stats.written, 6u);
+    EXPECT_EQ(stats.depth, 0u);
+
+    pthread_mutex_lock(&sink.lock);
+    sink.blocked = true;
+    pthread_mutex_unlock(&sink.lock);
+    EXPECT_EQ(queue.push("t", "y", db_write_op_update, "update y"), 0);
+    test_sink_wait_entered(&sink, 3);
+    EXPECT_EQ(queue.push("t", "e", db_write_op_insert, "bad into t (k, v) values(e, 6)"), 0);
+    EXPECT_EQ(queue.push("t", "f", db_write_op_insert, "bad into t (k, v) values(f, 7)"), 0);
+    test_sink_release(&sink);
+    queue.stop();
+
+    queue.get_stats(&stats);
+    EXPECT_EQ(stats.failed, 2u);
+    EXPECT_EQ(stats.written, 7u);
+    std::cout << "Exiting MergeInserts test" << std::endl;
+}
@@ -0,0 +1,172 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include "dm_cfg_delta.h"
+
+/**
+* @brief Test that a radio subdoc is told apart by what it changes
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Compare a radio with itself, measurements aside | noise and utilization differ | No change | Should Pass |
+* | 02| Compare an unknown radio | cur = NULL | New, channel and radio | Should Pass |
+* | 03| Change the transmit power, then the BSS color | 20 to 17, 0 to 5 | Channel, then radio | Should Pass |
+* | 04| Move the current operating class to another channel | 36 to 149 | Channel | Should Pass |
+* | 05| Change an operating class that is not the current one | one channel more | Radio | Should Pass |
+*/
+TEST(dm_cfg_delta_t_Test, Radio) {
+    std::cout << "Entering Radio test" << std::endl;
+    em_radio_info_t *cur = new em_radio_info_t, *dec = new em_radio_info_t;
+    em_op_class_info_t op_cur, op_dec;
+
+    memset(cur, 0, sizeof(em_radio_info_t));
+    cur->intf.mac[5] = 0x01;
+    cur->enabled = true;
+    cur->transmit_power_limit = 20;
+    memcpy(dec, cur, sizeof(em_radio_info_t));
+    dec->noise = -90;
+    dec->utilization = 40;
+    EXPECT_EQ(dm_cfg_delta_t::radio(cur, dec), static_cast<unsigned int> (DM_CFG_DELTA_NONE));
+    EXPECT_EQ(dm_cfg_delta_t::radio(NULL, dec), static_cast<unsigned int> (DM_CFG_DELTA_NEW | DM_CFG_DELTA_CHANNEL | DM_CFG_DELTA_RADIO));
+
+    dec->transmit_power_limit = 17;
+    EXPECT_EQ(dm_cfg_delta_t::radio(cur, dec), static_cast<unsigned int> (DM_CFG_DELTA_CHANNEL));
+    dec->transmit_power_limit = 20;
+    dec->bss_color = 5;
+    EXPECT_EQ(dm_cfg_delta_t::radio(cur, dec), static_cast<unsigned int> (DM_CFG_DELTA_RADIO));
+
+    memset(&op_cur, 0, sizeof(op_cur));
+    op_cur.id.type = em_op_class_type_current;
+    op_cur.op_class = 128;
+    op_cur.channel = 36;
+    memcpy(&op_dec, &op_cur, sizeof(op_dec));
+    EXPECT_EQ(dm_cfg_delta_t::op_class(&op_cur, &op_dec), static_cast<unsigned int> (DM_CFG_DELTA_NONE));
+    op_dec.channel = 149;
+    EXPECT_EQ(dm_cfg_delta_t::op_class(&op_cur, &op_dec), static_cast<unsigned int> (DM_CFG_DELTA_CHANNEL));
+
+    op_cur.id.type = em_op_class_type_capability;
+    op_cur.num_channels = 1;
+    op_cur.channels[0] = 36;
+    memcpy(&op_dec, &op_cur, sizeof(op_dec));
+    op_dec.num_channels = 2;
+    op_dec.channels[1] = 40;
+    EXPECT_EQ(dm_cfg_delta_t::op_class(&op_cur, &op_dec), static_cast<unsigned int> (DM_CFG_DELTA_RADIO));
+    EXPECT_EQ(dm_cfg_delta_t::op_class(NULL, &op_dec), static_cast<unsigned int> (DM_CFG_DELTA_NEW | DM_CFG_DELTA_RADIO));
+    delete cur;
+    delete dec;
+    std::cout << "Exiting Radio test" << std::endl;
+}
+
+/**
+* @brief Test that a VAP subdoc only counts as a change when the configuration of a BSS moves
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Compare a BSS with itself, counters aside | numberofsta, bytes sent differ | No change | Should Pass |
+* | 02| Change the SSID, then an AKM | "home" to "guest", "psk" to "sae" | BSS | Should Pass |
+* | 03| Compare an unknown BSS | cur = NULL | New and BSS | Should Pass |
+*/
+TEST(dm_cfg_delta_t_Test, Bss) {
+    std::cout << "Entering Bss test" << std::endl;
+    em_bss_info_t *cur = new em_bss_info_t, *dec = new em_bss_info_t;
+
+    memset(cur, 0, sizeof(em_bss_info_t));
+    cur->bssid.mac[5] = 0x10;
+    snprintf(cur->ssid, sizeof(cur->ssid), "%s", "home");
+    cur->enabled = true;
+    cur->num_fronthaul_akms = 1;
+    snprintf(cur->fronthaul_akm[0], sizeof(cur->fronthaul_akm[0]), "%s", "psk");
+    memcpy(dec, cur, sizeof(em_bss_info_t));
+    dec->numberofsta = 3;
+    dec->unicast_bytes_sent = 1000;
+    EXPECT_EQ(dm_cfg_delta_t::bss(cur, dec), static_cast<unsigned int> (DM_CFG_DELTA_NONE));
+
+    snprintf(dec->ssid, sizeof(dec->ssid), "%s", "guest");
+    EXPECT_EQ(dm_cfg_delta_t::bss(cur, dec), static_cast<unsigned int> (DM_CFG_DELTA_BSS));
+    snprintf(dec->ssid, sizeof(dec->ssid), "%s", "home");
+    snprintf(dec->fronthaul_akm[0], sizeof(dec->fronthaul_akm[0]), "%s", "sae");
+    EXPECT_EQ(dm_cfg_delta_t::bss(cur, dec), static_cast<unsigned int> (DM_CFG_DELTA_BSS));
+    EXPECT_EQ(dm_cfg_delta_t::bss(NULL, dec), static_cast<unsigned int> (DM_CFG_DELTA_NEW | DM_CFG_DELTA_BSS));
+    delete cur;
+    delete dec;
+    std::cout << "Exiting Bss test" << std::endl;
+}
+
+/**
+* @brief Test that a connected backhaul STA moving to another parent is not a reconfiguration
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Change the BSSID of a connected backhaul STA | parent 0x10 to 0x20 | Backhaul | Should Pass |
+* | 02| Change it along with the connection status | connect_status false | BSS | Should Pass |
+* | 03| Change the BSSID of an AP | vap_mode ap | BSS | Should Pass |
+*/
+TEST(dm_cfg_delta_t_Test, BackhaulRoam) {
+    std::cout << "Entering BackhaulRoam test" << std::endl;
+    em_bss_info_t *cur = new em_bss_info_t, *dec = new em_bss_info_t;
+
+    memset(cur, 0, sizeof(em_bss_info_t));
+    cur->vap_mode = em_vap_mode_sta;
+    cur->bssid.mac[5] = 0x10;
+    cur->enabled = true;
+    cur->connect_status = true;
+    memcpy(dec, cur, sizeof(em_bss_info_t));
+    dec->bssid.mac[5] = 0x20;
+    EXPECT_EQ(dm_cfg_delta_t::bss(cur, dec), static_cast<unsigned int> (DM_CFG_DELTA_BACKHAUL));
+
+    dec->connect_status = false;
+    EXPECT_EQ(dm_cfg_delta_t::bss(cur, dec), static_cast<unsigned int> (DM_CFG_DELTA_BSS));
+
+    cur->vap_mode = em_vap_mode_ap;
+    dec->vap_mode = em_vap_mode_ap;
+    dec->connect_status = true;
+    EXPECT_EQ(dm_cfg_delta_t::bss(cur, dec), static_cast<unsigned int> (DM_CFG_DELTA_BSS));
+    delete cur;
+    delete dec;
+    std::cout << "Exiting BackhaulRoam test" << std::endl;
+}
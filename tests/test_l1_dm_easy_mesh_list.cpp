@@ -4791,4 +4791,302 @@ TEST_F(dm_easy_mesh_list_tTEST, get_next_network_ssid_positive)
     ASSERT_NE(next, nullptr);
     EXPECT_STRNE((char*)first->m_network_ssid_info.ssid, (char*)next->m_network_ssid_info.ssid);
     std::cout << "Exiting get_next_network_ssid_positive test" << std::endl;
-}
\ No newline at end of file
+}
+/**
+ * @brief Verify that the get_next_sta walk and the range for walk return every STA once and in the same order
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 149@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Put 2 STAs in dm1, none in dm2 and 1 STA in dm3 | sta[0..2] | STAs stored | Should be successful |
+ * | 02 | Walk the STAs with get_first_sta/get_next_sta | None | 3 distinct STAs, dm2 does not end the walk | Should Pass |
+ * | 03 | Walk the STAs with walk_stas(), nesting a full walk inside | None | Same STAs in the same order, the nested walk does not disturb the outer one | Should Pass |
+ */
+TEST_F(dm_easy_mesh_list_tTEST, walk_stas_matches_get_next_sta)
+{
+    std::cout << "Entering walk_stas_matches_get_next_sta test" << std::endl;
+    dm_sta_t sta[3];
+    dm_sta_t *walked[3];
+    dm_map_key_t key;
+    unsigned char sta_mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x00};
+    unsigned int i, num = 0, inner;
+
+    for (i = 0; i < 3; i++) {
+        sta[i].init();
+        sta_mac[5] = static_cast<unsigned char>(i);
+        memcpy(sta[i].m_sta_info.id, sta_mac, sizeof(mac_address_t));
+        dm_key_map_t::sta_key(&key, sta_mac, mac3, mac3);
+        ((i < 2) ? dm1:dm3)->m_sta_map->put(&key, &sta[i]);
+    }
+
+    for (dm_sta_t *psta = list.get_first_sta(); psta != NULL; psta = list.get_next_sta(psta)) {
+        ASSERT_LT(num, 3u);
+        walked[num++] = psta;
+    }
+    ASSERT_EQ(num, 3u);
+    EXPECT_NE(walked[0], walked[1]);
+    EXPECT_NE(walked[1], walked[2]);
+    EXPECT_NE(walked[0], walked[2]);
+
+    num = 0;
+    for (dm_sta_t *psta : list.walk_stas()) {
+        ASSERT_LT(num, 3u);
+        EXPECT_EQ(psta, walked[num]);
+        num++;
+        inner = 0;
+        for (dm_sta_t *other : list.walk_stas()) {
+            (void)other;
+            inner++;
+        }
+        EXPECT_EQ(inner, 3u);
+    }
+    EXPECT_EQ(num, 3u);
+    std::cout << "Exiting walk_stas_matches_get_next_sta test" << std::endl;
+}
+
+/**
+ * @brief Verify that get_next_device continues from any device, not only the one it returned last
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 150@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Walk the devices with walk_devices() | 4 data models | 4 devices | Should Pass |
+ * | 02 | Call get_next_device on the first device after walking to the last one | None | The second device is returned | Should Pass |
+ */
+TEST_F(dm_easy_mesh_list_tTEST, get_next_device_from_any_device)
+{
+    std::cout << "Entering get_next_device_from_any_device test" << std::endl;
+    dm_device_t *devs[4];
+    unsigned int num = 0;
+
+    for (dm_device_t *dev : list.walk_devices()) {
+        ASSERT_LT(num, 4u);
+        devs[num++] = dev;
+    }
+    ASSERT_EQ(num, 4u);
+
+    EXPECT_EQ(list.get_first_device(), devs[0]);
+    EXPECT_EQ(list.get_next_device(devs[2]), devs[3]);
+    EXPECT_EQ(list.get_next_device(devs[3]), nullptr);
+    EXPECT_EQ(list.get_next_device(devs[0]), devs[1]);
+    std::cout << "Exiting get_next_device_from_any_device test" << std::endl;
+}
+
+/**
+ * @brief Verify that the radio and BSS lookups by MAC follow radios and BSSs across data models
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 151@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Give dm3 a radio and a BSS, put a STA on them | ruid = 02:00:00:00:00:01, bssid = 02:00:00:00:00:02 | get_radio_by_mac, get_radio, get_bss_by_mac and get_sta find them in dm3 | Should Pass |
+ * | 02 | Move the radio and the BSS to dm4 | None | The lookups return the objects of dm4 | Should Pass |
+ * | 03 | Remove the radio and the BSS from dm4 | None | The lookups return NULL | Should Pass |
+ */
+TEST_F(dm_easy_mesh_list_tTEST, get_radio_and_bss_by_mac_follow_data_models)
+{
+    std::cout << "Entering get_radio_and_bss_by_mac_follow_data_models test" << std::endl;
+    unsigned char ruid[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+    unsigned char bssid[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02};
+    unsigned char sta_mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x03};
+    char ruid_str[18], key[256];
+    dm_sta_t sta;
+
+    dm3->m_num_radios = 1;
+    memcpy(dm3->m_radio[0].m_radio_info.intf.mac, ruid, sizeof(mac_address_t));
+    dm3->m_num_bss = 1;
+    memcpy(dm3->m_bss[0].m_bss_info.bssid.mac, bssid, sizeof(mac_address_t));
+    mac_to_string(ruid, ruid_str);
+    EXPECT_EQ(list.get_radio_by_mac(ruid), &dm3->m_radio[0]);
+    EXPECT_EQ(list.get_radio(ruid_str), &dm3->m_radio[0]);
+    EXPECT_EQ(list.get_bss_by_mac(bssid), &dm3->m_bss[0]);
+
+    sta.init();
+    memcpy(sta.m_sta_info.id, sta_mac, sizeof(mac_address_t));
+    build_sta_key(sta_mac, bssid, ruid, key);
+    list.put_sta(key, &sta);
+    ASSERT_NE(list.get_sta(key), nullptr);
+    EXPECT_EQ(memcmp(list.get_sta(key)->m_sta_info.id, sta_mac, sizeof(mac_address_t)), 0);
+
+    dm3->m_num_radios = 0;
+    dm3->m_num_bss = 0;
+    dm4->m_num_radios = 1;
+    memcpy(dm4->m_radio[0].m_radio_info.intf.mac, ruid, sizeof(mac_address_t));
+    dm4->m_num_bss = 1;
+    memcpy(dm4->m_bss[0].m_bss_info.bssid.mac, bssid, sizeof(mac_address_t));
+    EXPECT_EQ(list.get_radio_by_mac(ruid), &dm4->m_radio[0]);
+    EXPECT_EQ(list.get_bss_by_mac(bssid), &dm4->m_bss[0]);
+    EXPECT_EQ(list.get_sta(key), nullptr);
+
+    dm4->m_num_radios = 0;
+    dm4->m_num_bss = 0;
+    EXPECT_EQ(list.get_radio_by_mac(ruid), nullptr);
+    EXPECT_EQ(list.get_bss_by_mac(bssid), nullptr);
+    std::cout << "Exiting get_radio_and_bss_by_mac_follow_data_models test" << std::endl;
+}
+
+/**
+ * @brief Verify that data models and the list report the generation of their last change
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 152@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Mark a device of dm3 for update | db_cfg_type_device_list_update | dm3 is newer than the list and dm4, the list generation is unchanged | Should Pass |
+ * | 02 | Mark a STA of dm4 dirty | None | dm4 is newer than dm3 | Should Pass |
+ * | 03 | Create a data model | mac = 02:00:00:00:00:05 | The list is newer than dm3 and dm4 | Should Pass |
+ */
+TEST_F(dm_easy_mesh_list_tTEST, generation_follows_changes)
+{
+    std::cout << "Entering generation_follows_changes test" << std::endl;
+    unsigned char mac5[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x05};
+    unsigned int list_gen = list.get_generation();
+    em_interface_t intf5;
+    dm_sta_t sta;
+
+    EXPECT_GE(dm_easy_mesh_t::get_last_generation(), list_gen);
+
+    dm3->set_db_cfg_param(db_cfg_type_device_list_update, "");
+    EXPECT_GT(dm3->get_generation(), list_gen);
+    EXPECT_GT(dm3->get_generation(), dm4->get_generation());
+    EXPECT_EQ(list.get_generation(), list_gen);
+    EXPECT_EQ(dm_easy_mesh_t::get_last_generation(), dm3->get_generation());
+
+    sta.init();
+    dm4->set_sta_dirty(&sta);
+    EXPECT_GT(dm4->get_generation(), dm3->get_generation());
+
+    memcpy(intf5.mac, mac5, 6);
+    strcpy(intf5.name, "eth4");
+    ASSERT_NE(list.create_data_model("Network2", &intf5, em_profile_type_3, false), nullptr);
+    EXPECT_GT(list.get_generation(), dm4->get_generation());
+    list.delete_data_model("Network2", mac5);
+    std::cout << "Exiting generation_follows_changes test" << std::endl;
+}
+
+/**
+ * @brief Verify that data models are found by network and AL MAC, also right after being created or deleted
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 153@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Look up a device that does not exist yet, twice | net_id = "Network3", mac = 02:00:00:00:00:06 | nullptr both times | Should Pass |
+ * | 02 | Create it in two networks | net_id = "Network3", "Network4" | Each network returns its own data model | Should Pass |
+ * | 03 | Delete it from one network | net_id = "Network3" | That network returns nullptr, the other still its data model | Should Pass |
+ */
+TEST_F(dm_easy_mesh_list_tTEST, get_data_model_by_network_and_mac)
+{
+    std::cout << "Entering get_data_model_by_network_and_mac test" << std::endl;
+    unsigned char mac6[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x06};
+    em_interface_t intf6;
+    dm_easy_mesh_t *net3, *net4;
+
+    EXPECT_EQ(list.get_data_model("Network3", mac6), nullptr);
+    EXPECT_EQ(list.get_data_model("Network3", mac6), nullptr);
+
+    memcpy(intf6.mac, mac6, 6);
+    strcpy(intf6.name, "eth5");
+    ASSERT_NE(net3 = list.create_data_model("Network3", &intf6, em_profile_type_3, false), nullptr);
+    ASSERT_NE(net4 = list.create_data_model("Network4", &intf6, em_profile_type_3, false), nullptr);
+    EXPECT_NE(net3, net4);
+    EXPECT_EQ(list.get_data_model("Network3", mac6), net3);
+    EXPECT_EQ(list.get_data_model("Network4", mac6), net4);
+    EXPECT_EQ(list.get_data_model("Network1", mac6), nullptr);
+
+    list.delete_data_model("Network3", mac6);
+    EXPECT_EQ(list.get_data_model("Network3", mac6), nullptr);
+    EXPECT_EQ(list.get_data_model("Network4", mac6), net4);
+    list.delete_data_model("Network4", mac6);
+    std::cout << "Exiting get_data_model_by_network_and_mac test" << std::endl;
+}
+
+/**
+ * @brief Verify that an agent created again right after its removal gets its data model back
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 154@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Create an agent data model with a radio, delete it | net_id = "Network1", mac = 02:00:00:00:00:07 | The data model is no longer found | Should Pass |
+ * | 02 | Create it again with another profile | profile = em_profile_type_2 | Same data model, radio kept, new profile, device rows to be written again | Should Pass |
+ * | 03 | Delete and create a colocated data model | mac = 02:00:00:00:00:08, colocated = true | Created from scratch, no radio | Should Pass |
+ */
+TEST_F(dm_easy_mesh_list_tTEST, create_data_model_reuses_removed_agent)
+{
+    std::cout << "Entering create_data_model_reuses_removed_agent test" << std::endl;
+    unsigned char mac7[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x07};
+    unsigned char mac8[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x08};
+    em_interface_t intf7, intf8;
+    dm_easy_mesh_t *dm, *again;
+
+    memcpy(intf7.mac, mac7, 6);
+    strcpy(intf7.name, "eth6");
+    ASSERT_NE(dm = list.create_data_model("Network1", &intf7, em_profile_type_3, false), nullptr);
+    dm->set_num_radios(1);
+    list.delete_data_model("Network1", mac7);
+    EXPECT_EQ(list.get_data_model("Network1", mac7), nullptr);
+
+    ASSERT_NE(again = list.create_data_model("Network1", &intf7, em_profile_type_2, false), nullptr);
+    EXPECT_EQ(again, dm);
+    EXPECT_EQ(again->get_num_radios(), 1u);
+    EXPECT_EQ(again->get_device()->m_device_info.profile, em_profile_type_2);
+    EXPECT_TRUE(again->db_cfg_type_is_set(db_cfg_type_device_list_update));
+    EXPECT_FALSE(again->db_cfg_type_is_set(db_cfg_type_device_list_delete));
+    EXPECT_EQ(list.get_data_model("Network1", mac7), again);
+    list.delete_data_model("Network1", mac7);
+
+    memcpy(intf8.mac, mac8, 6);
+    strcpy(intf8.name, "eth7");
+    ASSERT_NE(dm = list.create_data_model("Network1", &intf8, em_profile_type_3, true), nullptr);
+    dm->set_num_radios(1);
+    list.delete_data_model("Network1", mac8);
+    ASSERT_NE(again = list.create_data_model("Network1", &intf8, em_profile_type_3, true), nullptr);
+    EXPECT_EQ(again->get_num_radios(), 0u);
+    list.delete_data_model("Network1", mac8);
+    std::cout << "Exiting create_data_model_reuses_removed_agent test" << std::endl;
+}
@@ -0,0 +1,100 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include "dm_easy_mesh.h"
+#include "em_hex.h"
+#include "test_l1_utils.h"
+
+/**
+* @brief Test that an affiliated AP leaving its AP MLD detaches its link only
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| AP MLD with BSSs 1 and 2, a STA MLD linked to both | AP MLD 100, STA MLD 200 | Set up | Should Pass |
+* | 02| Affiliated AP of BSS 1 removed | BSS 1 | 2 changes, BSS 1 out of the MLD, BSS 2 kept | Should Pass |
+* | 03| STA MLD looked up | STA MLD 200 | Still associated, link to BSS 2 only | Should Pass |
+* | 04| Same affiliated AP removed again | BSS 1 | Nothing changed | Should Pass |
+* | 05| Affiliated AP of BSS 2 removed with another AP MLD MAC | AP MLD 101 | BSS 2 kept in its MLD, its STA link dropped | Should Pass |
+*/
+TEST(dm_easy_mesh_t_Test, RemoveAffiliatedAp) {
+    std::cout << "Entering RemoveAffiliatedAp test" << std::endl;
+    dm_easy_mesh_t dm;
+    em_assoc_sta_mld_info_t sta_mld;
+    em_assoc_sta_mld_info_t *found;
+    em_affiliated_ap_info_t ap;
+    mac_address_t ruid, ap_mld, other_mld;
+    unsigned int i;
+
+    make_mac(1000, ruid);
+    make_mac(100, ap_mld);
+    make_mac(101, other_mld);
+    for (i = 0; i < 2; i++) {
+        memset(&dm.m_bss[i].m_bss_info, 0, sizeof(em_bss_info_t));
+        memcpy(dm.m_bss[i].m_bss_info.ruid.mac, ruid, sizeof(mac_address_t));
+        make_mac(i + 1, dm.m_bss[i].m_bss_info.bssid.mac);
+        memcpy(dm.m_bss[i].m_bss_info.mld_mac, ap_mld, sizeof(mac_address_t));
+    }
+    dm.set_num_bss(2);
+
+    memset(&sta_mld, 0, sizeof(sta_mld));
+    make_mac(200, sta_mld.mac_addr);
+    memcpy(sta_mld.ap_mld_mac_addr, ap_mld, sizeof(mac_address_t));
+    sta_mld.num_affiliated_sta = 2;
+    for (i = 0; i < 2; i++) {
+        make_mac(i + 1, sta_mld.affiliated_sta[i].bssid);
+        make_mac(i + 201, sta_mld.affiliated_sta[i].mac_addr);
+    }
+    dm.update_assoc_sta_mld_info(&sta_mld);
+    ASSERT_EQ(dm.get_num_assoc_sta_mld(), 1u);
+
+    memset(&ap, 0, sizeof(ap));
+    memcpy(ap.ruid.mac, ruid, sizeof(mac_address_t));
+    make_mac(1, ap.mac_addr);
+    ap.mac_addr_valid = true;
+    EXPECT_EQ(dm.remove_affiliated_ap(ap_mld, &ap), 2u);
+    EXPECT_EQ(em_hex::pack_mac(dm.m_bss[0].m_bss_info.mld_mac), 0u);
+    EXPECT_TRUE(em_hex::mac_equal(dm.m_bss[1].m_bss_info.mld_mac, ap_mld));
+
+    found = dm.find_assoc_sta_mld(sta_mld.mac_addr);
+    ASSERT_NE(found, nullptr);
+    ASSERT_EQ(found->num_affiliated_sta, 1);
+    EXPECT_TRUE(em_hex::mac_equal(found->affiliated_sta[0].bssid, dm.m_bss[1].m_bss_info.bssid.mac));
+    EXPECT_EQ(dm.get_num_assoc_sta_mld(), 1u);
+
+    EXPECT_EQ(dm.remove_affiliated_ap(ap_mld, &ap), 0u);
+
+    make_mac(2, ap.mac_addr);
+    EXPECT_EQ(dm.remove_affiliated_ap(other_mld, &ap), 1u);
+    EXPECT_TRUE(em_hex::mac_equal(dm.m_bss[1].m_bss_info.mld_mac, ap_mld));
+    found = dm.find_assoc_sta_mld(sta_mld.mac_addr);
+    ASSERT_NE(found, nullptr);
+    EXPECT_EQ(found->num_affiliated_sta, 0);
+    std::cout << "Exiting RemoveAffiliatedAp test" << std::endl;
+}
@@ -0,0 +1,265 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <string>
+#include "dm_json_writer.h"
+
+// members of a station like object, written the same way to a streaming and to a tree writer
+static void write_members(dm_json_writer_t& writer)
+{
+    writer.add_string("MACAddress", "aa:bb:cc:dd:ee:ff");
+    writer.add_string("Escaped", "a\"b\\c\n\t\x01/");
+    writer.add_string("Empty", NULL);
+    writer.add_number("Rssi", -61);
+    writer.add_number("Zero", 0);
+    writer.add_number("Half", 0.5);
+    writer.add_number("Large", 3000000000.0);
+    writer.add_number("Tiny", 1.0 / 3);
+    writer.add_bool("Associated", true);
+    writer.add_bool("Steered", false);
+    writer.begin_object("ClientSteer");
+    writer.begin_object("RequestMode");
+    writer.add_bool("Disassoc", true);
+    writer.end_object();
+    writer.end_object();
+    writer.begin_array("Neighbors");
+    writer.begin_object();
+    writer.add_number("Channel", 36);
+    writer.end_object();
+    writer.add_string(NULL, "row");
+    writer.begin_array();
+    writer.end_array();
+    writer.end_array();
+}
+
+struct sink_data_t {
+    std::string out;
+    unsigned int calls;
+    bool fail;
+};
+
+static int write_sink(void *arg, const char *data, size_t len)
+{
+    sink_data_t *sink = static_cast<sink_data_t *>(arg);
+
+    if (sink->fail == true) {
+        return -1;
+    }
+    sink->out.append(data, len);
+    sink->calls++;
+
+    return 0;
+}
+
+/**
+* @brief Test that the streaming writer produces the text cJSON prints for the same tree
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Write the members to a tree writer on an object | strings, numbers, booleans, nested containers | No error | Should Pass |
+* | 02| Write the same members to a streaming writer | same data | Equal to cJSON_PrintUnformatted of the tree | Should Pass |
+*/
+TEST(dm_json_writer_t_Test, StreamMatchesTree) {
+    std::cout << "Entering StreamMatchesTree test" << std::endl;
+    cJSON *obj = cJSON_CreateObject();
+    dm_json_writer_t tree(obj);
+    dm_json_writer_t stream;
+    char *str;
+
+    write_members(tree);
+    EXPECT_FALSE(tree.has_error());
+    EXPECT_TRUE(tree.is_tree());
+
+    EXPECT_EQ(stream.begin_object(), 0);
+    write_members(stream);
+    EXPECT_EQ(stream.end_object(), 0);
+    EXPECT_FALSE(stream.has_error());
+
+    str = cJSON_PrintUnformatted(obj);
+    EXPECT_STREQ(stream.get_str(), str);
+    EXPECT_EQ(stream.get_len(), strlen(str));
+    cJSON_free(str);
+    cJSON_Delete(obj);
+    std::cout << "Exiting StreamMatchesTree test" << std::endl;
+}
+
+/**
+* @brief Test that misplaced writes are reported and reset makes the writer reusable
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Write a member without a key | open object | Error | Should Pass |
+* | 02| Close an array while an object is open | open object | -1 and error | Should Pass |
+* | 03| Reset and write an array | two rows | No error, compact array | Should Pass |
+* | 04| Close the container of a tree writer | array container | -1 and error | Should Pass |
+*/
+TEST(dm_json_writer_t_Test, ErrorsAndReset) {
+    std::cout << "Entering ErrorsAndReset test" << std::endl;
+    dm_json_writer_t writer;
+    cJSON *arr = cJSON_CreateArray();
+    dm_json_writer_t tree(arr);
+
+    writer.begin_object();
+    writer.add_number(NULL, 1);
+    EXPECT_TRUE(writer.has_error());
+
+    writer.reset();
+    writer.begin_object();
+    EXPECT_EQ(writer.end_array(), -1);
+    EXPECT_TRUE(writer.has_error());
+
+    writer.reset();
+    EXPECT_STREQ(writer.get_str(), "");
+    writer.begin_array();
+    writer.add_number(NULL, 1);
+    writer.add_string("ignored", "x");
+    writer.end_array();
+    EXPECT_FALSE(writer.has_error());
+    EXPECT_STREQ(writer.get_str(), "[1,\"x\"]");
+
+    tree.add_number(NULL, 7);
+    EXPECT_EQ(cJSON_GetArraySize(arr), 1);
+    EXPECT_EQ(tree.end_array(), -1);
+    EXPECT_TRUE(tree.has_error());
+    cJSON_Delete(arr);
+    std::cout << "Exiting ErrorsAndReset test" << std::endl;
+}
+
+/**
+* @brief Test that a writer with a sink hands the output over in bounded chunks
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Write an array larger than the flush length and flush | 1000 station objects | Sink called several times, output equal to the buffered writer | Should Pass |
+* | 02| Write to a sink that fails | 1000 station objects | Error, flush returns -1 | Should Pass |
+*/
+TEST(dm_json_writer_t_Test, SinkFlush) {
+    std::cout << "Entering SinkFlush test" << std::endl;
+    sink_data_t sink = {"", 0, false}, failing = {"", 0, true};
+    dm_json_writer_t writer(write_sink, &sink), bad(write_sink, &failing), ref;
+    dm_json_writer_t *all[] = {&writer, &bad, &ref};
+    unsigned int i, w;
+
+    for (w = 0; w < 3; w++) {
+        all[w]->begin_array();
+        for (i = 0; i < 1000; i++) {
+            all[w]->begin_object();
+            write_members(*all[w]);
+            all[w]->end_object();
+        }
+        all[w]->end_array();
+    }
+    EXPECT_LE(writer.get_len(), static_cast<size_t>(DM_JSON_WRITER_FLUSH_LEN));
+
+    EXPECT_EQ(writer.flush(), 0);
+    EXPECT_EQ(writer.get_len(), 0u);
+    EXPECT_GT(sink.calls, 1u);
+    EXPECT_FALSE(writer.has_error());
+    EXPECT_EQ(sink.out, std::string(ref.get_str()));
+
+    EXPECT_TRUE(bad.has_error());
+    EXPECT_EQ(bad.flush(), -1);
+    std::cout << "Exiting SinkFlush test" << std::endl;
+}
+
+/**
+* @brief Test that a cJSON tree streamed through the writer is the text cJSON prints for it
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Stream a tree to a sink | members, a null, a raw list, 1000 rows | Equal to cJSON_PrintUnformatted of the tree | Should Pass |
+* | 02| Add the tree to a tree writer | same tree | A copy equal to the tree | Should Pass |
+* | 03| Stream a tree whose top is not a container | string | Error | Should Pass |
+*/
+TEST(dm_json_writer_t_Test, TreeStreamsAsPrinted) {
+    std::cout << "Entering TreeStreamsAsPrinted test" << std::endl;
+    sink_data_t sink = {"", 0, false};
+    dm_json_writer_t writer(write_sink, &sink), leaf;
+    cJSON *obj = cJSON_CreateObject(), *rows, *copy = cJSON_CreateObject(), *str;
+    dm_json_writer_t tree(copy);
+    dm_json_writer_t members(obj);
+    unsigned int i;
+    char *text;
+
+    write_members(members);
+    cJSON_AddNullToObject(obj, "Null");
+    cJSON_AddRawToObject(obj, "STAList", "[{\"MACAddress\":\"00:11:22:33:44:55\"}]");
+    rows = cJSON_AddArrayToObject(obj, "Rows");
+    for (i = 0; i < 1000; i++) {
+        cJSON_AddItemToArray(rows, cJSON_CreateNumber(i * 1.5));
+    }
+
+    writer.add_tree(NULL, obj);
+    EXPECT_EQ(writer.flush(), 0);
+    EXPECT_GT(sink.calls, 1u);
+    text = cJSON_PrintUnformatted(obj);
+    EXPECT_EQ(sink.out, std::string(text));
+    cJSON_free(text);
+
+    tree.add_tree("Result", obj);
+    EXPECT_FALSE(tree.has_error());
+    EXPECT_TRUE(cJSON_Compare(cJSON_GetObjectItem(copy, "Result"), obj, true));
+
+    str = cJSON_CreateString("top");
+    leaf.add_tree(NULL, str);
+    EXPECT_TRUE(leaf.has_error());
+
+    cJSON_Delete(str);
+    cJSON_Delete(copy);
+    cJSON_Delete(obj);
+    std::cout << "Exiting TreeStreamsAsPrinted test" << std::endl;
+}
@@ -0,0 +1,283 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include "dm_key_map.h"
+
+static void make_sta_key(unsigned int n, dm_map_key_t *key)
+{
+    mac_address_t sta = {0x02, 0xaa, 0x00, 0x00, 0x00, 0x00}, bssid = {0x02, 0xbb, 0x00, 0x00, 0x00, 0x01};
+    mac_address_t ruid = {0x02, 0xcc, 0x00, 0x00, 0x00, 0x01};
+
+    sta[4] = static_cast<unsigned char>(n >> 8);
+    sta[5] = static_cast<unsigned char>(n);
+    // a few BSSes, as on a real radio
+    bssid[5] = static_cast<unsigned char>(n % 4);
+    dm_key_map_t::sta_key(key, sta, bssid, ruid);
+}
+
+static void *make_val(unsigned int n)
+{
+    return reinterpret_cast<void *>(static_cast<uintptr_t>((n + 1) * 16));
+}
+
+/**
+* @brief Test that iteration follows insertion order across removals and table growth
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Put 500 STA keys | None | count is 500, each key maps to its value, get_first/get_next visit them in insertion order | Should Pass |
+* | 02| Remove every third key while iterating, advancing before the removal | None | The remaining keys are still found and visited in order | Should Pass |
+* | 03| Put a new value under an existing key | None | The old value is returned, the key keeps its position | Should Pass |
+*/
+TEST(dm_key_map_t_Test, InsertionOrder) {
+    std::cout << "Entering InsertionOrder test" << std::endl;
+    const unsigned int num = 500;
+    dm_key_map_t map;
+    dm_map_key_t key;
+    void *val, *next;
+    unsigned int i;
+
+    EXPECT_EQ(map.get_first(), nullptr);
+    for (i = 0; i < num; i++) {
+        make_sta_key(i, &key);
+        ASSERT_EQ(map.put(&key, make_val(i)), nullptr);
+    }
+    EXPECT_EQ(map.count(), num);
+
+    for (i = 0, val = map.get_first(); val != NULL; i++, val = map.get_next(val)) {
+        ASSERT_EQ(val, make_val(i));
+        make_sta_key(i, &key);
+        EXPECT_EQ(map.get(&key), val);
+    }
+    EXPECT_EQ(i, num);
+
+    for (i = 0, val = map.get_first(); val != NULL; i++, val = next) {
+        next = map.get_next(val);
+        if ((i % 3) == 0) {
+            make_sta_key(i, &key);
+            EXPECT_EQ(map.remove(&key), val);
+            EXPECT_EQ(map.remove(&key), nullptr);
+        }
+    }
+    EXPECT_EQ(map.count(), num - ((num + 2) / 3));
+
+    for (i = 0, val = map.get_first(); i < num; i++) {
+        make_sta_key(i, &key);
+        if ((i % 3) == 0) {
+            EXPECT_EQ(map.get(&key), nullptr);
+            continue;
+        }
+        ASSERT_EQ(val, make_val(i));
+        val = map.get_next(val);
+    }
+    EXPECT_EQ(val, nullptr);
+
+    make_sta_key(1, &key);
+    EXPECT_EQ(map.put(&key, make_val(num)), make_val(1));
+    EXPECT_EQ(map.get(&key), make_val(num));
+    EXPECT_EQ(map.get_first(), make_val(num));
+    EXPECT_EQ(map.get_next(make_val(num)), make_val(2));
+    EXPECT_EQ(map.get_next(make_val(1)), nullptr);
+
+    map.clear();
+    EXPECT_EQ(map.count(), 0u);
+    EXPECT_EQ(map.get(&key), nullptr);
+    std::cout << "Exiting InsertionOrder test" << std::endl;
+}
+
+/**
+* @brief Test that scan result keys tell apart scanner, op class, channel and scanner type
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Put scan results differing in one field each | None | Each is found under its own key | Should Pass |
+* | 02| Build the key of an id with another network, then another device | None | The network is not part of the key, the device is | Should Pass |
+*/
+TEST(dm_key_map_t_Test, ScanResultKey) {
+    std::cout << "Entering ScanResultKey test" << std::endl;
+    dm_key_map_t map;
+    dm_map_key_t key, other;
+    em_scan_result_id_t id;
+    void *vals[4] = {make_val(0), make_val(1), make_val(2), make_val(3)};
+    unsigned int i;
+
+    memset(&id, 0, sizeof(id));
+    strncpy(id.net_id, "OneWifiMesh", sizeof(id.net_id) - 1);
+    id.scanner_mac[5] = 1;
+    id.op_class = 115;
+    id.channel = 36;
+    id.scanner_type = em_scanner_type_radio;
+
+    for (i = 0; i < 4; i++) {
+        em_scan_result_id_t tmp = id;
+        tmp.scanner_mac[5] = static_cast<unsigned char>(tmp.scanner_mac[5] + ((i == 1) ? 1:0));
+        tmp.op_class = static_cast<unsigned char>(tmp.op_class + ((i == 2) ? 1:0));
+        tmp.channel = static_cast<unsigned char>(tmp.channel + ((i == 3) ? 4:0));
+        dm_key_map_t::scan_result_key(&key, &tmp);
+        ASSERT_EQ(map.put(&key, vals[i]), nullptr);
+    }
+    EXPECT_EQ(map.count(), 4u);
+
+    id.scanner_type = em_scanner_type_sta;
+    dm_key_map_t::scan_result_key(&key, &id);
+    EXPECT_EQ(map.get(&key), nullptr);
+
+    id.scanner_type = em_scanner_type_radio;
+    dm_key_map_t::scan_result_key(&key, &id);
+    EXPECT_EQ(map.get(&key), vals[0]);
+
+    strncpy(id.net_id, "OtherMesh", sizeof(id.net_id) - 1);
+    dm_key_map_t::scan_result_key(&other, &id);
+    EXPECT_EQ(memcmp(&key, &other, sizeof(dm_map_key_t)), 0);
+
+    id.dev_mac[0] = 0x02;
+    dm_key_map_t::scan_result_key(&other, &id);
+    EXPECT_EQ(map.get(&other), nullptr);
+    std::cout << "Exiting ScanResultKey test" << std::endl;
+}
+
+/**
+* @brief Test that a copy shares the storage of its source until either of them changes
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Copy a map of 500 STAs into two empty maps | None | All keys found in both copies, in the same order | Should Pass |
+* | 02| Remove a key from the source, add one to a copy | None | Only the map changed sees the change | Should Pass |
+* | 03| Destroy the source, then copy into a map that has keys | None | The copies still hold their keys, the keys are merged | Should Pass |
+*/
+TEST(dm_key_map_t_Test, SharedCopy) {
+    std::cout << "Entering SharedCopy test" << std::endl;
+    const unsigned int num = 500;
+    dm_key_map_t *src = new dm_key_map_t();
+    dm_key_map_t copy, other, merged;
+    dm_map_key_t key, extra;
+    void *val;
+    unsigned int i;
+
+    for (i = 0; i < num; i++) {
+        make_sta_key(i, &key);
+        ASSERT_EQ(src->put(&key, make_val(i)), nullptr);
+    }
+    ASSERT_EQ(copy.copy_from(*src), 0);
+    ASSERT_EQ(other.copy_from(*src), 0);
+    EXPECT_EQ(copy.count(), num);
+    for (i = 0, val = copy.get_first(); val != NULL; i++, val = copy.get_next(val)) {
+        ASSERT_EQ(val, make_val(i));
+    }
+    EXPECT_EQ(i, num);
+
+    make_sta_key(7, &key);
+    EXPECT_EQ(src->remove(&key), make_val(7));
+    EXPECT_EQ(src->get(&key), nullptr);
+    EXPECT_EQ(copy.get(&key), make_val(7));
+    EXPECT_EQ(other.get(&key), make_val(7));
+
+    make_sta_key(num, &extra);
+    EXPECT_EQ(copy.put(&extra, make_val(num)), nullptr);
+    EXPECT_EQ(copy.get(&extra), make_val(num));
+    EXPECT_EQ(other.get(&extra), nullptr);
+    EXPECT_EQ(src->get(&extra), nullptr);
+
+    delete src;
+    EXPECT_EQ(other.count(), num);
+    EXPECT_EQ(other.get(&key), make_val(7));
+
+    make_sta_key(num + 1, &extra);
+    ASSERT_EQ(merged.put(&extra, make_val(num + 1)), nullptr);
+    ASSERT_EQ(merged.copy_from(other), 0);
+    EXPECT_EQ(merged.count(), num + 1);
+    EXPECT_EQ(merged.get_first(), make_val(num + 1));
+    EXPECT_EQ(merged.get(&key), make_val(7));
+    std::cout << "Exiting SharedCopy test" << std::endl;
+}
+
+/**
+* @brief Test that keys stay reachable through long runs of puts and removals
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Put and remove 1000 keys in a scrambled order for 20000 rounds | None | Each key is found exactly while it is in the map, count matches | Should Pass |
+*/
+TEST(dm_key_map_t_Test, Churn) {
+    std::cout << "Entering Churn test" << std::endl;
+    const unsigned int num = 1000;
+    dm_key_map_t map;
+    dm_map_key_t key;
+    bool present[num] = {false};
+    unsigned int i, n, count = 0, seed = 12345;
+
+    for (i = 0; i < 20000; i++) {
+        seed = (seed * 1103515245u) + 12345u;
+        n = (seed >> 8) % num;
+        make_sta_key(n, &key);
+        if (present[n] == true) {
+            ASSERT_EQ(map.remove(&key), make_val(n));
+            count--;
+        } else {
+            ASSERT_EQ(map.put(&key, make_val(n)), nullptr);
+            count++;
+        }
+        present[n] = !present[n];
+    }
+    EXPECT_EQ(map.count(), count);
+    for (n = 0; n < num; n++) {
+        make_sta_key(n, &key);
+        EXPECT_EQ(map.get(&key), (present[n] == true) ? make_val(n):nullptr);
+    }
+    std::cout << "Exiting Churn test" << std::endl;
+}
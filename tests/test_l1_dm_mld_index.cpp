@@ -0,0 +1,112 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include "dm_mld_index.h"
+
+/**
+* @brief Test that MLDs and their links are found by MAC address
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Index an MLD and two links | idx = 3, links 0 and 1 | MLD and links found with their indexes | Should Pass |
+* | 02| Index a zero MAC | 00:00:00:00:00:00 | Not indexed | Should Pass |
+* | 03| Look up an unknown MAC | 02:00:00:00:00:09 | Not found | Should Pass |
+*/
+TEST(dm_mld_index_t_Test, Find) {
+    std::cout << "Entering Find test" << std::endl;
+    dm_mld_index_t index;
+    mac_address_t mld = {0x02, 0, 0, 0, 0, 0x01}, ap0 = {0x02, 0, 0, 0, 0, 0x10}, ap1 = {0x02, 0, 0, 0, 0, 0x11};
+    mac_address_t zero = {0}, unknown = {0x02, 0, 0, 0, 0, 0x09};
+    unsigned int idx = 0, link = 0;
+
+    index.add_mld(mld, 3);
+    index.add_link(ap0, 3, 0);
+    index.add_link(ap1, 3, 1);
+    index.add_mld(zero, 4);
+    index.add_link(zero, 4, 0);
+    EXPECT_EQ(index.get_num_mlds(), 1u);
+    EXPECT_EQ(index.get_num_links(), 2u);
+
+    EXPECT_TRUE(index.find_mld(mld, &idx));
+    EXPECT_EQ(idx, 3u);
+    EXPECT_TRUE(index.find_link(ap1, &idx, &link));
+    EXPECT_EQ(idx, 3u);
+    EXPECT_EQ(link, 1u);
+    EXPECT_TRUE(index.find_link(ap0, &idx, NULL));
+    EXPECT_FALSE(index.find_mld(zero, &idx));
+    EXPECT_FALSE(index.find_link(unknown, &idx, &link));
+    std::cout << "Exiting Find test" << std::endl;
+}
+
+/**
+* @brief Test that a link moved to another MLD is not removed with its old MLD
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Move a link from MLD 0 to MLD 1, then remove the links of MLD 0 | ap0 | The link stays under MLD 1 | Should Pass |
+* | 02| Remove the MLD with the index it was moved from | idx = 0 | The MLD stays at idx 2 | Should Pass |
+* | 03| Clear the index | None | Nothing found | Should Pass |
+*/
+TEST(dm_mld_index_t_Test, Move) {
+    std::cout << "Entering Move test" << std::endl;
+    dm_mld_index_t index;
+    mac_address_t mld = {0x02, 0, 0, 0, 0, 0x01}, ap0 = {0x02, 0, 0, 0, 0, 0x10};
+    unsigned int idx = 0, link = 0;
+
+    index.add_mld(mld, 0);
+    index.add_link(ap0, 0, 0);
+    index.add_link(ap0, 1, 2);
+    index.remove_link(ap0, 0);
+    EXPECT_TRUE(index.find_link(ap0, &idx, &link));
+    EXPECT_EQ(idx, 1u);
+    EXPECT_EQ(link, 2u);
+    index.remove_link(ap0, 1);
+    EXPECT_FALSE(index.find_link(ap0, &idx, &link));
+
+    index.add_mld(mld, 2);
+    index.remove_mld(mld, 0);
+    EXPECT_TRUE(index.find_mld(mld, &idx));
+    EXPECT_EQ(idx, 2u);
+
+    index.add_link(ap0, 2, 0);
+    index.clear();
+    EXPECT_FALSE(index.find_mld(mld, &idx));
+    EXPECT_FALSE(index.find_link(ap0, &idx, &link));
+    EXPECT_EQ(index.get_num_links(), 0u);
+    std::cout << "Exiting Move test" << std::endl;
+}
@@ -1576,4 +1576,103 @@ TEST(dm_network_ssid_t_Test, DestructionDefault) {
         std::cout << "dm_network_ssid_t object will be destroyed automatically when going out of scope" << std::endl;
     });
     std::cout << "Exiting DestructionDefault test" << std::endl;
-}
\ No newline at end of file
+}
+/**
+ * @brief Verify that get_band_mask maps the Band strings of a network SSID to em_freq_band_t bits
+ *
+ * This test checks the bits of the "2.4", "5" and "6" bands and that a band string that is not one of them
+ * makes the network SSID count as present on all bands.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 050@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :--------------: | ----------- | --------- | --------------- | ----- |
+ * | 01 | Bands "2.4" and "6" | num_bands = 2 | Bits of em_freq_band_24 and em_freq_band_60 | Should Pass |
+ * | 02 | Add an unknown band | band[2] = "x" | All band bits | Should Pass |
+ * | 03 | No band | num_bands = 0 | 0 | Should Pass |
+ */
+TEST(dm_network_ssid_t_Test, GetBandMask) {
+    std::cout << "Entering GetBandMask test" << std::endl;
+    em_network_ssid_info_t info;
+    memset(&info, 0, sizeof(info));
+    info.num_bands = 2;
+    strncpy(info.band[0], "2.4", sizeof(info.band[0]) - 1);
+    strncpy(info.band[1], "6", sizeof(info.band[1]) - 1);
+    EXPECT_EQ(dm_network_ssid_t::get_band_mask(&info), (1U << em_freq_band_24) | (1U << em_freq_band_60));
+    info.num_bands = 3;
+    strncpy(info.band[2], "x", sizeof(info.band[2]) - 1);
+    EXPECT_EQ(dm_network_ssid_t::get_band_mask(&info), (1U << em_freq_band_unknown) - 1);
+    info.num_bands = 0;
+    EXPECT_EQ(dm_network_ssid_t::get_band_mask(&info), 0U);
+    std::cout << "Exiting GetBandMask test" << std::endl;
+}
+
+static void set_net_ssid(dm_network_ssid_t *net_ssid, const char *ssid, const char *pass_phrase, const char *band, em_haul_type_t haul_type)
+{
+    em_network_ssid_info_t *info = net_ssid->get_network_ssid_info();
+
+    memset(info, 0, sizeof(em_network_ssid_info_t));
+    strncpy(info->ssid, ssid, sizeof(info->ssid) - 1);
+    strncpy(info->pass_phrase, pass_phrase, sizeof(info->pass_phrase) - 1);
+    info->num_bands = 1;
+    strncpy(info->band[0], band, sizeof(info->band[0]) - 1);
+    info->num_hauls = 1;
+    info->haul_type[0] = haul_type;
+}
+
+/**
+ * @brief Verify that get_changed_bands only reports the bands of the haul types that changed
+ *
+ * The current list has a fronthaul SSID on 5 GHz, a backhaul SSID on 6 GHz and a hotspot SSID on 2.4 GHz. The
+ * requested lists change the hotspot pass phrase, move the backhaul SSID to 5 GHz and add an IoT SSID, in a
+ * different entry order than the current list.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 051@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :--------------: | ----------- | --------- | --------------- | ----- |
+ * | 01 | Same list, other entry order | tgt = cur reordered | 0 | Should Pass |
+ * | 02 | Hotspot pass phrase changed | hotspot pass_phrase = "new" | Bit of em_freq_band_24 only | Should Pass |
+ * | 03 | Backhaul moved from 6 to 5 GHz | backhaul band = "5" | Bits of em_freq_band_5 and em_freq_band_60 | Should Pass |
+ * | 04 | IoT SSID added | iot band = "2.4" | Bit of em_freq_band_24 only | Should Pass |
+ */
+TEST(dm_network_ssid_t_Test, GetChangedBands) {
+    std::cout << "Entering GetChangedBands test" << std::endl;
+    dm_network_ssid_t cur[EM_MAX_NET_SSIDS], tgt[EM_MAX_NET_SSIDS];
+
+    set_net_ssid(&cur[0], "home", "pass1", "5", em_haul_type_fronthaul);
+    set_net_ssid(&cur[1], "mesh", "pass2", "6", em_haul_type_backhaul);
+    set_net_ssid(&cur[2], "guest", "pass3", "2.4", em_haul_type_hotspot);
+
+    set_net_ssid(&tgt[0], "guest", "pass3", "2.4", em_haul_type_hotspot);
+    set_net_ssid(&tgt[1], "home", "pass1", "5", em_haul_type_fronthaul);
+    set_net_ssid(&tgt[2], "mesh", "pass2", "6", em_haul_type_backhaul);
+    EXPECT_EQ(dm_network_ssid_t::get_changed_bands(tgt, EM_MAX_NET_SSIDS, cur, EM_MAX_NET_SSIDS), 0U);
+
+    set_net_ssid(&tgt[0], "guest", "new", "2.4", em_haul_type_hotspot);
+    EXPECT_EQ(dm_network_ssid_t::get_changed_bands(tgt, EM_MAX_NET_SSIDS, cur, EM_MAX_NET_SSIDS), 1U << em_freq_band_24);
+
+    set_net_ssid(&tgt[0], "guest", "pass3", "2.4", em_haul_type_hotspot);
+    set_net_ssid(&tgt[2], "mesh", "pass2", "5", em_haul_type_backhaul);
+    EXPECT_EQ(dm_network_ssid_t::get_changed_bands(tgt, EM_MAX_NET_SSIDS, cur, EM_MAX_NET_SSIDS),
+              (1U << em_freq_band_5) | (1U << em_freq_band_60));
+
+    set_net_ssid(&tgt[2], "mesh", "pass2", "6", em_haul_type_backhaul);
+    set_net_ssid(&tgt[3], "things", "pass4", "2.4", em_haul_type_iot);
+    EXPECT_EQ(dm_network_ssid_t::get_changed_bands(tgt, EM_MAX_NET_SSIDS, cur, EM_MAX_NET_SSIDS), 1U << em_freq_band_24);
+    std::cout << "Exiting GetChangedBands test" << std::endl;
+}
@@ -0,0 +1,143 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+#include "dm_op_class_index.h"
+
+static void fill_op_class(em_op_class_info_t *info, const unsigned char *ruid, em_op_class_type_t type, unsigned int op_class,
+                          const unsigned int *channels, unsigned int num)
+{
+    memset(info, 0, sizeof(em_op_class_info_t));
+    memcpy(info->id.ruid, ruid, sizeof(mac_address_t));
+    info->id.type = type;
+    info->id.op_class = op_class;
+    info->op_class = op_class;
+    info->num_channels = num;
+    memcpy(info->channels, channels, num * sizeof(unsigned int));
+}
+
+/**
+* @brief Test that operating classes are found by radio, type and class
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Index the same class of two types and of two radios | class 115 at 0 to 2 | Each found with its index | Should Pass |
+* | 02| Look up a class, type or radio not indexed | class 118, type preference | Not found | Should Pass |
+* | 03| Index an entry again at another index | class 115 at 5 | Found at 5, count unchanged | Should Pass |
+*/
+TEST(dm_op_class_index_t_Test, Find) {
+    std::cout << "Entering Find test" << std::endl;
+    dm_op_class_index_t index;
+    mac_address_t radio0 = {0x02, 0, 0, 0, 0, 0x01}, radio1 = {0x02, 0, 0, 0, 0, 0x02}, unknown = {0x02, 0, 0, 0, 0, 0x09};
+    unsigned int channels[] = {36, 40};
+    em_op_class_info_t info;
+    const dm_op_class_index_entry_t *entry;
+
+    fill_op_class(&info, radio0, em_op_class_type_current, 115, channels, 1);
+    index.add(&info, 0);
+    fill_op_class(&info, radio0, em_op_class_type_capability, 115, channels, 2);
+    index.add(&info, 1);
+    fill_op_class(&info, radio1, em_op_class_type_current, 115, channels, 1);
+    index.add(&info, 2);
+    EXPECT_EQ(index.get_num(), 3u);
+
+    ASSERT_NE((entry = index.find(radio0, em_op_class_type_current, 115)), nullptr);
+    EXPECT_EQ(entry->idx, 0u);
+    ASSERT_NE((entry = index.find(radio0, em_op_class_type_capability, 115)), nullptr);
+    EXPECT_EQ(entry->idx, 1u);
+    EXPECT_EQ(entry->num_channels, 2u);
+    ASSERT_NE((entry = index.find(radio1, em_op_class_type_current, 115)), nullptr);
+    EXPECT_EQ(entry->idx, 2u);
+
+    EXPECT_EQ(index.find(radio0, em_op_class_type_current, 118), nullptr);
+    EXPECT_EQ(index.find(radio0, em_op_class_type_preference, 115), nullptr);
+    EXPECT_EQ(index.find(unknown, em_op_class_type_current, 115), nullptr);
+
+    fill_op_class(&info, radio1, em_op_class_type_current, 115, channels, 1);
+    index.add(&info, 5);
+    ASSERT_NE((entry = index.find(radio1, em_op_class_type_current, 115)), nullptr);
+    EXPECT_EQ(entry->idx, 5u);
+    EXPECT_EQ(index.get_num(), 3u);
+    std::cout << "Exiting Find test" << std::endl;
+}
+
+/**
+* @brief Test the channel bitmaps of the capability operating classes
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Index a capability class with non operable channels | class 121, channels 120 to 128 and 165 | Listed channels set, others not | Should Pass |
+* | 02| Check the radios with capabilities | radio with and without capability classes | Only the first has them | Should Pass |
+* | 03| Index the class again with another list | channel 100 | Bitmap replaced | Should Pass |
+* | 04| Clear the index | clear() | Nothing found, no radio has capabilities | Should Pass |
+*/
+TEST(dm_op_class_index_t_Test, Channels) {
+    std::cout << "Entering Channels test" << std::endl;
+    dm_op_class_index_t index;
+    mac_address_t radio0 = {0x02, 0, 0, 0, 0, 0x01}, radio1 = {0x02, 0, 0, 0, 0, 0x02};
+    unsigned int non_operable[] = {120, 124, 128, 165}, other[] = {100};
+    em_op_class_info_t info;
+    const dm_op_class_index_entry_t *entry;
+
+    fill_op_class(&info, radio0, em_op_class_type_capability, 121, non_operable, 4);
+    index.add(&info, 0);
+    fill_op_class(&info, radio1, em_op_class_type_current, 121, other, 1);
+    index.add(&info, 1);
+
+    ASSERT_NE((entry = index.find(radio0, em_op_class_type_capability, 121)), nullptr);
+    EXPECT_TRUE(dm_op_class_index_t::has_channel(entry, 120));
+    EXPECT_TRUE(dm_op_class_index_t::has_channel(entry, 128));
+    EXPECT_TRUE(dm_op_class_index_t::has_channel(entry, 165));
+    EXPECT_FALSE(dm_op_class_index_t::has_channel(entry, 100));
+    EXPECT_FALSE(dm_op_class_index_t::has_channel(entry, 0));
+    EXPECT_FALSE(dm_op_class_index_t::has_channel(entry, 300));
+
+    EXPECT_TRUE(index.has_capability(radio0));
+    EXPECT_FALSE(index.has_capability(radio1));
+
+    fill_op_class(&info, radio0, em_op_class_type_capability, 121, other, 1);
+    index.add(&info, 0);
+    ASSERT_NE((entry = index.find(radio0, em_op_class_type_capability, 121)), nullptr);
+    EXPECT_TRUE(dm_op_class_index_t::has_channel(entry, 100));
+    EXPECT_FALSE(dm_op_class_index_t::has_channel(entry, 120));
+    EXPECT_EQ(entry->num_channels, 1u);
+
+    index.clear();
+    EXPECT_EQ(index.get_num(), 0u);
+    EXPECT_EQ(index.find(radio0, em_op_class_type_capability, 121), nullptr);
+    EXPECT_FALSE(index.has_capability(radio0));
+    std::cout << "Exiting Channels test" << std::endl;
+}
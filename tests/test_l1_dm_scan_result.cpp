@@ -3787,3 +3787,61 @@ TEST(dm_scan_result_t_Test, Destruction_WithNullScanPointer_CopyConstructor) {
     std::cout << "Exiting Destruction_WithNullScanPointer_CopyConstructor test" << std::endl;
 }
 
+
+/**
+ * @brief Verify that neighbors are updated in place or appended through the BSSID index.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 064@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**
+ * | Variation / Step | Description                                              | Test Data                      | Expected Result                                 | Notes           |
+ * | :--------------: | -------------------------------------------------------- | ------------------------------ | ----------------------------------------------- | --------------- |
+ * | 01               | Put EM_MAX_NEIGHBORS neighbors                           | BSSIDs differing in the last byte | All stored and found                          | Should Pass     |
+ * | 02               | Put a known BSSID again with another signal strength     | signal_strength = -40          | Updated in place, count unchanged               | Should Pass     |
+ * | 03               | Put one more BSSID                                       | None                           | -1, list full                                   | Should Pass     |
+ * | 04               | Rewrite the neighbors in place and copy the object       | Count set to 1                 | The copy only finds the first neighbor          | Should Pass     |
+ */
+TEST(dm_scan_result_t_Test, PutNeighborThroughIndex) {
+    std::cout << "Entering PutNeighborThroughIndex test" << std::endl;
+    dm_scan_result_t obj;
+    em_neighbor_t nbr;
+    unsigned int i;
+
+    memset(&nbr, 0, sizeof(nbr));
+    nbr.bssid[0] = 0x02;
+    for (i = 0; i < EM_MAX_NEIGHBORS; i++) {
+        nbr.bssid[5] = static_cast<unsigned char>(i);
+        nbr.signal_strength = static_cast<signed char>(-60 - static_cast<int>(i));
+        EXPECT_EQ(obj.put_neighbor(&nbr), 0);
+    }
+    EXPECT_EQ(obj.m_scan_result.num_neighbors, EM_MAX_NEIGHBORS);
+    for (i = 0; i < EM_MAX_NEIGHBORS; i++) {
+        nbr.bssid[5] = static_cast<unsigned char>(i);
+        ASSERT_NE(obj.find_neighbor(nbr.bssid), nullptr);
+        EXPECT_EQ(obj.find_neighbor(nbr.bssid)->signal_strength, -60 - static_cast<int>(i));
+    }
+
+    nbr.bssid[5] = 3;
+    nbr.signal_strength = -40;
+    EXPECT_EQ(obj.put_neighbor(&nbr), 0);
+    EXPECT_EQ(obj.m_scan_result.num_neighbors, EM_MAX_NEIGHBORS);
+    EXPECT_EQ(obj.m_scan_result.neighbor[3].signal_strength, -40);
+
+    nbr.bssid[5] = 0xff;
+    EXPECT_EQ(obj.put_neighbor(&nbr), -1);
+    EXPECT_EQ(obj.find_neighbor(nbr.bssid), nullptr);
+
+    obj.m_scan_result.num_neighbors = 1;
+    dm_scan_result_t copy(obj);
+    nbr.bssid[5] = 0;
+    EXPECT_NE(copy.find_neighbor(nbr.bssid), nullptr);
+    nbr.bssid[5] = 1;
+    EXPECT_EQ(copy.find_neighbor(nbr.bssid), nullptr);
+    std::cout << "Exiting PutNeighborThroughIndex test" << std::endl;
+}
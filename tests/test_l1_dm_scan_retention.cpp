@@ -0,0 +1,169 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include "dm_scan_retention.h"
+
+static void set_entry(dm_scan_retention_entry_t *e, unsigned char radio, unsigned long long used_ms)
+{
+    unsigned char mac[EM_HEX_MAC_LEN] = {0x02, 0, 0, 0, 0, radio};
+
+    e->scanner = em_hex::pack_mac(mac);
+    e->used_ms = used_ms;
+    e->bytes = 1000;
+}
+
+/**
+* @brief Test that results not updated for longer than the maximum age are removed, unless just updated
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Select with a maximum age of 60 s | results updated 100 s, 30 s and 0 s ago | The oldest only is picked | Should Pass |
+* | 02| Select with a maximum age of 1 ms and a minimum idle time of 10 s | same results | All but the one updated now are picked | Should Pass |
+*/
+TEST(dm_scan_retention_t_Test, Age) {
+    std::cout << "Entering Age test" << std::endl;
+    dm_scan_retention_t ret;
+    dm_scan_retention_params_t params;
+    dm_scan_retention_entry_t entries[3];
+    bool evict[3];
+    unsigned long long now = 1000000;
+
+    memset(&params, 0, sizeof(params));
+    params.max_age_ms = 60000;
+    ret.set_params(&params);
+    set_entry(&entries[0], 1, now - 100000);
+    set_entry(&entries[1], 1, now - 30000);
+    set_entry(&entries[2], 1, now);
+
+    EXPECT_EQ(ret.select(now, entries, 3, evict), 1u);
+    EXPECT_TRUE(evict[0]);
+    EXPECT_FALSE(evict[1]);
+    EXPECT_FALSE(evict[2]);
+
+    params.max_age_ms = 1;
+    params.min_idle_ms = 10000;
+    ret.set_params(&params);
+    EXPECT_EQ(ret.select(now, entries, 3, evict), 2u);
+    EXPECT_FALSE(evict[2]);
+    EXPECT_EQ(ret.get_stats().evicted_age, 3u);
+    EXPECT_EQ(ret.get_stats().passes, 2u);
+    std::cout << "Exiting Age test" << std::endl;
+}
+
+/**
+* @brief Test that each scanner keeps its most recently updated results up to the maximum count
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Select with 2 results per radio | 4 results of radio 1 out of order, 1 of radio 2 | The 2 oldest of radio 1 are picked | Should Pass |
+*/
+TEST(dm_scan_retention_t_Test, PerRadio) {
+    std::cout << "Entering PerRadio test" << std::endl;
+    dm_scan_retention_t ret;
+    dm_scan_retention_params_t params;
+    dm_scan_retention_entry_t entries[5];
+    bool evict[5];
+    unsigned long long now = 1000000;
+
+    memset(&params, 0, sizeof(params));
+    params.max_per_radio = 2;
+    ret.set_params(&params);
+    set_entry(&entries[0], 1, now - 3000);
+    set_entry(&entries[1], 1, now - 1000);
+    set_entry(&entries[2], 2, now - 9000);
+    set_entry(&entries[3], 1, now - 4000);
+    set_entry(&entries[4], 1, now - 2000);
+
+    EXPECT_EQ(ret.select(now, entries, 5, evict), 2u);
+    EXPECT_TRUE(evict[0]);
+    EXPECT_FALSE(evict[1]);
+    EXPECT_FALSE(evict[2]);
+    EXPECT_TRUE(evict[3]);
+    EXPECT_FALSE(evict[4]);
+    EXPECT_EQ(ret.get_stats().evicted_radio, 2u);
+    std::cout << "Exiting PerRadio test" << std::endl;
+}
+
+/**
+* @brief Test that the least recently updated results across scanners go until the memory is under the cap
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Select with a cap of 2500 bytes | 4 results of 1000 bytes on 2 radios | The 2 oldest are picked whatever their radio | Should Pass |
+* | 02| Select with no limit | same results | Nothing is picked, the policy is disabled | Should Pass |
+*/
+TEST(dm_scan_retention_t_Test, MemoryCap) {
+    std::cout << "Entering MemoryCap test" << std::endl;
+    dm_scan_retention_t ret;
+    dm_scan_retention_params_t params;
+    dm_scan_retention_entry_t entries[4];
+    bool evict[4];
+    unsigned long long now = 1000000;
+
+    memset(&params, 0, sizeof(params));
+    params.max_bytes = 2500;
+    ret.set_params(&params);
+    set_entry(&entries[0], 1, now - 1000);
+    set_entry(&entries[1], 2, now - 4000);
+    set_entry(&entries[2], 2, now - 2000);
+    set_entry(&entries[3], 1, now - 3000);
+
+    EXPECT_EQ(ret.select(now, entries, 4, evict), 2u);
+    EXPECT_FALSE(evict[0]);
+    EXPECT_TRUE(evict[1]);
+    EXPECT_FALSE(evict[2]);
+    EXPECT_TRUE(evict[3]);
+    EXPECT_EQ(ret.get_stats().last_bytes, 4000u);
+    EXPECT_EQ(ret.get_stats().evicted_memory, 2u);
+
+    memset(&params, 0, sizeof(params));
+    ret.set_params(&params);
+    EXPECT_FALSE(ret.is_enabled());
+    EXPECT_EQ(ret.select(now, entries, 4, evict), 0u);
+    std::cout << "Exiting MemoryCap test" << std::endl;
+}
@@ -0,0 +1,116 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include "dm_section.h"
+
+typedef struct {
+    unsigned int id;
+    unsigned char payload[100];
+} test_elem_t;
+
+/**
+* @brief Test that a section allocates on use and grows up to its maximum
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Read a const section that was never written | None | A default element is returned, nothing is allocated | Should Pass |
+* | 02| Write elements 0 to 9 | None | The section holds 16 elements and keeps the values | Should Pass |
+* | 03| Reserve above the maximum | num = 65 | -1 is returned, the section is unchanged | Should Pass |
+* | 04| Write the last element | idx = 63 | The section holds 64 elements, earlier values are kept | Should Pass |
+*/
+TEST(dm_section_t_Test, GrowOnUse) {
+    std::cout << "Entering GrowOnUse test" << std::endl;
+    dm_section_t<test_elem_t, 64> sect;
+    const dm_section_t<test_elem_t, 64>& csect = sect;
+    unsigned int i;
+
+    EXPECT_EQ(csect[3].id, 0u);
+    EXPECT_EQ(sect.get_size(), 0u);
+    EXPECT_EQ(sect.get_footprint(), 0u);
+
+    for (i = 0; i < 10; i++) {
+        sect[i].id = i + 1;
+    }
+    EXPECT_EQ(sect.get_size(), 16u);
+    EXPECT_EQ(sect.get_footprint(), 16 * sizeof(test_elem_t));
+
+    EXPECT_EQ(sect.reserve(65), -1);
+    EXPECT_EQ(sect.get_size(), 16u);
+
+    sect[63].id = 64;
+    EXPECT_EQ(sect.get_size(), 64u);
+    for (i = 0; i < 10; i++) {
+        EXPECT_EQ(csect[i].id, i + 1);
+    }
+    EXPECT_EQ(csect[63].id, 64u);
+    std::cout << "Exiting GrowOnUse test" << std::endl;
+}
+
+/**
+* @brief Test that copies of a section do not share storage
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Copy construct and assign from a section of 5 elements | None | The copies hold the same values | Should Pass |
+* | 02| Change the source, then clear it | None | The copies keep their values | Should Pass |
+*/
+TEST(dm_section_t_Test, DeepCopy) {
+    std::cout << "Entering DeepCopy test" << std::endl;
+    dm_section_t<test_elem_t, 64> src, assigned;
+    unsigned int i;
+
+    for (i = 0; i < 5; i++) {
+        src[i].id = i + 1;
+        memset(src[i].payload, static_cast<int>(i), sizeof(src[i].payload));
+    }
+
+    dm_section_t<test_elem_t, 64> copied(src);
+    assigned = src;
+
+    src[0].id = 100;
+    src.clear();
+    EXPECT_EQ(src.get_size(), 0u);
+
+    for (i = 0; i < 5; i++) {
+        EXPECT_EQ(copied[i].id, i + 1);
+        EXPECT_EQ(assigned[i].id, i + 1);
+        EXPECT_EQ(assigned[i].payload[99], i);
+    }
+    std::cout << "Exiting DeepCopy test" << std::endl;
+}
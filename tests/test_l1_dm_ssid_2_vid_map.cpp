@@ -0,0 +1,89 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include "dm_ssid_2_vid_map.h"
+
+static dm_ssid_2_vid_map_t make_map(const char *ssid, const char *dev, unsigned short vid)
+{
+    em_ssid_2_vid_map_info_t info;
+
+    memset(&info, 0, sizeof(em_ssid_2_vid_map_info_t));
+    snprintf(info.ssid, sizeof(info.ssid), "%s", ssid);
+    snprintf(info.id, sizeof(info.id), "%s@%s", ssid, dev);
+    info.vid = vid;
+
+    return dm_ssid_2_vid_map_t(&info);
+}
+
+/**
+* @brief Test the SSID to VID lookups and the generation of the map
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Empty map | get_vid("home") | -1, generation 0 | Should Pass |
+* | 02| Two SSIDs added | home 10, guest 20 | Insert, VIDs found, generation 2 | Should Pass |
+* | 03| Same mapping again | home 10 | None, generation unchanged | Should Pass |
+* | 04| Same SSID on another device | home 10 on dev2 | Insert, generation unchanged | Should Pass |
+* | 05| VID of an SSID changed | home 30 | Update, VID 30 found and in the list, generation 3 | Should Pass |
+*/
+TEST(dm_ssid_2_vid_map_t_Test, VidLookup) {
+    std::cout << "Entering VidLookup test" << std::endl;
+    dm_ssid_2_vid_map_t map;
+    dm_ssid_2_vid_map_t *entry;
+    unsigned int num = 0;
+
+    ASSERT_EQ(map.init(), 0);
+    EXPECT_EQ(map.get_vid("home"), -1);
+    EXPECT_EQ(map.get_generation(), 0u);
+
+    EXPECT_EQ(map.update_list(make_map("home", "dev1", 10)), dm_orch_type_db_insert);
+    EXPECT_EQ(map.update_list(make_map("guest", "dev1", 20)), dm_orch_type_db_insert);
+    EXPECT_EQ(map.get_vid("home"), 10);
+    EXPECT_EQ(map.get_vid("guest"), 20);
+    EXPECT_EQ(map.get_generation(), 2u);
+
+    EXPECT_EQ(map.update_list(make_map("home", "dev1", 10)), dm_orch_type_none);
+    EXPECT_EQ(map.get_generation(), 2u);
+    EXPECT_EQ(map.update_list(make_map("home", "dev2", 10)), dm_orch_type_db_insert);
+    EXPECT_EQ(map.get_generation(), 2u);
+
+    EXPECT_EQ(map.update_list(make_map("home", "dev1", 30)), dm_orch_type_db_update);
+    EXPECT_EQ(map.get_vid("home"), 30);
+    EXPECT_EQ(map.get_generation(), 3u);
+    for (entry = map.get_first(); entry != NULL; entry = map.get_next(entry)) {
+        if (strcmp(entry->get_ssid_2_vid_map_info()->id, "home@dev1") == 0) {
+            EXPECT_EQ(entry->get_ssid_2_vid_map_info()->vid, 30);
+        }
+        num++;
+    }
+    EXPECT_EQ(num, 3u);
+    std::cout << "Exiting VidLookup test" << std::endl;
+}
@@ -1549,3 +1549,91 @@ TEST(dm_sta_t_Test, dm_sta_t_destructor_default_constructor) {
     });
     std::cout << "Exiting dm_sta_t::~dm_sta_t()_end test" << std::endl;
 }
+
+/**
+ * @brief Verify that the dirty mark of a dm_sta_t is set and cleared, and is not carried by a copy.
+ *
+ * The controller writes only the database rows of the stations marked as dirty. The test checks
+ * that a new station is clean, that the mark follows set_dirty() and that a copy starts clean.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 047@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**
+ * | Variation / Step | Description                                   | Test Data                  | Expected Result             | Notes         |
+ * | :---------------:| ----------------------------------------------| ---------------------------| ----------------------------| --------------|
+ * | 01               | Create a station                              | default constructor        | is_dirty() returns false    | Should Pass   |
+ * | 02               | Mark the station                              | set_dirty(true)            | is_dirty() returns true     | Should Pass   |
+ * | 03               | Copy the marked station                       | copy constructor           | copy is_dirty() is false    | Should Pass   |
+ * | 04               | Clear the mark                                | set_dirty(false)           | is_dirty() returns false    | Should Pass   |
+ */
+TEST(dm_sta_t_Test, DirtyMark) {
+    std::cout << "Entering DirtyMark test" << std::endl;
+    dm_sta_t sta;
+    EXPECT_FALSE(sta.is_dirty());
+    sta.set_dirty(true);
+    EXPECT_TRUE(sta.is_dirty());
+    dm_sta_t copy(sta);
+    EXPECT_FALSE(copy.is_dirty());
+    sta.set_dirty(false);
+    EXPECT_FALSE(sta.is_dirty());
+    std::cout << "Exiting DirtyMark test" << std::endl;
+}
+
+/**
+ * @brief Test that the frame body of a station is parsed once into its capabilities
+ *
+ * The encodes of a station read the capabilities parsed on the first call, the frame body
+ * is walked again only once it changed.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 048@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**
+ * | Variation / Step | Description                                   | Test Data                  | Expected Result             | Notes         |
+ * | :---------------:| ----------------------------------------------| ---------------------------| ----------------------------| --------------|
+ * | 01               | Get the capabilities of an Association Request| SSID, RRM, BTM, Multi-Link | RRM, BTM and MLO with the MLD MAC, fields decoded | Should Pass |
+ * | 02               | Clear a decoded field and get them again      | Same frame body            | Field left alone, not parsed again | Should Pass |
+ * | 03               | Change the frame body                         | Extended Capabilities without BTM | BTM cleared, fields decoded again | Should Pass |
+ */
+TEST(dm_sta_t_Test, ParsedCaps) {
+    std::cout << "Entering ParsedCaps test" << std::endl;
+    const unsigned char body[] = {0x31, 0x04, 0x0a, 0x00,
+        0, 4, 'm', 'e', 's', 'h',
+        70, 5, 0x73, 0, 0, 0, 0,
+        127, 3, 0, 0, 0x08,
+        255, 10, 107, 0xb0, 0x01, 7, 0x02, 0x11, 0x22, 0x33, 0x44, 0x55};
+    const unsigned char mld[] = {0x02, 0x11, 0x22, 0x33, 0x44, 0x55};
+    const em_client_cap_t *cap;
+    dm_sta_t sta;
+
+    memcpy(sta.m_sta_info.frame_body, body, sizeof(body));
+    sta.m_sta_info.frame_body_len = sizeof(body);
+    cap = sta.get_caps();
+    EXPECT_EQ(cap->flags, static_cast<unsigned int>(EM_CLIENT_CAP_RRM | EM_CLIENT_CAP_BTM | EM_CLIENT_CAP_MLO));
+    EXPECT_EQ(memcmp(cap->mld_mac, mld, sizeof(mld)), 0);
+    EXPECT_STREQ(sta.m_sta_info.ssid, "mesh");
+    EXPECT_STREQ(sta.m_sta_info.multi_link, "02:11:22:33:44:55");
+    EXPECT_TRUE(sta.m_sta_info.multi_band_cap);
+
+    memset(sta.m_sta_info.ssid, 0, sizeof(sta.m_sta_info.ssid));
+    sta.get_caps();
+    EXPECT_STREQ(sta.m_sta_info.ssid, "");
+
+    sta.m_sta_info.frame_body[21] = 0;
+    cap = sta.get_caps();
+    EXPECT_EQ(cap->flags & EM_CLIENT_CAP_BTM, 0u);
+    EXPECT_FALSE(sta.m_sta_info.multi_band_cap);
+    EXPECT_STREQ(sta.m_sta_info.ssid, "mesh");
+    std::cout << "Exiting ParsedCaps test" << std::endl;
+}
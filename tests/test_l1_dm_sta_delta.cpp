@@ -0,0 +1,219 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include "dm_sta_delta.h"
+#include "dm_sta.h"
+
+// puts STA n in a map the way the associated clients decode does
+static void put_sta(dm_key_map_t *map, unsigned int n, unsigned char frame)
+{
+    em_sta_info_t info;
+    dm_map_key_t key;
+
+    memset(&info, 0, sizeof(em_sta_info_t));
+    info.id[0] = 0x02;
+    info.id[4] = static_cast<unsigned char>(n >> 8);
+    info.id[5] = static_cast<unsigned char>(n);
+    info.bssid[0] = 0x02;
+    info.bssid[5] = static_cast<unsigned char>(n % 4);
+    info.radiomac[0] = 0x02;
+    info.radiomac[5] = 0x01;
+    info.frame_body_len = 4;
+    info.frame_body[3] = frame;
+    dm_key_map_t::sta_key(&key, info.id, info.bssid, info.radiomac);
+    map->put(&key, new dm_sta_t(&info));
+}
+
+static void free_stas(dm_key_map_t *map)
+{
+    dm_sta_t *sta, *next;
+
+    sta = static_cast<dm_sta_t *>(map->get_first());
+    while (sta != NULL) {
+        next = static_cast<dm_sta_t *>(map->get_next(sta));
+        delete sta;
+        sta = next;
+    }
+    map->clear();
+}
+
+/**
+* @brief Test that a full client list reduces to the STAs that joined or left
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Apply a list of 100 STAs | None | All 100 are kept and staged | Should Pass |
+* | 02| Apply the same 100 STAs and one more | None | Only the new STA is kept | Should Pass |
+* | 03| Apply the 101 STAs with one of them in the disassoc map and dropped from the list | None | Only the leave is reported, 100 STAs stay staged | Should Pass |
+* | 04| Apply the 100 STAs with a new association frame for one | None | The reassociated STA is kept | Should Pass |
+*/
+TEST(dm_sta_delta_t_Test, JoinsAndLeaves) {
+    std::cout << "Entering JoinsAndLeaves test" << std::endl;
+    dm_sta_delta_t delta(0);
+    dm_key_map_t assoc, dassoc;
+    unsigned int i;
+
+    for (i = 0; i < 100; i++) {
+        put_sta(&assoc, i, 0);
+    }
+    EXPECT_EQ(delta.apply(&assoc, &dassoc, 1000), 100u);
+    EXPECT_EQ(delta.get_count(), 100u);
+    EXPECT_EQ(delta.get_stats()->joined, 100u);
+    free_stas(&assoc);
+
+    for (i = 0; i < 101; i++) {
+        put_sta(&assoc, i, 0);
+    }
+    EXPECT_EQ(delta.apply(&assoc, &dassoc, 2000), 1u);
+    EXPECT_EQ(delta.get_stats()->unchanged, 100u);
+    ASSERT_EQ(assoc.count(), 1u);
+    EXPECT_EQ(static_cast<dm_sta_t *>(assoc.get_first())->get_sta_info()->id[5], 100);
+    EXPECT_EQ(delta.get_count(), 101u);
+    free_stas(&assoc);
+
+    for (i = 0; i < 100; i++) {
+        put_sta(&assoc, i, 0);
+    }
+    put_sta(&dassoc, 100, 0);
+    EXPECT_EQ(delta.apply(&assoc, &dassoc, 3000), 1u);
+    EXPECT_EQ(assoc.count(), 0u);
+    EXPECT_EQ(delta.get_stats()->left, 1u);
+    EXPECT_EQ(delta.get_stats()->vanished, 0u);
+    EXPECT_EQ(delta.get_count(), 100u);
+    free_stas(&assoc);
+    free_stas(&dassoc);
+
+    for (i = 0; i < 100; i++) {
+        put_sta(&assoc, i, (i == 7) ? 1:0);
+    }
+    EXPECT_EQ(delta.apply(&assoc, &dassoc, 4000), 1u);
+    ASSERT_EQ(assoc.count(), 1u);
+    EXPECT_EQ(static_cast<dm_sta_t *>(assoc.get_first())->get_sta_info()->id[5], 7);
+    free_stas(&assoc);
+    std::cout << "Exiting JoinsAndLeaves test" << std::endl;
+}
+
+/**
+* @brief Test that STAs missing from the list are forgotten and reported again when they return
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Apply 10 STAs, then 5 of them | None | Nothing is reported, 5 STAs vanish | Should Pass |
+* | 02| Apply the 10 STAs again | None | The 5 that vanished are reported as joins | Should Pass |
+*/
+TEST(dm_sta_delta_t_Test, Vanished) {
+    std::cout << "Entering Vanished test" << std::endl;
+    dm_sta_delta_t delta(0);
+    dm_key_map_t assoc, dassoc;
+    unsigned int i;
+
+    for (i = 0; i < 10; i++) {
+        put_sta(&assoc, i, 0);
+    }
+    delta.apply(&assoc, &dassoc, 1000);
+    free_stas(&assoc);
+
+    for (i = 0; i < 5; i++) {
+        put_sta(&assoc, i, 0);
+    }
+    EXPECT_EQ(delta.apply(&assoc, &dassoc, 2000), 0u);
+    EXPECT_EQ(delta.get_stats()->vanished, 5u);
+    EXPECT_EQ(delta.get_count(), 5u);
+    free_stas(&assoc);
+
+    for (i = 0; i < 10; i++) {
+        put_sta(&assoc, i, 0);
+    }
+    EXPECT_EQ(delta.apply(&assoc, &dassoc, 3000), 5u);
+    EXPECT_EQ(delta.get_count(), 10u);
+    free_stas(&assoc);
+    std::cout << "Exiting Vanished test" << std::endl;
+}
+
+/**
+* @brief Test that every STA is passed through once the resync interval has elapsed
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** Medium@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Apply 20 STAs at 10s and again at 11s with a 5s resync | None | All are kept the first time, none the second | Should Pass |
+* | 02| Apply them at 15s | None | All 20 are kept | Should Pass |
+* | 03| Reset and apply them at 16s | None | All 20 are kept | Should Pass |
+*/
+TEST(dm_sta_delta_t_Test, Resync) {
+    std::cout << "Entering Resync test" << std::endl;
+    dm_sta_delta_t delta(5000);
+    dm_key_map_t assoc, dassoc;
+    unsigned int i;
+
+    for (i = 0; i < 20; i++) {
+        put_sta(&assoc, i, 0);
+    }
+    EXPECT_EQ(delta.apply(&assoc, &dassoc, 10000), 20u);
+    free_stas(&assoc);
+
+    for (i = 0; i < 20; i++) {
+        put_sta(&assoc, i, 0);
+    }
+    EXPECT_EQ(delta.apply(&assoc, &dassoc, 11000), 0u);
+    free_stas(&assoc);
+
+    for (i = 0; i < 20; i++) {
+        put_sta(&assoc, i, 0);
+    }
+    EXPECT_EQ(delta.apply(&assoc, &dassoc, 15000), 20u);
+    free_stas(&assoc);
+
+    delta.reset();
+    EXPECT_EQ(delta.get_count(), 0u);
+    for (i = 0; i < 20; i++) {
+        put_sta(&assoc, i, 0);
+    }
+    EXPECT_EQ(delta.apply(&assoc, &dassoc, 16000), 20u);
+    free_stas(&assoc);
+    std::cout << "Exiting Resync test" << std::endl;
+}
@@ -0,0 +1,172 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "ec_gas_frag.h"
+
+static uint8_t peer_a[ETH_ALEN] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55};
+static uint8_t peer_b[ETH_ALEN] = {0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB};
+
+static std::vector<uint8_t> make_payload(size_t len)
+{
+    std::vector<uint8_t> payload(len);
+
+    for (size_t i = 0; i < len; i++) {
+        payload[i] = static_cast<uint8_t>(i * 7);
+    }
+    return payload;
+}
+
+static std::vector<uint8_t> copy_frame(const ec_gas_comeback_response_frame_t *frame, size_t len)
+{
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(frame);
+    return std::vector<uint8_t>(p, p + len);
+}
+
+/**
+* @brief Test that a payload fragmented by the sending side is reassembled by the receiving side
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Queue a payload of a bit more than 3 MTUs | 5000 bytes | Fragments pending for the peer only | Should Pass |
+* | 02| Build every fragment and add it to the receiving side | None | 4 fragments with increasing IDs, the last one completes the payload | Should Pass |
+*/
+TEST(ec_gas_frag_t_Test, FragmentAndReassemble) {
+    std::cout << "Entering FragmentAndReassemble test" << std::endl;
+    ec_gas_frag_t tx, rx;
+    std::vector<uint8_t> payload = make_payload(5000);
+    const ec_gas_comeback_response_frame_t *frame;
+    ec_gas_frag_status_t status = ec_gas_frag_more;
+    const uint8_t *out = NULL;
+    size_t out_len = 0, frame_len = 0;
+    unsigned int num = 0;
+
+    ASSERT_TRUE(tx.queue(peer_a, 42, payload.data(), payload.size()));
+    EXPECT_TRUE(tx.has_pending(peer_a));
+    EXPECT_FALSE(tx.has_pending(peer_b));
+
+    while ((frame = tx.next_fragment(peer_a, &frame_len)) != NULL) {
+        std::vector<uint8_t> copy = copy_frame(frame, frame_len);
+        EXPECT_EQ(frame->fragment_id, num);
+        EXPECT_EQ(frame->base.dialog_token, 42);
+        EXPECT_EQ(frame->base.action, dpp_gas_comeback_resp);
+        status = rx.add_fragment(peer_a, reinterpret_cast<ec_gas_comeback_response_frame_t *>(copy.data()), copy.size(), &out, &out_len);
+        num++;
+        if (status == ec_gas_frag_complete) {
+            ASSERT_EQ(out_len, payload.size());
+            EXPECT_EQ(memcmp(out, payload.data(), out_len), 0);
+        } else {
+            EXPECT_EQ(status, ec_gas_frag_more);
+        }
+    }
+    EXPECT_EQ(num, 4u);
+    EXPECT_EQ(status, ec_gas_frag_complete);
+    EXPECT_FALSE(tx.has_pending(peer_a));
+    std::cout << "Exiting FragmentAndReassemble test" << std::endl;
+}
+
+/**
+* @brief Test that a payload in a single fragment is handed out of the frame itself
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Queue a payload smaller than the MTU and add its only fragment | 100 bytes | Complete, the payload points into the frame | Should Pass |
+*/
+TEST(ec_gas_frag_t_Test, SingleFragment) {
+    std::cout << "Entering SingleFragment test" << std::endl;
+    ec_gas_frag_t tx, rx;
+    std::vector<uint8_t> payload = make_payload(100);
+    const ec_gas_comeback_response_frame_t *frame;
+    const uint8_t *out = NULL;
+    size_t out_len = 0, frame_len = 0;
+
+    ASSERT_TRUE(tx.queue(peer_b, 7, payload.data(), payload.size()));
+    ASSERT_NE(frame = tx.next_fragment(peer_b, &frame_len), nullptr);
+    EXPECT_EQ(frame->more_fragments, 0);
+    EXPECT_EQ(rx.add_fragment(peer_b, frame, frame_len, &out, &out_len), ec_gas_frag_complete);
+    EXPECT_EQ(out, frame->comeback_resp);
+    EXPECT_EQ(out_len, payload.size());
+    EXPECT_EQ(tx.next_fragment(peer_b, &frame_len), nullptr);
+    std::cout << "Exiting SingleFragment test" << std::endl;
+}
+
+/**
+* @brief Test that out of order and truncated fragments are rejected
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Add fragment 0 then fragment 2 | None | Fragment 2 is an error | Should Pass |
+* | 02| Add fragment 1 | None | Error, the session was dropped | Should Pass |
+* | 03| Add fragment 0 shorter than its announced length | None | Error | Should Pass |
+* | 04| Queue a payload larger than the 7 bit Fragment ID can carry | None | Refused | Should Pass |
+*/
+TEST(ec_gas_frag_t_Test, Rejects) {
+    std::cout << "Entering Rejects test" << std::endl;
+    ec_gas_frag_t tx, rx;
+    std::vector<uint8_t> payload = make_payload(5000);
+    const ec_gas_comeback_response_frame_t *frame;
+    const uint8_t *out = NULL;
+    size_t out_len = 0, frame_len = 0;
+
+    ASSERT_TRUE(tx.queue(peer_a, 9, payload.data(), payload.size()));
+    ASSERT_NE(frame = tx.next_fragment(peer_a, &frame_len), nullptr);
+    std::vector<uint8_t> frag0 = copy_frame(frame, frame_len);
+    ASSERT_NE(frame = tx.next_fragment(peer_a, &frame_len), nullptr);
+    std::vector<uint8_t> frag1 = copy_frame(frame, frame_len);
+    ASSERT_NE(frame = tx.next_fragment(peer_a, &frame_len), nullptr);
+
+    EXPECT_EQ(rx.add_fragment(peer_a, reinterpret_cast<ec_gas_comeback_response_frame_t *>(frag0.data()), frag0.size(), &out, &out_len), ec_gas_frag_more);
+    EXPECT_EQ(rx.add_fragment(peer_a, frame, frame_len, &out, &out_len), ec_gas_frag_error);
+    EXPECT_EQ(rx.add_fragment(peer_a, reinterpret_cast<ec_gas_comeback_response_frame_t *>(frag1.data()), frag1.size(), &out, &out_len), ec_gas_frag_error);
+    EXPECT_EQ(rx.add_fragment(peer_a, reinterpret_cast<ec_gas_comeback_response_frame_t *>(frag0.data()), frag0.size() - 1, &out, &out_len), ec_gas_frag_error);
+
+    std::vector<uint8_t> too_large(EC_GAS_FRAG_MAX_PAYLOAD + 1);
+    EXPECT_FALSE(tx.queue(peer_b, 1, too_large.data(), too_large.size()));
+    std::cout << "Exiting Rejects test" << std::endl;
+}
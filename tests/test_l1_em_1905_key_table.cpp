@@ -0,0 +1,233 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include "em_1905_key_table.h"
+
+static const unsigned char ctrl_mac[] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+static const unsigned char agent_mac[] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02};
+static const unsigned char cmdu_hdr[] = {0x00, 0x00, 0x80, 0x02, 0x12, 0x34, 0x00, 0x80};
+
+class em_1905_key_table_test : public ::testing::Test {
+protected:
+    em_1905_key_table_t ctrl;
+    em_1905_key_table_t agent;
+    unsigned char tk[EM_1905_TK_LEN];
+    unsigned char gtk[EM_1905_GTK_LEN];
+    unsigned char tlvs[300];
+
+    void SetUp() override {
+        memset(tk, 0x3c, sizeof(tk));
+        memset(gtk, 0x5a, sizeof(gtk));
+        for (unsigned int i = 0; i < sizeof(tlvs); i++) {
+            tlvs[i] = static_cast<unsigned char> (i);
+        }
+        ctrl.set_al_mac(ctrl_mac);
+        agent.set_al_mac(agent_mac);
+        ASSERT_EQ(ctrl.install_ptk(agent_mac, tk, sizeof(tk)), 0);
+        ASSERT_EQ(agent.install_ptk(ctrl_mac, tk, sizeof(tk)), 0);
+    }
+};
+
+/**
+* @brief Test that an encrypted payload opens at the peer and that a replayed one is dropped
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Encrypt the TLVs of a message to the agent | 300 bytes | Value with counter 1 and both AL MACs | Should Pass |
+* | 02| Decrypt it at the agent | None | The TLVs come back, the counter of the controller is 1 | Should Pass |
+* | 03| Decrypt the same value again | None | Dropped as a replay | Should Pass |
+*/
+TEST_F(em_1905_key_table_test, EncryptDecrypt) {
+    std::cout << "Entering EncryptDecrypt test" << std::endl;
+    unsigned char value[EM_1905_ENCR_HDR_LEN + AES_BLOCK_SIZE + sizeof(tlvs)], plain[sizeof(tlvs)];
+    int len;
+
+    len = ctrl.encrypt(agent_mac, cmdu_hdr, tlvs, sizeof(tlvs), value, sizeof(value));
+    ASSERT_EQ(len, static_cast<int> (sizeof(value)));
+    EXPECT_EQ(em_1905_key_table_t::get_counter(value), 1ULL);
+    EXPECT_EQ(memcmp(value + EM_1905_COUNTER_LEN, ctrl_mac, sizeof(mac_address_t)), 0);
+    EXPECT_EQ(memcmp(value + EM_1905_COUNTER_LEN + sizeof(mac_address_t), agent_mac, sizeof(mac_address_t)), 0);
+
+    ASSERT_EQ(agent.decrypt(cmdu_hdr, value, static_cast<unsigned int> (len), plain, sizeof(plain)), static_cast<int> (sizeof(tlvs)));
+    EXPECT_EQ(memcmp(plain, tlvs, sizeof(tlvs)), 0);
+    ASSERT_NE(agent.get_peer(ctrl_mac), nullptr);
+    EXPECT_EQ(agent.get_peer(ctrl_mac)->rx_counter, 1ULL);
+
+    EXPECT_EQ(agent.decrypt(cmdu_hdr, value, static_cast<unsigned int> (len), plain, sizeof(plain)), -1);
+    EXPECT_EQ(agent.get_stats().replays, 1ULL);
+    EXPECT_EQ(agent.get_stats().decrypted, 1ULL);
+    std::cout << "Exiting EncryptDecrypt test" << std::endl;
+}
+
+/**
+* @brief Test that a payload does not open once its header, ciphertext or destination changed
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Decrypt with another message type in the CMDU header | None | Fails, the counter does not move | Should Pass |
+* | 02| Decrypt with a flipped ciphertext bit | None | Fails | Should Pass |
+* | 03| Decrypt a value to another AL MAC | None | Fails | Should Pass |
+* | 04| Decrypt the untouched value | None | The TLVs come back | Should Pass |
+*/
+TEST_F(em_1905_key_table_test, Tampered) {
+    std::cout << "Entering Tampered test" << std::endl;
+    unsigned char value[EM_1905_ENCR_HDR_LEN + AES_BLOCK_SIZE + 64], bad[sizeof(value)], plain[64];
+    unsigned char hdr[sizeof(cmdu_hdr)];
+    int len;
+
+    len = ctrl.encrypt(agent_mac, cmdu_hdr, tlvs, 64, value, sizeof(value));
+    ASSERT_EQ(len, static_cast<int> (sizeof(value)));
+
+    memcpy(hdr, cmdu_hdr, sizeof(hdr));
+    hdr[3] ^= 0x01;
+    EXPECT_EQ(agent.decrypt(hdr, value, sizeof(value), plain, sizeof(plain)), -1);
+    EXPECT_EQ(agent.get_peer(ctrl_mac)->rx_counter, 0ULL);
+
+    memcpy(bad, value, sizeof(bad));
+    bad[sizeof(bad) - 1] ^= 0x01;
+    EXPECT_EQ(agent.decrypt(cmdu_hdr, bad, sizeof(bad), plain, sizeof(plain)), -1);
+    EXPECT_EQ(agent.get_stats().failures, 2ULL);
+
+    memcpy(bad, value, sizeof(bad));
+    bad[EM_1905_COUNTER_LEN + 2 * sizeof(mac_address_t) - 1] ^= 0x01;
+    EXPECT_EQ(agent.decrypt(cmdu_hdr, bad, sizeof(bad), plain, sizeof(plain)), -1);
+
+    EXPECT_EQ(agent.decrypt(cmdu_hdr, value, sizeof(value), plain, sizeof(plain)), 64);
+    EXPECT_EQ(memcmp(plain, tlvs, 64), 0);
+    std::cout << "Exiting Tampered test" << std::endl;
+}
+
+/**
+* @brief Test that the counters move per message and restart with a new TK, and that peers without keys are refused
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Decrypt the third message before the second | None | Third opens, second is a replay | Should Pass |
+* | 02| Install a new TK on both sides | None | The next message carries counter 1 and opens | Should Pass |
+* | 03| Encrypt to a removed peer and to an unknown one | None | Refused, counted as no key | Should Pass |
+*/
+TEST_F(em_1905_key_table_test, Counters) {
+    std::cout << "Entering Counters test" << std::endl;
+    unsigned char value[3][EM_1905_ENCR_HDR_LEN + AES_BLOCK_SIZE + 16], plain[16];
+    unsigned char unknown[] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x09};
+    unsigned int i;
+
+    for (i = 0; i < 3; i++) {
+        ASSERT_GT(ctrl.encrypt(agent_mac, cmdu_hdr, tlvs, 16, value[i], sizeof(value[i])), 0);
+        EXPECT_EQ(em_1905_key_table_t::get_counter(value[i]), i + 1ULL);
+    }
+    EXPECT_EQ(agent.decrypt(cmdu_hdr, value[2], sizeof(value[2]), plain, sizeof(plain)), 16);
+    EXPECT_EQ(agent.decrypt(cmdu_hdr, value[1], sizeof(value[1]), plain, sizeof(plain)), -1);
+
+    memset(tk, 0x4d, sizeof(tk));
+    ASSERT_EQ(ctrl.install_ptk(agent_mac, tk, sizeof(tk)), 0);
+    ASSERT_EQ(agent.install_ptk(ctrl_mac, tk, sizeof(tk)), 0);
+    ASSERT_GT(ctrl.encrypt(agent_mac, cmdu_hdr, tlvs, 16, value[0], sizeof(value[0])), 0);
+    EXPECT_EQ(em_1905_key_table_t::get_counter(value[0]), 1ULL);
+    EXPECT_EQ(agent.decrypt(cmdu_hdr, value[0], sizeof(value[0]), plain, sizeof(plain)), 16);
+
+    EXPECT_EQ(ctrl.install_ptk(unknown, tk, EM_1905_TK_LEN - 1), -1);
+    ctrl.remove(agent_mac);
+    EXPECT_EQ(ctrl.get_peer(agent_mac), nullptr);
+    EXPECT_EQ(ctrl.encrypt(agent_mac, cmdu_hdr, tlvs, 16, value[0], sizeof(value[0])), -1);
+    EXPECT_EQ(ctrl.encrypt(unknown, cmdu_hdr, tlvs, 16, value[0], sizeof(value[0])), -1);
+    EXPECT_EQ(ctrl.get_stats().no_key, 2ULL);
+    std::cout << "Exiting Counters test" << std::endl;
+}
+
+/**
+* @brief Test the MIC of multicast messages with the GTK
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Add a MIC before any GTK is installed | None | Refused | Should Pass |
+* | 02| Install the GTK with key ID 1 on both sides and add a MIC | None | Value with key ID 1 and counter 1 | Should Pass |
+* | 03| Check it at the agent, then again | None | Verifies once, then a replay | Should Pass |
+* | 04| Check a MIC over changed TLVs | None | Fails | Should Pass |
+* | 05| Check a MIC after the agent moved to key ID 2 | None | Refused as no key | Should Pass |
+*/
+TEST_F(em_1905_key_table_test, Mic) {
+    std::cout << "Entering Mic test" << std::endl;
+    unsigned char value[EM_1905_MIC_HDR_LEN + EM_1905_MIC_LEN];
+    unsigned char changed[sizeof(tlvs)];
+
+    EXPECT_EQ(ctrl.add_mic(cmdu_hdr, tlvs, sizeof(tlvs), value, sizeof(value)), -1);
+    EXPECT_EQ(ctrl.install_gtk(agent_mac, gtk, sizeof(gtk), 0, 0), -1);
+    ASSERT_EQ(ctrl.install_gtk(agent_mac, gtk, sizeof(gtk), 1, 0), 0);
+    ASSERT_EQ(agent.install_gtk(ctrl_mac, gtk, sizeof(gtk), 1, 0), 0);
+
+    ASSERT_EQ(ctrl.add_mic(cmdu_hdr, tlvs, sizeof(tlvs), value, sizeof(value)), static_cast<int> (sizeof(value)));
+    EXPECT_EQ(value[0] >> 6, 1);
+    EXPECT_EQ(em_1905_key_table_t::get_counter(value + 1), 1ULL);
+    EXPECT_EQ(agent.check_mic(cmdu_hdr, tlvs, sizeof(tlvs), value, sizeof(value)), 0);
+    EXPECT_EQ(agent.check_mic(cmdu_hdr, tlvs, sizeof(tlvs), value, sizeof(value)), -1);
+    EXPECT_EQ(agent.get_stats().replays, 1ULL);
+
+    ASSERT_GT(ctrl.add_mic(cmdu_hdr, tlvs, sizeof(tlvs), value, sizeof(value)), 0);
+    memcpy(changed, tlvs, sizeof(changed));
+    changed[10] ^= 0x01;
+    EXPECT_EQ(agent.check_mic(cmdu_hdr, changed, sizeof(changed), value, sizeof(value)), -1);
+    EXPECT_EQ(agent.get_stats().failures, 1ULL);
+
+    memset(gtk, 0x6b, sizeof(gtk));
+    ASSERT_EQ(agent.install_gtk(ctrl_mac, gtk, sizeof(gtk), 2, 0), 0);
+    EXPECT_EQ(agent.check_mic(cmdu_hdr, tlvs, sizeof(tlvs), value, sizeof(value)), -1);
+    EXPECT_EQ(agent.get_stats().no_key, 1ULL);
+    EXPECT_EQ(agent.get_stats().checked_mics, 1ULL);
+    std::cout << "Exiting Mic test" << std::endl;
+}
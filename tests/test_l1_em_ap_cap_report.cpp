@@ -0,0 +1,163 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <vector>
+#include "em_ap_cap_report.h"
+
+static void add_tlv(std::vector<unsigned char>& buff, unsigned char type, const std::vector<unsigned char>& val)
+{
+    unsigned short len = htons(static_cast<unsigned short>(val.size()));
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(&len);
+
+    buff.push_back(type);
+    buff.insert(buff.end(), p, p + sizeof(len));
+    buff.insert(buff.end(), val.begin(), val.end());
+}
+
+static std::vector<unsigned char> ruid_val(unsigned char n, unsigned int extra)
+{
+    std::vector<unsigned char> val = {0x02, 0, 0, 0, 0, n};
+
+    val.resize(val.size() + extra, 0);
+    return val;
+}
+
+// AP Radio Basic Capabilities of a radio with op class 81 on channels 1, 6, 11 and op class 83 without channels
+static std::vector<unsigned char> basic_val(unsigned char n)
+{
+    std::vector<unsigned char> val = ruid_val(n, 0);
+
+    val.insert(val.end(), {16, 2, 81, 20, 3, 1, 6, 11, 83, 18, 0});
+    return val;
+}
+
+/**
+* @brief Test that the TLVs of a report are grouped by radio
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Parse a report of two radios with basic, HT and advanced TLVs, and an AP Capability TLV | None | 2 radio sections, the agent TLV and 6 TLVs | Should Pass |
+* | 02| Decode the operating classes of the first radio | None | 81 with 3 channels, 83 with none | Should Pass |
+* | 03| Copy a short TLV into a larger structure | None | Tail zeroed | Should Pass |
+*/
+TEST(em_ap_cap_report_t_Test, GroupByRadio) {
+    std::cout << "Entering GroupByRadio test" << std::endl;
+    em_ap_cap_report_t report;
+    std::vector<unsigned char> buff, adv;
+    em_op_class_info_t op_classes[4];
+    em_ap_he_cap_t he;
+    const em_ap_cap_radio_sect_t *sect;
+
+    add_tlv(buff, em_tlv_type_ap_cap, {0x80});
+    add_tlv(buff, em_tlv_type_ap_radio_basic_cap, basic_val(1));
+    add_tlv(buff, em_tlv_type_ap_radio_basic_cap, basic_val(2));
+    add_tlv(buff, em_tlv_type_ht_cap, ruid_val(2, 1));
+    adv = ruid_val(1, 1);
+    std::vector<unsigned char> adv2 = ruid_val(2, 1);
+    adv.insert(adv.end(), adv2.begin(), adv2.end());
+    add_tlv(buff, em_tlv_type_ap_radio_advanced_cap, adv);
+    add_tlv(buff, em_tlv_type_he_cap, {0x02, 0, 0, 0});
+    add_tlv(buff, em_tlv_type_eom, {});
+
+    EXPECT_EQ(report.parse(buff.data(), static_cast<unsigned int>(buff.size())), 6);
+    ASSERT_EQ(report.get_num_radios(), 2u);
+    EXPECT_NE(report.get_agent_tlv(em_ap_cap_agent_tlv_ap_cap)->value, nullptr);
+    EXPECT_EQ(report.get_agent_tlv(em_ap_cap_agent_tlv_inventory)->value, nullptr);
+
+    sect = report.get_radio(0);
+    EXPECT_EQ(sect->ruid[5], 1);
+    EXPECT_NE(sect->tlvs[em_ap_cap_radio_tlv_basic].value, nullptr);
+    EXPECT_EQ(sect->tlvs[em_ap_cap_radio_tlv_ht].value, nullptr);
+    EXPECT_EQ(sect->tlvs[em_ap_cap_radio_tlv_advanced].len, sizeof(em_ap_radio_advanced_cap_t));
+    sect = report.get_radio(1);
+    EXPECT_EQ(sect->ruid[5], 2);
+    EXPECT_NE(sect->tlvs[em_ap_cap_radio_tlv_ht].value, nullptr);
+    EXPECT_NE(sect->tlvs[em_ap_cap_radio_tlv_advanced].value, nullptr);
+    // too short for a RUID, left out
+    EXPECT_EQ(sect->tlvs[em_ap_cap_radio_tlv_he].value, nullptr);
+
+    ASSERT_EQ(em_ap_cap_report_t::decode_op_classes(&report.get_radio(0)->tlvs[em_ap_cap_radio_tlv_basic], op_classes, 4), 2u);
+    EXPECT_EQ(op_classes[0].op_class, 81u);
+    EXPECT_EQ(op_classes[0].id.type, em_op_class_type_capability);
+    EXPECT_EQ(op_classes[0].max_tx_power, 20);
+    EXPECT_EQ(op_classes[0].num_channels, 3u);
+    EXPECT_EQ(op_classes[0].channels[2], 11u);
+    EXPECT_EQ(op_classes[1].op_class, 83u);
+    EXPECT_EQ(op_classes[1].num_channels, 0u);
+    EXPECT_EQ(op_classes[1].id.ruid[5], 1);
+
+    memset(&he, 0xff, sizeof(he));
+    em_ap_cap_report_t::copy(&report.get_radio(1)->tlvs[em_ap_cap_radio_tlv_ht], &he, sizeof(he));
+    EXPECT_EQ(he.ruid[5], 2);
+    EXPECT_EQ(he.sprt_mcs_len, 0);
+    EXPECT_EQ(reinterpret_cast<unsigned char *>(&he)[sizeof(he) - 1], 0);
+    std::cout << "Exiting GroupByRadio test" << std::endl;
+}
+
+/**
+* @brief Test that malformed reports are refused
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Parse a report whose last TLV runs past the end | Length cut by 1 | -1 is returned | Should Pass |
+* | 02| Parse an advanced capabilities TLV that is not a whole number of entries | None | -1 is returned | Should Pass |
+* | 03| Decode a basic capabilities TLV whose last operating class is cut | None | Only the complete class | Should Pass |
+*/
+TEST(em_ap_cap_report_t_Test, Malformed) {
+    std::cout << "Entering Malformed test" << std::endl;
+    em_ap_cap_report_t cut, adv;
+    std::vector<unsigned char> buff, val = basic_val(1);
+    em_op_class_info_t op_classes[4];
+    em_ap_cap_tlv_ref_t basic;
+
+    add_tlv(buff, em_tlv_type_ap_radio_basic_cap, val);
+    EXPECT_EQ(cut.parse(buff.data(), static_cast<unsigned int>(buff.size()) - 1), -1);
+
+    buff.clear();
+    add_tlv(buff, em_tlv_type_ap_radio_advanced_cap, ruid_val(1, 2));
+    EXPECT_EQ(adv.parse(buff.data(), static_cast<unsigned int>(buff.size())), -1);
+
+    // op class 81 complete, 83 claims a channel it does not carry
+    val.back() = 1;
+    basic.value = val.data();
+    basic.len = static_cast<unsigned int>(val.size());
+    EXPECT_EQ(em_ap_cap_report_t::decode_op_classes(&basic, op_classes, 4), 1u);
+    std::cout << "Exiting Malformed test" << std::endl;
+}
@@ -0,0 +1,132 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include "em_ap_mld_sync.h"
+
+/**
+* @brief Test that an unchanged configuration is skipped only once the agent acknowledged it
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Nothing sent yet | TLV A | Not acked, to be sent | Should Pass |
+* | 02| TLV A sent, no ACK | msg id 7 | Still not acked, to be sent again | Should Pass |
+* | 03| ACK with another message id | msg id 8 | Not matched | Should Pass |
+* | 04| ACK of the request | msg id 7 | TLV A acked and skipped, TLV B and a prefix of A are not | Should Pass |
+* | 05| Reset | - | TLV A to be sent again | Should Pass |
+*/
+TEST(em_ap_mld_sync_t_Test, UnchangedSkipped) {
+    std::cout << "Entering UnchangedSkipped test" << std::endl;
+    em_ap_mld_sync_t sync;
+    unsigned char a[12], b[12];
+
+    memset(a, 0xa, sizeof(a));
+    memset(b, 0xa, sizeof(b));
+    b[11] = 0xb;
+
+    EXPECT_FALSE(sync.is_acked(a, sizeof(a)));
+    sync.sent(7, a, sizeof(a));
+    EXPECT_FALSE(sync.is_acked(a, sizeof(a)));
+    EXPECT_TRUE(sync.is_pending(7));
+
+    EXPECT_FALSE(sync.ack(8));
+    EXPECT_FALSE(sync.is_acked(a, sizeof(a)));
+
+    EXPECT_TRUE(sync.ack(7));
+    EXPECT_FALSE(sync.is_pending(7));
+    EXPECT_EQ(sync.pending(), 0u);
+    EXPECT_TRUE(sync.is_acked(a, sizeof(a)));
+    EXPECT_FALSE(sync.is_acked(b, sizeof(b)));
+    EXPECT_FALSE(sync.is_acked(a, sizeof(a) - 1));
+    EXPECT_FALSE(sync.ack(7));
+
+    sync.reset();
+    EXPECT_FALSE(sync.is_acked(a, sizeof(a)));
+    std::cout << "Exiting UnchangedSkipped test" << std::endl;
+}
+
+/**
+* @brief Test the matching of ACKs to the requests on their message ids
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| TLV A then TLV B sent, ACK of A | msg ids 1 and 2 | A acked, B still pending | Should Pass |
+* | 02| ACK of B | msg id 2 | B acked | Should Pass |
+* | 03| A, B and A again sent, ACK of the last | msg ids 3, 4, 5 | A acked, the older requests dropped | Should Pass |
+* | 04| Message id reused | msg id 6 twice | One request, with the last TLV | Should Pass |
+* | 05| More requests than EM_AP_MLD_SYNC_MAX_PENDING | msg ids 100 on | Oldest dropped, table bounded | Should Pass |
+*/
+TEST(em_ap_mld_sync_t_Test, AckMatching) {
+    std::cout << "Entering AckMatching test" << std::endl;
+    em_ap_mld_sync_t sync;
+    unsigned char a[4] = {1, 2, 3, 4}, b[6] = {5, 6, 7, 8, 9, 10};
+    unsigned int i;
+
+    sync.sent(1, a, sizeof(a));
+    sync.sent(2, b, sizeof(b));
+    EXPECT_TRUE(sync.ack(1));
+    EXPECT_TRUE(sync.is_acked(a, sizeof(a)));
+    EXPECT_TRUE(sync.is_pending(2));
+    EXPECT_TRUE(sync.ack(2));
+    EXPECT_TRUE(sync.is_acked(b, sizeof(b)));
+
+    sync.sent(3, a, sizeof(a));
+    sync.sent(4, b, sizeof(b));
+    sync.sent(5, a, sizeof(a));
+    EXPECT_TRUE(sync.ack(5));
+    EXPECT_TRUE(sync.is_acked(a, sizeof(a)));
+    EXPECT_EQ(sync.pending(), 0u);
+    EXPECT_FALSE(sync.ack(4));
+
+    sync.sent(6, a, sizeof(a));
+    sync.sent(6, b, sizeof(b));
+    EXPECT_EQ(sync.pending(), 1u);
+    EXPECT_TRUE(sync.ack(6));
+    EXPECT_TRUE(sync.is_acked(b, sizeof(b)));
+
+    for (i = 0; i < EM_AP_MLD_SYNC_MAX_PENDING + 2; i++) {
+        sync.sent(static_cast<unsigned short>(100 + i), a, sizeof(a));
+    }
+    EXPECT_EQ(sync.pending(), static_cast<unsigned int>(EM_AP_MLD_SYNC_MAX_PENDING));
+    EXPECT_FALSE(sync.is_pending(100));
+    EXPECT_FALSE(sync.is_pending(101));
+    EXPECT_TRUE(sync.is_pending(102));
+    EXPECT_TRUE(sync.ack(static_cast<unsigned short>(100 + EM_AP_MLD_SYNC_MAX_PENDING + 1)));
+    EXPECT_EQ(sync.pending(), 0u);
+    std::cout << "Exiting AckMatching test" << std::endl;
+}
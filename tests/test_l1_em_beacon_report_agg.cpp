@@ -0,0 +1,180 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "em_beacon_report_agg.h"
+#include "test_l1_utils.h"
+
+// Measurement Report element of a Beacon Report, the fixed fields then extra bytes of subelements
+static void add_report(std::vector<unsigned char>& elems, unsigned int bss, unsigned char channel, unsigned char rcpi,
+        unsigned int extra = 0)
+{
+    std::vector<unsigned char> elem(31 + extra, 0);
+
+    elem[0] = 39;
+    elem[1] = static_cast<unsigned char>(29 + extra);
+    elem[2 + 2] = 5;
+    elem[2 + 3] = 115;
+    elem[2 + 4] = channel;
+    elem[2 + 16] = rcpi;
+    elem[2 + 17] = 30;
+    make_mac(bss, &elem[2 + 18]);
+    elems.insert(elems.end(), elem.begin(), elem.end());
+}
+
+// the BSS of each element of a response, in order
+static std::vector<unsigned int> get_bsss(const em_beacon_report_agg_report_t *report)
+{
+    std::vector<unsigned int> bsss;
+    unsigned int i, off = 0;
+
+    for (i = 0; i < report->count; i++) {
+        bsss.push_back(report->elems[off + 2 + 18 + 5]);
+        off += 2U + report->elems[off + 1];
+    }
+    EXPECT_EQ(off, report->len);
+
+    return bsss;
+}
+
+/**
+* @brief Test that the reports of a STA are sent once every queried channel is reported
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Query channels 36 and 149 | Reports on 36 only | Nothing ready | Should Pass |
+* | 02| Report on 149, BSS 1 again on 36 | Stronger BSS 1 | One response of 3 BSSs, strongest first | Should Pass |
+* | 03| Report of an unqueried STA | None | Ready at the deadline only | Should Pass |
+*/
+TEST(em_beacon_report_agg_t_Test, Complete) {
+    std::cout << "Entering Complete test" << std::endl;
+    em_beacon_report_agg_t agg;
+    em_beacon_report_agg_report_t report;
+    em_beacon_report_agg_stats_t stats;
+    std::vector<unsigned char> elems;
+    unsigned char channels[] = { 36, 149 };
+    mac_address_t sta, other;
+    bssid_t bssid;
+
+    make_mac(1, sta);
+    make_mac(2, other);
+    make_mac(100, bssid);
+
+    agg.expect(sta, channels, 2, 1000);
+    add_report(elems, 1, 36, 80);
+    add_report(elems, 2, 36, 120);
+    EXPECT_EQ(agg.add(sta, bssid, elems.data(), static_cast<unsigned int>(elems.size()), 2, 1100), 2u);
+    EXPECT_FALSE(agg.pop_ready(1200, &report));
+
+    elems.clear();
+    add_report(elems, 3, 149, 100);
+    add_report(elems, 1, 36, 140);
+    EXPECT_EQ(agg.add(sta, bssid, elems.data(), static_cast<unsigned int>(elems.size()), 2, 1300), 2u);
+    ASSERT_TRUE(agg.pop_ready(1300, &report));
+    EXPECT_EQ(memcmp(report.sta, sta, sizeof(mac_address_t)), 0);
+    EXPECT_EQ(memcmp(report.bssid, bssid, sizeof(bssid_t)), 0);
+    EXPECT_EQ(report.count, 3u);
+    EXPECT_EQ(get_bsss(&report), (std::vector<unsigned int>{ 1, 2, 3 }));
+    EXPECT_EQ(agg.get_pending(), 0u);
+
+    elems.clear();
+    add_report(elems, 4, 6, 90);
+    agg.add(other, bssid, elems.data(), static_cast<unsigned int>(elems.size()), 1, 2000);
+    EXPECT_FALSE(agg.pop_ready(2000 + EM_BEACON_REPORT_AGG_DEADLINE_MS - 1, &report));
+    ASSERT_TRUE(agg.pop_ready(2000 + EM_BEACON_REPORT_AGG_DEADLINE_MS, &report));
+    EXPECT_EQ(get_bsss(&report), (std::vector<unsigned int>{ 4 }));
+
+    // queried but never reported, dropped at the deadline without a response
+    agg.expect(other, channels, 1, 5000);
+    EXPECT_FALSE(agg.pop_ready(5000 + EM_BEACON_REPORT_AGG_DEADLINE_MS, &report));
+    EXPECT_EQ(agg.get_pending(), 0u);
+
+    agg.get_stats(&stats);
+    EXPECT_EQ(stats.reports, 3u);
+    EXPECT_EQ(stats.elems, 5u);
+    EXPECT_EQ(stats.duplicates, 1u);
+    EXPECT_EQ(stats.responses, 2u);
+    EXPECT_EQ(stats.complete, 1u);
+    std::cout << "Exiting Complete test" << std::endl;
+}
+
+/**
+* @brief Test that a response too long for the TLV is compacted
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Report 10 BSSs with 60 bytes of subelements each | 910 bytes | Subelements stripped, all 10 sent | Should Pass |
+* | 02| Report a further, weaker BSS | 11 BSSs | The weakest is not kept | Should Pass |
+*/
+TEST(em_beacon_report_agg_t_Test, Compact) {
+    std::cout << "Entering Compact test" << std::endl;
+    em_beacon_report_agg_t agg;
+    em_beacon_report_agg_report_t report;
+    em_beacon_report_agg_stats_t stats;
+    std::vector<unsigned char> elems;
+    std::vector<unsigned int> bsss;
+    mac_address_t sta;
+    bssid_t bssid;
+    unsigned int i;
+
+    make_mac(1, sta);
+    make_mac(100, bssid);
+
+    for (i = 0; i < EM_BEACON_REPORT_AGG_MAX_ELEMS; i++) {
+        add_report(elems, i + 1, static_cast<unsigned char>(36 + i * 4), static_cast<unsigned char>(100 + i), 60);
+    }
+    EXPECT_EQ(agg.add(sta, bssid, elems.data(), static_cast<unsigned int>(elems.size()), EM_BEACON_REPORT_AGG_MAX_ELEMS, 0),
+            static_cast<unsigned int>(EM_BEACON_REPORT_AGG_MAX_ELEMS));
+    elems.clear();
+    add_report(elems, 50, 6, 10);
+    EXPECT_EQ(agg.add(sta, bssid, elems.data(), static_cast<unsigned int>(elems.size()), 1, 0), 0u);
+
+    ASSERT_TRUE(agg.pop_ready(EM_BEACON_REPORT_AGG_DEADLINE_MS, &report));
+    EXPECT_EQ(report.count, static_cast<unsigned int>(EM_BEACON_REPORT_AGG_MAX_ELEMS));
+    EXPECT_EQ(report.len, EM_BEACON_REPORT_AGG_MAX_ELEMS * 31u);
+    bsss = get_bsss(&report);
+    ASSERT_EQ(bsss.size(), static_cast<size_t>(EM_BEACON_REPORT_AGG_MAX_ELEMS));
+    EXPECT_EQ(bsss[0], static_cast<unsigned int>(EM_BEACON_REPORT_AGG_MAX_ELEMS));
+    EXPECT_EQ(bsss[EM_BEACON_REPORT_AGG_MAX_ELEMS - 1], 1u);
+
+    agg.get_stats(&stats);
+    EXPECT_EQ(stats.compacted, 1u);
+    std::cout << "Exiting Compact test" << std::endl;
+}
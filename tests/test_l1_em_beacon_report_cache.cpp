@@ -0,0 +1,159 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "em_beacon_report_cache.h"
+#include "test_l1_utils.h"
+
+// Measurement Report element of a Beacon Report, 26 bytes of body up to the Antenna ID
+static void add_report(std::vector<unsigned char>& elems, unsigned int bss, unsigned char channel, unsigned char rcpi)
+{
+    unsigned char elem[28];
+
+    memset(elem, 0, sizeof(elem));
+    elem[0] = 39;
+    elem[1] = 26;
+    elem[2 + 2] = 5;
+    elem[2 + 3] = 115;
+    elem[2 + 4] = channel;
+    elem[2 + 16] = rcpi;
+    elem[2 + 17] = 30;
+    make_mac(bss, &elem[2 + 18]);
+    elems.insert(elems.end(), elem, elem + sizeof(elem));
+}
+
+/**
+* @brief Test that the reports of a response are cached per BSSID and channel
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Add a response with 3 reports, BSS 1 on two channels | None | 3 entries | Should Pass |
+* | 02| Add a response with BSS 1 on channel 36 again | rcpi = 200 | Still 3 entries, the entry is refreshed | Should Pass |
+* | 03| Best BSS excluding BSS 1 | None | BSS 2 | Should Pass |
+* | 04| Add a truncated response | None | Only the complete reports are added | Should Pass |
+*/
+TEST(em_beacon_report_cache_t_Test, AddReports) {
+    std::cout << "Entering AddReports test" << std::endl;
+    em_beacon_report_cache_t cache;
+    em_beacon_report_entry_t entries[EM_BEACON_REPORT_MAX_PER_STA], best;
+    std::vector<unsigned char> elems;
+    unsigned char sta[6], bss1[6], bss2[6];
+
+    make_mac(1, sta);
+    make_mac(100, bss1);
+    make_mac(200, bss2);
+    add_report(elems, 100, 36, 120);
+    add_report(elems, 100, 6, 150);
+    add_report(elems, 200, 149, 140);
+    ASSERT_EQ(cache.add_reports(sta, elems.data(), static_cast<unsigned int>(elems.size()), 3, 1000), 3u);
+    ASSERT_EQ(cache.get_reports(sta, entries, EM_BEACON_REPORT_MAX_PER_STA), 3u);
+    EXPECT_EQ(entries[0].op_class, 115);
+    EXPECT_EQ(entries[0].rsni, 30);
+
+    elems.clear();
+    add_report(elems, 100, 36, 200);
+    ASSERT_EQ(cache.add_reports(sta, elems.data(), static_cast<unsigned int>(elems.size()), 1, 2000), 1u);
+    ASSERT_EQ(cache.get_reports(sta, entries, EM_BEACON_REPORT_MAX_PER_STA), 3u);
+    EXPECT_EQ(entries[0].rcpi, 200);
+    EXPECT_EQ(entries[0].time_ms, 2000u);
+
+    ASSERT_TRUE(cache.get_best(sta, NULL, &best));
+    EXPECT_EQ(memcmp(best.bssid, bss1, sizeof(bssid_t)), 0);
+    ASSERT_TRUE(cache.get_best(sta, bss1, &best));
+    EXPECT_EQ(memcmp(best.bssid, bss2, sizeof(bssid_t)), 0);
+    EXPECT_EQ(best.channel, 149);
+
+    make_mac(2, sta);
+    elems.clear();
+    add_report(elems, 100, 36, 120);
+    add_report(elems, 200, 36, 120);
+    EXPECT_EQ(cache.add_reports(sta, elems.data(), static_cast<unsigned int>(elems.size()) - 1, 2, 1000), 1u);
+    EXPECT_EQ(cache.count(), 2u);
+    std::cout << "Exiting AddReports test" << std::endl;
+}
+
+/**
+* @brief Test freshness, age-out and the per STA limit
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Add one more BSS than a STA can hold | None | The oldest BSS is replaced | Should Pass |
+* | 02| Check freshness around EM_BEACON_REPORT_FRESH_MS | None | Fresh, then not | Should Pass |
+* | 03| Response without reports | None | The STA is fresh | Should Pass |
+* | 04| Age out past EM_BEACON_REPORT_MAX_AGE_MS | None | Old entries and STAs removed | Should Pass |
+*/
+TEST(em_beacon_report_cache_t_Test, FreshnessAndAgeOut) {
+    std::cout << "Entering FreshnessAndAgeOut test" << std::endl;
+    em_beacon_report_cache_t cache;
+    em_beacon_report_entry_t entries[EM_BEACON_REPORT_MAX_PER_STA + 1], entry;
+    unsigned char sta[6], other[6];
+    unsigned int i;
+
+    make_mac(1, sta);
+    make_mac(2, other);
+    EXPECT_FALSE(cache.is_fresh(sta, 1000));
+    for (i = 0; i <= EM_BEACON_REPORT_MAX_PER_STA; i++) {
+        memset(&entry, 0, sizeof(entry));
+        make_mac(100 + i, entry.bssid);
+        entry.channel = 36;
+        entry.rcpi = 100;
+        entry.time_ms = 1000 + i;
+        cache.update(sta, &entry);
+    }
+    ASSERT_EQ(cache.get_reports(sta, entries, EM_BEACON_REPORT_MAX_PER_STA + 1), static_cast<unsigned int>(EM_BEACON_REPORT_MAX_PER_STA));
+    make_mac(100 + EM_BEACON_REPORT_MAX_PER_STA, entry.bssid);
+    EXPECT_EQ(memcmp(entries[0].bssid, entry.bssid, sizeof(bssid_t)), 0);
+
+    EXPECT_TRUE(cache.is_fresh(sta, 1000 + EM_BEACON_REPORT_FRESH_MS));
+    EXPECT_FALSE(cache.is_fresh(sta, 1000 + EM_BEACON_REPORT_MAX_PER_STA + EM_BEACON_REPORT_FRESH_MS));
+
+    EXPECT_EQ(cache.add_reports(other, NULL, 0, 0, 50000), 0u);
+    EXPECT_TRUE(cache.is_fresh(other, 50000));
+    EXPECT_EQ(cache.get_reports(other, entries, 1), 0u);
+
+    EXPECT_EQ(cache.age_out(1000), 0u);
+    EXPECT_EQ(cache.age_out(1008 + EM_BEACON_REPORT_MAX_AGE_MS), 8u);
+    EXPECT_EQ(cache.get_reports(sta, entries, EM_BEACON_REPORT_MAX_PER_STA), 8u);
+    EXPECT_EQ(cache.count(), 2u);
+    EXPECT_EQ(cache.age_out(50000 + EM_BEACON_REPORT_MAX_AGE_MS), 8u);
+    EXPECT_EQ(cache.count(), 0u);
+    EXPECT_FALSE(cache.remove(sta));
+    std::cout << "Exiting FreshnessAndAgeOut test" << std::endl;
+}
@@ -0,0 +1,249 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include "em_bh_steer.h"
+#include "test_l1_utils.h"
+
+/*
+ * A chain of agents: agent 1 is wired, agent n + 1 is associated with the backhaul BSS
+ * of agent n. The AL MAC of agent n is n, its bSTA 0x40 + n, its backhaul BSS 0x80 + n.
+ */
+static void make_chain(unsigned int num, em_bh_steer_node_t *nodes, em_bh_steer_bss_t *bss)
+{
+    unsigned int i;
+
+    for (i = 0; i < num; i++) {
+        memset(&nodes[i], 0, sizeof(em_bh_steer_node_t));
+        make_mac(i + 1, nodes[i].al_mac);
+        if (i != 0) {
+            make_mac(0x40 + i + 1, nodes[i].bsta);
+            make_mac(0x80 + i, nodes[i].bssid);
+            nodes[i].rcpi = 100;
+        }
+        memset(&bss[i], 0, sizeof(em_bh_steer_bss_t));
+        make_mac(i + 1, bss[i].al_mac);
+        make_mac(0x80 + i + 1, bss[i].bssid);
+        bss[i].op_class = 128;
+        bss[i].channel = 36;
+    }
+}
+
+static void add_meas(em_beacon_report_cache_t *meas, const unsigned char *bsta, unsigned int bss, unsigned char rcpi,
+                     unsigned long long now)
+{
+    em_beacon_report_entry_t entry;
+
+    memset(&entry, 0, sizeof(entry));
+    make_mac(0x80 + bss, entry.bssid);
+    entry.op_class = 128;
+    entry.channel = 36;
+    entry.rcpi = rcpi;
+    entry.time_ms = now;
+    meas->update(bsta, &entry);
+}
+
+/**
+* @brief Test that an agent is steered to a parent closer to the controller
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Agent 3 two hops away, measured by agent 1 and its current parent | rcpi 100 and 120 | Steered to agent 1, 2 hops to 1 | Should Pass |
+* | 02| The measurement of agent 1 below min_rcpi | rcpi 60 | No decision | Should Pass |
+*/
+TEST(em_bh_steer_t_Test, CloserParent) {
+    std::cout << "Entering CloserParent test" << std::endl;
+    em_bh_steer_t steer;
+    em_beacon_report_cache_t meas;
+    em_bh_steer_node_t nodes[3];
+    em_bh_steer_bss_t bss[3];
+    em_bh_steer_decision_t decisions[EM_BH_STEER_MAX_DECISIONS];
+    unsigned long long now = 100000;
+    unsigned char target[6];
+
+    make_chain(3, nodes, bss);
+    add_meas(&meas, nodes[2].bsta, 1, 100, now);
+    add_meas(&meas, nodes[2].bsta, 2, 120, now);
+    add_meas(&meas, nodes[1].bsta, 1, 120, now);
+
+    ASSERT_EQ(steer.evaluate(now, nodes, 3, bss, 3, &meas, decisions, EM_BH_STEER_MAX_DECISIONS), 1u);
+    make_mac(0x81, target);
+    EXPECT_EQ(decisions[0].action, em_bh_steer_action_steer);
+    EXPECT_EQ(memcmp(decisions[0].al_mac, nodes[2].al_mac, sizeof(mac_address_t)), 0);
+    EXPECT_EQ(memcmp(decisions[0].target, target, sizeof(bssid_t)), 0);
+    EXPECT_EQ(decisions[0].hops, 2u);
+    EXPECT_EQ(decisions[0].target_hops, 1u);
+    EXPECT_EQ(decisions[0].channel, 36);
+
+    add_meas(&meas, nodes[2].bsta, 1, 60, now);
+    EXPECT_EQ(steer.evaluate(now, nodes, 3, bss, 3, &meas, decisions, EM_BH_STEER_MAX_DECISIONS), 0u);
+    std::cout << "Exiting CloserParent test" << std::endl;
+}
+
+/**
+* @brief Test that an agent is never steered to a BSS of its own subtree
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Weak agent 2 measured strongly by its child, agent 3 | rcpi 50 and 150 | No decision | Should Pass |
+* | 02| Agent 2 measured by another backhaul BSS of its parent | rcpi 150 | Steered to that BSS, as many hops | Should Pass |
+*/
+TEST(em_bh_steer_t_Test, Subtree) {
+    std::cout << "Entering Subtree test" << std::endl;
+    em_bh_steer_t steer;
+    em_beacon_report_cache_t meas;
+    em_bh_steer_node_t nodes[3];
+    em_bh_steer_bss_t bss[4];
+    em_bh_steer_decision_t decisions[EM_BH_STEER_MAX_DECISIONS];
+    unsigned long long now = 100000;
+
+    make_chain(3, nodes, bss);
+    nodes[1].rcpi = 50;
+    add_meas(&meas, nodes[1].bsta, 3, 150, now);
+    add_meas(&meas, nodes[2].bsta, 2, 120, now);
+    EXPECT_EQ(steer.evaluate(now, nodes, 3, bss, 3, &meas, decisions, EM_BH_STEER_MAX_DECISIONS), 0u);
+
+    // a second backhaul BSS of agent 1, on another band
+    memset(&bss[3], 0, sizeof(em_bh_steer_bss_t));
+    make_mac(1, bss[3].al_mac);
+    make_mac(0x84, bss[3].bssid);
+    bss[3].op_class = 81;
+    bss[3].channel = 6;
+    add_meas(&meas, nodes[1].bsta, 4, 150, now);
+
+    ASSERT_EQ(steer.evaluate(now, nodes, 3, bss, 4, &meas, decisions, EM_BH_STEER_MAX_DECISIONS), 1u);
+    EXPECT_EQ(memcmp(decisions[0].al_mac, nodes[1].al_mac, sizeof(mac_address_t)), 0);
+    EXPECT_EQ(memcmp(decisions[0].target, bss[3].bssid, sizeof(bssid_t)), 0);
+    EXPECT_EQ(decisions[0].target_hops, 1u);
+    EXPECT_EQ(decisions[0].channel, 6);
+    std::cout << "Exiting Subtree test" << std::endl;
+}
+
+/**
+* @brief Test that an agent without fresh measurements is measured first
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| No measurements, agent 2 one hop away and strong, agent 3 two hops away | empty cache | Measure agent 3 only | Should Pass |
+* | 02| Agent 3 measured before fresh_ms | time_ms = now - 40000 | Measure agent 3 | Should Pass |
+*/
+TEST(em_bh_steer_t_Test, Measure) {
+    std::cout << "Entering Measure test" << std::endl;
+    em_bh_steer_t steer;
+    em_beacon_report_cache_t meas;
+    em_bh_steer_node_t nodes[3];
+    em_bh_steer_bss_t bss[3];
+    em_bh_steer_decision_t decisions[EM_BH_STEER_MAX_DECISIONS];
+    unsigned long long now = 100000;
+
+    make_chain(3, nodes, bss);
+    ASSERT_EQ(steer.evaluate(now, nodes, 3, bss, 3, &meas, decisions, EM_BH_STEER_MAX_DECISIONS), 1u);
+    EXPECT_EQ(decisions[0].action, em_bh_steer_action_measure);
+    EXPECT_EQ(memcmp(decisions[0].bsta, nodes[2].bsta, sizeof(mac_address_t)), 0);
+
+    add_meas(&meas, nodes[2].bsta, 1, 150, now - 40000);
+    ASSERT_EQ(steer.evaluate(now, nodes, 3, bss, 3, &meas, decisions, EM_BH_STEER_MAX_DECISIONS), 1u);
+    EXPECT_EQ(decisions[0].action, em_bh_steer_action_measure);
+    EXPECT_EQ(steer.get_stats().measures, 2u);
+    std::cout << "Exiting Measure test" << std::endl;
+}
+
+/**
+* @brief Test the completion latency, the timeouts and the backoff of an agent
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Start a steer, complete it 800 ms later | success | Latency 800, completed 1 | Should Pass |
+* | 02| Complete it again | | false | Should Pass |
+* | 03| Evaluate the agent during its backoff | better parent measured | No decision | Should Pass |
+* | 04| Start a steer and let timeout_ms pass | expire() | 1 timeout, not pending | Should Pass |
+*/
+TEST(em_bh_steer_t_Test, Latency) {
+    std::cout << "Entering Latency test" << std::endl;
+    em_bh_steer_t steer;
+    em_beacon_report_cache_t meas;
+    em_bh_steer_node_t nodes[3];
+    em_bh_steer_bss_t bss[3];
+    em_bh_steer_decision_t decisions[EM_BH_STEER_MAX_DECISIONS];
+    em_bh_steer_agent_stats_t stats;
+    unsigned long long now = 100000, latency = 0;
+
+    make_chain(3, nodes, bss);
+    steer.started(nodes[2].al_mac, now);
+    EXPECT_TRUE(steer.is_pending(nodes[2].al_mac));
+    EXPECT_TRUE(steer.completed(nodes[2].al_mac, true, now + 800, &latency));
+    EXPECT_EQ(latency, 800u);
+    EXPECT_FALSE(steer.is_pending(nodes[2].al_mac));
+    ASSERT_TRUE(steer.get_agent_stats(nodes[2].al_mac, &stats));
+    EXPECT_EQ(stats.steers, 1u);
+    EXPECT_EQ(stats.completed, 1u);
+    EXPECT_EQ(stats.last_latency_ms, 800u);
+    EXPECT_FALSE(steer.completed(nodes[2].al_mac, true, now + 900, &latency));
+
+    add_meas(&meas, nodes[2].bsta, 1, 150, now + 1000);
+    add_meas(&meas, nodes[1].bsta, 1, 150, now + 1000);
+    EXPECT_EQ(steer.evaluate(now + 1000, nodes, 3, bss, 3, &meas, decisions, EM_BH_STEER_MAX_DECISIONS), 0u);
+
+    steer.started(nodes[1].al_mac, now);
+    EXPECT_EQ(steer.expire(now + steer.get_params().timeout_ms - 1), 0u);
+    EXPECT_EQ(steer.expire(now + steer.get_params().timeout_ms), 1u);
+    EXPECT_FALSE(steer.is_pending(nodes[1].al_mac));
+    ASSERT_TRUE(steer.get_agent_stats(nodes[1].al_mac, &stats));
+    EXPECT_EQ(stats.timeouts, 1u);
+    EXPECT_EQ(steer.get_stats().timeouts, 1u);
+    std::cout << "Exiting Latency test" << std::endl;
+}
@@ -0,0 +1,150 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include "em_blocklist.h"
+#include "test_l1_utils.h"
+
+
+/**
+* @brief Test blocking and unblocking STAs
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Block 500 STAs from one BSS indefinitely | None | All blocked from that BSS only | Should Pass |
+* | 02| Look up 1000 STAs that are not blocked | None | None blocked, most rejected by the bloom filter | Should Pass |
+* | 03| Unblock every other STA | None | Half of them left | Should Pass |
+* | 04| Block past EM_BLOCKLIST_MAX | None | Refused | Should Pass |
+*/
+TEST(em_blocklist_t_Test, BlockAndUnblock) {
+    std::cout << "Entering BlockAndUnblock test" << std::endl;
+    em_blocklist_t list;
+    em_blocklist_stats_t stats;
+    unsigned char sta[6], bss[6], other[6];
+    unsigned int i;
+
+    make_mac(60000, bss);
+    make_mac(60001, other);
+    for (i = 0; i < 500; i++) {
+        make_mac(i, sta);
+        ASSERT_EQ(list.block(sta, bss, 0, 1000), 0);
+    }
+    EXPECT_EQ(list.count(), 500u);
+    for (i = 0; i < 500; i++) {
+        make_mac(i, sta);
+        EXPECT_TRUE(list.is_blocked(sta, bss));
+        EXPECT_FALSE(list.is_blocked(sta, other));
+    }
+
+    for (i = 1000; i < 2000; i++) {
+        make_mac(i, sta);
+        EXPECT_FALSE(list.is_blocked(sta, bss));
+    }
+    list.get_stats(&stats);
+    EXPECT_EQ(stats.lookups, 2000u);
+    EXPECT_EQ(stats.hits, 500u);
+    EXPECT_GT(stats.bloom_rejects, 1200u);
+
+    for (i = 0; i < 500; i += 2) {
+        make_mac(i, sta);
+        EXPECT_TRUE(list.unblock(sta, bss));
+        EXPECT_FALSE(list.unblock(sta, bss));
+    }
+    EXPECT_EQ(list.count(), 250u);
+    for (i = 0; i < 500; i++) {
+        make_mac(i, sta);
+        EXPECT_EQ(list.is_blocked(sta, bss), (i % 2) == 1);
+    }
+
+    for (i = 0; list.count() < EM_BLOCKLIST_MAX; i++) {
+        make_mac(i, sta);
+        ASSERT_EQ(list.block(sta, other, 0, 1000), 0);
+    }
+    make_mac(i, sta);
+    EXPECT_EQ(list.block(sta, other, 0, 1000), -1);
+    std::cout << "Exiting BlockAndUnblock test" << std::endl;
+}
+
+/**
+* @brief Test the expiry of timed blocks
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Block STA 1 for 5 s, STA 2 for 60 s, STA 3 indefinitely | None | 3 blocked | Should Pass |
+* | 02| Refresh STA 1 for 10 s at 4 s | None | Still blocked at 9 s, expired at 14 s | Should Pass |
+* | 03| Expire at 61 s and much later | None | STA 2 expired, STA 3 blocked | Should Pass |
+* | 04| Make STA 3 timed, then indefinite again | None | Never expires | Should Pass |
+*/
+TEST(em_blocklist_t_Test, Expiry) {
+    std::cout << "Entering Expiry test" << std::endl;
+    em_blocklist_t list;
+    em_blocklist_stats_t stats;
+    unsigned char sta1[6], sta2[6], sta3[6], bss[6];
+    unsigned long long base = 1000000;
+
+    make_mac(1, sta1);
+    make_mac(2, sta2);
+    make_mac(3, sta3);
+    make_mac(100, bss);
+    ASSERT_EQ(list.block(sta1, bss, 5000, base), 0);
+    ASSERT_EQ(list.block(sta2, bss, 60000, base), 0);
+    ASSERT_EQ(list.block(sta3, bss, 0, base), 0);
+    EXPECT_EQ(list.expire(base + 1000), 0u);
+
+    ASSERT_EQ(list.block(sta1, bss, 10000, base + 4000), 0);
+    EXPECT_EQ(list.expire(base + 9000), 0u);
+    EXPECT_TRUE(list.is_blocked(sta1, bss));
+    EXPECT_EQ(list.expire(base + 14000), 1u);
+    EXPECT_FALSE(list.is_blocked(sta1, bss));
+
+    EXPECT_EQ(list.expire(base + 61000), 1u);
+    EXPECT_FALSE(list.is_blocked(sta2, bss));
+    EXPECT_EQ(list.expire(base + 10000000), 0u);
+    EXPECT_TRUE(list.is_blocked(sta3, bss));
+
+    ASSERT_EQ(list.block(sta3, bss, 1000, base + 10000000), 0);
+    ASSERT_EQ(list.block(sta3, bss, 0, base + 10000000), 0);
+    EXPECT_EQ(list.expire(base + 20000000), 0u);
+    EXPECT_TRUE(list.is_blocked(sta3, bss));
+
+    list.get_stats(&stats);
+    EXPECT_EQ(stats.entries, 1u);
+    EXPECT_EQ(stats.expired, 2u);
+    std::cout << "Exiting Expiry test" << std::endl;
+}
@@ -0,0 +1,243 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <string>
+#include <vector>
+#include "em_bus_dispatch.h"
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    bool blocked;                       // the handler waits until released
+    std::vector<std::string> seen;
+} test_dispatch_ctx_t;
+
+static test_dispatch_ctx_t s_ctx = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, false, {} };
+
+static void test_handler(unsigned char *data, unsigned int len, void *arg)
+{
+    pthread_mutex_lock(&s_ctx.lock);
+    s_ctx.seen.push_back(std::string(static_cast<const char *>(arg)) + ":" +
+            std::string(reinterpret_cast<const char *>(data), len));
+    pthread_cond_broadcast(&s_ctx.cond);
+    while (s_ctx.blocked == true) {
+        pthread_cond_wait(&s_ctx.cond, &s_ctx.lock);
+    }
+    pthread_mutex_unlock(&s_ctx.lock);
+}
+
+// the key is the text before the first '=', payloads without one have no key
+static bool test_key(const unsigned char *data, unsigned int len, char *key, unsigned int key_len)
+{
+    const char *eq = static_cast<const char *>(memchr(data, '=', len));
+
+    if ((eq == NULL) || (static_cast<unsigned int>(eq - reinterpret_cast<const char *>(data)) >= key_len)) {
+        return false;
+    }
+    snprintf(key, key_len, "%.*s", static_cast<int>(eq - reinterpret_cast<const char *>(data)), data);
+
+    return true;
+}
+
+static void test_reset(bool blocked)
+{
+    pthread_mutex_lock(&s_ctx.lock);
+    s_ctx.blocked = blocked;
+    s_ctx.seen.clear();
+    pthread_mutex_unlock(&s_ctx.lock);
+}
+
+static void test_unblock()
+{
+    pthread_mutex_lock(&s_ctx.lock);
+    s_ctx.blocked = false;
+    pthread_cond_broadcast(&s_ctx.cond);
+    pthread_mutex_unlock(&s_ctx.lock);
+}
+
+static bool test_wait_seen(size_t num)
+{
+    struct timespec ts;
+    bool ok = true;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += 5;
+    pthread_mutex_lock(&s_ctx.lock);
+    while ((s_ctx.seen.size() < num) && (ok == true)) {
+        ok = (pthread_cond_timedwait(&s_ctx.cond, &s_ctx.lock, &ts) == 0);
+    }
+    ok = (s_ctx.seen.size() >= num);
+    pthread_mutex_unlock(&s_ctx.lock);
+
+    return ok;
+}
+
+static std::vector<std::string> test_get_seen()
+{
+    std::vector<std::string> seen;
+
+    pthread_mutex_lock(&s_ctx.lock);
+    seen = s_ctx.seen;
+    pthread_mutex_unlock(&s_ctx.lock);
+
+    return seen;
+}
+
+static char s_arg_a[] = "a", s_arg_b[] = "b";
+
+/**
+* @brief Test that the payloads are handled in the order they were posted across channels
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Post before start | One payload | Handled on the calling thread | Should Pass |
+* | 02| Post to two channels while the handler is held | a1 b1 a2 b2 | Handled in the posted order | Should Pass |
+* | 03| Stop with payloads queued | Held handler | Queued ones counted as dropped | Should Pass |
+*/
+TEST(em_bus_dispatch_t_Test, Order) {
+    std::cout << "Entering Order test" << std::endl;
+    em_bus_dispatch_t disp;
+    em_bus_dispatch_stats_t stats;
+    std::vector<std::string> seen;
+    int a, b;
+
+    a = disp.add_channel("a", em_bus_dispatch_policy_drop_newest, 8, test_handler, NULL, s_arg_a);
+    b = disp.add_channel("b", em_bus_dispatch_policy_drop_oldest, 8, test_handler, NULL, s_arg_b);
+    ASSERT_GE(a, 0);
+    ASSERT_GE(b, 0);
+
+    test_reset(false);
+    EXPECT_TRUE(disp.post(a, "sync", 4));
+    seen = test_get_seen();
+    ASSERT_EQ(seen.size(), 1u);
+    EXPECT_EQ(seen[0], "a:sync");
+
+    ASSERT_EQ(disp.start(), 0);
+    EXPECT_EQ(disp.add_channel("c", em_bus_dispatch_policy_drop_newest, 8, test_handler, NULL, NULL), -1);
+    test_reset(true);
+    EXPECT_TRUE(disp.post(a, "0", 1));
+    ASSERT_TRUE(test_wait_seen(1));
+    EXPECT_TRUE(disp.post(a, "1", 1));
+    EXPECT_TRUE(disp.post(b, "1", 1));
+    EXPECT_TRUE(disp.post(a, "2", 1));
+    EXPECT_TRUE(disp.post(b, "2", 1));
+    test_unblock();
+    ASSERT_TRUE(test_wait_seen(5));
+    seen = test_get_seen();
+    EXPECT_EQ(seen, (std::vector<std::string>{ "a:0", "a:1", "b:1", "a:2", "b:2" }));
+
+    test_reset(true);
+    EXPECT_TRUE(disp.post(b, "3", 1));
+    ASSERT_TRUE(test_wait_seen(1));
+    EXPECT_TRUE(disp.post(b, "4", 1));
+    test_unblock();
+    disp.stop();
+    disp.get_stats(b, &stats);
+    EXPECT_EQ(stats.posted, 4u);
+    EXPECT_EQ(stats.dispatched + stats.dropped, 4u);
+    EXPECT_EQ(stats.depth, 0u);
+    EXPECT_EQ(stats.bytes, 0u);
+    std::cout << "Exiting Order test" << std::endl;
+}
+
+/**
+* @brief Test the drop and coalesce policies of a full queue
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Overflow a drop newest queue of 2 | 4 payloads | Last two refused | Should Pass |
+* | 02| Overflow a drop oldest queue of 2 | 4 payloads | First two dropped | Should Pass |
+* | 03| Post the same keys twice | x=1 y=1 x=2 z | x=1 replaced, x=2 after y=1 | Should Pass |
+*/
+TEST(em_bus_dispatch_t_Test, Policies) {
+    std::cout << "Entering Policies test" << std::endl;
+    em_bus_dispatch_t disp;
+    em_bus_dispatch_stats_t stats;
+    std::vector<std::string> seen;
+    int newest, oldest, coalesce;
+
+    newest = disp.add_channel("newest", em_bus_dispatch_policy_drop_newest, 2, test_handler, NULL, s_arg_a);
+    oldest = disp.add_channel("oldest", em_bus_dispatch_policy_drop_oldest, 2, test_handler, NULL, s_arg_b);
+    coalesce = disp.add_channel("coalesce", em_bus_dispatch_policy_coalesce, 4, test_handler, test_key, s_arg_a);
+    ASSERT_EQ(disp.start(), 0);
+
+    // the first payload holds the handler so that the others queue
+    test_reset(true);
+    EXPECT_TRUE(disp.post(coalesce, "hold", 4));
+    ASSERT_TRUE(test_wait_seen(1));
+
+    EXPECT_TRUE(disp.post(newest, "n1", 2));
+    EXPECT_TRUE(disp.post(newest, "n2", 2));
+    EXPECT_FALSE(disp.post(newest, "n3", 2));
+    EXPECT_FALSE(disp.post(newest, "n4", 2));
+    EXPECT_TRUE(disp.post(oldest, "o1", 2));
+    EXPECT_TRUE(disp.post(oldest, "o2", 2));
+    EXPECT_TRUE(disp.post(oldest, "o3", 2));
+    EXPECT_TRUE(disp.post(oldest, "o4", 2));
+    EXPECT_TRUE(disp.post(coalesce, "x=1", 3));
+    EXPECT_TRUE(disp.post(coalesce, "y=1", 3));
+    EXPECT_TRUE(disp.post(coalesce, "x=2", 3));
+    EXPECT_TRUE(disp.post(coalesce, "z", 1));
+
+    disp.get_stats(newest, &stats);
+    EXPECT_EQ(stats.dropped, 2u);
+    EXPECT_EQ(stats.depth, 2u);
+    EXPECT_EQ(stats.bytes, 4u);
+    disp.get_stats(oldest, &stats);
+    EXPECT_EQ(stats.dropped, 2u);
+    disp.get_stats(coalesce, &stats);
+    EXPECT_EQ(stats.coalesced, 1u);
+    EXPECT_EQ(stats.depth, 3u);
+    EXPECT_EQ(disp.get_lost(), 5u);
+
+    test_unblock();
+    ASSERT_TRUE(test_wait_seen(8));
+    seen = test_get_seen();
+    EXPECT_EQ(seen, (std::vector<std::string>{ "a:hold", "a:n1", "a:n2", "b:o3", "b:o4", "a:y=1", "a:x=2", "a:z" }));
+
+    // the counters of the last handler are updated after it returns
+    disp.stop();
+    disp.get_stats(coalesce, &stats);
+    EXPECT_EQ(stats.posted, 5u);
+    EXPECT_EQ(stats.dispatched, 4u);
+    EXPECT_EQ(stats.max_depth, 3u);
+    std::cout << "Exiting Policies test" << std::endl;
+}
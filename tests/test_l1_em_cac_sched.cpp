@@ -0,0 +1,290 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "em_cac_sched.h"
+#include "test_l1_utils.h"
+
+// CAC Completion Report TLV value of one radio, without detected pairs unless radar
+static std::vector<unsigned char> make_completion(const unsigned char *ruid, unsigned char op_class, unsigned char channel,
+    unsigned char status)
+{
+    std::vector<unsigned char> v;
+
+    v.push_back(1);
+    v.insert(v.end(), ruid, ruid + sizeof(mac_address_t));
+    v.push_back(op_class);
+    v.push_back(channel);
+    v.push_back(status);
+    if (status == 1) {
+        v.push_back(1);
+        v.push_back(op_class);
+        v.push_back(channel);
+    } else {
+        v.push_back(0);
+    }
+
+    return v;
+}
+
+/**
+* @brief Test the DFS channels and their CAC time
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| 2.4 and 6 GHz, 5 GHz outside 52 to 144 | 81/6, 131/37, 115/36, 125/149 | Not DFS, no CAC, available | Should Pass |
+* | 02| 20 MHz DFS channels | 118/52, 121/100 | DFS, EM_CAC_SCHED_CAC_MS | Should Pass |
+* | 03| 40, 80 and 160 MHz spans | 117/48 no, 119/60 yes, 128/42 no, 128/58 yes, 129/50 yes | Overlap with 52 to 144 | Should Pass |
+* | 04| Weather radar channels | 121/124, 128/122 | EM_CAC_SCHED_WEATHER_CAC_MS | Should Pass |
+*/
+TEST(em_cac_sched_t_Test, DfsChannels) {
+    std::cout << "Entering DfsChannels test" << std::endl;
+    em_cac_sched_t sched;
+    mac_address_t agent;
+
+    make_mac(1, agent);
+    EXPECT_FALSE(em_cac_sched_t::is_dfs(81, 6));
+    EXPECT_FALSE(em_cac_sched_t::is_dfs(131, 37));
+    EXPECT_FALSE(em_cac_sched_t::is_dfs(115, 36));
+    EXPECT_FALSE(em_cac_sched_t::is_dfs(125, 149));
+    EXPECT_EQ(em_cac_sched_t::get_cac_ms(115, 36), 0u);
+    EXPECT_EQ(sched.get_state(agent, 115, 36, 1000), em_cac_state_available);
+
+    EXPECT_TRUE(em_cac_sched_t::is_dfs(118, 52));
+    EXPECT_TRUE(em_cac_sched_t::is_dfs(121, 100));
+    EXPECT_EQ(em_cac_sched_t::get_cac_ms(118, 52), static_cast<unsigned int>(EM_CAC_SCHED_CAC_MS));
+    EXPECT_EQ(sched.get_state(agent, 118, 52, 1000), em_cac_state_unknown);
+
+    EXPECT_FALSE(em_cac_sched_t::is_dfs(117, 48));
+    EXPECT_TRUE(em_cac_sched_t::is_dfs(119, 60));
+    EXPECT_FALSE(em_cac_sched_t::is_dfs(128, 42));
+    EXPECT_TRUE(em_cac_sched_t::is_dfs(128, 58));
+    EXPECT_TRUE(em_cac_sched_t::is_dfs(129, 50));
+    EXPECT_FALSE(em_cac_sched_t::is_dfs(128, 155));
+
+    EXPECT_EQ(em_cac_sched_t::get_cac_ms(121, 124), static_cast<unsigned int>(EM_CAC_SCHED_WEATHER_CAC_MS));
+    EXPECT_EQ(em_cac_sched_t::get_cac_ms(128, 122), static_cast<unsigned int>(EM_CAC_SCHED_WEATHER_CAC_MS));
+    EXPECT_EQ(em_cac_sched_t::get_cac_ms(128, 106), static_cast<unsigned int>(EM_CAC_SCHED_CAC_MS));
+    std::cout << "Exiting DfsChannels test" << std::endl;
+}
+
+/**
+* @brief Test the channel states taken from the CAC Status and Completion Reports
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Status report | 52 available, 100 non occupied 60 s, 116 active 30 s | 3 channels, states as reported | Should Pass |
+* | 02| Timers run out | 61 s later | 100 and 116 unknown, 52 still available | Should Pass |
+* | 03| Truncated reports | Lists shorter than their counts | -1, states kept | Should Pass |
+* | 04| Completion reports | 60 cleared, 64 radar | 60 available, 64 non occupied for EM_CAC_SCHED_NON_OCC_MS | Should Pass |
+* | 05| New status report | Empty lists | Replaces the channels of the agent | Should Pass |
+*/
+TEST(em_cac_sched_t_Test, Reports) {
+    std::cout << "Entering Reports test" << std::endl;
+    em_cac_sched_t sched;
+    mac_address_t agent, ruid;
+    unsigned long long now = 10000000;
+    std::vector<unsigned char> v;
+    const unsigned char status[] = {
+        1, 118, 52, 0x00, 0x05,         // cleared 5 minutes ago
+        1, 121, 100, 0x00, 0x3c,        // 60 s of non-occupancy left
+        1, 121, 116, 0x00, 0x00, 0x1e   // 30 s of CAC left
+    };
+    const unsigned char empty[] = {0, 0, 0};
+
+    make_mac(1, agent);
+    make_mac(0x101, ruid);
+    ASSERT_EQ(sched.handle_status_report(agent, status, sizeof(status), now), 3);
+    EXPECT_EQ(sched.get_state(agent, 118, 52, now), em_cac_state_available);
+    EXPECT_EQ(sched.get_state(agent, 121, 100, now), em_cac_state_non_occupied);
+    EXPECT_EQ(sched.get_state(agent, 121, 116, now), em_cac_state_active);
+    EXPECT_EQ(sched.get_state(agent, 121, 104, now), em_cac_state_unknown);
+
+    now += 61000;
+    EXPECT_EQ(sched.get_state(agent, 118, 52, now), em_cac_state_available);
+    EXPECT_EQ(sched.get_state(agent, 121, 100, now), em_cac_state_unknown);
+    EXPECT_EQ(sched.get_state(agent, 121, 116, now), em_cac_state_unknown);
+
+    EXPECT_EQ(sched.handle_status_report(agent, status, sizeof(status) - 1, now), -1);
+    EXPECT_EQ(sched.handle_status_report(agent, status, 4, now), -1);
+    EXPECT_EQ(sched.handle_status_report(agent, status, 0, now), -1);
+    EXPECT_EQ(sched.get_state(agent, 118, 52, now), em_cac_state_available);
+
+    v = make_completion(ruid, 118, 60, 0);
+    ASSERT_EQ(sched.handle_completion_report(agent, v.data(), static_cast<unsigned int>(v.size()), now), 1);
+    EXPECT_EQ(sched.get_state(agent, 118, 60, now), em_cac_state_available);
+    v = make_completion(ruid, 118, 64, 1);
+    EXPECT_EQ(sched.handle_completion_report(agent, v.data(), static_cast<unsigned int>(v.size()) - 1, now), -1);
+    ASSERT_EQ(sched.handle_completion_report(agent, v.data(), static_cast<unsigned int>(v.size()), now), 1);
+    EXPECT_EQ(sched.get_state(agent, 118, 64, now), em_cac_state_non_occupied);
+    EXPECT_EQ(sched.get_state(agent, 118, 64, now + EM_CAC_SCHED_NON_OCC_MS - 1), em_cac_state_non_occupied);
+    EXPECT_EQ(sched.get_state(agent, 118, 64, now + EM_CAC_SCHED_NON_OCC_MS), em_cac_state_unknown);
+    EXPECT_EQ(sched.get_stats().radar, 1u);
+
+    ASSERT_EQ(sched.handle_status_report(agent, empty, sizeof(empty), now), 0);
+    EXPECT_EQ(sched.get_state(agent, 118, 52, now), em_cac_state_unknown);
+    EXPECT_EQ(sched.get_state(agent, 118, 60, now), em_cac_state_unknown);
+    EXPECT_EQ(sched.get_stats().status_reports, 2u);
+    std::cout << "Exiting Reports test" << std::endl;
+}
+
+/**
+* @brief Test that the agents of a backhaul branch take turns for their CACs
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Agents 1, 2 and 3 in the branch of agent 1 | Radios ask in order 1, 3, 2 | Radio 1 starts, the others wait | Should Pass |
+* | 02| Agent 4 in its own branch | Radio 4 asks | Starts alongside radio 1 | Should Pass |
+* | 03| Completion of radio 1 | Radio 2 asks before radio 3 | Radio 2 waits, radio 3 asked first and starts | Should Pass |
+* | 04| Radio 3 without completion | Its CAC time passes | Counted timed out, radio 2 starts | Should Pass |
+*/
+TEST(em_cac_sched_t_Test, Stagger) {
+    std::cout << "Entering Stagger test" << std::endl;
+    em_cac_sched_t sched;
+    mac_address_t agents[5], radios[5];
+    unsigned long long now = 1000;
+    std::vector<unsigned char> v;
+    unsigned int i;
+
+    for (i = 1; i <= 4; i++) {
+        make_mac(i, agents[i]);
+        make_mac(0x100 + i, radios[i]);
+    }
+    sched.set_group(agents[2], agents[1]);
+    sched.set_group(agents[3], agents[1]);
+
+    EXPECT_EQ(sched.admit(agents[1], radios[1], EM_CAC_SCHED_CAC_MS, now), em_cac_admit_started);
+    EXPECT_EQ(sched.admit(agents[1], radios[1], EM_CAC_SCHED_CAC_MS, now), em_cac_admit_started);
+    EXPECT_EQ(sched.admit(agents[3], radios[3], EM_CAC_SCHED_CAC_MS, now + 10), em_cac_admit_wait);
+    EXPECT_EQ(sched.admit(agents[2], radios[2], EM_CAC_SCHED_CAC_MS, now + 20), em_cac_admit_wait);
+    EXPECT_EQ(sched.admit(agents[4], radios[4], EM_CAC_SCHED_CAC_MS, now + 30), em_cac_admit_started);
+    EXPECT_EQ(sched.get_active(now + 30), 2u);
+
+    now += 5000;
+    v = make_completion(radios[1], 118, 52, 0);
+    ASSERT_EQ(sched.handle_completion_report(agents[1], v.data(), static_cast<unsigned int>(v.size()), now), 1);
+    EXPECT_EQ(sched.get_state(agents[1], 118, 52, now), em_cac_state_available);
+    EXPECT_EQ(sched.admit(agents[2], radios[2], EM_CAC_SCHED_CAC_MS, now), em_cac_admit_wait);
+    EXPECT_EQ(sched.admit(agents[3], radios[3], EM_CAC_SCHED_CAC_MS, now), em_cac_admit_started);
+    EXPECT_EQ(sched.get_active(now), 2u);
+
+    // radio 2 keeps asking, the CAC of radio 3 is never reported
+    for (now += 5000; now < 5000 + 1000 + EM_CAC_SCHED_CAC_MS; now += 5000) {
+        EXPECT_EQ(sched.admit(agents[2], radios[2], EM_CAC_SCHED_CAC_MS, now), em_cac_admit_wait);
+    }
+    EXPECT_EQ(sched.admit(agents[2], radios[2], EM_CAC_SCHED_CAC_MS, now), em_cac_admit_started);
+    EXPECT_EQ(sched.get_stats().timed_out, 2u);
+    EXPECT_EQ(sched.get_stats().completed, 1u);
+    EXPECT_EQ(sched.get_stats().started, 4u);
+    std::cout << "Exiting Stagger test" << std::endl;
+}
+
+/**
+* @brief Test the limit of the mesh, the radios that stop asking and the ones waiting too long
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Agents in their own branches | EM_CAC_SCHED_MAX_ACTIVE + 1 radios ask | The last one waits | Should Pass |
+* | 02| Radio of a busy branch stops asking | Another radio of the branch asks every 5 s | The first leaves the queue, the other starts when the CACs end | Should Pass |
+* | 03| Radio behind a weather radar CAC | Asks every 5 s | Refused after EM_CAC_SCHED_MAX_WAIT_MS | Should Pass |
+*/
+TEST(em_cac_sched_t_Test, Limits) {
+    std::cout << "Entering Limits test" << std::endl;
+    em_cac_sched_t sched;
+    mac_address_t agent, radio, extra, stale, next;
+    unsigned long long now = 1000, start;
+    unsigned int i;
+    em_cac_admit_t ret;
+
+    for (i = 0; i < EM_CAC_SCHED_MAX_ACTIVE; i++) {
+        make_mac(i + 1, agent);
+        make_mac(0x100 + i, radio);
+        EXPECT_EQ(sched.admit(agent, radio, EM_CAC_SCHED_CAC_MS, now), em_cac_admit_started);
+    }
+    make_mac(0x80, agent);
+    make_mac(0x180, extra);
+    EXPECT_EQ(sched.admit(agent, extra, EM_CAC_SCHED_CAC_MS, now), em_cac_admit_wait);
+    EXPECT_EQ(sched.get_active(now), static_cast<unsigned int>(EM_CAC_SCHED_MAX_ACTIVE));
+
+    make_mac(1, agent);
+    make_mac(0x200, stale);
+    make_mac(0x201, next);
+    EXPECT_EQ(sched.admit(agent, stale, EM_CAC_SCHED_CAC_MS, now), em_cac_admit_wait);
+    EXPECT_EQ(sched.admit(agent, next, EM_CAC_SCHED_CAC_MS, now + 1), em_cac_admit_wait);
+    for (now += 5000; now < 1000 + EM_CAC_SCHED_CAC_MS; now += 5000) {
+        EXPECT_EQ(sched.admit(agent, next, EM_CAC_SCHED_CAC_MS, now), em_cac_admit_wait);
+    }
+    now = 1000 + EM_CAC_SCHED_CAC_MS;
+    EXPECT_EQ(sched.admit(agent, next, EM_CAC_SCHED_CAC_MS, now), em_cac_admit_started);
+    EXPECT_EQ(sched.get_stats().timed_out, static_cast<unsigned int>(EM_CAC_SCHED_MAX_ACTIVE));
+
+    // the branch of agent 0x30 is off channel for a weather radar CAC
+    make_mac(0x30, agent);
+    make_mac(0x300, radio);
+    EXPECT_EQ(sched.admit(agent, radio, EM_CAC_SCHED_WEATHER_CAC_MS, now), em_cac_admit_started);
+    make_mac(0x301, radio);
+    start = now;
+    do {
+        ret = sched.admit(agent, radio, EM_CAC_SCHED_CAC_MS, now);
+        now += 5000;
+    } while ((ret == em_cac_admit_wait) && (now - start <= EM_CAC_SCHED_WEATHER_CAC_MS));
+    EXPECT_EQ(ret, em_cac_admit_refused);
+    EXPECT_EQ(now - 5000 - start, static_cast<unsigned long long>(EM_CAC_SCHED_MAX_WAIT_MS));
+    EXPECT_EQ(sched.get_stats().refused, 1u);
+    std::cout << "Exiting Limits test" << std::endl;
+}
@@ -0,0 +1,188 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <thread>
+#include <vector>
+#include "em_capture.h"
+
+#define TEST_CAPTURE_FILE   "/tmp/test_l1_em_capture.pcapng"
+
+/**
+* @brief Test that captured frames are read back with their direction, annotation and data
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Capture frames of odd lengths in both directions | 61 byte rx frame with a node, 64 byte tx frame without | Capture started, 2 frames written | Should Pass |
+* | 02| Write while the capture is stopped | - | Not in the file | Should Pass |
+* | 03| Read the capture | - | Same frames, directions and annotation in order, then the end | Should Pass |
+*/
+TEST(em_capture_t_Test, RoundTrip) {
+    std::cout << "Entering RoundTrip test" << std::endl;
+    unsigned char rx[61], tx[64];
+    em_capture_reader_t reader;
+    em_capture_frame_t frame;
+    uint64_t first_ts;
+
+    memset(rx, 0x5a, sizeof(rx));
+    memset(tx, 0xa5, sizeof(tx));
+    ASSERT_EQ(em_capture_t::start(TEST_CAPTURE_FILE, "eth0"), 0);
+    EXPECT_TRUE(em_capture_t::is_active());
+    EXPECT_EQ(em_capture_t::start(TEST_CAPTURE_FILE), -1);
+    em_capture_t::write(em_capture_dir_rx, "node=02:00:00:00:00:01 if=eth0 svc=ctrl", rx, sizeof(rx));
+    em_capture_t::write(em_capture_dir_tx, NULL, tx, sizeof(tx));
+    EXPECT_EQ(em_capture_t::stop(), 2u);
+    EXPECT_FALSE(em_capture_t::is_active());
+    em_capture_t::write(em_capture_dir_rx, NULL, rx, sizeof(rx));
+
+    ASSERT_EQ(reader.open(TEST_CAPTURE_FILE), 0);
+    ASSERT_EQ(reader.next(&frame), 1);
+    EXPECT_EQ(frame.dir, em_capture_dir_rx);
+    EXPECT_STREQ(frame.node, "node=02:00:00:00:00:01 if=eth0 svc=ctrl");
+    ASSERT_EQ(frame.len, sizeof(rx));
+    EXPECT_EQ(frame.orig_len, sizeof(rx));
+    EXPECT_EQ(memcmp(frame.data, rx, sizeof(rx)), 0);
+    first_ts = frame.ts_us;
+    EXPECT_NE(first_ts, 0u);
+
+    ASSERT_EQ(reader.next(&frame), 1);
+    EXPECT_EQ(frame.dir, em_capture_dir_tx);
+    EXPECT_STREQ(frame.node, "");
+    ASSERT_EQ(frame.len, sizeof(tx));
+    EXPECT_EQ(memcmp(frame.data, tx, sizeof(tx)), 0);
+    EXPECT_GE(frame.ts_us, first_ts);
+
+    EXPECT_EQ(reader.next(&frame), 0);
+    reader.close();
+    unlink(TEST_CAPTURE_FILE);
+    std::cout << "Exiting RoundTrip test" << std::endl;
+}
+
+/**
+* @brief Test that the frames of many threads all end up in the capture
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Capture from several threads | 8 threads, 200 frames each | 1600 frames read back in time order | Should Pass |
+*/
+TEST(em_capture_t_Test, Threads) {
+    std::cout << "Entering Threads test" << std::endl;
+    std::vector<std::thread> threads;
+    em_capture_reader_t reader;
+    em_capture_frame_t frame;
+    uint64_t last_ts = 0;
+    unsigned int frames = 0;
+    bool ordered = true;
+
+    ASSERT_EQ(em_capture_t::start(TEST_CAPTURE_FILE), 0);
+    for (unsigned int i = 0; i < 8; i++) {
+        threads.emplace_back([i]() {
+            unsigned char buff[100];
+            memset(buff, static_cast<int>(i), sizeof(buff));
+            for (unsigned int j = 0; j < 200; j++) {
+                em_capture_t::write(em_capture_dir_rx, "node=test", buff, 20 + j % 80);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(em_capture_t::stop(), 1600u);
+
+    ASSERT_EQ(reader.open(TEST_CAPTURE_FILE), 0);
+    while (reader.next(&frame) == 1) {
+        ordered = ordered && (frame.ts_us >= last_ts);
+        last_ts = frame.ts_us;
+        frames++;
+    }
+    EXPECT_EQ(frames, 1600u);
+    EXPECT_TRUE(ordered);
+    reader.close();
+    unlink(TEST_CAPTURE_FILE);
+    std::cout << "Exiting Threads test" << std::endl;
+}
+
+/**
+* @brief Test that files which are not pcapng or are cut short are rejected
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Open a missing file and a text file | - | -1 | Should Pass |
+* | 02| Read a capture cut in its last frame | Capture of one frame, 10 bytes cut off | -1 | Should Pass |
+*/
+TEST(em_capture_t_Test, Invalid) {
+    std::cout << "Entering Invalid test" << std::endl;
+    unsigned char buff[64] = {0};
+    em_capture_reader_t reader;
+    em_capture_frame_t frame;
+    FILE *fp;
+    long size;
+
+    EXPECT_EQ(reader.open("/tmp/test_l1_em_capture_missing.pcapng"), -1);
+    fp = fopen(TEST_CAPTURE_FILE, "w");
+    ASSERT_NE(fp, nullptr);
+    fprintf(fp, "not a capture\n");
+    fclose(fp);
+    EXPECT_EQ(reader.open(TEST_CAPTURE_FILE), -1);
+
+    ASSERT_EQ(em_capture_t::start(TEST_CAPTURE_FILE), 0);
+    em_capture_t::write(em_capture_dir_rx, NULL, buff, sizeof(buff));
+    em_capture_t::stop();
+    fp = fopen(TEST_CAPTURE_FILE, "r+");
+    ASSERT_NE(fp, nullptr);
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fclose(fp);
+    ASSERT_EQ(truncate(TEST_CAPTURE_FILE, size - 10), 0);
+    ASSERT_EQ(reader.open(TEST_CAPTURE_FILE), 0);
+    EXPECT_EQ(reader.next(&frame), -1);
+    reader.close();
+    unlink(TEST_CAPTURE_FILE);
+    std::cout << "Exiting Invalid test" << std::endl;
+}
@@ -0,0 +1,273 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include "em_chan_planner.h"
+#include "test_l1_utils.h"
+
+class em_chan_planner_tTEST : public ::testing::Test {
+protected:
+    em_chan_planner_t planner;
+
+    // a 2.4 GHz radio on channels 1 to 11, 1, 6 and 11 preferred, with one BSS
+    void add_radio(unsigned int n, unsigned char current)
+    {
+        unsigned char channels[11], prefs[11], ruid[6], bssid[6];
+        unsigned int i;
+
+        for (i = 0; i < 11; i++) {
+            channels[i] = static_cast<unsigned char>(i + 1);
+            prefs[i] = ((i + 1) % 5 == 1) ? EM_CHAN_PLANNER_MAX_PREF:10;
+        }
+        make_mac(n, 0, ruid);
+        make_mac(n, 1, bssid);
+        ASSERT_EQ(planner.set_radio(ruid, 81, channels, prefs, 11, current), 0);
+        ASSERT_EQ(planner.add_bss(bssid, ruid), 0);
+    }
+
+    // a scan of a radio on a channel, hearing the BSSs of other radios (kind 1) or foreign BSSs (kind 2)
+    int scan(unsigned int n, unsigned char channel, const unsigned int *heard, unsigned char kind, unsigned int num, signed char signal)
+    {
+        em_scan_result_t res;
+        unsigned int i;
+
+        memset(&res, 0, sizeof(res));
+        make_mac(n, 0, res.id.scanner_mac);
+        res.id.op_class = 81;
+        res.id.channel = channel;
+        for (i = 0; i < num; i++) {
+            make_mac(heard[i], kind, res.neighbor[i].bssid);
+            res.neighbor[i].signal_strength = signal;
+        }
+        res.num_neighbors = static_cast<unsigned short>(num);
+
+        return planner.add_scan_result(&res);
+    }
+
+    unsigned char channel(unsigned int n)
+    {
+        unsigned char ruid[6];
+
+        make_mac(n, 0, ruid);
+
+        return planner.get_channel(ruid);
+    }
+};
+
+/**
+* @brief Test the band, overlap and signal weight helpers
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Band of 2.4, 5 and 6 GHz operating classes | 81, 115, 131 | 2g, 5g, 6g | Should Pass |
+* | 02| Overlap of 2.4 GHz channels | 6/6, 6/8, 1/6 | 100, 60, 0 | Should Pass |
+* | 03| Overlap of 5 GHz channels | 36/36, 36/40 | 100, 0 | Should Pass |
+* | 04| Weight of signal strengths | -30, -100, -120 dBm | 70, 0, 0 | Should Pass |
+*/
+TEST_F(em_chan_planner_tTEST, Helpers) {
+    std::cout << "Entering Helpers test" << std::endl;
+    EXPECT_EQ(em_chan_planner_t::get_band(81), em_chan_planner_band_2g);
+    EXPECT_EQ(em_chan_planner_t::get_band(115), em_chan_planner_band_5g);
+    EXPECT_EQ(em_chan_planner_t::get_band(131), em_chan_planner_band_6g);
+    EXPECT_EQ(em_chan_planner_t::get_overlap(em_chan_planner_band_2g, 6, 6), 100u);
+    EXPECT_EQ(em_chan_planner_t::get_overlap(em_chan_planner_band_2g, 6, 8), 60u);
+    EXPECT_EQ(em_chan_planner_t::get_overlap(em_chan_planner_band_2g, 1, 6), 0u);
+    EXPECT_EQ(em_chan_planner_t::get_overlap(em_chan_planner_band_5g, 36, 36), 100u);
+    EXPECT_EQ(em_chan_planner_t::get_overlap(em_chan_planner_band_5g, 36, 40), 0u);
+    EXPECT_EQ(em_chan_planner_t::get_signal_weight(-30), 70u);
+    EXPECT_EQ(em_chan_planner_t::get_signal_weight(-100), 0u);
+    EXPECT_EQ(em_chan_planner_t::get_signal_weight(-120), 0u);
+    std::cout << "Exiting Helpers test" << std::endl;
+}
+
+/**
+* @brief Test that radios hearing each other are spread over the non overlapping channels
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Three radios on channel 6 that hear each other | -40 dBm | Planned on 1, 6 and 11, the cost is the preference and switch penalties | Should Pass |
+* | 02| Scan of an unknown radio | None | -1 | Should Pass |
+* | 03| Plan again with no new scan | None | No change | Should Pass |
+*/
+TEST_F(em_chan_planner_tTEST, SpreadRadios) {
+    std::cout << "Entering SpreadRadios test" << std::endl;
+    unsigned int peers[3][2] = {{1, 2}, {0, 2}, {0, 1}};
+    unsigned int i;
+
+    for (i = 0; i < 3; i++) {
+        add_radio(i, 6);
+    }
+    for (i = 0; i < 3; i++) {
+        EXPECT_EQ(scan(i, 6, peers[i], 1, 2, -40), 2);
+    }
+
+    EXPECT_EQ(planner.plan(true), 3u);
+    EXPECT_NE(channel(0), channel(1));
+    EXPECT_NE(channel(0), channel(2));
+    EXPECT_NE(channel(1), channel(2));
+    for (i = 0; i < 3; i++) {
+        EXPECT_EQ(channel(i) % 5, 1);
+    }
+    EXPECT_EQ(planner.get_cost(), 2ull * planner.get_params().switch_cost);
+
+    EXPECT_EQ(scan(7, 6, peers[0], 1, 2, -40), -1);
+    EXPECT_EQ(planner.plan(false), 0u);
+    std::cout << "Exiting SpreadRadios test" << std::endl;
+}
+
+/**
+* @brief Test that new scan data is planned incrementally from the radios it touches
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| 20 radios, in pairs that hear each other | -40 dBm | Each pair on two different channels | Should Pass |
+* | 02| Strong foreign BSSs on the channel of one radio | -30 dBm | It moves, only its pair is evaluated again and the other pairs keep their channels | Should Pass |
+* | 03| A full plan of the same data | None | Same cost as the incremental plan | Should Pass |
+*/
+TEST_F(em_chan_planner_tTEST, IncrementalPlan) {
+    std::cout << "Entering IncrementalPlan test" << std::endl;
+    unsigned int foreign[3] = {0, 1, 2}, peer, i;
+    unsigned char before, planned[20];
+    unsigned long long cost;
+
+    for (i = 0; i < 20; i++) {
+        add_radio(i, 6);
+    }
+    for (i = 0; i < 20; i++) {
+        peer = i ^ 1;
+        EXPECT_EQ(scan(i, 6, &peer, 1, 1, -40), 1);
+    }
+    planner.plan(true);
+    for (i = 0; i < 20; i++) {
+        planned[i] = channel(i);
+        EXPECT_EQ(em_chan_planner_t::get_overlap(em_chan_planner_band_2g, channel(i), channel(i ^ 1)), 0u);
+    }
+
+    before = channel(4);
+    EXPECT_EQ(scan(4, before, foreign, 2, 3, -30), 0);
+    EXPECT_GE(planner.plan(false), 1u);
+    EXPECT_NE(channel(4), before);
+    EXPECT_EQ(em_chan_planner_t::get_overlap(em_chan_planner_band_2g, channel(4), channel(5)), 0u);
+    EXPECT_LE(planner.get_stats().last_evaluated, 3u);
+    for (i = 0; i < 20; i++) {
+        if ((i != 4) && (i != 5)) {
+            EXPECT_EQ(channel(i), planned[i]);
+        }
+    }
+
+    cost = planner.get_cost();
+    planner.plan(true);
+    EXPECT_EQ(planner.get_cost(), cost);
+    EXPECT_EQ(planner.count(), 20u);
+    std::cout << "Exiting IncrementalPlan test" << std::endl;
+}
+
+/**
+* @brief Test a plan bounded by a time budget and the changes it proposes
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| 2000 radios on channel 6, in pairs that hear each other, planned with a 1 us budget | -40 dBm | The plan is truncated, the next plans go on until one completes | Should Pass |
+* | 02| Changes of the completed plan | None | One radio of each pair moves, with a gain | Should Pass |
+* | 03| A radio reports its planned channel | set_current() | It is no longer a change | Should Pass |
+* | 04| Operating channel of an unknown radio | set_current() | -1 | Should Pass |
+*/
+TEST_F(em_chan_planner_tTEST, BudgetedPlan) {
+    std::cout << "Entering BudgetedPlan test" << std::endl;
+    static em_chan_planner_change_t changes[2000];
+    unsigned long long truncated;
+    unsigned char ruid[6];
+    unsigned int i, peer, num, plans;
+
+    for (i = 0; i < 2000; i++) {
+        add_radio(i, 6);
+    }
+    for (i = 0; i < 2000; i++) {
+        peer = i ^ 1;
+        EXPECT_EQ(scan(i, 6, &peer, 1, 1, -40), 1);
+    }
+
+    planner.plan(true, 1);
+    EXPECT_EQ(planner.get_stats().truncated, 1u);
+    EXPECT_EQ(channel(1999), 0);
+    for (plans = 0; plans < 2000; plans++) {
+        truncated = planner.get_stats().truncated;
+        planner.plan(false, 1);
+        if (planner.get_stats().truncated == truncated) {
+            break;
+        }
+    }
+    EXPECT_LT(plans, 2000u);
+    for (i = 0; i < 2000; i++) {
+        EXPECT_EQ(em_chan_planner_t::get_overlap(em_chan_planner_band_2g, channel(i), channel(i ^ 1)), 0u);
+    }
+
+    num = planner.get_changes(changes, 2000);
+    EXPECT_EQ(num, 1000u);
+    for (i = 0; i < num; i++) {
+        EXPECT_EQ(changes[i].current, 6);
+        EXPECT_NE(changes[i].channel, 6);
+        EXPECT_GT(changes[i].gain, 0u);
+    }
+
+    EXPECT_EQ(planner.set_current(changes[0].ruid, changes[0].channel), 0);
+    EXPECT_EQ(planner.get_changes(changes, 2000), num - 1);
+
+    make_mac(5000, 0, ruid);
+    EXPECT_EQ(planner.set_current(ruid, 6), -1);
+    std::cout << "Exiting BudgetedPlan test" << std::endl;
+}
@@ -0,0 +1,165 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "em_client_cap_cache.h"
+#include "test_l1_utils.h"
+
+static void add_elem(std::vector<unsigned char>& body, unsigned char id, std::vector<unsigned char> val)
+{
+    body.push_back(id);
+    body.push_back(static_cast<unsigned char>(val.size()));
+    body.insert(body.end(), val.begin(), val.end());
+}
+
+// Association Request of a 2x2 HE STA on 2.4 and 5 GHz, with BTM and RRM
+static std::vector<unsigned char> make_assoc_req(bool reassoc)
+{
+    std::vector<unsigned char> body = {0x31, 0x04, 0x0a, 0x00};
+    std::vector<unsigned char> ht(26, 0), vht(12, 0);
+
+    if (reassoc == true) {
+        body.insert(body.end(), {0x02, 0, 0, 0, 0, 0x01});
+    }
+    add_elem(body, 0, {'m', 'e', 's', 'h'});
+    add_elem(body, 1, {0x82, 0x84, 0x8b, 0x96});
+    ht[3] = 0xff;
+    ht[4] = 0xff;
+    add_elem(body, 45, ht);
+    add_elem(body, 59, {115, 81, 115, 128, 130, 80});
+    add_elem(body, 70, {0x73, 0, 0, 0, 0});
+    add_elem(body, 127, {0, 0, 0x08});
+    vht[4] = 0xfa;
+    vht[5] = 0xff;
+    add_elem(body, 191, vht);
+    add_elem(body, 255, {35, 0, 0, 0});
+    return body;
+}
+
+/**
+* @brief Test that the elements of a (Re)Association Request are parsed
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Parse an Association Request | HT, VHT, HE, BTM, RRM, op classes 81 and 115 | 2.4 and 5 GHz, 2 streams, all flags but EHT | Should Pass |
+* | 02| Parse the same elements in a Reassociation Request | Current AP after the fixed fields | Same capabilities | Should Pass |
+* | 03| Parse a truncated body | Last element cut | false is returned | Should Pass |
+*/
+TEST(em_client_cap_cache_t_Test, Parse) {
+    std::cout << "Entering Parse test" << std::endl;
+    em_client_cap_t cap, recap;
+    std::vector<unsigned char> body = make_assoc_req(false);
+    std::vector<unsigned char> rebody = make_assoc_req(true);
+
+    memset(&cap, 0, sizeof(cap));
+    memset(&recap, 0, sizeof(recap));
+    EXPECT_TRUE(em_client_cap_cache_t::parse(body.data(), static_cast<unsigned int>(body.size()), &cap));
+    EXPECT_EQ(cap.bands, static_cast<unsigned int>(EM_CLIENT_CAP_BAND_24 | EM_CLIENT_CAP_BAND_5));
+    EXPECT_EQ(cap.flags, static_cast<unsigned int>(EM_CLIENT_CAP_HT | EM_CLIENT_CAP_VHT | EM_CLIENT_CAP_HE |
+                EM_CLIENT_CAP_BTM | EM_CLIENT_CAP_RRM));
+    EXPECT_EQ(cap.max_nss, 2);
+
+    EXPECT_TRUE(em_client_cap_cache_t::parse(rebody.data(), static_cast<unsigned int>(rebody.size()), &recap));
+    EXPECT_EQ(recap.bands, cap.bands);
+    EXPECT_EQ(recap.flags, cap.flags);
+    EXPECT_EQ(recap.max_nss, cap.max_nss);
+
+    EXPECT_FALSE(em_client_cap_cache_t::parse(body.data(), static_cast<unsigned int>(body.size()) - 1, &cap));
+    EXPECT_EQ(em_client_cap_cache_t::op_class_band(81), static_cast<unsigned int>(EM_CLIENT_CAP_BAND_24));
+    EXPECT_EQ(em_client_cap_cache_t::op_class_band(131), static_cast<unsigned int>(EM_CLIENT_CAP_BAND_6));
+    EXPECT_EQ(em_client_cap_cache_t::op_class_band(1), 0u);
+    std::cout << "Exiting Parse test" << std::endl;
+}
+
+/**
+* @brief Test that a reported STA is not queried again unless its capabilities may have changed
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Claim a query of an unknown STA twice | now = 1000 | First claim wins, second is refused until the timeout | Should Pass |
+* | 02| Update the STA, then update it again with the same body | 5 GHz | Changed only the first time, no query needed on 2.4 or 5 GHz | Should Pass |
+* | 03| Ask on 6 GHz and after the maximum age | None | Query needed | Should Pass |
+* | 04| Copy the body back and check the bands for steering | None | Same body, 6 GHz targets refused, unknown STA allowed | Should Pass |
+* | 05| Age out | now past the maximum age | Entry removed | Should Pass |
+*/
+TEST(em_client_cap_cache_t_Test, QueryOnChange) {
+    std::cout << "Entering QueryOnChange test" << std::endl;
+    em_client_cap_cache_t cache;
+    em_client_cap_t cap;
+    std::vector<unsigned char> body = make_assoc_req(false);
+    unsigned int len = static_cast<unsigned int>(body.size());
+    unsigned char sta[6], other[6], copy[EM_MAX_FRAME_BODY_LEN];
+    unsigned long long now = 1000;
+
+    make_mac(1, sta);
+    make_mac(2, other);
+    EXPECT_TRUE(cache.needs_query(sta, em_freq_band_5, now));
+    EXPECT_TRUE(cache.claim_query(sta, now));
+    EXPECT_FALSE(cache.claim_query(sta, now + 1));
+    EXPECT_FALSE(cache.get(sta, &cap));
+    EXPECT_TRUE(cache.claim_query(sta, now + EM_CLIENT_CAP_QUERY_TIMEOUT_MS));
+
+    EXPECT_TRUE(cache.update(sta, body.data(), len, em_freq_band_5, now));
+    EXPECT_FALSE(cache.update(sta, body.data(), len, em_freq_band_5, now + 10));
+    EXPECT_FALSE(cache.needs_query(sta, em_freq_band_5, now + 20));
+    EXPECT_FALSE(cache.needs_query(sta, em_freq_band_24, now + 20));
+    EXPECT_TRUE(cache.claim_query(sta, now + 20));
+    EXPECT_TRUE(cache.needs_query(sta, em_freq_band_60, now + 20));
+    EXPECT_TRUE(cache.needs_query(sta, em_freq_band_5, now + 10 + EM_CLIENT_CAP_MAX_AGE_MS));
+
+    ASSERT_TRUE(cache.get(sta, &cap));
+    EXPECT_EQ(cap.time_ms, now + 10);
+    EXPECT_EQ(cache.get_body(sta, copy, sizeof(copy)), len);
+    EXPECT_EQ(memcmp(copy, body.data(), len), 0);
+    EXPECT_EQ(cache.get_body(sta, copy, len - 1), 0u);
+    EXPECT_TRUE(cache.supports_op_class(sta, 128));
+    EXPECT_FALSE(cache.supports_op_class(sta, 134));
+    EXPECT_TRUE(cache.supports_op_class(other, 134));
+
+    // a STA now also on 6 GHz
+    EXPECT_TRUE(cache.update(sta, body.data(), len, em_freq_band_60, now + 30));
+    EXPECT_TRUE(cache.supports_op_class(sta, 134));
+
+    EXPECT_EQ(cache.count(), 1u);
+    EXPECT_EQ(cache.age_out(now + 30 + EM_CLIENT_CAP_MAX_AGE_MS - 1), 0u);
+    EXPECT_EQ(cache.age_out(now + 30 + EM_CLIENT_CAP_MAX_AGE_MS), 1u);
+    EXPECT_EQ(cache.count(), 0u);
+    std::cout << "Exiting QueryOnChange test" << std::endl;
+}
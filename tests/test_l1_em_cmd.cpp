@@ -929,18 +929,18 @@ TEST(em_cmd_t, reset_cmd_ctx_default_constructed_object)
 {
     std::cout << "Entering reset_cmd_ctx_default_constructed_object test" << std::endl;
     em_cmd_t cmd_obj;
-    cmd_obj.m_data_model.m_cmd_ctx.arr_index = 1;
-    cmd_obj.m_data_model.m_cmd_ctx.type = dm_orch_type_topo_sync;
-    memcpy(cmd_obj.m_data_model.m_cmd_ctx.obj_id, "SampleID", strlen("SampleID") + 1);
+    cmd_obj.m_ctx.arr_index = 1;
+    cmd_obj.m_ctx.type = dm_orch_type_topo_sync;
+    memcpy(cmd_obj.m_ctx.obj_id, "SampleID", strlen("SampleID") + 1);
     std::cout << "Invoking reset_cmd_ctx" << std::endl;
     EXPECT_NO_THROW({
         cmd_obj.reset_cmd_ctx();
-        std::cout << "reset_cmd_ctx() invoked successfully. m_data_model.reset_cmd_ctx() should have been executed without exceptions." << std::endl;
+        std::cout << "reset_cmd_ctx() invoked successfully. the command context should have been reset without exceptions." << std::endl;
     });
-    EXPECT_EQ(cmd_obj.m_data_model.m_cmd_ctx.arr_index, 0u);
-    EXPECT_EQ(cmd_obj.m_data_model.m_cmd_ctx.type, 0);
-    for (size_t i = 0; i < sizeof(cmd_obj.m_data_model.m_cmd_ctx.obj_id); i++) {
-        EXPECT_EQ(cmd_obj.m_data_model.m_cmd_ctx.obj_id[i], 0);
+    EXPECT_EQ(cmd_obj.m_ctx.arr_index, 0u);
+    EXPECT_EQ(cmd_obj.m_ctx.type, 0);
+    for (size_t i = 0; i < sizeof(cmd_obj.m_ctx.obj_id); i++) {
+        EXPECT_EQ(cmd_obj.m_ctx.obj_id[i], 0);
     }
     std::cout << "Exiting reset_cmd_ctx_default_constructed_object test" << std::endl;
 }
@@ -1424,18 +1424,18 @@ TEST(em_cmd_t, ValidConstructionNonEmptyCommandParameters)
     std::cout << "Parameter num_args: " << cmd.m_param.u.args.num_args << std::endl;
     std::cout << "Arg[0]: " << cmd.m_param.u.args.args[0] << std::endl;
     std::cout << "Fixed args: " << cmd.m_param.u.args.fixed_args << std::endl;
-    std::cout << "m_num_radios: " << cmd.m_data_model.m_num_radios << std::endl;
-    std::cout << "m_num_bss: " << cmd.m_data_model.m_num_bss << std::endl;
-    std::cout << "m_num_opclass: " << cmd.m_data_model.m_num_opclass << std::endl;
-    std::cout << "m_colocated: " << cmd.m_data_model.m_colocated << std::endl;
+    std::cout << "m_num_radios: " << cmd.m_data_model->m_num_radios << std::endl;
+    std::cout << "m_num_bss: " << cmd.m_data_model->m_num_bss << std::endl;
+    std::cout << "m_num_opclass: " << cmd.m_data_model->m_num_opclass << std::endl;
+    std::cout << "m_colocated: " << cmd.m_data_model->m_colocated << std::endl;
     EXPECT_EQ(cmd.m_type, em_cmd_type_get_device);
     EXPECT_EQ(cmd.m_param.u.args.num_args, 1);
     EXPECT_STREQ(cmd.m_param.u.args.args[0], "testArg");
     EXPECT_STREQ(cmd.m_param.u.args.fixed_args, "fixedTest");
-    EXPECT_EQ(cmd.m_data_model.m_num_radios, 2);
-    EXPECT_EQ(cmd.m_data_model.m_num_bss, 3);
-    EXPECT_EQ(cmd.m_data_model.m_num_opclass, 4);
-    EXPECT_TRUE(cmd.m_data_model.m_colocated);
+    EXPECT_EQ(cmd.m_data_model->m_num_radios, 2);
+    EXPECT_EQ(cmd.m_data_model->m_num_bss, 3);
+    EXPECT_EQ(cmd.m_data_model->m_num_opclass, 4);
+    EXPECT_TRUE(cmd.m_data_model->m_colocated);
     std::cout << "Exiting ValidConstructionNonEmptyCommandParameters test" << std::endl;
 }
 /**
@@ -1502,10 +1502,10 @@ TEST(em_cmd_t, SuccessfulRetrieval)
 {
     std::cout << "Entering SuccessfulRetrieval test" << std::endl;
     em_cmd_t cmd;
-    strncpy(cmd.m_data_model.m_device.m_device_info.intf.name, "AgentAL_Interface", sizeof(cmd.m_data_model.m_device.m_device_info.intf.name));
+    strncpy(cmd.m_data_model->m_device.m_device_info.intf.name, "AgentAL_Interface", sizeof(cmd.m_data_model->m_device.m_device_info.intf.name));
     unsigned char mac[6] = {0x1A, 0x1B, 0x2C, 0x3D, 0x4E, 0x5A};
-    memcpy(cmd.m_data_model.m_device.m_device_info.intf.mac, mac, sizeof(mac));
-    cmd.m_data_model.m_device.m_device_info.intf.media = em_media_type_ieee8023ab;
+    memcpy(cmd.m_data_model->m_device.m_device_info.intf.mac, mac, sizeof(mac));
+    cmd.m_data_model->m_device.m_device_info.intf.media = em_media_type_ieee8023ab;
     std::cout << "Invoking get_agent_al_interface()" << std::endl;
     em_interface_t *agentInterface = cmd.get_agent_al_interface();
     if (agentInterface) {
@@ -1549,7 +1549,7 @@ TEST(em_cmd_t, RetrieveALInterfaceMACAddress_WithValidConfiguration) {
     std::cout << "Entering RetrieveALInterfaceMACAddress_WithValidConfiguration test" << std::endl;
     em_cmd_t cmd;
     unsigned char mac[6] = {0x1A, 0x1B, 0x2C, 0x3D, 0x4E, 0x5A};
-    memcpy(cmd.m_data_model.m_device.m_device_info.intf.mac, mac, sizeof(mac));
+    memcpy(cmd.m_data_model->m_device.m_device_info.intf.mac, mac, sizeof(mac));
     std::cout << "Invoking get_al_interface_mac() method" << std::endl;
     unsigned char *mac_ptr = cmd.get_al_interface_mac();
     ASSERT_NE(mac_ptr, nullptr);
@@ -2002,10 +2002,10 @@ TEST(em_cmd_t, ExceedingCommandType) {
 TEST(em_cmd_t, ControlALInterfaceValid) {
     std::cout << "Entering ControlALInterfaceValid test" << std::endl;
     em_cmd_t cmd;
-    strncpy(cmd.m_data_model.m_network.m_net_info.colocated_agent_id.name, "brlan0", sizeof(cmd.m_data_model.m_network.m_net_info.colocated_agent_id.name) - 1);
+    strncpy(cmd.m_data_model->m_network.m_net_info.colocated_agent_id.name, "brlan0", sizeof(cmd.m_data_model->m_network.m_net_info.colocated_agent_id.name) - 1);
     unsigned char expected_mac[] = {0x1A, 0x2B, 0x3C, 0x4D, 0x5E, 0x4B};
-    memcpy(cmd.m_data_model.m_network.m_net_info.colocated_agent_id.mac, expected_mac, sizeof(expected_mac));
-    cmd.m_data_model.m_network.m_net_info.colocated_agent_id.media = em_media_type_ieee8023ab;
+    memcpy(cmd.m_data_model->m_network.m_net_info.colocated_agent_id.mac, expected_mac, sizeof(expected_mac));
+    cmd.m_data_model->m_network.m_net_info.colocated_agent_id.media = em_media_type_ieee8023ab;
     std::cout << "Invoking get_ctrl_al_interface()" << std::endl;
     em_interface_t *ctrlInterface = cmd.get_ctrl_al_interface();
     ASSERT_NE(ctrlInterface, nullptr);
@@ -2046,7 +2046,7 @@ TEST(em_cmd_t, ValidLowerBoundaryIndex) {
     std::cout << "Entering ValidLowerBoundaryIndex test" << std::endl;
     em_cmd_t cmd;
     unsigned int index = 0;
-    em_op_class_info_t &infoInit = cmd.m_data_model.m_op_class[index].m_op_class_info;
+    em_op_class_info_t &infoInit = cmd.m_data_model->m_op_class[index].m_op_class_info;
     for (int i = 0; i < 6; i++)
         infoInit.id.ruid[i] = static_cast<unsigned char>(0x10 + i);
     infoInit.id.type = static_cast<em_op_class_type_t>(1);
@@ -2126,7 +2126,7 @@ TEST(em_cmd_t, ValidMidRangeIndex) {
     em_cmd_t cmd;
     unsigned int index = 3;
     em_op_class_info_t &infoInit =
-        cmd.m_data_model.m_op_class[index].m_op_class_info;
+        cmd.m_data_model->m_op_class[index].m_op_class_info;
     for (int i = 0; i < 6; i++)
         infoInit.id.ruid[i] = static_cast<unsigned char>(0x20 + i);
     infoInit.id.type = static_cast<em_op_class_type_t>(2);
@@ -2201,8 +2201,8 @@ TEST(em_cmd_t, MaxIndexValue) {
     std::cout << "Entering MaxIndexValue test" << std::endl;
     em_cmd_t cmd;
     unsigned int index = EM_MAX_OPCLASS - 1;
-    cmd.m_data_model.m_num_opclass = index + 1;
-    em_op_class_info_t &infoInit = cmd.m_data_model.m_op_class[index].m_op_class_info;
+    cmd.m_data_model->m_num_opclass = index + 1;
+    em_op_class_info_t &infoInit = cmd.m_data_model->m_op_class[index].m_op_class_info;
     for (int i = 0; i < 6; i++)
         infoInit.id.ruid[i] = static_cast<unsigned char>(0x30 + i);
     infoInit.id.type = static_cast<em_op_class_type_t>(3);
@@ -2307,14 +2307,14 @@ TEST(em_cmd_t, GetDataModelReturnsNonNull)
 {
     std::cout << "Entering GetDataModelReturnsNonNull test" << std::endl;
     em_cmd_t cmd{};
-    cmd.m_data_model.m_num_preferences = 2;
-    cmd.m_data_model.m_num_interfaces = 3;
-    cmd.m_data_model.m_num_net_ssids = 8;
-    cmd.m_data_model.m_num_radios = 2;
-    cmd.m_data_model.m_num_bss = 2;
-    cmd.m_data_model.m_num_opclass = 3; 
-    cmd.m_data_model.m_colocated = false;
-    cmd.m_data_model.m_device.m_device_info.dfs_enable = true;
+    cmd.m_data_model->m_num_preferences = 2;
+    cmd.m_data_model->m_num_interfaces = 3;
+    cmd.m_data_model->m_num_net_ssids = 8;
+    cmd.m_data_model->m_num_radios = 2;
+    cmd.m_data_model->m_num_bss = 2;
+    cmd.m_data_model->m_num_opclass = 3; 
+    cmd.m_data_model->m_colocated = false;
+    cmd.m_data_model->m_device.m_device_info.dfs_enable = true;
     std::cout << "Invoking get_data_model() method on initialized em_cmd_t object." << std::endl;
     dm_easy_mesh_t* data_model_ptr = cmd.get_data_model();
     ASSERT_NE(data_model_ptr, nullptr);
@@ -2382,10 +2382,10 @@ TEST(em_cmd_t, Validate_retrieval_of_the_DB_configuration_type) {
 TEST(em_cmd_t, GetDpp_Invocation) {
     std::cout << "Entering GetDpp_Invocation test" << std::endl;
     em_cmd_t cmd{};
-    cmd.m_data_model.m_dpp.m_dpp_info.version = 5;
-    cmd.m_data_model.m_dpp.m_dpp_info.type = ec_session_type_cfg;
+    cmd.m_data_model->m_dpp.m_dpp_info.version = 5;
+    cmd.m_data_model->m_dpp.m_dpp_info.type = ec_session_type_cfg;
     unsigned char mac[] = {0x1A, 0x2B, 0x3C, 0x4D, 0x5E, 0x4B};
-    memcpy(cmd.m_data_model.m_dpp.m_dpp_info.mac_addr, mac, sizeof(mac));
+    memcpy(cmd.m_data_model->m_dpp.m_dpp_info.mac_addr, mac, sizeof(mac));
     std::cout << "Created em_cmd_t object using default constructor." << std::endl;
     dm_dpp_t* dpp_ptr = cmd.get_dpp();
     std::cout << "Invoked get_dpp(); returned pointer: " << dpp_ptr << std::endl;
@@ -2741,9 +2741,9 @@ TEST(em_cmd_t, ValidateEventLengthTypical) {
 TEST(em_cmd_t, get_ieee_1905_security_cap_Successful) {
     std::cout << "Entering get_ieee_1905_security_cap_Successful test" << std::endl;   
     em_cmd_t cmd_obj;
-    cmd_obj.m_data_model.m_ieee_1905_security.m_ieee_1905_security_info.sec_cap.onboarding_proto = 1;
-    cmd_obj.m_data_model.m_ieee_1905_security.m_ieee_1905_security_info.sec_cap.integrity_algo   = 2;
-    cmd_obj.m_data_model.m_ieee_1905_security.m_ieee_1905_security_info.sec_cap.encryption_algo  = 3;
+    cmd_obj.m_data_model->m_ieee_1905_security.m_ieee_1905_security_info.sec_cap.onboarding_proto = 1;
+    cmd_obj.m_data_model->m_ieee_1905_security.m_ieee_1905_security_info.sec_cap.integrity_algo   = 2;
+    cmd_obj.m_data_model->m_ieee_1905_security.m_ieee_1905_security_info.sec_cap.encryption_algo  = 3;
     std::cout << "Invoking get_ieee_1905_security_cap method" << std::endl;
     em_ieee_1905_security_cap_t *cap_ptr = nullptr;
     EXPECT_NO_THROW(cap_ptr = cmd_obj.get_ieee_1905_security_cap());
@@ -3246,10 +3246,10 @@ TEST(em_cmd_t, get_radio_interface_valid_index0) {
     std::cout << "Entering get_radio_interface_valid_index0 test" << std::endl;
     em_cmd_t cmd;
 	unsigned char mac[6] = {0x1A, 0x1B, 0x2C, 0x3D, 0x4E, 0x5A};
-	memcpy(cmd.m_data_model.m_radio[0].m_radio_info.intf.mac, mac, sizeof(mac));
-	cmd.m_data_model.m_radio[0].m_radio_info.intf.media = em_media_type_ieee80211a_5;
+	memcpy(cmd.m_data_model->m_radio[0].m_radio_info.intf.mac, mac, sizeof(mac));
+	cmd.m_data_model->m_radio[0].m_radio_info.intf.media = em_media_type_ieee80211a_5;
     const char *ifaceName0 = "TestInterface0";
-    strncpy(cmd.m_data_model.m_radio[0].m_radio_info.intf.name, ifaceName0, sizeof(cmd.m_data_model.m_radio[0].m_radio_info.intf.name) - 1);
+    strncpy(cmd.m_data_model->m_radio[0].m_radio_info.intf.name, ifaceName0, sizeof(cmd.m_data_model->m_radio[0].m_radio_info.intf.name) - 1);
     unsigned int index = 0;
     std::cout << "Invoking get_radio_interface with index: " << index << std::endl;
     em_interface_t* retrievedIface = cmd.get_radio_interface(index);
@@ -3299,14 +3299,14 @@ TEST(em_cmd_t, get_radio_interface_valid_lastindex) {
     em_cmd_t cmd;
     // Configure MAC for radio[0]
     unsigned char mac[6] = {0x1A, 0x1B, 0x2C, 0x3D, 0x4E, 0x5A};
-    memcpy(cmd.m_data_model.m_radio[2].m_radio_info.intf.mac, mac, sizeof(mac));
+    memcpy(cmd.m_data_model->m_radio[2].m_radio_info.intf.mac, mac, sizeof(mac));
     // Configure media type for radio[2]
-    cmd.m_data_model.m_radio[2].m_radio_info.intf.media = em_media_type_ieee80211n_24;
+    cmd.m_data_model->m_radio[2].m_radio_info.intf.media = em_media_type_ieee80211n_24;
     // Set interface name on radio[0] (though index=2 returns radio[2])
     const char *ifaceName0 = "TestInterface0";
-    strncpy(cmd.m_data_model.m_radio[2].m_radio_info.intf.name,
+    strncpy(cmd.m_data_model->m_radio[2].m_radio_info.intf.name,
             ifaceName0,
-            sizeof(cmd.m_data_model.m_radio[2].m_radio_info.intf.name) - 1);
+            sizeof(cmd.m_data_model->m_radio[2].m_radio_info.intf.name) - 1);
     unsigned int index = 2;
     std::cout << "Invoking get_radio_interface with index: " << index << std::endl;
     em_interface_t* retrievedIface = cmd.get_radio_interface(index);
@@ -3352,10 +3352,10 @@ TEST(em_cmd_t, get_radio_interface_index_out_of_range) {
     std::cout << "Entering get_radio_interface_index_out_of_range test" << std::endl;
     em_cmd_t cmd;
     unsigned char mac[6] = {0x1A, 0x1B, 0x2C, 0x3D, 0x4E, 0x5A};
-    memcpy(cmd.m_data_model.m_radio[4].m_radio_info.intf.mac, mac, sizeof(mac));
-    cmd.m_data_model.m_radio[4].m_radio_info.intf.media = em_media_type_ieee80211n_24;
+    memcpy(cmd.m_data_model->m_radio[4].m_radio_info.intf.mac, mac, sizeof(mac));
+    cmd.m_data_model->m_radio[4].m_radio_info.intf.media = em_media_type_ieee80211n_24;
     const char *ifaceName0 = "TestInterface0";
-    strncpy(cmd.m_data_model.m_radio[4].m_radio_info.intf.name, ifaceName0, sizeof(cmd.m_data_model.m_radio[0].m_radio_info.intf.name) - 1);
+    strncpy(cmd.m_data_model->m_radio[4].m_radio_info.intf.name, ifaceName0, sizeof(cmd.m_data_model->m_radio[0].m_radio_info.intf.name) - 1);
     unsigned int index = 4;
     std::cout << "Invoking get_radio_interface with index: " << index << std::endl;
     em_interface_t* retrievedIface = cmd.get_radio_interface(index);
@@ -3384,7 +3384,7 @@ TEST(em_cmd_t, get_manufacturer_valid_retrieve_valid_manufacturer_name)
 {
     std::cout << "Entering get_manufacturer_valid_retrieve_valid_manufacturer_name test" << std::endl;       
     em_cmd_t cmd{};
-    strncpy(cmd.m_data_model.m_device.m_device_info.manufacturer, "Acme Corp", sizeof(cmd.m_data_model.m_device.m_device_info.manufacturer) - 1);
+    strncpy(cmd.m_data_model->m_device.m_device_info.manufacturer, "Acme Corp", sizeof(cmd.m_data_model->m_device.m_device_info.manufacturer) - 1);
     std::cout << "Invoking get_manufacturer()" << std::endl;
     char *result = nullptr;
     result = cmd.get_manufacturer();
@@ -3417,7 +3417,7 @@ TEST(em_cmd_t, get_manufacturer_empty_retrieve_manufacturer_name_empty)
 {
     std::cout << "Entering get_manufacturer_empty_retrieve_manufacturer_name_empty test" << std::endl;
     em_cmd_t cmd{};
-    strncpy(cmd.m_data_model.m_device.m_device_info.manufacturer, "", sizeof(cmd.m_data_model.m_device.m_device_info.manufacturer) - 1);
+    strncpy(cmd.m_data_model->m_device.m_device_info.manufacturer, "", sizeof(cmd.m_data_model->m_device.m_device_info.manufacturer) - 1);
     std::cout << "Invoking get_manufacturer()" << std::endl;
     char *result = cmd.get_manufacturer();
     ASSERT_NE(result, nullptr);
@@ -3449,7 +3449,7 @@ TEST(em_cmd_t, get_manufacturer_RetrieveManufacturerWithSpecialCharacters)
 {
     std::cout << "Entering get_manufacturer_RetrieveManufacturerWithSpecialCharacters test" << std::endl;
     em_cmd_t cmd{};
-    memcpy(cmd.m_data_model.m_device.m_device_info.manufacturer, "!@#$%^&*()_+", strlen("!@#$%^&*()_+") + 1);
+    memcpy(cmd.m_data_model->m_device.m_device_info.manufacturer, "!@#$%^&*()_+", strlen("!@#$%^&*()_+") + 1);
     std::cout << "Invoking get_manufacturer()" << std::endl;
     char *result = cmd.get_manufacturer();
     ASSERT_NE(result, nullptr);
@@ -3480,7 +3480,7 @@ TEST(em_cmd_t, get_manufacturer_model_ValidModelProperlySet)
 {
     std::cout << "Entering get_manufacturer_model_ValidModelProperlySet test" << std::endl;
     em_cmd_t cmd;
-    strncpy(cmd.m_data_model.m_device.m_device_info.manufacturer_model, "TestModel", sizeof(cmd.m_data_model.m_device.m_device_info.manufacturer_model) - 1);
+    strncpy(cmd.m_data_model->m_device.m_device_info.manufacturer_model, "TestModel", sizeof(cmd.m_data_model->m_device.m_device_info.manufacturer_model) - 1);
     std::cout << "Invoking get_manufacturer_model()" << std::endl;
     char *result = cmd.get_manufacturer_model();
     ASSERT_NE(result, nullptr);
@@ -3514,7 +3514,7 @@ TEST(em_cmd_t, get_manufacturer_model_EmptyModel)
 {
     std::cout << "Entering get_manufacturer_model_EmptyModel test" << std::endl;
     em_cmd_t cmd;
-    strncpy(cmd.m_data_model.m_device.m_device_info.manufacturer_model, "", sizeof(cmd.m_data_model.m_device.m_device_info.manufacturer_model) - 1);
+    strncpy(cmd.m_data_model->m_device.m_device_info.manufacturer_model, "", sizeof(cmd.m_data_model->m_device.m_device_info.manufacturer_model) - 1);
     std::cout << "Invoking get_manufacturer_model()" << std::endl;
     char *result = cmd.get_manufacturer_model();
     ASSERT_NE(result, nullptr);
@@ -3546,7 +3546,7 @@ TEST(em_cmd_t, get_manufacturer_model_RetrieveWithSpecialCharacters)
 {
     std::cout << "Entering get_manufacturer_model_RetrieveWithSpecialCharacters test" << std::endl;
     em_cmd_t cmd{};
-    memcpy(cmd.m_data_model.m_device.m_device_info.manufacturer_model, "!@#$%^&*()", strlen("!@#$%^&*()") + 1);
+    memcpy(cmd.m_data_model->m_device.m_device_info.manufacturer_model, "!@#$%^&*()", strlen("!@#$%^&*()") + 1);
     std::cout << "Invoking get_manufacturer_model()" << std::endl;
     char *result = cmd.get_manufacturer_model();
     ASSERT_NE(result, nullptr);
@@ -3579,8 +3579,8 @@ TEST(em_cmd_t, get_serial_number_valid_serial) {
     std::cout << "Entering get_serial_number_valid_serial test" << std::endl;
     const char* expectedSerial = "ABC123";
     em_cmd_t cmd;
-    strncpy(cmd.m_data_model.m_device.m_device_info.serial_number, expectedSerial, sizeof(cmd.m_data_model.m_device.m_device_info.serial_number) - 1);
-    cmd.m_data_model.m_device.m_device_info.serial_number[sizeof(cmd.m_data_model.m_device.m_device_info.serial_number) - 1] = '\0';
+    strncpy(cmd.m_data_model->m_device.m_device_info.serial_number, expectedSerial, sizeof(cmd.m_data_model->m_device.m_device_info.serial_number) - 1);
+    cmd.m_data_model->m_device.m_device_info.serial_number[sizeof(cmd.m_data_model->m_device.m_device_info.serial_number) - 1] = '\0';
     std::cout << "Invoking get_serial_number() on em_cmd_t object" << std::endl;
     char* retSerial = cmd.get_serial_number();
     ASSERT_NE(retSerial, nullptr);
@@ -3614,7 +3614,7 @@ TEST(em_cmd_t, get_serial_number_empty_serial) {
     std::cout << "Entering get_serial_number_empty_serial test" << std::endl;
     const char* expectedSerial = "";
     em_cmd_t cmd;
-    strncpy(cmd.m_data_model.m_device.m_device_info.serial_number, expectedSerial, sizeof(cmd.m_data_model.m_device.m_device_info.serial_number) - 1); 
+    strncpy(cmd.m_data_model->m_device.m_device_info.serial_number, expectedSerial, sizeof(cmd.m_data_model->m_device.m_device_info.serial_number) - 1); 
     std::cout << "Invoking get_serial_number() on em_cmd_t object" << std::endl;
     char* retSerial = cmd.get_serial_number();
     ASSERT_NE(retSerial, nullptr);
@@ -3648,7 +3648,7 @@ TEST(em_cmd_t, get_serial_number_empty_serial) {
 TEST(em_cmd_t, get_serial_number_serial_WithSpecialCharacters) {
     std::cout << "Entering get_serial_number_serial_WithSpecialCharacters test" << std::endl;
     em_cmd_t cmd;
-    memcpy(cmd.m_data_model.m_device.m_device_info.serial_number, u8"SN@#123!$%\n\t\u00A9", strlen(u8"SN@#123!$%\n\t\u00A9") + 1);  
+    memcpy(cmd.m_data_model->m_device.m_device_info.serial_number, u8"SN@#123!$%\n\t\u00A9", strlen(u8"SN@#123!$%\n\t\u00A9") + 1);  
     std::cout << "Invoking get_serial_number() on em_cmd_t object" << std::endl;
     char* retSerial = cmd.get_serial_number();
     ASSERT_NE(retSerial, nullptr);
@@ -3679,7 +3679,7 @@ TEST(em_cmd_t, get_serial_number_serial_WithSpecialCharacters) {
 TEST(em_cmd_t, get_primary_device_type_valid) {
     std::cout << "Entering get_primary_device_type_valid test" << std::endl;
     em_cmd_t cmd;
-	memcpy(cmd.m_data_model.m_device.m_device_info.primary_device_type, "DEVICE_TYPE_XYZ", strlen("DEVICE_TYPE_XYZ") + 1);
+	memcpy(cmd.m_data_model->m_device.m_device_info.primary_device_type, "DEVICE_TYPE_XYZ", strlen("DEVICE_TYPE_XYZ") + 1);
     std::cout << "Invoking get_primary_device_type() on cmd object" << std::endl;
     char *retVal = cmd.get_primary_device_type();
     std::cout << "Returned value: " << (retVal ? retVal : "NULL") << std::endl;
@@ -3710,7 +3710,7 @@ TEST(em_cmd_t, get_primary_device_type_valid) {
 TEST(em_cmd_t, get_primary_device_type_empty) {
     std::cout << "Entering get_primary_device_type_empty test" << std::endl;
     em_cmd_t cmd;
-    memcpy(cmd.m_data_model.m_device.m_device_info.primary_device_type, "", strlen("") + 1);
+    memcpy(cmd.m_data_model->m_device.m_device_info.primary_device_type, "", strlen("") + 1);
     std::cout << "Invoking get_primary_device_type() on cmd object" << std::endl;
     char *retVal = cmd.get_primary_device_type();
     std::cout << "Returned value: " << (retVal ? retVal : "NULL") << std::endl;
@@ -3739,7 +3739,7 @@ TEST(em_cmd_t, get_primary_device_type_empty) {
 TEST(em_cmd_t, get_primary_device_type_SpecialCharacters) {
     std::cout << "Entering get_primary_device_type_SpecialCharacters test" << std::endl;
     em_cmd_t cmd;
-    memcpy(cmd.m_data_model.m_device.m_device_info.primary_device_type, "!@#$%^&*()_+", strlen("!@#$%^&*()_+") + 1);
+    memcpy(cmd.m_data_model->m_device.m_device_info.primary_device_type, "!@#$%^&*()_+", strlen("!@#$%^&*()_+") + 1);
     std::cout << "Invoking get_primary_device_type() on cmd object" << std::endl;
     char *retVal = cmd.get_primary_device_type();
     std::cout << "Returned value: " << (retVal ? retVal : "NULL") << std::endl;
@@ -3770,7 +3770,7 @@ TEST(em_cmd_t, get_primary_device_type_SpecialCharacters) {
 TEST(em_cmd_t, get_num_network_ssid_verify_returns_0_when_no_network_ssids_available) {
     std::cout << "Entering get_num_network_ssid_verify_returns_0_when_no_network_ssids_available test" << std::endl;
     em_cmd_t cmd;
-    cmd.m_data_model.m_num_net_ssids = 0;
+    cmd.m_data_model->m_num_net_ssids = 0;
     std::cout << "Invoking get_num_network_ssid() method." << std::endl;
     unsigned int ssidCount = cmd.get_num_network_ssid();
     std::cout << "get_num_network_ssid() returned: " << ssidCount << std::endl;
@@ -3798,7 +3798,7 @@ TEST(em_cmd_t, get_num_network_ssid_verify_returns_0_when_no_network_ssids_avail
 TEST(em_cmd_t, get_num_network_ssid_verify_returns_valid_count_for_configured_ssids) {
     std::cout << "Entering get_num_network_ssid_verify_returns_valid_count_for_configured_ssids test" << std::endl;   
     em_cmd_t cmd;
-    cmd.m_data_model.m_num_net_ssids = 3;
+    cmd.m_data_model->m_num_net_ssids = 3;
     std::cout << "Invoking get_num_network_ssid() method." << std::endl;
     unsigned int ssidCount = cmd.get_num_network_ssid();
     std::cout << "get_num_network_ssid() returned: " << ssidCount << std::endl;   
@@ -3828,7 +3828,7 @@ TEST(em_cmd_t, get_num_network_ssid_verify_returns_maximum_ssid_count_boundary_c
     std::cout << "Entering get_num_network_ssid_verify_returns_maximum_ssid_count_boundary_condition test" << std::endl;
     em_cmd_t cmd;
 	unsigned int maxSSIDCount = UINT_MAX;
-	cmd.m_data_model.m_num_net_ssids = maxSSIDCount;
+	cmd.m_data_model->m_num_net_ssids = maxSSIDCount;
     std::cout << "Invoking get_num_network_ssid() method." << std::endl;
     unsigned int ssidCount = cmd.get_num_network_ssid();
     std::cout << "get_num_network_ssid() returned: " << ssidCount << std::endl;   
@@ -3863,10 +3863,10 @@ TEST(em_cmd_t, get_network_ssid_valid_index_0)
     std::cout << "Entering get_network_ssid_valid_index_0 test" << std::endl;
     em_cmd_t cmdObj;
     unsigned int index = 0;
-    memcpy(cmdObj.m_data_model.m_network_ssid[index].m_network_ssid_info.ssid, "TestSSID", strlen("TestSSID") + 1);
-    cmdObj.m_data_model.m_network_ssid[index].m_network_ssid_info.num_bands = 2;
-    cmdObj.m_data_model.m_network_ssid[index].m_network_ssid_info.enable = true;
-    cmdObj.m_data_model.m_network_ssid[index].m_network_ssid_info.num_hauls = 2;
+    memcpy(cmdObj.m_data_model->m_network_ssid[index].m_network_ssid_info.ssid, "TestSSID", strlen("TestSSID") + 1);
+    cmdObj.m_data_model->m_network_ssid[index].m_network_ssid_info.num_bands = 2;
+    cmdObj.m_data_model->m_network_ssid[index].m_network_ssid_info.enable = true;
+    cmdObj.m_data_model->m_network_ssid[index].m_network_ssid_info.num_hauls = 2;
     std::cout << "Invoking get_network_ssid with index = " << index << std::endl;
     dm_network_ssid_t *ssidPtr = cmdObj.get_network_ssid(index);
     ASSERT_NE(ssidPtr, nullptr);
@@ -3909,10 +3909,10 @@ TEST(em_cmd_t, get_network_ssid_valid_index_2)
     std::cout << "Entering get_network_ssid_valid_index_2 test" << std::endl;
     em_cmd_t cmdObj;
     unsigned int index = 2;
-	memcpy(cmdObj.m_data_model.m_network_ssid[index].m_network_ssid_info.ssid, "TestSSID1", strlen("TestSSID1") + 1);
-    cmdObj.m_data_model.m_network_ssid[index].m_network_ssid_info.num_bands = 2;
-    cmdObj.m_data_model.m_network_ssid[index].m_network_ssid_info.enable = true;
-    cmdObj.m_data_model.m_network_ssid[index].m_network_ssid_info.num_hauls = 2;
+	memcpy(cmdObj.m_data_model->m_network_ssid[index].m_network_ssid_info.ssid, "TestSSID1", strlen("TestSSID1") + 1);
+    cmdObj.m_data_model->m_network_ssid[index].m_network_ssid_info.num_bands = 2;
+    cmdObj.m_data_model->m_network_ssid[index].m_network_ssid_info.enable = true;
+    cmdObj.m_data_model->m_network_ssid[index].m_network_ssid_info.num_hauls = 2;
     std::cout << "Invoking get_network_ssid with index = " << index << std::endl;
     dm_network_ssid_t *ssidPtr = cmdObj.get_network_ssid(index);
     std::cout << "Method get_network_ssid returned pointer = " << ssidPtr << std::endl;
@@ -3953,10 +3953,10 @@ TEST(em_cmd_t, get_network_ssid_index_at_boundary)
     std::cout << "Entering get_network_ssid_index_beyond_boundary test" << std::endl;
     em_cmd_t cmdObj;
     unsigned int boundaryIndex = 4;
-    memcpy(cmdObj.m_data_model.m_network_ssid[boundaryIndex].m_network_ssid_info.ssid, "TestSSID2", strlen("TestSSID2") + 1);
-    cmdObj.m_data_model.m_network_ssid[boundaryIndex].m_network_ssid_info.num_bands = 2;
-    cmdObj.m_data_model.m_network_ssid[boundaryIndex].m_network_ssid_info.enable = true;
-    cmdObj.m_data_model.m_network_ssid[boundaryIndex].m_network_ssid_info.num_hauls = 2;
+    memcpy(cmdObj.m_data_model->m_network_ssid[boundaryIndex].m_network_ssid_info.ssid, "TestSSID2", strlen("TestSSID2") + 1);
+    cmdObj.m_data_model->m_network_ssid[boundaryIndex].m_network_ssid_info.num_bands = 2;
+    cmdObj.m_data_model->m_network_ssid[boundaryIndex].m_network_ssid_info.enable = true;
+    cmdObj.m_data_model->m_network_ssid[boundaryIndex].m_network_ssid_info.num_hauls = 2;
     std::cout << "Invoking get_network_ssid with index = " << boundaryIndex << std::endl;
     dm_network_ssid_t *ssidPtr = cmdObj.get_network_ssid(boundaryIndex);
     ASSERT_NE(ssidPtr, nullptr);
@@ -4025,10 +4025,10 @@ TEST(em_cmd_t, get_radio_valid_index_returns_valid_radio_pointer)
     std::cout << "Entering get_radio_valid_index_returns_valid_radio_pointer test" << std::endl;
     em_cmd_t cmd;
 	unsigned int index = 1;
-	cmd.m_data_model.m_radio[index].m_radio_info.enabled = true;
-	cmd.m_data_model.m_radio[index].m_radio_info.number_of_bss = 2;
-	cmd.m_data_model.m_radio[index].m_radio_info.number_of_unassoc_sta = 1;
-	cmd.m_data_model.m_radio[index].m_radio_info.noise = 4;
+	cmd.m_data_model->m_radio[index].m_radio_info.enabled = true;
+	cmd.m_data_model->m_radio[index].m_radio_info.number_of_bss = 2;
+	cmd.m_data_model->m_radio[index].m_radio_info.number_of_unassoc_sta = 1;
+	cmd.m_data_model->m_radio[index].m_radio_info.noise = 4;
     std::cout << "Invoking get_radio with index 1" << std::endl;
     dm_radio_t* radio = cmd.get_radio(index);
     ASSERT_NE(radio, nullptr);   
@@ -4071,10 +4071,10 @@ TEST(em_cmd_t, get_radio_edge_index_zero_returns_valid_radio_pointer)
     std::cout << "Entering get_radio_edge_index_zero_returns_valid_radio_pointer test" << std::endl;
     em_cmd_t cmd;
     unsigned int index = 0;
-    cmd.m_data_model.m_radio[index].m_radio_info.enabled = true;
-    cmd.m_data_model.m_radio[index].m_radio_info.number_of_bss = 2;
-    cmd.m_data_model.m_radio[index].m_radio_info.number_of_unassoc_sta =1;
-    cmd.m_data_model.m_radio[index].m_radio_info.noise = 4;
+    cmd.m_data_model->m_radio[index].m_radio_info.enabled = true;
+    cmd.m_data_model->m_radio[index].m_radio_info.number_of_bss = 2;
+    cmd.m_data_model->m_radio[index].m_radio_info.number_of_unassoc_sta =1;
+    cmd.m_data_model->m_radio[index].m_radio_info.noise = 4;
     std::cout << "Invoking get_radio with index 0" << std::endl;
     dm_radio_t* radio = cmd.get_radio(index);
     ASSERT_NE(radio, nullptr);
@@ -4116,10 +4116,10 @@ TEST(em_cmd_t, get_radio_out_of_range_index_returns_nullptr)
     std::cout << "Entering get_radio_out_of_range_index_returns_nullptr test" << std::endl;
     em_cmd_t cmd;        
     unsigned int outOfRangeIndex = 100;
-    cmd.m_data_model.m_radio[outOfRangeIndex].m_radio_info.enabled = true;
-    cmd.m_data_model.m_radio[outOfRangeIndex].m_radio_info.number_of_bss = 2;
-    cmd.m_data_model.m_radio[outOfRangeIndex].m_radio_info.number_of_unassoc_sta = 1;
-    cmd.m_data_model.m_radio[outOfRangeIndex].m_radio_info.noise = 4;
+    cmd.m_data_model->m_radio[outOfRangeIndex].m_radio_info.enabled = true;
+    cmd.m_data_model->m_radio[outOfRangeIndex].m_radio_info.number_of_bss = 2;
+    cmd.m_data_model->m_radio[outOfRangeIndex].m_radio_info.number_of_unassoc_sta = 1;
+    cmd.m_data_model->m_radio[outOfRangeIndex].m_radio_info.noise = 4;
     std::cout << "Invoking get_radio with out-of-range index " << outOfRangeIndex << std::endl;
     dm_radio_t* radio = cmd.get_radio(outOfRangeIndex);
     std::cout << "Returned pointer from get_radio(" << outOfRangeIndex << "): " << radio << std::endl;    
@@ -4150,21 +4150,21 @@ TEST(em_cmd_t, get_radio_data_valid_match)
 {
     std::cout << "Entering get_radio_data_valid_match test" << std::endl;
     em_cmd_t cmd{};
-    cmd.m_data_model.m_wifi_data = static_cast<webconfig_subdoc_data_t*>(calloc(1, sizeof(webconfig_subdoc_data_t)));
-    ASSERT_NE(cmd.m_data_model.m_wifi_data, nullptr);
-    cmd.m_data_model.m_wifi_data->u.decoded.num_radios = 1;
-    strncpy(cmd.m_data_model.m_wifi_data->u.decoded.radios[0].name,
-            "Interface1", sizeof(cmd.m_data_model.m_wifi_data->u.decoded.radios[0].name) - 1);
+    cmd.m_data_model->m_wifi_data = static_cast<webconfig_subdoc_data_t*>(calloc(1, sizeof(webconfig_subdoc_data_t)));
+    ASSERT_NE(cmd.m_data_model->m_wifi_data, nullptr);
+    cmd.m_data_model->m_wifi_data->u.decoded.num_radios = 1;
+    strncpy(cmd.m_data_model->m_wifi_data->u.decoded.radios[0].name,
+            "Interface1", sizeof(cmd.m_data_model->m_wifi_data->u.decoded.radios[0].name) - 1);
     em_interface_t iface{};	
     strncpy(iface.name, "Interface1", sizeof(iface.name) - 1);
     uint8_t sample_mac[6] = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0x1A};
     memcpy(iface.mac, sample_mac, sizeof(sample_mac));
     iface.media = em_media_type_ieee80211n_5;
     std::cout << "Invoking get_radio_data with matching interface name" << std::endl;
-    rdk_wifi_radio_t *radio = cmd.m_data_model.get_radio_data(&iface);
+    rdk_wifi_radio_t *radio = cmd.m_data_model->get_radio_data(&iface);
     EXPECT_NE(radio, nullptr);
     std::cout << "Returned radio pointer: " << radio << std::endl;
-    free(cmd.m_data_model.m_wifi_data);
+    free(cmd.m_data_model->m_wifi_data);
     std::cout << "Exiting get_radio_data_valid_match test" << std::endl;
 }
 /**
@@ -4189,10 +4189,10 @@ TEST(em_cmd_t, get_radio_data_null_interface_crashes)
 {
     std::cout << "Entering get_radio_data_null_interface_crashes test" << std::endl;
     em_cmd_t cmd{};
-    cmd.m_data_model.m_wifi_data = static_cast<webconfig_subdoc_data_t*>(calloc(1, sizeof(webconfig_subdoc_data_t)));
-    rdk_wifi_radio_t *ptr = cmd.m_data_model.get_radio_data(nullptr);
+    cmd.m_data_model->m_wifi_data = static_cast<webconfig_subdoc_data_t*>(calloc(1, sizeof(webconfig_subdoc_data_t)));
+    rdk_wifi_radio_t *ptr = cmd.m_data_model->get_radio_data(nullptr);
 	EXPECT_EQ(ptr, nullptr);
-    free(cmd.m_data_model.m_wifi_data);
+    free(cmd.m_data_model->m_wifi_data);
     std::cout << "Exiting get_radio_data_null_interface_crashes test" << std::endl;
 }
 /**
@@ -4223,17 +4223,17 @@ TEST(em_cmd_t, get_radio_data_no_radios_returns_null)
 {
     std::cout << "Entering get_radio_data_no_radios_returns_null test" << std::endl;
     em_cmd_t cmd{};
-    cmd.m_data_model.m_wifi_data = static_cast<webconfig_subdoc_data_t*>(calloc(1, sizeof(webconfig_subdoc_data_t)));
-    ASSERT_NE(cmd.m_data_model.m_wifi_data, nullptr);
-    cmd.m_data_model.m_wifi_data->u.decoded.num_radios = 0;
+    cmd.m_data_model->m_wifi_data = static_cast<webconfig_subdoc_data_t*>(calloc(1, sizeof(webconfig_subdoc_data_t)));
+    ASSERT_NE(cmd.m_data_model->m_wifi_data, nullptr);
+    cmd.m_data_model->m_wifi_data->u.decoded.num_radios = 0;
     em_interface_t iface{};
     strncpy(iface.name, "Interface1", sizeof(iface.name) - 1);
     uint8_t sample_mac[6] = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0x1A};
     memcpy(iface.mac, sample_mac, sizeof(sample_mac));
     iface.media = em_media_type_ieee80211n_5;
-    rdk_wifi_radio_t *radio = cmd.m_data_model.get_radio_data(&iface);
+    rdk_wifi_radio_t *radio = cmd.m_data_model->get_radio_data(&iface);
     EXPECT_EQ(radio, nullptr);
-    free(cmd.m_data_model.m_wifi_data);
+    free(cmd.m_data_model->m_wifi_data);
     std::cout << "Exiting get_radio_data_no_radios_returns_null test" << std::endl;
 }
 /**
@@ -5195,4 +5195,52 @@ TEST(em_cmd_t, override_op_null_descriptor)
     std::cout << "Invoking override_op with index = " << index << " and NULL descriptor pointer" << std::endl;
     EXPECT_ANY_THROW(cmd.override_op(index, nullptr));
     std::cout << "Exiting override_op_null_descriptor test" << std::endl;
-}
\ No newline at end of file
+}
+/**
+ * @brief Verify that clones share the data model until one of them takes its own copy.
+ *
+ * This test clones a command for the next orchestration step and checks that both commands read the same data model while each keeps its own command context, and that get_own_data_model() gives the clone a private copy without changing the original.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 126@n
+ * **Priority:** High@n
+ * @n
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ * @n
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Clone a command of two orchestration steps | orig.m_num_orch_desc = 2, orig.m_ctx.arr_index = 3 | The clone has the same data model, its context is reset | Should Pass |
+ * | 02 | Take a private data model on the clone and change it | clone->get_own_data_model()->m_num_bss = 5 | The clone points to another data model, the original keeps m_num_bss | Should Pass |
+ */
+TEST(em_cmd_t, CloneSharesDataModel)
+{
+    std::cout << "Entering CloneSharesDataModel test" << std::endl;
+    em_cmd_t orig;
+    dm_easy_mesh_t *own;
+    orig.m_type = em_cmd_type_reset;
+    orig.m_orch_op_idx = 0;
+    orig.m_num_orch_desc = 2;
+    for (unsigned int i = 0; i < orig.m_num_orch_desc; i++) {
+        orig.m_orch_desc[i].op = dm_orch_type_net_insert;
+        orig.m_orch_desc[i].submit = true;
+    }
+    orig.m_ctx.arr_index = 3;
+    orig.m_data_model->m_num_bss = 1;
+    em_cmd_t* clone = orig.clone_for_next();
+    ASSERT_NE(clone, nullptr);
+    EXPECT_EQ(clone->get_data_model(), orig.get_data_model());
+    EXPECT_EQ(clone->get_cmd_ctx()->arr_index, 0u);
+    EXPECT_EQ(orig.get_cmd_ctx()->arr_index, 3u);
+    own = clone->get_own_data_model();
+    ASSERT_NE(own, nullptr);
+    EXPECT_NE(own, orig.get_data_model());
+    own->m_num_bss = 5;
+    EXPECT_EQ(orig.get_data_model()->m_num_bss, 1u);
+    EXPECT_EQ(clone->get_own_data_model(), own);
+    clone->deinit();
+    delete clone;
+    std::cout << "Exiting CloneSharesDataModel test" << std::endl;
+}
@@ -65,7 +65,7 @@ TEST(em_cmd_ap_metrics_report_t, em_cmd_ap_metrics_report_t_valid_parameters) {
     EXPECT_STREQ(cmd.m_name, "ap_metrics_report");
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_none);
     EXPECT_EQ(cmd.m_svc, em_service_type_agent);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_none);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_none);
     cmd.deinit();
     std::cout << "Exiting em_cmd_ap_metrics_report_t_valid_parameters test" << std::endl;
 }
@@ -113,7 +113,7 @@ TEST(em_cmd_ap_metrics_report_t, em_cmd_ap_metrics_report_t_empty_fixed_args) {
     EXPECT_STREQ(cmd.m_name, "ap_metrics_report");
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_none);
     EXPECT_EQ(cmd.m_svc, em_service_type_agent);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_none);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_none);
     cmd.deinit();
     std::cout << "Exiting em_cmd_ap_metrics_report_t_empty_fixed_args test" << std::endl;
 }
@@ -162,7 +162,7 @@ TEST(em_cmd_ap_metrics_report_t, em_cmd_ap_metrics_report_t_ConstructWithMaxSSID
     EXPECT_STREQ(cmd.m_name, "ap_metrics_report");
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_none);
     EXPECT_EQ(cmd.m_svc, em_service_type_agent);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_none);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_none);
     cmd.deinit();
     std::cout << "Exiting em_cmd_ap_metrics_report_t_ConstructWithMaxSSIDLength test" << std::endl;
 }
@@ -75,7 +75,7 @@ TEST(em_cmd_beacon_report_t, em_cmd_beacon_report_t_create_valid_parameters) {
     EXPECT_STREQ(cmd.m_name, "beacon_report");
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_beacon_report);
     EXPECT_EQ(cmd.m_svc, em_service_type_ctrl);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_beacon_report);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_beacon_report);
     cmd.deinit();
     std::cout << "Exiting em_cmd_beacon_report_t_create_valid_parameters test" << std::endl;
 }
@@ -123,7 +123,7 @@ TEST(em_cmd_beacon_report_t, em_cmd_beacon_report_t_create_edge_case_parameter_l
     EXPECT_STREQ(beaconReport.m_name, "beacon_report");
     EXPECT_EQ(beaconReport.m_orch_desc[0].op, dm_orch_type_beacon_report);
     EXPECT_EQ(beaconReport.m_svc, em_service_type_ctrl);
-    EXPECT_EQ(beaconReport.m_data_model.m_cmd_ctx.type, dm_orch_type_beacon_report);
+    EXPECT_EQ(beaconReport.m_ctx.type, dm_orch_type_beacon_report);
     EXPECT_EQ(memcmp(beaconReport.m_param.u.args.fixed_args, param.u.args.fixed_args, sizeof(param.u.args.fixed_args)), 0);
     EXPECT_EQ(beaconReport.m_param.u.args.num_args, maxArgs);
     for (int i = 0; i < maxArgs; i++) {
@@ -193,7 +193,7 @@ TEST(em_cmd_beacon_report_t, em_cmd_beacon_report_t_create_minimal_valid_paramet
     EXPECT_STREQ(beaconReport.m_name, "beacon_report");
     EXPECT_EQ(beaconReport.m_orch_desc[0].op, dm_orch_type_beacon_report);
     EXPECT_EQ(beaconReport.m_svc, em_service_type_ctrl);
-    EXPECT_EQ(beaconReport.m_data_model.m_cmd_ctx.type, dm_orch_type_beacon_report);
+    EXPECT_EQ(beaconReport.m_ctx.type, dm_orch_type_beacon_report);
     beaconReport.deinit();
     std::cout << "Exiting em_cmd_beacon_report_t_create_minimal_valid_parameters test" << std::endl;
 }
@@ -240,7 +240,7 @@ TEST(em_cmd_beacon_report_t, em_cmd_beacon_report_t_empty_fixed_args) {
     EXPECT_STREQ(cmd.m_name,  "beacon_report");
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_beacon_report);
     EXPECT_EQ(cmd.m_svc, em_service_type_ctrl);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_beacon_report);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_beacon_report);
     cmd.deinit();
     std::cout << "Exiting em_cmd_beacon_report_t_empty_fixed_args test" << std::endl;
 }
\ No newline at end of file
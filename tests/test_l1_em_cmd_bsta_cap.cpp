@@ -69,7 +69,7 @@ TEST(em_cmd_bsta_cap_t, em_cmd_bsta_cap_t_ValidConstruction)
     EXPECT_STREQ(obj.m_name, "bsta_cap");
     EXPECT_EQ(obj.m_orch_desc[0].op, dm_orch_type_bsta_cap_query);
     EXPECT_EQ(obj.m_svc, em_service_type_ctrl);
-    EXPECT_EQ(obj.m_data_model.m_cmd_ctx.type, dm_orch_type_bsta_cap_query);
+    EXPECT_EQ(obj.m_ctx.type, dm_orch_type_bsta_cap_query);
     obj.deinit();
     std::cout << "Exiting em_cmd_bsta_cap_t_ValidConstruction test" << std::endl;
 }
@@ -117,7 +117,7 @@ TEST(em_cmd_bsta_cap_t, em_cmd_bsta_cap_t_NullNetNode)
     EXPECT_STREQ(obj.m_name, "bsta_cap");
     EXPECT_EQ(obj.m_orch_desc[0].op, dm_orch_type_bsta_cap_query);
     EXPECT_EQ(obj.m_svc, em_service_type_ctrl);
-    EXPECT_EQ(obj.m_data_model.m_cmd_ctx.type, dm_orch_type_bsta_cap_query);
+    EXPECT_EQ(obj.m_ctx.type, dm_orch_type_bsta_cap_query);
     obj.deinit();
     std::cout << "Exiting em_cmd_bsta_cap_t_NullNetNode test" << std::endl;
 }
@@ -160,7 +160,7 @@ TEST(em_cmd_bsta_cap_t, em_cmd_bsta_cap_t_EmptyFixedArgs)
     EXPECT_STREQ(obj.m_name, "bsta_cap");
     EXPECT_EQ(obj.m_orch_desc[0].op, dm_orch_type_bsta_cap_query);
     EXPECT_EQ(obj.m_svc, em_service_type_ctrl);
-    EXPECT_EQ(obj.m_data_model.m_cmd_ctx.type, dm_orch_type_bsta_cap_query);
+    EXPECT_EQ(obj.m_ctx.type, dm_orch_type_bsta_cap_query);
     obj.deinit();
     std::cout << "Exiting em_cmd_bsta_cap_t_EmptyFixedArgs test" << std::endl;    
 }
@@ -209,7 +209,7 @@ TEST(em_cmd_bsta_cap_t, em_cmd_bsta_cap_t_MaxLengthFixedArgs)
     EXPECT_STREQ(obj.m_name, "bsta_cap");
     EXPECT_EQ(obj.m_orch_desc[0].op, dm_orch_type_bsta_cap_query);
     EXPECT_EQ(obj.m_svc, em_service_type_ctrl);
-    EXPECT_EQ(obj.m_data_model.m_cmd_ctx.type, dm_orch_type_bsta_cap_query);
+    EXPECT_EQ(obj.m_ctx.type, dm_orch_type_bsta_cap_query);
     obj.deinit();
     std::cout << "Exiting em_cmd_bsta_cap_t_MaxLengthFixedArgs test" << std::endl;
 }
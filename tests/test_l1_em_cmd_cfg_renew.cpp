@@ -69,7 +69,7 @@ TEST(em_cmd_cfg_renew_t, em_cmd_cfg_renew_t_valid_ctrl)
     std::cout << "Constructor invoked with service = "
               << static_cast<unsigned int>(service)
               << " and fixed_args = " << cmd.m_param.u.args.fixed_args
-              << ", network id = " << cmd.m_data_model.m_network.m_net_info.id
+              << ", network id = " << cmd.m_data_model->m_network.m_net_info.id
               << std::endl;
     EXPECT_EQ(cmd.m_type, em_cmd_type_cfg_renew);
     EXPECT_STREQ(cmd.m_name, "cfg_renew");
@@ -79,7 +79,7 @@ TEST(em_cmd_cfg_renew_t, em_cmd_cfg_renew_t_valid_ctrl)
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_tx_cfg_renew);
     EXPECT_EQ(cmd.m_orch_desc[0].submit, true);
     EXPECT_STREQ(cmd.m_param.u.args.fixed_args, "TestCtrl");
-    EXPECT_STREQ(cmd.m_data_model.m_network.m_net_info.id, "NetworkID_CTRL");
+    EXPECT_STREQ(cmd.m_data_model->m_network.m_net_info.id, "NetworkID_CTRL");
     cmd.deinit();
     std::cout << "Exiting " << testName << " test" << std::endl;
 }
@@ -117,7 +117,7 @@ TEST(em_cmd_cfg_renew_t, em_cmd_cfg_renew_t_valid_agent)
     std::cout << "Constructor invoked with service = "
               << static_cast<unsigned int>(service)
               << " and fixed_args = " << cmd.m_param.u.args.fixed_args
-              << ", network id = " << cmd.m_data_model.m_network.m_net_info.id
+              << ", network id = " << cmd.m_data_model->m_network.m_net_info.id
               << std::endl;
     EXPECT_EQ(cmd.m_type, em_cmd_type_cfg_renew);
     EXPECT_STREQ(cmd.m_name, "cfg_renew");
@@ -127,7 +127,7 @@ TEST(em_cmd_cfg_renew_t, em_cmd_cfg_renew_t_valid_agent)
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_tx_cfg_renew);
     EXPECT_EQ(cmd.m_orch_desc[0].submit, true);
     EXPECT_STREQ(cmd.m_param.u.args.fixed_args, "AgentParam");
-    EXPECT_STREQ(cmd.m_data_model.m_network.m_net_info.id, "NetworkID_AGENT");
+    EXPECT_STREQ(cmd.m_data_model->m_network.m_net_info.id, "NetworkID_AGENT");
     cmd.deinit();
     std::cout << "Exiting " << testName << " test" << std::endl;
 }
@@ -167,7 +167,7 @@ TEST(em_cmd_cfg_renew_t, em_cmd_cfg_renew_t_valid_cli)
     std::cout << "Constructor invoked with service = "
               << static_cast<unsigned int>(service)
               << " and fixed_args = " << cmd.m_param.u.args.fixed_args
-              << ", network id = " << cmd.m_data_model.m_network.m_net_info.id
+              << ", network id = " << cmd.m_data_model->m_network.m_net_info.id
               << std::endl;
     EXPECT_EQ(cmd.m_type, em_cmd_type_cfg_renew);
     EXPECT_STREQ(cmd.m_name, "cfg_renew");
@@ -177,7 +177,7 @@ TEST(em_cmd_cfg_renew_t, em_cmd_cfg_renew_t_valid_cli)
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_tx_cfg_renew);
     EXPECT_TRUE(cmd.m_orch_desc[0].submit);
     EXPECT_STREQ(cmd.m_param.u.args.fixed_args, "CliFixedArg");
-    EXPECT_STREQ(cmd.m_data_model.m_network.m_net_info.id, "NetworkID_CLI");
+    EXPECT_STREQ(cmd.m_data_model->m_network.m_net_info.id, "NetworkID_CLI");
     cmd.deinit();
     std::cout << "Exiting " << testName << " test" << std::endl;
 }
@@ -217,7 +217,7 @@ TEST(em_cmd_cfg_renew_t, em_cmd_cfg_renew_t_valid_none)
     std::cout << "Constructor invoked with service = "
               << static_cast<unsigned int>(service)
               << " and fixed_args = \"" << cmd.m_param.u.args.fixed_args
-              << "\", network id = " << cmd.m_data_model.m_network.m_net_info.id
+              << "\", network id = " << cmd.m_data_model->m_network.m_net_info.id
               << std::endl;
     EXPECT_EQ(cmd.m_type, em_cmd_type_cfg_renew);
     EXPECT_STREQ(cmd.m_name, "cfg_renew");
@@ -227,7 +227,7 @@ TEST(em_cmd_cfg_renew_t, em_cmd_cfg_renew_t_valid_none)
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_tx_cfg_renew);
     EXPECT_TRUE(cmd.m_orch_desc[0].submit);
     EXPECT_STREQ(cmd.m_param.u.args.fixed_args, "");
-    EXPECT_STREQ(cmd.m_data_model.m_network.m_net_info.id, "NetworkID_NONE");
+    EXPECT_STREQ(cmd.m_data_model->m_network.m_net_info.id, "NetworkID_NONE");
     cmd.deinit();
     std::cout << "Exiting " << testName << " test" << std::endl;
 }
@@ -268,7 +268,7 @@ TEST(em_cmd_cfg_renew_t, em_cmd_cfg_renew_t_negative_empty_param)
     std::cout << "Constructor invoked with service = "
               << static_cast<unsigned int>(service)
               << " and fixed_args = \"" << cmd.m_param.u.args.fixed_args
-              << "\", network id = " << cmd.m_data_model.m_network.m_net_info.id
+              << "\", network id = " << cmd.m_data_model->m_network.m_net_info.id
               << std::endl;
     EXPECT_EQ(cmd.m_type, em_cmd_type_cfg_renew);
     EXPECT_STREQ(cmd.m_name, "cfg_renew");
@@ -276,7 +276,7 @@ TEST(em_cmd_cfg_renew_t, em_cmd_cfg_renew_t_negative_empty_param)
     EXPECT_EQ(cmd.m_orch_op_idx, 0);
     EXPECT_EQ(cmd.m_num_orch_desc, 1);
     EXPECT_STREQ(cmd.m_param.u.args.fixed_args, "");
-    EXPECT_STREQ(cmd.m_data_model.m_network.m_net_info.id, "NetworkID_EmptyParam");
+    EXPECT_STREQ(cmd.m_data_model->m_network.m_net_info.id, "NetworkID_EmptyParam");
     cmd.deinit();
     std::cout << "Exiting " << testName << " test" << std::endl;
 }
@@ -316,7 +316,7 @@ TEST(em_cmd_cfg_renew_t, em_cmd_cfg_renew_t_negative_dm_error)
     std::cout << "Constructor invoked with service = "
               << static_cast<unsigned int>(service)
               << " and fixed_args = " << cmd.m_param.u.args.fixed_args
-              << ", network id = \"" << cmd.m_data_model.m_network.m_net_info.id << "\""
+              << ", network id = \"" << cmd.m_data_model->m_network.m_net_info.id << "\""
               << std::endl;
     EXPECT_EQ(cmd.m_type, em_cmd_type_cfg_renew);
     EXPECT_STREQ(cmd.m_name, "cfg_renew");
@@ -324,7 +324,7 @@ TEST(em_cmd_cfg_renew_t, em_cmd_cfg_renew_t_negative_dm_error)
     EXPECT_EQ(cmd.m_orch_op_idx, 0);
     EXPECT_EQ(cmd.m_num_orch_desc, 1);
     EXPECT_STREQ(cmd.m_param.u.args.fixed_args, "ValidAgentParam");
-    EXPECT_STREQ(cmd.m_data_model.m_network.m_net_info.id, "");
+    EXPECT_STREQ(cmd.m_data_model->m_network.m_net_info.id, "");
     cmd.deinit();
     std::cout << "Exiting " << testName << " test" << std::endl;
 }
\ No newline at end of file
@@ -71,7 +71,7 @@ TEST(em_cmd_client_cap_report_t, em_cmd_client_cap_report_t_valid_client_cap_rep
     EXPECT_STREQ(clientCapReport.m_param.u.args.args[0], "Arg1");
     EXPECT_STREQ(clientCapReport.m_param.u.args.args[1], "Arg2");
     EXPECT_STREQ(clientCapReport.m_param.u.args.args[2], "Arg3");
-    EXPECT_STREQ(clientCapReport.m_data_model.m_network.m_net_info.id, "");
+    EXPECT_STREQ(clientCapReport.m_data_model->m_network.m_net_info.id, "");
     clientCapReport.deinit();
     std::cout << "Exiting em_cmd_client_cap_report_t_valid_client_cap_report test" << std::endl;
 }
@@ -117,7 +117,7 @@ TEST(em_cmd_client_cap_report_t, em_cmd_client_cap_report_t_minimal_client_cap_r
     for (unsigned int i = 0; i < EM_CLI_MAX_ARGS; i++) {
         EXPECT_STREQ(clientCapReport.m_param.u.args.args[i], "");
     }
-    EXPECT_STREQ(clientCapReport.m_data_model.m_network.m_net_info.id, "");
+    EXPECT_STREQ(clientCapReport.m_data_model->m_network.m_net_info.id, "");
     clientCapReport.deinit();
     std::cout << "Exiting em_cmd_client_cap_report_t_minimal_client_cap_report test" << std::endl;
 }
\ No newline at end of file
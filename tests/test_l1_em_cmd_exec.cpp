@@ -0,0 +1,102 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "em_cmd_exec.h"
+
+/**
+* @brief Test that an encoded bus event carries only its arguments and its subdocument
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Encode a bus event with one argument and a subdocument | num_args = 1, data_len = 32 | Header fields match, zero tail of the parameters dropped, subdocument follows | Should Pass |
+*/
+TEST(em_cmd_exec_t_Test, EncodeBusEvent) {
+    std::cout << "Entering EncodeBusEvent test" << std::endl;
+    unsigned int data_len = 32, len, off;
+    em_event_t *evt = static_cast<em_event_t *> (calloc(1, sizeof(em_event_t) + data_len));
+    unsigned int sz = static_cast<unsigned int> (sizeof(em_cmd_wire_hdr_t) + sizeof(em_event_t)) + data_len;
+    unsigned char *buff = static_cast<unsigned char *> (malloc(sz));
+    em_cmd_wire_hdr_t *hdr = reinterpret_cast<em_cmd_wire_hdr_t *> (buff);
+    em_bus_event_t *bevt = &evt->u.bevt;
+    ASSERT_NE(evt, nullptr);
+    ASSERT_NE(buff, nullptr);
+    evt->type = em_event_type_bus;
+    bevt->type = em_bus_event_type_get_network;
+    bevt->params.u.args.num_args = 1;
+    bevt->data_len = data_len;
+    snprintf(bevt->u.subdoc.name, sizeof(bevt->u.subdoc.name), "%s", "Network");
+    memset(bevt->u.subdoc.buff, 'x', data_len);
+
+    len = em_cmd_exec_t::encode_event(evt, buff, sz);
+    EXPECT_EQ(hdr->magic, static_cast<unsigned int> (EM_CMD_WIRE_MAGIC));
+    EXPECT_EQ(hdr->type, static_cast<unsigned int> (em_bus_event_type_get_network));
+    EXPECT_GT(hdr->params_len, 0u);
+    EXPECT_LE(hdr->params_len, sizeof(bevt->params.u.args.num_args));
+    EXPECT_EQ(hdr->data_len, data_len);
+    EXPECT_EQ(len, sizeof(em_cmd_wire_hdr_t) + hdr->params_len + sizeof(bevt->u) + data_len);
+    EXPECT_LT(len, sizeof(em_event_t) + data_len);
+    off = static_cast<unsigned int> (sizeof(em_cmd_wire_hdr_t)) + hdr->params_len;
+    EXPECT_STREQ(reinterpret_cast<char *> (buff + off), "Network");
+    EXPECT_EQ(buff[off + sizeof(bevt->u.subdoc.name) + data_len - 1], 'x');
+    free(buff);
+    free(evt);
+    std::cout << "Exiting EncodeBusEvent test" << std::endl;
+}
+
+/**
+* @brief Test that events that cannot be encoded are refused
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Encode a frame event | em_event_type_frame | 0 is returned | Should Pass |
+* | 02| Encode a bus event into a buffer too small | len = sizeof(em_cmd_wire_hdr_t) | 0 is returned | Should Pass |
+*/
+TEST(em_cmd_exec_t_Test, EncodeRefused) {
+    std::cout << "Entering EncodeRefused test" << std::endl;
+    em_event_t evt;
+    unsigned char buff[sizeof(em_cmd_wire_hdr_t) + sizeof(em_event_t)];
+    memset(&evt, 0, sizeof(evt));
+    evt.type = em_event_type_frame;
+    EXPECT_EQ(em_cmd_exec_t::encode_event(&evt, buff, sizeof(buff)), 0u);
+    evt.type = em_event_type_bus;
+    EXPECT_EQ(em_cmd_exec_t::encode_event(&evt, buff, sizeof(em_cmd_wire_hdr_t)), 0u);
+    EXPECT_NE(em_cmd_exec_t::encode_event(&evt, buff, sizeof(buff)), 0u);
+    std::cout << "Exiting EncodeRefused test" << std::endl;
+}
@@ -67,7 +67,7 @@ TEST(em_cmd_ow_cb_t, em_cmd_ow_cb_t_valid_instance_creation)
     EXPECT_STREQ(obj.m_name, "onewifi_cnf");
     EXPECT_EQ(obj.m_orch_desc[0].op, dm_orch_type_owconfig_cnf);
     EXPECT_EQ(obj.m_svc, em_service_type_agent);
-    EXPECT_EQ(obj.m_data_model.m_cmd_ctx.type, dm_orch_type_owconfig_cnf);
+    EXPECT_EQ(obj.m_ctx.type, dm_orch_type_owconfig_cnf);
     obj.deinit();
     std::cout << "Exiting em_cmd_ow_cb_t_em_cmd_ow_cb_t_valid_instance_creation test" << std::endl;
 }
@@ -115,7 +115,7 @@ TEST(em_cmd_ow_cb_t, em_cmd_ow_cb_t_empty_fixed_args)
     EXPECT_STREQ(obj.m_name, "onewifi_cnf");
     EXPECT_EQ(obj.m_orch_desc[0].op, dm_orch_type_owconfig_cnf);
     EXPECT_EQ(obj.m_svc, em_service_type_agent);
-    EXPECT_EQ(obj.m_data_model.m_cmd_ctx.type, dm_orch_type_owconfig_cnf);
+    EXPECT_EQ(obj.m_ctx.type, dm_orch_type_owconfig_cnf);
     obj.deinit();
     std::cout << "Exiting em_cmd_ow_cb_t_empty_fixed_args test" << std::endl;
 }
@@ -162,7 +162,7 @@ TEST(em_cmd_ow_cb_t, em_cmd_ow_cb_t_ConstructWithMaxSSIDLength)
     EXPECT_STREQ(obj.m_name, "onewifi_cnf");
     EXPECT_EQ(obj.m_orch_desc[0].op, dm_orch_type_owconfig_cnf);
     EXPECT_EQ(obj.m_svc, em_service_type_agent);
-    EXPECT_EQ(obj.m_data_model.m_cmd_ctx.type, dm_orch_type_owconfig_cnf);
+    EXPECT_EQ(obj.m_ctx.type, dm_orch_type_owconfig_cnf);
     obj.deinit();
     std::cout << "Exiting em_cmd_ow_cb_t_ConstructWithMaxSSIDLength test" << std::endl;
 }
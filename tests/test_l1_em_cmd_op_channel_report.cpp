@@ -76,7 +76,7 @@ TEST(em_cmd_op_channel_report_t, em_cmd_op_channel_report_t_valid)
     EXPECT_EQ(cmd.m_num_orch_desc, 1);
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_op_channel_report);
     EXPECT_EQ(cmd.m_orch_desc[0].submit, true);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_op_channel_report);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_op_channel_report);
     cmd.deinit();
     std::cout << "Exiting em_cmd_op_channel_report_t_valid test" << std::endl;
 }
@@ -116,7 +116,7 @@ TEST(em_cmd_op_channel_report_t, em_cmd_op_channel_report_t_empty)
     EXPECT_EQ(cmd.m_num_orch_desc, 1);
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_op_channel_report);
     EXPECT_EQ(cmd.m_orch_desc[0].submit, true);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_op_channel_report);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_op_channel_report);
     cmd.deinit();
     std::cout << "Exiting em_cmd_op_channel_report_t_empty test" << std::endl;
 }
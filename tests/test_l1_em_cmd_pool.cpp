@@ -0,0 +1,121 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include "em_cmd.h"
+#include "em_cmd_pool.h"
+
+/**
+* @brief Test that a released block is recycled by the next allocation of the same size
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Allocate a block, release it and allocate the same size again | size = 256 | Same block is returned, counted as a hit | Should Pass |
+*/
+TEST(em_cmd_pool_t_Test, RecycleSameSize) {
+    std::cout << "Entering RecycleSameSize test" << std::endl;
+    em_cmd_pool_t pool;
+    unsigned int alloc, hit, cached;
+    void *first = pool.alloc(256);
+    ASSERT_NE(first, nullptr);
+    pool.release(first);
+    void *second = pool.alloc(256);
+    EXPECT_EQ(first, second);
+    ASSERT_TRUE(pool.get_stats(256, &alloc, &hit, &cached));
+    EXPECT_EQ(alloc, 2u);
+    EXPECT_EQ(hit, 1u);
+    EXPECT_EQ(cached, 0u);
+    pool.release(second);
+    std::cout << "Exiting RecycleSameSize test" << std::endl;
+}
+
+/**
+* @brief Test that blocks of different sizes are not mixed up
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Release a small block and allocate a larger one | size = 64, 4096 | A different block is returned and the full size is writable | Should Pass |
+*/
+TEST(em_cmd_pool_t_Test, SizesAreSeparate) {
+    std::cout << "Entering SizesAreSeparate test" << std::endl;
+    em_cmd_pool_t pool;
+    unsigned int alloc, hit, cached;
+    void *small = pool.alloc(64);
+    ASSERT_NE(small, nullptr);
+    pool.release(small);
+    void *large = pool.alloc(4096);
+    ASSERT_NE(large, nullptr);
+    EXPECT_NE(small, large);
+    memset(large, 0xa5, 4096);
+    ASSERT_TRUE(pool.get_stats(64, &alloc, &hit, &cached));
+    EXPECT_EQ(cached, 1u);
+    ASSERT_TRUE(pool.get_stats(4096, &alloc, &hit, &cached));
+    EXPECT_EQ(hit, 0u);
+    pool.release(large);
+    std::cout << "Exiting SizesAreSeparate test" << std::endl;
+}
+
+/**
+* @brief Test that commands are allocated from the shared pool
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Create and delete a command, then create another one | new em_cmd_t | Same block is returned and the pool counts a hit | Should Pass |
+*/
+TEST(em_cmd_pool_t_Test, CommandRecycled) {
+    std::cout << "Entering CommandRecycled test" << std::endl;
+    unsigned int alloc, hit, cached, prev_hit;
+    em_cmd_t *first = new em_cmd_t();
+    ASSERT_TRUE(em_cmd_pool_t::get_pool()->get_stats(sizeof(em_cmd_t), &alloc, &prev_hit, &cached));
+    delete first;
+    em_cmd_t *second = new em_cmd_t();
+    EXPECT_EQ(first, second);
+    ASSERT_TRUE(em_cmd_pool_t::get_pool()->get_stats(sizeof(em_cmd_t), &alloc, &hit, &cached));
+    EXPECT_EQ(hit, prev_hit + 1);
+    delete second;
+    std::cout << "Exiting CommandRecycled test" << std::endl;
+}
@@ -64,7 +64,7 @@ TEST(em_cmd_remove_device_t, em_cmd_remove_device_t_valid_remove)
     EXPECT_STREQ(cmd.m_param.u.args.fixed_args, "remove_device");
     EXPECT_EQ(cmd.m_param.u.args.num_args, 1);
     EXPECT_STREQ(cmd.m_param.u.args.args[0], "Arg0");
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_db_delete);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_db_delete);
     cmd.deinit();
     std::cout << "Exiting em_cmd_remove_device_t_valid_remove test" << std::endl;
 }
@@ -106,7 +106,7 @@ TEST(em_cmd_remove_device_t, em_cmd_remove_device_t_empty_params)
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_db_delete);
     EXPECT_EQ(cmd.m_orch_desc[1].op, dm_orch_type_em_delete);
     EXPECT_EQ(cmd.m_orch_desc[2].op, dm_orch_type_dm_delete);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_db_delete);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_db_delete);
     cmd.deinit();
     std::cout << "Exiting em_cmd_remove_device_t_empty_params test" << std::endl;
 }
@@ -162,7 +162,7 @@ TEST(em_cmd_remove_device_t, em_cmd_remove_device_t_max_params)
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_db_delete);
     EXPECT_EQ(cmd.m_orch_desc[1].op, dm_orch_type_em_delete);
     EXPECT_EQ(cmd.m_orch_desc[2].op, dm_orch_type_dm_delete);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_db_delete);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_db_delete);
     cmd.deinit();
     std::cout << "Exiting em_cmd_remove_device_t_max_params test" << std::endl;
 }
@@ -70,7 +70,7 @@ TEST(em_cmd_reset_t, em_cmd_reset_t_valid_construction) {
     EXPECT_STREQ(cmd.m_param.u.args.fixed_args, "ResetCommand");
     EXPECT_EQ(cmd.m_param.u.args.num_args, 1);
     EXPECT_STREQ(cmd.m_param.u.args.args[0], "Arg0");
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_em_reset);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_em_reset);
     cmd.deinit();
     std::cout << "Exiting em_cmd_reset_t_valid_construction test" << std::endl;
 }
@@ -121,7 +121,7 @@ TEST(em_cmd_reset_t, em_cmd_reset_t_empty_params)
     EXPECT_EQ(cmd.m_orch_desc[3].op, dm_orch_type_db_cfg);
     EXPECT_STREQ(cmd.m_name, "reset");
     EXPECT_EQ(cmd.m_svc, em_service_type_ctrl);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_em_reset);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_em_reset);
     cmd.deinit();
     std::cout << "Exiting em_cmd_reset_t_empty_params test" << std::endl;
 }
@@ -171,7 +171,7 @@ TEST(em_cmd_reset_t, em_cmd_reset_t_max_params)
     EXPECT_EQ(cmd.m_type, em_cmd_type_reset);
     EXPECT_STREQ(cmd.m_name, "reset");
     EXPECT_EQ(cmd.m_svc, em_service_type_ctrl);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_em_reset);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_em_reset);
     EXPECT_EQ(cmd.m_param.u.args.num_args, params.u.args.num_args);
     EXPECT_STREQ(cmd.m_param.u.args.fixed_args, params.u.args.fixed_args);
     for (unsigned int i = 0; i < params.u.args.num_args; i++) {
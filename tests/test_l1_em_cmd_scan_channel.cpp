@@ -63,7 +63,7 @@ TEST(em_cmd_scan_channel_t, em_cmd_scan_channel_t_valid_typical_parameters)
     EXPECT_EQ(cmd.m_num_orch_desc, 1);
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_channel_scan_req);
     EXPECT_TRUE(cmd.m_orch_desc[0].submit);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_channel_scan_req);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_channel_scan_req);
     cmd.deinit();
     std::cout << "Exiting em_cmd_scan_channel_t_valid_typical_parameters test" << std::endl;
 }
@@ -111,7 +111,7 @@ TEST(em_cmd_scan_channel_t, em_cmd_scan_channel_t_valid_boundary_parameters)
     EXPECT_EQ(cmd.m_num_orch_desc, 1);
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_channel_scan_req);
     EXPECT_TRUE(cmd.m_orch_desc[0].submit);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_channel_scan_req);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_channel_scan_req);
     cmd.deinit();
     std::cout << "Exiting em_cmd_scan_channel_t_valid_boundary_parameters test" << std::endl;
 }
@@ -163,7 +163,7 @@ TEST(em_cmd_scan_channel_t, em_cmd_scan_channel_t_ctor_max_fixed_args)
     EXPECT_EQ(cmd.m_num_orch_desc, 1);
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_channel_scan_req);
     EXPECT_TRUE(cmd.m_orch_desc[0].submit);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_channel_scan_req);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_channel_scan_req);
     cmd.deinit();
     std::cout << "Exiting em_cmd_scan_channel_t_ctor_max_fixed_args test" << std::endl;
 }
@@ -67,7 +67,7 @@ TEST(em_cmd_scan_result_t, em_cmd_scan_result_t_valid_initialization) {
     EXPECT_EQ(cmd.m_num_orch_desc, 1);
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_channel_scan_res);
     EXPECT_TRUE(cmd.m_orch_desc[0].submit);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_channel_scan_res);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_channel_scan_res);
     cmd.deinit();
     std::cout << "Exiting em_cmd_scan_result_t_valid_initialization test" << std::endl;
 }
@@ -114,7 +114,7 @@ TEST(em_cmd_scan_result_t, em_cmd_scan_result_t_empty_parameters) {
     EXPECT_EQ(cmd.m_num_orch_desc, 1);
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_channel_scan_res);
     EXPECT_TRUE(cmd.m_orch_desc[0].submit);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_channel_scan_res);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_channel_scan_res);
     cmd.deinit();
     std::cout << "Exiting em_cmd_scan_result_t_empty_parameters test" << std::endl;
 }
@@ -168,7 +168,7 @@ TEST(em_cmd_scan_result_t, em_cmd_scan_result_t_ctor_max_fixed_args)
     EXPECT_EQ(cmd.m_num_orch_desc, 1);
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_channel_scan_res);
     EXPECT_TRUE(cmd.m_orch_desc[0].submit);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_channel_scan_res);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_channel_scan_res);
     cmd.deinit();
     std::cout << "Exiting em_cmd_scan_channel_t_ctor_max_fixed_args test" << std::endl;
 }
@@ -70,7 +70,7 @@ TEST(em_cmd_set_policy_t, em_cmd_set_policy_t_valid_complete_parameters)
     EXPECT_EQ(cmd.m_num_orch_desc, 1);
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_policy_cfg);
     EXPECT_TRUE(cmd.m_orch_desc[0].submit);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_policy_cfg);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_policy_cfg);
     cmd.deinit();
     std::cout << "Exiting em_cmd_set_policy_t_valid_complete_parameters test" << std::endl;
 }
@@ -116,7 +116,7 @@ TEST(em_cmd_set_policy_t, em_cmd_set_policy_t_valid_minimal_parameters)
     EXPECT_EQ(cmd.m_num_orch_desc, 1);
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_policy_cfg);
     EXPECT_TRUE(cmd.m_orch_desc[0].submit);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_policy_cfg);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_policy_cfg);
     cmd.deinit();
     std::cout << "Exiting em_cmd_set_policy_t_valid_minimal_parameters test" << std::endl;
 }
@@ -165,7 +165,7 @@ TEST(em_cmd_set_policy_t, em_cmd_set_policy_t_ctor_max_fixed_args)
     EXPECT_EQ(cmd.m_num_orch_desc, 1);
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_policy_cfg);
     EXPECT_TRUE(cmd.m_orch_desc[0].submit);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_policy_cfg);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_policy_cfg);
     cmd.deinit();
     std::cout << "Exiting em_cmd_set_policy_t_ctor_max_fixed_args test" << std::endl;
 }
@@ -74,7 +74,7 @@ TEST(em_cmd_set_radio_t, em_cmd_set_radio_t_valid_set_radio_parameters) {
     EXPECT_EQ(cmd.m_num_orch_desc, 1);
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_em_update);
     EXPECT_TRUE(cmd.m_orch_desc[0].submit);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_em_update);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_em_update);
     cmd.deinit();
     std::cout << "Exiting em_cmd_set_radio_t_valid_set_radio_parameters test" << std::endl;
 }
@@ -119,7 +119,7 @@ TEST(em_cmd_set_radio_t, em_cmd_set_radio_t_minimal_empty_arguments) {
     EXPECT_EQ(cmd.m_num_orch_desc, 1);
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_em_update);
     EXPECT_TRUE(cmd.m_orch_desc[0].submit);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_em_update);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_em_update);
     cmd.deinit();
     std::cout << "Exiting em_cmd_set_radio_t_minimal_empty_arguments test" << std::endl;
 }
@@ -171,7 +171,7 @@ TEST(em_cmd_set_radio_t, em_cmd_set_radio_t_ctor_max_fixed_args)
     EXPECT_EQ(cmd.m_num_orch_desc, 1);
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_em_update);
     EXPECT_TRUE(cmd.m_orch_desc[0].submit);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_em_update);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_em_update);
     cmd.deinit();
     std::cout << "Exiting em_cmd_set_radio_t_ctor_max_fixed_args test" << std::endl;
 }
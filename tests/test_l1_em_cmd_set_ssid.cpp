@@ -64,7 +64,7 @@ TEST(em_cmd_set_ssid_t, em_cmd_set_ssid_t_ConstructValidNonEmptyFixedArgs)
     EXPECT_EQ(cmd.m_orch_desc[2].op, dm_orch_type_net_ssid_update);
     EXPECT_STREQ(cmd.m_name, "set_ssid");
     EXPECT_EQ(cmd.m_svc, em_service_type_ctrl);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_db_cfg);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_db_cfg);
     cmd.deinit();
     std::cout << "Exiting em_cmd_set_ssid_t_ConstructValidNonEmptyFixedArgs test" << std::endl;
 }
@@ -109,7 +109,7 @@ TEST(em_cmd_set_ssid_t, em_cmd_set_ssid_t_ConstructWithEmptyFixedArgs)
     EXPECT_EQ(cmd.m_orch_desc[2].op, dm_orch_type_net_ssid_update);
     EXPECT_STREQ(cmd.m_name, "set_ssid");
     EXPECT_EQ(cmd.m_svc, em_service_type_ctrl);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_db_cfg);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_db_cfg);
     cmd.deinit();
     std::cout << "Exiting em_cmd_set_ssid_t_ConstructWithEmptyFixedArgs test" << std::endl;
 }
@@ -159,7 +159,7 @@ TEST(em_cmd_set_ssid_t, em_cmd_set_ssid_t_ConstructWithMaxSSIDLength)
     EXPECT_EQ(cmd.m_orch_desc[2].op, dm_orch_type_net_ssid_update);
     EXPECT_STREQ(cmd.m_name, "set_ssid");
     EXPECT_EQ(cmd.m_svc, em_service_type_ctrl);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_db_cfg);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_db_cfg);
     cmd.deinit();
     std::cout << "Exiting em_cmd_set_ssid_t_ConstructWithMaxSSIDLength test" << std::endl;
 }
@@ -206,7 +206,7 @@ TEST(em_cmd_set_ssid_t, em_cmd_set_ssid_t_ConstructWithInitializedDM)
     EXPECT_EQ(cmd.m_orch_desc[2].op, dm_orch_type_net_ssid_update);
     EXPECT_STREQ(cmd.m_name, "set_ssid");
     EXPECT_EQ(cmd.m_svc, em_service_type_ctrl);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_db_cfg);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_db_cfg);
     cmd.deinit();
     std::cout << "Exiting em_cmd_set_ssid_t_ConstructWithInitializedDM test" << std::endl;
 }
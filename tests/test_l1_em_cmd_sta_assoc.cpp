@@ -62,7 +62,7 @@ TEST(em_cmd_sta_assoc_t, em_cmd_sta_assoc_t_valid_parameters) {
     EXPECT_EQ(assoc.m_num_orch_desc, 1);
     EXPECT_EQ(assoc.m_orch_desc[0].op, dm_orch_type_sta_cap);
     EXPECT_TRUE(assoc.m_orch_desc[0].submit);
-    EXPECT_EQ(assoc.m_data_model.m_cmd_ctx.type, dm_orch_type_sta_cap);
+    EXPECT_EQ(assoc.m_ctx.type, dm_orch_type_sta_cap);
     assoc.deinit();
     std::cout << "Exiting em_cmd_sta_assoc_t_valid_parameters test" << std::endl;
 }
@@ -106,7 +106,7 @@ TEST(em_cmd_sta_assoc_t, em_cmd_sta_assoc_t_valid_minimal_parameters) {
     EXPECT_EQ(assoc.m_num_orch_desc, 1);
     EXPECT_EQ(assoc.m_orch_desc[0].op, dm_orch_type_sta_cap);
     EXPECT_TRUE(assoc.m_orch_desc[0].submit);
-    EXPECT_EQ(assoc.m_data_model.m_cmd_ctx.type, dm_orch_type_sta_cap);
+    EXPECT_EQ(assoc.m_ctx.type, dm_orch_type_sta_cap);
     assoc.deinit();
     std::cout << "Exiting em_cmd_sta_assoc_t_valid_minimal_parameters test" << std::endl;
 }
@@ -158,7 +158,7 @@ TEST(em_cmd_sta_assoc_t, em_cmd_sta_assoc_t_ctor_max_fixed_args) {
     EXPECT_EQ(assoc.m_num_orch_desc, 1);
     EXPECT_EQ(assoc.m_orch_desc[0].op, dm_orch_type_sta_cap);
     EXPECT_TRUE(assoc.m_orch_desc[0].submit);
-    EXPECT_EQ(assoc.m_data_model.m_cmd_ctx.type, dm_orch_type_sta_cap);
+    EXPECT_EQ(assoc.m_ctx.type, dm_orch_type_sta_cap);
     assoc.deinit();
     std::cout << "Exiting em_cmd_sta_assoc_t_ctor_max_fixed_args test" << std::endl;
 }
@@ -67,7 +67,7 @@ TEST(em_cmd_sta_list_t, em_cmd_sta_list_t_valid_parameters) {
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_ctrl_notify);
     EXPECT_EQ(cmd.m_orch_desc[1].op, dm_orch_type_sta_aggregate);
     EXPECT_TRUE(cmd.m_orch_desc[0].submit);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_ctrl_notify);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_ctrl_notify);
     cmd.deinit();
     std::cout << "Exiting em_cmd_sta_list_t_valid_parameters test" << std::endl;
 }
@@ -113,7 +113,7 @@ TEST(em_cmd_sta_list_t, em_cmd_sta_list_t_valid_minimal_parameters)
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_ctrl_notify);
     EXPECT_EQ(cmd.m_orch_desc[1].op, dm_orch_type_sta_aggregate);
     EXPECT_TRUE(cmd.m_orch_desc[0].submit);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_ctrl_notify);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_ctrl_notify);
     cmd.deinit();
     std::cout << "Exiting em_cmd_sta_list_t_valid_minimal_parameters test" << std::endl;
 }
@@ -165,7 +165,7 @@ TEST(em_cmd_set_policy_t, em_cmd_sta_list_t_ctor_max_fixed_args)
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_ctrl_notify);
     EXPECT_EQ(cmd.m_orch_desc[1].op, dm_orch_type_sta_aggregate);
     EXPECT_TRUE(cmd.m_orch_desc[0].submit);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_ctrl_notify);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_ctrl_notify);
     cmd.deinit();
     std::cout << "Exiting em_cmd_sta_list_t_ctor_max_fixed_args test" << std::endl;
 }
@@ -211,7 +211,7 @@ TEST(em_cmd_get_network_t, em_cmd_sta_list_t_NullNetworkNode)
     EXPECT_EQ(cmd.m_orch_desc[0].op, dm_orch_type_ctrl_notify);
     EXPECT_EQ(cmd.m_orch_desc[1].op, dm_orch_type_sta_aggregate);
     EXPECT_TRUE(cmd.m_orch_desc[0].submit);
-    EXPECT_EQ(cmd.m_data_model.m_cmd_ctx.type, dm_orch_type_ctrl_notify);
+    EXPECT_EQ(cmd.m_ctx.type, dm_orch_type_ctrl_notify);
     cmd.deinit();
     std::cout << "Exiting em_cmd_sta_list_t_NullNetworkNode test" << std::endl;
 }
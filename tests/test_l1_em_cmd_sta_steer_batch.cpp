@@ -0,0 +1,93 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <cstring>
+#include "em_cmd_sta_steer_batch.h"
+#include "test_l1_utils.h"
+
+/**
+ * @brief Tests the creation of an em_cmd_sta_steer_batch_t instance with three STAs.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 001@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None
+ * **Dependencies:** None
+ * **User Interaction:** None
+ *
+ * **Test Procedure:**
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Construct with three STAs of the same source BSS | num = 3 | Batch type, sta_steer orch op, the three entries copied | Should Pass |
+ */
+TEST(em_cmd_sta_steer_batch_t, em_cmd_sta_steer_batch_t_three_stas) {
+    std::cout << "Entering em_cmd_sta_steer_batch_t_three_stas test" << std::endl;
+    em_cmd_steer_batch_params_t params{};
+    unsigned int i;
+
+    make_mac(1000, params.source);
+    params.request_mode = 1;
+    params.disassoc_imminent = true;
+    params.btm_disassociation_timer = 100;
+    params.num = 3;
+    for (i = 0; i < params.num; i++) {
+        make_mac(i + 1, params.entries[i].sta_mac);
+        make_mac(2000 + i, params.entries[i].target);
+        params.entries[i].target_op_class = 115;
+        params.entries[i].target_channel = 36;
+    }
+
+    em_cmd_sta_steer_batch_t obj(params);
+    EXPECT_EQ(obj.m_type, em_cmd_type_sta_steer_batch);
+    EXPECT_STREQ(obj.m_name, "steer_sta_batch");
+    EXPECT_EQ(obj.m_num_orch_desc, 1u);
+    EXPECT_EQ(obj.m_orch_desc[0].op, dm_orch_type_sta_steer);
+    EXPECT_EQ(obj.m_orch_desc[0].submit, true);
+    EXPECT_EQ(obj.m_param.u.steer_batch_params.num, 3u);
+    EXPECT_EQ(memcmp(obj.m_param.u.steer_batch_params.entries, params.entries, 3 * sizeof(em_steer_batch_entry_t)), 0);
+    std::cout << "Exiting em_cmd_sta_steer_batch_t_three_stas test" << std::endl;
+}
+
+/**
+ * @brief Tests that the number of STAs is clamped to EM_MAX_STEER_BATCH.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 002@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None
+ * **Dependencies:** None
+ * **User Interaction:** None
+ *
+ * **Test Procedure:**
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Construct with more STAs than a batch holds | num = EM_MAX_STEER_BATCH + 5 | num is EM_MAX_STEER_BATCH | Should Pass |
+ */
+TEST(em_cmd_sta_steer_batch_t, em_cmd_sta_steer_batch_t_clamps_num) {
+    std::cout << "Entering em_cmd_sta_steer_batch_t_clamps_num test" << std::endl;
+    em_cmd_steer_batch_params_t params{};
+
+    params.num = EM_MAX_STEER_BATCH + 5;
+    em_cmd_sta_steer_batch_t obj(params);
+    EXPECT_EQ(obj.m_param.u.steer_batch_params.num, static_cast<unsigned int>(EM_MAX_STEER_BATCH));
+    std::cout << "Exiting em_cmd_sta_steer_batch_t_clamps_num test" << std::endl;
+}
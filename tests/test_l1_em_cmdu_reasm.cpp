@@ -0,0 +1,263 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include "em_cmdu_reasm.h"
+#include "em_tlv_writer.h"
+#include "em_msg.h"
+
+static mac_address_t dst = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55};
+static mac_address_t src = {0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb};
+
+class em_cmdu_reasm_t_Test : public ::testing::Test {
+protected:
+    em_frame_ring_t ring;
+    em_cmdu_reasm_t reasm;
+    em_tlv_writer_t writer;
+
+    void SetUp() override {
+        ASSERT_EQ(ring.init(8), 0);
+        reasm.init(&ring);
+        writer.set_frame_size(200);
+    }
+
+    void TearDown() override {
+        reasm.flush();
+        EXPECT_EQ(ring.get_in_use(), 0u);
+        ring.deinit();
+    }
+
+    // builds a message of num AP Metrics TLVs of 50 bytes, value = TLV number
+    int build(unsigned short msg_id, unsigned int num) {
+        unsigned char value[50];
+        unsigned int i;
+
+        writer.begin(dst, src, em_msg_type_ap_metrics_rsp, msg_id);
+        for (i = 0; i < num; i++) {
+            memset(value, static_cast<int>(i), sizeof(value));
+            writer.add_tlv(em_tlv_type_ap_metrics, value, sizeof(value));
+        }
+        return writer.finish();
+    }
+
+    em_rx_buff_t *feed(unsigned int idx, unsigned int *len, uint64_t now_us) {
+        unsigned char *frame = writer.get_frame(idx, len);
+        em_rx_buff_t *buff = ring.get(*len);
+
+        memcpy(buff->data, frame, *len);
+        return reasm.add(buff, len, now_us);
+    }
+
+    void check_message(em_rx_buff_t *buff, unsigned int len, unsigned int num) {
+        unsigned int hdr_len = sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t), i;
+        em_cmdu_t *cmdu = reinterpret_cast<em_cmdu_t *>(buff->data + sizeof(em_raw_hdr_t));
+
+        EXPECT_EQ(cmdu->frag_id, 0);
+        EXPECT_EQ(cmdu->last_frag_ind, 1);
+        EXPECT_EQ(ntohs(cmdu->type), em_msg_type_ap_metrics_rsp);
+        EXPECT_EQ(len, hdr_len + num * (sizeof(em_tlv_t) + 50) + sizeof(em_tlv_t));
+
+        em_msg_t msg(buff->data + hdr_len, len - hdr_len);
+        EXPECT_EQ(msg.get_tlv_count(em_tlv_type_ap_metrics), num);
+        for (i = 0; i < num; i++) {
+            em_tlv_t *tlv = msg.get_tlv(em_tlv_type_ap_metrics, i);
+            ASSERT_NE(tlv, nullptr);
+            EXPECT_EQ(tlv->value[0], i);
+            EXPECT_EQ(tlv->value[49], i);
+        }
+        EXPECT_FALSE(msg.is_malformed());
+    }
+};
+
+/**
+* @brief Test that unfragmented frames are passed through and fragments are joined in order
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Add a single frame message | 1 TLV | The same buffer is returned | Should Pass |
+* | 02| Add the fragments of a message in order | 10 TLVs in 200 byte frames | NULL until the last one, then one message with all TLVs and a single end of message TLV | Should Pass |
+*/
+TEST_F(em_cmdu_reasm_t_Test, InOrder) {
+    std::cout << "Entering InOrder test" << std::endl;
+    em_rx_buff_t *buff, *out;
+    unsigned char *frame;
+    unsigned int len, i;
+    int num;
+
+    ASSERT_EQ(build(1, 1), 1);
+    frame = writer.get_frame(0, &len);
+    buff = ring.get(len);
+    memcpy(buff->data, frame, len);
+    EXPECT_EQ(reasm.add(buff, &len, 0), buff);
+    em_frame_ring_t::put(buff);
+
+    num = build(2, 10);
+    ASSERT_GT(num, 2);
+    for (i = 0; i < static_cast<unsigned int>(num - 1); i++) {
+        EXPECT_EQ(feed(i, &len, 100 * i), nullptr);
+        EXPECT_EQ(reasm.get_pending(), 1u);
+    }
+    ASSERT_NE(out = feed(static_cast<unsigned int>(num - 1), &len, 1000), nullptr);
+    check_message(out, len, 10);
+    em_frame_ring_t::put(out);
+
+    EXPECT_EQ(reasm.get_pending(), 0u);
+    EXPECT_EQ(reasm.get_pending_bytes(), 0u);
+    EXPECT_EQ(reasm.get_stats()->completed, 1u);
+    EXPECT_EQ(reasm.get_latency()->get_count(), 1u);
+    EXPECT_EQ(reasm.get_latency()->get_max_us(), 1000u);
+    std::cout << "Exiting InOrder test" << std::endl;
+}
+
+/**
+* @brief Test that fragments out of order are joined by fragment id and duplicates are dropped
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Add the last fragment, then the others from the first one with fragment 0 twice | 10 TLVs in 200 byte frames | The duplicate is dropped, the message completes with its TLVs in order | Should Pass |
+*/
+TEST_F(em_cmdu_reasm_t_Test, OutOfOrder) {
+    std::cout << "Entering OutOfOrder test" << std::endl;
+    em_rx_buff_t *out = NULL;
+    unsigned int len, i;
+    int num;
+
+    num = build(3, 10);
+    ASSERT_GT(num, 2);
+    EXPECT_EQ(feed(static_cast<unsigned int>(num - 1), &len, 0), nullptr);
+    EXPECT_EQ(feed(0, &len, 0), nullptr);
+    EXPECT_EQ(feed(0, &len, 0), nullptr);
+    EXPECT_EQ(reasm.get_stats()->dropped_frags, 1u);
+    for (i = 1; i < static_cast<unsigned int>(num - 1); i++) {
+        out = feed(i, &len, 0);
+    }
+    ASSERT_NE(out, nullptr);
+    check_message(out, len, 10);
+    em_frame_ring_t::put(out);
+    std::cout << "Exiting OutOfOrder test" << std::endl;
+}
+
+/**
+* @brief Test that a message whose fragments come in reverse order gets the headers of fragment 0
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Add the fragments from the last one to fragment 0, which alone has the relay indicator set | 10 TLVs in 200 byte frames | The message completes with fragment id 0, the relay indicator of fragment 0 and its TLVs in order | Should Pass |
+*/
+TEST_F(em_cmdu_reasm_t_Test, ReverseOrder) {
+    std::cout << "Entering ReverseOrder test" << std::endl;
+    em_rx_buff_t *out = NULL;
+    em_cmdu_t *cmdu;
+    unsigned int len;
+    int num, i;
+
+    num = build(4, 10);
+    ASSERT_GT(num, 2);
+    cmdu = reinterpret_cast<em_cmdu_t *>(writer.get_frame(0, &len) + sizeof(em_raw_hdr_t));
+    cmdu->relay_ind = 1;
+    for (i = num - 1; i >= 0; i--) {
+        out = feed(static_cast<unsigned int>(i), &len, 0);
+        if (i != 0) {
+            EXPECT_EQ(out, nullptr);
+        }
+    }
+    ASSERT_NE(out, nullptr);
+    check_message(out, len, 10);
+    cmdu = reinterpret_cast<em_cmdu_t *>(out->data + sizeof(em_raw_hdr_t));
+    EXPECT_EQ(cmdu->relay_ind, 1);
+    EXPECT_EQ(ntohs(cmdu->id), 4);
+    em_frame_ring_t::put(out);
+    std::cout << "Exiting ReverseOrder test" << std::endl;
+}
+
+/**
+* @brief Test the timeout and the per source quota of pending messages
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Add the first fragment of a message and let the timeout pass | timeout 1000us | The message is dropped and counted as a timeout | Should Pass |
+* | 02| Start two messages from one source with a quota for one fragment | quota 200 bytes | The older message is evicted | Should Pass |
+* | 03| Start a message larger than the quota | 10 TLVs, quota 200 bytes | The fragment that does not fit drops the message | Should Pass |
+*/
+TEST_F(em_cmdu_reasm_t_Test, Limits) {
+    std::cout << "Entering Limits test" << std::endl;
+    unsigned int len;
+
+    reasm.set_limits(200, 1000, 1000);
+
+    ASSERT_GT(build(4, 10), 2);
+    EXPECT_EQ(feed(0, &len, 0), nullptr);
+    EXPECT_EQ(reasm.get_pending(), 1u);
+    EXPECT_EQ(reasm.expire(1001), 1u);
+    EXPECT_EQ(reasm.get_pending(), 0u);
+    EXPECT_EQ(reasm.get_stats()->timeouts, 1u);
+
+    ASSERT_GT(build(5, 10), 2);
+    EXPECT_EQ(feed(0, &len, 0), nullptr);
+    ASSERT_GT(build(6, 10), 2);
+    EXPECT_EQ(feed(0, &len, 10), nullptr);
+    EXPECT_EQ(reasm.get_pending(), 1u);
+    EXPECT_EQ(reasm.get_stats()->quota_evictions, 1u);
+    EXPECT_LE(reasm.get_pending_bytes(), 200u);
+
+    EXPECT_EQ(feed(1, &len, 20), nullptr);
+    EXPECT_EQ(reasm.get_pending(), 0u);
+    EXPECT_EQ(reasm.get_pending_bytes(), 0u);
+    EXPECT_EQ(reasm.get_stats()->dropped_frags, 1u);
+    std::cout << "Exiting Limits test" << std::endl;
+}
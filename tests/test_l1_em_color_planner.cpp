@@ -0,0 +1,304 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include <memory>
+#include "em_color_planner.h"
+#include "test_l1_utils.h"
+
+// neighbor BSS color in use bitmap of a Spatial Reuse Report with one color, none if 0
+static void make_heard(unsigned char color, unsigned char *heard)
+{
+    memset(heard, 0, 8);
+    if (color != 0) {
+        heard[color / 8] = static_cast<unsigned char>(1 << (color % 8));
+    }
+}
+
+// a scan of a radio on a channel that hears one BSS
+static std::unique_ptr<em_scan_result_t> make_scan(const unsigned char *ruid, unsigned char channel, const unsigned char *bssid,
+    signed char signal, unsigned char color)
+{
+    std::unique_ptr<em_scan_result_t> res(new em_scan_result_t);
+
+    memset(res.get(), 0, sizeof(em_scan_result_t));
+    memcpy(res->id.scanner_mac, ruid, sizeof(mac_address_t));
+    res->id.op_class = 115;
+    res->id.channel = channel;
+    res->num_neighbors = 1;
+    memcpy(res->neighbor[0].bssid, bssid, sizeof(mac_address_t));
+    res->neighbor[0].signal_strength = signal;
+    res->neighbor[0].bss_color = color;
+
+    return res;
+}
+
+/**
+* @brief Test the signal weight and the partial BSSID bit
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Signal weight | -120, -99, -50, -20, 0 dBm | 1, 1, 50, 80, 80 | Should Pass |
+* | 02| Partial BSSID bit | octet 4 0x80, octet 5 0x1f and 0xe0 | 1, 62, 0 | Should Pass |
+* | 03| Scan of an unknown radio | add_scan_result() | -1 | Should Pass |
+*/
+TEST(em_color_planner_t_Test, Basics) {
+    std::cout << "Entering Basics test" << std::endl;
+    em_color_planner_t planner;
+    unsigned char bssid[6] = {0x02, 0, 0, 0, 0x80, 0x00};
+    mac_address_t ruid;
+
+    EXPECT_EQ(em_color_planner_t::get_signal_weight(-120), 1u);
+    EXPECT_EQ(em_color_planner_t::get_signal_weight(-99), 1u);
+    EXPECT_EQ(em_color_planner_t::get_signal_weight(-50), 50u);
+    EXPECT_EQ(em_color_planner_t::get_signal_weight(-20), 80u);
+    EXPECT_EQ(em_color_planner_t::get_signal_weight(0), 80u);
+
+    EXPECT_EQ(em_color_planner_t::get_partial_bssid_bit(bssid), 1u);
+    bssid[4] = 0x00;
+    bssid[5] = 0x1f;
+    EXPECT_EQ(em_color_planner_t::get_partial_bssid_bit(bssid), 62u);
+    bssid[5] = 0xe0;
+    EXPECT_EQ(em_color_planner_t::get_partial_bssid_bit(bssid), 0u);
+
+    make_mac(1, ruid);
+    EXPECT_EQ(planner.add_scan_result(make_scan(ruid, 36, bssid, -50, 0).get()), -1);
+    std::cout << "Exiting Basics test" << std::endl;
+}
+
+/**
+* @brief Test that the radios of a channel that hear each other get distinct colors
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Three radios on 36 with color 5 that scan each other, one on 149 with color 5 | Reports and scans | 3 collisions before the plan | Should Pass |
+* | 02| Full plan | plan(true) | No collision, one radio of 36 and the radio of 149 keep color 5 | Should Pass |
+* | 03| Plan again | plan(true) | No color changes | Should Pass |
+*/
+TEST(em_color_planner_t_Test, Collisions) {
+    std::cout << "Entering Collisions test" << std::endl;
+    em_color_planner_t planner;
+    mac_address_t ruid[4], bssid[4];
+    unsigned char heard[8];
+    em_color_plan_t plan[4];
+    unsigned int i, j, kept = 0;
+
+    make_heard(0, heard);
+    for (i = 0; i < 4; i++) {
+        make_mac(i + 1, ruid[i]);
+        make_mac(0x100 + i, bssid[i]);
+        EXPECT_TRUE(planner.set_report(ruid[i], (i < 3) ? 115:125, (i < 3) ? 36:149, 5, heard));
+        planner.add_bss(bssid[i], ruid[i]);
+    }
+    for (i = 0; i < 3; i++) {
+        for (j = 0; j < 3; j++) {
+            if (i != j) {
+                EXPECT_EQ(planner.add_scan_result(make_scan(ruid[i], 36, bssid[j], -60, 5).get()), 1);
+            }
+        }
+    }
+    // the radio of 149 hears one of 36, they do not collide
+    EXPECT_EQ(planner.add_scan_result(make_scan(ruid[3], 149, bssid[0], -40, 5).get()), 1);
+    EXPECT_EQ(planner.get_collisions(), 3u);
+
+    EXPECT_EQ(planner.plan(true), 4u);
+    EXPECT_EQ(planner.get_collisions(), 0u);
+    for (i = 0; i < 4; i++) {
+        ASSERT_TRUE(planner.get_plan(ruid[i], &plan[i]));
+        EXPECT_GE(plan[i].color, 1);
+        EXPECT_LE(plan[i].color, EM_COLOR_PLANNER_MAX_COLOR);
+    }
+    for (i = 0; i < 3; i++) {
+        kept += (plan[i].color == 5) ? 1:0;
+    }
+    EXPECT_EQ(kept, 1u);
+    EXPECT_EQ(plan[3].color, 5);
+    EXPECT_NE(plan[0].color, plan[1].color);
+    EXPECT_NE(plan[0].color, plan[2].color);
+    EXPECT_NE(plan[1].color, plan[2].color);
+
+    EXPECT_EQ(planner.plan(true), 0u);
+    EXPECT_EQ(planner.get_collisions(), 0u);
+    std::cout << "Exiting Collisions test" << std::endl;
+}
+
+/**
+* @brief Test the colors heard from outside the mesh and the peers of peers
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Radio with color 7 reporting color 7 in use, no peers | Report | It leaves color 7 | Should Pass |
+* | 02| Radio with color 9 reporting color 7 in use | Report | It keeps color 9 | Should Pass |
+* | 03| Scan of the radio hearing a foreign BSS with its color | Scan on its channel | It leaves the color | Should Pass |
+* | 04| Chain A-B-C on 36, A and C with color 3 | Reports and scans | A and C get distinct colors | Should Pass |
+*/
+TEST(em_color_planner_t_Test, Foreign) {
+    std::cout << "Entering Foreign test" << std::endl;
+    em_color_planner_t planner;
+    mac_address_t ruid[6], bssid[6], foreign;
+    unsigned char heard[8];
+    em_color_plan_t plan;
+    unsigned int i;
+
+    for (i = 0; i < 6; i++) {
+        make_mac(i + 1, ruid[i]);
+        make_mac(0x100 + i, bssid[i]);
+    }
+    make_mac(0x999, foreign);
+
+    make_heard(7, heard);
+    planner.set_report(ruid[0], 115, 40, 7, heard);
+    planner.set_report(ruid[1], 115, 44, 9, heard);
+    make_heard(0, heard);
+    planner.set_report(ruid[2], 115, 48, 11, heard);
+    planner.plan(false);
+    ASSERT_TRUE(planner.get_plan(ruid[0], &plan));
+    EXPECT_NE(plan.color, 7);
+    ASSERT_TRUE(planner.get_plan(ruid[1], &plan));
+    EXPECT_EQ(plan.color, 9);
+    ASSERT_TRUE(planner.get_plan(ruid[2], &plan));
+    EXPECT_EQ(plan.color, 11);
+
+    // a scan of another channel does not count, one of its channel does
+    EXPECT_EQ(planner.add_scan_result(make_scan(ruid[2], 52, foreign, -70, 11).get()), 0);
+    EXPECT_EQ(planner.plan(false), 0u);
+    EXPECT_EQ(planner.add_scan_result(make_scan(ruid[2], 48, foreign, -70, 11).get()), 0);
+    EXPECT_EQ(planner.plan(false), 1u);
+    ASSERT_TRUE(planner.get_plan(ruid[2], &plan));
+    EXPECT_NE(plan.color, 11);
+
+    planner.set_report(ruid[3], 115, 36, 3, heard);
+    planner.set_report(ruid[4], 115, 36, 10, heard);
+    planner.set_report(ruid[5], 115, 36, 3, heard);
+    for (i = 3; i < 6; i++) {
+        planner.add_bss(bssid[i], ruid[i]);
+    }
+    planner.add_scan_result(make_scan(ruid[3], 36, bssid[4], -50, 10).get());
+    planner.add_scan_result(make_scan(ruid[5], 36, bssid[4], -50, 10).get());
+    planner.plan(false);
+    em_color_plan_t a, c;
+    ASSERT_TRUE(planner.get_plan(ruid[3], &a));
+    ASSERT_TRUE(planner.get_plan(ruid[5], &c));
+    EXPECT_NE(a.color, c.color);
+    ASSERT_TRUE(planner.get_plan(ruid[4], &plan));
+    EXPECT_EQ(plan.color, 10);
+    std::cout << "Exiting Foreign test" << std::endl;
+}
+
+/**
+* @brief Test the incremental plans and the spatial reuse groups
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Two radios on 36 that hear each other, then plan | Reports, scan | Both evaluated, no collision | Should Pass |
+* | 02| Same reports again, plan | set_report() | false, nothing evaluated | Should Pass |
+* | 03| Report of a radio on 149 | set_report() | Only it is evaluated | Should Pass |
+* | 04| Plan of a radio | get_plan() | SRG of the other radio, its color and BSSID bit | Should Pass |
+* | 05| Radio never reported | get_plan() | false | Should Pass |
+*/
+TEST(em_color_planner_t_Test, Incremental) {
+    std::cout << "Entering Incremental test" << std::endl;
+    em_color_planner_t planner;
+    mac_address_t ruid[4], bssid[3];
+    unsigned char heard[8];
+    em_color_plan_t a, b;
+    unsigned int bit;
+
+    for (unsigned int i = 0; i < 4; i++) {
+        make_mac(i + 1, ruid[i]);
+    }
+    for (unsigned int i = 0; i < 3; i++) {
+        make_mac(0x100 + i, bssid[i]);
+    }
+    bssid[1][4] = 0x80;
+
+    make_heard(0, heard);
+    planner.set_report(ruid[0], 115, 36, 1, heard);
+    planner.set_report(ruid[1], 115, 36, 1, heard);
+    planner.add_bss(bssid[0], ruid[0]);
+    planner.add_bss(bssid[1], ruid[1]);
+    EXPECT_EQ(planner.add_scan_result(make_scan(ruid[0], 36, bssid[1], -50, 1).get()), 1);
+    EXPECT_EQ(planner.plan(false), 2u);
+    EXPECT_EQ(planner.get_stats().last_evaluated, 2u);
+    EXPECT_EQ(planner.get_collisions(), 0u);
+
+    EXPECT_FALSE(planner.set_report(ruid[0], 115, 36, 1, heard));
+    EXPECT_EQ(planner.plan(false), 0u);
+    EXPECT_EQ(planner.get_stats().last_evaluated, 0u);
+
+    EXPECT_TRUE(planner.set_report(ruid[2], 125, 149, 1, heard));
+    EXPECT_EQ(planner.plan(false), 1u);
+    EXPECT_EQ(planner.get_stats().last_evaluated, 1u);
+    EXPECT_EQ(planner.get_stats().reports, 3u);
+
+    ASSERT_TRUE(planner.get_plan(ruid[0], &a));
+    ASSERT_TRUE(planner.get_plan(ruid[1], &b));
+    EXPECT_TRUE(a.srg_valid);
+    EXPECT_NE(a.srg_color_bitmap[b.color / 8] & (1 << (b.color % 8)), 0);
+    bit = em_color_planner_t::get_partial_bssid_bit(bssid[1]);
+    EXPECT_NE(a.srg_bssid_bitmap[bit / 8] & (1 << (bit % 8)), 0);
+    EXPECT_EQ(a.srg_color_bitmap[a.color / 8] & (1 << (a.color % 8)), 0);
+
+    // the BSS moved to another radio, it leaves the group
+    planner.add_bss(bssid[1], ruid[2]);
+    ASSERT_TRUE(planner.get_plan(ruid[0], &a));
+    EXPECT_EQ(a.srg_bssid_bitmap[bit / 8] & (1 << (bit % 8)), 0);
+
+    EXPECT_FALSE(planner.get_plan(ruid[3], &a));
+    EXPECT_EQ(a.color, 0);
+    std::cout << "Exiting Incremental test" << std::endl;
+}
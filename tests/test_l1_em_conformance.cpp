@@ -0,0 +1,245 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include "em_conformance.h"
+
+static const unsigned char s_al[] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+static const unsigned char s_ctrl[] = {0x02, 0x00, 0x00, 0x00, 0x00, 0xc0};
+
+static const char *s_script =
+    "# a comment\n"
+    "scenario onboarding\n"
+    "iterations 10\n"
+    "send autoconf_search multicast\n"
+    "tlv 0x01 $al\n"
+    "tlv 0x0d 00   # registrar\n"
+    "tlv 0x80 01 00\n"
+    "expect autoconf_resp 500\n"
+    "\n"
+    "scenario topology\n"
+    "profile 2\n"
+    "send topo_query\n"
+    "expect topo_resp 200 anyid\n"
+    "send 0x0001 ctrl\n"
+    "tlv 0x01 $al\n";
+
+/**
+* @brief Test that a script is parsed into its scenarios and steps
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Parse two scenarios | Script with names, numbers and comments | Steps, TLVs and options as written | Should Pass |
+*/
+TEST(em_conformance_t_Test, Parse) {
+    std::cout << "Entering Parse test" << std::endl;
+    em_conformance_t conf;
+    std::string err;
+
+    ASSERT_EQ(conf.parse(s_script, err), 0) << err;
+    auto& scenarios = conf.get_scenarios();
+    ASSERT_EQ(scenarios.size(), 2u);
+
+    EXPECT_EQ(scenarios[0].name, "onboarding");
+    EXPECT_EQ(scenarios[0].iterations, 10u);
+    EXPECT_EQ(scenarios[0].profile, em_profile_type_3);
+    ASSERT_EQ(scenarios[0].steps.size(), 1u);
+    EXPECT_EQ(scenarios[0].steps[0].type, em_msg_type_autoconf_search);
+    EXPECT_EQ(scenarios[0].steps[0].dst, em_conformance_dst_multicast);
+    ASSERT_EQ(scenarios[0].steps[0].tlvs.size(), 3u);
+    EXPECT_EQ(scenarios[0].steps[0].tlvs[2].tokens.size(), 2u);
+    EXPECT_TRUE(scenarios[0].steps[0].expect);
+    EXPECT_EQ(scenarios[0].steps[0].expect_type, em_msg_type_autoconf_resp);
+    EXPECT_EQ(scenarios[0].steps[0].timeout_ms, 500u);
+    EXPECT_TRUE(scenarios[0].steps[0].match_id);
+
+    EXPECT_EQ(scenarios[1].profile, em_profile_type_2);
+    ASSERT_EQ(scenarios[1].steps.size(), 2u);
+    EXPECT_EQ(scenarios[1].steps[0].dst, em_conformance_dst_ctrl);
+    EXPECT_FALSE(scenarios[1].steps[0].match_id);
+    EXPECT_EQ(scenarios[1].steps[1].type, em_msg_type_topo_notif);
+    EXPECT_FALSE(scenarios[1].steps[1].expect);
+    std::cout << "Exiting Parse test" << std::endl;
+}
+
+/**
+* @brief Test that script errors are reported with their line
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Step before any scenario | send topo_query | Fails on line 1 | Should Pass |
+* | 02| Unknown message | send no_such_msg | Fails on line 2 | Should Pass |
+* | 03| Odd number of hex digits | tlv 0x01 abc | Fails | Should Pass |
+* | 04| tlv before a send | tlv 0x01 00 | Fails | Should Pass |
+*/
+TEST(em_conformance_t_Test, ParseErrors) {
+    std::cout << "Entering ParseErrors test" << std::endl;
+    std::string err;
+
+    {
+        em_conformance_t conf;
+        EXPECT_EQ(conf.parse("send topo_query\n", err), -1);
+        EXPECT_EQ(err.find("line 1:"), 0u);
+    }
+    {
+        em_conformance_t conf;
+        EXPECT_EQ(conf.parse("scenario a\nsend no_such_msg\n", err), -1);
+        EXPECT_EQ(err.find("line 2:"), 0u);
+    }
+    {
+        em_conformance_t conf;
+        EXPECT_EQ(conf.parse("scenario a\nsend topo_notif\ntlv 0x01 abc\n", err), -1);
+    }
+    {
+        em_conformance_t conf;
+        EXPECT_EQ(conf.parse("scenario a\ntlv 0x01 00\n", err), -1);
+    }
+    std::cout << "Exiting ParseErrors test" << std::endl;
+}
+
+/**
+* @brief Test that a step is built into a CMDU with its variables resolved
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Build the multicast search | msg id 7 | Multicast dst, AL src, $al in the first TLV, end of message last | Should Pass |
+* | 02| Build a step to the unknown controller | topo_query | Fails | Should Pass |
+* | 03| Build it once the controller is known | topo_query | Sent to the controller | Should Pass |
+*/
+TEST(em_conformance_t_Test, Build) {
+    std::cout << "Entering Build test" << std::endl;
+    em_conformance_t conf;
+    em_tlv_writer_t writer;
+    const unsigned char multi_addr[] = {0x01, 0x80, 0xc2, 0x00, 0x00, 0x13};
+    std::string err;
+    unsigned char *frame;
+    unsigned int len;
+    em_raw_hdr_t *hdr;
+    em_cmdu_t *cmdu;
+    em_tlv_t *tlv;
+
+    ASSERT_EQ(conf.parse(s_script, err), 0) << err;
+    conf.set_al_mac(s_al);
+    auto& scenarios = conf.get_scenarios();
+
+    ASSERT_EQ(conf.build(scenarios[0].steps[0], 7, writer), 1);
+    frame = writer.get_frame(0, &len);
+    hdr = reinterpret_cast<em_raw_hdr_t *>(frame);
+    cmdu = reinterpret_cast<em_cmdu_t *>(frame + sizeof(em_raw_hdr_t));
+    EXPECT_EQ(memcmp(hdr->dst, multi_addr, sizeof(multi_addr)), 0);
+    EXPECT_EQ(memcmp(hdr->src, s_al, sizeof(s_al)), 0);
+    EXPECT_EQ(ntohs(cmdu->type), em_msg_type_autoconf_search);
+    EXPECT_EQ(ntohs(cmdu->id), 7);
+    tlv = reinterpret_cast<em_tlv_t *>(frame + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
+    EXPECT_EQ(tlv->type, 0x01);
+    EXPECT_EQ(ntohs(tlv->len), sizeof(mac_address_t));
+    EXPECT_EQ(memcmp(tlv->value, s_al, sizeof(s_al)), 0);
+    // al mac, searched role, supported service and the end of message
+    EXPECT_EQ(len, sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t) + (4 * sizeof(em_tlv_t)) + 6 + 1 + 2);
+
+    EXPECT_EQ(conf.build(scenarios[1].steps[0], 8, writer), -1);
+    conf.set_ctrl_mac(s_ctrl);
+    ASSERT_EQ(conf.build(scenarios[1].steps[0], 8, writer), 1);
+    frame = writer.get_frame(0, &len);
+    EXPECT_EQ(memcmp(reinterpret_cast<em_raw_hdr_t *>(frame)->dst, s_ctrl, sizeof(s_ctrl)), 0);
+    std::cout << "Exiting Build test" << std::endl;
+}
+
+/**
+* @brief Test that only the expected answer of a step is matched
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Answer with the type and id of the request | autoconf_resp 7 | Matched | Should Pass |
+* | 02| Other id, other type, own frame | autoconf_resp 8, topo_query 7, src $al | Not matched | Should Pass |
+* | 03| Step that ignores the id | topo_resp 99 | Matched | Should Pass |
+*/
+TEST(em_conformance_t_Test, Match) {
+    std::cout << "Entering Match test" << std::endl;
+    em_conformance_t conf;
+    em_tlv_writer_t writer;
+    std::string err;
+    unsigned char *frame;
+    unsigned int len;
+
+    ASSERT_EQ(conf.parse(s_script, err), 0) << err;
+    conf.set_al_mac(s_al);
+    auto& scenarios = conf.get_scenarios();
+
+    writer.begin(const_cast<unsigned char *>(s_al), const_cast<unsigned char *>(s_ctrl), em_msg_type_autoconf_resp, 7);
+    writer.finish();
+    frame = writer.get_frame(0, &len);
+    EXPECT_TRUE(conf.match(scenarios[0].steps[0], 7, frame, len));
+    EXPECT_FALSE(conf.match(scenarios[0].steps[0], 8, frame, len));
+    EXPECT_FALSE(conf.match(scenarios[0].steps[0], 7, frame, 10));
+
+    writer.begin(const_cast<unsigned char *>(s_al), const_cast<unsigned char *>(s_ctrl), em_msg_type_topo_query, 7);
+    writer.finish();
+    frame = writer.get_frame(0, &len);
+    EXPECT_FALSE(conf.match(scenarios[0].steps[0], 7, frame, len));
+
+    writer.begin(const_cast<unsigned char *>(s_ctrl), const_cast<unsigned char *>(s_al), em_msg_type_autoconf_resp, 7);
+    writer.finish();
+    frame = writer.get_frame(0, &len);
+    EXPECT_FALSE(conf.match(scenarios[0].steps[0], 7, frame, len));
+
+    writer.begin(const_cast<unsigned char *>(s_al), const_cast<unsigned char *>(s_ctrl), em_msg_type_topo_resp, 99);
+    writer.finish();
+    frame = writer.get_frame(0, &len);
+    EXPECT_TRUE(conf.match(scenarios[1].steps[0], 7, frame, len));
+    std::cout << "Exiting Match test" << std::endl;
+}
@@ -0,0 +1,195 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <set>
+#include "em_crypto_pool.h"
+
+struct test_job_t {
+    em_crypto_job_t job;            // first member, the pool hands back &job
+    unsigned int idx;
+    pthread_t tid;                  // worker that ran the job
+    std::atomic<unsigned int> *done;
+    std::atomic<unsigned int> *running;
+    std::atomic<unsigned int> *max_running;
+};
+
+static void test_run(em_crypto_job_t *job)
+{
+    test_job_t *j = reinterpret_cast<test_job_t *>(job);
+    unsigned int now = ++(*j->running), max;
+
+    max = j->max_running->load();
+    while ((now > max) && (j->max_running->compare_exchange_weak(max, now) == false));
+    usleep(2000);
+    j->tid = pthread_self();
+    job->result = static_cast<int>(j->idx);
+    (*j->running)--;
+}
+
+static void test_done(em_crypto_job_t *job)
+{
+    (*reinterpret_cast<test_job_t *>(job)->done)++;
+}
+
+static void init_job(test_job_t *j, unsigned int idx, std::atomic<unsigned int> *done,
+    std::atomic<unsigned int> *running, std::atomic<unsigned int> *max_running)
+{
+    memset(&j->job, 0, sizeof(em_crypto_job_t));
+    j->job.run = test_run;
+    j->job.done = test_done;
+    j->job.owner = j;
+    j->idx = idx;
+    j->done = done;
+    j->running = running;
+    j->max_running = max_running;
+}
+
+/**
+* @brief Test that every submitted job runs once and that the workers run jobs at the same time
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Start a pool of 4 workers | None | 4 workers running | Should Pass |
+* | 02| Submit 64 jobs taking 2ms each | None | Every job is run and handed back once with its result | Should Pass |
+* | 03| Check the workers that ran the jobs | None | More than one job ran at a time, on more than one worker | Should Pass |
+*/
+TEST(em_crypto_pool_t_Test, RunAll) {
+    std::cout << "Entering RunAll test" << std::endl;
+    const unsigned int num_jobs = 64;
+    static test_job_t jobs[num_jobs];
+    std::atomic<unsigned int> done(0), running(0), max_running(0);
+    std::set<pthread_t> tids;
+    em_crypto_pool_t pool;
+    unsigned int i;
+
+    ASSERT_EQ(pool.init(4), 0);
+    ASSERT_EQ(pool.get_num_workers(), 4u);
+    for (i = 0; i < num_jobs; i++) {
+        init_job(&jobs[i], i, &done, &running, &max_running);
+        ASSERT_EQ(pool.submit(&jobs[i].job), 0);
+    }
+    for (i = 0; (i < 1000) && (done.load() != num_jobs); i++) {
+        usleep(10000);
+    }
+    ASSERT_EQ(done.load(), num_jobs);
+
+    for (i = 0; i < num_jobs; i++) {
+        EXPECT_EQ(jobs[i].job.result, static_cast<int>(i));
+        tids.insert(jobs[i].tid);
+    }
+    EXPECT_GT(max_running.load(), 1u);
+    EXPECT_GT(tids.size(), 1u);
+    EXPECT_GE(pool.get_high_watermark(), 1u);
+    pool.deinit();
+    EXPECT_EQ(pool.get_num_workers(), 0u);
+    std::cout << "Exiting RunAll test" << std::endl;
+}
+
+/**
+* @brief Test that a pool that is not running refuses jobs and that the worker count is capped
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Submit a job to a pool that was never started | None | Refused, done() not called | Should Pass |
+* | 02| Start a pool with more workers than the maximum | 100 | EM_CRYPTO_POOL_MAX_WORKERS workers running | Should Pass |
+* | 03| Stop it and submit a job | None | Refused, done() not called | Should Pass |
+*/
+TEST(em_crypto_pool_t_Test, NotRunning) {
+    std::cout << "Entering NotRunning test" << std::endl;
+    std::atomic<unsigned int> done(0), running(0), max_running(0);
+    em_crypto_pool_t pool;
+    test_job_t job;
+
+    init_job(&job, 1, &done, &running, &max_running);
+    EXPECT_EQ(pool.submit(&job.job), -1);
+
+    ASSERT_EQ(pool.init(100), 0);
+    EXPECT_EQ(pool.get_num_workers(), static_cast<unsigned int>(EM_CRYPTO_POOL_MAX_WORKERS));
+    pool.deinit();
+    EXPECT_EQ(pool.submit(&job.job), -1);
+    EXPECT_EQ(done.load(), 0u);
+    std::cout << "Exiting NotRunning test" << std::endl;
+}
+
+/**
+* @brief Test that the jobs still queued when the pool stops are handed back as not run
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Submit 32 jobs taking 2ms each to a pool of 1 worker and stop it right away | None | Every job is handed back once | Should Pass |
+* | 02| Check the results | None | The jobs that did not run have result -1 | Should Pass |
+*/
+TEST(em_crypto_pool_t_Test, DeinitHandsBack) {
+    std::cout << "Entering DeinitHandsBack test" << std::endl;
+    const unsigned int num_jobs = 32;
+    static test_job_t jobs[num_jobs];
+    std::atomic<unsigned int> done(0), running(0), max_running(0);
+    em_crypto_pool_t pool;
+    unsigned int i, not_run = 0;
+
+    ASSERT_EQ(pool.init(1), 0);
+    for (i = 0; i < num_jobs; i++) {
+        init_job(&jobs[i], i + 1, &done, &running, &max_running);
+        ASSERT_EQ(pool.submit(&jobs[i].job), 0);
+    }
+    pool.deinit();
+    EXPECT_EQ(done.load(), num_jobs);
+
+    for (i = 0; i < num_jobs; i++) {
+        if (jobs[i].job.result == -1) {
+            not_run++;
+        } else {
+            EXPECT_EQ(jobs[i].job.result, static_cast<int>(i + 1));
+        }
+    }
+    EXPECT_GT(not_run, 0u);
+    std::cout << "Exiting DeinitHandsBack test" << std::endl;
+}
@@ -0,0 +1,140 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include "em_event_pool.h"
+
+/**
+* @brief Test that a released event is recycled by the next allocation of the same size class
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Allocate a small event, fill its subdoc payload, release it and allocate again | data_len = 200, then 100 | Same block is returned, the subdoc payload is terminated | Should Pass |
+*/
+TEST(em_event_pool_t_Test, RecycleSmallEvent) {
+    std::cout << "Entering RecycleSmallEvent test" << std::endl;
+    em_event_pool_t pool;
+    em_event_t *first = pool.alloc(200);
+    ASSERT_NE(first, nullptr);
+    memset(first->u.bevt.u.subdoc.buff, 0xa5, 200);
+    pool.release(first);
+    em_event_t *second = pool.alloc(100);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(second->u.bevt.u.subdoc.buff[99], static_cast<char>(0xa5));
+    EXPECT_EQ(second->u.bevt.u.subdoc.buff[100], 0);
+    pool.release(second);
+    std::cout << "Exiting RecycleSmallEvent test" << std::endl;
+}
+
+/**
+* @brief Test that events of different size classes are not mixed up
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Release a small event and allocate a large one | data_len = 16, EM_MAX_EVENT_DATA_LEN | A different block is returned, the full subdoc payload is writable and terminated | Should Pass |
+*/
+TEST(em_event_pool_t_Test, SizeClassesAreSeparate) {
+    std::cout << "Entering SizeClassesAreSeparate test" << std::endl;
+    em_event_pool_t pool;
+    em_event_t *small = pool.alloc(16);
+    ASSERT_NE(small, nullptr);
+    pool.release(small);
+    em_event_t *large = pool.alloc(EM_MAX_EVENT_DATA_LEN);
+    ASSERT_NE(large, nullptr);
+    EXPECT_NE(small, large);
+    memset(large->u.bevt.u.subdoc.buff, 0xa5, EM_MAX_EVENT_DATA_LEN);
+    EXPECT_EQ(large->u.bevt.u.subdoc.buff[EM_MAX_EVENT_DATA_LEN], 0);
+    pool.release(large);
+    std::cout << "Exiting SizeClassesAreSeparate test" << std::endl;
+}
+
+/**
+* @brief Test that an oversized payload is rejected
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Allocate an event larger than the maximum event data length | data_len = EM_MAX_EVENT_DATA_LEN + 1 | NULL is returned | Should Fail |
+*/
+TEST(em_event_pool_t_Test, OversizedEventRejected) {
+    std::cout << "Entering OversizedEventRejected test" << std::endl;
+    em_event_pool_t pool;
+    EXPECT_EQ(pool.alloc(EM_MAX_EVENT_DATA_LEN + 1), nullptr);
+    pool.release(NULL);
+    std::cout << "Exiting OversizedEventRejected test" << std::endl;
+}
+
+/**
+* @brief Test payload length extraction for bus and non bus events
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** Medium@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Query the data length of a bus event | data_len = 100 | 100 | Should Pass |
+* | 02| Query the data length of a frame event | type = em_event_type_frame | 0 | Should Pass |
+*/
+TEST(em_event_pool_t_Test, EventDataLength) {
+    std::cout << "Entering EventDataLength test" << std::endl;
+    em_event_pool_t pool;
+    em_event_t *evt = pool.alloc(100);
+    ASSERT_NE(evt, nullptr);
+    evt->type = em_event_type_bus;
+    evt->u.bevt.data_len = 100;
+    EXPECT_EQ(em_event_pool_t::get_event_data_len(evt), 100u);
+    evt->type = em_event_type_frame;
+    EXPECT_EQ(em_event_pool_t::get_event_data_len(evt), 0u);
+    pool.release(evt);
+    std::cout << "Exiting EventDataLength test" << std::endl;
+}
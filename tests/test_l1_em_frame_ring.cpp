@@ -0,0 +1,131 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include "em_frame_ring.h"
+
+/**
+* @brief Test that a frame event maps back to its receive buffer and the buffer is recycled
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Take a buffer, convert it to a frame event and back | len = 64 | Same buffer, frame points at the buffer data | Should Pass |
+* | 02| Release the event and take a new buffer | None | Ring buffer is reused, no buffer in use | Should Pass |
+*/
+TEST(em_frame_ring_t_Test, EventRoundTrip) {
+    std::cout << "Entering EventRoundTrip test" << std::endl;
+    em_frame_ring_t ring;
+    ASSERT_EQ(ring.init(2), 0);
+    em_rx_buff_t *buff = ring.get();
+    ASSERT_NE(buff, nullptr);
+    em_event_t *evt = em_frame_ring_t::to_event(buff, 64);
+    EXPECT_EQ(evt->type, em_event_type_frame);
+    EXPECT_EQ(evt->u.fevt.frame, buff->data);
+    EXPECT_EQ(evt->u.fevt.frame_len, 64u);
+    EXPECT_EQ(em_frame_ring_t::from_event(evt), buff);
+    EXPECT_EQ(ring.get_in_use(), 1u);
+    em_frame_ring_t::put(em_frame_ring_t::from_event(evt));
+    EXPECT_EQ(ring.get_in_use(), 0u);
+    em_rx_buff_t *again = ring.get();
+    EXPECT_EQ(again, buff);
+    em_frame_ring_t::put(again);
+    std::cout << "Exiting EventRoundTrip test" << std::endl;
+}
+
+/**
+* @brief Test that a buffer is only recycled once its last reference is dropped
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Take a buffer, hold an extra reference and put it once | None | Buffer still in use | Should Pass |
+* | 02| Put the last reference | None | Buffer returned to the ring | Should Pass |
+*/
+TEST(em_frame_ring_t_Test, RefCounting) {
+    std::cout << "Entering RefCounting test" << std::endl;
+    em_frame_ring_t ring;
+    ASSERT_EQ(ring.init(1), 0);
+    em_rx_buff_t *buff = ring.get();
+    ASSERT_NE(buff, nullptr);
+    em_frame_ring_t::hold(buff);
+    em_frame_ring_t::put(buff);
+    EXPECT_EQ(ring.get_in_use(), 1u);
+    em_frame_ring_t::put(buff);
+    EXPECT_EQ(ring.get_in_use(), 0u);
+    std::cout << "Exiting RefCounting test" << std::endl;
+}
+
+/**
+* @brief Test heap fallback when the ring is exhausted or the frame is oversized
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** Medium@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Take two buffers from a ring of one | None | Second buffer comes from the heap | Should Pass |
+* | 02| Take a buffer larger than EM_RX_BUFF_SZ | len = EM_RX_BUFF_SZ * 2 | Heap buffer of the requested size | Should Pass |
+*/
+TEST(em_frame_ring_t_Test, HeapFallback) {
+    std::cout << "Entering HeapFallback test" << std::endl;
+    em_frame_ring_t ring;
+    ASSERT_EQ(ring.init(1), 0);
+    em_rx_buff_t *first = ring.get();
+    em_rx_buff_t *second = ring.get();
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    EXPECT_FALSE(first->heap);
+    EXPECT_TRUE(second->heap);
+    em_rx_buff_t *large = ring.get(EM_RX_BUFF_SZ * 2);
+    ASSERT_NE(large, nullptr);
+    EXPECT_TRUE(large->heap);
+    EXPECT_EQ(large->size, static_cast<unsigned int>(EM_RX_BUFF_SZ * 2));
+    memset(large->data, 0, large->size);
+    EXPECT_EQ(ring.get_high_watermark(), 3u);
+    EXPECT_EQ(ring.get_heap_allocs(), 2u);
+    em_frame_ring_t::put(large);
+    em_frame_ring_t::put(second);
+    em_frame_ring_t::put(first);
+    EXPECT_EQ(ring.get_in_use(), 0u);
+    std::cout << "Exiting HeapFallback test" << std::endl;
+}
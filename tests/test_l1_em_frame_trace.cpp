@@ -0,0 +1,197 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "em_frame_trace.h"
+
+/**
+* @brief Test that each stage of a frame is recorded for its message type
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Record a frame with all stamps | Topology response, rx 1000, read 1100, queued 1300, handler 1700 to 2000 | Socket 100, Listener 200, Queue 400, Handler 300, Total 1000 us | Should Pass |
+* | 02| Read another message type | Topology query | No samples | Should Pass |
+*/
+TEST(em_frame_trace_t_Test, StagesRecorded) {
+    std::cout << "Entering StagesRecorded test" << std::endl;
+    em_frame_ts_t ts = {1000, 1100, 1300};
+    uint64_t expected[em_frame_stage_max] = {100, 200, 400, 300, 1000};
+    em_frame_trace_t::reset();
+    em_frame_trace_t::record(em_msg_type_topo_resp, &ts, 1700, 2000);
+    for (unsigned int i = 0; i < em_frame_stage_max; i++) {
+        em_lat_hist_t hist;
+        em_frame_trace_t::get_hist(em_msg_type_topo_resp, static_cast<em_frame_stage_t>(i), &hist);
+        EXPECT_EQ(hist.get_count(), 1u) << em_frame_trace_t::get_stage_str(static_cast<em_frame_stage_t>(i));
+        EXPECT_EQ(hist.get_max_us(), expected[i]) << em_frame_trace_t::get_stage_str(static_cast<em_frame_stage_t>(i));
+    }
+    em_lat_hist_t other;
+    em_frame_trace_t::get_hist(em_msg_type_topo_query, em_frame_stage_handler, &other);
+    EXPECT_EQ(other.get_count(), 0u);
+    std::cout << "Exiting StagesRecorded test" << std::endl;
+}
+
+/**
+* @brief Test that stages without stamps are left out and stamps out of order give no negative stage
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Record a frame without kernel stamp | read 500, queued 600, handler 700 to 800 | No socket sample, total 300 us from the read | Should Pass |
+* | 02| Record a frame queued after its handler start | queued 900, handler 850 to 860 | Queue 0 us | Should Pass |
+*/
+TEST(em_frame_trace_t_Test, MissingStamps) {
+    std::cout << "Entering MissingStamps test" << std::endl;
+    em_frame_ts_t no_rx = {0, 500, 600};
+    em_frame_ts_t late = {0, 0, 900};
+    em_lat_hist_t socket, total, queue;
+    em_frame_trace_t::reset();
+    em_frame_trace_t::record(em_msg_type_autoconf_search, &no_rx, 700, 800);
+    em_frame_trace_t::get_hist(em_msg_type_autoconf_search, em_frame_stage_socket, &socket);
+    em_frame_trace_t::get_hist(em_msg_type_autoconf_search, em_frame_stage_total, &total);
+    EXPECT_EQ(socket.get_count(), 0u);
+    EXPECT_EQ(total.get_max_us(), 300u);
+
+    em_frame_trace_t::record(em_msg_type_autoconf_resp, &late, 850, 860);
+    em_frame_trace_t::get_hist(em_msg_type_autoconf_resp, em_frame_stage_queue, &queue);
+    EXPECT_EQ(queue.get_count(), 1u);
+    EXPECT_EQ(queue.get_max_us(), 0u);
+    std::cout << "Exiting MissingStamps test" << std::endl;
+}
+
+/**
+* @brief Test the slow frame count and the encoded snapshot
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Record frames around the threshold | Threshold 1000 us, totals of 500 and 20 x 5000 us | 20 slow frames | Should Pass |
+* | 02| Turn the log off | Threshold 0 | Count unchanged | Should Pass |
+* | 03| Encode | - | SlowFrames 20 and a 0x8002 type with all stages | Should Pass |
+*/
+TEST(em_frame_trace_t_Test, SlowFramesAndEncode) {
+    std::cout << "Entering SlowFramesAndEncode test" << std::endl;
+    em_frame_ts_t fast = {0, 1000, 1100};
+    em_frame_ts_t slow = {0, 1000, 5000};
+    cJSON *obj = cJSON_CreateObject(), *types, *type;
+    em_frame_trace_t::reset();
+    em_frame_trace_t::set_slow_threshold_us(1000);
+    em_frame_trace_t::record(em_msg_type_ap_cap_rprt, &fast, 1200, 1500);
+    for (unsigned int i = 0; i < 20; i++) {
+        em_frame_trace_t::record(em_msg_type_ap_cap_rprt, &slow, 5500, 6000);
+    }
+    EXPECT_EQ(em_frame_trace_t::get_slow_frames(), 20u);
+    em_frame_trace_t::set_slow_threshold_us(0);
+    em_frame_trace_t::record(em_msg_type_ap_cap_rprt, &slow, 5500, 6000);
+    EXPECT_EQ(em_frame_trace_t::get_slow_frames(), 20u);
+
+    em_frame_trace_t::encode(obj);
+    EXPECT_EQ(cJSON_GetObjectItem(obj, "SlowFrames")->valuedouble, 20);
+    types = cJSON_GetObjectItem(obj, "Types");
+    ASSERT_NE(types, nullptr);
+    EXPECT_EQ(cJSON_GetArraySize(types), 1);
+    type = cJSON_GetObjectItem(types, "0x8002");
+    ASSERT_NE(type, nullptr);
+    for (unsigned int i = 0; i < em_frame_stage_max; i++) {
+        EXPECT_NE(cJSON_GetObjectItem(type, em_frame_trace_t::get_stage_str(static_cast<em_frame_stage_t>(i))), nullptr);
+    }
+    cJSON_Delete(obj);
+    em_frame_trace_t::set_slow_threshold_us(EM_FRAME_TRACE_SLOW_US);
+    std::cout << "Exiting SlowFramesAndEncode test" << std::endl;
+}
+
+/**
+* @brief Test the receive time of a datagram read from a timestamped socket
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Read without control data | - | 0 | Should Pass |
+* | 02| Send and read a datagram on a timestamped socket pair | 10 ms between send and read | Receive time at least 10 ms before the read | Should Pass |
+*/
+TEST(em_frame_trace_t_Test, RxTime) {
+    std::cout << "Entering RxTime test" << std::endl;
+    unsigned char buff[64] = {0}, ctrl[CMSG_SPACE(3 * sizeof(struct timespec))];
+    struct iovec iov = {buff, sizeof(buff)};
+    struct msghdr msg;
+    uint64_t now_us, rx_us;
+    int fds[2];
+
+    memset(&msg, 0, sizeof(msg));
+    EXPECT_EQ(em_frame_trace_t::get_rx_time_us(&msg, em_lat_hist_t::get_time_us()), 0u);
+
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_DGRAM, 0, fds), 0);
+    if (em_frame_trace_t::enable_rx_timestamps(fds[1]) != 0) {
+        close(fds[0]);
+        close(fds[1]);
+        GTEST_SKIP() << "no receive timestamps on this kernel";
+    }
+    ASSERT_EQ(send(fds[0], buff, sizeof(buff), 0), static_cast<ssize_t>(sizeof(buff)));
+    usleep(10000);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl;
+    msg.msg_controllen = sizeof(ctrl);
+    ASSERT_EQ(recvmsg(fds[1], &msg, 0), static_cast<ssize_t>(sizeof(buff)));
+    now_us = em_lat_hist_t::get_time_us();
+    rx_us = em_frame_trace_t::get_rx_time_us(&msg, now_us);
+    if (rx_us != 0) {
+        EXPECT_GE(now_us - rx_us, 9000u);
+        EXPECT_LT(now_us - rx_us, 5000000u);
+    }
+    close(fds[0]);
+    close(fds[1]);
+    std::cout << "Exiting RxTime test" << std::endl;
+}
@@ -0,0 +1,129 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include "em_hex.h"
+
+/**
+* @brief Test that MAC addresses are formatted and parsed back in every accepted form
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Format a MAC address with and without separator | 1c:1a:2b:3c:4d:5e | Lower case string, end pointer at the NUL | Should Pass |
+* | 02| Parse it in colon, dash, upper case and plain forms | "1C-1A-2B-3C-4D-5E", "1c1a2b3c4d5e" | Same bytes | Should Pass |
+*/
+TEST(em_hex_Test, MacRoundTrip) {
+    std::cout << "Entering MacRoundTrip test" << std::endl;
+    unsigned char mac[EM_HEX_MAC_LEN] = {0x1c, 0x1a, 0x2b, 0x3c, 0x4d, 0xfe};
+    unsigned char out[EM_HEX_MAC_LEN];
+    char str[EM_HEX_MAC_STR_LEN + 1];
+    char *end = em_hex::mac_to_str(mac, str);
+    EXPECT_STREQ(str, "1c:1a:2b:3c:4d:fe");
+    EXPECT_EQ(end, str + EM_HEX_MAC_STR_LEN);
+    em_hex::mac_to_str(mac, str, '\0');
+    EXPECT_STREQ(str, "1c1a2b3c4dfe");
+    EXPECT_EQ(em_hex::str_to_mac("1c:1a:2b:3c:4d:fe", out), 0);
+    EXPECT_EQ(memcmp(out, mac, sizeof(out)), 0);
+    EXPECT_EQ(em_hex::str_to_mac("1C-1A-2B-3C-4D-FE", out), 0);
+    EXPECT_EQ(memcmp(out, mac, sizeof(out)), 0);
+    EXPECT_EQ(em_hex::str_to_mac("1c1a2b3c4dfe", out), 0);
+    EXPECT_EQ(memcmp(out, mac, sizeof(out)), 0);
+    std::cout << "Exiting MacRoundTrip test" << std::endl;
+}
+
+/**
+* @brief Test that malformed MAC strings are refused and the unparsed bytes zeroed
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Parse a short MAC string | "01:23:45:67" | -1, first four bytes set, last two zero | Should Pass |
+* | 02| Parse an empty and a non hex string | "", "zz:..." | -1, all zero | Should Pass |
+*/
+TEST(em_hex_Test, MacMalformed) {
+    std::cout << "Entering MacMalformed test" << std::endl;
+    unsigned char out[EM_HEX_MAC_LEN];
+    unsigned char expect[EM_HEX_MAC_LEN] = {0x01, 0x23, 0x45, 0x67, 0, 0};
+    unsigned char zero[EM_HEX_MAC_LEN] = {0};
+    memset(out, 0xff, sizeof(out));
+    EXPECT_EQ(em_hex::str_to_mac("01:23:45:67", out), -1);
+    EXPECT_EQ(memcmp(out, expect, sizeof(out)), 0);
+    EXPECT_EQ(em_hex::str_to_mac("", out), -1);
+    EXPECT_EQ(memcmp(out, zero, sizeof(out)), 0);
+    EXPECT_EQ(em_hex::str_to_mac("zz:23:45:67:89:ab", out), -1);
+    EXPECT_EQ(memcmp(out, zero, sizeof(out)), 0);
+    std::cout << "Exiting MacMalformed test" << std::endl;
+}
+
+/**
+* @brief Test hex encoding of blobs and packed MAC comparison
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Encode and decode a blob, decode upper case and a bad digit | {0x00, 0x9f, 0xa0, 0xff} | "009fa0ff", same bytes, -1 on bad digit | Should Pass |
+* | 02| Pack, unpack and compare MAC addresses | Two MACs differing in the last byte | Round trip, unequal | Should Pass |
+*/
+TEST(em_hex_Test, BlobAndPacked) {
+    std::cout << "Entering BlobAndPacked test" << std::endl;
+    unsigned char blob[4] = {0x00, 0x9f, 0xa0, 0xff}, out[4];
+    char str[9];
+    em_hex::encode(blob, sizeof(blob), str);
+    EXPECT_STREQ(str, "009fa0ff");
+    EXPECT_EQ(em_hex::decode("009FA0FF", 8, out), 0);
+    EXPECT_EQ(memcmp(out, blob, sizeof(out)), 0);
+    EXPECT_EQ(em_hex::decode("0g", 2, out), -1);
+
+    unsigned char a[EM_HEX_MAC_LEN] = {0x02, 0x11, 0x22, 0x33, 0x44, 0x55};
+    unsigned char b[EM_HEX_MAC_LEN] = {0x02, 0x11, 0x22, 0x33, 0x44, 0x56};
+    unsigned char c[EM_HEX_MAC_LEN];
+    em_packed_mac_t packed = em_hex::pack_mac(a);
+    EXPECT_EQ(packed >> 48, 0u);
+    em_hex::unpack_mac(packed, c);
+    EXPECT_TRUE(em_hex::mac_equal(a, c));
+    EXPECT_FALSE(em_hex::mac_equal(a, b));
+    EXPECT_NE(packed, em_hex::pack_mac(b));
+    std::cout << "Exiting BlobAndPacked test" << std::endl;
+}
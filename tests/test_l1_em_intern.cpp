@@ -0,0 +1,87 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include "em_intern.h"
+
+/**
+* @brief Test that a string keeps its handle and the handle gives back the string
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Look up a string before interning it | "OneWifiMesh" | EM_INTERN_NONE | Should Pass |
+* | 02| Intern two strings, intern the first again | "OneWifiMesh", "private_ssid" | Distinct handles, the same handle again, the strings come back | Should Pass |
+*/
+TEST(em_intern_t_Test, InternAndFind) {
+    std::cout << "Entering InternAndFind test" << std::endl;
+    em_intern_t table;
+    EXPECT_EQ(table.find("OneWifiMesh", 128), static_cast<em_intern_id_t> (EM_INTERN_NONE));
+    em_intern_id_t net = table.intern("OneWifiMesh", 128);
+    em_intern_id_t ssid = table.intern("private_ssid", 128);
+    EXPECT_NE(net, static_cast<em_intern_id_t> (EM_INTERN_NONE));
+    EXPECT_NE(net, ssid);
+    EXPECT_EQ(table.intern("OneWifiMesh", 128), net);
+    EXPECT_EQ(table.find("OneWifiMesh", 128), net);
+    EXPECT_EQ(table.find("OneWifiMes", 128), static_cast<em_intern_id_t> (EM_INTERN_NONE));
+    EXPECT_STREQ(table.get_str(net), "OneWifiMesh");
+    EXPECT_STREQ(table.get_str(ssid), "private_ssid");
+    EXPECT_EQ(table.count(), 2u);
+    std::cout << "Exiting InternAndFind test" << std::endl;
+}
+
+/**
+* @brief Test that strings are bounded by their buffer and bad input is handled
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Intern a buffer without NUL | "OneWifiMesh", max = 4 | The handle of "OneW" | Should Pass |
+* | 02| Intern NULL, get the string of an unknown handle | NULL, 100 | EM_INTERN_NONE, "" | Should Pass |
+*/
+TEST(em_intern_t_Test, BoundsAndInvalid) {
+    std::cout << "Entering BoundsAndInvalid test" << std::endl;
+    em_intern_t table;
+    em_intern_id_t full = table.intern("OneWifiMesh", 128);
+    em_intern_id_t part = table.intern("OneWifiMesh", 4);
+    EXPECT_NE(full, part);
+    EXPECT_STREQ(table.get_str(part), "OneW");
+    EXPECT_EQ(table.find("OneW", 128), part);
+    EXPECT_EQ(table.find("OneWifiMesh", 128), full);
+    EXPECT_EQ(table.intern(NULL, 128), static_cast<em_intern_id_t> (EM_INTERN_NONE));
+    EXPECT_STREQ(table.get_str(100), "");
+    std::cout << "Exiting BoundsAndInvalid test" << std::endl;
+}
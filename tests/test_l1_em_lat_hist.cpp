@@ -0,0 +1,130 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include "em_lat_hist.h"
+
+/**
+* @brief Test that samples land in the power of two bucket matching their value
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Compute the bucket of samples on and around the bucket limits | 0, 1, 2, 3, 4, 1023, 1024 us | Buckets 0, 1, 2, 2, 3, 10, 11 | Should Pass |
+* | 02| Compute the bucket of a sample beyond the last limit | 1 hour | Last bucket | Should Pass |
+*/
+TEST(em_lat_hist_t_Test, BucketIndex) {
+    std::cout << "Entering BucketIndex test" << std::endl;
+    EXPECT_EQ(em_lat_hist_t::get_bucket_index(0), 0u);
+    EXPECT_EQ(em_lat_hist_t::get_bucket_index(1), 1u);
+    EXPECT_EQ(em_lat_hist_t::get_bucket_index(2), 2u);
+    EXPECT_EQ(em_lat_hist_t::get_bucket_index(3), 2u);
+    EXPECT_EQ(em_lat_hist_t::get_bucket_index(4), 3u);
+    EXPECT_EQ(em_lat_hist_t::get_bucket_index(1023), 10u);
+    EXPECT_EQ(em_lat_hist_t::get_bucket_index(1024), 11u);
+    EXPECT_EQ(em_lat_hist_t::get_bucket_index(3600ULL * 1000000), static_cast<unsigned int>(EM_LAT_HIST_BUCKETS - 1));
+    EXPECT_EQ(em_lat_hist_t::get_bucket_limit_us(EM_LAT_HIST_BUCKETS - 1), UINT64_MAX);
+    std::cout << "Exiting BucketIndex test" << std::endl;
+}
+
+/**
+* @brief Test the count, mean, max and percentile estimates of a histogram
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Record 99 fast samples and one slow sample | 99 x 100 us, 1 x 50000 us | Count 100, mean 599 us, max 50000 us | Should Pass |
+* | 02| Estimate the percentiles | 50, 99, 100 | 128 us, 128 us, 50000 us | Should Pass |
+* | 03| Reset the histogram | None | No samples, percentile 0 | Should Pass |
+*/
+TEST(em_lat_hist_t_Test, Summary) {
+    std::cout << "Entering Summary test" << std::endl;
+    em_lat_hist_t hist;
+    unsigned int i;
+    EXPECT_EQ(hist.get_percentile_us(50), 0u);
+    for (i = 0; i < 99; i++) {
+        hist.add(100);
+    }
+    hist.add(50000);
+    EXPECT_EQ(hist.get_count(), 100u);
+    EXPECT_EQ(hist.get_mean_us(), 599u);
+    EXPECT_EQ(hist.get_max_us(), 50000u);
+    EXPECT_EQ(hist.get_bucket(em_lat_hist_t::get_bucket_index(100)), 99u);
+    EXPECT_EQ(hist.get_percentile_us(50), 128u);
+    EXPECT_EQ(hist.get_percentile_us(99), 128u);
+    EXPECT_EQ(hist.get_percentile_us(100), 50000u);
+    hist.reset();
+    EXPECT_EQ(hist.get_count(), 0u);
+    EXPECT_EQ(hist.get_max_us(), 0u);
+    EXPECT_EQ(hist.get_percentile_us(99), 0u);
+    std::cout << "Exiting Summary test" << std::endl;
+}
+
+/**
+* @brief Test that the JSON encoding carries the summary and only the non empty buckets
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** Medium@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Record samples in two buckets and encode the histogram | 10 us, 10 us, 5000 us | Count 3, two bucket entries with counts 2 and 1 | Should Pass |
+*/
+TEST(em_lat_hist_t_Test, Encode) {
+    std::cout << "Entering Encode test" << std::endl;
+    em_lat_hist_t hist;
+    cJSON *obj = cJSON_CreateObject(), *arr;
+    hist.add(10);
+    hist.add(10);
+    hist.add(5000);
+    hist.encode(obj);
+    EXPECT_EQ(cJSON_GetObjectItem(obj, "Count")->valueint, 3);
+    EXPECT_EQ(cJSON_GetObjectItem(obj, "MaxUs")->valueint, 5000);
+    arr = cJSON_GetObjectItem(obj, "Buckets");
+    ASSERT_NE(arr, nullptr);
+    ASSERT_EQ(cJSON_GetArraySize(arr), 2);
+    EXPECT_EQ(cJSON_GetObjectItem(cJSON_GetArrayItem(arr, 0), "LimitUs")->valueint, 16);
+    EXPECT_EQ(cJSON_GetObjectItem(cJSON_GetArrayItem(arr, 0), "Count")->valueint, 2);
+    EXPECT_EQ(cJSON_GetObjectItem(cJSON_GetArrayItem(arr, 1), "Count")->valueint, 1);
+    cJSON_Delete(obj);
+    std::cout << "Exiting Encode test" << std::endl;
+}
@@ -0,0 +1,219 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "em_log.h"
+
+static void log_print(em_log_t *log, easymesh_log_level_t level, easymesh_dbg_type_t module, const char *format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    log->vprint(level, module, "log_print", 7, format, args);
+    va_end(args);
+}
+
+static std::string read_file(const std::string& path)
+{
+    std::string text;
+    char buff[4096];
+    size_t n;
+    FILE *fp;
+
+    if ((fp = fopen(path.c_str(), "r")) == NULL) {
+        return text;
+    }
+    while ((n = fread(buff, 1, sizeof(buff), fp)) > 0) {
+        text.append(buff, n);
+    }
+    fclose(fp);
+
+    return text;
+}
+
+class em_log_t_Test : public ::testing::Test {
+protected:
+    std::string m_dir;
+
+    void SetUp() override {
+        char tmpl[] = "/tmp/em_log_XXXXXX";
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        m_dir = std::string(tmpl) + "/";
+    }
+
+    void TearDown() override {
+        std::string cmd = "rm -rf " + m_dir;
+        EXPECT_EQ(system(cmd.c_str()), 0);
+    }
+};
+
+/**
+* @brief Test that info messages go to the log file and debug messages are not formatted without the debug enable file
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Check the levels of EM_CTRL | No debug enable file | Info and error enabled, debug not | Should Pass |
+* | 02| Log an info and a debug message and flush | "hello 42", "hidden" | emCtrl.txt holds the info message with its prefix only | Should Pass |
+*/
+TEST_F(em_log_t_Test, LevelsAndFile) {
+    std::cout << "Entering LevelsAndFile test" << std::endl;
+    em_log_t log;
+    ASSERT_EQ(log.init(m_dir.c_str(), m_dir.c_str(), m_dir.c_str()), 0);
+    EXPECT_TRUE(log.enabled(EM_LOG_LVL_INFO, EM_CTRL));
+    EXPECT_TRUE(log.enabled(EM_LOG_LVL_ERROR, EM_CTRL));
+    EXPECT_FALSE(log.enabled(EM_LOG_LVL_DEBUG, EM_CTRL));
+    log_print(&log, EM_LOG_LVL_INFO, EM_CTRL, "hello %d", 42);
+    log_print(&log, EM_LOG_LVL_DEBUG, EM_CTRL, "hidden");
+    EXPECT_TRUE(log.flush(5000));
+    std::string text = read_file(m_dir + "emCtrl.txt");
+    EXPECT_NE(text.find(" emCtrl:log_print:7: INFO: hello 42\n"), std::string::npos);
+    EXPECT_EQ(text.find("hidden"), std::string::npos);
+    EXPECT_EQ(access((m_dir + "emCtrl").c_str(), F_OK), -1);
+    log.deinit();
+    std::cout << "Exiting LevelsAndFile test" << std::endl;
+}
+
+/**
+* @brief Test that the debug enable file sends every level to the debug log and that long messages are kept whole
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Create emAgentDbg and start the logger | None | Debug enabled for EM_AGENT | Should Pass |
+* | 02| Log a debug message longer than a ring slot and flush | 3 * EM_LOG_MSG_SZ characters | emAgent holds the whole message | Should Pass |
+* | 03| Write raw text | "raw\n" | Appended as it is | Should Pass |
+*/
+TEST_F(em_log_t_Test, DebugFileAndLongMessage) {
+    std::cout << "Entering DebugFileAndLongMessage test" << std::endl;
+    FILE *fp = fopen((m_dir + "emAgentDbg").c_str(), "w");
+    ASSERT_NE(fp, nullptr);
+    fclose(fp);
+    em_log_t log;
+    ASSERT_EQ(log.init(m_dir.c_str(), m_dir.c_str(), m_dir.c_str()), 0);
+    EXPECT_TRUE(log.enabled(EM_LOG_LVL_DEBUG, EM_AGENT));
+    std::string msg(3 * EM_LOG_MSG_SZ, 'x');
+    log_print(&log, EM_LOG_LVL_DEBUG, EM_AGENT, "%s", msg.c_str());
+    log.write(EM_LOG_LVL_DEBUG, EM_AGENT, "raw\n", 4);
+    EXPECT_TRUE(log.flush(5000));
+    std::string text = read_file(m_dir + "emAgent");
+    EXPECT_NE(text.find("DEBUG: " + msg + "\nraw\n"), std::string::npos);
+    log.deinit();
+    std::cout << "Exiting DebugFileAndLongMessage test" << std::endl;
+}
+
+/**
+* @brief Test that a rotated log file is reopened
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Log a message and rename the log file | "first" | emDb.txt.1 holds the message | Should Pass |
+* | 02| Wait for the file check and log another message | "second" | A new emDb.txt holds only the second message | Should Pass |
+*/
+TEST_F(em_log_t_Test, ReopenRotatedFile) {
+    std::cout << "Entering ReopenRotatedFile test" << std::endl;
+    em_log_t log;
+    ASSERT_EQ(log.init(m_dir.c_str(), m_dir.c_str(), m_dir.c_str()), 0);
+    log_print(&log, EM_LOG_LVL_ERROR, EM_DB, "first");
+    EXPECT_TRUE(log.flush(5000));
+    ASSERT_EQ(rename((m_dir + "emDb.txt").c_str(), (m_dir + "emDb.txt.1").c_str()), 0);
+    usleep((EM_LOG_CHECK_MS + 200) * 1000);
+    log_print(&log, EM_LOG_LVL_ERROR, EM_DB, "second");
+    EXPECT_TRUE(log.flush(5000));
+    EXPECT_NE(read_file(m_dir + "emDb.txt.1").find("first"), std::string::npos);
+    std::string text = read_file(m_dir + "emDb.txt");
+    EXPECT_NE(text.find("second"), std::string::npos);
+    EXPECT_EQ(text.find("first"), std::string::npos);
+    log.deinit();
+    std::cout << "Exiting ReopenRotatedFile test" << std::endl;
+}
+
+/**
+* @brief Test that messages logged from several threads are all written or counted as dropped
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Log from 4 threads at once and flush | 4 x 5000 messages | Lines written + drops == 20000 | Should Pass |
+*/
+TEST_F(em_log_t_Test, ConcurrentProducers) {
+    std::cout << "Entering ConcurrentProducers test" << std::endl;
+    const unsigned int num_threads = 4, num_msgs = 5000;
+    std::vector<std::thread> threads;
+    em_log_t log;
+    unsigned int i, lines = 0;
+    ASSERT_EQ(log.init(m_dir.c_str(), m_dir.c_str(), m_dir.c_str()), 0);
+    for (i = 0; i < num_threads; i++) {
+        threads.emplace_back([&log, i]() {
+            for (unsigned int j = 0; j < num_msgs; j++) {
+                log_print(&log, EM_LOG_LVL_INFO, EM_MGR, "thread %u message %u", i, j);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_TRUE(log.flush(5000));
+    std::string text = read_file(m_dir + "emMgr.txt");
+    for (auto c : text) {
+        lines += (c == '\n') ? 1:0;
+    }
+    EXPECT_EQ(lines + log.get_drops(), num_threads * num_msgs);
+    log.deinit();
+    std::cout << "Exiting ConcurrentProducers test" << std::endl;
+}
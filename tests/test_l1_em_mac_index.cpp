@@ -0,0 +1,167 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include "em_mac_index.h"
+#include "test_l1_utils.h"
+
+static void *make_val(unsigned int n)
+{
+    return reinterpret_cast<void *>(static_cast<uintptr_t>(n + 1));
+}
+
+/**
+* @brief Test adding, looking up and removing single mappings across table growth
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Add 1000 MACs, adding each twice | None | count is 1000, every MAC maps to its value | Should Pass |
+* | 02| Remove every other MAC | None | Removed MACs are not found, the others still are | Should Pass |
+* | 03| Clear the index | None | count is 0, nothing is found | Should Pass |
+*/
+TEST(em_mac_index_t_Test, AddGetRemove) {
+    std::cout << "Entering AddGetRemove test" << std::endl;
+    const unsigned int num = 1000;
+    em_mac_index_t index;
+    mac_address_t mac;
+    unsigned int i;
+
+    make_mac(0, mac);
+    EXPECT_EQ(index.get(mac), nullptr);
+    EXPECT_EQ(index.add(mac, NULL), -1);
+
+    for (i = 0; i < num; i++) {
+        make_mac(i, mac);
+        ASSERT_EQ(index.add(mac, make_val(i)), 0);
+        ASSERT_EQ(index.add(mac, make_val(i)), 0);
+    }
+    EXPECT_EQ(index.count(), num);
+
+    for (i = 0; i < num; i++) {
+        make_mac(i, mac);
+        EXPECT_EQ(index.get(mac), make_val(i));
+    }
+
+    for (i = 0; i < num; i += 2) {
+        make_mac(i, mac);
+        EXPECT_TRUE(index.remove(mac, make_val(i)));
+        EXPECT_FALSE(index.remove(mac, make_val(i)));
+    }
+    EXPECT_EQ(index.count(), num / 2);
+
+    for (i = 0; i < num; i++) {
+        make_mac(i, mac);
+        EXPECT_EQ(index.get(mac), ((i % 2) == 0) ? nullptr:make_val(i));
+    }
+
+    index.clear();
+    EXPECT_EQ(index.count(), 0u);
+    make_mac(1, mac);
+    EXPECT_EQ(index.get(mac), nullptr);
+    std::cout << "Exiting AddGetRemove test" << std::endl;
+}
+
+/**
+* @brief Test MACs mapping to several values and removal of a value from all its MACs
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Map 100 AL MACs to 3 radio values each | None | get_all returns the 3 values of each MAC, and the total when the array is too small | Should Pass |
+* | 02| Map 500 BSSIDs to the radio values, then remove_value for one radio of every AL MAC | None | The radio is gone from every MAC, the other values are untouched | Should Pass |
+*/
+TEST(em_mac_index_t_Test, MultiValue) {
+    std::cout << "Entering MultiValue test" << std::endl;
+    const unsigned int num_al = 100, num_radio = 3, num_bss = 500;
+    em_mac_index_t index;
+    mac_address_t mac;
+    void *vals[num_radio];
+    std::map<void *, unsigned int> seen;
+    unsigned int i, j, n;
+
+    for (i = 0; i < num_al; i++) {
+        make_mac(i, mac);
+        for (j = 0; j < num_radio; j++) {
+            ASSERT_EQ(index.add(mac, make_val(i * num_radio + j)), 0);
+        }
+    }
+    for (i = 0; i < num_bss; i++) {
+        make_mac(0x10000 + i, mac);
+        ASSERT_EQ(index.add(mac, make_val(i % (num_al * num_radio))), 0);
+    }
+    EXPECT_EQ(index.count(), num_al * num_radio + num_bss);
+
+    for (i = 0; i < num_al; i++) {
+        make_mac(i, mac);
+        ASSERT_EQ(index.get_all(mac, vals, num_radio), num_radio);
+        seen.clear();
+        for (j = 0; j < num_radio; j++) {
+            seen[vals[j]]++;
+        }
+        for (j = 0; j < num_radio; j++) {
+            EXPECT_EQ(seen[make_val(i * num_radio + j)], 1u);
+        }
+        EXPECT_EQ(index.get_all(mac, vals, 1), num_radio);
+    }
+
+    n = 0;
+    for (i = 0; i < num_al; i++) {
+        n += index.remove_value(make_val(i * num_radio));
+    }
+    // the AL MAC mapping of each first radio, and the BSSIDs that pointed to one
+    for (i = 0, j = 0; i < num_bss; i++) {
+        j += (((i % (num_al * num_radio)) % num_radio) == 0) ? 1:0;
+    }
+    EXPECT_EQ(n, num_al + j);
+    EXPECT_EQ(index.count(), num_al * num_radio + num_bss - n);
+
+    for (i = 0; i < num_al; i++) {
+        make_mac(i, mac);
+        ASSERT_EQ(index.get_all(mac, vals, num_radio), num_radio - 1);
+        for (j = 0; j < num_radio - 1; j++) {
+            EXPECT_NE(vals[j], make_val(i * num_radio));
+        }
+    }
+    for (i = 0; i < num_bss; i++) {
+        make_mac(0x10000 + i, mac);
+        n = i % (num_al * num_radio);
+        EXPECT_EQ(index.get(mac), ((n % num_radio) == 0) ? nullptr:make_val(n));
+    }
+    std::cout << "Exiting MultiValue test" << std::endl;
+}
@@ -0,0 +1,171 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include "em_mem_acct.h"
+
+static void fill_usage(em_mem_acct_usage_t *usage, unsigned char last, unsigned long long bytes)
+{
+    const unsigned char mac[] = {0x02, 0x00, 0x00, 0x00, 0x00, last};
+    unsigned int i;
+
+    memset(usage, 0, sizeof(em_mem_acct_usage_t));
+    memcpy(usage->al_mac, mac, sizeof(mac_address_t));
+    for (i = 0; i < em_mem_acct_max; i++) {
+        usage->bytes[i] = bytes;
+    }
+}
+
+/**
+* @brief Test that an update reports the agents over the agent budget, stacks excluded
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Update without budget | 2 agents | None over, total and peak set | Should Pass |
+* | 02| Update with an agent budget | 100 bytes per type, budget 650 | Only the agent over 650 heap bytes reported | Should Pass |
+*/
+TEST(em_mem_acct_t_Test, UpdateOverBudget) {
+    std::cout << "Entering UpdateOverBudget test" << std::endl;
+    em_mem_acct_t acct;
+    em_mem_acct_usage_t usage[2], over[2], got;
+    em_mem_acct_params_t params = {};
+
+    fill_usage(&usage[0], 1, 100);
+    fill_usage(&usage[1], 2, 200);
+    // 6 heap types, the stacks do not count
+    EXPECT_EQ(em_mem_acct_t::get_heap_bytes(&usage[0]), 600u);
+
+    EXPECT_EQ(acct.update(usage, 2, over, 2), 0u);
+    EXPECT_EQ(acct.count(), 2u);
+    EXPECT_EQ(acct.get_stats().total_bytes, 1800u);
+    EXPECT_EQ(acct.get_stats().peak_bytes, 1800u);
+    ASSERT_TRUE(acct.get_usage(usage[1].al_mac, &got));
+    EXPECT_EQ(got.bytes[em_mem_acct_scan], 200u);
+
+    params.agent_budget = 650;
+    acct.set_params(&params);
+    ASSERT_EQ(acct.update(usage, 2, over, 2), 1u);
+    EXPECT_EQ(memcmp(over[0].al_mac, usage[1].al_mac, sizeof(mac_address_t)), 0);
+
+    // a smaller measurement keeps the peak
+    EXPECT_EQ(acct.update(usage, 1, NULL, 0), 0u);
+    EXPECT_EQ(acct.count(), 1u);
+    EXPECT_EQ(acct.get_stats().total_bytes, 600u);
+    EXPECT_EQ(acct.get_stats().peak_bytes, 1800u);
+    std::cout << "Exiting UpdateOverBudget test" << std::endl;
+}
+
+/**
+* @brief Test that new agents are refused once a limit is reached
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Admit up to max_agents | max_agents 2 | Third agent refused, known agents admitted | Should Pass |
+* | 02| Admit over the total budget | total_budget 1000, 1200 bytes used | New agent refused until eviction frees memory | Should Pass |
+*/
+TEST(em_mem_acct_t_Test, Admit) {
+    std::cout << "Entering Admit test" << std::endl;
+    em_mem_acct_t acct;
+    em_mem_acct_usage_t usage[2];
+    em_mem_acct_params_t params = {};
+
+    params.max_agents = 2;
+    acct.set_params(&params);
+    fill_usage(&usage[0], 1, 0);
+    fill_usage(&usage[1], 2, 0);
+    EXPECT_TRUE(acct.admit(usage[0].al_mac));
+    EXPECT_TRUE(acct.admit(usage[1].al_mac));
+    fill_usage(&usage[0], 3, 0);
+    EXPECT_FALSE(acct.admit(usage[0].al_mac));
+    EXPECT_TRUE(acct.admit(usage[1].al_mac));
+    EXPECT_EQ(acct.get_stats().refused, 1u);
+
+    params.max_agents = 0;
+    params.total_budget = 1000;
+    acct.set_params(&params);
+    fill_usage(&usage[0], 1, 100);
+    fill_usage(&usage[1], 2, 100);
+    acct.update(usage, 2, NULL, 0);
+    fill_usage(&usage[0], 3, 0);
+    EXPECT_FALSE(acct.admit(usage[0].al_mac));
+
+    acct.evicted(300);
+    EXPECT_EQ(acct.get_stats().evictions, 1u);
+    EXPECT_EQ(acct.get_stats().evicted_bytes, 300u);
+    EXPECT_TRUE(acct.admit(usage[0].al_mac));
+    EXPECT_EQ(acct.count(), 3u);
+    EXPECT_EQ(acct.get_stats().refused, 2u);
+    std::cout << "Exiting Admit test" << std::endl;
+}
+
+/**
+* @brief Test that the accounting is encoded with every agent and type
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** Medium@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Encode one agent | 10 bytes per type | Agents array with the ALID, each type and the heap bytes | Should Pass |
+*/
+TEST(em_mem_acct_t_Test, Encode) {
+    std::cout << "Entering Encode test" << std::endl;
+    em_mem_acct_t acct;
+    em_mem_acct_usage_t usage;
+    cJSON *obj, *agent;
+
+    fill_usage(&usage, 1, 10);
+    acct.update(&usage, 1, NULL, 0);
+
+    obj = cJSON_CreateObject();
+    acct.encode(obj);
+    EXPECT_EQ(cJSON_GetObjectItem(obj, "TotalBytes")->valuedouble, 60);
+    ASSERT_EQ(cJSON_GetArraySize(cJSON_GetObjectItem(obj, "Agents")), 1);
+    agent = cJSON_GetArrayItem(cJSON_GetObjectItem(obj, "Agents"), 0);
+    EXPECT_STREQ(cJSON_GetObjectItem(agent, "ALID")->valuestring, "02:00:00:00:00:01");
+    EXPECT_EQ(cJSON_GetObjectItem(agent, em_mem_acct_t::get_type_str(em_mem_acct_stacks))->valuedouble, 10);
+    EXPECT_EQ(cJSON_GetObjectItem(agent, "HeapBytes")->valuedouble, 60);
+    cJSON_Delete(obj);
+    std::cout << "Exiting Encode test" << std::endl;
+}
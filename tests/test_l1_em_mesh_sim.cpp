@@ -0,0 +1,167 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include "em_mesh_sim.h"
+#include "em_msg.h"
+
+static void init_sim(em_mesh_sim_t *sim, unsigned int num_radios, unsigned int num_stas)
+{
+    em_mesh_sim_config_t cfg;
+
+    memset(&cfg, 0, sizeof(cfg));
+    snprintf(cfg.ifname, sizeof(cfg.ifname), "veth0");
+    cfg.num_agents = 300;
+    cfg.num_radios = num_radios;
+    cfg.num_stas = num_stas;
+    ASSERT_EQ(sim->init(&cfg, false), 0);
+}
+
+static bool validate_built(em_mesh_sim_t *sim, em_msg_type_t type)
+{
+    char *errors[EM_MAX_TLV_MEMBERS] = {0};
+    unsigned char *frame;
+    unsigned int len;
+
+    frame = sim->get_writer()->get_frame(0, &len);
+    em_msg_t msg(type, em_profile_type_2, frame, len);
+
+    return msg.validate(errors) != 0;
+}
+
+/**
+* @brief Test the MAC addresses of the simulated agents, radios, BSSs and stations
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Get the AL MAC of an agent | Agent 0x1234 | 02:5e:12:34:00:00 | Should Pass |
+* | 02| Get the radio, BSSID and station of the agent | Radio 1, station 6 | 02:5e:12:34:02:00, 02:5e:12:34:02:01, 06:5e:12:34:02:07 | Should Pass |
+*/
+TEST(em_mesh_sim_t_Test, MacScheme) {
+    std::cout << "Entering MacScheme test" << std::endl;
+    mac_address_t mac;
+    unsigned char al_mac[] = {0x02, 0x5e, 0x12, 0x34, 0x00, 0x00};
+    unsigned char ruid[] = {0x02, 0x5e, 0x12, 0x34, 0x02, 0x00};
+    unsigned char bssid[] = {0x02, 0x5e, 0x12, 0x34, 0x02, 0x01};
+    unsigned char sta[] = {0x06, 0x5e, 0x12, 0x34, 0x02, 0x07};
+    em_mesh_sim_t::get_mac(0x1234, -1, -1, false, mac);
+    EXPECT_EQ(memcmp(mac, al_mac, sizeof(mac)), 0);
+    em_mesh_sim_t::get_mac(0x1234, 1, -1, false, mac);
+    EXPECT_EQ(memcmp(mac, ruid, sizeof(mac)), 0);
+    em_mesh_sim_t::get_mac(0x1234, 1, -1, true, mac);
+    EXPECT_EQ(memcmp(mac, bssid, sizeof(mac)), 0);
+    em_mesh_sim_t::get_mac(0x1234, 1, 6, false, mac);
+    EXPECT_EQ(memcmp(mac, sta, sizeof(mac)), 0);
+    std::cout << "Exiting MacScheme test" << std::endl;
+}
+
+/**
+* @brief Test that every message the agents send passes the validation of the controller
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Build and validate the autoconfig search and the M1 of each radio | 2 radios, 4 stations per radio, profile 2 | One frame each, valid | Should Pass |
+* | 02| Build and validate the topology response, AP metrics response and BTM report | Same | One frame each, valid, message id of the query echoed | Should Pass |
+* | 03| Build an ack | Message id 0x4242 | 1905 ack with message id 0x4242 | Should Pass |
+*/
+TEST(em_mesh_sim_t_Test, MessagesValidate) {
+    std::cout << "Entering MessagesValidate test" << std::endl;
+    em_mesh_sim_t sim;
+    em_cmdu_t *cmdu;
+    unsigned char *frame;
+    unsigned int len;
+    init_sim(&sim, 2, 4);
+
+    ASSERT_EQ(sim.build_autoconf_search(7), 1);
+    EXPECT_TRUE(validate_built(&sim, em_msg_type_autoconf_search));
+    for (unsigned int radio = 0; radio < 2; radio++) {
+        ASSERT_EQ(sim.build_m1(7, radio), 1);
+        EXPECT_TRUE(validate_built(&sim, em_msg_type_autoconf_wsc));
+    }
+    ASSERT_EQ(sim.build_topo_resp(7, 0x1111), 1);
+    EXPECT_TRUE(validate_built(&sim, em_msg_type_topo_resp));
+    frame = sim.get_writer()->get_frame(0, &len);
+    cmdu = reinterpret_cast<em_cmdu_t *> (frame + sizeof(em_raw_hdr_t));
+    EXPECT_EQ(ntohs(cmdu->id), 0x1111);
+    ASSERT_EQ(sim.build_ap_metrics_rsp(7, 0x2222), 1);
+    EXPECT_TRUE(validate_built(&sim, em_msg_type_ap_metrics_rsp));
+    ASSERT_EQ(sim.build_btm_rprt(7, 1, 3), 1);
+    EXPECT_TRUE(validate_built(&sim, em_msg_type_client_steering_btm_rprt));
+
+    ASSERT_EQ(sim.build_ack(7, 0x4242), 1);
+    frame = sim.get_writer()->get_frame(0, &len);
+    cmdu = reinterpret_cast<em_cmdu_t *> (frame + sizeof(em_raw_hdr_t));
+    EXPECT_EQ(ntohs(cmdu->type), em_msg_type_1905_ack);
+    EXPECT_EQ(ntohs(cmdu->id), 0x4242);
+    std::cout << "Exiting MessagesValidate test" << std::endl;
+}
+
+/**
+* @brief Test that the messages of a large agent are fragmented to the frame size
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Build the AP metrics response of the largest agent | 4 radios, 32 stations per radio | More than one frame, none above the frame size | Should Pass |
+* | 02| Build its topology response | Same | One frame | Should Pass |
+*/
+TEST(em_mesh_sim_t_Test, LargeAgentFragmented) {
+    std::cout << "Entering LargeAgentFragmented test" << std::endl;
+    em_mesh_sim_t sim;
+    unsigned int i, len;
+    int count;
+    init_sim(&sim, EM_MESH_SIM_MAX_RADIOS, EM_MESH_SIM_MAX_STAS);
+
+    count = sim.build_ap_metrics_rsp(299, 1);
+    ASSERT_GT(count, 1);
+    for (i = 0; i < static_cast<unsigned int> (count); i++) {
+        ASSERT_NE(sim.get_writer()->get_frame(i, &len), nullptr);
+        EXPECT_LE(len, EM_MAX_FRAME_SZ);
+    }
+    EXPECT_EQ(sim.build_topo_resp(299, 2), 1);
+    std::cout << "Exiting LargeAgentFragmented test" << std::endl;
+}
@@ -53,6 +53,12 @@ public:
         return 0;
     }
 
+    int send_frames(unsigned char** /*buffs*/, unsigned int* /*lens*/, unsigned int num, bool /*multicast*/ = false) override {
+        return static_cast<int>(num);
+    }
+
+    em_tlv_writer_t* get_tlv_writer() override { return &m_tlv_writer; }
+
     em_profile_type_t get_profile_type() override { return m_profile; }
 
     em_cmd_t* get_current_cmd() override { return m_current_cmd; }
@@ -67,6 +73,7 @@ public:
     void set_current_cmd(em_cmd_t* cmd) { m_current_cmd = cmd; }
 
 private:
+    em_tlv_writer_t   m_tlv_writer;
     em_mgr_t*         m_mgr         = nullptr;
     dm_easy_mesh_t*   m_dm          = nullptr;
     em_profile_type_t m_profile     = em_profile_type_reserved;
@@ -0,0 +1,188 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include "em_metrics_history.h"
+#include "test_l1_utils.h"
+
+static em_metrics_sample_t make_sample(unsigned long long time_ms, unsigned char rcpi, unsigned int rate)
+{
+    em_metrics_sample_t sample;
+
+    memset(&sample, 0, sizeof(sample));
+    sample.time_ms = time_ms;
+    sample.rcpi = rcpi;
+    sample.ul_rate = rate;
+    sample.dl_rate = rate * 2;
+    sample.util = rate / 10;
+
+    return sample;
+}
+
+/**
+* @brief Test that the ring keeps the most recent samples in order once it wrapped
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Append 40 samples to a STA | rcpi = 100 + n | The last 32 samples, oldest first | Should Pass |
+* | 02| Get the 4 most recent samples | max = 4 | Samples 36 to 39 | Should Pass |
+* | 03| Get the samples of an unknown STA | None | None | Should Pass |
+*/
+TEST(em_metrics_history_t_Test, RingWraps) {
+    std::cout << "Entering RingWraps test" << std::endl;
+    em_metrics_history_t history;
+    em_metrics_sample_t samples[EM_METRICS_HISTORY_LEN], sample;
+    mac_address_t sta, other;
+    unsigned int i;
+
+    make_mac(1, sta);
+    make_mac(2, other);
+    for (i = 0; i < 40; i++) {
+        sample = make_sample(1000 + i, static_cast<unsigned char>(100 + i), i);
+        ASSERT_EQ(history.append(sta, &sample), 0);
+    }
+    EXPECT_EQ(history.count(), 1u);
+
+    ASSERT_EQ(history.get_samples(sta, samples, EM_METRICS_HISTORY_LEN), static_cast<unsigned int>(EM_METRICS_HISTORY_LEN));
+    for (i = 0; i < EM_METRICS_HISTORY_LEN; i++) {
+        EXPECT_EQ(samples[i].rcpi, 108 + i);
+        EXPECT_EQ(samples[i].time_ms, 1008u + i);
+    }
+
+    ASSERT_EQ(history.get_samples(sta, samples, 4), 4u);
+    EXPECT_EQ(samples[0].rcpi, 136);
+    EXPECT_EQ(samples[3].rcpi, 139);
+
+    EXPECT_EQ(history.get_samples(other, samples, 4), 0u);
+    std::cout << "Exiting RingWraps test" << std::endl;
+}
+
+/**
+* @brief Test the windowed min and max and the EWMA
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Append 10 samples one second apart, RCPI 50 then 150 | None | None | Should be successful |
+* | 02| Aggregate over the last 3 seconds | now = 9000 | 4 samples, min = max = 150 | Should Pass |
+* | 03| Aggregate over the whole ring | window = 0 | 10 samples, min 50 max 150, EWMA between them | Should Pass |
+* | 04| Aggregate an unknown STA | None | false | Should Pass |
+*/
+TEST(em_metrics_history_t_Test, Aggregates) {
+    std::cout << "Entering Aggregates test" << std::endl;
+    em_metrics_history_t history;
+    em_metrics_aggregate_t agg;
+    em_metrics_sample_t sample;
+    mac_address_t sta, other;
+    unsigned int i;
+
+    make_mac(1, sta);
+    make_mac(2, other);
+    for (i = 0; i < 10; i++) {
+        sample = make_sample(i * 1000, (i < 5) ? 50:150, (i + 1) * 100);
+        ASSERT_EQ(history.append(sta, &sample), 0);
+    }
+
+    ASSERT_TRUE(history.get_aggregate(sta, 3000, 9000, &agg));
+    EXPECT_EQ(agg.num, 4u);
+    EXPECT_EQ(agg.min.rcpi, 150);
+    EXPECT_EQ(agg.max.rcpi, 150);
+    EXPECT_EQ(agg.min.ul_rate, 700u);
+    EXPECT_EQ(agg.max.ul_rate, 1000u);
+    EXPECT_EQ(agg.min.time_ms, 6000u);
+    EXPECT_EQ(agg.max.time_ms, 9000u);
+
+    ASSERT_TRUE(history.get_aggregate(sta, 0, 9000, &agg));
+    EXPECT_EQ(agg.num, 10u);
+    EXPECT_EQ(agg.min.rcpi, 50);
+    EXPECT_EQ(agg.max.rcpi, 150);
+    EXPECT_GT(agg.ewma.rcpi, 50);
+    EXPECT_LT(agg.ewma.rcpi, 150);
+
+    EXPECT_FALSE(history.get_aggregate(other, 0, 9000, &agg));
+    std::cout << "Exiting Aggregates test" << std::endl;
+}
+
+/**
+* @brief Test that find_weak follows the EWMA and that removal keeps the other rows
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| 100 STAs with 8 samples at RCPI 120, STA 7 and 42 at RCPI 20 | None | None | Should be successful |
+* | 02| One sample at RCPI 20 for STA 3 | None | STA 3 is not weak, its EWMA barely moved | Should Pass |
+* | 03| Find weak STAs below 60 | min_samples = 4 | STA 7 and 42 | Should Pass |
+* | 04| Remove STA 7 | None | Only STA 42 is weak, 99 STAs left | Should Pass |
+*/
+TEST(em_metrics_history_t_Test, FindWeakAndRemove) {
+    std::cout << "Entering FindWeakAndRemove test" << std::endl;
+    em_metrics_history_t history;
+    em_metrics_sample_t sample;
+    mac_address_t macs[100], weak[4];
+    unsigned int i, j;
+
+    for (i = 0; i < 100; i++) {
+        make_mac(i, macs[i]);
+        for (j = 0; j < 8; j++) {
+            sample = make_sample(j, ((i == 7) || (i == 42)) ? 20:120, 100);
+            ASSERT_EQ(history.append(macs[i], &sample), 0);
+        }
+    }
+    sample = make_sample(8, 20, 100);
+    ASSERT_EQ(history.append(macs[3], &sample), 0);
+
+    ASSERT_EQ(history.find_weak(60, 4, weak, 4), 2u);
+    EXPECT_EQ(memcmp(weak[0], macs[7], sizeof(mac_address_t)), 0);
+    EXPECT_EQ(memcmp(weak[1], macs[42], sizeof(mac_address_t)), 0);
+    EXPECT_EQ(history.find_weak(60, 9, weak, 4), 0u);
+
+    EXPECT_TRUE(history.remove(macs[7]));
+    EXPECT_FALSE(history.remove(macs[7]));
+    EXPECT_EQ(history.count(), 99u);
+    ASSERT_EQ(history.find_weak(60, 4, weak, 4), 1u);
+    EXPECT_EQ(memcmp(weak[0], macs[42], sizeof(mac_address_t)), 0);
+    std::cout << "Exiting FindWeakAndRemove test" << std::endl;
+}
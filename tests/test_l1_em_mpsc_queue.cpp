@@ -0,0 +1,233 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+#include "em_mpsc_queue.h"
+
+/**
+* @brief Test FIFO ordering, bounded capacity and counters of the queue
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Fill a queue of capacity 4 and push one more entry | entries 1..5 | Fifth push fails and is counted as a drop | Should Pass |
+* | 02| Pop all entries | None | Entries come out in order, then NULL | Should Pass |
+*/
+TEST(em_mpsc_queue_t_Test, FifoAndCapacity) {
+    std::cout << "Entering FifoAndCapacity test" << std::endl;
+    em_mpsc_queue_t q;
+    ASSERT_EQ(q.init(4), 0);
+    for (uintptr_t i = 1; i <= 4; i++) {
+        EXPECT_TRUE(q.push(reinterpret_cast<void *>(i)));
+    }
+    EXPECT_FALSE(q.push(reinterpret_cast<void *>(5)));
+    EXPECT_EQ(q.get_drops(), 1u);
+    EXPECT_EQ(q.count(), 4u);
+    EXPECT_EQ(q.get_high_watermark(), 4u);
+    for (uintptr_t i = 1; i <= 4; i++) {
+        EXPECT_EQ(q.pop(), reinterpret_cast<void *>(i));
+    }
+    EXPECT_EQ(q.pop(), nullptr);
+    EXPECT_EQ(q.count(), 0u);
+    std::cout << "Exiting FifoAndCapacity test" << std::endl;
+}
+
+/**
+* @brief Test that wait() times out on an empty queue and returns once an entry is queued
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Wait on an empty queue | timeout = 10 ms | false | Should Pass |
+* | 02| Push from another thread while waiting | timeout = 5000 ms | true and the entry can be popped | Should Pass |
+*/
+TEST(em_mpsc_queue_t_Test, WaitAndWake) {
+    std::cout << "Entering WaitAndWake test" << std::endl;
+    em_mpsc_queue_t q;
+    ASSERT_EQ(q.init(8), 0);
+    EXPECT_FALSE(q.wait(10));
+    std::thread producer([&q]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        q.push(reinterpret_cast<void *>(0x1));
+    });
+    EXPECT_TRUE(q.wait(5000));
+    producer.join();
+    EXPECT_EQ(q.pop(), reinterpret_cast<void *>(0x1));
+    std::cout << "Exiting WaitAndWake test" << std::endl;
+}
+
+/**
+* @brief Test concurrent producers with a single consumer
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Four producers push 10000 entries each, retrying when full | None | Consumer receives every entry exactly once | Should Pass |
+*/
+TEST(em_mpsc_queue_t_Test, ConcurrentProducers) {
+    std::cout << "Entering ConcurrentProducers test" << std::endl;
+    const unsigned int producers = 4, per_producer = 10000;
+    em_mpsc_queue_t q;
+    ASSERT_EQ(q.init(64), 0);
+    std::vector<std::thread> threads;
+    for (unsigned int p = 0; p < producers; p++) {
+        threads.emplace_back([&q, p, per_producer]() {
+            for (uintptr_t i = 0; i < per_producer; i++) {
+                while (q.push(reinterpret_cast<void *>((p * per_producer) + i + 1)) == false) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    std::vector<bool> seen(producers * per_producer + 1, false);
+    unsigned int received = 0;
+    while (received < producers * per_producer) {
+        void *data = q.pop();
+        if (data == NULL) {
+            q.wait(100);
+            continue;
+        }
+        uintptr_t v = reinterpret_cast<uintptr_t>(data);
+        ASSERT_FALSE(seen[v]);
+        seen[v] = true;
+        received++;
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(q.pop(), nullptr);
+    std::cout << "Exiting ConcurrentProducers test" << std::endl;
+}
+
+/**
+* @brief Test that a batch pop returns the queued entries in order and bounded by the array size
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Push 10 entries and pop a batch of 8 | max = 8 | Entries 1 to 8 in order | Should Pass |
+* | 02| Pop another batch of 8 | max = 8 | Entries 9 and 10 | Should Pass |
+* | 03| Push after the batch pops until the queue is full | capacity = 16 | All pushes succeed | Should Pass |
+*/
+TEST(em_mpsc_queue_t_Test, PopBatch) {
+    std::cout << "Entering PopBatch test" << std::endl;
+    em_mpsc_queue_t q;
+    void *entries[8];
+    ASSERT_EQ(q.init(16), 0);
+    for (uintptr_t i = 1; i <= 10; i++) {
+        ASSERT_TRUE(q.push(reinterpret_cast<void *>(i)));
+    }
+    ASSERT_EQ(q.pop_batch(entries, 8), 8u);
+    for (uintptr_t i = 0; i < 8; i++) {
+        EXPECT_EQ(entries[i], reinterpret_cast<void *>(i + 1));
+    }
+    ASSERT_EQ(q.pop_batch(entries, 8), 2u);
+    EXPECT_EQ(entries[0], reinterpret_cast<void *>(9));
+    EXPECT_EQ(entries[1], reinterpret_cast<void *>(10));
+    EXPECT_EQ(q.count(), 0u);
+    for (uintptr_t i = 1; i <= 16; i++) {
+        EXPECT_TRUE(q.push(reinterpret_cast<void *>(i)));
+    }
+    EXPECT_FALSE(q.push(reinterpret_cast<void *>(17)));
+    q.deinit();
+    std::cout << "Exiting PopBatch test" << std::endl;
+}
+
+/**
+* @brief Test that push_wait() waits for room up to its timeout
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 005@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Push to a full queue without waiting | timeout = 0 ms | false, one drop | Should Pass |
+* | 02| Push to a full queue that is not drained | timeout = 20 ms | false after the timeout, one more drop | Should Pass |
+* | 03| Push to a full queue while another thread pops | timeout = 5000 ms | true once an entry is popped, no drop | Should Pass |
+*/
+TEST(em_mpsc_queue_t_Test, PushWait) {
+    std::cout << "Entering PushWait test" << std::endl;
+    em_mpsc_queue_t q;
+    ASSERT_EQ(q.init(4), 0);
+    for (uintptr_t i = 1; i <= 4; i++) {
+        EXPECT_TRUE(q.push_wait(reinterpret_cast<void *>(i), 0));
+    }
+    EXPECT_FALSE(q.push_wait(reinterpret_cast<void *>(5), 0));
+    EXPECT_EQ(q.get_drops(), 1u);
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(q.push_wait(reinterpret_cast<void *>(5), 20));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+    EXPECT_EQ(q.get_drops(), 2u);
+
+    std::thread consumer([&q]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        EXPECT_EQ(q.pop(), reinterpret_cast<void *>(0x1));
+    });
+    EXPECT_TRUE(q.push_wait(reinterpret_cast<void *>(5), 5000));
+    consumer.join();
+    EXPECT_EQ(q.get_drops(), 2u);
+    EXPECT_EQ(q.count(), 4u);
+    for (uintptr_t i = 2; i <= 5; i++) {
+        EXPECT_EQ(q.pop(), reinterpret_cast<void *>(i));
+    }
+    std::cout << "Exiting PushWait test" << std::endl;
+}
@@ -21,6 +21,7 @@
 #include <stdio.h>
 #include "em_msg.h"
 #include <cstring>
+#include <vector>
 
 #define TLV_HEADER_SIZE 3  // type (1) + len (2)
 #define MAC_LEN 6
@@ -5172,6 +5173,173 @@ TEST(em_msg_t, get_tlv_eom_before_target)
     delete[] buffer;
     std::cout << "Exiting get_tlv_eom_before_target test" << std::endl;
 }
+/**
+ * @brief Verify that every instance of a repeated TLV type is served from the index in frame order.
+ *
+ * This test builds a message with three AP Metrics TLVs interleaved with other TLVs and checks that get_tlv_count and the instance based get_tlv return each AP Metrics TLV in the order they appear in the frame.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 184@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Write three AP Metrics TLVs with a profile TLV in between, followed by an EOM TLV | ap_metrics values = {1..6}, {7..12}, {13..18} | Buffer populated | Should be successful |
+ * | 02 | Invoke get_tlv_count and get_tlv for each instance | type = em_tlv_type_ap_metrics, instance = 0..3 | count is 3, instances 0..2 match the written values in order, instance 3 is nullptr | Should Pass |
+ */
+TEST(em_msg_t, get_tlv_instance_multiple_ap_metrics)
+{
+    std::cout << "Entering get_tlv_instance_multiple_ap_metrics test" << std::endl;
+    unsigned char buffer[128] = {0};
+    unsigned char val[3][6] = {{1, 2, 3, 4, 5, 6}, {7, 8, 9, 10, 11, 12}, {13, 14, 15, 16, 17, 18}};
+    unsigned char profile = em_profile_type_2;
+    size_t offset = 0;
+    write_tlv(buffer + offset, em_tlv_type_ap_metrics, val[0], sizeof(val[0]));
+    offset += TLV_HEADER_SIZE + sizeof(val[0]);
+    write_tlv(buffer + offset, em_tlv_type_profile, &profile, sizeof(profile));
+    offset += TLV_HEADER_SIZE + sizeof(profile);
+    write_tlv(buffer + offset, em_tlv_type_ap_metrics, val[1], sizeof(val[1]));
+    offset += TLV_HEADER_SIZE + sizeof(val[1]);
+    write_tlv(buffer + offset, em_tlv_type_ap_metrics, val[2], sizeof(val[2]));
+    offset += TLV_HEADER_SIZE + sizeof(val[2]);
+    write_tlv(buffer + offset, em_tlv_type_eom, nullptr, 0);
+    offset += TLV_HEADER_SIZE;
+    em_msg_t msg(buffer, static_cast<unsigned int>(offset));
+    EXPECT_EQ(msg.get_tlv_count(em_tlv_type_ap_metrics), 3u);
+    EXPECT_EQ(msg.get_tlv_count(em_tlv_type_profile), 1u);
+    EXPECT_EQ(msg.get_tlv_count(em_tlv_type_radio_id), 0u);
+    for (unsigned int i = 0; i < 3; i++) {
+        em_tlv_t *tlv = msg.get_tlv(em_tlv_type_ap_metrics, i);
+        ASSERT_NE(tlv, nullptr);
+        EXPECT_EQ(0, memcmp(tlv->value, val[i], sizeof(val[i])));
+    }
+    EXPECT_EQ(msg.get_tlv(em_tlv_type_ap_metrics, 3), nullptr);
+    EXPECT_EQ(msg.get_tlv(em_tlv_type_ap_metrics), msg.get_tlv(em_tlv_type_ap_metrics, 0));
+    EXPECT_FALSE(msg.is_malformed());
+    std::cout << "Exiting get_tlv_instance_multiple_ap_metrics test" << std::endl;
+}
+/**
+ * @brief Verify that a TLV whose length overruns the buffer is not indexed and flags the message as malformed.
+ *
+ * This test writes a valid AL MAC address TLV followed by a radio id TLV that claims more bytes than the buffer holds, and checks that only the valid TLV is returned.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 185@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Write an AL MAC TLV and a radio id TLV with a length of 64 into a buffer that ends 6 bytes into its value | buffer length = 2 * TLV_HEADER_SIZE + 12 | Buffer populated | Should be successful |
+ * | 02 | Invoke get_al_mac_address, get_radio_id and is_malformed | mac buffers | AL MAC is found, radio id is not, is_malformed returns true | Should Pass |
+ */
+TEST(em_msg_t, get_tlv_length_overrun_not_indexed)
+{
+    std::cout << "Entering get_tlv_length_overrun_not_indexed test" << std::endl;
+    unsigned char buffer[2 * TLV_HEADER_SIZE + 12] = {0};
+    unsigned char al_mac[6] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55};
+    unsigned char ruid[6] = {0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB};
+    write_tlv(buffer, em_tlv_type_al_mac_address, al_mac, sizeof(al_mac));
+    write_tlv(buffer + TLV_HEADER_SIZE + 6, em_tlv_type_radio_id, ruid, sizeof(ruid));
+    uint16_t bad_len = htons(64);
+    memcpy(buffer + TLV_HEADER_SIZE + 6 + 1, &bad_len, sizeof(bad_len));
+    em_msg_t msg(buffer, sizeof(buffer));
+    unsigned char mac[6] = {0};
+    mac_address_t radio;
+    EXPECT_TRUE(msg.get_al_mac_address(mac));
+    EXPECT_EQ(0, memcmp(mac, al_mac, sizeof(al_mac)));
+    EXPECT_FALSE(msg.get_radio_id(&radio));
+    EXPECT_TRUE(msg.is_malformed());
+    std::cout << "Exiting get_tlv_length_overrun_not_indexed test" << std::endl;
+}
+/**
+ * @brief Verify that TLVs beyond the index capacity are still found.
+ *
+ * This test writes more TLVs than EM_MAX_INDEXED_TLVS, with the only radio id TLV placed after them, and checks that lookups fall back to walking the part that was not indexed.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 186@n
+ * **Priority:** Medium@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Write EM_MAX_INDEXED_TLVS + 2 AP Metrics TLVs followed by a radio id TLV and an EOM TLV | ap_metrics value = instance number | Buffer populated | Should be successful |
+ * | 02 | Invoke get_tlv_count, get_tlv for the last AP Metrics instance and get_radio_id | type = em_tlv_type_ap_metrics, em_tlv_type_radio_id | All AP Metrics TLVs are counted, the last instance and the radio id are found | Should Pass |
+ */
+TEST(em_msg_t, get_tlv_beyond_index_capacity)
+{
+    std::cout << "Entering get_tlv_beyond_index_capacity test" << std::endl;
+    const unsigned int num = EM_MAX_INDEXED_TLVS + 2;
+    std::vector<unsigned char> buffer((num + 2) * (TLV_HEADER_SIZE + 6), 0);
+    unsigned char ruid[6] = {0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB};
+    size_t offset = 0;
+    for (unsigned int i = 0; i < num; i++) {
+        unsigned char val[6] = {static_cast<unsigned char>(i), static_cast<unsigned char>(i >> 8), 0, 0, 0, 0};
+        write_tlv(&buffer[offset], em_tlv_type_ap_metrics, val, sizeof(val));
+        offset += TLV_HEADER_SIZE + sizeof(val);
+    }
+    write_tlv(&buffer[offset], em_tlv_type_radio_id, ruid, sizeof(ruid));
+    offset += TLV_HEADER_SIZE + sizeof(ruid);
+    write_tlv(&buffer[offset], em_tlv_type_eom, nullptr, 0);
+    offset += TLV_HEADER_SIZE;
+    em_msg_t msg(buffer.data(), static_cast<unsigned int>(offset));
+    EXPECT_EQ(msg.get_tlv_count(em_tlv_type_ap_metrics), num);
+    em_tlv_t *tlv = msg.get_tlv(em_tlv_type_ap_metrics, num - 1);
+    ASSERT_NE(tlv, nullptr);
+    EXPECT_EQ(tlv->value[0], static_cast<unsigned char>(num - 1));
+    EXPECT_EQ(tlv->value[1], static_cast<unsigned char>((num - 1) >> 8));
+    mac_address_t radio;
+    EXPECT_TRUE(msg.get_radio_id(&radio));
+    EXPECT_EQ(0, memcmp(radio, ruid, sizeof(ruid)));
+    std::cout << "Exiting get_tlv_beyond_index_capacity test" << std::endl;
+}
+/**
+ * @brief Verify that every message type maps to a distinct slot and unknown types share the last one.
+ *
+ * This test checks the slot mapping used by the per message type dispatch tables for the first and last 1905 and EasyMesh types, for types between the two ranges and for types past the EasyMesh range.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 187@n
+ * **Priority:** Medium@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Invoke get_type_slot for known 1905 and EasyMesh types | em_msg_type_topo_disc, em_msg_type_autoconf_renew, em_msg_type_1905_ack, em_msg_type_avail_spectrum_inquiry | Distinct slots below EM_MSG_TYPE_SLOT_OTHER | Should Pass |
+ * | 02 | Invoke get_type_slot for types outside the ranges | 0x0010, 0x7fff, 0x8050, 0xffff | EM_MSG_TYPE_SLOT_OTHER | Should Pass |
+ */
+TEST(em_msg_t, get_type_slot_ranges)
+{
+    std::cout << "Entering get_type_slot_ranges test" << std::endl;
+    EXPECT_EQ(em_msg_t::get_type_slot(em_msg_type_topo_disc), 0u);
+    EXPECT_EQ(em_msg_t::get_type_slot(em_msg_type_autoconf_renew), static_cast<unsigned int>(em_msg_type_autoconf_renew));
+    EXPECT_EQ(em_msg_t::get_type_slot(em_msg_type_1905_ack), static_cast<unsigned int>(EM_MSG_TYPE_1905_SLOTS));
+    EXPECT_LT(em_msg_t::get_type_slot(em_msg_type_avail_spectrum_inquiry), static_cast<unsigned int>(EM_MSG_TYPE_SLOT_OTHER));
+    EXPECT_NE(em_msg_t::get_type_slot(em_msg_type_ap_mld_config_req), em_msg_t::get_type_slot(em_msg_type_agent_list));
+    EXPECT_EQ(em_msg_t::get_type_slot(0x0010), static_cast<unsigned int>(EM_MSG_TYPE_SLOT_OTHER));
+    EXPECT_EQ(em_msg_t::get_type_slot(0x7fff), static_cast<unsigned int>(EM_MSG_TYPE_SLOT_OTHER));
+    EXPECT_EQ(em_msg_t::get_type_slot(0x8050), static_cast<unsigned int>(EM_MSG_TYPE_SLOT_OTHER));
+    EXPECT_EQ(em_msg_t::get_type_slot(0xffff), static_cast<unsigned int>(EM_MSG_TYPE_SLOT_OTHER));
+    std::cout << "Exiting get_type_slot_ranges test" << std::endl;
+}
 /**
  * @brief Verify that the higher_layer_data function does not throw exceptions for all valid profiles
  *
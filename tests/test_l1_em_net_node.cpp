@@ -5087,3 +5087,241 @@ TEST(em_net_node_t, em_net_node_t_successful_cleanup_of_resources_heap) {
     });
     std::cout << "Exiting ~em_net_node_t_successful_cleanup_of_resources_heap test" << std::endl;
 }
+/**
+ * @brief Verify that a cloned tree is allocated in one block, depth first from its root
+ *
+ * This test clones a root with three children and checks that the nodes of the clone follow each other in memory, the root first, so the whole tree is one allocation freed at once.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 125@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :--------------: | ----------- | --------- | --------------- | ----- |
+ * | 01 | Clone a root with three string children | root.num_children = 3 | A clone with three children | Should Pass |
+ * | 02 | Check the place of each child | clone_root->child[i] | clone_root + 1 + i | Should Pass |
+ * | 03 | Free the clone | free_network_tree(clone_root) | No error | Should be successful |
+ */
+TEST(em_net_node_t, clone_network_tree_single_block)
+{
+    std::cout << "Entering clone_network_tree_single_block test" << std::endl;
+    em_network_node_t root, child[3];
+    unsigned int i;
+    memset(&root, 0, sizeof(root));
+    strncpy(root.key, "root", sizeof(root.key));
+    root.type = em_network_node_data_type_obj;
+    for (i = 0; i < 3; i++) {
+        memset(&child[i], 0, sizeof(child[i]));
+        snprintf(child[i].key, sizeof(child[i].key), "child%u", i);
+        child[i].type = em_network_node_data_type_string;
+        root.child[root.num_children++] = &child[i];
+    }
+    em_network_node_t* clone_root = em_net_node_t::clone_network_tree(&root);
+    ASSERT_NE(clone_root, nullptr);
+    ASSERT_EQ(clone_root->num_children, 3u);
+    for (i = 0; i < 3; i++) {
+        EXPECT_EQ(clone_root->child[i], clone_root + 1 + i);
+        EXPECT_STREQ(clone_root->child[i]->key, child[i].key);
+    }
+    em_net_node_t::free_network_tree(clone_root);
+    std::cout << "Exiting clone_network_tree_single_block test" << std::endl;
+}
+/**
+ * @brief Verify that array elements set on a cloned tree are freed with it
+ *
+ * This test sets an array of more elements than the tree has room for on a leaf of a cloned tree, so its arena grows by a block, and frees the tree.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 126@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :--------------: | ----------- | --------- | --------------- | ----- |
+ * | 01 | Clone a single string array node | type = em_network_node_data_type_array_str | A clone without children | Should Pass |
+ * | 02 | Set 40 elements on the clone | fmt = "[a, b, ..., N]" | num_children = 40, the values in order | Should Pass |
+ * | 03 | Free the clone | free_network_tree(clone) | No error | Should be successful |
+ */
+TEST(em_net_node_t, set_node_array_value_on_cloned_tree)
+{
+    std::cout << "Entering set_node_array_value_on_cloned_tree test" << std::endl;
+    const char *names = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMN";
+    em_network_node_t node;
+    char fmt[128] = "[";
+    char elem[8];
+    unsigned int i;
+    memset(&node, 0, sizeof(node));
+    strncpy(node.key, "SSIDList", sizeof(node.key));
+    node.type = em_network_node_data_type_array_str;
+    em_network_node_t* clone = em_net_node_t::clone_network_tree(&node);
+    ASSERT_NE(clone, nullptr);
+    for (i = 0; i < 40; i++) {
+        snprintf(elem, sizeof(elem), (i == 0) ? "%c" : ", %c", names[i]);
+        strncat(fmt, elem, sizeof(fmt) - strlen(fmt) - 1);
+    }
+    strncat(fmt, "]", sizeof(fmt) - strlen(fmt) - 1);
+    em_net_node_t::set_node_array_value(clone, fmt);
+    EXPECT_EQ(clone->num_children, 40u);
+    for (i = 0; i < clone->num_children; i++) {
+        snprintf(elem, sizeof(elem), "%c", names[i]);
+        EXPECT_STREQ(clone->child[i]->value_str, elem);
+    }
+    em_net_node_t::free_network_tree(clone);
+    std::cout << "Exiting set_node_array_value_on_cloned_tree test" << std::endl;
+}
+/**
+ * @brief Verify that a subtree of a cloned tree can be freed before its root
+ *
+ * This test frees a child of a cloned tree, which stays allocated until its root is freed, then frees the root.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 127@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :--------------: | ----------- | --------- | --------------- | ----- |
+ * | 01 | Clone a root with one child | root.num_children = 1 | A clone with one child | Should Pass |
+ * | 02 | Free the child and then the root | free_network_tree(clone_root->child[0]), free_network_tree(clone_root) | No error | Should be successful |
+ */
+TEST(em_net_node_t, free_network_tree_subtree_of_cloned_tree)
+{
+    std::cout << "Entering free_network_tree_subtree_of_cloned_tree test" << std::endl;
+    em_network_node_t root, child;
+    memset(&root, 0, sizeof(root));
+    memset(&child, 0, sizeof(child));
+    root.type = em_network_node_data_type_obj;
+    child.type = em_network_node_data_type_number;
+    child.value_int = 7;
+    root.child[root.num_children++] = &child;
+    em_network_node_t* clone_root = em_net_node_t::clone_network_tree(&root);
+    ASSERT_NE(clone_root, nullptr);
+    EXPECT_NO_THROW({
+        em_net_node_t::free_network_tree(clone_root->child[0]);
+        em_net_node_t::free_network_tree(clone_root);
+    });
+    std::cout << "Exiting free_network_tree_subtree_of_cloned_tree test" << std::endl;
+}
+/**
+ * @brief Verify that the lookups in an indexed tree find the nodes a walk of the tree finds
+ *
+ * This test clones a tree with an array of two objects, indexes the clone and looks nodes up by path, by key prefix from the root and from a subtree, and by display counter.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 128@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :--------------: | ----------- | --------- | --------------- | ----- |
+ * | 01 | Clone and index a tree | {"SSIDList": [{"SSID": "home"}, {"SSID": "guest"}], "SSIDCount": 2} | index_network_tree returns 0 | Should Pass |
+ * | 02 | Look up by path | "SSIDList.1.SSID", "SSIDList.2", "SSIDList." | guest node, NULL, NULL | Should Pass |
+ * | 03 | Look up by key | "SSIDC" from the root, "SSID" from the second element | SSIDCount node, guest node | Should Pass |
+ * | 04 | Look up by display counter | 3 | The same node as in the tree not indexed | Should Pass |
+ * | 05 | Free the trees | free_network_tree | No error | Should be successful |
+ */
+TEST(em_net_node_t, index_network_tree_lookups)
+{
+    std::cout << "Entering index_network_tree_lookups test" << std::endl;
+    em_network_node_t root, list, elem[2], ssid[2], count;
+    em_long_string_t key;
+    unsigned int i;
+    memset(&root, 0, sizeof(root));
+    memset(&list, 0, sizeof(list));
+    memset(&count, 0, sizeof(count));
+    root.type = em_network_node_data_type_obj;
+    strncpy(list.key, "SSIDList", sizeof(list.key));
+    list.type = em_network_node_data_type_array_obj;
+    list.display_info.node_ctr = 1;
+    for (i = 0; i < 2; i++) {
+        memset(&elem[i], 0, sizeof(elem[i]));
+        memset(&ssid[i], 0, sizeof(ssid[i]));
+        elem[i].type = em_network_node_data_type_obj;
+        elem[i].display_info.node_ctr = 2 + 2 * i;
+        strncpy(ssid[i].key, "SSID", sizeof(ssid[i].key));
+        ssid[i].type = em_network_node_data_type_string;
+        strncpy(ssid[i].value_str, (i == 0) ? "home" : "guest", sizeof(ssid[i].value_str));
+        ssid[i].display_info.node_ctr = 3 + 2 * i;
+        elem[i].child[elem[i].num_children++] = &ssid[i];
+        list.child[list.num_children++] = &elem[i];
+    }
+    strncpy(count.key, "SSIDCount", sizeof(count.key));
+    count.type = em_network_node_data_type_number;
+    count.value_int = 2;
+    count.display_info.node_ctr = 6;
+    root.child[root.num_children++] = &list;
+    root.child[root.num_children++] = &count;
+    em_network_node_t* plain = em_net_node_t::clone_network_tree(&root);
+    em_network_node_t* tree = em_net_node_t::clone_network_tree(&root);
+    ASSERT_NE(plain, nullptr);
+    ASSERT_NE(tree, nullptr);
+    EXPECT_EQ(em_net_node_t::index_network_tree(tree), 0);
+    em_network_node_t* node = em_net_node_t::get_network_tree_by_path(tree, "SSIDList.1.SSID");
+    ASSERT_NE(node, nullptr);
+    EXPECT_STREQ(node->value_str, "guest");
+    EXPECT_EQ(em_net_node_t::get_network_tree_by_path(tree, "SSIDList.2"), nullptr);
+    EXPECT_EQ(em_net_node_t::get_network_tree_by_path(tree, "SSIDList."), nullptr);
+    snprintf(key, sizeof(key), "SSIDC");
+    EXPECT_EQ(em_net_node_t::get_network_tree_by_key(tree, key), tree->child[1]);
+    snprintf(key, sizeof(key), "SSID");
+    EXPECT_EQ(em_net_node_t::get_network_tree_by_key(tree->child[0]->child[1], key), tree->child[0]->child[1]->child[0]);
+    node = em_net_node_t::get_node_from_node_ctr(tree, 3);
+    ASSERT_NE(node, nullptr);
+    EXPECT_STREQ(node->value_str, em_net_node_t::get_node_from_node_ctr(plain, 3)->value_str);
+    em_net_node_t::free_network_tree(tree);
+    em_net_node_t::free_network_tree(plain);
+    std::cout << "Exiting index_network_tree_lookups test" << std::endl;
+}
+/**
+ * @brief Verify that only the root of a tree built by em_net_node_t can be indexed
+ *
+ * This test indexes a tree on the stack and a subtree of a cloned tree, both are refused.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 129@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :--------------: | ----------- | --------- | --------------- | ----- |
+ * | 01 | Index a node on the stack | &root | -1 | Should Pass |
+ * | 02 | Index a subtree of a clone | clone->child[0] | -1 | Should Pass |
+ * | 03 | Free the clone | free_network_tree(clone) | No error | Should be successful |
+ */
+TEST(em_net_node_t, index_network_tree_not_a_root)
+{
+    std::cout << "Entering index_network_tree_not_a_root test" << std::endl;
+    em_network_node_t root, child;
+    memset(&root, 0, sizeof(root));
+    memset(&child, 0, sizeof(child));
+    root.type = em_network_node_data_type_obj;
+    strncpy(child.key, "child", sizeof(child.key));
+    root.child[root.num_children++] = &child;
+    EXPECT_EQ(em_net_node_t::index_network_tree(&root), -1);
+    em_network_node_t* clone = em_net_node_t::clone_network_tree(&root);
+    ASSERT_NE(clone, nullptr);
+    EXPECT_EQ(em_net_node_t::index_network_tree(clone->child[0]), -1);
+    em_net_node_t::free_network_tree(clone);
+    std::cout << "Exiting index_network_tree_not_a_root test" << std::endl;
+}
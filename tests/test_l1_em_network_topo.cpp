@@ -1003,7 +1003,7 @@ TEST(em_network_topo_t, find_topology_null) {
  * | Variation / Step | Description                                                                                   | Test Data                                                                                                                         | Expected Result                                                                                                    | Notes        |
  * | :--------------: | --------------------------------------------------------------------------------------------- | --------------------------------------------------------------------------------------------------------------------------------- | ------------------------------------------------------------------------------------------------------------------ | ------------ |
  * | 01               | Initialize the device manager (DM) with a MAC and configure a single BSS with backhaul settings | root_dm pointer, init_dm_with_mac(root_dm, 0x10, 0), m_num_bss = 1, bssid = {0x02,0x10,0x00,0x00,0x00,0x01}, haul type = em_haul_type_backhaul | DM and BSS are set up correctly with the backhaul flag enabled                                                       | Should be successful |
- * | 02               | Create a STA, populate its MAC address and associate it with the BSS; insert STA into the STA map | sta pointer, sta_mac = {0x02,0x10,0x01,0x00,0x00,0x01}, associated bssid = {0x02,0x10,0x00,0x00,0x00,0x01}, sta_key generated via snprintf | STA is correctly inserted into the STA map                                                                           | Should be successful |
+ * | 02               | Create a STA, populate its MAC address and associate it with the BSS; insert STA into the STA map | sta pointer, sta_mac = {0x02,0x10,0x01,0x00,0x00,0x01}, associated bssid = {0x02,0x10,0x00,0x00,0x00,0x01}, sta_key built with dm_key_map_t::sta_key | STA is correctly inserted into the STA map                                                                           | Should be successful |
  * | 03               | Invoke find_topology_by_bh_associated using the STA MAC and verify it returns the correct topology  | Input: sta_mac = {0x02,0x10,0x01,0x00,0x00,0x01}; Output: pointer to topology (found)                                                | API returns topology pointer equal to the root topology instance (&topo_root) as verified by EXPECT_EQ                | Should Pass  |
  */
 TEST(em_network_topo_t, find_topology_by_bh_associated_sta_in_root) {
@@ -1014,22 +1014,21 @@ TEST(em_network_topo_t, find_topology_by_bh_associated_sta_in_root) {
     mac_address_t bssid = {0x02, 0x10, 0x00, 0x00, 0x00, 0x01};
     memcpy(root_dm->m_bss[0].m_bss_info.id.bssid, bssid, sizeof(mac_address_t));
     root_dm->m_bss[0].m_bss_info.id.haul_type = em_haul_type_backhaul;
-    root_dm->m_sta_map = hash_map_create();
+    root_dm->m_sta_map = new dm_key_map_t();
     dm_sta_t* sta = new dm_sta_t();
     mac_address_t sta_mac = {0x02, 0x10, 0x01, 0x00, 0x00, 0x01};
     memcpy(sta->m_sta_info.id, sta_mac, sizeof(mac_address_t));
     memcpy(sta->m_sta_info.bssid, bssid, sizeof(mac_address_t));
-    char* sta_key = static_cast<char*>(malloc(18));
-    snprintf(sta_key, 18, "%02X:%02X:%02X:%02X:%02X:%02X",
-             sta_mac[0], sta_mac[1], sta_mac[2],
-             sta_mac[3], sta_mac[4], sta_mac[5]);
-    hash_map_put(root_dm->m_sta_map, sta_key, sta);
+    dm_map_key_t sta_key;
+    dm_key_map_t::sta_key(&sta_key, sta_mac, bssid, sta->m_sta_info.radiomac);
+    root_dm->m_sta_map->put(&sta_key, sta);
     em_network_topo_t topo_root(root_dm);
     em_network_topo_t* found = topo_root.find_topology_by_bh_associated(sta_mac);
     EXPECT_EQ(found, &topo_root);
-    hash_map_remove(root_dm->m_sta_map, sta_key);
+    root_dm->m_sta_map->remove(&sta_key);
     delete sta;
-    hash_map_destroy(root_dm->m_sta_map);
+    delete root_dm->m_sta_map;
+    root_dm->m_sta_map = NULL;
     delete root_dm;
     std::cout << "Exiting find_topology_by_bh_associated_sta_in_root test" << std::endl;
 }
@@ -1069,22 +1068,21 @@ TEST(em_network_topo_t, find_topology_by_bh_associated_sta_in_child) {
     mac_address_t bssid = {0x02, 0x20, 0x00, 0x00, 0x00, 0x01};
     memcpy(child_dm->m_bss[0].m_bss_info.id.bssid, bssid, sizeof(mac_address_t));
     child_dm->m_bss[0].m_bss_info.id.haul_type = em_haul_type_backhaul;
-    child_dm->m_sta_map = hash_map_create();
+    child_dm->m_sta_map = new dm_key_map_t();
     dm_sta_t* sta = new dm_sta_t();
     mac_address_t sta_mac = {0x02, 0x20, 0x01, 0x00, 0x00, 0x01};
     memcpy(sta->m_sta_info.id, sta_mac, sizeof(mac_address_t));
     memcpy(sta->m_sta_info.bssid, bssid, sizeof(mac_address_t));
-    char* sta_key = static_cast<char*>(malloc(18));
-    snprintf(sta_key, 18, "%02X:%02X:%02X:%02X:%02X:%02X",
-             sta_mac[0], sta_mac[1], sta_mac[2],
-             sta_mac[3], sta_mac[4], sta_mac[5]);
-    hash_map_put(child_dm->m_sta_map, sta_key, sta);
+    dm_map_key_t sta_key;
+    dm_key_map_t::sta_key(&sta_key, sta_mac, bssid, sta->m_sta_info.radiomac);
+    child_dm->m_sta_map->put(&sta_key, sta);
     em_network_topo_t* found = topo_root->find_topology_by_bh_associated(sta_mac);
     EXPECT_EQ(found->get_data_model(), child_dm);
     // Cleanup
-    hash_map_remove(child_dm->m_sta_map, sta_key);
+    child_dm->m_sta_map->remove(&sta_key);
     delete sta;
-    hash_map_destroy(child_dm->m_sta_map);
+    delete child_dm->m_sta_map;
+    child_dm->m_sta_map = NULL;
     topo_root->remove(child_dm, nullptr, nullptr);
     delete child_dm;
     delete topo_root;
@@ -1114,9 +1112,9 @@ TEST(em_network_topo_t, find_topology_by_bh_associated_sta_in_child) {
  * | 03 | Initialize child data model and update its number of BSS. | child_dm pointer, value=0x20, m_num_bss=1 | Child data model is initialized and configured with one BSS | Should be successful |
  * | 04 | Initialize grandchild data model with BSS info for backhaul association. | grandchild_dm pointer, value=0x30, m_num_bss=1, BSSID, haul_type=em_haul_type_backhaul | Grandchild data model is initialized with backhaul details | Should be successful |
  * | 05 | Add child and grandchild topologies to the root network topology. | child_dm, grandchildren array containing grandchild_topo, count=1 | Network topology correctly links child and grandchild nodes | Should be successful |
- * | 06 | Create a station and add it to the grandchild node's station map with matching BSSID. | sta pointer, sta_mac, bssid, sta_key (formatted MAC string) | Station is successfully added to the grandchild station map | Should Pass |
+ * | 06 | Create a station and add it to the grandchild node's station map with matching BSSID. | sta pointer, sta_mac, bssid, sta_key (binary STA, BSSID and radio key) | Station is successfully added to the grandchild station map | Should Pass |
  * | 07 | Invoke find_topology_by_bh_associated using the station MAC address and validate the returned topology. | Input: sta_mac, Expected output: grandchild_dm associated topology | API returns topology containing grandchild data model; EXPECT_EQ check passes | Should Pass |
- * | 08 | Cleanup all allocated resources. | Pointers: root_dm, child_dm, grandchild_dm, topo_root, grandchild_topo, sta, sta_key; hash_map resources | All resources are deallocated without memory leaks | Should be successful |
+ * | 08 | Cleanup all allocated resources. | Pointers: root_dm, child_dm, grandchild_dm, topo_root, grandchild_topo, sta, sta_key; sta map | All resources are deallocated without memory leaks | Should be successful |
  */
 TEST(em_network_topo_t, find_topology_by_bh_associated_sta_in_grandchild) {
     std::cout << "Entering find_topology_by_bh_associated_sta_in_grandchild test" << std::endl;
@@ -1132,7 +1130,7 @@ TEST(em_network_topo_t, find_topology_by_bh_associated_sta_in_grandchild) {
     em_network_topo_t* grandchild_topo = new em_network_topo_t(grandchild_dm);
     em_network_topo_t* grandchildren[1] = { grandchild_topo };
     topo_root->add_network_topo(child_dm, grandchildren, 1);
-    grandchild_dm->m_sta_map = hash_map_create();
+    grandchild_dm->m_sta_map = new dm_key_map_t();
     dm_sta_t* sta = new dm_sta_t();
     mac_address_t bssid = {0x02, 0x30, 0x00, 0x00, 0x00, 0x01};
     memcpy(grandchild_dm->m_bss[0].m_bss_info.id.bssid, bssid, sizeof(mac_address_t));
@@ -1140,17 +1138,16 @@ TEST(em_network_topo_t, find_topology_by_bh_associated_sta_in_grandchild) {
     mac_address_t sta_mac = {0x02, 0x30, 0x00, 0x00, 0x00, 0x01};
     memcpy(sta->m_sta_info.id, sta_mac, sizeof(mac_address_t));
     memcpy(sta->m_sta_info.bssid, bssid, sizeof(mac_address_t));
-    char* sta_key = static_cast<char*>(malloc(18));
-    snprintf(sta_key, 18, "%02X:%02X:%02X:%02X:%02X:%02X",
-             sta_mac[0], sta_mac[1], sta_mac[2],
-             sta_mac[3], sta_mac[4], sta_mac[5]);
-    hash_map_put(grandchild_dm->m_sta_map, sta_key, sta);
+    dm_map_key_t sta_key;
+    dm_key_map_t::sta_key(&sta_key, sta_mac, bssid, sta->m_sta_info.radiomac);
+    grandchild_dm->m_sta_map->put(&sta_key, sta);
     em_network_topo_t* found = topo_root->find_topology_by_bh_associated(sta_mac);
     EXPECT_EQ(found->get_data_model(), grandchild_dm);
     // Cleanup
-    hash_map_remove(grandchild_dm->m_sta_map, sta_key);
+    grandchild_dm->m_sta_map->remove(&sta_key);
     delete sta;
-    hash_map_destroy(grandchild_dm->m_sta_map);
+    delete grandchild_dm->m_sta_map;
+    grandchild_dm->m_sta_map = NULL;
     topo_root->remove(child_dm, nullptr, nullptr); // removes child and grandchild
     delete grandchild_topo;
     delete grandchild_dm;
@@ -1247,9 +1244,9 @@ TEST(em_network_topo_t, find_topology_by_bh_associated_empty_root) {
  * | :--------------: | ----------- | --------- | --------------- | ----- |
  * | 01 | Initialize the root network device by invoking init_dm_with_mac with specific MAC parameters | Input: root_dm pointer, 0x10, 0 | The root network device (root_dm) is initialized with the correct MAC address | Should be successful |
  * | 02 | Configure radio and BSS parameters for the root device including enabling radio and BSS, setting MAC addresses, BSSID, haul type, and VAP mode | Input: root_dm fields: m_num_radios = 1, m_radio[0].enabled = true, radio_mac = {0x02, 0x10, 0x00, 0x00, 0x00, 0x00}; m_num_bss = 1, m_bss[0].enabled = true, BSSID = {0x02, 0x10, 0x00, 0x00, 0x00, 0x01}, haul_type = em_haul_type_backhaul, vap_mode = em_vap_mode_sta | The radio and BSS configurations are correctly applied to root_dm | Should be successful |
- * | 03 | Insert station (STA) information into the station map using hash_map_create and hash_map_put | Input: Created dm_sta_t with sta_mac = {0x02, 0x10, 0x01, 0x00, 0x00, 0x01}, corresponding key generated from the sta_mac | The station is successfully added to the sta_map | Should be successful |
+ * | 03 | Insert station (STA) information into the station map with dm_key_map_t::put | Input: Created dm_sta_t with sta_mac = {0x02, 0x10, 0x01, 0x00, 0x00, 0x01}, corresponding key generated from the sta_mac | The station is successfully added to the sta_map | Should be successful |
  * | 04 | Create the network topology object and invoke find_topology_by_bh_associated to retrieve the associated topology | Input: em_network_topo_t pointer created using root_dm, then call find_topology_by_bh_associated(root_dm) | The method returns the topology object equal to the one created (topo_root) and the EXPECT_EQ assertion passes | Should Pass |
- * | 05 | Clean up all allocated resources including removing STA from the map, freeing memory, and deleting objects | Input: Removal via hash_map_remove, deletion of sta, destruction of sta_map, deletion of root_dm and topo_root | All resources are cleaned up without memory leaks or errors | Should be successful |
+ * | 05 | Clean up all allocated resources including removing STA from the map, freeing memory, and deleting objects | Input: Removal via dm_key_map_t::remove, deletion of sta, destruction of sta_map, deletion of root_dm and topo_root | All resources are cleaned up without memory leaks or errors | Should be successful |
  */
 TEST(em_network_topo_t, find_topology_by_bh_associated_root) {
     std::cout << "Entering find_topology_by_bh_associated_root test" << std::endl;
@@ -1267,24 +1264,23 @@ TEST(em_network_topo_t, find_topology_by_bh_associated_root) {
     memcpy(root_dm->m_bss[0].m_bss_info.ruid.mac, radio_mac, 6);
     memcpy(root_dm->m_bss[0].m_bss_info.bssid.mac, bssid, 6);
     root_dm->m_bss[0].m_bss_info.vap_mode = em_vap_mode_sta;
-    root_dm->m_sta_map = hash_map_create();
+    root_dm->m_sta_map = new dm_key_map_t();
     dm_sta_t* sta = new dm_sta_t();
     mac_address_t sta_mac = {0x02, 0x10, 0x01, 0x00, 0x00, 0x01};
     memcpy(sta->m_sta_info.id, sta_mac, sizeof(mac_address_t));
     memcpy(sta->m_sta_info.bssid, bssid, sizeof(mac_address_t));
-    char* sta_key = static_cast<char*>(malloc(18));
-    snprintf(sta_key, 18, "%02X:%02X:%02X:%02X:%02X:%02X",
-             sta_mac[0], sta_mac[1], sta_mac[2],
-             sta_mac[3], sta_mac[4], sta_mac[5]);
-    hash_map_put(root_dm->m_sta_map, sta_key, sta);
+    dm_map_key_t sta_key;
+    dm_key_map_t::sta_key(&sta_key, sta_mac, bssid, sta->m_sta_info.radiomac);
+    root_dm->m_sta_map->put(&sta_key, sta);
 
     em_network_topo_t* topo_root = new em_network_topo_t(root_dm);
     g_network_topology = topo_root;
     em_network_topo_t* found = topo_root->find_topology_by_bh_associated(root_dm);
     EXPECT_EQ(found, topo_root);
-    hash_map_remove(root_dm->m_sta_map, sta_key);
+    root_dm->m_sta_map->remove(&sta_key);
     delete sta;
-    hash_map_destroy(root_dm->m_sta_map);
+    delete root_dm->m_sta_map;
+    root_dm->m_sta_map = NULL;
     delete root_dm;
     delete topo_root;
     std::cout << "Exiting find_topology_by_bh_associated_root test" << std::endl;
@@ -2188,3 +2184,245 @@ TEST(em_network_topo_t, destructor_releases_resources_for_valid_dm_pointer) {
     });
     std::cout << "Exiting destructor_releases_resources_for_valid_dm_pointer test" << std::endl;
 }
+/**
+ * @brief Verify the parent, hop count and path to the controller of the nodes, across a remove and add back
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 055@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Add a child with a grandchild to the root | root 0x10, child 0x20, grandchild 0x30 | Grandchild 2 hops away, path grandchild, child, root | Should Pass |
+ * | 02 | Remove the child keeping its children, then add it back with them | child_topos, num_child_topos | Grandchild detached with 0 hops, then 2 hops again under the new child node | Should Pass |
+ * | 03 | Look up the grandchild from the root and from itself | find_topology(gc_dm) | Found from both | Should Pass |
+ */
+TEST(em_network_topo_t, hops_and_path_to_controller) {
+    std::cout << "Entering hops_and_path_to_controller test" << std::endl;
+    dm_easy_mesh_t* root_dm = new dm_easy_mesh_t{};
+    init_dm_with_mac(root_dm, 0x10, 0);
+    em_network_topo_t* topo_root = new em_network_topo_t(root_dm);
+    dm_easy_mesh_t* child_dm = new dm_easy_mesh_t{};
+    init_dm_with_mac(child_dm, 0x20, 0);
+    dm_easy_mesh_t* gc_dm = new dm_easy_mesh_t{};
+    init_dm_with_mac(gc_dm, 0x30, 0);
+    em_network_topo_t* gc_topo = new em_network_topo_t(gc_dm);
+    em_network_topo_t* gc_array[1] = { gc_topo };
+    em_network_topo_t* child_topos[EM_MAX_NETWORKS];
+    em_network_topo_t* path[4];
+    unsigned int num_child_topos = 0;
+
+    topo_root->add_network_topo(child_dm, gc_array, 1);
+    EXPECT_EQ(topo_root->get_hops(), 0u);
+    EXPECT_EQ(topo_root->get_parent(), nullptr);
+    EXPECT_EQ(gc_topo->get_hops(), 2u);
+    ASSERT_EQ(gc_topo->get_path(path, 4), 3u);
+    EXPECT_EQ(path[0], gc_topo);
+    EXPECT_EQ(path[1]->get_data_model(), child_dm);
+    EXPECT_EQ(path[2], topo_root);
+
+    EXPECT_TRUE(topo_root->remove(child_dm, child_topos, &num_child_topos));
+    ASSERT_EQ(num_child_topos, 1u);
+    EXPECT_EQ(child_topos[0], gc_topo);
+    EXPECT_EQ(gc_topo->get_parent(), nullptr);
+    EXPECT_EQ(gc_topo->get_hops(), 0u);
+    EXPECT_EQ(topo_root->find_topology(gc_dm), nullptr);
+
+    topo_root->add_network_topo(child_dm, child_topos, num_child_topos);
+    EXPECT_EQ(gc_topo->get_hops(), 2u);
+    EXPECT_EQ(gc_topo->get_parent()->get_data_model(), child_dm);
+    EXPECT_EQ(topo_root->find_topology(gc_dm), gc_topo);
+    EXPECT_EQ(gc_topo->find_topology(gc_dm), gc_topo);
+
+    topo_root->remove(child_dm, nullptr, nullptr);
+    delete gc_topo;
+    delete gc_dm;
+    delete child_dm;
+    delete topo_root;
+    delete root_dm;
+    std::cout << "Exiting hops_and_path_to_controller test" << std::endl;
+}
+/**
+ * @brief Verify that find_topology_by_bss_mac follows BSSs added to and removed from the data model after its node was added
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 056@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Add a child without BSS, then give it a BSS | bssid AA:BB:CC:DD:EE:01 | Child found by the BSS | Should Pass |
+ * | 02 | Move the BSS to another child | Same bssid | Second child found | Should Pass |
+ * | 03 | Remove the BSS | m_num_bss = 0 | Not found | Should Pass |
+ */
+TEST(em_network_topo_t, find_topology_by_bss_mac_after_change) {
+    std::cout << "Entering find_topology_by_bss_mac_after_change test" << std::endl;
+    dm_easy_mesh_t* root_dm = new dm_easy_mesh_t{};
+    init_dm_with_mac(root_dm, 0x10, 0);
+    em_network_topo_t* topo_root = new em_network_topo_t(root_dm);
+    dm_easy_mesh_t* child1 = new dm_easy_mesh_t{};
+    init_dm_with_mac(child1, 0x20, 0);
+    dm_easy_mesh_t* child2 = new dm_easy_mesh_t{};
+    init_dm_with_mac(child2, 0x21, 1);
+    unsigned char bss_mac[6] = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0x01};
+    em_network_topo_t* result;
+
+    topo_root->add_network_topo(child1, nullptr, 0);
+    topo_root->add_network_topo(child2, nullptr, 0);
+    EXPECT_EQ(topo_root->find_topology_by_bss_mac(bss_mac), nullptr);
+
+    child1->m_num_bss = 1;
+    memcpy(child1->m_bss[0].m_bss_info.bssid.mac, bss_mac, sizeof(bss_mac));
+    result = topo_root->find_topology_by_bss_mac(bss_mac);
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(result->get_data_model(), child1);
+
+    child1->m_num_bss = 0;
+    child2->m_num_bss = 1;
+    memcpy(child2->m_bss[0].m_bss_info.bssid.mac, bss_mac, sizeof(bss_mac));
+    result = topo_root->find_topology_by_bss_mac(bss_mac);
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(result->get_data_model(), child2);
+
+    child2->m_num_bss = 0;
+    EXPECT_EQ(topo_root->find_topology_by_bss_mac(bss_mac), nullptr);
+
+    topo_root->remove(child1, nullptr, nullptr);
+    topo_root->remove(child2, nullptr, nullptr);
+    delete child1;
+    delete child2;
+    delete topo_root;
+    delete root_dm;
+    std::cout << "Exiting find_topology_by_bss_mac_after_change test" << std::endl;
+}
+/**
+ * @brief Verify the backhaul routes taken from the tree
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 057@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Child with a grandchild and a second child under the root | backhaul PHY rates 500, 80 and unknown | 3 routes, the grandchild 2 hops away through the child with an 80 Mbps bottleneck | Should Pass |
+ * | 02 | Routes into an array of one | max = 1 | 3 returned, the first stored | Should Pass |
+ */
+TEST(em_network_topo_t, routes_from_controller) {
+    std::cout << "Entering routes_from_controller test" << std::endl;
+    dm_easy_mesh_t* root_dm = new dm_easy_mesh_t{};
+    init_dm_with_mac(root_dm, 0x10, 0);
+    em_network_topo_t* topo_root = new em_network_topo_t(root_dm);
+    dm_easy_mesh_t* child_dm = new dm_easy_mesh_t{};
+    init_dm_with_mac(child_dm, 0x20, 0);
+    child_dm->m_device.m_device_info.backhaul_phyrate = 500;
+    dm_easy_mesh_t* gc_dm = new dm_easy_mesh_t{};
+    init_dm_with_mac(gc_dm, 0x30, 0);
+    gc_dm->m_device.m_device_info.backhaul_phyrate = 80;
+    dm_easy_mesh_t* other_dm = new dm_easy_mesh_t{};
+    init_dm_with_mac(other_dm, 0x40, 0);
+    em_network_topo_t* gc_topo = new em_network_topo_t(gc_dm);
+    em_network_topo_t* gc_array[1] = { gc_topo };
+    em_route_t routes[4];
+
+    topo_root->add_network_topo(child_dm, gc_array, 1);
+    topo_root->add_network_topo(other_dm);
+    ASSERT_EQ(topo_root->get_routes(routes, 4), 3u);
+
+    EXPECT_EQ(memcmp(routes[0].al_mac, child_dm->m_device.m_device_info.intf.mac, sizeof(mac_address_t)), 0);
+    EXPECT_EQ(memcmp(routes[0].next_hop, child_dm->m_device.m_device_info.intf.mac, sizeof(mac_address_t)), 0);
+    EXPECT_EQ(routes[0].hops, 1u);
+    EXPECT_EQ(routes[0].bottleneck_mbps, 500u);
+
+    EXPECT_EQ(memcmp(routes[1].al_mac, gc_dm->m_device.m_device_info.intf.mac, sizeof(mac_address_t)), 0);
+    EXPECT_EQ(memcmp(routes[1].next_hop, child_dm->m_device.m_device_info.intf.mac, sizeof(mac_address_t)), 0);
+    EXPECT_EQ(routes[1].hops, 2u);
+    EXPECT_EQ(routes[1].wireless_hops, 0u);
+    EXPECT_EQ(routes[1].bottleneck_mbps, 80u);
+
+    EXPECT_EQ(memcmp(routes[2].al_mac, other_dm->m_device.m_device_info.intf.mac, sizeof(mac_address_t)), 0);
+    EXPECT_EQ(routes[2].hops, 1u);
+    EXPECT_EQ(routes[2].bottleneck_mbps, 0u);
+
+    memset(routes, 0, sizeof(routes));
+    EXPECT_EQ(topo_root->get_routes(routes, 1), 3u);
+    EXPECT_EQ(routes[0].hops, 1u);
+    EXPECT_EQ(routes[1].hops, 0u);
+
+    topo_root->remove(other_dm, nullptr, nullptr);
+    topo_root->remove(gc_dm, nullptr, nullptr);
+    topo_root->remove(child_dm, nullptr, nullptr);
+    delete other_dm;
+    delete gc_dm;
+    delete child_dm;
+    delete topo_root;
+    delete root_dm;
+    std::cout << "Exiting routes_from_controller test" << std::endl;
+}
+
+/**
+ * @brief Verify that a node is current only while its data model has not changed since it was added
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 058@n
+ * **Priority:** High@n
+ * @n
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ * @n
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Child added under the root, device not in the tree | MACs 0x20 and 0x40 | Child current, other device not | Should Pass |
+ * | 02 | Data model of the child changed | set_changed() | Not current | Should Pass |
+ * | 03 | Child removed and added again | remove() then add() | Current | Should Pass |
+ * | 04 | Another data model with the AL MAC of the child | MAC 0x20 | Not current | Should Pass |
+ */
+TEST(em_network_topo_t, is_current_generation) {
+    std::cout << "Entering is_current_generation test" << std::endl;
+    dm_easy_mesh_t* root_dm = new dm_easy_mesh_t{};
+    init_dm_with_mac(root_dm, 0x10, 0);
+    em_network_topo_t* topo_root = new em_network_topo_t(root_dm);
+    dm_easy_mesh_t* child_dm = new dm_easy_mesh_t{};
+    init_dm_with_mac(child_dm, 0x20, 0);
+    dm_easy_mesh_t* other_dm = new dm_easy_mesh_t{};
+    init_dm_with_mac(other_dm, 0x40, 0);
+    dm_easy_mesh_t* same_dm = new dm_easy_mesh_t{};
+    init_dm_with_mac(same_dm, 0x20, 0);
+
+    child_dm->set_changed();
+    topo_root->add(child_dm, nullptr, 0);
+    EXPECT_TRUE(topo_root->is_current(child_dm));
+    EXPECT_FALSE(topo_root->is_current(other_dm));
+
+    child_dm->set_changed();
+    EXPECT_FALSE(topo_root->is_current(child_dm));
+
+    topo_root->remove(child_dm, nullptr, nullptr);
+    topo_root->add(child_dm, nullptr, 0);
+    EXPECT_TRUE(topo_root->is_current(child_dm));
+    EXPECT_FALSE(topo_root->is_current(same_dm));
+
+    topo_root->remove(child_dm, nullptr, nullptr);
+    delete same_dm;
+    delete other_dm;
+    delete child_dm;
+    delete topo_root;
+    delete root_dm;
+    std::cout << "Exiting is_current_generation test" << std::endl;
+}
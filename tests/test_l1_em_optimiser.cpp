@@ -0,0 +1,356 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include "em_optimiser.h"
+#include "em_chan_plan_optimiser.h"
+#include "test_l1_utils.h"
+
+// returns one steer action per score, after burning burn_us of CPU time
+class test_plugin_t : public em_optimiser_t {
+public:
+    const char *name;
+    unsigned long long scores[4];
+    unsigned int num_scores;
+    unsigned long long burn_us;
+    unsigned int events;
+    unsigned int applied_count;
+    unsigned long long last_budget;
+
+    const char *get_name() { return name; }
+
+    void radio_changed(const em_optimiser_radio_t *radio) { events++; }
+    void bss_added(const unsigned char *bssid, const unsigned char *ruid) { events++; }
+    void sta_sample(const unsigned char *sta, const unsigned char *bssid, const em_metrics_sample_t *sample) { events++; }
+    void bss_sample(const unsigned char *bssid, const em_metrics_sample_t *sample) { events++; }
+    void scan_result(const em_scan_result_t *res) { events++; }
+
+    unsigned int optimise(unsigned long long now, unsigned long long budget_us, em_optimiser_action_t *actions,
+                          unsigned int max)
+    {
+        unsigned long long start = em_optimiser_host_t::now_cpu_us();
+        volatile unsigned long long spin = 0;
+        unsigned int i;
+
+        last_budget = budget_us;
+        while ((em_optimiser_host_t::now_cpu_us() - start) < burn_us) {
+            spin++;
+        }
+        for (i = 0; (i < num_scores) && (i < max); i++) {
+            memset(&actions[i], 0, sizeof(em_optimiser_action_t));
+            actions[i].type = em_optimiser_action_steer;
+            actions[i].score = scores[i];
+        }
+
+        return i;
+    }
+
+    void applied(const em_optimiser_action_t *action, unsigned long long now) { applied_count++; }
+
+    test_plugin_t(const char *n) : name(n), num_scores(0), burn_us(0), events(0), applied_count(0), last_budget(0) { }
+};
+
+class em_optimiser_tTEST : public ::testing::Test {
+protected:
+    em_optimiser_host_t host;
+    em_optimiser_action_t actions[EM_OPTIMISER_MAX_ACTIONS];
+
+    // a 2.4 GHz radio on channels 1 to 11, 1, 6 and 11 preferred
+    void make_radio(unsigned int n, unsigned char current, em_optimiser_radio_t *radio)
+    {
+        unsigned int i;
+
+        memset(radio, 0, sizeof(em_optimiser_radio_t));
+        make_mac(n, 0, radio->ruid);
+        radio->op_class = 81;
+        radio->current = current;
+        radio->num_channels = 11;
+        for (i = 0; i < 11; i++) {
+            radio->channels[i] = static_cast<unsigned char>(i + 1);
+            radio->prefs[i] = ((i + 1) % 5 == 1) ? EM_OPTIMISER_MAX_PREF:10;
+        }
+    }
+
+    // a scan of a radio on channel 6, hearing the BSSs of other radios
+    void make_scan(unsigned int n, const unsigned int *heard, unsigned int num, em_scan_result_t *res)
+    {
+        unsigned int i;
+
+        memset(res, 0, sizeof(em_scan_result_t));
+        make_mac(n, 0, res->id.scanner_mac);
+        res->id.op_class = 81;
+        res->id.channel = 6;
+        for (i = 0; i < num; i++) {
+            make_mac(heard[i], 1, res->neighbor[i].bssid);
+            res->neighbor[i].signal_strength = -40;
+        }
+        res->num_neighbors = static_cast<unsigned short>(num);
+    }
+};
+
+/**
+* @brief Test adding and removing plugins
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Add two plugins, then the first again | a, b | 0, 1, -1 | Should Pass |
+* | 02| Add plugins up to the limit and one more | EM_OPTIMISER_MAX_PLUGINS | The last add returns -1 | Should Pass |
+* | 03| Remove the first plugin | a | The others move down, no name past the last | Should Pass |
+*/
+TEST_F(em_optimiser_tTEST, AddRemove) {
+    std::cout << "Entering AddRemove test" << std::endl;
+    test_plugin_t a("a"), b("b"), c("c");
+    std::vector<test_plugin_t *> more;
+    em_optimiser_stats_t stats;
+    unsigned int i;
+
+    EXPECT_EQ(host.add(&a), 0);
+    EXPECT_EQ(host.add(&b), 1);
+    EXPECT_EQ(host.add(&a), -1);
+    for (i = 2; i < EM_OPTIMISER_MAX_PLUGINS; i++) {
+        more.push_back(new test_plugin_t("more"));
+        EXPECT_EQ(host.add(more.back()), static_cast<int>(i));
+    }
+    EXPECT_EQ(host.add(&c), -1);
+    EXPECT_EQ(host.count(), static_cast<unsigned int>(EM_OPTIMISER_MAX_PLUGINS));
+
+    host.remove(&a);
+    EXPECT_EQ(host.count(), static_cast<unsigned int>(EM_OPTIMISER_MAX_PLUGINS - 1));
+    EXPECT_STREQ(host.get_name(0), "b");
+    EXPECT_EQ(host.get_name(EM_OPTIMISER_MAX_PLUGINS - 1), nullptr);
+    EXPECT_FALSE(host.get_stats(EM_OPTIMISER_MAX_PLUGINS - 1, &stats));
+
+    for (auto p : more) {
+        host.remove(p);
+        delete p;
+    }
+    host.remove(&b);
+    EXPECT_EQ(host.count(), 0u);
+    EXPECT_EQ(host.run(0, EM_OPTIMISER_BUDGET_US, actions, EM_OPTIMISER_MAX_ACTIONS), 0u);
+    std::cout << "Exiting AddRemove test" << std::endl;
+}
+
+/**
+* @brief Test that events reach every plugin and the actions of a cycle are ranked
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| One event of each kind | Two plugins | Each plugin sees five events | Should Pass |
+* | 02| Run a cycle | Scores 10, 30 and 20, 40 | Four actions, best first, each with the index of its plugin | Should Pass |
+* | 03| Report an action applied | Best action | Only its plugin is told | Should Pass |
+* | 04| Run a cycle with room for three actions | max 3 | The second plugin starts the cycle, both of its actions and the first of the other | Should Pass |
+*/
+TEST_F(em_optimiser_tTEST, EventsAndRanking) {
+    std::cout << "Entering EventsAndRanking test" << std::endl;
+    test_plugin_t a("a"), b("b");
+    em_optimiser_radio_t radio;
+    em_metrics_sample_t sample;
+    em_scan_result_t res;
+    em_optimiser_stats_t stats;
+    unsigned char mac[6];
+
+    a.scores[0] = 10;
+    a.scores[1] = 30;
+    a.num_scores = 2;
+    b.scores[0] = 20;
+    b.scores[1] = 40;
+    b.num_scores = 2;
+    ASSERT_EQ(host.add(&a), 0);
+    ASSERT_EQ(host.add(&b), 1);
+
+    make_mac(1, 0, mac);
+    make_radio(1, 6, &radio);
+    make_scan(1, NULL, 0, &res);
+    memset(&sample, 0, sizeof(sample));
+    host.radio_changed(&radio);
+    host.bss_added(mac, mac);
+    host.sta_sample(mac, mac, &sample);
+    host.bss_sample(mac, &sample);
+    host.scan_result(&res);
+    EXPECT_EQ(a.events, 5u);
+    EXPECT_EQ(b.events, 5u);
+    ASSERT_TRUE(host.get_stats(1, &stats));
+    EXPECT_EQ(stats.events, 5u);
+
+    ASSERT_EQ(host.run(0, EM_OPTIMISER_BUDGET_US, actions, EM_OPTIMISER_MAX_ACTIONS), 4u);
+    EXPECT_EQ(actions[0].score, 40u);
+    EXPECT_EQ(actions[0].plugin, 1u);
+    EXPECT_EQ(actions[1].score, 30u);
+    EXPECT_EQ(actions[1].plugin, 0u);
+    EXPECT_EQ(actions[2].score, 20u);
+    EXPECT_EQ(actions[3].score, 10u);
+
+    host.applied(&actions[0], 0);
+    EXPECT_EQ(a.applied_count, 0u);
+    EXPECT_EQ(b.applied_count, 1u);
+
+    ASSERT_EQ(host.run(0, EM_OPTIMISER_BUDGET_US, actions, 3), 3u);
+    EXPECT_EQ(actions[0].score, 40u);
+    EXPECT_EQ(actions[1].score, 20u);
+    EXPECT_EQ(actions[2].score, 10u);
+    ASSERT_TRUE(host.get_stats(0, &stats));
+    EXPECT_EQ(stats.cycles, 2u);
+    EXPECT_EQ(stats.actions, 3u);
+
+    host.remove(&a);
+    host.remove(&b);
+    std::cout << "Exiting EventsAndRanking test" << std::endl;
+}
+
+/**
+* @brief Test that a plugin that spends the budget does not starve the others
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Run a cycle, the first plugin burns twice the budget | 2000 us of 1000 us | It overruns, the second is skipped | Should Pass |
+* | 02| Run the next cycle | None | The second plugin starts it with the whole budget | Should Pass |
+*/
+TEST_F(em_optimiser_tTEST, Budget) {
+    std::cout << "Entering Budget test" << std::endl;
+    test_plugin_t a("a"), b("b");
+    em_optimiser_stats_t stats;
+
+    a.burn_us = 2000;
+    b.scores[0] = 1;
+    b.num_scores = 1;
+    ASSERT_EQ(host.add(&a), 0);
+    ASSERT_EQ(host.add(&b), 1);
+
+    EXPECT_EQ(host.run(0, 1000, actions, EM_OPTIMISER_MAX_ACTIONS), 0u);
+    ASSERT_TRUE(host.get_stats(0, &stats));
+    EXPECT_EQ(stats.overruns, 1u);
+    EXPECT_GE(stats.max_us, 2000u);
+    ASSERT_TRUE(host.get_stats(1, &stats));
+    EXPECT_EQ(stats.skipped, 1u);
+    EXPECT_EQ(stats.cycles, 0u);
+
+    EXPECT_EQ(host.run(0, 1000, actions, EM_OPTIMISER_MAX_ACTIONS), 1u);
+    EXPECT_EQ(actions[0].plugin, 1u);
+    ASSERT_TRUE(host.get_stats(1, &stats));
+    EXPECT_EQ(stats.cycles, 1u);
+    EXPECT_GT(b.last_budget, 0u);
+    EXPECT_LE(b.last_budget, 1000u);
+
+    host.remove(&a);
+    host.remove(&b);
+    std::cout << "Exiting Budget test" << std::endl;
+}
+
+/**
+* @brief Test the channel planner plugin from the events to its channel actions
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Three radios on channel 6 that hear each other | -40 dBm | Two channel actions, to channels other than 6 | Should Pass |
+* | 02| Run again with no new event | None | No action, the changes were proposed | Should Pass |
+* | 03| A radio moves to its planned channel | Operating channel event | No action | Should Pass |
+* | 04| A radio moves elsewhere | Channel 3 | Its change is proposed again | Should Pass |
+*/
+TEST_F(em_optimiser_tTEST, ChanPlanPlugin) {
+    std::cout << "Entering ChanPlanPlugin test" << std::endl;
+    em_chan_plan_optimiser_t chan;
+    unsigned int peers[3][2] = {{1, 2}, {0, 2}, {0, 1}};
+    em_optimiser_radio_t radio;
+    em_scan_result_t res;
+    unsigned char ruid[6], bssid[6], moved[6], planned;
+    unsigned int i, num;
+
+    ASSERT_EQ(host.add(&chan), 0);
+    EXPECT_STREQ(host.get_name(0), "chan_planner");
+    for (i = 0; i < 3; i++) {
+        make_radio(i, 6, &radio);
+        host.radio_changed(&radio);
+        make_mac(i, 0, ruid);
+        make_mac(i, 1, bssid);
+        host.bss_added(bssid, ruid);
+    }
+    for (i = 0; i < 3; i++) {
+        make_scan(i, peers[i], 2, &res);
+        host.scan_result(&res);
+    }
+
+    num = host.run(0, EM_OPTIMISER_BUDGET_US, actions, EM_OPTIMISER_MAX_ACTIONS);
+    ASSERT_EQ(num, 2u);
+    for (i = 0; i < num; i++) {
+        EXPECT_EQ(actions[i].type, em_optimiser_action_channel);
+        EXPECT_EQ(actions[i].op_class, 81);
+        EXPECT_NE(actions[i].channel, 6);
+        EXPECT_GT(actions[i].score, 0u);
+    }
+    EXPECT_NE(memcmp(actions[0].ruid, actions[1].ruid, sizeof(mac_address_t)), 0);
+    memcpy(moved, actions[1].ruid, sizeof(mac_address_t));
+    planned = actions[1].channel;
+
+    EXPECT_EQ(host.run(0, EM_OPTIMISER_BUDGET_US, actions, EM_OPTIMISER_MAX_ACTIONS), 0u);
+
+    memset(&radio, 0, sizeof(radio));
+    memcpy(radio.ruid, moved, sizeof(mac_address_t));
+    radio.op_class = 81;
+    radio.current = planned;
+    host.radio_changed(&radio);
+    EXPECT_EQ(host.run(0, EM_OPTIMISER_BUDGET_US, actions, EM_OPTIMISER_MAX_ACTIONS), 0u);
+    EXPECT_EQ(chan.get_planner()->get_channel(moved), planned);
+
+    radio.current = 3;
+    host.radio_changed(&radio);
+    ASSERT_EQ(host.run(0, EM_OPTIMISER_BUDGET_US, actions, EM_OPTIMISER_MAX_ACTIONS), 1u);
+    EXPECT_EQ(memcmp(actions[0].ruid, moved, sizeof(mac_address_t)), 0);
+    EXPECT_EQ(actions[0].channel, planned);
+
+    host.remove(&chan);
+    std::cout << "Exiting ChanPlanPlugin test" << std::endl;
+}
@@ -47,14 +47,6 @@ protected:
     }
 
     void TearDown() override {	
-        if (orch->m_pending) {
-            queue_destroy(orch->m_pending);
-            orch->m_pending = nullptr;
-        }
-        if (orch->m_active) {
-            queue_destroy(orch->m_active);
-            orch->m_active = nullptr;
-        }
         if (orch->m_cmd_map) {
             hash_map_destroy(orch->m_cmd_map);
             orch->m_cmd_map = nullptr;
@@ -237,14 +229,6 @@ TEST_F(EmOrchTest, VerifyDefaultConstructionSingle) {
     std::cout << "Invoking default constructor using the fixture object 'orch'" << std::endl;
     EXPECT_NO_THROW({
         Dummy_em_orch_t *obj = new Dummy_em_orch_t();
-        if (obj->m_pending) {
-            queue_destroy(obj->m_pending);
-            obj->m_pending = nullptr;
-        }
-        if (obj->m_active) {
-            queue_destroy(obj->m_active);
-            obj->m_active = nullptr;
-        }
         if (obj->m_cmd_map) {
             hash_map_destroy(obj->m_cmd_map);
             obj->m_cmd_map = nullptr;
@@ -977,14 +961,6 @@ TEST_F(EmOrchTest, em_orch_t_destructor_start) {
     std::cout << "Invoking destructor for em_orch_t instance" << std::endl;
     EXPECT_NO_THROW({
         Dummy_em_orch_t *obj = new Dummy_em_orch_t();
-        if (obj->m_pending) {
-            queue_destroy(obj->m_pending);
-            obj->m_pending = nullptr;
-        }
-        if (obj->m_active) {
-            queue_destroy(obj->m_active);
-            obj->m_active = nullptr;
-        }
         if (obj->m_cmd_map) {
             hash_map_destroy(obj->m_cmd_map);
             obj->m_cmd_map = nullptr;
@@ -994,4 +970,389 @@ TEST_F(EmOrchTest, em_orch_t_destructor_start) {
     });
     std::cout << "Destructor invoked successfully; resources cleaned up if allocated." << std::endl;    
     std::cout << "Exiting em_orch_t_destructor_start test" << std::endl;
-}
\ No newline at end of file
+}
+class Indexing_em_orch_t : public Dummy_em_orch_t {
+public:
+    em_t *m_candidate;
+    unsigned int build_candidates(em_cmd_t *cmd) override {
+        queue_push(cmd->m_em_candidates, m_candidate);
+        return 1;
+    }
+};
+
+/**
+ * @brief Verify that submitted commands are reachable through the per type and per em_t indexes.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 028@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :--------------: | ----------- | --------- | --------------- | ----- |
+ * | 01 | Submit two set_ssid commands and one set_radio command targeting the same em | None | Type counts are 2 and 1, the em is candidate of 3 commands | Should Pass |
+ * | 02 | Cancel the set_ssid commands | type = em_cmd_type_set_ssid | Only the set_radio command is left pending and indexed | Should Pass |
+ * | 03 | Cancel the set_radio command | type = em_cmd_type_set_radio | No command is left | Should Pass |
+ */
+TEST(em_orch_t_IndexTest, TypeAndEmIndexes) {
+    std::cout << "Entering TypeAndEmIndexes test" << std::endl;
+    em_interface_t ruid{};
+    strncpy(ruid.name, "Validname", sizeof(ruid.name));
+    unsigned char mac[6] = {0x1A, 0x1B, 0x2C, 0x3D, 0x4E, 0x5A};
+    memcpy(ruid.mac, mac, sizeof(mac));
+    dm_easy_mesh_t dm;
+    em_ctrl_t mgr;
+    em_t em(&ruid, em_freq_band_5, &dm, &mgr, em_profile_type_1, em_service_type_ctrl, false);
+    Indexing_em_orch_t orch;
+    orch.m_mgr = NULL;
+    orch.m_candidate = &em;
+    em_cmd_params_t param{};
+    em_cmd_t *cmds[4];
+
+    ASSERT_TRUE(orch.submit_command(new em_cmd_t(em_cmd_type_set_ssid, param, dm)));
+    ASSERT_TRUE(orch.submit_command(new em_cmd_t(em_cmd_type_set_ssid, param, dm)));
+    em_cmd_t *radio = new em_cmd_t(em_cmd_type_set_radio, param, dm);
+    ASSERT_TRUE(orch.submit_command(radio));
+    EXPECT_EQ(orch.get_cmd_count(em_cmd_type_set_ssid), 2u);
+    EXPECT_EQ(orch.get_cmd_count(em_cmd_type_set_radio), 1u);
+    EXPECT_EQ(orch.get_cmds_for_em(&em, cmds, 4), 3u);
+    EXPECT_EQ(orch.get_num_pending(), 3u);
+
+    orch.cancel_command(em_cmd_type_set_ssid);
+    EXPECT_EQ(orch.get_cmd_count(em_cmd_type_set_ssid), 0u);
+    EXPECT_EQ(orch.get_num_pending(), 1u);
+    ASSERT_EQ(orch.get_cmds_for_em(&em, cmds, 4), 1u);
+    EXPECT_EQ(cmds[0], radio);
+    EXPECT_TRUE(orch.get_dev_test_status());
+
+    orch.cancel_command(em_cmd_type_set_radio);
+    EXPECT_EQ(orch.get_cmd_count(em_cmd_type_set_radio), 0u);
+    EXPECT_EQ(orch.get_num_pending(), 0u);
+    EXPECT_EQ(orch.get_cmds_for_em(&em, cmds, 4), 0u);
+    EXPECT_FALSE(orch.get_dev_test_status());
+    hash_map_destroy(orch.m_cmd_map);
+    orch.m_cmd_map = nullptr;
+    std::cout << "Exiting TypeAndEmIndexes test" << std::endl;
+}
+
+// queues a OneWifi subdoc event the way the bus callback does
+static em_event_t *alloc_subdoc_event(em_mgr_t *mgr, em_bus_event_type_t type, const char *subdoc)
+{
+    em_event_t *evt;
+    unsigned int len = static_cast<unsigned int>(strlen(subdoc));
+
+    evt = mgr->alloc_event(len);
+    evt->type = em_event_type_bus;
+    evt->u.bevt.type = type;
+    evt->u.bevt.data_len = len;
+    memcpy(evt->u.bevt.u.raw_buff, subdoc, len);
+
+    return evt;
+}
+
+/**
+ * @brief Verify that updates deferred behind a command in progress are coalesced and handled once it finished.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 029@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :--------------: | ----------- | --------- | --------------- | ----- |
+ * | 01 | Submit a onewifi_cb command | None | A private subdoc event is reported in progress | Should Pass |
+ * | 02 | Defer two Vap_5G updates and one Vap_2.4G update | None | Two events are held, one was replaced | Should Pass |
+ * | 03 | Run the orchestrator with the command still pending | None | Nothing is handled | Should Pass |
+ * | 04 | Cancel the command and run the orchestrator | type = em_cmd_type_onewifi_cb | Both held events are handled and released | Should Pass |
+ * | 05 | Defer updates with 17 different keys | None | The last one does not fit, the others are dropped with clear_deferred | Should Pass |
+ */
+TEST(em_orch_t_DeferTest, LatestWins) {
+    std::cout << "Entering LatestWins test" << std::endl;
+    em_interface_t ruid{};
+    strncpy(ruid.name, "Validname", sizeof(ruid.name));
+    unsigned char mac[6] = {0x1A, 0x1B, 0x2C, 0x3D, 0x4E, 0x5A};
+    memcpy(ruid.mac, mac, sizeof(mac));
+    dm_easy_mesh_t dm;
+    em_ctrl_t mgr;
+    em_t em(&ruid, em_freq_band_5, &dm, &mgr, em_profile_type_1, em_service_type_ctrl, false);
+    Indexing_em_orch_t orch;
+    orch.m_mgr = &mgr;
+    orch.m_candidate = &em;
+    em_cmd_params_t param{};
+    em_event_t *evt;
+    char key[16];
+    unsigned int i;
+
+    ASSERT_TRUE(orch.submit_command(new em_cmd_t(em_cmd_type_onewifi_cb, param, dm)));
+    // keep the command pending
+    em.set_orch_state(em_orch_state_progress);
+
+    evt = alloc_subdoc_event(&mgr, em_bus_event_type_onewifi_private_cb, "{\"SubDocName\":\"Vap_5G\",\"Version\":1}");
+    EXPECT_TRUE(orch.is_cmd_type_in_progress(&evt->u.bevt));
+    EXPECT_TRUE(orch.defer_event(&evt->u.bevt, "Vap_5G"));
+    mgr.free_event(evt);
+    evt = alloc_subdoc_event(&mgr, em_bus_event_type_onewifi_private_cb, "{\"SubDocName\":\"Vap_5G\",\"Version\":2}");
+    EXPECT_TRUE(orch.defer_event(&evt->u.bevt, "Vap_5G"));
+    mgr.free_event(evt);
+    evt = alloc_subdoc_event(&mgr, em_bus_event_type_onewifi_private_cb, "{\"SubDocName\":\"Vap_2.4G\",\"Version\":1}");
+    EXPECT_TRUE(orch.defer_event(&evt->u.bevt, "Vap_2.4G"));
+    mgr.free_event(evt);
+    EXPECT_EQ(orch.get_num_deferred(), 2u);
+    EXPECT_EQ(orch.get_deferred_replaced(), 1u);
+
+    orch.handle_timeout();
+    EXPECT_EQ(orch.get_num_deferred(), 2u);
+
+    orch.cancel_command(em_cmd_type_onewifi_cb);
+    em.set_orch_state(em_orch_state_idle);
+    orch.handle_timeout();
+    EXPECT_EQ(orch.get_num_deferred(), 0u);
+
+    evt = alloc_subdoc_event(&mgr, em_bus_event_type_onewifi_radio_cb, "{\"SubDocName\":\"radio\"}");
+    for (i = 0; i < EM_ORCH_MAX_DEFERRED; i++) {
+        snprintf(key, sizeof(key), "radio_%u", i);
+        EXPECT_TRUE(orch.defer_event(&evt->u.bevt, key));
+    }
+    EXPECT_FALSE(orch.defer_event(&evt->u.bevt, "radio"));
+    mgr.free_event(evt);
+    EXPECT_EQ(orch.get_num_deferred(), EM_ORCH_MAX_DEFERRED);
+    orch.clear_deferred();
+    EXPECT_EQ(orch.get_num_deferred(), 0u);
+
+    hash_map_destroy(orch.m_cmd_map);
+    orch.m_cmd_map = nullptr;
+    std::cout << "Exiting LatestWins test" << std::endl;
+}
+
+class Partition_em_orch_t : public Dummy_em_orch_t {
+public:
+    em_t *m_candidates[4];
+    unsigned int m_num_candidates;
+    unsigned int build_candidates(em_cmd_t *cmd) override {
+        for (unsigned int i = 0; i < m_num_candidates; i++) {
+            queue_push(cmd->m_em_candidates, m_candidates[i]);
+        }
+        return m_num_candidates;
+    }
+};
+
+/**
+ * @brief Verify that commands are split per agent and that the active slots are shared fairly between the agents.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 030@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :--------------: | ----------- | --------- | --------------- | ----- |
+ * | 01 | Submit a set_ssid command targeting two radios of agent 1 and one radio of agent 2 | None | Two commands are pending, one per agent | Should Pass |
+ * | 02 | Cancel it, submit two commands for agent 1 then one for agent 2, with at most 2 active | max_active = 2 | One command of each agent is promoted | Should Pass |
+ * | 03 | Finish the two active commands | None | The second command of agent 1 is promoted | Should Pass |
+ * | 04 | Finish it | None | No command is left | Should Pass |
+ */
+TEST(em_orch_t_PartitionTest, PerAgentFairness) {
+    std::cout << "Entering PerAgentFairness test" << std::endl;
+    em_interface_t ruid1a{}, ruid1b{}, ruid2{};
+    unsigned char al1[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+    unsigned char al2[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02};
+    ruid1a.mac[5] = 0x1a;
+    ruid1b.mac[5] = 0x1b;
+    ruid2.mac[5] = 0x2a;
+    dm_easy_mesh_t dm1, dm2;
+    memcpy(dm1.get_device()->m_device_info.intf.mac, al1, sizeof(al1));
+    memcpy(dm2.get_device()->m_device_info.intf.mac, al2, sizeof(al2));
+    em_ctrl_t mgr;
+    em_t em1a(&ruid1a, em_freq_band_24, &dm1, &mgr, em_profile_type_1, em_service_type_ctrl, false);
+    em_t em1b(&ruid1b, em_freq_band_5, &dm1, &mgr, em_profile_type_1, em_service_type_ctrl, false);
+    em_t em2(&ruid2, em_freq_band_5, &dm2, &mgr, em_profile_type_1, em_service_type_ctrl, false);
+    Partition_em_orch_t orch;
+    orch.m_mgr = NULL;
+    orch.set_partition_by_agent(true);
+    em_cmd_params_t param{};
+    em_cmd_t *cmds[4], *first, *second, *third;
+
+    orch.m_candidates[0] = &em1a;
+    orch.m_candidates[1] = &em2;
+    orch.m_candidates[2] = &em1b;
+    orch.m_num_candidates = 3;
+    first = new em_cmd_t(em_cmd_type_set_ssid, param, dm1);
+    ASSERT_TRUE(orch.submit_command(first));
+    EXPECT_EQ(orch.get_num_pending(), 2u);
+    EXPECT_EQ(orch.get_cmd_count(em_cmd_type_set_ssid), 2u);
+    EXPECT_EQ(first->m_num_em_links, 2u);
+    ASSERT_EQ(orch.get_cmds_for_em(&em1b, cmds, 4), 1u);
+    EXPECT_EQ(cmds[0], first);
+    ASSERT_EQ(orch.get_cmds_for_em(&em2, cmds, 4), 1u);
+    EXPECT_NE(cmds[0], first);
+    EXPECT_EQ(cmds[0]->m_num_em_links, 1u);
+    orch.cancel_command(em_cmd_type_set_ssid);
+    EXPECT_EQ(orch.get_num_pending(), 0u);
+
+    orch.set_max_active(2);
+    orch.m_num_candidates = 1;
+    orch.m_candidates[0] = &em1a;
+    first = new em_cmd_t(em_cmd_type_set_ssid, param, dm1);
+    ASSERT_TRUE(orch.submit_command(first));
+    orch.m_candidates[0] = &em1b;
+    second = new em_cmd_t(em_cmd_type_set_ssid, param, dm1);
+    ASSERT_TRUE(orch.submit_command(second));
+    orch.m_candidates[0] = &em2;
+    third = new em_cmd_t(em_cmd_type_set_ssid, param, dm2);
+    ASSERT_TRUE(orch.submit_command(third));
+    EXPECT_EQ(orch.promote_pending(), 2u);
+    EXPECT_EQ(first->m_orch_list, &orch.m_active);
+    EXPECT_EQ(second->m_orch_list, &orch.m_pending[em_cmd_prio_config]);
+    EXPECT_EQ(third->m_orch_list, &orch.m_active);
+
+    em1a.set_orch_state(em_orch_state_fini);
+    em2.set_orch_state(em_orch_state_fini);
+    EXPECT_EQ(orch.process_active(), 2u);
+    EXPECT_EQ(orch.promote_pending(), 1u);
+    EXPECT_EQ(second->m_orch_list, &orch.m_active);
+    em1b.set_orch_state(em_orch_state_fini);
+    EXPECT_EQ(orch.process_active(), 1u);
+    EXPECT_EQ(orch.get_cmd_count(em_cmd_type_set_ssid), 0u);
+    hash_map_destroy(orch.m_cmd_map);
+    orch.m_cmd_map = nullptr;
+    std::cout << "Exiting PerAgentFairness test" << std::endl;
+}
+
+/**
+ * @brief Verify that a command whose steps run in place goes through its steps without clones.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 031@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :--------------: | ----------- | --------- | --------------- | ----- |
+ * | 01 | Build a command of three steps running in place | None | clone_for_next returns NULL | Should Pass |
+ * | 02 | Submit it and promote it | None | The command is active on its first step | Should Pass |
+ * | 03 | Finish the first two steps | None | The command stays active and moves to the next step, the em is pending again | Should Pass |
+ * | 04 | Finish the last step | None | The command is destroyed | Should Pass |
+ */
+TEST(em_orch_t_InPlaceTest, StepCursor) {
+    std::cout << "Entering StepCursor test" << std::endl;
+    em_interface_t ruid{};
+    ruid.mac[5] = 0x1a;
+    dm_easy_mesh_t dm;
+    em_ctrl_t mgr;
+    em_t em(&ruid, em_freq_band_5, &dm, &mgr, em_profile_type_1, em_service_type_ctrl, false);
+    Indexing_em_orch_t orch;
+    orch.m_mgr = NULL;
+    orch.m_candidate = &em;
+    em_cmd_params_t param{};
+    em_cmd_t *pcmd = new em_cmd_t(em_cmd_type_set_channel, param, dm);
+    unsigned int step;
+
+    pcmd->m_orch_in_place = true;
+    pcmd->m_num_orch_desc = 3;
+    pcmd->set_orch_op_index(0);
+    pcmd->m_orch_desc[0].op = dm_orch_type_channel_pref;
+    pcmd->m_orch_desc[1].op = dm_orch_type_channel_sel;
+    pcmd->m_orch_desc[2].op = dm_orch_type_channel_cnf;
+    EXPECT_EQ(pcmd->clone_for_next(), nullptr);
+
+    ASSERT_TRUE(orch.submit_command(pcmd));
+    EXPECT_EQ(orch.promote_pending(), 1u);
+    EXPECT_EQ(pcmd->m_orch_list, &orch.m_active);
+
+    for (step = 1; step < 3; step++) {
+        em.set_orch_state(em_orch_state_fini);
+        EXPECT_EQ(orch.process_active(), 1u);
+        EXPECT_EQ(pcmd->m_orch_list, &orch.m_active);
+        EXPECT_EQ(pcmd->get_orch_op(), pcmd->m_orch_desc[step].op);
+        EXPECT_EQ(pcmd->get_cmd_ctx()->type, pcmd->m_orch_desc[step].op);
+        EXPECT_EQ(em.get_orch_state(), em_orch_state_pending);
+    }
+
+    em.set_orch_state(em_orch_state_fini);
+    EXPECT_EQ(orch.process_active(), 1u);
+    EXPECT_EQ(orch.m_active.count, 0u);
+    EXPECT_EQ(orch.get_cmd_count(em_cmd_type_set_channel), 0u);
+    EXPECT_EQ(em.get_orch_state(), em_orch_state_idle);
+    hash_map_destroy(orch.m_cmd_map);
+    orch.m_cmd_map = nullptr;
+    std::cout << "Exiting StepCursor test" << std::endl;
+}
+
+/**
+ * @brief Verify that interactive commands are promoted ahead of background ones and that background admission is limited.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 032@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :--------------: | ----------- | --------- | --------------- | ----- |
+ * | 01 | Limit the background class to one pending command, submit two scans then a steer on the same em | max_pending = 1 | The second scan is rejected | Should Pass |
+ * | 02 | Promote the pending commands | None | The steer gets the em, the scan waits | Should Pass |
+ * | 03 | Finish the steer and promote again | None | The scan is promoted, both classes recorded a wait | Should Pass |
+ */
+TEST(em_orch_t_PriorityTest, InteractiveFirst) {
+    std::cout << "Entering InteractiveFirst test" << std::endl;
+    em_interface_t ruid{};
+    ruid.mac[5] = 0x1a;
+    dm_easy_mesh_t dm;
+    em_ctrl_t mgr;
+    em_t em(&ruid, em_freq_band_5, &dm, &mgr, em_profile_type_1, em_service_type_ctrl, false);
+    Indexing_em_orch_t orch;
+    orch.m_mgr = NULL;
+    orch.m_candidate = &em;
+    em_cmd_params_t param{};
+    em_cmd_t *scan, *steer;
+
+    EXPECT_EQ(em_cmd_t::get_cmd_prio(em_cmd_type_sta_steer), em_cmd_prio_interactive);
+    EXPECT_EQ(em_cmd_t::get_cmd_prio(em_cmd_type_em_config), em_cmd_prio_config);
+    EXPECT_EQ(em_cmd_t::get_cmd_prio(em_cmd_type_scan_channel), em_cmd_prio_background);
+
+    orch.set_class_limits(em_cmd_prio_background, 1, 0);
+    scan = new em_cmd_t(em_cmd_type_scan_channel, param, dm);
+    ASSERT_TRUE(orch.submit_command(scan));
+    EXPECT_FALSE(orch.submit_command(new em_cmd_t(em_cmd_type_scan_channel, param, dm)));
+    EXPECT_EQ(orch.get_class_rejected(em_cmd_prio_background), 1u);
+    steer = new em_cmd_t(em_cmd_type_sta_steer, param, dm);
+    ASSERT_TRUE(orch.submit_command(steer));
+    EXPECT_EQ(orch.get_num_pending(), 2u);
+
+    EXPECT_EQ(orch.promote_pending(), 1u);
+    EXPECT_EQ(steer->m_orch_list, &orch.m_active);
+    EXPECT_EQ(scan->m_orch_list, &orch.m_pending[em_cmd_prio_background]);
+
+    em.set_orch_state(em_orch_state_fini);
+    EXPECT_EQ(orch.process_active(), 1u);
+    EXPECT_EQ(orch.promote_pending(), 1u);
+    EXPECT_EQ(scan->m_orch_list, &orch.m_active);
+    EXPECT_EQ(orch.get_class_wait(em_cmd_prio_interactive)->get_count(), 1u);
+    EXPECT_EQ(orch.get_class_wait(em_cmd_prio_background)->get_count(), 1u);
+
+    em.set_orch_state(em_orch_state_fini);
+    EXPECT_EQ(orch.process_active(), 1u);
+    EXPECT_EQ(orch.m_active.count, 0u);
+    hash_map_destroy(orch.m_cmd_map);
+    orch.m_cmd_map = nullptr;
+    std::cout << "Exiting InteractiveFirst test" << std::endl;
+}
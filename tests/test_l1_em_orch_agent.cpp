@@ -36,8 +36,6 @@ public:
     }
     void TearDown() override {
 	    hash_map_destroy(orch->m_mgr->m_em_map);
-	    queue_destroy(orch->m_pending);
-	    queue_destroy(orch->m_active);
 	    hash_map_destroy(orch->m_cmd_map);
         delete orch;
     }
@@ -1002,8 +1000,6 @@ TEST_F(em_orch_agent_t_TEST, em_orch_agent_t_TEST_valid_manager)
     em_orch_agent_t *orchAgent{};
     std::cout << "Invoking em_orch_agent_t_TEST constructor with valid mgr object" << std::endl;
     EXPECT_NO_THROW(orchAgent = new em_orch_agent_t(&mgr));
-    queue_destroy(orchAgent->m_pending);
-    queue_destroy(orchAgent->m_active);
     hash_map_destroy(orchAgent->m_cmd_map);
     delete orchAgent;
     std::cout << "Exiting em_orch_agent_t_TEST_valid_manager test" << std::endl;
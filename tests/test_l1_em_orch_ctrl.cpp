@@ -35,8 +35,6 @@ public:
     }
     void TearDown() override {
 	    hash_map_destroy(orch->m_mgr->m_em_map);
-	    queue_destroy(orch->m_pending);
-	    queue_destroy(orch->m_active);
 	    hash_map_destroy(orch->m_cmd_map);
         delete orch;
     }
@@ -1002,8 +1000,6 @@ TEST_F(em_orch_ctrl_t_TEST, em_orch_ctrl_t_TEST_valid_manager)
     em_orch_ctrl_t *orchCtrl;
     std::cout << "Invoking em_orch_ctrl_t_TEST constructor with valid mgr object" << std::endl;
     EXPECT_NO_THROW(orchCtrl = new em_orch_ctrl_t(&mgr));
-    queue_destroy(orchCtrl->m_pending);
-    queue_destroy(orchCtrl->m_active);
     hash_map_destroy(orchCtrl->m_cmd_map);
     delete orchCtrl;
     std::cout << "Exiting em_orch_ctrl_t_TEST_valid_manager test" << std::endl;
@@ -0,0 +1,124 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+#include "em_perf.h"
+
+/**
+* @brief Test that counters and samples recorded by many threads are all summed up
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Count and record from more threads than there are shards | 40 threads, 1000 frames and samples each | 40000 frames and samples | Should Pass |
+* | 02| Read the sum and max of the samples | Samples of 10 us, one of 5000 us | Max 5000 us, mean about 10 us | Should Pass |
+*/
+TEST(em_perf_t_Test, ThreadsSummed) {
+    std::cout << "Entering ThreadsSummed test" << std::endl;
+    std::vector<std::thread> threads;
+    em_lat_hist_t hist;
+    em_perf_t::reset();
+    for (unsigned int i = 0; i < 40; i++) {
+        threads.emplace_back([i]() {
+            for (unsigned int j = 0; j < 1000; j++) {
+                em_perf_t::inc(em_perf_ctr_frames_tx);
+                em_perf_t::inc(em_perf_ctr_bytes_tx, 100);
+                em_perf_t::record(em_perf_hist_send_frame, ((i == 7) && (j == 0)) ? 5000:10);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(em_perf_t::get_counter(em_perf_ctr_frames_tx), 40000u);
+    EXPECT_EQ(em_perf_t::get_counter(em_perf_ctr_bytes_tx), 4000000u);
+    EXPECT_EQ(em_perf_t::get_counter(em_perf_ctr_frames_rx), 0u);
+    em_perf_t::get_hist(em_perf_hist_send_frame, &hist);
+    EXPECT_EQ(hist.get_count(), 40000u);
+    EXPECT_EQ(hist.get_max_us(), 5000u);
+    EXPECT_LE(hist.get_percentile_us(50), 16u);
+    std::cout << "Exiting ThreadsSummed test" << std::endl;
+}
+
+/**
+* @brief Test the gauges, the encoded snapshot and the reset
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Set a gauge up then down | 12 then 3 | Value 3, max 12 | Should Pass |
+* | 02| Encode after counting and timing a scope | 5 db queries, one db scope | Totals, gauge and one db sample in the snapshot | Should Pass |
+* | 03| Reset | None | Every counter, gauge and histogram back to 0 | Should Pass |
+*/
+TEST(em_perf_t_Test, GaugesEncodeReset) {
+    std::cout << "Entering GaugesEncodeReset test" << std::endl;
+    cJSON *obj, *item;
+    em_lat_hist_t hist;
+    em_perf_t::reset();
+    em_perf_t::set_gauge(em_perf_gauge_mgr_queue_depth, 12);
+    em_perf_t::set_gauge(em_perf_gauge_mgr_queue_depth, 3);
+    EXPECT_EQ(em_perf_t::get_gauge(em_perf_gauge_mgr_queue_depth), 3u);
+    EXPECT_EQ(em_perf_t::get_gauge_max(em_perf_gauge_mgr_queue_depth), 12u);
+
+    em_perf_t::inc(em_perf_ctr_db_queries, 5);
+    {
+        em_perf_scope_t scope(em_perf_hist_db_execute);
+    }
+    obj = cJSON_CreateObject();
+    em_perf_t::encode(obj);
+    item = cJSON_GetObjectItem(cJSON_GetObjectItem(obj, "Counters"), "DbQueries");
+    ASSERT_NE(item, nullptr);
+    EXPECT_EQ(cJSON_GetObjectItem(item, "Total")->valuedouble, 5);
+    item = cJSON_GetObjectItem(cJSON_GetObjectItem(obj, "Gauges"), "MgrQueueDepth");
+    ASSERT_NE(item, nullptr);
+    EXPECT_EQ(cJSON_GetObjectItem(item, "Value")->valuedouble, 3);
+    EXPECT_EQ(cJSON_GetObjectItem(item, "Max")->valuedouble, 12);
+    item = cJSON_GetObjectItem(cJSON_GetObjectItem(obj, "Latency"), "DbExecute");
+    ASSERT_NE(item, nullptr);
+    EXPECT_EQ(cJSON_GetObjectItem(item, "Count")->valuedouble, 1);
+    cJSON_Delete(obj);
+
+    em_perf_t::reset();
+    EXPECT_EQ(em_perf_t::get_counter(em_perf_ctr_db_queries), 0u);
+    EXPECT_EQ(em_perf_t::get_gauge_max(em_perf_gauge_mgr_queue_depth), 0u);
+    em_perf_t::get_hist(em_perf_hist_db_execute, &hist);
+    EXPECT_EQ(hist.get_count(), 0u);
+    EXPECT_STREQ(em_perf_t::get_counter_str(em_perf_ctr_max), "unknown");
+    EXPECT_STREQ(em_perf_t::get_hist_str(em_perf_hist_tr181_get), "Tr181Get");
+    std::cout << "Exiting GaugesEncodeReset test" << std::endl;
+}
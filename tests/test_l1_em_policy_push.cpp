@@ -0,0 +1,246 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include "em_policy_push.h"
+#include "test_l1_utils.h"
+
+/**
+* @brief Test the reuse of a cached encoding with the radio unique identifiers patched
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Lookup of a policy set not cached | key 1 | 0 returned | Should Pass |
+* | 02| Encoding of radio 1 cached, looked up for radio 2 | ruid at 4 and 20 | Same TLVs with the ruid of radio 2 | Should Pass |
+* | 03| Lookup with a buffer too small | 10 bytes | 0 returned | Should Pass |
+* | 04| Encoding with a ruid past its end | offset 28 of 32 | Rejected | Should Pass |
+*/
+TEST(em_policy_push_t_Test, EncodingReuse) {
+    std::cout << "Entering EncodingReuse test" << std::endl;
+    em_policy_push_t push;
+    unsigned char tlvs[32], buff[64], expected[32], radio1[6], radio2[6];
+    unsigned short ruid_off[2] = {4, 20}, bad_off[1] = {28};
+    unsigned int i;
+
+    make_mac(1, radio1);
+    make_mac(2, radio2);
+    for (i = 0; i < sizeof(tlvs); i++) {
+        tlvs[i] = static_cast<unsigned char>(i);
+    }
+    memcpy(tlvs + 4, radio1, sizeof(mac_address_t));
+    memcpy(tlvs + 20, radio1, sizeof(mac_address_t));
+
+    EXPECT_EQ(push.get_encoding(1, radio2, buff, sizeof(buff)), 0u);
+    EXPECT_EQ(push.put_encoding(1, tlvs, sizeof(tlvs), ruid_off, 2), 0);
+
+    memcpy(expected, tlvs, sizeof(tlvs));
+    memcpy(expected + 4, radio2, sizeof(mac_address_t));
+    memcpy(expected + 20, radio2, sizeof(mac_address_t));
+    ASSERT_EQ(push.get_encoding(1, radio2, buff, sizeof(buff)), sizeof(tlvs));
+    EXPECT_EQ(memcmp(buff, expected, sizeof(expected)), 0);
+    EXPECT_EQ(push.get_encoding(1, radio2, buff, 10), 0u);
+
+    EXPECT_EQ(push.put_encoding(2, tlvs, sizeof(tlvs), bad_off, 1), -1);
+    EXPECT_EQ(push.get_encoding(2, radio2, buff, sizeof(buff)), 0u);
+    EXPECT_EQ(push.get_stats().encoded, 1u);
+    EXPECT_EQ(push.get_stats().reused, 1u);
+    std::cout << "Exiting EncodingReuse test" << std::endl;
+}
+
+/**
+* @brief Test the replacement of the least recently used encoding
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Cache full, the first key looked up again | EM_POLICY_PUSH_MAX_ENCODINGS keys | All cached | Should Pass |
+* | 02| One more key cached | key EM_POLICY_PUSH_MAX_ENCODINGS | Second key dropped, first kept | Should Pass |
+* | 03| Key cached again with new TLVs | key 0 | New TLVs returned | Should Pass |
+*/
+TEST(em_policy_push_t_Test, LeastRecentlyUsed) {
+    std::cout << "Entering LeastRecentlyUsed test" << std::endl;
+    em_policy_push_t push;
+    unsigned char tlvs[8] = {1, 2, 3, 4, 5, 6, 7, 8}, buff[16], radio[6];
+    unsigned int i;
+
+    make_mac(1, radio);
+    for (i = 0; i < EM_POLICY_PUSH_MAX_ENCODINGS; i++) {
+        EXPECT_EQ(push.put_encoding(i, tlvs, sizeof(tlvs), NULL, 0), 0);
+    }
+    EXPECT_EQ(push.get_encoding(0, radio, buff, sizeof(buff)), sizeof(tlvs));
+
+    EXPECT_EQ(push.put_encoding(EM_POLICY_PUSH_MAX_ENCODINGS, tlvs, sizeof(tlvs), NULL, 0), 0);
+    EXPECT_EQ(push.get_encoding(1, radio, buff, sizeof(buff)), 0u);
+    EXPECT_EQ(push.get_encoding(0, radio, buff, sizeof(buff)), sizeof(tlvs));
+    EXPECT_EQ(push.get_encoding(EM_POLICY_PUSH_MAX_ENCODINGS, radio, buff, sizeof(buff)), sizeof(tlvs));
+
+    tlvs[0] = 9;
+    EXPECT_EQ(push.put_encoding(0, tlvs, 4, NULL, 0), 0);
+    ASSERT_EQ(push.get_encoding(0, radio, buff, sizeof(buff)), 4u);
+    EXPECT_EQ(buff[0], 9);
+    std::cout << "Exiting LeastRecentlyUsed test" << std::endl;
+}
+
+/**
+* @brief Test the matching of the 1905 ACKs of several agents to their requests
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Requests to two agents, two radios each | msg ids 10 to 13 | 4 pending, 2 per agent | Should Pass |
+* | 02| ACK of a request of the other agent | agent 2, msg id 10 | Not matched | Should Pass |
+* | 03| ACKs of the requests, one twice | 150 ms slowest | Matched once each, none pending | Should Pass |
+*/
+TEST(em_policy_push_t_Test, AckMatching) {
+    std::cout << "Entering AckMatching test" << std::endl;
+    em_policy_push_t push;
+    em_policy_push_stats_t stats;
+    unsigned char agent1[6], agent2[6];
+
+    make_mac(1, agent1);
+    make_mac(2, agent2);
+    push.sent(agent1, 10, 1000);
+    push.sent(agent1, 11, 1000);
+    push.sent(agent2, 12, 1000);
+    push.sent(agent2, 13, 1000);
+    EXPECT_EQ(push.pending(), 4u);
+    EXPECT_EQ(push.pending(agent1), 2u);
+    EXPECT_EQ(push.pending(agent2), 2u);
+
+    EXPECT_FALSE(push.ack(agent2, 10, 1050));
+    EXPECT_TRUE(push.ack(agent1, 10, 1050));
+    EXPECT_FALSE(push.ack(agent1, 10, 1060));
+    EXPECT_TRUE(push.ack(agent2, 13, 1100));
+    EXPECT_TRUE(push.ack(agent1, 11, 1150));
+    EXPECT_TRUE(push.ack(agent2, 12, 1020));
+    EXPECT_EQ(push.pending(), 0u);
+
+    stats = push.get_stats();
+    EXPECT_EQ(stats.sent, 4u);
+    EXPECT_EQ(stats.acked, 4u);
+    EXPECT_EQ(stats.expired, 0u);
+    EXPECT_EQ(stats.max_ack_ms, 150u);
+    std::cout << "Exiting AckMatching test" << std::endl;
+}
+
+/**
+* @brief Test the expiry of the requests without ACK
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Requests sent at 0 and 3000 ms, expired at 5000 ms | EM_POLICY_PUSH_TIMEOUT_MS | First expired, its late ACK not matched | Should Pass |
+* | 02| More requests than EM_POLICY_PUSH_MAX_PENDING | One agent | Oldest dropped, table bounded | Should Pass |
+*/
+TEST(em_policy_push_t_Test, Expiry) {
+    std::cout << "Entering Expiry test" << std::endl;
+    em_policy_push_t push;
+    unsigned char agent[6];
+    unsigned int i;
+
+    make_mac(1, agent);
+    push.sent(agent, 1, 0);
+    push.sent(agent, 2, 3000);
+    EXPECT_EQ(push.expire(4999), 0u);
+    EXPECT_EQ(push.expire(EM_POLICY_PUSH_TIMEOUT_MS), 1u);
+    EXPECT_FALSE(push.ack(agent, 1, 5100));
+    EXPECT_TRUE(push.ack(agent, 2, 5100));
+
+    for (i = 0; i <= EM_POLICY_PUSH_MAX_PENDING; i++) {
+        push.sent(agent, static_cast<unsigned short>(100 + i), 6000 + i);
+    }
+    EXPECT_EQ(push.pending(), static_cast<unsigned int>(EM_POLICY_PUSH_MAX_PENDING));
+    EXPECT_FALSE(push.ack(agent, 100, 7000));
+    EXPECT_TRUE(push.ack(agent, 101, 7000));
+    EXPECT_EQ(push.get_stats().expired, 2u);
+    std::cout << "Exiting Expiry test" << std::endl;
+}
+
+/**
+* @brief Test that a policy change drops the cached encodings
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 005@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Two policy sets cached, encodings cleared | keys 1 and 2 | 2 dropped, neither found | Should Pass |
+* | 02| Encodings cleared again | Empty cache | 0 dropped | Should Pass |
+* | 03| Policy set cached again | key 1 | Found | Should Pass |
+*/
+TEST(em_policy_push_t_Test, ClearEncodings) {
+    std::cout << "Entering ClearEncodings test" << std::endl;
+    em_policy_push_t push;
+    unsigned char tlvs[16], buff[16], radio[6];
+
+    make_mac(1, radio);
+    memset(tlvs, 0x5a, sizeof(tlvs));
+    EXPECT_EQ(push.put_encoding(1, tlvs, sizeof(tlvs), NULL, 0), 0);
+    EXPECT_EQ(push.put_encoding(2, tlvs, sizeof(tlvs), NULL, 0), 0);
+    EXPECT_EQ(push.clear_encodings(), 2u);
+    EXPECT_EQ(push.get_encoding(1, radio, buff, sizeof(buff)), 0u);
+    EXPECT_EQ(push.get_encoding(2, radio, buff, sizeof(buff)), 0u);
+    EXPECT_EQ(push.clear_encodings(), 0u);
+
+    EXPECT_EQ(push.put_encoding(1, tlvs, sizeof(tlvs), NULL, 0), 0);
+    EXPECT_EQ(push.get_encoding(1, radio, buff, sizeof(buff)), sizeof(tlvs));
+    EXPECT_EQ(push.get_stats().cleared, 2u);
+    std::cout << "Exiting ClearEncodings test" << std::endl;
+}
@@ -0,0 +1,168 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "em_profile.h"
+
+static const char *test_name_fn(em_profile_domain_t domain, unsigned int type)
+{
+    return ((domain == em_profile_domain_bus) && (type == 3)) ? "bus_three":NULL;
+}
+
+/**
+* @brief Test that the types with the most CPU time come first
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Record events of several domains | bus 3: 2 x 5 ms, CMDU 0x8002: 1 x 20 ms, event 1: 1 x 1 ms, bus 500 | CMDU, bus 3, event 1 in that order | Should Pass |
+* | 02| Ask for fewer entries than types | n = 2 | 2 entries | Should Pass |
+* | 03| Record a type beyond the table | bus 500 | Counted in the last bus slot | Should Pass |
+*/
+TEST(em_profile_t_Test, TopN) {
+    std::cout << "Entering TopN test" << std::endl;
+    em_profile_entry_t entries[8];
+    em_profile_t::reset();
+    em_profile_t::record(em_profile_domain_bus, 3, 5000000, 10, 1000);
+    em_profile_t::record(em_profile_domain_bus, 3, 5000000, 30, 3000);
+    em_profile_t::record(em_profile_domain_cmdu, 0x8002, 20000000, 1, 100);
+    em_profile_t::record(em_profile_domain_event, 1, 1000000, 0, 0);
+    em_profile_t::record(em_profile_domain_bus, 500, 1000, 0, 0);
+
+    ASSERT_EQ(em_profile_t::get_top(entries, 8), 4u);
+    EXPECT_EQ(entries[0].domain, em_profile_domain_cmdu);
+    EXPECT_EQ(entries[0].type, 0x8002u);
+    EXPECT_EQ(entries[1].domain, em_profile_domain_bus);
+    EXPECT_EQ(entries[1].type, 3u);
+    EXPECT_EQ(entries[1].count, 2u);
+    EXPECT_EQ(entries[1].cpu_ns, 10000000u);
+    EXPECT_EQ(entries[1].max_cpu_ns, 5000000u);
+    EXPECT_EQ(entries[1].allocs, 40u);
+    EXPECT_EQ(entries[1].alloc_bytes, 4000u);
+    EXPECT_EQ(entries[2].domain, em_profile_domain_event);
+    EXPECT_EQ(entries[3].type, static_cast<unsigned int>(EM_PROFILE_MAX_TYPES - 1));
+
+    EXPECT_EQ(em_profile_t::get_top(entries, 2), 2u);
+    EXPECT_EQ(entries[1].type, 3u);
+    std::cout << "Exiting TopN test" << std::endl;
+}
+
+/**
+* @brief Test the encoded profile and the names of its types
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Encode with a name function | bus 3 named, CMDU 0x8002 and an unknown CMDU type not | "bus_three", "0x8002" and "Other" | Should Pass |
+* | 02| Read the fields of an entry | bus 3: 2 x 5 ms, 40 allocations | Count 2, CpuUs 10000, MeanCpuUs 5000, Allocs 40 | Should Pass |
+*/
+TEST(em_profile_t_Test, Encode) {
+    std::cout << "Entering Encode test" << std::endl;
+    cJSON *arr = cJSON_CreateArray(), *obj;
+    em_profile_t::reset();
+    em_profile_t::record(em_profile_domain_bus, 3, 5000000, 10, 1000);
+    em_profile_t::record(em_profile_domain_bus, 3, 5000000, 30, 3000);
+    em_profile_t::record(em_profile_domain_cmdu, 0x8002, 20000000, 1, 100);
+    em_profile_t::record(em_profile_domain_cmdu, 0x9000, 100, 0, 0);
+
+    em_profile_t::encode(arr, EM_PROFILE_TOP_N, test_name_fn);
+    ASSERT_EQ(cJSON_GetArraySize(arr), 3);
+    obj = cJSON_GetArrayItem(arr, 0);
+    EXPECT_STREQ(cJSON_GetObjectItem(obj, "Domain")->valuestring, "CMDU");
+    EXPECT_STREQ(cJSON_GetObjectItem(obj, "Type")->valuestring, "0x8002");
+    obj = cJSON_GetArrayItem(arr, 1);
+    EXPECT_STREQ(cJSON_GetObjectItem(obj, "Type")->valuestring, "bus_three");
+    EXPECT_EQ(cJSON_GetObjectItem(obj, "Count")->valuedouble, 2);
+    EXPECT_EQ(cJSON_GetObjectItem(obj, "CpuUs")->valuedouble, 10000);
+    EXPECT_EQ(cJSON_GetObjectItem(obj, "MeanCpuUs")->valuedouble, 5000);
+    EXPECT_EQ(cJSON_GetObjectItem(obj, "MaxCpuUs")->valuedouble, 5000);
+    EXPECT_EQ(cJSON_GetObjectItem(obj, "Allocs")->valuedouble, 40);
+    EXPECT_EQ(cJSON_GetObjectItem(obj, "AllocBytes")->valuedouble, 4000);
+    obj = cJSON_GetArrayItem(arr, 2);
+    EXPECT_STREQ(cJSON_GetObjectItem(obj, "Type")->valuestring, "Other");
+    cJSON_Delete(arr);
+    std::cout << "Exiting Encode test" << std::endl;
+}
+
+/**
+* @brief Test that a scope records the CPU time of the calling thread
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Spin and allocate in a scope | 2 ms of CPU, 5 allocations of 100 bytes | Count 1, at least 1 ms of CPU | Should Pass |
+* | 02| Read the allocations | - | At least 5 allocations and 500 bytes with EM_PROFILE, 0 without | Should Pass |
+*/
+TEST(em_profile_t_Test, Scope) {
+    std::cout << "Entering Scope test" << std::endl;
+    em_profile_entry_t entry;
+    void *ptrs[5];
+    uint64_t start;
+    em_profile_t::reset();
+    {
+        em_profile_scope_t scope(em_profile_domain_event, 2);
+        start = em_profile_t::get_thread_cpu_ns();
+        while ((em_profile_t::get_thread_cpu_ns() - start) < 2000000);
+        for (unsigned int i = 0; i < 5; i++) {
+            ptrs[i] = malloc(100);
+            memset(ptrs[i], 0, 100);
+        }
+        for (unsigned int i = 0; i < 5; i++) {
+            free(ptrs[i]);
+        }
+    }
+
+    ASSERT_EQ(em_profile_t::get_top(&entry, 1), 1u);
+    EXPECT_EQ(entry.count, 1u);
+    EXPECT_GE(entry.cpu_ns, 1000000u);
+#ifdef EM_PROFILE
+    EXPECT_GE(entry.allocs, 5u);
+    EXPECT_GE(entry.alloc_bytes, 500u);
+#else
+    EXPECT_EQ(entry.allocs, 0u);
+#endif
+    std::cout << "Exiting Scope test" << std::endl;
+}
@@ -24,6 +24,7 @@
 #include "ec_manager.h"
 #include "dm_easy_mesh.h"
 #include "em_provisioning.h"
+#include "ec_util.h"
 
 class MockEmMgr : public em_mgr_t {
 public:
@@ -69,6 +70,7 @@ public:
     using em_provisioning_t::create_cce_ind_msg;
     using em_provisioning_t::send_chirp_notif_msg;
     using em_provisioning_t::send_prox_encap_dpp_msg;
+    using em_provisioning_t::send_prox_encap_dpp_frame;
     using em_provisioning_t::send_direct_encap_dpp_msg;
     using em_provisioning_t::send_1905_eapol_encap_msg;
     using em_provisioning_t::send_1905_rekey_msg;
@@ -81,6 +83,8 @@ public:
     uint8_t* get_al_interface_mac() override { return mac_address; }
     uint8_t* get_radio_interface_mac() override { return nullptr; }	
     int send_frame(uint8_t *buff, unsigned int len, bool multicast = false) override { return 0; }
+    int send_frames(unsigned char **buffs, unsigned int *lens, unsigned int num, bool multicast = false) override { return static_cast<int>(num); }
+    em_tlv_writer_t* get_tlv_writer() override { return &writer; }
     int send_cmd(em_cmd_exec_t *exec, em_cmd_type_t type, em_service_type_t svc, uint8_t *buff, unsigned int len) override { return 0; }
     em_cmd_t* get_current_cmd() override { return nullptr; }
     dm_easy_mesh_t* get_data_model() override { return nullptr; }
@@ -90,6 +94,7 @@ public:
 
 private:
     MockEmMgr* mgr;
+    em_tlv_writer_t writer;
 };
 
 class EmProvisioningTest : public ::testing::Test {
@@ -1536,3 +1541,56 @@ TEST_F(EmProvisioningTest, send_prox_encap_dpp_msg_zero_chirp_len)
 
     std::cout << "Exiting send_prox_encap_dpp_msg_zero_chirp_len test" << std::endl;
 }
+
+/**
+ * @brief Validate that send_prox_encap_dpp_frame writes the same 1905 Encap DPP TLV as create_encap_dpp_tlv.
+ *
+ * This test sends a DPP frame with send_prox_encap_dpp_frame, which writes the Encap DPP TLV straight into the message, and compares the TLV of the message with the one that ec_util::create_encap_dpp_tlv allocates for the same frame.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 039@n
+ * **Priority:** High@n
+ * 
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ * 
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Invoke send_prox_encap_dpp_frame with a DPP frame and an enrollee MAC | frame = 40 bytes, dpp_frame_indicator = 1, frame_type = ec_frame_type_easymesh, dst_al_mac = {0x02, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E} | API returns the message length | Should Pass |
+ * | 02 | Compare the first TLV of the message with create_encap_dpp_tlv | TLV type 0xcd | Same length and value | Should Pass |
+ * | 03 | Invoke send_prox_encap_dpp_frame with an empty frame | frame = NULL, frame_len = 0 | API returns -1 | Should Fail |
+ */
+TEST_F(EmProvisioningTest, send_prox_encap_dpp_frame_writes_encap_tlv)
+{
+    std::cout << "Entering send_prox_encap_dpp_frame_writes_encap_tlv test" << std::endl;
+
+    uint8_t frame[40];
+    for (unsigned int i = 0; i < sizeof(frame); i++) {
+        frame[i] = static_cast<uint8_t>(i);
+    }
+    uint8_t enrollee_mac[ETH_ALEN] = {0x02, 0x01, 0x02, 0x03, 0x04, 0x05};
+    uint8_t dst_al_mac[ETH_ALEN] = {0x02, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E};
+
+    int ret = provisioning->send_prox_encap_dpp_frame(true, enrollee_mac, ec_frame_type_easymesh, frame, sizeof(frame), dst_al_mac);
+    std::cout << "send_prox_encap_dpp_frame returned: " << ret << std::endl;
+    EXPECT_GT(ret, 0);
+
+    auto [encap_dpp_tlv, encap_dpp_tlv_len] = ec_util::create_encap_dpp_tlv(true, enrollee_mac, ec_frame_type_easymesh, frame, sizeof(frame));
+    ASSERT_NE(encap_dpp_tlv, nullptr);
+
+    unsigned int len = 0;
+    uint8_t *msg = provisioning->get_tlv_writer()->get_frame(0, &len);
+    ASSERT_NE(msg, nullptr);
+    em_tlv_t *tlv = reinterpret_cast<em_tlv_t *>(msg + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t));
+    EXPECT_EQ(tlv->type, em_tlv_type_1905_encap_dpp);
+    EXPECT_EQ(ntohs(tlv->len), encap_dpp_tlv_len);
+    EXPECT_EQ(memcmp(tlv->value, encap_dpp_tlv, encap_dpp_tlv_len), 0);
+    EXPECT_EQ(static_cast<unsigned int>(ret), len);
+    free(encap_dpp_tlv);
+
+    EXPECT_EQ(provisioning->send_prox_encap_dpp_frame(true, enrollee_mac, ec_frame_type_easymesh, NULL, 0, dst_al_mac), -1);
+
+    std::cout << "Exiting send_prox_encap_dpp_frame_writes_encap_tlv test" << std::endl;
+}
@@ -0,0 +1,232 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include "em_renew_sched.h"
+
+static em_renew_sched_radio_t make_radio(unsigned char al, unsigned char radio, unsigned int hops)
+{
+    em_renew_sched_radio_t r;
+
+    memset(&r, 0, sizeof(r));
+    r.al_mac[0] = 0x02;
+    r.al_mac[5] = al;
+    r.ruid[0] = 0x04;
+    r.ruid[4] = al;
+    r.ruid[5] = radio;
+    r.hops = hops;
+
+    return r;
+}
+
+static em_renew_sched_state_t state_of(em_renew_sched_t& sched, const em_renew_sched_radio_t& r)
+{
+    em_renew_sched_entry_t entry;
+
+    memset(&entry, 0, sizeof(entry));
+    entry.state = em_renew_sched_failed;
+    EXPECT_TRUE(sched.get_entry(r.ruid, &entry));
+    return entry.state;
+}
+
+/**
+* @brief Test that the deepest agents start first and the shallower ones wait for them
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Plan agents at 1, 3 and 2 hops | no limits | 3 radios in the round | Should Pass |
+* | 02| Shallower radios ask first | 1 and 2 hops | held back | Should Pass |
+* | 03| Deepest radio, then the others in order | 3, 2, 1 hops | each may start once the deeper ones did | Should Pass |
+* | 04| Radio outside the round | unknown ruid | may start | Should Pass |
+*/
+TEST(em_renew_sched_t_Test, DeepestFirst) {
+    std::cout << "Entering DeepestFirst test" << std::endl;
+    em_renew_sched_t sched;
+    em_renew_sched_radio_t radios[3];
+    em_renew_sched_radio_t other = make_radio(9, 1, 0);
+
+    sched.set_limits(0, 0);
+    radios[0] = make_radio(1, 1, 1);
+    radios[1] = make_radio(3, 1, 3);
+    radios[2] = make_radio(2, 1, 2);
+    EXPECT_EQ(sched.plan(radios, 3, 1000), 3u);
+
+    EXPECT_FALSE(sched.may_start(radios[0].ruid, 1000));
+    EXPECT_FALSE(sched.may_start(radios[2].ruid, 1000));
+    EXPECT_TRUE(sched.may_start(radios[1].ruid, 1000));
+    EXPECT_EQ(state_of(sched, radios[1]), em_renew_sched_active);
+    EXPECT_FALSE(sched.may_start(radios[0].ruid, 1000));
+    EXPECT_TRUE(sched.may_start(radios[2].ruid, 1000));
+    EXPECT_TRUE(sched.may_start(radios[0].ruid, 1000));
+    EXPECT_TRUE(sched.may_start(other.ruid, 1000));
+
+    EXPECT_EQ(sched.get_progress().active, 3u);
+    EXPECT_EQ(sched.get_progress().waiting, 0u);
+    std::cout << "Exiting DeepestFirst test" << std::endl;
+}
+
+/**
+* @brief Test the limit of radios in progress and the gap between two starts
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Four radios at the same depth | 2 active, 100 ms gap | second waits for the gap | Should Pass |
+* | 02| Both slots taken | third radio after the gap | held back | Should Pass |
+* | 03| One finishes | third radio | may start, progress counts one done | Should Pass |
+*/
+TEST(em_renew_sched_t_Test, SlotsAndGap) {
+    std::cout << "Entering SlotsAndGap test" << std::endl;
+    em_renew_sched_t sched;
+    em_renew_sched_radio_t radios[4];
+    em_renew_sched_progress_t progress;
+    unsigned int i;
+
+    sched.set_limits(2, 100);
+    for (i = 0; i < 4; i++) {
+        radios[i] = make_radio(1, static_cast<unsigned char> (i), 1);
+    }
+    EXPECT_EQ(sched.plan(radios, 4, 1000), 4u);
+
+    EXPECT_TRUE(sched.may_start(radios[0].ruid, 1000));
+    EXPECT_FALSE(sched.may_start(radios[1].ruid, 1050));
+    EXPECT_TRUE(sched.may_start(radios[1].ruid, 1100));
+    EXPECT_FALSE(sched.may_start(radios[2].ruid, 1300));
+
+    sched.finish(radios[0].ruid, true, 1400);
+    EXPECT_TRUE(sched.may_start(radios[2].ruid, 1400));
+
+    progress = sched.get_progress();
+    EXPECT_EQ(progress.total, 4u);
+    EXPECT_EQ(progress.done, 1u);
+    EXPECT_EQ(progress.active, 2u);
+    EXPECT_EQ(progress.waiting, 1u);
+    EXPECT_EQ(progress.rounds, 1u);
+    std::cout << "Exiting SlotsAndGap test" << std::endl;
+}
+
+/**
+* @brief Test that a radio that does not finish or never gets ready does not hold the round
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Only slot active past EM_RENEW_SCHED_STEP_MS | 1 slot | failed, next radio starts, one timeout | Should Pass |
+* | 02| Deepest radio never asks | shallower radio asks | held back until EM_RENEW_SCHED_STEP_MS, then starts | Should Pass |
+*/
+TEST(em_renew_sched_t_Test, Timeouts) {
+    std::cout << "Entering Timeouts test" << std::endl;
+    em_renew_sched_t sched;
+    em_renew_sched_radio_t radios[2];
+
+    sched.set_limits(1, 0);
+    radios[0] = make_radio(1, 1, 1);
+    radios[1] = make_radio(2, 1, 1);
+    sched.plan(radios, 2, 1000);
+    EXPECT_TRUE(sched.may_start(radios[0].ruid, 1000));
+    EXPECT_FALSE(sched.may_start(radios[1].ruid, 2000));
+    EXPECT_TRUE(sched.may_start(radios[1].ruid, 1000 + EM_RENEW_SCHED_STEP_MS));
+    EXPECT_EQ(state_of(sched, radios[0]), em_renew_sched_failed);
+    EXPECT_EQ(sched.get_progress().timeouts, 1u);
+    sched.finish(radios[1].ruid, true, 12000);
+
+    sched.set_limits(0, 0);
+    radios[0] = make_radio(3, 1, 3);
+    radios[1] = make_radio(4, 1, 1);
+    sched.plan(radios, 2, 20000);
+    EXPECT_FALSE(sched.may_start(radios[1].ruid, 21000));
+    EXPECT_TRUE(sched.may_start(radios[1].ruid, 20000 + EM_RENEW_SCHED_STEP_MS));
+    EXPECT_EQ(state_of(sched, radios[0]), em_renew_sched_failed);
+    EXPECT_EQ(sched.get_progress().timeouts, 2u);
+    std::cout << "Exiting Timeouts test" << std::endl;
+}
+
+/**
+* @brief Test that a new round keeps the radios in progress and the ones still waiting
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Round of three, one active, one done | 1 slot | - | Should Pass |
+* | 02| New round of the done radio and a new one | 2 radios | 4 radios, active keeps its slot, done one waits again | Should Pass |
+* | 03| Canceled waiting radio | finish not ok | failed, next radio may go | Should Pass |
+*/
+TEST(em_renew_sched_t_Test, Replan) {
+    std::cout << "Entering Replan test" << std::endl;
+    em_renew_sched_t sched;
+    em_renew_sched_radio_t radios[3], again[2];
+
+    sched.set_limits(1, 0);
+    radios[0] = make_radio(1, 1, 2);
+    radios[1] = make_radio(2, 1, 2);
+    radios[2] = make_radio(3, 1, 1);
+    sched.plan(radios, 3, 1000);
+    EXPECT_TRUE(sched.may_start(radios[0].ruid, 1000));
+    sched.finish(radios[0].ruid, true, 1100);
+    EXPECT_TRUE(sched.may_start(radios[1].ruid, 1200));
+
+    again[0] = radios[0];
+    again[1] = make_radio(4, 1, 3);
+    EXPECT_EQ(sched.plan(again, 2, 1300), 4u);
+    EXPECT_EQ(state_of(sched, radios[0]), em_renew_sched_waiting);
+    EXPECT_EQ(state_of(sched, radios[1]), em_renew_sched_active);
+    EXPECT_EQ(sched.get_progress().rounds, 2u);
+
+    sched.finish(radios[1].ruid, true, 1400);
+    EXPECT_FALSE(sched.may_start(radios[0].ruid, 1400));
+    sched.finish(again[1].ruid, false, 1500);
+    EXPECT_EQ(state_of(sched, again[1]), em_renew_sched_failed);
+    EXPECT_TRUE(sched.may_start(radios[0].ruid, 1500));
+    EXPECT_EQ(sched.get_progress().failed, 1u);
+    std::cout << "Exiting Replan test" << std::endl;
+}
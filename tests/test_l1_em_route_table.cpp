@@ -0,0 +1,133 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include "em_route_table.h"
+
+static em_route_t make_route(unsigned char al, unsigned char next_hop, unsigned int hops,
+    unsigned int wireless_hops, unsigned int bottleneck_mbps)
+{
+    em_route_t route;
+
+    memset(&route, 0, sizeof(route));
+    route.al_mac[0] = 0x02;
+    route.al_mac[5] = al;
+    route.next_hop[0] = 0x02;
+    route.next_hop[5] = next_hop;
+    route.hops = hops;
+    route.wireless_hops = wireless_hops;
+    route.bottleneck_mbps = bottleneck_mbps;
+
+    return route;
+}
+
+/**
+* @brief Test that an update replaces the routes and counts the ones that changed
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| First update | agents 1 and 2 under agent 1 | 2 changed, both found | Should Pass |
+* | 02| Same routes again | rates changed only | 0 changed, new rate returned | Should Pass |
+* | 03| Agent 2 moved, agent 3 added, agent 1 gone | agent 2 direct | 3 changed, agent 1 unknown | Should Pass |
+*/
+TEST(em_route_table_t_Test, Update) {
+    std::cout << "Entering Update test" << std::endl;
+    em_route_table_t table;
+    em_route_t routes[2], route;
+
+    routes[0] = make_route(1, 1, 1, 1, 400);
+    routes[1] = make_route(2, 1, 2, 2, 200);
+    EXPECT_EQ(table.update(routes, 2), 2u);
+    EXPECT_EQ(table.count(), 2u);
+    ASSERT_TRUE(table.get_route(routes[1].al_mac, &route));
+    EXPECT_EQ(route.hops, 2u);
+    EXPECT_EQ(route.next_hop[5], 1);
+
+    routes[1].bottleneck_mbps = 150;
+    EXPECT_EQ(table.update(routes, 2), 0u);
+    ASSERT_TRUE(table.get_route(routes[1].al_mac, &route));
+    EXPECT_EQ(route.bottleneck_mbps, 150u);
+
+    routes[0] = make_route(2, 2, 1, 1, 400);
+    routes[1] = make_route(3, 2, 2, 2, 400);
+    EXPECT_EQ(table.update(routes, 2), 3u);
+    EXPECT_FALSE(table.get_route(make_route(1, 1, 1, 1, 0).al_mac, &route));
+    EXPECT_EQ(table.count(), 2u);
+
+    EXPECT_EQ(table.get_stats().updates, 3u);
+    EXPECT_EQ(table.get_stats().changed, 5u);
+    EXPECT_EQ(table.get_stats().misses, 1u);
+    std::cout << "Exiting Update test" << std::endl;
+}
+
+/**
+* @brief Test the stretch of the polling period by the route
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Wired or one wireless hop, fast | 0 and 1 wireless hops | 1 | Should Pass |
+* | 02| More wireless hops | 2, 3 and 5 wireless hops | 2, 4 and 4 | Should Pass |
+* | 03| Slow bottleneck | 50 Mbps | Doubled, capped at EM_ROUTE_MAX_POLL_SCALE | Should Pass |
+* | 04| Unknown agent | not in the table | 1 | Should Pass |
+*/
+TEST(em_route_table_t_Test, PollScale) {
+    std::cout << "Entering PollScale test" << std::endl;
+    em_route_table_t table;
+    em_route_t route;
+
+    route = make_route(1, 1, 2, 0, 1000);
+    EXPECT_EQ(em_route_table_t::get_poll_scale(&route), 1u);
+    route = make_route(1, 1, 1, 1, 0);
+    EXPECT_EQ(em_route_table_t::get_poll_scale(&route), 1u);
+    route = make_route(1, 1, 2, 2, 400);
+    EXPECT_EQ(em_route_table_t::get_poll_scale(&route), 2u);
+    route = make_route(1, 1, 3, 3, 400);
+    EXPECT_EQ(em_route_table_t::get_poll_scale(&route), 4u);
+    route = make_route(1, 1, 5, 5, 400);
+    EXPECT_EQ(em_route_table_t::get_poll_scale(&route), 4u);
+    route = make_route(1, 1, 1, 1, 50);
+    EXPECT_EQ(em_route_table_t::get_poll_scale(&route), 2u);
+    route = make_route(1, 1, 5, 5, 50);
+    EXPECT_EQ(em_route_table_t::get_poll_scale(&route), static_cast<unsigned int> (EM_ROUTE_MAX_POLL_SCALE));
+
+    table.update(&route, 1);
+    EXPECT_EQ(table.get_poll_scale(route.al_mac), static_cast<unsigned int> (EM_ROUTE_MAX_POLL_SCALE));
+    route = make_route(9, 9, 1, 1, 50);
+    EXPECT_EQ(table.get_poll_scale(route.al_mac), 1u);
+    std::cout << "Exiting PollScale test" << std::endl;
+}
@@ -0,0 +1,165 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <unistd.h>
+#include <mutex>
+#include <vector>
+#include "em_rx_shard.h"
+
+#define TEST_RX_SHARD_SOURCES   8
+#define TEST_RX_SHARD_FRAMES    64      // per source
+
+typedef struct {
+    unsigned int shard;
+    unsigned char source;
+    unsigned char seq;
+    void *src;
+} test_rx_shard_frame_t;
+
+static std::mutex test_lock;
+static std::vector<test_rx_shard_frame_t> test_routed;
+
+static void test_route(void *, em_rx_shard_t *shard, em_rx_buff_t *buff, unsigned int len, void *src)
+{
+    em_raw_hdr_t *hdr = reinterpret_cast<em_raw_hdr_t *>(buff->data);
+    test_rx_shard_frame_t frame;
+
+    EXPECT_EQ(len, sizeof(em_raw_hdr_t) + 1);
+    frame.shard = shard->idx;
+    frame.source = hdr->src[5];
+    frame.seq = buff->data[sizeof(em_raw_hdr_t)];
+    frame.src = src;
+    em_frame_ring_t::put(buff);
+
+    std::lock_guard<std::mutex> guard(test_lock);
+    test_routed.push_back(frame);
+}
+
+static unsigned int test_count()
+{
+    std::lock_guard<std::mutex> guard(test_lock);
+    return static_cast<unsigned int>(test_routed.size());
+}
+
+/**
+* @brief Test that the sources are spread over the shards and always owned by the same one
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Hash 64 AL MACs differing in their last byte twice | 4 shards | Same shard both times, every shard owns some | Should Pass |
+* | 02| Hash with one shard | None | Shard 0 | Should Pass |
+*/
+TEST(em_rx_shard_pool_t_Test, Hash) {
+    std::cout << "Entering Hash test" << std::endl;
+    mac_address_t mac = {0x02, 0x11, 0x22, 0x33, 0x44, 0x00};
+    unsigned int owned[4] = {0}, i, shard;
+
+    for (i = 0; i < 64; i++) {
+        mac[5] = static_cast<unsigned char>(i);
+        shard = em_rx_shard_pool_t::get_shard(mac, 4);
+        ASSERT_LT(shard, 4u);
+        EXPECT_EQ(em_rx_shard_pool_t::get_shard(mac, 4), shard);
+        EXPECT_EQ(em_rx_shard_pool_t::get_shard(mac, 1), 0u);
+        owned[shard]++;
+    }
+    for (i = 0; i < 4; i++) {
+        EXPECT_GT(owned[i], 0u);
+    }
+    std::cout << "Exiting Hash test" << std::endl;
+}
+
+/**
+* @brief Test that the frames of a source are routed by its shard in the order they were read
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Dispatch the frames of 8 sources interleaved | 4 shards, 64 frames per source | Every frame routed once with its node | Should Pass |
+* | 02| Check the shard and order of each source | None | Owning shard, read order | Should Pass |
+* | 03| Stop the shards | None | Every buffer returned to the ring | Should Pass |
+*/
+TEST(em_rx_shard_pool_t_Test, Dispatch) {
+    std::cout << "Entering Dispatch test" << std::endl;
+    em_frame_ring_t ring;
+    em_rx_shard_pool_t pool;
+    em_rx_buff_t *buff;
+    em_raw_hdr_t *hdr;
+    unsigned char next[TEST_RX_SHARD_SOURCES] = {0};
+    int node = 0;
+    unsigned int i, j, shard, tries;
+
+    test_routed.clear();
+    ASSERT_EQ(ring.init(16), 0);
+    ASSERT_EQ(pool.init(4, &ring, test_route, NULL), 0);
+    ASSERT_EQ(pool.get_num_shards(), 4u);
+
+    for (i = 0; i < TEST_RX_SHARD_FRAMES; i++) {
+        for (j = 0; j < TEST_RX_SHARD_SOURCES; j++) {
+            ASSERT_NE(buff = ring.get(sizeof(em_raw_hdr_t) + 1), nullptr);
+            hdr = reinterpret_cast<em_raw_hdr_t *>(buff->data);
+            memset(hdr, 0, sizeof(em_raw_hdr_t));
+            hdr->src[0] = 0x02;
+            hdr->src[5] = static_cast<unsigned char>(j);
+            buff->data[sizeof(em_raw_hdr_t)] = static_cast<unsigned char>(i);
+            EXPECT_TRUE(pool.dispatch(buff, sizeof(em_raw_hdr_t) + 1, &node));
+        }
+        // keep fewer frames in flight than a shard queue holds
+        for (tries = 0; (test_count() + 128 < (i + 1) * TEST_RX_SHARD_SOURCES) && (tries < 1000); tries++) {
+            usleep(1000);
+        }
+    }
+
+    for (tries = 0; (test_count() < TEST_RX_SHARD_SOURCES * TEST_RX_SHARD_FRAMES) && (tries < 1000); tries++) {
+        usleep(1000);
+    }
+    pool.deinit();
+    EXPECT_EQ(pool.get_num_shards(), 0u);
+    EXPECT_EQ(ring.get_in_use(), 0u);
+
+    ASSERT_EQ(test_routed.size(), static_cast<size_t>(TEST_RX_SHARD_SOURCES * TEST_RX_SHARD_FRAMES));
+    for (i = 0; i < test_routed.size(); i++) {
+        mac_address_t mac = {0x02, 0, 0, 0, 0, test_routed[i].source};
+        shard = em_rx_shard_pool_t::get_shard(mac, 4);
+        ASSERT_LT(test_routed[i].source, TEST_RX_SHARD_SOURCES);
+        EXPECT_EQ(test_routed[i].shard, shard);
+        EXPECT_EQ(test_routed[i].seq, next[test_routed[i].source]++);
+        EXPECT_EQ(test_routed[i].src, &node);
+    }
+    ring.deinit();
+    std::cout << "Exiting Dispatch test" << std::endl;
+}
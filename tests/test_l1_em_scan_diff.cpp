@@ -0,0 +1,144 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include "em_scan_diff.h"
+
+static void set_result(em_scan_result_t *res, unsigned char channel, unsigned int num_nbrs)
+{
+    unsigned int i;
+
+    memset(res, 0, sizeof(em_scan_result_t));
+    res->id.scanner_mac[0] = 0x02;
+    res->id.scanner_mac[5] = 0x01;
+    res->id.op_class = 115;
+    res->id.channel = channel;
+    res->util = 50;
+    res->num_neighbors = static_cast<unsigned short> (num_nbrs);
+    for (i = 0; i < num_nbrs; i++) {
+        res->neighbor[i].bssid[0] = 0x02;
+        res->neighbor[i].bssid[5] = static_cast<unsigned char> (0x10 + i);
+        res->neighbor[i].signal_strength = -60;
+    }
+}
+
+/**
+* @brief Test that a result is left out of the report until a neighbor appears, disappears or moves
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Compare a result never reported | 3 neighbors | Changed | Should Pass |
+* | 02| Compare the same result once reported, neighbors in another order, signal moved by less than the threshold | -58 dBm instead of -60 | Unchanged | Should Pass |
+* | 03| Move the signal of a neighbor by the threshold | -66 dBm | Changed | Should Pass |
+* | 04| Drop a neighbor, then add one | 2, then 4 neighbors | Changed | Should Pass |
+* | 05| Compare a result of another channel | channel 40 | Changed, never reported | Should Pass |
+*/
+TEST(em_scan_diff_t_Test, Neighbors) {
+    std::cout << "Entering Neighbors test" << std::endl;
+    em_scan_diff_t diff;
+    em_scan_result_t *res = new em_scan_result_t;
+    em_neighbor_t tmp;
+    unsigned long long now = 1000;
+
+    set_result(res, 36, 3);
+    EXPECT_TRUE(diff.is_changed(res, now));
+    diff.reported(res, now);
+    EXPECT_EQ(diff.get_count(), 1u);
+
+    tmp = res->neighbor[0];
+    res->neighbor[0] = res->neighbor[2];
+    res->neighbor[2] = tmp;
+    res->neighbor[1].signal_strength = -58;
+    EXPECT_FALSE(diff.is_changed(res, now + 1000));
+    EXPECT_EQ(diff.get_stats().suppressed, 1u);
+
+    res->neighbor[1].signal_strength = -66;
+    EXPECT_TRUE(diff.is_changed(res, now + 1000));
+    EXPECT_EQ(diff.get_stats().changed, 1u);
+
+    set_result(res, 36, 2);
+    EXPECT_TRUE(diff.is_changed(res, now + 1000));
+    EXPECT_EQ(diff.get_stats().disappeared, 1u);
+    set_result(res, 36, 4);
+    EXPECT_TRUE(diff.is_changed(res, now + 1000));
+    EXPECT_EQ(diff.get_stats().appeared, 1u);
+
+    set_result(res, 40, 3);
+    EXPECT_TRUE(diff.is_changed(res, now + 1000));
+    delete res;
+    std::cout << "Exiting Neighbors test" << std::endl;
+}
+
+/**
+* @brief Test that the utilization, the status and the refresh period bring an unchanged result back
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Raise the utilization by the threshold | 50 to 70 | Changed | Should Pass |
+* | 02| Change the scan status | 0 to 1 | Changed | Should Pass |
+* | 03| Compare once the refresh period is over | refresh_ms later | Changed | Should Pass |
+* | 04| Disable, then forget | enabled = false | Changed, then nothing recorded | Should Pass |
+*/
+TEST(em_scan_diff_t_Test, Refresh) {
+    std::cout << "Entering Refresh test" << std::endl;
+    em_scan_diff_t diff;
+    em_scan_diff_params_t params = diff.get_params();
+    em_scan_result_t *res = new em_scan_result_t;
+    unsigned long long now = 1000;
+
+    set_result(res, 36, 3);
+    diff.reported(res, now);
+    EXPECT_FALSE(diff.is_changed(res, now));
+
+    res->util = 70;
+    EXPECT_TRUE(diff.is_changed(res, now));
+    res->util = 50;
+    res->scan_status = 1;
+    EXPECT_TRUE(diff.is_changed(res, now));
+    res->scan_status = 0;
+    EXPECT_FALSE(diff.is_changed(res, now + params.refresh_ms - 1));
+    EXPECT_TRUE(diff.is_changed(res, now + params.refresh_ms));
+
+    params.enabled = false;
+    diff.set_params(&params);
+    EXPECT_TRUE(diff.is_changed(res, now));
+    diff.forget();
+    EXPECT_EQ(diff.get_count(), 0u);
+    delete res;
+    std::cout << "Exiting Refresh test" << std::endl;
+}
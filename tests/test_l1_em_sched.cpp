@@ -0,0 +1,158 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <gtest/gtest.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+#include "em_sched.h"
+
+typedef struct {
+    int ret;
+    char name[EM_SCHED_NAME_LEN];
+    cpu_set_t cpus;
+} test_sched_result_t;
+
+static void *sched_thread(void *arg)
+{
+    test_sched_result_t *res = static_cast<test_sched_result_t *>(arg);
+
+    res->ret = em_sched_t::apply(em_stack_role_crypto, "crypto-test");
+    pthread_getname_np(pthread_self(), res->name, sizeof(res->name));
+    pthread_getaffinity_np(pthread_self(), sizeof(res->cpus), &res->cpus);
+
+    return NULL;
+}
+
+/**
+* @brief Test that the scheduling of the roles is parsed from their role:option list
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Configure two roles | listener:cpus=2-3+5:fifo=20,mgr:nice=-5 | CPUs, policy and nice of each | Should Pass |
+* | 02| Configure bad lists | Unknown role or option, bad CPU, priority or nice | Refused, nothing changed | Should Pass |
+* | 03| Reset | None | Roles not configured | Should Pass |
+*/
+TEST(em_sched_t_Test, Configure) {
+    std::cout << "Entering Configure test" << std::endl;
+    em_sched_cfg_t cfg;
+    const char *bad[] = {
+        "", "listener", ":cpus=1", "foo:cpus=1", "listener:cpus", "listener:cpus=", "listener:cpus=64",
+        "listener:cpus=3-2", "listener:cpus=1+", "listener:fifo=0", "listener:rr=100", "listener:nice=20",
+        "listener:prio=5", "listener:cpus=1,worker:nice=x",
+    };
+    unsigned int i;
+
+    EXPECT_EQ(em_sched_t::configure("listener:cpus=2-3+5:fifo=20,mgr:nice=-5"), 0);
+    em_sched_t::get_cfg(em_stack_role_listener, &cfg);
+    EXPECT_EQ(cfg.cpus, 0x2cULL);
+    EXPECT_EQ(cfg.policy, SCHED_FIFO);
+    EXPECT_EQ(cfg.priority, 20);
+    EXPECT_FALSE(cfg.set_nice);
+    em_sched_t::get_cfg(EM_SCHED_ROLE_MGR, &cfg);
+    EXPECT_EQ(cfg.cpus, 0u);
+    EXPECT_EQ(cfg.policy, SCHED_OTHER);
+    EXPECT_TRUE(cfg.set_nice);
+    EXPECT_EQ(cfg.nice, -5);
+
+    EXPECT_EQ(em_sched_t::configure("worker:rr=1"), 0);
+    em_sched_t::get_cfg(em_stack_role_worker, &cfg);
+    EXPECT_EQ(cfg.policy, SCHED_RR);
+    EXPECT_EQ(cfg.priority, 1);
+
+    for (i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        if (bad[i][0] == '\0') {
+            // an empty list sets nothing
+            EXPECT_EQ(em_sched_t::configure(bad[i]), 0);
+            continue;
+        }
+        EXPECT_EQ(em_sched_t::configure(bad[i]), -1) << bad[i];
+    }
+    em_sched_t::get_cfg(em_stack_role_listener, &cfg);
+    EXPECT_EQ(cfg.cpus, 0x2cULL);
+    em_sched_t::get_cfg(em_stack_role_worker, &cfg);
+    EXPECT_FALSE(cfg.set_nice);
+
+    em_sched_t::reset();
+    em_sched_t::get_cfg(em_stack_role_listener, &cfg);
+    EXPECT_EQ(cfg.cpus, 0u);
+    EXPECT_EQ(cfg.policy, SCHED_OTHER);
+    std::cout << "Exiting Configure test" << std::endl;
+}
+
+/**
+* @brief Test that a thread takes its name and the CPUs of its role
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Shorten long names | MAC of a node | Prefix and the end, 15 characters | Should Pass |
+* | 02| Apply the crypto role on a thread | First CPU of the process | Named, runs on that CPU only | Should Pass |
+*/
+TEST(em_sched_t_Test, Apply) {
+    std::cout << "Entering Apply test" << std::endl;
+    char name[EM_SCHED_NAME_LEN], spec[64];
+    test_sched_result_t res;
+    cpu_set_t cpus;
+    pthread_t tid;
+    unsigned int cpu;
+
+    em_sched_t::get_short_name("node-aa:bb:cc:dd:ee:ff", name);
+    EXPECT_STREQ(name, "node-c:dd:ee:ff");
+    em_sched_t::get_short_name("worker-1", name);
+    EXPECT_STREQ(name, "worker-1");
+    em_sched_t::get_short_name("0123456789abcdefghij", name);
+    EXPECT_STREQ(name, "56789abcdefghij");
+
+    ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus), 0);
+    for (cpu = 0; (cpu < EM_SCHED_MAX_CPUS) && !CPU_ISSET(cpu, &cpus); cpu++);
+    ASSERT_LT(cpu, static_cast<unsigned int>(EM_SCHED_MAX_CPUS));
+    snprintf(spec, sizeof(spec), "crypto:cpus=%u", cpu);
+    ASSERT_EQ(em_sched_t::configure(spec), 0);
+
+    memset(&res, 0, sizeof(res));
+    ASSERT_EQ(pthread_create(&tid, NULL, sched_thread, &res), 0);
+    pthread_join(tid, NULL);
+    EXPECT_EQ(res.ret, 0);
+    EXPECT_STREQ(res.name, "crypto-test");
+    EXPECT_EQ(CPU_COUNT(&res.cpus), 1);
+    EXPECT_TRUE(CPU_ISSET(cpu, &res.cpus));
+    em_sched_t::reset();
+    std::cout << "Exiting Apply test" << std::endl;
+}
@@ -363,3 +363,103 @@ TEST(em_sm_t_Test, Destruction_em_sm_t)
 
     std::cout << "Exiting Destruction_em_sm_t test" << std::endl;
 }
+
+/**
+* @brief Test that the state code runs on state changes, events and deadlines only
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 009@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| State without deadline entered, ticks follow | em_state_ctrl_wsc_m1_pending | Runs on the first tick only, then waiting | Should Pass |
+* | 02| Event reaches the node | kick() | Not waiting, runs on the next tick only | Should Pass |
+* | 03| State with a deadline entered, ticks of EM_SM_POLL_MS follow | em_state_ctrl_set_policy_pending | Runs on every tick, not in between | Should Pass |
+* | 04| Unknown states | em_state_max, 0x80 | Rejected, no table entry | Should Pass |
+*/
+TEST(em_sm_t_Test, RunOnEventOrDeadline) {
+    std::cout << "Entering RunOnEventOrDeadline test" << std::endl;
+    em_sm_t sm;
+    uint64_t now = 1000000, tick = EM_SM_POLL_MS * 1000ULL;
+    unsigned int i;
+
+    sm.init_sm(em_service_type_ctrl);
+    EXPECT_TRUE(sm.begin_run(now));
+    EXPECT_EQ(sm.set_state(em_state_ctrl_wsc_m1_pending), 0);
+    EXPECT_TRUE(sm.begin_run(now += tick));
+    for (i = 0; i < 5; i++) {
+        EXPECT_FALSE(sm.begin_run(now += tick));
+    }
+    EXPECT_TRUE(sm.is_waiting());
+    sm.kick();
+    EXPECT_FALSE(sm.is_waiting());
+    EXPECT_TRUE(sm.begin_run(now += tick));
+    EXPECT_FALSE(sm.begin_run(now += tick));
+
+    EXPECT_EQ(sm.set_state(em_state_ctrl_set_policy_pending), 0);
+    EXPECT_TRUE(sm.begin_run(now += tick));
+    EXPECT_FALSE(sm.is_waiting());
+    EXPECT_FALSE(sm.begin_run(now + tick / 4));
+    for (i = 0; i < 5; i++) {
+        // ticks come a little early or late
+        now += (i % 2 == 0) ? (tick - 1000):(tick + 1000);
+        EXPECT_TRUE(sm.begin_run(now));
+    }
+    EXPECT_EQ(sm.get_num_runs(), 9u);
+
+    EXPECT_EQ(sm.set_state(em_state_max), -1);
+    EXPECT_EQ(sm.set_state(static_cast<em_state_t>(0x80)), -1);
+    EXPECT_EQ(em_sm_t::get_state_info(em_state_max), nullptr);
+    EXPECT_EQ(em_sm_t::get_state_info(em_state_ctrl_set_policy_pending)->deadline_ms, static_cast<unsigned int>(EM_SM_POLL_MS));
+    EXPECT_EQ(em_sm_t::get_state_info(em_state_ctrl_configured)->deadline_ms, 0u);
+    EXPECT_EQ(em_sm_t::get_state_at(EM_SM_NUM_STATES - 1), em_state_ctrl_topo_publish_pending);
+    std::cout << "Exiting RunOnEventOrDeadline test" << std::endl;
+}
+
+/**
+* @brief Test the accounting of the time spent in each state
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 010@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Agent goes through three states and back to the first | unconfigured, wsc_m2_pending, configured | One sample per state left, none for the current one | Should Pass |
+* | 02| Same state set again | em_state_agent_unconfigured | Not a transition | Should Pass |
+* | 03| Histogram of an unknown state | em_state_max | false | Should Pass |
+*/
+TEST(em_sm_t_Test, TimeInState) {
+    std::cout << "Entering TimeInState test" << std::endl;
+    em_sm_t sm;
+    em_lat_hist_t hist;
+
+    sm.init_sm(em_service_type_agent);
+    EXPECT_EQ(sm.set_state(em_state_agent_wsc_m2_pending), 0);
+    EXPECT_EQ(sm.set_state(em_state_agent_configured), 0);
+    EXPECT_EQ(sm.set_state(em_state_agent_unconfigured), 0);
+    EXPECT_EQ(sm.set_state(em_state_agent_unconfigured), 0);
+    EXPECT_EQ(sm.get_num_transitions(), 3u);
+
+    ASSERT_TRUE(sm.get_time_in_state(em_state_agent_wsc_m2_pending, &hist));
+    EXPECT_EQ(hist.get_count(), 1u);
+    ASSERT_TRUE(sm.get_time_in_state(em_state_agent_configured, &hist));
+    EXPECT_EQ(hist.get_count(), 1u);
+    ASSERT_TRUE(sm.get_time_in_state(em_state_agent_unconfigured, &hist));
+    EXPECT_EQ(hist.get_count(), 1u);
+    ASSERT_TRUE(sm.get_time_in_state(em_state_ctrl_configured, &hist));
+    EXPECT_EQ(hist.get_count(), 0u);
+    EXPECT_FALSE(sm.get_time_in_state(em_state_max, &hist));
+    std::cout << "Exiting TimeInState test" << std::endl;
+}
@@ -0,0 +1,185 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include "em_spectrum_cache.h"
+#include "test_l1_utils.h"
+
+/**
+* @brief Test the expiry time of an AFC response
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Expiry two hours away | "2025-01-01T02:00:00Z" at 00:00:00 | now + 7200000 | Should Pass |
+* | 02| Expiry a week away | "2025-01-08T00:00:00Z" | now + EM_SPECTRUM_CACHE_MAX_TTL_MS | Should Pass |
+* | 03| Expiry passed, malformed, not UTC | Various | -1 | Should Pass |
+* | 04| 6 GHz operating classes | 130, 131, 137, 138 | Only 131 to 137 | Should Pass |
+*/
+TEST(em_spectrum_cache_t_Test, ExpireTime) {
+    std::cout << "Entering ExpireTime test" << std::endl;
+    time_t wall = 1735689600;   // 2025-01-01T00:00:00Z
+    unsigned long long expire = 0;
+
+    EXPECT_EQ(em_spectrum_cache_t::parse_expire_time("2025-01-01T02:00:00Z", wall, 5000, &expire), 0);
+    EXPECT_EQ(expire, 5000ULL + 7200000ULL);
+    EXPECT_EQ(em_spectrum_cache_t::parse_expire_time("2025-01-08T00:00:00Z", wall, 5000, &expire), 0);
+    EXPECT_EQ(expire, 5000ULL + EM_SPECTRUM_CACHE_MAX_TTL_MS);
+
+    EXPECT_EQ(em_spectrum_cache_t::parse_expire_time("2024-12-31T23:59:59Z", wall, 5000, &expire), -1);
+    EXPECT_EQ(em_spectrum_cache_t::parse_expire_time("2025-01-01T00:00:00Z", wall, 5000, &expire), -1);
+    EXPECT_EQ(em_spectrum_cache_t::parse_expire_time("2025-01-01 02:00:00Z", wall, 5000, &expire), -1);
+    EXPECT_EQ(em_spectrum_cache_t::parse_expire_time("2025-01-01T02:00:00", wall, 5000, &expire), -1);
+    EXPECT_EQ(em_spectrum_cache_t::parse_expire_time("2025-13-01T02:00:00Z", wall, 5000, &expire), -1);
+    EXPECT_EQ(em_spectrum_cache_t::parse_expire_time("", wall, 5000, &expire), -1);
+
+    EXPECT_FALSE(em_spectrum_cache_t::is_afc(130));
+    EXPECT_TRUE(em_spectrum_cache_t::is_afc(131));
+    EXPECT_TRUE(em_spectrum_cache_t::is_afc(137));
+    EXPECT_FALSE(em_spectrum_cache_t::is_afc(138));
+    std::cout << "Exiting ExpireTime test" << std::endl;
+}
+
+/**
+* @brief Test the channel states and their sharing by location
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| No availability | get_state() | Unknown | Should Pass |
+* | 02| Availability of class 131 for agent 1 | Channels 1, 5 | 1 and 5 available with their EIRP, 9 unavailable, 133 unknown | Should Pass |
+* | 03| Agent 2 a few meters away, agent 3 far | set_location() | Agent 2 shares it, agent 3 does not | Should Pass |
+* | 04| Agent without location | get_state() | Unknown | Should Pass |
+* | 05| After the expiry | get_state() | Unknown, counted as expired on the next put | Should Pass |
+* | 06| Out of range coordinates | 91, 0 and 0, 181 | -1 | Should Pass |
+*/
+TEST(em_spectrum_cache_t_Test, Locations) {
+    std::cout << "Entering Locations test" << std::endl;
+    em_spectrum_cache_t cache;
+    mac_address_t agent[4];
+    em_spectrum_channel_t channels[2] = {{1, 30}, {5, 24}};
+    signed char eirp = 0;
+
+    for (unsigned int i = 0; i < 4; i++) {
+        make_mac(i + 1, agent[i]);
+    }
+    EXPECT_EQ(cache.get_state(agent[0], 131, 1, 1000, &eirp), em_spectrum_state_unknown);
+
+    EXPECT_EQ(cache.set_location(agent[0], 37.40001, -122.00001), 0);
+    EXPECT_EQ(cache.set_location(agent[1], 37.40003, -121.99998), 0);
+    EXPECT_EQ(cache.set_location(agent[2], 37.41, -122.0), 0);
+    cache.put(agent[0], 131, channels, 2, 100000, 1000);
+
+    EXPECT_EQ(cache.get_state(agent[0], 131, 1, 2000, &eirp), em_spectrum_state_available);
+    EXPECT_EQ(eirp, 30);
+    EXPECT_EQ(cache.get_state(agent[0], 131, 5, 2000, &eirp), em_spectrum_state_available);
+    EXPECT_EQ(eirp, 24);
+    EXPECT_EQ(cache.get_state(agent[0], 131, 9, 2000, NULL), em_spectrum_state_unavailable);
+    EXPECT_EQ(cache.get_state(agent[0], 133, 7, 2000, NULL), em_spectrum_state_unknown);
+
+    EXPECT_EQ(cache.get_state(agent[1], 131, 5, 2000, NULL), em_spectrum_state_available);
+    EXPECT_EQ(cache.get_state(agent[2], 131, 5, 2000, NULL), em_spectrum_state_unknown);
+    EXPECT_EQ(cache.get_state(agent[3], 131, 5, 2000, NULL), em_spectrum_state_unknown);
+
+    EXPECT_EQ(cache.get_state(agent[0], 131, 1, 100000, NULL), em_spectrum_state_unknown);
+    cache.put(agent[0], 133, channels, 1, 200000, 100000);
+    EXPECT_EQ(cache.get_stats().expired, 1u);
+    EXPECT_EQ(cache.get_stats().hits, 4u);
+    EXPECT_EQ(cache.get_stats().misses, 5u);
+
+    EXPECT_EQ(cache.set_location(agent[3], 91.0, 0.0), -1);
+    EXPECT_EQ(cache.set_location(agent[3], 0.0, 181.0), -1);
+    std::cout << "Exiting Locations test" << std::endl;
+}
+
+/**
+* @brief Test the inquiries of a location
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Two agents at a location, nothing cached | query() | Send for the first, wait for the second | Should Pass |
+* | 02| Response arrives | put(), end_inquiry() | Cached for both, shared counted | Should Pass |
+* | 03| Within the refresh margin | query() | Send | Should Pass |
+* | 04| Inquiry without response | INFLIGHT_MS later | Failed until RETRY_MS, then send | Should Pass |
+* | 05| Inquiry ended without availability | end_inquiry(false) | Failed | Should Pass |
+*/
+TEST(em_spectrum_cache_t_Test, Inquiries) {
+    std::cout << "Entering Inquiries test" << std::endl;
+    em_spectrum_cache_t cache;
+    mac_address_t agent[3];
+    em_spectrum_channel_t channels[1] = {{37, 36}};
+    unsigned long long now = 1000, expire = now + 2 * EM_SPECTRUM_CACHE_REFRESH_MS;
+
+    for (unsigned int i = 0; i < 3; i++) {
+        make_mac(i + 1, agent[i]);
+        cache.set_location(agent[i], 51.5, -0.12);
+    }
+
+    EXPECT_EQ(cache.query(agent[0], now), em_spectrum_query_send);
+    EXPECT_EQ(cache.query(agent[1], now + 10), em_spectrum_query_wait);
+    cache.put(agent[0], 131, channels, 1, expire, now + 100);
+    cache.end_inquiry(agent[0], true, now + 100);
+    EXPECT_EQ(cache.query(agent[0], now + 200), em_spectrum_query_cached);
+    EXPECT_EQ(cache.query(agent[1], now + 200), em_spectrum_query_cached);
+    EXPECT_EQ(cache.get_stats().shared, 2u);
+    EXPECT_EQ(cache.get_stats().inquiries, 1u);
+
+    now = expire - EM_SPECTRUM_CACHE_REFRESH_MS;
+    EXPECT_EQ(cache.query(agent[1], now), em_spectrum_query_send);
+    EXPECT_EQ(cache.query(agent[0], now + 1), em_spectrum_query_wait);
+    // the availability stays usable while it is refreshed
+    EXPECT_EQ(cache.get_state(agent[2], 131, 37, now + 1, NULL), em_spectrum_state_available);
+
+    now += EM_SPECTRUM_CACHE_INFLIGHT_MS;
+    EXPECT_EQ(cache.query(agent[0], now), em_spectrum_query_failed);
+    EXPECT_EQ(cache.get_stats().failed, 1u);
+    EXPECT_EQ(cache.query(agent[2], now + EM_SPECTRUM_CACHE_RETRY_MS - 1), em_spectrum_query_failed);
+    EXPECT_EQ(cache.query(agent[2], now + EM_SPECTRUM_CACHE_RETRY_MS), em_spectrum_query_send);
+    cache.end_inquiry(agent[2], false, now + EM_SPECTRUM_CACHE_RETRY_MS + 5);
+    EXPECT_EQ(cache.query(agent[0], now + EM_SPECTRUM_CACHE_RETRY_MS + 6), em_spectrum_query_failed);
+    EXPECT_EQ(cache.get_stats().failed, 2u);
+    std::cout << "Exiting Inquiries test" << std::endl;
+}
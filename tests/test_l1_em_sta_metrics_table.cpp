@@ -0,0 +1,139 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include "em_sta_metrics_table.h"
+
+static em_sta_info_t *make_sta(unsigned int n, unsigned char rcpi)
+{
+    em_sta_info_t *info = static_cast<em_sta_info_t *>(calloc(1, sizeof(em_sta_info_t)));
+
+    info->id[0] = 0x02;
+    info->id[4] = static_cast<unsigned char>(n >> 8);
+    info->id[5] = static_cast<unsigned char>(n);
+    info->bssid[0] = 0x02;
+    info->bssid[5] = 0xaa;
+    info->rcpi = rcpi;
+    info->bytes_tx = n;
+
+    return info;
+}
+
+/**
+* @brief Test that rows are added once per STA, refreshed in place and kept dense on removal
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Update 200 STAs, then update them all again | rcpi = n % 256 | 200 rows, the columns hold the last values | Should Pass |
+* | 02| Remove every even STA | None | 100 rows left, every odd STA still maps to its own values | Should Pass |
+*/
+TEST(em_sta_metrics_table_t_Test, UpdateAndRemove) {
+    std::cout << "Entering UpdateAndRemove test" << std::endl;
+    em_sta_metrics_table_t table;
+    em_sta_info_t *stas[200];
+    const em_sta_metrics_cols_t *cols;
+    unsigned int i, j, found;
+
+    for (i = 0; i < 200; i++) {
+        stas[i] = make_sta(i, static_cast<unsigned char>(i));
+        ASSERT_EQ(table.update(stas[i]), 0);
+    }
+    for (i = 0; i < 200; i++) {
+        stas[i]->bytes_tx = i + 1000;
+        ASSERT_EQ(table.update(stas[i]), 0);
+    }
+    EXPECT_EQ(table.count(), 200u);
+
+    for (i = 0; i < 200; i += 2) {
+        EXPECT_TRUE(table.remove(stas[i]->id));
+    }
+    EXPECT_FALSE(table.remove(stas[0]->id));
+    EXPECT_EQ(table.count(), 100u);
+
+    table.read_lock();
+    cols = table.get_cols();
+    ASSERT_EQ(cols->num_rows, 100u);
+    for (i = 1; i < 200; i += 2) {
+        found = 0;
+        for (j = 0; j < cols->num_rows; j++) {
+            if (memcmp(cols->sta[j], stas[i]->id, sizeof(mac_address_t)) == 0) {
+                found++;
+                EXPECT_EQ(cols->bytes_tx[j], i + 1000);
+                EXPECT_EQ(cols->rcpi[j], i);
+            }
+        }
+        EXPECT_EQ(found, 1u);
+    }
+    table.read_unlock();
+
+    for (i = 0; i < 200; i++) {
+        free(stas[i]);
+    }
+    std::cout << "Exiting UpdateAndRemove test" << std::endl;
+}
+
+/**
+* @brief Test that find_weak returns the STAs below the RCPI threshold
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Update 10 STAs with RCPI 10 to 100 | None | None | Should be successful |
+* | 02| Find the STAs below RCPI 45 | max = 10 then max = 2 | 4 STAs, then only 2 | Should Pass |
+*/
+TEST(em_sta_metrics_table_t_Test, FindWeak) {
+    std::cout << "Entering FindWeak test" << std::endl;
+    em_sta_metrics_table_t table;
+    em_sta_info_t *info;
+    mac_address_t weak[10];
+    unsigned int i;
+
+    for (i = 0; i < 10; i++) {
+        info = make_sta(i, static_cast<unsigned char>((i + 1) * 10));
+        ASSERT_EQ(table.update(info), 0);
+        free(info);
+    }
+
+    ASSERT_EQ(table.find_weak(45, 60, weak, 10), 4u);
+    for (i = 0; i < 4; i++) {
+        EXPECT_EQ(weak[i][5], i);
+    }
+    EXPECT_EQ(table.find_weak(45, 0, weak, 2), 2u);
+    std::cout << "Exiting FindWeak test" << std::endl;
+}
@@ -0,0 +1,157 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <pthread.h>
+#include "em_stack.h"
+
+#define TEST_STACK_USE  0x40000     // 256KB
+
+typedef struct {
+    size_t size;
+    size_t high_water_before;
+    size_t high_water_after;
+} test_stack_result_t;
+
+static size_t get_own_high_water()
+{
+    em_stack_thread_info_t info[EM_STACK_MAX_THREADS];
+    unsigned int i, num;
+
+    num = em_stack_t::get_threads(info, EM_STACK_MAX_THREADS);
+    for (i = 0; i < num; i++) {
+        if (strcmp(info[i].name, "test-stack") == 0) {
+            return info[i].high_water;
+        }
+    }
+
+    return 0;
+}
+
+static void __attribute__((noinline)) use_stack(size_t bytes)
+{
+    volatile unsigned char buf[0x1000];
+
+    memset(const_cast<unsigned char *>(buf), 1, sizeof(buf));
+    if (bytes > sizeof(buf)) {
+        use_stack(bytes - sizeof(buf));
+    }
+    buf[0] = buf[sizeof(buf) - 1];
+}
+
+static void *stack_thread(void *arg)
+{
+    test_stack_result_t *res = static_cast<test_stack_result_t *>(arg);
+    em_stack_thread_info_t info[EM_STACK_MAX_THREADS];
+    int slot;
+
+    slot = em_stack_t::enter(em_stack_role_worker, "test-stack");
+    if (slot >= 0) {
+        res->high_water_before = get_own_high_water();
+        use_stack(TEST_STACK_USE);
+        res->high_water_after = get_own_high_water();
+        if (em_stack_t::get_threads(info, 1) == 1) {
+            res->size = info[0].size;
+        }
+    }
+    em_stack_t::leave(slot);
+
+    return NULL;
+}
+
+/**
+* @brief Test that the stack sizes are parsed from their role=KB list
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Configure two roles | node=256,crypto=128 | Both sizes set, the others kept | Should Pass |
+* | 02| Bad lists | Unknown role, no size, below the minimum, trailing text | Refused, nothing set | Should Pass |
+*/
+TEST(em_stack_t_Test, Configure) {
+    std::cout << "Entering Configure test" << std::endl;
+    size_t worker = em_stack_t::get_size(em_stack_role_worker);
+
+    EXPECT_EQ(em_stack_t::configure("node=256,crypto=128"), 0);
+    EXPECT_EQ(em_stack_t::get_size(em_stack_role_node), 256u * 1024);
+    EXPECT_EQ(em_stack_t::get_size(em_stack_role_crypto), 128u * 1024);
+    EXPECT_EQ(em_stack_t::get_size(em_stack_role_worker), worker);
+
+    EXPECT_EQ(em_stack_t::configure("node=512,radio=256"), -1);
+    EXPECT_EQ(em_stack_t::configure("node="), -1);
+    EXPECT_EQ(em_stack_t::configure("=256"), -1);
+    EXPECT_EQ(em_stack_t::configure("node=16"), -1);
+    EXPECT_EQ(em_stack_t::configure("node=256k"), -1);
+    EXPECT_EQ(em_stack_t::get_size(em_stack_role_node), 256u * 1024);
+
+    EXPECT_EQ(em_stack_t::set_size(em_stack_role_node, EM_STACK_MIN_SZ - 1), -1);
+    EXPECT_EQ(em_stack_t::set_size(em_stack_role_node, 0x800000), 0);
+    EXPECT_EQ(em_stack_t::set_size(em_stack_role_crypto, 0x100000), 0);
+    EXPECT_STREQ(em_stack_t::get_role_str(em_stack_role_listener), "listener");
+    std::cout << "Exiting Configure test" << std::endl;
+}
+
+/**
+* @brief Test that the high water mark of a thread follows its deepest use
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Start a thread of the worker size | 1MB | Its size is reported, its mark is small | Should Pass |
+* | 02| Use 256KB of stack | Recursion | Mark of at least 256KB, below the size | Should Pass |
+* | 03| Let the thread exit | None | Mark kept for the role | Should Pass |
+*/
+TEST(em_stack_t_Test, HighWater) {
+    std::cout << "Entering HighWater test" << std::endl;
+    test_stack_result_t res = {};
+    pthread_attr_t attr;
+    pthread_t tid;
+
+    ASSERT_EQ(em_stack_t::set_size(em_stack_role_worker, 0x100000), 0);
+    pthread_attr_init(&attr);
+    ASSERT_EQ(em_stack_t::set_attr(&attr, em_stack_role_worker), 0);
+    ASSERT_EQ(pthread_create(&tid, &attr, stack_thread, &res), 0);
+    pthread_join(tid, NULL);
+    pthread_attr_destroy(&attr);
+
+    EXPECT_GT(res.size, 0x100000u - 0x10000u);
+    EXPECT_LE(res.size, 0x100000u);
+    EXPECT_LT(res.high_water_before, static_cast<size_t>(TEST_STACK_USE));
+    EXPECT_GE(res.high_water_after, static_cast<size_t>(TEST_STACK_USE));
+    EXPECT_LT(res.high_water_after, res.size);
+    EXPECT_GE(em_stack_t::get_max_high_water(em_stack_role_worker), res.high_water_after);
+    std::cout << "Exiting HighWater test" << std::endl;
+}
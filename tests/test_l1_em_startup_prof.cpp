@@ -0,0 +1,141 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "em_startup_prof.h"
+
+/**
+* @brief Test that the entries nest, carry their rows and stop once the profile is done
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| A phase holding a table and a scope | 12 rows, 2ms sleep | Depths 0, 1, 1, rows kept, phase at least 2ms | Should Pass |
+* | 02| Mark the profile done and begin another entry | None | -1 is returned, done once | Should Pass |
+*/
+TEST(em_startup_prof_t_Test, Entries) {
+    std::cout << "Entering Entries test" << std::endl;
+    cJSON *obj, *arr, *item;
+    int phase, table;
+
+    em_startup_prof_t::reset();
+    phase = em_startup_prof_t::begin(em_startup_prof_phase, "load_tables");
+    ASSERT_GE(phase, 0);
+    table = em_startup_prof_t::begin(em_startup_prof_table, "STAList");
+    ASSERT_GE(table, 0);
+    usleep(2000);
+    em_startup_prof_t::end(table, 12);
+    {
+        em_startup_prof_scope_t scope("writer");
+    }
+    em_startup_prof_t::end(phase);
+    // ending twice changes nothing
+    em_startup_prof_t::end(phase);
+
+    EXPECT_FALSE(em_startup_prof_t::is_done());
+    em_startup_prof_t::done();
+    EXPECT_TRUE(em_startup_prof_t::is_done());
+    EXPECT_EQ(em_startup_prof_t::begin(em_startup_prof_phase, "late"), -1);
+
+    obj = cJSON_CreateObject();
+    em_startup_prof_t::encode(obj);
+    EXPECT_EQ(cJSON_GetObjectItem(obj, "Done")->valuedouble, 1);
+    EXPECT_GE(cJSON_GetObjectItem(obj, "TotalUs")->valuedouble, 2000);
+    arr = cJSON_GetObjectItem(obj, "Entries");
+    ASSERT_EQ(cJSON_GetArraySize(arr), 3);
+
+    item = cJSON_GetArrayItem(arr, 0);
+    EXPECT_STREQ(cJSON_GetObjectItem(item, "Name")->valuestring, "load_tables");
+    EXPECT_STREQ(cJSON_GetObjectItem(item, "Kind")->valuestring, "Phase");
+    EXPECT_EQ(cJSON_GetObjectItem(item, "Depth")->valuedouble, 0);
+    EXPECT_GE(cJSON_GetObjectItem(item, "Us")->valuedouble, 2000);
+    EXPECT_EQ(cJSON_GetObjectItem(item, "Rows"), nullptr);
+
+    item = cJSON_GetArrayItem(arr, 1);
+    EXPECT_STREQ(cJSON_GetObjectItem(item, "Name")->valuestring, "STAList");
+    EXPECT_STREQ(cJSON_GetObjectItem(item, "Kind")->valuestring, "Table");
+    EXPECT_EQ(cJSON_GetObjectItem(item, "Depth")->valuedouble, 1);
+    EXPECT_EQ(cJSON_GetObjectItem(item, "Rows")->valuedouble, 12);
+
+    item = cJSON_GetArrayItem(arr, 2);
+    EXPECT_STREQ(cJSON_GetObjectItem(item, "Name")->valuestring, "writer");
+    EXPECT_EQ(cJSON_GetObjectItem(item, "Depth")->valuedouble, 1);
+    cJSON_Delete(obj);
+
+    em_startup_prof_t::reset();
+    std::cout << "Exiting Entries test" << std::endl;
+}
+
+/**
+* @brief Test that the memory an entry allocates is reported
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** Medium@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Allocate and touch 4MB in a phase | None | Resident memory grew by most of it, the heap too where reported | Should Pass |
+*/
+TEST(em_startup_prof_t_Test, Memory) {
+    std::cout << "Entering Memory test" << std::endl;
+    const size_t sz = 0x400000;
+    cJSON *obj, *item;
+    char *buf;
+    int slot;
+
+    em_startup_prof_t::reset();
+    ASSERT_GT(em_startup_prof_t::get_rss_bytes(), 0);
+
+    slot = em_startup_prof_t::begin(em_startup_prof_phase, "alloc");
+    buf = static_cast<char *>(malloc(sz));
+    ASSERT_NE(buf, nullptr);
+    memset(buf, 1, sz);
+    em_startup_prof_t::end(slot);
+
+    obj = cJSON_CreateObject();
+    em_startup_prof_t::encode(obj);
+    item = cJSON_GetArrayItem(cJSON_GetObjectItem(obj, "Entries"), 0);
+    ASSERT_NE(item, nullptr);
+    EXPECT_GE(cJSON_GetObjectItem(item, "RssBytes")->valuedouble, static_cast<double>(sz / 2));
+    if (em_startup_prof_t::get_heap_bytes() != 0) {
+        EXPECT_GE(cJSON_GetObjectItem(item, "HeapBytes")->valuedouble, static_cast<double>(sz));
+    }
+    cJSON_Delete(obj);
+    free(buf);
+
+    em_startup_prof_t::reset();
+    std::cout << "Exiting Memory test" << std::endl;
+}
@@ -0,0 +1,229 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include "em_steer_engine.h"
+#include "test_l1_utils.h"
+
+class em_steer_engine_tTEST : public ::testing::Test {
+protected:
+    em_steer_engine_t engine;
+    em_sta_metrics_table_t table;
+    em_metrics_history_t sta_history;
+    em_metrics_history_t bss_history;
+    em_beacon_report_cache_t reports;
+    em_steer_decision_t decisions[EM_STEER_ENGINE_MAX_DECISIONS];
+
+    // a STA associated with BSS 1000 and a few link metrics samples at the same RCPI
+    void add_sta(unsigned int n, unsigned char rcpi, unsigned long long now)
+    {
+        em_sta_info_t *info = static_cast<em_sta_info_t *>(calloc(1, sizeof(em_sta_info_t)));
+        em_metrics_sample_t sample;
+        unsigned int i;
+
+        make_mac(n, info->id);
+        make_mac(1000, info->bssid);
+        info->rcpi = rcpi;
+        ASSERT_EQ(table.update(info), 0);
+        memset(&sample, 0, sizeof(sample));
+        sample.rcpi = rcpi;
+        for (i = 0; i < 4; i++) {
+            sample.time_ms = now - 4000 + i * 1000;
+            ASSERT_EQ(sta_history.append(info->id, &sample), 0);
+        }
+        free(info);
+    }
+
+    void add_report(unsigned int n, unsigned int bss, unsigned char rcpi, unsigned long long now)
+    {
+        em_beacon_report_entry_t entry;
+        mac_address_t sta;
+
+        memset(&entry, 0, sizeof(entry));
+        make_mac(n, sta);
+        make_mac(bss, entry.bssid);
+        entry.op_class = 115;
+        entry.channel = 36;
+        entry.rcpi = rcpi;
+        entry.time_ms = now;
+        reports.update(sta, &entry);
+    }
+
+    unsigned int evaluate(unsigned long long now)
+    {
+        return engine.evaluate(now, &table, &sta_history, &bss_history, &reports, decisions, EM_STEER_ENGINE_MAX_DECISIONS);
+    }
+};
+
+/**
+* @brief Test that a weak STA asks for a Beacon Report first, then is steered to a better BSS
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| A weak STA and a strong STA, no Beacon Reports | rcpi 40 and 150 | One Beacon Report request for the weak STA | Should Pass |
+* | 02| Report of a BSS within the hysteresis | rcpi 45 | No decision | Should Pass |
+* | 03| Report of a BSS better by more than the hysteresis | rcpi 120 | Steer to it, latency since the first pass | Should Pass |
+* | 04| Pass again before and after the backoff | None | Nothing during the backoff, steered again after | Should Pass |
+*/
+TEST_F(em_steer_engine_tTEST, SteerWeakSta) {
+    std::cout << "Entering SteerWeakSta test" << std::endl;
+    unsigned char weak[6], target[6], source[6];
+
+    make_mac(1, weak);
+    make_mac(2000, target);
+    make_mac(1000, source);
+    add_sta(1, 40, 100000);
+    add_sta(2, 150, 100000);
+
+    ASSERT_EQ(evaluate(100000), 1u);
+    EXPECT_EQ(decisions[0].action, em_steer_action_beacon_report);
+    EXPECT_EQ(memcmp(decisions[0].sta, weak, sizeof(mac_address_t)), 0);
+    EXPECT_EQ(memcmp(decisions[0].source, source, sizeof(bssid_t)), 0);
+    EXPECT_EQ(engine.get_stats().last_stas, 2u);
+    EXPECT_EQ(engine.get_stats().last_triggered, 1u);
+
+    add_report(1, 2000, 45, 101000);
+    EXPECT_EQ(evaluate(102000), 0u);
+
+    add_report(1, 2000, 120, 103000);
+    ASSERT_EQ(evaluate(104000), 1u);
+    EXPECT_EQ(decisions[0].action, em_steer_action_steer);
+    EXPECT_EQ(memcmp(decisions[0].target, target, sizeof(bssid_t)), 0);
+    EXPECT_EQ(decisions[0].op_class, 115);
+    EXPECT_EQ(decisions[0].channel, 36);
+    EXPECT_EQ(decisions[0].target_rcpi, 120);
+    EXPECT_EQ(decisions[0].latency_ms, 4000u);
+    EXPECT_EQ(engine.get_stats().steers, 1u);
+    EXPECT_EQ(engine.get_stats().max_latency_ms, 4000u);
+
+    engine.steered(weak, 104000);
+    EXPECT_TRUE(engine.in_backoff(weak, 105000));
+    EXPECT_EQ(evaluate(106000), 0u);
+
+    add_report(1, 2000, 120, 104000 + engine.get_params().backoff_ms);
+    ASSERT_EQ(evaluate(104000 + engine.get_params().backoff_ms), 1u);
+    EXPECT_EQ(decisions[0].action, em_steer_action_steer);
+    std::cout << "Exiting SteerWeakSta test" << std::endl;
+}
+
+/**
+* @brief Test that the backoff doubles on every attempt up to its maximum
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Steer a STA three times in a row | None | Backoff of 1, 2 and 4 times the base | Should Pass |
+* | 02| Steer it many more times | None | Backoff capped at backoff_max_ms | Should Pass |
+*/
+TEST_F(em_steer_engine_tTEST, Backoff) {
+    std::cout << "Entering Backoff test" << std::endl;
+    unsigned long long base = engine.get_params().backoff_ms, now = 1000;
+    unsigned char sta[6];
+    unsigned int i;
+
+    make_mac(1, sta);
+    engine.steered(sta, now);
+    EXPECT_TRUE(engine.in_backoff(sta, now + base - 1));
+    EXPECT_FALSE(engine.in_backoff(sta, now + base));
+
+    now += base;
+    engine.steered(sta, now);
+    EXPECT_TRUE(engine.in_backoff(sta, now + 2 * base - 1));
+    EXPECT_FALSE(engine.in_backoff(sta, now + 2 * base));
+
+    now += 2 * base;
+    engine.steered(sta, now);
+    EXPECT_TRUE(engine.in_backoff(sta, now + 4 * base - 1));
+
+    for (i = 0; i < 40; i++) {
+        engine.steered(sta, now);
+    }
+    EXPECT_TRUE(engine.in_backoff(sta, now + engine.get_params().backoff_max_ms - 1));
+    EXPECT_FALSE(engine.in_backoff(sta, now + engine.get_params().backoff_max_ms));
+    std::cout << "Exiting Backoff test" << std::endl;
+}
+
+/**
+* @brief Test that STAs of a busy BSS are offloaded to a less utilized BSS only
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Strong STA on a BSS at utilization 240, reports of two BSSs | util 230 and 50 | Steered to the BSS at 50 | Should Pass |
+* | 02| Disable the engine | None | No decision | Should Pass |
+*/
+TEST_F(em_steer_engine_tTEST, OffloadBusyBss) {
+    std::cout << "Entering OffloadBusyBss test" << std::endl;
+    em_steer_engine_params_t params;
+    em_metrics_sample_t sample;
+    unsigned char bss[6];
+
+    add_sta(1, 150, 100000);
+    memset(&sample, 0, sizeof(sample));
+    sample.time_ms = 99000;
+    sample.util = 240;
+    make_mac(1000, bss);
+    ASSERT_EQ(bss_history.append(bss, &sample), 0);
+    sample.util = 230;
+    make_mac(2000, bss);
+    ASSERT_EQ(bss_history.append(bss, &sample), 0);
+    sample.util = 50;
+    make_mac(3000, bss);
+    ASSERT_EQ(bss_history.append(bss, &sample), 0);
+    add_report(1, 2000, 160, 99500);
+    add_report(1, 3000, 110, 99500);
+
+    ASSERT_EQ(evaluate(100000), 1u);
+    EXPECT_EQ(decisions[0].action, em_steer_action_steer);
+    EXPECT_EQ(memcmp(decisions[0].target, bss, sizeof(bssid_t)), 0);
+
+    params = engine.get_params();
+    params.enabled = false;
+    engine.set_params(&params);
+    EXPECT_EQ(evaluate(100000), 0u);
+    std::cout << "Exiting OffloadBusyBss test" << std::endl;
+}
@@ -0,0 +1,141 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include "em_steer_outcome.h"
+#include "test_l1_utils.h"
+
+/**
+* @brief Test a steer accepted by the STA, from the request to the reassociation with the target
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Request for two STAs in one message, ACK from another agent then from the right one | msg id 7 | ACK of the other agent ignored, 2 steers acked | Should Pass |
+* | 02| BTM Report accepting the steer, then association with the target | status 0 | Steer closed as succeeded, 1500 ms steering time | Should Pass |
+* | 03| BTM Report rejecting the steer of the second STA | status 6 | Steer closed as failed, 50% success | Should Pass |
+* | 04| Association of a STA that was not steered | None | Ignored | Should Pass |
+*/
+TEST(em_steer_outcome_table_t_Test, AcceptedAndRejected) {
+    std::cout << "Entering AcceptedAndRejected test" << std::endl;
+    em_steer_outcome_table_t table;
+    em_steer_outcome_stats_t stats;
+    unsigned char agent[6], other[6], sta1[6], sta2[6], source[6], target[6], zero[6] = {0};
+
+    make_mac(1, agent);
+    make_mac(2, other);
+    make_mac(10, sta1);
+    make_mac(11, sta2);
+    make_mac(100, source);
+    make_mac(200, target);
+    EXPECT_FALSE(table.get_agent_stats(agent, &stats));
+
+    table.add_request(agent, sta1, source, target, 7, 1000);
+    table.add_request(agent, sta2, source, target, 7, 1000);
+    EXPECT_EQ(table.count(), 2u);
+    EXPECT_EQ(table.ack(other, 7, 1010), 0u);
+    EXPECT_EQ(table.ack(agent, 7, 1020), 2u);
+    EXPECT_EQ(table.ack(agent, 7, 1030), 0u);
+
+    EXPECT_TRUE(table.report(sta1, 0, zero, 1200));
+    EXPECT_TRUE(table.reassociated(sta1, target, 2500));
+    EXPECT_EQ(table.count(), 1u);
+    ASSERT_TRUE(table.get_agent_stats(agent, &stats));
+    EXPECT_EQ(stats.requests, 2u);
+    EXPECT_EQ(stats.acked, 2u);
+    EXPECT_EQ(stats.reported, 1u);
+    EXPECT_EQ(stats.succeeded, 1u);
+    EXPECT_EQ(stats.success_pct, 100u);
+    EXPECT_EQ(stats.p50_ms, 1500u);
+
+    EXPECT_TRUE(table.report(sta2, 6, zero, 1300));
+    EXPECT_EQ(table.count(), 0u);
+    ASSERT_TRUE(table.get_agent_stats(agent, &stats));
+    EXPECT_EQ(stats.failed, 1u);
+    EXPECT_EQ(stats.success_pct, 50u);
+
+    EXPECT_FALSE(table.reassociated(sta2, target, 1400));
+    EXPECT_FALSE(table.report(sta1, 0, zero, 1400));
+    std::cout << "Exiting AcceptedAndRejected test" << std::endl;
+}
+
+/**
+* @brief Test the steers that never complete
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Steer a STA twice | msg id 1 then 2 | The first steer closed as failed | Should Pass |
+* | 02| BTM Report naming another target, association with it | None | Succeeded | Should Pass |
+* | 03| Steer a STA that associates elsewhere | None | Failed | Should Pass |
+* | 04| Steer a STA that never reassociates | None | Expired after EM_STEER_OUTCOME_TIMEOUT_MS | Should Pass |
+*/
+TEST(em_steer_outcome_table_t_Test, SupersededAndExpired) {
+    std::cout << "Entering SupersededAndExpired test" << std::endl;
+    em_steer_outcome_table_t table;
+    em_steer_outcome_stats_t stats;
+    unsigned char agent[6], sta[6], source[6], target[6], chosen[6];
+
+    make_mac(1, agent);
+    make_mac(10, sta);
+    make_mac(100, source);
+    make_mac(200, target);
+    make_mac(300, chosen);
+
+    table.add_request(agent, sta, source, target, 1, 1000);
+    table.add_request(agent, sta, source, target, 2, 2000);
+    EXPECT_EQ(table.count(), 1u);
+    EXPECT_TRUE(table.report(sta, 0, chosen, 2100));
+    EXPECT_TRUE(table.reassociated(sta, chosen, 2200));
+
+    table.add_request(agent, sta, source, target, 3, 3000);
+    EXPECT_TRUE(table.reassociated(sta, source, 3500));
+
+    table.add_request(agent, sta, source, target, 4, 4000);
+    EXPECT_EQ(table.expire(4000 + EM_STEER_OUTCOME_TIMEOUT_MS - 1), 0u);
+    EXPECT_EQ(table.expire(4000 + EM_STEER_OUTCOME_TIMEOUT_MS), 1u);
+    EXPECT_EQ(table.count(), 0u);
+
+    ASSERT_TRUE(table.get_agent_stats(agent, &stats));
+    EXPECT_EQ(stats.requests, 4u);
+    EXPECT_EQ(stats.succeeded, 1u);
+    EXPECT_EQ(stats.failed, 2u);
+    EXPECT_EQ(stats.expired, 1u);
+    EXPECT_EQ(stats.success_pct, 25u);
+    EXPECT_EQ(stats.p99_ms, 200u);
+    std::cout << "Exiting SupersededAndExpired test" << std::endl;
+}
@@ -0,0 +1,182 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include "em_tid_link_planner.h"
+#include "test_l1_utils.h"
+
+class em_tid_link_planner_tTEST : public ::testing::Test {
+protected:
+    em_tid_link_planner_t planner;
+    em_metrics_history_t sta_history;
+    em_metrics_history_t bss_history;
+    em_tid_link_mld_t mld;
+    em_tid_link_decision_t decisions[EM_TID_LINK_PLANNER_MAX_DECISIONS];
+    unsigned long long now = 100000;
+
+    // STA MLD 1 on AP MLD 100, link n is STA 10 + n on BSS 1000 + n with link ID n
+    void SetUp() override
+    {
+        unsigned int i;
+
+        memset(&mld, 0, sizeof(mld));
+        make_mac(100, mld.ap_mld);
+        make_mac(1, mld.sta_mld);
+        mld.num_links = 2;
+        for (i = 0; i < mld.num_links; i++) {
+            make_mac(10 + i, mld.links[i].sta);
+            make_mac(1000 + i, mld.links[i].bssid);
+            mld.links[i].link_id = static_cast<unsigned char>(i);
+        }
+    }
+
+    // enough samples at the same RCPI to bring the EWMA there
+    void add_samples(unsigned int link, unsigned char rcpi, unsigned int num)
+    {
+        em_metrics_sample_t sample;
+        unsigned int i;
+
+        memset(&sample, 0, sizeof(sample));
+        sample.rcpi = rcpi;
+        for (i = 0; i < num; i++) {
+            sample.time_ms = ++now;
+            ASSERT_EQ(sta_history.append(mld.links[link].sta, &sample), 0);
+        }
+    }
+
+    unsigned int evaluate()
+    {
+        return planner.evaluate(now, &mld, 1, &sta_history, &bss_history, decisions, EM_TID_LINK_PLANNER_MAX_DECISIONS);
+    }
+};
+
+/**
+* @brief Test that a weak link is taken out of the mapping and that nothing new is not evaluated
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| A strong and a weak link | rcpi 150 and 40 | Map of link 0 only | Should Pass |
+* | 02| Pass again before the mapping is pushed | None | Same decision | Should Pass |
+* | 03| Push it and pass again twice without new samples | None | No decision, the second pass skips the STA MLD | Should Pass |
+*/
+TEST_F(em_tid_link_planner_tTEST, DropWeakLink) {
+    std::cout << "Entering DropWeakLink test" << std::endl;
+    unsigned char map = 0;
+
+    add_samples(0, 150, 4);
+    add_samples(1, 40, 4);
+    ASSERT_EQ(evaluate(), 1u);
+    EXPECT_EQ(memcmp(decisions[0].sta_mld, mld.sta_mld, sizeof(mac_address_t)), 0);
+    EXPECT_EQ(memcmp(decisions[0].ap_mld, mld.ap_mld, sizeof(mac_address_t)), 0);
+    EXPECT_EQ(decisions[0].link_map, 0x01);
+    EXPECT_FALSE(decisions[0].default_map);
+
+    ASSERT_EQ(evaluate(), 1u);
+    planner.pushed(&decisions[0], now);
+    EXPECT_TRUE(planner.get_link_map(mld.sta_mld, &map));
+    EXPECT_EQ(map, 0x01);
+
+    EXPECT_EQ(evaluate(), 0u);
+    EXPECT_EQ(evaluate(), 0u);
+    EXPECT_GE(planner.get_stats().skipped, 1u);
+    EXPECT_EQ(planner.get_stats().pushed, 1u);
+    std::cout << "Exiting DropWeakLink test" << std::endl;
+}
+
+/**
+* @brief Test that a link rejoins the mapping only above the hysteresis and after the hold time
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Weak link taken out and pushed | rcpi 40 | Map of link 0 | Should Pass |
+* | 02| The link comes back above the floor but within the hysteresis | rcpi 64 | No decision | Should Pass |
+* | 03| The link comes back above the hysteresis within the hold time | rcpi 90 | Held | Should Pass |
+* | 04| Pass after the hold time | None | Default mapping of both links | Should Pass |
+*/
+TEST_F(em_tid_link_planner_tTEST, Hysteresis) {
+    std::cout << "Entering Hysteresis test" << std::endl;
+
+    add_samples(0, 150, 4);
+    add_samples(1, 40, 4);
+    ASSERT_EQ(evaluate(), 1u);
+    planner.pushed(&decisions[0], now);
+
+    add_samples(1, 64, 64);
+    EXPECT_EQ(evaluate(), 0u);
+
+    add_samples(1, 90, 64);
+    EXPECT_EQ(evaluate(), 0u);
+    EXPECT_GE(planner.get_stats().held, 1u);
+
+    now += planner.get_params().hold_ms;
+    ASSERT_EQ(evaluate(), 1u);
+    EXPECT_EQ(decisions[0].link_map, 0x03);
+    EXPECT_TRUE(decisions[0].default_map);
+    std::cout << "Exiting Hysteresis test" << std::endl;
+}
+
+/**
+* @brief Test that the best link is kept when none qualifies and that gone STA MLDs are forgotten
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Both links weak | rcpi 20 and 45 | Map of link 1 | Should Pass |
+* | 02| Pass without the STA MLD | num = 0 | The STA MLD is forgotten | Should Pass |
+*/
+TEST_F(em_tid_link_planner_tTEST, KeepBestLink) {
+    std::cout << "Entering KeepBestLink test" << std::endl;
+    unsigned char map = 0;
+
+    add_samples(0, 20, 4);
+    add_samples(1, 45, 4);
+    ASSERT_EQ(evaluate(), 1u);
+    EXPECT_EQ(decisions[0].link_map, 0x02);
+
+    EXPECT_EQ(planner.evaluate(now, &mld, 0, &sta_history, &bss_history, decisions, EM_TID_LINK_PLANNER_MAX_DECISIONS), 0u);
+    EXPECT_FALSE(planner.get_link_map(mld.sta_mld, &map));
+    std::cout << "Exiting KeepBestLink test" << std::endl;
+}
@@ -0,0 +1,192 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include "em_timer_wheel.h"
+
+static void count_cb(void *arg)
+{
+    (*static_cast<unsigned int *>(arg))++;
+}
+
+struct cancel_ctx_t {
+    em_timer_wheel_t *wheel;
+    em_timer_t *victim;
+    unsigned int fired;
+};
+
+static void cancel_cb(void *arg)
+{
+    cancel_ctx_t *ctx = static_cast<cancel_ctx_t *>(arg);
+    ctx->fired++;
+    ctx->wheel->cancel(ctx->victim);
+}
+
+/**
+* @brief Test that a one shot timer fires once at its deadline and not before
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Arm a 250 ms one shot timer and run the wheel at 240 ms | timeout_ms = 250 | Callback not run, next timeout is 10 ms | Should Pass |
+* | 02| Run the wheel at 250 ms and 1000 ms | None | Callback run exactly once, no timer armed | Should Pass |
+*/
+TEST(em_timer_wheel_t_Test, OneShot) {
+    std::cout << "Entering OneShot test" << std::endl;
+    em_timer_wheel_t wheel;
+    em_timer_t t;
+    unsigned int fired = 0;
+    em_timer_wheel_t::init_timer(&t);
+    wheel.add(&t, 1000, 250, 0, count_cb, &fired);
+    EXPECT_EQ(wheel.count(), 1u);
+    EXPECT_EQ(wheel.run(1240), 0u);
+    EXPECT_EQ(wheel.next_timeout_ms(1240), 10);
+    EXPECT_EQ(wheel.run(1250), 1u);
+    EXPECT_EQ(wheel.run(2000), 0u);
+    EXPECT_EQ(fired, 1u);
+    EXPECT_EQ(wheel.count(), 0u);
+    EXPECT_EQ(wheel.next_timeout_ms(2000), -1);
+    std::cout << "Exiting OneShot test" << std::endl;
+}
+
+/**
+* @brief Test that periodic timers fire on every period, including long periods that cascade between levels
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Arm 500 ms and 5 s periodic timers and run the wheel every 10 ms for 60 s | period_ms = 500, 5000 | 120 and 12 expirations | Should Pass |
+*/
+TEST(em_timer_wheel_t_Test, Periodic) {
+    std::cout << "Entering Periodic test" << std::endl;
+    em_timer_wheel_t wheel;
+    em_timer_t fast, slow;
+    unsigned int fast_fired = 0, slow_fired = 0;
+    uint64_t now;
+    em_timer_wheel_t::init_timer(&fast);
+    em_timer_wheel_t::init_timer(&slow);
+    wheel.add(&fast, 0, 500, 500, count_cb, &fast_fired);
+    wheel.add(&slow, 0, 5000, 5000, count_cb, &slow_fired);
+    for (now = 10; now <= 60000; now += 10) {
+        wheel.run(now);
+    }
+    EXPECT_EQ(fast_fired, 120u);
+    EXPECT_EQ(slow_fired, 12u);
+    EXPECT_EQ(wheel.count(), 2u);
+    std::cout << "Exiting Periodic test" << std::endl;
+}
+
+/**
+* @brief Test that the nearest deadline is reported across levels and that idle gaps are skipped
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Arm a 1300 ms timer, advance 1 s and arm a 400 ms timer | None | Next timeout is 300 ms | Should Pass |
+* | 02| Run straight to the reported deadlines | None | Each timer fires at its own deadline | Should Pass |
+* | 03| Arm a timer beyond the last level and run past it | timeout_ms = 3000000 | Timer fires once | Should Pass |
+*/
+TEST(em_timer_wheel_t_Test, NearestDeadline) {
+    std::cout << "Entering NearestDeadline test" << std::endl;
+    em_timer_wheel_t wheel;
+    em_timer_t far_t, near_t, huge_t;
+    unsigned int far_fired = 0, near_fired = 0, huge_fired = 0;
+    em_timer_wheel_t::init_timer(&far_t);
+    em_timer_wheel_t::init_timer(&near_t);
+    em_timer_wheel_t::init_timer(&huge_t);
+    wheel.add(&far_t, 0, 1300, 0, count_cb, &far_fired);
+    wheel.run(1000);
+    wheel.add(&near_t, 1000, 400, 0, count_cb, &near_fired);
+    EXPECT_EQ(wheel.next_timeout_ms(1000), 300);
+    wheel.run(1300);
+    EXPECT_EQ(far_fired, 1u);
+    EXPECT_EQ(near_fired, 0u);
+    EXPECT_EQ(wheel.next_timeout_ms(1300), 100);
+    wheel.run(1400);
+    EXPECT_EQ(near_fired, 1u);
+    wheel.add(&huge_t, 1400, 3000000, 0, count_cb, &huge_fired);
+    wheel.run(3001390);
+    EXPECT_EQ(huge_fired, 0u);
+    wheel.run(3001400);
+    EXPECT_EQ(huge_fired, 1u);
+    std::cout << "Exiting NearestDeadline test" << std::endl;
+}
+
+/**
+* @brief Test that callbacks can cancel and re-arm timers
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** Medium@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Cancel a pending timer | None | Callback never runs | Should Pass |
+* | 02| Cancel a timer from the callback of a timer with the same deadline | None | Only the first callback runs | Should Pass |
+*/
+TEST(em_timer_wheel_t_Test, Cancel) {
+    std::cout << "Entering Cancel test" << std::endl;
+    em_timer_wheel_t wheel;
+    em_timer_t a, b;
+    unsigned int b_fired = 0;
+    cancel_ctx_t ctx = { &wheel, &b, 0 };
+    em_timer_wheel_t::init_timer(&a);
+    em_timer_wheel_t::init_timer(&b);
+    wheel.cancel(&a);
+    wheel.add(&b, 0, 100, 0, count_cb, &b_fired);
+    wheel.cancel(&b);
+    EXPECT_EQ(wheel.count(), 0u);
+    wheel.add(&a, 0, 100, 0, cancel_cb, &ctx);
+    wheel.add(&b, 0, 100, 0, count_cb, &b_fired);
+    EXPECT_EQ(wheel.run(100), 1u);
+    EXPECT_EQ(ctx.fired, 1u);
+    EXPECT_EQ(b_fired, 0u);
+    EXPECT_EQ(wheel.count(), 0u);
+    std::cout << "Exiting Cancel test" << std::endl;
+}
@@ -0,0 +1,179 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include "em_tlv_writer.h"
+#include "em_msg.h"
+
+static mac_address_t dst = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55};
+static mac_address_t src = {0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb};
+
+/**
+* @brief Test that a small message stays in one frame with its header, TLVs and end of message TLV
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Add a TLV with a ready made value and one written in place | AL MAC TLV, profile TLV opened with a reservation of 16 and closed with 1 | Both lengths are back-patched | Should Pass |
+* | 02| Finish the message | None | One frame, last fragment flag set, ends with the end of message TLV | Should Pass |
+*/
+TEST(em_tlv_writer_t_Test, SingleFrame) {
+    std::cout << "Entering SingleFrame test" << std::endl;
+    em_tlv_writer_t writer;
+    unsigned char *tmp, *frame;
+    unsigned int len;
+
+    ASSERT_EQ(writer.begin(dst, src, em_msg_type_topo_resp, 0x1234), 0);
+    ASSERT_EQ(writer.add_tlv(em_tlv_type_al_mac_address, src, sizeof(mac_address_t)), 0);
+    ASSERT_NE(tmp = writer.open_tlv(em_tlv_type_profile, 16), nullptr);
+    tmp[0] = em_profile_type_3;
+    ASSERT_EQ(writer.close_tlv(1), 0);
+    ASSERT_EQ(writer.finish(), 1);
+
+    frame = writer.get_frame(0, &len);
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(len, sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t) + (sizeof(em_tlv_t) + 6) + (sizeof(em_tlv_t) + 1) + sizeof(em_tlv_t));
+    em_cmdu_t *cmdu = reinterpret_cast<em_cmdu_t *>(frame + sizeof(em_raw_hdr_t));
+    EXPECT_EQ(ntohs(cmdu->type), em_msg_type_topo_resp);
+    EXPECT_EQ(ntohs(cmdu->id), 0x1234);
+    EXPECT_EQ(cmdu->frag_id, 0);
+    EXPECT_EQ(cmdu->last_frag_ind, 1);
+
+    em_msg_t msg(frame + sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t), len - static_cast<unsigned int>(sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t)));
+    em_profile_type_t profile;
+    EXPECT_TRUE(msg.get_profile_type(&profile));
+    EXPECT_EQ(profile, em_profile_type_3);
+    EXPECT_EQ(frame[len - sizeof(em_tlv_t)], em_tlv_type_eom);
+    EXPECT_FALSE(writer.has_error());
+    std::cout << "Exiting SingleFrame test" << std::endl;
+}
+
+/**
+* @brief Test that TLVs beyond the frame size start new fragments without splitting a TLV
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Write 40 AP Metrics TLVs of 100 bytes into a writer with the default frame size | value = TLV number | Every frame is at most EM_MAX_FRAME_SZ long | Should Pass |
+* | 02| Walk the TLVs of every frame | None | All 40 TLVs are found in order, only the last frame has the last fragment flag and the end of message TLV | Should Pass |
+*/
+TEST(em_tlv_writer_t_Test, Fragments) {
+    std::cout << "Entering Fragments test" << std::endl;
+    em_tlv_writer_t writer;
+    unsigned char value[100], *frame;
+    unsigned int i, f, len, off, next = 0;
+    int num;
+
+    ASSERT_EQ(writer.begin(dst, src, em_msg_type_ap_metrics_rsp, 7), 0);
+    for (i = 0; i < 40; i++) {
+        memset(value, static_cast<int>(i), sizeof(value));
+        ASSERT_EQ(writer.add_tlv(em_tlv_type_ap_metrics, value, sizeof(value)), 0);
+    }
+    num = writer.finish();
+    ASSERT_GT(num, 1);
+
+    for (f = 0; f < static_cast<unsigned int>(num); f++) {
+        frame = writer.get_frame(f, &len);
+        ASSERT_LE(len, EM_MAX_FRAME_SZ);
+        em_cmdu_t *cmdu = reinterpret_cast<em_cmdu_t *>(frame + sizeof(em_raw_hdr_t));
+        EXPECT_EQ(ntohs(cmdu->id), 7);
+        EXPECT_EQ(cmdu->frag_id, f);
+        EXPECT_EQ(cmdu->last_frag_ind, (f == static_cast<unsigned int>(num - 1)) ? 1:0);
+        EXPECT_EQ(memcmp(frame, dst, sizeof(mac_address_t)), 0);
+
+        for (off = sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t); off < len; ) {
+            em_tlv_t *tlv = reinterpret_cast<em_tlv_t *>(frame + off);
+            if (tlv->type == em_tlv_type_eom) {
+                EXPECT_EQ(f, static_cast<unsigned int>(num - 1));
+                off += sizeof(em_tlv_t);
+                break;
+            }
+            EXPECT_EQ(tlv->type, em_tlv_type_ap_metrics);
+            EXPECT_EQ(ntohs(tlv->len), sizeof(value));
+            EXPECT_EQ(tlv->value[0], next);
+            EXPECT_EQ(tlv->value[sizeof(value) - 1], next);
+            next++;
+            off += sizeof(em_tlv_t) + ntohs(tlv->len);
+        }
+        EXPECT_EQ(off, len);
+    }
+    EXPECT_EQ(next, 40u);
+    std::cout << "Exiting Fragments test" << std::endl;
+}
+
+/**
+* @brief Test the error handling of the writer and the reuse of its buffer
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Close a TLV with more bytes than reserved | reservation 4, length 5 | close_tlv and finish fail | Should Pass |
+* | 02| Open a TLV while another one is open | None | open_tlv returns NULL | Should Pass |
+* | 03| Begin a new message on the same writer | None | The error is cleared and a one frame message is built | Should Pass |
+*/
+TEST(em_tlv_writer_t_Test, Errors) {
+    std::cout << "Entering Errors test" << std::endl;
+    em_tlv_writer_t writer;
+    unsigned int len;
+
+    ASSERT_EQ(writer.begin(dst, src, em_msg_type_topo_query, 1), 0);
+    ASSERT_NE(writer.open_tlv(em_tlv_type_profile, 4), nullptr);
+    EXPECT_EQ(writer.close_tlv(5), -1);
+    EXPECT_TRUE(writer.has_error());
+    EXPECT_EQ(writer.finish(), -1);
+
+    ASSERT_EQ(writer.begin(dst, src, em_msg_type_topo_query, 2), 0);
+    ASSERT_NE(writer.open_tlv(em_tlv_type_profile, 4), nullptr);
+    EXPECT_EQ(writer.open_tlv(em_tlv_type_profile, 4), nullptr);
+
+    ASSERT_EQ(writer.begin(dst, src, em_msg_type_topo_query, 3), 0);
+    EXPECT_FALSE(writer.has_error());
+    EXPECT_EQ(writer.finish(), 1);
+    ASSERT_NE(writer.get_frame(0, &len), nullptr);
+    EXPECT_EQ(len, sizeof(em_raw_hdr_t) + sizeof(em_cmdu_t) + sizeof(em_tlv_t));
+    EXPECT_EQ(writer.get_frame(1, &len), nullptr);
+    std::cout << "Exiting Errors test" << std::endl;
+}
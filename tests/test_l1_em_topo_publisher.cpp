@@ -0,0 +1,304 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include "em_topo_publisher.h"
+
+// topology like document, a Network with num_dev devices each with a list of radios
+static cJSON *make_topology(int num_dev, const char *ssid)
+{
+    cJSON *root = cJSON_CreateObject(), *net, *devs, *dev, *radios, *radio;
+    std::string id;
+    int i, j;
+
+    net = cJSON_AddObjectToObject(root, "Network");
+    cJSON_AddStringToObject(net, "ID", "OneWifiMesh");
+    cJSON_AddStringToObject(net, "SSID", ssid);
+    devs = cJSON_AddArrayToObject(net, "DeviceList");
+    for (i = 0; i < num_dev; i++) {
+        dev = cJSON_CreateObject();
+        id = "aa:bb:cc:dd:ee:" + std::to_string(10 + i);
+        cJSON_AddStringToObject(dev, "ID", id.c_str());
+        cJSON_AddNumberToObject(dev, "NumberOfRadios", 2);
+        radios = cJSON_AddArrayToObject(dev, "RadioList");
+        for (j = 0; j < 2; j++) {
+            radio = cJSON_CreateObject();
+            cJSON_AddNumberToObject(radio, "Noise", 90 + j);
+            cJSON_AddBoolToObject(radio, "Enabled", true);
+            cJSON_AddItemToArray(radios, radio);
+        }
+        cJSON_AddItemToArray(devs, dev);
+    }
+
+    return root;
+}
+
+// RFC 6902 add, remove and replace, as a subscriber applies them, returns false on a bad patch
+static bool apply_patch(cJSON *doc, const cJSON *patch)
+{
+    const cJSON *op;
+    cJSON *parent, *val;
+    std::vector<std::string> tokens;
+    std::string path, tok;
+    size_t pos, i;
+    const char *type;
+
+    for (op = patch->child; op != NULL; op = op->next) {
+        type = cJSON_GetObjectItem(op, "op")->valuestring;
+        path = cJSON_GetObjectItem(op, "path")->valuestring;
+        val = cJSON_GetObjectItem(op, "value");
+
+        tokens.clear();
+        while (path.empty() == false) {
+            path.erase(0, 1);
+            pos = path.find('/');
+            tok = path.substr(0, pos);
+            path = (pos == std::string::npos) ? "":path.substr(pos);
+            while ((pos = tok.find("~1")) != std::string::npos) {
+                tok.replace(pos, 2, "/");
+            }
+            while ((pos = tok.find("~0")) != std::string::npos) {
+                tok.replace(pos, 2, "~");
+            }
+            tokens.push_back(tok);
+        }
+        if (tokens.empty() == true) {
+            return false;
+        }
+
+        parent = doc;
+        for (i = 0; (i + 1 < tokens.size()) && (parent != NULL); i++) {
+            parent = cJSON_IsArray(parent) ? cJSON_GetArrayItem(parent, atoi(tokens[i].c_str())):
+                cJSON_GetObjectItemCaseSensitive(parent, tokens[i].c_str());
+        }
+        if (parent == NULL) {
+            return false;
+        }
+
+        tok = tokens.back();
+        if (strcmp(type, "remove") == 0) {
+            if (cJSON_IsArray(parent)) {
+                cJSON_DeleteItemFromArray(parent, atoi(tok.c_str()));
+            } else {
+                cJSON_DeleteItemFromObjectCaseSensitive(parent, tok.c_str());
+            }
+        } else if (strcmp(type, "add") == 0) {
+            if (cJSON_IsArray(parent)) {
+                cJSON_InsertItemInArray(parent, atoi(tok.c_str()), cJSON_Duplicate(val, true));
+            } else {
+                cJSON_AddItemToObject(parent, tok.c_str(), cJSON_Duplicate(val, true));
+            }
+        } else if (strcmp(type, "replace") == 0) {
+            if (cJSON_IsArray(parent)) {
+                cJSON_ReplaceItemInArray(parent, atoi(tok.c_str()), cJSON_Duplicate(val, true));
+            } else {
+                cJSON_ReplaceItemInObjectCaseSensitive(parent, tok.c_str(), cJSON_Duplicate(val, true));
+            }
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+* @brief Test that the first document is published as a snapshot and an unchanged one is not published
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Update with a first document | 4 devices | Compact snapshot with Seq 1 carrying the document | Should Pass |
+* | 02| Update with an equal document | 4 devices | Nothing to publish, the sequence number is unchanged | Should Pass |
+*/
+TEST(em_topo_publisher_t_Test, FirstSnapshotAndUnchanged) {
+    std::cout << "Entering FirstSnapshotAndUnchanged test" << std::endl;
+    em_topo_publisher_t publisher;
+    em_topo_publisher_stats_t stats;
+    cJSON *msg, *ref = make_topology(4, "home");
+    std::string str;
+
+    ASSERT_EQ(publisher.update(make_topology(4, "home"), 1000, str), em_topo_msg_type_snapshot);
+    EXPECT_EQ(str.find('\n'), std::string::npos);
+    ASSERT_NE((msg = cJSON_Parse(str.c_str())), nullptr);
+    EXPECT_STREQ(cJSON_GetObjectItem(msg, EM_TOPO_MSG_TYPE)->valuestring, EM_TOPO_MSG_TYPE_SNAPSHOT);
+    EXPECT_EQ(cJSON_GetObjectItem(msg, EM_TOPO_MSG_SEQ)->valueint, 1);
+    EXPECT_TRUE(cJSON_Compare(cJSON_GetObjectItem(msg, EM_TOPO_MSG_TOPOLOGY), ref, true));
+    cJSON_Delete(msg);
+
+    EXPECT_EQ(publisher.update(make_topology(4, "home"), 2000, str), em_topo_msg_type_none);
+    EXPECT_TRUE(str.empty());
+    EXPECT_EQ(publisher.get_seq(), 1u);
+    EXPECT_EQ(publisher.update(NULL, 2000, str), em_topo_msg_type_none);
+
+    publisher.get_stats(&stats);
+    EXPECT_EQ(stats.snapshots, 1u);
+    EXPECT_EQ(stats.unchanged, 1u);
+    cJSON_Delete(ref);
+    std::cout << "Exiting FirstSnapshotAndUnchanged test" << std::endl;
+}
+
+/**
+* @brief Test that a patch turns the document last published into the new one
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Publish a first document | 8 devices | Snapshot | Should Pass |
+* | 02| Change a value, add and remove members, add a device | 9 devices | Patch based on the snapshot, smaller than it, that reproduces the document | Should Pass |
+* | 03| Remove two devices | 7 devices | Patch based on the previous one that reproduces the document | Should Pass |
+*/
+TEST(em_topo_publisher_t_Test, PatchReproducesDocument) {
+    std::cout << "Entering PatchReproducesDocument test" << std::endl;
+    em_topo_publisher_t publisher;
+    cJSON *base = make_topology(8, "home"), *next, *dev, *msg;
+    std::string snapshot, str;
+
+    ASSERT_EQ(publisher.update(cJSON_Duplicate(base, true), 1000, snapshot), em_topo_msg_type_snapshot);
+
+    next = make_topology(9, "home");
+    dev = cJSON_GetArrayItem(cJSON_GetObjectItem(cJSON_GetObjectItem(next, "Network"), "DeviceList"), 2);
+    cJSON_GetObjectItem(cJSON_GetArrayItem(cJSON_GetObjectItem(dev, "RadioList"), 1), "Noise")->valuedouble = 70;
+    cJSON_DeleteItemFromObjectCaseSensitive(dev, "NumberOfRadios");
+    cJSON_AddStringToObject(dev, "Backhaul/Link~", "wifi");
+
+    ASSERT_EQ(publisher.update(cJSON_Duplicate(next, true), 2000, str), em_topo_msg_type_patch);
+    EXPECT_LT(str.size(), snapshot.size());
+    ASSERT_NE((msg = cJSON_Parse(str.c_str())), nullptr);
+    EXPECT_STREQ(cJSON_GetObjectItem(msg, EM_TOPO_MSG_TYPE)->valuestring, EM_TOPO_MSG_PATCH);
+    EXPECT_EQ(cJSON_GetObjectItem(msg, EM_TOPO_MSG_SEQ)->valueint, 2);
+    EXPECT_EQ(cJSON_GetObjectItem(msg, EM_TOPO_MSG_BASE_SEQ)->valueint, 1);
+    ASSERT_TRUE(apply_patch(base, cJSON_GetObjectItem(msg, EM_TOPO_MSG_PATCH)));
+    EXPECT_TRUE(cJSON_Compare(base, next, true));
+    cJSON_Delete(msg);
+    cJSON_Delete(next);
+
+    next = make_topology(7, "home");
+    ASSERT_EQ(publisher.update(cJSON_Duplicate(next, true), 3000, str), em_topo_msg_type_patch);
+    ASSERT_NE((msg = cJSON_Parse(str.c_str())), nullptr);
+    EXPECT_EQ(cJSON_GetObjectItem(msg, EM_TOPO_MSG_BASE_SEQ)->valueint, 2);
+    ASSERT_TRUE(apply_patch(base, cJSON_GetObjectItem(msg, EM_TOPO_MSG_PATCH)));
+    EXPECT_TRUE(cJSON_Compare(base, next, true));
+    cJSON_Delete(msg);
+    cJSON_Delete(next);
+
+    cJSON_Delete(base);
+    std::cout << "Exiting PatchReproducesDocument test" << std::endl;
+}
+
+/**
+* @brief Test when a snapshot is published instead of a patch
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Publish EM_TOPO_SNAPSHOT_PATCHES changes after a snapshot, then one more | SSID changes | Patches, then a snapshot | Should Pass |
+* | 02| Move the whole document under another member | 8 devices | Snapshot, the patch would not be smaller | Should Pass |
+* | 03| Ask for the periodic snapshot before and after the interval | None | Nothing, then a snapshot of the document last published | Should Pass |
+* | 04| Reset and update with the same document | 1 device | Snapshot | Should Pass |
+*/
+TEST(em_topo_publisher_t_Test, SnapshotPolicy) {
+    std::cout << "Entering SnapshotPolicy test" << std::endl;
+    em_topo_publisher_t publisher;
+    em_topo_publisher_stats_t stats;
+    unsigned long long now = 1000;
+    std::string str, ssid;
+    cJSON *msg, *doc;
+    int i;
+
+    ASSERT_EQ(publisher.update(make_topology(8, "ssid"), now, str), em_topo_msg_type_snapshot);
+    for (i = 0; i < EM_TOPO_SNAPSHOT_PATCHES; i++) {
+        ssid = "ssid" + std::to_string(i);
+        EXPECT_EQ(publisher.update(make_topology(8, ssid.c_str()), ++now, str), em_topo_msg_type_patch);
+    }
+    EXPECT_EQ(publisher.update(make_topology(8, "last"), ++now, str), em_topo_msg_type_snapshot);
+
+    doc = cJSON_CreateObject();
+    cJSON_AddItemToObject(doc, "Moved", make_topology(8, "other"));
+    EXPECT_EQ(publisher.update(doc, ++now, str), em_topo_msg_type_snapshot);
+
+    EXPECT_EQ(publisher.get_periodic(now + EM_TOPO_SNAPSHOT_INTERVAL_MS - 1, str), em_topo_msg_type_none);
+    EXPECT_TRUE(str.empty());
+    ASSERT_EQ(publisher.get_periodic(now + EM_TOPO_SNAPSHOT_INTERVAL_MS, str), em_topo_msg_type_snapshot);
+    ASSERT_NE((msg = cJSON_Parse(str.c_str())), nullptr);
+    doc = cJSON_GetObjectItem(cJSON_GetObjectItem(msg, EM_TOPO_MSG_TOPOLOGY), "Moved");
+    EXPECT_STREQ(cJSON_GetObjectItem(cJSON_GetObjectItem(doc, "Network"), "SSID")->valuestring, "other");
+    EXPECT_EQ(static_cast<unsigned int>(cJSON_GetObjectItem(msg, EM_TOPO_MSG_SEQ)->valueint), publisher.get_seq());
+    cJSON_Delete(msg);
+
+    publisher.reset();
+    EXPECT_EQ(publisher.get_periodic(now + 10 * EM_TOPO_SNAPSHOT_INTERVAL_MS, str), em_topo_msg_type_none);
+    EXPECT_EQ(publisher.update(make_topology(1, "other"), ++now, str), em_topo_msg_type_snapshot);
+
+    publisher.get_stats(&stats);
+    EXPECT_EQ(stats.patches, static_cast<unsigned long long>(EM_TOPO_SNAPSHOT_PATCHES));
+    EXPECT_EQ(stats.snapshots, 5u);
+    std::cout << "Exiting SnapshotPolicy test" << std::endl;
+}
+
+/**
+* @brief Test the escaping of member names in JSON pointers
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** Medium@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Pointers of plain names and of names with ~ and / | None | ~ is ~0, / is ~1 | Should Pass |
+*/
+TEST(em_topo_publisher_t_Test, Pointer) {
+    std::cout << "Entering Pointer test" << std::endl;
+    EXPECT_EQ(em_topo_publisher_t::get_pointer("", "Network"), "/Network");
+    EXPECT_EQ(em_topo_publisher_t::get_pointer("/Network", "a/b~c"), "/Network/a~1b~0c");
+    EXPECT_EQ(em_topo_publisher_t::get_pointer("/Network", ""), "/Network/");
+    std::cout << "Exiting Pointer test" << std::endl;
+}
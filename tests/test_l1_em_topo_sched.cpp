@@ -0,0 +1,300 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include <set>
+#include "em_topo_sched.h"
+#include "test_l1_utils.h"
+
+/**
+* @brief Test the back off of the queries of a stable agent
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Agent added | now = 1000 | Due within the jitter of the minimum period, nothing due before | Should Pass |
+* | 02| Unchanged responses | 6 rounds | Period doubles up to the maximum | Should Pass |
+* | 03| Changed response | changed = true | Period back to the minimum | Should Pass |
+* | 04| Response without query | answered() | false returned | Should Pass |
+*/
+TEST(em_topo_sched_t_Test, BackOff) {
+    std::cout << "Entering BackOff test" << std::endl;
+    em_topo_sched_t sched(1);
+    em_topo_sched_agent_t info;
+    mac_address_t agent, due[4];
+    unsigned long long now = 1000, min_due, max_due;
+    unsigned int period, i;
+
+    make_mac(1, agent);
+    sched.add(agent, now);
+    ASSERT_TRUE(sched.get_agent(agent, &info));
+    min_due = now + EM_TOPO_SCHED_MIN_PERIOD_MS * (100 - EM_TOPO_SCHED_JITTER_PCT) / 100;
+    max_due = now + EM_TOPO_SCHED_MIN_PERIOD_MS * (100 + EM_TOPO_SCHED_JITTER_PCT) / 100;
+    EXPECT_GE(info.due_ms, min_due);
+    EXPECT_LE(info.due_ms, max_due);
+    EXPECT_EQ(sched.get_due(info.due_ms - 1, due, 4), 0u);
+
+    period = EM_TOPO_SCHED_MIN_PERIOD_MS;
+    for (i = 0; i < 6; i++) {
+        now = info.due_ms;
+        ASSERT_EQ(sched.get_due(now, due, 4), 1u);
+        EXPECT_EQ(memcmp(due[0], agent, sizeof(mac_address_t)), 0);
+        EXPECT_EQ(sched.get_due(now, due, 4), 0u);
+        now += 100;
+        EXPECT_TRUE(sched.answered(agent, false, now));
+        period = (2 * period > EM_TOPO_SCHED_MAX_PERIOD_MS) ? EM_TOPO_SCHED_MAX_PERIOD_MS:2 * period;
+        ASSERT_TRUE(sched.get_agent(agent, &info));
+        EXPECT_EQ(info.period_ms, period);
+        EXPECT_GE(info.due_ms, now + period * (100 - EM_TOPO_SCHED_JITTER_PCT) / 100);
+        EXPECT_LE(info.due_ms, now + period * (100 + EM_TOPO_SCHED_JITTER_PCT) / 100);
+    }
+    EXPECT_EQ(info.period_ms, static_cast<unsigned int>(EM_TOPO_SCHED_MAX_PERIOD_MS));
+
+    now = info.due_ms;
+    ASSERT_EQ(sched.get_due(now, due, 4), 1u);
+    EXPECT_TRUE(sched.answered(agent, true, now));
+    ASSERT_TRUE(sched.get_agent(agent, &info));
+    EXPECT_EQ(info.period_ms, static_cast<unsigned int>(EM_TOPO_SCHED_MIN_PERIOD_MS));
+    EXPECT_FALSE(sched.answered(agent, false, now));
+
+    EXPECT_EQ(sched.get_stats().queried, 7u);
+    EXPECT_EQ(sched.get_stats().unchanged, 6u);
+    EXPECT_EQ(sched.get_stats().changed, 1u);
+    std::cout << "Exiting BackOff test" << std::endl;
+}
+
+/**
+* @brief Test that a Topology Notification makes the query due at once
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Notification of an idle agent | notified() | Due now, period back to the minimum | Should Pass |
+* | 02| Notification while a query is outstanding | notified() then answered() | Due again at the response | Should Pass |
+* | 03| Notification of an unknown agent | agent 2 | false returned | Should Pass |
+*/
+TEST(em_topo_sched_t_Test, Notification) {
+    std::cout << "Entering Notification test" << std::endl;
+    em_topo_sched_t sched(1);
+    em_topo_sched_agent_t info;
+    mac_address_t agent, other, due[4];
+    unsigned long long now = 1000;
+
+    make_mac(1, agent);
+    make_mac(2, other);
+    sched.add(agent, now);
+    ASSERT_TRUE(sched.get_agent(agent, &info));
+    ASSERT_EQ(sched.get_due(info.due_ms, due, 4), 1u);
+    EXPECT_TRUE(sched.answered(agent, false, info.due_ms));
+    ASSERT_TRUE(sched.get_agent(agent, &info));
+    EXPECT_EQ(info.period_ms, 2u * EM_TOPO_SCHED_MIN_PERIOD_MS);
+
+    now = info.due_ms - 50000;
+    EXPECT_EQ(sched.get_due(now, due, 4), 0u);
+    EXPECT_TRUE(sched.notified(agent, now));
+    ASSERT_EQ(sched.get_due(now, due, 4), 1u);
+    ASSERT_TRUE(sched.get_agent(agent, &info));
+    EXPECT_EQ(info.period_ms, static_cast<unsigned int>(EM_TOPO_SCHED_MIN_PERIOD_MS));
+
+    // the response may predate the notification
+    EXPECT_TRUE(sched.notified(agent, now + 10));
+    EXPECT_EQ(sched.get_due(now + 10, due, 4), 0u);
+    EXPECT_TRUE(sched.answered(agent, true, now + 20));
+    ASSERT_EQ(sched.get_due(now + 20, due, 4), 1u);
+    EXPECT_TRUE(sched.answered(agent, false, now + 30));
+    EXPECT_EQ(sched.get_due(now + 30, due, 4), 0u);
+
+    EXPECT_FALSE(sched.notified(other, now));
+    EXPECT_EQ(sched.get_stats().notified, 2u);
+    std::cout << "Exiting Notification test" << std::endl;
+}
+
+/**
+* @brief Test the spread of agents added together and the limit per tick
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| 64 agents added in the same tick | now = 1000 | At least 32 distinct due times | Should Pass |
+* | 02| All due | max = EM_TOPO_SCHED_MAX_PER_TICK | Most overdue first, at most the limit per call | Should Pass |
+*/
+TEST(em_topo_sched_t_Test, Spread) {
+    std::cout << "Entering Spread test" << std::endl;
+    em_topo_sched_t sched(7);
+    em_topo_sched_agent_t info;
+    mac_address_t agent, due[EM_TOPO_SCHED_MAX_PER_TICK];
+    std::set<unsigned long long> times;
+    unsigned long long now = 1000, last = 0;
+    unsigned int i, num, total = 0;
+
+    for (i = 0; i < 64; i++) {
+        make_mac(i, agent);
+        sched.add(agent, now);
+        ASSERT_TRUE(sched.get_agent(agent, &info));
+        times.insert(info.due_ms);
+    }
+    EXPECT_EQ(sched.count(), 64u);
+    EXPECT_GE(times.size(), 32u);
+
+    now += EM_TOPO_SCHED_MAX_PERIOD_MS;
+    while ((num = sched.get_due(now, due, EM_TOPO_SCHED_MAX_PER_TICK)) != 0) {
+        EXPECT_LE(num, static_cast<unsigned int>(EM_TOPO_SCHED_MAX_PER_TICK));
+        for (i = 0; i < num; i++) {
+            ASSERT_TRUE(sched.get_agent(due[i], &info));
+            EXPECT_TRUE(info.outstanding);
+            EXPECT_GE(info.due_ms, last);
+            last = info.due_ms;
+        }
+        total += num;
+    }
+    EXPECT_EQ(total, 64u);
+    std::cout << "Exiting Spread test" << std::endl;
+}
+
+/**
+* @brief Test lost, deferred and removed queries
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 004@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Query deferred | defer() | Due again after EM_TOPO_SCHED_RETRY_MS | Should Pass |
+* | 02| Query without response | EM_TOPO_SCHED_TIMEOUT_MS later | Counted lost, due within a jittered minimum period | Should Pass |
+* | 03| Agent removed | remove() | Unknown, nothing due | Should Pass |
+*/
+TEST(em_topo_sched_t_Test, LostAndDeferred) {
+    std::cout << "Entering LostAndDeferred test" << std::endl;
+    em_topo_sched_t sched(1);
+    em_topo_sched_agent_t info;
+    mac_address_t agent, due[4];
+    unsigned long long now;
+
+    make_mac(1, agent);
+    sched.add(agent, 1000);
+    ASSERT_TRUE(sched.get_agent(agent, &info));
+    now = info.due_ms;
+    ASSERT_EQ(sched.get_due(now, due, 4), 1u);
+    sched.defer(agent, now);
+    EXPECT_EQ(sched.get_due(now + EM_TOPO_SCHED_RETRY_MS - 1, due, 4), 0u);
+    now += EM_TOPO_SCHED_RETRY_MS;
+    ASSERT_EQ(sched.get_due(now, due, 4), 1u);
+    EXPECT_EQ(sched.get_stats().deferred, 1u);
+
+    now += EM_TOPO_SCHED_TIMEOUT_MS;
+    EXPECT_EQ(sched.get_due(now, due, 4), 0u);
+    EXPECT_EQ(sched.get_stats().lost, 1u);
+    ASSERT_TRUE(sched.get_agent(agent, &info));
+    EXPECT_FALSE(info.outstanding);
+    EXPECT_LE(info.due_ms, now + EM_TOPO_SCHED_MIN_PERIOD_MS * (100 + EM_TOPO_SCHED_JITTER_PCT) / 100);
+    EXPECT_FALSE(sched.answered(agent, false, now));
+
+    sched.remove(agent);
+    EXPECT_FALSE(sched.get_agent(agent, &info));
+    EXPECT_EQ(sched.get_due(now + EM_TOPO_SCHED_MAX_PERIOD_MS * 2, due, 4), 0u);
+    EXPECT_EQ(sched.count(), 0u);
+    std::cout << "Exiting LostAndDeferred test" << std::endl;
+}
+
+/**
+* @brief Test the minimum period set from the route of an agent
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 005@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Minimum period set | 4 x EM_TOPO_SCHED_MIN_PERIOD_MS | Period raised to it | Should Pass |
+* | 02| Changed response and notification | answered(changed), notified() | Period back to the agent minimum, not the global one | Should Pass |
+* | 03| Out of range and unknown agent | 0, 2 x EM_TOPO_SCHED_MAX_PERIOD_MS, agent 2 | Clamped, false for the unknown agent | Should Pass |
+*/
+TEST(em_topo_sched_t_Test, MinPeriod) {
+    std::cout << "Entering MinPeriod test" << std::endl;
+    em_topo_sched_t sched(1);
+    em_topo_sched_agent_t info;
+    mac_address_t agent, other, due[4];
+    unsigned int min_period = 4 * EM_TOPO_SCHED_MIN_PERIOD_MS;
+
+    make_mac(1, agent);
+    make_mac(2, other);
+    sched.add(agent, 1000);
+    EXPECT_TRUE(sched.set_min_period(agent, min_period));
+    ASSERT_TRUE(sched.get_agent(agent, &info));
+    EXPECT_EQ(info.period_ms, min_period);
+    EXPECT_EQ(info.min_period_ms, min_period);
+
+    ASSERT_EQ(sched.get_due(info.due_ms, due, 4), 1u);
+    EXPECT_TRUE(sched.answered(agent, false, info.due_ms));
+    ASSERT_TRUE(sched.get_agent(agent, &info));
+    EXPECT_EQ(info.period_ms, 2 * min_period);
+    ASSERT_EQ(sched.get_due(info.due_ms, due, 4), 1u);
+    EXPECT_TRUE(sched.answered(agent, true, info.due_ms));
+    ASSERT_TRUE(sched.get_agent(agent, &info));
+    EXPECT_EQ(info.period_ms, min_period);
+    EXPECT_TRUE(sched.notified(agent, info.due_ms));
+    ASSERT_TRUE(sched.get_agent(agent, &info));
+    EXPECT_EQ(info.period_ms, min_period);
+
+    EXPECT_TRUE(sched.set_min_period(agent, 0));
+    ASSERT_TRUE(sched.get_agent(agent, &info));
+    EXPECT_EQ(info.min_period_ms, static_cast<unsigned int> (EM_TOPO_SCHED_MIN_PERIOD_MS));
+    EXPECT_TRUE(sched.set_min_period(agent, 2 * EM_TOPO_SCHED_MAX_PERIOD_MS));
+    ASSERT_TRUE(sched.get_agent(agent, &info));
+    EXPECT_EQ(info.min_period_ms, static_cast<unsigned int> (EM_TOPO_SCHED_MAX_PERIOD_MS));
+    EXPECT_FALSE(sched.set_min_period(other, min_period));
+    std::cout << "Exiting MinPeriod test" << std::endl;
+}
@@ -0,0 +1,199 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "em_trace.h"
+
+typedef struct {
+    double ts;
+    int tid;
+    std::string module;
+    std::string event;
+    unsigned int args[EM_TRACE_MAX_ARGS];
+} em_trace_line_t;
+
+// dumps the rings and decodes them back
+static std::vector<em_trace_line_t> dump_and_decode()
+{
+    std::vector<em_trace_line_t> lines;
+    char path[] = "/tmp/em_trace_XXXXXX";
+    em_trace_line_t line;
+    std::string text;
+    char buff[256];
+    FILE *out;
+    int fd;
+
+    if ((fd = mkstemp(path)) < 0) {
+        return lines;
+    }
+    close(fd);
+    out = tmpfile();
+    if ((em_trace_t::dump(path) == 0) && (out != NULL) && (em_trace_t::decode(path, out) >= 0)) {
+        rewind(out);
+        while (fgets(buff, sizeof(buff), out) != NULL) {
+            std::istringstream ss(buff);
+            ss >> line.ts >> line.tid >> line.module >> line.event;
+            for (unsigned int i = 0; i < EM_TRACE_MAX_ARGS; i++) {
+                ss >> line.args[i];
+            }
+            lines.push_back(line);
+        }
+    }
+    if (out != NULL) {
+        fclose(out);
+    }
+    unlink(path);
+
+    return lines;
+}
+
+/**
+* @brief Test that events recorded by two threads are dumped and decoded in time order
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Record an event, then one from another thread, then one more | orch_exec 1 2, orch_skip 3 4, orch_fini 5 6 | Decoded in that order with their threads, modules and arguments | Should Pass |
+*/
+TEST(em_trace_t_Test, DumpAndDecode) {
+    std::cout << "Entering DumpAndDecode test" << std::endl;
+    int tid = static_cast<int>(syscall(SYS_gettid)), other = 0;
+    em_trace(EM_MGR, em_trace_event_orch_exec, 1001, 2);
+    std::thread t([&other]() {
+        other = static_cast<int>(syscall(SYS_gettid));
+        em_trace(EM_CTRL, em_trace_event_orch_skip, 1003, 4);
+    });
+    t.join();
+    em_trace(EM_MGR, em_trace_event_orch_fini, 1005, 6);
+    std::vector<em_trace_line_t> lines = dump_and_decode();
+    std::vector<em_trace_line_t> found;
+    for (auto& l : lines) {
+        if ((l.args[0] >= 1001) && (l.args[0] <= 1005)) {
+            found.push_back(l);
+        }
+    }
+    ASSERT_EQ(found.size(), 3u);
+    EXPECT_EQ(found[0].event, "orch_exec");
+    EXPECT_EQ(found[0].module, "mgr");
+    EXPECT_EQ(found[0].tid, tid);
+    EXPECT_EQ(found[0].args[1], 2u);
+    EXPECT_EQ(found[1].event, "orch_skip");
+    EXPECT_EQ(found[1].module, "ctrl");
+    EXPECT_EQ(found[1].tid, other);
+    EXPECT_EQ(found[2].event, "orch_fini");
+    EXPECT_EQ(found[2].args[1], 6u);
+    EXPECT_LE(found[0].ts, found[1].ts);
+    EXPECT_LE(found[1].ts, found[2].ts);
+    std::cout << "Exiting DumpAndDecode test" << std::endl;
+}
+
+/**
+* @brief Test that a thread ring keeps its latest EM_TRACE_RING_SZ records and that disabled tracing records nothing
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Record EM_TRACE_RING_SZ + 10 events from a new thread | First argument 0, 1, ... | The thread has EM_TRACE_RING_SZ records starting at 10 | Should Pass |
+* | 02| Disable tracing and record from a new thread | One event | The thread has no record | Should Pass |
+*/
+TEST(em_trace_t_Test, RingWrapAndDisable) {
+    std::cout << "Entering RingWrapAndDisable test" << std::endl;
+    int tid = 0, off = 0;
+    std::thread t([&tid]() {
+        tid = static_cast<int>(syscall(SYS_gettid));
+        for (unsigned int i = 0; i < EM_TRACE_RING_SZ + 10; i++) {
+            em_trace(EM_DB, em_trace_event_ctrl_state, i);
+        }
+    });
+    t.join();
+    em_trace_t::enable(false);
+    std::thread t2([&off]() {
+        off = static_cast<int>(syscall(SYS_gettid));
+        em_trace(EM_DB, em_trace_event_ctrl_state, 7);
+    });
+    t2.join();
+    em_trace_t::enable(true);
+    std::vector<em_trace_line_t> lines = dump_and_decode();
+    std::vector<unsigned int> args;
+    unsigned int num_off = 0;
+    for (auto& l : lines) {
+        if ((l.module == "db") && (l.event == "ctrl_state")) {
+            args.push_back(l.args[0]);
+        }
+        if ((off != tid) && (l.tid == off)) {
+            num_off++;
+        }
+    }
+    ASSERT_EQ(args.size(), static_cast<size_t>(EM_TRACE_RING_SZ));
+    EXPECT_EQ(args.front(), 10u);
+    EXPECT_EQ(args.back(), EM_TRACE_RING_SZ + 9u);
+    EXPECT_EQ(num_off, 0u);
+    std::cout << "Exiting RingWrapAndDisable test" << std::endl;
+}
+
+/**
+* @brief Test the compile time log gating and that a file that is not a dump is refused
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Check em_log_compiled() with the default build flags | Every level and module | true | Should Pass |
+* | 02| Decode a file that is not a dump | /dev/null | -1 | Should Pass |
+*/
+TEST(em_trace_t_Test, GatingAndBadDump) {
+    std::cout << "Entering GatingAndBadDump test" << std::endl;
+    static_assert(em_log_compiled(EM_LOG_LVL_ERROR, EM_CONF), "errors are always compiled in by default");
+    EXPECT_TRUE(em_log_compiled(EM_LOG_LVL_DEBUG, EM_STDOUT));
+    EXPECT_TRUE(em_log_compiled(EM_LOG_LVL_INFO, EM_CTRL));
+    EXPECT_EQ(em_trace_t::decode("/dev/null", stdout), -1);
+    EXPECT_STREQ(em_trace_t::get_event_str(em_trace_event_max), "unknown");
+    std::cout << "Exiting GatingAndBadDump test" << std::endl;
+}
@@ -0,0 +1,139 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include "em_unassoc_sta.h"
+
+static void set_target(em_unassoc_sta_target_t *target, unsigned char last, unsigned char op_class, unsigned char channel)
+{
+    memset(target, 0, sizeof(em_unassoc_sta_target_t));
+    target->sta[0] = 0x02;
+    target->sta[5] = last;
+    target->op_class = op_class;
+    target->channel = channel;
+}
+
+/**
+* @brief Test that a query groups the STAs of an op class per channel and decodes back
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Encode 4 targets, 3 of op class 115 on 2 interleaved channels | channels 36, 40, 36 and one of op class 81 | 2 channels, 3 STAs, the op class 81 target left out | Should Pass |
+* | 02| Decode the query | The value of step 01 | 3 targets of op class 115, the two of channel 36 first | Should Pass |
+* | 03| Decode the query truncated | len - 1 | -1 is returned | Should Pass |
+* | 04| Encode for an op class without targets | op class 128 | 0 is returned | Should Pass |
+*/
+TEST(em_unassoc_sta_tlv_t_Test, Query) {
+    std::cout << "Entering Query test" << std::endl;
+    em_unassoc_sta_target_t targets[4], decoded[4];
+    unsigned char buff[128];
+    unsigned int len;
+
+    set_target(&targets[0], 1, 115, 36);
+    set_target(&targets[1], 2, 115, 40);
+    set_target(&targets[2], 3, 81, 6);
+    set_target(&targets[3], 4, 115, 36);
+
+    len = em_unassoc_sta_tlv_t::encode_query(115, targets, 4, buff, sizeof(buff));
+    EXPECT_EQ(len, 2u + 2 * 2 + 3 * sizeof(mac_address_t));
+    EXPECT_EQ(buff[0], 115);
+    EXPECT_EQ(buff[1], 2);
+    EXPECT_EQ(buff[2], 36);
+    EXPECT_EQ(buff[3], 2);
+
+    ASSERT_EQ(em_unassoc_sta_tlv_t::decode_query(buff, len, decoded, 4), 3);
+    EXPECT_EQ(decoded[0].sta[5], 1);
+    EXPECT_EQ(decoded[1].sta[5], 4);
+    EXPECT_EQ(decoded[1].channel, 36);
+    EXPECT_EQ(decoded[2].sta[5], 2);
+    EXPECT_EQ(decoded[2].channel, 40);
+    EXPECT_EQ(decoded[2].op_class, 115);
+
+    EXPECT_EQ(em_unassoc_sta_tlv_t::decode_query(buff, len - 1, decoded, 4), -1);
+    EXPECT_EQ(em_unassoc_sta_tlv_t::encode_query(128, targets, 4, buff, sizeof(buff)), 0u);
+    std::cout << "Exiting Query test" << std::endl;
+}
+
+/**
+* @brief Test that a response encodes the time delta in network order and decodes back
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Encode 2 measurements | time delta 0x01020304 and 20, rcpi 150 and 90 | 26 octets, delta most significant octet first | Should Pass |
+* | 02| Decode the response | The value of step 01 | op class and both measurements match | Should Pass |
+* | 03| Encode and decode a response without measurements | num = 0 | 2 octets, 0 measurements | Should Pass |
+* | 04| Decode a response announcing more STAs than it carries | count patched to 3 | -1 is returned | Should Pass |
+*/
+TEST(em_unassoc_sta_tlv_t_Test, Response) {
+    std::cout << "Entering Response test" << std::endl;
+    em_unassoc_sta_meas_t meas[2], decoded[2];
+    unsigned char buff[64], op_class = 0;
+    unsigned int len;
+
+    memset(meas, 0, sizeof(meas));
+    meas[0].sta[5] = 1;
+    meas[0].channel = 36;
+    meas[0].time_delta_ms = 0x01020304;
+    meas[0].rcpi = 150;
+    meas[1].sta[5] = 2;
+    meas[1].channel = 40;
+    meas[1].time_delta_ms = 20;
+    meas[1].rcpi = 90;
+
+    len = em_unassoc_sta_tlv_t::encode_response(115, meas, 2, buff, sizeof(buff));
+    ASSERT_EQ(len, 26u);
+    EXPECT_EQ(buff[1], 2);
+    EXPECT_EQ(buff[2 + sizeof(mac_address_t) + 1], 0x01);
+    EXPECT_EQ(buff[2 + sizeof(mac_address_t) + 4], 0x04);
+
+    ASSERT_EQ(em_unassoc_sta_tlv_t::decode_response(buff, len, &op_class, decoded, 2), 2);
+    EXPECT_EQ(op_class, 115);
+    EXPECT_EQ(decoded[0].time_delta_ms, 0x01020304u);
+    EXPECT_EQ(decoded[0].rcpi, 150);
+    EXPECT_EQ(decoded[1].sta[5], 2);
+    EXPECT_EQ(decoded[1].channel, 40);
+    EXPECT_EQ(decoded[1].rcpi, 90);
+
+    EXPECT_EQ(em_unassoc_sta_tlv_t::encode_response(115, NULL, 0, buff, sizeof(buff)), 2u);
+    EXPECT_EQ(em_unassoc_sta_tlv_t::decode_response(buff, 2, &op_class, decoded, 2), 0);
+
+    len = em_unassoc_sta_tlv_t::encode_response(115, meas, 2, buff, sizeof(buff));
+    buff[1] = 3;
+    EXPECT_EQ(em_unassoc_sta_tlv_t::decode_response(buff, len, &op_class, decoded, 2), -1);
+    std::cout << "Exiting Response test" << std::endl;
+}
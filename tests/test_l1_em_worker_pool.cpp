@@ -0,0 +1,284 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "em_worker_pool.h"
+
+struct test_node_t {
+    em_mpsc_queue_t q;
+    em_worker_slot_t *slot;
+    uintptr_t next;                 // value the next popped entry must have
+    std::atomic<unsigned int> done;
+    std::atomic<unsigned int> ticks;
+    std::atomic<unsigned int> running;
+    bool in_order;
+    bool concurrent;
+    pthread_t tid;
+    bool moved;                     // ran on more than one thread
+};
+
+static bool test_run(void *ctx, unsigned int budget)
+{
+    test_node_t *n = static_cast<test_node_t *>(ctx);
+    unsigned int i;
+    void *e;
+
+    if (n->running++ != 0) {
+        n->concurrent = true;
+    }
+    if ((n->done != 0) && (pthread_equal(n->tid, pthread_self()) == 0)) {
+        n->moved = true;
+    }
+    n->tid = pthread_self();
+    for (i = 0; (i < budget) && ((e = n->q.pop()) != NULL); i++) {
+        if (reinterpret_cast<uintptr_t>(e) != n->next) {
+            n->in_order = false;
+        }
+        n->next++;
+        n->done++;
+    }
+    n->running--;
+
+    return n->q.count() != 0;
+}
+
+static void test_tick(void *ctx)
+{
+    static_cast<test_node_t *>(ctx)->ticks++;
+}
+
+static void init_node(test_node_t *n)
+{
+    ASSERT_EQ(n->q.init(4096), 0);
+    n->slot = NULL;
+    n->next = 1;
+    n->done = 0;
+    n->ticks = 0;
+    n->running = 0;
+    n->in_order = true;
+    n->concurrent = false;
+    n->moved = false;
+}
+
+/**
+* @brief Test that nodes are spread over the workers and run in order on their home worker
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Attach 4 nodes to a pool of 2 workers | None | 2 nodes homed on each worker | Should Pass |
+* | 02| Queue 2000 entries per node from 2 producer threads each and schedule the node after each push | None | Every entry runs once, in order, never concurrently and always on the same thread | Should Pass |
+* | 03| Wait for the tick period | 50ms | Every node got ticked | Should Pass |
+*/
+TEST(em_worker_pool_t_Test, OrderAndAffinity) {
+    std::cout << "Entering OrderAndAffinity test" << std::endl;
+    const unsigned int num_nodes = 4, per_node = 2000;
+    static test_node_t nodes[num_nodes];
+    em_worker_pool_t pool;
+    std::vector<std::thread> producers;
+    std::atomic<uintptr_t> seq[num_nodes];
+    unsigned int i, p;
+
+    ASSERT_EQ(pool.init(2, test_run, test_tick, 50), 0);
+    ASSERT_EQ(pool.get_num_workers(), 2u);
+    for (i = 0; i < num_nodes; i++) {
+        init_node(&nodes[i]);
+        ASSERT_NE(nodes[i].slot = pool.attach(&nodes[i]), nullptr);
+        seq[i] = 1;
+    }
+    EXPECT_EQ(pool.get_num_homed(0), 2u);
+    EXPECT_EQ(pool.get_num_homed(1), 2u);
+
+    for (i = 0; i < num_nodes; i++) {
+        for (p = 0; p < 2; p++) {
+            producers.emplace_back([&, i]() {
+                static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+                for (unsigned int k = 0; k < per_node / 2; k++) {
+                    // the sequence number and the push are taken together so that the queue order is the sequence order
+                    pthread_mutex_lock(&lock);
+                    nodes[i].q.push(reinterpret_cast<void *>(seq[i]++));
+                    pthread_mutex_unlock(&lock);
+                    pool.schedule(nodes[i].slot);
+                }
+            });
+        }
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+
+    for (i = 0; i < 200; i++) {
+        bool all = true;
+        for (p = 0; p < num_nodes; p++) {
+            all = all && (nodes[p].done == per_node);
+        }
+        if (all == true) {
+            break;
+        }
+        usleep(10000);
+    }
+    usleep(100000);
+
+    for (i = 0; i < num_nodes; i++) {
+        EXPECT_EQ(nodes[i].done, per_node);
+        EXPECT_TRUE(nodes[i].in_order);
+        EXPECT_FALSE(nodes[i].concurrent);
+        EXPECT_FALSE(nodes[i].moved);
+        EXPECT_GT(nodes[i].ticks, 0u);
+        pool.detach(nodes[i].slot);
+    }
+    pool.deinit();
+    for (i = 0; i < num_nodes; i++) {
+        nodes[i].q.deinit();
+    }
+    std::cout << "Exiting OrderAndAffinity test" << std::endl;
+}
+
+/**
+* @brief Test that a detached node is not run anymore and that its slot is reused
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Attach a node, detach it, queue an entry and schedule the stale slot | None | The entry is not run | Should Pass |
+* | 02| Attach another node | None | It gets the freed slot and its entries run | Should Pass |
+*/
+TEST(em_worker_pool_t_Test, Detach) {
+    std::cout << "Entering Detach test" << std::endl;
+    static test_node_t a, b;
+    em_worker_pool_t pool;
+    em_worker_slot_t *slot;
+    unsigned int i;
+
+    ASSERT_EQ(pool.init(1, test_run, NULL, 1000), 0);
+    init_node(&a);
+    init_node(&b);
+    ASSERT_NE(slot = pool.attach(&a), nullptr);
+    pool.detach(slot);
+    EXPECT_EQ(pool.get_num_homed(0), 0u);
+
+    a.q.push(reinterpret_cast<void *>(1));
+    pool.schedule(slot);
+    usleep(50000);
+    EXPECT_EQ(a.done, 0u);
+
+    ASSERT_EQ(pool.attach(&b), slot);
+    b.q.push(reinterpret_cast<void *>(1));
+    pool.schedule(slot);
+    for (i = 0; (i < 100) && (b.done == 0); i++) {
+        usleep(10000);
+    }
+    EXPECT_EQ(b.done, 1u);
+    EXPECT_EQ(a.done, 0u);
+
+    pool.detach(slot);
+    pool.deinit();
+    while (a.q.pop() != NULL);
+    a.q.deinit();
+    b.q.deinit();
+    std::cout << "Exiting Detach test" << std::endl;
+}
+
+/**
+* @brief Test that a parked node is not ticked until it is unparked or scheduled
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Park one of two nodes, wait for several ticks | 10ms tick | Parked node not ticked, the other one is | Should Pass |
+* | 02| Queue an entry on the parked node and schedule it | None | Entry runs, node ticked again | Should Pass |
+* | 03| Park the node again and unpark it | None | Node ticked again | Should Pass |
+*/
+TEST(em_worker_pool_t_Test, Park) {
+    std::cout << "Entering Park test" << std::endl;
+    static test_node_t a, b;
+    em_worker_pool_t pool;
+    unsigned int i, ticks;
+
+    ASSERT_EQ(pool.init(1, test_run, test_tick, 10), 0);
+    init_node(&a);
+    init_node(&b);
+    ASSERT_NE(a.slot = pool.attach(&a), nullptr);
+    ASSERT_NE(b.slot = pool.attach(&b), nullptr);
+
+    pool.park(a.slot);
+    EXPECT_EQ(pool.get_num_parked(0), 1u);
+    // a tick running while parking may still reach the node
+    usleep(30000);
+    ticks = a.ticks;
+    b.ticks = 0;
+    usleep(100000);
+    EXPECT_EQ(a.ticks, ticks);
+    EXPECT_GT(b.ticks, 2u);
+
+    a.q.push(reinterpret_cast<void *>(1));
+    pool.schedule(a.slot);
+    for (i = 0; (i < 100) && (a.ticks == ticks); i++) {
+        usleep(10000);
+    }
+    EXPECT_EQ(a.done, 1u);
+    EXPECT_GT(a.ticks, ticks);
+    EXPECT_EQ(pool.get_num_parked(0), 0u);
+
+    pool.park(a.slot);
+    usleep(30000);
+    ticks = a.ticks;
+    pool.unpark(a.slot);
+    for (i = 0; (i < 100) && (a.ticks == ticks); i++) {
+        usleep(10000);
+    }
+    EXPECT_GT(a.ticks, ticks);
+
+    pool.detach(a.slot);
+    pool.detach(b.slot);
+    pool.deinit();
+    a.q.deinit();
+    b.q.deinit();
+    std::cout << "Exiting Park test" << std::endl;
+}
@@ -21,7 +21,11 @@
 #include <atomic>
 #include <chrono>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <thread>
+#include <vector>
 
 using namespace std::chrono_literals;
 
@@ -202,3 +206,112 @@ TEST(ThreadedTimer, Stop_Only) {
     timer.stop();
     std::cout << "Exiting: ThreadedTimer_Stop_Only" << std::endl;
 }
+/**
+ * @brief Verify that timers run on one shared thread, in deadline order, and that cancelled ones never run.
+ *
+ * **Test Group ID:** Basic: 01
+ * **Test Case ID:** 006
+ * **Priority:** High
+ *
+ * **Pre-Conditions:** None
+ * **Dependencies:** None
+ * **User Interaction:** None
+ *
+ * **Test Procedure:**
+ * | Variation / Step | Description | Test Data |Expected Result |Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * |01| Start 32 timers with decreasing delays and stop every other one | Delays 200ms down to 45ms | The 16 left run in deadline order, all on the same thread | Should Pass |
+ * |02| Check the service after the timers ran | None | No timer left scheduled | Should Pass |
+ */
+TEST(ThreadedTimer, SharedThreadOrderAndCancel) {
+    std::cout << "Entering: ThreadedTimer_SharedThreadOrderAndCancel" << std::endl;
+    const int num = 32;
+    std::vector<std::unique_ptr<ThreadedTimer>> timers;
+    std::vector<int> order;
+    std::set<std::thread::id> threads;
+    std::mutex lock;
+    for (int i = 0; i < num; i++) {
+        timers.push_back(std::make_unique<ThreadedTimer>());
+        timers[i]->execute_after(std::chrono::milliseconds(200 - i * 5), [&, i]() {
+            std::lock_guard<std::mutex> guard(lock);
+            order.push_back(i);
+            threads.insert(std::this_thread::get_id());
+        });
+    }
+    for (int i = 0; i < num; i += 2) {
+        timers[i]->stop();
+    }
+    for (int i = 0; i < 100 && TimerService::instance().pending() != 0; ++i) {
+        std::this_thread::sleep_for(10ms);
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    ASSERT_EQ(order.size(), static_cast<size_t>(num / 2));
+    for (size_t i = 0; i < order.size(); i++) {
+        EXPECT_EQ(order[i], num - 1 - 2 * static_cast<int>(i));
+    }
+    EXPECT_EQ(threads.size(), 1u);
+    EXPECT_EQ(threads.count(std::this_thread::get_id()), 0u);
+    EXPECT_EQ(TimerService::instance().pending(), 0u);
+    std::cout << "Exiting: ThreadedTimer_SharedThreadOrderAndCancel" << std::endl;
+}
+
+/**
+ * @brief Verify that a timer can be stopped from its own callback and can own itself through it.
+ *
+ * **Test Group ID:** Basic: 01
+ * **Test Case ID:** 007
+ * **Priority:** High
+ *
+ * **Pre-Conditions:** None
+ * **Dependencies:** None
+ * **User Interaction:** None
+ *
+ * **Test Procedure:**
+ * | Variation / Step | Description | Test Data |Expected Result |Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * |01| Start a periodic timer whose callback stops it on the second call | interval = 20ms | Called twice, no deadlock | Should Pass |
+ * |02| Start a one shot timer held only by its own callback | delay = 20ms, shared_ptr captured by the callback | Runs once and the timer is freed | Should Pass |
+ * |03| Stop a timer while its callback runs | Callback sleeping 100ms | stop() returns after the callback | Should Pass |
+ */
+TEST(ThreadedTimer, StopFromCallbackAndSelfOwned) {
+    std::cout << "Entering: ThreadedTimer_StopFromCallbackAndSelfOwned" << std::endl;
+    ThreadedTimer periodic;
+    std::atomic<int> count{0};
+    periodic.start_periodic(20ms, [&]() -> bool {
+        if (++count == 2) {
+            periodic.stop();
+        }
+        return true;
+    });
+    std::this_thread::sleep_for(150ms);
+    EXPECT_EQ(count.load(), 2);
+
+    std::atomic<bool> fired{false};
+    std::weak_ptr<ThreadedTimer> weak;
+    {
+        auto timer = std::make_shared<ThreadedTimer>();
+        weak = timer;
+        timer->execute_after(20ms, [&fired, timer]() {
+            fired = true;
+        });
+    }
+    for (int i = 0; i < 50 && !weak.expired(); ++i) {
+        std::this_thread::sleep_for(10ms);
+    }
+    EXPECT_TRUE(fired.load());
+    EXPECT_TRUE(weak.expired());
+
+    ThreadedTimer slow;
+    std::atomic<bool> started{false}, finished{false};
+    slow.execute_after(0ms, [&]() {
+        started = true;
+        std::this_thread::sleep_for(100ms);
+        finished = true;
+    });
+    while (!started.load()) {
+        std::this_thread::sleep_for(1ms);
+    }
+    slow.stop();
+    EXPECT_TRUE(finished.load());
+    std::cout << "Exiting: ThreadedTimer_StopFromCallbackAndSelfOwned" << std::endl;
+}
@@ -0,0 +1,161 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2025 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "tr_181_notify.h"
+
+#define TEST_DEV1_ID    "Device.WiFi.DataElements.Network.Device.1.ID"
+#define TEST_DEV1_RADIO "Device.WiFi.DataElements.Network.Device.1.Radio.2.Noise"
+#define TEST_DEV12_ID   "Device.WiFi.DataElements.Network.Device.12.ID"
+
+/**
+* @brief Test that only subscribed paths under a changed object are marked, once per batch
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 001@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Mark an object with nothing subscribed | None | Nothing is marked | Should Pass |
+* | 02| Subscribe three paths, mark device 1 twice | None | Its two paths are marked once, the second mark is coalesced, device 12 is not marked | Should Pass |
+* | 03| Take the batch | None | Both paths are returned, the next batch is empty | Should Pass |
+* | 04| Mark, then unsubscribe a path before the batch | None | The path is not in the batch | Should Pass |
+*/
+TEST(tr_181_notify_t_Test, MarkAndBatch) {
+    std::cout << "Entering MarkAndBatch test" << std::endl;
+    tr_181_notify_t notify;
+    tr_181_notify_stats_t stats;
+    std::vector<std::string> paths;
+
+    EXPECT_FALSE(notify.has_subs());
+    EXPECT_EQ(notify.mark_changed("Device.WiFi.DataElements.Network."), 0u);
+    EXPECT_EQ(notify.subscribe(""), -1);
+
+    EXPECT_EQ(notify.subscribe(TEST_DEV1_ID), 0);
+    EXPECT_EQ(notify.subscribe(TEST_DEV1_RADIO), 0);
+    EXPECT_EQ(notify.subscribe(TEST_DEV12_ID), 0);
+    EXPECT_TRUE(notify.has_subs());
+    EXPECT_EQ(notify.mark_changed("Device.WiFi.DataElements.Network.Device.1."), 2u);
+    EXPECT_EQ(notify.mark_changed("Device.WiFi.DataElements.Network.Device.1."), 0u);
+
+    ASSERT_EQ(notify.get_batch(10000, paths), 2u);
+    EXPECT_TRUE(((paths[0] == TEST_DEV1_ID) && (paths[1] == TEST_DEV1_RADIO)) ||
+        ((paths[0] == TEST_DEV1_RADIO) && (paths[1] == TEST_DEV1_ID)));
+    EXPECT_EQ(notify.get_batch(20000, paths), 0u);
+    EXPECT_TRUE(paths.empty());
+
+    EXPECT_EQ(notify.mark_changed(TEST_DEV12_ID), 1u);
+    EXPECT_EQ(notify.unsubscribe(TEST_DEV12_ID), 0);
+    EXPECT_EQ(notify.unsubscribe(TEST_DEV12_ID), -1);
+    EXPECT_EQ(notify.get_batch(30000, paths), 0u);
+
+    notify.get_stats(&stats);
+    EXPECT_EQ(stats.num_subs, 2u);
+    EXPECT_EQ(stats.marked, 3u);
+    EXPECT_EQ(stats.coalesced, 2u);
+    std::cout << "Exiting MarkAndBatch test" << std::endl;
+}
+
+/**
+* @brief Test that batches are rate limited and that unchanged values are not published
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 002@n
+* **Priority:** High@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Set an interval below the minimum, then 2 s | None | The first is refused, the second applies | Should Pass |
+* | 02| Take a batch, mark again and take one before the interval elapsed | None | The second batch waits, the marks are kept | Should Pass |
+* | 03| Record the same value twice, then another one | None | Only the first and the changed value are to be published | Should Pass |
+* | 04| Subscribe a path twice and unsubscribe it once | None | The path stays subscribed | Should Pass |
+*/
+TEST(tr_181_notify_t_Test, RateLimitAndValues) {
+    std::cout << "Entering RateLimitAndValues test" << std::endl;
+    tr_181_notify_t notify;
+    tr_181_notify_stats_t stats;
+    std::vector<std::string> paths;
+
+    EXPECT_EQ(notify.get_interval(), static_cast<unsigned int>(TR_181_NOTIFY_DEF_INTERVAL_MS));
+    EXPECT_EQ(notify.set_interval(TR_181_NOTIFY_MIN_INTERVAL_MS - 1), -1);
+    EXPECT_EQ(notify.set_interval(2000), 0);
+    EXPECT_EQ(notify.get_interval(), 2000u);
+
+    ASSERT_EQ(notify.subscribe(TEST_DEV1_ID), 0);
+    notify.mark_changed(TEST_DEV1_ID);
+    ASSERT_EQ(notify.get_batch(10000, paths), 1u);
+    notify.mark_changed(TEST_DEV1_ID);
+    EXPECT_EQ(notify.get_batch(11000, paths), 0u);
+    EXPECT_EQ(notify.get_batch(12000, paths), 1u);
+
+    EXPECT_TRUE(notify.update_value(TEST_DEV1_ID, "aa:bb:cc:dd:ee:ff"));
+    EXPECT_FALSE(notify.update_value(TEST_DEV1_ID, "aa:bb:cc:dd:ee:ff"));
+    EXPECT_TRUE(notify.update_value(TEST_DEV1_ID, "aa:bb:cc:dd:ee:00"));
+    EXPECT_FALSE(notify.update_value(TEST_DEV12_ID, "aa:bb:cc:dd:ee:00"));
+
+    EXPECT_EQ(notify.subscribe(TEST_DEV1_ID), 0);
+    EXPECT_EQ(notify.unsubscribe(TEST_DEV1_ID), 0);
+    EXPECT_TRUE(notify.has_subs());
+
+    notify.get_stats(&stats);
+    EXPECT_EQ(stats.batches, 2u);
+    EXPECT_EQ(stats.published, 2u);
+    EXPECT_EQ(stats.unchanged, 1u);
+    std::cout << "Exiting RateLimitAndValues test" << std::endl;
+}
+
+/**
+* @brief Test that instance numbers of a path are replaced by {i}
+*
+* **Test Group ID:** Basic: 01@n
+* **Test Case ID:** 003@n
+* **Priority:** Medium@n
+* @n
+* **Pre-Conditions:** None@n
+* **Dependencies:** None@n
+* **User Interaction:** None@n
+* @n
+* **Test Procedure:**@n
+* | Variation / Step | Description | Test Data |Expected Result |Notes |
+* | :----: | --------- | ---------- |-------------- | ----- |
+* | 01| Convert paths with one, two and no instance numbers and an object path | None | Only the segments of digits are replaced | Should Pass |
+*/
+TEST(tr_181_notify_t_Test, Template) {
+    std::cout << "Entering Template test" << std::endl;
+    EXPECT_EQ(tr_181_notify_t::get_template(TEST_DEV12_ID), "Device.WiFi.DataElements.Network.Device.{i}.ID");
+    EXPECT_EQ(tr_181_notify_t::get_template(TEST_DEV1_RADIO), "Device.WiFi.DataElements.Network.Device.{i}.Radio.{i}.Noise");
+    EXPECT_EQ(tr_181_notify_t::get_template("Device.WiFi.DataElements.Network.ID"), "Device.WiFi.DataElements.Network.ID");
+    EXPECT_EQ(tr_181_notify_t::get_template("Device.WiFi.DataElements.Network.Device.3."), "Device.WiFi.DataElements.Network.Device.{i}.");
+    EXPECT_EQ(tr_181_notify_t::get_template("Device.WiFi.DataElements.Network.X_RDK_Notify.MinInterval"),
+        "Device.WiFi.DataElements.Network.X_RDK_Notify.MinInterval");
+    std::cout << "Exiting Template test" << std::endl;
+}
@@ -4,6 +4,7 @@
 #include <vector>
 #include <arpa/inet.h>
 #include <cstring>
+#include <time.h>
 #include "util.h"
 
 using namespace util;
@@ -588,3 +589,69 @@ TEST(UtilTest, set_net_uint16_from_host_negative_nullptr) {
     std::cout << "Returned bool=" << ok << std::endl;
     std::cout << "Exiting set_net_uint16_from_host_negative_nullptr test" << std::endl;
 }
+/**
+ * @brief Verify the regional and global lookups of em_chan_to_freq and em_freq_to_chan.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 021@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Regional operating class with and without its region | op_class = 1, channel = 36, "US" and "" | 5180, then -1 | Should Pass |
+ * | 02 | Channel 0 of a global operating class | op_class = 81, channel = 0 | 2412, the lowest channel | Should Pass |
+ * | 03 | 5180 MHz without region, in the US and in a region without ranges | "", "US", "DE" | 115/36, 1/36 and the last global class 130/36 | Should Pass |
+ * | 04 | 60 GHz frequency | 58320 MHz | 180/1 | Should Pass |
+ */
+TEST(UtilTest, em_freq_lookup_regions) {
+    std::cout << "Entering em_freq_lookup_regions test" << std::endl;
+    EXPECT_EQ(em_chan_to_freq(1, 36, "US"), 5180);
+    EXPECT_EQ(em_chan_to_freq(1, 36, ""), -1);
+    EXPECT_EQ(em_chan_to_freq(81, 0, ""), 2412);
+    EXPECT_EQ(em_freq_to_chan(5180, ""), std::make_pair(static_cast<uint8_t>(115), static_cast<uint8_t>(36)));
+    EXPECT_EQ(em_freq_to_chan(5180, "US"), std::make_pair(static_cast<uint8_t>(1), static_cast<uint8_t>(36)));
+    EXPECT_EQ(em_freq_to_chan(5180, "DE"), std::make_pair(static_cast<uint8_t>(130), static_cast<uint8_t>(36)));
+    EXPECT_EQ(em_freq_to_chan(58320, ""), std::make_pair(static_cast<uint8_t>(180), static_cast<uint8_t>(1)));
+    std::cout << "Exiting em_freq_lookup_regions test" << std::endl;
+}
+/**
+ * @brief Verify that delay sleeps for the requested seconds without spinning.
+ *
+ * **Test Group ID:** Basic: 01@n
+ * **Test Case ID:** 022@n
+ * **Priority:** High@n
+ *
+ * **Pre-Conditions:** None@n
+ * **Dependencies:** None@n
+ * **User Interaction:** None@n
+ *
+ * **Test Procedure:**@n
+ * | Variation / Step | Description | Test Data | Expected Result | Notes |
+ * | :----: | --------- | ---------- |-------------- | ----- |
+ * | 01 | Call delay and measure the elapsed and the CPU time of the thread | seconds = 1 | At least 1 s elapsed, less than 100 ms of CPU used | Should Pass |
+ * | 02 | Call delay with no time | seconds = 0, -1 | Returns at once | Should Pass |
+ */
+TEST(UtilTest, delay_sleeps) {
+    std::cout << "Entering delay_sleeps test" << std::endl;
+    struct timespec start, end, cpu_start, cpu_end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_start);
+    delay(1);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_end);
+    long long elapsed_ms = (end.tv_sec - start.tv_sec) * 1000LL + (end.tv_nsec - start.tv_nsec) / 1000000;
+    long long cpu_ms = (cpu_end.tv_sec - cpu_start.tv_sec) * 1000LL + (cpu_end.tv_nsec - cpu_start.tv_nsec) / 1000000;
+    EXPECT_GE(elapsed_ms, 1000);
+    EXPECT_LT(cpu_ms, 100);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    delay(0);
+    delay(-1);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    EXPECT_LT((end.tv_sec - start.tv_sec) * 1000LL + (end.tv_nsec - start.tv_nsec) / 1000000, 100);
+    std::cout << "Exiting delay_sleeps test" << std::endl;
+}
@@ -21,6 +21,7 @@
 #include <array>
 #include <sstream>
 #include <cctype>
+#include <string.h>
 
 MacAddress parseMacAddress(const std::string& macStr) {
     std::string cleaned;
@@ -38,6 +39,21 @@ MacAddress parseMacAddress(const std::string& macStr) {
 }
 
 
+void make_mac(unsigned int n, unsigned char *mac)
+{
+    make_mac(n, 0, mac);
+}
+
+void make_mac(unsigned int n, unsigned char kind, unsigned char *mac)
+{
+    memset(mac, 0, 6);
+    mac[0] = 0x02;
+    mac[1] = kind;
+    mac[3] = static_cast<unsigned char>(n >> 16);
+    mac[4] = static_cast<unsigned char>(n >> 8);
+    mac[5] = static_cast<unsigned char>(n);
+}
+
 std::ostream& operator<<(std::ostream& os, const MacAddress& mac) {
     for (size_t i = 0; i < mac.size(); ++i) {
         if (i != 0) os << ":";
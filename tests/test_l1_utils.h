@@ -32,4 +32,9 @@ MacAddress parseMacAddress(const std::string& macStr);
 std::ostream& operator<<(std::ostream& os, const MacAddress& mac);
 std::ostream& operator<<(std::ostream& os, const MessageIdRange& range);
 std::ostream& operator<<(std::ostream& os, const SAPActivation& op);
-std::ostream& operator<<(std::ostream& os, const ServiceType& type);
\ No newline at end of file
+std::ostream& operator<<(std::ostream& os, const ServiceType& type);
+
+// Locally administered MAC of test object n, 02:kind:00 followed by the low 24 bits of n;
+// kind tells apart objects that share n, e.g. a radio and its BSS
+void make_mac(unsigned int n, unsigned char *mac);
+void make_mac(unsigned int n, unsigned char kind, unsigned char *mac);